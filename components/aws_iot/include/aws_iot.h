@@ -10,6 +10,7 @@
 #include <stdint.h>
 
 #include "esp_err.h"
+#include "sdkconfig.h"
 #include "aws_iot_mqtt_client_interface.h"
 
 #ifdef __cplusplus
@@ -21,6 +22,8 @@ extern "C" {
  *
  * The certificate fields are expected to be PEM-formatted, null-terminated strings
  * that live for the lifetime of the client instance (e.g. embedded with `extern const char`).
+ * They may instead be DER, one or more structures back to back followed by a NUL
+ * byte; the TLS layer then parses them without the PEM decoding step.
  */
 typedef struct {
     const char *endpoint;        /**< AWS IoT endpoint, e.g. "xxxxxxxxxx-ats.iot.us-west-2.amazonaws.com" */
@@ -42,6 +45,19 @@ typedef struct {
  */
 typedef void (*aws_iot_disconnect_cb_t)(AWS_IoT_Client *client, void *ctx);
 
+/**
+ * @brief MQTT 5 properties of a publish.
+ *
+ * The MQTT 3.1.1 client sends none of them. Strings must outlive the
+ * message, which in practice means string literals.
+ */
+typedef struct {
+    uint32_t expiry_sec;         /**< Message expiry interval; 0 never expires. */
+    const char *content_type;    /**< MIME type of the payload, or NULL. */
+    const char *user_key;        /**< One user property, or NULL. Keep both short: they go out with every message. */
+    const char *user_value;
+} aws_iot_publish_props_t;
+
 /**
  * @brief AWS IoT client wrapper.
  */
@@ -53,6 +69,9 @@ typedef struct {
     bool connected;
     aws_iot_disconnect_cb_t disconnect_cb;
     void *disconnect_ctx;
+#if CONFIG_NAPHOME_AWS_IOT_MQTT5
+    struct aws_iot_mqtt5 *mqtt5; /**< esp-mqtt client and its state; the SDK fields above go unused. */
+#endif
 } aws_iot_client_t;
 
 /**
@@ -94,22 +113,75 @@ esp_err_t aws_iot_client_init_from_settings(aws_iot_client_t *client);
 esp_err_t aws_iot_client_init(aws_iot_client_t *client, const aws_iot_config_t *config);
 esp_err_t aws_iot_client_connect(aws_iot_client_t *client);
 esp_err_t aws_iot_client_disconnect(aws_iot_client_t *client);
+
+/**
+ * @brief Release what @ref aws_iot_client_init set up; disconnect first.
+ */
+void aws_iot_client_deinit(aws_iot_client_t *client);
 esp_err_t aws_iot_client_yield(aws_iot_client_t *client, uint32_t timeout_ms);
+
+/**
+ * @brief Sleep until the connection needs aws_iot_client_yield().
+ *
+ * Blocks in select() on the TLS socket, so an idle connection costs no
+ * wakeups: returns as soon as a packet arrives, when the keepalive ping is
+ * due, when @p wake_fd (an eventfd, or -1) is signalled, or after
+ * @p max_wait_ms, whichever comes first. A signalled @p wake_fd is drained.
+ *
+ * @return ESP_OK when there is data to read or the keepalive is due;
+ *         ESP_ERR_TIMEOUT when woken through @p wake_fd or @p max_wait_ms
+ *         elapsed; ESP_ERR_INVALID_STATE when not connected
+ */
+esp_err_t aws_iot_client_wait(aws_iot_client_t *client, int wake_fd, uint32_t max_wait_ms);
 esp_err_t aws_iot_client_publish(aws_iot_client_t *client,
                                  const char *topic,
                                  QoS qos,
                                  const void *payload,
                                  size_t payload_len,
                                  bool retain);
+
+/**
+ * @brief Publish with MQTT 5 properties; @p props may be NULL.
+ *
+ * Under MQTT 5 a topic published before on this connection goes out as its
+ * topic alias. The MQTT 3.1.1 client ignores @p props.
+ */
+esp_err_t aws_iot_client_publish_props(aws_iot_client_t *client,
+                                       const char *topic,
+                                       QoS qos,
+                                       const void *payload,
+                                       size_t payload_len,
+                                       bool retain,
+                                       const aws_iot_publish_props_t *props);
 esp_err_t aws_iot_client_subscribe(aws_iot_client_t *client,
                                    const char *topic,
                                    QoS qos,
                                    pApplicationHandler_t handler,
                                    void *handler_ctx);
 bool aws_iot_client_is_connected(const aws_iot_client_t *client);
+
+/**
+ * @brief Whether the broker kept the MQTT session on the last connect.
+ *
+ * Only meaningful with clean_session disabled: when true, the broker still
+ * holds this client's subscriptions and nothing needs re-subscribing.
+ */
+bool aws_iot_client_session_present(const aws_iot_client_t *client);
+
+/**
+ * @brief Re-send SUBSCRIBE for every handler already registered on the client.
+ *
+ * Use after a reconnect that did not restore the session; calling
+ * @ref aws_iot_client_subscribe again would register a second handler.
+ */
+esp_err_t aws_iot_client_resubscribe(aws_iot_client_t *client);
 void aws_iot_client_set_disconnect_callback(aws_iot_client_t *client,
                                             aws_iot_disconnect_cb_t cb,
                                             void *ctx);
+
+/**
+ * @brief The SDK client underneath; NULL under MQTT 5, which has none.
+ */
 AWS_IoT_Client *aws_iot_client_get_mqtt_client(aws_iot_client_t *client);
 
 #ifdef __cplusplus
@@ -24,11 +24,81 @@ typedef struct {
     void *config_loader_ctx;
 } aws_iot_service_config_t;
 
+/**
+ * @brief Outbox priority; under pressure a higher class evicts a lower one.
+ */
+typedef enum {
+    AWS_IOT_SERVICE_PRIORITY_LOG = 0,
+    AWS_IOT_SERVICE_PRIORITY_TELEMETRY,
+    AWS_IOT_SERVICE_PRIORITY_INTERACTION,
+} aws_iot_service_priority_t;
+
+typedef struct {
+    uint32_t queued;                  ///< Messages waiting now
+    uint32_t queued_bytes;
+    uint32_t high_water;              ///< Most messages ever waiting at once
+    uint32_t sent;
+    uint32_t coalesced;               ///< Replaced by a newer message on the same topic
+    uint32_t evicted;                 ///< Dropped to make room for a higher priority
+    uint32_t rejected;                ///< Refused with ESP_ERR_NO_MEM (backpressure)
+    uint32_t failed;                  ///< Dropped after repeated publish errors
+    uint32_t expired;                 ///< Dropped unsent past their expiry
+} aws_iot_service_outbox_stats_t;
+
 esp_err_t aws_iot_service_start(const aws_iot_service_config_t *config);
 esp_err_t aws_iot_service_stop(void);
 bool aws_iot_service_is_running(void);
 aws_iot_client_t *aws_iot_service_get_client(void);
 
+/**
+ * @brief Also subscribe to topic, with the configured handler, context and QoS.
+ *
+ * Topics are kept across stop and start and cannot be removed, since the SDK
+ * holds on to them. Subscribed from the service task once connected; adding
+ * a topic again is a no-op.
+ *
+ * @return ESP_OK once recorded; ESP_ERR_NO_MEM when all extra slots (one fewer
+ *         than AWS_IOT_MQTT_NUM_SUBSCRIBE_HANDLERS) are used;
+ *         ESP_ERR_INVALID_ARG for a missing or over-long topic
+ */
+esp_err_t aws_iot_service_add_subscription(const char *topic);
+
+/**
+ * @brief Queue a message for the service task to publish.
+ *
+ * Never blocks on the network: topic and payload are copied and the service
+ * task publishes everything queued before each yield, highest priority first,
+ * oldest first within a priority. Messages wait out a disconnect.
+ *
+ * @param coalesce Replace a message still waiting on the same topic, for
+ *                 payloads where only the latest matters (state snapshots)
+ * @return ESP_OK once queued; ESP_ERR_NO_MEM when the outbox is full of
+ *         messages of equal or higher priority, so the caller may keep its
+ *         data and retry; ESP_ERR_INVALID_STATE when the service is stopped
+ */
+esp_err_t aws_iot_service_publish(const char *topic,
+                                  QoS qos,
+                                  const void *payload,
+                                  size_t payload_len,
+                                  aws_iot_service_priority_t priority,
+                                  bool coalesce);
+
+/**
+ * @brief aws_iot_service_publish() with MQTT 5 properties; @p props may be NULL.
+ *
+ * A message with an expiry still queued that long after this call is dropped
+ * instead of sent; under MQTT 5 the broker is given what is left of it.
+ */
+esp_err_t aws_iot_service_publish_props(const char *topic,
+                                        QoS qos,
+                                        const void *payload,
+                                        size_t payload_len,
+                                        aws_iot_service_priority_t priority,
+                                        bool coalesce,
+                                        const aws_iot_publish_props_t *props);
+
+void aws_iot_service_get_outbox_stats(aws_iot_service_outbox_stats_t *stats);
+
 #ifdef __cplusplus
 }
 #endif
@@ -5,7 +5,10 @@
 
 #include "aws_iot.h"
 
+#include <errno.h>
 #include <string.h>
+#include <sys/select.h>
+#include <unistd.h>
 
 #include "esp_check.h"
 #include "esp_log.h"
@@ -189,6 +192,15 @@ esp_err_t aws_iot_client_disconnect(aws_iot_client_t *client)
     return ESP_OK;
 }
 
+void aws_iot_client_deinit(aws_iot_client_t *client)
+{
+    // The SDK client holds nothing beyond the struct
+    if (client) {
+        client->initialized = false;
+        client->connected = false;
+    }
+}
+
 esp_err_t aws_iot_client_yield(aws_iot_client_t *client, uint32_t timeout_ms)
 {
     ESP_RETURN_ON_FALSE(client, ESP_ERR_INVALID_ARG, TAG, "client handle is NULL");
@@ -203,6 +215,56 @@ esp_err_t aws_iot_client_yield(aws_iot_client_t *client, uint32_t timeout_ms)
     return ESP_OK;
 }
 
+esp_err_t aws_iot_client_wait(aws_iot_client_t *client, int wake_fd, uint32_t max_wait_ms)
+{
+    ESP_RETURN_ON_FALSE(client, ESP_ERR_INVALID_ARG, TAG, "client handle is NULL");
+    ESP_RETURN_ON_FALSE(client->initialized, ESP_ERR_INVALID_STATE, TAG, "client not initialised");
+    if (!client->connected) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    TLSDataParams *tls = &client->client.networkStack.tlsDataParams;
+    // A record already decrypted into mbedTLS never shows up on the socket
+    if (mbedtls_ssl_get_bytes_avail(&tls->ssl) > 0) {
+        return ESP_OK;
+    }
+    uint32_t ping_ms = left_ms(&client->client.pingReqTimer);
+    if (ping_ms == 0) {
+        return ESP_OK;
+    }
+
+    uint32_t wait_ms = ping_ms < max_wait_ms ? ping_ms : max_wait_ms;
+    int sock = tls->server_fd.fd;
+    fd_set readable;
+    FD_ZERO(&readable);
+    FD_SET(sock, &readable);
+    if (wake_fd >= 0) {
+        FD_SET(wake_fd, &readable);
+    }
+    struct timeval tv = {
+        .tv_sec = wait_ms / 1000,
+        .tv_usec = (wait_ms % 1000) * 1000,
+    };
+    int ready = select((sock > wake_fd ? sock : wake_fd) + 1, &readable, NULL, NULL, &tv);
+    if (ready < 0) {
+        if (errno == EINTR) {
+            return ESP_ERR_TIMEOUT;
+        }
+        // Let yield find out what is wrong with the socket
+        ESP_LOGW(TAG, "select failed (errno %d)", errno);
+        return ESP_OK;
+    }
+
+    if (wake_fd >= 0 && FD_ISSET(wake_fd, &readable)) {
+        uint64_t count;
+        (void)read(wake_fd, &count, sizeof(count));
+    }
+    if (ready > 0 && FD_ISSET(sock, &readable)) {
+        return ESP_OK;
+    }
+    return ready == 0 && wait_ms == ping_ms ? ESP_OK : ESP_ERR_TIMEOUT;
+}
+
 esp_err_t aws_iot_client_publish(aws_iot_client_t *client,
                                  const char *topic,
                                  QoS qos,
@@ -230,6 +292,19 @@ esp_err_t aws_iot_client_publish(aws_iot_client_t *client,
     return ESP_OK;
 }
 
+esp_err_t aws_iot_client_publish_props(aws_iot_client_t *client,
+                                       const char *topic,
+                                       QoS qos,
+                                       const void *payload,
+                                       size_t payload_len,
+                                       bool retain,
+                                       const aws_iot_publish_props_t *props)
+{
+    // MQTT 3.1.1 has no properties to carry them in
+    (void)props;
+    return aws_iot_client_publish(client, topic, qos, payload, payload_len, retain);
+}
+
 esp_err_t aws_iot_client_subscribe(aws_iot_client_t *client,
                                    const char *topic,
                                    QoS qos,
@@ -258,6 +333,35 @@ bool aws_iot_client_is_connected(const aws_iot_client_t *client)
     return client->connected;
 }
 
+bool aws_iot_client_session_present(const aws_iot_client_t *client)
+{
+    if (!client || !client->connected) {
+        return false;
+    }
+
+    return client->client.clientData.sessionPresent;
+}
+
+esp_err_t aws_iot_client_resubscribe(aws_iot_client_t *client)
+{
+    ESP_RETURN_ON_FALSE(client, ESP_ERR_INVALID_ARG, TAG, "client handle is NULL");
+    ESP_RETURN_ON_FALSE(client->initialized, ESP_ERR_INVALID_STATE, TAG, "client not initialised");
+
+    // The SDK only clears these when yield notices the drop; a drop seen by
+    // a publish would leave them set and the resubscribe would send nothing
+    for (size_t i = 0; i < AWS_IOT_MQTT_NUM_SUBSCRIBE_HANDLERS; ++i) {
+        client->client.clientData.messageHandlers[i].resubscribed = 0;
+    }
+
+    IoT_Error_t rc = aws_iot_mqtt_resubscribe(&client->client);
+    if (SUCCESS != rc) {
+        ESP_LOGE(TAG, "aws_iot_mqtt_resubscribe failed (%d)", rc);
+        return convert_iot_error(rc);
+    }
+
+    return ESP_OK;
+}
+
 void aws_iot_client_set_disconnect_callback(aws_iot_client_t *client,
                                             aws_iot_disconnect_cb_t cb,
                                             void *ctx)
@@ -1,10 +1,12 @@
 #include "aws_iot.h"
 
 #include <inttypes.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "esp_check.h"
 #include "esp_log.h"
+#include "nvs.h"
 #include "sdkconfig.h"
 
 static const char *TAG = "aws_iot_cfg";
@@ -64,6 +66,7 @@ static esp_err_t validate_credentials_placeholders(void)
         has_placeholder = true;
     }
 
+#ifndef CONFIG_NAPHOME_AWS_IOT_CREDENTIALS_NVS
     if (buffer_contains_placeholder(_binary_device_cert_pem_start, device_cert_len)) {
         ESP_LOGW(TAG, "Device certificate placeholder detected");
         has_placeholder = true;
@@ -73,6 +76,10 @@ static esp_err_t validate_credentials_placeholders(void)
         ESP_LOGW(TAG, "Private key placeholder detected");
         has_placeholder = true;
     }
+#else
+    (void)device_cert_len;
+    (void)private_key_len;
+#endif
 
 #if CONFIG_NAPHOME_AWS_IOT_FAIL_ON_PLACEHOLDER_CERTS
     ESP_RETURN_ON_FALSE(!has_placeholder, ESP_ERR_INVALID_STATE, TAG,
@@ -82,6 +89,51 @@ static esp_err_t validate_credentials_placeholders(void)
     return ESP_OK;
 }
 
+#ifdef CONFIG_NAPHOME_AWS_IOT_CREDENTIALS_NVS
+// Read once and kept: the SDK holds on to the pointers for every reconnect
+static char *s_nvs_cert;
+static size_t s_nvs_cert_len;
+static char *s_nvs_key;
+static size_t s_nvs_key_len;
+
+static esp_err_t load_nvs_string(nvs_handle_t nvs, const char *key, char **out, size_t *out_len)
+{
+    size_t len = 0;
+    esp_err_t err = nvs_get_str(nvs, key, NULL, &len);
+    ESP_RETURN_ON_ERROR(err, TAG, "\"%s\" not in NVS: %s", key, esp_err_to_name(err));
+    char *buf = malloc(len);
+    ESP_RETURN_ON_FALSE(buf, ESP_ERR_NO_MEM, TAG, "no memory for \"%s\"", key);
+    err = nvs_get_str(nvs, key, buf, &len);
+    if (err != ESP_OK) {
+        free(buf);
+        ESP_LOGE(TAG, "\"%s\" read failed: %s", key, esp_err_to_name(err));
+        return err;
+    }
+    *out = buf;
+    *out_len = len;
+    return ESP_OK;
+}
+
+static esp_err_t load_nvs_credentials(void)
+{
+    if (s_nvs_cert && s_nvs_key) {
+        return ESP_OK;
+    }
+    nvs_handle_t nvs;
+    esp_err_t err = nvs_open(CONFIG_NAPHOME_AWS_IOT_CREDENTIALS_NVS_NAMESPACE, NVS_READONLY, &nvs);
+    ESP_RETURN_ON_ERROR(err, TAG, "no device credentials in NVS namespace %s: %s",
+                        CONFIG_NAPHOME_AWS_IOT_CREDENTIALS_NVS_NAMESPACE, esp_err_to_name(err));
+    if (!s_nvs_cert) {
+        err = load_nvs_string(nvs, "cert", &s_nvs_cert, &s_nvs_cert_len);
+    }
+    if (err == ESP_OK && !s_nvs_key) {
+        err = load_nvs_string(nvs, "key", &s_nvs_key, &s_nvs_key_len);
+    }
+    nvs_close(nvs);
+    return err;
+}
+#endif
+
 esp_err_t aws_iot_config_load_from_kconfig(aws_iot_config_t *config)
 {
     ESP_RETURN_ON_FALSE(config, ESP_ERR_INVALID_ARG, TAG, "config pointer is NULL");
@@ -101,20 +153,43 @@ esp_err_t aws_iot_config_load_from_kconfig(aws_iot_config_t *config)
         return err;
     }
 
+#ifdef CONFIG_NAPHOME_AWS_IOT_CREDENTIALS_NVS
+    err = load_nvs_credentials();
+    if (err != ESP_OK) {
+        return err;
+    }
+#endif
+
     *config = (aws_iot_config_t)AWS_IOT_CONFIG_DEFAULT();
     config->endpoint = CONFIG_NAPHOME_AWS_IOT_ENDPOINT;
     config->port = (uint16_t)CONFIG_NAPHOME_AWS_IOT_PORT;
     config->client_id = CONFIG_NAPHOME_AWS_IOT_CLIENT_ID;
     config->keepalive_sec = (uint32_t)CONFIG_NAPHOME_AWS_IOT_KEEPALIVE_SEC;
-    config->clean_session = CONFIG_NAPHOME_AWS_IOT_CLEAN_SESSION;
-    config->auto_reconnect = CONFIG_NAPHOME_AWS_IOT_AUTO_RECONNECT;
+    // Bool options are left undefined when disabled, so they cannot be assigned directly
+#ifdef CONFIG_NAPHOME_AWS_IOT_CLEAN_SESSION
+    config->clean_session = true;
+#else
+    config->clean_session = false;
+#endif
+#ifdef CONFIG_NAPHOME_AWS_IOT_AUTO_RECONNECT
+    config->auto_reconnect = true;
+#else
+    config->auto_reconnect = false;
+#endif
 
     config->root_ca = _binary_root_ca_pem_start;
     config->root_ca_len = (size_t)(_binary_root_ca_pem_end - _binary_root_ca_pem_start);
+#ifdef CONFIG_NAPHOME_AWS_IOT_CREDENTIALS_NVS
+    config->client_cert = s_nvs_cert;
+    config->client_cert_len = s_nvs_cert_len;
+    config->client_key = s_nvs_key;
+    config->client_key_len = s_nvs_key_len;
+#else
     config->client_cert = _binary_device_cert_pem_start;
     config->client_cert_len = (size_t)(_binary_device_cert_pem_end - _binary_device_cert_pem_start);
     config->client_key = _binary_private_key_pem_start;
     config->client_key_len = (size_t)(_binary_private_key_pem_end - _binary_private_key_pem_start);
+#endif
 
     ESP_LOGI(TAG, "Loaded AWS IoT config: endpoint=%s client_id=%s port=%" PRIu16,
              config->endpoint,
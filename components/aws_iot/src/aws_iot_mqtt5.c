@@ -0,0 +1,598 @@
+/**
+ * @file aws_iot_mqtt5.c
+ * @brief The aws_iot_client_* API over esp-mqtt speaking MQTT 5.
+ *
+ * esp-mqtt runs the connection on its own task. Incoming messages are queued
+ * from there and handed to the subscribe handlers in aws_iot_client_yield(),
+ * so they run on the caller's task exactly as with the SDK client.
+ */
+
+#include "aws_iot.h"
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/select.h>
+#include <unistd.h>
+
+#include "esp_check.h"
+#include "esp_log.h"
+#include "esp_vfs_eventfd.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
+#include "freertos/queue.h"
+#include "mqtt_client.h"
+
+static const char *TAG = "aws_iot_mqtt5";
+
+#define MQTT5_CONNECTED_BIT     BIT0
+#define MQTT5_FAILED_BIT        BIT1
+#define MQTT5_CONNECT_TIMEOUT_MS 20000
+// Messages received but not yet handed to the handlers
+#define MQTT5_RX_QUEUE_LEN      8
+
+typedef struct {
+    size_t topic_len;
+    size_t payload_len;
+    QoS qos;
+    bool retain;
+    bool dup;
+    uint16_t id;
+    char data[];                 // Topic, its terminator, then the payload
+} mqtt5_rx_msg_t;
+
+typedef struct {
+    const char *filter;          // Caller's; the SDK client keeps pointers too
+    QoS qos;
+    pApplicationHandler_t handler;
+    void *ctx;
+} mqtt5_sub_t;
+
+typedef struct {
+    char *topic;
+    uint32_t last_used;
+} mqtt5_alias_t;
+
+struct aws_iot_mqtt5 {
+    esp_mqtt_client_config_t cfg;
+    esp_mqtt_client_handle_t handle;
+    EventGroupHandle_t events;
+    QueueHandle_t rx;
+    int rx_fd;                   // Signalled per queued message and on a drop
+    mqtt5_rx_msg_t *partial;     // Message arriving in more than one chunk
+    size_t partial_filled;
+    bool session_present;
+    bool dropped;                // Set by the esp-mqtt task; the disconnect callback is still due
+    mqtt5_sub_t subs[AWS_IOT_MQTT_NUM_SUBSCRIBE_HANDLERS];
+    size_t sub_count;
+    uint16_t alias_limit;        // Lowered to 0 for the connection if the broker refuses one
+    uint32_t alias_clock;
+    mqtt5_alias_t aliases[CONFIG_NAPHOME_AWS_IOT_MQTT5_TOPIC_ALIASES ? CONFIG_NAPHOME_AWS_IOT_MQTT5_TOPIC_ALIASES : 1];
+};
+
+static void mqtt5_signal(struct aws_iot_mqtt5 *m)
+{
+    uint64_t one = 1;
+    (void)write(m->rx_fd, &one, sizeof(one));
+}
+
+// esp-mqtt task
+static void mqtt5_on_data(struct aws_iot_mqtt5 *m, const esp_mqtt_event_t *event)
+{
+    if (event->current_data_offset == 0) {
+        free(m->partial);
+        m->partial = NULL;
+        size_t bytes = sizeof(mqtt5_rx_msg_t) + (size_t)event->topic_len + 1 + (size_t)event->total_data_len;
+        mqtt5_rx_msg_t *msg = malloc(bytes);
+        if (!msg) {
+            ESP_LOGW(TAG, "Dropped a %d byte message: out of memory", event->total_data_len);
+            return;
+        }
+        msg->topic_len = (size_t)event->topic_len;
+        msg->payload_len = (size_t)event->total_data_len;
+        msg->qos = (QoS)event->qos;
+        msg->retain = event->retain;
+        msg->dup = event->dup;
+        msg->id = (uint16_t)event->msg_id;
+        memcpy(msg->data, event->topic, msg->topic_len);
+        msg->data[msg->topic_len] = '\0';
+        m->partial = msg;
+        m->partial_filled = 0;
+    }
+    mqtt5_rx_msg_t *msg = m->partial;
+    if (!msg || (size_t)event->current_data_offset != m->partial_filled ||
+        m->partial_filled + (size_t)event->data_len > msg->payload_len) {
+        return;
+    }
+    memcpy(msg->data + msg->topic_len + 1 + m->partial_filled, event->data, (size_t)event->data_len);
+    m->partial_filled += (size_t)event->data_len;
+    if (m->partial_filled < msg->payload_len) {
+        return;
+    }
+    m->partial = NULL;
+    if (xQueueSend(m->rx, &msg, 0) != pdTRUE) {
+        ESP_LOGW(TAG, "Receive queue full, dropped a message on %s", msg->data);
+        free(msg);
+        return;
+    }
+    mqtt5_signal(m);
+}
+
+// esp-mqtt task
+static void mqtt5_event_handler(void *arg, esp_event_base_t base, int32_t event_id, void *event_data)
+{
+    (void)base;
+    aws_iot_client_t *client = (aws_iot_client_t *)arg;
+    struct aws_iot_mqtt5 *m = client->mqtt5;
+    esp_mqtt_event_handle_t event = (esp_mqtt_event_handle_t)event_data;
+
+    switch ((esp_mqtt_event_id_t)event_id) {
+    case MQTT_EVENT_CONNECTED:
+        m->session_present = event->session_present;
+        client->connected = true;
+        xEventGroupSetBits(m->events, MQTT5_CONNECTED_BIT);
+        break;
+    case MQTT_EVENT_DISCONNECTED:
+        if (client->connected) {
+            client->connected = false;
+            m->dropped = true;
+            mqtt5_signal(m);
+        }
+        xEventGroupSetBits(m->events, MQTT5_FAILED_BIT);
+        break;
+    case MQTT_EVENT_ERROR:
+        if (event->error_handle && event->error_handle->error_type == MQTT_ERROR_TYPE_CONNECTION_REFUSED) {
+            ESP_LOGE(TAG, "Connection refused (reason 0x%x) - check client ID and IAM policy",
+                     event->error_handle->connect_return_code);
+        } else if (event->error_handle && event->error_handle->esp_tls_last_esp_err) {
+            ESP_LOGE(TAG, "TLS error %s", esp_err_to_name(event->error_handle->esp_tls_last_esp_err));
+        }
+        xEventGroupSetBits(m->events, MQTT5_FAILED_BIT);
+        break;
+    case MQTT_EVENT_DATA:
+        mqtt5_on_data(m, event);
+        break;
+    default:
+        break;
+    }
+}
+
+// MQTT filter match: '+' takes one level, a trailing '#' the rest
+static bool mqtt5_topic_matches(const char *filter, const char *topic, size_t topic_len)
+{
+    size_t t = 0;
+    for (const char *f = filter; *f; ++f) {
+        if (*f == '#') {
+            return true;
+        }
+        if (*f == '+') {
+            while (t < topic_len && topic[t] != '/') {
+                ++t;
+            }
+        } else if (t < topic_len && topic[t] == *f) {
+            ++t;
+        } else {
+            return false;
+        }
+    }
+    return t == topic_len;
+}
+
+static void mqtt5_forget_aliases(struct aws_iot_mqtt5 *m)
+{
+    for (size_t i = 0; i < sizeof(m->aliases) / sizeof(m->aliases[0]); ++i) {
+        free(m->aliases[i].topic);
+        m->aliases[i].topic = NULL;
+    }
+    m->alias_limit = CONFIG_NAPHOME_AWS_IOT_MQTT5_TOPIC_ALIASES;
+}
+
+static void mqtt5_drop_queued(struct aws_iot_mqtt5 *m)
+{
+    mqtt5_rx_msg_t *msg;
+    while (m->rx && xQueueReceive(m->rx, &msg, 0) == pdTRUE) {
+        free(msg);
+    }
+    free(m->partial);
+    m->partial = NULL;
+}
+
+// A fresh esp-mqtt client per connection: aliases are per connection, and
+// esp-mqtt would otherwise resend queued packets that use them
+static void mqtt5_destroy_handle(struct aws_iot_mqtt5 *m)
+{
+    if (m->handle) {
+        esp_mqtt_client_destroy(m->handle);
+        m->handle = NULL;
+    }
+    mqtt5_drop_queued(m);
+    mqtt5_forget_aliases(m);
+}
+
+esp_err_t aws_iot_client_init(aws_iot_client_t *client, const aws_iot_config_t *config)
+{
+    ESP_RETURN_ON_FALSE(client, ESP_ERR_INVALID_ARG, TAG, "client handle is NULL");
+    ESP_RETURN_ON_FALSE(config && config->endpoint && config->client_id && config->root_ca && config->client_cert &&
+                            config->client_key,
+                        ESP_ERR_INVALID_ARG, TAG, "configuration is invalid");
+
+    memset(client, 0, sizeof(*client));
+    struct aws_iot_mqtt5 *m = calloc(1, sizeof(*m));
+    ESP_RETURN_ON_FALSE(m, ESP_ERR_NO_MEM, TAG, "no memory for client");
+    m->rx_fd = -1;
+
+    esp_vfs_eventfd_config_t eventfd_cfg = ESP_VFS_EVENTD_CONFIG_DEFAULT();
+    esp_err_t err = esp_vfs_eventfd_register(&eventfd_cfg);
+    if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) {
+        free(m);
+        return err;
+    }
+    m->events = xEventGroupCreate();
+    m->rx = xQueueCreate(MQTT5_RX_QUEUE_LEN, sizeof(mqtt5_rx_msg_t *));
+    m->rx_fd = eventfd(0, 0);
+    client->mqtt5 = m;
+    if (!m->events || !m->rx || m->rx_fd < 0) {
+        ESP_LOGE(TAG, "Failed to create client primitives");
+        aws_iot_client_deinit(client);
+        return ESP_ERR_NO_MEM;
+    }
+
+    // Lengths include the terminator of a PEM string, which esp-tls wants
+    m->cfg = (esp_mqtt_client_config_t){
+        .broker.address.hostname = config->endpoint,
+        .broker.address.port = config->port ? config->port : 8883,
+        .broker.address.transport = MQTT_TRANSPORT_OVER_SSL,
+        .broker.verification.certificate = config->root_ca,
+        .broker.verification.certificate_len = config->root_ca_len,
+        .credentials.client_id = config->client_id,
+        .credentials.authentication.certificate = config->client_cert,
+        .credentials.authentication.certificate_len = config->client_cert_len,
+        .credentials.authentication.key = config->client_key,
+        .credentials.authentication.key_len = config->client_key_len,
+        .session.keepalive = (int)(config->keepalive_sec ? config->keepalive_sec : 60),
+        .session.disable_clean_session = !config->clean_session,
+        .session.protocol_ver = MQTT_PROTOCOL_V_5,
+        // Reconnects are the caller's, as with the SDK client
+        .network.disable_auto_reconnect = true,
+    };
+    m->alias_limit = CONFIG_NAPHOME_AWS_IOT_MQTT5_TOPIC_ALIASES;
+    client->initialized = true;
+    client->connected = false;
+    return ESP_OK;
+}
+
+esp_err_t aws_iot_client_connect(aws_iot_client_t *client)
+{
+    ESP_RETURN_ON_FALSE(client, ESP_ERR_INVALID_ARG, TAG, "client handle is NULL");
+    ESP_RETURN_ON_FALSE(client->initialized, ESP_ERR_INVALID_STATE, TAG, "client not initialised");
+    struct aws_iot_mqtt5 *m = client->mqtt5;
+
+    ESP_LOGI(TAG, "Attempting AWS IoT MQTT 5 connection to %s:%" PRIu32 " (client_id=%s)",
+             m->cfg.broker.address.hostname, m->cfg.broker.address.port, m->cfg.credentials.client_id);
+
+    mqtt5_destroy_handle(m);
+    m->dropped = false;
+    xEventGroupClearBits(m->events, MQTT5_CONNECTED_BIT | MQTT5_FAILED_BIT);
+    m->handle = esp_mqtt_client_init(&m->cfg);
+    ESP_RETURN_ON_FALSE(m->handle, ESP_ERR_NO_MEM, TAG, "esp_mqtt_client_init failed");
+
+    // A session the broker keeps (clean start off) outlives the connection
+    esp_mqtt5_connection_property_config_t connect_props = {
+        .session_expiry_interval = m->cfg.session.disable_clean_session ? UINT32_MAX : 0,
+    };
+    esp_err_t err = esp_mqtt5_client_set_connect_property(m->handle, &connect_props);
+    if (err == ESP_OK) {
+        err = esp_mqtt_client_register_event(m->handle, MQTT_EVENT_ANY, mqtt5_event_handler, client);
+    }
+    if (err == ESP_OK) {
+        err = esp_mqtt_client_start(m->handle);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "esp-mqtt start failed (%s)", esp_err_to_name(err));
+        mqtt5_destroy_handle(m);
+        return err;
+    }
+
+    EventBits_t bits = xEventGroupWaitBits(m->events, MQTT5_CONNECTED_BIT | MQTT5_FAILED_BIT, pdFALSE, pdFALSE,
+                                           pdMS_TO_TICKS(MQTT5_CONNECT_TIMEOUT_MS));
+    if (!(bits & MQTT5_CONNECTED_BIT)) {
+        ESP_LOGE(TAG, "MQTT 5 connect %s", (bits & MQTT5_FAILED_BIT) ? "failed" : "timed out");
+        mqtt5_destroy_handle(m);
+        client->connected = false;
+        return (bits & MQTT5_FAILED_BIT) ? ESP_ERR_INVALID_RESPONSE : ESP_ERR_TIMEOUT;
+    }
+
+    ESP_LOGI(TAG, "Connected to AWS IoT Core over MQTT 5");
+    return ESP_OK;
+}
+
+esp_err_t aws_iot_client_disconnect(aws_iot_client_t *client)
+{
+    ESP_RETURN_ON_FALSE(client, ESP_ERR_INVALID_ARG, TAG, "client handle is NULL");
+    ESP_RETURN_ON_FALSE(client->initialized, ESP_ERR_INVALID_STATE, TAG, "client not initialised");
+
+    client->connected = false;
+    mqtt5_destroy_handle(client->mqtt5);
+    return ESP_OK;
+}
+
+void aws_iot_client_deinit(aws_iot_client_t *client)
+{
+    struct aws_iot_mqtt5 *m = client ? client->mqtt5 : NULL;
+    if (!m) {
+        return;
+    }
+    mqtt5_destroy_handle(m);
+    if (m->rx) {
+        vQueueDelete(m->rx);
+    }
+    if (m->events) {
+        vEventGroupDelete(m->events);
+    }
+    if (m->rx_fd >= 0) {
+        close(m->rx_fd);
+    }
+    free(m);
+    client->mqtt5 = NULL;
+    client->initialized = false;
+    client->connected = false;
+}
+
+esp_err_t aws_iot_client_yield(aws_iot_client_t *client, uint32_t timeout_ms)
+{
+    ESP_RETURN_ON_FALSE(client, ESP_ERR_INVALID_ARG, TAG, "client handle is NULL");
+    ESP_RETURN_ON_FALSE(client->initialized, ESP_ERR_INVALID_STATE, TAG, "client not initialised");
+    struct aws_iot_mqtt5 *m = client->mqtt5;
+
+    mqtt5_rx_msg_t *msg;
+    TickType_t wait = pdMS_TO_TICKS(timeout_ms);
+    while (xQueueReceive(m->rx, &msg, wait) == pdTRUE) {
+        wait = 0;
+        IoT_Publish_Message_Params params = {
+            .qos = msg->qos,
+            .isRetained = msg->retain,
+            .isDup = msg->dup,
+            .id = msg->id,
+            .payload = msg->data + msg->topic_len + 1,
+            .payloadLen = msg->payload_len,
+        };
+        // Like the SDK: every matching subscription gets it
+        for (size_t i = 0; i < m->sub_count; ++i) {
+            if (mqtt5_topic_matches(m->subs[i].filter, msg->data, msg->topic_len)) {
+                m->subs[i].handler(&client->client, msg->data, (uint16_t)msg->topic_len, &params, m->subs[i].ctx);
+            }
+        }
+        free(msg);
+    }
+
+    if (m->dropped) {
+        m->dropped = false;
+        ESP_LOGW(TAG, "AWS IoT disconnected");
+        if (client->disconnect_cb) {
+            client->disconnect_cb(&client->client, client->disconnect_ctx);
+        }
+    }
+    return client->connected ? ESP_OK : ESP_ERR_INVALID_STATE;
+}
+
+esp_err_t aws_iot_client_wait(aws_iot_client_t *client, int wake_fd, uint32_t max_wait_ms)
+{
+    ESP_RETURN_ON_FALSE(client, ESP_ERR_INVALID_ARG, TAG, "client handle is NULL");
+    ESP_RETURN_ON_FALSE(client->initialized, ESP_ERR_INVALID_STATE, TAG, "client not initialised");
+    struct aws_iot_mqtt5 *m = client->mqtt5;
+    if (!client->connected && !m->dropped) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    // esp-mqtt sends the keepalive itself, so only messages and drops matter
+    if (uxQueueMessagesWaiting(m->rx) > 0 || m->dropped) {
+        return ESP_OK;
+    }
+
+    fd_set readable;
+    FD_ZERO(&readable);
+    FD_SET(m->rx_fd, &readable);
+    if (wake_fd >= 0) {
+        FD_SET(wake_fd, &readable);
+    }
+    struct timeval tv = {
+        .tv_sec = max_wait_ms / 1000,
+        .tv_usec = (max_wait_ms % 1000) * 1000,
+    };
+    int ready = select((m->rx_fd > wake_fd ? m->rx_fd : wake_fd) + 1, &readable, NULL, NULL, &tv);
+    if (ready < 0) {
+        if (errno != EINTR) {
+            ESP_LOGW(TAG, "select failed (errno %d)", errno);
+        }
+        return ESP_ERR_TIMEOUT;
+    }
+
+    uint64_t count;
+    if (wake_fd >= 0 && FD_ISSET(wake_fd, &readable)) {
+        (void)read(wake_fd, &count, sizeof(count));
+    }
+    if (ready > 0 && FD_ISSET(m->rx_fd, &readable)) {
+        (void)read(m->rx_fd, &count, sizeof(count));
+        return ESP_OK;
+    }
+    return ESP_ERR_TIMEOUT;
+}
+
+// Alias for the topic, and whether this publish must still carry the topic
+// to bind it; 0 when the topic goes out in full
+static uint16_t mqtt5_alias_for(struct aws_iot_mqtt5 *m, const char *topic, bool *bind)
+{
+    if (m->alias_limit == 0) {
+        return 0;
+    }
+    size_t slots = m->alias_limit < sizeof(m->aliases) / sizeof(m->aliases[0])
+                       ? m->alias_limit
+                       : sizeof(m->aliases) / sizeof(m->aliases[0]);
+    size_t victim = 0;
+    for (size_t i = 0; i < slots; ++i) {
+        mqtt5_alias_t *a = &m->aliases[i];
+        if (a->topic && strcmp(a->topic, topic) == 0) {
+            a->last_used = ++m->alias_clock;
+            *bind = false;
+            return (uint16_t)(i + 1);
+        }
+        if (!a->topic || (m->aliases[victim].topic && a->last_used < m->aliases[victim].last_used)) {
+            victim = i;
+        }
+    }
+    // Rebinding the least recently used alias costs one full topic
+    char *copy = strdup(topic);
+    if (!copy) {
+        return 0;
+    }
+    free(m->aliases[victim].topic);
+    m->aliases[victim].topic = copy;
+    m->aliases[victim].last_used = ++m->alias_clock;
+    *bind = true;
+    return (uint16_t)(victim + 1);
+}
+
+static esp_err_t mqtt5_publish(aws_iot_client_t *client, const char *topic, QoS qos, const void *payload,
+                               size_t payload_len, bool retain, const aws_iot_publish_props_t *props)
+{
+    struct aws_iot_mqtt5 *m = client->mqtt5;
+    ESP_RETURN_ON_FALSE(m->handle && client->connected, ESP_ERR_INVALID_STATE, TAG, "not connected");
+
+    bool bind = true;
+    uint16_t alias = mqtt5_alias_for(m, topic, &bind);
+    esp_mqtt5_publish_property_config_t publish_props = {
+        .topic_alias = alias,
+    };
+    if (props) {
+        publish_props.message_expiry_interval = props->expiry_sec;
+        publish_props.content_type = props->content_type;
+        // Tells the broker the payload is UTF-8
+        publish_props.payload_format_indicator =
+            props->content_type && (strncmp(props->content_type, "text/", 5) == 0 ||
+                                    strcmp(props->content_type, "application/json") == 0);
+        if (props->user_key && props->user_value) {
+            esp_mqtt5_user_property_item_t item = { props->user_key, props->user_value };
+            esp_mqtt5_client_set_user_property(&publish_props.user_property, &item, 1);
+        }
+    }
+    esp_mqtt5_client_set_publish_property(m->handle, &publish_props);
+    int id = esp_mqtt_client_publish(m->handle, bind ? topic : "", payload, (int)payload_len, qos, retain);
+    if (id < 0 && alias) {
+        // The broker allows fewer aliases than configured: full topics from now on
+        ESP_LOGW(TAG, "Topic alias %u refused, sending full topics on this connection", alias);
+        mqtt5_forget_aliases(m);
+        m->alias_limit = 0;
+        publish_props.topic_alias = 0;
+        esp_mqtt5_client_set_publish_property(m->handle, &publish_props);
+        id = esp_mqtt_client_publish(m->handle, topic, payload, (int)payload_len, qos, retain);
+    }
+    esp_mqtt5_client_delete_user_property(publish_props.user_property);
+    if (id < 0) {
+        ESP_LOGE(TAG, "esp_mqtt_client_publish failed on %s", topic);
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+esp_err_t aws_iot_client_publish(aws_iot_client_t *client,
+                                 const char *topic,
+                                 QoS qos,
+                                 const void *payload,
+                                 size_t payload_len,
+                                 bool retain)
+{
+    return aws_iot_client_publish_props(client, topic, qos, payload, payload_len, retain, NULL);
+}
+
+esp_err_t aws_iot_client_publish_props(aws_iot_client_t *client,
+                                       const char *topic,
+                                       QoS qos,
+                                       const void *payload,
+                                       size_t payload_len,
+                                       bool retain,
+                                       const aws_iot_publish_props_t *props)
+{
+    ESP_RETURN_ON_FALSE(client, ESP_ERR_INVALID_ARG, TAG, "client handle is NULL");
+    ESP_RETURN_ON_FALSE(topic && payload, ESP_ERR_INVALID_ARG, TAG, "topic/payload invalid");
+    ESP_RETURN_ON_FALSE(client->initialized, ESP_ERR_INVALID_STATE, TAG, "client not initialised");
+    return mqtt5_publish(client, topic, qos, payload, payload_len, retain, props);
+}
+
+esp_err_t aws_iot_client_subscribe(aws_iot_client_t *client,
+                                   const char *topic,
+                                   QoS qos,
+                                   pApplicationHandler_t handler,
+                                   void *handler_ctx)
+{
+    ESP_RETURN_ON_FALSE(client, ESP_ERR_INVALID_ARG, TAG, "client handle is NULL");
+    ESP_RETURN_ON_FALSE(topic && handler, ESP_ERR_INVALID_ARG, TAG, "topic/handler invalid");
+    ESP_RETURN_ON_FALSE(client->initialized, ESP_ERR_INVALID_STATE, TAG, "client not initialised");
+    struct aws_iot_mqtt5 *m = client->mqtt5;
+    ESP_RETURN_ON_FALSE(m->sub_count < AWS_IOT_MQTT_NUM_SUBSCRIBE_HANDLERS, ESP_ERR_INVALID_STATE, TAG,
+                        "subscription table full");
+    ESP_RETURN_ON_FALSE(m->handle && client->connected, ESP_ERR_INVALID_STATE, TAG, "not connected");
+
+    if (esp_mqtt_client_subscribe(m->handle, topic, qos) < 0) {
+        ESP_LOGE(TAG, "esp_mqtt_client_subscribe failed on %s", topic);
+        return ESP_FAIL;
+    }
+    m->subs[m->sub_count++] = (mqtt5_sub_t){
+        .filter = topic,
+        .qos = qos,
+        .handler = handler,
+        .ctx = handler_ctx,
+    };
+    return ESP_OK;
+}
+
+bool aws_iot_client_is_connected(const aws_iot_client_t *client)
+{
+    if (!client) {
+        return false;
+    }
+
+    return client->connected;
+}
+
+bool aws_iot_client_session_present(const aws_iot_client_t *client)
+{
+    if (!client || !client->connected) {
+        return false;
+    }
+
+    return client->mqtt5->session_present;
+}
+
+esp_err_t aws_iot_client_resubscribe(aws_iot_client_t *client)
+{
+    ESP_RETURN_ON_FALSE(client, ESP_ERR_INVALID_ARG, TAG, "client handle is NULL");
+    ESP_RETURN_ON_FALSE(client->initialized, ESP_ERR_INVALID_STATE, TAG, "client not initialised");
+    struct aws_iot_mqtt5 *m = client->mqtt5;
+    ESP_RETURN_ON_FALSE(m->handle && client->connected, ESP_ERR_INVALID_STATE, TAG, "not connected");
+
+    for (size_t i = 0; i < m->sub_count; ++i) {
+        if (esp_mqtt_client_subscribe(m->handle, m->subs[i].filter, m->subs[i].qos) < 0) {
+            ESP_LOGE(TAG, "Resubscribe failed on %s", m->subs[i].filter);
+            return ESP_FAIL;
+        }
+    }
+    return ESP_OK;
+}
+
+void aws_iot_client_set_disconnect_callback(aws_iot_client_t *client,
+                                            aws_iot_disconnect_cb_t cb,
+                                            void *ctx)
+{
+    if (!client) {
+        return;
+    }
+
+    client->disconnect_cb = cb;
+    client->disconnect_ctx = ctx;
+}
+
+AWS_IoT_Client *aws_iot_client_get_mqtt_client(aws_iot_client_t *client)
+{
+    (void)client;
+    return NULL;
+}
@@ -1,11 +1,18 @@
 #include "aws_iot_service.h"
 
+#include <errno.h>
+#include <inttypes.h>
+#include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
 #include "esp_check.h"
 #include "esp_event.h"
 #include "esp_log.h"
 #include "esp_netif.h"
+#include "esp_random.h"
+#include "esp_timer.h"
+#include "esp_vfs_eventfd.h"
 #include "esp_wifi.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/event_groups.h"
@@ -16,8 +23,57 @@
 
 #define AWS_IOT_SERVICE_TASK_STACK (8 * 1024)
 #define AWS_IOT_SERVICE_TASK_PRIO   5
+#ifndef CONFIG_NAPHOME_AWS_IOT_TASK_CORE
+#define CONFIG_NAPHOME_AWS_IOT_TASK_CORE 0
+#endif
+#ifndef CONFIG_NAPHOME_AWS_IOT_RECONNECT_BASE_MS
+#define CONFIG_NAPHOME_AWS_IOT_RECONNECT_BASE_MS 1000
+#endif
+#ifndef CONFIG_NAPHOME_AWS_IOT_RECONNECT_MAX_MS
+#define CONFIG_NAPHOME_AWS_IOT_RECONNECT_MAX_MS 60000
+#endif
+#ifndef CONFIG_NAPHOME_AWS_IOT_OUTBOX_SLOTS
+#define CONFIG_NAPHOME_AWS_IOT_OUTBOX_SLOTS 16
+#endif
+#ifndef CONFIG_NAPHOME_AWS_IOT_OUTBOX_BYTES
+#define CONFIG_NAPHOME_AWS_IOT_OUTBOX_BYTES 16384
+#endif
+// Publish errors while connected before a message is dropped
+#define AWS_IOT_SERVICE_OUTBOX_MAX_ATTEMPTS 3
 #define AWS_IOT_SERVICE_HAS_IP_BIT  BIT0
 #define AWS_IOT_SERVICE_STOP_BIT    BIT1
+#define AWS_IOT_SERVICE_WAKE_BIT    BIT2  // Cuts a backoff wait short
+// Event-driven receive: yield only long enough to drain what arrived, and
+// re-check the loop at least this often even if nothing wakes it
+#define AWS_IOT_SERVICE_RX_YIELD_MS     20
+#define AWS_IOT_SERVICE_IDLE_WAIT_MS    30000
+// Topics added with aws_iot_service_add_subscription(); the SDK table holds
+// AWS_IOT_MQTT_NUM_SUBSCRIBE_HANDLERS, one of them the configured topic
+#define AWS_IOT_SERVICE_EXTRA_TOPICS    (AWS_IOT_MQTT_NUM_SUBSCRIBE_HANDLERS - 1)
+#define AWS_IOT_SERVICE_EXTRA_TOPIC_MAX 64
+
+// One allocation holds the topic, its terminator, then the payload
+typedef struct {
+    char *buf;
+    size_t topic_len;
+    size_t payload_len;
+    uint32_t seq;
+    int64_t queued_us;
+    aws_iot_publish_props_t props;
+    QoS qos;
+    aws_iot_service_priority_t priority;
+    uint8_t attempts;
+    bool coalesce;
+    bool sending;
+} outbox_entry_t;
+
+typedef struct {
+    outbox_entry_t slots[CONFIG_NAPHOME_AWS_IOT_OUTBOX_SLOTS];
+    size_t bytes;
+    uint32_t next_seq;
+    bool accepting;
+    aws_iot_service_outbox_stats_t stats;
+} outbox_t;
 
 typedef struct {
     aws_iot_service_config_t cfg;
@@ -28,12 +84,26 @@ typedef struct {
     esp_event_handler_instance_t ip_handler;
     bool should_run;
     bool subscribed;
+    bool handler_registered;          // Subscribe handler is in the SDK table
+    uint32_t extra_registered;        // Extra topics in the SDK table
+    uint32_t reconnect_attempt;       // Failures since the last good connect
 } aws_iot_service_ctx_t;
 
 static const char *TAG = "aws_iot_srv";
 static aws_iot_service_ctx_t s_ctx = { 0 };
 static bool s_was_connected = false; // Track previous connection state for LED updates
-
+// Kept out of s_ctx, which start/stop clear while producers may still call in
+static outbox_t s_outbox;
+static portMUX_TYPE s_outbox_lock = portMUX_INITIALIZER_UNLOCKED;
+// eventfd the task selects on next to the socket; created once and never
+// closed, so a late publish can never write to a reused descriptor
+static int s_wake_fd = -1;
+// Only ever appended to: the SDK keeps pointers to the topics it subscribed
+static char s_extra_topics[AWS_IOT_SERVICE_EXTRA_TOPICS][AWS_IOT_SERVICE_EXTRA_TOPIC_MAX];
+static uint32_t s_extra_count;
+static portMUX_TYPE s_extra_lock = portMUX_INITIALIZER_UNLOCKED;
+
+#ifndef CONFIG_NAPHOME_AWS_IOT_EVENT_DRIVEN_RX
 static uint32_t resolve_yield_timeout_ms(const aws_iot_service_config_t *cfg)
 {
     if (cfg && cfg->yield_timeout_ms) {
@@ -41,6 +111,7 @@ static uint32_t resolve_yield_timeout_ms(const aws_iot_service_config_t *cfg)
     }
     return CONFIG_NAPHOME_AWS_IOT_YIELD_TIMEOUT_MS;
 }
+#endif
 
 static QoS resolve_subscribe_qos(const aws_iot_service_config_t *cfg)
 {
@@ -71,6 +142,313 @@ static pApplicationHandler_t resolve_subscribe_handler(const aws_iot_service_con
     return NULL;
 }
 
+static esp_err_t aws_iot_service_wake_init(void)
+{
+#ifdef CONFIG_NAPHOME_AWS_IOT_EVENT_DRIVEN_RX
+    if (s_wake_fd >= 0) {
+        return ESP_OK;
+    }
+    esp_vfs_eventfd_config_t eventfd_cfg = ESP_VFS_EVENTD_CONFIG_DEFAULT();
+    esp_err_t err = esp_vfs_eventfd_register(&eventfd_cfg);
+    // ESP_ERR_INVALID_STATE: another component registered it already
+    ESP_RETURN_ON_FALSE(err == ESP_OK || err == ESP_ERR_INVALID_STATE, err, TAG, "eventfd register failed");
+    s_wake_fd = eventfd(0, 0);
+    ESP_RETURN_ON_FALSE(s_wake_fd >= 0, ESP_FAIL, TAG, "eventfd failed (errno %d)", errno);
+#endif
+    return ESP_OK;
+}
+
+// Interrupt the task's select() so it notices new work right away
+static void aws_iot_service_wake(void)
+{
+    if (s_wake_fd >= 0) {
+        uint64_t one = 1;
+        (void)write(s_wake_fd, &one, sizeof(one));
+    }
+}
+
+static size_t outbox_entry_bytes(const outbox_entry_t *entry)
+{
+    return entry->topic_len + 1 + entry->payload_len;
+}
+
+// Caller holds the lock; returns the buffer for the caller to free outside it
+static char *outbox_remove(outbox_entry_t *entry)
+{
+    char *buf = entry->buf;
+    s_outbox.bytes -= outbox_entry_bytes(entry);
+    s_outbox.stats.queued--;
+    memset(entry, 0, sizeof(*entry));
+    return buf;
+}
+
+// Oldest waiting entry of the lowest priority below the given one
+static outbox_entry_t *outbox_find_victim(aws_iot_service_priority_t below)
+{
+    outbox_entry_t *victim = NULL;
+    for (size_t i = 0; i < CONFIG_NAPHOME_AWS_IOT_OUTBOX_SLOTS; ++i) {
+        outbox_entry_t *entry = &s_outbox.slots[i];
+        if (!entry->buf || entry->sending || entry->priority >= below) {
+            continue;
+        }
+        if (!victim || entry->priority < victim->priority ||
+            (entry->priority == victim->priority && (int32_t)(entry->seq - victim->seq) < 0)) {
+            victim = entry;
+        }
+    }
+    return victim;
+}
+
+// Whether replacing and evicting would make room, before touching anything
+static bool outbox_can_fit(size_t bytes, aws_iot_service_priority_t priority, const outbox_entry_t *replaced)
+{
+    size_t free_bytes = CONFIG_NAPHOME_AWS_IOT_OUTBOX_BYTES - s_outbox.bytes;
+    bool free_slot = false;
+    for (size_t i = 0; i < CONFIG_NAPHOME_AWS_IOT_OUTBOX_SLOTS; ++i) {
+        const outbox_entry_t *entry = &s_outbox.slots[i];
+        if (!entry->buf) {
+            free_slot = true;
+        } else if (entry == replaced || (!entry->sending && entry->priority < priority)) {
+            free_slot = true;
+            free_bytes += outbox_entry_bytes(entry);
+        }
+    }
+    return free_slot && free_bytes >= bytes;
+}
+
+esp_err_t aws_iot_service_publish(const char *topic,
+                                  QoS qos,
+                                  const void *payload,
+                                  size_t payload_len,
+                                  aws_iot_service_priority_t priority,
+                                  bool coalesce)
+{
+    return aws_iot_service_publish_props(topic, qos, payload, payload_len, priority, coalesce, NULL);
+}
+
+esp_err_t aws_iot_service_publish_props(const char *topic,
+                                        QoS qos,
+                                        const void *payload,
+                                        size_t payload_len,
+                                        aws_iot_service_priority_t priority,
+                                        bool coalesce,
+                                        const aws_iot_publish_props_t *props)
+{
+    // Checked again under the lock; this only spares the copy
+    if (!s_outbox.accepting) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    ESP_RETURN_ON_FALSE(topic && topic[0] && (payload || payload_len == 0), ESP_ERR_INVALID_ARG, TAG,
+                        "topic/payload invalid");
+    size_t topic_len = strlen(topic);
+    size_t bytes = topic_len + 1 + payload_len;
+    ESP_RETURN_ON_FALSE(bytes <= CONFIG_NAPHOME_AWS_IOT_OUTBOX_BYTES, ESP_ERR_INVALID_SIZE, TAG,
+                        "message larger than the outbox");
+
+    char *buf = malloc(bytes);
+    if (!buf) {
+        return ESP_ERR_NO_MEM;
+    }
+    memcpy(buf, topic, topic_len + 1);
+    if (payload_len) {
+        memcpy(buf + topic_len + 1, payload, payload_len);
+    }
+    int64_t now_us = esp_timer_get_time();
+
+    // Buffers this call displaces, freed once the lock is released
+    char *released[CONFIG_NAPHOME_AWS_IOT_OUTBOX_SLOTS + 1];
+    size_t released_count = 0;
+    esp_err_t err = ESP_OK;
+
+    taskENTER_CRITICAL(&s_outbox_lock);
+    if (!s_outbox.accepting) {
+        released[released_count++] = buf;
+        err = ESP_ERR_INVALID_STATE;
+        goto unlock;
+    }
+    outbox_entry_t *replaced = NULL;
+    for (size_t i = 0; coalesce && i < CONFIG_NAPHOME_AWS_IOT_OUTBOX_SLOTS && !replaced; ++i) {
+        outbox_entry_t *entry = &s_outbox.slots[i];
+        if (entry->buf && entry->coalesce && !entry->sending && entry->topic_len == topic_len &&
+            memcmp(entry->buf, topic, topic_len) == 0) {
+            replaced = entry;
+        }
+    }
+    if (!outbox_can_fit(bytes, priority, replaced)) {
+        released[released_count++] = buf;
+        s_outbox.stats.rejected++;
+        err = ESP_ERR_NO_MEM;
+        goto unlock;
+    }
+    if (replaced) {
+        released[released_count++] = outbox_remove(replaced);
+        s_outbox.stats.coalesced++;
+    }
+
+    outbox_entry_t *slot = NULL;
+    for (;;) {
+        for (size_t i = 0; i < CONFIG_NAPHOME_AWS_IOT_OUTBOX_SLOTS && !slot; ++i) {
+            if (!s_outbox.slots[i].buf) {
+                slot = &s_outbox.slots[i];
+            }
+        }
+        if (slot && s_outbox.bytes + bytes <= CONFIG_NAPHOME_AWS_IOT_OUTBOX_BYTES) {
+            break;
+        }
+        // outbox_can_fit() guarantees a victim until both hold
+        outbox_entry_t *victim = outbox_find_victim(priority);
+        released[released_count++] = outbox_remove(victim);
+        s_outbox.stats.evicted++;
+        if (!slot) {
+            slot = victim;
+        }
+    }
+    *slot = (outbox_entry_t){
+        .buf = buf,
+        .topic_len = topic_len,
+        .payload_len = payload_len,
+        .seq = s_outbox.next_seq++,
+        .queued_us = now_us,
+        .props = props ? *props : (aws_iot_publish_props_t){ 0 },
+        .qos = qos,
+        .priority = priority,
+        .coalesce = coalesce,
+    };
+    s_outbox.bytes += bytes;
+    s_outbox.stats.queued++;
+    if (s_outbox.stats.queued > s_outbox.stats.high_water) {
+        s_outbox.stats.high_water = s_outbox.stats.queued;
+    }
+unlock:
+    taskEXIT_CRITICAL(&s_outbox_lock);
+
+    for (size_t i = 0; i < released_count; ++i) {
+        free(released[i]);
+    }
+    if (err == ESP_OK) {
+        aws_iot_service_wake();
+    }
+    return err;
+}
+
+void aws_iot_service_get_outbox_stats(aws_iot_service_outbox_stats_t *stats)
+{
+    if (!stats) {
+        return;
+    }
+    taskENTER_CRITICAL(&s_outbox_lock);
+    *stats = s_outbox.stats;
+    stats->queued_bytes = (uint32_t)s_outbox.bytes;
+    taskEXIT_CRITICAL(&s_outbox_lock);
+}
+
+// Highest priority, then oldest; marked sending so producers leave it alone
+static outbox_entry_t *outbox_take_next(void)
+{
+    outbox_entry_t *next = NULL;
+    taskENTER_CRITICAL(&s_outbox_lock);
+    for (size_t i = 0; i < CONFIG_NAPHOME_AWS_IOT_OUTBOX_SLOTS; ++i) {
+        outbox_entry_t *entry = &s_outbox.slots[i];
+        if (!entry->buf || entry->sending) {
+            continue;
+        }
+        if (!next || entry->priority > next->priority ||
+            (entry->priority == next->priority && (int32_t)(entry->seq - next->seq) < 0)) {
+            next = entry;
+        }
+    }
+    if (next) {
+        next->sending = true;
+    }
+    taskEXIT_CRITICAL(&s_outbox_lock);
+    return next;
+}
+
+// Publish what is queued now; a failure leaves the message first in line
+// for the next pass, up to AWS_IOT_SERVICE_OUTBOX_MAX_ATTEMPTS
+static void outbox_drain(aws_iot_client_t *client)
+{
+    for (size_t sent = 0; sent < CONFIG_NAPHOME_AWS_IOT_OUTBOX_SLOTS; ++sent) {
+        outbox_entry_t *entry = outbox_take_next();
+        if (!entry) {
+            return;
+        }
+        // Only this task touches a sending entry, so no lock for the publish
+        aws_iot_publish_props_t props = entry->props;
+        bool expired = false;
+        if (props.expiry_sec) {
+            // The broker counts the expiry from when it gets the message
+            int64_t age_sec = (esp_timer_get_time() - entry->queued_us) / 1000000;
+            expired = age_sec >= props.expiry_sec;
+            props.expiry_sec -= expired ? props.expiry_sec : (uint32_t)age_sec;
+        }
+        esp_err_t err = expired ? ESP_OK
+                                : aws_iot_client_publish_props(client, entry->buf, entry->qos,
+                                                               entry->buf + entry->topic_len + 1, entry->payload_len,
+                                                               false, &props);
+        char *done = NULL;
+        taskENTER_CRITICAL(&s_outbox_lock);
+        if (expired) {
+            done = outbox_remove(entry);
+            s_outbox.stats.expired++;
+        } else if (err == ESP_OK) {
+            done = outbox_remove(entry);
+            s_outbox.stats.sent++;
+        } else if (++entry->attempts >= AWS_IOT_SERVICE_OUTBOX_MAX_ATTEMPTS) {
+            // Most likely one the SDK can never send, e.g. too large
+            done = outbox_remove(entry);
+            s_outbox.stats.failed++;
+        } else {
+            entry->sending = false;
+        }
+        taskEXIT_CRITICAL(&s_outbox_lock);
+        free(done);
+        if (err != ESP_OK) {
+            return;
+        }
+    }
+}
+
+static void outbox_open(void)
+{
+    taskENTER_CRITICAL(&s_outbox_lock);
+    s_outbox.accepting = true;
+    taskEXIT_CRITICAL(&s_outbox_lock);
+}
+
+// Drop whatever is still waiting; counters survive for diagnostics
+static void outbox_close(void)
+{
+    char *released[CONFIG_NAPHOME_AWS_IOT_OUTBOX_SLOTS];
+    size_t released_count = 0;
+    taskENTER_CRITICAL(&s_outbox_lock);
+    s_outbox.accepting = false;
+    for (size_t i = 0; i < CONFIG_NAPHOME_AWS_IOT_OUTBOX_SLOTS; ++i) {
+        if (s_outbox.slots[i].buf) {
+            released[released_count++] = outbox_remove(&s_outbox.slots[i]);
+        }
+    }
+    taskEXIT_CRITICAL(&s_outbox_lock);
+    for (size_t i = 0; i < released_count; ++i) {
+        free(released[i]);
+    }
+}
+
+// Full jitter: wait uniformly in [0, min(max, base * 2^attempt)]
+static void aws_iot_service_backoff(aws_iot_service_ctx_t *ctx, const char *why)
+{
+    uint32_t shift = ctx->reconnect_attempt < 16 ? ctx->reconnect_attempt : 16;
+    uint64_t ceiling = (uint64_t)CONFIG_NAPHOME_AWS_IOT_RECONNECT_BASE_MS << shift;
+    if (ceiling > CONFIG_NAPHOME_AWS_IOT_RECONNECT_MAX_MS) {
+        ceiling = CONFIG_NAPHOME_AWS_IOT_RECONNECT_MAX_MS;
+    }
+    uint32_t wait_ms = esp_random() % ((uint32_t)ceiling + 1);
+    ctx->reconnect_attempt++;
+
+    ESP_LOGI(TAG, "%s, retrying in %" PRIu32 " ms (attempt %" PRIu32 ")", why, wait_ms, ctx->reconnect_attempt);
+    xEventGroupWaitBits(ctx->events, AWS_IOT_SERVICE_WAKE_BIT, pdTRUE, pdFALSE, pdMS_TO_TICKS(wait_ms));
+}
+
 static void aws_iot_service_event_handler(void *arg,
                                           esp_event_base_t event_base,
                                           int32_t event_id,
@@ -81,18 +459,21 @@ static void aws_iot_service_event_handler(void *arg,
 
     if (event_base == IP_EVENT && event_id == IP_EVENT_STA_GOT_IP) {
         ESP_LOGI(TAG, "Wi-Fi got IP address, enabling AWS IoT service");
-        xEventGroupSetBits(ctx->events, AWS_IOT_SERVICE_HAS_IP_BIT);
+        xEventGroupSetBits(ctx->events, AWS_IOT_SERVICE_HAS_IP_BIT | AWS_IOT_SERVICE_WAKE_BIT);
     } else if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_DISCONNECTED) {
         ESP_LOGW(TAG, "Wi-Fi disconnected, suspending AWS IoT service");
         xEventGroupClearBits(ctx->events, AWS_IOT_SERVICE_HAS_IP_BIT);
         ctx->subscribed = false;
+        aws_iot_service_wake();
     }
 }
 
 static void aws_iot_service_task(void *arg)
 {
     aws_iot_service_ctx_t *ctx = (aws_iot_service_ctx_t *)arg;
+#ifndef CONFIG_NAPHOME_AWS_IOT_EVENT_DRIVEN_RX
     const uint32_t yield_timeout_ms = resolve_yield_timeout_ms(&ctx->cfg);
+#endif
 
     ESP_LOGI(TAG, "AWS IoT service task started");
 
@@ -108,20 +489,19 @@ static void aws_iot_service_task(void *arg)
         }
 
         if (!ctx->client.initialized) {
-            esp_err_t err = ESP_FAIL;
-            if (ctx->cfg.config_loader) {
-                aws_iot_config_t custom_cfg = AWS_IOT_CONFIG_DEFAULT();
-                err = ctx->cfg.config_loader(&custom_cfg, ctx->cfg.config_loader_ctx);
-                if (err == ESP_OK) {
-                    err = aws_iot_client_init(&ctx->client, &custom_cfg);
-                }
-            } else {
-                err = aws_iot_client_init_from_settings(&ctx->client);
+            aws_iot_config_t client_cfg = AWS_IOT_CONFIG_DEFAULT();
+            esp_err_t err = ctx->cfg.config_loader
+                                ? ctx->cfg.config_loader(&client_cfg, ctx->cfg.config_loader_ctx)
+                                : aws_iot_config_load_from_kconfig(&client_cfg);
+            if (err == ESP_OK) {
+                // This task paces reconnects; the SDK's own retry has no jitter
+                client_cfg.auto_reconnect = false;
+                err = aws_iot_client_init(&ctx->client, &client_cfg);
             }
 
             if (err != ESP_OK) {
-                ESP_LOGE(TAG, "aws_iot_client_init_from_settings failed (%s)", esp_err_to_name(err));
-                vTaskDelay(pdMS_TO_TICKS(1000));
+                ESP_LOGE(TAG, "aws_iot_client_init failed (%s)", esp_err_to_name(err));
+                aws_iot_service_backoff(ctx, "Init failed");
                 continue;
             }
         }
@@ -131,18 +511,25 @@ static void aws_iot_service_task(void *arg)
         // Track connection state (LED updates disabled when AWS IoT is disabled)
         if (is_connected != s_was_connected) {
             s_was_connected = is_connected;
+            if (!is_connected) {
+                // Spread out a fleet that lost the broker at the same moment
+                aws_iot_service_backoff(ctx, "Connection lost");
+                continue;
+            }
         }
         
         if (!is_connected) {
             esp_err_t err = aws_iot_client_connect(&ctx->client);
             if (err != ESP_OK) {
                 ESP_LOGW(TAG, "aws_iot_client_connect failed (%s)", esp_err_to_name(err));
-                vTaskDelay(pdMS_TO_TICKS(2000));
+                aws_iot_service_backoff(ctx, "Connect failed");
                 continue;
             }
 
             ctx->subscribed = false;
-            ESP_LOGI(TAG, "AWS IoT connection established");
+            ctx->reconnect_attempt = 0;
+            ESP_LOGI(TAG, "AWS IoT connection established (session %s)",
+                     aws_iot_client_session_present(&ctx->client) ? "resumed" : "new");
 
             if (ctx->cfg.on_connected) {
                 ctx->cfg.on_connected(&ctx->client, ctx->cfg.on_connected_ctx);
@@ -153,17 +540,25 @@ static void aws_iot_service_task(void *arg)
             const char *topic = resolve_subscribe_topic(&ctx->cfg);
             pApplicationHandler_t handler = resolve_subscribe_handler(&ctx->cfg);
             if (topic && handler) {
-                esp_err_t err = aws_iot_client_subscribe(&ctx->client,
-                                                         topic,
-                                                         resolve_subscribe_qos(&ctx->cfg),
-                                                         handler,
-                                                         ctx->cfg.subscribe_ctx);
+                esp_err_t err = ESP_OK;
+                if (!ctx->handler_registered) {
+                    err = aws_iot_client_subscribe(&ctx->client,
+                                                   topic,
+                                                   resolve_subscribe_qos(&ctx->cfg),
+                                                   handler,
+                                                   ctx->cfg.subscribe_ctx);
+                    ctx->handler_registered = err == ESP_OK;
+                } else if (!aws_iot_client_session_present(&ctx->client)) {
+                    // Subscribing again would add a second handler to the SDK table
+                    err = aws_iot_client_resubscribe(&ctx->client);
+                }
+
                 if (err == ESP_OK) {
                     ctx->subscribed = true;
                     ESP_LOGI(TAG, "Subscribed to %s", topic);
                 } else {
                     ESP_LOGW(TAG, "Failed to subscribe to %s (%s)", topic, esp_err_to_name(err));
-                    vTaskDelay(pdMS_TO_TICKS(2000));
+                    aws_iot_service_backoff(ctx, "Subscribe failed");
                     continue;
                 }
             } else {
@@ -171,7 +566,40 @@ static void aws_iot_service_task(void *arg)
             }
         }
 
+        // A resubscribe above covered the ones already in the table
+        uint32_t extra_count = __atomic_load_n(&s_extra_count, __ATOMIC_ACQUIRE);
+        if (ctx->extra_registered < extra_count && resolve_subscribe_handler(&ctx->cfg)) {
+            const char *topic = s_extra_topics[ctx->extra_registered];
+            esp_err_t err = aws_iot_client_subscribe(&ctx->client,
+                                                     topic,
+                                                     resolve_subscribe_qos(&ctx->cfg),
+                                                     resolve_subscribe_handler(&ctx->cfg),
+                                                     ctx->cfg.subscribe_ctx);
+            if (err != ESP_OK) {
+                ESP_LOGW(TAG, "Failed to subscribe to %s (%s)", topic, esp_err_to_name(err));
+                aws_iot_service_backoff(ctx, "Subscribe failed");
+                continue;
+            }
+            ESP_LOGI(TAG, "Subscribed to %s", topic);
+            ctx->extra_registered++;
+            continue;
+        }
+
+        // Everything queued goes out before the yield, so throughput does not
+        // depend on the yield timeout; new messages wait at most one yield
+        outbox_drain(&ctx->client);
+
+#ifdef CONFIG_NAPHOME_AWS_IOT_EVENT_DRIVEN_RX
+        // Sleep until a packet arrives, the keepalive is due, or a publish,
+        // Wi-Fi loss or stop wakes us; then yield only to process it
+        esp_err_t err = aws_iot_client_wait(&ctx->client, s_wake_fd, AWS_IOT_SERVICE_IDLE_WAIT_MS);
+        if (err == ESP_ERR_TIMEOUT) {
+            continue;
+        }
+        err = aws_iot_client_yield(&ctx->client, AWS_IOT_SERVICE_RX_YIELD_MS);
+#else
         esp_err_t err = aws_iot_client_yield(&ctx->client, yield_timeout_ms);
+#endif
         if (err != ESP_OK) {
             ESP_LOGW(TAG, "aws_iot_client_yield returned %s", esp_err_to_name(err));
             vTaskDelay(pdMS_TO_TICKS(250));
@@ -183,6 +611,7 @@ static void aws_iot_service_task(void *arg)
         aws_iot_client_disconnect(&ctx->client);
     }
 
+    aws_iot_client_deinit(&ctx->client);
     memset(&ctx->client, 0, sizeof(ctx->client));
     ctx->task = NULL;
     xEventGroupSetBits(ctx->events, AWS_IOT_SERVICE_STOP_BIT);
@@ -198,10 +627,13 @@ esp_err_t aws_iot_service_start(const aws_iot_service_config_t *config)
     }
 
     memset(&s_ctx, 0, sizeof(s_ctx));
+    s_was_connected = false;
     if (config) {
         s_ctx.cfg = *config;
     }
 
+    ESP_RETURN_ON_ERROR(aws_iot_service_wake_init(), TAG, "Failed to create wake eventfd");
+
     s_ctx.events = xEventGroupCreate();
     ESP_RETURN_ON_FALSE(s_ctx.events, ESP_ERR_NO_MEM, TAG, "Failed to create event group");
 
@@ -224,6 +656,7 @@ esp_err_t aws_iot_service_start(const aws_iot_service_config_t *config)
         "Failed to register Wi-Fi handler");
 
     s_ctx.should_run = true;
+    outbox_open();
 
     esp_netif_t *sta = esp_netif_get_handle_from_ifkey("WIFI_STA_DEF");
     if (sta) {
@@ -233,14 +666,16 @@ esp_err_t aws_iot_service_start(const aws_iot_service_config_t *config)
         }
     }
 
-    BaseType_t created = xTaskCreate(aws_iot_service_task,
-                                     "aws_iot_service",
-                                     AWS_IOT_SERVICE_TASK_STACK,
-                                     &s_ctx,
-                                     AWS_IOT_SERVICE_TASK_PRIO,
-                                     &s_ctx.task);
+    BaseType_t created = xTaskCreatePinnedToCore(aws_iot_service_task,
+                                                 "aws_iot_service",
+                                                 AWS_IOT_SERVICE_TASK_STACK,
+                                                 &s_ctx,
+                                                 AWS_IOT_SERVICE_TASK_PRIO,
+                                                 &s_ctx.task,
+                                                 CONFIG_NAPHOME_AWS_IOT_TASK_CORE);
     if (created != pdPASS) {
         ESP_LOGE(TAG, "Failed to create AWS IoT service task");
+        outbox_close();
         esp_event_handler_instance_unregister(IP_EVENT, IP_EVENT_STA_GOT_IP, s_ctx.ip_handler);
         esp_event_handler_instance_unregister(WIFI_EVENT, WIFI_EVENT_STA_DISCONNECTED, s_ctx.wifi_disconnect_handler);
         vEventGroupDelete(s_ctx.events);
@@ -259,6 +694,8 @@ esp_err_t aws_iot_service_stop(void)
 
     s_ctx.should_run = false;
     xEventGroupClearBits(s_ctx.events, AWS_IOT_SERVICE_HAS_IP_BIT);
+    xEventGroupSetBits(s_ctx.events, AWS_IOT_SERVICE_WAKE_BIT);
+    aws_iot_service_wake();
 
     if (s_ctx.task) {
         EventBits_t bits = xEventGroupWaitBits(s_ctx.events,
@@ -271,6 +708,8 @@ esp_err_t aws_iot_service_stop(void)
         }
     }
 
+    outbox_close();
+
     if (s_ctx.ip_handler) {
         esp_event_handler_instance_unregister(IP_EVENT, IP_EVENT_STA_GOT_IP, s_ctx.ip_handler);
     }
@@ -286,6 +725,30 @@ esp_err_t aws_iot_service_stop(void)
     return ESP_OK;
 }
 
+esp_err_t aws_iot_service_add_subscription(const char *topic)
+{
+    ESP_RETURN_ON_FALSE(topic && topic[0] && strlen(topic) < AWS_IOT_SERVICE_EXTRA_TOPIC_MAX, ESP_ERR_INVALID_ARG,
+                        TAG, "topic invalid");
+    esp_err_t err = ESP_OK;
+    portENTER_CRITICAL(&s_extra_lock);
+    uint32_t count = s_extra_count;
+    bool present = false;
+    for (uint32_t i = 0; i < count && !present; ++i) {
+        present = strcmp(s_extra_topics[i], topic) == 0;
+    }
+    if (!present && count == AWS_IOT_SERVICE_EXTRA_TOPICS) {
+        err = ESP_ERR_NO_MEM;
+    } else if (!present) {
+        strcpy(s_extra_topics[count], topic);
+        __atomic_store_n(&s_extra_count, count + 1, __ATOMIC_RELEASE);
+    }
+    portEXIT_CRITICAL(&s_extra_lock);
+    if (err == ESP_OK) {
+        aws_iot_service_wake();
+    }
+    return err;
+}
+
 bool aws_iot_service_is_running(void)
 {
     return s_ctx.should_run;
@@ -0,0 +1,140 @@
+/**
+ * @file deferred_log.h
+ * @brief Logging for hot paths: the call site stores a format ID and the
+ *        raw arguments, and the text is made later by a low-priority task.
+ *
+ * DLOGI() and friends take the same arguments as ESP_LOGI(). Each call
+ * site owns a static deferred_log_site_t with its level and format; the
+ * site's address is the format ID. A call copies the ID, the tag pointer, a
+ * timestamp and the arguments' raw values into a ring owned by the calling
+ * core, with only that core's interrupts masked for the copy, so cores
+ * never contend. A record that does not fit is dropped and counted.
+ *
+ * The argument layout comes from the format string, parsed once per site
+ * on its first call: integer conversions up to 32 bits and %p take 4 bytes,
+ * ll/j conversions and floating point 8, and %s a length byte and up to
+ * CONFIG_DEFERRED_LOG_STRING_MAX characters. A format the parser does not
+ * take (%n, %L, more than DEFERRED_LOG_MAX_ARGS arguments) is logged
+ * straight through esp_log instead.
+ *
+ * One task drains the rings with deferred_log_drain(), in timestamp order,
+ * and either formats each record with deferred_log_print() or forwards it
+ * unformatted to a host that resolves the IDs from the firmware ELF
+ * (scripts/capture_logs.py --elf).
+ */
+
+#pragma once
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_log.h"
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DEFERRED_LOG_MAX_ARGS 8
+
+/**
+ * @brief One DLOG* call site. Only format and level are set by the macro;
+ *        the rest is filled in on the first call.
+ */
+typedef struct {
+    const char *format;               // First member: the host reads it from the ELF at the site's address
+    uint8_t level;                    // esp_log_level_t
+    uint8_t state;                    // deferred_log_site_state_t (atomic)
+    uint8_t nargs;
+    uint8_t kinds[DEFERRED_LOG_MAX_ARGS];   // deferred_log_arg_kind_t
+    uint8_t limits[DEFERRED_LOG_MAX_ARGS];  // %s: fixed precision, 0 = none
+} deferred_log_site_t;
+
+typedef enum {
+    DEFERRED_LOG_SITE_NEW,
+    DEFERRED_LOG_SITE_READY,
+    DEFERRED_LOG_SITE_DIRECT,         // Format not supported: logged through esp_log as it happens
+} deferred_log_site_state_t;
+
+typedef enum {
+    DEFERRED_LOG_ARG_I32,             // int and smaller, long, size_t, char
+    DEFERRED_LOG_ARG_I64,             // long long, intmax_t
+    DEFERRED_LOG_ARG_F64,             // float and double (promoted)
+    DEFERRED_LOG_ARG_PTR,             // %p
+    DEFERRED_LOG_ARG_STR,             // %s: length byte, then the characters without a terminator
+    DEFERRED_LOG_ARG_PRECISION,       // The int of a %.*s, which bounds the string that follows
+} deferred_log_arg_kind_t;
+
+/**
+ * @brief Record header, followed by args_len bytes of arguments in format
+ *        order. Also the payload of the serial link's LOG frame.
+ */
+typedef struct __attribute__((packed)) {
+    uint32_t site;                    // Address of the deferred_log_site_t: the format ID
+    uint32_t tag;                     // Address of the tag string
+    uint32_t time_ms;                 // esp_log_timestamp()
+    uint8_t core;
+    uint8_t level;
+    uint16_t args_len;
+} deferred_log_record_t;
+
+// record's arguments follow it in the same buffer; both are valid only during the call
+typedef void (*deferred_log_sink_t)(const deferred_log_record_t *record, void *ctx);
+
+#if CONFIG_DEFERRED_LOG_ENABLE
+
+#define DLOG_LEVEL(lvl, tag, fmt, ...) do {                                            \
+        if (LOG_LOCAL_LEVEL >= (lvl)) {                                                \
+            static deferred_log_site_t _dlog_site = {.format = (fmt), .level = (lvl)}; \
+            deferred_log_write(&_dlog_site, (tag), (fmt), ##__VA_ARGS__);              \
+        }                                                                              \
+    } while (0)
+
+#else
+
+#define DLOG_LEVEL(level, tag, format, ...) ESP_LOG_LEVEL_LOCAL(level, tag, format, ##__VA_ARGS__)
+
+#endif
+
+#define DLOGE(tag, format, ...) DLOG_LEVEL(ESP_LOG_ERROR, tag, format, ##__VA_ARGS__)
+#define DLOGW(tag, format, ...) DLOG_LEVEL(ESP_LOG_WARN, tag, format, ##__VA_ARGS__)
+#define DLOGI(tag, format, ...) DLOG_LEVEL(ESP_LOG_INFO, tag, format, ##__VA_ARGS__)
+#define DLOGD(tag, format, ...) DLOG_LEVEL(ESP_LOG_DEBUG, tag, format, ##__VA_ARGS__)
+#define DLOGV(tag, format, ...) DLOG_LEVEL(ESP_LOG_VERBOSE, tag, format, ##__VA_ARGS__)
+
+/**
+ * @brief Record one message; use the DLOG* macros. format is the site's
+ *        own, passed again so the compiler checks the arguments against it.
+ *
+ * Never blocks. Safe from any task, and from ISRs that are not in IRAM.
+ */
+void deferred_log_write(deferred_log_site_t *site, const char *tag, const char *format, ...)
+    __attribute__((format(printf, 3, 4)));
+
+/**
+ * @brief Pass every pending record to sink, oldest first across the cores.
+ *
+ * Call from one task only.
+ *
+ * @return Records passed
+ */
+size_t deferred_log_drain(deferred_log_sink_t sink, void *ctx);
+
+/**
+ * @brief Format a drained record's message, without the level, time and
+ *        tag prefix.
+ *
+ * @return Characters written, not counting the terminator
+ */
+size_t deferred_log_format(const deferred_log_record_t *record, char *out, size_t size);
+
+// Sink that prints a record through esp_log_write(), which filters by the tag's level
+void deferred_log_print(const deferred_log_record_t *record, void *ctx);
+
+// Records dropped on full rings since boot, over all cores
+uint32_t deferred_log_dropped(void);
+
+#ifdef __cplusplus
+}
+#endif
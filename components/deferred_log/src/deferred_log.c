@@ -0,0 +1,466 @@
+/**
+ * @file deferred_log.c
+ */
+
+#include "deferred_log.h"
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+
+#if CONFIG_DEFERRED_LOG_ENABLE
+
+#define DEFERRED_LOG_CORES portNUM_PROCESSORS
+#define DEFERRED_LOG_RING CONFIG_DEFERRED_LOG_RING_BYTES
+// Every argument fits in a length byte plus the longest string
+#define DEFERRED_LOG_MAX_RECORD (sizeof(deferred_log_record_t) + DEFERRED_LOG_MAX_ARGS * (1 + CONFIG_DEFERRED_LOG_STRING_MAX))
+#define DEFERRED_LOG_LINE_MAX 256
+#define DEFERRED_LOG_SPEC_MAX 24
+
+/*
+ * Single producer (the owning core, interrupts masked) and single consumer
+ * (the drain). Offsets stay below the ring size and one byte is always
+ * left free, so head == tail means empty.
+ */
+typedef struct {
+    uint8_t buf[DEFERRED_LOG_RING];
+    uint32_t head;                    // Written by the owning core (atomic)
+    uint32_t tail;                    // Written by the drain (atomic)
+    uint32_t dropped;                 // (atomic)
+} ring_t;
+
+typedef struct {
+    const char *start;                // The '%'
+    size_t len;                       // Through the conversion character
+    uint8_t kind;                     // deferred_log_arg_kind_t of the value
+    uint8_t stars;                    // '*' ints before the value: width, precision or both
+    bool star_precision;              // The last of them is the precision
+    bool supported;
+    int precision;                    // Fixed precision, -1 when none
+} spec_t;
+
+typedef union {
+    uint32_t u32;
+    uint64_t u64;
+    double f64;
+    const char *str;
+} arg_value_t;
+
+static ring_t s_rings[DEFERRED_LOG_CORES];
+static uint8_t s_record[DEFERRED_LOG_MAX_RECORD];  // The drain's copy of the record it is passing on
+
+static const char LEVEL_LETTERS[] = "NEWIDV";
+
+// Next conversion from p on; NULL at the end of the format
+static const char *next_spec(const char *p, spec_t *spec)
+{
+    while (*p) {
+        if (p[0] == '%' && p[1] == '%') {
+            p += 2;
+        } else if (p[0] == '%') {
+            break;
+        } else {
+            p++;
+        }
+    }
+    if (!*p) {
+        return NULL;
+    }
+    memset(spec, 0, sizeof(*spec));
+    spec->start = p++;
+    spec->precision = -1;
+    while (*p && strchr("-+ #0", *p)) {
+        p++;
+    }
+    if (*p == '*') {
+        spec->stars++;
+        p++;
+    }
+    while (*p >= '0' && *p <= '9') {
+        p++;
+    }
+    if (*p == '.') {
+        p++;
+        if (*p == '*') {
+            spec->stars++;
+            spec->star_precision = true;
+            p++;
+        } else {
+            spec->precision = 0;
+            while (*p >= '0' && *p <= '9') {
+                spec->precision = spec->precision * 10 + (*p++ - '0');
+            }
+        }
+    }
+    int longs = 0;
+    bool wide = false;
+    while (*p && strchr("hljzt", *p)) {
+        longs += *p == 'l';
+        wide |= *p == 'j';
+        p++;
+    }
+    // Anything else, long double's L included, leaves the site to esp_log
+    char conv = *p;
+    spec->supported = true;
+    if (conv && strchr("diouxXc", conv)) {
+        spec->kind = longs >= 2 || wide ? DEFERRED_LOG_ARG_I64 : DEFERRED_LOG_ARG_I32;
+    } else if (conv && strchr("fFeEgGaA", conv)) {
+        spec->kind = DEFERRED_LOG_ARG_F64;
+    } else if (conv == 's' && longs == 0) {
+        spec->kind = DEFERRED_LOG_ARG_STR;
+    } else if (conv == 'p') {
+        spec->kind = DEFERRED_LOG_ARG_PTR;
+    } else {
+        spec->supported = false;
+    }
+    if (!conv) {
+        spec->len = (size_t)(p - spec->start);
+        return p;
+    }
+    spec->len = (size_t)(p + 1 - spec->start);
+    return p + 1;
+}
+
+// Fill in the site's argument layout; racing cores write the same values
+static uint8_t site_parse(deferred_log_site_t *site)
+{
+    uint8_t state = DEFERRED_LOG_SITE_READY;
+    size_t nargs = 0;
+    spec_t spec;
+    const char *p = site->format;
+    while (state == DEFERRED_LOG_SITE_READY && (p = next_spec(p, &spec)) != NULL) {
+        if (!spec.supported || nargs + spec.stars + 1 > DEFERRED_LOG_MAX_ARGS) {
+            state = DEFERRED_LOG_SITE_DIRECT;
+            break;
+        }
+        for (uint8_t i = 0; i < spec.stars; ++i) {
+            bool bound = spec.star_precision && i == spec.stars - 1 && spec.kind == DEFERRED_LOG_ARG_STR;
+            site->limits[nargs] = 0;
+            site->kinds[nargs++] = bound ? DEFERRED_LOG_ARG_PRECISION : DEFERRED_LOG_ARG_I32;
+        }
+        site->limits[nargs] = spec.precision > 0 ? (uint8_t)(spec.precision > 255 ? 255 : spec.precision) : 0;
+        site->kinds[nargs++] = spec.kind;
+    }
+    site->nargs = (uint8_t)nargs;
+    __atomic_store_n(&site->state, state, __ATOMIC_RELEASE);
+    return state;
+}
+
+static void log_direct(const deferred_log_site_t *site, const char *tag, const char *format, va_list ap)
+{
+    esp_log_level_t level = (esp_log_level_t)site->level;
+    esp_log_write(level, tag, "%c (%" PRIu32 ") %s: ", LEVEL_LETTERS[level], esp_log_timestamp(), tag);
+    esp_log_writev(level, tag, format, ap);
+    esp_log_write(level, tag, "\n");
+}
+
+static uint32_t ring_used(uint32_t head, uint32_t tail)
+{
+    return (head + DEFERRED_LOG_RING - tail) % DEFERRED_LOG_RING;
+}
+
+static void ring_put(ring_t *ring, uint32_t *pos, const void *data, size_t len)
+{
+    size_t first = DEFERRED_LOG_RING - *pos;
+    if (first > len) {
+        first = len;
+    }
+    memcpy(ring->buf + *pos, data, first);
+    memcpy(ring->buf, (const uint8_t *)data + first, len - first);
+    *pos = (uint32_t)((*pos + len) % DEFERRED_LOG_RING);
+}
+
+static void ring_get(const ring_t *ring, uint32_t pos, void *data, size_t len)
+{
+    size_t first = DEFERRED_LOG_RING - pos;
+    if (first > len) {
+        first = len;
+    }
+    memcpy(data, ring->buf + pos, first);
+    memcpy((uint8_t *)data + first, ring->buf, len - first);
+}
+
+void deferred_log_write(deferred_log_site_t *site, const char *tag, const char *format, ...)
+{
+    uint8_t state = __atomic_load_n(&site->state, __ATOMIC_ACQUIRE);
+    if (state == DEFERRED_LOG_SITE_NEW) {
+        state = site_parse(site);
+    }
+    va_list ap;
+    va_start(ap, format);
+    if (state == DEFERRED_LOG_SITE_DIRECT) {
+        log_direct(site, tag, format, ap);
+        va_end(ap);
+        return;
+    }
+
+    // Values and string lengths first, so the masked copy below is short
+    arg_value_t values[DEFERRED_LOG_MAX_ARGS];
+    uint8_t str_lens[DEFERRED_LOG_MAX_ARGS];
+    size_t args_len = 0;
+    int bound = -1;
+    for (uint8_t i = 0; i < site->nargs; ++i) {
+        switch (site->kinds[i]) {
+        case DEFERRED_LOG_ARG_I32:
+        case DEFERRED_LOG_ARG_PRECISION:
+            values[i].u32 = va_arg(ap, uint32_t);
+            bound = site->kinds[i] == DEFERRED_LOG_ARG_PRECISION ? (int)values[i].u32 : -1;
+            args_len += 4;
+            break;
+        case DEFERRED_LOG_ARG_I64:
+            values[i].u64 = va_arg(ap, uint64_t);
+            args_len += 8;
+            break;
+        case DEFERRED_LOG_ARG_F64:
+            values[i].f64 = va_arg(ap, double);
+            args_len += 8;
+            break;
+        case DEFERRED_LOG_ARG_PTR:
+            values[i].u32 = (uint32_t)(uintptr_t)va_arg(ap, void *);
+            args_len += 4;
+            break;
+        case DEFERRED_LOG_ARG_STR: {
+            values[i].str = va_arg(ap, const char *);
+            if (!values[i].str) {
+                values[i].str = "(null)";
+            }
+            size_t max = CONFIG_DEFERRED_LOG_STRING_MAX;
+            if (site->limits[i] && site->limits[i] < max) {
+                max = site->limits[i];
+            }
+            if (bound >= 0 && (size_t)bound < max) {
+                max = (size_t)bound;
+            }
+            str_lens[i] = (uint8_t)strnlen(values[i].str, max);
+            args_len += 1 + str_lens[i];
+            bound = -1;
+            break;
+        }
+        }
+    }
+    va_end(ap);
+
+    deferred_log_record_t record = {
+        .site = (uint32_t)(uintptr_t)site,
+        .tag = (uint32_t)(uintptr_t)tag,
+        .time_ms = esp_log_timestamp(),
+        .level = site->level,
+        .args_len = (uint16_t)args_len,
+    };
+    // Masking this core's interrupts keeps other writers on it out; the other core has its own ring
+    UBaseType_t irq = portSET_INTERRUPT_MASK_FROM_ISR();
+    record.core = (uint8_t)xPortGetCoreID();
+    ring_t *ring = &s_rings[record.core];
+    uint32_t head = ring->head;
+    uint32_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+    if (DEFERRED_LOG_RING - 1 - ring_used(head, tail) < sizeof(record) + args_len) {
+        __atomic_fetch_add(&ring->dropped, 1, __ATOMIC_RELAXED);
+        portCLEAR_INTERRUPT_MASK_FROM_ISR(irq);
+        return;
+    }
+    ring_put(ring, &head, &record, sizeof(record));
+    for (uint8_t i = 0; i < site->nargs; ++i) {
+        switch (site->kinds[i]) {
+        case DEFERRED_LOG_ARG_I64:
+        case DEFERRED_LOG_ARG_F64:
+            ring_put(ring, &head, &values[i], 8);
+            break;
+        case DEFERRED_LOG_ARG_STR:
+            ring_put(ring, &head, &str_lens[i], 1);
+            ring_put(ring, &head, values[i].str, str_lens[i]);
+            break;
+        default:
+            ring_put(ring, &head, &values[i].u32, 4);
+            break;
+        }
+    }
+    __atomic_store_n(&ring->head, head, __ATOMIC_RELEASE);
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(irq);
+}
+
+size_t deferred_log_drain(deferred_log_sink_t sink, void *ctx)
+{
+    size_t passed = 0;
+    while (true) {
+        // The oldest record at the front of any ring
+        ring_t *oldest = NULL;
+        deferred_log_record_t front;
+        for (int core = 0; core < DEFERRED_LOG_CORES; ++core) {
+            ring_t *ring = &s_rings[core];
+            if (__atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) == ring->tail) {
+                continue;
+            }
+            deferred_log_record_t record;
+            ring_get(ring, ring->tail, &record, sizeof(record));
+            if (!oldest || (int32_t)(record.time_ms - front.time_ms) < 0) {
+                oldest = ring;
+                front = record;
+            }
+        }
+        if (!oldest) {
+            return passed;
+        }
+        size_t len = sizeof(front) + front.args_len;
+        ring_get(oldest, oldest->tail, s_record, len);
+        __atomic_store_n(&oldest->tail, (uint32_t)((oldest->tail + len) % DEFERRED_LOG_RING), __ATOMIC_RELEASE);
+        if (sink) {
+            sink((const deferred_log_record_t *)s_record, ctx);
+        }
+        passed++;
+    }
+}
+
+// Literal text from p to end, with %% collapsed; returns the new length
+static size_t emit_literal(const char *p, const char *end, char *out, size_t size, size_t n)
+{
+    while (p < end && n + 1 < size) {
+        out[n++] = *p;
+        p += p[0] == '%' ? 2 : 1;
+    }
+    return n;
+}
+
+size_t deferred_log_format(const deferred_log_record_t *record, char *out, size_t size)
+{
+    if (size == 0) {
+        return 0;
+    }
+    const deferred_log_site_t *site = (const deferred_log_site_t *)(uintptr_t)record->site;
+    const uint8_t *args = (const uint8_t *)(record + 1);
+    const uint8_t *args_end = args + record->args_len;
+    size_t n = 0;
+    const char *p = site->format;
+    spec_t spec;
+    const char *next;
+    while ((next = next_spec(p, &spec)) != NULL) {
+        n = emit_literal(p, spec.start, out, size, n);
+        p = next;
+        char fmt[DEFERRED_LOG_SPEC_MAX];
+        if (spec.len >= sizeof(fmt) || n + 1 >= size) {
+            break;
+        }
+        memcpy(fmt, spec.start, spec.len);
+        fmt[spec.len] = '\0';
+
+        int stars[2] = {0, 0};
+        for (uint8_t i = 0; i < spec.stars && args + 4 <= args_end; ++i) {
+            memcpy(&stars[i], args, 4);
+            args += 4;
+        }
+        size_t value_len = spec.kind == DEFERRED_LOG_ARG_STR ? 1 : (spec.kind == DEFERRED_LOG_ARG_I64 || spec.kind == DEFERRED_LOG_ARG_F64) ? 8 : 4;
+        if (args + value_len > args_end) {
+            break;
+        }
+        char *dst = out + n;
+        size_t room = size - n;
+        int written = 0;
+#define EMIT(value)                                                                                  \
+        (spec.stars == 0 ? snprintf(dst, room, fmt, value)                                           \
+         : spec.stars == 1 ? snprintf(dst, room, fmt, stars[0], value)                               \
+                           : snprintf(dst, room, fmt, stars[0], stars[1], value))
+        switch (spec.kind) {
+        case DEFERRED_LOG_ARG_I64: {
+            uint64_t v;
+            memcpy(&v, args, 8);
+            written = EMIT(v);
+            break;
+        }
+        case DEFERRED_LOG_ARG_F64: {
+            double v;
+            memcpy(&v, args, 8);
+            written = EMIT(v);
+            break;
+        }
+        case DEFERRED_LOG_ARG_PTR: {
+            uint32_t v;
+            memcpy(&v, args, 4);
+            written = EMIT((void *)(uintptr_t)v);
+            break;
+        }
+        case DEFERRED_LOG_ARG_STR: {
+            char str[CONFIG_DEFERRED_LOG_STRING_MAX + 1];
+            size_t len = args[0];
+            if (args + 1 + len > args_end || len > CONFIG_DEFERRED_LOG_STRING_MAX) {
+                args = args_end;
+                break;
+            }
+            memcpy(str, args + 1, len);
+            str[len] = '\0';
+            value_len = 1 + len;
+            written = EMIT(str);
+            break;
+        }
+        default: {
+            uint32_t v;
+            memcpy(&v, args, 4);
+            written = EMIT(v);
+            break;
+        }
+        }
+#undef EMIT
+        args += value_len;
+        if (written > 0) {
+            n += (size_t)written < room ? (size_t)written : room - 1;
+        }
+    }
+    if (!next) {
+        n = emit_literal(p, p + strlen(p), out, size, n);
+    }
+    out[n] = '\0';
+    return n;
+}
+
+void deferred_log_print(const deferred_log_record_t *record, void *ctx)
+{
+    (void)ctx;
+    static char text[DEFERRED_LOG_LINE_MAX];  // Only the drain task prints
+    static const char *const COLORS[] = {"", LOG_COLOR_E, LOG_COLOR_W, LOG_COLOR_I, LOG_COLOR_D, LOG_COLOR_V};
+    deferred_log_format(record, text, sizeof(text));
+    esp_log_level_t level = record->level <= ESP_LOG_VERBOSE ? (esp_log_level_t)record->level : ESP_LOG_VERBOSE;
+    const char *tag = (const char *)(uintptr_t)record->tag;
+    esp_log_write(level, tag, "%s%c (%" PRIu32 ") %s: %s%s\n", COLORS[level], LEVEL_LETTERS[level], record->time_ms,
+                  tag, text, level == ESP_LOG_NONE ? "" : LOG_RESET_COLOR);
+}
+
+uint32_t deferred_log_dropped(void)
+{
+    uint32_t dropped = 0;
+    for (int core = 0; core < DEFERRED_LOG_CORES; ++core) {
+        dropped += __atomic_load_n(&s_rings[core].dropped, __ATOMIC_RELAXED);
+    }
+    return dropped;
+}
+
+#else
+
+size_t deferred_log_drain(deferred_log_sink_t sink, void *ctx)
+{
+    (void)sink;
+    (void)ctx;
+    return 0;
+}
+
+size_t deferred_log_format(const deferred_log_record_t *record, char *out, size_t size)
+{
+    (void)record;
+    if (size) {
+        out[0] = '\0';
+    }
+    return 0;
+}
+
+void deferred_log_print(const deferred_log_record_t *record, void *ctx)
+{
+    (void)record;
+    (void)ctx;
+}
+
+uint32_t deferred_log_dropped(void)
+{
+    return 0;
+}
+
+#endif
@@ -272,6 +272,7 @@ typedef struct _ClientData {
 	uint16_t keepAliveInterval; ///< Maximum interval between control packets
 	uint32_t currentReconnectWaitInterval; ///< Current backoff period for reconnect
 	uint32_t counterNetworkDisconnected; ///< How many times this client detected a disconnection
+	bool sessionPresent; ///< CONNACK session present flag from the last successful connect
 
 	/* The below values are initialized with the
 	 * lengths of the TX/RX buffers and never modified
@@ -387,6 +387,9 @@ static IoT_Error_t _aws_iot_mqtt_internal_connect(AWS_IoT_Client *pClient, IoT_C
 		FUNC_EXIT_RC(connack_rc);
 	}
 
+	/* Broker kept our subscriptions and queued QoS1 messages (cleanSession = 0) */
+	pClient->clientData.sessionPresent = (0 != sessionPresent);
+
 	/* Ensure that a ping request is sent after keepAliveInterval. */
 	pClient->clientStatus.isPingOutstanding = false;
 	countdown_sec(&pClient->pingReqTimer, pClient->clientData.keepAliveInterval);
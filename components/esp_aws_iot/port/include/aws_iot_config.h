@@ -46,8 +46,9 @@
 #define CONFIG_AWS_IOT_MQTT_RX_BUF_LEN 2048
 #endif
 
+// Command topic, three device shadow topics and up to four gateway peers
 #ifndef CONFIG_AWS_IOT_MQTT_NUM_SUBSCRIBE_HANDLERS
-#define CONFIG_AWS_IOT_MQTT_NUM_SUBSCRIBE_HANDLERS 4
+#define CONFIG_AWS_IOT_MQTT_NUM_SUBSCRIBE_HANDLERS 8
 #endif
 
 #ifndef CONFIG_AWS_IOT_SHADOW_MAX_SIZE_OF_THING_NAME
@@ -25,8 +25,10 @@
 #include "network_platform.h"
 
 #include "mbedtls/esp_debug.h"
+#include "mbedtls/version.h"
 
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "esp_vfs.h"
 
 static const char *TAG = "aws_iot";
@@ -34,6 +36,129 @@ static const char *TAG = "aws_iot";
 /* This is the value used for ssl read timeout */
 #define IOT_SSL_READ_TIMEOUT 10
 
+#ifdef CONFIG_NAPHOME_AWS_IOT_ECDSA_HANDSHAKE
+/*
+ * With a P-256 device key nothing in the handshake needs another curve:
+ * ECDHE on secp256r1, a P-256 signature and AES-GCM on the AES peripheral.
+ * The server's own key only costs a public-key verify, so ECDHE-RSA leads
+ * and works with the Amazon Root CA 1 chain every root_ca.pem carries;
+ * ECDSA server suites follow for trust stores that also hold Root CA 3.
+ */
+static const int s_p256_ciphersuites[] = {
+#ifdef MBEDTLS_SSL_PROTO_TLS1_3
+    MBEDTLS_TLS1_3_AES_128_GCM_SHA256,
+#endif
+    MBEDTLS_TLS_ECDHE_RSA_WITH_AES_128_GCM_SHA256,
+    MBEDTLS_TLS_ECDHE_ECDSA_WITH_AES_128_GCM_SHA256,
+    MBEDTLS_TLS_ECDHE_RSA_WITH_AES_256_GCM_SHA384,
+    MBEDTLS_TLS_ECDHE_ECDSA_WITH_AES_256_GCM_SHA384,
+    0,
+};
+#if MBEDTLS_VERSION_NUMBER >= 0x03000000
+static const uint16_t s_p256_groups[] = {
+    MBEDTLS_SSL_IANA_TLS_GROUP_SECP256R1,
+    MBEDTLS_SSL_IANA_TLS_GROUP_NONE,
+};
+#else
+static const mbedtls_ecp_group_id s_p256_curves[] = {
+    MBEDTLS_ECP_DP_SECP256R1,
+    MBEDTLS_ECP_DP_NONE,
+};
+#endif
+#endif
+
+#if CONFIG_NAPHOME_AWS_IOT_TLS_MAX_FRAGMENT > 0 && defined(MBEDTLS_SSL_MAX_FRAGMENT_LENGTH)
+/* Largest of the four lengths the extension can carry that fits the setting */
+static unsigned char s_max_frag_len_code(void) {
+#if CONFIG_NAPHOME_AWS_IOT_TLS_MAX_FRAGMENT >= 4096
+    return MBEDTLS_SSL_MAX_FRAG_LEN_4096;
+#elif CONFIG_NAPHOME_AWS_IOT_TLS_MAX_FRAGMENT >= 2048
+    return MBEDTLS_SSL_MAX_FRAG_LEN_2048;
+#elif CONFIG_NAPHOME_AWS_IOT_TLS_MAX_FRAGMENT >= 1024
+    return MBEDTLS_SSL_MAX_FRAG_LEN_1024;
+#else
+    return MBEDTLS_SSL_MAX_FRAG_LEN_512;
+#endif
+}
+#endif
+
+#ifdef CONFIG_NAPHOME_AWS_IOT_TLS_RESUMPTION
+/*
+ * Session (ticket or session ID) from the last completed handshake, offered
+ * on the next connect so a reconnect skips the certificate exchange and the
+ * private-key signature. The device talks to a single endpoint, so one slot
+ * keyed by host name is enough.
+ */
+static mbedtls_ssl_session s_saved_session;
+static char s_saved_session_host[128];
+static bool s_saved_session_valid;
+
+static void _iot_tls_forget_session(void) {
+    if (s_saved_session_valid) {
+        mbedtls_ssl_session_free(&s_saved_session);
+        s_saved_session_valid = false;
+    }
+}
+
+static void _iot_tls_save_session(mbedtls_ssl_context *ssl, const char *host) {
+    _iot_tls_forget_session();
+    if (strlen(host) >= sizeof(s_saved_session_host)) {
+        return;
+    }
+    mbedtls_ssl_session_init(&s_saved_session);
+    if (mbedtls_ssl_get_session(ssl, &s_saved_session) != 0) {
+        mbedtls_ssl_session_free(&s_saved_session);
+        return;
+    }
+    strcpy(s_saved_session_host, host);
+    s_saved_session_valid = true;
+}
+#endif
+
+/*
+ * Credentials handed over as DER (somnus_mqtt caches them that way) are one
+ * or more DER structures back to back, ended by a NUL byte. DER always
+ * opens with a SEQUENCE tag, which PEM text and paths never do.
+ */
+static bool _iot_tls_is_der(const char *buf) {
+    return (unsigned char)buf[0] == 0x30;
+}
+
+/* Whole length of the DER structure at p, or 0 if its header is unusable */
+static size_t _iot_tls_der_len(const unsigned char *p) {
+    if(p[1] < 0x80) {
+        return 2 + p[1];
+    }
+    size_t octets = p[1] & 0x7F;
+    if(octets == 0 || octets > 2) {
+        return 0;
+    }
+    size_t len = 0;
+    for(size_t i = 0; i < octets; i++) {
+        len = (len << 8) | p[2 + i];
+    }
+    return 2 + octets + len;
+}
+
+static int _iot_tls_parse_crt(mbedtls_x509_crt *crt, const char *buf) {
+    if(!_iot_tls_is_der(buf)) {
+        return mbedtls_x509_crt_parse(crt, (const unsigned char *)buf, strlen(buf) + 1);
+    }
+    const unsigned char *p = (const unsigned char *)buf;
+    while(*p == 0x30) {
+        size_t len = _iot_tls_der_len(p);
+        if(len == 0) {
+            return MBEDTLS_ERR_X509_INVALID_FORMAT;
+        }
+        int ret = mbedtls_x509_crt_parse_der(crt, p, len);
+        if(ret != 0) {
+            return ret;
+        }
+        p += len;
+    }
+    return 0;
+}
+
 /*
  * This is a function to do further verification if needed on the cert received.
  *
@@ -143,8 +268,7 @@ IoT_Error_t iot_tls_connect(Network *pNetwork, TLSConnectParams *params) {
         ret = mbedtls_x509_crt_parse_file(&(tlsDataParams->cacert), pNetwork->tlsConnectParams.pRootCALocation);
     } else {
         ESP_LOGD(TAG, "Loading embedded CA root certificate ...");
-        ret = mbedtls_x509_crt_parse(&(tlsDataParams->cacert), (const unsigned char *)pNetwork->tlsConnectParams.pRootCALocation,
-                                 strlen(pNetwork->tlsConnectParams.pRootCALocation)+1);
+        ret = _iot_tls_parse_crt(&(tlsDataParams->cacert), pNetwork->tlsConnectParams.pRootCALocation);
     }
 
     if(ret < 0) {
@@ -160,9 +284,7 @@ IoT_Error_t iot_tls_connect(Network *pNetwork, TLSConnectParams *params) {
                                           pNetwork->tlsConnectParams.pDeviceCertLocation);
     } else {
         ESP_LOGD(TAG, "Loading embedded client certificate...");
-        ret = mbedtls_x509_crt_parse(&(tlsDataParams->clicert),
-                                     (const unsigned char *)pNetwork->tlsConnectParams.pDeviceCertLocation,
-                                     strlen(pNetwork->tlsConnectParams.pDeviceCertLocation)+1);
+        ret = _iot_tls_parse_crt(&(tlsDataParams->clicert), pNetwork->tlsConnectParams.pDeviceCertLocation);
     }
     if(ret != 0) {
         ESP_LOGE(TAG, "failed!  mbedtls_x509_crt_parse returned -0x%x while parsing device cert", -ret);
@@ -177,10 +299,9 @@ IoT_Error_t iot_tls_connect(Network *pNetwork, TLSConnectParams *params) {
                                        NULL);
     } else {
         ESP_LOGD(TAG, "Loading embedded client private key...");
-        ret = mbedtls_pk_parse_key(&(tlsDataParams->pkey),
-                                   (const unsigned char *)pNetwork->tlsConnectParams.pDevicePrivateKeyLocation,
-                                   strlen(pNetwork->tlsConnectParams.pDevicePrivateKeyLocation)+1,
-                                   NULL, 0);
+        const char *key = pNetwork->tlsConnectParams.pDevicePrivateKeyLocation;
+        size_t key_len = _iot_tls_is_der(key) ? _iot_tls_der_len((const unsigned char *)key) : strlen(key) + 1;
+        ret = mbedtls_pk_parse_key(&(tlsDataParams->pkey), (const unsigned char *)key, key_len, NULL, 0);
     }
     if(ret != 0) {
         ESP_LOGE(TAG, "failed!  mbedtls_pk_parse_key returned -0x%x while parsing private key", -ret);
@@ -227,6 +348,27 @@ IoT_Error_t iot_tls_connect(Network *pNetwork, TLSConnectParams *params) {
     }
     mbedtls_ssl_conf_rng(&(tlsDataParams->conf), mbedtls_ctr_drbg_random, &(tlsDataParams->ctr_drbg));
 
+#ifdef CONFIG_NAPHOME_AWS_IOT_ECDSA_HANDSHAKE
+    if(mbedtls_pk_get_type(&(tlsDataParams->pkey)) == MBEDTLS_PK_ECKEY &&
+       mbedtls_pk_get_bitlen(&(tlsDataParams->pkey)) == 256) {
+        mbedtls_ssl_conf_ciphersuites(&(tlsDataParams->conf), s_p256_ciphersuites);
+#if MBEDTLS_VERSION_NUMBER >= 0x03000000
+        mbedtls_ssl_conf_groups(&(tlsDataParams->conf), s_p256_groups);
+#else
+        mbedtls_ssl_conf_curves(&(tlsDataParams->conf), s_p256_curves);
+#endif
+        ESP_LOGD(TAG, "P-256 device key, offering ECDHE/AES-GCM suites only");
+    }
+#endif
+
+#if CONFIG_NAPHOME_AWS_IOT_TLS_MAX_FRAGMENT > 0 && defined(MBEDTLS_SSL_MAX_FRAGMENT_LENGTH)
+    mbedtls_ssl_conf_max_frag_len(&(tlsDataParams->conf), s_max_frag_len_code());
+#endif
+
+#if defined(CONFIG_NAPHOME_AWS_IOT_TLS_RESUMPTION) && defined(MBEDTLS_SSL_SESSION_TICKETS)
+    mbedtls_ssl_conf_session_tickets(&(tlsDataParams->conf), MBEDTLS_SSL_SESSION_TICKETS_ENABLED);
+#endif
+
     mbedtls_ssl_conf_ca_chain(&(tlsDataParams->conf), &(tlsDataParams->cacert), NULL);
     ret = mbedtls_ssl_conf_own_cert(&(tlsDataParams->conf), &(tlsDataParams->clicert), &(tlsDataParams->pkey));
     if(ret != 0) {
@@ -261,16 +403,36 @@ IoT_Error_t iot_tls_connect(Network *pNetwork, TLSConnectParams *params) {
                         mbedtls_net_recv_timeout);
     ESP_LOGD(TAG, "ok");
 
+    bool resuming = false;
+#ifdef CONFIG_NAPHOME_AWS_IOT_TLS_RESUMPTION
+    if (s_saved_session_valid &&
+        strcmp(s_saved_session_host, pNetwork->tlsConnectParams.pDestinationURL) == 0) {
+        /* The server falls back to a full handshake if it no longer knows the session */
+        if((ret = mbedtls_ssl_set_session(&(tlsDataParams->ssl), &s_saved_session)) == 0) {
+            resuming = true;
+        } else {
+            ESP_LOGW(TAG, "mbedtls_ssl_set_session returned -0x%x, doing a full handshake", -ret);
+        }
+    }
+#endif
+
     ESP_LOGD(TAG, "Performing the SSL/TLS handshake...");
+    int64_t handshake_start = esp_timer_get_time();
     while((ret = mbedtls_ssl_handshake(&(tlsDataParams->ssl))) != 0) {
         if(ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE) {
             ESP_LOGE(TAG, "failed! mbedtls_ssl_handshake returned -0x%x", -ret);
             if(ret == MBEDTLS_ERR_X509_CERT_VERIFY_FAILED) {
                 ESP_LOGE(TAG, "    Unable to verify the server's certificate. ");
             }
+#ifdef CONFIG_NAPHOME_AWS_IOT_TLS_RESUMPTION
+            /* Never offer a session that may be what the server rejected */
+            _iot_tls_forget_session();
+#endif
             return SSL_CONNECTION_ERROR;
         }
     }
+    ESP_LOGI(TAG, "TLS handshake took %lld ms%s", (long long)((esp_timer_get_time() - handshake_start) / 1000),
+             resuming ? " (session offered for resumption)" : "");
 
     ESP_LOGD(TAG, "ok    [ Protocol is %s ]    [ Ciphersuite is %s ]", mbedtls_ssl_get_version(&(tlsDataParams->ssl)),
           mbedtls_ssl_get_ciphersuite(&(tlsDataParams->ssl)));
@@ -297,6 +459,14 @@ IoT_Error_t iot_tls_connect(Network *pNetwork, TLSConnectParams *params) {
         ret = SUCCESS;
     }
 
+#ifdef CONFIG_NAPHOME_AWS_IOT_TLS_RESUMPTION
+    if(ret == SUCCESS) {
+        _iot_tls_save_session(&(tlsDataParams->ssl), pNetwork->tlsConnectParams.pDestinationURL);
+    } else {
+        _iot_tls_forget_session();
+    }
+#endif
+
     if(LOG_LOCAL_LEVEL >= ESP_LOG_DEBUG) {
         if (mbedtls_ssl_get_peer_cert(&(tlsDataParams->ssl)) != NULL) {
             ESP_LOGD(TAG, "Peer certificate information:");
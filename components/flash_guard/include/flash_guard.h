@@ -0,0 +1,51 @@
+/**
+ * @file flash_guard.h
+ * @brief Pace flash erases and writes around live audio.
+ *
+ * Every erase or program turns the flash cache off while it runs: only IRAM
+ * code and interrupts run, and tasks on both cores stop. The I2S interrupts
+ * are built for that (CONFIG_I2S_ISR_IRAM_SAFE), but the player's mixer
+ * task is not, so its DMA queue has to outlast each stall.
+ *
+ * Writers go one sector at a time through flash_guard_erase_range() and
+ * flash_guard_write(), or call flash_guard_wait() before each step of their
+ * own. While the player is active, the first step of a write waits up to
+ * CONFIG_FLASH_GUARD_MAX_DEFER_MS for it to go idle, and the steps of a
+ * write still running with audio are spaced CONFIG_FLASH_GUARD_GAP_MS apart.
+ * With no audio the steps run back to back.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "esp_err.h"
+#include "esp_partition.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Largest erase or write done as one step: one flash sector
+#define FLASH_GUARD_STEP_BYTES 4096
+
+// Set by the audio player as it starts and stops feeding the DAC
+void flash_guard_set_audio_active(bool active);
+bool flash_guard_audio_active(void);
+
+/**
+ * @brief Block until the next flash step may start. Call from a task, before
+ *        each erase or write of at most FLASH_GUARD_STEP_BYTES.
+ */
+void flash_guard_wait(void);
+
+// esp_partition_erase_range() one sector per step; offset and size as it takes them
+esp_err_t flash_guard_erase_range(const esp_partition_t *part, size_t offset, size_t size);
+
+// esp_partition_write() in steps of at most FLASH_GUARD_STEP_BYTES
+esp_err_t flash_guard_write(const esp_partition_t *part, size_t offset, const void *data, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
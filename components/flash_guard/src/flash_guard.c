@@ -0,0 +1,79 @@
+#include "flash_guard.h"
+
+#include <stdint.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "sdkconfig.h"
+
+#define FLASH_GUARD_POLL_MS 10
+// Steps closer together than this belong to one write, which waits for the player only once
+#define FLASH_GUARD_SAME_WRITE_MS 500
+_Static_assert(CONFIG_FLASH_GUARD_GAP_MS < FLASH_GUARD_SAME_WRITE_MS, "gap splits one write into many");
+
+static bool s_audio_active;           // atomic
+// Writers on different tasks may race on it; that only shortens one gap
+static TickType_t s_last_step;
+static bool s_stepped;
+
+void flash_guard_set_audio_active(bool active)
+{
+    __atomic_store_n(&s_audio_active, active, __ATOMIC_RELAXED);
+}
+
+bool flash_guard_audio_active(void)
+{
+    return __atomic_load_n(&s_audio_active, __ATOMIC_RELAXED);
+}
+
+void flash_guard_wait(void)
+{
+    TickType_t now = xTaskGetTickCount();
+    if (!s_stepped || now - s_last_step >= pdMS_TO_TICKS(FLASH_GUARD_SAME_WRITE_MS)) {
+        TickType_t start = now;
+        while (flash_guard_audio_active() && now - start < pdMS_TO_TICKS(CONFIG_FLASH_GUARD_MAX_DEFER_MS)) {
+            vTaskDelay(pdMS_TO_TICKS(FLASH_GUARD_POLL_MS));
+            now = xTaskGetTickCount();
+        }
+    } else if (flash_guard_audio_active()) {
+        TickType_t gap = pdMS_TO_TICKS(CONFIG_FLASH_GUARD_GAP_MS);
+        if (now - s_last_step < gap) {
+            vTaskDelay(gap - (now - s_last_step));
+            now = xTaskGetTickCount();
+        }
+    }
+    s_last_step = now;
+    s_stepped = true;
+}
+
+esp_err_t flash_guard_erase_range(const esp_partition_t *part, size_t offset, size_t size)
+{
+    while (size > 0) {
+        size_t n = size < FLASH_GUARD_STEP_BYTES ? size : FLASH_GUARD_STEP_BYTES;
+        flash_guard_wait();
+        esp_err_t err = esp_partition_erase_range(part, offset, n);
+        if (err != ESP_OK) {
+            return err;
+        }
+        offset += n;
+        size -= n;
+    }
+    return ESP_OK;
+}
+
+esp_err_t flash_guard_write(const esp_partition_t *part, size_t offset, const void *data, size_t size)
+{
+    const uint8_t *src = data;
+    while (size > 0) {
+        size_t n = size < FLASH_GUARD_STEP_BYTES ? size : FLASH_GUARD_STEP_BYTES;
+        flash_guard_wait();
+        esp_err_t err = esp_partition_write(part, offset, src, n);
+        if (err != ESP_OK) {
+            return err;
+        }
+        offset += n;
+        src += n;
+        size -= n;
+    }
+    return ESP_OK;
+}
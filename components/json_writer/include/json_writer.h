@@ -0,0 +1,119 @@
+/**
+ * @file json_writer.h
+ * @brief Streaming JSON output without a document tree.
+ *
+ * Values are written in order, straight into a caller's buffer: either one
+ * buffer that holds the whole document, or a chunk buffer that is handed
+ * to a flush callback whenever it fills (an HTTP chunk, a socket). Nothing
+ * is allocated. Keys and strings are escaped as they are copied, and the
+ * writer places the commas itself.
+ *
+ *     json_writer_t w;
+ *     json_writer_init(&w, buf, sizeof(buf));
+ *     json_writer_begin_object(&w, NULL);
+ *     json_writer_string(&w, "deviceId", id);
+ *     json_writer_int(&w, "timestamp_ms", now_ms);
+ *     json_writer_end_object(&w);
+ *     ESP_RETURN_ON_ERROR(json_writer_finish(&w, &len), TAG, "payload");
+ *
+ * Every emitter takes a key, which must be NULL for array elements and the
+ * top-level value. Errors are sticky: after the first one the writer only
+ * keeps counting, and json_writer_finish() reports it.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Takes a full chunk buffer, or the rest of it from json_writer_finish()
+typedef esp_err_t (*json_writer_flush_t)(void *ctx, const char *data, size_t len);
+
+typedef struct {
+    char *buf;
+    size_t size;
+    size_t len;                       // Fixed: bytes of output so far, even past size. Chunked: bytes in buf
+    json_writer_flush_t flush;        // NULL for a fixed buffer
+    void *flush_ctx;
+    bool need_comma;
+    esp_err_t err;
+} json_writer_t;
+
+/**
+ * @brief Write into buf, which gets a terminator from json_writer_finish().
+ *
+ * Output past size is counted but not stored, and fails the writer with
+ * ESP_ERR_INVALID_SIZE, so buf = NULL and size = 0 measure a document the
+ * way snprintf() does.
+ */
+void json_writer_init(json_writer_t *w, char *buf, size_t size);
+
+// Write through buf, passing it to flush each time it fills
+void json_writer_init_chunked(json_writer_t *w, char *buf, size_t size, json_writer_flush_t flush, void *ctx);
+
+void json_writer_begin_object(json_writer_t *w, const char *key);
+void json_writer_end_object(json_writer_t *w);
+void json_writer_begin_array(json_writer_t *w, const char *key);
+void json_writer_end_array(json_writer_t *w);
+
+// NULL is written as ""
+void json_writer_string(json_writer_t *w, const char *key, const char *value);
+// len bytes of value, which need not be terminated
+void json_writer_string_len(json_writer_t *w, const char *key, const char *value, size_t len);
+void json_writer_int(json_writer_t *w, const char *key, int64_t value);
+void json_writer_bool(json_writer_t *w, const char *key, bool value);
+void json_writer_null(json_writer_t *w, const char *key);
+
+/**
+ * @brief A double in as few digits as read back to the same value, as
+ *        cJSON prints numbers; integral values have no decimal point.
+ *        NaN and infinities are written as null.
+ */
+void json_writer_double(json_writer_t *w, const char *key, double value);
+
+// A float reading to 7 significant digits, so 21.3f stays "21.3"; not finite is null
+void json_writer_float(json_writer_t *w, const char *key, float value);
+
+// Already-serialised JSON, copied as is, e.g. a cached document
+void json_writer_raw(json_writer_t *w, const char *key, const char *json);
+
+/**
+ * @brief Flush what is buffered (chunked) or terminate the output (fixed).
+ *
+ * @param[out] out_len Optional: the document's length without the
+ *                     terminator; for a fixed buffer also when it did not fit
+ * @return The first error: ESP_ERR_INVALID_SIZE if a fixed buffer was too
+ *         small, or what a flush returned
+ */
+esp_err_t json_writer_finish(json_writer_t *w, size_t *out_len);
+
+typedef void (*json_writer_build_t)(json_writer_t *w, const void *arg);
+
+/**
+ * @brief Build a document into a buffer of exactly its size.
+ *
+ * build runs twice, once to measure and once to write, and must write the
+ * same both times. The result is terminated and comes from alloc; release
+ * frees it if the passes differed.
+ *
+ * @return NULL if alloc failed or the two passes differed
+ */
+char *json_writer_build_alloc(json_writer_build_t build, const void *arg, void *(*alloc)(size_t size),
+                              void (*release)(void *ptr), size_t *out_len);
+
+// Bytes s takes as JSON string content, without the quotes
+size_t json_writer_escaped_len(const char *s);
+
+// Write s escaped as JSON string content, without the quotes; returns the end of what was written
+char *json_writer_escape_copy(char *dst, const char *s);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,282 @@
+#include "json_writer.h"
+
+#include <inttypes.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char s_hex[] = "0123456789abcdef";
+
+// Escape for a byte that cannot appear raw in a string, or NULL; out has room for 7
+static const char *json_writer_escape(unsigned char c, char *out)
+{
+    switch (c) {
+    case '"':
+        return "\\\"";
+    case '\\':
+        return "\\\\";
+    case '\n':
+        return "\\n";
+    case '\r':
+        return "\\r";
+    case '\t':
+        return "\\t";
+    default:
+        break;
+    }
+    if (c >= 0x20) {
+        return NULL;
+    }
+    memcpy(out, "\\u00", 4);
+    out[4] = s_hex[c >> 4];
+    out[5] = s_hex[c & 0xF];
+    out[6] = '\0';
+    return out;
+}
+
+static void json_writer_put(json_writer_t *w, const char *data, size_t len)
+{
+    if (!w->flush) {
+        // One byte is kept for the terminator
+        if (w->len + len < w->size) {
+            memcpy(w->buf + w->len, data, len);
+        } else {
+            w->err = w->err == ESP_OK ? ESP_ERR_INVALID_SIZE : w->err;
+        }
+        w->len += len;
+        return;
+    }
+    while (len > 0 && w->err == ESP_OK) {
+        size_t n = w->size - w->len;
+        if (n > len) {
+            n = len;
+        }
+        memcpy(w->buf + w->len, data, n);
+        w->len += n;
+        data += n;
+        len -= n;
+        if (w->len == w->size) {
+            w->err = w->flush(w->flush_ctx, w->buf, w->len);
+            w->len = 0;
+        }
+    }
+}
+
+static void json_writer_puts(json_writer_t *w, const char *s)
+{
+    json_writer_put(w, s, strlen(s));
+}
+
+static void json_writer_quoted(json_writer_t *w, const char *s, size_t len)
+{
+    json_writer_put(w, "\"", 1);
+    const char *run = s;
+    const char *end = s + len;
+    char buf[7];
+    for (const char *p = s; p < end; p++) {
+        const char *esc = json_writer_escape((unsigned char)*p, buf);
+        if (esc) {
+            json_writer_put(w, run, (size_t)(p - run));
+            json_writer_puts(w, esc);
+            run = p + 1;
+        }
+    }
+    json_writer_put(w, run, (size_t)(end - run));
+    json_writer_put(w, "\"", 1);
+}
+
+// Separator and key before a value
+static void json_writer_key(json_writer_t *w, const char *key)
+{
+    if (w->need_comma) {
+        json_writer_put(w, ",", 1);
+    }
+    w->need_comma = true;
+    if (key) {
+        json_writer_quoted(w, key, strlen(key));
+        json_writer_put(w, ":", 1);
+    }
+}
+
+void json_writer_init(json_writer_t *w, char *buf, size_t size)
+{
+    *w = (json_writer_t){
+        .buf = buf,
+        .size = buf ? size : 0,
+    };
+}
+
+void json_writer_init_chunked(json_writer_t *w, char *buf, size_t size, json_writer_flush_t flush, void *ctx)
+{
+    *w = (json_writer_t){
+        .buf = buf,
+        .size = size,
+        .flush = flush,
+        .flush_ctx = ctx,
+        .err = buf && size && flush ? ESP_OK : ESP_ERR_INVALID_ARG,
+    };
+}
+
+static void json_writer_open(json_writer_t *w, const char *key, char bracket)
+{
+    json_writer_key(w, key);
+    json_writer_put(w, &bracket, 1);
+    w->need_comma = false;
+}
+
+static void json_writer_close(json_writer_t *w, char bracket)
+{
+    json_writer_put(w, &bracket, 1);
+    w->need_comma = true;
+}
+
+void json_writer_begin_object(json_writer_t *w, const char *key)
+{
+    json_writer_open(w, key, '{');
+}
+
+void json_writer_end_object(json_writer_t *w)
+{
+    json_writer_close(w, '}');
+}
+
+void json_writer_begin_array(json_writer_t *w, const char *key)
+{
+    json_writer_open(w, key, '[');
+}
+
+void json_writer_end_array(json_writer_t *w)
+{
+    json_writer_close(w, ']');
+}
+
+void json_writer_string(json_writer_t *w, const char *key, const char *value)
+{
+    json_writer_string_len(w, key, value ? value : "", value ? strlen(value) : 0);
+}
+
+void json_writer_string_len(json_writer_t *w, const char *key, const char *value, size_t len)
+{
+    json_writer_key(w, key);
+    json_writer_quoted(w, value, len);
+}
+
+void json_writer_int(json_writer_t *w, const char *key, int64_t value)
+{
+    char num[24];
+    json_writer_key(w, key);
+    int n = snprintf(num, sizeof(num), "%" PRId64, value);
+    json_writer_put(w, num, (size_t)n);
+}
+
+void json_writer_bool(json_writer_t *w, const char *key, bool value)
+{
+    json_writer_key(w, key);
+    json_writer_puts(w, value ? "true" : "false");
+}
+
+void json_writer_null(json_writer_t *w, const char *key)
+{
+    json_writer_key(w, key);
+    json_writer_put(w, "null", 4);
+}
+
+void json_writer_double(json_writer_t *w, const char *key, double value)
+{
+    if (!isfinite(value)) {
+        json_writer_null(w, key);
+        return;
+    }
+    char num[32];
+    json_writer_key(w, key);
+    int n = snprintf(num, sizeof(num), "%.15g", value);
+    if (strtod(num, NULL) != value) {
+        n = snprintf(num, sizeof(num), "%.17g", value);
+    }
+    json_writer_put(w, num, (size_t)n);
+}
+
+void json_writer_float(json_writer_t *w, const char *key, float value)
+{
+    if (!isfinite(value)) {
+        json_writer_null(w, key);
+        return;
+    }
+    char num[24];
+    json_writer_key(w, key);
+    int n = snprintf(num, sizeof(num), "%.7g", (double)value);
+    json_writer_put(w, num, (size_t)n);
+}
+
+void json_writer_raw(json_writer_t *w, const char *key, const char *json)
+{
+    json_writer_key(w, key);
+    json_writer_puts(w, json);
+}
+
+esp_err_t json_writer_finish(json_writer_t *w, size_t *out_len)
+{
+    if (w->flush) {
+        if (w->len > 0 && w->err == ESP_OK) {
+            w->err = w->flush(w->flush_ctx, w->buf, w->len);
+        }
+        w->len = 0;
+    } else if (w->size > 0) {
+        w->buf[w->len < w->size ? w->len : w->size - 1] = '\0';
+    }
+    if (out_len) {
+        *out_len = w->len;
+    }
+    return w->err;
+}
+
+char *json_writer_build_alloc(json_writer_build_t build, const void *arg, void *(*alloc)(size_t size),
+                              void (*release)(void *ptr), size_t *out_len)
+{
+    json_writer_t w;
+    json_writer_init(&w, NULL, 0);
+    build(&w, arg);
+    size_t len = w.len;
+    char *buf = alloc(len + 1);
+    if (!buf) {
+        return NULL;
+    }
+    json_writer_init(&w, buf, len + 1);
+    build(&w, arg);
+    if (json_writer_finish(&w, NULL) != ESP_OK || w.len != len) {
+        release(buf);
+        return NULL;
+    }
+    if (out_len) {
+        *out_len = len;
+    }
+    return buf;
+}
+
+size_t json_writer_escaped_len(const char *s)
+{
+    size_t n = 0;
+    char buf[7];
+    for (const unsigned char *p = (const unsigned char *)s; *p; ++p) {
+        const char *esc = json_writer_escape(*p, buf);
+        n += esc ? strlen(esc) : 1;
+    }
+    return n;
+}
+
+char *json_writer_escape_copy(char *dst, const char *s)
+{
+    char buf[7];
+    for (const unsigned char *p = (const unsigned char *)s; *p; ++p) {
+        const char *esc = json_writer_escape(*p, buf);
+        if (esc) {
+            size_t n = strlen(esc);
+            memcpy(dst, esc, n);
+            dst += n;
+        } else {
+            *dst++ = (char)*p;
+        }
+    }
+    return dst;
+}
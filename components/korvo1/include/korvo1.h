@@ -4,35 +4,91 @@
 #include <stddef.h>
 #include <stdint.h>
 #include "esp_err.h"
-#include "driver/i2s.h"
+#include "driver/i2s_pdm.h"
+#include "driver/i2s_tdm.h"
+#include "freertos/FreeRTOS.h"
 #include "hal/gpio_types.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+typedef enum {
+    KORVO1_CAPTURE_PDM,               // Two PDM microphones on the port's PDM RX
+    KORVO1_CAPTURE_TDM,               // A multi-channel ADC (ES7210 class) on an I2S TDM bus
+} korvo1_capture_mode_t;
+
+// Most 16-bit slots a TDM frame may carry
+#define KORVO1_TDM_MAX_SLOTS 8
+
+typedef enum {
+    KORVO1_CHANNEL_ONLY_LEFT,
+    KORVO1_CHANNEL_ONLY_RIGHT,
+    KORVO1_CHANNEL_STEREO,            // Interleaved right/left, two samples per frame
+} korvo1_channel_fmt_t;
+
+/**
+ * Called from the I2S interrupt with each DMA buffer as it fills. The data
+ * is only valid until the callback returns; the DMA engine reuses the
+ * buffer one ring period later. Must not block.
+ *
+ * @return true if the callback woke a higher-priority task
+ */
+typedef bool (*korvo1_rx_callback_t)(const void *data, size_t bytes, void *ctx);
+
+/**
+ * In TDM mode the ADC is the bus slave: this side drives MCLK, BCLK and the
+ * frame sync, and each DMA frame holds tdm_slots 16-bit samples in slot
+ * order. Which slot is which microphone, or the codec's loopback of the
+ * speaker, is the caller's to know. The ADC itself must already be set up
+ * for TDM output (it is configured over I2C with the rest of the codec).
+ */
 typedef struct {
     i2s_port_t port;
     gpio_num_t din_io_num;
-    gpio_num_t bclk_io_num;
-    gpio_num_t ws_io_num;
-    gpio_num_t mclk_io_num;
+    gpio_num_t bclk_io_num;           // TDM bit clock; unused by the PDM microphones
+    gpio_num_t ws_io_num;             // PDM clock, or the TDM frame sync
+    gpio_num_t mclk_io_num;           // TDM master clock; unused by the PDM microphones
     int sample_rate_hz;
-    int dma_buffer_count;
-    int dma_buffer_len;
-    i2s_channel_fmt_t channel_format;
+    int dma_buffer_count;             // DMA descriptors in the ring
+    int dma_buffer_len;               // Frames per DMA buffer
+    korvo1_channel_fmt_t channel_format;  // PDM only
+    korvo1_capture_mode_t mode;
+    int tdm_slots;                    // TDM only: slots per frame, 2 to KORVO1_TDM_MAX_SLOTS
 } korvo1_config_t;
 
 typedef struct {
     korvo1_config_t config;
+    i2s_chan_handle_t rx;
+    korvo1_rx_callback_t rx_cb;
+    void *rx_ctx;
+    int64_t last_rx_us;               // Previous DMA interrupt, for gap detection
+    int64_t buffer_us;                // Audio per DMA buffer
+    uint32_t overruns;                // DMA buffers lost before anyone took them (atomic)
     bool initialized;
     bool streaming;
 } korvo1_t;
 
 esp_err_t korvo1_init(korvo1_t *dev, const korvo1_config_t *config);
+
+/**
+ * Deliver every DMA buffer to cb from the I2S interrupt instead of queueing
+ * it for korvo1_read(). Call between korvo1_init() and korvo1_start().
+ */
+esp_err_t korvo1_set_rx_callback(korvo1_t *dev, korvo1_rx_callback_t cb, void *ctx);
+
 esp_err_t korvo1_start(korvo1_t *dev);
 esp_err_t korvo1_stop(korvo1_t *dev);
+
+// Polling path; ESP_ERR_INVALID_STATE once an RX callback owns the buffers
 esp_err_t korvo1_read(korvo1_t *dev, void *buffer, size_t bytes_to_read, size_t *bytes_read, TickType_t ticks_to_wait);
+
+/**
+ * DMA buffers overwritten before they were consumed: a late interrupt with
+ * a callback, or a reader that fell behind the driver queue without one.
+ */
+uint32_t korvo1_overruns(const korvo1_t *dev);
+
 esp_err_t korvo1_deinit(korvo1_t *dev);
 
 #ifdef __cplusplus
@@ -3,72 +3,181 @@
 #include <string.h>
 #include "esp_check.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 
 static const char *TAG = "korvo1";
 
-__attribute__((weak)) esp_err_t korvo1_i2s_read(i2s_port_t port, void *dest, size_t size, size_t *bytes_read, TickType_t ticks_to_wait)
+// Deeper than the legacy 4 x 256 so an interrupt held off by a flash write
+// (~100 ms at 16 kHz) still finds its buffer intact
+#define KORVO1_DEFAULT_DMA_BUFFERS 8
+#define KORVO1_DEFAULT_DMA_FRAMES 256
+
+__attribute__((weak)) esp_err_t korvo1_i2s_read(i2s_chan_handle_t rx, void *dest, size_t size, size_t *bytes_read, TickType_t ticks_to_wait)
 {
-    return i2s_read(port, dest, size, bytes_read, ticks_to_wait);
+    uint32_t timeout_ms = ticks_to_wait == portMAX_DELAY ? portMAX_DELAY : pdTICKS_TO_MS(ticks_to_wait);
+    return i2s_channel_read(rx, dest, size, bytes_read, timeout_ms);
 }
 
-esp_err_t korvo1_init(korvo1_t *dev, const korvo1_config_t *config)
+// Interrupts more than a buffer and a half apart mean the DMA moved past
+// buffers nobody was told about; count each one lost
+static bool IRAM_ATTR on_recv(i2s_chan_handle_t handle, i2s_event_data_t *event, void *user_ctx)
 {
-    ESP_RETURN_ON_FALSE(dev && config, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
-    memcpy(&dev->config, config, sizeof(korvo1_config_t));
+    (void)handle;
+    korvo1_t *dev = (korvo1_t *)user_ctx;
+    int64_t now_us = esp_timer_get_time();
+    if (dev->last_rx_us != 0) {
+        int64_t gap_us = now_us - dev->last_rx_us;
+        if (gap_us > dev->buffer_us * 3 / 2) {
+            __atomic_fetch_add(&dev->overruns, (uint32_t)(gap_us / dev->buffer_us) - 1, __ATOMIC_RELAXED);
+        }
+    }
+    dev->last_rx_us = now_us;
+    return dev->rx_cb(event->dma_buf, event->size, dev->rx_ctx);
+}
 
-    i2s_channel_fmt_t ch_fmt;
-    if (config->channel_format == I2S_CHANNEL_FMT_ONLY_LEFT) {
-        ch_fmt = I2S_CHANNEL_FMT_ONLY_LEFT;
-    } else if (config->channel_format == I2S_CHANNEL_FMT_ONLY_RIGHT) {
-        ch_fmt = I2S_CHANNEL_FMT_ONLY_RIGHT;
-    } else {
-        ch_fmt = I2S_CHANNEL_FMT_RIGHT_LEFT; // STEREO
+// Without a callback the driver queues buffers for korvo1_read() and drops
+// the oldest when the reader falls behind
+static bool IRAM_ATTR on_recv_q_ovf(i2s_chan_handle_t handle, i2s_event_data_t *event, void *user_ctx)
+{
+    (void)handle;
+    (void)event;
+    korvo1_t *dev = (korvo1_t *)user_ctx;
+    __atomic_fetch_add(&dev->overruns, 1, __ATOMIC_RELAXED);
+    return false;
+}
+
+static esp_err_t init_pdm_rx(korvo1_t *dev, int sample_rate, const i2s_chan_config_t *chan_cfg)
+{
+    const korvo1_config_t *config = &dev->config;
+    i2s_slot_mode_t slot_mode = I2S_SLOT_MODE_STEREO;
+    i2s_pdm_slot_mask_t slot_mask = I2S_PDM_SLOT_BOTH;
+    const char *ch_fmt_str = "STEREO";
+    if (config->channel_format == KORVO1_CHANNEL_ONLY_LEFT) {
+        slot_mode = I2S_SLOT_MODE_MONO;
+        slot_mask = I2S_PDM_SLOT_LEFT;
+        ch_fmt_str = "ONLY_LEFT";
+    } else if (config->channel_format == KORVO1_CHANNEL_ONLY_RIGHT) {
+        slot_mode = I2S_SLOT_MODE_MONO;
+        slot_mask = I2S_PDM_SLOT_RIGHT;
+        ch_fmt_str = "ONLY_RIGHT";
     }
-    
-    i2s_config_t i2s_conf = {
-        .mode = I2S_MODE_MASTER | I2S_MODE_RX | I2S_MODE_PDM,
-        .sample_rate = config->sample_rate_hz > 0 ? config->sample_rate_hz : 16000,
-        .bits_per_sample = I2S_BITS_PER_SAMPLE_16BIT,
-        .channel_format = ch_fmt,
-        .communication_format = I2S_COMM_FORMAT_STAND_I2S,
-        .intr_alloc_flags = ESP_INTR_FLAG_LEVEL1,
-        .dma_buf_count = config->dma_buffer_count > 0 ? config->dma_buffer_count : 4,
-        .dma_buf_len = config->dma_buffer_len > 0 ? config->dma_buffer_len : 256,
-        .use_apll = false,
-        .tx_desc_auto_clear = false,
-        .fixed_mclk = 0
+
+    i2s_pdm_rx_config_t pdm_cfg = {
+        .clk_cfg = I2S_PDM_RX_CLK_DEFAULT_CONFIG(sample_rate),
+        .slot_cfg = I2S_PDM_RX_SLOT_DEFAULT_CONFIG(I2S_DATA_BIT_WIDTH_16BIT, slot_mode),
+        .gpio_cfg = {
+            .clk = config->ws_io_num,
+            .din = config->din_io_num,
+            .invert_flags = {
+                .clk_inv = false,
+            },
+        },
     };
-    const char* ch_fmt_str = (ch_fmt == I2S_CHANNEL_FMT_ONLY_LEFT) ? "ONLY_LEFT" :
-                             (ch_fmt == I2S_CHANNEL_FMT_ONLY_RIGHT) ? "ONLY_RIGHT" : "STEREO";
+    pdm_cfg.slot_cfg.slot_mask = slot_mask;
+
     ESP_LOGI(TAG, "I2S Configuration: mode=PDM_RX, sample_rate=%d, channel_format=%s, dma_bufs=%d x %d",
-             (int)i2s_conf.sample_rate, ch_fmt_str, (int)i2s_conf.dma_buf_count, (int)i2s_conf.dma_buf_len);
-    ESP_RETURN_ON_ERROR(i2s_driver_install(config->port, &i2s_conf, 0, NULL), TAG, "driver install failed");
-
-    i2s_pin_config_t pin_conf = {
-        .mck_io_num = config->mclk_io_num,
-        .bck_io_num = config->bclk_io_num,
-        .ws_io_num = config->ws_io_num,
-        .data_out_num = I2S_PIN_NO_CHANGE,
-        .data_in_num = config->din_io_num
+             sample_rate, ch_fmt_str, (int)chan_cfg->dma_desc_num, (int)chan_cfg->dma_frame_num);
+    esp_err_t err = i2s_channel_init_pdm_rx_mode(dev->rx, &pdm_cfg);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "PDM RX init failed: %s", esp_err_to_name(err));
+        return err;
+    }
+    ESP_LOGI(TAG, "I2S Pin Configuration: DIN=GPIO%d, CLK=GPIO%d (BCLK=GPIO%d, MCLK=GPIO%d unused in PDM)",
+             config->din_io_num, config->ws_io_num, config->bclk_io_num, config->mclk_io_num);
+    return ESP_OK;
+}
+
+// Philips TDM with 16-bit slots, as the ES7210 sends it; slots 0..tdm_slots-1 are active
+static esp_err_t init_tdm_rx(korvo1_t *dev, int sample_rate, const i2s_chan_config_t *chan_cfg)
+{
+    const korvo1_config_t *config = &dev->config;
+    i2s_tdm_slot_mask_t slot_mask = (i2s_tdm_slot_mask_t)((1U << config->tdm_slots) - 1);
+    i2s_tdm_config_t tdm_cfg = {
+        .clk_cfg = I2S_TDM_CLK_DEFAULT_CONFIG(sample_rate),
+        .slot_cfg = I2S_TDM_PHILIPS_SLOT_DEFAULT_CONFIG(I2S_DATA_BIT_WIDTH_16BIT, I2S_SLOT_MODE_STEREO, slot_mask),
+        .gpio_cfg = {
+            .mclk = config->mclk_io_num,
+            .bclk = config->bclk_io_num,
+            .ws = config->ws_io_num,
+            .dout = I2S_GPIO_UNUSED,
+            .din = config->din_io_num,
+        },
     };
+
+    ESP_LOGI(TAG, "I2S Configuration: mode=TDM_RX, sample_rate=%d, slots=%d, dma_bufs=%d x %d",
+             sample_rate, config->tdm_slots, (int)chan_cfg->dma_desc_num, (int)chan_cfg->dma_frame_num);
+    esp_err_t err = i2s_channel_init_tdm_mode(dev->rx, &tdm_cfg);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "TDM RX init failed: %s", esp_err_to_name(err));
+        return err;
+    }
     ESP_LOGI(TAG, "I2S Pin Configuration: DIN=GPIO%d, BCLK=GPIO%d, WS=GPIO%d, MCLK=GPIO%d",
-             pin_conf.data_in_num, pin_conf.bck_io_num, pin_conf.ws_io_num, pin_conf.mck_io_num);
-    ESP_RETURN_ON_ERROR(i2s_set_pin(config->port, &pin_conf), TAG, "set pin failed");
-    ESP_RETURN_ON_ERROR(i2s_zero_dma_buffer(config->port), TAG, "zero dma buffer failed");
-    ESP_LOGI(TAG, "I2S driver installed and pins configured successfully");
+             config->din_io_num, config->bclk_io_num, config->ws_io_num, config->mclk_io_num);
+    return ESP_OK;
+}
+
+esp_err_t korvo1_init(korvo1_t *dev, const korvo1_config_t *config)
+{
+    ESP_RETURN_ON_FALSE(dev && config, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(config->mode != KORVO1_CAPTURE_TDM ||
+                            (config->tdm_slots >= 2 && config->tdm_slots <= KORVO1_TDM_MAX_SLOTS),
+                        ESP_ERR_INVALID_ARG, TAG, "TDM needs 2 to %d slots", KORVO1_TDM_MAX_SLOTS);
+    memset(dev, 0, sizeof(*dev));
+    memcpy(&dev->config, config, sizeof(korvo1_config_t));
+
+    int sample_rate = config->sample_rate_hz > 0 ? config->sample_rate_hz : 16000;
+    i2s_chan_config_t chan_cfg = I2S_CHANNEL_DEFAULT_CONFIG(config->port, I2S_ROLE_MASTER);
+    chan_cfg.dma_desc_num = config->dma_buffer_count > 0 ? config->dma_buffer_count : KORVO1_DEFAULT_DMA_BUFFERS;
+    chan_cfg.dma_frame_num = config->dma_buffer_len > 0 ? config->dma_buffer_len : KORVO1_DEFAULT_DMA_FRAMES;
+    dev->buffer_us = (int64_t)chan_cfg.dma_frame_num * 1000000 / sample_rate;
+
+    ESP_RETURN_ON_ERROR(i2s_new_channel(&chan_cfg, NULL, &dev->rx), TAG, "channel alloc failed");
+    esp_err_t err = config->mode == KORVO1_CAPTURE_TDM ? init_tdm_rx(dev, sample_rate, &chan_cfg)
+                                                       : init_pdm_rx(dev, sample_rate, &chan_cfg);
+    if (err != ESP_OK) {
+        i2s_del_channel(dev->rx);
+        dev->rx = NULL;
+        return err;
+    }
+
+    i2s_event_callbacks_t cbs = {
+        .on_recv_q_ovf = on_recv_q_ovf,
+    };
+    err = i2s_channel_register_event_callback(dev->rx, &cbs, dev);
+    if (err != ESP_OK) {
+        i2s_del_channel(dev->rx);
+        dev->rx = NULL;
+        return err;
+    }
+    ESP_LOGI(TAG, "I2S %s RX channel ready", config->mode == KORVO1_CAPTURE_TDM ? "TDM" : "PDM");
 
     dev->initialized = true;
     dev->streaming = false;
     return ESP_OK;
 }
 
+esp_err_t korvo1_set_rx_callback(korvo1_t *dev, korvo1_rx_callback_t cb, void *ctx)
+{
+    ESP_RETURN_ON_FALSE(dev && cb, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(dev->initialized && !dev->streaming, ESP_ERR_INVALID_STATE, TAG, "set before start");
+    dev->rx_cb = cb;
+    dev->rx_ctx = ctx;
+    // Replaces the queue-overflow hook: nobody drains the driver queue now, so
+    // it overflows on every buffer and gaps are detected in on_recv instead
+    i2s_event_callbacks_t cbs = {
+        .on_recv = on_recv,
+    };
+    return i2s_channel_register_event_callback(dev->rx, &cbs, dev);
+}
+
 esp_err_t korvo1_start(korvo1_t *dev)
 {
     ESP_RETURN_ON_FALSE(dev, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
     ESP_RETURN_ON_FALSE(dev->initialized, ESP_ERR_INVALID_STATE, TAG, "not initialized");
-    ESP_RETURN_ON_ERROR(i2s_start(dev->config.port), TAG, "start stream failed");
+    dev->last_rx_us = 0;
+    ESP_RETURN_ON_ERROR(i2s_channel_enable(dev->rx), TAG, "start stream failed");
     dev->streaming = true;
     return ESP_OK;
 }
@@ -76,10 +185,10 @@ esp_err_t korvo1_start(korvo1_t *dev)
 esp_err_t korvo1_stop(korvo1_t *dev)
 {
     ESP_RETURN_ON_FALSE(dev, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
-    if (!dev->initialized) {
+    if (!dev->initialized || !dev->streaming) {
         return ESP_OK;
     }
-    ESP_RETURN_ON_ERROR(i2s_stop(dev->config.port), TAG, "stop stream failed");
+    ESP_RETURN_ON_ERROR(i2s_channel_disable(dev->rx), TAG, "stop stream failed");
     dev->streaming = false;
     return ESP_OK;
 }
@@ -89,8 +198,14 @@ esp_err_t korvo1_read(korvo1_t *dev, void *buffer, size_t bytes_to_read, size_t
     ESP_RETURN_ON_FALSE(dev && buffer, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
     ESP_RETURN_ON_FALSE(dev->initialized, ESP_ERR_INVALID_STATE, TAG, "not initialized");
     ESP_RETURN_ON_FALSE(dev->streaming, ESP_ERR_INVALID_STATE, TAG, "stream not started");
+    ESP_RETURN_ON_FALSE(!dev->rx_cb, ESP_ERR_INVALID_STATE, TAG, "buffers go to the RX callback");
 
-    return korvo1_i2s_read(dev->config.port, buffer, bytes_to_read, bytes_read, ticks_to_wait);
+    return korvo1_i2s_read(dev->rx, buffer, bytes_to_read, bytes_read, ticks_to_wait);
+}
+
+uint32_t korvo1_overruns(const korvo1_t *dev)
+{
+    return dev ? __atomic_load_n(&dev->overruns, __ATOMIC_RELAXED) : 0;
 }
 
 esp_err_t korvo1_deinit(korvo1_t *dev)
@@ -100,9 +215,11 @@ esp_err_t korvo1_deinit(korvo1_t *dev)
         return ESP_OK;
     }
     if (dev->streaming) {
-        i2s_stop(dev->config.port);
+        i2s_channel_disable(dev->rx);
     }
-    i2s_driver_uninstall(dev->config.port);
+    i2s_del_channel(dev->rx);
+    dev->rx = NULL;
+    dev->rx_cb = NULL;
     dev->initialized = false;
     dev->streaming = false;
     return ESP_OK;
@@ -40,6 +40,25 @@ esp_err_t led_strip_new_rmt_device(const led_strip_config_t *config,
                                    const led_strip_rmt_config_t *rmt_config,
                                    led_strip_handle_t *ret_handle);
 esp_err_t led_strip_set_pixel(led_strip_handle_t handle, uint32_t index, uint32_t red, uint32_t green, uint32_t blue);
+/**
+ * Write count pixels from packed RGB triplets starting at index. When lut is
+ * set, every component goes through it on the way in (brightness, gamma).
+ */
+esp_err_t led_strip_set_pixels(led_strip_handle_t handle,
+                               uint32_t index,
+                               const uint8_t *rgb,
+                               uint32_t count,
+                               const uint8_t *lut);
+
+/**
+ * Queue the frame written so far and return without waiting for the wire.
+ * The next frame is written into the other buffer, which starts as a copy of
+ * the one just queued; this only blocks when a frame is submitted before the
+ * one before it has finished shifting out.
+ */
+esp_err_t led_strip_submit(led_strip_handle_t handle);
+
+// Submit and wait until the frame has been latched
 esp_err_t led_strip_refresh(led_strip_handle_t handle);
 esp_err_t led_strip_clear(led_strip_handle_t handle);
 esp_err_t led_strip_del(led_strip_handle_t handle);
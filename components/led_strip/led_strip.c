@@ -1,23 +1,43 @@
 #include "led_strip.h"
 
+#include <inttypes.h>
 #include <stdlib.h>
 #include <string.h>
 
+#include "driver/rmt_encoder.h"
+#include "driver/rmt_tx.h"
 #include "esp_check.h"
 #include "esp_log.h"
 #include "freertos/FreeRTOS.h"
-#include "freertos/task.h"
-#include "driver/rmt.h"
+#include "freertos/semphr.h"
+#include "soc/soc_caps.h"
+
+/*
+ * Frames are double buffered: callers fill the back buffer while the RMT
+ * channel shifts the front one out, and led_strip_submit() swaps them
+ * without waiting for the wire. The encoder streams GRB bytes straight into
+ * RMT memory (a DMA buffer when the SoC has one), followed by a latch gap,
+ * so no symbol array is built per frame.
+ */
+
+typedef struct {
+    rmt_encoder_t base;
+    rmt_encoder_t *bytes_encoder;
+    rmt_encoder_t *copy_encoder;
+    int state;
+    rmt_symbol_word_t reset_code;
+} led_strip_encoder_t;
 
 typedef struct led_strip_impl {
-    rmt_channel_t channel;
+    rmt_channel_handle_t channel;
+    rmt_encoder_handle_t encoder;
+    SemaphoreHandle_t done;           // Given once per finished transmission
     uint32_t led_count;
-    uint8_t *buffer;
+    uint8_t *frames[2];
+    uint8_t *buffer;                  // Back buffer, frames[back]
+    int back;
+    int inflight;
     bool inited;
-    uint32_t t0h_ticks;
-    uint32_t t0l_ticks;
-    uint32_t t1h_ticks;
-    uint32_t t1l_ticks;
 } led_strip_impl_t;
 
 static const char *TAG = "led_strip_drv";
@@ -26,52 +46,153 @@ static const uint32_t WS_T0H_NS = 350;
 static const uint32_t WS_T0L_NS = 1000;
 static const uint32_t WS_T1H_NS = 1000;
 static const uint32_t WS_T1L_NS = 350;
+// Newer WS2812B parts need more than 280 us low to latch
+static const uint32_t WS_RESET_US = 300;
 
-static uint32_t s_next_channel = RMT_CHANNEL_0;
+#define LED_STRIP_DEFAULT_RESOLUTION_HZ (10 * 1000 * 1000)
+#define LED_STRIP_DMA_SYMBOLS 1024
+#define LED_STRIP_QUEUE_DEPTH 2
 
-static inline rmt_channel_t led_strip_alloc_channel(void)
+static size_t led_strip_encode(rmt_encoder_t *encoder,
+                               rmt_channel_handle_t channel,
+                               const void *data,
+                               size_t data_size,
+                               rmt_encode_state_t *ret_state)
 {
-    rmt_channel_t ch = s_next_channel;
-    s_next_channel = (s_next_channel + 1) % RMT_CHANNEL_MAX;
-    return ch;
+    led_strip_encoder_t *enc = __containerof(encoder, led_strip_encoder_t, base);
+    rmt_encode_state_t session_state = RMT_ENCODING_RESET;
+    rmt_encode_state_t state = RMT_ENCODING_RESET;
+    size_t encoded = 0;
+
+    switch (enc->state) {
+    case 0:
+        encoded += enc->bytes_encoder->encode(enc->bytes_encoder, channel, data, data_size, &session_state);
+        if (session_state & RMT_ENCODING_COMPLETE) {
+            enc->state = 1;
+        }
+        if (session_state & RMT_ENCODING_MEM_FULL) {
+            state |= RMT_ENCODING_MEM_FULL;
+            break;
+        }
+        // fall through
+    case 1:
+        encoded += enc->copy_encoder->encode(enc->copy_encoder, channel, &enc->reset_code,
+                                             sizeof(enc->reset_code), &session_state);
+        if (session_state & RMT_ENCODING_COMPLETE) {
+            enc->state = RMT_ENCODING_RESET;
+            state |= RMT_ENCODING_COMPLETE;
+        }
+        if (session_state & RMT_ENCODING_MEM_FULL) {
+            state |= RMT_ENCODING_MEM_FULL;
+        }
+        break;
+    }
+    *ret_state = state;
+    return encoded;
 }
 
-static void led_strip_build_items(const led_strip_impl_t *impl,
-                                  const uint8_t *buffer,
-                                  size_t length,
-                                  rmt_item32_t *items)
+static esp_err_t led_strip_encoder_reset(rmt_encoder_t *encoder)
 {
-    rmt_item32_t bit0 = {{{ impl->t0h_ticks, 1, impl->t0l_ticks, 0 }}};
-    rmt_item32_t bit1 = {{{ impl->t1h_ticks, 1, impl->t1l_ticks, 0 }}};
+    led_strip_encoder_t *enc = __containerof(encoder, led_strip_encoder_t, base);
+    rmt_encoder_reset(enc->bytes_encoder);
+    rmt_encoder_reset(enc->copy_encoder);
+    enc->state = RMT_ENCODING_RESET;
+    return ESP_OK;
+}
 
-    size_t item_index = 0;
-    for (size_t byte = 0; byte < length; ++byte) {
-        for (int bit = 7; bit >= 0; --bit) {
-            items[item_index++] = (buffer[byte] & (1 << bit)) ? bit1 : bit0;
-        }
+static esp_err_t led_strip_encoder_del(rmt_encoder_t *encoder)
+{
+    led_strip_encoder_t *enc = __containerof(encoder, led_strip_encoder_t, base);
+    if (enc->bytes_encoder) {
+        rmt_del_encoder(enc->bytes_encoder);
     }
+    if (enc->copy_encoder) {
+        rmt_del_encoder(enc->copy_encoder);
+    }
+    free(enc);
+    return ESP_OK;
 }
 
-static esp_err_t led_strip_transmit(led_strip_impl_t *impl)
+static uint16_t led_strip_ticks(uint32_t resolution_hz, uint32_t ns)
 {
-    size_t item_count = impl->led_count * 24;
-    rmt_item32_t *items = malloc(item_count * sizeof(rmt_item32_t));
-    ESP_RETURN_ON_FALSE(items, ESP_ERR_NO_MEM, TAG, "no mem for RMT items");
+    return (uint16_t)(((uint64_t)resolution_hz * ns + 500000000ULL) / 1000000000ULL);
+}
 
-    led_strip_build_items(impl, impl->buffer, impl->led_count * 3, items);
-    esp_err_t ret = rmt_write_items(impl->channel, items, item_count, true);
-    if (ret == ESP_OK) {
-        ret = rmt_wait_tx_done(impl->channel, pdMS_TO_TICKS(100));
+static esp_err_t led_strip_new_encoder(uint32_t resolution_hz, rmt_encoder_handle_t *ret_encoder)
+{
+    led_strip_encoder_t *enc = calloc(1, sizeof(*enc));
+    ESP_RETURN_ON_FALSE(enc, ESP_ERR_NO_MEM, TAG, "no mem encoder");
+    enc->base.encode = led_strip_encode;
+    enc->base.reset = led_strip_encoder_reset;
+    enc->base.del = led_strip_encoder_del;
+
+    rmt_bytes_encoder_config_t bytes_config = {
+        .bit0 = {
+            .level0 = 1,
+            .duration0 = led_strip_ticks(resolution_hz, WS_T0H_NS),
+            .level1 = 0,
+            .duration1 = led_strip_ticks(resolution_hz, WS_T0L_NS),
+        },
+        .bit1 = {
+            .level0 = 1,
+            .duration0 = led_strip_ticks(resolution_hz, WS_T1H_NS),
+            .level1 = 0,
+            .duration1 = led_strip_ticks(resolution_hz, WS_T1L_NS),
+        },
+        .flags.msb_first = 1,
+    };
+    rmt_copy_encoder_config_t copy_config = {};
+    esp_err_t err = rmt_new_bytes_encoder(&bytes_config, &enc->bytes_encoder);
+    if (err == ESP_OK) {
+        err = rmt_new_copy_encoder(&copy_config, &enc->copy_encoder);
+    }
+    if (err != ESP_OK) {
+        led_strip_encoder_del(&enc->base);
+        return err;
     }
-    free(items);
-    return ret;
+
+    uint16_t half_reset = led_strip_ticks(resolution_hz, WS_RESET_US * 1000) / 2;
+    enc->reset_code = (rmt_symbol_word_t){
+        .level0 = 0,
+        .duration0 = half_reset,
+        .level1 = 0,
+        .duration1 = half_reset,
+    };
+    *ret_encoder = &enc->base;
+    return ESP_OK;
+}
+
+static bool led_strip_on_done(rmt_channel_handle_t channel, const rmt_tx_done_event_data_t *edata, void *ctx)
+{
+    (void)channel;
+    (void)edata;
+    led_strip_impl_t *impl = ctx;
+    BaseType_t woken = pdFALSE;
+    xSemaphoreGiveFromISR(impl->done, &woken);
+    return woken == pdTRUE;
+}
+
+static void led_strip_destroy(led_strip_impl_t *impl)
+{
+    if (impl->channel) {
+        rmt_disable(impl->channel);
+        rmt_del_channel(impl->channel);
+    }
+    if (impl->encoder) {
+        rmt_del_encoder(impl->encoder);
+    }
+    if (impl->done) {
+        vSemaphoreDelete(impl->done);
+    }
+    free(impl->frames[0]);
+    free(impl);
 }
 
 esp_err_t led_strip_new_rmt_device(const led_strip_config_t *config,
                                    const led_strip_rmt_config_t *rmt_dev_cfg,
                                    led_strip_handle_t *ret_handle)
 {
-    ESP_RETURN_ON_FALSE(config && ret_handle, ESP_ERR_INVALID_ARG, TAG, "bad args");
+    ESP_RETURN_ON_FALSE(config && ret_handle && config->max_leds > 0, ESP_ERR_INVALID_ARG, TAG, "bad args");
     ESP_RETURN_ON_FALSE(config->led_model == LED_MODEL_WS2812, ESP_ERR_NOT_SUPPORTED, TAG, "only WS2812 supported");
     ESP_RETURN_ON_FALSE(config->color_component_format == LED_STRIP_COLOR_COMPONENT_FMT_RGB,
                         ESP_ERR_NOT_SUPPORTED,
@@ -81,45 +202,55 @@ esp_err_t led_strip_new_rmt_device(const led_strip_config_t *config,
     led_strip_impl_t *impl = calloc(1, sizeof(led_strip_impl_t));
     ESP_RETURN_ON_FALSE(impl, ESP_ERR_NO_MEM, TAG, "no mem impl");
     impl->led_count = config->max_leds;
-    impl->buffer = calloc(config->max_leds, 3);
-    if (!impl->buffer) {
-        free(impl);
+    // Both frames share one allocation
+    impl->frames[0] = calloc(2 * config->max_leds, 3);
+    impl->done = xSemaphoreCreateCounting(LED_STRIP_QUEUE_DEPTH, 0);
+    if (!impl->frames[0] || !impl->done) {
+        led_strip_destroy(impl);
         return ESP_ERR_NO_MEM;
     }
+    impl->frames[1] = impl->frames[0] + config->max_leds * 3;
+    impl->buffer = impl->frames[0];
 
-    rmt_channel_t channel = led_strip_alloc_channel();
+    uint32_t resolution_hz = rmt_dev_cfg && rmt_dev_cfg->resolution_hz > 0 ? rmt_dev_cfg->resolution_hz
+                                                                          : LED_STRIP_DEFAULT_RESOLUTION_HZ;
+    bool with_dma = rmt_dev_cfg && rmt_dev_cfg->with_dma;
+#if !SOC_RMT_SUPPORT_DMA
+    with_dma = false;
+#endif
+    rmt_tx_channel_config_t channel_config = {
+        .gpio_num = config->strip_gpio_num,
+        .clk_src = RMT_CLK_SRC_DEFAULT,
+        .resolution_hz = resolution_hz,
+        .mem_block_symbols = with_dma ? LED_STRIP_DMA_SYMBOLS : SOC_RMT_MEM_WORDS_PER_CHANNEL,
+        .trans_queue_depth = LED_STRIP_QUEUE_DEPTH,
+        .flags = {
+            .invert_out = config->flags.invert_out,
+            .with_dma = with_dma,
+        },
+    };
+    const rmt_tx_event_callbacks_t callbacks = {
+        .on_trans_done = led_strip_on_done,
+    };
+    esp_err_t err = rmt_new_tx_channel(&channel_config, &impl->channel);
+    if (err == ESP_OK) {
+        err = led_strip_new_encoder(resolution_hz, &impl->encoder);
+    }
+    if (err == ESP_OK) {
+        err = rmt_tx_register_event_callbacks(impl->channel, &callbacks, impl);
+    }
+    if (err == ESP_OK) {
+        err = rmt_enable(impl->channel);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "RMT TX channel setup failed (%s)", esp_err_to_name(err));
+        led_strip_destroy(impl);
+        return err;
+    }
 
-    rmt_config_t rmt_cfg = RMT_DEFAULT_CONFIG_TX(config->strip_gpio_num, channel);
-    rmt_cfg.clk_div = 2;
-    // Calculate clock divider if resolution is specified
-    if (rmt_dev_cfg && rmt_dev_cfg->resolution_hz > 0) {
-        // For ESP-IDF v4.4, we need to install driver first before getting clock
-        // Use a default base clock estimate (80MHz APB clock / 2 = 40MHz typical)
-        uint32_t base_clk = 40 * 1000 * 1000; // 40MHz default
-        uint32_t div = base_clk / rmt_dev_cfg->resolution_hz;
-        if (div == 0) {
-            div = 1;
-        }
-        rmt_cfg.clk_div = div;
-    }
-    ESP_RETURN_ON_ERROR(rmt_config(&rmt_cfg), TAG, "rmt config failed");
-    ESP_RETURN_ON_ERROR(rmt_driver_install(channel, 0, 0), TAG, "rmt driver install failed");
-
-    impl->channel = channel;
-    // Calculate counter clock from APB clock and divider
-    // ESP-IDF v4.4: APB clock is typically 80MHz, RMT uses APB clock / clk_div
-    // We configured clk_div above, so counter_clk = APB_CLK / clk_div
-    uint32_t apb_clk_hz = 80 * 1000 * 1000; // 80MHz APB clock (typical for ESP32-S3)
-    uint32_t counter_clk_hz = apb_clk_hz / rmt_cfg.clk_div;
-    if (counter_clk_hz == 0) {
-        counter_clk_hz = 40 * 1000 * 1000; // Fallback to 40MHz
-    }
-    float ratio = (float)counter_clk_hz / 1e9f;
-    impl->t0h_ticks = (uint32_t)(ratio * WS_T0H_NS);
-    impl->t0l_ticks = (uint32_t)(ratio * WS_T0L_NS);
-    impl->t1h_ticks = (uint32_t)(ratio * WS_T1H_NS);
-    impl->t1l_ticks = (uint32_t)(ratio * WS_T1L_NS);
     impl->inited = true;
+    ESP_LOGI(TAG, "WS2812 on GPIO%d: %" PRIu32 " LEDs, %s", config->strip_gpio_num, impl->led_count,
+             with_dma ? "DMA" : "RMT memory");
     *ret_handle = impl;
     return ESP_OK;
 }
@@ -140,11 +271,82 @@ esp_err_t led_strip_set_pixel(led_strip_handle_t handle,
     return ESP_OK;
 }
 
+esp_err_t led_strip_set_pixels(led_strip_handle_t handle,
+                               uint32_t index,
+                               const uint8_t *rgb,
+                               uint32_t count,
+                               const uint8_t *lut)
+{
+    led_strip_impl_t *impl = handle;
+    ESP_RETURN_ON_FALSE(impl && impl->inited, ESP_ERR_INVALID_STATE, TAG, "not ready");
+    ESP_RETURN_ON_FALSE(rgb && index <= impl->led_count && count <= impl->led_count - index,
+                        ESP_ERR_INVALID_ARG,
+                        TAG,
+                        "range out of bounds");
+    uint8_t *out = impl->buffer + index * 3;
+    if (lut) {
+        for (uint32_t i = 0; i < count; ++i, rgb += 3, out += 3) {
+            out[0] = lut[rgb[1]];
+            out[1] = lut[rgb[0]];
+            out[2] = lut[rgb[2]];
+        }
+    } else {
+        for (uint32_t i = 0; i < count; ++i, rgb += 3, out += 3) {
+            out[0] = rgb[1];
+            out[1] = rgb[0];
+            out[2] = rgb[2];
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t led_strip_submit(led_strip_handle_t handle)
+{
+    led_strip_impl_t *impl = handle;
+    ESP_RETURN_ON_FALSE(impl && impl->inited, ESP_ERR_INVALID_STATE, TAG, "not ready");
+
+    // Reap frames the channel has finished since the last submit
+    while (impl->inflight > 0 && xSemaphoreTake(impl->done, 0) == pdTRUE) {
+        impl->inflight--;
+    }
+
+    const rmt_transmit_config_t tx_config = {
+        .loop_count = 0,
+    };
+    uint8_t *front = impl->buffer;
+    ESP_RETURN_ON_ERROR(rmt_transmit(impl->channel, impl->encoder, front, impl->led_count * 3, &tx_config),
+                        TAG, "rmt transmit failed");
+    impl->inflight++;
+
+    // The other frame may still be on the wire from the submit before this one
+    if (impl->inflight >= LED_STRIP_QUEUE_DEPTH) {
+        if (xSemaphoreTake(impl->done, pdMS_TO_TICKS(100)) != pdTRUE) {
+            return ESP_ERR_TIMEOUT;
+        }
+        impl->inflight--;
+    }
+    impl->back ^= 1;
+    impl->buffer = impl->frames[impl->back];
+    // Callers may update only some pixels, so the back buffer starts as the frame just sent
+    memcpy(impl->buffer, front, impl->led_count * 3);
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_wait_idle(led_strip_impl_t *impl, TickType_t timeout)
+{
+    esp_err_t err = rmt_tx_wait_all_done(impl->channel, (int)pdTICKS_TO_MS(timeout));
+    while (xSemaphoreTake(impl->done, 0) == pdTRUE) {
+    }
+    impl->inflight = 0;
+    return err;
+}
+
 esp_err_t led_strip_refresh(led_strip_handle_t handle)
 {
     led_strip_impl_t *impl = handle;
     ESP_RETURN_ON_FALSE(impl && impl->inited, ESP_ERR_INVALID_STATE, TAG, "not ready");
-    return led_strip_transmit(impl);
+    ESP_RETURN_ON_ERROR(led_strip_submit(impl), TAG, "submit failed");
+    return led_strip_wait_idle(impl, pdMS_TO_TICKS(100));
 }
 
 esp_err_t led_strip_clear(led_strip_handle_t handle)
@@ -152,7 +354,7 @@ esp_err_t led_strip_clear(led_strip_handle_t handle)
     led_strip_impl_t *impl = handle;
     ESP_RETURN_ON_FALSE(impl && impl->inited, ESP_ERR_INVALID_STATE, TAG, "not ready");
     memset(impl->buffer, 0, impl->led_count * 3);
-    return led_strip_transmit(impl);
+    return led_strip_refresh(impl);
 }
 
 esp_err_t led_strip_del(led_strip_handle_t handle)
@@ -162,9 +364,8 @@ esp_err_t led_strip_del(led_strip_handle_t handle)
         return ESP_OK;
     }
     if (impl->inited) {
-        rmt_driver_uninstall(impl->channel);
+        led_strip_wait_idle(impl, pdMS_TO_TICKS(100));
     }
-    free(impl->buffer);
-    free(impl);
+    led_strip_destroy(impl);
     return ESP_OK;
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <stdbool.h>
+#include <stdint.h>
 
 #include "cJSON.h"
 #include "esp_err.h"
@@ -45,6 +46,13 @@ typedef struct {
 
 esp_err_t matter_bridge_register_device(const matter_bridge_device_registration_t *registration);
 
+/**
+ * Report the player state of a registered device. Like sensor samples, the
+ * values are coalesced and written to the Media Playback and Level Control
+ * clusters at the next reporting interval.
+ */
+esp_err_t matter_bridge_update_media_state(matter_bridge_device_kind_t kind, bool playing, uint8_t volume_percent);
+
 // Matter attribute write callbacks (called from Matter controllers)
 typedef struct {
     void *device_handle;  // Device context (e.g., spotify_client_t*)
@@ -1,10 +1,14 @@
 #include "matter_bridge.h"
 
+#include <math.h>
 #include <string.h>
 
+#include "esp_check.h"
 #include "esp_log.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "matter_bridge_priv.h"
 #include "sdkconfig.h"
 
 static const char *TAG = "matter_bridge";
@@ -37,17 +41,48 @@ void matter_bridge_sensor_observer(const char *sensor_name, const cJSON *sensor_
     (void)user_ctx;
 }
 
+esp_err_t matter_bridge_update_media_state(matter_bridge_device_kind_t kind, bool playing, uint8_t volume_percent)
+{
+    (void)kind;
+    (void)playing;
+    (void)volume_percent;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
 #else
 
+#ifndef CONFIG_NAPHOME_MATTER_BRIDGE_REPORT_INTERVAL_MS
+#define CONFIG_NAPHOME_MATTER_BRIDGE_REPORT_INTERVAL_MS 10000
+#endif
+
+#define MATTER_BRIDGE_MAX_DEVICES 4
+#define MATTER_BRIDGE_REPORT_TASK_STACK 4096
+#define MATTER_BRIDGE_REPORT_TASK_PRIORITY (tskIDLE_PRIORITY + 2)
+
+// Cluster enum values (AirQualityEnum, PlaybackStateEnum)
+#define MATTER_BRIDGE_AIR_QUALITY_GOOD 1
+#define MATTER_BRIDGE_PLAYBACK_PLAYING 0
+#define MATTER_BRIDGE_PLAYBACK_PAUSED 1
+
+/*
+ * Latest value of each attribute since the last flush. Observers only write
+ * here; the report task turns the dirty bits into one batch per interval, so
+ * a sensor that ticks every second still costs one attribute report per
+ * interval at most, and an unchanged value costs none.
+ */
+typedef struct {
+    uint32_t present;
+    uint32_t dirty;
+    int32_t value[MATTER_BRIDGE_ATTR_COUNT];
+} matter_bridge_attrs_t;
+
 typedef struct {
     bool in_use;
     matter_bridge_sensor_kind_t kind;
     char name[CONFIG_NAPHOME_MATTER_BRIDGE_SENSOR_NAME_MAX_LEN];
     char label[CONFIG_NAPHOME_MATTER_BRIDGE_ENDPOINT_LABEL_MAX_LEN];
-#if CONFIG_NAPHOME_MATTER_BRIDGE_USE_ESPMATTER
-    // Placeholder for esp-matter endpoint handles
-    void *endpoint_handle;
-#endif
+    uint16_t endpoint_id;
+    matter_bridge_attrs_t attrs;
 } matter_bridge_sensor_entry_t;
 
 typedef struct {
@@ -55,18 +90,35 @@ typedef struct {
     matter_bridge_device_kind_t kind;
     char label[CONFIG_NAPHOME_MATTER_BRIDGE_ENDPOINT_LABEL_MAX_LEN];
     void *device_handle;  // Device context (e.g., spotify_client_t*)
-#if CONFIG_NAPHOME_MATTER_BRIDGE_USE_ESPMATTER
-    void *endpoint_handle;
-#endif
+    uint16_t endpoint_id;
+    matter_bridge_attrs_t attrs;
 } matter_bridge_device_entry_t;
 
 static SemaphoreHandle_t s_registry_lock;
 static matter_bridge_sensor_entry_t s_registry[CONFIG_NAPHOME_MATTER_BRIDGE_MAX_SENSORS];
-#define MATTER_BRIDGE_MAX_DEVICES 4
 static matter_bridge_device_entry_t s_device_registry[MATTER_BRIDGE_MAX_DEVICES];
 static bool s_initialized;
 static bool s_started;
 static matter_bridge_config_t s_cfg;
+static TaskHandle_t s_report_task;
+// Only touched by the report task
+static matter_bridge_report_t s_batch[(CONFIG_NAPHOME_MATTER_BRIDGE_MAX_SENSORS + MATTER_BRIDGE_MAX_DEVICES) *
+                                     MATTER_BRIDGE_ATTR_COUNT];
+
+static const char *const s_attr_names[MATTER_BRIDGE_ATTR_COUNT] = {
+    [MATTER_BRIDGE_ATTR_TEMPERATURE] = "temperature",
+    [MATTER_BRIDGE_ATTR_HUMIDITY] = "humidity",
+    [MATTER_BRIDGE_ATTR_CO2] = "co2",
+    [MATTER_BRIDGE_ATTR_AIR_QUALITY] = "air_quality",
+    [MATTER_BRIDGE_ATTR_ILLUMINANCE] = "illuminance",
+    [MATTER_BRIDGE_ATTR_PLAYBACK_STATE] = "playback_state",
+    [MATTER_BRIDGE_ATTR_VOLUME] = "volume",
+};
+
+// Upper bounds for Good, Fair, Moderate, Poor and Very Poor; above is Extremely Poor
+static const float s_co2_ppm_limits[] = {600, 1000, 1500, 2000, 5000};
+static const float s_voc_index_limits[] = {100, 150, 200, 300, 400};
+static const float s_pm2_5_limits[] = {12, 35, 55, 150, 250};
 
 static void matter_bridge_copy_string(char *dest, size_t dest_len, const char *src)
 {
@@ -102,21 +154,20 @@ static matter_bridge_sensor_entry_t *matter_bridge_alloc_entry(const char *senso
     }
     for (size_t i = 0; i < CONFIG_NAPHOME_MATTER_BRIDGE_MAX_SENSORS; ++i) {
         if (!s_registry[i].in_use) {
+            memset(&s_registry[i], 0, sizeof(s_registry[i]));
             s_registry[i].in_use = true;
             s_registry[i].kind = MATTER_BRIDGE_SENSOR_KIND_GENERIC;
             matter_bridge_copy_string(s_registry[i].name,
                                       sizeof(s_registry[i].name),
                                       sensor_name);
-            s_registry[i].label[0] = '\0';
-#if CONFIG_NAPHOME_MATTER_BRIDGE_USE_ESPMATTER
-            s_registry[i].endpoint_handle = NULL;
-#endif
+            s_registry[i].endpoint_id = MATTER_BRIDGE_ENDPOINT_NONE;
             return &s_registry[i];
         }
     }
     return NULL;
 }
 
+#if !CONFIG_NAPHOME_MATTER_BRIDGE_USE_ESPMATTER
 static void matter_bridge_log_state(const matter_bridge_sensor_entry_t *entry, const cJSON *sensor_state)
 {
     const cJSON *child = sensor_state ? sensor_state->child : NULL;
@@ -134,6 +185,215 @@ static void matter_bridge_log_state(const matter_bridge_sensor_entry_t *entry, c
         child = child->next;
     }
 }
+#endif
+
+static void matter_bridge_attr_set(matter_bridge_attrs_t *attrs, matter_bridge_attr_t attr, int32_t value)
+{
+    uint32_t bit = 1u << attr;
+    if ((attrs->present & bit) && attrs->value[attr] == value) {
+        return;
+    }
+    attrs->value[attr] = value;
+    attrs->present |= bit;
+    attrs->dirty |= bit;
+}
+
+static bool matter_bridge_get_number(const cJSON *state, const char *key, double *out)
+{
+    const cJSON *item = cJSON_GetObjectItemCaseSensitive(state, key);
+    if (!cJSON_IsNumber(item) || isnan(item->valuedouble)) {
+        return false;
+    }
+    *out = item->valuedouble;
+    return true;
+}
+
+static int32_t matter_bridge_clamp(double value, int32_t min, int32_t max)
+{
+    if (value < min) {
+        return min;
+    }
+    if (value > max) {
+        return max;
+    }
+    return (int32_t)lround(value);
+}
+
+static int32_t matter_bridge_classify_air_quality(double value, const float limits[5])
+{
+    int32_t level = MATTER_BRIDGE_AIR_QUALITY_GOOD;
+    for (size_t i = 0; i < 5 && value > limits[i]; ++i) {
+        level++;
+    }
+    return level;
+}
+
+/*
+ * Convert the sensor-manager fields this kind understands into cluster units.
+ * Returns the number of attributes recognised, so unmapped sensors can still
+ * be logged in stub mode.
+ */
+static int matter_bridge_record_state(matter_bridge_sensor_entry_t *entry, const cJSON *sensor_state)
+{
+    matter_bridge_attrs_t *attrs = &entry->attrs;
+    double v;
+    int mapped = 0;
+
+    switch (entry->kind) {
+    case MATTER_BRIDGE_SENSOR_KIND_ENVIRONMENT:
+        if (matter_bridge_get_number(sensor_state, "temperature_c", &v)) {
+            matter_bridge_attr_set(attrs, MATTER_BRIDGE_ATTR_TEMPERATURE, matter_bridge_clamp(v * 100.0, -27315, 32767));
+            mapped++;
+        }
+        if (matter_bridge_get_number(sensor_state, "humidity_rh", &v)) {
+            matter_bridge_attr_set(attrs, MATTER_BRIDGE_ATTR_HUMIDITY, matter_bridge_clamp(v * 100.0, 0, 10000));
+            mapped++;
+        }
+        break;
+    case MATTER_BRIDGE_SENSOR_KIND_IAQ:
+        if (matter_bridge_get_number(sensor_state, "co2_ppm", &v)) {
+            matter_bridge_attr_set(attrs, MATTER_BRIDGE_ATTR_CO2, matter_bridge_clamp(v, 0, 40000));
+            matter_bridge_attr_set(attrs, MATTER_BRIDGE_ATTR_AIR_QUALITY,
+                                   matter_bridge_classify_air_quality(v, s_co2_ppm_limits));
+            mapped++;
+        } else if (matter_bridge_get_number(sensor_state, "voc_index", &v)) {
+            matter_bridge_attr_set(attrs, MATTER_BRIDGE_ATTR_AIR_QUALITY,
+                                   matter_bridge_classify_air_quality(v, s_voc_index_limits));
+            mapped++;
+        }
+        break;
+    case MATTER_BRIDGE_SENSOR_KIND_PM:
+        if (matter_bridge_get_number(sensor_state, "pm2_5_ug_m3", &v)) {
+            matter_bridge_attr_set(attrs, MATTER_BRIDGE_ATTR_AIR_QUALITY,
+                                   matter_bridge_classify_air_quality(v, s_pm2_5_limits));
+            mapped++;
+        }
+        break;
+    case MATTER_BRIDGE_SENSOR_KIND_LIGHT:
+        if (matter_bridge_get_number(sensor_state, "ambient_lux", &v)) {
+            // 0 means "too low to measure" in the Illuminance Measurement cluster
+            int32_t encoded = v >= 1.0 ? matter_bridge_clamp(10000.0 * log10(v) + 1.0, 1, 0xFFFE) : 0;
+            matter_bridge_attr_set(attrs, MATTER_BRIDGE_ATTR_ILLUMINANCE, encoded);
+            mapped++;
+        }
+        break;
+    default:
+        break;
+    }
+    return mapped;
+}
+
+static size_t matter_bridge_collect(matter_bridge_attrs_t *attrs,
+                                    uint16_t endpoint_id,
+                                    const char *owner,
+                                    matter_bridge_report_t *out,
+                                    size_t room)
+{
+    size_t count = 0;
+#if CONFIG_NAPHOME_MATTER_BRIDGE_USE_ESPMATTER
+    // Keep values pending until the endpoint exists
+    if (endpoint_id == MATTER_BRIDGE_ENDPOINT_NONE) {
+        return 0;
+    }
+#endif
+    for (int attr = 0; attr < MATTER_BRIDGE_ATTR_COUNT && count < room; ++attr) {
+        if (attrs->dirty & (1u << attr)) {
+            out[count].endpoint_id = endpoint_id;
+            out[count].attr = (matter_bridge_attr_t)attr;
+            out[count].value = attrs->value[attr];
+            out[count].owner = owner;
+            count++;
+        }
+    }
+    attrs->dirty = 0;
+    return count;
+}
+
+static void matter_bridge_flush(void)
+{
+    if (xSemaphoreTake(s_registry_lock, pdMS_TO_TICKS(50)) != pdTRUE) {
+        return; // Still dirty, picked up next interval
+    }
+    size_t count = 0;
+    const size_t room = sizeof(s_batch) / sizeof(s_batch[0]);
+    for (size_t i = 0; i < CONFIG_NAPHOME_MATTER_BRIDGE_MAX_SENSORS; ++i) {
+        matter_bridge_sensor_entry_t *entry = &s_registry[i];
+        if (entry->in_use && entry->attrs.dirty) {
+            count += matter_bridge_collect(&entry->attrs, entry->endpoint_id,
+                                           entry->label[0] ? entry->label : entry->name,
+                                           &s_batch[count], room - count);
+        }
+    }
+    for (size_t i = 0; i < MATTER_BRIDGE_MAX_DEVICES; ++i) {
+        matter_bridge_device_entry_t *entry = &s_device_registry[i];
+        if (entry->in_use && entry->attrs.dirty) {
+            count += matter_bridge_collect(&entry->attrs, entry->endpoint_id, entry->label,
+                                           &s_batch[count], room - count);
+        }
+    }
+    xSemaphoreGive(s_registry_lock);
+
+    if (count == 0) {
+        return;
+    }
+#if CONFIG_NAPHOME_MATTER_BRIDGE_USE_ESPMATTER
+    for (size_t i = 0; i < count; ++i) {
+        ESP_LOGD(TAG, "[%s] endpoint %u %s=%ld", s_batch[i].owner, s_batch[i].endpoint_id,
+                 s_attr_names[s_batch[i].attr], (long)s_batch[i].value);
+    }
+    esp_err_t err = matter_bridge_endpoints_report(s_batch, count);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Attribute report of %u values failed: %s", (unsigned)count, esp_err_to_name(err));
+    }
+#else
+    for (size_t i = 0; i < count; ++i) {
+        ESP_LOGI(TAG, "[%s] %s=%ld", s_batch[i].owner, s_attr_names[s_batch[i].attr], (long)s_batch[i].value);
+    }
+#endif
+}
+
+static void matter_bridge_report_task(void *arg)
+{
+    (void)arg;
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(CONFIG_NAPHOME_MATTER_BRIDGE_REPORT_INTERVAL_MS));
+        matter_bridge_flush();
+    }
+}
+
+#if CONFIG_NAPHOME_MATTER_BRIDGE_USE_ESPMATTER
+static void matter_bridge_attach_sensor(matter_bridge_sensor_entry_t *entry)
+{
+    if (entry->endpoint_id != MATTER_BRIDGE_ENDPOINT_NONE || entry->kind == MATTER_BRIDGE_SENSOR_KIND_GENERIC) {
+        return;
+    }
+    esp_err_t err = matter_bridge_endpoints_add_sensor(entry->kind,
+                                                       entry->label[0] ? entry->label : entry->name,
+                                                       &entry->endpoint_id);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "No endpoint for sensor '%s': %s", entry->name, esp_err_to_name(err));
+        return;
+    }
+    // Everything recorded so far goes out with the first report
+    entry->attrs.dirty = entry->attrs.present;
+    ESP_LOGI(TAG, "Sensor '%s' on endpoint %u", entry->name, entry->endpoint_id);
+}
+
+static void matter_bridge_attach_device(matter_bridge_device_entry_t *entry)
+{
+    if (entry->endpoint_id != MATTER_BRIDGE_ENDPOINT_NONE) {
+        return;
+    }
+    esp_err_t err = matter_bridge_endpoints_add_device(entry->kind, entry->label, entry->device_handle,
+                                                       &entry->endpoint_id);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "No endpoint for device '%s': %s", entry->label, esp_err_to_name(err));
+        return;
+    }
+    entry->attrs.dirty = entry->attrs.present;
+    ESP_LOGI(TAG, "Device '%s' on endpoint %u", entry->label, entry->endpoint_id);
+}
+#endif
 
 esp_err_t matter_bridge_init(const matter_bridge_config_t *config)
 {
@@ -165,12 +425,37 @@ esp_err_t matter_bridge_start(void)
 
 #if CONFIG_NAPHOME_MATTER_BRIDGE_USE_ESPMATTER
     ESP_LOGI(TAG, "Matter bridge starting with esp-matter integration");
-    // TODO: Add esp-matter node/endpoint bring-up
+    ESP_RETURN_ON_ERROR(matter_bridge_endpoints_start(s_cfg.enable_matter_console),
+                        TAG, "Failed to start Matter node");
 #else
     ESP_LOGI(TAG, "Matter bridge running in stub mode (logging only)");
 #endif
 
+    if (!s_report_task &&
+        xTaskCreate(matter_bridge_report_task, "matter_report", MATTER_BRIDGE_REPORT_TASK_STACK, NULL,
+                    MATTER_BRIDGE_REPORT_TASK_PRIORITY, &s_report_task) != pdPASS) {
+        s_report_task = NULL;
+        ESP_LOGE(TAG, "Failed to create report task");
+        return ESP_ERR_NO_MEM;
+    }
+
+    xSemaphoreTake(s_registry_lock, portMAX_DELAY);
+#if CONFIG_NAPHOME_MATTER_BRIDGE_USE_ESPMATTER
+    // Anything registered before start gets its endpoint now
+    for (size_t i = 0; i < CONFIG_NAPHOME_MATTER_BRIDGE_MAX_SENSORS; ++i) {
+        if (s_registry[i].in_use) {
+            matter_bridge_attach_sensor(&s_registry[i]);
+        }
+    }
+    for (size_t i = 0; i < MATTER_BRIDGE_MAX_DEVICES; ++i) {
+        if (s_device_registry[i].in_use) {
+            matter_bridge_attach_device(&s_device_registry[i]);
+        }
+    }
+#endif
     s_started = true;
+    xSemaphoreGive(s_registry_lock);
+    ESP_LOGI(TAG, "Reporting attribute changes every %d ms", CONFIG_NAPHOME_MATTER_BRIDGE_REPORT_INTERVAL_MS);
     return ESP_OK;
 }
 
@@ -197,11 +482,17 @@ esp_err_t matter_bridge_register_sensor(const matter_bridge_sensor_registration_
         }
     }
 
-    entry->kind = registration->sensor_kind;
+    if (entry->endpoint_id != MATTER_BRIDGE_ENDPOINT_NONE && entry->kind != registration->sensor_kind) {
+        ESP_LOGW(TAG, "Sensor '%s' already has an endpoint; kind change ignored", registration->sensor_name);
+    } else {
+        entry->kind = registration->sensor_kind;
+    }
     matter_bridge_copy_string(entry->label, sizeof(entry->label), registration->endpoint_label);
 
 #if CONFIG_NAPHOME_MATTER_BRIDGE_USE_ESPMATTER
-    // TODO: Allocate or update esp-matter endpoints as required
+    if (s_started) {
+        matter_bridge_attach_sensor(entry);
+    }
 #endif
 
     xSemaphoreGive(s_registry_lock);
@@ -235,15 +526,14 @@ void matter_bridge_sensor_observer(const char *sensor_name, const cJSON *sensor_
         ESP_LOGI(TAG, "Auto-registered sensor '%s' with default kind", sensor_name);
     }
 
-#if CONFIG_NAPHOME_MATTER_BRIDGE_USE_ESPMATTER
-    // TODO: Update esp-matter clusters/endpoints here
-    // Map sensor data to Matter clusters:
-    // - MATTER_BRIDGE_SENSOR_KIND_ENVIRONMENT -> Temperature Measurement (0x0402), Relative Humidity (0x0405)
-    // - MATTER_BRIDGE_SENSOR_KIND_IAQ -> Air Quality (0x042C), Carbon Dioxide (0x040D)
-    // - MATTER_BRIDGE_SENSOR_KIND_LIGHT -> Illuminance Measurement (0x0400)
-    // - MATTER_BRIDGE_SENSOR_KIND_PM -> Air Quality (0x042C) with PM2.5/PM10 attributes
+    // Only record here; the report task writes attributes once per interval
+    int mapped = matter_bridge_record_state(entry, sensor_state);
+#if !CONFIG_NAPHOME_MATTER_BRIDGE_USE_ESPMATTER
+    if (mapped == 0) {
+        matter_bridge_log_state(entry, sensor_state);
+    }
 #else
-    matter_bridge_log_state(entry, sensor_state);
+    (void)mapped;
 #endif
 
     xSemaphoreGive(s_registry_lock);
@@ -263,11 +553,9 @@ static matter_bridge_device_entry_t *matter_bridge_alloc_device(void)
 {
     for (size_t i = 0; i < MATTER_BRIDGE_MAX_DEVICES; ++i) {
         if (!s_device_registry[i].in_use) {
+            memset(&s_device_registry[i], 0, sizeof(s_device_registry[i]));
             s_device_registry[i].in_use = true;
-            s_device_registry[i].device_handle = NULL;
-#if CONFIG_NAPHOME_MATTER_BRIDGE_USE_ESPMATTER
-            s_device_registry[i].endpoint_handle = NULL;
-#endif
+            s_device_registry[i].endpoint_id = MATTER_BRIDGE_ENDPOINT_NONE;
             return &s_device_registry[i];
         }
     }
@@ -298,50 +586,11 @@ esp_err_t matter_bridge_register_device(const matter_bridge_device_registration_
     matter_bridge_copy_string(entry->label, sizeof(entry->label), registration->endpoint_label);
 
 #if CONFIG_NAPHOME_MATTER_BRIDGE_USE_ESPMATTER
-    // TODO: Create Matter endpoint for device
-    // For Spotify: Create Media Playback cluster (0x0506) endpoint
-    // - PlaybackState (0x0000): Playing, Paused, NotPlaying
-    // - PlaybackSpeed (0x0001): float
-    // - PlaybackSeekRangeEnd (0x0002): uint64_t
-    // - PlaybackSeekRangeStart (0x0003): uint64_t
-    // - PlaybackSupportedPlaybackSpeeds (0x0004): array
-    // - PlaybackSupportedPlaybackCommands (0x0005): array
-    // - PlaybackPositionUpdatedAt (0x0006): uint64_t
-    // - PlaybackPosition (0x0007): uint64_t
-    // - PlaybackDuration (0x0008): uint64_t
-    // - PlaybackSampledPosition (0x0009): struct
-    // - PlaybackPlaybackSpeed (0x000A): float
-    // - PlaybackSeekedAt (0x000B): uint64_t
-    // - PlaybackCurrentActiveAudioTrack (0x000C): struct
-    // - PlaybackNextTrack (0x000D): struct
-    // - PlaybackPreviousTrack (0x000E): struct
-    // - PlaybackCurrentTrack (0x000F): struct
-    // - PlaybackPlaybackRepeatMode (0x0010): enum
-    // - PlaybackPlaybackSpeedRange (0x0011): struct
-    // - PlaybackActiveAudioTrack (0x0012): struct
-    // Commands:
-    // - Play (0x00)
-    // - Pause (0x01)
-    // - Stop (0x02)
-    // - StartOver (0x03)
-    // - Previous (0x04)
-    // - Next (0x05)
-    // - Rewind (0x06)
-    // - FastForward (0x07)
-    // - SkipForward (0x08)
-    // - SkipBackward (0x09)
-    // - Seek (0x0A)
-    // Also add Level Control cluster (0x0008) for volume:
-    // - CurrentLevel (0x0000): uint8_t (0-100)
-    // Commands:
-    // - MoveToLevel (0x00)
-    // - Move (0x01)
-    // - Step (0x02)
-    // - Stop (0x03)
-    // - MoveToLevelWithOnOff (0x04)
-    // - MoveWithOnOff (0x05)
-    // - StepWithOnOff (0x06)
-    // - StopWithOnOff (0x07)
+    // Media Playback (0x0506) for state, On/Off for play/pause and Level
+    // Control (0x0008) for volume; controller writes land in matter_bridge_spotify_*
+    if (s_started) {
+        matter_bridge_attach_device(entry);
+    }
 #else
     ESP_LOGI(TAG, "Registered device '%s' (kind=%d) - stub mode", entry->label, entry->kind);
 #endif
@@ -351,6 +600,28 @@ esp_err_t matter_bridge_register_device(const matter_bridge_device_registration_
     return ESP_OK;
 }
 
+esp_err_t matter_bridge_update_media_state(matter_bridge_device_kind_t kind, bool playing, uint8_t volume_percent)
+{
+    ESP_RETURN_ON_FALSE(s_initialized, ESP_ERR_INVALID_STATE, TAG, "Bridge not initialized");
+
+    if (xSemaphoreTake(s_registry_lock, pdMS_TO_TICKS(10)) != pdTRUE) {
+        return ESP_ERR_TIMEOUT;
+    }
+    matter_bridge_device_entry_t *entry = matter_bridge_find_device(kind);
+    if (!entry) {
+        xSemaphoreGive(s_registry_lock);
+        return ESP_ERR_NOT_FOUND;
+    }
+    if (volume_percent > 100) {
+        volume_percent = 100;
+    }
+    matter_bridge_attr_set(&entry->attrs, MATTER_BRIDGE_ATTR_PLAYBACK_STATE,
+                           playing ? MATTER_BRIDGE_PLAYBACK_PLAYING : MATTER_BRIDGE_PLAYBACK_PAUSED);
+    matter_bridge_attr_set(&entry->attrs, MATTER_BRIDGE_ATTR_VOLUME, (volume_percent * 254 + 50) / 100);
+    xSemaphoreGive(s_registry_lock);
+    return ESP_OK;
+}
+
 esp_err_t matter_bridge_spotify_play(void *context)
 {
     ESP_LOGI(TAG, "Matter: Spotify Play command");
@@ -0,0 +1,278 @@
+#include "matter_bridge_priv.h"
+
+#include <inttypes.h>
+#include <string.h>
+
+#include "esp_check.h"
+#include "esp_log.h"
+#include "esp_matter.h"
+#include "sdkconfig.h"
+
+#if CONFIG_ENABLE_CHIP_SHELL
+#include "esp_matter_console.h"
+#endif
+
+using namespace esp_matter;
+using namespace esp_matter::endpoint;
+using namespace chip::app::Clusters;
+
+static const char *TAG = "matter_bridge";
+
+static node_t *s_node;
+static endpoint_t *s_aggregator;
+static bool s_matter_started;
+// Set while the bridge writes its own reports so the callback below does not
+// echo them back to the player
+static bool s_reporting;
+
+static esp_err_t matter_bridge_attribute_cb(attribute::callback_type_t type,
+                                            uint16_t endpoint_id,
+                                            uint32_t cluster_id,
+                                            uint32_t attribute_id,
+                                            esp_matter_attr_val_t *val,
+                                            void *priv_data)
+{
+    (void)endpoint_id;
+    // Only media endpoints carry a device handle
+    if (type != attribute::PRE_UPDATE || !priv_data || s_reporting) {
+        return ESP_OK;
+    }
+    if (cluster_id == OnOff::Id && attribute_id == OnOff::Attributes::OnOff::Id) {
+        return val->val.b ? matter_bridge_spotify_resume(priv_data) : matter_bridge_spotify_pause(priv_data);
+    }
+    if (cluster_id == LevelControl::Id && attribute_id == LevelControl::Attributes::CurrentLevel::Id) {
+        return matter_bridge_spotify_volume_set(priv_data, (uint8_t)((val->val.u8 * 100 + 127) / 254));
+    }
+    return ESP_OK;
+}
+
+static bool matter_bridge_lock(void)
+{
+    // Already held when called back from the Matter task
+    return lock::chip_stack_lock(portMAX_DELAY) == lock::SUCCESS;
+}
+
+static void matter_bridge_unlock(bool locked)
+{
+    if (locked) {
+        lock::chip_stack_unlock();
+    }
+}
+
+static endpoint_t *matter_bridge_create_bridged(const char *label, void *priv_data)
+{
+    bridged_node::config_t bridged_config;
+    endpoint_t *endpoint = bridged_node::create(s_node, &bridged_config,
+                                                ENDPOINT_FLAG_DESTROYABLE | ENDPOINT_FLAG_BRIDGE, priv_data);
+    if (!endpoint) {
+        return NULL;
+    }
+    if (label && label[0]) {
+        cluster_t *basic = cluster::get(endpoint, BridgedDeviceBasicInformation::Id);
+        cluster::bridged_device_basic_information::attribute::create_node_label(basic, const_cast<char *>(label),
+                                                                               strlen(label));
+    }
+    set_parent_endpoint(endpoint, s_aggregator);
+    return endpoint;
+}
+
+static esp_err_t matter_bridge_finish_endpoint(endpoint_t *endpoint, esp_err_t err, uint16_t *endpoint_id)
+{
+    if (err == ESP_OK && s_matter_started) {
+        // Endpoints added after esp_matter::start() stay hidden until enabled
+        err = endpoint::enable(endpoint);
+    }
+    if (err != ESP_OK) {
+        endpoint::destroy(s_node, endpoint);
+        return err;
+    }
+    *endpoint_id = endpoint::get_id(endpoint);
+    return ESP_OK;
+}
+
+extern "C" esp_err_t matter_bridge_endpoints_start(bool enable_console)
+{
+    if (s_node) {
+        return ESP_OK;
+    }
+
+    node::config_t node_config;
+    s_node = node::create(&node_config, matter_bridge_attribute_cb, NULL);
+    ESP_RETURN_ON_FALSE(s_node, ESP_FAIL, TAG, "Failed to create Matter node");
+
+    aggregator::config_t aggregator_config;
+    s_aggregator = aggregator::create(s_node, &aggregator_config, ENDPOINT_FLAG_NONE, NULL);
+    ESP_RETURN_ON_FALSE(s_aggregator, ESP_FAIL, TAG, "Failed to create aggregator endpoint");
+
+    ESP_RETURN_ON_ERROR(esp_matter::start(NULL), TAG, "Failed to start Matter stack");
+    s_matter_started = true;
+
+#if CONFIG_ENABLE_CHIP_SHELL
+    if (enable_console) {
+        console::diagnostics_register_commands();
+        console::init();
+    }
+#else
+    (void)enable_console;
+#endif
+    return ESP_OK;
+}
+
+extern "C" esp_err_t matter_bridge_endpoints_add_sensor(matter_bridge_sensor_kind_t kind,
+                                                        const char *label,
+                                                        uint16_t *endpoint_id)
+{
+    ESP_RETURN_ON_FALSE(s_node && endpoint_id, ESP_ERR_INVALID_STATE, TAG, "Matter node not created");
+    if (kind == MATTER_BRIDGE_SENSOR_KIND_GENERIC) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    bool locked = matter_bridge_lock();
+    endpoint_t *endpoint = matter_bridge_create_bridged(label, NULL);
+    if (!endpoint) {
+        matter_bridge_unlock(locked);
+        return ESP_ERR_NO_MEM;
+    }
+
+    esp_err_t err = ESP_OK;
+    switch (kind) {
+    case MATTER_BRIDGE_SENSOR_KIND_ENVIRONMENT: {
+        temperature_sensor::config_t temperature_config;
+        humidity_sensor::config_t humidity_config;
+        err = temperature_sensor::add(endpoint, &temperature_config);
+        if (err == ESP_OK) {
+            err = humidity_sensor::add(endpoint, &humidity_config);
+        }
+        break;
+    }
+    case MATTER_BRIDGE_SENSOR_KIND_IAQ:
+    case MATTER_BRIDGE_SENSOR_KIND_PM: {
+        air_quality_sensor::config_t air_quality_config;
+        err = air_quality_sensor::add(endpoint, &air_quality_config);
+        if (err == ESP_OK && kind == MATTER_BRIDGE_SENSOR_KIND_IAQ) {
+            namespace co2 = cluster::carbon_dioxide_concentration_measurement;
+            co2::config_t co2_config;
+            cluster_t *co2_cluster = co2::create(endpoint, &co2_config, CLUSTER_FLAG_SERVER);
+            co2::feature::numeric_measurement::config_t numeric_config;
+            err = co2_cluster ? co2::feature::numeric_measurement::add(co2_cluster, &numeric_config) : ESP_ERR_NO_MEM;
+        }
+        break;
+    }
+    case MATTER_BRIDGE_SENSOR_KIND_LIGHT: {
+        light_sensor::config_t light_config;
+        err = light_sensor::add(endpoint, &light_config);
+        break;
+    }
+    default:
+        err = ESP_ERR_NOT_SUPPORTED;
+        break;
+    }
+
+    err = matter_bridge_finish_endpoint(endpoint, err, endpoint_id);
+    matter_bridge_unlock(locked);
+    return err;
+}
+
+extern "C" esp_err_t matter_bridge_endpoints_add_device(matter_bridge_device_kind_t kind,
+                                                        const char *label,
+                                                        void *device_handle,
+                                                        uint16_t *endpoint_id)
+{
+    ESP_RETURN_ON_FALSE(s_node && endpoint_id, ESP_ERR_INVALID_STATE, TAG, "Matter node not created");
+    ESP_RETURN_ON_FALSE(kind == MATTER_BRIDGE_DEVICE_KIND_SPOTIFY, ESP_ERR_NOT_SUPPORTED, TAG,
+                        "Unsupported device kind %d", kind);
+
+    bool locked = matter_bridge_lock();
+    // The device handle rides along as endpoint private data for the attribute callback
+    endpoint_t *endpoint = matter_bridge_create_bridged(label, device_handle);
+    if (!endpoint) {
+        matter_bridge_unlock(locked);
+        return ESP_ERR_NO_MEM;
+    }
+
+    // Speaker gives On/Off (play/pause) and Level Control (volume); Media
+    // Playback carries CurrentState for controllers that show it
+    speaker::config_t speaker_config;
+    esp_err_t err = speaker::add(endpoint, &speaker_config);
+    if (err == ESP_OK) {
+        cluster::media_playback::config_t playback_config;
+        if (!cluster::media_playback::create(endpoint, &playback_config, CLUSTER_FLAG_SERVER)) {
+            err = ESP_ERR_NO_MEM;
+        }
+    }
+
+    err = matter_bridge_finish_endpoint(endpoint, err, endpoint_id);
+    matter_bridge_unlock(locked);
+    return err;
+}
+
+extern "C" esp_err_t matter_bridge_endpoints_report(const matter_bridge_report_t *reports, size_t count)
+{
+    ESP_RETURN_ON_FALSE(s_matter_started, ESP_ERR_INVALID_STATE, TAG, "Matter stack not started");
+
+    // One lock for the whole batch; the stack coalesces the resulting reports
+    // per subscription
+    bool locked = matter_bridge_lock();
+    s_reporting = true;
+    esp_err_t result = ESP_OK;
+    for (size_t i = 0; i < count; ++i) {
+        const matter_bridge_report_t *report = &reports[i];
+        uint32_t cluster_id;
+        uint32_t attribute_id;
+        esp_matter_attr_val_t val;
+
+        switch (report->attr) {
+        case MATTER_BRIDGE_ATTR_TEMPERATURE:
+            cluster_id = TemperatureMeasurement::Id;
+            attribute_id = TemperatureMeasurement::Attributes::MeasuredValue::Id;
+            val = esp_matter_nullable_int16((int16_t)report->value);
+            break;
+        case MATTER_BRIDGE_ATTR_HUMIDITY:
+            cluster_id = RelativeHumidityMeasurement::Id;
+            attribute_id = RelativeHumidityMeasurement::Attributes::MeasuredValue::Id;
+            val = esp_matter_nullable_uint16((uint16_t)report->value);
+            break;
+        case MATTER_BRIDGE_ATTR_CO2:
+            cluster_id = CarbonDioxideConcentrationMeasurement::Id;
+            attribute_id = CarbonDioxideConcentrationMeasurement::Attributes::MeasuredValue::Id;
+            val = esp_matter_nullable_float((float)report->value);
+            break;
+        case MATTER_BRIDGE_ATTR_AIR_QUALITY:
+            cluster_id = AirQuality::Id;
+            attribute_id = AirQuality::Attributes::AirQuality::Id;
+            val = esp_matter_enum8((uint8_t)report->value);
+            break;
+        case MATTER_BRIDGE_ATTR_ILLUMINANCE:
+            cluster_id = IlluminanceMeasurement::Id;
+            attribute_id = IlluminanceMeasurement::Attributes::MeasuredValue::Id;
+            val = esp_matter_nullable_uint16((uint16_t)report->value);
+            break;
+        case MATTER_BRIDGE_ATTR_PLAYBACK_STATE: {
+            // Keep On/Off in step so play/pause toggles reflect the player
+            esp_matter_attr_val_t on = esp_matter_bool(report->value == 0);
+            attribute::update(report->endpoint_id, OnOff::Id, OnOff::Attributes::OnOff::Id, &on);
+            cluster_id = MediaPlayback::Id;
+            attribute_id = MediaPlayback::Attributes::CurrentState::Id;
+            val = esp_matter_enum8((uint8_t)report->value);
+            break;
+        }
+        case MATTER_BRIDGE_ATTR_VOLUME:
+            cluster_id = LevelControl::Id;
+            attribute_id = LevelControl::Attributes::CurrentLevel::Id;
+            val = esp_matter_nullable_uint8((uint8_t)report->value);
+            break;
+        default:
+            continue;
+        }
+
+        esp_err_t err = attribute::update(report->endpoint_id, cluster_id, attribute_id, &val);
+        if (err != ESP_OK) {
+            ESP_LOGW(TAG, "Endpoint %u cluster 0x%04" PRIx32 " update failed: %s", report->endpoint_id, cluster_id,
+                     esp_err_to_name(err));
+            result = err;
+        }
+    }
+    s_reporting = false;
+    matter_bridge_unlock(locked);
+    return result;
+}
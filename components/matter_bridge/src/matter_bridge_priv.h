@@ -0,0 +1,56 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "matter_bridge.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MATTER_BRIDGE_ENDPOINT_NONE 0xFFFF
+
+/**
+ * Attributes the bridge reports. Values are kept in the cluster's own units so
+ * the endpoint layer only has to pick the attribute and its type.
+ */
+typedef enum {
+    MATTER_BRIDGE_ATTR_TEMPERATURE = 0, ///< 0x0402 MeasuredValue, 0.01 degC
+    MATTER_BRIDGE_ATTR_HUMIDITY,        ///< 0x0405 MeasuredValue, 0.01 %RH
+    MATTER_BRIDGE_ATTR_CO2,             ///< 0x040D MeasuredValue, ppm
+    MATTER_BRIDGE_ATTR_AIR_QUALITY,     ///< 0x005B AirQuality, AirQualityEnum
+    MATTER_BRIDGE_ATTR_ILLUMINANCE,     ///< 0x0400 MeasuredValue, 10000*log10(lux)+1
+    MATTER_BRIDGE_ATTR_PLAYBACK_STATE,  ///< 0x0506 CurrentState, PlaybackStateEnum
+    MATTER_BRIDGE_ATTR_VOLUME,          ///< 0x0008 CurrentLevel, 0-254
+    MATTER_BRIDGE_ATTR_COUNT,
+} matter_bridge_attr_t;
+
+typedef struct {
+    uint16_t endpoint_id;
+    matter_bridge_attr_t attr;
+    int32_t value;
+    const char *owner; ///< Sensor or device label, for logging only
+} matter_bridge_report_t;
+
+/*
+ * Endpoint layer, implemented against esp-matter in matter_bridge_esp_matter.cpp
+ * when CONFIG_NAPHOME_MATTER_BRIDGE_USE_ESPMATTER is set. Endpoint creation runs
+ * under the registry lock, so nothing here (including the Matter attribute
+ * callback) may take that lock.
+ */
+esp_err_t matter_bridge_endpoints_start(bool enable_console);
+esp_err_t matter_bridge_endpoints_add_sensor(matter_bridge_sensor_kind_t kind,
+                                             const char *label,
+                                             uint16_t *endpoint_id);
+esp_err_t matter_bridge_endpoints_add_device(matter_bridge_device_kind_t kind,
+                                             const char *label,
+                                             void *device_handle,
+                                             uint16_t *endpoint_id);
+esp_err_t matter_bridge_endpoints_report(const matter_bridge_report_t *reports, size_t count);
+
+#ifdef __cplusplus
+}
+#endif
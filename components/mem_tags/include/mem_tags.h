@@ -0,0 +1,75 @@
+/**
+ * @file mem_tags.h
+ * @brief Per-subsystem heap accounting through allocation wrapper macros.
+ *
+ * Subsystems allocate through MEM_TAG_MALLOC() and friends with their tag;
+ * with CONFIG_MEM_TAGS_ENABLE the wrappers keep live and peak bytes per
+ * tag, otherwise they compile to the plain allocator calls. A block must be
+ * freed (or reallocated) with the tag it was allocated under.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "esp_heap_caps.h"
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    MEM_TAG_VOICE_PIPELINE,
+    MEM_TAG_OPENAI,
+    MEM_TAG_GEMINI,
+    MEM_TAG_CSPOT,
+    MEM_TAG_BLE,
+    MEM_TAG_MQTT,
+    MEM_TAG_COUNT,
+} mem_tag_t;
+
+typedef struct {
+    size_t live_bytes;
+    size_t peak_bytes;
+    uint32_t live_blocks;
+    uint32_t failures;                // Allocations that returned NULL
+} mem_tag_stats_t;
+
+// "voice_pipeline", "openai", ...; NULL past the end
+const char *mem_tags_name(mem_tag_t tag);
+
+// Zeroed when tagging is disabled
+void mem_tags_get(mem_tag_t tag, mem_tag_stats_t *out);
+
+/**
+ * Account memory a subsystem draws through an allocator the macros can't
+ * wrap (a component's operator new, say): positive to charge, negative to
+ * release. Peak and live bytes move as for a tagged allocation.
+ */
+void mem_tags_charge(mem_tag_t tag, int32_t bytes);
+
+void *mem_tags_caps_malloc(mem_tag_t tag, size_t size, uint32_t caps);
+void *mem_tags_calloc(mem_tag_t tag, size_t n, size_t size);
+void *mem_tags_realloc(mem_tag_t tag, void *ptr, size_t size);
+void mem_tags_free(mem_tag_t tag, void *ptr);
+
+#if CONFIG_MEM_TAGS_ENABLE
+#define MEM_TAG_MALLOC(tag, size) mem_tags_caps_malloc((tag), (size), MALLOC_CAP_DEFAULT)
+#define MEM_TAG_CAPS_MALLOC(tag, size, caps) mem_tags_caps_malloc((tag), (size), (caps))
+#define MEM_TAG_CALLOC(tag, n, size) mem_tags_calloc((tag), (n), (size))
+#define MEM_TAG_REALLOC(tag, ptr, size) mem_tags_realloc((tag), (ptr), (size))
+#define MEM_TAG_FREE(tag, ptr) mem_tags_free((tag), (ptr))
+#else
+#define MEM_TAG_MALLOC(tag, size) malloc(size)
+#define MEM_TAG_CAPS_MALLOC(tag, size, caps) heap_caps_malloc((size), (caps))
+#define MEM_TAG_CALLOC(tag, n, size) calloc((n), (size))
+#define MEM_TAG_REALLOC(tag, ptr, size) realloc((ptr), (size))
+#define MEM_TAG_FREE(tag, ptr) free(ptr)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
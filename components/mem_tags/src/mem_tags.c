@@ -0,0 +1,129 @@
+/**
+ * @file mem_tags.c
+ */
+
+#include "mem_tags.h"
+
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+
+static const char *const TAG_NAMES[MEM_TAG_COUNT] = {
+    [MEM_TAG_VOICE_PIPELINE] = "voice_pipeline",
+    [MEM_TAG_OPENAI] = "openai",
+    [MEM_TAG_GEMINI] = "gemini",
+    [MEM_TAG_CSPOT] = "cspot",
+    [MEM_TAG_BLE] = "ble",
+    [MEM_TAG_MQTT] = "mqtt",
+};
+
+static mem_tag_stats_t s_stats[MEM_TAG_COUNT];
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+const char *mem_tags_name(mem_tag_t tag)
+{
+    return tag < MEM_TAG_COUNT ? TAG_NAMES[tag] : NULL;
+}
+
+void mem_tags_get(mem_tag_t tag, mem_tag_stats_t *out)
+{
+    if (!out) {
+        return;
+    }
+    if (tag >= MEM_TAG_COUNT) {
+        memset(out, 0, sizeof(*out));
+        return;
+    }
+    portENTER_CRITICAL(&s_lock);
+    *out = s_stats[tag];
+    portEXIT_CRITICAL(&s_lock);
+}
+
+// bytes < 0 releases; blocks is +1, -1 or 0
+static void account(mem_tag_t tag, int32_t bytes, int blocks)
+{
+    if (tag >= MEM_TAG_COUNT) {
+        return;
+    }
+    portENTER_CRITICAL(&s_lock);
+    mem_tag_stats_t *s = &s_stats[tag];
+    if (bytes >= 0) {
+        s->live_bytes += (size_t)bytes;
+        if (s->live_bytes > s->peak_bytes) {
+            s->peak_bytes = s->live_bytes;
+        }
+    } else {
+        size_t release = (size_t)(-(int64_t)bytes);
+        s->live_bytes = release > s->live_bytes ? 0 : s->live_bytes - release;
+    }
+    if (blocks > 0) {
+        s->live_blocks++;
+    } else if (blocks < 0 && s->live_blocks > 0) {
+        s->live_blocks--;
+    }
+    portEXIT_CRITICAL(&s_lock);
+}
+
+static void note_failure(mem_tag_t tag)
+{
+    if (tag >= MEM_TAG_COUNT) {
+        return;
+    }
+    portENTER_CRITICAL(&s_lock);
+    s_stats[tag].failures++;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+void mem_tags_charge(mem_tag_t tag, int32_t bytes)
+{
+    account(tag, bytes, 0);
+}
+
+// Counted at the heap's block size, so padding shows up where it is spent
+void *mem_tags_caps_malloc(mem_tag_t tag, size_t size, uint32_t caps)
+{
+    void *ptr = heap_caps_malloc(size, caps);
+    if (!ptr) {
+        note_failure(tag);
+        return NULL;
+    }
+    account(tag, (int32_t)heap_caps_get_allocated_size(ptr), 1);
+    return ptr;
+}
+
+void *mem_tags_calloc(mem_tag_t tag, size_t n, size_t size)
+{
+    void *ptr = calloc(n, size);
+    if (!ptr) {
+        note_failure(tag);
+        return NULL;
+    }
+    account(tag, (int32_t)heap_caps_get_allocated_size(ptr), 1);
+    return ptr;
+}
+
+void *mem_tags_realloc(mem_tag_t tag, void *ptr, size_t size)
+{
+    size_t old_size = ptr ? heap_caps_get_allocated_size(ptr) : 0;
+    void *grown = realloc(ptr, size);
+    if (!grown) {
+        if (size > 0) {
+            note_failure(tag);
+            return NULL;
+        }
+        // realloc(ptr, 0) freed the block
+        account(tag, -(int32_t)old_size, ptr ? -1 : 0);
+        return NULL;
+    }
+    account(tag, (int32_t)heap_caps_get_allocated_size(grown) - (int32_t)old_size, ptr ? 0 : 1);
+    return grown;
+}
+
+void mem_tags_free(mem_tag_t tag, void *ptr)
+{
+    if (!ptr) {
+        return;
+    }
+    account(tag, -(int32_t)heap_caps_get_allocated_size(ptr), -1);
+    free(ptr);
+}
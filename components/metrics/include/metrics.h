@@ -0,0 +1,150 @@
+/**
+ * @file metrics.h
+ * @brief Named counters, gauges and latency histograms for telemetry.
+ *
+ * Metrics are registered by name, usually once at init, and recorded from
+ * any task without locks: counters and histograms keep one slot per core,
+ * updated with a relaxed atomic add, and the reader sums the slots. Nothing
+ * can be unregistered and names must outlive the registry (string literals).
+ *
+ * Registering the same name and type again returns the same metric, so a
+ * subsystem can also count in one line with METRICS_COUNT().
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "freertos/FreeRTOS.h"
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define METRICS_CORES portNUM_PROCESSORS
+
+/**
+ * Bucket 0 counts samples under the histogram's base, bucket i samples
+ * under base << i, and the last bucket everything slower.
+ */
+#define METRICS_HISTOGRAM_BUCKETS 12
+
+typedef enum {
+    METRICS_TYPE_COUNTER,
+    METRICS_TYPE_GAUGE,
+    METRICS_TYPE_HISTOGRAM,
+} metrics_type_t;
+
+typedef struct {
+    uint32_t per_core[METRICS_CORES];
+} metrics_counter_t;
+
+typedef struct {
+    int32_t value;
+    bool set;                         // False until the first metrics_gauge_set()
+} metrics_gauge_t;
+
+typedef struct {
+    uint32_t base_us;
+    uint32_t max_us[METRICS_CORES];
+    uint32_t buckets[METRICS_CORES][METRICS_HISTOGRAM_BUCKETS];
+} metrics_histogram_t;
+
+/**
+ * @brief Summed view of one metric, filled by metrics_read()
+ */
+typedef struct {
+    const char *name;
+    metrics_type_t type;
+    union {
+        uint32_t count;               ///< COUNTER
+        struct {
+            int32_t value;
+            bool set;
+        } gauge;                      ///< GAUGE
+        struct {
+            uint32_t base_us;
+            uint32_t count;
+            uint32_t max_us;
+            uint32_t buckets[METRICS_HISTOGRAM_BUCKETS];
+        } histogram;                  ///< HISTOGRAM
+    };
+} metrics_value_t;
+
+/**
+ * @brief Register a counter, or find the one already registered under name
+ *
+ * @return NULL when the pool (CONFIG_METRICS_MAX_COUNTERS) is full or the
+ *         name is taken by another type
+ */
+metrics_counter_t *metrics_counter(const char *name);
+metrics_gauge_t *metrics_gauge(const char *name);
+
+/**
+ * @param base_us Upper edge of the first bucket; each bucket doubles it.
+ *                Ignored when the histogram already exists.
+ */
+metrics_histogram_t *metrics_histogram(const char *name, uint32_t base_us);
+
+/**
+ * @brief Number of registered metrics; indices below it stay valid
+ */
+size_t metrics_count(void);
+
+/**
+ * @brief Sum metric index across cores
+ *
+ * Lock-free: a sample recorded during the read may or may not be included.
+ *
+ * @return false if index is out of range
+ */
+bool metrics_read(size_t index, metrics_value_t *out);
+
+/**
+ * @brief Latency below which pct percent of the samples fell
+ *
+ * Resolved to the buckets: the upper edge of the bucket holding the
+ * percentile, or the histogram's max for the open last bucket.
+ *
+ * @return Microseconds, 0 without samples
+ */
+uint32_t metrics_histogram_percentile_us(const metrics_value_t *value, float pct);
+
+static inline void metrics_counter_add(metrics_counter_t *counter, uint32_t n)
+{
+    if (counter) {
+        // A task moved to the other core meanwhile still adds atomically
+        __atomic_fetch_add(&counter->per_core[xPortGetCoreID()], n, __ATOMIC_RELAXED);
+    }
+}
+
+static inline void metrics_gauge_set(metrics_gauge_t *gauge, int32_t value)
+{
+    if (gauge) {
+        __atomic_store_n(&gauge->value, value, __ATOMIC_RELAXED);
+        __atomic_store_n(&gauge->set, true, __ATOMIC_RELEASE);
+    }
+}
+
+void metrics_histogram_record_us(metrics_histogram_t *histogram, uint32_t us);
+
+/**
+ * @brief Count into the counter called name, registering it on first use
+ *
+ * The lookup runs once per call site; after that this is one atomic add.
+ */
+#define METRICS_COUNT(name, n)                                                      \
+    do {                                                                            \
+        static metrics_counter_t *metrics_count_site_;                              \
+        if (!metrics_count_site_) {                                                 \
+            metrics_count_site_ = metrics_counter(name);                            \
+        }                                                                           \
+        metrics_counter_add(metrics_count_site_, (n));                              \
+    } while (0)
+
+#ifdef __cplusplus
+}
+#endif
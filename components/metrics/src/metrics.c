@@ -0,0 +1,180 @@
+/**
+ * @file metrics.c
+ */
+
+#include "metrics.h"
+
+#include <string.h>
+
+#include "esp_attr.h"
+
+#define METRICS_MAX_ENTRIES (CONFIG_METRICS_MAX_COUNTERS + CONFIG_METRICS_MAX_GAUGES + CONFIG_METRICS_MAX_HISTOGRAMS)
+
+typedef struct {
+    const char *name;
+    metrics_type_t type;
+    void *metric;
+} metrics_entry_t;
+
+static metrics_counter_t s_counters[CONFIG_METRICS_MAX_COUNTERS];
+static metrics_gauge_t s_gauges[CONFIG_METRICS_MAX_GAUGES];
+static metrics_histogram_t s_histograms[CONFIG_METRICS_MAX_HISTOGRAMS];
+static size_t s_used[3];              // Per type, under s_lock
+
+// Entries are filled in before s_count is raised, so readers never lock
+static metrics_entry_t s_entries[METRICS_MAX_ENTRIES];
+static size_t s_count;
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static void *metrics_register(const char *name, metrics_type_t type, uint32_t base_us)
+{
+    if (!name) {
+        return NULL;
+    }
+    void *metric = NULL;
+    portENTER_CRITICAL(&s_lock);
+    for (size_t i = 0; i < s_count; ++i) {
+        if (strcmp(s_entries[i].name, name) == 0) {
+            metric = s_entries[i].type == type ? s_entries[i].metric : NULL;
+            portEXIT_CRITICAL(&s_lock);
+            return metric;
+        }
+    }
+    switch (type) {
+    case METRICS_TYPE_COUNTER:
+        if (s_used[type] < CONFIG_METRICS_MAX_COUNTERS) {
+            metric = &s_counters[s_used[type]++];
+        }
+        break;
+    case METRICS_TYPE_GAUGE:
+        if (s_used[type] < CONFIG_METRICS_MAX_GAUGES) {
+            metric = &s_gauges[s_used[type]++];
+        }
+        break;
+    case METRICS_TYPE_HISTOGRAM:
+        if (s_used[type] < CONFIG_METRICS_MAX_HISTOGRAMS) {
+            metrics_histogram_t *histogram = &s_histograms[s_used[type]++];
+            // The last edge, base << (BUCKETS - 1), has to fit in 32 bits
+            const uint32_t limit = UINT32_MAX >> (METRICS_HISTOGRAM_BUCKETS - 1);
+            histogram->base_us = base_us == 0 ? 1 : (base_us > limit ? limit : base_us);
+            metric = histogram;
+        }
+        break;
+    }
+    if (metric) {
+        s_entries[s_count] = (metrics_entry_t){
+            .name = name,
+            .type = type,
+            .metric = metric,
+        };
+        __atomic_store_n(&s_count, s_count + 1, __ATOMIC_RELEASE);
+    }
+    portEXIT_CRITICAL(&s_lock);
+    return metric;
+}
+
+metrics_counter_t *metrics_counter(const char *name)
+{
+    return metrics_register(name, METRICS_TYPE_COUNTER, 0);
+}
+
+metrics_gauge_t *metrics_gauge(const char *name)
+{
+    return metrics_register(name, METRICS_TYPE_GAUGE, 0);
+}
+
+metrics_histogram_t *metrics_histogram(const char *name, uint32_t base_us)
+{
+    return metrics_register(name, METRICS_TYPE_HISTOGRAM, base_us);
+}
+
+// In IRAM: recorded from interrupts that keep running while the flash cache is off
+void IRAM_ATTR metrics_histogram_record_us(metrics_histogram_t *histogram, uint32_t us)
+{
+    if (!histogram) {
+        return;
+    }
+    size_t bucket = 0;
+    uint32_t edge = histogram->base_us;
+    while (bucket < METRICS_HISTOGRAM_BUCKETS - 1 && us >= edge) {
+        bucket++;
+        edge <<= 1;
+    }
+    int core = xPortGetCoreID();
+    __atomic_fetch_add(&histogram->buckets[core][bucket], 1, __ATOMIC_RELAXED);
+
+    uint32_t max = __atomic_load_n(&histogram->max_us[core], __ATOMIC_RELAXED);
+    while (us > max &&
+           !__atomic_compare_exchange_n(&histogram->max_us[core], &max, us, true, __ATOMIC_RELAXED,
+                                        __ATOMIC_RELAXED)) {
+    }
+}
+
+size_t metrics_count(void)
+{
+    return __atomic_load_n(&s_count, __ATOMIC_ACQUIRE);
+}
+
+bool metrics_read(size_t index, metrics_value_t *out)
+{
+    if (!out || index >= metrics_count()) {
+        return false;
+    }
+    const metrics_entry_t *entry = &s_entries[index];
+    memset(out, 0, sizeof(*out));
+    out->name = entry->name;
+    out->type = entry->type;
+
+    switch (entry->type) {
+    case METRICS_TYPE_COUNTER: {
+        const metrics_counter_t *counter = entry->metric;
+        for (int core = 0; core < METRICS_CORES; ++core) {
+            out->count += __atomic_load_n(&counter->per_core[core], __ATOMIC_RELAXED);
+        }
+        break;
+    }
+    case METRICS_TYPE_GAUGE: {
+        metrics_gauge_t *gauge = entry->metric;
+        out->gauge.set = __atomic_load_n(&gauge->set, __ATOMIC_ACQUIRE);
+        out->gauge.value = __atomic_load_n(&gauge->value, __ATOMIC_RELAXED);
+        break;
+    }
+    case METRICS_TYPE_HISTOGRAM: {
+        metrics_histogram_t *histogram = entry->metric;
+        out->histogram.base_us = histogram->base_us;
+        for (int core = 0; core < METRICS_CORES; ++core) {
+            uint32_t max = __atomic_load_n(&histogram->max_us[core], __ATOMIC_RELAXED);
+            if (max > out->histogram.max_us) {
+                out->histogram.max_us = max;
+            }
+            for (int b = 0; b < METRICS_HISTOGRAM_BUCKETS; ++b) {
+                uint32_t n = __atomic_load_n(&histogram->buckets[core][b], __ATOMIC_RELAXED);
+                out->histogram.buckets[b] += n;
+                out->histogram.count += n;
+            }
+        }
+        break;
+    }
+    }
+    return true;
+}
+
+uint32_t metrics_histogram_percentile_us(const metrics_value_t *value, float pct)
+{
+    if (!value || value->type != METRICS_TYPE_HISTOGRAM || value->histogram.count == 0) {
+        return 0;
+    }
+    uint64_t target = (uint64_t)((double)value->histogram.count * pct / 100.0 + 0.5);
+    if (target == 0) {
+        target = 1;
+    }
+    uint64_t seen = 0;
+    uint32_t edge = value->histogram.base_us;
+    for (int b = 0; b < METRICS_HISTOGRAM_BUCKETS - 1; ++b, edge <<= 1) {
+        seen += value->histogram.buckets[b];
+        if (seen >= target) {
+            return edge < value->histogram.max_us ? edge : value->histogram.max_us;
+        }
+    }
+    return value->histogram.max_us;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Direction of arrival from a two-mic pair by GCC-PHAT. Each 16 ms window
+ * of interleaved stereo goes through one complex FFT on the frontend's
+ * engine (left as real, right as imaginary), the phase-only cross-spectrum
+ * is accumulated while speech is flagged, and its steered response over a
+ * grid of angles gives the bearing. A pair cannot tell front from back, so
+ * angles run -90 (toward channel 0) through 0 (broadside) to +90 (toward
+ * channel 1). Audio and speech flags come from one task; any task may read.
+ */
+
+/** Samples per channel in each analysis window; consecutive windows overlap by half */
+#define AUDIO_DOA_WINDOW 256
+
+typedef struct {
+    uint32_t sample_rate;   ///< Hz (default 16000)
+    uint16_t mic_spacing_mm;///< Between the two captured mics (default 65)
+    uint16_t smoothing_ms;  ///< Time constant of the running angle during speech (default 300)
+} audio_doa_config_t;
+
+typedef struct {
+    float angle_deg;            ///< Running estimate over the current utterance's recent speech
+    float confidence;           ///< 0-1: share of the pair's phase agreeing with angle_deg
+    bool active;                ///< In speech and angle_deg is current
+    float utterance_deg;        ///< Over the whole of the last finished utterance
+    float utterance_confidence;
+    uint32_t utterances;        ///< Finished utterances; a change means utterance_deg is new
+} audio_doa_estimate_t;
+
+typedef struct audio_doa audio_doa_t;
+
+/**
+ * @brief Allocate an estimator; NULL config takes the defaults
+ *
+ * Also sets up the shared FFT (audio_features_fft_init()), so create it
+ * from setup code.
+ */
+audio_doa_t *audio_doa_create(const audio_doa_config_t *config);
+void audio_doa_destroy(audio_doa_t *doa);
+
+/**
+ * @brief Feed interleaved stereo; partial windows carry over to the next call
+ *
+ * Outside speech the windows are buffered but not transformed, so the cost
+ * while idle is a copy.
+ *
+ * @param samples Sample count, not frames
+ */
+void audio_doa_push(audio_doa_t *doa, const int16_t *stereo, size_t samples);
+
+/**
+ * @brief Mark speech onset or end, e.g. from the VAD
+ *
+ * An onset starts a new utterance; an end publishes its angle when it
+ * held enough speech.
+ *
+ * @return true when this call published a new utterance angle
+ */
+bool audio_doa_set_speech(audio_doa_t *doa, bool in_speech);
+
+void audio_doa_read(audio_doa_t *doa, audio_doa_estimate_t *out);
+
+#ifdef __cplusplus
+}
+#endif
@@ -3,15 +3,137 @@
 #include <stdint.h>
 #include <stddef.h>
 #include "esp_err.h"
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Number of mel bands per spectrogram row */
+#ifdef CONFIG_OPENWAKEWORD_N_MELS
+#define AUDIO_FEATURES_N_MELS CONFIG_OPENWAKEWORD_N_MELS
+#else
+#define AUDIO_FEATURES_N_MELS 40
+#endif
+
+/** Samples between consecutive mel rows (10 ms at 16 kHz) */
+#define AUDIO_FEATURES_HOP_LENGTH 160
+
+/** Rows kept in the rolling spectrogram window (matches openWakeWord's 76-frame embedding window) */
+#define AUDIO_FEATURES_WINDOW_FRAMES 76
 
 typedef struct audio_features audio_features_t;
 
+/** Called on the pushing task with each new mel row (AUDIO_FEATURES_N_MELS floats) */
+typedef void (*audio_features_row_cb_t)(const float *mel_row, void *ctx);
+
+/**
+ * @brief Create a mel frontend
+ *
+ * @return Handle, or NULL when out of memory or when the fixed-point FFT mode
+ *         cannot set up ESP-DSP's sc16 kernel
+ */
 audio_features_t *audio_features_init(uint32_t sample_rate);
 
+/**
+ * @brief Compute a single mel row from the first N_FFT samples of a buffer
+ *
+ * Stateless one-shot helper; samples beyond N_FFT are ignored. Use
+ * audio_features_stream_push() for continuous audio.
+ */
 esp_err_t audio_features_extract_melspectrogram(audio_features_t *features,
                                                   const int16_t *audio_samples,
                                                   size_t sample_count,
                                                   float *melspectrogram_out,
                                                   size_t *melspectrogram_size_out);
 
-void audio_features_deinit(audio_features_t *features);
\ No newline at end of file
+/**
+ * @brief Push audio into the streaming extractor
+ *
+ * Samples are appended to an internal overlap ring. Every time a full hop of
+ * new audio is available, one mel row is computed over the last N_FFT samples
+ * and appended to the rolling spectrogram window. Any partial hop is carried
+ * over to the next call, so chunk sizes need not be a multiple of the hop.
+ *
+ * @param features Extractor handle
+ * @param audio_samples 16-bit PCM samples
+ * @param sample_count Number of samples
+ * @param rows_emitted_out Optional, number of new mel rows produced by this call
+ * @return ESP_OK on success
+ */
+esp_err_t audio_features_stream_push(audio_features_t *features,
+                                     const int16_t *audio_samples,
+                                     size_t sample_count,
+                                     size_t *rows_emitted_out);
+
+/**
+ * @brief Hand every row the stream emits to a consumer as well (NULL detaches)
+ *
+ * Lets other stages reuse the wake word FFT instead of running their own.
+ */
+void audio_features_stream_set_row_cb(audio_features_t *features,
+                                      audio_features_row_cb_t cb,
+                                      void *ctx);
+
+/**
+ * @brief Copy the most recent mel rows in chronological order
+ *
+ * @param features Extractor handle
+ * @param window_out Output buffer, n_frames * AUDIO_FEATURES_N_MELS floats
+ * @param n_frames Number of rows to copy (<= AUDIO_FEATURES_WINDOW_FRAMES)
+ * @return ESP_OK on success, ESP_ERR_NOT_FINISHED if fewer rows are buffered
+ */
+esp_err_t audio_features_stream_get_window(audio_features_t *features,
+                                           float *window_out,
+                                           size_t n_frames);
+
+/**
+ * @brief Get a pointer to the newest mel row, or NULL if none yet
+ */
+const float *audio_features_stream_latest_row(audio_features_t *features);
+
+/**
+ * @brief Number of rows currently buffered in the rolling window
+ */
+size_t audio_features_stream_available(audio_features_t *features);
+
+/**
+ * @brief Total rows emitted since init/reset (monotonic counter)
+ */
+uint32_t audio_features_stream_total_rows(audio_features_t *features);
+
+/**
+ * @brief Drop buffered audio and spectrogram rows
+ */
+void audio_features_stream_reset(audio_features_t *features);
+
+void audio_features_deinit(audio_features_t *features);
+
+/** Largest transform audio_features_fft() takes, in complex points */
+#define AUDIO_FEATURES_FFT_MAX 512
+
+/**
+ * @brief Set up the shared float FFT for audio_features_fft()
+ *
+ * Idempotent, but not thread-safe: call from setup code, before any task
+ * transforms. The twiddle table is the one the float frontend uses; it is
+ * never freed, so audio_features_deinit() on any extractor leaves it in place.
+ */
+esp_err_t audio_features_fft_init(void);
+
+/**
+ * @brief In-place complex FFT on the frontend's radix-2 engine
+ *
+ * Lets other stages reuse the ESP-DSP kernels (or the fallback DFT) and
+ * twiddle table instead of carrying their own.
+ *
+ * @param data n complex floats [Re, Im, ...], natural order in and out
+ * @param n Power of two, 2..AUDIO_FEATURES_FFT_MAX
+ * @return ESP_ERR_INVALID_ARG for a bad size, ESP_ERR_INVALID_STATE before
+ *         audio_features_fft_init()
+ */
+esp_err_t audio_features_fft(float *data, size_t n);
+
+#ifdef __cplusplus
+}
+#endif
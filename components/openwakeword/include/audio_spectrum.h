@@ -0,0 +1,52 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Band-energy analyzer that rides on the streaming mel frontend. It groups
+ * each mel row into a few bands spread evenly on the mel scale (log-spaced
+ * in Hz), smooths them with separate attack and decay times and flags beats
+ * from low-band onsets. Rows arrive on the audio task; any task may read.
+ */
+
+#define AUDIO_SPECTRUM_MAX_BANDS 16
+
+typedef struct {
+    uint8_t band_count;     ///< 1..AUDIO_SPECTRUM_MAX_BANDS (default 8)
+    uint16_t attack_ms;     ///< Rise time constant (default 20)
+    uint16_t decay_ms;      ///< Fall time constant (default 250)
+    uint8_t range_db;       ///< Span from each band's floor to full scale (default 40)
+} audio_spectrum_config_t;
+
+typedef struct audio_spectrum audio_spectrum_t;
+
+audio_spectrum_t *audio_spectrum_create(const audio_spectrum_config_t *config);
+void audio_spectrum_destroy(audio_spectrum_t *spectrum);
+
+/**
+ * @brief Feed one mel row (AUDIO_FEATURES_N_MELS log10 magnitudes)
+ *
+ * Matches the audio_features row callback, so it can be attached directly.
+ */
+void audio_spectrum_push_row(const float *mel_row, void *spectrum);
+
+/**
+ * @brief Copy the smoothed band levels
+ *
+ * @param levels_out 0-255 per band, lowest band first
+ * @param count Entries to copy, clamped to the band count
+ * @param beats_out Optional, beats detected since create; compare with the
+ *                  previous read to spot new ones
+ * @return Number of bands copied
+ */
+size_t audio_spectrum_read(audio_spectrum_t *spectrum, uint8_t *levels_out, size_t count, uint32_t *beats_out);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,62 @@
+/**
+ * @file detection_filter.h
+ * @brief Turns a wake word's per-frame scores into triggers
+ *
+ * openWakeWord-style post-processing: each wake word keeps a ring of its
+ * recent raw scores, compares their short moving average against its own
+ * threshold, and only triggers once that has held for `patience` frames in
+ * a row. While the detector is debouncing after any trigger, scores are
+ * still recorded but cannot trigger, and the run has to start over.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Raw scores kept per wake word (about 2.5 s at one score per 80 ms) */
+#define DETECTION_FILTER_HISTORY 32
+
+typedef struct {
+    float threshold;                  ///< Smoothed score must exceed this
+    uint8_t patience_frames;          ///< Consecutive frames over threshold to trigger (0 = 1)
+    uint8_t smoothing_frames;         ///< Newest scores averaged (0 or 1 = raw score)
+} detection_filter_config_t;
+
+typedef struct {
+    detection_filter_config_t config;
+    float scores[DETECTION_FILTER_HISTORY];   // Raw scores, newest at head - 1
+    uint8_t head;
+    uint8_t count;                    // Valid entries in scores
+    uint8_t run;                      // Consecutive smoothed scores over threshold
+    float smoothed;                   // Latest smoothed score
+} detection_filter_t;
+
+/**
+ * @brief Set up a filter; patience and smoothing are clamped to the history
+ */
+void detection_filter_init(detection_filter_t *filter, const detection_filter_config_t *config);
+
+/**
+ * @brief Forget recorded scores and any run in progress
+ */
+void detection_filter_reset(detection_filter_t *filter);
+
+/**
+ * @brief Record one frame's score
+ *
+ * @param filter Filter
+ * @param score Raw model output for the frame
+ * @param armed False while debouncing: the score is recorded but the run is held at zero
+ * @return true when this frame completes the patience run; the run restarts after a trigger
+ */
+bool detection_filter_push(detection_filter_t *filter, float score, bool armed);
+
+#ifdef __cplusplus
+}
+#endif
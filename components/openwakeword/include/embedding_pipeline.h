@@ -0,0 +1,179 @@
+/**
+ * @file embedding_pipeline.h
+ * @brief Staged openWakeWord inference: mel window -> embedding -> classifier heads
+ *
+ * Mirrors upstream openWakeWord: a shared embedding model runs over the last
+ * 76 mel rows every 80 ms, its output is appended to a ring of embeddings,
+ * and each small wake-word classifier head scores the newest N embeddings.
+ * Only one embedding is computed per 80 ms step regardless of how many
+ * heads are registered, and the heads' interpreters share one tensor arena
+ * (tflite_wrapper_group_t) since they run back to back.
+ *
+ * An optional event head scores sound classes (snore, cough, ...) from the
+ * same embeddings at a decimated cadence, so sound-event detection costs a
+ * small model run every few hundred milliseconds and no frontend of its own.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "audio_features.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Maximum number of classifier heads sharing one embedding stage */
+#define EMBEDDING_PIPELINE_MAX_HEADS 4
+
+/** Embeddings kept in the ring (upstream heads consume 16) */
+#define EMBEDDING_PIPELINE_RING_SIZE 16
+
+/** Mel rows between consecutive embeddings (80 ms at 10 ms hop) */
+#define EMBEDDING_PIPELINE_STEP_FRAMES 8
+
+/** Classes the event head may score */
+#define EMBEDDING_PIPELINE_MAX_EVENT_CLASSES 8
+
+typedef struct embedding_pipeline embedding_pipeline_t;
+
+/**
+ * @brief Create the pipeline around a shared embedding model
+ *
+ * The embedding model must take AUDIO_FEATURES_WINDOW_FRAMES x
+ * AUDIO_FEATURES_N_MELS floats. Takes ownership of model_data, which is
+ * released with model_loader_free() on destroy, or before returning NULL.
+ *
+ * @param model_data Embedding TFLite flatbuffer
+ * @param model_size Model size in bytes
+ * @param arena_size Tensor arena for the embedding interpreter
+ * @return Pipeline handle or NULL on error
+ */
+embedding_pipeline_t *embedding_pipeline_create(uint8_t *model_data,
+                                                size_t model_size,
+                                                size_t arena_size);
+
+/**
+ * @brief Register a wake-word classifier head
+ *
+ * The head's input length must be a multiple of the embedding size and
+ * cover at most EMBEDDING_PIPELINE_RING_SIZE embeddings. Takes ownership
+ * of model_data. All heads are replanned into one shared arena each time a
+ * head is added, so add them during setup.
+ *
+ * @param pipeline Pipeline handle
+ * @param name Wake word name reported to callers (copied)
+ * @param model_data Classifier TFLite flatbuffer
+ * @param model_size Model size in bytes
+ * @param arena_size Arena this head would need alone; the shared arena is bounded by the sum
+ * @param index_out Optional, index of the new head
+ * @return ESP_OK on success
+ */
+esp_err_t embedding_pipeline_add_head(embedding_pipeline_t *pipeline,
+                                      const char *name,
+                                      uint8_t *model_data,
+                                      size_t model_size,
+                                      size_t arena_size,
+                                      size_t *index_out);
+
+/**
+ * @brief Set the sound event head
+ *
+ * Like a wake word head its input is the newest N embeddings; its output is
+ * one score per class (at most EMBEDDING_PIPELINE_MAX_EVENT_CLASSES). It has
+ * its own interpreter and runs once every stride embeddings. Takes
+ * ownership of model_data.
+ *
+ * @param pipeline Pipeline handle
+ * @param model_data Event classifier TFLite flatbuffer
+ * @param model_size Model size in bytes
+ * @param arena_size Tensor arena for its interpreter
+ * @param stride Embeddings between runs (0 = every embedding)
+ * @param class_count_out Optional, number of classes it scores
+ * @return ESP_OK on success, ESP_ERR_INVALID_STATE if already set
+ */
+esp_err_t embedding_pipeline_set_event_head(embedding_pipeline_t *pipeline,
+                                            uint8_t *model_data,
+                                            size_t model_size,
+                                            size_t arena_size,
+                                            uint8_t stride,
+                                            size_t *class_count_out);
+
+/**
+ * @brief Advance the pipeline after new mel rows were pushed
+ *
+ * Computes one embedding if at least EMBEDDING_PIPELINE_STEP_FRAMES rows
+ * arrived since the previous one and the mel window is full, then runs
+ * every head whose embedding history is complete.
+ *
+ * @param pipeline Pipeline handle
+ * @param features Streaming mel extractor feeding the pipeline
+ * @param scored_out Optional, true if head scores were updated
+ * @return ESP_OK on success
+ */
+esp_err_t embedding_pipeline_process(embedding_pipeline_t *pipeline,
+                                     audio_features_t *features,
+                                     bool *scored_out);
+
+/**
+ * @brief Number of registered heads
+ */
+size_t embedding_pipeline_head_count(const embedding_pipeline_t *pipeline);
+
+/**
+ * @brief Latest score and name of a head
+ *
+ * @param pipeline Pipeline handle
+ * @param index Head index
+ * @param name_out Optional, head name
+ * @param score_out Optional, last score (0.0 until the head has run)
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG for bad index
+ */
+esp_err_t embedding_pipeline_get_score(const embedding_pipeline_t *pipeline,
+                                       size_t index,
+                                       const char **name_out,
+                                       float *score_out);
+
+/**
+ * @brief Event scores from the last embedding_pipeline_process() call
+ *
+ * @param pipeline Pipeline handle
+ * @param scores_out Receives one score per class
+ * @param max Entries scores_out holds
+ * @param event_us_out Optional, event head run time
+ * @return Classes written; 0 when the event head did not run in that call
+ */
+size_t embedding_pipeline_get_event_scores(const embedding_pipeline_t *pipeline,
+                                           float *scores_out,
+                                           size_t max,
+                                           uint32_t *event_us_out);
+
+/**
+ * @brief Model time of the last embedding_pipeline_process() call
+ *
+ * @param pipeline Pipeline handle
+ * @param embedding_us_out Optional, embedding model (0 if no embedding was due)
+ * @param classifier_us_out Optional, all heads together (0 if no embedding was due)
+ * @param skipped_steps_out Optional, embedding steps lost to late frames since creation
+ */
+void embedding_pipeline_get_timing(const embedding_pipeline_t *pipeline,
+                                   uint32_t *embedding_us_out,
+                                   uint32_t *classifier_us_out,
+                                   uint32_t *skipped_steps_out);
+
+/**
+ * @brief Clear embedding history and head scores
+ */
+void embedding_pipeline_reset(embedding_pipeline_t *pipeline);
+
+/**
+ * @brief Destroy the pipeline and release all models
+ */
+void embedding_pipeline_destroy(embedding_pipeline_t *pipeline);
+
+#ifdef __cplusplus
+}
+#endif
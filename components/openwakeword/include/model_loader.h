@@ -2,7 +2,64 @@
 
 #include <stdint.h>
 #include <stddef.h>
+#include <stdbool.h>
 #include "esp_err.h"
+#include "esp_partition.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** "OWWM" little-endian: marks a raw model partition with a size header */
+#define MODEL_PARTITION_MAGIC 0x4D57574FU
+#define MODEL_PARTITION_HEADER_VERSION 2
+
+/**
+ * @brief Header at offset 0 of a raw model partition
+ *
+ * Written by scripts/pack_model_partition.py. Version 1 images are this
+ * header and the flatbuffer; version 2 extends it to
+ * model_partition_header_v2_t. Either way the flatbuffer follows the
+ * header 16-byte aligned in the mapping.
+ */
+typedef struct __attribute__((packed)) {
+    uint32_t magic;          ///< MODEL_PARTITION_MAGIC
+    uint32_t version;        ///< Header version, 1 or MODEL_PARTITION_HEADER_VERSION
+    uint32_t model_size;     ///< Flatbuffer size in bytes
+    uint32_t crc32;          ///< CRC32 (little-endian) of the flatbuffer, 0 to skip
+} model_partition_header_t;
+
+typedef struct __attribute__((packed)) {
+    model_partition_header_t base;
+    uint32_t model_version;  ///< The model's own version, set when it is packed
+    uint32_t reserved[3];
+} model_partition_header_v2_t;
+
+/** Where the flatbuffer starts in an image with this header version */
+#define MODEL_PARTITION_HEADER_SIZE(version) \
+    ((version) >= 2 ? sizeof(model_partition_header_v2_t) : sizeof(model_partition_header_t))
+
+/**
+ * @brief Handle for a memory-mapped model
+ */
+typedef struct {
+    esp_partition_mmap_handle_t mmap_handle;
+    bool mapped;
+    uint32_t model_version;  ///< From a version 2 header, 0 otherwise
+} model_loader_mmap_t;
+
+/**
+ * @brief A model in the registry, shared by everyone who acquired it
+ */
+typedef struct {
+    const char *partition;   ///< Partition label
+    const uint8_t *data;     ///< The flatbuffer, in flash
+    size_t size;
+    uint32_t model_version;  ///< From a version 2 header, 0 otherwise
+} model_loader_model_t;
+
+/** Models mapped at the same time; each takes MMU pages, not RAM */
+#define MODEL_LOADER_MAX_ACTIVE 4
 
 /**
  * @brief Load TFLite model from SPIFFS partition
@@ -42,9 +99,107 @@ esp_err_t model_loader_load_from_partition_raw(const char *partition_name,
                                                 uint8_t **model_data_out,
                                                 size_t *model_size_out);
 
+/**
+ * @brief Memory-map a model from a raw partition (no copy into RAM)
+ * 
+ * The TFLite flatbuffer is used directly from flash through the MMU. The
+ * model size comes from the partition header; a partition without a header
+ * but holding a bare flatbuffer is mapped whole for backward compatibility.
+ * 
+ * @param partition_name Partition name
+ * @param model_data_out Pointer into the mapping, valid until model_loader_munmap()
+ * @param model_size_out Model size in bytes (from the header)
+ * @param mapping_out Mapping handle
+ * @return ESP_OK on success, ESP_ERR_NOT_FOUND if no partition,
+ *         ESP_ERR_INVALID_SIZE / ESP_ERR_INVALID_CRC on a bad image
+ */
+esp_err_t model_loader_mmap_partition(const char *partition_name,
+                                      const uint8_t **model_data_out,
+                                      size_t *model_size_out,
+                                      model_loader_mmap_t *mapping_out);
+
+/**
+ * @brief Release a mapping created by model_loader_mmap_partition()
+ * 
+ * @param mapping Mapping handle
+ */
+void model_loader_munmap(model_loader_mmap_t *mapping);
+
+/**
+ * @brief Get a model from the registry, mapping its partition on first use
+ *
+ * Every model partition (wake words, sound event classifiers, ...) goes
+ * through here, so a model in use by several users is mapped and checked
+ * once, and one nobody has asked for costs nothing. The mapping is
+ * released with the last model_loader_release().
+ *
+ * @param partition_name Partition label
+ * @param model_out The shared entry, valid until released
+ * @return As model_loader_mmap_partition(), or ESP_ERR_NO_MEM when
+ *         MODEL_LOADER_MAX_ACTIVE models are already mapped
+ */
+esp_err_t model_loader_acquire(const char *partition_name, const model_loader_model_t **model_out);
+
+/**
+ * @brief Drop a reference taken by model_loader_acquire()
+ */
+void model_loader_release(const model_loader_model_t *model);
+
+/**
+ * @brief Streamed write of a packed model image into a partition
+ *
+ * Used to receive a model over the network straight into flash, without
+ * holding the image in RAM. The image is what pack_model_partition.py
+ * produces: header followed by the flatbuffer.
+ */
+typedef struct {
+    const esp_partition_t *partition;
+    size_t image_size;       ///< Declared size, header included
+    size_t written;
+} model_loader_writer_t;
+
+/**
+ * @brief Erase room for an image and start writing at offset 0
+ * 
+ * Never point this at the partition the running model is mapped from;
+ * a partition acquired from the registry is refused.
+ * 
+ * @param partition_name Partition name
+ * @param image_size Full image size, header included
+ * @param writer_out Writer state
+ * @return ESP_OK on success, ESP_ERR_NOT_FOUND if no partition,
+ *         ESP_ERR_INVALID_SIZE if the image does not fit,
+ *         ESP_ERR_INVALID_STATE if the partition is in use
+ */
+esp_err_t model_loader_write_begin(const char *partition_name,
+                                   size_t image_size,
+                                   model_loader_writer_t *writer_out);
+
+/**
+ * @brief Append the next chunk of the image
+ * 
+ * @return ESP_ERR_INVALID_SIZE if more than the declared size would be written
+ */
+esp_err_t model_loader_write(model_loader_writer_t *writer, const void *data, size_t len);
+
+/**
+ * @brief Check the written image is complete and its CRC matches
+ * 
+ * Images without a CRC in the header are rejected here, unlike at boot,
+ * since nothing else vouches for a downloaded model.
+ * 
+ * @return ESP_OK when the partition holds a valid model,
+ *         ESP_ERR_INVALID_SIZE / ESP_ERR_INVALID_VERSION / ESP_ERR_INVALID_CRC otherwise
+ */
+esp_err_t model_loader_write_finish(model_loader_writer_t *writer);
+
 /**
  * @brief Free model data allocated by loader
  * 
  * @param model_data Model data to free
  */
-void model_loader_free(uint8_t *model_data);
\ No newline at end of file
+void model_loader_free(uint8_t *model_data);
+
+#ifdef __cplusplus
+}
+#endif
\ No newline at end of file
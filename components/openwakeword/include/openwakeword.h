@@ -9,8 +9,10 @@
 #pragma once
 
 #include <stdint.h>
+#include <stddef.h>
 #include <stdbool.h>
 #include "esp_err.h"
+#include "audio_spectrum.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -25,6 +27,31 @@ extern "C" {
  */
 typedef void (*openwakeword_callback_t)(const char *wake_word_name, float confidence, void *user_data);
 
+/**
+ * @brief A finished sound event from the event head
+ */
+typedef struct {
+    const char *label;                ///< Class name from openwakeword_config_t.event_labels
+    int64_t start_us;                 ///< esp_timer time the event opened
+    uint32_t duration_ms;
+    float confidence;                 ///< Peak score while it lasted
+} openwakeword_sound_event_t;
+
+/**
+ * @brief Callback for sound events, from the task processing audio
+ */
+typedef void (*openwakeword_event_callback_t)(const openwakeword_sound_event_t *event, void *user_data);
+
+/**
+ * @brief Classifier head for the three-stage pipeline
+ */
+typedef struct {
+    const char *name;                 ///< Wake word name passed to the callback
+    const char *model_path;           ///< Path to the classifier TFLite model
+    float threshold;                  ///< Detection threshold (0 = use config threshold)
+    uint8_t patience_frames;          ///< Frames over threshold to trigger (0 = use config's)
+} openwakeword_head_config_t;
+
 /**
  * @brief Configuration for OpenWakeWord
  */
@@ -34,8 +61,18 @@ typedef struct {
     uint32_t sample_rate;              ///< Audio sample rate (default 16000)
     uint32_t frame_size_ms;           ///< Audio frame size in milliseconds (default 80)
     uint32_t cooldown_ms;             ///< Cooldown period after detection in ms (default 2000)
+    uint8_t patience_frames;          ///< Consecutive scores over threshold to trigger (0 = Kconfig default)
+    uint8_t smoothing_frames;         ///< Scores averaged before the threshold (0 = Kconfig default)
     bool enable_vad;                  ///< Enable voice activity detection
     float vad_threshold;              ///< VAD threshold if enabled
+    const char *embedding_model_path; ///< Shared embedding model; enables mel -> embedding -> classifier
+    const openwakeword_head_config_t *heads; ///< Classifier heads (NULL: model_path as "hey_naptick")
+    size_t head_count;                ///< Number of entries in heads
+    const char *event_model_path;     ///< Sound event head over the shared embeddings (NULL/"" = none)
+    const char *const *event_labels;  ///< Class names in output order, kept by pointer (NULL: snore, cough, talking, alarm)
+    size_t event_label_count;         ///< Number of entries in event_labels
+    float event_threshold;            ///< Score that opens an event (0 = Kconfig default)
+    uint8_t event_stride;             ///< Embeddings between event head runs (0 = Kconfig default)
 } openwakeword_config_t;
 
 /**
@@ -64,6 +101,12 @@ esp_err_t openwakeword_init(const openwakeword_config_t *config,
 /**
  * @brief Process audio frame
  * 
+ * Each wake word's score goes through a detection_filter_t: averaged over
+ * smoothing_frames, it has to stay over that word's threshold for
+ * patience_frames in a row. During the cooldown after a trigger audio is
+ * still streamed through the features and models, so scores and windows
+ * are current when it ends, but nothing can trigger.
+ *
  * @param handle OpenWakeWord handle
  * @param audio_samples 16-bit PCM audio samples
  * @param sample_count Number of samples (must match frame_size_ms)
@@ -83,6 +126,65 @@ esp_err_t openwakeword_process_audio(openwakeword_handle_t handle,
  */
 esp_err_t openwakeword_deinit(openwakeword_handle_t handle);
 
+/**
+ * @brief Feed the detector's mel rows to a spectrum analyzer (NULL detaches)
+ *
+ * Rows are produced for every processed frame, including during the
+ * post-detection cooldown.
+ *
+ * @param handle OpenWakeWord handle
+ * @param spectrum Analyzer from audio_spectrum_create()
+ * @return ESP_OK on success
+ */
+esp_err_t openwakeword_attach_spectrum(openwakeword_handle_t handle,
+                                       audio_spectrum_t *spectrum);
+
+/**
+ * @brief Receive sound events (NULL detaches)
+ *
+ * Events keep coming through the wake word cooldown. Set it before audio
+ * is processed; the callback runs on that task and should only queue.
+ *
+ * @param handle OpenWakeWord handle
+ * @param callback Called once per finished event
+ * @param user_data Passed to callback
+ * @return ESP_OK on success
+ */
+esp_err_t openwakeword_set_event_callback(openwakeword_handle_t handle,
+                                          openwakeword_event_callback_t callback,
+                                          void *user_data);
+
+/**
+ * @brief Replace the wake word model while detection keeps running
+ * 
+ * Maps the model in the given partition (CRC checked), builds its
+ * interpreter in the calling task, then swaps it in between two frames:
+ * openwakeword_process_audio() only waits for the pointer exchange. The old
+ * interpreter is freed afterwards and the partition is remembered in NVS,
+ * so the next boot maps it too. On any failure the current model stays.
+ * 
+ * Both interpreters' arenas are allocated while the new one is built.
+ * Single-model detection only; pipeline heads load from SPIFFS at init.
+ * 
+ * @param handle OpenWakeWord handle
+ * @param partition_name Partition written with model_loader_write_*(),
+ *        normally openwakeword_spare_partition()
+ * @return ESP_OK once the new model is live, ESP_ERR_NOT_SUPPORTED in
+ *         pipeline mode or without TFLite, else the load error
+ */
+esp_err_t openwakeword_swap_model(openwakeword_handle_t handle, const char *partition_name);
+
+/**
+ * @brief Model partition not in use, safe to overwrite with an update
+ * 
+ * Alternates between CONFIG_OPENWAKEWORD_MODEL_PARTITION and
+ * CONFIG_OPENWAKEWORD_MODEL_SPARE_PARTITION as models are swapped.
+ * 
+ * @param handle OpenWakeWord handle
+ * @return Partition label
+ */
+const char *openwakeword_spare_partition(openwakeword_handle_t handle);
+
 /**
  * @brief Get model input shape requirements
  * 
@@ -2,11 +2,66 @@
 
 #include <stdint.h>
 #include <stddef.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "sdkconfig.h"
+#include "openwakeword.h"
+
+#if CONFIG_IDF_TARGET_LINUX
+#include <time.h>
+#else
+#include "esp_timer.h"
+#endif
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/** Wake words tracked in the score statistics (EMBEDDING_PIPELINE_MAX_HEADS) */
+#define OPENWAKEWORD_STATS_MAX_WORDS 4
+
+/**
+ * Latency histogram buckets. Bucket 0 counts runs under
+ * OPENWAKEWORD_STATS_BUCKET_BASE_US, bucket i runs under BASE << i, and the
+ * last bucket everything slower (about 131 ms and up with the defaults).
+ */
+#define OPENWAKEWORD_STATS_BUCKETS 12
+#define OPENWAKEWORD_STATS_BUCKET_BASE_US 128
+
+/** Weight of each new score in the running average (about 1.6 s at 80 ms frames) */
+#ifndef OPENWAKEWORD_STATS_SCORE_EWMA_ALPHA
+#define OPENWAKEWORD_STATS_SCORE_EWMA_ALPHA 0.05f
+#endif
+
+typedef enum {
+    OPENWAKEWORD_STAGE_FRONTEND,      ///< Streaming melspectrogram
+    OPENWAKEWORD_STAGE_EMBEDDING,     ///< Shared embedding model (three-stage pipeline only)
+    OPENWAKEWORD_STAGE_CLASSIFIER,    ///< Wake word model(s)
+    OPENWAKEWORD_STAGE_EVENTS,        ///< Sound event head (decimated)
+    OPENWAKEWORD_STAGE_COUNT,
+} openwakeword_stage_t;
+
+/**
+ * @brief Latency of one stage, in microseconds
+ */
+typedef struct {
+    uint32_t count;                   ///< Runs recorded
+    uint32_t last_us;
+    uint32_t max_us;
+    uint64_t total_us;
+    uint32_t histogram[OPENWAKEWORD_STATS_BUCKETS];
+} openwakeword_stage_stats_t;
+
+/**
+ * @brief Score history of one wake word
+ */
+typedef struct {
+    const char *name;
+    float last;                       ///< Newest raw score
+    float ewma;                       ///< Running average, the word's background level
+    float peak;                       ///< Highest raw score since the last reset
+} openwakeword_score_stats_t;
+
 /**
  * @brief OpenWakeWord performance statistics
  */
@@ -15,41 +70,87 @@ typedef struct {
     uint32_t detections_count;
     uint32_t inference_errors;
     uint32_t preprocessing_errors;
-    
-    // Timing (in milliseconds, approximate)
-    uint32_t avg_preprocessing_time_ms;
-    uint32_t avg_inference_time_ms;
-    uint32_t max_preprocessing_time_ms;
-    uint32_t max_inference_time_ms;
-    
+    uint32_t frames_dropped;          ///< Reported by the caller via openwakeword_note_dropped()
+    uint32_t embedding_steps_skipped; ///< 80 ms embedding steps lost because frames arrived late
+    uint32_t sound_events;            ///< Events reported to the event callback
+
+    // Timing, from esp_timer (microseconds)
+    openwakeword_stage_stats_t stages[OPENWAKEWORD_STAGE_COUNT];
+    uint64_t audio_us;                ///< Audio covered by the processed frames
+    uint64_t busy_us;                 ///< Time spent in openwakeword_process_audio()
+    uint32_t max_frame_us;            ///< Slowest single call
+    float real_time_factor;           ///< busy_us / audio_us; at 1.0 or more detection falls behind
+
+    // Scores
+    openwakeword_score_stats_t scores[OPENWAKEWORD_STATS_MAX_WORDS];
+    size_t score_count;
+
     // Memory usage
     size_t model_size_bytes;
     size_t tensor_arena_size_bytes;
     size_t audio_buffer_size_bytes;
-    
+
     // Model state
     bool model_loaded;
     bool tflite_initialized;
     bool test_mode_enabled;
 } openwakeword_stats_t;
 
+/**
+ * @brief Microsecond clock the statistics are taken with
+ */
+static inline int64_t openwakeword_stats_now_us(void)
+{
+#if CONFIG_IDF_TARGET_LINUX
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+#else
+    return esp_timer_get_time();
+#endif
+}
+
 /**
  * @brief Get current statistics
- * 
+ *
+ * Safe to call from any task while another is processing audio.
+ *
  * @param handle OpenWakeWord handle
  * @param stats_out Output statistics
  * @return ESP_OK on success
  */
-int openwakeword_get_stats(void *handle, openwakeword_stats_t *stats_out);
+esp_err_t openwakeword_get_stats(openwakeword_handle_t handle, openwakeword_stats_t *stats_out);
 
 /**
- * @brief Reset statistics
- * 
+ * @brief Reset timing, drop and score statistics
+ *
+ * Frame, detection and error counters keep running.
+ *
  * @param handle OpenWakeWord handle
  * @return ESP_OK on success
  */
-int openwakeword_reset_stats(void *handle);
+esp_err_t openwakeword_reset_stats(openwakeword_handle_t handle);
+
+/**
+ * @brief Count frames the caller discarded because detection was behind
+ *
+ * @param handle OpenWakeWord handle
+ * @param frames Frames of frame_size_ms never passed to openwakeword_process_audio()
+ */
+void openwakeword_note_dropped(openwakeword_handle_t handle, uint32_t frames);
+
+/**
+ * @brief Latency below which pct percent of a stage's runs finished
+ *
+ * Resolved to the histogram: returns the upper edge of the bucket holding
+ * the percentile, or UINT32_MAX when it falls in the open last bucket.
+ *
+ * @param stage Stage statistics
+ * @param pct Percentile, 0 to 100
+ * @return Microseconds, 0 when the stage has not run
+ */
+uint32_t openwakeword_stats_percentile_us(const openwakeword_stage_stats_t *stage, float pct);
 
 #ifdef __cplusplus
 }
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,62 @@
+/**
+ * @file sound_event_filter.h
+ * @brief Turns one sound class's periodic scores into timed events
+ *
+ * Hysteresis on the event head's output: a score at or over on_threshold
+ * opens an event, scores down to off_threshold keep it open, and the first
+ * score under that closes it. An event that runs past max_ms (a night of
+ * snoring) is reported in max_ms pieces, so telemetry never waits on it
+ * for long.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    float on_threshold;               ///< Score that opens an event
+    float off_threshold;              ///< Scores under this close it
+    uint32_t max_ms;                  ///< Longer events are split (0 = never)
+} sound_event_filter_config_t;
+
+/** One finished event */
+typedef struct {
+    int64_t start_us;                 ///< Time of the score that opened it
+    uint32_t duration_ms;
+    float confidence;                 ///< Peak score
+} sound_event_t;
+
+typedef struct {
+    sound_event_filter_config_t config;
+    bool active;
+    int64_t start_us;
+    float peak;
+} sound_event_filter_t;
+
+void sound_event_filter_init(sound_event_filter_t *filter, const sound_event_filter_config_t *config);
+
+/**
+ * @brief Drop an event in progress without reporting it
+ */
+void sound_event_filter_reset(sound_event_filter_t *filter);
+
+/**
+ * @brief Record one score
+ *
+ * @param filter Filter
+ * @param score Class score from the event head
+ * @param now_us Time of the score
+ * @param event_out Filled when an event finishes
+ * @return true when event_out holds an event to report
+ */
+bool sound_event_filter_push(sound_event_filter_t *filter, float score, int64_t now_us, sound_event_t *event_out);
+
+#ifdef __cplusplus
+}
+#endif
@@ -10,10 +10,56 @@ extern "C" {
 #endif
 
 typedef struct tflite_wrapper tflite_wrapper_t;
+typedef struct tflite_wrapper_group tflite_wrapper_group_t;
+
+/** Most models one shared-arena group can hold */
+#define TFLITE_WRAPPER_GROUP_MAX 8
+
+/**
+ * @brief Element type of an input/output tensor
+ */
+typedef enum {
+    TFLITE_WRAPPER_TYPE_UNKNOWN = 0,
+    TFLITE_WRAPPER_TYPE_FLOAT32,
+    TFLITE_WRAPPER_TYPE_INT8,
+    TFLITE_WRAPPER_TYPE_UINT8,
+    TFLITE_WRAPPER_TYPE_INT16,
+} tflite_wrapper_type_t;
+
+/**
+ * @brief Heap the tensor arena is allocated from
+ */
+typedef enum {
+    TFLITE_WRAPPER_ARENA_AUTO = 0,   ///< Internal SRAM if it leaves the configured reserve free, else PSRAM
+    TFLITE_WRAPPER_ARENA_INTERNAL,   ///< Internal SRAM only (fastest)
+    TFLITE_WRAPPER_ARENA_PSRAM,      ///< PSRAM, falling back to internal SRAM
+    TFLITE_WRAPPER_ARENA_DMA,        ///< DMA-capable internal SRAM
+} tflite_wrapper_arena_placement_t;
+
+/**
+ * @brief Arena options for tflite_wrapper_create_with_config()
+ */
+typedef struct {
+    size_t arena_size;                          ///< Arena size, or probe upper bound when auto_size is set
+    tflite_wrapper_arena_placement_t placement; ///< Heap for the final arena
+    bool auto_size;                             ///< Trim the arena to what AllocateTensors() actually used
+    bool persist_size;                          ///< Cache the measured size in NVS, keyed by model CRC
+} tflite_wrapper_config_t;
+
+/**
+ * @brief Default arena options from Kconfig
+ * 
+ * @param arena_size Arena size / probe upper bound
+ * @return Config with Kconfig placement and auto-sizing settings
+ */
+tflite_wrapper_config_t tflite_wrapper_default_config(size_t arena_size);
 
 /**
  * @brief Create TFLite wrapper
  * 
+ * Equivalent to tflite_wrapper_create_with_config() with
+ * tflite_wrapper_default_config(tensor_arena_size).
+ * 
  * @param model_data TFLite model data
  * @param model_size Model size in bytes
  * @param tensor_arena_size Size of tensor arena
@@ -23,12 +69,46 @@ tflite_wrapper_t* tflite_wrapper_create(const uint8_t* model_data,
                                              size_t model_size,
                                              size_t tensor_arena_size);
 
+/**
+ * @brief Create TFLite wrapper with explicit arena sizing and placement
+ * 
+ * With auto_size, the model is first planned in a transient probe arena of
+ * config->arena_size bytes (PSRAM when available), the real arena is then
+ * allocated at arena_used_bytes() plus a small margin in the requested heap.
+ * With persist_size, the measured size is stored in NVS so later boots skip
+ * the probe; a stale entry is discarded if AllocateTensors() fails with it.
+ * 
+ * @param model_data TFLite model data
+ * @param model_size Model size in bytes
+ * @param config Arena options
+ * @return Wrapper handle or NULL on error
+ */
+tflite_wrapper_t* tflite_wrapper_create_with_config(const uint8_t* model_data,
+                                                    size_t model_size,
+                                                    const tflite_wrapper_config_t* config);
+
+/**
+ * @brief Get arena usage
+ * 
+ * @param wrapper TFLite wrapper
+ * @param used_out Optional, bytes used by the interpreter after AllocateTensors()
+ * @param allocated_out Optional, bytes allocated for the arena
+ * @return ESP_OK on success
+ */
+esp_err_t tflite_wrapper_get_arena_usage(tflite_wrapper_t* wrapper,
+                                         size_t* used_out,
+                                         size_t* allocated_out);
+
 /**
  * @brief Run inference
  * 
+ * Float, int8, uint8 and int16 models are supported. For quantized models the
+ * input is quantized and the output dequantized with the tensors' scale and
+ * zero-point, so callers always deal in floats.
+ * 
  * @param wrapper TFLite wrapper
  * @param input_data Input data (melspectrogram)
- * @param input_size Input size in floats
+ * @param input_size Input size in elements
  * @param output_data Output buffer
  * @param output_size Output size (in/out)
  * @return ESP_OK on success
@@ -39,18 +119,118 @@ esp_err_t tflite_wrapper_invoke(tflite_wrapper_t* wrapper,
                                  float* output_data, 
                                  size_t* output_size);
 
+/**
+ * @brief Get a pointer to the interpreter's input tensor buffer
+ * 
+ * Lets producers write features straight into the tensor arena. Fill it with
+ * tflite_wrapper_get_input_size() elements of the reported type, then call
+ * tflite_wrapper_invoke_in_place(). The pointer stays valid for the lifetime
+ * of the wrapper.
+ * 
+ * @param wrapper TFLite wrapper
+ * @param type_out Optional, element type of the buffer
+ * @return Buffer pointer, or NULL if not initialized
+ */
+void* tflite_wrapper_input_ptr(tflite_wrapper_t* wrapper, tflite_wrapper_type_t* type_out);
+
+/**
+ * @brief Get a pointer to the interpreter's output tensor buffer
+ * 
+ * Valid after tflite_wrapper_invoke_in_place() until the next invoke.
+ * 
+ * @param wrapper TFLite wrapper
+ * @param type_out Optional, element type of the buffer
+ * @return Buffer pointer, or NULL if not initialized
+ */
+const void* tflite_wrapper_output_ptr(tflite_wrapper_t* wrapper, tflite_wrapper_type_t* type_out);
+
+/**
+ * @brief Get quantization parameters of the input or output tensor
+ * 
+ * real = (q - zero_point) * scale. Float tensors report scale 1, zero-point 0.
+ * 
+ * @param wrapper TFLite wrapper
+ * @param output false for input(0), true for output(0)
+ * @param scale_out Optional, scale
+ * @param zero_point_out Optional, zero-point
+ * @return ESP_OK on success
+ */
+esp_err_t tflite_wrapper_get_quant_params(tflite_wrapper_t* wrapper, bool output,
+                                          float* scale_out, int32_t* zero_point_out);
+
+/**
+ * @brief Run inference on whatever is already in the input tensor
+ * 
+ * @param wrapper TFLite wrapper
+ * @return ESP_OK on success
+ */
+esp_err_t tflite_wrapper_invoke_in_place(tflite_wrapper_t* wrapper);
+
 /**
  * @brief Destroy TFLite wrapper
  * 
+ * Group members are destroyed with their group; passing one here is a no-op.
+ * 
  * @param wrapper TFLite wrapper
  */
 void tflite_wrapper_destroy(tflite_wrapper_t* wrapper);
 
+/**
+ * @brief Create interpreters for several models in one shared tensor arena
+ * 
+ * Each model keeps its own persistent allocations, but all share one
+ * scratch region planned for the largest, so the arena costs the biggest
+ * model's activations plus everyone's bookkeeping instead of the sum of
+ * separate arenas. Members must therefore run one at a time, from one
+ * task, and a member's input and output tensors only hold its data from
+ * filling the input until the next member runs: fill, invoke, read the
+ * output, then move on.
+ * 
+ * Sizing follows config as for a single wrapper; with persist_size the NVS
+ * key covers every model in the group.
+ * 
+ * @param models Model flatbuffers, kept by the caller for the group's lifetime
+ * @param model_sizes Size of each model in bytes
+ * @param count Number of models, 1 to TFLITE_WRAPPER_GROUP_MAX
+ * @param config Arena options; arena_size bounds the whole group
+ * @return Group handle or NULL on error
+ */
+tflite_wrapper_group_t* tflite_wrapper_group_create(const uint8_t* const* models,
+                                                    const size_t* model_sizes,
+                                                    size_t count,
+                                                    const tflite_wrapper_config_t* config);
+
+/**
+ * @brief Interpreter for models[index] of the group
+ * 
+ * @return Wrapper owned by the group, or NULL for a bad index
+ */
+tflite_wrapper_t* tflite_wrapper_group_member(tflite_wrapper_group_t* group, size_t index);
+
+/**
+ * @brief Get the shared arena's usage
+ * 
+ * @param group Group handle
+ * @param used_out Optional, bytes used by all members together
+ * @param allocated_out Optional, bytes allocated for the arena
+ * @return ESP_OK on success
+ */
+esp_err_t tflite_wrapper_group_get_arena_usage(tflite_wrapper_group_t* group,
+                                               size_t* used_out,
+                                               size_t* allocated_out);
+
+/**
+ * @brief Destroy every member and free the shared arena
+ * 
+ * @param group Group handle
+ */
+void tflite_wrapper_group_destroy(tflite_wrapper_group_t* group);
+
 /**
  * @brief Get input tensor size
  * 
  * @param wrapper TFLite wrapper
- * @return Input size in floats
+ * @return Input size in elements
  */
 size_t tflite_wrapper_get_input_size(tflite_wrapper_t* wrapper);
 
@@ -58,7 +238,7 @@ size_t tflite_wrapper_get_input_size(tflite_wrapper_t* wrapper);
  * @brief Get output tensor size
  * 
  * @param wrapper TFLite wrapper
- * @return Output size in floats
+ * @return Output size in elements
  */
 size_t tflite_wrapper_get_output_size(tflite_wrapper_t* wrapper);
 
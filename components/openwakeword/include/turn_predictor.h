@@ -0,0 +1,107 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "audio_features.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * End-of-turn prediction for early endpointing. A VAD gate has to wait out
+ * a long hangover because a pause inside a sentence looks like its end;
+ * this scores, at each pause, how likely it is that the talker is done, so
+ * the gate can close a finished turn after a short silence and keep the
+ * full hangover for pauses that are not.
+ *
+ * The cues are prosodic, tracked over the utterance's audio: the F0 contour
+ * (a final fall ends a statement, a long level stretch is a filled pause),
+ * the energy decay from the utterance's peak, the voiced share and the
+ * trailing silence, plus an optional hint from partial transcripts (final
+ * punctuation, or a trailing conjunction or filler). With a model, a mel
+ * window over the last TURN_PREDICTOR_MEL_FRAMES rows and the prosody
+ * vector are its input and its single output is the score; without one a
+ * fixed weighting of the same cues stands in.
+ *
+ * Audio comes from one task; turn_predictor_set_partial() may be called
+ * from any.
+ */
+
+/** Mel rows (10 ms each) in the model input, oldest first */
+#define TURN_PREDICTOR_MEL_FRAMES 50
+
+/** Prosody features after the mel window, see turn_predictor_feature_t */
+#define TURN_PREDICTOR_PROSODY_FEATURES 8
+
+/** Model input length in floats */
+#define TURN_PREDICTOR_INPUT_SIZE (TURN_PREDICTOR_MEL_FRAMES * AUDIO_FEATURES_N_MELS + TURN_PREDICTOR_PROSODY_FEATURES)
+
+/** Order of the prosody features in the model input */
+typedef enum {
+    TURN_PREDICTOR_F0_SLOPE = 0,      ///< Recent F0 slope, semitones/s / 20, clipped to +-1
+    TURN_PREDICTOR_F0_FINAL,          ///< Last voiced F0 against the utterance mean, semitones / 12
+    TURN_PREDICTOR_ENERGY_DECAY,      ///< Last voiced level under the utterance peak, dB / 30 (<= 0)
+    TURN_PREDICTOR_VOICED_SHARE,      ///< Voiced frames over speech frames
+    TURN_PREDICTOR_UTTERANCE_S,       ///< Utterance length, s / 10
+    TURN_PREDICTOR_SILENCE_S,         ///< Trailing silence, s
+    TURN_PREDICTOR_LEVEL_RUN_S,       ///< Level F0 at the end (a held "uhm"), s
+    TURN_PREDICTOR_TEXT_HINT,         ///< 1 complete, -1 incomplete, 0 unknown or no transcript
+} turn_predictor_feature_t;
+
+typedef struct {
+    uint32_t sample_rate;        ///< Hz (default 16000)
+    const uint8_t *model_data;   ///< NULL: the fixed weighting only
+    size_t model_size;
+    size_t arena_size;           ///< Tensor arena for the model (default 48 KB)
+    float threshold;             ///< Score at which the turn is taken as complete (default 0.7)
+    uint32_t min_silence_ms;     ///< Never end on less trailing silence (default 200)
+    uint32_t min_utterance_ms;   ///< Nor an utterance shorter than this (default 500)
+} turn_predictor_config_t;
+
+typedef struct turn_predictor turn_predictor_t;
+
+/**
+ * @brief Allocate a predictor; NULL config takes the defaults
+ *
+ * A model that fails to load is logged and the fixed weighting used.
+ */
+turn_predictor_t *turn_predictor_create(const turn_predictor_config_t *config);
+void turn_predictor_destroy(turn_predictor_t *predictor);
+
+/**
+ * @brief Start a new utterance: clears the audio, the cues and the text hint
+ */
+void turn_predictor_begin(turn_predictor_t *predictor);
+
+/**
+ * @brief Feed one frame of the utterance, mono, with the VAD's speech vote
+ *
+ * The mel and prosody analysis run on the caller; the model, when there is
+ * one, every 80 ms of audio.
+ */
+void turn_predictor_push(turn_predictor_t *predictor, const int16_t *samples, size_t count, bool speech);
+
+/**
+ * @brief Latest partial transcript of the current utterance (whole text so far)
+ */
+void turn_predictor_set_partial(turn_predictor_t *predictor, const char *text);
+
+/**
+ * @brief Decide at a pause whether the turn is over
+ *
+ * @param silence_ms Trailing silence as the caller's VAD counts it
+ * @return true to end the utterance now instead of after the hangover
+ */
+bool turn_predictor_should_end(turn_predictor_t *predictor, uint32_t silence_ms);
+
+/**
+ * @brief Score of the last should_end() decision, 0-1
+ */
+float turn_predictor_score(const turn_predictor_t *predictor);
+
+#ifdef __cplusplus
+}
+#endif
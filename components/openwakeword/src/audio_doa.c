@@ -0,0 +1,278 @@
+/**
+ * @file audio_doa.c
+ * @brief Talker direction from the mic pair by GCC-PHAT
+ *
+ * Both channels share one complex FFT per window: with z = left + j*right,
+ * the two real spectra fall out of Z[k] and Z[N-k]. Only the phase of the
+ * cross-spectrum is kept (PHAT), so every bin votes equally whatever its
+ * level, and the steered response is summed straight from the bins at each
+ * grid angle instead of going back through an inverse FFT.
+ */
+
+#include "audio_doa.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "audio_features.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static const char *TAG = "audio_doa";
+
+#define DOA_HOP (AUDIO_DOA_WINDOW / 2)
+#define DOA_SPEED_OF_SOUND 343.0f
+// Voice band; the top is lowered further where the pair would alias
+#define DOA_BAND_LOW_HZ 300.0f
+#define DOA_BAND_HIGH_HZ 4000.0f
+// Steering grid from -90 to +90 degrees
+#define DOA_GRID_STEP_DEG 5
+#define DOA_GRID_POINTS (180 / DOA_GRID_STEP_DEG + 1)
+// An utterance needs this many speech windows (~120 ms) for its own angle
+#define DOA_MIN_UTTERANCE_WINDOWS 15
+// Windows with less band energy than this are digital silence
+#define DOA_MIN_ENERGY 1e-9f
+
+struct audio_doa {
+    uint32_t sample_rate;
+    int bin_low;
+    int bin_count;
+    float smoothing;              // EMA coefficient per hop
+    float window[AUDIO_DOA_WINDOW];
+    // Per grid angle: the phase step between bins and the phase at bin_low, as cos/sin
+    float step_cos[DOA_GRID_POINTS];
+    float step_sin[DOA_GRID_POINTS];
+    float start_cos[DOA_GRID_POINTS];
+    float start_sin[DOA_GRID_POINTS];
+
+    // Audio task only
+    int16_t pcm[2 * AUDIO_DOA_WINDOW];   // Interleaved stereo, oldest first
+    size_t fill;                  // Frames in pcm
+    float fft[2 * AUDIO_DOA_WINDOW];
+    float cross[AUDIO_DOA_WINDOW];       // bin_count complex, this window's PHAT cross-spectrum
+    float smooth[AUDIO_DOA_WINDOW];      // bin_count complex, running PHAT cross-spectrum
+    float utterance[AUDIO_DOA_WINDOW];   // bin_count complex, summed over the utterance
+    float smooth_weight;          // EMA bias correction: 1 - (1 - smoothing)^windows
+    uint32_t utterance_windows;
+    bool in_speech;
+
+    // Published to readers under lock
+    portMUX_TYPE lock;
+    audio_doa_estimate_t estimate;
+};
+
+// Steered response of a cross-spectrum: the angle whose delay best lines up
+// the bins' phases, refined between grid points, and how well they line up
+static void doa_steer(const audio_doa_t *doa, const float *cross, float weight, float *angle_deg, float *confidence)
+{
+    float response[DOA_GRID_POINTS];
+    int best = 0;
+    for (int a = 0; a < DOA_GRID_POINTS; a++) {
+        float c = doa->start_cos[a];
+        float s = doa->start_sin[a];
+        float sum = 0.0f;
+        for (int k = 0; k < doa->bin_count; k++) {
+            // Re(G[k] * e^{j*phase}); then advance the phase by one bin
+            sum += cross[2 * k] * c - cross[2 * k + 1] * s;
+            float next = c * doa->step_cos[a] - s * doa->step_sin[a];
+            s = c * doa->step_sin[a] + s * doa->step_cos[a];
+            c = next;
+        }
+        response[a] = sum;
+        if (sum > response[best]) {
+            best = a;
+        }
+    }
+
+    float offset = 0.0f;
+    if (best > 0 && best < DOA_GRID_POINTS - 1) {
+        float left = response[best - 1];
+        float right = response[best + 1];
+        float curve = left - 2.0f * response[best] + right;
+        if (curve < 0.0f) {
+            offset = 0.5f * (left - right) / curve;
+            offset = offset < -0.5f ? -0.5f : offset > 0.5f ? 0.5f : offset;
+        }
+    }
+    *angle_deg = ((float)best + offset) * DOA_GRID_STEP_DEG - 90.0f;
+    float norm = weight * (float)doa->bin_count;
+    float conf = norm > 0.0f ? response[best] / norm : 0.0f;
+    *confidence = conf < 0.0f ? 0.0f : conf > 1.0f ? 1.0f : conf;
+}
+
+static void doa_process_window(audio_doa_t *doa)
+{
+    for (int i = 0; i < AUDIO_DOA_WINDOW; i++) {
+        doa->fft[2 * i] = (float)doa->pcm[2 * i] / 32768.0f * doa->window[i];
+        doa->fft[2 * i + 1] = (float)doa->pcm[2 * i + 1] / 32768.0f * doa->window[i];
+    }
+    if (audio_features_fft(doa->fft, AUDIO_DOA_WINDOW) != ESP_OK) {
+        return;
+    }
+
+    float *cross = doa->cross;
+    float energy = 0.0f;
+    for (int i = 0; i < doa->bin_count; i++) {
+        int k = doa->bin_low + i;
+        int m = AUDIO_DOA_WINDOW - k;
+        float zr_k = doa->fft[2 * k], zi_k = doa->fft[2 * k + 1];
+        float zr_m = doa->fft[2 * m], zi_m = doa->fft[2 * m + 1];
+        // Left = (Z[k] + conj(Z[N-k])) / 2, right = (Z[k] - conj(Z[N-k])) / 2j
+        float lr = 0.5f * (zr_k + zr_m);
+        float li = 0.5f * (zi_k - zi_m);
+        float rr = 0.5f * (zi_k + zi_m);
+        float ri = -0.5f * (zr_k - zr_m);
+        float gr = lr * rr + li * ri;
+        float gi = li * rr - lr * ri;
+        float mag = sqrtf(gr * gr + gi * gi);
+        energy += lr * lr + li * li + rr * rr + ri * ri;
+        cross[2 * i] = mag > 0.0f ? gr / mag : 0.0f;
+        cross[2 * i + 1] = mag > 0.0f ? gi / mag : 0.0f;
+    }
+    if (energy < DOA_MIN_ENERGY) {
+        return;
+    }
+
+    for (int i = 0; i < 2 * doa->bin_count; i++) {
+        doa->smooth[i] += doa->smoothing * (cross[i] - doa->smooth[i]);
+        doa->utterance[i] += cross[i];
+    }
+    doa->smooth_weight += doa->smoothing * (1.0f - doa->smooth_weight);
+    doa->utterance_windows++;
+
+    float angle, confidence;
+    doa_steer(doa, doa->smooth, doa->smooth_weight, &angle, &confidence);
+    portENTER_CRITICAL(&doa->lock);
+    doa->estimate.angle_deg = angle;
+    doa->estimate.confidence = confidence;
+    doa->estimate.active = true;
+    portEXIT_CRITICAL(&doa->lock);
+}
+
+audio_doa_t *audio_doa_create(const audio_doa_config_t *config)
+{
+    if (audio_features_fft_init() != ESP_OK) {
+        return NULL;
+    }
+    audio_doa_t *doa = calloc(1, sizeof(audio_doa_t));
+    if (!doa) {
+        return NULL;
+    }
+
+    doa->sample_rate = config && config->sample_rate ? config->sample_rate : 16000;
+    float spacing_m = (config && config->mic_spacing_mm ? config->mic_spacing_mm : 65) / 1000.0f;
+    float smoothing_ms = config && config->smoothing_ms ? config->smoothing_ms : 300;
+    float hop_ms = 1000.0f * DOA_HOP / (float)doa->sample_rate;
+    doa->smoothing = 1.0f - expf(-hop_ms / smoothing_ms);
+
+    // Above c / 2d a full cycle fits in the pair's delay and bins stop voting for one angle
+    float bin_hz = (float)doa->sample_rate / AUDIO_DOA_WINDOW;
+    float high_hz = fminf(DOA_BAND_HIGH_HZ, DOA_SPEED_OF_SOUND / (2.0f * spacing_m));
+    int low = (int)ceilf(DOA_BAND_LOW_HZ / bin_hz);
+    int high = (int)floorf(high_hz / bin_hz);
+    low = low < 1 ? 1 : low;
+    high = high > AUDIO_DOA_WINDOW / 2 - 1 ? AUDIO_DOA_WINDOW / 2 - 1 : high;
+    if (high < low) {
+        high = low;
+    }
+    doa->bin_low = low;
+    doa->bin_count = high - low + 1;
+
+    for (int i = 0; i < AUDIO_DOA_WINDOW; i++) {
+        doa->window[i] = 0.5f * (1.0f - cosf(2.0f * M_PI * i / (AUDIO_DOA_WINDOW - 1)));
+    }
+    // A talker at +theta reaches channel 1 first, by d*sin(theta)/c: the
+    // cross-spectrum of left against right turns by -omega*delay, so steer back
+    for (int a = 0; a < DOA_GRID_POINTS; a++) {
+        float theta = (float)(a * DOA_GRID_STEP_DEG - 90) * (float)M_PI / 180.0f;
+        float delay_s = spacing_m * sinf(theta) / DOA_SPEED_OF_SOUND;
+        float step = 2.0f * (float)M_PI * bin_hz * delay_s;
+        doa->step_cos[a] = cosf(step);
+        doa->step_sin[a] = sinf(step);
+        doa->start_cos[a] = cosf(step * (float)low);
+        doa->start_sin[a] = sinf(step * (float)low);
+    }
+    portMUX_INITIALIZE(&doa->lock);
+
+    ESP_LOGI(TAG, "%.0f mm pair, bins %d-%d (%.0f-%.0f Hz), %d-point grid",
+             spacing_m * 1000.0f, low, high, low * bin_hz, high * bin_hz, DOA_GRID_POINTS);
+    return doa;
+}
+
+void audio_doa_destroy(audio_doa_t *doa)
+{
+    free(doa);
+}
+
+void audio_doa_push(audio_doa_t *doa, const int16_t *stereo, size_t samples)
+{
+    if (!doa || !stereo) {
+        return;
+    }
+    size_t frames = samples / 2;
+    while (frames > 0) {
+        size_t take = AUDIO_DOA_WINDOW - doa->fill;
+        if (take > frames) {
+            take = frames;
+        }
+        memcpy(&doa->pcm[2 * doa->fill], stereo, take * 2 * sizeof(int16_t));
+        doa->fill += take;
+        stereo += 2 * take;
+        frames -= take;
+        if (doa->fill < AUDIO_DOA_WINDOW) {
+            break;
+        }
+        if (doa->in_speech) {
+            doa_process_window(doa);
+        }
+        memmove(doa->pcm, &doa->pcm[2 * DOA_HOP], 2 * (AUDIO_DOA_WINDOW - DOA_HOP) * sizeof(int16_t));
+        doa->fill = AUDIO_DOA_WINDOW - DOA_HOP;
+    }
+}
+
+bool audio_doa_set_speech(audio_doa_t *doa, bool in_speech)
+{
+    if (!doa || in_speech == doa->in_speech) {
+        return false;
+    }
+    doa->in_speech = in_speech;
+    if (in_speech) {
+        memset(doa->smooth, 0, sizeof(doa->smooth));
+        memset(doa->utterance, 0, sizeof(doa->utterance));
+        doa->smooth_weight = 0.0f;
+        doa->utterance_windows = 0;
+        return false;
+    }
+
+    bool enough = doa->utterance_windows >= DOA_MIN_UTTERANCE_WINDOWS;
+    float angle = 0.0f, confidence = 0.0f;
+    if (enough) {
+        doa_steer(doa, doa->utterance, (float)doa->utterance_windows, &angle, &confidence);
+    }
+    portENTER_CRITICAL(&doa->lock);
+    doa->estimate.active = false;
+    if (enough) {
+        doa->estimate.utterance_deg = angle;
+        doa->estimate.utterance_confidence = confidence;
+        doa->estimate.utterances++;
+    }
+    portEXIT_CRITICAL(&doa->lock);
+    if (enough) {
+        ESP_LOGD(TAG, "Utterance from %.0f deg (confidence %.2f, %u windows)",
+                 angle, confidence, (unsigned)doa->utterance_windows);
+    }
+    return enough;
+}
+
+void audio_doa_read(audio_doa_t *doa, audio_doa_estimate_t *out)
+{
+    if (!doa || !out) {
+        return;
+    }
+    portENTER_CRITICAL(&doa->lock);
+    *out = doa->estimate;
+    portEXIT_CRITICAL(&doa->lock);
+}
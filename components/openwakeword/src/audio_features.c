@@ -21,18 +21,33 @@
 // ESP-DSP for FFT (optional, fallback to simple implementation if not available)
 #ifdef CONFIG_DSP_ENABLED
 #include "dsps_fft2r.h"
+#include "dsps_dotprod.h"
 #include "dsp_err.h"
 #define USE_ESP_DSP_FFT 1
 #else
 #define USE_ESP_DSP_FFT 0
 #endif
 
+// Frontend FFT mode (Kconfig "Melspectrogram FFT mode"). Real-input is the
+// default; fixed-point needs ESP-DSP's sc16 kernels and falls back to the
+// float real-input path without them.
+#if defined(CONFIG_OPENWAKEWORD_FFT_FIXED16) && USE_ESP_DSP_FFT
+#define FRONTEND_FIXED16 1
+#define FRONTEND_REAL 1
+#elif defined(CONFIG_OPENWAKEWORD_FFT_COMPLEX)
+#define FRONTEND_FIXED16 0
+#define FRONTEND_REAL 0
+#else
+#define FRONTEND_FIXED16 0
+#define FRONTEND_REAL 1
+#endif
+
 static const char *TAG = "audio_features";
 
 // Melspectrogram parameters (matching OpenWakeWord defaults)
-#define MELSPEC_N_MELS 40
+#define MELSPEC_N_MELS AUDIO_FEATURES_N_MELS
 #define MELSPEC_N_FFT 512
-#define MELSPEC_HOP_LENGTH 160
+#define MELSPEC_HOP_LENGTH AUDIO_FEATURES_HOP_LENGTH
 #define MELSPEC_FMIN 0
 #define MELSPEC_FMAX 8000
 #define MELSPEC_SAMPLE_RATE 16000
@@ -41,6 +56,13 @@ static const char *TAG = "audio_features";
 #define HZ_TO_MEL(hz) (2595.0 * log10(1.0 + (hz) / 700.0))
 #define MEL_TO_HZ(mel) (700.0 * (pow(10, (mel) / 2595.0) - 1.0))
 
+// One triangular mel filter stored as its non-zero run of FFT bins
+typedef struct {
+    uint16_t start_bin;           // First bin with non-zero weight
+    uint16_t length;              // Number of consecutive non-zero bins
+    const float *weights;         // length weights, points into mel_weights
+} mel_span_t;
+
 struct audio_features {
     uint32_t sample_rate;
     float *melspectrogram_buffer;
@@ -48,12 +70,36 @@ struct audio_features {
     
     // FFT buffers
     float *fft_buffer;           // Complex FFT input/output [Re, Im, Re, Im, ...]
-    float *magnitude_buffer;      // FFT magnitude spectrum
-    float *mel_filter_bank;       // Pre-computed mel filter bank
+    float *magnitude_buffer;      // FFT magnitude (power in fixed-point mode)
+#if FRONTEND_REAL
+    float *split_cos;             // Real-FFT split twiddles, N/2 + 1 entries
+    float *split_sin;
+#endif
+#if FRONTEND_FIXED16
+    int16_t *fft_sc16;            // N/2 complex int16 [Re, Im, ...]
+    int16_t *window_q15;          // Hanning window in Q15
+#endif
+    mel_span_t mel_spans[MELSPEC_N_MELS];  // Sparse mel filter bank
+    float *mel_weights;           // Packed weights for all spans
+    size_t mel_weight_count;
     bool fft_initialized;
     
     // Window function (Hanning)
     float *window;
+    
+    // Streaming state: overlap ring of the last N_FFT samples
+    int16_t *sample_ring;
+    size_t ring_pos;              // Next write index (oldest sample once full)
+    size_t ring_fill;             // Valid samples, saturates at N_FFT
+    size_t hop_fill;              // New samples since the last emitted row
+    
+    // Rolling spectrogram window: WINDOW_FRAMES x N_MELS rows, circular
+    float *window_rows;
+    size_t row_head;              // Next row slot
+    size_t row_count;             // Valid rows, saturates at WINDOW_FRAMES
+    uint32_t total_rows;
+    audio_features_row_cb_t row_cb;
+    void *row_cb_ctx;
 };
 
 // Generate Hanning window
@@ -64,12 +110,26 @@ static void generate_hanning_window(float *window, int size)
     }
 }
 
-// Generate mel filter bank
-static esp_err_t generate_mel_filter_bank(float *filter_bank, uint32_t sample_rate, int n_fft, int n_mels)
+static float mel_triangle_weight(float freq, float left, float center, float right)
+{
+    if (freq >= left && freq <= center) {
+        return (freq - left) / (center - left);
+    } else if (freq > center && freq <= right) {
+        return (right - freq) / (right - center);
+    }
+    return 0.0f;
+}
+
+// Generate mel filter bank as sparse (start_bin, length, weights) spans.
+// Each triangle only covers a handful of bins, so the packed form is a few
+// hundred floats instead of the dense n_mels x (n_fft/2+1) matrix.
+static esp_err_t generate_mel_filter_bank(audio_features_t *features, uint32_t sample_rate,
+                                          int n_fft, int n_mels)
 {
     float mel_max = HZ_TO_MEL(sample_rate / 2.0f);
     float mel_min = HZ_TO_MEL(MELSPEC_FMIN);
     float mel_spacing = (mel_max - mel_min) / (n_mels + 1);
+    int n_bins = n_fft / 2 + 1;
     
     // Generate mel center frequencies
     float *mel_centers = malloc((n_mels + 2) * sizeof(float));
@@ -81,42 +141,44 @@ static esp_err_t generate_mel_filter_bank(float *filter_bank, uint32_t sample_ra
         mel_centers[i] = MEL_TO_HZ(mel_min + i * mel_spacing);
     }
     
-    // Convert to FFT bin frequencies
-    float *fft_freqs = malloc((n_fft / 2 + 1) * sizeof(float));
-    if (!fft_freqs) {
-        free(mel_centers);
-        return ESP_ERR_NO_MEM;
+    // Pass 1: find the non-zero run of each triangle
+    size_t total = 0;
+    for (int i = 0; i < n_mels; i++) {
+        int first = -1;
+        int last = -1;
+        for (int j = 0; j < n_bins; j++) {
+            float freq = (float)j * sample_rate / n_fft;
+            if (mel_triangle_weight(freq, mel_centers[i], mel_centers[i + 1],
+                                    mel_centers[i + 2]) > 0.0f) {
+                if (first < 0) first = j;
+                last = j;
+            }
+        }
+        features->mel_spans[i].start_bin = (first < 0) ? 0 : (uint16_t)first;
+        features->mel_spans[i].length = (first < 0) ? 0 : (uint16_t)(last - first + 1);
+        total += features->mel_spans[i].length;
     }
     
-    for (int i = 0; i <= n_fft / 2; i++) {
-        fft_freqs[i] = (float)i * sample_rate / n_fft;
+    // Pass 2: pack the weights contiguously
+    features->mel_weights = malloc((total > 0 ? total : 1) * sizeof(float));
+    if (!features->mel_weights) {
+        free(mel_centers);
+        return ESP_ERR_NO_MEM;
     }
+    features->mel_weight_count = total;
     
-    // Generate triangular filters
-    int filter_size = n_mels * (n_fft / 2 + 1);
-    memset(filter_bank, 0, filter_size * sizeof(float));
-    
+    float *w = features->mel_weights;
     for (int i = 0; i < n_mels; i++) {
-        float left = mel_centers[i];
-        float center = mel_centers[i + 1];
-        float right = mel_centers[i + 2];
-        
-        for (int j = 0; j <= n_fft / 2; j++) {
-            float freq = fft_freqs[j];
-            float weight = 0.0f;
-            
-            if (freq >= left && freq <= center) {
-                weight = (freq - left) / (center - left);
-            } else if (freq > center && freq <= right) {
-                weight = (right - freq) / (right - center);
-            }
-            
-            filter_bank[i * (n_fft / 2 + 1) + j] = weight;
+        mel_span_t *span = &features->mel_spans[i];
+        span->weights = w;
+        for (int k = 0; k < span->length; k++) {
+            float freq = (float)(span->start_bin + k) * sample_rate / n_fft;
+            *w++ = mel_triangle_weight(freq, mel_centers[i], mel_centers[i + 1],
+                                       mel_centers[i + 2]);
         }
     }
     
     free(mel_centers);
-    free(fft_freqs);
     return ESP_OK;
 }
 
@@ -170,6 +232,82 @@ static void simple_fft(float *data, int n, int is_inverse)
     free(imag);
 }
 
+#if USE_ESP_DSP_FFT
+// ESP-DSP keeps one twiddle table per kernel type for the whole process, used
+// by every extractor, audio_features_fft() and audio_doa.c alike. Each is set
+// up once at AUDIO_FEATURES_FFT_MAX, which serves every smaller power of two,
+// and never freed: one extractor's deinit must not pull it from the others.
+_Static_assert(MELSPEC_N_FFT <= AUDIO_FEATURES_FFT_MAX, "frontend FFT outgrows the shared table");
+static bool s_fc32_table_ready;
+
+static esp_err_t fft_table_init_fc32(void)
+{
+    if (!s_fc32_table_ready) {
+        esp_err_t err = dsps_fft2r_init_fc32(NULL, AUDIO_FEATURES_FFT_MAX);
+        if (err != ESP_OK) {
+            return err;
+        }
+        s_fc32_table_ready = true;
+    }
+    return ESP_OK;
+}
+
+#if FRONTEND_FIXED16
+static bool s_sc16_table_ready;
+
+static esp_err_t fft_table_init_sc16(void)
+{
+    if (!s_sc16_table_ready) {
+        esp_err_t err = dsps_fft2r_init_sc16(NULL, AUDIO_FEATURES_FFT_MAX);
+        if (err != ESP_OK) {
+            return err;
+        }
+        s_sc16_table_ready = true;
+    }
+    return ESP_OK;
+}
+#endif
+#endif
+
+static bool s_shared_fft_ready;
+
+esp_err_t audio_features_fft_init(void)
+{
+#if USE_ESP_DSP_FFT
+    esp_err_t err = fft_table_init_fc32();
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Shared FFT init failed: %d", err);
+        return err;
+    }
+#endif
+    s_shared_fft_ready = true;
+    return ESP_OK;
+}
+
+esp_err_t audio_features_fft(float *data, size_t n)
+{
+    if (!data || n < 2 || n > AUDIO_FEATURES_FFT_MAX || (n & (n - 1)) != 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!s_shared_fft_ready) {
+        return ESP_ERR_INVALID_STATE;
+    }
+#if USE_ESP_DSP_FFT
+    #ifdef CONFIG_IDF_TARGET_ESP32S3
+    esp_err_t err = dsps_fft2r_fc32_aes3(data, (int)n);
+    #else
+    esp_err_t err = dsps_fft2r_fc32_ansi(data, (int)n);
+    #endif
+    if (err != ESP_OK) {
+        return err;
+    }
+    dsps_bit_rev_fc32(data, (int)n);
+#else
+    simple_fft(data, (int)n, 0);
+#endif
+    return ESP_OK;
+}
+
 audio_features_t *audio_features_init(uint32_t sample_rate)
 {
     audio_features_t *features = calloc(1, sizeof(audio_features_t));
@@ -184,26 +322,55 @@ audio_features_t *audio_features_init(uint32_t sample_rate)
     features->melspectrogram_size = MELSPEC_N_MELS;
     features->melspectrogram_buffer = malloc(features->melspectrogram_size * sizeof(float));
     
-    // FFT buffer: complex numbers [Re, Im, Re, Im, ...]
+    // FFT buffer: complex numbers [Re, Im, Re, Im, ...]. Real-input mode
+    // packs N real samples as N/2 complex values, so half the size is enough.
+#if FRONTEND_REAL
+    features->fft_buffer = malloc(MELSPEC_N_FFT * sizeof(float));
+    features->split_cos = malloc((MELSPEC_N_FFT / 2 + 1) * sizeof(float));
+    features->split_sin = malloc((MELSPEC_N_FFT / 2 + 1) * sizeof(float));
+    if (!features->split_cos || !features->split_sin) {
+        audio_features_deinit(features);
+        return NULL;
+    }
+    for (int k = 0; k <= MELSPEC_N_FFT / 2; k++) {
+        features->split_cos[k] = cosf(2.0f * M_PI * k / MELSPEC_N_FFT);
+        features->split_sin[k] = sinf(2.0f * M_PI * k / MELSPEC_N_FFT);
+    }
+#else
     features->fft_buffer = malloc(MELSPEC_N_FFT * 2 * sizeof(float));
+#endif
+#if FRONTEND_FIXED16
+    features->fft_sc16 = malloc(MELSPEC_N_FFT * sizeof(int16_t));
+    features->window_q15 = malloc(MELSPEC_N_FFT * sizeof(int16_t));
+    if (!features->fft_sc16 || !features->window_q15) {
+        audio_features_deinit(features);
+        return NULL;
+    }
+#endif
     features->magnitude_buffer = malloc(n_fft_bins * sizeof(float));
     features->window = malloc(MELSPEC_N_FFT * sizeof(float));
     
-    // Mel filter bank: n_mels x n_fft_bins
-    int filter_bank_size = MELSPEC_N_MELS * n_fft_bins;
-    features->mel_filter_bank = malloc(filter_bank_size * sizeof(float));
+    // Streaming buffers
+    features->sample_ring = calloc(MELSPEC_N_FFT, sizeof(int16_t));
+    features->window_rows = calloc(AUDIO_FEATURES_WINDOW_FRAMES * MELSPEC_N_MELS, sizeof(float));
     
     if (!features->melspectrogram_buffer || !features->fft_buffer || 
-        !features->magnitude_buffer || !features->window || !features->mel_filter_bank) {
+        !features->magnitude_buffer || !features->window ||
+        !features->sample_ring || !features->window_rows) {
         audio_features_deinit(features);
         return NULL;
     }
     
     // Initialize window function
     generate_hanning_window(features->window, MELSPEC_N_FFT);
+#if FRONTEND_FIXED16
+    for (int i = 0; i < MELSPEC_N_FFT; i++) {
+        features->window_q15[i] = (int16_t)(features->window[i] * 32767.0f);
+    }
+#endif
     
     // Initialize mel filter bank
-    esp_err_t err = generate_mel_filter_bank(features->mel_filter_bank, sample_rate, 
+    esp_err_t err = generate_mel_filter_bank(features, sample_rate,
                                               MELSPEC_N_FFT, MELSPEC_N_MELS);
     if (err != ESP_OK) {
         ESP_LOGE(TAG, "Failed to generate mel filter bank");
@@ -211,14 +378,23 @@ audio_features_t *audio_features_init(uint32_t sample_rate)
         return NULL;
     }
     
-#if USE_ESP_DSP_FFT
-    // Initialize ESP-DSP FFT
-    err = dsps_fft2r_init_fc32(NULL, MELSPEC_N_FFT);
+#if FRONTEND_FIXED16
+    // The sc16 kernel is the only transform this mode has; no fallback
+    err = fft_table_init_sc16();
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "ESP-DSP sc16 FFT init failed: %d", err);
+        audio_features_deinit(features);
+        return NULL;
+    }
+    features->fft_initialized = true;
+    ESP_LOGI(TAG, "Using ESP-DSP FFT");
+#elif USE_ESP_DSP_FFT
+    err = fft_table_init_fc32();
     if (err == ESP_OK) {
         features->fft_initialized = true;
         ESP_LOGI(TAG, "Using ESP-DSP FFT");
     } else {
-        ESP_LOGW(TAG, "ESP-DSP FFT init failed, using fallback");
+        ESP_LOGW(TAG, "ESP-DSP FFT init failed, using simple FFT fallback");
         features->fft_initialized = false;
     }
 #else
@@ -229,78 +405,195 @@ audio_features_t *audio_features_init(uint32_t sample_rate)
     ESP_LOGI(TAG, "Initialized audio features extractor");
     ESP_LOGI(TAG, "  Sample rate: %u Hz", (unsigned int)sample_rate);
     ESP_LOGI(TAG, "  N_FFT: %d, N_MELS: %d", MELSPEC_N_FFT, MELSPEC_N_MELS);
+    ESP_LOGI(TAG, "  FFT mode: %s", FRONTEND_FIXED16 ? "fixed-point sc16 real-input" :
+                                   FRONTEND_REAL ? "float real-input" : "float complex");
     ESP_LOGI(TAG, "  Melspectrogram size: %zu", features->melspectrogram_size);
+    ESP_LOGI(TAG, "  Mel filter bank: %zu sparse weights (dense would be %d)",
+             features->mel_weight_count, MELSPEC_N_MELS * n_fft_bins);
+    ESP_LOGI(TAG, "  Hop: %d samples, window: %d frames", MELSPEC_HOP_LENGTH, AUDIO_FEATURES_WINDOW_FRAMES);
     
     return features;
 }
 
-esp_err_t audio_features_extract_melspectrogram(audio_features_t *features,
-                                                  const int16_t *audio_samples,
-                                                  size_t sample_count,
-                                                  float *melspectrogram_out,
-                                                  size_t *melspectrogram_size_out)
+// Write one windowed input sample into the FFT staging buffer
+static inline void stage_sample(audio_features_t *features, size_t i, int16_t raw)
 {
-    if (!features || !audio_samples || !melspectrogram_out) {
-        return ESP_ERR_INVALID_ARG;
+#if FRONTEND_FIXED16
+    features->fft_sc16[i] = (int16_t)(((int32_t)raw * features->window_q15[i]) >> 15);
+#elif FRONTEND_REAL
+    // N real samples packed as N/2 complex: z[n] = x[2n] + j*x[2n+1]
+    features->fft_buffer[i] = ((float)raw / 32768.0f) * features->window[i];
+#else
+    features->fft_buffer[i * 2] = ((float)raw / 32768.0f) * features->window[i];
+    features->fft_buffer[i * 2 + 1] = 0.0f;
+#endif
+}
+
+#if FRONTEND_FIXED16
+// log2 approximation from the float exponent plus a quadratic on the
+// mantissa (max error ~5e-3), good enough ahead of a learned model.
+static inline float fast_log10f(float x)
+{
+    union { float f; uint32_t i; } v = { .f = x };
+    float log2 = (float)((int)((v.i >> 23) & 0xFF) - 128);
+    v.i = (v.i & 0x007FFFFF) | 0x3F800000;
+    log2 += (-0.34484843f * v.f + 2.02466578f) * v.f - 0.67487759f;
+    return log2 * 0.30102999566f;
+}
+#endif
+
+#if FRONTEND_REAL
+// Recover the N-point real spectrum from the N/2-point complex FFT of the
+// packed samples. z holds Z[0..M-1] interleaved, M = N/2. Writes magnitude
+// (or power) for bins 0..M into out.
+static void real_fft_split(const audio_features_t *features, const float *z,
+                           float *out, bool power)
+{
+    const int M = MELSPEC_N_FFT / 2;
+    for (int k = 0; k <= M; k++) {
+        int a = (k == M) ? 0 : k;
+        int b = (k == 0) ? 0 : (M - k);
+        float zr_k = z[a * 2], zi_k = z[a * 2 + 1];
+        float zr_m = z[b * 2], zi_m = z[b * 2 + 1];
+        
+        // Even/odd halves: E = (Z[k] + conj(Z[M-k]))/2, O = (Z[k] - conj(Z[M-k]))/2j
+        float er = 0.5f * (zr_k + zr_m);
+        float ei = 0.5f * (zi_k - zi_m);
+        float or_ = 0.5f * (zi_k + zi_m);
+        float oi = -0.5f * (zr_k - zr_m);
+        
+        // X[k] = E + W^k * O, W = exp(-j*2*pi/N)
+        float c = features->split_cos[k];
+        float sn = features->split_sin[k];
+        float xr = er + c * or_ + sn * oi;
+        float xi = ei + c * oi - sn * or_;
+        float p = xr * xr + xi * xi;
+        out[k] = power ? p : sqrtf(p);
     }
+}
+#endif
+
+// Run FFT -> magnitude -> mel filter bank -> log over the windowed frame
+// already staged by stage_sample().
+static esp_err_t compute_mel_row(audio_features_t *features, float *mel_out)
+{
+    int n_bins = MELSPEC_N_FFT / 2 + 1;
     
-    // Limit sample count to N_FFT
-    size_t samples_to_process = (sample_count > MELSPEC_N_FFT) ? MELSPEC_N_FFT : sample_count;
-    
-    // Step 1: Convert int16 to float and apply window
-    for (size_t i = 0; i < MELSPEC_N_FFT; i++) {
-        float sample = (i < samples_to_process) ? 
-                       ((float)audio_samples[i] / 32768.0f) : 0.0f;
-        // Apply Hanning window
-        sample *= features->window[i];
-        // Store as complex: real part = sample, imaginary part = 0
-        features->fft_buffer[i * 2] = sample;     // Real
-        features->fft_buffer[i * 2 + 1] = 0.0f;  // Imaginary
+#if FRONTEND_FIXED16
+    // Step 2/3: N/2-point sc16 FFT (scaled by 1/M per ESP-DSP), split, power
+    const int M = MELSPEC_N_FFT / 2;
+    esp_err_t err;
+    #ifdef CONFIG_IDF_TARGET_ESP32S3
+    err = dsps_fft2r_sc16_aes3(features->fft_sc16, M);
+    #else
+    err = dsps_fft2r_sc16_ansi(features->fft_sc16, M);
+    #endif
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "FFT computation failed");
+        return err;
     }
-    
+    dsps_bit_rev_sc16_ansi(features->fft_sc16, M);
+    for (int i = 0; i < MELSPEC_N_FFT; i++) {
+        features->fft_buffer[i] = (float)features->fft_sc16[i];
+    }
+    real_fft_split(features, features->fft_buffer, features->magnitude_buffer, true);
+#else
     // Step 2: Compute FFT
+#if FRONTEND_REAL
+    const int fft_n = MELSPEC_N_FFT / 2;
+#else
+    const int fft_n = MELSPEC_N_FFT;
+#endif
 #if USE_ESP_DSP_FFT
     if (features->fft_initialized) {
         // Use ESP-DSP optimized FFT
         #ifdef CONFIG_IDF_TARGET_ESP32S3
-        esp_err_t err = dsps_fft2r_fc32_aes3(features->fft_buffer, MELSPEC_N_FFT);
+        esp_err_t err = dsps_fft2r_fc32_aes3(features->fft_buffer, fft_n);
         #else
-        esp_err_t err = dsps_fft2r_fc32_ansi(features->fft_buffer, MELSPEC_N_FFT);
+        esp_err_t err = dsps_fft2r_fc32_ansi(features->fft_buffer, fft_n);
         #endif
         if (err != ESP_OK) {
             ESP_LOGE(TAG, "FFT computation failed");
             return err;
         }
+        // Radix-2 output is in bit-reversed order
+        dsps_bit_rev_fc32(features->fft_buffer, fft_n);
     } else {
-        simple_fft(features->fft_buffer, MELSPEC_N_FFT, 0);
+        simple_fft(features->fft_buffer, fft_n, 0);
     }
 #else
-    simple_fft(features->fft_buffer, MELSPEC_N_FFT, 0);
+    simple_fft(features->fft_buffer, fft_n, 0);
 #endif
     
     // Step 3: Compute magnitude spectrum
-    int n_bins = MELSPEC_N_FFT / 2 + 1;
+#if FRONTEND_REAL
+    real_fft_split(features, features->fft_buffer, features->magnitude_buffer, false);
+#else
     for (int i = 0; i < n_bins; i++) {
         float real = features->fft_buffer[i * 2];
         float imag = features->fft_buffer[i * 2 + 1];
         features->magnitude_buffer[i] = sqrtf(real * real + imag * imag);
     }
+#endif
+#endif // FRONTEND_FIXED16
+    (void)n_bins;
     
-    // Step 4: Apply mel filter bank
-    memset(melspectrogram_out, 0, MELSPEC_N_MELS * sizeof(float));
+    // Step 4: Apply mel filter bank (one short dot product per span)
     for (int mel = 0; mel < MELSPEC_N_MELS; mel++) {
+        const mel_span_t *span = &features->mel_spans[mel];
+        const float *mag = &features->magnitude_buffer[span->start_bin];
         float sum = 0.0f;
-        for (int bin = 0; bin < n_bins; bin++) {
-            float filter_weight = features->mel_filter_bank[mel * n_bins + bin];
-            sum += features->magnitude_buffer[bin] * filter_weight;
+#if USE_ESP_DSP_FFT
+        if (span->length > 0) {
+            dsps_dotprod_f32(mag, span->weights, &sum, span->length);
+        }
+#else
+        for (int k = 0; k < span->length; k++) {
+            sum += mag[k] * span->weights[k];
         }
-        melspectrogram_out[mel] = sum;
+#endif
+        mel_out[mel] = sum;
     }
     
     // Step 5: Take logarithm (log10 with small epsilon to avoid log(0))
+#if FRONTEND_FIXED16
+    // Power is in Q30 and scaled by 1/M^2 by the FFT; undo that in the log
+    // domain and halve so rows stay on the same scale as the magnitude path.
+    const float power_offset = log10f((float)M * (float)M / 1073741824.0f);
+    for (int i = 0; i < MELSPEC_N_MELS; i++) {
+        mel_out[i] = 0.5f * (fast_log10f(mel_out[i] + 1.0f) + power_offset);
+    }
+#else
     const float epsilon = 1e-10f;
     for (int i = 0; i < MELSPEC_N_MELS; i++) {
-        melspectrogram_out[i] = log10f(melspectrogram_out[i] + epsilon);
+        mel_out[i] = log10f(mel_out[i] + epsilon);
+    }
+#endif
+    
+    return ESP_OK;
+}
+
+esp_err_t audio_features_extract_melspectrogram(audio_features_t *features,
+                                                  const int16_t *audio_samples,
+                                                  size_t sample_count,
+                                                  float *melspectrogram_out,
+                                                  size_t *melspectrogram_size_out)
+{
+    if (!features || !audio_samples || !melspectrogram_out) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    // Limit sample count to N_FFT
+    size_t samples_to_process = (sample_count > MELSPEC_N_FFT) ? MELSPEC_N_FFT : sample_count;
+    
+    // Step 1: Apply Hanning window, zero-padding short input
+    for (size_t i = 0; i < MELSPEC_N_FFT; i++) {
+        stage_sample(features, i, (i < samples_to_process) ? audio_samples[i] : 0);
+    }
+    
+    esp_err_t err = compute_mel_row(features, melspectrogram_out);
+    if (err != ESP_OK) {
+        return err;
     }
     
     if (melspectrogram_size_out) {
@@ -310,23 +603,182 @@ esp_err_t audio_features_extract_melspectrogram(audio_features_t *features,
     return ESP_OK;
 }
 
-void audio_features_deinit(audio_features_t *features)
+// Window the last N_FFT samples of the overlap ring into the FFT buffer,
+// oldest sample first, without linearizing the ring.
+static void stage_ring_frame(audio_features_t *features)
+{
+    size_t src = features->ring_pos;
+    for (size_t i = 0; i < MELSPEC_N_FFT; i++) {
+        stage_sample(features, i, features->sample_ring[src]);
+        if (++src == MELSPEC_N_FFT) {
+            src = 0;
+        }
+    }
+}
+
+esp_err_t audio_features_stream_push(audio_features_t *features,
+                                     const int16_t *audio_samples,
+                                     size_t sample_count,
+                                     size_t *rows_emitted_out)
+{
+    if (rows_emitted_out) {
+        *rows_emitted_out = 0;
+    }
+    if (!features || (!audio_samples && sample_count > 0)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    size_t emitted = 0;
+    size_t consumed = 0;
+    while (consumed < sample_count) {
+        // Copy up to the next hop boundary (or ring wrap) in one go
+        size_t need = MELSPEC_HOP_LENGTH - features->hop_fill;
+        size_t to_wrap = MELSPEC_N_FFT - features->ring_pos;
+        size_t n = sample_count - consumed;
+        if (n > need) n = need;
+        if (n > to_wrap) n = to_wrap;
+        
+        memcpy(&features->sample_ring[features->ring_pos], &audio_samples[consumed],
+               n * sizeof(int16_t));
+        features->ring_pos = (features->ring_pos + n) % MELSPEC_N_FFT;
+        features->ring_fill += n;
+        if (features->ring_fill > MELSPEC_N_FFT) {
+            features->ring_fill = MELSPEC_N_FFT;
+        }
+        features->hop_fill += n;
+        consumed += n;
+        
+        if (features->hop_fill < MELSPEC_HOP_LENGTH) {
+            continue;
+        }
+        features->hop_fill = 0;
+        
+        // Wait for a full analysis frame before emitting the first row
+        if (features->ring_fill < MELSPEC_N_FFT) {
+            continue;
+        }
+        
+        stage_ring_frame(features);
+        float *row = &features->window_rows[features->row_head * MELSPEC_N_MELS];
+        esp_err_t err = compute_mel_row(features, row);
+        if (err != ESP_OK) {
+            if (rows_emitted_out) {
+                *rows_emitted_out = emitted;
+            }
+            return err;
+        }
+        
+        features->row_head = (features->row_head + 1) % AUDIO_FEATURES_WINDOW_FRAMES;
+        if (features->row_count < AUDIO_FEATURES_WINDOW_FRAMES) {
+            features->row_count++;
+        }
+        features->total_rows++;
+        emitted++;
+        if (features->row_cb) {
+            features->row_cb(row, features->row_cb_ctx);
+        }
+    }
+    
+    if (rows_emitted_out) {
+        *rows_emitted_out = emitted;
+    }
+    return ESP_OK;
+}
+
+void audio_features_stream_set_row_cb(audio_features_t *features,
+                                      audio_features_row_cb_t cb,
+                                      void *ctx)
 {
     if (!features) {
         return;
     }
+    features->row_cb = cb;
+    features->row_cb_ctx = ctx;
+}
+
+esp_err_t audio_features_stream_get_window(audio_features_t *features,
+                                           float *window_out,
+                                           size_t n_frames)
+{
+    if (!features || !window_out || n_frames == 0 ||
+        n_frames > AUDIO_FEATURES_WINDOW_FRAMES) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (features->row_count < n_frames) {
+        return ESP_ERR_NOT_FINISHED;
+    }
     
-#if USE_ESP_DSP_FFT
-    if (features->fft_initialized) {
-        dsps_fft2r_deinit_fc32();
+    // Oldest requested row, then copy in at most two contiguous runs
+    size_t start = (features->row_head + AUDIO_FEATURES_WINDOW_FRAMES - n_frames) %
+                   AUDIO_FEATURES_WINDOW_FRAMES;
+    size_t first = AUDIO_FEATURES_WINDOW_FRAMES - start;
+    if (first > n_frames) {
+        first = n_frames;
+    }
+    memcpy(window_out, &features->window_rows[start * MELSPEC_N_MELS],
+           first * MELSPEC_N_MELS * sizeof(float));
+    if (first < n_frames) {
+        memcpy(&window_out[first * MELSPEC_N_MELS], features->window_rows,
+               (n_frames - first) * MELSPEC_N_MELS * sizeof(float));
+    }
+    return ESP_OK;
+}
+
+const float *audio_features_stream_latest_row(audio_features_t *features)
+{
+    if (!features || features->row_count == 0) {
+        return NULL;
+    }
+    size_t idx = (features->row_head + AUDIO_FEATURES_WINDOW_FRAMES - 1) %
+                 AUDIO_FEATURES_WINDOW_FRAMES;
+    return &features->window_rows[idx * MELSPEC_N_MELS];
+}
+
+size_t audio_features_stream_available(audio_features_t *features)
+{
+    return features ? features->row_count : 0;
+}
+
+uint32_t audio_features_stream_total_rows(audio_features_t *features)
+{
+    return features ? features->total_rows : 0;
+}
+
+void audio_features_stream_reset(audio_features_t *features)
+{
+    if (!features) {
+        return;
+    }
+    features->ring_pos = 0;
+    features->ring_fill = 0;
+    features->hop_fill = 0;
+    features->row_head = 0;
+    features->row_count = 0;
+    features->total_rows = 0;
+}
+
+void audio_features_deinit(audio_features_t *features)
+{
+    if (!features) {
+        return;
     }
-#endif
     
+    // The ESP-DSP tables stay: they are shared (see fft_table_init_fc32())
     if (features->melspectrogram_buffer) free(features->melspectrogram_buffer);
     if (features->fft_buffer) free(features->fft_buffer);
+#if FRONTEND_REAL
+    if (features->split_cos) free(features->split_cos);
+    if (features->split_sin) free(features->split_sin);
+#endif
+#if FRONTEND_FIXED16
+    if (features->fft_sc16) free(features->fft_sc16);
+    if (features->window_q15) free(features->window_q15);
+#endif
     if (features->magnitude_buffer) free(features->magnitude_buffer);
     if (features->window) free(features->window);
-    if (features->mel_filter_bank) free(features->mel_filter_bank);
+    if (features->mel_weights) free(features->mel_weights);
+    if (features->sample_ring) free(features->sample_ring);
+    if (features->window_rows) free(features->window_rows);
     
     free(features);
 }
\ No newline at end of file
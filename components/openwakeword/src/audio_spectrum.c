@@ -0,0 +1,169 @@
+/**
+ * @file audio_spectrum.c
+ * @brief Band energies and beats from the streaming mel frontend
+ *
+ * Works on the log10 mel rows audio_features already computes for wake word
+ * detection, so sound-reactive consumers cost a few adds per row instead of
+ * a second FFT.
+ */
+
+#include "audio_spectrum.h"
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "audio_features.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+
+static const char *TAG = "audio_spectrum";
+
+// Rows arrive once per hop (10 ms at 16 kHz)
+#define SPECTRUM_ROW_MS (1000.0f * AUDIO_FEATURES_HOP_LENGTH / 16000.0f)
+// Rows are log10 magnitudes: one unit is 20 dB
+#define SPECTRUM_DB_PER_UNIT 20.0f
+// Floors drop to a quieter signal at once and creep back up at ~4 dB/s
+#define SPECTRUM_FLOOR_RISE (4.0f / SPECTRUM_DB_PER_UNIT * SPECTRUM_ROW_MS / 1000.0f)
+// A beat is the low bands jumping 6 dB over their 1 s average, at most every 200 ms
+#define SPECTRUM_BEAT_RISE (6.0f / SPECTRUM_DB_PER_UNIT)
+#define SPECTRUM_BEAT_AVG_MS 1000.0f
+#define SPECTRUM_BEAT_HOLDOFF_ROWS 20
+
+struct audio_spectrum {
+    uint8_t band_count;
+    uint8_t band_edges[AUDIO_SPECTRUM_MAX_BANDS + 1];  // First mel bin of each band
+    uint8_t beat_bands;           // Lowest bands that drive beat detection
+    float attack;
+    float decay;
+    float beat_avg_coeff;
+    float range;                  // Full scale above the floor, log10 units
+
+    // Audio task only
+    float smoothed[AUDIO_SPECTRUM_MAX_BANDS];
+    float floor[AUDIO_SPECTRUM_MAX_BANDS];
+    float beat_avg;
+    bool primed;
+    bool beat_armed;
+    uint32_t rows_since_beat;
+
+    // Published to readers under lock
+    portMUX_TYPE lock;
+    uint8_t levels[AUDIO_SPECTRUM_MAX_BANDS];
+    uint32_t beats;
+};
+
+static float spectrum_coeff(float time_ms)
+{
+    return time_ms > 0.0f ? 1.0f - expf(-SPECTRUM_ROW_MS / time_ms) : 1.0f;
+}
+
+audio_spectrum_t *audio_spectrum_create(const audio_spectrum_config_t *config)
+{
+    audio_spectrum_t *spectrum = calloc(1, sizeof(audio_spectrum_t));
+    if (!spectrum) {
+        return NULL;
+    }
+
+    uint8_t bands = config && config->band_count ? config->band_count : 8;
+    if (bands > AUDIO_SPECTRUM_MAX_BANDS) {
+        bands = AUDIO_SPECTRUM_MAX_BANDS;
+    }
+    if (bands > AUDIO_FEATURES_N_MELS) {
+        bands = AUDIO_FEATURES_N_MELS;
+    }
+    spectrum->band_count = bands;
+    // Equal runs of mel bins are equal steps on the mel scale
+    for (int b = 0; b <= bands; b++) {
+        spectrum->band_edges[b] = (uint8_t)(b * AUDIO_FEATURES_N_MELS / bands);
+    }
+    spectrum->beat_bands = bands >= 4 ? bands / 4 : 1;
+
+    spectrum->attack = spectrum_coeff(config && config->attack_ms ? config->attack_ms : 20);
+    spectrum->decay = spectrum_coeff(config && config->decay_ms ? config->decay_ms : 250);
+    spectrum->beat_avg_coeff = spectrum_coeff(SPECTRUM_BEAT_AVG_MS);
+    spectrum->range = (config && config->range_db ? config->range_db : 40) / SPECTRUM_DB_PER_UNIT;
+    spectrum->beat_armed = true;
+    portMUX_INITIALIZE(&spectrum->lock);
+
+    ESP_LOGI(TAG, "%u bands over %d mel bins", bands, AUDIO_FEATURES_N_MELS);
+    return spectrum;
+}
+
+void audio_spectrum_destroy(audio_spectrum_t *spectrum)
+{
+    free(spectrum);
+}
+
+void audio_spectrum_push_row(const float *mel_row, void *ctx)
+{
+    audio_spectrum_t *spectrum = ctx;
+    if (!spectrum || !mel_row) {
+        return;
+    }
+
+    uint8_t levels[AUDIO_SPECTRUM_MAX_BANDS];
+    float low = 0.0f;
+    for (int b = 0; b < spectrum->band_count; b++) {
+        int first = spectrum->band_edges[b];
+        int last = spectrum->band_edges[b + 1];
+        float sum = 0.0f;
+        for (int m = first; m < last; m++) {
+            sum += mel_row[m];
+        }
+        float energy = sum / (float)(last - first);
+        if (b < spectrum->beat_bands) {
+            low += energy;
+        }
+
+        if (!spectrum->primed) {
+            spectrum->smoothed[b] = energy;
+            spectrum->floor[b] = energy;
+        }
+        float coeff = energy > spectrum->smoothed[b] ? spectrum->attack : spectrum->decay;
+        spectrum->smoothed[b] += coeff * (energy - spectrum->smoothed[b]);
+        if (spectrum->smoothed[b] < spectrum->floor[b]) {
+            spectrum->floor[b] = spectrum->smoothed[b];
+        } else {
+            spectrum->floor[b] += SPECTRUM_FLOOR_RISE;
+        }
+
+        float level = (spectrum->smoothed[b] - spectrum->floor[b]) / spectrum->range;
+        levels[b] = level <= 0.0f ? 0 : level >= 1.0f ? 255 : (uint8_t)(level * 255.0f + 0.5f);
+    }
+
+    low /= (float)spectrum->beat_bands;
+    if (!spectrum->primed) {
+        spectrum->beat_avg = low;
+        spectrum->primed = true;
+    }
+    bool onset = low - spectrum->beat_avg > SPECTRUM_BEAT_RISE;
+    bool beat = onset && spectrum->beat_armed && spectrum->rows_since_beat >= SPECTRUM_BEAT_HOLDOFF_ROWS;
+    // Re-arm only once the low bands fall back, so one loud note is one beat
+    spectrum->beat_armed = !onset;
+    spectrum->rows_since_beat = beat ? 0 : spectrum->rows_since_beat + 1;
+    spectrum->beat_avg += spectrum->beat_avg_coeff * (low - spectrum->beat_avg);
+
+    portENTER_CRITICAL(&spectrum->lock);
+    memcpy(spectrum->levels, levels, spectrum->band_count);
+    if (beat) {
+        spectrum->beats++;
+    }
+    portEXIT_CRITICAL(&spectrum->lock);
+}
+
+size_t audio_spectrum_read(audio_spectrum_t *spectrum, uint8_t *levels_out, size_t count, uint32_t *beats_out)
+{
+    if (!spectrum || (!levels_out && count > 0)) {
+        return 0;
+    }
+    if (count > spectrum->band_count) {
+        count = spectrum->band_count;
+    }
+    portENTER_CRITICAL(&spectrum->lock);
+    memcpy(levels_out, spectrum->levels, count);
+    if (beats_out) {
+        *beats_out = spectrum->beats;
+    }
+    portEXIT_CRITICAL(&spectrum->lock);
+    return count;
+}
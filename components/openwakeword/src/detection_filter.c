@@ -0,0 +1,58 @@
+/**
+ * @file detection_filter.c
+ * @brief Score smoothing, patience and debounce for wake word triggers
+ */
+
+#include "detection_filter.h"
+#include <string.h>
+
+static uint8_t clamp_frames(uint8_t frames)
+{
+    if (frames == 0) {
+        return 1;
+    }
+    return frames > DETECTION_FILTER_HISTORY ? DETECTION_FILTER_HISTORY : frames;
+}
+
+void detection_filter_init(detection_filter_t *filter, const detection_filter_config_t *config)
+{
+    memset(filter, 0, sizeof(*filter));
+    filter->config = *config;
+    filter->config.patience_frames = clamp_frames(config->patience_frames);
+    filter->config.smoothing_frames = clamp_frames(config->smoothing_frames);
+}
+
+void detection_filter_reset(detection_filter_t *filter)
+{
+    filter->head = 0;
+    filter->count = 0;
+    filter->run = 0;
+    filter->smoothed = 0.0f;
+}
+
+bool detection_filter_push(detection_filter_t *filter, float score, bool armed)
+{
+    filter->scores[filter->head] = score;
+    filter->head = (filter->head + 1) % DETECTION_FILTER_HISTORY;
+    if (filter->count < DETECTION_FILTER_HISTORY) {
+        filter->count++;
+    }
+
+    // Average what is there while the ring is still filling
+    size_t n = filter->config.smoothing_frames < filter->count ? filter->config.smoothing_frames : filter->count;
+    float sum = 0.0f;
+    for (size_t i = 1; i <= n; i++) {
+        sum += filter->scores[(filter->head + DETECTION_FILTER_HISTORY - i) % DETECTION_FILTER_HISTORY];
+    }
+    filter->smoothed = sum / (float)n;
+
+    if (!armed || filter->smoothed <= filter->config.threshold) {
+        filter->run = 0;
+        return false;
+    }
+    if (++filter->run < filter->config.patience_frames) {
+        return false;
+    }
+    filter->run = 0;
+    return true;
+}
@@ -0,0 +1,558 @@
+/**
+ * @file embedding_pipeline.c
+ * @brief Shared embedding stage and per-wake-word classifier heads
+ *
+ * Based on openWakeWord's Model.predict(): melspectrogram -> embedding model
+ * over 76-frame windows -> classifier over the last 16 embeddings.
+ */
+
+#include "embedding_pipeline.h"
+#include "model_loader.h"
+#include "tflite_wrapper.h"
+#include "openwakeword_stats.h"
+#include <string.h>
+#include <stdlib.h>
+#include "esp_log.h"
+#include "esp_err.h"
+
+static const char *TAG = "oww_pipeline";
+
+#define HEAD_NAME_MAX 32
+
+typedef struct {
+    char name[HEAD_NAME_MAX];
+    tflite_wrapper_t *wrapper;    // Member of the pipeline's head group
+    uint8_t *model_data;
+    size_t model_size;
+    float *direct_input;          // Input tensor buffer for float models, else NULL
+    size_t n_embeddings;          // Embeddings consumed per inference
+    float score;
+} pipeline_head_t;
+
+typedef struct {
+    tflite_wrapper_t *wrapper;
+    uint8_t *model_data;
+    float *direct_input;
+    size_t n_embeddings;
+    size_t class_count;
+    uint8_t stride;
+    uint8_t countdown;            // Embeddings until the next run
+    bool scored;                  // Ran in the last process call
+    uint32_t last_us;
+    float scores[EMBEDDING_PIPELINE_MAX_EVENT_CLASSES];
+} pipeline_event_head_t;
+
+struct embedding_pipeline {
+    tflite_wrapper_t *embedding_wrapper;
+    uint8_t *embedding_model_data;
+    size_t embedding_dim;
+    float *embedding_direct_input;  // Input tensor buffer for float models, else NULL
+    
+    // Staging buffers
+    float *mel_window;            // WINDOW_FRAMES x N_MELS, model-scaled (quantized embedding model only)
+    float *head_input;            // Newest embeddings for the heads, chronological
+    
+    // Embedding ring
+    float *ring;                  // RING_SIZE x embedding_dim
+    size_t ring_head;
+    size_t ring_count;
+    
+    uint32_t last_embedding_row;  // audio_features total_rows at last embedding
+    bool have_embedding_row;
+    uint32_t skipped_steps;
+    
+    // Model time in the last process call, 0 when it computed nothing
+    uint32_t last_embedding_us;
+    uint32_t last_classifier_us;
+    
+    // Heads run back to back, so their interpreters share one tensor arena
+    tflite_wrapper_group_t *head_group;
+    size_t head_arena_budget;     // Sum of the per-head arena sizes, bounds the group's arena
+    pipeline_head_t heads[EMBEDDING_PIPELINE_MAX_HEADS];
+    size_t head_count;
+    
+    pipeline_event_head_t event;  // wrapper is NULL without an event head
+};
+
+// Float models are fed by writing straight into the tensor arena; quantized
+// models go through the staging buffer and tflite_wrapper_invoke().
+static float *direct_float_input(tflite_wrapper_t *wrapper)
+{
+    tflite_wrapper_type_t type = TFLITE_WRAPPER_TYPE_UNKNOWN;
+    void *ptr = tflite_wrapper_input_ptr(wrapper, &type);
+    return (type == TFLITE_WRAPPER_TYPE_FLOAT32) ? (float *)ptr : NULL;
+}
+
+// Read element i of the output tensor as float
+static float read_output(tflite_wrapper_t *wrapper, size_t i)
+{
+    tflite_wrapper_type_t type = TFLITE_WRAPPER_TYPE_UNKNOWN;
+    const void *ptr = tflite_wrapper_output_ptr(wrapper, &type);
+    if (!ptr) {
+        return 0.0f;
+    }
+    if (type == TFLITE_WRAPPER_TYPE_FLOAT32) {
+        return ((const float *)ptr)[i];
+    }
+    
+    float scale = 1.0f;
+    int32_t zero_point = 0;
+    tflite_wrapper_get_quant_params(wrapper, true, &scale, &zero_point);
+    int32_t q = 0;
+    switch (type) {
+        case TFLITE_WRAPPER_TYPE_INT8:  q = ((const int8_t *)ptr)[i]; break;
+        case TFLITE_WRAPPER_TYPE_UINT8: q = ((const uint8_t *)ptr)[i]; break;
+        case TFLITE_WRAPPER_TYPE_INT16: q = ((const int16_t *)ptr)[i]; break;
+        default: break;
+    }
+    return (float)(q - zero_point) * scale;
+}
+
+embedding_pipeline_t *embedding_pipeline_create(uint8_t *model_data,
+                                                size_t model_size,
+                                                size_t arena_size)
+{
+    // model_data is ours from here on, including on every error path
+    if (!model_data || model_size == 0) {
+        model_loader_free(model_data);
+        return NULL;
+    }
+    
+    embedding_pipeline_t *pipeline = calloc(1, sizeof(embedding_pipeline_t));
+    if (!pipeline) {
+        model_loader_free(model_data);
+        return NULL;
+    }
+    pipeline->embedding_model_data = model_data;
+    
+    pipeline->embedding_wrapper = tflite_wrapper_create(model_data, model_size, arena_size);
+    if (!pipeline->embedding_wrapper || !tflite_wrapper_is_initialized(pipeline->embedding_wrapper)) {
+        ESP_LOGE(TAG, "Failed to create embedding interpreter");
+        embedding_pipeline_destroy(pipeline);
+        return NULL;
+    }
+    
+    size_t input_size = tflite_wrapper_get_input_size(pipeline->embedding_wrapper);
+    size_t expected = AUDIO_FEATURES_WINDOW_FRAMES * AUDIO_FEATURES_N_MELS;
+    if (input_size != expected) {
+        ESP_LOGE(TAG, "Embedding model input %zu floats, expected %d x %d = %zu",
+                 input_size, AUDIO_FEATURES_WINDOW_FRAMES, AUDIO_FEATURES_N_MELS, expected);
+        embedding_pipeline_destroy(pipeline);
+        return NULL;
+    }
+    
+    pipeline->embedding_dim = tflite_wrapper_get_output_size(pipeline->embedding_wrapper);
+    if (pipeline->embedding_dim == 0) {
+        embedding_pipeline_destroy(pipeline);
+        return NULL;
+    }
+    
+    pipeline->embedding_direct_input = direct_float_input(pipeline->embedding_wrapper);
+    if (!pipeline->embedding_direct_input) {
+        pipeline->mel_window = malloc(expected * sizeof(float));
+    }
+    pipeline->ring = calloc(EMBEDDING_PIPELINE_RING_SIZE * pipeline->embedding_dim, sizeof(float));
+    pipeline->head_input = malloc(EMBEDDING_PIPELINE_RING_SIZE * pipeline->embedding_dim * sizeof(float));
+    if ((!pipeline->embedding_direct_input && !pipeline->mel_window) ||
+        !pipeline->ring || !pipeline->head_input) {
+        embedding_pipeline_destroy(pipeline);
+        return NULL;
+    }
+    
+    ESP_LOGI(TAG, "Embedding stage ready: %d x %d mel -> %zu-dim embedding",
+             AUDIO_FEATURES_WINDOW_FRAMES, AUDIO_FEATURES_N_MELS, pipeline->embedding_dim);
+    return pipeline;
+}
+
+esp_err_t embedding_pipeline_add_head(embedding_pipeline_t *pipeline,
+                                      const char *name,
+                                      uint8_t *model_data,
+                                      size_t model_size,
+                                      size_t arena_size,
+                                      size_t *index_out)
+{
+    if (!pipeline || !name || !model_data || model_size == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (pipeline->head_count >= EMBEDDING_PIPELINE_MAX_HEADS) {
+        return ESP_ERR_NO_MEM;
+    }
+    
+    // Replan every head in one arena with the new model added; the current
+    // group stays in use if that fails
+    const uint8_t *models[EMBEDDING_PIPELINE_MAX_HEADS];
+    size_t sizes[EMBEDDING_PIPELINE_MAX_HEADS];
+    size_t count = pipeline->head_count;
+    for (size_t h = 0; h < count; h++) {
+        models[h] = pipeline->heads[h].model_data;
+        sizes[h] = pipeline->heads[h].model_size;
+    }
+    models[count] = model_data;
+    sizes[count] = model_size;
+    
+    tflite_wrapper_config_t config = tflite_wrapper_default_config(pipeline->head_arena_budget + arena_size);
+    tflite_wrapper_group_t *group = tflite_wrapper_group_create(models, sizes, count + 1, &config);
+    tflite_wrapper_t *wrapper = tflite_wrapper_group_member(group, count);
+    if (!wrapper || !tflite_wrapper_is_initialized(wrapper)) {
+        ESP_LOGE(TAG, "Failed to create interpreter for head '%s'", name);
+        tflite_wrapper_group_destroy(group);
+        return ESP_FAIL;
+    }
+    
+    size_t input_size = tflite_wrapper_get_input_size(wrapper);
+    size_t n_embeddings = input_size / pipeline->embedding_dim;
+    if (input_size % pipeline->embedding_dim != 0 || n_embeddings == 0 ||
+        n_embeddings > EMBEDDING_PIPELINE_RING_SIZE) {
+        ESP_LOGE(TAG, "Head '%s' input %zu floats is not 1..%d x %zu embeddings",
+                 name, input_size, EMBEDDING_PIPELINE_RING_SIZE, pipeline->embedding_dim);
+        tflite_wrapper_group_destroy(group);
+        return ESP_ERR_INVALID_SIZE;
+    }
+    
+    tflite_wrapper_group_destroy(pipeline->head_group);
+    pipeline->head_group = group;
+    pipeline->head_arena_budget += arena_size;
+    for (size_t h = 0; h < count; h++) {
+        pipeline->heads[h].wrapper = tflite_wrapper_group_member(group, h);
+        pipeline->heads[h].direct_input = direct_float_input(pipeline->heads[h].wrapper);
+    }
+    
+    pipeline_head_t *head = &pipeline->heads[count];
+    strncpy(head->name, name, sizeof(head->name) - 1);
+    head->name[sizeof(head->name) - 1] = '\0';
+    head->wrapper = wrapper;
+    head->model_data = model_data;
+    head->model_size = model_size;
+    head->direct_input = direct_float_input(wrapper);
+    head->n_embeddings = n_embeddings;
+    head->score = 0.0f;
+    
+    if (index_out) {
+        *index_out = count;
+    }
+    pipeline->head_count++;
+    
+    size_t used = 0;
+    size_t allocated = 0;
+    tflite_wrapper_group_get_arena_usage(group, &used, &allocated);
+    ESP_LOGI(TAG, "Added head '%s' over %zu embeddings; %zu head(s) share %zu of %zu arena bytes",
+             head->name, n_embeddings, pipeline->head_count, used, allocated);
+    return ESP_OK;
+}
+
+esp_err_t embedding_pipeline_set_event_head(embedding_pipeline_t *pipeline,
+                                            uint8_t *model_data,
+                                            size_t model_size,
+                                            size_t arena_size,
+                                            uint8_t stride,
+                                            size_t *class_count_out)
+{
+    if (!pipeline || !model_data || model_size == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (pipeline->event.wrapper) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    tflite_wrapper_t *wrapper = tflite_wrapper_create(model_data, model_size, arena_size);
+    if (!wrapper || !tflite_wrapper_is_initialized(wrapper)) {
+        ESP_LOGE(TAG, "Failed to create event head interpreter");
+        tflite_wrapper_destroy(wrapper);
+        return ESP_FAIL;
+    }
+    size_t input_size = tflite_wrapper_get_input_size(wrapper);
+    size_t n_embeddings = input_size / pipeline->embedding_dim;
+    size_t class_count = tflite_wrapper_get_output_size(wrapper);
+    if (input_size % pipeline->embedding_dim != 0 || n_embeddings == 0 ||
+        n_embeddings > EMBEDDING_PIPELINE_RING_SIZE ||
+        class_count == 0 || class_count > EMBEDDING_PIPELINE_MAX_EVENT_CLASSES) {
+        ESP_LOGE(TAG, "Event head takes %zu floats and scores %zu classes; expected 1..%d x %zu and 1..%d",
+                 input_size, class_count, EMBEDDING_PIPELINE_RING_SIZE, pipeline->embedding_dim,
+                 EMBEDDING_PIPELINE_MAX_EVENT_CLASSES);
+        tflite_wrapper_destroy(wrapper);
+        return ESP_ERR_INVALID_SIZE;
+    }
+    
+    pipeline_event_head_t *event = &pipeline->event;
+    memset(event, 0, sizeof(*event));
+    event->wrapper = wrapper;
+    event->model_data = model_data;
+    event->direct_input = direct_float_input(wrapper);
+    event->n_embeddings = n_embeddings;
+    event->class_count = class_count;
+    event->stride = stride ? stride : 1;
+    if (class_count_out) {
+        *class_count_out = class_count;
+    }
+    ESP_LOGI(TAG, "Event head over %zu embeddings scores %zu classes every %u embeddings",
+             n_embeddings, class_count, (unsigned)event->stride);
+    return ESP_OK;
+}
+
+// Copy the newest n embeddings into dst, oldest first
+static void linearize_ring(embedding_pipeline_t *pipeline, size_t n, float *dst)
+{
+    size_t dim = pipeline->embedding_dim;
+    size_t start = (pipeline->ring_head + EMBEDDING_PIPELINE_RING_SIZE - n) %
+                   EMBEDDING_PIPELINE_RING_SIZE;
+    size_t first = EMBEDDING_PIPELINE_RING_SIZE - start;
+    if (first > n) {
+        first = n;
+    }
+    memcpy(dst, &pipeline->ring[start * dim], first * dim * sizeof(float));
+    if (first < n) {
+        memcpy(&dst[first * dim], pipeline->ring,
+               (n - first) * dim * sizeof(float));
+    }
+}
+
+esp_err_t embedding_pipeline_process(embedding_pipeline_t *pipeline,
+                                     audio_features_t *features,
+                                     bool *scored_out)
+{
+    if (scored_out) {
+        *scored_out = false;
+    }
+    if (!pipeline || !features) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pipeline->last_embedding_us = 0;
+    pipeline->last_classifier_us = 0;
+    pipeline->event.scored = false;
+    
+    uint32_t total_rows = audio_features_stream_total_rows(features);
+    if (audio_features_stream_available(features) < AUDIO_FEATURES_WINDOW_FRAMES) {
+        return ESP_OK;
+    }
+    if (pipeline->have_embedding_row) {
+        uint32_t elapsed = total_rows - pipeline->last_embedding_row;
+        if (elapsed < EMBEDDING_PIPELINE_STEP_FRAMES) {
+            return ESP_OK;
+        }
+        // Older windows are already overwritten; only the newest can be computed
+        if (elapsed >= 2 * EMBEDDING_PIPELINE_STEP_FRAMES) {
+            pipeline->skipped_steps += elapsed / EMBEDDING_PIPELINE_STEP_FRAMES - 1;
+        }
+    }
+    
+    float *mel = pipeline->embedding_direct_input ? pipeline->embedding_direct_input
+                                                  : pipeline->mel_window;
+    esp_err_t err = audio_features_stream_get_window(features, mel, AUDIO_FEATURES_WINDOW_FRAMES);
+    if (err != ESP_OK) {
+        return err;
+    }
+    
+    // openWakeWord's embedding model expects melspec/10 + 2 of a dB power
+    // spectrogram; our rows are log10 magnitude, i.e. dB/20.
+    size_t n = AUDIO_FEATURES_WINDOW_FRAMES * AUDIO_FEATURES_N_MELS;
+    for (size_t i = 0; i < n; i++) {
+        mel[i] = mel[i] * 2.0f + 2.0f;
+    }
+    
+    // One new embedding into its ring slot
+    int64_t embedding_start = openwakeword_stats_now_us();
+    float *slot = &pipeline->ring[pipeline->ring_head * pipeline->embedding_dim];
+    if (pipeline->embedding_direct_input) {
+        err = tflite_wrapper_invoke_in_place(pipeline->embedding_wrapper);
+        if (err == ESP_OK) {
+            tflite_wrapper_type_t out_type = TFLITE_WRAPPER_TYPE_UNKNOWN;
+            const void *out = tflite_wrapper_output_ptr(pipeline->embedding_wrapper, &out_type);
+            if (out_type == TFLITE_WRAPPER_TYPE_FLOAT32) {
+                memcpy(slot, out, pipeline->embedding_dim * sizeof(float));
+            } else {
+                for (size_t i = 0; i < pipeline->embedding_dim; i++) {
+                    slot[i] = read_output(pipeline->embedding_wrapper, i);
+                }
+            }
+        }
+    } else {
+        size_t out_size = pipeline->embedding_dim;
+        err = tflite_wrapper_invoke(pipeline->embedding_wrapper, mel, n, slot, &out_size);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Embedding inference failed: %s", esp_err_to_name(err));
+        return err;
+    }
+    
+    pipeline->ring_head = (pipeline->ring_head + 1) % EMBEDDING_PIPELINE_RING_SIZE;
+    if (pipeline->ring_count < EMBEDDING_PIPELINE_RING_SIZE) {
+        pipeline->ring_count++;
+    }
+    pipeline->last_embedding_row = total_rows;
+    pipeline->have_embedding_row = true;
+    int64_t classifier_start = openwakeword_stats_now_us();
+    pipeline->last_embedding_us = (uint32_t)(classifier_start - embedding_start);
+    
+    // Run every head that has a full embedding history. The newest
+    // embeddings are linearized once for all of them; each head takes its
+    // tail of that and, sharing the arena, must be filled right before it runs.
+    size_t newest = 0;
+    for (size_t h = 0; h < pipeline->head_count; h++) {
+        size_t n_embeddings = pipeline->heads[h].n_embeddings;
+        if (pipeline->ring_count >= n_embeddings && n_embeddings > newest) {
+            newest = n_embeddings;
+        }
+    }
+    bool event_due = false;
+    if (pipeline->event.wrapper && pipeline->ring_count >= pipeline->event.n_embeddings) {
+        if (pipeline->event.countdown == 0) {
+            event_due = true;
+            pipeline->event.countdown = pipeline->event.stride;
+            if (pipeline->event.n_embeddings > newest) {
+                newest = pipeline->event.n_embeddings;
+            }
+        }
+        pipeline->event.countdown--;
+    }
+    if (newest > 0) {
+        linearize_ring(pipeline, newest, pipeline->head_input);
+    }
+    
+    bool scored = false;
+    for (size_t h = 0; h < pipeline->head_count; h++) {
+        pipeline_head_t *head = &pipeline->heads[h];
+        if (pipeline->ring_count < head->n_embeddings) {
+            continue;
+        }
+        const float *input = &pipeline->head_input[(newest - head->n_embeddings) * pipeline->embedding_dim];
+        size_t input_size = head->n_embeddings * pipeline->embedding_dim;
+        if (head->direct_input) {
+            memcpy(head->direct_input, input, input_size * sizeof(float));
+            err = tflite_wrapper_invoke_in_place(head->wrapper);
+        } else {
+            err = tflite_wrapper_invoke(head->wrapper, input, input_size, NULL, NULL);
+        }
+        if (err != ESP_OK) {
+            ESP_LOGE(TAG, "Head '%s' inference failed: %s", head->name, esp_err_to_name(err));
+            return err;
+        }
+        // Single sigmoid output, or [not_wake_word, wake_word]
+        size_t output_size = tflite_wrapper_get_output_size(head->wrapper);
+        head->score = read_output(head->wrapper, (output_size >= 2) ? 1 : 0);
+        scored = true;
+    }
+    int64_t event_start = openwakeword_stats_now_us();
+    pipeline->last_classifier_us = (uint32_t)(event_start - classifier_start);
+    
+    if (event_due) {
+        pipeline_event_head_t *event = &pipeline->event;
+        const float *input = &pipeline->head_input[(newest - event->n_embeddings) * pipeline->embedding_dim];
+        size_t input_size = event->n_embeddings * pipeline->embedding_dim;
+        if (event->direct_input) {
+            memcpy(event->direct_input, input, input_size * sizeof(float));
+            err = tflite_wrapper_invoke_in_place(event->wrapper);
+        } else {
+            err = tflite_wrapper_invoke(event->wrapper, input, input_size, NULL, NULL);
+        }
+        if (err != ESP_OK) {
+            ESP_LOGE(TAG, "Event head inference failed: %s", esp_err_to_name(err));
+            return err;
+        }
+        for (size_t c = 0; c < event->class_count; c++) {
+            event->scores[c] = read_output(event->wrapper, c);
+        }
+        event->scored = true;
+        event->last_us = (uint32_t)(openwakeword_stats_now_us() - event_start);
+    }
+    
+    if (scored_out) {
+        *scored_out = scored;
+    }
+    return ESP_OK;
+}
+
+size_t embedding_pipeline_head_count(const embedding_pipeline_t *pipeline)
+{
+    return pipeline ? pipeline->head_count : 0;
+}
+
+esp_err_t embedding_pipeline_get_score(const embedding_pipeline_t *pipeline,
+                                       size_t index,
+                                       const char **name_out,
+                                       float *score_out)
+{
+    if (!pipeline || index >= pipeline->head_count) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (name_out) {
+        *name_out = pipeline->heads[index].name;
+    }
+    if (score_out) {
+        *score_out = pipeline->heads[index].score;
+    }
+    return ESP_OK;
+}
+
+size_t embedding_pipeline_get_event_scores(const embedding_pipeline_t *pipeline,
+                                           float *scores_out,
+                                           size_t max,
+                                           uint32_t *event_us_out)
+{
+    if (!pipeline || !scores_out || !pipeline->event.scored) {
+        return 0;
+    }
+    size_t n = pipeline->event.class_count < max ? pipeline->event.class_count : max;
+    memcpy(scores_out, pipeline->event.scores, n * sizeof(float));
+    if (event_us_out) {
+        *event_us_out = pipeline->event.last_us;
+    }
+    return n;
+}
+
+void embedding_pipeline_get_timing(const embedding_pipeline_t *pipeline,
+                                   uint32_t *embedding_us_out,
+                                   uint32_t *classifier_us_out,
+                                   uint32_t *skipped_steps_out)
+{
+    if (embedding_us_out) {
+        *embedding_us_out = pipeline ? pipeline->last_embedding_us : 0;
+    }
+    if (classifier_us_out) {
+        *classifier_us_out = pipeline ? pipeline->last_classifier_us : 0;
+    }
+    if (skipped_steps_out) {
+        *skipped_steps_out = pipeline ? pipeline->skipped_steps : 0;
+    }
+}
+
+void embedding_pipeline_reset(embedding_pipeline_t *pipeline)
+{
+    if (!pipeline) {
+        return;
+    }
+    pipeline->ring_head = 0;
+    pipeline->ring_count = 0;
+    pipeline->have_embedding_row = false;
+    for (size_t h = 0; h < pipeline->head_count; h++) {
+        pipeline->heads[h].score = 0.0f;
+    }
+    pipeline->event.countdown = 0;
+    pipeline->event.scored = false;
+}
+
+void embedding_pipeline_destroy(embedding_pipeline_t *pipeline)
+{
+    if (!pipeline) {
+        return;
+    }
+    
+    tflite_wrapper_group_destroy(pipeline->head_group);
+    for (size_t h = 0; h < pipeline->head_count; h++) {
+        model_loader_free(pipeline->heads[h].model_data);
+    }
+    if (pipeline->event.wrapper) {
+        tflite_wrapper_destroy(pipeline->event.wrapper);
+        model_loader_free(pipeline->event.model_data);
+    }
+    
+    if (pipeline->embedding_wrapper) {
+        tflite_wrapper_destroy(pipeline->embedding_wrapper);
+    }
+    model_loader_free(pipeline->embedding_model_data);
+    
+    if (pipeline->mel_window) free(pipeline->mel_window);
+    if (pipeline->head_input) free(pipeline->head_input);
+    if (pipeline->ring) free(pipeline->ring);
+    
+    free(pipeline);
+}
@@ -12,9 +12,56 @@
 #include "esp_log.h"
 #include "esp_err.h"
 #include "esp_partition.h"
+#include "esp_rom_crc.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+// TFLite flatbuffers carry the "TFL3" file identifier at offset 4
+#define TFLITE_FILE_IDENTIFIER_OFFSET 4
 
 static const char *TAG = "model_loader";
 
+// The registry: one mapping per model partition in use
+typedef struct {
+    model_loader_model_t model;
+    char label[sizeof(((esp_partition_t *)0)->label)];
+    model_loader_mmap_t mapping;
+    uint32_t refs;           // 0 = free slot
+} registry_entry_t;
+
+static registry_entry_t s_registry[MODEL_LOADER_MAX_ACTIVE];
+static SemaphoreHandle_t s_registry_lock;
+
+// Created on first use by whichever task gets there first
+static SemaphoreHandle_t registry_lock(void)
+{
+    SemaphoreHandle_t lock = __atomic_load_n(&s_registry_lock, __ATOMIC_ACQUIRE);
+    if (!lock) {
+        SemaphoreHandle_t created = xSemaphoreCreateMutex();
+        if (!created) {
+            return NULL;
+        }
+        if (__atomic_compare_exchange_n(&s_registry_lock, &lock, created, false, __ATOMIC_ACQ_REL,
+                                        __ATOMIC_ACQUIRE)) {
+            lock = created;
+        } else {
+            vSemaphoreDelete(created);
+        }
+    }
+    return lock;
+}
+
+// With the registry locked
+static registry_entry_t *registry_find(const char *partition_name)
+{
+    for (int i = 0; i < MODEL_LOADER_MAX_ACTIVE; i++) {
+        if (s_registry[i].refs > 0 && strcmp(s_registry[i].label, partition_name) == 0) {
+            return &s_registry[i];
+        }
+    }
+    return NULL;
+}
+
 esp_err_t model_loader_load_from_partition(const char *partition_name,
                                             const char *model_name,
                                             uint8_t **model_data_out,
@@ -124,27 +171,291 @@ esp_err_t model_loader_load_from_partition_raw(const char *partition_name,
     ESP_LOGI(TAG, "Reading from partition '%s': size=%u", 
              partition_name, (unsigned int)partition->size);
     
+    // Read only the model when the partition carries a size header
+    size_t offset = 0;
+    size_t model_size = partition->size;
+    model_partition_header_t header;
+    esp_err_t err = esp_partition_read(partition, 0, &header, sizeof(header));
+    if (err == ESP_OK && header.magic == MODEL_PARTITION_MAGIC) {
+        offset = MODEL_PARTITION_HEADER_SIZE(header.version);
+        if (header.model_size == 0 || header.model_size > partition->size - offset) {
+            ESP_LOGE(TAG, "Bad model size in header: %u", (unsigned int)header.model_size);
+            return ESP_ERR_INVALID_SIZE;
+        }
+        model_size = header.model_size;
+    }
+    
     // Allocate buffer
-    uint8_t *model_data = malloc(partition->size);
+    uint8_t *model_data = malloc(model_size);
     if (!model_data) {
         return ESP_ERR_NO_MEM;
     }
     
     // Read from partition
-    esp_err_t err = esp_partition_read(partition, 0, model_data, partition->size);
+    err = esp_partition_read(partition, offset, model_data, model_size);
     if (err != ESP_OK) {
         free(model_data);
         ESP_LOGE(TAG, "Failed to read partition: %s", esp_err_to_name(err));
         return err;
     }
     
-    ESP_LOGI(TAG, "Loaded model from partition: %u bytes", (unsigned int)partition->size);
+    ESP_LOGI(TAG, "Loaded model from partition: %u bytes", (unsigned int)model_size);
     
     *model_data_out = model_data;
-    *model_size_out = partition->size;
+    *model_size_out = model_size;
     return ESP_OK;
 }
 
+esp_err_t model_loader_mmap_partition(const char *partition_name,
+                                      const uint8_t **model_data_out,
+                                      size_t *model_size_out,
+                                      model_loader_mmap_t *mapping_out)
+{
+    if (!partition_name || !model_data_out || !model_size_out || !mapping_out) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    mapping_out->mapped = false;
+    mapping_out->model_version = 0;
+    
+    const esp_partition_t *partition = esp_partition_find_first(
+        ESP_PARTITION_TYPE_DATA,
+        ESP_PARTITION_SUBTYPE_ANY,
+        partition_name
+    );
+    
+    if (!partition) {
+        ESP_LOGD(TAG, "Partition '%s' not found", partition_name);
+        return ESP_ERR_NOT_FOUND;
+    }
+    
+    // Look at the header first so only the model's pages get mapped
+    model_partition_header_t header;
+    esp_err_t err = esp_partition_read(partition, 0, &header, sizeof(header));
+    if (err != ESP_OK) {
+        return err;
+    }
+    
+    size_t offset = 0;
+    size_t model_size = 0;
+    if (header.magic == MODEL_PARTITION_MAGIC) {
+        if (header.version < 1 || header.version > MODEL_PARTITION_HEADER_VERSION) {
+            ESP_LOGE(TAG, "Unsupported model header version %u", (unsigned int)header.version);
+            return ESP_ERR_INVALID_VERSION;
+        }
+        offset = MODEL_PARTITION_HEADER_SIZE(header.version);
+        if (header.model_size == 0 || header.model_size > partition->size - offset) {
+            ESP_LOGE(TAG, "Bad model size in header: %u", (unsigned int)header.model_size);
+            return ESP_ERR_INVALID_SIZE;
+        }
+        model_size = header.model_size;
+    } else if (memcmp((const uint8_t *)&header + TFLITE_FILE_IDENTIFIER_OFFSET, "TFL3", 4) == 0) {
+        // Bare flatbuffer written without a header: map the whole partition
+        ESP_LOGW(TAG, "No model header in '%s', mapping whole partition", partition_name);
+        model_size = partition->size;
+    } else {
+        ESP_LOGE(TAG, "Partition '%s' holds neither a model header nor a TFLite model", partition_name);
+        return ESP_ERR_NOT_FOUND;
+    }
+    
+    const void *mapped = NULL;
+    err = esp_partition_mmap(partition, 0, offset + model_size, ESP_PARTITION_MMAP_DATA,
+                             &mapped, &mapping_out->mmap_handle);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to mmap partition '%s': %s", partition_name, esp_err_to_name(err));
+        return err;
+    }
+    mapping_out->mapped = true;
+    if (header.version >= 2) {
+        mapping_out->model_version = ((const model_partition_header_v2_t *)mapped)->model_version;
+    }
+    
+    const uint8_t *model_data = (const uint8_t *)mapped + offset;
+    if (offset > 0 && header.crc32 != 0) {
+        uint32_t crc = esp_rom_crc32_le(0, model_data, model_size);
+        if (crc != header.crc32) {
+            ESP_LOGE(TAG, "Model CRC mismatch: 0x%08x != 0x%08x",
+                     (unsigned int)crc, (unsigned int)header.crc32);
+            model_loader_munmap(mapping_out);
+            return ESP_ERR_INVALID_CRC;
+        }
+    }
+    
+    ESP_LOGI(TAG, "Mapped model from partition '%s': %u bytes at %p",
+             partition_name, (unsigned int)model_size, model_data);
+    
+    *model_data_out = model_data;
+    *model_size_out = model_size;
+    return ESP_OK;
+}
+
+void model_loader_munmap(model_loader_mmap_t *mapping)
+{
+    if (mapping && mapping->mapped) {
+        esp_partition_munmap(mapping->mmap_handle);
+        mapping->mapped = false;
+    }
+}
+
+esp_err_t model_loader_acquire(const char *partition_name, const model_loader_model_t **model_out)
+{
+    if (!partition_name || !model_out) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    SemaphoreHandle_t lock = registry_lock();
+    if (!lock) {
+        return ESP_ERR_NO_MEM;
+    }
+    xSemaphoreTake(lock, portMAX_DELAY);
+    esp_err_t err = ESP_OK;
+    registry_entry_t *entry = registry_find(partition_name);
+    if (!entry) {
+        for (int i = 0; i < MODEL_LOADER_MAX_ACTIVE && !entry; i++) {
+            entry = s_registry[i].refs == 0 ? &s_registry[i] : NULL;
+        }
+        if (!entry) {
+            ESP_LOGE(TAG, "No room to map '%s': %d models in use", partition_name, MODEL_LOADER_MAX_ACTIVE);
+            err = ESP_ERR_NO_MEM;
+        } else {
+            // First user: map and check it now, not at boot
+            memset(entry, 0, sizeof(*entry));
+            snprintf(entry->label, sizeof(entry->label), "%s", partition_name);
+            err = model_loader_mmap_partition(partition_name, &entry->model.data, &entry->model.size,
+                                              &entry->mapping);
+            entry->model.partition = entry->label;
+            entry->model.model_version = entry->mapping.model_version;
+            if (err != ESP_OK) {
+                entry = NULL;
+            }
+        }
+    }
+    if (entry) {
+        entry->refs++;
+        *model_out = &entry->model;
+    }
+    xSemaphoreGive(lock);
+    return err;
+}
+
+void model_loader_release(const model_loader_model_t *model)
+{
+    if (!model) {
+        return;
+    }
+    SemaphoreHandle_t lock = registry_lock();
+    xSemaphoreTake(lock, portMAX_DELAY);
+    registry_entry_t *entry = registry_find(model->partition);
+    if (entry && --entry->refs == 0) {
+        model_loader_munmap(&entry->mapping);
+        ESP_LOGI(TAG, "Unmapped model '%s'", entry->label);
+    }
+    xSemaphoreGive(lock);
+}
+
+esp_err_t model_loader_write_begin(const char *partition_name,
+                                   size_t image_size,
+                                   model_loader_writer_t *writer_out)
+{
+    if (!partition_name || !writer_out) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    memset(writer_out, 0, sizeof(*writer_out));
+    
+    const esp_partition_t *partition = esp_partition_find_first(
+        ESP_PARTITION_TYPE_DATA,
+        ESP_PARTITION_SUBTYPE_ANY,
+        partition_name
+    );
+    
+    if (!partition) {
+        ESP_LOGE(TAG, "Partition '%s' not found", partition_name);
+        return ESP_ERR_NOT_FOUND;
+    }
+    SemaphoreHandle_t lock = registry_lock();
+    bool in_use = false;
+    if (lock) {
+        xSemaphoreTake(lock, portMAX_DELAY);
+        in_use = registry_find(partition_name) != NULL;
+        xSemaphoreGive(lock);
+    }
+    if (in_use) {
+        ESP_LOGE(TAG, "Partition '%s' holds a model in use", partition_name);
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (image_size <= sizeof(model_partition_header_t) || image_size > partition->size) {
+        ESP_LOGE(TAG, "Image of %u bytes does not fit partition '%s' (%u bytes)",
+                 (unsigned int)image_size, partition_name, (unsigned int)partition->size);
+        return ESP_ERR_INVALID_SIZE;
+    }
+    
+    // Erase only the sectors the image covers
+    size_t erase_size = (image_size + partition->erase_size - 1) / partition->erase_size * partition->erase_size;
+    esp_err_t err = esp_partition_erase_range(partition, 0, erase_size);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to erase partition '%s': %s", partition_name, esp_err_to_name(err));
+        return err;
+    }
+    
+    writer_out->partition = partition;
+    writer_out->image_size = image_size;
+    return ESP_OK;
+}
+
+esp_err_t model_loader_write(model_loader_writer_t *writer, const void *data, size_t len)
+{
+    if (!writer || !writer->partition || (!data && len > 0)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (len > writer->image_size - writer->written) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    esp_err_t err = esp_partition_write(writer->partition, writer->written, data, len);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to write partition: %s", esp_err_to_name(err));
+        return err;
+    }
+    writer->written += len;
+    return ESP_OK;
+}
+
+esp_err_t model_loader_write_finish(model_loader_writer_t *writer)
+{
+    if (!writer || !writer->partition) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (writer->written != writer->image_size) {
+        ESP_LOGE(TAG, "Image incomplete: %u of %u bytes",
+                 (unsigned int)writer->written, (unsigned int)writer->image_size);
+        return ESP_ERR_INVALID_SIZE;
+    }
+    
+    model_partition_header_t header;
+    esp_err_t err = esp_partition_read(writer->partition, 0, &header, sizeof(header));
+    if (err != ESP_OK) {
+        return err;
+    }
+    if (header.magic != MODEL_PARTITION_MAGIC ||
+        header.model_size != writer->image_size - MODEL_PARTITION_HEADER_SIZE(header.version)) {
+        ESP_LOGE(TAG, "Image header does not match the %u bytes written", (unsigned int)writer->written);
+        return ESP_ERR_INVALID_SIZE;
+    }
+    if (header.crc32 == 0) {
+        ESP_LOGE(TAG, "Image carries no CRC");
+        return ESP_ERR_INVALID_CRC;
+    }
+    
+    // Mapping checks the version and CRC against what actually landed in flash
+    const uint8_t *model_data = NULL;
+    size_t model_size = 0;
+    model_loader_mmap_t mapping;
+    err = model_loader_mmap_partition(writer->partition->label, &model_data, &model_size, &mapping);
+    model_loader_munmap(&mapping);
+    if (err == ESP_OK) {
+        ESP_LOGI(TAG, "Model image verified in '%s': %u bytes, CRC 0x%08x",
+                 writer->partition->label, (unsigned int)model_size, (unsigned int)header.crc32);
+    }
+    return err;
+}
+
 void model_loader_free(uint8_t *model_data)
 {
     if (model_data) {
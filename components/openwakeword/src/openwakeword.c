@@ -13,9 +13,13 @@
  */
 
 #include "openwakeword.h"
+#include "openwakeword_stats.h"
 #include "audio_features.h"
 #include "model_loader.h"
 #include "tflite_wrapper.h"
+#include "embedding_pipeline.h"
+#include "detection_filter.h"
+#include "sound_event_filter.h"
 
 // Forward declaration for test mode
 extern esp_err_t openwakeword_test_mode_process(openwakeword_handle_t handle,
@@ -30,10 +34,12 @@ extern esp_err_t openwakeword_test_mode_process(openwakeword_handle_t handle,
 #include "esp_partition.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "nvs.h"
 #include <inttypes.h>
 
-// Melspectrogram size (defined in audio_features.c)
-#define MELSPEC_N_MELS 40
+// Melspectrogram size (defined in audio_features.h)
+#define MELSPEC_N_MELS AUDIO_FEATURES_N_MELS
 
 // TensorFlow Lite Micro integration
 #ifdef CONFIG_OPENWAKEWORD_USE_TFLITE
@@ -42,6 +48,45 @@ extern esp_err_t openwakeword_test_mode_process(openwakeword_handle_t handle,
 #define TFLITE_AVAILABLE 0
 #endif
 
+// Detection post-processing used when the config leaves it at 0
+#ifdef CONFIG_OPENWAKEWORD_PATIENCE_FRAMES
+#define OWW_DEFAULT_PATIENCE_FRAMES CONFIG_OPENWAKEWORD_PATIENCE_FRAMES
+#else
+#define OWW_DEFAULT_PATIENCE_FRAMES 2
+#endif
+#ifdef CONFIG_OPENWAKEWORD_SMOOTHING_FRAMES
+#define OWW_DEFAULT_SMOOTHING_FRAMES CONFIG_OPENWAKEWORD_SMOOTHING_FRAMES
+#else
+#define OWW_DEFAULT_SMOOTHING_FRAMES 1
+#endif
+
+// Sound event head cadence and threshold used when the config leaves them at 0
+#ifdef CONFIG_OPENWAKEWORD_EVENT_STRIDE
+#define OWW_DEFAULT_EVENT_STRIDE CONFIG_OPENWAKEWORD_EVENT_STRIDE
+#else
+#define OWW_DEFAULT_EVENT_STRIDE 6
+#endif
+#ifdef CONFIG_OPENWAKEWORD_EVENT_THRESHOLD
+#define OWW_DEFAULT_EVENT_THRESHOLD (CONFIG_OPENWAKEWORD_EVENT_THRESHOLD / 1000.0f)
+#else
+#define OWW_DEFAULT_EVENT_THRESHOLD 0.6f
+#endif
+// Continuous sound (snoring, an alarm) is reported a minute at a time
+#define OWW_EVENT_MAX_MS 60000
+
+static const char *const kDefaultEventLabels[] = { "snore", "cough", "talking", "alarm" };
+
+// Second model partition for updates at runtime
+#ifdef CONFIG_OPENWAKEWORD_MODEL_SPARE_PARTITION
+#define OWW_SPARE_PARTITION CONFIG_OPENWAKEWORD_MODEL_SPARE_PARTITION
+#else
+#define OWW_SPARE_PARTITION "model_b"
+#endif
+#define OWW_MODEL_PARTITION CONFIG_OPENWAKEWORD_MODEL_PARTITION
+
+#define OWW_NVS_NAMESPACE "oww"
+#define OWW_NVS_KEY_PARTITION "model_part"
+
 static const char *TAG = "openwakeword";
 
 struct openwakeword_handle {
@@ -54,18 +99,36 @@ struct openwakeword_handle {
     tflite_wrapper_t *tflite_wrapper;
     uint8_t *model_data;
     size_t model_size;
+    const model_loader_model_t *model_ref;  // Registry entry model_data points into, NULL for a RAM copy
+    const char *model_partition;        // Label model_data is mapped from, NULL for SPIFFS
     float output_buffer[4];  // Buffer for model output
     size_t output_buffer_size;
+    float *model_input;      // Input tensor buffer when the model is float in/out (zero-copy)
+    
+    // Three-stage pipeline (mel -> shared embedding -> classifier heads)
+    embedding_pipeline_t *pipeline;
+    
+    // Sound events from the pipeline's event head
+    const char *event_labels[EMBEDDING_PIPELINE_MAX_EVENT_CLASSES];
+    sound_event_filter_t event_filters[EMBEDDING_PIPELINE_MAX_EVENT_CLASSES];
+    size_t event_class_count;       // Labeled classes, 0 without an event head
+    size_t event_class_offset;      // Leading background score in the output
 #endif
+    openwakeword_event_callback_t event_callback;
+    void *event_user_data;
     bool model_loaded;
+    SemaphoreHandle_t model_lock;  // Held for a frame; openwakeword_swap_model() exchanges the model under it
     
     // Audio processing
     int16_t *audio_buffer;
     size_t audio_buffer_size;
     audio_features_t *audio_features;
     float *melspectrogram_buffer;  // Reusable buffer for melspectrogram
+    float *mel_window;             // Staging buffer for the model's mel window
+    size_t mel_window_frames;      // Rows fed to the model per inference
     
-    // Detection state
+    // Detection state: one filter per head, [0] for the single-model path
+    detection_filter_t filters[EMBEDDING_PIPELINE_MAX_HEADS];
     uint32_t last_detection_tick;
     uint32_t cooldown_ticks;
     
@@ -75,15 +138,394 @@ struct openwakeword_handle {
     uint32_t inference_errors;
     uint32_t preprocessing_errors;
     
-    // Performance timing (approximate, in ticks)
-    uint32_t last_preprocessing_ticks;
-    uint32_t last_inference_ticks;
-    uint32_t total_preprocessing_ticks;
-    uint32_t total_inference_ticks;
-    uint32_t preprocessing_count;
-    uint32_t inference_count;
+    // Stage timing, score history and drops; other tasks read it under stats_lock
+    portMUX_TYPE stats_lock;
+    openwakeword_stats_t stats;
 };
 
+static void stats_stage(openwakeword_handle_t handle, openwakeword_stage_t stage, uint32_t us)
+{
+    size_t bucket = 0;
+    while (bucket < OPENWAKEWORD_STATS_BUCKETS - 1 &&
+           us >= ((uint32_t)OPENWAKEWORD_STATS_BUCKET_BASE_US << bucket)) {
+        bucket++;
+    }
+    portENTER_CRITICAL(&handle->stats_lock);
+    openwakeword_stage_stats_t *s = &handle->stats.stages[stage];
+    s->count++;
+    s->last_us = us;
+    s->total_us += us;
+    if (us > s->max_us) {
+        s->max_us = us;
+    }
+    s->histogram[bucket]++;
+    portEXIT_CRITICAL(&handle->stats_lock);
+}
+
+static void init_filter(openwakeword_handle_t handle, size_t index,
+                        float threshold, uint8_t patience_frames)
+{
+    const openwakeword_config_t *config = &handle->config;
+    detection_filter_config_t fc = {
+        .threshold = threshold > 0.0f ? threshold : config->threshold,
+        .patience_frames = patience_frames ? patience_frames
+                         : config->patience_frames ? config->patience_frames
+                         : OWW_DEFAULT_PATIENCE_FRAMES,
+        .smoothing_frames = config->smoothing_frames ? config->smoothing_frames
+                          : OWW_DEFAULT_SMOOTHING_FRAMES,
+    };
+    detection_filter_init(&handle->filters[index], &fc);
+}
+
+#if TFLITE_AVAILABLE
+static void stats_score(openwakeword_handle_t handle, size_t index, const char *name, float score)
+{
+    if (index >= OPENWAKEWORD_STATS_MAX_WORDS) {
+        return;
+    }
+    portENTER_CRITICAL(&handle->stats_lock);
+    openwakeword_score_stats_t *s = &handle->stats.scores[index];
+    if (!s->name) {
+        // First score since init or reset seeds the average
+        s->name = name;
+        s->ewma = score;
+        s->peak = score;
+    }
+    s->last = score;
+    s->ewma += OPENWAKEWORD_STATS_SCORE_EWMA_ALPHA * (score - s->ewma);
+    if (score > s->peak) {
+        s->peak = score;
+    }
+    if (handle->stats.score_count <= index) {
+        handle->stats.score_count = index + 1;
+    }
+    portEXIT_CRITICAL(&handle->stats_lock);
+}
+
+// Record a frame's score for one wake word and fire the callback if its
+// filter triggers. Returns true on a trigger.
+static bool handle_score(openwakeword_handle_t handle, size_t index, const char *name,
+                         float score, uint32_t now, bool armed)
+{
+    stats_score(handle, index, name, score);
+    detection_filter_t *filter = &handle->filters[index];
+    if (!detection_filter_push(filter, score, armed)) {
+        return false;
+    }
+    
+    handle->last_detection_tick = now;
+    handle->detections_count++;
+    ESP_LOGI(TAG, "*** WAKE WORD DETECTED *** %s confidence: %.2f (threshold: %.2f, %u frames)",
+             name, filter->smoothed, filter->config.threshold,
+             (unsigned)filter->config.patience_frames);
+    if (handle->callback) {
+        handle->callback(name, filter->smoothed, handle->user_data);
+    }
+    return true;
+}
+
+// One single-path model and what process_frame derives from it; built
+// outside the frame lock, then exchanged with the handle's fields
+typedef struct {
+    tflite_wrapper_t *wrapper;
+    uint8_t *data;
+    size_t size;
+    const model_loader_model_t *ref;
+    float *input;
+    size_t mel_window_frames;
+} loaded_model_t;
+
+// Create the interpreter for model->data and work out the mel window it
+// takes. The data stays owned by the caller on failure.
+static esp_err_t model_build(loaded_model_t *model)
+{
+    model->wrapper = tflite_wrapper_create(model->data, model->size, CONFIG_OPENWAKEWORD_TENSOR_ARENA_SIZE);
+    if (!model->wrapper || !tflite_wrapper_is_initialized(model->wrapper)) {
+        ESP_LOGW(TAG, "TFLite wrapper initialization failed");
+        if (model->wrapper) {
+            tflite_wrapper_destroy(model->wrapper);
+            model->wrapper = NULL;
+        }
+        return ESP_FAIL;
+    }
+    
+    size_t input_size = tflite_wrapper_get_input_size(model->wrapper);
+    size_t output_size = tflite_wrapper_get_output_size(model->wrapper);
+    ESP_LOGI(TAG, "TFLite wrapper initialized");
+    ESP_LOGI(TAG, "  Input: %zu floats, Output: %zu floats", input_size, output_size);
+    
+    // Model consumes the newest N mel rows of the rolling window
+    size_t frames = input_size / MELSPEC_N_MELS;
+    if (frames == 0) frames = 1;
+    if (frames > AUDIO_FEATURES_WINDOW_FRAMES) {
+        ESP_LOGW(TAG, "Model wants %zu mel frames, clamping to %d",
+                 frames, AUDIO_FEATURES_WINDOW_FRAMES);
+        frames = AUDIO_FEATURES_WINDOW_FRAMES;
+    }
+    model->mel_window_frames = frames;
+    
+    // Float models get mel rows written straight into the tensor arena
+    tflite_wrapper_type_t in_type = TFLITE_WRAPPER_TYPE_UNKNOWN;
+    tflite_wrapper_type_t out_type = TFLITE_WRAPPER_TYPE_UNKNOWN;
+    void *in_ptr = tflite_wrapper_input_ptr(model->wrapper, &in_type);
+    tflite_wrapper_output_ptr(model->wrapper, &out_type);
+    model->input = NULL;
+    if (in_type == TFLITE_WRAPPER_TYPE_FLOAT32 &&
+        out_type == TFLITE_WRAPPER_TYPE_FLOAT32 &&
+        input_size == frames * MELSPEC_N_MELS) {
+        model->input = (float *)in_ptr;
+    }
+    return ESP_OK;
+}
+
+static void model_release(loaded_model_t *model)
+{
+    if (model->wrapper) {
+        tflite_wrapper_destroy(model->wrapper);
+        model->wrapper = NULL;
+    }
+    if (model->ref) {
+        model_loader_release(model->ref);
+        model->ref = NULL;
+    } else if (model->data) {
+        model_loader_free(model->data);
+    }
+    model->data = NULL;
+}
+
+// Install model in the handle and hand back the one it replaces
+static void model_exchange(openwakeword_handle_t handle, loaded_model_t *model)
+{
+    loaded_model_t old = {
+        .wrapper = handle->tflite_wrapper,
+        .data = handle->model_data,
+        .size = handle->model_size,
+        .ref = handle->model_ref,
+        .input = handle->model_input,
+        .mel_window_frames = handle->mel_window_frames,
+    };
+    handle->tflite_wrapper = model->wrapper;
+    handle->model_data = model->data;
+    handle->model_size = model->size;
+    handle->model_ref = model->ref;
+    handle->model_input = model->input;
+    handle->mel_window_frames = model->mel_window_frames;
+    *model = old;
+}
+
+// Model partition to map at boot: the one last swapped in, else the primary
+static const char *active_partition(void)
+{
+    nvs_handle_t nvs;
+    if (nvs_open(OWW_NVS_NAMESPACE, NVS_READONLY, &nvs) != ESP_OK) {
+        return OWW_MODEL_PARTITION;
+    }
+    char label[sizeof(((esp_partition_t *)0)->label)] = {0};
+    size_t len = sizeof(label);
+    esp_err_t err = nvs_get_str(nvs, OWW_NVS_KEY_PARTITION, label, &len);
+    nvs_close(nvs);
+    if (err == ESP_OK && strcmp(label, OWW_SPARE_PARTITION) == 0) {
+        return OWW_SPARE_PARTITION;
+    }
+    return OWW_MODEL_PARTITION;
+}
+
+static void remember_partition(const char *label)
+{
+    nvs_handle_t nvs;
+    esp_err_t err = nvs_open(OWW_NVS_NAMESPACE, NVS_READWRITE, &nvs);
+    if (err == ESP_OK) {
+        err = nvs_set_str(nvs, OWW_NVS_KEY_PARTITION, label);
+        if (err == ESP_OK) {
+            err = nvs_commit(nvs);
+        }
+        nvs_close(nvs);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Active model partition not persisted: %s", esp_err_to_name(err));
+    }
+}
+
+// Optional: without an event head wake words are detected as before. An
+// output with one score more than there are labels has background first.
+static void init_event_head(openwakeword_handle_t handle, const openwakeword_config_t *config)
+{
+    const char *const *labels = config->event_labels;
+    size_t label_count = config->event_label_count;
+    if (!labels || label_count == 0) {
+        labels = kDefaultEventLabels;
+        label_count = sizeof(kDefaultEventLabels) / sizeof(kDefaultEventLabels[0]);
+    }
+    
+    uint8_t *data = NULL;
+    size_t size = 0;
+    esp_err_t err = model_loader_load_from_spiffs(config->event_model_path, &data, &size);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Sound events off: %s not loaded (%s)", config->event_model_path, esp_err_to_name(err));
+        return;
+    }
+    size_t classes = 0;
+    err = embedding_pipeline_set_event_head(handle->pipeline, data, size, CONFIG_OPENWAKEWORD_TENSOR_ARENA_SIZE,
+                                            config->event_stride ? config->event_stride : OWW_DEFAULT_EVENT_STRIDE,
+                                            &classes);
+    if (err != ESP_OK) {
+        model_loader_free(data);
+        ESP_LOGW(TAG, "Sound events off: %s", esp_err_to_name(err));
+        return;
+    }
+    
+    handle->event_class_offset = classes == label_count + 1 ? 1 : 0;
+    handle->event_class_count = classes - handle->event_class_offset;
+    if (handle->event_class_count > label_count) {
+        handle->event_class_count = label_count;
+    }
+    float threshold = config->event_threshold > 0.0f ? config->event_threshold : OWW_DEFAULT_EVENT_THRESHOLD;
+    sound_event_filter_config_t fc = {
+        .on_threshold = threshold,
+        .off_threshold = threshold * 0.5f,
+        .max_ms = OWW_EVENT_MAX_MS,
+    };
+    for (size_t c = 0; c < handle->event_class_count; c++) {
+        handle->event_labels[c] = labels[c];
+        sound_event_filter_init(&handle->event_filters[c], &fc);
+    }
+    ESP_LOGI(TAG, "Sound events: %zu classes, threshold %.2f", handle->event_class_count, threshold);
+}
+
+// Build the staged pipeline from config->embedding_model_path and the head
+// list. Without explicit heads, model_path is used as the single head.
+static esp_err_t init_pipeline(openwakeword_handle_t handle, const openwakeword_config_t *config)
+{
+    uint8_t *data = NULL;
+    size_t size = 0;
+    
+    ESP_LOGI(TAG, "Loading embedding model from: %s", config->embedding_model_path);
+    esp_err_t err = model_loader_load_from_spiffs(config->embedding_model_path, &data, &size);
+    if (err != ESP_OK) {
+        return err;
+    }
+    
+    handle->pipeline = embedding_pipeline_create(data, size, CONFIG_OPENWAKEWORD_EMBEDDING_ARENA_SIZE);
+    if (!handle->pipeline) {
+        return ESP_FAIL;
+    }
+    
+    openwakeword_head_config_t default_head = {
+        .name = "hey_naptick",
+        .model_path = config->model_path,
+        .threshold = 0.0f,
+    };
+    const openwakeword_head_config_t *heads = config->heads;
+    size_t head_count = config->head_count;
+    if (!heads || head_count == 0) {
+        heads = &default_head;
+        head_count = 1;
+    }
+    
+    for (size_t i = 0; i < head_count; i++) {
+        const openwakeword_head_config_t *hc = &heads[i];
+        if (!hc->model_path || !hc->name) {
+            continue;
+        }
+        err = model_loader_load_from_spiffs(hc->model_path, &data, &size);
+        if (err != ESP_OK) {
+            ESP_LOGW(TAG, "Skipping head '%s': %s", hc->name, esp_err_to_name(err));
+            continue;
+        }
+        size_t index = 0;
+        err = embedding_pipeline_add_head(handle->pipeline, hc->name, data, size,
+                                          CONFIG_OPENWAKEWORD_TENSOR_ARENA_SIZE, &index);
+        if (err != ESP_OK) {
+            model_loader_free(data);
+            continue;
+        }
+        init_filter(handle, index, hc->threshold, hc->patience_frames);
+    }
+    
+    if (embedding_pipeline_head_count(handle->pipeline) == 0) {
+        ESP_LOGE(TAG, "No classifier heads loaded");
+        embedding_pipeline_destroy(handle->pipeline);
+        handle->pipeline = NULL;
+        return ESP_ERR_NOT_FOUND;
+    }
+    if (config->event_model_path && config->event_model_path[0]) {
+        init_event_head(handle, config);
+    }
+    return ESP_OK;
+}
+
+// Run the event head's scores through their filters and report what finished
+static void process_events(openwakeword_handle_t handle)
+{
+    float scores[EMBEDDING_PIPELINE_MAX_EVENT_CLASSES];
+    uint32_t event_us = 0;
+    size_t n = embedding_pipeline_get_event_scores(handle->pipeline, scores,
+                                                   EMBEDDING_PIPELINE_MAX_EVENT_CLASSES, &event_us);
+    if (n == 0) {
+        return;
+    }
+    stats_stage(handle, OPENWAKEWORD_STAGE_EVENTS, event_us);
+    
+    int64_t now_us = openwakeword_stats_now_us();
+    for (size_t c = 0; c < handle->event_class_count && handle->event_class_offset + c < n; c++) {
+        sound_event_t event;
+        if (!sound_event_filter_push(&handle->event_filters[c], scores[handle->event_class_offset + c],
+                                     now_us, &event)) {
+            continue;
+        }
+        portENTER_CRITICAL(&handle->stats_lock);
+        handle->stats.sound_events++;
+        portEXIT_CRITICAL(&handle->stats_lock);
+        ESP_LOGI(TAG, "Sound event %s: %" PRIu32 " ms, confidence %.2f",
+                 handle->event_labels[c], event.duration_ms, event.confidence);
+        if (handle->event_callback) {
+            openwakeword_sound_event_t out = {
+                .label = handle->event_labels[c],
+                .start_us = event.start_us,
+                .duration_ms = event.duration_ms,
+                .confidence = event.confidence,
+            };
+            handle->event_callback(&out, handle->event_user_data);
+        }
+    }
+}
+
+// Advance the staged pipeline and score every head, so each keeps its
+// history through the cooldown. At most one head triggers per frame.
+static esp_err_t process_pipeline(openwakeword_handle_t handle, uint32_t now, bool armed)
+{
+    bool scored = false;
+    esp_err_t err = embedding_pipeline_process(handle->pipeline, handle->audio_features, &scored);
+    if (err != ESP_OK) {
+        handle->inference_errors++;
+        return err;
+    }
+    
+    uint32_t embedding_us = 0;
+    uint32_t classifier_us = 0;
+    embedding_pipeline_get_timing(handle->pipeline, &embedding_us, &classifier_us, NULL);
+    if (embedding_us > 0) {
+        stats_stage(handle, OPENWAKEWORD_STAGE_EMBEDDING, embedding_us);
+    }
+    process_events(handle);
+    if (!scored) {
+        return ESP_OK;
+    }
+    stats_stage(handle, OPENWAKEWORD_STAGE_CLASSIFIER, classifier_us);
+    
+    size_t heads = embedding_pipeline_head_count(handle->pipeline);
+    for (size_t i = 0; i < heads; i++) {
+        const char *name = NULL;
+        float score = 0.0f;
+        embedding_pipeline_get_score(handle->pipeline, i, &name, &score);
+        if (handle_score(handle, i, name, score, now, armed)) {
+            armed = false;
+        }
+    }
+    return ESP_OK;
+}
+#endif
+
 esp_err_t openwakeword_init(const openwakeword_config_t *config,
                             openwakeword_callback_t callback,
                             void *user_data,
@@ -113,10 +555,7 @@ esp_err_t openwakeword_init(const openwakeword_config_t *config,
     handle->detections_count = 0;
     handle->inference_errors = 0;
     handle->preprocessing_errors = 0;
-    handle->preprocessing_count = 0;
-    handle->inference_count = 0;
-    handle->total_preprocessing_ticks = 0;
-    handle->total_inference_ticks = 0;
+    portMUX_INITIALIZE(&handle->stats_lock);
     
     // Calculate audio buffer size
     handle->audio_buffer_size = (config->sample_rate * config->frame_size_ms) / 1000;
@@ -137,6 +576,10 @@ esp_err_t openwakeword_init(const openwakeword_config_t *config,
     // Calculate cooldown ticks
     handle->cooldown_ticks = pdMS_TO_TICKS(config->cooldown_ms);
     handle->last_detection_tick = 0;
+    init_filter(handle, 0, config->threshold, 0);
+    ESP_LOGI(TAG, "  Patience: %u frames, smoothing: %u frames",
+             (unsigned)handle->filters[0].config.patience_frames,
+             (unsigned)handle->filters[0].config.smoothing_frames);
     
     // Allocate melspectrogram buffer
     handle->melspectrogram_buffer = malloc(MELSPEC_N_MELS * sizeof(float));
@@ -147,55 +590,72 @@ esp_err_t openwakeword_init(const openwakeword_config_t *config,
         return ESP_ERR_NO_MEM;
     }
     
+    // Staging buffer sized for the full rolling window so any model input fits
+    handle->mel_window_frames = 1;
+    handle->mel_window = malloc(AUDIO_FEATURES_WINDOW_FRAMES * MELSPEC_N_MELS * sizeof(float));
+    if (!handle->mel_window) {
+        free(handle->melspectrogram_buffer);
+        audio_features_deinit(handle->audio_features);
+        free(handle->audio_buffer);
+        free(handle);
+        return ESP_ERR_NO_MEM;
+    }
+    
     // Load TensorFlow Lite model
     handle->model_loaded = false;
 #if TFLITE_AVAILABLE
     handle->model_data = NULL;
     handle->model_size = 0;
+    handle->model_ref = NULL;
+    handle->model_partition = NULL;
     handle->tflite_wrapper = NULL;
     handle->output_buffer_size = sizeof(handle->output_buffer) / sizeof(float);
+    handle->model_input = NULL;
+    handle->pipeline = NULL;
     
-    if (config->model_path && strlen(config->model_path) > 0) {
+    if (config->embedding_model_path && strlen(config->embedding_model_path) > 0) {
+        esp_err_t err = init_pipeline(handle, config);
+        if (err == ESP_OK) {
+            handle->model_loaded = true;
+            ESP_LOGI(TAG, "Three-stage pipeline ready with %zu head(s)",
+                     embedding_pipeline_head_count(handle->pipeline));
+        } else {
+            ESP_LOGE(TAG, "Pipeline init failed: %s", esp_err_to_name(err));
+        }
+    } else if (config->model_path && strlen(config->model_path) > 0) {
         ESP_LOGI(TAG, "Loading TFLite model from: %s", config->model_path);
         
-        // Try to load from SPIFFS first
-        esp_err_t err = model_loader_load_from_spiffs(config->model_path,
-                                                       &handle->model_data,
-                                                       &handle->model_size);
-        
-        if (err != ESP_OK) {
-            // Fallback: try loading from raw partition
-            ESP_LOGW(TAG, "SPIFFS load failed, trying raw partition");
-            err = model_loader_load_from_partition_raw("model",
-                                                        &handle->model_data,
-                                                        &handle->model_size);
+        // Prefer mapping the model partition in place: no heap copy of the flatbuffer
+        loaded_model_t model = {0};
+        const char *partition = active_partition();
+        esp_err_t err = model_loader_acquire(partition, &model.ref);
+        if (err != ESP_OK && strcmp(partition, OWW_MODEL_PARTITION) != 0) {
+            ESP_LOGW(TAG, "Model partition '%s' not mapped (%s), trying '%s'",
+                     partition, esp_err_to_name(err), OWW_MODEL_PARTITION);
+            partition = OWW_MODEL_PARTITION;
+            err = model_loader_acquire(partition, &model.ref);
+        }
+        if (err == ESP_OK) {
+            // Read-only in flash; the interpreter never writes to the flatbuffer
+            model.data = (uint8_t *)model.ref->data;
+            model.size = model.ref->size;
+            handle->model_partition = partition;
+            ESP_LOGI(TAG, "Model version %" PRIu32 " from '%s'", model.ref->model_version, partition);
+        } else {
+            // Fallback: copy the model from SPIFFS into RAM
+            ESP_LOGW(TAG, "Model partition not mapped (%s), trying SPIFFS", esp_err_to_name(err));
+            err = model_loader_load_from_spiffs(config->model_path, &model.data, &model.size);
         }
         
-        if (err == ESP_OK && handle->model_data) {
-            ESP_LOGI(TAG, "Model loaded: %zu bytes", handle->model_size);
-            
-            // Initialize TFLite wrapper
-            size_t arena_size = CONFIG_OPENWAKEWORD_TENSOR_ARENA_SIZE;
-            handle->tflite_wrapper = tflite_wrapper_create(
-                handle->model_data,
-                handle->model_size,
-                arena_size
-            );
-            
-            if (handle->tflite_wrapper && tflite_wrapper_is_initialized(handle->tflite_wrapper)) {
+        if (err == ESP_OK && model.data) {
+            ESP_LOGI(TAG, "Model loaded: %zu bytes", model.size);
+            if (model_build(&model) == ESP_OK) {
+                model_exchange(handle, &model);
                 handle->model_loaded = true;
-                size_t input_size = tflite_wrapper_get_input_size(handle->tflite_wrapper);
-                size_t output_size = tflite_wrapper_get_output_size(handle->tflite_wrapper);
-                ESP_LOGI(TAG, "TFLite wrapper initialized");
-                ESP_LOGI(TAG, "  Input: %zu floats, Output: %zu floats", input_size, output_size);
             } else {
-                ESP_LOGW(TAG, "TFLite wrapper initialization failed");
                 ESP_LOGW(TAG, "Add esp-tflite-micro component to enable inference");
-                if (handle->tflite_wrapper) {
-                    tflite_wrapper_destroy(handle->tflite_wrapper);
-                    handle->tflite_wrapper = NULL;
-                }
-                handle->model_loaded = false;
+                model_release(&model);
+                handle->model_partition = NULL;
             }
         } else {
             ESP_LOGE(TAG, "Failed to load model: %s", esp_err_to_name(err));
@@ -210,23 +670,24 @@ esp_err_t openwakeword_init(const openwakeword_config_t *config,
     ESP_LOGW(TAG, "  2. Enable CONFIG_OPENWAKEWORD_USE_TFLITE in menuconfig");
 #endif
     
+    handle->model_lock = xSemaphoreCreateMutex();
+    if (!handle->model_lock) {
+        openwakeword_deinit(handle);
+        return ESP_ERR_NO_MEM;
+    }
+    
     *handle_out = handle;
     return ESP_OK;
 }
 
-esp_err_t openwakeword_process_audio(openwakeword_handle_t handle,
-                                     const int16_t *audio_samples,
-                                     size_t sample_count)
+static esp_err_t process_frame(openwakeword_handle_t handle,
+                               const int16_t *audio_samples,
+                               size_t sample_count)
 {
-    if (!handle || !audio_samples) {
-        return ESP_ERR_INVALID_ARG;
-    }
-    
-    // Check if we're in cooldown period
+    // Inside the cooldown audio still goes through features and models;
+    // scores are recorded but cannot trigger
     uint32_t now = xTaskGetTickCount();
-    if (now - handle->last_detection_tick < handle->cooldown_ticks) {
-        return ESP_OK;
-    }
+    bool armed = now - handle->last_detection_tick >= handle->cooldown_ticks;
     
     // Validate sample count matches expected frame size
     size_t expected_samples = handle->audio_buffer_size;
@@ -244,18 +705,18 @@ esp_err_t openwakeword_process_audio(openwakeword_handle_t handle,
         return ESP_ERR_NOT_FINISHED;
     }
     
-    // Step 1: Extract audio features (melspectrogram)
-    TickType_t preprocess_start = xTaskGetTickCount();
-    size_t mel_size = 0;
+    // Step 1: Stream audio through the hop-based melspectrogram extractor.
+    // Every 160-sample hop yields one mel row in the rolling window.
+    int64_t frontend_start = openwakeword_stats_now_us();
+    size_t rows_emitted = 0;
     
-    esp_err_t err = audio_features_extract_melspectrogram(
+    esp_err_t err = audio_features_stream_push(
         handle->audio_features,
         audio_samples,
         sample_count,
-        handle->melspectrogram_buffer,
-        &mel_size
+        &rows_emitted
     );
-    TickType_t preprocess_end = xTaskGetTickCount();
+    uint32_t frontend_us = (uint32_t)(openwakeword_stats_now_us() - frontend_start);
     
     if (err != ESP_OK) {
         ESP_LOGE(TAG, "Failed to extract melspectrogram: %s", esp_err_to_name(err));
@@ -263,11 +724,27 @@ esp_err_t openwakeword_process_audio(openwakeword_handle_t handle,
         return err;
     }
     
-    // Update preprocessing statistics
-    TickType_t preprocess_ticks = preprocess_end - preprocess_start;
-    handle->total_preprocessing_ticks += preprocess_ticks;
-    handle->preprocessing_count++;
+    stats_stage(handle, OPENWAKEWORD_STAGE_FRONTEND, frontend_us);
     handle->total_frames_processed++;
+
+#if TFLITE_AVAILABLE
+    if (handle->pipeline) {
+        return process_pipeline(handle, now, armed);
+    }
+#endif
+    
+    float *mel_dst = handle->mel_window;
+#if TFLITE_AVAILABLE
+    if (handle->model_input) {
+        mel_dst = handle->model_input;
+    }
+#endif
+    if (rows_emitted == 0 ||
+        audio_features_stream_get_window(handle->audio_features, mel_dst,
+                                         handle->mel_window_frames) != ESP_OK) {
+        // Still priming the analysis window
+        return ESP_OK;
+    }
     
     // Step 2: Run TensorFlow Lite inference
 #if TFLITE_AVAILABLE
@@ -279,17 +756,8 @@ esp_err_t openwakeword_process_audio(openwakeword_handle_t handle,
         esp_err_t test_err = openwakeword_test_mode_process(
             handle, audio_samples, sample_count, &test_confidence);
         
-        if (test_err == ESP_OK && test_confidence > handle->config.threshold) {
-            // Test mode detection
-            handle->last_detection_tick = now;
-            handle->detections_count++;
-            
-            ESP_LOGI(TAG, "*** TEST MODE: WAKE WORD DETECTED *** Confidence: %.2f (threshold: %.2f)", 
-                     test_confidence, handle->config.threshold);
-            
-            if (handle->callback) {
-                handle->callback("hey_naptick", test_confidence, handle->user_data);
-            }
+        if (test_err == ESP_OK) {
+            handle_score(handle, 0, "hey_naptick", test_confidence, now, armed);
         }
         
         if (handle->total_frames_processed % 100 == 0) {
@@ -310,22 +778,30 @@ esp_err_t openwakeword_process_audio(openwakeword_handle_t handle,
     
     float confidence = 0.0f;
     size_t output_size = handle->output_buffer_size;
+    size_t mel_size = handle->mel_window_frames * MELSPEC_N_MELS;
     
     // Run TFLite inference
-    TickType_t inference_start = xTaskGetTickCount();
-    esp_err_t err = tflite_wrapper_invoke(
-        handle->tflite_wrapper,
-        handle->melspectrogram_buffer,
-        mel_size,
-        handle->output_buffer,
-        &output_size
-    );
-    TickType_t inference_end = xTaskGetTickCount();
-    
-    // Update inference statistics
-    TickType_t inference_ticks = inference_end - inference_start;
-    handle->total_inference_ticks += inference_ticks;
-    handle->inference_count++;
+    int64_t inference_start = openwakeword_stats_now_us();
+    if (handle->model_input) {
+        // Input already sits in the tensor; read the output in place too
+        err = tflite_wrapper_invoke_in_place(handle->tflite_wrapper);
+        if (err == ESP_OK) {
+            const float *out = tflite_wrapper_output_ptr(handle->tflite_wrapper, NULL);
+            size_t n = tflite_wrapper_get_output_size(handle->tflite_wrapper);
+            output_size = (n < output_size) ? n : output_size;
+            memcpy(handle->output_buffer, out, output_size * sizeof(float));
+        }
+    } else {
+        err = tflite_wrapper_invoke(
+            handle->tflite_wrapper,
+            handle->mel_window,
+            mel_size,
+            handle->output_buffer,
+            &output_size
+        );
+    }
+    stats_stage(handle, OPENWAKEWORD_STAGE_CLASSIFIER,
+                (uint32_t)(openwakeword_stats_now_us() - inference_start));
     
     if (err == ESP_OK && output_size > 0) {
         // Get confidence from output
@@ -344,20 +820,10 @@ esp_err_t openwakeword_process_audio(openwakeword_handle_t handle,
         return err;
     }
     
-    // Step 3: Check if score exceeds threshold
-    if (confidence > handle->config.threshold) {
-        // Step 4: Call callback if detected
-        handle->last_detection_tick = now;
-        handle->detections_count++;
-        
-        ESP_LOGI(TAG, "*** WAKE WORD DETECTED *** Confidence: %.2f (threshold: %.2f)", 
-                 confidence, handle->config.threshold);
-        
-        if (handle->callback) {
-            handle->callback("hey_naptick", confidence, handle->user_data);
-        }
-    }
+    // Step 3: Smooth, apply patience and call back on a trigger
+    handle_score(handle, 0, "hey_naptick", confidence, now, armed);
 #else
+    (void)armed;
     // Without TFLite, just log that we're processing
     if (handle->total_frames_processed % 100 == 0) {
         ESP_LOGD(TAG, "Processed %" PRIu32 " audio frames (TFLite not enabled)", 
@@ -368,6 +834,31 @@ esp_err_t openwakeword_process_audio(openwakeword_handle_t handle,
     return ESP_OK;
 }
 
+esp_err_t openwakeword_process_audio(openwakeword_handle_t handle,
+                                     const int16_t *audio_samples,
+                                     size_t sample_count)
+{
+    if (!handle || !audio_samples) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    int64_t start = openwakeword_stats_now_us();
+    xSemaphoreTake(handle->model_lock, portMAX_DELAY);
+    esp_err_t err = process_frame(handle, audio_samples, sample_count);
+    xSemaphoreGive(handle->model_lock);
+    uint32_t busy_us = (uint32_t)(openwakeword_stats_now_us() - start);
+    uint64_t audio_us = (uint64_t)sample_count * 1000000 / handle->config.sample_rate;
+    
+    portENTER_CRITICAL(&handle->stats_lock);
+    handle->stats.busy_us += busy_us;
+    handle->stats.audio_us += audio_us;
+    if (busy_us > handle->stats.max_frame_us) {
+        handle->stats.max_frame_us = busy_us;
+    }
+    portEXIT_CRITICAL(&handle->stats_lock);
+    return err;
+}
+
 esp_err_t openwakeword_deinit(openwakeword_handle_t handle)
 {
     if (!handle) {
@@ -377,6 +868,9 @@ esp_err_t openwakeword_deinit(openwakeword_handle_t handle)
     ESP_LOGI(TAG, "Deinitializing OpenWakeWord");
     ESP_LOGI(TAG, "  Total frames processed: %" PRIu32, handle->total_frames_processed);
     ESP_LOGI(TAG, "  Detections: %" PRIu32, handle->detections_count);
+    if (handle->stats.audio_us > 0) {
+        ESP_LOGI(TAG, "  Real-time factor: %.3f", (double)handle->stats.busy_us / (double)handle->stats.audio_us);
+    }
     
     if (handle->audio_features) {
         audio_features_deinit(handle->audio_features);
@@ -390,23 +884,126 @@ esp_err_t openwakeword_deinit(openwakeword_handle_t handle)
         free(handle->melspectrogram_buffer);
     }
     
+    if (handle->mel_window) {
+        free(handle->mel_window);
+    }
+
 #if TFLITE_AVAILABLE
     // Free TFLite resources
+    if (handle->pipeline) {
+        embedding_pipeline_destroy(handle->pipeline);
+        handle->pipeline = NULL;
+    }
+    
     if (handle->tflite_wrapper) {
         tflite_wrapper_destroy(handle->tflite_wrapper);
         handle->tflite_wrapper = NULL;
     }
     
-    if (handle->model_data) {
+    if (handle->model_ref) {
+        model_loader_release(handle->model_ref);
+    } else if (handle->model_data) {
         model_loader_free(handle->model_data);
-        handle->model_data = NULL;
     }
+    handle->model_data = NULL;
 #endif
     
+    if (handle->model_lock) {
+        vSemaphoreDelete(handle->model_lock);
+    }
     free(handle);
     return ESP_OK;
 }
 
+esp_err_t openwakeword_swap_model(openwakeword_handle_t handle, const char *partition_name)
+{
+    if (!handle || !partition_name) {
+        return ESP_ERR_INVALID_ARG;
+    }
+#if TFLITE_AVAILABLE
+    if (handle->pipeline) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    // Keep the Kconfig literal: it outlives the caller's string and identifies the slot
+    const char *label = strcmp(partition_name, OWW_SPARE_PARTITION) == 0 ? OWW_SPARE_PARTITION
+                      : strcmp(partition_name, OWW_MODEL_PARTITION) == 0 ? OWW_MODEL_PARTITION
+                      : NULL;
+    if (!label) {
+        ESP_LOGE(TAG, "'%s' is not a model partition", partition_name);
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    int64_t start = openwakeword_stats_now_us();
+    loaded_model_t model = {0};
+    esp_err_t err = model_loader_acquire(label, &model.ref);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "New model in '%s' not usable: %s", label, esp_err_to_name(err));
+        return err;
+    }
+    model.data = (uint8_t *)model.ref->data;
+    model.size = model.ref->size;
+    
+    // The slow part runs here while frames keep flowing through the old model
+    err = model_build(&model);
+    if (err != ESP_OK) {
+        model_release(&model);
+        return err;
+    }
+    
+    xSemaphoreTake(handle->model_lock, portMAX_DELAY);
+    model_exchange(handle, &model);
+    handle->model_partition = label;
+    handle->model_loaded = true;
+    // Scores from the old model say nothing about the new one's scale
+    detection_filter_reset(&handle->filters[0]);
+    xSemaphoreGive(handle->model_lock);
+    
+    model_release(&model);
+    remember_partition(label);
+    ESP_LOGI(TAG, "Swapped in model from '%s': %zu bytes, %" PRId64 " ms",
+             label, handle->model_size, (openwakeword_stats_now_us() - start) / 1000);
+    return ESP_OK;
+#else
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
+const char *openwakeword_spare_partition(openwakeword_handle_t handle)
+{
+#if TFLITE_AVAILABLE
+    if (handle && handle->model_partition &&
+        strcmp(handle->model_partition, OWW_SPARE_PARTITION) == 0) {
+        return OWW_MODEL_PARTITION;
+    }
+#else
+    (void)handle;
+#endif
+    return OWW_SPARE_PARTITION;
+}
+
+esp_err_t openwakeword_attach_spectrum(openwakeword_handle_t handle,
+                                       audio_spectrum_t *spectrum)
+{
+    if (!handle) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    audio_features_stream_set_row_cb(handle->audio_features,
+                                     spectrum ? audio_spectrum_push_row : NULL, spectrum);
+    return ESP_OK;
+}
+
+esp_err_t openwakeword_set_event_callback(openwakeword_handle_t handle,
+                                          openwakeword_event_callback_t callback,
+                                          void *user_data)
+{
+    if (!handle) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    handle->event_user_data = user_data;
+    handle->event_callback = callback;
+    return ESP_OK;
+}
+
 esp_err_t openwakeword_get_input_requirements(openwakeword_handle_t handle,
                                                size_t *samples_out)
 {
@@ -438,4 +1035,83 @@ esp_err_t openwakeword_get_statistics(openwakeword_handle_t handle,
     }
     
     return ESP_OK;
-}
\ No newline at end of file
+}
+esp_err_t openwakeword_get_stats(openwakeword_handle_t handle, openwakeword_stats_t *stats_out)
+{
+    if (!handle || !stats_out) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    portENTER_CRITICAL(&handle->stats_lock);
+    *stats_out = handle->stats;
+    portEXIT_CRITICAL(&handle->stats_lock);
+    
+    stats_out->total_frames_processed = handle->total_frames_processed;
+    stats_out->detections_count = handle->detections_count;
+    stats_out->inference_errors = handle->inference_errors;
+    stats_out->preprocessing_errors = handle->preprocessing_errors;
+    stats_out->real_time_factor = stats_out->audio_us > 0
+        ? (float)((double)stats_out->busy_us / (double)stats_out->audio_us) : 0.0f;
+    stats_out->audio_buffer_size_bytes = handle->audio_buffer_size * sizeof(int16_t);
+    stats_out->model_loaded = handle->model_loaded;
+#ifdef CONFIG_OPENWAKEWORD_TEST_MODE
+    stats_out->test_mode_enabled = true;
+#endif
+#if TFLITE_AVAILABLE
+    if (handle->pipeline) {
+        embedding_pipeline_get_timing(handle->pipeline, NULL, NULL, &stats_out->embedding_steps_skipped);
+        stats_out->tflite_initialized = true;
+    } else {
+        // The wrapper may be swapped out from another task
+        xSemaphoreTake(handle->model_lock, portMAX_DELAY);
+        if (handle->tflite_wrapper) {
+            stats_out->model_size_bytes = handle->model_size;
+            tflite_wrapper_get_arena_usage(handle->tflite_wrapper, NULL, &stats_out->tensor_arena_size_bytes);
+            stats_out->tflite_initialized = true;
+        }
+        xSemaphoreGive(handle->model_lock);
+    }
+#endif
+    return ESP_OK;
+}
+
+esp_err_t openwakeword_reset_stats(openwakeword_handle_t handle)
+{
+    if (!handle) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    portENTER_CRITICAL(&handle->stats_lock);
+    memset(&handle->stats, 0, sizeof(handle->stats));
+    portEXIT_CRITICAL(&handle->stats_lock);
+    return ESP_OK;
+}
+
+void openwakeword_note_dropped(openwakeword_handle_t handle, uint32_t frames)
+{
+    if (!handle) {
+        return;
+    }
+    portENTER_CRITICAL(&handle->stats_lock);
+    handle->stats.frames_dropped += frames;
+    portEXIT_CRITICAL(&handle->stats_lock);
+}
+
+uint32_t openwakeword_stats_percentile_us(const openwakeword_stage_stats_t *stage, float pct)
+{
+    if (!stage || stage->count == 0) {
+        return 0;
+    }
+    // Rank of the percentile run, 1-based
+    uint32_t rank = (uint32_t)(pct / 100.0f * (float)stage->count + 0.5f);
+    if (rank < 1) {
+        rank = 1;
+    }
+    uint32_t seen = 0;
+    for (size_t i = 0; i < OPENWAKEWORD_STATS_BUCKETS - 1; i++) {
+        seen += stage->histogram[i];
+        if (seen >= rank) {
+            return (uint32_t)OPENWAKEWORD_STATS_BUCKET_BASE_US << i;
+        }
+    }
+    return UINT32_MAX;
+}
@@ -0,0 +1,58 @@
+/**
+ * @file sound_event_filter.c
+ * @brief Hysteresis and splitting for sound events
+ */
+
+#include "sound_event_filter.h"
+#include <string.h>
+
+void sound_event_filter_init(sound_event_filter_t *filter, const sound_event_filter_config_t *config)
+{
+    memset(filter, 0, sizeof(*filter));
+    filter->config = *config;
+    if (filter->config.off_threshold > filter->config.on_threshold) {
+        filter->config.off_threshold = filter->config.on_threshold;
+    }
+}
+
+void sound_event_filter_reset(sound_event_filter_t *filter)
+{
+    filter->active = false;
+    filter->peak = 0.0f;
+}
+
+static void finish(const sound_event_filter_t *filter, int64_t now_us, sound_event_t *event_out)
+{
+    event_out->start_us = filter->start_us;
+    event_out->duration_ms = (uint32_t)((now_us - filter->start_us) / 1000);
+    event_out->confidence = filter->peak;
+}
+
+bool sound_event_filter_push(sound_event_filter_t *filter, float score, int64_t now_us, sound_event_t *event_out)
+{
+    if (!filter->active) {
+        if (score >= filter->config.on_threshold) {
+            filter->active = true;
+            filter->start_us = now_us;
+            filter->peak = score;
+        }
+        return false;
+    }
+
+    if (score < filter->config.off_threshold) {
+        filter->active = false;
+        finish(filter, now_us, event_out);
+        return true;
+    }
+    if (score > filter->peak) {
+        filter->peak = score;
+    }
+    if (filter->config.max_ms && now_us - filter->start_us >= (int64_t)filter->config.max_ms * 1000) {
+        // Report what has run so far and carry on with a new piece
+        finish(filter, now_us, event_out);
+        filter->start_us = now_us;
+        filter->peak = score;
+        return true;
+    }
+    return false;
+}
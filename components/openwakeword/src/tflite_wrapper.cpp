@@ -10,6 +10,12 @@
 #include "esp_err.h"
 #include <string.h>
 #include <stdlib.h>
+#include <math.h>
+#include <stdio.h>
+#include <inttypes.h>
+#include "esp_heap_caps.h"
+#include "esp_rom_crc.h"
+#include "nvs.h"
 
 static const char *TAG = "tflite_wrapper";
 
@@ -18,18 +24,30 @@ static const char *TAG = "tflite_wrapper";
 // Include TFLite headers when available
 #if __has_include("tensorflow/lite/micro/micro_interpreter.h")
 #include "tensorflow/lite/micro/micro_interpreter.h"
+#include "tensorflow/lite/micro/micro_allocator.h"
 #include "tensorflow/lite/micro/micro_log.h"
 #include "tensorflow/lite/schema/schema_generated.h"
-#include "tensorflow/lite/micro/all_ops_resolver.h"
+#include "tensorflow/lite/schema/schema_utils.h"
+#include "tensorflow/lite/micro/micro_mutable_op_resolver.h"
 #define TFLITE_HEADERS_AVAILABLE 1
 #else
 #define TFLITE_HEADERS_AVAILABLE 0
 #endif
 
+// Upper bound on distinct builtin ops registered per model
+#define TFLITE_WRAPPER_MAX_OPS 24
+
+#if TFLITE_HEADERS_AVAILABLE
+typedef tflite::MicroMutableOpResolver<TFLITE_WRAPPER_MAX_OPS> wrapper_op_resolver_t;
+#endif
+
 struct tflite_wrapper {
 #if TFLITE_HEADERS_AVAILABLE
     tflite::MicroInterpreter* interpreter;
     const tflite::Model* model;
+    wrapper_op_resolver_t* resolver;
+    TfLiteTensor* input;
+    TfLiteTensor* output;
 #else
     void* interpreter;
     void* model;
@@ -38,92 +56,560 @@ struct tflite_wrapper {
     size_t model_size;
     uint8_t *tensor_arena;
     size_t tensor_arena_size;
-    float *input_tensor;
-    float *output_tensor;
-    size_t input_size;
+    size_t input_size;            // Elements, not bytes
     size_t output_size;
+    tflite_wrapper_group_t* group; // Set for group members, which do not own their arena
     bool initialized;
 };
 
-extern "C" {
+struct tflite_wrapper_group {
+    tflite_wrapper_t* members[TFLITE_WRAPPER_GROUP_MAX];
+    size_t count;
+    uint8_t* arena;
+    size_t arena_size;
+    size_t used;                  // All members together, after AllocateTensors()
+};
 
-tflite_wrapper_t* tflite_wrapper_create(const uint8_t* model_data, 
-                                         size_t model_size,
-                                         size_t tensor_arena_size)
+#if TFLITE_HEADERS_AVAILABLE
+// Register only the builtin ops the model references, so only those kernels
+// are linked and looked up. On ESP32-S3, esp-tflite-micro backs CONV_2D,
+// DEPTHWISE_CONV_2D, FULLY_CONNECTED, ADD, MUL, pooling and SOFTMAX with
+// esp-nn optimized int8 kernels.
+static bool register_model_ops(const tflite::Model* model, wrapper_op_resolver_t* resolver)
 {
-    if (!model_data || model_size == 0) {
-        ESP_LOGE(TAG, "Invalid model data");
-        return NULL;
+    auto* opcodes = model->operator_codes();
+    if (!opcodes) {
+        return true;
     }
     
-    tflite_wrapper_t* wrapper = (tflite_wrapper_t*)calloc(1, sizeof(tflite_wrapper_t));
-    if (!wrapper) {
-        return NULL;
+    // A builtin may appear more than once in operator_codes (e.g. under two
+    // versions), and the resolver rejects a second Add of the same op
+    tflite::BuiltinOperator added[TFLITE_WRAPPER_MAX_OPS];
+    size_t added_count = 0;
+    bool ok = true;
+    for (size_t i = 0; i < opcodes->size(); i++) {
+        tflite::BuiltinOperator op = tflite::GetBuiltinCode(opcodes->Get(i));
+        bool seen = false;
+        for (size_t j = 0; j < added_count && !seen; j++) {
+            seen = added[j] == op;
+        }
+        if (seen) {
+            continue;
+        }
+        TfLiteStatus status;
+        switch (op) {
+            case tflite::BuiltinOperator_CONV_2D:           status = resolver->AddConv2D(); break;
+            case tflite::BuiltinOperator_DEPTHWISE_CONV_2D: status = resolver->AddDepthwiseConv2D(); break;
+            case tflite::BuiltinOperator_FULLY_CONNECTED:   status = resolver->AddFullyConnected(); break;
+            case tflite::BuiltinOperator_BATCH_MATMUL:      status = resolver->AddBatchMatMul(); break;
+            case tflite::BuiltinOperator_ADD:               status = resolver->AddAdd(); break;
+            case tflite::BuiltinOperator_SUB:               status = resolver->AddSub(); break;
+            case tflite::BuiltinOperator_MUL:               status = resolver->AddMul(); break;
+            case tflite::BuiltinOperator_MEAN:              status = resolver->AddMean(); break;
+            case tflite::BuiltinOperator_MAX_POOL_2D:       status = resolver->AddMaxPool2D(); break;
+            case tflite::BuiltinOperator_AVERAGE_POOL_2D:   status = resolver->AddAveragePool2D(); break;
+            case tflite::BuiltinOperator_RELU:              status = resolver->AddRelu(); break;
+            case tflite::BuiltinOperator_RELU6:             status = resolver->AddRelu6(); break;
+            case tflite::BuiltinOperator_LEAKY_RELU:        status = resolver->AddLeakyRelu(); break;
+            case tflite::BuiltinOperator_LOGISTIC:          status = resolver->AddLogistic(); break;
+            case tflite::BuiltinOperator_TANH:              status = resolver->AddTanh(); break;
+            case tflite::BuiltinOperator_SOFTMAX:           status = resolver->AddSoftmax(); break;
+            case tflite::BuiltinOperator_RESHAPE:           status = resolver->AddReshape(); break;
+            case tflite::BuiltinOperator_SQUEEZE:           status = resolver->AddSqueeze(); break;
+            case tflite::BuiltinOperator_EXPAND_DIMS:       status = resolver->AddExpandDims(); break;
+            case tflite::BuiltinOperator_CONCATENATION:     status = resolver->AddConcatenation(); break;
+            case tflite::BuiltinOperator_PAD:               status = resolver->AddPad(); break;
+            case tflite::BuiltinOperator_TRANSPOSE:         status = resolver->AddTranspose(); break;
+            case tflite::BuiltinOperator_STRIDED_SLICE:     status = resolver->AddStridedSlice(); break;
+            case tflite::BuiltinOperator_QUANTIZE:          status = resolver->AddQuantize(); break;
+            case tflite::BuiltinOperator_DEQUANTIZE:        status = resolver->AddDequantize(); break;
+            default:
+                ESP_LOGE(TAG, "Unsupported op in model: %s (%d)",
+                         tflite::EnumNameBuiltinOperator(op), (int)op);
+                ok = false;
+                continue;
+        }
+        if (status != kTfLiteOk) {
+            ESP_LOGE(TAG, "Failed to register op %s", tflite::EnumNameBuiltinOperator(op));
+            ok = false;
+        } else if (added_count < TFLITE_WRAPPER_MAX_OPS) {
+            added[added_count++] = op;
+        }
+    }
+    return ok;
+}
+
+static size_t tensor_element_count(const TfLiteTensor* t)
+{
+    switch (t->type) {
+        case kTfLiteFloat32: return t->bytes / sizeof(float);
+        case kTfLiteInt8:
+        case kTfLiteUInt8:   return t->bytes;
+        case kTfLiteInt16:   return t->bytes / sizeof(int16_t);
+        default:             return 0;
+    }
+}
+
+static tflite_wrapper_type_t wrapper_type(const TfLiteTensor* t)
+{
+    switch (t->type) {
+        case kTfLiteFloat32: return TFLITE_WRAPPER_TYPE_FLOAT32;
+        case kTfLiteInt8:    return TFLITE_WRAPPER_TYPE_INT8;
+        case kTfLiteUInt8:   return TFLITE_WRAPPER_TYPE_UINT8;
+        case kTfLiteInt16:   return TFLITE_WRAPPER_TYPE_INT16;
+        default:             return TFLITE_WRAPPER_TYPE_UNKNOWN;
+    }
+}
+
+// Write float input into the tensor, quantizing with its scale/zero-point
+static void quantize_into(TfLiteTensor* t, const float* src, size_t n)
+{
+    if (t->type == kTfLiteFloat32) {
+        memcpy(t->data.f, src, n * sizeof(float));
+        return;
     }
     
-    wrapper->model_data = (uint8_t*)model_data;
-    wrapper->model_size = model_size;
-    wrapper->tensor_arena_size = tensor_arena_size;
+    const float inv_scale = 1.0f / t->params.scale;
+    const int32_t zp = t->params.zero_point;
+    if (t->type == kTfLiteInt8) {
+        for (size_t i = 0; i < n; i++) {
+            int32_t q = (int32_t)lrintf(src[i] * inv_scale) + zp;
+            t->data.int8[i] = (int8_t)(q < -128 ? -128 : (q > 127 ? 127 : q));
+        }
+    } else if (t->type == kTfLiteUInt8) {
+        for (size_t i = 0; i < n; i++) {
+            int32_t q = (int32_t)lrintf(src[i] * inv_scale) + zp;
+            t->data.uint8[i] = (uint8_t)(q < 0 ? 0 : (q > 255 ? 255 : q));
+        }
+    } else if (t->type == kTfLiteInt16) {
+        for (size_t i = 0; i < n; i++) {
+            int32_t q = (int32_t)lrintf(src[i] * inv_scale) + zp;
+            t->data.i16[i] = (int16_t)(q < -32768 ? -32768 : (q > 32767 ? 32767 : q));
+        }
+    }
+}
+
+// Read tensor output as float, dequantizing with its scale/zero-point
+static void dequantize_from(const TfLiteTensor* t, float* dst, size_t n)
+{
+    if (t->type == kTfLiteFloat32) {
+        memcpy(dst, t->data.f, n * sizeof(float));
+        return;
+    }
+    
+    const float scale = t->params.scale;
+    const int32_t zp = t->params.zero_point;
+    for (size_t i = 0; i < n; i++) {
+        int32_t q;
+        if (t->type == kTfLiteInt8) {
+            q = t->data.int8[i];
+        } else if (t->type == kTfLiteUInt8) {
+            q = t->data.uint8[i];
+        } else {
+            q = t->data.i16[i];
+        }
+        dst[i] = (float)(q - zp) * scale;
+    }
+}
+#endif
+
+// Slack added to the measured arena size (alignment of the final allocation)
+#define TFLITE_WRAPPER_ARENA_MARGIN 1024
+#define TFLITE_WRAPPER_ARENA_ALIGN 16
+
+#define ARENA_NVS_NAMESPACE "tflite_arena"
+
+#ifdef CONFIG_OPENWAKEWORD_ARENA_AUTO_SIZE
+#define ARENA_AUTO_SIZE true
+#else
+#define ARENA_AUTO_SIZE false
+#endif
+
+#ifdef CONFIG_OPENWAKEWORD_ARENA_INTERNAL_RESERVE
+#define ARENA_INTERNAL_RESERVE CONFIG_OPENWAKEWORD_ARENA_INTERNAL_RESERVE
+#else
+#define ARENA_INTERNAL_RESERVE (64 * 1024)
+#endif
+
+#if defined(CONFIG_OPENWAKEWORD_ARENA_INTERNAL)
+#define DEFAULT_ARENA_PLACEMENT TFLITE_WRAPPER_ARENA_INTERNAL
+#elif defined(CONFIG_OPENWAKEWORD_ARENA_PSRAM)
+#define DEFAULT_ARENA_PLACEMENT TFLITE_WRAPPER_ARENA_PSRAM
+#elif defined(CONFIG_OPENWAKEWORD_ARENA_DMA)
+#define DEFAULT_ARENA_PLACEMENT TFLITE_WRAPPER_ARENA_DMA
+#else
+#define DEFAULT_ARENA_PLACEMENT TFLITE_WRAPPER_ARENA_AUTO
+#endif
+
+#define CAPS_INTERNAL (MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT)
+#define CAPS_PSRAM    (MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT)
+#define CAPS_DMA      (MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT)
+
+#if TFLITE_HEADERS_AVAILABLE
+// Allocate a 16-byte aligned arena according to the placement policy
+static uint8_t* arena_alloc(size_t size, tflite_wrapper_arena_placement_t placement)
+{
+    void* arena = NULL;
+    const char* where = "internal";
+    switch (placement) {
+        case TFLITE_WRAPPER_ARENA_INTERNAL:
+            arena = heap_caps_aligned_alloc(TFLITE_WRAPPER_ARENA_ALIGN, size, CAPS_INTERNAL);
+            break;
+        case TFLITE_WRAPPER_ARENA_DMA:
+            arena = heap_caps_aligned_alloc(TFLITE_WRAPPER_ARENA_ALIGN, size, CAPS_DMA);
+            where = "DMA";
+            break;
+        case TFLITE_WRAPPER_ARENA_PSRAM:
+            arena = heap_caps_aligned_alloc(TFLITE_WRAPPER_ARENA_ALIGN, size, CAPS_PSRAM);
+            where = "PSRAM";
+            if (!arena) {
+                arena = heap_caps_aligned_alloc(TFLITE_WRAPPER_ARENA_ALIGN, size, CAPS_INTERNAL);
+                where = "internal";
+            }
+            break;
+        case TFLITE_WRAPPER_ARENA_AUTO:
+        default:
+            // Keep internal SRAM for AFE/audio buffers unless there is room to spare
+            if (heap_caps_get_largest_free_block(CAPS_INTERNAL) >= size + ARENA_INTERNAL_RESERVE) {
+                arena = heap_caps_aligned_alloc(TFLITE_WRAPPER_ARENA_ALIGN, size, CAPS_INTERNAL);
+            }
+            if (!arena) {
+                arena = heap_caps_aligned_alloc(TFLITE_WRAPPER_ARENA_ALIGN, size, CAPS_PSRAM);
+                where = "PSRAM";
+            }
+            if (!arena) {
+                arena = heap_caps_aligned_alloc(TFLITE_WRAPPER_ARENA_ALIGN, size, CAPS_INTERNAL);
+                where = "internal";
+            }
+            break;
+    }
     
-    // Allocate tensor arena
-    wrapper->tensor_arena = (uint8_t*)malloc(tensor_arena_size);
+    if (arena) {
+        ESP_LOGI(TAG, "Tensor arena: %zu bytes in %s RAM", size, where);
+    } else {
+        ESP_LOGE(TAG, "Failed to allocate %zu byte tensor arena", size);
+    }
+    return (uint8_t*)arena;
+}
+
+static size_t trimmed_arena_size(size_t used)
+{
+    size_t size = used + TFLITE_WRAPPER_ARENA_MARGIN;
+    return (size + TFLITE_WRAPPER_ARENA_ALIGN - 1) & ~(size_t)(TFLITE_WRAPPER_ARENA_ALIGN - 1);
+}
+
+static void arena_cache_key(uint32_t model_crc, char* key, size_t key_len)
+{
+    snprintf(key, key_len, "m%08" PRIx32, model_crc);
+}
+
+static bool arena_cache_load(uint32_t model_crc, size_t* size_out)
+{
+    nvs_handle_t nvs;
+    if (nvs_open(ARENA_NVS_NAMESPACE, NVS_READONLY, &nvs) != ESP_OK) {
+        return false;
+    }
+    char key[NVS_KEY_NAME_MAX_SIZE];
+    arena_cache_key(model_crc, key, sizeof(key));
+    uint32_t size = 0;
+    esp_err_t err = nvs_get_u32(nvs, key, &size);
+    nvs_close(nvs);
+    if (err != ESP_OK || size == 0) {
+        return false;
+    }
+    *size_out = size;
+    return true;
+}
+
+static void arena_cache_store(uint32_t model_crc, size_t size)
+{
+    nvs_handle_t nvs;
+    esp_err_t err = nvs_open(ARENA_NVS_NAMESPACE, NVS_READWRITE, &nvs);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Arena size not persisted: %s", esp_err_to_name(err));
+        return;
+    }
+    char key[NVS_KEY_NAME_MAX_SIZE];
+    arena_cache_key(model_crc, key, sizeof(key));
+    err = nvs_set_u32(nvs, key, (uint32_t)size);
+    if (err == ESP_OK) {
+        err = nvs_commit(nvs);
+    }
+    nvs_close(nvs);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Arena size not persisted: %s", esp_err_to_name(err));
+    }
+}
+
+static void arena_cache_erase(uint32_t model_crc)
+{
+    nvs_handle_t nvs;
+    if (nvs_open(ARENA_NVS_NAMESPACE, NVS_READWRITE, &nvs) != ESP_OK) {
+        return;
+    }
+    char key[NVS_KEY_NAME_MAX_SIZE];
+    arena_cache_key(model_crc, key, sizeof(key));
+    nvs_erase_key(nvs, key);
+    nvs_commit(nvs);
+    nvs_close(nvs);
+}
+
+static void release_interpreter(tflite_wrapper_t* wrapper)
+{
+    if (wrapper->interpreter) {
+        delete wrapper->interpreter;
+        wrapper->interpreter = NULL;
+    }
+    if (wrapper->tensor_arena) {
+        heap_caps_free(wrapper->tensor_arena);
+        wrapper->tensor_arena = NULL;
+    }
+    wrapper->tensor_arena_size = 0;
+}
+
+// Allocate the arena, create the interpreter and plan the tensors
+static esp_err_t build_interpreter(tflite_wrapper_t* wrapper, size_t arena_size,
+                                   tflite_wrapper_arena_placement_t placement)
+{
+    wrapper->tensor_arena = arena_alloc(arena_size, placement);
     if (!wrapper->tensor_arena) {
-        free(wrapper);
+        return ESP_ERR_NO_MEM;
+    }
+    wrapper->tensor_arena_size = arena_size;
+    
+    wrapper->interpreter = new tflite::MicroInterpreter(
+        wrapper->model, *wrapper->resolver, wrapper->tensor_arena, arena_size);
+    if (!wrapper->interpreter) {
+        ESP_LOGE(TAG, "Failed to create interpreter");
+        release_interpreter(wrapper);
+        return ESP_ERR_NO_MEM;
+    }
+    
+    if (wrapper->interpreter->AllocateTensors() != kTfLiteOk) {
+        ESP_LOGE(TAG, "Failed to allocate tensors in %zu byte arena", arena_size);
+        release_interpreter(wrapper);
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+static void release_group(tflite_wrapper_group_t* group)
+{
+    for (size_t i = 0; i < group->count; i++) {
+        delete group->members[i]->interpreter;
+        group->members[i]->interpreter = NULL;
+    }
+    if (group->arena) {
+        heap_caps_free(group->arena);
+        group->arena = NULL;
+    }
+    group->arena_size = 0;
+    group->used = 0;
+}
+
+// One MicroAllocator over the arena serves every member: persistent
+// allocations stack up from the tail, while the scratch head is planned for
+// the largest member and reused by all of them
+static esp_err_t build_group(tflite_wrapper_group_t* group, size_t arena_size,
+                             tflite_wrapper_arena_placement_t placement)
+{
+    group->arena = arena_alloc(arena_size, placement);
+    if (!group->arena) {
+        return ESP_ERR_NO_MEM;
+    }
+    group->arena_size = arena_size;
+    
+    tflite::MicroAllocator* allocator = tflite::MicroAllocator::Create(group->arena, arena_size);
+    if (!allocator) {
+        release_group(group);
+        return ESP_ERR_NO_MEM;
+    }
+    for (size_t i = 0; i < group->count; i++) {
+        tflite_wrapper_t* member = group->members[i];
+        member->interpreter = new tflite::MicroInterpreter(member->model, *member->resolver, allocator);
+        if (!member->interpreter || member->interpreter->AllocateTensors() != kTfLiteOk) {
+            ESP_LOGE(TAG, "Failed to allocate tensors for group member %zu in %zu byte arena", i, arena_size);
+            release_group(group);
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    group->used = allocator->used_bytes();
+    return ESP_OK;
+}
+
+// Choose the arena size from config and build into it: a size cached in NVS,
+// a probe at config->arena_size trimmed to what was used, or
+// config->arena_size as is. A stale cached size is re-probed once. build()
+// releases everything itself when it fails.
+template <typename Build, typename Used, typename Release>
+static esp_err_t plan_and_build(const tflite_wrapper_config_t* config, uint32_t model_crc,
+                                Build build, Used used, Release release)
+{
+    // The probe is freed straight away, so prefer PSRAM to avoid fragmenting SRAM
+    auto probe = [&]() -> size_t {
+        if (build(config->arena_size, TFLITE_WRAPPER_ARENA_PSRAM) != ESP_OK) {
+            return 0;
+        }
+        size_t needed = used();
+        release();
+        ESP_LOGI(TAG, "Probed arena: model needs %zu bytes", needed);
+        return needed;
+    };
+    
+    size_t arena_size = config->arena_size;
+    bool from_cache = false;
+    if (config->auto_size) {
+        if (config->persist_size) {
+            size_t cached = 0;
+            if (arena_cache_load(model_crc, &cached)) {
+                arena_size = cached;
+                from_cache = true;
+                ESP_LOGI(TAG, "Arena size from NVS: %zu bytes", arena_size);
+            }
+        }
+        if (!from_cache) {
+            size_t needed = probe();
+            if (needed == 0) {
+                ESP_LOGE(TAG, "Model does not fit a %zu byte probe arena", config->arena_size);
+                return ESP_ERR_NO_MEM;
+            }
+            arena_size = trimmed_arena_size(needed);
+            if (config->persist_size) {
+                arena_cache_store(model_crc, arena_size);
+            }
+        }
+    }
+    
+    esp_err_t err = build(arena_size, config->placement);
+    if (err != ESP_OK && from_cache) {
+        // Model or TFLM changed since the size was cached: measure again
+        ESP_LOGW(TAG, "Cached arena size %zu too small, re-probing", arena_size);
+        arena_cache_erase(model_crc);
+        size_t needed = probe();
+        if (needed > 0) {
+            arena_size = trimmed_arena_size(needed);
+            arena_cache_store(model_crc, arena_size);
+            err = build(arena_size, config->placement);
+        }
+    }
+    return err;
+}
+
+// Parse the model and build a resolver holding only the ops it uses
+static tflite_wrapper_t* wrapper_alloc(const uint8_t* model_data, size_t model_size)
+{
+    tflite_wrapper_t* wrapper = (tflite_wrapper_t*)calloc(1, sizeof(tflite_wrapper_t));
+    if (!wrapper) {
         return NULL;
     }
+    wrapper->model_data = (uint8_t*)model_data;
+    wrapper->model_size = model_size;
     
-#if TFLITE_HEADERS_AVAILABLE
-    // Parse model
     const tflite::Model* model = tflite::GetModel(model_data);
     if (model->version() != TFLITE_SCHEMA_VERSION) {
         ESP_LOGE(TAG, "Model schema version %d != %d", 
                  model->version(), TFLITE_SCHEMA_VERSION);
-        free(wrapper->tensor_arena);
         free(wrapper);
         return NULL;
     }
+    wrapper->model = model;
     
-    // Create interpreter
-    static tflite::MicroErrorReporter micro_error_reporter;
-    static tflite::AllOpsResolver resolver;
-    
-    tflite::MicroInterpreter* interpreter = new tflite::MicroInterpreter(
-        model, resolver, wrapper->tensor_arena, tensor_arena_size,
-        &micro_error_reporter);
-    
-    if (!interpreter) {
-        ESP_LOGE(TAG, "Failed to create interpreter");
-        free(wrapper->tensor_arena);
+    wrapper->resolver = new wrapper_op_resolver_t();
+    if (!wrapper->resolver || !register_model_ops(model, wrapper->resolver)) {
+        ESP_LOGE(TAG, "Model uses ops not supported by the wrapper resolver");
+        delete wrapper->resolver;
         free(wrapper);
         return NULL;
     }
-    
-    // Allocate tensors
-    if (interpreter->AllocateTensors() != kTfLiteOk) {
-        ESP_LOGE(TAG, "Failed to allocate tensors");
-        delete interpreter;
-        free(wrapper->tensor_arena);
-        free(wrapper);
+    return wrapper;
+}
+
+// Look up input(0)/output(0) once the tensors are allocated
+static bool bind_tensors(tflite_wrapper_t* wrapper)
+{
+    wrapper->input = wrapper->interpreter->input(0);
+    wrapper->output = wrapper->interpreter->output(0);
+    wrapper->input_size = tensor_element_count(wrapper->input);
+    wrapper->output_size = tensor_element_count(wrapper->output);
+    if (wrapper->input_size == 0 || wrapper->output_size == 0) {
+        ESP_LOGE(TAG, "Unsupported tensor types: input %s, output %s",
+                 TfLiteTypeGetName(wrapper->input->type),
+                 TfLiteTypeGetName(wrapper->output->type));
+        return false;
+    }
+    return true;
+}
+#endif
+
+extern "C" {
+
+tflite_wrapper_config_t tflite_wrapper_default_config(size_t arena_size)
+{
+    tflite_wrapper_config_t config = {};
+    config.arena_size = arena_size;
+    config.placement = DEFAULT_ARENA_PLACEMENT;
+    config.auto_size = ARENA_AUTO_SIZE;
+    config.persist_size = ARENA_AUTO_SIZE;
+    return config;
+}
+
+tflite_wrapper_t* tflite_wrapper_create(const uint8_t* model_data, 
+                                         size_t model_size,
+                                         size_t tensor_arena_size)
+{
+    tflite_wrapper_config_t config = tflite_wrapper_default_config(tensor_arena_size);
+    return tflite_wrapper_create_with_config(model_data, model_size, &config);
+}
+
+tflite_wrapper_t* tflite_wrapper_create_with_config(const uint8_t* model_data,
+                                                    size_t model_size,
+                                                    const tflite_wrapper_config_t* config)
+{
+    if (!model_data || model_size == 0 || !config || config->arena_size == 0) {
+        ESP_LOGE(TAG, "Invalid model data");
         return NULL;
     }
     
-    wrapper->interpreter = interpreter;
-    wrapper->model = model;
-    
-    // Get input/output tensors
-    TfLiteTensor* input = interpreter->input(0);
-    TfLiteTensor* output = interpreter->output(0);
+#if TFLITE_HEADERS_AVAILABLE
+    tflite_wrapper_t* wrapper = wrapper_alloc(model_data, model_size);
+    if (!wrapper) {
+        return NULL;
+    }
     
-    wrapper->input_tensor = input->data.f;
-    wrapper->output_tensor = output->data.f;
-    wrapper->input_size = input->bytes / sizeof(float);
-    wrapper->output_size = output->bytes / sizeof(float);
+    uint32_t model_crc = (config->auto_size && config->persist_size)
+                         ? esp_rom_crc32_le(0, model_data, model_size) : 0;
+    esp_err_t err = plan_and_build(
+        config, model_crc,
+        [&](size_t size, tflite_wrapper_arena_placement_t placement) {
+            return build_interpreter(wrapper, size, placement);
+        },
+        [&]() { return wrapper->interpreter->arena_used_bytes(); },
+        [&]() { release_interpreter(wrapper); });
+    if (err != ESP_OK || !bind_tensors(wrapper)) {
+        release_interpreter(wrapper);
+        delete wrapper->resolver;
+        free(wrapper);
+        return NULL;
+    }
     wrapper->initialized = true;
     
     ESP_LOGI(TAG, "TFLite wrapper initialized");
-    ESP_LOGI(TAG, "  Input: %zu floats, Output: %zu floats", 
-             wrapper->input_size, wrapper->output_size);
+    ESP_LOGI(TAG, "  Input: %zu x %s, Output: %zu x %s",
+             wrapper->input_size, TfLiteTypeGetName(wrapper->input->type),
+             wrapper->output_size, TfLiteTypeGetName(wrapper->output->type));
+    ESP_LOGI(TAG, "  Arena: %zu of %zu bytes used",
+             wrapper->interpreter->arena_used_bytes(), wrapper->tensor_arena_size);
+    if (wrapper->input->type != kTfLiteFloat32) {
+        ESP_LOGI(TAG, "  Input quant: scale=%g zero_point=%d",
+                 wrapper->input->params.scale, (int)wrapper->input->params.zero_point);
+    }
 #else
+    tflite_wrapper_t* wrapper = (tflite_wrapper_t*)calloc(1, sizeof(tflite_wrapper_t));
+    if (!wrapper) {
+        return NULL;
+    }
+    wrapper->model_data = (uint8_t*)model_data;
+    wrapper->model_size = model_size;
     ESP_LOGW(TAG, "TFLite headers not available - add esp-tflite-micro component");
     wrapper->initialized = false;
     wrapper->interpreter = NULL;
@@ -133,6 +619,28 @@ tflite_wrapper_t* tflite_wrapper_create(const uint8_t* model_data,
     return wrapper;
 }
 
+esp_err_t tflite_wrapper_get_arena_usage(tflite_wrapper_t* wrapper,
+                                         size_t* used_out,
+                                         size_t* allocated_out)
+{
+    if (!wrapper || !wrapper->initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+#if TFLITE_HEADERS_AVAILABLE
+    if (used_out) {
+        *used_out = wrapper->interpreter->arena_used_bytes();
+    }
+    if (allocated_out) {
+        *allocated_out = wrapper->tensor_arena_size;
+    }
+    return ESP_OK;
+#else
+    (void)used_out;
+    (void)allocated_out;
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
 esp_err_t tflite_wrapper_invoke(tflite_wrapper_t* wrapper, 
                                  const float* input_data, 
                                  size_t input_size,
@@ -148,11 +656,11 @@ esp_err_t tflite_wrapper_invoke(tflite_wrapper_t* wrapper,
         return ESP_ERR_INVALID_STATE;
     }
     
-    // Copy input data
+    // Copy input data, quantizing for int8/uint8 models
     if (input_data && input_size > 0) {
         size_t copy_size = (input_size < wrapper->input_size) ? 
                            input_size : wrapper->input_size;
-        memcpy(wrapper->input_tensor, input_data, copy_size * sizeof(float));
+        quantize_into(wrapper->input, input_data, copy_size);
     }
     
     // Run inference
@@ -166,7 +674,7 @@ esp_err_t tflite_wrapper_invoke(tflite_wrapper_t* wrapper,
     if (output_data && output_size) {
         size_t copy_size = (wrapper->output_size < *output_size) ? 
                            wrapper->output_size : *output_size;
-        memcpy(output_data, wrapper->output_tensor, copy_size * sizeof(float));
+        dequantize_from(wrapper->output, output_data, copy_size);
         *output_size = wrapper->output_size;
     }
     
@@ -180,24 +688,97 @@ esp_err_t tflite_wrapper_invoke(tflite_wrapper_t* wrapper,
 #endif
 }
 
+void* tflite_wrapper_input_ptr(tflite_wrapper_t* wrapper, tflite_wrapper_type_t* type_out)
+{
+    if (!wrapper || !wrapper->initialized) {
+        return NULL;
+    }
+#if TFLITE_HEADERS_AVAILABLE
+    if (type_out) {
+        *type_out = wrapper_type(wrapper->input);
+    }
+    return wrapper->input->data.raw;
+#else
+    (void)type_out;
+    return NULL;
+#endif
+}
+
+const void* tflite_wrapper_output_ptr(tflite_wrapper_t* wrapper, tflite_wrapper_type_t* type_out)
+{
+    if (!wrapper || !wrapper->initialized) {
+        return NULL;
+    }
+#if TFLITE_HEADERS_AVAILABLE
+    if (type_out) {
+        *type_out = wrapper_type(wrapper->output);
+    }
+    return wrapper->output->data.raw;
+#else
+    (void)type_out;
+    return NULL;
+#endif
+}
+
+esp_err_t tflite_wrapper_get_quant_params(tflite_wrapper_t* wrapper, bool output,
+                                          float* scale_out, int32_t* zero_point_out)
+{
+    if (!wrapper || !wrapper->initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+#if TFLITE_HEADERS_AVAILABLE
+    const TfLiteTensor* t = output ? wrapper->output : wrapper->input;
+    bool is_float = (t->type == kTfLiteFloat32);
+    if (scale_out) {
+        *scale_out = is_float ? 1.0f : t->params.scale;
+    }
+    if (zero_point_out) {
+        *zero_point_out = is_float ? 0 : t->params.zero_point;
+    }
+    return ESP_OK;
+#else
+    (void)output;
+    (void)scale_out;
+    (void)zero_point_out;
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
+esp_err_t tflite_wrapper_invoke_in_place(tflite_wrapper_t* wrapper)
+{
+    if (!wrapper || !wrapper->initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+#if TFLITE_HEADERS_AVAILABLE
+    TfLiteStatus status = wrapper->interpreter->Invoke();
+    if (status != kTfLiteOk) {
+        ESP_LOGE(TAG, "TFLite Invoke failed: %d", status);
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+#else
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
 void tflite_wrapper_destroy(tflite_wrapper_t* wrapper)
 {
     if (!wrapper) {
         return;
     }
+    if (wrapper->group) {
+        ESP_LOGW(TAG, "Group members are destroyed with their group");
+        return;
+    }
     
 #if TFLITE_HEADERS_AVAILABLE
-    if (wrapper->interpreter) {
-        delete wrapper->interpreter;
-        wrapper->interpreter = NULL;
+    release_interpreter(wrapper);
+    if (wrapper->resolver) {
+        delete wrapper->resolver;
+        wrapper->resolver = NULL;
     }
 #endif
     
-    if (wrapper->tensor_arena) {
-        free(wrapper->tensor_arena);
-        wrapper->tensor_arena = NULL;
-    }
-    
     free(wrapper);
 }
 
@@ -216,6 +797,106 @@ bool tflite_wrapper_is_initialized(tflite_wrapper_t* wrapper)
     return wrapper && wrapper->initialized;
 }
 
+tflite_wrapper_group_t* tflite_wrapper_group_create(const uint8_t* const* models,
+                                                    const size_t* model_sizes,
+                                                    size_t count,
+                                                    const tflite_wrapper_config_t* config)
+{
+    if (!models || !model_sizes || count == 0 || count > TFLITE_WRAPPER_GROUP_MAX ||
+        !config || config->arena_size == 0) {
+        ESP_LOGE(TAG, "Invalid group");
+        return NULL;
+    }
+    
+#if TFLITE_HEADERS_AVAILABLE
+    tflite_wrapper_group_t* group = (tflite_wrapper_group_t*)calloc(1, sizeof(tflite_wrapper_group_t));
+    if (!group) {
+        return NULL;
+    }
+    
+    bool ok = true;
+    uint32_t models_crc = 0;
+    for (size_t i = 0; i < count && ok; i++) {
+        tflite_wrapper_t* member = (models[i] && model_sizes[i] > 0)
+                                   ? wrapper_alloc(models[i], model_sizes[i]) : NULL;
+        if (!member) {
+            ok = false;
+            break;
+        }
+        member->group = group;
+        group->members[group->count++] = member;
+        if (config->auto_size && config->persist_size) {
+            models_crc = esp_rom_crc32_le(models_crc, models[i], model_sizes[i]);
+        }
+    }
+    
+    if (ok) {
+        ok = plan_and_build(
+            config, models_crc,
+            [&](size_t size, tflite_wrapper_arena_placement_t placement) {
+                return build_group(group, size, placement);
+            },
+            [&]() { return group->used; },
+            [&]() { release_group(group); }) == ESP_OK;
+    }
+    for (size_t i = 0; i < group->count && ok; i++) {
+        tflite_wrapper_t* member = group->members[i];
+        ok = bind_tensors(member);
+        member->tensor_arena_size = group->arena_size;
+        member->initialized = ok;
+    }
+    if (!ok) {
+        tflite_wrapper_group_destroy(group);
+        return NULL;
+    }
+    
+    ESP_LOGI(TAG, "Shared arena for %zu models: %zu of %zu bytes used",
+             group->count, group->used, group->arena_size);
+    return group;
+#else
+    (void)models;
+    (void)model_sizes;
+    ESP_LOGW(TAG, "TFLite headers not available - add esp-tflite-micro component");
+    return NULL;
+#endif
+}
+
+tflite_wrapper_t* tflite_wrapper_group_member(tflite_wrapper_group_t* group, size_t index)
+{
+    return (group && index < group->count) ? group->members[index] : NULL;
+}
+
+esp_err_t tflite_wrapper_group_get_arena_usage(tflite_wrapper_group_t* group,
+                                               size_t* used_out,
+                                               size_t* allocated_out)
+{
+    if (!group) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (used_out) {
+        *used_out = group->used;
+    }
+    if (allocated_out) {
+        *allocated_out = group->arena_size;
+    }
+    return ESP_OK;
+}
+
+void tflite_wrapper_group_destroy(tflite_wrapper_group_t* group)
+{
+    if (!group) {
+        return;
+    }
+#if TFLITE_HEADERS_AVAILABLE
+    release_group(group);
+    for (size_t i = 0; i < group->count; i++) {
+        delete group->members[i]->resolver;
+        free(group->members[i]);
+    }
+#endif
+    free(group);
+}
+
 } // extern "C"
 
 #else // CONFIG_OPENWAKEWORD_USE_TFLITE not defined
@@ -234,6 +915,34 @@ tflite_wrapper_t* tflite_wrapper_create(const uint8_t* model_data,
     return NULL;
 }
 
+tflite_wrapper_config_t tflite_wrapper_default_config(size_t arena_size)
+{
+    tflite_wrapper_config_t config = {};
+    config.arena_size = arena_size;
+    config.placement = TFLITE_WRAPPER_ARENA_AUTO;
+    return config;
+}
+
+tflite_wrapper_t* tflite_wrapper_create_with_config(const uint8_t* model_data,
+                                                    size_t model_size,
+                                                    const tflite_wrapper_config_t* config)
+{
+    (void)model_data;
+    (void)model_size;
+    (void)config;
+    return NULL;
+}
+
+esp_err_t tflite_wrapper_get_arena_usage(tflite_wrapper_t* wrapper,
+                                         size_t* used_out,
+                                         size_t* allocated_out)
+{
+    (void)wrapper;
+    (void)used_out;
+    (void)allocated_out;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
 esp_err_t tflite_wrapper_invoke(tflite_wrapper_t* wrapper, 
                                  const float* input_data, 
                                  size_t input_size,
@@ -248,6 +957,36 @@ esp_err_t tflite_wrapper_invoke(tflite_wrapper_t* wrapper,
     return ESP_ERR_NOT_SUPPORTED;
 }
 
+void* tflite_wrapper_input_ptr(tflite_wrapper_t* wrapper, tflite_wrapper_type_t* type_out)
+{
+    (void)wrapper;
+    (void)type_out;
+    return NULL;
+}
+
+const void* tflite_wrapper_output_ptr(tflite_wrapper_t* wrapper, tflite_wrapper_type_t* type_out)
+{
+    (void)wrapper;
+    (void)type_out;
+    return NULL;
+}
+
+esp_err_t tflite_wrapper_get_quant_params(tflite_wrapper_t* wrapper, bool output,
+                                          float* scale_out, int32_t* zero_point_out)
+{
+    (void)wrapper;
+    (void)output;
+    (void)scale_out;
+    (void)zero_point_out;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t tflite_wrapper_invoke_in_place(tflite_wrapper_t* wrapper)
+{
+    (void)wrapper;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
 void tflite_wrapper_destroy(tflite_wrapper_t* wrapper)
 {
     (void)wrapper;
@@ -272,6 +1011,40 @@ bool tflite_wrapper_is_initialized(tflite_wrapper_t* wrapper)
     return false;
 }
 
+tflite_wrapper_group_t* tflite_wrapper_group_create(const uint8_t* const* models,
+                                                    const size_t* model_sizes,
+                                                    size_t count,
+                                                    const tflite_wrapper_config_t* config)
+{
+    (void)models;
+    (void)model_sizes;
+    (void)count;
+    (void)config;
+    return NULL;
+}
+
+tflite_wrapper_t* tflite_wrapper_group_member(tflite_wrapper_group_t* group, size_t index)
+{
+    (void)group;
+    (void)index;
+    return NULL;
+}
+
+esp_err_t tflite_wrapper_group_get_arena_usage(tflite_wrapper_group_t* group,
+                                               size_t* used_out,
+                                               size_t* allocated_out)
+{
+    (void)group;
+    (void)used_out;
+    (void)allocated_out;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+void tflite_wrapper_group_destroy(tflite_wrapper_group_t* group)
+{
+    (void)group;
+}
+
 } // extern "C"
 
 #endif // CONFIG_OPENWAKEWORD_USE_TFLITE
\ No newline at end of file
@@ -0,0 +1,426 @@
+/**
+ * @file turn_predictor.c
+ * @brief End-of-turn score from prosody, the mel stream and partial transcripts
+ *
+ * F0 comes from a normalised autocorrelation of each 32 ms block of speech,
+ * decimated by two first (the voice F0 range needs no more); its slope is a
+ * least-squares fit over the last few voiced blocks. The mel rows are the
+ * wake word frontend's, run on the utterance's own audio so the model sees
+ * the same features the wake word models were trained on.
+ */
+
+#include "turn_predictor.h"
+#include <ctype.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_log.h"
+#include "tflite_wrapper.h"
+
+static const char *TAG = "turn_predictor";
+
+#define TP_DEFAULT_ARENA (48 * 1024)
+// Analysis block for F0 and level; the longest period searched fits twice
+// into it after decimation
+#define TP_BLOCK 512
+#define TP_DECIMATE 2
+#define TP_F0_MIN_HZ 70
+#define TP_F0_MAX_HZ 400
+// Peak normalised autocorrelation for a block to count as voiced
+#define TP_VOICING 0.5f
+// Voiced blocks in the slope fit (~400 ms of voicing)
+#define TP_TRACK 12
+// The shortest lag within this share of the best wins, so a period's multiples never do
+#define TP_OCTAVE_SHARE 0.85f
+// Successive voiced blocks this close in F0 extend a level run
+#define TP_LEVEL_ST 0.6f
+// Mel rows between model runs (80 ms)
+#define TP_MODEL_STEP_ROWS 8
+
+// Words after which an English sentence cannot end
+static const char *const s_continuations[] = {
+    "and", "but", "or", "so", "because", "if", "then", "than", "that", "which", "to", "of", "for", "with",
+    "the", "a", "an", "my", "your", "in", "on", "at", "from", "is", "are", "was", "um", "uh", "uhm", "er",
+    "like", "set", "turn", "play", "what's", "whats",
+};
+
+struct turn_predictor {
+    turn_predictor_config_t config;
+    tflite_wrapper_t *model;
+    audio_features_t *mel;
+    float *input;                 // TURN_PREDICTOR_INPUT_SIZE
+    int lag_min;                  // In decimated samples
+    int lag_max;
+
+    // Audio task only
+    int16_t block[TP_BLOCK];
+    size_t fill;
+    uint32_t blocks;              // Analysed since begin()
+    uint32_t speech_blocks;
+    uint32_t voiced_blocks;
+    uint32_t utterance_ms;
+    uint32_t silence_ms;
+    float peak_db;
+    float last_voiced_db;
+    float f0_sum;                 // Semitones re 100 Hz over voiced blocks
+    float track_st[TP_TRACK];
+    uint32_t track_block[TP_TRACK];
+    size_t track_len;
+    float level_start_st;
+    uint32_t level_blocks;
+    uint32_t rows_since_model;
+    float model_score;            // < 0 until the model has run this utterance
+    float score;
+
+    int8_t text_hint;             // Any task
+};
+
+static float clampf(float v, float lo, float hi)
+{
+    return v < lo ? lo : v > hi ? hi : v;
+}
+
+// F0 in semitones re 100 Hz, or NAN when the block is unvoiced
+static float tp_pitch(const turn_predictor_t *tp, const float *x, size_t n)
+{
+    float r[TP_BLOCK / TP_DECIMATE / 2 + 2] = {0};
+    float best = 0.0f;
+    for (int lag = tp->lag_min - 1; lag <= tp->lag_max + 1; lag++) {
+        float c = 0.0f, e0 = 0.0f, e1 = 0.0f;
+        for (size_t i = 0; i + lag < n; i++) {
+            c += x[i] * x[i + lag];
+            e0 += x[i] * x[i];
+            e1 += x[i + lag] * x[i + lag];
+        }
+        float norm = sqrtf(e0 * e1);
+        r[lag - tp->lag_min + 1] = norm > 0.0f ? c / norm : 0.0f;
+        if (lag >= tp->lag_min && lag <= tp->lag_max && r[lag - tp->lag_min + 1] > best) {
+            best = r[lag - tp->lag_min + 1];
+        }
+    }
+    if (best < TP_VOICING) {
+        return NAN;
+    }
+    // First local peak close to the best, refined between lags by a parabola
+    float *at = r + 1 - tp->lag_min;
+    int lag = tp->lag_min;
+    while (lag < tp->lag_max && !(at[lag] >= TP_OCTAVE_SHARE * best && at[lag] >= at[lag - 1] && at[lag] >= at[lag + 1])) {
+        lag++;
+    }
+    float period = (float)lag;
+    float curve = at[lag - 1] - 2.0f * at[lag] + at[lag + 1];
+    if (curve < 0.0f) {
+        period += clampf(0.5f * (at[lag - 1] - at[lag + 1]) / curve, -0.5f, 0.5f);
+    }
+    float f0 = (float)tp->config.sample_rate / TP_DECIMATE / period;
+    return 12.0f * log2f(f0 / 100.0f);
+}
+
+static void tp_analyse_block(turn_predictor_t *tp, bool speech)
+{
+    float x[TP_BLOCK / TP_DECIMATE];
+    float mean = 0.0f;
+    for (size_t i = 0; i < TP_BLOCK; i++) {
+        mean += tp->block[i];
+    }
+    mean /= TP_BLOCK;
+    float energy = 0.0f;
+    for (size_t i = 0; i < TP_BLOCK; i++) {
+        float v = ((float)tp->block[i] - mean) / 32768.0f;
+        energy += v * v;
+    }
+    // Pairs averaged: a crude low-pass, enough ahead of the autocorrelation
+    for (size_t i = 0; i < TP_BLOCK / TP_DECIMATE; i++) {
+        x[i] = ((float)tp->block[2 * i] + (float)tp->block[2 * i + 1] - 2.0f * mean) / 65536.0f;
+    }
+    float db = 10.0f * log10f(energy / TP_BLOCK + 1e-10f);
+    tp->blocks++;
+    // Pauses and consonants leave the level run alone: it describes the last voicing
+    if (!speech) {
+        return;
+    }
+    tp->speech_blocks++;
+    if (db > tp->peak_db) {
+        tp->peak_db = db;
+    }
+    float st = tp_pitch(tp, x, TP_BLOCK / TP_DECIMATE);
+    if (isnan(st)) {
+        return;
+    }
+    tp->voiced_blocks++;
+    tp->last_voiced_db = db;
+    tp->f0_sum += st;
+    if (tp->level_blocks && fabsf(st - tp->level_start_st) < TP_LEVEL_ST) {
+        tp->level_blocks++;
+    } else {
+        tp->level_start_st = st;
+        tp->level_blocks = 1;
+    }
+    if (tp->track_len == TP_TRACK) {
+        memmove(tp->track_st, tp->track_st + 1, (TP_TRACK - 1) * sizeof(float));
+        memmove(tp->track_block, tp->track_block + 1, (TP_TRACK - 1) * sizeof(uint32_t));
+        tp->track_len--;
+    }
+    tp->track_st[tp->track_len] = st;
+    tp->track_block[tp->track_len] = tp->blocks;
+    tp->track_len++;
+}
+
+// Least-squares F0 slope over the tracked voiced blocks, semitones per second
+static float tp_f0_slope(const turn_predictor_t *tp)
+{
+    if (tp->track_len < 3) {
+        return 0.0f;
+    }
+    float block_s = (float)TP_BLOCK / (float)tp->config.sample_rate;
+    float mt = 0.0f, ms = 0.0f;
+    for (size_t i = 0; i < tp->track_len; i++) {
+        mt += (float)tp->track_block[i] * block_s;
+        ms += tp->track_st[i];
+    }
+    mt /= tp->track_len;
+    ms /= tp->track_len;
+    float num = 0.0f, den = 0.0f;
+    for (size_t i = 0; i < tp->track_len; i++) {
+        float dt = (float)tp->track_block[i] * block_s - mt;
+        num += dt * (tp->track_st[i] - ms);
+        den += dt * dt;
+    }
+    return den > 0.0f ? num / den : 0.0f;
+}
+
+static void tp_prosody(const turn_predictor_t *tp, uint32_t silence_ms, float *out)
+{
+    float block_s = (float)TP_BLOCK / (float)tp->config.sample_rate;
+    float mean_st = tp->voiced_blocks ? tp->f0_sum / (float)tp->voiced_blocks : 0.0f;
+    float last_st = tp->track_len ? tp->track_st[tp->track_len - 1] : mean_st;
+    out[TURN_PREDICTOR_F0_SLOPE] = clampf(tp_f0_slope(tp) / 20.0f, -1.0f, 1.0f);
+    out[TURN_PREDICTOR_F0_FINAL] = (last_st - mean_st) / 12.0f;
+    out[TURN_PREDICTOR_ENERGY_DECAY] = tp->voiced_blocks ? clampf((tp->last_voiced_db - tp->peak_db) / 30.0f, -1.0f, 0.0f)
+                                                         : 0.0f;
+    out[TURN_PREDICTOR_VOICED_SHARE] = tp->speech_blocks ? (float)tp->voiced_blocks / (float)tp->speech_blocks : 0.0f;
+    out[TURN_PREDICTOR_UTTERANCE_S] = (float)tp->utterance_ms / 10000.0f;
+    out[TURN_PREDICTOR_SILENCE_S] = (float)silence_ms / 1000.0f;
+    out[TURN_PREDICTOR_LEVEL_RUN_S] = (float)tp->level_blocks * block_s;
+    out[TURN_PREDICTOR_TEXT_HINT] = (float)__atomic_load_n(&tp->text_hint, __ATOMIC_RELAXED);
+}
+
+// Without a model: a bare pause tops out under the default threshold, so it
+// still waits for the hangover; a falling F0, a decayed level or a complete
+// transcript push it over, a held level F0 or a transcript that cannot end
+// there pull it back
+static float tp_heuristic(const float *p)
+{
+    float score = 0.5f;
+    if (p[TURN_PREDICTOR_F0_SLOPE] < 0.0f) {
+        score += fminf(-p[TURN_PREDICTOR_F0_SLOPE] * 0.4f, 0.2f);
+    }
+    if (p[TURN_PREDICTOR_ENERGY_DECAY] < -0.4f) {
+        score += 0.1f;
+    }
+    if (p[TURN_PREDICTOR_LEVEL_RUN_S] >= 0.3f) {
+        score -= 0.25f;
+    }
+    score += p[TURN_PREDICTOR_TEXT_HINT] * 0.3f;
+    score += fminf(p[TURN_PREDICTOR_SILENCE_S], 0.4f) * 0.4f;
+    return clampf(score, 0.0f, 1.0f);
+}
+
+static void tp_run_model(turn_predictor_t *tp)
+{
+    float *mel = tp->input;
+    size_t have = audio_features_stream_available(tp->mel);
+    size_t rows = have < TURN_PREDICTOR_MEL_FRAMES ? have : TURN_PREDICTOR_MEL_FRAMES;
+    // A short utterance is padded with zero rows in front
+    size_t pad = TURN_PREDICTOR_MEL_FRAMES - rows;
+    memset(mel, 0, pad * AUDIO_FEATURES_N_MELS * sizeof(float));
+    if (rows && audio_features_stream_get_window(tp->mel, mel + pad * AUDIO_FEATURES_N_MELS, rows) != ESP_OK) {
+        return;
+    }
+    tp_prosody(tp, tp->silence_ms, tp->input + TURN_PREDICTOR_MEL_FRAMES * AUDIO_FEATURES_N_MELS);
+    float out = 0.0f;
+    size_t out_size = 1;
+    if (tflite_wrapper_invoke(tp->model, tp->input, TURN_PREDICTOR_INPUT_SIZE, &out, &out_size) == ESP_OK &&
+        out_size >= 1) {
+        tp->model_score = clampf(out, 0.0f, 1.0f);
+    }
+}
+
+turn_predictor_t *turn_predictor_create(const turn_predictor_config_t *config)
+{
+    turn_predictor_t *tp = calloc(1, sizeof(*tp));
+    if (!tp) {
+        return NULL;
+    }
+    if (config) {
+        tp->config = *config;
+    }
+    if (tp->config.sample_rate == 0) {
+        tp->config.sample_rate = 16000;
+    }
+    if (tp->config.arena_size == 0) {
+        tp->config.arena_size = TP_DEFAULT_ARENA;
+    }
+    if (tp->config.threshold <= 0.0f) {
+        tp->config.threshold = 0.7f;
+    }
+    if (tp->config.min_silence_ms == 0) {
+        tp->config.min_silence_ms = 200;
+    }
+    if (tp->config.min_utterance_ms == 0) {
+        tp->config.min_utterance_ms = 500;
+    }
+    tp->lag_min = (int)(tp->config.sample_rate / TP_DECIMATE / TP_F0_MAX_HZ);
+    tp->lag_max = (int)(tp->config.sample_rate / TP_DECIMATE / TP_F0_MIN_HZ);
+    if (tp->lag_max > TP_BLOCK / TP_DECIMATE / 2) {
+        tp->lag_max = TP_BLOCK / TP_DECIMATE / 2;
+    }
+
+    if (tp->config.model_data && tp->config.model_size) {
+        tp->model = tflite_wrapper_create(tp->config.model_data, tp->config.model_size, tp->config.arena_size);
+        if (tp->model && tflite_wrapper_get_input_size(tp->model) != TURN_PREDICTOR_INPUT_SIZE) {
+            ESP_LOGW(TAG, "Model takes %u inputs, not %u; using prosody weights",
+                     (unsigned)tflite_wrapper_get_input_size(tp->model), (unsigned)TURN_PREDICTOR_INPUT_SIZE);
+            tflite_wrapper_destroy(tp->model);
+            tp->model = NULL;
+        }
+        if (tp->model) {
+            tp->mel = audio_features_init(tp->config.sample_rate);
+            tp->input = malloc(TURN_PREDICTOR_INPUT_SIZE * sizeof(float));
+            if (!tp->mel || !tp->input) {
+                turn_predictor_destroy(tp);
+                return NULL;
+            }
+        } else {
+            ESP_LOGW(TAG, "End-of-turn model did not load; using prosody weights");
+        }
+    }
+    turn_predictor_begin(tp);
+    ESP_LOGI(TAG, "End-of-turn predictor: %s, threshold %.2f, min silence %u ms",
+             tp->model ? "model" : "prosody weights", tp->config.threshold, (unsigned)tp->config.min_silence_ms);
+    return tp;
+}
+
+void turn_predictor_destroy(turn_predictor_t *predictor)
+{
+    if (!predictor) {
+        return;
+    }
+    if (predictor->model) {
+        tflite_wrapper_destroy(predictor->model);
+    }
+    if (predictor->mel) {
+        audio_features_deinit(predictor->mel);
+    }
+    free(predictor->input);
+    free(predictor);
+}
+
+void turn_predictor_begin(turn_predictor_t *predictor)
+{
+    turn_predictor_t *tp = predictor;
+    if (tp->mel) {
+        audio_features_stream_reset(tp->mel);
+    }
+    tp->fill = 0;
+    tp->blocks = 0;
+    tp->speech_blocks = 0;
+    tp->voiced_blocks = 0;
+    tp->utterance_ms = 0;
+    tp->silence_ms = 0;
+    tp->peak_db = -100.0f;
+    tp->last_voiced_db = -100.0f;
+    tp->f0_sum = 0.0f;
+    tp->track_len = 0;
+    tp->level_blocks = 0;
+    tp->rows_since_model = 0;
+    tp->model_score = -1.0f;
+    tp->score = 0.0f;
+    __atomic_store_n(&tp->text_hint, 0, __ATOMIC_RELAXED);
+}
+
+void turn_predictor_push(turn_predictor_t *predictor, const int16_t *samples, size_t count, bool speech)
+{
+    turn_predictor_t *tp = predictor;
+    uint32_t ms = (uint32_t)(count * 1000 / tp->config.sample_rate);
+    tp->utterance_ms += ms;
+    tp->silence_ms = speech ? 0 : tp->silence_ms + ms;
+    for (size_t done = 0; done < count;) {
+        size_t take = count - done;
+        if (take > TP_BLOCK - tp->fill) {
+            take = TP_BLOCK - tp->fill;
+        }
+        memcpy(tp->block + tp->fill, samples + done, take * sizeof(int16_t));
+        tp->fill += take;
+        done += take;
+        if (tp->fill == TP_BLOCK) {
+            tp_analyse_block(tp, speech);
+            tp->fill = 0;
+        }
+    }
+    if (!tp->model) {
+        return;
+    }
+    size_t rows = 0;
+    if (audio_features_stream_push(tp->mel, samples, count, &rows) != ESP_OK) {
+        return;
+    }
+    tp->rows_since_model += rows;
+    if (tp->rows_since_model >= TP_MODEL_STEP_ROWS) {
+        tp->rows_since_model = 0;
+        tp_run_model(tp);
+    }
+}
+
+void turn_predictor_set_partial(turn_predictor_t *predictor, const char *text)
+{
+    size_t len = strlen(text);
+    while (len && isspace((unsigned char)text[len - 1])) {
+        len--;
+    }
+    int8_t hint = 0;
+    if (len && strchr(".?!", text[len - 1])) {
+        hint = 1;
+    } else if (len) {
+        size_t start = len;
+        while (start && !isspace((unsigned char)text[start - 1])) {
+            start--;
+        }
+        char word[12];
+        size_t n = len - start;
+        if (n < sizeof(word)) {
+            for (size_t i = 0; i < n; i++) {
+                word[i] = (char)tolower((unsigned char)text[start + i]);
+            }
+            word[n] = '\0';
+            for (size_t i = 0; i < sizeof(s_continuations) / sizeof(s_continuations[0]); i++) {
+                if (strcmp(word, s_continuations[i]) == 0) {
+                    hint = -1;
+                    break;
+                }
+            }
+        }
+    }
+    __atomic_store_n(&predictor->text_hint, hint, __ATOMIC_RELAXED);
+}
+
+bool turn_predictor_should_end(turn_predictor_t *predictor, uint32_t silence_ms)
+{
+    turn_predictor_t *tp = predictor;
+    if (silence_ms < tp->config.min_silence_ms || tp->utterance_ms < tp->config.min_utterance_ms) {
+        return false;
+    }
+    if (tp->model && tp->model_score >= 0.0f) {
+        tp->score = tp->model_score;
+    } else {
+        float prosody[TURN_PREDICTOR_PROSODY_FEATURES];
+        tp_prosody(tp, silence_ms, prosody);
+        tp->score = tp_heuristic(prosody);
+    }
+    return tp->score >= tp->config.threshold;
+}
+
+float turn_predictor_score(const turn_predictor_t *predictor)
+{
+    return predictor->score;
+}
@@ -0,0 +1,82 @@
+/**
+ * @file night_summary.h
+ * @brief On-device aggregation of a night of sensor readings and sound events.
+ *
+ * While a night is open every sampling period feeds the raw channel values
+ * into per-epoch sketches: count, min, max, mean, and P² estimates of the
+ * median and 90th percentile. Each closed epoch is appended as one record to
+ * the "night" flash partition, together with the sound events counted in
+ * it, so a reboot loses at most the epoch in progress. When the night ends
+ * one summary and the epoch series are published to the telemetry topic
+ * with a "/night" suffix, and kept in flash until every piece is out.
+ *
+ * Summary (CBOR map):
+ *   "v", "id", "start", "end" (ms; "wall" true when Unix epoch, else
+ *   uptime), "epoch_s", "epochs", "channels": {"<group>.<key>": {"n",
+ *   "min", "mean", "max", "p50", "p90"}}, "events": {"<label>": count}
+ * Night percentiles are the count-weighted percentiles of the epoch ones.
+ *
+ * Series (one CBOR map per channel and NIGHT_SUMMARY_SERIES_CHUNK epochs):
+ *   "v", "id", "ch", "first" (epoch index), "mean", "min", "max" (arrays,
+ *   null for an epoch without readings)
+ *
+ * The channel set is the telemetry batch one. Only the sensor manager task
+ * calls in, except for night_summary_set_open() and
+ * night_summary_count_event().
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "esp_err.h"
+#include "telemetry_batch.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define NIGHT_SUMMARY_PARTITION_LABEL "night"
+#define NIGHT_SUMMARY_VERSION 1
+#define NIGHT_SUMMARY_MAX_EVENT_KINDS 8
+#define NIGHT_SUMMARY_SERIES_CHUNK 48
+
+/**
+ * @brief Bind to the channel set and recover the partition.
+ *
+ * A night left open by the previous boot is closed at its last epoch and
+ * queued for publishing, as is one that ended but was not fully sent.
+ *
+ * @return ESP_ERR_NOT_FOUND without a "night" partition
+ */
+esp_err_t night_summary_init(const telemetry_batch_channel_t *channels, size_t count);
+
+/**
+ * @brief Ask for a night to start or end; applied at the next sample.
+ *
+ * Starting a night discards a previous one that was never published.
+ * Callable from any task.
+ */
+void night_summary_set_open(bool open);
+
+/**
+ * @brief Count a sound event in the open night; ignored otherwise.
+ *
+ * Up to NIGHT_SUMMARY_MAX_EVENT_KINDS distinct labels per night; label must
+ * be a static string. Callable from any task, never blocks.
+ */
+void night_summary_count_event(const char *label);
+
+/**
+ * @brief One sampling period: raw values in channel order, NAN where missing.
+ *
+ * Also moves a finished summary out, a few publishes per call.
+ */
+void night_summary_record(const float *values);
+
+bool night_summary_is_open(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,119 @@
+/**
+ * @file sensor_history.h
+ * @brief Local sensor history in a flash partition, at three resolutions.
+ *
+ * The "history" partition is split into three rings of 4 KB sectors, one per
+ * tier: every reported reading (raw), one-minute means and fifteen-minute
+ * means. Raw rows are written only when a channel's value changes at its
+ * batch precision, or at least every five minutes. The rings are sized 5:2:1,
+ * which at the default 512 KB keeps roughly a day raw, days of minutes and
+ * weeks of quarter hours. Each ring overwrites its oldest sector, so every
+ * sector is erased once per pass around its ring and wear is bounded.
+ *
+ * Readings go into per-channel blocks held in RAM and appended to the ring
+ * when full or old enough (raw 5 min, 1 min tier 30 min, 15 min tier 2 h;
+ * a reset loses at most that much of each tier). Block layout, little-endian:
+ *   u8 0x5B, u8 channel, u16 payload length, u32 first time, u32 last time,
+ *   then zigzag varint value, and per further row varint dt (s) and zigzag
+ *   varint value delta
+ * Times are Unix seconds; nothing is stored until SNTP has set the clock.
+ * Values are integers, round(value * 10^decimals), as in telemetry batches.
+ * A RAM index of each sector's time span lets range queries skip the rest.
+ *
+ * Only the sensor manager task records; queries may come from any task.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "telemetry_batch.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SENSOR_HISTORY_PARTITION_LABEL "history"
+#define SENSOR_HISTORY_EXPORT_VERSION 1
+
+typedef enum {
+    SENSOR_HISTORY_TIER_RAW = 0,
+    SENSOR_HISTORY_TIER_1MIN,
+    SENSOR_HISTORY_TIER_15MIN,
+    SENSOR_HISTORY_TIER_COUNT,
+    SENSOR_HISTORY_TIER_AUTO = 0xFF,  /**< Finest tier that still reaches back to from */
+} sensor_history_tier_t;
+
+/**
+ * @brief One stored point; return false to stop the query.
+ *
+ * Points of one channel arrive in time order; channels are interleaved.
+ */
+typedef bool (*sensor_history_point_cb_t)(size_t channel, uint32_t t_s, float value, void *ctx);
+
+/**
+ * @brief Bind to the channel set and index the partition.
+ *
+ * Sectors written with another channel set are ignored until overwritten.
+ *
+ * @return ESP_ERR_NOT_FOUND without a "history" partition
+ */
+esp_err_t sensor_history_init(const telemetry_batch_channel_t *channels, size_t count);
+
+/**
+ * @brief One sampling period, from the sensor manager task.
+ *
+ * @param raw      Every reading, NAN where missing; feeds the means
+ * @param reported The same after the deadband; feeds the raw tier
+ */
+void sensor_history_record(const float *raw, const float *reported);
+
+size_t sensor_history_channel_count(void);
+
+/**
+ * @brief "<group>.<key>" of a channel into buf.
+ */
+void sensor_history_channel_name(size_t channel, char *buf, size_t len);
+
+/**
+ * @return Index of the channel named "<group>.<key>", or -1
+ */
+int sensor_history_find_channel(const char *name);
+
+const char *sensor_history_tier_name(sensor_history_tier_t tier);
+
+/**
+ * @brief Tier SENSOR_HISTORY_TIER_AUTO resolves to for a range.
+ *
+ * Raw for spans up to a day, the minute tier up to a week, else quarter
+ * hours; a tier that no longer reaches back to from gives way to a coarser
+ * one.
+ */
+sensor_history_tier_t sensor_history_pick_tier(uint32_t from_s, uint32_t to_s);
+
+/**
+ * @brief Points with from_s <= t <= to_s, including those not yet in flash.
+ *
+ * @param channel Channel index, or -1 for all
+ */
+esp_err_t sensor_history_query(int channel, uint32_t from_s, uint32_t to_s, sensor_history_tier_t tier,
+                               sensor_history_point_cb_t cb, void *ctx);
+
+/**
+ * @brief The blocks overlapping a range, as stored, for bulk transfer.
+ *
+ * Layout: u8 version, u8 tier, u8 flags (bit 0: cut at max_len), u8 channel
+ * count, then per channel u8 decimals, u8 name length, name; then blocks as
+ * described above. Blocks may extend past the range on either side.
+ *
+ * @param out Heap buffer for the caller to free
+ */
+esp_err_t sensor_history_export(uint32_t from_s, uint32_t to_s, sensor_history_tier_t tier, size_t max_len,
+                                uint8_t **out, size_t *out_len);
+
+#ifdef __cplusplus
+}
+#endif
@@ -15,20 +15,56 @@ typedef struct {
     float temperature_c;        ///< Temperature from SHT45 (°C)
     float humidity_rh;          ///< Humidity from SHT45 (%)
     uint16_t voc_index;         ///< VOC index from SGP40
+    uint16_t voc_ticks;         ///< Raw SGP40 signal
     float co2_ppm;              ///< CO2 from SCD40 (ppm)
     float temperature_co2_c;    ///< Temperature from SCD40 (°C)
     float humidity_co2_rh;       ///< Humidity from SCD40 (%)
     uint16_t ambient_lux;       ///< Ambient light from VCNL4040 (lux)
     uint16_t proximity;         ///< Proximity from VCNL4040
     float ec_ms_per_cm;         ///< PM2.5 from EC10 (μg/m³) - stored in ec_ms_per_cm field
+    float pm1_0_ug_m3;          ///< PM1.0 from EC10 (μg/m³)
+    float pm10_ug_m3;           ///< PM10 from EC10 (μg/m³)
+    float sps30_pm1_0_ug_m3;    ///< PM1.0 from SPS30 (μg/m³)
+    float sps30_pm2_5_ug_m3;    ///< PM2.5 from SPS30 (μg/m³)
+    float sps30_pm4_0_ug_m3;    ///< PM4.0 from SPS30 (μg/m³)
+    float sps30_pm10_ug_m3;     ///< PM10 from SPS30 (μg/m³)
+    float sps30_particle_size_um; ///< Typical particle size from SPS30 (μm)
+    float pressure_hpa;         ///< Mean pressure from BMP581 since the last update (hPa)
+    float pressure_span_pa;     ///< Max minus min BMP581 pressure since the last update (Pa)
+    float temperature_baro_c;   ///< Temperature from BMP581 (°C)
+    uint16_t opt3002_lux;       ///< Ambient light from OPT3002, estimated from irradiance (lux)
+    float irradiance_nw_cm2;    ///< Optical power density from OPT3002 (nW/cm²)
     bool sht45_available;       ///< SHT45 sensor available
     bool sgp40_available;       ///< SGP40 sensor available
     bool scd40_available;       ///< SCD40 sensor available
     bool vcnl4040_available;    ///< VCNL4040 sensor available
     bool ec10_available;        ///< EC10 sensor available
+    bool sps30_available;       ///< SPS30 sensor available
+    bool bmp581_available;      ///< BMP581 sensor available
+    bool opt3002_available;     ///< OPT3002 sensor available
     uint32_t last_update_ms;    ///< Last update timestamp (ms)
 } sensor_integration_data_t;
 
+typedef enum {
+    SENSOR_INTEGRATION_EVENT_PROXIMITY,      ///< Something came close or went away
+    SENSOR_INTEGRATION_EVENT_AMBIENT_LIGHT,  ///< Light moved out of the window around the last level
+} sensor_integration_event_type_t;
+
+/**
+ * @brief Proximity or light change, reported as it happens rather than at the next poll
+ */
+typedef struct {
+    sensor_integration_event_type_t type;
+    bool near;                  ///< Something is close to the sensor
+    uint16_t ambient_lux;       ///< From the OPT3002 when fitted, else the VCNL4040
+    uint16_t proximity;
+} sensor_integration_event_t;
+
+/**
+ * @brief Event handler; runs on the sampling task, so keep it short
+ */
+typedef void (*sensor_integration_event_cb_t)(const sensor_integration_event_t *event, void *user_ctx);
+
 /**
  * @brief Initialize sensor integration system
  * @return ESP_OK on success
@@ -49,10 +85,26 @@ esp_err_t sensor_integration_stop(void);
 
 /**
  * @brief Get current sensor data
+ *
+ * Returns a consistent snapshot of the readings the sampling task last
+ * published. Lock-free and never touches I2C, so it is safe from any task.
+ *
  * @return Sensor data structure
  */
 sensor_integration_data_t sensor_integration_get_data(void);
 
+/**
+ * @brief Receive proximity and ambient light events
+ *
+ * With CONFIG_SENSOR_INTEGRATION_VCNL4040_INT_GPIO set they arrive within
+ * milliseconds of the change; otherwise at the next 1 Hz poll. The
+ * "vcnl4040" sensor is also pushed to the sensor_manager observer. Set it
+ * before sensor_integration_start().
+ *
+ * @param cb NULL to stop receiving events
+ */
+esp_err_t sensor_integration_set_event_cb(sensor_integration_event_cb_t cb, void *user_ctx);
+
 #ifdef __cplusplus
 }
 #endif
@@ -5,16 +5,56 @@
 
 #include "cJSON.h"
 #include "esp_err.h"
+#include "telemetry_cbor.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/** Schema version carried as "v" in binary telemetry; bump on incompatible changes */
+#define SENSOR_MANAGER_TELEMETRY_SCHEMA 1
+
 typedef bool (*sensor_manager_sample_cb_t)(cJSON *sensor_root);
 
+/**
+ * Binary counterpart of sample_cb: write the sensor's fields into the open
+ * CBOR map with the telemetry_cbor_put_*() helpers, using the same keys.
+ */
+typedef bool (*sensor_manager_encode_cb_t)(telemetry_cbor_t *sensor_map);
+
+/**
+ * One numeric reading of a sensor, as stored in telemetry batches.
+ *
+ * A reading is reported when it moves more than @c deadband from the last
+ * reported value, or when @c max_interval_ms has passed since then; in
+ * between the last reported value stands.
+ */
+typedef struct {
+    const char *key;                  /**< Same key as in the JSON payload */
+    uint8_t decimals;                 /**< Fixed-point digits kept in batches */
+    float deadband;                   /**< 0 reports every change */
+    uint32_t max_interval_ms;         /**< Heartbeat; 0 uses SENSOR_MANAGER_HEARTBEAT_MS */
+} sensor_manager_channel_t;
+
+/**
+ * Fill one value per channel, in channel order; leave NAN where there is no
+ * reading. Return false when the sensor has nothing at all.
+ */
+typedef bool (*sensor_manager_read_cb_t)(float *values);
+
 typedef struct {
     const char *name;
     sensor_manager_sample_cb_t sample_cb;
+    sensor_manager_encode_cb_t encode_cb;  /**< Optional; sample_cb output is converted when NULL */
+    /**
+     * Optional numeric channels. With batching enabled these sensors are
+     * recorded into telemetry batches instead of being published live;
+     * without it they are published live only when a channel is due.
+     * sample_cb still feeds the observer every period.
+     */
+    const sensor_manager_channel_t *channels;
+    uint8_t channel_count;
+    sensor_manager_read_cb_t read_cb;
 } sensor_manager_sensor_t;
 
 typedef void (*sensor_manager_observer_cb_t)(const char *sensor_name,
@@ -28,6 +68,22 @@ typedef struct {
 esp_err_t sensor_manager_init(const sensor_manager_config_t *config);
 esp_err_t sensor_manager_register(const sensor_manager_sensor_t *sensor);
 esp_err_t sensor_manager_set_observer(sensor_manager_observer_cb_t observer, void *user_ctx);
+/**
+ * Hand a sensor's new reading to the observer now instead of at the next
+ * period, for sensors that learn of changes from an interrupt. Telemetry
+ * keeps its own pace. Call from a task, not an ISR.
+ *
+ * @return ESP_ERR_NOT_FOUND for a name that was never registered
+ */
+esp_err_t sensor_manager_notify(const char *sensor_name);
+/**
+ * Change the sampling period at run time, e.g. slower while nobody is
+ * around; every observer update, telemetry sample and batch row follows it.
+ * Callable from any task; the pending period is moved at once.
+ *
+ * @param interval_ms 0 restores the interval given to sensor_manager_init()
+ */
+esp_err_t sensor_manager_set_publish_interval(uint32_t interval_ms);
 esp_err_t sensor_manager_start(void);
 esp_err_t sensor_manager_stop(void);
 bool sensor_manager_is_running(void);
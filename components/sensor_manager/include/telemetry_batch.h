@@ -0,0 +1,96 @@
+/**
+ * @file telemetry_batch.h
+ * @brief Delta-encoded telemetry batches kept in an RTC RAM store.
+ *
+ * Samples of a fixed channel set are appended to an open batch as they are
+ * taken. A batch is sealed when it reaches its sample or size limit or its
+ * age limit, and sealed batches wait in the store, oldest first, until they
+ * are published. The store sits in RTC memory that is not cleared on a
+ * software reset, so batches not yet sent survive a crash or reboot and are
+ * replayed once the connection is back. When the store is full the oldest
+ * sealed batch is dropped.
+ *
+ * Batch layout (little-endian):
+ *   u8 version, u8 flags (bit 0: base time is Unix epoch ms, else uptime ms),
+ *   u8 channel count, then per channel: u8 decimals, u8 name length, name;
+ *   u64 base time ms, u16 sample count, then one row per sample:
+ *     varint (dt_ms << 1 | present mask changed)
+ *     [varint present mask]
+ *     varint changed mask (bit set: value differs from the previous row)
+ *     zigzag varint delta per changed channel, in channel order
+ * Values are integers: round(value * 10^decimals). The first row of each
+ * batch is relative to zero, so every batch decodes on its own. A flat
+ * reading costs one byte per row on top of the time delta.
+ *
+ * Not thread-safe; the sensor manager task is the only caller.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TELEMETRY_BATCH_VERSION 1
+#define TELEMETRY_BATCH_MAX_CHANNELS 16
+
+typedef struct {
+    const char *group;                /**< Sensor name; the channel is named "<group>.<key>" */
+    const char *key;
+    uint8_t decimals;                 /**< Decimal digits kept */
+} telemetry_batch_channel_t;
+
+typedef struct {
+    uint16_t max_samples;             /**< Seal after this many samples */
+    uint32_t max_age_ms;              /**< Seal once the first sample is this old */
+    uint16_t max_bytes;               /**< Seal before a batch grows past this */
+} telemetry_batch_config_t;
+
+/**
+ * @brief Bind the store to a channel set.
+ *
+ * Batches left in RTC memory by the previous boot are kept when the channel
+ * set is unchanged, and discarded otherwise. An open batch from the previous
+ * boot is sealed as is.
+ */
+esp_err_t telemetry_batch_init(const telemetry_batch_channel_t *channels, size_t count,
+                               const telemetry_batch_config_t *config);
+
+/**
+ * @brief Append one sample; NAN marks a channel without a reading.
+ *
+ * @param values One value per channel, in init order
+ */
+void telemetry_batch_record(const float *values);
+
+/**
+ * @brief Seal the open batch if it has reached its age limit.
+ */
+void telemetry_batch_poll(void);
+
+/**
+ * @brief Oldest sealed batch, or false when none is waiting.
+ *
+ * The pointer stays valid until the next call into this module.
+ */
+bool telemetry_batch_peek(const uint8_t **data, size_t *len);
+
+/**
+ * @brief Drop the batch returned by telemetry_batch_peek() once it is sent.
+ */
+void telemetry_batch_pop(void);
+
+/**
+ * @brief Sealed batches dropped because the store was full, since boot.
+ */
+uint32_t telemetry_batch_dropped(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,60 @@
+/**
+ * @file telemetry_cbor.h
+ * @brief Minimal CBOR (RFC 8949) writer for telemetry payloads.
+ *
+ * Writes into a caller-owned buffer with no allocation. Maps are emitted with
+ * indefinite length so sensors can add fields without counting them first.
+ * Once the buffer is full every further write is dropped and @c overflow is
+ * set; check it once when the payload is complete.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    uint8_t *buf;
+    size_t cap;
+    size_t len;
+    bool overflow;
+} telemetry_cbor_t;
+
+void telemetry_cbor_init(telemetry_cbor_t *enc, uint8_t *buf, size_t cap);
+
+void telemetry_cbor_map_begin(telemetry_cbor_t *enc);
+void telemetry_cbor_map_end(telemetry_cbor_t *enc);
+
+// Indefinite-length array, like maps
+void telemetry_cbor_array_begin(telemetry_cbor_t *enc);
+void telemetry_cbor_array_end(telemetry_cbor_t *enc);
+
+void telemetry_cbor_text(telemetry_cbor_t *enc, const char *text);
+void telemetry_cbor_int(telemetry_cbor_t *enc, int64_t value);
+void telemetry_cbor_bool(telemetry_cbor_t *enc, bool value);
+void telemetry_cbor_null(telemetry_cbor_t *enc);
+
+/**
+ * @brief Encode a float as half precision when that is exact, else single.
+ */
+void telemetry_cbor_float(telemetry_cbor_t *enc, float value);
+
+/**
+ * @brief Encode a JSON number: integers as CBOR integers, the rest as floats.
+ */
+void telemetry_cbor_number(telemetry_cbor_t *enc, double value);
+
+// Map entry helpers: text key followed by the value
+void telemetry_cbor_put_int(telemetry_cbor_t *enc, const char *key, int64_t value);
+void telemetry_cbor_put_float(telemetry_cbor_t *enc, const char *key, float value);
+void telemetry_cbor_put_bool(telemetry_cbor_t *enc, const char *key, bool value);
+void telemetry_cbor_put_text(telemetry_cbor_t *enc, const char *key, const char *value);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,655 @@
+/**
+ * @file night_summary.c
+ */
+
+#include "night_summary.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "esp_check.h"
+#include "esp_log.h"
+#include "esp_partition.h"
+#include "flash_guard.h"
+#include "esp_random.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "sdkconfig.h"
+#include "somnus_mqtt.h"
+#include "telemetry_cbor.h"
+
+#define NIGHT_SUMMARY_TAG "night_summary"
+
+#ifndef CONFIG_SENSOR_MANAGER_NIGHT_EPOCH_S
+#define CONFIG_SENSOR_MANAGER_NIGHT_EPOCH_S 300
+#endif
+
+#define NIGHT_MAGIC 0x5447494Eu        // "NIGT"
+#define HEADER_BYTES 256
+#define RECORD_HEAD_BYTES 16
+#define RECORD_ALIGN 16
+#define SECTOR_BYTES 4096
+#define LABEL_LEN 16
+// Wall-clock times before this are an unset clock
+#define EPOCH_VALID_MS 1600000000000LL
+#define PAYLOAD_BYTES 2048
+// A morning after an outage is spread over several periods, like batches
+#define SENDS_PER_CALL 2
+
+// Written once at the start of a night; the fields after labels start erased
+// and are programmed in place as the night goes on
+typedef struct {
+    uint32_t magic;
+    uint32_t id;                      // Random per night; tags its records
+    uint32_t layout;                  // Hash of the channel set
+    uint16_t epoch_s;
+    uint16_t record_bytes;
+    int64_t start_ms;
+    uint8_t channel_count;
+    uint8_t wall;                     // start_ms is Unix epoch time
+    uint8_t reserved[6];
+    char labels[NIGHT_SUMMARY_MAX_EVENT_KINDS][LABEL_LEN];  // All ones until first seen
+    int64_t end_ms;                   // All ones until the night ends
+    uint32_t published;               // All ones until every piece is out
+    uint32_t reserved2;
+} night_header_t;
+
+_Static_assert(sizeof(night_header_t) <= HEADER_BYTES, "night header outgrew its slot");
+
+typedef struct {
+    uint32_t n;                       // Readings in the epoch; 0 leaves the rest undefined
+    float min;
+    float mean;
+    float max;
+    float p50;
+    float p90;
+} night_stats_t;
+
+typedef struct {
+    uint32_t id;
+    uint16_t index;
+    uint16_t reserved;
+    uint8_t events[NIGHT_SUMMARY_MAX_EVENT_KINDS];
+    night_stats_t ch[];
+} night_record_t;
+
+_Static_assert(sizeof(night_record_t) == RECORD_HEAD_BYTES, "record head size");
+
+#define RECORD_MAX_BYTES (RECORD_HEAD_BYTES + sizeof(night_stats_t) * TELEMETRY_BATCH_MAX_CHANNELS)
+
+// P² quantile estimate (Jain & Chlamtac): five markers, no stored samples
+typedef struct {
+    float q[5];                       // Marker heights; the first n sorted while n < 5
+    float pos[5];
+    float want[5];
+    uint32_t n;
+} p2_t;
+
+typedef struct {
+    uint32_t n;
+    float min;
+    float max;
+    float sum;
+    p2_t p50;
+    p2_t p90;
+} epoch_acc_t;
+
+static struct {
+    const esp_partition_t *part;
+    const telemetry_batch_channel_t *channels;
+    size_t count;
+    uint32_t layout;
+    night_header_t hdr;
+    size_t record_bytes;
+    uint32_t capacity;                // Epoch records that fit in the partition
+    uint32_t epochs;                  // Records written this night
+    size_t erased_to;
+    bool want_open;                   // Set from any task
+    volatile bool open;
+    bool full_logged;
+    int64_t start_us;
+    int64_t epoch_start_us;
+    epoch_acc_t acc[TELEMETRY_BATCH_MAX_CHANNELS];
+    portMUX_TYPE lock;                // Guards the event fields below
+    const char *labels[NIGHT_SUMMARY_MAX_EVENT_KINDS];
+    uint8_t label_count;
+    uint8_t counts[NIGHT_SUMMARY_MAX_EVENT_KINDS];
+    uint8_t labels_written;
+    bool publishing;
+    uint32_t step;                    // 0 is the summary, then series chunks
+    uint8_t *payload;
+} s_night = { .lock = portMUX_INITIALIZER_UNLOCKED };
+
+static uint8_t s_record[RECORD_MAX_BYTES] __attribute__((aligned(4)));
+
+static void p2_add(p2_t *s, float p, float x)
+{
+    if (s->n < 5) {
+        uint32_t i = s->n++;
+        while (i > 0 && s->q[i - 1] > x) {
+            s->q[i] = s->q[i - 1];
+            --i;
+        }
+        s->q[i] = x;
+        if (s->n == 5) {
+            for (int m = 0; m < 5; ++m) {
+                s->pos[m] = (float)m;
+            }
+            s->want[0] = 0.0f;
+            s->want[1] = 2.0f * p;
+            s->want[2] = 4.0f * p;
+            s->want[3] = 2.0f + 2.0f * p;
+            s->want[4] = 4.0f;
+        }
+        return;
+    }
+
+    int k;
+    if (x < s->q[0]) {
+        s->q[0] = x;
+        k = 0;
+    } else if (x >= s->q[4]) {
+        s->q[4] = x;
+        k = 3;
+    } else {
+        k = 0;
+        while (x >= s->q[k + 1]) {
+            ++k;
+        }
+    }
+    for (int m = k + 1; m < 5; ++m) {
+        s->pos[m] += 1.0f;
+    }
+    const float step[5] = {0.0f, p / 2.0f, p, (1.0f + p) / 2.0f, 1.0f};
+    for (int m = 0; m < 5; ++m) {
+        s->want[m] += step[m];
+    }
+    s->n++;
+
+    for (int m = 1; m < 4; ++m) {
+        float d = s->want[m] - s->pos[m];
+        if ((d >= 1.0f && s->pos[m + 1] - s->pos[m] > 1.0f) || (d <= -1.0f && s->pos[m - 1] - s->pos[m] < -1.0f)) {
+            float dir = d > 0.0f ? 1.0f : -1.0f;
+            // Piecewise-parabolic step, linear when that would leave the bracket
+            float qp = s->q[m] + dir / (s->pos[m + 1] - s->pos[m - 1]) *
+                       ((s->pos[m] - s->pos[m - 1] + dir) * (s->q[m + 1] - s->q[m]) / (s->pos[m + 1] - s->pos[m]) +
+                        (s->pos[m + 1] - s->pos[m] - dir) * (s->q[m] - s->q[m - 1]) / (s->pos[m] - s->pos[m - 1]));
+            if (qp <= s->q[m - 1] || qp >= s->q[m + 1]) {
+                int j = m + (int)dir;
+                qp = s->q[m] + dir * (s->q[j] - s->q[m]) / (s->pos[j] - s->pos[m]);
+            }
+            s->q[m] = qp;
+            s->pos[m] += dir;
+        }
+    }
+}
+
+static float p2_get(const p2_t *s, float p)
+{
+    if (s->n == 0) {
+        return NAN;
+    }
+    if (s->n < 5) {
+        return s->q[(uint32_t)lroundf(p * (float)(s->n - 1))];
+    }
+    return s->q[2];
+}
+
+static uint32_t layout_hash(void)
+{
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < s_night.count; ++i) {
+        const telemetry_batch_channel_t *ch = &s_night.channels[i];
+        for (const char *p = ch->group; *p; ++p) {
+            h = (h ^ (uint8_t)*p) * 16777619u;
+        }
+        h = (h ^ '.') * 16777619u;
+        for (const char *p = ch->key; *p; ++p) {
+            h = (h ^ (uint8_t)*p) * 16777619u;
+        }
+    }
+    return h;
+}
+
+static int64_t now_ms(bool *wall)
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    int64_t wall_ms = (int64_t)tv.tv_sec * 1000 + tv.tv_usec / 1000;
+    *wall = wall_ms >= EPOCH_VALID_MS;
+    return *wall ? wall_ms : esp_timer_get_time() / 1000;
+}
+
+static size_t record_offset(uint32_t index)
+{
+    return HEADER_BYTES + (size_t)index * s_night.record_bytes;
+}
+
+static esp_err_t write_at(size_t offset, const void *data, size_t len)
+{
+    // Sectors are erased as the night reaches them, not all at bedtime
+    while (s_night.erased_to < offset + len) {
+        ESP_RETURN_ON_ERROR(flash_guard_erase_range(s_night.part, s_night.erased_to, SECTOR_BYTES),
+                            NIGHT_SUMMARY_TAG, "erase");
+        s_night.erased_to += SECTOR_BYTES;
+    }
+    return esp_partition_write(s_night.part, offset, data, len);
+}
+
+// Header fields programmed after the start land on bytes still erased
+static esp_err_t write_header_field(size_t offset, const void *data, size_t len)
+{
+    return esp_partition_write(s_night.part, offset, data, len);
+}
+
+static void reset_epoch(void)
+{
+    memset(s_night.acc, 0, sizeof(s_night.acc));
+    s_night.epoch_start_us = esp_timer_get_time();
+}
+
+static void night_begin(void)
+{
+    if (s_night.publishing) {
+        ESP_LOGW(NIGHT_SUMMARY_TAG, "Previous night was never fully published; discarding it");
+        s_night.publishing = false;
+        free(s_night.payload);
+        s_night.payload = NULL;
+    }
+    bool wall;
+    memset(&s_night.hdr, 0xFF, sizeof(s_night.hdr));
+    s_night.hdr.magic = NIGHT_MAGIC;
+    s_night.hdr.id = esp_random();
+    s_night.hdr.layout = s_night.layout;
+    s_night.hdr.epoch_s = CONFIG_SENSOR_MANAGER_NIGHT_EPOCH_S;
+    s_night.hdr.record_bytes = (uint16_t)s_night.record_bytes;
+    s_night.hdr.start_ms = now_ms(&wall);
+    s_night.hdr.channel_count = (uint8_t)s_night.count;
+    s_night.hdr.wall = wall;
+    memset(s_night.hdr.reserved, 0, sizeof(s_night.hdr.reserved));
+
+    s_night.erased_to = 0;
+    esp_err_t err = write_at(0, &s_night.hdr, offsetof(night_header_t, labels));
+    if (err != ESP_OK) {
+        ESP_LOGE(NIGHT_SUMMARY_TAG, "Cannot start the night: %s", esp_err_to_name(err));
+        return;
+    }
+    portENTER_CRITICAL(&s_night.lock);
+    s_night.label_count = 0;
+    memset(s_night.counts, 0, sizeof(s_night.counts));
+    portEXIT_CRITICAL(&s_night.lock);
+    s_night.labels_written = 0;
+    s_night.epochs = 0;
+    s_night.full_logged = false;
+    s_night.start_us = esp_timer_get_time();
+    reset_epoch();
+    s_night.open = true;
+    ESP_LOGI(NIGHT_SUMMARY_TAG, "Night started (%u epochs of %u s fit)", (unsigned)s_night.capacity,
+             (unsigned)s_night.hdr.epoch_s);
+}
+
+static void close_epoch(void)
+{
+    night_record_t *rec = (night_record_t *)s_record;
+    memset(s_record, 0, s_night.record_bytes);
+    rec->id = s_night.hdr.id;
+    rec->index = (uint16_t)s_night.epochs;
+
+    const char *labels[NIGHT_SUMMARY_MAX_EVENT_KINDS];
+    portENTER_CRITICAL(&s_night.lock);
+    uint8_t label_count = s_night.label_count;
+    memcpy(labels, s_night.labels, sizeof(labels));
+    memcpy(rec->events, s_night.counts, sizeof(rec->events));
+    memset(s_night.counts, 0, sizeof(s_night.counts));
+    portEXIT_CRITICAL(&s_night.lock);
+
+    for (size_t c = 0; c < s_night.count; ++c) {
+        const epoch_acc_t *acc = &s_night.acc[c];
+        night_stats_t *st = &rec->ch[c];
+        st->n = acc->n;
+        if (acc->n) {
+            st->min = acc->min;
+            st->max = acc->max;
+            st->mean = acc->sum / (float)acc->n;
+            st->p50 = p2_get(&acc->p50, 0.5f);
+            st->p90 = p2_get(&acc->p90, 0.9f);
+        }
+    }
+    reset_epoch();
+
+    // A label goes to flash before the first record that counts it
+    for (; s_night.labels_written < label_count; ++s_night.labels_written) {
+        char *name = s_night.hdr.labels[s_night.labels_written];
+        memset(name, 0, LABEL_LEN);
+        strlcpy(name, labels[s_night.labels_written], LABEL_LEN);
+        write_header_field(offsetof(night_header_t, labels) + LABEL_LEN * s_night.labels_written, name, LABEL_LEN);
+    }
+    if (s_night.epochs >= s_night.capacity) {
+        if (!s_night.full_logged) {
+            ESP_LOGW(NIGHT_SUMMARY_TAG, "Night partition full after %u epochs", (unsigned)s_night.epochs);
+            s_night.full_logged = true;
+        }
+        return;
+    }
+    esp_err_t err = write_at(record_offset(s_night.epochs), rec, s_night.record_bytes);
+    if (err != ESP_OK) {
+        ESP_LOGW(NIGHT_SUMMARY_TAG, "Epoch %u not stored: %s", (unsigned)s_night.epochs, esp_err_to_name(err));
+        return;
+    }
+    s_night.epochs++;
+}
+
+static void night_end(void)
+{
+    bool any = false;
+    for (size_t c = 0; c < s_night.count; ++c) {
+        any |= s_night.acc[c].n > 0;
+    }
+    if (any) {
+        close_epoch();
+    }
+    s_night.open = false;
+    // Same time base as the start, even if SNTP set the clock during the night
+    int64_t end_ms = s_night.hdr.start_ms + (esp_timer_get_time() - s_night.start_us) / 1000;
+    write_header_field(offsetof(night_header_t, end_ms), &end_ms, sizeof(end_ms));
+    s_night.hdr.end_ms = end_ms;
+    s_night.publishing = true;
+    s_night.step = 0;
+    ESP_LOGI(NIGHT_SUMMARY_TAG, "Night ended after %u epochs", (unsigned)s_night.epochs);
+}
+
+static bool read_stats(uint32_t index, size_t channel, night_stats_t *out)
+{
+    size_t offset = record_offset(index) + RECORD_HEAD_BYTES + channel * sizeof(night_stats_t);
+    return esp_partition_read(s_night.part, offset, out, sizeof(*out)) == ESP_OK && out->n > 0;
+}
+
+typedef struct {
+    float value;
+    uint32_t weight;
+} weighted_t;
+
+static int compare_weighted(const void *a, const void *b)
+{
+    float x = ((const weighted_t *)a)->value;
+    float y = ((const weighted_t *)b)->value;
+    return (x > y) - (x < y);
+}
+
+static float weighted_quantile(weighted_t *items, size_t count, uint64_t total, float p)
+{
+    qsort(items, count, sizeof(*items), compare_weighted);
+    uint64_t target = (uint64_t)ceilf(p * (float)total);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < count; ++i) {
+        seen += items[i].weight;
+        if (seen >= target) {
+            return items[i].value;
+        }
+    }
+    return items[count - 1].value;
+}
+
+static void encode_summary(telemetry_cbor_t *enc)
+{
+    telemetry_cbor_map_begin(enc);
+    telemetry_cbor_put_int(enc, "v", NIGHT_SUMMARY_VERSION);
+    telemetry_cbor_put_int(enc, "id", s_night.hdr.id);
+    telemetry_cbor_put_int(enc, "start", s_night.hdr.start_ms);
+    telemetry_cbor_put_int(enc, "end", s_night.hdr.end_ms);
+    telemetry_cbor_put_bool(enc, "wall", s_night.hdr.wall);
+    telemetry_cbor_put_int(enc, "epoch_s", s_night.hdr.epoch_s);
+    telemetry_cbor_put_int(enc, "epochs", s_night.epochs);
+
+    weighted_t *p50 = s_night.epochs ? malloc(sizeof(weighted_t) * s_night.epochs * 2) : NULL;
+    weighted_t *p90 = p50 ? p50 + s_night.epochs : NULL;
+    telemetry_cbor_text(enc, "channels");
+    telemetry_cbor_map_begin(enc);
+    for (size_t c = 0; c < s_night.count && p50; ++c) {
+        uint64_t total = 0;
+        float min = INFINITY;
+        float max = -INFINITY;
+        double sum = 0.0;
+        size_t used = 0;
+        for (uint32_t e = 0; e < s_night.epochs; ++e) {
+            night_stats_t st;
+            if (!read_stats(e, c, &st)) {
+                continue;
+            }
+            total += st.n;
+            min = fminf(min, st.min);
+            max = fmaxf(max, st.max);
+            sum += (double)st.mean * st.n;
+            p50[used] = (weighted_t){st.p50, st.n};
+            p90[used] = (weighted_t){st.p90, st.n};
+            used++;
+        }
+        if (used == 0) {
+            continue;
+        }
+        char name[64];
+        snprintf(name, sizeof(name), "%s.%s", s_night.channels[c].group, s_night.channels[c].key);
+        telemetry_cbor_text(enc, name);
+        telemetry_cbor_map_begin(enc);
+        telemetry_cbor_put_int(enc, "n", (int64_t)total);
+        telemetry_cbor_put_float(enc, "min", min);
+        telemetry_cbor_put_float(enc, "mean", (float)(sum / (double)total));
+        telemetry_cbor_put_float(enc, "max", max);
+        telemetry_cbor_put_float(enc, "p50", weighted_quantile(p50, used, total, 0.5f));
+        telemetry_cbor_put_float(enc, "p90", weighted_quantile(p90, used, total, 0.9f));
+        telemetry_cbor_map_end(enc);
+    }
+    telemetry_cbor_map_end(enc);
+    free(p50);
+
+    uint32_t events[NIGHT_SUMMARY_MAX_EVENT_KINDS] = {0};
+    for (uint32_t e = 0; e < s_night.epochs; ++e) {
+        uint8_t counts[NIGHT_SUMMARY_MAX_EVENT_KINDS];
+        if (esp_partition_read(s_night.part, record_offset(e) + offsetof(night_record_t, events), counts,
+                               sizeof(counts)) == ESP_OK) {
+            for (int k = 0; k < NIGHT_SUMMARY_MAX_EVENT_KINDS; ++k) {
+                events[k] += counts[k];
+            }
+        }
+    }
+    telemetry_cbor_text(enc, "events");
+    telemetry_cbor_map_begin(enc);
+    for (int k = 0; k < NIGHT_SUMMARY_MAX_EVENT_KINDS; ++k) {
+        const char *label = s_night.hdr.labels[k];
+        if ((uint8_t)label[0] == 0xFF || label[0] == '\0') {
+            continue;
+        }
+        char name[LABEL_LEN + 1] = {0};
+        memcpy(name, label, LABEL_LEN);
+        telemetry_cbor_put_int(enc, name, events[k]);
+    }
+    telemetry_cbor_map_end(enc);
+    telemetry_cbor_map_end(enc);
+}
+
+static void encode_series(telemetry_cbor_t *enc, size_t channel, uint32_t first)
+{
+    uint32_t last = first + NIGHT_SUMMARY_SERIES_CHUNK;
+    if (last > s_night.epochs) {
+        last = s_night.epochs;
+    }
+    char name[64];
+    snprintf(name, sizeof(name), "%s.%s", s_night.channels[channel].group, s_night.channels[channel].key);
+    telemetry_cbor_map_begin(enc);
+    telemetry_cbor_put_int(enc, "v", NIGHT_SUMMARY_VERSION);
+    telemetry_cbor_put_int(enc, "id", s_night.hdr.id);
+    telemetry_cbor_put_text(enc, "ch", name);
+    telemetry_cbor_put_int(enc, "first", first);
+    static const char *const FIELDS[] = {"mean", "min", "max"};
+    for (size_t f = 0; f < sizeof(FIELDS) / sizeof(FIELDS[0]); ++f) {
+        telemetry_cbor_text(enc, FIELDS[f]);
+        telemetry_cbor_array_begin(enc);
+        for (uint32_t e = first; e < last; ++e) {
+            night_stats_t st;
+            if (!read_stats(e, channel, &st)) {
+                telemetry_cbor_null(enc);
+                continue;
+            }
+            telemetry_cbor_float(enc, f == 0 ? st.mean : f == 1 ? st.min : st.max);
+        }
+        telemetry_cbor_array_end(enc);
+    }
+    telemetry_cbor_map_end(enc);
+}
+
+// Summary first, then each channel's series in chunks; stops at the first refusal
+static void publish_some(void)
+{
+    if (!s_night.payload) {
+        s_night.payload = malloc(PAYLOAD_BYTES);
+        if (!s_night.payload) {
+            return;
+        }
+    }
+    uint32_t chunks = (s_night.epochs + NIGHT_SUMMARY_SERIES_CHUNK - 1) / NIGHT_SUMMARY_SERIES_CHUNK;
+    uint32_t steps = 1 + (uint32_t)s_night.count * chunks;
+    for (int sent = 0; sent < SENDS_PER_CALL && s_night.step < steps; ++sent) {
+        telemetry_cbor_t enc;
+        telemetry_cbor_init(&enc, s_night.payload, PAYLOAD_BYTES);
+        if (s_night.step == 0) {
+            encode_summary(&enc);
+        } else {
+            uint32_t piece = s_night.step - 1;
+            encode_series(&enc, piece / chunks, (piece % chunks) * NIGHT_SUMMARY_SERIES_CHUNK);
+        }
+        if (enc.overflow) {
+            ESP_LOGW(NIGHT_SUMMARY_TAG, "Piece %u does not fit %u bytes; skipped", (unsigned)s_night.step,
+                     PAYLOAD_BYTES);
+            s_night.step++;
+            continue;
+        }
+        esp_err_t err = somnus_mqtt_publish_telemetry_night(s_night.payload, enc.len);
+        if (err != ESP_OK) {
+            ESP_LOGD(NIGHT_SUMMARY_TAG, "Night publish deferred (%s)", esp_err_to_name(err));
+            return;
+        }
+        s_night.step++;
+    }
+    if (s_night.step < steps) {
+        return;
+    }
+    uint32_t done = 0;
+    write_header_field(offsetof(night_header_t, published), &done, sizeof(done));
+    s_night.publishing = false;
+    free(s_night.payload);
+    s_night.payload = NULL;
+    ESP_LOGI(NIGHT_SUMMARY_TAG, "Night summary published (%u pieces)", (unsigned)steps);
+}
+
+esp_err_t night_summary_init(const telemetry_batch_channel_t *channels, size_t count)
+{
+    ESP_RETURN_ON_FALSE(channels && count > 0 && count <= TELEMETRY_BATCH_MAX_CHANNELS, ESP_ERR_INVALID_ARG,
+                        NIGHT_SUMMARY_TAG, "bad channel set");
+    const esp_partition_t *part =
+        esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, NIGHT_SUMMARY_PARTITION_LABEL);
+    ESP_RETURN_ON_FALSE(part, ESP_ERR_NOT_FOUND, NIGHT_SUMMARY_TAG, "no \"%s\" partition",
+                        NIGHT_SUMMARY_PARTITION_LABEL);
+    s_night.part = part;
+    s_night.channels = channels;
+    s_night.count = count;
+    s_night.layout = layout_hash();
+    size_t bytes = RECORD_HEAD_BYTES + sizeof(night_stats_t) * count;
+    s_night.record_bytes = (bytes + RECORD_ALIGN - 1) / RECORD_ALIGN * RECORD_ALIGN;
+    s_night.capacity = (uint32_t)((part->size - HEADER_BYTES) / s_night.record_bytes);
+    if (s_night.capacity > UINT16_MAX) {
+        s_night.capacity = UINT16_MAX;
+    }
+
+    night_header_t *hdr = &s_night.hdr;
+    ESP_RETURN_ON_ERROR(esp_partition_read(part, 0, hdr, sizeof(*hdr)), NIGHT_SUMMARY_TAG, "read header");
+    if (hdr->magic != NIGHT_MAGIC || hdr->layout != s_night.layout || hdr->channel_count != count ||
+        hdr->record_bytes != s_night.record_bytes || hdr->published != UINT32_MAX) {
+        return ESP_OK;
+    }
+    s_night.epochs = 0;
+    while (s_night.epochs < s_night.capacity) {
+        night_record_t head;
+        if (esp_partition_read(part, record_offset(s_night.epochs), &head, sizeof(head)) != ESP_OK ||
+            head.id != hdr->id || head.index != s_night.epochs) {
+            break;
+        }
+        s_night.epochs++;
+    }
+    if (hdr->end_ms == -1) {
+        // Cut short by a reset: the night ends with its last stored epoch
+        int64_t end_ms = hdr->start_ms + (int64_t)s_night.epochs * hdr->epoch_s * 1000;
+        write_header_field(offsetof(night_header_t, end_ms), &end_ms, sizeof(end_ms));
+        hdr->end_ms = end_ms;
+    }
+    s_night.publishing = true;
+    s_night.step = 0;
+    ESP_LOGI(NIGHT_SUMMARY_TAG, "Night of %u epochs from before reset waits to be published",
+             (unsigned)s_night.epochs);
+    return ESP_OK;
+}
+
+void night_summary_set_open(bool open)
+{
+    __atomic_store_n(&s_night.want_open, open, __ATOMIC_RELEASE);
+}
+
+bool night_summary_is_open(void)
+{
+    return s_night.open;
+}
+
+void night_summary_count_event(const char *label)
+{
+    if (!s_night.open || !label) {
+        return;
+    }
+    portENTER_CRITICAL(&s_night.lock);
+    uint8_t k = 0;
+    while (k < s_night.label_count && s_night.labels[k] != label && strcmp(s_night.labels[k], label) != 0) {
+        ++k;
+    }
+    if (k == s_night.label_count && k < NIGHT_SUMMARY_MAX_EVENT_KINDS) {
+        s_night.labels[s_night.label_count++] = label;
+    }
+    if (k < s_night.label_count && s_night.counts[k] < UINT8_MAX) {
+        s_night.counts[k]++;
+    }
+    portEXIT_CRITICAL(&s_night.lock);
+}
+
+void night_summary_record(const float *values)
+{
+    if (!s_night.part) {
+        return;
+    }
+    bool want = __atomic_load_n(&s_night.want_open, __ATOMIC_ACQUIRE);
+    if (want && !s_night.open) {
+        night_begin();
+    } else if (!want && s_night.open) {
+        night_end();
+    }
+
+    if (s_night.open && values) {
+        for (size_t c = 0; c < s_night.count; ++c) {
+            float v = values[c];
+            if (isnan(v)) {
+                continue;
+            }
+            epoch_acc_t *acc = &s_night.acc[c];
+            acc->min = acc->n ? fminf(acc->min, v) : v;
+            acc->max = acc->n ? fmaxf(acc->max, v) : v;
+            acc->sum += v;
+            acc->n++;
+            p2_add(&acc->p50, 0.5f, v);
+            p2_add(&acc->p90, 0.9f, v);
+        }
+        if (esp_timer_get_time() - s_night.epoch_start_us >= (int64_t)s_night.hdr.epoch_s * 1000000) {
+            close_epoch();
+        }
+    }
+    if (s_night.publishing && !s_night.open) {
+        publish_some();
+    }
+}
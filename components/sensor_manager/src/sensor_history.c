@@ -0,0 +1,685 @@
+/**
+ * @file sensor_history.c
+ */
+
+#include "sensor_history.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "esp_check.h"
+#include "esp_log.h"
+#include "esp_partition.h"
+#include "flash_guard.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+#define SENSOR_HISTORY_TAG "sensor_history"
+
+#define SECTOR_BYTES 4096
+#define SECTOR_MAGIC 0x53545348u       // "HSTS"
+#define SECTOR_HEAD_BYTES 16
+#define BLOCK_MAGIC 0x5B
+#define BLOCK_HEAD_BYTES 12
+#define BLOCK_PAYLOAD_MAX 116
+#define MAX_SECTORS 256
+// Wall-clock seconds before this are an unset clock
+#define CLOCK_VALID_S 1600000000u
+// A raw row at least this often, so a gap reads as missing data, not a flat line
+#define RAW_HEARTBEAT_S 300
+#define MAX_DECIMALS 6
+#define DAY_S 86400u
+
+typedef struct {
+    uint32_t magic;
+    uint32_t layout;                  // Hash of the channel set
+    uint32_t seq;                     // Increases by one per sector written, per tier
+    uint8_t tier;
+    uint8_t reserved[3];
+} sector_head_t;
+
+typedef struct __attribute__((packed)) {
+    uint8_t magic;
+    uint8_t channel;
+    uint16_t len;                     // Payload bytes; 0 in RAM means no open block
+    uint32_t t0;
+    uint32_t t1;
+} block_head_t;
+
+_Static_assert(sizeof(sector_head_t) == SECTOR_HEAD_BYTES, "sector head size");
+_Static_assert(sizeof(block_head_t) == BLOCK_HEAD_BYTES, "block head size");
+
+// RAM index of one sector; seq 0 marks one that is empty or from another channel set
+typedef struct {
+    uint32_t seq;
+    uint32_t t_min;
+    uint32_t t_max;
+} sector_index_t;
+
+// Head and payload contiguous, so a block is written as one span
+typedef struct {
+    block_head_t head;
+    uint8_t payload[BLOCK_PAYLOAD_MAX];
+    int32_t last;
+} open_block_t;
+
+typedef struct {
+    float sum;
+    uint32_t n;
+    uint32_t bucket;
+} mean_acc_t;
+
+static const struct {
+    uint32_t period_s;                // 0: every change
+    uint32_t flush_s;                 // Oldest an open block may get
+    uint8_t share;                    // Eighths of the partition
+    const char *name;
+} TIERS[SENSOR_HISTORY_TIER_COUNT] = {
+    [SENSOR_HISTORY_TIER_RAW] = {0, 300, 5, "raw"},
+    [SENSOR_HISTORY_TIER_1MIN] = {60, 1800, 2, "1m"},
+    [SENSOR_HISTORY_TIER_15MIN] = {900, 7200, 1, "15m"},
+};
+
+static const float POW10[MAX_DECIMALS + 1] = {1.0f, 10.0f, 100.0f, 1e3f, 1e4f, 1e5f, 1e6f};
+
+static struct {
+    const esp_partition_t *part;
+    const telemetry_batch_channel_t *channels;
+    size_t count;
+    uint32_t layout;
+    SemaphoreHandle_t lock;           // Flash, index and open blocks
+    uint32_t first[SENSOR_HISTORY_TIER_COUNT];   // Ring of each tier, in sectors
+    uint32_t sectors[SENSOR_HISTORY_TIER_COUNT];
+    uint32_t cur[SENSOR_HISTORY_TIER_COUNT];     // Sector being filled
+    uint32_t offset[SENSOR_HISTORY_TIER_COUNT];  // Next free byte in it; 0 before the first
+    sector_index_t index[MAX_SECTORS];
+    open_block_t *open;               // [tier][channel]
+    mean_acc_t mean[SENSOR_HISTORY_TIER_COUNT][TELEMETRY_BATCH_MAX_CHANNELS];
+    int32_t raw_last[TELEMETRY_BATCH_MAX_CHANNELS];
+    uint32_t raw_t[TELEMETRY_BATCH_MAX_CHANNELS];
+} s_hist;
+
+static uint32_t layout_hash(void)
+{
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < s_hist.count; ++i) {
+        const telemetry_batch_channel_t *ch = &s_hist.channels[i];
+        for (const char *p = ch->group; *p; ++p) {
+            h = (h ^ (uint8_t)*p) * 16777619u;
+        }
+        h = (h ^ '.') * 16777619u;
+        for (const char *p = ch->key; *p; ++p) {
+            h = (h ^ (uint8_t)*p) * 16777619u;
+        }
+        h = (h ^ ch->decimals) * 16777619u;
+    }
+    return h;
+}
+
+static size_t put_varint(uint8_t *out, uint32_t value)
+{
+    size_t n = 0;
+    while (value >= 0x80) {
+        out[n++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    out[n++] = (uint8_t)value;
+    return n;
+}
+
+static bool get_varint(const uint8_t *in, size_t len, size_t *at, uint32_t *value)
+{
+    uint32_t v = 0;
+    for (int shift = 0; shift < 35 && *at < len; shift += 7) {
+        uint8_t b = in[(*at)++];
+        v |= (uint32_t)(b & 0x7F) << shift;
+        if (!(b & 0x80)) {
+            *value = v;
+            return true;
+        }
+    }
+    return false;
+}
+
+static uint32_t zigzag(int32_t value)
+{
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+static int32_t unzigzag(uint32_t value)
+{
+    return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+static int32_t scale(size_t channel, float value)
+{
+    float v = roundf(value * POW10[s_hist.channels[channel].decimals]);
+    v = fminf(fmaxf(v, (float)INT32_MIN), (float)INT32_MAX);
+    return (int32_t)v;
+}
+
+static open_block_t *open_block(sensor_history_tier_t tier, size_t channel)
+{
+    return &s_hist.open[tier * s_hist.count + channel];
+}
+
+static bool tier_of_sector(uint32_t sector, sensor_history_tier_t *tier)
+{
+    for (int t = 0; t < SENSOR_HISTORY_TIER_COUNT; ++t) {
+        if (sector >= s_hist.first[t] && sector < s_hist.first[t] + s_hist.sectors[t]) {
+            *tier = (sensor_history_tier_t)t;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Move the tier's ring on by one sector, erasing the oldest
+static esp_err_t next_sector(sensor_history_tier_t tier)
+{
+    uint32_t next = s_hist.cur[tier] + 1;
+    uint32_t seq = s_hist.index[s_hist.cur[tier]].seq + 1;
+    if (s_hist.offset[tier] == 0) {
+        next = s_hist.first[tier];
+        seq = 1;
+    } else if (next >= s_hist.first[tier] + s_hist.sectors[tier]) {
+        next = s_hist.first[tier];
+    }
+    s_hist.index[next].seq = 0;
+    size_t base = (size_t)next * SECTOR_BYTES;
+    ESP_RETURN_ON_ERROR(flash_guard_erase_range(s_hist.part, base, SECTOR_BYTES), SENSOR_HISTORY_TAG, "erase");
+    const sector_head_t head = {
+        .magic = SECTOR_MAGIC,
+        .layout = s_hist.layout,
+        .seq = seq,
+        .tier = (uint8_t)tier,
+    };
+    ESP_RETURN_ON_ERROR(esp_partition_write(s_hist.part, base, &head, sizeof(head)), SENSOR_HISTORY_TAG,
+                        "sector head");
+    s_hist.index[next] = (sector_index_t){.seq = seq, .t_min = UINT32_MAX, .t_max = 0};
+    s_hist.cur[tier] = next;
+    s_hist.offset[tier] = SECTOR_HEAD_BYTES;
+    return ESP_OK;
+}
+
+static void flush_block(sensor_history_tier_t tier, size_t channel)
+{
+    open_block_t *ob = open_block(tier, channel);
+    if (ob->head.len == 0) {
+        return;
+    }
+    size_t size = BLOCK_HEAD_BYTES + ob->head.len;
+    ob->head.magic = BLOCK_MAGIC;
+    if ((s_hist.offset[tier] == 0 || s_hist.offset[tier] + size > SECTOR_BYTES) && next_sector(tier) != ESP_OK) {
+        ob->head.len = 0;
+        return;
+    }
+    // Head and payload are contiguous in the open block
+    size_t at = (size_t)s_hist.cur[tier] * SECTOR_BYTES + s_hist.offset[tier];
+    esp_err_t err = esp_partition_write(s_hist.part, at, &ob->head, size);
+    if (err != ESP_OK) {
+        ESP_LOGW(SENSOR_HISTORY_TAG, "Block write failed: %s", esp_err_to_name(err));
+    } else {
+        sector_index_t *idx = &s_hist.index[s_hist.cur[tier]];
+        idx->t_min = ob->head.t0 < idx->t_min ? ob->head.t0 : idx->t_min;
+        idx->t_max = ob->head.t1 > idx->t_max ? ob->head.t1 : idx->t_max;
+    }
+    s_hist.offset[tier] += size;
+    ob->head.len = 0;
+}
+
+static void add_row(sensor_history_tier_t tier, size_t channel, uint32_t t, int32_t value)
+{
+    open_block_t *ob = open_block(tier, channel);
+    if (ob->head.len && t >= ob->head.t1) {
+        uint8_t row[10];
+        size_t n = put_varint(row, t - ob->head.t1);
+        n += put_varint(row + n, zigzag(value - ob->last));
+        if (ob->head.len + n <= BLOCK_PAYLOAD_MAX) {
+            memcpy(ob->payload + ob->head.len, row, n);
+            ob->head.len += n;
+            ob->head.t1 = t;
+            ob->last = value;
+            return;
+        }
+    }
+    // Full, or the clock went back: this row starts a new block
+    flush_block(tier, channel);
+    ob->head.channel = (uint8_t)channel;
+    ob->head.t0 = t;
+    ob->head.t1 = t;
+    ob->head.len = (uint16_t)put_varint(ob->payload, zigzag(value));
+    ob->last = value;
+}
+
+// Whole sector into buf; returns its valid bytes, 0 if it is not ours
+static size_t scan_sector(uint32_t sector, uint8_t *buf, sector_index_t *idx)
+{
+    *idx = (sector_index_t){0};
+    if (esp_partition_read(s_hist.part, (size_t)sector * SECTOR_BYTES, buf, SECTOR_BYTES) != ESP_OK) {
+        return 0;
+    }
+    sector_head_t head;
+    memcpy(&head, buf, sizeof(head));
+    sensor_history_tier_t tier;
+    if (head.magic != SECTOR_MAGIC || head.layout != s_hist.layout || head.seq == 0 ||
+        !tier_of_sector(sector, &tier) || head.tier != tier) {
+        return 0;
+    }
+    idx->seq = head.seq;
+    idx->t_min = UINT32_MAX;
+    size_t at = SECTOR_HEAD_BYTES;
+    while (at + BLOCK_HEAD_BYTES <= SECTOR_BYTES) {
+        block_head_t block;
+        memcpy(&block, buf + at, sizeof(block));
+        if (block.magic != BLOCK_MAGIC || block.len > BLOCK_PAYLOAD_MAX || block.channel >= s_hist.count ||
+            at + BLOCK_HEAD_BYTES + block.len > SECTOR_BYTES) {
+            break;
+        }
+        idx->t_min = block.t0 < idx->t_min ? block.t0 : idx->t_min;
+        idx->t_max = block.t1 > idx->t_max ? block.t1 : idx->t_max;
+        at += BLOCK_HEAD_BYTES + block.len;
+    }
+    return at;
+}
+
+esp_err_t sensor_history_init(const telemetry_batch_channel_t *channels, size_t count)
+{
+    ESP_RETURN_ON_FALSE(channels && count > 0 && count <= TELEMETRY_BATCH_MAX_CHANNELS, ESP_ERR_INVALID_ARG,
+                        SENSOR_HISTORY_TAG, "bad channel set");
+    const esp_partition_t *part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY,
+                                                           SENSOR_HISTORY_PARTITION_LABEL);
+    ESP_RETURN_ON_FALSE(part, ESP_ERR_NOT_FOUND, SENSOR_HISTORY_TAG, "no \"%s\" partition",
+                        SENSOR_HISTORY_PARTITION_LABEL);
+    uint32_t total = part->size / SECTOR_BYTES;
+    if (total > MAX_SECTORS) {
+        total = MAX_SECTORS;
+    }
+    ESP_RETURN_ON_FALSE(total >= 8, ESP_ERR_INVALID_SIZE, SENSOR_HISTORY_TAG, "partition too small");
+
+    if (!s_hist.lock) {
+        s_hist.lock = xSemaphoreCreateMutex();
+        ESP_RETURN_ON_FALSE(s_hist.lock, ESP_ERR_NO_MEM, SENSOR_HISTORY_TAG, "no memory for lock");
+    }
+    open_block_t *open = calloc(SENSOR_HISTORY_TIER_COUNT * count, sizeof(open_block_t));
+    uint8_t *buf = malloc(SECTOR_BYTES);
+    if (!open || !buf) {
+        free(open);
+        free(buf);
+        return ESP_ERR_NO_MEM;
+    }
+
+    xSemaphoreTake(s_hist.lock, portMAX_DELAY);
+    free(s_hist.open);
+    s_hist.open = open;
+    s_hist.part = part;
+    s_hist.channels = channels;
+    s_hist.count = count;
+    s_hist.layout = layout_hash();
+    memset(s_hist.mean, 0, sizeof(s_hist.mean));
+    memset(s_hist.raw_t, 0, sizeof(s_hist.raw_t));
+
+    uint32_t at = 0;
+    for (int t = 0; t < SENSOR_HISTORY_TIER_COUNT; ++t) {
+        s_hist.first[t] = at;
+        s_hist.sectors[t] = t == SENSOR_HISTORY_TIER_COUNT - 1 ? total - at : total * TIERS[t].share / 8;
+        at += s_hist.sectors[t];
+        s_hist.offset[t] = 0;
+    }
+    size_t kept = 0;
+    for (uint32_t s = 0; s < total; ++s) {
+        size_t end = scan_sector(s, buf, &s_hist.index[s]);
+        sensor_history_tier_t tier;
+        if (!end || !tier_of_sector(s, &tier)) {
+            continue;
+        }
+        kept++;
+        if (s_hist.offset[tier] == 0 || s_hist.index[s].seq > s_hist.index[s_hist.cur[tier]].seq) {
+            s_hist.cur[tier] = s;
+            s_hist.offset[tier] = end;
+        }
+    }
+    xSemaphoreGive(s_hist.lock);
+    free(buf);
+    ESP_LOGI(SENSOR_HISTORY_TAG, "%u of %u sectors hold history", (unsigned)kept, (unsigned)total);
+    return ESP_OK;
+}
+
+void sensor_history_record(const float *raw, const float *reported)
+{
+    if (!s_hist.part || !raw || !reported) {
+        return;
+    }
+    time_t now_s = time(NULL);
+    if (now_s < (time_t)CLOCK_VALID_S) {
+        return;
+    }
+    uint32_t now = (uint32_t)now_s;
+
+    xSemaphoreTake(s_hist.lock, portMAX_DELAY);
+    for (size_t c = 0; c < s_hist.count; ++c) {
+        if (isnan(reported[c])) {
+            continue;
+        }
+        int32_t v = scale(c, reported[c]);
+        if (s_hist.raw_t[c] == 0 || v != s_hist.raw_last[c] || now - s_hist.raw_t[c] >= RAW_HEARTBEAT_S) {
+            add_row(SENSOR_HISTORY_TIER_RAW, c, now, v);
+            s_hist.raw_last[c] = v;
+            s_hist.raw_t[c] = now;
+        }
+    }
+    for (int t = SENSOR_HISTORY_TIER_1MIN; t < SENSOR_HISTORY_TIER_COUNT; ++t) {
+        uint32_t period = TIERS[t].period_s;
+        uint32_t bucket = now / period;
+        for (size_t c = 0; c < s_hist.count; ++c) {
+            mean_acc_t *acc = &s_hist.mean[t][c];
+            if (acc->n && acc->bucket != bucket) {
+                add_row((sensor_history_tier_t)t, c, acc->bucket * period, scale(c, acc->sum / (float)acc->n));
+                acc->n = 0;
+                acc->sum = 0.0f;
+            }
+            if (!isnan(raw[c])) {
+                acc->bucket = bucket;
+                acc->sum += raw[c];
+                acc->n++;
+            }
+        }
+    }
+    for (int t = 0; t < SENSOR_HISTORY_TIER_COUNT; ++t) {
+        for (size_t c = 0; c < s_hist.count; ++c) {
+            const open_block_t *ob = open_block((sensor_history_tier_t)t, c);
+            if (ob->head.len && now - ob->head.t0 >= TIERS[t].flush_s) {
+                flush_block((sensor_history_tier_t)t, c);
+            }
+        }
+    }
+    xSemaphoreGive(s_hist.lock);
+}
+
+size_t sensor_history_channel_count(void)
+{
+    return s_hist.part ? s_hist.count : 0;
+}
+
+void sensor_history_channel_name(size_t channel, char *buf, size_t len)
+{
+    if (!buf || len == 0) {
+        return;
+    }
+    if (channel >= s_hist.count) {
+        buf[0] = '\0';
+        return;
+    }
+    snprintf(buf, len, "%s.%s", s_hist.channels[channel].group, s_hist.channels[channel].key);
+}
+
+int sensor_history_find_channel(const char *name)
+{
+    if (!name) {
+        return -1;
+    }
+    for (size_t c = 0; c < s_hist.count; ++c) {
+        const char *group = s_hist.channels[c].group;
+        size_t group_len = strlen(group);
+        if (strncmp(name, group, group_len) == 0 && name[group_len] == '.' &&
+            strcmp(name + group_len + 1, s_hist.channels[c].key) == 0) {
+            return (int)c;
+        }
+    }
+    return -1;
+}
+
+const char *sensor_history_tier_name(sensor_history_tier_t tier)
+{
+    return tier < SENSOR_HISTORY_TIER_COUNT ? TIERS[tier].name : "auto";
+}
+
+// Oldest time a tier still holds, flash or RAM; UINT32_MAX when empty
+static uint32_t tier_oldest(sensor_history_tier_t tier)
+{
+    uint32_t oldest = UINT32_MAX;
+    for (uint32_t s = s_hist.first[tier]; s < s_hist.first[tier] + s_hist.sectors[tier]; ++s) {
+        if (s_hist.index[s].seq && s_hist.index[s].t_min < oldest) {
+            oldest = s_hist.index[s].t_min;
+        }
+    }
+    for (size_t c = 0; c < s_hist.count; ++c) {
+        const open_block_t *ob = open_block(tier, c);
+        if (ob->head.len && ob->head.t0 < oldest) {
+            oldest = ob->head.t0;
+        }
+    }
+    return oldest;
+}
+
+sensor_history_tier_t sensor_history_pick_tier(uint32_t from_s, uint32_t to_s)
+{
+    uint32_t span = to_s > from_s ? to_s - from_s : 0;
+    sensor_history_tier_t tier = span <= DAY_S       ? SENSOR_HISTORY_TIER_RAW
+                                 : span <= 7 * DAY_S ? SENSOR_HISTORY_TIER_1MIN
+                                                     : SENSOR_HISTORY_TIER_15MIN;
+    if (!s_hist.part) {
+        return tier;
+    }
+    xSemaphoreTake(s_hist.lock, portMAX_DELAY);
+    while (tier + 1 < SENSOR_HISTORY_TIER_COUNT && tier_oldest(tier) > from_s) {
+        tier = (sensor_history_tier_t)(tier + 1);
+    }
+    xSemaphoreGive(s_hist.lock);
+    return tier;
+}
+
+static int compare_seq(const void *a, const void *b)
+{
+    uint32_t x = s_hist.index[*(const uint32_t *)a].seq;
+    uint32_t y = s_hist.index[*(const uint32_t *)b].seq;
+    return (x > y) - (x < y);
+}
+
+// Sectors of a tier overlapping the range, oldest first; caller holds the lock
+static size_t overlapping_sectors(sensor_history_tier_t tier, uint32_t from_s, uint32_t to_s, uint32_t *out,
+                                  uint32_t *seqs)
+{
+    size_t n = 0;
+    for (uint32_t s = s_hist.first[tier]; s < s_hist.first[tier] + s_hist.sectors[tier]; ++s) {
+        const sector_index_t *idx = &s_hist.index[s];
+        if (idx->seq && idx->t_max >= from_s && idx->t_min <= to_s) {
+            out[n++] = s;
+        }
+    }
+    qsort(out, n, sizeof(*out), compare_seq);
+    for (size_t i = 0; i < n; ++i) {
+        seqs[i] = s_hist.index[out[i]].seq;
+    }
+    return n;
+}
+
+static bool emit_block(const block_head_t *head, const uint8_t *payload, int channel, uint32_t from_s,
+                       uint32_t to_s, sensor_history_point_cb_t cb, void *ctx)
+{
+    if ((channel >= 0 && head->channel != channel) || head->channel >= s_hist.count || head->t1 < from_s ||
+        head->t0 > to_s) {
+        return true;
+    }
+    float div = POW10[s_hist.channels[head->channel].decimals];
+    size_t at = 0;
+    uint32_t raw;
+    if (!get_varint(payload, head->len, &at, &raw)) {
+        return true;
+    }
+    int32_t value = unzigzag(raw);
+    uint32_t t = head->t0;
+    for (;;) {
+        if (t > to_s) {
+            return true;
+        }
+        if (t >= from_s && !cb(head->channel, t, (float)value / div, ctx)) {
+            return false;
+        }
+        uint32_t dt;
+        uint32_t dv;
+        if (!get_varint(payload, head->len, &at, &dt) || !get_varint(payload, head->len, &at, &dv)) {
+            return true;
+        }
+        t += dt;
+        value += unzigzag(dv);
+    }
+}
+
+// Every block of a tier overlapping the range, flash then RAM, oldest first
+typedef bool (*block_visit_t)(const block_head_t *head, const uint8_t *payload, void *ctx);
+
+static esp_err_t visit_blocks(sensor_history_tier_t tier, uint32_t from_s, uint32_t to_s, block_visit_t visit,
+                              void *ctx)
+{
+    uint32_t *sectors = malloc(sizeof(uint32_t) * 2 * s_hist.sectors[tier]);
+    uint8_t *buf = malloc(SECTOR_BYTES);
+    if (!sectors || !buf) {
+        free(sectors);
+        free(buf);
+        return ESP_ERR_NO_MEM;
+    }
+    uint32_t *seqs = sectors + s_hist.sectors[tier];
+    xSemaphoreTake(s_hist.lock, portMAX_DELAY);
+    size_t n = overlapping_sectors(tier, from_s, to_s, sectors, seqs);
+    xSemaphoreGive(s_hist.lock);
+
+    bool more = true;
+    for (size_t i = 0; i < n && more; ++i) {
+        // The ring may have moved on to this sector since the list was made
+        xSemaphoreTake(s_hist.lock, portMAX_DELAY);
+        bool same = s_hist.index[sectors[i]].seq == seqs[i] &&
+                    esp_partition_read(s_hist.part, (size_t)sectors[i] * SECTOR_BYTES, buf, SECTOR_BYTES) == ESP_OK;
+        xSemaphoreGive(s_hist.lock);
+        if (!same) {
+            continue;
+        }
+        size_t at = SECTOR_HEAD_BYTES;
+        while (more && at + BLOCK_HEAD_BYTES <= SECTOR_BYTES) {
+            block_head_t head;
+            memcpy(&head, buf + at, sizeof(head));
+            if (head.magic != BLOCK_MAGIC || head.len > BLOCK_PAYLOAD_MAX ||
+                at + BLOCK_HEAD_BYTES + head.len > SECTOR_BYTES) {
+                break;
+            }
+            if (head.t1 >= from_s && head.t0 <= to_s) {
+                more = visit(&head, buf + at + BLOCK_HEAD_BYTES, ctx);
+            }
+            at += BLOCK_HEAD_BYTES + head.len;
+        }
+    }
+
+    // Open blocks last: each is newer than everything of its channel in flash
+    xSemaphoreTake(s_hist.lock, portMAX_DELAY);
+    size_t bytes = s_hist.count * sizeof(open_block_t);
+    if (bytes <= SECTOR_BYTES) {
+        memcpy(buf, open_block(tier, 0), bytes);
+    }
+    xSemaphoreGive(s_hist.lock);
+    for (size_t c = 0; more && bytes <= SECTOR_BYTES && c < s_hist.count; ++c) {
+        const open_block_t *ob = (const open_block_t *)buf + c;
+        if (ob->head.len && ob->head.t1 >= from_s && ob->head.t0 <= to_s) {
+            block_head_t head = ob->head;
+            head.magic = BLOCK_MAGIC;
+            more = visit(&head, ob->payload, ctx);
+        }
+    }
+    free(buf);
+    free(sectors);
+    return ESP_OK;
+}
+
+typedef struct {
+    int channel;
+    uint32_t from_s;
+    uint32_t to_s;
+    sensor_history_point_cb_t cb;
+    void *ctx;
+} query_ctx_t;
+
+static bool query_visit(const block_head_t *head, const uint8_t *payload, void *ctx)
+{
+    const query_ctx_t *q = ctx;
+    return emit_block(head, payload, q->channel, q->from_s, q->to_s, q->cb, q->ctx);
+}
+
+esp_err_t sensor_history_query(int channel, uint32_t from_s, uint32_t to_s, sensor_history_tier_t tier,
+                               sensor_history_point_cb_t cb, void *ctx)
+{
+    ESP_RETURN_ON_FALSE(s_hist.part, ESP_ERR_INVALID_STATE, SENSOR_HISTORY_TAG, "not initialised");
+    ESP_RETURN_ON_FALSE(cb && channel < (int)s_hist.count && from_s <= to_s, ESP_ERR_INVALID_ARG,
+                        SENSOR_HISTORY_TAG, "bad query");
+    if (tier == SENSOR_HISTORY_TIER_AUTO) {
+        tier = sensor_history_pick_tier(from_s, to_s);
+    }
+    ESP_RETURN_ON_FALSE(tier < SENSOR_HISTORY_TIER_COUNT, ESP_ERR_INVALID_ARG, SENSOR_HISTORY_TAG, "bad tier");
+    query_ctx_t q = {.channel = channel, .from_s = from_s, .to_s = to_s, .cb = cb, .ctx = ctx};
+    return visit_blocks(tier, from_s, to_s, query_visit, &q);
+}
+
+typedef struct {
+    uint8_t *buf;
+    size_t len;
+    size_t cap;
+    bool cut;
+} export_ctx_t;
+
+static bool export_visit(const block_head_t *head, const uint8_t *payload, void *ctx)
+{
+    export_ctx_t *e = ctx;
+    size_t size = BLOCK_HEAD_BYTES + head->len;
+    if (e->len + size > e->cap) {
+        e->cut = true;
+        return false;
+    }
+    memcpy(e->buf + e->len, head, BLOCK_HEAD_BYTES);
+    memcpy(e->buf + e->len + BLOCK_HEAD_BYTES, payload, head->len);
+    e->len += size;
+    return true;
+}
+
+esp_err_t sensor_history_export(uint32_t from_s, uint32_t to_s, sensor_history_tier_t tier, size_t max_len,
+                                uint8_t **out, size_t *out_len)
+{
+    ESP_RETURN_ON_FALSE(s_hist.part, ESP_ERR_INVALID_STATE, SENSOR_HISTORY_TAG, "not initialised");
+    ESP_RETURN_ON_FALSE(out && out_len && from_s <= to_s, ESP_ERR_INVALID_ARG, SENSOR_HISTORY_TAG, "bad export");
+    if (tier == SENSOR_HISTORY_TIER_AUTO) {
+        tier = sensor_history_pick_tier(from_s, to_s);
+    }
+    ESP_RETURN_ON_FALSE(tier < SENSOR_HISTORY_TIER_COUNT, ESP_ERR_INVALID_ARG, SENSOR_HISTORY_TAG, "bad tier");
+
+    size_t head = 4;
+    for (size_t c = 0; c < s_hist.count; ++c) {
+        head += 2 + strlen(s_hist.channels[c].group) + 1 + strlen(s_hist.channels[c].key);
+    }
+    ESP_RETURN_ON_FALSE(max_len > head, ESP_ERR_INVALID_SIZE, SENSOR_HISTORY_TAG, "export limit too small");
+    export_ctx_t e = {.buf = malloc(max_len), .cap = max_len};
+    ESP_RETURN_ON_FALSE(e.buf, ESP_ERR_NO_MEM, SENSOR_HISTORY_TAG, "no memory for export");
+
+    e.buf[e.len++] = SENSOR_HISTORY_EXPORT_VERSION;
+    e.buf[e.len++] = (uint8_t)tier;
+    e.len++;                          // Flags, once known
+    e.buf[e.len++] = (uint8_t)s_hist.count;
+    for (size_t c = 0; c < s_hist.count; ++c) {
+        char name[64];
+        sensor_history_channel_name(c, name, sizeof(name));
+        size_t name_len = strlen(name);
+        e.buf[e.len++] = s_hist.channels[c].decimals;
+        e.buf[e.len++] = (uint8_t)name_len;
+        memcpy(e.buf + e.len, name, name_len);
+        e.len += name_len;
+    }
+    esp_err_t err = visit_blocks(tier, from_s, to_s, export_visit, &e);
+    if (err != ESP_OK) {
+        free(e.buf);
+        return err;
+    }
+    e.buf[2] = e.cut ? 0x01 : 0x00;
+    uint8_t *shrunk = realloc(e.buf, e.len);
+    *out = shrunk ? shrunk : e.buf;
+    *out_len = e.len;
+    return ESP_OK;
+}
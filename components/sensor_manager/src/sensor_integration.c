@@ -1,31 +1,40 @@
 /**
  * @file sensor_integration.c
  * @brief Unified sensor integration - samples all I2C sensors at 1Hz
+ *
+ * One task owns the bus and runs an i2c_scheduler sweep per period, so the
+ * SHT45 and SGP40 conversions overlap. The SGP40 signal goes through the gas
+ * index algorithm, whose learned baseline is kept in NVS. Readers get
+ * seqlock snapshots of the last sweep and never wait on I2C.
+ *
+ * With its INT pin wired, the VCNL4040 wakes the task as soon as proximity
+ * or light crosses a threshold, and is otherwise only read now and then.
  */
 
 #include "sensor_integration.h"
 
+#include <inttypes.h>
 #include <string.h>
 #include <math.h>
 #include "esp_log.h"
 #include "esp_err.h"
 #include "esp_check.h"
-#include "driver/i2c.h"
-// Compatibility layer for v5.0 API
-#define i2c_master_bus_handle_t i2c_port_t
-#define i2c_master_dev_handle_t i2c_cmd_handle_t
 #include "driver/gpio.h"
-#include "driver/uart.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "nvs.h"
 #include "cJSON.h"
 
-// Sensor drivers - TODO: Re-enable when component discovery is fixed
-// #include "sht45.h"
-// #include "sgp40.h"
-// #include "scd40.h"
-// #include "vcnl4040.h"
-// #include "ec10.h"
+#include "i2c_scheduler.h"
+#include "sht45.h"
+#include "sgp40.h"
+#include "sgp40_voc_index.h"
+#include "scd40.h"
+#include "vcnl4040.h"
+#include "ec10.h"
+#include "sps30.h"
+#include "bmp581.h"
+#include "opt3002.h"
 
 // Sensor manager
 #include "sensor_manager.h"
@@ -38,43 +47,152 @@ static const char *TAG = "sensor_integration";
 #define I2C_MASTER_SDA_IO           44    // GPIO number for I2C master data (RXD/UART0_RX)
 #define I2C_MASTER_NUM              0     // I2C master i2c port number
 #define I2C_MASTER_FREQ_HZ          100000 // I2C master clock frequency
-#define I2C_MASTER_TIMEOUT_MS       1000
 
 // Sensor sampling rate: 1Hz = 1000ms
 #define SENSOR_SAMPLE_INTERVAL_MS   1000
+#ifndef CONFIG_SENSOR_MANAGER_TASK_CORE
+#define CONFIG_SENSOR_MANAGER_TASK_CORE 0
+#endif
 
-// Sensor handles - TODO: Re-enable when sensor driver components are available
-static i2c_master_bus_handle_t s_i2c_bus = I2C_NUM_MAX; // Use invalid port instead of NULL
-// static sht45_handle_t s_sht45;
-// static sgp40_t s_sgp40;
-// static scd40_t s_scd40;
-// static vcnl4040_t s_vcnl4040;
-// static ec10_t s_ec10;
+#ifndef CONFIG_SENSOR_INTEGRATION_EC10
+#define CONFIG_SENSOR_INTEGRATION_EC10 0
+#endif
+#ifndef CONFIG_SENSOR_INTEGRATION_EC10_UART_NUM
+#define CONFIG_SENSOR_INTEGRATION_EC10_UART_NUM 1
+#endif
+#ifndef CONFIG_SENSOR_INTEGRATION_EC10_TX_GPIO
+#define CONFIG_SENSOR_INTEGRATION_EC10_TX_GPIO 17
+#endif
+#ifndef CONFIG_SENSOR_INTEGRATION_EC10_RX_GPIO
+#define CONFIG_SENSOR_INTEGRATION_EC10_RX_GPIO 18
+#endif
+#ifndef CONFIG_SENSOR_INTEGRATION_SPS30_UINT16
+#define CONFIG_SENSOR_INTEGRATION_SPS30_UINT16 0
+#endif
+#ifndef CONFIG_SENSOR_INTEGRATION_SPS30_CLEAN_DAYS
+#define CONFIG_SENSOR_INTEGRATION_SPS30_CLEAN_DAYS 7
+#endif
+#ifndef CONFIG_SENSOR_INTEGRATION_VCNL4040_INT_GPIO
+#define CONFIG_SENSOR_INTEGRATION_VCNL4040_INT_GPIO -1
+#endif
+#define VCNL4040_INT_GPIO           ((gpio_num_t)CONFIG_SENSOR_INTEGRATION_VCNL4040_INT_GPIO)
+#ifndef CONFIG_SENSOR_INTEGRATION_BMP581_INT_GPIO
+#define CONFIG_SENSOR_INTEGRATION_BMP581_INT_GPIO -1
+#endif
+#define BMP581_INT_GPIO             ((gpio_num_t)CONFIG_SENSOR_INTEGRATION_BMP581_INT_GPIO)
+#ifndef CONFIG_SENSOR_INTEGRATION_OPT3002_INT_GPIO
+#define CONFIG_SENSOR_INTEGRATION_OPT3002_INT_GPIO -1
+#endif
+#define OPT3002_INT_GPIO            ((gpio_num_t)CONFIG_SENSOR_INTEGRATION_OPT3002_INT_GPIO)
+#ifndef CONFIG_SENSOR_INTEGRATION_OPT3002_NW_PER_LUX
+#define CONFIG_SENSOR_INTEGRATION_OPT3002_NW_PER_LUX 400
+#endif
+
+// Interrupt sources waking the sampling task, as task notification bits
+#define SAMPLING_NOTIFY_VCNL4040    (1 << 0)
+#define SAMPLING_NOTIFY_BMP581      (1 << 1)
+#define SAMPLING_NOTIFY_OPT3002     (1 << 2)
+
+// With INT wired, changes arrive as interrupts and the VCNL4040 is only read
+// this often to keep its published readings fresh
+#define VCNL4040_IRQ_POLL_MS        30000
+// Proximity hysteresis in raw counts: close above the first, away below the second
+#define VCNL4040_PS_CLOSE_COUNTS    200
+#define VCNL4040_PS_AWAY_COUNTS     100
+// ALS window re-armed around each reading: a quarter of it either side,
+// and never under 20 counts (1 lux)
+#define VCNL4040_ALS_WINDOW_SHIFT   2
+#define VCNL4040_ALS_WINDOW_MIN     20
+// OPT3002 on ADDR=VDD; 0x44 is the SHT45. Same window rule as the VCNL4040,
+// at least 10 LSB (12 nW/cm²) either side, and the same slow poll with INT
+#define OPT3002_ADDR                OPT3002_ADDR_VDD
+#define OPT3002_WINDOW_SHIFT        2
+#define OPT3002_WINDOW_MIN_NW_CM2   12.0f
+#define OPT3002_IRQ_POLL_MS         30000
+// Learned VOC baseline. It moves on a 12 h time constant, and each write
+// stalls flash access for a moment, so hourly saves are plenty
+#define VOC_STATE_NVS_NAMESPACE     "sgp40_voc"
+#define VOC_STATE_NVS_KEY           "state"
+#define VOC_STATE_SAVE_INTERVAL_S   3600
+// The EC10 streams a frame about every second; older than this means it went quiet
+#define EC10_STALE_MS               5000
+// The SPS30 flags a reading every second; a sweep that finds none keeps the
+// last one until it is older than this
+#define SPS30_STALE_MS              3000
+// BMP581 pressure: polled, 10 Hz fits the 16-frame FIFO between 1 s sweeps.
+// With INT wired it runs at 25 Hz and the FIFO threshold wakes the task to
+// drain 12 frames (~0.5 s) at a time
+#define BMP581_POLL_ODR             BMP581_ODR_10_HZ
+#define BMP581_IRQ_ODR              BMP581_ODR_25_HZ
+#define BMP581_IRQ_FIFO_THRESHOLD   12
+
+// Sensor handles, owned by the sampling task once it runs
+static i2c_scheduler_t *s_sched = NULL;
+static sht45_handle_t s_sht45;
+static sgp40_t s_sgp40;
+static scd40_t s_scd40;
+static vcnl4040_t s_vcnl4040;
+static ec10_t s_ec10;
+static sps30_t s_sps30;
+static bmp581_t s_bmp581;
+static opt3002_t s_opt3002;
+static i2c_scheduler_dev_t *s_sht45_job = NULL;
+static i2c_scheduler_dev_t *s_sgp40_job = NULL;
+static i2c_scheduler_dev_t *s_scd40_job = NULL;
+static i2c_scheduler_dev_t *s_vcnl4040_job = NULL;
+static i2c_scheduler_dev_t *s_sps30_job = NULL;
+static uint32_t s_sps30_last_ok_ms = 0;
+static uint32_t s_sps30_started_ms = 0;
+static i2c_scheduler_dev_t *s_bmp581_job = NULL;
+static bool s_bmp581_irq = false;
+// With an OPT3002 on the bus it is the light source for readings and
+// events; the VCNL4040 is left to proximity
+static i2c_scheduler_dev_t *s_opt3002_job = NULL;
+static bool s_opt3002_irq = false;
+static bool s_light_window_valid = false;
+static bool s_light_window_unwritten = false;
+static float s_light_window_low = 0.0f;
+static float s_light_window_high = 0.0f;
+// BMP581 frames drained since the last sweep published them
+static struct {
+    float pressure_sum;
+    float pressure_min;
+    float pressure_max;
+    float temperature_c;
+    uint32_t frames;
+} s_baro;
+static uint32_t s_ec10_last_ok_ms = 0;
+// VCNL4040 interrupt mode and the thresholds last armed
+static bool s_vcnl4040_irq = false;
+static bool s_vcnl4040_near = false;
+static bool s_als_window_valid = false;
+static bool s_als_window_unwritten = false;
+static uint16_t s_als_window_low = 0;
+static uint16_t s_als_window_high = 0;
+// Events found by the last VCNL4040 or OPT3002 read, dispatched once it is published
+#define SENSOR_EVENT_PROXIMITY    (1 << 0)
+#define SENSOR_EVENT_LIGHT        (1 << 1)
+static uint8_t s_sensor_events = 0;
+static sensor_integration_event_cb_t s_event_cb = NULL;
+static void *s_event_ctx = NULL;
+static sgp40_voc_index_t s_voc_index;
+static uint32_t s_voc_samples_since_save = 0;
 
 static bool s_initialized = false;
 static bool s_running = false;
 static TaskHandle_t s_task_handle = NULL;
 
-// Sensor data cache
-typedef struct {
-    float temperature_c;
-    float humidity_rh;
-    uint16_t voc_index;
-    float co2_ppm;
-    float temperature_co2_c;
-    float humidity_co2_rh;
-    uint16_t ambient_lux;
-    uint16_t proximity;
-    float ec_ms_per_cm;
-    bool sht45_available;
-    bool sgp40_available;
-    bool scd40_available;
-    bool vcnl4040_available;
-    bool ec10_available;
-    uint32_t last_update_ms;
-} sensor_data_cache_t;
-
-static sensor_data_cache_t s_sensor_cache = {0};
+// Readings being assembled by the current sweep; only the sampling task
+// touches it, and it is published to the cache below once per period
+static sensor_integration_data_t s_staging = {0};
+
+// Published readings. Two slots and a sequence counter: the sampling task
+// fills the slot readers are not pointed at, then bumps the sequence; a
+// reader copies the current slot and retries if the sequence moved under it.
+// Readers never wait on the sampling task or on I2C, and one that preempts a
+// publish still finds a complete slot.
+static sensor_integration_data_t s_cache[2] = {0};
+static uint32_t s_cache_seq = 0;
 
 static void sensor_sampling_task(void *arg);
 static bool sample_sht45_cb(cJSON *sensor_root);
@@ -82,6 +200,690 @@ static bool sample_sgp40_cb(cJSON *sensor_root);
 static bool sample_scd40_cb(cJSON *sensor_root);
 static bool sample_vcnl4040_cb(cJSON *sensor_root);
 static bool sample_ec10_cb(cJSON *sensor_root);
+static bool sample_sps30_cb(cJSON *sensor_root);
+static bool sample_bmp581_cb(cJSON *sensor_root);
+static bool sample_opt3002_cb(cJSON *sensor_root);
+static bool encode_sht45_cb(telemetry_cbor_t *sensor_map);
+static bool encode_sgp40_cb(telemetry_cbor_t *sensor_map);
+static bool encode_scd40_cb(telemetry_cbor_t *sensor_map);
+static bool encode_vcnl4040_cb(telemetry_cbor_t *sensor_map);
+static bool encode_ec10_cb(telemetry_cbor_t *sensor_map);
+static bool encode_sps30_cb(telemetry_cbor_t *sensor_map);
+static bool encode_bmp581_cb(telemetry_cbor_t *sensor_map);
+static bool encode_opt3002_cb(telemetry_cbor_t *sensor_map);
+static bool read_sht45_cb(float *values);
+static bool read_sgp40_cb(float *values);
+static bool read_scd40_cb(float *values);
+static bool read_vcnl4040_cb(float *values);
+static bool read_ec10_cb(float *values);
+static bool read_sps30_cb(float *values);
+static bool read_bmp581_cb(float *values);
+static bool read_opt3002_cb(float *values);
+
+// Batched channels, in the order the read callbacks fill them. Deadbands sit
+// just above each sensor's noise, so a still room is mostly heartbeats.
+static const sensor_manager_channel_t SHT45_CHANNELS[] = {
+    {"temperature_c", 2, 0.1f, 0},
+    {"humidity_rh", 1, 1.0f, 0},
+};
+static const sensor_manager_channel_t SGP40_CHANNELS[] = {
+    {"voc_index", 0, 5.0f, 0},
+};
+static const sensor_manager_channel_t SCD40_CHANNELS[] = {
+    {"co2_ppm", 0, 25.0f, 0},
+    {"temperature_c", 2, 0.1f, 0},
+    {"humidity_rh", 1, 1.0f, 0},
+};
+static const sensor_manager_channel_t VCNL4040_CHANNELS[] = {
+    {"ambient_lux", 0, 5.0f, 0},
+    // Presence is event-like; report every change
+    {"proximity", 0, 0.0f, 0},
+};
+static const sensor_manager_channel_t EC10_CHANNELS[] = {
+    {"pm1_0_ug_m3", 0, 2.0f, 0},
+    {"pm2_5_ug_m3", 0, 2.0f, 0},
+    {"pm10_ug_m3", 0, 3.0f, 0},
+};
+static const sensor_manager_channel_t SPS30_CHANNELS[] = {
+    {"pm1_0_ug_m3", 1, 1.0f, 0},
+    {"pm2_5_ug_m3", 1, 1.0f, 0},
+    {"pm4_0_ug_m3", 1, 1.5f, 0},
+    {"pm10_ug_m3", 1, 2.0f, 0},
+    {"particle_size_um", 2, 0.05f, 0},
+};
+static const sensor_manager_channel_t BMP581_CHANNELS[] = {
+    {"pressure_hpa", 2, 0.05f, 0},
+    {"temperature_c", 2, 0.1f, 0},
+    // Spread within one sweep; a door or a window moving shows up as a jump
+    {"pressure_span_pa", 1, 2.0f, 0},
+};
+static const sensor_manager_channel_t OPT3002_CHANNELS[] = {
+    {"ambient_lux", 0, 5.0f, 0},
+    {"irradiance_nw_cm2", 0, 50.0f, 0},
+};
+#define CHANNELS(table) .channels = (table), .channel_count = sizeof(table) / sizeof((table)[0])
+
+// Ticks the SGP40 expects for its compensation arguments
+static uint16_t sgp40_humidity_ticks(float humidity_rh)
+{
+    return (uint16_t)(fminf(fmaxf(humidity_rh, 0.0f), 100.0f) * 65535.0f / 100.0f);
+}
+
+static uint16_t sgp40_temperature_ticks(float temperature_c)
+{
+    return (uint16_t)((fminf(fmaxf(temperature_c, -45.0f), 130.0f) + 45.0f) * 65535.0f / 175.0f);
+}
+
+// Scheduler steps; they run on the sampling task and fill s_staging
+static esp_err_t sht45_start_step(i2c_scheduler_dev_t *dev, void *ctx)
+{
+    (void)dev;
+    return sht45_start_measurement(ctx) ? ESP_OK : ESP_FAIL;
+}
+
+static esp_err_t sht45_collect_step(i2c_scheduler_dev_t *dev, void *ctx)
+{
+    (void)dev;
+    sht45_data_t data;
+    if (!sht45_read_measurement(ctx, &data)) {
+        return ESP_FAIL;
+    }
+    s_staging.temperature_c = data.temperature_c;
+    s_staging.humidity_rh = data.humidity_rh;
+    return ESP_OK;
+}
+
+static esp_err_t sgp40_start_step(i2c_scheduler_dev_t *dev, void *ctx)
+{
+    (void)dev;
+    // Compensate with the SHT45 reading of the previous sweep, or with the
+    // datasheet defaults of 50 %RH and 25 °C without one
+    uint16_t humidity_ticks = 0x8000;
+    uint16_t temperature_ticks = 0x6666;
+    if (s_staging.sht45_available) {
+        humidity_ticks = sgp40_humidity_ticks(s_staging.humidity_rh);
+        temperature_ticks = sgp40_temperature_ticks(s_staging.temperature_c);
+    }
+    return sgp40_start_measure_raw(ctx, humidity_ticks, temperature_ticks);
+}
+
+static void voc_state_load(void)
+{
+    nvs_handle_t nvs;
+    if (nvs_open(VOC_STATE_NVS_NAMESPACE, NVS_READONLY, &nvs) != ESP_OK) {
+        return;
+    }
+    sgp40_voc_index_state_t state;
+    size_t len = sizeof(state);
+    esp_err_t err = nvs_get_blob(nvs, VOC_STATE_NVS_KEY, &state, &len);
+    nvs_close(nvs);
+    if (err == ESP_OK && len == sizeof(state)) {
+        sgp40_voc_index_set_state(&s_voc_index, &state);
+        ESP_LOGI(TAG, "VOC baseline restored");
+    }
+}
+
+static void voc_state_save(void)
+{
+    sgp40_voc_index_state_t state;
+    if (!sgp40_voc_index_get_state(&s_voc_index, &state)) {
+        return;
+    }
+    nvs_handle_t nvs;
+    esp_err_t err = nvs_open(VOC_STATE_NVS_NAMESPACE, NVS_READWRITE, &nvs);
+    if (err == ESP_OK) {
+        err = nvs_set_blob(nvs, VOC_STATE_NVS_KEY, &state, sizeof(state));
+        if (err == ESP_OK) {
+            err = nvs_commit(nvs);
+        }
+        nvs_close(nvs);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "VOC baseline not persisted: %s", esp_err_to_name(err));
+    }
+}
+
+static esp_err_t sgp40_collect_step(i2c_scheduler_dev_t *dev, void *ctx)
+{
+    (void)dev;
+    sgp40_raw_data_t data;
+    ESP_RETURN_ON_ERROR(sgp40_read_raw(ctx, &data), TAG, "sgp40 read");
+    s_staging.voc_ticks = data.voc_ticks;
+    // The sweep runs once per second, the cadence the algorithm is tuned for
+    s_staging.voc_index = (uint16_t)sgp40_voc_index_process(&s_voc_index, data.voc_ticks);
+    if (++s_voc_samples_since_save >= VOC_STATE_SAVE_INTERVAL_S) {
+        s_voc_samples_since_save = 0;
+        voc_state_save();
+    }
+    return ESP_OK;
+}
+
+static esp_err_t scd40_collect_step(i2c_scheduler_dev_t *dev, void *ctx)
+{
+    (void)dev;
+    scd40_measurement_t data;
+    ESP_RETURN_ON_ERROR(scd40_read_measurement(ctx, &data), TAG, "scd40 read");
+    s_staging.co2_ppm = data.co2_ppm;
+    s_staging.temperature_co2_c = data.temperature_c;
+    s_staging.humidity_co2_rh = data.humidity_rh;
+    return ESP_OK;
+}
+
+// Continuous mode: a poll reads the data-ready flag and, when it is set,
+// every value in one batched read
+static esp_err_t sps30_collect_step(i2c_scheduler_dev_t *dev, void *ctx)
+{
+    (void)dev;
+    sps30_measurement_t data;
+    bool fresh = false;
+    ESP_RETURN_ON_ERROR(sps30_poll(ctx, &data, &fresh), TAG, "sps30 read");
+    uint32_t now_ms = esp_log_timestamp();
+    // Readings while the fan spins up are off; drop them
+    if (fresh && now_ms - s_sps30_started_ms < SPS30_STARTUP_MS) {
+        return ESP_ERR_NOT_FINISHED;
+    }
+    if (!fresh) {
+        return s_sps30_last_ok_ms == 0 || now_ms - s_sps30_last_ok_ms > SPS30_STALE_MS ? ESP_ERR_TIMEOUT : ESP_OK;
+    }
+    s_sps30_last_ok_ms = now_ms;
+    s_staging.sps30_pm1_0_ug_m3 = data.mc_pm1_0;
+    s_staging.sps30_pm2_5_ug_m3 = data.mc_pm2_5;
+    s_staging.sps30_pm4_0_ug_m3 = data.mc_pm4_0;
+    s_staging.sps30_pm10_ug_m3 = data.mc_pm10;
+    s_staging.sps30_particle_size_um = data.typical_particle_size_um;
+    return ESP_OK;
+}
+
+// One burst per call however many frames are queued; runs from the sweep and
+// whenever the FIFO threshold interrupt fires
+static esp_err_t bmp581_drain(void)
+{
+    bmp581_sample_t samples[BMP581_FIFO_CAPACITY];
+    size_t count = 0;
+    if (s_bmp581_irq) {
+        // Releases the latched INT, also if an earlier one went unserviced
+        uint8_t status = 0;
+        ESP_RETURN_ON_ERROR(bmp581_read_int_status(&s_bmp581, &status), TAG, "bmp581 int status");
+    }
+    ESP_RETURN_ON_ERROR(bmp581_read_fifo(&s_bmp581, samples, BMP581_FIFO_CAPACITY, &count), TAG, "bmp581 fifo");
+    for (size_t i = 0; i < count; ++i) {
+        float p = samples[i].pressure_pa;
+        if (s_baro.frames == 0) {
+            s_baro.pressure_min = p;
+            s_baro.pressure_max = p;
+        }
+        s_baro.pressure_sum += p;
+        s_baro.pressure_min = fminf(s_baro.pressure_min, p);
+        s_baro.pressure_max = fmaxf(s_baro.pressure_max, p);
+        s_baro.temperature_c = samples[i].temperature_c;
+        s_baro.frames++;
+    }
+    return ESP_OK;
+}
+
+static esp_err_t bmp581_collect_step(i2c_scheduler_dev_t *dev, void *ctx)
+{
+    (void)dev;
+    (void)ctx;
+    ESP_RETURN_ON_ERROR(bmp581_drain(), TAG, "bmp581 read");
+    if (s_baro.frames == 0) {
+        return ESP_ERR_NOT_FINISHED;
+    }
+    s_staging.pressure_hpa = s_baro.pressure_sum / s_baro.frames / 100.0f;
+    s_staging.pressure_span_pa = s_baro.pressure_max - s_baro.pressure_min;
+    s_staging.temperature_baro_c = s_baro.temperature_c;
+    memset(&s_baro, 0, sizeof(s_baro));
+    return ESP_OK;
+}
+
+// Centre the ALS window on the reading; in interrupt mode the sensor gets it too
+static void vcnl4040_center_als_window(uint16_t als_raw)
+{
+    uint32_t margin = als_raw >> VCNL4040_ALS_WINDOW_SHIFT;
+    if (margin < VCNL4040_ALS_WINDOW_MIN) {
+        margin = VCNL4040_ALS_WINDOW_MIN;
+    }
+    s_als_window_low = als_raw > margin ? (uint16_t)(als_raw - margin) : 0;
+    s_als_window_high = als_raw + margin < UINT16_MAX ? (uint16_t)(als_raw + margin) : UINT16_MAX;
+    s_als_window_valid = true;
+    s_als_window_unwritten = s_vcnl4040_irq;
+}
+
+// Runs from the sweep, and straight away when INT fires
+static esp_err_t vcnl4040_collect_step(i2c_scheduler_dev_t *dev, void *ctx)
+{
+    (void)dev;
+    vcnl4040_t *vcnl = ctx;
+    if (s_vcnl4040_irq) {
+        // Also releases INT if an earlier interrupt went unserviced
+        uint8_t flags = 0;
+        ESP_RETURN_ON_ERROR(vcnl4040_read_int_flags(vcnl, &flags), TAG, "vcnl4040 flags read");
+        ESP_LOGD(TAG, "VCNL4040 INT flags 0x%02X", flags);
+    }
+    uint16_t als_raw = 0;
+    uint16_t proximity = 0;
+    ESP_RETURN_ON_ERROR(vcnl4040_read_ambient_lux(vcnl, &als_raw), TAG, "vcnl4040 als read");
+    ESP_RETURN_ON_ERROR(vcnl4040_read_proximity(vcnl, &proximity), TAG, "vcnl4040 ps read");
+    s_staging.ambient_lux = (uint16_t)(als_raw * VCNL4040_LUX_PER_COUNT);
+    s_staging.proximity = proximity;
+
+    // Same decisions the sensor's thresholds make, so polling and interrupt
+    // mode report the same events
+    bool near = s_vcnl4040_near ? proximity >= VCNL4040_PS_AWAY_COUNTS : proximity > VCNL4040_PS_CLOSE_COUNTS;
+    if (near != s_vcnl4040_near) {
+        s_vcnl4040_near = near;
+        s_sensor_events |= SENSOR_EVENT_PROXIMITY;
+    }
+    if (s_opt3002_job) {
+        return ESP_OK;
+    }
+    // The first reading counts as a change, so consumers start from a level
+    if (!s_als_window_valid || als_raw < s_als_window_low || als_raw > s_als_window_high) {
+        s_sensor_events |= SENSOR_EVENT_LIGHT;
+        vcnl4040_center_als_window(als_raw);
+    }
+    if (s_als_window_unwritten) {
+        // A failed write is retried on the next read
+        s_als_window_unwritten =
+            vcnl4040_set_als_thresholds(vcnl, s_als_window_low, s_als_window_high) != ESP_OK;
+    }
+    return ESP_OK;
+}
+
+static void opt3002_center_window(float nw_cm2)
+{
+    float margin = fmaxf(nw_cm2 / (1 << OPT3002_WINDOW_SHIFT), OPT3002_WINDOW_MIN_NW_CM2);
+    s_light_window_low = fmaxf(nw_cm2 - margin, 0.0f);
+    s_light_window_high = nw_cm2 + margin;
+    s_light_window_valid = true;
+    s_light_window_unwritten = s_opt3002_irq;
+}
+
+// Runs from the sweep, and straight away when INT fires
+static esp_err_t opt3002_collect_step(i2c_scheduler_dev_t *dev, void *ctx)
+{
+    (void)dev;
+    opt3002_t *opt = ctx;
+    if (s_opt3002_irq) {
+        // Reading the flags releases the latched INT
+        uint8_t flags = 0;
+        ESP_RETURN_ON_ERROR(opt3002_read_flags(opt, &flags), TAG, "opt3002 flags read");
+        ESP_LOGD(TAG, "OPT3002 flags 0x%02X", flags);
+    }
+    float nw_cm2 = 0.0f;
+    ESP_RETURN_ON_ERROR(opt3002_read_power(opt, &nw_cm2), TAG, "opt3002 read");
+    float lux = nw_cm2 / CONFIG_SENSOR_INTEGRATION_OPT3002_NW_PER_LUX;
+    s_staging.irradiance_nw_cm2 = nw_cm2;
+    s_staging.opt3002_lux = lux < UINT16_MAX ? (uint16_t)lux : UINT16_MAX;
+
+    // Same test the sensor's window comparator makes
+    if (!s_light_window_valid || nw_cm2 < s_light_window_low || nw_cm2 > s_light_window_high) {
+        s_sensor_events |= SENSOR_EVENT_LIGHT;
+        opt3002_center_window(nw_cm2);
+    }
+    if (s_light_window_unwritten) {
+        // A failed write is retried on the next read
+        s_light_window_unwritten = opt3002_set_window(opt, s_light_window_low, s_light_window_high) != ESP_OK;
+    }
+    return ESP_OK;
+}
+
+// INT is level-triggered so it can wake the chip from light sleep; the pin
+// stays masked until the task has read the flags and released it
+static void IRAM_ATTR vcnl4040_int_isr(void *arg)
+{
+    BaseType_t woken = pdFALSE;
+    gpio_intr_disable(VCNL4040_INT_GPIO);
+    xTaskNotifyFromISR((TaskHandle_t)arg, SAMPLING_NOTIFY_VCNL4040, eSetBits, &woken);
+    portYIELD_FROM_ISR(woken);
+}
+
+// Latched, open drain and active low like the VCNL4040's
+static void IRAM_ATTR opt3002_int_isr(void *arg)
+{
+    BaseType_t woken = pdFALSE;
+    gpio_intr_disable(OPT3002_INT_GPIO);
+    xTaskNotifyFromISR((TaskHandle_t)arg, SAMPLING_NOTIFY_OPT3002, eSetBits, &woken);
+    portYIELD_FROM_ISR(woken);
+}
+
+// Latched and active high; masked the same way until the task reads the status
+static void IRAM_ATTR bmp581_int_isr(void *arg)
+{
+    BaseType_t woken = pdFALSE;
+    gpio_intr_disable(BMP581_INT_GPIO);
+    xTaskNotifyFromISR((TaskHandle_t)arg, SAMPLING_NOTIFY_BMP581, eSetBits, &woken);
+    portYIELD_FROM_ISR(woken);
+}
+
+// Thresholds first, then the interrupts, then the pin; polling stays on any failure
+static void vcnl4040_setup_interrupt(void)
+{
+#if CONFIG_SENSOR_INTEGRATION_VCNL4040_INT_GPIO >= 0
+    gpio_config_t io_conf = {
+        .pin_bit_mask = 1ULL << VCNL4040_INT_GPIO,
+        .mode = GPIO_MODE_INPUT,
+        .pull_up_en = GPIO_PULLUP_ENABLE,  // INT is open drain, active low
+        .pull_down_en = GPIO_PULLDOWN_DISABLE,
+        .intr_type = GPIO_INTR_LOW_LEVEL,
+    };
+    esp_err_t err = vcnl4040_set_als_thresholds(&s_vcnl4040, 0, UINT16_MAX);
+    if (err == ESP_OK) {
+        err = vcnl4040_set_ps_thresholds(&s_vcnl4040, VCNL4040_PS_AWAY_COUNTS, VCNL4040_PS_CLOSE_COUNTS);
+    }
+    if (err == ESP_OK) {
+        // Light changes come from the OPT3002 when there is one
+        err = vcnl4040_enable_interrupts(&s_vcnl4040, s_opt3002_job == NULL, true);
+    }
+    if (err == ESP_OK) {
+        err = gpio_config(&io_conf);
+    }
+    if (err == ESP_OK) {
+        // Masked until the sampling task has its handler in place
+        gpio_intr_disable(VCNL4040_INT_GPIO);
+        err = gpio_wakeup_enable(VCNL4040_INT_GPIO, GPIO_INTR_LOW_LEVEL);
+    }
+    if (err == ESP_OK) {
+        // Already installed by another service is fine
+        err = gpio_install_isr_service(0);
+        if (err == ESP_ERR_INVALID_STATE) {
+            err = ESP_OK;
+        }
+    }
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "VCNL4040 interrupt unavailable, polling instead: %s", esp_err_to_name(err));
+        vcnl4040_enable_interrupts(&s_vcnl4040, false, false);
+        return;
+    }
+    s_vcnl4040_irq = true;
+#endif
+}
+
+// Pin first, then the window is armed on the first read; polling stays on any failure
+static bool opt3002_setup_interrupt(void)
+{
+#if CONFIG_SENSOR_INTEGRATION_OPT3002_INT_GPIO >= 0
+    gpio_config_t io_conf = {
+        .pin_bit_mask = 1ULL << OPT3002_INT_GPIO,
+        .mode = GPIO_MODE_INPUT,
+        .pull_up_en = GPIO_PULLUP_ENABLE,  // INT is open drain, active low
+        .pull_down_en = GPIO_PULLDOWN_DISABLE,
+        .intr_type = GPIO_INTR_LOW_LEVEL,
+    };
+    esp_err_t err = gpio_config(&io_conf);
+    if (err == ESP_OK) {
+        // Masked until the sampling task has its handler in place
+        gpio_intr_disable(OPT3002_INT_GPIO);
+        err = gpio_wakeup_enable(OPT3002_INT_GPIO, GPIO_INTR_LOW_LEVEL);
+    }
+    if (err == ESP_OK) {
+        err = gpio_install_isr_service(0);
+        if (err == ESP_ERR_INVALID_STATE) {
+            err = ESP_OK;
+        }
+    }
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "OPT3002 interrupt unavailable, polling instead: %s", esp_err_to_name(err));
+        return false;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+// Pin first, then the FIFO threshold interrupt; polling stays on any failure
+static bool bmp581_setup_interrupt(void)
+{
+#if CONFIG_SENSOR_INTEGRATION_BMP581_INT_GPIO >= 0
+    gpio_config_t io_conf = {
+        .pin_bit_mask = 1ULL << BMP581_INT_GPIO,
+        .mode = GPIO_MODE_INPUT,
+        .pull_up_en = GPIO_PULLUP_DISABLE,
+        .pull_down_en = GPIO_PULLDOWN_ENABLE,  // INT is push-pull, active high
+        .intr_type = GPIO_INTR_HIGH_LEVEL,
+    };
+    esp_err_t err = gpio_config(&io_conf);
+    if (err == ESP_OK) {
+        // Masked until the sampling task has its handler in place
+        gpio_intr_disable(BMP581_INT_GPIO);
+        // A full FIFO drops frames, so the threshold has to wake light sleep too
+        err = gpio_wakeup_enable(BMP581_INT_GPIO, GPIO_INTR_HIGH_LEVEL);
+    }
+    if (err == ESP_OK) {
+        err = gpio_install_isr_service(0);
+        if (err == ESP_ERR_INVALID_STATE) {
+            err = ESP_OK;
+        }
+    }
+    if (err == ESP_OK) {
+        err = bmp581_enable_interrupt(&s_bmp581, BMP581_INT_FIFO_THRESHOLD);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "BMP581 interrupt unavailable, polling instead: %s", esp_err_to_name(err));
+        bmp581_enable_interrupt(&s_bmp581, 0);
+        return false;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+// Add a device for a driver that expects its handle attached before init
+static esp_err_t attach_device(uint16_t address, i2c_master_dev_handle_t *ret_dev)
+{
+    i2c_device_config_t dev_config = {
+        .dev_addr_length = I2C_ADDR_BIT_LEN_7,
+        .device_address = address,
+        .scl_speed_hz = I2C_MASTER_FREQ_HZ,
+    };
+    return i2c_master_bus_add_device(i2c_scheduler_bus(s_sched), &dev_config, ret_dev);
+}
+
+static void detach_device(i2c_master_dev_handle_t *dev)
+{
+    if (*dev) {
+        i2c_master_bus_rm_device(*dev);
+        *dev = NULL;
+    }
+}
+
+// Probe, initialise and schedule each I2C sensor; a missing one is skipped
+static void sensor_integration_add_i2c_sensors(void)
+{
+    i2c_scheduler_job_t job;
+
+    if (i2c_scheduler_probe(s_sched, 0x44) == ESP_OK && sht45_init(&s_sht45, i2c_scheduler_bus(s_sched), 0x44)) {
+        job = (i2c_scheduler_job_t){
+            .name = "sht45",
+            .address = 0x44,
+            .device = s_sht45.i2c_dev,
+            .conversion_ms = SHT45_MEASURE_DELAY_MS,
+            .start = sht45_start_step,
+            .collect = sht45_collect_step,
+            .ctx = &s_sht45,
+        };
+        if (i2c_scheduler_add_job(s_sched, &job, &s_sht45_job) != ESP_OK) {
+            sht45_deinit(&s_sht45);
+        }
+    }
+
+    sgp40_config_t sgp40_cfg = {
+        .i2c_port = I2C_MASTER_NUM,
+        .sda_io_num = I2C_MASTER_SDA_IO,
+        .scl_io_num = I2C_MASTER_SCL_IO,
+        .i2c_clk_speed_hz = I2C_MASTER_FREQ_HZ,
+    };
+    if (i2c_scheduler_probe(s_sched, SGP40_DEFAULT_ADDR) == ESP_OK &&
+        attach_device(SGP40_DEFAULT_ADDR, &s_sgp40.i2c_dev) == ESP_OK) {
+        job = (i2c_scheduler_job_t){
+            .name = "sgp40",
+            .address = SGP40_DEFAULT_ADDR,
+            .device = s_sgp40.i2c_dev,
+            .conversion_ms = SGP40_MEASURE_RAW_DELAY_MS,
+            .start = sgp40_start_step,
+            .collect = sgp40_collect_step,
+            .ctx = &s_sgp40,
+        };
+        if (sgp40_init(&s_sgp40, &sgp40_cfg) != ESP_OK ||
+            i2c_scheduler_add_job(s_sched, &job, &s_sgp40_job) != ESP_OK) {
+            detach_device(&s_sgp40.i2c_dev);
+            s_sgp40.initialized = false;
+        } else {
+            sgp40_voc_index_init(&s_voc_index);
+            voc_state_load();
+        }
+    }
+
+    scd40_config_t scd40_cfg = {
+        .i2c_port = I2C_MASTER_NUM,
+        .sda_io_num = I2C_MASTER_SDA_IO,
+        .scl_io_num = I2C_MASTER_SCL_IO,
+        .i2c_clk_speed_hz = I2C_MASTER_FREQ_HZ,
+        .rst_io_num = GPIO_NUM_NC,
+    };
+    if (i2c_scheduler_probe(s_sched, SCD40_DEFAULT_ADDR) == ESP_OK &&
+        attach_device(SCD40_DEFAULT_ADDR, &s_scd40.i2c_dev) == ESP_OK) {
+        // Periodic mode: the sensor converts on its own, so there is only a
+        // collect step, run once per measurement interval
+        job = (i2c_scheduler_job_t){
+            .name = "scd40",
+            .address = SCD40_DEFAULT_ADDR,
+            .device = s_scd40.i2c_dev,
+            .period_ms = SCD40_MEASUREMENT_DELAY_MS,
+            .collect = scd40_collect_step,
+            .ctx = &s_scd40,
+        };
+        if (scd40_init(&s_scd40, &scd40_cfg) != ESP_OK ||
+            scd40_start_periodic_measurement(&s_scd40) != ESP_OK ||
+            i2c_scheduler_add_job(s_sched, &job, &s_scd40_job) != ESP_OK) {
+            detach_device(&s_scd40.i2c_dev);
+            s_scd40.initialized = false;
+        }
+    }
+
+    opt3002_config_t opt3002_cfg = {
+        .conversion_time = OPT3002_CONVERSION_800MS,
+        .fault_count = 2,
+    };
+    if (i2c_scheduler_probe(s_sched, OPT3002_ADDR) == ESP_OK &&
+        attach_device(OPT3002_ADDR, &s_opt3002.i2c_dev) == ESP_OK) {
+        // Converts continuously once configured; collect only
+        job = (i2c_scheduler_job_t){
+            .name = "opt3002",
+            .address = OPT3002_ADDR,
+            .device = s_opt3002.i2c_dev,
+            .collect = opt3002_collect_step,
+            .ctx = &s_opt3002,
+        };
+        if (opt3002_init(&s_opt3002, &opt3002_cfg) == ESP_OK) {
+            s_opt3002_irq = opt3002_setup_interrupt();
+            job.period_ms = s_opt3002_irq ? OPT3002_IRQ_POLL_MS : 0;
+        }
+        if (!s_opt3002.initialized ||
+            i2c_scheduler_add_job(s_sched, &job, &s_opt3002_job) != ESP_OK) {
+            s_opt3002_irq = false;
+            detach_device(&s_opt3002.i2c_dev);
+            s_opt3002.initialized = false;
+        }
+    }
+
+    vcnl4040_config_t vcnl4040_cfg = {
+        .led_current_ma = 100,
+        .prox_rate = VCNL4040_PROX_RATE_31_3_SPS,
+    };
+    if (i2c_scheduler_probe(s_sched, VCNL4040_DEFAULT_ADDR) == ESP_OK &&
+        attach_device(VCNL4040_DEFAULT_ADDR, &s_vcnl4040.i2c_dev) == ESP_OK) {
+        // ALS and PS run continuously once configured; collect only
+        job = (i2c_scheduler_job_t){
+            .name = "vcnl4040",
+            .address = VCNL4040_DEFAULT_ADDR,
+            .device = s_vcnl4040.i2c_dev,
+            .collect = vcnl4040_collect_step,
+            .ctx = &s_vcnl4040,
+        };
+        if (vcnl4040_init(&s_vcnl4040, &vcnl4040_cfg) == ESP_OK) {
+            vcnl4040_setup_interrupt();
+            job.period_ms = s_vcnl4040_irq ? VCNL4040_IRQ_POLL_MS : 0;
+        }
+        if (!s_vcnl4040.initialized ||
+            i2c_scheduler_add_job(s_sched, &job, &s_vcnl4040_job) != ESP_OK) {
+            if (s_vcnl4040_irq) {
+                vcnl4040_enable_interrupts(&s_vcnl4040, false, false);
+                s_vcnl4040_irq = false;
+            }
+            detach_device(&s_vcnl4040.i2c_dev);
+            s_vcnl4040.initialized = false;
+        }
+    }
+
+    bmp581_config_t bmp581_cfg = {
+        .odr = BMP581_POLL_ODR,
+        .osr_pressure = BMP581_OSR_X8,
+        .osr_temperature = BMP581_OSR_X1,
+        .fifo_threshold = BMP581_IRQ_FIFO_THRESHOLD,
+    };
+#if CONFIG_SENSOR_INTEGRATION_BMP581_INT_GPIO >= 0
+    bmp581_cfg.odr = BMP581_IRQ_ODR;
+#endif
+    if (i2c_scheduler_probe(s_sched, BMP581_DEFAULT_ADDR) == ESP_OK &&
+        attach_device(BMP581_DEFAULT_ADDR, &s_bmp581.i2c_dev) == ESP_OK) {
+        // Normal mode fills the FIFO on its own; collect only
+        job = (i2c_scheduler_job_t){
+            .name = "bmp581",
+            .address = BMP581_DEFAULT_ADDR,
+            .device = s_bmp581.i2c_dev,
+            .collect = bmp581_collect_step,
+            .ctx = &s_bmp581,
+        };
+        if (bmp581_init(&s_bmp581, &bmp581_cfg) == ESP_OK) {
+            s_bmp581_irq = bmp581_setup_interrupt();
+        }
+        if (!s_bmp581.initialized ||
+            i2c_scheduler_add_job(s_sched, &job, &s_bmp581_job) != ESP_OK) {
+            if (s_bmp581_irq) {
+                bmp581_enable_interrupt(&s_bmp581, 0);
+                s_bmp581_irq = false;
+            }
+            detach_device(&s_bmp581.i2c_dev);
+            s_bmp581.initialized = false;
+        }
+    }
+
+    sps30_config_t sps30_cfg = {
+        .output_format = CONFIG_SENSOR_INTEGRATION_SPS30_UINT16 ? SPS30_OUTPUT_UINT16 : SPS30_OUTPUT_FLOAT,
+        .auto_clean_interval_s = CONFIG_SENSOR_INTEGRATION_SPS30_CLEAN_DAYS * 86400u,
+    };
+    if (i2c_scheduler_probe(s_sched, SPS30_DEFAULT_ADDR) == ESP_OK &&
+        attach_device(SPS30_DEFAULT_ADDR, &s_sps30.i2c_dev) == ESP_OK) {
+        // Continuous mode converts on its own at 1 Hz; collect only
+        job = (i2c_scheduler_job_t){
+            .name = "sps30",
+            .address = SPS30_DEFAULT_ADDR,
+            .device = s_sps30.i2c_dev,
+            .period_ms = SPS30_MEASUREMENT_PERIOD_MS,
+            .collect = sps30_collect_step,
+            .ctx = &s_sps30,
+        };
+        s_sps30_started_ms = esp_log_timestamp();
+        if (sps30_init(&s_sps30, &sps30_cfg) != ESP_OK ||
+            sps30_start_measurement(&s_sps30) != ESP_OK ||
+            i2c_scheduler_add_job(s_sched, &job, &s_sps30_job) != ESP_OK) {
+            if (s_sps30.measuring) {
+                sps30_stop_measurement(&s_sps30);
+            }
+            detach_device(&s_sps30.i2c_dev);
+            s_sps30.initialized = false;
+        }
+    }
+
+    ESP_LOGI(TAG, "I2C sensors: sht45=%s sgp40=%s scd40=%s vcnl4040=%s opt3002=%s sps30=%s bmp581=%s",
+             s_sht45_job ? "yes" : "no", s_sgp40_job ? "yes" : "no",
+             s_scd40_job ? "yes" : "no", s_vcnl4040_job ? (s_vcnl4040_irq ? "irq" : "yes") : "no",
+             s_opt3002_job ? (s_opt3002_irq ? "irq" : "yes") : "no",
+             s_sps30_job ? "yes" : "no", s_bmp581_job ? (s_bmp581_irq ? "irq" : "yes") : "no");
+}
 
 esp_err_t sensor_integration_init(void)
 {
@@ -91,33 +893,34 @@ esp_err_t sensor_integration_init(void)
 
     ESP_LOGI(TAG, "Initializing sensor integration...");
 
-    // TODO: Re-enable when sensor driver components are available
-    // Initialize I2C master bus
-    // i2c_master_bus_config_t i2c_bus_config = {
-    //     .i2c_port = I2C_MASTER_NUM,
-    //     .sda_io_num = I2C_MASTER_SDA_IO,
-    //     .scl_io_num = I2C_MASTER_SCL_IO,
-    //     .clk_source = I2C_CLK_SRC_DEFAULT,
-    //     .glitch_ignore_cnt = 7,
-    //     .flags = {
-    //         .enable_internal_pullup = true,
-    //     },
-    // };
-    // i2c_master_bus_handle_t bus_handle = I2C_NUM_MAX;
-    // esp_err_t ret = i2c_new_master_bus(&i2c_bus_config, &bus_handle);
-    // if (ret != ESP_OK) {
-    //     ESP_LOGE(TAG, "Failed to initialize I2C bus: %s", esp_err_to_name(ret));
-    //     return ret;
-    // }
-    // s_i2c_bus = bus_handle;
-    
-    // For now, mark all sensors as unavailable (will use synthetic data)
-    s_sensor_cache.sht45_available = false;
-    s_sensor_cache.sgp40_available = false;
-    s_sensor_cache.scd40_available = false;
-    s_sensor_cache.vcnl4040_available = false;
-    s_sensor_cache.ec10_available = false;
-    ESP_LOGI(TAG, "Sensor drivers disabled - using synthetic data");
+    i2c_scheduler_config_t sched_cfg = {
+        .port = I2C_MASTER_NUM,
+        .sda_io_num = I2C_MASTER_SDA_IO,
+        .scl_io_num = I2C_MASTER_SCL_IO,
+        .scl_speed_hz = I2C_MASTER_FREQ_HZ,
+        .enable_internal_pullup = true,
+    };
+    esp_err_t ret = i2c_scheduler_new(&sched_cfg, &s_sched);
+    if (ret == ESP_OK) {
+        sensor_integration_add_i2c_sensors();
+    } else {
+        ESP_LOGE(TAG, "Failed to initialize I2C bus: %s", esp_err_to_name(ret));
+        s_sched = NULL;
+    }
+
+#if CONFIG_SENSOR_INTEGRATION_EC10
+    ec10_config_t ec10_cfg = {
+        .uart_port = CONFIG_SENSOR_INTEGRATION_EC10_UART_NUM,
+        .tx_io_num = CONFIG_SENSOR_INTEGRATION_EC10_TX_GPIO,
+        .rx_io_num = CONFIG_SENSOR_INTEGRATION_EC10_RX_GPIO,
+        .baud_rate = 9600,
+        .rx_buffer_size = 255,  // Must exceed the 128-byte UART FIFO
+    };
+    ret = ec10_init(&s_ec10, &ec10_cfg);
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "EC10 init failed: %s", esp_err_to_name(ret));
+    }
+#endif
 
     // Initialize sensor manager with 1Hz sampling (1000ms)
     sensor_manager_config_t mgr_cfg = {
@@ -127,11 +930,22 @@ esp_err_t sensor_integration_init(void)
 
     // Register all sensors
     sensor_manager_sensor_t sensors[] = {
-        {.name = "sht45", .sample_cb = sample_sht45_cb},
-        {.name = "sgp40", .sample_cb = sample_sgp40_cb},
-        {.name = "scd40", .sample_cb = sample_scd40_cb},
-        {.name = "vcnl4040", .sample_cb = sample_vcnl4040_cb},
-        {.name = "ec10", .sample_cb = sample_ec10_cb},
+        {.name = "sht45", .sample_cb = sample_sht45_cb, .encode_cb = encode_sht45_cb,
+         CHANNELS(SHT45_CHANNELS), .read_cb = read_sht45_cb},
+        {.name = "sgp40", .sample_cb = sample_sgp40_cb, .encode_cb = encode_sgp40_cb,
+         CHANNELS(SGP40_CHANNELS), .read_cb = read_sgp40_cb},
+        {.name = "scd40", .sample_cb = sample_scd40_cb, .encode_cb = encode_scd40_cb,
+         CHANNELS(SCD40_CHANNELS), .read_cb = read_scd40_cb},
+        {.name = "vcnl4040", .sample_cb = sample_vcnl4040_cb, .encode_cb = encode_vcnl4040_cb,
+         CHANNELS(VCNL4040_CHANNELS), .read_cb = read_vcnl4040_cb},
+        {.name = "ec10", .sample_cb = sample_ec10_cb, .encode_cb = encode_ec10_cb,
+         CHANNELS(EC10_CHANNELS), .read_cb = read_ec10_cb},
+        {.name = "sps30", .sample_cb = sample_sps30_cb, .encode_cb = encode_sps30_cb,
+         CHANNELS(SPS30_CHANNELS), .read_cb = read_sps30_cb},
+        {.name = "bmp581", .sample_cb = sample_bmp581_cb, .encode_cb = encode_bmp581_cb,
+         CHANNELS(BMP581_CHANNELS), .read_cb = read_bmp581_cb},
+        {.name = "opt3002", .sample_cb = sample_opt3002_cb, .encode_cb = encode_opt3002_cb,
+         CHANNELS(OPT3002_CHANNELS), .read_cb = read_opt3002_cb},
     };
 
     for (size_t i = 0; i < sizeof(sensors) / sizeof(sensors[0]); i++) {
@@ -159,19 +973,23 @@ esp_err_t sensor_integration_start(void)
     // Start sensor manager
     ESP_RETURN_ON_ERROR(sensor_manager_start(), TAG, "sensor manager start failed");
 
+    // Set before the task runs: its loop exits as soon as this is false
+    s_running = true;
+
     // Start sampling task
-    BaseType_t ret = xTaskCreate(sensor_sampling_task,
-                                 "sensor_sampling",
-                                 4096,
-                                 NULL,
-                                 5,
-                                 &s_task_handle);
+    BaseType_t ret = xTaskCreatePinnedToCore(sensor_sampling_task,
+                                             "sensor_sampling",
+                                             4096,
+                                             NULL,
+                                             5,
+                                             &s_task_handle,
+                                             CONFIG_SENSOR_MANAGER_TASK_CORE);
     if (ret != pdPASS) {
         ESP_LOGE(TAG, "Failed to create sensor sampling task");
+        s_running = false;
         return ESP_ERR_NO_MEM;
     }
 
-    s_running = true;
     ESP_LOGI(TAG, "Sensor integration started");
     return ESP_OK;
 }
@@ -185,6 +1003,21 @@ esp_err_t sensor_integration_stop(void)
     sensor_manager_stop();
     s_running = false;
 
+    if (s_vcnl4040_irq) {
+        gpio_intr_disable(VCNL4040_INT_GPIO);
+        gpio_wakeup_disable(VCNL4040_INT_GPIO);
+        gpio_isr_handler_remove(VCNL4040_INT_GPIO);
+    }
+    if (s_bmp581_irq) {
+        gpio_intr_disable(BMP581_INT_GPIO);
+        gpio_wakeup_disable(BMP581_INT_GPIO);
+        gpio_isr_handler_remove(BMP581_INT_GPIO);
+    }
+    if (s_opt3002_irq) {
+        gpio_intr_disable(OPT3002_INT_GPIO);
+        gpio_wakeup_disable(OPT3002_INT_GPIO);
+        gpio_isr_handler_remove(OPT3002_INT_GPIO);
+    }
     if (s_task_handle) {
         vTaskDelete(s_task_handle);
         s_task_handle = NULL;
@@ -194,134 +1027,477 @@ esp_err_t sensor_integration_stop(void)
     return ESP_OK;
 }
 
+static void cache_publish(const sensor_integration_data_t *data)
+{
+    uint32_t seq = __atomic_load_n(&s_cache_seq, __ATOMIC_RELAXED);
+    s_cache[(seq + 1) & 1] = *data;
+    __atomic_store_n(&s_cache_seq, seq + 1, __ATOMIC_RELEASE);
+}
+
 sensor_integration_data_t sensor_integration_get_data(void)
 {
-    sensor_integration_data_t data = {0};
-    data.temperature_c = s_sensor_cache.temperature_c;
-    data.humidity_rh = s_sensor_cache.humidity_rh;
-    data.voc_index = s_sensor_cache.voc_index;
-    data.co2_ppm = s_sensor_cache.co2_ppm;
-    data.temperature_co2_c = s_sensor_cache.temperature_co2_c;
-    data.humidity_co2_rh = s_sensor_cache.humidity_co2_rh;
-    data.ambient_lux = s_sensor_cache.ambient_lux;
-    data.proximity = s_sensor_cache.proximity;
-    data.ec_ms_per_cm = s_sensor_cache.ec_ms_per_cm;
-    data.sht45_available = s_sensor_cache.sht45_available;
-    data.sgp40_available = s_sensor_cache.sgp40_available;
-    data.scd40_available = s_sensor_cache.scd40_available;
-    data.vcnl4040_available = s_sensor_cache.vcnl4040_available;
-    data.ec10_available = s_sensor_cache.ec10_available;
-    data.last_update_ms = s_sensor_cache.last_update_ms;
+    sensor_integration_data_t data;
+    uint32_t seq;
+    do {
+        seq = __atomic_load_n(&s_cache_seq, __ATOMIC_ACQUIRE);
+        data = s_cache[seq & 1];
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    } while (__atomic_load_n(&s_cache_seq, __ATOMIC_RELAXED) != seq);
     return data;
 }
 
+esp_err_t sensor_integration_set_event_cb(sensor_integration_event_cb_t cb, void *user_ctx)
+{
+    s_event_ctx = user_ctx;
+    s_event_cb = cb;
+    return ESP_OK;
+}
+
+static bool job_ok(const i2c_scheduler_dev_t *job)
+{
+    return job && i2c_scheduler_dev_result(job) == ESP_OK;
+}
+
+static void sample_ec10(uint32_t now_ms)
+{
+    if (!s_ec10.initialized) {
+        return;
+    }
+    // The sensor streams frames on its own; drain to the newest whole one
+    // without waiting for more
+    size_t buffered = 0;
+    uart_get_buffered_data_len(s_ec10.config.uart_port, &buffered);
+    ec10_measurement_t data;
+    while (buffered >= EC10_FRAME_LENGTH) {
+        if (ec10_read_measurement(&s_ec10, &data, 0) == ESP_OK) {
+            s_staging.pm1_0_ug_m3 = data.pm1_0_ug_m3;
+            s_staging.ec_ms_per_cm = data.pm2_5_ug_m3;
+            s_staging.pm10_ug_m3 = data.pm10_ug_m3;
+            s_ec10_last_ok_ms = now_ms;
+            s_staging.ec10_available = true;
+        }
+        buffered -= EC10_FRAME_LENGTH;
+    }
+    if (s_staging.ec10_available && now_ms - s_ec10_last_ok_ms > EC10_STALE_MS) {
+        s_staging.ec10_available = false;
+    }
+}
+
+// After the readings are published, so observers sample what the event reports
+static void dispatch_sensor_events(void)
+{
+    uint8_t events = s_sensor_events;
+    s_sensor_events = 0;
+    if (!events) {
+        return;
+    }
+    if ((events & SENSOR_EVENT_PROXIMITY) || !s_opt3002_job) {
+        sensor_manager_notify("vcnl4040");
+    }
+    if ((events & SENSOR_EVENT_LIGHT) && s_opt3002_job) {
+        sensor_manager_notify("opt3002");
+    }
+
+    sensor_integration_event_cb_t cb = s_event_cb;
+    if (!cb) {
+        return;
+    }
+    sensor_integration_event_t event = {
+        .near = s_vcnl4040_near,
+        .ambient_lux = s_opt3002_job ? s_staging.opt3002_lux : s_staging.ambient_lux,
+        .proximity = s_staging.proximity,
+    };
+    if (events & SENSOR_EVENT_PROXIMITY) {
+        event.type = SENSOR_INTEGRATION_EVENT_PROXIMITY;
+        cb(&event, s_event_ctx);
+    }
+    if (events & SENSOR_EVENT_LIGHT) {
+        event.type = SENSOR_INTEGRATION_EVENT_AMBIENT_LIGHT;
+        cb(&event, s_event_ctx);
+    }
+}
+
+static void vcnl4040_service_interrupt(void)
+{
+    if (!s_vcnl4040_irq) {
+        return;
+    }
+    s_staging.vcnl4040_available = vcnl4040_collect_step(s_vcnl4040_job, &s_vcnl4040) == ESP_OK;
+    s_staging.last_update_ms = esp_log_timestamp();
+    cache_publish(&s_staging);
+    dispatch_sensor_events();
+    // A failed read leaves INT low; the next sweep unmasks it rather than
+    // spinning on a broken bus
+    if (s_staging.vcnl4040_available) {
+        gpio_intr_enable(VCNL4040_INT_GPIO);
+    }
+}
+
+static void opt3002_service_interrupt(void)
+{
+    if (!s_opt3002_irq) {
+        return;
+    }
+    s_staging.opt3002_available = opt3002_collect_step(s_opt3002_job, &s_opt3002) == ESP_OK;
+    s_staging.last_update_ms = esp_log_timestamp();
+    cache_publish(&s_staging);
+    dispatch_sensor_events();
+    if (s_staging.opt3002_available) {
+        gpio_intr_enable(OPT3002_INT_GPIO);
+    }
+}
+
+static void bmp581_service_interrupt(void)
+{
+    if (!s_bmp581_irq) {
+        return;
+    }
+    // Frames wait for the sweep to publish them; a failed read leaves INT
+    // high, so the pin stays masked until the next sweep
+    if (bmp581_drain() == ESP_OK) {
+        gpio_intr_enable(BMP581_INT_GPIO);
+    }
+}
+
 static void sensor_sampling_task(void *arg)
 {
     (void)arg;
     const TickType_t delay_ticks = pdMS_TO_TICKS(SENSOR_SAMPLE_INTERVAL_MS);
-    TickType_t last_wake = xTaskGetTickCount();
+    TickType_t next_sweep = xTaskGetTickCount();
 
     ESP_LOGI(TAG, "Sensor sampling task started (1Hz)");
+    if (s_vcnl4040_irq) {
+        gpio_isr_handler_add(VCNL4040_INT_GPIO, vcnl4040_int_isr, xTaskGetCurrentTaskHandle());
+        gpio_intr_enable(VCNL4040_INT_GPIO);
+    }
+    if (s_bmp581_irq) {
+        gpio_isr_handler_add(BMP581_INT_GPIO, bmp581_int_isr, xTaskGetCurrentTaskHandle());
+        gpio_intr_enable(BMP581_INT_GPIO);
+    }
+    if (s_opt3002_irq) {
+        gpio_isr_handler_add(OPT3002_INT_GPIO, opt3002_int_isr, xTaskGetCurrentTaskHandle());
+        gpio_intr_enable(OPT3002_INT_GPIO);
+    }
 
     while (s_running) {
-        // TODO: Re-enable when sensor driver components are available
-        // For now, generate synthetic sensor data
-        static uint32_t sensor_synthetic_counter = 0;
-        sensor_synthetic_counter++;
-        
-        // Generate synthetic SHT45 data (temperature, humidity)
-        s_sensor_cache.temperature_c = 22.0f + 3.0f * sinf(sensor_synthetic_counter * 0.01f);
-        s_sensor_cache.humidity_rh = 50.0f + 10.0f * sinf(sensor_synthetic_counter * 0.008f);
-        
-        // Generate synthetic SGP40 data (VOC)
-        s_sensor_cache.voc_index = 100 + (uint16_t)(50.0f * sinf(sensor_synthetic_counter * 0.01f));
-        
-        // Generate synthetic SCD40 data (CO2, temperature, humidity)
-        s_sensor_cache.co2_ppm = 450.0f + 50.0f * sinf(sensor_synthetic_counter * 0.005f);
-        s_sensor_cache.temperature_co2_c = s_sensor_cache.temperature_c;
-        s_sensor_cache.humidity_co2_rh = s_sensor_cache.humidity_rh;
-        
-        // Generate synthetic VCNL4040 data (light, proximity)
-        s_sensor_cache.ambient_lux = 200 + (uint16_t)(100.0f * sinf(sensor_synthetic_counter * 0.02f));
-        s_sensor_cache.proximity = 0;  // No proximity by default
-
-        // TODO: Re-enable when ec10 component is available
-        // ec10_measurement_t ec10_data;
-        // esp_err_t ec10_ret = ec10_read_measurement(&s_ec10, &ec10_data, pdMS_TO_TICKS(100));
-        // if (ec10_ret == ESP_OK) {
-        //     // EC10 is PM sensor, not EC - use PM2.5 as primary value
-        //     s_sensor_cache.ec_ms_per_cm = ec10_data.pm2_5_ug_m3;  // Store PM2.5 value
-        // Use synthetic data for now
-        if (!s_sensor_cache.ec10_available) {
-            // Generate synthetic PM2.5 data
-            static uint32_t ec10_synthetic_counter = 0;
-            ec10_synthetic_counter++;
-            s_sensor_cache.ec_ms_per_cm = 15.0f + 5.0f * sinf(ec10_synthetic_counter * 0.01f);  // PM2.5 in μg/m³
+        int32_t remaining = (int32_t)(next_sweep - xTaskGetTickCount());
+        if (remaining > 0) {
+            // Sleep to the next sweep unless a sensor raises INT first
+            uint32_t pending = 0;
+            if (xTaskNotifyWait(0, UINT32_MAX, &pending, (TickType_t)remaining) == pdTRUE) {
+                if (pending & SAMPLING_NOTIFY_VCNL4040) {
+                    vcnl4040_service_interrupt();
+                }
+                if (pending & SAMPLING_NOTIFY_OPT3002) {
+                    opt3002_service_interrupt();
+                }
+                if (pending & SAMPLING_NOTIFY_BMP581) {
+                    bmp581_service_interrupt();
+                }
+            }
+            continue;
         }
+        next_sweep += delay_ticks;
 
-        s_sensor_cache.last_update_ms = esp_log_timestamp();
+        // All conversions overlap, so a sweep takes about the slowest one
+        uint32_t sweep_ms = 0;
+        if (s_sched) {
+            i2c_scheduler_sweep(s_sched, &sweep_ms);
+        }
+        // A failed read keeps the last values but clears the flag
+        s_staging.sht45_available = job_ok(s_sht45_job);
+        s_staging.sgp40_available = job_ok(s_sgp40_job);
+        s_staging.scd40_available = job_ok(s_scd40_job);
+        s_staging.vcnl4040_available = job_ok(s_vcnl4040_job);
+        s_staging.sps30_available = job_ok(s_sps30_job);
+        s_staging.bmp581_available = job_ok(s_bmp581_job);
+        s_staging.opt3002_available = job_ok(s_opt3002_job);
+        sample_ec10(esp_log_timestamp());
 
-        // Log sensor readings
-        ESP_LOGI(TAG, "Sensors: T=%.1f°C H=%.1f%% VOC=%u CO2=%.0fppm Lux=%u Prox=%u PM2.5=%.0f",
-                 s_sensor_cache.temperature_c,
-                 s_sensor_cache.humidity_rh,
-                 s_sensor_cache.voc_index,
-                 s_sensor_cache.co2_ppm,
-                 s_sensor_cache.ambient_lux,
-                 s_sensor_cache.proximity,
-                 s_sensor_cache.ec_ms_per_cm);
+        s_staging.last_update_ms = esp_log_timestamp();
+        cache_publish(&s_staging);
+        dispatch_sensor_events();
+        if (s_vcnl4040_irq) {
+            gpio_intr_enable(VCNL4040_INT_GPIO);
+        }
+        if (s_bmp581_irq) {
+            gpio_intr_enable(BMP581_INT_GPIO);
+        }
+        if (s_opt3002_irq) {
+            gpio_intr_enable(OPT3002_INT_GPIO);
+        }
 
-        vTaskDelayUntil(&last_wake, delay_ticks);
+        ESP_LOGD(TAG, "Sensors (%" PRIu32 " ms): T=%.1f°C H=%.1f%% VOC=%u CO2=%.0fppm Lux=%u Prox=%u PM2.5=%.0f",
+                 sweep_ms,
+                 s_staging.temperature_c,
+                 s_staging.humidity_rh,
+                 s_staging.voc_index,
+                 s_staging.co2_ppm,
+                 s_staging.ambient_lux,
+                 s_staging.proximity,
+                 s_staging.ec_ms_per_cm);
     }
 
     vTaskDelete(NULL);
 }
 
-// TODO: Re-enable when sensor driver components are available
+// The callbacks below run on the sensor manager task and read the latest
+// published snapshot; a sensor without a current reading is left out
 static bool sample_sht45_cb(cJSON *sensor_root)
 {
-    // Return synthetic data
-    cJSON_AddNumberToObject(sensor_root, "temperature_c", s_sensor_cache.temperature_c);
-    cJSON_AddNumberToObject(sensor_root, "humidity_rh", s_sensor_cache.humidity_rh);
-    cJSON_AddBoolToObject(sensor_root, "synthetic", true);
+    sensor_integration_data_t data = sensor_integration_get_data();
+    if (!data.sht45_available) {
+        return false;
+    }
+    cJSON_AddNumberToObject(sensor_root, "temperature_c", data.temperature_c);
+    cJSON_AddNumberToObject(sensor_root, "humidity_rh", data.humidity_rh);
     return true;
 }
 
 static bool sample_sgp40_cb(cJSON *sensor_root)
 {
-    // Return synthetic data
-    cJSON_AddNumberToObject(sensor_root, "voc_index", s_sensor_cache.voc_index);
-    cJSON_AddNumberToObject(sensor_root, "voc_ticks", s_sensor_cache.voc_index * 10);
-    cJSON_AddBoolToObject(sensor_root, "synthetic", true);
+    sensor_integration_data_t data = sensor_integration_get_data();
+    if (!data.sgp40_available) {
+        return false;
+    }
+    cJSON_AddNumberToObject(sensor_root, "voc_index", data.voc_index);
+    cJSON_AddNumberToObject(sensor_root, "voc_ticks", data.voc_ticks);
     return true;
 }
 
 static bool sample_scd40_cb(cJSON *sensor_root)
 {
-    // Return synthetic data
-    cJSON_AddNumberToObject(sensor_root, "co2_ppm", s_sensor_cache.co2_ppm);
-    cJSON_AddNumberToObject(sensor_root, "temperature_c", s_sensor_cache.temperature_co2_c);
-    cJSON_AddNumberToObject(sensor_root, "humidity_rh", s_sensor_cache.humidity_co2_rh);
-    cJSON_AddBoolToObject(sensor_root, "synthetic", true);
+    sensor_integration_data_t data = sensor_integration_get_data();
+    if (!data.scd40_available) {
+        return false;
+    }
+    cJSON_AddNumberToObject(sensor_root, "co2_ppm", data.co2_ppm);
+    cJSON_AddNumberToObject(sensor_root, "temperature_c", data.temperature_co2_c);
+    cJSON_AddNumberToObject(sensor_root, "humidity_rh", data.humidity_co2_rh);
     return true;
 }
 
 static bool sample_vcnl4040_cb(cJSON *sensor_root)
 {
-    // Return synthetic data
-    cJSON_AddNumberToObject(sensor_root, "ambient_lux", s_sensor_cache.ambient_lux);
-    cJSON_AddNumberToObject(sensor_root, "proximity", s_sensor_cache.proximity);
-    cJSON_AddBoolToObject(sensor_root, "synthetic", true);
+    sensor_integration_data_t data = sensor_integration_get_data();
+    if (!data.vcnl4040_available) {
+        return false;
+    }
+    cJSON_AddNumberToObject(sensor_root, "ambient_lux", data.ambient_lux);
+    cJSON_AddNumberToObject(sensor_root, "proximity", data.proximity);
     return true;
 }
 
 static bool sample_ec10_cb(cJSON *sensor_root)
 {
-    // Return synthetic PM data
-    float pm2_5 = s_sensor_cache.ec_ms_per_cm;  // Stored as PM2.5
-    cJSON_AddNumberToObject(sensor_root, "pm1_0_ug_m3", (uint16_t)(pm2_5 * 0.7f));
-    cJSON_AddNumberToObject(sensor_root, "pm2_5_ug_m3", (uint16_t)pm2_5);
-    cJSON_AddNumberToObject(sensor_root, "pm10_ug_m3", (uint16_t)(pm2_5 * 1.5f));
-    cJSON_AddBoolToObject(sensor_root, "synthetic", true);
+    sensor_integration_data_t data = sensor_integration_get_data();
+    if (!data.ec10_available) {
+        return false;
+    }
+    cJSON_AddNumberToObject(sensor_root, "pm1_0_ug_m3", (uint16_t)data.pm1_0_ug_m3);
+    cJSON_AddNumberToObject(sensor_root, "pm2_5_ug_m3", (uint16_t)data.ec_ms_per_cm);
+    cJSON_AddNumberToObject(sensor_root, "pm10_ug_m3", (uint16_t)data.pm10_ug_m3);
+    return true;
+}
+
+static bool sample_sps30_cb(cJSON *sensor_root)
+{
+    sensor_integration_data_t data = sensor_integration_get_data();
+    if (!data.sps30_available) {
+        return false;
+    }
+    cJSON_AddNumberToObject(sensor_root, "pm1_0_ug_m3", data.sps30_pm1_0_ug_m3);
+    cJSON_AddNumberToObject(sensor_root, "pm2_5_ug_m3", data.sps30_pm2_5_ug_m3);
+    cJSON_AddNumberToObject(sensor_root, "pm4_0_ug_m3", data.sps30_pm4_0_ug_m3);
+    cJSON_AddNumberToObject(sensor_root, "pm10_ug_m3", data.sps30_pm10_ug_m3);
+    cJSON_AddNumberToObject(sensor_root, "particle_size_um", data.sps30_particle_size_um);
+    return true;
+}
+
+static bool sample_bmp581_cb(cJSON *sensor_root)
+{
+    sensor_integration_data_t data = sensor_integration_get_data();
+    if (!data.bmp581_available) {
+        return false;
+    }
+    cJSON_AddNumberToObject(sensor_root, "pressure_hpa", data.pressure_hpa);
+    cJSON_AddNumberToObject(sensor_root, "temperature_c", data.temperature_baro_c);
+    cJSON_AddNumberToObject(sensor_root, "pressure_span_pa", data.pressure_span_pa);
+    return true;
+}
+
+static bool sample_opt3002_cb(cJSON *sensor_root)
+{
+    sensor_integration_data_t data = sensor_integration_get_data();
+    if (!data.opt3002_available) {
+        return false;
+    }
+    cJSON_AddNumberToObject(sensor_root, "ambient_lux", data.opt3002_lux);
+    cJSON_AddNumberToObject(sensor_root, "irradiance_nw_cm2", data.irradiance_nw_cm2);
+    return true;
+}
+
+// Binary telemetry: same keys and values as the JSON callbacks above
+static bool encode_sht45_cb(telemetry_cbor_t *sensor_map)
+{
+    sensor_integration_data_t data = sensor_integration_get_data();
+    if (!data.sht45_available) {
+        return false;
+    }
+    telemetry_cbor_put_float(sensor_map, "temperature_c", data.temperature_c);
+    telemetry_cbor_put_float(sensor_map, "humidity_rh", data.humidity_rh);
+    return true;
+}
+
+static bool encode_sgp40_cb(telemetry_cbor_t *sensor_map)
+{
+    sensor_integration_data_t data = sensor_integration_get_data();
+    if (!data.sgp40_available) {
+        return false;
+    }
+    telemetry_cbor_put_int(sensor_map, "voc_index", data.voc_index);
+    telemetry_cbor_put_int(sensor_map, "voc_ticks", data.voc_ticks);
+    return true;
+}
+
+static bool encode_scd40_cb(telemetry_cbor_t *sensor_map)
+{
+    sensor_integration_data_t data = sensor_integration_get_data();
+    if (!data.scd40_available) {
+        return false;
+    }
+    telemetry_cbor_put_float(sensor_map, "co2_ppm", data.co2_ppm);
+    telemetry_cbor_put_float(sensor_map, "temperature_c", data.temperature_co2_c);
+    telemetry_cbor_put_float(sensor_map, "humidity_rh", data.humidity_co2_rh);
+    return true;
+}
+
+static bool encode_vcnl4040_cb(telemetry_cbor_t *sensor_map)
+{
+    sensor_integration_data_t data = sensor_integration_get_data();
+    if (!data.vcnl4040_available) {
+        return false;
+    }
+    telemetry_cbor_put_int(sensor_map, "ambient_lux", data.ambient_lux);
+    telemetry_cbor_put_int(sensor_map, "proximity", data.proximity);
+    return true;
+}
+
+static bool encode_ec10_cb(telemetry_cbor_t *sensor_map)
+{
+    sensor_integration_data_t data = sensor_integration_get_data();
+    if (!data.ec10_available) {
+        return false;
+    }
+    telemetry_cbor_put_int(sensor_map, "pm1_0_ug_m3", (uint16_t)data.pm1_0_ug_m3);
+    telemetry_cbor_put_int(sensor_map, "pm2_5_ug_m3", (uint16_t)data.ec_ms_per_cm);
+    telemetry_cbor_put_int(sensor_map, "pm10_ug_m3", (uint16_t)data.pm10_ug_m3);
     return true;
 }
+
+static bool encode_sps30_cb(telemetry_cbor_t *sensor_map)
+{
+    sensor_integration_data_t data = sensor_integration_get_data();
+    if (!data.sps30_available) {
+        return false;
+    }
+    telemetry_cbor_put_float(sensor_map, "pm1_0_ug_m3", data.sps30_pm1_0_ug_m3);
+    telemetry_cbor_put_float(sensor_map, "pm2_5_ug_m3", data.sps30_pm2_5_ug_m3);
+    telemetry_cbor_put_float(sensor_map, "pm4_0_ug_m3", data.sps30_pm4_0_ug_m3);
+    telemetry_cbor_put_float(sensor_map, "pm10_ug_m3", data.sps30_pm10_ug_m3);
+    telemetry_cbor_put_float(sensor_map, "particle_size_um", data.sps30_particle_size_um);
+    return true;
+}
+
+static bool encode_bmp581_cb(telemetry_cbor_t *sensor_map)
+{
+    sensor_integration_data_t data = sensor_integration_get_data();
+    if (!data.bmp581_available) {
+        return false;
+    }
+    telemetry_cbor_put_float(sensor_map, "pressure_hpa", data.pressure_hpa);
+    telemetry_cbor_put_float(sensor_map, "temperature_c", data.temperature_baro_c);
+    telemetry_cbor_put_float(sensor_map, "pressure_span_pa", data.pressure_span_pa);
+    return true;
+}
+
+static bool encode_opt3002_cb(telemetry_cbor_t *sensor_map)
+{
+    sensor_integration_data_t data = sensor_integration_get_data();
+    if (!data.opt3002_available) {
+        return false;
+    }
+    telemetry_cbor_put_int(sensor_map, "ambient_lux", data.opt3002_lux);
+    telemetry_cbor_put_float(sensor_map, "irradiance_nw_cm2", data.irradiance_nw_cm2);
+    return true;
+}
+
+// Batched readings: same values as above, one per channel
+static bool read_sht45_cb(float *values)
+{
+    sensor_integration_data_t data = sensor_integration_get_data();
+    values[0] = data.temperature_c;
+    values[1] = data.humidity_rh;
+    return data.sht45_available;
+}
+
+static bool read_sgp40_cb(float *values)
+{
+    sensor_integration_data_t data = sensor_integration_get_data();
+    values[0] = data.voc_index;
+    return data.sgp40_available;
+}
+
+static bool read_scd40_cb(float *values)
+{
+    sensor_integration_data_t data = sensor_integration_get_data();
+    values[0] = data.co2_ppm;
+    values[1] = data.temperature_co2_c;
+    values[2] = data.humidity_co2_rh;
+    return data.scd40_available;
+}
+
+static bool read_vcnl4040_cb(float *values)
+{
+    sensor_integration_data_t data = sensor_integration_get_data();
+    values[0] = data.ambient_lux;
+    values[1] = data.proximity;
+    return data.vcnl4040_available;
+}
+
+static bool read_ec10_cb(float *values)
+{
+    sensor_integration_data_t data = sensor_integration_get_data();
+    values[0] = (uint16_t)data.pm1_0_ug_m3;
+    values[1] = (uint16_t)data.ec_ms_per_cm;
+    values[2] = (uint16_t)data.pm10_ug_m3;
+    return data.ec10_available;
+}
+
+static bool read_sps30_cb(float *values)
+{
+    sensor_integration_data_t data = sensor_integration_get_data();
+    values[0] = data.sps30_pm1_0_ug_m3;
+    values[1] = data.sps30_pm2_5_ug_m3;
+    values[2] = data.sps30_pm4_0_ug_m3;
+    values[3] = data.sps30_pm10_ug_m3;
+    values[4] = data.sps30_particle_size_um;
+    return data.sps30_available;
+}
+
+static bool read_bmp581_cb(float *values)
+{
+    sensor_integration_data_t data = sensor_integration_get_data();
+    values[0] = data.pressure_hpa;
+    values[1] = data.temperature_baro_c;
+    values[2] = data.pressure_span_pa;
+    return data.bmp581_available;
+}
+
+static bool read_opt3002_cb(float *values)
+{
+    sensor_integration_data_t data = sensor_integration_get_data();
+    values[0] = data.opt3002_lux;
+    values[1] = data.irradiance_nw_cm2;
+    return data.opt3002_available;
+}
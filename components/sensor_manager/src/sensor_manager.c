@@ -4,14 +4,21 @@
 
 #include "sensor_manager.h"
 
+#include <inttypes.h>
+#include <math.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "esp_check.h"
 #include "esp_log.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "json_writer.h"
 #include "sdkconfig.h"
+#include "night_summary.h"
+#include "sensor_history.h"
 #include "somnus_mqtt.h"
+#include "telemetry_batch.h"
 
 #define SENSOR_MANAGER_TAG "sensor_manager"
 
@@ -20,25 +27,92 @@
 #endif
 
 #define SENSOR_MANAGER_MAX_SENSORS 8
+// Telemetry is encoded into one static buffer by the manager task
+#define SENSOR_MANAGER_CBOR_MAX_BYTES 512
+#define SENSOR_MANAGER_JSON_MAX_BYTES 1024
 #define SENSOR_MANAGER_TASK_STACK 4096
 #define SENSOR_MANAGER_TASK_PRIO 5
+#if !defined(CONFIG_SENSOR_MANAGER_TELEMETRY_CBOR) && !defined(CONFIG_SENSOR_MANAGER_TELEMETRY_JSON)
+#define CONFIG_SENSOR_MANAGER_TELEMETRY_CBOR 1
+#endif
+#ifndef CONFIG_SENSOR_MANAGER_TELEMETRY_CBOR
+#define CONFIG_SENSOR_MANAGER_TELEMETRY_CBOR 0
+#endif
+
+#ifndef CONFIG_SENSOR_MANAGER_TASK_CORE
+#define CONFIG_SENSOR_MANAGER_TASK_CORE 0
+#endif
+
+#ifndef CONFIG_SENSOR_MANAGER_BATCH
+#define CONFIG_SENSOR_MANAGER_BATCH 1
+#endif
+#ifndef CONFIG_SENSOR_MANAGER_BATCH_MAX_SAMPLES
+#define CONFIG_SENSOR_MANAGER_BATCH_MAX_SAMPLES 300
+#endif
+#ifndef CONFIG_SENSOR_MANAGER_BATCH_MAX_AGE_MS
+#define CONFIG_SENSOR_MANAGER_BATCH_MAX_AGE_MS 300000
+#endif
+#ifndef CONFIG_SENSOR_MANAGER_BATCH_MAX_BYTES
+#define CONFIG_SENSOR_MANAGER_BATCH_MAX_BYTES 2048
+#endif
+#if !defined(CONFIG_SENSOR_MANAGER_NIGHT_SUMMARY) && CONFIG_SENSOR_MANAGER_BATCH
+#define CONFIG_SENSOR_MANAGER_NIGHT_SUMMARY 1
+#endif
+#if !defined(CONFIG_SENSOR_MANAGER_HISTORY) && CONFIG_SENSOR_MANAGER_BATCH
+#define CONFIG_SENSOR_MANAGER_HISTORY 1
+#endif
+// Replay after an outage is spread over several periods
+#define SENSOR_MANAGER_BATCH_SENDS_PER_TICK 2
+#ifndef CONFIG_SENSOR_MANAGER_HEARTBEAT_MS
+#define CONFIG_SENSOR_MANAGER_HEARTBEAT_MS 300000
+#endif
+#define SENSOR_MANAGER_MAX_CHANNELS TELEMETRY_BATCH_MAX_CHANNELS
 
 typedef struct {
     const char *name;
     sensor_manager_sample_cb_t callback;
+    sensor_manager_encode_cb_t encoder;
+    const sensor_manager_channel_t *channels;
+    uint8_t channel_count;
+    uint8_t channel_base;             // First slot in s_channel_state
+    sensor_manager_read_cb_t reader;
 } sensor_entry_t;
 
+// Last reported value of each channel, for deadband and heartbeat
+typedef struct {
+    float reported;
+    uint32_t reported_ms;
+    bool seen;
+} channel_state_t;
+
 static sensor_entry_t s_sensors[SENSOR_MANAGER_MAX_SENSORS];
 static size_t s_sensor_count;
 static uint32_t s_publish_interval_ms = CONFIG_SENSOR_MANAGER_PUBLISH_INTERVAL_MS;
+// Interval from init; sensor_manager_set_publish_interval() overrides it in s_publish_interval_ms
+static uint32_t s_base_interval_ms = CONFIG_SENSOR_MANAGER_PUBLISH_INTERVAL_MS;
 static bool s_initialized;
 static bool s_should_run;
 static bool s_running;
 static TaskHandle_t s_task_handle;
 static sensor_manager_observer_cb_t s_observer_cb;
 static void *s_observer_ctx;
+static channel_state_t s_channel_state[SENSOR_MANAGER_MAX_CHANNELS];
+// One bit per sensor index, set by sensor_manager_notify()
+static uint32_t s_notify_pending;
+#if CONFIG_SENSOR_MANAGER_TELEMETRY_CBOR
+static uint8_t s_payload[SENSOR_MANAGER_CBOR_MAX_BYTES];
+#else
+static char s_payload[SENSOR_MANAGER_JSON_MAX_BYTES];
+#endif
+#if CONFIG_SENSOR_MANAGER_BATCH
+static telemetry_batch_channel_t s_batch_channels[TELEMETRY_BATCH_MAX_CHANNELS];
+static size_t s_batch_channel_count;
+static bool s_batching;
+#endif
 
 static void sensor_manager_collect_and_publish(void);
+static void sensor_manager_batch_tick(void);
+static void sensor_manager_push_notified(void);
 static void sensor_manager_task(void *arg);
 
 esp_err_t sensor_manager_init(const sensor_manager_config_t *config)
@@ -48,6 +122,7 @@ esp_err_t sensor_manager_init(const sensor_manager_config_t *config)
     } else {
         s_publish_interval_ms = CONFIG_SENSOR_MANAGER_PUBLISH_INTERVAL_MS;
     }
+    s_base_interval_ms = s_publish_interval_ms;
 
     s_initialized = true;
     s_observer_cb = NULL;
@@ -70,6 +145,10 @@ esp_err_t sensor_manager_register(const sensor_manager_sensor_t *sensor)
                         ESP_ERR_INVALID_ARG,
                         SENSOR_MANAGER_TAG,
                         "sensor callback is NULL");
+    ESP_RETURN_ON_FALSE(!sensor->read_cb || (sensor->channels && sensor->channel_count > 0),
+                        ESP_ERR_INVALID_ARG,
+                        SENSOR_MANAGER_TAG,
+                        "read callback without channels");
     ESP_RETURN_ON_FALSE(!s_running,
                         ESP_ERR_INVALID_STATE,
                         SENSOR_MANAGER_TAG,
@@ -82,6 +161,10 @@ esp_err_t sensor_manager_register(const sensor_manager_sensor_t *sensor)
     s_sensors[s_sensor_count++] = (sensor_entry_t){
         .name = sensor->name,
         .callback = sensor->sample_cb,
+        .encoder = sensor->encode_cb,
+        .channels = sensor->channels,
+        .channel_count = sensor->read_cb ? sensor->channel_count : 0,
+        .reader = sensor->read_cb,
     };
     return ESP_OK;
 }
@@ -93,6 +176,36 @@ esp_err_t sensor_manager_set_observer(sensor_manager_observer_cb_t observer, voi
     return ESP_OK;
 }
 
+esp_err_t sensor_manager_set_publish_interval(uint32_t interval_ms)
+{
+    uint32_t ms = interval_ms ? interval_ms : s_base_interval_ms;
+    if (__atomic_exchange_n(&s_publish_interval_ms, ms, __ATOMIC_RELAXED) != ms) {
+        ESP_LOGI(SENSOR_MANAGER_TAG, "Sampling every %" PRIu32 " ms", ms);
+        TaskHandle_t task = s_task_handle;
+        if (task) {
+            xTaskNotifyGive(task);
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t sensor_manager_notify(const char *sensor_name)
+{
+    ESP_RETURN_ON_FALSE(sensor_name, ESP_ERR_INVALID_ARG, SENSOR_MANAGER_TAG, "sensor name is NULL");
+    for (size_t i = 0; i < s_sensor_count; ++i) {
+        if (strcmp(s_sensors[i].name, sensor_name) != 0) {
+            continue;
+        }
+        __atomic_fetch_or(&s_notify_pending, 1u << i, __ATOMIC_RELEASE);
+        TaskHandle_t task = s_task_handle;
+        if (task) {
+            xTaskNotifyGive(task);
+        }
+        return ESP_OK;
+    }
+    return ESP_ERR_NOT_FOUND;
+}
+
 esp_err_t sensor_manager_start(void)
 {
     if (!s_initialized) {
@@ -108,13 +221,80 @@ esp_err_t sensor_manager_start(void)
         return ESP_OK;
     }
 
+    // Sensors that do not fit in the channel limit are published every period
+    size_t channel_total = 0;
+    for (size_t i = 0; i < s_sensor_count; ++i) {
+        sensor_entry_t *entry = &s_sensors[i];
+        if (!entry->reader) {
+            continue;
+        }
+        if (channel_total + entry->channel_count > SENSOR_MANAGER_MAX_CHANNELS) {
+            ESP_LOGW(SENSOR_MANAGER_TAG, "No channels left for '%s'", entry->name);
+            entry->reader = NULL;
+            continue;
+        }
+        entry->channel_base = (uint8_t)channel_total;
+        channel_total += entry->channel_count;
+    }
+    for (size_t i = 0; i < SENSOR_MANAGER_MAX_CHANNELS; ++i) {
+        s_channel_state[i] = (channel_state_t){.reported = NAN};
+    }
+
+#if CONFIG_SENSOR_MANAGER_BATCH
+    s_batch_channel_count = 0;
+    for (size_t i = 0; i < s_sensor_count; ++i) {
+        const sensor_entry_t *entry = &s_sensors[i];
+        if (!entry->reader) {
+            continue;
+        }
+        for (uint8_t c = 0; c < entry->channel_count; ++c) {
+            s_batch_channels[s_batch_channel_count++] = (telemetry_batch_channel_t){
+                .group = entry->name,
+                .key = entry->channels[c].key,
+                .decimals = entry->channels[c].decimals,
+            };
+        }
+    }
+    s_batching = false;
+    if (s_batch_channel_count > 0) {
+        const telemetry_batch_config_t batch_config = {
+            .max_samples = CONFIG_SENSOR_MANAGER_BATCH_MAX_SAMPLES,
+            .max_age_ms = CONFIG_SENSOR_MANAGER_BATCH_MAX_AGE_MS,
+            .max_bytes = CONFIG_SENSOR_MANAGER_BATCH_MAX_BYTES,
+        };
+        esp_err_t err = telemetry_batch_init(s_batch_channels, s_batch_channel_count, &batch_config);
+        if (err == ESP_OK) {
+            s_batching = true;
+        } else {
+            ESP_LOGW(SENSOR_MANAGER_TAG, "Telemetry batching disabled (%s)", esp_err_to_name(err));
+        }
+#if CONFIG_SENSOR_MANAGER_NIGHT_SUMMARY
+        if (s_batching) {
+            err = night_summary_init(s_batch_channels, s_batch_channel_count);
+            if (err != ESP_OK) {
+                ESP_LOGW(SENSOR_MANAGER_TAG, "Night summary disabled (%s)", esp_err_to_name(err));
+            }
+        }
+#endif
+#if CONFIG_SENSOR_MANAGER_HISTORY
+        if (s_batching) {
+            err = sensor_history_init(s_batch_channels, s_batch_channel_count);
+            if (err != ESP_OK) {
+                ESP_LOGW(SENSOR_MANAGER_TAG, "Sensor history disabled (%s)", esp_err_to_name(err));
+            }
+        }
+#endif
+    }
+#endif
+
     s_should_run = true;
-    BaseType_t created = xTaskCreate(sensor_manager_task,
-                                     "sensor_manager",
-                                     SENSOR_MANAGER_TASK_STACK,
-                                     NULL,
-                                     SENSOR_MANAGER_TASK_PRIO,
-                                     &s_task_handle);
+    BaseType_t created = xTaskCreatePinnedToCore(sensor_manager_task,
+                                                 "sensor_manager",
+                                                 SENSOR_MANAGER_TASK_STACK,
+                                                 NULL,
+                                                 SENSOR_MANAGER_TASK_PRIO,
+                                                 &s_task_handle,
+                                                 CONFIG_SENSOR_MANAGER_TASK_CORE);
     ESP_RETURN_ON_FALSE(created == pdPASS,
                         ESP_ERR_NO_MEM,
                         SENSOR_MANAGER_TAG,
@@ -144,13 +324,28 @@ bool sensor_manager_is_running(void)
 static void sensor_manager_task(void *arg)
 {
     (void)arg;
-    const TickType_t delay_ticks = pdMS_TO_TICKS(s_publish_interval_ms);
-    TickType_t last_wake = xTaskGetTickCount();
+    TickType_t delay_ticks = pdMS_TO_TICKS(s_publish_interval_ms);
+    TickType_t next_wake = xTaskGetTickCount();
     s_running = true;
 
     while (s_should_run) {
-        sensor_manager_collect_and_publish();
-        vTaskDelayUntil(&last_wake, delay_ticks);
+        // A new interval also moves the period already waited for
+        TickType_t wanted = pdMS_TO_TICKS(__atomic_load_n(&s_publish_interval_ms, __ATOMIC_RELAXED));
+        if (wanted != delay_ticks) {
+            next_wake = next_wake - delay_ticks + wanted;
+            delay_ticks = wanted;
+        }
+        int32_t remaining = (int32_t)(next_wake - xTaskGetTickCount());
+        if (remaining <= 0) {
+            sensor_manager_collect_and_publish();
+            sensor_manager_batch_tick();
+            next_wake += delay_ticks;
+            continue;
+        }
+        // Sleep to the next period unless a sensor pushes a reading first
+        if (ulTaskNotifyTake(pdTRUE, (TickType_t)remaining) > 0) {
+            sensor_manager_push_notified();
+        }
     }
 
     s_running = false;
@@ -158,65 +353,343 @@ static void sensor_manager_task(void *arg)
     vTaskDelete(NULL);
 }
 
-static void sensor_manager_collect_and_publish(void)
+static bool sensor_manager_is_batched(const sensor_entry_t *entry)
 {
-    if (s_sensor_count == 0) {
+#if CONFIG_SENSOR_MANAGER_BATCH
+    return s_batching && entry->reader;
+#else
+    (void)entry;
+    return false;
+#endif
+}
+
+// One value per channel of entry, NAN where the sensor has no reading
+static void sensor_manager_read_channels(const sensor_entry_t *entry, float *values)
+{
+    for (uint8_t c = 0; c < entry->channel_count; ++c) {
+        values[c] = NAN;
+    }
+    if (!entry->reader(values)) {
+        for (uint8_t c = 0; c < entry->channel_count; ++c) {
+            values[c] = NAN;
+        }
+    }
+}
+
+// Channels that moved past their deadband, or whose heartbeat expired, become
+// the new reported value; the rest are replaced by the value last reported.
+// Returns true when any channel was reported.
+static bool sensor_manager_filter_channels(const sensor_entry_t *entry, float *values, uint32_t now_ms)
+{
+    bool due = false;
+    for (uint8_t c = 0; c < entry->channel_count; ++c) {
+        const sensor_manager_channel_t *channel = &entry->channels[c];
+        channel_state_t *state = &s_channel_state[entry->channel_base + c];
+        uint32_t interval = channel->max_interval_ms ? channel->max_interval_ms
+                                                     : CONFIG_SENSOR_MANAGER_HEARTBEAT_MS;
+        bool changed;
+        if (isnan(values[c]) || isnan(state->reported)) {
+            changed = isnan(values[c]) != isnan(state->reported);
+        } else {
+            changed = fabsf(values[c] - state->reported) > channel->deadband;
+        }
+        // A missing reading has nothing to repeat
+        bool expired = !isnan(values[c]) && (!state->seen || now_ms - state->reported_ms >= interval);
+        if (changed || expired) {
+            state->reported = values[c];
+            state->reported_ms = now_ms;
+            state->seen = true;
+            due = true;
+        } else {
+            values[c] = state->reported;
+        }
+    }
+    return due;
+}
+
+// Sensors with channels are published live only when one of them is due
+static bool sensor_manager_live_due(const sensor_entry_t *entry, uint32_t now_ms)
+{
+    if (!entry->reader) {
+        return true;
+    }
+    float values[SENSOR_MANAGER_MAX_CHANNELS];
+    sensor_manager_read_channels(entry, values);
+    return sensor_manager_filter_channels(entry, values, now_ms);
+}
+
+static void sensor_manager_batch_tick(void)
+{
+#if CONFIG_SENSOR_MANAGER_BATCH
+    if (!s_batching) {
         return;
     }
 
-    cJSON *root = cJSON_CreateObject();
-    if (!root) {
-        ESP_LOGE(SENSOR_MANAGER_TAG, "Failed to allocate JSON root");
+    float values[SENSOR_MANAGER_MAX_CHANNELS];
+    for (size_t i = 0; i < s_sensor_count; ++i) {
+        const sensor_entry_t *entry = &s_sensors[i];
+        if (entry->reader) {
+            sensor_manager_read_channels(entry, &values[entry->channel_base]);
+        }
+    }
+#if CONFIG_SENSOR_MANAGER_NIGHT_SUMMARY
+    // Every raw reading, before the deadband holds any back
+    night_summary_record(values);
+#endif
+#if CONFIG_SENSOR_MANAGER_HISTORY
+    float raw[SENSOR_MANAGER_MAX_CHANNELS];
+    memcpy(raw, values, sizeof(float) * s_batch_channel_count);
+#endif
+
+    // A period where nothing is due adds no row; the decoder holds the last one
+    uint32_t now_ms = esp_log_timestamp();
+    bool due = false;
+    for (size_t i = 0; i < s_sensor_count; ++i) {
+        const sensor_entry_t *entry = &s_sensors[i];
+        if (entry->reader) {
+            due |= sensor_manager_filter_channels(entry, &values[entry->channel_base], now_ms);
+        }
+    }
+    if (due) {
+        telemetry_batch_record(values);
+    }
+#if CONFIG_SENSOR_MANAGER_HISTORY
+    sensor_history_record(raw, values);
+#endif
+    telemetry_batch_poll();
+
+    // Oldest first; a failed send leaves the batch for the next period
+    const uint8_t *data;
+    size_t len;
+    for (int sent = 0; sent < SENSOR_MANAGER_BATCH_SENDS_PER_TICK && telemetry_batch_peek(&data, &len); ++sent) {
+        esp_err_t err = somnus_mqtt_publish_telemetry_batch(data, len);
+        if (err != ESP_OK) {
+            ESP_LOGD(SENSOR_MANAGER_TAG, "Batch publish deferred (%s)", esp_err_to_name(err));
+            break;
+        }
+        telemetry_batch_pop();
+    }
+#endif
+}
+
+// Only built when something consumes it: the observer, or a sensor with no encode_cb
+static cJSON *sensor_manager_sample_json(const sensor_entry_t *entry)
+{
+    cJSON *sensor_obj = cJSON_CreateObject();
+    if (!sensor_obj) {
+        ESP_LOGW(SENSOR_MANAGER_TAG, "Failed to allocate JSON object for sensor '%s'", entry->name);
+        return NULL;
+    }
+    if (!entry->callback(sensor_obj) || !sensor_obj->child) {
+        cJSON_Delete(sensor_obj);
+        return NULL;
+    }
+    return sensor_obj;
+}
+
+// Sensors flagged by sensor_manager_notify() go to the observer right away
+static void sensor_manager_push_notified(void)
+{
+    uint32_t pending = __atomic_exchange_n(&s_notify_pending, 0, __ATOMIC_ACQUIRE);
+    if (!s_observer_cb) {
+        return;
+    }
+    for (size_t i = 0; i < s_sensor_count; ++i) {
+        if (!(pending & (1u << i))) {
+            continue;
+        }
+        cJSON *sensor_obj = sensor_manager_sample_json(&s_sensors[i]);
+        if (sensor_obj) {
+            s_observer_cb(s_sensors[i].name, sensor_obj, s_observer_ctx);
+            cJSON_Delete(sensor_obj);
+        }
+    }
+}
+
+#if CONFIG_SENSOR_MANAGER_TELEMETRY_CBOR
+// cJSON tree to CBOR, for sensors without an encode_cb
+static void sensor_manager_json_to_cbor(telemetry_cbor_t *enc, const cJSON *item)
+{
+    if (cJSON_IsObject(item)) {
+        telemetry_cbor_map_begin(enc);
+        for (const cJSON *child = item->child; child; child = child->next) {
+            telemetry_cbor_text(enc, child->string);
+            sensor_manager_json_to_cbor(enc, child);
+        }
+        telemetry_cbor_map_end(enc);
+    } else if (cJSON_IsNumber(item)) {
+        telemetry_cbor_number(enc, item->valuedouble);
+    } else if (cJSON_IsBool(item)) {
+        telemetry_cbor_bool(enc, cJSON_IsTrue(item));
+    } else if (cJSON_IsString(item)) {
+        telemetry_cbor_text(enc, item->valuestring);
+    } else {
+        // Arrays and null are not produced by any sensor; keep the map well formed
+        telemetry_cbor_bool(enc, false);
+    }
+}
+
+static void sensor_manager_collect_and_publish(void)
+{
+    if (s_sensor_count == 0) {
         return;
     }
 
+    telemetry_cbor_t enc;
+    telemetry_cbor_init(&enc, s_payload, sizeof(s_payload));
+    telemetry_cbor_map_begin(&enc);
+    telemetry_cbor_put_int(&enc, "v", SENSOR_MANAGER_TELEMETRY_SCHEMA);
     const char *device_id = somnus_mqtt_get_device_id();
     if (device_id) {
-        cJSON_AddStringToObject(root, "deviceId", device_id);
+        telemetry_cbor_put_text(&enc, "deviceId", device_id);
     }
-    cJSON_AddNumberToObject(root, "timestamp_ms", (double)esp_log_timestamp());
+    uint32_t now_ms = esp_log_timestamp();
+    telemetry_cbor_put_int(&enc, "timestamp_ms", now_ms);
 
     bool has_data = false;
 
     for (size_t i = 0; i < s_sensor_count; ++i) {
         const sensor_entry_t *entry = &s_sensors[i];
-        cJSON *sensor_obj = cJSON_CreateObject();
-        if (!sensor_obj) {
-            ESP_LOGW(SENSOR_MANAGER_TAG, "Failed to allocate JSON object for sensor '%s'", entry->name);
+        bool publish = !sensor_manager_is_batched(entry) && sensor_manager_live_due(entry, now_ms);
+        if (!publish && !s_observer_cb) {
             continue;
         }
-
-        bool ok = entry->callback(sensor_obj);
-        if (ok && sensor_obj->child) {
-            cJSON_AddItemToObject(root, entry->name, sensor_obj);
-            has_data = true;
+        cJSON *sensor_obj = NULL;
+        if (s_observer_cb || !entry->encoder) {
+            sensor_obj = sensor_manager_sample_json(entry);
+            if (!sensor_obj) {
+                continue;
+            }
             if (s_observer_cb) {
                 s_observer_cb(entry->name, sensor_obj, s_observer_ctx);
             }
-        } else {
+        }
+        if (!publish) {
             cJSON_Delete(sensor_obj);
+            continue;
+        }
+
+        // A sensor that writes nothing is dropped by rewinding to before its key
+        size_t mark = enc.len;
+        telemetry_cbor_text(&enc, entry->name);
+        bool ok = true;
+        if (entry->encoder) {
+            telemetry_cbor_map_begin(&enc);
+            size_t body = enc.len;
+            ok = entry->encoder(&enc) && enc.len > body;
+            telemetry_cbor_map_end(&enc);
+        } else {
+            sensor_manager_json_to_cbor(&enc, sensor_obj);
         }
+        cJSON_Delete(sensor_obj);
+        if (!ok) {
+            enc.len = mark;
+            continue;
+        }
+        has_data = true;
     }
+    telemetry_cbor_map_end(&enc);
 
     if (!has_data) {
-        cJSON_Delete(root);
         return;
     }
+    if (enc.overflow) {
+        ESP_LOGW(SENSOR_MANAGER_TAG, "Telemetry payload exceeds %u bytes, dropped", (unsigned)sizeof(s_payload));
+        return;
+    }
+
+    esp_err_t err = somnus_mqtt_publish_telemetry_binary(s_payload, enc.len);
+    if (err != ESP_OK) {
+        ESP_LOGW(SENSOR_MANAGER_TAG,
+                 "Telemetry publish failed (%s)",
+                 esp_err_to_name(err));
+    }
+}
+
+#else
+
+// cJSON sensor object into the telemetry document
+static void sensor_manager_json_to_writer(json_writer_t *w, const char *key, const cJSON *item)
+{
+    if (cJSON_IsObject(item)) {
+        json_writer_begin_object(w, key);
+        for (const cJSON *child = item->child; child; child = child->next) {
+            sensor_manager_json_to_writer(w, child->string, child);
+        }
+        json_writer_end_object(w);
+    } else if (cJSON_IsArray(item)) {
+        json_writer_begin_array(w, key);
+        for (const cJSON *child = item->child; child; child = child->next) {
+            sensor_manager_json_to_writer(w, NULL, child);
+        }
+        json_writer_end_array(w);
+    } else if (cJSON_IsNumber(item)) {
+        json_writer_double(w, key, item->valuedouble);
+    } else if (cJSON_IsBool(item)) {
+        json_writer_bool(w, key, cJSON_IsTrue(item));
+    } else if (cJSON_IsString(item)) {
+        json_writer_string(w, key, item->valuestring);
+    } else {
+        json_writer_null(w, key);
+    }
+}
+
+static void sensor_manager_collect_and_publish(void)
+{
+    if (s_sensor_count == 0) {
+        return;
+    }
+
+    // The document is written into s_payload as it goes; only each sensor's own sample is a cJSON tree
+    json_writer_t w;
+    json_writer_init(&w, s_payload, sizeof(s_payload));
+    json_writer_begin_object(&w, NULL);
+    const char *device_id = somnus_mqtt_get_device_id();
+    if (device_id) {
+        json_writer_string(&w, "deviceId", device_id);
+    }
+    uint32_t now_ms = esp_log_timestamp();
+    json_writer_int(&w, "timestamp_ms", now_ms);
 
-    char *payload = cJSON_PrintUnformatted(root);
-    cJSON_Delete(root);
+    bool has_data = false;
 
-    if (!payload) {
-        ESP_LOGW(SENSOR_MANAGER_TAG, "Failed to serialise telemetry payload");
+    for (size_t i = 0; i < s_sensor_count; ++i) {
+        const sensor_entry_t *entry = &s_sensors[i];
+        bool publish = !sensor_manager_is_batched(entry) && sensor_manager_live_due(entry, now_ms);
+        if (!publish && !s_observer_cb) {
+            continue;
+        }
+        cJSON *sensor_obj = sensor_manager_sample_json(entry);
+        if (!sensor_obj) {
+            continue;
+        }
+        if (s_observer_cb) {
+            s_observer_cb(entry->name, sensor_obj, s_observer_ctx);
+        }
+        if (publish) {
+            sensor_manager_json_to_writer(&w, entry->name, sensor_obj);
+            has_data = true;
+        }
+        cJSON_Delete(sensor_obj);
+    }
+    json_writer_end_object(&w);
+
+    if (!has_data) {
+        return;
+    }
+    size_t len = 0;
+    if (json_writer_finish(&w, &len) != ESP_OK) {
+        ESP_LOGW(SENSOR_MANAGER_TAG, "Telemetry payload of %u bytes exceeds %u, dropped", (unsigned)len,
+                 (unsigned)sizeof(s_payload));
         return;
     }
 
-    esp_err_t err = somnus_mqtt_publish_telemetry(payload);
+    esp_err_t err = somnus_mqtt_publish_telemetry(s_payload);
     if (err != ESP_OK) {
         ESP_LOGW(SENSOR_MANAGER_TAG,
                  "Telemetry publish failed (%s)",
                  esp_err_to_name(err));
     }
-    free(payload);
 }
 
+#endif
@@ -0,0 +1,343 @@
+/**
+ * @file telemetry_batch.c
+ */
+
+#include "telemetry_batch.h"
+
+#include <math.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "esp_attr.h"
+#include "esp_check.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "sdkconfig.h"
+
+#define TELEMETRY_BATCH_TAG "telemetry_batch"
+
+#ifndef CONFIG_SENSOR_MANAGER_BATCH_STORE_BYTES
+#define CONFIG_SENSOR_MANAGER_BATCH_STORE_BYTES 6144
+#endif
+
+#define STORE_MAGIC 0x54424154u        // "TBAT"
+#define FLAG_EPOCH 0x01
+#define LEN_PREFIX 2
+// Time delta, present mask, changed mask and one delta per channel, as varints
+#define ROW_MAX_BYTES (5 + 3 + 3 + 5 * TELEMETRY_BATCH_MAX_CHANNELS)
+// Wall-clock times before this are an unset clock
+#define EPOCH_VALID_MS 1600000000000LL
+#define MAX_DECIMALS 6
+
+typedef struct {
+    uint32_t magic;
+    uint32_t layout;                  // Hash of the channel set the batches were written with
+    uint16_t used;                    // Bytes of sealed batches, each behind a u16 length
+    uint16_t open_len;                // Bytes of the open batch after them; 0 when none is open
+    uint16_t open_rows;
+    uint16_t open_count_at;           // Offset of its sample count within the batch
+    uint8_t open_flags;
+    uint32_t open_present;
+    int64_t open_base_ms;
+    int64_t last_ms;
+    int32_t prev[TELEMETRY_BATCH_MAX_CHANNELS];
+    uint8_t data[CONFIG_SENSOR_MANAGER_BATCH_STORE_BYTES];
+} batch_store_t;
+
+// Survives software resets and panics; validated against the magic and layout on init
+static RTC_NOINIT_ATTR batch_store_t s_store;
+
+static const telemetry_batch_channel_t *s_channels;
+static size_t s_channel_count;
+static telemetry_batch_config_t s_cfg;
+static uint32_t s_dropped;
+
+static const float POW10[MAX_DECIMALS + 1] = {1.0f, 10.0f, 100.0f, 1e3f, 1e4f, 1e5f, 1e6f};
+
+static uint32_t layout_hash(void)
+{
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < s_channel_count; ++i) {
+        const telemetry_batch_channel_t *ch = &s_channels[i];
+        for (const char *p = ch->group; *p; ++p) {
+            h = (h ^ (uint8_t)*p) * 16777619u;
+        }
+        h = (h ^ '.') * 16777619u;
+        for (const char *p = ch->key; *p; ++p) {
+            h = (h ^ (uint8_t)*p) * 16777619u;
+        }
+        h = (h ^ ch->decimals) * 16777619u;
+    }
+    return h ^ CONFIG_SENSOR_MANAGER_BATCH_STORE_BYTES;
+}
+
+static int64_t now_ms(uint8_t *flags)
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    int64_t wall_ms = (int64_t)tv.tv_sec * 1000 + tv.tv_usec / 1000;
+    if (wall_ms >= EPOCH_VALID_MS) {
+        *flags = FLAG_EPOCH;
+        return wall_ms;
+    }
+    *flags = 0;
+    return esp_timer_get_time() / 1000;
+}
+
+static size_t put_varint(uint8_t *out, uint32_t value)
+{
+    size_t n = 0;
+    while (value >= 0x80) {
+        out[n++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    out[n++] = (uint8_t)value;
+    return n;
+}
+
+static uint32_t zigzag(int32_t value)
+{
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+static uint8_t *open_batch(void)
+{
+    return s_store.data + s_store.used + LEN_PREFIX;
+}
+
+static void drop_oldest(void)
+{
+    uint16_t len;
+    memcpy(&len, s_store.data, sizeof(len));
+    size_t gone = LEN_PREFIX + len;
+    size_t tail = s_store.used - gone + (s_store.open_len ? LEN_PREFIX + s_store.open_len : 0);
+    memmove(s_store.data, s_store.data + gone, tail);
+    s_store.used -= gone;
+}
+
+static void seal(void)
+{
+    if (s_store.open_len == 0) {
+        return;
+    }
+    if (s_store.open_rows == 0) {
+        s_store.open_len = 0;
+        return;
+    }
+    uint8_t *batch = open_batch();
+    batch[s_store.open_count_at] = (uint8_t)s_store.open_rows;
+    batch[s_store.open_count_at + 1] = (uint8_t)(s_store.open_rows >> 8);
+    memcpy(s_store.data + s_store.used, &s_store.open_len, sizeof(uint16_t));
+    ESP_LOGD(TELEMETRY_BATCH_TAG, "Sealed %u samples in %u bytes", s_store.open_rows, s_store.open_len);
+    s_store.used += LEN_PREFIX + s_store.open_len;
+    s_store.open_len = 0;
+}
+
+// Room for len more bytes at the end of the open batch, dropping old batches if needed
+static bool reserve(size_t len)
+{
+    size_t open = LEN_PREFIX + s_store.open_len;
+    while (s_store.used + open + len > sizeof(s_store.data)) {
+        if (s_store.used == 0) {
+            return false;
+        }
+        drop_oldest();
+        s_dropped++;
+    }
+    return true;
+}
+
+static bool start_batch(int64_t base_ms, uint8_t flags)
+{
+    size_t header = 3 + 8 + 2;
+    for (size_t i = 0; i < s_channel_count; ++i) {
+        header += 2 + strlen(s_channels[i].group) + 1 + strlen(s_channels[i].key);
+    }
+    s_store.open_len = 0;
+    if (!reserve(header)) {
+        return false;
+    }
+    uint8_t *out = open_batch();
+    size_t n = 0;
+    out[n++] = TELEMETRY_BATCH_VERSION;
+    out[n++] = flags;
+    out[n++] = (uint8_t)s_channel_count;
+    for (size_t i = 0; i < s_channel_count; ++i) {
+        size_t group_len = strlen(s_channels[i].group);
+        size_t key_len = strlen(s_channels[i].key);
+        out[n++] = s_channels[i].decimals;
+        out[n++] = (uint8_t)(group_len + 1 + key_len);
+        memcpy(out + n, s_channels[i].group, group_len);
+        n += group_len;
+        out[n++] = '.';
+        memcpy(out + n, s_channels[i].key, key_len);
+        n += key_len;
+    }
+    uint64_t base = (uint64_t)base_ms;
+    for (int b = 0; b < 8; ++b) {
+        out[n++] = (uint8_t)(base >> (8 * b));
+    }
+    s_store.open_count_at = (uint16_t)n;
+    out[n++] = 0;
+    out[n++] = 0;
+
+    s_store.open_len = (uint16_t)n;
+    s_store.open_rows = 0;
+    s_store.open_flags = flags;
+    s_store.open_present = 0;
+    s_store.open_base_ms = base_ms;
+    s_store.last_ms = base_ms;
+    memset(s_store.prev, 0, sizeof(s_store.prev));
+    return true;
+}
+
+static size_t encode_row(uint8_t *out, int64_t at_ms, const float *values, int32_t *scaled)
+{
+    uint32_t present = 0;
+    uint32_t changed = 0;
+    for (size_t i = 0; i < s_channel_count; ++i) {
+        if (isnan(values[i])) {
+            scaled[i] = s_store.prev[i];
+            continue;
+        }
+        float v = roundf(values[i] * POW10[s_channels[i].decimals]);
+        v = fminf(fmaxf(v, (float)INT32_MIN), (float)INT32_MAX);
+        scaled[i] = (int32_t)v;
+        present |= 1u << i;
+        if (scaled[i] != s_store.prev[i]) {
+            changed |= 1u << i;
+        }
+    }
+    int64_t dt = at_ms - s_store.last_ms;
+    uint32_t dt_ms = dt > (int64_t)(UINT32_MAX >> 1) ? (UINT32_MAX >> 1) : (uint32_t)dt;
+    bool mask_changed = present != s_store.open_present;
+
+    size_t n = put_varint(out, dt_ms << 1 | (mask_changed ? 1u : 0u));
+    if (mask_changed) {
+        n += put_varint(out + n, present);
+    }
+    n += put_varint(out + n, changed);
+    for (size_t i = 0; i < s_channel_count; ++i) {
+        if (changed & (1u << i)) {
+            n += put_varint(out + n, zigzag(scaled[i] - s_store.prev[i]));
+        }
+    }
+    s_store.open_present = present;
+    return n;
+}
+
+esp_err_t telemetry_batch_init(const telemetry_batch_channel_t *channels, size_t count,
+                               const telemetry_batch_config_t *config)
+{
+    ESP_RETURN_ON_FALSE(channels && count > 0 && count <= TELEMETRY_BATCH_MAX_CHANNELS && config,
+                        ESP_ERR_INVALID_ARG, TELEMETRY_BATCH_TAG, "bad channel set");
+    ESP_RETURN_ON_FALSE(config->max_samples > 0 && config->max_bytes >= 64 &&
+                        config->max_bytes <= sizeof(s_store.data) / 2,
+                        ESP_ERR_INVALID_ARG, TELEMETRY_BATCH_TAG, "bad batch limits");
+    for (size_t i = 0; i < count; ++i) {
+        ESP_RETURN_ON_FALSE(channels[i].group && channels[i].key && channels[i].decimals <= MAX_DECIMALS &&
+                            strlen(channels[i].group) + 1 + strlen(channels[i].key) <= UINT8_MAX,
+                            ESP_ERR_INVALID_ARG, TELEMETRY_BATCH_TAG, "bad channel %u", (unsigned)i);
+    }
+    s_channels = channels;
+    s_channel_count = count;
+    s_cfg = *config;
+
+    uint32_t layout = layout_hash();
+    bool intact = s_store.magic == STORE_MAGIC && s_store.layout == layout &&
+                  (size_t)s_store.used + (s_store.open_len ? LEN_PREFIX + s_store.open_len : 0) <=
+                      sizeof(s_store.data);
+    if (!intact) {
+        memset(&s_store, 0, offsetof(batch_store_t, data));
+        s_store.magic = STORE_MAGIC;
+        s_store.layout = layout;
+        return ESP_OK;
+    }
+    // The previous boot's open batch ends here; its timestamps do not continue
+    seal();
+    size_t batches = 0;
+    for (size_t at = 0; at < s_store.used; ++batches) {
+        uint16_t len;
+        memcpy(&len, s_store.data + at, sizeof(len));
+        at += LEN_PREFIX + len;
+    }
+    if (batches) {
+        ESP_LOGI(TELEMETRY_BATCH_TAG, "%u batches (%u bytes) kept from before reset", (unsigned)batches,
+                 (unsigned)s_store.used);
+    }
+    return ESP_OK;
+}
+
+void telemetry_batch_record(const float *values)
+{
+    if (!s_channels || !values) {
+        return;
+    }
+    uint8_t flags;
+    int64_t at_ms = now_ms(&flags);
+    // A clock that was set or stepped back starts a new batch
+    if (s_store.open_len &&
+        (flags != s_store.open_flags || at_ms < s_store.last_ms || s_store.open_rows >= s_cfg.max_samples)) {
+        seal();
+    }
+    if (!s_store.open_len && !start_batch(at_ms, flags)) {
+        return;
+    }
+
+    uint8_t row[ROW_MAX_BYTES];
+    int32_t scaled[TELEMETRY_BATCH_MAX_CHANNELS];
+    uint32_t present_before = s_store.open_present;
+    size_t n = encode_row(row, at_ms, values, scaled);
+    if (s_store.open_len + n > s_cfg.max_bytes && s_store.open_rows > 0) {
+        s_store.open_present = present_before;
+        seal();
+        if (!start_batch(at_ms, flags)) {
+            return;
+        }
+        n = encode_row(row, at_ms, values, scaled);
+    }
+    if (!reserve(n)) {
+        return;
+    }
+    memcpy(open_batch() + s_store.open_len, row, n);
+    s_store.open_len += (uint16_t)n;
+    s_store.open_rows++;
+    s_store.last_ms = at_ms;
+    memcpy(s_store.prev, scaled, sizeof(int32_t) * s_channel_count);
+}
+
+void telemetry_batch_poll(void)
+{
+    if (!s_store.open_len || s_store.open_rows == 0) {
+        return;
+    }
+    uint8_t flags;
+    int64_t at_ms = now_ms(&flags);
+    if (flags != s_store.open_flags || at_ms - s_store.open_base_ms >= (int64_t)s_cfg.max_age_ms) {
+        seal();
+    }
+}
+
+bool telemetry_batch_peek(const uint8_t **data, size_t *len)
+{
+    if (s_store.used == 0 || !data || !len) {
+        return false;
+    }
+    uint16_t batch_len;
+    memcpy(&batch_len, s_store.data, sizeof(batch_len));
+    *data = s_store.data + LEN_PREFIX;
+    *len = batch_len;
+    return true;
+}
+
+void telemetry_batch_pop(void)
+{
+    if (s_store.used) {
+        drop_oldest();
+    }
+}
+
+uint32_t telemetry_batch_dropped(void)
+{
+    return s_dropped;
+}
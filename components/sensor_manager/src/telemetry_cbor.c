@@ -0,0 +1,192 @@
+/**
+ * @file telemetry_cbor.c
+ */
+
+#include "telemetry_cbor.h"
+
+#include <math.h>
+#include <string.h>
+
+#define CBOR_MAJOR_UINT 0
+#define CBOR_MAJOR_NINT 1
+#define CBOR_MAJOR_TEXT 3
+
+#define CBOR_FALSE 0xF4
+#define CBOR_TRUE 0xF5
+#define CBOR_NULL 0xF6
+#define CBOR_HALF 0xF9
+#define CBOR_SINGLE 0xFA
+#define CBOR_ARRAY_INDEFINITE 0x9F
+#define CBOR_MAP_INDEFINITE 0xBF
+#define CBOR_BREAK 0xFF
+
+static void put_bytes(telemetry_cbor_t *enc, const void *data, size_t len)
+{
+    if (enc->overflow || enc->cap - enc->len < len) {
+        enc->overflow = true;
+        return;
+    }
+    if (len == 0) {
+        return;
+    }
+    memcpy(enc->buf + enc->len, data, len);
+    enc->len += len;
+}
+
+static void put_byte(telemetry_cbor_t *enc, uint8_t byte)
+{
+    put_bytes(enc, &byte, 1);
+}
+
+// Initial byte plus the shortest big-endian argument that holds value
+static void put_head(telemetry_cbor_t *enc, uint8_t major, uint64_t value)
+{
+    uint8_t head[9];
+    size_t len;
+    if (value < 24) {
+        head[0] = (uint8_t)(major << 5 | value);
+        len = 1;
+    } else if (value <= UINT8_MAX) {
+        head[0] = (uint8_t)(major << 5 | 24);
+        len = 2;
+    } else if (value <= UINT16_MAX) {
+        head[0] = (uint8_t)(major << 5 | 25);
+        len = 3;
+    } else if (value <= UINT32_MAX) {
+        head[0] = (uint8_t)(major << 5 | 26);
+        len = 5;
+    } else {
+        head[0] = (uint8_t)(major << 5 | 27);
+        len = 9;
+    }
+    for (size_t i = 1; i < len; ++i) {
+        head[i] = (uint8_t)(value >> (8 * (len - 1 - i)));
+    }
+    put_bytes(enc, head, len);
+}
+
+void telemetry_cbor_init(telemetry_cbor_t *enc, uint8_t *buf, size_t cap)
+{
+    enc->buf = buf;
+    enc->cap = buf ? cap : 0;
+    enc->len = 0;
+    enc->overflow = false;
+}
+
+void telemetry_cbor_map_begin(telemetry_cbor_t *enc)
+{
+    put_byte(enc, CBOR_MAP_INDEFINITE);
+}
+
+void telemetry_cbor_map_end(telemetry_cbor_t *enc)
+{
+    put_byte(enc, CBOR_BREAK);
+}
+
+void telemetry_cbor_array_begin(telemetry_cbor_t *enc)
+{
+    put_byte(enc, CBOR_ARRAY_INDEFINITE);
+}
+
+void telemetry_cbor_array_end(telemetry_cbor_t *enc)
+{
+    put_byte(enc, CBOR_BREAK);
+}
+
+void telemetry_cbor_text(telemetry_cbor_t *enc, const char *text)
+{
+    size_t len = text ? strlen(text) : 0;
+    put_head(enc, CBOR_MAJOR_TEXT, len);
+    put_bytes(enc, text, len);
+}
+
+void telemetry_cbor_int(telemetry_cbor_t *enc, int64_t value)
+{
+    if (value >= 0) {
+        put_head(enc, CBOR_MAJOR_UINT, (uint64_t)value);
+    } else {
+        put_head(enc, CBOR_MAJOR_NINT, (uint64_t)(-(value + 1)));
+    }
+}
+
+void telemetry_cbor_bool(telemetry_cbor_t *enc, bool value)
+{
+    put_byte(enc, value ? CBOR_TRUE : CBOR_FALSE);
+}
+
+void telemetry_cbor_null(telemetry_cbor_t *enc)
+{
+    put_byte(enc, CBOR_NULL);
+}
+
+// Half-precision bits for value, or false when it would lose precision
+static bool to_half(float value, uint16_t *half)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    uint16_t sign = (uint16_t)((bits >> 16) & 0x8000);
+    int32_t exp = (int32_t)((bits >> 23) & 0xFF);
+    uint32_t mant = bits & 0x7FFFFF;
+    if (exp == 0 && mant == 0) {
+        *half = sign;
+        return true;
+    }
+    if (exp == 0xFF) {
+        return false;
+    }
+    exp -= 127 - 15;
+    // Normal halves only, with the 13 dropped mantissa bits all zero
+    if (exp <= 0 || exp >= 31 || (mant & 0x1FFF) != 0) {
+        return false;
+    }
+    *half = (uint16_t)(sign | (uint16_t)exp << 10 | (uint16_t)(mant >> 13));
+    return true;
+}
+
+void telemetry_cbor_float(telemetry_cbor_t *enc, float value)
+{
+    uint16_t half;
+    if (to_half(value, &half)) {
+        uint8_t out[3] = {CBOR_HALF, (uint8_t)(half >> 8), (uint8_t)half};
+        put_bytes(enc, out, sizeof(out));
+        return;
+    }
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    uint8_t out[5] = {CBOR_SINGLE, (uint8_t)(bits >> 24), (uint8_t)(bits >> 16), (uint8_t)(bits >> 8),
+                      (uint8_t)bits};
+    put_bytes(enc, out, sizeof(out));
+}
+
+void telemetry_cbor_number(telemetry_cbor_t *enc, double value)
+{
+    if (value == floor(value) && fabs(value) < 9007199254740992.0) {
+        telemetry_cbor_int(enc, (int64_t)value);
+    } else {
+        telemetry_cbor_float(enc, (float)value);
+    }
+}
+
+void telemetry_cbor_put_int(telemetry_cbor_t *enc, const char *key, int64_t value)
+{
+    telemetry_cbor_text(enc, key);
+    telemetry_cbor_int(enc, value);
+}
+
+void telemetry_cbor_put_float(telemetry_cbor_t *enc, const char *key, float value)
+{
+    telemetry_cbor_text(enc, key);
+    telemetry_cbor_float(enc, value);
+}
+
+void telemetry_cbor_put_bool(telemetry_cbor_t *enc, const char *key, bool value)
+{
+    telemetry_cbor_text(enc, key);
+    telemetry_cbor_bool(enc, value);
+}
+
+void telemetry_cbor_put_text(telemetry_cbor_t *enc, const char *key, const char *value)
+{
+    telemetry_cbor_text(enc, key);
+    telemetry_cbor_text(enc, value);
+}
@@ -0,0 +1,72 @@
+/**
+ * @file slab_alloc.h
+ * @brief Size-class slab allocator for small, short-lived objects.
+ *
+ * One block of internal RAM, reserved at init, is cut into classes of
+ * fixed-size slots (16, 32, 48, 64, 128 and 256 bytes, slot counts from
+ * Kconfig). An allocation takes a slot of the smallest class that fits and
+ * a free puts it back, both in constant time, so small-object churn cannot
+ * fragment the general heap: whatever it does stays inside the reserved
+ * block.
+ *
+ * Each class keeps a short cache of free slots per core in front of its
+ * shared free list, so the two cores rarely take the same lock. Requests
+ * over 256 bytes, or for a class with no free slot, go to malloc(), and
+ * slab_free() recognises both kinds of block, so these calls replace
+ * malloc/calloc/realloc/free wherever a block is always released through
+ * slab_free(). Never pass a slab block to free(). Not for use from ISRs.
+ *
+ * Each class's slots in use are published as a metrics gauge
+ * ("slab16_used", ...), and slots that ran out as the "slab_fallbacks"
+ * counter.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SLAB_ALLOC_CLASSES 6
+
+// Largest request a slot can hold
+#define SLAB_ALLOC_MAX_SIZE 256
+
+typedef struct {
+    size_t slot_size;
+    size_t slots;
+    size_t in_use;
+    size_t peak;
+    uint32_t fallbacks;               // Requests this class could not serve
+} slab_alloc_class_stats_t;
+
+/**
+ * Reserve the slabs in internal RAM; once, early in app_main(). Until it
+ * has run (or when it failed) every call goes to the heap, and blocks
+ * allocated before it are still freed correctly.
+ *
+ * @return ESP_ERR_NO_MEM if internal RAM is short
+ */
+esp_err_t slab_alloc_init(void);
+
+void *slab_malloc(size_t size);
+void *slab_calloc(size_t count, size_t size);
+void *slab_realloc(void *ptr, size_t size);
+void slab_free(void *ptr);
+
+// The block came from a slab rather than the heap
+bool slab_owns(const void *ptr);
+
+// One entry per class, smallest first; zeroed before init
+void slab_alloc_get_stats(slab_alloc_class_stats_t out[SLAB_ALLOC_CLASSES]);
+
+#ifdef __cplusplus
+}
+#endif
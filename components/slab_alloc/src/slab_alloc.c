@@ -0,0 +1,325 @@
+/**
+ * @file slab_alloc.c
+ */
+
+#include "slab_alloc.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "metrics.h"
+
+#if CONFIG_SLAB_ALLOC_ENABLE
+
+static const char *TAG = "slab_alloc";
+
+// Free slots a core keeps for itself; it trades half of them with the shared list at a time
+#define CACHE_DEPTH 8
+#define SLOT_ALIGN 16
+
+typedef struct slot {
+    struct slot *next;
+} slot_t;
+
+typedef struct {
+    portMUX_TYPE lock;
+    uint32_t count;
+    slot_t *items[CACHE_DEPTH];
+} core_cache_t;
+
+typedef struct {
+    uint16_t size;
+    uint16_t slots;
+    const char *metric;
+    uint8_t *base;
+    portMUX_TYPE lock;                // Shared free list
+    slot_t *free_list;
+    core_cache_t cache[portNUM_PROCESSORS];
+    uint32_t in_use;
+    uint32_t peak;
+    uint32_t fallbacks;
+    metrics_gauge_t *gauge;
+} slab_class_t;
+
+static slab_class_t s_classes[SLAB_ALLOC_CLASSES] = {
+    {.size = 16, .slots = CONFIG_SLAB_ALLOC_SLOTS_16, .metric = "slab16_used"},
+    {.size = 32, .slots = CONFIG_SLAB_ALLOC_SLOTS_32, .metric = "slab32_used"},
+    {.size = 48, .slots = CONFIG_SLAB_ALLOC_SLOTS_48, .metric = "slab48_used"},
+    {.size = 64, .slots = CONFIG_SLAB_ALLOC_SLOTS_64, .metric = "slab64_used"},
+    {.size = 128, .slots = CONFIG_SLAB_ALLOC_SLOTS_128, .metric = "slab128_used"},
+    {.size = 256, .slots = CONFIG_SLAB_ALLOC_SLOTS_256, .metric = "slab256_used"},
+};
+
+static uint8_t *s_region;
+static size_t s_region_len;
+static metrics_counter_t *s_fallbacks;
+
+esp_err_t slab_alloc_init(void)
+{
+    if (s_region) {
+        return ESP_OK;
+    }
+    size_t total = 0;
+    for (size_t c = 0; c < SLAB_ALLOC_CLASSES; ++c) {
+        total += (size_t)s_classes[c].size * s_classes[c].slots;
+    }
+    if (total == 0) {
+        return ESP_OK;
+    }
+    uint8_t *region = heap_caps_aligned_alloc(SLOT_ALIGN, total, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (!region) {
+        ESP_LOGW(TAG, "No internal RAM for %u bytes of slabs; small allocations use the heap", (unsigned)total);
+        return ESP_ERR_NO_MEM;
+    }
+
+    uint8_t *p = region;
+    for (size_t c = 0; c < SLAB_ALLOC_CLASSES; ++c) {
+        slab_class_t *cls = &s_classes[c];
+        cls->base = p;
+        portMUX_INITIALIZE(&cls->lock);
+        for (size_t core = 0; core < portNUM_PROCESSORS; ++core) {
+            portMUX_INITIALIZE(&cls->cache[core].lock);
+        }
+        // Threaded back to front so the list hands out low addresses first
+        for (size_t i = cls->slots; i-- > 0;) {
+            slot_t *slot = (slot_t *)(p + i * cls->size);
+            slot->next = cls->free_list;
+            cls->free_list = slot;
+        }
+        p += (size_t)cls->size * cls->slots;
+        cls->gauge = metrics_gauge(cls->metric);
+        metrics_gauge_set(cls->gauge, 0);
+    }
+    s_fallbacks = metrics_counter("slab_fallbacks");
+    s_region_len = total;
+    // Published last: other tasks start using the slabs once they see it
+    __atomic_store_n(&s_region, region, __ATOMIC_RELEASE);
+    ESP_LOGI(TAG, "%u bytes of slabs in internal RAM", (unsigned)total);
+    return ESP_OK;
+}
+
+static slab_class_t *class_for_size(size_t size)
+{
+    if (!__atomic_load_n(&s_region, __ATOMIC_ACQUIRE) || size == 0 || size > SLAB_ALLOC_MAX_SIZE) {
+        return NULL;
+    }
+    for (size_t c = 0; c < SLAB_ALLOC_CLASSES; ++c) {
+        if (size <= s_classes[c].size && s_classes[c].slots) {
+            return &s_classes[c];
+        }
+    }
+    return NULL;
+}
+
+static slab_class_t *class_of(const void *ptr)
+{
+    const uint8_t *p = (const uint8_t *)ptr;
+    uint8_t *region = __atomic_load_n(&s_region, __ATOMIC_ACQUIRE);
+    if (!region || p < region || p >= region + s_region_len) {
+        return NULL;
+    }
+    for (size_t c = SLAB_ALLOC_CLASSES; c-- > 0;) {
+        if (p >= s_classes[c].base) {
+            return &s_classes[c];
+        }
+    }
+    return NULL;
+}
+
+// Pop one slot from this core's cache, refilled from the shared list when empty
+static slot_t *cache_pop(slab_class_t *cls, core_cache_t *cache)
+{
+    slot_t *slot = NULL;
+    portENTER_CRITICAL(&cache->lock);
+    if (cache->count == 0) {
+        portENTER_CRITICAL(&cls->lock);
+        while (cache->count < CACHE_DEPTH / 2 && cls->free_list) {
+            cache->items[cache->count++] = cls->free_list;
+            cls->free_list = cls->free_list->next;
+        }
+        portEXIT_CRITICAL(&cls->lock);
+    }
+    if (cache->count) {
+        slot = cache->items[--cache->count];
+    }
+    portEXIT_CRITICAL(&cache->lock);
+    return slot;
+}
+
+static void note_in_use(slab_class_t *cls, int32_t delta)
+{
+    uint32_t in_use = __atomic_add_fetch(&cls->in_use, (uint32_t)delta, __ATOMIC_RELAXED);
+    uint32_t peak = __atomic_load_n(&cls->peak, __ATOMIC_RELAXED);
+    while (in_use > peak && !__atomic_compare_exchange_n(&cls->peak, &peak, in_use, true, __ATOMIC_RELAXED,
+                                                         __ATOMIC_RELAXED)) {
+    }
+    metrics_gauge_set(cls->gauge, (int32_t)in_use);
+}
+
+static void *class_alloc(slab_class_t *cls)
+{
+    // A task moved to the other core meanwhile just uses that core's cache under its lock
+    size_t core = xPortGetCoreID();
+    slot_t *slot = cache_pop(cls, &cls->cache[core]);
+    // The shared list is empty; the last slots may sit in the other cores' caches
+    for (size_t other = 0; !slot && other < portNUM_PROCESSORS; ++other) {
+        if (other == core) {
+            continue;
+        }
+        core_cache_t *cache = &cls->cache[other];
+        portENTER_CRITICAL(&cache->lock);
+        if (cache->count) {
+            slot = cache->items[--cache->count];
+        }
+        portEXIT_CRITICAL(&cache->lock);
+    }
+    if (slot) {
+        note_in_use(cls, 1);
+    }
+    return slot;
+}
+
+static void class_free(slab_class_t *cls, void *ptr)
+{
+    core_cache_t *cache = &cls->cache[xPortGetCoreID()];
+    portENTER_CRITICAL(&cache->lock);
+    if (cache->count == CACHE_DEPTH) {
+        portENTER_CRITICAL(&cls->lock);
+        while (cache->count > CACHE_DEPTH / 2) {
+            slot_t *slot = cache->items[--cache->count];
+            slot->next = cls->free_list;
+            cls->free_list = slot;
+        }
+        portEXIT_CRITICAL(&cls->lock);
+    }
+    cache->items[cache->count++] = (slot_t *)ptr;
+    portEXIT_CRITICAL(&cache->lock);
+    note_in_use(cls, -1);
+}
+
+void *slab_malloc(size_t size)
+{
+    slab_class_t *cls = class_for_size(size);
+    if (!cls) {
+        return malloc(size);
+    }
+    void *ptr = class_alloc(cls);
+    if (!ptr) {
+        // The next larger classes are not tried: they are sized for their own objects
+        __atomic_fetch_add(&cls->fallbacks, 1, __ATOMIC_RELAXED);
+        metrics_counter_add(s_fallbacks, 1);
+        return malloc(size);
+    }
+    return ptr;
+}
+
+void slab_free(void *ptr)
+{
+    if (!ptr) {
+        return;
+    }
+    slab_class_t *cls = class_of(ptr);
+    if (!cls) {
+        free(ptr);
+        return;
+    }
+    if (((uint8_t *)ptr - cls->base) % cls->size != 0) {
+        ESP_LOGE(TAG, "%p is not the start of a %u-byte slot", ptr, (unsigned)cls->size);
+        abort();
+    }
+    class_free(cls, ptr);
+}
+
+void *slab_realloc(void *ptr, size_t size)
+{
+    if (!ptr) {
+        return slab_malloc(size);
+    }
+    if (size == 0) {
+        slab_free(ptr);
+        return NULL;
+    }
+    slab_class_t *cls = class_of(ptr);
+    if (!cls) {
+        // Heap blocks stay on the heap; their old size is not known here
+        return realloc(ptr, size);
+    }
+    if (size <= cls->size) {
+        return ptr;
+    }
+    void *moved = slab_malloc(size);
+    if (moved) {
+        memcpy(moved, ptr, cls->size);
+        class_free(cls, ptr);
+    }
+    return moved;
+}
+
+bool slab_owns(const void *ptr)
+{
+    return class_of(ptr) != NULL;
+}
+
+void slab_alloc_get_stats(slab_alloc_class_stats_t out[SLAB_ALLOC_CLASSES])
+{
+    bool ready = __atomic_load_n(&s_region, __ATOMIC_ACQUIRE) != NULL;
+    for (size_t c = 0; c < SLAB_ALLOC_CLASSES; ++c) {
+        const slab_class_t *cls = &s_classes[c];
+        out[c] = (slab_alloc_class_stats_t){
+            .slot_size = cls->size,
+            .slots = ready ? cls->slots : 0,
+            .in_use = __atomic_load_n(&cls->in_use, __ATOMIC_RELAXED),
+            .peak = __atomic_load_n(&cls->peak, __ATOMIC_RELAXED),
+            .fallbacks = __atomic_load_n(&cls->fallbacks, __ATOMIC_RELAXED),
+        };
+    }
+}
+
+#else
+
+esp_err_t slab_alloc_init(void)
+{
+    return ESP_OK;
+}
+
+void *slab_malloc(size_t size)
+{
+    return malloc(size);
+}
+
+void *slab_realloc(void *ptr, size_t size)
+{
+    return realloc(ptr, size);
+}
+
+void slab_free(void *ptr)
+{
+    free(ptr);
+}
+
+bool slab_owns(const void *ptr)
+{
+    return false;
+}
+
+void slab_alloc_get_stats(slab_alloc_class_stats_t out[SLAB_ALLOC_CLASSES])
+{
+    memset(out, 0, sizeof(slab_alloc_class_stats_t) * SLAB_ALLOC_CLASSES);
+}
+
+#endif
+
+void *slab_calloc(size_t count, size_t size)
+{
+    if (size && count > SIZE_MAX / size) {
+        return NULL;
+    }
+    void *ptr = slab_malloc(count * size);
+    if (ptr) {
+        memset(ptr, 0, count * size);
+    }
+    return ptr;
+}
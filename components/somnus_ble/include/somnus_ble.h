@@ -6,6 +6,8 @@
 #pragma once
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 
 #include "esp_err.h"
 
@@ -40,14 +42,42 @@ typedef bool (*somnus_ble_connect_wifi_cb_t)(const char *ssid,
  */
 typedef esp_err_t (*somnus_ble_device_command_cb_t)(const char *payload, void *ctx);
 
+/**
+ * @brief Callback for the SET_LED command (JSON or binary).
+ *
+ * Called from the BLE command task with the newest value only: slider writes
+ * that arrive while one is being applied are coalesced.
+ *
+ * @param rgb        Colour as {r, g, b}, or NULL to keep the current colour
+ * @param brightness 0.0 - 1.0, or negative to keep the current brightness
+ * @param ctx        Context pointer passed during configuration
+ */
+typedef esp_err_t (*somnus_ble_set_led_cb_t)(const uint8_t *rgb, float brightness, void *ctx);
+
+/**
+ * @brief Callback for the SET_VOLUME command (JSON or binary), coalesced like SET_LED.
+ *
+ * @param volume 0.0 - 1.0
+ * @param ctx    Context pointer passed during configuration
+ */
+typedef esp_err_t (*somnus_ble_set_volume_cb_t)(float volume, void *ctx);
+
 /**
  * @brief Configuration for the Somnus BLE service.
+ *
+ * Without @p set_led_cb / @p set_volume_cb, SET_LED and SET_VOLUME are
+ * forwarded to @p device_command_cb as the equivalent "LED",
+ * "SetLEDIntensity" or "SetVolume" Somnus action.
  */
 typedef struct {
     somnus_ble_connect_wifi_cb_t connect_cb; /**< Optional Wi-Fi connect handler. */
     void *connect_ctx;                       /**< Context pointer passed to @p connect_cb. */
     somnus_ble_device_command_cb_t device_command_cb; /**< Optional device command handler. */
     void *device_command_ctx;                /**< Context pointer passed to @p device_command_cb. */
+    somnus_ble_set_led_cb_t set_led_cb;      /**< Optional SET_LED handler. */
+    void *set_led_ctx;                       /**< Context pointer passed to @p set_led_cb. */
+    somnus_ble_set_volume_cb_t set_volume_cb; /**< Optional SET_VOLUME handler. */
+    void *set_volume_ctx;                    /**< Context pointer passed to @p set_volume_cb. */
 } somnus_ble_config_t;
 
 /**
@@ -65,6 +95,18 @@ esp_err_t somnus_ble_start(const somnus_ble_config_t *config);
  */
 esp_err_t somnus_ble_stop(void);
 
+/**
+ * @brief Give the shared 2.4 GHz radio to Wi-Fi while audio streams.
+ *
+ * Low duty advertises every CONFIG_SOMNUS_BLE_LOW_DUTY_ADV_MS instead of the
+ * stack's 30-60 ms, keeps a connected app on the idle interval with slave
+ * latency (bulk transfers included), and refuses Wi-Fi scans requested over
+ * BLE with a BUSY status (JSON: WIFI_LIST_BUSY between START and END).
+ * Applied in the NimBLE host task; callable from any task, before or after
+ * somnus_ble_start(). Repeated calls are no-ops.
+ */
+esp_err_t somnus_ble_set_low_duty(bool low_duty);
+
 /**
  * @brief Check if the Somnus BLE service is currently advertising/active.
  */
@@ -85,8 +127,10 @@ bool somnus_ble_is_advertising(void);
 /**
  * @brief Send a notification payload to the connected mobile app.
  *
- * Messages longer than the BLE MTU are chunked into 20-byte fragments to
- * remain compatible with the reference Somnus implementation.
+ * Messages are split into one notification per negotiated ATT MTU (MTU - 3
+ * bytes, up to 244 with the default preferred MTU of 247). With the default
+ * 23-byte MTU this is the reference Somnus 20-byte fragment. Multi-packet
+ * messages switch the link to a fast connection interval until it goes idle.
  *
  * @param message Null-terminated string to transmit.
  * @return ESP_OK if notification was queued for delivery, ESP_ERR_INVALID_STATE
@@ -94,6 +138,105 @@ bool somnus_ble_is_advertising(void);
  */
 esp_err_t somnus_ble_notify(const char *message);
 
+/**
+ * @brief What a bulk transfer carries, announced in its START frame.
+ */
+typedef enum {
+    SOMNUS_BLE_BULK_KIND_RAW = 0,
+    SOMNUS_BLE_BULK_KIND_BLE_LOGS = 1,
+    SOMNUS_BLE_BULK_KIND_RULES = 2,
+    SOMNUS_BLE_BULK_KIND_DIAGNOSTICS = 3,
+    SOMNUS_BLE_BULK_KIND_HISTORY = 4,          ///< sensor_history_export() layout
+} somnus_ble_bulk_kind_t;
+
+/**
+ * @brief Send a large payload over the flow-controlled bulk characteristic.
+ *
+ * Frames carry a 4-byte header (type, stream id, 16-bit sequence number) and
+ * fill the negotiated MTU. After START the app acknowledges with its highest
+ * in-order sequence number and a window of further frames it can take; the
+ * sender never runs past that window and keeps at most a few notifications
+ * with the stack, refilling on BLE_GAP_EVENT_NOTIFY_TX. Missing frames are
+ * resent from the last ack on a NACK or after a second of silence, so nothing
+ * is dropped silently. Wire format: docs/SOMNUS_BLE_PROTOCOLS.md.
+ *
+ * Blocks the calling task until the END frame is acknowledged. @p data must
+ * stay valid until then; frames are sliced from it without copying.
+ *
+ * @return ESP_OK once fully acknowledged; ESP_ERR_INVALID_STATE if the app is
+ *         not subscribed to the bulk characteristic or disconnects;
+ *         ESP_ERR_TIMEOUT (after sending ABORT) if @p timeout_ms elapses or
+ *         the app stops acknowledging.
+ */
+esp_err_t somnus_ble_bulk_send(somnus_ble_bulk_kind_t kind, const void *data, size_t len, uint32_t timeout_ms);
+
+/**
+ * @brief Check whether the connected app is subscribed to the bulk characteristic.
+ */
+bool somnus_ble_bulk_is_ready(void);
+
+/**
+ * @brief Serialize the BLE event log (connects, RX/TX, subscriptions) as JSON.
+ *
+ * @param out_json    Receives a string built by cJSON; release it with cJSON_free().
+ * @param max_entries Oldest entries to include, 0 for all.
+ */
+esp_err_t somnus_ble_get_logs(char **out_json, size_t max_entries);
+
+/**
+ * @brief Called with each BLE event log entry as it is recorded.
+ *
+ * Runs on whichever task logged the entry, often the NimBLE host task, so
+ * keep it short and do not call back into the BLE service. The log itself
+ * stores binary records; message is formatted for the callback only while
+ * one is set.
+ *
+ * @param type         Same names as in somnus_ble_get_logs(): "CONNECT", "RX", ...
+ */
+typedef void (*somnus_ble_log_cb_t)(const char *type, uint32_t timestamp_ms, const char *message, void *ctx);
+
+/**
+ * @brief Follow the BLE event log live instead of polling somnus_ble_get_logs().
+ *
+ * @param cb NULL to stop
+ */
+esp_err_t somnus_ble_set_log_cb(somnus_ble_log_cb_t cb, void *ctx);
+
+/**
+ * @brief Service counters and the current link, for load tests and field diagnostics.
+ *
+ * Counters run from boot or the last somnus_ble_reset_stats(); the link
+ * fields describe the connection now (zero when nothing is connected). The
+ * app reads the same values with the GET_STATS command.
+ */
+typedef struct {
+    uint32_t rx_writes;               ///< JSON writes on RX
+    uint32_t rx_bytes;
+    uint32_t bin_writes;              ///< Frames written to the binary characteristic
+    uint32_t bin_bytes;
+    uint32_t queue_drops;             ///< Writes refused because the command queue was full
+    uint32_t coalesced;               ///< SET_LED / SET_VOLUME writes replaced before they ran
+    uint32_t commands;                ///< Commands run by the command task
+    uint32_t notify_count;            ///< Notifications handed to the stack, all characteristics
+    uint32_t notify_bytes;
+    uint32_t notify_failures;         ///< Notifications the stack refused
+    uint32_t mbuf_waits;              ///< Sends that waited for the mbuf pool to refill
+    uint32_t mbuf_failures;           ///< ... and gave up
+    uint32_t bulk_frames;             ///< Bulk frames sent, retransmits included
+    uint32_t bulk_retransmits;
+    uint16_t mtu;                     ///< ATT MTU
+    uint8_t tx_phy;                   ///< 1 = 1M, 2 = 2M, 3 = coded
+    uint8_t rx_phy;
+    uint16_t conn_itvl;               ///< Connection interval, 1.25 ms units
+    uint16_t conn_latency;            ///< Peripheral latency, connection events
+    uint16_t supervision_tmo;         ///< 10 ms units
+} somnus_ble_stats_t;
+
+esp_err_t somnus_ble_get_stats(somnus_ble_stats_t *out);
+
+// Zeroes the counters; the link fields are kept
+void somnus_ble_reset_stats(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -5,11 +5,15 @@
 
 #include "somnus_ble.h"
 
+#include <inttypes.h>
+#include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
 #include <strings.h>
+#include <time.h>
 
 #include "cJSON.h"
+#include "deferred_log.h"
 #include "esp_bt.h"
 #include "esp_err.h"
 #include "esp_log.h"
@@ -27,6 +31,7 @@
 #include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/queue.h"
+#include "freertos/semphr.h"
 #include "freertos/task.h"
 #include "nimble/nimble_port.h"
 #include "nimble/nimble_port_freertos.h"
@@ -40,8 +45,10 @@
 #include "services/gap/ble_svc_gap.h"
 #include "services/gatt/ble_svc_gatt.h"
 
+#include "mem_tags.h"
 #include "somnus_profile.h"
 #ifdef CONFIG_SENSOR_MANAGER_ENABLED
+#include "sensor_history.h"
 #include "sensor_integration.h"
 #endif
 
@@ -51,19 +58,168 @@
 #define SOMNUS_BLE_QUEUE_LENGTH 6
 #define SOMNUS_BLE_TASK_STACK 4096
 #define SOMNUS_BLE_TASK_PRIO 5
+#ifndef CONFIG_SOMNUS_BLE_TASK_CORE
+#define CONFIG_SOMNUS_BLE_TASK_CORE 0
+#endif
 
+// Reference Somnus chunk size, and what a 23-byte default MTU leaves anyway
 #define SOMNUS_BLE_NOTIFY_CHUNK 20
+#define SOMNUS_BLE_ATT_NOTIFY_HDR 3
+#define SOMNUS_BLE_MBUF_RETRIES 40
+#define SOMNUS_BLE_MBUF_RETRY_MS 5
+#ifndef CONFIG_SOMNUS_BLE_PREFERRED_MTU
+#define CONFIG_SOMNUS_BLE_PREFERRED_MTU 247
+#endif
+#ifndef CONFIG_SOMNUS_BLE_BULK_IDLE_MS
+#define CONFIG_SOMNUS_BLE_BULK_IDLE_MS 2000
+#endif
+// Connection intervals in 1.25 ms units, supervision timeout in 10 ms units
+#define SOMNUS_BLE_BULK_ITVL_MIN 6     // 7.5 ms
+#define SOMNUS_BLE_BULK_ITVL_MAX 12    // 15 ms
+#define SOMNUS_BLE_IDLE_ITVL_MIN 24    // 30 ms
+#define SOMNUS_BLE_IDLE_ITVL_MAX 40    // 50 ms
+#define SOMNUS_BLE_SUPERVISION_TMO 400 // 4 s
+// Low duty (see somnus_ble_set_low_duty()): slave latency on the idle interval
+#define SOMNUS_BLE_LOW_DUTY_LATENCY 4  // Radio up every 150-250 ms
+#ifndef CONFIG_SOMNUS_BLE_LOW_DUTY_ADV_MS
+#define CONFIG_SOMNUS_BLE_LOW_DUTY_ADV_MS 1000
+#endif
+// LE Data Length Extension maximum: 251 octets, 2120 us on the 1M PHY
+#define SOMNUS_BLE_DLE_TX_OCTETS 251
+#define SOMNUS_BLE_DLE_TX_TIME 2120
+// Bulk channel: see somnus_ble_bulk_send() and docs/SOMNUS_BLE_PROTOCOLS.md
+#define SOMNUS_BLE_BULK_HDR_LEN 4
+#define SOMNUS_BLE_BULK_MAX_INFLIGHT 4     // Notifications handed to the stack, not yet NOTIFY_TX
+#define SOMNUS_BLE_BULK_RETRY_MS 1000      // No ack progress for this long: go back to the last ack
+#define SOMNUS_BLE_BULK_MAX_RETRIES 5
+#define SOMNUS_BLE_BULK_FRAME_START 0x01
+#define SOMNUS_BLE_BULK_FRAME_DATA 0x02
+#define SOMNUS_BLE_BULK_FRAME_END 0x03
+#define SOMNUS_BLE_BULK_FRAME_ABORT 0x04
+#define SOMNUS_BLE_BULK_FRAME_ACK 0x81
+#define SOMNUS_BLE_BULK_FRAME_NACK 0x82
+// Binary command channel: see somnus_ble_handle_binary() and docs/SOMNUS_BLE_PROTOCOLS.md
+#define SOMNUS_BLE_BIN_REQ_HDR_LEN 2       // [cmd][req_id]
+#define SOMNUS_BLE_BIN_RSP_HDR_LEN 3       // [cmd | 0x80][req_id][status]
+#define SOMNUS_BLE_BIN_RSP_FLAG 0x80
+#define SOMNUS_BLE_BIN_FRAME_MAX 128
+#define SOMNUS_BLE_CMD_SCAN 0x01
+#define SOMNUS_BLE_CMD_CONNECT_WIFI 0x02
+#define SOMNUS_BLE_CMD_READ_SENSORS 0x03
+#define SOMNUS_BLE_CMD_GET_LOGS 0x04
+#define SOMNUS_BLE_CMD_READ_HISTORY 0x05
+#define SOMNUS_BLE_CMD_SET_LED 0x10
+#define SOMNUS_BLE_CMD_SET_VOLUME 0x11
+#define SOMNUS_BLE_CMD_GET_STATS 0x20
+#define SOMNUS_BLE_CMD_SET_LINK 0x21
+#define SOMNUS_BLE_CMD_ECHO 0x22
+#define SOMNUS_BLE_BIN_OK 0x00
+#define SOMNUS_BLE_BIN_MORE 0x01           // Another response frame for the same request follows
+#define SOMNUS_BLE_BIN_INVALID_ARG 0x02
+#define SOMNUS_BLE_BIN_BUSY 0x03
+#define SOMNUS_BLE_BIN_UNSUPPORTED 0x04
+#define SOMNUS_BLE_BIN_FAILED 0x05
+#define SOMNUS_BLE_TLV_SSID 0x01
+#define SOMNUS_BLE_TLV_PASSWORD 0x02
+#define SOMNUS_BLE_TLV_USER_TOKEN 0x03
+#define SOMNUS_BLE_TLV_IS_PRODUCTION 0x04
+#define SOMNUS_BLE_TLV_RGB 0x10
+#define SOMNUS_BLE_TLV_BRIGHTNESS 0x11     // Percent, 0-100
+#define SOMNUS_BLE_TLV_VOLUME 0x12         // Percent, 0-100
+#define SOMNUS_BLE_TLV_FROM 0x13           // u32 little-endian, Unix seconds
+#define SOMNUS_BLE_TLV_TO 0x14
+#define SOMNUS_BLE_TLV_AP_SSID 0x20
+#define SOMNUS_BLE_TLV_AP_BSSID 0x21
+#define SOMNUS_BLE_TLV_AP_RSSI 0x22
+#define SOMNUS_BLE_TLV_AP_AUTH 0x23        // wifi_auth_mode_t
+#define SOMNUS_BLE_TLV_AP_CHANNEL 0x24
+#define SOMNUS_BLE_TLV_SENSOR_BASE 0x30    // int32 little-endian, value x100
+#define SOMNUS_BLE_TLV_DATA 0x40           // ECHO payload, returned as sent
+#define SOMNUS_BLE_TLV_SIZE 0x41           // u32 LE: ECHO reply length
+#define SOMNUS_BLE_TLV_BULK 0x42           // u8: ECHO over the bulk channel
+#define SOMNUS_BLE_TLV_RESET 0x43          // u8: GET_STATS zeroes the counters once read
+#define SOMNUS_BLE_TLV_INTERVAL 0x44       // u16 LE, 1.25 ms units, 0 = automatic
+#define SOMNUS_BLE_TLV_PHY 0x45            // u8: 1 = 1M, 2 = 2M
+#define SOMNUS_BLE_TLV_STATS_BASE 0x50     // u32 LE counters, in somnus_ble_stats_t order
+#define SOMNUS_BLE_TLV_LINK_BASE 0x60      // mtu, tx phy, rx phy, interval, latency, timeout
 #define SOMNUS_WIFI_SCAN_MAX_AP 20
 #define SOMNUS_BLE_LOG_MAX_ENTRIES 100
-#define SOMNUS_BLE_LOG_MSG_MAX_LEN 256
+#define SOMNUS_BLE_LOG_MSG_MAX_LEN 256     // Formatted message, on the reading side only
+#define SOMNUS_BLE_LOG_PREVIEW_LEN 80      // RX/TX text kept per entry
+#define SOMNUS_BLE_HISTORY_MAX_BYTES (64 * 1024)
+#define SOMNUS_BLE_HISTORY_DEFAULT_S (24 * 3600)
+#define SOMNUS_BLE_ECHO_MAX_BYTES 4096     // JSON reply on TX
+#define SOMNUS_BLE_ECHO_BULK_MAX_BYTES (64 * 1024)
+#define SOMNUS_BLE_PIN_ITVL_MIN 6          // 7.5 ms
+#define SOMNUS_BLE_PIN_ITVL_MAX 240        // 300 ms: inside the supervision timeout at low-duty latency
 
 #define SOMNUS_MIN(a, b) ((a) < (b) ? (a) : (b))
 
+typedef enum {
+    SOMNUS_BLE_MSG_JSON = 0,
+    SOMNUS_BLE_MSG_BINARY,
+    SOMNUS_BLE_MSG_LATEST,            ///< payload[0] names the s_bin_latest slot to run
+} somnus_ble_msg_kind_t;
+
 typedef struct {
+    somnus_ble_msg_kind_t kind;
     size_t len;
     char payload[SOMNUS_BLE_CMD_MAX_LEN + 1];
 } somnus_ble_cmd_msg_t;
 
+/*
+ * Arguments of a command, decoded from either JSON fields or binary TLVs so
+ * both encodings share one handler per command.
+ */
+typedef struct {
+    const char *ssid;
+    const char *password;
+    const char *user_token;
+    bool is_production;
+    bool has_rgb;
+    uint8_t rgb[3];
+    bool has_brightness;
+    float brightness;                 ///< 0..1
+    bool has_volume;
+    float volume;                     ///< 0..1
+    bool stream;                      ///< SCAN: report networks as each channel finishes
+    bool has_range;
+    uint32_t from_s;                  ///< READ_HISTORY range, Unix seconds
+    uint32_t to_s;
+    const uint8_t *data;              ///< ECHO payload, inside the request
+    size_t data_len;
+    uint32_t size;                    ///< ECHO reply length; shorter than the payload means the payload
+    bool bulk;                        ///< ECHO over the bulk channel
+    bool reset;                       ///< GET_STATS
+    bool has_interval;
+    uint16_t interval;                ///< SET_LINK, 1.25 ms units, 0 = automatic
+    uint8_t phy;                      ///< SET_LINK: 0 keep, 1 = 1M, 2 = 2M
+} somnus_ble_cmd_args_t;
+
+// Where a handler's answer goes: text notifications on TX or binary frames
+typedef struct {
+    bool binary;
+    uint8_t cmd;
+    uint8_t req_id;
+} somnus_ble_reply_t;
+
+typedef void (*somnus_ble_cmd_handler_t)(const somnus_ble_cmd_args_t *args, const somnus_ble_reply_t *reply);
+
+typedef struct {
+    uint8_t id;                       ///< Binary command byte
+    const char *action;               ///< JSON "action" value
+    somnus_ble_cmd_handler_t handler;
+} somnus_ble_cmd_def_t;
+
+// Receives each network of a streaming scan; an error stops the scan
+typedef esp_err_t (*somnus_ble_scan_emit_t)(const wifi_ap_record_t *rec, void *ctx);
+
+typedef struct {
+    uint8_t buf[SOMNUS_BLE_BIN_FRAME_MAX];
+    size_t len;
+    bool overflow;
+} somnus_ble_bin_frame_t;
+
 // BLE log entry
 typedef enum {
     BLE_LOG_CONNECT,
@@ -73,30 +229,67 @@ typedef enum {
     BLE_LOG_SUBSCRIBE,
 } ble_log_type_t;
 
+// What happened; each event has its type and message template in ble_log_format()
+typedef enum {
+    BLE_LOG_EV_STARTING,
+    BLE_LOG_EV_CONNECTED,             // conn
+    BLE_LOG_EV_CONNECT_FAILED,        // value = status
+    BLE_LOG_EV_DISCONNECTED,          // conn, value = reason
+    BLE_LOG_EV_RX_TEXT,               // len, preview
+    BLE_LOG_EV_TX_TEXT,               // len, preview
+    BLE_LOG_EV_RX_BIN,                // value = cmd, len
+    BLE_LOG_EV_NOTIFY,                // value = enabled
+} ble_log_event_t;
+
+// Binary record; the text is only made when someone reads the log
 typedef struct {
-    ble_log_type_t type;
+    uint32_t seq;                     // Claim ticket + 1 once complete, 0 while being written
     uint32_t timestamp_ms;
-    char message[SOMNUS_BLE_LOG_MSG_MAX_LEN];
+    int32_t value;
+    uint16_t conn;
+    uint16_t len;
+    uint8_t event;                    // ble_log_event_t
+    uint8_t preview_len;
+    char preview[SOMNUS_BLE_LOG_PREVIEW_LEN];
 } ble_log_entry_t;
 
-// BLE log ring buffer
+/*
+ * BLE log ring, without a lock: a writer claims the next ticket with an
+ * atomic increment and owns slot ticket % SOMNUS_BLE_LOG_MAX_ENTRIES. It
+ * clears the slot's seq, fills the entry and then publishes seq = ticket + 1.
+ * Readers copy a slot and keep it only if seq was the expected value both
+ * before and after the copy, so an entry overwritten mid-read is skipped
+ * rather than torn.
+ */
 typedef struct {
     ble_log_entry_t entries[SOMNUS_BLE_LOG_MAX_ENTRIES];
-    size_t head;
-    size_t count;
-    portMUX_TYPE lock;
+    uint32_t next;                    // Tickets claimed so far
 } ble_log_buffer_t;
 
 static somnus_ble_connect_wifi_cb_t s_connect_cb;
 static void *s_connect_ctx;
 static somnus_ble_device_command_cb_t s_device_command_cb;
 static void *s_device_command_ctx;
+static somnus_ble_set_led_cb_t s_set_led_cb;
+static void *s_set_led_ctx;
+static somnus_ble_set_volume_cb_t s_set_volume_cb;
+static void *s_set_volume_ctx;
+static somnus_ble_log_cb_t s_log_cb;
+static void *s_log_ctx;
 static bool s_started;
 static bool s_notify_enabled;
 static uint16_t s_conn_handle = BLE_HS_CONN_HANDLE_NONE;
 static uint16_t s_tx_val_handle;
 static uint8_t s_tx_buffer[512];
 static size_t s_tx_buffer_len = 0;
+static uint16_t s_att_mtu = BLE_ATT_MTU_DFLT;
+static bool s_bulk_fast;
+static esp_timer_handle_t s_bulk_timer;
+static bool s_low_duty;               // Written by any task (atomic), applied in the host task
+static uint16_t s_pinned_itvl;        // SET_LINK interval (atomic), 0 = automatic; cleared on disconnect
+static somnus_ble_stats_t s_stats;    // Counters by atomic add; link fields under s_state_lock
+
+#define SOMNUS_BLE_COUNT(field, n) __atomic_fetch_add(&s_stats.field, (uint32_t)(n), __ATOMIC_RELAXED)
 
 static TaskHandle_t s_cmd_task;
 static QueueHandle_t s_cmd_queue;
@@ -111,11 +304,55 @@ typedef struct {
 } notify_work_t;
 
 static QueueHandle_t s_notify_queue = NULL;
+// Posted to the host's event queue so notifications are sent in its context
+static struct ble_npl_event s_notify_ev;
+// Re-applies advertising or connection parameters after a duty change
+static struct ble_npl_event s_duty_ev;
 
 /* UUIDs in little-endian format for NimBLE macros */
 #define SOMNUS_UUID128_SERVICE BLE_UUID128_DECLARE(0x9E, 0xCA, 0xDC, 0x24, 0x0E, 0xE5, 0xA9, 0xE0, 0x93, 0xF3, 0xA3, 0xB5, 0x01, 0x00, 0x40, 0x6E)
 #define SOMNUS_UUID128_CHR_TX BLE_UUID128_DECLARE(0x9E, 0xCA, 0xDC, 0x24, 0x0E, 0xE5, 0xA9, 0xE0, 0x93, 0xF3, 0xA3, 0xB5, 0x03, 0x00, 0x40, 0x6E)
 #define SOMNUS_UUID128_CHR_RX BLE_UUID128_DECLARE(0x9E, 0xCA, 0xDC, 0x24, 0x0E, 0xE5, 0xA9, 0xE0, 0x93, 0xF3, 0xA3, 0xB5, 0x02, 0x00, 0x40, 0x6E)
+#define SOMNUS_UUID128_CHR_BULK BLE_UUID128_DECLARE(0x9E, 0xCA, 0xDC, 0x24, 0x0E, 0xE5, 0xA9, 0xE0, 0x93, 0xF3, 0xA3, 0xB5, 0x04, 0x00, 0x40, 0x6E)
+#define SOMNUS_UUID128_CHR_BIN BLE_UUID128_DECLARE(0x9E, 0xCA, 0xDC, 0x24, 0x0E, 0xE5, 0xA9, 0xE0, 0x93, 0xF3, 0xA3, 0xB5, 0x05, 0x00, 0x40, 0x6E)
+
+/*
+ * Bulk transfer state. The sender task owns the stream and its next frame;
+ * the host task records the peer's ack window and NOTIFY_TX completions under
+ * s_state_lock and wakes the sender through `wake`.
+ */
+typedef struct {
+    uint16_t val_handle;
+    bool subscribed;
+    bool active;
+    uint8_t stream;
+    bool acked_any;
+    uint32_t acked;                   ///< Highest frame the peer has in order
+    uint32_t window;                  ///< Frames the peer accepts beyond `acked`
+    bool nack;
+    uint32_t nack_from;
+    uint32_t inflight;
+    SemaphoreHandle_t wake;
+    SemaphoreHandle_t mutex;          ///< One transfer at a time
+} somnus_ble_bulk_t;
+
+static somnus_ble_bulk_t s_bulk;
+
+static uint16_t s_bin_val_handle;
+static bool s_bin_subscribed;
+
+/*
+ * Newest SET_LED / SET_VOLUME request. A slider writes once per step; each
+ * write overwrites its slot and only takes a command queue entry when none is
+ * pending, so a drag costs one handler run per value actually applied.
+ */
+typedef struct {
+    bool pending;
+    size_t len;
+    uint8_t frame[SOMNUS_BLE_BIN_FRAME_MAX];
+} somnus_ble_latest_t;
+
+static somnus_ble_latest_t s_bin_latest[2];
 
 static int somnus_ble_gap_event(struct ble_gap_event *event, void *arg);
 static void somnus_ble_start_advertising(void);
@@ -123,9 +360,17 @@ static void somnus_ble_on_sync(void);
 static void somnus_ble_host_task(void *param);
 static void somnus_ble_command_task(void *param);
 static void somnus_ble_handle_command(const char *payload);
-static void somnus_ble_handle_scan_action(void);
-static void somnus_ble_handle_connect_action(const cJSON *root);
-static void somnus_ble_handle_read_sensors_action(void);
+static void somnus_ble_handle_binary(const uint8_t *frame, size_t len);
+static void somnus_ble_handle_scan_action(const somnus_ble_cmd_args_t *args, const somnus_ble_reply_t *reply);
+static void somnus_ble_handle_connect_action(const somnus_ble_cmd_args_t *args, const somnus_ble_reply_t *reply);
+static void somnus_ble_handle_read_sensors_action(const somnus_ble_cmd_args_t *args, const somnus_ble_reply_t *reply);
+static void somnus_ble_handle_get_logs_action(const somnus_ble_cmd_args_t *args, const somnus_ble_reply_t *reply);
+static void somnus_ble_handle_read_history_action(const somnus_ble_cmd_args_t *args, const somnus_ble_reply_t *reply);
+static void somnus_ble_handle_set_led_action(const somnus_ble_cmd_args_t *args, const somnus_ble_reply_t *reply);
+static void somnus_ble_handle_set_volume_action(const somnus_ble_cmd_args_t *args, const somnus_ble_reply_t *reply);
+static void somnus_ble_handle_get_stats_action(const somnus_ble_cmd_args_t *args, const somnus_ble_reply_t *reply);
+static void somnus_ble_handle_set_link_action(const somnus_ble_cmd_args_t *args, const somnus_ble_reply_t *reply);
+static void somnus_ble_handle_echo_action(const somnus_ble_cmd_args_t *args, const somnus_ble_reply_t *reply);
 static int somnus_ble_rx_access_cb(uint16_t conn_handle,
                                    uint16_t attr_handle,
                                    struct ble_gatt_access_ctxt *ctxt,
@@ -134,43 +379,138 @@ static int somnus_ble_tx_access_cb(uint16_t conn_handle,
                                    uint16_t attr_handle,
                                    struct ble_gatt_access_ctxt *ctxt,
                                    void *arg);
+static int somnus_ble_bulk_access_cb(uint16_t conn_handle,
+                                     uint16_t attr_handle,
+                                     struct ble_gatt_access_ctxt *ctxt,
+                                     void *arg);
 static esp_err_t somnus_ble_send_chunked(const char *message,
                                          TickType_t inter_chunk_delay);
-static char *somnus_ble_perform_wifi_scan(size_t *out_len);
+static int somnus_ble_bin_access_cb(uint16_t conn_handle,
+                                    uint16_t attr_handle,
+                                    struct ble_gatt_access_ctxt *ctxt,
+                                    void *arg);
+static esp_err_t somnus_ble_scan_ap_records(wifi_ap_record_t **out_records, uint16_t *out_count);
+static esp_err_t somnus_ble_scan_stream(somnus_ble_scan_emit_t emit, void *ctx);
+static cJSON *somnus_ble_ap_record_to_json(const wifi_ap_record_t *rec);
+static char *somnus_ble_ap_records_to_json(const wifi_ap_record_t *records, uint16_t count);
+
+// Commands reachable both as JSON {"action": ...} on RX and as binary frames
+static const somnus_ble_cmd_def_t s_cmd_defs[] = {
+    {SOMNUS_BLE_CMD_SCAN, "SCAN", somnus_ble_handle_scan_action},
+    {SOMNUS_BLE_CMD_CONNECT_WIFI, "CONNECT_WIFI", somnus_ble_handle_connect_action},
+    {SOMNUS_BLE_CMD_READ_SENSORS, "READ_SENSORS", somnus_ble_handle_read_sensors_action},
+    {SOMNUS_BLE_CMD_GET_LOGS, "GET_LOGS", somnus_ble_handle_get_logs_action},
+    {SOMNUS_BLE_CMD_READ_HISTORY, "READ_HISTORY", somnus_ble_handle_read_history_action},
+    {SOMNUS_BLE_CMD_SET_LED, "SET_LED", somnus_ble_handle_set_led_action},
+    {SOMNUS_BLE_CMD_SET_VOLUME, "SET_VOLUME", somnus_ble_handle_set_volume_action},
+    {SOMNUS_BLE_CMD_GET_STATS, "GET_STATS", somnus_ble_handle_get_stats_action},
+    {SOMNUS_BLE_CMD_SET_LINK, "SET_LINK", somnus_ble_handle_set_link_action},
+    {SOMNUS_BLE_CMD_ECHO, "ECHO", somnus_ble_handle_echo_action},
+};
 
 // BLE log functions
 static void ble_log_init(void)
 {
-    s_ble_log.head = 0;
-    s_ble_log.count = 0;
-    portMUX_TYPE tmp = portMUX_INITIALIZER_UNLOCKED;
-    s_ble_log.lock = tmp;
+    for (size_t i = 0; i < SOMNUS_BLE_LOG_MAX_ENTRIES; i++) {
+        __atomic_store_n(&s_ble_log.entries[i].seq, 0, __ATOMIC_RELAXED);
+    }
+    __atomic_store_n(&s_ble_log.next, 0, __ATOMIC_RELEASE);
 }
 
-static void ble_log_add(ble_log_type_t type, const char *message)
+static const char *ble_log_type_name(ble_log_type_t type)
 {
-    if (!message) {
-        return;
+    switch (type) {
+    case BLE_LOG_CONNECT:
+        return "CONNECT";
+    case BLE_LOG_DISCONNECT:
+        return "DISCONNECT";
+    case BLE_LOG_RX:
+        return "RX";
+    case BLE_LOG_TX:
+        return "TX";
+    case BLE_LOG_SUBSCRIBE:
+        return "SUBSCRIBE";
+    }
+    return "UNKNOWN";
+}
+
+static ble_log_type_t ble_log_format(const ble_log_entry_t *entry, char *out, size_t size)
+{
+    switch ((ble_log_event_t)entry->event) {
+    case BLE_LOG_EV_STARTING:
+        snprintf(out, size, "BLE service starting");
+        return BLE_LOG_CONNECT;
+    case BLE_LOG_EV_CONNECTED:
+        snprintf(out, size, "Client connected (handle=%u)", entry->conn);
+        return BLE_LOG_CONNECT;
+    case BLE_LOG_EV_CONNECT_FAILED:
+        snprintf(out, size, "Connection failed (status=%d)", (int)entry->value);
+        return BLE_LOG_DISCONNECT;
+    case BLE_LOG_EV_DISCONNECTED:
+        snprintf(out, size, "Client disconnected (handle=%u, reason=%d)", entry->conn, (int)entry->value);
+        return BLE_LOG_DISCONNECT;
+    case BLE_LOG_EV_RX_TEXT:
+        snprintf(out, size, "RX[%u]: %.*s", entry->len, entry->preview_len, entry->preview);
+        return BLE_LOG_RX;
+    case BLE_LOG_EV_TX_TEXT:
+        snprintf(out, size, "TX[%u]: %.*s", entry->len, entry->preview_len, entry->preview);
+        return BLE_LOG_TX;
+    case BLE_LOG_EV_RX_BIN:
+        snprintf(out, size, "BIN RX cmd=0x%02x len=%u", (unsigned)entry->value, entry->len);
+        return BLE_LOG_RX;
+    case BLE_LOG_EV_NOTIFY:
+        snprintf(out, size, "Notifications %s", entry->value ? "enabled" : "disabled");
+        return BLE_LOG_SUBSCRIBE;
+    }
+    snprintf(out, size, "event %u", entry->event);
+    return BLE_LOG_CONNECT;
+}
+
+// Copy the entry for ticket into out; false if it was not complete or has been overwritten
+static bool ble_log_read(uint32_t ticket, ble_log_entry_t *out)
+{
+    const ble_log_entry_t *entry = &s_ble_log.entries[ticket % SOMNUS_BLE_LOG_MAX_ENTRIES];
+    if (__atomic_load_n(&entry->seq, __ATOMIC_ACQUIRE) != ticket + 1) {
+        return false;
     }
-    
-    portENTER_CRITICAL(&s_ble_log.lock);
-    
-    size_t idx = (s_ble_log.head + s_ble_log.count) % SOMNUS_BLE_LOG_MAX_ENTRIES;
-    ble_log_entry_t *entry = &s_ble_log.entries[idx];
-    
-    entry->type = type;
+    memcpy(out, entry, sizeof(*out));
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return __atomic_load_n(&entry->seq, __ATOMIC_RELAXED) == ticket + 1;
+}
+
+// Record an event; preview is RX/TX text, of which the first SOMNUS_BLE_LOG_PREVIEW_LEN bytes are kept
+static void ble_log_add(ble_log_event_t event, uint16_t conn, int32_t value, const char *preview, size_t len)
+{
+    uint32_t ticket = __atomic_fetch_add(&s_ble_log.next, 1, __ATOMIC_RELAXED);
+    ble_log_entry_t *entry = &s_ble_log.entries[ticket % SOMNUS_BLE_LOG_MAX_ENTRIES];
+
+    __atomic_store_n(&entry->seq, 0, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
     entry->timestamp_ms = (uint32_t)(esp_timer_get_time() / 1000);
-    strncpy(entry->message, message, SOMNUS_BLE_LOG_MSG_MAX_LEN - 1);
-    entry->message[SOMNUS_BLE_LOG_MSG_MAX_LEN - 1] = '\0';
-    
-    if (s_ble_log.count < SOMNUS_BLE_LOG_MAX_ENTRIES) {
-        s_ble_log.count++;
-    } else {
-        // Ring buffer full, overwrite oldest entry
-        s_ble_log.head = (s_ble_log.head + 1) % SOMNUS_BLE_LOG_MAX_ENTRIES;
+    entry->value = value;
+    entry->conn = conn;
+    entry->len = (uint16_t)SOMNUS_MIN(len, UINT16_MAX);
+    entry->event = (uint8_t)event;
+    entry->preview_len = preview ? (uint8_t)SOMNUS_MIN(len, SOMNUS_BLE_LOG_PREVIEW_LEN) : 0;
+    if (entry->preview_len) {
+        memcpy(entry->preview, preview, entry->preview_len);
+    }
+    __atomic_store_n(&entry->seq, ticket + 1, __ATOMIC_RELEASE);
+
+    // The live callback is the one reader that wants text as it happens
+    if (!__atomic_load_n(&s_log_cb, __ATOMIC_RELAXED)) {
+        return;
+    }
+    portENTER_CRITICAL(&s_state_lock);
+    somnus_ble_log_cb_t cb = s_log_cb;
+    void *cb_ctx = s_log_ctx;
+    portEXIT_CRITICAL(&s_state_lock);
+    ble_log_entry_t copy;
+    if (cb && ble_log_read(ticket, &copy)) {
+        char message[SOMNUS_BLE_LOG_MSG_MAX_LEN];
+        ble_log_type_t type = ble_log_format(&copy, message, sizeof(message));
+        cb(ble_log_type_name(type), copy.timestamp_ms, message, cb_ctx);
     }
-    
-    portEXIT_CRITICAL(&s_ble_log.lock);
 }
 
 static const struct ble_gatt_chr_def somnus_chr_defs[] = {
@@ -185,6 +525,20 @@ static const struct ble_gatt_chr_def somnus_chr_defs[] = {
         .access_cb = somnus_ble_rx_access_cb,
         .flags = BLE_GATT_CHR_F_WRITE,
     },
+    {
+        // Framed bulk data out by notification, acks back by write-without-response
+        .uuid = SOMNUS_UUID128_CHR_BULK,
+        .access_cb = somnus_ble_bulk_access_cb,
+        .flags = BLE_GATT_CHR_F_NOTIFY | BLE_GATT_CHR_F_WRITE_NO_RSP,
+        .val_handle = &s_bulk.val_handle,
+    },
+    {
+        // Binary TLV commands in, binary responses out by notification
+        .uuid = SOMNUS_UUID128_CHR_BIN,
+        .access_cb = somnus_ble_bin_access_cb,
+        .flags = BLE_GATT_CHR_F_WRITE | BLE_GATT_CHR_F_WRITE_NO_RSP | BLE_GATT_CHR_F_NOTIFY,
+        .val_handle = &s_bin_val_handle,
+    },
     {0},
 };
 
@@ -246,6 +600,8 @@ static int somnus_ble_rx_access_cb(uint16_t conn_handle,
         ESP_LOGW(SOMNUS_BLE_TAG, "[BLE RX] unexpected op %d", ctxt->op);
         return BLE_ATT_ERR_UNLIKELY;
     }
+    SOMNUS_BLE_COUNT(rx_writes, 1);
+    SOMNUS_BLE_COUNT(rx_bytes, pkt_len);
 
     somnus_ble_cmd_msg_t msg = {0};
     size_t copy_len = SOMNUS_MIN(pkt_len, SOMNUS_BLE_CMD_MAX_LEN);
@@ -261,11 +617,7 @@ static int somnus_ble_rx_access_cb(uint16_t conn_handle,
 
     ESP_LOGI(SOMNUS_BLE_TAG, "[BLE RX] payload[%zu]: %.*s", msg.len, (int)msg.len, msg.payload);
     
-    // Log RX event
-    char log_msg[SOMNUS_BLE_LOG_MSG_MAX_LEN];
-    size_t payload_display_len = msg.len > 80 ? 80 : msg.len;
-    snprintf(log_msg, sizeof(log_msg), "RX[%zu]: %.*s", msg.len, (int)payload_display_len, msg.payload);
-    ble_log_add(BLE_LOG_RX, log_msg);
+    ble_log_add(BLE_LOG_EV_RX_TEXT, conn_handle, 0, msg.payload, msg.len);
     
     // Log hex dump for non-printable or long messages
     if (msg.len > 64 || (msg.len > 0 && !strnlen(msg.payload, msg.len))) {
@@ -292,6 +644,7 @@ static int somnus_ble_rx_access_cb(uint16_t conn_handle,
     
     if (xQueueSend(s_cmd_queue, &msg, 0) != pdTRUE) {
         ESP_LOGW(SOMNUS_BLE_TAG, "[BLE RX] command queue full (spaces=%u), dropping payload", queue_space);
+        SOMNUS_BLE_COUNT(queue_drops, 1);
         somnus_ble_notify("Queue busy");
     } else {
         ESP_LOGD(SOMNUS_BLE_TAG, "[BLE RX] queued successfully (remaining spaces=%u)", uxQueueSpacesAvailable(s_cmd_queue));
@@ -351,6 +704,94 @@ esp_err_t somnus_ble_notify(const char *message)
     return somnus_ble_send_chunked(message, 0);
 }
 
+static void somnus_ble_set_conn_params(uint16_t conn, bool fast)
+{
+    // Low duty keeps even bulk transfers on the idle interval
+    bool low_duty = __atomic_load_n(&s_low_duty, __ATOMIC_ACQUIRE);
+    fast = fast && !low_duty;
+    // A SET_LINK interval holds through bulk transfers and idle alike
+    uint16_t pinned = __atomic_load_n(&s_pinned_itvl, __ATOMIC_ACQUIRE);
+    struct ble_gap_upd_params params = {
+        .itvl_min = pinned ? pinned : fast ? SOMNUS_BLE_BULK_ITVL_MIN : SOMNUS_BLE_IDLE_ITVL_MIN,
+        .itvl_max = pinned ? pinned : fast ? SOMNUS_BLE_BULK_ITVL_MAX : SOMNUS_BLE_IDLE_ITVL_MAX,
+        .latency = low_duty ? SOMNUS_BLE_LOW_DUTY_LATENCY : 0,
+        .supervision_timeout = SOMNUS_BLE_SUPERVISION_TMO,
+        .min_ce_len = 0,
+        .max_ce_len = 0,
+    };
+    int rc = ble_gap_update_params(conn, &params);
+    if (rc != 0) {
+        ESP_LOGD(SOMNUS_BLE_TAG, "[BLE] conn param update (%s) rc=%d", fast ? "fast" : "idle", rc);
+    }
+}
+
+static void somnus_ble_bulk_idle_cb(void *arg)
+{
+    (void)arg;
+    portENTER_CRITICAL(&s_state_lock);
+    uint16_t conn = s_conn_handle;
+    bool was_fast = s_bulk_fast;
+    s_bulk_fast = false;
+    portEXIT_CRITICAL(&s_state_lock);
+
+    if (was_fast && conn != BLE_HS_CONN_HANDLE_NONE) {
+        ESP_LOGI(SOMNUS_BLE_TAG, "[BLE] Bulk transfer idle, relaxing connection interval");
+        somnus_ble_set_conn_params(conn, false);
+    }
+}
+
+// Multi-packet transfers run at the fast interval until they go quiet
+static void somnus_ble_bulk_touch(uint16_t conn)
+{
+    portENTER_CRITICAL(&s_state_lock);
+    bool was_fast = s_bulk_fast;
+    s_bulk_fast = true;
+    portEXIT_CRITICAL(&s_state_lock);
+
+    if (!was_fast) {
+        somnus_ble_set_conn_params(conn, true);
+    }
+    if (s_bulk_timer) {
+        esp_timer_stop(s_bulk_timer);
+        esp_timer_start_once(s_bulk_timer, (uint64_t)CONFIG_SOMNUS_BLE_BULK_IDLE_MS * 1000);
+    }
+}
+
+static void somnus_ble_notify_drain(struct ble_npl_event *ev)
+{
+    (void)ev;
+    notify_work_t notify_work;
+    while (s_notify_queue && xQueueReceive(s_notify_queue, &notify_work, 0) == pdTRUE) {
+        // Consumes the mbuf whether or not it succeeds
+        uint16_t len = OS_MBUF_PKTLEN(notify_work.om);
+        int rc = ble_gatts_notify_custom(notify_work.conn_handle, notify_work.val_handle, notify_work.om);
+        if (rc != 0) {
+            ESP_LOGE(SOMNUS_BLE_TAG, "[BLE HOST TASK] ble_gatts_notify_custom failed: %d", rc);
+            SOMNUS_BLE_COUNT(notify_failures, 1);
+        } else {
+            SOMNUS_BLE_COUNT(notify_count, 1);
+            SOMNUS_BLE_COUNT(notify_bytes, len);
+        }
+    }
+}
+
+static struct os_mbuf *somnus_ble_mbuf_from_flat(const uint8_t *data, size_t len)
+{
+    // The msys pool refills as the controller acknowledges earlier packets
+    for (int attempt = 0; attempt < SOMNUS_BLE_MBUF_RETRIES; ++attempt) {
+        struct os_mbuf *om = ble_hs_mbuf_from_flat(data, len);
+        if (om) {
+            return om;
+        }
+        if (attempt == 0) {
+            SOMNUS_BLE_COUNT(mbuf_waits, 1);
+        }
+        vTaskDelay(pdMS_TO_TICKS(SOMNUS_BLE_MBUF_RETRY_MS));
+    }
+    SOMNUS_BLE_COUNT(mbuf_failures, 1);
+    return NULL;
+}
+
 static esp_err_t somnus_ble_send_chunked(const char *message,
                                          TickType_t inter_chunk_delay)
 {
@@ -362,6 +803,7 @@ static esp_err_t somnus_ble_send_chunked(const char *message,
     portENTER_CRITICAL(&s_state_lock);
     uint16_t conn = s_conn_handle;
     bool notify_enabled = s_notify_enabled;
+    uint16_t mtu = s_att_mtu;
     portEXIT_CRITICAL(&s_state_lock);
 
     if (!notify_enabled || conn == BLE_HS_CONN_HANDLE_NONE) {
@@ -370,71 +812,59 @@ static esp_err_t somnus_ble_send_chunked(const char *message,
                  notify_enabled, conn);
         return ESP_ERR_INVALID_STATE;
     }
+    if (s_notify_queue == NULL) {
+        ESP_LOGE(SOMNUS_BLE_TAG, "[BLE TX] Notification queue not initialized");
+        return ESP_ERR_INVALID_STATE;
+    }
 
-    ESP_LOGI(SOMNUS_BLE_TAG, "[BLE TX] sending message[%zu]: %.*s", len, (int)(len > 128 ? 128 : len), message);
+    // One notification per negotiated MTU; never below the reference 20 bytes
+    size_t chunk_max = mtu > SOMNUS_BLE_ATT_NOTIFY_HDR ? mtu - SOMNUS_BLE_ATT_NOTIFY_HDR : 0;
+    if (chunk_max < SOMNUS_BLE_NOTIFY_CHUNK) {
+        chunk_max = SOMNUS_BLE_NOTIFY_CHUNK;
+    }
+    if (chunk_max > sizeof(s_tx_buffer)) {
+        chunk_max = sizeof(s_tx_buffer);
+    }
+
+    DLOGI(SOMNUS_BLE_TAG, "[BLE TX] sending message[%zu] in %zu-byte chunks: %.*s",
+          len, chunk_max, (int)(len > 128 ? 128 : len), message);
     
-    // Log TX event
-    char log_msg[SOMNUS_BLE_LOG_MSG_MAX_LEN];
-    size_t msg_display_len = len > 80 ? 80 : len;
-    snprintf(log_msg, sizeof(log_msg), "TX[%zu]: %.*s", len, (int)msg_display_len, message);
-    ble_log_add(BLE_LOG_TX, log_msg);
+    ble_log_add(BLE_LOG_EV_TX_TEXT, conn, 0, message, len);
+
+    if (len > chunk_max) {
+        somnus_ble_bulk_touch(conn);
+    }
     
     const uint8_t *data = (const uint8_t *)message;
     size_t total_sent = 0;
     size_t chunk_num = 0;
+    size_t chunk_len = 0;
     
     while (len > 0) {
-        size_t chunk_len = len > SOMNUS_BLE_NOTIFY_CHUNK ? SOMNUS_BLE_NOTIFY_CHUNK : len;
-        ESP_LOGD(SOMNUS_BLE_TAG, "[BLE TX] chunk[%zu] len=%zu: %.*s", 
-                 chunk_num, chunk_len, (int)chunk_len, (const char *)data);
-        
-        // Store chunk in TX buffer for access callback
-        if (chunk_len > sizeof(s_tx_buffer)) {
-            ESP_LOGE(SOMNUS_BLE_TAG, "[BLE TX] chunk too large: %zu > %zu", chunk_len, sizeof(s_tx_buffer));
-            return ESP_ERR_INVALID_SIZE;
-        }
-        
-        portENTER_CRITICAL(&s_state_lock);
-        memcpy(s_tx_buffer, data, chunk_len);
-        s_tx_buffer_len = chunk_len;
-        portEXIT_CRITICAL(&s_state_lock);
-
-        ESP_LOGI(SOMNUS_BLE_TAG, "[BLE TX] Stored chunk[%zu] len=%zu, sending notification (conn=%u, handle=%u)", 
-                 chunk_num, chunk_len, conn, s_tx_val_handle);
+        chunk_len = len > chunk_max ? chunk_max : len;
+        DLOGD(SOMNUS_BLE_TAG, "[BLE TX] chunk[%zu] len=%zu: %.*s",
+              chunk_num, chunk_len, (int)chunk_len, (const char *)data);
 
-        // Allocate mbuf with the chunk data
-        // Note: ble_gatts_notify_custom consumes the mbuf on success, so we don't free it
-        struct os_mbuf *om = ble_hs_mbuf_from_flat(s_tx_buffer, chunk_len);
+        // The mbuf is filled straight from the caller's buffer
+        struct os_mbuf *om = somnus_ble_mbuf_from_flat(data, chunk_len);
         if (om == NULL) {
             ESP_LOGE(SOMNUS_BLE_TAG, "[BLE TX] Failed to allocate mbuf for notification");
             return ESP_ERR_NO_MEM;
         }
         
-        // Post notification work to the NimBLE host task
-        // GATT operations should be performed in the host task context
-        if (s_notify_queue == NULL) {
-            ESP_LOGE(SOMNUS_BLE_TAG, "[BLE TX] Notification queue not initialized");
-            os_mbuf_free_chain(om);
-            return ESP_ERR_INVALID_STATE;
-        }
-        
         notify_work_t notify_work = {
             .conn_handle = conn,
             .val_handle = s_tx_val_handle,
             .om = om
         };
         
+        // A full queue blocks the sender until the host task catches up
         if (xQueueSend(s_notify_queue, &notify_work, pdMS_TO_TICKS(100)) != pdTRUE) {
             ESP_LOGE(SOMNUS_BLE_TAG, "[BLE TX] Failed to queue notification work (queue full)");
             os_mbuf_free_chain(om);
             return ESP_ERR_NO_MEM;
         }
-        
-        ESP_LOGI(SOMNUS_BLE_TAG, "[BLE TX] Notification work queued (chunk %zu, %zu bytes)", 
-                 chunk_num, chunk_len);
-        
-        // Small delay to allow host task to process the notification
-        vTaskDelay(pdMS_TO_TICKS(20));
+        ble_npl_eventq_put(nimble_port_get_dflt_eventq(), &s_notify_ev);
 
         data += chunk_len;
         len -= chunk_len;
@@ -445,186 +875,812 @@ static esp_err_t somnus_ble_send_chunked(const char *message,
             vTaskDelay(inter_chunk_delay);
         }
     }
+
+    // Reads of the TX characteristic return the last chunk sent
+    portENTER_CRITICAL(&s_state_lock);
+    memcpy(s_tx_buffer, data - chunk_len, chunk_len);
+    s_tx_buffer_len = chunk_len;
+    portEXIT_CRITICAL(&s_state_lock);
     
-    ESP_LOGI(SOMNUS_BLE_TAG, "[BLE TX] sent %zu bytes in %zu chunks", total_sent, chunk_num);
+    DLOGI(SOMNUS_BLE_TAG, "[BLE TX] sent %zu bytes in %zu chunks", total_sent, chunk_num);
     return ESP_OK;
 }
 
-static void somnus_ble_host_task(void *param)
+static void somnus_ble_bulk_wake(void)
 {
-    (void)param;
-    
-    // Process notification queue in host task context
-    notify_work_t notify_work;
-    while (1) {
-        // Check for pending notifications (non-blocking)
-        if (s_notify_queue && xQueueReceive(s_notify_queue, &notify_work, pdMS_TO_TICKS(10)) == pdTRUE) {
-            ESP_LOGI(SOMNUS_BLE_TAG, "[BLE HOST TASK] Processing notification (conn=%u, handle=%u)", 
-                     notify_work.conn_handle, notify_work.val_handle);
-            
-            int rc = ble_gatts_notify_custom(notify_work.conn_handle, notify_work.val_handle, notify_work.om);
-            if (rc != 0) {
-                ESP_LOGE(SOMNUS_BLE_TAG, "[BLE HOST TASK] ble_gatts_notify_custom failed: %d", rc);
-                os_mbuf_free_chain(notify_work.om);
-            } else {
-                ESP_LOGI(SOMNUS_BLE_TAG, "[BLE HOST TASK] Notification sent successfully");
-                // mbuf is consumed by ble_gatts_notify_custom on success
-            }
-        }
-        
-        // Run NimBLE port (this blocks, so we check queue before each run)
-        nimble_port_run();
+    if (s_bulk.wake) {
+        xSemaphoreGive(s_bulk.wake);
     }
-    
-    nimble_port_freertos_deinit();
 }
 
-static esp_err_t somnus_ble_set_advertising_data(void)
+static int somnus_ble_bulk_access_cb(uint16_t conn_handle,
+                                     uint16_t attr_handle,
+                                     struct ble_gatt_access_ctxt *ctxt,
+                                     void *arg)
 {
-    struct ble_hs_adv_fields fields;
-    memset(&fields, 0, sizeof(fields));
-    
-    fields.flags = BLE_HS_ADV_F_DISC_GEN | BLE_HS_ADV_F_BREDR_UNSUP;
-    fields.tx_pwr_lvl_is_present = 0;
-    fields.name = (uint8_t *)SOMNUS_BLE_LOCAL_NAME;
-    fields.name_len = strlen(SOMNUS_BLE_LOCAL_NAME);
-    fields.name_is_complete = 1;
-    
-    // 128-bit Service UUID (6e400001-b5a3-f393-e0a9-e50e24dcca9e) in little-endian format
-    static const ble_uuid128_t service_uuid =
-        {.u = {.type = BLE_UUID_TYPE_128},
-         .value = {0x9E, 0xCA, 0xDC, 0x24, 0x0E, 0xE5, 0xA9, 0xE0, 0x93, 0xF3, 0xA3, 0xB5, 0x01, 0x00, 0x40, 0x6E}};
-    
-    fields.uuids128 = &service_uuid;
-    fields.num_uuids128 = 1;
-    fields.uuids128_is_complete = 1;
-    
-    // Log the service UUID being advertised
-    char uuid_str[BLE_UUID_STR_LEN];
-    ble_uuid_to_str(&service_uuid.u, uuid_str);
-    ESP_LOGI(SOMNUS_BLE_TAG, "[BLE] Advertising service UUID: %s", uuid_str);
-    ESP_LOGI(SOMNUS_BLE_TAG, "[BLE] Advertising name: \"%s\" (len=%zu)", 
-             SOMNUS_BLE_LOCAL_NAME, fields.name_len);
-    
-    // Set advertising fields - this must be called when advertising is stopped
-    // Note: Device name is already set via ble_svc_gap_device_name_set, so device will be discoverable
-    // even if this fails. The service UUID in advertising data is optional.
-    int rc = ble_gap_adv_set_fields(&fields);
-    if (rc != 0) {
-        // These errors are expected if advertising is active - not a real failure
-        if (rc == BLE_HS_EBUSY || rc == BLE_HS_EALREADY) {
-            ESP_LOGD(SOMNUS_BLE_TAG, "Advertising fields set deferred (advertising active, rc=%d)", rc);
-            return ESP_OK;  // Not an error - will be set when advertising stops
-        }
-        // EINVAL (4) means invalid parameters or stack not ready
-        // This is not critical - device name is already set, so device will still be discoverable
-        ESP_LOGD(SOMNUS_BLE_TAG, "ble_gap_adv_set_fields failed rc=%d (will use device name only)", rc);
-        return ESP_OK;  // Not a fatal error - advertising will work with device name
-    }
-    
-    ESP_LOGI(SOMNUS_BLE_TAG, "[BLE] Advertising fields set successfully");
-    return ESP_OK;
-}
+    (void)conn_handle;
+    (void)attr_handle;
+    (void)arg;
 
-static void somnus_ble_start_advertising(void)
-{
-    // Don't advertise if already connected
-    portENTER_CRITICAL(&s_state_lock);
-    bool already_connected = (s_conn_handle != BLE_HS_CONN_HANDLE_NONE);
-    portEXIT_CRITICAL(&s_state_lock);
-    
-    if (already_connected) {
-        ESP_LOGI(SOMNUS_BLE_TAG, "Skipping advertising restart - already connected (handle=%u)", s_conn_handle);
-        return;
-    }
-    
-    // Stop any existing advertising first
-    int stop_rc = ble_gap_adv_stop();
-    if (stop_rc != 0 && stop_rc != BLE_HS_EALREADY) {
-        ESP_LOGD(SOMNUS_BLE_TAG, "ble_gap_adv_stop returned rc=%d", stop_rc);
+    if (ctxt->op != BLE_GATT_ACCESS_OP_WRITE_CHR) {
+        return BLE_ATT_ERR_UNLIKELY;
     }
-    
-    // Wait a bit for stop to complete (if it was running)
-    // Use a small delay to let the stack process the stop command
-    vTaskDelay(pdMS_TO_TICKS(50));
-    
-    // Try to set advertising fields (optional - device name is already set via ble_svc_gap_device_name_set)
-    // If this fails, advertising will still work with the device name
-    esp_err_t fields_set = somnus_ble_set_advertising_data();
-    if (fields_set != ESP_OK) {
-        // Not critical - device name is already set, so device will still be discoverable
-        ESP_LOGD(SOMNUS_BLE_TAG, "Advertising fields not set (will use device name only)");
+
+    uint8_t frame[5] = {0};
+    uint16_t frame_len = OS_MBUF_PKTLEN(ctxt->om);
+    if (frame_len < 4 || frame_len > sizeof(frame) ||
+        os_mbuf_copydata(ctxt->om, 0, frame_len, frame) != 0) {
+        return BLE_ATT_ERR_INVALID_ATTR_VALUE_LEN;
     }
-    
-    // Start advertising with proper parameters
-    struct ble_gap_adv_params adv_params;
-    memset(&adv_params, 0, sizeof(adv_params));
-    adv_params.conn_mode = BLE_GAP_CONN_MODE_UND;  // Undirected connectable - allows any device to connect
-    adv_params.disc_mode = BLE_GAP_DISC_MODE_GEN;  // General discoverable
 
-    ESP_LOGI(SOMNUS_BLE_TAG, "Starting BLE advertising: name=\"%s\" conn_mode=UND (connectable)", SOMNUS_BLE_LOCAL_NAME);
-    int rc = ble_gap_adv_start(BLE_OWN_ADDR_PUBLIC,
-                                NULL,
-                                BLE_HS_FOREVER,
-                                &adv_params,
-                                somnus_ble_gap_event,
-                                NULL);
-    if (rc != 0) {
-        if (rc == BLE_HS_EALREADY) {
-            ESP_LOGD(SOMNUS_BLE_TAG, "Advertising already active");
-        } else {
-            ESP_LOGE(SOMNUS_BLE_TAG, "ble_gap_adv_start failed rc=%d", rc);
+    uint32_t seq = (uint32_t)frame[2] | ((uint32_t)frame[3] << 8);
+    portENTER_CRITICAL(&s_state_lock);
+    bool current = s_bulk.active && frame[1] == s_bulk.stream;
+    if (current && frame[0] == SOMNUS_BLE_BULK_FRAME_ACK && frame_len == 5) {
+        // Acks may arrive out of order; only ever move forward
+        if (!s_bulk.acked_any || seq > s_bulk.acked) {
+            s_bulk.acked = seq;
         }
+        s_bulk.acked_any = true;
+        s_bulk.window = frame[4];
+    } else if (current && frame[0] == SOMNUS_BLE_BULK_FRAME_NACK) {
+        s_bulk.nack = true;
+        s_bulk.nack_from = seq;
+    }
+    portEXIT_CRITICAL(&s_state_lock);
+
+    if (current) {
+        somnus_ble_bulk_wake();
     } else {
-        ESP_LOGI(SOMNUS_BLE_TAG,
-                 "Advertising as \"%s\" (connectable, waiting for connections)",
-                 SOMNUS_BLE_LOCAL_NAME);
+        ESP_LOGD(SOMNUS_BLE_TAG, "[BLE BULK] stale frame type=0x%02x stream=%u", frame[0], frame[1]);
     }
+    return 0;
 }
 
-static void somnus_ble_on_sync(void)
+/*
+ * Build one frame: a 4-byte header [type][stream][seq lo][seq hi], then the
+ * START body (total length, kind), a DATA slice of the caller's buffer, or
+ * nothing for END and ABORT.
+ */
+static struct os_mbuf *somnus_ble_bulk_frame(uint8_t type,
+                                             uint32_t seq,
+                                             const uint8_t *body,
+                                             size_t body_len)
 {
-    uint8_t addr_val[6] = {0};
-    int rc = ble_hs_id_infer_auto(0, &addr_val[0]);
-    
-    if (rc != 0) {
-        ESP_LOGE(SOMNUS_BLE_TAG, "ble_hs_id_infer_auto failed rc=%d", rc);
-        return;
+    uint8_t hdr[SOMNUS_BLE_BULK_HDR_LEN] = {type, s_bulk.stream, (uint8_t)(seq & 0xFF), (uint8_t)(seq >> 8)};
+    struct os_mbuf *om = somnus_ble_mbuf_from_flat(hdr, sizeof(hdr));
+    if (om && body_len > 0 && os_mbuf_append(om, body, body_len) != 0) {
+        os_mbuf_free_chain(om);
+        om = NULL;
     }
-    
-    rc = ble_hs_id_copy_addr(BLE_ADDR_PUBLIC, addr_val, NULL);
-    if (rc != 0) {
-        ESP_LOGE(SOMNUS_BLE_TAG, "ble_hs_id_copy_addr failed rc=%d", rc);
-        return;
+    return om;
+}
+
+static esp_err_t somnus_ble_bulk_queue(uint16_t conn, struct os_mbuf *om)
+{
+    notify_work_t notify_work = {
+        .conn_handle = conn,
+        .val_handle = s_bulk.val_handle,
+        .om = om,
+    };
+    if (xQueueSend(s_notify_queue, &notify_work, pdMS_TO_TICKS(100)) != pdTRUE) {
+        os_mbuf_free_chain(om);
+        return ESP_ERR_NO_MEM;
     }
-    
-    // Don't set advertising fields here - wait until we actually start advertising
-    // The stack might not be fully ready yet in the sync callback
-    ESP_LOGI(SOMNUS_BLE_TAG, "BLE stack synchronized, ready to start advertising");
-    somnus_ble_start_advertising();
+    ble_npl_eventq_put(nimble_port_get_dflt_eventq(), &s_notify_ev);
+    return ESP_OK;
 }
 
-static int somnus_ble_gap_event(struct ble_gap_event *event, void *arg)
+esp_err_t somnus_ble_bulk_send(somnus_ble_bulk_kind_t kind, const void *data, size_t len, uint32_t timeout_ms)
 {
-    (void)arg;
-    switch (event->type) {
-    case BLE_GAP_EVENT_CONNECT:
+    if (!data || len == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!s_bulk.mutex || !s_bulk.wake || !s_notify_queue) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (xSemaphoreTake(s_bulk.mutex, pdMS_TO_TICKS(timeout_ms)) != pdTRUE) {
+        return ESP_ERR_TIMEOUT;
+    }
+
+    portENTER_CRITICAL(&s_state_lock);
+    uint16_t conn = s_conn_handle;
+    bool subscribed = s_bulk.subscribed;
+    uint16_t mtu = s_att_mtu;
+    portEXIT_CRITICAL(&s_state_lock);
+
+    size_t payload_max = mtu > SOMNUS_BLE_ATT_NOTIFY_HDR + SOMNUS_BLE_BULK_HDR_LEN
+                             ? mtu - SOMNUS_BLE_ATT_NOTIFY_HDR - SOMNUS_BLE_BULK_HDR_LEN
+                             : 0;
+    // Frame 0 is START, 1..data_frames carry data, data_frames + 1 is END
+    size_t data_frames = payload_max ? (len + payload_max - 1) / payload_max : 0;
+    if (conn == BLE_HS_CONN_HANDLE_NONE || !subscribed || payload_max == 0) {
+        xSemaphoreGive(s_bulk.mutex);
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (data_frames + 1 > UINT16_MAX) {
+        xSemaphoreGive(s_bulk.mutex);
+        return ESP_ERR_INVALID_SIZE;
+    }
+    const uint32_t end_seq = (uint32_t)data_frames + 1;
+
+    portENTER_CRITICAL(&s_state_lock);
+    s_bulk.stream++;
+    s_bulk.active = true;
+    s_bulk.acked_any = false;
+    s_bulk.acked = 0;
+    s_bulk.window = 0;
+    s_bulk.nack = false;
+    s_bulk.inflight = 0;
+    portEXIT_CRITICAL(&s_state_lock);
+    xSemaphoreTake(s_bulk.wake, 0);
+
+    ESP_LOGI(SOMNUS_BLE_TAG, "[BLE BULK] stream %u: %zu bytes, kind %d, %zu frames of %zu",
+             s_bulk.stream, len, (int)kind, data_frames, payload_max);
+    somnus_ble_bulk_touch(conn);
+
+    const uint8_t *bytes = (const uint8_t *)data;
+    const uint8_t start_body[5] = {
+        (uint8_t)(len & 0xFF), (uint8_t)(len >> 8), (uint8_t)(len >> 16), (uint8_t)(len >> 24), (uint8_t)kind,
+    };
+    int64_t deadline = esp_timer_get_time() + (int64_t)timeout_ms * 1000;
+    uint32_t next = 0;
+    uint32_t sent_end = 0;            // One past the highest frame sent; below it is a resend
+    uint32_t progress_mark = 0;
+    bool progress_any = false;
+    int retries = 0;
+    esp_err_t result = ESP_ERR_TIMEOUT;
+
+    while (true) {
+        portENTER_CRITICAL(&s_state_lock);
+        bool still_connected = s_conn_handle == conn && s_bulk.subscribed;
+        bool acked_any = s_bulk.acked_any;
+        uint32_t acked = s_bulk.acked;
+        uint32_t window = s_bulk.window;
+        uint32_t inflight = s_bulk.inflight;
+        if (s_bulk.nack) {
+            s_bulk.nack = false;
+            if (s_bulk.nack_from < next) {
+                next = s_bulk.nack_from;
+            }
+        }
+        portEXIT_CRITICAL(&s_state_lock);
+
+        if (!still_connected) {
+            result = ESP_ERR_INVALID_STATE;
+            break;
+        }
+        if (acked_any && acked >= end_seq) {
+            result = ESP_OK;
+            break;
+        }
+        if (acked_any && (!progress_any || acked > progress_mark)) {
+            progress_mark = acked;
+            progress_any = true;
+            retries = 0;
+        }
+
+        // Only START goes out until the receiver has announced its window
+        uint32_t limit = acked_any ? acked + window : 0;
+        if (limit > end_seq) {
+            limit = end_seq;
+        }
+        while (next <= limit && inflight < SOMNUS_BLE_BULK_MAX_INFLIGHT) {
+            struct os_mbuf *om;
+            if (next == 0) {
+                om = somnus_ble_bulk_frame(SOMNUS_BLE_BULK_FRAME_START, 0, start_body, sizeof(start_body));
+            } else if (next == end_seq) {
+                om = somnus_ble_bulk_frame(SOMNUS_BLE_BULK_FRAME_END, next, NULL, 0);
+            } else {
+                // Go-back-N needs no copy: every frame is re-sliced from the caller's buffer
+                size_t offset = (size_t)(next - 1) * payload_max;
+                size_t chunk = len - offset < payload_max ? len - offset : payload_max;
+                om = somnus_ble_bulk_frame(SOMNUS_BLE_BULK_FRAME_DATA, next, bytes + offset, chunk);
+            }
+            if (!om || somnus_ble_bulk_queue(conn, om) != ESP_OK) {
+                break; // Retried on the next wake
+            }
+            portENTER_CRITICAL(&s_state_lock);
+            inflight = ++s_bulk.inflight;
+            portEXIT_CRITICAL(&s_state_lock);
+            SOMNUS_BLE_COUNT(bulk_frames, 1);
+            if (next < sent_end) {
+                SOMNUS_BLE_COUNT(bulk_retransmits, 1);
+            } else {
+                sent_end = next + 1;
+            }
+            next++;
+        }
+
+        int64_t now = esp_timer_get_time();
+        if (now >= deadline) {
+            break;
+        }
+        int64_t wait_ms = (deadline - now) / 1000;
+        if (wait_ms > SOMNUS_BLE_BULK_RETRY_MS) {
+            wait_ms = SOMNUS_BLE_BULK_RETRY_MS;
+        }
+        if (xSemaphoreTake(s_bulk.wake, pdMS_TO_TICKS(wait_ms)) != pdTRUE) {
+            // Silence: frames or acks were lost, so resend from the last ack
+            if (++retries > SOMNUS_BLE_BULK_MAX_RETRIES) {
+                break;
+            }
+            ESP_LOGW(SOMNUS_BLE_TAG, "[BLE BULK] stream %u stalled at %" PRIu32 "/%" PRIu32 ", resending",
+                     s_bulk.stream, acked, end_seq);
+            next = acked_any ? acked + 1 : 0;
+            portENTER_CRITICAL(&s_state_lock);
+            s_bulk.inflight = 0;
+            portEXIT_CRITICAL(&s_state_lock);
+        }
+    }
+
+    if (result == ESP_ERR_TIMEOUT) {
+        struct os_mbuf *om = somnus_ble_bulk_frame(SOMNUS_BLE_BULK_FRAME_ABORT, 0, NULL, 0);
+        if (om) {
+            somnus_ble_bulk_queue(conn, om);
+        }
+    }
+
+    portENTER_CRITICAL(&s_state_lock);
+    s_bulk.active = false;
+    portEXIT_CRITICAL(&s_state_lock);
+
+    ESP_LOGI(SOMNUS_BLE_TAG, "[BLE BULK] stream %u finished: %s", s_bulk.stream, esp_err_to_name(result));
+    xSemaphoreGive(s_bulk.mutex);
+    return result;
+}
+
+bool somnus_ble_bulk_is_ready(void)
+{
+    portENTER_CRITICAL(&s_state_lock);
+    bool ready = s_bulk.subscribed && s_conn_handle != BLE_HS_CONN_HANDLE_NONE;
+    portEXIT_CRITICAL(&s_state_lock);
+    return ready;
+}
+
+static void somnus_ble_bin_begin(somnus_ble_bin_frame_t *frame, const somnus_ble_reply_t *reply, uint8_t status)
+{
+    frame->buf[0] = reply->cmd | SOMNUS_BLE_BIN_RSP_FLAG;
+    frame->buf[1] = reply->req_id;
+    frame->buf[2] = status;
+    frame->len = SOMNUS_BLE_BIN_RSP_HDR_LEN;
+    frame->overflow = false;
+}
+
+static void somnus_ble_bin_put(somnus_ble_bin_frame_t *frame, uint8_t tag, const void *value, size_t len)
+{
+    if (len > UINT8_MAX || frame->len + 2 + len > sizeof(frame->buf)) {
+        frame->overflow = true;
+        return;
+    }
+    frame->buf[frame->len++] = tag;
+    frame->buf[frame->len++] = (uint8_t)len;
+    memcpy(&frame->buf[frame->len], value, len);
+    frame->len += len;
+}
+
+static void somnus_ble_bin_put_u8(somnus_ble_bin_frame_t *frame, uint8_t tag, uint8_t value)
+{
+    somnus_ble_bin_put(frame, tag, &value, 1);
+}
+
+// Unsigned little-endian in 1, 2 or 4 bytes
+static void somnus_ble_bin_put_uint(somnus_ble_bin_frame_t *frame, uint8_t tag, uint32_t value, size_t bytes)
+{
+    uint8_t le[4];
+    for (size_t i = 0; i < bytes && i < sizeof(le); i++) {
+        le[i] = (uint8_t)(value >> (8 * i));
+    }
+    somnus_ble_bin_put(frame, tag, le, bytes);
+}
+
+// Fixed-point so the app needs no float parsing: int32 little-endian, value x100
+static void somnus_ble_bin_put_scaled(somnus_ble_bin_frame_t *frame, uint8_t tag, double value)
+{
+    int32_t scaled = (int32_t)(value * 100.0 + (value < 0 ? -0.5 : 0.5));
+    uint8_t le[4] = {
+        (uint8_t)scaled, (uint8_t)(scaled >> 8), (uint8_t)(scaled >> 16), (uint8_t)(scaled >> 24),
+    };
+    somnus_ble_bin_put(frame, tag, le, sizeof(le));
+}
+
+/*
+ * Notify one response frame on the binary characteristic. A frame is never
+ * split: it must fit the negotiated MTU, which somnus_ble_request_fast_link()
+ * raises well past SOMNUS_BLE_BIN_FRAME_MAX on connect.
+ */
+static esp_err_t somnus_ble_bin_send(const somnus_ble_bin_frame_t *frame)
+{
+    if (frame->overflow) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    if (!s_notify_queue) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    portENTER_CRITICAL(&s_state_lock);
+    uint16_t conn = s_conn_handle;
+    bool subscribed = s_bin_subscribed;
+    uint16_t mtu = s_att_mtu;
+    portEXIT_CRITICAL(&s_state_lock);
+
+    if (conn == BLE_HS_CONN_HANDLE_NONE || !subscribed) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (frame->len + SOMNUS_BLE_ATT_NOTIFY_HDR > mtu) {
+        ESP_LOGW(SOMNUS_BLE_TAG, "[BLE BIN] %zu-byte frame exceeds MTU %u", frame->len, mtu);
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    struct os_mbuf *om = somnus_ble_mbuf_from_flat(frame->buf, frame->len);
+    if (!om) {
+        return ESP_ERR_NO_MEM;
+    }
+    notify_work_t notify_work = {
+        .conn_handle = conn,
+        .val_handle = s_bin_val_handle,
+        .om = om,
+    };
+    if (xQueueSend(s_notify_queue, &notify_work, pdMS_TO_TICKS(100)) != pdTRUE) {
+        os_mbuf_free_chain(om);
+        return ESP_ERR_NO_MEM;
+    }
+    ble_npl_eventq_put(nimble_port_get_dflt_eventq(), &s_notify_ev);
+    return ESP_OK;
+}
+
+static esp_err_t somnus_ble_bin_status(const somnus_ble_reply_t *reply, uint8_t status)
+{
+    somnus_ble_bin_frame_t frame;
+    somnus_ble_bin_begin(&frame, reply, status);
+    return somnus_ble_bin_send(&frame);
+}
+
+static uint8_t somnus_ble_bin_status_from_err(esp_err_t err)
+{
+    switch (err) {
+    case ESP_OK:
+        return SOMNUS_BLE_BIN_OK;
+    case ESP_ERR_INVALID_ARG:
+        return SOMNUS_BLE_BIN_INVALID_ARG;
+    case ESP_ERR_NOT_SUPPORTED:
+        return SOMNUS_BLE_BIN_UNSUPPORTED;
+    case ESP_ERR_NO_MEM:
+    case ESP_ERR_TIMEOUT:
+        return SOMNUS_BLE_BIN_BUSY;
+    default:
+        return SOMNUS_BLE_BIN_FAILED;
+    }
+}
+
+/*
+ * Decode the TLVs after a request header. Strings are copied NUL-terminated
+ * into `strings`, which needs at least as many bytes as the frame. Unknown
+ * tags are skipped so the app can send fields newer firmware understands.
+ */
+static esp_err_t somnus_ble_bin_decode(const uint8_t *frame,
+                                       size_t len,
+                                       somnus_ble_cmd_args_t *args,
+                                       char *strings,
+                                       size_t strings_len)
+{
+    memset(args, 0, sizeof(*args));
+    size_t used = 0;
+    size_t pos = SOMNUS_BLE_BIN_REQ_HDR_LEN;
+    while (pos < len) {
+        if (len - pos < 2 || frame[pos + 1] > len - pos - 2) {
+            return ESP_ERR_INVALID_SIZE;
+        }
+        uint8_t tag = frame[pos];
+        uint8_t vlen = frame[pos + 1];
+        const uint8_t *value = &frame[pos + 2];
+        pos += 2 + vlen;
+
+        const char **str = NULL;
+        switch (tag) {
+        case SOMNUS_BLE_TLV_SSID:
+            str = &args->ssid;
+            break;
+        case SOMNUS_BLE_TLV_PASSWORD:
+            str = &args->password;
+            break;
+        case SOMNUS_BLE_TLV_USER_TOKEN:
+            str = &args->user_token;
+            break;
+        case SOMNUS_BLE_TLV_IS_PRODUCTION:
+            if (vlen != 1) {
+                return ESP_ERR_INVALID_ARG;
+            }
+            args->is_production = value[0] != 0;
+            break;
+        case SOMNUS_BLE_TLV_RGB:
+            if (vlen != 3) {
+                return ESP_ERR_INVALID_ARG;
+            }
+            memcpy(args->rgb, value, 3);
+            args->has_rgb = true;
+            break;
+        case SOMNUS_BLE_TLV_BRIGHTNESS:
+            if (vlen != 1 || value[0] > 100) {
+                return ESP_ERR_INVALID_ARG;
+            }
+            args->brightness = value[0] / 100.0f;
+            args->has_brightness = true;
+            break;
+        case SOMNUS_BLE_TLV_VOLUME:
+            if (vlen != 1 || value[0] > 100) {
+                return ESP_ERR_INVALID_ARG;
+            }
+            args->volume = value[0] / 100.0f;
+            args->has_volume = true;
+            break;
+        case SOMNUS_BLE_TLV_FROM:
+        case SOMNUS_BLE_TLV_TO:
+            if (vlen != 4) {
+                return ESP_ERR_INVALID_ARG;
+            }
+            *(tag == SOMNUS_BLE_TLV_FROM ? &args->from_s : &args->to_s) =
+                (uint32_t)value[0] | (uint32_t)value[1] << 8 | (uint32_t)value[2] << 16 | (uint32_t)value[3] << 24;
+            args->has_range = true;
+            break;
+        case SOMNUS_BLE_TLV_DATA:
+            args->data = value;
+            args->data_len = vlen;
+            break;
+        case SOMNUS_BLE_TLV_SIZE:
+            if (vlen != 4) {
+                return ESP_ERR_INVALID_ARG;
+            }
+            args->size =
+                (uint32_t)value[0] | (uint32_t)value[1] << 8 | (uint32_t)value[2] << 16 | (uint32_t)value[3] << 24;
+            break;
+        case SOMNUS_BLE_TLV_BULK:
+        case SOMNUS_BLE_TLV_RESET:
+            if (vlen != 1) {
+                return ESP_ERR_INVALID_ARG;
+            }
+            *(tag == SOMNUS_BLE_TLV_BULK ? &args->bulk : &args->reset) = value[0] != 0;
+            break;
+        case SOMNUS_BLE_TLV_INTERVAL:
+            if (vlen != 2) {
+                return ESP_ERR_INVALID_ARG;
+            }
+            args->interval = (uint16_t)(value[0] | value[1] << 8);
+            args->has_interval = true;
+            break;
+        case SOMNUS_BLE_TLV_PHY:
+            if (vlen != 1) {
+                return ESP_ERR_INVALID_ARG;
+            }
+            args->phy = value[0];
+            break;
+        default:
+            ESP_LOGD(SOMNUS_BLE_TAG, "[BLE BIN] skipping unknown tag 0x%02x", tag);
+            break;
+        }
+
+        if (str) {
+            if (used + vlen + 1 > strings_len) {
+                return ESP_ERR_INVALID_SIZE;
+            }
+            memcpy(&strings[used], value, vlen);
+            strings[used + vlen] = '\0';
+            *str = &strings[used];
+            used += vlen + 1;
+        }
+    }
+    return ESP_OK;
+}
+
+static int somnus_ble_bin_access_cb(uint16_t conn_handle,
+                                    uint16_t attr_handle,
+                                    struct ble_gatt_access_ctxt *ctxt,
+                                    void *arg)
+{
+    (void)attr_handle;
+    (void)arg;
+
+    if (ctxt->op != BLE_GATT_ACCESS_OP_WRITE_CHR) {
+        return BLE_ATT_ERR_UNLIKELY;
+    }
+
+    uint16_t pkt_len = OS_MBUF_PKTLEN(ctxt->om);
+    if (pkt_len < SOMNUS_BLE_BIN_REQ_HDR_LEN || pkt_len > SOMNUS_BLE_CMD_MAX_LEN) {
+        return BLE_ATT_ERR_INVALID_ATTR_VALUE_LEN;
+    }
+
+    somnus_ble_cmd_msg_t msg = {
+        .kind = SOMNUS_BLE_MSG_BINARY,
+        .len = pkt_len,
+    };
+    if (os_mbuf_copydata(ctxt->om, 0, pkt_len, msg.payload) != 0) {
+        return BLE_ATT_ERR_UNLIKELY;
+    }
+    if (!s_cmd_queue) {
+        return BLE_ATT_ERR_UNLIKELY;
+    }
+    SOMNUS_BLE_COUNT(bin_writes, 1);
+    SOMNUS_BLE_COUNT(bin_bytes, pkt_len);
+
+    const somnus_ble_reply_t reply = {
+        .binary = true,
+        .cmd = (uint8_t)msg.payload[0],
+        .req_id = (uint8_t)msg.payload[1],
+    };
+    ESP_LOGD(SOMNUS_BLE_TAG, "[BLE BIN] cmd=0x%02x id=%u len=%u", reply.cmd, reply.req_id, pkt_len);
+
+    // Slider controls: keep only the newest value and at most one queue entry each
+    int slot = reply.cmd == SOMNUS_BLE_CMD_SET_LED ? 0 : reply.cmd == SOMNUS_BLE_CMD_SET_VOLUME ? 1 : -1;
+    if (slot >= 0) {
+        if (pkt_len > sizeof(s_bin_latest[slot].frame)) {
+            return BLE_ATT_ERR_INVALID_ATTR_VALUE_LEN;
+        }
+        portENTER_CRITICAL(&s_state_lock);
+        bool was_pending = s_bin_latest[slot].pending;
+        memcpy(s_bin_latest[slot].frame, msg.payload, pkt_len);
+        s_bin_latest[slot].len = pkt_len;
+        s_bin_latest[slot].pending = true;
+        portEXIT_CRITICAL(&s_state_lock);
+        if (was_pending) {
+            SOMNUS_BLE_COUNT(coalesced, 1);
+            return 0;
+        }
+        msg.kind = SOMNUS_BLE_MSG_LATEST;
+        msg.len = 1;
+        msg.payload[0] = (char)slot;
+    } else {
+        ble_log_add(BLE_LOG_EV_RX_BIN, conn_handle, reply.cmd, NULL, pkt_len);
+    }
+
+    if (xQueueSend(s_cmd_queue, &msg, 0) != pdTRUE) {
+        ESP_LOGW(SOMNUS_BLE_TAG, "[BLE BIN] command queue full, dropping cmd=0x%02x", reply.cmd);
+        SOMNUS_BLE_COUNT(queue_drops, 1);
+        if (slot >= 0) {
+            portENTER_CRITICAL(&s_state_lock);
+            s_bin_latest[slot].pending = false;
+            portEXIT_CRITICAL(&s_state_lock);
+        }
+        somnus_ble_bin_status(&reply, SOMNUS_BLE_BIN_BUSY);
+    }
+    return 0;
+}
+
+static void somnus_ble_host_task(void *param)
+{
+    (void)param;
+    // Returns only after nimble_port_stop(); notifications arrive as events
+    nimble_port_run();
+    nimble_port_freertos_deinit();
+}
+
+static esp_err_t somnus_ble_set_advertising_data(void)
+{
+    struct ble_hs_adv_fields fields;
+    memset(&fields, 0, sizeof(fields));
+    
+    fields.flags = BLE_HS_ADV_F_DISC_GEN | BLE_HS_ADV_F_BREDR_UNSUP;
+    fields.tx_pwr_lvl_is_present = 0;
+    fields.name = (uint8_t *)SOMNUS_BLE_LOCAL_NAME;
+    fields.name_len = strlen(SOMNUS_BLE_LOCAL_NAME);
+    fields.name_is_complete = 1;
+    
+    // 128-bit Service UUID (6e400001-b5a3-f393-e0a9-e50e24dcca9e) in little-endian format
+    static const ble_uuid128_t service_uuid =
+        {.u = {.type = BLE_UUID_TYPE_128},
+         .value = {0x9E, 0xCA, 0xDC, 0x24, 0x0E, 0xE5, 0xA9, 0xE0, 0x93, 0xF3, 0xA3, 0xB5, 0x01, 0x00, 0x40, 0x6E}};
+    
+    fields.uuids128 = &service_uuid;
+    fields.num_uuids128 = 1;
+    fields.uuids128_is_complete = 1;
+    
+    // Log the service UUID being advertised
+    char uuid_str[BLE_UUID_STR_LEN];
+    ble_uuid_to_str(&service_uuid.u, uuid_str);
+    ESP_LOGI(SOMNUS_BLE_TAG, "[BLE] Advertising service UUID: %s", uuid_str);
+    ESP_LOGI(SOMNUS_BLE_TAG, "[BLE] Advertising name: \"%s\" (len=%zu)", 
+             SOMNUS_BLE_LOCAL_NAME, fields.name_len);
+    
+    // Set advertising fields - this must be called when advertising is stopped
+    // Note: Device name is already set via ble_svc_gap_device_name_set, so device will be discoverable
+    // even if this fails. The service UUID in advertising data is optional.
+    int rc = ble_gap_adv_set_fields(&fields);
+    if (rc != 0) {
+        // These errors are expected if advertising is active - not a real failure
+        if (rc == BLE_HS_EBUSY || rc == BLE_HS_EALREADY) {
+            ESP_LOGD(SOMNUS_BLE_TAG, "Advertising fields set deferred (advertising active, rc=%d)", rc);
+            return ESP_OK;  // Not an error - will be set when advertising stops
+        }
+        // EINVAL (4) means invalid parameters or stack not ready
+        // This is not critical - device name is already set, so device will still be discoverable
+        ESP_LOGD(SOMNUS_BLE_TAG, "ble_gap_adv_set_fields failed rc=%d (will use device name only)", rc);
+        return ESP_OK;  // Not a fatal error - advertising will work with device name
+    }
+    
+    ESP_LOGI(SOMNUS_BLE_TAG, "[BLE] Advertising fields set successfully");
+    return ESP_OK;
+}
+
+static void somnus_ble_start_advertising(void)
+{
+    // Don't advertise if already connected
+    portENTER_CRITICAL(&s_state_lock);
+    bool already_connected = (s_conn_handle != BLE_HS_CONN_HANDLE_NONE);
+    portEXIT_CRITICAL(&s_state_lock);
+    
+    if (already_connected) {
+        ESP_LOGI(SOMNUS_BLE_TAG, "Skipping advertising restart - already connected (handle=%u)", s_conn_handle);
+        return;
+    }
+    
+    // Stop any existing advertising first
+    int stop_rc = ble_gap_adv_stop();
+    if (stop_rc != 0 && stop_rc != BLE_HS_EALREADY) {
+        ESP_LOGD(SOMNUS_BLE_TAG, "ble_gap_adv_stop returned rc=%d", stop_rc);
+    }
+    
+    // Wait a bit for stop to complete (if it was running)
+    // Use a small delay to let the stack process the stop command
+    vTaskDelay(pdMS_TO_TICKS(50));
+    
+    // Try to set advertising fields (optional - device name is already set via ble_svc_gap_device_name_set)
+    // If this fails, advertising will still work with the device name
+    esp_err_t fields_set = somnus_ble_set_advertising_data();
+    if (fields_set != ESP_OK) {
+        // Not critical - device name is already set, so device will still be discoverable
+        ESP_LOGD(SOMNUS_BLE_TAG, "Advertising fields not set (will use device name only)");
+    }
+    
+    // Start advertising with proper parameters
+    struct ble_gap_adv_params adv_params;
+    memset(&adv_params, 0, sizeof(adv_params));
+    adv_params.conn_mode = BLE_GAP_CONN_MODE_UND;  // Undirected connectable - allows any device to connect
+    adv_params.disc_mode = BLE_GAP_DISC_MODE_GEN;  // General discoverable
+    bool low_duty = __atomic_load_n(&s_low_duty, __ATOMIC_ACQUIRE);
+    if (low_duty) {
+        // 0.625 ms units; 0 leaves the stack's 30-60 ms default
+        adv_params.itvl_min = BLE_GAP_ADV_ITVL_MS(CONFIG_SOMNUS_BLE_LOW_DUTY_ADV_MS);
+        adv_params.itvl_max = BLE_GAP_ADV_ITVL_MS(CONFIG_SOMNUS_BLE_LOW_DUTY_ADV_MS + CONFIG_SOMNUS_BLE_LOW_DUTY_ADV_MS / 10);
+    }
+
+    ESP_LOGI(SOMNUS_BLE_TAG, "Starting BLE advertising: name=\"%s\" conn_mode=UND (connectable)%s",
+             SOMNUS_BLE_LOCAL_NAME, low_duty ? ", low duty" : "");
+    int rc = ble_gap_adv_start(BLE_OWN_ADDR_PUBLIC,
+                                NULL,
+                                BLE_HS_FOREVER,
+                                &adv_params,
+                                somnus_ble_gap_event,
+                                NULL);
+    if (rc != 0) {
+        if (rc == BLE_HS_EALREADY) {
+            ESP_LOGD(SOMNUS_BLE_TAG, "Advertising already active");
+        } else {
+            ESP_LOGE(SOMNUS_BLE_TAG, "ble_gap_adv_start failed rc=%d", rc);
+        }
+    } else {
+        ESP_LOGI(SOMNUS_BLE_TAG,
+                 "Advertising as \"%s\" (connectable, waiting for connections)",
+                 SOMNUS_BLE_LOCAL_NAME);
+    }
+}
+
+static void somnus_ble_duty_apply(struct ble_npl_event *ev)
+{
+    (void)ev;
+    if (!s_started) {
+        return;
+    }
+    portENTER_CRITICAL(&s_state_lock);
+    uint16_t conn = s_conn_handle;
+    bool fast = s_bulk_fast;
+    portEXIT_CRITICAL(&s_state_lock);
+
+    if (conn != BLE_HS_CONN_HANDLE_NONE) {
+        somnus_ble_set_conn_params(conn, fast);
+    } else {
+        somnus_ble_start_advertising();
+    }
+}
+
+static void somnus_ble_on_sync(void)
+{
+    uint8_t addr_val[6] = {0};
+    int rc = ble_hs_id_infer_auto(0, &addr_val[0]);
+    
+    if (rc != 0) {
+        ESP_LOGE(SOMNUS_BLE_TAG, "ble_hs_id_infer_auto failed rc=%d", rc);
+        return;
+    }
+    
+    rc = ble_hs_id_copy_addr(BLE_ADDR_PUBLIC, addr_val, NULL);
+    if (rc != 0) {
+        ESP_LOGE(SOMNUS_BLE_TAG, "ble_hs_id_copy_addr failed rc=%d", rc);
+        return;
+    }
+    
+    // Don't set advertising fields here - wait until we actually start advertising
+    // The stack might not be fully ready yet in the sync callback
+    ESP_LOGI(SOMNUS_BLE_TAG, "BLE stack synchronized, ready to start advertising");
+    somnus_ble_start_advertising();
+}
+
+static int somnus_ble_mtu_exchange_cb(uint16_t conn_handle,
+                                      const struct ble_gatt_error *error,
+                                      uint16_t mtu,
+                                      void *arg)
+{
+    (void)arg;
+    // BLE_GAP_EVENT_MTU records the result; this only reports failures
+    if (error && error->status != 0) {
+        ESP_LOGW(SOMNUS_BLE_TAG, "[BLE] MTU exchange failed handle=%u status=%d", conn_handle, error->status);
+    } else {
+        ESP_LOGD(SOMNUS_BLE_TAG, "[BLE] MTU exchange done handle=%u mtu=%u", conn_handle, mtu);
+    }
+    return 0;
+}
+
+/*
+ * Ask for everything that makes large notifications cheap: the preferred MTU,
+ * 251-byte link-layer packets and the 2M PHY. Each request is optional; the
+ * phone may refuse any of them and chunking follows whatever MTU results.
+ */
+static void somnus_ble_request_fast_link(uint16_t conn)
+{
+    int rc = ble_gattc_exchange_mtu(conn, somnus_ble_mtu_exchange_cb, NULL);
+    if (rc != 0) {
+        ESP_LOGD(SOMNUS_BLE_TAG, "[BLE] MTU exchange not started rc=%d", rc);
+    }
+#if CONFIG_SOMNUS_BLE_DATA_LENGTH_EXT
+    rc = ble_gap_set_data_len(conn, SOMNUS_BLE_DLE_TX_OCTETS, SOMNUS_BLE_DLE_TX_TIME);
+    if (rc != 0) {
+        ESP_LOGD(SOMNUS_BLE_TAG, "[BLE] Data length request rc=%d", rc);
+    }
+#endif
+#if CONFIG_SOMNUS_BLE_PREFER_2M_PHY
+    rc = ble_gap_set_prefered_le_phy(conn, BLE_GAP_LE_PHY_2M_MASK, BLE_GAP_LE_PHY_2M_MASK,
+                                     BLE_GAP_LE_PHY_CODED_ANY);
+    if (rc != 0) {
+        ESP_LOGD(SOMNUS_BLE_TAG, "[BLE] 2M PHY request rc=%d", rc);
+    }
+#endif
+}
+
+// Interval, latency and timeout the controller settled on, for GET_STATS
+static void somnus_ble_record_link(uint16_t conn)
+{
+    struct ble_gap_conn_desc desc;
+    if (ble_gap_conn_find(conn, &desc) != 0) {
+        return;
+    }
+    portENTER_CRITICAL(&s_state_lock);
+    s_stats.conn_itvl = desc.conn_itvl;
+    s_stats.conn_latency = desc.conn_latency;
+    s_stats.supervision_tmo = desc.supervision_timeout;
+    portEXIT_CRITICAL(&s_state_lock);
+}
+
+static int somnus_ble_gap_event(struct ble_gap_event *event, void *arg)
+{
+    (void)arg;
+    switch (event->type) {
+    case BLE_GAP_EVENT_CONNECT:
         ESP_LOGI(SOMNUS_BLE_TAG, "[BLE] GAP connect: handle=%u status=%d",
                  event->connect.conn_handle, event->connect.status);
         if (event->connect.status == 0) {
             ESP_LOGI(SOMNUS_BLE_TAG, "[BLE] Client connected handle=%u", event->connect.conn_handle);
             portENTER_CRITICAL(&s_state_lock);
             s_conn_handle = event->connect.conn_handle;
+            s_att_mtu = BLE_ATT_MTU_DFLT;
+            s_bulk_fast = false;
+            s_stats.tx_phy = BLE_GAP_LE_PHY_1M;
+            s_stats.rx_phy = BLE_GAP_LE_PHY_1M;
             portEXIT_CRITICAL(&s_state_lock);
+            somnus_ble_record_link(event->connect.conn_handle);
+            somnus_ble_request_fast_link(event->connect.conn_handle);
             ESP_LOGI(SOMNUS_BLE_TAG, "[BLE] Connection established - ready for RX/TX");
-            char log_msg[128];
-            snprintf(log_msg, sizeof(log_msg), "Client connected (handle=%u)", event->connect.conn_handle);
-            ble_log_add(BLE_LOG_CONNECT, log_msg);
+            ble_log_add(BLE_LOG_EV_CONNECTED, event->connect.conn_handle, 0, NULL, 0);
         } else {
             ESP_LOGW(SOMNUS_BLE_TAG, "[BLE] Connection failed status=%d (0=success, non-zero=error)", event->connect.status);
-            char log_msg[128];
-            snprintf(log_msg, sizeof(log_msg), "Connection failed (status=%d)", event->connect.status);
-            ble_log_add(BLE_LOG_DISCONNECT, log_msg);
+            ble_log_add(BLE_LOG_EV_CONNECT_FAILED, event->connect.conn_handle, event->connect.status, NULL, 0);
             somnus_ble_start_advertising();
         }
         break;
@@ -636,21 +1692,49 @@ static int somnus_ble_gap_event(struct ble_gap_event *event, void *arg)
         portENTER_CRITICAL(&s_state_lock);
         s_conn_handle = BLE_HS_CONN_HANDLE_NONE;
         s_notify_enabled = false;
+        s_att_mtu = BLE_ATT_MTU_DFLT;
+        s_bulk_fast = false;
+        s_bulk.subscribed = false;
+        s_bin_subscribed = false;
+        s_stats.tx_phy = s_stats.rx_phy = 0;
+        s_stats.conn_itvl = s_stats.conn_latency = s_stats.supervision_tmo = 0;
         portEXIT_CRITICAL(&s_state_lock);
+        __atomic_store_n(&s_pinned_itvl, 0, __ATOMIC_RELEASE);
+        somnus_ble_bulk_wake();
+        if (s_bulk_timer) {
+            esp_timer_stop(s_bulk_timer);
+        }
         ESP_LOGI(SOMNUS_BLE_TAG, "[BLE] Connection closed - restarting advertising");
-        char log_msg[128];
-        snprintf(log_msg, sizeof(log_msg), "Client disconnected (handle=%u, reason=%d)", 
-                 event->disconnect.conn.conn_handle, event->disconnect.reason);
-        ble_log_add(BLE_LOG_DISCONNECT, log_msg);
+        ble_log_add(BLE_LOG_EV_DISCONNECTED, event->disconnect.conn.conn_handle, event->disconnect.reason,
+                    NULL, 0);
         somnus_ble_start_advertising();
         break;
     case BLE_GAP_EVENT_CONN_UPDATE:
         ESP_LOGI(SOMNUS_BLE_TAG, "Connection update: handle=%u status=%d",
                  event->conn_update.conn_handle, event->conn_update.status);
+        if (event->conn_update.status == 0) {
+            somnus_ble_record_link(event->conn_update.conn_handle);
+        }
+        break;
+    case BLE_GAP_EVENT_PHY_UPDATE_COMPLETE:
+        ESP_LOGI(SOMNUS_BLE_TAG, "PHY update: handle=%u status=%d tx=%u rx=%u", event->phy_updated.conn_handle,
+                 event->phy_updated.status, event->phy_updated.tx_phy, event->phy_updated.rx_phy);
+        portENTER_CRITICAL(&s_state_lock);
+        if (event->phy_updated.status == 0 && event->phy_updated.conn_handle == s_conn_handle) {
+            s_stats.tx_phy = event->phy_updated.tx_phy;
+            s_stats.rx_phy = event->phy_updated.rx_phy;
+        }
+        portEXIT_CRITICAL(&s_state_lock);
         break;
     case BLE_GAP_EVENT_MTU:
-        ESP_LOGI(SOMNUS_BLE_TAG, "MTU update: handle=%u mtu=%u",
-                 event->mtu.conn_handle, event->mtu.value);
+        ESP_LOGI(SOMNUS_BLE_TAG, "MTU update: handle=%u mtu=%u (notify payload %u bytes)",
+                 event->mtu.conn_handle, event->mtu.value,
+                 event->mtu.value > SOMNUS_BLE_ATT_NOTIFY_HDR ? event->mtu.value - SOMNUS_BLE_ATT_NOTIFY_HDR : 0);
+        portENTER_CRITICAL(&s_state_lock);
+        if (event->mtu.conn_handle == s_conn_handle) {
+            s_att_mtu = event->mtu.value;
+        }
+        portEXIT_CRITICAL(&s_state_lock);
         break;
     case BLE_GAP_EVENT_ADV_COMPLETE:
         ESP_LOGI(SOMNUS_BLE_TAG, "Advertisement complete status=%d (0=timeout/complete, non-zero=error)", event->adv_complete.reason);
@@ -676,13 +1760,35 @@ static int somnus_ble_gap_event(struct ble_gap_event *event, void *arg)
             portEXIT_CRITICAL(&s_state_lock);
             ESP_LOGI(SOMNUS_BLE_TAG, "[BLE TX] Notifications %s (can now send messages to client)",
                      s_notify_enabled ? "enabled" : "disabled");
-            char log_msg[128];
-            snprintf(log_msg, sizeof(log_msg), "Notifications %s", s_notify_enabled ? "enabled" : "disabled");
-            ble_log_add(BLE_LOG_SUBSCRIBE, log_msg);
+            ble_log_add(BLE_LOG_EV_NOTIFY, event->subscribe.conn_handle, event->subscribe.cur_notify, NULL, 0);
+        } else if (event->subscribe.attr_handle == s_bulk.val_handle) {
+            portENTER_CRITICAL(&s_state_lock);
+            s_bulk.subscribed = event->subscribe.cur_notify;
+            portEXIT_CRITICAL(&s_state_lock);
+            somnus_ble_bulk_wake();
+            ESP_LOGI(SOMNUS_BLE_TAG, "[BLE BULK] Notifications %s",
+                     event->subscribe.cur_notify ? "enabled" : "disabled");
+        } else if (event->subscribe.attr_handle == s_bin_val_handle) {
+            portENTER_CRITICAL(&s_state_lock);
+            s_bin_subscribed = event->subscribe.cur_notify;
+            portEXIT_CRITICAL(&s_state_lock);
+            ESP_LOGI(SOMNUS_BLE_TAG, "[BLE BIN] Notifications %s",
+                     event->subscribe.cur_notify ? "enabled" : "disabled");
         } else {
             ESP_LOGD(SOMNUS_BLE_TAG, "[BLE] Subscribe event for non-TX characteristic (handle=%u)", event->subscribe.attr_handle);
         }
         break;
+    case BLE_GAP_EVENT_NOTIFY_TX:
+        // Paces the bulk channel: a slot frees once the stack has sent the frame
+        if (event->notify_tx.attr_handle == s_bulk.val_handle) {
+            portENTER_CRITICAL(&s_state_lock);
+            if (s_bulk.inflight > 0) {
+                s_bulk.inflight--;
+            }
+            portEXIT_CRITICAL(&s_state_lock);
+            somnus_ble_bulk_wake();
+        }
+        break;
     default:
         ESP_LOGD(SOMNUS_BLE_TAG, "GAP event: type=%d", event->type);
         break;
@@ -690,90 +1796,582 @@ static int somnus_ble_gap_event(struct ble_gap_event *event, void *arg)
     return 0;
 }
 
-static void somnus_ble_command_task(void *param)
+static void somnus_ble_command_task(void *param)
+{
+    (void)param;
+    somnus_ble_cmd_msg_t msg;
+    ESP_LOGI(SOMNUS_BLE_TAG, "[BLE] Command task started - waiting for messages");
+    while (xQueueReceive(s_cmd_queue, &msg, portMAX_DELAY) == pdTRUE) {
+        SOMNUS_BLE_COUNT(commands, 1);
+        switch (msg.kind) {
+        case SOMNUS_BLE_MSG_JSON:
+            ESP_LOGI(SOMNUS_BLE_TAG, "[BLE] Processing command[%zu]: %.*s", msg.len, (int)msg.len, msg.payload);
+            somnus_ble_handle_command(msg.payload);
+            break;
+        case SOMNUS_BLE_MSG_BINARY:
+            somnus_ble_handle_binary((const uint8_t *)msg.payload, msg.len);
+            break;
+        case SOMNUS_BLE_MSG_LATEST: {
+            // Take the newest frame; writes from here on queue a fresh entry
+            uint8_t slot = (uint8_t)msg.payload[0];
+            uint8_t frame[SOMNUS_BLE_BIN_FRAME_MAX];
+            portENTER_CRITICAL(&s_state_lock);
+            size_t len = s_bin_latest[slot].len;
+            memcpy(frame, s_bin_latest[slot].frame, len);
+            s_bin_latest[slot].pending = false;
+            portEXIT_CRITICAL(&s_state_lock);
+            somnus_ble_handle_binary(frame, len);
+            break;
+        }
+        }
+        ESP_LOGD(SOMNUS_BLE_TAG, "[BLE] Command processing complete");
+    }
+}
+
+static void somnus_ble_handle_binary(const uint8_t *frame, size_t len)
+{
+    const somnus_ble_reply_t reply = {
+        .binary = true,
+        .cmd = frame[0],
+        .req_id = frame[1],
+    };
+
+    const somnus_ble_cmd_def_t *def = NULL;
+    for (size_t i = 0; i < sizeof(s_cmd_defs) / sizeof(s_cmd_defs[0]); i++) {
+        if (s_cmd_defs[i].id == reply.cmd) {
+            def = &s_cmd_defs[i];
+            break;
+        }
+    }
+    if (!def) {
+        ESP_LOGW(SOMNUS_BLE_TAG, "[BLE BIN] Unknown command 0x%02x", reply.cmd);
+        somnus_ble_bin_status(&reply, SOMNUS_BLE_BIN_UNSUPPORTED);
+        return;
+    }
+
+    somnus_ble_cmd_args_t args;
+    char strings[SOMNUS_BLE_CMD_MAX_LEN + 1];
+    if (somnus_ble_bin_decode(frame, len, &args, strings, sizeof(strings)) != ESP_OK) {
+        ESP_LOGW(SOMNUS_BLE_TAG, "[BLE BIN] Malformed TLVs for %s", def->action);
+        somnus_ble_bin_status(&reply, SOMNUS_BLE_BIN_INVALID_ARG);
+        return;
+    }
+
+    ESP_LOGI(SOMNUS_BLE_TAG, "[BLE BIN] Executing %s (id=%u)", def->action, reply.req_id);
+    def->handler(&args, &reply);
+}
+
+static void somnus_ble_args_from_json(const cJSON *root, somnus_ble_cmd_args_t *args)
+{
+    memset(args, 0, sizeof(*args));
+
+    const cJSON *ssid = cJSON_GetObjectItemCaseSensitive(root, "ssid");
+    const cJSON *password = cJSON_GetObjectItemCaseSensitive(root, "password");
+    const cJSON *token = cJSON_GetObjectItemCaseSensitive(root, "user_token");
+    const cJSON *is_prod = cJSON_GetObjectItemCaseSensitive(root, "is_production");
+    args->ssid = cJSON_IsString(ssid) ? ssid->valuestring : NULL;
+    args->password = cJSON_IsString(password) ? password->valuestring : NULL;
+    args->user_token = cJSON_IsString(token) ? token->valuestring : NULL;
+    if (cJSON_IsBool(is_prod)) {
+        args->is_production = cJSON_IsTrue(is_prod);
+    } else if (cJSON_IsString(is_prod)) {
+        args->is_production = strcasecmp(is_prod->valuestring, "true") == 0 ||
+                              strcmp(is_prod->valuestring, "1") == 0;
+    }
+
+    const cJSON *color = cJSON_GetObjectItemCaseSensitive(root, "color");
+    if (cJSON_IsArray(color) && cJSON_GetArraySize(color) == 3) {
+        args->has_rgb = true;
+        for (int i = 0; i < 3; i++) {
+            const cJSON *c = cJSON_GetArrayItem(color, i);
+            double v = cJSON_IsNumber(c) ? c->valuedouble : 0;
+            args->rgb[i] = (uint8_t)(v < 0 ? 0 : v > 255 ? 255 : v);
+        }
+    }
+    const cJSON *brightness = cJSON_GetObjectItemCaseSensitive(root, "brightness");
+    if (cJSON_IsNumber(brightness)) {
+        args->has_brightness = true;
+        args->brightness = (float)brightness->valuedouble;
+    }
+    const cJSON *volume = cJSON_GetObjectItemCaseSensitive(root, "volume");
+    if (cJSON_IsNumber(volume)) {
+        args->has_volume = true;
+        args->volume = (float)volume->valuedouble;
+    }
+    args->stream = cJSON_IsTrue(cJSON_GetObjectItemCaseSensitive(root, "stream"));
+    const cJSON *from = cJSON_GetObjectItemCaseSensitive(root, "from");
+    const cJSON *to = cJSON_GetObjectItemCaseSensitive(root, "to");
+    if (cJSON_IsNumber(from) || cJSON_IsNumber(to)) {
+        args->has_range = true;
+        args->from_s = cJSON_IsNumber(from) && from->valuedouble > 0 ? (uint32_t)from->valuedouble : 0;
+        args->to_s = cJSON_IsNumber(to) && to->valuedouble > 0 ? (uint32_t)to->valuedouble : 0;
+    }
+
+    const cJSON *data = cJSON_GetObjectItemCaseSensitive(root, "data");
+    if (cJSON_IsString(data)) {
+        args->data = (const uint8_t *)data->valuestring;
+        args->data_len = strlen(data->valuestring);
+    }
+    const cJSON *size = cJSON_GetObjectItemCaseSensitive(root, "size");
+    if (cJSON_IsNumber(size) && size->valuedouble > 0) {
+        args->size = size->valuedouble < UINT32_MAX ? (uint32_t)size->valuedouble : UINT32_MAX;
+    }
+    args->bulk = cJSON_IsTrue(cJSON_GetObjectItemCaseSensitive(root, "bulk"));
+    args->reset = cJSON_IsTrue(cJSON_GetObjectItemCaseSensitive(root, "reset"));
+    // Milliseconds here; the binary TLV carries 1.25 ms units
+    const cJSON *interval = cJSON_GetObjectItemCaseSensitive(root, "interval_ms");
+    if (cJSON_IsNumber(interval)) {
+        double units = interval->valuedouble / 1.25 + 0.5;
+        args->has_interval = true;
+        args->interval = units < 0 ? 0 : units > UINT16_MAX ? UINT16_MAX : (uint16_t)units;
+    }
+    const cJSON *phy = cJSON_GetObjectItemCaseSensitive(root, "phy");
+    if (cJSON_IsNumber(phy)) {
+        args->phy = phy->valuedouble < 0 || phy->valuedouble > UINT8_MAX ? UINT8_MAX : (uint8_t)phy->valuedouble;
+    }
+}
+
+static void somnus_ble_handle_command(const char *payload)
+{
+    if (!payload || payload[0] == '\0') {
+        ESP_LOGW(SOMNUS_BLE_TAG, "[BLE] Empty command payload");
+        return;
+    }
+
+    ESP_LOGD(SOMNUS_BLE_TAG, "[BLE] Parsing JSON command: %s", payload);
+    cJSON *root = cJSON_Parse(payload);
+    if (!root) {
+        ESP_LOGW(SOMNUS_BLE_TAG, "[BLE] JSON parse failed for payload: %s", payload);
+        somnus_ble_notify("Bad JSON format");
+        return;
+    }
+
+    // Check for device command format (Action with capital A, or array of actions)
+    const cJSON *action_capital = cJSON_GetObjectItemCaseSensitive(root, "Action");
+    bool is_device_command = (action_capital != NULL && cJSON_IsString(action_capital)) || cJSON_IsArray(root);
+    
+    if (is_device_command) {
+        // This is a device command (LED, SongChange, SetVolume, etc.)
+        ESP_LOGI(SOMNUS_BLE_TAG, "[BLE] Device command detected, routing to action handler");
+        if (s_device_command_cb) {
+            esp_err_t err = s_device_command_cb(payload, s_device_command_ctx);
+            if (err == ESP_OK) {
+                somnus_ble_notify("Command executed");
+            } else {
+                char err_msg[64];
+                snprintf(err_msg, sizeof(err_msg), "Command failed: %s", esp_err_to_name(err));
+                somnus_ble_notify(err_msg);
+            }
+        } else {
+            ESP_LOGW(SOMNUS_BLE_TAG, "[BLE] Device command received but no handler registered");
+            somnus_ble_notify("Device command handler not available");
+        }
+        cJSON_Delete(root);
+        return;
+    }
+
+    // Check for BLE-specific actions (lowercase "action" field)
+    const cJSON *action = cJSON_GetObjectItemCaseSensitive(root, "action");
+    if (!cJSON_IsString(action) || action->valuestring == NULL) {
+        ESP_LOGW(SOMNUS_BLE_TAG, "[BLE] Missing or invalid 'action' field");
+        somnus_ble_notify("Unknown action");
+        cJSON_Delete(root);
+        return;
+    }
+
+    const somnus_ble_cmd_def_t *def = NULL;
+    for (size_t i = 0; i < sizeof(s_cmd_defs) / sizeof(s_cmd_defs[0]); i++) {
+        if (strcasecmp(action->valuestring, s_cmd_defs[i].action) == 0) {
+            def = &s_cmd_defs[i];
+            break;
+        }
+    }
+    if (def) {
+        ESP_LOGI(SOMNUS_BLE_TAG, "[BLE] Handling %s action", def->action);
+        somnus_ble_cmd_args_t args;
+        somnus_ble_args_from_json(root, &args);
+        const somnus_ble_reply_t reply = {.binary = false, .cmd = def->id};
+        def->handler(&args, &reply);
+    } else {
+        ESP_LOGW(SOMNUS_BLE_TAG, "[BLE] Unknown action: %s", action->valuestring);
+        somnus_ble_notify("Unknown action");
+    }
+
+    cJSON_Delete(root);
+}
+
+// Text replies for device commands share the "Command executed" wording
+static void somnus_ble_reply_result(const somnus_ble_reply_t *reply, esp_err_t err)
+{
+    if (reply->binary) {
+        somnus_ble_bin_status(reply, somnus_ble_bin_status_from_err(err));
+    } else if (err == ESP_OK) {
+        somnus_ble_notify("Command executed");
+    } else {
+        char err_msg[64];
+        snprintf(err_msg, sizeof(err_msg), "Command failed: %s", esp_err_to_name(err));
+        somnus_ble_notify(err_msg);
+    }
+}
+
+/*
+ * Without a typed callback the control is handed to the device command
+ * handler as the equivalent Somnus action, so existing apps keep working.
+ */
+static esp_err_t somnus_ble_forward_device_command(const char *json)
+{
+    if (!s_device_command_cb) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    return s_device_command_cb(json, s_device_command_ctx);
+}
+
+static void somnus_ble_handle_set_led_action(const somnus_ble_cmd_args_t *args, const somnus_ble_reply_t *reply)
+{
+    if (!args->has_rgb && !args->has_brightness) {
+        somnus_ble_reply_result(reply, ESP_ERR_INVALID_ARG);
+        return;
+    }
+    float brightness = args->brightness < 0 ? 0 : args->brightness > 1 ? 1 : args->brightness;
+
+    esp_err_t err;
+    if (s_set_led_cb) {
+        err = s_set_led_cb(args->has_rgb ? args->rgb : NULL,
+                           args->has_brightness ? brightness : -1.0f,
+                           s_set_led_ctx);
+    } else {
+        char json[128];
+        if (args->has_rgb) {
+            snprintf(json, sizeof(json),
+                     "{\"Action\":\"LED\",\"Data\":{\"Color\":[%u,%u,%u],\"Intensity\":%.2f}}",
+                     args->rgb[0], args->rgb[1], args->rgb[2],
+                     args->has_brightness ? brightness : 1.0f);
+        } else {
+            snprintf(json, sizeof(json),
+                     "{\"Action\":\"SetLEDIntensity\",\"Data\":{\"Intensity\":%.2f}}", brightness);
+        }
+        err = somnus_ble_forward_device_command(json);
+    }
+    somnus_ble_reply_result(reply, err);
+}
+
+static void somnus_ble_handle_set_volume_action(const somnus_ble_cmd_args_t *args, const somnus_ble_reply_t *reply)
+{
+    if (!args->has_volume) {
+        somnus_ble_reply_result(reply, ESP_ERR_INVALID_ARG);
+        return;
+    }
+    float volume = args->volume < 0 ? 0 : args->volume > 1 ? 1 : args->volume;
+
+    esp_err_t err;
+    if (s_set_volume_cb) {
+        err = s_set_volume_cb(volume, s_set_volume_ctx);
+    } else {
+        char json[64];
+        snprintf(json, sizeof(json), "{\"Action\":\"SetVolume\",\"Data\":{\"Volume\":%.2f}}", volume);
+        err = somnus_ble_forward_device_command(json);
+    }
+    somnus_ble_reply_result(reply, err);
+}
+
+static void somnus_ble_handle_get_stats_action(const somnus_ble_cmd_args_t *args, const somnus_ble_reply_t *reply)
+{
+    somnus_ble_stats_t stats;
+    somnus_ble_get_stats(&stats);
+    if (args->reset) {
+        somnus_ble_reset_stats();
+    }
+
+    if (reply->binary) {
+        somnus_ble_bin_frame_t frame;
+        somnus_ble_bin_begin(&frame, reply, SOMNUS_BLE_BIN_OK);
+        const uint32_t *counters = &stats.rx_writes;
+        for (size_t i = 0; i < offsetof(somnus_ble_stats_t, mtu) / sizeof(uint32_t); i++) {
+            somnus_ble_bin_put_uint(&frame, SOMNUS_BLE_TLV_STATS_BASE + i, counters[i], 4);
+        }
+        somnus_ble_bin_put_uint(&frame, SOMNUS_BLE_TLV_LINK_BASE + 0, stats.mtu, 2);
+        somnus_ble_bin_put_u8(&frame, SOMNUS_BLE_TLV_LINK_BASE + 1, stats.tx_phy);
+        somnus_ble_bin_put_u8(&frame, SOMNUS_BLE_TLV_LINK_BASE + 2, stats.rx_phy);
+        somnus_ble_bin_put_uint(&frame, SOMNUS_BLE_TLV_LINK_BASE + 3, stats.conn_itvl, 2);
+        somnus_ble_bin_put_uint(&frame, SOMNUS_BLE_TLV_LINK_BASE + 4, stats.conn_latency, 2);
+        somnus_ble_bin_put_uint(&frame, SOMNUS_BLE_TLV_LINK_BASE + 5, stats.supervision_tmo, 2);
+        if (somnus_ble_bin_send(&frame) != ESP_OK) {
+            somnus_ble_bin_status(reply, SOMNUS_BLE_BIN_FAILED);
+        }
+        return;
+    }
+
+    cJSON *root = cJSON_CreateObject();
+    cJSON_AddNumberToObject(root, "rx_writes", stats.rx_writes);
+    cJSON_AddNumberToObject(root, "rx_bytes", stats.rx_bytes);
+    cJSON_AddNumberToObject(root, "bin_writes", stats.bin_writes);
+    cJSON_AddNumberToObject(root, "bin_bytes", stats.bin_bytes);
+    cJSON_AddNumberToObject(root, "queue_drops", stats.queue_drops);
+    cJSON_AddNumberToObject(root, "coalesced", stats.coalesced);
+    cJSON_AddNumberToObject(root, "commands", stats.commands);
+    cJSON_AddNumberToObject(root, "notify_count", stats.notify_count);
+    cJSON_AddNumberToObject(root, "notify_bytes", stats.notify_bytes);
+    cJSON_AddNumberToObject(root, "notify_failures", stats.notify_failures);
+    cJSON_AddNumberToObject(root, "mbuf_waits", stats.mbuf_waits);
+    cJSON_AddNumberToObject(root, "mbuf_failures", stats.mbuf_failures);
+    cJSON_AddNumberToObject(root, "bulk_frames", stats.bulk_frames);
+    cJSON_AddNumberToObject(root, "bulk_retransmits", stats.bulk_retransmits);
+    cJSON_AddNumberToObject(root, "mtu", stats.mtu);
+    cJSON_AddNumberToObject(root, "tx_phy", stats.tx_phy);
+    cJSON_AddNumberToObject(root, "rx_phy", stats.rx_phy);
+    cJSON_AddNumberToObject(root, "interval_ms", stats.conn_itvl * 1.25);
+    cJSON_AddNumberToObject(root, "latency", stats.conn_latency);
+    cJSON_AddNumberToObject(root, "supervision_ms", stats.supervision_tmo * 10);
+    char *json = cJSON_PrintUnformatted(root);
+    cJSON_Delete(root);
+    if (json) {
+        somnus_ble_notify("STATS_START");
+        somnus_ble_send_chunked(json, 0);
+        somnus_ble_notify("STATS_END");
+        cJSON_free(json);
+    } else {
+        somnus_ble_notify("STATS_ERROR");
+    }
+}
+
+/*
+ * Link settings for load tests. The interval is pinned until the next
+ * disconnect (0 gives it back to the bulk/idle logic); the PHY is a
+ * preference the phone may refuse. Either way GET_STATS shows what the
+ * controllers settled on once the update completes.
+ */
+static void somnus_ble_handle_set_link_action(const somnus_ble_cmd_args_t *args, const somnus_ble_reply_t *reply)
+{
+    portENTER_CRITICAL(&s_state_lock);
+    uint16_t conn = s_conn_handle;
+    bool fast = s_bulk_fast;
+    portEXIT_CRITICAL(&s_state_lock);
+
+    bool interval_ok = !args->has_interval || args->interval == 0 ||
+                       (args->interval >= SOMNUS_BLE_PIN_ITVL_MIN && args->interval <= SOMNUS_BLE_PIN_ITVL_MAX);
+    esp_err_t err = ESP_OK;
+    if (conn == BLE_HS_CONN_HANDLE_NONE) {
+        err = ESP_ERR_INVALID_STATE;
+    } else if (!interval_ok || args->phy > 2 || (!args->has_interval && !args->phy)) {
+        err = ESP_ERR_INVALID_ARG;
+    }
+    if (err == ESP_OK && args->has_interval) {
+        __atomic_store_n(&s_pinned_itvl, args->interval, __ATOMIC_RELEASE);
+        somnus_ble_set_conn_params(conn, fast);
+    }
+    if (err == ESP_OK && args->phy) {
+#if CONFIG_BT_NIMBLE_LL_CFG_FEAT_LE_2M_PHY
+        uint8_t mask = args->phy == 2 ? BLE_GAP_LE_PHY_2M_MASK : BLE_GAP_LE_PHY_1M_MASK;
+        err = ble_gap_set_prefered_le_phy(conn, mask, mask, BLE_GAP_LE_PHY_CODED_ANY) == 0 ? ESP_OK : ESP_FAIL;
+#else
+        err = ESP_ERR_NOT_SUPPORTED;
+#endif
+    }
+    somnus_ble_reply_result(reply, err);
+}
+
+/*
+ * Round trip for load tests. The payload comes back as sent, padded with a
+ * counting pattern up to `size`: in one binary frame, as one text message
+ * on TX ("ECHO:" + payload, split by MTU), or with `bulk` as a raw bulk
+ * transfer acknowledged by the payload alone once it completes.
+ */
+static void somnus_ble_handle_echo_action(const somnus_ble_cmd_args_t *args, const somnus_ble_reply_t *reply)
 {
-    (void)param;
-    somnus_ble_cmd_msg_t msg;
-    ESP_LOGI(SOMNUS_BLE_TAG, "[BLE] Command task started - waiting for messages");
-    while (xQueueReceive(s_cmd_queue, &msg, portMAX_DELAY) == pdTRUE) {
-        ESP_LOGI(SOMNUS_BLE_TAG, "[BLE] Processing command[%zu]: %.*s", msg.len, (int)msg.len, msg.payload);
-        somnus_ble_handle_command(msg.payload);
-        ESP_LOGD(SOMNUS_BLE_TAG, "[BLE] Command processing complete");
+    size_t size = args->size > args->data_len ? args->size : args->data_len;
+    esp_err_t err = ESP_OK;
+
+    if (args->bulk) {
+        uint8_t *buf = NULL;
+        if (size == 0 || size > SOMNUS_BLE_ECHO_BULK_MAX_BYTES) {
+            err = ESP_ERR_INVALID_ARG;
+        } else if (!somnus_ble_bulk_is_ready()) {
+            err = ESP_ERR_INVALID_STATE;
+        } else if (!(buf = malloc(size))) {
+            err = ESP_ERR_NO_MEM;
+        }
+        if (err == ESP_OK) {
+            if (args->data_len) {
+                memcpy(buf, args->data, args->data_len);
+            }
+            for (size_t i = args->data_len; i < size; i++) {
+                buf[i] = (uint8_t)i;
+            }
+            err = somnus_ble_bulk_send(SOMNUS_BLE_BULK_KIND_RAW, buf, size, 30000);
+        }
+        free(buf);
+        size = args->data_len;
+    }
+
+    if (reply->binary) {
+        somnus_ble_bin_frame_t frame;
+        uint8_t body[SOMNUS_BLE_BIN_FRAME_MAX];
+        if (err == ESP_OK && size > sizeof(body)) {
+            err = ESP_ERR_INVALID_ARG;
+        }
+        if (err == ESP_OK) {
+            if (args->data_len) {
+                memcpy(body, args->data, args->data_len);
+            }
+            for (size_t i = args->data_len; i < size; i++) {
+                body[i] = (uint8_t)i;
+            }
+            somnus_ble_bin_begin(&frame, reply, SOMNUS_BLE_BIN_OK);
+            somnus_ble_bin_put(&frame, SOMNUS_BLE_TLV_DATA, body, size);
+            // Too big for the frame or the MTU: the framing limit is what is being tested
+            err = frame.overflow ? ESP_ERR_INVALID_ARG : somnus_ble_bin_send(&frame);
+        }
+        if (err != ESP_OK) {
+            somnus_ble_bin_status(reply, somnus_ble_bin_status_from_err(err));
+        }
+        return;
+    }
+
+    char *text = NULL;
+    if (err == ESP_OK && size > SOMNUS_BLE_ECHO_MAX_BYTES) {
+        err = ESP_ERR_INVALID_ARG;
+    } else if (err == ESP_OK && !(text = malloc(5 + size + 1))) {
+        err = ESP_ERR_NO_MEM;
+    }
+    if (err == ESP_OK) {
+        // Text stays printable: '.' pads instead of the counting pattern
+        memcpy(text, "ECHO:", 5);
+        if (args->data_len) {
+            memcpy(text + 5, args->data, args->data_len);
+        }
+        memset(text + 5 + args->data_len, '.', size - args->data_len);
+        text[5 + size] = '\0';
+        somnus_ble_send_chunked(text, 0);
+    } else {
+        char msg[48];
+        snprintf(msg, sizeof(msg), "ECHO_ERROR: %s", esp_err_to_name(err));
+        somnus_ble_notify(msg);
     }
+    free(text);
 }
 
-static void somnus_ble_handle_command(const char *payload)
+static void somnus_ble_handle_get_logs_action(const somnus_ble_cmd_args_t *args, const somnus_ble_reply_t *reply)
 {
-    if (!payload || payload[0] == '\0') {
-        ESP_LOGW(SOMNUS_BLE_TAG, "[BLE] Empty command payload");
+    (void)args;
+
+    if (!somnus_ble_bulk_is_ready()) {
+        if (reply->binary) {
+            somnus_ble_bin_status(reply, SOMNUS_BLE_BIN_FAILED);
+        } else {
+            somnus_ble_notify("LOGS_ERROR: subscribe to the bulk characteristic");
+        }
         return;
     }
 
-    ESP_LOGD(SOMNUS_BLE_TAG, "[BLE] Parsing JSON command: %s", payload);
-    cJSON *root = cJSON_Parse(payload);
-    if (!root) {
-        ESP_LOGW(SOMNUS_BLE_TAG, "[BLE] JSON parse failed for payload: %s", payload);
-        somnus_ble_notify("Bad JSON format");
-        return;
+    char *json = NULL;
+    esp_err_t err = somnus_ble_get_logs(&json, 0);
+    if (err == ESP_OK && json) {
+        err = somnus_ble_bulk_send(SOMNUS_BLE_BULK_KIND_BLE_LOGS, json, strlen(json), 30000);
+    } else if (err == ESP_OK) {
+        err = ESP_FAIL;
     }
+    cJSON_free(json);
 
-    // Check for device command format (Action with capital A, or array of actions)
-    const cJSON *action_capital = cJSON_GetObjectItemCaseSensitive(root, "Action");
-    bool is_device_command = (action_capital != NULL && cJSON_IsString(action_capital)) || cJSON_IsArray(root);
-    
-    if (is_device_command) {
-        // This is a device command (LED, SongChange, SetVolume, etc.)
-        ESP_LOGI(SOMNUS_BLE_TAG, "[BLE] Device command detected, routing to action handler");
-        if (s_device_command_cb) {
-            esp_err_t err = s_device_command_cb(payload, s_device_command_ctx);
-            if (err == ESP_OK) {
-                somnus_ble_notify("Command executed");
-            } else {
-                char err_msg[64];
-                snprintf(err_msg, sizeof(err_msg), "Command failed: %s", esp_err_to_name(err));
-                somnus_ble_notify(err_msg);
-            }
+    if (reply->binary) {
+        somnus_ble_bin_status(reply, somnus_ble_bin_status_from_err(err));
+    } else if (err != ESP_OK) {
+        char msg[48];
+        snprintf(msg, sizeof(msg), "LOGS_ERROR: %s", esp_err_to_name(err));
+        somnus_ble_notify(msg);
+    }
+}
+
+static void somnus_ble_handle_read_history_action(const somnus_ble_cmd_args_t *args, const somnus_ble_reply_t *reply)
+{
+#ifdef CONFIG_SENSOR_MANAGER_ENABLED
+    if (!somnus_ble_bulk_is_ready()) {
+        if (reply->binary) {
+            somnus_ble_bin_status(reply, SOMNUS_BLE_BIN_FAILED);
         } else {
-            ESP_LOGW(SOMNUS_BLE_TAG, "[BLE] Device command received but no handler registered");
-            somnus_ble_notify("Device command handler not available");
+            somnus_ble_notify("HISTORY_ERROR: subscribe to the bulk characteristic");
         }
-        cJSON_Delete(root);
         return;
     }
 
-    // Check for BLE-specific actions (lowercase "action" field)
-    const cJSON *action = cJSON_GetObjectItemCaseSensitive(root, "action");
-    if (!cJSON_IsString(action) || action->valuestring == NULL) {
-        ESP_LOGW(SOMNUS_BLE_TAG, "[BLE] Missing or invalid 'action' field");
-        somnus_ble_notify("Unknown action");
-        cJSON_Delete(root);
-        return;
+    // A missing end is now; a missing range is the last day
+    uint32_t now = (uint32_t)time(NULL);
+    uint32_t to_s = args->has_range && args->to_s ? args->to_s : now;
+    uint32_t from_s = args->has_range ? args->from_s
+                                      : (to_s > SOMNUS_BLE_HISTORY_DEFAULT_S ? to_s - SOMNUS_BLE_HISTORY_DEFAULT_S : 0);
+    uint8_t *data = NULL;
+    size_t len = 0;
+    esp_err_t err = from_s <= to_s ? ESP_OK : ESP_ERR_INVALID_ARG;
+    if (err == ESP_OK) {
+        err = sensor_history_export(from_s, to_s, SENSOR_HISTORY_TIER_AUTO, SOMNUS_BLE_HISTORY_MAX_BYTES, &data,
+                                    &len);
     }
+    if (err == ESP_OK) {
+        err = somnus_ble_bulk_send(SOMNUS_BLE_BULK_KIND_HISTORY, data, len, 30000);
+    }
+    free(data);
 
-    ESP_LOGI(SOMNUS_BLE_TAG, "[BLE] Executing BLE action: %s", action->valuestring);
-    if (strcasecmp(action->valuestring, "SCAN") == 0) {
-        ESP_LOGI(SOMNUS_BLE_TAG, "[BLE] Handling SCAN action");
-        somnus_ble_handle_scan_action();
-    } else if (strcasecmp(action->valuestring, "CONNECT_WIFI") == 0) {
-        ESP_LOGI(SOMNUS_BLE_TAG, "[BLE] Handling CONNECT_WIFI action");
-        somnus_ble_handle_connect_action(root);
-    } else if (strcasecmp(action->valuestring, "READ_SENSORS") == 0) {
-        ESP_LOGI(SOMNUS_BLE_TAG, "[BLE] Handling READ_SENSORS action");
-        somnus_ble_handle_read_sensors_action();
+    if (reply->binary) {
+        somnus_ble_bin_status(reply, somnus_ble_bin_status_from_err(err));
+    } else if (err != ESP_OK) {
+        char msg[48];
+        snprintf(msg, sizeof(msg), "HISTORY_ERROR: %s", esp_err_to_name(err));
+        somnus_ble_notify(msg);
+    }
+#else
+    (void)args;
+    if (reply->binary) {
+        somnus_ble_bin_status(reply, SOMNUS_BLE_BIN_UNSUPPORTED);
     } else {
-        ESP_LOGW(SOMNUS_BLE_TAG, "[BLE] Unknown action: %s", action->valuestring);
-        somnus_ble_notify("Unknown action");
+        somnus_ble_notify("HISTORY_ERROR: sensor manager not enabled");
     }
+#endif
+}
 
-    cJSON_Delete(root);
+#ifdef CONFIG_SENSOR_MANAGER_ENABLED
+static void somnus_ble_send_sensors_binary(const sensor_integration_data_t *sensor_data, const somnus_ble_reply_t *reply)
+{
+    somnus_ble_bin_frame_t frame;
+    somnus_ble_bin_begin(&frame, reply, SOMNUS_BLE_BIN_OK);
+    // Tags follow the field order of the JSON response; absent sensors are omitted
+    if (sensor_data->sht45_available) {
+        somnus_ble_bin_put_scaled(&frame, SOMNUS_BLE_TLV_SENSOR_BASE + 0, sensor_data->temperature_c);
+        somnus_ble_bin_put_scaled(&frame, SOMNUS_BLE_TLV_SENSOR_BASE + 1, sensor_data->humidity_rh);
+    }
+    if (sensor_data->sgp40_available) {
+        somnus_ble_bin_put_scaled(&frame, SOMNUS_BLE_TLV_SENSOR_BASE + 2, sensor_data->voc_index);
+        somnus_ble_bin_put_scaled(&frame, SOMNUS_BLE_TLV_SENSOR_BASE + 3, sensor_data->voc_ticks);
+    }
+    if (sensor_data->scd40_available) {
+        somnus_ble_bin_put_scaled(&frame, SOMNUS_BLE_TLV_SENSOR_BASE + 4, sensor_data->co2_ppm);
+        somnus_ble_bin_put_scaled(&frame, SOMNUS_BLE_TLV_SENSOR_BASE + 5, sensor_data->temperature_co2_c);
+        somnus_ble_bin_put_scaled(&frame, SOMNUS_BLE_TLV_SENSOR_BASE + 6, sensor_data->humidity_co2_rh);
+    }
+    if (sensor_data->vcnl4040_available) {
+        somnus_ble_bin_put_scaled(&frame, SOMNUS_BLE_TLV_SENSOR_BASE + 7, sensor_data->ambient_lux);
+        somnus_ble_bin_put_scaled(&frame, SOMNUS_BLE_TLV_SENSOR_BASE + 8, sensor_data->proximity);
+    }
+    if (sensor_data->ec10_available) {
+        somnus_ble_bin_put_scaled(&frame, SOMNUS_BLE_TLV_SENSOR_BASE + 9, sensor_data->ec_ms_per_cm);
+        somnus_ble_bin_put_scaled(&frame, SOMNUS_BLE_TLV_SENSOR_BASE + 10, sensor_data->pm1_0_ug_m3);
+        somnus_ble_bin_put_scaled(&frame, SOMNUS_BLE_TLV_SENSOR_BASE + 11, sensor_data->pm10_ug_m3);
+    }
+    if (somnus_ble_bin_send(&frame) != ESP_OK) {
+        somnus_ble_bin_status(reply, SOMNUS_BLE_BIN_FAILED);
+    }
 }
+#endif
 
-static void somnus_ble_handle_read_sensors_action(void)
+static void somnus_ble_handle_read_sensors_action(const somnus_ble_cmd_args_t *args, const somnus_ble_reply_t *reply)
 {
+    (void)args;
 #ifdef CONFIG_SENSOR_MANAGER_ENABLED
     ESP_LOGI(SOMNUS_BLE_TAG, "[BLE] Reading sensor data");
     
     sensor_integration_data_t sensor_data = sensor_integration_get_data();
+    if (reply->binary) {
+        somnus_ble_send_sensors_binary(&sensor_data, reply);
+        return;
+    }
     
     cJSON *root = cJSON_CreateObject();
     cJSON *sensors = cJSON_CreateObject();
@@ -795,7 +2393,7 @@ static void somnus_ble_handle_read_sensors_action(void)
     if (sensor_data.sgp40_available) {
         cJSON *sgp40 = cJSON_CreateObject();
         cJSON_AddNumberToObject(sgp40, "voc_index", sensor_data.voc_index);
-        cJSON_AddNumberToObject(sgp40, "voc_ticks", sensor_data.voc_index * 10); // Approximate
+        cJSON_AddNumberToObject(sgp40, "voc_ticks", sensor_data.voc_ticks);
         cJSON_AddBoolToObject(sgp40, "synthetic", false);
         cJSON_AddItemToObject(sensors, "sgp40", sgp40);
     }
@@ -824,8 +2422,8 @@ static void somnus_ble_handle_read_sensors_action(void)
         cJSON *ec10 = cJSON_CreateObject();
         // EC10 stores PM2.5 in ec_ms_per_cm field
         cJSON_AddNumberToObject(ec10, "pm2_5_ug_m3", sensor_data.ec_ms_per_cm);
-        cJSON_AddNumberToObject(ec10, "pm1_0_ug_m3", sensor_data.ec_ms_per_cm * 0.5); // Estimate
-        cJSON_AddNumberToObject(ec10, "pm10_ug_m3", sensor_data.ec_ms_per_cm * 1.5); // Estimate
+        cJSON_AddNumberToObject(ec10, "pm1_0_ug_m3", sensor_data.pm1_0_ug_m3);
+        cJSON_AddNumberToObject(ec10, "pm10_ug_m3", sensor_data.pm10_ug_m3);
         cJSON_AddBoolToObject(ec10, "synthetic", false);
         cJSON_AddItemToObject(sensors, "ec10", ec10);
     }
@@ -836,9 +2434,9 @@ static void somnus_ble_handle_read_sensors_action(void)
     if (json) {
         ESP_LOGI(SOMNUS_BLE_TAG, "[BLE] Sending sensor data: %s", json);
         somnus_ble_notify("SENSOR_DATA_START");
-        somnus_ble_send_chunked(json, pdMS_TO_TICKS(50));
+        somnus_ble_send_chunked(json, 0);
         somnus_ble_notify("SENSOR_DATA_END");
-        free(json);
+        cJSON_free(json);
     } else {
         ESP_LOGE(SOMNUS_BLE_TAG, "[BLE] Failed to serialize sensor data");
         somnus_ble_notify("SENSOR_DATA_ERROR");
@@ -847,13 +2445,62 @@ static void somnus_ble_handle_read_sensors_action(void)
     cJSON_Delete(root);
 #else
     ESP_LOGW(SOMNUS_BLE_TAG, "[BLE] Sensor manager not enabled, cannot read sensors");
-    somnus_ble_notify("SENSOR_DATA_ERROR: Sensor manager not available");
+    if (reply->binary) {
+        somnus_ble_bin_status(reply, SOMNUS_BLE_BIN_UNSUPPORTED);
+    } else {
+        somnus_ble_notify("SENSOR_DATA_ERROR: Sensor manager not available");
+    }
 #endif
 }
 
-static void somnus_ble_handle_scan_action(void)
+static esp_err_t somnus_ble_emit_ap_binary(const wifi_ap_record_t *rec, void *ctx)
+{
+    somnus_ble_bin_frame_t frame;
+    somnus_ble_bin_begin(&frame, (const somnus_ble_reply_t *)ctx, SOMNUS_BLE_BIN_MORE);
+    somnus_ble_bin_put(&frame, SOMNUS_BLE_TLV_AP_SSID, rec->ssid, strnlen((const char *)rec->ssid, sizeof(rec->ssid)));
+    somnus_ble_bin_put(&frame, SOMNUS_BLE_TLV_AP_BSSID, rec->bssid, sizeof(rec->bssid));
+    somnus_ble_bin_put_u8(&frame, SOMNUS_BLE_TLV_AP_RSSI, (uint8_t)rec->rssi);
+    somnus_ble_bin_put_u8(&frame, SOMNUS_BLE_TLV_AP_AUTH, (uint8_t)rec->authmode);
+    somnus_ble_bin_put_u8(&frame, SOMNUS_BLE_TLV_AP_CHANNEL, rec->primary);
+    return somnus_ble_bin_send(&frame);
+}
+
+static esp_err_t somnus_ble_emit_ap_json(const wifi_ap_record_t *rec, void *ctx)
+{
+    (void)ctx;
+    cJSON *obj = somnus_ble_ap_record_to_json(rec);
+    char *json = obj ? cJSON_PrintUnformatted(obj) : NULL;
+    cJSON_Delete(obj);
+    if (!json) {
+        return ESP_ERR_NO_MEM;
+    }
+    esp_err_t err = somnus_ble_send_chunked(json, 0);
+    cJSON_free(json);
+    return err;
+}
+
+static void somnus_ble_handle_scan_action(const somnus_ble_cmd_args_t *args, const somnus_ble_reply_t *reply)
 {
-    ESP_LOGI(SOMNUS_BLE_TAG, "[BLE] Handling WiFi scan request");
+    // A scan takes the radio off the AP's channel for over a second
+    if (__atomic_load_n(&s_low_duty, __ATOMIC_ACQUIRE)) {
+        ESP_LOGI(SOMNUS_BLE_TAG, "[BLE] WiFi scan refused while audio is streaming");
+        if (reply->binary) {
+            somnus_ble_bin_status(reply, SOMNUS_BLE_BIN_BUSY);
+        } else {
+            somnus_ble_notify("WIFI_LIST_START");
+            somnus_ble_notify("WIFI_LIST_BUSY");
+            somnus_ble_notify("WIFI_LIST_END");
+        }
+        return;
+    }
+    ESP_LOGI(SOMNUS_BLE_TAG, "[BLE] Handling WiFi scan request%s", args->stream ? " (streaming)" : "");
+    if (reply->binary) {
+        // One MORE frame per network as its channel completes, then a final status frame
+        esp_err_t err = somnus_ble_scan_stream(somnus_ble_emit_ap_binary, (void *)reply);
+        ESP_LOGI(SOMNUS_BLE_TAG, "[BLE BIN] WiFi scan response complete: %s", esp_err_to_name(err));
+        somnus_ble_bin_status(reply, somnus_ble_bin_status_from_err(err));
+        return;
+    }
     
     // Always send WIFI_LIST_START to indicate scan beginning
     esp_err_t notify_err = somnus_ble_notify("WIFI_LIST_START");
@@ -864,7 +2511,25 @@ static void somnus_ble_handle_scan_action(void)
     // Small delay to ensure notification is sent before starting scan
     vTaskDelay(pdMS_TO_TICKS(100));
 
-    char *json = somnus_ble_perform_wifi_scan(NULL);
+    if (args->stream) {
+        // One JSON object per network instead of a single array at the end
+        esp_err_t err = somnus_ble_scan_stream(somnus_ble_emit_ap_json, NULL);
+        if (err == ESP_ERR_NO_MEM) {
+            somnus_ble_notify("WIFI_LIST_ERROR");
+        }
+        somnus_ble_notify("WIFI_LIST_END");
+        ESP_LOGI(SOMNUS_BLE_TAG, "[BLE] WiFi scan stream complete: %s", esp_err_to_name(err));
+        return;
+    }
+
+    wifi_ap_record_t *records = NULL;
+    uint16_t count = 0;
+    char *json = NULL;
+    // A scan that cannot run reports an empty list rather than an error
+    if (somnus_ble_scan_ap_records(&records, &count) != ESP_ERR_NO_MEM) {
+        json = somnus_ble_ap_records_to_json(records, count);
+    }
+    MEM_TAG_FREE(MEM_TAG_BLE, records);
     if (!json) {
         ESP_LOGE(SOMNUS_BLE_TAG, "[BLE] WiFi scan failed - memory allocation error");
         somnus_ble_notify("WIFI_LIST_ERROR");
@@ -882,12 +2547,12 @@ static void somnus_ble_handle_scan_action(void)
         ESP_LOGI(SOMNUS_BLE_TAG, "[BLE] WiFi scan complete, sending %zu bytes", json_len);
     }
     
-    esp_err_t send_err = somnus_ble_send_chunked(json, pdMS_TO_TICKS(50));
+    esp_err_t send_err = somnus_ble_send_chunked(json, 0);
     if (send_err != ESP_OK) {
         ESP_LOGW(SOMNUS_BLE_TAG, "[BLE] Failed to send WiFi scan results: %s", esp_err_to_name(send_err));
         // Still send END marker even if chunked send failed
     }
-    free(json);
+    cJSON_free(json);
 
     // Always send WIFI_LIST_END to indicate scan completion
     notify_err = somnus_ble_notify("WIFI_LIST_END");
@@ -898,56 +2563,51 @@ static void somnus_ble_handle_scan_action(void)
     ESP_LOGI(SOMNUS_BLE_TAG, "[BLE] WiFi scan response complete");
 }
 
-static void somnus_ble_handle_connect_action(const cJSON *root)
+static void somnus_ble_handle_connect_action(const somnus_ble_cmd_args_t *args, const somnus_ble_reply_t *reply)
 {
-    const cJSON *ssid = cJSON_GetObjectItemCaseSensitive(root, "ssid");
-    const cJSON *password = cJSON_GetObjectItemCaseSensitive(root, "password");
-    const cJSON *token = cJSON_GetObjectItemCaseSensitive(root, "user_token");
-    const cJSON *is_prod = cJSON_GetObjectItemCaseSensitive(root, "is_production");
-
-    if (!cJSON_IsString(ssid) || !cJSON_IsString(password) || !cJSON_IsString(token)) {
-        somnus_ble_notify("Missing ssid/password/token");
+    if (!args->ssid || !args->password || !args->user_token) {
+        if (reply->binary) {
+            somnus_ble_bin_status(reply, SOMNUS_BLE_BIN_INVALID_ARG);
+        } else {
+            somnus_ble_notify("Missing ssid/password/token");
+        }
         return;
     }
 
-    bool is_production = false;
-    if (cJSON_IsBool(is_prod)) {
-        is_production = cJSON_IsTrue(is_prod);
-    } else if (cJSON_IsString(is_prod)) {
-        is_production = strcasecmp(is_prod->valuestring, "true") == 0 ||
-                        strcmp(is_prod->valuestring, "1") == 0;
+    if (!reply->binary) {
+        char connecting_msg[96];
+        snprintf(connecting_msg, sizeof(connecting_msg), "Connecting to %s...", args->ssid);
+        somnus_ble_notify(connecting_msg);
     }
 
-    char connecting_msg[96];
-    snprintf(connecting_msg, sizeof(connecting_msg), "Connecting to %s...", ssid->valuestring);
-    somnus_ble_notify(connecting_msg);
-
     bool success = false;
     if (s_connect_cb) {
-        success = s_connect_cb(ssid->valuestring,
-                               password->valuestring,
-                               token->valuestring,
-                               is_production,
+        success = s_connect_cb(args->ssid,
+                               args->password,
+                               args->user_token,
+                               args->is_production,
                                s_connect_ctx);
     } else {
         ESP_LOGW(SOMNUS_BLE_TAG, "Connect callback not set");
     }
 
-    if (success) {
+    if (reply->binary) {
+        somnus_ble_bin_status(reply, success ? SOMNUS_BLE_BIN_OK : SOMNUS_BLE_BIN_FAILED);
+    } else if (success) {
         char connected_msg[96];
-        snprintf(connected_msg, sizeof(connected_msg), "Connected to %s", ssid->valuestring);
+        snprintf(connected_msg, sizeof(connected_msg), "Connected to %s", args->ssid);
         somnus_ble_notify(connected_msg);
     } else {
         somnus_ble_notify("Wi-Fi connection failed");
     }
 }
 
-static char *somnus_ble_perform_wifi_scan(size_t *out_len)
+// Bring Wi-Fi up in STA mode for scanning if nobody has
+static esp_err_t somnus_ble_scan_prepare(void)
 {
     // Check if WiFi is initialized and in a mode that supports scanning
     wifi_mode_t mode;
     esp_err_t err = esp_wifi_get_mode(&mode);
-    bool wifi_was_initialized = (err == ESP_OK);
     
     // If WiFi is not initialized, try to initialize it for scanning
     if (err != ESP_OK || mode == WIFI_MODE_NULL) {
@@ -976,33 +2636,21 @@ static char *somnus_ble_perform_wifi_scan(size_t *out_len)
         err = esp_wifi_init(&wifi_cfg);
         if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) {
             ESP_LOGE(SOMNUS_BLE_TAG, "[BLE] Failed to initialize WiFi for scan: %s", esp_err_to_name(err));
-            char *empty = strdup("[]");
-            if (out_len) {
-                *out_len = 2;
-            }
-            return empty;
+            return err;
         }
         
         // Set WiFi to STA mode for scanning
         err = esp_wifi_set_mode(WIFI_MODE_STA);
         if (err != ESP_OK) {
             ESP_LOGE(SOMNUS_BLE_TAG, "[BLE] Failed to set WiFi mode to STA: %s", esp_err_to_name(err));
-            char *empty = strdup("[]");
-            if (out_len) {
-                *out_len = 2;
-            }
-            return empty;
+            return err;
         }
         
         // Start WiFi - required for scanning
         err = esp_wifi_start();
         if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) {
             ESP_LOGE(SOMNUS_BLE_TAG, "[BLE] Failed to start WiFi for scan: %s", esp_err_to_name(err));
-            char *empty = strdup("[]");
-            if (out_len) {
-                *out_len = 2;
-            }
-            return empty;
+            return err;
         }
         
         // Small delay to allow WiFi to start
@@ -1012,11 +2660,7 @@ static char *somnus_ble_perform_wifi_scan(size_t *out_len)
         err = esp_wifi_get_mode(&mode);
         if (err != ESP_OK || (mode != WIFI_MODE_STA && mode != WIFI_MODE_APSTA)) {
             ESP_LOGW(SOMNUS_BLE_TAG, "[BLE] WiFi mode not suitable for scanning after init: %d", mode);
-            char *empty = strdup("[]");
-            if (out_len) {
-                *out_len = 2;
-            }
-            return empty;
+            return err != ESP_OK ? err : ESP_ERR_INVALID_STATE;
         }
         
         ESP_LOGI(SOMNUS_BLE_TAG, "[BLE] WiFi initialized in STA mode for scanning");
@@ -1025,19 +2669,23 @@ static char *somnus_ble_perform_wifi_scan(size_t *out_len)
     // WiFi must be in STA or APSTA mode to scan
     if (mode != WIFI_MODE_STA && mode != WIFI_MODE_APSTA) {
         ESP_LOGW(SOMNUS_BLE_TAG, "[BLE] WiFi mode (%d) does not support scanning, need STA or APSTA", mode);
-        char *empty = strdup("[]");
-        if (out_len) {
-            *out_len = 2;
-        }
-        return empty;
+        return ESP_ERR_INVALID_STATE;
     }
     
     ESP_LOGI(SOMNUS_BLE_TAG, "[BLE] Starting WiFi scan (mode=%d)", mode);
+    return ESP_OK;
+}
 
+/*
+ * One blocking scan of `channel` (0 for all). Fills up to *count records,
+ * strongest first, and sets *count to the number stored.
+ */
+static esp_err_t somnus_ble_scan_pass(uint8_t channel, wifi_ap_record_t *records, uint16_t *count)
+{
     wifi_scan_config_t scan_cfg = {
         .ssid = NULL,
         .bssid = NULL,
-        .channel = 0,
+        .channel = channel,
         .show_hidden = true,
         .scan_type = WIFI_SCAN_TYPE_ACTIVE,
         .scan_time.active = {
@@ -1047,138 +2695,200 @@ static char *somnus_ble_perform_wifi_scan(size_t *out_len)
     };
 
     // Start WiFi scan (blocking call - waits for scan to complete)
-    err = esp_wifi_scan_start(&scan_cfg, true);
+    esp_err_t err = esp_wifi_scan_start(&scan_cfg, true);
     if (err != ESP_OK) {
         ESP_LOGE(SOMNUS_BLE_TAG, "[BLE] Wi-Fi scan start failed: %s", esp_err_to_name(err));
-        // Return empty list instead of NULL for graceful handling
-        char *empty = strdup("[]");
-        if (out_len) {
-            *out_len = 2;
-        }
-        return empty;
+        return err;
     }
     
-    ESP_LOGI(SOMNUS_BLE_TAG, "[BLE] WiFi scan completed, retrieving results");
+    ESP_LOGD(SOMNUS_BLE_TAG, "[BLE] WiFi scan of channel %u completed, retrieving results", channel);
 
-    uint16_t ap_num = 0;
-    err = esp_wifi_scan_get_ap_num(&ap_num);
+    // Also frees the driver's list, so it is called even when nothing was found
+    err = esp_wifi_scan_get_ap_records(count, records);
     if (err != ESP_OK) {
-        ESP_LOGW(SOMNUS_BLE_TAG, "Wi-Fi get ap num failed (%s)", esp_err_to_name(err));
-        // Return empty list instead of NULL for graceful handling
-        char *empty = strdup("[]");
-        if (out_len) {
-            *out_len = 2;
-        }
-        return empty;
+        ESP_LOGW(SOMNUS_BLE_TAG, "Wi-Fi get ap records failed (%s)", esp_err_to_name(err));
+        *count = 0;
     }
+    return err;
+}
 
-    if (ap_num > SOMNUS_WIFI_SCAN_MAX_AP) {
-        ap_num = SOMNUS_WIFI_SCAN_MAX_AP;
-    }
-    if (ap_num == 0) {
-        char *empty = strdup("[]");
-        if (out_len) {
-            *out_len = 2;
-        }
-        return empty;
+/*
+ * Run a blocking scan of every channel. On success *out_records holds
+ * *out_count entries (possibly none) for the caller to MEM_TAG_FREE(MEM_TAG_BLE).
+ */
+static esp_err_t somnus_ble_scan_ap_records(wifi_ap_record_t **out_records, uint16_t *out_count)
+{
+    *out_records = NULL;
+    *out_count = 0;
+
+    esp_err_t err = somnus_ble_scan_prepare();
+    if (err != ESP_OK) {
+        return err;
     }
 
-    wifi_ap_record_t *ap_records = calloc(ap_num, sizeof(wifi_ap_record_t));
+    uint16_t ap_num = SOMNUS_WIFI_SCAN_MAX_AP;
+    wifi_ap_record_t *ap_records = MEM_TAG_CALLOC(MEM_TAG_BLE, ap_num, sizeof(wifi_ap_record_t));
     if (!ap_records) {
-        return NULL;
+        return ESP_ERR_NO_MEM;
     }
 
-    err = esp_wifi_scan_get_ap_records(&ap_num, ap_records);
+    err = somnus_ble_scan_pass(0, ap_records, &ap_num);
     if (err != ESP_OK) {
-        ESP_LOGW(SOMNUS_BLE_TAG, "Wi-Fi get ap records failed (%s)", esp_err_to_name(err));
-        free(ap_records);
-        // Return empty list instead of NULL for graceful handling
-        char *empty = strdup("[]");
-        if (out_len) {
-            *out_len = 2;
+        MEM_TAG_FREE(MEM_TAG_BLE, ap_records);
+        return err;
+    }
+
+    *out_records = ap_records;
+    *out_count = ap_num;
+    return ESP_OK;
+}
+
+/*
+ * Sweep the country's channels one at a time and hand every network to
+ * `emit` as soon as its channel is done, rather than after the whole sweep.
+ * An AP overheard on a neighbouring channel is reported once. Stops early if
+ * `emit` fails, and returns that error.
+ */
+static esp_err_t somnus_ble_scan_stream(somnus_ble_scan_emit_t emit, void *ctx)
+{
+    esp_err_t err = somnus_ble_scan_prepare();
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    uint8_t first = 1;
+    uint8_t last = 13;
+    wifi_country_t country;
+    if (esp_wifi_get_country(&country) == ESP_OK && country.nchan > 0) {
+        first = country.schan;
+        last = country.schan + country.nchan - 1;
+    }
+
+    wifi_ap_record_t *records = MEM_TAG_CALLOC(MEM_TAG_BLE, SOMNUS_WIFI_SCAN_MAX_AP, sizeof(wifi_ap_record_t));
+    uint8_t (*seen)[6] = MEM_TAG_CALLOC(MEM_TAG_BLE, SOMNUS_WIFI_SCAN_MAX_AP, 6);
+    if (!records || !seen) {
+        MEM_TAG_FREE(MEM_TAG_BLE, records);
+        MEM_TAG_FREE(MEM_TAG_BLE, seen);
+        return ESP_ERR_NO_MEM;
+    }
+
+    size_t seen_count = 0;
+    for (uint8_t channel = first; channel <= last && seen_count < SOMNUS_WIFI_SCAN_MAX_AP; channel++) {
+        uint16_t count = SOMNUS_WIFI_SCAN_MAX_AP;
+        if (somnus_ble_scan_pass(channel, records, &count) != ESP_OK) {
+            continue; // One bad channel should not cost the rest of the list
+        }
+        for (uint16_t i = 0; i < count && seen_count < SOMNUS_WIFI_SCAN_MAX_AP; i++) {
+            const wifi_ap_record_t *rec = &records[i];
+            if (rec->ssid[0] == '\0') {
+                continue;
+            }
+            bool duplicate = false;
+            for (size_t j = 0; j < seen_count && !duplicate; j++) {
+                duplicate = memcmp(seen[j], rec->bssid, 6) == 0;
+            }
+            if (duplicate) {
+                continue;
+            }
+            memcpy(seen[seen_count++], rec->bssid, 6);
+            err = emit(rec, ctx);
+            if (err != ESP_OK) {
+                goto done;
+            }
         }
-        return empty;
     }
+    ESP_LOGI(SOMNUS_BLE_TAG, "[BLE] Streamed %zu networks from channels %u-%u", seen_count, first, last);
+
+done:
+    MEM_TAG_FREE(MEM_TAG_BLE, seen);
+    MEM_TAG_FREE(MEM_TAG_BLE, records);
+    return err;
+}
+
+static cJSON *somnus_ble_ap_record_to_json(const wifi_ap_record_t *rec)
+{
+    cJSON *obj = cJSON_CreateObject();
+    if (!obj) {
+        return NULL;
+    }
+
+    cJSON_AddStringToObject(obj, "ssid", (const char *)rec->ssid);
+
+    char mac_buf[18];
+    snprintf(mac_buf, sizeof(mac_buf),
+             "%02X:%02X:%02X:%02X:%02X:%02X",
+             rec->bssid[0],
+             rec->bssid[1],
+             rec->bssid[2],
+             rec->bssid[3],
+             rec->bssid[4],
+             rec->bssid[5]);
+    cJSON_AddStringToObject(obj, "mac", mac_buf);
+
+    // Add RSSI (signal strength)
+    cJSON_AddNumberToObject(obj, "rssi", rec->rssi);
+
+    // Add auth mode (security type)
+    const char *auth_str = "Unknown";
+    switch (rec->authmode) {
+    case WIFI_AUTH_OPEN:
+        auth_str = "Open";
+        break;
+    case WIFI_AUTH_WEP:
+        auth_str = "WEP";
+        break;
+    case WIFI_AUTH_WPA_PSK:
+        auth_str = "WPA";
+        break;
+    case WIFI_AUTH_WPA2_PSK:
+        auth_str = "WPA2";
+        break;
+    case WIFI_AUTH_WPA_WPA2_PSK:
+        auth_str = "WPA/WPA2";
+        break;
+    case WIFI_AUTH_WPA2_ENTERPRISE:
+        auth_str = "WPA2-Enterprise";
+        break;
+    case WIFI_AUTH_WPA3_PSK:
+        auth_str = "WPA3";
+        break;
+    case WIFI_AUTH_WPA2_WPA3_PSK:
+        auth_str = "WPA2/WPA3";
+        break;
+    case WIFI_AUTH_WAPI_PSK:
+        auth_str = "WAPI";
+        break;
+    default:
+        auth_str = "Unknown";
+        break;
+    }
+    cJSON_AddStringToObject(obj, "auth", auth_str);
 
+    return obj;
+}
+
+static char *somnus_ble_ap_records_to_json(const wifi_ap_record_t *records, uint16_t count)
+{
     cJSON *array = cJSON_CreateArray();
     if (!array) {
-        free(ap_records);
         return NULL;
     }
 
-    for (uint16_t i = 0; i < ap_num; ++i) {
-        wifi_ap_record_t *rec = &ap_records[i];
+    for (uint16_t i = 0; i < count; ++i) {
+        const wifi_ap_record_t *rec = &records[i];
         if (rec->ssid[0] == '\0') {
             continue;
         }
 
-        cJSON *obj = cJSON_CreateObject();
+        cJSON *obj = somnus_ble_ap_record_to_json(rec);
         if (!obj) {
             continue;
         }
-
-        cJSON_AddStringToObject(obj, "ssid", (const char *)rec->ssid);
-
-        char mac_buf[18];
-        snprintf(mac_buf, sizeof(mac_buf),
-                 "%02X:%02X:%02X:%02X:%02X:%02X",
-                 rec->bssid[0],
-                 rec->bssid[1],
-                 rec->bssid[2],
-                 rec->bssid[3],
-                 rec->bssid[4],
-                 rec->bssid[5]);
-        cJSON_AddStringToObject(obj, "mac", mac_buf);
-
-        // Add RSSI (signal strength)
-        cJSON_AddNumberToObject(obj, "rssi", rec->rssi);
-
-        // Add auth mode (security type)
-        const char *auth_str = "Unknown";
-        switch (rec->authmode) {
-        case WIFI_AUTH_OPEN:
-            auth_str = "Open";
-            break;
-        case WIFI_AUTH_WEP:
-            auth_str = "WEP";
-            break;
-        case WIFI_AUTH_WPA_PSK:
-            auth_str = "WPA";
-            break;
-        case WIFI_AUTH_WPA2_PSK:
-            auth_str = "WPA2";
-            break;
-        case WIFI_AUTH_WPA_WPA2_PSK:
-            auth_str = "WPA/WPA2";
-            break;
-        case WIFI_AUTH_WPA2_ENTERPRISE:
-            auth_str = "WPA2-Enterprise";
-            break;
-        case WIFI_AUTH_WPA3_PSK:
-            auth_str = "WPA3";
-            break;
-        case WIFI_AUTH_WPA2_WPA3_PSK:
-            auth_str = "WPA2/WPA3";
-            break;
-        case WIFI_AUTH_WAPI_PSK:
-            auth_str = "WAPI";
-            break;
-        default:
-            auth_str = "Unknown";
-            break;
-        }
-        cJSON_AddStringToObject(obj, "auth", auth_str);
-
         cJSON_AddItemToArray(array, obj);
     }
 
     char *json = cJSON_PrintUnformatted(array);
-    if (out_len && json) {
-        *out_len = strlen(json);
-    }
-
     cJSON_Delete(array);
-    free(ap_records);
     return json;
 }
 
@@ -1191,19 +2901,28 @@ esp_err_t somnus_ble_start(const somnus_ble_config_t *config)
 
     // Initialize BLE log buffer
     ble_log_init();
-    ble_log_add(BLE_LOG_CONNECT, "BLE service starting");
+    ble_log_add(BLE_LOG_EV_STARTING, BLE_HS_CONN_HANDLE_NONE, 0, NULL, 0);
 
     if (config) {
         s_connect_cb = config->connect_cb;
         s_connect_ctx = config->connect_ctx;
         s_device_command_cb = config->device_command_cb;
         s_device_command_ctx = config->device_command_ctx;
+        s_set_led_cb = config->set_led_cb;
+        s_set_led_ctx = config->set_led_ctx;
+        s_set_volume_cb = config->set_volume_cb;
+        s_set_volume_ctx = config->set_volume_ctx;
     } else {
         s_connect_cb = NULL;
         s_connect_ctx = NULL;
         s_device_command_cb = NULL;
         s_device_command_ctx = NULL;
+        s_set_led_cb = NULL;
+        s_set_led_ctx = NULL;
+        s_set_volume_cb = NULL;
+        s_set_volume_ctx = NULL;
     }
+    memset(s_bin_latest, 0, sizeof(s_bin_latest));
 
     ESP_LOGI(SOMNUS_BLE_TAG, "Initialising NimBLE controller + host");
     esp_err_t err = esp_bt_controller_mem_release(ESP_BT_MODE_CLASSIC_BT);
@@ -1222,6 +2941,7 @@ esp_err_t somnus_ble_start(const somnus_ble_config_t *config)
     }
     ESP_LOGI(SOMNUS_BLE_TAG, "nimble_port_init complete");
 
+    int rc;
     ble_hs_cfg.sync_cb = somnus_ble_on_sync;
     ble_hs_cfg.gatts_register_cb = somnus_ble_gatt_register_cb;
     ble_hs_cfg.store_status_cb = ble_store_util_status_rr;
@@ -1230,9 +2950,13 @@ esp_err_t somnus_ble_start(const somnus_ble_config_t *config)
     ble_svc_gap_init();
     ble_svc_gatt_init();
     ble_svc_gap_device_name_set(SOMNUS_BLE_LOCAL_NAME);
+    rc = ble_att_set_preferred_mtu(CONFIG_SOMNUS_BLE_PREFERRED_MTU);
+    if (rc != 0) {
+        ESP_LOGW(SOMNUS_BLE_TAG, "ble_att_set_preferred_mtu(%d) failed rc=%d", CONFIG_SOMNUS_BLE_PREFERRED_MTU, rc);
+    }
     ESP_LOGI(SOMNUS_BLE_TAG, "Gap/Gatt services configured");
 
-    int rc = ble_gatts_count_cfg(somnus_svc_defs);
+    rc = ble_gatts_count_cfg(somnus_svc_defs);
     if (rc != 0) {
         nimble_port_deinit();
         ESP_LOGE(SOMNUS_BLE_TAG, "ble_gatts_count_cfg failed rc=%d", rc);
@@ -1258,12 +2982,13 @@ esp_err_t somnus_ble_start(const somnus_ble_config_t *config)
     }
     ESP_LOGI(SOMNUS_BLE_TAG, "Command queue created");
 
-    if (xTaskCreate(somnus_ble_command_task,
-                    "somnus_ble_cmd",
-                    SOMNUS_BLE_TASK_STACK,
-                    NULL,
-                    SOMNUS_BLE_TASK_PRIO,
-                    &s_cmd_task) != pdPASS) {
+    if (xTaskCreatePinnedToCore(somnus_ble_command_task,
+                                "somnus_ble_cmd",
+                                SOMNUS_BLE_TASK_STACK,
+                                NULL,
+                                SOMNUS_BLE_TASK_PRIO,
+                                &s_cmd_task,
+                                CONFIG_SOMNUS_BLE_TASK_CORE) != pdPASS) {
         vQueueDelete(s_cmd_queue);
         s_cmd_queue = NULL;
         nimble_port_deinit();
@@ -1283,8 +3008,31 @@ esp_err_t somnus_ble_start(const somnus_ble_config_t *config)
         ESP_LOGE(SOMNUS_BLE_TAG, "Failed to create notification queue");
         return ESP_ERR_NO_MEM;
     }
+    ble_npl_event_init(&s_notify_ev, somnus_ble_notify_drain, NULL);
+    ble_npl_event_init(&s_duty_ev, somnus_ble_duty_apply, NULL);
+
+    if (!s_bulk.wake) {
+        s_bulk.wake = xSemaphoreCreateBinary();
+    }
+    if (!s_bulk.mutex) {
+        s_bulk.mutex = xSemaphoreCreateMutex();
+    }
+    if (!s_bulk.wake || !s_bulk.mutex) {
+        // Only the bulk channel is lost; somnus_ble_bulk_send() reports it
+        ESP_LOGW(SOMNUS_BLE_TAG, "Failed to create bulk channel semaphores");
+    }
     ESP_LOGI(SOMNUS_BLE_TAG, "Notification queue created");
 
+    const esp_timer_create_args_t bulk_timer_args = {
+        .callback = somnus_ble_bulk_idle_cb,
+        .name = "ble_bulk_idle",
+    };
+    if (esp_timer_create(&bulk_timer_args, &s_bulk_timer) != ESP_OK) {
+        // Transfers still work, the link just keeps the fast interval
+        ESP_LOGW(SOMNUS_BLE_TAG, "Failed to create bulk idle timer");
+        s_bulk_timer = NULL;
+    }
+
     // Start FreeRTOS host task (must be last, matches reference examples)
     nimble_port_freertos_init(somnus_ble_host_task);
     // nimble_port_freertos_init returns void, so no error check needed
@@ -1322,11 +3070,24 @@ esp_err_t somnus_ble_stop(void)
         vQueueDelete(s_notify_queue);
         s_notify_queue = NULL;
     }
+    if (s_bulk_timer) {
+        esp_timer_stop(s_bulk_timer);
+        esp_timer_delete(s_bulk_timer);
+        s_bulk_timer = NULL;
+    }
 
     portENTER_CRITICAL(&s_state_lock);
     s_conn_handle = BLE_HS_CONN_HANDLE_NONE;
     s_notify_enabled = false;
+    s_att_mtu = BLE_ATT_MTU_DFLT;
+    s_bulk_fast = false;
+    s_bulk.subscribed = false;
+    s_bin_subscribed = false;
+    s_stats.tx_phy = s_stats.rx_phy = 0;
+    s_stats.conn_itvl = s_stats.conn_latency = s_stats.supervision_tmo = 0;
     portEXIT_CRITICAL(&s_state_lock);
+    __atomic_store_n(&s_pinned_itvl, 0, __ATOMIC_RELEASE);
+    somnus_ble_bulk_wake();
 
     s_started = false;
     ESP_LOGI(SOMNUS_BLE_TAG, "Somnus BLE service stopped");
@@ -1342,50 +3103,33 @@ esp_err_t somnus_ble_get_logs(char **out_json, size_t max_entries)
     cJSON *json = cJSON_CreateObject();
     cJSON *logs_array = cJSON_CreateArray();
     
-    portENTER_CRITICAL(&s_ble_log.lock);
-    
-    size_t count = s_ble_log.count;
+    uint32_t next = __atomic_load_n(&s_ble_log.next, __ATOMIC_ACQUIRE);
+    size_t total = SOMNUS_MIN(next, SOMNUS_BLE_LOG_MAX_ENTRIES);
+    size_t count = total;
     if (max_entries > 0 && count > max_entries) {
         count = max_entries;
     }
     
-    // Get entries from oldest to newest
-    for (size_t i = 0; i < count; i++) {
-        size_t idx = (s_ble_log.head + i) % SOMNUS_BLE_LOG_MAX_ENTRIES;
-        ble_log_entry_t *entry = &s_ble_log.entries[idx];
+    // Get entries from oldest to newest; writers may overwrite the oldest meanwhile, which are skipped
+    char message[SOMNUS_BLE_LOG_MSG_MAX_LEN];
+    for (uint32_t ticket = next - total; ticket != next - total + count; ticket++) {
+        ble_log_entry_t entry;
+        if (!ble_log_read(ticket, &entry)) {
+            continue;
+        }
+        ble_log_type_t type = ble_log_format(&entry, message, sizeof(message));
         
         cJSON *log_obj = cJSON_CreateObject();
         
-        const char *type_str = "UNKNOWN";
-        switch (entry->type) {
-        case BLE_LOG_CONNECT:
-            type_str = "CONNECT";
-            break;
-        case BLE_LOG_DISCONNECT:
-            type_str = "DISCONNECT";
-            break;
-        case BLE_LOG_RX:
-            type_str = "RX";
-            break;
-        case BLE_LOG_TX:
-            type_str = "TX";
-            break;
-        case BLE_LOG_SUBSCRIBE:
-            type_str = "SUBSCRIBE";
-            break;
-        }
-        
-        cJSON_AddStringToObject(log_obj, "type", type_str);
-        cJSON_AddNumberToObject(log_obj, "timestamp_ms", entry->timestamp_ms);
-        cJSON_AddStringToObject(log_obj, "message", entry->message);
+        cJSON_AddStringToObject(log_obj, "type", ble_log_type_name(type));
+        cJSON_AddNumberToObject(log_obj, "timestamp_ms", entry.timestamp_ms);
+        cJSON_AddStringToObject(log_obj, "message", message);
         
         cJSON_AddItemToArray(logs_array, log_obj);
     }
     
-    portEXIT_CRITICAL(&s_ble_log.lock);
-    
     cJSON_AddItemToObject(json, "logs", logs_array);
-    cJSON_AddNumberToObject(json, "total_count", s_ble_log.count);
+    cJSON_AddNumberToObject(json, "total_count", total);
     
     char *json_str = cJSON_Print(json);
     cJSON_Delete(json);
@@ -1398,6 +3142,49 @@ esp_err_t somnus_ble_get_logs(char **out_json, size_t max_entries)
     return ESP_OK;
 }
 
+esp_err_t somnus_ble_set_log_cb(somnus_ble_log_cb_t cb, void *ctx)
+{
+    // Under s_state_lock so ble_log_add never sees a callback with another's context
+    portENTER_CRITICAL(&s_state_lock);
+    s_log_cb = cb;
+    s_log_ctx = ctx;
+    portEXIT_CRITICAL(&s_state_lock);
+    return ESP_OK;
+}
+
+esp_err_t somnus_ble_get_stats(somnus_ble_stats_t *out)
+{
+    if (!out) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    portENTER_CRITICAL(&s_state_lock);
+    *out = s_stats;
+    out->mtu = s_conn_handle != BLE_HS_CONN_HANDLE_NONE ? s_att_mtu : 0;
+    portEXIT_CRITICAL(&s_state_lock);
+    return ESP_OK;
+}
+
+void somnus_ble_reset_stats(void)
+{
+    // The counters are everything before mtu
+    portENTER_CRITICAL(&s_state_lock);
+    memset(&s_stats, 0, offsetof(somnus_ble_stats_t, mtu));
+    portEXIT_CRITICAL(&s_state_lock);
+}
+
+esp_err_t somnus_ble_set_low_duty(bool low_duty)
+{
+    if (__atomic_exchange_n(&s_low_duty, low_duty, __ATOMIC_ACQ_REL) == low_duty) {
+        return ESP_OK;
+    }
+    ESP_LOGI(SOMNUS_BLE_TAG, "[BLE] %s duty cycle", low_duty ? "Low" : "Normal");
+    // Before start the flag is simply picked up by the first advertisement
+    if (s_started) {
+        ble_npl_eventq_put(nimble_port_get_dflt_eventq(), &s_duty_ev);
+    }
+    return ESP_OK;
+}
+
 bool somnus_ble_is_running(void)
 {
     return s_started;
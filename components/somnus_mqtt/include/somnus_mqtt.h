@@ -5,6 +5,9 @@
 
 #pragma once
 
+#include <stddef.h>
+#include <stdint.h>
+
 #include "esp_err.h"
 #include "esp_log.h"
 
@@ -20,9 +23,51 @@ extern "C" {
  */
 typedef void (*somnus_mqtt_action_cb_t)(const char *payload, void *ctx);
 
+/**
+ * @brief Action types, resolved from the "Action" string by a perfect hash.
+ */
+typedef enum {
+    SOMNUS_MQTT_ACTION_UNKNOWN = 0,
+    SOMNUS_MQTT_ACTION_LED,
+    SOMNUS_MQTT_ACTION_SONG_CHANGE,
+    SOMNUS_MQTT_ACTION_SET_VOLUME,
+    SOMNUS_MQTT_ACTION_SET_LED_INTENSITY,
+    SOMNUS_MQTT_ACTION_PAUSE,
+    SOMNUS_MQTT_ACTION_PLAY,
+    SOMNUS_MQTT_ACTION_SPEECH,
+    SOMNUS_MQTT_ACTION_IR,
+} somnus_mqtt_action_type_t;
+
+/**
+ * @brief One action of a command, pointing straight into the MQTT receive buffer.
+ *
+ * Nothing is copied or NUL-terminated; the pointers are only valid during the
+ * callback.
+ */
+typedef struct {
+    somnus_mqtt_action_type_t type;
+    const char *name;                  /**< "Action" value (name_len bytes). */
+    size_t name_len;
+    const char *data;                  /**< Raw JSON of "Data" (data_len bytes), NULL if absent. */
+    size_t data_len;
+    uint32_t delay_s;                  /**< "Delay" in seconds, 0 if absent. */
+    size_t index;                      /**< Position in an action list. */
+    size_t count;                      /**< Length of the action list, 1 for a single action. */
+} somnus_mqtt_action_t;
+
+/**
+ * @brief Callback invoked once per action, in order, without building a DOM.
+ *
+ * For a single action, returning ESP_ERR_NOT_SUPPORTED passes the payload on
+ * to @ref somnus_mqtt_action_cb_t as well. Schedule updates ("store": true)
+ * and routine lists always go to the raw callback.
+ */
+typedef esp_err_t (*somnus_mqtt_action_item_cb_t)(const somnus_mqtt_action_t *action, void *ctx);
+
 typedef struct {
     somnus_mqtt_action_cb_t action_cb; /**< Optional handler for action payloads. */
-    void *action_ctx;                  /**< Context passed to @p action_cb. */
+    void *action_ctx;                  /**< Context passed to @p action_cb and @p action_item_cb. */
+    somnus_mqtt_action_item_cb_t action_item_cb; /**< Optional streaming handler for actions. */
 } somnus_mqtt_config_t;
 
 /**
@@ -38,9 +83,42 @@ esp_err_t somnus_mqtt_start(const somnus_mqtt_config_t *config);
  */
 esp_err_t somnus_mqtt_stop(void);
 
+/**
+ * @brief Drop the DER credentials cached in NVS (CONFIG_SOMNUS_MQTT_CERT_CACHE).
+ *
+ * The next somnus_mqtt_start() discovers and converts the certificates again.
+ * Changed certificate files and new firmware invalidate the cache on their
+ * own; this is for credentials replaced some other way.
+ */
+esp_err_t somnus_mqtt_forget_cached_certificates(void);
+
+/**
+ * @brief Callback for messages on a topic added with somnus_mqtt_subscribe().
+ *
+ * Runs on the AWS IoT service task; topic and payload are not NUL-terminated
+ * and only valid during the call.
+ */
+typedef void (*somnus_mqtt_topic_cb_t)(const char *topic, size_t topic_len, const char *payload, size_t len,
+                                       void *ctx);
+
+/**
+ * @brief Subscribe to another topic filter and route its messages to @p cb
+ *        instead of the command handler.
+ *
+ * The filter may use MQTT '+' and a trailing '#'. Subscriptions last across
+ * reconnects and share the service's extra topic slots with the gateway.
+ *
+ * @return ESP_ERR_NO_MEM when no route or topic slot is left
+ */
+esp_err_t somnus_mqtt_subscribe(const char *filter, somnus_mqtt_topic_cb_t cb, void *ctx);
+
 /**
  * @brief Publish a Somnus log payload.
  *
+ * With CONFIG_SOMNUS_MQTT_LOG_SINK the message joins the next batch of the
+ * remote log sink (somnus_mqtt_log_sink.h) and is subject to its rate limits;
+ * ESP_ERR_NO_MEM means it was dropped. Otherwise it is published on its own.
+ *
  * @param level   Log severity string (e.g. "INFO", "WARN").
  * @param message Log message body.
  */
@@ -58,6 +136,45 @@ esp_err_t somnus_mqtt_publish_raw_log(const char *json_payload);
  */
 esp_err_t somnus_mqtt_publish_telemetry(const char *json_payload);
 
+/**
+ * @brief Publish a CBOR telemetry payload.
+ *
+ * Sent to the telemetry topic with a "/cbor" suffix so JSON consumers of the
+ * telemetry topic never see binary frames.
+ */
+esp_err_t somnus_mqtt_publish_telemetry_binary(const void *payload, size_t payload_len);
+
+/**
+ * @brief Publish a delta-encoded telemetry batch (see telemetry_batch.h).
+ *
+ * Sent to the telemetry topic with a "/batch" suffix. Like every publish here
+ * it is only queued (aws_iot_service_publish()); ESP_ERR_NO_MEM means the
+ * outbox is full and the batch should be kept for a later retry.
+ */
+esp_err_t somnus_mqtt_publish_telemetry_batch(const void *payload, size_t payload_len);
+
+/**
+ * @brief Publish a piece of a nightly summary (see night_summary.h).
+ *
+ * Sent to the telemetry topic with a "/night" suffix. ESP_ERR_NO_MEM means
+ * the outbox is full; the summary stays in flash for a later retry.
+ */
+esp_err_t somnus_mqtt_publish_telemetry_night(const void *payload, size_t payload_len);
+
+/**
+ * @brief Publish the JSON report of one finished voice interaction.
+ *
+ * Sent to the telemetry topic with an "/interaction" suffix, at
+ * AWS_IOT_SERVICE_PRIORITY_INTERACTION: when the outbox fills, telemetry
+ * and logs are evicted before a report is refused.
+ */
+esp_err_t somnus_mqtt_publish_interaction(const char *json_payload);
+
+/**
+ * @brief Resolve an action name (not necessarily NUL-terminated).
+ */
+somnus_mqtt_action_type_t somnus_mqtt_action_type_from_name(const char *name, size_t len);
+
 /**
  * @brief Retrieve the Somnus device identifier used for MQTT.
  */
@@ -0,0 +1,85 @@
+/**
+ * @file somnus_mqtt_gateway.h
+ * @brief One AWS IoT connection per home: units on a LAN share an elected gateway.
+ *
+ * Units beacon over UDP broadcast on CONFIG_SOMNUS_MQTT_GATEWAY_PORT. The
+ * candidate with the lowest device ID among those heard in the last three
+ * beacons is the gateway; it keeps its MQTT connection, subscribes to each
+ * peer's command topic and welcomes the peer in reply to its beacons. A
+ * welcomed peer stops its own connection and sends its publishes to the
+ * gateway, which queues them under the peer's topics; commands for the peer
+ * come back the same way. A unit that is neither (no gateway heard yet, the
+ * gateway out of peer slots, or its welcomes stopped) keeps its own
+ * connection, so losing the gateway costs at most three beacons of traffic.
+ *
+ * A gateway that cannot reach the broker withdraws from the election for a
+ * while so another unit can take over.
+ *
+ * Packets are trusted by source address only: peers must share a LAN the
+ * home trusts, and the IoT policy of every unit must allow the topics of the
+ * others.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** What a publish is, so the gateway can rebuild a peer's topic. */
+typedef enum {
+    SOMNUS_MQTT_TOPIC_LOG = 0,
+    SOMNUS_MQTT_TOPIC_TELEMETRY,
+    SOMNUS_MQTT_TOPIC_TELEMETRY_CBOR,
+    SOMNUS_MQTT_TOPIC_TELEMETRY_BATCH,
+    SOMNUS_MQTT_TOPIC_TELEMETRY_NIGHT,
+    SOMNUS_MQTT_TOPIC_INTERACTION,
+    SOMNUS_MQTT_TOPIC_COUNT,
+} somnus_mqtt_topic_t;
+
+/** Called from the gateway task unless noted. */
+typedef struct {
+    esp_err_t (*connect)(void);       ///< Run this unit's own MQTT connection
+    void (*disconnect)(void);         ///< Stop it: this unit is now a peer
+    /** Queue a peer's publish under its topic (gateway only) */
+    esp_err_t (*publish_for)(const char *device_id, somnus_mqtt_topic_t topic, const void *payload, size_t len);
+    /** A command the gateway relayed to this unit */
+    void (*command)(const char *payload, size_t len);
+} somnus_mqtt_gateway_ops_t;
+
+/**
+ * @brief Start beaconing and the election for device_id.
+ *
+ * Nothing connects until two beacon periods have passed, so a unit that
+ * boots into a home with a gateway never opens its own connection.
+ */
+esp_err_t somnus_mqtt_gateway_start(const char *device_id, const somnus_mqtt_gateway_ops_t *ops);
+
+esp_err_t somnus_mqtt_gateway_stop(void);
+
+/** True while publishes must go through somnus_mqtt_gateway_forward(). */
+bool somnus_mqtt_gateway_is_peer(void);
+
+/**
+ * @brief Send a publish to the gateway. Any task.
+ *
+ * @return ESP_OK once sent; ESP_ERR_INVALID_STATE when this unit is not a
+ *         peer; ESP_ERR_INVALID_SIZE when it does not fit one datagram
+ */
+esp_err_t somnus_mqtt_gateway_forward(somnus_mqtt_topic_t topic, const void *payload, size_t len);
+
+/**
+ * @brief Pass a command received on another unit's topic to that unit.
+ *
+ * @return ESP_ERR_NOT_FOUND when device_id is not a peer of this gateway
+ */
+esp_err_t somnus_mqtt_gateway_relay(const char *device_id, const void *payload, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
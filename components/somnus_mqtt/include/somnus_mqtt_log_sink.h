@@ -0,0 +1,63 @@
+/**
+ * @file somnus_mqtt_log_sink.h
+ * @brief Rate-limited, batched forwarding of log lines to the Somnus log topic.
+ *
+ * An esp_log_set_vprintf() hook copies each ESP_LOGx line into a lock-free
+ * ring after printing it as before. A low-priority task drains the ring every
+ * CONFIG_SOMNUS_MQTT_LOG_SINK_INTERVAL_MS into one Somnus log message, so
+ * remote logging costs at most one publish per interval however much is
+ * logged. Writers never block: a line over its level's per-second budget, or
+ * one that finds the ring full, is dropped and counted, and the next batch
+ * reports how many were lost.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "esp_log.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    uint32_t queued;                  ///< Lines waiting in the ring now
+    uint32_t sent_lines;              ///< Lines handed to the outbox
+    uint32_t batches;                 ///< Batched log messages published
+    uint32_t dropped_rate;            ///< Over their level's per-second budget
+    uint32_t dropped_full;            ///< Found the ring full
+    uint32_t publish_deferred;        ///< Publishes refused by the outbox and retried
+} somnus_mqtt_log_sink_stats_t;
+
+/**
+ * @brief Install the log hook and start the drain task (idempotent).
+ *
+ * Called by somnus_mqtt_start() when CONFIG_SOMNUS_MQTT_LOG_SINK is set.
+ *
+ * @param stage_onboarding LogName for lines that mention onboarding
+ * @param stage_after      LogName for every other line
+ */
+esp_err_t somnus_mqtt_log_sink_start(const char *stage_onboarding, const char *stage_after);
+
+/**
+ * @brief Restore the previous log output and stop the drain task.
+ *
+ * Lines still in the ring are kept for the next start.
+ */
+esp_err_t somnus_mqtt_log_sink_stop(void);
+
+/**
+ * @brief Queue one line for the next batch, subject to the same rate limits.
+ *
+ * @return ESP_OK once queued; ESP_ERR_NO_MEM when the line was dropped by the
+ *         rate limit or a full ring; ESP_ERR_INVALID_STATE when not started
+ */
+esp_err_t somnus_mqtt_log_sink_enqueue(esp_log_level_t level, const char *message);
+
+void somnus_mqtt_log_sink_get_stats(somnus_mqtt_log_sink_stats_t *out);
+
+#ifdef __cplusplus
+}
+#endif
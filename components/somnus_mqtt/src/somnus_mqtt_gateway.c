@@ -0,0 +1,493 @@
+/**
+ * @file somnus_mqtt_gateway.c
+ */
+
+#include "somnus_mqtt_gateway.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "esp_check.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "sdkconfig.h"
+#include "somnus_profile.h"
+
+#if CONFIG_SOMNUS_MQTT_GATEWAY
+
+#include "aws_iot_service.h"
+#include "lwip/sockets.h"
+
+#define TAG "somnus_gateway"
+
+#define GW_MAGIC 0x4e475731u          // "NGW1"
+#define GW_BEACON_US ((int64_t)CONFIG_SOMNUS_MQTT_GATEWAY_BEACON_MS * 1000)
+#define GW_ALIVE_US (GW_BEACON_US * 3)
+#define GW_HOLDOFF_US (GW_BEACON_US * 2)
+// A gateway this long without the broker steps aside for GW_WITHDRAW_US
+#define GW_OFFLINE_LIMIT_US (60LL * 1000 * 1000)
+#define GW_WITHDRAW_US (10LL * 60 * 1000 * 1000)
+#define GW_MAX_UNITS 8
+// Large enough for a log batch; needs IPv4 reassembly, which the option selects
+#define GW_PAYLOAD_MAX 4096
+#define GW_RECV_TIMEOUT_MS 250
+#define GW_TASK_STACK 4096
+#define GW_TASK_PRIO 4
+
+typedef enum {
+    GW_TYPE_BEACON = 1,               // Broadcast by every unit
+    GW_TYPE_WELCOME,                  // Gateway to a peer it serves, per beacon
+    GW_TYPE_PUBLISH,                  // Peer to gateway; flags hold the topic
+    GW_TYPE_COMMAND,                  // Gateway to peer
+} gw_type_t;
+
+#define GW_FLAG_CANDIDATE 0x01
+#define GW_FLAG_CONNECTED 0x02        // The sender's MQTT connection is up
+
+typedef struct __attribute__((packed)) {
+    uint32_t magic;
+    uint8_t type;
+    uint8_t flags;
+    char device_id[SOMNUS_DEVICE_ID_LEN]; // Sender
+} gw_header_t;
+
+typedef enum {
+    GW_ROLE_UNDECIDED = 0,
+    GW_ROLE_SOLO,                     // Own connection, nobody to serve
+    GW_ROLE_GATEWAY,
+    GW_ROLE_PEER,
+} gw_role_t;
+
+static const char *const kRoleNames[] = { "undecided", "solo", "gateway", "peer" };
+
+typedef struct {
+    char device_id[SOMNUS_DEVICE_ID_LEN];
+    struct sockaddr_in addr;
+    int64_t seen_us;                  // 0 = empty slot
+    uint8_t flags;
+    bool served;                      // Its command topic is subscribed here
+} gw_unit_t;
+
+static struct {
+    bool running;
+    TaskHandle_t task;
+    SemaphoreHandle_t stopped;
+    SemaphoreHandle_t lock;           // units, gateway_*
+    int sock;
+    somnus_mqtt_gateway_ops_t ops;
+    char device_id[SOMNUS_DEVICE_ID_LEN];
+    volatile gw_role_t role;
+    gw_unit_t units[GW_MAX_UNITS];
+    char gateway_id[SOMNUS_DEVICE_ID_LEN]; // Last unit to welcome us
+    struct sockaddr_in gateway_addr;
+    int64_t welcomed_us;
+    int64_t started_us;
+    int64_t offline_since_us;         // Own connection down since; 0 when up
+    int64_t withdrawn_until_us;
+} s_gw = { .sock = -1 };
+
+static uint8_t s_rx[sizeof(gw_header_t) + GW_PAYLOAD_MAX];
+
+// Forward declaration - defined in main app if available
+extern void aws_led_set_connected(bool connected);
+
+static bool gw_own_connection_up(void)
+{
+    aws_iot_client_t *client = aws_iot_service_get_client();
+    return client && aws_iot_client_is_connected(client);
+}
+
+static esp_err_t gw_send(const struct sockaddr_in *to, gw_type_t type, uint8_t flags, const void *payload,
+                         size_t len)
+{
+    gw_header_t header = {
+        .magic = GW_MAGIC,
+        .type = (uint8_t)type,
+        .flags = flags,
+    };
+    memcpy(header.device_id, s_gw.device_id, sizeof(header.device_id));
+    // Header and payload go out as one datagram without a copy
+    struct iovec iov[2] = {
+        { .iov_base = &header, .iov_len = sizeof(header) },
+        { .iov_base = (void *)payload, .iov_len = len },
+    };
+    struct msghdr msg = {
+        .msg_name = (void *)to,
+        .msg_namelen = sizeof(*to),
+        .msg_iov = iov,
+        .msg_iovlen = len ? 2 : 1,
+    };
+    return sendmsg(s_gw.sock, &msg, 0) < 0 ? ESP_FAIL : ESP_OK;
+}
+
+// Under lock
+static gw_unit_t *gw_find(const char *device_id)
+{
+    for (int i = 0; i < GW_MAX_UNITS; ++i) {
+        if (s_gw.units[i].seen_us && strcmp(s_gw.units[i].device_id, device_id) == 0) {
+            return &s_gw.units[i];
+        }
+    }
+    return NULL;
+}
+
+// Under lock: the unit's slot, else the stalest
+static gw_unit_t *gw_upsert(const gw_header_t *header, const struct sockaddr_in *from, int64_t now_us)
+{
+    gw_unit_t *unit = gw_find(header->device_id);
+    if (!unit) {
+        unit = &s_gw.units[0];
+        for (int i = 1; i < GW_MAX_UNITS && unit->seen_us; ++i) {
+            if (s_gw.units[i].seen_us < unit->seen_us) {
+                unit = &s_gw.units[i];
+            }
+        }
+        memset(unit, 0, sizeof(*unit));
+        memcpy(unit->device_id, header->device_id, sizeof(unit->device_id));
+    }
+    unit->addr = *from;
+    unit->flags = header->flags;
+    unit->seen_us = now_us;
+    return unit;
+}
+
+// Not under lock: stopping the service waits for its task, which may be
+// relaying a command
+static void gw_set_role(gw_role_t role)
+{
+    gw_role_t old = s_gw.role;
+    if (role == old) {
+        return;
+    }
+    ESP_LOGI(TAG, "%s -> %s", kRoleNames[old], kRoleNames[role]);
+    // Publishes start going to the gateway before the connection is dropped
+    s_gw.role = role;
+    if (role == GW_ROLE_PEER) {
+        s_gw.ops.disconnect();
+        s_gw.offline_since_us = 0;
+    } else if (old == GW_ROLE_PEER || old == GW_ROLE_UNDECIDED) {
+        aws_led_set_connected(false);
+        esp_err_t err = s_gw.ops.connect();
+        if (err != ESP_OK) {
+            ESP_LOGW(TAG, "Own connection not started (%s)", esp_err_to_name(err));
+        }
+    }
+    if (role != GW_ROLE_GATEWAY) {
+        xSemaphoreTake(s_gw.lock, portMAX_DELAY);
+        for (int i = 0; i < GW_MAX_UNITS; ++i) {
+            s_gw.units[i].served = false;
+        }
+        xSemaphoreGive(s_gw.lock);
+    }
+}
+
+static void gw_elect(int64_t now_us)
+{
+    bool own = s_gw.role == GW_ROLE_SOLO || s_gw.role == GW_ROLE_GATEWAY;
+    if (!own || gw_own_connection_up()) {
+        s_gw.offline_since_us = 0;
+    } else if (!s_gw.offline_since_us) {
+        s_gw.offline_since_us = now_us;
+    } else if (s_gw.role == GW_ROLE_GATEWAY && now_us - s_gw.offline_since_us > GW_OFFLINE_LIMIT_US) {
+        ESP_LOGW(TAG, "No broker for %lld s, standing down as gateway", GW_OFFLINE_LIMIT_US / 1000000);
+        s_gw.withdrawn_until_us = now_us + GW_WITHDRAW_US;
+        s_gw.offline_since_us = 0;
+    }
+    if (now_us - s_gw.started_us < GW_HOLDOFF_US) {
+        return;
+    }
+
+    bool candidate = now_us >= s_gw.withdrawn_until_us;
+    xSemaphoreTake(s_gw.lock, portMAX_DELAY);
+    const gw_unit_t *lowest = NULL;
+    for (int i = 0; i < GW_MAX_UNITS; ++i) {
+        const gw_unit_t *unit = &s_gw.units[i];
+        if (unit->seen_us && now_us - unit->seen_us < GW_ALIVE_US && (unit->flags & GW_FLAG_CANDIDATE) &&
+            (!lowest || strcmp(unit->device_id, lowest->device_id) < 0)) {
+            lowest = unit;
+        }
+    }
+    gw_role_t role;
+    if (candidate && (!lowest || strcmp(s_gw.device_id, lowest->device_id) < 0)) {
+        role = GW_ROLE_GATEWAY;
+    } else if (lowest && strcmp(lowest->device_id, s_gw.gateway_id) == 0 &&
+               now_us - s_gw.welcomed_us < GW_ALIVE_US) {
+        role = GW_ROLE_PEER;
+    } else {
+        role = GW_ROLE_SOLO;
+    }
+    xSemaphoreGive(s_gw.lock);
+    gw_set_role(role);
+}
+
+static void gw_beacon(void)
+{
+    static const struct sockaddr_in broadcast = {
+        .sin_family = AF_INET,
+        .sin_port = PP_HTONS(CONFIG_SOMNUS_MQTT_GATEWAY_PORT),
+        .sin_addr.s_addr = PP_HTONL(INADDR_BROADCAST),
+    };
+    uint8_t flags = esp_timer_get_time() >= s_gw.withdrawn_until_us ? GW_FLAG_CANDIDATE : 0;
+    if (s_gw.role != GW_ROLE_PEER && gw_own_connection_up()) {
+        flags |= GW_FLAG_CONNECTED;
+    }
+    // Fails until the station has an address; the next beacon tries again
+    (void)gw_send(&broadcast, GW_TYPE_BEACON, flags, NULL, 0);
+}
+
+// Gateway, under lock: take the unit on if there is room, and welcome it
+static void gw_serve(gw_unit_t *unit)
+{
+    if (!unit->served) {
+        char topic[SOMNUS_PROFILE_TOPIC_MAX];
+        snprintf(topic, sizeof(topic), SOMNUS_PROFILE_SUBSCRIBE_TOPIC_HEAD "%s", unit->device_id);
+        esp_err_t err = aws_iot_service_add_subscription(topic);
+        if (err != ESP_OK) {
+            // It keeps its own connection
+            ESP_LOGD(TAG, "Cannot serve %s (%s)", unit->device_id, esp_err_to_name(err));
+            return;
+        }
+        ESP_LOGI(TAG, "Serving %s", unit->device_id);
+        unit->served = true;
+    }
+    (void)gw_send(&unit->addr, GW_TYPE_WELCOME, gw_own_connection_up() ? GW_FLAG_CONNECTED : 0, NULL, 0);
+}
+
+static bool gw_same_addr(const struct sockaddr_in *a, const struct sockaddr_in *b)
+{
+    return a->sin_addr.s_addr == b->sin_addr.s_addr && a->sin_port == b->sin_port;
+}
+
+static void gw_handle(const struct sockaddr_in *from, size_t len, int64_t now_us)
+{
+    gw_header_t header;
+    memcpy(&header, s_rx, sizeof(header));
+    header.device_id[sizeof(header.device_id) - 1] = '\0';
+    if (header.magic != GW_MAGIC || strcmp(header.device_id, s_gw.device_id) == 0) {
+        return;
+    }
+    const uint8_t *payload = s_rx + sizeof(header);
+    size_t payload_len = len - sizeof(header);
+
+    xSemaphoreTake(s_gw.lock, portMAX_DELAY);
+    gw_unit_t *unit = gw_find(header.device_id);
+    switch (header.type) {
+    case GW_TYPE_BEACON:
+        unit = gw_upsert(&header, from, now_us);
+        if (s_gw.role == GW_ROLE_GATEWAY) {
+            gw_serve(unit);
+        }
+        break;
+    case GW_TYPE_WELCOME:
+        memcpy(s_gw.gateway_id, header.device_id, sizeof(s_gw.gateway_id));
+        s_gw.gateway_addr = *from;
+        s_gw.welcomed_us = now_us;
+        if (s_gw.role == GW_ROLE_PEER) {
+            aws_led_set_connected(header.flags & GW_FLAG_CONNECTED);
+        }
+        break;
+    case GW_TYPE_PUBLISH:
+        if (s_gw.role == GW_ROLE_GATEWAY && unit && unit->served && gw_same_addr(&unit->addr, from) &&
+            header.flags < SOMNUS_MQTT_TOPIC_COUNT) {
+            esp_err_t err = s_gw.ops.publish_for(unit->device_id, (somnus_mqtt_topic_t)header.flags, payload,
+                                                 payload_len);
+            if (err != ESP_OK) {
+                ESP_LOGD(TAG, "Publish for %s dropped (%s)", unit->device_id, esp_err_to_name(err));
+            }
+        }
+        break;
+    case GW_TYPE_COMMAND:
+        if (s_gw.role == GW_ROLE_PEER && strcmp(header.device_id, s_gw.gateway_id) == 0 &&
+            gw_same_addr(&s_gw.gateway_addr, from)) {
+            // Handlers may publish, which takes the lock again
+            xSemaphoreGive(s_gw.lock);
+            s_gw.ops.command((const char *)payload, payload_len);
+            return;
+        }
+        break;
+    default:
+        break;
+    }
+    xSemaphoreGive(s_gw.lock);
+}
+
+static void gw_task(void *arg)
+{
+    (void)arg;
+    int64_t next_beacon_us = 0;
+    while (s_gw.running) {
+        int64_t now_us = esp_timer_get_time();
+        if (now_us >= next_beacon_us) {
+            gw_elect(now_us);
+            gw_beacon();
+            next_beacon_us = now_us + GW_BEACON_US;
+        }
+
+        struct sockaddr_in from;
+        socklen_t from_len = sizeof(from);
+        int len = recvfrom(s_gw.sock, s_rx, sizeof(s_rx), 0, (struct sockaddr *)&from, &from_len);
+        if (len >= (int)sizeof(gw_header_t) && from.sin_family == AF_INET) {
+            gw_handle(&from, (size_t)len, esp_timer_get_time());
+        }
+    }
+
+    s_gw.task = NULL;
+    xSemaphoreGive(s_gw.stopped);
+    vTaskDelete(NULL);
+}
+
+esp_err_t somnus_mqtt_gateway_start(const char *device_id, const somnus_mqtt_gateway_ops_t *ops)
+{
+    ESP_RETURN_ON_FALSE(device_id && ops && ops->connect && ops->disconnect && ops->publish_for && ops->command,
+                        ESP_ERR_INVALID_ARG, TAG, "device ID and all ops required");
+    if (s_gw.running) {
+        return ESP_OK;
+    }
+
+    if (!s_gw.lock) {
+        s_gw.lock = xSemaphoreCreateMutex();
+        s_gw.stopped = xSemaphoreCreateBinary();
+        ESP_RETURN_ON_FALSE(s_gw.lock && s_gw.stopped, ESP_ERR_NO_MEM, TAG, "Failed to create semaphores");
+    }
+
+    int sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    ESP_RETURN_ON_FALSE(sock >= 0, ESP_FAIL, TAG, "socket failed (errno %d)", errno);
+    int on = 1;
+    struct timeval timeout = { .tv_usec = GW_RECV_TIMEOUT_MS * 1000 };
+    struct sockaddr_in local = {
+        .sin_family = AF_INET,
+        .sin_port = htons(CONFIG_SOMNUS_MQTT_GATEWAY_PORT),
+        .sin_addr.s_addr = htonl(INADDR_ANY),
+    };
+    if (setsockopt(sock, SOL_SOCKET, SO_BROADCAST, &on, sizeof(on)) != 0 ||
+        setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)) != 0 ||
+        bind(sock, (struct sockaddr *)&local, sizeof(local)) != 0) {
+        ESP_LOGE(TAG, "UDP port %d setup failed (errno %d)", CONFIG_SOMNUS_MQTT_GATEWAY_PORT, errno);
+        close(sock);
+        return ESP_FAIL;
+    }
+
+    s_gw.sock = sock;
+    s_gw.ops = *ops;
+    strlcpy(s_gw.device_id, device_id, sizeof(s_gw.device_id));
+    memset(s_gw.units, 0, sizeof(s_gw.units));
+    s_gw.gateway_id[0] = '\0';
+    s_gw.role = GW_ROLE_UNDECIDED;
+    s_gw.started_us = esp_timer_get_time();
+    s_gw.offline_since_us = 0;
+    s_gw.withdrawn_until_us = 0;
+    s_gw.running = true;
+
+    // Same core as the AWS IoT service task, away from the audio core
+    BaseType_t created = xTaskCreatePinnedToCore(gw_task,
+                                                 "somnus_gateway",
+                                                 GW_TASK_STACK,
+                                                 NULL,
+                                                 GW_TASK_PRIO,
+                                                 &s_gw.task,
+                                                 CONFIG_NAPHOME_AWS_IOT_TASK_CORE);
+    if (created != pdPASS) {
+        s_gw.running = false;
+        close(sock);
+        s_gw.sock = -1;
+        ESP_LOGE(TAG, "Failed to create gateway task");
+        return ESP_ERR_NO_MEM;
+    }
+
+    ESP_LOGI(TAG, "Gateway election on UDP port %d as %s", CONFIG_SOMNUS_MQTT_GATEWAY_PORT, device_id);
+    return ESP_OK;
+}
+
+esp_err_t somnus_mqtt_gateway_stop(void)
+{
+    if (!s_gw.running) {
+        return ESP_OK;
+    }
+
+    s_gw.running = false;
+    if (s_gw.task && xSemaphoreTake(s_gw.stopped, pdMS_TO_TICKS(2000)) != pdTRUE) {
+        ESP_LOGW(TAG, "Timed out waiting for gateway task to stop");
+        return ESP_ERR_TIMEOUT;
+    }
+    close(s_gw.sock);
+    s_gw.sock = -1;
+    s_gw.role = GW_ROLE_UNDECIDED;
+    return ESP_OK;
+}
+
+bool somnus_mqtt_gateway_is_peer(void)
+{
+    return s_gw.running && s_gw.role == GW_ROLE_PEER;
+}
+
+esp_err_t somnus_mqtt_gateway_forward(somnus_mqtt_topic_t topic, const void *payload, size_t len)
+{
+    ESP_RETURN_ON_FALSE(len <= GW_PAYLOAD_MAX, ESP_ERR_INVALID_SIZE, TAG, "publish too large to forward");
+    if (!somnus_mqtt_gateway_is_peer()) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    xSemaphoreTake(s_gw.lock, portMAX_DELAY);
+    struct sockaddr_in to = s_gw.gateway_addr;
+    xSemaphoreGive(s_gw.lock);
+    return gw_send(&to, GW_TYPE_PUBLISH, (uint8_t)topic, payload, len);
+}
+
+esp_err_t somnus_mqtt_gateway_relay(const char *device_id, const void *payload, size_t len)
+{
+    ESP_RETURN_ON_FALSE(device_id && payload, ESP_ERR_INVALID_ARG, TAG, "device ID and payload required");
+    ESP_RETURN_ON_FALSE(len <= GW_PAYLOAD_MAX, ESP_ERR_INVALID_SIZE, TAG, "command too large to relay");
+    if (!s_gw.running || s_gw.role != GW_ROLE_GATEWAY) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    xSemaphoreTake(s_gw.lock, portMAX_DELAY);
+    const gw_unit_t *unit = gw_find(device_id);
+    bool served = unit && unit->served;
+    struct sockaddr_in to = served ? unit->addr : (struct sockaddr_in){ 0 };
+    xSemaphoreGive(s_gw.lock);
+    if (!served) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    return gw_send(&to, GW_TYPE_COMMAND, 0, payload, len);
+}
+
+#else /* !CONFIG_SOMNUS_MQTT_GATEWAY */
+
+esp_err_t somnus_mqtt_gateway_start(const char *device_id, const somnus_mqtt_gateway_ops_t *ops)
+{
+    (void)device_id;
+    (void)ops;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t somnus_mqtt_gateway_stop(void)
+{
+    return ESP_OK;
+}
+
+bool somnus_mqtt_gateway_is_peer(void)
+{
+    return false;
+}
+
+esp_err_t somnus_mqtt_gateway_forward(somnus_mqtt_topic_t topic, const void *payload, size_t len)
+{
+    (void)topic;
+    (void)payload;
+    (void)len;
+    return ESP_ERR_INVALID_STATE;
+}
+
+esp_err_t somnus_mqtt_gateway_relay(const char *device_id, const void *payload, size_t len)
+{
+    (void)device_id;
+    (void)payload;
+    (void)len;
+    return ESP_ERR_NOT_FOUND;
+}
+
+#endif /* CONFIG_SOMNUS_MQTT_GATEWAY */
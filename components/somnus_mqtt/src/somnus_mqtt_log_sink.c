@@ -0,0 +1,529 @@
+/**
+ * @file somnus_mqtt_log_sink.c
+ */
+
+#include "somnus_mqtt_log_sink.h"
+
+#include <ctype.h>
+#include <inttypes.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "esp_check.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "mem_tags.h"
+#include "sdkconfig.h"
+#include "somnus_mqtt.h"
+#include "somnus_profile.h"
+
+#if CONFIG_SOMNUS_MQTT_LOG_SINK
+
+#define TAG "somnus_log_sink"
+
+#define LOG_SINK_SLOTS      CONFIG_SOMNUS_MQTT_LOG_SINK_SLOTS
+#define LOG_SINK_LINE_MAX   CONFIG_SOMNUS_MQTT_LOG_SINK_LINE_MAX
+#define LOG_SINK_BATCH_MAX  CONFIG_SOMNUS_MQTT_LOG_SINK_BATCH_BYTES
+// Lines are escaped straight into the payload after room for the Somnus
+// envelope, which is written in front of them once the batch is closed
+#define LOG_SINK_PAYLOAD_MAX \
+    (SOMNUS_PROFILE_LOG_PREFIX_MAX + LOG_SINK_BATCH_MAX + sizeof(SOMNUS_PROFILE_LOG_SUFFIX))
+#define LOG_SINK_TASK_STACK 3072
+#define LOG_SINK_TASK_PRIO  (tskIDLE_PRIORITY + 1)
+
+_Static_assert((LOG_SINK_SLOTS & (LOG_SINK_SLOTS - 1)) == 0,
+               "CONFIG_SOMNUS_MQTT_LOG_SINK_SLOTS must be a power of two");
+
+typedef enum {
+    LOG_SINK_LEVEL_ERROR = 0,
+    LOG_SINK_LEVEL_WARN,
+    LOG_SINK_LEVEL_INFO,
+    LOG_SINK_LEVEL_DEBUG,
+    LOG_SINK_LEVEL_COUNT,
+} log_sink_level_t;
+
+static const char *const kLevelNames[LOG_SINK_LEVEL_COUNT] = { "ERROR", "WARN", "INFO", "DEBUG" };
+
+static const uint32_t kLevelRate[LOG_SINK_LEVEL_COUNT] = {
+    CONFIG_SOMNUS_MQTT_LOG_SINK_RATE_ERROR,
+    CONFIG_SOMNUS_MQTT_LOG_SINK_RATE_WARN,
+    CONFIG_SOMNUS_MQTT_LOG_SINK_RATE_INFO,
+    CONFIG_SOMNUS_MQTT_LOG_SINK_RATE_DEBUG,
+};
+
+/*
+ * Bounded multi-producer, single-consumer ring. A slot is free for the writer
+ * at position p when seq == p and readable at tail t when seq == t + 1; the
+ * reader hands it back with seq = t + LOG_SINK_SLOTS. Writers claim a position
+ * with one CAS on head and never wait for each other or for the reader.
+ */
+typedef struct {
+    uint32_t seq;
+    uint8_t level;
+    char text[LOG_SINK_LINE_MAX];
+} log_sink_slot_t;
+
+typedef struct {
+    uint32_t window;                  ///< Second the count belongs to
+    uint32_t count;
+} log_sink_rate_t;
+
+// Allocated on first start and never freed: a writer preempted mid-copy may
+// still hold a slot when the sink stops
+static log_sink_slot_t *s_slots;
+static uint32_t s_head;
+static uint32_t s_tail;
+static log_sink_rate_t s_rate[LOG_SINK_LEVEL_COUNT];
+static uint32_t s_dropped_unreported;
+static somnus_mqtt_log_sink_stats_t s_stats;
+
+static struct {
+    bool running;
+    TaskHandle_t task;
+    SemaphoreHandle_t stopped;
+    vprintf_like_t prev_vprintf;
+    const char *stage_onboarding;
+    const char *stage_after;
+    char *payload;
+    const char *payload_start;        ///< Inside payload, where the envelope begins
+    size_t payload_len;               ///< Non-zero while a refused batch waits for retry
+    uint32_t payload_lines;
+} s_sink;
+
+static bool log_sink_admit(log_sink_level_t level)
+{
+    if (kLevelRate[level] == 0) {
+        return false;
+    }
+
+    log_sink_rate_t *rate = &s_rate[level];
+    uint32_t now = esp_log_timestamp() / 1000;
+    uint32_t window = __atomic_load_n(&rate->window, __ATOMIC_RELAXED);
+    if (window != now &&
+        __atomic_compare_exchange_n(&rate->window, &window, now, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        __atomic_store_n(&rate->count, 0, __ATOMIC_RELAXED);
+    }
+    if (__atomic_add_fetch(&rate->count, 1, __ATOMIC_RELAXED) > kLevelRate[level]) {
+        __atomic_fetch_add(&s_stats.dropped_rate, 1, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&s_dropped_unreported, 1, __ATOMIC_RELAXED);
+        return false;
+    }
+    return true;
+}
+
+static log_sink_slot_t *log_sink_claim(void)
+{
+    uint32_t pos = __atomic_load_n(&s_head, __ATOMIC_RELAXED);
+    for (;;) {
+        log_sink_slot_t *slot = &s_slots[pos & (LOG_SINK_SLOTS - 1)];
+        int32_t diff = (int32_t)(__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) - pos);
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&s_head, &pos, pos + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                return slot;
+            }
+        } else if (diff < 0) {
+            __atomic_fetch_add(&s_stats.dropped_full, 1, __ATOMIC_RELAXED);
+            __atomic_fetch_add(&s_dropped_unreported, 1, __ATOMIC_RELAXED);
+            return NULL;
+        } else {
+            pos = __atomic_load_n(&s_head, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+static void log_sink_commit(log_sink_slot_t *slot, log_sink_level_t level)
+{
+    slot->level = (uint8_t)level;
+    // seq was pos when claimed; pos + 1 publishes the line to the reader
+    __atomic_store_n(&slot->seq, slot->seq + 1, __ATOMIC_RELEASE);
+}
+
+// ESP_LOGx formats start with the level letter, after the colour code if any
+static int log_sink_level_from_format(const char *fmt)
+{
+    if (!fmt) {
+        return -1;
+    }
+    if (fmt[0] == '\033') {
+        fmt = strchr(fmt, 'm');
+        if (!fmt) {
+            return -1;
+        }
+        fmt++;
+    }
+    if (fmt[0] == '\0' || fmt[1] != ' ' || fmt[2] != '(') {
+        return -1;
+    }
+    switch (fmt[0]) {
+    case 'E':
+        return LOG_SINK_LEVEL_ERROR;
+    case 'W':
+        return LOG_SINK_LEVEL_WARN;
+    case 'I':
+        return LOG_SINK_LEVEL_INFO;
+    case 'D':
+    case 'V':
+        return LOG_SINK_LEVEL_DEBUG;
+    default:
+        return -1;
+    }
+}
+
+static int log_sink_vprintf(const char *fmt, va_list args)
+{
+    va_list copy;
+    va_copy(copy, args);
+    int ret = s_sink.prev_vprintf ? s_sink.prev_vprintf(fmt, args) : vprintf(fmt, args);
+
+    // The drain task's own lines (and the publish path it calls) stay local,
+    // otherwise every batch would schedule the next one
+    int level = log_sink_level_from_format(fmt);
+    if (level >= 0 && s_sink.running && xTaskGetCurrentTaskHandle() != s_sink.task &&
+        log_sink_admit((log_sink_level_t)level)) {
+        log_sink_slot_t *slot = log_sink_claim();
+        if (slot) {
+            vsnprintf(slot->text, sizeof(slot->text), fmt, copy);
+            log_sink_commit(slot, (log_sink_level_t)level);
+        }
+    }
+
+    va_end(copy);
+    return ret;
+}
+
+static log_sink_level_t log_sink_level_from_esp(esp_log_level_t level)
+{
+    switch (level) {
+    case ESP_LOG_ERROR:
+        return LOG_SINK_LEVEL_ERROR;
+    case ESP_LOG_WARN:
+        return LOG_SINK_LEVEL_WARN;
+    case ESP_LOG_INFO:
+        return LOG_SINK_LEVEL_INFO;
+    default:
+        return LOG_SINK_LEVEL_DEBUG;
+    }
+}
+
+esp_err_t somnus_mqtt_log_sink_enqueue(esp_log_level_t level, const char *message)
+{
+    if (!message || level == ESP_LOG_NONE) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!s_sink.running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    log_sink_level_t sink_level = log_sink_level_from_esp(level);
+    if (!log_sink_admit(sink_level)) {
+        return ESP_ERR_NO_MEM;
+    }
+    log_sink_slot_t *slot = log_sink_claim();
+    if (!slot) {
+        return ESP_ERR_NO_MEM;
+    }
+    strlcpy(slot->text, message, sizeof(slot->text));
+    log_sink_commit(slot, sink_level);
+    return ESP_OK;
+}
+
+static log_sink_slot_t *log_sink_peek(void)
+{
+    log_sink_slot_t *slot = &s_slots[s_tail & (LOG_SINK_SLOTS - 1)];
+    if (__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) != s_tail + 1) {
+        return NULL;
+    }
+    return slot;
+}
+
+static void log_sink_release(log_sink_slot_t *slot)
+{
+    __atomic_store_n(&slot->seq, s_tail + LOG_SINK_SLOTS, __ATOMIC_RELEASE);
+    s_tail++;
+}
+
+static bool log_sink_mentions_onboarding(const char *text)
+{
+    static const char kNeedle[] = "ONBOARDING";
+    for (const char *p = text; *p; ++p) {
+        size_t i = 0;
+        while (kNeedle[i] && p[i] && toupper((unsigned char)p[i]) == kNeedle[i]) {
+            ++i;
+        }
+        if (kNeedle[i] == '\0') {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ * JSON-escape one console line into out, dropping colour codes and the
+ * trailing newline. Returns the bytes written, or 0 if it does not fit.
+ */
+static size_t log_sink_escape(const char *line, char *out, size_t out_len)
+{
+    size_t n = 0;
+    for (const char *p = line; *p; ++p) {
+        char c = *p;
+        if (c == '\033') {
+            const char *end = strchr(p, 'm');
+            if (!end) {
+                break;
+            }
+            p = end;
+            continue;
+        }
+        if (c == '\n' || c == '\r') {
+            continue;
+        }
+        char esc[2];
+        size_t len = 1;
+        if (c == '"' || c == '\\') {
+            esc[0] = '\\';
+            esc[1] = c;
+            len = 2;
+        } else if ((unsigned char)c < 0x20) {
+            esc[0] = ' ';
+        } else {
+            esc[0] = c;
+        }
+        if (n + len >= out_len) {
+            return 0;
+        }
+        memcpy(out + n, esc, len);
+        n += len;
+    }
+    out[n] = '\0';
+    return n;
+}
+
+/*
+ * Gather waiting lines into s_sink.payload. A batch carries one LogName, so it
+ * ends early where the stage changes; its LogType is its most severe line.
+ */
+static bool log_sink_build_batch(void)
+{
+    char *text = s_sink.payload + SOMNUS_PROFILE_LOG_PREFIX_MAX;
+    size_t len = 0;
+    uint32_t lines = 0;
+    log_sink_level_t worst = LOG_SINK_LEVEL_DEBUG;
+    int onboarding = -1;
+    char line[LOG_SINK_LINE_MAX * 2 + 1]; // Every character escaped
+
+    uint32_t dropped = __atomic_exchange_n(&s_dropped_unreported, 0, __ATOMIC_RELAXED);
+    if (dropped) {
+        len = (size_t)snprintf(text, LOG_SINK_BATCH_MAX, "[%" PRIu32 " log lines dropped]", dropped);
+        worst = LOG_SINK_LEVEL_WARN;
+    }
+
+    log_sink_slot_t *slot;
+    while ((slot = log_sink_peek()) != NULL) {
+        slot->text[sizeof(slot->text) - 1] = '\0';
+        int stage = log_sink_mentions_onboarding(slot->text) ? 1 : 0;
+        if (onboarding >= 0 && stage != onboarding) {
+            break;
+        }
+        size_t n = log_sink_escape(slot->text, line, sizeof(line));
+        if (len + 2 + n >= LOG_SINK_BATCH_MAX) {
+            break; // Waits for the next interval
+        }
+        if (len) {
+            memcpy(text + len, "\\n", 2);
+            len += 2;
+        }
+        memcpy(text + len, line, n + 1);
+        len += n;
+        if (slot->level < worst) {
+            worst = (log_sink_level_t)slot->level;
+        }
+        onboarding = stage;
+        lines++;
+        log_sink_release(slot);
+    }
+
+    if (len == 0) {
+        return false;
+    }
+    text[len] = '\0';
+
+    char prefix[SOMNUS_PROFILE_LOG_PREFIX_MAX];
+    size_t prefix_len = somnus_profile_write_log_prefix(kLevelNames[worst],
+                                                        onboarding == 1 ? s_sink.stage_onboarding
+                                                                        : s_sink.stage_after,
+                                                        prefix,
+                                                        sizeof(prefix));
+    if (prefix_len == 0) {
+        // Not logged: the line would come straight back through the hook
+        return false;
+    }
+    char *start = text - prefix_len;
+    memcpy(start, prefix, prefix_len);
+    memcpy(text + len, SOMNUS_PROFILE_LOG_SUFFIX, sizeof(SOMNUS_PROFILE_LOG_SUFFIX));
+    s_sink.payload_start = start;
+    s_sink.payload_len = prefix_len + len + sizeof(SOMNUS_PROFILE_LOG_SUFFIX) - 1;
+    s_sink.payload_lines = lines;
+    return true;
+}
+
+static void log_sink_flush(void)
+{
+    if (s_sink.payload_len == 0 && !log_sink_build_batch()) {
+        return;
+    }
+
+    esp_err_t err = somnus_mqtt_publish_raw_log(s_sink.payload_start);
+    if (err == ESP_ERR_NO_MEM || err == ESP_ERR_INVALID_STATE) {
+        // Outbox full or AWS IoT service stopped: keep the batch, the ring
+        // absorbs new lines (and counts what it cannot) until the retry
+        __atomic_fetch_add(&s_stats.publish_deferred, 1, __ATOMIC_RELAXED);
+        return;
+    }
+    if (err == ESP_OK) {
+        __atomic_fetch_add(&s_stats.sent_lines, s_sink.payload_lines, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&s_stats.batches, 1, __ATOMIC_RELAXED);
+    }
+    s_sink.payload_len = 0;
+    s_sink.payload_lines = 0;
+}
+
+static void log_sink_task(void *arg)
+{
+    (void)arg;
+    while (s_sink.running) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(CONFIG_SOMNUS_MQTT_LOG_SINK_INTERVAL_MS));
+        if (s_sink.running) {
+            log_sink_flush();
+        }
+    }
+
+    s_sink.task = NULL;
+    xSemaphoreGive(s_sink.stopped);
+    vTaskDelete(NULL);
+}
+
+esp_err_t somnus_mqtt_log_sink_start(const char *stage_onboarding, const char *stage_after)
+{
+    ESP_RETURN_ON_FALSE(stage_onboarding && stage_after, ESP_ERR_INVALID_ARG, TAG, "stage names required");
+    if (s_sink.running) {
+        return ESP_OK;
+    }
+
+    if (!s_slots) {
+        s_slots = MEM_TAG_CALLOC(MEM_TAG_MQTT, LOG_SINK_SLOTS, sizeof(*s_slots));
+        ESP_RETURN_ON_FALSE(s_slots, ESP_ERR_NO_MEM, TAG, "Failed to allocate log ring");
+        for (uint32_t i = 0; i < LOG_SINK_SLOTS; ++i) {
+            s_slots[i].seq = i;
+        }
+    }
+    if (!s_sink.stopped) {
+        s_sink.stopped = xSemaphoreCreateBinary();
+        ESP_RETURN_ON_FALSE(s_sink.stopped, ESP_ERR_NO_MEM, TAG, "Failed to create semaphore");
+    }
+
+    s_sink.payload = MEM_TAG_MALLOC(MEM_TAG_MQTT, LOG_SINK_PAYLOAD_MAX);
+    if (!s_sink.payload) {
+        return ESP_ERR_NO_MEM;
+    }
+    s_sink.payload_len = 0;
+    s_sink.stage_onboarding = stage_onboarding;
+    s_sink.stage_after = stage_after;
+    s_sink.running = true;
+
+    // Same core as the AWS IoT service task, away from the audio core
+    BaseType_t created = xTaskCreatePinnedToCore(log_sink_task,
+                                                 "somnus_log_sink",
+                                                 LOG_SINK_TASK_STACK,
+                                                 NULL,
+                                                 LOG_SINK_TASK_PRIO,
+                                                 &s_sink.task,
+                                                 CONFIG_NAPHOME_AWS_IOT_TASK_CORE);
+    if (created != pdPASS) {
+        s_sink.running = false;
+        MEM_TAG_FREE(MEM_TAG_MQTT, s_sink.payload);
+        s_sink.payload = NULL;
+        ESP_LOGE(TAG, "Failed to create log sink task");
+        return ESP_ERR_NO_MEM;
+    }
+
+    s_sink.prev_vprintf = esp_log_set_vprintf(log_sink_vprintf);
+    ESP_LOGI(TAG, "Forwarding logs every %d ms (E/W/I/D %d/%d/%d/%d per s)",
+             CONFIG_SOMNUS_MQTT_LOG_SINK_INTERVAL_MS,
+             CONFIG_SOMNUS_MQTT_LOG_SINK_RATE_ERROR,
+             CONFIG_SOMNUS_MQTT_LOG_SINK_RATE_WARN,
+             CONFIG_SOMNUS_MQTT_LOG_SINK_RATE_INFO,
+             CONFIG_SOMNUS_MQTT_LOG_SINK_RATE_DEBUG);
+    return ESP_OK;
+}
+
+esp_err_t somnus_mqtt_log_sink_stop(void)
+{
+    if (!s_sink.running) {
+        return ESP_OK;
+    }
+
+    // The hook stays callable through prev_vprintf for any writer already in it
+    esp_log_set_vprintf(s_sink.prev_vprintf ? s_sink.prev_vprintf : vprintf);
+    s_sink.running = false;
+
+    if (s_sink.task) {
+        xTaskNotifyGive(s_sink.task);
+        if (xSemaphoreTake(s_sink.stopped, pdMS_TO_TICKS(2000)) != pdTRUE) {
+            ESP_LOGW(TAG, "Timed out waiting for log sink task to stop");
+            return ESP_ERR_TIMEOUT;
+        }
+    }
+
+    MEM_TAG_FREE(MEM_TAG_MQTT, s_sink.payload);
+    s_sink.payload = NULL;
+    s_sink.payload_len = 0;
+    return ESP_OK;
+}
+
+void somnus_mqtt_log_sink_get_stats(somnus_mqtt_log_sink_stats_t *out)
+{
+    if (!out) {
+        return;
+    }
+
+    out->queued = s_slots ? __atomic_load_n(&s_head, __ATOMIC_RELAXED) - s_tail : 0;
+    out->sent_lines = __atomic_load_n(&s_stats.sent_lines, __ATOMIC_RELAXED);
+    out->batches = __atomic_load_n(&s_stats.batches, __ATOMIC_RELAXED);
+    out->dropped_rate = __atomic_load_n(&s_stats.dropped_rate, __ATOMIC_RELAXED);
+    out->dropped_full = __atomic_load_n(&s_stats.dropped_full, __ATOMIC_RELAXED);
+    out->publish_deferred = __atomic_load_n(&s_stats.publish_deferred, __ATOMIC_RELAXED);
+}
+
+#else /* !CONFIG_SOMNUS_MQTT_LOG_SINK */
+
+esp_err_t somnus_mqtt_log_sink_start(const char *stage_onboarding, const char *stage_after)
+{
+    (void)stage_onboarding;
+    (void)stage_after;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t somnus_mqtt_log_sink_stop(void)
+{
+    return ESP_OK;
+}
+
+esp_err_t somnus_mqtt_log_sink_enqueue(esp_log_level_t level, const char *message)
+{
+    (void)level;
+    (void)message;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+void somnus_mqtt_log_sink_get_stats(somnus_mqtt_log_sink_stats_t *out)
+{
+    if (out) {
+        memset(out, 0, sizeof(*out));
+    }
+}
+
+#endif /* CONFIG_SOMNUS_MQTT_LOG_SINK */
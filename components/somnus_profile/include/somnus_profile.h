@@ -34,11 +34,55 @@ extern "C" {
 /** Prefix applied to the device MAC (hex, uppercase, no separators). */
 #define SOMNUS_DEVICE_ID_PREFIX "SOMNUS_"
 
+/** Device ID length including the NUL: prefix plus 12 hex digits. */
+#define SOMNUS_DEVICE_ID_LEN (sizeof(SOMNUS_DEVICE_ID_PREFIX) + 12)
+
+/** Topic heads; the device ID completes each topic. */
+#define SOMNUS_PROFILE_SUBSCRIBE_TOPIC_HEAD "device/somnus/"
+#define SOMNUS_PROFILE_LOG_TOPIC_HEAD       "device/receive/uat/"
+#define SOMNUS_PROFILE_TELEMETRY_TOPIC_HEAD "device/telemetry/"
+
+/** Longest topic in the profile, including the NUL. */
+#define SOMNUS_PROFILE_TOPIC_MAX 48
+
+/** Room somnus_profile_write_log_prefix() needs for any stage and level name. */
+#define SOMNUS_PROFILE_LOG_PREFIX_MAX 160
+
+/** Closes the LogText string and the JSON objects opened by the log prefix. */
+#define SOMNUS_PROFILE_LOG_SUFFIX "\"}}"
+
 /**
- * @brief Compute the Somnus-formatted device ID for this ESP32.
+ * @brief Identifiers and topics for this device, built once by somnus_profile_load().
+ *
+ * Immutable after load, so callers keep the pointers for as long as they like.
+ */
+typedef struct {
+    char device_id[SOMNUS_DEVICE_ID_LEN];             ///< SOMNUS_<MAC>
+    char subscribe_topic[SOMNUS_PROFILE_TOPIC_MAX];   ///< device/somnus/{DEVICE_ID}
+    char log_topic[SOMNUS_PROFILE_TOPIC_MAX];         ///< device/receive/uat/{DEVICE_ID}
+    char telemetry_topic[SOMNUS_PROFILE_TOPIC_MAX];   ///< device/telemetry/{DEVICE_ID}
+    char log_prefix[96];                              ///< Log payload up to the LogName value
+    size_t log_prefix_len;
+} somnus_profile_t;
+
+/**
+ * @brief Read the station MAC and build the device ID, topics and log framing.
  *
  * Device IDs are composed of the literal prefix "SOMNUS_" followed by the
  * station MAC address rendered as 12 uppercase hexadecimal characters.
+ * Later calls return ESP_OK without doing anything.
+ *
+ * @return ESP_OK on success, or an ESP-IDF error from esp_read_mac().
+ */
+esp_err_t somnus_profile_load(void);
+
+/**
+ * @brief The loaded profile, or NULL before somnus_profile_load() succeeds.
+ */
+const somnus_profile_t *somnus_profile_get(void);
+
+/**
+ * @brief Copy the Somnus-formatted device ID, loading the profile if needed.
  *
  * @param[out] out Buffer to receive the null-terminated device ID string.
  * @param[out] out_len Length of @p out in bytes.
@@ -49,37 +93,16 @@ extern "C" {
 esp_err_t somnus_profile_get_device_id(char *out, size_t out_len);
 
 /**
- * @brief Compose the Somnus MQTT subscribe and log topics for this device.
- *
- * Topics follow the patterns:
- *   subscribe: device/somnus/{DEVICE_ID}
- *   log:       device/receive/uat/{DEVICE_ID}
- *
- * @param[out] subscribe Buffer for the subscribe topic (null-terminated).
- * @param[in]  subscribe_len Length of the subscribe buffer.
- * @param[out] log Buffer for the log topic (null-terminated).
- * @param[in]  log_len Length of the log buffer.
- * @return ESP_OK on success, ESP_ERR_INVALID_ARG for invalid pointers,
- *         ESP_ERR_INVALID_SIZE if buffers are too small, or propagated error
- *         from somnus_profile_get_device_id().
- */
-esp_err_t somnus_profile_get_topics(char *subscribe,
-                                    size_t subscribe_len,
-                                    char *log,
-                                    size_t log_len);
-
-/**
- * @brief Compose the Somnus telemetry topic for this device.
+ * @brief Write a log payload up to the opening quote of its LogText value.
  *
- * Topic pattern: device/telemetry/{DEVICE_ID}
+ * The caller appends the JSON-escaped text and SOMNUS_PROFILE_LOG_SUFFIX,
+ * so text can be written straight into the payload buffer. Only the stage
+ * and level are copied; the rest comes from the profile.
  *
- * @param[out] telemetry Buffer for the telemetry topic (null-terminated).
- * @param[in]  telemetry_len Length of the telemetry buffer.
- * @return ESP_OK on success, ESP_ERR_INVALID_ARG for invalid pointers,
- *         ESP_ERR_INVALID_SIZE if buffer is too small, or propagated error
- *         from somnus_profile_get_device_id().
+ * @return Bytes written (not NUL-terminated), or 0 if the profile is not
+ *         loaded, an argument is NULL or @p out_len is too small.
  */
-esp_err_t somnus_profile_get_telemetry_topic(char *telemetry, size_t telemetry_len);
+size_t somnus_profile_write_log_prefix(const char *level, const char *stage, char *out, size_t out_len);
 
 /**
  * @brief Format a Somnus MQTT log payload into the provided buffer.
@@ -101,8 +124,8 @@ esp_err_t somnus_profile_get_telemetry_topic(char *telemetry, size_t telemetry_l
  * @param[out] out  Destination buffer for the JSON payload.
  * @param[in] out_len Size of @p out in bytes.
  * @return ESP_OK on success, ESP_ERR_INVALID_ARG for bad pointers,
- *         ESP_ERR_INVALID_SIZE if the buffer is insufficient, otherwise
- *         propagated error from somnus_profile_get_device_id().
+ *         ESP_ERR_INVALID_STATE before somnus_profile_load(),
+ *         ESP_ERR_INVALID_SIZE if the buffer is insufficient.
  */
 esp_err_t somnus_profile_format_log_payload(const char *level,
                                             const char *stage,
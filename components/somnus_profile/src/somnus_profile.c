@@ -11,6 +11,13 @@
 
 #define SOMNUS_DEVICE_ID_BODY_LEN 12
 
+// Log payload pieces between the profile prefix and the text
+#define SOMNUS_LOG_TYPE_KEY "\",\"LogType\":\""
+#define SOMNUS_LOG_TEXT_KEY "\",\"LogText\":\""
+
+static somnus_profile_t s_profile;
+static bool s_loaded;
+
 static esp_err_t somnus_profile_compose_device_id(char *out,
                                                   size_t out_len,
                                                   const uint8_t mac[6])
@@ -42,10 +49,19 @@ static esp_err_t somnus_profile_compose_device_id(char *out,
     return ESP_OK;
 }
 
-esp_err_t somnus_profile_get_device_id(char *out, size_t out_len)
+static esp_err_t somnus_profile_compose(char *out, size_t out_len, const char *head, const char *tail)
 {
-    if (!out || out_len == 0) {
-        return ESP_ERR_INVALID_ARG;
+    int written = snprintf(out, out_len, "%s%s%s", head, s_profile.device_id, tail);
+    if (written < 0 || (size_t)written >= out_len) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    return ESP_OK;
+}
+
+esp_err_t somnus_profile_load(void)
+{
+    if (s_loaded) {
+        return ESP_OK;
     }
 
     uint8_t mac[6] = {0};
@@ -54,64 +70,79 @@ esp_err_t somnus_profile_get_device_id(char *out, size_t out_len)
         return err;
     }
 
-    return somnus_profile_compose_device_id(out, out_len, mac);
+    // The only formatting the profile does; everything after reuses these
+    err = somnus_profile_compose_device_id(s_profile.device_id, sizeof(s_profile.device_id), mac);
+    if (err == ESP_OK) {
+        err = somnus_profile_compose(s_profile.subscribe_topic, sizeof(s_profile.subscribe_topic),
+                                     SOMNUS_PROFILE_SUBSCRIBE_TOPIC_HEAD, "");
+    }
+    if (err == ESP_OK) {
+        err = somnus_profile_compose(s_profile.log_topic, sizeof(s_profile.log_topic),
+                                     SOMNUS_PROFILE_LOG_TOPIC_HEAD, "");
+    }
+    if (err == ESP_OK) {
+        err = somnus_profile_compose(s_profile.telemetry_topic, sizeof(s_profile.telemetry_topic),
+                                     SOMNUS_PROFILE_TELEMETRY_TOPIC_HEAD, "");
+    }
+    if (err == ESP_OK) {
+        err = somnus_profile_compose(s_profile.log_prefix, sizeof(s_profile.log_prefix),
+                                     "{\"Action\":\"Log\",\"Data\":{\"DeviceId\":\"", "\",\"LogName\":\"");
+    }
+    if (err != ESP_OK) {
+        memset(&s_profile, 0, sizeof(s_profile));
+        return err;
+    }
+    s_profile.log_prefix_len = strlen(s_profile.log_prefix);
+    s_loaded = true;
+    return ESP_OK;
+}
+
+const somnus_profile_t *somnus_profile_get(void)
+{
+    return s_loaded ? &s_profile : NULL;
 }
 
-esp_err_t somnus_profile_get_topics(char *subscribe,
-                                    size_t subscribe_len,
-                                    char *log,
-                                    size_t log_len)
+esp_err_t somnus_profile_get_device_id(char *out, size_t out_len)
 {
-    if (!subscribe || !log) {
+    if (!out || out_len == 0) {
         return ESP_ERR_INVALID_ARG;
     }
 
-    char device_id[SOMNUS_DEVICE_ID_BODY_LEN + sizeof(SOMNUS_DEVICE_ID_PREFIX)] = {0};
-    esp_err_t err = somnus_profile_get_device_id(device_id, sizeof(device_id));
+    esp_err_t err = somnus_profile_load();
     if (err != ESP_OK) {
         return err;
     }
-
-    int sub_written = snprintf(subscribe,
-                               subscribe_len,
-                               "device/somnus/%s",
-                               device_id);
-    if (sub_written < 0 || (size_t)sub_written >= subscribe_len) {
-        return ESP_ERR_INVALID_SIZE;
-    }
-
-    int log_written = snprintf(log,
-                               log_len,
-                               "device/receive/uat/%s",
-                               device_id);
-    if (log_written < 0 || (size_t)log_written >= log_len) {
+    if (strlcpy(out, s_profile.device_id, out_len) >= out_len) {
         return ESP_ERR_INVALID_SIZE;
     }
-
     return ESP_OK;
 }
 
-esp_err_t somnus_profile_get_telemetry_topic(char *telemetry, size_t telemetry_len)
+size_t somnus_profile_write_log_prefix(const char *level, const char *stage, char *out, size_t out_len)
 {
-    if (!telemetry) {
-        return ESP_ERR_INVALID_ARG;
+    if (!s_loaded || !level || !stage || !out) {
+        return 0;
     }
 
-    char device_id[SOMNUS_DEVICE_ID_BODY_LEN + sizeof(SOMNUS_DEVICE_ID_PREFIX)] = {0};
-    esp_err_t err = somnus_profile_get_device_id(device_id, sizeof(device_id));
-    if (err != ESP_OK) {
-        return err;
+    const size_t stage_len = strlen(stage);
+    const size_t level_len = strlen(level);
+    const size_t total = s_profile.log_prefix_len + stage_len + sizeof(SOMNUS_LOG_TYPE_KEY) - 1 + level_len +
+                         sizeof(SOMNUS_LOG_TEXT_KEY) - 1;
+    if (total > out_len) {
+        return 0;
     }
 
-    int written = snprintf(telemetry,
-                           telemetry_len,
-                           "device/telemetry/%s",
-                           device_id);
-    if (written < 0 || (size_t)written >= telemetry_len) {
-        return ESP_ERR_INVALID_SIZE;
-    }
-
-    return ESP_OK;
+    char *p = out;
+    memcpy(p, s_profile.log_prefix, s_profile.log_prefix_len);
+    p += s_profile.log_prefix_len;
+    memcpy(p, stage, stage_len);
+    p += stage_len;
+    memcpy(p, SOMNUS_LOG_TYPE_KEY, sizeof(SOMNUS_LOG_TYPE_KEY) - 1);
+    p += sizeof(SOMNUS_LOG_TYPE_KEY) - 1;
+    memcpy(p, level, level_len);
+    p += level_len;
+    memcpy(p, SOMNUS_LOG_TEXT_KEY, sizeof(SOMNUS_LOG_TEXT_KEY) - 1);
+    return total;
 }
 
 esp_err_t somnus_profile_format_log_payload(const char *level,
@@ -123,24 +154,20 @@ esp_err_t somnus_profile_format_log_payload(const char *level,
     if (!level || !stage || !message || !out) {
         return ESP_ERR_INVALID_ARG;
     }
-
-    char device_id[SOMNUS_DEVICE_ID_BODY_LEN + sizeof(SOMNUS_DEVICE_ID_PREFIX)] = {0};
-    esp_err_t err = somnus_profile_get_device_id(device_id, sizeof(device_id));
-    if (err != ESP_OK) {
-        return err;
+    if (!s_loaded) {
+        return ESP_ERR_INVALID_STATE;
     }
 
-    int written = snprintf(out,
-                           out_len,
-                           "{\"Action\":\"Log\",\"Data\":{\"DeviceId\":\"%s\",\"LogName\":\"%s\",\"LogType\":\"%s\",\"LogText\":\"%s\"}}",
-                           device_id,
-                           stage,
-                           level,
-                           message);
-    if (written < 0 || (size_t)written >= out_len) {
+    size_t len = somnus_profile_write_log_prefix(level, stage, out, out_len);
+    if (len == 0) {
         return ESP_ERR_INVALID_SIZE;
     }
+    const size_t message_len = strlen(message);
+    if (len + message_len + sizeof(SOMNUS_PROFILE_LOG_SUFFIX) > out_len) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    memcpy(out + len, message, message_len);
+    memcpy(out + len + message_len, SOMNUS_PROFILE_LOG_SUFFIX, sizeof(SOMNUS_PROFILE_LOG_SUFFIX));
 
     return ESP_OK;
 }
-
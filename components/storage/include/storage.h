@@ -0,0 +1,80 @@
+/**
+ * @file storage.h
+ * @brief Small files that change at runtime, on a LittleFS partition.
+ *
+ * Rules, credentials and caches live here rather than on SPIFFS. LittleFS
+ * updates its metadata copy-on-write in bounded steps, so a writer never
+ * waits out a garbage-collection pass of hundreds of milliseconds, and a
+ * power cut leaves each file as it was before or after a write.
+ *
+ * storage_write_atomic() writes a temporary file next to the target, syncs
+ * it and renames it over the target, which LittleFS does atomically. The
+ * data goes out in flash_guard steps, so writes pace themselves around live
+ * audio.
+ *
+ *     ESP_RETURN_ON_ERROR(storage_mount(NULL), TAG, "storage");
+ *     storage_write_atomic(STORAGE_PATH("rules.json"), json, len);
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "esp_err.h"
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef CONFIG_STORAGE_PARTITION_LABEL
+#define CONFIG_STORAGE_PARTITION_LABEL "storage"
+#endif
+
+#ifndef CONFIG_STORAGE_BASE_PATH
+#define CONFIG_STORAGE_BASE_PATH "/storage"
+#endif
+
+// A file under the mount point, e.g. STORAGE_PATH("rules.json")
+#define STORAGE_PATH(name) CONFIG_STORAGE_BASE_PATH "/" name
+
+typedef struct {
+    const char *partition_label;      // NULL = CONFIG_STORAGE_PARTITION_LABEL
+    const char *base_path;            // NULL = CONFIG_STORAGE_BASE_PATH
+} storage_config_t;
+
+/**
+ * @brief Mount the partition, formatting it if it holds no filesystem.
+ *
+ * @param cfg NULL for the Kconfig defaults
+ * @return ESP_OK also when already mounted; ESP_ERR_NOT_FOUND without the partition
+ */
+esp_err_t storage_mount(const storage_config_t *cfg);
+
+bool storage_mounted(void);
+
+/**
+ * @brief Read a whole file into a buffer from malloc(), with a terminator
+ *        after the data so text can be used as a string.
+ *
+ * @return ESP_ERR_NOT_FOUND when the file does not exist
+ */
+esp_err_t storage_read(const char *path, char **out_data, size_t *out_len);
+
+/**
+ * @brief Replace path with data, or leave it untouched if anything fails.
+ *
+ * Writers of the same path are serialised. Call from a task: the write
+ * may wait for audio (flash_guard.h).
+ */
+esp_err_t storage_write_atomic(const char *path, const void *data, size_t len);
+
+// A missing file is not an error
+esp_err_t storage_remove(const char *path);
+
+esp_err_t storage_info(size_t *out_total, size_t *out_used);
+
+#ifdef __cplusplus
+}
+#endif
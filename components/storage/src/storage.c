@@ -0,0 +1,177 @@
+#include "storage.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "esp_littlefs.h"
+#include "esp_log.h"
+#include "flash_guard.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+static const char *TAG = "storage";
+
+#define TMP_SUFFIX ".tmp"
+#define PATH_MAX_LEN 96
+
+static struct {
+    const char *label;
+    SemaphoreHandle_t write_lock;     // One temporary file per path at a time, and one writer is plenty
+    bool mounted;
+} s_storage;
+
+esp_err_t storage_mount(const storage_config_t *cfg)
+{
+    if (s_storage.mounted) {
+        return ESP_OK;
+    }
+    const char *label = cfg && cfg->partition_label ? cfg->partition_label : CONFIG_STORAGE_PARTITION_LABEL;
+    esp_vfs_littlefs_conf_t conf = {
+        .base_path = cfg && cfg->base_path ? cfg->base_path : CONFIG_STORAGE_BASE_PATH,
+        .partition_label = label,
+        .format_if_mount_failed = true,
+    };
+    if (!s_storage.write_lock) {
+        s_storage.write_lock = xSemaphoreCreateMutex();
+        if (!s_storage.write_lock) {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    esp_err_t err = esp_vfs_littlefs_register(&conf);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Mounting \"%s\" at %s failed: %s", label, conf.base_path, esp_err_to_name(err));
+        return err;
+    }
+    s_storage.label = label;
+    s_storage.mounted = true;
+    size_t total = 0;
+    size_t used = 0;
+    esp_littlefs_info(label, &total, &used);
+    ESP_LOGI(TAG, "\"%s\" mounted at %s: %u of %u KB used", label, conf.base_path, (unsigned)(used / 1024),
+             (unsigned)(total / 1024));
+    return ESP_OK;
+}
+
+bool storage_mounted(void)
+{
+    return s_storage.mounted;
+}
+
+esp_err_t storage_read(const char *path, char **out_data, size_t *out_len)
+{
+    if (!path || !out_data) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *out_data = NULL;
+    if (out_len) {
+        *out_len = 0;
+    }
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        return errno == ENOENT ? ESP_ERR_NOT_FOUND : ESP_FAIL;
+    }
+    struct stat st;
+    if (fstat(fileno(f), &st) != 0 || st.st_size < 0) {
+        fclose(f);
+        return ESP_FAIL;
+    }
+    size_t len = (size_t)st.st_size;
+    char *data = malloc(len + 1);
+    if (!data) {
+        fclose(f);
+        return ESP_ERR_NO_MEM;
+    }
+    bool ok = fread(data, 1, len, f) == len;
+    fclose(f);
+    if (!ok) {
+        free(data);
+        return ESP_FAIL;
+    }
+    data[len] = '\0';
+    *out_data = data;
+    if (out_len) {
+        *out_len = len;
+    }
+    return ESP_OK;
+}
+
+static bool write_file(const char *path, const uint8_t *data, size_t len)
+{
+    FILE *f = fopen(path, "wb");
+    if (!f) {
+        return false;
+    }
+    bool ok = true;
+    for (size_t done = 0; ok && done < len;) {
+        size_t n = len - done < FLASH_GUARD_STEP_BYTES ? len - done : FLASH_GUARD_STEP_BYTES;
+        flash_guard_wait();
+        ok = fwrite(data + done, 1, n, f) == n && fflush(f) == 0;
+        done += n;
+    }
+    flash_guard_wait();
+    ok = ok && fsync(fileno(f)) == 0;
+    ok = fclose(f) == 0 && ok;
+    return ok;
+}
+
+esp_err_t storage_write_atomic(const char *path, const void *data, size_t len)
+{
+    if (!path || (!data && len > 0)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!s_storage.mounted) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    char tmp[PATH_MAX_LEN];
+    if (snprintf(tmp, sizeof(tmp), "%s" TMP_SUFFIX, path) >= (int)sizeof(tmp)) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    xSemaphoreTake(s_storage.write_lock, portMAX_DELAY);
+    esp_err_t err = ESP_OK;
+    if (!write_file(tmp, data, len)) {
+        ESP_LOGE(TAG, "Writing %s failed", tmp);
+        err = ESP_FAIL;
+    } else if (rename(tmp, path) != 0) {
+        // LittleFS replaces an existing target in the same step
+        ESP_LOGE(TAG, "Replacing %s failed: errno %d", path, errno);
+        err = ESP_FAIL;
+    }
+    if (err != ESP_OK) {
+        unlink(tmp);
+    }
+    xSemaphoreGive(s_storage.write_lock);
+    return err;
+}
+
+esp_err_t storage_remove(const char *path)
+{
+    if (!path) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (unlink(path) != 0 && errno != ENOENT) {
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+esp_err_t storage_info(size_t *out_total, size_t *out_used)
+{
+    if (!s_storage.mounted) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    size_t total = 0;
+    size_t used = 0;
+    esp_err_t err = esp_littlefs_info(s_storage.label, &total, &used);
+    if (out_total) {
+        *out_total = total;
+    }
+    if (out_used) {
+        *out_used = used;
+    }
+    return err;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <stdbool.h>
+
+#include "esp_err.h"
+#include "esp_netif.h"
+#include "esp_wifi_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Station reconnect policy shared by wifi_manager and the application.
+ *
+ * The BSSID and channel of the last AP that handed out an address are kept
+ * in NVS. Connecting starts with a directed attempt at that AP on that
+ * channel. Only if that fails does it fall back to a full scan. Retries
+ * back off exponentially instead of hammering a rebooting router. The PSK
+ * to PMK derivation is cached by the Wi-Fi driver itself (default
+ * WIFI_STORAGE_FLASH) as long as SSID and password stay the same, and
+ * CONFIG_LWIP_DHCP_RESTORE_LAST_IP lets DHCP re-request the previous lease.
+ *
+ * Call the on_* hooks from the WIFI_EVENT / IP_EVENT handler.
+ */
+
+/**
+ * Set the station config: the given SSID, password and auth mode, plus the
+ * cached AP hints when they belong to this SSID. Also used when switching
+ * networks at runtime.
+ */
+esp_err_t wifi_fast_connect_configure(const wifi_config_t *config);
+
+/** Use CONFIG_NAPHOME_WIFI_STATIC_IP instead of DHCP; no-op when it is empty */
+esp_err_t wifi_fast_connect_apply_static_ip(esp_netif_t *netif);
+
+/** WIFI_EVENT_STA_START: first connect attempt */
+void wifi_fast_connect_on_start(void);
+
+/**
+ * WIFI_EVENT_STA_DISCONNECTED: a failed directed attempt falls back to a
+ * full scan at once; otherwise the next attempt is scheduled with backoff.
+ *
+ * @param max_attempts Give up after this many (0 = never)
+ * @return Number of the attempt scheduled, or -1 after giving up
+ */
+int wifi_fast_connect_on_disconnect(int max_attempts);
+
+/** IP_EVENT_STA_GOT_IP: reset the backoff and remember the AP */
+void wifi_fast_connect_on_got_ip(void);
+
+/** Stop a pending retry, e.g. before esp_wifi_stop() */
+void wifi_fast_connect_cancel(void);
+
+/** Drop the cached AP, e.g. when credentials change */
+void wifi_fast_connect_forget(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,225 @@
+#include "wifi_fast_connect.h"
+
+#include <string.h>
+
+#include "esp_check.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_wifi.h"
+#include "nvs.h"
+#include "sdkconfig.h"
+
+#define FAST_CONNECT_NVS_NAMESPACE "wifi_fast"
+#define FAST_CONNECT_NVS_KEY "ap"
+
+#ifdef CONFIG_NAPHOME_WIFI_FAST_CONNECT
+#define FAST_CONNECT_ENABLED 1
+#else
+#define FAST_CONNECT_ENABLED 0
+#endif
+
+static const char *TAG = "wifi_fast";
+
+// Last AP that handed out an address
+typedef struct {
+    char ssid[33];
+    uint8_t bssid[6];
+    uint8_t channel;
+} fast_connect_ap_t;
+
+static wifi_config_t s_config;        // Credentials only; hints are added per attempt
+static fast_connect_ap_t s_ap;
+static bool s_have_ap;
+static bool s_directed;               // Current attempt is pinned to s_ap
+static bool s_connected;
+static int s_attempts;
+static esp_timer_handle_t s_retry_timer;
+
+static bool load_ap(fast_connect_ap_t *ap)
+{
+    nvs_handle_t nvs;
+    if (nvs_open(FAST_CONNECT_NVS_NAMESPACE, NVS_READONLY, &nvs) != ESP_OK) {
+        return false;
+    }
+    size_t len = sizeof(*ap);
+    esp_err_t err = nvs_get_blob(nvs, FAST_CONNECT_NVS_KEY, ap, &len);
+    nvs_close(nvs);
+    return err == ESP_OK && len == sizeof(*ap) && ap->channel > 0;
+}
+
+static void store_ap(const fast_connect_ap_t *ap)
+{
+    nvs_handle_t nvs;
+    esp_err_t err = nvs_open(FAST_CONNECT_NVS_NAMESPACE, NVS_READWRITE, &nvs);
+    if (err == ESP_OK) {
+        err = nvs_set_blob(nvs, FAST_CONNECT_NVS_KEY, ap, sizeof(*ap));
+        if (err == ESP_OK) {
+            err = nvs_commit(nvs);
+        }
+        nvs_close(nvs);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "AP not cached: %s", esp_err_to_name(err));
+    }
+}
+
+static esp_err_t set_station(bool directed)
+{
+    wifi_config_t cfg = s_config;
+    s_directed = directed && s_have_ap;
+    if (s_directed) {
+        cfg.sta.bssid_set = true;
+        memcpy(cfg.sta.bssid, s_ap.bssid, sizeof(cfg.sta.bssid));
+        cfg.sta.channel = s_ap.channel;
+        cfg.sta.scan_method = WIFI_FAST_SCAN;
+    } else {
+        cfg.sta.scan_method = WIFI_ALL_CHANNEL_SCAN;
+        cfg.sta.sort_method = WIFI_CONNECT_AP_BY_SIGNAL;
+    }
+    return esp_wifi_set_config(WIFI_IF_STA, &cfg);
+}
+
+static uint32_t backoff_ms(int attempt)
+{
+    uint32_t delay = CONFIG_NAPHOME_WIFI_BACKOFF_MIN_MS;
+    for (int i = 1; i < attempt && delay < CONFIG_NAPHOME_WIFI_BACKOFF_MAX_MS; ++i) {
+        delay *= 2;
+    }
+    return delay < CONFIG_NAPHOME_WIFI_BACKOFF_MAX_MS ? delay : CONFIG_NAPHOME_WIFI_BACKOFF_MAX_MS;
+}
+
+static void retry_timer_cb(void *arg)
+{
+    (void)arg;
+    // Every round starts with the known AP again; a miss falls back to a scan
+    if (s_have_ap && !s_directed) {
+        set_station(true);
+    }
+    esp_wifi_connect();
+}
+
+esp_err_t wifi_fast_connect_configure(const wifi_config_t *config)
+{
+    ESP_RETURN_ON_FALSE(config, ESP_ERR_INVALID_ARG, TAG, "config");
+    if (!s_retry_timer) {
+        const esp_timer_create_args_t args = {
+            .callback = retry_timer_cb,
+            .name = "wifi_retry",
+        };
+        ESP_RETURN_ON_ERROR(esp_timer_create(&args, &s_retry_timer), TAG, "retry timer");
+    }
+    wifi_fast_connect_cancel();
+
+    s_config = *config;
+    s_config.sta.bssid_set = false;
+    s_config.sta.channel = 0;
+    s_attempts = 0;
+    s_connected = false;
+
+    s_have_ap = FAST_CONNECT_ENABLED && load_ap(&s_ap) &&
+                strncmp(s_ap.ssid, (const char *)s_config.sta.ssid, sizeof(s_config.sta.ssid)) == 0;
+    if (s_have_ap) {
+        ESP_LOGI(TAG, "Connecting straight to " MACSTR " on channel %u",
+                 MAC2STR(s_ap.bssid), (unsigned)s_ap.channel);
+    }
+    return set_station(true);
+}
+
+esp_err_t wifi_fast_connect_apply_static_ip(esp_netif_t *netif)
+{
+    if (CONFIG_NAPHOME_WIFI_STATIC_IP[0] == '\0') {
+        return ESP_OK;
+    }
+    ESP_RETURN_ON_FALSE(netif, ESP_ERR_INVALID_ARG, TAG, "netif");
+
+    esp_netif_ip_info_t info = {0};
+    ESP_RETURN_ON_ERROR(esp_netif_str_to_ip4(CONFIG_NAPHOME_WIFI_STATIC_IP, &info.ip), TAG, "static IP");
+    ESP_RETURN_ON_ERROR(esp_netif_str_to_ip4(CONFIG_NAPHOME_WIFI_STATIC_NETMASK, &info.netmask), TAG, "netmask");
+    ESP_RETURN_ON_ERROR(esp_netif_str_to_ip4(CONFIG_NAPHOME_WIFI_STATIC_GATEWAY, &info.gw), TAG, "gateway");
+
+    esp_err_t err = esp_netif_dhcpc_stop(netif);
+    ESP_RETURN_ON_FALSE(err == ESP_OK || err == ESP_ERR_ESP_NETIF_DHCP_ALREADY_STOPPED, err, TAG, "DHCP stop");
+    ESP_RETURN_ON_ERROR(esp_netif_set_ip_info(netif, &info), TAG, "set IP");
+
+    // Without DHCP nobody hands out a resolver; the gateway usually is one
+    esp_netif_dns_info_t dns = {0};
+    dns.ip.type = ESP_IPADDR_TYPE_V4;
+    const char *server = CONFIG_NAPHOME_WIFI_STATIC_DNS[0] ? CONFIG_NAPHOME_WIFI_STATIC_DNS
+                                                          : CONFIG_NAPHOME_WIFI_STATIC_GATEWAY;
+    ESP_RETURN_ON_ERROR(esp_netif_str_to_ip4(server, &dns.ip.u_addr.ip4), TAG, "DNS");
+    ESP_RETURN_ON_ERROR(esp_netif_set_dns_info(netif, ESP_NETIF_DNS_MAIN, &dns), TAG, "set DNS");
+
+    ESP_LOGI(TAG, "Static IP " IPSTR ", DHCP off", IP2STR(&info.ip));
+    return ESP_OK;
+}
+
+void wifi_fast_connect_on_start(void)
+{
+    esp_wifi_connect();
+}
+
+int wifi_fast_connect_on_disconnect(int max_attempts)
+{
+    // A link that was up starts a fresh round at the shortest delay
+    bool was_connected = s_connected;
+    s_connected = false;
+    if (was_connected) {
+        s_attempts = 0;
+    } else if (s_directed) {
+        ESP_LOGW(TAG, "Cached AP not joined, scanning all channels");
+        set_station(false);
+        esp_wifi_connect();
+        return s_attempts;
+    }
+
+    if (max_attempts > 0 && s_attempts >= max_attempts) {
+        return -1;
+    }
+    s_attempts++;
+    uint32_t delay = backoff_ms(s_attempts);
+    ESP_LOGI(TAG, "Reconnect attempt %d in %u ms", s_attempts, (unsigned)delay);
+    esp_timer_stop(s_retry_timer);
+    esp_timer_start_once(s_retry_timer, (uint64_t)delay * 1000);
+    return s_attempts;
+}
+
+void wifi_fast_connect_on_got_ip(void)
+{
+    s_attempts = 0;
+    s_connected = true;
+
+    wifi_ap_record_t ap_info;
+    if (!FAST_CONNECT_ENABLED || esp_wifi_sta_get_ap_info(&ap_info) != ESP_OK) {
+        return;
+    }
+    fast_connect_ap_t ap = {0};
+    // A 32-byte SSID has no terminator in wifi_config_t
+    memcpy(ap.ssid, s_config.sta.ssid, sizeof(s_config.sta.ssid));
+    memcpy(ap.bssid, ap_info.bssid, sizeof(ap.bssid));
+    ap.channel = ap_info.primary;
+    // Only write flash when the AP actually changed
+    if (!s_have_ap || memcmp(&ap, &s_ap, sizeof(ap)) != 0) {
+        store_ap(&ap);
+        ESP_LOGI(TAG, "Cached " MACSTR " on channel %u", MAC2STR(ap.bssid), (unsigned)ap.channel);
+    }
+    s_ap = ap;
+    s_have_ap = true;
+}
+
+void wifi_fast_connect_cancel(void)
+{
+    if (s_retry_timer) {
+        esp_timer_stop(s_retry_timer);
+    }
+}
+
+void wifi_fast_connect_forget(void)
+{
+    s_have_ap = false;
+    nvs_handle_t nvs;
+    if (nvs_open(FAST_CONNECT_NVS_NAMESPACE, NVS_READWRITE, &nvs) == ESP_OK) {
+        nvs_erase_key(nvs, FAST_CONNECT_NVS_KEY);
+        nvs_commit(nvs);
+        nvs_close(nvs);
+    }
+}
@@ -1,4 +1,5 @@
 #include "wifi_manager.h"
+#include "wifi_fast_connect.h"
 
 #include <string.h>
 
@@ -42,7 +43,7 @@ static void wifi_event_handler(void *arg,
     if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_START) {
         if (s_auto_connect_configured) {
             ESP_LOGI(TAG, "Wi-Fi started, attempting connect");
-            esp_wifi_connect();
+            wifi_fast_connect_on_start();
         } else {
             ESP_LOGI(TAG, "Wi-Fi started with no stored credentials; awaiting provisioning");
         }
@@ -51,17 +52,16 @@ static void wifi_event_handler(void *arg,
         ESP_LOGW(TAG, "Disconnected from AP (reason=%d)", disconnected ? disconnected->reason : 0);
         xEventGroupClearBits(s_wifi_event_group, WIFI_CONNECTED_BIT);
 
-        if (CONFIG_NAPHOME_WIFI_MAX_RETRY == 0 || s_retry_count < CONFIG_NAPHOME_WIFI_MAX_RETRY) {
-            esp_wifi_connect();
-            s_retry_count++;
-            ESP_LOGI(TAG, "Retrying connection (%d)", s_retry_count);
-        } else {
+        // Retries back off; the first goes straight to the last AP
+        s_retry_count = wifi_fast_connect_on_disconnect(CONFIG_NAPHOME_WIFI_MAX_RETRY);
+        if (s_retry_count < 0) {
             ESP_LOGE(TAG, "Max retry count reached (%d)", CONFIG_NAPHOME_WIFI_MAX_RETRY);
             xEventGroupSetBits(s_wifi_event_group, WIFI_FAIL_BIT);
         }
     } else if (event_base == IP_EVENT && event_id == IP_EVENT_STA_GOT_IP) {
         ip_event_got_ip_t *event = (ip_event_got_ip_t *)event_data;
         s_retry_count = 0;
+        wifi_fast_connect_on_got_ip();
         xEventGroupSetBits(s_wifi_event_group, WIFI_CONNECTED_BIT);
         ESP_LOGI(TAG, "Obtained IP address: " IPSTR, IP2STR(&event->ip_info.ip));
     }
@@ -119,6 +119,7 @@ esp_err_t wifi_manager_start(void)
     if (!s_netif) {
         s_netif = esp_netif_create_default_wifi_sta();
         ESP_RETURN_ON_FALSE(s_netif, ESP_ERR_NO_MEM, TAG, "Failed to create default Wi-Fi STA");
+        ESP_RETURN_ON_ERROR(wifi_fast_connect_apply_static_ip(s_netif), TAG, "static IP config failed");
     }
 
     wifi_init_config_t cfg = WIFI_INIT_CONFIG_DEFAULT();
@@ -137,7 +138,7 @@ esp_err_t wifi_manager_start(void)
         wifi_config.sta.pmf_cfg.capable = true;
         wifi_config.sta.pmf_cfg.required = false;
 
-        ESP_RETURN_ON_ERROR(esp_wifi_set_config(WIFI_IF_STA, &wifi_config), TAG, "esp_wifi_set_config failed");
+        ESP_RETURN_ON_ERROR(wifi_fast_connect_configure(&wifi_config), TAG, "esp_wifi_set_config failed");
         s_auto_connect_configured = true;
     } else {
         s_auto_connect_configured = false;
@@ -176,7 +177,8 @@ esp_err_t wifi_manager_connect(const char *ssid, const char *password, TickType_
     wifi_config.sta.pmf_cfg.capable = true;
     wifi_config.sta.pmf_cfg.required = false;
 
-    ESP_RETURN_ON_ERROR(esp_wifi_set_config(WIFI_IF_STA, &wifi_config), TAG, "runtime esp_wifi_set_config failed");
+    // Cached AP hints only apply when the SSID matches the one they were learnt on
+    ESP_RETURN_ON_ERROR(wifi_fast_connect_configure(&wifi_config), TAG, "runtime esp_wifi_set_config failed");
 
     if (s_wifi_event_group) {
         xEventGroupClearBits(s_wifi_event_group, WIFI_CONNECTED_BIT | WIFI_FAIL_BIT);
@@ -205,6 +207,7 @@ esp_err_t wifi_manager_stop(void)
         return ESP_OK;
     }
 
+    wifi_fast_connect_cancel();
     esp_wifi_stop();
     esp_wifi_deinit();
     unregister_event_handlers();
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "driver/gpio.h"
+#include "driver/rmt_tx.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// One RMT tick per microsecond; a symbol half holds up to 32767 us
+#define IR_TX_RESOLUTION_HZ          1000000
+#define IR_TX_TIMEOUT_MS             500
+
+// NEC: 38 kHz, pulse-distance bits LSB first, 108 ms frame period
+#define IR_TX_NEC_CARRIER_HZ         38000
+#define IR_TX_NEC_HEADER_MARK_US     9000
+#define IR_TX_NEC_HEADER_SPACE_US    4500
+#define IR_TX_NEC_REPEAT_SPACE_US    2250
+#define IR_TX_NEC_MARK_US            560
+#define IR_TX_NEC_ZERO_SPACE_US      560
+#define IR_TX_NEC_ONE_SPACE_US       1690
+#define IR_TX_NEC_PERIOD_MS          108
+#define IR_TX_NEC_SYMBOLS            34   // Header, 32 bits, stop mark
+#define IR_TX_NEC_REPEAT_SYMBOLS     2
+
+// RC5: 36 kHz, 14 Manchester bits of 2 x 889 us, 114 ms frame period
+#define IR_TX_RC5_CARRIER_HZ         36000
+#define IR_TX_RC5_HALF_BIT_US        889
+#define IR_TX_RC5_PERIOD_MS          114
+#define IR_TX_RC5_SYMBOLS            14
+
+/*
+ * Symbol initializers, so a code table is built by the compiler and lives
+ * in flash: sending it is a copy into RMT memory with no encoding at run
+ * time. Level 1 is carrier on.
+ */
+#define IR_TX_MARK_SPACE(mark_us, space_us) \
+    {.duration0 = (mark_us), .level0 = 1, .duration1 = (space_us), .level1 = 0}
+
+#define IR_TX_NEC_BIT(b) \
+    IR_TX_MARK_SPACE(IR_TX_NEC_MARK_US, (b) ? IR_TX_NEC_ONE_SPACE_US : IR_TX_NEC_ZERO_SPACE_US)
+#define IR_TX_NEC_BYTE(v) \
+    IR_TX_NEC_BIT((v) & 0x01), IR_TX_NEC_BIT((v) & 0x02), IR_TX_NEC_BIT((v) & 0x04), IR_TX_NEC_BIT((v) & 0x08), \
+    IR_TX_NEC_BIT((v) & 0x10), IR_TX_NEC_BIT((v) & 0x20), IR_TX_NEC_BIT((v) & 0x40), IR_TX_NEC_BIT((v) & 0x80)
+// Address, its inverse, command, its inverse
+#define IR_TX_NEC_FRAME(address, command) \
+    IR_TX_MARK_SPACE(IR_TX_NEC_HEADER_MARK_US, IR_TX_NEC_HEADER_SPACE_US), \
+    IR_TX_NEC_BYTE(address), IR_TX_NEC_BYTE(~(address)), \
+    IR_TX_NEC_BYTE(command), IR_TX_NEC_BYTE(~(command)), \
+    IR_TX_MARK_SPACE(IR_TX_NEC_MARK_US, IR_TX_NEC_ZERO_SPACE_US)
+#define IR_TX_NEC_REPEAT \
+    IR_TX_MARK_SPACE(IR_TX_NEC_HEADER_MARK_US, IR_TX_NEC_REPEAT_SPACE_US), \
+    IR_TX_MARK_SPACE(IR_TX_NEC_MARK_US, IR_TX_NEC_ZERO_SPACE_US)
+
+// A one is off then on, a zero on then off
+#define IR_TX_RC5_BIT(b) \
+    {.duration0 = IR_TX_RC5_HALF_BIT_US, .level0 = (b) ? 0 : 1, \
+     .duration1 = IR_TX_RC5_HALF_BIT_US, .level1 = (b) ? 1 : 0}
+// Start, field (inverted command bit 6), toggle, 5 address bits, 6 command bits, MSB first
+#define IR_TX_RC5_FRAME(address, command, toggle) \
+    IR_TX_RC5_BIT(1), IR_TX_RC5_BIT(!((command) & 0x40)), IR_TX_RC5_BIT(toggle), \
+    IR_TX_RC5_BIT((address) & 0x10), IR_TX_RC5_BIT((address) & 0x08), IR_TX_RC5_BIT((address) & 0x04), \
+    IR_TX_RC5_BIT((address) & 0x02), IR_TX_RC5_BIT((address) & 0x01), \
+    IR_TX_RC5_BIT((command) & 0x20), IR_TX_RC5_BIT((command) & 0x10), IR_TX_RC5_BIT((command) & 0x08), \
+    IR_TX_RC5_BIT((command) & 0x04), IR_TX_RC5_BIT((command) & 0x02), IR_TX_RC5_BIT((command) & 0x01)
+
+/**
+ * @brief One button, ready to send
+ */
+typedef struct {
+    const char *name;
+    uint32_t carrier_hz;
+    const rmt_symbol_word_t *frame;
+    const rmt_symbol_word_t *toggled;  ///< Frame with the toggle bit set, alternated per press (RC5); NULL if none
+    const rmt_symbol_word_t *repeat;   ///< Sent while held instead of the frame (NEC); NULL resends the frame
+    uint8_t frame_len;
+    uint8_t repeat_len;
+    uint16_t period_ms;                ///< Start of one frame to start of the next
+} ir_tx_code_t;
+
+typedef struct {
+    gpio_num_t gpio;
+    uint8_t duty_percent;            ///< Carrier duty; 0 uses 33
+} ir_tx_config_t;
+
+typedef struct {
+    ir_tx_config_t config;
+    bool initialized;
+    rmt_channel_handle_t channel;
+    rmt_encoder_handle_t encoder;    // Copy encoder: symbols go to RMT memory as they are
+    uint32_t carrier_hz;             // Carrier currently applied to the channel
+    bool toggle;                     // RC5 toggle bit for the next press
+} ir_tx_t;
+
+/**
+ * @brief Claim an RMT TX channel of its own for the IR LED.
+ *
+ * The channel uses its plain 48-symbol block rather than DMA, which the
+ * SoC has for one channel only and the LED strip may hold, and the lowest
+ * interrupt priority, so a send never delays the audio interrupts. Every
+ * built-in frame fits the block, so it is copied in once before it starts.
+ */
+esp_err_t ir_tx_init(ir_tx_t *tx, const ir_tx_config_t *config);
+
+/**
+ * @brief Send raw symbols and wait until they are on the wire.
+ *
+ * Use this for captured frames, such as an AC's full-state commands.
+ * Symbols are read while sending, so they must stay valid until it returns.
+ */
+esp_err_t ir_tx_send_symbols(ir_tx_t *tx, uint32_t carrier_hz, const rmt_symbol_word_t *symbols, size_t count);
+
+/**
+ * @brief Send one press of a code, then repeats more frames as if held.
+ */
+esp_err_t ir_tx_send_code(ir_tx_t *tx, const ir_tx_code_t *code, uint8_t repeats);
+
+/**
+ * @brief Encode and send a code that is not in the library.
+ */
+esp_err_t ir_tx_send_nec(ir_tx_t *tx, uint8_t address, uint8_t command, uint8_t repeats);
+esp_err_t ir_tx_send_rc5(ir_tx_t *tx, uint8_t address, uint8_t command, uint8_t repeats);
+
+/**
+ * @brief Fill symbols with one frame, the same as the IR_TX_*_FRAME initializers.
+ *
+ * @return Symbols written: IR_TX_NEC_SYMBOLS or IR_TX_RC5_SYMBOLS
+ */
+size_t ir_tx_encode_nec(uint8_t address, uint8_t command, rmt_symbol_word_t *symbols);
+size_t ir_tx_encode_rc5(uint8_t address, uint8_t command, bool toggle, rmt_symbol_word_t *symbols);
+
+/**
+ * @brief Look a code up in the built-in library (src/ir_codes.c) by name.
+ *
+ * @return NULL if there is no such code
+ */
+const ir_tx_code_t *ir_tx_find_code(const char *name);
+
+esp_err_t ir_tx_deinit(ir_tx_t *tx);
+
+#ifdef __cplusplus
+}
+#endif
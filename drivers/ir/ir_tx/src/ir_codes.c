@@ -0,0 +1,59 @@
+#include "ir_tx.h"
+
+#include <string.h>
+
+/*
+ * Built-in codes. Every frame is expanded from the IR_TX_* initializers by
+ * the compiler, so the tables are const data in flash and sending one
+ * needs no encoding. Add a device by adding its buttons here.
+ */
+
+static const rmt_symbol_word_t s_nec_repeat[] = {IR_TX_NEC_REPEAT};
+
+#define NEC_CODE(name_, address, command) \
+    { \
+        .name = (name_), \
+        .carrier_hz = IR_TX_NEC_CARRIER_HZ, \
+        .frame = (const rmt_symbol_word_t[]){IR_TX_NEC_FRAME(address, command)}, \
+        .repeat = s_nec_repeat, \
+        .frame_len = IR_TX_NEC_SYMBOLS, \
+        .repeat_len = IR_TX_NEC_REPEAT_SYMBOLS, \
+        .period_ms = IR_TX_NEC_PERIOD_MS, \
+    }
+
+#define RC5_CODE(name_, address, command) \
+    { \
+        .name = (name_), \
+        .carrier_hz = IR_TX_RC5_CARRIER_HZ, \
+        .frame = (const rmt_symbol_word_t[]){IR_TX_RC5_FRAME(address, command, 0)}, \
+        .toggled = (const rmt_symbol_word_t[]){IR_TX_RC5_FRAME(address, command, 1)}, \
+        .frame_len = IR_TX_RC5_SYMBOLS, \
+        .period_ms = IR_TX_RC5_PERIOD_MS, \
+    }
+
+static const ir_tx_code_t s_codes[] = {
+    // LG TVs: NEC, address 0x04
+    NEC_CODE("lg_tv_power", 0x04, 0x08),
+    NEC_CODE("lg_tv_volume_up", 0x04, 0x02),
+    NEC_CODE("lg_tv_volume_down", 0x04, 0x03),
+    NEC_CODE("lg_tv_mute", 0x04, 0x09),
+    NEC_CODE("lg_tv_input", 0x04, 0x0B),
+    // Philips TVs: RC5, system 0
+    RC5_CODE("philips_tv_power", 0, 12),
+    RC5_CODE("philips_tv_volume_up", 0, 16),
+    RC5_CODE("philips_tv_volume_down", 0, 17),
+    RC5_CODE("philips_tv_mute", 0, 13),
+};
+
+const ir_tx_code_t *ir_tx_find_code(const char *name)
+{
+    if (!name) {
+        return NULL;
+    }
+    for (size_t i = 0; i < sizeof(s_codes) / sizeof(s_codes[0]); ++i) {
+        if (strcmp(s_codes[i].name, name) == 0) {
+            return &s_codes[i];
+        }
+    }
+    return NULL;
+}
@@ -0,0 +1,197 @@
+#include "ir_tx.h"
+
+#include <inttypes.h>
+#include <string.h>
+#include "esp_check.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "soc/soc_caps.h"
+
+static const char *TAG = "ir_tx";
+
+#define IR_TX_DEFAULT_DUTY_PERCENT   33
+
+static const rmt_symbol_word_t s_nec_repeat[] = {IR_TX_NEC_REPEAT};
+
+static esp_err_t ir_tx_apply_carrier(ir_tx_t *tx, uint32_t carrier_hz)
+{
+    if (carrier_hz == tx->carrier_hz) {
+        return ESP_OK;
+    }
+    uint8_t duty = tx->config.duty_percent ? tx->config.duty_percent : IR_TX_DEFAULT_DUTY_PERCENT;
+    rmt_carrier_config_t carrier = {
+        .frequency_hz = carrier_hz,
+        .duty_cycle = duty / 100.0f,
+    };
+    ESP_RETURN_ON_ERROR(rmt_apply_carrier(tx->channel, &carrier), TAG, "carrier %" PRIu32 " Hz", carrier_hz);
+    tx->carrier_hz = carrier_hz;
+    return ESP_OK;
+}
+
+static uint32_t ir_tx_duration_us(const rmt_symbol_word_t *symbols, size_t count)
+{
+    uint32_t total = 0;
+    for (size_t i = 0; i < count; ++i) {
+        total += symbols[i].duration0 + symbols[i].duration1;
+    }
+    return total;
+}
+
+esp_err_t ir_tx_init(ir_tx_t *tx, const ir_tx_config_t *config)
+{
+    ESP_RETURN_ON_FALSE(tx && config && config->duty_percent <= 100, ESP_ERR_INVALID_ARG, TAG, "invalid arguments");
+    memset(tx, 0, sizeof(*tx));
+    memcpy(&tx->config, config, sizeof(ir_tx_config_t));
+
+    rmt_tx_channel_config_t channel_config = {
+        .gpio_num = config->gpio,
+        .clk_src = RMT_CLK_SRC_DEFAULT,
+        .resolution_hz = IR_TX_RESOLUTION_HZ,
+        .mem_block_symbols = SOC_RMT_MEM_WORDS_PER_CHANNEL,
+        .trans_queue_depth = 1,
+        .intr_priority = 1,
+    };
+    rmt_copy_encoder_config_t encoder_config = {};
+    esp_err_t err = rmt_new_tx_channel(&channel_config, &tx->channel);
+    if (err == ESP_OK) {
+        err = rmt_new_copy_encoder(&encoder_config, &tx->encoder);
+    }
+    if (err == ESP_OK) {
+        err = ir_tx_apply_carrier(tx, IR_TX_NEC_CARRIER_HZ);
+    }
+    if (err == ESP_OK) {
+        err = rmt_enable(tx->channel);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "RMT TX channel setup failed (%s)", esp_err_to_name(err));
+        if (tx->encoder) {
+            rmt_del_encoder(tx->encoder);
+        }
+        if (tx->channel) {
+            rmt_del_channel(tx->channel);
+        }
+        memset(tx, 0, sizeof(*tx));
+        return err;
+    }
+
+    tx->initialized = true;
+    ESP_LOGI(TAG, "IR TX on GPIO%d", config->gpio);
+    return ESP_OK;
+}
+
+esp_err_t ir_tx_send_symbols(ir_tx_t *tx, uint32_t carrier_hz, const rmt_symbol_word_t *symbols, size_t count)
+{
+    ESP_RETURN_ON_FALSE(tx && symbols && count > 0 && carrier_hz > 0, ESP_ERR_INVALID_ARG, TAG,
+                        "invalid argument");
+    ESP_RETURN_ON_FALSE(tx->initialized, ESP_ERR_INVALID_STATE, TAG, "not initialized");
+    ESP_RETURN_ON_ERROR(ir_tx_apply_carrier(tx, carrier_hz), TAG, "carrier failed");
+
+    rmt_transmit_config_t transmit_config = {
+        .loop_count = 0,
+    };
+    ESP_RETURN_ON_ERROR(rmt_transmit(tx->channel, tx->encoder, symbols, count * sizeof(rmt_symbol_word_t),
+                                     &transmit_config), TAG, "transmit failed");
+    return rmt_tx_wait_all_done(tx->channel, IR_TX_TIMEOUT_MS);
+}
+
+esp_err_t ir_tx_send_code(ir_tx_t *tx, const ir_tx_code_t *code, uint8_t repeats)
+{
+    ESP_RETURN_ON_FALSE(tx && code && code->frame && code->frame_len > 0, ESP_ERR_INVALID_ARG, TAG,
+                        "invalid argument");
+    const rmt_symbol_word_t *frame = tx->toggle && code->toggled ? code->toggled : code->frame;
+    const rmt_symbol_word_t *symbols = frame;
+    size_t count = code->frame_len;
+
+    for (int i = 0; i <= repeats; ++i) {
+        if (i > 0) {
+            // Whatever the frame took, the next one starts a period after it
+            uint32_t sent_ms = ir_tx_duration_us(symbols, count) / 1000;
+            if (code->period_ms > sent_ms) {
+                vTaskDelay(pdMS_TO_TICKS(code->period_ms - sent_ms));
+            }
+            if (code->repeat) {
+                symbols = code->repeat;
+                count = code->repeat_len;
+            }
+        }
+        ESP_RETURN_ON_ERROR(ir_tx_send_symbols(tx, code->carrier_hz, symbols, count), TAG, "%s failed",
+                            code->name ? code->name : "code");
+    }
+    // The receiver tells a new press of the same button by the flipped bit
+    if (code->toggled) {
+        tx->toggle = !tx->toggle;
+    }
+    return ESP_OK;
+}
+
+size_t ir_tx_encode_nec(uint8_t address, uint8_t command, rmt_symbol_word_t *symbols)
+{
+    const uint8_t bytes[4] = {address, (uint8_t)~address, command, (uint8_t)~command};
+    size_t n = 0;
+    symbols[n++] = (rmt_symbol_word_t)IR_TX_MARK_SPACE(IR_TX_NEC_HEADER_MARK_US, IR_TX_NEC_HEADER_SPACE_US);
+    for (size_t i = 0; i < sizeof(bytes); ++i) {
+        for (int bit = 0; bit < 8; ++bit) {
+            symbols[n++] = (rmt_symbol_word_t)IR_TX_NEC_BIT((bytes[i] >> bit) & 1);
+        }
+    }
+    symbols[n++] = (rmt_symbol_word_t)IR_TX_MARK_SPACE(IR_TX_NEC_MARK_US, IR_TX_NEC_ZERO_SPACE_US);
+    return n;
+}
+
+size_t ir_tx_encode_rc5(uint8_t address, uint8_t command, bool toggle, rmt_symbol_word_t *symbols)
+{
+    // Start, field, toggle, then address and command MSB first
+    uint16_t word = (1u << 13) | ((command & 0x40) ? 0 : (1u << 12)) | (toggle ? (1u << 11) : 0) |
+                    ((address & 0x1F) << 6) | (command & 0x3F);
+    for (int i = 0; i < IR_TX_RC5_SYMBOLS; ++i) {
+        symbols[i] = (rmt_symbol_word_t)IR_TX_RC5_BIT((word >> (IR_TX_RC5_SYMBOLS - 1 - i)) & 1);
+    }
+    return IR_TX_RC5_SYMBOLS;
+}
+
+esp_err_t ir_tx_send_nec(ir_tx_t *tx, uint8_t address, uint8_t command, uint8_t repeats)
+{
+    rmt_symbol_word_t frame[IR_TX_NEC_SYMBOLS];
+    ir_tx_code_t code = {
+        .name = "nec",
+        .carrier_hz = IR_TX_NEC_CARRIER_HZ,
+        .frame = frame,
+        .repeat = s_nec_repeat,
+        .frame_len = (uint8_t)ir_tx_encode_nec(address, command, frame),
+        .repeat_len = IR_TX_NEC_REPEAT_SYMBOLS,
+        .period_ms = IR_TX_NEC_PERIOD_MS,
+    };
+    return ir_tx_send_code(tx, &code, repeats);
+}
+
+esp_err_t ir_tx_send_rc5(ir_tx_t *tx, uint8_t address, uint8_t command, uint8_t repeats)
+{
+    rmt_symbol_word_t frame[IR_TX_RC5_SYMBOLS];
+    rmt_symbol_word_t toggled[IR_TX_RC5_SYMBOLS];
+    ir_tx_encode_rc5(address, command, false, frame);
+    ir_tx_code_t code = {
+        .name = "rc5",
+        .carrier_hz = IR_TX_RC5_CARRIER_HZ,
+        .frame = frame,
+        .toggled = toggled,
+        .frame_len = (uint8_t)ir_tx_encode_rc5(address, command, true, toggled),
+        .period_ms = IR_TX_RC5_PERIOD_MS,
+    };
+    return ir_tx_send_code(tx, &code, repeats);
+}
+
+esp_err_t ir_tx_deinit(ir_tx_t *tx)
+{
+    ESP_RETURN_ON_FALSE(tx, ESP_ERR_INVALID_ARG, TAG, "tx null");
+    if (!tx->initialized) {
+        return ESP_OK;
+    }
+    rmt_disable(tx->channel);
+    rmt_del_channel(tx->channel);
+    rmt_del_encoder(tx->encoder);
+    tx->channel = NULL;
+    tx->encoder = NULL;
+    tx->initialized = false;
+    return ESP_OK;
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "driver/i2c_master.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define AS7341_DEFAULT_ADDR          0x39
+#define AS7341_I2C_TIMEOUT_MS        100
+#define AS7341_SPECTRAL_CHANNELS     8
+
+/**
+ * Six ADCs serve eleven photodiodes, so a reading covers one bank at a
+ * time; both banks also carry Clear and NIR.
+ */
+typedef enum {
+    AS7341_BANK_F1_F4 = 0,
+    AS7341_BANK_F5_F8,
+} as7341_bank_t;
+
+// AGAIN codes: 0.5x, then doubling up to 512x
+typedef enum {
+    AS7341_GAIN_0_5X = 0,
+    AS7341_GAIN_1X,
+    AS7341_GAIN_2X,
+    AS7341_GAIN_4X,
+    AS7341_GAIN_8X,
+    AS7341_GAIN_16X,
+    AS7341_GAIN_32X,
+    AS7341_GAIN_64X,
+    AS7341_GAIN_128X,
+    AS7341_GAIN_256X,
+    AS7341_GAIN_512X,
+} as7341_gain_t;
+
+typedef struct {
+    uint8_t atime;                    ///< Integration is (atime + 1) * (astep + 1) * 2.78 µs
+    uint16_t astep;
+    as7341_gain_t gain;
+} as7341_config_t;
+
+typedef struct {
+    uint16_t f[AS7341_SPECTRAL_CHANNELS];  ///< F1 (415 nm) to F8 (680 nm)
+    uint16_t clear;
+    uint16_t nir;
+    bool saturated;                   ///< Either bank clipped in its latest reading
+    uint8_t fresh;                    ///< Bit per as7341_bank_t read since the part powered up
+} as7341_spectrum_t;
+
+typedef struct {
+    as7341_config_t config;
+    as7341_bank_t bank;               ///< Bank the SMUX is routed to now
+    as7341_spectrum_t spectrum;
+    bool bank_saturated[2];
+    bool initialized;
+    i2c_master_dev_handle_t i2c_dev;
+} as7341_t;
+
+/**
+ * @brief Check the ID, power on, set integration and gain, and route the
+ *        SMUX to the F1-F4 bank.
+ *
+ * Talks through dev->i2c_dev, which the caller attaches. as7341_deinit()
+ * powers the part down and hands the handle back to the bus. After a
+ * failed init the handle is still the caller's.
+ */
+esp_err_t as7341_init(as7341_t *dev, const as7341_config_t *config);
+
+/**
+ * @brief Integration time plus start-up, the least to wait after
+ *        as7341_start() before as7341_read().
+ */
+uint32_t as7341_measurement_ms(const as7341_t *dev);
+
+/**
+ * @brief Start a measurement on the routed bank.
+ *
+ * @return ESP_ERR_NOT_FINISHED while the SMUX is still being routed
+ */
+esp_err_t as7341_start(as7341_t *dev);
+
+/**
+ * @brief Collect the measurement if the spectral-valid flag is up, then
+ *        route the SMUX to the other bank for the next one.
+ *
+ * The read is one status byte and one 13-byte burst; rerouting writes the
+ * cached 20-byte SMUX table in one more. Routing runs in the part while the
+ * caller does other work, so alternating banks costs no waiting.
+ *
+ * @param bank Optional; the bank just read
+ * @return ESP_ERR_NOT_FINISHED before the measurement is valid
+ */
+esp_err_t as7341_read(as7341_t *dev, as7341_bank_t *bank);
+
+/**
+ * @brief Both banks as last read; check fresh for a full spectrum.
+ */
+void as7341_get_spectrum(const as7341_t *dev, as7341_spectrum_t *spectrum);
+
+esp_err_t as7341_deinit(as7341_t *dev);
+
+#ifdef __cplusplus
+}
+#endif
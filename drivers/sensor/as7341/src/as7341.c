@@ -0,0 +1,213 @@
+#include "as7341.h"
+
+#include <string.h>
+#include "esp_check.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+static const char *TAG = "as7341";
+
+#define AS7341_REG_SMUX_RAM          0x00
+#define AS7341_REG_ENABLE            0x80
+#define AS7341_REG_ATIME             0x81
+#define AS7341_REG_ID                0x92
+#define AS7341_REG_ASTATUS           0x94
+#define AS7341_REG_STATUS2           0xA3
+#define AS7341_REG_CFG1              0xAA
+#define AS7341_REG_CFG6              0xAF
+#define AS7341_REG_ASTEP_L           0xCA
+
+#define AS7341_ID_MASK               0xFC
+#define AS7341_ID                    0x24
+
+#define AS7341_PON                   (1 << 0)
+#define AS7341_SP_EN                 (1 << 1)
+#define AS7341_SMUXEN                (1 << 4)
+#define AS7341_SMUX_CMD_WRITE        (2 << 3)
+#define AS7341_AVALID                (1 << 6)
+#define AS7341_ASAT                  (1 << 7)
+
+#define AS7341_SMUX_LEN              20
+// ASTATUS and six 16-bit channels, read in one burst; reading ASTATUS latches them
+#define AS7341_DATA_LEN              13
+#define AS7341_STARTUP_MS            2
+#define AS7341_SMUX_POLLS            10
+
+// SMUX tables, from the AS7341 application note: ADC0-3 take four filters,
+// ADC4 Clear and ADC5 NIR
+static const uint8_t SMUX_F1_F4[AS7341_SMUX_LEN] = {
+    0x30, 0x01, 0x00, 0x00, 0x00, 0x42, 0x00, 0x00, 0x50, 0x00,
+    0x00, 0x00, 0x20, 0x04, 0x00, 0x30, 0x01, 0x50, 0x00, 0x06,
+};
+static const uint8_t SMUX_F5_F8[AS7341_SMUX_LEN] = {
+    0x00, 0x00, 0x00, 0x40, 0x02, 0x00, 0x10, 0x03, 0x50, 0x10,
+    0x03, 0x00, 0x00, 0x00, 0x24, 0x00, 0x00, 0x50, 0x00, 0x06,
+};
+
+// Weak so the unit test can model SMUXEN clearing, or hanging, after a route
+__attribute__((weak)) esp_err_t as7341_i2c_transfer(i2c_master_dev_handle_t i2c_dev,
+                                                    const uint8_t *write_buf,
+                                                    size_t write_size,
+                                                    uint8_t *read_buf,
+                                                    size_t read_size,
+                                                    int timeout_ms)
+{
+    if (read_size == 0) {
+        return i2c_master_transmit(i2c_dev, write_buf, write_size, timeout_ms);
+    }
+    return i2c_master_transmit_receive(i2c_dev, write_buf, write_size, read_buf, read_size, timeout_ms);
+}
+
+// Registers auto-increment, so one write covers a run of them
+static esp_err_t as7341_write_regs(as7341_t *dev, uint8_t reg, const uint8_t *data, size_t len)
+{
+    if (dev->i2c_dev == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    uint8_t buf[1 + AS7341_SMUX_LEN];
+    if (len > AS7341_SMUX_LEN) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    buf[0] = reg;
+    memcpy(&buf[1], data, len);
+    return as7341_i2c_transfer(dev->i2c_dev, buf, len + 1, NULL, 0, AS7341_I2C_TIMEOUT_MS);
+}
+
+static esp_err_t as7341_write_reg(as7341_t *dev, uint8_t reg, uint8_t value)
+{
+    return as7341_write_regs(dev, reg, &value, 1);
+}
+
+static esp_err_t as7341_read_regs(as7341_t *dev, uint8_t reg, uint8_t *data, size_t len)
+{
+    if (dev->i2c_dev == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    return as7341_i2c_transfer(dev->i2c_dev, &reg, 1, data, len, AS7341_I2C_TIMEOUT_MS);
+}
+
+// Measurement stops, the table goes over in one burst and the part routes it
+// on its own; SMUXEN clears when done
+static esp_err_t as7341_route(as7341_t *dev, as7341_bank_t bank)
+{
+    ESP_RETURN_ON_ERROR(as7341_write_reg(dev, AS7341_REG_ENABLE, AS7341_PON), TAG, "stop failed");
+    ESP_RETURN_ON_ERROR(as7341_write_regs(dev, AS7341_REG_SMUX_RAM,
+                                          bank == AS7341_BANK_F1_F4 ? SMUX_F1_F4 : SMUX_F5_F8, AS7341_SMUX_LEN),
+                        TAG, "smux table write failed");
+    ESP_RETURN_ON_ERROR(as7341_write_reg(dev, AS7341_REG_CFG6, AS7341_SMUX_CMD_WRITE), TAG, "smux command failed");
+    ESP_RETURN_ON_ERROR(as7341_write_reg(dev, AS7341_REG_ENABLE, AS7341_PON | AS7341_SMUXEN), TAG,
+                        "smux enable failed");
+    dev->bank = bank;
+    return ESP_OK;
+}
+
+esp_err_t as7341_init(as7341_t *dev, const as7341_config_t *config)
+{
+    ESP_RETURN_ON_FALSE(dev && config, ESP_ERR_INVALID_ARG, TAG, "invalid arguments");
+    ESP_RETURN_ON_FALSE(config->gain <= AS7341_GAIN_512X, ESP_ERR_INVALID_ARG, TAG, "invalid gain");
+    memcpy(&dev->config, config, sizeof(as7341_config_t));
+    dev->initialized = false;
+    memset(&dev->spectrum, 0, sizeof(dev->spectrum));
+    memset(dev->bank_saturated, 0, sizeof(dev->bank_saturated));
+
+    uint8_t id = 0;
+    ESP_RETURN_ON_ERROR(as7341_read_regs(dev, AS7341_REG_ID, &id, 1), TAG, "id read failed");
+    ESP_RETURN_ON_FALSE((id & AS7341_ID_MASK) == AS7341_ID, ESP_ERR_NOT_FOUND, TAG, "unexpected id 0x%02x", id);
+
+    ESP_RETURN_ON_ERROR(as7341_write_reg(dev, AS7341_REG_ENABLE, AS7341_PON), TAG, "power on failed");
+    ESP_RETURN_ON_ERROR(as7341_write_reg(dev, AS7341_REG_ATIME, config->atime), TAG, "atime failed");
+    const uint8_t astep[2] = {config->astep & 0xFF, config->astep >> 8};
+    ESP_RETURN_ON_ERROR(as7341_write_regs(dev, AS7341_REG_ASTEP_L, astep, sizeof(astep)), TAG, "astep failed");
+    ESP_RETURN_ON_ERROR(as7341_write_reg(dev, AS7341_REG_CFG1, config->gain), TAG, "gain failed");
+    ESP_RETURN_ON_ERROR(as7341_route(dev, AS7341_BANK_F1_F4), TAG, "smux route failed");
+
+    // Only here is routing waited for; afterwards a sweep's worth of time covers it
+    uint8_t enable = AS7341_SMUXEN;
+    for (int i = 0; i < AS7341_SMUX_POLLS && (enable & AS7341_SMUXEN); ++i) {
+        vTaskDelay(pdMS_TO_TICKS(1));
+        ESP_RETURN_ON_ERROR(as7341_read_regs(dev, AS7341_REG_ENABLE, &enable, 1), TAG, "enable read failed");
+    }
+    ESP_RETURN_ON_FALSE(!(enable & AS7341_SMUXEN), ESP_ERR_TIMEOUT, TAG, "smux did not complete");
+
+    dev->initialized = true;
+    return ESP_OK;
+}
+
+uint32_t as7341_measurement_ms(const as7341_t *dev)
+{
+    if (!dev) {
+        return 0;
+    }
+    // 2.78 µs per step
+    uint64_t us = (uint64_t)(dev->config.atime + 1) * (dev->config.astep + 1) * 278 / 100;
+    return (uint32_t)((us + 999) / 1000) + AS7341_STARTUP_MS;
+}
+
+esp_err_t as7341_start(as7341_t *dev)
+{
+    ESP_RETURN_ON_FALSE(dev, ESP_ERR_INVALID_ARG, TAG, "dev null");
+    ESP_RETURN_ON_FALSE(dev->initialized, ESP_ERR_INVALID_STATE, TAG, "not initialized");
+
+    uint8_t enable = 0;
+    ESP_RETURN_ON_ERROR(as7341_read_regs(dev, AS7341_REG_ENABLE, &enable, 1), TAG, "enable read failed");
+    if (enable & AS7341_SMUXEN) {
+        return ESP_ERR_NOT_FINISHED;
+    }
+    return as7341_write_reg(dev, AS7341_REG_ENABLE, AS7341_PON | AS7341_SP_EN);
+}
+
+esp_err_t as7341_read(as7341_t *dev, as7341_bank_t *bank)
+{
+    ESP_RETURN_ON_FALSE(dev, ESP_ERR_INVALID_ARG, TAG, "dev null");
+    ESP_RETURN_ON_FALSE(dev->initialized, ESP_ERR_INVALID_STATE, TAG, "not initialized");
+
+    uint8_t status2 = 0;
+    ESP_RETURN_ON_ERROR(as7341_read_regs(dev, AS7341_REG_STATUS2, &status2, 1), TAG, "status read failed");
+    if (!(status2 & AS7341_AVALID)) {
+        return ESP_ERR_NOT_FINISHED;
+    }
+    uint8_t data[AS7341_DATA_LEN];
+    ESP_RETURN_ON_ERROR(as7341_read_regs(dev, AS7341_REG_ASTATUS, data, sizeof(data)), TAG, "data read failed");
+
+    uint16_t ch[6];
+    for (int i = 0; i < 6; ++i) {
+        ch[i] = (uint16_t)(data[1 + 2 * i] | data[2 + 2 * i] << 8);
+    }
+    as7341_spectrum_t *s = &dev->spectrum;
+    as7341_bank_t read_bank = dev->bank;
+    memcpy(&s->f[read_bank == AS7341_BANK_F1_F4 ? 0 : 4], ch, 4 * sizeof(ch[0]));
+    s->clear = ch[4];
+    s->nir = ch[5];
+    dev->bank_saturated[read_bank] = (data[0] & AS7341_ASAT) != 0;
+    s->saturated = dev->bank_saturated[0] || dev->bank_saturated[1];
+    s->fresh |= 1 << read_bank;
+    if (bank) {
+        *bank = read_bank;
+    }
+
+    return as7341_route(dev, read_bank == AS7341_BANK_F1_F4 ? AS7341_BANK_F5_F8 : AS7341_BANK_F1_F4);
+}
+
+void as7341_get_spectrum(const as7341_t *dev, as7341_spectrum_t *spectrum)
+{
+    if (dev && spectrum) {
+        *spectrum = dev->spectrum;
+    }
+}
+
+esp_err_t as7341_deinit(as7341_t *dev)
+{
+    ESP_RETURN_ON_FALSE(dev, ESP_ERR_INVALID_ARG, TAG, "dev null");
+    if (!dev->initialized) {
+        return ESP_OK;
+    }
+    as7341_write_reg(dev, AS7341_REG_ENABLE, 0);
+    // Remove device from bus if it was added
+    if (dev->i2c_dev != NULL) {
+        i2c_master_bus_rm_device(dev->i2c_dev);
+        dev->i2c_dev = NULL;
+    }
+    dev->initialized = false;
+    return ESP_OK;
+}
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "driver/i2c_master.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BME68X_ADDR_LOW              0x76   // SDO low
+#define BME68X_ADDR_HIGH             0x77   // SDO high
+#define BME68X_I2C_TIMEOUT_MS        100
+#define BME68X_CALIB_LEN             42
+#define BME68X_MAX_HEATER_STEPS      10
+// Data fields the part buffers; parallel mode cycles through them
+#define BME68X_FIELD_COUNT           3
+
+typedef enum {
+    BME68X_OS_NONE = 0,               ///< Channel skipped
+    BME68X_OS_X1,
+    BME68X_OS_X2,
+    BME68X_OS_X4,
+    BME68X_OS_X8,
+    BME68X_OS_X16,
+} bme68x_os_t;
+
+typedef enum {
+    BME68X_VARIANT_GAS_LOW = 0,       ///< BME680
+    BME68X_VARIANT_GAS_HIGH = 1,      ///< BME688
+} bme68x_variant_t;
+
+typedef struct {
+    uint16_t temp_c;                  ///< Heater target, 200..400 °C
+    /**
+     * Forced mode: hold time in ms (up to 4032).
+     * Parallel mode: multiple of shared_heater_ms, 1..255.
+     */
+    uint16_t duration;
+} bme68x_heater_step_t;
+
+typedef struct {
+    bme68x_os_t os_temp;
+    bme68x_os_t os_pres;
+    bme68x_os_t os_hum;
+    uint8_t filter;                   ///< IIR filter coefficient code, 0 (off) to 7
+    bme68x_heater_step_t heater[BME68X_MAX_HEATER_STEPS];
+    uint8_t heater_steps;             ///< 0 measures without the gas channel
+    float ambient_c;                  ///< For the heater resistance until a reading replaces it
+    /**
+     * Run the whole heater profile continuously in the part (BME688 only);
+     * a BME680 falls back to forced mode, one step per measurement.
+     */
+    bool parallel;
+    uint16_t shared_heater_ms;        ///< Parallel mode: heater time one duration unit stands for, up to 1923 ms
+} bme68x_config_t;
+
+/**
+ * @brief Trimming from the part's NVM, as read; callers may keep it
+ *        (e.g. in NVS) and hand it back to skip the read on the next init.
+ */
+typedef struct {
+    uint8_t raw[BME68X_CALIB_LEN];
+} bme68x_calib_t;
+
+typedef struct {
+    uint16_t t1, p1;
+    int16_t t2, p2, p4, p5, p8, p9;
+    int8_t t3, p3, p6, p7;
+    uint8_t p10;
+    uint16_t h1, h2;
+    int8_t h3, h4, h5, h7;
+    uint8_t h6;
+    int8_t gh1, gh3;
+    int16_t gh2;
+    uint8_t res_heat_range;
+    int8_t res_heat_val;
+    int8_t range_sw_err;
+} bme68x_coeffs_t;
+
+typedef struct {
+    bme68x_config_t config;
+    bme68x_calib_t calib;
+    bme68x_coeffs_t coeffs;
+    bme68x_variant_t variant;
+    bool parallel;                    ///< Parallel mode in effect
+    bool running;                     ///< Parallel mode started
+    uint8_t step;                     ///< Forced mode: heater step of the next measurement
+    uint8_t last_meas_index;          ///< Parallel mode: newest field returned so far
+    bool have_meas_index;
+    float ambient_c;
+    bool initialized;
+    i2c_master_dev_handle_t i2c_dev;
+} bme68x_t;
+
+typedef struct {
+    float temperature_c;
+    float humidity_rh;
+    float pressure_pa;
+    float gas_ohm;                    ///< NAN unless gas_valid and heat_stable
+    uint8_t gas_index;                ///< Heater step the gas reading was taken at
+    bool gas_valid;
+    bool heat_stable;
+} bme68x_sample_t;
+
+/**
+ * @brief Reset the part, check its ID and variant, load the trimming and
+ *        program oversampling and filter.
+ *
+ * dev->i2c_dev must already be on the bus. The driver borrows it until
+ * bme68x_deinit(), which puts the part to sleep and removes it.
+ *
+ * @param calib Trimming kept from an earlier bme68x_get_calib(), or NULL to
+ *              read it from the part
+ */
+esp_err_t bme68x_init(bme68x_t *dev, const bme68x_config_t *config, const bme68x_calib_t *calib);
+
+void bme68x_get_calib(const bme68x_t *dev, bme68x_calib_t *calib);
+
+/**
+ * @brief Time from bme68x_start() until bme68x_read() has a result.
+ *
+ * Forced mode: conversion plus the longest heater step. Parallel mode: 0,
+ * since the part keeps its fields filled between reads.
+ */
+uint32_t bme68x_measurement_ms(const bme68x_t *dev);
+
+/**
+ * @brief Forced mode: trigger one measurement at the next heater step.
+ *        Parallel mode: start the profile once; later calls do nothing.
+ */
+esp_err_t bme68x_start(bme68x_t *dev);
+
+/**
+ * @brief Results that are new since the last read, oldest first.
+ *
+ * Forced mode yields at most one; parallel mode up to BME68X_FIELD_COUNT,
+ * so read at least once per three heater steps to lose none.
+ */
+esp_err_t bme68x_read(bme68x_t *dev, bme68x_sample_t *samples, size_t max_samples, size_t *count);
+
+esp_err_t bme68x_deinit(bme68x_t *dev);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,462 @@
+#include "bme68x.h"
+
+#include <math.h>
+#include <string.h>
+#include "esp_check.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+static const char *TAG = "bme68x";
+
+#define BME68X_REG_FIELD0            0x1D
+#define BME68X_REG_RES_HEAT0         0x5A
+#define BME68X_REG_GAS_WAIT0         0x64
+#define BME68X_REG_GAS_WAIT_SHARED   0x6E
+#define BME68X_REG_CTRL_GAS0         0x70
+#define BME68X_REG_CTRL_GAS1         0x71
+#define BME68X_REG_CTRL_HUM          0x72
+#define BME68X_REG_CTRL_MEAS         0x74
+#define BME68X_REG_CONFIG            0x75
+#define BME68X_REG_COEFF3            0x00
+#define BME68X_REG_COEFF1            0x8A
+#define BME68X_REG_CHIP_ID           0xD0
+#define BME68X_REG_SOFT_RESET        0xE0
+#define BME68X_REG_COEFF2            0xE1
+#define BME68X_REG_VARIANT_ID        0xF0
+
+#define BME68X_CHIP_ID               0x61
+#define BME68X_CMD_SOFT_RESET        0xB6
+#define BME68X_RESET_DELAY_MS        10
+#define BME68X_COEFF1_LEN            23
+#define BME68X_COEFF2_LEN            14
+#define BME68X_COEFF3_LEN            5
+#define BME68X_FIELD_LEN             17
+
+#define BME68X_MODE_SLEEP            0x00
+#define BME68X_MODE_FORCED           0x01
+#define BME68X_MODE_PARALLEL         0x02
+#define BME68X_HEAT_OFF              (1 << 3)
+// CTRL_GAS_1: run_gas in bits 4-5 (a different bit per variant), heater step count in 0-3
+#define BME68X_RUN_GAS_LOW           (1 << 4)
+#define BME68X_RUN_GAS_HIGH          (2 << 4)
+
+// Field status bytes
+#define BME68X_NEW_DATA              (1 << 7)
+#define BME68X_GAS_INDEX_MASK        0x0F
+#define BME68X_GAS_VALID             (1 << 5)
+#define BME68X_HEAT_STAB             (1 << 4)
+#define BME68X_GAS_RANGE_MASK        0x0F
+
+#define BME68X_MAX_HEATER_C          400
+#define BME68X_MAX_FORCED_WAIT_MS    0xFC0
+#define BME68X_MAX_SHARED_WAIT_MS    0x783
+
+// test_bme68x.c replaces this to serve the registers and trimming blocks from memory
+__attribute__((weak)) esp_err_t bme68x_i2c_transfer(i2c_master_dev_handle_t i2c_dev,
+                                                    const uint8_t *write_buf,
+                                                    size_t write_size,
+                                                    uint8_t *read_buf,
+                                                    size_t read_size,
+                                                    int timeout_ms)
+{
+    if (read_size == 0) {
+        return i2c_master_transmit(i2c_dev, write_buf, write_size, timeout_ms);
+    }
+    return i2c_master_transmit_receive(i2c_dev, write_buf, write_size, read_buf, read_size, timeout_ms);
+}
+
+// Writes go as register/value pairs, any number in one transfer
+static esp_err_t bme68x_write_regs(bme68x_t *dev, const uint8_t *pairs, size_t len)
+{
+    if (dev->i2c_dev == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    return bme68x_i2c_transfer(dev->i2c_dev, pairs, len, NULL, 0, BME68X_I2C_TIMEOUT_MS);
+}
+
+static esp_err_t bme68x_write_reg(bme68x_t *dev, uint8_t reg, uint8_t value)
+{
+    uint8_t buf[2] = {reg, value};
+    return bme68x_write_regs(dev, buf, sizeof(buf));
+}
+
+static esp_err_t bme68x_read_regs(bme68x_t *dev, uint8_t reg, uint8_t *data, size_t len)
+{
+    if (dev->i2c_dev == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    return bme68x_i2c_transfer(dev->i2c_dev, &reg, 1, data, len, BME68X_I2C_TIMEOUT_MS);
+}
+
+// Offsets into bme68x_calib_t.raw: COEFF1 (0x8A, 23 bytes), COEFF2 (0xE1, 14), COEFF3 (0x00, 5)
+static void bme68x_parse_calib(const uint8_t *c, bme68x_coeffs_t *k)
+{
+    k->t1 = (uint16_t)(c[32] << 8 | c[31]);
+    k->t2 = (int16_t)(c[1] << 8 | c[0]);
+    k->t3 = (int8_t)c[2];
+    k->p1 = (uint16_t)(c[5] << 8 | c[4]);
+    k->p2 = (int16_t)(c[7] << 8 | c[6]);
+    k->p3 = (int8_t)c[8];
+    k->p4 = (int16_t)(c[11] << 8 | c[10]);
+    k->p5 = (int16_t)(c[13] << 8 | c[12]);
+    k->p6 = (int8_t)c[15];
+    k->p7 = (int8_t)c[14];
+    k->p8 = (int16_t)(c[19] << 8 | c[18]);
+    k->p9 = (int16_t)(c[21] << 8 | c[20]);
+    k->p10 = c[22];
+    // H1 and H2 share a byte, each taking one nibble of it
+    k->h1 = (uint16_t)(c[25] << 4 | (c[24] & 0x0F));
+    k->h2 = (uint16_t)(c[23] << 4 | c[24] >> 4);
+    k->h3 = (int8_t)c[26];
+    k->h4 = (int8_t)c[27];
+    k->h5 = (int8_t)c[28];
+    k->h6 = c[29];
+    k->h7 = (int8_t)c[30];
+    k->gh1 = (int8_t)c[35];
+    k->gh2 = (int16_t)(c[34] << 8 | c[33]);
+    k->gh3 = (int8_t)c[36];
+    k->res_heat_val = (int8_t)c[37];
+    k->res_heat_range = (c[39] & 0x30) >> 4;
+    k->range_sw_err = (int8_t)((int8_t)c[41] >> 4);
+}
+
+static esp_err_t bme68x_read_calib(bme68x_t *dev)
+{
+    uint8_t *raw = dev->calib.raw;
+    ESP_RETURN_ON_ERROR(bme68x_read_regs(dev, BME68X_REG_COEFF1, raw, BME68X_COEFF1_LEN), TAG, "coeff1");
+    ESP_RETURN_ON_ERROR(bme68x_read_regs(dev, BME68X_REG_COEFF2, raw + BME68X_COEFF1_LEN, BME68X_COEFF2_LEN), TAG,
+                        "coeff2");
+    return bme68x_read_regs(dev, BME68X_REG_COEFF3, raw + BME68X_COEFF1_LEN + BME68X_COEFF2_LEN,
+                            BME68X_COEFF3_LEN);
+}
+
+// Register code for a heater target at the current ambient temperature
+static uint8_t bme68x_res_heat(const bme68x_t *dev, uint16_t temp_c)
+{
+    const bme68x_coeffs_t *k = &dev->coeffs;
+    float target = temp_c > BME68X_MAX_HEATER_C ? BME68X_MAX_HEATER_C : temp_c;
+    float var1 = ((float)k->gh1 / 16.0f) + 49.0f;
+    float var2 = (((float)k->gh2 / 32768.0f) * 0.0005f) + 0.00235f;
+    float var3 = (float)k->gh3 / 1024.0f;
+    float var4 = var1 * (1.0f + (var2 * target));
+    float var5 = var4 + (var3 * dev->ambient_c);
+    float res = 3.4f * ((var5 * (4.0f / (4.0f + (float)k->res_heat_range)) *
+                         (1.0f / (1.0f + ((float)k->res_heat_val * 0.002f)))) - 25.0f);
+    return res <= 0.0f ? 0 : res >= 255.0f ? 255 : (uint8_t)res;
+}
+
+// Six bits of duration and a two-bit multiplier of 1, 4, 16 or 64
+static uint8_t bme68x_encode_wait(uint32_t ticks)
+{
+    uint8_t factor = 0;
+    while (ticks > 0x3F) {
+        ticks /= 4;
+        factor++;
+    }
+    return (uint8_t)(ticks + factor * 64);
+}
+
+static uint8_t bme68x_gas_wait(uint16_t ms)
+{
+    return ms >= BME68X_MAX_FORCED_WAIT_MS ? 0xFF : bme68x_encode_wait(ms);
+}
+
+// Shared heater time counts in 477 µs ticks
+static uint8_t bme68x_shared_wait(uint16_t ms)
+{
+    return ms >= BME68X_MAX_SHARED_WAIT_MS ? 0xFF : bme68x_encode_wait((uint32_t)ms * 1000 / 477);
+}
+
+// Temperature, pressure and humidity conversion in µs
+static uint32_t bme68x_tph_us(const bme68x_t *dev)
+{
+    static const uint8_t cycles[] = {0, 1, 2, 4, 8, 16};
+    const bme68x_config_t *cfg = &dev->config;
+    uint32_t us = (cycles[cfg->os_temp] + cycles[cfg->os_pres] + cycles[cfg->os_hum]) * 1963u;
+    us += 477 * 4;                    // Switching between channels
+    us += 477 * 5;                    // Gas conversion
+    if (!dev->parallel) {
+        us += 1000;                   // Wake from sleep
+    }
+    return us;
+}
+
+static float bme68x_gas_low(const bme68x_t *dev, uint16_t adc, uint8_t range)
+{
+    static const float k1[16] = {0, 0, 0, 0, 0, -1, 0, -0.8f, 0, 0, -0.2f, -0.5f, 0, -1, 0, 0};
+    static const float k2[16] = {0, 0, 0, 0, 0.1f, 0.7f, 0, -0.8f, -0.1f, 0, 0, 0, 0, 0, 0, 0};
+    float var1 = 1340.0f + (5.0f * dev->coeffs.range_sw_err);
+    float var2 = var1 * (1.0f + k1[range] / 100.0f);
+    float var3 = 1.0f + (k2[range] / 100.0f);
+    return 1.0f / (var3 * 0.000000125f * (float)(1u << range) * ((((float)adc - 512.0f) / var2) + 1.0f));
+}
+
+static float bme68x_gas_high(uint16_t adc, uint8_t range)
+{
+    float var1 = (float)(262144u >> range);
+    float var2 = 4096.0f + ((float)adc - 512.0f) * 3.0f;
+    return 1000000.0f * var1 / var2;
+}
+
+// Bosch's floating-point compensation, from one 17-byte data field
+static void bme68x_decode(bme68x_t *dev, const uint8_t *f, bme68x_sample_t *sample)
+{
+    const bme68x_coeffs_t *k = &dev->coeffs;
+    uint32_t adc_p = (uint32_t)f[2] << 12 | (uint32_t)f[3] << 4 | f[4] >> 4;
+    uint32_t adc_t = (uint32_t)f[5] << 12 | (uint32_t)f[6] << 4 | f[7] >> 4;
+    uint16_t adc_h = (uint16_t)(f[8] << 8 | f[9]);
+
+    float var1 = (((float)adc_t / 16384.0f) - ((float)k->t1 / 1024.0f)) * (float)k->t2;
+    float var2 = (((float)adc_t / 131072.0f) - ((float)k->t1 / 8192.0f));
+    var2 = var2 * var2 * ((float)k->t3 * 16.0f);
+    float t_fine = var1 + var2;
+    float temp = t_fine / 5120.0f;
+    sample->temperature_c = temp;
+
+    var1 = (t_fine / 2.0f) - 64000.0f;
+    var2 = var1 * var1 * ((float)k->p6 / 131072.0f);
+    var2 = var2 + (var1 * (float)k->p5 * 2.0f);
+    var2 = (var2 / 4.0f) + ((float)k->p4 * 65536.0f);
+    var1 = ((((float)k->p3 * var1 * var1) / 16384.0f) + ((float)k->p2 * var1)) / 524288.0f;
+    var1 = (1.0f + (var1 / 32768.0f)) * (float)k->p1;
+    float pres = 1048576.0f - (float)adc_p;
+    if ((int)var1 != 0) {
+        pres = ((pres - (var2 / 4096.0f)) * 6250.0f) / var1;
+        var1 = ((float)k->p9 * pres * pres) / 2147483648.0f;
+        var2 = pres * ((float)k->p8 / 32768.0f);
+        float var3 = (pres / 256.0f) * (pres / 256.0f) * (pres / 256.0f) * ((float)k->p10 / 131072.0f);
+        pres = pres + (var1 + var2 + var3 + ((float)k->p7 * 128.0f)) / 16.0f;
+    } else {
+        pres = 0.0f;
+    }
+    sample->pressure_pa = pres;
+
+    var1 = (float)adc_h - (((float)k->h1 * 16.0f) + (((float)k->h3 / 2.0f) * temp));
+    var2 = var1 * (((float)k->h2 / 262144.0f) *
+                   (1.0f + (((float)k->h4 / 16384.0f) * temp) + (((float)k->h5 / 1048576.0f) * temp * temp)));
+    float var3 = (float)k->h6 / 16384.0f;
+    float var4 = (float)k->h7 / 2097152.0f;
+    float hum = var2 + ((var3 + (var4 * temp)) * var2 * var2);
+    sample->humidity_rh = hum > 100.0f ? 100.0f : hum < 0.0f ? 0.0f : hum;
+
+    // The BME688 reports gas in the next two registers over
+    const uint8_t *g = dev->variant == BME68X_VARIANT_GAS_HIGH ? &f[15] : &f[13];
+    uint16_t adc_g = (uint16_t)(g[0] << 2 | g[1] >> 6);
+    uint8_t range = g[1] & BME68X_GAS_RANGE_MASK;
+    sample->gas_index = f[0] & BME68X_GAS_INDEX_MASK;
+    sample->gas_valid = (g[1] & BME68X_GAS_VALID) != 0;
+    sample->heat_stable = (g[1] & BME68X_HEAT_STAB) != 0;
+    if (sample->gas_valid && sample->heat_stable) {
+        sample->gas_ohm = dev->variant == BME68X_VARIANT_GAS_HIGH ? bme68x_gas_high(adc_g, range)
+                                                                  : bme68x_gas_low(dev, adc_g, range);
+    } else {
+        sample->gas_ohm = NAN;
+    }
+    dev->ambient_c = temp;
+}
+
+static uint8_t bme68x_ctrl_meas(const bme68x_t *dev, uint8_t mode)
+{
+    return (uint8_t)((dev->config.os_temp & 0x07) << 5 | (dev->config.os_pres & 0x07) << 2 | mode);
+}
+
+// Sleep mode only: the part ignores heater writes while converting
+static esp_err_t bme68x_write_parallel_profile(bme68x_t *dev)
+{
+    const bme68x_config_t *cfg = &dev->config;
+    uint8_t pairs[4 * BME68X_MAX_HEATER_STEPS + 2];
+    size_t len = 0;
+    for (uint8_t i = 0; i < cfg->heater_steps; ++i) {
+        pairs[len++] = BME68X_REG_RES_HEAT0 + i;
+        pairs[len++] = bme68x_res_heat(dev, cfg->heater[i].temp_c);
+        pairs[len++] = BME68X_REG_GAS_WAIT0 + i;
+        pairs[len++] = cfg->heater[i].duration > 0xFF ? 0xFF : (uint8_t)cfg->heater[i].duration;
+    }
+    pairs[len++] = BME68X_REG_GAS_WAIT_SHARED;
+    pairs[len++] = bme68x_shared_wait(cfg->shared_heater_ms);
+    return bme68x_write_regs(dev, pairs, len);
+}
+
+esp_err_t bme68x_init(bme68x_t *dev, const bme68x_config_t *config, const bme68x_calib_t *calib)
+{
+    ESP_RETURN_ON_FALSE(dev && config, ESP_ERR_INVALID_ARG, TAG, "invalid arguments");
+    ESP_RETURN_ON_FALSE(config->os_temp <= BME68X_OS_X16 && config->os_pres <= BME68X_OS_X16 &&
+                        config->os_hum <= BME68X_OS_X16 && config->filter <= 7 &&
+                        config->heater_steps <= BME68X_MAX_HEATER_STEPS, ESP_ERR_INVALID_ARG, TAG,
+                        "invalid config");
+    memcpy(&dev->config, config, sizeof(bme68x_config_t));
+    dev->initialized = false;
+    dev->running = false;
+    dev->step = 0;
+    dev->have_meas_index = false;
+    dev->ambient_c = config->ambient_c;
+
+    ESP_RETURN_ON_ERROR(bme68x_write_reg(dev, BME68X_REG_SOFT_RESET, BME68X_CMD_SOFT_RESET), TAG,
+                        "soft reset failed");
+    vTaskDelay(pdMS_TO_TICKS(BME68X_RESET_DELAY_MS));
+
+    uint8_t chip_id = 0;
+    ESP_RETURN_ON_ERROR(bme68x_read_regs(dev, BME68X_REG_CHIP_ID, &chip_id, 1), TAG, "chip id read failed");
+    ESP_RETURN_ON_FALSE(chip_id == BME68X_CHIP_ID, ESP_ERR_NOT_FOUND, TAG, "unexpected chip id 0x%02x", chip_id);
+    uint8_t variant = 0;
+    ESP_RETURN_ON_ERROR(bme68x_read_regs(dev, BME68X_REG_VARIANT_ID, &variant, 1), TAG, "variant read failed");
+    dev->variant = variant == BME68X_VARIANT_GAS_HIGH ? BME68X_VARIANT_GAS_HIGH : BME68X_VARIANT_GAS_LOW;
+
+    if (calib) {
+        memcpy(&dev->calib, calib, sizeof(bme68x_calib_t));
+    } else {
+        ESP_RETURN_ON_ERROR(bme68x_read_calib(dev), TAG, "calibration read failed");
+    }
+    bme68x_parse_calib(dev->calib.raw, &dev->coeffs);
+
+    dev->parallel = config->parallel && config->heater_steps > 0 && dev->variant == BME68X_VARIANT_GAS_HIGH;
+    if (config->parallel && !dev->parallel) {
+        ESP_LOGW(TAG, "Parallel mode needs a BME688 and a heater profile; using forced mode");
+    }
+
+    // The reset left the part asleep, where all of these take effect
+    uint8_t run_gas = 0;
+    if (config->heater_steps > 0) {
+        run_gas = dev->variant == BME68X_VARIANT_GAS_HIGH ? BME68X_RUN_GAS_HIGH : BME68X_RUN_GAS_LOW;
+    }
+    const uint8_t setup[] = {
+        BME68X_REG_CTRL_GAS0, config->heater_steps > 0 ? 0 : BME68X_HEAT_OFF,
+        BME68X_REG_CTRL_GAS1, (uint8_t)(run_gas | (dev->parallel ? config->heater_steps : 0)),
+        BME68X_REG_CTRL_HUM, (uint8_t)(config->os_hum & 0x07),
+        BME68X_REG_CONFIG, (uint8_t)((config->filter & 0x07) << 2),
+        BME68X_REG_CTRL_MEAS, bme68x_ctrl_meas(dev, BME68X_MODE_SLEEP),
+    };
+    ESP_RETURN_ON_ERROR(bme68x_write_regs(dev, setup, sizeof(setup)), TAG, "config write failed");
+    if (dev->parallel) {
+        ESP_RETURN_ON_ERROR(bme68x_write_parallel_profile(dev), TAG, "heater profile write failed");
+    }
+
+    dev->initialized = true;
+    return ESP_OK;
+}
+
+void bme68x_get_calib(const bme68x_t *dev, bme68x_calib_t *calib)
+{
+    if (dev && calib) {
+        memcpy(calib, &dev->calib, sizeof(bme68x_calib_t));
+    }
+}
+
+uint32_t bme68x_measurement_ms(const bme68x_t *dev)
+{
+    if (!dev || dev->parallel) {
+        return 0;
+    }
+    uint32_t heater_ms = 0;
+    for (uint8_t i = 0; i < dev->config.heater_steps; ++i) {
+        if (dev->config.heater[i].duration > heater_ms) {
+            heater_ms = dev->config.heater[i].duration;
+        }
+    }
+    return (bme68x_tph_us(dev) + 999) / 1000 + heater_ms;
+}
+
+esp_err_t bme68x_start(bme68x_t *dev)
+{
+    ESP_RETURN_ON_FALSE(dev, ESP_ERR_INVALID_ARG, TAG, "dev null");
+    ESP_RETURN_ON_FALSE(dev->initialized, ESP_ERR_INVALID_STATE, TAG, "not initialized");
+
+    if (dev->parallel) {
+        if (dev->running) {
+            return ESP_OK;
+        }
+        ESP_RETURN_ON_ERROR(bme68x_write_reg(dev, BME68X_REG_CTRL_MEAS, bme68x_ctrl_meas(dev, BME68X_MODE_PARALLEL)),
+                            TAG, "mode write failed");
+        dev->running = true;
+        return ESP_OK;
+    }
+
+    // Forced mode: the heater step goes in slot 0, and the part sleeps again when done
+    uint8_t pairs[6];
+    size_t len = 0;
+    if (dev->config.heater_steps > 0) {
+        const bme68x_heater_step_t *step = &dev->config.heater[dev->step];
+        pairs[len++] = BME68X_REG_RES_HEAT0;
+        pairs[len++] = bme68x_res_heat(dev, step->temp_c);
+        pairs[len++] = BME68X_REG_GAS_WAIT0;
+        pairs[len++] = bme68x_gas_wait(step->duration);
+    }
+    pairs[len++] = BME68X_REG_CTRL_MEAS;
+    pairs[len++] = bme68x_ctrl_meas(dev, BME68X_MODE_FORCED);
+    return bme68x_write_regs(dev, pairs, len);
+}
+
+esp_err_t bme68x_read(bme68x_t *dev, bme68x_sample_t *samples, size_t max_samples, size_t *count)
+{
+    ESP_RETURN_ON_FALSE(dev && count && (samples || max_samples == 0), ESP_ERR_INVALID_ARG, TAG,
+                        "invalid argument");
+    ESP_RETURN_ON_FALSE(dev->initialized, ESP_ERR_INVALID_STATE, TAG, "not initialized");
+    *count = 0;
+
+    if (!dev->parallel) {
+        uint8_t field[BME68X_FIELD_LEN];
+        ESP_RETURN_ON_ERROR(bme68x_read_regs(dev, BME68X_REG_FIELD0, field, sizeof(field)), TAG,
+                            "field read failed");
+        if (!(field[0] & BME68X_NEW_DATA) || max_samples == 0) {
+            return ESP_OK;
+        }
+        bme68x_decode(dev, field, &samples[0]);
+        // The gas index reads back as slot 0; report the profile step it ran
+        samples[0].gas_index = dev->step;
+        if (dev->config.heater_steps > 0) {
+            dev->step = (uint8_t)((dev->step + 1) % dev->config.heater_steps);
+        }
+        *count = 1;
+        return ESP_OK;
+    }
+
+    // The three fields sit back to back; one burst reads them all
+    uint8_t fields[BME68X_FIELD_COUNT][BME68X_FIELD_LEN];
+    ESP_RETURN_ON_ERROR(bme68x_read_regs(dev, BME68X_REG_FIELD0, &fields[0][0], sizeof(fields)), TAG,
+                        "field read failed");
+    // Sub-measurement indices count up across fields; keep new ones, oldest first
+    uint8_t order[BME68X_FIELD_COUNT];
+    size_t n = 0;
+    for (uint8_t i = 0; i < BME68X_FIELD_COUNT; ++i) {
+        if (!(fields[i][0] & BME68X_NEW_DATA)) {
+            continue;
+        }
+        if (dev->have_meas_index && (int8_t)(fields[i][1] - dev->last_meas_index) <= 0) {
+            continue;
+        }
+        size_t j = n++;
+        while (j > 0 && (int8_t)(fields[order[j - 1]][1] - fields[i][1]) > 0) {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = i;
+    }
+    if (n > max_samples) {
+        n = max_samples;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        bme68x_decode(dev, fields[order[i]], &samples[i]);
+        dev->last_meas_index = fields[order[i]][1];
+        dev->have_meas_index = true;
+    }
+    *count = n;
+    return ESP_OK;
+}
+
+esp_err_t bme68x_deinit(bme68x_t *dev)
+{
+    ESP_RETURN_ON_FALSE(dev, ESP_ERR_INVALID_ARG, TAG, "dev null");
+    if (!dev->initialized) {
+        return ESP_OK;
+    }
+    bme68x_write_reg(dev, BME68X_REG_CTRL_MEAS, bme68x_ctrl_meas(dev, BME68X_MODE_SLEEP));
+    // Remove device from bus if it was added
+    if (dev->i2c_dev != NULL) {
+        i2c_master_bus_rm_device(dev->i2c_dev);
+        dev->i2c_dev = NULL;
+    }
+    dev->initialized = false;
+    dev->running = false;
+    return ESP_OK;
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "driver/i2c_master.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BMP581_DEFAULT_ADDR          0x47   // SDO high; 0x46 with SDO low
+#define BMP581_I2C_TIMEOUT_MS        100
+// FIFO depth with pressure and temperature in every frame
+#define BMP581_FIFO_CAPACITY         16
+#define BMP581_FIFO_FRAME_BYTES      6
+
+// Bits returned by bmp581_read_int_status() and taken by bmp581_enable_interrupt()
+#define BMP581_INT_DATA_READY        (1 << 0)
+#define BMP581_INT_FIFO_FULL         (1 << 1)
+#define BMP581_INT_FIFO_THRESHOLD    (1 << 2)
+
+// Output data rate codes of ODR_CONFIG; a subset of the 32 the part offers
+typedef enum {
+    BMP581_ODR_240_HZ = 0x00,
+    BMP581_ODR_160_HZ = 0x04,
+    BMP581_ODR_100_HZ = 0x0A,
+    BMP581_ODR_50_HZ = 0x0F,
+    BMP581_ODR_25_HZ = 0x14,
+    BMP581_ODR_10_HZ = 0x17,
+    BMP581_ODR_5_HZ = 0x18,
+    BMP581_ODR_1_HZ = 0x1C,
+} bmp581_odr_t;
+
+typedef enum {
+    BMP581_OSR_X1 = 0,
+    BMP581_OSR_X2,
+    BMP581_OSR_X4,
+    BMP581_OSR_X8,
+    BMP581_OSR_X16,
+    BMP581_OSR_X32,
+    BMP581_OSR_X64,
+    BMP581_OSR_X128
+} bmp581_osr_t;
+
+typedef struct {
+    bmp581_odr_t odr;
+    bmp581_osr_t osr_pressure;     ///< Must leave room for the ODR; x8 fits up to 100 Hz
+    bmp581_osr_t osr_temperature;
+    uint8_t fifo_threshold;        ///< Frames that raise BMP581_INT_FIFO_THRESHOLD, 1..15
+} bmp581_config_t;
+
+typedef struct {
+    bmp581_config_t config;
+    bool initialized;
+    i2c_master_dev_handle_t i2c_dev;
+} bmp581_t;
+
+typedef struct {
+    float pressure_pa;
+    float temperature_c;
+} bmp581_sample_t;
+
+/**
+ * @brief Reset the part, check its ID and start continuous conversions
+ *        into the FIFO at the configured rate.
+ *
+ * Add the part to the I2C bus and store the handle in dev->i2c_dev first.
+ * bmp581_deinit() takes it off the bus again.
+ */
+esp_err_t bmp581_init(bmp581_t *dev, const bmp581_config_t *config);
+
+/**
+ * @brief Latest conversion from the data registers, bypassing the FIFO.
+ */
+esp_err_t bmp581_read_sample(bmp581_t *dev, bmp581_sample_t *sample);
+
+/**
+ * @brief Drain up to max_samples frames from the FIFO in one burst read.
+ *
+ * Costs a one-byte count read and a single burst of 6 bytes per frame,
+ * however many frames are waiting. Frames beyond max_samples stay queued.
+ */
+esp_err_t bmp581_read_fifo(bmp581_t *dev, bmp581_sample_t *samples, size_t max_samples, size_t *count);
+
+/**
+ * @brief Drive INT (push-pull, active high, latched) on the given
+ *        BMP581_INT_* sources; 0 disables the pin.
+ */
+esp_err_t bmp581_enable_interrupt(bmp581_t *dev, uint8_t sources);
+
+/**
+ * @brief Read and clear the pending BMP581_INT_* bits; releases INT.
+ */
+esp_err_t bmp581_read_int_status(bmp581_t *dev, uint8_t *status);
+
+esp_err_t bmp581_deinit(bmp581_t *dev);
+
+#ifdef __cplusplus
+}
+#endif
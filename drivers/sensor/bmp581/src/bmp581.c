@@ -0,0 +1,210 @@
+#include "bmp581.h"
+
+#include <string.h>
+#include "esp_check.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+static const char *TAG = "bmp581";
+
+#define BMP581_REG_CHIP_ID           0x01
+#define BMP581_REG_INT_CONFIG        0x14
+#define BMP581_REG_INT_SOURCE        0x15
+#define BMP581_REG_FIFO_CONFIG       0x16
+#define BMP581_REG_FIFO_COUNT        0x17
+#define BMP581_REG_FIFO_SEL          0x18
+#define BMP581_REG_TEMP_DATA_XLSB    0x1D
+#define BMP581_REG_INT_STATUS        0x27
+#define BMP581_REG_STATUS            0x28
+#define BMP581_REG_FIFO_DATA         0x29
+#define BMP581_REG_OSR_CONFIG        0x36
+#define BMP581_REG_ODR_CONFIG        0x37
+#define BMP581_REG_CMD               0x7E
+
+#define BMP581_CHIP_ID               0x50
+#define BMP585_CHIP_ID               0x51
+#define BMP581_CMD_SOFT_RESET        0xB6
+#define BMP581_RESET_DELAY_MS        2
+
+#define BMP581_INT_STATUS_POR        (1 << 4)
+#define BMP581_STATUS_NVM_RDY        (1 << 1)
+#define BMP581_STATUS_NVM_ERR        (1 << 2)
+
+// INT_CONFIG: latched, active high, push-pull, enabled
+#define BMP581_INT_MODE_LATCHED      (1 << 0)
+#define BMP581_INT_POL_HIGH          (1 << 1)
+#define BMP581_INT_EN                (1 << 3)
+
+// FIFO_CONFIG threshold in bits 0-4; mode bit 5 left clear streams, dropping the oldest frame
+#define BMP581_FIFO_THRESHOLD_MASK   0x1F
+#define BMP581_FIFO_COUNT_MASK       0x3F
+// FIFO_SEL: pressure and temperature per frame, no decimation
+#define BMP581_FIFO_SEL_PRESS_TEMP   0x03
+
+#define BMP581_OSR_P_SHIFT           3
+#define BMP581_PRESS_EN              (1 << 6)
+
+// ODR_CONFIG: power mode in bits 0-1, rate in 2-6; deep standby disabled
+#define BMP581_PWR_MODE_STANDBY      0x00
+#define BMP581_PWR_MODE_NORMAL       0x01
+#define BMP581_ODR_SHIFT             2
+#define BMP581_DEEP_DISABLE          (1 << 7)
+
+// Weak: the unit test puts a fake FIFO behind FIFO_DATA
+__attribute__((weak)) esp_err_t bmp581_i2c_transfer(i2c_master_dev_handle_t i2c_dev,
+                                                    const uint8_t *write_buf,
+                                                    size_t write_size,
+                                                    uint8_t *read_buf,
+                                                    size_t read_size,
+                                                    int timeout_ms)
+{
+    if (read_size == 0) {
+        return i2c_master_transmit(i2c_dev, write_buf, write_size, timeout_ms);
+    }
+    return i2c_master_transmit_receive(i2c_dev, write_buf, write_size, read_buf, read_size, timeout_ms);
+}
+
+static esp_err_t bmp581_write_reg(bmp581_t *dev, uint8_t reg, uint8_t value)
+{
+    if (dev->i2c_dev == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    uint8_t buf[2] = {reg, value};
+    return bmp581_i2c_transfer(dev->i2c_dev, buf, sizeof(buf), NULL, 0, BMP581_I2C_TIMEOUT_MS);
+}
+
+// Registers auto-increment, except FIFO_DATA, which a burst keeps popping
+static esp_err_t bmp581_read_regs(bmp581_t *dev, uint8_t reg, uint8_t *data, size_t len)
+{
+    if (dev->i2c_dev == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    return bmp581_i2c_transfer(dev->i2c_dev, &reg, 1, data, len, BMP581_I2C_TIMEOUT_MS);
+}
+
+// Temperature then pressure, each 24 bits little-endian: signed 1/65536 °C, unsigned 1/64 Pa
+static void bmp581_decode(const uint8_t *data, bmp581_sample_t *sample)
+{
+    int32_t raw_t = (int32_t)(((uint32_t)data[2] << 24) | ((uint32_t)data[1] << 16) | ((uint32_t)data[0] << 8)) >> 8;
+    uint32_t raw_p = ((uint32_t)data[5] << 16) | ((uint32_t)data[4] << 8) | data[3];
+    sample->temperature_c = (float)raw_t / 65536.0f;
+    sample->pressure_pa = (float)raw_p / 64.0f;
+}
+
+esp_err_t bmp581_init(bmp581_t *dev, const bmp581_config_t *config)
+{
+    ESP_RETURN_ON_FALSE(dev && config, ESP_ERR_INVALID_ARG, TAG, "invalid arguments");
+    ESP_RETURN_ON_FALSE(config->fifo_threshold >= 1 && config->fifo_threshold < BMP581_FIFO_CAPACITY,
+                        ESP_ERR_INVALID_ARG, TAG, "fifo threshold");
+    memcpy(&dev->config, config, sizeof(bmp581_config_t));
+
+    ESP_RETURN_ON_ERROR(bmp581_write_reg(dev, BMP581_REG_CMD, BMP581_CMD_SOFT_RESET), TAG, "soft reset failed");
+    vTaskDelay(pdMS_TO_TICKS(BMP581_RESET_DELAY_MS));
+
+    uint8_t chip_id = 0;
+    ESP_RETURN_ON_ERROR(bmp581_read_regs(dev, BMP581_REG_CHIP_ID, &chip_id, 1), TAG, "chip id read failed");
+    ESP_RETURN_ON_FALSE(chip_id == BMP581_CHIP_ID || chip_id == BMP585_CHIP_ID, ESP_ERR_NOT_FOUND, TAG,
+                        "unexpected chip id 0x%02x", chip_id);
+
+    // The reset must have reloaded the trimming from NVM
+    uint8_t int_status = 0;
+    uint8_t status = 0;
+    ESP_RETURN_ON_ERROR(bmp581_read_regs(dev, BMP581_REG_INT_STATUS, &int_status, 1), TAG, "int status failed");
+    ESP_RETURN_ON_ERROR(bmp581_read_regs(dev, BMP581_REG_STATUS, &status, 1), TAG, "status read failed");
+    ESP_RETURN_ON_FALSE((int_status & BMP581_INT_STATUS_POR) && (status & BMP581_STATUS_NVM_RDY) &&
+                        !(status & BMP581_STATUS_NVM_ERR), ESP_ERR_INVALID_RESPONSE, TAG, "nvm not ready");
+
+    // FIFO and oversampling only change in standby, which the reset left us in
+    uint8_t osr = (config->osr_temperature & 0x07) | ((config->osr_pressure & 0x07) << BMP581_OSR_P_SHIFT) |
+                  BMP581_PRESS_EN;
+    ESP_RETURN_ON_ERROR(bmp581_write_reg(dev, BMP581_REG_OSR_CONFIG, osr), TAG, "osr config failed");
+    ESP_RETURN_ON_ERROR(bmp581_write_reg(dev, BMP581_REG_FIFO_SEL, BMP581_FIFO_SEL_PRESS_TEMP), TAG,
+                        "fifo select failed");
+    ESP_RETURN_ON_ERROR(bmp581_write_reg(dev, BMP581_REG_FIFO_CONFIG,
+                                         config->fifo_threshold & BMP581_FIFO_THRESHOLD_MASK), TAG,
+                        "fifo config failed");
+
+    uint8_t odr = ((config->odr & 0x1F) << BMP581_ODR_SHIFT) | BMP581_DEEP_DISABLE;
+    ESP_RETURN_ON_ERROR(bmp581_write_reg(dev, BMP581_REG_ODR_CONFIG, odr | BMP581_PWR_MODE_NORMAL), TAG,
+                        "odr config failed");
+
+    dev->initialized = true;
+    return ESP_OK;
+}
+
+esp_err_t bmp581_read_sample(bmp581_t *dev, bmp581_sample_t *sample)
+{
+    ESP_RETURN_ON_FALSE(dev && sample, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(dev->initialized, ESP_ERR_INVALID_STATE, TAG, "not initialized");
+
+    uint8_t data[BMP581_FIFO_FRAME_BYTES];
+    ESP_RETURN_ON_ERROR(bmp581_read_regs(dev, BMP581_REG_TEMP_DATA_XLSB, data, sizeof(data)), TAG,
+                        "data read failed");
+    bmp581_decode(data, sample);
+    return ESP_OK;
+}
+
+esp_err_t bmp581_read_fifo(bmp581_t *dev, bmp581_sample_t *samples, size_t max_samples, size_t *count)
+{
+    ESP_RETURN_ON_FALSE(dev && count && (samples || max_samples == 0), ESP_ERR_INVALID_ARG, TAG,
+                        "invalid argument");
+    ESP_RETURN_ON_FALSE(dev->initialized, ESP_ERR_INVALID_STATE, TAG, "not initialized");
+    *count = 0;
+
+    uint8_t frames = 0;
+    ESP_RETURN_ON_ERROR(bmp581_read_regs(dev, BMP581_REG_FIFO_COUNT, &frames, 1), TAG, "fifo count failed");
+    frames &= BMP581_FIFO_COUNT_MASK;
+    if (frames > BMP581_FIFO_CAPACITY) {
+        frames = BMP581_FIFO_CAPACITY;
+    }
+    if (frames > max_samples) {
+        frames = (uint8_t)max_samples;
+    }
+    if (frames == 0) {
+        return ESP_OK;
+    }
+
+    uint8_t data[BMP581_FIFO_CAPACITY * BMP581_FIFO_FRAME_BYTES];
+    ESP_RETURN_ON_ERROR(bmp581_read_regs(dev, BMP581_REG_FIFO_DATA, data, frames * BMP581_FIFO_FRAME_BYTES), TAG,
+                        "fifo read failed");
+    for (size_t i = 0; i < frames; ++i) {
+        bmp581_decode(&data[i * BMP581_FIFO_FRAME_BYTES], &samples[i]);
+    }
+    *count = frames;
+    return ESP_OK;
+}
+
+esp_err_t bmp581_enable_interrupt(bmp581_t *dev, uint8_t sources)
+{
+    ESP_RETURN_ON_FALSE(dev, ESP_ERR_INVALID_ARG, TAG, "dev null");
+    ESP_RETURN_ON_FALSE(dev->initialized, ESP_ERR_INVALID_STATE, TAG, "not initialized");
+
+    uint8_t mask = BMP581_INT_DATA_READY | BMP581_INT_FIFO_FULL | BMP581_INT_FIFO_THRESHOLD;
+    ESP_RETURN_ON_ERROR(bmp581_write_reg(dev, BMP581_REG_INT_SOURCE, sources & mask), TAG, "int source failed");
+    uint8_t int_config = BMP581_INT_MODE_LATCHED | BMP581_INT_POL_HIGH | (sources ? BMP581_INT_EN : 0);
+    return bmp581_write_reg(dev, BMP581_REG_INT_CONFIG, int_config);
+}
+
+esp_err_t bmp581_read_int_status(bmp581_t *dev, uint8_t *status)
+{
+    ESP_RETURN_ON_FALSE(dev && status, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(dev->initialized, ESP_ERR_INVALID_STATE, TAG, "not initialized");
+    return bmp581_read_regs(dev, BMP581_REG_INT_STATUS, status, 1);
+}
+
+esp_err_t bmp581_deinit(bmp581_t *dev)
+{
+    ESP_RETURN_ON_FALSE(dev, ESP_ERR_INVALID_ARG, TAG, "dev null");
+    if (!dev->initialized) {
+        return ESP_OK;
+    }
+    bmp581_write_reg(dev, BMP581_REG_ODR_CONFIG, BMP581_PWR_MODE_STANDBY);
+    // Remove device from bus if it was added
+    if (dev->i2c_dev != NULL) {
+        i2c_master_bus_rm_device(dev->i2c_dev);
+        dev->i2c_dev = NULL;
+    }
+    dev->initialized = false;
+    return ESP_OK;
+}
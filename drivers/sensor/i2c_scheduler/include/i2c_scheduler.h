@@ -0,0 +1,128 @@
+/**
+ * @file i2c_scheduler.h
+ * @brief Overlapped sensor conversions on one I2C master bus.
+ *
+ * Each sensor is a job: a start step that triggers a conversion, the
+ * conversion time, and a collect step that reads the result. A sweep starts
+ * every due job back to back, then collects each one as its deadline passes,
+ * earliest first. A sweep therefore takes about the longest conversion
+ * instead of the sum of them, and the calling task sleeps between transfers
+ * instead of holding the bus idle.
+ *
+ * All devices share one bus handle, so transfers are serialised by the
+ * driver in the order the sweep issues them. Built on the ESP-IDF
+ * i2c_master driver; do not mix with the legacy driver on the same port.
+ *
+ * Not thread-safe: one task owns the scheduler and runs its sweeps.
+ */
+
+#ifndef I2C_SCHEDULER_H
+#define I2C_SCHEDULER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "driver/gpio.h"
+#include "driver/i2c_master.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define I2C_SCHEDULER_MAX_JOBS 8
+#define I2C_SCHEDULER_TIMEOUT_MS 100
+
+typedef struct i2c_scheduler i2c_scheduler_t;
+typedef struct i2c_scheduler_dev i2c_scheduler_dev_t;
+
+typedef struct {
+    int port;                         ///< I2C port number
+    gpio_num_t sda_io_num;
+    gpio_num_t scl_io_num;
+    uint32_t scl_speed_hz;
+    bool enable_internal_pullup;
+} i2c_scheduler_config_t;
+
+/**
+ * @brief Start or collect step of a job; runs on the task calling the sweep.
+ */
+typedef esp_err_t (*i2c_scheduler_step_cb_t)(i2c_scheduler_dev_t *dev, void *ctx);
+
+typedef struct {
+    const char *name;                 ///< For logs
+    uint16_t address;                 ///< 7-bit device address
+    i2c_master_dev_handle_t device;   ///< Device a driver already added to the bus; NULL adds one for address
+    uint32_t conversion_ms;           ///< Minimum time from start to collect
+    uint32_t period_ms;               ///< Run at most this often; 0 runs every sweep
+    i2c_scheduler_step_cb_t start;    ///< NULL when there is nothing to trigger
+    i2c_scheduler_step_cb_t collect;
+    void *ctx;
+} i2c_scheduler_job_t;
+
+/**
+ * @brief Create the master bus the jobs will share.
+ */
+esp_err_t i2c_scheduler_new(const i2c_scheduler_config_t *config, i2c_scheduler_t **ret_sched);
+
+/**
+ * @brief Remove every device and release the bus.
+ */
+void i2c_scheduler_delete(i2c_scheduler_t *sched);
+
+/**
+ * @brief The shared bus, for drivers that add their own device handle.
+ */
+i2c_master_bus_handle_t i2c_scheduler_bus(const i2c_scheduler_t *sched);
+
+/**
+ * @brief Check that a device acknowledges its address.
+ */
+esp_err_t i2c_scheduler_probe(i2c_scheduler_t *sched, uint16_t address);
+
+/**
+ * @brief Read one register of a device that has no job yet, e.g. a chip ID.
+ */
+esp_err_t i2c_scheduler_identify(i2c_scheduler_t *sched, uint16_t address, uint8_t reg, uint8_t *value);
+
+/**
+ * @brief Add a device and its job.
+ *
+ * A device passed in the job stays owned by the caller and is not removed by
+ * i2c_scheduler_delete().
+ *
+ * @param ret_dev Optional; the device handle, usable for one-off setup such
+ *                as reading calibration data before the first sweep
+ */
+esp_err_t i2c_scheduler_add_job(i2c_scheduler_t *sched, const i2c_scheduler_job_t *job,
+                                i2c_scheduler_dev_t **ret_dev);
+
+/**
+ * @brief Run every due job once and return after the last collect.
+ *
+ * A job whose start step fails is not collected. Per-job outcomes are read
+ * with i2c_scheduler_dev_result().
+ *
+ * @param elapsed_ms Optional; wall time the sweep took
+ */
+esp_err_t i2c_scheduler_sweep(i2c_scheduler_t *sched, uint32_t *elapsed_ms);
+
+/**
+ * @brief Outcome of the device's last run: ESP_OK, the error its start or
+ *        collect step returned, or ESP_ERR_NOT_FINISHED before its first run.
+ */
+esp_err_t i2c_scheduler_dev_result(const i2c_scheduler_dev_t *dev);
+
+// Transfers for use inside job steps and for setup
+esp_err_t i2c_scheduler_write(i2c_scheduler_dev_t *dev, const uint8_t *data, size_t len);
+esp_err_t i2c_scheduler_read(i2c_scheduler_dev_t *dev, uint8_t *data, size_t len);
+esp_err_t i2c_scheduler_write_read(i2c_scheduler_dev_t *dev, const uint8_t *write_data, size_t write_len,
+                                   uint8_t *read_data, size_t read_len);
+esp_err_t i2c_scheduler_write_reg(i2c_scheduler_dev_t *dev, uint8_t reg, uint8_t value);
+esp_err_t i2c_scheduler_read_reg(i2c_scheduler_dev_t *dev, uint8_t reg, uint8_t *data, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // I2C_SCHEDULER_H
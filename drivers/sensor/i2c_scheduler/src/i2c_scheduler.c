@@ -0,0 +1,239 @@
+/**
+ * @file i2c_scheduler.c
+ */
+
+#include "i2c_scheduler.h"
+
+#include <stdlib.h>
+#include "esp_check.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+static const char *TAG = "i2c_scheduler";
+
+struct i2c_scheduler_dev {
+    i2c_master_dev_handle_t handle;
+    i2c_scheduler_job_t job;
+    int64_t last_start_us;
+    int64_t deadline_us;
+    bool owned;
+    bool pending;
+    bool ran;
+    esp_err_t result;
+};
+
+struct i2c_scheduler {
+    i2c_master_bus_handle_t bus;
+    uint32_t scl_speed_hz;
+    i2c_scheduler_dev_t devs[I2C_SCHEDULER_MAX_JOBS];
+    size_t count;
+};
+
+esp_err_t i2c_scheduler_new(const i2c_scheduler_config_t *config, i2c_scheduler_t **ret_sched)
+{
+    ESP_RETURN_ON_FALSE(config && ret_sched, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+
+    i2c_scheduler_t *sched = calloc(1, sizeof(*sched));
+    ESP_RETURN_ON_FALSE(sched, ESP_ERR_NO_MEM, TAG, "no memory for scheduler");
+
+    i2c_master_bus_config_t bus_config = {
+        .i2c_port = config->port,
+        .sda_io_num = config->sda_io_num,
+        .scl_io_num = config->scl_io_num,
+        .clk_source = I2C_CLK_SRC_DEFAULT,
+        .glitch_ignore_cnt = 7,
+        .flags = {
+            .enable_internal_pullup = config->enable_internal_pullup,
+        },
+    };
+    esp_err_t err = i2c_new_master_bus(&bus_config, &sched->bus);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create I2C bus on port %d: %s", config->port, esp_err_to_name(err));
+        free(sched);
+        return err;
+    }
+    sched->scl_speed_hz = config->scl_speed_hz ? config->scl_speed_hz : 100000;
+    *ret_sched = sched;
+    return ESP_OK;
+}
+
+void i2c_scheduler_delete(i2c_scheduler_t *sched)
+{
+    if (!sched) {
+        return;
+    }
+    for (size_t i = 0; i < sched->count; ++i) {
+        if (sched->devs[i].owned) {
+            i2c_master_bus_rm_device(sched->devs[i].handle);
+        }
+    }
+    i2c_del_master_bus(sched->bus);
+    free(sched);
+}
+
+i2c_master_bus_handle_t i2c_scheduler_bus(const i2c_scheduler_t *sched)
+{
+    return sched ? sched->bus : NULL;
+}
+
+esp_err_t i2c_scheduler_probe(i2c_scheduler_t *sched, uint16_t address)
+{
+    ESP_RETURN_ON_FALSE(sched, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    return i2c_master_probe(sched->bus, address, I2C_SCHEDULER_TIMEOUT_MS);
+}
+
+esp_err_t i2c_scheduler_identify(i2c_scheduler_t *sched, uint16_t address, uint8_t reg, uint8_t *value)
+{
+    ESP_RETURN_ON_FALSE(sched && value, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+
+    i2c_device_config_t dev_config = {
+        .dev_addr_length = I2C_ADDR_BIT_LEN_7,
+        .device_address = address,
+        .scl_speed_hz = sched->scl_speed_hz,
+    };
+    i2c_master_dev_handle_t handle;
+    ESP_RETURN_ON_ERROR(i2c_master_bus_add_device(sched->bus, &dev_config, &handle), TAG,
+                        "add device 0x%02X", address);
+    esp_err_t err = i2c_master_transmit_receive(handle, &reg, 1, value, 1, I2C_SCHEDULER_TIMEOUT_MS);
+    i2c_master_bus_rm_device(handle);
+    return err;
+}
+
+esp_err_t i2c_scheduler_add_job(i2c_scheduler_t *sched, const i2c_scheduler_job_t *job,
+                                i2c_scheduler_dev_t **ret_dev)
+{
+    ESP_RETURN_ON_FALSE(sched && job && job->collect, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(sched->count < I2C_SCHEDULER_MAX_JOBS, ESP_ERR_NO_MEM, TAG, "job table full");
+
+    i2c_scheduler_dev_t *dev = &sched->devs[sched->count];
+    dev->owned = job->device == NULL;
+    if (dev->owned) {
+        i2c_device_config_t dev_config = {
+            .dev_addr_length = I2C_ADDR_BIT_LEN_7,
+            .device_address = job->address,
+            .scl_speed_hz = sched->scl_speed_hz,
+        };
+        ESP_RETURN_ON_ERROR(i2c_master_bus_add_device(sched->bus, &dev_config, &dev->handle), TAG,
+                            "add device 0x%02X", job->address);
+    } else {
+        dev->handle = job->device;
+    }
+
+    dev->job = *job;
+    dev->pending = false;
+    dev->ran = false;
+    dev->result = ESP_ERR_NOT_FINISHED;
+    sched->count++;
+    if (ret_dev) {
+        *ret_dev = dev;
+    }
+    return ESP_OK;
+}
+
+static bool job_due(const i2c_scheduler_dev_t *dev, int64_t now_us)
+{
+    return !dev->ran || dev->job.period_ms == 0 ||
+           now_us - dev->last_start_us >= (int64_t)dev->job.period_ms * 1000;
+}
+
+// Sleep to the deadline, rounded up to a whole tick; late is safe, early is not
+static void wait_until(int64_t deadline_us)
+{
+    int64_t remaining_us = deadline_us - esp_timer_get_time();
+    if (remaining_us <= 0) {
+        return;
+    }
+    uint32_t remaining_ms = (uint32_t)((remaining_us + 999) / 1000);
+    vTaskDelay((remaining_ms + portTICK_PERIOD_MS - 1) / portTICK_PERIOD_MS);
+}
+
+esp_err_t i2c_scheduler_sweep(i2c_scheduler_t *sched, uint32_t *elapsed_ms)
+{
+    ESP_RETURN_ON_FALSE(sched, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+
+    int64_t begin_us = esp_timer_get_time();
+    size_t pending = 0;
+
+    // Trigger every due conversion first so they all run at once
+    for (size_t i = 0; i < sched->count; ++i) {
+        i2c_scheduler_dev_t *dev = &sched->devs[i];
+        int64_t now_us = esp_timer_get_time();
+        if (!job_due(dev, now_us)) {
+            continue;
+        }
+        dev->last_start_us = now_us;
+        esp_err_t err = dev->job.start ? dev->job.start(dev, dev->job.ctx) : ESP_OK;
+        if (err != ESP_OK) {
+            ESP_LOGD(TAG, "%s start failed: %s", dev->job.name, esp_err_to_name(err));
+            dev->result = err;
+            dev->ran = true;
+            continue;
+        }
+        dev->deadline_us = esp_timer_get_time() + (int64_t)dev->job.conversion_ms * 1000;
+        dev->pending = true;
+        pending++;
+    }
+
+    // Then collect in deadline order
+    while (pending > 0) {
+        i2c_scheduler_dev_t *next = NULL;
+        for (size_t i = 0; i < sched->count; ++i) {
+            i2c_scheduler_dev_t *dev = &sched->devs[i];
+            if (dev->pending && (!next || dev->deadline_us < next->deadline_us)) {
+                next = dev;
+            }
+        }
+        wait_until(next->deadline_us);
+        esp_err_t err = next->job.collect(next, next->job.ctx);
+        if (err != ESP_OK) {
+            ESP_LOGD(TAG, "%s collect failed: %s", next->job.name, esp_err_to_name(err));
+        }
+        next->result = err;
+        next->pending = false;
+        next->ran = true;
+        pending--;
+    }
+
+    if (elapsed_ms) {
+        *elapsed_ms = (uint32_t)((esp_timer_get_time() - begin_us) / 1000);
+    }
+    return ESP_OK;
+}
+
+esp_err_t i2c_scheduler_dev_result(const i2c_scheduler_dev_t *dev)
+{
+    return dev ? dev->result : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t i2c_scheduler_write(i2c_scheduler_dev_t *dev, const uint8_t *data, size_t len)
+{
+    ESP_RETURN_ON_FALSE(dev && data, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    return i2c_master_transmit(dev->handle, data, len, I2C_SCHEDULER_TIMEOUT_MS);
+}
+
+esp_err_t i2c_scheduler_read(i2c_scheduler_dev_t *dev, uint8_t *data, size_t len)
+{
+    ESP_RETURN_ON_FALSE(dev && data, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    return i2c_master_receive(dev->handle, data, len, I2C_SCHEDULER_TIMEOUT_MS);
+}
+
+esp_err_t i2c_scheduler_write_read(i2c_scheduler_dev_t *dev, const uint8_t *write_data, size_t write_len,
+                                   uint8_t *read_data, size_t read_len)
+{
+    ESP_RETURN_ON_FALSE(dev && write_data && read_data, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    return i2c_master_transmit_receive(dev->handle, write_data, write_len, read_data, read_len,
+                                       I2C_SCHEDULER_TIMEOUT_MS);
+}
+
+esp_err_t i2c_scheduler_write_reg(i2c_scheduler_dev_t *dev, uint8_t reg, uint8_t value)
+{
+    uint8_t buf[2] = {reg, value};
+    return i2c_scheduler_write(dev, buf, sizeof(buf));
+}
+
+esp_err_t i2c_scheduler_read_reg(i2c_scheduler_dev_t *dev, uint8_t reg, uint8_t *data, size_t len)
+{
+    return i2c_scheduler_write_read(dev, &reg, 1, data, len);
+}
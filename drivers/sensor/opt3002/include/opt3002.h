@@ -0,0 +1,81 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "driver/i2c_master.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Address set by the ADDR pin
+#define OPT3002_ADDR_GND             0x44
+#define OPT3002_ADDR_VDD             0x45
+#define OPT3002_ADDR_SDA             0x46
+#define OPT3002_ADDR_SCL             0x47
+#define OPT3002_I2C_TIMEOUT_MS       100
+
+// Auto-range full scale: 4095 x 2^11 x 1.2 nW/cm²
+#define OPT3002_MAX_NW_CM2           10063872.0f
+
+// Bits returned by opt3002_read_flags()
+#define OPT3002_FLAG_LOW             (1 << 0)   // Below the window's low limit
+#define OPT3002_FLAG_HIGH            (1 << 1)   // Above the window's high limit
+#define OPT3002_FLAG_READY           (1 << 2)   // A conversion finished since the last read
+#define OPT3002_FLAG_OVERFLOW        (1 << 3)
+
+typedef enum {
+    OPT3002_CONVERSION_100MS = 0,
+    OPT3002_CONVERSION_800MS = 1,   ///< Less noise in the dark
+} opt3002_conversion_time_t;
+
+typedef struct {
+    opt3002_conversion_time_t conversion_time;
+    uint8_t fault_count;            ///< Consecutive out-of-window results before INT: 1, 2, 4 or 8
+} opt3002_config_t;
+
+typedef struct {
+    opt3002_config_t config;
+    bool initialized;
+    i2c_master_dev_handle_t i2c_dev;
+    uint16_t config_reg;              // Shadow of the writable configuration bits
+} opt3002_t;
+
+/**
+ * @brief Check the manufacturer ID and start continuous auto-ranged
+ *        conversions, with INT latched, open drain and active low.
+ *
+ * The window starts wide open, so INT stays quiet until
+ * opt3002_set_window() narrows it.
+ *
+ * dev->i2c_dev is the caller's handle, attached before this call. Once
+ * init succeeds, opt3002_deinit() shuts the part down and detaches it.
+ */
+esp_err_t opt3002_init(opt3002_t *dev, const opt3002_config_t *config);
+
+/**
+ * @brief Latest result as optical power density (nW/cm²).
+ *
+ * The OPT3002 covers 300 to 1000 nm without photopic weighting, so lux
+ * depends on the light source.
+ */
+esp_err_t opt3002_read_power(opt3002_t *dev, float *nw_cm2);
+
+/**
+ * @brief Raise INT once a result leaves [low, high] (nW/cm²).
+ *
+ * Limits are rounded outward to what the registers can hold.
+ */
+esp_err_t opt3002_set_window(opt3002_t *dev, float low_nw_cm2, float high_nw_cm2);
+
+/**
+ * @brief Read the OPT3002_FLAG_* bits; clears the latched window flags and releases INT.
+ */
+esp_err_t opt3002_read_flags(opt3002_t *dev, uint8_t *flags);
+
+esp_err_t opt3002_deinit(opt3002_t *dev);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,170 @@
+#include "opt3002.h"
+
+#include <math.h>
+#include <string.h>
+#include "esp_check.h"
+#include "esp_log.h"
+
+static const char *TAG = "opt3002";
+
+// Every register is a 16-bit word, sent and read high byte first
+#define OPT3002_REG_RESULT           0x00
+#define OPT3002_REG_CONFIG           0x01
+#define OPT3002_REG_LOW_LIMIT        0x02
+#define OPT3002_REG_HIGH_LIMIT       0x03
+#define OPT3002_REG_MANUFACTURER_ID  0x7E
+
+#define OPT3002_MANUFACTURER_ID      0x5449  // "TI"
+
+// CONFIG; the low byte above bit 4 is read-only status
+#define OPT3002_CFG_RANGE_AUTO       (0x0C << 12)
+#define OPT3002_CFG_CT_SHIFT         11
+#define OPT3002_CFG_MODE_SHUTDOWN    (0x00 << 9)
+#define OPT3002_CFG_MODE_CONTINUOUS  (0x02 << 9)
+#define OPT3002_CFG_OVF              (1 << 8)
+#define OPT3002_CFG_CRF              (1 << 7)
+#define OPT3002_CFG_FH               (1 << 6)
+#define OPT3002_CFG_FL               (1 << 5)
+#define OPT3002_CFG_LATCH            (1 << 4)
+#define OPT3002_CFG_MODE_MASK        (0x03 << 9)
+
+// Result and limits: 4-bit exponent over a 12-bit mantissa, 1.2 nW/cm² per LSB at E = 0
+#define OPT3002_LSB_NW_CM2           1.2f
+#define OPT3002_MANTISSA_MAX         0x0FFF
+#define OPT3002_EXPONENT_MAX         11
+
+// Replaced in the unit test by an array of the part's 16-bit registers
+__attribute__((weak)) esp_err_t opt3002_i2c_transfer(i2c_master_dev_handle_t i2c_dev,
+                                                     const uint8_t *write_buf,
+                                                     size_t write_size,
+                                                     uint8_t *read_buf,
+                                                     size_t read_size,
+                                                     int timeout_ms)
+{
+    if (read_size == 0) {
+        return i2c_master_transmit(i2c_dev, write_buf, write_size, timeout_ms);
+    }
+    return i2c_master_transmit_receive(i2c_dev, write_buf, write_size, read_buf, read_size, timeout_ms);
+}
+
+static esp_err_t opt3002_write_reg(opt3002_t *dev, uint8_t reg, uint16_t value)
+{
+    if (dev->i2c_dev == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    uint8_t buf[3] = {
+        reg,
+        (uint8_t)(value >> 8),
+        (uint8_t)(value & 0xFF)
+    };
+    return opt3002_i2c_transfer(dev->i2c_dev, buf, sizeof(buf), NULL, 0, OPT3002_I2C_TIMEOUT_MS);
+}
+
+static esp_err_t opt3002_read_reg(opt3002_t *dev, uint8_t reg, uint16_t *value)
+{
+    if (dev->i2c_dev == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    uint8_t buf[2] = {0};
+    esp_err_t err = opt3002_i2c_transfer(dev->i2c_dev, &reg, 1, buf, sizeof(buf), OPT3002_I2C_TIMEOUT_MS);
+    ESP_RETURN_ON_ERROR(err, TAG, "read register failed");
+    *value = ((uint16_t)buf[0] << 8) | buf[1];
+    return ESP_OK;
+}
+
+static float opt3002_decode(uint16_t raw)
+{
+    return ldexpf(OPT3002_LSB_NW_CM2 * (float)(raw & OPT3002_MANTISSA_MAX), raw >> 12);
+}
+
+// Smallest exponent that fits, so the limit keeps the most resolution;
+// round_up picks the next step above instead of the one below
+static uint16_t opt3002_encode(float nw_cm2, bool round_up)
+{
+    if (nw_cm2 <= 0.0f) {
+        return 0;
+    }
+    for (int e = 0; e <= OPT3002_EXPONENT_MAX; ++e) {
+        float steps = nw_cm2 / ldexpf(OPT3002_LSB_NW_CM2, e);
+        float mantissa = round_up ? ceilf(steps) : floorf(steps);
+        if (mantissa <= OPT3002_MANTISSA_MAX) {
+            return (uint16_t)((e << 12) | (uint16_t)mantissa);
+        }
+    }
+    return (OPT3002_EXPONENT_MAX << 12) | OPT3002_MANTISSA_MAX;
+}
+
+esp_err_t opt3002_init(opt3002_t *dev, const opt3002_config_t *config)
+{
+    ESP_RETURN_ON_FALSE(dev && config, ESP_ERR_INVALID_ARG, TAG, "invalid arguments");
+    memcpy(&dev->config, config, sizeof(opt3002_config_t));
+
+    uint16_t id = 0;
+    ESP_RETURN_ON_ERROR(opt3002_read_reg(dev, OPT3002_REG_MANUFACTURER_ID, &id), TAG, "id read failed");
+    ESP_RETURN_ON_FALSE(id == OPT3002_MANUFACTURER_ID, ESP_ERR_NOT_FOUND, TAG, "unexpected id 0x%04x", id);
+
+    // Fault count field: 1, 2, 4 or 8 results
+    uint16_t fault_code = 0;
+    while (fault_code < 3 && (1u << fault_code) < config->fault_count) {
+        fault_code++;
+    }
+    dev->config_reg = OPT3002_CFG_RANGE_AUTO | ((config->conversion_time & 0x01) << OPT3002_CFG_CT_SHIFT) |
+                      OPT3002_CFG_MODE_CONTINUOUS | OPT3002_CFG_LATCH | fault_code;
+
+    // Open window first, so enabling conversions cannot latch a stale event
+    ESP_RETURN_ON_ERROR(opt3002_write_reg(dev, OPT3002_REG_LOW_LIMIT, 0), TAG, "low limit failed");
+    ESP_RETURN_ON_ERROR(opt3002_write_reg(dev, OPT3002_REG_HIGH_LIMIT, opt3002_encode(OPT3002_MAX_NW_CM2, true)),
+                        TAG, "high limit failed");
+    ESP_RETURN_ON_ERROR(opt3002_write_reg(dev, OPT3002_REG_CONFIG, dev->config_reg), TAG, "config failed");
+
+    dev->initialized = true;
+    return ESP_OK;
+}
+
+esp_err_t opt3002_read_power(opt3002_t *dev, float *nw_cm2)
+{
+    ESP_RETURN_ON_FALSE(dev && nw_cm2, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(dev->initialized, ESP_ERR_INVALID_STATE, TAG, "not initialized");
+    uint16_t raw = 0;
+    ESP_RETURN_ON_ERROR(opt3002_read_reg(dev, OPT3002_REG_RESULT, &raw), TAG, "result read failed");
+    *nw_cm2 = opt3002_decode(raw);
+    return ESP_OK;
+}
+
+esp_err_t opt3002_set_window(opt3002_t *dev, float low_nw_cm2, float high_nw_cm2)
+{
+    ESP_RETURN_ON_FALSE(dev && low_nw_cm2 <= high_nw_cm2, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(dev->initialized, ESP_ERR_INVALID_STATE, TAG, "not initialized");
+    ESP_RETURN_ON_ERROR(opt3002_write_reg(dev, OPT3002_REG_LOW_LIMIT, opt3002_encode(low_nw_cm2, false)), TAG,
+                        "low limit failed");
+    return opt3002_write_reg(dev, OPT3002_REG_HIGH_LIMIT, opt3002_encode(high_nw_cm2, true));
+}
+
+esp_err_t opt3002_read_flags(opt3002_t *dev, uint8_t *flags)
+{
+    ESP_RETURN_ON_FALSE(dev && flags, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(dev->initialized, ESP_ERR_INVALID_STATE, TAG, "not initialized");
+    uint16_t value = 0;
+    ESP_RETURN_ON_ERROR(opt3002_read_reg(dev, OPT3002_REG_CONFIG, &value), TAG, "config read failed");
+    *flags = ((value & OPT3002_CFG_FL) ? OPT3002_FLAG_LOW : 0) |
+             ((value & OPT3002_CFG_FH) ? OPT3002_FLAG_HIGH : 0) |
+             ((value & OPT3002_CFG_CRF) ? OPT3002_FLAG_READY : 0) |
+             ((value & OPT3002_CFG_OVF) ? OPT3002_FLAG_OVERFLOW : 0);
+    return ESP_OK;
+}
+
+esp_err_t opt3002_deinit(opt3002_t *dev)
+{
+    ESP_RETURN_ON_FALSE(dev, ESP_ERR_INVALID_ARG, TAG, "dev null");
+    if (!dev->initialized) {
+        return ESP_OK;
+    }
+    opt3002_write_reg(dev, OPT3002_REG_CONFIG, (dev->config_reg & ~OPT3002_CFG_MODE_MASK) | OPT3002_CFG_MODE_SHUTDOWN);
+    // Remove device from bus if it was added
+    if (dev->i2c_dev != NULL) {
+        i2c_master_bus_rm_device(dev->i2c_dev);
+        dev->i2c_dev = NULL;
+    }
+    dev->initialized = false;
+    return ESP_OK;
+}
@@ -6,7 +6,7 @@
 // Use i2c_port_t from HAL to avoid including old driver/i2c.h (conflicts with driver_ng)
 #include "hal/i2c_types.h"
 #include "driver/gpio.h"
-#include "../../i2c_master_compat.h"  // For i2c_master_dev_handle_t
+#include "driver/i2c_master.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -28,7 +28,7 @@ typedef struct {
     scd40_config_t config;
     bool initialized;
     bool periodic_measurement;
-    i2c_master_dev_handle_t i2c_dev;  // Device handle for new I2C API
+    i2c_master_dev_handle_t i2c_dev;
 } scd40_t;
 
 typedef struct {
@@ -37,6 +37,13 @@ typedef struct {
     float humidity_rh;
 } scd40_measurement_t;
 
+/**
+ * @brief Take the part out of reset (rst_io_num >= 0) and ready it for
+ *        commands over dev->i2c_dev.
+ *
+ * The handle comes from the caller, already added to the bus;
+ * scd40_deinit() removes it.
+ */
 esp_err_t scd40_init(scd40_t *dev, const scd40_config_t *config);
 esp_err_t scd40_start_periodic_measurement(scd40_t *dev);
 esp_err_t scd40_stop_periodic_measurement(scd40_t *dev);
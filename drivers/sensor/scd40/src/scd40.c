@@ -1,5 +1,4 @@
 #include "scd40.h"
-#include "../../i2c_master_compat.h"  // For i2c_master_write_to_device, i2c_master_write_read_device
 
 #include <string.h>
 #include "esp_check.h"
@@ -8,6 +7,7 @@
 #include "driver/gpio.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "sensirion_common.h"
 
 static const char *TAG = "scd40";
 
@@ -16,8 +16,7 @@ static const char *TAG = "scd40";
 #define SCD40_CMD_READ_MEASUREMENT  0xEC05
 #define SCD40_CMD_FRC               0x362F
 
-#define SCD40_CRC_POLY              0x31
-#define SCD40_CRC_INIT              0xFF
+#define SCD40_FRC_DELAY_MS          400
 
 __attribute__((weak)) esp_err_t scd40_i2c_transfer(i2c_port_t port,
                                                    uint8_t addr,
@@ -32,76 +31,25 @@ __attribute__((weak)) esp_err_t scd40_i2c_transfer(i2c_port_t port,
     return ESP_ERR_NOT_SUPPORTED;
 }
 
-static uint8_t scd40_calc_crc(const uint8_t *data, size_t len)
-{
-    uint8_t crc = SCD40_CRC_INIT;
-    for (size_t i = 0; i < len; ++i) {
-        crc ^= data[i];
-        for (int bit = 0; bit < 8; ++bit) {
-            if (crc & 0x80) {
-                crc = (crc << 1) ^ SCD40_CRC_POLY;
-            } else {
-                crc <<= 1;
-            }
-        }
-    }
-    return crc;
-}
-
 static esp_err_t scd40_send_command(scd40_t *dev, uint16_t command)
 {
     ESP_RETURN_ON_FALSE(dev && dev->initialized, ESP_ERR_INVALID_STATE, TAG, "device not initialized");
-    if (dev->i2c_dev == NULL) {
-        return ESP_ERR_INVALID_STATE;
-    }
-    uint8_t buf[2] = {
-        (uint8_t)(command >> 8),
-        (uint8_t)(command & 0xFF)
-    };
-    return i2c_master_transmit(dev->i2c_dev, buf, sizeof(buf), pdMS_TO_TICKS(SCD40_I2C_TIMEOUT_MS));
-}
-
-static esp_err_t scd40_write_with_arg(scd40_t *dev, uint16_t command, uint16_t arg)
-{
-    uint8_t buf[5] = {
-        (uint8_t)(command >> 8),
-        (uint8_t)(command & 0xFF),
-        (uint8_t)(arg >> 8),
-        (uint8_t)(arg & 0xFF),
-        0
-    };
-    buf[4] = scd40_calc_crc(&buf[2], 2);
-    if (dev->i2c_dev == NULL) {
-        return ESP_ERR_INVALID_STATE;
-    }
-    return i2c_master_transmit(dev->i2c_dev, buf, sizeof(buf), pdMS_TO_TICKS(SCD40_I2C_TIMEOUT_MS));
+    return sensirion_write_cmd(dev->i2c_dev, command, SCD40_I2C_TIMEOUT_MS);
 }
 
 static esp_err_t scd40_read_measurement_raw(scd40_t *dev, uint16_t *co2, uint16_t *temp, uint16_t *hum)
 {
-    uint8_t command[2] = {
-        (uint8_t)(SCD40_CMD_READ_MEASUREMENT >> 8),
-        (uint8_t)(SCD40_CMD_READ_MEASUREMENT & 0xFF)
-    };
-    uint8_t response[9] = {0};
-    if (dev->i2c_dev == NULL) {
-        return ESP_ERR_INVALID_STATE;
+    uint16_t words[3];
+    esp_err_t err = sensirion_cmd_read_words(dev->i2c_dev, SCD40_CMD_READ_MEASUREMENT, words, 3,
+                                             SCD40_I2C_TIMEOUT_MS);
+    if (err == ESP_ERR_INVALID_CRC) {
+        ESP_LOGE(TAG, "crc mismatch in measurement");
     }
-    esp_err_t err = i2c_master_transmit_receive(dev->i2c_dev, command, sizeof(command),
-                                                 response, sizeof(response), pdMS_TO_TICKS(SCD40_I2C_TIMEOUT_MS));
     ESP_RETURN_ON_ERROR(err, TAG, "i2c read failed");
 
-    for (size_t i = 0; i < 3; ++i) {
-        uint8_t crc = scd40_calc_crc(&response[i * 3], 2);
-        if (crc != response[i * 3 + 2]) {
-            ESP_LOGE(TAG, "crc mismatch on block %d", (int)i);
-            return ESP_ERR_INVALID_CRC;
-        }
-    }
-
-    *co2 = ((uint16_t)response[0] << 8) | response[1];
-    *temp = ((uint16_t)response[3] << 8) | response[4];
-    *hum = ((uint16_t)response[6] << 8) | response[7];
+    *co2 = words[0];
+    *temp = words[1];
+    *hum = words[2];
     return ESP_OK;
 }
 
@@ -120,10 +68,6 @@ esp_err_t scd40_init(scd40_t *dev, const scd40_config_t *config)
 {
     ESP_RETURN_ON_FALSE(dev && config, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
     memcpy(&dev->config, config, sizeof(scd40_config_t));
-    dev->i2c_dev = NULL;  // Will be set by sensor_integration.c
-
-    // I2C bus should already be initialized by sensor_integration.c using new API
-    // Device handle will be created and stored by sensor_integration.c
 
     dev->initialized = true;
     dev->periodic_measurement = false;
@@ -184,22 +128,17 @@ esp_err_t scd40_perform_forced_recalibration(scd40_t *dev, uint16_t target_co2_p
     ESP_RETURN_ON_FALSE(dev, ESP_ERR_INVALID_ARG, TAG, "dev is null");
     ESP_RETURN_ON_FALSE(dev->initialized, ESP_ERR_INVALID_STATE, TAG, "device not initialized");
 
-    ESP_RETURN_ON_ERROR(scd40_write_with_arg(dev, SCD40_CMD_FRC, target_co2_ppm), TAG, "write frc command failed");
+    ESP_RETURN_ON_ERROR(sensirion_write_cmd_args(dev->i2c_dev, SCD40_CMD_FRC, &target_co2_ppm, 1,
+                                                 SCD40_I2C_TIMEOUT_MS), TAG, "write frc command failed");
 
-    uint8_t response[3] = {0};
-    uint8_t cmd[2] = { (uint8_t)(SCD40_CMD_FRC >> 8), (uint8_t)(SCD40_CMD_FRC & 0xFF) };
-    if (dev->i2c_dev == NULL) {
-        return ESP_ERR_INVALID_STATE;
-    }
-    ESP_RETURN_ON_ERROR(i2c_master_transmit_receive(dev->i2c_dev, cmd, sizeof(cmd), response, sizeof(response),
-                                                     pdMS_TO_TICKS(SCD40_I2C_TIMEOUT_MS)), TAG, "read frc result failed");
-
-    if (scd40_calc_crc(response, 2) != response[2]) {
-        return ESP_ERR_INVALID_CRC;
-    }
+    // The correction is only readable once the sensor has computed it
+    vTaskDelay(pdMS_TO_TICKS(SCD40_FRC_DELAY_MS));
+    uint16_t result = 0;
+    ESP_RETURN_ON_ERROR(sensirion_read_words(dev->i2c_dev, &result, 1, SCD40_I2C_TIMEOUT_MS), TAG,
+                        "read frc result failed");
 
     if (frc_result) {
-        *frc_result = ((uint16_t)response[0] << 8) | response[1];
+        *frc_result = result;
     }
     return ESP_OK;
 }
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "driver/i2c_master.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Shared I2C framing for the Sensirion parts (SCD4x, SGP40, SHT4x, SPS30):
+ * 16-bit big-endian words, each followed by a CRC-8 (poly 0x31, init 0xFF)
+ * on the wire. Commands are 16-bit except on the SHT4x, which sends its
+ * one-byte commands itself and reads through these helpers.
+ */
+
+#define SENSIRION_WORD_BYTES  3   // Two data bytes and their CRC
+#define SENSIRION_MAX_WORDS   20  // Longest read or argument list in one transaction (SPS30 floats)
+
+uint8_t sensirion_crc8(const uint8_t *data, size_t len);
+
+// Words to wire format; out needs count * SENSIRION_WORD_BYTES bytes
+void sensirion_pack_words(const uint16_t *words, size_t count, uint8_t *out);
+
+// Wire format to words; ESP_ERR_INVALID_CRC if any word fails its check
+esp_err_t sensirion_unpack_words(const uint8_t *in, size_t count, uint16_t *words);
+
+esp_err_t sensirion_write_cmd(i2c_master_dev_handle_t dev, uint16_t command, int timeout_ms);
+
+// Command followed by argument words, each with its CRC
+esp_err_t sensirion_write_cmd_args(i2c_master_dev_handle_t dev, uint16_t command,
+                                   const uint16_t *args, size_t arg_count, int timeout_ms);
+
+// Read words left by an earlier command (after its execution time)
+esp_err_t sensirion_read_words(i2c_master_dev_handle_t dev, uint16_t *words, size_t count, int timeout_ms);
+
+// Command and read in one transaction, for commands with no execution time to wait out
+esp_err_t sensirion_cmd_read_words(i2c_master_dev_handle_t dev, uint16_t command,
+                                   uint16_t *words, size_t count, int timeout_ms);
+
+#ifdef __cplusplus
+}
+#endif
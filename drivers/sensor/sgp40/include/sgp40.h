@@ -6,7 +6,7 @@
 // Use i2c_port_t from HAL to avoid including old driver/i2c.h (conflicts with driver_ng)
 #include "hal/i2c_types.h"
 #include "driver/gpio.h"
-#include "../../i2c_master_compat.h"  // For i2c_master_dev_handle_t
+#include "driver/i2c_master.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -15,6 +15,8 @@ extern "C" {
 #define SGP40_DEFAULT_ADDR         0x59
 #define SGP40_I2C_TIMEOUT_MS       1000
 #define SGP40_RAW_DATA_WORDS       3
+// Worst-case measure_raw execution time, for callers that overlap measurements
+#define SGP40_MEASURE_RAW_DELAY_MS 30
 
 typedef struct {
     i2c_port_t i2c_port;
@@ -26,15 +28,23 @@ typedef struct {
 typedef struct {
     sgp40_config_t config;
     bool initialized;
-    i2c_master_dev_handle_t i2c_dev;  // Device handle for new I2C API
+    i2c_master_dev_handle_t i2c_dev;
 } sgp40_t;
 
 typedef struct {
     uint16_t voc_ticks;
 } sgp40_raw_data_t;
 
+/**
+ * @brief Bind the driver to dev->i2c_dev, attached to the bus beforehand.
+ *
+ * Nothing is sent yet. sgp40_deinit() removes the device from the bus.
+ */
 esp_err_t sgp40_init(sgp40_t *dev, const sgp40_config_t *config);
 esp_err_t sgp40_measure_raw(sgp40_t *dev, uint16_t humidity_ticks, uint16_t temperature_ticks, sgp40_raw_data_t *data);
+// Split form of sgp40_measure_raw: start, then read after SGP40_MEASURE_RAW_DELAY_MS
+esp_err_t sgp40_start_measure_raw(sgp40_t *dev, uint16_t humidity_ticks, uint16_t temperature_ticks);
+esp_err_t sgp40_read_raw(sgp40_t *dev, sgp40_raw_data_t *data);
 esp_err_t sgp40_perform_self_test(sgp40_t *dev, bool *passed);
 esp_err_t sgp40_deinit(sgp40_t *dev);
 
@@ -0,0 +1,87 @@
+/**
+ * @file sgp40_voc_index.h
+ * @brief Sensirion Gas Index Algorithm (VOC) in Q16.16 fixed point.
+ *
+ * Turns the SGP40's compensated raw signal into the VOC index (1..500, 100
+ * is the learned average of the last day). The algorithm keeps a running
+ * mean and deviation of the raw signal, maps each sample against them and
+ * smooths the result with an adaptive low-pass filter. It assumes exactly
+ * one sample per second.
+ *
+ * The learned mean and deviation take about 12 h to settle. Save them with
+ * sgp40_voc_index_get_state() and restore them after a reboot to skip that.
+ *
+ * All arithmetic is 32-bit fixed point with 64-bit intermediates; no float.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SGP40_VOC_INDEX_SAMPLING_INTERVAL_S 1
+/// Index reported while the sensor warms up after init
+#define SGP40_VOC_INDEX_BLACKOUT_S          45
+
+typedef struct {
+    int32_t uptime;
+    int32_t sraw;
+    int32_t gas_index;
+    // Mean and variance estimator
+    bool mve_initialized;
+    int32_t mve_mean;
+    int32_t mve_sraw_offset;
+    int32_t mve_std;
+    int32_t mve_gamma_mean;
+    int32_t mve_gamma_variance;
+    int32_t mve_uptime_gamma;
+    int32_t mve_uptime_gating;
+    int32_t mve_gating_duration_min;
+    // MOX model
+    int32_t mox_sraw_std;
+    int32_t mox_sraw_mean;
+    // Adaptive low-pass
+    bool lp_initialized;
+    int32_t lp_x1;
+    int32_t lp_x2;
+    int32_t lp_x3;
+} sgp40_voc_index_t;
+
+/**
+ * @brief Learned state worth keeping across reboots, Q16.16.
+ */
+typedef struct {
+    int32_t mean;
+    int32_t std;
+} sgp40_voc_index_state_t;
+
+void sgp40_voc_index_init(sgp40_voc_index_t *algo);
+
+/**
+ * @brief Feed one raw sample; call once per second.
+ *
+ * @param sraw Raw ticks from sgp40_read_raw(), measured with humidity and
+ *             temperature compensation
+ * @return VOC index 1..500, or 0 during the warm-up blackout
+ */
+int32_t sgp40_voc_index_process(sgp40_voc_index_t *algo, uint16_t sraw);
+
+/**
+ * @brief Learned state, once the algorithm has run long enough to trust it.
+ *
+ * @return false during the first hours, when there is nothing worth saving
+ */
+bool sgp40_voc_index_get_state(const sgp40_voc_index_t *algo, sgp40_voc_index_state_t *state);
+
+/**
+ * @brief Resume from a saved state; call right after init.
+ */
+void sgp40_voc_index_set_state(sgp40_voc_index_t *algo, const sgp40_voc_index_state_t *state);
+
+#ifdef __cplusplus
+}
+#endif
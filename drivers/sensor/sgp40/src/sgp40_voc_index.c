@@ -0,0 +1,334 @@
+/**
+ * @file sgp40_voc_index.c
+ * @brief Fixed-point port of the Sensirion Gas Index Algorithm, VOC mode.
+ *
+ * Structure and tuning follow Sensirion's reference: a mean/variance
+ * estimator with sigmoid-gated learning rates, a MOX model that normalises
+ * the raw signal against it, a sigmoid that maps it onto 0..500, and an
+ * adaptive low-pass filter. Every value is Q16.16; the scalings the
+ * reference applies (gamma x64, std limited around 1440) keep intermediates
+ * inside that range.
+ */
+
+#include "sgp40_voc_index.h"
+
+#include <string.h>
+
+typedef int32_t fix16_t;
+
+#define F16(x) ((fix16_t)(((x) >= 0) ? ((x) * 65536.0 + 0.5) : ((x) * 65536.0 - 0.5)))
+#define FIX16_ONE     0x00010000
+#define FIX16_MAXIMUM INT32_MAX
+#define FIX16_MINIMUM INT32_MIN
+
+// Tuning from the reference implementation, for a 1 s sampling interval
+#define VOC_INTERVAL                     1.0
+#define VOC_INDEX_GAIN                   230.0
+#define VOC_SRAW_STD_INITIAL             50.0
+#define VOC_SRAW_STD_BONUS               220.0
+#define VOC_TAU_MEAN_HOURS               12.0
+#define VOC_TAU_VARIANCE_HOURS           12.0
+#define VOC_TAU_INITIAL_MEAN             20.0
+#define VOC_INIT_DURATION_MEAN           (3600.0 * 0.75)
+#define VOC_INIT_TRANSITION_MEAN         0.01
+#define VOC_TAU_INITIAL_VARIANCE         2500.0
+#define VOC_INIT_DURATION_VARIANCE       (3600.0 * 1.45)
+#define VOC_INIT_TRANSITION_VARIANCE     0.01
+#define VOC_GATING_THRESHOLD             340.0
+#define VOC_GATING_THRESHOLD_INITIAL     510.0
+#define VOC_GATING_THRESHOLD_TRANSITION  0.09
+#define VOC_GATING_MAX_DURATION_MINUTES  (60.0 * 3.0)
+#define VOC_GATING_MAX_RATIO             0.3
+#define VOC_SIGMOID_L                    500.0
+#define VOC_SIGMOID_K                    -0.0065
+#define VOC_SIGMOID_X0                   213.0
+#define VOC_LP_TAU_FAST                  20.0
+#define VOC_LP_TAU_SLOW                  500.0
+#define VOC_LP_ALPHA                     -0.2
+#define VOC_SRAW_MINIMUM                 20000
+#define VOC_PERSISTENCE_UPTIME_GAMMA     (3.0 * 3600.0)
+#define VOC_GAMMA_SCALING                64.0
+#define VOC_ADDITIONAL_GAMMA_MEAN_SCALING 8.0
+// Uptimes stop just short of the largest whole Q16.16 value
+#define VOC_UPTIME_LIMIT                 (32767.0 - VOC_INTERVAL)
+
+#define VOC_GAMMA_MEAN \
+    ((VOC_ADDITIONAL_GAMMA_MEAN_SCALING * VOC_GAMMA_SCALING * (VOC_INTERVAL / 3600.0)) / \
+     (VOC_TAU_MEAN_HOURS + VOC_INTERVAL / 3600.0))
+#define VOC_GAMMA_VARIANCE \
+    ((VOC_GAMMA_SCALING * (VOC_INTERVAL / 3600.0)) / (VOC_TAU_VARIANCE_HOURS + VOC_INTERVAL / 3600.0))
+#define VOC_GAMMA_INITIAL_MEAN \
+    ((VOC_ADDITIONAL_GAMMA_MEAN_SCALING * VOC_GAMMA_SCALING * VOC_INTERVAL) / \
+     (VOC_TAU_INITIAL_MEAN + VOC_INTERVAL))
+#define VOC_GAMMA_INITIAL_VARIANCE \
+    ((VOC_GAMMA_SCALING * VOC_INTERVAL) / (VOC_TAU_INITIAL_VARIANCE + VOC_INTERVAL))
+#define VOC_LP_A1 (VOC_INTERVAL / (VOC_LP_TAU_FAST + VOC_INTERVAL))
+#define VOC_LP_A2 (VOC_INTERVAL / (VOC_LP_TAU_SLOW + VOC_INTERVAL))
+
+static fix16_t fix16_saturate(int64_t value)
+{
+    if (value > FIX16_MAXIMUM) {
+        return FIX16_MAXIMUM;
+    }
+    if (value < FIX16_MINIMUM) {
+        return FIX16_MINIMUM;
+    }
+    return (fix16_t)value;
+}
+
+static fix16_t fix16_mul(fix16_t a, fix16_t b)
+{
+    int64_t product = (int64_t)a * b;
+    return fix16_saturate((product + 0x8000) >> 16);
+}
+
+static fix16_t fix16_div(fix16_t a, fix16_t b)
+{
+    if (b == 0) {
+        return a >= 0 ? FIX16_MAXIMUM : FIX16_MINIMUM;
+    }
+    return fix16_saturate(((int64_t)a * FIX16_ONE) / b);
+}
+
+static fix16_t fix16_sqrt(fix16_t x)
+{
+    if (x <= 0) {
+        return 0;
+    }
+    // Integer square root of x << 16 is the Q16.16 root of x
+    uint64_t value = (uint64_t)x << 16;
+    uint64_t result = 0;
+    uint64_t bit = 1ULL << 46;
+    while (bit > value) {
+        bit >>= 2;
+    }
+    while (bit != 0) {
+        if (value >= result + bit) {
+            value -= result + bit;
+            result = (result >> 1) + bit;
+        } else {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (fix16_t)result;
+}
+
+static fix16_t fix16_exp(fix16_t x)
+{
+    // Outside these the result does not fit, or rounds to zero
+    if (x >= F16(10.3972)) {
+        return FIX16_MAXIMUM;
+    }
+    if (x <= F16(-11.7835)) {
+        return 0;
+    }
+    // x = k * ln2 + r with |r| <= ln2 / 2, then a Taylor series for e^r
+    const fix16_t ln2 = F16(0.69314718);
+    int32_t k = (x >= 0 ? x + ln2 / 2 : x - ln2 / 2) / ln2;
+    fix16_t r = x - k * ln2;
+    fix16_t term = FIX16_ONE;
+    for (int n = 6; n >= 1; --n) {
+        term = FIX16_ONE + fix16_mul(r, term) / n;
+    }
+    int64_t result = term;
+    if (k >= 0) {
+        result <<= k;
+    } else {
+        result = (result + (1LL << (-k - 1))) >> -k;
+    }
+    return fix16_saturate(result);
+}
+
+// 1 / (1 + e^(k * (sample - x0)))
+static fix16_t sigmoid(fix16_t sample, fix16_t x0, fix16_t k)
+{
+    fix16_t x = fix16_mul(k, sample - x0);
+    if (x < F16(-50.0)) {
+        return FIX16_ONE;
+    }
+    if (x > F16(50.0)) {
+        return 0;
+    }
+    fix16_t e = fix16_exp(x);
+    if (e == FIX16_MAXIMUM) {
+        return 0;
+    }
+    return fix16_div(FIX16_ONE, FIX16_ONE + e);
+}
+
+static void mve_calculate_gamma(sgp40_voc_index_t *algo)
+{
+    if (algo->mve_uptime_gamma < F16(VOC_UPTIME_LIMIT)) {
+        algo->mve_uptime_gamma += F16(VOC_INTERVAL);
+    }
+    if (algo->mve_uptime_gating < F16(VOC_UPTIME_LIMIT)) {
+        algo->mve_uptime_gating += F16(VOC_INTERVAL);
+    }
+
+    // Learn fast while the estimator is young, then settle on the 12 h constants
+    fix16_t sigmoid_gamma_mean = sigmoid(algo->mve_uptime_gamma, F16(VOC_INIT_DURATION_MEAN),
+                                         F16(VOC_INIT_TRANSITION_MEAN));
+    fix16_t gamma_mean = F16(VOC_GAMMA_MEAN) +
+                         fix16_mul(F16(VOC_GAMMA_INITIAL_MEAN) - F16(VOC_GAMMA_MEAN), sigmoid_gamma_mean);
+    fix16_t gating_threshold_mean =
+        F16(VOC_GATING_THRESHOLD) +
+        fix16_mul(F16(VOC_GATING_THRESHOLD_INITIAL) - F16(VOC_GATING_THRESHOLD),
+                  sigmoid(algo->mve_uptime_gating, F16(VOC_INIT_DURATION_MEAN), F16(VOC_INIT_TRANSITION_MEAN)));
+    // Stop learning while an event pushes the index above the gate
+    fix16_t sigmoid_gating_mean = sigmoid(algo->gas_index, gating_threshold_mean,
+                                          F16(VOC_GATING_THRESHOLD_TRANSITION));
+    algo->mve_gamma_mean = fix16_mul(sigmoid_gating_mean, gamma_mean);
+
+    fix16_t sigmoid_gamma_variance = sigmoid(algo->mve_uptime_gamma, F16(VOC_INIT_DURATION_VARIANCE),
+                                             F16(VOC_INIT_TRANSITION_VARIANCE));
+    fix16_t gamma_variance = F16(VOC_GAMMA_VARIANCE) +
+                             fix16_mul(F16(VOC_GAMMA_INITIAL_VARIANCE) - F16(VOC_GAMMA_VARIANCE),
+                                       sigmoid_gamma_variance - sigmoid_gamma_mean);
+    fix16_t gating_threshold_variance =
+        F16(VOC_GATING_THRESHOLD) +
+        fix16_mul(F16(VOC_GATING_THRESHOLD_INITIAL) - F16(VOC_GATING_THRESHOLD),
+                  sigmoid(algo->mve_uptime_gating, F16(VOC_INIT_DURATION_VARIANCE),
+                          F16(VOC_INIT_TRANSITION_VARIANCE)));
+    fix16_t sigmoid_gating_variance = sigmoid(algo->gas_index, gating_threshold_variance,
+                                              F16(VOC_GATING_THRESHOLD_TRANSITION));
+    algo->mve_gamma_variance = fix16_mul(sigmoid_gating_variance, gamma_variance);
+
+    // A gate held closed for too long is reopened, so a lasting change is learned
+    algo->mve_gating_duration_min +=
+        fix16_mul(F16(VOC_INTERVAL / 60.0),
+                  fix16_mul(FIX16_ONE - sigmoid_gating_mean, F16(1.0 + VOC_GATING_MAX_RATIO)) -
+                      F16(VOC_GATING_MAX_RATIO));
+    if (algo->mve_gating_duration_min < 0) {
+        algo->mve_gating_duration_min = 0;
+    }
+    if (algo->mve_gating_duration_min > F16(VOC_GATING_MAX_DURATION_MINUTES)) {
+        algo->mve_uptime_gating = 0;
+    }
+}
+
+static void mve_process(sgp40_voc_index_t *algo, fix16_t sraw)
+{
+    if (!algo->mve_initialized) {
+        algo->mve_initialized = true;
+        algo->mve_sraw_offset = sraw;
+        algo->mve_mean = 0;
+        return;
+    }
+    // Keep the mean small by moving it into the offset
+    if (algo->mve_mean >= F16(100.0) || algo->mve_mean <= F16(-100.0)) {
+        algo->mve_sraw_offset += algo->mve_mean;
+        algo->mve_mean = 0;
+    }
+    sraw -= algo->mve_sraw_offset;
+    mve_calculate_gamma(algo);
+
+    fix16_t delta_sgp = fix16_div(sraw - algo->mve_mean, F16(VOC_GAMMA_SCALING));
+    fix16_t c = delta_sgp < 0 ? algo->mve_std - delta_sgp : algo->mve_std + delta_sgp;
+    fix16_t additional_scaling = FIX16_ONE;
+    if (c > F16(1440.0)) {
+        fix16_t ratio = fix16_div(c, F16(1440.0));
+        additional_scaling = fix16_mul(ratio, ratio);
+    }
+    algo->mve_std = fix16_mul(
+        fix16_sqrt(fix16_mul(additional_scaling, F16(VOC_GAMMA_SCALING) - algo->mve_gamma_variance)),
+        fix16_sqrt(fix16_mul(algo->mve_std,
+                             fix16_div(algo->mve_std, fix16_mul(F16(VOC_GAMMA_SCALING), additional_scaling))) +
+                   fix16_mul(fix16_div(fix16_mul(algo->mve_gamma_variance, delta_sgp), additional_scaling),
+                             delta_sgp)));
+    algo->mve_mean += fix16_div(fix16_mul(algo->mve_gamma_mean, delta_sgp),
+                                F16(VOC_ADDITIONAL_GAMMA_MEAN_SCALING));
+}
+
+static fix16_t mox_model_process(const sgp40_voc_index_t *algo, fix16_t sraw)
+{
+    return fix16_mul(fix16_div(sraw - algo->mox_sraw_mean, -(algo->mox_sraw_std + F16(VOC_SRAW_STD_BONUS))),
+                     F16(VOC_INDEX_GAIN));
+}
+
+// With the default index offset of 100 the reference's shift term is zero
+static fix16_t sigmoid_scaled_process(fix16_t sample)
+{
+    return fix16_mul(F16(VOC_SIGMOID_L), sigmoid(sample, F16(VOC_SIGMOID_X0), F16(VOC_SIGMOID_K)));
+}
+
+static fix16_t adaptive_lowpass_process(sgp40_voc_index_t *algo, fix16_t sample)
+{
+    if (!algo->lp_initialized) {
+        algo->lp_x1 = sample;
+        algo->lp_x2 = sample;
+        algo->lp_x3 = sample;
+        algo->lp_initialized = true;
+    }
+    algo->lp_x1 = fix16_mul(FIX16_ONE - F16(VOC_LP_A1), algo->lp_x1) + fix16_mul(F16(VOC_LP_A1), sample);
+    algo->lp_x2 = fix16_mul(FIX16_ONE - F16(VOC_LP_A2), algo->lp_x2) + fix16_mul(F16(VOC_LP_A2), sample);
+    fix16_t abs_delta = algo->lp_x1 - algo->lp_x2;
+    if (abs_delta < 0) {
+        abs_delta = -abs_delta;
+    }
+    // Follow quickly while the fast and slow filters disagree, smooth otherwise
+    fix16_t f1 = fix16_exp(fix16_mul(F16(VOC_LP_ALPHA), abs_delta));
+    fix16_t tau_a = fix16_mul(F16(VOC_LP_TAU_SLOW - VOC_LP_TAU_FAST), f1) + F16(VOC_LP_TAU_FAST);
+    fix16_t a3 = fix16_div(F16(VOC_INTERVAL), F16(VOC_INTERVAL) + tau_a);
+    algo->lp_x3 = fix16_mul(FIX16_ONE - a3, algo->lp_x3) + fix16_mul(a3, sample);
+    return algo->lp_x3;
+}
+
+void sgp40_voc_index_init(sgp40_voc_index_t *algo)
+{
+    memset(algo, 0, sizeof(*algo));
+    algo->mve_std = F16(VOC_SRAW_STD_INITIAL);
+    algo->mox_sraw_std = F16(VOC_SRAW_STD_INITIAL);
+}
+
+int32_t sgp40_voc_index_process(sgp40_voc_index_t *algo, uint16_t sraw)
+{
+    if (algo->uptime <= F16(SGP40_VOC_INDEX_BLACKOUT_S)) {
+        algo->uptime += F16(VOC_INTERVAL);
+    } else {
+        if (sraw > 0 && sraw < 65000) {
+            int32_t value = sraw;
+            if (value < VOC_SRAW_MINIMUM + 1) {
+                value = VOC_SRAW_MINIMUM + 1;
+            } else if (value > VOC_SRAW_MINIMUM + 32767) {
+                value = VOC_SRAW_MINIMUM + 32767;
+            }
+            algo->sraw = (value - VOC_SRAW_MINIMUM) * FIX16_ONE;
+        }
+        algo->gas_index = mox_model_process(algo, algo->sraw);
+        algo->gas_index = sigmoid_scaled_process(algo->gas_index);
+        algo->gas_index = adaptive_lowpass_process(algo, algo->gas_index);
+        if (algo->gas_index < F16(0.5)) {
+            algo->gas_index = F16(0.5);
+        }
+        if (algo->sraw > 0) {
+            mve_process(algo, algo->sraw);
+            algo->mox_sraw_std = algo->mve_std;
+            algo->mox_sraw_mean = algo->mve_mean + algo->mve_sraw_offset;
+        }
+    }
+    return (algo->gas_index + F16(0.5)) >> 16;
+}
+
+bool sgp40_voc_index_get_state(const sgp40_voc_index_t *algo, sgp40_voc_index_state_t *state)
+{
+    if (!algo->mve_initialized || algo->mve_uptime_gamma < F16(VOC_PERSISTENCE_UPTIME_GAMMA)) {
+        return false;
+    }
+    state->mean = algo->mve_mean + algo->mve_sraw_offset;
+    state->std = algo->mve_std;
+    return true;
+}
+
+void sgp40_voc_index_set_state(sgp40_voc_index_t *algo, const sgp40_voc_index_state_t *state)
+{
+    algo->mve_mean = state->mean;
+    algo->mve_sraw_offset = 0;
+    algo->mve_std = state->std;
+    // Resume as if the estimator had already run through its fast start
+    algo->mve_uptime_gamma = F16(VOC_PERSISTENCE_UPTIME_GAMMA);
+    algo->mve_initialized = true;
+    algo->mox_sraw_std = state->std;
+    algo->mox_sraw_mean = state->mean;
+    algo->sraw = state->mean;
+}
@@ -11,13 +11,17 @@
 
 #include <stdint.h>
 #include <stdbool.h>
-#include "../../i2c_master_compat.h"
+#include "driver/i2c_master.h"
+
+/// Worst-case high-precision conversion time, for callers that overlap measurements
+#define SHT45_MEASURE_DELAY_MS 15
 
 /**
  * @brief SHT45 device handle
  */
 typedef struct {
-    i2c_master_bus_handle_t i2c_bus;  ///< I2C bus handle (i2c_port_t in v4.4)
+    i2c_master_bus_handle_t i2c_bus;  ///< I2C bus handle
+    i2c_master_dev_handle_t i2c_dev;  ///< Added to i2c_bus by sht45_init()
     uint8_t device_address;           ///< I2C device address (default 0x44)
     bool initialized;                  ///< Initialization status
 } sht45_handle_t;
@@ -35,14 +39,14 @@ typedef struct {
  * @brief Initialize SHT45 sensor
  * 
  * @param handle Pointer to SHT45 handle (will be initialized)
- * @param i2c_bus I2C bus handle (must be initialized)
+ * @param i2c_bus I2C bus handle (must be initialized); the sensor is added to it
  * @param device_addr I2C device address (default: 0x44)
  * @return true if initialization successful, false otherwise
  */
 bool sht45_init(sht45_handle_t *handle, i2c_master_bus_handle_t i2c_bus, uint8_t device_addr);
 
 /**
- * @brief Deinitialize SHT45 sensor
+ * @brief Deinitialize SHT45 sensor and remove it from the bus
  * 
  * @param handle SHT45 handle
  */
@@ -57,6 +61,26 @@ void sht45_deinit(sht45_handle_t *handle);
  */
 bool sht45_read(sht45_handle_t *handle, sht45_data_t *data);
 
+/**
+ * @brief Trigger a measurement without waiting for it
+ *
+ * Collect the result with sht45_read_measurement() once
+ * SHT45_MEASURE_DELAY_MS has passed.
+ *
+ * @param handle SHT45 handle
+ * @return true if the command was sent, false otherwise
+ */
+bool sht45_start_measurement(sht45_handle_t *handle);
+
+/**
+ * @brief Read the result of a measurement started earlier
+ *
+ * @param handle SHT45 handle
+ * @param data Pointer to data structure (will be populated)
+ * @return true if read successful, false otherwise
+ */
+bool sht45_read_measurement(sht45_handle_t *handle, sht45_data_t *data);
+
 /**
  * @brief Read temperature only
  * 
@@ -8,6 +8,7 @@
 #include "esp_err.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "sensirion_common.h"
 #include <string.h>
 
 static const char *TAG = "sht45";
@@ -19,8 +20,8 @@ static const char *TAG = "sht45";
 #define SHT45_CMD_MEASURE_T_RH_HPM 0xFD  // High precision measurement
 #define SHT45_CMD_SOFT_RESET 0x94
 
-// Timing
-#define SHT45_MEASURE_DELAY_MS 15
+#define SHT45_I2C_SPEED_HZ 100000
+#define SHT45_I2C_TIMEOUT_MS 100
 
 /**
  * @brief Initialize SHT45 sensor
@@ -36,17 +37,20 @@ bool sht45_init(sht45_handle_t *handle, i2c_master_bus_handle_t i2c_bus, uint8_t
     handle->i2c_bus = i2c_bus;
     handle->device_address = (device_addr != 0) ? device_addr : SHT45_I2C_ADDR_DEFAULT;
 
+    i2c_device_config_t dev_config = {
+        .dev_addr_length = I2C_ADDR_BIT_LEN_7,
+        .device_address = handle->device_address,
+        .scl_speed_hz = SHT45_I2C_SPEED_HZ,
+    };
+    esp_err_t ret = i2c_master_bus_add_device(i2c_bus, &dev_config, &handle->i2c_dev);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to add device: %s", esp_err_to_name(ret));
+        return false;
+    }
+
     // Perform soft reset
-    // Note: i2c_master_transmit_receive needs a device handle, not bus handle + address
-    // For v4.4 compatibility, we'll use direct I2C commands
     uint8_t cmd = SHT45_CMD_SOFT_RESET;
-    i2c_cmd_handle_t i2c_cmd = i2c_cmd_link_create();
-    i2c_master_start(i2c_cmd);
-    i2c_master_write_byte(i2c_cmd, (handle->device_address << 1) | I2C_MASTER_WRITE, true);
-    i2c_master_write_byte(i2c_cmd, cmd, true);
-    i2c_master_stop(i2c_cmd);
-    i2c_master_cmd_begin(handle->i2c_bus, i2c_cmd, pdMS_TO_TICKS(100));
-    i2c_cmd_link_delete(i2c_cmd);
+    i2c_master_transmit(handle->i2c_dev, &cmd, 1, SHT45_I2C_TIMEOUT_MS);
     vTaskDelay(pdMS_TO_TICKS(10));
 
     // Verify device presence by attempting a read
@@ -63,65 +67,61 @@ bool sht45_init(sht45_handle_t *handle, i2c_master_bus_handle_t i2c_bus, uint8_t
 void sht45_deinit(sht45_handle_t *handle)
 {
     if (handle != NULL) {
+        if (handle->i2c_dev != NULL) {
+            i2c_master_bus_rm_device(handle->i2c_dev);
+            handle->i2c_dev = NULL;
+        }
         handle->initialized = false;
         ESP_LOGI(TAG, "SHT45 deinitialized");
     }
 }
 
 /**
- * @brief Read temperature and humidity from sensor
+ * @brief Trigger a measurement without waiting for it
  */
-bool sht45_read(sht45_handle_t *handle, sht45_data_t *data)
+bool sht45_start_measurement(sht45_handle_t *handle)
 {
-    if (handle == NULL || data == NULL || !handle->initialized) {
+    if (handle == NULL || !handle->initialized) {
         ESP_LOGE(TAG, "Invalid parameters or not initialized");
         return false;
     }
 
     uint8_t cmd = SHT45_CMD_MEASURE_T_RH_HPM;
-    uint8_t rx_data[6] = {0};
-
-    // Send measurement command using v4.4 I2C API
-    i2c_cmd_handle_t i2c_cmd = i2c_cmd_link_create();
-    i2c_master_start(i2c_cmd);
-    i2c_master_write_byte(i2c_cmd, (handle->device_address << 1) | I2C_MASTER_WRITE, true);
-    i2c_master_write_byte(i2c_cmd, cmd, true);
-    i2c_master_stop(i2c_cmd);
-    esp_err_t ret = i2c_master_cmd_begin(handle->i2c_bus, i2c_cmd, pdMS_TO_TICKS(100));
-    i2c_cmd_link_delete(i2c_cmd);
 
+    esp_err_t ret = i2c_master_transmit(handle->i2c_dev, &cmd, 1, SHT45_I2C_TIMEOUT_MS);
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "I2C write failed: %s", esp_err_to_name(ret));
-        data->valid = false;
         return false;
     }
+    return true;
+}
 
-    // Wait for measurement to complete
-    vTaskDelay(pdMS_TO_TICKS(SHT45_MEASURE_DELAY_MS));
-
-    // Read measurement data using v4.4 I2C API
-    i2c_cmd = i2c_cmd_link_create();
-    i2c_master_start(i2c_cmd);
-    i2c_master_write_byte(i2c_cmd, (handle->device_address << 1) | I2C_MASTER_READ, true);
-    if (6 > 1) {
-        i2c_master_read(i2c_cmd, rx_data, 6 - 1, I2C_MASTER_ACK);
+/**
+ * @brief Read the result of a measurement started earlier
+ */
+bool sht45_read_measurement(sht45_handle_t *handle, sht45_data_t *data)
+{
+    if (handle == NULL || data == NULL || !handle->initialized) {
+        ESP_LOGE(TAG, "Invalid parameters or not initialized");
+        return false;
     }
-    i2c_master_read_byte(i2c_cmd, rx_data + 6 - 1, I2C_MASTER_NACK);
-    i2c_master_stop(i2c_cmd);
-    ret = i2c_master_cmd_begin(handle->i2c_bus, i2c_cmd, pdMS_TO_TICKS(100));
-    i2c_cmd_link_delete(i2c_cmd);
+
+    uint16_t words[2] = {0};
+
+    // Both words carry a CRC; a corrupted frame is rejected like a failed read
+    esp_err_t ret = sensirion_read_words(handle->i2c_dev, words, 2, SHT45_I2C_TIMEOUT_MS);
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "I2C read failed: %s", esp_err_to_name(ret));
         data->valid = false;
         return false;
     }
 
-    // Parse temperature (first 2 bytes)
-    uint16_t temp_raw = (rx_data[0] << 8) | rx_data[1];
+    // Parse temperature (first word)
+    uint16_t temp_raw = words[0];
     data->temperature_c = -45.0f + (175.0f * temp_raw / 65535.0f);
 
-    // Parse humidity (bytes 3-4)
-    uint16_t hum_raw = (rx_data[3] << 8) | rx_data[4];
+    // Parse humidity (second word)
+    uint16_t hum_raw = words[1];
     data->humidity_rh = -6.0f + (125.0f * hum_raw / 65535.0f);
 
     // Validate ranges
@@ -137,6 +137,26 @@ bool sht45_read(sht45_handle_t *handle, sht45_data_t *data)
     return true;
 }
 
+/**
+ * @brief Read temperature and humidity from sensor
+ */
+bool sht45_read(sht45_handle_t *handle, sht45_data_t *data)
+{
+    if (data == NULL) {
+        ESP_LOGE(TAG, "Invalid parameters or not initialized");
+        return false;
+    }
+    if (!sht45_start_measurement(handle)) {
+        data->valid = false;
+        return false;
+    }
+
+    // Wait for measurement to complete
+    vTaskDelay(pdMS_TO_TICKS(SHT45_MEASURE_DELAY_MS));
+
+    return sht45_read_measurement(handle, data);
+}
+
 /**
  * @brief Read temperature only
  */
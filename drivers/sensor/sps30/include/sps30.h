@@ -0,0 +1,85 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "driver/i2c_master.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SPS30_DEFAULT_ADDR          0x69
+#define SPS30_I2C_TIMEOUT_MS        100
+// A new measurement is ready once a second in continuous mode
+#define SPS30_MEASUREMENT_PERIOD_MS 1000
+// Fan spin-up before the first measurement is valid
+#define SPS30_STARTUP_MS            8000
+// Auto-cleaning default in the sensor: once a week of continuous running
+#define SPS30_AUTO_CLEAN_DEFAULT_S  604800
+
+typedef enum {
+    SPS30_OUTPUT_FLOAT = 0x03,   ///< IEEE754 floats, 20 words per read
+    SPS30_OUTPUT_UINT16 = 0x05,  ///< Integers, 10 words per read; particle size in nm
+} sps30_output_format_t;
+
+typedef struct {
+    sps30_output_format_t output_format;
+    uint32_t auto_clean_interval_s;  ///< Written at init if non-zero; 0 keeps the sensor's stored setting
+} sps30_config_t;
+
+typedef struct {
+    sps30_config_t config;
+    bool initialized;
+    bool measuring;
+    i2c_master_dev_handle_t i2c_dev;
+} sps30_t;
+
+typedef struct {
+    float mc_pm1_0;                  ///< Mass concentration (µg/m³)
+    float mc_pm2_5;
+    float mc_pm4_0;
+    float mc_pm10;
+    float nc_pm0_5;                  ///< Number concentration (#/cm³)
+    float nc_pm1_0;
+    float nc_pm2_5;
+    float nc_pm4_0;
+    float nc_pm10;
+    float typical_particle_size_um;
+} sps30_measurement_t;
+
+/**
+ * @brief Set up the driver on dev->i2c_dev and write the auto-cleaning
+ *        interval if one is configured.
+ *
+ * The caller adds the device to the bus first. sps30_deinit() stops any
+ * measurement and removes it; if init fails, removing it is still the
+ * caller's job.
+ */
+esp_err_t sps30_init(sps30_t *dev, const sps30_config_t *config);
+esp_err_t sps30_start_measurement(sps30_t *dev);
+esp_err_t sps30_stop_measurement(sps30_t *dev);
+esp_err_t sps30_read_data_ready(sps30_t *dev, bool *ready);
+esp_err_t sps30_read_measurement(sps30_t *dev, sps30_measurement_t *measurement);
+
+/**
+ * @brief Read the measurement only when the sensor flags a new one.
+ *
+ * One short read of the data-ready flag, then one batched read of every
+ * value if it is set. *fresh reports which happened; the measurement is
+ * untouched when it is false.
+ */
+esp_err_t sps30_poll(sps30_t *dev, sps30_measurement_t *measurement, bool *fresh);
+
+esp_err_t sps30_start_fan_cleaning(sps30_t *dev);
+esp_err_t sps30_get_auto_cleaning_interval(sps30_t *dev, uint32_t *interval_s);
+esp_err_t sps30_set_auto_cleaning_interval(sps30_t *dev, uint32_t interval_s);
+esp_err_t sps30_deinit(sps30_t *dev);
+
+// Words of a measured-values read in the given format to values; used by sps30_read_measurement
+void sps30_decode_measurement(const uint16_t *words, sps30_output_format_t format,
+                              sps30_measurement_t *measurement);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,204 @@
+#include "sps30.h"
+
+#include <string.h>
+#include "esp_check.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "sensirion_common.h"
+
+static const char *TAG = "sps30";
+
+#define SPS30_CMD_START_MEASUREMENT  0x0010
+#define SPS30_CMD_STOP_MEASUREMENT   0x0104
+#define SPS30_CMD_READ_DATA_READY    0x0202
+#define SPS30_CMD_READ_VALUES        0x0300
+#define SPS30_CMD_AUTO_CLEAN         0x8004
+#define SPS30_CMD_START_FAN_CLEANING 0x5607
+
+#define SPS30_VALUE_COUNT            10
+// Start and stop take up to 20 ms before the sensor accepts another command
+#define SPS30_CMD_EXEC_MS            20
+
+// The SPS30 does not take a repeated start: each read is a command write,
+// a stop, then a read of the words it left
+static esp_err_t sps30_read_cmd(sps30_t *dev, uint16_t command, uint16_t *words, size_t count)
+{
+    ESP_RETURN_ON_ERROR(sensirion_write_cmd(dev->i2c_dev, command, SPS30_I2C_TIMEOUT_MS), TAG, "command 0x%04x",
+                        command);
+    return sensirion_read_words(dev->i2c_dev, words, count, SPS30_I2C_TIMEOUT_MS);
+}
+
+static size_t sps30_value_words(sps30_output_format_t format)
+{
+    return format == SPS30_OUTPUT_FLOAT ? SPS30_VALUE_COUNT * 2 : SPS30_VALUE_COUNT;
+}
+
+void sps30_decode_measurement(const uint16_t *words, sps30_output_format_t format,
+                              sps30_measurement_t *measurement)
+{
+    float values[SPS30_VALUE_COUNT];
+    for (size_t i = 0; i < SPS30_VALUE_COUNT; ++i) {
+        if (format == SPS30_OUTPUT_FLOAT) {
+            uint32_t bits = ((uint32_t)words[i * 2] << 16) | words[i * 2 + 1];
+            memcpy(&values[i], &bits, sizeof(values[i]));
+        } else {
+            values[i] = words[i];
+        }
+    }
+    // Integer output reports the typical size in nm
+    if (format == SPS30_OUTPUT_UINT16) {
+        values[9] /= 1000.0f;
+    }
+    measurement->mc_pm1_0 = values[0];
+    measurement->mc_pm2_5 = values[1];
+    measurement->mc_pm4_0 = values[2];
+    measurement->mc_pm10 = values[3];
+    measurement->nc_pm0_5 = values[4];
+    measurement->nc_pm1_0 = values[5];
+    measurement->nc_pm2_5 = values[6];
+    measurement->nc_pm4_0 = values[7];
+    measurement->nc_pm10 = values[8];
+    measurement->typical_particle_size_um = values[9];
+}
+
+esp_err_t sps30_init(sps30_t *dev, const sps30_config_t *config)
+{
+    ESP_RETURN_ON_FALSE(dev && config, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(config->output_format == SPS30_OUTPUT_FLOAT || config->output_format == SPS30_OUTPUT_UINT16,
+                        ESP_ERR_INVALID_ARG, TAG, "output format");
+    memcpy(&dev->config, config, sizeof(sps30_config_t));
+
+    dev->initialized = true;
+    dev->measuring = false;
+
+    if (config->auto_clean_interval_s) {
+        esp_err_t err = sps30_set_auto_cleaning_interval(dev, config->auto_clean_interval_s);
+        if (err != ESP_OK) {
+            dev->initialized = false;
+            return err;
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t sps30_start_measurement(sps30_t *dev)
+{
+    ESP_RETURN_ON_FALSE(dev, ESP_ERR_INVALID_ARG, TAG, "dev is null");
+    ESP_RETURN_ON_FALSE(dev->initialized, ESP_ERR_INVALID_STATE, TAG, "device not initialized");
+
+    // Format in the high byte, low byte reserved
+    uint16_t arg = (uint16_t)dev->config.output_format << 8;
+    ESP_RETURN_ON_ERROR(sensirion_write_cmd_args(dev->i2c_dev, SPS30_CMD_START_MEASUREMENT, &arg, 1,
+                                                 SPS30_I2C_TIMEOUT_MS), TAG, "start measurement failed");
+    vTaskDelay(pdMS_TO_TICKS(SPS30_CMD_EXEC_MS));
+    dev->measuring = true;
+    return ESP_OK;
+}
+
+esp_err_t sps30_stop_measurement(sps30_t *dev)
+{
+    ESP_RETURN_ON_FALSE(dev, ESP_ERR_INVALID_ARG, TAG, "dev is null");
+    ESP_RETURN_ON_FALSE(dev->initialized, ESP_ERR_INVALID_STATE, TAG, "device not initialized");
+
+    ESP_RETURN_ON_ERROR(sensirion_write_cmd(dev->i2c_dev, SPS30_CMD_STOP_MEASUREMENT, SPS30_I2C_TIMEOUT_MS), TAG,
+                        "stop measurement failed");
+    vTaskDelay(pdMS_TO_TICKS(SPS30_CMD_EXEC_MS));
+    dev->measuring = false;
+    return ESP_OK;
+}
+
+esp_err_t sps30_read_data_ready(sps30_t *dev, bool *ready)
+{
+    ESP_RETURN_ON_FALSE(dev && ready, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(dev->initialized, ESP_ERR_INVALID_STATE, TAG, "device not initialized");
+
+    uint16_t flag = 0;
+    ESP_RETURN_ON_ERROR(sps30_read_cmd(dev, SPS30_CMD_READ_DATA_READY, &flag, 1), TAG, "read data ready failed");
+    *ready = (flag & 0x01) != 0;
+    return ESP_OK;
+}
+
+esp_err_t sps30_read_measurement(sps30_t *dev, sps30_measurement_t *measurement)
+{
+    ESP_RETURN_ON_FALSE(dev && measurement, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(dev->initialized, ESP_ERR_INVALID_STATE, TAG, "device not initialized");
+    ESP_RETURN_ON_FALSE(dev->measuring, ESP_ERR_INVALID_STATE, TAG, "not measuring");
+
+    uint16_t words[SPS30_VALUE_COUNT * 2];
+    esp_err_t err = sps30_read_cmd(dev, SPS30_CMD_READ_VALUES, words, sps30_value_words(dev->config.output_format));
+    if (err == ESP_ERR_INVALID_CRC) {
+        ESP_LOGE(TAG, "crc mismatch in measurement");
+    }
+    ESP_RETURN_ON_ERROR(err, TAG, "read measurement failed");
+
+    sps30_decode_measurement(words, dev->config.output_format, measurement);
+    return ESP_OK;
+}
+
+esp_err_t sps30_poll(sps30_t *dev, sps30_measurement_t *measurement, bool *fresh)
+{
+    ESP_RETURN_ON_FALSE(fresh, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    *fresh = false;
+    bool ready = false;
+    ESP_RETURN_ON_ERROR(sps30_read_data_ready(dev, &ready), TAG, "poll failed");
+    if (!ready) {
+        return ESP_OK;
+    }
+    ESP_RETURN_ON_ERROR(sps30_read_measurement(dev, measurement), TAG, "poll failed");
+    *fresh = true;
+    return ESP_OK;
+}
+
+esp_err_t sps30_start_fan_cleaning(sps30_t *dev)
+{
+    ESP_RETURN_ON_FALSE(dev, ESP_ERR_INVALID_ARG, TAG, "dev is null");
+    ESP_RETURN_ON_FALSE(dev->initialized, ESP_ERR_INVALID_STATE, TAG, "device not initialized");
+    // Only accepted while measuring; the fan runs at full speed for 10 s
+    ESP_RETURN_ON_FALSE(dev->measuring, ESP_ERR_INVALID_STATE, TAG, "not measuring");
+
+    return sensirion_write_cmd(dev->i2c_dev, SPS30_CMD_START_FAN_CLEANING, SPS30_I2C_TIMEOUT_MS);
+}
+
+esp_err_t sps30_get_auto_cleaning_interval(sps30_t *dev, uint32_t *interval_s)
+{
+    ESP_RETURN_ON_FALSE(dev && interval_s, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(dev->initialized, ESP_ERR_INVALID_STATE, TAG, "device not initialized");
+
+    uint16_t words[2];
+    ESP_RETURN_ON_ERROR(sps30_read_cmd(dev, SPS30_CMD_AUTO_CLEAN, words, 2), TAG, "read auto clean failed");
+    *interval_s = ((uint32_t)words[0] << 16) | words[1];
+    return ESP_OK;
+}
+
+esp_err_t sps30_set_auto_cleaning_interval(sps30_t *dev, uint32_t interval_s)
+{
+    ESP_RETURN_ON_FALSE(dev, ESP_ERR_INVALID_ARG, TAG, "dev is null");
+    ESP_RETURN_ON_FALSE(dev->initialized, ESP_ERR_INVALID_STATE, TAG, "device not initialized");
+
+    // Stored in the sensor's flash and kept across power cycles; 0 disables it
+    uint16_t args[2] = {(uint16_t)(interval_s >> 16), (uint16_t)(interval_s & 0xFFFF)};
+    ESP_RETURN_ON_ERROR(sensirion_write_cmd_args(dev->i2c_dev, SPS30_CMD_AUTO_CLEAN, args, 2,
+                                                 SPS30_I2C_TIMEOUT_MS), TAG, "write auto clean failed");
+    vTaskDelay(pdMS_TO_TICKS(SPS30_CMD_EXEC_MS));
+    return ESP_OK;
+}
+
+esp_err_t sps30_deinit(sps30_t *dev)
+{
+    ESP_RETURN_ON_FALSE(dev, ESP_ERR_INVALID_ARG, TAG, "dev is null");
+    if (!dev->initialized) {
+        return ESP_OK;
+    }
+    if (dev->measuring) {
+        sps30_stop_measurement(dev);
+    }
+    // Remove device from bus if it was added
+    if (dev->i2c_dev != NULL) {
+        i2c_master_bus_rm_device(dev->i2c_dev);
+        dev->i2c_dev = NULL;
+    }
+    dev->initialized = false;
+    dev->measuring = false;
+    return ESP_OK;
+}
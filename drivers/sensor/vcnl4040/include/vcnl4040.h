@@ -3,10 +3,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include "esp_err.h"
-// Use i2c_port_t from HAL to avoid including old driver/i2c.h (conflicts with driver_ng)
-#include "hal/i2c_types.h"
-#include "driver/gpio.h"
-#include "../../i2c_master_compat.h"  // For i2c_master_dev_handle_t
+#include "driver/i2c_master.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -15,6 +12,15 @@ extern "C" {
 #define VCNL4040_DEFAULT_ADDR        0x60
 #define VCNL4040_I2C_TIMEOUT_MS      1000
 
+// ALS resolution at the driver's 160 ms integration time
+#define VCNL4040_LUX_PER_COUNT       0.05f
+
+// Bits returned by vcnl4040_read_int_flags()
+#define VCNL4040_INT_PS_AWAY         (1 << 0)
+#define VCNL4040_INT_PS_CLOSE        (1 << 1)
+#define VCNL4040_INT_ALS_HIGH        (1 << 4)
+#define VCNL4040_INT_ALS_LOW         (1 << 5)
+
 typedef enum {
     VCNL4040_PROX_RATE_1_95_SPS = 0,
     VCNL4040_PROX_RATE_3_9_SPS,
@@ -27,10 +33,6 @@ typedef enum {
 } vcnl4040_prox_rate_t;
 
 typedef struct {
-    i2c_port_t i2c_port;
-    gpio_num_t sda_io_num;
-    gpio_num_t scl_io_num;
-    uint32_t i2c_clk_speed_hz;
     uint8_t led_current_ma;
     vcnl4040_prox_rate_t prox_rate;
 } vcnl4040_config_t;
@@ -38,13 +40,45 @@ typedef struct {
 typedef struct {
     vcnl4040_config_t config;
     bool initialized;
-    i2c_master_dev_handle_t i2c_dev;  // Device handle for new I2C API
+    i2c_master_dev_handle_t i2c_dev;
+    uint16_t als_conf;                // Shadow of ALS_CONF, for toggling the interrupt
+    uint16_t ps_conf;                 // Shadow of PS_CONF1/PS_CONF2
 } vcnl4040_t;
 
+/**
+ * @brief Configure ALS and PS and set the LED current.
+ *
+ * Set dev->i2c_dev to a device already on the bus. vcnl4040_deinit()
+ * removes it from the bus, but only after a successful init.
+ */
 esp_err_t vcnl4040_init(vcnl4040_t *dev, const vcnl4040_config_t *config);
 esp_err_t vcnl4040_read_ambient_lux(vcnl4040_t *dev, uint16_t *lux_raw);
 esp_err_t vcnl4040_read_proximity(vcnl4040_t *dev, uint16_t *proximity_raw);
 esp_err_t vcnl4040_set_led_current(vcnl4040_t *dev, uint8_t led_current_ma);
+
+/**
+ * @brief Raise the ALS interrupt when a reading leaves [low, high], in raw counts.
+ */
+esp_err_t vcnl4040_set_als_thresholds(vcnl4040_t *dev, uint16_t low, uint16_t high);
+
+/**
+ * @brief Raise the PS interrupt on rising above high (close) and falling
+ *        below low (away); the gap between them is the hysteresis.
+ */
+esp_err_t vcnl4040_set_ps_thresholds(vcnl4040_t *dev, uint16_t low, uint16_t high);
+
+/**
+ * @brief Drive the open-drain INT pin low on threshold events.
+ *
+ * Set the thresholds first. The pin stays low until the flags are read.
+ */
+esp_err_t vcnl4040_enable_interrupts(vcnl4040_t *dev, bool als, bool ps);
+
+/**
+ * @brief Read and clear the pending VCNL4040_INT_* flags; releases INT.
+ */
+esp_err_t vcnl4040_read_int_flags(vcnl4040_t *dev, uint8_t *flags);
+
 esp_err_t vcnl4040_deinit(vcnl4040_t *dev);
 
 #ifdef __cplusplus
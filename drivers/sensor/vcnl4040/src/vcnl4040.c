@@ -1,5 +1,4 @@
 #include "vcnl4040.h"
-#include "../../i2c_master_compat.h"  // For i2c_master_write_to_device, i2c_master_write_read_device
 
 #include <string.h>
 #include "esp_check.h"
@@ -10,37 +9,47 @@
 
 static const char *TAG = "vcnl4040";
 
+// Every register is a 16-bit word, sent and read low byte first. Registers
+// the datasheet splits in two (PS_CONF1/2, PS_CONF3/PS_MS) share one word:
+// the low byte is the first name, the high byte the second
 #define VCNL4040_REG_ALS_CONF        0x00
 #define VCNL4040_REG_ALS_THDH        0x01
 #define VCNL4040_REG_ALS_THDL        0x02
 #define VCNL4040_REG_PS_CONF1_2      0x03
-#define VCNL4040_REG_PS_CONF3        0x04
-#define VCNL4040_REG_PS_MS           0x05
-#define VCNL4040_REG_PS_CANC         0x06
-#define VCNL4040_REG_PS_THDL         0x07
-#define VCNL4040_REG_PS_THDH         0x08
+#define VCNL4040_REG_PS_CONF3_MS     0x04
+#define VCNL4040_REG_PS_CANC         0x05
+#define VCNL4040_REG_PS_THDL         0x06
+#define VCNL4040_REG_PS_THDH         0x07
 #define VCNL4040_REG_PS_DATA         0x08
 #define VCNL4040_REG_ALS_DATA        0x09
+#define VCNL4040_REG_INT_FLAG        0x0B
 
-#define VCNL4040_ALS_IT_80MS         (0x01 << 6)
-#define VCNL4040_ALS_PERS_1          (0x00 << 4)
-#define VCNL4040_ALS_ACTIVE          (1 << 0)
+// ALS_CONF; ALS_SD (bit 0) left clear keeps the ALS powered
+#define VCNL4040_ALS_IT_160MS        (0x01 << 6)
+#define VCNL4040_ALS_PERS_1          (0x00 << 2)
+#define VCNL4040_ALS_INT_EN          (1 << 1)
 
+// PS_CONF1 in the low byte, PS_CONF2 in the high byte; PS_SD (bit 0) clear
 #define VCNL4040_PS_PERS_1           (0x00 << 4)
-#define VCNL4040_PS_ACTIVE           (1 << 0)
+#define VCNL4040_PS_IT_SHIFT         1
+#define VCNL4040_PS_INT_CLOSE_AWAY   (0x03 << 8)
+#define VCNL4040_PS_INT_MASK         (0x03 << 8)
+
+// PS_MS in the high byte of 0x04
 #define VCNL4040_LED_I_SHIFT         8
 
-__attribute__((weak)) esp_err_t vcnl4040_i2c_transfer(i2c_port_t port,
-                                                      uint8_t addr,
+// The unit test overrides this with a table of the command codes
+__attribute__((weak)) esp_err_t vcnl4040_i2c_transfer(i2c_master_dev_handle_t i2c_dev,
                                                       const uint8_t *write_buf,
                                                       size_t write_size,
                                                       uint8_t *read_buf,
                                                       size_t read_size,
-                                                      TickType_t ticks_to_wait)
+                                                      int timeout_ms)
 {
-    // This weak function is overridden in sensor_integration.c
-    // It should not be called directly - use the device handle instead
-    return ESP_ERR_NOT_SUPPORTED;
+    if (read_size == 0) {
+        return i2c_master_transmit(i2c_dev, write_buf, write_size, timeout_ms);
+    }
+    return i2c_master_transmit_receive(i2c_dev, write_buf, write_size, read_buf, read_size, timeout_ms);
 }
 
 static esp_err_t vcnl4040_write_reg(vcnl4040_t *dev, uint8_t reg, uint16_t value)
@@ -50,10 +59,10 @@ static esp_err_t vcnl4040_write_reg(vcnl4040_t *dev, uint8_t reg, uint16_t value
     }
     uint8_t buf[3] = {
         reg,
-        (uint8_t)(value >> 8),
-        (uint8_t)(value & 0xFF)
+        (uint8_t)(value & 0xFF),
+        (uint8_t)(value >> 8)
     };
-    return i2c_master_transmit(dev->i2c_dev, buf, sizeof(buf), pdMS_TO_TICKS(VCNL4040_I2C_TIMEOUT_MS));
+    return vcnl4040_i2c_transfer(dev->i2c_dev, buf, sizeof(buf), NULL, 0, VCNL4040_I2C_TIMEOUT_MS);
 }
 
 static esp_err_t vcnl4040_read_reg(vcnl4040_t *dev, uint8_t reg, uint16_t *value)
@@ -63,10 +72,10 @@ static esp_err_t vcnl4040_read_reg(vcnl4040_t *dev, uint8_t reg, uint16_t *value
     }
     uint8_t reg_addr = reg;
     uint8_t buf[2] = {0};
-    esp_err_t err = i2c_master_transmit_receive(dev->i2c_dev, &reg_addr, sizeof(reg_addr),
-                                                 buf, sizeof(buf), pdMS_TO_TICKS(VCNL4040_I2C_TIMEOUT_MS));
+    esp_err_t err = vcnl4040_i2c_transfer(dev->i2c_dev, &reg_addr, sizeof(reg_addr),
+                                          buf, sizeof(buf), VCNL4040_I2C_TIMEOUT_MS);
     ESP_RETURN_ON_ERROR(err, TAG, "read register failed");
-    *value = ((uint16_t)buf[0] << 8) | buf[1];
+    *value = ((uint16_t)buf[1] << 8) | buf[0];
     return ESP_OK;
 }
 
@@ -74,20 +83,20 @@ esp_err_t vcnl4040_init(vcnl4040_t *dev, const vcnl4040_config_t *config)
 {
     ESP_RETURN_ON_FALSE(dev && config, ESP_ERR_INVALID_ARG, TAG, "invalid arguments");
     memcpy(&dev->config, config, sizeof(vcnl4040_config_t));
-    dev->i2c_dev = NULL;  // Will be set by sensor_integration.c
-
-    // I2C bus should already be initialized by sensor_integration.c using new API
-    // Device handle will be created and stored by sensor_integration.c
-
-    uint16_t als_conf = VCNL4040_ALS_IT_80MS | VCNL4040_ALS_PERS_1 | VCNL4040_ALS_ACTIVE;
-    ESP_RETURN_ON_ERROR(vcnl4040_write_reg(dev, VCNL4040_REG_ALS_CONF, als_conf), TAG, "als config failed");
 
-    uint16_t ps_conf1_2 = (config->prox_rate << 1) | VCNL4040_PS_PERS_1 | VCNL4040_PS_ACTIVE;
-    ESP_RETURN_ON_ERROR(vcnl4040_write_reg(dev, VCNL4040_REG_PS_CONF1_2, ps_conf1_2), TAG, "ps config failed");
+    dev->als_conf = VCNL4040_ALS_IT_160MS | VCNL4040_ALS_PERS_1;
+    ESP_RETURN_ON_ERROR(vcnl4040_write_reg(dev, VCNL4040_REG_ALS_CONF, dev->als_conf), TAG, "als config failed");
 
-    ESP_RETURN_ON_ERROR(vcnl4040_set_led_current(dev, config->led_current_ma), TAG, "led current set failed");
+    dev->ps_conf = ((config->prox_rate & 0x07) << VCNL4040_PS_IT_SHIFT) | VCNL4040_PS_PERS_1;
+    ESP_RETURN_ON_ERROR(vcnl4040_write_reg(dev, VCNL4040_REG_PS_CONF1_2, dev->ps_conf), TAG, "ps config failed");
 
     dev->initialized = true;
+    esp_err_t err = vcnl4040_set_led_current(dev, config->led_current_ma);
+    if (err != ESP_OK) {
+        dev->initialized = false;
+        ESP_LOGE(TAG, "led current set failed: %s", esp_err_to_name(err));
+        return err;
+    }
     return ESP_OK;
 }
 
@@ -110,11 +119,56 @@ esp_err_t vcnl4040_set_led_current(vcnl4040_t *dev, uint8_t led_current_ma)
     ESP_RETURN_ON_FALSE(dev, ESP_ERR_INVALID_ARG, TAG, "dev null");
     ESP_RETURN_ON_FALSE(dev->initialized, ESP_ERR_INVALID_STATE, TAG, "not initialized");
 
-    if (led_current_ma > 200) {
-        led_current_ma = 200;
+    // LED_I steps; the highest one not above the request, 50 mA at least
+    static const uint8_t kLedCurrentMa[] = {50, 75, 100, 120, 140, 160, 180, 200};
+    uint16_t code = 0;
+    for (uint16_t i = 1; i < sizeof(kLedCurrentMa); ++i) {
+        if (led_current_ma >= kLedCurrentMa[i]) {
+            code = i;
+        }
     }
-    uint16_t value = ((uint16_t)led_current_ma << VCNL4040_LED_I_SHIFT);
-    return vcnl4040_write_reg(dev, VCNL4040_REG_PS_MS, value);
+    uint16_t value = code << VCNL4040_LED_I_SHIFT;
+    return vcnl4040_write_reg(dev, VCNL4040_REG_PS_CONF3_MS, value);
+}
+
+esp_err_t vcnl4040_set_als_thresholds(vcnl4040_t *dev, uint16_t low, uint16_t high)
+{
+    ESP_RETURN_ON_FALSE(dev && low <= high, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(dev->initialized, ESP_ERR_INVALID_STATE, TAG, "not initialized");
+    ESP_RETURN_ON_ERROR(vcnl4040_write_reg(dev, VCNL4040_REG_ALS_THDL, low), TAG, "als low threshold failed");
+    return vcnl4040_write_reg(dev, VCNL4040_REG_ALS_THDH, high);
+}
+
+esp_err_t vcnl4040_set_ps_thresholds(vcnl4040_t *dev, uint16_t low, uint16_t high)
+{
+    ESP_RETURN_ON_FALSE(dev && low <= high, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(dev->initialized, ESP_ERR_INVALID_STATE, TAG, "not initialized");
+    ESP_RETURN_ON_ERROR(vcnl4040_write_reg(dev, VCNL4040_REG_PS_THDL, low), TAG, "ps low threshold failed");
+    return vcnl4040_write_reg(dev, VCNL4040_REG_PS_THDH, high);
+}
+
+esp_err_t vcnl4040_enable_interrupts(vcnl4040_t *dev, bool als, bool ps)
+{
+    ESP_RETURN_ON_FALSE(dev, ESP_ERR_INVALID_ARG, TAG, "dev null");
+    ESP_RETURN_ON_FALSE(dev->initialized, ESP_ERR_INVALID_STATE, TAG, "not initialized");
+
+    uint16_t als_conf = als ? (dev->als_conf | VCNL4040_ALS_INT_EN) : (dev->als_conf & ~VCNL4040_ALS_INT_EN);
+    uint16_t ps_conf = (dev->ps_conf & ~VCNL4040_PS_INT_MASK) | (ps ? VCNL4040_PS_INT_CLOSE_AWAY : 0);
+    ESP_RETURN_ON_ERROR(vcnl4040_write_reg(dev, VCNL4040_REG_ALS_CONF, als_conf), TAG, "als interrupt failed");
+    dev->als_conf = als_conf;
+    ESP_RETURN_ON_ERROR(vcnl4040_write_reg(dev, VCNL4040_REG_PS_CONF1_2, ps_conf), TAG, "ps interrupt failed");
+    dev->ps_conf = ps_conf;
+    return ESP_OK;
+}
+
+esp_err_t vcnl4040_read_int_flags(vcnl4040_t *dev, uint8_t *flags)
+{
+    ESP_RETURN_ON_FALSE(dev && flags, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(dev->initialized, ESP_ERR_INVALID_STATE, TAG, "not initialized");
+    uint16_t value = 0;
+    ESP_RETURN_ON_ERROR(vcnl4040_read_reg(dev, VCNL4040_REG_INT_FLAG, &value), TAG, "int flag read failed");
+    *flags = (uint8_t)(value >> 8);
+    return ESP_OK;
 }
 
 esp_err_t vcnl4040_deinit(vcnl4040_t *dev)
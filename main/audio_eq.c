@@ -0,0 +1,190 @@
+#include "audio_eq.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "sdkconfig.h"
+
+// ESP-DSP runs the biquads on the S3's SIMD unit; the plain loop matches it
+#ifdef CONFIG_DSP_ENABLED
+#include "dsps_biquad.h"
+#define USE_ESP_DSP_BIQUAD 1
+#else
+#define USE_ESP_DSP_BIQUAD 0
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// One channel at a time; only the audio output task filters
+static float s_left[AUDIO_EQ_BLOCK_FRAMES] __attribute__((aligned(16)));
+static float s_right[AUDIO_EQ_BLOCK_FRAMES] __attribute__((aligned(16)));
+
+static void biquad_run(const float *coef, float *w, float *buf, size_t n)
+{
+#if USE_ESP_DSP_BIQUAD
+    dsps_biquad_f32(buf, buf, (int)n, (float *)coef, w);
+#else
+    // Direct form II, same state layout as dsps_biquad_f32
+    for (size_t i = 0; i < n; ++i) {
+        float d0 = buf[i] - coef[3] * w[0] - coef[4] * w[1];
+        buf[i] = coef[0] * d0 + coef[1] * w[0] + coef[2] * w[1];
+        w[1] = w[0];
+        w[0] = d0;
+    }
+#endif
+}
+
+static float clamp_hz(int rate_hz, float hz)
+{
+    float nyquist = rate_hz * 0.45f;
+    return hz < 10.0f ? 10.0f : (hz > nyquist ? nyquist : hz);
+}
+
+static void normalise(float coef[5], float b0, float b1, float b2, float a0, float a1, float a2)
+{
+    coef[0] = b0 / a0;
+    coef[1] = b1 / a0;
+    coef[2] = b2 / a0;
+    coef[3] = a1 / a0;
+    coef[4] = a2 / a0;
+}
+
+void audio_eq_design_highpass(float coef[5], int rate_hz, float hz, float q)
+{
+    float w0 = 2.0f * (float)M_PI * clamp_hz(rate_hz, hz) / rate_hz;
+    float cw = cosf(w0);
+    float alpha = sinf(w0) / (2.0f * q);
+    normalise(coef, (1.0f + cw) / 2.0f, -(1.0f + cw), (1.0f + cw) / 2.0f, 1.0f + alpha, -2.0f * cw, 1.0f - alpha);
+}
+
+void audio_eq_design_lowpass(float coef[5], int rate_hz, float hz, float q)
+{
+    float w0 = 2.0f * (float)M_PI * clamp_hz(rate_hz, hz) / rate_hz;
+    float cw = cosf(w0);
+    float alpha = sinf(w0) / (2.0f * q);
+    normalise(coef, (1.0f - cw) / 2.0f, 1.0f - cw, (1.0f - cw) / 2.0f, 1.0f + alpha, -2.0f * cw, 1.0f - alpha);
+}
+
+// Shelf slope S = 1
+static void design_shelf(float coef[5], int rate_hz, float hz, float gain_db, bool low)
+{
+    float a = powf(10.0f, gain_db / 40.0f);
+    float w0 = 2.0f * (float)M_PI * clamp_hz(rate_hz, hz) / rate_hz;
+    float cw = cosf(w0);
+    float alpha = sinf(w0) / 2.0f * sqrtf(2.0f);
+    float k = 2.0f * sqrtf(a) * alpha;
+    if (low) {
+        normalise(coef, a * ((a + 1) - (a - 1) * cw + k), 2 * a * ((a - 1) - (a + 1) * cw),
+                  a * ((a + 1) - (a - 1) * cw - k), (a + 1) + (a - 1) * cw + k, -2 * ((a - 1) + (a + 1) * cw),
+                  (a + 1) + (a - 1) * cw - k);
+    } else {
+        normalise(coef, a * ((a + 1) + (a - 1) * cw + k), -2 * a * ((a - 1) + (a + 1) * cw),
+                  a * ((a + 1) + (a - 1) * cw - k), (a + 1) - (a - 1) * cw + k, 2 * ((a - 1) - (a + 1) * cw),
+                  (a + 1) - (a - 1) * cw - k);
+    }
+}
+
+void audio_eq_design_low_shelf(float coef[5], int rate_hz, float hz, float gain_db)
+{
+    design_shelf(coef, rate_hz, hz, gain_db, true);
+}
+
+void audio_eq_design_high_shelf(float coef[5], int rate_hz, float hz, float gain_db)
+{
+    design_shelf(coef, rate_hz, hz, gain_db, false);
+}
+
+void audio_eq_init_speaker(audio_eq_chain_t *chain, int rate_hz)
+{
+    memset(chain, 0, sizeof(*chain));
+    audio_eq_design_highpass(chain->stage[0].coef, rate_hz, AUDIO_EQ_HIGHPASS_HZ, 0.707f);
+    audio_eq_design_high_shelf(chain->stage[1].coef, rate_hz, AUDIO_EQ_TREBLE_HZ, AUDIO_EQ_TREBLE_DB);
+    chain->count = 2;
+}
+
+float audio_eq_loudness_db(int volume_percent)
+{
+    if (volume_percent < 0) {
+        volume_percent = 0;
+    } else if (volume_percent > 100) {
+        volume_percent = 100;
+    }
+    return AUDIO_EQ_LOUDNESS_MAX_DB * (100 - volume_percent) / 100.0f;
+}
+
+void audio_eq_set_loudness(audio_eq_chain_t *chain, int rate_hz, int volume_percent)
+{
+    audio_eq_design_high_shelf(chain->stage[0].coef, rate_hz, AUDIO_EQ_LOUDNESS_HZ,
+                               -audio_eq_loudness_db(volume_percent));
+    chain->count = 1;
+}
+
+void audio_eq_reset(audio_eq_chain_t *chain)
+{
+    for (size_t i = 0; i < AUDIO_EQ_MAX_STAGES; ++i) {
+        memset(chain->stage[i].w, 0, sizeof(chain->stage[i].w));
+    }
+}
+
+static void run_chain(audio_eq_chain_t *chain, size_t n)
+{
+    for (size_t s = 0; s < chain->count; ++s) {
+        audio_eq_biquad_t *bq = &chain->stage[s];
+        biquad_run(bq->coef, bq->w[0], s_left, n);
+        biquad_run(bq->coef, bq->w[1], s_right, n);
+    }
+}
+
+static int16_t to_i16(float v)
+{
+    if (v >= 32767.0f) {
+        return INT16_MAX;
+    }
+    if (v <= -32768.0f) {
+        return INT16_MIN;
+    }
+    return (int16_t)lrintf(v);
+}
+
+void audio_eq_process_i16(audio_eq_chain_t *chain, int16_t *frames, size_t frame_count)
+{
+    if (chain->count == 0) {
+        return;
+    }
+    while (frame_count > 0) {
+        size_t n = frame_count < AUDIO_EQ_BLOCK_FRAMES ? frame_count : AUDIO_EQ_BLOCK_FRAMES;
+        for (size_t i = 0; i < n; ++i) {
+            s_left[i] = frames[2 * i];
+            s_right[i] = frames[2 * i + 1];
+        }
+        run_chain(chain, n);
+        for (size_t i = 0; i < n; ++i) {
+            frames[2 * i] = to_i16(s_left[i]);
+            frames[2 * i + 1] = to_i16(s_right[i]);
+        }
+        frames += n * 2;
+        frame_count -= n;
+    }
+}
+
+void audio_eq_process_i32(audio_eq_chain_t *chain, const int32_t *in, int16_t *out, size_t frame_count)
+{
+    while (frame_count > 0) {
+        size_t n = frame_count < AUDIO_EQ_BLOCK_FRAMES ? frame_count : AUDIO_EQ_BLOCK_FRAMES;
+        for (size_t i = 0; i < n; ++i) {
+            s_left[i] = (float)in[2 * i];
+            s_right[i] = (float)in[2 * i + 1];
+        }
+        run_chain(chain, n);
+        for (size_t i = 0; i < n; ++i) {
+            out[2 * i] = to_i16(s_left[i]);
+            out[2 * i + 1] = to_i16(s_right[i]);
+        }
+        in += n * 2;
+        out += n * 2;
+        frame_count -= n;
+    }
+}
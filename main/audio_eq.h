@@ -0,0 +1,84 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Biquads per chain
+#define AUDIO_EQ_MAX_STAGES 4
+
+// Frames per call to the process functions; longer blocks are split
+#define AUDIO_EQ_BLOCK_FRAMES 256
+
+// Speaker voicing on the final mix. The small driver can't move air below
+// the high-pass, so that energy only costs headroom and distortion; the
+// shelf lifts the top a little against the grille.
+#ifndef AUDIO_EQ_HIGHPASS_HZ
+#define AUDIO_EQ_HIGHPASS_HZ 120
+#endif
+
+#ifndef AUDIO_EQ_TREBLE_HZ
+#define AUDIO_EQ_TREBLE_HZ 6000
+#endif
+
+#ifndef AUDIO_EQ_TREBLE_DB
+#define AUDIO_EQ_TREBLE_DB 2.0f
+#endif
+
+// Loudness: bass lifted by up to this much as the volume falls, since the
+// ear loses low frequencies faster than mids at low levels
+#ifndef AUDIO_EQ_LOUDNESS_HZ
+#define AUDIO_EQ_LOUDNESS_HZ 250
+#endif
+
+#ifndef AUDIO_EQ_LOUDNESS_MAX_DB
+#define AUDIO_EQ_LOUDNESS_MAX_DB 9.0f
+#endif
+
+// Coefficients in ESP-DSP order: b0, b1, b2, a1, a2 (a0 normalised to 1)
+typedef struct {
+    float coef[5];
+    float w[2][2];                    // Per-channel delay line
+} audio_eq_biquad_t;
+
+// Stereo cascade of biquads; zero-initialised it passes audio through
+typedef struct {
+    audio_eq_biquad_t stage[AUDIO_EQ_MAX_STAGES];
+    size_t count;
+} audio_eq_chain_t;
+
+// RBJ cookbook designs; hz is clamped below Nyquist
+void audio_eq_design_highpass(float coef[5], int rate_hz, float hz, float q);
+void audio_eq_design_lowpass(float coef[5], int rate_hz, float hz, float q);
+void audio_eq_design_low_shelf(float coef[5], int rate_hz, float hz, float gain_db);
+void audio_eq_design_high_shelf(float coef[5], int rate_hz, float hz, float gain_db);
+
+// HPF and treble shelf at AUDIO_EQ_* for the output rate
+void audio_eq_init_speaker(audio_eq_chain_t *chain, int rate_hz);
+
+// Bass lift for a listening level: none at 100 %, AUDIO_EQ_LOUDNESS_MAX_DB at 0 %
+float audio_eq_loudness_db(int volume_percent);
+
+/**
+ * Loudness as one shelf that cuts everything above AUDIO_EQ_LOUDNESS_HZ by
+ * audio_eq_loudness_db(); the caller makes that up in the stream gain, so
+ * the bass comes up relative to the rest without eating headroom before
+ * the volume is applied. Keeps the delay line, so it can be retuned
+ * between blocks without a click.
+ */
+void audio_eq_set_loudness(audio_eq_chain_t *chain, int rate_hz, int volume_percent);
+
+void audio_eq_reset(audio_eq_chain_t *chain);
+
+// Filter interleaved stereo in place
+void audio_eq_process_i16(audio_eq_chain_t *chain, int16_t *frames, size_t frame_count);
+
+// Filter an interleaved stereo mix bus and saturate it to 16 bits
+void audio_eq_process_i32(audio_eq_chain_t *chain, const int32_t *in, int16_t *out, size_t frame_count);
+
+#ifdef __cplusplus
+}
+#endif
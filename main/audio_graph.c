@@ -0,0 +1,245 @@
+#include "audio_graph.h"
+
+#include <stdbool.h>
+#include <string.h>
+
+#include "deadline_monitor.h"
+#include "esp_check.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "task_placement.h"
+
+static const char *TAG = "audio_graph";
+
+#define CAPTURE (-1)
+
+typedef enum {
+    WORKER_AUDIO,
+    WORKER_AUX,
+    WORKER_COUNT,
+} worker_id_t;
+
+typedef struct {
+    const char *name;                 // Also the node's deadline stage
+    worker_id_t worker;
+    int8_t input;                     // CAPTURE or the node feeding it, on the same worker and earlier
+} plan_t;
+
+static const plan_t PLAN[AUDIO_GRAPH_NODE_COUNT] = {
+    [AUDIO_GRAPH_NODE_MIC_METER] = {"mic_meter", WORKER_AUDIO, CAPTURE},
+    [AUDIO_GRAPH_NODE_WAKE_ENERGY] = {"wake_word", WORKER_AUDIO, CAPTURE},
+    [AUDIO_GRAPH_NODE_AFE] = {"afe", WORKER_AUDIO, CAPTURE},
+    [AUDIO_GRAPH_NODE_RAW_UPLINK] = {"raw_uplink", WORKER_AUDIO, CAPTURE},
+    [AUDIO_GRAPH_NODE_DOWNMIX] = {"downmix", WORKER_AUX, CAPTURE},
+    [AUDIO_GRAPH_NODE_SPECTRUM] = {"spectrum", WORKER_AUX, AUDIO_GRAPH_NODE_DOWNMIX},
+};
+
+static const task_placement_id_t WORKER_PLACEMENT[WORKER_COUNT] = {
+    [WORKER_AUDIO] = TASK_PLACEMENT_AUDIO_GRAPH,
+    [WORKER_AUX] = TASK_PLACEMENT_AUDIO_GRAPH_AUX,
+};
+
+typedef struct {
+    audio_graph_node_config_t cfg;
+    int16_t *owned;                   // cfg.buffer when the graph allocated it
+    size_t fill;                      // Samples of the current block assembled
+    uint32_t pos;
+    uint32_t blocks;
+    deadline_monitor_stage_t *deadline;
+    bool attached;                    // Changed under the worker's lock
+} node_t;
+
+typedef struct {
+    worker_id_t id;
+    korvo_audio_reader_t *reader;
+    int16_t *quantum;
+    SemaphoreHandle_t lock;           // Held over each quantum; attach and detach wait for it
+    TaskHandle_t task;
+    uint32_t attached;                // Nodes attached (atomic); the worker idles at 0
+    uint32_t quanta;
+} worker_t;
+
+static node_t s_nodes[AUDIO_GRAPH_NODE_COUNT];
+static worker_t s_workers[WORKER_COUNT];
+static korvo_audio_t *s_audio;
+
+static void node_feed(audio_graph_node_id_t id, const int16_t *samples, size_t count, uint32_t pos, bool capture)
+{
+    node_t *node = &s_nodes[id];
+    size_t block = node->cfg.block_samples;
+    while (count > 0) {
+        if (node->fill == 0) {
+            node->pos = pos;
+        }
+        size_t take = block - node->fill;
+        if (take > count) {
+            take = count;
+        }
+        memcpy(node->cfg.buffer + node->fill, samples, take * sizeof(int16_t));
+        node->fill += take;
+        samples += take;
+        count -= take;
+        // Capture positions are sample indexes; a derived edge keeps its producer's
+        pos += capture ? (uint32_t)take : 0;
+        if (node->fill == block) {
+            const audio_graph_block_t out = {
+                .samples = node->cfg.buffer,
+                .count = block,
+                .pos = node->pos,
+            };
+            node->fill = 0;
+            deadline_monitor_begin(node->deadline);
+            node->cfg.process(node->cfg.ctx, &out);
+            deadline_monitor_end(node->deadline);
+            node->blocks++;
+        }
+    }
+}
+
+static void worker_task(void *arg)
+{
+    worker_t *worker = (worker_t *)arg;
+    while (true) {
+        if (__atomic_load_n(&worker->attached, __ATOMIC_ACQUIRE) == 0) {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            // Whatever piled up while nothing listened is stale
+            korvo_audio_reader_sync(worker->reader);
+            continue;
+        }
+        size_t got = 0;
+        if (korvo_audio_read(worker->reader, worker->quantum, CONFIG_KVA_AUDIO_GRAPH_QUANTUM_SAMPLES, &got,
+                             pdMS_TO_TICKS(100)) != ESP_OK || got == 0) {
+            continue;
+        }
+        uint32_t pos = worker->reader->read_pos - (uint32_t)got;
+        xSemaphoreTake(worker->lock, portMAX_DELAY);
+        for (int i = 0; i < AUDIO_GRAPH_NODE_COUNT; ++i) {
+            if (PLAN[i].worker == worker->id && PLAN[i].input == CAPTURE && s_nodes[i].attached) {
+                node_feed((audio_graph_node_id_t)i, worker->quantum, got, pos, true);
+            }
+        }
+        xSemaphoreGive(worker->lock);
+        worker->quanta++;
+    }
+}
+
+esp_err_t audio_graph_init(korvo_audio_t *audio)
+{
+    ESP_RETURN_ON_FALSE(audio, ESP_ERR_INVALID_ARG, TAG, "audio");
+    ESP_RETURN_ON_FALSE(!s_audio, ESP_ERR_INVALID_STATE, TAG, "already running");
+    for (int i = 0; i < AUDIO_GRAPH_NODE_COUNT; ++i) {
+        int input = PLAN[i].input;
+        ESP_RETURN_ON_FALSE(input == CAPTURE || (input < i && PLAN[input].worker == PLAN[i].worker),
+                            ESP_ERR_INVALID_STATE, TAG, "%s: input must run before it on its worker", PLAN[i].name);
+    }
+    static const char *const READER_NAMES[WORKER_COUNT] = {"graph", "graph_aux"};
+    for (int w = 0; w < WORKER_COUNT; ++w) {
+        worker_t *worker = &s_workers[w];
+        worker->id = (worker_id_t)w;
+        worker->quantum = heap_caps_malloc(CONFIG_KVA_AUDIO_GRAPH_QUANTUM_SAMPLES * sizeof(int16_t),
+                                           MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+        worker->lock = xSemaphoreCreateMutex();
+        ESP_RETURN_ON_FALSE(worker->quantum && worker->lock, ESP_ERR_NO_MEM, TAG, "worker %d", w);
+        ESP_RETURN_ON_ERROR(korvo_audio_open_reader(audio, READER_NAMES[w], &worker->reader), TAG, "reader");
+        ESP_RETURN_ON_FALSE(task_placement_create(WORKER_PLACEMENT[w], worker_task, worker, &worker->task) == pdPASS,
+                            ESP_ERR_NO_MEM, TAG, "worker %d task", w);
+    }
+    s_audio = audio;
+    return ESP_OK;
+}
+
+esp_err_t audio_graph_attach(audio_graph_node_id_t id, const audio_graph_node_config_t *config)
+{
+    ESP_RETURN_ON_FALSE(id < AUDIO_GRAPH_NODE_COUNT && config && config->process && config->block_samples,
+                        ESP_ERR_INVALID_ARG, TAG, "config");
+    ESP_RETURN_ON_FALSE(s_audio && !s_nodes[id].attached, ESP_ERR_INVALID_STATE, TAG, "%s: not attachable",
+                        PLAN[id].name);
+    worker_t *worker = &s_workers[PLAN[id].worker];
+
+    int16_t *owned = NULL;
+    if (!config->buffer) {
+        owned = heap_caps_malloc(config->block_samples * sizeof(int16_t), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+        ESP_RETURN_ON_FALSE(owned, ESP_ERR_NO_MEM, TAG, "%s: block", PLAN[id].name);
+    }
+    deadline_monitor_stage_t *deadline = NULL;
+    if (PLAN[id].input == CAPTURE) {
+        // Interleaved stereo: the block covers block_samples / 2 frames
+        const deadline_monitor_config_t stage = {
+            .name = PLAN[id].name,
+            .period_us = (uint32_t)((int64_t)config->block_samples / 2 * 1000000 / s_audio->sample_rate_hz),
+        };
+        deadline_monitor_register(&stage, &deadline);
+    }
+
+    xSemaphoreTake(worker->lock, portMAX_DELAY);
+    node_t *node = &s_nodes[id];
+    node->cfg = *config;
+    node->cfg.buffer = config->buffer ? config->buffer : owned;
+    node->owned = owned;
+    node->fill = 0;
+    node->deadline = deadline;
+    deadline_monitor_pause(deadline);  // A node attached again is not late for its first block
+    node->attached = true;
+    __atomic_add_fetch(&worker->attached, 1, __ATOMIC_RELEASE);
+    xSemaphoreGive(worker->lock);
+    xTaskNotifyGive(worker->task);
+    ESP_LOGI(TAG, "%s attached: %u-sample blocks on core %d", PLAN[id].name, (unsigned)config->block_samples,
+             task_placement_get(WORKER_PLACEMENT[PLAN[id].worker])->core);
+    return ESP_OK;
+}
+
+void audio_graph_detach(audio_graph_node_id_t id)
+{
+    if (id >= AUDIO_GRAPH_NODE_COUNT || !s_audio) {
+        return;
+    }
+    worker_t *worker = &s_workers[PLAN[id].worker];
+    xSemaphoreTake(worker->lock, portMAX_DELAY);
+    node_t *node = &s_nodes[id];
+    int16_t *owned = NULL;
+    if (node->attached) {
+        node->attached = false;
+        owned = node->owned;
+        node->owned = NULL;
+        __atomic_sub_fetch(&worker->attached, 1, __ATOMIC_RELEASE);
+    }
+    xSemaphoreGive(worker->lock);
+    heap_caps_free(owned);
+}
+
+void audio_graph_emit(audio_graph_node_id_t from, const int16_t *samples, size_t count, uint32_t pos)
+{
+    // Runs on the producer's worker with its lock held, like the consumers the plan gives it
+    for (int i = from + 1; i < AUDIO_GRAPH_NODE_COUNT; ++i) {
+        if (PLAN[i].input == (int)from && s_nodes[i].attached) {
+            node_feed((audio_graph_node_id_t)i, samples, count, pos, false);
+        }
+    }
+}
+
+void audio_graph_log(void)
+{
+    if (!s_audio) {
+        ESP_LOGI(TAG, "Not running");
+        return;
+    }
+    for (int w = 0; w < WORKER_COUNT; ++w) {
+        const worker_t *worker = &s_workers[w];
+        const task_placement_t *placement = task_placement_get(WORKER_PLACEMENT[w]);
+        ESP_LOGI(TAG, "%s on core %d: %lu nodes, %lu quanta, %lu overruns", placement->name, placement->core,
+                 (unsigned long)__atomic_load_n(&worker->attached, __ATOMIC_RELAXED), (unsigned long)worker->quanta,
+                 (unsigned long)worker->reader->overruns);
+        for (int i = 0; i < AUDIO_GRAPH_NODE_COUNT; ++i) {
+            if (PLAN[i].worker != (worker_id_t)w) {
+                continue;
+            }
+            const node_t *node = &s_nodes[i];
+            ESP_LOGI(TAG, "  %-11s <- %-9s %s block=%u blocks=%lu", PLAN[i].name,
+                     PLAN[i].input == CAPTURE ? "capture" : PLAN[PLAN[i].input].name,
+                     node->attached ? "on " : "off", (unsigned)node->cfg.block_samples, (unsigned long)node->blocks);
+        }
+    }
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "korvo_audio.h"
+#include "kva_config_defaults.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Block-based runtime for everything that consumes the microphones.
+ *
+ * Each stage is a node with a fixed block size. The static plan in
+ * audio_graph.c gives every node its worker and its input: the capture
+ * ring, or another node's output on the same worker. There is one worker
+ * per core, and each keeps a single read cursor into the capture ring
+ * (the edge every capture-fed node shares), reads it in
+ * CONFIG_KVA_AUDIO_GRAPH_QUANTUM_SAMPLES pieces and runs its nodes in plan
+ * order whenever their block fills. A node's block buffer is allocated
+ * when it is attached, so the data path never allocates; its latency is
+ * bounded by its block plus one quantum.
+ *
+ * Adding a consumer of audio means a row in the plan and a process
+ * callback, not another task with its own capture loop. Capture-fed nodes
+ * also get a deadline_monitor stage under their plan name, with the block
+ * as the period.
+ */
+typedef enum {
+    // Audio core, in run order
+    AUDIO_GRAPH_NODE_MIC_METER,       // audio_taps: LED levels and the serial link's audio tap
+    AUDIO_GRAPH_NODE_WAKE_ENERGY,     // wake_word_service: energy wake detector
+    AUDIO_GRAPH_NODE_AFE,             // voice_pipeline: AFE, WakeNet, VAD, MultiNet and the uplink
+    AUDIO_GRAPH_NODE_RAW_UPLINK,      // voice_pipeline: unprocessed capture to Gemini Live, without an AFE
+    // Network core
+    AUDIO_GRAPH_NODE_DOWNMIX,         // audio_taps: stereo to mono
+    AUDIO_GRAPH_NODE_SPECTRUM,        // audio_taps: mel frontend for the spectrum LEDs, fed by DOWNMIX
+    AUDIO_GRAPH_NODE_COUNT,
+} audio_graph_node_id_t;
+
+typedef struct {
+    const int16_t *samples;
+    size_t count;                     // Always the node's block_samples
+    uint32_t pos;                     // Capture ring index of the first sample (korvo_audio_sample_time_us)
+} audio_graph_block_t;
+
+typedef void (*audio_graph_process_t)(void *ctx, const audio_graph_block_t *block);
+
+typedef struct {
+    audio_graph_process_t process;
+    void *ctx;
+    size_t block_samples;             // Interleaved samples per call, in the input's channel layout
+    int16_t *buffer;                  // block_samples to assemble blocks in; NULL = allocated by the graph
+} audio_graph_node_config_t;
+
+// Open the workers' cursors into the capture ring; the workers idle until a node is attached
+esp_err_t audio_graph_init(korvo_audio_t *audio);
+
+/**
+ * Start running a node. Safe while the graph runs: the node sees capture
+ * from the next quantum on.
+ *
+ * @return ESP_ERR_INVALID_STATE if already attached or before init
+ */
+esp_err_t audio_graph_attach(audio_graph_node_id_t id, const audio_graph_node_config_t *config);
+
+// Stop a node; returns once its process callback can no longer run
+void audio_graph_detach(audio_graph_node_id_t id);
+
+/**
+ * From a node's process callback: pass count samples to the nodes the plan
+ * feeds from it. pos travels with them to the blocks they fill.
+ */
+void audio_graph_emit(audio_graph_node_id_t from, const int16_t *samples, size_t count, uint32_t pos);
+
+// Console view for the GRAPH command: the plan, what is attached and block counts
+void audio_graph_log(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,157 @@
+#include "audio_meter.h"
+
+#include <math.h>
+#include <string.h>
+
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+
+// Squares are shifted down by 8 bits, so a block of this many frames can
+// accumulate in 32 bits per channel before it is folded into 64
+#define METER_BLOCK_FRAMES 512
+
+typedef struct {
+    uint32_t seq;                     // Odd while a writer is mid-update
+    audio_meter_level_t level[AUDIO_METER_MIC_CHANNELS];
+    int64_t us;
+} meter_slot_t;
+
+static meter_slot_t s_mics;
+static meter_slot_t s_processed;      // level[0] only
+static portMUX_TYPE s_write_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static inline int32_t abs32(int32_t v)
+{
+    return v < 0 ? -v : v;
+}
+
+static void finish(audio_meter_level_t *out, uint64_t sq, uint64_t abs_sum, int32_t peak, size_t frames)
+{
+    out->rms = sqrtf((float)sq * 256.0f / (float)frames);
+    out->peak = (float)peak;
+    out->mean_abs = (float)abs_sum / (float)frames;
+}
+
+// Two channels of the same frames in one pass; stride is the frame width in samples
+static void measure_pair(const int16_t *s, size_t frames, size_t stride, audio_meter_level_t out[2])
+{
+    uint64_t sq0 = 0, sq1 = 0, abs0 = 0, abs1 = 0;
+    int32_t peak0 = 0, peak1 = 0;
+    for (size_t start = 0; start < frames; start += METER_BLOCK_FRAMES) {
+        size_t end = frames - start > METER_BLOCK_FRAMES ? start + METER_BLOCK_FRAMES : frames;
+        uint32_t bsq0 = 0, bsq1 = 0, babs0 = 0, babs1 = 0;
+        for (size_t i = start; i < end; ++i) {
+            int32_t a = s[i * stride];
+            int32_t b = s[i * stride + 1];
+            bsq0 += (uint32_t)(a * a) >> 8;
+            bsq1 += (uint32_t)(b * b) >> 8;
+            a = abs32(a);
+            b = abs32(b);
+            babs0 += (uint32_t)a;
+            babs1 += (uint32_t)b;
+            peak0 = a > peak0 ? a : peak0;
+            peak1 = b > peak1 ? b : peak1;
+        }
+        sq0 += bsq0;
+        sq1 += bsq1;
+        abs0 += babs0;
+        abs1 += babs1;
+    }
+    finish(&out[0], sq0, abs0, peak0, frames);
+    finish(&out[1], sq1, abs1, peak1, frames);
+}
+
+static void measure_one(const int16_t *s, size_t frames, size_t stride, audio_meter_level_t *out)
+{
+    uint64_t sq = 0, abs_sum = 0;
+    int32_t peak = 0;
+    for (size_t start = 0; start < frames; start += METER_BLOCK_FRAMES) {
+        size_t end = frames - start > METER_BLOCK_FRAMES ? start + METER_BLOCK_FRAMES : frames;
+        uint32_t bsq = 0, babs = 0;
+        for (size_t i = start; i < end; ++i) {
+            int32_t a = s[i * stride];
+            bsq += (uint32_t)(a * a) >> 8;
+            a = abs32(a);
+            babs += (uint32_t)a;
+            peak = a > peak ? a : peak;
+        }
+        sq += bsq;
+        abs_sum += babs;
+    }
+    finish(out, sq, abs_sum, peak, frames);
+}
+
+void audio_meter_measure(const int16_t *samples, size_t frames, size_t channels, audio_meter_level_t *out)
+{
+    if (!out || channels == 0) {
+        return;
+    }
+    if (!samples || frames == 0) {
+        memset(out, 0, channels * sizeof(*out));
+        return;
+    }
+    size_t c = 0;
+    for (; c + 2 <= channels; c += 2) {
+        measure_pair(samples + c, frames, channels, &out[c]);
+    }
+    if (c < channels) {
+        measure_one(samples + c, frames, channels, &out[c]);
+    }
+}
+
+static void publish(meter_slot_t *slot, const audio_meter_level_t *level, size_t count)
+{
+    int64_t now = esp_timer_get_time();
+    // Writers (the capture loop, the wake word listener, the AFE loop) take
+    // the lock among themselves; readers only watch seq
+    portENTER_CRITICAL(&s_write_lock);
+    __atomic_store_n(&slot->seq, slot->seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    memcpy(slot->level, level, count * sizeof(*level));
+    slot->us = now;
+    __atomic_store_n(&slot->seq, slot->seq + 1, __ATOMIC_RELEASE);
+    portEXIT_CRITICAL(&s_write_lock);
+}
+
+static void read_slot(const meter_slot_t *slot, audio_meter_level_t *level, size_t count, int64_t *us)
+{
+    uint32_t seq;
+    do {
+        seq = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+        memcpy(level, slot->level, count * sizeof(*level));
+        *us = slot->us;
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    } while ((seq & 1) || seq != __atomic_load_n(&slot->seq, __ATOMIC_RELAXED));
+}
+
+void audio_meter_feed_mics(const int16_t *stereo, size_t samples, audio_meter_level_t out[AUDIO_METER_MIC_CHANNELS])
+{
+    audio_meter_level_t level[AUDIO_METER_MIC_CHANNELS];
+    audio_meter_measure(stereo, samples / AUDIO_METER_MIC_CHANNELS, AUDIO_METER_MIC_CHANNELS, level);
+    publish(&s_mics, level, AUDIO_METER_MIC_CHANNELS);
+    if (out) {
+        memcpy(out, level, sizeof(level));
+    }
+}
+
+void audio_meter_feed_processed(const int16_t *mono, size_t samples)
+{
+    audio_meter_level_t level;
+    audio_meter_measure(mono, samples, 1, &level);
+    publish(&s_processed, &level, 1);
+}
+
+void audio_meter_get(audio_meter_levels_t *out)
+{
+    read_slot(&s_mics, out->mic, AUDIO_METER_MIC_CHANNELS, &out->mic_us);
+    read_slot(&s_processed, &out->processed, 1, &out->processed_us);
+}
+
+float audio_meter_voice_rms(const audio_meter_levels_t *levels)
+{
+    if (levels->processed_us != 0 &&
+        esp_timer_get_time() - levels->processed_us < (int64_t)AUDIO_METER_STALE_MS * 1000) {
+        return levels->processed.rms;
+    }
+    return fmaxf(levels->mic[0].rms, levels->mic[1].rms);
+}
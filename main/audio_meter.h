@@ -0,0 +1,56 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define AUDIO_METER_MIC_CHANNELS 2
+
+// Processed level older than this is treated as absent (AFE off or stalled)
+#ifndef AUDIO_METER_STALE_MS
+#define AUDIO_METER_STALE_MS 200
+#endif
+
+typedef struct {
+    float rms;
+    float peak;                       // Largest |sample| in the block
+    float mean_abs;                   // Mean |sample|; the wake word energy gate is tuned in this unit
+} audio_meter_level_t;
+
+typedef struct {
+    audio_meter_level_t mic[AUDIO_METER_MIC_CHANNELS];  // Raw capture: left, right
+    audio_meter_level_t processed;    // AFE output: beamformed, echo-cancelled, noise-suppressed
+    int64_t mic_us;                   // esp_timer time of the last update; 0 before the first
+    int64_t processed_us;
+} audio_meter_levels_t;
+
+/**
+ * Level one block in a single pass: RMS, peak and mean |x| of each of the
+ * channels interleaved in samples. Branch-free, so on the S3 the loop is
+ * loads, MUL16S, ABS and MAX with 32-bit accumulators.
+ */
+void audio_meter_measure(const int16_t *samples, size_t frames, size_t channels, audio_meter_level_t *out);
+
+// Meter an interleaved stereo capture block and publish it; sample count, not
+// frames. The block's own levels also go to out (may be NULL) so a caller
+// gating on them is not handed another writer's block.
+void audio_meter_feed_mics(const int16_t *stereo, size_t samples, audio_meter_level_t out[AUDIO_METER_MIC_CHANNELS]);
+
+// Meter a block of mono AFE output and publish it
+void audio_meter_feed_processed(const int16_t *mono, size_t samples);
+
+/**
+ * Latest levels. Readers never block the audio tasks: each half is guarded
+ * by a sequence counter and the copy is retried if a writer raced it.
+ */
+void audio_meter_get(audio_meter_levels_t *out);
+
+// How loud the talker is: the AFE output RMS when fresh, else the louder mic
+float audio_meter_voice_rms(const audio_meter_levels_t *levels);
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,15 +1,52 @@
 #include "audio_player.h"
 
+#include <math.h>
 #include <string.h>
 
+#include "audio_eq.h"
+#include "audio_resampler.h"
+#include "interaction_trace.h"
+#include "task_placement.h"
+
 #include "driver/i2c.h"
+#include "driver/i2s_std.h"
 // Compatibility: use old I2C API for ESP-IDF v4.4
 #define i2c_master_bus_handle_t i2c_port_t
 #define i2c_master_dev_handle_t i2c_cmd_handle_t
 #include "esp_check.h"
+#include "esp_heap_caps.h"
 #include "esp_log.h"
+#include "esp_timer.h"
+#include "flash_guard.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "sdkconfig.h"
+
+// ESP-DSP scales steady-gain streams with its MAC loop; the plain loop matches it bit for bit
+#ifdef CONFIG_DSP_ENABLED
+#include "dsps_mulc.h"
+#define USE_ESP_DSP_MIX 1
+#else
+#define USE_ESP_DSP_MIX 0
+#endif
 
 #define AUDIO_PLAYER_I2C_FREQ_HZ 100000
+// Unity gain for the Q15 mixer
+#define GAIN_UNITY 32768
+// Media duck ramp per mixed block: ~50 ms down, ~300 ms back up at 44.1 kHz
+static const int32_t DUCK_ATTACK_STEP = 2800;
+static const int32_t DUCK_RELEASE_STEP = 480;
+// I2S TX DMA ring; a block written now plays after the other buffers drain
+#define OUTPUT_DMA_BUF_COUNT 6
+#define OUTPUT_DMA_BUF_FRAMES 256
+// Frames mixed per i2s_write from the output task: always one whole DMA
+// buffer, so each TX done interrupt retires exactly one written block
+#define OUTPUT_CHUNK_FRAMES OUTPUT_DMA_BUF_FRAMES
+#define MAX_EVENT_CBS 4
+#define LOOPBACK_MASK (AUDIO_PLAYER_LOOPBACK_SAMPLES - 1)
+// Newest loopback samples the output task may still be writing; never read
+#define LOOPBACK_GUARD 256
 #define ES8388_ADDR 0x20
 
 // ES8388 register definitions
@@ -44,17 +81,115 @@
 #define ES8388_DACCONTROL26 0x30
 #define ES8388_DACCONTROL27 0x31
 
+// One mixer input: interleaved stereo frames at the source rate
+typedef struct {
+    int16_t *ring;
+    size_t frames;                    // Ring length, a power of two
+    size_t head;                      // Frames ever queued
+    size_t tail;                      // Frames ever mixed
+    int rate;                         // Sample rate of every frame in the ring
+    volatile int32_t gain_q15;        // Set by audio_player_set_stream_gain()
+    volatile int volume_percent;      // Set by audio_player_set_stream_volume(); -1 = gain only
+    SemaphoreHandle_t write_lock;     // One producer at a time
+    SemaphoreHandle_t space_ready;    // Given after each mixed block
+    SemaphoreHandle_t drained;        // Given once the stream's last frame has left the DAC
+    volatile bool dac_busy;           // Mixed frames not yet played; cleared with DRAINED
+    volatile bool flush;              // audio_player_flush(): output_task drops the queue
+    volatile bool aborted;            // audio_player_abort(): producers are turned away
+    // Owned by output_task
+    bool playing;
+    int64_t dry_since_us;             // When the ring last ran empty mid-play, or 0
+    int64_t held_since_us;            // Data queued but held back for the prefill, or 0
+    bool resuming;                    // The held data continues the stream that ran dry
+    uint32_t underruns;
+    uint32_t overruns;                // Producer side, under write_lock
+    int32_t applied_gain_q15;         // Gain at the end of the last block, ramped from
+    bool mixed;                       // Has frames in the block being written
+    bool start_pending;               // STARTED is due once tx_sent reaches start_seq
+    bool sounding;                    // Between STARTED and DRAINED
+    uint32_t start_seq;
+    uint32_t done_seq;                // tx_sent once the stream's newest block has played
+    int resample_rate;                // Rate rs is set up for; 0 resets it
+    audio_resampler_t rs;
+    volatile int32_t trim_ppm;        // Set by audio_player_set_stream_trim()
+    size_t block_pos;                 // tail when the block being written was pulled
+    // Where the newest written block sits on the DAC timeline, under s_ring_lock
+    size_t clock_pos;                 // Ring position of its first frame
+    uint32_t clock_seq;               // tx_sent when it starts to play
+    bool clock_valid;
+    int loudness_percent;             // Level eq is tuned for; -1 = not yet
+    audio_eq_chain_t eq;              // Loudness, at the output rate
+} mix_stream_t;
+
 typedef struct {
     bool initialized;
     audio_player_config_t cfg;
-    int current_sample_rate;
+    int current_sample_rate;          // I2S rate; fixed for the process lifetime
+    i2s_chan_handle_t tx;
+    volatile bool tx_active;          // Blocks are being written; idle silence is not an underrun
+    uint32_t dma_underruns;           // Bumped from the I2S interrupt (atomic)
+    uint32_t dma_underruns_seen;      // Already reported as events
+    // DAC timeline, counted in DMA buffers the I2S has finished sending
+    uint32_t tx_sent;                 // Bumped from the I2S interrupt (atomic)
+    volatile uint32_t tx_sent_us;     // Low 32 bits of esp_timer at the last bump
+    volatile uint32_t tx_wake_seq;    // The interrupt wakes output_task once tx_sent reaches it
+    volatile bool tx_wake_armed;
+    uint32_t tx_done_seq;             // tx_sent once the newest written block has played
     i2c_master_bus_handle_t i2c_bus;
     i2c_master_dev_handle_t i2c_dev;
+    mix_stream_t streams[AUDIO_PLAYER_STREAM_COUNT];
+    bool mixing;                      // Rings allocated and output_task running
+    SemaphoreHandle_t data_ready;     // Given after each enqueue on any stream
+    TaskHandle_t output_task;         // Cleared by the task as it exits
+    volatile bool stop_output;
+    int32_t duck_q15;                 // Current media gain from ducking
+    int64_t voice_last_us;            // Last block that carried voice
+    audio_eq_chain_t speaker_eq;      // On the final mix
+    audio_resampler_t direct_rs;      // Fallback path without the mixer
+    int direct_rate;
+    // AEC reference: mono mix at loopback_rate_hz, indexed by the time it reaches the DAC
+    int16_t *loopback;
+    uint32_t loopback_head;           // One past the newest sample (atomic); index = DAC time x rate
+    audio_resampler_t loopback_rs;
 } audio_player_state_t;
 
+// Low-latency streams start on their first frame
+static const uint32_t STREAM_PREFILL_MS[AUDIO_PLAYER_STREAM_COUNT] = {
+    [AUDIO_PLAYER_STREAM_MEDIA] = AUDIO_PLAYER_MEDIA_PREFILL_MS,
+};
+
+static const size_t STREAM_RING_FRAMES[AUDIO_PLAYER_STREAM_COUNT] = {
+    [AUDIO_PLAYER_STREAM_MEDIA] = AUDIO_PLAYER_MEDIA_RING_FRAMES,
+    [AUDIO_PLAYER_STREAM_VOICE] = AUDIO_PLAYER_RING_FRAMES,
+    [AUDIO_PLAYER_STREAM_UI] = AUDIO_PLAYER_RING_FRAMES / 4,
+};
+
 static audio_player_state_t s_audio;
+static portMUX_TYPE s_ring_lock = portMUX_INITIALIZER_UNLOCKED;
+// Mix scratch, used only by output_task; kept in internal RAM off the PSRAM bus
+static int32_t s_mix_acc[OUTPUT_CHUNK_FRAMES * 2];
+static int16_t s_mix_src[OUTPUT_CHUNK_FRAMES * 2] __attribute__((aligned(16)));
+static int16_t s_mix_out[OUTPUT_CHUNK_FRAMES * 2];
+static int16_t s_loopback_src[OUTPUT_CHUNK_FRAMES * 2];
 static const char *TAG = "audio_player";
 
+typedef struct {
+    audio_player_event_cb_t cb;
+    void *ctx;
+} event_sub_t;
+
+static event_sub_t s_event_subs[MAX_EVENT_CBS];
+static int s_event_sub_count;
+
+// On output_task
+static void notify_event(audio_player_event_t event, audio_player_stream_t stream)
+{
+    int count = __atomic_load_n(&s_event_sub_count, __ATOMIC_ACQUIRE);
+    for (int i = 0; i < count; ++i) {
+        s_event_subs[i].cb(event, stream, s_event_subs[i].ctx);
+    }
+}
+
 static esp_err_t es8388_write_reg(uint8_t reg, uint8_t value)
 {
     if (s_audio.i2c_bus == I2C_NUM_MAX) {
@@ -135,33 +270,574 @@ static esp_err_t configure_i2c(const audio_player_config_t *cfg)
     return ESP_OK;
 }
 
+// The TX queue overflows when DMA finishes a buffer and none was written in
+// its place: auto_clear then sends silence. Only a gap mid-play is an underrun.
+static bool IRAM_ATTR on_send_q_ovf(i2s_chan_handle_t handle, i2s_event_data_t *event, void *user_ctx)
+{
+    (void)handle;
+    (void)event;
+    (void)user_ctx;
+    if (s_audio.tx_active) {
+        __atomic_fetch_add(&s_audio.dma_underruns, 1, __ATOMIC_RELAXED);
+    }
+    return false;
+}
+
+// One DMA buffer has reached the DAC. This is the clock every playback event
+// and the AEC reference are timed from.
+static bool IRAM_ATTR on_sent(i2s_chan_handle_t handle, i2s_event_data_t *event, void *user_ctx)
+{
+    (void)handle;
+    (void)event;
+    (void)user_ctx;
+    uint32_t sent = __atomic_add_fetch(&s_audio.tx_sent, 1, __ATOMIC_RELEASE);
+    s_audio.tx_sent_us = (uint32_t)esp_timer_get_time();
+    BaseType_t woken = pdFALSE;
+    if (s_audio.tx_wake_armed && (int32_t)(sent - s_audio.tx_wake_seq) >= 0) {
+        s_audio.tx_wake_armed = false;
+        xSemaphoreGiveFromISR(s_audio.data_ready, &woken);
+    }
+    return woken == pdTRUE;
+}
+
 static esp_err_t configure_i2s(const audio_player_config_t *cfg)
 {
-    i2s_config_t i2s_conf = {
-        .mode = I2S_MODE_MASTER | I2S_MODE_TX,
-        .sample_rate = cfg->default_sample_rate,
-        .bits_per_sample = I2S_BITS_PER_SAMPLE_16BIT,
-        .channel_format = I2S_CHANNEL_FMT_RIGHT_LEFT,
-        .communication_format = I2S_COMM_FORMAT_STAND_I2S,
-        .intr_alloc_flags = ESP_INTR_FLAG_LEVEL1,
-        .dma_buf_count = 6,
-        .dma_buf_len = 256,
-        .use_apll = true,
-        .tx_desc_auto_clear = true,
-        .fixed_mclk = cfg->default_sample_rate * 256,
+    // TX only: the ES8388 ADC is unused (the microphones are PDM on their own
+    // port), so there is no RX half to share this channel's clock
+    i2s_chan_config_t chan_cfg = I2S_CHANNEL_DEFAULT_CONFIG(cfg->i2s_port, I2S_ROLE_MASTER);
+    chan_cfg.dma_desc_num = OUTPUT_DMA_BUF_COUNT;
+    chan_cfg.dma_frame_num = OUTPUT_DMA_BUF_FRAMES;
+    chan_cfg.auto_clear = true;
+
+    i2s_std_config_t std_cfg = {
+        .clk_cfg = I2S_STD_CLK_DEFAULT_CONFIG(s_audio.current_sample_rate),
+        .slot_cfg = I2S_STD_PHILIPS_SLOT_DEFAULT_CONFIG(I2S_DATA_BIT_WIDTH_16BIT, I2S_SLOT_MODE_STEREO),
+        .gpio_cfg = {
+            .mclk = cfg->mclk_gpio,
+            .bclk = cfg->bclk_gpio,
+            .ws = cfg->lrclk_gpio,
+            .dout = cfg->data_gpio,
+            .din = I2S_GPIO_UNUSED,
+            .invert_flags = {
+                .mclk_inv = false,
+                .bclk_inv = false,
+                .ws_inv = false,
+            },
+        },
     };
+    // The ES8388 runs from MCLK = 256 x fs
+    std_cfg.clk_cfg.mclk_multiple = I2S_MCLK_MULTIPLE_256;
 
-    i2s_pin_config_t pin_conf = {
-        .mck_io_num = cfg->mclk_gpio,
-        .bck_io_num = cfg->bclk_gpio,
-        .ws_io_num = cfg->lrclk_gpio,
-        .data_out_num = cfg->data_gpio,
-        .data_in_num = I2S_PIN_NO_CHANGE,
+    ESP_RETURN_ON_ERROR(i2s_new_channel(&chan_cfg, &s_audio.tx, NULL), TAG, "i2s channel");
+    i2s_event_callbacks_t cbs = {
+        .on_sent = on_sent,
+        .on_send_q_ovf = on_send_q_ovf,
     };
+    s_audio.tx_sent_us = (uint32_t)esp_timer_get_time();
+    esp_err_t err = i2s_channel_init_std_mode(s_audio.tx, &std_cfg);
+    if (err == ESP_OK) {
+        err = i2s_channel_register_event_callback(s_audio.tx, &cbs, NULL);
+    }
+    if (err == ESP_OK) {
+        err = i2s_channel_enable(s_audio.tx);
+    }
+    if (err != ESP_OK) {
+        i2s_del_channel(s_audio.tx);
+        s_audio.tx = NULL;
+        ESP_LOGE(TAG, "i2s setup: %s", esp_err_to_name(err));
+    }
+    return err;
+}
 
-    ESP_RETURN_ON_ERROR(i2s_driver_install(cfg->i2s_port, &i2s_conf, 0, NULL), TAG, "i2s install");
-    ESP_RETURN_ON_ERROR(i2s_set_pin(cfg->i2s_port, &pin_conf), TAG, "i2s pins");
-    ESP_RETURN_ON_ERROR(i2s_zero_dma_buffer(cfg->i2s_port), TAG, "i2s zero");
+static esp_err_t i2s_write_frames(const int16_t *frames, size_t frame_count)
+{
+    const uint8_t *src = (const uint8_t *)frames;
+    size_t bytes = frame_count * sizeof(int16_t) * 2;
+    size_t total_written = 0;
+    while (total_written < bytes) {
+        size_t bytes_written = 0;
+        esp_err_t err = i2s_channel_write(s_audio.tx, src + total_written, bytes - total_written, &bytes_written,
+                                          portMAX_DELAY);
+        if (err != ESP_OK) {
+            return err;
+        }
+        total_written += bytes_written;
+    }
+    return ESP_OK;
+}
+
+static size_t stream_used(const mix_stream_t *st)
+{
+    portENTER_CRITICAL(&s_ring_lock);
+    size_t used = st->head - st->tail;
+    portEXIT_CRITICAL(&s_ring_lock);
+    return used;
+}
+
+#if !AUDIO_PLAYER_SPEAKER_EQ
+static int16_t saturate16(int32_t v)
+{
+    if (v > INT16_MAX) {
+        return INT16_MAX;
+    }
+    if (v < INT16_MIN) {
+        return INT16_MIN;
+    }
+    return (int16_t)v;
+}
+#endif
+
+// Take up to want frames at the output rate from a stream's ring
+static size_t stream_pull(mix_stream_t *st, int16_t *dst, size_t want)
+{
+    if (st->resample_rate != st->rate) {
+        // The rate only changes while the ring is empty, so it holds for every queued frame
+        st->resample_rate = st->rate;
+        audio_resampler_init(&st->rs, st->rate, s_audio.current_sample_rate);
+    }
+    int32_t trim = st->trim_ppm;
+    if (trim != st->rs.trim_ppm) {
+        audio_resampler_set_trim(&st->rs, trim);
+    }
+    st->block_pos = st->tail;
+
+    size_t avail = stream_used(st);
+    size_t used = 0;
+    size_t n = 0;
+    // At most two runs: up to the end of the ring, then from its start
+    while (n < want && used < avail) {
+        size_t offset = (st->tail + used) & (st->frames - 1);
+        size_t run = avail - used;
+        if (run > st->frames - offset) {
+            run = st->frames - offset;
+        }
+        size_t taken = 0;
+        n += audio_resampler_process(&st->rs, &st->ring[offset * 2], run, &taken, dst + n * 2, want - n);
+        used += taken;
+        if (taken < run) {
+            break;
+        }
+    }
+
+    if (used) {
+        portENTER_CRITICAL(&s_ring_lock);
+        st->tail += used;
+        portEXIT_CRITICAL(&s_ring_lock);
+        xSemaphoreGive(st->space_ready);
+    }
+    return n;
+}
+
+static void mix_add(int32_t *acc, const int16_t *src, size_t samples)
+{
+    for (size_t i = 0; i < samples; ++i) {
+        acc[i] += src[i];
+    }
+}
+
+// acc += src * gain, ramping the gain from g0 to g1 across the block so changes don't click.
+// src may be scaled in place.
+static void mix_accumulate(int32_t *acc, int16_t *src, size_t frames, int32_t g0, int32_t g1)
+{
+    if (g0 == g1 && g0 == GAIN_UNITY) {
+        mix_add(acc, src, frames * 2);
+        return;
+    }
+#if USE_ESP_DSP_MIX
+    // A steady cut can't leave 16 bits, so ESP-DSP's Q15 scale gives the same samples
+    if (g0 == g1 && g0 < GAIN_UNITY) {
+        dsps_mulc_s16(src, src, (int)frames * 2, (int16_t)g0, 1, 1);
+        mix_add(acc, src, frames * 2);
+        return;
+    }
+#endif
+    int32_t g = g0 * 256;
+    int32_t step = (g1 - g0) * 256 / (int32_t)frames;
+    for (size_t i = 0; i < frames; ++i) {
+        int32_t gain = g >> 8;
+        acc[2 * i] += (src[2 * i] * gain) >> 15;
+        acc[2 * i + 1] += (src[2 * i + 1] * gain) >> 15;
+        g += step;
+    }
+}
+
+static int32_t stream_target_gain(audio_player_stream_t id)
+{
+    int32_t gain = s_audio.streams[id].gain_q15;
+    if (id == AUDIO_PLAYER_STREAM_MEDIA) {
+        gain = gain * s_audio.duck_q15 >> 15;
+    }
+    return gain;
+}
+
+// Move the media duck gain one block toward its target
+static void update_duck(int64_t now_us)
+{
+    bool voice = stream_used(&s_audio.streams[AUDIO_PLAYER_STREAM_VOICE]) > 0 ||
+                 now_us - s_audio.voice_last_us < (int64_t)AUDIO_PLAYER_DUCK_HOLD_MS * 1000;
+    int32_t target = voice ? AUDIO_PLAYER_DUCK_GAIN_Q15 : GAIN_UNITY;
+    if (s_audio.duck_q15 > target) {
+        s_audio.duck_q15 -= DUCK_ATTACK_STEP;
+        if (s_audio.duck_q15 < target) {
+            s_audio.duck_q15 = target;
+        }
+    } else if (s_audio.duck_q15 < target) {
+        s_audio.duck_q15 += DUCK_RELEASE_STEP;
+        if (s_audio.duck_q15 > target) {
+            s_audio.duck_q15 = target;
+        }
+    }
+}
+
+// Mix one block from every stream into s_mix_acc; returns the block length in frames
+static size_t mix_block(int64_t now_us)
+{
+    size_t block = 0;
+    memset(s_mix_acc, 0, sizeof(s_mix_acc));
+    update_duck(now_us);
+    for (int id = 0; id < AUDIO_PLAYER_STREAM_COUNT; ++id) {
+        mix_stream_t *st = &s_audio.streams[id];
+        int32_t target = stream_target_gain((audio_player_stream_t)id);
+        if (st->flush) {
+            portENTER_CRITICAL(&s_ring_lock);
+            st->tail = st->head;
+            portEXIT_CRITICAL(&s_ring_lock);
+            st->playing = false;
+            st->dry_since_us = 0;
+            st->held_since_us = 0;
+            st->flush = false;
+            xSemaphoreGive(st->space_ready);
+        }
+        if (!st->playing) {
+            size_t queued = stream_used(st);
+            if (queued == 0) {
+                continue;
+            }
+            if (!st->held_since_us) {
+                // First data since the ring ran dry; the gap decides what it is
+                st->held_since_us = now_us;
+                st->resuming = st->dry_since_us &&
+                               now_us - st->dry_since_us < (int64_t)AUDIO_PLAYER_UNDERRUN_GAP_MS * 1000;
+                if (st->resuming) {
+                    st->underruns++;
+                    ESP_LOGD(TAG, "Stream %d underrun #%u", id, (unsigned)st->underruns);
+                    notify_event(AUDIO_PLAYER_EVENT_UNDERRUN, (audio_player_stream_t)id);
+                }
+                st->dry_since_us = 0;
+            }
+            uint32_t prefill_ms = STREAM_PREFILL_MS[id];
+            if (queued < (size_t)st->rate * prefill_ms / 1000 &&
+                now_us - st->held_since_us < (int64_t)prefill_ms * 2000) {
+                continue;
+            }
+            if (!st->resuming) {
+                // A new stream: fresh resampler and filter state, no ramp from the old gain
+                st->resample_rate = 0;
+                st->applied_gain_q15 = target;
+                audio_eq_reset(&st->eq);
+            }
+            st->playing = true;
+            st->held_since_us = 0;
+        }
+
+        st->dac_busy = true;
+        size_t got = stream_pull(st, s_mix_src, OUTPUT_CHUNK_FRAMES);
+        if (got < OUTPUT_CHUNK_FRAMES) {
+            st->playing = false;
+            st->dry_since_us = now_us;
+        }
+        if (got == 0) {
+            continue;
+        }
+        int volume = st->volume_percent;
+        if (volume >= 0) {
+            if (volume != st->loudness_percent) {
+                audio_eq_set_loudness(&st->eq, s_audio.current_sample_rate, volume);
+                st->loudness_percent = volume;
+            }
+            audio_eq_process_i16(&st->eq, s_mix_src, got);
+        }
+        mix_accumulate(s_mix_acc, s_mix_src, got, st->applied_gain_q15, target);
+        st->applied_gain_q15 = target;
+        st->mixed = true;
+        if (id == AUDIO_PLAYER_STREAM_VOICE) {
+            s_audio.voice_last_us = now_us;
+        }
+        if (got > block) {
+            block = got;
+        }
+    }
+    return block;
+}
+
+static uint32_t loopback_index(int64_t time_us)
+{
+    return (uint32_t)(time_us * s_audio.cfg.loopback_rate_hz / 1000000);
+}
+
+// tx_sent once a block written now has played
+static uint32_t next_block_seq(void)
+{
+    uint32_t sent = __atomic_load_n(&s_audio.tx_sent, __ATOMIC_ACQUIRE);
+    if ((int32_t)(s_audio.tx_done_seq - sent) > 0) {
+        // Behind the blocks still in the DMA ring
+        s_audio.tx_done_seq++;
+    } else {
+        // After idle: the buffer in flight goes first
+        s_audio.tx_done_seq = sent + 2;
+    }
+    return s_audio.tx_done_seq;
+}
+
+// When tx_sent reaches seq, from the last TX done interrupt and the buffer period
+static int64_t seq_time_us(uint32_t seq)
+{
+    uint32_t sent_us;
+    uint32_t sent;
+    do {
+        sent_us = s_audio.tx_sent_us;
+        sent = __atomic_load_n(&s_audio.tx_sent, __ATOMIC_ACQUIRE);
+    } while (sent_us != s_audio.tx_sent_us);
+    int64_t now_us = esp_timer_get_time();
+    int64_t buffer_us = (int64_t)OUTPUT_DMA_BUF_FRAMES * 1000000 / s_audio.current_sample_rate;
+    return now_us - (uint32_t)((uint32_t)now_us - sent_us) + (int32_t)(seq - sent) * buffer_us;
+}
+
+// Tie the streams in the block just written to the buffer that carries it
+static void mark_block(uint32_t seq)
+{
+    for (int id = 0; id < AUDIO_PLAYER_STREAM_COUNT; ++id) {
+        mix_stream_t *st = &s_audio.streams[id];
+        if (!st->mixed) {
+            continue;
+        }
+        st->mixed = false;
+        portENTER_CRITICAL(&s_ring_lock);
+        st->clock_pos = st->block_pos;
+        st->clock_seq = seq - 1;
+        st->clock_valid = true;
+        portEXIT_CRITICAL(&s_ring_lock);
+        if (!st->sounding && !st->start_pending) {
+            st->start_pending = true;
+            st->start_seq = seq - 1;
+        }
+        st->done_seq = seq;
+    }
+}
+
+/**
+ * Report what the DAC has caught up with since the last call, and arm the
+ * TX done interrupt to wake output_task for the next event that is due, so
+ * an idle mixer still reports a drain the moment it happens.
+ */
+static void dispatch_events(void)
+{
+    uint32_t sent = __atomic_load_n(&s_audio.tx_sent, __ATOMIC_ACQUIRE);
+    uint32_t dma_underruns = __atomic_load_n(&s_audio.dma_underruns, __ATOMIC_RELAXED);
+    if (dma_underruns != s_audio.dma_underruns_seen) {
+        s_audio.dma_underruns_seen = dma_underruns;
+        notify_event(AUDIO_PLAYER_EVENT_UNDERRUN, AUDIO_PLAYER_STREAM_COUNT);
+    }
+    bool waiting = false;
+    uint32_t wake = 0;
+    for (int id = 0; id < AUDIO_PLAYER_STREAM_COUNT; ++id) {
+        mix_stream_t *st = &s_audio.streams[id];
+        uint32_t due = 0;
+        bool pending = false;
+        if (st->start_pending) {
+            if ((int32_t)(sent - st->start_seq) >= 0) {
+                st->start_pending = false;
+                st->sounding = true;
+                notify_event(AUDIO_PLAYER_EVENT_STARTED, (audio_player_stream_t)id);
+            } else {
+                due = st->start_seq;
+                pending = true;
+            }
+        }
+        if (!pending && st->dac_busy) {
+            if ((int32_t)(sent - st->done_seq) >= 0 && stream_used(st) == 0) {
+                st->dac_busy = false;
+                if (st->sounding) {
+                    st->sounding = false;
+                    notify_event(AUDIO_PLAYER_EVENT_DRAINED, (audio_player_stream_t)id);
+                }
+                xSemaphoreGive(st->drained);
+            } else {
+                due = st->done_seq;
+                pending = true;
+            }
+        }
+        if (pending && (!waiting || (int32_t)(due - wake) < 0)) {
+            wake = due;
+            waiting = true;
+        }
+    }
+    s_audio.tx_wake_seq = wake;
+    s_audio.tx_wake_armed = waiting;
+}
+
+/**
+ * Append a block to the loopback ring at dac_us, when the TX done interrupts
+ * say it starts to play. Idle gaps are filled with silence; small timing
+ * jitter between back-to-back blocks is ignored so the reference stays
+ * continuous.
+ */
+static void loopback_publish(const int16_t *frames, size_t frame_count, int64_t dac_us)
+{
+    uint32_t start = loopback_index(dac_us);
+    uint32_t head = s_audio.loopback_head;
+    int32_t gap = (int32_t)(start - head);
+    int32_t jitter = (int32_t)loopback_index(OUTPUT_DMA_BUF_FRAMES * 1000000LL / s_audio.current_sample_rate);
+    if (gap > jitter || gap < -jitter * OUTPUT_DMA_BUF_COUNT) {
+        // Playback restarted after idle (or drifted): realign to the DAC clock
+        if (gap > 0) {
+            uint32_t fill = gap < AUDIO_PLAYER_LOOPBACK_SAMPLES ? (uint32_t)gap : AUDIO_PLAYER_LOOPBACK_SAMPLES;
+            for (uint32_t i = 0; i < fill; ++i) {
+                s_audio.loopback[(start - fill + i) & LOOPBACK_MASK] = 0;
+            }
+        }
+        audio_resampler_init(&s_audio.loopback_rs, s_audio.current_sample_rate, s_audio.cfg.loopback_rate_hz);
+        head = start;
+    }
+
+    size_t used = 0;
+    while (used < frame_count) {
+        size_t taken = 0;
+        size_t n = audio_resampler_process(&s_audio.loopback_rs, &frames[used * 2], frame_count - used, &taken,
+                                           s_loopback_src, OUTPUT_CHUNK_FRAMES);
+        for (size_t i = 0; i < n; ++i) {
+            s_audio.loopback[(head + i) & LOOPBACK_MASK] =
+                (int16_t)(((int32_t)s_loopback_src[2 * i] + s_loopback_src[2 * i + 1]) / 2);
+        }
+        head += (uint32_t)n;
+        used += taken;
+    }
+    __atomic_store_n(&s_audio.loopback_head, head, __ATOMIC_RELEASE);
+}
+
+// Mixes every stream into I2S at one fixed rate; the only task that blocks on DMA
+static void output_task(void *arg)
+{
+    (void)arg;
+    while (!s_audio.stop_output) {
+        int64_t now_us = esp_timer_get_time();
+        dispatch_events();
+        size_t frames = mix_block(now_us);
+        if (frames == 0) {
+            if (s_audio.tx_active) {
+                flash_guard_set_audio_active(false);
+            }
+            s_audio.tx_active = false;
+            xSemaphoreTake(s_audio.data_ready, pdMS_TO_TICKS(50));
+            continue;
+        }
+        if (!s_audio.tx_active) {
+            // Flash writes hold back while the DMA queue is all that covers a cache-off stall
+            flash_guard_set_audio_active(true);
+        }
+        s_audio.tx_active = true;
+        // A short last block is padded with the silence already in s_mix_acc
+        frames = OUTPUT_CHUNK_FRAMES;
+
+        // Streams were summed at 32 bits; clip once per block instead of after every add
+#if AUDIO_PLAYER_SPEAKER_EQ
+        audio_eq_process_i32(&s_audio.speaker_eq, s_mix_acc, s_mix_out, frames);
+#else
+        for (size_t i = 0; i < frames * 2; ++i) {
+            s_mix_out[i] = saturate16(s_mix_acc[i]);
+        }
+#endif
+        uint32_t seq = next_block_seq();
+        int64_t dac_us = seq_time_us(seq - 1);
+        i2s_write_frames(s_mix_out, frames);
+        mark_block(seq);
+        if (s_audio.voice_last_us == now_us) {
+            // This block carried voice: the reply is reaching the DAC
+            interaction_trace_mark(INTERACTION_TRACE_FIRST_DMA_WRITE);
+        }
+        if (s_audio.loopback) {
+            loopback_publish(s_mix_out, frames, dac_us);
+        }
+    }
+    s_audio.output_task = NULL;
+    vTaskDelete(NULL);
+}
+
+static void stop_output_task(void)
+{
+    s_audio.tx_wake_armed = false;
+    if (s_audio.output_task) {
+        s_audio.stop_output = true;
+        xSemaphoreGive(s_audio.data_ready);
+        while (s_audio.output_task) {
+            vTaskDelay(pdMS_TO_TICKS(10));
+        }
+    }
+    for (int id = 0; id < AUDIO_PLAYER_STREAM_COUNT; ++id) {
+        mix_stream_t *st = &s_audio.streams[id];
+        if (st->write_lock) {
+            vSemaphoreDelete(st->write_lock);
+        }
+        if (st->space_ready) {
+            vSemaphoreDelete(st->space_ready);
+        }
+        if (st->drained) {
+            vSemaphoreDelete(st->drained);
+        }
+        heap_caps_free(st->ring);
+        memset(st, 0, sizeof(*st));
+    }
+    if (s_audio.data_ready) {
+        vSemaphoreDelete(s_audio.data_ready);
+        s_audio.data_ready = NULL;
+    }
+    heap_caps_free(s_audio.loopback);
+    s_audio.loopback = NULL;
+    s_audio.mixing = false;
+}
+
+static esp_err_t start_output_task(void)
+{
+    bool ok = true;
+    for (int id = 0; id < AUDIO_PLAYER_STREAM_COUNT; ++id) {
+        mix_stream_t *st = &s_audio.streams[id];
+        memset(st, 0, sizeof(*st));
+        st->frames = STREAM_RING_FRAMES[id];
+        st->ring = heap_caps_calloc(st->frames * 2, sizeof(int16_t), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        st->write_lock = xSemaphoreCreateMutex();
+        st->space_ready = xSemaphoreCreateBinary();
+        st->drained = xSemaphoreCreateBinary();
+        st->rate = s_audio.current_sample_rate;
+        st->gain_q15 = GAIN_UNITY;
+        st->volume_percent = -1;
+        st->loudness_percent = -1;
+        ok = ok && st->ring && st->write_lock && st->space_ready && st->drained;
+    }
+    s_audio.data_ready = xSemaphoreCreateBinary();
+    s_audio.stop_output = false;
+    s_audio.duck_q15 = GAIN_UNITY;
+    s_audio.voice_last_us = INT64_MIN / 2;
+    audio_eq_init_speaker(&s_audio.speaker_eq, s_audio.current_sample_rate);
+    if (!ok || !s_audio.data_ready ||
+        task_placement_create(TASK_PLACEMENT_AUDIO_OUT, output_task, NULL, &s_audio.output_task) != pdPASS) {
+        s_audio.output_task = NULL;
+        stop_output_task();
+        return ESP_ERR_NO_MEM;
+    }
+    s_audio.mixing = true;
+
+    if (s_audio.cfg.loopback_rate_hz > 0) {
+        // Optional: without it AEC runs reference-free, as before
+        int16_t *loopback = heap_caps_calloc(AUDIO_PLAYER_LOOPBACK_SAMPLES, sizeof(int16_t),
+                                             MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        if (loopback) {
+            audio_resampler_init(&s_audio.loopback_rs, s_audio.current_sample_rate, s_audio.cfg.loopback_rate_hz);
+            s_audio.loopback_head = loopback_index(esp_timer_get_time());
+            s_audio.loopback = loopback;
+        } else {
+            ESP_LOGW(TAG, "No memory for the AEC loopback tap");
+        }
+    }
     return ESP_OK;
 }
 
@@ -182,38 +858,33 @@ esp_err_t audio_player_init(const audio_player_config_t *cfg)
     ESP_RETURN_ON_ERROR(configure_i2s(cfg), TAG, "i2s setup");
     ESP_RETURN_ON_ERROR(es8388_init(), TAG, "codec init");
 
-    s_audio.initialized = true;
-    ESP_LOGI(TAG, "Audio player ready (sr=%d)", s_audio.current_sample_rate);
-    return ESP_OK;
-}
-
-static esp_err_t ensure_sample_rate(int sample_rate_hz)
-{
-    if (!s_audio.initialized || sample_rate_hz <= 0) {
-        return ESP_ERR_INVALID_STATE;
+    // Build the common tables up front so the first clip at each rate doesn't stall the mixer
+    static const int common_rates[] = {16000, 24000, 44100};
+    for (size_t i = 0; i < sizeof(common_rates) / sizeof(common_rates[0]); ++i) {
+        audio_resampler_prepare(common_rates[i], s_audio.current_sample_rate);
     }
-    if (sample_rate_hz == s_audio.current_sample_rate) {
-        return ESP_OK;
+
+    s_audio.initialized = true;
+    if (start_output_task() != ESP_OK) {
+        ESP_LOGW(TAG, "No mixer rings; playback blocks the caller on I2S");
     }
-    ESP_RETURN_ON_ERROR(
-        i2s_set_clk(s_audio.cfg.i2s_port,
-                    sample_rate_hz,
-                    I2S_BITS_PER_SAMPLE_16BIT,
-                    I2S_CHANNEL_STEREO),
-        TAG,
-        "set clk");
-    s_audio.current_sample_rate = sample_rate_hz;
-    ESP_LOGI(TAG, "Playback sample rate -> %d Hz", sample_rate_hz);
+    ESP_LOGI(TAG, "Audio player ready (sr=%d, mixer=%s)", s_audio.current_sample_rate,
+             s_audio.mixing ? "on" : "off");
     return ESP_OK;
 }
 
-static esp_err_t write_pcm_frames(const int16_t *samples, size_t sample_count, int num_channels)
+// Without the mixer: resample on the caller's task and block on I2S
+static esp_err_t write_pcm_frames(const int16_t *samples, size_t sample_count, int sample_rate_hz, int num_channels)
 {
-    ESP_RETURN_ON_FALSE(samples && sample_count > 0, ESP_ERR_INVALID_ARG, TAG, "bad pcm args");
-    ESP_RETURN_ON_FALSE(num_channels == 1 || num_channels == 2, ESP_ERR_INVALID_ARG, TAG, "channels");
-
-    const size_t chunk_frames = 256;
+    const size_t chunk_frames = 128;
     int16_t stereo_buffer[chunk_frames * 2];
+    int16_t out_buffer[chunk_frames * 2];
+
+    if (sample_rate_hz != s_audio.direct_rate) {
+        ESP_RETURN_ON_ERROR(audio_resampler_init(&s_audio.direct_rs, sample_rate_hz, s_audio.current_sample_rate),
+                            TAG, "resampler");
+        s_audio.direct_rate = sample_rate_hz;
+    }
 
     size_t frames_written = 0;
     while (frames_written < sample_count) {
@@ -234,25 +905,105 @@ static esp_err_t write_pcm_frames(const int16_t *samples, size_t sample_count, i
                    frames_this * sizeof(int16_t) * 2);
         }
 
-        size_t bytes_to_write = frames_this * sizeof(int16_t) * 2;
-        size_t total_written = 0;
-        while (total_written < bytes_to_write) {
-            size_t bytes_written = 0;
-            esp_err_t err = i2s_write(s_audio.cfg.i2s_port,
-                                      (uint8_t *)stereo_buffer + total_written,
-                                      bytes_to_write - total_written,
-                                      &bytes_written,
-                                      portMAX_DELAY);
-            if (err != ESP_OK) {
-                return err;
-            }
-            total_written += bytes_written;
+        size_t consumed = 0;
+        while (consumed < frames_this) {
+            size_t taken = 0;
+            size_t produced = audio_resampler_process(&s_audio.direct_rs, &stereo_buffer[consumed * 2],
+                                                      frames_this - consumed, &taken, out_buffer, chunk_frames);
+            consumed += taken;
+            ESP_RETURN_ON_ERROR(i2s_write_frames(out_buffer, produced), TAG, "i2s write");
         }
         frames_written += frames_this;
     }
     return ESP_OK;
 }
 
+// Caller holds st->write_lock. Old-rate frames must be mixed out before the rate changes.
+static bool stream_accepts_rate(mix_stream_t *st, int sample_rate_hz, bool wait)
+{
+    while (sample_rate_hz != st->rate) {
+        if (stream_used(st) == 0) {
+            st->rate = sample_rate_hz;
+            break;
+        }
+        if (!wait) {
+            return false;
+        }
+        xSemaphoreTake(st->space_ready, pdMS_TO_TICKS(20));
+    }
+    return true;
+}
+
+// Caller holds st->write_lock; copies what fits, widening mono to stereo
+static size_t stream_write(mix_stream_t *st, const int16_t *samples, size_t frame_count, int num_channels)
+{
+    size_t room = st->frames - stream_used(st);
+    size_t frames = frame_count < room ? frame_count : room;
+    size_t mask = st->frames - 1;
+    size_t head = st->head;
+    if (num_channels == 2) {
+        // Already the ring's layout: at most two copies, either side of the wrap
+        size_t start = head & mask;
+        size_t first = frames < st->frames - start ? frames : st->frames - start;
+        memcpy(&st->ring[start * 2], samples, first * 2 * sizeof(int16_t));
+        memcpy(st->ring, samples + first * 2, (frames - first) * 2 * sizeof(int16_t));
+    } else {
+        for (size_t i = 0; i < frames; ++i) {
+            int16_t *dst = &st->ring[((head + i) & mask) * 2];
+            dst[0] = dst[1] = samples[i];
+        }
+    }
+    if (frames) {
+        portENTER_CRITICAL(&s_ring_lock);
+        st->head += frames;
+        portEXIT_CRITICAL(&s_ring_lock);
+        xSemaphoreGive(s_audio.data_ready);
+    }
+    return frames;
+}
+
+static esp_err_t check_pcm_args(audio_player_stream_t stream, const int16_t *samples, size_t sample_count,
+                                int sample_rate_hz, int num_channels)
+{
+    ESP_RETURN_ON_FALSE(s_audio.initialized, ESP_ERR_INVALID_STATE, TAG, "not init");
+    ESP_RETURN_ON_FALSE(stream >= 0 && stream < AUDIO_PLAYER_STREAM_COUNT, ESP_ERR_INVALID_ARG, TAG, "stream");
+    ESP_RETURN_ON_FALSE(samples && sample_count > 0, ESP_ERR_INVALID_ARG, TAG, "bad pcm args");
+    ESP_RETURN_ON_FALSE(num_channels == 1 || num_channels == 2, ESP_ERR_INVALID_ARG, TAG, "channels");
+    ESP_RETURN_ON_FALSE(sample_rate_hz > 0, ESP_ERR_INVALID_ARG, TAG, "sr");
+    return ESP_OK;
+}
+
+static esp_err_t queue_pcm(audio_player_stream_t stream, const int16_t *samples, size_t sample_count,
+                           int sample_rate_hz, int num_channels)
+{
+    ESP_RETURN_ON_ERROR(check_pcm_args(stream, samples, sample_count, sample_rate_hz, num_channels), TAG, "pcm");
+    if (!s_audio.mixing) {
+        return write_pcm_frames(samples, sample_count, sample_rate_hz, num_channels);
+    }
+
+    mix_stream_t *st = &s_audio.streams[stream];
+    xSemaphoreTake(st->write_lock, portMAX_DELAY);
+    stream_accepts_rate(st, sample_rate_hz, true);
+    size_t done = 0;
+    bool waited = false;
+    while (done < sample_count) {
+        if (st->aborted) {
+            xSemaphoreGive(st->write_lock);
+            return ESP_ERR_INVALID_STATE;
+        }
+        done += stream_write(st, samples + done * num_channels, sample_count - done, num_channels);
+        if (done < sample_count) {
+            if (!waited) {
+                st->overruns++;
+                waited = true;
+            }
+            xSemaphoreTake(st->space_ready, pdMS_TO_TICKS(100));
+        }
+    }
+    xSemaphoreGive(st->write_lock);
+    return ESP_OK;
+}
+
 typedef struct __attribute__((packed)) {
     char chunk_id[4];
     uint32_t chunk_size;
@@ -321,18 +1072,270 @@ esp_err_t audio_player_play_wav(const uint8_t *wav_data, size_t wav_len)
     size_t sample_count = data_size / (fmt.bits_per_sample / 8);
     const int16_t *samples = (const int16_t *)data_ptr;
 
-    ESP_RETURN_ON_ERROR(ensure_sample_rate(fmt.sample_rate), TAG, "sr");
-    return write_pcm_frames(samples, sample_count / fmt.num_channels, fmt.num_channels);
+    return queue_pcm(AUDIO_PLAYER_STREAM_VOICE, samples, sample_count / fmt.num_channels, (int)fmt.sample_rate,
+                     fmt.num_channels);
 }
 
 esp_err_t audio_player_submit_pcm(const int16_t *samples,
                                   size_t sample_count,
                                   int sample_rate_hz,
                                   int num_channels)
+{
+    return queue_pcm(AUDIO_PLAYER_STREAM_MEDIA, samples, sample_count, sample_rate_hz, num_channels);
+}
+
+esp_err_t audio_player_stream_submit(audio_player_stream_t stream,
+                                     const int16_t *samples,
+                                     size_t sample_count,
+                                     int sample_rate_hz,
+                                     int num_channels)
+{
+    return queue_pcm(stream, samples, sample_count, sample_rate_hz, num_channels);
+}
+
+esp_err_t audio_player_enqueue_pcm(audio_player_stream_t stream,
+                                   const int16_t *samples,
+                                   size_t sample_count,
+                                   int sample_rate_hz,
+                                   int num_channels,
+                                   size_t *frames_queued)
+{
+    ESP_RETURN_ON_FALSE(frames_queued, ESP_ERR_INVALID_ARG, TAG, "frames_queued required");
+    *frames_queued = 0;
+    ESP_RETURN_ON_ERROR(check_pcm_args(stream, samples, sample_count, sample_rate_hz, num_channels), TAG, "pcm");
+    ESP_RETURN_ON_FALSE(s_audio.mixing, ESP_ERR_NOT_SUPPORTED, TAG, "no mixer");
+
+    mix_stream_t *st = &s_audio.streams[stream];
+    if (st->aborted) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (xSemaphoreTake(st->write_lock, 0) != pdTRUE) {
+        return ESP_OK;
+    }
+    if (stream_accepts_rate(st, sample_rate_hz, false)) {
+        *frames_queued = stream_write(st, samples, sample_count, num_channels);
+    }
+    xSemaphoreGive(st->write_lock);
+    return ESP_OK;
+}
+
+esp_err_t audio_player_set_stream_gain(audio_player_stream_t stream, float gain)
+{
+    ESP_RETURN_ON_FALSE(stream >= 0 && stream < AUDIO_PLAYER_STREAM_COUNT, ESP_ERR_INVALID_ARG, TAG, "stream");
+    if (gain < 0.0f) {
+        gain = 0.0f;
+    } else if (gain > 1.0f) {
+        gain = 1.0f;
+    }
+    s_audio.streams[stream].gain_q15 = (int32_t)(gain * GAIN_UNITY + 0.5f);
+    s_audio.streams[stream].volume_percent = -1;
+    return ESP_OK;
+}
+
+esp_err_t audio_player_set_stream_volume(audio_player_stream_t stream, int percent)
+{
+    ESP_RETURN_ON_FALSE(stream >= 0 && stream < AUDIO_PLAYER_STREAM_COUNT, ESP_ERR_INVALID_ARG, TAG, "stream");
+    if (percent < 0) {
+        percent = 0;
+    } else if (percent > 100) {
+        percent = 100;
+    }
+    mix_stream_t *st = &s_audio.streams[stream];
+    if (percent == 0) {
+        st->gain_q15 = 0;
+    } else {
+        // Even steps in dB, plus the make-up for the loudness shelf's cut
+        float db = -AUDIO_PLAYER_VOLUME_RANGE_DB * (100 - percent) / 100.0f + audio_eq_loudness_db(percent);
+        st->gain_q15 = (int32_t)(powf(10.0f, db / 20.0f) * GAIN_UNITY + 0.5f);
+    }
+    st->volume_percent = percent;
+    return ESP_OK;
+}
+
+esp_err_t audio_player_drain(audio_player_stream_t stream, uint32_t timeout_ms)
 {
     ESP_RETURN_ON_FALSE(s_audio.initialized, ESP_ERR_INVALID_STATE, TAG, "not init");
-    ESP_RETURN_ON_ERROR(ensure_sample_rate(sample_rate_hz), TAG, "sr");
-    return write_pcm_frames(samples, sample_count, num_channels);
+    ESP_RETURN_ON_FALSE(stream >= 0 && stream < AUDIO_PLAYER_STREAM_COUNT, ESP_ERR_INVALID_ARG, TAG, "stream");
+    mix_stream_t *st = &s_audio.streams[stream];
+    int64_t deadline_us = esp_timer_get_time() + (int64_t)timeout_ms * 1000;
+    while (s_audio.mixing && (stream_used(st) > 0 || st->dac_busy)) {
+        int64_t left_us = deadline_us - esp_timer_get_time();
+        if (left_us <= 0) {
+            return ESP_ERR_TIMEOUT;
+        }
+        xSemaphoreTake(st->drained, pdMS_TO_TICKS(left_us / 1000) + 1);
+    }
+    return ESP_OK;
+}
+
+esp_err_t audio_player_flush(audio_player_stream_t stream)
+{
+    ESP_RETURN_ON_FALSE(s_audio.initialized, ESP_ERR_INVALID_STATE, TAG, "not init");
+    ESP_RETURN_ON_FALSE(stream >= 0 && stream < AUDIO_PLAYER_STREAM_COUNT, ESP_ERR_INVALID_ARG, TAG, "stream");
+    if (!s_audio.mixing) {
+        return ESP_OK;
+    }
+    mix_stream_t *st = &s_audio.streams[stream];
+    st->flush = true;
+    xSemaphoreGive(s_audio.data_ready);
+    for (int waited_ms = 0; st->flush; waited_ms += 2) {
+        if (waited_ms >= 100) {
+            return ESP_ERR_TIMEOUT;
+        }
+        vTaskDelay(pdMS_TO_TICKS(2) ? pdMS_TO_TICKS(2) : 1);
+    }
+    return ESP_OK;
+}
+
+esp_err_t audio_player_abort(audio_player_stream_t stream)
+{
+    ESP_RETURN_ON_FALSE(s_audio.initialized, ESP_ERR_INVALID_STATE, TAG, "not init");
+    ESP_RETURN_ON_FALSE(stream >= 0 && stream < AUDIO_PLAYER_STREAM_COUNT, ESP_ERR_INVALID_ARG, TAG, "stream");
+    if (!s_audio.mixing) {
+        return ESP_OK;
+    }
+    mix_stream_t *st = &s_audio.streams[stream];
+    st->aborted = true;
+    st->flush = true;
+    // Wake the output task for the flush and a producer waiting for room
+    xSemaphoreGive(s_audio.data_ready);
+    xSemaphoreGive(st->space_ready);
+    return ESP_OK;
+}
+
+esp_err_t audio_player_resume(audio_player_stream_t stream)
+{
+    ESP_RETURN_ON_FALSE(s_audio.initialized, ESP_ERR_INVALID_STATE, TAG, "not init");
+    ESP_RETURN_ON_FALSE(stream >= 0 && stream < AUDIO_PLAYER_STREAM_COUNT, ESP_ERR_INVALID_ARG, TAG, "stream");
+    s_audio.streams[stream].aborted = false;
+    return ESP_OK;
+}
+
+void audio_player_loopback_read(int64_t start_us, int16_t *out, size_t count)
+{
+    if (!s_audio.loopback) {
+        memset(out, 0, count * sizeof(int16_t));
+        return;
+    }
+    uint32_t head = __atomic_load_n(&s_audio.loopback_head, __ATOMIC_ACQUIRE);
+    uint32_t pos = loopback_index(start_us);
+    for (size_t i = 0; i < count; ++i, ++pos) {
+        int32_t age = (int32_t)(head - pos);
+        bool valid = age > 0 && age <= AUDIO_PLAYER_LOOPBACK_SAMPLES - LOOPBACK_GUARD;
+        out[i] = valid ? s_audio.loopback[pos & LOOPBACK_MASK] : 0;
+    }
+}
+
+esp_err_t audio_player_set_stream_trim(audio_player_stream_t stream, int32_t ppm)
+{
+    ESP_RETURN_ON_FALSE(s_audio.initialized, ESP_ERR_INVALID_STATE, TAG, "not init");
+    ESP_RETURN_ON_FALSE(stream >= 0 && stream < AUDIO_PLAYER_STREAM_COUNT, ESP_ERR_INVALID_ARG, TAG, "stream");
+    if (ppm > AUDIO_PLAYER_TRIM_MAX_PPM) {
+        ppm = AUDIO_PLAYER_TRIM_MAX_PPM;
+    } else if (ppm < -AUDIO_PLAYER_TRIM_MAX_PPM) {
+        ppm = -AUDIO_PLAYER_TRIM_MAX_PPM;
+    }
+    s_audio.streams[stream].trim_ppm = ppm;
+    return ESP_OK;
+}
+
+esp_err_t audio_player_get_stream_clock(audio_player_stream_t stream, audio_player_clock_t *clock)
+{
+    ESP_RETURN_ON_FALSE(clock, ESP_ERR_INVALID_ARG, TAG, "clock required");
+    ESP_RETURN_ON_FALSE(stream >= 0 && stream < AUDIO_PLAYER_STREAM_COUNT, ESP_ERR_INVALID_ARG, TAG, "stream");
+    ESP_RETURN_ON_FALSE(s_audio.mixing, ESP_ERR_INVALID_STATE, TAG, "mixer not running");
+    const mix_stream_t *st = &s_audio.streams[stream];
+    portENTER_CRITICAL(&s_ring_lock);
+    clock->queued_pos = (uint32_t)st->head;
+    clock->mixed_pos = (uint32_t)st->tail;
+    clock->dac_pos = (uint32_t)st->clock_pos;
+    uint32_t seq = st->clock_seq;
+    bool valid = st->clock_valid;
+    portEXIT_CRITICAL(&s_ring_lock);
+    clock->rate_hz = st->rate;
+    clock->playing = valid && st->playing;
+    clock->dac_us = valid ? seq_time_us(seq) : 0;
+    return ESP_OK;
+}
+
+size_t audio_player_stream_peek(audio_player_stream_t stream, uint32_t pos, int16_t *dst, size_t frames)
+{
+    if (!s_audio.mixing || stream < 0 || stream >= AUDIO_PLAYER_STREAM_COUNT || !dst) {
+        return 0;
+    }
+    const mix_stream_t *st = &s_audio.streams[stream];
+    portENTER_CRITICAL(&s_ring_lock);
+    uint32_t tail = (uint32_t)st->tail;
+    uint32_t head = (uint32_t)st->head;
+    portEXIT_CRITICAL(&s_ring_lock);
+    if ((int32_t)(pos - tail) < 0 || (int32_t)(head - pos) <= 0) {
+        return 0;
+    }
+    size_t n = head - pos < frames ? head - pos : frames;
+    size_t mask = st->frames - 1;
+    for (size_t done = 0; done < n;) {
+        size_t offset = (pos + done) & mask;
+        size_t run = n - done < st->frames - offset ? n - done : st->frames - offset;
+        memcpy(&dst[done * 2], &st->ring[offset * 2], run * 2 * sizeof(int16_t));
+        done += run;
+    }
+    // A producer only overwrites a slot once the mixer has taken it, so the
+    // copy holds if the mixer had not reached pos by the time it finished
+    portENTER_CRITICAL(&s_ring_lock);
+    tail = (uint32_t)st->tail;
+    portEXIT_CRITICAL(&s_ring_lock);
+    return (int32_t)(pos - tail) >= 0 ? n : 0;
+}
+
+esp_err_t audio_player_add_event_cb(audio_player_event_cb_t cb, void *ctx)
+{
+    ESP_RETURN_ON_FALSE(cb, ESP_ERR_INVALID_ARG, TAG, "cb required");
+    portENTER_CRITICAL(&s_ring_lock);
+    int slot = s_event_sub_count;
+    if (slot < MAX_EVENT_CBS) {
+        s_event_subs[slot] = (event_sub_t){.cb = cb, .ctx = ctx};
+        __atomic_store_n(&s_event_sub_count, slot + 1, __ATOMIC_RELEASE);
+    }
+    portEXIT_CRITICAL(&s_ring_lock);
+    ESP_RETURN_ON_FALSE(slot < MAX_EVENT_CBS, ESP_ERR_NO_MEM, TAG, "event callbacks full");
+    return ESP_OK;
+}
+
+void audio_player_get_stats(audio_player_stats_t *stats)
+{
+    if (!stats) {
+        return;
+    }
+    memset(stats, 0, sizeof(*stats));
+    stats->output_rate_hz = s_audio.current_sample_rate;
+    stats->dma_underruns = __atomic_load_n(&s_audio.dma_underruns, __ATOMIC_RELAXED);
+    if (!s_audio.mixing) {
+        return;
+    }
+    for (int id = 0; id < AUDIO_PLAYER_STREAM_COUNT; ++id) {
+        const mix_stream_t *st = &s_audio.streams[id];
+        stats->underruns += st->underruns;
+        stats->overruns += st->overruns;
+        stats->queued_frames += stream_used(st);
+        stats->ring_frames += st->frames;
+    }
+}
+
+void audio_player_get_stream_stats(audio_player_stream_t stream, audio_player_stream_stats_t *stats)
+{
+    if (!stats) {
+        return;
+    }
+    memset(stats, 0, sizeof(*stats));
+    if (!s_audio.mixing || stream < 0 || stream >= AUDIO_PLAYER_STREAM_COUNT) {
+        return;
+    }
+    const mix_stream_t *st = &s_audio.streams[stream];
+    int rate = st->rate > 0 ? st->rate : s_audio.current_sample_rate;
+    stats->underruns = st->underruns;
+    stats->overruns = st->overruns;
+    stats->queued_ms = (uint32_t)((uint64_t)stream_used(st) * 1000 / rate);
+    stats->ring_ms = (uint32_t)((uint64_t)st->frames * 1000 / rate);
 }
 
 void audio_player_shutdown(void)
@@ -340,7 +1343,12 @@ void audio_player_shutdown(void)
     if (!s_audio.initialized) {
         return;
     }
-    i2s_driver_uninstall(s_audio.cfg.i2s_port);
+    stop_output_task();
+    if (s_audio.tx) {
+        i2s_channel_disable(s_audio.tx);
+        i2s_del_channel(s_audio.tx);
+        s_audio.tx = NULL;
+    }
     
     // Clean up I2C
     if (s_audio.i2c_bus != I2C_NUM_MAX) {
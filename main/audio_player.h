@@ -1,13 +1,87 @@
 #pragma once
 
+#include <stddef.h>
+#include <stdint.h>
+
 #include "esp_err.h"
 #include "hal/gpio_types.h"
-#include "driver/i2s.h"
+#include "driver/i2s_types.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+// Ring length of the voice stream in stereo frames, held in PSRAM; must be
+// a power of two. The UI stream gets a quarter of it.
+// 32768 frames is ~0.7 s at 44.1 kHz and ~1.4 s at 24 kHz.
+#ifndef AUDIO_PLAYER_RING_FRAMES
+#define AUDIO_PLAYER_RING_FRAMES 32768
+#endif
+
+// The media ring doubles as the network jitter buffer: a streaming decoder
+// runs up to this far ahead of the speaker, so a Wi-Fi dip shorter than the
+// ring plays through. 131072 frames is ~3 s at 44.1 kHz (512 KB of PSRAM).
+#ifndef AUDIO_PLAYER_MEDIA_RING_FRAMES
+#define AUDIO_PLAYER_MEDIA_RING_FRAMES 131072
+#endif
+
+// Media waits for this much audio before it starts, and again after an
+// underrun, so a starved stream refills instead of stuttering through every
+// packet. Held at most twice as long when the producer can't get there.
+#ifndef AUDIO_PLAYER_MEDIA_PREFILL_MS
+#define AUDIO_PLAYER_MEDIA_PREFILL_MS 500
+#endif
+
+// A stream that runs dry and refills within this gap counts as an underrun
+// (the producer was late) rather than the end of a stream
+#ifndef AUDIO_PLAYER_UNDERRUN_GAP_MS
+#define AUDIO_PLAYER_UNDERRUN_GAP_MS 250
+#endif
+
+// Media gain while the assistant speaks, Q15 (8192 is -12 dB)
+#ifndef AUDIO_PLAYER_DUCK_GAIN_Q15
+#define AUDIO_PLAYER_DUCK_GAIN_Q15 8192
+#endif
+
+// Media stays ducked this long after speech stops, so pauses between
+// sentences don't pump the music back up
+#ifndef AUDIO_PLAYER_DUCK_HOLD_MS
+#define AUDIO_PLAYER_DUCK_HOLD_MS 600
+#endif
+
+// Span of audio_player_set_stream_volume() from 1 % to 100 %
+#ifndef AUDIO_PLAYER_VOLUME_RANGE_DB
+#define AUDIO_PLAYER_VOLUME_RANGE_DB 50.0f
+#endif
+
+// Voice the final mix for the built-in speaker (see audio_eq.h)
+#ifndef AUDIO_PLAYER_SPEAKER_EQ
+#define AUDIO_PLAYER_SPEAKER_EQ 1
+#endif
+
+// Largest audio_player_set_stream_trim(); 1000 ppm slews 1 ms per second
+#ifndef AUDIO_PLAYER_TRIM_MAX_PPM
+#define AUDIO_PLAYER_TRIM_MAX_PPM 1000
+#endif
+
+// AEC loopback length in mono samples at loopback_rate_hz; power of two.
+// 16384 samples is ~1 s at 16 kHz, as deep as the capture ring.
+#ifndef AUDIO_PLAYER_LOOPBACK_SAMPLES
+#define AUDIO_PLAYER_LOOPBACK_SAMPLES 16384
+#endif
+
+/**
+ * Mixer inputs. Each has its own ring, sample rate and gain, and all of
+ * them are resampled and summed into one I2S stream at the output rate,
+ * so a new source never reclocks I2S or waits for another to finish.
+ */
+typedef enum {
+    AUDIO_PLAYER_STREAM_MEDIA = 0,    // Spotify and other music; ducked under VOICE
+    AUDIO_PLAYER_STREAM_VOICE,        // Assistant speech
+    AUDIO_PLAYER_STREAM_UI,           // Short local cues
+    AUDIO_PLAYER_STREAM_COUNT,
+} audio_player_stream_t;
+
 typedef struct {
     i2s_port_t i2s_port;
     gpio_num_t bclk_gpio;
@@ -16,15 +90,176 @@ typedef struct {
     gpio_num_t mclk_gpio;
     gpio_num_t i2c_scl_gpio;
     gpio_num_t i2c_sda_gpio;
-    int default_sample_rate;
+    int default_sample_rate;          // Fixed I2S rate; every source is resampled to it
+    int loopback_rate_hz;             // Rate of the AEC reference tap; 0 disables it
 } audio_player_config_t;
 
+typedef struct {
+    uint32_t underruns;               // Streams that ran dry mid-play, summed
+    uint32_t overruns;                // Submits that waited for a full ring, summed
+    size_t queued_frames;             // Frames waiting in all streams
+    size_t ring_frames;               // All rings; 0 when playback fell back to direct I2S writes
+    uint32_t dma_underruns;           // I2S DMA ran out of written audio mid-play and sent silence
+    int output_rate_hz;
+} audio_player_stats_t;
+
+typedef struct {
+    uint32_t underruns;               // Ran dry mid-play: the producer was late
+    uint32_t overruns;                // A submit found the ring full and waited
+    uint32_t queued_ms;               // Buffered ahead of the speaker, at the stream's rate
+    uint32_t ring_ms;
+} audio_player_stream_stats_t;
+
+/**
+ * A stream's ring positions against the DAC timeline. Positions count
+ * frames ever queued on the stream at its own rate and wrap at 2^32; compare
+ * them by signed difference.
+ */
+typedef struct {
+    uint32_t queued_pos;              // Position the next submitted frame gets
+    uint32_t mixed_pos;               // Frames before this were taken by the mixer
+    uint32_t dac_pos;                 // The frame that reaches the DAC at dac_us
+    int64_t dac_us;
+    int rate_hz;                      // Of every frame in the ring
+    bool playing;                     // dac_pos and dac_us describe the stream playing now
+} audio_player_clock_t;
+
+/**
+ * What the speaker is doing, timed by the I2S TX done interrupt: an event
+ * fires when the DMA buffer carrying the audio reaches or leaves the DAC,
+ * not when the audio was mixed. Only reported while the mixer runs.
+ */
+typedef enum {
+    AUDIO_PLAYER_EVENT_STARTED,       // A stream's first frame after silence is playing
+    AUDIO_PLAYER_EVENT_DRAINED,       // Everything queued on a stream has played
+    AUDIO_PLAYER_EVENT_UNDERRUN,      // A stream ran dry mid-play; AUDIO_PLAYER_STREAM_COUNT for the DMA
+} audio_player_event_t;
+
+// Runs on the output task: keep it short and never block on playback
+typedef void (*audio_player_event_cb_t)(audio_player_event_t event, audio_player_stream_t stream, void *ctx);
+
+/**
+ * Set up the codec and I2S, and start the output task that mixes the PSRAM
+ * stream rings into I2S at cfg->default_sample_rate. Without PSRAM for the
+ * rings, playback falls back to writing I2S from the caller, one rate at a time.
+ */
 esp_err_t audio_player_init(const audio_player_config_t *cfg);
+
+// Queue a 16-bit PCM WAV on the voice stream
 esp_err_t audio_player_play_wav(const uint8_t *wav_data, size_t wav_len);
+
+/**
+ * Queue PCM on a stream. Waits only while that stream's ring is full, never
+ * on DMA or on other streams. A sample rate change waits for the audio
+ * already queued on the same stream to play out.
+ *
+ * @param sample_count frames (samples per channel)
+ */
+esp_err_t audio_player_stream_submit(audio_player_stream_t stream,
+                                     const int16_t *samples,
+                                     size_t sample_count,
+                                     int sample_rate_hz,
+                                     int num_channels);
+
+// audio_player_stream_submit() on AUDIO_PLAYER_STREAM_MEDIA
 esp_err_t audio_player_submit_pcm(const int16_t *samples,
                                   size_t sample_count,
                                   int sample_rate_hz,
                                   int num_channels);
+
+/**
+ * Queue as much PCM as fits right now and return at once.
+ *
+ * @param frames_queued whole frames accepted; 0 while the ring is full, busy
+ *                      with another producer, or playing another sample rate
+ */
+esp_err_t audio_player_enqueue_pcm(audio_player_stream_t stream,
+                                   const int16_t *samples,
+                                   size_t sample_count,
+                                   int sample_rate_hz,
+                                   int num_channels,
+                                   size_t *frames_queued);
+
+/**
+ * Set a stream's gain from 0.0 to 1.0. Changes ramp over one block. Media
+ * ducking is applied on top of this.
+ */
+esp_err_t audio_player_set_stream_gain(audio_player_stream_t stream, float gain);
+
+/**
+ * Set a stream's listening level from 0 to 100 %: even steps in dB across
+ * AUDIO_PLAYER_VOLUME_RANGE_DB, with loudness compensation that lifts the
+ * bass as the level falls. Ramps like a gain change, so it is click-free and
+ * needs no codec writes. Replaced by the next audio_player_set_stream_gain().
+ */
+esp_err_t audio_player_set_stream_volume(audio_player_stream_t stream, int percent);
+
+/**
+ * Wait until every frame queued on a stream has left the DAC, i.e. for its
+ * AUDIO_PLAYER_EVENT_DRAINED. The speaker is quiet when this returns.
+ */
+esp_err_t audio_player_drain(audio_player_stream_t stream, uint32_t timeout_ms);
+
+/**
+ * Drop everything queued on a stream that has not been mixed yet, for a
+ * producer that switches sounds. Returns once the output task has dropped
+ * it, so frames queued after this call are kept.
+ */
+esp_err_t audio_player_flush(audio_player_stream_t stream);
+
+/**
+ * Barge-in: drop a stream's queue at the next mixed block and turn its
+ * producers away. A submit waiting for room, and every submit after it,
+ * returns ESP_ERR_INVALID_STATE until audio_player_resume(). Does not wait,
+ * so it may be called from the task that detected the interruption.
+ */
+esp_err_t audio_player_abort(audio_player_stream_t stream);
+esp_err_t audio_player_resume(audio_player_stream_t stream);
+
+/**
+ * Copy the mono playback reference that reached the DAC from start_us on,
+ * at loopback_rate_hz. Anything not played, not yet played, or already
+ * overwritten reads as silence. Lock-free; for a single consumer such as the
+ * AFE feed.
+ */
+void audio_player_loopback_read(int64_t start_us, int16_t *out, size_t count);
+
+/**
+ * Play a stream faster (ppm > 0) or slower, up to AUDIO_PLAYER_TRIM_MAX_PPM,
+ * to lock it to a clock other than the local crystal. Takes effect from the
+ * next mixed block and lasts until changed.
+ */
+esp_err_t audio_player_set_stream_trim(audio_player_stream_t stream, int32_t ppm);
+
+/**
+ * Where a stream's frames meet the DAC, from the block written last. Between
+ * two reads dac_pos advances at the stream rate (times the trim), so a
+ * producer can tell when any frame it queued will be heard.
+ *
+ * @return ESP_ERR_INVALID_STATE while playback runs without the mixer
+ */
+esp_err_t audio_player_get_stream_clock(audio_player_stream_t stream, audio_player_clock_t *clock);
+
+/**
+ * Copy queued frames, stereo, starting at ring position pos, without taking
+ * them. Only frames the mixer has not reached yet can be read.
+ *
+ * @return frames copied; 0 when pos is already mixed or not queued yet
+ */
+size_t audio_player_stream_peek(audio_player_stream_t stream, uint32_t pos, int16_t *dst, size_t frames);
+
+/**
+ * Subscribe to playback events; may be called before audio_player_init().
+ * Subscriptions last for the process lifetime.
+ *
+ * @return ESP_ERR_NO_MEM once four callbacks are registered
+ */
+esp_err_t audio_player_add_event_cb(audio_player_event_cb_t cb, void *ctx);
+
+void audio_player_get_stats(audio_player_stats_t *stats);
+
+// Zeroes while playback runs without the mixer
+void audio_player_get_stream_stats(audio_player_stream_t stream, audio_player_stream_stats_t *stats);
 void audio_player_shutdown(void);
 
 #ifdef __cplusplus
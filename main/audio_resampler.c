@@ -0,0 +1,251 @@
+#include "audio_resampler.h"
+
+#include <math.h>
+#include <string.h>
+
+#include "esp_check.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+
+static const char *TAG = "audio_resampler";
+
+// Coefficients are Q14 so the 32-bit sum of a branch cannot overflow
+#define COEFF_SHIFT 14
+// Low-pass edge as a fraction of the lower Nyquist rate
+#define CUTOFF_SCALE 0.92
+
+struct audio_resampler_table {
+    uint32_t up;
+    uint32_t down;
+    int16_t coeffs[];                 // up branches x AUDIO_RESAMPLER_TAPS, newest input first
+};
+
+static const audio_resampler_table_t *s_tables[AUDIO_RESAMPLER_MAX_TABLES];
+static portMUX_TYPE s_tables_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static uint32_t gcd(uint32_t a, uint32_t b)
+{
+    while (b) {
+        uint32_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+static int16_t saturate16(int32_t v)
+{
+    if (v > INT16_MAX) {
+        return INT16_MAX;
+    }
+    if (v < INT16_MIN) {
+        return INT16_MIN;
+    }
+    return (int16_t)v;
+}
+
+static const audio_resampler_table_t *find_table(uint32_t up, uint32_t down)
+{
+    const audio_resampler_table_t *found = NULL;
+    portENTER_CRITICAL(&s_tables_lock);
+    for (int i = 0; i < AUDIO_RESAMPLER_MAX_TABLES && s_tables[i]; ++i) {
+        if (s_tables[i]->up == up && s_tables[i]->down == down) {
+            found = s_tables[i];
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&s_tables_lock);
+    return found;
+}
+
+/**
+ * Blackman-windowed sinc of length up * TAPS at the upsampled rate, split
+ * into branches. Each branch is normalised to unity DC gain so the output
+ * level does not ripple with the phase.
+ */
+static audio_resampler_table_t *build_table(uint32_t up, uint32_t down)
+{
+    size_t count = (size_t)up * AUDIO_RESAMPLER_TAPS;
+    size_t bytes = sizeof(audio_resampler_table_t) + count * sizeof(int16_t);
+    audio_resampler_table_t *table = heap_caps_malloc(bytes, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (!table) {
+        table = heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    }
+    if (!table) {
+        return NULL;
+    }
+    table->up = up;
+    table->down = down;
+
+    double fc = CUTOFF_SCALE * 0.5 / (double)(up > down ? up : down);
+    double center = (double)(count - 1) / 2.0;
+    for (uint32_t p = 0; p < up; ++p) {
+        double branch[AUDIO_RESAMPLER_TAPS];
+        double sum = 0.0;
+        for (int k = 0; k < AUDIO_RESAMPLER_TAPS; ++k) {
+            double n = (double)(p + (uint32_t)k * up);
+            double x = n - center;
+            double sinc = fabs(x) < 1e-9 ? 2.0 * fc : sin(2.0 * M_PI * fc * x) / (M_PI * x);
+            double w = 0.42 - 0.5 * cos(2.0 * M_PI * n / (double)(count - 1)) +
+                       0.08 * cos(4.0 * M_PI * n / (double)(count - 1));
+            branch[k] = sinc * w;
+            sum += branch[k];
+        }
+        for (int k = 0; k < AUDIO_RESAMPLER_TAPS; ++k) {
+            double c = sum != 0.0 ? branch[k] / sum : 0.0;
+            table->coeffs[p * AUDIO_RESAMPLER_TAPS + k] = saturate16((int32_t)lround(c * (1 << COEFF_SHIFT)));
+        }
+    }
+    return table;
+}
+
+static const audio_resampler_table_t *get_table(uint32_t up, uint32_t down)
+{
+    const audio_resampler_table_t *table = find_table(up, down);
+    if (table) {
+        return table;
+    }
+    audio_resampler_table_t *built = build_table(up, down);
+    if (!built) {
+        return NULL;
+    }
+
+    bool stored = false;
+    portENTER_CRITICAL(&s_tables_lock);
+    for (int i = 0; i < AUDIO_RESAMPLER_MAX_TABLES; ++i) {
+        if (!s_tables[i]) {
+            s_tables[i] = built;
+            stored = true;
+            break;
+        }
+        if (s_tables[i]->up == up && s_tables[i]->down == down) {
+            table = s_tables[i];      // Built concurrently by another task
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&s_tables_lock);
+
+    if (!stored) {
+        heap_caps_free(built);
+        if (!table) {
+            ESP_LOGW(TAG, "Table cache full; %u/%u uses linear interpolation", (unsigned)up, (unsigned)down);
+        }
+        return table;
+    }
+    ESP_LOGI(TAG, "Built %u-phase table for %u/%u", (unsigned)up, (unsigned)up, (unsigned)down);
+    return built;
+}
+
+static esp_err_t reduce_ratio(int in_rate_hz, int out_rate_hz, uint32_t *up, uint32_t *down)
+{
+    ESP_RETURN_ON_FALSE(in_rate_hz > 0 && out_rate_hz > 0, ESP_ERR_INVALID_ARG, TAG, "rates");
+    uint32_t g = gcd((uint32_t)in_rate_hz, (uint32_t)out_rate_hz);
+    *up = (uint32_t)out_rate_hz / g;
+    *down = (uint32_t)in_rate_hz / g;
+    return ESP_OK;
+}
+
+esp_err_t audio_resampler_prepare(int in_rate_hz, int out_rate_hz)
+{
+    uint32_t up, down;
+    ESP_RETURN_ON_ERROR(reduce_ratio(in_rate_hz, out_rate_hz, &up, &down), TAG, "ratio");
+    if (up == down || up > AUDIO_RESAMPLER_MAX_PHASES) {
+        return ESP_OK;
+    }
+    return get_table(up, down) ? ESP_OK : ESP_ERR_NO_MEM;
+}
+
+esp_err_t audio_resampler_init(audio_resampler_t *rs, int in_rate_hz, int out_rate_hz)
+{
+    ESP_RETURN_ON_FALSE(rs, ESP_ERR_INVALID_ARG, TAG, "rs required");
+    memset(rs, 0, sizeof(*rs));
+    ESP_RETURN_ON_ERROR(reduce_ratio(in_rate_hz, out_rate_hz, &rs->up, &rs->down), TAG, "ratio");
+    rs->phase = rs->up;               // Load one input frame before the first output
+    if (rs->up != rs->down && rs->up <= AUDIO_RESAMPLER_MAX_PHASES) {
+        rs->table = get_table(rs->up, rs->down);
+    }
+    return ESP_OK;
+}
+
+static void push_frame(audio_resampler_t *rs, const int16_t *frame)
+{
+    rs->pos = rs->pos ? rs->pos - 1 : AUDIO_RESAMPLER_TAPS - 1;
+    for (int c = 0; c < 2; ++c) {
+        rs->history[c][rs->pos] = frame[c];
+        rs->history[c][rs->pos + AUDIO_RESAMPLER_TAPS] = frame[c];
+    }
+}
+
+// One branch against the history; both runs are contiguous for the compiler to unroll.
+// Not dsps_dotprod_s16: its MAC16 kernel loads word pairs, so it needs 4-byte
+// alignment that the sliding history start doesn't have, and it keeps the low
+// 16 bits of the sum where this saturates.
+static int16_t dot(const int16_t *coeffs, const int16_t *hist)
+{
+    int32_t acc = 1 << (COEFF_SHIFT - 1);
+    for (int k = 0; k < AUDIO_RESAMPLER_TAPS; ++k) {
+        acc += (int32_t)coeffs[k] * hist[k];
+    }
+    return saturate16(acc >> COEFF_SHIFT);
+}
+
+void audio_resampler_set_trim(audio_resampler_t *rs, int32_t ppm)
+{
+    if (ppm && rs->up == 1 && rs->down == 1) {
+        // The copy kept the last two frames, so interpolation picks up without a gap
+        rs->up = rs->down = AUDIO_RESAMPLER_TRIM_STEPS;
+        rs->phase = rs->up;
+    }
+    rs->trim_ppm = ppm;
+}
+
+size_t audio_resampler_process(audio_resampler_t *rs, const int16_t *in, size_t in_frames, size_t *in_used,
+                               int16_t *out, size_t out_frames)
+{
+    if (rs->up == rs->down && rs->up == 1) {
+        size_t n = in_frames < out_frames ? in_frames : out_frames;
+        memcpy(out, in, n * 2 * sizeof(int16_t));
+        for (size_t i = n > 2 ? n - 2 : 0; i < n; ++i) {
+            push_frame(rs, &in[2 * i]);
+        }
+        *in_used = n;
+        return n;
+    }
+
+    size_t used = 0;
+    size_t n = 0;
+    while (n < out_frames) {
+        while (rs->phase >= rs->up && used < in_frames) {
+            push_frame(rs, &in[2 * used]);
+            used++;
+            rs->phase -= rs->up;
+        }
+        if (rs->phase >= rs->up) {
+            break;
+        }
+        const int16_t *h0 = &rs->history[0][rs->pos];
+        const int16_t *h1 = &rs->history[1][rs->pos];
+        if (rs->table) {
+            const int16_t *coeffs = &rs->table->coeffs[rs->phase * AUDIO_RESAMPLER_TAPS];
+            out[2 * n] = dot(coeffs, h0);
+            out[2 * n + 1] = dot(coeffs, h1);
+        } else {
+            // Between the previous and newest frame, one input frame late
+            int32_t w = (int32_t)(((uint64_t)rs->phase << 15) / rs->up);
+            out[2 * n] = (int16_t)(h0[1] + (((int32_t)h0[0] - h0[1]) * w >> 15));
+            out[2 * n + 1] = (int16_t)(h1[1] + (((int32_t)h1[0] - h1[1]) * w >> 15));
+        }
+        rs->phase += rs->down;
+        if (rs->trim_ppm) {
+            // Less than one input frame per output, so the phase stays positive
+            rs->trim_acc += rs->trim_ppm * (int32_t)rs->down;
+            int32_t steps = rs->trim_acc / 1000000;
+            rs->phase += steps;
+            rs->trim_acc -= steps * 1000000;
+        }
+        n++;
+    }
+    *in_used = used;
+    return n;
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// FIR taps per polyphase branch; fixed so the inner product unrolls
+#define AUDIO_RESAMPLER_TAPS 32
+
+// Ratios with more phases than this (after reducing by the GCD) use linear
+// interpolation instead of a table. 320 covers 22.05 -> 48 kHz; a table
+// takes phases x AUDIO_RESAMPLER_TAPS x 2 bytes (10 KB for 44.1 -> 48 kHz).
+#ifndef AUDIO_RESAMPLER_MAX_PHASES
+#define AUDIO_RESAMPLER_MAX_PHASES 320
+#endif
+
+// Distinct rate pairs whose tables are kept for the process lifetime
+#ifndef AUDIO_RESAMPLER_MAX_TABLES
+#define AUDIO_RESAMPLER_MAX_TABLES 6
+#endif
+
+// Phase steps per input frame once an equal-rate stream is trimmed
+#define AUDIO_RESAMPLER_TRIM_STEPS 64
+
+typedef struct audio_resampler_table audio_resampler_table_t;
+
+/**
+ * Stereo rational resampler: up by L, windowed-sinc low-pass, down by M,
+ * evaluated as L polyphase branches so only the taps that hit real input
+ * samples are computed. Equal rates pass through untouched.
+ *
+ * State carries across calls, so input can arrive in arbitrary pieces.
+ */
+typedef struct {
+    const audio_resampler_table_t *table;  // NULL for passthrough or linear
+    uint32_t up;                      // L
+    uint32_t down;                    // M
+    uint32_t phase;                   // Output position past the newest input, in 1/L input frames
+    uint32_t pos;                     // Newest sample in history
+    int32_t trim_ppm;                 // Extra input consumed per output, in millionths
+    int32_t trim_acc;                 // Phase error carried toward the next whole step, x 1e6
+    int16_t history[2][2 * AUDIO_RESAMPLER_TAPS];  // Mirrored so each dot product reads one run
+} audio_resampler_t;
+
+/**
+ * Build and cache the filter table for a rate pair ahead of time. Tables are
+ * otherwise built on first use by audio_resampler_init().
+ */
+esp_err_t audio_resampler_prepare(int in_rate_hz, int out_rate_hz);
+
+/**
+ * Reset rs for a new stream. Falls back to linear interpolation when the
+ * ratio needs too many phases or no table can be allocated.
+ */
+esp_err_t audio_resampler_init(audio_resampler_t *rs, int in_rate_hz, int out_rate_hz);
+
+/**
+ * Play the input faster (ppm > 0) or slower by a few hundred ppm, e.g. to
+ * follow another device's clock. Applied one phase step at a time, so the
+ * ratio moves without a click; an equal-rate stream moves from the copy to
+ * linear interpolation on a fine grid the first time it is trimmed.
+ */
+void audio_resampler_set_trim(audio_resampler_t *rs, int32_t ppm);
+
+/**
+ * Convert interleaved stereo frames.
+ *
+ * @param in_used set to the input frames consumed; a few may be held in the
+ *                filter history rather than produced yet
+ * @return output frames written, at most out_frames
+ */
+size_t audio_resampler_process(audio_resampler_t *rs, const int16_t *in, size_t in_frames, size_t *in_used,
+                               int16_t *out, size_t out_frames);
+
+#ifdef __cplusplus
+}
+#endif
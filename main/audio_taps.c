@@ -0,0 +1,104 @@
+#include "audio_taps.h"
+
+#include "audio_graph.h"
+#include "audio_meter.h"
+#include "esp_check.h"
+#include "esp_log.h"
+#include "event_bus.h"
+#include "serial_link.h"
+#if CONFIG_KVA_SPECTRUM_LEDS
+#include "audio_features.h"
+#include "audio_spectrum.h"
+#endif
+
+static const char *TAG = "audio_taps";
+
+// Stereo samples per meter block: 16 ms at 16 kHz, the LED frame budget
+#define AUDIO_TAPS_METER_BLOCK 512
+// Mono samples per mel frontend push
+#define AUDIO_TAPS_SPECTRUM_BLOCK 256
+
+static void mic_meter_node(void *ctx, const audio_graph_block_t *block)
+{
+    (void)ctx;
+    // Mic LEDs (4, 8, 12): left, right, and the AFE output once it has one
+    audio_meter_feed_mics(block->samples, block->count, NULL);
+    serial_link_tap_audio(block->samples, block->count, AUDIO_METER_MIC_CHANNELS);
+    audio_meter_levels_t levels;
+    audio_meter_get(&levels);
+    const event_bus_event_t meter = {
+        .topic = EVENT_BUS_TOPIC_MIC_LEVELS,
+        .mic_levels.mic = {levels.mic[0].rms, levels.mic[1].rms, audio_meter_voice_rms(&levels)},
+    };
+    event_bus_publish(&meter);
+}
+
+#if CONFIG_KVA_SPECTRUM_LEDS
+static audio_features_t *s_features;
+static audio_spectrum_t *s_spectrum;
+
+static void downmix_node(void *ctx, const audio_graph_block_t *block)
+{
+    (void)ctx;
+    int16_t mono[AUDIO_TAPS_METER_BLOCK / 2];
+    size_t frames = block->count / 2;
+    for (size_t i = 0; i < frames; ++i) {
+        mono[i] = (int16_t)(((int32_t)block->samples[2 * i] + block->samples[2 * i + 1]) / 2);
+    }
+    audio_graph_emit(AUDIO_GRAPH_NODE_DOWNMIX, mono, frames, block->pos);
+}
+
+// Each new mel row updates the spectrum
+static void spectrum_node(void *ctx, const audio_graph_block_t *block)
+{
+    (void)ctx;
+    size_t rows = 0;
+    if (audio_features_stream_push(s_features, block->samples, block->count, &rows) == ESP_OK && rows > 0) {
+        const event_bus_event_t event = {
+            .topic = EVENT_BUS_TOPIC_SPECTRUM,
+            .spectrum.analyzer = s_spectrum,
+        };
+        event_bus_publish(&event);
+    }
+}
+
+static void spectrum_start(void)
+{
+    s_features = audio_features_init(CONFIG_KVA_SAMPLE_RATE);
+    s_spectrum = audio_spectrum_create(NULL);
+    const audio_graph_node_config_t downmix = {
+        .process = downmix_node,
+        .block_samples = AUDIO_TAPS_METER_BLOCK,
+    };
+    const audio_graph_node_config_t spectrum = {
+        .process = spectrum_node,
+        .block_samples = AUDIO_TAPS_SPECTRUM_BLOCK,
+    };
+    if (s_features && s_spectrum) {
+        audio_features_stream_set_row_cb(s_features, audio_spectrum_push_row, s_spectrum);
+        if (audio_graph_attach(AUDIO_GRAPH_NODE_SPECTRUM, &spectrum) == ESP_OK &&
+            audio_graph_attach(AUDIO_GRAPH_NODE_DOWNMIX, &downmix) == ESP_OK) {
+            return;
+        }
+        audio_graph_detach(AUDIO_GRAPH_NODE_SPECTRUM);
+    }
+    ESP_LOGW(TAG, "Spectrum analyzer unavailable; LEDs stay level-only");
+    audio_features_deinit(s_features);
+    audio_spectrum_destroy(s_spectrum);
+    s_features = NULL;
+    s_spectrum = NULL;
+}
+#endif
+
+esp_err_t audio_taps_start(void)
+{
+    const audio_graph_node_config_t meter = {
+        .process = mic_meter_node,
+        .block_samples = AUDIO_TAPS_METER_BLOCK,
+    };
+    ESP_RETURN_ON_ERROR(audio_graph_attach(AUDIO_GRAPH_NODE_MIC_METER, &meter), TAG, "meter");
+#if CONFIG_KVA_SPECTRUM_LEDS
+    spectrum_start();
+#endif
+    return ESP_OK;
+}
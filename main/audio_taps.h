@@ -0,0 +1,21 @@
+#pragma once
+
+#include "esp_err.h"
+#include "kva_config_defaults.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * The audio_graph nodes that only observe the raw capture, for whichever
+ * pipeline is running: mic levels for the LEDs and the serial link's audio
+ * tap on the audio core, and with CONFIG_KVA_SPECTRUM_LEDS the mel
+ * spectrum analyser on the network core, where a slow frame costs nothing
+ * but a late LED update.
+ */
+esp_err_t audio_taps_start(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,110 +1,303 @@
 #include "aws_iot_bridge.h"
 
-#include "aws_iot_bridge.h"
-
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
-#include "cJSON.h"
+#include "audio_meter.h"
+#include "breath_monitor.h"
+#include "cpu_profiler.h"
 #include "esp_check.h"
 #include "esp_log.h"
 #include "esp_timer.h"
+#include "json_writer.h"
+#include "mem_tags.h"
+#include "mem_telemetry.h"
 #include "somnus_mqtt.h"
+#include "sound_events.h"
+#include "task_placement.h"
+#include "version_info.h"
 
 static const char *TAG = "aws_iot_bridge";
 
-static void aws_iot_bridge_metrics_init(aws_iot_bridge_metrics_t *metrics)
+// Busiest tasks in each metrics report
+#define AWS_IOT_BRIDGE_TOP_TASKS 8
+
+// Histogram bases: bucket edges double from there, up to about 100 s
+#define AWS_IOT_BRIDGE_LATENCY_BASE_US 50000
+
+// One interaction report: transcript, intent, status and every trace point
+#define AWS_IOT_BRIDGE_INTERACTION_JSON_BYTES 1536
+
+static esp_err_t aws_iot_bridge_metrics_register(aws_iot_bridge_metrics_t *m)
 {
-    if (!metrics) {
-        return;
+    m->wake_events = metrics_counter("wake_events");
+    m->simulated_wake_events = metrics_counter("simulated_wake_events");
+    m->button_events = metrics_counter("button_events");
+    m->stt_success = metrics_counter("stt_success");
+    m->stt_failure = metrics_counter("stt_failure");
+    m->tts_success = metrics_counter("tts_success");
+    m->tts_failure = metrics_counter("tts_failure");
+    m->spotify_success = metrics_counter("spotify_success");
+    m->spotify_failure = metrics_counter("spotify_failure");
+    m->interactions = metrics_counter("interactions");
+    m->interaction_errors = metrics_counter("interaction_errors");
+    m->last_button_id = metrics_gauge("last_button_id");
+    m->stt_latency = metrics_histogram("stt_latency", AWS_IOT_BRIDGE_LATENCY_BASE_US);
+    m->llm_latency = metrics_histogram("llm_latency", AWS_IOT_BRIDGE_LATENCY_BASE_US);
+    m->tts_first_byte = metrics_histogram("tts_first_byte", AWS_IOT_BRIDGE_LATENCY_BASE_US);
+    m->wake_to_response = metrics_histogram("wake_to_response", AWS_IOT_BRIDGE_LATENCY_BASE_US);
+    m->spotify_latency = metrics_histogram("spotify_latency", AWS_IOT_BRIDGE_LATENCY_BASE_US);
+    // Recording into a missing metric is a no-op, so a full pool only costs telemetry
+    return m->interaction_errors && m->last_button_id && m->spotify_latency ? ESP_OK : ESP_ERR_NO_MEM;
+}
+
+// Counters and gauges as plain numbers; a histogram as {"count":..,"base_us":..,
+// "buckets":[..],"p50_us":..,"p90_us":..,"p99_us":..,"max_us":..}. Bucket i
+// counts samples under base_us << i (the last one everything slower) since
+// boot, so buckets from many devices add up to one fleet-wide histogram.
+static void aws_iot_bridge_add_registry(json_writer_t *w)
+{
+    size_t count = metrics_count();
+    for (size_t i = 0; i < count; ++i) {
+        metrics_value_t value;
+        if (!metrics_read(i, &value)) {
+            continue;
+        }
+        switch (value.type) {
+        case METRICS_TYPE_COUNTER:
+            json_writer_int(w, value.name, value.count);
+            break;
+        case METRICS_TYPE_GAUGE:
+            if (value.gauge.set) {
+                json_writer_int(w, value.name, value.gauge.value);
+            }
+            break;
+        case METRICS_TYPE_HISTOGRAM: {
+            if (value.histogram.count == 0) {
+                break;
+            }
+            json_writer_begin_object(w, value.name);
+            json_writer_int(w, "count", value.histogram.count);
+            json_writer_int(w, "base_us", value.histogram.base_us);
+            json_writer_begin_array(w, "buckets");
+            for (int b = 0; b < METRICS_HISTOGRAM_BUCKETS; ++b) {
+                json_writer_int(w, NULL, value.histogram.buckets[b]);
+            }
+            json_writer_end_array(w);
+            json_writer_int(w, "p50_us", metrics_histogram_percentile_us(&value, 50.0f));
+            json_writer_int(w, "p90_us", metrics_histogram_percentile_us(&value, 90.0f));
+            json_writer_int(w, "p99_us", metrics_histogram_percentile_us(&value, 99.0f));
+            json_writer_int(w, "max_us", value.histogram.max_us);
+            json_writer_end_object(w);
+            break;
+        }
+        }
     }
-    memset(metrics, 0, sizeof(*metrics));
-    metrics->last_button_id = -1;
 }
 
-static bool aws_iot_bridge_lock(aws_iot_bridge_t *bridge)
+// {"internal":{"free":..,"min_free":..,"largest":..,"min_largest":..},...,
+//  "tags":{"cspot":{"live":..,"peak":..,"failures":..}},"stack_min_free":{"audio_out":..}}
+static void aws_iot_bridge_add_memory(json_writer_t *w)
 {
-    if (!bridge || !bridge->metrics_mutex) {
-        return false;
+    json_writer_begin_object(w, "memory");
+    mem_telemetry_snapshot_t snap;
+    mem_telemetry_sample(&snap);
+    for (int r = 0; r < MEM_TELEMETRY_REGION_COUNT; ++r) {
+        const mem_telemetry_heap_t *heap = &snap.heap[r];
+        if (heap->total_bytes == 0) {
+            continue;
+        }
+        json_writer_begin_object(w, mem_telemetry_region_name((mem_telemetry_region_t)r));
+        json_writer_int(w, "free", heap->free_bytes);
+        json_writer_int(w, "min_free", heap->min_free_bytes);
+        json_writer_int(w, "largest", heap->largest_free_block);
+        json_writer_int(w, "min_largest", heap->min_largest_free_block);
+        json_writer_end_object(w);
+    }
+#if CONFIG_MEM_TAGS_ENABLE
+    json_writer_begin_object(w, "tags");
+    for (int t = 0; t < MEM_TAG_COUNT; ++t) {
+        mem_tag_stats_t stats;
+        mem_tags_get((mem_tag_t)t, &stats);
+        json_writer_begin_object(w, mem_tags_name((mem_tag_t)t));
+        json_writer_int(w, "live", stats.live_bytes);
+        json_writer_int(w, "peak", stats.peak_bytes);
+        json_writer_int(w, "failures", stats.failures);
+        json_writer_end_object(w);
     }
-    if (xSemaphoreTake(bridge->metrics_mutex, portMAX_DELAY) != pdTRUE) {
-        return false;
+    json_writer_end_object(w);
+#endif
+    json_writer_begin_object(w, "stack_min_free");
+    for (int i = 0; i < TASK_PLACEMENT_COUNT; ++i) {
+        uint32_t min_free = task_placement_min_free_bytes((task_placement_id_t)i);
+        if (min_free != UINT32_MAX) {
+            json_writer_int(w, task_placement_get((task_placement_id_t)i)->name, min_free);
+        }
     }
-    return true;
+    json_writer_end_object(w);
+    json_writer_end_object(w);
 }
 
-static void aws_iot_bridge_unlock(aws_iot_bridge_t *bridge)
+// {"core0":{"1s":..,"10s":..,"60s":..},"core1":{..},"afe":{"frames":..,"misses":..,"worst_us":..},
+//  "top":{"voice_pipeline":41.2,...}}; AFE and top over the last minute
+static void aws_iot_bridge_add_cpu(json_writer_t *w)
 {
-    if (bridge && bridge->metrics_mutex) {
-        xSemaphoreGive(bridge->metrics_mutex);
+    float load;
+    if (cpu_profiler_core_load(0, CPU_PROFILER_WINDOW_60S, &load) != ESP_OK) {
+        return;  // Not running or not sampled yet
+    }
+    json_writer_begin_object(w, "cpu");
+    for (int core = 0; core < portNUM_PROCESSORS; ++core) {
+        char name[8];
+        snprintf(name, sizeof(name), "core%d", core);
+        json_writer_begin_object(w, name);
+        for (int win = 0; win < CPU_PROFILER_WINDOW_COUNT; ++win) {
+            if (cpu_profiler_core_load(core, (cpu_profiler_window_t)win, &load) == ESP_OK) {
+                json_writer_float(w, cpu_profiler_window_name((cpu_profiler_window_t)win), load);
+            }
+        }
+        json_writer_end_object(w);
     }
+    cpu_profiler_afe_stats_t afe;
+    cpu_profiler_afe_stats(CPU_PROFILER_WINDOW_60S, &afe);
+    json_writer_begin_object(w, "afe");
+    json_writer_int(w, "frames", afe.frames);
+    json_writer_int(w, "misses", afe.misses);
+    json_writer_int(w, "worst_us", afe.worst_us);
+    json_writer_end_object(w);
+    cpu_profiler_task_load_t top[AWS_IOT_BRIDGE_TOP_TASKS];
+    size_t n = cpu_profiler_top(top, AWS_IOT_BRIDGE_TOP_TASKS, CPU_PROFILER_WINDOW_60S);
+    json_writer_begin_object(w, "top");
+    for (size_t i = 0; i < n; ++i) {
+        json_writer_float(w, top[i].name, top[i].load_pct);
+    }
+    json_writer_end_object(w);
+    json_writer_end_object(w);
 }
 
-static bool aws_iot_bridge_snapshot_metrics(const aws_iot_bridge_t *bridge, aws_iot_bridge_metrics_t *out)
+static float aws_iot_bridge_dbfs(float level)
 {
-    if (!bridge || !out || !bridge->metrics_mutex) {
-        return false;
+    return level > 1.0f ? 20.0f * log10f(level / 32768.0f) : -90.3f;  // One LSB
+}
+
+// {"mic_rms_dbfs":[..,..],"mic_peak_dbfs":[..,..],"voice_rms_dbfs":..}; levels of the latest block
+static void aws_iot_bridge_add_audio(json_writer_t *w)
+{
+    audio_meter_levels_t levels;
+    audio_meter_get(&levels);
+    if (levels.mic_us == 0) {
+        return;  // Capture has not run
+    }
+    json_writer_begin_object(w, "audio");
+    json_writer_begin_array(w, "mic_rms_dbfs");
+    for (int ch = 0; ch < AUDIO_METER_MIC_CHANNELS; ++ch) {
+        json_writer_float(w, NULL, aws_iot_bridge_dbfs(levels.mic[ch].rms));
+    }
+    json_writer_end_array(w);
+    json_writer_begin_array(w, "mic_peak_dbfs");
+    for (int ch = 0; ch < AUDIO_METER_MIC_CHANNELS; ++ch) {
+        json_writer_float(w, NULL, aws_iot_bridge_dbfs(levels.mic[ch].peak));
+    }
+    json_writer_end_array(w);
+    json_writer_float(w, "voice_rms_dbfs", aws_iot_bridge_dbfs(audio_meter_voice_rms(&levels)));
+    json_writer_end_object(w);
+}
+
+// "sound_events":[{"label":"snore","start_ms":..,"epoch":true,"duration_ms":..,"confidence":..}],
+// "sound_events_dropped":..; only when something happened since the last report
+static void aws_iot_bridge_add_sound_events(json_writer_t *w)
+{
+    sound_events_entry_t events[CONFIG_KVA_SOUND_EVENTS_QUEUE];
+    uint32_t dropped = 0;
+    size_t count = sound_events_drain(events, CONFIG_KVA_SOUND_EVENTS_QUEUE, &dropped);
+    if (dropped > 0) {
+        json_writer_int(w, "sound_events_dropped", dropped);
+    }
+    if (count == 0) {
+        return;
     }
-    if (xSemaphoreTake(bridge->metrics_mutex, pdMS_TO_TICKS(50)) != pdTRUE) {
-        return false;
+    json_writer_begin_array(w, "sound_events");
+    for (size_t i = 0; i < count; ++i) {
+        json_writer_begin_object(w, NULL);
+        json_writer_string(w, "label", events[i].label);
+        json_writer_int(w, "start_ms", events[i].start_ms);
+        json_writer_bool(w, "epoch", events[i].epoch);
+        json_writer_int(w, "duration_ms", events[i].duration_ms);
+        json_writer_float(w, "confidence", roundf(events[i].confidence * 100.0f) / 100.0f);
+        json_writer_end_object(w);
     }
-    *out = bridge->metrics;
-    xSemaphoreGive(bridge->metrics_mutex);
-    return true;
+    json_writer_end_array(w);
+}
+
+// {"breaths_per_min":..,"regularity":..,"estimates":..}; only while the monitor runs,
+// rate and regularity only when the last estimate found a rhythm
+static void aws_iot_bridge_add_breathing(json_writer_t *w)
+{
+    breath_monitor_stats_t breath;
+    breath_monitor_get(&breath);
+    if (!breath.active) {
+        return;
+    }
+    json_writer_begin_object(w, "breathing");
+    if (breath.valid) {
+        json_writer_float(w, "breaths_per_min", roundf(breath.breaths_per_min * 10.0f) / 10.0f);
+        json_writer_float(w, "regularity", roundf(breath.regularity * 100.0f) / 100.0f);
+    }
+    json_writer_int(w, "estimates", breath.estimates);
+    json_writer_end_object(w);
 }
 
 static void aws_iot_bridge_publish_metrics(aws_iot_bridge_t *bridge)
 {
-    aws_iot_bridge_metrics_t snapshot = {0};
-    if (!aws_iot_bridge_snapshot_metrics(bridge, &snapshot)) {
+    if (!bridge || !bridge->ready) {
         return;
     }
-    cJSON *root = cJSON_CreateObject();
-    if (!root) {
+    // One buffer for the whole report, written in place rather than built as a tree and printed
+    char *json = malloc(CONFIG_KVA_AWS_TELEMETRY_MAX_BYTES);
+    if (!json) {
         return;
     }
+    json_writer_t w;
+    json_writer_init(&w, json, CONFIG_KVA_AWS_TELEMETRY_MAX_BYTES);
+    json_writer_begin_object(&w, NULL);
     const char *device_id = somnus_mqtt_get_device_id();
     if (device_id) {
-        cJSON_AddStringToObject(root, "deviceId", device_id);
+        json_writer_string(&w, "deviceId", device_id);
     }
-    uint64_t timestamp_ms = esp_timer_get_time() / 1000ULL;
-    cJSON_AddNumberToObject(root, "timestamp_ms", (double)timestamp_ms);
-    cJSON *metrics = cJSON_CreateObject();
-    if (!metrics) {
-        cJSON_Delete(root);
+    json_writer_int(&w, "timestamp_ms", esp_timer_get_time() / 1000);
+    // Latency distributions are compared across releases
+    json_writer_string(&w, "firmware_version", FIRMWARE_VERSION);
+    json_writer_begin_object(&w, "assistant_metrics");
+    aws_iot_bridge_add_registry(&w);
+    aws_iot_bridge_add_memory(&w);
+    aws_iot_bridge_add_cpu(&w);
+    aws_iot_bridge_add_audio(&w);
+    aws_iot_bridge_add_breathing(&w);
+    json_writer_end_object(&w);
+    aws_iot_bridge_add_sound_events(&w);
+    json_writer_end_object(&w);
+    size_t len = 0;
+    if (json_writer_finish(&w, &len) != ESP_OK) {
+        ESP_LOGW(TAG, "Metrics report of %u bytes exceeds CONFIG_KVA_AWS_TELEMETRY_MAX_BYTES, dropped",
+                 (unsigned)len);
+        free(json);
         return;
     }
-    cJSON_AddItemToObject(root, "assistant_metrics", metrics);
-    cJSON_AddNumberToObject(metrics, "wake_events", snapshot.wake_events);
-    cJSON_AddNumberToObject(metrics, "simulated_wake_events", snapshot.simulated_wake_events);
-    cJSON_AddNumberToObject(metrics, "button_events", snapshot.button_events);
-    cJSON_AddNumberToObject(metrics, "stt_success", snapshot.stt_success);
-    cJSON_AddNumberToObject(metrics, "stt_failure", snapshot.stt_failure);
-    cJSON_AddNumberToObject(metrics, "tts_success", snapshot.tts_success);
-    cJSON_AddNumberToObject(metrics, "tts_failure", snapshot.tts_failure);
-    cJSON_AddNumberToObject(metrics, "spotify_success", snapshot.spotify_success);
-    cJSON_AddNumberToObject(metrics, "spotify_failure", snapshot.spotify_failure);
-    cJSON_AddNumberToObject(metrics, "interactions", snapshot.interactions);
-    cJSON_AddNumberToObject(metrics, "interaction_errors", snapshot.interaction_errors);
-    if (snapshot.last_button_id >= 0) {
-        cJSON_AddNumberToObject(metrics, "last_button_id", snapshot.last_button_id);
-    }
-    char *json = cJSON_PrintUnformatted(root);
-    if (json) {
-        esp_err_t err = somnus_mqtt_publish_telemetry(json);
-        if (err != ESP_OK) {
-            ESP_LOGW(TAG, "Telemetry publish failed (%s); logging locally", esp_err_to_name(err));
-            ESP_LOGI(TAG, "[metrics] %s", json);
-        } else {
-            ESP_LOGI(TAG, "Published assistant metrics snapshot");
-        }
-        cJSON_free(json);
+    esp_err_t err = somnus_mqtt_publish_telemetry(json);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Telemetry publish failed (%s); logging locally", esp_err_to_name(err));
+        ESP_LOGI(TAG, "[metrics] %s", json);
+    } else {
+        ESP_LOGI(TAG, "Published assistant metrics snapshot");
     }
-    cJSON_Delete(root);
+    free(json);
 }
 
-static void telemetry_timer_cb(TimerHandle_t timer)
+static void telemetry_timer_cb(void *arg)
 {
-    aws_iot_bridge_t *bridge = (aws_iot_bridge_t *)pvTimerGetTimerID(timer);
+    aws_iot_bridge_t *bridge = (aws_iot_bridge_t *)arg;
     if (!bridge) {
         return;
     }
@@ -114,50 +307,113 @@ static void telemetry_timer_cb(TimerHandle_t timer)
 esp_err_t aws_iot_bridge_init(aws_iot_bridge_t *bridge, const aws_iot_bridge_config_t *cfg)
 {
     ESP_RETURN_ON_FALSE(bridge && cfg, ESP_ERR_INVALID_ARG, TAG, "bad args");
-    aws_iot_bridge_metrics_init(&bridge->metrics);
-    bridge->metrics_mutex = xSemaphoreCreateMutex();
-    ESP_RETURN_ON_FALSE(bridge->metrics_mutex, ESP_ERR_NO_MEM, TAG, "metrics mutex");
+    if (aws_iot_bridge_metrics_register(&bridge->metrics) != ESP_OK) {
+        ESP_LOGW(TAG, "Metrics registry full; some assistant metrics are not reported");
+    }
     bridge->telemetry_period_ms = cfg->telemetry_period_ms;
     if (bridge->telemetry_period_ms > 0) {
-        bridge->telemetry_timer = xTimerCreate("aws_telemetry",
-                                               pdMS_TO_TICKS(bridge->telemetry_period_ms),
-                                               pdTRUE,
-                                               bridge,
-                                               telemetry_timer_cb);
-        if (!bridge->telemetry_timer) {
-            vSemaphoreDelete(bridge->metrics_mutex);
-            bridge->metrics_mutex = NULL;
-            return ESP_ERR_NO_MEM;
-        }
-        xTimerStart(bridge->telemetry_timer, 0);
+        const timer_wheel_timer_config_t timer_cfg = {
+            .callback = telemetry_timer_cb,
+            .arg = bridge,
+            .name = "aws_telemetry",
+            .slack_ms = bridge->telemetry_period_ms / 4,
+        };
+        ESP_RETURN_ON_ERROR(timer_wheel_create(&timer_cfg, &bridge->telemetry_timer), TAG, "telemetry timer");
+    }
+    // Before the first tick, which checks it
+    bridge->ready = true;
+    if (bridge->telemetry_timer) {
+        timer_wheel_start_periodic(bridge->telemetry_timer, bridge->telemetry_period_ms);
     }
     return ESP_OK;
 }
 
-static void aws_iot_bridge_record_interaction_locked(aws_iot_bridge_t *bridge, esp_err_t status)
+static void aws_iot_bridge_record_result(metrics_counter_t *success, metrics_counter_t *failure, esp_err_t status)
 {
-    bridge->metrics.interactions++;
-    if (status != ESP_OK) {
-        bridge->metrics.interaction_errors++;
+    metrics_counter_add(status == ESP_OK ? success : failure, 1);
+}
+
+static void aws_iot_bridge_record_us(metrics_histogram_t *histogram, int64_t us)
+{
+    if (us >= 0) {
+        metrics_histogram_record_us(histogram, us > UINT32_MAX ? UINT32_MAX : (uint32_t)us);
+    }
+}
+
+// Time between two points of the trace; skipped unless both were reached
+static void aws_iot_bridge_record_span(metrics_histogram_t *histogram, const interaction_trace_t *trace,
+                                       interaction_trace_point_t from, interaction_trace_point_t to)
+{
+    int64_t from_us = interaction_trace_offset_us(trace, from);
+    int64_t to_us = interaction_trace_offset_us(trace, to);
+    if (from_us >= 0 && to_us >= from_us) {
+        aws_iot_bridge_record_us(histogram, to_us - from_us);
     }
 }
 
-static void aws_iot_bridge_record_result_locked(aws_iot_bridge_metrics_t *metrics,
-                                                bool success,
-                                                uint32_t *success_counter,
-                                                uint32_t *failure_counter)
+// "latency_ms":{"origin":"wake","wake":0,"vad_onset":312.5,...} in ms from the origin; unreached points are left out
+static void aws_iot_bridge_add_latency(json_writer_t *w, const interaction_trace_t *trace)
 {
-    if (success) {
-        (*success_counter)++;
+    json_writer_begin_object(w, "latency_ms");
+    json_writer_string(w, "origin", interaction_trace_point_name(trace->origin));
+    for (int p = 0; p < INTERACTION_TRACE_POINT_COUNT; ++p) {
+        int64_t offset_us = interaction_trace_offset_us(trace, (interaction_trace_point_t)p);
+        if (offset_us >= 0) {
+            json_writer_double(w, interaction_trace_point_name((interaction_trace_point_t)p),
+                               (double)offset_us / 1000.0);
+        }
+    }
+    json_writer_end_object(w);
+}
+
+// Queued at interaction priority, ahead of telemetry and logs when the outbox fills
+static void aws_iot_bridge_send_interaction(const char *transcript, const char *intent, const char *status,
+                                            const interaction_trace_t *trace)
+{
+    char *json = malloc(AWS_IOT_BRIDGE_INTERACTION_JSON_BYTES);
+    if (!json) {
+        return;
+    }
+    json_writer_t w;
+    json_writer_init(&w, json, AWS_IOT_BRIDGE_INTERACTION_JSON_BYTES);
+    json_writer_begin_object(&w, NULL);
+    const char *device_id = somnus_mqtt_get_device_id();
+    if (device_id) {
+        json_writer_string(&w, "deviceId", device_id);
+    }
+    json_writer_int(&w, "timestamp_ms", esp_timer_get_time() / 1000);
+    json_writer_string(&w, "firmware_version", FIRMWARE_VERSION);
+    if (transcript) {
+        json_writer_string(&w, "transcript", transcript);
     } else {
-        (*failure_counter)++;
+        json_writer_null(&w, "transcript");
     }
+    json_writer_string(&w, "intent", intent);
+    json_writer_string(&w, "status", status);
+    if (trace) {
+        aws_iot_bridge_add_latency(&w, trace);
+    }
+    json_writer_end_object(&w);
+    size_t len = 0;
+    if (json_writer_finish(&w, &len) != ESP_OK) {
+        ESP_LOGW(TAG, "Interaction report of %u bytes exceeds %d, dropped", (unsigned)len,
+                 AWS_IOT_BRIDGE_INTERACTION_JSON_BYTES);
+        free(json);
+        return;
+    }
+    esp_err_t err = somnus_mqtt_publish_interaction(json);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Interaction publish failed (%s); logging locally", esp_err_to_name(err));
+        ESP_LOGI(TAG, "[interaction] %s", json);
+    }
+    free(json);
 }
 
 esp_err_t aws_iot_bridge_publish_interaction(aws_iot_bridge_t *bridge,
                                              const char *transcript,
                                              const intent_router_decision_t *decision,
-                                             esp_err_t action_status)
+                                             esp_err_t action_status,
+                                             const interaction_trace_t *trace)
 {
     ESP_RETURN_ON_FALSE(bridge, ESP_ERR_INVALID_ARG, TAG, "bridge required");
     const char *intent = "none";
@@ -179,79 +435,77 @@ esp_err_t aws_iot_bridge_publish_interaction(aws_iot_bridge_t *bridge,
                 break;
         }
     }
-    ESP_LOGI(TAG,
-             "[stub] Would publish interaction: transcript=\"%s\" intent=%s status=%s",
-             transcript ? transcript : "(none)",
-             intent,
-             action_status == ESP_OK ? "ok" : esp_err_to_name(action_status));
+    const char *status = action_status == ESP_OK ? "ok" : esp_err_to_name(action_status);
+    ESP_LOGI(TAG, "Interaction: transcript=\"%s\" intent=%s status=%s",
+             transcript ? transcript : "(none)", intent, status);
+    aws_iot_bridge_send_interaction(transcript, intent, status, trace);
+    if (trace) {
+        interaction_trace_log(trace);
+        aws_iot_bridge_record_span(bridge->metrics.stt_latency, trace, INTERACTION_TRACE_VAD_OFFSET,
+                                   INTERACTION_TRACE_STT_FINAL);
+        aws_iot_bridge_record_span(bridge->metrics.llm_latency, trace, INTERACTION_TRACE_STT_FINAL,
+                                   INTERACTION_TRACE_LLM_FIRST_TOKEN);
+        aws_iot_bridge_record_span(bridge->metrics.tts_first_byte, trace, INTERACTION_TRACE_LLM_FIRST_TOKEN,
+                                   INTERACTION_TRACE_TTS_FIRST_BYTE);
+        aws_iot_bridge_record_us(bridge->metrics.wake_to_response,
+                                 interaction_trace_offset_us(trace, INTERACTION_TRACE_FIRST_DMA_WRITE));
+    }
     aws_iot_bridge_record_interaction(bridge, action_status);
     return ESP_OK;
 }
 
 void aws_iot_bridge_record_wake(aws_iot_bridge_t *bridge, bool simulated)
 {
-    if (!aws_iot_bridge_lock(bridge)) {
+    if (!bridge) {
         return;
     }
-    if (simulated) {
-        bridge->metrics.simulated_wake_events++;
-    } else {
-        bridge->metrics.wake_events++;
-    }
-    aws_iot_bridge_unlock(bridge);
+    metrics_counter_add(simulated ? bridge->metrics.simulated_wake_events : bridge->metrics.wake_events, 1);
 }
 
 void aws_iot_bridge_record_button(aws_iot_bridge_t *bridge, int button_id)
 {
-    if (!aws_iot_bridge_lock(bridge)) {
+    if (!bridge) {
         return;
     }
-    bridge->metrics.button_events++;
-    bridge->metrics.last_button_id = button_id;
-    aws_iot_bridge_unlock(bridge);
+    metrics_counter_add(bridge->metrics.button_events, 1);
+    metrics_gauge_set(bridge->metrics.last_button_id, button_id);
 }
 
 void aws_iot_bridge_record_stt_result(aws_iot_bridge_t *bridge, esp_err_t status)
 {
-    if (!aws_iot_bridge_lock(bridge)) {
-        return;
+    if (bridge) {
+        aws_iot_bridge_record_result(bridge->metrics.stt_success, bridge->metrics.stt_failure, status);
     }
-    aws_iot_bridge_record_result_locked(&bridge->metrics,
-                                        status == ESP_OK,
-                                        &bridge->metrics.stt_success,
-                                        &bridge->metrics.stt_failure);
-    aws_iot_bridge_unlock(bridge);
 }
 
 void aws_iot_bridge_record_tts_result(aws_iot_bridge_t *bridge, esp_err_t status)
 {
-    if (!aws_iot_bridge_lock(bridge)) {
-        return;
+    if (bridge) {
+        aws_iot_bridge_record_result(bridge->metrics.tts_success, bridge->metrics.tts_failure, status);
     }
-    aws_iot_bridge_record_result_locked(&bridge->metrics,
-                                        status == ESP_OK,
-                                        &bridge->metrics.tts_success,
-                                        &bridge->metrics.tts_failure);
-    aws_iot_bridge_unlock(bridge);
 }
 
 void aws_iot_bridge_record_spotify_result(aws_iot_bridge_t *bridge, esp_err_t status)
 {
-    if (!aws_iot_bridge_lock(bridge)) {
-        return;
+    if (bridge) {
+        aws_iot_bridge_record_result(bridge->metrics.spotify_success, bridge->metrics.spotify_failure, status);
+    }
+}
+
+void aws_iot_bridge_record_spotify_latency(aws_iot_bridge_t *bridge, int64_t elapsed_us)
+{
+    if (bridge) {
+        aws_iot_bridge_record_us(bridge->metrics.spotify_latency, elapsed_us);
     }
-    aws_iot_bridge_record_result_locked(&bridge->metrics,
-                                        status == ESP_OK,
-                                        &bridge->metrics.spotify_success,
-                                        &bridge->metrics.spotify_failure);
-    aws_iot_bridge_unlock(bridge);
 }
 
 void aws_iot_bridge_record_interaction(aws_iot_bridge_t *bridge, esp_err_t status)
 {
-    if (!aws_iot_bridge_lock(bridge)) {
+    if (!bridge) {
         return;
     }
-    aws_iot_bridge_record_interaction_locked(bridge, status);
-    aws_iot_bridge_unlock(bridge);
+    metrics_counter_add(bridge->metrics.interactions, 1);
+    if (status != ESP_OK) {
+        metrics_counter_add(bridge->metrics.interaction_errors, 1);
+    }
 }
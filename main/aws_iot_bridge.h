@@ -3,34 +3,47 @@
 #include <stdbool.h>
 
 #include "esp_err.h"
-#include "freertos/FreeRTOS.h"
-#include "freertos/semphr.h"
-#include "freertos/timers.h"
 #include "intent_router.h"
+#include "interaction_trace.h"
+#include "metrics.h"
+#include "timer_wheel.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+// The bridge's own entries in the metrics registry, registered by init
 typedef struct {
-    uint32_t wake_events;
-    uint32_t simulated_wake_events;
-    uint32_t button_events;
-    uint32_t stt_success;
-    uint32_t stt_failure;
-    uint32_t tts_success;
-    uint32_t tts_failure;
-    uint32_t spotify_success;
-    uint32_t spotify_failure;
-    uint32_t interactions;
-    uint32_t interaction_errors;
-    int last_button_id;
+    metrics_counter_t *wake_events;
+    metrics_counter_t *simulated_wake_events;
+    metrics_counter_t *button_events;
+    metrics_counter_t *stt_success;
+    metrics_counter_t *stt_failure;
+    metrics_counter_t *tts_success;
+    metrics_counter_t *tts_failure;
+    metrics_counter_t *spotify_success;
+    metrics_counter_t *spotify_failure;
+    metrics_counter_t *interactions;
+    metrics_counter_t *interaction_errors;
+    metrics_gauge_t *last_button_id;
+    // Stage latencies from the interaction trace
+    metrics_histogram_t *stt_latency;         // End of speech to final transcript
+    metrics_histogram_t *llm_latency;         // Final transcript to first LLM token
+    metrics_histogram_t *tts_first_byte;      // First LLM token to first TTS byte
+    metrics_histogram_t *wake_to_response;    // Wake (or speech onset) to first reply sample
+    metrics_histogram_t *spotify_latency;     // One Spotify command, call to result
 } aws_iot_bridge_metrics_t;
 
+/**
+ * Telemetry reports every metric in the registry (see metrics.h), not just
+ * the bridge's: a subsystem adds one with metrics_counter() or
+ * METRICS_COUNT() and it shows up in the next report. Recording never
+ * takes a lock.
+ */
 typedef struct aws_iot_bridge {
     uint32_t telemetry_period_ms;
-    TimerHandle_t telemetry_timer;
-    SemaphoreHandle_t metrics_mutex;
+    timer_wheel_timer_t *telemetry_timer;
+    bool ready;
     aws_iot_bridge_metrics_t metrics;
 } aws_iot_bridge_t;
 
@@ -39,15 +52,22 @@ typedef struct {
 } aws_iot_bridge_config_t;
 
 esp_err_t aws_iot_bridge_init(aws_iot_bridge_t *bridge, const aws_iot_bridge_config_t *cfg);
+/**
+ * Report one finished interaction through somnus_mqtt_publish_interaction().
+ * trace, when not NULL, is the latency record of the interaction; its offsets
+ * go out with the report as "latency_ms" and are printed on the console.
+ */
 esp_err_t aws_iot_bridge_publish_interaction(aws_iot_bridge_t *bridge,
                                              const char *transcript,
                                              const intent_router_decision_t *decision,
-                                             esp_err_t action_status);
+                                             esp_err_t action_status,
+                                             const interaction_trace_t *trace);
 void aws_iot_bridge_record_wake(aws_iot_bridge_t *bridge, bool simulated);
 void aws_iot_bridge_record_button(aws_iot_bridge_t *bridge, int button_id);
 void aws_iot_bridge_record_stt_result(aws_iot_bridge_t *bridge, esp_err_t status);
 void aws_iot_bridge_record_tts_result(aws_iot_bridge_t *bridge, esp_err_t status);
 void aws_iot_bridge_record_spotify_result(aws_iot_bridge_t *bridge, esp_err_t status);
+void aws_iot_bridge_record_spotify_latency(aws_iot_bridge_t *bridge, int64_t elapsed_us);
 void aws_iot_bridge_record_interaction(aws_iot_bridge_t *bridge, esp_err_t status);
 
 #ifdef __cplusplus
@@ -0,0 +1,266 @@
+#include "batch_stt.h"
+
+#include <string.h>
+
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
+#include "gemini_client.h"
+#include "mem_tags.h"
+#include "openai_client.h"
+#include "task_placement.h"
+
+static const char *TAG = "batch_stt";
+
+// Job->winner before any transcript, and once the caller has stopped waiting without one
+#define WINNER_NONE -1
+#define WINNER_GAVE_UP -2
+
+typedef struct batch_stt_job batch_stt_job_t;
+
+typedef struct {
+    batch_stt_job_t *job;
+    provider_router_provider_t provider;
+    int64_t start_us;
+    int64_t deadline_us;
+    esp_err_t err;
+    bool running;                     // Caller's view: launched, not answered, not given up on
+    bool noted;                       // Its failure is counted; set by whoever counts it first
+    char text[GEMINI_MAX_TRANSCRIPT_CHARS > OPENAI_MAX_TRANSCRIPT_CHARS ? GEMINI_MAX_TRANSCRIPT_CHARS
+                                                                        : OPENAI_MAX_TRANSCRIPT_CHARS];
+} batch_stt_attempt_t;
+
+// Shared by the caller and its attempts; the last one out frees it
+struct batch_stt_job {
+    int16_t *pcm;                     // Copy of the caller's audio, which may be reused before a late attempt ends
+    size_t sample_count;
+    int sample_rate_hz;
+    uplink_codec_id_t codec;
+    QueueHandle_t results;            // Index of each attempt that answered
+    int refs;
+    int winner;                       // First attempt with a transcript, or WINNER_*
+    batch_stt_attempt_t attempts[PROVIDER_ROUTER_COUNT];
+};
+
+static esp_err_t transcribe(provider_router_provider_t provider, const int16_t *pcm, size_t sample_count,
+                            int sample_rate_hz, uplink_codec_id_t codec, char *text, size_t text_len)
+{
+    esp_err_t err = ESP_ERR_NOT_SUPPORTED;
+    if (provider == PROVIDER_ROUTER_GEMINI) {
+        gemini_transcription_t result = {0};
+        err = gemini_transcribe_audio(pcm, sample_count, sample_rate_hz, codec, &result);
+        strlcpy(text, result.text, text_len);
+    } else if (provider == PROVIDER_ROUTER_OPENAI) {
+        openai_transcription_t result = {0};
+        err = openai_transcribe_wav(pcm, sample_count, sample_rate_hz, &result);
+        strlcpy(text, result.text, text_len);
+    }
+    return err == ESP_OK && text[0] == '\0' ? ESP_ERR_NOT_FOUND : err;
+}
+
+static void job_release(batch_stt_job_t *job)
+{
+    if (__atomic_sub_fetch(&job->refs, 1, __ATOMIC_ACQ_REL) > 0) {
+        return;
+    }
+    vQueueDelete(job->results);
+    heap_caps_free(job->pcm);
+    MEM_TAG_FREE(MEM_TAG_VOICE_PIPELINE, job);
+}
+
+// Count a failure once, whether the attempt or the caller's timeout sees it first
+static void note_failure_once(batch_stt_attempt_t *attempt, esp_err_t err, int64_t elapsed_us)
+{
+    if (!__atomic_exchange_n(&attempt->noted, true, __ATOMIC_ACQ_REL)) {
+        provider_router_note_failure(attempt->provider, PROVIDER_ROUTER_STT, err, elapsed_us);
+    }
+}
+
+static void attempt_task(void *arg)
+{
+    batch_stt_attempt_t *attempt = (batch_stt_attempt_t *)arg;
+    batch_stt_job_t *job = attempt->job;
+    int index = (int)(attempt - job->attempts);
+    attempt->err = transcribe(attempt->provider, job->pcm, job->sample_count, job->sample_rate_hz, job->codec,
+                              attempt->text, sizeof(attempt->text));
+    int64_t elapsed_us = esp_timer_get_time() - attempt->start_us;
+    if (attempt->err == ESP_OK) {
+        // The winner is timed by the interaction trace. Given up on or not,
+        // the first transcript still wins while the caller waits
+        int none = WINNER_NONE;
+        if (!__atomic_compare_exchange_n(&job->winner, &none, index, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            // Another attempt won, or the caller gave up: only the latency is news
+            provider_router_note_late(attempt->provider, PROVIDER_ROUTER_STT, elapsed_us);
+        }
+    } else if (attempt->err != ESP_ERR_NOT_FOUND) {
+        // Nothing said is an answer, not a fault of the provider
+        note_failure_once(attempt, attempt->err, elapsed_us);
+    }
+    xQueueSend(job->results, &index, 0);
+    job_release(job);
+    task_placement_note_exit(TASK_PLACEMENT_STT_ATTEMPT);
+    vTaskDelete(NULL);
+}
+
+static bool launch(batch_stt_job_t *job, provider_router_provider_t provider)
+{
+    batch_stt_attempt_t *attempt = &job->attempts[provider];
+    attempt->job = job;
+    attempt->provider = provider;
+    attempt->start_us = esp_timer_get_time();
+    attempt->deadline_us = attempt->start_us + (int64_t)provider_router_timeout_ms(provider, PROVIDER_ROUTER_STT) * 1000;
+    __atomic_add_fetch(&job->refs, 1, __ATOMIC_ACQ_REL);
+    if (task_placement_create(TASK_PLACEMENT_STT_ATTEMPT, attempt_task, attempt, NULL) != pdPASS) {
+        __atomic_sub_fetch(&job->refs, 1, __ATOMIC_ACQ_REL);
+        return false;
+    }
+    attempt->running = true;
+    return true;
+}
+
+static batch_stt_job_t *job_create(const int16_t *pcm, size_t sample_count, int sample_rate_hz,
+                                   uplink_codec_id_t codec)
+{
+    batch_stt_job_t *job = MEM_TAG_CALLOC(MEM_TAG_VOICE_PIPELINE, 1, sizeof(*job));
+    if (!job) {
+        return NULL;
+    }
+    size_t bytes = sample_count * sizeof(int16_t);
+    job->pcm = heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    job->results = xQueueCreate(PROVIDER_ROUTER_COUNT, sizeof(int));
+    if (!job->pcm || !job->results) {
+        if (job->results) {
+            vQueueDelete(job->results);
+        }
+        heap_caps_free(job->pcm);
+        MEM_TAG_FREE(MEM_TAG_VOICE_PIPELINE, job);
+        return NULL;
+    }
+    memcpy(job->pcm, pcm, bytes);
+    job->sample_count = sample_count;
+    job->sample_rate_hz = sample_rate_hz;
+    job->codec = codec;
+    job->refs = 1;
+    job->winner = WINNER_NONE;
+    return job;
+}
+
+// Wait on the attempts, launching failovers and the hedge as they fall due
+static esp_err_t race(batch_stt_job_t *job, provider_router_provider_t primary, uint32_t hedge_after_ms)
+{
+    uint32_t tried = 1u << primary;
+    esp_err_t last_err = ESP_FAIL;
+    int64_t hedge_at_us = hedge_after_ms == UINT32_MAX ? INT64_MAX
+                                                       : esp_timer_get_time() + (int64_t)hedge_after_ms * 1000;
+    if (!launch(job, primary)) {
+        return ESP_ERR_NO_MEM;
+    }
+    for (;;) {
+        int64_t now_us = esp_timer_get_time();
+        int64_t wake_us = hedge_at_us;
+        bool running = false;
+        for (int p = 0; p < PROVIDER_ROUTER_COUNT; ++p) {
+            batch_stt_attempt_t *attempt = &job->attempts[p];
+            if (attempt->running && now_us >= attempt->deadline_us) {
+                // Given up on; it finishes in the background
+                attempt->running = false;
+                note_failure_once(attempt, ESP_ERR_TIMEOUT, now_us - attempt->start_us);
+                ESP_LOGW(TAG, "%s gave no transcript in %lld ms", provider_router_provider_name(attempt->provider),
+                         (long long)((now_us - attempt->start_us) / 1000));
+                last_err = ESP_ERR_TIMEOUT;
+            }
+            if (attempt->running) {
+                running = true;
+                wake_us = attempt->deadline_us < wake_us ? attempt->deadline_us : wake_us;
+            }
+        }
+        bool hedge = running && now_us >= hedge_at_us;
+        if (!running || hedge) {
+            hedge_at_us = INT64_MAX;
+            provider_router_provider_t next = provider_router_next(PROVIDER_ROUTER_STT, tried);
+            if (next != PROVIDER_ROUTER_NONE && (!hedge || provider_router_hedge_take())) {
+                ESP_LOGI(TAG, "%s %s", hedge ? "Hedging with" : "Failing over to",
+                         provider_router_provider_name(next));
+                tried |= 1u << next;
+                if (launch(job, next)) {
+                    continue;
+                }
+            }
+            if (!running) {
+                return last_err;
+            }
+            continue;
+        }
+        int index;
+        TickType_t wait = pdMS_TO_TICKS((wake_us - now_us + 999) / 1000);
+        if (xQueueReceive(job->results, &index, wait ? wait : 1) != pdTRUE) {
+            continue;
+        }
+        if (__atomic_load_n(&job->winner, __ATOMIC_ACQUIRE) == index) {
+            return ESP_OK;
+        }
+        batch_stt_attempt_t *attempt = &job->attempts[index];
+        if (!attempt->running) {
+            continue;  // Failed after being given up on
+        }
+        attempt->running = false;
+        last_err = attempt->err;
+        ESP_LOGW(TAG, "%s STT failed: %s", provider_router_provider_name(attempt->provider),
+                 esp_err_to_name(attempt->err));
+        if (attempt->err == ESP_ERR_NOT_FOUND) {
+            // Heard nothing; another provider would not hear more
+            return last_err;
+        }
+    }
+}
+
+esp_err_t batch_stt_transcribe(const int16_t *pcm, size_t sample_count, int sample_rate_hz, uplink_codec_id_t codec,
+                               char *text, size_t text_len, provider_router_route_t *route)
+{
+    if (!pcm || sample_count == 0 || sample_rate_hz <= 0 || !text || text_len == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    text[0] = '\0';
+    provider_router_provider_t primary = provider_router_pick(PROVIDER_ROUTER_STT);
+    if (primary == PROVIDER_ROUTER_NONE) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    uint32_t clip_ms = (uint32_t)(sample_count * 1000 / (size_t)sample_rate_hz);
+    uint32_t hedge_after_ms = provider_router_hedge_after_ms(primary, clip_ms);
+    int64_t start_us = esp_timer_get_time();
+    batch_stt_job_t *job = NULL;
+    // With nowhere to fail over to, a task and a copy of the audio buy nothing
+    if (hedge_after_ms != UINT32_MAX ||
+        provider_router_next(PROVIDER_ROUTER_STT, 1u << primary) != PROVIDER_ROUTER_NONE) {
+        job = job_create(pcm, sample_count, sample_rate_hz, codec);
+    }
+    if (!job) {
+        esp_err_t err = transcribe(primary, pcm, sample_count, sample_rate_hz, codec, text, text_len);
+        if (err != ESP_OK && err != ESP_ERR_NOT_FOUND) {
+            provider_router_note_failure(primary, PROVIDER_ROUTER_STT, err, esp_timer_get_time() - start_us);
+        } else if (err == ESP_OK && route) {
+            route->provider[PROVIDER_ROUTER_STT] = primary;
+            route->start_us[PROVIDER_ROUTER_STT] = start_us;
+        }
+        return err;
+    }
+
+    esp_err_t err = race(job, primary, hedge_after_ms);
+    int winner_index = WINNER_NONE;
+    if (!__atomic_compare_exchange_n(&job->winner, &winner_index, WINNER_GAVE_UP, false, __ATOMIC_ACQ_REL,
+                                     __ATOMIC_ACQUIRE)) {
+        // Won, possibly by an attempt answering just after the last one failed
+        const batch_stt_attempt_t *winner = &job->attempts[winner_index];
+        err = ESP_OK;
+        strlcpy(text, winner->text, text_len);
+        if (route) {
+            route->provider[PROVIDER_ROUTER_STT] = winner->provider;
+            route->start_us[PROVIDER_ROUTER_STT] = winner->start_us;
+        }
+    }
+    job_release(job);
+    return err;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "provider_router.h"
+#include "uplink_codec.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Batch transcription of one utterance through the provider router.
+ *
+ * Each attempt runs on a task of its own, so the caller can stop waiting
+ * for it: an attempt unanswered after provider_router_timeout_ms() is
+ * given up on and the next provider tried, and a failure moves on at
+ * once. With hedging enabled, a short clip still unanswered after the
+ * provider's usual latency is also sent to the other provider and the
+ * first transcript wins. An abandoned attempt runs to its end in the
+ * background on a copy of the audio, and its latency still counts.
+ *
+ * codec applies to Gemini; OpenAI takes PCM16 WAV.
+ *
+ * @param route When not NULL, gets the serving provider and its start time
+ * @return ESP_ERR_NOT_FOUND for an empty transcript, else the last
+ *         attempt's error (ESP_ERR_TIMEOUT if it was given up on)
+ */
+esp_err_t batch_stt_transcribe(const int16_t *pcm, size_t sample_count, int sample_rate_hz, uplink_codec_id_t codec,
+                               char *text, size_t text_len, provider_router_route_t *route);
+
+#ifdef __cplusplus
+}
+#endif
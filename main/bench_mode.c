@@ -0,0 +1,58 @@
+#include "bench_mode.h"
+
+#include <string.h>
+
+#include "esp_check.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+
+static const char *TAG = "bench_mode";
+
+#define BENCH_MAX_FRAMES ((uint32_t)((uint64_t)CONFIG_KVA_SAMPLE_RATE * CONFIG_KVA_BENCH_MAX_CLIP_MS / 1000))
+
+static korvo_audio_t *s_audio;
+static int16_t *s_clip;               // PSRAM, BENCH_MAX_FRAMES once the first clip arrives
+static uint32_t s_total;
+static uint32_t s_loaded;
+static uint32_t s_runs;
+
+esp_err_t bench_mode_init(korvo_audio_t *audio)
+{
+    ESP_RETURN_ON_FALSE(audio, ESP_ERR_INVALID_ARG, TAG, "audio");
+    s_audio = audio;
+    ESP_LOGW(TAG, "Benchmark build: cloud requests go to %s", CONFIG_KVA_BENCH_CLOUD_HOST);
+    return ESP_OK;
+}
+
+esp_err_t bench_mode_load(uint32_t total_frames, uint32_t first_frame, const int16_t *pcm, uint32_t frames)
+{
+    ESP_RETURN_ON_FALSE(s_audio && (pcm || frames == 0), ESP_ERR_INVALID_ARG, TAG, "args");
+    ESP_RETURN_ON_FALSE(!korvo_audio_injecting(s_audio), ESP_ERR_INVALID_STATE, TAG, "clip playing");
+    ESP_RETURN_ON_FALSE(total_frames > 0 && total_frames <= BENCH_MAX_FRAMES, ESP_ERR_INVALID_SIZE, TAG,
+                        "%lu frames, at most %lu", (unsigned long)total_frames, (unsigned long)BENCH_MAX_FRAMES);
+    if (!s_clip) {
+        s_clip = heap_caps_malloc(BENCH_MAX_FRAMES * sizeof(int16_t), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        ESP_RETURN_ON_FALSE(s_clip, ESP_ERR_NO_MEM, TAG, "clip");
+    }
+    if (first_frame == 0) {
+        s_total = total_frames;
+        s_loaded = 0;
+    }
+    ESP_RETURN_ON_FALSE(total_frames == s_total && first_frame == s_loaded && frames <= s_total - s_loaded,
+                        ESP_ERR_INVALID_STATE, TAG, "piece at %lu out of order", (unsigned long)first_frame);
+    memcpy(s_clip + s_loaded, pcm, frames * sizeof(int16_t));
+    s_loaded += frames;
+    if (s_loaded == s_total) {
+        ESP_LOGI(TAG, "Clip loaded: %lu ms", (unsigned long)((uint64_t)s_total * 1000 / CONFIG_KVA_SAMPLE_RATE));
+    }
+    return ESP_OK;
+}
+
+esp_err_t bench_mode_play(void)
+{
+    ESP_RETURN_ON_FALSE(s_audio, ESP_ERR_INVALID_STATE, TAG, "not initialised");
+    ESP_RETURN_ON_FALSE(s_total > 0 && s_loaded == s_total, ESP_ERR_INVALID_STATE, TAG, "no complete clip");
+    ESP_RETURN_ON_ERROR(korvo_audio_inject(s_audio, s_clip, s_total), TAG, "inject");
+    ESP_LOGI(TAG, "Run %lu: playing %lu frames", (unsigned long)++s_runs, (unsigned long)s_total);
+    return ESP_OK;
+}
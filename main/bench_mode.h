@@ -0,0 +1,44 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "korvo_audio.h"
+#include "kva_config_defaults.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Device side of the end-to-end latency benchmark
+ * (scripts/bench_voice_latency.py). Only built with CONFIG_KVA_BENCH_MODE,
+ * where the cloud clients also point at scripts/mock_cloud_server.py.
+ *
+ * The host uploads a recorded utterance, wake word included, over the
+ * serial link (BENCH_AUDIO frames) and then sends BENCH for each run. The
+ * clip is published into the capture ring in place of the microphones, so
+ * the whole path runs as for a spoken request: AFE, wake word, VAD, uplink,
+ * mock STT/LLM/TTS and playback. Each run ends in the usual
+ * interaction_trace line, which the host parses.
+ */
+
+// Keep the capture context the clip is played into
+esp_err_t bench_mode_init(korvo_audio_t *audio);
+
+/**
+ * Store frames of mono PCM at the capture rate, starting at first_frame of a
+ * total_frames clip; first_frame 0 starts a new clip. Pieces must arrive in
+ * order.
+ *
+ * @return ESP_ERR_INVALID_STATE while a clip plays or on a piece out of
+ *         order, ESP_ERR_INVALID_SIZE past CONFIG_KVA_BENCH_MAX_CLIP_MS
+ */
+esp_err_t bench_mode_load(uint32_t total_frames, uint32_t first_frame, const int16_t *pcm, uint32_t frames);
+
+// Play the complete clip once
+esp_err_t bench_mode_play(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,182 @@
+#include "boot_sequence.h"
+
+#include <string.h>
+
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
+#include "freertos/task.h"
+#include "task_placement.h"
+
+static const char *TAG = "boot";
+
+typedef struct {
+    boot_stage_state_t state;
+    esp_err_t err;
+    int64_t start_us;                 // Since power-on
+    int64_t end_us;
+} stage_status_t;
+
+static const boot_stage_t *s_stages;
+static size_t s_count;
+static stage_status_t s_status[BOOT_SEQUENCE_MAX_STAGES];
+static EventGroupHandle_t s_done_bits;
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static void stage_task(void *arg)
+{
+    size_t index = (size_t)arg;
+    const boot_stage_t *stage = &s_stages[index];
+
+    esp_err_t err = stage->run();
+
+    stage_status_t done;
+    portENTER_CRITICAL(&s_lock);
+    s_status[index].err = err;
+    s_status[index].end_us = esp_timer_get_time();
+    s_status[index].state = err == ESP_OK ? BOOT_STAGE_READY
+                            : err == ESP_ERR_NOT_SUPPORTED ? BOOT_STAGE_DISABLED
+                            : BOOT_STAGE_FAILED;
+    done = s_status[index];
+    portEXIT_CRITICAL(&s_lock);
+
+    int took_ms = (int)((done.end_us - done.start_us) / 1000);
+    int at_ms = (int)(done.end_us / 1000);
+    if (done.state == BOOT_STAGE_FAILED) {
+        ESP_LOGW(TAG, "%s failed after %d ms (%s)", stage->name, took_ms, esp_err_to_name(err));
+    } else {
+        ESP_LOGI(TAG, "%s %s at %d ms (took %d ms)", stage->name, boot_stage_state_name(done.state), at_ms, took_ms);
+    }
+
+    xEventGroupSetBits(s_done_bits, BOOT_AFTER(index));
+    vTaskDelete(NULL);
+}
+
+// Every dependency in range and some order that satisfies them all
+static bool graph_is_valid(const boot_stage_t *stages, size_t count)
+{
+    uint32_t all = (1UL << count) - 1;
+    uint32_t placed = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (!stages[i].run || (stages[i].after & ~all) || (stages[i].after & BOOT_AFTER(i))) {
+            return false;
+        }
+    }
+    while (placed != all) {
+        uint32_t before = placed;
+        for (size_t i = 0; i < count; i++) {
+            if (!(placed & BOOT_AFTER(i)) && (stages[i].after & ~placed) == 0) {
+                placed |= BOOT_AFTER(i);
+            }
+        }
+        if (placed == before) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void log_summary(void)
+{
+    ESP_LOGI(TAG, "Boot finished at %d ms:", (int)(esp_timer_get_time() / 1000));
+    for (size_t i = 0; i < s_count; i++) {
+        stage_status_t st;
+        portENTER_CRITICAL(&s_lock);
+        st = s_status[i];
+        portEXIT_CRITICAL(&s_lock);
+        ESP_LOGI(TAG, "  %-16s %-8s %6d -> %6d ms", s_stages[i].name, boot_stage_state_name(st.state),
+                 (int)(st.start_us / 1000), (int)(st.end_us / 1000));
+    }
+}
+
+esp_err_t boot_sequence_run(const boot_stage_t *stages, size_t count)
+{
+    if (!stages || count == 0 || count > BOOT_SEQUENCE_MAX_STAGES || !graph_is_valid(stages, count)) {
+        ESP_LOGE(TAG, "Invalid boot graph");
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!s_done_bits) {
+        s_done_bits = xEventGroupCreate();
+        if (!s_done_bits) {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    xEventGroupClearBits(s_done_bits, (1UL << count) - 1);
+
+    portENTER_CRITICAL(&s_lock);
+    s_stages = stages;
+    s_count = count;
+    memset(s_status, 0, sizeof(s_status));
+    portEXIT_CRITICAL(&s_lock);
+
+    UBaseType_t priority = uxTaskPriorityGet(NULL);
+    uint32_t all = (1UL << count) - 1;
+    uint32_t launched = 0;
+    uint32_t done = 0;
+    while (done != all) {
+        for (size_t i = 0; i < count; i++) {
+            if ((launched & BOOT_AFTER(i)) || (stages[i].after & ~done)) {
+                continue;
+            }
+            portENTER_CRITICAL(&s_lock);
+            s_status[i].state = BOOT_STAGE_RUNNING;
+            s_status[i].start_us = esp_timer_get_time();
+            portEXIT_CRITICAL(&s_lock);
+            launched |= BOOT_AFTER(i);
+
+            // Off the audio core: stages block on I/O, and the audio tasks
+            // they create pin themselves
+            uint32_t stack = stages[i].stack_bytes ? stages[i].stack_bytes : BOOT_SEQUENCE_DEFAULT_STACK;
+            if (xTaskCreatePinnedToCore(stage_task, stages[i].name, stack, (void *)i, priority, NULL,
+                                        TASK_PLACEMENT_NETWORK_CORE) != pdPASS) {
+                ESP_LOGE(TAG, "No memory for the %s task", stages[i].name);
+                portENTER_CRITICAL(&s_lock);
+                s_status[i].state = BOOT_STAGE_FAILED;
+                s_status[i].err = ESP_ERR_NO_MEM;
+                s_status[i].end_us = s_status[i].start_us;
+                portEXIT_CRITICAL(&s_lock);
+                xEventGroupSetBits(s_done_bits, BOOT_AFTER(i));
+            }
+        }
+        EventBits_t bits = xEventGroupWaitBits(s_done_bits, launched & ~done, pdFALSE, pdFALSE, portMAX_DELAY);
+        done |= (uint32_t)bits & launched;
+    }
+
+    log_summary();
+    return ESP_OK;
+}
+
+boot_stage_state_t boot_sequence_state(const char *name)
+{
+    boot_stage_state_t state = BOOT_STAGE_PENDING;
+    if (!name) {
+        return state;
+    }
+    portENTER_CRITICAL(&s_lock);
+    for (size_t i = 0; i < s_count; i++) {
+        if (strcmp(s_stages[i].name, name) == 0) {
+            state = s_status[i].state;
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&s_lock);
+    return state;
+}
+
+const char *boot_stage_state_name(boot_stage_state_t state)
+{
+    switch (state) {
+    case BOOT_STAGE_PENDING:
+        return "pending";
+    case BOOT_STAGE_RUNNING:
+        return "running";
+    case BOOT_STAGE_READY:
+        return "ready";
+    case BOOT_STAGE_FAILED:
+        return "failed";
+    case BOOT_STAGE_DISABLED:
+        return "disabled";
+    }
+    return "unknown";
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Event group bits available on the coordinator, one per stage
+#define BOOT_SEQUENCE_MAX_STAGES 24
+
+#ifndef BOOT_SEQUENCE_DEFAULT_STACK
+#define BOOT_SEQUENCE_DEFAULT_STACK 4096
+#endif
+
+// Dependency mask entry for boot_stage_t.after
+#define BOOT_AFTER(stage) (1UL << (stage))
+
+typedef enum {
+    BOOT_STAGE_PENDING = 0,
+    BOOT_STAGE_RUNNING,
+    BOOT_STAGE_READY,
+    BOOT_STAGE_FAILED,
+    BOOT_STAGE_DISABLED,              // The stage returned ESP_ERR_NOT_SUPPORTED
+} boot_stage_state_t;
+
+typedef esp_err_t (*boot_stage_fn_t)(void);
+
+typedef struct {
+    const char *name;
+    boot_stage_fn_t run;
+    uint32_t after;                   // BOOT_AFTER() of every stage that must finish first
+    uint32_t stack_bytes;             // 0 = BOOT_SEQUENCE_DEFAULT_STACK
+} boot_stage_t;
+
+/**
+ * Start-up as a dependency graph instead of one long sequence. Each stage
+ * runs on its own short-lived task as soon as every stage it comes after
+ * has finished, so slow independent work (Wi-Fi association, I2C probing,
+ * model loading, reading credentials from flash) overlaps.
+ *
+ * Ordering is all "after" promises: a stage still runs when one it comes
+ * after failed, and should check the services it uses with
+ * boot_sequence_state() where it matters. Each stage's readiness is logged
+ * with its time since power-on as it finishes, followed by a summary.
+ *
+ * Blocks until every stage has finished. Returns ESP_ERR_INVALID_ARG
+ * without running anything for more than BOOT_SEQUENCE_MAX_STAGES stages,
+ * or for dependencies that are out of range or form a cycle. The table
+ * must outlive the boot (a static const array).
+ */
+esp_err_t boot_sequence_run(const boot_stage_t *stages, size_t count);
+
+// BOOT_STAGE_PENDING for names that are not in the running table
+boot_stage_state_t boot_sequence_state(const char *name);
+
+const char *boot_stage_state_name(boot_stage_state_t state);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,191 @@
+#include "breath_monitor.h"
+
+#include <math.h>
+#include <string.h>
+
+#include "audio_eq.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+
+// Breath noise is broadband hiss; this keeps hum, footsteps and HVAC rumble
+// below it and most of the speech band above it out
+#define BREATH_BAND_LOW_HZ 250.0f
+#define BREATH_BAND_HIGH_HZ 1500.0f
+// 6 to 30 breaths per minute
+#define BREATH_MIN_PERIOD_S 2
+#define BREATH_MAX_PERIOD_S 10
+// Weaker autocorrelation peaks are noise, not a rhythm
+#define BREATH_MIN_REGULARITY 0.3f
+
+#define BREATH_SAMPLES_PER_ENVELOPE (CONFIG_KVA_SAMPLE_RATE / BREATH_MONITOR_ENVELOPE_HZ)
+#define BREATH_WINDOW (CONFIG_KVA_BREATH_WINDOW_S * BREATH_MONITOR_ENVELOPE_HZ)
+#define BREATH_MIN_LAG (BREATH_MIN_PERIOD_S * BREATH_MONITOR_ENVELOPE_HZ)
+#define BREATH_MAX_LAG (BREATH_MAX_PERIOD_S * BREATH_MONITOR_ENVELOPE_HZ)
+
+static const char *TAG = "breath";
+
+static struct {
+    volatile bool active;
+    bool reset;                       // Set by set_active, honoured by the feed
+    float band[2][5];                 // High-pass then low-pass
+    float w[2][2];
+    float acc;                        // Sum of |x| toward the next envelope sample
+    uint32_t acc_samples;
+    float envelope[BREATH_WINDOW];    // Ring, oldest at head once full
+    uint32_t head;
+    uint32_t filled;
+    uint32_t since_estimate;          // Envelope samples since the last estimate
+    portMUX_TYPE lock;                // Guards stats
+    breath_monitor_stats_t stats;
+} s_breath = { .lock = portMUX_INITIALIZER_UNLOCKED };
+
+void breath_monitor_set_active(bool active)
+{
+#if CONFIG_KVA_BREATH_MONITOR
+    if (active == s_breath.active) {
+        return;
+    }
+    portENTER_CRITICAL(&s_breath.lock);
+    memset(&s_breath.stats, 0, sizeof(s_breath.stats));
+    s_breath.stats.active = active;
+    portEXIT_CRITICAL(&s_breath.lock);
+    s_breath.reset = true;
+    s_breath.active = active;
+    ESP_LOGI(TAG, "Breathing monitor %s", active ? "started" : "stopped");
+#else
+    (void)active;
+#endif
+}
+
+void breath_monitor_sleep_cb(bool sleeping, void *ctx)
+{
+    (void)ctx;
+    breath_monitor_set_active(sleeping);
+}
+
+static void restart(void)
+{
+    audio_eq_design_highpass(s_breath.band[0], CONFIG_KVA_SAMPLE_RATE, BREATH_BAND_LOW_HZ, 0.707f);
+    audio_eq_design_lowpass(s_breath.band[1], CONFIG_KVA_SAMPLE_RATE, BREATH_BAND_HIGH_HZ, 0.707f);
+    memset(s_breath.w, 0, sizeof(s_breath.w));
+    s_breath.acc = 0.0f;
+    s_breath.acc_samples = 0;
+    s_breath.head = 0;
+    s_breath.filled = 0;
+    s_breath.since_estimate = 0;
+    s_breath.reset = false;
+}
+
+// Strongest period in the window by normalised autocorrelation
+static void estimate(void)
+{
+    static float x[BREATH_WINDOW];
+    float mean = 0.0f;
+    for (uint32_t i = 0; i < BREATH_WINDOW; ++i) {
+        x[i] = s_breath.envelope[(s_breath.head + i) % BREATH_WINDOW];
+        mean += x[i];
+    }
+    mean /= BREATH_WINDOW;
+    float energy = 0.0f;
+    for (uint32_t i = 0; i < BREATH_WINDOW; ++i) {
+        x[i] -= mean;
+        energy += x[i] * x[i];
+    }
+
+    float r[BREATH_MAX_LAG + 2];
+    for (uint32_t lag = BREATH_MIN_LAG - 1; lag <= BREATH_MAX_LAG + 1; ++lag) {
+        float sum = 0.0f;
+        for (uint32_t i = 0; i + lag < BREATH_WINDOW; ++i) {
+            sum += x[i] * x[i + lag];
+        }
+        // Unbiased: longer lags overlap fewer samples
+        r[lag] = energy > 0.0f ? sum / energy * BREATH_WINDOW / (BREATH_WINDOW - lag) : 0.0f;
+    }
+    uint32_t best = 0;
+    for (uint32_t lag = BREATH_MIN_LAG; lag <= BREATH_MAX_LAG; ++lag) {
+        if (r[lag] >= r[lag - 1] && r[lag] >= r[lag + 1] && (best == 0 || r[lag] > r[best])) {
+            best = lag;
+        }
+    }
+
+    breath_monitor_stats_t stats;
+    portENTER_CRITICAL(&s_breath.lock);
+    stats = s_breath.stats;
+    portEXIT_CRITICAL(&s_breath.lock);
+    stats.updated_us = esp_timer_get_time();
+    stats.valid = best > 0 && r[best] >= BREATH_MIN_REGULARITY;
+    if (stats.valid) {
+        // Parabolic interpolation between the envelope samples
+        float denom = r[best - 1] - 2.0f * r[best] + r[best + 1];
+        float offset = denom < 0.0f ? 0.5f * (r[best - 1] - r[best + 1]) / denom : 0.0f;
+        float period_s = ((float)best + offset) / BREATH_MONITOR_ENVELOPE_HZ;
+        stats.breaths_per_min = 60.0f / period_s;
+        stats.regularity = r[best] > 1.0f ? 1.0f : r[best];
+        stats.estimates++;
+    }
+    portENTER_CRITICAL(&s_breath.lock);
+    if (s_breath.stats.active) {
+        s_breath.stats = stats;
+    }
+    portEXIT_CRITICAL(&s_breath.lock);
+    if (stats.valid) {
+        ESP_LOGD(TAG, "%.1f breaths/min, regularity %.2f", stats.breaths_per_min, stats.regularity);
+    }
+}
+
+static void push_envelope(float value)
+{
+    s_breath.envelope[s_breath.head] = value;
+    s_breath.head = (s_breath.head + 1) % BREATH_WINDOW;
+    if (s_breath.filled < BREATH_WINDOW) {
+        s_breath.filled++;
+    }
+    if (++s_breath.since_estimate >= CONFIG_KVA_BREATH_UPDATE_S * BREATH_MONITOR_ENVELOPE_HZ &&
+        s_breath.filled == BREATH_WINDOW) {
+        s_breath.since_estimate = 0;
+        estimate();
+    }
+}
+
+void breath_monitor_feed(const int16_t *mono, size_t samples)
+{
+#if CONFIG_KVA_BREATH_MONITOR
+    if (!s_breath.active || !mono) {
+        return;
+    }
+    if (s_breath.reset) {
+        restart();
+    }
+    for (size_t i = 0; i < samples; ++i) {
+        float v = (float)mono[i];
+        for (int s = 0; s < 2; ++s) {
+            const float *c = s_breath.band[s];
+            float *w = s_breath.w[s];
+            float d0 = v - c[3] * w[0] - c[4] * w[1];
+            v = c[0] * d0 + c[1] * w[0] + c[2] * w[1];
+            w[1] = w[0];
+            w[0] = d0;
+        }
+        s_breath.acc += fabsf(v);
+        if (++s_breath.acc_samples == BREATH_SAMPLES_PER_ENVELOPE) {
+            push_envelope(logf(1.0f + s_breath.acc / BREATH_SAMPLES_PER_ENVELOPE));
+            s_breath.acc = 0.0f;
+            s_breath.acc_samples = 0;
+        }
+    }
+#else
+    (void)mono;
+    (void)samples;
+#endif
+}
+
+void breath_monitor_get(breath_monitor_stats_t *out)
+{
+    if (!out) {
+        return;
+    }
+    portENTER_CRITICAL(&s_breath.lock);
+    *out = s_breath.stats;
+    portEXIT_CRITICAL(&s_breath.lock);
+}
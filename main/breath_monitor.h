@@ -0,0 +1,50 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "kva_config_defaults.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Breathing rate from the AFE output while the device is in sleep mode.
+ *
+ * The processed signal is band-limited to where breath noise sits, and its
+ * envelope is taken at BREATH_MONITOR_ENVELOPE_HZ (log-compressed, so a
+ * cough does not swamp a minute of breaths). Every
+ * CONFIG_KVA_BREATH_UPDATE_S the autocorrelation of the last
+ * CONFIG_KVA_BREATH_WINDOW_S of envelope is searched for its strongest
+ * period between 2 and 10 s. The period gives the rate, and the height of
+ * the peak shows how regular the breathing is. Outside sleep mode the feed
+ * returns at once, so it costs nothing by day.
+ */
+
+#define BREATH_MONITOR_ENVELOPE_HZ 5
+
+typedef struct {
+    bool active;                      // Running (sleep mode)
+    bool valid;                       // The last estimate found a steady rhythm
+    float breaths_per_min;
+    float regularity;                 // Autocorrelation peak, 0..1; 1 = perfectly periodic
+    uint32_t estimates;               // Valid estimates since it was started
+    int64_t updated_us;               // esp_timer time of the last estimate
+} breath_monitor_stats_t;
+
+// Start or stop; the envelope history starts over each time
+void breath_monitor_set_active(bool active);
+
+// device_state sleep listener: runs the monitor while sleep mode is on
+void breath_monitor_sleep_cb(bool sleeping, void *ctx);
+
+// Mono AFE output at CONFIG_KVA_SAMPLE_RATE, from the AFE task
+void breath_monitor_feed(const int16_t *mono, size_t samples);
+
+void breath_monitor_get(breath_monitor_stats_t *out);
+
+#ifdef __cplusplus
+}
+#endif
@@ -6,68 +6,175 @@
 #include "esp_check.h"
 #include "esp_log.h"
 #include "esp_timer.h"
-#include "freertos/FreeRTOS.h"
-#include "freertos/queue.h"
-#include "freertos/task.h"
 
 #define BUTTON_SERVICE_MAX_BUTTONS 4
+// Power of two. A pin stays masked from its edge until it is re-armed, so
+// at most one edge per button is ever queued and the ring cannot overflow.
+#define BUTTON_SERVICE_EDGE_RING 8
+#define BUTTON_SERVICE_LONG_PRESS_MS 800
+
+_Static_assert(BUTTON_SERVICE_EDGE_RING >= BUTTON_SERVICE_MAX_BUTTONS, "edge ring must hold one edge per button");
 
 typedef struct {
     const button_service_button_t *def;
     button_service_t *owner;
-    uint64_t last_press_us;
+    uint8_t index;
+    // Timer callback only
+    bool pressed;
+    bool long_sent;
+    int64_t pressed_at_us;
+    int64_t rearm_at_us;              // Pin masked until then; 0 while armed
 } button_info_t;
 
 typedef struct {
-    int id;
-} button_event_t;
+    uint8_t index;
+    int64_t at_us;
+} button_edge_t;
 
 struct button_service {
     button_info_t buttons[BUTTON_SERVICE_MAX_BUTTONS];
     size_t button_count;
     button_service_cb_t callback;
     void *callback_ctx;
-    uint32_t debounce_us;
-    QueueHandle_t queue;
-    TaskHandle_t task;
+    button_service_event_cb_t event_callback;
+    int64_t debounce_us;
+    int64_t long_press_us;
+    esp_timer_handle_t timer;
+
+    // Single producer (the GPIO ISR), single consumer (the timer callback)
+    button_edge_t edges[BUTTON_SERVICE_EDGE_RING];
+    uint32_t edge_head;               // Written by the ISR (atomic)
+    uint32_t edge_tail;               // Written by the timer callback (atomic)
 };
 
 static const char *TAG = "button_service";
 
-static void button_service_task(void *arg)
+static gpio_int_type_t watch_level(const button_info_t *info, bool for_press)
+{
+    // Active-low buttons read 0 while pressed
+    return (info->def->active_low == for_press) ? GPIO_INTR_LOW_LEVEL : GPIO_INTR_HIGH_LEVEL;
+}
+
+static uint32_t held_mask(const button_service_t *service)
+{
+    uint32_t mask = 0;
+    for (size_t i = 0; i < service->button_count; ++i) {
+        if (service->buttons[i].pressed) {
+            mask |= 1u << i;
+        }
+    }
+    return mask;
+}
+
+static void emit(button_service_t *service, button_info_t *info, button_service_event_type_t type, int64_t now_us)
+{
+    if (type == BUTTON_SERVICE_EVENT_PRESS && service->callback) {
+        service->callback(info->def->id, service->callback_ctx);
+    }
+    if (service->event_callback) {
+        button_service_event_t event = {
+            .type = type,
+            .button_id = info->def->id,
+            .held_mask = held_mask(service),
+            .duration_ms = type == BUTTON_SERVICE_EVENT_RELEASE || type == BUTTON_SERVICE_EVENT_LONG_PRESS
+                ? (uint32_t)((now_us - info->pressed_at_us) / 1000) : 0,
+        };
+        service->event_callback(&event, service->callback_ctx);
+    }
+}
+
+// The pin fired at the level it was armed for, so every edge flips the state
+static void handle_edge(button_service_t *service, button_info_t *info, int64_t at_us)
+{
+    if (!info->pressed) {
+        info->pressed = true;
+        info->long_sent = false;
+        info->pressed_at_us = at_us;
+        emit(service, info, BUTTON_SERVICE_EVENT_PRESS, at_us);
+        if (held_mask(service) != (1u << info->index)) {
+            emit(service, info, BUTTON_SERVICE_EVENT_CHORD, at_us);
+        }
+    } else {
+        // Reported before the flag drops so held_mask still includes this button
+        emit(service, info, BUTTON_SERVICE_EVENT_RELEASE, at_us);
+        info->pressed = false;
+    }
+    info->rearm_at_us = at_us + service->debounce_us;
+}
+
+// Watch for the opposite level. If the pin is already there (a tap shorter
+// than the debounce), the interrupt fires right away and nothing is lost.
+static void rearm(button_info_t *info)
+{
+    gpio_int_type_t level = watch_level(info, !info->pressed);
+    gpio_set_intr_type(info->def->gpio, level);
+    gpio_wakeup_enable(info->def->gpio, level);
+    info->rearm_at_us = 0;
+    gpio_intr_enable(info->def->gpio);
+}
+
+static void button_timer_cb(void *arg)
 {
     button_service_t *service = (button_service_t *)arg;
-    button_event_t evt;
-    while (xQueueReceive(service->queue, &evt, portMAX_DELAY) == pdTRUE) {
-        if (service->callback) {
-            service->callback(evt.id, service->callback_ctx);
+
+    uint32_t tail = service->edge_tail;
+    uint32_t head = __atomic_load_n(&service->edge_head, __ATOMIC_ACQUIRE);
+    while (tail != head) {
+        const button_edge_t *edge = &service->edges[tail % BUTTON_SERVICE_EDGE_RING];
+        handle_edge(service, &service->buttons[edge->index], edge->at_us);
+        tail++;
+    }
+    __atomic_store_n(&service->edge_tail, tail, __ATOMIC_RELEASE);
+
+    int64_t now = esp_timer_get_time();
+    int64_t next = INT64_MAX;
+    for (size_t i = 0; i < service->button_count; ++i) {
+        button_info_t *info = &service->buttons[i];
+        if (info->pressed && !info->long_sent) {
+            int64_t due = info->pressed_at_us + service->long_press_us;
+            if (now >= due) {
+                info->long_sent = true;
+                emit(service, info, BUTTON_SERVICE_EVENT_LONG_PRESS, now);
+            } else if (due < next) {
+                next = due;
+            }
+        }
+        if (info->rearm_at_us) {
+            if (now >= info->rearm_at_us) {
+                rearm(info);
+            } else if (info->rearm_at_us < next) {
+                next = info->rearm_at_us;
+            }
         }
     }
-    vTaskDelete(NULL);
+
+    // Fails only when the ISR has already queued another run, which
+    // recomputes the deadlines anyway
+    if (next != INT64_MAX) {
+        esp_timer_start_once(service->timer, (uint64_t)(next - now));
+    }
 }
 
+// Masks the pin and hands the edge to the timer callback straight away
 static void IRAM_ATTR gpio_isr_handler(void *arg)
 {
     button_info_t *info = (button_info_t *)arg;
-    if (!info || !info->def) {
+    if (!info || !info->def || !info->owner) {
         return;
     }
     button_service_t *service = info->owner;
-    if (!service || !service->queue) {
-        return;
-    }
-    int level = gpio_get_level(info->def->gpio);
-    bool pressed = info->def->active_low ? (level == 0) : (level == 1);
-    if (!pressed) {
-        return;
-    }
-    uint64_t now = esp_timer_get_time();
-    if (now - info->last_press_us < service->debounce_us) {
-        return;
-    }
-    info->last_press_us = now;
-    button_event_t evt = { .id = info->def->id };
-    xQueueSendFromISR(service->queue, &evt, NULL);
+    gpio_intr_disable(info->def->gpio);
+
+    uint32_t head = service->edge_head;
+    service->edges[head % BUTTON_SERVICE_EDGE_RING] = (button_edge_t){
+        .index = info->index,
+        .at_us = esp_timer_get_time(),
+    };
+    __atomic_store_n(&service->edge_head, head + 1, __ATOMIC_RELEASE);
+
+    // Pull a pending long-press or debounce deadline forward to now
+    esp_timer_stop(service->timer);
+    esp_timer_start_once(service->timer, 0);
 }
 
 button_service_t *button_service_start(const button_service_config_t *config)
@@ -83,18 +190,24 @@ button_service_t *button_service_start(const button_service_config_t *config)
     service->button_count = config->button_count;
     service->callback = config->callback;
     service->callback_ctx = config->callback_ctx;
-    service->debounce_us = (config->debounce_ms ? config->debounce_ms : 75) * 1000;
-    service->queue = xQueueCreate(8, sizeof(button_event_t));
-
-    if (!service->queue) {
+    service->event_callback = config->event_callback;
+    service->debounce_us = (int64_t)(config->debounce_ms ? config->debounce_ms : 75) * 1000;
+    service->long_press_us = (int64_t)(config->long_press_ms ? config->long_press_ms : BUTTON_SERVICE_LONG_PRESS_MS) * 1000;
+
+    const esp_timer_create_args_t timer_args = {
+        .callback = button_timer_cb,
+        .arg = service,
+        .name = "buttons",
+    };
+    if (esp_timer_create(&timer_args, &service->timer) != ESP_OK) {
         free(service);
         return NULL;
     }
 
     for (size_t i = 0; i < config->button_count; ++i) {
         service->buttons[i].def = &config->buttons[i];
-        service->buttons[i].last_press_us = 0;
         service->buttons[i].owner = service;
+        service->buttons[i].index = (uint8_t)i;
     }
 
     static bool isr_service_installed = false;
@@ -110,17 +223,12 @@ button_service_t *button_service_start(const button_service_config_t *config)
             .mode = GPIO_MODE_INPUT,
             .pull_up_en = btn->active_low ? GPIO_PULLUP_ENABLE : GPIO_PULLUP_DISABLE,
             .pull_down_en = btn->active_low ? GPIO_PULLDOWN_DISABLE : GPIO_PULLDOWN_ENABLE,
-            .intr_type = btn->active_low ? GPIO_INTR_NEGEDGE : GPIO_INTR_POSEDGE,
+            .intr_type = watch_level(&service->buttons[i], true),
         };
-        gpio_config(&io_conf);
-
+        // Handler first: a held button would otherwise fire with nobody to mask it
         gpio_isr_handler_add(btn->gpio, gpio_isr_handler, &service->buttons[i]);
-    }
-
-    BaseType_t rc = xTaskCreate(button_service_task, "button_service", 2048, service, 5, &service->task);
-    if (rc != pdPASS) {
-        button_service_stop(service);
-        return NULL;
+        gpio_config(&io_conf);
+        gpio_wakeup_enable(btn->gpio, io_conf.intr_type);
     }
 
     ESP_LOGI(TAG, "Button service started with %d inputs", (int)service->button_count);
@@ -134,14 +242,13 @@ void button_service_stop(button_service_t *service)
     }
     for (size_t i = 0; i < service->button_count; ++i) {
         if (service->buttons[i].def) {
+            gpio_wakeup_disable(service->buttons[i].def->gpio);
             gpio_isr_handler_remove(service->buttons[i].def->gpio);
         }
     }
-    if (service->task) {
-        vTaskDelete(service->task);
-    }
-    if (service->queue) {
-        vQueueDelete(service->queue);
+    if (service->timer) {
+        esp_timer_stop(service->timer);
+        esp_timer_delete(service->timer);
     }
     free(service);
 }
@@ -2,6 +2,7 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
 #include "esp_err.h"
 #include "hal/gpio_types.h"
@@ -16,18 +17,43 @@ typedef struct {
     bool active_low;
 } button_service_button_t;
 
+typedef enum {
+    BUTTON_SERVICE_EVENT_PRESS,       // Leading edge; bounces after it are ignored
+    BUTTON_SERVICE_EVENT_RELEASE,
+    BUTTON_SERVICE_EVENT_LONG_PRESS,  // Still held after long_press_ms
+    BUTTON_SERVICE_EVENT_CHORD,       // Pressed while others were held; held_mask has them all
+} button_service_event_type_t;
+
+typedef struct {
+    button_service_event_type_t type;
+    int button_id;
+    uint32_t held_mask;               // Bit i set while buttons[i] (config order) is down
+    uint32_t duration_ms;             // RELEASE and LONG_PRESS: time since the press
+} button_service_event_t;
+
+// Both callbacks run in the esp_timer task: keep them short and never block
 typedef void (*button_service_cb_t)(int button_id, void *ctx);
+typedef void (*button_service_event_cb_t)(const button_service_event_t *event, void *ctx);
 
 typedef struct button_service button_service_t;
 
 typedef struct {
     const button_service_button_t *buttons;
     size_t button_count;
-    button_service_cb_t callback;
+    button_service_cb_t callback;     // On every press
     void *callback_ctx;
+    button_service_event_cb_t event_callback;  // Optional: every event, after callback
     uint32_t debounce_ms;
+    uint32_t long_press_ms;           // 0 = 800
 } button_service_config_t;
 
+/**
+ * Buttons are level-triggered GPIO interrupts, so they also wake the chip
+ * from light sleep. The ISR masks the pin and queues a timestamped edge;
+ * an esp_timer callback runs the press/release/long-press/chord state and
+ * arms the pin for the opposite level once the debounce has passed. Nothing
+ * polls: between edges the service only runs for a pending long press.
+ */
 button_service_t *button_service_start(const button_service_config_t *config);
 void button_service_stop(button_service_t *service);
 
@@ -0,0 +1,139 @@
+#include "control_coalescer.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+#include "esp_check.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "timer_wheel.h"
+
+static const char *TAG = "control_coalescer";
+
+struct control_coalescer {
+    portMUX_TYPE lock;
+    int target;
+    float current;                    // Where the glide is; wheel task, and sync
+    int applied;                      // Last value handed to apply
+    bool running;                     // The timer is armed or about to be
+    float alpha;                      // Fraction of the gap closed per tick
+    int step;
+    uint32_t period_ms;
+    control_coalescer_apply_t apply;
+    void *ctx;
+    timer_wheel_timer_t *timer;
+};
+
+static void coalescer_tick(void *arg)
+{
+    control_coalescer_t *c = (control_coalescer_t *)arg;
+    portENTER_CRITICAL(&c->lock);
+    int target = c->target;
+    float gap = (float)target - c->current;
+    // Within half a step of the target there is nothing left worth gliding through
+    c->current = fabsf(gap) * 2.0f <= (float)c->step ? (float)target : c->current + gap * c->alpha;
+    bool settled = c->current == (float)target;
+    int value = settled ? target : (int)lroundf(c->current);
+    bool apply = settled ? value != c->applied || gap != 0.0f : abs(value - c->applied) >= c->step;
+    if (apply) {
+        c->applied = value;
+    }
+    portEXIT_CRITICAL(&c->lock);
+
+    if (apply) {
+        c->apply(value, settled, c->ctx);
+    }
+    if (!settled) {
+        return;
+    }
+
+    // Stop before looking again, so a set() in between either is seen here or sees the timer stopped
+    timer_wheel_stop(c->timer);
+    portENTER_CRITICAL(&c->lock);
+    bool moved = c->target != target;
+    c->running = moved;
+    portEXIT_CRITICAL(&c->lock);
+    if (moved) {
+        timer_wheel_start_periodic(c->timer, c->period_ms);
+    }
+}
+
+esp_err_t control_coalescer_create(const control_coalescer_config_t *config, control_coalescer_t **out)
+{
+    ESP_RETURN_ON_FALSE(config && config->apply && out, ESP_ERR_INVALID_ARG, TAG, "config");
+    control_coalescer_t *c = calloc(1, sizeof(*c));
+    ESP_RETURN_ON_FALSE(c, ESP_ERR_NO_MEM, TAG, "coalescer");
+    uint32_t rate_hz = config->rate_hz ? config->rate_hz : CONFIG_KVA_CONTROL_RATE_HZ;
+    portMUX_INITIALIZE(&c->lock);
+    c->target = config->initial;
+    c->current = (float)config->initial;
+    c->applied = config->initial;
+    c->step = config->step > 0 ? config->step : 1;
+    c->period_ms = rate_hz ? (1000 + rate_hz - 1) / rate_hz : 1000;
+    c->alpha = config->smoothing_ms ? 1.0f - expf(-(float)c->period_ms / (float)config->smoothing_ms) : 1.0f;
+    c->apply = config->apply;
+    c->ctx = config->ctx;
+
+    const timer_wheel_timer_config_t timer_cfg = {
+        .callback = coalescer_tick,
+        .arg = c,
+        .name = config->name ? config->name : TAG,
+    };
+    esp_err_t err = timer_wheel_create(&timer_cfg, &c->timer);
+    if (err != ESP_OK) {
+        free(c);
+        return err;
+    }
+    *out = c;
+    return ESP_OK;
+}
+
+void control_coalescer_delete(control_coalescer_t *c)
+{
+    if (!c) {
+        return;
+    }
+    timer_wheel_delete(c->timer);
+    free(c);
+}
+
+void control_coalescer_set(control_coalescer_t *c, int target)
+{
+    portENTER_CRITICAL(&c->lock);
+    c->target = target;
+    bool start = !c->running;
+    c->running = true;
+    portEXIT_CRITICAL(&c->lock);
+    if (start) {
+        timer_wheel_start_periodic(c->timer, c->period_ms);
+    }
+}
+
+int control_coalescer_add(control_coalescer_t *c, int delta, int lo, int hi)
+{
+    portENTER_CRITICAL(&c->lock);
+    int target = c->target + delta;
+    target = target < lo ? lo : (target > hi ? hi : target);
+    c->target = target;
+    bool start = !c->running;
+    c->running = true;
+    portEXIT_CRITICAL(&c->lock);
+    if (start) {
+        timer_wheel_start_periodic(c->timer, c->period_ms);
+    }
+    return target;
+}
+
+int control_coalescer_target(const control_coalescer_t *c)
+{
+    return __atomic_load_n(&c->target, __ATOMIC_RELAXED);
+}
+
+void control_coalescer_sync(control_coalescer_t *c, int value)
+{
+    portENTER_CRITICAL(&c->lock);
+    c->target = value;
+    c->current = (float)value;
+    c->applied = value;
+    portEXIT_CRITICAL(&c->lock);
+}
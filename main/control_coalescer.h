@@ -0,0 +1,61 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "kva_config_defaults.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Coalesces a control that is set far more often than it is worth applying:
+ * a volume or brightness slider over BLE or MQTT, "louder" said three times
+ * in a row, an ambient light reading every sample.
+ *
+ * Setters only record the latest target and return; a timer_wheel.h timer
+ * at the control's rate (CONFIG_KVA_CONTROL_RATE_HZ by default) glides the
+ * applied value towards it and calls apply with the result. Targets that
+ * are superseded before a tick are never applied, and the timer stops once
+ * the value has arrived, so an idle control costs nothing.
+ *
+ * apply runs on the timer_wheel task and must not block for long. Its
+ * settled argument is true for the last call of a glide, for work that
+ * only the final value deserves (telling a remote, saving the setting).
+ */
+typedef void (*control_coalescer_apply_t)(int value, bool settled, void *ctx);
+
+typedef struct control_coalescer control_coalescer_t;
+
+typedef struct {
+    const char *name;                 // For logs and the timer; not copied
+    control_coalescer_apply_t apply;
+    void *ctx;
+    int initial;                      // Taken as already applied
+    uint32_t rate_hz;                 // 0 = CONFIG_KVA_CONTROL_RATE_HZ
+    uint32_t smoothing_ms;            // Time constant of the glide, 0 = jump to each target
+    int step;                         // Smallest change worth applying mid-glide, 0 = 1
+} control_coalescer_config_t;
+
+// Needs timer_wheel_init() to have run
+esp_err_t control_coalescer_create(const control_coalescer_config_t *config, control_coalescer_t **out);
+
+// Not from apply, or while apply may be running
+void control_coalescer_delete(control_coalescer_t *c);
+
+// Latest wins; callable from any task
+void control_coalescer_set(control_coalescer_t *c, int target);
+
+// Move the target by delta within [lo, hi], from the target rather than the applied value; returns the new target
+int control_coalescer_add(control_coalescer_t *c, int delta, int lo, int hi);
+
+int control_coalescer_target(const control_coalescer_t *c);
+
+// The control was changed elsewhere (a remote, a user on the device): take value as applied and as the target
+void control_coalescer_sync(control_coalescer_t *c, int value);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,200 @@
+#include "conversation_memory.h"
+
+#include <string.h>
+
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "kva_config_defaults.h"
+#include "mem_tags.h"
+
+// Summary line kept per folded turn, before its "User: "/"Assistant: " label
+#define SUMMARY_LINE_CHARS 96
+
+static const char *TAG = "conversation";
+
+static SemaphoreHandle_t s_lock;
+static portMUX_TYPE s_init_lock = portMUX_INITIALIZER_UNLOCKED;
+// PSRAM: turn text packed oldest first, then the summary
+static char *s_text;
+static size_t s_text_used;
+static char *s_summary;
+static conversation_turn_t s_turns[CONFIG_KVA_CONVERSATION_TURNS];
+static size_t s_turn_count;
+static TickType_t s_last_turn;
+
+static bool memory_lock(void)
+{
+    if (!s_lock) {
+        SemaphoreHandle_t lock = xSemaphoreCreateMutex();
+        portENTER_CRITICAL(&s_init_lock);
+        if (!s_lock) {
+            s_lock = lock;
+            lock = NULL;
+        }
+        portEXIT_CRITICAL(&s_init_lock);
+        if (lock) {
+            vSemaphoreDelete(lock);
+        }
+        if (!s_lock) {
+            return false;
+        }
+    }
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    return true;
+}
+
+// Under s_lock
+static void clear_locked(void)
+{
+    s_turn_count = 0;
+    s_text_used = 0;
+    if (s_summary) {
+        s_summary[0] = '\0';
+    }
+}
+
+// Bytes of s that fit in max without splitting a UTF-8 sequence
+static size_t utf8_fit(const char *s, size_t len, size_t max)
+{
+    if (len <= max) {
+        return len;
+    }
+    while (max > 0 && ((unsigned char)s[max] & 0xC0) == 0x80) {
+        max--;
+    }
+    return max;
+}
+
+// Append the first sentence of the oldest turn to the summary, dropping the
+// oldest summary lines to make room
+static void fold_into_summary(const conversation_turn_t *turn)
+{
+    const char *label = turn->role == CONVERSATION_ROLE_USER ? "User: " : "Assistant: ";
+    size_t len = strcspn(turn->text, ".!?");
+    if (turn->text[len] != '\0') {
+        len++;
+    }
+    len = utf8_fit(turn->text, len, SUMMARY_LINE_CHARS);
+    size_t line = strlen(label) + len + 1;
+    if (line >= CONFIG_KVA_CONVERSATION_SUMMARY_CHARS) {
+        return;
+    }
+
+    size_t used = strlen(s_summary);
+    while (used + line >= CONFIG_KVA_CONVERSATION_SUMMARY_CHARS) {
+        char *next = strchr(s_summary, '\n');
+        size_t drop = next ? (size_t)(next - s_summary) + 1 : used;
+        memmove(s_summary, s_summary + drop, used - drop + 1);
+        used -= drop;
+    }
+    char *p = s_summary + used;
+    memcpy(p, label, strlen(label));
+    p += strlen(label);
+    memcpy(p, turn->text, len);
+    p[len] = '\n';
+    p[len + 1] = '\0';
+}
+
+// Fold the oldest turn and close the gap it leaves in s_text
+static void evict_oldest(void)
+{
+    fold_into_summary(&s_turns[0]);
+    size_t drop = strlen(s_turns[0].text) + 1;
+    memmove(s_text, s_text + drop, s_text_used - drop);
+    s_text_used -= drop;
+    for (size_t i = 1; i < s_turn_count; ++i) {
+        s_turns[i - 1].role = s_turns[i].role;
+        s_turns[i - 1].text = s_turns[i].text - drop;
+    }
+    s_turn_count--;
+}
+
+static void append_turn(conversation_role_t role, const char *text)
+{
+    size_t len = utf8_fit(text, strlen(text), CONFIG_KVA_CONVERSATION_BUDGET_BYTES - 1);
+    if (len == 0) {
+        return;
+    }
+    while (s_turn_count > 0 &&
+           (s_turn_count == CONFIG_KVA_CONVERSATION_TURNS || s_text_used + len + 1 > CONFIG_KVA_CONVERSATION_BUDGET_BYTES)) {
+        evict_oldest();
+    }
+    char *dst = s_text + s_text_used;
+    memcpy(dst, text, len);
+    dst[len] = '\0';
+    s_text_used += len + 1;
+    s_turns[s_turn_count++] = (conversation_turn_t){.role = role, .text = dst};
+}
+
+// Under s_lock
+static bool expire_locked(TickType_t now)
+{
+    if ((s_turn_count || (s_summary && s_summary[0])) &&
+        now - s_last_turn > pdMS_TO_TICKS(CONFIG_KVA_CONVERSATION_IDLE_S * 1000)) {
+        ESP_LOGI(TAG, "Idle for %ds, forgetting %u turns", CONFIG_KVA_CONVERSATION_IDLE_S, (unsigned)s_turn_count);
+        clear_locked();
+    }
+    return s_turn_count > 0 || (s_summary && s_summary[0]);
+}
+
+void conversation_memory_add(const char *user_text, const char *assistant_text)
+{
+    if (!memory_lock()) {
+        return;
+    }
+    if (!s_text) {
+        size_t bytes = CONFIG_KVA_CONVERSATION_BUDGET_BYTES + CONFIG_KVA_CONVERSATION_SUMMARY_CHARS;
+        s_text = MEM_TAG_CAPS_MALLOC(MEM_TAG_VOICE_PIPELINE, bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        if (!s_text) {
+            s_text = MEM_TAG_MALLOC(MEM_TAG_VOICE_PIPELINE, bytes);
+        }
+        if (!s_text) {
+            ESP_LOGW(TAG, "No memory for conversation history");
+            xSemaphoreGive(s_lock);
+            return;
+        }
+        s_summary = s_text + CONFIG_KVA_CONVERSATION_BUDGET_BYTES;
+        clear_locked();
+    }
+    TickType_t now = xTaskGetTickCount();
+    expire_locked(now);
+    if (user_text) {
+        append_turn(CONVERSATION_ROLE_USER, user_text);
+    }
+    if (assistant_text) {
+        append_turn(CONVERSATION_ROLE_ASSISTANT, assistant_text);
+    }
+    s_last_turn = now;
+    xSemaphoreGive(s_lock);
+}
+
+void conversation_memory_clear(void)
+{
+    if (memory_lock()) {
+        clear_locked();
+        xSemaphoreGive(s_lock);
+    }
+}
+
+bool conversation_memory_acquire(conversation_view_t *view)
+{
+    if (!s_text || !memory_lock()) {
+        return false;
+    }
+    if (!expire_locked(xTaskGetTickCount())) {
+        xSemaphoreGive(s_lock);
+        return false;
+    }
+    view->summary = s_summary;
+    view->turns = s_turns;
+    view->turn_count = s_turn_count;
+    return true;
+}
+
+void conversation_memory_release(void)
+{
+    xSemaphoreGive(s_lock);
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * The last few LLM turns, spliced into each LLM request so a follow-up
+ * ("make them dimmer") has something to refer to.
+ *
+ * Turns are kept oldest first in one PSRAM buffer of
+ * CONFIG_KVA_CONVERSATION_BUDGET_BYTES, which bounds what history adds to a
+ * request (about a token per four bytes). A turn pushed out by the turn
+ * count or the budget is folded into a short summary: its first sentence,
+ * with the oldest summary lines dropped as new ones arrive. History left
+ * alone for CONFIG_KVA_CONVERSATION_IDLE_S is forgotten.
+ *
+ * Like the interaction arena, there is one history for the device; the LLM
+ * clients read it without it being threaded through their calls.
+ */
+
+typedef enum {
+    CONVERSATION_ROLE_USER,
+    CONVERSATION_ROLE_ASSISTANT,
+} conversation_role_t;
+
+typedef struct {
+    conversation_role_t role;
+    const char *text;
+} conversation_turn_t;
+
+typedef struct {
+    const char *summary;              // "" when nothing was folded yet
+    const conversation_turn_t *turns; // Oldest first
+    size_t turn_count;
+} conversation_view_t;
+
+// Record an exchange the user heard. Either text may be NULL
+void conversation_memory_add(const char *user_text, const char *assistant_text);
+
+// Forget everything, e.g. when the user says goodbye
+void conversation_memory_clear(void);
+
+/**
+ * Borrow the history to build one request, blocking other writers until
+ * conversation_memory_release(). History past its idle timeout is cleared
+ * first.
+ *
+ * @return false when there is no history; nothing needs releasing then
+ */
+bool conversation_memory_acquire(conversation_view_t *view);
+
+void conversation_memory_release(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,343 @@
+#include "cpu_profiler.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
+static const char *TAG = "cpu_profiler";
+
+#define RUN_TIME_STATS (configUSE_TRACE_FACILITY && configGENERATE_RUN_TIME_STATS)
+
+// One point more than the longest window, which needs both of its ends
+#define HISTORY 61
+
+static const uint32_t WINDOW_SAMPLES[CPU_PROFILER_WINDOW_COUNT] = {
+    1000 / CPU_PROFILER_SAMPLE_MS,
+    10000 / CPU_PROFILER_SAMPLE_MS,
+    60000 / CPU_PROFILER_SAMPLE_MS,
+};
+static const char *const WINDOW_NAMES[CPU_PROFILER_WINDOW_COUNT] = {"1s", "10s", "60s"};
+
+_Static_assert(60000 / CPU_PROFILER_SAMPLE_MS < HISTORY, "CPU_PROFILER_SAMPLE_MS too short for a minute of history");
+
+typedef struct {
+    TaskHandle_t handle;              // NULL for a free slot
+    char name[configMAX_TASK_NAME_LEN];
+    int core;
+    uint32_t run_time[HISTORY];       // Run-time counter at each sample; wraps, deltas don't care
+} task_slot_t;
+
+typedef struct {
+    task_slot_t tasks[CPU_PROFILER_MAX_TASKS];
+    int64_t time_us[HISTORY];
+    uint32_t afe_frames[HISTORY];     // Cumulative
+    uint32_t afe_misses[HISTORY];     // Cumulative
+    uint32_t afe_worst_us[HISTORY];   // Worst frame within each sample period
+    size_t head;
+    size_t samples;
+    TaskStatus_t status[CPU_PROFILER_MAX_TASKS];
+} profiler_t;
+
+static profiler_t *s_prof;
+static SemaphoreHandle_t s_mutex;
+static esp_timer_handle_t s_timer;
+
+static portMUX_TYPE s_afe_lock = portMUX_INITIALIZER_UNLOCKED;
+static uint32_t s_afe_frames;
+static uint32_t s_afe_misses;
+static uint32_t s_afe_worst_us;
+static uint32_t s_afe_budget_us;
+
+const char *cpu_profiler_window_name(cpu_profiler_window_t window)
+{
+    return window < CPU_PROFILER_WINDOW_COUNT ? WINDOW_NAMES[window] : "?";
+}
+
+void cpu_profiler_note_afe_frame(uint32_t elapsed_us, uint32_t budget_us)
+{
+    portENTER_CRITICAL(&s_afe_lock);
+    s_afe_frames++;
+    if (elapsed_us > budget_us) {
+        s_afe_misses++;
+    }
+    if (elapsed_us > s_afe_worst_us) {
+        s_afe_worst_us = elapsed_us;
+    }
+    s_afe_budget_us = budget_us;
+    portEXIT_CRITICAL(&s_afe_lock);
+}
+
+// Index `back` samples before the head
+static size_t back_index(size_t back)
+{
+    return (s_prof->head + HISTORY - back) % HISTORY;
+}
+
+// Samples a window spans, shortened while history fills; 0 with too little
+static size_t window_span(cpu_profiler_window_t window)
+{
+    if (!s_prof || window >= CPU_PROFILER_WINDOW_COUNT || s_prof->samples < 2) {
+        return 0;
+    }
+    size_t span = WINDOW_SAMPLES[window];
+    return span < s_prof->samples ? span : s_prof->samples - 1;
+}
+
+static float slot_load(const task_slot_t *slot, size_t span)
+{
+    int64_t elapsed_us = s_prof->time_us[s_prof->head] - s_prof->time_us[back_index(span)];
+    if (elapsed_us <= 0) {
+        return 0.0f;
+    }
+    uint32_t busy_us = slot->run_time[s_prof->head] - slot->run_time[back_index(span)];
+    float pct = 100.0f * (float)busy_us / (float)elapsed_us;
+    return pct > 100.0f ? 100.0f : pct;
+}
+
+#if RUN_TIME_STATS
+static task_slot_t *find_slot(const TaskStatus_t *status)
+{
+    task_slot_t *free_slot = NULL;
+    for (int i = 0; i < CPU_PROFILER_MAX_TASKS; ++i) {
+        task_slot_t *slot = &s_prof->tasks[i];
+        if (slot->handle == status->xHandle && strncmp(slot->name, status->pcTaskName, sizeof(slot->name)) == 0) {
+            return slot;
+        }
+        if (!slot->handle && !free_slot) {
+            free_slot = slot;
+        }
+    }
+    if (free_slot) {
+        // New task: backfill its history so its first window starts now
+        free_slot->handle = status->xHandle;
+        strlcpy(free_slot->name, status->pcTaskName, sizeof(free_slot->name));
+#if configTASKLIST_INCLUDE_COREID
+        free_slot->core = status->xCoreID == tskNO_AFFINITY ? -1 : (int)status->xCoreID;
+#else
+        free_slot->core = -1;
+#endif
+        for (int h = 0; h < HISTORY; ++h) {
+            free_slot->run_time[h] = (uint32_t)status->ulRunTimeCounter;
+        }
+    }
+    return free_slot;
+}
+
+static void sample(void *arg)
+{
+    (void)arg;
+    UBaseType_t count = uxTaskGetSystemState(s_prof->status, CPU_PROFILER_MAX_TASKS, NULL);
+    int64_t now_us = esp_timer_get_time();
+    if (count == 0) {
+        // The call fills nothing when the array can't hold every task
+        static bool warned;
+        if (!warned) {
+            ESP_LOGW(TAG, "More than %d tasks; raise CPU_PROFILER_MAX_TASKS", CPU_PROFILER_MAX_TASKS);
+            warned = true;
+        }
+        return;
+    }
+
+    portENTER_CRITICAL(&s_afe_lock);
+    uint32_t afe_frames = s_afe_frames;
+    uint32_t afe_misses = s_afe_misses;
+    uint32_t afe_worst_us = s_afe_worst_us;
+    s_afe_worst_us = 0;
+    portEXIT_CRITICAL(&s_afe_lock);
+
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    size_t head = (s_prof->head + 1) % HISTORY;
+    bool seen[CPU_PROFILER_MAX_TASKS] = {0};
+    for (UBaseType_t i = 0; i < count; ++i) {
+        task_slot_t *slot = find_slot(&s_prof->status[i]);
+        if (slot) {
+            slot->run_time[head] = (uint32_t)s_prof->status[i].ulRunTimeCounter;
+            seen[slot - s_prof->tasks] = true;
+        }
+    }
+    for (int i = 0; i < CPU_PROFILER_MAX_TASKS; ++i) {
+        if (!seen[i]) {
+            s_prof->tasks[i].handle = NULL;  // Deleted
+        }
+    }
+    s_prof->time_us[head] = now_us;
+    s_prof->afe_frames[head] = afe_frames;
+    s_prof->afe_misses[head] = afe_misses;
+    s_prof->afe_worst_us[head] = afe_worst_us;
+    s_prof->head = head;
+    if (s_prof->samples < HISTORY) {
+        s_prof->samples++;
+    }
+    xSemaphoreGive(s_mutex);
+}
+#endif
+
+esp_err_t cpu_profiler_init(void)
+{
+#if RUN_TIME_STATS
+    if (s_prof) {
+        return ESP_OK;
+    }
+    // A minute of counters for every task: PSRAM when there is some
+    s_prof = heap_caps_calloc(1, sizeof(*s_prof), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!s_prof) {
+        s_prof = calloc(1, sizeof(*s_prof));
+    }
+    s_mutex = xSemaphoreCreateMutex();
+    if (!s_prof || !s_mutex) {
+        free(s_prof);
+        s_prof = NULL;
+        if (s_mutex) {
+            vSemaphoreDelete(s_mutex);
+            s_mutex = NULL;
+        }
+        return ESP_ERR_NO_MEM;
+    }
+    // Skipping missed periods also keeps the timer from waking the chip out of light sleep
+    const esp_timer_create_args_t args = {
+        .callback = sample,
+        .arg = NULL,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "cpu_profiler",
+        .skip_unhandled_events = true,
+    };
+    esp_err_t err = esp_timer_create(&args, &s_timer);
+    if (err == ESP_OK) {
+        sample(NULL);
+        err = esp_timer_start_periodic(s_timer, (uint64_t)CPU_PROFILER_SAMPLE_MS * 1000);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Sampling timer: %s", esp_err_to_name(err));
+    }
+    return err;
+#else
+    ESP_LOGW(TAG, "Built without FreeRTOS run-time stats; no CPU profile");
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
+esp_err_t cpu_profiler_core_load(int core, cpu_profiler_window_t window, float *out_pct)
+{
+    if (core < 0 || core >= portNUM_PROCESSORS || !out_pct) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!s_prof) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    TaskHandle_t idle = xTaskGetIdleTaskHandleForCore(core);
+    esp_err_t err = ESP_ERR_INVALID_STATE;
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    size_t span = window_span(window);
+    for (int i = 0; span && i < CPU_PROFILER_MAX_TASKS; ++i) {
+        if (s_prof->tasks[i].handle == idle) {
+            *out_pct = 100.0f - slot_load(&s_prof->tasks[i], span);
+            err = ESP_OK;
+            break;
+        }
+    }
+    xSemaphoreGive(s_mutex);
+    return err;
+}
+
+size_t cpu_profiler_top(cpu_profiler_task_load_t *out, size_t max, cpu_profiler_window_t window)
+{
+    if (!s_prof || !out || max == 0) {
+        return 0;
+    }
+    size_t written = 0;
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    size_t span = window_span(window);
+    for (int i = 0; span && i < CPU_PROFILER_MAX_TASKS; ++i) {
+        const task_slot_t *slot = &s_prof->tasks[i];
+        if (!slot->handle) {
+            continue;
+        }
+        float load = slot_load(slot, span);
+        // Insertion into the sorted output; the lightest falls off the end
+        size_t pos = written;
+        while (pos > 0 && out[pos - 1].load_pct < load) {
+            if (pos < max) {
+                out[pos] = out[pos - 1];
+            }
+            pos--;
+        }
+        if (pos < max) {
+            strlcpy(out[pos].name, slot->name, sizeof(out[pos].name));
+            out[pos].core = slot->core;
+            out[pos].load_pct = load;
+            if (written < max) {
+                written++;
+            }
+        }
+    }
+    xSemaphoreGive(s_mutex);
+    return written;
+}
+
+void cpu_profiler_afe_stats(cpu_profiler_window_t window, cpu_profiler_afe_stats_t *out)
+{
+    memset(out, 0, sizeof(*out));
+    if (!s_prof) {
+        return;
+    }
+    portENTER_CRITICAL(&s_afe_lock);
+    out->budget_us = s_afe_budget_us;
+    portEXIT_CRITICAL(&s_afe_lock);
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    size_t span = window_span(window);
+    if (span) {
+        size_t from = back_index(span);
+        out->frames = s_prof->afe_frames[s_prof->head] - s_prof->afe_frames[from];
+        out->misses = s_prof->afe_misses[s_prof->head] - s_prof->afe_misses[from];
+        for (size_t b = 0; b < span; ++b) {
+            uint32_t worst = s_prof->afe_worst_us[back_index(b)];
+            if (worst > out->worst_us) {
+                out->worst_us = worst;
+            }
+        }
+    }
+    xSemaphoreGive(s_mutex);
+}
+
+void cpu_profiler_log(void)
+{
+    if (!s_prof) {
+        ESP_LOGW(TAG, "Profiler not running");
+        return;
+    }
+    for (int core = 0; core < portNUM_PROCESSORS; ++core) {
+        float load[CPU_PROFILER_WINDOW_COUNT] = {0};
+        for (int w = 0; w < CPU_PROFILER_WINDOW_COUNT; ++w) {
+            cpu_profiler_core_load(core, (cpu_profiler_window_t)w, &load[w]);
+        }
+        ESP_LOGI(TAG, "core %d: %5.1f%% %5.1f%% %5.1f%% (1s 10s 60s)", core, load[0], load[1], load[2]);
+    }
+    cpu_profiler_afe_stats_t afe;
+    cpu_profiler_afe_stats(CPU_PROFILER_WINDOW_60S, &afe);
+    if (afe.frames) {
+        ESP_LOGI(TAG, "AFE: %u frames in 60s, worst %u us of %u us", (unsigned)afe.frames, (unsigned)afe.worst_us,
+                 (unsigned)afe.budget_us);
+        if (afe.misses) {
+            ESP_LOGW(TAG, "AFE missed its deadline on %u frames in 60s", (unsigned)afe.misses);
+        }
+    }
+    cpu_profiler_task_load_t *top = malloc(CPU_PROFILER_MAX_TASKS * sizeof(*top));
+    if (!top) {
+        return;
+    }
+    size_t n = cpu_profiler_top(top, CPU_PROFILER_MAX_TASKS, CPU_PROFILER_WINDOW_10S);
+    for (size_t i = 0; i < n; ++i) {
+        if (top[i].core >= 0) {
+            ESP_LOGI(TAG, "%-16s core %d %5.1f%%", top[i].name, top[i].core, top[i].load_pct);
+        } else {
+            ESP_LOGI(TAG, "%-16s core * %5.1f%%", top[i].name, top[i].load_pct);
+        }
+    }
+    free(top);
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Tasks tracked at once; with more running, sampling pauses and logs a warning
+#ifndef CPU_PROFILER_MAX_TASKS
+#define CPU_PROFILER_MAX_TASKS 48
+#endif
+
+// Run-time counters are sampled this often; windows are whole samples
+#ifndef CPU_PROFILER_SAMPLE_MS
+#define CPU_PROFILER_SAMPLE_MS 1000
+#endif
+
+typedef enum {
+    CPU_PROFILER_WINDOW_1S,
+    CPU_PROFILER_WINDOW_10S,
+    CPU_PROFILER_WINDOW_60S,
+    CPU_PROFILER_WINDOW_COUNT,
+} cpu_profiler_window_t;
+
+typedef struct {
+    char name[configMAX_TASK_NAME_LEN];
+    int core;                         // -1 for a task free to run on either core
+    float load_pct;                   // Of one core over the window
+} cpu_profiler_task_load_t;
+
+// AFE frames whose feed-to-result work took longer than the audio it covers
+typedef struct {
+    uint32_t frames;
+    uint32_t misses;
+    uint32_t worst_us;
+    uint32_t budget_us;               // Audio per frame
+} cpu_profiler_afe_stats_t;
+
+/**
+ * Sample every task's FreeRTOS run-time counter each CPU_PROFILER_SAMPLE_MS
+ * and keep a minute of history, so loads come out over 1 s, 10 s and 60 s
+ * sliding windows. Needs CONFIG_FREERTOS_USE_TRACE_FACILITY and
+ * CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS (config/sdkconfig.defaults).
+ *
+ * @return ESP_ERR_NOT_SUPPORTED without run-time stats in the build
+ */
+esp_err_t cpu_profiler_init(void);
+
+// "1s", "10s", "60s"
+const char *cpu_profiler_window_name(cpu_profiler_window_t window);
+
+// Busy share of a core (100 % minus its idle task); ESP_ERR_INVALID_STATE before two samples
+esp_err_t cpu_profiler_core_load(int core, cpu_profiler_window_t window, float *out_pct);
+
+// The busiest tasks over a window, heaviest first; returns how many were written
+size_t cpu_profiler_top(cpu_profiler_task_load_t *out, size_t max, cpu_profiler_window_t window);
+
+// Called by the AFE loop once per frame; elapsed over budget counts as a deadline miss
+void cpu_profiler_note_afe_frame(uint32_t elapsed_us, uint32_t budget_us);
+
+void cpu_profiler_afe_stats(cpu_profiler_window_t window, cpu_profiler_afe_stats_t *out);
+
+// Console view for the TOP command: core loads, AFE deadlines, then tasks by 10 s load
+void cpu_profiler_log(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,316 @@
+#include "deadline_monitor.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cpu_profiler.h"
+#include "esp_check.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "metrics.h"
+#include "timer_wheel.h"
+
+static const char *TAG = "deadline";
+
+#define DEADLINE_MONITOR_REVIEW_MS 1000
+#define DEADLINE_MONITOR_SNAPSHOT_GAP_US (60LL * 1000 * 1000)
+// Runs kept for the snapshot; a power of two
+#define DEADLINE_MONITOR_RECENT 16
+#define DEADLINE_MONITOR_METRIC_NAME 40
+
+typedef struct {
+    uint32_t exec_us;
+    uint32_t interval_us;             // From the previous start, 0 after a pause
+} recent_run_t;
+
+struct deadline_monitor_stage {
+    const char *name;
+    uint32_t period_us;
+    uint32_t budget_us;
+
+    // Written by the stage's own task or ISR only
+    int64_t begin_us;
+    int64_t prev_begin_us;            // 0 = no previous start to measure from
+    int core;
+    TaskHandle_t task;                // NULL when the stage runs in an ISR
+    uint32_t streak;                  // Misses in a row
+    uint32_t recent_pos;
+    recent_run_t recent[DEADLINE_MONITOR_RECENT];
+
+    // Read by the review and the console
+    uint32_t runs;
+    uint32_t misses;
+    uint32_t worst_exec_us;
+    uint32_t worst_jitter_us;
+    uint32_t pending;                 // Misses since the last review; the review swaps it to 0
+    uint32_t worst_pending_us;
+    bool snapshot_due;
+
+    metrics_histogram_t *exec;
+    metrics_histogram_t *jitter;
+    metrics_counter_t *overruns;
+    metrics_counter_t *late;
+    char metric_names[4][DEADLINE_MONITOR_METRIC_NAME];
+};
+
+static deadline_monitor_stage_t s_stages[CONFIG_KVA_DEADLINE_MONITOR_MAX_STAGES];
+static uint32_t s_stage_count;        // Slots below this are claimed; release/acquire
+static portMUX_TYPE s_register_lock = portMUX_INITIALIZER_UNLOCKED;
+static timer_wheel_timer_t *s_review_timer;
+static int64_t s_last_snapshot_us;
+
+static inline __attribute__((always_inline)) void store_max(uint32_t *slot, uint32_t value)
+{
+    if (value > __atomic_load_n(slot, __ATOMIC_RELAXED)) {
+        __atomic_store_n(slot, value, __ATOMIC_RELAXED);
+    }
+}
+
+esp_err_t deadline_monitor_register(const deadline_monitor_config_t *config, deadline_monitor_stage_t **out_stage)
+{
+    ESP_RETURN_ON_FALSE(config && config->name && out_stage, ESP_ERR_INVALID_ARG, TAG, "config");
+    ESP_RETURN_ON_FALSE(config->period_us || config->budget_us, ESP_ERR_INVALID_ARG, TAG, "%s: no period or budget",
+                        config->name);
+
+    deadline_monitor_stage_t *stage = NULL;
+    bool created = false;
+    portENTER_CRITICAL(&s_register_lock);
+    uint32_t count = s_stage_count;
+    for (uint32_t i = 0; i < count; ++i) {
+        if (strcmp(s_stages[i].name, config->name) == 0) {
+            stage = &s_stages[i];
+            break;
+        }
+    }
+    if (!stage && count < CONFIG_KVA_DEADLINE_MONITOR_MAX_STAGES) {
+        stage = &s_stages[count];
+        stage->name = config->name;
+        stage->period_us = config->period_us;
+        stage->budget_us = config->budget_us ? config->budget_us : config->period_us;
+        __atomic_store_n(&s_stage_count, count + 1, __ATOMIC_RELEASE);
+        created = true;
+    }
+    portEXIT_CRITICAL(&s_register_lock);
+    ESP_RETURN_ON_FALSE(stage, ESP_ERR_NO_MEM, TAG, "no slot for %s", config->name);
+
+    if (created) {
+        // Outside the lock: the registry takes its own. Until these are set the stage only counts
+        char (*names)[DEADLINE_MONITOR_METRIC_NAME] = stage->metric_names;
+        snprintf(names[0], sizeof(names[0]), "deadline_%s_exec", stage->name);
+        snprintf(names[1], sizeof(names[1]), "deadline_%s_jitter", stage->name);
+        snprintf(names[2], sizeof(names[2]), "deadline_%s_overruns", stage->name);
+        snprintf(names[3], sizeof(names[3]), "deadline_%s_late", stage->name);
+        uint32_t exec_base = stage->budget_us / 8 ? stage->budget_us / 8 : 1;
+        uint32_t jitter_base = stage->period_us / 32 ? stage->period_us / 32 : 1;
+        __atomic_store_n(&stage->exec, metrics_histogram(names[0], exec_base), __ATOMIC_RELEASE);
+        __atomic_store_n(&stage->overruns, metrics_counter(names[2]), __ATOMIC_RELEASE);
+        if (stage->period_us) {
+            __atomic_store_n(&stage->jitter, metrics_histogram(names[1], jitter_base), __ATOMIC_RELEASE);
+            __atomic_store_n(&stage->late, metrics_counter(names[3]), __ATOMIC_RELEASE);
+        }
+        ESP_LOGI(TAG, "%s: period %lu us, budget %lu us", stage->name, (unsigned long)stage->period_us,
+                 (unsigned long)stage->budget_us);
+    }
+    *out_stage = stage;
+    return ESP_OK;
+}
+
+// Both ends run in the capture interrupt, which flash writes do not hold off
+void IRAM_ATTR deadline_monitor_begin(deadline_monitor_stage_t *stage)
+{
+    if (!stage) {
+        return;
+    }
+    int64_t now = esp_timer_get_time();
+    stage->begin_us = now;
+    stage->core = xPortGetCoreID();
+    stage->task = xPortInIsrContext() ? NULL : xTaskGetCurrentTaskHandle();
+}
+
+void IRAM_ATTR deadline_monitor_end(deadline_monitor_stage_t *stage)
+{
+    if (!stage || stage->begin_us == 0) {
+        return;
+    }
+    int64_t now = esp_timer_get_time();
+    uint32_t exec_us = (uint32_t)(now - stage->begin_us);
+    uint32_t interval_us = stage->prev_begin_us ? (uint32_t)(stage->begin_us - stage->prev_begin_us) : 0;
+    stage->prev_begin_us = stage->begin_us;
+    stage->begin_us = 0;
+
+    bool missed = false;
+    metrics_histogram_record_us(__atomic_load_n(&stage->exec, __ATOMIC_ACQUIRE), exec_us);
+    if (exec_us > stage->budget_us) {
+        metrics_counter_add(__atomic_load_n(&stage->overruns, __ATOMIC_ACQUIRE), 1);
+        missed = true;
+    }
+    if (stage->period_us && interval_us) {
+        uint32_t jitter_us = interval_us > stage->period_us ? interval_us - stage->period_us
+                                                            : stage->period_us - interval_us;
+        metrics_histogram_record_us(__atomic_load_n(&stage->jitter, __ATOMIC_ACQUIRE), jitter_us);
+        store_max(&stage->worst_jitter_us, jitter_us);
+        if (interval_us > stage->period_us + stage->period_us / 2) {
+            metrics_counter_add(__atomic_load_n(&stage->late, __ATOMIC_ACQUIRE), 1);
+            missed = true;
+        }
+    }
+    store_max(&stage->worst_exec_us, exec_us);
+
+    recent_run_t *run = &stage->recent[stage->recent_pos++ & (DEADLINE_MONITOR_RECENT - 1)];
+    run->exec_us = exec_us;
+    run->interval_us = interval_us;
+    __atomic_store_n(&stage->runs, stage->runs + 1, __ATOMIC_RELAXED);
+
+    if (!missed) {
+        stage->streak = 0;
+        return;
+    }
+    __atomic_store_n(&stage->misses, stage->misses + 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&stage->pending, 1, __ATOMIC_RELAXED);
+    store_max(&stage->worst_pending_us, exec_us > interval_us ? exec_us : interval_us);
+    if (CONFIG_KVA_DEADLINE_MONITOR_SNAPSHOT_MISSES > 0 &&
+        ++stage->streak == CONFIG_KVA_DEADLINE_MONITOR_SNAPSHOT_MISSES) {
+        __atomic_store_n(&stage->snapshot_due, true, __ATOMIC_RELEASE);
+    }
+}
+
+void deadline_monitor_pause(deadline_monitor_stage_t *stage)
+{
+    if (stage) {
+        stage->prev_begin_us = 0;
+        stage->begin_us = 0;
+        stage->streak = 0;
+    }
+}
+
+// Busiest task in the last second that could have run on the stage's core, other than the stage itself
+static void find_suspect(const deadline_monitor_stage_t *stage, char *out, size_t out_size)
+{
+    cpu_profiler_task_load_t top[8];
+    size_t n = cpu_profiler_top(top, sizeof(top) / sizeof(top[0]), CPU_PROFILER_WINDOW_1S);
+    TaskHandle_t own = __atomic_load_n(&stage->task, __ATOMIC_RELAXED);
+    const char *own_name = own ? pcTaskGetName(own) : NULL;
+    strlcpy(out, "?", out_size);
+    for (size_t i = 0; i < n; ++i) {
+        if (top[i].core != -1 && top[i].core != stage->core) {
+            continue;
+        }
+        if (strncmp(top[i].name, "IDLE", 4) == 0 || (own_name && strcmp(top[i].name, own_name) == 0)) {
+            continue;
+        }
+        snprintf(out, out_size, "%s (%.0f%%)", top[i].name, top[i].load_pct);
+        return;
+    }
+}
+
+static char task_state_char(eTaskState state)
+{
+    switch (state) {
+    case eRunning:
+        return 'X';
+    case eReady:
+        return 'R';
+    case eBlocked:
+        return 'B';
+    case eSuspended:
+        return 'S';
+    default:
+        return 'D';
+    }
+}
+
+static void log_snapshot(deadline_monitor_stage_t *stage)
+{
+    ESP_LOGW(TAG, "=== %s: %d misses in a row (period %lu us, budget %lu us) ===", stage->name,
+             CONFIG_KVA_DEADLINE_MONITOR_SNAPSHOT_MISSES, (unsigned long)stage->period_us,
+             (unsigned long)stage->budget_us);
+    // Oldest first; the owner may be adding one meanwhile, which costs at most a torn line
+    uint32_t end = __atomic_load_n(&stage->recent_pos, __ATOMIC_RELAXED);
+    for (uint32_t i = end - DEADLINE_MONITOR_RECENT; i != end; ++i) {
+        const recent_run_t *run = &stage->recent[i & (DEADLINE_MONITOR_RECENT - 1)];
+        if (run->exec_us || run->interval_us) {
+            ESP_LOGW(TAG, "  run: exec %6lu us, since previous %6lu us", (unsigned long)run->exec_us,
+                     (unsigned long)run->interval_us);
+        }
+    }
+
+    UBaseType_t capacity = uxTaskGetNumberOfTasks() + 4;
+    TaskStatus_t *tasks = malloc(capacity * sizeof(*tasks));
+    if (!tasks) {
+        ESP_LOGW(TAG, "  (no memory for the task table)");
+        return;
+    }
+    UBaseType_t count = uxTaskGetSystemState(tasks, capacity, NULL);
+    ESP_LOGW(TAG, "  %-16s st pri core stack_free", "task");
+    for (UBaseType_t i = 0; i < count; ++i) {
+        const TaskStatus_t *t = &tasks[i];
+        ESP_LOGW(TAG, "  %-16s %c  %3u %4d %10lu", t->pcTaskName, task_state_char(t->eCurrentState),
+                 (unsigned)t->uxCurrentPriority, t->xCoreID == tskNO_AFFINITY ? -1 : (int)t->xCoreID,
+                 (unsigned long)t->usStackHighWaterMark);
+    }
+    free(tasks);
+}
+
+static void review_cb(void *arg)
+{
+    (void)arg;
+    uint32_t count = __atomic_load_n(&s_stage_count, __ATOMIC_ACQUIRE);
+    for (uint32_t i = 0; i < count; ++i) {
+        deadline_monitor_stage_t *stage = &s_stages[i];
+        uint32_t pending = __atomic_exchange_n(&stage->pending, 0, __ATOMIC_RELAXED);
+        uint32_t worst_us = __atomic_exchange_n(&stage->worst_pending_us, 0, __ATOMIC_RELAXED);
+        if (pending == 0) {
+            continue;
+        }
+        char suspect[configMAX_TASK_NAME_LEN + 8];
+        find_suspect(stage, suspect, sizeof(suspect));
+        ESP_LOGW(TAG, "%s missed %lu deadline(s), worst %lu us against %lu us; busiest other task on core %d: %s",
+                 stage->name, (unsigned long)pending, (unsigned long)worst_us,
+                 (unsigned long)(stage->period_us ? stage->period_us : stage->budget_us), stage->core, suspect);
+
+        if (__atomic_exchange_n(&stage->snapshot_due, false, __ATOMIC_ACQUIRE)) {
+            int64_t now = esp_timer_get_time();
+            if (s_last_snapshot_us == 0 || now - s_last_snapshot_us >= DEADLINE_MONITOR_SNAPSHOT_GAP_US) {
+                s_last_snapshot_us = now;
+                log_snapshot(stage);
+            }
+        }
+    }
+}
+
+esp_err_t deadline_monitor_init(void)
+{
+    if (s_review_timer) {
+        return ESP_OK;
+    }
+    const timer_wheel_timer_config_t config = {
+        .callback = review_cb,
+        .name = "deadline_review",
+        .slack_ms = DEADLINE_MONITOR_REVIEW_MS / 4,
+    };
+    ESP_RETURN_ON_ERROR(timer_wheel_create(&config, &s_review_timer), TAG, "review timer");
+    timer_wheel_start_periodic(s_review_timer, DEADLINE_MONITOR_REVIEW_MS);
+    return ESP_OK;
+}
+
+void deadline_monitor_log(void)
+{
+    uint32_t count = __atomic_load_n(&s_stage_count, __ATOMIC_ACQUIRE);
+    if (count == 0) {
+        ESP_LOGI(TAG, "No stages registered");
+        return;
+    }
+    ESP_LOGI(TAG, "%-12s %9s %9s %10s %8s %11s %11s", "stage", "period_us", "budget_us", "runs", "misses",
+             "worst_exec", "worst_jit");
+    for (uint32_t i = 0; i < count; ++i) {
+        const deadline_monitor_stage_t *stage = &s_stages[i];
+        ESP_LOGI(TAG, "%-12s %9lu %9lu %10lu %8lu %11lu %11lu", stage->name, (unsigned long)stage->period_us,
+                 (unsigned long)stage->budget_us, (unsigned long)__atomic_load_n(&stage->runs, __ATOMIC_RELAXED),
+                 (unsigned long)__atomic_load_n(&stage->misses, __ATOMIC_RELAXED),
+                 (unsigned long)__atomic_load_n(&stage->worst_exec_us, __ATOMIC_RELAXED),
+                 (unsigned long)__atomic_load_n(&stage->worst_jitter_us, __ATOMIC_RELAXED));
+    }
+}
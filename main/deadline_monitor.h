@@ -0,0 +1,68 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "kva_config_defaults.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Deadline accounting for the real-time audio stages. A stage declares how
+ * often it runs and how long one run may take, then brackets each run with
+ * deadline_monitor_begin() and deadline_monitor_end(). Per stage the
+ * metrics registry gets
+ *
+ *   deadline_<name>_exec     histogram of run time, base budget / 8
+ *   deadline_<name>_jitter   histogram of |start-to-start - period|
+ *   deadline_<name>_overruns runs longer than the budget
+ *   deadline_<name>_late     starts more than half a period behind
+ *
+ * A missed AFE feed shows up as nothing worse than a weaker wake word, so
+ * these are how starvation gets noticed in the field.
+ *
+ * Begin and end only touch the stage and the registry's lock-free slots and
+ * are safe in an ISR. Once a second a timer_wheel callback looks at the
+ * stages that missed: it logs the miss with the busiest other task on the
+ * stage's core over the last second (cpu_profiler), the likeliest task to
+ * have preempted it. After CONFIG_KVA_DEADLINE_MONITOR_SNAPSHOT_MISSES
+ * misses in a row it also logs a snapshot: the stage's recent runs and
+ * every task's state, priority, core and stack, at most once a minute.
+ */
+typedef struct deadline_monitor_stage deadline_monitor_stage_t;
+
+typedef struct {
+    const char *name;                 // Short, metric-safe; must outlive the monitor (a literal)
+    uint32_t period_us;               // 0 = driven by a queue, not a clock: no jitter or lateness
+    uint32_t budget_us;               // 0 = the period
+} deadline_monitor_config_t;
+
+// Start the once-a-second review; needs timer_wheel_init() first
+esp_err_t deadline_monitor_init(void);
+
+/**
+ * Registering a name again returns the same stage, so a stage that is
+ * started and stopped can register on every start. Works before
+ * deadline_monitor_init(); misses are then only counted.
+ *
+ * @return ESP_ERR_NO_MEM when all CONFIG_KVA_DEADLINE_MONITOR_MAX_STAGES
+ *         slots are taken
+ */
+esp_err_t deadline_monitor_register(const deadline_monitor_config_t *config, deadline_monitor_stage_t **out_stage);
+
+// One run of the stage, from one task or ISR at a time. A NULL stage, or an
+// end without a begin, is ignored
+void deadline_monitor_begin(deadline_monitor_stage_t *stage);
+void deadline_monitor_end(deadline_monitor_stage_t *stage);
+
+// The stage stops on purpose (a pause, a closed session); the next begin is not late
+void deadline_monitor_pause(deadline_monitor_stage_t *stage);
+
+// Console view for the DEADLINES command: every stage since boot
+void deadline_monitor_log(void);
+
+#ifdef __cplusplus
+}
+#endif
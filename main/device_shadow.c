@@ -0,0 +1,563 @@
+#include "device_shadow.h"
+
+#include <inttypes.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "aws_iot_service.h"
+#include "device_state.h"
+#include "esp_check.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "feature_flags.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "jsmn.h"
+#include "kva_config_defaults.h"
+#include "somnus_mqtt.h"
+#include "somnus_mqtt_gateway.h"
+#include "timer_wheel.h"
+
+static const char *TAG = "device_shadow";
+
+#define SHADOW_TOPIC_MAX 64
+// Room for every field and flag at once, as the first update after boot sends
+#define SHADOW_PAYLOAD_MAX 768
+// get/accepted carries desired, reported, delta and their metadata
+#define SHADOW_TOKENS 192
+
+typedef struct {
+    const char *name;
+    bool is_bool;
+    uint8_t decimals;
+    float deadband;                   // Numbers: movement worth reporting
+    bool (*get)(const device_state_inputs_t *in, double *value);  // false while unavailable
+    esp_err_t (*set)(double value);   // NULL: reported only
+} shadow_field_t;
+
+static bool get_lights(const device_state_inputs_t *in, double *v) { *v = in->lights_enabled; return true; }
+static bool get_muted(const device_state_inputs_t *in, double *v) { *v = in->muted; return true; }
+static bool get_sleep(const device_state_inputs_t *in, double *v) { *v = in->sleep_mode; return true; }
+static bool get_playing(const device_state_inputs_t *in, double *v) { *v = in->audio_playing; return true; }
+static bool get_spotify(const device_state_inputs_t *in, double *v) { *v = in->spotify_ready; return true; }
+
+static bool get_brightness(const device_state_inputs_t *in, double *v)
+{
+    *v = in->led_brightness;
+    return in->leds_present;
+}
+
+static bool get_rssi(const device_state_inputs_t *in, double *v)
+{
+    *v = in->wifi_rssi;
+    return in->wifi_connected;
+}
+
+static bool get_temperature(const device_state_inputs_t *in, double *v)
+{
+    *v = in->sensors.sht45_available ? in->sensors.temperature_c : in->sensors.temperature_co2_c;
+    return in->sensors.sht45_available || in->sensors.scd40_available;
+}
+
+static bool get_humidity(const device_state_inputs_t *in, double *v)
+{
+    *v = in->sensors.sht45_available ? in->sensors.humidity_rh : in->sensors.humidity_co2_rh;
+    return in->sensors.sht45_available || in->sensors.scd40_available;
+}
+
+static bool get_co2(const device_state_inputs_t *in, double *v)
+{
+    *v = in->sensors.co2_ppm;
+    return in->sensors.scd40_available;
+}
+
+static bool get_voc(const device_state_inputs_t *in, double *v)
+{
+    *v = in->sensors.voc_index;
+    return in->sensors.sgp40_available;
+}
+
+static bool get_lux(const device_state_inputs_t *in, double *v)
+{
+    *v = in->sensors.ambient_lux;
+    return in->sensors.vcnl4040_available;
+}
+
+static bool get_pm2_5(const device_state_inputs_t *in, double *v)
+{
+    // EC10 reports PM2.5 in ec_ms_per_cm
+    *v = in->sensors.ec_ms_per_cm;
+    return in->sensors.ec10_available;
+}
+
+static esp_err_t set_lights(double v)
+{
+    return device_state_set_lights(v != 0);
+}
+
+static esp_err_t set_muted(double v)
+{
+    device_state_set_muted(v != 0);
+    return ESP_OK;
+}
+
+static esp_err_t set_sleep(double v)
+{
+    device_state_set_sleep_mode(v != 0);
+    return ESP_OK;
+}
+
+// Deadbands follow the ones the device state snapshot is rebuilt on
+static const shadow_field_t s_fields[] = {
+    {"lights_enabled", true, 0, 0.0f, get_lights, set_lights},
+    {"muted", true, 0, 0.0f, get_muted, set_muted},
+    {"sleep_mode", true, 0, 0.0f, get_sleep, set_sleep},
+    {"audio_playing", true, 0, 0.0f, get_playing, NULL},
+    {"spotify_ready", true, 0, 0.0f, get_spotify, NULL},
+    {"brightness", false, 0, 1.0f, get_brightness, NULL},
+    {"wifi_rssi", false, 0, 5.0f, get_rssi, NULL},
+    {"temperature_c", false, 1, 0.2f, get_temperature, NULL},
+    {"humidity_rh", false, 0, 1.0f, get_humidity, NULL},
+    {"co2_ppm", false, 0, 25.0f, get_co2, NULL},
+    {"voc_index", false, 0, 5.0f, get_voc, NULL},
+    {"ambient_lux", false, 0, 5.0f, get_lux, NULL},
+    {"pm2_5_ug_m3", false, 1, 2.0f, get_pm2_5, NULL},
+};
+
+#define SHADOW_FIELD_COUNT (sizeof(s_fields) / sizeof(s_fields[0]))
+
+typedef enum {
+    SHADOW_MSG_DELTA,
+    SHADOW_MSG_ACCEPTED,
+    SHADOW_MSG_REJECTED,
+} shadow_msg_t;
+
+static struct {
+    SemaphoreHandle_t lock;
+    timer_wheel_timer_t *timer;
+    char topic_update[SHADOW_TOPIC_MAX];
+    char topic_get[SHADOW_TOPIC_MAX];
+    uint32_t version;                 // Document version as last heard; 0 unknown
+    uint32_t applied_version;         // Of the newest delta applied
+    bool synced;                      // Reported values below match the service's
+    int64_t get_sent_us;
+    uint32_t next_token;
+    uint32_t pending_token;           // Update awaiting accepted or rejected; 0 none
+    int64_t pending_since_us;
+    uint32_t pending_mask;            // Fields the pending update carries
+    uint32_t pending_flags;           // ... and feature flags
+    double reported[SHADOW_FIELD_COUNT];
+    bool reported_set[SHADOW_FIELD_COUNT];
+    double sent[SHADOW_FIELD_COUNT];
+    bool sent_set[SHADOW_FIELD_COUNT];
+    double flag_reported[FEATURE_FLAG_COUNT];  // Effective values, under reported "flags"
+    bool flag_reported_set[FEATURE_FLAG_COUNT];
+    double flag_sent[FEATURE_FLAG_COUNT];
+    jsmntok_t tokens[SHADOW_TOKENS];  // Service task only
+    char payload[SHADOW_PAYLOAD_MAX]; // Update being built; under lock
+} s_shadow;
+
+static bool tok_eq(const char *js, const jsmntok_t *t, const char *s)
+{
+    size_t len = strlen(s);
+    return (size_t)(t->end - t->start) == len && memcmp(js + t->start, s, len) == 0;
+}
+
+// Index of the token following t[i] and everything nested under it
+static int tok_skip(const jsmntok_t *t, int i, int count)
+{
+    int pending = 1;
+    while (pending > 0 && i < count) {
+        pending += t[i].size - 1;
+        ++i;
+    }
+    return i;
+}
+
+// Value token for key in object t[obj], or -1
+static int obj_get(const char *js, const jsmntok_t *t, int obj, int count, const char *key)
+{
+    if (obj < 0 || t[obj].type != JSMN_OBJECT) {
+        return -1;
+    }
+    int i = obj + 1;
+    for (int k = 0; k < t[obj].size && i + 1 < count; ++k) {
+        if (t[i].type == JSMN_STRING && tok_eq(js, &t[i], key)) {
+            return i + 1;
+        }
+        i = tok_skip(t, i + 1, count);
+    }
+    return -1;
+}
+
+// true/false/number primitive; null and anything else are not values
+static bool tok_number(const char *js, const jsmntok_t *t, double *out)
+{
+    if (t->type != JSMN_PRIMITIVE) {
+        return false;
+    }
+    char c = js[t->start];
+    if (c == 't' || c == 'f') {
+        *out = c == 't';
+        return true;
+    }
+    char buf[24];
+    size_t len = (size_t)(t->end - t->start);
+    if (c == 'n' || len >= sizeof(buf)) {
+        return false;
+    }
+    memcpy(buf, js + t->start, len);
+    buf[len] = '\0';
+    char *end;
+    *out = strtod(buf, &end);
+    return end != buf;
+}
+
+static int field_index(const char *js, const jsmntok_t *t)
+{
+    for (size_t f = 0; f < SHADOW_FIELD_COUNT; ++f) {
+        if (tok_eq(js, t, s_fields[f].name)) {
+            return (int)f;
+        }
+    }
+    return -1;
+}
+
+static uint32_t tok_u32(const char *js, const jsmntok_t *t, int i)
+{
+    double v;
+    return i >= 0 && tok_number(js, &t[i], &v) && v > 0 ? (uint32_t)v : 0;
+}
+
+// Under lock: desired "flags" object; null drops an override
+static void shadow_apply_flags(const char *js, const jsmntok_t *t, int obj, int count, uint32_t version)
+{
+    int i = obj + 1;
+    for (int k = 0; k < t[obj].size && i + 1 < count; ++k) {
+        int f = feature_flag_find(js + t[i].start, (size_t)(t[i].end - t[i].start));
+        double value;
+        if (f < 0) {
+            ESP_LOGW(TAG, "Unknown flag %.*s", t[i].end - t[i].start, js + t[i].start);
+        } else if (tok_number(js, &t[i + 1], &value)) {
+            esp_err_t err = feature_flags_set((feature_flag_t)f, value);
+            ESP_LOGI(TAG, "Desired flag %s=%g (v%" PRIu32 "): %s", feature_flag_name((feature_flag_t)f), value, version,
+                     esp_err_to_name(err));
+        } else if (t[i + 1].type == JSMN_PRIMITIVE && js[t[i + 1].start] == 'n') {
+            feature_flags_reset((feature_flag_t)f);
+        }
+        i = tok_skip(t, i + 1, count);
+    }
+}
+
+// Under lock: write the desired values of a delta's state object
+static void shadow_apply_desired(const char *js, const jsmntok_t *t, int obj, int count, uint32_t version)
+{
+    if (obj < 0 || t[obj].type != JSMN_OBJECT) {
+        return;
+    }
+    if (version && version <= s_shadow.applied_version) {
+        ESP_LOGD(TAG, "Delta v%" PRIu32 " already applied", version);
+        return;
+    }
+    s_shadow.applied_version = version;
+    int i = obj + 1;
+    for (int k = 0; k < t[obj].size && i + 1 < count; ++k) {
+        if (tok_eq(js, &t[i], "flags") && t[i + 1].type == JSMN_OBJECT) {
+            shadow_apply_flags(js, t, i + 1, count, version);
+            i = tok_skip(t, i + 1, count);
+            continue;
+        }
+        int f = field_index(js, &t[i]);
+        double value;
+        if (f >= 0 && s_fields[f].set && tok_number(js, &t[i + 1], &value)) {
+            esp_err_t err = s_fields[f].set(value);
+            ESP_LOGI(TAG, "Desired %s=%g (v%" PRIu32 "): %s", s_fields[f].name, value, version, esp_err_to_name(err));
+        }
+        i = tok_skip(t, i + 1, count);
+    }
+}
+
+// Under lock: take the service's reported values as the baseline to diff against
+static void shadow_load_reported(const char *js, const jsmntok_t *t, int obj, int count)
+{
+    memset(s_shadow.reported_set, 0, sizeof(s_shadow.reported_set));
+    memset(s_shadow.flag_reported_set, 0, sizeof(s_shadow.flag_reported_set));
+    if (obj < 0 || t[obj].type != JSMN_OBJECT) {
+        return;
+    }
+    int i = obj + 1;
+    for (int k = 0; k < t[obj].size && i + 1 < count; ++k) {
+        if (tok_eq(js, &t[i], "flags") && t[i + 1].type == JSMN_OBJECT) {
+            int flags = i + 1;
+            int j = flags + 1;
+            for (int n = 0; n < t[flags].size && j + 1 < count; ++n) {
+                int f = feature_flag_find(js + t[j].start, (size_t)(t[j].end - t[j].start));
+                if (f >= 0) {
+                    s_shadow.flag_reported_set[f] = tok_number(js, &t[j + 1], &s_shadow.flag_reported[f]);
+                }
+                j = tok_skip(t, j + 1, count);
+            }
+            i = j;
+            continue;
+        }
+        int f = field_index(js, &t[i]);
+        if (f >= 0) {
+            s_shadow.reported_set[f] = tok_number(js, &t[i + 1], &s_shadow.reported[f]);
+        }
+        i = tok_skip(t, i + 1, count);
+    }
+}
+
+static void shadow_commit_pending(void)
+{
+    for (size_t f = 0; f < SHADOW_FIELD_COUNT; ++f) {
+        if (s_shadow.pending_mask & (1u << f)) {
+            s_shadow.reported[f] = s_shadow.sent[f];
+            s_shadow.reported_set[f] = s_shadow.sent_set[f];
+        }
+    }
+    for (int f = 0; f < FEATURE_FLAG_COUNT; ++f) {
+        if (s_shadow.pending_flags & (1u << f)) {
+            s_shadow.flag_reported[f] = s_shadow.flag_sent[f];
+            s_shadow.flag_reported_set[f] = true;
+        }
+    }
+    s_shadow.pending_token = 0;
+    s_shadow.pending_mask = 0;
+    s_shadow.pending_flags = 0;
+}
+
+// Service task. Topics end in update/delta, {get,update}/accepted or {get,update}/rejected
+static void shadow_on_message(const char *topic, size_t topic_len, const char *payload, size_t len, void *ctx)
+{
+    shadow_msg_t kind = (shadow_msg_t)(intptr_t)ctx;
+    // The device ID is fixed, so the operation sits at a fixed offset
+    size_t base = strlen(s_shadow.topic_get) - 3;
+    bool is_get = topic_len > base + 4 && memcmp(topic + base, "get/", 4) == 0;
+
+    const char *js = payload;
+    jsmntok_t *t = s_shadow.tokens;
+    jsmn_parser parser;
+    jsmn_init(&parser);
+    int count = jsmn_parse(&parser, js, len, t, SHADOW_TOKENS);
+    if (count <= 0 || t[0].type != JSMN_OBJECT) {
+        ESP_LOGW(TAG, "Unparsable shadow message on %.*s (%d)", (int)topic_len, topic, count);
+        return;
+    }
+    uint32_t version = tok_u32(js, t, obj_get(js, t, 0, count, "version"));
+    uint32_t token = 0;
+    int token_tok = obj_get(js, t, 0, count, "clientToken");
+    if (token_tok >= 0 && t[token_tok].type == JSMN_STRING) {
+        token = (uint32_t)strtoul(js + t[token_tok].start, NULL, 10);
+    }
+
+    xSemaphoreTake(s_shadow.lock, portMAX_DELAY);
+    if (version > s_shadow.version) {
+        s_shadow.version = version;
+    }
+    int state = obj_get(js, t, 0, count, "state");
+    switch (kind) {
+    case SHADOW_MSG_DELTA:
+        shadow_apply_desired(js, t, state, count, version);
+        break;
+    case SHADOW_MSG_ACCEPTED:
+        if (is_get) {
+            shadow_load_reported(js, t, obj_get(js, t, state, count, "reported"), count);
+            s_shadow.version = version;
+            s_shadow.synced = true;
+            s_shadow.pending_token = 0;
+            shadow_apply_desired(js, t, obj_get(js, t, state, count, "delta"), count, version);
+            ESP_LOGI(TAG, "Shadow v%" PRIu32 " fetched", version);
+        } else if (token && token == s_shadow.pending_token) {
+            shadow_commit_pending();
+        }
+        break;
+    case SHADOW_MSG_REJECTED: {
+        uint32_t code = tok_u32(js, t, obj_get(js, t, 0, count, "code"));
+        if (is_get && code == 404) {
+            // No document yet: the first update creates it
+            memset(s_shadow.reported_set, 0, sizeof(s_shadow.reported_set));
+            memset(s_shadow.flag_reported_set, 0, sizeof(s_shadow.flag_reported_set));
+            s_shadow.version = 0;
+            s_shadow.synced = true;
+        } else if (!is_get && token && token == s_shadow.pending_token) {
+            if (code == 409) {
+                // Someone else wrote first; fetch what won and diff against that
+                ESP_LOGI(TAG, "Update conflicted with v%" PRIu32 "; refetching", s_shadow.version);
+                s_shadow.pending_token = 0;
+                s_shadow.synced = false;
+                s_shadow.get_sent_us = 0;
+            } else {
+                // Resending would fail the same way
+                ESP_LOGW(TAG, "Update rejected (%" PRIu32 ")", code);
+                shadow_commit_pending();
+            }
+        } else if (is_get) {
+            ESP_LOGW(TAG, "Shadow fetch rejected (%" PRIu32 ")", code);
+        }
+        break;
+    }
+    }
+    xSemaphoreGive(s_shadow.lock);
+}
+
+static bool shadow_field_changed(size_t f, bool present, double value)
+{
+    if (present != s_shadow.reported_set[f]) {
+        return true;
+    }
+    if (!present) {
+        return false;
+    }
+    if (s_fields[f].is_bool) {
+        return (value != 0) != (s_shadow.reported[f] != 0);
+    }
+    return fabs(value - s_shadow.reported[f]) >= s_fields[f].deadband * feature_flag_float(FEATURE_FLAG_DEADBAND_SCALE);
+}
+
+// Under lock: publish the fields and flags that moved, if any
+static void shadow_publish_changes(void)
+{
+    device_state_inputs_t in;
+    if (!device_state_get_inputs(&in, NULL)) {
+        return;
+    }
+    char *payload = s_shadow.payload;
+    const size_t payload_size = sizeof(s_shadow.payload);
+    int pos = snprintf(payload, payload_size, "{\"state\":{\"reported\":{");
+    uint32_t mask = 0;
+    for (size_t f = 0; f < SHADOW_FIELD_COUNT; ++f) {
+        double value = 0;
+        bool present = s_fields[f].get(&in, &value);
+        if (!shadow_field_changed(f, present, value)) {
+            continue;
+        }
+        const char *sep = mask ? "," : "";
+        if (!present) {
+            pos += snprintf(payload + pos, payload_size - pos, "%s\"%s\":null", sep, s_fields[f].name);
+        } else if (s_fields[f].is_bool) {
+            pos += snprintf(payload + pos, payload_size - pos, "%s\"%s\":%s", sep, s_fields[f].name,
+                            value != 0 ? "true" : "false");
+        } else {
+            pos += snprintf(payload + pos, payload_size - pos, "%s\"%s\":%.*f", sep, s_fields[f].name,
+                            s_fields[f].decimals, value);
+        }
+        s_shadow.sent[f] = value;
+        s_shadow.sent_set[f] = present;
+        mask |= 1u << f;
+    }
+    // Effective flags, so a desired override clears from the delta once it is in force
+    uint32_t flags = 0;
+    for (int f = 0; f < FEATURE_FLAG_COUNT; ++f) {
+        double value = feature_flag_value((feature_flag_t)f);
+        // As floats: the document holds them printed to %g
+        if (s_shadow.flag_reported_set[f] && (float)s_shadow.flag_reported[f] == (float)value) {
+            continue;
+        }
+        const char *open = flags ? "," : (mask ? ",\"flags\":{" : "\"flags\":{");
+        pos += snprintf(payload + pos, payload_size - pos, "%s\"%s\":%g", open, feature_flag_name((feature_flag_t)f),
+                        value);
+        s_shadow.flag_sent[f] = value;
+        flags |= 1u << f;
+    }
+    if (flags) {
+        pos += snprintf(payload + pos, payload_size - pos, "}");
+    }
+    if (!mask && !flags) {
+        return;
+    }
+    uint32_t token = ++s_shadow.next_token ? s_shadow.next_token : ++s_shadow.next_token;
+    if (s_shadow.version) {
+        pos += snprintf(payload + pos, payload_size - pos, "}},\"version\":%" PRIu32 ",\"clientToken\":\"%" PRIu32 "\"}",
+                        s_shadow.version, token);
+    } else {
+        pos += snprintf(payload + pos, payload_size - pos, "}},\"clientToken\":\"%" PRIu32 "\"}", token);
+    }
+    if (pos >= (int)payload_size) {
+        ESP_LOGE(TAG, "Shadow update does not fit %d bytes", SHADOW_PAYLOAD_MAX);
+        return;
+    }
+    // Partial documents: coalescing one into the next would lose fields
+    esp_err_t err = aws_iot_service_publish(s_shadow.topic_update, QOS1, payload, (size_t)pos,
+                                            AWS_IOT_SERVICE_PRIORITY_TELEMETRY, false);
+    if (err == ESP_OK) {
+        s_shadow.pending_token = token;
+        s_shadow.pending_mask = mask;
+        s_shadow.pending_flags = flags;
+        s_shadow.pending_since_us = esp_timer_get_time();
+        ESP_LOGD(TAG, "Reported %u fields at v%" PRIu32 ": %s", (unsigned)__builtin_popcount(mask),
+                 s_shadow.version, payload);
+    }
+}
+
+static void shadow_tick(void *arg)
+{
+    (void)arg;
+    // A gateway peer has no connection of its own; its gateway is not its shadow
+    if (!aws_iot_service_is_running() || somnus_mqtt_gateway_is_peer()) {
+        return;
+    }
+    if (xSemaphoreTake(s_shadow.lock, 0) != pdTRUE) {
+        return;
+    }
+    int64_t now = esp_timer_get_time();
+    int64_t timeout_us = (int64_t)CONFIG_KVA_DEVICE_SHADOW_TIMEOUT_MS * 1000;
+    if (s_shadow.pending_token && now - s_shadow.pending_since_us > timeout_us) {
+        // The answer went missing; fetch the document rather than guess
+        s_shadow.pending_token = 0;
+        s_shadow.synced = false;
+        s_shadow.get_sent_us = 0;
+    }
+    if (!s_shadow.synced) {
+        if (s_shadow.get_sent_us == 0 || now - s_shadow.get_sent_us > timeout_us) {
+            static const char get_payload[] = "{}";
+            if (aws_iot_service_publish(s_shadow.topic_get, QOS1, get_payload, sizeof(get_payload) - 1,
+                                        AWS_IOT_SERVICE_PRIORITY_TELEMETRY, true) == ESP_OK) {
+                s_shadow.get_sent_us = now;
+            }
+        }
+    } else if (!s_shadow.pending_token) {
+        shadow_publish_changes();
+    }
+    xSemaphoreGive(s_shadow.lock);
+}
+
+esp_err_t device_shadow_start(void)
+{
+    ESP_RETURN_ON_FALSE(!s_shadow.lock, ESP_ERR_INVALID_STATE, TAG, "already started");
+    const char *thing = somnus_mqtt_get_device_id();
+    ESP_RETURN_ON_FALSE(thing, ESP_ERR_INVALID_STATE, TAG, "no device ID");
+
+    char filter[SHADOW_TOPIC_MAX];
+    snprintf(s_shadow.topic_update, sizeof(s_shadow.topic_update), "$aws/things/%s/shadow/update", thing);
+    snprintf(s_shadow.topic_get, sizeof(s_shadow.topic_get), "$aws/things/%s/shadow/get", thing);
+    s_shadow.lock = xSemaphoreCreateMutex();
+    ESP_RETURN_ON_FALSE(s_shadow.lock, ESP_ERR_NO_MEM, TAG, "lock");
+
+    // Not update/+: update/documents repeats the whole document on every change
+    static const struct {
+        const char *suffix;
+        shadow_msg_t kind;
+    } subs[] = {
+        {"update/delta", SHADOW_MSG_DELTA},
+        {"+/accepted", SHADOW_MSG_ACCEPTED},
+        {"+/rejected", SHADOW_MSG_REJECTED},
+    };
+    for (size_t i = 0; i < sizeof(subs) / sizeof(subs[0]); ++i) {
+        snprintf(filter, sizeof(filter), "$aws/things/%s/shadow/%s", thing, subs[i].suffix);
+        ESP_RETURN_ON_ERROR(somnus_mqtt_subscribe(filter, shadow_on_message, (void *)(intptr_t)subs[i].kind), TAG,
+                            "subscribe %s", subs[i].suffix);
+    }
+
+    const timer_wheel_timer_config_t args = {
+        .callback = shadow_tick,
+        .name = "device_shadow",
+        .slack_ms = CONFIG_KVA_DEVICE_SHADOW_SYNC_MS / 4,
+    };
+    ESP_RETURN_ON_ERROR(timer_wheel_create(&args, &s_shadow.timer), TAG, "timer");
+    timer_wheel_start_periodic(s_shadow.timer, CONFIG_KVA_DEVICE_SHADOW_SYNC_MS);
+    ESP_LOGI(TAG, "Syncing shadow of %s", thing);
+    return ESP_OK;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * AWS IoT Device Shadow of the thing named by the Somnus device ID.
+ *
+ * Every CONFIG_KVA_DEVICE_SHADOW_SYNC_MS the device state (device_state.h)
+ * is compared field by field with what the shadow service last accepted as
+ * reported, and only the fields that moved go out, conditioned on the
+ * document version. One update is in flight at a time; a version conflict
+ * fetches the document again and rediffs against it.
+ *
+ * Desired values the app writes (lights_enabled, muted, sleep_mode) arrive
+ * as delta messages, which are tokenized in place and applied in version
+ * order; a delta older than one already applied is dropped.
+ *
+ * Feature flags (feature_flags.h) ride in a "flags" object on both sides:
+ * desired "flags": {"afe_quiet_ms": 30000} overrides one, and the device
+ * reports the effective value of every flag, so the delta clears once an
+ * override is in force. Setting a flag back to its default, or to null,
+ * removes the override.
+ */
+esp_err_t device_shadow_start(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -7,7 +7,14 @@
 #include "esp_system.h"
 #include "cJSON.h"
 #include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "interaction_arena.h"
+#include "json_writer.h"
+#include "timer_wheel.h"
 #include <inttypes.h>
+#include <math.h>
+#include <stdlib.h>
 #include <string.h>
 
 #ifdef KVA_HAVE_CSPOT
@@ -16,6 +23,20 @@
 
 static const char *TAG = "device_state";
 
+// How often the snapshot is checked against its inputs
+#define DEVICE_STATE_REFRESH_MS 2000
+// Sensor movement that counts as a change worth rebuilding for
+#define DEVICE_STATE_TEMPERATURE_DEADBAND_C 0.2f
+#define DEVICE_STATE_HUMIDITY_DEADBAND_RH 1.0f
+#define DEVICE_STATE_CO2_DEADBAND_PPM 25.0f
+#define DEVICE_STATE_VOC_DEADBAND 5.0f
+#define DEVICE_STATE_PM_DEADBAND_UG_M3 2.0f
+#define DEVICE_STATE_LUX_DEADBAND_MIN 5.0f
+#define DEVICE_STATE_LUX_DEADBAND_FRACTION 0.1f
+// Headroom so small size changes reuse the buffer
+#define DEVICE_STATE_SNAPSHOT_SLACK 128
+#define DEVICE_STATE_MAX_SLEEP_LISTENERS 4
+
 // Forward declarations for global state (defined in naphome_voice_assistant_main.c)
 // Access global state directly via extern declarations
 extern led_controller_t *s_led_controller_handle;
@@ -35,6 +56,15 @@ typedef struct {
 
 static device_state_context_t s_ctx = {0};
 
+static struct {
+    bool sleeping;
+    device_state_sleep_cb_t cb[DEVICE_STATE_MAX_SLEEP_LISTENERS];
+    void *ctx[DEVICE_STATE_MAX_SLEEP_LISTENERS];
+    size_t count;
+} s_sleep;
+
+static void device_state_snapshot_init(void);
+
 void device_state_set_context(void *led_handle, bool lights_enabled, bool aws_connected, bool muted, bool audio_playing)
 {
     // Cache initial values, but we'll read from globals when generating state
@@ -43,6 +73,7 @@ void device_state_set_context(void *led_handle, bool lights_enabled, bool aws_co
     s_ctx.aws_connected = aws_connected;
     s_ctx.muted = muted;
     s_ctx.audio_playing = audio_playing;
+    device_state_snapshot_init();
     ESP_LOGI(TAG, "Device state context initialized: LEDs=%s, AWS=%s, Audio=%s, Muted=%s",
              lights_enabled ? "ON" : "OFF",
              aws_connected ? "connected" : "disconnected",
@@ -50,167 +81,398 @@ void device_state_set_context(void *led_handle, bool lights_enabled, bool aws_co
              muted ? "yes" : "no");
 }
 
-// Get sensor data from sensor_manager
-static void add_sensor_data(cJSON *root)
+static struct {
+    SemaphoreHandle_t lock;
+    char *json;                       // Heap, never the interaction arena
+    size_t len;
+    size_t cap;
+    uint32_t version;
+    bool valid;
+    device_state_inputs_t inputs;     // What json was built from
+    timer_wheel_timer_t *refresh_timer;
+} s_snapshot;
+
+static bool device_state_low_memory(void)
 {
-    cJSON *sensors = cJSON_CreateObject();
-    
-    // Get actual sensor data
-    sensor_integration_data_t sensor_data = sensor_integration_get_data();
-    
-    cJSON_AddBoolToObject(sensors, "sht45_available", sensor_data.sht45_available);
-    cJSON_AddBoolToObject(sensors, "sgp40_available", sensor_data.sgp40_available);
-    cJSON_AddBoolToObject(sensors, "scd40_available", sensor_data.scd40_available);
-    cJSON_AddBoolToObject(sensors, "vcnl4040_available", sensor_data.vcnl4040_available);
-    cJSON_AddBoolToObject(sensors, "ec10_available", sensor_data.ec10_available);
+    return !(esp_get_free_heap_size() > 50000 && esp_get_minimum_free_heap_size() > 10000);
+}
+
+static void device_state_collect(device_state_inputs_t *in)
+{
+    memset(in, 0, sizeof(*in));
+    led_controller_t *led_handle = s_led_controller_handle ? s_led_controller_handle : s_ctx.led_handle;
+    in->lights_enabled = s_lights_enabled;
+    in->muted = s_muted;
+    in->audio_playing = s_audio_playing;
+    in->aws_connected = s_aws_connected;
+    in->sleep_mode = s_sleep.sleeping;
+#ifdef KVA_HAVE_CSPOT
+    in->spotify_ready = spotify_player_is_ready();
+#endif
+    in->low_memory = device_state_low_memory();
+
+    wifi_ap_record_t ap_info;
+    if (esp_wifi_sta_get_ap_info(&ap_info) == ESP_OK) {
+        in->wifi_connected = true;
+        in->wifi_rssi = ap_info.rssi;
+        memcpy(in->wifi_ssid, ap_info.ssid, sizeof(in->wifi_ssid) - 1);
+    }
+    if (led_handle) {
+        in->leds_present = true;
+        in->led_count = led_handle->led_count;
+        in->led_brightness = led_handle->brightness;
+    }
+    in->sensors = sensor_integration_get_data();
+}
+
+static bool device_state_moved(float a, float b, float deadband)
+{
+    return fabsf(a - b) >= deadband;
+}
+
+static bool device_state_sensors_changed(const sensor_integration_data_t *a, const sensor_integration_data_t *b)
+{
+    if (a->sht45_available != b->sht45_available || a->sgp40_available != b->sgp40_available ||
+        a->scd40_available != b->scd40_available || a->vcnl4040_available != b->vcnl4040_available ||
+        a->ec10_available != b->ec10_available) {
+        return true;
+    }
+    if (a->sht45_available &&
+        (device_state_moved(a->temperature_c, b->temperature_c, DEVICE_STATE_TEMPERATURE_DEADBAND_C) ||
+         device_state_moved(a->humidity_rh, b->humidity_rh, DEVICE_STATE_HUMIDITY_DEADBAND_RH))) {
+        return true;
+    }
+    if (a->sgp40_available && device_state_moved(a->voc_index, b->voc_index, DEVICE_STATE_VOC_DEADBAND)) {
+        return true;
+    }
+    if (a->scd40_available &&
+        (device_state_moved(a->co2_ppm, b->co2_ppm, DEVICE_STATE_CO2_DEADBAND_PPM) ||
+         device_state_moved(a->temperature_co2_c, b->temperature_co2_c, DEVICE_STATE_TEMPERATURE_DEADBAND_C) ||
+         device_state_moved(a->humidity_co2_rh, b->humidity_co2_rh, DEVICE_STATE_HUMIDITY_DEADBAND_RH))) {
+        return true;
+    }
+    if (a->vcnl4040_available) {
+        // Light is judged relative to the level it was built with
+        float lux_deadband = fmaxf(DEVICE_STATE_LUX_DEADBAND_MIN, b->ambient_lux * DEVICE_STATE_LUX_DEADBAND_FRACTION);
+        if (device_state_moved(a->ambient_lux, b->ambient_lux, lux_deadband)) {
+            return true;
+        }
+    }
+    if (a->ec10_available && device_state_moved(a->ec_ms_per_cm, b->ec_ms_per_cm, DEVICE_STATE_PM_DEADBAND_UG_M3)) {
+        return true;
+    }
+    return false;
+}
+
+static bool device_state_inputs_changed(const device_state_inputs_t *a, const device_state_inputs_t *b)
+{
+    return a->lights_enabled != b->lights_enabled || a->muted != b->muted || a->audio_playing != b->audio_playing ||
+           a->aws_connected != b->aws_connected || a->spotify_ready != b->spotify_ready ||
+           a->sleep_mode != b->sleep_mode ||
+           a->low_memory != b->low_memory || a->wifi_connected != b->wifi_connected ||
+           strcmp(a->wifi_ssid, b->wifi_ssid) != 0 || a->leds_present != b->leds_present ||
+           a->led_count != b->led_count || a->led_brightness != b->led_brightness ||
+           device_state_sensors_changed(&a->sensors, &b->sensors);
+}
+
+// Without placeholders, readings of missing sensors are left out rather than written as 0
+static void write_sensor_data(json_writer_t *w, const sensor_integration_data_t *sensor_data, bool placeholders)
+{
+    json_writer_bool(w, "sht45_available", sensor_data->sht45_available);
+    json_writer_bool(w, "sgp40_available", sensor_data->sgp40_available);
+    json_writer_bool(w, "scd40_available", sensor_data->scd40_available);
+    json_writer_bool(w, "vcnl4040_available", sensor_data->vcnl4040_available);
+    json_writer_bool(w, "ec10_available", sensor_data->ec10_available);
     
-    if (sensor_data.sht45_available) {
-        cJSON_AddNumberToObject(sensors, "temperature_c", sensor_data.temperature_c);
-        cJSON_AddNumberToObject(sensors, "humidity_rh", sensor_data.humidity_rh);
-    } else {
-        cJSON_AddNumberToObject(sensors, "temperature_c", 0.0);
-        cJSON_AddNumberToObject(sensors, "humidity_rh", 0.0);
+    if (sensor_data->sht45_available) {
+        json_writer_float(w, "temperature_c", sensor_data->temperature_c);
+        json_writer_float(w, "humidity_rh", sensor_data->humidity_rh);
+    } else if (placeholders) {
+        json_writer_int(w, "temperature_c", 0);
+        json_writer_int(w, "humidity_rh", 0);
     }
     
-    if (sensor_data.sgp40_available) {
-        cJSON_AddNumberToObject(sensors, "voc_index", sensor_data.voc_index);
-    } else {
-        cJSON_AddNumberToObject(sensors, "voc_index", 0);
+    if (sensor_data->sgp40_available) {
+        json_writer_int(w, "voc_index", sensor_data->voc_index);
+    } else if (placeholders) {
+        json_writer_int(w, "voc_index", 0);
     }
     
-    if (sensor_data.scd40_available) {
-        cJSON_AddNumberToObject(sensors, "co2_ppm", sensor_data.co2_ppm);
-        cJSON_AddNumberToObject(sensors, "temperature_co2_c", sensor_data.temperature_co2_c);
-        cJSON_AddNumberToObject(sensors, "humidity_co2_rh", sensor_data.humidity_co2_rh);
-    } else {
-        cJSON_AddNumberToObject(sensors, "co2_ppm", 0);
-        cJSON_AddNumberToObject(sensors, "temperature_co2_c", 0.0);
-        cJSON_AddNumberToObject(sensors, "humidity_co2_rh", 0.0);
+    if (sensor_data->scd40_available) {
+        json_writer_float(w, "co2_ppm", sensor_data->co2_ppm);
+        json_writer_float(w, "temperature_co2_c", sensor_data->temperature_co2_c);
+        json_writer_float(w, "humidity_co2_rh", sensor_data->humidity_co2_rh);
+    } else if (placeholders) {
+        json_writer_int(w, "co2_ppm", 0);
+        json_writer_int(w, "temperature_co2_c", 0);
+        json_writer_int(w, "humidity_co2_rh", 0);
     }
     
-    if (sensor_data.vcnl4040_available) {
-        cJSON_AddNumberToObject(sensors, "ambient_lux", sensor_data.ambient_lux);
-        cJSON_AddNumberToObject(sensors, "proximity", sensor_data.proximity);
-    } else {
-        cJSON_AddNumberToObject(sensors, "ambient_lux", 0.0);
-        cJSON_AddNumberToObject(sensors, "proximity", 0);
+    if (sensor_data->vcnl4040_available) {
+        json_writer_int(w, "ambient_lux", sensor_data->ambient_lux);
+        json_writer_int(w, "proximity", sensor_data->proximity);
+    } else if (placeholders) {
+        json_writer_int(w, "ambient_lux", 0);
+        json_writer_int(w, "proximity", 0);
     }
     
-    if (sensor_data.ec10_available) {
+    if (sensor_data->ec10_available) {
         // EC10 stores PM2.5 in ec_ms_per_cm field (as per sensor_integration.h comment)
-        cJSON_AddNumberToObject(sensors, "pm2_5_ug_m3", sensor_data.ec_ms_per_cm);
-        cJSON_AddNumberToObject(sensors, "pm10_ug_m3", 0.0);  // PM10 not available from EC10
-    } else {
-        cJSON_AddNumberToObject(sensors, "pm2_5_ug_m3", 0.0);
-        cJSON_AddNumberToObject(sensors, "pm10_ug_m3", 0.0);
+        json_writer_float(w, "pm2_5_ug_m3", sensor_data->ec_ms_per_cm);
+        json_writer_int(w, "pm10_ug_m3", 0);  // PM10 not available from EC10
+    } else if (placeholders) {
+        json_writer_int(w, "pm2_5_ug_m3", 0);
+        json_writer_int(w, "pm10_ug_m3", 0);
     }
-    
-    cJSON_AddItemToObject(root, "sensors", sensors);
 }
 
-char *device_state_to_json(void)
+// Returns the document's length, which is size or more when it did not fit
+static size_t device_state_write_json(const device_state_inputs_t *in, char *buf, size_t size)
 {
-    cJSON *root = cJSON_CreateObject();
-    if (!root) {
-        ESP_LOGE(TAG, "Failed to create JSON root");
-        return NULL;
-    }
+    json_writer_t w;
+    json_writer_init(&w, buf, size);
+    json_writer_begin_object(&w, NULL);
     
     // Device info
-    cJSON *device = cJSON_CreateObject();
-    cJSON_AddStringToObject(device, "name", "Naphome Voice Assistant");
-    cJSON_AddStringToObject(device, "type", "ESP32-S3");
-    cJSON_AddNumberToObject(device, "free_heap_bytes", (double)esp_get_free_heap_size());
-    cJSON_AddNumberToObject(device, "min_free_heap_bytes", (double)esp_get_minimum_free_heap_size());
-    cJSON_AddItemToObject(root, "device", device);
+    json_writer_begin_object(&w, "device");
+    json_writer_string(&w, "name", "Naphome Voice Assistant");
+    json_writer_string(&w, "type", "ESP32-S3");
+    json_writer_int(&w, "free_heap_bytes", esp_get_free_heap_size());
+    json_writer_int(&w, "min_free_heap_bytes", esp_get_minimum_free_heap_size());
+    json_writer_end_object(&w);
     
     // WiFi status
-    cJSON *wifi = cJSON_CreateObject();
-    wifi_ap_record_t ap_info;
-    esp_err_t wifi_ret = esp_wifi_sta_get_ap_info(&ap_info);
-    if (wifi_ret == ESP_OK) {
-        cJSON_AddBoolToObject(wifi, "connected", true);
-        cJSON_AddStringToObject(wifi, "ssid", (const char *)ap_info.ssid);
-        cJSON_AddNumberToObject(wifi, "rssi", ap_info.rssi);
-    } else {
-        cJSON_AddBoolToObject(wifi, "connected", false);
-        cJSON_AddStringToObject(wifi, "ssid", "");
-        cJSON_AddNumberToObject(wifi, "rssi", 0);
-    }
-    cJSON_AddItemToObject(root, "wifi", wifi);
+    json_writer_begin_object(&w, "wifi");
+    json_writer_bool(&w, "connected", in->wifi_connected);
+    json_writer_string(&w, "ssid", in->wifi_ssid);
+    json_writer_int(&w, "rssi", in->wifi_rssi);
+    json_writer_end_object(&w);
     
-    // LED status - read from global state
-    cJSON *leds = cJSON_CreateObject();
-    led_controller_t *led_handle = s_led_controller_handle ? s_led_controller_handle : s_ctx.led_handle;
-    if (led_handle) {
-        cJSON_AddBoolToObject(leds, "enabled", s_lights_enabled);
-        cJSON_AddNumberToObject(leds, "count", led_handle->led_count);
-        cJSON_AddNumberToObject(leds, "brightness", led_handle->brightness);
-        const char *state_str = "idle";
-        switch (led_handle->state) {
-            case LED_CONTROLLER_STATE_IDLE: state_str = "idle"; break;
-            case LED_CONTROLLER_STATE_LISTENING: state_str = "listening"; break;
-            case LED_CONTROLLER_STATE_THINKING: state_str = "thinking"; break;
-            case LED_CONTROLLER_STATE_SPEAKING: state_str = "speaking"; break;
-            case LED_CONTROLLER_STATE_ERROR: state_str = "error"; break;
-        }
-        cJSON_AddStringToObject(leds, "state", state_str);
+    // LED status. The animation state is left out: it always reads "thinking"
+    // while a request is being built, so it told the model nothing
+    json_writer_begin_object(&w, "leds");
+    if (in->leds_present) {
+        json_writer_bool(&w, "enabled", in->lights_enabled);
+        json_writer_int(&w, "count", in->led_count);
+        json_writer_int(&w, "brightness", in->led_brightness);
     } else {
-        cJSON_AddBoolToObject(leds, "enabled", false);
+        json_writer_bool(&w, "enabled", false);
     }
-    cJSON_AddItemToObject(root, "leds", leds);
+    json_writer_end_object(&w);
     
-    // Audio status - read from global state
-    cJSON *audio = cJSON_CreateObject();
-    cJSON_AddBoolToObject(audio, "playing", s_audio_playing);
-    cJSON_AddBoolToObject(audio, "muted", s_muted);
-    cJSON_AddItemToObject(root, "audio", audio);
+    // Audio status
+    json_writer_begin_object(&w, "audio");
+    json_writer_bool(&w, "playing", in->audio_playing);
+    json_writer_bool(&w, "muted", in->muted);
+    json_writer_end_object(&w);
+    json_writer_bool(&w, "sleep_mode", in->sleep_mode);
     
-    // AWS IoT status - read from global state
-    cJSON *aws = cJSON_CreateObject();
-    cJSON_AddBoolToObject(aws, "connected", s_aws_connected);
-    cJSON_AddItemToObject(root, "aws", aws);
+    // AWS IoT status
+    json_writer_begin_object(&w, "aws");
+    json_writer_bool(&w, "connected", in->aws_connected);
+    json_writer_end_object(&w);
     
     // Spotify status
-    cJSON *spotify = cJSON_CreateObject();
+    json_writer_begin_object(&w, "spotify");
 #ifdef KVA_HAVE_CSPOT
-    cJSON_AddBoolToObject(spotify, "cspot_enabled", true);
-    extern bool spotify_player_is_ready(void);
-    cJSON_AddBoolToObject(spotify, "ready", spotify_player_is_ready());
+    json_writer_bool(&w, "cspot_enabled", true);
 #else
-    cJSON_AddBoolToObject(spotify, "cspot_enabled", false);
-    cJSON_AddBoolToObject(spotify, "ready", false);
+    json_writer_bool(&w, "cspot_enabled", false);
 #endif
-    cJSON_AddItemToObject(root, "spotify", spotify);
+    json_writer_bool(&w, "ready", in->spotify_ready);
+    json_writer_end_object(&w);
     
     // Sensors
-    add_sensor_data(root);
+    json_writer_begin_object(&w, "sensors");
+    write_sensor_data(&w, &in->sensors, true);
+    json_writer_end_object(&w);
     
     // System health
-    cJSON *health = cJSON_CreateObject();
+    json_writer_begin_object(&w, "health");
     uint32_t free_heap = esp_get_free_heap_size();
     uint32_t min_free = esp_get_minimum_free_heap_size();
-    const char *health_status = (free_heap > 50000 && min_free > 10000) ? "healthy" : "low_memory";
-    cJSON_AddStringToObject(health, "status", health_status);
-    cJSON_AddNumberToObject(health, "free_heap_bytes", free_heap);
-    cJSON_AddNumberToObject(health, "min_free_heap_bytes", min_free);
-    cJSON_AddNumberToObject(health, "free_heap_percent", (free_heap * 100.0) / (512 * 1024));  // Approximate
+    json_writer_string(&w, "status", in->low_memory ? "low_memory" : "healthy");
+    json_writer_int(&w, "free_heap_bytes", free_heap);
+    json_writer_int(&w, "min_free_heap_bytes", min_free);
+    json_writer_double(&w, "free_heap_percent", (free_heap * 100.0) / (512 * 1024));  // Approximate
     
     // Count active sensors
-    sensor_integration_data_t sensor_data = sensor_integration_get_data();
     int sensor_count = 0;
-    if (sensor_data.sht45_available) sensor_count++;
-    if (sensor_data.sgp40_available) sensor_count++;
-    if (sensor_data.scd40_available) sensor_count++;
-    if (sensor_data.vcnl4040_available) sensor_count++;
-    if (sensor_data.ec10_available) sensor_count++;
-    cJSON_AddNumberToObject(health, "sensors_active", sensor_count);
+    if (in->sensors.sht45_available) sensor_count++;
+    if (in->sensors.sgp40_available) sensor_count++;
+    if (in->sensors.scd40_available) sensor_count++;
+    if (in->sensors.vcnl4040_available) sensor_count++;
+    if (in->sensors.ec10_available) sensor_count++;
+    json_writer_int(&w, "sensors_active", sensor_count);
     
-    cJSON_AddItemToObject(root, "health", health);
+    json_writer_end_object(&w);
+    json_writer_end_object(&w);
     
-    char *json_str = cJSON_PrintUnformatted(root);
-    cJSON_Delete(root);
-    return json_str;
+    size_t len = 0;
+    json_writer_finish(&w, &len);
+    return len;
+}
+
+// Called with s_snapshot.lock held
+static void device_state_refresh_locked(void)
+{
+    device_state_inputs_t in;
+    device_state_collect(&in);
+    if (s_snapshot.valid && !device_state_inputs_changed(&in, &s_snapshot.inputs)) {
+        return;
+    }
+
+    // Written straight into the snapshot; only a document that outgrew it is written twice
+    size_t len = device_state_write_json(&in, s_snapshot.json, s_snapshot.cap);
+    if (len + 1 > s_snapshot.cap) {
+        char *grown = realloc(s_snapshot.json, len + 1 + DEVICE_STATE_SNAPSHOT_SLACK);
+        if (!grown) {
+            // The partial write has already replaced the old document
+            s_snapshot.valid = false;
+            return;
+        }
+        s_snapshot.json = grown;
+        s_snapshot.cap = len + 1 + DEVICE_STATE_SNAPSHOT_SLACK;
+        len = device_state_write_json(&in, s_snapshot.json, s_snapshot.cap);
+        if (len + 1 > s_snapshot.cap) {
+            s_snapshot.valid = false;
+            return;
+        }
+    }
+    s_snapshot.len = len;
+    s_snapshot.inputs = in;
+    s_snapshot.valid = true;
+    s_snapshot.version++;
+    ESP_LOGD(TAG, "Device state snapshot v%" PRIu32 " rebuilt (%u bytes)", s_snapshot.version, (unsigned)len);
+}
+
+static void device_state_refresh_cb(void *arg)
+{
+    (void)arg;
+    if (xSemaphoreTake(s_snapshot.lock, 0) == pdTRUE) {
+        device_state_refresh_locked();
+        xSemaphoreGive(s_snapshot.lock);
+    }
+}
+
+static void device_state_snapshot_init(void)
+{
+    if (s_snapshot.lock) {
+        return;
+    }
+    s_snapshot.lock = xSemaphoreCreateMutex();
+    if (!s_snapshot.lock) {
+        ESP_LOGE(TAG, "Failed to create snapshot lock");
+        return;
+    }
+    const timer_wheel_timer_config_t args = {
+        .callback = device_state_refresh_cb,
+        .name = "device_state",
+        .slack_ms = DEVICE_STATE_REFRESH_MS / 4,
+    };
+    if (timer_wheel_create(&args, &s_snapshot.refresh_timer) == ESP_OK) {
+        timer_wheel_start_periodic(s_snapshot.refresh_timer, DEVICE_STATE_REFRESH_MS);
+    }
+}
+
+char *device_state_to_json(void)
+{
+    device_state_snapshot_init();
+    if (!s_snapshot.lock || xSemaphoreTake(s_snapshot.lock, portMAX_DELAY) != pdTRUE) {
+        return NULL;
+    }
+    // Usually a no-op: the timer has already folded in any change
+    device_state_refresh_locked();
+    char *copy = NULL;
+    if (s_snapshot.valid) {
+        copy = interaction_arena_malloc(s_snapshot.len + 1);
+        if (copy) {
+            memcpy(copy, s_snapshot.json, s_snapshot.len + 1);
+        }
+    }
+    xSemaphoreGive(s_snapshot.lock);
+    return copy;
+}
+
+uint32_t device_state_version(void)
+{
+    return s_snapshot.version;
+}
+
+bool device_state_get_inputs(device_state_inputs_t *out, uint32_t *version)
+{
+    device_state_snapshot_init();
+    if (!s_snapshot.lock || xSemaphoreTake(s_snapshot.lock, portMAX_DELAY) != pdTRUE) {
+        return false;
+    }
+    device_state_refresh_locked();
+    bool valid = s_snapshot.valid;
+    if (valid) {
+        *out = s_snapshot.inputs;
+        if (version) {
+            *version = s_snapshot.version;
+        }
+    }
+    xSemaphoreGive(s_snapshot.lock);
+    return valid;
+}
+
+esp_err_t device_state_set_lights(bool enabled)
+{
+    led_controller_t *led_handle = s_led_controller_handle ? s_led_controller_handle : s_ctx.led_handle;
+    if (!led_handle) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    s_lights_enabled = enabled;
+    s_ctx.lights_enabled = enabled;
+    if (enabled) {
+        led_controller_start_trippy_fade(led_handle);
+        led_controller_set_enabled(led_handle, true);
+    } else {
+        led_controller_set_enabled(led_handle, false);
+    }
+    return ESP_OK;
+}
+
+void device_state_set_muted(bool muted)
+{
+    s_muted = muted;
+    s_ctx.muted = muted;
+}
+
+esp_err_t device_state_add_sleep_listener(device_state_sleep_cb_t cb, void *ctx)
+{
+    if (!cb) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (s_sleep.count >= DEVICE_STATE_MAX_SLEEP_LISTENERS) {
+        return ESP_ERR_NO_MEM;
+    }
+    s_sleep.cb[s_sleep.count] = cb;
+    s_sleep.ctx[s_sleep.count] = ctx;
+    s_sleep.count++;
+    // Joining while already asleep starts it right away
+    if (s_sleep.sleeping) {
+        cb(true, ctx);
+    }
+    return ESP_OK;
+}
+
+void device_state_set_sleep_mode(bool sleeping)
+{
+    if (sleeping == s_sleep.sleeping) {
+        return;
+    }
+    s_sleep.sleeping = sleeping;
+    ESP_LOGI(TAG, "Sleep mode %s", sleeping ? "on" : "off");
+    for (size_t i = 0; i < s_sleep.count; ++i) {
+        s_sleep.cb[i](sleeping, s_sleep.ctx[i]);
+    }
+}
+
+bool device_state_sleep_mode(void)
+{
+    return s_sleep.sleeping;
 }
 
 esp_err_t gemini_execute_function_call(const char *function_name, const char *arguments_json, char *response_text, size_t response_len)
@@ -230,7 +492,7 @@ esp_err_t gemini_execute_function_call(const char *function_name, const char *ar
         char *state_json = device_state_to_json();
         if (state_json) {
             snprintf(response_text, response_len, "%s", state_json);
-            free(state_json);
+            cJSON_free(state_json);
         } else {
             snprintf(response_text, response_len, "{\"error\": \"Failed to generate device state\"}");
             ret = ESP_FAIL;
@@ -277,63 +539,20 @@ esp_err_t gemini_execute_function_call(const char *function_name, const char *ar
     }
     else if (strcmp(function_name, "get_sensors") == 0) {
         sensor_integration_data_t sensor_data = sensor_integration_get_data();
-        cJSON *sensors = cJSON_CreateObject();
-        
-        cJSON_AddBoolToObject(sensors, "sht45_available", sensor_data.sht45_available);
-        cJSON_AddBoolToObject(sensors, "sgp40_available", sensor_data.sgp40_available);
-        cJSON_AddBoolToObject(sensors, "scd40_available", sensor_data.scd40_available);
-        cJSON_AddBoolToObject(sensors, "vcnl4040_available", sensor_data.vcnl4040_available);
-        cJSON_AddBoolToObject(sensors, "ec10_available", sensor_data.ec10_available);
-        
-        if (sensor_data.sht45_available) {
-            cJSON_AddNumberToObject(sensors, "temperature_c", sensor_data.temperature_c);
-            cJSON_AddNumberToObject(sensors, "humidity_rh", sensor_data.humidity_rh);
-        }
-        if (sensor_data.sgp40_available) {
-            cJSON_AddNumberToObject(sensors, "voc_index", sensor_data.voc_index);
-        }
-        if (sensor_data.scd40_available) {
-            cJSON_AddNumberToObject(sensors, "co2_ppm", sensor_data.co2_ppm);
-            cJSON_AddNumberToObject(sensors, "temperature_co2_c", sensor_data.temperature_co2_c);
-            cJSON_AddNumberToObject(sensors, "humidity_co2_rh", sensor_data.humidity_co2_rh);
+        json_writer_t w;
+        json_writer_init(&w, response_text, response_len);
+        json_writer_begin_object(&w, NULL);
+        write_sensor_data(&w, &sensor_data, false);
+        json_writer_end_object(&w);
+        if (json_writer_finish(&w, NULL) != ESP_OK) {
+            snprintf(response_text, response_len, "{}");
         }
-        if (sensor_data.vcnl4040_available) {
-            cJSON_AddNumberToObject(sensors, "ambient_lux", sensor_data.ambient_lux);
-            cJSON_AddNumberToObject(sensors, "proximity", sensor_data.proximity);
-        }
-        if (sensor_data.ec10_available) {
-            // EC10 stores PM2.5 in ec_ms_per_cm field
-            cJSON_AddNumberToObject(sensors, "pm2_5_ug_m3", sensor_data.ec_ms_per_cm);
-            cJSON_AddNumberToObject(sensors, "pm10_ug_m3", 0.0);
-        }
-        
-        char *sensors_str = cJSON_PrintUnformatted(sensors);
-        snprintf(response_text, response_len, "%s", sensors_str ? sensors_str : "{}");
-        if (sensors_str) free(sensors_str);
-        cJSON_Delete(sensors);
     }
     else if (strcmp(function_name, "set_leds") == 0) {
         cJSON *enabled = cJSON_GetObjectItem(args, "enabled");
-        led_controller_t *led_handle = s_led_controller_handle ? s_led_controller_handle : s_ctx.led_handle;
-        if (cJSON_IsBool(enabled) && led_handle) {
+        if (cJSON_IsBool(enabled) && device_state_set_lights(cJSON_IsTrue(enabled)) == ESP_OK) {
             bool enable = cJSON_IsTrue(enabled);
-            
-            // Update global state
-            s_lights_enabled = enable;
-            s_ctx.lights_enabled = enable;
-            
-            // Actually control LEDs
-            if (enable) {
-                led_controller_start_trippy_fade(led_handle);
-                ESP_LOGI(TAG, "🔧 [Gemini Tools] set_leds: ON - Started trippy fade");
-            } else {
-                led_controller_stop_trippy_fade(led_handle);
-                for (uint8_t i = 0; i < led_handle->led_count; ++i) {
-                    led_controller_set_pixel_color(led_handle, i, 0, 0, 0);
-                }
-                ESP_LOGI(TAG, "🔧 [Gemini Tools] set_leds: OFF - All LEDs turned off");
-            }
-            
+            ESP_LOGI(TAG, "🔧 [Gemini Tools] set_leds: %s", enable ? "ON - Started trippy fade" : "OFF - All LEDs turned off");
             snprintf(response_text, response_len, "{\"success\": true, \"message\": \"LEDs turned %s\"}", enable ? "on" : "off");
         } else {
             snprintf(response_text, response_len, "{\"error\": \"Invalid arguments or LEDs not available\"}");
@@ -350,11 +569,8 @@ esp_err_t gemini_execute_function_call(const char *function_name, const char *ar
             uint8_t g = (uint8_t)cJSON_GetNumberValue(green);
             uint8_t b = (uint8_t)cJSON_GetNumberValue(blue);
             
-            // Stop trippy fade and set solid color
-            led_controller_stop_trippy_fade(led_handle);
-            for (uint8_t i = 0; i < led_handle->led_count; ++i) {
-                led_controller_set_pixel_color(led_handle, i, r, g, b);
-            }
+            // Replaces the trippy fade and turns the strip back on
+            led_controller_set_color(led_handle, r, g, b);
             s_lights_enabled = true;  // Ensure lights are on
             s_ctx.lights_enabled = true;
             
@@ -369,8 +585,7 @@ esp_err_t gemini_execute_function_call(const char *function_name, const char *ar
         cJSON *muted = cJSON_GetObjectItem(args, "muted");
         if (cJSON_IsBool(muted)) {
             bool mute_val = cJSON_IsTrue(muted);
-            s_muted = mute_val;
-            s_ctx.muted = mute_val;
+            device_state_set_muted(mute_val);
             ESP_LOGI(TAG, "🔧 [Gemini Tools] set_audio_mute: %s", mute_val ? "muted" : "unmuted");
             snprintf(response_text, response_len, "{\"success\": true, \"message\": \"Audio %s\"}", mute_val ? "muted" : "unmuted");
         } else {
@@ -4,6 +4,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "esp_err.h"
+#include "sensor_integration.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -13,10 +14,49 @@ extern "C" {
 // led_handle should be cast from led_controller_t*
 void device_state_set_context(void *led_handle, bool lights_enabled, bool aws_connected, bool muted, bool audio_playing);
 
-// Generate JSON string of current device state
-// Returns allocated string (caller must free) or NULL on error
+// Copy of the cached device state JSON. The snapshot is rebuilt in the
+// background only when lights, mute, playback, AWS/Wi-Fi/Spotify state or a
+// sensor reading (past its deadband) changes, so this is normally just a copy.
+// Returns allocated string (caller must cJSON_free) or NULL on error
 char *device_state_to_json(void);
 
+// Bumped every time the snapshot is rebuilt; 0 until the first build
+uint32_t device_state_version(void);
+
+// Inputs the snapshot is built from. It is rebuilt only when one of these
+// moves; heap figures and RSSI are carried along as of the last rebuild.
+typedef struct {
+    bool lights_enabled;
+    bool muted;
+    bool audio_playing;
+    bool aws_connected;
+    bool spotify_ready;
+    bool sleep_mode;
+    bool low_memory;
+    bool wifi_connected;
+    int8_t wifi_rssi;
+    char wifi_ssid[33];
+    bool leds_present;
+    uint8_t led_count;
+    uint8_t led_brightness;
+    sensor_integration_data_t sensors;
+} device_state_inputs_t;
+
+// What the current snapshot was built from, and its version; false before the first build
+bool device_state_get_inputs(device_state_inputs_t *out, uint32_t *version);
+
+// Writers shared by the Gemini tools and the device shadow
+esp_err_t device_state_set_lights(bool enabled);
+void device_state_set_muted(bool muted);
+
+// Sleep mode: the user is in bed. Listeners run on the caller's task, once
+// per change, and start or stop what only runs at night.
+typedef void (*device_state_sleep_cb_t)(bool sleeping, void *ctx);
+
+esp_err_t device_state_add_sleep_listener(device_state_sleep_cb_t cb, void *ctx);
+void device_state_set_sleep_mode(bool sleeping);
+bool device_state_sleep_mode(void);
+
 // Parse and execute Gemini function call
 // Returns response text to send back to Gemini
 esp_err_t gemini_execute_function_call(const char *function_name, const char *arguments_json, char *response_text, size_t response_len);
@@ -0,0 +1,279 @@
+#include "dns_cache.h"
+
+#include <stdbool.h>
+#include <string.h>
+
+#include "esp_check.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "lwip/api.h"
+#include "lwip/ip_addr.h"
+#include "lwip/netdb.h"
+#include "task_placement.h"
+
+static const char *TAG = "dns_cache";
+
+#define DNS_CACHE_HOST_MAX 64
+#define DNS_CACHE_TTL_US ((int64_t)CONFIG_KVA_DNS_CACHE_TTL_S * 1000 * 1000)
+// A failed lookup is tried again after this, until the address expires
+#define DNS_CACHE_RETRY_US (30LL * 1000 * 1000)
+#define DNS_CACHE_NEVER INT64_MAX
+
+typedef struct {
+    char host[DNS_CACHE_HOST_MAX];    // Empty for a free slot
+    ip_addr_t addr;
+    int64_t expires_us;               // 0 until resolved
+    int64_t refresh_us;               // When the task resolves it next
+    bool pinned;                      // A known endpoint: never dropped
+    bool used;                        // Asked for since it was last resolved
+} entry_t;
+
+static const char *const KNOWN_HOSTS[] = {
+    "api.openai.com",
+    "generativelanguage.googleapis.com",
+    "speech.googleapis.com",
+    "texttospeech.googleapis.com",
+    "apresolve.spotify.com",
+#ifdef CONFIG_NAPHOME_AWS_IOT_ENDPOINT
+    CONFIG_NAPHOME_AWS_IOT_ENDPOINT,
+#endif
+};
+
+static entry_t s_entries[CONFIG_KVA_DNS_CACHE_ENTRIES];
+static SemaphoreHandle_t s_lock;
+static TaskHandle_t s_task;
+static dns_cache_stats_t s_stats;
+
+static entry_t *find_locked(const char *host)
+{
+    for (int i = 0; i < CONFIG_KVA_DNS_CACHE_ENTRIES; ++i) {
+        if (s_entries[i].host[0] && strcmp(s_entries[i].host, host) == 0) {
+            return &s_entries[i];
+        }
+    }
+    return NULL;
+}
+
+// A free slot, else the unpinned entry closest to expiring; NULL when all are pinned
+static entry_t *claim_locked(const char *host, bool pinned)
+{
+    entry_t *victim = NULL;
+    for (int i = 0; i < CONFIG_KVA_DNS_CACHE_ENTRIES; ++i) {
+        entry_t *e = &s_entries[i];
+        if (!e->host[0]) {
+            victim = e;
+            break;
+        }
+        if (!e->pinned && (!victim || e->expires_us < victim->expires_us)) {
+            victim = e;
+        }
+    }
+    if (victim) {
+        memset(victim, 0, sizeof(*victim));
+        strlcpy(victim->host, host, sizeof(victim->host));
+        victim->pinned = pinned;
+    }
+    return victim;
+}
+
+/**
+ * Copy out the first entry due for a lookup and push its refresh back by
+ * the retry interval, so a failure does not spin. Unpinned entries nobody
+ * asked for are dropped once expired. Otherwise *next_us is when the task
+ * has work again.
+ */
+static bool take_due(int64_t now, char *host, int64_t *next_us)
+{
+    bool found = false;
+    *next_us = DNS_CACHE_NEVER;
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    for (int i = 0; i < CONFIG_KVA_DNS_CACHE_ENTRIES; ++i) {
+        entry_t *e = &s_entries[i];
+        if (!e->host[0]) {
+            continue;
+        }
+        if (!e->pinned && !e->used) {
+            if (e->expires_us <= now) {
+                e->host[0] = '\0';
+            }
+            continue;
+        }
+        if (!found && e->refresh_us <= now) {
+            strlcpy(host, e->host, DNS_CACHE_HOST_MAX);
+            e->refresh_us = now + DNS_CACHE_RETRY_US;
+            found = true;
+        }
+        if (e->refresh_us < *next_us) {
+            *next_us = e->refresh_us;
+        }
+    }
+    xSemaphoreGive(s_lock);
+    return found;
+}
+
+static void resolve(const char *host)
+{
+    // IPv4 only, as the rest of the firmware; IPv6 lookups are left to lwIP
+    const struct addrinfo hints = {
+        .ai_family = AF_INET,
+        .ai_socktype = SOCK_STREAM,
+    };
+    struct addrinfo *res = NULL;
+    int rc = getaddrinfo(host, NULL, &hints, &res);
+    int64_t now = esp_timer_get_time();
+
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    entry_t *e = find_locked(host);
+    if (rc == 0 && res) {
+        s_stats.refreshes++;
+        if (e) {
+            const struct sockaddr_in *sin = (const struct sockaddr_in *)res->ai_addr;
+            ip4_addr_set_u32(ip_2_ip4(&e->addr), sin->sin_addr.s_addr);
+            IP_SET_TYPE(&e->addr, IPADDR_TYPE_V4);
+            e->expires_us = now + DNS_CACHE_TTL_US;
+            e->refresh_us = now + DNS_CACHE_TTL_US / 4 * 3;
+            e->used = false;
+        }
+    } else {
+        s_stats.failures++;
+    }
+    xSemaphoreGive(s_lock);
+
+    if (rc != 0 || !res) {
+        ESP_LOGW(TAG, "%s: lookup failed (%d)", host, rc);
+    } else {
+        ESP_LOGD(TAG, "%s: resolved", host);
+    }
+    if (res) {
+        freeaddrinfo(res);
+    }
+}
+
+static void dns_cache_task(void *arg)
+{
+    (void)arg;
+    char host[DNS_CACHE_HOST_MAX];
+    while (true) {
+        int64_t next_us;
+        // One lookup at a time, with the lock released over the network
+        while (take_due(esp_timer_get_time(), host, &next_us)) {
+            resolve(host);
+        }
+        TickType_t wait = portMAX_DELAY;
+        if (next_us != DNS_CACHE_NEVER) {
+            int64_t delay_us = next_us - esp_timer_get_time();
+            wait = delay_us > 0 ? pdMS_TO_TICKS(delay_us / 1000) + 1 : 0;
+        }
+        ulTaskNotifyTake(pdTRUE, wait);
+    }
+}
+
+/*
+ * lwIP asks here before its own resolver, from the task calling
+ * getaddrinfo(). Returns 1 with *addr set when the cache answers, 0 to let
+ * lwIP resolve; the refresh task's own lookups always go to lwIP.
+ */
+int lwip_hook_netconn_external_resolve(const char *name, ip_addr_t *addr, u8_t addrtype, err_t *err)
+{
+    if (!s_lock || !s_task || xTaskGetCurrentTaskHandle() == s_task) {
+        return 0;
+    }
+#if LWIP_IPV4 && LWIP_IPV6
+    if (addrtype == NETCONN_DNS_IPV6) {
+        return 0;
+    }
+#else
+    (void)addrtype;
+#endif
+    ip4_addr_t literal;
+    if (ip4addr_aton(name, &literal) || strlen(name) >= DNS_CACHE_HOST_MAX) {
+        return 0;
+    }
+
+    bool hit = false;
+    bool wake = false;
+    int64_t now = esp_timer_get_time();
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    entry_t *e = find_locked(name);
+    if (e && e->expires_us > now) {
+        *addr = e->addr;
+        e->used = true;
+        s_stats.hits++;
+        hit = true;
+    } else {
+        // lwIP resolves this one; the task fetches it for the next request
+        s_stats.misses++;
+        if (!e) {
+            e = claim_locked(name, false);
+        }
+        if (e) {
+            e->used = true;
+            if (e->refresh_us > now) {
+                e->refresh_us = now;
+                wake = true;
+            }
+        }
+    }
+    xSemaphoreGive(s_lock);
+
+    if (wake) {
+        xTaskNotifyGive(s_task);
+    }
+    if (hit) {
+        *err = ERR_OK;
+    }
+    return hit ? 1 : 0;
+}
+
+esp_err_t dns_cache_init(void)
+{
+    if (s_lock) {
+        return ESP_OK;
+    }
+    s_lock = xSemaphoreCreateMutex();
+    ESP_RETURN_ON_FALSE(s_lock, ESP_ERR_NO_MEM, TAG, "lock");
+    for (size_t i = 0; i < sizeof(KNOWN_HOSTS) / sizeof(KNOWN_HOSTS[0]); ++i) {
+        if (KNOWN_HOSTS[i][0]) {
+            entry_t *e = claim_locked(KNOWN_HOSTS[i], true);
+            if (e) {
+                e->refresh_us = DNS_CACHE_NEVER;  // Until dns_cache_prefetch() on the first connect
+            }
+        }
+    }
+    if (task_placement_create(TASK_PLACEMENT_DNS_CACHE, dns_cache_task, NULL, &s_task) != pdPASS) {
+        vSemaphoreDelete(s_lock);
+        s_lock = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+void dns_cache_prefetch(void)
+{
+    if (!s_lock || !s_task) {
+        return;
+    }
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    for (int i = 0; i < CONFIG_KVA_DNS_CACHE_ENTRIES; ++i) {
+        s_entries[i].refresh_us = 0;
+    }
+    xSemaphoreGive(s_lock);
+    xTaskNotifyGive(s_task);
+}
+
+void dns_cache_get_stats(dns_cache_stats_t *out)
+{
+    if (!out) {
+        return;
+    }
+    if (!s_lock) {
+        memset(out, 0, sizeof(*out));
+        return;
+    }
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    *out = s_stats;
+    xSemaphoreGive(s_lock);
+}
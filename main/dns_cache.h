@@ -0,0 +1,47 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "kva_config_defaults.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Resolved addresses for the cloud hosts, kept warm so a cold request on the
+ * interaction path does not wait for a DNS round trip.
+ *
+ * The cache answers lwIP's external resolve hook
+ * (CONFIG_LWIP_HOOK_NETCONN_EXT_RESOLVE_CUSTOM), which every getaddrinfo()
+ * goes through, so the HTTPS pool, the WebSocket clients and MQTT use it
+ * without changes and still connect by name for SNI and certificate checks.
+ * A name it does not hold, or holds expired, is resolved by lwIP as before
+ * and picked up in the background for next time.
+ *
+ * The known endpoints (OpenAI, the Google APIs, the AWS IoT endpoint,
+ * Spotify's access point resolver) are resolved at boot and again on every
+ * Wi-Fi connect. lwIP does not pass the record's TTL up, so addresses are
+ * trusted for CONFIG_KVA_DNS_CACHE_TTL_S and resolved again at three
+ * quarters of it while the host is still in use; a host nobody asked for
+ * over a whole TTL is dropped unless it is one of the known endpoints.
+ */
+typedef struct {
+    uint32_t hits;
+    uint32_t misses;                  // Left to lwIP: unknown, expired or an IPv6 lookup
+    uint32_t refreshes;
+    uint32_t failures;                // Background lookups that failed
+} dns_cache_stats_t;
+
+// Start the refresh task; call before Wi-Fi comes up
+esp_err_t dns_cache_init(void);
+
+// Resolve every entry again now, e.g. on a new IP lease; safe from an event handler
+void dns_cache_prefetch(void);
+
+void dns_cache_get_stats(dns_cache_stats_t *out);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,166 @@
+#include "event_bus.h"
+
+#include <string.h>
+
+#include "esp_check.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+static const char *TAG = "event_bus";
+
+/*
+ * Each subscriber queue is a bounded multi-producer, single-consumer ring
+ * (Vyukov): every slot carries a sequence number. A producer claims the
+ * tail with a CAS when the slot's sequence equals the tail, fills the slot
+ * and publishes it by storing tail + 1; the consumer takes a slot whose
+ * sequence is head + 1 and hands it back by storing head + depth. A
+ * producer interrupted between the claim and the store only delays the
+ * consumer, it never corrupts the ring.
+ */
+typedef struct {
+    uint32_t seq;
+    event_bus_event_t event;
+} slot_t;
+
+typedef struct {
+    uint32_t topics;
+    event_bus_handler_t handler;
+    void *ctx;
+    TaskHandle_t task;
+    slot_t *slots;
+    uint32_t mask;
+    uint32_t tail;                    // Next slot to claim; producers only
+    uint32_t head;                    // Next slot to take; the subscriber task only
+} subscriber_t;
+
+static subscriber_t s_subs[CONFIG_KVA_EVENT_BUS_MAX_SUBSCRIBERS];
+static uint32_t s_sub_count;          // Slots below this are complete; release/acquire
+static event_bus_stats_t s_stats;
+
+static bool enqueue(subscriber_t *sub, const event_bus_event_t *event)
+{
+    uint32_t pos = __atomic_load_n(&sub->tail, __ATOMIC_RELAXED);
+    slot_t *slot;
+    while (true) {
+        slot = &sub->slots[pos & sub->mask];
+        int32_t diff = (int32_t)(__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) - pos);
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&sub->tail, &pos, pos + 1, true, __ATOMIC_RELAXED,
+                                            __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false;             // Full: the consumer has not handed this slot back yet
+        } else {
+            pos = __atomic_load_n(&sub->tail, __ATOMIC_RELAXED);
+        }
+    }
+    slot->event = *event;
+    __atomic_store_n(&slot->seq, pos + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+static bool dequeue(subscriber_t *sub, event_bus_event_t *out)
+{
+    slot_t *slot = &sub->slots[sub->head & sub->mask];
+    if ((int32_t)(__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) - (sub->head + 1)) < 0) {
+        return false;
+    }
+    *out = slot->event;
+    __atomic_store_n(&slot->seq, sub->head + sub->mask + 1, __ATOMIC_RELEASE);
+    sub->head++;
+    return true;
+}
+
+static void subscriber_task(void *arg)
+{
+    subscriber_t *sub = (subscriber_t *)arg;
+    event_bus_event_t event;
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        while (dequeue(sub, &event)) {
+            sub->handler(&event, sub->ctx);
+        }
+    }
+}
+
+esp_err_t event_bus_subscribe(const event_bus_subscriber_config_t *config)
+{
+    ESP_RETURN_ON_FALSE(config && config->handler && config->topics, ESP_ERR_INVALID_ARG, TAG, "config");
+    uint32_t depth = config->queue_depth ? config->queue_depth : CONFIG_KVA_EVENT_BUS_QUEUE_DEPTH;
+    ESP_RETURN_ON_FALSE((depth & (depth - 1)) == 0, ESP_ERR_INVALID_ARG, TAG, "depth %lu not a power of two",
+                        (unsigned long)depth);
+
+    // Subscribers register from init code; only the count is shared with publishers
+    uint32_t index = __atomic_load_n(&s_sub_count, __ATOMIC_RELAXED);
+    ESP_RETURN_ON_FALSE(index < CONFIG_KVA_EVENT_BUS_MAX_SUBSCRIBERS, ESP_ERR_NO_MEM, TAG, "no subscriber slot");
+    subscriber_t *sub = &s_subs[index];
+    // Internal RAM: publishers may run in an ISR with the cache disabled
+    sub->slots = heap_caps_calloc(depth, sizeof(slot_t), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    ESP_RETURN_ON_FALSE(sub->slots, ESP_ERR_NO_MEM, TAG, "queue");
+    for (uint32_t i = 0; i < depth; ++i) {
+        sub->slots[i].seq = i;
+    }
+    sub->mask = depth - 1;
+    sub->topics = config->topics;
+    sub->handler = config->handler;
+    sub->ctx = config->ctx;
+    if (task_placement_create(config->task, subscriber_task, sub, &sub->task) != pdPASS) {
+        heap_caps_free(sub->slots);
+        memset(sub, 0, sizeof(*sub));
+        return ESP_ERR_NO_MEM;
+    }
+    __atomic_store_n(&s_sub_count, index + 1, __ATOMIC_RELEASE);
+    return ESP_OK;
+}
+
+bool event_bus_publish(const event_bus_event_t *event)
+{
+    uint32_t bit = EVENT_BUS_TOPIC_BIT(event->topic);
+    uint32_t count = __atomic_load_n(&s_sub_count, __ATOMIC_ACQUIRE);
+    bool in_isr = xPortInIsrContext();
+    BaseType_t woken = pdFALSE;
+    bool delivered = true;
+
+    __atomic_fetch_add(&s_stats.published, 1, __ATOMIC_RELAXED);
+    for (uint32_t i = 0; i < count; ++i) {
+        subscriber_t *sub = &s_subs[i];
+        if (!(sub->topics & bit)) {
+            continue;
+        }
+        if (!enqueue(sub, event)) {
+            __atomic_fetch_add(&s_stats.dropped, 1, __ATOMIC_RELAXED);
+            delivered = false;
+            continue;
+        }
+        if (in_isr) {
+            vTaskNotifyGiveFromISR(sub->task, &woken);
+        } else {
+            xTaskNotifyGive(sub->task);
+        }
+    }
+    if (woken) {
+        portYIELD_FROM_ISR();
+    }
+    return delivered;
+}
+
+bool event_bus_publish_state(event_bus_topic_t topic, bool on)
+{
+    const event_bus_event_t event = {
+        .topic = topic,
+        .on = on,
+    };
+    return event_bus_publish(&event);
+}
+
+void event_bus_get_stats(event_bus_stats_t *out)
+{
+    if (!out) {
+        return;
+    }
+    out->published = __atomic_load_n(&s_stats.published, __ATOMIC_RELAXED);
+    out->dropped = __atomic_load_n(&s_stats.dropped, __ATOMIC_RELAXED);
+}
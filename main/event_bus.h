@@ -0,0 +1,90 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "kva_config_defaults.h"
+#include "task_placement.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Typed publish/subscribe between subsystems that should not call into each
+ * other, above all the audio loops and the LED and network code.
+ *
+ * Topics are compile-time integers. Each subscriber names the topics it
+ * wants as a bit mask and gets its own bounded queue and a task that calls
+ * its handler; a publish copies the event into every interested queue with
+ * a compare-and-swap on the queue tail and notifies the task, so it never
+ * blocks, never takes a lock and is safe from an ISR. When a queue is full
+ * the event is dropped for that subscriber and counted.
+ *
+ * Subscribe at init, before the publishers start; there is no unsubscribe.
+ */
+typedef enum {
+    EVENT_BUS_TOPIC_MIC_LEVELS = 0,   // mic_levels: capture and AFE RMS, on every audio frame
+    EVENT_BUS_TOPIC_DIRECTION,        // direction: talker bearing from the DOA estimator
+    EVENT_BUS_TOPIC_SPECTRUM,         // spectrum: new mel rows in the band analyzer
+    EVENT_BUS_TOPIC_PLAYBACK,         // on: an assistant reply starts or stops playing
+    EVENT_BUS_TOPIC_LIGHTS,           // on: ambient lights requested on or off
+    EVENT_BUS_TOPIC_CLOUD,            // on: AWS IoT connected or lost
+    EVENT_BUS_TOPIC_COUNT,
+} event_bus_topic_t;
+
+#define EVENT_BUS_TOPIC_BIT(topic) (1U << (topic))
+
+typedef struct {
+    event_bus_topic_t topic;
+    union {
+        struct {
+            float mic[3];             // Left, right, the talker (audio_meter_voice_rms)
+        } mic_levels;
+        struct {
+            float angle_deg;          // -90 (capture channel 0) to +90
+            float confidence;
+            bool active;
+        } direction;
+        struct {
+            void *analyzer;           // audio_spectrum_t; read it, the rows stay with the producer
+        } spectrum;
+        bool on;
+    };
+} event_bus_event_t;
+
+// Runs on the subscriber's task, one event at a time in publish order
+typedef void (*event_bus_handler_t)(const event_bus_event_t *event, void *ctx);
+
+typedef struct {
+    uint32_t topics;                  // EVENT_BUS_TOPIC_BIT() of each topic wanted
+    event_bus_handler_t handler;
+    void *ctx;
+    task_placement_id_t task;         // Name, stack, priority and core of the handler task
+    uint16_t queue_depth;             // Power of two; 0 = CONFIG_KVA_EVENT_BUS_QUEUE_DEPTH
+} event_bus_subscriber_config_t;
+
+typedef struct {
+    uint32_t published;
+    uint32_t dropped;                 // Delivery skipped on a full subscriber queue
+} event_bus_stats_t;
+
+/**
+ * @return ESP_ERR_NO_MEM when all CONFIG_KVA_EVENT_BUS_MAX_SUBSCRIBERS
+ *         slots are taken or the queue or task cannot be created
+ */
+esp_err_t event_bus_subscribe(const event_bus_subscriber_config_t *config);
+
+// Any task or ISR. Returns false if some subscriber's queue was full
+bool event_bus_publish(const event_bus_event_t *event);
+
+// Shorthand for the topics that carry only "on"
+bool event_bus_publish_state(event_bus_topic_t topic, bool on);
+
+void event_bus_get_stats(event_bus_stats_t *out);
+
+#ifdef __cplusplus
+}
+#endif
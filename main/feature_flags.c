@@ -0,0 +1,241 @@
+#include "feature_flags.h"
+
+#include <math.h>
+#include <string.h>
+
+#include "esp_check.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "nvs.h"
+
+static const char *TAG = "feature_flags";
+
+#define FEATURE_FLAGS_NVS_NAMESPACE "flags"
+
+typedef struct {
+    const char *name;                 // At most 15 characters: it is also the NVS key
+    feature_flag_type_t type;
+    double def;
+    double min;
+    double max;
+} feature_flag_def_t;
+
+static const feature_flag_def_t s_defs[FEATURE_FLAG_COUNT] = {
+    [FEATURE_FLAG_PIPELINED_TTS] = {"pipelined_tts", FEATURE_FLAG_TYPE_BOOL, CONFIG_KVA_PIPELINED_TTS, 0, 1},
+    [FEATURE_FLAG_UPLINK_CODEC] = {"uplink_codec", FEATURE_FLAG_TYPE_BOOL, 1, 0, 1},
+    [FEATURE_FLAG_AFE_PROFILES] = {"afe_profiles", FEATURE_FLAG_TYPE_BOOL, CONFIG_KVA_AFE_PROFILES, 0, 1},
+    [FEATURE_FLAG_AFE_QUIET_MS] = {"afe_quiet_ms", FEATURE_FLAG_TYPE_INT, CONFIG_KVA_AFE_LOW_COST_QUIET_MS, 1000,
+                                   3600000},
+    [FEATURE_FLAG_AFE_WARMUP_MS] = {"afe_warmup_ms", FEATURE_FLAG_TYPE_INT, CONFIG_KVA_AFE_SWAP_WARMUP_MS, 0, 1000},
+    [FEATURE_FLAG_EMPTY_SENSOR_MS] = {"empty_sensor_ms", FEATURE_FLAG_TYPE_INT, CONFIG_KVA_OCCUPANCY_EMPTY_SENSOR_MS,
+                                      1000, 600000},
+    [FEATURE_FLAG_ASLEEP_SENSOR_MS] = {"sleep_sensor_ms", FEATURE_FLAG_TYPE_INT, CONFIG_KVA_OCCUPANCY_ASLEEP_SENSOR_MS,
+                                       1000, 600000},
+    [FEATURE_FLAG_IDLE_LED_MS] = {"idle_led_ms", FEATURE_FLAG_TYPE_INT, CONFIG_KVA_OCCUPANCY_IDLE_LED_FRAME_MS, 0,
+                                  1000},
+    [FEATURE_FLAG_DEADBAND_SCALE] = {"deadband_scale", FEATURE_FLAG_TYPE_FLOAT, 1.0, 0.25, 20.0},
+};
+
+typedef struct {
+    feature_flag_t flag;
+    feature_flag_cb_t cb;
+    void *ctx;
+} feature_flag_sub_t;
+
+static struct {
+    SemaphoreHandle_t lock;           // Setters and subscribe; lookups never take it
+    int32_t values[FEATURE_FLAG_COUNT];  // Bools and ints as they are, floats by their bits
+    bool ready;
+    feature_flag_sub_t subs[CONFIG_KVA_FEATURE_FLAGS_MAX_SUBSCRIBERS];
+    size_t sub_count;
+} s_flags;
+
+static int32_t encode(feature_flag_t flag, double value)
+{
+    switch (s_defs[flag].type) {
+    case FEATURE_FLAG_TYPE_BOOL:
+        return value != 0;
+    case FEATURE_FLAG_TYPE_INT:
+        return (int32_t)lround(value);
+    case FEATURE_FLAG_TYPE_FLOAT:
+    default: {
+        float f = (float)value;
+        int32_t bits;
+        memcpy(&bits, &f, sizeof(bits));
+        return bits;
+    }
+    }
+}
+
+static double clamp(feature_flag_t flag, double value)
+{
+    const feature_flag_def_t *def = &s_defs[flag];
+    return value < def->min ? def->min : (value > def->max ? def->max : value);
+}
+
+static int32_t load(feature_flag_t flag)
+{
+    if (!__atomic_load_n(&s_flags.ready, __ATOMIC_ACQUIRE)) {
+        return encode(flag, s_defs[flag].def);
+    }
+    return __atomic_load_n(&s_flags.values[flag], __ATOMIC_RELAXED);
+}
+
+esp_err_t feature_flags_init(void)
+{
+    if (s_flags.ready) {
+        return ESP_OK;
+    }
+    s_flags.lock = xSemaphoreCreateMutex();
+    ESP_RETURN_ON_FALSE(s_flags.lock, ESP_ERR_NO_MEM, TAG, "lock");
+    for (int f = 0; f < FEATURE_FLAG_COUNT; ++f) {
+        s_flags.values[f] = encode((feature_flag_t)f, s_defs[f].def);
+    }
+
+    nvs_handle_t nvs;
+    if (nvs_open(FEATURE_FLAGS_NVS_NAMESPACE, NVS_READONLY, &nvs) == ESP_OK) {
+        for (int f = 0; f < FEATURE_FLAG_COUNT; ++f) {
+            int32_t stored;
+            if (nvs_get_i32(nvs, s_defs[f].name, &stored) != ESP_OK) {
+                continue;
+            }
+            // Stored before a range was narrowed, or by another build: clamp again
+            double value = stored;
+            if (s_defs[f].type == FEATURE_FLAG_TYPE_FLOAT) {
+                float fv;
+                memcpy(&fv, &stored, sizeof(fv));
+                value = isfinite(fv) ? fv : s_defs[f].def;
+            }
+            value = clamp((feature_flag_t)f, value);
+            s_flags.values[f] = encode((feature_flag_t)f, value);
+            ESP_LOGI(TAG, "%s overridden: %g", s_defs[f].name, value);
+        }
+        nvs_close(nvs);
+    }
+    __atomic_store_n(&s_flags.ready, true, __ATOMIC_RELEASE);
+    return ESP_OK;
+}
+
+bool feature_flag_bool(feature_flag_t flag)
+{
+    return load(flag) != 0;
+}
+
+int32_t feature_flag_int(feature_flag_t flag)
+{
+    return load(flag);
+}
+
+float feature_flag_float(feature_flag_t flag)
+{
+    int32_t bits = load(flag);
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+double feature_flag_value(feature_flag_t flag)
+{
+    return s_defs[flag].type == FEATURE_FLAG_TYPE_FLOAT ? (double)feature_flag_float(flag) : load(flag);
+}
+
+const char *feature_flag_name(feature_flag_t flag)
+{
+    return s_defs[flag].name;
+}
+
+feature_flag_type_t feature_flag_type(feature_flag_t flag)
+{
+    return s_defs[flag].type;
+}
+
+int feature_flag_find(const char *name, size_t len)
+{
+    for (int f = 0; f < FEATURE_FLAG_COUNT; ++f) {
+        if (strlen(s_defs[f].name) == len && memcmp(s_defs[f].name, name, len) == 0) {
+            return f;
+        }
+    }
+    return -1;
+}
+
+// Under the lock: a missing key is the default
+static esp_err_t store(feature_flag_t flag, int32_t value, bool is_default)
+{
+    nvs_handle_t nvs;
+    esp_err_t err = nvs_open(FEATURE_FLAGS_NVS_NAMESPACE, NVS_READWRITE, &nvs);
+    if (err != ESP_OK) {
+        return err;
+    }
+    if (is_default) {
+        err = nvs_erase_key(nvs, s_defs[flag].name);
+        err = err == ESP_ERR_NVS_NOT_FOUND ? ESP_OK : err;
+    } else {
+        err = nvs_set_i32(nvs, s_defs[flag].name, value);
+    }
+    if (err == ESP_OK) {
+        err = nvs_commit(nvs);
+    }
+    nvs_close(nvs);
+    return err;
+}
+
+static esp_err_t apply(feature_flag_t flag, int32_t value, bool is_default)
+{
+    ESP_RETURN_ON_FALSE(flag >= 0 && flag < FEATURE_FLAG_COUNT, ESP_ERR_INVALID_ARG, TAG, "flag");
+    ESP_RETURN_ON_FALSE(s_flags.ready, ESP_ERR_INVALID_STATE, TAG, "not initialized");
+
+    xSemaphoreTake(s_flags.lock, portMAX_DELAY);
+    bool changed = s_flags.values[flag] != value;
+    __atomic_store_n(&s_flags.values[flag], value, __ATOMIC_RELAXED);
+    // Stored even when unchanged, so a reset always clears the key
+    esp_err_t err = store(flag, value, is_default);
+    feature_flag_sub_t subs[CONFIG_KVA_FEATURE_FLAGS_MAX_SUBSCRIBERS];
+    size_t count = 0;
+    for (size_t i = 0; changed && i < s_flags.sub_count; ++i) {
+        if (s_flags.subs[i].flag == flag) {
+            subs[count++] = s_flags.subs[i];
+        }
+    }
+    xSemaphoreGive(s_flags.lock);
+
+    if (err != ESP_OK) {
+        // Still in effect until the next boot
+        ESP_LOGW(TAG, "%s not stored: %s", s_defs[flag].name, esp_err_to_name(err));
+    }
+    if (changed) {
+        ESP_LOGI(TAG, "%s = %g%s", s_defs[flag].name, feature_flag_value(flag), is_default ? " (default)" : "");
+    }
+    for (size_t i = 0; i < count; ++i) {
+        subs[i].cb(flag, subs[i].ctx);
+    }
+    return ESP_OK;
+}
+
+esp_err_t feature_flags_set(feature_flag_t flag, double value)
+{
+    ESP_RETURN_ON_FALSE(flag >= 0 && flag < FEATURE_FLAG_COUNT && isfinite(value), ESP_ERR_INVALID_ARG, TAG, "flag");
+    int32_t encoded = encode(flag, clamp(flag, value));
+    return apply(flag, encoded, encoded == encode(flag, s_defs[flag].def));
+}
+
+esp_err_t feature_flags_reset(feature_flag_t flag)
+{
+    ESP_RETURN_ON_FALSE(flag >= 0 && flag < FEATURE_FLAG_COUNT, ESP_ERR_INVALID_ARG, TAG, "flag");
+    return apply(flag, encode(flag, s_defs[flag].def), true);
+}
+
+esp_err_t feature_flags_subscribe(feature_flag_t flag, feature_flag_cb_t cb, void *ctx)
+{
+    ESP_RETURN_ON_FALSE(flag >= 0 && flag < FEATURE_FLAG_COUNT && cb, ESP_ERR_INVALID_ARG, TAG, "subscriber");
+    ESP_RETURN_ON_FALSE(s_flags.ready, ESP_ERR_INVALID_STATE, TAG, "not initialized");
+    xSemaphoreTake(s_flags.lock, portMAX_DELAY);
+    esp_err_t err = ESP_ERR_NO_MEM;
+    if (s_flags.sub_count < CONFIG_KVA_FEATURE_FLAGS_MAX_SUBSCRIBERS) {
+        s_flags.subs[s_flags.sub_count++] = (feature_flag_sub_t){flag, cb, ctx};
+        err = ESP_OK;
+    }
+    xSemaphoreGive(s_flags.lock);
+    return err;
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "kva_config_defaults.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Performance settings the fleet can change without an OTA: which AFE
+ * profile an idle room gets, whether the uplink is compressed and TTS is
+ * pipelined, how often sensors are sampled, how far a value must move
+ * before the shadow hears of it.
+ *
+ * Each flag starts at its build-time default (the CONFIG_KVA_ option it
+ * stands for) and may carry an override, which arrives in the desired
+ * "flags" object of the device shadow (device_shadow.h), is clamped to the
+ * flag's range and kept in NVS. The effective values live in a RAM table
+ * indexed by feature_flag_t, so a lookup from a hot path is one atomic load
+ * and never touches NVS.
+ *
+ * A flag turns a feature off or on within what the build has; it cannot
+ * bring in code the build left out.
+ */
+typedef enum {
+    FEATURE_FLAG_PIPELINED_TTS = 0,   // bool: synthesize sentence N+1 while N plays
+    FEATURE_FLAG_UPLINK_CODEC,        // bool: speech goes up in the configured codec; false sends PCM16
+    FEATURE_FLAG_AFE_PROFILES,        // bool: idle rooms may get the low-cost AFE
+    FEATURE_FLAG_AFE_QUIET_MS,        // int: speech-free time before the low-cost AFE
+    FEATURE_FLAG_AFE_WARMUP_MS,       // int: audio the incoming AFE hears before a swap
+    FEATURE_FLAG_EMPTY_SENSOR_MS,     // int: sensor publish interval in an empty room
+    FEATURE_FLAG_ASLEEP_SENSOR_MS,    // int: ... and in a sleeping one
+    FEATURE_FLAG_IDLE_LED_MS,         // int: LED frame period while the room is idle
+    FEATURE_FLAG_DEADBAND_SCALE,      // float: multiplies the device shadow's report deadbands
+    FEATURE_FLAG_COUNT,
+} feature_flag_t;
+
+typedef enum {
+    FEATURE_FLAG_TYPE_BOOL,
+    FEATURE_FLAG_TYPE_INT,
+    FEATURE_FLAG_TYPE_FLOAT,
+} feature_flag_type_t;
+
+// Runs on the task that changed the flag (the shadow's MQTT task); keep it short
+typedef void (*feature_flag_cb_t)(feature_flag_t flag, void *ctx);
+
+// Loads the overrides from NVS; after nvs_flash_init(). Before it, lookups give the defaults
+esp_err_t feature_flags_init(void);
+
+bool feature_flag_bool(feature_flag_t flag);
+int32_t feature_flag_int(feature_flag_t flag);
+float feature_flag_float(feature_flag_t flag);
+
+// The value as a number whatever the type, for reporting
+double feature_flag_value(feature_flag_t flag);
+
+// Name used in the shadow and as the NVS key
+const char *feature_flag_name(feature_flag_t flag);
+
+feature_flag_type_t feature_flag_type(feature_flag_t flag);
+
+// Flag with this name (not terminated, len bytes), or -1
+int feature_flag_find(const char *name, size_t len);
+
+/**
+ * @brief Override a flag, clamped to its range, and store it.
+ *
+ * Setting the default removes the override. Subscribers are called when
+ * the effective value changes.
+ */
+esp_err_t feature_flags_set(feature_flag_t flag, double value);
+
+// Back to the build-time default, with the stored override erased
+esp_err_t feature_flags_reset(feature_flag_t flag);
+
+/**
+ * @return ESP_ERR_NO_MEM when all CONFIG_KVA_FEATURE_FLAGS_MAX_SUBSCRIBERS
+ *         slots are taken
+ */
+esp_err_t feature_flags_subscribe(feature_flag_t flag, feature_flag_cb_t cb, void *ctx);
+
+#ifdef __cplusplus
+}
+#endif
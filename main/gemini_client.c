@@ -7,14 +7,31 @@
 #include <string.h>
 
 #include "cJSON.h"
+#include "conversation_memory.h"
 #include "esp_check.h"
 #include "esp_crt_bundle.h"
-#include "esp_http_client.h"
+#include "esp_heap_caps.h"
 #include "esp_log.h"
 #include "esp_timer.h"
 #include "mbedtls/base64.h"
+#include "esp_websocket_client.h"
 #include "esp_wifi.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
+#include "h2_transport.h"
+#include "https_pool.h"
+#include "interaction_arena.h"
+#include "interaction_trace.h"
+#include "json_writer.h"
+#include "kva_config_defaults.h"
+#include "mem_tags.h"
 #include "spotify_player.h"
+#include "sse_text_parser.h"
+#include "task_placement.h"
+#include "tool_dispatch.h"
+#include "uplink_link.h"
+#include "wav_upload.h"
 
 #ifdef GEMINI_ENABLED
 #include "gemini_secrets.h"
@@ -24,10 +41,23 @@
 
 static const char *TAG = "gemini_client";
 
-// Google API endpoints
-static const char *SPEECH_TO_TEXT_URL = "https://speech.googleapis.com/v1/speech:recognize";
-static const char *GEMINI_API_URL = "https://generativelanguage.googleapis.com/v1beta/models/gemini-1.5-flash:generateContent";
-static const char *TEXT_TO_SPEECH_URL = "https://texttospeech.googleapis.com/v1/text:synthesize";
+// Google API endpoints; a benchmark build sends all of them to the mock server
+#if CONFIG_KVA_BENCH_MODE
+#define SPEECH_ORIGIN "http://" CONFIG_KVA_BENCH_CLOUD_HOST
+#define GEMINI_ORIGIN "http://" CONFIG_KVA_BENCH_CLOUD_HOST
+#define GEMINI_WS_ORIGIN "ws://" CONFIG_KVA_BENCH_CLOUD_HOST
+#define TTS_ORIGIN "http://" CONFIG_KVA_BENCH_CLOUD_HOST
+#else
+#define SPEECH_ORIGIN "https://speech.googleapis.com"
+#define GEMINI_ORIGIN "https://generativelanguage.googleapis.com"
+#define GEMINI_WS_ORIGIN "wss://generativelanguage.googleapis.com"
+#define TTS_ORIGIN "https://texttospeech.googleapis.com"
+#endif
+
+static const char *SPEECH_TO_TEXT_URL = SPEECH_ORIGIN "/v1/speech:recognize";
+static const char *GEMINI_API_URL = GEMINI_ORIGIN "/v1beta/models/gemini-1.5-flash:generateContent";
+static const char *GEMINI_STREAM_URL = GEMINI_ORIGIN "/v1beta/models/gemini-1.5-flash:streamGenerateContent?alt=sse";
+static const char *TEXT_TO_SPEECH_URL = TTS_ORIGIN "/v1/text:synthesize";
 
 typedef struct {
     uint8_t *data;
@@ -45,7 +75,7 @@ static esp_err_t http_buffer_append(http_buffer_t *buf, const uint8_t *chunk, si
         while (new_cap < buf->len + chunk_len) {
             new_cap *= 2;
         }
-        uint8_t *new_mem = realloc(buf->data, new_cap);
+        uint8_t *new_mem = interaction_arena_realloc(buf->data, new_cap);
         ESP_RETURN_ON_FALSE(new_mem, ESP_ERR_NO_MEM, TAG, "alloc");
         buf->data = new_mem;
         buf->cap = new_cap;
@@ -55,142 +85,112 @@ static esp_err_t http_buffer_append(http_buffer_t *buf, const uint8_t *chunk, si
     return ESP_OK;
 }
 
-static esp_err_t http_event_handler(esp_http_client_event_t *evt)
+// https_pool body sink
+static esp_err_t http_buffer_sink(void *ctx, const uint8_t *data, size_t len)
 {
-    if (!evt || !evt->user_data) {
-        return ESP_FAIL;
-    }
-    http_buffer_t *buf = (http_buffer_t *)evt->user_data;
-    if (evt->event_id == HTTP_EVENT_ON_DATA) {
-        return http_buffer_append(buf, (const uint8_t *)evt->data, evt->data_len);
+    return http_buffer_append((http_buffer_t *)ctx, data, len);
+}
+
+// One multiplexed HTTP/2 connection for all Google hosts when the server
+// allows it, the per-host keep-alive pool otherwise
+static esp_err_t gemini_post(const https_pool_request_t *req, int *status)
+{
+#if CONFIG_KVA_HTTP2_GOOGLEAPIS
+    esp_err_t ret = h2_transport_post(req, status);
+    if (ret != ESP_ERR_NOT_SUPPORTED) {
+        return ret;
     }
-    return ESP_OK;
+#endif
+    return https_pool_post(req, status);
 }
 
-static esp_err_t build_wav_from_pcm(const int16_t *pcm, size_t sample_count, int sample_rate_hz, uint8_t **out_buf, size_t *out_len)
-{
-    ESP_RETURN_ON_FALSE(pcm && out_buf && out_len, ESP_ERR_INVALID_ARG, TAG, "bad args");
-    const uint16_t num_channels = 1;
-    const uint16_t bits_per_sample = 16;
-    size_t data_bytes = sample_count * sizeof(int16_t);
-    size_t total_bytes = 44 + data_bytes;
-    uint8_t *wav = malloc(total_bytes);
-    ESP_RETURN_ON_FALSE(wav, ESP_ERR_NO_MEM, TAG, "wav alloc");
-
-    uint8_t header[44] = {0};
-    memcpy(header, "RIFF", 4);
-    uint32_t chunk_size = total_bytes - 8;
-    memcpy(header + 4, &chunk_size, 4);
-    memcpy(header + 8, "WAVE", 4);
-    memcpy(header + 12, "fmt ", 4);
-    uint32_t subchunk1_size = 16;
-    memcpy(header + 16, &subchunk1_size, 4);
-    uint16_t audio_format = 1;
-    memcpy(header + 20, &audio_format, 2);
-    memcpy(header + 22, &num_channels, 2);
-    uint32_t sample_rate = sample_rate_hz;
-    memcpy(header + 24, &sample_rate, 4);
-    uint32_t byte_rate = sample_rate * num_channels * bits_per_sample / 8;
-    memcpy(header + 28, &byte_rate, 4);
-    uint16_t block_align = num_channels * bits_per_sample / 8;
-    memcpy(header + 32, &block_align, 2);
-    memcpy(header + 34, &bits_per_sample, 2);
-    memcpy(header + 36, "data", 4);
-    uint32_t subchunk2_size = data_bytes;
-    memcpy(header + 40, &subchunk2_size, 4);
-
-    memcpy(wav, header, sizeof(header));
-    memcpy(wav + sizeof(header), pcm, data_bytes);
-
-    *out_buf = wav;
-    *out_len = total_bytes;
-    return ESP_OK;
+static const https_pool_header_t JSON_HEADERS[] = {
+    {"Content-Type", "application/json"},
+};
+
+// POST a JSON body over the shared session for the URL's host
+static esp_err_t gemini_post_json(const char *url, const char *payload, http_buffer_t *response, int *status)
+{
+    const https_pool_request_t req = {
+        .url = url,
+        .body = payload,
+        .body_len = strlen(payload),
+        .headers = JSON_HEADERS,
+        .header_count = sizeof(JSON_HEADERS) / sizeof(JSON_HEADERS[0]),
+        .on_data = http_buffer_sink,
+        .ctx = response,
+    };
+    return gemini_post(&req, status);
 }
 
-static esp_err_t base64_encode_alloc(const uint8_t *input, size_t input_len, char **out_str)
+// Same, with the WAV of pcm base64-streamed where payload has WAV_UPLOAD_MARKER
+static esp_err_t gemini_post_wav(const char *url, const char *payload, const int16_t *pcm, size_t sample_count,
+                                 int sample_rate_hz, uplink_codec_id_t codec, http_buffer_t *response, int *status)
 {
-    ESP_RETURN_ON_FALSE(input && out_str, ESP_ERR_INVALID_ARG, TAG, "bad args");
-    size_t target_len = ((input_len + 2) / 3) * 4 + 1;
-    char *encoded = malloc(target_len);
-    ESP_RETURN_ON_FALSE(encoded, ESP_ERR_NO_MEM, TAG, "b64 alloc");
-    size_t written = 0;
-    int ret = mbedtls_base64_encode((unsigned char *)encoded, target_len, &written, input, input_len);
-    if (ret != 0) {
-        free(encoded);
-        return ESP_FAIL;
-    }
-    encoded[written] = '\0';
-    *out_str = encoded;
-    return ESP_OK;
+    wav_upload_body_t body;
+    ESP_RETURN_ON_ERROR(wav_upload_body_init(&body, payload, pcm, sample_count, sample_rate_hz, codec), TAG, "wav body");
+    const https_pool_request_t req = {
+        .url = url,
+        .body_len = wav_upload_body_length(&body),
+        .write_body = wav_upload_body_write,
+        .body_ctx = &body,
+        .headers = JSON_HEADERS,
+        .header_count = sizeof(JSON_HEADERS) / sizeof(JSON_HEADERS[0]),
+        .on_data = http_buffer_sink,
+        .ctx = response,
+    };
+    return gemini_post(&req, status);
 }
 
-// STT: Speech-to-Text using Google Speech-to-Text API
 esp_err_t gemini_transcribe_wav(const int16_t *pcm_samples, size_t sample_count, int sample_rate_hz, gemini_transcription_t *result)
+{
+    return gemini_transcribe_audio(pcm_samples, sample_count, sample_rate_hz, UPLINK_CODEC_PCM16, result);
+}
+
+esp_err_t gemini_transcribe_audio(const int16_t *pcm_samples, size_t sample_count, int sample_rate_hz,
+                                  uplink_codec_id_t codec, gemini_transcription_t *result)
 {
     ESP_RETURN_ON_FALSE(pcm_samples && sample_count && result, ESP_ERR_INVALID_ARG, TAG, "bad args");
     ESP_RETURN_ON_FALSE(sample_rate_hz > 0, ESP_ERR_INVALID_ARG, TAG, "sample_rate_hz must be > 0");
     
     float duration_sec = sample_rate_hz > 0 ? (float)sample_count / sample_rate_hz : 0.0f;
-    ESP_LOGI(TAG, "🔊 [Gemini STT] Starting transcription: %zu samples @ %d Hz (%.2f sec)", 
-             sample_count, sample_rate_hz, duration_sec);
-    
-    uint8_t *wav = NULL;
-    size_t wav_len = 0;
-    ESP_RETURN_ON_ERROR(build_wav_from_pcm(pcm_samples, sample_count, sample_rate_hz, &wav, &wav_len), TAG, "wav");
-    ESP_LOGD(TAG, "🔊 [Gemini STT] WAV created: %zu bytes", wav_len);
-    
-    char *b64_audio = NULL;
-    ESP_RETURN_ON_ERROR(base64_encode_alloc(wav, wav_len, &b64_audio), TAG, "b64");
-    ESP_LOGD(TAG, "🔊 [Gemini STT] Base64 encoded: %zu chars", strlen(b64_audio));
-    free(wav);
-    
-    // Build JSON request for Google Speech-to-Text API
-    cJSON *root = cJSON_CreateObject();
-    cJSON *config = cJSON_CreateObject();
-    cJSON_AddStringToObject(config, "encoding", "LINEAR16");
-    cJSON_AddNumberToObject(config, "sampleRateHertz", sample_rate_hz);
-    cJSON_AddStringToObject(config, "languageCode", "en-US");
-    cJSON_AddItemToObject(root, "config", config);
-    
-    cJSON *audio = cJSON_CreateObject();
-    cJSON_AddStringToObject(audio, "content", b64_audio);
-    cJSON_AddItemToObject(root, "audio", audio);
-    
-    char *payload = cJSON_PrintUnformatted(root);
-    cJSON_Delete(root);
-    free(b64_audio);
-    ESP_RETURN_ON_FALSE(payload, ESP_ERR_NO_MEM, TAG, "payload");
+    ESP_LOGI(TAG, "🔊 [Gemini STT] Starting transcription: %zu samples @ %d Hz (%.2f sec, %s)", 
+             sample_count, sample_rate_hz, duration_sec, uplink_codec_google_encoding(codec));
+    
+    // Build JSON request for Google Speech-to-Text API; the audio content is
+    // a marker that the WAV gets base64-streamed over while uploading
+    char payload[192];
+    json_writer_t w;
+    json_writer_init(&w, payload, sizeof(payload));
+    json_writer_begin_object(&w, NULL);
+    json_writer_begin_object(&w, "config");
+    json_writer_string(&w, "encoding", uplink_codec_google_encoding(codec));
+    json_writer_int(&w, "sampleRateHertz", sample_rate_hz);
+    json_writer_string(&w, "languageCode", "en-US");
+    json_writer_end_object(&w);
+    json_writer_begin_object(&w, "audio");
+    json_writer_string(&w, "content", WAV_UPLOAD_MARKER);
+    json_writer_end_object(&w);
+    json_writer_end_object(&w);
+    ESP_RETURN_ON_ERROR(json_writer_finish(&w, NULL), TAG, "payload");
     
     // Build URL with API key
     char url[512];
     snprintf(url, sizeof(url), "%s?key=%s", SPEECH_TO_TEXT_URL, GEMINI_API_KEY_STRING);
     ESP_LOGD(TAG, "🔊 [Gemini STT] Request URL: %s", SPEECH_TO_TEXT_URL);
-    ESP_LOGD(TAG, "🔊 [Gemini STT] Payload size: %zu bytes", strlen(payload));
-    
-    esp_http_client_config_t cfg = {
-        .url = url,
-        .crt_bundle_attach = esp_crt_bundle_attach,
-        .event_handler = http_event_handler,
-    };
     
     http_buffer_t response = {0};
-    cfg.user_data = &response;
-    esp_http_client_handle_t client = esp_http_client_init(&cfg);
-    ESP_RETURN_ON_FALSE(client, ESP_ERR_NO_MEM, TAG, "http client");
-    
-    ESP_LOGI(TAG, "📤 [Gemini STT] Sending audio via HTTP POST: %zu bytes payload (%.2f sec audio)", 
-             strlen(payload), duration_sec);
+    ESP_LOGI(TAG, "📤 [Gemini STT] Streaming audio via HTTP POST: %zu bytes %s (%.2f sec audio)", 
+             sample_count * (size_t)(uplink_codec_bits_per_sample(codec) / 8), uplink_codec_google_encoding(codec),
+             duration_sec);
     esp_err_t ret = ESP_OK;
-    ESP_GOTO_ON_ERROR(esp_http_client_set_method(client, HTTP_METHOD_POST), cleanup, TAG, "method");
-    ESP_GOTO_ON_ERROR(esp_http_client_set_header(client, "Content-Type", "application/json"), cleanup, TAG, "ct hdr");
-    ESP_GOTO_ON_ERROR(esp_http_client_set_post_field(client, payload, strlen(payload)), cleanup, TAG, "set body");
-    
     int64_t start_time = esp_timer_get_time();
     ESP_LOGI(TAG, "📤 [Gemini STT] HTTP POST in progress...");
-    ESP_GOTO_ON_ERROR(esp_http_client_perform(client), cleanup, TAG, "perform");
+    int status = 0;
+    ESP_GOTO_ON_ERROR(gemini_post_wav(url, payload, pcm_samples, sample_count, sample_rate_hz, codec, &response, &status),
+                      cleanup, TAG, "post");
     int64_t elapsed_us = esp_timer_get_time() - start_time;
     
-    int status = esp_http_client_get_status_code(client);
     ESP_LOGI(TAG, "🔊 [Gemini STT] HTTP response: %d (took %lld ms)", status, elapsed_us / 1000);
     if (status / 100 != 2) {
         ESP_LOGE(TAG, "❌ [Gemini STT] HTTP error %d", status);
@@ -198,7 +198,7 @@ esp_err_t gemini_transcribe_wav(const int16_t *pcm_samples, size_t sample_count,
         goto cleanup;
     }
     
-    response.data = realloc(response.data, response.len + 1);
+    response.data = interaction_arena_realloc(response.data, response.len + 1);
     if (!response.data) {
         ret = ESP_ERR_NO_MEM;
         goto cleanup;
@@ -243,102 +243,59 @@ esp_err_t gemini_transcribe_wav(const int16_t *pcm_samples, size_t sample_count,
     cJSON_Delete(json);
     
 cleanup:
-    if (response.data) free(response.data);
-    if (payload) free(payload);
-    if (client) esp_http_client_cleanup(client);
+    if (response.data) interaction_arena_free(response.data);
     return ret;
 }
 
-// Build Gemini function calling tools definition
-static cJSON *build_gemini_tools(void)
-{
-    cJSON *tools = cJSON_CreateArray();
-    cJSON *tool = cJSON_CreateObject();
-    cJSON *function_declarations = cJSON_CreateArray();
-    
-    // get_device_state
-    cJSON *func1 = cJSON_CreateObject();
-    cJSON_AddStringToObject(func1, "name", "get_device_state");
-    cJSON_AddStringToObject(func1, "description", "Get complete device state including WiFi, LEDs, audio, AWS, Spotify, sensors, and health");
-    cJSON_AddItemToArray(function_declarations, func1);
-    
-    // get_health
-    cJSON *func2 = cJSON_CreateObject();
-    cJSON_AddStringToObject(func2, "name", "get_health");
-    cJSON_AddStringToObject(func2, "description", "Get device health status including memory usage");
-    cJSON_AddItemToArray(function_declarations, func2);
-    
-    // get_temperature
-    cJSON *func3 = cJSON_CreateObject();
-    cJSON_AddStringToObject(func3, "name", "get_temperature");
-    cJSON_AddStringToObject(func3, "description", "Get current temperature reading from sensors");
-    cJSON_AddItemToArray(function_declarations, func3);
-    
-    // get_sensors
-    cJSON *func4 = cJSON_CreateObject();
-    cJSON_AddStringToObject(func4, "name", "get_sensors");
-    cJSON_AddStringToObject(func4, "description", "Get all sensor readings (temperature, humidity, VOC, CO2, ambient light, proximity)");
-    cJSON_AddItemToArray(function_declarations, func4);
-    
-    // set_leds
-    cJSON *func5 = cJSON_CreateObject();
-    cJSON_AddStringToObject(func5, "name", "set_leds");
-    cJSON_AddStringToObject(func5, "description", "Turn LEDs on or off. Arguments: {\"enabled\": true/false}");
-    cJSON *params5 = cJSON_CreateObject();
-    cJSON_AddStringToObject(params5, "type", "object");
-    cJSON *props5 = cJSON_CreateObject();
-    cJSON *enabled5 = cJSON_CreateObject();
-    cJSON_AddStringToObject(enabled5, "type", "boolean");
-    cJSON_AddStringToObject(enabled5, "description", "true to turn on, false to turn off");
-    cJSON_AddItemToObject(props5, "enabled", enabled5);
-    cJSON_AddItemToObject(params5, "properties", props5);
-    cJSON_AddItemToObject(func5, "parameters", params5);
-    cJSON_AddItemToArray(function_declarations, func5);
-    
-    // set_led_color
-    cJSON *func6 = cJSON_CreateObject();
-    cJSON_AddStringToObject(func6, "name", "set_led_color");
-    cJSON_AddStringToObject(func6, "description", "Set LED color. Arguments: {\"red\": 0-255, \"green\": 0-255, \"blue\": 0-255}");
-    cJSON *params6 = cJSON_CreateObject();
-    cJSON_AddStringToObject(params6, "type", "object");
-    cJSON *props6 = cJSON_CreateObject();
-    cJSON *red6 = cJSON_CreateObject();
-    cJSON_AddStringToObject(red6, "type", "number");
-    cJSON_AddNumberToObject(red6, "minimum", 0);
-    cJSON_AddNumberToObject(red6, "maximum", 255);
-    cJSON_AddItemToObject(props6, "red", red6);
-    cJSON *green6 = cJSON_CreateObject();
-    cJSON_AddStringToObject(green6, "type", "number");
-    cJSON_AddNumberToObject(green6, "minimum", 0);
-    cJSON_AddNumberToObject(green6, "maximum", 255);
-    cJSON_AddItemToObject(props6, "green", green6);
-    cJSON *blue6 = cJSON_CreateObject();
-    cJSON_AddStringToObject(blue6, "type", "number");
-    cJSON_AddNumberToObject(blue6, "minimum", 0);
-    cJSON_AddNumberToObject(blue6, "maximum", 255);
-    cJSON_AddItemToObject(props6, "blue", blue6);
-    cJSON_AddItemToObject(params6, "properties", props6);
-    cJSON_AddItemToObject(func6, "parameters", params6);
-    cJSON_AddItemToArray(function_declarations, func6);
-    
-    // set_audio_mute
-    cJSON *func7 = cJSON_CreateObject();
-    cJSON_AddStringToObject(func7, "name", "set_audio_mute");
-    cJSON_AddStringToObject(func7, "description", "Mute or unmute audio. Arguments: {\"muted\": true/false}");
-    cJSON *params7 = cJSON_CreateObject();
-    cJSON_AddStringToObject(params7, "type", "object");
-    cJSON *props7 = cJSON_CreateObject();
-    cJSON *muted7 = cJSON_CreateObject();
-    cJSON_AddStringToObject(muted7, "type", "boolean");
-    cJSON_AddStringToObject(muted7, "description", "true to mute, false to unmute");
-    cJSON_AddItemToObject(props7, "muted", muted7);
-    cJSON_AddItemToObject(params7, "properties", props7);
-    cJSON_AddItemToObject(func7, "parameters", params7);
-    cJSON_AddItemToArray(function_declarations, func7);
-    
-    cJSON_AddItemToObject(tool, "functionDeclarations", function_declarations);
-    cJSON_AddItemToArray(tools, tool);
-    return tools;
+// Function-calling schema. It never changes, so it is a literal rather than a
+// cJSON tree built and printed for every request
+#define GEMINI_TOOLS_JSON \
+    "[{\"functionDeclarations\":[" \
+    "{\"name\":\"get_device_state\",\"description\":\"Get complete device state including WiFi, LEDs, audio, AWS, Spotify, sensors, and health\"}," \
+    "{\"name\":\"get_health\",\"description\":\"Get device health status including memory usage\"}," \
+    "{\"name\":\"get_temperature\",\"description\":\"Get current temperature reading from sensors\"}," \
+    "{\"name\":\"get_sensors\",\"description\":\"Get all sensor readings (temperature, humidity, VOC, CO2, ambient light, proximity)\"}," \
+    "{\"name\":\"set_leds\",\"description\":\"Turn LEDs on or off. Arguments: {\\\"enabled\\\": true/false}\",\"parameters\":{\"type\":\"object\",\"properties\":{\"enabled\":{\"type\":\"boolean\",\"description\":\"true to turn on, false to turn off\"}}}}," \
+    "{\"name\":\"set_led_color\",\"description\":\"Set LED color. Arguments: {\\\"red\\\": 0-255, \\\"green\\\": 0-255, \\\"blue\\\": 0-255}\",\"parameters\":{\"type\":\"object\",\"properties\":{\"red\":{\"type\":\"number\",\"minimum\":0,\"maximum\":255},\"green\":{\"type\":\"number\",\"minimum\":0,\"maximum\":255},\"blue\":{\"type\":\"number\",\"minimum\":0,\"maximum\":255}}}}," \
+    "{\"name\":\"set_audio_mute\",\"description\":\"Mute or unmute audio. Arguments: {\\\"muted\\\": true/false}\",\"parameters\":{\"type\":\"object\",\"properties\":{\"muted\":{\"type\":\"boolean\",\"description\":\"true to mute, false to unmute\"}}}}" \
+    "]}]"
+#define GEMINI_TOOL_COUNT 7
+
+// generateContent body around the device state and user query. The fixed text
+// is stored already JSON-escaped, so a request only escapes what it splices in.
+// Conversation history goes between LLM_CONTENTS_OPEN and the query's turn
+#define LLM_CONTENTS_OPEN "\"contents\":["
+#define LLM_TURN_OPEN "{\"role\":\"user\",\"parts\":[{\"text\":\""
+static const char LLM_PAYLOAD_HEAD[] =
+    LLM_TURN_OPEN
+    "You are Naphome, a voice assistant for a smart home device. Here is the current device state:\\n\\n";
+static const char LLM_PAYLOAD_QUERY[] = "\\n\\nUser query: ";
+static const char LLM_PAYLOAD_TAIL[] =
+    "\\n\\nYou have access to function calling tools to control the device and query its status:\\n"
+    "- get_device_state: Get complete device state (WiFi, LEDs, audio, AWS, Spotify, sensors, health)\\n"
+    "- get_health: Get device health status including memory usage and sensor counts\\n"
+    "- get_temperature: Get current temperature and humidity from sensors\\n"
+    "- get_sensors: Get all sensor readings (temperature, humidity, VOC, CO2, ambient light, proximity, PM2.5)\\n"
+    "- set_leds: Turn LEDs on or off (arguments: {\\\"enabled\\\": true/false})\\n"
+    "- set_led_color: Set LED color (arguments: {\\\"red\\\": 0-255, \\\"green\\\": 0-255, \\\"blue\\\": 0-255})\\n"
+    "- set_audio_mute: Mute or unmute audio (arguments: {\\\"muted\\\": true/false})\\n\\n"
+    "When the user asks about device status, health, or sensors, use the appropriate function to get current data. "
+    "When the user wants to control lights or audio, use the control functions. Always provide natural, conversational responses."
+    "\"}]}],\"tools\":" GEMINI_TOOLS_JSON "}";
+// Plain prompt, no state or tools
+static const char LLM_PLAIN_HEAD[] = LLM_TURN_OPEN;
+static const char LLM_PLAIN_TAIL[] = "\"}]}]}";
+// Folded older turns ride in the system instruction
+static const char LLM_SUMMARY_OPEN[] = "\"systemInstruction\":{\"parts\":[{\"text\":\"Earlier in this conversation:\\n";
+static const char LLM_SUMMARY_CLOSE[] = "\"}]},";
+static const char LLM_HISTORY_USER[] = "{\"role\":\"user\",\"parts\":[{\"text\":\"";
+static const char LLM_HISTORY_MODEL[] = "{\"role\":\"model\",\"parts\":[{\"text\":\"";
+static const char LLM_HISTORY_CLOSE[] = "\"}]},";
+
+static char *append_literal(char *dst, const char *lit, size_t len)
+{
+    memcpy(dst, lit, len);
+    return dst + len;
 }
 
 // LLM: Chat completions using Gemini API
@@ -347,6 +304,148 @@ esp_err_t gemini_generate_text_response(const char *prompt, char *out_text, size
     return gemini_generate_text_response_with_tools(prompt, NULL, out_text, out_len);
 }
 
+// generateContent body for prompt after the conversation history; device state
+// adds context and the tool list. Sized up front and filled in one pass;
+// release with cJSON_free() like any other payload
+static char *build_llm_payload(const char *prompt, const char *device_state_json)
+{
+    size_t prompt_len = json_writer_escaped_len(prompt);
+    size_t state_len = device_state_json ? json_writer_escaped_len(device_state_json) : 0;
+    size_t total = device_state_json
+                       ? sizeof(LLM_PAYLOAD_HEAD) - 1 + state_len + sizeof(LLM_PAYLOAD_QUERY) - 1 + prompt_len +
+                             sizeof(LLM_PAYLOAD_TAIL) - 1
+                       : sizeof(LLM_PLAIN_HEAD) - 1 + prompt_len + sizeof(LLM_PLAIN_TAIL) - 1;
+    total += 1 + sizeof(LLM_CONTENTS_OPEN) - 1;
+
+    // Held until the history is copied in, so it cannot change between sizing and writing
+    conversation_view_t history = {0};
+    bool has_history = conversation_memory_acquire(&history);
+    if (has_history) {
+        if (history.summary[0]) {
+            total += sizeof(LLM_SUMMARY_OPEN) - 1 + json_writer_escaped_len(history.summary) + sizeof(LLM_SUMMARY_CLOSE) - 1;
+        }
+        for (size_t i = 0; i < history.turn_count; ++i) {
+            bool user = history.turns[i].role == CONVERSATION_ROLE_USER;
+            total += (user ? sizeof(LLM_HISTORY_USER) : sizeof(LLM_HISTORY_MODEL)) - 1 +
+                     json_writer_escaped_len(history.turns[i].text) + sizeof(LLM_HISTORY_CLOSE) - 1;
+        }
+    }
+    char *payload = interaction_arena_malloc(total + 1);
+    if (!payload) {
+        if (has_history) {
+            conversation_memory_release();
+        }
+        return NULL;
+    }
+
+    char *p = payload;
+    *p++ = '{';
+    if (has_history && history.summary[0]) {
+        p = append_literal(p, LLM_SUMMARY_OPEN, sizeof(LLM_SUMMARY_OPEN) - 1);
+        p = json_writer_escape_copy(p, history.summary);
+        p = append_literal(p, LLM_SUMMARY_CLOSE, sizeof(LLM_SUMMARY_CLOSE) - 1);
+    }
+    p = append_literal(p, LLM_CONTENTS_OPEN, sizeof(LLM_CONTENTS_OPEN) - 1);
+    if (has_history) {
+        for (size_t i = 0; i < history.turn_count; ++i) {
+            p = history.turns[i].role == CONVERSATION_ROLE_USER
+                    ? append_literal(p, LLM_HISTORY_USER, sizeof(LLM_HISTORY_USER) - 1)
+                    : append_literal(p, LLM_HISTORY_MODEL, sizeof(LLM_HISTORY_MODEL) - 1);
+            p = json_writer_escape_copy(p, history.turns[i].text);
+            p = append_literal(p, LLM_HISTORY_CLOSE, sizeof(LLM_HISTORY_CLOSE) - 1);
+        }
+        conversation_memory_release();
+    }
+    if (device_state_json) {
+        p = append_literal(p, LLM_PAYLOAD_HEAD, sizeof(LLM_PAYLOAD_HEAD) - 1);
+        p = json_writer_escape_copy(p, device_state_json);
+        p = append_literal(p, LLM_PAYLOAD_QUERY, sizeof(LLM_PAYLOAD_QUERY) - 1);
+        p = json_writer_escape_copy(p, prompt);
+        p = append_literal(p, LLM_PAYLOAD_TAIL, sizeof(LLM_PAYLOAD_TAIL) - 1);
+        ESP_LOGI(TAG, "💬 [Gemini LLM] Function calling enabled with %d tools", GEMINI_TOOL_COUNT);
+    } else {
+        p = append_literal(p, LLM_PLAIN_HEAD, sizeof(LLM_PLAIN_HEAD) - 1);
+        p = json_writer_escape_copy(p, prompt);
+        p = append_literal(p, LLM_PLAIN_TAIL, sizeof(LLM_PLAIN_TAIL) - 1);
+    }
+    *p = '\0';
+    return payload;
+}
+
+// Run every functionCall part of a reply at once. Plain actions are confirmed
+// from fixed phrases; results that have to be read out, and failures, go back
+// to the model for one more reply
+static esp_err_t run_function_calls(const cJSON *parts, const char *prompt, char *out_text, size_t out_len)
+{
+    tool_dispatch_call_t *calls = interaction_arena_calloc(TOOL_DISPATCH_MAX_CALLS, sizeof(*calls));
+    ESP_RETURN_ON_FALSE(calls, ESP_ERR_NO_MEM, TAG, "calls");
+    char *args[TOOL_DISPATCH_MAX_CALLS] = {0};
+    char *followup_prompt = NULL;
+    size_t count = 0;
+    esp_err_t ret = ESP_OK;
+    const cJSON *part;
+    cJSON_ArrayForEach(part, parts) {
+        const cJSON *function_call = cJSON_GetObjectItem(part, "functionCall");
+        const cJSON *name = cJSON_GetObjectItem(function_call, "name");
+        const cJSON *fargs = cJSON_GetObjectItem(function_call, "args");
+        if (!cJSON_IsString(name)) {
+            continue;
+        }
+        if (count == TOOL_DISPATCH_MAX_CALLS) {
+            ESP_LOGW(TAG, "⚠️ [Gemini LLM] More than %d function calls, ignoring the rest", TOOL_DISPATCH_MAX_CALLS);
+            break;
+        }
+        args[count] = cJSON_IsObject(fargs) ? cJSON_PrintUnformatted(fargs) : NULL;
+        calls[count].name = name->valuestring;
+        calls[count].args_json = args[count];
+        ESP_LOGI(TAG, "🔧 [Gemini LLM] Function call detected: %s(%s)", name->valuestring,
+                 args[count] ? args[count] : "{}");
+        count++;
+    }
+    ESP_GOTO_ON_FALSE(count > 0, ESP_FAIL, done, TAG, "❌ [Gemini LLM] Invalid function call format");
+
+    tool_dispatch_run(calls, count);
+    if (tool_dispatch_confirmation(calls, count, out_text, out_len)) {
+        ESP_LOGI(TAG, "✅ [Gemini LLM] Confirmed locally: \"%s\"", out_text);
+        goto done;
+    }
+
+    // Use original prompt (before device state enhancement) for user query context
+    size_t cap = strlen(prompt) + 128;
+    for (size_t i = 0; i < count; ++i) {
+        cap += strlen(calls[i].name) + strlen(calls[i].result) + 32;
+    }
+    followup_prompt = interaction_arena_malloc(cap);
+    ESP_GOTO_ON_FALSE(followup_prompt, ESP_ERR_NO_MEM, done, TAG, "followup");
+    size_t len = 0;
+    for (size_t i = 0; i < count; ++i) {
+        len += snprintf(followup_prompt + len, cap - len, "Function %s returned: %s\n", calls[i].name,
+                        calls[i].result);
+    }
+    snprintf(followup_prompt + len, cap - len,
+             "\nProvide a natural language response to the user's original query: %s", prompt);
+
+    // Recursive call (limit depth to prevent infinite loops)
+    // Note: Use NULL for device_state_json in followup to avoid redundant state
+    static int call_depth = 0;
+    if (call_depth < 2) {
+        call_depth++;
+        ret = gemini_generate_text_response_with_tools(followup_prompt, NULL, out_text, out_len);
+        call_depth--;
+    } else {
+        // Fallback: use function result as response to prevent infinite recursion
+        snprintf(out_text, out_len, "Function %s completed: %s", calls[0].name, calls[0].result);
+    }
+
+done:
+    for (size_t i = 0; i < count; ++i) {
+        cJSON_free(args[i]);
+    }
+    interaction_arena_free(followup_prompt);
+    interaction_arena_free(calls);
+    return ret;
+}
+
 // LLM: Chat completions with function calling support
 esp_err_t gemini_generate_text_response_with_tools(const char *prompt, const char *device_state_json, char *out_text, size_t out_len)
 {
@@ -354,48 +453,7 @@ esp_err_t gemini_generate_text_response_with_tools(const char *prompt, const cha
     
     ESP_LOGI(TAG, "💬 [Gemini LLM] Generating response for: \"%.100s%s\"", prompt, strlen(prompt) > 100 ? "..." : "");
     
-    // Build enhanced prompt with device state
-    char enhanced_prompt[4096] = {0};
-    if (device_state_json) {
-        snprintf(enhanced_prompt, sizeof(enhanced_prompt),
-                "You are Naphome, a voice assistant for a smart home device. Here is the current device state:\n\n%s\n\n"
-                "User query: %s\n\n"
-                "You have access to function calling tools to control the device and query its status:\n"
-                "- get_device_state: Get complete device state (WiFi, LEDs, audio, AWS, Spotify, sensors, health)\n"
-                "- get_health: Get device health status including memory usage and sensor counts\n"
-                "- get_temperature: Get current temperature and humidity from sensors\n"
-                "- get_sensors: Get all sensor readings (temperature, humidity, VOC, CO2, ambient light, proximity, PM2.5)\n"
-                "- set_leds: Turn LEDs on or off (arguments: {\"enabled\": true/false})\n"
-                "- set_led_color: Set LED color (arguments: {\"red\": 0-255, \"green\": 0-255, \"blue\": 0-255})\n"
-                "- set_audio_mute: Mute or unmute audio (arguments: {\"muted\": true/false})\n\n"
-                "When the user asks about device status, health, or sensors, use the appropriate function to get current data. "
-                "When the user wants to control lights or audio, use the control functions. Always provide natural, conversational responses.",
-                device_state_json, prompt);
-    } else {
-        snprintf(enhanced_prompt, sizeof(enhanced_prompt), "%s", prompt);
-    }
-    
-    // Build JSON request for Gemini API
-    cJSON *root = cJSON_CreateObject();
-    cJSON *contents = cJSON_CreateArray();
-    cJSON *content = cJSON_CreateObject();
-    cJSON *parts = cJSON_CreateArray();
-    cJSON *part = cJSON_CreateObject();
-    cJSON_AddStringToObject(part, "text", enhanced_prompt);
-    cJSON_AddItemToArray(parts, part);
-    cJSON_AddItemToObject(content, "parts", parts);
-    cJSON_AddItemToArray(contents, content);
-    cJSON_AddItemToObject(root, "contents", contents);
-    
-    // Add function calling tools
-    if (device_state_json) {
-        cJSON *tools = build_gemini_tools();
-        cJSON_AddItemToObject(root, "tools", tools);
-        ESP_LOGI(TAG, "💬 [Gemini LLM] Function calling enabled with %d tools", cJSON_GetArraySize(cJSON_GetObjectItem(cJSON_GetArrayItem(tools, 0), "functionDeclarations")));
-    }
-    
-    char *payload = cJSON_PrintUnformatted(root);
-    cJSON_Delete(root);
+    char *payload = build_llm_payload(prompt, device_state_json);
     ESP_RETURN_ON_FALSE(payload, ESP_ERR_NO_MEM, TAG, "payload");
     
     // Build URL with API key
@@ -404,28 +462,14 @@ esp_err_t gemini_generate_text_response_with_tools(const char *prompt, const cha
     ESP_LOGD(TAG, "💬 [Gemini LLM] Request URL: %s", GEMINI_API_URL);
     ESP_LOGD(TAG, "💬 [Gemini LLM] Payload size: %zu bytes", strlen(payload));
     
-    esp_http_client_config_t cfg = {
-        .url = url,
-        .crt_bundle_attach = esp_crt_bundle_attach,
-        .event_handler = http_event_handler,
-    };
-    
     http_buffer_t response = {0};
-    cfg.user_data = &response;
-    esp_http_client_handle_t client = esp_http_client_init(&cfg);
-    ESP_RETURN_ON_FALSE(client, ESP_ERR_NO_MEM, TAG, "http client");
-    
     ESP_LOGI(TAG, "💬 [Gemini LLM] Sending HTTP POST request...");
     esp_err_t ret = ESP_OK;
-    ESP_GOTO_ON_ERROR(esp_http_client_set_method(client, HTTP_METHOD_POST), cleanup, TAG, "method");
-    ESP_GOTO_ON_ERROR(esp_http_client_set_header(client, "Content-Type", "application/json"), cleanup, TAG, "ct hdr");
-    ESP_GOTO_ON_ERROR(esp_http_client_set_post_field(client, payload, strlen(payload)), cleanup, TAG, "set body");
-    
     int64_t start_time = esp_timer_get_time();
-    ESP_GOTO_ON_ERROR(esp_http_client_perform(client), cleanup, TAG, "perform");
+    int status = 0;
+    ESP_GOTO_ON_ERROR(gemini_post_json(url, payload, &response, &status), cleanup, TAG, "post");
     int64_t elapsed_us = esp_timer_get_time() - start_time;
     
-    int status = esp_http_client_get_status_code(client);
     ESP_LOGI(TAG, "💬 [Gemini LLM] HTTP response: %d (took %lld ms)", status, elapsed_us / 1000);
     if (status / 100 != 2) {
         ESP_LOGE(TAG, "❌ [Gemini LLM] HTTP error %d", status);
@@ -433,7 +477,7 @@ esp_err_t gemini_generate_text_response_with_tools(const char *prompt, const cha
         goto cleanup;
     }
     
-    response.data = realloc(response.data, response.len + 1);
+    response.data = interaction_arena_realloc(response.data, response.len + 1);
     if (!response.data) {
         ret = ESP_ERR_NO_MEM;
         goto cleanup;
@@ -459,49 +503,10 @@ esp_err_t gemini_generate_text_response_with_tools(const char *prompt, const cha
             if (cJSON_IsArray(parts) && cJSON_GetArraySize(parts) > 0) {
                 cJSON *first_part = cJSON_GetArrayItem(parts, 0);
                 
-                // Check for function call
+                // Check for function calls; a reply may hold several, in any of its parts
                 cJSON *function_call = cJSON_GetObjectItem(first_part, "functionCall");
                 if (function_call) {
-                    cJSON *name = cJSON_GetObjectItem(function_call, "name");
-                    cJSON *args = cJSON_GetObjectItem(function_call, "args");
-                    if (cJSON_IsString(name) && cJSON_IsObject(args)) {
-                        const char *func_name = name->valuestring;
-                        char *args_str = cJSON_PrintUnformatted(args);
-                        ESP_LOGI(TAG, "🔧 [Gemini LLM] Function call detected: %s(%s)", func_name, args_str);
-                        
-                        // Execute function call
-                        char func_response[512] = {0};
-                        esp_err_t func_ret = gemini_execute_function_call(func_name, args_str, func_response, sizeof(func_response));
-                        free(args_str);
-                        
-                        if (func_ret == ESP_OK) {
-                            // Call Gemini again with function result
-                            // Use original prompt (before device state enhancement) for user query context
-                            char followup_prompt[1024];
-                            snprintf(followup_prompt, sizeof(followup_prompt),
-                                    "Function %s returned: %s\n\nProvide a natural language response to the user's original query: %s",
-                                    func_name, func_response, prompt);
-                            
-                            // Recursive call (limit depth to prevent infinite loops)
-                            // Note: Use NULL for device_state_json in followup to avoid redundant state
-                            static int call_depth = 0;
-                            if (call_depth < 2) {
-                                call_depth++;
-                                ret = gemini_generate_text_response_with_tools(followup_prompt, NULL, out_text, out_len);
-                                call_depth--;
-                            } else {
-                                // Fallback: use function result as response to prevent infinite recursion
-                                snprintf(out_text, out_len, "Function %s completed: %s", func_name, func_response);
-                                ret = ESP_OK;
-                            }
-                        } else {
-                            snprintf(out_text, out_len, "Error executing function %s", func_name);
-                            ret = ESP_FAIL;
-                        }
-                    } else {
-                        ESP_LOGE(TAG, "❌ [Gemini LLM] Invalid function call format");
-                        ret = ESP_FAIL;
-                    }
+                    ret = run_function_calls(parts, prompt, out_text, out_len);
                 } else {
                     // Regular text response
                     cJSON *text = cJSON_GetObjectItem(first_part, "text");
@@ -531,13 +536,146 @@ esp_err_t gemini_generate_text_response_with_tools(const char *prompt, const cha
     cJSON_Delete(json);
     
 cleanup:
-    if (response.data) free(response.data);
-    if (payload) free(payload);
-    if (client) esp_http_client_cleanup(client);
+    if (response.data) interaction_arena_free(response.data);
+    if (payload) cJSON_free(payload);
+    return ret;
+}
+
+// Streaming LLM: SSE text parts forwarded as they arrive
+typedef struct {
+    sse_text_parser_t parser;
+    gemini_text_delta_cb_t on_delta;
+    void *ctx;
+    char *out_text;
+    size_t out_len;
+    size_t used;
+    size_t delivered;                 // Delta bytes handed to on_delta
+} llm_stream_t;
+
+static void llm_stream_text(const char *text, bool is_done, void *ctx)
+{
+    llm_stream_t *s = (llm_stream_t *)ctx;
+    // Text after a functionCall is unreliable; that turn is redone with tools
+    if (is_done || !text[0] || s->parser.tool_call_seen) {
+        return;
+    }
+    size_t len = strlen(text);
+    size_t room = s->out_len - 1 - s->used;
+    size_t n = len < room ? len : room;
+    memcpy(s->out_text + s->used, text, n);
+    s->used += n;
+    s->out_text[s->used] = '\0';
+    if (s->on_delta) {
+        s->on_delta(text, s->ctx);
+    }
+    s->delivered += len;
+}
+
+static esp_err_t llm_stream_sink(void *ctx, const uint8_t *data, size_t len)
+{
+    llm_stream_t *s = (llm_stream_t *)ctx;
+    sse_text_parser_feed(&s->parser, (const char *)data, len);
+    return ESP_OK;
+}
+
+esp_err_t gemini_generate_text_response_stream(const char *prompt, const char *device_state_json,
+                                               gemini_text_delta_cb_t on_delta, void *ctx,
+                                               char *out_text, size_t out_len)
+{
+    ESP_RETURN_ON_FALSE(prompt && out_text && out_len > 0, ESP_ERR_INVALID_ARG, TAG, "bad args");
+    
+    ESP_LOGI(TAG, "💬 [Gemini LLM] Streaming response for: \"%.100s%s\"", prompt, strlen(prompt) > 100 ? "..." : "");
+    out_text[0] = '\0';
+    
+    char *payload = build_llm_payload(prompt, device_state_json);
+    ESP_RETURN_ON_FALSE(payload, ESP_ERR_NO_MEM, TAG, "payload");
+    
+    // Parser holds a line buffer and token array; too large for the caller's stack
+    llm_stream_t *stream = interaction_arena_calloc(1, sizeof(*stream));
+    if (!stream) {
+        cJSON_free(payload);
+        return ESP_ERR_NO_MEM;
+    }
+    sse_text_parser_init(&stream->parser, llm_stream_text, stream);
+    stream->on_delta = on_delta;
+    stream->ctx = ctx;
+    stream->out_text = out_text;
+    stream->out_len = out_len;
+    
+    char url[512];
+    snprintf(url, sizeof(url), "%s&key=%s", GEMINI_STREAM_URL, GEMINI_API_KEY_STRING);
+    const https_pool_request_t req = {
+        .url = url,
+        .body = payload,
+        .body_len = strlen(payload),
+        .headers = JSON_HEADERS,
+        .header_count = sizeof(JSON_HEADERS) / sizeof(JSON_HEADERS[0]),
+        .on_data = llm_stream_sink,
+        .ctx = stream,
+    };
+    
+    int64_t start_time = esp_timer_get_time();
+    int status = 0;
+    esp_err_t ret = gemini_post(&req, &status);
+    sse_text_parser_finish(&stream->parser);
+    int64_t elapsed_us = esp_timer_get_time() - start_time;
+    
+    if (ret == ESP_OK && status / 100 != 2) {
+        ESP_LOGE(TAG, "❌ [Gemini LLM] HTTP error %d", status);
+        ret = ESP_FAIL;
+    } else if (ret == ESP_OK && stream->parser.tool_call_seen) {
+        // The function call and its follow-up go through the blocking path, and
+        // the final answer is delivered as one delta
+        ESP_LOGI(TAG, "🔧 [Gemini LLM] Streamed reply requested a tool; resolving with function calling");
+        ret = gemini_generate_text_response_with_tools(prompt, device_state_json, out_text, out_len);
+        if (ret == ESP_OK && on_delta && out_text[0]) {
+            on_delta(out_text, ctx);
+        }
+    } else if (ret == ESP_OK && stream->delivered == 0) {
+        ESP_LOGE(TAG, "❌ [Gemini LLM] No text in streamed response");
+        ret = ESP_FAIL;
+    } else if (ret == ESP_OK) {
+        ESP_LOGI(TAG, "✅ [Gemini LLM] Streamed \"%.200s%s\" (took %lld ms)",
+                 out_text, strlen(out_text) > 200 ? "..." : "", elapsed_us / 1000);
+    }
+    
+    interaction_arena_free(stream);
+    cJSON_free(payload);
     return ret;
 }
 
 // TTS: Text-to-Speech using Google Text-to-Speech API
+typedef struct {
+    const char *text;
+    const char *voice;
+} tts_payload_args_t;
+
+static void write_tts_payload(json_writer_t *w, const void *arg)
+{
+    const tts_payload_args_t *args = arg;
+    json_writer_begin_object(w, NULL);
+    json_writer_begin_object(w, "input");
+    json_writer_string(w, "text", args->text);
+    json_writer_end_object(w);
+    // Use provided voice or default to en-US-Standard-D
+    json_writer_begin_object(w, "voice");
+    json_writer_string(w, "languageCode", "en-US");
+    json_writer_string(w, "name", args->voice && args->voice[0] ? args->voice : "en-US-Standard-D");
+    json_writer_end_object(w);
+    json_writer_begin_object(w, "audioConfig");
+    json_writer_string(w, "audioEncoding", "LINEAR16");
+    json_writer_int(w, "sampleRateHertz", 24000); // Google TTS default
+    json_writer_end_object(w);
+    json_writer_end_object(w);
+}
+
+// Release with cJSON_free() like the other payloads
+static char *build_tts_payload(const char *text, const char *voice)
+{
+    const tts_payload_args_t args = {.text = text, .voice = voice};
+    return json_writer_build_alloc(write_tts_payload, &args, interaction_arena_malloc, interaction_arena_free, NULL);
+}
+
 esp_err_t gemini_tts_generate(const char *text, const char *voice, uint8_t *out_wav, size_t max_out, size_t *bytes_written)
 {
     ESP_RETURN_ON_FALSE(text && out_wav && max_out > 0, ESP_ERR_INVALID_ARG, TAG, "bad args");
@@ -545,25 +683,7 @@ esp_err_t gemini_tts_generate(const char *text, const char *voice, uint8_t *out_
     ESP_LOGI(TAG, "🔊 [Gemini TTS] Generating speech: \"%.100s%s\" (voice: %s)", 
              text, strlen(text) > 100 ? "..." : "", voice && voice[0] ? voice : "default");
     
-    // Build JSON request for Google TTS API
-    cJSON *root = cJSON_CreateObject();
-    cJSON *input = cJSON_CreateObject();
-    cJSON_AddStringToObject(input, "text", text);
-    cJSON_AddItemToObject(root, "input", input);
-    
-    cJSON *voice_config = cJSON_CreateObject();
-    // Use provided voice or default to en-US-Standard-D
-    cJSON_AddStringToObject(voice_config, "languageCode", "en-US");
-    cJSON_AddStringToObject(voice_config, "name", voice && voice[0] ? voice : "en-US-Standard-D");
-    cJSON_AddItemToObject(root, "voice", voice_config);
-    
-    cJSON *audio_config = cJSON_CreateObject();
-    cJSON_AddStringToObject(audio_config, "audioEncoding", "LINEAR16");
-    cJSON_AddNumberToObject(audio_config, "sampleRateHertz", 24000); // Google TTS default
-    cJSON_AddItemToObject(root, "audioConfig", audio_config);
-    
-    char *payload = cJSON_PrintUnformatted(root);
-    cJSON_Delete(root);
+    char *payload = build_tts_payload(text, voice);
     ESP_RETURN_ON_FALSE(payload, ESP_ERR_NO_MEM, TAG, "payload");
     
     // Build URL with API key
@@ -572,28 +692,14 @@ esp_err_t gemini_tts_generate(const char *text, const char *voice, uint8_t *out_
     ESP_LOGD(TAG, "🔊 [Gemini TTS] Request URL: %s", TEXT_TO_SPEECH_URL);
     ESP_LOGD(TAG, "🔊 [Gemini TTS] Payload size: %zu bytes", strlen(payload));
     
-    esp_http_client_config_t cfg = {
-        .url = url,
-        .crt_bundle_attach = esp_crt_bundle_attach,
-        .event_handler = http_event_handler,
-    };
-    
     http_buffer_t response = {0};
-    cfg.user_data = &response;
-    esp_http_client_handle_t client = esp_http_client_init(&cfg);
-    ESP_RETURN_ON_FALSE(client, ESP_ERR_NO_MEM, TAG, "http client");
-    
     ESP_LOGI(TAG, "🔊 [Gemini TTS] Sending HTTP POST request...");
     esp_err_t ret = ESP_OK;
-    ESP_GOTO_ON_ERROR(esp_http_client_set_method(client, HTTP_METHOD_POST), cleanup, TAG, "method");
-    ESP_GOTO_ON_ERROR(esp_http_client_set_header(client, "Content-Type", "application/json"), cleanup, TAG, "ct hdr");
-    ESP_GOTO_ON_ERROR(esp_http_client_set_post_field(client, payload, strlen(payload)), cleanup, TAG, "set body");
-    
     int64_t start_time = esp_timer_get_time();
-    ESP_GOTO_ON_ERROR(esp_http_client_perform(client), cleanup, TAG, "perform");
+    int status = 0;
+    ESP_GOTO_ON_ERROR(gemini_post_json(url, payload, &response, &status), cleanup, TAG, "post");
     int64_t elapsed_us = esp_timer_get_time() - start_time;
     
-    int status = esp_http_client_get_status_code(client);
     ESP_LOGI(TAG, "🔊 [Gemini TTS] HTTP response: %d (took %lld ms)", status, elapsed_us / 1000);
     if (status / 100 != 2) {
         ESP_LOGE(TAG, "❌ [Gemini TTS] HTTP error %d", status);
@@ -601,7 +707,7 @@ esp_err_t gemini_tts_generate(const char *text, const char *voice, uint8_t *out_
         goto cleanup;
     }
     
-    response.data = realloc(response.data, response.len + 1);
+    response.data = interaction_arena_realloc(response.data, response.len + 1);
     if (!response.data) {
         ret = ESP_ERR_NO_MEM;
         goto cleanup;
@@ -650,22 +756,530 @@ esp_err_t gemini_tts_generate(const char *text, const char *voice, uint8_t *out_
     cJSON_Delete(json);
     
 cleanup:
-    if (response.data) free(response.data);
-    if (payload) free(payload);
-    if (client) esp_http_client_cleanup(client);
+    if (response.data) interaction_arena_free(response.data);
+    if (payload) cJSON_free(payload);
     return ret;
 }
 
-// Realtime API: Placeholder for future streaming support
-// For now, we'll use batch STT
+// Incremental scanner for {"audioContent": "<base64>"} that decodes as bytes arrive
+#define TTS_STREAM_OUT_BYTES 768
+
+typedef enum {
+    AUDIO_SCAN_KEY,
+    AUDIO_SCAN_OPEN_QUOTE,
+    AUDIO_SCAN_VALUE,
+    AUDIO_SCAN_DONE,
+} audio_scan_state_t;
+
+typedef struct {
+    gemini_tts_chunk_cb_t on_chunk;
+    void *ctx;
+    audio_scan_state_t state;
+    size_t key_match;
+    uint32_t quad;
+    int quad_len;
+    uint8_t out[TTS_STREAM_OUT_BYTES];
+    size_t out_len;
+    size_t total;
+    esp_err_t err;
+} audio_content_stream_t;
+
+static const char AUDIO_CONTENT_KEY[] = "\"audioContent\"";
+
+static int b64_value(char c)
+{
+    if (c >= 'A' && c <= 'Z') return c - 'A';
+    if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+    if (c >= '0' && c <= '9') return c - '0' + 52;
+    if (c == '+' || c == '-') return 62;
+    if (c == '/' || c == '_') return 63;
+    return -1;
+}
+
+static void audio_stream_flush(audio_content_stream_t *s)
+{
+    if (s->out_len && s->err == ESP_OK) {
+        s->err = s->on_chunk(s->out, s->out_len, s->ctx);
+        s->total += s->out_len;
+    }
+    s->out_len = 0;
+}
+
+static void audio_stream_emit(audio_content_stream_t *s, const uint8_t *bytes, size_t n)
+{
+    if (s->out_len + n > sizeof(s->out)) {
+        audio_stream_flush(s);
+    }
+    memcpy(s->out + s->out_len, bytes, n);
+    s->out_len += n;
+}
+
+// Decode the '='-less tail left in the quad accumulator
+static void audio_stream_finish_quad(audio_content_stream_t *s)
+{
+    uint8_t bytes[3];
+    if (s->quad_len == 2) {
+        bytes[0] = (uint8_t)(s->quad >> 4);
+        audio_stream_emit(s, bytes, 1);
+    } else if (s->quad_len == 3) {
+        bytes[0] = (uint8_t)(s->quad >> 10);
+        bytes[1] = (uint8_t)(s->quad >> 2);
+        audio_stream_emit(s, bytes, 2);
+    }
+    s->quad = 0;
+    s->quad_len = 0;
+}
+
+static esp_err_t audio_content_sink(void *ctx, const uint8_t *data, size_t len)
+{
+    audio_content_stream_t *s = (audio_content_stream_t *)ctx;
+    interaction_trace_mark(INTERACTION_TRACE_TTS_FIRST_BYTE);
+    
+    for (size_t i = 0; i < len && s->state != AUDIO_SCAN_DONE && s->err == ESP_OK; ++i) {
+        char c = (char)data[i];
+        switch (s->state) {
+        case AUDIO_SCAN_KEY:
+            if (c == AUDIO_CONTENT_KEY[s->key_match]) {
+                if (++s->key_match == sizeof(AUDIO_CONTENT_KEY) - 1) {
+                    s->state = AUDIO_SCAN_OPEN_QUOTE;
+                }
+            } else {
+                s->key_match = (c == '"') ? 1 : 0;
+            }
+            break;
+        case AUDIO_SCAN_OPEN_QUOTE:
+            if (c == '"') {
+                s->state = AUDIO_SCAN_VALUE;
+            } else if (c != ':' && c != ' ' && c != '\t' && c != '\r' && c != '\n') {
+                // Key appeared somewhere other than as a member name; keep looking
+                s->state = AUDIO_SCAN_KEY;
+                s->key_match = 0;
+            }
+            break;
+        case AUDIO_SCAN_VALUE: {
+            if (c == '"') {
+                audio_stream_finish_quad(s);
+                audio_stream_flush(s);
+                s->state = AUDIO_SCAN_DONE;
+                break;
+            }
+            int v = b64_value(c);
+            if (v < 0) {
+                break;  // '=', '\' of an escaped '/', whitespace
+            }
+            s->quad = (s->quad << 6) | (uint32_t)v;
+            if (++s->quad_len == 4) {
+                uint8_t bytes[3] = {
+                    (uint8_t)(s->quad >> 16),
+                    (uint8_t)(s->quad >> 8),
+                    (uint8_t)s->quad,
+                };
+                audio_stream_emit(s, bytes, sizeof(bytes));
+                s->quad = 0;
+                s->quad_len = 0;
+            }
+            break;
+        }
+        case AUDIO_SCAN_DONE:
+            break;
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t gemini_tts_generate_stream(const char *text, const char *voice, gemini_tts_chunk_cb_t on_chunk, void *ctx)
+{
+    ESP_RETURN_ON_FALSE(text && on_chunk, ESP_ERR_INVALID_ARG, TAG, "bad args");
+    
+    ESP_LOGI(TAG, "🔊 [Gemini TTS] Streaming speech: \"%.100s%s\" (voice: %s)", 
+             text, strlen(text) > 100 ? "..." : "", voice && voice[0] ? voice : "default");
+    
+    char *payload = build_tts_payload(text, voice);
+    ESP_RETURN_ON_FALSE(payload, ESP_ERR_NO_MEM, TAG, "payload");
+    
+    audio_content_stream_t *stream = interaction_arena_calloc(1, sizeof(*stream));
+    if (!stream) {
+        cJSON_free(payload);
+        return ESP_ERR_NO_MEM;
+    }
+    stream->on_chunk = on_chunk;
+    stream->ctx = ctx;
+    
+    char url[512];
+    snprintf(url, sizeof(url), "%s?key=%s", TEXT_TO_SPEECH_URL, GEMINI_API_KEY_STRING);
+    const https_pool_request_t req = {
+        .url = url,
+        .body = payload,
+        .body_len = strlen(payload),
+        .headers = JSON_HEADERS,
+        .header_count = sizeof(JSON_HEADERS) / sizeof(JSON_HEADERS[0]),
+        .on_data = audio_content_sink,
+        .ctx = stream,
+    };
+    
+    int64_t start_time = esp_timer_get_time();
+    int status = 0;
+    esp_err_t ret = gemini_post(&req, &status);
+    int64_t elapsed_us = esp_timer_get_time() - start_time;
+    
+    if (ret == ESP_OK && status / 100 != 2) {
+        ESP_LOGE(TAG, "❌ [Gemini TTS] HTTP error %d", status);
+        ret = ESP_FAIL;
+    } else if (ret == ESP_OK && stream->err != ESP_OK) {
+        ESP_LOGE(TAG, "❌ [Gemini TTS] Chunk consumer failed: %s", esp_err_to_name(stream->err));
+        ret = stream->err;
+    } else if (ret == ESP_OK && stream->state != AUDIO_SCAN_DONE) {
+        ESP_LOGE(TAG, "❌ [Gemini TTS] No complete audioContent in response");
+        ret = ESP_FAIL;
+    }
+    if (ret == ESP_OK) {
+        ESP_LOGI(TAG, "✅ [Gemini TTS] Streamed %zu bytes audio (took %lld ms)", stream->total, elapsed_us / 1000);
+    }
+    
+    interaction_arena_free(stream);
+    cJSON_free(payload);
+    return ret;
+}
+
+esp_err_t gemini_prewarm(void)
+{
+    // In request order, so STT is ready first; the key is not needed to open a socket
+    const char *urls[] = {SPEECH_TO_TEXT_URL, GEMINI_STREAM_URL, TEXT_TO_SPEECH_URL};
+    esp_err_t ret = ESP_OK;
+    int64_t start_us = esp_timer_get_time();
+#if CONFIG_KVA_HTTP2_GOOGLEAPIS
+    // Over HTTP/2 one handshake covers all three hosts
+    ret = h2_transport_prewarm(urls[0]);
+    if (ret != ESP_ERR_NOT_SUPPORTED) {
+        ESP_LOGI(TAG, "🔥 [Gemini] HTTP/2 connection prewarmed in %lld ms", (esp_timer_get_time() - start_us) / 1000);
+        return ret;
+    }
+    ret = ESP_OK;
+#endif
+    for (size_t i = 0; i < sizeof(urls) / sizeof(urls[0]); ++i) {
+        esp_err_t err = https_pool_prewarm(urls[i]);
+        if (err != ESP_OK && ret == ESP_OK) {
+            ret = err;
+        }
+    }
+    ESP_LOGI(TAG, "🔥 [Gemini] Connections prewarmed in %lld ms", (esp_timer_get_time() - start_us) / 1000);
+    return ret;
+}
+
+// Realtime API: Gemini Live (BidiGenerateContent) over WebSocket
+static const char *GEMINI_LIVE_URL = GEMINI_WS_ORIGIN "/ws/google.ai.generativelanguage.v1beta.GenerativeService.BidiGenerateContent";
+static const char *GEMINI_LIVE_MODEL = "models/gemini-2.0-flash-live-001";
+
+// Samples per queued chunk (32 ms at 16 kHz); a message carries one or more
+#define GEMINI_LIVE_CHUNK_SAMPLES 512
+// Holds speech captured while TLS and setup are still in flight (~2 s at
+// 16 kHz); the queue storage lives in PSRAM
+#define GEMINI_LIVE_QUEUE_DEPTH 64
+
+// Live only takes 16-bit PCM; the rate goes in the MIME type, so a poor
+// link can switch to half rate from one message to the next
+static const char LIVE_AUDIO_PREFIX_FMT[] = "{\"realtimeInput\":{\"audio\":{\"mimeType\":\"audio/pcm;rate=%d\",\"data\":\"";
+static const char LIVE_AUDIO_SUFFIX[] = "\"}}}";
+static const char LIVE_AUDIO_END[] = "{\"realtimeInput\":{\"audioStreamEnd\":true}}";
+
+// sample_count 0 marks the end of an utterance
+typedef struct {
+    int16_t samples[GEMINI_LIVE_CHUNK_SAMPLES];
+    size_t sample_count;
+} live_chunk_t;
+
 struct gemini_realtime_stream {
+    esp_websocket_client_handle_t ws_client;
     int sample_rate_hz;
     gemini_realtime_transcript_cb_t transcript_cb;
     gemini_realtime_error_cb_t error_cb;
     void *cb_ctx;
-    bool stop_requested;
+    volatile bool connected;
+    volatile bool setup_complete;     // Audio before setupComplete stays queued
+    volatile bool stop_requested;
+    TaskHandle_t task;                // Cleared by the task as it exits
+    int64_t start_us;
+    QueueHandle_t audio_queue;
+    live_chunk_t chunk;               // Owned by the audio task
+    // Messages are sized and their rate picked from the link quality
+    uplink_link_t link;
+    uplink_codec_encoder_t encoder;
+    int wire_rate_hz;
+    uint8_t *encoded;                 // PCM of one message, CONFIG_KVA_UPLINK_BATCH_MAX chunks
+    // realtimeInput frame, prefix rewritten when the rate changes
+    char *frame;
+    size_t frame_cap;
+    size_t frame_prefix_len;
+    // Reassembly of server messages split across WebSocket events
+    char *message_buffer;
+    size_t message_buffer_len;
+    size_t message_buffer_cap;
+    // Input transcription accumulated over the current turn
+    char transcript[GEMINI_MAX_TRANSCRIPT_CHARS];
+    size_t transcript_len;
 };
 
+static void live_send_setup(struct gemini_realtime_stream *stream)
+{
+    // Only the input transcription is used, so the model reply is capped at
+    // one token; turnComplete then follows the end of speech almost at once
+    char json[192];
+    size_t len = 0;
+    json_writer_t w;
+    json_writer_init(&w, json, sizeof(json));
+    json_writer_begin_object(&w, NULL);
+    json_writer_begin_object(&w, "setup");
+    json_writer_string(&w, "model", GEMINI_LIVE_MODEL);
+    json_writer_begin_object(&w, "generationConfig");
+    json_writer_begin_array(&w, "responseModalities");
+    json_writer_string(&w, NULL, "TEXT");
+    json_writer_end_array(&w);
+    json_writer_int(&w, "maxOutputTokens", 1);
+    json_writer_end_object(&w);
+    json_writer_begin_object(&w, "inputAudioTranscription");
+    json_writer_end_object(&w);
+    json_writer_end_object(&w);
+    json_writer_end_object(&w);
+    if (json_writer_finish(&w, &len) != ESP_OK) {
+        ESP_LOGE(TAG, "❌ [Gemini Live] Failed to build setup message");
+        return;
+    }
+    int sent = esp_websocket_client_send_text(stream->ws_client, json, len, portMAX_DELAY);
+    if (sent < 0) {
+        ESP_LOGE(TAG, "❌ [Gemini Live] Failed to send setup");
+    } else {
+        ESP_LOGI(TAG, "🎙️ [Gemini Live] Setup sent (%s)", GEMINI_LIVE_MODEL);
+    }
+}
+
+static void live_handle_message(struct gemini_realtime_stream *stream, const char *json)
+{
+    cJSON *msg = cJSON_Parse(json);
+    if (!msg) {
+        ESP_LOGW(TAG, "⚠️ [Gemini Live] Unparseable message: %.200s", json);
+        return;
+    }
+    
+    if (cJSON_GetObjectItem(msg, "setupComplete")) {
+        stream->setup_complete = true;
+        ESP_LOGI(TAG, "✅ [Gemini Live] Session ready after %lld ms, flushing %u buffered chunks",
+                 (esp_timer_get_time() - stream->start_us) / 1000,
+                 (unsigned)uxQueueMessagesWaiting(stream->audio_queue));
+    }
+    
+    cJSON *content = cJSON_GetObjectItem(msg, "serverContent");
+    if (content) {
+        cJSON *input = cJSON_GetObjectItem(content, "inputTranscription");
+        cJSON *text = input ? cJSON_GetObjectItem(input, "text") : NULL;
+        if (cJSON_IsString(text) && text->valuestring[0]) {
+            size_t room = sizeof(stream->transcript) - 1 - stream->transcript_len;
+            size_t n = strlen(text->valuestring);
+            n = n < room ? n : room;
+            memcpy(stream->transcript + stream->transcript_len, text->valuestring, n);
+            stream->transcript_len += n;
+            stream->transcript[stream->transcript_len] = '\0';
+            stream->transcript_cb(stream->transcript, false, stream->cb_ctx);
+        }
+        if (cJSON_IsTrue(cJSON_GetObjectItem(content, "turnComplete"))) {
+            if (stream->transcript_len) {
+                stream->transcript_cb(stream->transcript, true, stream->cb_ctx);
+            }
+            stream->transcript_len = 0;
+            stream->transcript[0] = '\0';
+        }
+    }
+    
+    cJSON *go_away = cJSON_GetObjectItem(msg, "goAway");
+    if (go_away) {
+        ESP_LOGW(TAG, "⚠️ [Gemini Live] Server closing session soon: %.200s", json);
+    }
+    
+    cJSON_Delete(msg);
+}
+
+static void live_websocket_event_handler(void *handler_args, esp_event_base_t base, int32_t event_id, void *event_data)
+{
+    struct gemini_realtime_stream *stream = (struct gemini_realtime_stream *)handler_args;
+    esp_websocket_event_data_t *data = (esp_websocket_event_data_t *)event_data;
+    
+    switch ((esp_websocket_event_id_t)event_id) {
+        case WEBSOCKET_EVENT_CONNECTED:
+            ESP_LOGI(TAG, "🎙️ [Gemini Live] WebSocket connected");
+            stream->connected = true;
+            stream->setup_complete = false;
+            stream->transcript_len = 0;
+            live_send_setup(stream);
+            break;
+            
+        case WEBSOCKET_EVENT_DISCONNECTED:
+            ESP_LOGW(TAG, "⚠️ [Gemini Live] WebSocket disconnected");
+            stream->connected = false;
+            stream->setup_complete = false;
+            if (stream->error_cb) {
+                stream->error_cb(ESP_FAIL, stream->cb_ctx);
+            }
+            break;
+            
+        case WEBSOCKET_EVENT_DATA:
+            if (data->op_code == 0x08) {
+                ESP_LOGW(TAG, "⚠️ [Gemini Live] Server closed session: %.*s", data->data_len, data->data_ptr);
+                stream->connected = false;
+                stream->setup_complete = false;
+                break;
+            }
+            // Server JSON arrives in binary frames as well as text frames
+            if ((data->op_code != 0x01 && data->op_code != 0x02 && data->op_code != 0x00) || data->data_len <= 0) {
+                break;
+            }
+            if (data->payload_offset == 0) {
+                stream->message_buffer_len = 0;
+            }
+            if (stream->message_buffer_len + data->data_len + 1 > stream->message_buffer_cap) {
+                size_t new_cap = stream->message_buffer_cap ? stream->message_buffer_cap : 1024;
+                while (new_cap < stream->message_buffer_len + data->data_len + 1) {
+                    new_cap *= 2;
+                }
+                char *new_buf = MEM_TAG_REALLOC(MEM_TAG_GEMINI, stream->message_buffer, new_cap);
+                if (!new_buf) {
+                    ESP_LOGE(TAG, "❌ [Gemini Live] No memory for %zu byte message", new_cap);
+                    stream->message_buffer_len = 0;
+                    break;
+                }
+                stream->message_buffer = new_buf;
+                stream->message_buffer_cap = new_cap;
+            }
+            memcpy(stream->message_buffer + stream->message_buffer_len, data->data_ptr, data->data_len);
+            stream->message_buffer_len += data->data_len;
+            stream->message_buffer[stream->message_buffer_len] = '\0';
+            if (data->payload_offset + data->data_len >= data->payload_len) {
+                live_handle_message(stream, stream->message_buffer);
+                stream->message_buffer_len = 0;
+            }
+            break;
+            
+        case WEBSOCKET_EVENT_ERROR:
+            ESP_LOGE(TAG, "❌ [Gemini Live] WebSocket error");
+            if (stream->error_cb) {
+                stream->error_cb(ESP_FAIL, stream->cb_ctx);
+            }
+            break;
+            
+        default:
+            break;
+    }
+    (void)base;
+}
+
+static void live_set_wire_rate(struct gemini_realtime_stream *stream, int rate_hz)
+{
+    if (rate_hz == stream->wire_rate_hz) {
+        return;
+    }
+    uplink_codec_init(&stream->encoder, UPLINK_CODEC_PCM16, stream->sample_rate_hz, rate_hz);
+    stream->frame_prefix_len = (size_t)snprintf(stream->frame, stream->frame_cap, LIVE_AUDIO_PREFIX_FMT, rate_hz);
+    stream->wire_rate_hz = rate_hz;
+}
+
+static void live_send_end(struct gemini_realtime_stream *stream)
+{
+    if (esp_websocket_client_send_text(stream->ws_client, LIVE_AUDIO_END, sizeof(LIVE_AUDIO_END) - 1,
+                                       pdMS_TO_TICKS(100)) < 0) {
+        ESP_LOGW(TAG, "⚠️ [Gemini Live] Audio end send failed");
+    }
+}
+
+// Encodes queued PCM into realtimeInput frames on the uplink core
+static void live_audio_task(void *arg)
+{
+    struct gemini_realtime_stream *stream = (struct gemini_realtime_stream *)arg;
+    live_chunk_t *chunk = &stream->chunk;
+    const uint32_t chunk_ms = GEMINI_LIVE_CHUNK_SAMPLES * 1000 / (uint32_t)stream->sample_rate_hz;
+    
+    while (!stream->stop_requested) {
+        // Until the session is ready, audio waits in the queue and is flushed in order
+        if (!stream->connected || !stream->setup_complete) {
+            vTaskDelay(pdMS_TO_TICKS(10));
+            continue;
+        }
+        if (xQueueReceive(stream->audio_queue, chunk, pdMS_TO_TICKS(100)) != pdTRUE) {
+            continue;
+        }
+        if (chunk->sample_count == 0) {
+            live_send_end(stream);
+            continue;
+        }
+        
+        size_t queued = uxQueueMessagesWaiting(stream->audio_queue);
+        uplink_link_level_t level = uplink_link_update(&stream->link, queued);
+        bool halve = level == UPLINK_LINK_POOR && stream->sample_rate_hz % 2 == 0;
+        live_set_wire_rate(stream, halve ? stream->sample_rate_hz / 2 : stream->sample_rate_hz);
+        size_t batch = uplink_link_batch(&stream->link, queued);
+        size_t samples = 0;
+        size_t bytes = 0;
+        bool end = false;
+        for (size_t i = 1;; ++i) {
+            bytes += uplink_codec_encode(&stream->encoder, chunk->samples, chunk->sample_count, stream->encoded + bytes);
+            samples += chunk->sample_count;
+            if (i == batch) {
+                break;
+            }
+            // A good link's batch waits for the audio still being spoken; a catch-up one takes what is queued
+            TickType_t wait = level == UPLINK_LINK_GOOD ? pdMS_TO_TICKS(2 * chunk_ms) : 0;
+            if (xQueueReceive(stream->audio_queue, chunk, wait) != pdTRUE) {
+                break;
+            }
+            if (chunk->sample_count == 0) {
+                end = true;
+                break;
+            }
+        }
+        
+        size_t b64_len = 0;
+        size_t suffix_len = sizeof(LIVE_AUDIO_SUFFIX) - 1;
+        int ret = mbedtls_base64_encode((unsigned char *)stream->frame + stream->frame_prefix_len,
+                                        stream->frame_cap - stream->frame_prefix_len - suffix_len, &b64_len,
+                                        stream->encoded, bytes);
+        if (ret != 0) {
+            ESP_LOGW(TAG, "⚠️ [Gemini Live] Base64 failed: %d", ret);
+        } else {
+            memcpy(stream->frame + stream->frame_prefix_len + b64_len, LIVE_AUDIO_SUFFIX, suffix_len);
+            int64_t send_start_us = esp_timer_get_time();
+            bool sent = esp_websocket_client_send_text(stream->ws_client, stream->frame,
+                                                       stream->frame_prefix_len + b64_len + suffix_len,
+                                                       pdMS_TO_TICKS(100)) >= 0;
+            uplink_link_note_send(&stream->link, (uint32_t)(samples * 1000 / (size_t)stream->sample_rate_hz),
+                                  esp_timer_get_time() - send_start_us, sent);
+            if (!sent) {
+                ESP_LOGW(TAG, "⚠️ [Gemini Live] Audio send failed");
+            } else {
+                interaction_trace_mark(INTERACTION_TRACE_UPLINK_FIRST_BYTE);
+            }
+        }
+        if (end) {
+            live_send_end(stream);
+        }
+    }
+    
+    stream->task = NULL;
+    task_placement_note_exit(TASK_PLACEMENT_GEMINI_LIVE_UPLINK);
+    vTaskDelete(NULL);
+}
+
+static void live_stream_free(struct gemini_realtime_stream *stream)
+{
+    if (stream->ws_client) {
+        esp_websocket_client_stop(stream->ws_client);
+        esp_websocket_client_destroy(stream->ws_client);
+    }
+    if (stream->audio_queue) {
+        vQueueDeleteWithCaps(stream->audio_queue);
+    }
+    MEM_TAG_FREE(MEM_TAG_GEMINI, stream->message_buffer);
+    MEM_TAG_FREE(MEM_TAG_GEMINI, stream->encoded);
+    MEM_TAG_FREE(MEM_TAG_GEMINI, stream->frame);
+    MEM_TAG_FREE(MEM_TAG_GEMINI, stream);
+}
+
 gemini_realtime_handle_t gemini_realtime_start(int sample_rate_hz,
                                                 gemini_realtime_transcript_cb_t transcript_cb,
                                                 gemini_realtime_error_cb_t error_cb,
@@ -673,9 +1287,8 @@ gemini_realtime_handle_t gemini_realtime_start(int sample_rate_hz,
 {
     ESP_RETURN_ON_FALSE(sample_rate_hz > 0 && sample_rate_hz <= 48000 && transcript_cb, NULL, TAG, "bad args");
     ESP_LOGI(TAG, "🎙️ [Gemini Live] Starting realtime stream @ %d Hz", sample_rate_hz);
-    ESP_LOGI(TAG, "🎙️ [Gemini Live] NOTE: Currently using batch STT mode (realtime API placeholder)");
     
-    struct gemini_realtime_stream *stream = calloc(1, sizeof(struct gemini_realtime_stream));
+    struct gemini_realtime_stream *stream = MEM_TAG_CALLOC(MEM_TAG_GEMINI, 1, sizeof(struct gemini_realtime_stream));
     if (!stream) {
         ESP_LOGE(TAG, "❌ [Gemini Live] Failed to allocate stream");
         return NULL;
@@ -684,26 +1297,88 @@ gemini_realtime_handle_t gemini_realtime_start(int sample_rate_hz,
     stream->transcript_cb = transcript_cb;
     stream->error_cb = error_cb;
     stream->cb_ctx = cb_ctx;
-    stream->stop_requested = false;
+    stream->start_us = esp_timer_get_time();
+    
+    // One frame buffer for every audio message (~1.5 KB per 512 samples at
+    // full rate), sized for the largest batch
+    uplink_codec_init(&stream->encoder, UPLINK_CODEC_PCM16, sample_rate_hz, sample_rate_hz);
+    size_t encoded_cap = uplink_codec_max_encoded_bytes(&stream->encoder,
+                                                        (size_t)GEMINI_LIVE_CHUNK_SAMPLES * CONFIG_KVA_UPLINK_BATCH_MAX);
+    char prefix[128];
+    int prefix_len = snprintf(prefix, sizeof(prefix), LIVE_AUDIO_PREFIX_FMT, sample_rate_hz);
+    stream->frame_cap = prefix_len + (encoded_cap + 2) / 3 * 4 + sizeof(LIVE_AUDIO_SUFFIX);
+    stream->frame = MEM_TAG_MALLOC(MEM_TAG_GEMINI, stream->frame_cap);
+    stream->encoded = MEM_TAG_MALLOC(MEM_TAG_GEMINI, encoded_cap);
+    stream->audio_queue = xQueueCreateWithCaps(GEMINI_LIVE_QUEUE_DEPTH, sizeof(live_chunk_t),
+                                               MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!stream->frame || !stream->encoded || !stream->audio_queue) {
+        ESP_LOGE(TAG, "❌ [Gemini Live] Failed to allocate audio buffers");
+        live_stream_free(stream);
+        return NULL;
+    }
+    live_set_wire_rate(stream, sample_rate_hz);
+    uplink_link_init(&stream->link, "Gemini Live", GEMINI_LIVE_QUEUE_DEPTH);
+    
+    char url[512];
+    snprintf(url, sizeof(url), "%s?key=%s", GEMINI_LIVE_URL, GEMINI_API_KEY_STRING);
+    esp_websocket_client_config_t ws_cfg = {
+        .uri = url,
+        .crt_bundle_attach = esp_crt_bundle_attach,
+        .buffer_size = 2048,
+    };
+    stream->ws_client = esp_websocket_client_init(&ws_cfg);
+    if (!stream->ws_client) {
+        ESP_LOGE(TAG, "❌ [Gemini Live] WebSocket init failed");
+        live_stream_free(stream);
+        return NULL;
+    }
+    esp_websocket_register_events(stream->ws_client, WEBSOCKET_EVENT_ANY, live_websocket_event_handler, stream);
+    
+    esp_err_t err = esp_websocket_client_start(stream->ws_client);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "❌ [Gemini Live] WebSocket start failed: %s", esp_err_to_name(err));
+        live_stream_free(stream);
+        return NULL;
+    }
+    
+    // Base64 and sends happen off the AFE core
+    if (task_placement_create(TASK_PLACEMENT_GEMINI_LIVE_UPLINK, live_audio_task, stream, &stream->task) != pdPASS) {
+        ESP_LOGE(TAG, "❌ [Gemini Live] Audio task create failed");
+        live_stream_free(stream);
+        return NULL;
+    }
+    
     ESP_LOGI(TAG, "✅ [Gemini Live] Stream initialized");
     return (gemini_realtime_handle_t)stream;
 }
 
 esp_err_t gemini_realtime_send_audio(gemini_realtime_handle_t handle, const int16_t *pcm_samples, size_t sample_count)
 {
-    if (!handle) {
-        return ESP_ERR_INVALID_ARG;
-    }
+    ESP_RETURN_ON_FALSE(handle && pcm_samples && sample_count > 0, ESP_ERR_INVALID_ARG, TAG, "bad args");
     struct gemini_realtime_stream *stream = (struct gemini_realtime_stream *)handle;
     
-    // For now, batch process audio chunks
-    // In the future, this could buffer and send to streaming API
-    float duration_sec = stream->sample_rate_hz > 0 ? (float)sample_count / stream->sample_rate_hz : 0.0f;
-    ESP_LOGD(TAG, "🎙️ [Gemini Live] Audio chunk: %zu samples @ %d Hz (%.2f sec, batch mode)", 
-             sample_count, stream->sample_rate_hz, duration_sec);
+    // Called from the AFE loop: copy into the queue and never wait on the network
+    live_chunk_t chunk;
+    for (size_t i = 0; i < sample_count; i += GEMINI_LIVE_CHUNK_SAMPLES) {
+        size_t n = sample_count - i < GEMINI_LIVE_CHUNK_SAMPLES ? sample_count - i : GEMINI_LIVE_CHUNK_SAMPLES;
+        memcpy(chunk.samples, pcm_samples + i, n * sizeof(int16_t));
+        chunk.sample_count = n;
+        if (xQueueSend(stream->audio_queue, &chunk, 0) != pdTRUE) {
+            ESP_LOGW(TAG, "⚠️ [Gemini Live] Audio queue full, dropping %zu samples", sample_count - i);
+            return ESP_ERR_TIMEOUT;
+        }
+    }
     return ESP_OK;
 }
 
+esp_err_t gemini_realtime_end_audio(gemini_realtime_handle_t handle)
+{
+    ESP_RETURN_ON_FALSE(handle, ESP_ERR_INVALID_ARG, TAG, "bad args");
+    struct gemini_realtime_stream *stream = (struct gemini_realtime_stream *)handle;
+    live_chunk_t end = {.sample_count = 0};
+    return xQueueSend(stream->audio_queue, &end, 0) == pdTRUE ? ESP_OK : ESP_ERR_TIMEOUT;
+}
+
 esp_err_t gemini_realtime_stop(gemini_realtime_handle_t handle)
 {
     if (!handle) {
@@ -712,7 +1387,11 @@ esp_err_t gemini_realtime_stop(gemini_realtime_handle_t handle)
     ESP_LOGI(TAG, "🎙️ [Gemini Live] Stopping realtime stream");
     struct gemini_realtime_stream *stream = (struct gemini_realtime_stream *)handle;
     stream->stop_requested = true;
-    free(stream);
+    // The audio task notices within one queue timeout plus one send
+    while (stream->task) {
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+    live_stream_free(stream);
     ESP_LOGI(TAG, "✅ [Gemini Live] Stream stopped");
     return ESP_OK;
 }
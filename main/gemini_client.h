@@ -5,6 +5,7 @@
 #include <stdint.h>
 
 #include "esp_err.h"
+#include "uplink_codec.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -16,29 +17,58 @@ typedef struct {
     char text[GEMINI_MAX_TRANSCRIPT_CHARS];
 } gemini_transcription_t;
 
+// Receives consecutive pieces of a synthesized WAV as they download
+typedef esp_err_t (*gemini_tts_chunk_cb_t)(const uint8_t *data, size_t len, void *ctx);
+
+// Receives each piece of LLM text as it streams; text is only valid during the call
+typedef void (*gemini_text_delta_cb_t)(const char *text, void *ctx);
+
 // Callback for realtime transcription events
 typedef void (*gemini_realtime_transcript_cb_t)(const char *text, bool is_final, void *ctx);
 typedef void (*gemini_realtime_error_cb_t)(esp_err_t error, void *ctx);
 
 // STT: Speech-to-Text using Google Speech-to-Text API
 esp_err_t gemini_transcribe_wav(const int16_t *pcm_samples, size_t sample_count, int sample_rate_hz, gemini_transcription_t *result);
+// Same, with the audio encoded on the wire as codec (e.g. mu-law halves the upload)
+esp_err_t gemini_transcribe_audio(const int16_t *pcm_samples, size_t sample_count, int sample_rate_hz,
+                                  uplink_codec_id_t codec, gemini_transcription_t *result);
 
 // LLM: Chat completions using Gemini API with function calling support
 esp_err_t gemini_generate_text_response(const char *prompt, char *out_text, size_t out_len);
 esp_err_t gemini_generate_text_response_with_tools(const char *prompt, const char *device_state_json, char *out_text, size_t out_len);
+// Streaming LLM: on_delta sees text as it is generated; out_text receives the whole reply.
+// Replies that call a tool are resolved with the blocking path and delivered in one delta.
+esp_err_t gemini_generate_text_response_stream(const char *prompt, const char *device_state_json,
+                                               gemini_text_delta_cb_t on_delta, void *ctx,
+                                               char *out_text, size_t out_len);
+
+// Names the synthesis settings below (LINEAR16, 24 kHz); change it with them so cached speech is re-rendered
+#define GEMINI_TTS_MODEL "google-tts-linear16-24k"
 
 // TTS: Text-to-Speech using Google Text-to-Speech API
 esp_err_t gemini_tts_generate(const char *text, const char *voice, uint8_t *out_wav, size_t max_out, size_t *bytes_written);
+// Streaming TTS: audioContent is base64-decoded on the fly and handed to on_chunk
+esp_err_t gemini_tts_generate_stream(const char *text, const char *voice, gemini_tts_chunk_cb_t on_chunk, void *ctx);
 
-// Realtime API: Stream audio to Gemini via WebSocket (if supported)
-// For now, we'll use batch STT, but this can be extended for streaming
+// Open the STT, LLM and TTS connections ahead of a request (e.g. on wake word);
+// blocks for the handshakes, so call it from a worker task
+esp_err_t gemini_prewarm(void);
+
+// Realtime API: Gemini Live session over WebSocket. Audio is uploaded while the
+// user speaks; input transcription arrives as partials and a final per turn.
 typedef struct gemini_realtime_stream *gemini_realtime_handle_t;
 
 gemini_realtime_handle_t gemini_realtime_start(int sample_rate_hz,
                                                 gemini_realtime_transcript_cb_t transcript_cb,
                                                 gemini_realtime_error_cb_t error_cb,
                                                 void *cb_ctx);
+// Queue 16-bit PCM without blocking. Audio sent before the session is ready is
+// held (up to ~2 s) and flushed once setup completes, so a session can be
+// started at speech onset without losing the first words
+
 esp_err_t gemini_realtime_send_audio(gemini_realtime_handle_t handle, const int16_t *pcm_samples, size_t sample_count);
+// Local VAD saw the end of speech; lets the server close the turn without waiting for silence
+esp_err_t gemini_realtime_end_audio(gemini_realtime_handle_t handle);
 esp_err_t gemini_realtime_stop(gemini_realtime_handle_t handle);
 
 #ifdef __cplusplus
@@ -0,0 +1,774 @@
+#include "h2_transport.h"
+
+#include <ctype.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/select.h>
+
+#include "esp_check.h"
+#include "esp_crt_bundle.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_tls.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "interaction_cancel.h"
+#include "kva_config_defaults.h"
+#include "mbedtls/ssl.h"
+#include "mem_tags.h"
+#include "nghttp2/nghttp2.h"
+#include "sdkconfig.h"
+
+static const char *TAG = "h2_transport";
+
+// Hosts the one connection may carry; the server's certificate covers them all
+#define H2_HOST_SUFFIX ".googleapis.com"
+#define H2_PORT 443
+#define HOST_MAX_LEN 64
+#define HEADER_NAME_MAX_LEN 32
+// :method, :scheme, :authority, :path, content-length and the caller's
+#define H2_MAX_NV (5 + HTTPS_POOL_MAX_HEADERS)
+// Longest socket wait while holding the lock, so other streams get it back soon
+#define H2_POLL_MS 20
+// Response bytes per on_data call; each is a point where a cancel is noticed
+#define DELIVER_CHUNK_LEN 512
+// Streamed request body waiting for the connection
+#define TX_RING_LEN 4096
+#define READ_BUF_LEN 2048
+static const int DEFAULT_TIMEOUT_MS = 60000;
+static const int CONNECT_TIMEOUT_MS = 10000;
+
+typedef struct {
+    uint8_t *buf;
+    size_t cap;
+    size_t head;
+    size_t len;
+} ring_t;
+
+typedef struct {
+    bool used;
+    int32_t id;
+    const https_pool_request_t *req;
+    size_t body_sent;                 // Handed to nghttp2 so far
+    bool deferred;                    // The body ran dry; resumed when the writer adds more
+    ring_t tx;                        // Streamed body only
+    ring_t rx;                        // Response not yet delivered; as large as the stream window
+    int status;
+    size_t bytes_received;
+    bool closed;
+    uint32_t error_code;              // From RST_STREAM or GOAWAY once closed
+    bool conn_lost;                   // Closed because the connection went away
+} h2_stream_t;
+
+static struct {
+    SemaphoreHandle_t lock;           // Held for any use of the session, the socket or a stream
+    esp_tls_t *tls;
+    int fd;
+    nghttp2_session *session;
+    char host[HOST_MAX_LEN];          // Host the connection was opened to
+    bool declined;                    // ALPN did not pick h2; until close_all
+    bool goaway;                      // No new streams; open ones may finish
+    int64_t last_used_us;
+    size_t active;
+#if CONFIG_ESP_TLS_CLIENT_SESSION_TICKETS
+    esp_tls_client_session_t *ticket;
+#endif
+    h2_stream_t streams[CONFIG_KVA_HTTP2_MAX_STREAMS];
+    uint8_t read_buf[READ_BUF_LEN];
+} s_h2;
+static portMUX_TYPE s_init_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static size_t ring_put(ring_t *r, const uint8_t *data, size_t len)
+{
+    size_t n = 0;
+    while (n < len && r->len < r->cap) {
+        size_t tail = (r->head + r->len) % r->cap;
+        // Free space runs to the end of the buffer or up to head
+        size_t run = tail >= r->head ? r->cap - tail : r->head - tail;
+        run = run < len - n ? run : len - n;
+        memcpy(r->buf + tail, data + n, run);
+        r->len += run;
+        n += run;
+    }
+    return n;
+}
+
+static size_t ring_get(ring_t *r, uint8_t *out, size_t len)
+{
+    size_t n = 0;
+    while (n < len && r->len > 0) {
+        size_t run = r->cap - r->head;
+        run = run < r->len ? run : r->len;
+        run = run < len - n ? run : len - n;
+        memcpy(out + n, r->buf + r->head, run);
+        r->head = (r->head + run) % r->cap;
+        r->len -= run;
+        n += run;
+    }
+    return n;
+}
+
+static esp_err_t ensure_lock(void)
+{
+    if (s_h2.lock) {
+        return ESP_OK;
+    }
+    SemaphoreHandle_t lock = xSemaphoreCreateMutex();
+    ESP_RETURN_ON_FALSE(lock, ESP_ERR_NO_MEM, TAG, "mutex");
+    portENTER_CRITICAL(&s_init_lock);
+    if (!s_h2.lock) {
+        s_h2.lock = lock;
+        lock = NULL;
+    }
+    portEXIT_CRITICAL(&s_init_lock);
+    if (lock) {
+        vSemaphoreDelete(lock);
+    }
+    return ESP_OK;
+}
+
+// ESP_ERR_NOT_SUPPORTED for anything this transport does not carry
+static esp_err_t parse_url(const char *url, char *host, size_t host_len, const char **path)
+{
+    static const char scheme[] = "https://";
+    if (strncmp(url, scheme, sizeof(scheme) - 1) != 0) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    const char *start = url + sizeof(scheme) - 1;
+    size_t len = strcspn(start, ":/?#");
+    size_t suffix_len = strlen(H2_HOST_SUFFIX);
+    if (start[len] == ':' || len >= host_len || len <= suffix_len ||
+        memcmp(start + len - suffix_len, H2_HOST_SUFFIX, suffix_len) != 0) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    memcpy(host, start, len);
+    host[len] = '\0';
+    *path = start[len] == '/' ? start + len : "/";
+    return ESP_OK;
+}
+
+static bool idle_expired(int64_t now_us)
+{
+    return now_us - s_h2.last_used_us > (int64_t)HTTPS_POOL_IDLE_TIMEOUT_MS * 1000;
+}
+
+/* nghttp2 callbacks; all run under the lock, from conn_pump() */
+
+static ssize_t on_send(nghttp2_session *session, const uint8_t *data, size_t len, int flags, void *user_data)
+{
+    ssize_t written = esp_tls_conn_write(s_h2.tls, data, len);
+    if (written == ESP_TLS_ERR_SSL_WANT_READ || written == ESP_TLS_ERR_SSL_WANT_WRITE) {
+        return NGHTTP2_ERR_WOULDBLOCK;
+    }
+    return written > 0 ? written : NGHTTP2_ERR_CALLBACK_FAILURE;
+}
+
+static int on_header(nghttp2_session *session, const nghttp2_frame *frame, const uint8_t *name, size_t namelen,
+                     const uint8_t *value, size_t valuelen, uint8_t flags, void *user_data)
+{
+    if (frame->hd.type != NGHTTP2_HEADERS || frame->headers.cat != NGHTTP2_HCAT_RESPONSE) {
+        return 0;
+    }
+    h2_stream_t *s = nghttp2_session_get_stream_user_data(session, frame->hd.stream_id);
+    if (s && namelen == 7 && memcmp(name, ":status", 7) == 0) {
+        int status = 0;
+        for (size_t i = 0; i < valuelen && isdigit(value[i]); ++i) {
+            status = status * 10 + (value[i] - '0');
+        }
+        s->status = status;
+    }
+    return 0;
+}
+
+static int on_data_chunk(nghttp2_session *session, uint8_t flags, int32_t stream_id, const uint8_t *data,
+                         size_t len, void *user_data)
+{
+    h2_stream_t *s = nghttp2_session_get_stream_user_data(session, stream_id);
+    if (!s) {
+        // A stream we reset: nobody reads it, but it still counts against the connection
+        nghttp2_session_consume_connection(session, len);
+        return 0;
+    }
+    s->bytes_received += len;
+    // Fits unless the server overran the window, which only reopens as the ring drains
+    if (ring_put(&s->rx, data, len) < len) {
+        ESP_LOGW(TAG, "stream %" PRId32 " overran its window", stream_id);
+        nghttp2_submit_rst_stream(session, NGHTTP2_FLAG_NONE, stream_id, NGHTTP2_FLOW_CONTROL_ERROR);
+    }
+    return 0;
+}
+
+static int on_stream_close(nghttp2_session *session, int32_t stream_id, uint32_t error_code, void *user_data)
+{
+    h2_stream_t *s = nghttp2_session_get_stream_user_data(session, stream_id);
+    if (s) {
+        s->closed = true;
+        s->error_code = error_code;
+    }
+    return 0;
+}
+
+static int on_frame_recv(nghttp2_session *session, const nghttp2_frame *frame, void *user_data)
+{
+    if (frame->hd.type == NGHTTP2_GOAWAY) {
+        // Streams above last_stream_id are closed with REFUSED_STREAM by nghttp2
+        ESP_LOGI(TAG, "%s: GOAWAY (error %" PRIu32 ")", s_h2.host, frame->goaway.error_code);
+        s_h2.goaway = true;
+    }
+    return 0;
+}
+
+static ssize_t on_body_read(nghttp2_session *session, int32_t stream_id, uint8_t *buf, size_t length,
+                            uint32_t *data_flags, nghttp2_data_source *source, void *user_data)
+{
+    h2_stream_t *s = source->ptr;
+    const https_pool_request_t *req = s->req;
+    size_t n;
+    if (req->write_body) {
+        n = ring_get(&s->tx, buf, length);
+        if (n == 0 && s->body_sent < req->body_len) {
+            s->deferred = true;
+            return NGHTTP2_ERR_DEFERRED;
+        }
+    } else {
+        n = req->body_len - s->body_sent;
+        n = n < length ? n : length;
+        memcpy(buf, req->body + s->body_sent, n);
+    }
+    s->body_sent += n;
+    if (s->body_sent == req->body_len) {
+        *data_flags |= NGHTTP2_DATA_FLAG_EOF;
+    }
+    return (ssize_t)n;
+}
+
+/* Connection; everything below runs under the lock */
+
+static void conn_close(const char *why, bool goaway)
+{
+    for (size_t i = 0; i < CONFIG_KVA_HTTP2_MAX_STREAMS; ++i) {
+        h2_stream_t *s = &s_h2.streams[i];
+        if (s->used && !s->closed) {
+            s->closed = true;
+            s->conn_lost = true;
+        }
+    }
+    if (s_h2.session) {
+        if (goaway) {
+            nghttp2_session_terminate_session(s_h2.session, NGHTTP2_NO_ERROR);
+            nghttp2_session_send(s_h2.session);
+        }
+        nghttp2_session_del(s_h2.session);
+        s_h2.session = NULL;
+    }
+    if (s_h2.tls) {
+        esp_tls_conn_destroy(s_h2.tls);
+        s_h2.tls = NULL;
+        ESP_LOGI(TAG, "%s: connection closed (%s)", s_h2.host, why);
+    }
+    s_h2.goaway = false;
+}
+
+static esp_err_t conn_open(const char *host)
+{
+    static const char *alpn[] = {"h2", NULL};
+    int64_t start_us = esp_timer_get_time();
+    esp_tls_cfg_t cfg = {
+        .alpn_protos = alpn,
+        .crt_bundle_attach = esp_crt_bundle_attach,
+        .timeout_ms = CONNECT_TIMEOUT_MS,
+#if CONFIG_ESP_TLS_CLIENT_SESSION_TICKETS
+        .client_session = s_h2.ticket,
+#endif
+    };
+    s_h2.tls = esp_tls_init();
+    ESP_RETURN_ON_FALSE(s_h2.tls, ESP_ERR_NO_MEM, TAG, "tls");
+    strlcpy(s_h2.host, host, sizeof(s_h2.host));
+    if (esp_tls_conn_new_sync(host, (int)strlen(host), H2_PORT, &cfg, s_h2.tls) != 1) {
+        conn_close("connect failed", false);
+        return ESP_FAIL;
+    }
+
+    mbedtls_ssl_context *ssl = esp_tls_get_ssl_context(s_h2.tls);
+    const char *proto = ssl ? mbedtls_ssl_get_alpn_protocol(ssl) : NULL;
+    if (!proto || strcmp(proto, "h2") != 0) {
+        ESP_LOGW(TAG, "%s: server declined h2, staying on HTTP/1.1", host);
+        s_h2.declined = true;
+        conn_close("no h2", false);
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+#if CONFIG_ESP_TLS_CLIENT_SESSION_TICKETS
+    if (s_h2.ticket) {
+        esp_tls_free_client_session(s_h2.ticket);
+    }
+    s_h2.ticket = esp_tls_get_client_session(s_h2.tls);
+#endif
+    if (esp_tls_get_conn_sockfd(s_h2.tls, &s_h2.fd) != ESP_OK) {
+        conn_close("no socket", false);
+        return ESP_FAIL;
+    }
+
+    nghttp2_session_callbacks *cbs;
+    nghttp2_option *opt;
+    if (nghttp2_session_callbacks_new(&cbs) != 0) {
+        conn_close("no memory", false);
+        return ESP_ERR_NO_MEM;
+    }
+    if (nghttp2_option_new(&opt) != 0) {
+        nghttp2_session_callbacks_del(cbs);
+        conn_close("no memory", false);
+        return ESP_ERR_NO_MEM;
+    }
+    nghttp2_session_callbacks_set_send_callback(cbs, on_send);
+    nghttp2_session_callbacks_set_on_header_callback(cbs, on_header);
+    nghttp2_session_callbacks_set_on_data_chunk_recv_callback(cbs, on_data_chunk);
+    nghttp2_session_callbacks_set_on_stream_close_callback(cbs, on_stream_close);
+    nghttp2_session_callbacks_set_on_frame_recv_callback(cbs, on_frame_recv);
+    // Windows reopen as owners drain their rings, not as bytes arrive
+    nghttp2_option_set_no_auto_window_update(opt, 1);
+    int rv = nghttp2_session_client_new2(&s_h2.session, cbs, NULL, opt);
+    nghttp2_option_del(opt);
+    nghttp2_session_callbacks_del(cbs);
+    if (rv != 0) {
+        s_h2.session = NULL;
+        conn_close("no memory", false);
+        return ESP_ERR_NO_MEM;
+    }
+
+    const nghttp2_settings_entry settings[] = {
+        {NGHTTP2_SETTINGS_ENABLE_PUSH, 0},
+        {NGHTTP2_SETTINGS_MAX_CONCURRENT_STREAMS, CONFIG_KVA_HTTP2_MAX_STREAMS},
+        {NGHTTP2_SETTINGS_INITIAL_WINDOW_SIZE, CONFIG_KVA_HTTP2_STREAM_WINDOW},
+    };
+    nghttp2_submit_settings(s_h2.session, NGHTTP2_FLAG_NONE, settings, sizeof(settings) / sizeof(settings[0]));
+    // Room for every stream's full window at once
+    nghttp2_session_set_local_window_size(s_h2.session, NGHTTP2_FLAG_NONE, 0,
+                                          CONFIG_KVA_HTTP2_MAX_STREAMS * CONFIG_KVA_HTTP2_STREAM_WINDOW);
+    if (nghttp2_session_send(s_h2.session) != 0) {
+        conn_close("preface failed", false);
+        return ESP_FAIL;
+    }
+    s_h2.goaway = false;
+    ESP_LOGI(TAG, "%s: HTTP/2 connection up in %lld ms", host, (esp_timer_get_time() - start_us) / 1000);
+    return ESP_OK;
+}
+
+/**
+ * Send whatever nghttp2 has queued, wait up to wait_ms for the socket and
+ * feed one read to the session. A failure closes the connection, which
+ * closes every open stream.
+ */
+static esp_err_t conn_pump(int wait_ms)
+{
+    if (!s_h2.session) {
+        return ESP_FAIL;
+    }
+    if (nghttp2_session_send(s_h2.session) != 0) {
+        conn_close("send failed", false);
+        return ESP_FAIL;
+    }
+    // Records mbedTLS already decrypted are invisible to select()
+    if (esp_tls_get_bytes_avail(s_h2.tls) <= 0) {
+        fd_set readable;
+        FD_ZERO(&readable);
+        FD_SET(s_h2.fd, &readable);
+        struct timeval tv = {.tv_sec = 0, .tv_usec = wait_ms * 1000};
+        int ready = select(s_h2.fd + 1, &readable, NULL, NULL, &tv);
+        if (ready == 0) {
+            return ESP_OK;
+        }
+        if (ready < 0) {
+            conn_close("select failed", false);
+            return ESP_FAIL;
+        }
+    }
+    ssize_t got = esp_tls_conn_read(s_h2.tls, s_h2.read_buf, sizeof(s_h2.read_buf));
+    if (got == ESP_TLS_ERR_SSL_WANT_READ || got == ESP_TLS_ERR_SSL_WANT_WRITE) {
+        return ESP_OK;
+    }
+    if (got <= 0) {
+        conn_close(got == 0 ? "closed by server" : "read failed", false);
+        return ESP_FAIL;
+    }
+    if (nghttp2_session_mem_recv(s_h2.session, s_h2.read_buf, (size_t)got) < 0) {
+        conn_close("protocol error", false);
+        return ESP_FAIL;
+    }
+    // SETTINGS and PING acks, window updates, the reset of an overrun stream
+    if (nghttp2_session_send(s_h2.session) != 0) {
+        conn_close("send failed", false);
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+static uint8_t *ring_alloc(size_t len)
+{
+    uint8_t *buf = MEM_TAG_CAPS_MALLOC(MEM_TAG_GEMINI, len, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    return buf ? buf : MEM_TAG_MALLOC(MEM_TAG_GEMINI, len);
+}
+
+// A free slot with its rings; they are kept for the next request
+static h2_stream_t *stream_claim(const https_pool_request_t *req)
+{
+    for (size_t i = 0; i < CONFIG_KVA_HTTP2_MAX_STREAMS; ++i) {
+        h2_stream_t *s = &s_h2.streams[i];
+        if (s->used) {
+            continue;
+        }
+        if (!s->rx.buf) {
+            s->rx.buf = ring_alloc(CONFIG_KVA_HTTP2_STREAM_WINDOW);
+            s->rx.cap = CONFIG_KVA_HTTP2_STREAM_WINDOW;
+        }
+        if (req->write_body && !s->tx.buf) {
+            s->tx.buf = ring_alloc(TX_RING_LEN);
+            s->tx.cap = TX_RING_LEN;
+        }
+        if (!s->rx.buf || (req->write_body && !s->tx.buf)) {
+            return NULL;
+        }
+        ring_t rx = s->rx;
+        ring_t tx = s->tx;
+        memset(s, 0, sizeof(*s));
+        s->rx = (ring_t){.buf = rx.buf, .cap = rx.cap};
+        s->tx = (ring_t){.buf = tx.buf, .cap = tx.cap};
+        s->req = req;
+        s->used = true;
+        s_h2.active++;
+        return s;
+    }
+    return NULL;
+}
+
+// Give back n delivered bytes of window
+static void stream_consume(h2_stream_t *s, size_t n)
+{
+    if (n == 0 || !s_h2.session || s->conn_lost) {
+        return;
+    }
+    if (s->closed) {
+        nghttp2_session_consume_connection(s_h2.session, n);
+    } else {
+        nghttp2_session_consume(s_h2.session, s->id, n);
+    }
+}
+
+static void stream_release(h2_stream_t *s)
+{
+    if (s_h2.session && !s->closed && s->id > 0) {
+        // Cancelled or failed on our side; the connection stays up for the others
+        nghttp2_session_set_stream_user_data(s_h2.session, s->id, NULL);
+        nghttp2_submit_rst_stream(s_h2.session, NGHTTP2_FLAG_NONE, s->id, NGHTTP2_CANCEL);
+        s->closed = true;
+        nghttp2_session_send(s_h2.session);
+    }
+    stream_consume(s, s->rx.len);
+    s->used = false;
+    s->req = NULL;
+    s_h2.active--;
+    s_h2.last_used_us = esp_timer_get_time();
+}
+
+static nghttp2_nv make_nv(const char *name, const char *value)
+{
+    return (nghttp2_nv){(uint8_t *)name, (uint8_t *)value, strlen(name), strlen(value), NGHTTP2_NV_FLAG_NONE};
+}
+
+/**
+ * Take a stream on the connection (opened now if there is none) and submit
+ * the request headers; the body follows as the connection is pumped.
+ */
+static esp_err_t stream_open(const https_pool_request_t *req, const char *host, const char *path,
+                             h2_stream_t **out, bool *reused)
+{
+    xSemaphoreTake(s_h2.lock, portMAX_DELAY);
+    esp_err_t ret = ESP_OK;
+    if (s_h2.declined) {
+        ret = ESP_ERR_NOT_SUPPORTED;
+        goto done;
+    }
+    if (s_h2.session && s_h2.active == 0 && (s_h2.goaway || idle_expired(esp_timer_get_time()))) {
+        // The server has likely dropped it; reconnecting now is cheaper than a failed stream
+        conn_close(s_h2.goaway ? "drained" : "idle", !s_h2.goaway);
+    }
+    if (s_h2.session && s_h2.goaway) {
+        // Still draining other streams; this one goes over HTTP/1.1
+        ret = ESP_ERR_NOT_SUPPORTED;
+        goto done;
+    }
+    *reused = s_h2.session != NULL;
+    if (!s_h2.session) {
+        ret = conn_open(host);
+        if (ret != ESP_OK) {
+            goto done;
+        }
+    }
+
+    h2_stream_t *s = stream_claim(req);
+    if (!s) {
+        ESP_LOGD(TAG, "No free stream for %s", host);
+        ret = ESP_ERR_NOT_SUPPORTED;
+        goto done;
+    }
+
+    char content_length[16];
+    snprintf(content_length, sizeof(content_length), "%zu", req->body_len);
+    // HTTP/2 field names are lowercase
+    char names[HTTPS_POOL_MAX_HEADERS][HEADER_NAME_MAX_LEN];
+    nghttp2_nv nva[H2_MAX_NV];
+    size_t nv_count = 0;
+    nva[nv_count++] = make_nv(":method", "POST");
+    nva[nv_count++] = make_nv(":scheme", "https");
+    nva[nv_count++] = make_nv(":authority", host);
+    nva[nv_count++] = make_nv(":path", path);
+    nva[nv_count++] = make_nv("content-length", content_length);
+    for (size_t i = 0; i < req->header_count; ++i) {
+        size_t j = 0;
+        for (; req->headers[i].name[j] && j < HEADER_NAME_MAX_LEN - 1; ++j) {
+            names[i][j] = (char)tolower((unsigned char)req->headers[i].name[j]);
+        }
+        names[i][j] = '\0';
+        nva[nv_count++] = make_nv(names[i], req->headers[i].value);
+    }
+    const nghttp2_data_provider body = {
+        .source.ptr = s,
+        .read_callback = on_body_read,
+    };
+    int32_t id = nghttp2_submit_request(s_h2.session, NULL, nva, nv_count, &body, s);
+    if (id < 0) {
+        ESP_LOGE(TAG, "%s: submit failed (%s)", host, nghttp2_strerror(id));
+        stream_release(s);
+        ret = ESP_FAIL;
+        goto done;
+    }
+    s->id = id;
+    conn_pump(0);
+    *out = s;
+
+done:
+    xSemaphoreGive(s_h2.lock);
+    return ret;
+}
+
+static esp_err_t stream_write(https_pool_writer_t *writer, const void *data, size_t len)
+{
+    h2_stream_t *s = writer->transport;
+    const int timeout_ms = s->req->timeout_ms > 0 ? s->req->timeout_ms : DEFAULT_TIMEOUT_MS;
+    const uint8_t *p = (const uint8_t *)data;
+    int64_t last_progress_us = esp_timer_get_time();
+    while (len > 0) {
+        if (interaction_cancelled()) {
+            return ESP_ERR_INVALID_STATE;
+        }
+        xSemaphoreTake(s_h2.lock, portMAX_DELAY);
+        size_t n = s->closed ? 0 : ring_put(&s->tx, p, len);
+        if (n && s->deferred) {
+            s->deferred = false;
+            nghttp2_session_resume_data(s_h2.session, s->id);
+        }
+        bool closed = s->closed;
+        if (!closed) {
+            // A full ring waits for the socket or a window update
+            conn_pump(n ? 0 : H2_POLL_MS);
+        }
+        xSemaphoreGive(s_h2.lock);
+        ESP_RETURN_ON_FALSE(!closed, ESP_FAIL, TAG, "stream closed before the body was sent");
+
+        int64_t now_us = esp_timer_get_time();
+        if (n) {
+            p += n;
+            len -= n;
+            last_progress_us = now_us;
+        } else if (now_us - last_progress_us > (int64_t)timeout_ms * 1000) {
+            return ESP_ERR_TIMEOUT;
+        }
+    }
+    return ESP_OK;
+}
+
+/**
+ * Send the body (streamed bodies through the writer) and hand the response
+ * to on_data as it arrives. Other streams' data is read into their rings
+ * whenever this one pumps the connection.
+ */
+static esp_err_t stream_run(h2_stream_t *s, const https_pool_request_t *req)
+{
+    if (req->write_body) {
+        https_pool_writer_t writer = {
+            .write = stream_write,
+            .transport = s,
+            .remaining = req->body_len,
+        };
+        ESP_RETURN_ON_ERROR(req->write_body(&writer, req->body_ctx), TAG, "body");
+        ESP_RETURN_ON_FALSE(writer.remaining == 0, ESP_ERR_INVALID_SIZE, TAG, "body %zu bytes short",
+                            writer.remaining);
+    }
+
+    const int timeout_ms = req->timeout_ms > 0 ? req->timeout_ms : DEFAULT_TIMEOUT_MS;
+    int64_t last_progress_us = esp_timer_get_time();
+    uint8_t chunk[DELIVER_CHUNK_LEN];
+    while (1) {
+        if (interaction_cancelled()) {
+            return ESP_ERR_INVALID_STATE;
+        }
+        xSemaphoreTake(s_h2.lock, portMAX_DELAY);
+        size_t n = ring_get(&s->rx, chunk, sizeof(chunk));
+        stream_consume(s, n);
+        bool done = s->closed && s->rx.len == 0;
+        int status = s->status;
+        if (!done && !s->closed) {
+            // Without data to deliver, wait for some; otherwise just flush the window update
+            conn_pump(n ? 0 : H2_POLL_MS);
+        }
+        xSemaphoreGive(s_h2.lock);
+
+        int64_t now_us = esp_timer_get_time();
+        if (n) {
+            last_progress_us = now_us;
+            // A misdirected request's body is the server's, not the caller's
+            if (status != 421 && req->on_data) {
+                ESP_RETURN_ON_ERROR(req->on_data(req->ctx, chunk, n), TAG, "consumer");
+            }
+        }
+        if (done) {
+            break;
+        }
+        if (!n && now_us - last_progress_us > (int64_t)timeout_ms * 1000) {
+            return ESP_ERR_TIMEOUT;
+        }
+    }
+
+    if (s->conn_lost || s->error_code != NGHTTP2_NO_ERROR || s->status == 0) {
+        return ESP_FAIL;
+    }
+    return s->status == 421 ? ESP_ERR_NOT_SUPPORTED : ESP_OK;
+}
+
+esp_err_t h2_transport_post(const https_pool_request_t *req, int *status_out)
+{
+    ESP_RETURN_ON_FALSE(req && req->url && (req->body || req->write_body), ESP_ERR_INVALID_ARG, TAG, "bad args");
+    ESP_RETURN_ON_FALSE(req->header_count <= HTTPS_POOL_MAX_HEADERS, ESP_ERR_INVALID_ARG, TAG, "too many headers");
+
+    char host[HOST_MAX_LEN];
+    const char *path;
+    esp_err_t ret = parse_url(req->url, host, sizeof(host), &path);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    ESP_RETURN_ON_ERROR(ensure_lock(), TAG, "init");
+
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        h2_stream_t *s = NULL;
+        bool reused = false;
+        ret = stream_open(req, host, path, &s, &reused);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+
+        int64_t start_us = esp_timer_get_time();
+        ret = stream_run(s, req);
+        xSemaphoreTake(s_h2.lock, portMAX_DELAY);
+        int status = s->status;
+        bool refused = s->conn_lost || s->error_code == NGHTTP2_REFUSED_STREAM;
+        size_t received = s->bytes_received;
+        stream_release(s);
+        xSemaphoreGive(s_h2.lock);
+
+        if (ret == ESP_OK) {
+            if (status_out) {
+                *status_out = status;
+            }
+            ESP_LOGD(TAG, "%s: %s stream took %lld ms", host, reused ? "reused" : "new",
+                     (esp_timer_get_time() - start_us) / 1000);
+            return ESP_OK;
+        }
+        if (ret == ESP_ERR_INVALID_STATE && interaction_cancelled()) {
+            ESP_LOGI(TAG, "%s: stream cancelled", host);
+            return ret;
+        }
+        if (ret == ESP_ERR_NOT_SUPPORTED) {
+            ESP_LOGW(TAG, "%s: misdirected on the shared connection", host);
+            return ret;
+        }
+
+        // A dead reused connection (or a stream refused by GOAWAY) fails before
+        // any response bytes; anything later is a real error the caller must see
+        bool retry = reused && refused && attempt == 0 && received == 0;
+        ESP_LOGW(TAG, "%s: stream failed (%s)%s", host, esp_err_to_name(ret), retry ? ", retrying" : "");
+        if (!retry) {
+            break;
+        }
+    }
+    return ret;
+}
+
+esp_err_t h2_transport_prewarm(const char *url)
+{
+    ESP_RETURN_ON_FALSE(url, ESP_ERR_INVALID_ARG, TAG, "bad args");
+    char host[HOST_MAX_LEN];
+    const char *path;
+    esp_err_t ret = parse_url(url, host, sizeof(host), &path);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    ESP_RETURN_ON_ERROR(ensure_lock(), TAG, "init");
+
+    xSemaphoreTake(s_h2.lock, portMAX_DELAY);
+    int64_t now_us = esp_timer_get_time();
+    if (s_h2.declined) {
+        ret = ESP_ERR_NOT_SUPPORTED;
+    } else if (s_h2.session && s_h2.active == 0 && (s_h2.goaway || idle_expired(now_us))) {
+        conn_close(s_h2.goaway ? "drained" : "idle", !s_h2.goaway);
+    }
+    if (ret == ESP_OK && !s_h2.session) {
+        ret = conn_open(host);
+    }
+    s_h2.last_used_us = esp_timer_get_time();
+    xSemaphoreGive(s_h2.lock);
+    return ret;
+}
+
+void h2_transport_close_idle(void)
+{
+    if (ensure_lock() != ESP_OK || xSemaphoreTake(s_h2.lock, 0) != pdTRUE) {
+        return;
+    }
+    // Between requests nobody reads the socket: a poll answers the server's
+    // PINGs and notices a GOAWAY before the next request runs into it
+    if (s_h2.session && s_h2.active == 0) {
+        if (idle_expired(esp_timer_get_time())) {
+            conn_close("idle", true);
+        } else if (conn_pump(0) == ESP_OK && s_h2.goaway) {
+            conn_close("drained", false);
+        }
+    }
+    xSemaphoreGive(s_h2.lock);
+}
+
+void h2_transport_close_all(void)
+{
+    if (ensure_lock() != ESP_OK) {
+        return;
+    }
+    xSemaphoreTake(s_h2.lock, portMAX_DELAY);
+    conn_close("closed", false);
+    for (size_t i = 0; i < CONFIG_KVA_HTTP2_MAX_STREAMS; ++i) {
+        h2_stream_t *s = &s_h2.streams[i];
+        if (!s->used) {
+            MEM_TAG_FREE(MEM_TAG_GEMINI, s->rx.buf);
+            MEM_TAG_FREE(MEM_TAG_GEMINI, s->tx.buf);
+            memset(s, 0, sizeof(*s));
+        }
+    }
+#if CONFIG_ESP_TLS_CLIENT_SESSION_TICKETS
+    if (s_h2.ticket) {
+        esp_tls_free_client_session(s_h2.ticket);
+        s_h2.ticket = NULL;
+    }
+#endif
+    s_h2.declined = false;
+    xSemaphoreGive(s_h2.lock);
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "esp_err.h"
+#include "https_pool.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * HTTP/2 transport for the Google APIs.
+ *
+ * One TLS connection, with "h2" negotiated by ALPN, carries every request
+ * to a *.googleapis.com host as its own stream: speech, generative language
+ * and text-to-speech share the connection (and its single handshake) by
+ * sending their own :authority, which the server's wildcard certificate
+ * covers. Requests run concurrently, so the LLM stream and the TTS of a
+ * pipelined reply no longer wait for each other, and HPACK sends the
+ * repeated headers as table indexes.
+ *
+ * There is no I/O task: whichever caller holds the connection lock reads
+ * the socket for all streams, each stream's response is buffered in a
+ * CONFIG_KVA_HTTP2_STREAM_WINDOW ring, and that is also the window the
+ * server may fill, so a caller slow in on_data only stalls its own stream.
+ *
+ * Requests take the https_pool request type and keep its contract
+ * (repeatable write_body, one retry when a reused connection proves dead
+ * before any response, cancel between chunks). A cancel resets just that
+ * stream; the connection stays up for the others.
+ */
+
+/**
+ * POST over the shared HTTP/2 connection, opening it if needed.
+ *
+ * @return ESP_ERR_NOT_SUPPORTED, with nothing delivered to on_data, when
+ *         the URL is not https on googleapis.com, the server declined h2
+ *         (remembered until h2_transport_close_all()), every stream slot
+ *         is taken, the connection is draining after a GOAWAY, or the
+ *         server answered 421 for the host; use https_pool_post() then
+ */
+esp_err_t h2_transport_post(const https_pool_request_t *req, int *status_out);
+
+/**
+ * Open the connection ahead of the first request (DNS, TCP, TLS and the
+ * HTTP/2 preface). One call covers every googleapis.com host.
+ *
+ * @return ESP_ERR_NOT_SUPPORTED as for h2_transport_post()
+ */
+esp_err_t h2_transport_prewarm(const char *url);
+
+/**
+ * Close the connection if no stream is open and it was idle for more than
+ * HTTPS_POOL_IDLE_TIMEOUT_MS. Never blocks on the network.
+ */
+void h2_transport_close_idle(void);
+
+/**
+ * Close the connection, failing any open stream, and forget the TLS
+ * session ticket and a declined h2 (e.g. on Wi-Fi loss).
+ */
+void h2_transport_close_all(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,440 @@
+#include "https_pool.h"
+
+#include <stdbool.h>
+#include <string.h>
+
+#include "esp_check.h"
+#include "esp_crt_bundle.h"
+#include "esp_http_client.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "interaction_cancel.h"
+#include "sdkconfig.h"
+
+static const char *TAG = "https_pool";
+
+#define HOST_MAX_LEN 64
+#define HEADER_NAME_MAX_LEN 32
+// Body bytes per read; each read is a point where a cancel is noticed
+#define READ_CHUNK_LEN 512
+static const int DEFAULT_TIMEOUT_MS = 60000;
+
+typedef struct {
+    char host[HOST_MAX_LEN];
+    esp_http_client_handle_t client;
+    SemaphoreHandle_t lock;           // Held for the whole request
+    int64_t last_used_us;
+    bool connected;                   // A request left the socket open (keep-alive)
+    // Headers set by the previous request, removed before the next one
+    char header_names[HTTPS_POOL_MAX_HEADERS][HEADER_NAME_MAX_LEN];
+    size_t header_count;
+    // Active request's sink, read by the shared event handler
+    https_pool_data_cb_t on_data;
+    void *ctx;
+    size_t bytes_received;
+    esp_err_t data_err;
+} pool_entry_t;
+
+static pool_entry_t s_entries[HTTPS_POOL_MAX_HOSTS];
+static SemaphoreHandle_t s_table_lock;
+static portMUX_TYPE s_init_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static esp_err_t pool_event_handler(esp_http_client_event_t *evt)
+{
+    pool_entry_t *entry = (pool_entry_t *)evt->user_data;
+    if (!entry || evt->event_id != HTTP_EVENT_ON_DATA || evt->data_len <= 0) {
+        return ESP_OK;
+    }
+    entry->bytes_received += evt->data_len;
+    if (entry->data_err == ESP_OK && interaction_cancelled()) {
+        entry->data_err = ESP_ERR_INVALID_STATE;
+    }
+    if (entry->on_data && entry->data_err == ESP_OK) {
+        entry->data_err = entry->on_data(entry->ctx, (const uint8_t *)evt->data, evt->data_len);
+    }
+    return ESP_OK;
+}
+
+static esp_err_t parse_host(const char *url, char *host, size_t host_len)
+{
+    const char *start = strstr(url, "://");
+    start = start ? start + 3 : url;
+    size_t len = strcspn(start, ":/?#");
+    ESP_RETURN_ON_FALSE(len > 0 && len < host_len, ESP_ERR_INVALID_ARG, TAG, "bad host in %s", url);
+    memcpy(host, start, len);
+    host[len] = '\0';
+    return ESP_OK;
+}
+
+static esp_err_t ensure_table_lock(void)
+{
+    if (s_table_lock) {
+        return ESP_OK;
+    }
+    SemaphoreHandle_t lock = xSemaphoreCreateMutex();
+    ESP_RETURN_ON_FALSE(lock, ESP_ERR_NO_MEM, TAG, "table mutex");
+    portENTER_CRITICAL(&s_init_lock);
+    if (!s_table_lock) {
+        s_table_lock = lock;
+        lock = NULL;
+    }
+    portEXIT_CRITICAL(&s_init_lock);
+    if (lock) {
+        vSemaphoreDelete(lock);
+    }
+    return ESP_OK;
+}
+
+static void entry_drop_client(pool_entry_t *entry)
+{
+    if (entry->client) {
+        esp_http_client_cleanup(entry->client);
+        entry->client = NULL;
+    }
+    entry->connected = false;
+    entry->header_count = 0;
+}
+
+static esp_err_t entry_create_client(pool_entry_t *entry, const char *url)
+{
+    esp_http_client_config_t cfg = {
+        .url = url,
+        .method = HTTP_METHOD_POST,
+        .event_handler = pool_event_handler,
+        .user_data = entry,
+        .crt_bundle_attach = esp_crt_bundle_attach,
+        .timeout_ms = DEFAULT_TIMEOUT_MS,
+        .keep_alive_enable = true,
+#if CONFIG_ESP_TLS_CLIENT_SESSION_TICKETS
+        .save_client_session = true,
+#endif
+    };
+    entry->client = esp_http_client_init(&cfg);
+    ESP_RETURN_ON_FALSE(entry->client, ESP_ERR_NO_MEM, TAG, "client init for %s", entry->host);
+    entry->header_count = 0;
+    ESP_LOGI(TAG, "New session for %s", entry->host);
+    return ESP_OK;
+}
+
+/**
+ * Find (or claim) the slot for host and return it locked.
+ */
+static esp_err_t acquire_entry(const char *host, pool_entry_t **out)
+{
+    ESP_RETURN_ON_ERROR(ensure_table_lock(), TAG, "init");
+    xSemaphoreTake(s_table_lock, portMAX_DELAY);
+
+    pool_entry_t *match = NULL;
+    pool_entry_t *free_slot = NULL;
+    pool_entry_t *oldest = NULL;
+    for (size_t i = 0; i < HTTPS_POOL_MAX_HOSTS; ++i) {
+        pool_entry_t *e = &s_entries[i];
+        if (e->host[0] && strcmp(e->host, host) == 0) {
+            match = e;
+            break;
+        }
+        if (!e->host[0]) {
+            if (!free_slot) {
+                free_slot = e;
+            }
+        } else if (!oldest || e->last_used_us < oldest->last_used_us) {
+            oldest = e;
+        }
+    }
+
+    if (!match) {
+        match = free_slot ? free_slot : oldest;
+        if (!match->lock) {
+            match->lock = xSemaphoreCreateMutex();
+            if (!match->lock) {
+                xSemaphoreGive(s_table_lock);
+                return ESP_ERR_NO_MEM;
+            }
+        }
+        // Evicting waits for the current user of that slot to finish
+        xSemaphoreTake(match->lock, portMAX_DELAY);
+        if (match->host[0]) {
+            ESP_LOGI(TAG, "Evicting session for %s", match->host);
+        }
+        entry_drop_client(match);
+        strlcpy(match->host, host, sizeof(match->host));
+        xSemaphoreGive(s_table_lock);
+        *out = match;
+        return ESP_OK;
+    }
+
+    xSemaphoreGive(s_table_lock);
+    xSemaphoreTake(match->lock, portMAX_DELAY);
+    // The slot may have been handed to another host while we waited
+    if (strcmp(match->host, host) != 0) {
+        xSemaphoreGive(match->lock);
+        return acquire_entry(host, out);
+    }
+    *out = match;
+    return ESP_OK;
+}
+
+static esp_err_t entry_prepare(pool_entry_t *entry, const https_pool_request_t *req)
+{
+    for (size_t i = 0; i < entry->header_count; ++i) {
+        esp_http_client_delete_header(entry->client, entry->header_names[i]);
+    }
+    entry->header_count = 0;
+
+    ESP_RETURN_ON_ERROR(esp_http_client_set_url(entry->client, req->url), TAG, "url");
+    ESP_RETURN_ON_ERROR(esp_http_client_set_method(entry->client, HTTP_METHOD_POST), TAG, "method");
+    ESP_RETURN_ON_ERROR(esp_http_client_set_timeout_ms(entry->client,
+                                                       req->timeout_ms > 0 ? req->timeout_ms : DEFAULT_TIMEOUT_MS),
+                        TAG, "timeout");
+    for (size_t i = 0; i < req->header_count; ++i) {
+        const https_pool_header_t *h = &req->headers[i];
+        ESP_RETURN_ON_ERROR(esp_http_client_set_header(entry->client, h->name, h->value), TAG, "hdr %s", h->name);
+        strlcpy(entry->header_names[entry->header_count++], h->name, HEADER_NAME_MAX_LEN);
+    }
+    // Both body modes are written by entry_stream()
+    return esp_http_client_set_post_field(entry->client, NULL, 0);
+}
+
+esp_err_t https_pool_write(https_pool_writer_t *writer, const void *data, size_t len)
+{
+    ESP_RETURN_ON_FALSE(writer && (data || len == 0), ESP_ERR_INVALID_ARG, TAG, "bad args");
+    ESP_RETURN_ON_FALSE(len <= writer->remaining, ESP_ERR_INVALID_SIZE, TAG, "body overruns Content-Length");
+    if (len == 0) {
+        return ESP_OK;
+    }
+    ESP_RETURN_ON_ERROR(writer->write(writer, data, len), TAG, "write");
+    writer->remaining -= len;
+    return ESP_OK;
+}
+
+static esp_err_t client_write(https_pool_writer_t *writer, const void *data, size_t len)
+{
+    const char *p = (const char *)data;
+    while (len > 0) {
+        int written = esp_http_client_write((esp_http_client_handle_t)writer->transport, p, (int)len);
+        ESP_RETURN_ON_FALSE(written > 0, ESP_ERR_HTTP_WRITE_DATA, TAG, "write");
+        p += written;
+        len -= (size_t)written;
+    }
+    return ESP_OK;
+}
+
+/*
+ * open -> body -> fetch_headers -> read until done; body bytes reach on_data
+ * via events. The read loop replaces esp_http_client_perform() so a
+ * barge-in is seen between chunks rather than after the whole response.
+ */
+static esp_err_t entry_stream(pool_entry_t *entry, const https_pool_request_t *req)
+{
+    ESP_RETURN_ON_ERROR(esp_http_client_open(entry->client, (int)req->body_len), TAG, "open");
+    https_pool_writer_t writer = {
+        .write = client_write,
+        .transport = entry->client,
+        .remaining = req->body_len,
+    };
+    if (req->write_body) {
+        ESP_RETURN_ON_ERROR(req->write_body(&writer, req->body_ctx), TAG, "body");
+    } else {
+        ESP_RETURN_ON_ERROR(https_pool_write(&writer, req->body, req->body_len), TAG, "body");
+    }
+    ESP_RETURN_ON_FALSE(writer.remaining == 0, ESP_ERR_INVALID_SIZE, TAG, "body %zu bytes short", writer.remaining);
+    ESP_RETURN_ON_FALSE(esp_http_client_fetch_headers(entry->client) >= 0, ESP_ERR_HTTP_FETCH_HEADER, TAG, "headers");
+
+    char chunk[READ_CHUNK_LEN];
+    while (!esp_http_client_is_complete_data_received(entry->client)) {
+        if (interaction_cancelled()) {
+            return ESP_ERR_INVALID_STATE;
+        }
+        int read = esp_http_client_read(entry->client, chunk, sizeof(chunk));
+        if (read < 0) {
+            return read == -ESP_ERR_HTTP_EAGAIN ? ESP_ERR_TIMEOUT : ESP_FAIL;
+        }
+        if (read == 0) {
+            break;
+        }
+    }
+    return ESP_OK;
+}
+
+static bool entry_idle_expired(const pool_entry_t *entry, int64_t now_us)
+{
+    return now_us - entry->last_used_us > (int64_t)HTTPS_POOL_IDLE_TIMEOUT_MS * 1000;
+}
+
+esp_err_t https_pool_post(const https_pool_request_t *req, int *status_out)
+{
+    ESP_RETURN_ON_FALSE(req && req->url && (req->body || req->write_body), ESP_ERR_INVALID_ARG, TAG, "bad args");
+    ESP_RETURN_ON_FALSE(req->header_count <= HTTPS_POOL_MAX_HEADERS, ESP_ERR_INVALID_ARG, TAG, "too many headers");
+
+    char host[HOST_MAX_LEN];
+    ESP_RETURN_ON_ERROR(parse_host(req->url, host, sizeof(host)), TAG, "host");
+
+    pool_entry_t *entry = NULL;
+    ESP_RETURN_ON_ERROR(acquire_entry(host, &entry), TAG, "acquire");
+
+    esp_err_t ret = ESP_OK;
+    bool reused = entry->client != NULL;
+    if (reused && entry_idle_expired(entry, esp_timer_get_time())) {
+        // The server has likely dropped it; reconnecting now is cheaper than a failed write
+        esp_http_client_close(entry->client);
+        entry->connected = false;
+        reused = false;
+    }
+
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        if (!entry->client) {
+            ESP_GOTO_ON_ERROR(entry_create_client(entry, req->url), done, TAG, "create");
+        }
+        ret = entry_prepare(entry, req);
+        if (ret != ESP_OK) {
+            // Start clean next time rather than reuse a half-configured client
+            entry_drop_client(entry);
+            goto done;
+        }
+
+        entry->on_data = req->on_data;
+        entry->ctx = req->ctx;
+        entry->bytes_received = 0;
+        entry->data_err = ESP_OK;
+
+        int64_t start_us = esp_timer_get_time();
+        ret = entry_stream(entry, req);
+        entry->on_data = NULL;
+        entry->ctx = NULL;
+        if (ret == ESP_ERR_INVALID_STATE && interaction_cancelled()) {
+            // The rest of the response is still on the socket, so it cannot be reused
+            ESP_LOGI(TAG, "%s: request cancelled", entry->host);
+            esp_http_client_close(entry->client);
+            entry->connected = false;
+            break;
+        }
+        if (ret == ESP_OK) {
+            entry->connected = true;
+            ret = entry->data_err;
+            ESP_LOGD(TAG, "%s: %s request took %lld ms", entry->host, reused ? "reused" : "new",
+                     (esp_timer_get_time() - start_us) / 1000);
+            break;
+        }
+
+        // A stale keep-alive socket fails before any response bytes; anything
+        // later is a real error the caller must see
+        bool retry = reused && attempt == 0 && entry->bytes_received == 0;
+        ESP_LOGW(TAG, "%s: request failed (%s)%s", entry->host, esp_err_to_name(ret),
+                 retry ? ", reconnecting" : "");
+        esp_http_client_close(entry->client);
+        entry->connected = false;
+        if (!retry) {
+            break;
+        }
+        reused = false;
+    }
+
+    if (ret == ESP_OK && status_out) {
+        *status_out = esp_http_client_get_status_code(entry->client);
+    }
+
+done:
+    entry->last_used_us = esp_timer_get_time();
+    xSemaphoreGive(entry->lock);
+    return ret;
+}
+
+esp_err_t https_pool_prewarm(const char *url)
+{
+    ESP_RETURN_ON_FALSE(url, ESP_ERR_INVALID_ARG, TAG, "bad args");
+    char host[HOST_MAX_LEN];
+    ESP_RETURN_ON_ERROR(parse_host(url, host, sizeof(host)), TAG, "host");
+
+    pool_entry_t *entry = NULL;
+    ESP_RETURN_ON_ERROR(acquire_entry(host, &entry), TAG, "acquire");
+
+    esp_err_t ret = ESP_OK;
+    int64_t start_us = esp_timer_get_time();
+    if (entry->client && entry->connected && !entry_idle_expired(entry, start_us)) {
+        goto done;
+    }
+    if (entry->client) {
+        esp_http_client_close(entry->client);
+        entry->connected = false;
+    }
+    if (!entry->client) {
+        ESP_GOTO_ON_ERROR(entry_create_client(entry, url), done, TAG, "create");
+    }
+
+    // Any status will do; only the open keep-alive socket matters
+    for (size_t i = 0; i < entry->header_count; ++i) {
+        esp_http_client_delete_header(entry->client, entry->header_names[i]);
+    }
+    entry->header_count = 0;
+    ret = esp_http_client_set_url(entry->client, url);
+    if (ret == ESP_OK) {
+        ret = esp_http_client_set_method(entry->client, HTTP_METHOD_HEAD);
+    }
+    if (ret == ESP_OK) {
+        ret = esp_http_client_set_post_field(entry->client, NULL, 0);
+    }
+    if (ret != ESP_OK) {
+        entry_drop_client(entry);
+        goto done;
+    }
+    entry->on_data = NULL;
+    entry->data_err = ESP_OK;
+    ret = esp_http_client_perform(entry->client);
+    if (ret == ESP_OK) {
+        entry->connected = true;
+        ESP_LOGI(TAG, "%s: prewarmed in %lld ms (status %d)", entry->host,
+                 (esp_timer_get_time() - start_us) / 1000, esp_http_client_get_status_code(entry->client));
+    } else {
+        ESP_LOGW(TAG, "%s: prewarm failed (%s)", entry->host, esp_err_to_name(ret));
+        esp_http_client_close(entry->client);
+    }
+
+done:
+    entry->last_used_us = esp_timer_get_time();
+    xSemaphoreGive(entry->lock);
+    return ret;
+}
+
+void https_pool_close_idle(void)
+{
+    if (ensure_table_lock() != ESP_OK) {
+        return;
+    }
+    int64_t now_us = esp_timer_get_time();
+    xSemaphoreTake(s_table_lock, portMAX_DELAY);
+    for (size_t i = 0; i < HTTPS_POOL_MAX_HOSTS; ++i) {
+        pool_entry_t *e = &s_entries[i];
+        if (!e->lock || !e->client || !e->connected || !entry_idle_expired(e, now_us)) {
+            continue;
+        }
+        if (xSemaphoreTake(e->lock, 0) != pdTRUE) {
+            continue;
+        }
+        ESP_LOGI(TAG, "%s: closing idle connection", e->host);
+        esp_http_client_close(e->client);
+        e->connected = false;
+        xSemaphoreGive(e->lock);
+    }
+    xSemaphoreGive(s_table_lock);
+}
+
+void https_pool_close_all(void)
+{
+    if (ensure_table_lock() != ESP_OK) {
+        return;
+    }
+    xSemaphoreTake(s_table_lock, portMAX_DELAY);
+    for (size_t i = 0; i < HTTPS_POOL_MAX_HOSTS; ++i) {
+        pool_entry_t *e = &s_entries[i];
+        if (!e->lock) {
+            continue;
+        }
+        xSemaphoreTake(e->lock, portMAX_DELAY);
+        entry_drop_client(e);
+        e->host[0] = '\0';
+        xSemaphoreGive(e->lock);
+    }
+    xSemaphoreGive(s_table_lock);
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Distinct hosts kept connected at once (OpenAI, Speech, Gemini, TTS)
+#ifndef HTTPS_POOL_MAX_HOSTS
+#define HTTPS_POOL_MAX_HOSTS 4
+#endif
+
+// Extra request headers per call
+#ifndef HTTPS_POOL_MAX_HEADERS
+#define HTTPS_POOL_MAX_HEADERS 4
+#endif
+
+// Connections idle longer than this are closed before reuse instead of
+// waiting for the server's keep-alive timer to race the next request
+#ifndef HTTPS_POOL_IDLE_TIMEOUT_MS
+#define HTTPS_POOL_IDLE_TIMEOUT_MS 50000
+#endif
+
+/**
+ * Called for every chunk of response body, in order.
+ */
+typedef esp_err_t (*https_pool_data_cb_t)(void *ctx, const uint8_t *data, size_t len);
+
+/**
+ * Body sink handed to a streaming request's write_body callback. The
+ * transport carrying the request fills it in; callers only pass it to
+ * https_pool_write().
+ */
+typedef struct https_pool_writer https_pool_writer_t;
+
+struct https_pool_writer {
+    // Sends all len bytes or fails; remaining is already checked
+    esp_err_t (*write)(https_pool_writer_t *writer, const void *data, size_t len);
+    void *transport;
+    size_t remaining;
+};
+
+/**
+ * Produce the request body with https_pool_write(). May be called a second
+ * time for the same request if the first attempt hit a stale connection, so
+ * it must be repeatable.
+ */
+typedef esp_err_t (*https_pool_body_cb_t)(https_pool_writer_t *writer, void *ctx);
+
+typedef struct {
+    const char *name;
+    const char *value;
+} https_pool_header_t;
+
+typedef struct {
+    const char *url;                  // Full https:// URL; the host selects the pooled session
+    const char *body;                 // POST body, unused when write_body is set
+    size_t body_len;                  // Exact Content-Length in both modes
+    https_pool_body_cb_t write_body;  // Stream the body instead of sending a buffer
+    void *body_ctx;
+    const https_pool_header_t *headers;
+    size_t header_count;              // <= HTTPS_POOL_MAX_HEADERS
+    int timeout_ms;                   // 0 keeps the client default
+    https_pool_data_cb_t on_data;
+    void *ctx;
+} https_pool_request_t;
+
+/**
+ * POST through the keep-alive session for the URL's host.
+ *
+ * The session is created on first use and kept for later requests. A dropped
+ * connection is reopened with a full TLS handshake. If a reused connection
+ * turns out to be dead before any response data arrived, it is reopened and
+ * the request is sent once more. Requests to the same host are serialised.
+ *
+ * The response is read in chunks, and a request running while the current
+ * interaction is cancelled (interaction_cancel.h) stops at the next chunk,
+ * closes its socket and returns ESP_ERR_INVALID_STATE.
+ *
+ * @param status_out HTTP status code (may be NULL)
+ */
+esp_err_t https_pool_post(const https_pool_request_t *req, int *status_out);
+
+/**
+ * Send the next part of a streamed body. Fails if more than the declared
+ * body_len would be written.
+ */
+esp_err_t https_pool_write(https_pool_writer_t *writer, const void *data, size_t len);
+
+/**
+ * Open the session for the URL's host ahead of the first request: DNS, TCP
+ * and TLS happen now (a HEAD on url) so the next POST reuses the socket.
+ * Does nothing if the host already has a live connection.
+ */
+esp_err_t https_pool_prewarm(const char *url);
+
+/**
+ * Close connections idle for more than HTTPS_POOL_IDLE_TIMEOUT_MS. Clients
+ * are kept. Skips hosts with a request in flight, so it never blocks on the
+ * network.
+ */
+void https_pool_close_idle(void);
+
+/**
+ * Close every pooled connection and free the clients (e.g. on Wi-Fi loss).
+ */
+void https_pool_close_all(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,145 @@
+#include "i2c_topology.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "esp_chip_info.h"
+#include "esp_log.h"
+#include "nvs.h"
+
+#define I2C_TOPOLOGY_NVS_NAMESPACE "i2c_topo"
+#define I2C_TOPOLOGY_FIRST_ADDR 0x08
+#define I2C_TOPOLOGY_LAST_ADDR 0x77
+// Bumped when the stored layout changes, so old entries stop matching
+#define I2C_TOPOLOGY_VERSION 1
+
+static const char *TAG = "i2c_topology";
+
+typedef struct {
+    uint32_t fingerprint;
+    uint8_t count;
+    uint8_t addr[I2C_TOPOLOGY_MAX_DEVICES];
+} topology_record_t;
+
+static uint32_t fnv1a(uint32_t hash, const void *data, size_t len)
+{
+    const uint8_t *p = data;
+    for (size_t i = 0; i < len; ++i) {
+        hash = (hash ^ p[i]) * 16777619u;
+    }
+    return hash;
+}
+
+// The same wiring on the same chip; a different board or pin map never matches
+static uint32_t bus_fingerprint(const i2c_topology_bus_t *bus)
+{
+    esp_chip_info_t chip;
+    esp_chip_info(&chip);
+    const int32_t fields[] = {
+        I2C_TOPOLOGY_VERSION, bus->port, bus->sda, bus->scl, (int32_t)bus->freq_hz,
+        (int32_t)chip.model, (int32_t)chip.revision, (int32_t)chip.features,
+    };
+    return fnv1a(2166136261u, fields, sizeof(fields));
+}
+
+static void record_key(const i2c_topology_bus_t *bus, char *key, size_t len)
+{
+    snprintf(key, len, "bus%d", bus->port);
+}
+
+static bool load_record(const char *key, topology_record_t *rec)
+{
+    nvs_handle_t nvs;
+    if (nvs_open(I2C_TOPOLOGY_NVS_NAMESPACE, NVS_READONLY, &nvs) != ESP_OK) {
+        return false;
+    }
+    size_t len = sizeof(*rec);
+    esp_err_t err = nvs_get_blob(nvs, key, rec, &len);
+    nvs_close(nvs);
+    return err == ESP_OK && len == sizeof(*rec) && rec->count <= I2C_TOPOLOGY_MAX_DEVICES;
+}
+
+static void store_record(const char *key, const topology_record_t *rec)
+{
+    nvs_handle_t nvs;
+    esp_err_t err = nvs_open(I2C_TOPOLOGY_NVS_NAMESPACE, NVS_READWRITE, &nvs);
+    if (err == ESP_OK) {
+        err = nvs_set_blob(nvs, key, rec, sizeof(*rec));
+        if (err == ESP_OK) {
+            err = nvs_commit(nvs);
+        }
+        nvs_close(nvs);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Topology not cached: %s", esp_err_to_name(err));
+    }
+}
+
+esp_err_t i2c_topology_discover(const i2c_topology_bus_t *bus, i2c_topology_probe_t probe, void *ctx, bool rescan,
+                                i2c_topology_t *out)
+{
+    if (!bus || !probe || !out) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    memset(out, 0, sizeof(*out));
+    char key[16];
+    record_key(bus, key, sizeof(key));
+    uint32_t fingerprint = bus_fingerprint(bus);
+
+    topology_record_t rec;
+    if (!rescan && load_record(key, &rec) && rec.fingerprint == fingerprint) {
+        bool all_present = true;
+        for (uint8_t i = 0; i < rec.count && all_present; ++i) {
+            out->probes++;
+            all_present = probe(rec.addr[i], ctx);
+        }
+        if (all_present) {
+            out->count = rec.count;
+            memcpy(out->addr, rec.addr, rec.count);
+            out->from_cache = true;
+            return ESP_OK;
+        }
+        ESP_LOGI(TAG, "Bus %d changed since the last scan; scanning in full", bus->port);
+    }
+
+    bool overflow = false;
+    memset(out, 0, sizeof(*out));
+    for (uint8_t addr = I2C_TOPOLOGY_FIRST_ADDR; addr <= I2C_TOPOLOGY_LAST_ADDR; ++addr) {
+        out->probes++;
+        if (!probe(addr, ctx)) {
+            continue;
+        }
+        if (out->count < I2C_TOPOLOGY_MAX_DEVICES) {
+            out->addr[out->count++] = addr;
+        } else {
+            overflow = true;
+        }
+    }
+    // A truncated list would verify without ever noticing the rest
+    if (overflow) {
+        ESP_LOGW(TAG, "Bus %d has more than %d devices; not cached", bus->port, I2C_TOPOLOGY_MAX_DEVICES);
+        return ESP_OK;
+    }
+    rec = (topology_record_t){.fingerprint = fingerprint, .count = out->count};
+    memcpy(rec.addr, out->addr, out->count);
+    store_record(key, &rec);
+    return ESP_OK;
+}
+
+esp_err_t i2c_topology_forget(void)
+{
+    nvs_handle_t nvs;
+    esp_err_t err = nvs_open(I2C_TOPOLOGY_NVS_NAMESPACE, NVS_READWRITE, &nvs);
+    if (err == ESP_ERR_NVS_NOT_FOUND) {
+        return ESP_OK;                // Nothing cached yet
+    }
+    if (err != ESP_OK) {
+        return err;
+    }
+    err = nvs_erase_all(nvs);
+    if (err == ESP_OK) {
+        err = nvs_commit(nvs);
+    }
+    nvs_close(nvs);
+    return err;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Which addresses answer on an I2C bus, remembered in NVS across boots.
+ *
+ * A full scan probes every address from 0x08 to 0x77. Once one has run,
+ * later boots probe only the addresses it found; if every one of them still
+ * answers, that list is taken as the bus. A missing device, a different
+ * board fingerprint (port, pins, clock, chip) or an explicit rescan falls
+ * back to a full scan and stores its result. A device added to an otherwise
+ * unchanged bus is not noticed until a rescan is asked for.
+ *
+ * Probing is left to the caller, so the cache works with either I2C driver.
+ */
+
+#define I2C_TOPOLOGY_MAX_DEVICES 16
+
+typedef struct {
+    int port;
+    int sda;
+    int scl;
+    uint32_t freq_hz;
+} i2c_topology_bus_t;
+
+typedef struct {
+    uint8_t count;
+    uint8_t addr[I2C_TOPOLOGY_MAX_DEVICES];
+    bool from_cache;                  // Verified against the cache, no full scan
+    uint16_t probes;                  // Addresses probed to get here
+} i2c_topology_t;
+
+// True when a device acknowledges the address
+typedef bool (*i2c_topology_probe_t)(uint8_t address, void *ctx);
+
+/**
+ * Devices on the bus, from the verified cache or a full scan.
+ *
+ * @param rescan Skip the cache and scan everything
+ */
+esp_err_t i2c_topology_discover(const i2c_topology_bus_t *bus, i2c_topology_probe_t probe, void *ctx, bool rescan,
+                                i2c_topology_t *out);
+
+// Drop every cached bus so the next discovery scans in full
+esp_err_t i2c_topology_forget(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,115 +1,289 @@
 #include "intent_router.h"
 
 #include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "esp_check.h"
 #include "esp_log.h"
+#include "kva_config_defaults.h"
+#include "phrase_fuzzy.h"
+#include "phrase_matcher.h"
 
 static const char *TAG = "intent_router";
 
-static const char *find_keyword(const char *haystack, const char *needle)
+_Static_assert(INTENT_ROUTER_PHRASE_MAX <= PHRASE_FUZZY_MAX_LEN, "phrases must fit the fuzzy matcher");
+
+typedef struct {
+    const char *name;
+    intent_router_action_t action;
+    int volume_sign;
+} action_name_t;
+
+static const action_name_t ACTION_NAMES[] = {
+    {"pause", INTENT_ROUTER_ACTION_SPOTIFY_PAUSE, 0},
+    {"resume", INTENT_ROUTER_ACTION_SPOTIFY_RESUME, 0},
+    {"volume_up", INTENT_ROUTER_ACTION_SPOTIFY_VOLUME_DELTA, 1},
+    {"volume_down", INTENT_ROUTER_ACTION_SPOTIFY_VOLUME_DELTA, -1},
+    {"play", INTENT_ROUTER_ACTION_SPOTIFY_PLAY, 0},
+    {"lights_off", INTENT_ROUTER_ACTION_LIGHTS_OFF, 0},
+    {"lights_on", INTENT_ROUTER_ACTION_LIGHTS_ON, 0},
+};
+
+typedef struct {
+    const char *action;
+    const char *phrase;
+} builtin_phrase_t;
+
+// Used when no phrase file is readable; order is priority
+static const builtin_phrase_t BUILTIN_PHRASES[] = {
+    {"pause", "pause"},
+    {"pause", "stop"},
+    {"resume", "resume"},
+    {"resume", "continue"},
+    {"volume_up", "volume up"},
+    {"volume_up", "louder"},
+    {"volume_down", "volume down"},
+    {"volume_down", "quieter"},
+    {"volume_down", "lower"},
+    {"play", "play"},
+    {"lights_off", "lights off"},
+    {"lights_off", "turn off the lights"},
+    {"lights_off", "lights out"},
+    {"lights_off", "turn lights off"},
+    {"lights_on", "lights on"},
+    {"lights_on", "turn on the lights"},
+    {"lights_on", "turn lights on"},
+    {"lights_on", "lights up"},
+};
+
+#define BUILTIN_COUNT (sizeof(BUILTIN_PHRASES) / sizeof(BUILTIN_PHRASES[0]))
+
+static const action_name_t *find_action(const char *name)
 {
-    if (!haystack || !needle) {
-        return NULL;
-    }
-    size_t needle_len = strlen(needle);
-    if (needle_len == 0) {
-        return NULL;
-    }
-    for (const char *p = haystack; *p; ++p) {
-        size_t i = 0;
-        while (p[i] && i < needle_len) {
-            char a = (char)tolower((unsigned char)p[i]);
-            char b = (char)tolower((unsigned char)needle[i]);
-            if (a != b) {
-                break;
-            }
-            i++;
-        }
-        if (i == needle_len) {
-            return p;
+    for (size_t i = 0; i < sizeof(ACTION_NAMES) / sizeof(ACTION_NAMES[0]); ++i) {
+        if (strcmp(ACTION_NAMES[i].name, name) == 0) {
+            return &ACTION_NAMES[i];
         }
     }
     return NULL;
 }
 
-static void extract_after_keyword(const char *utterance, const char *keyword, char *out, size_t out_len)
+// Phrases under construction: text for the matcher, intent for the router
+typedef struct {
+    char (*text)[INTENT_ROUTER_PHRASE_MAX + 1];
+    const char **ptrs;
+    intent_router_phrase_t *intents;
+    size_t count;
+} phrase_table_t;
+
+static bool table_add(phrase_table_t *table, const char *action_name, const char *phrase)
+{
+    const action_name_t *action = find_action(action_name);
+    if (!action) {
+        ESP_LOGW(TAG, "Unknown action \"%s\", skipping \"%s\"", action_name, phrase);
+        return false;
+    }
+    if (phrase[0] == '\0' || strlen(phrase) > INTENT_ROUTER_PHRASE_MAX) {
+        ESP_LOGW(TAG, "Skipping %s phrase \"%.*s\" (empty or too long)", action_name, INTENT_ROUTER_PHRASE_MAX, phrase);
+        return false;
+    }
+    if (table->count == INTENT_ROUTER_MAX_PHRASES) {
+        ESP_LOGW(TAG, "Phrase table full, skipping \"%s\"", phrase);
+        return false;
+    }
+    strlcpy(table->text[table->count], phrase, sizeof(table->text[0]));
+    table->ptrs[table->count] = table->text[table->count];
+    table->intents[table->count].action = action->action;
+    table->intents[table->count].volume_sign = action->volume_sign;
+    table->count++;
+    return true;
+}
+
+static void table_load_builtin(phrase_table_t *table)
 {
-    if (!utterance || !keyword || !out || out_len == 0) {
-        return;
+    for (size_t i = 0; i < BUILTIN_COUNT; ++i) {
+        table_add(table, BUILTIN_PHRASES[i].action, BUILTIN_PHRASES[i].phrase);
     }
-    const char *pos = find_keyword(utterance, keyword);
-    if (!pos) {
-        out[0] = '\0';
+}
+
+// "<action> <phrase>" per line; '#' starts a comment line
+static void table_load_file(phrase_table_t *table, const char *path)
+{
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        ESP_LOGW(TAG, "No phrase file at %s, using built-in phrases", path);
         return;
     }
-    pos += strlen(keyword);
-    while (*pos && isspace((unsigned char)*pos)) {
-        ++pos;
+    char line[INTENT_ROUTER_PHRASE_MAX + 32];
+    while (fgets(line, sizeof(line), f)) {
+        size_t len = strlen(line);
+        while (len > 0 && isspace((unsigned char)line[len - 1])) {
+            line[--len] = '\0';
+        }
+        char *action = line;
+        while (*action && isspace((unsigned char)*action)) {
+            ++action;
+        }
+        if (*action == '\0' || *action == '#') {
+            continue;
+        }
+        char *phrase = action;
+        while (*phrase && !isspace((unsigned char)*phrase)) {
+            ++phrase;
+        }
+        if (*phrase) {
+            *phrase++ = '\0';
+        }
+        while (*phrase && isspace((unsigned char)*phrase)) {
+            ++phrase;
+        }
+        table_add(table, action, phrase);
     }
-    strlcpy(out, pos, out_len);
+    fclose(f);
+    ESP_LOGI(TAG, "Loaded %u phrases from %s", (unsigned)table->count, path);
 }
 
 esp_err_t intent_router_init(intent_router_t *router, const intent_router_config_t *cfg)
 {
     ESP_RETURN_ON_FALSE(router, ESP_ERR_INVALID_ARG, TAG, "router required");
     router->default_volume_step = cfg ? cfg->default_volume_step : 10;
-    return ESP_OK;
+    router->matcher = NULL;
+    router->fuzzy = NULL;
+    router->phrases = NULL;
+    router->phrase_count = 0;
+
+    esp_err_t ret = ESP_OK;
+    phrase_table_t table = {
+        .text = malloc(INTENT_ROUTER_MAX_PHRASES * sizeof(*table.text)),
+        .ptrs = malloc(INTENT_ROUTER_MAX_PHRASES * sizeof(*table.ptrs)),
+        .intents = calloc(INTENT_ROUTER_MAX_PHRASES, sizeof(*table.intents)),
+    };
+    ESP_GOTO_ON_FALSE(table.text && table.ptrs && table.intents, ESP_ERR_NO_MEM, done, TAG, "phrase table");
+
+    if (cfg && cfg->phrase_path) {
+        table_load_file(&table, cfg->phrase_path);
+    }
+    if (table.count == 0) {
+        table_load_builtin(&table);
+    }
+    ESP_GOTO_ON_ERROR(phrase_matcher_create((const char *const *)table.ptrs, table.count, &router->matcher), done, TAG, "matcher");
+    // Routing stays exact without it; a phrase of punctuation only is what fails here
+    if (CONFIG_KVA_INTENT_FUZZY_CHARS_PER_EDIT > 0 &&
+        phrase_fuzzy_create((const char *const *)table.ptrs, table.count, CONFIG_KVA_INTENT_FUZZY_CHARS_PER_EDIT,
+                            &router->fuzzy) != ESP_OK) {
+        ESP_LOGW(TAG, "Fuzzy matching off");
+    }
+    router->phrases = table.intents;
+    router->phrase_count = table.count;
+    table.intents = NULL;
+    ESP_LOGI(TAG, "Routing on %u phrases", (unsigned)router->phrase_count);
+
+done:
+    // The matcher keeps no pointers into the phrase text
+    free(table.text);
+    free(table.ptrs);
+    free(table.intents);
+    return ret;
 }
 
-intent_router_decision_t intent_router_route(intent_router_t *router, const char *utterance)
+void intent_router_deinit(intent_router_t *router)
+{
+    if (!router) {
+        return;
+    }
+    phrase_matcher_destroy(router->matcher);
+    phrase_fuzzy_destroy(router->fuzzy);
+    free(router->phrases);
+    router->matcher = NULL;
+    router->fuzzy = NULL;
+    router->phrases = NULL;
+    router->phrase_count = 0;
+}
+
+static intent_router_decision_t decide(const intent_router_t *router, const char *utterance, int match,
+                                       size_t match_end)
 {
     intent_router_decision_t decision = {
         .action = INTENT_ROUTER_ACTION_NONE,
         .argument = {0},
         .volume_delta = 0,
     };
-    if (!utterance || !router) {
+    if (match < 0) {
         return decision;
     }
-
-    if (find_keyword(utterance, "pause") || find_keyword(utterance, "stop")) {
-        decision.action = INTENT_ROUTER_ACTION_SPOTIFY_PAUSE;
-        return decision;
+    const intent_router_phrase_t *phrase = &router->phrases[match];
+    decision.action = phrase->action;
+    decision.confidence = 1.0f;
+    decision.volume_delta = phrase->volume_sign * router->default_volume_step;
+    if (decision.action == INTENT_ROUTER_ACTION_SPOTIFY_PLAY) {
+        const char *arg = utterance + match_end;
+        while (*arg && isspace((unsigned char)*arg)) {
+            ++arg;
+        }
+        strlcpy(decision.argument, arg, sizeof(decision.argument));
     }
+    return decision;
+}
 
-    if (find_keyword(utterance, "resume") || find_keyword(utterance, "continue")) {
-        decision.action = INTENT_ROUTER_ACTION_SPOTIFY_RESUME;
-        return decision;
+intent_router_decision_t intent_router_route(intent_router_t *router, const char *utterance)
+{
+    if (!utterance || !router || !router->matcher) {
+        return decide(router, utterance, -1, 0);
     }
-
-    if (find_keyword(utterance, "volume up") || find_keyword(utterance, "louder")) {
-        decision.action = INTENT_ROUTER_ACTION_SPOTIFY_VOLUME_DELTA;
-        decision.volume_delta = router->default_volume_step;
-        return decision;
+    size_t match_end = 0;
+    int match = phrase_matcher_find(router->matcher, utterance, &match_end);
+    if (match >= 0) {
+        return decide(router, utterance, match, match_end);
     }
-
-    if (find_keyword(utterance, "volume down") || find_keyword(utterance, "quieter") || find_keyword(utterance, "lower")) {
-        decision.action = INTENT_ROUTER_ACTION_SPOTIFY_VOLUME_DELTA;
-        decision.volume_delta = -router->default_volume_step;
-        return decision;
+    phrase_fuzzy_match_t fuzzy;
+    phrase_fuzzy_find(router->fuzzy, utterance, &fuzzy);
+    if (fuzzy.phrase < 0) {
+        ESP_LOGI(TAG, "No intent matched for \"%s\"", utterance);
+        return decide(router, utterance, -1, 0);
     }
+    ESP_LOGI(TAG, "\"%s\" matched phrase %d with %u edits (confidence %.2f)", utterance, fuzzy.phrase,
+             (unsigned)fuzzy.distance, fuzzy.confidence);
+    intent_router_decision_t decision = decide(router, utterance, fuzzy.phrase, fuzzy.end);
+    decision.confidence = fuzzy.confidence;
+    return decision;
+}
 
-    if (find_keyword(utterance, "play")) {
-        decision.action = INTENT_ROUTER_ACTION_SPOTIFY_PLAY;
-        extract_after_keyword(utterance, "play", decision.argument, sizeof(decision.argument));
-        return decision;
+void intent_router_stream_begin(intent_router_stream_t *stream)
+{
+    if (stream) {
+        phrase_matcher_scan_begin(&stream->scan);
     }
+}
 
-    // Lights control - simple local keyword detection
-    if (find_keyword(utterance, "lights off") || find_keyword(utterance, "turn off the lights") || 
-        find_keyword(utterance, "lights out") || find_keyword(utterance, "turn lights off")) {
-        decision.action = INTENT_ROUTER_ACTION_LIGHTS_OFF;
-        return decision;
+intent_router_decision_t intent_router_route_partial(intent_router_t *router, intent_router_stream_t *stream,
+                                                     const char *partial)
+{
+    if (!partial || !router || !router->matcher || !stream) {
+        return decide(router, partial, -1, 0);
     }
-
-    if (find_keyword(utterance, "lights on") || find_keyword(utterance, "turn on the lights") || 
-        find_keyword(utterance, "turn lights on") || find_keyword(utterance, "lights up")) {
-        decision.action = INTENT_ROUTER_ACTION_LIGHTS_ON;
-        return decision;
+    size_t len = strlen(partial);
+    if (len < stream->scan.pos) {
+        phrase_matcher_scan_begin(&stream->scan);
     }
+    phrase_matcher_scan_feed(router->matcher, &stream->scan, partial + stream->scan.pos, len - stream->scan.pos);
+    return decide(router, partial, stream->scan.best, stream->scan.best_end);
+}
 
-    ESP_LOGI(TAG, "No intent matched for \"%s\"", utterance);
-    return decision;
+bool intent_router_is_immediate(const intent_router_decision_t *decision)
+{
+    if (!decision) {
+        return false;
+    }
+    switch (decision->action) {
+        case INTENT_ROUTER_ACTION_SPOTIFY_PAUSE:
+        case INTENT_ROUTER_ACTION_SPOTIFY_RESUME:
+        case INTENT_ROUTER_ACTION_SPOTIFY_VOLUME_DELTA:
+        case INTENT_ROUTER_ACTION_LIGHTS_ON:
+        case INTENT_ROUTER_ACTION_LIGHTS_OFF:
+            return true;
+        default:
+            return false;
+    }
 }
@@ -4,6 +4,9 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+#include "phrase_fuzzy.h"
+#include "phrase_matcher.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -22,19 +25,83 @@ typedef struct {
     intent_router_action_t action;
     char argument[64];
     int volume_delta;
+    float confidence;                  // 1 for an exact phrase, lower for a fuzzy match, 0 for none
 } intent_router_decision_t;
 
+// Longest phrase accepted from a phrase file
+#ifndef INTENT_ROUTER_PHRASE_MAX
+#define INTENT_ROUTER_PHRASE_MAX 48
+#endif
+
+// Phrases kept from a phrase file; the rest are skipped with a warning
+#ifndef INTENT_ROUTER_MAX_PHRASES
+#define INTENT_ROUTER_MAX_PHRASES 64
+#endif
+
+typedef struct {
+    intent_router_action_t action;
+    int volume_sign;                   // Volume phrases: +1 up, -1 down
+} intent_router_phrase_t;
+
+/**
+ * Routes a transcript to a local action with one pass of a compiled phrase
+ * matcher. Phrases come from a text file (e.g. on SPIFFS), one per line:
+ *
+ *     # comment
+ *     pause stop
+ *     volume_up louder
+ *     play play
+ *
+ * The first word is the action (pause, resume, volume_up, volume_down,
+ * play, lights_off, lights_on), the rest of the line the phrase. Earlier
+ * lines win when several phrases match. Phrases match as case-insensitive
+ * substrings; for play, the text after the phrase is the argument. Without
+ * a readable file the built-in table is used.
+ *
+ * A final transcript without an exact phrase is tried against the same
+ * table by edit distance (phrase_fuzzy.h), one edit allowed per
+ * CONFIG_KVA_INTENT_FUZZY_CHARS_PER_EDIT bytes of phrase, so a misheard
+ * "lights of" still stays local. Partial transcripts only match exactly.
+ */
 typedef struct intent_router {
     int default_volume_step;
+    phrase_matcher_t *matcher;
+    phrase_fuzzy_t *fuzzy;             // NULL when fuzzy matching is off
+    intent_router_phrase_t *phrases;   // Indexed like the matcher's phrases
+    size_t phrase_count;
 } intent_router_t;
 
 typedef struct {
     int default_volume_step;
+    const char *phrase_path;           // Phrase file; NULL for the built-in table
 } intent_router_config_t;
 
+// Matcher progress over one growing transcript
+typedef struct {
+    phrase_matcher_scan_t scan;
+} intent_router_stream_t;
+
 esp_err_t intent_router_init(intent_router_t *router, const intent_router_config_t *cfg);
+void intent_router_deinit(intent_router_t *router);
 intent_router_decision_t intent_router_route(intent_router_t *router, const char *utterance);
 
+void intent_router_stream_begin(intent_router_stream_t *stream);
+
+/**
+ * Route a partial transcript that grows between calls (each call passes
+ * the whole text so far). Only the bytes added since the previous call are
+ * scanned; a shorter text restarts the stream.
+ */
+intent_router_decision_t intent_router_route_partial(intent_router_t *router, intent_router_stream_t *stream,
+                                                     const char *partial);
+
+/**
+ * True for intents that are complete as soon as their phrase is heard, so
+ * they can run before the transcript is final. Play is not: its argument
+ * is the rest of the utterance.
+ */
+bool intent_router_is_immediate(const intent_router_decision_t *decision);
+
 #ifdef __cplusplus
 }
 #endif
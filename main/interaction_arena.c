@@ -0,0 +1,205 @@
+#include "interaction_arena.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cJSON.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "slab_alloc.h"
+
+static const char *TAG = "interaction_arena";
+
+// Blocks are 8-byte aligned for the doubles inside cJSON nodes
+#define ARENA_ALIGN 8
+#define ARENA_NO_BLOCK SIZE_MAX
+
+typedef struct {
+    uint32_t size;                    // Bytes requested, for realloc copies
+    uint32_t reserved;                // Keeps the payload ARENA_ALIGN aligned
+} arena_header_t;
+
+// Only the owner task touches top/last/live_blocks; begin/end hand it over
+static struct {
+    uint8_t *base;
+    size_t cap;
+    size_t top;
+    size_t last;                      // Offset of the newest block, or ARENA_NO_BLOCK
+    TaskHandle_t owner;
+    size_t high_water;
+    size_t live_blocks;
+    size_t heap_fallbacks;
+} s_arena;
+
+static portMUX_TYPE s_owner_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static size_t align_up(size_t n)
+{
+    return (n + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+}
+
+static bool owned_here(void)
+{
+    return s_arena.owner && s_arena.owner == xTaskGetCurrentTaskHandle();
+}
+
+static bool in_arena(const void *ptr)
+{
+    const uint8_t *p = (const uint8_t *)ptr;
+    return s_arena.base && p >= s_arena.base && p < s_arena.base + s_arena.cap;
+}
+
+static arena_header_t *header_of(void *ptr)
+{
+    return (arena_header_t *)ptr - 1;
+}
+
+esp_err_t interaction_arena_init(size_t bytes)
+{
+    if (s_arena.base) {
+        return ESP_OK;
+    }
+    if (bytes == 0 || bytes > UINT32_MAX) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    // Installed even without an arena, so cJSON outside interactions still gets the slabs
+    cJSON_Hooks hooks = {
+        .malloc_fn = interaction_arena_malloc,
+        .free_fn = interaction_arena_free,
+    };
+    cJSON_InitHooks(&hooks);
+
+    s_arena.base = heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!s_arena.base) {
+        ESP_LOGW(TAG, "No PSRAM for a %u byte arena; interactions use the heap", (unsigned)bytes);
+        return ESP_ERR_NO_MEM;
+    }
+    s_arena.cap = bytes;
+    s_arena.last = ARENA_NO_BLOCK;
+    ESP_LOGI(TAG, "%u KB interaction arena in PSRAM", (unsigned)(bytes / 1024));
+    return ESP_OK;
+}
+
+bool interaction_arena_begin(void)
+{
+    bool claimed = false;
+    portENTER_CRITICAL(&s_owner_lock);
+    if (s_arena.base && !s_arena.owner) {
+        s_arena.owner = xTaskGetCurrentTaskHandle();
+        claimed = true;
+    }
+    portEXIT_CRITICAL(&s_owner_lock);
+    return claimed;
+}
+
+void interaction_arena_end(void)
+{
+    if (!owned_here()) {
+        return;
+    }
+    if (s_arena.live_blocks) {
+        ESP_LOGW(TAG, "%u blocks not freed before reset", (unsigned)s_arena.live_blocks);
+    }
+    ESP_LOGD(TAG, "Interaction used %u bytes (high water %u), %u heap fallbacks", (unsigned)s_arena.top,
+             (unsigned)s_arena.high_water, (unsigned)s_arena.heap_fallbacks);
+    s_arena.top = 0;
+    s_arena.last = ARENA_NO_BLOCK;
+    s_arena.live_blocks = 0;
+    s_arena.heap_fallbacks = 0;
+
+    portENTER_CRITICAL(&s_owner_lock);
+    s_arena.owner = NULL;
+    portEXIT_CRITICAL(&s_owner_lock);
+}
+
+void *interaction_arena_malloc(size_t size)
+{
+    if (!owned_here() || size == 0) {
+        return slab_malloc(size);
+    }
+    size_t need = sizeof(arena_header_t) + align_up(size);
+    if (need > s_arena.cap - s_arena.top) {
+        if (s_arena.heap_fallbacks++ == 0) {
+            ESP_LOGW(TAG, "Arena full (%u/%u bytes), using the heap", (unsigned)s_arena.top, (unsigned)s_arena.cap);
+        }
+        return slab_malloc(size);
+    }
+    arena_header_t *hdr = (arena_header_t *)(s_arena.base + s_arena.top);
+    hdr->size = (uint32_t)size;
+    s_arena.last = s_arena.top;
+    s_arena.top += need;
+    s_arena.live_blocks++;
+    if (s_arena.top > s_arena.high_water) {
+        s_arena.high_water = s_arena.top;
+    }
+    return hdr + 1;
+}
+
+void *interaction_arena_calloc(size_t count, size_t size)
+{
+    if (size && count > SIZE_MAX / size) {
+        return NULL;
+    }
+    void *ptr = interaction_arena_malloc(count * size);
+    if (ptr) {
+        memset(ptr, 0, count * size);
+    }
+    return ptr;
+}
+
+void *interaction_arena_realloc(void *ptr, size_t size)
+{
+    if (!ptr) {
+        return interaction_arena_malloc(size);
+    }
+    if (!in_arena(ptr)) {
+        return slab_realloc(ptr, size);
+    }
+
+    arena_header_t *hdr = header_of(ptr);
+    size_t offset = (uint8_t *)hdr - s_arena.base;
+    if (owned_here() && offset == s_arena.last) {
+        // Newest block: grow or shrink in place
+        size_t need = sizeof(arena_header_t) + align_up(size);
+        if (need <= s_arena.cap - offset) {
+            hdr->size = (uint32_t)size;
+            s_arena.top = offset + need;
+            if (s_arena.top > s_arena.high_water) {
+                s_arena.high_water = s_arena.top;
+            }
+            return ptr;
+        }
+    }
+
+    void *moved = interaction_arena_malloc(size);
+    if (moved) {
+        memcpy(moved, ptr, hdr->size < size ? hdr->size : size);
+        interaction_arena_free(ptr);
+    }
+    return moved;
+}
+
+void interaction_arena_free(void *ptr)
+{
+    if (!ptr) {
+        return;
+    }
+    if (!in_arena(ptr)) {
+        slab_free(ptr);
+        return;
+    }
+    if (!owned_here()) {
+        return;
+    }
+    size_t offset = (uint8_t *)header_of(ptr) - s_arena.base;
+    if (s_arena.live_blocks) {
+        s_arena.live_blocks--;
+    }
+    if (offset == s_arena.last) {
+        s_arena.top = offset;
+        s_arena.last = ARENA_NO_BLOCK;
+    }
+}
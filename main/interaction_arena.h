@@ -0,0 +1,62 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Per-interaction bump allocator in PSRAM.
+ *
+ * One voice interaction makes dozens of short-lived allocations (request
+ * payloads, response buffers, cJSON trees, base64 blocks) that all die when
+ * it ends. Serving them from one arena that is reset afterwards keeps them
+ * from fragmenting the shared heap on a device that never reboots.
+ *
+ * The arena is bound to one task between interaction_arena_begin() and
+ * interaction_arena_end(). Allocations from any other task, or once the
+ * arena is full, fall back to the small-object slabs (slab_alloc.h) and
+ * past them the heap, so these functions are drop-in replacements for
+ * malloc/calloc/realloc/free anywhere a block is also freed through them. free is a no-op for
+ * arena blocks except the most recent one, which is rolled back so growing
+ * buffers reuse their space.
+ *
+ * The cJSON hooks are pointed here at init, with or without PSRAM.
+ * Strings from cJSON_Print*() must therefore be released with
+ * cJSON_free(), never free(), and nothing allocated during an interaction
+ * may outlive interaction_arena_end().
+ */
+
+/**
+ * Allocate the arena and install the cJSON hooks. Safe to call again.
+ *
+ * @return ESP_ERR_NO_MEM if PSRAM is short; everything then uses the heap
+ */
+esp_err_t interaction_arena_init(size_t bytes);
+
+/**
+ * Bind the arena to the calling task.
+ *
+ * @return false if the arena is missing or already bound to another task;
+ *         allocations then use the heap and interaction_arena_end() is not needed
+ */
+bool interaction_arena_begin(void);
+
+/**
+ * Release everything allocated since interaction_arena_begin(). Must be
+ * called by the task that began it.
+ */
+void interaction_arena_end(void);
+
+void *interaction_arena_malloc(size_t size);
+void *interaction_arena_calloc(size_t count, size_t size);
+void *interaction_arena_realloc(void *ptr, size_t size);
+void interaction_arena_free(void *ptr);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,55 @@
+#include "interaction_cancel.h"
+
+#include "audio_player.h"
+#include "esp_log.h"
+
+static const char *TAG = "interaction_cancel";
+
+// 0 = none; a token is never reused before the counter wraps
+static interaction_token_t s_next;
+static interaction_token_t s_active;
+static interaction_token_t s_cancelled;
+
+interaction_token_t interaction_cancel_begin(void)
+{
+    interaction_token_t token = __atomic_add_fetch(&s_next, 1, __ATOMIC_RELAXED);
+    if (token == 0) {
+        token = __atomic_add_fetch(&s_next, 1, __ATOMIC_RELAXED);
+    }
+    audio_player_resume(AUDIO_PLAYER_STREAM_VOICE);
+    __atomic_store_n(&s_active, token, __ATOMIC_RELEASE);
+    return token;
+}
+
+void interaction_cancel_end(interaction_token_t token)
+{
+    interaction_token_t expected = token;
+    if (token && __atomic_compare_exchange_n(&s_active, &expected, 0, false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+        // Every producer for the reply has returned by now
+        audio_player_resume(AUDIO_PLAYER_STREAM_VOICE);
+    }
+}
+
+bool interaction_cancel_request(void)
+{
+    interaction_token_t active = __atomic_load_n(&s_active, __ATOMIC_ACQUIRE);
+    if (active == 0) {
+        return false;
+    }
+    if (__atomic_exchange_n(&s_cancelled, active, __ATOMIC_ACQ_REL) != active) {
+        ESP_LOGI(TAG, "Reply %u cancelled", (unsigned)active);
+    }
+    audio_player_abort(AUDIO_PLAYER_STREAM_VOICE);
+    return true;
+}
+
+bool interaction_cancelled(void)
+{
+    interaction_token_t active = __atomic_load_n(&s_active, __ATOMIC_ACQUIRE);
+    return active != 0 && __atomic_load_n(&s_cancelled, __ATOMIC_ACQUIRE) == active;
+}
+
+bool interaction_in_progress(void)
+{
+    return __atomic_load_n(&s_active, __ATOMIC_ACQUIRE) != 0;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Barge-in for the reply in progress.
+ *
+ * Only one interaction replies at a time, so its cancellation token is
+ * global like the interaction arena: the task that starts a reply takes a
+ * token, and the HTTP reads, the TTS stream and the audio player poll
+ * interaction_cancelled() instead of having a token threaded through them.
+ * A second wake word, a button press or "stop" calls
+ * interaction_cancel_request() from its own task; the voice stream is
+ * flushed at once and every loop working for the reply bails out at its
+ * next check.
+ */
+
+typedef uint32_t interaction_token_t;
+
+/**
+ * Start a cancellable reply. Clears a cancel left over from the last one
+ * and lets the voice stream take audio again.
+ */
+interaction_token_t interaction_cancel_begin(void);
+
+/**
+ * The reply for token is over; a cancel requested after this is a no-op
+ * and the voice stream takes audio again. Ignored if a newer reply has
+ * begun since.
+ */
+void interaction_cancel_end(interaction_token_t token);
+
+/**
+ * Cancel the reply in progress and flush the voice stream.
+ *
+ * @return false if no reply was in progress
+ */
+bool interaction_cancel_request(void);
+
+/**
+ * Whether the reply in progress was cancelled. Cheap; poll it per chunk.
+ */
+bool interaction_cancelled(void);
+
+// Whether a reply is between begin and end, e.g. to keep background work off the network and flash
+bool interaction_in_progress(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,127 @@
+#include "interaction_pool.h"
+
+#include <stdlib.h>
+
+#include "esp_check.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/idf_additions.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "sdkconfig.h"
+
+static const char *TAG = "interaction_pool";
+
+struct interaction_pool {
+    interaction_pool_config_t cfg;
+    QueueHandle_t jobs;
+    SemaphoreHandle_t submit_lock;    // Submitters take turns so a drop and its re-send stay together
+    void *dropped;                    // One job, under submit_lock
+};
+
+static void worker_task(void *arg)
+{
+    interaction_pool_handle_t pool = (interaction_pool_handle_t)arg;
+    // The worker's job buffer lives as long as the worker
+    void *job = heap_caps_malloc(pool->cfg.job_size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!job) {
+        job = malloc(pool->cfg.job_size);
+    }
+    if (!job) {
+        ESP_LOGE(TAG, "No memory for a %u-byte job, worker exits", (unsigned)pool->cfg.job_size);
+        vTaskDelete(NULL);
+        return;
+    }
+    for (;;) {
+        if (xQueueReceive(pool->jobs, job, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+        pool->cfg.run(job, pool->cfg.ctx);
+    }
+}
+
+static BaseType_t start_worker(interaction_pool_handle_t pool)
+{
+    const task_placement_t *plan = task_placement_get(pool->cfg.placement);
+#if CONFIG_SPIRAM
+    if (pool->cfg.psram_stacks && plan && plan->stack_bytes) {
+        return xTaskCreatePinnedToCoreWithCaps(worker_task, plan->name, plan->stack_bytes, pool, plan->priority,
+                                               NULL, plan->core, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    }
+#endif
+    return task_placement_create(pool->cfg.placement, worker_task, pool, NULL);
+}
+
+esp_err_t interaction_pool_create(const interaction_pool_config_t *cfg, interaction_pool_handle_t *out)
+{
+    ESP_RETURN_ON_FALSE(cfg && out && cfg->run && cfg->job_size > 0 && cfg->queue_depth > 0 && cfg->workers > 0,
+                        ESP_ERR_INVALID_ARG, TAG, "invalid config");
+    *out = NULL;
+
+    interaction_pool_handle_t pool = calloc(1, sizeof(*pool));
+    ESP_RETURN_ON_FALSE(pool, ESP_ERR_NO_MEM, TAG, "pool");
+    pool->cfg = *cfg;
+#if !CONFIG_SPIRAM
+    pool->cfg.psram_stacks = false;
+#endif
+    pool->jobs = xQueueCreate(cfg->queue_depth, cfg->job_size);
+    pool->submit_lock = xSemaphoreCreateMutex();
+    pool->dropped = malloc(cfg->job_size);
+    if (!pool->jobs || !pool->submit_lock || !pool->dropped) {
+        ESP_LOGE(TAG, "No memory for %u jobs of %u bytes", (unsigned)cfg->queue_depth, (unsigned)cfg->job_size);
+        if (pool->jobs) {
+            vQueueDelete(pool->jobs);
+        }
+        if (pool->submit_lock) {
+            vSemaphoreDelete(pool->submit_lock);
+        }
+        free(pool->dropped);
+        free(pool);
+        return ESP_ERR_NO_MEM;
+    }
+
+    // Workers never exit, so from here on the pool is never freed
+    size_t started = 0;
+    while (started < cfg->workers && start_worker(pool) == pdPASS) {
+        ++started;
+    }
+    if (started == 0) {
+        ESP_LOGE(TAG, "No worker could be created");
+        vQueueDelete(pool->jobs);
+        vSemaphoreDelete(pool->submit_lock);
+        free(pool->dropped);
+        free(pool);
+        return ESP_ERR_NO_MEM;
+    }
+    if (started < cfg->workers) {
+        ESP_LOGW(TAG, "Only %u of %u workers started", (unsigned)started, (unsigned)cfg->workers);
+    }
+    ESP_LOGI(TAG, "%u workers, %u queued jobs of %u bytes%s", (unsigned)started, (unsigned)cfg->queue_depth,
+             (unsigned)cfg->job_size, cfg->psram_stacks ? ", PSRAM stacks" : "");
+    *out = pool;
+    return ESP_OK;
+}
+
+esp_err_t interaction_pool_submit(interaction_pool_handle_t pool, const void *job)
+{
+    ESP_RETURN_ON_FALSE(pool && job, ESP_ERR_INVALID_ARG, TAG, "bad args");
+
+    xSemaphoreTake(pool->submit_lock, portMAX_DELAY);
+    esp_err_t ret = ESP_OK;
+    if (xQueueSend(pool->jobs, job, 0) != pdPASS) {
+        if (pool->cfg.when_full == INTERACTION_POOL_DROP_OLDEST &&
+            xQueueReceive(pool->jobs, pool->dropped, 0) == pdTRUE) {
+            ESP_LOGW(TAG, "Queue full, dropping the oldest job");
+            if (pool->cfg.drop) {
+                pool->cfg.drop(pool->dropped, pool->cfg.ctx);
+            }
+        }
+        if (xQueueSend(pool->jobs, job, 0) != pdPASS) {
+            ESP_LOGW(TAG, "Queue full, job refused");
+            ret = ESP_ERR_TIMEOUT;
+        }
+    }
+    xSemaphoreGive(pool->submit_lock);
+    return ret;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "esp_err.h"
+#include "task_placement.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Fixed workers for interaction replies.
+ *
+ * The workers are created once and wait on a bounded queue of job
+ * structs, so a reply costs a queue copy instead of a task creation, and
+ * every job carries its own copy of the transcript and intent: two
+ * transcripts that arrive together never share a buffer. What happens to
+ * a job that finds the queue full is the pool's policy, chosen at create.
+ */
+
+typedef struct interaction_pool *interaction_pool_handle_t;
+
+typedef enum {
+    INTERACTION_POOL_REJECT,          // The new job is refused
+    INTERACTION_POOL_DROP_OLDEST,     // The oldest queued job makes room; the newest speech wins
+} interaction_pool_full_policy_t;
+
+// Runs on a worker with a private copy of the job
+typedef void (*interaction_pool_job_fn_t)(void *job, void *ctx);
+
+typedef struct {
+    interaction_pool_job_fn_t run;
+    interaction_pool_job_fn_t drop;   // Called on the submitting task for a job that never runs; may be NULL
+    void *ctx;
+    size_t job_size;
+    size_t queue_depth;               // Jobs waiting, not counting those running
+    size_t workers;
+    task_placement_id_t placement;    // Name, stack, priority and core of every worker
+    interaction_pool_full_policy_t when_full;
+    bool psram_stacks;                // Worker stacks in PSRAM; see CONFIG_KVA_INTERACTION_PSRAM_STACKS
+} interaction_pool_config_t;
+
+/**
+ * Allocate the queue and start the workers.
+ *
+ * @return ESP_ERR_NO_MEM if the queue or any worker could not be created
+ */
+esp_err_t interaction_pool_create(const interaction_pool_config_t *cfg, interaction_pool_handle_t *out);
+
+/**
+ * Copy job into the queue without waiting.
+ *
+ * @return ESP_ERR_TIMEOUT if the queue is full and the policy refuses the
+ *         job; the caller still owns whatever the job refers to
+ */
+esp_err_t interaction_pool_submit(interaction_pool_handle_t pool, const void *job);
+
+#ifdef __cplusplus
+}
+#endif
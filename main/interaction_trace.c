@@ -0,0 +1,141 @@
+#include "interaction_trace.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "esp_cpu.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+
+static const char *TAG = "interaction_trace";
+
+// Cycle deltas are printed only below this gap; the 32-bit counter wraps in ~17 s at 240 MHz
+#define CYCLE_DELTA_MAX_US 10000000
+
+static const char *const POINT_NAMES[INTERACTION_TRACE_POINT_COUNT] = {
+    [INTERACTION_TRACE_WAKE] = "wake",
+    [INTERACTION_TRACE_VAD_ONSET] = "vad_onset",
+    [INTERACTION_TRACE_VAD_OFFSET] = "vad_offset",
+    [INTERACTION_TRACE_UPLINK_FIRST_BYTE] = "uplink_first_byte",
+    [INTERACTION_TRACE_STT_FINAL] = "stt_final",
+    [INTERACTION_TRACE_LLM_FIRST_TOKEN] = "llm_first_token",
+    [INTERACTION_TRACE_TTS_FIRST_BYTE] = "tts_first_byte",
+    [INTERACTION_TRACE_FIRST_DMA_WRITE] = "first_dma_write",
+};
+
+static struct {
+    bool open;
+    uint32_t next_id;
+    interaction_trace_t record;
+} s_trace;
+
+static portMUX_TYPE s_trace_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static void stamp_locked(interaction_trace_point_t point, int64_t now_us, uint32_t cycles, uint8_t core)
+{
+    interaction_trace_stamp_t *stamp = &s_trace.record.points[point];
+    if (stamp->time_us == 0) {
+        stamp->time_us = now_us;
+        stamp->cycles = cycles;
+        stamp->core = core;
+    }
+}
+
+void interaction_trace_begin(interaction_trace_point_t origin)
+{
+    if (origin >= INTERACTION_TRACE_POINT_COUNT) {
+        return;
+    }
+    // Read the clocks outside the lock so the stamp is not delayed by a waiter
+    uint32_t cycles = (uint32_t)esp_cpu_get_cycle_count();
+    int64_t now_us = esp_timer_get_time();
+    uint8_t core = (uint8_t)esp_cpu_get_core_id();
+
+    portENTER_CRITICAL(&s_trace_lock);
+    const interaction_trace_t *rec = &s_trace.record;
+    bool restart = !s_trace.open ||
+                   now_us - rec->points[rec->origin].time_us > (int64_t)INTERACTION_TRACE_STALE_MS * 1000 ||
+                   (rec->points[origin].time_us != 0 && rec->points[INTERACTION_TRACE_STT_FINAL].time_us == 0);
+    if (restart) {
+        memset(&s_trace.record, 0, sizeof(s_trace.record));
+        s_trace.record.id = ++s_trace.next_id;
+        s_trace.record.origin = origin;
+        s_trace.open = true;
+    }
+    stamp_locked(origin, now_us, cycles, core);
+    portEXIT_CRITICAL(&s_trace_lock);
+}
+
+void interaction_trace_mark(interaction_trace_point_t point)
+{
+    if (point >= INTERACTION_TRACE_POINT_COUNT || !s_trace.open) {
+        return;
+    }
+    uint32_t cycles = (uint32_t)esp_cpu_get_cycle_count();
+    int64_t now_us = esp_timer_get_time();
+    uint8_t core = (uint8_t)esp_cpu_get_core_id();
+
+    portENTER_CRITICAL(&s_trace_lock);
+    if (s_trace.open) {
+        stamp_locked(point, now_us, cycles, core);
+    }
+    portEXIT_CRITICAL(&s_trace_lock);
+}
+
+bool interaction_trace_finish(interaction_trace_t *out)
+{
+    bool was_open = false;
+    portENTER_CRITICAL(&s_trace_lock);
+    if (s_trace.open) {
+        if (out) {
+            *out = s_trace.record;
+        }
+        s_trace.open = false;
+        was_open = true;
+    }
+    portEXIT_CRITICAL(&s_trace_lock);
+    return was_open;
+}
+
+int64_t interaction_trace_offset_us(const interaction_trace_t *trace, interaction_trace_point_t point)
+{
+    if (!trace || point >= INTERACTION_TRACE_POINT_COUNT || trace->points[point].time_us == 0) {
+        return -1;
+    }
+    return trace->points[point].time_us - trace->points[trace->origin].time_us;
+}
+
+const char *interaction_trace_point_name(interaction_trace_point_t point)
+{
+    return point < INTERACTION_TRACE_POINT_COUNT ? POINT_NAMES[point] : "unknown";
+}
+
+void interaction_trace_log(const interaction_trace_t *trace)
+{
+    if (!trace) {
+        return;
+    }
+    char line[384];
+    int len = snprintf(line, sizeof(line), "#%u from %s:", (unsigned)trace->id,
+                       interaction_trace_point_name(trace->origin));
+    const interaction_trace_stamp_t *prev = &trace->points[trace->origin];
+    for (int p = 0; p < INTERACTION_TRACE_POINT_COUNT && len > 0 && (size_t)len < sizeof(line); ++p) {
+        const interaction_trace_stamp_t *stamp = &trace->points[p];
+        if (stamp->time_us == 0 || p == (int)trace->origin) {
+            continue;
+        }
+        int64_t offset_us = interaction_trace_offset_us(trace, (interaction_trace_point_t)p);
+        long long abs_us = llabs((long long)offset_us);
+        len += snprintf(line + len, sizeof(line) - len, " %s=%c%lld.%03lld ms", POINT_NAMES[p],
+                        offset_us < 0 ? '-' : '+', abs_us / 1000, abs_us % 1000);
+        // Same-core neighbours in time order get an exact cycle count for the gap
+        if (prev->core == stamp->core && stamp->time_us >= prev->time_us &&
+            stamp->time_us - prev->time_us < CYCLE_DELTA_MAX_US && (size_t)len < sizeof(line)) {
+            len += snprintf(line + len, sizeof(line) - len, " (%u cyc)", (unsigned)(stamp->cycles - prev->cycles));
+        }
+        prev = stamp;
+    }
+    ESP_LOGI(TAG, "%s", line);
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// An open record whose origin is older than this is dropped by the next begin
+#ifndef INTERACTION_TRACE_STALE_MS
+#define INTERACTION_TRACE_STALE_MS 30000
+#endif
+
+// In the order they normally occur; not every path reaches every point
+typedef enum {
+    INTERACTION_TRACE_WAKE = 0,           // Wake word (WakeNet or openWakeWord) detected
+    INTERACTION_TRACE_VAD_ONSET,          // VAD gate opened an utterance
+    INTERACTION_TRACE_VAD_OFFSET,         // VAD gate closed it
+    INTERACTION_TRACE_UPLINK_FIRST_BYTE,  // First audio byte handed to the socket
+    INTERACTION_TRACE_STT_FINAL,          // Final transcript available
+    INTERACTION_TRACE_LLM_FIRST_TOKEN,    // First reply text from the LLM
+    INTERACTION_TRACE_TTS_FIRST_BYTE,     // First byte of the TTS response
+    INTERACTION_TRACE_FIRST_DMA_WRITE,    // First reply samples written to I2S DMA
+    INTERACTION_TRACE_POINT_COUNT,
+} interaction_trace_point_t;
+
+typedef struct {
+    int64_t time_us;                  // esp_timer time; 0 when the point was not reached
+    uint32_t cycles;                  // CPU cycle counter of the core that marked it
+    uint8_t core;
+} interaction_trace_stamp_t;
+
+typedef struct {
+    uint32_t id;                      // Increments per record, so lost records show as gaps
+    interaction_trace_point_t origin; // First point, the zero of every offset
+    interaction_trace_stamp_t points[INTERACTION_TRACE_POINT_COUNT];
+} interaction_trace_t;
+
+/**
+ * Latency tracepoints for one voice interaction.
+ *
+ * There is one record at a time. interaction_trace_begin() opens it at the
+ * first point of an interaction (wake or speech onset), every module along
+ * the path stamps its point with interaction_trace_mark(), and whoever
+ * reports the outcome takes the record with interaction_trace_finish().
+ * Only the first stamp of each point is kept, and marks with no open record
+ * are ignored, so points can be marked unconditionally from any task.
+ *
+ * esp_timer times are comparable across cores; the cycle counter is per
+ * core and only resolves gaps between points stamped on the same core.
+ */
+
+/**
+ * Stamp origin, opening a record unless one is already in progress.
+ * A record is replaced if it already has this origin but no final transcript
+ * (the previous utterance went nowhere) or is older than
+ * INTERACTION_TRACE_STALE_MS.
+ */
+void interaction_trace_begin(interaction_trace_point_t origin);
+
+// Stamp a point of the open record. Cheap and safe from any task.
+void interaction_trace_mark(interaction_trace_point_t point);
+
+/**
+ * Close the open record and copy it out.
+ *
+ * @return false if no record was open; *out is untouched
+ */
+bool interaction_trace_finish(interaction_trace_t *out);
+
+// Microseconds from the origin to point, or -1 if it was not reached
+int64_t interaction_trace_offset_us(const interaction_trace_t *trace, interaction_trace_point_t point);
+
+// Short snake_case name, used as the JSON key and in the console
+const char *interaction_trace_point_name(interaction_trace_point_t point);
+
+// One-line summary on the serial console
+void interaction_trace_log(const interaction_trace_t *trace);
+
+#ifdef __cplusplus
+}
+#endif
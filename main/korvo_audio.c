@@ -1,13 +1,49 @@
 #include "korvo_audio.h"
 
+#include "deadline_monitor.h"
+#include "kva_config_defaults.h"
 #include "driver/gpio.h"
 #include "esp_check.h"
 #include "esp_log.h"
+#include "esp_heap_caps.h"
+#include "esp_memory_utils.h"
+#include "esp_private/cache_utils.h"
+#include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "task_placement.h"
+#include <string.h>
 
 static const char *TAG = "korvo_audio";
 
+#define RING_MASK (KORVO_AUDIO_RING_SAMPLES - 1)
+_Static_assert((KORVO_AUDIO_RING_SAMPLES & RING_MASK) == 0, "ring size must be a power of two");
+
+// Each DMA buffer is published from the I2S interrupt as it fills: 128
+// frames keep publish latency at 8 ms, and 16 of them cover ~120 ms (a
+// flash erase) when the interrupt is not built into IRAM and is held off
+#define CAPTURE_DMA_FRAMES 128
+#define CAPTURE_DMA_BUFFERS 16
+#define CAPTURE_CHANNELS 2  // KORVO1_CHANNEL_STEREO below, or the two TDM mic slots
+#define CAPTURE_CHUNK_SAMPLES (CAPTURE_DMA_FRAMES * CAPTURE_CHANNELS)
+// The chunk being written by the interrupt is never handed to readers
+#define RING_READABLE (KORVO_AUDIO_RING_SAMPLES - CAPTURE_CHUNK_SAMPLES)
+// The reference ring holds one sample for each frame of the capture ring
+#define REF_RING_FRAMES (KORVO_AUDIO_RING_SAMPLES / CAPTURE_CHANNELS)
+#define REF_RING_MASK (REF_RING_FRAMES - 1)
+
+#if CONFIG_KVA_CAPTURE_TDM
+_Static_assert(CONFIG_KVA_TDM_SLOTS >= 2 && CONFIG_KVA_TDM_SLOTS <= KORVO1_TDM_MAX_SLOTS, "TDM slot count");
+_Static_assert(CONFIG_KVA_TDM_MIC0_SLOT < CONFIG_KVA_TDM_SLOTS && CONFIG_KVA_TDM_MIC1_SLOT < CONFIG_KVA_TDM_SLOTS &&
+                   CONFIG_KVA_TDM_REF_SLOT < CONFIG_KVA_TDM_SLOTS,
+               "TDM slot outside the frame");
+#endif
+
+static portMUX_TYPE s_anchor_lock = portMUX_INITIALIZER_UNLOCKED;
+// One DMA buffer per period; a late interrupt is a flash write or a long critical section
+static deadline_monitor_stage_t *s_rx_deadline;
+
 static korvo1_config_t default_korvo1_pins(int sample_rate_hz)
 {
     korvo1_config_t cfg = {
@@ -17,13 +53,163 @@ static korvo1_config_t default_korvo1_pins(int sample_rate_hz)
         .ws_io_num = GPIO_NUM_17,
         .mclk_io_num = GPIO_NUM_0,
         .sample_rate_hz = sample_rate_hz,
-        .dma_buffer_count = 4,
-        .dma_buffer_len = 256,
-        .channel_format = I2S_CHANNEL_FMT_RIGHT_LEFT, // Changed to STEREO to support multiple microphone channels
+        .dma_buffer_count = CAPTURE_DMA_BUFFERS,
+        .dma_buffer_len = CAPTURE_DMA_FRAMES,
+        .channel_format = KORVO1_CHANNEL_STEREO, // Both microphones, interleaved
+#if CONFIG_KVA_CAPTURE_TDM
+        .mode = KORVO1_CAPTURE_TDM,
+        .tdm_slots = CONFIG_KVA_TDM_SLOTS,
+#endif
     };
     return cfg;
 }
 
+static void log_first_capture(const int16_t *buffer, size_t valid_samples)
+{
+    int16_t first_sample = buffer[0];
+    int16_t max_sample = first_sample;
+    int16_t min_sample = first_sample;
+    int64_t sum = 0;
+    for (size_t i = 0; i < valid_samples && i < 100; i++) {
+        if (buffer[i] > max_sample) max_sample = buffer[i];
+        if (buffer[i] < min_sample) min_sample = buffer[i];
+        sum += buffer[i] >= 0 ? buffer[i] : -buffer[i];
+    }
+    float avg_level = (float)sum / (float)valid_samples;
+    ESP_LOGI(TAG, "First audio capture: %zu samples, first=%d, min=%d, max=%d, avg_level=%.0f",
+             valid_samples, first_sample, min_sample, max_sample, avg_level);
+}
+
+/**
+ * I2S interrupt: copy the DMA buffer that just filled into the ring, publish
+ * it with a release store of write_pos and wake the readers. This is the
+ * only copy between the microphones and a reader's buffer; the DMA buffer
+ * itself is reused one ring period later, so it cannot be lent out.
+ */
+static bool IRAM_ATTR capture_on_rx(const void *data, size_t bytes, void *arg)
+{
+    korvo_audio_t *ctx = (korvo_audio_t *)arg;
+#if CONFIG_I2S_ISR_IRAM_SAFE
+    if (ctx->rings_external && !spi_flash_cache_enabled()) {
+        // PSRAM is behind the cache a flash write has turned off: the buffer is lost as if the interrupt were late
+        __atomic_fetch_add(&ctx->mic.overruns, 1, __ATOMIC_RELAXED);
+        return false;
+    }
+#endif
+    deadline_monitor_begin(s_rx_deadline);
+    size_t frame_samples = ctx->tdm_slots ? ctx->tdm_slots : CAPTURE_CHANNELS;
+    size_t samples = bytes / (sizeof(int16_t) * frame_samples) * CAPTURE_CHANNELS;
+    if (samples > CAPTURE_CHUNK_SAMPLES) {
+        samples = CAPTURE_CHUNK_SAMPLES;
+    }
+    uint32_t pos = ctx->write_pos;  // Only this interrupt writes it
+    const int16_t *inject = __atomic_load_n(&ctx->inject, __ATOMIC_ACQUIRE);
+    if (inject) {
+        // The DMA buffer still goes around; its samples are replaced by the clip's, silence past its end
+        for (size_t i = 0; i < samples; i += CAPTURE_CHANNELS) {
+            int16_t sample = ctx->inject_pos < ctx->inject_frames ? inject[ctx->inject_pos++] : 0;
+            for (size_t c = 0; c < CAPTURE_CHANNELS; ++c) {
+                ctx->ring[(pos + i + c) & RING_MASK] = sample;
+            }
+            if (ctx->ref_ring) {
+                ctx->ref_ring[((pos + i) / CAPTURE_CHANNELS) & REF_RING_MASK] = 0;
+            }
+        }
+        if (ctx->inject_pos >= ctx->inject_frames) {
+            __atomic_store_n(&ctx->inject, NULL, __ATOMIC_RELEASE);
+        }
+    } else if (ctx->tdm_slots) {
+        // Pick the mic pair and the loopback out of each frame of slots
+        const int16_t *frame = (const int16_t *)data;
+        for (size_t i = 0; i < samples; i += CAPTURE_CHANNELS) {
+            ctx->ring[(pos + i) & RING_MASK] = frame[ctx->tdm_mic_slots[0]];
+            ctx->ring[(pos + i + 1) & RING_MASK] = frame[ctx->tdm_mic_slots[1]];
+            if (ctx->ref_ring) {
+                ctx->ref_ring[((pos + i) / CAPTURE_CHANNELS) & REF_RING_MASK] = frame[ctx->tdm_ref_slot];
+            }
+            frame += ctx->tdm_slots;
+        }
+    } else {
+        uint32_t offset = pos & RING_MASK;
+        size_t first = samples;
+        if (offset + first > KORVO_AUDIO_RING_SAMPLES) {
+            first = KORVO_AUDIO_RING_SAMPLES - offset;
+        }
+        memcpy(&ctx->ring[offset], data, first * sizeof(int16_t));
+        if (samples > first) {
+            memcpy(&ctx->ring[0], (const int16_t *)data + first, (samples - first) * sizeof(int16_t));
+        }
+    }
+
+    // The buffer's last sample was captured as its DMA transfer completed
+    int64_t now_us = esp_timer_get_time();
+    portENTER_CRITICAL_ISR(&s_anchor_lock);
+    ctx->anchor_us = now_us;
+    ctx->anchor_pos = pos + (uint32_t)samples;
+    portEXIT_CRITICAL_ISR(&s_anchor_lock);
+    __atomic_store_n(&ctx->write_pos, pos + (uint32_t)samples, __ATOMIC_RELEASE);
+
+    BaseType_t woken = pdFALSE;
+    for (int i = 0; i < KORVO_AUDIO_MAX_READERS; i++) {
+        SemaphoreHandle_t ready = ctx->readers[i].data_ready;
+        if (ctx->readers[i].in_use && ready) {
+            xSemaphoreGiveFromISR(ready, &woken);
+        }
+    }
+    deadline_monitor_end(s_rx_deadline);
+    return woken == pdTRUE;
+}
+
+/**
+ * Rings of samples, zeroed. With the I2S interrupt built into IRAM
+ * (CONFIG_I2S_ISR_IRAM_SAFE) it keeps writing them while a flash write has
+ * the cache, and PSRAM behind it, turned off, so internal RAM comes first.
+ */
+static int16_t *alloc_ring(size_t samples)
+{
+#if CONFIG_I2S_ISR_IRAM_SAFE
+    const uint32_t caps[] = {MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT};
+#else
+    const uint32_t caps[] = {MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT};
+#endif
+    for (size_t i = 0; i < sizeof(caps) / sizeof(caps[0]); i++) {
+        int16_t *ring = heap_caps_calloc(samples, sizeof(int16_t), caps[i]);
+        if (ring) {
+            return ring;
+        }
+    }
+    return NULL;
+}
+
+typedef struct {
+    korvo_audio_t *ctx;
+    korvo1_config_t cfg;
+    esp_err_t err;
+    SemaphoreHandle_t done;
+} capture_start_t;
+
+// The I2S interrupt is allocated on the core that creates the channel, so
+// bring RX up from the audio core and keep DMA completions off the core
+// that services Wi-Fi
+static void capture_start_task(void *arg)
+{
+    capture_start_t *start = (capture_start_t *)arg;
+    korvo_audio_t *ctx = start->ctx;
+    esp_err_t err = korvo1_init(&ctx->mic, &start->cfg);
+    if (err == ESP_OK) {
+        err = korvo1_set_rx_callback(&ctx->mic, capture_on_rx, ctx);
+        if (err == ESP_OK) {
+            err = korvo1_start(&ctx->mic);
+        }
+        if (err != ESP_OK) {
+            korvo1_deinit(&ctx->mic);
+        }
+    }
+    start->err = err;
+    xSemaphoreGive(start->done);
+    vTaskDelete(NULL);
+}
+
 esp_err_t korvo_audio_init(korvo_audio_t *ctx, int sample_rate_hz)
 {
     ESP_RETURN_ON_FALSE(ctx, ESP_ERR_INVALID_ARG, TAG, "ctx required");
@@ -33,95 +219,286 @@ esp_err_t korvo_audio_init(korvo_audio_t *ctx, int sample_rate_hz)
     ESP_LOGI(TAG, "  Sample Rate: %d Hz", cfg.sample_rate_hz);
     ESP_LOGI(TAG, "  Pins: DIN=GPIO%d, BCLK=GPIO%d, WS=GPIO%d, MCLK=GPIO%d",
              cfg.din_io_num, cfg.bclk_io_num, cfg.ws_io_num, cfg.mclk_io_num);
-    const char* channel_fmt_str = (cfg.channel_format == I2S_CHANNEL_FMT_ONLY_LEFT) ? "ONLY_LEFT" : 
-                                  (cfg.channel_format == I2S_CHANNEL_FMT_ONLY_RIGHT) ? "ONLY_RIGHT" : "STEREO";
+#if CONFIG_KVA_CAPTURE_TDM
+    ESP_LOGI(TAG, "  TDM: %d slots, mics in %d and %d, loopback in %d", CONFIG_KVA_TDM_SLOTS,
+             CONFIG_KVA_TDM_MIC0_SLOT, CONFIG_KVA_TDM_MIC1_SLOT, CONFIG_KVA_TDM_REF_SLOT);
+#else
+    const char* channel_fmt_str = (cfg.channel_format == KORVO1_CHANNEL_ONLY_LEFT) ? "ONLY_LEFT" :
+                                  (cfg.channel_format == KORVO1_CHANNEL_ONLY_RIGHT) ? "ONLY_RIGHT" : "STEREO";
     ESP_LOGI(TAG, "  Channel Format: %s", channel_fmt_str);
-    ESP_LOGI(TAG, "  DMA: %d buffers x %d samples", cfg.dma_buffer_count, cfg.dma_buffer_len);
-    ESP_RETURN_ON_ERROR(korvo1_init(&ctx->mic, &cfg), TAG, "init failed");
-    esp_err_t start_err = korvo1_start(&ctx->mic);
-    ESP_RETURN_ON_ERROR(start_err, TAG, "start failed");
+#endif
+    ESP_LOGI(TAG, "  DMA: %d buffers x %d frames", cfg.dma_buffer_count, cfg.dma_buffer_len);
+
+    memset(ctx->readers, 0, sizeof(ctx->readers));
+    ctx->write_pos = 0;
+    ctx->anchor_pos = 0;
+    ctx->anchor_us = 0;
+    ctx->readers_mutex = xSemaphoreCreateMutex();
+    ctx->ring = alloc_ring(KORVO_AUDIO_RING_SAMPLES);
+    ctx->tdm_slots = 0;
+    ctx->ref_ring = NULL;
+#if CONFIG_KVA_CAPTURE_TDM
+    ctx->tdm_slots = CONFIG_KVA_TDM_SLOTS;
+    ctx->tdm_mic_slots[0] = CONFIG_KVA_TDM_MIC0_SLOT;
+    ctx->tdm_mic_slots[1] = CONFIG_KVA_TDM_MIC1_SLOT;
+    if (CONFIG_KVA_TDM_REF_SLOT >= 0) {
+        ctx->tdm_ref_slot = (uint8_t)CONFIG_KVA_TDM_REF_SLOT;
+        ctx->ref_ring = alloc_ring(REF_RING_FRAMES);
+    }
+#endif
+    ctx->rings_external = (ctx->ring && esp_ptr_external_ram(ctx->ring)) ||
+                          (ctx->ref_ring && esp_ptr_external_ram(ctx->ref_ring));
+    if (!ctx->readers_mutex || !ctx->ring || (CONFIG_KVA_CAPTURE_TDM && CONFIG_KVA_TDM_REF_SLOT >= 0 && !ctx->ref_ring)) {
+        korvo_audio_shutdown(ctx);
+        return ESP_ERR_NO_MEM;
+    }
+
     ctx->sample_rate_hz = sample_rate_hz;
-    ctx->stream_mutex = xSemaphoreCreateMutex();
-    if (!ctx->stream_mutex) {
-        korvo1_stop(&ctx->mic);
-        korvo1_deinit(&ctx->mic);
+    uint32_t dma_period_us = (uint32_t)((int64_t)CAPTURE_DMA_FRAMES * 1000000 / sample_rate_hz);
+    const deadline_monitor_config_t rx_deadline = {
+        .name = "i2s_rx",
+        .period_us = dma_period_us,
+        .budget_us = dma_period_us / 8,
+    };
+    if (deadline_monitor_register(&rx_deadline, &s_rx_deadline) != ESP_OK) {
+        s_rx_deadline = NULL;
+    }
+
+    capture_start_t start = {
+        .ctx = ctx,
+        .cfg = cfg,
+        .err = ESP_FAIL,
+        .done = xSemaphoreCreateBinary(),
+    };
+    if (!start.done) {
+        korvo_audio_shutdown(ctx);
+        return ESP_ERR_NO_MEM;
+    }
+    if (task_placement_create(TASK_PLACEMENT_CAPTURE, capture_start_task, &start, NULL) != pdPASS) {
+        vSemaphoreDelete(start.done);
+        korvo_audio_shutdown(ctx);
         return ESP_ERR_NO_MEM;
     }
-    ESP_LOGI(TAG, "Korvo-1 microphone initialized and started successfully");
+    xSemaphoreTake(start.done, portMAX_DELAY);
+    vSemaphoreDelete(start.done);
+    if (start.err != ESP_OK) {
+        ESP_LOGE(TAG, "init failed: %s", esp_err_to_name(start.err));
+        korvo_audio_shutdown(ctx);
+        return start.err;
+    }
+
+    // Sanity-check the microphones on the first buffers
+    for (int i = 0; i < 10 && __atomic_load_n(&ctx->write_pos, __ATOMIC_ACQUIRE) < CAPTURE_CHUNK_SAMPLES; i++) {
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+    if (__atomic_load_n(&ctx->write_pos, __ATOMIC_ACQUIRE) >= CAPTURE_CHUNK_SAMPLES) {
+        log_first_capture(ctx->ring, CAPTURE_CHUNK_SAMPLES);
+    } else {
+        ESP_LOGW(TAG, "No audio from the microphones after 100 ms");
+    }
+    ESP_LOGI(TAG, "Korvo-1 microphone initialized and started successfully (%d sample ring)",
+             KORVO_AUDIO_RING_SAMPLES);
     return ESP_OK;
 }
 
-esp_err_t korvo_audio_acquire(korvo_audio_t *ctx, TickType_t timeout_ticks)
+uint32_t korvo_audio_dma_overruns(korvo_audio_t *ctx)
 {
-    ESP_RETURN_ON_FALSE(ctx && ctx->stream_mutex, ESP_ERR_INVALID_STATE, TAG, "bad ctx");
-    if (xSemaphoreTake(ctx->stream_mutex, timeout_ticks) != pdTRUE) {
-        return ESP_ERR_TIMEOUT;
+    return ctx ? korvo1_overruns(&ctx->mic) : 0;
+}
+
+esp_err_t korvo_audio_inject(korvo_audio_t *ctx, const int16_t *mono, uint32_t frames)
+{
+    ESP_RETURN_ON_FALSE(ctx && ctx->ring && mono && frames, ESP_ERR_INVALID_ARG, TAG, "bad args");
+    ESP_RETURN_ON_FALSE(!korvo_audio_injecting(ctx), ESP_ERR_INVALID_STATE, TAG, "clip still playing");
+    // The interrupt reads these only once it sees the clip pointer
+    ctx->inject_frames = frames;
+    ctx->inject_pos = 0;
+    __atomic_store_n(&ctx->inject, mono, __ATOMIC_RELEASE);
+    return ESP_OK;
+}
+
+bool korvo_audio_injecting(const korvo_audio_t *ctx)
+{
+    return ctx && __atomic_load_n(&ctx->inject, __ATOMIC_ACQUIRE) != NULL;
+}
+
+int64_t korvo_audio_sample_time_us(korvo_audio_t *ctx, uint32_t pos)
+{
+    portENTER_CRITICAL(&s_anchor_lock);
+    int64_t anchor_us = ctx->anchor_us;
+    uint32_t anchor_pos = ctx->anchor_pos;
+    portEXIT_CRITICAL(&s_anchor_lock);
+    int32_t behind = (int32_t)(anchor_pos - pos);
+    return anchor_us - (int64_t)behind * 1000000 / ((int64_t)ctx->sample_rate_hz * CAPTURE_CHANNELS);
+}
+
+esp_err_t korvo_audio_open_reader(korvo_audio_t *ctx, const char *name, korvo_audio_reader_t **reader_out)
+{
+    ESP_RETURN_ON_FALSE(ctx && ctx->readers_mutex && reader_out, ESP_ERR_INVALID_ARG, TAG, "bad args");
+    xSemaphoreTake(ctx->readers_mutex, portMAX_DELAY);
+    korvo_audio_reader_t *reader = NULL;
+    for (int i = 0; i < KORVO_AUDIO_MAX_READERS; i++) {
+        if (!ctx->readers[i].in_use) {
+            reader = &ctx->readers[i];
+            break;
+        }
+    }
+    if (!reader) {
+        xSemaphoreGive(ctx->readers_mutex);
+        ESP_LOGE(TAG, "No free audio reader for %s", name ? name : "?");
+        return ESP_ERR_NO_MEM;
     }
+    if (!reader->data_ready) {
+        reader->data_ready = xSemaphoreCreateBinary();
+        if (!reader->data_ready) {
+            xSemaphoreGive(ctx->readers_mutex);
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    reader->ctx = ctx;
+    reader->name = name;
+    reader->overruns = 0;
+    reader->read_pos = __atomic_load_n(&ctx->write_pos, __ATOMIC_ACQUIRE);
+    reader->in_use = true;
+    xSemaphoreGive(ctx->readers_mutex);
+    ESP_LOGI(TAG, "Audio reader '%s' opened", name ? name : "?");
+    *reader_out = reader;
     return ESP_OK;
 }
 
-void korvo_audio_release(korvo_audio_t *ctx)
+void korvo_audio_close_reader(korvo_audio_reader_t *reader)
 {
-    if (!ctx || !ctx->stream_mutex) {
+    if (!reader || !reader->ctx) {
         return;
     }
-    xSemaphoreGive(ctx->stream_mutex);
+    korvo_audio_t *ctx = reader->ctx;
+    xSemaphoreTake(ctx->readers_mutex, portMAX_DELAY);
+    reader->in_use = false;
+    xSemaphoreGive(ctx->readers_mutex);
+    // data_ready is kept for the slot's next user so the capture task never sees it freed
+}
+
+void korvo_audio_reader_sync(korvo_audio_reader_t *reader)
+{
+    if (!reader || !reader->ctx) {
+        return;
+    }
+    reader->read_pos = __atomic_load_n(&reader->ctx->write_pos, __ATOMIC_ACQUIRE);
+    xSemaphoreTake(reader->data_ready, 0);
+}
+
+uint32_t korvo_audio_reader_seek(korvo_audio_reader_t *reader, uint32_t pos)
+{
+    if (!reader || !reader->ctx) {
+        return pos;
+    }
+    uint32_t head = __atomic_load_n(&reader->ctx->write_pos, __ATOMIC_ACQUIRE);
+    // Wrap-safe: how far pos lies behind the live edge
+    uint32_t behind = head - pos;
+    if ((int32_t)behind < 0) {
+        pos = head;
+    } else if (behind > RING_READABLE) {
+        pos = head - RING_READABLE;
+    }
+    // Keep the cursor on a frame boundary
+    pos -= (head - pos) % CAPTURE_CHANNELS;
+    reader->read_pos = pos;
+    xSemaphoreTake(reader->data_ready, 0);
+    return pos;
+}
+
+uint32_t korvo_audio_write_pos(const korvo_audio_t *ctx)
+{
+    return ctx ? __atomic_load_n(&ctx->write_pos, __ATOMIC_ACQUIRE) : 0;
+}
+
+size_t korvo_audio_reader_available(const korvo_audio_reader_t *reader)
+{
+    if (!reader || !reader->ctx) {
+        return 0;
+    }
+    uint32_t avail = __atomic_load_n(&reader->ctx->write_pos, __ATOMIC_ACQUIRE) - reader->read_pos;
+    return avail > RING_READABLE ? RING_READABLE : avail;
 }
 
-esp_err_t korvo_audio_capture_locked(korvo_audio_t *ctx,
-                                     int16_t *buffer,
-                                     size_t samples_requested,
-                                     size_t *samples_read,
-                                     TickType_t timeout_ticks)
+esp_err_t korvo_audio_read(korvo_audio_reader_t *reader,
+                           int16_t *buffer,
+                           size_t samples_requested,
+                           size_t *samples_read,
+                           TickType_t timeout_ticks)
 {
-    ESP_RETURN_ON_FALSE(ctx && buffer, ESP_ERR_INVALID_ARG, TAG, "bad args");
-    size_t bytes_read = 0;
-    size_t bytes_to_read = samples_requested * sizeof(int16_t);
-    esp_err_t err = korvo1_read(&ctx->mic, buffer, bytes_to_read, &bytes_read, timeout_ticks);
+    ESP_RETURN_ON_FALSE(reader && reader->in_use && buffer, ESP_ERR_INVALID_ARG, TAG, "bad args");
+    korvo_audio_t *ctx = reader->ctx;
     if (samples_read) {
-        size_t sample_size = sizeof(int16_t);
-        *samples_read = sample_size > 0 ? bytes_read / sample_size : 0;
-    }
-    
-    // Debug: Log first capture and periodic stats
-    static bool first_capture = true;
-    static int capture_count = 0;
-    if (first_capture && err == ESP_OK && bytes_read > 0) {
-        int16_t first_sample = buffer[0];
-        int16_t max_sample = first_sample;
-        int16_t min_sample = first_sample;
-        int64_t sum = 0;
-        size_t sample_size = sizeof(int16_t);
-        size_t valid_samples = sample_size > 0 ? bytes_read / sample_size : 0;
-        for (size_t i = 0; i < valid_samples && i < 100; i++) {
-            if (buffer[i] > max_sample) max_sample = buffer[i];
-            if (buffer[i] < min_sample) min_sample = buffer[i];
-            sum += buffer[i] >= 0 ? buffer[i] : -buffer[i];
+        *samples_read = 0;
+    }
+    if (samples_requested > KORVO_AUDIO_RING_SAMPLES / 2) {
+        samples_requested = KORVO_AUDIO_RING_SAMPLES / 2;
+    }
+
+    TickType_t start = xTaskGetTickCount();
+    uint32_t head = __atomic_load_n(&ctx->write_pos, __ATOMIC_ACQUIRE);
+    while (head - reader->read_pos < samples_requested) {
+        TickType_t elapsed = xTaskGetTickCount() - start;
+        if (elapsed >= timeout_ticks) {
+            break;
         }
-        float avg_level = (float)sum / (float)valid_samples;
-        ESP_LOGI(TAG, "First audio capture: %zu samples, first=%d, min=%d, max=%d, avg_level=%.0f",
-                 valid_samples, first_sample, min_sample, max_sample, avg_level);
-        first_capture = false;
+        xSemaphoreTake(reader->data_ready, timeout_ticks - elapsed);
+        head = __atomic_load_n(&ctx->write_pos, __ATOMIC_ACQUIRE);
     }
-    
-    capture_count++;
-    if (err != ESP_OK && capture_count % 100 == 0) {
-        ESP_LOGW(TAG, "Audio capture error: %s (err=%d), bytes_read=%zu", esp_err_to_name(err), err, bytes_read);
+
+    // Lagged past the ring: resume at the oldest sample not yet overwritten
+    if (head - reader->read_pos > RING_READABLE) {
+        reader->read_pos = head - RING_READABLE;
+        reader->overruns++;
+    }
+    size_t count = head - reader->read_pos;
+    if (count > samples_requested) {
+        count = samples_requested;
+    }
+    if (count == 0) {
+        return ESP_ERR_TIMEOUT;
     }
-    
-    return err;
+
+    uint32_t offset = reader->read_pos & RING_MASK;
+    size_t first = count;
+    if (offset + first > KORVO_AUDIO_RING_SAMPLES) {
+        first = KORVO_AUDIO_RING_SAMPLES - offset;
+    }
+    memcpy(buffer, &ctx->ring[offset], first * sizeof(int16_t));
+    if (count > first) {
+        memcpy(buffer + first, &ctx->ring[0], (count - first) * sizeof(int16_t));
+    }
+
+    // The producer may have lapped us while copying; if so the copy is torn
+    uint32_t after = __atomic_load_n(&ctx->write_pos, __ATOMIC_ACQUIRE);
+    if (after - reader->read_pos > RING_READABLE) {
+        reader->read_pos = after - RING_READABLE;
+        reader->overruns++;
+        return ESP_ERR_TIMEOUT;
+    }
+
+    reader->read_pos += (uint32_t)count;
+    if (samples_read) {
+        *samples_read = count;
+    }
+    return ESP_OK;
 }
 
-esp_err_t korvo_audio_capture(korvo_audio_t *ctx,
-                              int16_t *buffer,
-                              size_t samples_requested,
-                              size_t *samples_read,
-                              TickType_t timeout_ticks)
+bool korvo_audio_has_reference(const korvo_audio_t *ctx)
 {
-    ESP_RETURN_ON_ERROR(korvo_audio_acquire(ctx, timeout_ticks), TAG, "acquire");
-    esp_err_t err = korvo_audio_capture_locked(ctx, buffer, samples_requested, samples_read, timeout_ticks);
-    korvo_audio_release(ctx);
-    return err;
+    return ctx && ctx->ref_ring;
+}
+
+void korvo_audio_read_reference(korvo_audio_t *ctx, uint32_t pos, int16_t *out, size_t frames)
+{
+    uint32_t head = __atomic_load_n(&ctx->write_pos, __ATOMIC_ACQUIRE);
+    for (size_t i = 0; i < frames; ++i) {
+        uint32_t at = pos + (uint32_t)(i * CAPTURE_CHANNELS);
+        // Wrap-safe, like the readers: published and not yet overwritten
+        uint32_t behind = head - at;
+        out[i] = behind - 1 < RING_READABLE ? ctx->ref_ring[(at / CAPTURE_CHANNELS) & REF_RING_MASK] : 0;
+    }
 }
 
 void korvo_audio_shutdown(korvo_audio_t *ctx)
@@ -129,10 +506,27 @@ void korvo_audio_shutdown(korvo_audio_t *ctx)
     if (!ctx) {
         return;
     }
-    if (ctx->stream_mutex) {
-        vSemaphoreDelete(ctx->stream_mutex);
-        ctx->stream_mutex = NULL;
+    if (ctx->mic.initialized) {
+        korvo1_stop(&ctx->mic);
+        korvo1_deinit(&ctx->mic);
+    }
+    for (int i = 0; i < KORVO_AUDIO_MAX_READERS; i++) {
+        if (ctx->readers[i].data_ready) {
+            vSemaphoreDelete(ctx->readers[i].data_ready);
+            ctx->readers[i].data_ready = NULL;
+        }
+        ctx->readers[i].in_use = false;
+    }
+    if (ctx->readers_mutex) {
+        vSemaphoreDelete(ctx->readers_mutex);
+        ctx->readers_mutex = NULL;
+    }
+    if (ctx->ring) {
+        heap_caps_free(ctx->ring);
+        ctx->ring = NULL;
+    }
+    if (ctx->ref_ring) {
+        heap_caps_free(ctx->ref_ring);
+        ctx->ref_ring = NULL;
     }
-    korvo1_stop(&ctx->mic);
-    korvo1_deinit(&ctx->mic);
 }
@@ -1,29 +1,156 @@
 #pragma once
 
+#include <stdbool.h>
+#include <stdint.h>
+
 #include "esp_err.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/semphr.h"
+#include "freertos/task.h"
 #include "korvo1.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+// Capture ring length in int16 samples; must be a power of two.
+// 32768 samples is ~1 s of 16 kHz stereo.
+#ifndef KORVO_AUDIO_RING_SAMPLES
+#define KORVO_AUDIO_RING_SAMPLES 32768
+#endif
+
+// Consumers that can hold a read cursor at the same time
+// (AFE feed, openWakeWord, level meters, cloud uploader, ...)
+#ifndef KORVO_AUDIO_MAX_READERS
+#define KORVO_AUDIO_MAX_READERS 6
+#endif
+
+typedef struct korvo_audio korvo_audio_t;
+
+/**
+ * Independent read cursor into the capture ring.
+ *
+ * Every reader sees every sample the capture task publishes. A reader that
+ * falls more than KORVO_AUDIO_RING_SAMPLES behind is moved to the oldest
+ * sample still in the ring and its overrun counter is bumped; the producer
+ * never waits on readers.
+ */
 typedef struct {
+    korvo_audio_t *ctx;
+    const char *name;
+    uint32_t read_pos;                // Monotonic sample index of the next sample to read
+    uint32_t overruns;                // Times this reader lost samples
+    SemaphoreHandle_t data_ready;     // Given by the capture task after each publish
+    bool in_use;
+} korvo_audio_reader_t;
+
+struct korvo_audio {
     korvo1_t mic;
     int sample_rate_hz;
-    SemaphoreHandle_t stream_mutex;
-} korvo_audio_t;
+    int16_t *ring;
+    uint32_t write_pos;               // Monotonic count of published samples (atomic)
+    korvo_audio_reader_t readers[KORVO_AUDIO_MAX_READERS];
+    SemaphoreHandle_t readers_mutex;  // Guards open/close only, never taken on the data path
+    int64_t anchor_us;                // esp_timer time of the latest publish
+    uint32_t anchor_pos;              // write_pos at that publish
+    const int16_t *inject;            // Mono clip replacing the microphones, NULL when live (atomic)
+    uint32_t inject_frames;
+    uint32_t inject_pos;              // Next clip frame; the interrupt only
+    uint8_t tdm_slots;                // Slots per frame of a TDM capture, 0 for the PDM microphones
+    uint8_t tdm_mic_slots[2];         // TDM slots published as the ring's two channels
+    uint8_t tdm_ref_slot;             // TDM slot of the loopback, when ref_ring is set
+    int16_t *ref_ring;                // Speaker loopback of a TDM capture, one sample per ring frame; NULL without
+    bool rings_external;              // A ring fell back to PSRAM, which is unreadable while flash is written
+};
 
+/**
+ * Start the microphones. Each filled I2S DMA buffer is copied into the ring
+ * and published from the I2S interrupt, which runs on the audio core.
+ *
+ * With CONFIG_KVA_CAPTURE_TDM the capture comes from a multi-channel ADC
+ * on a TDM bus instead: two of its slots become the ring's stereo pair, so
+ * readers see the same layout as with PDM, and the codec's loopback slot
+ * goes to a reference ring indexed like it (korvo_audio_read_reference()).
+ */
 esp_err_t korvo_audio_init(korvo_audio_t *ctx, int sample_rate_hz);
-esp_err_t korvo_audio_capture(korvo_audio_t *ctx, int16_t *buffer, size_t samples_requested, size_t *samples_read, TickType_t timeout_ticks);
-esp_err_t korvo_audio_acquire(korvo_audio_t *ctx, TickType_t timeout_ticks);
-void korvo_audio_release(korvo_audio_t *ctx);
-esp_err_t korvo_audio_capture_locked(korvo_audio_t *ctx,
-                                     int16_t *buffer,
-                                     size_t samples_requested,
-                                     size_t *samples_read,
-                                     TickType_t timeout_ticks);
+
+/**
+ * Register a consumer. The cursor starts at the live edge of the stream.
+ */
+esp_err_t korvo_audio_open_reader(korvo_audio_t *ctx, const char *name, korvo_audio_reader_t **reader_out);
+void korvo_audio_close_reader(korvo_audio_reader_t *reader);
+
+/**
+ * Read up to samples_requested samples. Blocks until that many are available
+ * or timeout_ticks elapse, then returns what is available; ESP_ERR_TIMEOUT if
+ * nothing arrived.
+ */
+esp_err_t korvo_audio_read(korvo_audio_reader_t *reader,
+                           int16_t *buffer,
+                           size_t samples_requested,
+                           size_t *samples_read,
+                           TickType_t timeout_ticks);
+
+/**
+ * Drop anything buffered for this reader and continue from the live edge.
+ */
+void korvo_audio_reader_sync(korvo_audio_reader_t *reader);
+
+/**
+ * Move the cursor to monotonic sample index pos, clamped to what the ring
+ * still holds and to the live edge. Lets a consumer start in the past, e.g.
+ * for a pre-roll. Returns the position actually set.
+ */
+uint32_t korvo_audio_reader_seek(korvo_audio_reader_t *reader, uint32_t pos);
+
+/**
+ * Monotonic index of the next sample the capture task will publish.
+ */
+uint32_t korvo_audio_write_pos(const korvo_audio_t *ctx);
+
+/**
+ * Samples buffered for this reader (capped at the ring length).
+ */
+size_t korvo_audio_reader_available(const korvo_audio_reader_t *reader);
+
+/**
+ * esp_timer time at which the sample at monotonic index pos was captured,
+ * extrapolated from the latest publish. Lets consumers line capture up with
+ * other clocks, such as the playback loopback used for AEC.
+ */
+int64_t korvo_audio_sample_time_us(korvo_audio_t *ctx, uint32_t pos);
+
+/**
+ * DMA buffers lost because the I2S interrupt was held off past the DMA ring.
+ * Unlike a reader's overruns, every reader missed these samples.
+ */
+uint32_t korvo_audio_dma_overruns(korvo_audio_t *ctx);
+
+/**
+ * Publish a mono clip on both channels in place of the microphones, from the
+ * next DMA buffer until it ends, so every reader gets it as captured audio.
+ * For the latency benchmark (bench_mode.h). The clip must stay valid while
+ * korvo_audio_injecting() is true.
+ *
+ * @return ESP_ERR_INVALID_STATE while a clip is still playing
+ */
+esp_err_t korvo_audio_inject(korvo_audio_t *ctx, const int16_t *mono, uint32_t frames);
+bool korvo_audio_injecting(const korvo_audio_t *ctx);
+
+/**
+ * True when the capture carries the codec's loopback of the speaker, so the
+ * AEC reference comes with the microphones instead of from the player.
+ */
+bool korvo_audio_has_reference(const korvo_audio_t *ctx);
+
+/**
+ * Copy the loopback captured alongside the frames that start at monotonic
+ * sample index pos (a reader's or audio graph block's position), one sample
+ * per frame. It is sample-aligned with the microphones. Frames not captured
+ * yet, or already gone from the ring, read as silence.
+ */
+void korvo_audio_read_reference(korvo_audio_t *ctx, uint32_t pos, int16_t *out, size_t frames);
+
 void korvo_audio_shutdown(korvo_audio_t *ctx);
 
 #ifdef __cplusplus
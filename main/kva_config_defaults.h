@@ -12,26 +12,280 @@
 #define CONFIG_KVA_SAMPLE_RATE 16000
 #endif
 
+// Capture from a TDM ADC (ES7210 class) instead of the two PDM mics. Two of
+// its slots are the mic pair; the codec's loopback slot becomes the AEC
+// reference, sample-aligned with them; REF_SLOT -1 for a bus without one
+#ifndef CONFIG_KVA_CAPTURE_TDM
+#define CONFIG_KVA_CAPTURE_TDM 0
+#endif
+#ifndef CONFIG_KVA_TDM_SLOTS
+#define CONFIG_KVA_TDM_SLOTS 4
+#endif
+#ifndef CONFIG_KVA_TDM_MIC0_SLOT
+#define CONFIG_KVA_TDM_MIC0_SLOT 0
+#endif
+#ifndef CONFIG_KVA_TDM_MIC1_SLOT
+#define CONFIG_KVA_TDM_MIC1_SLOT 1
+#endif
+#ifndef CONFIG_KVA_TDM_REF_SLOT
+#define CONFIG_KVA_TDM_REF_SLOT 3
+#endif
+
+// How long a wake turn waits for speech to start; the turn then streams
+// until the VAD hears it end
 #ifndef CONFIG_KVA_CAPTURE_MS
 #define CONFIG_KVA_CAPTURE_MS 2500
 #endif
 
+// After a spoken reply, speech within this window is the next turn without
+// a wake word; 0 turns it off
+#ifndef CONFIG_KVA_FOLLOW_UP_MS
+#define CONFIG_KVA_FOLLOW_UP_MS 5000
+#endif
+
 #ifndef CONFIG_KVA_WAKE_WORD_SENSITIVITY
 #define CONFIG_KVA_WAKE_WORD_SENSITIVITY 60
 #endif
 
+// The wake gate's noise floor is kept in NVS, so detection starts on the
+// first frame instead of after a calibration. Quiet frames move the stored
+// floor with a time constant of WAKE_NOISE_LEARN_S, and it is written back
+// at most every WAKE_NOISE_SAVE_S when it has moved by more than 1 dB
+#ifndef CONFIG_KVA_WAKE_NOISE_PERSIST
+#define CONFIG_KVA_WAKE_NOISE_PERSIST 1
+#endif
+
+#ifndef CONFIG_KVA_WAKE_NOISE_LEARN_S
+#define CONFIG_KVA_WAKE_NOISE_LEARN_S 300
+#endif
+
+#ifndef CONFIG_KVA_WAKE_NOISE_SAVE_S
+#define CONFIG_KVA_WAKE_NOISE_SAVE_S 1800
+#endif
+
 #ifndef CONFIG_KVA_SIMULATED_WAKE_INTERVAL_MS
 #define CONFIG_KVA_SIMULATED_WAKE_INTERVAL_MS 0
 #endif
 
+// Final transcripts without an exact intent phrase may match one with an
+// edit per this many bytes of phrase ("lights of"); 0 matches exactly only
+#ifndef CONFIG_KVA_INTENT_FUZZY_CHARS_PER_EDIT
+#define CONFIG_KVA_INTENT_FUZZY_CHARS_PER_EDIT 4
+#endif
+
 #ifndef CONFIG_KVA_TTS_VOICE
 #define CONFIG_KVA_TTS_VOICE "alloy"
 #endif
 
+#ifndef CONFIG_KVA_PIPELINED_TTS
+#define CONFIG_KVA_PIPELINED_TTS 1
+#endif
+
+// Cloud STT uplink: 0 = PCM16, 1 = G.711 mu-law (half the bytes on the wire)
+#ifndef CONFIG_KVA_UPLINK_CODEC
+#define CONFIG_KVA_UPLINK_CODEC 1
+#endif
+
+// Realtime uplinks follow the link quality (main/uplink_link.h): GOOD_BATCH
+// chunks per message on a good link, up to BATCH_MAX while catching up, and
+// a lower-rate format on a poor one. 0 sends every chunk alone at full rate
+#ifndef CONFIG_KVA_UPLINK_ADAPTIVE
+#define CONFIG_KVA_UPLINK_ADAPTIVE 1
+#endif
+
+#ifndef CONFIG_KVA_UPLINK_GOOD_BATCH
+#define CONFIG_KVA_UPLINK_GOOD_BATCH 2
+#endif
+
+#ifndef CONFIG_KVA_UPLINK_BATCH_MAX
+#define CONFIG_KVA_UPLINK_BATCH_MAX 4
+#endif
+
+// Better conditions must hold this long before the level climbs a step
+#ifndef CONFIG_KVA_UPLINK_RECOVER_MS
+#define CONFIG_KVA_UPLINK_RECOVER_MS 3000
+#endif
+
+// Station RSSI (dBm) under which the link counts as fair, and as poor
+#ifndef CONFIG_KVA_UPLINK_RSSI_FAIR
+#define CONFIG_KVA_UPLINK_RSSI_FAIR -70
+#endif
+
+#ifndef CONFIG_KVA_UPLINK_RSSI_POOR
+#define CONFIG_KVA_UPLINK_RSSI_POOR -78
+#endif
+
+// Answer through OpenAI Realtime speech-to-speech instead of Gemini Live STT,
+// LLM and TTS; needs the AFE VAD to end turns
+#ifndef CONFIG_KVA_OPENAI_SPEECH
+#define CONFIG_KVA_OPENAI_SPEECH 0
+#endif
+
+// Batch STT, LLM and TTS requests go to whichever provider is currently
+// fastest and healthy, failing over to the other (main/provider_router.h).
+// 0 sends them all to the configured provider
+#ifndef CONFIG_KVA_PROVIDER_ROUTER
+#define CONFIG_KVA_PROVIDER_ROUTER 1
+#endif
+
+// Bounds of the per-attempt STT timeout derived from observed latency
+#ifndef CONFIG_KVA_ROUTER_TIMEOUT_MIN_MS
+#define CONFIG_KVA_ROUTER_TIMEOUT_MIN_MS 2000
+#endif
+
+#ifndef CONFIG_KVA_ROUTER_TIMEOUT_MAX_MS
+#define CONFIG_KVA_ROUTER_TIMEOUT_MAX_MS 8000
+#endif
+
+// Consecutive failures that take a provider out of rotation for a stage;
+// a timeout counts as two. It is retried after a cool-down that doubles
+// with each trip up to 32x
+#ifndef CONFIG_KVA_ROUTER_TRIP_FAILURES
+#define CONFIG_KVA_ROUTER_TRIP_FAILURES 2
+#endif
+
+#ifndef CONFIG_KVA_ROUTER_COOLDOWN_MS
+#define CONFIG_KVA_ROUTER_COOLDOWN_MS 5000
+#endif
+
+// The other provider must be this much faster to take over a stage
+#ifndef CONFIG_KVA_ROUTER_SWITCH_PCT
+#define CONFIG_KVA_ROUTER_SWITCH_PCT 20
+#endif
+
+// Every this many requests of a stage, one goes to a provider whose figures are stale
+#ifndef CONFIG_KVA_ROUTER_EXPLORE_EVERY
+#define CONFIG_KVA_ROUTER_EXPLORE_EVERY 25
+#endif
+
+// Hedged STT: a clip up to HEDGE_MAX_MS long whose first request has not
+// answered by its provider's usual latency is also sent to the other one,
+// and the first transcript wins. BUDGET_PCT caps the share of requests
+// that may be hedged, since each hedge is a second paid transcription
+#ifndef CONFIG_KVA_ROUTER_HEDGE_STT
+#define CONFIG_KVA_ROUTER_HEDGE_STT 0
+#endif
+
+#ifndef CONFIG_KVA_ROUTER_HEDGE_MAX_MS
+#define CONFIG_KVA_ROUTER_HEDGE_MAX_MS 4000
+#endif
+
+#ifndef CONFIG_KVA_ROUTER_HEDGE_BUDGET_PCT
+#define CONFIG_KVA_ROUTER_HEDGE_BUDGET_PCT 10
+#endif
+
+// PSRAM bump arena for one voice interaction's buffers, reset after each reply
+#ifndef CONFIG_KVA_INTERACTION_ARENA_KB
+#define CONFIG_KVA_INTERACTION_ARENA_KB 256
+#endif
+
+// Reply workers and the transcripts that may wait for one; a full queue
+// drops its oldest transcript so the newest speech is answered
+#ifndef CONFIG_KVA_INTERACTION_WORKERS
+#define CONFIG_KVA_INTERACTION_WORKERS 1
+#endif
+#ifndef CONFIG_KVA_INTERACTION_QUEUE_DEPTH
+#define CONFIG_KVA_INTERACTION_QUEUE_DEPTH 2
+#endif
+
+// Workers that run a model reply's function calls side by side (tool_dispatch.h); 0 runs them in turn
+#ifndef CONFIG_KVA_TOOL_WORKERS
+#define CONFIG_KVA_TOOL_WORKERS 2
+#endif
+
+// Worker stacks in PSRAM. Only safe while nothing a reply runs writes flash
+// (NVS, SPIFFS): the cache is off during the write and the stack with it.
+// Replies then leave the TTS cache to the fixed phrases rendered at startup
+#ifndef CONFIG_KVA_INTERACTION_PSRAM_STACKS
+#define CONFIG_KVA_INTERACTION_PSRAM_STACKS 0
+#endif
+
+// Synthesized replies kept in the "tts_cache" partition and replayed from
+// flash; longer replies are never cached
+#ifndef CONFIG_KVA_TTS_CACHE
+#define CONFIG_KVA_TTS_CACHE 1
+#endif
+#ifndef CONFIG_KVA_TTS_CACHE_MAX_CHARS
+#define CONFIG_KVA_TTS_CACHE_MAX_CHARS 160
+#endif
+
+// LLM turns replayed with each request (about 4 bytes a token); older turns
+// shrink to a line of summary, and all of it is dropped after an idle spell
+#ifndef CONFIG_KVA_CONVERSATION_MEMORY
+#define CONFIG_KVA_CONVERSATION_MEMORY 1
+#endif
+#ifndef CONFIG_KVA_CONVERSATION_TURNS
+#define CONFIG_KVA_CONVERSATION_TURNS 6
+#endif
+#ifndef CONFIG_KVA_CONVERSATION_BUDGET_BYTES
+#define CONFIG_KVA_CONVERSATION_BUDGET_BYTES 1536
+#endif
+#ifndef CONFIG_KVA_CONVERSATION_SUMMARY_CHARS
+#define CONFIG_KVA_CONVERSATION_SUMMARY_CHARS 384
+#endif
+#ifndef CONFIG_KVA_CONVERSATION_IDLE_S
+#define CONFIG_KVA_CONVERSATION_IDLE_S 120
+#endif
+
+// MultiNet grammar for playback, volume and lights, run next to WakeNet in the AFE loop
+#ifndef CONFIG_KVA_LOCAL_COMMANDS
+#define CONFIG_KVA_LOCAL_COMMANDS 1
+#endif
+
+// Core reserved for capture, the AFE and output; everything else runs on the other one
+#ifndef CONFIG_KVA_AUDIO_CORE
+#define CONFIG_KVA_AUDIO_CORE 1
+#endif
+
+// Heap and task stack report on the console; 0 disables it
+#ifndef CONFIG_KVA_STACK_REPORT_PERIOD_MS
+#define CONFIG_KVA_STACK_REPORT_PERIOD_MS 60000
+#endif
+
+// Binary frames on the console port; see serial_link.h
+#ifndef CONFIG_KVA_SERIAL_LINK_ENABLE
+#define CONFIG_KVA_SERIAL_LINK_ENABLE 0
+#endif
+
+#ifndef CONFIG_KVA_SERIAL_LINK_USB_JTAG
+#define CONFIG_KVA_SERIAL_LINK_USB_JTAG 0
+#endif
+
+#ifndef CONFIG_KVA_SERIAL_LINK_TX_BUFFER
+#define CONFIG_KVA_SERIAL_LINK_TX_BUFFER 16384
+#endif
+
+// How often log_drain.h formats or forwards the DLOG* records
+#ifndef CONFIG_KVA_LOG_DRAIN_PERIOD_MS
+#define CONFIG_KVA_LOG_DRAIN_PERIOD_MS 50
+#endif
+
+// Audio around wake events for training data; see wake_capture.h
+#ifndef CONFIG_KVA_WAKE_CAPTURE_ENABLE
+#define CONFIG_KVA_WAKE_CAPTURE_ENABLE 0
+#endif
+
+#ifndef CONFIG_KVA_WAKE_CAPTURE_PREROLL_MS
+#define CONFIG_KVA_WAKE_CAPTURE_PREROLL_MS 800
+#endif
+
+#ifndef CONFIG_KVA_WAKE_CAPTURE_POSTROLL_MS
+#define CONFIG_KVA_WAKE_CAPTURE_POSTROLL_MS 1200
+#endif
+
+#ifndef CONFIG_KVA_WAKE_CAPTURE_NEAR_MISS_PCT
+#define CONFIG_KVA_WAKE_CAPTURE_NEAR_MISS_PCT 70
+#endif
+
 #ifndef CONFIG_KVA_SPOTIFY_DEVICE_NAME
 #define CONFIG_KVA_SPOTIFY_DEVICE_NAME "Korvo-1"
 #endif
 
+// Intent phrase table, flashed from config/storage/intents.txt; the built-in table is used when it is missing
+#ifndef CONFIG_KVA_INTENT_PHRASES_PATH
+#define CONFIG_KVA_INTENT_PHRASES_PATH "/storage/intents.txt"
+#endif
+
 #ifndef CONFIG_KVA_SPOTIFY_VOLUME_STEP
 #define CONFIG_KVA_SPOTIFY_VOLUME_STEP 10
 #endif
@@ -40,6 +294,11 @@
 #define CONFIG_KVA_AWS_TELEMETRY_PERIOD_MS 15000
 #endif
 
+// Largest assistant metrics report; one that does not fit is logged and dropped
+#ifndef CONFIG_KVA_AWS_TELEMETRY_MAX_BYTES
+#define CONFIG_KVA_AWS_TELEMETRY_MAX_BYTES 6144
+#endif
+
 #ifndef CONFIG_KVA_LED_STRIP_GPIO
 #define CONFIG_KVA_LED_STRIP_GPIO 19
 #endif
@@ -52,6 +311,151 @@
 #define CONFIG_KVA_LED_BRIGHTNESS 32
 #endif
 
+// Frame period of the LED effects task while anything animates
+#ifndef CONFIG_KVA_LED_FRAME_MS
+#define CONFIG_KVA_LED_FRAME_MS 33
+#endif
+
+// Gamma-correct the strip so equal steps in a fade look equal
+#ifndef CONFIG_KVA_LED_GAMMA
+#define CONFIG_KVA_LED_GAMMA 0
+#endif
+
+// Band energies from the wake word mel frontend drive a spectrum layer
+#ifndef CONFIG_KVA_SPECTRUM_LEDS
+#define CONFIG_KVA_SPECTRUM_LEDS 0
+#endif
+
+// GCC-PHAT talker direction over the capture pair, in the AFE loop
+#ifndef CONFIG_KVA_DOA_ENABLE
+#define CONFIG_KVA_DOA_ENABLE 0
+#endif
+
+#ifndef CONFIG_KVA_DOA_MIC_SPACING_MM
+#define CONFIG_KVA_DOA_MIC_SPACING_MM 65
+#endif
+
+// A spot on the ring toward the talker; OFFSET is the bearing for broadside
+#ifndef CONFIG_KVA_DOA_LEDS
+#define CONFIG_KVA_DOA_LEDS 0
+#endif
+
+#ifndef CONFIG_KVA_DOA_LED_OFFSET_DEG
+#define CONFIG_KVA_DOA_LED_OFFSET_DEG 0
+#endif
+
+// End-of-turn prediction in the AFE loop: a pause the predictor takes as the
+// end of the turn closes the utterance after MIN_SILENCE_MS instead of the
+// full VAD hangover. Uses the model in the PARTITION partition when one is
+// flashed, prosody and partial-transcript cues otherwise
+#ifndef CONFIG_KVA_TURN_PREDICTOR
+#define CONFIG_KVA_TURN_PREDICTOR 1
+#endif
+
+#ifndef CONFIG_KVA_TURN_PREDICTOR_PARTITION
+#define CONFIG_KVA_TURN_PREDICTOR_PARTITION "eot_model"
+#endif
+
+#ifndef CONFIG_KVA_TURN_PREDICTOR_THRESHOLD_PCT
+#define CONFIG_KVA_TURN_PREDICTOR_THRESHOLD_PCT 70
+#endif
+
+#ifndef CONFIG_KVA_TURN_PREDICTOR_MIN_SILENCE_MS
+#define CONFIG_KVA_TURN_PREDICTOR_MIN_SILENCE_MS 200
+#endif
+
+// Draw Wi-Fi, AWS, wake word, mute, playback and mic indicators over the
+// first status pixels; off leaves the whole ring to the trippy fade
+#ifndef CONFIG_KVA_LED_STATUS_OVERLAYS
+#define CONFIG_KVA_LED_STATUS_OVERLAYS 0
+#endif
+
+// Event bus (event_bus.h): subscriber slots, and events each subscriber can
+// have waiting (power of two) before further ones are dropped for it
+#ifndef CONFIG_KVA_EVENT_BUS_MAX_SUBSCRIBERS
+#define CONFIG_KVA_EVENT_BUS_MAX_SUBSCRIBERS 4
+#endif
+
+#ifndef CONFIG_KVA_EVENT_BUS_QUEUE_DEPTH
+#define CONFIG_KVA_EVENT_BUS_QUEUE_DEPTH 32
+#endif
+
+// Resolution of timer_wheel.h deadlines
+#ifndef CONFIG_KVA_TIMER_WHEEL_TICK_MS
+#define CONFIG_KVA_TIMER_WHEEL_TICK_MS 10
+#endif
+
+// Rate control_coalescer.h applies volume and brightness changes at, and
+// how long a change glides for (time constant)
+#ifndef CONFIG_KVA_CONTROL_RATE_HZ
+#define CONFIG_KVA_CONTROL_RATE_HZ 30
+#endif
+
+#ifndef CONFIG_KVA_CONTROL_SMOOTHING_MS
+#define CONFIG_KVA_CONTROL_SMOOTHING_MS 80
+#endif
+
+// Real-time stages deadline_monitor.h can track, and the misses in a row
+// that log a task snapshot (0 = never)
+#ifndef CONFIG_KVA_DEADLINE_MONITOR_MAX_STAGES
+#define CONFIG_KVA_DEADLINE_MONITOR_MAX_STAGES 8
+#endif
+
+#ifndef CONFIG_KVA_DEADLINE_MONITOR_SNAPSHOT_MISSES
+#define CONFIG_KVA_DEADLINE_MONITOR_SNAPSHOT_MISSES 8
+#endif
+
+// Resolved cloud hosts kept by dns_cache.h, and how long an address is
+// trusted; entries are resolved again at three quarters of it
+#ifndef CONFIG_KVA_DNS_CACHE_ENTRIES
+#define CONFIG_KVA_DNS_CACHE_ENTRIES 12
+#endif
+
+#ifndef CONFIG_KVA_DNS_CACHE_TTL_S
+#define CONFIG_KVA_DNS_CACHE_TTL_S 300
+#endif
+
+// Capture samples (interleaved stereo) each audio_graph worker reads at a
+// time: 16 ms at 16 kHz, the latency a node adds on top of its own block
+#ifndef CONFIG_KVA_AUDIO_GRAPH_QUANTUM_SAMPLES
+#define CONFIG_KVA_AUDIO_GRAPH_QUANTUM_SAMPLES 512
+#endif
+
+// Latency benchmark build (bench_mode.h): the cloud clients talk plain HTTP
+// and WebSocket to scripts/mock_cloud_server.py at BENCH_CLOUD_HOST
+// ("host:port") instead of the real APIs. Never ship with it on
+#ifndef CONFIG_KVA_BENCH_MODE
+#define CONFIG_KVA_BENCH_MODE 0
+#endif
+
+#ifndef CONFIG_KVA_BENCH_CLOUD_HOST
+#define CONFIG_KVA_BENCH_CLOUD_HOST "192.168.4.2:8080"
+#endif
+
+// Longest utterance the benchmark can upload, kept in PSRAM
+#ifndef CONFIG_KVA_BENCH_MAX_CLIP_MS
+#define CONFIG_KVA_BENCH_MAX_CLIP_MS 8000
+#endif
+
+// Ambient light auto-dim: the LEDs fade from MIN_BRIGHTNESS in the dark up to
+// CONFIG_KVA_LED_BRIGHTNESS at FULL_LUX, and a hand over the proximity
+// sensor restores full brightness for WAKE_HOLD_MS
+#ifndef CONFIG_KVA_LED_AUTO_DIM
+#define CONFIG_KVA_LED_AUTO_DIM 1
+#endif
+
+#ifndef CONFIG_KVA_LED_MIN_BRIGHTNESS
+#define CONFIG_KVA_LED_MIN_BRIGHTNESS 4
+#endif
+
+#ifndef CONFIG_KVA_LED_AUTO_DIM_FULL_LUX
+#define CONFIG_KVA_LED_AUTO_DIM_FULL_LUX 150
+#endif
+
+#ifndef CONFIG_KVA_LED_WAKE_HOLD_MS
+#define CONFIG_KVA_LED_WAKE_HOLD_MS 10000
+#endif
+
 #ifndef CONFIG_KVA_BUTTON1_GPIO
 #define CONFIG_KVA_BUTTON1_GPIO -1
 #endif
@@ -64,6 +468,10 @@
 #define CONFIG_KVA_BUTTON_DEBOUNCE_MS 120
 #endif
 
+#ifndef CONFIG_KVA_BUTTON_LONG_PRESS_MS
+#define CONFIG_KVA_BUTTON_LONG_PRESS_MS 800
+#endif
+
 #ifndef CONFIG_KVA_CODEC_I2C_SDA
 #define CONFIG_KVA_CODEC_I2C_SDA -1
 #endif
@@ -92,6 +500,226 @@
 #define CONFIG_KVA_CODEC_I2S_PORT 1
 #endif
 
+// Playback clock; every source is resampled to it, so I2S is never reclocked
+#ifndef CONFIG_KVA_CODEC_SAMPLE_RATE
+#define CONFIG_KVA_CODEC_SAMPLE_RATE 48000
+#endif
+
 #ifndef CONFIG_KVA_SPOTIFY_USE_CSPOT
 #define CONFIG_KVA_SPOTIFY_USE_CSPOT 0
 #endif
+
+#ifndef CONFIG_KVA_SPOTIFY_LAZY_START
+#define CONFIG_KVA_SPOTIFY_LAZY_START 1
+#endif
+
+// With lazy start, still log in at boot when the device is already paired,
+// so the first play does not wait for it; the idle stop frees it again
+#ifndef CONFIG_KVA_SPOTIFY_RESUME_AT_BOOT
+#define CONFIG_KVA_SPOTIFY_RESUME_AT_BOOT 1
+#endif
+
+#ifndef CONFIG_KVA_SPOTIFY_IDLE_STOP_MIN
+#define CONFIG_KVA_SPOTIFY_IDLE_STOP_MIN 30
+#endif
+
+// esp_pm profile; only takes effect with CONFIG_PM_ENABLE in sdkconfig
+#ifndef CONFIG_KVA_PM_MAX_CPU_MHZ
+#define CONFIG_KVA_PM_MAX_CPU_MHZ 240
+#endif
+
+#ifndef CONFIG_KVA_PM_MIN_CPU_MHZ
+#define CONFIG_KVA_PM_MIN_CPU_MHZ 40
+#endif
+
+#ifndef CONFIG_KVA_PM_LIGHT_SLEEP
+#define CONFIG_KVA_PM_LIGHT_SLEEP 1
+#endif
+
+// Keep the AFE at full clock while wake-word listening is live (not muted)
+#ifndef CONFIG_KVA_PM_LISTEN_FULL_SPEED
+#define CONFIG_KVA_PM_LISTEN_FULL_SPEED 1
+#endif
+
+// Wi-Fi modem sleep while no audio streams; full power from wake to the end of the reply (radio_coex.h)
+#ifndef CONFIG_KVA_PM_WIFI_POWER_SAVE
+#define CONFIG_KVA_PM_WIFI_POWER_SAVE 1
+#endif
+
+// Idle modem sleep: 1 wakes every CONFIG_KVA_WIFI_LISTEN_INTERVAL beacons, 0 for each DTIM beacon
+#ifndef CONFIG_KVA_WIFI_PS_IDLE_MAX_MODEM
+#define CONFIG_KVA_WIFI_PS_IDLE_MAX_MODEM 1
+#endif
+
+// Beacon intervals (about 102 ms each) between wakes in max modem sleep; told to the AP on association
+#ifndef CONFIG_KVA_WIFI_LISTEN_INTERVAL
+#define CONFIG_KVA_WIFI_LISTEN_INTERVAL 10
+#endif
+
+// A wake word or speech onset holds Wi-Fi at full power this long, even if no interaction follows
+#ifndef CONFIG_KVA_WIFI_PS_PREWARM_MS
+#define CONFIG_KVA_WIFI_PS_PREWARM_MS 5000
+#endif
+
+// Wi-Fi keeps the radio this long after the last audio stream ends
+#ifndef CONFIG_KVA_COEX_RESTORE_MS
+#define CONFIG_KVA_COEX_RESTORE_MS 2000
+#endif
+
+// ESP-NOW wake arbitration between units on the same SSID (wake_arbiter.h)
+#ifndef CONFIG_KVA_WAKE_ARBITER
+#define CONFIG_KVA_WAKE_ARBITER 1
+#endif
+
+// How long a wake waits for the other units' bids
+#ifndef CONFIG_KVA_WAKE_ARBITER_WINDOW_MS
+#define CONFIG_KVA_WAKE_ARBITER_WINDOW_MS 50
+#endif
+
+// Multi-room playback (multiroom_sync.h); the role is chosen at run time
+#ifndef CONFIG_KVA_MULTIROOM
+#define CONFIG_KVA_MULTIROOM 1
+#endif
+
+#ifndef CONFIG_KVA_MULTIROOM_GROUP
+#define CONFIG_KVA_MULTIROOM_GROUP "239.255.78.1"
+#endif
+
+#ifndef CONFIG_KVA_MULTIROOM_PORT
+#define CONFIG_KVA_MULTIROOM_PORT 47820
+#endif
+
+// How far ahead of its own speaker the leader sends; longer than the media
+// prefill so followers have the start before the leader plays it
+#ifndef CONFIG_KVA_MULTIROOM_LEAD_MS
+#define CONFIG_KVA_MULTIROOM_LEAD_MS 600
+#endif
+
+// Skew beyond this is fixed by skipping or padding instead of the trim
+#ifndef CONFIG_KVA_MULTIROOM_COARSE_MS
+#define CONFIG_KVA_MULTIROOM_COARSE_MS 20
+#endif
+
+// Breathing rate from the AFE output in sleep mode (breath_monitor.h)
+#ifndef CONFIG_KVA_BREATH_MONITOR
+#define CONFIG_KVA_BREATH_MONITOR 1
+#endif
+
+// Envelope history the autocorrelation looks at
+#ifndef CONFIG_KVA_BREATH_WINDOW_S
+#define CONFIG_KVA_BREATH_WINDOW_S 60
+#endif
+
+#ifndef CONFIG_KVA_BREATH_UPDATE_S
+#define CONFIG_KVA_BREATH_UPDATE_S 10
+#endif
+
+// Sound events held between telemetry reports (sound_events.h)
+#ifndef CONFIG_KVA_SOUND_EVENTS_QUEUE
+#define CONFIG_KVA_SOUND_EVENTS_QUEUE 32
+#endif
+
+// Room occupancy from proximity, sound, CO2, the phone app and use (occupancy.h);
+// drives the sampling, AFE and LED profiles below
+#ifndef CONFIG_KVA_OCCUPANCY
+#define CONFIG_KVA_OCCUPANCY 1
+#endif
+
+#ifndef CONFIG_KVA_OCCUPANCY_TICK_MS
+#define CONFIG_KVA_OCCUPANCY_TICK_MS 2000
+#endif
+
+// Evidence fades to nothing over this long
+#ifndef CONFIG_KVA_OCCUPANCY_HOLD_S
+#define CONFIG_KVA_OCCUPANCY_HOLD_S 900
+#endif
+
+// AFE output RMS that can count as someone moving or talking, when also
+// well above the room's tracked floor
+#ifndef CONFIG_KVA_OCCUPANCY_SOUND_RMS
+#define CONFIG_KVA_OCCUPANCY_SOUND_RMS 300
+#endif
+
+// CO2 slope over the window that means someone is breathing in the room
+#ifndef CONFIG_KVA_OCCUPANCY_CO2_WINDOW_MIN
+#define CONFIG_KVA_OCCUPANCY_CO2_WINDOW_MIN 10
+#endif
+
+#ifndef CONFIG_KVA_OCCUPANCY_CO2_PPM_MIN
+#define CONFIG_KVA_OCCUPANCY_CO2_PPM_MIN 2
+#endif
+
+// Sensor period in an empty and a sleeping room; occupied uses the sensor default
+#ifndef CONFIG_KVA_OCCUPANCY_EMPTY_SENSOR_MS
+#define CONFIG_KVA_OCCUPANCY_EMPTY_SENSOR_MS 10000
+#endif
+
+#ifndef CONFIG_KVA_OCCUPANCY_ASLEEP_SENSOR_MS
+#define CONFIG_KVA_OCCUPANCY_ASLEEP_SENSOR_MS 5000
+#endif
+
+// LED frame period while nobody is watching
+#ifndef CONFIG_KVA_OCCUPANCY_IDLE_LED_FRAME_MS
+#define CONFIG_KVA_OCCUPANCY_IDLE_LED_FRAME_MS 100
+#endif
+
+// The AFE's low-cost profile is a second, single-mic instance built in the
+// background and swapped in on a chunk boundary; 0 only switches SE and NS
+// off in the full one
+#ifndef CONFIG_KVA_AFE_PROFILES
+#define CONFIG_KVA_AFE_PROFILES 1
+#endif
+
+// Speech-free time before an idle room gets the low-cost profile; speech
+// brings back the full one at its onset
+#ifndef CONFIG_KVA_AFE_LOW_COST_QUIET_MS
+#define CONFIG_KVA_AFE_LOW_COST_QUIET_MS 10000
+#endif
+
+// The incoming instance hears this much audio before it takes over
+#ifndef CONFIG_KVA_AFE_SWAP_WARMUP_MS
+#define CONFIG_KVA_AFE_SWAP_WARMUP_MS 96
+#endif
+
+// Callbacks feature_flags_subscribe() can hold; see main/feature_flags.h
+#ifndef CONFIG_KVA_FEATURE_FLAGS_MAX_SUBSCRIBERS
+#define CONFIG_KVA_FEATURE_FLAGS_MAX_SUBSCRIBERS 8
+#endif
+
+// mbedTLS blocks this large or larger (record buffers, certificate chains)
+// are put in PSRAM when the board has it; see main/tls_mem.h
+#ifndef CONFIG_KVA_TLS_PSRAM_MIN_BYTES
+#define CONFIG_KVA_TLS_PSRAM_MIN_BYTES 2048
+#endif
+
+// AWS IoT Device Shadow sync of the device state; see main/device_shadow.h
+#ifndef CONFIG_KVA_DEVICE_SHADOW
+#define CONFIG_KVA_DEVICE_SHADOW 1
+#endif
+
+#ifndef CONFIG_KVA_DEVICE_SHADOW_SYNC_MS
+#define CONFIG_KVA_DEVICE_SHADOW_SYNC_MS 2000
+#endif
+
+// Wait for accepted/rejected before fetching the document again
+#ifndef CONFIG_KVA_DEVICE_SHADOW_TIMEOUT_MS
+#define CONFIG_KVA_DEVICE_SHADOW_TIMEOUT_MS 10000
+#endif
+
+// Gemini-path requests (STT, LLM, TTS) share one HTTP/2 connection to
+// googleapis.com when the server negotiates h2; see main/h2_transport.h.
+// 0, or a server without h2, keeps one HTTP/1.1 connection per host
+#ifndef CONFIG_KVA_HTTP2_GOOGLEAPIS
+#define CONFIG_KVA_HTTP2_GOOGLEAPIS 1
+#endif
+
+// Concurrent streams on that connection; a request finding none free uses HTTP/1.1
+#ifndef CONFIG_KVA_HTTP2_MAX_STREAMS
+#define CONFIG_KVA_HTTP2_MAX_STREAMS 4
+#endif
+
+// Response bytes buffered per stream, which is also the window the server
+// may fill before the reader catches up
+#ifndef CONFIG_KVA_HTTP2_STREAM_WINDOW
+#define CONFIG_KVA_HTTP2_STREAM_WINDOW 16384
+#endif
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Fixed-point colour maths shared by the LED code. Levels are Q8 (0-255 is
+ * 0.0-1.0) and animation phases are Q16 turns, so the per-pixel, per-frame
+ * work is table lookups, multiplies and shifts with no FPU use.
+ */
+
+typedef struct {
+    uint8_t r;
+    uint8_t g;
+    uint8_t b;
+} led_rgb_t;
+
+// Frames are handed to led_strip_set_pixels() as packed RGB triplets
+_Static_assert(sizeof(led_rgb_t) == 3, "led_rgb_t must be packed RGB");
+
+#define LED_COLOR_HUE_MAX 1536            // Hue units per turn: 256 per sextant
+
+extern const uint8_t led_color_gamma8[256];
+extern const uint8_t led_color_wave8[256];
+extern const uint8_t led_color_ease8[256];
+
+// round(value * scale / 255)
+static inline uint8_t led_color_scale8(uint8_t value, uint8_t scale)
+{
+    uint32_t p = (uint32_t)value * scale + 128;
+    return (uint8_t)((p + (p >> 8)) >> 8);
+}
+
+static inline led_rgb_t led_color_scale(led_rgb_t c, uint8_t scale)
+{
+    return (led_rgb_t){led_color_scale8(c.r, scale), led_color_scale8(c.g, scale), led_color_scale8(c.b, scale)};
+}
+
+// a at t = 0, b at t = 255
+static inline uint8_t led_color_lerp8(uint8_t a, uint8_t b, uint8_t t)
+{
+    return (uint8_t)(a + (((int32_t)b - a) * t + (b > a ? 127 : -127)) / 255);
+}
+
+static inline led_rgb_t led_color_lerp(led_rgb_t a, led_rgb_t b, uint8_t t)
+{
+    return (led_rgb_t){led_color_lerp8(a.r, b.r, t), led_color_lerp8(a.g, b.g, t), led_color_lerp8(a.b, b.b, t)};
+}
+
+static inline uint8_t led_color_add8(uint8_t a, uint8_t b)
+{
+    uint32_t sum = (uint32_t)a + b;
+    return sum > 255 ? 255 : (uint8_t)sum;
+}
+
+// Position within the current period as a Q16 fraction of a turn
+static inline uint16_t led_color_phase16(uint32_t elapsed_ms, uint32_t period_ms)
+{
+    return (uint16_t)(((uint64_t)(elapsed_ms % period_ms) << 16) / period_ms);
+}
+
+// Raised cosine over one turn, interpolated between table entries
+static inline uint8_t led_color_wave(uint16_t phase16)
+{
+    uint8_t index = (uint8_t)(phase16 >> 8);
+    int32_t a = led_color_wave8[index];
+    int32_t b = led_color_wave8[(uint8_t)(index + 1)];
+    return (uint8_t)(a + (((b - a) * (int32_t)(phase16 & 0xFF)) >> 8));
+}
+
+/**
+ * Fill a 256-entry table that maps a frame component to what goes on the
+ * wire: optional gamma, then brightness. Built once per brightness change
+ * so the per-frame cost is one lookup per component.
+ */
+void led_color_build_lut(uint8_t lut[256], uint8_t brightness, bool gamma);
+
+// hue in LED_COLOR_HUE_MAX units per turn
+led_rgb_t led_color_hsv(uint16_t hue, uint8_t saturation, uint8_t value);
+
+#ifdef __cplusplus
+}
+#endif
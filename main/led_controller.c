@@ -1,34 +1,29 @@
 #include "led_controller.h"
 
-#include <math.h>
 #include <stdlib.h>
 
 #include "esp_check.h"
 #include "esp_log.h"
+#include "kva_config_defaults.h"
 #include "led_strip.h"
+#include "task_placement.h"
 
 static const char *TAG = "led_controller";
 
-static void set_pixel_scaled(led_controller_t *controller, uint8_t index, uint8_t red, uint8_t green, uint8_t blue)
-{
-    if (!controller || !controller->strip || index >= controller->led_count) {
-        return;
-    }
-    uint8_t scaled_r = (red * controller->brightness) / 255;
-    uint8_t scaled_g = (green * controller->brightness) / 255;
-    uint8_t scaled_b = (blue * controller->brightness) / 255;
-    led_strip_set_pixel(controller->strip, index, scaled_r, scaled_g, scaled_b);
-}
+// One sunrise-to-night cycle of the trippy fade
+#define TRIPPY_CYCLE_MS 15625
 
-static void apply_color(led_controller_t *controller, uint8_t red, uint8_t green, uint8_t blue)
+static void led_controller_render_trippy(led_rgb_t *pixels, size_t count, uint32_t elapsed_ms, void *ctx);
+
+static void set_base_color(led_controller_t *controller, uint8_t red, uint8_t green, uint8_t blue, uint8_t first)
 {
-    if (!controller || !controller->strip) {
-        return;
-    }
-    for (uint8_t i = controller->reserved_pixels; i < controller->led_count; ++i) {
-        set_pixel_scaled(controller, i, red, green, blue);
-    }
-    led_strip_refresh(controller->strip);
+    const led_effect_layer_t layer = {
+        .kind = LED_EFFECT_SOLID,
+        .color = {red, green, blue},
+        .intensity = 255,
+        .first = first,
+    };
+    led_effects_set_layer(controller->effects, LED_CONTROLLER_LAYER_BASE, &layer);
 }
 
 static void update_state(led_controller_t *controller)
@@ -47,10 +42,11 @@ static void update_state(led_controller_t *controller)
     if (controller->state > LED_CONTROLLER_STATE_ERROR) {
         controller->state = LED_CONTROLLER_STATE_IDLE;
     }
-    apply_color(controller,
-                kStateColors[controller->state].r,
-                kStateColors[controller->state].g,
-                kStateColors[controller->state].b);
+    set_base_color(controller,
+                   kStateColors[controller->state].r,
+                   kStateColors[controller->state].g,
+                   kStateColors[controller->state].b,
+                   controller->reserved_pixels);
 }
 
 esp_err_t led_controller_init(led_controller_t *controller, const led_controller_config_t *config)
@@ -70,22 +66,42 @@ esp_err_t led_controller_init(led_controller_t *controller, const led_controller
 
     led_strip_rmt_config_t rmt_config = {
         .resolution_hz = 10 * 1000 * 1000, // 10MHz
-        .with_dma = false,
+        .with_dma = true,
     };
 
     led_strip_handle_t strip = NULL;
     ESP_RETURN_ON_ERROR(led_strip_new_rmt_device(&strip_config, &rmt_config, &strip), TAG, "RMT init failed");
+    led_strip_clear(strip);
+
+    uint8_t brightness = config->brightness > 0 ? config->brightness : 32;
+    const task_placement_t *placement = task_placement_get(TASK_PLACEMENT_LED_EFFECTS);
+    led_effects_config_t fx_config = {
+        .strip = strip,
+        .pixel_count = config->led_count,
+        .brightness = brightness,
+        .gamma = CONFIG_KVA_LED_GAMMA,
+        .frame_ms = CONFIG_KVA_LED_FRAME_MS,
+        .task_name = placement->name,
+        .stack_bytes = placement->stack_bytes,
+        .priority = placement->priority,
+        .core = placement->core,
+    };
+    led_effects_t *effects = NULL;
+    esp_err_t err = led_effects_create(&fx_config, &effects);
+    if (err != ESP_OK) {
+        led_strip_del(strip);
+        ESP_LOGE(TAG, "Effects engine init failed (%s)", esp_err_to_name(err));
+        return err;
+    }
 
     controller->strip = strip;
+    controller->effects = effects;
     controller->led_count = config->led_count;
-    controller->brightness = config->brightness > 0 ? config->brightness : 32;
+    controller->brightness = brightness;
     controller->reserved_pixels = config->reserved_pixels <= controller->led_count ? config->reserved_pixels : controller->led_count;
     controller->state = LED_CONTROLLER_STATE_IDLE;
     controller->trippy_active = false;
-    controller->trippy_time = 0.0f;
-    controller->trippy_speed = 0.02f; // Animation speed (adjust for faster/slower)
 
-    led_strip_clear(controller->strip);
     update_state(controller);
     ESP_LOGI(TAG, "WS2812 strip on GPIO%d with %d pixels", config->data_gpio, config->led_count);
     return ESP_OK;
@@ -93,7 +109,7 @@ esp_err_t led_controller_init(led_controller_t *controller, const led_controller
 
 void led_controller_set_state(led_controller_t *controller, led_controller_state_t state)
 {
-    if (!controller || !controller->strip) {
+    if (!controller || !controller->effects) {
         return;
     }
     controller->state = state;
@@ -103,13 +119,65 @@ void led_controller_set_state(led_controller_t *controller, led_controller_state
     }
 }
 
-void led_controller_set_pixel_color(led_controller_t *controller, uint8_t pixel_index, uint8_t red, uint8_t green, uint8_t blue)
+void led_controller_set_brightness(led_controller_t *controller, uint8_t brightness)
+{
+    if (!controller || !controller->effects || controller->brightness == brightness) {
+        return;
+    }
+    controller->brightness = brightness;
+    led_effects_set_brightness(controller->effects, brightness);
+}
+
+void led_controller_set_color(led_controller_t *controller, uint8_t red, uint8_t green, uint8_t blue)
+{
+    if (!controller || !controller->effects) {
+        return;
+    }
+    controller->trippy_active = false;
+    set_base_color(controller, red, green, blue, 0);
+    led_effects_set_enabled(controller->effects, true);
+}
+
+void led_controller_set_enabled(led_controller_t *controller, bool enabled)
+{
+    if (!controller || !controller->effects) {
+        return;
+    }
+    led_effects_set_enabled(controller->effects, enabled);
+}
+
+void led_controller_set_overlay(led_controller_t *controller, uint8_t pixel_index, const led_effect_layer_t *layer)
 {
-    if (!controller || !controller->strip || pixel_index >= controller->led_count) {
+    if (!controller || !controller->effects || pixel_index >= controller->led_count) {
+        return;
+    }
+    uint8_t slot = LED_CONTROLLER_LAYER_STATUS + pixel_index;
+    if (slot >= LED_EFFECTS_MAX_LAYERS) {
+        return;
+    }
+    if (!layer) {
+        led_effects_clear_layer(controller->effects, slot);
         return;
     }
-    set_pixel_scaled(controller, pixel_index, red, green, blue);
-    led_strip_refresh(controller->strip);
+    led_effect_layer_t overlay = *layer;
+    overlay.first = pixel_index;
+    overlay.count = 1;
+    led_effects_set_layer(controller->effects, slot, &overlay);
+}
+
+void led_controller_set_audio_layer(led_controller_t *controller, const led_effect_layer_t *layer)
+{
+    if (!controller || !controller->effects) {
+        return;
+    }
+    if (!layer) {
+        led_effects_clear_layer(controller->effects, LED_CONTROLLER_LAYER_AUDIO);
+        return;
+    }
+    led_effect_layer_t audio = *layer;
+    audio.first = 0;
+    audio.count = 0;
+    led_effects_set_layer(controller->effects, LED_CONTROLLER_LAYER_AUDIO, &audio);
 }
 
 void led_controller_shutdown(led_controller_t *controller)
@@ -117,47 +185,33 @@ void led_controller_shutdown(led_controller_t *controller)
     if (!controller || !controller->strip) {
         return;
     }
-    led_controller_stop_trippy_fade(controller);
+    led_effects_destroy(controller->effects);
+    controller->effects = NULL;
+    controller->trippy_active = false;
     led_strip_clear(controller->strip);
     led_strip_del(controller->strip);
     controller->strip = NULL;
 }
 
-// Convert HSV to RGB for smooth color transitions
-static void hsv_to_rgb(float h, float s, float v, uint8_t *r, uint8_t *g, uint8_t *b)
-{
-    int i = (int)(h * 6.0f);
-    float f = (h * 6.0f) - i;
-    float p = v * (1.0f - s);
-    float q = v * (1.0f - s * f);
-    float t = v * (1.0f - s * (1.0f - f));
-    
-    i = i % 6;
-    
-    switch (i) {
-        case 0: *r = (uint8_t)(v * 255); *g = (uint8_t)(t * 255); *b = (uint8_t)(p * 255); break;
-        case 1: *r = (uint8_t)(q * 255); *g = (uint8_t)(v * 255); *b = (uint8_t)(p * 255); break;
-        case 2: *r = (uint8_t)(p * 255); *g = (uint8_t)(v * 255); *b = (uint8_t)(t * 255); break;
-        case 3: *r = (uint8_t)(p * 255); *g = (uint8_t)(q * 255); *b = (uint8_t)(v * 255); break;
-        case 4: *r = (uint8_t)(t * 255); *g = (uint8_t)(p * 255); *b = (uint8_t)(v * 255); break;
-        case 5: *r = (uint8_t)(v * 255); *g = (uint8_t)(p * 255); *b = (uint8_t)(q * 255); break;
-        default: *r = 0; *g = 0; *b = 0; break;
-    }
-}
-
 void led_controller_start_trippy_fade(led_controller_t *controller)
 {
-    if (!controller || !controller->strip) {
+    if (!controller || !controller->effects) {
         return;
     }
+    const led_effect_layer_t layer = {
+        .kind = LED_EFFECT_CUSTOM,
+        .intensity = 255,
+        .period_ms = TRIPPY_CYCLE_MS,
+        .render = led_controller_render_trippy,
+    };
     controller->trippy_active = true;
-    controller->trippy_time = 0.0f;
+    led_effects_set_layer(controller->effects, LED_CONTROLLER_LAYER_BASE, &layer);
     ESP_LOGI(TAG, "Trippy fade animation started");
 }
 
 void led_controller_stop_trippy_fade(led_controller_t *controller)
 {
-    if (!controller || !controller->strip) {
+    if (!controller || !controller->effects) {
         return;
     }
     controller->trippy_active = false;
@@ -166,117 +220,46 @@ void led_controller_stop_trippy_fade(led_controller_t *controller)
     ESP_LOGI(TAG, "Trippy fade animation stopped");
 }
 
-void led_controller_update_trippy_fade(led_controller_t *controller)
+/*
+ * One sunrise-to-night cycle as keyframes: position (Q16 of the cycle), hue
+ * (LED_COLOR_HUE_MAX units), saturation and value. Each segment eases with
+ * smoothstep, and the last keyframe matches the first so the cycle wraps
+ * without a jump.
+ */
+static const struct {
+    uint32_t pos;
+    uint16_t hue;
+    uint8_t sat;
+    uint8_t val;
+} kTrippyKeys[] = {
+    { 0,       1044, 77,  13 },   // Night: deep blue-purple, very dark
+    { 19661,   123,  255, 217 },  // Sunrise: vibrant orange-red
+    { 32768,   230,  5,   255 },  // Day: warm white at peak brightness
+    { 45875,   123,  255, 140 },  // Sunset: orange-red, dimming
+    { 65536,   1044, 77,  13 },   // Night again
+};
+
+static int32_t trippy_lerp(int32_t a, int32_t b, uint8_t t)
 {
-    if (!controller || !controller->strip || !controller->trippy_active) {
-        return;
-    }
-    
-    // Update animation time
-    controller->trippy_time += controller->trippy_speed;
-    if (controller->trippy_time > 1000.0f) {
-        controller->trippy_time = 0.0f; // Reset to prevent overflow
-    }
-    
-    // Animate ALL LEDs (including status LEDs)
-    if (controller->led_count == 0) {
-        return;
-    }
-    
-    // Sunrise/Sunset cycle speed - full cycle duration
-    // Make it faster and more visible: cycle completes in ~15 seconds instead of 31
-    float cycle_speed = 0.16f;  // Doubled for faster, more visible cycle
-    float cycle_position = fmodf(controller->trippy_time * cycle_speed, 1.0f);  // 0.0 to 1.0
-    
-    // Smooth easing function for natural transitions (ease-in-out smoothstep)
-    // Inline smoothstep: t * t * (3.0f - 2.0f * t)
-    
-    // Map cycle position to time of day with smooth transitions:
-    // 0.0: Night (dark blue-purple) - matches end of cycle for smooth wraparound
-    // 0.0-0.3: Sunrise (night -> warm colors -> bright)
-    // 0.3-0.5: Day (bright white, peak brightness)
-    // 0.5-0.7: Sunset (bright -> warm colors -> dim)
-    // 0.7-1.0: Evening/Night (dim warm colors -> night)
-    // 1.0: Night (dark blue-purple) - matches start of cycle for smooth wraparound
-    
-    float hue, saturation, brightness;
-    
-    // Handle very beginning (0.0) and very end (1.0) to ensure smooth wraparound
-    if (cycle_position < 0.001f || cycle_position >= 0.999f) {
-        // At both start (0.0) and end (1.0), we're at night state
-        float night_hue = 0.68f;  // Deep blue-purple
-        hue = night_hue;
-        saturation = 0.3f;  // Low saturation (night)
-        brightness = 0.05f;  // Very dark
-    } else if (cycle_position < 0.3f) {
-        // Sunrise: Night -> Warm colors -> Bright
-        float t = cycle_position / 0.3f;  // 0.0 to 1.0
-        float phase = t * t * (3.0f - 2.0f * t);  // Smoothstep easing
-        // Start: very dark blue-purple (night), End: warm orange/red at full brightness
-        float night_hue = 0.68f;  // Deep blue-purple (night)
-        float sunrise_hue = 0.08f;  // Orange-red (sunrise)
-        // Smooth hue transition from night to sunrise
-        hue = night_hue + (sunrise_hue - night_hue) * phase;
-        // Handle hue wraparound smoothly
-        if (hue < 0.0f) hue += 1.0f;
-        if (hue >= 1.0f) hue -= 1.0f;
-        saturation = 0.3f + phase * 0.7f;  // 0.3 to 1.0 (night to vibrant sunrise)
-        brightness = 0.05f + phase * 0.85f;  // 0.05 to 0.9 (dark to bright)
-    } else if (cycle_position < 0.5f) {
-        // Day: Peak brightness, transitioning from sunrise to pure white
-        float t = (cycle_position - 0.3f) / 0.2f;  // 0.0 to 1.0
-        float phase = t * t * (3.0f - 2.0f * t);  // Smoothstep easing
-        float sunrise_hue = 0.08f;  // Orange-red
-        float day_hue = 0.15f;  // Slight yellow tint for warm white
-        hue = sunrise_hue + (day_hue - sunrise_hue) * phase;
-        saturation = 1.0f - phase * 0.98f;  // 1.0 to 0.02 (color to pure white, more dramatic)
-        brightness = 0.85f + phase * 0.15f;  // 0.85 to 1.0 (very bright, more contrast)
-    } else if (cycle_position < 0.7f) {
-        // Sunset: Bright white -> Warm colors -> Dim
-        float t = (cycle_position - 0.5f) / 0.2f;  // 0.0 to 1.0
-        float phase = t * t * (3.0f - 2.0f * t);  // Smoothstep easing
-        float day_hue = 0.15f;  // Yellow-white
-        float sunset_hue = 0.08f;  // Orange-red
-        hue = day_hue + (sunset_hue - day_hue) * phase;
-        saturation = 0.02f + phase * 0.98f;  // 0.02 to 1.0 (white to full color, more dramatic)
-        brightness = 1.0f - phase * 0.45f;  // 1.0 to 0.55 (bright to dim, more visible change)
-    } else {
-        // Evening/Night: Dim warm colors -> Night (ending at same state as start)
-        float t = (cycle_position - 0.7f) / 0.3f;  // 0.0 to 1.0
-        float phase = t * t * (3.0f - 2.0f * t);  // Smoothstep easing
-        float sunset_hue = 0.08f;  // Orange-red
-        float night_hue = 0.68f;  // Deep blue-purple
-        // Smooth hue transition from sunset to night
-        hue = sunset_hue + (night_hue - sunset_hue) * phase;
-        // Handle hue wraparound smoothly
-        if (hue < 0.0f) hue += 1.0f;
-        if (hue >= 1.0f) hue -= 1.0f;
-        saturation = 1.0f - phase * 0.7f;  // 1.0 to 0.3 (losing color more visibly)
-        brightness = 0.55f - phase * 0.5f;  // 0.55 to 0.05 (more visible dim to dark transition)
-        
-        // Ensure we end exactly at night state (matching start) for smooth wraparound
-        if (cycle_position >= 0.999f) {
-            hue = night_hue;
-            saturation = 0.3f;
-            brightness = 0.05f;
-        }
+    return a + ((b - a) * t) / 255;
+}
+
+// Effects task: the whole strip follows one sunrise/sunset cycle
+static void led_controller_render_trippy(led_rgb_t *pixels, size_t count, uint32_t elapsed_ms, void *ctx)
+{
+    (void)ctx;
+    uint32_t pos = led_color_phase16(elapsed_ms, TRIPPY_CYCLE_MS);
+    size_t k = 0;
+    while (pos >= kTrippyKeys[k + 1].pos) {
+        ++k;
     }
-    
-    // Clamp values
-    if (saturation < 0.0f) saturation = 0.0f;
-    if (saturation > 1.0f) saturation = 1.0f;
-    if (brightness < 0.05f) brightness = 0.05f;  // Very dark but not completely off
-    if (brightness > 1.0f) brightness = 1.0f;
-    if (hue < 0.0f) hue += 1.0f;
-    if (hue >= 1.0f) hue -= 1.0f;
-    
-    // Apply same color to all LEDs for uniform cycle
-    uint8_t r, g, b;
-    hsv_to_rgb(hue, saturation, brightness, &r, &g, &b);
-    
-    for (uint8_t i = 0; i < controller->led_count; ++i) {
-        set_pixel_scaled(controller, i, r, g, b);
+    uint8_t t = (uint8_t)((pos - kTrippyKeys[k].pos) * 255 / (kTrippyKeys[k + 1].pos - kTrippyKeys[k].pos));
+    uint8_t eased = led_color_ease8[t];
+
+    led_rgb_t c = led_color_hsv((uint16_t)trippy_lerp(kTrippyKeys[k].hue, kTrippyKeys[k + 1].hue, eased),
+                                (uint8_t)trippy_lerp(kTrippyKeys[k].sat, kTrippyKeys[k + 1].sat, eased),
+                                (uint8_t)trippy_lerp(kTrippyKeys[k].val, kTrippyKeys[k + 1].val, eased));
+    for (size_t i = 0; i < count; ++i) {
+        pixels[i] = c;
     }
-    
-    led_strip_refresh(controller->strip);
 }
@@ -2,6 +2,7 @@
 
 #include "esp_err.h"
 #include "hal/gpio_types.h"
+#include "led_effects.h"
 #include "led_strip.h"
 
 #ifdef __cplusplus
@@ -23,27 +24,40 @@ typedef struct {
     uint8_t reserved_pixels; // number of leading LEDs reserved for status indicators
 } led_controller_config_t;
 
+// Effects layers, bottom to top
+enum {
+    LED_CONTROLLER_LAYER_BASE = 0,    // State colour, solid colour or the trippy fade
+    LED_CONTROLLER_LAYER_AUDIO,       // Sound-reactive layer over the base
+    LED_CONTROLLER_LAYER_STATUS,      // Overlay for pixel 0; pixel n uses LAYER_STATUS + n
+};
+
 typedef struct {
     led_strip_handle_t strip;
+    led_effects_t *effects;  // Owns every write to the strip
     uint8_t led_count;
     uint8_t brightness;
     uint8_t reserved_pixels;
     led_controller_state_t state;
-    // Trippy fade animation state
     bool trippy_active;
-    float trippy_time;
-    float trippy_speed;
 } led_controller_t;
 
 esp_err_t led_controller_init(led_controller_t *controller, const led_controller_config_t *config);
 void led_controller_set_state(led_controller_t *controller, led_controller_state_t state);
-void led_controller_set_pixel_color(led_controller_t *controller, uint8_t pixel_index, uint8_t red, uint8_t green, uint8_t blue);
+// Scales every colour from the next frame on; 0-255
+void led_controller_set_brightness(led_controller_t *controller, uint8_t brightness);
+// One colour on every pixel; stops the trippy fade and turns the lights on
+void led_controller_set_color(led_controller_t *controller, uint8_t red, uint8_t green, uint8_t blue);
+// Off holds the strip black without forgetting what it was showing
+void led_controller_set_enabled(led_controller_t *controller, bool enabled);
+// Declare the overlay drawn on one status pixel; NULL removes it
+void led_controller_set_overlay(led_controller_t *controller, uint8_t pixel_index, const led_effect_layer_t *layer);
+// Declare the sound-reactive layer over the whole strip, under any status overlays; NULL removes it
+void led_controller_set_audio_layer(led_controller_t *controller, const led_effect_layer_t *layer);
 void led_controller_shutdown(led_controller_t *controller);
 
-// Trippy fade animation functions
+// Sunrise/sunset cycle over every pixel, animated by the effects task
 void led_controller_start_trippy_fade(led_controller_t *controller);
 void led_controller_stop_trippy_fade(led_controller_t *controller);
-void led_controller_update_trippy_fade(led_controller_t *controller);
 
 #ifdef __cplusplus
 }
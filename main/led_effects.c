@@ -0,0 +1,461 @@
+#include "led_effects.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "esp_check.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
+static const char *TAG = "led_effects";
+
+// Animated layers never fade all the way out (5%)
+#define LED_EFFECTS_FLOOR 13
+
+// A DIRECTION spot fades to black this far from its centre, in 1/256 pixels
+#define LED_EFFECTS_SPOT_RADIUS 384
+
+typedef struct {
+    led_effect_layer_t spec;
+    uint32_t start_ms;
+} led_effects_slot_t;
+
+struct led_effects {
+    led_strip_handle_t strip;
+    uint16_t pixel_count;
+    uint16_t base_frame_ms;           // From the config; set_frame_ms(0) returns to it
+    bool gamma;
+    SemaphoreHandle_t lock;
+    TaskHandle_t task;
+    TaskHandle_t stopper;
+    // Guarded by lock
+    led_effects_slot_t slots[LED_EFFECTS_MAX_LAYERS];
+    uint8_t brightness;
+    uint16_t frame_ms;
+    bool enabled;
+    bool stop;
+    bool reshow;                      // Hand the current frame to a new frame callback
+    led_effects_frame_cb_t frame_cb;
+    void *frame_ctx;
+    // Written without the lock; a torn frame is one level late at worst
+    volatile uint8_t levels[LED_EFFECTS_LEVEL_CHANNELS];
+    volatile uint8_t bands[LED_EFFECTS_MAX_BANDS];
+    volatile uint8_t band_count;
+    volatile uint32_t beat_ms;        // When the last new beat was reported
+    volatile uint16_t direction_deg;
+    volatile uint8_t direction_strength;
+    uint32_t beats;                   // Last count seen by set_bands
+    // Effects task only
+    led_rgb_t *frame;
+    led_rgb_t *scratch;
+    led_rgb_t *shown;
+    uint8_t lut[256];                 // Gamma and brightness, rebuilt when brightness changes
+};
+
+static uint32_t led_effects_now_ms(void)
+{
+    return (uint32_t)(esp_timer_get_time() / 1000);
+}
+
+static void led_effects_fill(led_rgb_t *pixels, size_t count, led_rgb_t c)
+{
+    for (size_t i = 0; i < count; ++i) {
+        pixels[i] = c;
+    }
+}
+
+// Returns true when the layer changes from frame to frame
+static bool led_effects_render_layer(const led_effects_t *fx,
+                                     const led_effect_layer_t *spec,
+                                     led_rgb_t *pixels,
+                                     size_t count,
+                                     uint32_t elapsed_ms,
+                                     uint32_t now_ms)
+{
+    uint32_t period = spec->period_ms ? spec->period_ms : 1000;
+    uint16_t phase = led_color_phase16(elapsed_ms, period);
+    uint8_t level = 255;
+
+    switch (spec->kind) {
+    case LED_EFFECT_SOLID:
+        led_effects_fill(pixels, count, led_color_scale(spec->color, spec->intensity));
+        return false;
+    case LED_EFFECT_BREATHING:
+        level = led_color_wave(phase);
+        break;
+    case LED_EFFECT_PULSE: {
+        // Thirds of the period: half a raised cosine up, hold, half back down
+        uint32_t third = (uint32_t)phase * 3;
+        uint16_t half = (uint16_t)((third & 0xFFFF) >> 1);
+        if (third < 0x10000) {
+            level = led_color_wave(half);
+        } else if (third < 0x20000) {
+            level = 255;
+        } else {
+            level = led_color_wave(0x8000 + half);
+        }
+        break;
+    }
+    case LED_EFFECT_GRADIENT: {
+        // color2 peaks at the pixel the phase has reached
+        uint16_t step = (uint16_t)(0x10000 / count);
+        uint16_t angle = (uint16_t)(phase + 0x8000);
+        for (size_t i = 0; i < count; ++i, angle += step) {
+            led_rgb_t c = led_color_lerp(spec->color, spec->color2, led_color_wave(angle));
+            pixels[i] = led_color_scale(c, spec->intensity);
+        }
+        return true;
+    }
+    case LED_EFFECT_BLINK: {
+        bool on = phase < 0x8000;
+        led_effects_fill(pixels, count, on ? led_color_scale(spec->color, spec->intensity) : (led_rgb_t){0});
+        return true;
+    }
+    case LED_EFFECT_LEVEL: {
+        uint8_t channel = spec->level_channel < LED_EFFECTS_LEVEL_CHANNELS ? spec->level_channel : 0;
+        uint8_t scale = led_color_scale8(fx->levels[channel], spec->intensity);
+        led_effects_fill(pixels, count, led_color_scale(spec->color, scale));
+        return true;
+    }
+    case LED_EFFECT_SPECTRUM: {
+        uint8_t bands = fx->band_count;
+        for (size_t i = 0; i < count; ++i) {
+            uint8_t band = bands ? fx->bands[i * bands / count] : 0;
+            uint8_t along = count > 1 ? (uint8_t)(i * 255 / (count - 1)) : 0;
+            led_rgb_t c = led_color_lerp(spec->color, spec->color2, along);
+            pixels[i] = led_color_scale(c, led_color_scale8(band, spec->intensity));
+        }
+        return true;
+    }
+    case LED_EFFECT_BEAT: {
+        uint32_t age = now_ms - fx->beat_ms;
+        uint8_t flash = fx->beat_ms && age < period ? (uint8_t)(255 - age * 255 / period) : 0;
+        led_effects_fill(pixels, count, led_color_scale(spec->color, led_color_scale8(flash, spec->intensity)));
+        return true;
+    }
+    case LED_EFFECT_DIRECTION: {
+        // Distances wrap around the range, so the spot can straddle its ends
+        uint8_t strength = led_color_scale8(fx->direction_strength, spec->intensity);
+        uint32_t ring = (uint32_t)count << 8;
+        uint32_t center = (uint32_t)(fx->direction_deg % 360) * ring / 360;
+        for (size_t i = 0; i < count; ++i) {
+            uint32_t at = (uint32_t)i << 8;
+            uint32_t dist = at > center ? at - center : center - at;
+            if (dist > ring / 2) {
+                dist = ring - dist;
+            }
+            uint8_t spot = dist < LED_EFFECTS_SPOT_RADIUS ? (uint8_t)(255 - dist * 255 / LED_EFFECTS_SPOT_RADIUS) : 0;
+            pixels[i] = led_color_scale(spec->color, led_color_scale8(spot, strength));
+        }
+        return true;
+    }
+    case LED_EFFECT_CUSTOM:
+        if (!spec->render) {
+            led_effects_fill(pixels, count, (led_rgb_t){0});
+            return false;
+        }
+        spec->render(pixels, count, elapsed_ms, spec->render_ctx);
+        if (spec->intensity != 255) {
+            for (size_t i = 0; i < count; ++i) {
+                pixels[i] = led_color_scale(pixels[i], spec->intensity);
+            }
+        }
+        return true;
+    case LED_EFFECT_OFF:
+    default:
+        return false;
+    }
+
+    // BREATHING and PULSE: one colour at a time-varying level
+    if (level < LED_EFFECTS_FLOOR) {
+        level = LED_EFFECTS_FLOOR;
+    }
+    led_effects_fill(pixels, count, led_color_scale(spec->color, led_color_scale8(level, spec->intensity)));
+    return true;
+}
+
+// Render every layer bottom to top into fx->frame; true when anything animates
+static bool led_effects_compose(led_effects_t *fx, const led_effects_slot_t *slots, uint32_t now_ms)
+{
+    memset(fx->frame, 0, fx->pixel_count * sizeof(led_rgb_t));
+    bool animated = false;
+    for (int s = 0; s < LED_EFFECTS_MAX_LAYERS; ++s) {
+        const led_effect_layer_t *spec = &slots[s].spec;
+        if (spec->kind == LED_EFFECT_OFF || spec->first >= fx->pixel_count) {
+            continue;
+        }
+        size_t room = fx->pixel_count - spec->first;
+        size_t count = spec->count && spec->count < room ? spec->count : room;
+        animated |= led_effects_render_layer(fx, spec, fx->scratch, count, now_ms - slots[s].start_ms, now_ms);
+
+        led_rgb_t *dst = &fx->frame[spec->first];
+        if (spec->additive) {
+            for (size_t i = 0; i < count; ++i) {
+                dst[i].r = led_color_add8(dst[i].r, fx->scratch[i].r);
+                dst[i].g = led_color_add8(dst[i].g, fx->scratch[i].g);
+                dst[i].b = led_color_add8(dst[i].b, fx->scratch[i].b);
+            }
+        } else {
+            memcpy(dst, fx->scratch, count * sizeof(led_rgb_t));
+        }
+    }
+    return animated;
+}
+
+static void led_effects_push(led_effects_t *fx)
+{
+    esp_err_t err = led_strip_set_pixels(fx->strip, 0, (const uint8_t *)fx->frame, fx->pixel_count, fx->lut);
+    if (err == ESP_OK) {
+        // Returns while the frame shifts out; the next one renders meanwhile
+        err = led_strip_submit(fx->strip);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Strip submit failed (%s)", esp_err_to_name(err));
+    }
+}
+
+static void led_effects_task(void *arg)
+{
+    led_effects_t *fx = arg;
+    led_effects_slot_t slots[LED_EFFECTS_MAX_LAYERS];
+    const size_t frame_bytes = fx->pixel_count * sizeof(led_rgb_t);
+    bool first = true;
+    uint8_t pushed_brightness = 0;
+
+    while (true) {
+        TickType_t frame_start = xTaskGetTickCount();
+
+        xSemaphoreTake(fx->lock, portMAX_DELAY);
+        if (fx->stop) {
+            xSemaphoreGive(fx->lock);
+            break;
+        }
+        memcpy(slots, fx->slots, sizeof(slots));
+        uint8_t brightness = fx->brightness;
+        TickType_t period = pdMS_TO_TICKS(fx->frame_ms) > 0 ? pdMS_TO_TICKS(fx->frame_ms) : 1;
+        bool enabled = fx->enabled;
+        led_effects_frame_cb_t frame_cb = fx->frame_cb;
+        void *frame_ctx = fx->frame_ctx;
+        bool reshow = fx->reshow;
+        fx->reshow = false;
+        xSemaphoreGive(fx->lock);
+
+        bool animated = false;
+        if (enabled) {
+            animated = led_effects_compose(fx, slots, led_effects_now_ms());
+        } else {
+            memset(fx->frame, 0, frame_bytes);
+        }
+
+        bool changed = first || reshow || memcmp(fx->frame, fx->shown, frame_bytes) != 0;
+        if (changed) {
+            memcpy(fx->shown, fx->frame, frame_bytes);
+            if (frame_cb) {
+                frame_cb(fx->frame, fx->pixel_count, frame_ctx);
+            }
+        }
+        if (fx->strip && (first || brightness != pushed_brightness)) {
+            led_color_build_lut(fx->lut, brightness, fx->gamma);
+        }
+        if (fx->strip && (changed || brightness != pushed_brightness)) {
+            led_effects_push(fx);
+            pushed_brightness = brightness;
+        }
+        first = false;
+
+        // Static frames wait for the next declaration; animations keep the frame clock
+        TickType_t wait = portMAX_DELAY;
+        if (animated) {
+            TickType_t spent = xTaskGetTickCount() - frame_start;
+            wait = spent < period ? period - spent : 0;
+        }
+        ulTaskNotifyTake(pdTRUE, wait);
+    }
+
+    TaskHandle_t stopper = fx->stopper;
+    if (stopper) {
+        xTaskNotifyGive(stopper);
+    }
+    vTaskDelete(NULL);
+}
+
+static void led_effects_wake(led_effects_t *fx)
+{
+    if (fx->task) {
+        xTaskNotifyGive(fx->task);
+    }
+}
+
+esp_err_t led_effects_create(const led_effects_config_t *config, led_effects_t **out)
+{
+    ESP_RETURN_ON_FALSE(config && out && config->pixel_count > 0, ESP_ERR_INVALID_ARG, TAG, "invalid args");
+    *out = NULL;
+
+    led_effects_t *fx = calloc(1, sizeof(*fx));
+    ESP_RETURN_ON_FALSE(fx, ESP_ERR_NO_MEM, TAG, "no mem for effects");
+    // frame, scratch and shown share one allocation
+    led_rgb_t *buffers = calloc(3 * (size_t)config->pixel_count, sizeof(led_rgb_t));
+    fx->lock = xSemaphoreCreateMutex();
+    if (!buffers || !fx->lock) {
+        free(buffers);
+        if (fx->lock) {
+            vSemaphoreDelete(fx->lock);
+        }
+        free(fx);
+        return ESP_ERR_NO_MEM;
+    }
+    fx->frame = buffers;
+    fx->scratch = buffers + config->pixel_count;
+    fx->shown = buffers + 2 * config->pixel_count;
+    fx->strip = config->strip;
+    fx->pixel_count = config->pixel_count;
+    fx->base_frame_ms = config->frame_ms ? config->frame_ms : LED_EFFECTS_DEFAULT_FRAME_MS;
+    fx->frame_ms = fx->base_frame_ms;
+    fx->brightness = config->brightness;
+    fx->gamma = config->gamma;
+    fx->enabled = true;
+
+    BaseType_t ok = xTaskCreatePinnedToCore(led_effects_task,
+                                            config->task_name ? config->task_name : "led_effects",
+                                            config->stack_bytes ? config->stack_bytes : 3072,
+                                            fx,
+                                            config->priority ? config->priority : 3,
+                                            &fx->task,
+                                            config->core);
+    if (ok != pdPASS) {
+        vSemaphoreDelete(fx->lock);
+        free(buffers);
+        free(fx);
+        return ESP_ERR_NO_MEM;
+    }
+    ESP_LOGI(TAG, "Effects engine: %u pixels, %u ms frames", fx->pixel_count, fx->frame_ms);
+    *out = fx;
+    return ESP_OK;
+}
+
+void led_effects_destroy(led_effects_t *fx)
+{
+    if (!fx) {
+        return;
+    }
+    xSemaphoreTake(fx->lock, portMAX_DELAY);
+    fx->stop = true;
+    fx->stopper = xTaskGetCurrentTaskHandle();
+    xSemaphoreGive(fx->lock);
+    led_effects_wake(fx);
+    if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(1000)) == 0) {
+        ESP_LOGW(TAG, "Effects task did not stop");
+        return;
+    }
+    vSemaphoreDelete(fx->lock);
+    free(fx->frame);
+    free(fx);
+}
+
+esp_err_t led_effects_set_layer(led_effects_t *fx, uint8_t slot, const led_effect_layer_t *layer)
+{
+    ESP_RETURN_ON_FALSE(fx && layer && slot < LED_EFFECTS_MAX_LAYERS, ESP_ERR_INVALID_ARG, TAG, "invalid layer");
+    xSemaphoreTake(fx->lock, portMAX_DELAY);
+    led_effects_slot_t *s = &fx->slots[slot];
+    if (s->spec.kind != layer->kind || s->spec.period_ms != layer->period_ms) {
+        s->start_ms = led_effects_now_ms();
+    }
+    s->spec = *layer;
+    xSemaphoreGive(fx->lock);
+    led_effects_wake(fx);
+    return ESP_OK;
+}
+
+void led_effects_clear_layer(led_effects_t *fx, uint8_t slot)
+{
+    if (!fx || slot >= LED_EFFECTS_MAX_LAYERS) {
+        return;
+    }
+    xSemaphoreTake(fx->lock, portMAX_DELAY);
+    bool was_set = fx->slots[slot].spec.kind != LED_EFFECT_OFF;
+    fx->slots[slot].spec.kind = LED_EFFECT_OFF;
+    xSemaphoreGive(fx->lock);
+    if (was_set) {
+        led_effects_wake(fx);
+    }
+}
+
+void led_effects_set_brightness(led_effects_t *fx, uint8_t brightness)
+{
+    if (!fx) {
+        return;
+    }
+    xSemaphoreTake(fx->lock, portMAX_DELAY);
+    fx->brightness = brightness;
+    xSemaphoreGive(fx->lock);
+    led_effects_wake(fx);
+}
+
+void led_effects_set_frame_ms(led_effects_t *fx, uint16_t frame_ms)
+{
+    if (!fx) {
+        return;
+    }
+    xSemaphoreTake(fx->lock, portMAX_DELAY);
+    fx->frame_ms = frame_ms ? frame_ms : fx->base_frame_ms;
+    xSemaphoreGive(fx->lock);
+}
+
+void led_effects_set_enabled(led_effects_t *fx, bool enabled)
+{
+    if (!fx) {
+        return;
+    }
+    xSemaphoreTake(fx->lock, portMAX_DELAY);
+    fx->enabled = enabled;
+    xSemaphoreGive(fx->lock);
+    led_effects_wake(fx);
+}
+
+void led_effects_set_level(led_effects_t *fx, uint8_t channel, uint8_t level)
+{
+    if (fx && channel < LED_EFFECTS_LEVEL_CHANNELS) {
+        fx->levels[channel] = level;
+    }
+}
+
+void led_effects_set_bands(led_effects_t *fx, const uint8_t *levels, size_t count, uint32_t beats)
+{
+    if (!fx || (!levels && count > 0)) {
+        return;
+    }
+    if (count > LED_EFFECTS_MAX_BANDS) {
+        count = LED_EFFECTS_MAX_BANDS;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        fx->bands[i] = levels[i];
+    }
+    fx->band_count = (uint8_t)count;
+    if (beats != fx->beats) {
+        fx->beats = beats;
+        fx->beat_ms = led_effects_now_ms();
+    }
+}
+
+void led_effects_set_direction(led_effects_t *fx, uint16_t bearing_deg, uint8_t strength)
+{
+    if (fx) {
+        fx->direction_deg = bearing_deg;
+        fx->direction_strength = strength;
+    }
+}
+
+void led_effects_set_frame_cb(led_effects_t *fx, led_effects_frame_cb_t cb, void *ctx)
+{
+    if (!fx) {
+        return;
+    }
+    xSemaphoreTake(fx->lock, portMAX_DELAY);
+    fx->frame_cb = cb;
+    fx->frame_ctx = ctx;
+    fx->reshow = true;
+    xSemaphoreGive(fx->lock);
+    led_effects_wake(fx);
+}
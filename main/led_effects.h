@@ -0,0 +1,126 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "led_color.h"
+#include "led_strip.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * One frame-clocked task per strip that owns every write to it. Callers
+ * declare what each layer should show; the task renders the layers bottom
+ * to top into one framebuffer, scales it by the strip brightness and calls
+ * led_strip_refresh() once per frame, and only when the frame changed.
+ * With nothing animated the task sleeps until a layer changes.
+ */
+
+#ifndef LED_EFFECTS_MAX_LAYERS
+#define LED_EFFECTS_MAX_LAYERS 12
+#endif
+
+#ifndef LED_EFFECTS_LEVEL_CHANNELS
+#define LED_EFFECTS_LEVEL_CHANNELS 4
+#endif
+
+#ifndef LED_EFFECTS_MAX_BANDS
+#define LED_EFFECTS_MAX_BANDS 16
+#endif
+
+#define LED_EFFECTS_DEFAULT_FRAME_MS 33
+
+typedef enum {
+    LED_EFFECT_OFF = 0,               // Layer unused; lower layers show through
+    LED_EFFECT_SOLID,                 // color
+    LED_EFFECT_BREATHING,             // color swelling 5%-100%-5% once per period
+    LED_EFFECT_PULSE,                 // color, 4-4-4: rise, hold, fall in thirds of the period
+    LED_EFFECT_GRADIENT,              // color -> color2 around the range, one turn per period
+    LED_EFFECT_BLINK,                 // color for the first half of each period, black for the second
+    LED_EFFECT_LEVEL,                 // color scaled by led_effects_set_level(level_channel)
+    LED_EFFECT_SPECTRUM,              // Bands of led_effects_set_bands() across the range, color -> color2
+    LED_EFFECT_BEAT,                  // color flashing on each beat, fading out over period_ms
+    LED_EFFECT_DIRECTION,             // color spot at led_effects_set_direction()'s bearing, the range as a ring
+    LED_EFFECT_CUSTOM,                // render() fills the range
+} led_effect_kind_t;
+
+// Fills count pixels; elapsed_ms counts from when the layer was declared
+typedef void (*led_effect_render_fn)(led_rgb_t *pixels, size_t count, uint32_t elapsed_ms, void *ctx);
+
+typedef struct {
+    led_effect_kind_t kind;
+    led_rgb_t color;
+    led_rgb_t color2;
+    uint8_t intensity;                // 0-255, applied on top of the colours
+    uint16_t first;                   // First pixel of the range
+    uint16_t count;                   // 0 = through the end of the strip
+    uint32_t period_ms;               // Animation period; ignored by SOLID and LEVEL
+    uint8_t level_channel;            // LEVEL only
+    bool additive;                    // Add onto lower layers instead of covering them
+    led_effect_render_fn render;      // CUSTOM only
+    void *render_ctx;
+} led_effect_layer_t;
+
+// Called on the effects task with each new frame, before strip brightness
+typedef void (*led_effects_frame_cb_t)(const led_rgb_t *pixels, size_t count, void *ctx);
+
+typedef struct {
+    led_strip_handle_t strip;         // May be NULL when only the frame callback consumes frames
+    uint16_t pixel_count;
+    uint8_t brightness;               // 0-255 scale on the way to the strip
+    bool gamma;                       // Gamma-correct frames on the way to the strip
+    uint16_t frame_ms;                // 0 = LED_EFFECTS_DEFAULT_FRAME_MS
+    const char *task_name;            // NULL = "led_effects"
+    uint32_t stack_bytes;             // 0 = 3072
+    UBaseType_t priority;             // 0 = 3
+    BaseType_t core;                  // Core to pin the task to, or tskNO_AFFINITY
+} led_effects_config_t;
+
+typedef struct led_effects led_effects_t;
+
+esp_err_t led_effects_create(const led_effects_config_t *config, led_effects_t **out);
+
+// Stops the task; the strip and whatever it last showed stay with the caller
+void led_effects_destroy(led_effects_t *fx);
+
+/**
+ * Declare what a layer shows. Re-declaring the same kind and period keeps
+ * the animation's phase, so a colour or intensity change does not restart it.
+ */
+esp_err_t led_effects_set_layer(led_effects_t *fx, uint8_t slot, const led_effect_layer_t *layer);
+void led_effects_clear_layer(led_effects_t *fx, uint8_t slot);
+
+void led_effects_set_brightness(led_effects_t *fx, uint8_t brightness);
+
+// Animation frame period from the next frame on; 0 returns to the config's
+void led_effects_set_frame_ms(led_effects_t *fx, uint16_t frame_ms);
+
+// While disabled the strip is held black; layers are kept for re-enable
+void led_effects_set_enabled(led_effects_t *fx, bool enabled);
+
+// Lock-free; meant to be called from audio loops at their own rate
+void led_effects_set_level(led_effects_t *fx, uint8_t channel, uint8_t level);
+
+/**
+ * Lock-free, like set_level: band levels (0-255, lowest band first) and a
+ * running beat count, e.g. straight from audio_spectrum_read().
+ */
+void led_effects_set_bands(led_effects_t *fx, const uint8_t *levels, size_t count, uint32_t beats);
+
+/**
+ * Lock-free, like set_level: where DIRECTION layers put their spot. The
+ * bearing runs 0-359 degrees around the layer's range from its first pixel;
+ * strength 0-255 scales the spot, 0 hides it.
+ */
+void led_effects_set_direction(led_effects_t *fx, uint16_t bearing_deg, uint8_t strength);
+
+void led_effects_set_frame_cb(led_effects_t *fx, led_effects_frame_cb_t cb, void *ctx);
+
+#ifdef __cplusplus
+}
+#endif
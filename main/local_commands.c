@@ -0,0 +1,180 @@
+#include "local_commands.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "esp_check.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_mn_iface.h"
+#include "esp_mn_models.h"
+#include "esp_mn_speech_commands.h"
+#include "sr_models.h"
+
+static const char *TAG = "local_commands";
+
+typedef struct {
+    const char *phrase;
+    intent_router_action_t action;
+    int volume_sign;                  // Volume commands: +1 up, -1 down
+} local_command_t;
+
+// MultiNet is most reliable on phrases of two or more words, so the bare
+// keywords of intent_router_route() appear here in short carrier phrases.
+// The command id passed to MultiNet is the index in this table.
+static const local_command_t COMMANDS[] = {
+    {"pause music", INTENT_ROUTER_ACTION_SPOTIFY_PAUSE, 0},
+    {"pause the music", INTENT_ROUTER_ACTION_SPOTIFY_PAUSE, 0},
+    {"stop music", INTENT_ROUTER_ACTION_SPOTIFY_PAUSE, 0},
+    {"stop the music", INTENT_ROUTER_ACTION_SPOTIFY_PAUSE, 0},
+    {"resume music", INTENT_ROUTER_ACTION_SPOTIFY_RESUME, 0},
+    {"continue playing", INTENT_ROUTER_ACTION_SPOTIFY_RESUME, 0},
+    {"play music", INTENT_ROUTER_ACTION_SPOTIFY_PLAY, 0},
+    {"volume up", INTENT_ROUTER_ACTION_SPOTIFY_VOLUME_DELTA, 1},
+    {"turn it up", INTENT_ROUTER_ACTION_SPOTIFY_VOLUME_DELTA, 1},
+    {"make it louder", INTENT_ROUTER_ACTION_SPOTIFY_VOLUME_DELTA, 1},
+    {"volume down", INTENT_ROUTER_ACTION_SPOTIFY_VOLUME_DELTA, -1},
+    {"turn it down", INTENT_ROUTER_ACTION_SPOTIFY_VOLUME_DELTA, -1},
+    {"make it quieter", INTENT_ROUTER_ACTION_SPOTIFY_VOLUME_DELTA, -1},
+    {"lights off", INTENT_ROUTER_ACTION_LIGHTS_OFF, 0},
+    {"turn off the lights", INTENT_ROUTER_ACTION_LIGHTS_OFF, 0},
+    {"lights out", INTENT_ROUTER_ACTION_LIGHTS_OFF, 0},
+    {"lights on", INTENT_ROUTER_ACTION_LIGHTS_ON, 0},
+    {"turn on the lights", INTENT_ROUTER_ACTION_LIGHTS_ON, 0},
+};
+
+#define COMMAND_COUNT (sizeof(COMMANDS) / sizeof(COMMANDS[0]))
+
+struct local_commands {
+    const esp_mn_iface_t *multinet;
+    model_iface_data_t *model;
+    int volume_step;
+    int16_t *chunk;                   // One MultiNet chunk, filled across AFE frames
+    size_t chunk_samples;
+    size_t chunk_fill;
+};
+
+esp_err_t local_commands_create(int volume_step, local_commands_t **out)
+{
+    ESP_RETURN_ON_FALSE(out, ESP_ERR_INVALID_ARG, TAG, "out required");
+    *out = NULL;
+
+    srmodel_list_t *models = sr_models_get();
+    char *name = models ? esp_srmodel_filter(models, ESP_MN_PREFIX, ESP_MN_ENGLISH) : NULL;
+    if (!name) {
+        ESP_LOGW(TAG, "No English MultiNet model in the model partition");
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    esp_err_t ret = ESP_OK;
+    local_commands_t *commands = calloc(1, sizeof(*commands));
+    ESP_GOTO_ON_FALSE(commands, ESP_ERR_NO_MEM, fail, TAG, "commands alloc");
+    commands->volume_step = volume_step;
+    commands->multinet = esp_mn_handle_from_name(name);
+    ESP_GOTO_ON_FALSE(commands->multinet, ESP_ERR_NOT_FOUND, fail, TAG, "no MultiNet handle for %s", name);
+    commands->model = commands->multinet->create(name, LOCAL_COMMANDS_TIMEOUT_MS);
+    ESP_GOTO_ON_FALSE(commands->model, ESP_ERR_NO_MEM, fail, TAG, "MultiNet create");
+
+    esp_mn_commands_alloc(commands->multinet, commands->model);
+    esp_mn_commands_clear();
+    for (size_t i = 0; i < COMMAND_COUNT; ++i) {
+        esp_mn_commands_add((int)i, COMMANDS[i].phrase);
+    }
+    esp_mn_error_t *rejected = esp_mn_commands_update();
+    if (rejected) {
+        for (int i = 0; i < rejected->num; ++i) {
+            ESP_LOGW(TAG, "MultiNet rejected \"%s\"", rejected->phrases[i]->string);
+        }
+    }
+
+    commands->chunk_samples = (size_t)commands->multinet->get_samp_chunksize(commands->model);
+    commands->chunk = heap_caps_malloc(commands->chunk_samples * sizeof(int16_t), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    ESP_GOTO_ON_FALSE(commands->chunk, ESP_ERR_NO_MEM, fail, TAG, "chunk alloc");
+
+    ESP_LOGI(TAG, "MultiNet %s: %u commands, %u-sample chunks", name, (unsigned)COMMAND_COUNT,
+             (unsigned)commands->chunk_samples);
+    *out = commands;
+    return ESP_OK;
+
+fail:
+    local_commands_destroy(commands);
+    return ret;
+}
+
+void local_commands_destroy(local_commands_t *commands)
+{
+    if (!commands) {
+        return;
+    }
+    if (commands->model) {
+        commands->multinet->destroy(commands->model);
+    }
+    heap_caps_free(commands->chunk);
+    free(commands);
+}
+
+static void fill_decision(const local_commands_t *commands, const local_command_t *cmd,
+                          intent_router_decision_t *decision)
+{
+    memset(decision, 0, sizeof(*decision));
+    decision->action = cmd->action;
+    decision->volume_delta = cmd->volume_sign * commands->volume_step;
+}
+
+bool local_commands_feed(local_commands_t *commands, const int16_t *samples, size_t count,
+                         intent_router_decision_t *decision, const char **phrase)
+{
+    if (!commands || !samples || !decision) {
+        return false;
+    }
+    while (count > 0) {
+        size_t n = commands->chunk_samples - commands->chunk_fill;
+        if (n > count) {
+            n = count;
+        }
+        memcpy(commands->chunk + commands->chunk_fill, samples, n * sizeof(int16_t));
+        commands->chunk_fill += n;
+        samples += n;
+        count -= n;
+        if (commands->chunk_fill < commands->chunk_samples) {
+            break;
+        }
+        commands->chunk_fill = 0;
+
+        esp_mn_state_t state = commands->multinet->detect(commands->model, commands->chunk);
+        if (state == ESP_MN_STATE_TIMEOUT) {
+            commands->multinet->clean(commands->model);
+            continue;
+        }
+        if (state != ESP_MN_STATE_DETECTED) {
+            continue;
+        }
+        esp_mn_results_t *result = commands->multinet->get_results(commands->model);
+        commands->multinet->clean(commands->model);
+        if (!result || result->num <= 0 || result->command_id[0] < 0 ||
+            result->command_id[0] >= (int)COMMAND_COUNT) {
+            continue;
+        }
+        const local_command_t *cmd = &COMMANDS[result->command_id[0]];
+        if (result->prob[0] < LOCAL_COMMANDS_MIN_PROB) {
+            ESP_LOGD(TAG, "\"%s\" below threshold (%.2f)", cmd->phrase, result->prob[0]);
+            continue;
+        }
+        ESP_LOGI(TAG, "Recognised \"%s\" (prob %.2f)", cmd->phrase, result->prob[0]);
+        fill_decision(commands, cmd, decision);
+        if (phrase) {
+            *phrase = cmd->phrase;
+        }
+        commands->chunk_fill = 0;
+        return true;
+    }
+    return false;
+}
+
+void local_commands_reset(local_commands_t *commands)
+{
+    if (commands) {
+        commands->multinet->clean(commands->model);
+        commands->chunk_fill = 0;
+    }
+}
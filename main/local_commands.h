@@ -0,0 +1,62 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "intent_router.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// MultiNet listening window per utterance; shorter commands end earlier on their own
+#ifndef LOCAL_COMMANDS_TIMEOUT_MS
+#define LOCAL_COMMANDS_TIMEOUT_MS 3000
+#endif
+
+// Minimum MultiNet probability for a command to run
+#ifndef LOCAL_COMMANDS_MIN_PROB
+#define LOCAL_COMMANDS_MIN_PROB 0.5f
+#endif
+
+/**
+ * On-device command grammar on ESP-SR MultiNet.
+ *
+ * The grammar is the local subset of intent_router_route(): playback
+ * control, volume and lights, compiled into MultiNet at create time. It is
+ * fed the AFE output from the same fetch loop as WakeNet and the VAD gate,
+ * one utterance at a time, and reports a recognised phrase as the
+ * intent_router_decision_t the cloud path would have produced for it.
+ *
+ * Not thread-safe; one task feeds it.
+ */
+typedef struct local_commands local_commands_t;
+
+/**
+ * Load the English MultiNet model from the "model" partition and install
+ * the command grammar.
+ *
+ * @param volume_step Volume delta reported for the volume commands
+ * @return ESP_ERR_NOT_FOUND if no MultiNet model is flashed
+ */
+esp_err_t local_commands_create(int volume_step, local_commands_t **out);
+void local_commands_destroy(local_commands_t *commands);
+
+/**
+ * Feed mono AFE output at the model's rate (16 kHz). Any frame length is
+ * accepted; MultiNet runs once per complete chunk.
+ *
+ * @param phrase Set to the recognised phrase when a command is returned
+ * @return true when a command was recognised; the model is then reset
+ */
+bool local_commands_feed(local_commands_t *commands, const int16_t *samples, size_t count,
+                         intent_router_decision_t *decision, const char **phrase);
+
+// Drop the current utterance's state; call when the VAD gate ends it
+void local_commands_reset(local_commands_t *commands);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,51 @@
+#include "log_drain.h"
+
+#include <inttypes.h>
+
+#include "deferred_log.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "serial_link.h"
+#include "task_placement.h"
+
+static const char *TAG = "log_drain";
+
+// Longest the drain waits for room in the serial link's ring before a frame is dropped
+#define LOG_DRAIN_FRAME_WAIT_MS 20
+
+static TaskHandle_t s_task;
+
+static void forward_record(const deferred_log_record_t *record, void *ctx)
+{
+    (void)ctx;
+    serial_link_publish_parts(SERIAL_LINK_FRAME_LOG, record, sizeof(*record), record + 1, record->args_len,
+                              LOG_DRAIN_FRAME_WAIT_MS);
+}
+
+static void log_drain_task(void *arg)
+{
+    (void)arg;
+    uint32_t reported = 0;
+    while (true) {
+        vTaskDelay(pdMS_TO_TICKS(CONFIG_KVA_LOG_DRAIN_PERIOD_MS));
+        bool binary = serial_link_wants(SERIAL_LINK_STREAM_LOG);
+        deferred_log_drain(binary ? forward_record : deferred_log_print, NULL);
+        uint32_t dropped = deferred_log_dropped();
+        if (dropped != reported) {
+            ESP_LOGW(TAG, "%" PRIu32 " deferred log records dropped on full rings", dropped - reported);
+            reported = dropped;
+        }
+    }
+}
+
+esp_err_t log_drain_init(void)
+{
+    if (s_task) {
+        return ESP_OK;
+    }
+    if (task_placement_create(TASK_PLACEMENT_LOG_DRAIN, log_drain_task, NULL, &s_task) != pdPASS) {
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
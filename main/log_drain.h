@@ -0,0 +1,23 @@
+#pragma once
+
+#include "esp_err.h"
+#include "kva_config_defaults.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * The task that turns the DLOG* records (components/deferred_log) into
+ * output, at the lowest priority on the network core. Every
+ * CONFIG_KVA_LOG_DRAIN_PERIOD_MS it empties the per-core rings: as text
+ * lines on the console, or, while a host subscribes to the serial link's
+ * LOG stream, as LOG frames that scripts/capture_logs.py --elf formats
+ * against the firmware image. Records lost to full rings are reported as
+ * a warning.
+ */
+esp_err_t log_drain_init(void);
+
+#ifdef __cplusplus
+}
+#endif
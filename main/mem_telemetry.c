@@ -0,0 +1,143 @@
+#include "mem_telemetry.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "mem_tags.h"
+#include "slab_alloc.h"
+#include "task_placement.h"
+#include "tls_mem.h"
+
+static const char *TAG = "mem_telemetry";
+
+static const struct {
+    const char *name;
+    uint32_t caps;
+} REGIONS[MEM_TELEMETRY_REGION_COUNT] = {
+    [MEM_TELEMETRY_INTERNAL] = {"internal", MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT},
+    [MEM_TELEMETRY_PSRAM] = {"psram", MALLOC_CAP_SPIRAM},
+    [MEM_TELEMETRY_DMA] = {"dma", MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL},
+};
+
+static size_t s_min_largest[MEM_TELEMETRY_REGION_COUNT];
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+const char *mem_telemetry_region_name(mem_telemetry_region_t region)
+{
+    return region < MEM_TELEMETRY_REGION_COUNT ? REGIONS[region].name : "?";
+}
+
+void mem_telemetry_sample(mem_telemetry_snapshot_t *out)
+{
+    memset(out, 0, sizeof(*out));
+    for (int r = 0; r < MEM_TELEMETRY_REGION_COUNT; ++r) {
+        multi_heap_info_t info;
+        heap_caps_get_info(&info, REGIONS[r].caps);
+        mem_telemetry_heap_t *heap = &out->heap[r];
+        heap->free_bytes = info.total_free_bytes;
+        heap->total_bytes = info.total_free_bytes + info.total_allocated_bytes;
+        heap->min_free_bytes = info.minimum_free_bytes;
+        heap->largest_free_block = info.largest_free_block;
+        if (heap->total_bytes == 0) {
+            continue;
+        }
+        portENTER_CRITICAL(&s_lock);
+        if (s_min_largest[r] == 0 || info.largest_free_block < s_min_largest[r]) {
+            s_min_largest[r] = info.largest_free_block;
+        }
+        heap->min_largest_free_block = s_min_largest[r];
+        portEXIT_CRITICAL(&s_lock);
+    }
+}
+
+#if configUSE_TRACE_FACILITY
+static bool in_placement_table(const char *name)
+{
+    for (int i = 0; i < TASK_PLACEMENT_COUNT; ++i) {
+        if (strcmp(task_placement_get((task_placement_id_t)i)->name, name) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+#endif
+
+// The table's tasks keep their worst case across restarts; the rest (IDLE,
+// esp_timer, Wi-Fi, lwIP, ...) are read live when the trace facility is on
+static void log_stacks(void)
+{
+    task_placement_log_stacks();
+#if configUSE_TRACE_FACILITY
+    UBaseType_t capacity = uxTaskGetNumberOfTasks() + 4;
+    TaskStatus_t *tasks = malloc(capacity * sizeof(*tasks));
+    if (!tasks) {
+        return;
+    }
+    UBaseType_t count = uxTaskGetSystemState(tasks, capacity, NULL);
+    for (UBaseType_t i = 0; i < count; ++i) {
+        if (in_placement_table(tasks[i].pcTaskName)) {
+            continue;
+        }
+        // ESP-IDF reports the high-water mark in bytes
+        uint32_t free_bytes = (uint32_t)tasks[i].usStackHighWaterMark;
+        ESP_LOGI(TAG, "%-15s prio %2u: %5u bytes free at worst", tasks[i].pcTaskName,
+                 (unsigned)tasks[i].uxCurrentPriority, (unsigned)free_bytes);
+        if (free_bytes < TASK_PLACEMENT_STACK_WARN_BYTES) {
+            ESP_LOGW(TAG, "%s is within %u bytes of its stack end", tasks[i].pcTaskName, (unsigned)free_bytes);
+        }
+    }
+    free(tasks);
+#endif
+}
+
+void mem_telemetry_log(void)
+{
+    mem_telemetry_snapshot_t snap;
+    mem_telemetry_sample(&snap);
+    for (int r = 0; r < MEM_TELEMETRY_REGION_COUNT; ++r) {
+        const mem_telemetry_heap_t *heap = &snap.heap[r];
+        if (heap->total_bytes == 0) {
+            continue;
+        }
+        ESP_LOGI(TAG, "%-8s %7u of %7u bytes free, %7u at worst; largest block %7u, %7u at worst",
+                 REGIONS[r].name, (unsigned)heap->free_bytes, (unsigned)heap->total_bytes,
+                 (unsigned)heap->min_free_bytes, (unsigned)heap->largest_free_block,
+                 (unsigned)heap->min_largest_free_block);
+    }
+#if CONFIG_MBEDTLS_CUSTOM_MEM_ALLOC
+    tls_mem_stats_t tls;
+    tls_mem_get(&tls);
+    ESP_LOGI(TAG, "tls      %7u internal bytes, peak %7u; %7u psram, peak %7u", (unsigned)tls.internal_bytes,
+             (unsigned)tls.internal_peak_bytes, (unsigned)tls.psram_bytes, (unsigned)tls.psram_peak_bytes);
+#endif
+#if CONFIG_MEM_TAGS_ENABLE
+    for (int t = 0; t < MEM_TAG_COUNT; ++t) {
+        mem_tag_stats_t stats;
+        mem_tags_get((mem_tag_t)t, &stats);
+        ESP_LOGI(TAG, "%-15s %7u bytes in %4u blocks, peak %7u", mem_tags_name((mem_tag_t)t),
+                 (unsigned)stats.live_bytes, (unsigned)stats.live_blocks, (unsigned)stats.peak_bytes);
+        if (stats.failures) {
+            ESP_LOGW(TAG, "%s: %u allocations failed", mem_tags_name((mem_tag_t)t), (unsigned)stats.failures);
+        }
+    }
+#endif
+    slab_alloc_class_stats_t slabs[SLAB_ALLOC_CLASSES];
+    slab_alloc_get_stats(slabs);
+    for (int c = 0; c < SLAB_ALLOC_CLASSES; ++c) {
+        if (slabs[c].slots == 0) {
+            continue;
+        }
+        ESP_LOGI(TAG, "slab %-4u     %4u of %4u slots, peak %4u", (unsigned)slabs[c].slot_size,
+                 (unsigned)slabs[c].in_use, (unsigned)slabs[c].slots, (unsigned)slabs[c].peak);
+        if (slabs[c].fallbacks) {
+            ESP_LOGW(TAG, "slab %u: %u allocations went to the heap", (unsigned)slabs[c].slot_size,
+                     (unsigned)slabs[c].fallbacks);
+        }
+    }
+    log_stacks();
+}
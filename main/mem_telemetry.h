@@ -0,0 +1,44 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    MEM_TELEMETRY_INTERNAL,           // Internal 8-bit RAM: stacks, lwIP, TLS, most malloc()
+    MEM_TELEMETRY_PSRAM,
+    MEM_TELEMETRY_DMA,                // Internal DMA-capable RAM: I2S, SPI, the LED strip
+    MEM_TELEMETRY_REGION_COUNT,
+} mem_telemetry_region_t;
+
+typedef struct {
+    size_t total_bytes;
+    size_t free_bytes;
+    size_t min_free_bytes;            // Low-water mark since boot
+    size_t largest_free_block;
+    size_t min_largest_free_block;    // Smallest largest block over all samples: fragmentation
+} mem_telemetry_heap_t;
+
+typedef struct {
+    mem_telemetry_heap_t heap[MEM_TELEMETRY_REGION_COUNT];
+} mem_telemetry_snapshot_t;
+
+// "internal", "psram", "dma"
+const char *mem_telemetry_region_name(mem_telemetry_region_t region);
+
+// Read heap_caps_get_info() for each region; a region the chip lacks reads as zero
+void mem_telemetry_sample(mem_telemetry_snapshot_t *out);
+
+/**
+ * Console report: each heap region, the tagged allocation counters
+ * (components/mem_tags) and every task's stack high-water mark, warning
+ * about tasks close to their stack end.
+ */
+void mem_telemetry_log(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,521 @@
+#include "multiroom_sync.h"
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "audio_player.h"
+#include "esp_check.h"
+#include "esp_log.h"
+#include "esp_random.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "lwip/sockets.h"
+#include "radio_coex.h"
+#include "task_placement.h"
+
+#define MR_MAGIC 0x4e4d5231u          // "NMR1"
+// Stereo frames per packet: one unfragmented datagram
+#define MR_PACKET_FRAMES 352
+#define MR_LEAD_US ((int64_t)CONFIG_KVA_MULTIROOM_LEAD_MS * 1000)
+#define MR_COARSE_US ((int64_t)CONFIG_KVA_MULTIROOM_COARSE_MS * 1000)
+// Packets the leader may send per wakeup to catch up
+#define MR_BURST_PACKETS 4
+// From queueing a frame on an idle stream to the DAC, roughly the DMA ring;
+// the first skew measurement corrects the rest
+#define MR_OUTPUT_LATENCY_US 30000
+// A follower starts on the first packet with at least this much time to spare
+#define MR_MIN_START_US 100000
+#define MR_CONTROL_US 100000
+#define MR_CLOCK_FAST_US 250000       // Until the sample window is full
+#define MR_CLOCK_SLOW_US 1000000
+#define MR_CLOCK_SAMPLES 8
+// Trim controller: proportional ppm per us of skew, and how fast the
+// integral learns the crystal difference
+#define MR_TRIM_KP 0.25f
+#define MR_TRIM_KI 0.01f
+#define MR_DRIFT_MAX_PPM 300.0f
+
+typedef enum {
+    MR_TYPE_AUDIO = 1,                // Leader to group
+    MR_TYPE_CLOCK_REQ,                // Follower to leader
+    MR_TYPE_CLOCK_RESP,               // Leader to follower
+} mr_type_t;
+
+typedef struct __attribute__((packed)) {
+    uint32_t magic;
+    uint8_t type;
+    uint8_t reserved;
+    uint16_t frames;                  // Stereo frames that follow
+    uint32_t session;                 // New each time a unit starts leading
+    uint32_t seq;
+    uint32_t rate_hz;
+    int64_t play_us;                  // Leader clock when the first frame reaches its DAC
+} mr_audio_header_t;
+
+typedef struct __attribute__((packed)) {
+    uint32_t magic;
+    uint8_t type;
+    uint8_t reserved[3];
+    int64_t t1;                       // Follower send
+    int64_t t2;                       // Leader receive
+    int64_t t3;                       // Leader send
+} mr_clock_packet_t;
+
+typedef struct {
+    int64_t offset_us;                // Leader minus local
+    int32_t rtt_us;
+} mr_clock_sample_t;
+
+static const char *TAG = "multiroom";
+static const char *const kRoleNames[] = { "off", "leader", "follower" };
+static const int16_t s_silence[MR_PACKET_FRAMES * 2];
+
+static struct {
+    volatile multiroom_role_t role;
+    multiroom_role_t active;          // Role the socket is set up for; task only
+    TaskHandle_t task;
+    int sock;
+    bool joined;                      // Follower: member of the group
+    multiroom_stats_t stats;
+    // Leader
+    uint32_t session;
+    uint32_t seq;
+    uint32_t send_pos;
+    int send_rate;
+    bool send_valid;
+    // Follower: leader clock
+    struct sockaddr_in leader;
+    bool have_leader;
+    int64_t pending_t1;
+    int64_t next_clock_us;
+    mr_clock_sample_t samples[MR_CLOCK_SAMPLES];
+    uint32_t sample_count;
+    int64_t offset_us;
+    // Follower: timeline, mapping ring positions to the leader clock
+    uint32_t follow_session;
+    uint32_t follow_rate;
+    uint32_t expect_seq;
+    bool anchored;
+    uint32_t anchor_pos;
+    int64_t anchor_play_us;
+    uint32_t settle_pos;              // Skew is measured again once this frame plays
+    int64_t next_control_us;
+    float drift_ppm;
+} s_mr = { .sock = -1 };
+
+static uint8_t s_packet[sizeof(mr_audio_header_t) + MR_PACKET_FRAMES * 4];
+
+static void close_socket(void)
+{
+    if (s_mr.sock >= 0) {
+        close(s_mr.sock);
+        s_mr.sock = -1;
+    }
+    s_mr.joined = false;
+}
+
+static esp_err_t open_socket(multiroom_role_t role)
+{
+    int sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    ESP_RETURN_ON_FALSE(sock >= 0, ESP_FAIL, TAG, "socket failed (errno %d)", errno);
+    int reuse = 1;
+    uint8_t ttl = 1;                  // Stay on the home LAN
+    // The leader paces its sends off the receive timeout
+    struct timeval timeout = { .tv_usec = role == MULTIROOM_ROLE_LEADER ? 5000 : 20000 };
+    struct sockaddr_in local = {
+        .sin_family = AF_INET,
+        .sin_port = htons(CONFIG_KVA_MULTIROOM_PORT),
+        .sin_addr.s_addr = htonl(INADDR_ANY),
+    };
+    if (setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) != 0 ||
+        setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)) != 0 ||
+        setsockopt(sock, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl)) != 0 ||
+        bind(sock, (struct sockaddr *)&local, sizeof(local)) != 0) {
+        ESP_LOGE(TAG, "UDP port %d setup failed (errno %d)", CONFIG_KVA_MULTIROOM_PORT, errno);
+        close(sock);
+        return ESP_FAIL;
+    }
+    s_mr.sock = sock;
+    return ESP_OK;
+}
+
+// Fails until the station has an address; retried every pass
+static void join_group(void)
+{
+    struct ip_mreq mreq = {
+        .imr_multiaddr.s_addr = inet_addr(CONFIG_KVA_MULTIROOM_GROUP),
+        .imr_interface.s_addr = htonl(INADDR_ANY),
+    };
+    if (setsockopt(s_mr.sock, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) == 0) {
+        s_mr.joined = true;
+        ESP_LOGI(TAG, "Listening on %s:%d", CONFIG_KVA_MULTIROOM_GROUP, CONFIG_KVA_MULTIROOM_PORT);
+    }
+}
+
+static int64_t frame_time_us(const audio_player_clock_t *clk, uint32_t pos)
+{
+    return clk->dac_us + (int64_t)(int32_t)(pos - clk->dac_pos) * 1000000 / clk->rate_hz;
+}
+
+// Multicast what the local speaker will play in the next MR_LEAD_US
+static void leader_send(int64_t now_us)
+{
+    audio_player_clock_t clk;
+    if (audio_player_get_stream_clock(AUDIO_PLAYER_STREAM_MEDIA, &clk) != ESP_OK || !clk.playing ||
+        clk.rate_hz <= 0) {
+        s_mr.send_valid = false;
+        return;
+    }
+    if (!s_mr.send_valid || clk.rate_hz != s_mr.send_rate || (int32_t)(s_mr.send_pos - clk.mixed_pos) < 0) {
+        // New stream, or we fell behind the mixer: go on from what is still queued
+        s_mr.send_pos = clk.mixed_pos;
+        s_mr.send_rate = clk.rate_hz;
+        s_mr.send_valid = true;
+    }
+
+    struct sockaddr_in to = {
+        .sin_family = AF_INET,
+        .sin_port = htons(CONFIG_KVA_MULTIROOM_PORT),
+        .sin_addr.s_addr = inet_addr(CONFIG_KVA_MULTIROOM_GROUP),
+    };
+    mr_audio_header_t *header = (mr_audio_header_t *)s_packet;
+    int16_t *pcm = (int16_t *)(s_packet + sizeof(*header));
+    for (int i = 0; i < MR_BURST_PACKETS; ++i) {
+        int64_t play_us = frame_time_us(&clk, s_mr.send_pos);
+        if (play_us > now_us + MR_LEAD_US) {
+            break;
+        }
+        size_t frames = audio_player_stream_peek(AUDIO_PLAYER_STREAM_MEDIA, s_mr.send_pos, pcm, MR_PACKET_FRAMES);
+        if (frames == 0) {
+            break;
+        }
+        *header = (mr_audio_header_t){
+            .magic = MR_MAGIC,
+            .type = MR_TYPE_AUDIO,
+            .frames = (uint16_t)frames,
+            .session = s_mr.session,
+            .seq = s_mr.seq++,
+            .rate_hz = (uint32_t)clk.rate_hz,
+            .play_us = play_us,
+        };
+        // A dropped send is a lost packet to the followers; they pad it
+        (void)sendto(s_mr.sock, s_packet, sizeof(*header) + frames * 4, 0, (struct sockaddr *)&to, sizeof(to));
+        s_mr.send_pos += (uint32_t)frames;
+        s_mr.stats.packets++;
+    }
+}
+
+static void leader_answer_clock(const mr_clock_packet_t *req, const struct sockaddr_in *from, int64_t received_us)
+{
+    mr_clock_packet_t resp = {
+        .magic = MR_MAGIC,
+        .type = MR_TYPE_CLOCK_RESP,
+        .t1 = req->t1,
+        .t2 = received_us,
+    };
+    resp.t3 = esp_timer_get_time();
+    (void)sendto(s_mr.sock, &resp, sizeof(resp), 0, (const struct sockaddr *)from, sizeof(*from));
+}
+
+// The fastest exchange in the window had the least queueing to skew it
+static void follower_clock_sample(const mr_clock_packet_t *resp, int64_t received_us)
+{
+    if (resp->t1 != s_mr.pending_t1) {
+        return;
+    }
+    s_mr.pending_t1 = 0;
+    mr_clock_sample_t sample = {
+        .offset_us = ((resp->t2 - resp->t1) + (resp->t3 - received_us)) / 2,
+        .rtt_us = (int32_t)((received_us - resp->t1) - (resp->t3 - resp->t2)),
+    };
+    s_mr.samples[s_mr.sample_count++ % MR_CLOCK_SAMPLES] = sample;
+    uint32_t count = s_mr.sample_count < MR_CLOCK_SAMPLES ? s_mr.sample_count : MR_CLOCK_SAMPLES;
+    const mr_clock_sample_t *best = &s_mr.samples[0];
+    for (uint32_t i = 1; i < count; ++i) {
+        if (s_mr.samples[i].rtt_us < best->rtt_us) {
+            best = &s_mr.samples[i];
+        }
+    }
+    s_mr.offset_us = best->offset_us;
+    s_mr.stats.rtt_us = best->rtt_us;
+    if (!s_mr.stats.clock_locked) {
+        ESP_LOGI(TAG, "Leader clock locked (rtt %d us)", (int)best->rtt_us);
+    }
+    s_mr.stats.clock_locked = true;
+}
+
+static void follower_restart(void)
+{
+    s_mr.anchored = false;
+    s_mr.drift_ppm = 0.0f;
+    audio_player_set_stream_trim(AUDIO_PLAYER_STREAM_MEDIA, 0);
+    audio_player_flush(AUDIO_PLAYER_STREAM_MEDIA);
+}
+
+static void follower_queue(const int16_t *pcm, size_t frames, uint32_t rate_hz)
+{
+    while (frames > 0) {
+        size_t queued = 0;
+        audio_player_enqueue_pcm(AUDIO_PLAYER_STREAM_MEDIA, pcm, frames, (int)rate_hz, 2, &queued);
+        if (queued == 0) {
+            // Full or still draining another rate; the next packet's gap is padded
+            return;
+        }
+        frames -= queued;
+        if (pcm != s_silence) {
+            pcm += queued * 2;
+        }
+    }
+}
+
+static void follower_silence(uint32_t frames, uint32_t rate_hz)
+{
+    while (frames > 0) {
+        uint32_t n = frames < MR_PACKET_FRAMES ? frames : MR_PACKET_FRAMES;
+        follower_queue(s_silence, n, rate_hz);
+        frames -= n;
+    }
+}
+
+// Queue a packet where its timestamp puts it on the media ring
+static void follower_audio(const mr_audio_header_t *header, const int16_t *pcm, const struct sockaddr_in *from,
+                           int64_t now_us)
+{
+    s_mr.leader = *from;
+    s_mr.have_leader = true;
+    s_mr.stats.packets++;
+    if (!s_mr.stats.clock_locked || header->rate_hz == 0) {
+        return;
+    }
+    if (header->session != s_mr.follow_session || header->rate_hz != s_mr.follow_rate) {
+        ESP_LOGI(TAG, "Following session %08" PRIx32 " at %" PRIu32 " Hz", header->session, header->rate_hz);
+        s_mr.follow_session = header->session;
+        s_mr.follow_rate = header->rate_hz;
+        s_mr.expect_seq = header->seq;
+        follower_restart();
+    }
+    if ((int32_t)(header->seq - s_mr.expect_seq) < 0) {
+        return;                       // Late duplicate or reordered
+    }
+    s_mr.stats.lost += header->seq - s_mr.expect_seq;
+    s_mr.expect_seq = header->seq + 1;
+
+    audio_player_clock_t clk;
+    if (audio_player_get_stream_clock(AUDIO_PLAYER_STREAM_MEDIA, &clk) != ESP_OK) {
+        return;
+    }
+    uint32_t rate = header->rate_hz;
+    if (!s_mr.anchored) {
+        int64_t lead_us = header->play_us - s_mr.offset_us - now_us - MR_OUTPUT_LATENCY_US;
+        if (lead_us < MR_MIN_START_US) {
+            return;
+        }
+        // Leading silence is also the media prefill, so the stream starts at once
+        s_mr.anchor_pos = clk.queued_pos + (uint32_t)(lead_us * rate / 1000000);
+        s_mr.anchor_play_us = header->play_us;
+        s_mr.settle_pos = s_mr.anchor_pos;
+        s_mr.anchored = true;
+    }
+
+    uint32_t expected = s_mr.anchor_pos + (uint32_t)((header->play_us - s_mr.anchor_play_us) * rate / 1000000);
+    int32_t gap = (int32_t)(expected - clk.queued_pos);
+    size_t skip = 0;
+    if (gap > (int32_t)rate) {
+        // More than a second missing: start over from the next packet
+        s_mr.stats.resyncs++;
+        follower_restart();
+        return;
+    }
+    if (gap > 0) {
+        follower_silence((uint32_t)gap, rate);
+    } else if (gap < 0) {
+        skip = (size_t)-gap;
+        if (skip >= header->frames) {
+            return;
+        }
+    }
+    follower_queue(pcm + skip * 2, header->frames - skip, rate);
+}
+
+// Measure skew where the DAC is now and steer the media stream's trim
+static void follower_control(void)
+{
+    audio_player_clock_t clk;
+    if (!s_mr.anchored || audio_player_get_stream_clock(AUDIO_PLAYER_STREAM_MEDIA, &clk) != ESP_OK ||
+        !clk.playing || (int32_t)(clk.dac_pos - s_mr.settle_pos) < 0) {
+        return;
+    }
+    int64_t rate = s_mr.follow_rate;
+    int64_t expected_us = s_mr.anchor_play_us - s_mr.offset_us +
+                          (int64_t)(int32_t)(clk.dac_pos - s_mr.anchor_pos) * 1000000 / rate;
+    int64_t skew_us = clk.dac_us - expected_us;
+    s_mr.stats.skew_us = (int32_t)skew_us;
+
+    if (llabs(skew_us) > MR_COARSE_US) {
+        // Late: the next packets overlap what is queued and lose their head;
+        // early: they leave a gap that is padded. Measure again once it plays.
+        int32_t shift = (int32_t)(skew_us * rate / 1000000);
+        s_mr.anchor_pos -= (uint32_t)shift;
+        s_mr.settle_pos = clk.queued_pos + (uint32_t)(shift < 0 ? -shift : 0);
+        s_mr.stats.resyncs++;
+        ESP_LOGI(TAG, "Skew %d ms, realigning", (int)(skew_us / 1000));
+        return;
+    }
+    s_mr.drift_ppm += MR_TRIM_KI * (float)skew_us;
+    if (s_mr.drift_ppm > MR_DRIFT_MAX_PPM) {
+        s_mr.drift_ppm = MR_DRIFT_MAX_PPM;
+    } else if (s_mr.drift_ppm < -MR_DRIFT_MAX_PPM) {
+        s_mr.drift_ppm = -MR_DRIFT_MAX_PPM;
+    }
+    int32_t ppm = (int32_t)(s_mr.drift_ppm + MR_TRIM_KP * (float)skew_us);
+    if (ppm > AUDIO_PLAYER_TRIM_MAX_PPM) {
+        ppm = AUDIO_PLAYER_TRIM_MAX_PPM;
+    } else if (ppm < -AUDIO_PLAYER_TRIM_MAX_PPM) {
+        ppm = -AUDIO_PLAYER_TRIM_MAX_PPM;
+    }
+    s_mr.stats.trim_ppm = ppm;
+    audio_player_set_stream_trim(AUDIO_PLAYER_STREAM_MEDIA, ppm);
+}
+
+static void follower_tick(int64_t now_us)
+{
+    if (!s_mr.joined) {
+        join_group();
+    }
+    if (s_mr.have_leader && now_us >= s_mr.next_clock_us) {
+        mr_clock_packet_t req = {
+            .magic = MR_MAGIC,
+            .type = MR_TYPE_CLOCK_REQ,
+            .t1 = now_us,
+        };
+        s_mr.pending_t1 = now_us;
+        (void)sendto(s_mr.sock, &req, sizeof(req), 0, (struct sockaddr *)&s_mr.leader, sizeof(s_mr.leader));
+        s_mr.next_clock_us = now_us + (s_mr.sample_count < MR_CLOCK_SAMPLES ? MR_CLOCK_FAST_US : MR_CLOCK_SLOW_US);
+    }
+    if (now_us >= s_mr.next_control_us) {
+        follower_control();
+        s_mr.next_control_us = now_us + MR_CONTROL_US;
+    }
+}
+
+static void handle_packet(size_t len, const struct sockaddr_in *from, int64_t now_us)
+{
+    uint32_t magic;
+    memcpy(&magic, s_packet, sizeof(magic));
+    if (len < 5 || magic != MR_MAGIC) {
+        return;
+    }
+    uint8_t type = s_packet[4];
+    if (s_mr.active == MULTIROOM_ROLE_LEADER && type == MR_TYPE_CLOCK_REQ && len == sizeof(mr_clock_packet_t)) {
+        mr_clock_packet_t req;
+        memcpy(&req, s_packet, sizeof(req));
+        leader_answer_clock(&req, from, now_us);
+    } else if (s_mr.active == MULTIROOM_ROLE_FOLLOWER && type == MR_TYPE_CLOCK_RESP &&
+               len == sizeof(mr_clock_packet_t)) {
+        mr_clock_packet_t resp;
+        memcpy(&resp, s_packet, sizeof(resp));
+        follower_clock_sample(&resp, now_us);
+    } else if (s_mr.active == MULTIROOM_ROLE_FOLLOWER && type == MR_TYPE_AUDIO && len >= sizeof(mr_audio_header_t)) {
+        mr_audio_header_t header;
+        memcpy(&header, s_packet, sizeof(header));
+        if (len == sizeof(header) + (size_t)header.frames * 4 && header.frames <= MR_PACKET_FRAMES) {
+            follower_audio(&header, (const int16_t *)(s_packet + sizeof(header)), from, now_us);
+        }
+    }
+}
+
+// Tear down the role the socket was set up for and set up the requested one
+static void switch_role(multiroom_role_t role)
+{
+    if (s_mr.active == MULTIROOM_ROLE_FOLLOWER) {
+        follower_restart();
+    }
+    close_socket();
+    s_mr.active = MULTIROOM_ROLE_OFF;
+    radio_coex_set_busy(RADIO_COEX_MULTIROOM, false);
+    if (role == MULTIROOM_ROLE_OFF || open_socket(role) != ESP_OK) {
+        ESP_LOGI(TAG, "Multi-room off");
+        return;
+    }
+
+    multiroom_stats_t stats = { .role = role };
+    s_mr.stats = stats;
+    s_mr.session = esp_random();
+    s_mr.send_valid = false;
+    s_mr.have_leader = false;
+    s_mr.sample_count = 0;
+    s_mr.pending_t1 = 0;
+    s_mr.follow_session = 0;
+    s_mr.follow_rate = 0;
+    s_mr.anchored = false;
+    s_mr.active = role;
+    // Keep the radio on Wi-Fi: both sides live on steady packet timing
+    radio_coex_set_busy(RADIO_COEX_MULTIROOM, true);
+    ESP_LOGI(TAG, "Multi-room %s on port %d", kRoleNames[role], CONFIG_KVA_MULTIROOM_PORT);
+}
+
+static void multiroom_task(void *arg)
+{
+    (void)arg;
+    while (true) {
+        multiroom_role_t role = s_mr.role;
+        if (role != s_mr.active) {
+            switch_role(role);
+        }
+        if (s_mr.active == MULTIROOM_ROLE_OFF) {
+            ulTaskNotifyTake(pdTRUE, role == MULTIROOM_ROLE_OFF ? portMAX_DELAY : pdMS_TO_TICKS(1000));
+            continue;
+        }
+
+        struct sockaddr_in from;
+        socklen_t from_len = sizeof(from);
+        int len = recvfrom(s_mr.sock, s_packet, sizeof(s_packet), 0, (struct sockaddr *)&from, &from_len);
+        int64_t now_us = esp_timer_get_time();
+        if (len > 0 && from.sin_family == AF_INET) {
+            handle_packet((size_t)len, &from, now_us);
+        }
+        if (s_mr.active == MULTIROOM_ROLE_LEADER) {
+            leader_send(now_us);
+        } else {
+            follower_tick(now_us);
+        }
+    }
+}
+
+esp_err_t multiroom_sync_set_role(multiroom_role_t role)
+{
+#if CONFIG_KVA_MULTIROOM
+    ESP_RETURN_ON_FALSE(role >= MULTIROOM_ROLE_OFF && role <= MULTIROOM_ROLE_FOLLOWER, ESP_ERR_INVALID_ARG, TAG,
+                        "role");
+    s_mr.role = role;
+    if (!s_mr.task) {
+        if (role == MULTIROOM_ROLE_OFF) {
+            return ESP_OK;
+        }
+        ESP_RETURN_ON_FALSE(task_placement_create(TASK_PLACEMENT_MULTIROOM, multiroom_task, NULL, &s_mr.task) ==
+                                pdPASS,
+                            ESP_ERR_NO_MEM, TAG, "task");
+    }
+    xTaskNotifyGive(s_mr.task);
+    return ESP_OK;
+#else
+    return role == MULTIROOM_ROLE_OFF ? ESP_OK : ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
+multiroom_role_t multiroom_sync_get_role(void)
+{
+    return s_mr.role;
+}
+
+void multiroom_sync_get_stats(multiroom_stats_t *stats)
+{
+    if (stats) {
+        *stats = s_mr.stats;
+        stats->role = s_mr.active;
+    }
+}
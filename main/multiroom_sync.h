@@ -0,0 +1,63 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "kva_config_defaults.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Multi-room playback: one unit leads and the others play its media stream
+ * in step with it.
+ *
+ * The leader reads PCM straight out of its own media ring, ahead of the
+ * mixer, and multicasts it to CONFIG_KVA_MULTIROOM_GROUP stamped with the
+ * time on the leader's clock that each packet reaches the leader's DAC. It
+ * sends CONFIG_KVA_MULTIROOM_LEAD_MS ahead of its speaker, so whatever plays
+ * there (Spotify, soundscapes) is shared without changes to the sources.
+ *
+ * Followers estimate the leader's clock from timestamped request/response
+ * pairs, keeping the offset of the fastest recent exchange. Each packet is
+ * queued where its timestamp puts it, padding lost packets with silence.
+ * The media stream's clock is compared with where the frames should be
+ * heard: a trim of up to AUDIO_PLAYER_TRIM_MAX_PPM pulls small errors and
+ * crystal drift in inaudibly. Errors beyond CONFIG_KVA_MULTIROOM_COARSE_MS
+ * are fixed at once by skipping or padding audio.
+ *
+ * A follower owns its media stream: local media producers should stay idle.
+ */
+
+typedef enum {
+    MULTIROOM_ROLE_OFF = 0,
+    MULTIROOM_ROLE_LEADER,
+    MULTIROOM_ROLE_FOLLOWER,
+} multiroom_role_t;
+
+typedef struct {
+    multiroom_role_t role;
+    uint32_t packets;                 // Audio packets sent or received
+    uint32_t lost;                    // Follower: packets missing from the sequence
+    uint32_t resyncs;                 // Follower: timeline restarts and coarse corrections
+    int32_t skew_us;                  // Follower: last measured lateness against the leader (+ = late)
+    int32_t trim_ppm;                 // Follower: trim applied to the media stream
+    int32_t rtt_us;                   // Follower: round trip of the clock exchange in use
+    bool clock_locked;                // Follower: has a leader clock estimate
+} multiroom_stats_t;
+
+/**
+ * Switch role, stopping the previous one. A follower takes over the media
+ * stream from the first packet it can place; OFF gives it back untrimmed.
+ */
+esp_err_t multiroom_sync_set_role(multiroom_role_t role);
+
+multiroom_role_t multiroom_sync_get_role(void);
+
+void multiroom_sync_get_stats(multiroom_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
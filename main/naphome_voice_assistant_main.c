@@ -2,29 +2,58 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "audio_graph.h"
 #include "audio_player.h"
+#include "audio_taps.h"
 #include "kva_config_defaults.h"
 #include "aws_iot_bridge.h"
+#include "bench_mode.h"
+#include "boot_sequence.h"
+#include "breath_monitor.h"
 #include "button_service.h"
+#include "control_coalescer.h"
+#include "cpu_profiler.h"
+#include "deadline_monitor.h"
+#include "dns_cache.h"
 #include "esp_check.h"
 #include "esp_event.h"
 #include "esp_log.h"
 #include "esp_netif.h"
 #include "esp_timer.h"
 #include "esp_wifi.h"
+#include "feature_flags.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/event_groups.h"
+#include "interaction_arena.h"
+#include "i2c_topology.h"
 #include "intent_router.h"
 #include "korvo_audio.h"
 #include "led_controller.h"
+#include "log_drain.h"
+#include "mem_telemetry.h"
+#include "night_summary.h"
+#include "occupancy.h"
 #include "somnus_mqtt.h"
 #include "aws_iot_service.h"
 #include "nvs_flash.h"
+#include "power_profile.h"
+#include "radio_coex.h"
 #include "spotify_client.h"
 #include "spotify_player.h"
 #include "serial_command_parser.h"
+#include "slab_alloc.h"
+#include "sound_bank.h"
+#include "storage.h"
+#include "task_placement.h"
+#include "tts_cache.h"
 #include "voice_pipeline.h"
+#include "wake_capture.h"
+#include "wake_arbiter.h"
 #include "wake_word_service.h"
+#include "wifi_fast_connect.h"
+#if CONFIG_KVA_SPECTRUM_LEDS
+#include "audio_spectrum.h"
+#endif
 #include "sensor_integration.h"
 #include "matter_bridge.h"
 #include "sensor_manager.h"
@@ -36,6 +65,9 @@
 #include "esp_system.h"
 #include "version_info.h"
 #include "device_state.h"
+#include "device_shadow.h"
+#include "event_bus.h"
+#include "timer_wheel.h"
 
 static const char *TAG = "naphome_assistant";
 
@@ -47,11 +79,23 @@ static void shutdown_handler(void)
     ESP_LOGE(TAG, "Minimum free heap: %u bytes", (unsigned int)esp_get_minimum_free_heap_size());
 }
 
-// Forward declaration for microphone LED update function
-void update_mic_leds(float mic1_level, float mic2_level, float mic3_level);
+static bool probe_i2c_address(uint8_t addr, void *ctx)
+{
+    i2c_port_t i2c_port = *(const i2c_port_t *)ctx;
+    i2c_cmd_handle_t cmd = i2c_cmd_link_create();
+    i2c_master_start(cmd);
+    i2c_master_write_byte(cmd, (addr << 1) | I2C_MASTER_WRITE, true);
+    i2c_master_stop(cmd);
+    esp_err_t ret = i2c_master_cmd_begin(i2c_port, cmd, pdMS_TO_TICKS(50));
+    i2c_cmd_link_delete(cmd);
+    return ret == ESP_OK;
+}
 
 /**
  * @brief Scan I2C bus for devices
+ *
+ * Only the addresses found on an earlier boot are probed while they all
+ * still answer; see i2c_topology.h.
  * @param i2c_port I2C port number (I2C_NUM_0 or I2C_NUM_1)
  * @param sda_gpio SDA GPIO pin
  * @param scl_gpio SCL GPIO pin
@@ -84,29 +128,30 @@ static void scan_i2c_bus(i2c_port_t i2c_port, int sda_gpio, int scl_gpio, const
         return;
     }
     
-    // Scan all possible 7-bit addresses (0x08 to 0x77)
-    int found_count = 0;
-    for (uint8_t addr = 0x08; addr < 0x78; addr++) {
-        i2c_cmd_handle_t cmd = i2c_cmd_link_create();
-        i2c_master_start(cmd);
-        i2c_master_write_byte(cmd, (addr << 1) | I2C_MASTER_WRITE, true);
-        i2c_master_stop(cmd);
-        ret = i2c_master_cmd_begin(i2c_port, cmd, pdMS_TO_TICKS(50));
-        i2c_cmd_link_delete(cmd);
-        
-        if (ret == ESP_OK) {
-            ESP_LOGI(TAG, "  ✓ Found device at address 0x%02X", addr);
-            found_count++;
-        }
-    }
-    
+    const i2c_topology_bus_t bus = {
+        .port = i2c_port,
+        .sda = sda_gpio,
+        .scl = scl_gpio,
+        .freq_hz = conf.master.clk_speed,
+    };
+    i2c_topology_t topology;
+    ret = i2c_topology_discover(&bus, probe_i2c_address, &i2c_port, false, &topology);
+
     // Clean up
     i2c_driver_delete(i2c_port);
-    
-    if (found_count == 0) {
+
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "  Scan failed: %s", esp_err_to_name(ret));
+        return;
+    }
+    for (uint8_t i = 0; i < topology.count; i++) {
+        ESP_LOGI(TAG, "  ✓ Found device at address 0x%02X", topology.addr[i]);
+    }
+    if (topology.count == 0) {
         ESP_LOGW(TAG, "  No devices found on %s", bus_name);
     } else {
-        ESP_LOGI(TAG, "  Total: %d device(s) found on %s", found_count, bus_name);
+        ESP_LOGI(TAG, "  Total: %d device(s) found on %s (%s, %u probes)", topology.count, bus_name,
+                 topology.from_cache ? "verified from cache" : "full scan", topology.probes);
     }
     ESP_LOGI(TAG, "=== End scan of %s ===\n", bus_name);
 }
@@ -136,29 +181,58 @@ static const char* led_names[] = {
 
 #define WIFI_CONNECTED_BIT BIT0
 #define WIFI_FAIL_BIT BIT1
+// Failed attempts before the boot stage gives up waiting (retries go on)
+#define WIFI_BOOT_MAX_RETRY 5
 
 static EventGroupHandle_t s_wifi_event_group;
-static int s_retry_num = 0;
-static led_controller_t *s_led_controller_handle = NULL;
-static esp_timer_handle_t s_wifi_led_timer;
-static esp_timer_handle_t s_wake_word_led_timer;
-static esp_timer_handle_t s_audio_playback_timer;
-static esp_timer_handle_t s_trippy_fade_timer;
-static bool s_wifi_led_on;
-static bool s_muted = false;
-static bool s_audio_playing = false;
-static uint8_t s_audio_playback_brightness = 0;
-static bool s_lights_enabled = true; // Track if lights are on or off
-static bool s_aws_connected = false; // Track AWS IoT connection state
+// Not static: device_state.c reads the handle, mute, playback, lights and AWS
+// flags below for the LLM device-state snapshot
+led_controller_t *s_led_controller_handle = NULL;
+bool s_muted = false;
+bool s_audio_playing = false;
+bool s_lights_enabled = true; // Track if lights are on or off
+bool s_aws_connected = false; // Track AWS IoT connection state
 
-static void set_status_led(uint8_t index, uint8_t red, uint8_t green, uint8_t blue)
+// Mic level channels of the effects engine, one per mic LED
+#define MIC1_LEVEL_CHANNEL 0
+#define MIC2_LEVEL_CHANNEL 1
+#define MIC3_LEVEL_CHANNEL 2
+
+// Status pixels are overlays above the trippy fade, animated by the LED
+// effects task. With CONFIG_KVA_LED_STATUS_OVERLAYS off the fade keeps
+// every pixel and these calls do nothing.
+static void set_status_effect(uint8_t index, led_effect_kind_t kind, uint8_t red, uint8_t green, uint8_t blue,
+                              uint32_t period_ms)
 {
-    // Status LEDs are now animated by trippy fade, so this function is a no-op
-    // But we keep it for compatibility in case any code still calls it
+#if CONFIG_KVA_LED_STATUS_OVERLAYS
+    if (!s_led_controller_handle) {
+        return;
+    }
+    if (kind == LED_EFFECT_OFF) {
+        led_controller_set_overlay(s_led_controller_handle, index, NULL);
+        return;
+    }
+    const led_effect_layer_t layer = {
+        .kind = kind,
+        .color = {red, green, blue},
+        .intensity = 255,
+        .period_ms = period_ms,
+    };
+    led_controller_set_overlay(s_led_controller_handle, index, &layer);
+#else
     (void)index;
+    (void)kind;
     (void)red;
     (void)green;
     (void)blue;
+    (void)period_ms;
+#endif
+}
+
+static void set_status_led(uint8_t index, uint8_t red, uint8_t green, uint8_t blue)
+{
+    // Black hands the pixel back to the layer below
+    set_status_effect(index, (red | green | blue) ? LED_EFFECT_SOLID : LED_EFFECT_OFF, red, green, blue, 0);
 }
 
 // Helper function to scale audio level to LED brightness
@@ -186,36 +260,125 @@ static uint8_t scale_audio_level_to_brightness(float level)
     return brightness > 0 ? (brightness < 30 ? 30 : brightness) : 0; // Minimum 30 for visibility
 }
 
-// Update microphone LEDs (4, 8, 12) based on audio levels
-// LED 4 = MIC1 (left channel), LED 8 = MIC2 (right channel), LED 12 = MIC3 (combined)
-// Note: All LEDs are now animated by trippy fade, so this function is disabled
-void update_mic_leds(float mic1_level, float mic2_level, float mic3_level)
+// Feed the mic LEDs' level overlays: MIC1 (left channel RMS), MIC2 (right
+// channel RMS), MIC3 (the talker, from audio_meter_voice_rms()). The audio
+// loops publish levels at their own rate; the effects task picks them up on
+// its next frame.
+static void update_mic_leds(float mic1_level, float mic2_level, float mic3_level)
 {
-    // All LEDs are animated by trippy fade, so mic LEDs are part of the animation
+#if CONFIG_KVA_LED_STATUS_OVERLAYS
+    if (!s_led_controller_handle) {
+        return;
+    }
+    led_effects_t *effects = s_led_controller_handle->effects;
+    led_effects_set_level(effects, MIC1_LEVEL_CHANNEL, scale_audio_level_to_brightness(mic1_level));
+    led_effects_set_level(effects, MIC2_LEVEL_CHANNEL, scale_audio_level_to_brightness(mic2_level));
+    led_effects_set_level(effects, MIC3_LEVEL_CHANNEL, scale_audio_level_to_brightness(mic3_level));
+#else
     (void)mic1_level;
     (void)mic2_level;
     (void)mic3_level;
+#endif
+}
+
+static void mic_led_overlays_init(void)
+{
+#if CONFIG_KVA_LED_STATUS_OVERLAYS
+    static const struct {
+        uint8_t index;
+        uint8_t channel;
+    } kMicLeds[] = {
+        {MIC1_LED_INDEX, MIC1_LEVEL_CHANNEL},
+        {MIC2_LED_INDEX, MIC2_LEVEL_CHANNEL},
+        {MIC3_LED_INDEX, MIC3_LEVEL_CHANNEL},
+    };
+    for (size_t i = 0; i < sizeof(kMicLeds) / sizeof(kMicLeds[0]); ++i) {
+        const led_effect_layer_t layer = {
+            .kind = LED_EFFECT_LEVEL,
+            .color = {0, 120, 255},
+            .intensity = 255,
+            .level_channel = kMicLeds[i].channel,
+        };
+        led_controller_set_overlay(s_led_controller_handle, kMicLeds[i].index, &layer);
+    }
+#endif
 }
 
-void lights_off(void)
+#if CONFIG_KVA_SPECTRUM_LEDS
+// Published by the wake word listener after each batch of mel rows
+static void update_spectrum_leds(audio_spectrum_t *spectrum)
 {
     if (!s_led_controller_handle) {
         return;
     }
-    s_lights_enabled = false;
-    // Stop trippy fade animation
-    led_controller_stop_trippy_fade(s_led_controller_handle);
-    if (s_trippy_fade_timer) {
-        esp_timer_stop(s_trippy_fade_timer);
+    uint8_t bands[LED_EFFECTS_MAX_BANDS];
+    uint32_t beats = 0;
+    size_t count = audio_spectrum_read(spectrum, bands, sizeof(bands), &beats);
+    led_effects_set_bands(s_led_controller_handle->effects, bands, count, beats);
+}
+#endif
+
+static void spectrum_led_layer_init(void)
+{
+#if CONFIG_KVA_SPECTRUM_LEDS
+    // Bass warm to treble cool, added over the ambient light
+    const led_effect_layer_t layer = {
+        .kind = LED_EFFECT_SPECTRUM,
+        .color = {255, 60, 0},
+        .color2 = {0, 80, 255},
+        .intensity = 200,
+        .additive = true,
+    };
+    led_controller_set_audio_layer(s_led_controller_handle, &layer);
+#endif
+}
+
+#if CONFIG_KVA_DOA_ENABLE
+// Published by the AFE loop after each direction-of-arrival window; angle_deg
+// is -90 (toward capture channel 0) to +90, the spot goes out with the speech
+static void update_direction_leds(float angle_deg, float confidence, bool active)
+{
+#if CONFIG_KVA_DOA_LEDS
+    if (!s_led_controller_handle) {
+        return;
     }
-    // Turn off ALL LEDs
-    for (uint8_t i = 0; i < s_led_controller_handle->led_count; ++i) {
-        led_controller_set_pixel_color(s_led_controller_handle, i, 0, 0, 0);
+    int bearing = (CONFIG_KVA_DOA_LED_OFFSET_DEG + (int)lroundf(angle_deg) + 360) % 360;
+    uint8_t strength = active ? (uint8_t)(confidence * 255.0f) : 0;
+    led_effects_set_direction(s_led_controller_handle->effects, (uint16_t)bearing, strength);
+#else
+    (void)angle_deg;
+    (void)confidence;
+    (void)active;
+#endif
+}
+#endif
+
+static void direction_led_layer_init(void)
+{
+#if CONFIG_KVA_DOA_LEDS
+    // A white spot toward the talker, added over the ambient light
+    const led_effect_layer_t layer = {
+        .kind = LED_EFFECT_DIRECTION,
+        .color = {255, 255, 255},
+        .intensity = 255,
+        .additive = true,
+    };
+    led_controller_set_audio_layer(s_led_controller_handle, &layer);
+#endif
+}
+
+static void lights_off(void)
+{
+    if (!s_led_controller_handle) {
+        return;
     }
+    s_lights_enabled = false;
+    // Hold ALL LEDs black; the effects task sleeps until they come back
+    led_controller_set_enabled(s_led_controller_handle, false);
     ESP_LOGI(TAG, "Lights turned off");
 }
 
-void lights_on(void)
+static void lights_on(void)
 {
     if (!s_led_controller_handle) {
         return;
@@ -223,32 +386,87 @@ void lights_on(void)
     s_lights_enabled = true;
     // Restart trippy fade animation - it will animate all LEDs
     led_controller_start_trippy_fade(s_led_controller_handle);
-    if (s_trippy_fade_timer) {
-        esp_timer_start_periodic(s_trippy_fade_timer, 50 * 1000);
-    }
+    led_controller_set_enabled(s_led_controller_handle, true);
     ESP_LOGI(TAG, "Lights turned on - trippy fade animating all LEDs");
 }
 
-static void wifi_led_timer_cb(void *arg)
+#if CONFIG_KVA_LED_AUTO_DIM
+static timer_wheel_timer_t *s_led_wake_timer;
+static control_coalescer_t *s_led_dim;
+static uint16_t s_ambient_lux = CONFIG_KVA_LED_AUTO_DIM_FULL_LUX;
+static bool s_led_wake_hold;
+
+static uint8_t ambient_led_brightness(uint16_t lux)
 {
-    (void)arg;
-    if (!s_led_controller_handle) {
+    if (lux >= CONFIG_KVA_LED_AUTO_DIM_FULL_LUX) {
+        return CONFIG_KVA_LED_BRIGHTNESS;
+    }
+    return CONFIG_KVA_LED_MIN_BRIGHTNESS +
+           (CONFIG_KVA_LED_BRIGHTNESS - CONFIG_KVA_LED_MIN_BRIGHTNESS) * lux / CONFIG_KVA_LED_AUTO_DIM_FULL_LUX;
+}
+
+static void led_auto_dim_apply(void)
+{
+    if (!s_led_controller_handle || !s_lights_enabled) {
         return;
     }
-    s_wifi_led_on = !s_wifi_led_on;
-    if (s_wifi_led_on) {
-        set_status_led(WIFI_LED_INDEX, 0, 80, 80);
+    uint8_t level = s_led_wake_hold ? CONFIG_KVA_LED_BRIGHTNESS : ambient_led_brightness(s_ambient_lux);
+    if (s_led_dim) {
+        // Every light sample lands here; the coalescer fades to the latest
+        control_coalescer_set(s_led_dim, level);
     } else {
-        set_status_led(WIFI_LED_INDEX, 0, 0, 0);
+        led_controller_set_brightness(s_led_controller_handle, level);
     }
 }
 
-static void trippy_fade_timer_cb(void *arg)
+static void led_dim_apply_cb(int value, bool settled, void *ctx)
 {
-    (void)arg;
+    (void)settled;
+    (void)ctx;
     if (s_led_controller_handle && s_lights_enabled) {
-        led_controller_update_trippy_fade(s_led_controller_handle);
+        led_controller_set_brightness(s_led_controller_handle, (uint8_t)value);
+    }
+}
+
+static void led_wake_timer_cb(void *arg)
+{
+    (void)arg;
+    s_led_wake_hold = false;
+    led_auto_dim_apply();
+}
+
+// Light events and proximity that wakes the LEDs
+static void ambient_sensor_event_cb(const sensor_integration_event_t *event, void *user_ctx)
+{
+    (void)user_ctx;
+    s_ambient_lux = event->ambient_lux;
+    if (event->type == SENSOR_INTEGRATION_EVENT_PROXIMITY && event->near && s_led_wake_timer) {
+        // Wave to wake: full brightness for a while, then back to the room's level
+        s_led_wake_hold = true;
+        timer_wheel_start_once(s_led_wake_timer, CONFIG_KVA_LED_WAKE_HOLD_MS);
+    }
+    led_auto_dim_apply();
+}
+#endif
+
+// Sleep mode bounds the night the sensor manager aggregates
+static void night_sleep_cb(bool sleeping, void *ctx)
+{
+    (void)ctx;
+    night_summary_set_open(sleeping);
+}
+
+// Proximity and light events, on the sensor sampling task
+static void sensor_event_cb(const sensor_integration_event_t *event, void *user_ctx)
+{
+    if (event->type == SENSOR_INTEGRATION_EVENT_PROXIMITY && event->near) {
+        occupancy_note(OCCUPANCY_SOURCE_PROXIMITY);
+    }
+#if CONFIG_KVA_LED_AUTO_DIM
+    if (s_led_controller_handle) {
+        ambient_sensor_event_cb(event, user_ctx);
     }
+#endif
 }
 
 typedef enum {
@@ -260,98 +478,36 @@ typedef enum {
 
 static void wifi_led_set_mode(wifi_led_mode_t mode)
 {
-    if (!s_led_controller_handle) {
-        return;
-    }
     switch (mode) {
         case WIFI_LED_CONNECTING:
-            if (!s_wifi_led_timer) {
-                const esp_timer_create_args_t args = {
-                    .callback = wifi_led_timer_cb,
-                    .name = "wifi_led",
-                };
-                esp_err_t err = esp_timer_create(&args, &s_wifi_led_timer);
-                if (err != ESP_OK) {
-                    ESP_LOGE(TAG, "Failed to create Wi-Fi LED timer (%s)", esp_err_to_name(err));
-                    s_wifi_led_timer = NULL;
-                }
-            }
-            s_wifi_led_on = true;
-            set_status_led(WIFI_LED_INDEX, 0, 80, 80);
-            if (s_wifi_led_timer) {
-                esp_timer_start_periodic(s_wifi_led_timer, 350 * 1000);
-            }
+            set_status_effect(WIFI_LED_INDEX, LED_EFFECT_BLINK, 0, 80, 80, 700);
             break;
         case WIFI_LED_CONNECTED:
-            if (s_wifi_led_timer) {
-                esp_timer_stop(s_wifi_led_timer);
-            }
             set_status_led(WIFI_LED_INDEX, 0, 80, 80);
             break;
         case WIFI_LED_FAILED:
-            if (s_wifi_led_timer) {
-                esp_timer_stop(s_wifi_led_timer);
-            }
             set_status_led(WIFI_LED_INDEX, 80, 0, 0);
             break;
         case WIFI_LED_OFF:
         default:
-            if (s_wifi_led_timer) {
-                esp_timer_stop(s_wifi_led_timer);
-            }
             set_status_led(WIFI_LED_INDEX, 0, 0, 0);
             break;
     }
 }
 
-static void wake_word_led_timer_cb(void *arg)
-{
-    (void)arg;
-    if (!s_led_controller_handle) {
-        return;
-    }
-    static bool wake_led_on = false;
-    wake_led_on = !wake_led_on;
-    if (wake_led_on) {
-        set_status_led(WAKE_WORD_LED_INDEX, 255, 165, 0); // Orange
-    } else {
-        set_status_led(WAKE_WORD_LED_INDEX, 0, 0, 0);
-    }
-}
-
 static void wake_word_led_activate(void)
 {
-    if (!s_led_controller_handle) {
-        return;
-    }
-    if (!s_wake_word_led_timer) {
-        const esp_timer_create_args_t args = {
-            .callback = wake_word_led_timer_cb,
-            .name = "wake_word_led",
-        };
-        esp_err_t err = esp_timer_create(&args, &s_wake_word_led_timer);
-        if (err != ESP_OK) {
-            ESP_LOGE(TAG, "Failed to create wake word LED timer (%s)", esp_err_to_name(err));
-            s_wake_word_led_timer = NULL;
-            return;
-        }
-    }
-    esp_timer_start_periodic(s_wake_word_led_timer, 100 * 1000); // Fast blink: 100ms
+    // Fast orange blink: 100 ms on, 100 ms off
+    set_status_effect(WAKE_WORD_LED_INDEX, LED_EFFECT_BLINK, 255, 165, 0, 200);
 }
 
 static void wake_word_led_deactivate(void)
 {
-    if (s_wake_word_led_timer) {
-        esp_timer_stop(s_wake_word_led_timer);
-    }
     set_status_led(WAKE_WORD_LED_INDEX, 0, 0, 0);
 }
 
 static void update_mute_led(void)
 {
-    if (!s_led_controller_handle) {
-        return;
-    }
     if (s_muted) {
         set_status_led(MUTE_LED_INDEX, 80, 0, 0); // Red when muted
     } else {
@@ -359,63 +515,48 @@ static void update_mute_led(void)
     }
 }
 
-static void audio_playback_timer_cb(void *arg)
+// The playback pixel follows the voice stream at the DAC: on when a reply's
+// first frame plays, off when its last has played. A pause between
+// sentences keeps it on while the reply is still open.
+static volatile bool s_voice_sounding;
+
+static void playback_event_cb(audio_player_event_t event, audio_player_stream_t stream, void *ctx)
 {
-    (void)arg;
-    if (!s_led_controller_handle || !s_audio_playing) {
+    (void)ctx;
+    if (stream != AUDIO_PLAYER_STREAM_VOICE) {
         return;
     }
-    // Pulse animation: fade in and out
-    static bool fading_in = true;
-    if (fading_in) {
-        s_audio_playback_brightness += 8;
-        if (s_audio_playback_brightness >= 128) {
-            s_audio_playback_brightness = 128;
-            fading_in = false;
-        }
-    } else {
-        s_audio_playback_brightness -= 8;
-        if (s_audio_playback_brightness == 0) {
-            fading_in = true;
+    if (event == AUDIO_PLAYER_EVENT_STARTED) {
+        s_voice_sounding = true;
+        // Blue pulse, fading in and out every 1.6 s
+        set_status_effect(AUDIO_PLAYBACK_LED_INDEX, LED_EFFECT_BREATHING, 0, 0, 128, 1600);
+    } else if (event == AUDIO_PLAYER_EVENT_DRAINED) {
+        s_voice_sounding = false;
+        if (!s_audio_playing) {
+            set_status_led(AUDIO_PLAYBACK_LED_INDEX, 0, 0, 0);
         }
     }
-    // Blue pulsing LED for audio playback
-    uint8_t blue = s_audio_playback_brightness;
-    set_status_led(AUDIO_PLAYBACK_LED_INDEX, 0, 0, blue);
 }
 
-void audio_playback_led_start(void)
+static void audio_playback_led_start(void)
 {
-    if (!s_led_controller_handle) {
-        return;
-    }
+    power_profile_set_busy(POWER_PROFILE_PLAYBACK, true);
+    radio_coex_set_busy(RADIO_COEX_PLAYBACK, true);
     s_audio_playing = true;
-    s_audio_playback_brightness = 0;
-    if (!s_audio_playback_timer) {
-        const esp_timer_create_args_t args = {
-            .callback = audio_playback_timer_cb,
-            .name = "audio_playback_led",
-        };
-        esp_err_t err = esp_timer_create(&args, &s_audio_playback_timer);
-        if (err != ESP_OK) {
-            ESP_LOGE(TAG, "Failed to create audio playback LED timer (%s)", esp_err_to_name(err));
-            s_audio_playback_timer = NULL;
-            return;
-        }
-    }
-    esp_timer_start_periodic(s_audio_playback_timer, 50 * 1000); // 50ms for smooth animation
 }
 
-void audio_playback_led_stop(void)
+static void audio_playback_led_stop(void)
 {
+    power_profile_set_busy(POWER_PROFILE_PLAYBACK, false);
+    radio_coex_set_busy(RADIO_COEX_PLAYBACK, false);
     s_audio_playing = false;
-    if (s_audio_playback_timer) {
-        esp_timer_stop(s_audio_playback_timer);
+    // A streamed reply can end while its tail still plays; DRAINED clears it then
+    if (!s_voice_sounding) {
+        set_status_led(AUDIO_PLAYBACK_LED_INDEX, 0, 0, 0);
     }
-    set_status_led(AUDIO_PLAYBACK_LED_INDEX, 0, 0, 0);
 }
 
-void aws_led_set_connected(bool connected)
+static void aws_led_apply(bool connected)
 {
     s_aws_connected = connected;
     // Update device state context for Gemini function calling
@@ -434,27 +575,80 @@ void aws_led_set_connected(bool connected)
     }
 }
 
+// somnus_mqtt calls this from its service task; the LEDs change on ours
+void aws_led_set_connected(bool connected)
+{
+    event_bus_publish_state(EVENT_BUS_TOPIC_CLOUD, connected);
+}
+
+// The status task: LED, power and coexistence work the audio loops and the
+// cloud client publish instead of running inline
+static void status_event_cb(const event_bus_event_t *event, void *ctx)
+{
+    (void)ctx;
+    switch (event->topic) {
+        case EVENT_BUS_TOPIC_MIC_LEVELS:
+            update_mic_leds(event->mic_levels.mic[0], event->mic_levels.mic[1], event->mic_levels.mic[2]);
+            break;
+#if CONFIG_KVA_DOA_ENABLE
+        case EVENT_BUS_TOPIC_DIRECTION:
+            update_direction_leds(event->direction.angle_deg, event->direction.confidence, event->direction.active);
+            break;
+#endif
+#if CONFIG_KVA_SPECTRUM_LEDS
+        case EVENT_BUS_TOPIC_SPECTRUM:
+            update_spectrum_leds((audio_spectrum_t *)event->spectrum.analyzer);
+            break;
+#endif
+        case EVENT_BUS_TOPIC_PLAYBACK:
+            if (event->on) {
+                audio_playback_led_start();
+            } else {
+                audio_playback_led_stop();
+            }
+            break;
+        case EVENT_BUS_TOPIC_LIGHTS:
+            if (event->on) {
+                lights_on();
+            } else {
+                lights_off();
+            }
+            break;
+        case EVENT_BUS_TOPIC_CLOUD:
+            aws_led_apply(event->on);
+            break;
+        default:
+            break;
+    }
+}
+
 static void wifi_event_handler(void *arg, esp_event_base_t event_base, int32_t event_id, void *event_data)
 {
     if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_START) {
-        esp_wifi_connect();
+        wifi_fast_connect_on_start();
     } else if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_DISCONNECTED) {
-        if (s_retry_num < 5) {
-            esp_wifi_connect();
-            s_retry_num++;
-            ESP_LOGW(TAG, "Retrying Wi-Fi connection...");
-        } else {
+        // Keeps retrying with backoff; boot only waits for the first few
+        int attempt = wifi_fast_connect_on_disconnect(0);
+        ESP_LOGW(TAG, "Retrying Wi-Fi connection...");
+        if (attempt >= WIFI_BOOT_MAX_RETRY && s_wifi_event_group) {
             xEventGroupSetBits(s_wifi_event_group, WIFI_FAIL_BIT);
         }
     } else if (event_base == IP_EVENT && event_id == IP_EVENT_STA_GOT_IP) {
         ip_event_got_ip_t *event = (ip_event_got_ip_t *)event_data;
         ESP_LOGI(TAG, "IP:" IPSTR, IP2STR(&event->ip_info.ip));
-        s_retry_num = 0;
-        xEventGroupSetBits(s_wifi_event_group, WIFI_CONNECTED_BIT);
+        wifi_fast_connect_on_got_ip();
+        // Resolve the cloud hosts before the first interaction needs them
+        dns_cache_prefetch();
+        // The boot stage waiting on the group deletes it once it is done
+        if (s_wifi_event_group) {
+            xEventGroupSetBits(s_wifi_event_group, WIFI_CONNECTED_BIT);
+        }
     }
 }
 
-static esp_err_t wifi_connect(void)
+// Brings up the netif, the default event loop and the radio; association
+// carries on in the background while other boot stages run
+static esp_err_t wifi_start(void)
 {
     ESP_RETURN_ON_FALSE(strlen(CONFIG_KVA_WIFI_SSID) > 0, ESP_ERR_INVALID_STATE, TAG, "Set Wi-Fi SSID via menuconfig");
     s_wifi_event_group = xEventGroupCreate();
@@ -463,7 +657,8 @@ static esp_err_t wifi_connect(void)
 
     ESP_ERROR_CHECK(esp_netif_init());
     ESP_ERROR_CHECK(esp_event_loop_create_default());
-    esp_netif_create_default_wifi_sta();
+    esp_netif_t *sta_netif = esp_netif_create_default_wifi_sta();
+    ESP_ERROR_CHECK(wifi_fast_connect_apply_static_ip(sta_netif));
 
     wifi_init_config_t cfg = WIFI_INIT_CONFIG_DEFAULT();
     ESP_ERROR_CHECK(esp_wifi_init(&cfg));
@@ -474,12 +669,25 @@ static esp_err_t wifi_connect(void)
     strlcpy((char *)wifi_config.sta.ssid, CONFIG_KVA_WIFI_SSID, sizeof(wifi_config.sta.ssid));
     strlcpy((char *)wifi_config.sta.password, CONFIG_KVA_WIFI_PASSWORD, sizeof(wifi_config.sta.password));
     wifi_config.sta.threshold.authmode = WIFI_AUTH_WPA2_PSK;
+#if CONFIG_KVA_PM_WIFI_POWER_SAVE
+    // Announced on association; only max modem sleep wakes at it
+    wifi_config.sta.listen_interval = CONFIG_KVA_WIFI_LISTEN_INTERVAL;
+#endif
 
     ESP_ERROR_CHECK(esp_wifi_set_mode(WIFI_MODE_STA));
-    ESP_ERROR_CHECK(esp_wifi_set_config(WIFI_IF_STA, &wifi_config));
+    // Adds the BSSID/channel of the last AP when there is one
+    ESP_ERROR_CHECK(wifi_fast_connect_configure(&wifi_config));
     ESP_ERROR_CHECK(esp_wifi_start());
+    // Power save by pipeline state: modem sleep when idle, full power while audio streams
+    radio_coex_wifi_started();
 
     ESP_LOGI(TAG, "Connecting to Wi-Fi SSID=%s", CONFIG_KVA_WIFI_SSID);
+    return ESP_OK;
+}
+
+static esp_err_t wifi_wait_connected(void)
+{
+    ESP_RETURN_ON_FALSE(s_wifi_event_group, ESP_ERR_INVALID_STATE, TAG, "Wi-Fi not started");
     EventBits_t bits = xEventGroupWaitBits(s_wifi_event_group,
                                            WIFI_CONNECTED_BIT | WIFI_FAIL_BIT,
                                            pdFALSE,
@@ -505,10 +713,28 @@ static void wake_word_led_timeout_cb(void *arg)
     wake_word_led_deactivate();
 }
 
+// The wake word LED blinks for 2 s after either wake path fires
+static void wake_word_led_hold(void)
+{
+    static timer_wheel_timer_t *timeout_timer = NULL;
+    if (!timeout_timer) {
+        const timer_wheel_timer_config_t args = {
+            .callback = wake_word_led_timeout_cb,
+            .name = "wake_word_led",
+            .slack_ms = 100,
+        };
+        if (timer_wheel_create(&args, &timeout_timer) != ESP_OK) {
+            return;
+        }
+    }
+    timer_wheel_start_once(timeout_timer, 2000);
+}
+
 // Wake word callback from traditional wake word service (legacy)
 static void wake_word_callback(void *ctx)
 {
     voice_pipeline_handle_t pipeline = (voice_pipeline_handle_t)ctx;
+    occupancy_note(OCCUPANCY_SOURCE_ACTIVITY);
     wake_word_led_activate();
     // Only process wake word if not muted
     if (!s_muted) {
@@ -516,17 +742,7 @@ static void wake_word_callback(void *ctx)
     } else {
         ESP_LOGI(TAG, "Wake word detected but device is muted");
     }
-    // Schedule deactivation after 2 seconds
-    static esp_timer_handle_t timeout_timer = NULL;
-    if (!timeout_timer) {
-        const esp_timer_create_args_t args = {
-            .callback = wake_word_led_timeout_cb,
-            .name = "wake_word_timeout",
-        };
-        esp_timer_create(&args, &timeout_timer);
-    }
-    esp_timer_stop(timeout_timer);
-    esp_timer_start_once(timeout_timer, 2000 * 1000); // 2 seconds
+    wake_word_led_hold();
 }
 
 // WakeNet local control callback (parallel to Gemini streaming)
@@ -536,6 +752,7 @@ static void wakenet_local_control_cb(const char *wake_word, int word_index, void
 {
     voice_pipeline_handle_t pipeline = (voice_pipeline_handle_t)ctx;
     ESP_LOGI(TAG, "WakeNet local control triggered: '%s' (index=%d)", wake_word, word_index);
+    occupancy_note(OCCUPANCY_SOURCE_ACTIVITY);
     
     wake_word_led_activate();
     
@@ -568,26 +785,20 @@ static void wakenet_local_control_cb(const char *wake_word, int word_index, void
         ESP_LOGI(TAG, "WakeNet detected but device is muted");
     }
     
-    // Schedule LED deactivation
-    static esp_timer_handle_t timeout_timer = NULL;
-    if (!timeout_timer) {
-        const esp_timer_create_args_t args = {
-            .callback = wake_word_led_timeout_cb,
-            .name = "wakenet_local_timeout",
-        };
-        esp_timer_create(&args, &timeout_timer);
-    }
-    esp_timer_stop(timeout_timer);
-    esp_timer_start_once(timeout_timer, 2000 * 1000); // 2 seconds
+    wake_word_led_hold();
 }
 
+// Runs in the esp_timer task within microseconds of the press
 static void button_callback(int button_id, void *ctx)
 {
     voice_pipeline_handle_t pipeline = (voice_pipeline_handle_t)ctx;
+    occupancy_note(OCCUPANCY_SOURCE_ACTIVITY);
     // Button 1 toggles mute (if configured)
     if (button_id == 1 && CONFIG_KVA_BUTTON1_GPIO >= 0) {
         s_muted = !s_muted;
         update_mute_led();
+        // Muted, nothing acts on the AFE's output, so it may lag at a lower clock
+        power_profile_set_busy(POWER_PROFILE_LISTEN, CONFIG_KVA_PM_LISTEN_FULL_SPEED && !s_muted);
         ESP_LOGI(TAG, "Mute %s", s_muted ? "enabled" : "disabled");
         // Still process button for voice pipeline if not muted
         if (!s_muted) {
@@ -598,27 +809,77 @@ static void button_callback(int button_id, void *ctx)
     }
 }
 
-void app_main(void)
+// Services brought up by the boot stages below; they live for the whole run
+static korvo_audio_t s_audio;
+static led_controller_t s_leds;
+static intent_router_t s_router;
+static spotify_client_t s_spotify;
+static aws_iot_bridge_t s_aws_bridge;
+static voice_pipeline_handle_t s_pipeline;
+static wake_word_service_t *s_wake_service;
+static button_service_t *s_button_service;
+
+// Sampling, AFE and LED profiles follow the room; on the timer_wheel task
+static void occupancy_profile_cb(occupancy_state_t state, void *ctx)
 {
-    ESP_LOGI(TAG, "========================================");
-    ESP_LOGI(TAG, "Naphome Voice Assistant Starting");
-    ESP_LOGI(TAG, "ESP-IDF Version: %s", esp_get_idf_version());
-    ESP_LOGI(TAG, "Firmware Version: %s", FIRMWARE_VERSION);
-    ESP_LOGI(TAG, "Git Commit: %s", GIT_COMMIT_HASH);
-    ESP_LOGI(TAG, "Git Date: %s", GIT_COMMIT_DATE);
-    ESP_LOGI(TAG, "Build Time: %s", BUILD_TIMESTAMP);
-    ESP_LOGI(TAG, "Free heap: %u bytes", (unsigned int)esp_get_free_heap_size());
-    ESP_LOGI(TAG, "========================================\n");
-    
-    // Register shutdown handler for crash reporting
-    esp_register_shutdown_handler(shutdown_handler);
-    
-    ESP_ERROR_CHECK(nvs_flash_init());
-    ESP_LOGI(TAG, "NVS initialized");
-    
-    korvo_audio_t audio = {0};
-    ESP_ERROR_CHECK(korvo_audio_init(&audio, CONFIG_KVA_SAMPLE_RATE));
+    (void)ctx;
+    bool idle = state != OCCUPANCY_PRESENT;
+    sensor_manager_set_publish_interval(state == OCCUPANCY_EMPTY    ? feature_flag_int(FEATURE_FLAG_EMPTY_SENSOR_MS)
+                                        : state == OCCUPANCY_ASLEEP ? feature_flag_int(FEATURE_FLAG_ASLEEP_SENSOR_MS)
+                                                                    : 0);
+    if (s_pipeline) {
+        voice_pipeline_set_afe_low_cost(s_pipeline, idle);
+    }
+    if (s_led_controller_handle) {
+        led_effects_set_frame_ms(s_led_controller_handle->effects, idle ? feature_flag_int(FEATURE_FLAG_IDLE_LED_MS) : 0);
+    }
+}
+
+// A flag behind the occupancy profile changed: apply it to the room as it is now
+static void occupancy_flag_cb(feature_flag_t flag, void *ctx)
+{
+    (void)flag;
+    occupancy_profile_cb(occupancy_get(), ctx);
+}
 
+// Boot graph, in boot_sequence.h terms. Each stage names what it has to
+// come after; everything else overlaps. The voice pipeline deliberately
+// does not wait for Wi-Fi, so wake words are heard while the radio is
+// still associating.
+typedef enum {
+    STAGE_AUDIO = 0,                  // I2S capture
+    STAGE_CODEC,                      // ES8388 and the playback path
+    STAGE_LEDS,
+    STAGE_WIFI_START,                 // netif, event loop, radio on
+    STAGE_WIFI,                       // Associated and addressed
+    STAGE_ROUTER,
+    STAGE_SPOTIFY,
+    STAGE_CSPOT,                      // Reads stored credentials, then waits for the network itself
+    STAGE_AWS,
+    STAGE_MQTT,
+    STAGE_MATTER,
+    STAGE_SENSORS,                    // I2C probing of the sensor bus
+    STAGE_SENSOR_PUBLISH,
+    STAGE_AUDIO_BUS_SCAN,
+    STAGE_PIPELINE,                   // AFE and WakeNet models, wake word, buttons
+    STAGE_SERIAL,
+    STAGE_COUNT,
+} boot_stage_id_t;
+
+static esp_err_t boot_audio(void)
+{
+    ESP_ERROR_CHECK(korvo_audio_init(&s_audio, CONFIG_KVA_SAMPLE_RATE));
+    // Before the pipeline and the wake word service attach their nodes
+    ESP_ERROR_CHECK(audio_graph_init(&s_audio));
+    ESP_ERROR_CHECK(audio_taps_start());
+#if CONFIG_KVA_BENCH_MODE
+    ESP_ERROR_CHECK(bench_mode_init(&s_audio));
+#endif
+    return ESP_OK;
+}
+
+static esp_err_t boot_codec(void)
+{
     audio_player_config_t audio_cfg = {
         .i2s_port = CONFIG_KVA_CODEC_I2S_PORT,
         .bclk_gpio = CONFIG_KVA_CODEC_I2S_BCLK,
@@ -627,277 +888,398 @@ void app_main(void)
         .mclk_gpio = CONFIG_KVA_CODEC_I2S_MCLK,
         .i2c_scl_gpio = CONFIG_KVA_CODEC_I2C_SCL,
         .i2c_sda_gpio = CONFIG_KVA_CODEC_I2C_SDA,
-        .default_sample_rate = 44100,
+        .default_sample_rate = CONFIG_KVA_CODEC_SAMPLE_RATE,
+        .loopback_rate_hz = CONFIG_KVA_SAMPLE_RATE,
     };
-    if (CONFIG_KVA_CODEC_I2S_BCLK >= 0 &&
-        CONFIG_KVA_CODEC_I2S_LRCLK >= 0 &&
-        CONFIG_KVA_CODEC_I2S_DATA >= 0) {
-        esp_err_t audio_init_err = audio_player_init(&audio_cfg);
-        if (audio_init_err != ESP_OK) {
-            ESP_LOGW(TAG, "Audio player init failed (%s)", esp_err_to_name(audio_init_err));
-        }
-    } else {
+    if (CONFIG_KVA_CODEC_I2S_BCLK < 0 ||
+        CONFIG_KVA_CODEC_I2S_LRCLK < 0 ||
+        CONFIG_KVA_CODEC_I2S_DATA < 0) {
         ESP_LOGW(TAG, "Audio player disabled (missing codec pin config)");
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    audio_player_add_event_cb(playback_event_cb, NULL);
+    esp_err_t audio_init_err = audio_player_init(&audio_cfg);
+    if (audio_init_err != ESP_OK) {
+        ESP_LOGW(TAG, "Audio player init failed (%s)", esp_err_to_name(audio_init_err));
+        return audio_init_err;
+    }
+    esp_err_t bank_err = sound_bank_init();
+    if (bank_err != ESP_OK && bank_err != ESP_ERR_NOT_FOUND) {
+        ESP_LOGW(TAG, "Sound bank unavailable (%s)", esp_err_to_name(bank_err));
+    }
+#if CONFIG_KVA_TTS_CACHE
+    esp_err_t cache_err = tts_cache_init();
+    if (cache_err != ESP_OK && cache_err != ESP_ERR_NOT_FOUND) {
+        ESP_LOGW(TAG, "TTS cache unavailable (%s)", esp_err_to_name(cache_err));
     }
+#endif
+    return ESP_OK;
+}
 
-    led_controller_t leds = {0};
-    led_controller_t *led_handle = NULL;
-    if (CONFIG_KVA_LED_COUNT > 0 && CONFIG_KVA_LED_STRIP_GPIO >= 0) {
-        led_controller_config_t led_cfg = {
-            .data_gpio = CONFIG_KVA_LED_STRIP_GPIO,
-            .led_count = CONFIG_KVA_LED_COUNT,
-            .brightness = CONFIG_KVA_LED_BRIGHTNESS,
-            .reserved_pixels = STATUS_LED_COUNT,
-        };
-        if (led_controller_init(&leds, &led_cfg) == ESP_OK) {
-            led_handle = &leds;
-            s_led_controller_handle = led_handle;
-            ESP_LOGI(TAG, "LED controller initialized: GPIO%d, %d pixels, brightness=%d", 
-                     CONFIG_KVA_LED_STRIP_GPIO, CONFIG_KVA_LED_COUNT, CONFIG_KVA_LED_BRIGHTNESS);
-            // Ensure lights are enabled
-            s_lights_enabled = true;
-            // Initialize all status LEDs - make them clearly visible at boot
-            // Wi-Fi LED will be set by wifi_led_set_mode, but show it's ready with visible cyan
-            // Status LEDs will be animated by trippy fade, no need to set them individually
-            ESP_LOGI(TAG, "LEDs enabled and initialized - trippy fade will animate all LEDs");
-            
-            // Initialize device state context for Gemini function calling
-            device_state_set_context(s_led_controller_handle, s_lights_enabled, s_aws_connected, s_muted, s_audio_playing);
-            ESP_LOGI(TAG, "Device state context initialized for Gemini function calling");
-            
-            // Start trippy fade animation timer
-            const esp_timer_create_args_t trippy_timer_args = {
-                .callback = trippy_fade_timer_cb,
-                .name = "trippy_fade",
-            };
-            esp_err_t trippy_timer_err = esp_timer_create(&trippy_timer_args, &s_trippy_fade_timer);
-            if (trippy_timer_err == ESP_OK) {
-                // Start the trippy fade animation
-                led_controller_start_trippy_fade(s_led_controller_handle);
-                // Update animation every 50ms for smooth 20fps animation
-                esp_timer_start_periodic(s_trippy_fade_timer, 50 * 1000);
-                ESP_LOGI(TAG, "Trippy fade animation started!");
-            } else {
-                ESP_LOGW(TAG, "Failed to create trippy fade timer: %s", esp_err_to_name(trippy_timer_err));
-            }
-        } else {
-            ESP_LOGE(TAG, "LED controller init failed on GPIO%d", CONFIG_KVA_LED_STRIP_GPIO);
-        }
+static esp_err_t boot_leds(void)
+{
+    if (CONFIG_KVA_LED_COUNT <= 0 || CONFIG_KVA_LED_STRIP_GPIO < 0) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    led_controller_config_t led_cfg = {
+        .data_gpio = CONFIG_KVA_LED_STRIP_GPIO,
+        .led_count = CONFIG_KVA_LED_COUNT,
+        .brightness = CONFIG_KVA_LED_BRIGHTNESS,
+        .reserved_pixels = STATUS_LED_COUNT,
+    };
+    esp_err_t err = led_controller_init(&s_leds, &led_cfg);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "LED controller init failed on GPIO%d", CONFIG_KVA_LED_STRIP_GPIO);
+        return err;
     }
+    s_led_controller_handle = &s_leds;
+    ESP_LOGI(TAG, "LED controller initialized: GPIO%d, %d pixels, brightness=%d", 
+             CONFIG_KVA_LED_STRIP_GPIO, CONFIG_KVA_LED_COUNT, CONFIG_KVA_LED_BRIGHTNESS);
+    // Ensure lights are enabled
+    s_lights_enabled = true;
+    // Status LEDs will be animated by trippy fade, no need to set them individually
+    ESP_LOGI(TAG, "LEDs enabled and initialized - trippy fade will animate all LEDs");
+    
+    // Initialize device state context for Gemini function calling
+    device_state_set_context(s_led_controller_handle, s_lights_enabled, s_aws_connected, s_muted, s_audio_playing);
+    ESP_LOGI(TAG, "Device state context initialized for Gemini function calling");
+    
+    // The LED effects task animates the fade at CONFIG_KVA_LED_FRAME_MS
+    led_controller_start_trippy_fade(s_led_controller_handle);
+    mic_led_overlays_init();
+    spectrum_led_layer_init();
+    direction_led_layer_init();
+    return ESP_OK;
+}
 
-    // Connect to WiFi and log status
+static esp_err_t boot_wifi_start(void)
+{
     ESP_LOGI(TAG, "Initiating WiFi connection...");
-    esp_err_t wifi_ret = wifi_connect();
-    if (wifi_ret == ESP_OK) {
-        ESP_LOGI(TAG, "WiFi connection initiated");
-    } else {
+    esp_err_t wifi_ret = wifi_start();
+    if (wifi_ret != ESP_OK) {
+        ESP_LOGE(TAG, "WiFi start failed: %s", esp_err_to_name(wifi_ret));
+        return wifi_ret;
+    }
+    esp_err_t arbiter_err = wake_arbiter_init();
+    if (arbiter_err != ESP_OK && arbiter_err != ESP_ERR_NOT_SUPPORTED) {
+        ESP_LOGW(TAG, "Wake arbitration off, every unit answers (%s)", esp_err_to_name(arbiter_err));
+    }
+    return ESP_OK;
+}
+
+static esp_err_t boot_wifi(void)
+{
+    esp_err_t wifi_ret = wifi_wait_connected();
+    if (wifi_ret != ESP_OK) {
         ESP_LOGE(TAG, "WiFi connection failed: %s", esp_err_to_name(wifi_ret));
     }
+    return wifi_ret;
+}
 
-    intent_router_t router = {0};
+static esp_err_t boot_router(void)
+{
     intent_router_config_t router_cfg = {
         .default_volume_step = CONFIG_KVA_SPOTIFY_VOLUME_STEP,
+        .phrase_path = CONFIG_KVA_INTENT_PHRASES_PATH,
     };
-    ESP_ERROR_CHECK(intent_router_init(&router, &router_cfg));
+    ESP_ERROR_CHECK(intent_router_init(&s_router, &router_cfg));
+    return ESP_OK;
+}
 
-    spotify_client_t spotify = {0};
+static esp_err_t boot_spotify(void)
+{
     spotify_client_config_t spotify_cfg = {
         .device_name = CONFIG_KVA_SPOTIFY_DEVICE_NAME,
         .volume_step = CONFIG_KVA_SPOTIFY_VOLUME_STEP,
     };
     set_status_led(SPOTIFY_LED_INDEX, 80, 40, 0); // amber while starting
-    esp_err_t spotify_init_err = spotify_client_init(&spotify, &spotify_cfg);
+    esp_err_t spotify_init_err = spotify_client_init(&s_spotify, &spotify_cfg);
     if (spotify_init_err != ESP_OK) {
         set_status_led(SPOTIFY_LED_INDEX, 80, 0, 0);
         ESP_LOGE(TAG, "Spotify client init failed (%s)", esp_err_to_name(spotify_init_err));
     } else {
         set_status_led(SPOTIFY_LED_INDEX, 0, 80, 0);
     }
+    return spotify_init_err;
+}
 
+static esp_err_t boot_cspot(void)
+{
 #if CONFIG_KVA_SPOTIFY_USE_CSPOT
-    ESP_LOGI(TAG, "========================================");
-    ESP_LOGI(TAG, "cspot ENABLED - Starting Spotify Connect player...");
-    ESP_LOGI(TAG, "Device name: %s", CONFIG_KVA_SPOTIFY_DEVICE_NAME);
-    ESP_LOGI(TAG, "========================================");
+    ESP_LOGI(TAG, "cspot ENABLED - Starting Spotify Connect player (device: %s)", CONFIG_KVA_SPOTIFY_DEVICE_NAME);
     spotify_player_config_t cspot_cfg = {
         .device_name = CONFIG_KVA_SPOTIFY_DEVICE_NAME,
-        .credentials_path = "/spiffs/spotify_blob.json",
+        .credentials_path = STORAGE_PATH("spotify_blob.json"),
         .zeroconf_port = 8080,
+        .wait_for_network = true,
+        .idle_stop_ms = CONFIG_KVA_SPOTIFY_IDLE_STOP_MIN * 60U * 1000U,
     };
-    esp_err_t cspot_err = spotify_player_start(&cspot_cfg);
+    esp_err_t cspot_err = spotify_player_configure(&cspot_cfg);
+#if CONFIG_KVA_SPOTIFY_LAZY_START
+    if (cspot_err == ESP_OK && !(CONFIG_KVA_SPOTIFY_RESUME_AT_BOOT && spotify_player_has_credentials())) {
+        ESP_LOGI(TAG, "Spotify Connect starts on the first play request");
+        return ESP_OK;
+    }
+    if (cspot_err == ESP_OK) {
+        // Paired: resume the session in the background while Wi-Fi comes up
+        cspot_err = spotify_player_ensure_started();
+    }
+#else
+    if (cspot_err == ESP_OK) {
+        cspot_err = spotify_player_ensure_started();
+    }
+#endif
     if (cspot_err != ESP_OK) {
         ESP_LOGE(TAG, "❌ Spotify Connect player failed to start: %s", esp_err_to_name(cspot_err));
     } else {
         ESP_LOGI(TAG, "✅ Spotify Connect player started successfully (device: %s)", CONFIG_KVA_SPOTIFY_DEVICE_NAME);
     }
+    return cspot_err;
 #else
-    ESP_LOGW(TAG, "========================================");
-    ESP_LOGW(TAG, "⚠️  Spotify Connect (cspot) is DISABLED in configuration");
-    ESP_LOGW(TAG, "Set CONFIG_KVA_SPOTIFY_USE_CSPOT=y to enable");
-    ESP_LOGW(TAG, "========================================");
+    ESP_LOGW(TAG, "⚠️  Spotify Connect (cspot) is DISABLED; set CONFIG_KVA_SPOTIFY_USE_CSPOT=y to enable");
+    return ESP_ERR_NOT_SUPPORTED;
 #endif
+}
 
-    // Initialize AWS IoT bridge and MQTT service
-    aws_iot_bridge_t aws_bridge = {0};
+static esp_err_t boot_aws(void)
+{
     aws_iot_bridge_config_t aws_cfg = {
         .telemetry_period_ms = CONFIG_KVA_AWS_TELEMETRY_PERIOD_MS,
     };
     set_status_led(AWS_LED_INDEX, 80, 40, 0); // amber while initializing
-    esp_err_t aws_err = aws_iot_bridge_init(&aws_bridge, &aws_cfg);
+    esp_err_t aws_err = aws_iot_bridge_init(&s_aws_bridge, &aws_cfg);
     if (aws_err != ESP_OK) {
         set_status_led(AWS_LED_INDEX, 80, 0, 0);
         ESP_LOGE(TAG, "AWS IoT bridge init failed (%s)", esp_err_to_name(aws_err));
-        aws_bridge = (aws_iot_bridge_t){0}; // Zero out on failure
+        s_aws_bridge = (aws_iot_bridge_t){0}; // Zero out on failure
     } else {
         ESP_LOGI(TAG, "AWS IoT bridge initialized");
-        // Start Somnus MQTT service (handles AWS IoT connection)
-        esp_err_t mqtt_err = somnus_mqtt_start(NULL);
-        if (mqtt_err != ESP_OK) {
-            set_status_led(AWS_LED_INDEX, 80, 0, 0);
-            ESP_LOGW(TAG, "Somnus MQTT start failed (%s); telemetry publish disabled", esp_err_to_name(mqtt_err));
-        } else {
-            ESP_LOGI(TAG, "Somnus MQTT service started - AWS IoT connection in progress");
-            // LED will be updated by connection callback when connected
-            set_status_led(AWS_LED_INDEX, 80, 40, 0); // Keep amber until connected
+    }
+    return aws_err;
+}
+
+static esp_err_t boot_mqtt(void)
+{
+    if (boot_sequence_state("aws") != BOOT_STAGE_READY) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    // Start Somnus MQTT service (handles AWS IoT connection)
+    esp_err_t mqtt_err = somnus_mqtt_start(NULL);
+    if (mqtt_err != ESP_OK) {
+        set_status_led(AWS_LED_INDEX, 80, 0, 0);
+        ESP_LOGW(TAG, "Somnus MQTT start failed (%s); telemetry publish disabled", esp_err_to_name(mqtt_err));
+    } else {
+        ESP_LOGI(TAG, "Somnus MQTT service started - AWS IoT connection in progress");
+        // LED will be updated by connection callback when connected
+        set_status_led(AWS_LED_INDEX, 80, 40, 0); // Keep amber until connected
+#if CONFIG_KVA_DEVICE_SHADOW
+        esp_err_t shadow_err = device_shadow_start();
+        if (shadow_err != ESP_OK) {
+            ESP_LOGW(TAG, "Device shadow sync not started (%s)", esp_err_to_name(shadow_err));
         }
+#endif
     }
+    return mqtt_err;
+}
 
-    // Initialize Matter bridge for sensor telemetry and device control
+// Matter bridge for sensor telemetry and device control
+static esp_err_t boot_matter(void)
+{
 #if CONFIG_NAPHOME_MATTER_BRIDGE_ENABLE
     matter_bridge_config_t matter_cfg = {
         .enable_matter_console = false,
     };
     esp_err_t matter_init_err = matter_bridge_init(&matter_cfg);
-    if (matter_init_err == ESP_OK) {
-        matter_bridge_start();
-        ESP_LOGI(TAG, "Matter bridge initialized");
-        
-        // Register sensors with Matter bridge
-        matter_bridge_sensor_registration_t env_reg = {
-            .sensor_name = "sht45",
-            .sensor_kind = MATTER_BRIDGE_SENSOR_KIND_ENVIRONMENT,
-            .endpoint_label = "Environment",
-        };
-        matter_bridge_register_sensor(&env_reg);
-        
-        matter_bridge_sensor_registration_t iaq_reg = {
-            .sensor_name = "scd40",
-            .sensor_kind = MATTER_BRIDGE_SENSOR_KIND_IAQ,
-            .endpoint_label = "Air Quality",
-        };
-        matter_bridge_register_sensor(&iaq_reg);
-        
-        matter_bridge_sensor_registration_t voc_reg = {
-            .sensor_name = "sgp40",
-            .sensor_kind = MATTER_BRIDGE_SENSOR_KIND_IAQ,
-            .endpoint_label = "VOC Sensor",
-        };
-        matter_bridge_register_sensor(&voc_reg);
-        
-        matter_bridge_sensor_registration_t light_reg = {
-            .sensor_name = "vcnl4040",
-            .sensor_kind = MATTER_BRIDGE_SENSOR_KIND_LIGHT,
-            .endpoint_label = "Ambient Light",
-        };
-        matter_bridge_register_sensor(&light_reg);
-        
-        matter_bridge_sensor_registration_t pm_reg = {
-            .sensor_name = "ec10",
-            .sensor_kind = MATTER_BRIDGE_SENSOR_KIND_PM,
-            .endpoint_label = "Particulate Matter",
-        };
-        matter_bridge_register_sensor(&pm_reg);
-        
-        // Register Spotify device for Matter control
-        matter_bridge_device_registration_t spotify_reg = {
-            .device_kind = MATTER_BRIDGE_DEVICE_KIND_SPOTIFY,
-            .endpoint_label = "Spotify Player",
-            .device_handle = &spotify,
-        };
-        matter_bridge_register_device(&spotify_reg);
-        ESP_LOGI(TAG, "Matter bridge: Sensors and Spotify device registered");
-    } else {
+    if (matter_init_err != ESP_OK) {
         ESP_LOGW(TAG, "Matter bridge init failed (%s)", esp_err_to_name(matter_init_err));
+        return matter_init_err;
     }
+    matter_bridge_start();
+    ESP_LOGI(TAG, "Matter bridge initialized");
+    
+    // Register sensors with Matter bridge
+    matter_bridge_sensor_registration_t env_reg = {
+        .sensor_name = "sht45",
+        .sensor_kind = MATTER_BRIDGE_SENSOR_KIND_ENVIRONMENT,
+        .endpoint_label = "Environment",
+    };
+    matter_bridge_register_sensor(&env_reg);
+    
+    matter_bridge_sensor_registration_t iaq_reg = {
+        .sensor_name = "scd40",
+        .sensor_kind = MATTER_BRIDGE_SENSOR_KIND_IAQ,
+        .endpoint_label = "Air Quality",
+    };
+    matter_bridge_register_sensor(&iaq_reg);
+    
+    matter_bridge_sensor_registration_t voc_reg = {
+        .sensor_name = "sgp40",
+        .sensor_kind = MATTER_BRIDGE_SENSOR_KIND_IAQ,
+        .endpoint_label = "VOC Sensor",
+    };
+    matter_bridge_register_sensor(&voc_reg);
+    
+    matter_bridge_sensor_registration_t light_reg = {
+        .sensor_name = "vcnl4040",
+        .sensor_kind = MATTER_BRIDGE_SENSOR_KIND_LIGHT,
+        .endpoint_label = "Ambient Light",
+    };
+    matter_bridge_register_sensor(&light_reg);
+    
+    matter_bridge_sensor_registration_t pm_reg = {
+        .sensor_name = "ec10",
+        .sensor_kind = MATTER_BRIDGE_SENSOR_KIND_PM,
+        .endpoint_label = "Particulate Matter",
+    };
+    matter_bridge_register_sensor(&pm_reg);
+    
+    // Register Spotify device for Matter control
+    matter_bridge_device_registration_t spotify_reg = {
+        .device_kind = MATTER_BRIDGE_DEVICE_KIND_SPOTIFY,
+        .endpoint_label = "Spotify Player",
+        .device_handle = &s_spotify,
+    };
+    matter_bridge_register_device(&spotify_reg);
+    ESP_LOGI(TAG, "Matter bridge: Sensors and Spotify device registered");
+    return ESP_OK;
+#else
+    return ESP_ERR_NOT_SUPPORTED;
 #endif
+}
 
-    // Initialize sensor integration (samples all sensors at 1Hz)
-    // This creates the I2C bus on GPIO 44/43 (RXD/TXD)
+// Sensor integration (samples all sensors at 1Hz). This creates the I2C
+// bus on GPIO 44/43 (RXD/TXD) and probes every sensor on it.
+static esp_err_t boot_sensors(void)
+{
     ESP_LOGI(TAG, "Initializing sensor integration...");
     esp_err_t sensor_init_err = sensor_integration_init();
-    if (sensor_init_err == ESP_OK) {
-        ESP_LOGI(TAG, "Sensor integration initialized successfully");
-        
-        // Now scan the I2C bus after it's been created
-        ESP_LOGI(TAG, "\n=== Scanning Sensor Bus (after init) ===");
-        // Note: We can't easily scan here without access to the bus handle
-        // The scan will happen during sensor initialization internally
-        
-        // Register sensor_manager observer for Matter bridge
+    if (sensor_init_err != ESP_OK) {
+        ESP_LOGE(TAG, "Sensor integration init failed (%s) - system may be unstable", esp_err_to_name(sensor_init_err));
+        ESP_LOGE(TAG, "Free heap: %u bytes", (unsigned int)esp_get_free_heap_size());
+        return sensor_init_err;
+    }
+    ESP_LOGI(TAG, "Sensor integration initialized successfully");
+    
+#if CONFIG_KVA_LED_AUTO_DIM
+    if (s_led_controller_handle) {
+        const timer_wheel_timer_config_t wake_timer_args = {
+            .callback = led_wake_timer_cb,
+            .name = "led_wake",
+            .slack_ms = 100,
+        };
+        if (timer_wheel_create(&wake_timer_args, &s_led_wake_timer) != ESP_OK) {
+            s_led_wake_timer = NULL;
+        }
+        const control_coalescer_config_t dim_cfg = {
+            .name = "led_dim",
+            .apply = led_dim_apply_cb,
+            .initial = CONFIG_KVA_LED_BRIGHTNESS,
+            .smoothing_ms = CONFIG_KVA_CONTROL_SMOOTHING_MS,
+        };
+        if (control_coalescer_create(&dim_cfg, &s_led_dim) != ESP_OK) {
+            s_led_dim = NULL;
+        }
+    }
+#endif
+    sensor_integration_set_event_cb(sensor_event_cb, NULL);
+
+    // Register sensor_manager observer for Matter bridge
 #if CONFIG_NAPHOME_MATTER_BRIDGE_ENABLE
+    if (boot_sequence_state("matter") == BOOT_STAGE_READY) {
         sensor_manager_set_observer(matter_bridge_sensor_observer, NULL);
         ESP_LOGI(TAG, "Matter bridge registered as sensor_manager observer");
+    }
 #endif
+    device_state_add_sleep_listener(night_sleep_cb, NULL);
+#if CONFIG_KVA_OCCUPANCY
+    if (occupancy_init(occupancy_profile_cb, NULL) != ESP_OK) {
+        ESP_LOGW(TAG, "Occupancy profiles unavailable; sampling stays at full rate");
+    } else {
+        feature_flags_subscribe(FEATURE_FLAG_EMPTY_SENSOR_MS, occupancy_flag_cb, NULL);
+        feature_flags_subscribe(FEATURE_FLAG_ASLEEP_SENSOR_MS, occupancy_flag_cb, NULL);
+        feature_flags_subscribe(FEATURE_FLAG_IDLE_LED_MS, occupancy_flag_cb, NULL);
+    }
+#endif
+    return ESP_OK;
+}
+
+static esp_err_t boot_sensor_publish(void)
+{
+    if (boot_sequence_state("sensors") != BOOT_STAGE_READY) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    // Wait for MQTT connection before starting sensor publishing
+    // This prevents race condition where sensor_manager tries to publish before MQTT is connected
+    if (boot_sequence_state("mqtt") == BOOT_STAGE_READY) {
+        ESP_LOGI(TAG, "Waiting for MQTT connection before starting sensor publishing...");
+        aws_iot_client_t *client = NULL;
+        int wait_count = 0;
+        const int max_wait_seconds = 30; // Wait up to 30 seconds
         
-        // Wait for MQTT connection before starting sensor publishing
-        // This prevents race condition where sensor_manager tries to publish before MQTT is connected
-        if (mqtt_err == ESP_OK) {
-            ESP_LOGI(TAG, "Waiting for MQTT connection before starting sensor publishing...");
-            aws_iot_client_t *client = NULL;
-            int wait_count = 0;
-            const int max_wait_seconds = 30; // Wait up to 30 seconds
-            
-            while (wait_count < max_wait_seconds * 10) { // Check every 100ms
-                client = aws_iot_service_get_client();
-                if (client && aws_iot_client_is_connected(client)) {
-                    ESP_LOGI(TAG, "MQTT connected, starting sensor publishing");
-                    break;
-                }
-                vTaskDelay(pdMS_TO_TICKS(100));
-                wait_count++;
-            }
-            
-            if (wait_count >= max_wait_seconds * 10) {
-                ESP_LOGW(TAG, "MQTT connection timeout after %d seconds, starting sensors anyway (will retry on publish)", max_wait_seconds);
+        while (wait_count < max_wait_seconds * 10) { // Check every 100ms
+            client = aws_iot_service_get_client();
+            if (client && aws_iot_client_is_connected(client)) {
+                ESP_LOGI(TAG, "MQTT connected, starting sensor publishing");
+                break;
             }
+            vTaskDelay(pdMS_TO_TICKS(100));
+            wait_count++;
         }
         
-        // Start sensor integration (begins 1Hz sampling)
-        esp_err_t sensor_start_err = sensor_integration_start();
-        if (sensor_start_err == ESP_OK) {
-            ESP_LOGI(TAG, "Sensor integration started (1Hz sampling)");
-        } else {
-            ESP_LOGE(TAG, "Sensor integration start failed (%s)", esp_err_to_name(sensor_start_err));
+        if (wait_count >= max_wait_seconds * 10) {
+            ESP_LOGW(TAG, "MQTT connection timeout after %d seconds, starting sensors anyway (will retry on publish)", max_wait_seconds);
         }
-    } else {
-        ESP_LOGE(TAG, "Sensor integration init failed (%s) - system may be unstable", esp_err_to_name(sensor_init_err));
-        ESP_LOGE(TAG, "Free heap: %u bytes", (unsigned int)esp_get_free_heap_size());
     }
     
-    // Scan Audio Bus separately (I2C_NUM_1 on GPIO 1/2) - this is safe as it's a different port
-    if (CONFIG_KVA_CODEC_I2C_SDA >= 0 && CONFIG_KVA_CODEC_I2C_SCL >= 0) {
-        ESP_LOGI(TAG, "\n=== Scanning Audio Bus (I2C_NUM_1) ===");
-        scan_i2c_bus(I2C_NUM_1, CONFIG_KVA_CODEC_I2C_SDA, CONFIG_KVA_CODEC_I2C_SCL, "Audio Bus");
-    }
-
-    // Enable Gemini AI streaming with AFE pipeline: I2S -> AEC -> BSS/NS -> VAD -> Gemini Batch STT -> Gemini LLM -> Gemini TTS
-    // Enable WakeNet9l in parallel for local control
-    voice_pipeline_config_t pipeline_cfg = {
-        .use_gemini = true,  // Use Gemini AI exclusively
-        .audio = &audio,
-        .router = &router,
-        .spotify = &spotify,
-        .aws_bridge = (aws_bridge.metrics_mutex != NULL) ? &aws_bridge : NULL, // AWS IoT bridge if initialized
-        .leds = led_handle,
-        .sample_rate_hz = CONFIG_KVA_SAMPLE_RATE,
-        .capture_ms = CONFIG_KVA_CAPTURE_MS,
-        .tts_voice = CONFIG_KVA_TTS_VOICE,
-        .use_realtime_streaming = false,  // Gemini batch capture mode (no continuous streaming)
-        .skip_wake_word = true,           // Skip traditional wake word service
-        .enable_wakenet_local = true,     // Enable WakeNet9l in parallel for local control
-        .wakenet_model = "wn9_hiesp",     // WakeNet9l model: "hi esp"
-        .wakenet_threshold = 60,           // Detection threshold (0-100)
-    };
+    // Start sensor integration (begins 1Hz sampling)
+    esp_err_t sensor_start_err = sensor_integration_start();
+    if (sensor_start_err == ESP_OK) {
+        ESP_LOGI(TAG, "Sensor integration started (1Hz sampling)");
+    } else {
+        ESP_LOGE(TAG, "Sensor integration start failed (%s)", esp_err_to_name(sensor_start_err));
+    }
+    return sensor_start_err;
+}
+
+// Audio bus scan (I2C_NUM_1 on GPIO 1/2); a different port from the sensor bus
+static esp_err_t boot_audio_bus_scan(void)
+{
+    if (CONFIG_KVA_CODEC_I2C_SDA < 0 || CONFIG_KVA_CODEC_I2C_SCL < 0) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    ESP_LOGI(TAG, "\n=== Scanning Audio Bus (I2C_NUM_1) ===");
+    scan_i2c_bus(I2C_NUM_1, CONFIG_KVA_CODEC_I2C_SDA, CONFIG_KVA_CODEC_I2C_SCL, "Audio Bus");
+    return ESP_OK;
+}
+
+// Gemini AI streaming with AFE pipeline: I2S -> AEC -> BSS/NS -> VAD -> Gemini Batch STT -> Gemini LLM -> Gemini TTS
+// WakeNet9l runs in parallel for local control
+static const voice_pipeline_config_t s_pipeline_cfg = {
+    .use_gemini = true,  // Use Gemini AI exclusively
+    .audio = &s_audio,
+    .router = &s_router,
+    .spotify = &s_spotify,
+    .leds = NULL,                     // Filled in by boot_pipeline once LEDs are up
+    .sample_rate_hz = CONFIG_KVA_SAMPLE_RATE,
+    .capture_ms = CONFIG_KVA_CAPTURE_MS,
+    .follow_up_ms = CONFIG_KVA_FOLLOW_UP_MS,
+    .tts_voice = CONFIG_KVA_TTS_VOICE,
+    .pipelined_tts = CONFIG_KVA_PIPELINED_TTS,  // Overlap LLM streaming, TTS and playback per sentence
+    .uplink_codec = CONFIG_KVA_UPLINK_CODEC,    // mu-law STT uploads by default
+    .openai_speech = CONFIG_KVA_OPENAI_SPEECH,  // Spoken replies straight from OpenAI Realtime
+    .use_realtime_streaming = false,  // Gemini batch capture mode (no continuous streaming)
+    .skip_wake_word = true,           // Skip traditional wake word service
+    .enable_wakenet_local = true,     // Enable WakeNet9l in parallel for local control
+    .wakenet_model = "wn9_hiesp",     // WakeNet9l model: "hi esp"
+    .wakenet_threshold = 60,           // Detection threshold (0-100)
+    .enable_local_commands = CONFIG_KVA_LOCAL_COMMANDS,  // "lights off", "pause music"... without the cloud
+};
+
+static esp_err_t boot_pipeline(void)
+{
+    voice_pipeline_config_t pipeline_cfg = s_pipeline_cfg;
+    pipeline_cfg.aws_bridge = s_aws_bridge.ready ? &s_aws_bridge : NULL; // AWS IoT bridge if initialized
+    pipeline_cfg.leds = s_led_controller_handle;
     ESP_LOGI(TAG, "═══════════════════════════════════════════════════════════");
     ESP_LOGI(TAG, "=== GEMINI STT-LLM-TTS WITH FUNCTION CALLING ENABLED ===");
     ESP_LOGI(TAG, "═══════════════════════════════════════════════════════════");
@@ -906,38 +1288,52 @@ void app_main(void)
     ESP_LOGI(TAG, "Gemini can now control: LEDs, Audio, and query: Health, Sensors, Temperature");
     ESP_LOGI(TAG, "═══════════════════════════════════════════════════════════");
     
-    voice_pipeline_handle_t pipeline = voice_pipeline_create(&pipeline_cfg);
-    if (!pipeline) {
+    // Keeps per-interaction allocations out of the long-lived heap; falls back to it if PSRAM is short
+    interaction_arena_init(CONFIG_KVA_INTERACTION_ARENA_KB * 1024);
+    
+    s_pipeline = voice_pipeline_create(&pipeline_cfg);
+    if (!s_pipeline) {
         ESP_LOGE(TAG, "pipeline init failed");
-        return;
+        return ESP_FAIL;
+    }
+    ESP_ERROR_CHECK(voice_pipeline_start(s_pipeline));
+
+#if CONFIG_KVA_BREATH_MONITOR
+    // Listens to the AFE output, only while sleep mode is on
+    device_state_add_sleep_listener(breath_monitor_sleep_cb, NULL);
+#endif
+
+#if CONFIG_KVA_WAKE_CAPTURE_ENABLE
+    // Training capture is optional; the assistant runs without it
+    if (wake_capture_init(&s_audio) != ESP_OK) {
+        ESP_LOGW(TAG, "Wake-word training capture unavailable");
     }
-    ESP_ERROR_CHECK(voice_pipeline_start(pipeline));
+#endif
     
     // Set WakeNet local control callback (parallel to Gemini streaming)
     if (pipeline_cfg.enable_wakenet_local) {
-        voice_pipeline_set_wake_callback(pipeline, wakenet_local_control_cb, pipeline);
+        voice_pipeline_set_wake_callback(s_pipeline, wakenet_local_control_cb, s_pipeline);
         ESP_LOGI(TAG, "WakeNet9l enabled in parallel for local control: model=%s", pipeline_cfg.wakenet_model);
     }
 
     // Skip traditional wake word service when using realtime streaming + WakeNet
     // WakeNet is handled directly in AFE pipeline
-    wake_word_service_t *wake_service = NULL;
     if (!pipeline_cfg.use_realtime_streaming || (!pipeline_cfg.skip_wake_word && !pipeline_cfg.enable_wakenet_local)) {
         int wake_cooldown_ms = CONFIG_KVA_CAPTURE_MS + 500;
         if (wake_cooldown_ms < 1500) {
             wake_cooldown_ms = 1500;
         }
         wake_word_service_config_t wake_cfg = {
-            .audio = &audio,
-            .aws_bridge = (aws_bridge.metrics_mutex != NULL) ? &aws_bridge : NULL, // AWS IoT bridge if initialized
+            .audio = &s_audio,
+            .aws_bridge = pipeline_cfg.aws_bridge,
             .sensitivity = CONFIG_KVA_WAKE_WORD_SENSITIVITY,
             .simulated_interval_ms = CONFIG_KVA_SIMULATED_WAKE_INTERVAL_MS,
             .cooldown_ms = wake_cooldown_ms,
         };
-        wake_service = wake_word_service_start(&wake_cfg, wake_word_callback, pipeline);
-        if (!wake_service) {
+        s_wake_service = wake_word_service_start(&wake_cfg, wake_word_callback, s_pipeline);
+        if (!s_wake_service) {
             ESP_LOGE(TAG, "wake service init failed");
-            return;
+            return ESP_FAIL;
         }
     } else {
         if (pipeline_cfg.enable_wakenet_local) {
@@ -947,7 +1343,6 @@ void app_main(void)
         }
     }
 
-    button_service_t *button_service = NULL;
     if (CONFIG_KVA_BUTTON1_GPIO >= 0) {
         const button_service_button_t buttons[] = {
             {
@@ -960,11 +1355,12 @@ void app_main(void)
             .buttons = buttons,
             .button_count = 1,
             .callback = button_callback,
-            .callback_ctx = pipeline,
+            .callback_ctx = s_pipeline,
             .debounce_ms = CONFIG_KVA_BUTTON_DEBOUNCE_MS,
+            .long_press_ms = CONFIG_KVA_BUTTON_LONG_PRESS_MS,
         };
-        button_service = button_service_start(&button_cfg);
-        if (!button_service) {
+        s_button_service = button_service_start(&button_cfg);
+        if (!s_button_service) {
             ESP_LOGW(TAG, "Button service failed to start (GPIO %d)", CONFIG_KVA_BUTTON1_GPIO);
         }
     }
@@ -981,11 +1377,128 @@ void app_main(void)
     } else {
         ESP_LOGI(TAG, "Assistant ready. Say \"Naptick\" or wait for simulated wake events or button presses.");
     }
-    
-    // Initialize serial command parser for dashboard control
-    serial_command_parser_init(&spotify);
+    ESP_LOGI(TAG, "Listening %d ms after power-on", (int)(esp_timer_get_time() / 1000));
+    return ESP_OK;
+}
+
+// Serial command parser for dashboard control
+static esp_err_t boot_serial(void)
+{
+    serial_command_parser_init(&s_spotify);
     ESP_LOGI(TAG, "Serial command parser initialized for Spotify control");
+    return ESP_OK;
+}
+
+static const boot_stage_t s_boot_stages[STAGE_COUNT] = {
+    [STAGE_AUDIO] = {"audio", boot_audio, 0, 0},
+    [STAGE_CODEC] = {"codec", boot_codec, BOOT_AFTER(STAGE_AUDIO), 0},
+    [STAGE_LEDS] = {"leds", boot_leds, 0, 0},
+    [STAGE_WIFI_START] = {"wifi_start", boot_wifi_start, BOOT_AFTER(STAGE_LEDS), 0},
+    [STAGE_WIFI] = {"wifi", boot_wifi, BOOT_AFTER(STAGE_WIFI_START), 0},
+    [STAGE_ROUTER] = {"router", boot_router, 0, 0},
+    [STAGE_SPOTIFY] = {"spotify", boot_spotify, BOOT_AFTER(STAGE_LEDS), 0},
+    // mDNS needs the netif and event loop; credentials are read meanwhile
+    [STAGE_CSPOT] = {"cspot", boot_cspot, BOOT_AFTER(STAGE_WIFI_START), 0},
+    [STAGE_AWS] = {"aws", boot_aws, BOOT_AFTER(STAGE_LEDS), 0},
+    [STAGE_MQTT] = {"mqtt", boot_mqtt, BOOT_AFTER(STAGE_AWS) | BOOT_AFTER(STAGE_WIFI), 0},
+    [STAGE_MATTER] = {"matter", boot_matter, BOOT_AFTER(STAGE_SPOTIFY), 0},
+    [STAGE_SENSORS] = {"sensors", boot_sensors, BOOT_AFTER(STAGE_LEDS) | BOOT_AFTER(STAGE_MATTER), 8192},
+    [STAGE_SENSOR_PUBLISH] = {"sensor_publish", boot_sensor_publish, BOOT_AFTER(STAGE_SENSORS) | BOOT_AFTER(STAGE_MQTT), 0},
+    [STAGE_AUDIO_BUS_SCAN] = {"audio_bus_scan", boot_audio_bus_scan, BOOT_AFTER(STAGE_CODEC), 0},
+    [STAGE_PIPELINE] = {"pipeline",
+                        boot_pipeline,
+                        BOOT_AFTER(STAGE_AUDIO) | BOOT_AFTER(STAGE_CODEC) | BOOT_AFTER(STAGE_LEDS) |
+                            BOOT_AFTER(STAGE_ROUTER) | BOOT_AFTER(STAGE_SPOTIFY) | BOOT_AFTER(STAGE_AWS),
+                        8192},
+    [STAGE_SERIAL] = {"serial", boot_serial, BOOT_AFTER(STAGE_SPOTIFY), 0},
+};
+
+void app_main(void)
+{
+    ESP_LOGI(TAG, "========================================");
+    ESP_LOGI(TAG, "Naphome Voice Assistant Starting");
+    ESP_LOGI(TAG, "ESP-IDF Version: %s", esp_get_idf_version());
+    ESP_LOGI(TAG, "Firmware Version: %s", FIRMWARE_VERSION);
+    ESP_LOGI(TAG, "Git Commit: %s", GIT_COMMIT_HASH);
+    ESP_LOGI(TAG, "Git Date: %s", GIT_COMMIT_DATE);
+    ESP_LOGI(TAG, "Build Time: %s", BUILD_TIMESTAMP);
+    ESP_LOGI(TAG, "Free heap: %u bytes", (unsigned int)esp_get_free_heap_size());
+    ESP_LOGI(TAG, "========================================\n");
+    
+    // Register shutdown handler for crash reporting
+    esp_register_shutdown_handler(shutdown_handler);
+    
+    // Before any task starts allocating small objects; falls back to the heap if RAM is short
+    slab_alloc_init();
+
+    ESP_ERROR_CHECK(nvs_flash_init());
+    ESP_LOGI(TAG, "NVS initialized");
+
+    // Fleet overrides of the performance settings, before anything reads them
+    esp_err_t flags_err = feature_flags_init();
+    if (flags_err != ESP_OK) {
+        ESP_LOGW(TAG, "Feature flags at build defaults (%s)", esp_err_to_name(flags_err));
+    }
+
+    // Files the device writes at runtime; everything that uses it copes without
+    esp_err_t storage_err = storage_mount(NULL);
+    if (storage_err != ESP_OK) {
+        ESP_LOGW(TAG, "Storage unavailable (%s)", esp_err_to_name(storage_err));
+    }
+
+    // Housekeeping timers from here on, radio_coex's restore timer first
+    ESP_ERROR_CHECK(timer_wheel_init());
+
+    // DLOG* records from the hot paths wait in their rings until this runs
+    esp_err_t drain_err = log_drain_init();
+    if (drain_err != ESP_OK) {
+        ESP_LOGW(TAG, "Log drain unavailable, deferred logs are lost (%s)", esp_err_to_name(drain_err));
+    }
+
+    esp_err_t pm_err = power_profile_init();
+    if (pm_err != ESP_OK) {
+        ESP_LOGW(TAG, "Power profile unavailable, running at full clock (%s)", esp_err_to_name(pm_err));
+    }
+    power_profile_set_busy(POWER_PROFILE_LISTEN, CONFIG_KVA_PM_LISTEN_FULL_SPEED && !s_muted);
+    esp_err_t coex_err = radio_coex_init();
+    if (coex_err != ESP_OK) {
+        ESP_LOGW(TAG, "Radio coexistence tuning unavailable (%s)", esp_err_to_name(coex_err));
+    }
+
+    // Before the boot stages start the audio loops that publish to it
+    const event_bus_subscriber_config_t status_events = {
+        .topics = EVENT_BUS_TOPIC_BIT(EVENT_BUS_TOPIC_COUNT) - 1,
+        .handler = status_event_cb,
+        .task = TASK_PLACEMENT_STATUS_EVENTS,
+    };
+    ESP_ERROR_CHECK(event_bus_subscribe(&status_events));
+
+    // Before the boot stages, so their tasks are profiled from their first run
+    esp_err_t prof_err = cpu_profiler_init();
+    if (prof_err != ESP_OK) {
+        ESP_LOGW(TAG, "CPU profiler unavailable (%s)", esp_err_to_name(prof_err));
+    }
+    // Its review names the preempting task from the profiler's loads
+    esp_err_t deadline_err = deadline_monitor_init();
+    if (deadline_err != ESP_OK) {
+        ESP_LOGW(TAG, "Deadline monitor unavailable (%s)", esp_err_to_name(deadline_err));
+    }
+
+    // Before the Wi-Fi stage, whose first lease triggers the prefetch
+    esp_err_t dns_err = dns_cache_init();
+    if (dns_err != ESP_OK) {
+        ESP_LOGW(TAG, "DNS cache unavailable (%s)", esp_err_to_name(dns_err));
+    }
+
+    ESP_ERROR_CHECK(boot_sequence_run(s_boot_stages, STAGE_COUNT));
+
     while (true) {
-        vTaskDelay(pdMS_TO_TICKS(60000));
+        if (CONFIG_KVA_STACK_REPORT_PERIOD_MS > 0) {
+            vTaskDelay(pdMS_TO_TICKS(CONFIG_KVA_STACK_REPORT_PERIOD_MS));
+            mem_telemetry_log();
+        } else {
+            // Nothing left to do here; never wake the chip for it
+            vTaskDelay(portMAX_DELAY);
+        }
     }
 }
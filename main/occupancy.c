@@ -0,0 +1,242 @@
+#include "occupancy.h"
+
+#include <math.h>
+#include <string.h>
+
+#include "audio_meter.h"
+#include "device_state.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "sensor_integration.h"
+#include "somnus_ble.h"
+#include "timer_wheel.h"
+
+#define OCCUPANCY_ENTER_SCORE 50
+#define OCCUPANCY_LEAVE_SCORE 25
+// CO2 is sampled once a minute into the slope window
+#define OCCUPANCY_CO2_SAMPLE_US (60 * 1000000LL)
+// The sound floor falls at once and creeps up over about a quarter hour
+#define OCCUPANCY_FLOOR_RISE (CONFIG_KVA_OCCUPANCY_TICK_MS / 900000.0f)
+#define OCCUPANCY_SOUND_OVER_FLOOR 3.0f
+
+static const char *TAG = "occupancy";
+
+static const uint8_t WEIGHTS[OCCUPANCY_SOURCE_COUNT] = {
+    [OCCUPANCY_SOURCE_PROXIMITY] = 100,
+    [OCCUPANCY_SOURCE_ACTIVITY] = 100,
+    [OCCUPANCY_SOURCE_PHONE] = 60,
+    [OCCUPANCY_SOURCE_SOUND] = 50,
+    [OCCUPANCY_SOURCE_CO2] = 40,
+};
+
+static struct {
+    portMUX_TYPE lock;                // Guards seen_us and the published stats
+    int64_t seen_us[OCCUPANCY_SOURCE_COUNT];  // 0: never
+    occupancy_stats_t stats;
+    // timer_wheel task only
+    timer_wheel_timer_t *timer;
+    occupancy_cb_t cb;
+    void *cb_ctx;
+    float floor_rms;
+    float co2[CONFIG_KVA_OCCUPANCY_CO2_WINDOW_MIN];
+    uint32_t co2_count;
+    int64_t co2_next_us;
+} s_occ = {.lock = portMUX_INITIALIZER_UNLOCKED};
+
+void occupancy_note(occupancy_source_t source)
+{
+    if (source >= OCCUPANCY_SOURCE_COUNT) {
+        return;
+    }
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL_SAFE(&s_occ.lock);
+    s_occ.seen_us[source] = now;
+    portEXIT_CRITICAL_SAFE(&s_occ.lock);
+}
+
+// Least-squares slope of the per-minute window, ppm per minute
+static float co2_slope(void)
+{
+    uint32_t n = s_occ.co2_count;
+    if (n < CONFIG_KVA_OCCUPANCY_CO2_WINDOW_MIN) {
+        return NAN;
+    }
+    float mean_x = (n - 1) / 2.0f;
+    float mean_y = 0.0f;
+    for (uint32_t i = 0; i < n; ++i) {
+        mean_y += s_occ.co2[i];
+    }
+    mean_y /= n;
+    float sxy = 0.0f;
+    float sxx = 0.0f;
+    for (uint32_t i = 0; i < n; ++i) {
+        sxy += (i - mean_x) * (s_occ.co2[i] - mean_y);
+        sxx += (i - mean_x) * (i - mean_x);
+    }
+    return sxy / sxx;
+}
+
+static void sample_co2(int64_t now)
+{
+    if (now < s_occ.co2_next_us) {
+        return;
+    }
+    s_occ.co2_next_us = now + OCCUPANCY_CO2_SAMPLE_US;
+    sensor_integration_data_t data = sensor_integration_get_data();
+    if (!data.scd40_available) {
+        s_occ.co2_count = 0;
+        return;
+    }
+    // Oldest first, so the index is the minute
+    if (s_occ.co2_count == CONFIG_KVA_OCCUPANCY_CO2_WINDOW_MIN) {
+        memmove(s_occ.co2, s_occ.co2 + 1, sizeof(s_occ.co2) - sizeof(s_occ.co2[0]));
+        s_occ.co2_count--;
+    }
+    s_occ.co2[s_occ.co2_count++] = data.co2_ppm;
+    float slope = co2_slope();
+    if (!isnan(slope) && slope >= CONFIG_KVA_OCCUPANCY_CO2_PPM_MIN) {
+        occupancy_note(OCCUPANCY_SOURCE_CO2);
+    }
+}
+
+// Echo-cancelled AFE output only: the unit's own playback is not a person
+static void sample_sound(int64_t now)
+{
+    audio_meter_levels_t levels;
+    audio_meter_get(&levels);
+    if (!levels.processed_us || now - levels.processed_us > (int64_t)AUDIO_METER_STALE_MS * 1000) {
+        return;
+    }
+    float rms = levels.processed.rms;
+    if (s_occ.floor_rms <= 0.0f || rms < s_occ.floor_rms) {
+        s_occ.floor_rms = rms;
+    } else {
+        s_occ.floor_rms += (rms - s_occ.floor_rms) * OCCUPANCY_FLOOR_RISE;
+    }
+    if (rms >= CONFIG_KVA_OCCUPANCY_SOUND_RMS && rms >= s_occ.floor_rms * OCCUPANCY_SOUND_OVER_FLOOR) {
+        occupancy_note(OCCUPANCY_SOURCE_SOUND);
+    }
+}
+
+static void tick(void *arg)
+{
+    (void)arg;
+    int64_t now = esp_timer_get_time();
+    sample_co2(now);
+    sample_sound(now);
+    if (somnus_ble_is_connected()) {
+        occupancy_note(OCCUPANCY_SOURCE_PHONE);
+    }
+
+    int64_t seen_us[OCCUPANCY_SOURCE_COUNT];
+    portENTER_CRITICAL(&s_occ.lock);
+    memcpy(seen_us, s_occ.seen_us, sizeof(seen_us));
+    occupancy_state_t state = s_occ.stats.state;
+    portEXIT_CRITICAL(&s_occ.lock);
+
+    const int64_t hold_us = (int64_t)CONFIG_KVA_OCCUPANCY_HOLD_S * 1000000;
+    uint32_t score = 0;
+    int32_t ago_s[OCCUPANCY_SOURCE_COUNT];
+    for (int s = 0; s < OCCUPANCY_SOURCE_COUNT; ++s) {
+        int64_t age = now - seen_us[s];
+        ago_s[s] = seen_us[s] ? (int32_t)(age / 1000000) : -1;
+        if (seen_us[s] && age < hold_us) {
+            score += (uint32_t)(WEIGHTS[s] * (hold_us - age) / hold_us);
+        }
+    }
+
+    occupancy_state_t next = state;
+    if (device_state_sleep_mode()) {
+        next = OCCUPANCY_ASLEEP;
+    } else if (state != OCCUPANCY_PRESENT && score >= OCCUPANCY_ENTER_SCORE) {
+        next = OCCUPANCY_PRESENT;
+    } else if (state != OCCUPANCY_EMPTY && score < OCCUPANCY_LEAVE_SCORE) {
+        next = OCCUPANCY_EMPTY;
+    } else if (state == OCCUPANCY_ASLEEP) {
+        // Woken with the room still scoring in between: someone is up
+        next = OCCUPANCY_PRESENT;
+    }
+
+    portENTER_CRITICAL(&s_occ.lock);
+    s_occ.stats.state = next;
+    s_occ.stats.score = score;
+    s_occ.stats.co2_ppm_per_min = co2_slope();
+    s_occ.stats.sound_floor_rms = s_occ.floor_rms;
+    memcpy(s_occ.stats.seen_s_ago, ago_s, sizeof(ago_s));
+    portEXIT_CRITICAL(&s_occ.lock);
+
+    if (next != state) {
+        ESP_LOGI(TAG, "Room %s (score %u)", occupancy_state_name(next), (unsigned)score);
+        if (s_occ.cb) {
+            s_occ.cb(next, s_occ.cb_ctx);
+        }
+    }
+}
+
+esp_err_t occupancy_init(occupancy_cb_t cb, void *ctx)
+{
+#if CONFIG_KVA_OCCUPANCY
+    if (s_occ.timer) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    s_occ.cb = cb;
+    s_occ.cb_ctx = ctx;
+    s_occ.stats.state = OCCUPANCY_PRESENT;
+    s_occ.stats.co2_ppm_per_min = NAN;
+    for (int s = 0; s < OCCUPANCY_SOURCE_COUNT; ++s) {
+        s_occ.stats.seen_s_ago[s] = -1;
+    }
+    // Boot counts as use, so the room starts occupied and has to go quiet first
+    occupancy_note(OCCUPANCY_SOURCE_ACTIVITY);
+    const timer_wheel_timer_config_t args = {
+        .callback = tick,
+        .name = "occupancy",
+        .slack_ms = CONFIG_KVA_OCCUPANCY_TICK_MS / 4,
+    };
+    esp_err_t err = timer_wheel_create(&args, &s_occ.timer);
+    if (err == ESP_OK) {
+        timer_wheel_start_periodic(s_occ.timer, CONFIG_KVA_OCCUPANCY_TICK_MS);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Tick timer: %s", esp_err_to_name(err));
+    }
+    return err;
+#else
+    (void)cb;
+    (void)ctx;
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
+occupancy_state_t occupancy_get(void)
+{
+    portENTER_CRITICAL(&s_occ.lock);
+    occupancy_state_t state = s_occ.stats.state;
+    portEXIT_CRITICAL(&s_occ.lock);
+    return state;
+}
+
+void occupancy_get_stats(occupancy_stats_t *out)
+{
+    if (!out) {
+        return;
+    }
+    portENTER_CRITICAL(&s_occ.lock);
+    *out = s_occ.stats;
+    portEXIT_CRITICAL(&s_occ.lock);
+}
+
+const char *occupancy_state_name(occupancy_state_t state)
+{
+    switch (state) {
+    case OCCUPANCY_PRESENT:
+        return "occupied";
+    case OCCUPANCY_EMPTY:
+        return "empty";
+    case OCCUPANCY_ASLEEP:
+        return "asleep";
+    default:
+        return "unknown";
+    }
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "kva_config_defaults.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Whether anyone is in the room, from evidence that costs nothing extra to
+ * collect: VCNL4040 proximity events, sound above the room's noise floor on
+ * the AFE output (or a classified sound event), CO2 rising, the phone app
+ * connected over BLE, and direct use (wake word, button).
+ *
+ * Each source counts at its weight when just seen and fades linearly to
+ * nothing over CONFIG_KVA_OCCUPANCY_HOLD_S. The room is occupied once the
+ * sum reaches 50 and empty again below 25, so one weak source (a sound, a
+ * slow CO2 rise) is enough to hold a room but a door slam alone fades fast.
+ * Sleep mode overrides the score: the room is asleep.
+ *
+ * Evaluated on the esp_timer task every CONFIG_KVA_OCCUPANCY_TICK_MS; the
+ * callback runs there on every change of state.
+ */
+
+typedef enum {
+    OCCUPANCY_PRESENT = 0,            // Boot state: everything at full rate until proven empty
+    OCCUPANCY_EMPTY,
+    OCCUPANCY_ASLEEP,
+} occupancy_state_t;
+
+typedef enum {
+    OCCUPANCY_SOURCE_PROXIMITY,       // Weight 100
+    OCCUPANCY_SOURCE_ACTIVITY,        // 100
+    OCCUPANCY_SOURCE_PHONE,           // 60
+    OCCUPANCY_SOURCE_SOUND,           // 50
+    OCCUPANCY_SOURCE_CO2,             // 40
+    OCCUPANCY_SOURCE_COUNT,
+} occupancy_source_t;
+
+typedef void (*occupancy_cb_t)(occupancy_state_t state, void *ctx);
+
+typedef struct {
+    occupancy_state_t state;
+    uint32_t score;
+    float co2_ppm_per_min;            // NAN until the window has filled
+    float sound_floor_rms;
+    int32_t seen_s_ago[OCCUPANCY_SOURCE_COUNT];  // -1: never
+} occupancy_stats_t;
+
+// Start evaluating; cb (may be NULL) hears every change of state
+esp_err_t occupancy_init(occupancy_cb_t cb, void *ctx);
+
+// Evidence seen just now; any task, never blocks
+void occupancy_note(occupancy_source_t source);
+
+occupancy_state_t occupancy_get(void);
+
+void occupancy_get_stats(occupancy_stats_t *out);
+
+const char *occupancy_state_name(occupancy_state_t state);
+
+#ifdef __cplusplus
+}
+#endif
@@ -7,30 +7,78 @@
 #include <string.h>
 
 #include "cJSON.h"
+#include "conversation_memory.h"
+#include "deadline_monitor.h"
 #include "esp_check.h"
-#include "esp_crt_bundle.h"
-#include "esp_http_client.h"
 #include "esp_websocket_client.h"
 #include "esp_log.h"
 #include "esp_system.h"
+#include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/semphr.h"
 #include "freertos/task.h"
 #include "mbedtls/base64.h"
+#include "https_pool.h"
+#include "interaction_arena.h"
+#include "interaction_trace.h"
+#include "json_writer.h"
+#include "kva_config_defaults.h"
+#include "mem_tags.h"
 #include "openai_secrets.h"
+#include "sse_text_parser.h"
+#include "task_placement.h"
+#include "uplink_codec.h"
+#include "uplink_link.h"
+#include "wav_upload.h"
 
 static const char *TAG = "openai_client";
-static const char *RESPONSES_URL = "https://api.openai.com/v1/responses";
-static const char *TTS_URL = "https://api.openai.com/v1/audio/speech";
+#if CONFIG_KVA_BENCH_MODE
+#define OPENAI_HTTP_ORIGIN "http://" CONFIG_KVA_BENCH_CLOUD_HOST
+#define OPENAI_WS_ORIGIN "ws://" CONFIG_KVA_BENCH_CLOUD_HOST
+#else
+#define OPENAI_HTTP_ORIGIN "https://api.openai.com"
+#define OPENAI_WS_ORIGIN "wss://api.openai.com"
+#endif
 
-// SSE streaming context
+static const char *RESPONSES_URL = OPENAI_HTTP_ORIGIN "/v1/responses";
+static const char *TTS_URL = OPENAI_HTTP_ORIGIN "/v1/audio/speech";
+
+// Samples per queued chunk; an append event carries one or more
+#define REALTIME_CHUNK_SAMPLES 512
+#define REALTIME_QUEUE_DEPTH 30
+// A gap this long in the uplink audio ends the turn as far as the input format goes
+#define REALTIME_IDLE_TURN_US (1000 * 1000)
+
+// OpenAI Realtime takes G.711 at 8 kHz only
+#define REALTIME_G711_RATE_HZ 8000
+
+// input_audio_buffer.append framing written around the base64 payload
+static const char APPEND_PREFIX[] = "{\"type\":\"input_audio_buffer.append\",\"audio\":\"";
+static const char APPEND_SUFFIX[] = "\"}";
+static const char COMMIT_EVENT[] = "{\"type\":\"input_audio_buffer.commit\"}";
+static const char RESPONSE_EVENT[] = "{\"type\":\"response.create\"}";
+static const char CLEAR_EVENT[] = "{\"type\":\"input_audio_buffer.clear\"}";
+
+// Reply audio is decoded as its event arrives instead of being buffered and
+// parsed whole. The base64 delta is the event's last member.
+static const char AUDIO_DELTA_TYPE[] = "{\"type\":\"response.audio.delta\"";
+static const char AUDIO_DELTA_KEY[] = "\"delta\":\"";
+// base64 characters decoded per callback; a multiple of 8 so every decode
+// but a delta's last ends on a whole sample (384 samples, 16 ms)
+#define REALTIME_AUDIO_B64_CHARS 1024
+
+// sample_count 0 closes the turn
 typedef struct {
-    openai_stream_callback_t callback;
-    void *callback_ctx;
-    char *accumulated_text;
-    size_t accumulated_len;
-    size_t accumulated_cap;
-} sse_stream_ctx_t;
+    int16_t samples[REALTIME_CHUNK_SAMPLES];
+    uint16_t sample_count;
+    bool reply;
+} realtime_chunk_t;
+
+typedef enum {
+    REALTIME_RX_JSON = 0,   // Buffered, parsed when the message is complete
+    REALTIME_RX_AUDIO,      // Inside an audio delta's base64
+    REALTIME_RX_SKIP,       // Past the delta; the rest of the message is ignored
+} realtime_rx_state_t;
 
 // Realtime WebSocket streaming context
 struct openai_realtime_stream {
@@ -48,6 +96,28 @@ struct openai_realtime_stream {
     char *message_buffer;
     size_t message_buffer_len;
     size_t message_buffer_cap;
+    // Reusable send buffer for append events, sized once for CONFIG_KVA_UPLINK_BATCH_MAX chunks
+    char *append_frame;
+    size_t append_frame_cap;
+    // Uplink codec stage between the queue and the append frame. codec is
+    // the session's input format now; a poor link drops it from the
+    // configured one to mu-law between turns
+    uplink_codec_id_t codec;
+    uplink_codec_id_t configured_codec;
+    uplink_codec_encoder_t encoder;
+    uplink_link_t link;
+    bool turn_open;                   // Audio of the current turn has gone out in codec
+    int64_t last_audio_us;
+    uint8_t *encoded;
+    size_t encoded_cap;
+    // Encoding and sending a chunk has to fit in the audio it carries
+    deadline_monitor_stage_t *deadline;
+    // Speech-to-speech output, NULL for transcripts only
+    openai_realtime_audio_cb_t audio_cb;
+    realtime_rx_state_t rx_state;
+    char audio_b64[REALTIME_AUDIO_B64_CHARS];
+    size_t audio_b64_len;
+    int16_t audio_pcm[REALTIME_AUDIO_B64_CHARS / 4 * 3 / sizeof(int16_t)];
 };
 
 typedef struct {
@@ -66,7 +136,7 @@ static esp_err_t http_buffer_append(http_buffer_t *buf, const uint8_t *chunk, si
         while (new_cap < buf->len + chunk_len) {
             new_cap *= 2;
         }
-        uint8_t *new_mem = realloc(buf->data, new_cap);
+        uint8_t *new_mem = interaction_arena_realloc(buf->data, new_cap);
         ESP_RETURN_ON_FALSE(new_mem, ESP_ERR_NO_MEM, TAG, "alloc");
         buf->data = new_mem;
         buf->cap = new_cap;
@@ -76,104 +146,29 @@ static esp_err_t http_buffer_append(http_buffer_t *buf, const uint8_t *chunk, si
     return ESP_OK;
 }
 
-static esp_err_t http_event_handler(esp_http_client_event_t *evt)
+// https_pool body sink
+static esp_err_t http_buffer_sink(void *ctx, const uint8_t *data, size_t len)
 {
-    if (!evt || !evt->user_data) {
-        return ESP_FAIL;
-    }
-    http_buffer_t *buf = (http_buffer_t *)evt->user_data;
-    if (evt->event_id == HTTP_EVENT_ON_DATA) {
-        return http_buffer_append(buf, (const uint8_t *)evt->data, evt->data_len);
-    }
-    return ESP_OK;
+    return http_buffer_append((http_buffer_t *)ctx, data, len);
 }
 
-// SSE event handler for streaming responses
-static esp_err_t http_sse_event_handler(esp_http_client_event_t *evt)
+// https_pool sink for text/event-stream bodies
+static esp_err_t sse_parser_sink(void *ctx, const uint8_t *data, size_t len)
 {
-    if (!evt || !evt->user_data) {
-        return ESP_FAIL;
-    }
-    sse_stream_ctx_t *ctx = (sse_stream_ctx_t *)evt->user_data;
-    
-    if (evt->event_id == HTTP_EVENT_ON_DATA) {
-        const char *data = (const char *)evt->data;
-        size_t data_len = evt->data_len;
-        
-        // Parse SSE format: "data: {...}\n\n"
-        const char *line_start = data;
-        const char *end = data + data_len;
-        
-        while (line_start < end) {
-            const char *line_end = line_start;
-            while (line_end < end && *line_end != '\n' && *line_end != '\r') {
-                line_end++;
-            }
-            
-            size_t line_len = line_end - line_start;
-            if (line_len > 0) {
-                // Check if line starts with "data: "
-                if (line_len > 6 && memcmp(line_start, "data: ", 6) == 0) {
-                    const char *json_start = line_start + 6;
-                    size_t json_len = line_len - 6;
-                    
-                    // Parse JSON to extract text
-                    char *json_str = malloc(json_len + 1);
-                    if (json_str) {
-                        memcpy(json_str, json_start, json_len);
-                        json_str[json_len] = '\0';
-                        
-                        cJSON *root = cJSON_Parse(json_str);
-                        if (root) {
-                            // Check for "output" array
-                            cJSON *output = cJSON_GetObjectItem(root, "output");
-                            if (cJSON_IsArray(output)) {
-                                cJSON *msg = NULL;
-                                cJSON_ArrayForEach(msg, output) {
-                                    cJSON *content = cJSON_GetObjectItem(msg, "content");
-                                    if (cJSON_IsArray(content)) {
-                                        cJSON *entry = NULL;
-                                        cJSON_ArrayForEach(entry, content) {
-                                            cJSON *type = cJSON_GetObjectItem(entry, "type");
-                                            if (cJSON_IsString(type) && strcmp(type->valuestring, "output_text") == 0) {
-                                                cJSON *text = cJSON_GetObjectItem(entry, "text");
-                                                if (cJSON_IsString(text) && ctx->callback) {
-                                                    ctx->callback(text->valuestring, false, ctx->callback_ctx);
-                                                }
-                                            }
-                                        }
-                                    }
-                                }
-                            }
-                            
-                            // Check for "done" flag
-                            cJSON *done = cJSON_GetObjectItem(root, "done");
-                            if (cJSON_IsTrue(done) && ctx->callback) {
-                                ctx->callback("", true, ctx->callback_ctx);
-                            }
-                            
-                            cJSON_Delete(root);
-                        }
-                        free(json_str);
-                    }
-                }
-            }
-            
-            // Skip newline
-            while (line_end < end && (*line_end == '\n' || *line_end == '\r')) {
-                line_end++;
-            }
-            line_start = line_end;
-        }
-    }
-    
+    sse_text_parser_feed((sse_text_parser_t *)ctx, (const char *)data, len);
     return ESP_OK;
 }
 
+bool openai_has_api_key(void)
+{
+    // An unconfigured build keeps the template's placeholder
+    return OPENAI_API_KEY_STRING[0] != '\0' && OPENAI_API_KEY_STRING[0] != '@';
+}
+
 static char *make_auth_header(void)
 {
     size_t needed = strlen("Bearer ") + strlen(OPENAI_API_KEY_STRING) + 1;
-    char *value = calloc(1, needed);
+    char *value = interaction_arena_calloc(1, needed);
     if (!value) {
         return NULL;
     }
@@ -181,119 +176,178 @@ static char *make_auth_header(void)
     return value;
 }
 
-static esp_err_t http_post_json(const char *url, const char *payload, http_buffer_t *response, bool expect_binary)
+// Adds auth/content headers; req supplies URL, body and response sink
+static esp_err_t http_post(https_pool_request_t *req, const char *accept)
 {
-    ESP_RETURN_ON_FALSE(url && payload && response, ESP_ERR_INVALID_ARG, TAG, "bad args");
-    http_buffer_append(response, NULL, 0);
-    esp_http_client_config_t cfg = {
-        .url = url,
-        .method = HTTP_METHOD_POST,
-        .event_handler = http_event_handler,
-        .user_data = response,
-        .crt_bundle_attach = esp_crt_bundle_attach,
-        .timeout_ms = 60000,
+    char *auth_value = make_auth_header();
+    ESP_RETURN_ON_FALSE(auth_value, ESP_ERR_NO_MEM, TAG, "auth hdr");
+    const https_pool_header_t headers[] = {
+        {"Authorization", auth_value},
+        {"Content-Type", "application/json"},
+        {"Accept", accept},
     };
-    esp_http_client_handle_t client = esp_http_client_init(&cfg);
-    ESP_RETURN_ON_FALSE(client, ESP_FAIL, TAG, "client init failed");
+    req->headers = headers;
+    req->header_count = sizeof(headers) / sizeof(headers[0]);
+    req->timeout_ms = 60000;
 
-    esp_err_t ret = ESP_OK;
-    char *auth_value = make_auth_header();
-    if (!auth_value) {
-        esp_http_client_cleanup(client);
-        return ESP_ERR_NO_MEM;
-    }
-    ESP_GOTO_ON_ERROR(esp_http_client_set_header(client, "Authorization", auth_value), cleanup, TAG, "auth hdr");
-    ESP_GOTO_ON_ERROR(esp_http_client_set_header(client, "Content-Type", "application/json"), cleanup, TAG, "ct hdr");
-    if (expect_binary) {
-        ESP_GOTO_ON_ERROR(esp_http_client_set_header(client, "Accept", "audio/wav"), cleanup, TAG, "accept hdr");
-    }
-    ESP_GOTO_ON_ERROR(esp_http_client_set_post_field(client, payload, strlen(payload)), cleanup, TAG, "set body");
-    ESP_GOTO_ON_ERROR(esp_http_client_perform(client), cleanup, TAG, "perform");
-    int status = esp_http_client_get_status_code(client);
-    if (status / 100 != 2) {
+    int status = 0;
+    esp_err_t ret = https_pool_post(req, &status);
+    interaction_arena_free(auth_value);
+    if (ret == ESP_OK && status / 100 != 2) {
         ESP_LOGE(TAG, "HTTP %d", status);
         ret = ESP_FAIL;
     }
+    return ret;
+}
 
-cleanup:
-    free(auth_value);
-    esp_http_client_cleanup(client);
+// Collects the whole response into *response; freed again on failure
+static esp_err_t http_post_buffered(https_pool_request_t *req, http_buffer_t *response, const char *accept)
+{
+    http_buffer_append(response, NULL, 0);
+    req->on_data = http_buffer_sink;
+    req->ctx = response;
+    esp_err_t ret = http_post(req, accept);
+    if (ret != ESP_OK) {
+        interaction_arena_free(response->data);
+        response->data = NULL;
+        response->len = response->cap = 0;
+    }
     return ret;
 }
 
-static esp_err_t build_wav_from_pcm(const int16_t *pcm, size_t sample_count, int sample_rate_hz, uint8_t **out_buf, size_t *out_len)
-{
-    ESP_RETURN_ON_FALSE(pcm && out_buf && out_len, ESP_ERR_INVALID_ARG, TAG, "bad args");
-    const uint16_t num_channels = 1;
-    const uint16_t bits_per_sample = 16;
-    size_t data_bytes = sample_count * sizeof(int16_t);
-    size_t total_bytes = 44 + data_bytes;
-    uint8_t *wav = malloc(total_bytes);
-    ESP_RETURN_ON_FALSE(wav, ESP_ERR_NO_MEM, TAG, "wav alloc");
-
-    uint8_t header[44] = {0};
-    memcpy(header, "RIFF", 4);
-    uint32_t chunk_size = total_bytes - 8;
-    memcpy(header + 4, &chunk_size, 4);
-    memcpy(header + 8, "WAVE", 4);
-    memcpy(header + 12, "fmt ", 4);
-    uint32_t subchunk1_size = 16;
-    memcpy(header + 16, &subchunk1_size, 4);
-    uint16_t audio_format = 1;
-    memcpy(header + 20, &audio_format, 2);
-    memcpy(header + 22, &num_channels, 2);
-    uint32_t sample_rate = sample_rate_hz;
-    memcpy(header + 24, &sample_rate, 4);
-    uint32_t byte_rate = sample_rate * num_channels * bits_per_sample / 8;
-    memcpy(header + 28, &byte_rate, 4);
-    uint16_t block_align = num_channels * bits_per_sample / 8;
-    memcpy(header + 32, &block_align, 2);
-    memcpy(header + 34, &bits_per_sample, 2);
-    memcpy(header + 36, "data", 4);
-    uint32_t subchunk2_size = data_bytes;
-    memcpy(header + 40, &subchunk2_size, 4);
-
-    memcpy(wav, header, sizeof(header));
-    memcpy(wav + sizeof(header), pcm, data_bytes);
-
-    *out_buf = wav;
-    *out_len = total_bytes;
-    return ESP_OK;
+static esp_err_t http_post_json(const char *url, const char *payload, http_buffer_t *response, bool expect_binary)
+{
+    ESP_RETURN_ON_FALSE(url && payload && response, ESP_ERR_INVALID_ARG, TAG, "bad args");
+    https_pool_request_t req = {
+        .url = url,
+        .body = payload,
+        .body_len = strlen(payload),
+    };
+    return http_post_buffered(&req, response, expect_binary ? "audio/wav" : "application/json");
+}
+
+// payload carries WAV_UPLOAD_MARKER where the base64 WAV of pcm is streamed
+static esp_err_t http_post_wav(const char *url, const char *payload, const wav_upload_body_t *body,
+                               http_buffer_t *response)
+{
+    ESP_RETURN_ON_FALSE(url && payload && body && response, ESP_ERR_INVALID_ARG, TAG, "bad args");
+    https_pool_request_t req = {
+        .url = url,
+        .body_len = wav_upload_body_length(body),
+        .write_body = wav_upload_body_write,
+        .body_ctx = (void *)body,
+    };
+    return http_post_buffered(&req, response, "application/json");
+}
+
+static size_t append_frame_capacity(size_t pcm_bytes)
+{
+    // Prefix + base64 + suffix + NUL (mbedtls also needs room for its terminator)
+    return (sizeof(APPEND_PREFIX) - 1) + ((pcm_bytes + 2) / 3) * 4 + (sizeof(APPEND_SUFFIX) - 1) + 1;
 }
 
-static esp_err_t base64_encode_alloc(const uint8_t *input, size_t input_len, char **out_str)
+// Encode PCM straight into a preallocated append event; no heap, no cJSON
+static esp_err_t encode_append_frame(char *frame, size_t frame_cap,
+                                     const uint8_t *pcm, size_t pcm_bytes, size_t *frame_len)
 {
-    ESP_RETURN_ON_FALSE(input && out_str, ESP_ERR_INVALID_ARG, TAG, "bad args");
-    size_t target_len = ((input_len + 2) / 3) * 4 + 1;
-    char *encoded = malloc(target_len);
-    ESP_RETURN_ON_FALSE(encoded, ESP_ERR_NO_MEM, TAG, "b64 alloc");
-    size_t written = 0;
-    int ret = mbedtls_base64_encode((unsigned char *)encoded, target_len, &written, input, input_len);
+    const size_t prefix_len = sizeof(APPEND_PREFIX) - 1;
+    const size_t suffix_len = sizeof(APPEND_SUFFIX) - 1;
+    ESP_RETURN_ON_FALSE(frame && pcm && frame_len && frame_cap >= append_frame_capacity(pcm_bytes),
+                        ESP_ERR_INVALID_SIZE, TAG, "append frame too small");
+    memcpy(frame, APPEND_PREFIX, prefix_len);
+    size_t b64_len = 0;
+    int ret = mbedtls_base64_encode((unsigned char *)frame + prefix_len, frame_cap - prefix_len - suffix_len,
+                                    &b64_len, pcm, pcm_bytes);
     if (ret != 0) {
-        free(encoded);
         return ESP_FAIL;
     }
-    encoded[written] = '\0';
-    *out_str = encoded;
+    memcpy(frame + prefix_len + b64_len, APPEND_SUFFIX, suffix_len);
+    *frame_len = prefix_len + b64_len + suffix_len;
+    frame[*frame_len] = '\0';
     return ESP_OK;
 }
 
-static cJSON *make_text_content_node(const char *text)
+static void write_text_content(json_writer_t *w, const char *text)
+{
+    json_writer_begin_object(w, NULL);
+    json_writer_string(w, "type", "input_text");
+    json_writer_string(w, "text", text);
+    json_writer_end_object(w);
+}
+
+static void write_audio_content(json_writer_t *w, const char *b64, const char *format)
+{
+    json_writer_begin_object(w, NULL);
+    json_writer_string(w, "type", "input_audio");
+    json_writer_begin_object(w, "input_audio");
+    json_writer_string(w, "data", b64);
+    json_writer_string(w, "format", format);
+    json_writer_end_object(w);
+    json_writer_end_object(w);
+}
+
+#define TRANSCRIBE_INSTRUCTION "Please transcribe the attached audio using concise lowercase text."
+
+// Transcription request; the audio field holds a marker the WAV is base64-streamed in place of
+static void write_transcribe_payload(json_writer_t *w, const void *arg)
+{
+    bool stream = *(const bool *)arg;
+    json_writer_begin_object(w, NULL);
+    json_writer_string(w, "model", "gpt-4o-mini-transcribe");
+    if (stream) {
+        json_writer_bool(w, "stream", true);
+    }
+    json_writer_begin_array(w, "input");
+    json_writer_begin_object(w, NULL);
+    json_writer_string(w, "role", "user");
+    json_writer_begin_array(w, "content");
+    write_text_content(w, TRANSCRIBE_INSTRUCTION);
+    write_audio_content(w, WAV_UPLOAD_MARKER, "wav");
+    json_writer_end_array(w);
+    json_writer_end_object(w);
+    json_writer_end_array(w);
+    json_writer_end_object(w);
+}
+
+static char *build_transcribe_payload(bool stream)
 {
-    cJSON *node = cJSON_CreateObject();
-    cJSON_AddStringToObject(node, "type", "input_text");
-    cJSON_AddStringToObject(node, "text", text);
-    return node;
+    return json_writer_build_alloc(write_transcribe_payload, &stream, interaction_arena_malloc,
+                                   interaction_arena_free, NULL);
 }
 
-static cJSON *make_audio_content_node(const char *b64, const char *format)
+typedef struct {
+    const char *prompt;
+    const conversation_view_t *history;   // NULL without earlier turns
+} text_payload_args_t;
+
+// Earlier turns as Responses API input messages, the summary as instructions
+static void write_text_payload(json_writer_t *w, const void *arg)
 {
-    cJSON *node = cJSON_CreateObject();
-    cJSON_AddStringToObject(node, "type", "input_audio");
-    cJSON *payload = cJSON_AddObjectToObject(node, "input_audio");
-    cJSON_AddStringToObject(payload, "data", b64);
-    cJSON_AddStringToObject(payload, "format", format);
-    return node;
+    const text_payload_args_t *args = arg;
+    const conversation_view_t *history = args->history;
+    json_writer_begin_object(w, NULL);
+    // Use gpt-4o for chat completions (latest chat model, user requested gpt-5-chat but gpt-4o is latest available)
+    json_writer_string(w, "model", "gpt-4o");
+    if (history && history->summary[0]) {
+        char instructions[sizeof("Earlier in this conversation:\n") + CONFIG_KVA_CONVERSATION_SUMMARY_CHARS];
+        snprintf(instructions, sizeof(instructions), "Earlier in this conversation:\n%s", history->summary);
+        json_writer_string(w, "instructions", instructions);
+    }
+    json_writer_begin_array(w, "input");
+    for (size_t i = 0; history && i < history->turn_count; ++i) {
+        json_writer_begin_object(w, NULL);
+        json_writer_string(w, "role", history->turns[i].role == CONVERSATION_ROLE_USER ? "user" : "assistant");
+        json_writer_string(w, "content", history->turns[i].text);
+        json_writer_end_object(w);
+    }
+    json_writer_begin_object(w, NULL);
+    json_writer_string(w, "role", "user");
+    json_writer_begin_array(w, "content");
+    write_text_content(w, args->prompt);
+    json_writer_end_array(w);
+    json_writer_end_object(w);
+    json_writer_end_array(w);
+    json_writer_end_object(w);
 }
 
 static esp_err_t parse_output_text(const char *json, char *out_text, size_t out_len)
@@ -338,109 +392,145 @@ static esp_err_t parse_output_text(const char *json, char *out_text, size_t out_
 esp_err_t openai_transcribe_wav(const int16_t *pcm_samples, size_t sample_count, int sample_rate_hz, openai_transcription_t *result)
 {
     ESP_RETURN_ON_FALSE(pcm_samples && sample_count && result, ESP_ERR_INVALID_ARG, TAG, "bad args");
-    uint8_t *wav = NULL;
-    size_t wav_len = 0;
-    ESP_RETURN_ON_ERROR(build_wav_from_pcm(pcm_samples, sample_count, sample_rate_hz, &wav, &wav_len), TAG, "wav build");
-
-    char *b64 = NULL;
-    esp_err_t err = base64_encode_alloc(wav, wav_len, &b64);
-    free(wav);
-    ESP_RETURN_ON_ERROR(err, TAG, "wav b64");
-
-    cJSON *root = cJSON_CreateObject();
-    cJSON_AddStringToObject(root, "model", "gpt-4o-mini-transcribe");
-    cJSON *input = cJSON_AddArrayToObject(root, "input");
-    cJSON *msg = cJSON_CreateObject();
-    cJSON_AddStringToObject(msg, "role", "user");
-    cJSON *content = cJSON_AddArrayToObject(msg, "content");
-    cJSON_AddItemToArray(content, make_text_content_node("Please transcribe the attached audio using concise lowercase text."));
-    cJSON_AddItemToArray(content, make_audio_content_node(b64, "wav"));
-    cJSON_AddItemToArray(input, msg);
-
-    char *payload = cJSON_PrintUnformatted(root);
-    cJSON_Delete(root);
-    free(b64);
+
+    char *payload = build_transcribe_payload(false);
     ESP_RETURN_ON_FALSE(payload, ESP_ERR_NO_MEM, TAG, "payload");
 
+    wav_upload_body_t body;
+    esp_err_t err = wav_upload_body_init(&body, payload, pcm_samples, sample_count, sample_rate_hz, UPLINK_CODEC_PCM16);
     http_buffer_t response = {0};
-    err = http_post_json(RESPONSES_URL, payload, &response, false);
-    free(payload);
+    if (err == ESP_OK) {
+        err = http_post_wav(RESPONSES_URL, payload, &body, &response);
+    }
+    cJSON_free(payload);
     ESP_RETURN_ON_ERROR(err, TAG, "http");
 
-    response.data = realloc(response.data, response.len + 1);
+    response.data = interaction_arena_realloc(response.data, response.len + 1);
     if (!response.data) {
         response.len = 0;
         return ESP_ERR_NO_MEM;
     }
     response.data[response.len] = '\0';
     err = parse_output_text((const char *)response.data, result->text, sizeof(result->text));
-    free(response.data);
+    interaction_arena_free(response.data);
     if (err != ESP_OK) {
         ESP_LOGE(TAG, "Failed to parse transcription response");
     }
     return err;
 }
 
+typedef struct {
+    const char *text;
+    const char *voice;
+} tts_payload_args_t;
+
+static void write_tts_payload(json_writer_t *w, const void *arg)
+{
+    const tts_payload_args_t *args = arg;
+    json_writer_begin_object(w, NULL);
+    json_writer_string(w, "model", "gpt-4o-mini-tts");
+    json_writer_string(w, "input", args->text);
+    json_writer_string(w, "voice", args->voice && args->voice[0] ? args->voice : "alloy");
+    json_writer_string(w, "format", "wav");
+    json_writer_end_object(w);
+}
+
+static char *build_tts_payload(const char *text, const char *voice)
+{
+    const tts_payload_args_t args = {.text = text, .voice = voice};
+    return json_writer_build_alloc(write_tts_payload, &args, interaction_arena_malloc, interaction_arena_free, NULL);
+}
+
 esp_err_t openai_tts_generate(const char *text, const char *voice, uint8_t *out_wav, size_t max_out, size_t *bytes_written)
 {
     ESP_RETURN_ON_FALSE(text && out_wav && max_out > 0, ESP_ERR_INVALID_ARG, TAG, "bad args");
-    cJSON *root = cJSON_CreateObject();
-    cJSON_AddStringToObject(root, "model", "gpt-4o-mini-tts");
-    cJSON_AddStringToObject(root, "input", text);
-    cJSON_AddStringToObject(root, "voice", voice && voice[0] ? voice : "alloy");
-    cJSON_AddStringToObject(root, "format", "wav");
-    char *payload = cJSON_PrintUnformatted(root);
-    cJSON_Delete(root);
+    char *payload = build_tts_payload(text, voice);
     ESP_RETURN_ON_FALSE(payload, ESP_ERR_NO_MEM, TAG, "payload");
 
     http_buffer_t response = {0};
     esp_err_t err = http_post_json(TTS_URL, payload, &response, true);
-    free(payload);
+    cJSON_free(payload);
     ESP_RETURN_ON_ERROR(err, TAG, "http");
 
     if (response.len > max_out) {
         ESP_LOGE(TAG, "TTS response (%d) > buffer (%d)", (int)response.len, (int)max_out);
-        free(response.data);
+        interaction_arena_free(response.data);
         return ESP_ERR_NO_MEM;
     }
     memcpy(out_wav, response.data, response.len);
-    free(response.data);
+    interaction_arena_free(response.data);
     if (bytes_written) {
         *bytes_written = response.len;
     }
     return ESP_OK;
 }
 
+typedef struct {
+    openai_tts_chunk_cb_t on_chunk;
+    void *ctx;
+    esp_err_t err;
+} tts_chunk_sink_t;
+
+static esp_err_t tts_chunk_sink(void *ctx, const uint8_t *data, size_t len)
+{
+    tts_chunk_sink_t *sink = (tts_chunk_sink_t *)ctx;
+    interaction_trace_mark(INTERACTION_TRACE_TTS_FIRST_BYTE);
+    if (sink->err == ESP_OK) {
+        sink->err = sink->on_chunk(data, len, sink->ctx);
+    }
+    return ESP_OK;
+}
+
+esp_err_t openai_tts_generate_stream(const char *text, const char *voice, openai_tts_chunk_cb_t on_chunk, void *ctx)
+{
+    ESP_RETURN_ON_FALSE(text && on_chunk, ESP_ERR_INVALID_ARG, TAG, "bad args");
+    char *payload = build_tts_payload(text, voice);
+    ESP_RETURN_ON_FALSE(payload, ESP_ERR_NO_MEM, TAG, "payload");
+
+    tts_chunk_sink_t sink = {
+        .on_chunk = on_chunk,
+        .ctx = ctx,
+    };
+    https_pool_request_t req = {
+        .url = TTS_URL,
+        .body = payload,
+        .body_len = strlen(payload),
+        .on_data = tts_chunk_sink,
+        .ctx = &sink,
+    };
+    esp_err_t err = http_post(&req, "audio/wav");
+    cJSON_free(payload);
+    ESP_RETURN_ON_ERROR(err, TAG, "http");
+    ESP_RETURN_ON_ERROR(sink.err, TAG, "chunk consumer");
+    return ESP_OK;
+}
+
 esp_err_t openai_generate_text_response(const char *prompt, char *out_text, size_t out_len)
 {
     ESP_RETURN_ON_FALSE(prompt && out_text && out_len > 0, ESP_ERR_INVALID_ARG, TAG, "bad args");
-    cJSON *root = cJSON_CreateObject();
-    ESP_RETURN_ON_FALSE(root, ESP_ERR_NO_MEM, TAG, "json alloc");
-    // Use gpt-4o for chat completions (latest chat model, user requested gpt-5-chat but gpt-4o is latest available)
-    cJSON_AddStringToObject(root, "model", "gpt-4o");
-    cJSON *input = cJSON_AddArrayToObject(root, "input");
-    cJSON *msg = cJSON_CreateObject();
-    cJSON_AddStringToObject(msg, "role", "user");
-    cJSON *content = cJSON_AddArrayToObject(msg, "content");
-    cJSON_AddItemToArray(content, make_text_content_node(prompt));
-    cJSON_AddItemToArray(input, msg);
-
-    char *payload = cJSON_PrintUnformatted(root);
-    cJSON_Delete(root);
+    // Held across both writer passes, so the history cannot change between sizing and writing
+    conversation_view_t history;
+    bool has_history = conversation_memory_acquire(&history);
+    const text_payload_args_t args = {.prompt = prompt, .history = has_history ? &history : NULL};
+    char *payload = json_writer_build_alloc(write_text_payload, &args, interaction_arena_malloc,
+                                            interaction_arena_free, NULL);
+    if (has_history) {
+        conversation_memory_release();
+    }
     ESP_RETURN_ON_FALSE(payload, ESP_ERR_NO_MEM, TAG, "payload");
 
     http_buffer_t response = {0};
     esp_err_t err = http_post_json(RESPONSES_URL, payload, &response, false);
-    free(payload);
+    cJSON_free(payload);
     ESP_RETURN_ON_ERROR(err, TAG, "http");
 
-    response.data = realloc(response.data, response.len + 1);
+    response.data = interaction_arena_realloc(response.data, response.len + 1);
     if (!response.data) {
         return ESP_ERR_NO_MEM;
     }
     response.data[response.len] = '\0';
     err = parse_output_text((const char *)response.data, out_text, out_len);
-    free(response.data);
+    interaction_arena_free(response.data);
     return err;
 }
 
@@ -449,80 +539,209 @@ esp_err_t openai_stream_audio(const int16_t *pcm_samples, size_t sample_count, i
                               openai_stream_callback_t callback, void *callback_ctx)
 {
     ESP_RETURN_ON_FALSE(pcm_samples && sample_count && callback, ESP_ERR_INVALID_ARG, TAG, "bad args");
-    
-    uint8_t *wav = NULL;
-    size_t wav_len = 0;
-    ESP_RETURN_ON_ERROR(build_wav_from_pcm(pcm_samples, sample_count, sample_rate_hz, &wav, &wav_len), TAG, "wav build");
-
-    char *b64 = NULL;
-    esp_err_t err = base64_encode_alloc(wav, wav_len, &b64);
-    free(wav);
-    ESP_RETURN_ON_ERROR(err, TAG, "wav b64");
-
-    cJSON *root = cJSON_CreateObject();
-    cJSON_AddStringToObject(root, "model", "gpt-4o-mini-transcribe");
-    cJSON_AddBoolToObject(root, "stream", cJSON_True);  // Enable streaming
-    cJSON *input = cJSON_AddArrayToObject(root, "input");
-    cJSON *msg = cJSON_CreateObject();
-    cJSON_AddStringToObject(msg, "role", "user");
-    cJSON *content = cJSON_AddArrayToObject(msg, "content");
-    cJSON_AddItemToArray(content, make_text_content_node("Please transcribe the attached audio using concise lowercase text."));
-    cJSON_AddItemToArray(content, make_audio_content_node(b64, "wav"));
-    cJSON_AddItemToArray(input, msg);
-
-    char *payload = cJSON_PrintUnformatted(root);
-    cJSON_Delete(root);
-    free(b64);
+
+    char *payload = build_transcribe_payload(true);
     ESP_RETURN_ON_FALSE(payload, ESP_ERR_NO_MEM, TAG, "payload");
 
-    // Setup SSE streaming context
-    sse_stream_ctx_t sse_ctx = {
-        .callback = callback,
-        .callback_ctx = callback_ctx,
-        .accumulated_text = NULL,
-        .accumulated_len = 0,
-        .accumulated_cap = 0
-    };
+    // Text deltas reach the callback from inside the HTTP read loop, one per event
+    sse_text_parser_t *parser = interaction_arena_malloc(sizeof(*parser));
+    if (!parser) {
+        cJSON_free(payload);
+        return ESP_ERR_NO_MEM;
+    }
+    sse_text_parser_init(parser, callback, callback_ctx);
 
-    esp_http_client_config_t cfg = {
-        .url = RESPONSES_URL,
-        .method = HTTP_METHOD_POST,
-        .event_handler = http_sse_event_handler,
-        .user_data = &sse_ctx,
-        .crt_bundle_attach = esp_crt_bundle_attach,
-        .timeout_ms = 60000,
-    };
-    esp_http_client_handle_t client = esp_http_client_init(&cfg);
-    ESP_RETURN_ON_FALSE(client, ESP_FAIL, TAG, "client init failed");
+    wav_upload_body_t body;
+    esp_err_t ret = wav_upload_body_init(&body, payload, pcm_samples, sample_count, sample_rate_hz, UPLINK_CODEC_PCM16);
+    if (ret == ESP_OK) {
+        https_pool_request_t req = {
+            .url = RESPONSES_URL,
+            .body_len = wav_upload_body_length(&body),
+            .write_body = wav_upload_body_write,
+            .body_ctx = &body,
+            .on_data = sse_parser_sink,
+            .ctx = parser,
+        };
+        ret = http_post(&req, "text/event-stream");
+    }
+    if (ret == ESP_OK) {
+        sse_text_parser_finish(parser);
+    }
 
-    char *auth_value = make_auth_header();
-    if (!auth_value) {
-        esp_http_client_cleanup(client);
-        free(payload);
-        return ESP_ERR_NO_MEM;
+    interaction_arena_free(parser);
+    cJSON_free(payload);
+    return ret;
+}
+
+static void realtime_audio_emit(struct openai_realtime_stream *stream)
+{
+    size_t pcm_bytes = 0;
+    if (stream->audio_b64_len > 0 &&
+        mbedtls_base64_decode((unsigned char *)stream->audio_pcm, sizeof(stream->audio_pcm), &pcm_bytes,
+                              (const unsigned char *)stream->audio_b64, stream->audio_b64_len) != 0) {
+        ESP_LOGW(TAG, "Bad base64 in audio delta, dropping %zu chars", stream->audio_b64_len);
+        pcm_bytes = 0;
     }
+    stream->audio_b64_len = 0;
+    if (pcm_bytes >= sizeof(int16_t)) {
+        stream->audio_cb(stream->audio_pcm, pcm_bytes / sizeof(int16_t), stream->cb_ctx);
+    }
+}
+
+// Decode an audio delta's base64 up to its closing quote; true once that is reached
+static bool realtime_audio_feed(struct openai_realtime_stream *stream, const char *b64, size_t len)
+{
+    for (size_t i = 0; i < len; ++i) {
+        char c = b64[i];
+        if (c == '"') {
+            realtime_audio_emit(stream);
+            return true;
+        }
+        if (c == '\\') {
+            continue;  // JSON may escape '/' as "\/"
+        }
+        stream->audio_b64[stream->audio_b64_len++] = c;
+        if (stream->audio_b64_len == sizeof(stream->audio_b64)) {
+            realtime_audio_emit(stream);
+        }
+    }
+    return false;
+}
+
+static void realtime_handle_message(struct openai_realtime_stream *stream, const char *json_str)
+{
+    cJSON *event = cJSON_Parse(json_str);
+    if (!event) {
+        ESP_LOGW(TAG, "Failed to parse %d byte event: %.200s", (int)stream->message_buffer_len, json_str);
+        return;
+    }
+    cJSON *type = cJSON_GetObjectItem(event, "type");
+    if (!cJSON_IsString(type)) {
+        // Log if we can't parse event type
+        ESP_LOGW(TAG, "Received event without type field: %s", json_str);
+        cJSON_Delete(event);
+        return;
+    }
+    const char *event_type = type->valuestring;
     
-    esp_err_t ret = ESP_OK;
-    ESP_GOTO_ON_ERROR(esp_http_client_set_header(client, "Authorization", auth_value), cleanup, TAG, "auth hdr");
-    ESP_GOTO_ON_ERROR(esp_http_client_set_header(client, "Content-Type", "application/json"), cleanup, TAG, "ct hdr");
-    ESP_GOTO_ON_ERROR(esp_http_client_set_header(client, "Accept", "text/event-stream"), cleanup, TAG, "accept hdr");
-    ESP_GOTO_ON_ERROR(esp_http_client_set_post_field(client, payload, strlen(payload)), cleanup, TAG, "set body");
-    ESP_GOTO_ON_ERROR(esp_http_client_perform(client), cleanup, TAG, "perform");
+    // Log all events for debugging
+    ESP_LOGI(TAG, "Received OpenAI event: %s (len=%d)", event_type, (int)stream->message_buffer_len);
+    // Also log first 200 chars of the full event for debugging
+    if (stream->message_buffer_len < 200) {
+        ESP_LOGI(TAG, "Event data: %s", json_str);
+    }
     
-    int status = esp_http_client_get_status_code(client);
-    if (status / 100 != 2) {
-        ESP_LOGE(TAG, "HTTP %d", status);
-        ret = ESP_FAIL;
+    // Handle session.created
+    if (strcmp(event_type, "session.created") == 0) {
+        cJSON *session = cJSON_GetObjectItem(event, "session");
+        if (session) {
+            cJSON *id = cJSON_GetObjectItem(session, "id");
+            if (cJSON_IsString(id)) {
+                if (stream->session_id) free(stream->session_id);
+                stream->session_id = strdup(id->valuestring);
+                ESP_LOGI(TAG, "Session created: %s", stream->session_id);
+            }
+        }
+    }
+    // Handle response.audio_transcript.delta (partial transcription)
+    else if (strcmp(event_type, "response.audio_transcript.delta") == 0) {
+        cJSON *delta = cJSON_GetObjectItem(event, "delta");
+        if (delta && cJSON_IsString(delta) && delta->valuestring && strlen(delta->valuestring) > 0) {
+            // Forward to callback for console output
+            if (stream->transcript_cb) {
+                stream->transcript_cb(delta->valuestring, false, stream->cb_ctx);
+            }
+        }
+    }
+    // Handle response.audio_transcript.done (final transcription)
+    else if (strcmp(event_type, "response.audio_transcript.done") == 0) {
+        cJSON *transcript = cJSON_GetObjectItem(event, "transcript");
+        if (transcript && cJSON_IsString(transcript) && transcript->valuestring && strlen(transcript->valuestring) > 0) {
+            // Forward to callback for console output
+            if (stream->transcript_cb) {
+                stream->transcript_cb(transcript->valuestring, true, stream->cb_ctx);
+            }
+        }
+    }
+    // Audio deltas whose type is not the first member miss the fast path
+    else if (strcmp(event_type, "response.audio.delta") == 0) {
+        cJSON *delta = cJSON_GetObjectItem(event, "delta");
+        if (stream->audio_cb && cJSON_IsString(delta)) {
+            realtime_audio_feed(stream, delta->valuestring, strlen(delta->valuestring));
+            realtime_audio_emit(stream);
+        }
+    }
+    else if (strcmp(event_type, "response.audio.done") == 0) {
+        if (stream->audio_cb) {
+            stream->audio_cb(NULL, 0, stream->cb_ctx);
+        }
     }
+    // Handle error events
+    else if (strcmp(event_type, "error") == 0) {
+        ESP_LOGE(TAG, "OpenAI error: %s", json_str);
+        if (stream->error_cb) {
+            stream->error_cb(ESP_FAIL, stream->cb_ctx);
+        }
+    }
+    // Log unhandled events
+    else {
+        ESP_LOGI(TAG, "Unhandled event type: %s", event_type);
+    }
+    cJSON_Delete(event);
+}
 
-cleanup:
-    free(auth_value);
-    free(payload);
-    if (sse_ctx.accumulated_text) {
-        free(sse_ctx.accumulated_text);
+// One piece of a text message. Audio deltas are decoded as they arrive and
+// never buffered; everything else is parsed once the message is complete.
+static void realtime_receive(struct openai_realtime_stream *stream, const char *data, size_t len, bool message_end)
+{
+    if (stream->rx_state == REALTIME_RX_AUDIO) {
+        if (realtime_audio_feed(stream, data, len)) {
+            stream->rx_state = REALTIME_RX_SKIP;
+        } else if (message_end) {
+            realtime_audio_emit(stream);
+        }
+        return;
+    }
+    if (stream->rx_state == REALTIME_RX_SKIP) {
+        return;
+    }
+    
+    if (stream->message_buffer_len + len + 1 > stream->message_buffer_cap) {
+        size_t new_cap = stream->message_buffer_cap == 0 ? 4096 : stream->message_buffer_cap * 2;
+        while (stream->message_buffer_len + len + 1 > new_cap) {
+            new_cap *= 2;
+        }
+        char *new_buf = MEM_TAG_REALLOC(MEM_TAG_OPENAI, stream->message_buffer, new_cap);
+        if (!new_buf) {
+            ESP_LOGE(TAG, "Failed to realloc message buffer");
+            stream->rx_state = REALTIME_RX_SKIP;
+            return;
+        }
+        stream->message_buffer = new_buf;
+        stream->message_buffer_cap = new_cap;
+    }
+    memcpy(stream->message_buffer + stream->message_buffer_len, data, len);
+    stream->message_buffer_len += len;
+    stream->message_buffer[stream->message_buffer_len] = '\0';
+    
+    const size_t type_len = sizeof(AUDIO_DELTA_TYPE) - 1;
+    if (stream->audio_cb && stream->message_buffer_len >= type_len &&
+        memcmp(stream->message_buffer, AUDIO_DELTA_TYPE, type_len) == 0) {
+        // Only the few ids before the delta are ever held
+        const char *key = strstr(stream->message_buffer, AUDIO_DELTA_KEY);
+        if (key) {
+            const char *b64 = key + sizeof(AUDIO_DELTA_KEY) - 1;
+            size_t b64_len = stream->message_buffer_len - (size_t)(b64 - stream->message_buffer);
+            stream->rx_state = REALTIME_RX_AUDIO;
+            stream->message_buffer_len = 0;
+            realtime_receive(stream, b64, b64_len, message_end);
+            return;
+        }
+    }
+    if (message_end) {
+        realtime_handle_message(stream, stream->message_buffer);
+        stream->message_buffer_len = 0;
     }
-    esp_http_client_cleanup(client);
-    return ret;
 }
 
 // WebSocket event handler for OpenAI Realtime API
@@ -532,7 +751,8 @@ static void websocket_event_handler(void *handler_args, esp_event_base_t base, i
     esp_websocket_event_data_t *data = (esp_websocket_event_data_t *)event_data;
     struct openai_realtime_stream *stream = (struct openai_realtime_stream *)handler_args;
     
-    ESP_LOGI(TAG, "WebSocket event received: event_id=%" PRId32 " (ws_event_id=%d)", event_id, (int)ws_event_id);
+    // Audio replies arrive as a stream of these; keep them out of the info log
+    ESP_LOGD(TAG, "WebSocket event received: event_id=%" PRId32 " (ws_event_id=%d)", event_id, (int)ws_event_id);
     
     if (!stream) {
         ESP_LOGE(TAG, "WebSocket event handler: stream is NULL");
@@ -548,32 +768,40 @@ static void websocket_event_handler(void *handler_args, esp_event_base_t base, i
             // Send session.update to configure and establish the session
             // This may be required to trigger session.created from OpenAI
             ESP_LOGI(TAG, "Preparing session.update...");
-            cJSON *session_update = cJSON_CreateObject();
-            cJSON_AddStringToObject(session_update, "type", "session.update");
-            
-            cJSON *session_config = cJSON_CreateObject();
+            char session_json[384];
+            size_t session_len = 0;
+            json_writer_t w;
+            json_writer_init(&w, session_json, sizeof(session_json));
+            json_writer_begin_object(&w, NULL);
+            json_writer_string(&w, "type", "session.update");
             // Configure session for real-time transcription
             // Minimal configuration to establish session
-            cJSON *modalities = cJSON_CreateArray();
-            cJSON_AddItemToArray(modalities, cJSON_CreateString("text")); // Enable text modality
-            cJSON_AddItemToObject(session_config, "modalities", modalities);
-            cJSON_AddStringToObject(session_config, "instructions", "You are a helpful voice assistant.");
-            cJSON_AddStringToObject(session_config, "voice", "alloy");
-            cJSON_AddNumberToObject(session_config, "temperature", 1.0);
-            
-            cJSON_AddItemToObject(session_update, "session", session_config);
-            
-            char *session_json = cJSON_PrintUnformatted(session_update);
-            if (!session_json) {
+            json_writer_begin_object(&w, "session");
+            json_writer_begin_array(&w, "modalities");
+            json_writer_string(&w, NULL, "text"); // Enable text modality
+            if (stream->audio_cb) {
+                json_writer_string(&w, NULL, "audio");
+            }
+            json_writer_end_array(&w);
+            json_writer_string(&w, "instructions", "You are a helpful voice assistant.");
+            json_writer_string(&w, "voice", "alloy");
+            json_writer_double(&w, "temperature", 1.0);
+            json_writer_string(&w, "input_audio_format", uplink_codec_openai_format(stream->codec));
+            if (stream->audio_cb) {
+                // Answer in speech; the caller's VAD ends each turn, as server VAD
+                // never hears the silence after the speech it is sent
+                json_writer_string(&w, "output_audio_format", "pcm16");
+                json_writer_null(&w, "turn_detection");
+            }
+            json_writer_end_object(&w);
+            json_writer_end_object(&w);
+            if (json_writer_finish(&w, &session_len) != ESP_OK) {
                 ESP_LOGE(TAG, "Failed to create session.update JSON");
-                cJSON_Delete(session_update);
                 break;
             }
             
             if (!stream->ws_client) {
                 ESP_LOGE(TAG, "WebSocket client is NULL, cannot send session.update");
-                free(session_json);
-                cJSON_Delete(session_update);
                 break;
             }
             
@@ -586,18 +814,15 @@ static void websocket_event_handler(void *handler_args, esp_event_base_t base, i
             
             ESP_LOGI(TAG, "Sending session.update to establish session...");
             ESP_LOGI(TAG, "Session.update JSON: %s", session_json);
-            ESP_LOGI(TAG, "JSON length: %d bytes, ws_client: %p", strlen(session_json), stream->ws_client);
+            ESP_LOGI(TAG, "JSON length: %d bytes, ws_client: %p", (int)session_len, stream->ws_client);
             
-            esp_err_t send_err = esp_websocket_client_send_text(stream->ws_client, session_json, strlen(session_json), portMAX_DELAY);
+            esp_err_t send_err = esp_websocket_client_send_text(stream->ws_client, session_json, session_len, portMAX_DELAY);
             if (send_err == ESP_OK) {
-                ESP_LOGI(TAG, "Successfully sent session.update (%d bytes)", strlen(session_json));
+                ESP_LOGI(TAG, "Successfully sent session.update (%d bytes)", (int)session_len);
             } else {
                 ESP_LOGE(TAG, "Failed to send session.update: %s (0x%x)", esp_err_to_name(send_err), send_err);
             }
             
-            free(session_json);
-            cJSON_Delete(session_update);
-            
             ESP_LOGI(TAG, "Waiting for session.created event from server...");
             break;
             
@@ -621,110 +846,16 @@ static void websocket_event_handler(void *handler_args, esp_event_base_t base, i
                 break;
             }
             
-            if (data->data_len > 0 && data->op_code == 0x01) { // Only handle text frames
-                // Handle fragmented WebSocket messages by buffering
-                // Append to message buffer
-                if (stream->message_buffer_len + data->data_len + 1 > stream->message_buffer_cap) {
-                    size_t new_cap = stream->message_buffer_cap == 0 ? 4096 : stream->message_buffer_cap * 2;
-                    while (stream->message_buffer_len + data->data_len + 1 > new_cap) {
-                        new_cap *= 2;
-                    }
-                    char *new_buf = realloc(stream->message_buffer, new_cap);
-                    if (!new_buf) {
-                        ESP_LOGE(TAG, "Failed to realloc message buffer");
-                        break;
-                    }
-                    stream->message_buffer = new_buf;
-                    stream->message_buffer_cap = new_cap;
-                }
-                
-                memcpy(stream->message_buffer + stream->message_buffer_len, data->data_ptr, data->data_len);
-                stream->message_buffer_len += data->data_len;
-                stream->message_buffer[stream->message_buffer_len] = '\0';
-                
-                // Try to parse JSON - if it fails, wait for more fragments
-                char *json_str = stream->message_buffer;
-                size_t json_len = stream->message_buffer_len;
-                
-                cJSON *event = cJSON_Parse(json_str);
-                if (event) {
-                    // Successfully parsed - this is a complete message
-                        cJSON *type = cJSON_GetObjectItem(event, "type");
-                        if (cJSON_IsString(type)) {
-                            const char *event_type = type->valuestring;
-                            
-                            // Log all events for debugging
-                            ESP_LOGI(TAG, "Received OpenAI event: %s (len=%d)", event_type, (int)data->data_len);
-                            // Also log first 200 chars of the full event for debugging
-                            if (data->data_len < 200) {
-                                ESP_LOGI(TAG, "Event data: %s", json_str);
-                            }
-                            
-                            // Handle session.created
-                            if (strcmp(event_type, "session.created") == 0) {
-                                cJSON *session = cJSON_GetObjectItem(event, "session");
-                                if (session) {
-                                    cJSON *id = cJSON_GetObjectItem(session, "id");
-                                    if (cJSON_IsString(id)) {
-                                        if (stream->session_id) free(stream->session_id);
-                                        stream->session_id = strdup(id->valuestring);
-                                        ESP_LOGI(TAG, "Session created: %s", stream->session_id);
-                                    }
-                                }
-                            }
-                            // Handle response.audio_transcript.delta (partial transcription)
-                            else if (strcmp(event_type, "response.audio_transcript.delta") == 0) {
-                                cJSON *delta = cJSON_GetObjectItem(event, "delta");
-                                if (delta && cJSON_IsString(delta) && delta->valuestring && strlen(delta->valuestring) > 0) {
-                                    // Forward to callback for console output
-                                    if (stream->transcript_cb) {
-                                        stream->transcript_cb(delta->valuestring, false, stream->cb_ctx);
-                                    }
-                                }
-                            }
-                            // Handle response.audio_transcript.done (final transcription)
-                            else if (strcmp(event_type, "response.audio_transcript.done") == 0) {
-                                cJSON *transcript = cJSON_GetObjectItem(event, "transcript");
-                                if (transcript && cJSON_IsString(transcript) && transcript->valuestring && strlen(transcript->valuestring) > 0) {
-                                    // Forward to callback for console output
-                                    if (stream->transcript_cb) {
-                                        stream->transcript_cb(transcript->valuestring, true, stream->cb_ctx);
-                                    }
-                                }
-                            }
-                            // Handle error events
-                            else if (strcmp(event_type, "error") == 0) {
-                                cJSON *error_obj = cJSON_GetObjectItem(event, "error");
-                                ESP_LOGE(TAG, "OpenAI error: %s", json_str);
-                                if (stream->error_cb) {
-                                    stream->error_cb(ESP_FAIL, stream->cb_ctx);
-                                }
-                                (void)error_obj; // Suppress unused variable warning
-                            }
-                            // Log unhandled events
-                            else {
-                                ESP_LOGI(TAG, "Unhandled event type: %s", event_type);
-                            }
-                        } else {
-                            // Log if we can't parse event type
-                            ESP_LOGW(TAG, "Received event without type field: %s", json_str);
-                        }
-                        cJSON_Delete(event);
-                    // Reset message buffer for next message
-                    stream->message_buffer_len = 0;
-                } else {
-                    // JSON parse failed - might be incomplete fragment, wait for more
-                    // Log if buffer is getting very large (might be malformed or stuck)
-                    if (stream->message_buffer_len > 10000) {
-                        ESP_LOGW(TAG, "Failed to parse JSON after %d bytes, resetting buffer: %.200s", (int)json_len, json_str);
-                        // Reset buffer if too large to avoid memory issues
-                        stream->message_buffer_len = 0;
-                    } else if (stream->message_buffer_len > 500) {
-                        // Log that we're buffering fragments
-                        ESP_LOGD(TAG, "Buffering WebSocket fragment (total=%d bytes)", (int)stream->message_buffer_len);
-                    }
-                }
+            if (data->data_len <= 0 || data->op_code != 0x01) { // Only handle text frames
+                break;
+            }
+            // Messages larger than the client's buffer come in several events
+            if (data->payload_offset == 0) {
+                stream->message_buffer_len = 0;
+                stream->rx_state = REALTIME_RX_JSON;
             }
+            realtime_receive(stream, data->data_ptr, data->data_len,
+                             data->payload_offset + data->data_len >= data->payload_len);
             break;
             
         case WEBSOCKET_EVENT_ERROR:
@@ -739,6 +870,62 @@ static void websocket_event_handler(void *handler_args, esp_event_base_t base, i
     }
 }
 
+// Close a speech turn; the audio queued before it has already been sent
+static void realtime_send_turn_end(struct openai_realtime_stream *stream, bool reply)
+{
+    if (!stream->connected || !stream->ws_client || !stream->session_id) {
+        ESP_LOGW(TAG, "No session, dropping end of turn");
+        return;
+    }
+    int sent;
+    if (reply) {
+        sent = esp_websocket_client_send_text(stream->ws_client, COMMIT_EVENT, sizeof(COMMIT_EVENT) - 1,
+                                              pdMS_TO_TICKS(100));
+        if (sent >= 0) {
+            sent = esp_websocket_client_send_text(stream->ws_client, RESPONSE_EVENT, sizeof(RESPONSE_EVENT) - 1,
+                                                  pdMS_TO_TICKS(100));
+        }
+    } else {
+        sent = esp_websocket_client_send_text(stream->ws_client, CLEAR_EVENT, sizeof(CLEAR_EVENT) - 1,
+                                              pdMS_TO_TICKS(100));
+    }
+    if (sent < 0) {
+        ESP_LOGW(TAG, "Failed to send end of turn");
+    }
+}
+
+// Between turns: the input format the link calls for, announced before its audio
+static void realtime_pick_codec(struct openai_realtime_stream *stream, uplink_link_level_t level)
+{
+    uplink_codec_id_t codec = level == UPLINK_LINK_POOR ? UPLINK_CODEC_MULAW : stream->configured_codec;
+    if (codec == stream->codec) {
+        return;
+    }
+    int wire_rate_hz = codec == UPLINK_CODEC_MULAW ? REALTIME_G711_RATE_HZ : stream->sample_rate_hz;
+    uplink_codec_encoder_t encoder;
+    if (uplink_codec_init(&encoder, codec, stream->sample_rate_hz, wire_rate_hz) != ESP_OK) {
+        return;
+    }
+    char json[128];
+    size_t len = 0;
+    json_writer_t w;
+    json_writer_init(&w, json, sizeof(json));
+    json_writer_begin_object(&w, NULL);
+    json_writer_string(&w, "type", "session.update");
+    json_writer_begin_object(&w, "session");
+    json_writer_string(&w, "input_audio_format", uplink_codec_openai_format(codec));
+    json_writer_end_object(&w);
+    json_writer_end_object(&w);
+    if (json_writer_finish(&w, &len) != ESP_OK ||
+        esp_websocket_client_send_text(stream->ws_client, json, len, pdMS_TO_TICKS(100)) < 0) {
+        ESP_LOGW(TAG, "Failed to switch the uplink to %s", uplink_codec_openai_format(codec));
+        return;
+    }
+    stream->encoder = encoder;
+    stream->codec = codec;
+    ESP_LOGI(TAG, "Uplink now %s @ %d Hz", uplink_codec_openai_format(codec), wire_rate_hz);
+}
+
 // Audio streaming task
 static void realtime_audio_task(void *arg)
 {
@@ -748,16 +935,25 @@ static void realtime_audio_task(void *arg)
         return;
     }
     
-    int16_t audio_buffer[512]; // Chunk size for streaming
-    size_t sample_size = sizeof(int16_t);
-    size_t samples_per_chunk = sample_size > 0 ? sizeof(audio_buffer) / sample_size : 512;
+    realtime_chunk_t chunk;
+    const uint32_t chunk_ms = REALTIME_CHUNK_SAMPLES * 1000 / (uint32_t)stream->sample_rate_hz;
     
     static int audio_sent_count = 0;
     static int audio_receive_count = 0;
     
     while (!stream->stop_requested) {
+        if (stream->audio_cb && !stream->session_id) {
+            // A speech session holds what was said while it connected: the first words are the question
+            vTaskDelay(pdMS_TO_TICKS(10));
+            continue;
+        }
         // Wait for audio data from queue
-        if (xQueueReceive(stream->audio_queue, audio_buffer, pdMS_TO_TICKS(100)) == pdTRUE) {
+        if (xQueueReceive(stream->audio_queue, &chunk, pdMS_TO_TICKS(100)) == pdTRUE) {
+            if (chunk.sample_count == 0) {
+                realtime_send_turn_end(stream, chunk.reply);
+                stream->turn_open = false;
+                continue;
+            }
             audio_receive_count++;
             
             // Only send audio if WebSocket is connected AND session is created
@@ -769,49 +965,79 @@ static void realtime_audio_task(void *arg)
                     stream->connected = false;
                     // Don't send, will retry after reconnection
                 } else {
-                    // Base64 encode audio
-                    char *b64 = NULL;
-                    size_t audio_bytes = samples_per_chunk * sizeof(int16_t);
-                    esp_err_t err = base64_encode_alloc((const uint8_t *)audio_buffer, audio_bytes, &b64);
+                    size_t queued = uxQueueMessagesWaiting(stream->audio_queue);
+                    uplink_link_level_t level = uplink_link_update(&stream->link, queued);
+                    int64_t now_us = esp_timer_get_time();
+                    // The input format is the session's: it changes only between turns,
+                    // or after a gap once server VAD has closed the last one
+                    if (!stream->turn_open || now_us - stream->last_audio_us > REALTIME_IDLE_TURN_US) {
+                        realtime_pick_codec(stream, level);
+                        stream->turn_open = true;
+                    }
+                    stream->last_audio_us = now_us;
+                    
+                    // Run the uplink codec over a batch sized for the link, then base64
+                    // into the preallocated append frame
+                    size_t batch = uplink_link_batch(&stream->link, queued);
+                    size_t samples = 0;
+                    size_t audio_bytes = 0;
+                    bool end = false;
+                    for (size_t i = 1;; ++i) {
+                        audio_bytes += uplink_codec_encode(&stream->encoder, chunk.samples, chunk.sample_count,
+                                                           stream->encoded + audio_bytes);
+                        samples += chunk.sample_count;
+                        if (i == batch) {
+                            break;
+                        }
+                        // A good link's batch waits for audio still being spoken; a catch-up one takes what is queued
+                        TickType_t wait = level == UPLINK_LINK_GOOD ? pdMS_TO_TICKS(2 * chunk_ms) : 0;
+                        if (xQueueReceive(stream->audio_queue, &chunk, wait) != pdTRUE) {
+                            break;
+                        }
+                        if (chunk.sample_count == 0) {
+                            end = true;
+                            break;
+                        }
+                    }
+                    deadline_monitor_begin(stream->deadline);
+                    size_t frame_len = 0;
+                    esp_err_t err = encode_append_frame(stream->append_frame, stream->append_frame_cap,
+                                                        stream->encoded, audio_bytes, &frame_len);
                     
-                    if (err == ESP_OK && b64) {
-                        // Create input_audio_buffer.append event
-                        // OpenAI Realtime API format: {"type": "input_audio_buffer.append", "audio": "<base64>"}
-                        cJSON *event = cJSON_CreateObject();
-                        cJSON_AddStringToObject(event, "type", "input_audio_buffer.append");
-                        cJSON_AddStringToObject(event, "audio", b64);
-                        
-                        char *event_json = cJSON_PrintUnformatted(event);
-                        if (event_json) {
-                            // Use shorter timeout to avoid blocking if WebSocket is stuck
-                            esp_err_t send_err = esp_websocket_client_send_text(stream->ws_client, event_json, strlen(event_json), pdMS_TO_TICKS(100));
-                            if (send_err == ESP_OK) {
-                                audio_sent_count++;
-                                // Log every 50 chunks sent (about every 2-3 seconds at 24kHz)
-                                if (audio_sent_count % 50 == 0) {
-                                    ESP_LOGI(TAG, "Audio sent to OpenAI: %d chunks (received %d from queue)", audio_sent_count, audio_receive_count);
-                                }
-                            } else {
-                                // Check if it's a connection error (0x587 = ESP_ERR_WS_SEND_FRAME_FAILED)
-                                if (send_err == 0x587 || send_err == ESP_ERR_INVALID_STATE || send_err == ESP_FAIL) {
-                                    ESP_LOGW(TAG, "WebSocket send failed, marking disconnected: %s (0x%x)", 
-                                            esp_err_to_name(send_err), send_err);
-                                    stream->connected = false;
-                                }
-                                // Only log occasionally to avoid spam
-                                static int fail_count = 0;
-                                if (++fail_count % 50 == 0) {
-                                    ESP_LOGW(TAG, "Failed to send audio (count=%d): %s (0x%x)", 
-                                            fail_count, esp_err_to_name(send_err), send_err);
-                                }
+                    if (err == ESP_OK) {
+                        // Use shorter timeout to avoid blocking if WebSocket is stuck
+                        int64_t send_start_us = esp_timer_get_time();
+                        esp_err_t send_err = esp_websocket_client_send_text(stream->ws_client, stream->append_frame, frame_len, pdMS_TO_TICKS(100));
+                        uplink_link_note_send(&stream->link, (uint32_t)(samples * 1000 / (size_t)stream->sample_rate_hz),
+                                              esp_timer_get_time() - send_start_us, send_err >= 0);
+                        if (send_err >= 0) {
+                            audio_sent_count++;
+                            // Log every 50 chunks sent (about every 2-3 seconds at 24kHz)
+                            if (audio_sent_count % 50 == 0) {
+                                ESP_LOGI(TAG, "Audio sent to OpenAI: %d chunks (received %d from queue)", audio_sent_count, audio_receive_count);
+                            }
+                        } else {
+                            // Check if it's a connection error (0x587 = ESP_ERR_WS_SEND_FRAME_FAILED)
+                            if (send_err == 0x587 || send_err == ESP_ERR_INVALID_STATE || send_err == ESP_FAIL) {
+                                ESP_LOGW(TAG, "WebSocket send failed, marking disconnected: %s (0x%x)", 
+                                        esp_err_to_name(send_err), send_err);
+                                stream->connected = false;
+                            }
+                            // Only log occasionally to avoid spam
+                            static int fail_count = 0;
+                            if (++fail_count % 50 == 0) {
+                                ESP_LOGW(TAG, "Failed to send audio (count=%d): %s (0x%x)", 
+                                        fail_count, esp_err_to_name(send_err), send_err);
                             }
-                            free(event_json);
                         }
-                        cJSON_Delete(event);
-                        free(b64);
                     } else {
                         ESP_LOGW(TAG, "Base64 encode failed: %s", esp_err_to_name(err));
                     }
+                    deadline_monitor_end(stream->deadline);
+                    if (end) {
+                        realtime_send_turn_end(stream, chunk.reply);
+                        stream->turn_open = false;
+                    }
                 }
             } else {
                 // Log why we're not sending - only occasionally
@@ -824,20 +1050,24 @@ static void realtime_audio_task(void *arg)
         }
     }
     
+    task_placement_note_exit(TASK_PLACEMENT_OPENAI_UPLINK);
     vTaskDelete(NULL);
 }
 
-openai_realtime_handle_t openai_realtime_start(int sample_rate_hz,
-                                                openai_realtime_transcript_cb_t transcript_cb,
-                                                openai_realtime_error_cb_t error_cb,
-                                                void *cb_ctx)
+static openai_realtime_handle_t realtime_start(int sample_rate_hz,
+                                               uplink_codec_id_t codec,
+                                               openai_realtime_transcript_cb_t transcript_cb,
+                                               openai_realtime_audio_cb_t audio_cb,
+                                               openai_realtime_error_cb_t error_cb,
+                                               void *cb_ctx)
 {
     ESP_RETURN_ON_FALSE(sample_rate_hz > 0 && transcript_cb, NULL, TAG, "bad args");
     
-    struct openai_realtime_stream *stream = calloc(1, sizeof(struct openai_realtime_stream));
+    struct openai_realtime_stream *stream = MEM_TAG_CALLOC(MEM_TAG_OPENAI, 1, sizeof(struct openai_realtime_stream));
     ESP_RETURN_ON_FALSE(stream, NULL, TAG, "alloc failed");
     
     stream->transcript_cb = transcript_cb;
+    stream->audio_cb = audio_cb;
     stream->error_cb = error_cb;
     stream->cb_ctx = cb_ctx;
     stream->sample_rate_hz = sample_rate_hz;
@@ -847,10 +1077,39 @@ openai_realtime_handle_t openai_realtime_start(int sample_rate_hz,
     stream->message_buffer_len = 0;
     stream->message_buffer_cap = 0;
     
+    stream->codec = codec;
+    stream->configured_codec = codec;
+    int wire_rate_hz = codec == UPLINK_CODEC_MULAW ? REALTIME_G711_RATE_HZ : sample_rate_hz;
+    if (uplink_codec_init(&stream->encoder, codec, sample_rate_hz, wire_rate_hz) != ESP_OK) {
+        goto err_cleanup;
+    }
+    // The configured format is the largest this stream sends
+    stream->encoded_cap = uplink_codec_max_encoded_bytes(&stream->encoder,
+                                                         (size_t)REALTIME_CHUNK_SAMPLES * CONFIG_KVA_UPLINK_BATCH_MAX);
+    uplink_link_init(&stream->link, "OpenAI Realtime", REALTIME_QUEUE_DEPTH);
+    const deadline_monitor_config_t deadline = {
+        .name = "uplink",
+        .budget_us = (uint32_t)((int64_t)REALTIME_CHUNK_SAMPLES * 1000000 / sample_rate_hz),
+    };
+    deadline_monitor_register(&deadline, &stream->deadline);
+    stream->encoded = MEM_TAG_MALLOC(MEM_TAG_OPENAI, stream->encoded_cap);
+    if (!stream->encoded) {
+        ESP_LOGE(TAG, "encoded chunk alloc failed");
+        goto err_cleanup;
+    }
+    
+    // One send buffer for every append event (~1.4 KB per 512 PCM16 samples, ~0.4 KB as 8 kHz mu-law)
+    stream->append_frame_cap = append_frame_capacity(stream->encoded_cap);
+    stream->append_frame = MEM_TAG_MALLOC(MEM_TAG_OPENAI, stream->append_frame_cap);
+    if (!stream->append_frame) {
+        ESP_LOGE(TAG, "append frame alloc failed");
+        goto err_cleanup;
+    }
+    
     // Check available heap before creating queue
     uint32_t free_heap = esp_get_free_heap_size();
-    size_t queue_item_size = sizeof(int16_t) * 512;
-    size_t queue_size = 30;  // Reduced from 50 to save memory
+    size_t queue_item_size = sizeof(realtime_chunk_t);
+    size_t queue_size = REALTIME_QUEUE_DEPTH;  // Reduced from 50 to save memory
     size_t queue_memory_needed = queue_size * queue_item_size;
     
     ESP_LOGI(TAG, "Free heap before queue: %" PRIu32 " bytes, queue needs: %zu bytes", 
@@ -876,7 +1135,7 @@ openai_realtime_handle_t openai_realtime_start(int sample_rate_hz,
     // Build WebSocket URL
     char ws_url[256];
     snprintf(ws_url, sizeof(ws_url), 
-             "wss://api.openai.com/v1/realtime?model=gpt-4o-realtime-preview-2024-10-01&sample_rate=%d",
+             OPENAI_WS_ORIGIN "/v1/realtime?model=gpt-4o-realtime-preview-2024-10-01&sample_rate=%d",
              sample_rate_hz);
     
     // Build Authorization header - must be terminated with \r\n
@@ -904,9 +1163,11 @@ openai_realtime_handle_t openai_realtime_start(int sample_rate_hz,
     }
     
     // Start audio streaming task
-    xTaskCreatePinnedToCore(realtime_audio_task, "openai_realtime_audio", 4096, stream, 5, &stream->task, 1);
+    // Encoding runs here, away from the capture/AFE core
+    task_placement_create(TASK_PLACEMENT_OPENAI_UPLINK, realtime_audio_task, stream, &stream->task);
     
-    ESP_LOGI(TAG, "OpenAI Realtime API started (sample_rate=%d Hz)", sample_rate_hz);
+    ESP_LOGI(TAG, "OpenAI Realtime API started (sample_rate=%d Hz, uplink %s @ %d Hz, %s replies)",
+             sample_rate_hz, uplink_codec_openai_format(codec), wire_rate_hz, audio_cb ? "spoken" : "text");
     return stream;
     
 err_cleanup:
@@ -921,34 +1182,53 @@ err_cleanup:
         free(stream->session_id);
     }
     if (stream->message_buffer) {
-        free(stream->message_buffer);
+        MEM_TAG_FREE(MEM_TAG_OPENAI, stream->message_buffer);
     }
-    free(stream);
+    MEM_TAG_FREE(MEM_TAG_OPENAI, stream->append_frame);
+    MEM_TAG_FREE(MEM_TAG_OPENAI, stream->encoded);
+    MEM_TAG_FREE(MEM_TAG_OPENAI, stream);
     return NULL;
 }
 
+openai_realtime_handle_t openai_realtime_start(int sample_rate_hz,
+                                                uplink_codec_id_t codec,
+                                                openai_realtime_transcript_cb_t transcript_cb,
+                                                openai_realtime_error_cb_t error_cb,
+                                                void *cb_ctx)
+{
+    return realtime_start(sample_rate_hz, codec, transcript_cb, NULL, error_cb, cb_ctx);
+}
+
+openai_realtime_handle_t openai_realtime_start_speech(int sample_rate_hz,
+                                                      uplink_codec_id_t codec,
+                                                      openai_realtime_transcript_cb_t transcript_cb,
+                                                      openai_realtime_audio_cb_t audio_cb,
+                                                      openai_realtime_error_cb_t error_cb,
+                                                      void *cb_ctx)
+{
+    ESP_RETURN_ON_FALSE(audio_cb, NULL, TAG, "bad args");
+    return realtime_start(sample_rate_hz, codec, transcript_cb, audio_cb, error_cb, cb_ctx);
+}
+
 esp_err_t openai_realtime_send_audio(openai_realtime_handle_t handle, const int16_t *pcm_samples, size_t sample_count)
 {
     ESP_RETURN_ON_FALSE(handle && pcm_samples && sample_count > 0, ESP_ERR_INVALID_ARG, TAG, "bad args");
     
-    if (!handle->connected || !handle->audio_queue) {
+    // Speech sessions queue audio before they connect; the uplink task waits for the session
+    if ((!handle->connected && !handle->audio_cb) || !handle->audio_queue) {
         return ESP_ERR_INVALID_STATE;
     }
     
     // Send audio in chunks
-    size_t chunk_size = 512;
+    size_t chunk_size = REALTIME_CHUNK_SAMPLES;
     for (size_t i = 0; i < sample_count; i += chunk_size) {
         size_t to_send = (sample_count - i > chunk_size) ? chunk_size : (sample_count - i);
-        int16_t chunk[512];
-        memcpy(chunk, &pcm_samples[i], to_send * sizeof(int16_t));
-        
-        // Pad if needed
-        if (to_send < chunk_size) {
-            memset(&chunk[to_send], 0, (chunk_size - to_send) * sizeof(int16_t));
-        }
+        realtime_chunk_t chunk;
+        memcpy(chunk.samples, &pcm_samples[i], to_send * sizeof(int16_t));
+        chunk.sample_count = (uint16_t)to_send;
         
         // Use timeout to avoid blocking, but allow some wait time
-        if (xQueueSend(handle->audio_queue, chunk, pdMS_TO_TICKS(10)) != pdTRUE) {
+        if (xQueueSend(handle->audio_queue, &chunk, pdMS_TO_TICKS(10)) != pdTRUE) {
             static int drop_count = 0;
             if (++drop_count % 100 == 0) {
                 ESP_LOGW(TAG, "Audio queue full, dropping samples (total drops: %d)", drop_count);
@@ -959,6 +1239,17 @@ esp_err_t openai_realtime_send_audio(openai_realtime_handle_t handle, const int1
     return ESP_OK;
 }
 
+esp_err_t openai_realtime_end_audio(openai_realtime_handle_t handle, bool reply)
+{
+    ESP_RETURN_ON_FALSE(handle, ESP_ERR_INVALID_ARG, TAG, "bad args");
+    if (!handle->audio_queue) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    // Queued behind the turn's audio, so the commit never overtakes it
+    realtime_chunk_t end = {.sample_count = 0, .reply = reply};
+    return xQueueSend(handle->audio_queue, &end, 0) == pdTRUE ? ESP_OK : ESP_ERR_TIMEOUT;
+}
+
 esp_err_t openai_realtime_stop(openai_realtime_handle_t handle)
 {
     ESP_RETURN_ON_FALSE(handle, ESP_ERR_INVALID_ARG, TAG, "bad args");
@@ -987,10 +1278,12 @@ esp_err_t openai_realtime_stop(openai_realtime_handle_t handle)
     }
     
     if (handle->message_buffer) {
-        free(handle->message_buffer);
+        MEM_TAG_FREE(MEM_TAG_OPENAI, handle->message_buffer);
         handle->message_buffer = NULL;
     }
     
-    free(handle);
+    MEM_TAG_FREE(MEM_TAG_OPENAI, handle->append_frame);
+    MEM_TAG_FREE(MEM_TAG_OPENAI, handle->encoded);
+    MEM_TAG_FREE(MEM_TAG_OPENAI, handle);
     return ESP_OK;
 }
@@ -5,6 +5,7 @@
 #include <stdint.h>
 
 #include "esp_err.h"
+#include "uplink_codec.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -19,12 +20,25 @@ typedef struct {
 // Callback for streaming SSE events
 typedef void (*openai_stream_callback_t)(const char *text, bool is_done, void *ctx);
 
+// Receives consecutive pieces of a synthesized WAV as they download
+typedef esp_err_t (*openai_tts_chunk_cb_t)(const uint8_t *data, size_t len, void *ctx);
+
+// Realtime reply audio is 24 kHz mono PCM16; the API sends no other rate
+#define OPENAI_REALTIME_OUTPUT_RATE_HZ 24000
+
 // Callback for realtime transcription events
 typedef void (*openai_realtime_transcript_cb_t)(const char *text, bool is_final, void *ctx);
 typedef void (*openai_realtime_error_cb_t)(esp_err_t error, void *ctx);
+// Reply audio as it decodes, at OPENAI_REALTIME_OUTPUT_RATE_HZ; pcm is NULL once the reply's audio is complete
+typedef void (*openai_realtime_audio_cb_t)(const int16_t *pcm, size_t sample_count, void *ctx);
+
+// False when the build has no API key, so no request can succeed
+bool openai_has_api_key(void);
 
 esp_err_t openai_transcribe_wav(const int16_t *pcm_samples, size_t sample_count, int sample_rate_hz, openai_transcription_t *result);
 esp_err_t openai_tts_generate(const char *text, const char *voice, uint8_t *out_wav, size_t max_out, size_t *bytes_written);
+// Streaming TTS: WAV bytes are handed to on_chunk as they arrive
+esp_err_t openai_tts_generate_stream(const char *text, const char *voice, openai_tts_chunk_cb_t on_chunk, void *ctx);
 esp_err_t openai_generate_text_response(const char *prompt, char *out_text, size_t out_len);
 
 // Stream audio to OpenAI with SSE responses
@@ -34,11 +48,25 @@ esp_err_t openai_stream_audio(const int16_t *pcm_samples, size_t sample_count, i
 // Realtime API: Stream AFE-processed audio to OpenAI via WebSocket
 typedef struct openai_realtime_stream *openai_realtime_handle_t;
 
+// codec selects input_audio_format; mu-law is sent as 8 kHz g711_ulaw (16 kHz input is decimated)
 openai_realtime_handle_t openai_realtime_start(int sample_rate_hz,
+                                                uplink_codec_id_t codec,
                                                 openai_realtime_transcript_cb_t transcript_cb,
                                                 openai_realtime_error_cb_t error_cb,
                                                 void *cb_ctx);
+// Speech-to-speech: the model answers in audio, handed to audio_cb while the
+// response streams, so no separate LLM or TTS request is made. transcript_cb
+// gets the transcript of the reply. The server does not detect turns; end
+// each one with openai_realtime_end_audio().
+openai_realtime_handle_t openai_realtime_start_speech(int sample_rate_hz,
+                                                      uplink_codec_id_t codec,
+                                                      openai_realtime_transcript_cb_t transcript_cb,
+                                                      openai_realtime_audio_cb_t audio_cb,
+                                                      openai_realtime_error_cb_t error_cb,
+                                                      void *cb_ctx);
 esp_err_t openai_realtime_send_audio(openai_realtime_handle_t handle, const int16_t *pcm_samples, size_t sample_count);
+// Close the turn after the audio already queued: commit it and ask for a reply, or drop it
+esp_err_t openai_realtime_end_audio(openai_realtime_handle_t handle, bool reply);
 esp_err_t openai_realtime_stop(openai_realtime_handle_t handle);
 
 #ifdef __cplusplus
@@ -7,8 +7,12 @@
  */
 
 #include "openwakeword.h"
+#include "openwakeword_stats.h"
+#include "model_loader.h"
+#include "esp_http_client.h"
 #include "wake_word_service.h"
 #include "esp_log.h"
+#include <inttypes.h>
 
 static const char *TAG = "oww_integration";
 
@@ -90,6 +94,97 @@ void example_process_audio_with_openwakeword(wake_word_service_t *service,
     }
 }
 
+// Example: Log detector performance, e.g. every 10 s from a monitor task.
+// If your capture loop discards frames while detection is behind, report
+// them with openwakeword_note_dropped() so they show up here.
+void example_log_openwakeword_stats(wake_word_service_t *service)
+{
+    static const char *stage_names[OPENWAKEWORD_STAGE_COUNT] = {"frontend", "embedding", "classifier", "events"};
+    openwakeword_stats_t stats;
+    
+    if (!service->use_openwakeword || openwakeword_get_stats(service->oww_handle, &stats) != ESP_OK) {
+        return;
+    }
+    
+    ESP_LOGI(TAG, "OWW: %" PRIu32 " frames, RTF %.3f, worst frame %" PRIu32 " us, "
+             "%" PRIu32 " dropped, %" PRIu32 " embedding steps skipped",
+             stats.total_frames_processed, stats.real_time_factor, stats.max_frame_us,
+             stats.frames_dropped, stats.embedding_steps_skipped);
+    for (int i = 0; i < OPENWAKEWORD_STAGE_COUNT; i++) {
+        const openwakeword_stage_stats_t *stage = &stats.stages[i];
+        if (stage->count == 0) {
+            continue;
+        }
+        ESP_LOGI(TAG, "  %-10s mean %" PRIu64 " us, p50 <%" PRIu32 " us, p99 <%" PRIu32 " us, max %" PRIu32 " us",
+                 stage_names[i], stage->total_us / stage->count,
+                 openwakeword_stats_percentile_us(stage, 50.0f),
+                 openwakeword_stats_percentile_us(stage, 99.0f), stage->max_us);
+    }
+    for (size_t i = 0; i < stats.score_count; i++) {
+        const openwakeword_score_stats_t *score = &stats.scores[i];
+        ESP_LOGI(TAG, "  %s score: last %.3f, average %.3f, peak %.3f",
+                 score->name ? score->name : "?", score->last, score->ewma, score->peak);
+    }
+}
+
+// Example: Replace the wake word model from a URL without rebooting, e.g.
+// from a task started by a fleet command. The URL serves an image from
+// scripts/pack_model_partition.py. It streams into the spare model
+// partition in 4 KB chunks, then the detector switches over between two
+// frames and keeps listening throughout.
+esp_err_t example_update_openwakeword_model(wake_word_service_t *service, const char *url)
+{
+    if (!service->use_openwakeword) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    esp_http_client_config_t http_config = {
+        .url = url,
+        .timeout_ms = 10000,
+    };
+    esp_http_client_handle_t client = esp_http_client_init(&http_config);
+    if (!client) {
+        return ESP_ERR_NO_MEM;
+    }
+    
+    esp_err_t err = esp_http_client_open(client, 0);
+    int64_t length = err == ESP_OK ? esp_http_client_fetch_headers(client) : -1;
+    int status = esp_http_client_get_status_code(client);
+    if (err != ESP_OK || length <= 0 || status != 200) {
+        ESP_LOGE(TAG, "Model download failed: %s, HTTP %d, %" PRId64 " bytes",
+                 esp_err_to_name(err), status, length);
+        esp_http_client_cleanup(client);
+        return err != ESP_OK ? err : ESP_FAIL;
+    }
+    
+    // Never the partition the running model is mapped from
+    const char *partition = openwakeword_spare_partition(service->oww_handle);
+    model_loader_writer_t writer;
+    err = model_loader_write_begin(partition, (size_t)length, &writer);
+    
+    static uint8_t chunk[4096];
+    while (err == ESP_OK && writer.written < writer.image_size) {
+        int n = esp_http_client_read(client, (char *)chunk, sizeof(chunk));
+        if (n <= 0) {
+            err = ESP_ERR_INVALID_SIZE;
+            break;
+        }
+        err = model_loader_write(&writer, chunk, (size_t)n);
+    }
+    esp_http_client_cleanup(client);
+    
+    if (err == ESP_OK) {
+        err = model_loader_write_finish(&writer);
+    }
+    if (err == ESP_OK) {
+        err = openwakeword_swap_model(service->oww_handle, partition);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Model update from %s failed: %s", url, esp_err_to_name(err));
+    }
+    return err;
+}
+
 // Example: Cleanup in wake_word_service_stop()
 void example_cleanup_openwakeword(wake_word_service_t *service)
 {
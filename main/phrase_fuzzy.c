@@ -0,0 +1,217 @@
+#include "phrase_fuzzy.h"
+
+#include <ctype.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "esp_check.h"
+
+static const char *TAG = "phrase_fuzzy";
+
+// Words of a text considered; commands come well within it
+#define PHRASE_FUZZY_MAX_WORDS 32
+
+typedef struct {
+    uint8_t len;                      // Bytes once normalised
+    uint8_t words;
+    uint8_t budget;                   // Most edits accepted
+} phrase_entry_t;
+
+struct phrase_fuzzy {
+    uint8_t class_of[256];            // Byte -> alphabet class; 0 for bytes in no phrase
+    size_t classes;
+    size_t count;
+    phrase_entry_t *entries;
+    uint64_t *peq;                    // count x classes: bit i set where byte i of the phrase is in the class
+};
+
+typedef struct {
+    size_t start;
+    size_t len;
+} word_t;
+
+static bool is_word_byte(unsigned char c)
+{
+    return isalnum(c) || c == '\'';
+}
+
+// Lowercase words joined by single spaces; returns the length, or size + 1 when it does not fit
+static size_t normalize(const char *in, char *out, size_t size)
+{
+    size_t len = 0;
+    bool gap = false;
+    for (const unsigned char *p = (const unsigned char *)in; *p; ++p) {
+        if (!is_word_byte(*p)) {
+            gap = len > 0;
+            continue;
+        }
+        if (len + (gap ? 2 : 1) > size) {
+            return size + 1;
+        }
+        if (gap) {
+            out[len++] = ' ';
+            gap = false;
+        }
+        out[len++] = (char)tolower(*p);
+    }
+    return len;
+}
+
+esp_err_t phrase_fuzzy_create(const char *const *phrases, size_t count, uint8_t chars_per_edit,
+                              phrase_fuzzy_t **out)
+{
+    ESP_RETURN_ON_FALSE(phrases && count > 0 && chars_per_edit > 0 && out, ESP_ERR_INVALID_ARG, TAG, "bad args");
+    *out = NULL;
+    phrase_fuzzy_t *f = calloc(1, sizeof(*f));
+    ESP_RETURN_ON_FALSE(f, ESP_ERR_NO_MEM, TAG, "fuzzy alloc");
+
+    esp_err_t ret = ESP_OK;
+    char (*text)[PHRASE_FUZZY_MAX_LEN] = malloc(count * sizeof(*text));
+    f->entries = calloc(count, sizeof(*f->entries));
+    ESP_GOTO_ON_FALSE(text && f->entries, ESP_ERR_NO_MEM, fail, TAG, "phrase alloc");
+    f->count = count;
+
+    // Alphabet over the normalised phrases, both cases of a letter in one class
+    f->classes = 1;
+    for (size_t i = 0; i < count; ++i) {
+        ESP_GOTO_ON_FALSE(phrases[i], ESP_ERR_INVALID_ARG, fail, TAG, "phrase %u missing", (unsigned)i);
+        size_t len = normalize(phrases[i], text[i], PHRASE_FUZZY_MAX_LEN);
+        ESP_GOTO_ON_FALSE(len > 0, ESP_ERR_INVALID_ARG, fail, TAG, "phrase %u has no words", (unsigned)i);
+        ESP_GOTO_ON_FALSE(len <= PHRASE_FUZZY_MAX_LEN, ESP_ERR_INVALID_SIZE, fail, TAG, "phrase %u too long",
+                          (unsigned)i);
+        phrase_entry_t *e = &f->entries[i];
+        e->len = (uint8_t)len;
+        e->words = 1;
+        e->budget = (uint8_t)(len / chars_per_edit);
+        for (size_t j = 0; j < len; ++j) {
+            uint8_t c = (uint8_t)text[i][j];
+            e->words += c == ' ';
+            if (f->class_of[c] == 0) {
+                f->class_of[c] = (uint8_t)f->classes;
+                f->class_of[(uint8_t)toupper(c)] = (uint8_t)f->classes;
+                f->classes++;
+            }
+        }
+    }
+
+    f->peq = calloc(count * f->classes, sizeof(uint64_t));
+    ESP_GOTO_ON_FALSE(f->peq, ESP_ERR_NO_MEM, fail, TAG, "masks alloc");
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t *peq = &f->peq[i * f->classes];
+        for (size_t j = 0; j < f->entries[i].len; ++j) {
+            peq[f->class_of[(uint8_t)text[i][j]]] |= 1ull << j;
+        }
+    }
+    free(text);
+    *out = f;
+    return ESP_OK;
+
+fail:
+    free(text);
+    phrase_fuzzy_destroy(f);
+    return ret;
+}
+
+void phrase_fuzzy_destroy(phrase_fuzzy_t *fuzzy)
+{
+    if (!fuzzy) {
+        return;
+    }
+    free(fuzzy->entries);
+    free(fuzzy->peq);
+    free(fuzzy);
+}
+
+/**
+ * Levenshtein distance between a phrase and words [0, n) of text joined by
+ * single spaces (Myers 1999, in Hyyro's formulation). Bit i of the vertical
+ * deltas pv/mv says whether row i of the current DP column is one more or
+ * one less than row i - 1; the bottom row, tracked in score, is the
+ * distance so far. Bits above the phrase only take carries and never reach
+ * back down.
+ */
+static unsigned edit_distance(const phrase_fuzzy_t *f, size_t phrase, const char *text, const word_t *words,
+                              size_t n)
+{
+    const uint64_t *peq = &f->peq[phrase * f->classes];
+    const unsigned m = f->entries[phrase].len;
+    const uint64_t high = 1ull << (m - 1);
+    uint64_t pv = ~0ull;
+    uint64_t mv = 0;
+    unsigned score = m;
+    for (size_t w = 0; w < n; ++w) {
+        const char *p = text + words[w].start;
+        // The space before every word but the first
+        for (size_t j = w == 0; j <= words[w].len; ++j) {
+            uint8_t c = j == 0 ? ' ' : (uint8_t)tolower((unsigned char)p[j - 1]);
+            uint64_t eq = peq[f->class_of[c]];
+            uint64_t xv = eq | mv;
+            uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+            uint64_t ph = mv | ~(xh | pv);
+            uint64_t mh = pv & xh;
+            if (ph & high) {
+                score++;
+            } else if (mh & high) {
+                score--;
+            }
+            // Row 0 grows by one per text byte: the phrase is matched against the whole window
+            ph = (ph << 1) | 1;
+            mh <<= 1;
+            pv = mh | ~(xv | ph);
+            mv = ph & xv;
+        }
+    }
+    return score;
+}
+
+void phrase_fuzzy_find(const phrase_fuzzy_t *fuzzy, const char *text, phrase_fuzzy_match_t *out)
+{
+    *out = (phrase_fuzzy_match_t){.phrase = -1};
+    if (!fuzzy || !text) {
+        return;
+    }
+    word_t words[PHRASE_FUZZY_MAX_WORDS];
+    size_t prefix[PHRASE_FUZZY_MAX_WORDS + 1];  // Bytes of words before each, for window lengths
+    size_t n = 0;
+    prefix[0] = 0;
+    for (size_t i = 0; text[i] && n < PHRASE_FUZZY_MAX_WORDS;) {
+        if (!is_word_byte((unsigned char)text[i])) {
+            ++i;
+            continue;
+        }
+        words[n].start = i;
+        while (is_word_byte((unsigned char)text[i])) {
+            ++i;
+        }
+        words[n].len = i - words[n].start;
+        prefix[n + 1] = prefix[n] + words[n].len;
+        n++;
+    }
+
+    for (size_t i = 0; i < fuzzy->count; ++i) {
+        const phrase_entry_t *e = &fuzzy->entries[i];
+        for (size_t w = 0; w + e->words <= n; ++w) {
+            // A window whose length alone is over budget is not worth a pass
+            size_t len = prefix[w + e->words] - prefix[w] + e->words - 1;
+            size_t gap = len > e->len ? len - e->len : e->len - len;
+            if (gap > e->budget) {
+                continue;
+            }
+            unsigned d = edit_distance(fuzzy, i, text, &words[w], e->words);
+            if (d > e->budget) {
+                continue;
+            }
+            float confidence = 1.0f - (float)d / (float)e->len;
+            if (out->phrase < 0 || confidence > out->confidence) {
+                const word_t *last = &words[w + e->words - 1];
+                *out = (phrase_fuzzy_match_t){
+                    .phrase = (int)i,
+                    .distance = (uint8_t)d,
+                    .confidence = confidence,
+                    .end = last->start + last->len,
+                };
+            }
+        }
+    }
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Approximate phrase matching for misheard transcripts ("lights of" for
+ * "lights off"), the fallback behind phrase_matcher's exact substrings.
+ *
+ * Each phrase is compared with every run of as many words of the text,
+ * case-insensitively and with punctuation and extra spaces dropped, by
+ * Levenshtein distance. The distance comes from Myers' bit-vector
+ * algorithm: a phrase of up to 64 bytes is one 64-bit column, updated in a
+ * few word operations per text byte, from per-byte match masks compiled at
+ * create time over the phrases' alphabet.
+ *
+ * A phrase allows one edit per chars_per_edit bytes, so phrases shorter
+ * than that only match exactly. The best match is the one with the highest
+ * confidence, 1 - distance / phrase length; the lower phrase index wins
+ * ties, as in phrase_matcher. Read-only after create.
+ */
+typedef struct phrase_fuzzy phrase_fuzzy_t;
+
+#define PHRASE_FUZZY_MAX_LEN 64
+
+typedef struct {
+    int phrase;                       // -1 for none
+    uint8_t distance;                 // Edits between the phrase and the words it matched
+    float confidence;
+    size_t end;                       // Text offset just past the last matched word
+} phrase_fuzzy_match_t;
+
+/**
+ * @return ESP_ERR_INVALID_ARG for an empty set, a phrase without words or
+ *         chars_per_edit 0, ESP_ERR_INVALID_SIZE for a phrase past
+ *         PHRASE_FUZZY_MAX_LEN bytes once spaces are collapsed
+ */
+esp_err_t phrase_fuzzy_create(const char *const *phrases, size_t count, uint8_t chars_per_edit,
+                              phrase_fuzzy_t **out);
+void phrase_fuzzy_destroy(phrase_fuzzy_t *fuzzy);
+
+// Best phrase within its edit budget anywhere in text; out->phrase is -1 when there is none
+void phrase_fuzzy_find(const phrase_fuzzy_t *fuzzy, const char *text, phrase_fuzzy_match_t *out);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,176 @@
+#include "phrase_matcher.h"
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "esp_check.h"
+
+static const char *TAG = "phrase_matcher";
+
+#define NO_STATE UINT16_MAX
+
+struct phrase_matcher {
+    uint8_t class_of[256];            // Byte -> input class; 0 for bytes in no phrase
+    size_t classes;
+    size_t states;
+    uint16_t *next;                   // states x classes, complete DFA
+    int16_t *best;                    // Lowest phrase index ending in each state (fail chain included), -1 for none
+};
+
+static void keep_best(int16_t *slot, int16_t candidate)
+{
+    if (candidate >= 0 && (*slot < 0 || candidate < *slot)) {
+        *slot = candidate;
+    }
+}
+
+static esp_err_t build_alphabet(phrase_matcher_t *m, const char *const *phrases, size_t count, size_t *total_len)
+{
+    size_t classes = 1;
+    *total_len = 0;
+    for (size_t i = 0; i < count; ++i) {
+        ESP_RETURN_ON_FALSE(phrases[i] && phrases[i][0], ESP_ERR_INVALID_ARG, TAG, "empty phrase %u", (unsigned)i);
+        for (const char *p = phrases[i]; *p; ++p) {
+            uint8_t lower = (uint8_t)tolower((unsigned char)*p);
+            if (m->class_of[lower] == 0) {
+                m->class_of[lower] = (uint8_t)classes;
+                m->class_of[(uint8_t)toupper(lower)] = (uint8_t)classes;
+                classes++;
+            }
+        }
+        *total_len += strlen(phrases[i]);
+    }
+    m->classes = classes;
+    return ESP_OK;
+}
+
+esp_err_t phrase_matcher_create(const char *const *phrases, size_t count, phrase_matcher_t **out)
+{
+    ESP_RETURN_ON_FALSE(phrases && count > 0 && count <= INT16_MAX && out, ESP_ERR_INVALID_ARG, TAG, "bad args");
+    *out = NULL;
+    phrase_matcher_t *m = calloc(1, sizeof(*m));
+    ESP_RETURN_ON_FALSE(m, ESP_ERR_NO_MEM, TAG, "matcher alloc");
+
+    esp_err_t ret = ESP_OK;
+    uint16_t *fail_link = NULL;
+    uint16_t *queue = NULL;
+    size_t max_states = 0;
+    ESP_GOTO_ON_ERROR(build_alphabet(m, phrases, count, &max_states), fail, TAG, "alphabet");
+    max_states += 1;
+    ESP_GOTO_ON_FALSE(max_states < NO_STATE, ESP_ERR_INVALID_SIZE, fail, TAG, "%u states", (unsigned)max_states);
+
+    const size_t classes = m->classes;
+    m->next = malloc(max_states * classes * sizeof(uint16_t));
+    m->best = malloc(max_states * sizeof(int16_t));
+    ESP_GOTO_ON_FALSE(m->next && m->best, ESP_ERR_NO_MEM, fail, TAG, "tables alloc");
+    memset(m->next, 0xFF, max_states * classes * sizeof(uint16_t));
+    for (size_t s = 0; s < max_states; ++s) {
+        m->best[s] = -1;
+    }
+
+    // Trie
+    size_t states = 1;
+    for (size_t i = 0; i < count; ++i) {
+        size_t s = 0;
+        for (const char *p = phrases[i]; *p; ++p) {
+            uint16_t *edge = &m->next[s * classes + m->class_of[(uint8_t)*p]];
+            if (*edge == NO_STATE) {
+                *edge = (uint16_t)states++;
+            }
+            s = *edge;
+        }
+        keep_best(&m->best[s], (int16_t)i);
+    }
+
+    // Breadth-first: fill missing edges from the failure state, whose row is already complete
+    fail_link = calloc(states, sizeof(uint16_t));
+    queue = malloc(states * sizeof(uint16_t));
+    ESP_GOTO_ON_FALSE(fail_link && queue, ESP_ERR_NO_MEM, fail, TAG, "build alloc");
+    size_t head = 0;
+    size_t tail = 0;
+    for (size_t c = 0; c < classes; ++c) {
+        uint16_t *edge = &m->next[c];
+        if (*edge == NO_STATE) {
+            *edge = 0;
+        } else {
+            fail_link[*edge] = 0;
+            queue[tail++] = *edge;
+        }
+    }
+    while (head < tail) {
+        size_t s = queue[head++];
+        for (size_t c = 0; c < classes; ++c) {
+            uint16_t *edge = &m->next[s * classes + c];
+            uint16_t via_fail = m->next[fail_link[s] * classes + c];
+            if (*edge == NO_STATE) {
+                *edge = via_fail;
+            } else {
+                fail_link[*edge] = via_fail;
+                keep_best(&m->best[*edge], m->best[via_fail]);
+                queue[tail++] = *edge;
+            }
+        }
+    }
+    m->states = states;
+
+    free(fail_link);
+    free(queue);
+    *out = m;
+    return ESP_OK;
+
+fail:
+    free(fail_link);
+    free(queue);
+    phrase_matcher_destroy(m);
+    return ret;
+}
+
+void phrase_matcher_destroy(phrase_matcher_t *matcher)
+{
+    if (matcher) {
+        free(matcher->next);
+        free(matcher->best);
+        free(matcher);
+    }
+}
+
+void phrase_matcher_scan_begin(phrase_matcher_scan_t *scan)
+{
+    scan->state = 0;
+    scan->best = -1;
+    scan->best_end = 0;
+    scan->pos = 0;
+}
+
+void phrase_matcher_scan_feed(const phrase_matcher_t *matcher, phrase_matcher_scan_t *scan, const char *text,
+                              size_t len)
+{
+    if (!matcher || !scan || !text) {
+        return;
+    }
+    size_t s = scan->state;
+    for (size_t i = 0; i < len; ++i) {
+        s = matcher->next[s * matcher->classes + matcher->class_of[(uint8_t)text[i]]];
+        int best = matcher->best[s];
+        if (best >= 0 && (scan->best < 0 || best < scan->best)) {
+            scan->best = best;
+            scan->best_end = scan->pos + i + 1;
+        }
+    }
+    scan->state = (uint16_t)s;
+    scan->pos += len;
+}
+
+int phrase_matcher_find(const phrase_matcher_t *matcher, const char *text, size_t *match_end)
+{
+    phrase_matcher_scan_t scan;
+    phrase_matcher_scan_begin(&scan);
+    if (text) {
+        phrase_matcher_scan_feed(matcher, &scan, text, strlen(text));
+    }
+    if (match_end) {
+        *match_end = scan.best_end;
+    }
+    return scan.best;
+}
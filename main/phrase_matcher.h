@@ -0,0 +1,56 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Case-insensitive multi-phrase matcher (Aho-Corasick, compiled to a DFA).
+ *
+ * Phrases are compiled once; a scan then makes one table lookup per input
+ * byte, however many phrases there are. Phrases are ranked by their index:
+ * a scan reports the lowest-index phrase found anywhere in the text and
+ * where its first occurrence ends. Matching is by substring, like strstr().
+ *
+ * The input alphabet is reduced to the bytes that appear in some phrase,
+ * so the transition table stays at (phrase bytes + 1) x (distinct bytes + 1)
+ * entries. The matcher is read-only after create and can be shared.
+ */
+typedef struct phrase_matcher phrase_matcher_t;
+
+// Scan progress; text may arrive in pieces (e.g. a growing partial transcript)
+typedef struct {
+    uint16_t state;
+    int best;                         // Lowest phrase index matched so far, -1 for none
+    size_t best_end;                  // Input offset just past its first occurrence
+    size_t pos;                       // Bytes fed so far
+} phrase_matcher_scan_t;
+
+/**
+ * @return ESP_ERR_INVALID_ARG for an empty set or an empty phrase,
+ *         ESP_ERR_INVALID_SIZE past 65535 states
+ */
+esp_err_t phrase_matcher_create(const char *const *phrases, size_t count, phrase_matcher_t **out);
+void phrase_matcher_destroy(phrase_matcher_t *matcher);
+
+void phrase_matcher_scan_begin(phrase_matcher_scan_t *scan);
+void phrase_matcher_scan_feed(const phrase_matcher_t *matcher, phrase_matcher_scan_t *scan, const char *text,
+                              size_t len);
+
+/**
+ * Scan a whole NUL-terminated string.
+ *
+ * @param match_end Offset just past the first occurrence of the result; may be NULL
+ * @return lowest matching phrase index, or -1
+ */
+int phrase_matcher_find(const phrase_matcher_t *matcher, const char *text, size_t *match_end);
+
+#ifdef __cplusplus
+}
+#endif
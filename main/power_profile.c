@@ -0,0 +1,78 @@
+#include "power_profile.h"
+
+#include "esp_check.h"
+#include "esp_log.h"
+#include "esp_sleep.h"
+#include "sdkconfig.h"
+
+#if CONFIG_PM_ENABLE
+#include "esp_pm.h"
+#endif
+
+static const char *TAG = "power_profile";
+
+#if CONFIG_PM_ENABLE
+static const char *const LOCK_NAMES[POWER_PROFILE_SOURCE_COUNT] = {
+    [POWER_PROFILE_LISTEN] = "kva_listen",
+    [POWER_PROFILE_INTERACTION] = "kva_interaction",
+    [POWER_PROFILE_PLAYBACK] = "kva_playback",
+};
+
+static esp_pm_lock_handle_t s_locks[POWER_PROFILE_SOURCE_COUNT];
+#endif
+// Written from several tasks; the exchange makes each transition happen once
+static bool s_busy[POWER_PROFILE_SOURCE_COUNT];
+
+esp_err_t power_profile_init(void)
+{
+#if CONFIG_PM_ENABLE
+    for (int i = 0; i < POWER_PROFILE_SOURCE_COUNT; ++i) {
+        if (!s_locks[i]) {
+            ESP_RETURN_ON_ERROR(esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, LOCK_NAMES[i], &s_locks[i]),
+                                TAG, "create %s lock", LOCK_NAMES[i]);
+            // Sources marked busy before init still get their lock
+            if (__atomic_load_n(&s_busy[i], __ATOMIC_ACQUIRE)) {
+                esp_pm_lock_acquire(s_locks[i]);
+            }
+        }
+    }
+
+    esp_pm_config_t pm_config = {
+        .max_freq_mhz = CONFIG_KVA_PM_MAX_CPU_MHZ,
+        .min_freq_mhz = CONFIG_KVA_PM_MIN_CPU_MHZ,
+#if CONFIG_FREERTOS_USE_TICKLESS_IDLE
+        .light_sleep_enable = CONFIG_KVA_PM_LIGHT_SLEEP,
+#endif
+    };
+    ESP_RETURN_ON_ERROR(esp_pm_configure(&pm_config), TAG, "esp_pm_configure");
+    // Pins opt in with gpio_wakeup_enable()
+    ESP_RETURN_ON_ERROR(esp_sleep_enable_gpio_wakeup(), TAG, "gpio wakeup");
+
+    ESP_LOGI(TAG, "DFS %d-%d MHz, light sleep %s", CONFIG_KVA_PM_MIN_CPU_MHZ, CONFIG_KVA_PM_MAX_CPU_MHZ,
+             pm_config.light_sleep_enable ? "on" : "off");
+    return ESP_OK;
+#else
+    ESP_LOGI(TAG, "Power management disabled (CONFIG_PM_ENABLE not set)");
+    return ESP_OK;
+#endif
+}
+
+void power_profile_set_busy(power_profile_source_t source, bool busy)
+{
+    if (source < 0 || source >= POWER_PROFILE_SOURCE_COUNT) {
+        return;
+    }
+    if (__atomic_exchange_n(&s_busy[source], busy, __ATOMIC_ACQ_REL) == busy) {
+        return;
+    }
+#if CONFIG_PM_ENABLE
+    if (!s_locks[source]) {
+        return;
+    }
+    if (busy) {
+        esp_pm_lock_acquire(s_locks[source]);
+    } else {
+        esp_pm_lock_release(s_locks[source]);
+    }
+#endif
+}
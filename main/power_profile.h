@@ -0,0 +1,40 @@
+#pragma once
+
+#include <stdbool.h>
+
+#include "esp_err.h"
+#include "kva_config_defaults.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Dynamic frequency scaling with automatic light sleep. With nothing busy
+ * the CPU drops to CONFIG_KVA_PM_MIN_CPU_MHZ and the chip light-sleeps
+ * between ticks; each source below holds the CPU at full clock while it is
+ * busy. Drivers keep their own locks on top: the I2S driver blocks light
+ * sleep for as long as capture runs, so the chip only sleeps with the
+ * microphones stopped.
+ *
+ * Wake sources from light sleep are timers, Wi-Fi DTIM beacons and any GPIO
+ * armed with gpio_wakeup_enable() (buttons, the VCNL4040 INT line). Arming
+ * forces the pin's interrupt to level type, so those ISRs mask their pin and
+ * the owning task unmasks it once serviced.
+ */
+typedef enum {
+    POWER_PROFILE_LISTEN,             // Wake-word listening through the AFE
+    POWER_PROFILE_INTERACTION,        // From wake to the end of the reply
+    POWER_PROFILE_PLAYBACK,           // Music or any other audio out
+    POWER_PROFILE_SOURCE_COUNT,
+} power_profile_source_t;
+
+// Configure esp_pm and the GPIO wake source; call once, early in app_main
+esp_err_t power_profile_init(void);
+
+// Hold or release a source's full-clock lock; repeated calls are no-ops
+void power_profile_set_busy(power_profile_source_t source, bool busy);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,378 @@
+#include "provider_router.h"
+
+#include <float.h>
+#include <string.h>
+
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+
+static const char *TAG = "provider_router";
+
+// Smoothing per sample of the latency, its deviation and the error rate
+#define LATENCY_ALPHA 0.25f
+#define ERROR_ALPHA 0.2f
+// Error rate weighs the latency score: a provider failing half the time looks twice as slow
+#define ERROR_WEIGHT 2.0f
+// Figures older than this make a provider worth an exploring request
+#define STALE_US (60LL * 1000 * 1000)
+// Cool-downs double per trip up to 1 << MAX_TRIP_SHIFT
+#define MAX_TRIP_SHIFT 5
+// Unspent hedges carry over up to this many
+#define HEDGE_TOKENS_MAX 2.0f
+
+typedef struct {
+    float latency_ms;                 // 0 until the first sample
+    float deviation_ms;               // Smoothed absolute deviation from latency_ms
+    float error_rate;
+    uint32_t samples;
+    uint8_t failures;                 // Consecutive, a timeout counting two
+    uint8_t trips;                    // Breaker openings since the last success
+    int64_t open_until_us;            // Out of rotation until then; while probing, the probe's reservation
+    int64_t measured_us;              // Last latency sample
+} stage_stats_t;
+
+static struct {
+    provider_router_provider_t preferred;
+    uint32_t available;
+    uint32_t requests[PROVIDER_ROUTER_STAGE_COUNT];
+    provider_router_provider_t last[PROVIDER_ROUTER_STAGE_COUNT];
+    float hedge_tokens;
+    stage_stats_t stats[PROVIDER_ROUTER_COUNT][PROVIDER_ROUTER_STAGE_COUNT];
+} s_router = {
+    .preferred = PROVIDER_ROUTER_GEMINI,
+    .available = 1u << PROVIDER_ROUTER_GEMINI,
+};
+
+static portMUX_TYPE s_router_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static const char *const PROVIDER_NAMES[PROVIDER_ROUTER_COUNT] = {
+    [PROVIDER_ROUTER_GEMINI] = "gemini",
+    [PROVIDER_ROUTER_OPENAI] = "openai",
+};
+
+static const char *const STAGE_NAMES[PROVIDER_ROUTER_STAGE_COUNT] = {
+    [PROVIDER_ROUTER_STT] = "stt",
+    [PROVIDER_ROUTER_LLM] = "llm",
+    [PROVIDER_ROUTER_TTS] = "tts",
+};
+
+// Trace points bounding each stage
+static const interaction_trace_point_t STAGE_START[PROVIDER_ROUTER_STAGE_COUNT] = {
+    [PROVIDER_ROUTER_STT] = INTERACTION_TRACE_VAD_OFFSET,
+    [PROVIDER_ROUTER_LLM] = INTERACTION_TRACE_STT_FINAL,
+    [PROVIDER_ROUTER_TTS] = INTERACTION_TRACE_LLM_FIRST_TOKEN,
+};
+
+static const interaction_trace_point_t STAGE_END[PROVIDER_ROUTER_STAGE_COUNT] = {
+    [PROVIDER_ROUTER_STT] = INTERACTION_TRACE_STT_FINAL,
+    [PROVIDER_ROUTER_LLM] = INTERACTION_TRACE_LLM_FIRST_TOKEN,
+    [PROVIDER_ROUTER_TTS] = INTERACTION_TRACE_TTS_FIRST_BYTE,
+};
+
+static bool valid(provider_router_provider_t provider, provider_router_stage_t stage)
+{
+    return provider < PROVIDER_ROUTER_COUNT && stage < PROVIDER_ROUTER_STAGE_COUNT;
+}
+
+static bool available_locked(provider_router_provider_t provider)
+{
+    return (s_router.available & (1u << provider)) != 0;
+}
+
+static bool healthy_locked(const stage_stats_t *stats, int64_t now_us)
+{
+    return now_us >= stats->open_until_us;
+}
+
+// Expected cost of a request. The preferred provider is discounted by the
+// switch margin, and holds the stage outright until it has been measured;
+// an unmeasured other one is the last resort
+static float score_locked(provider_router_provider_t provider, const stage_stats_t *stats)
+{
+    if (stats->samples == 0) {
+        return provider == s_router.preferred ? 0.0f : FLT_MAX;
+    }
+    float score = stats->latency_ms * (1.0f + ERROR_WEIGHT * stats->error_rate);
+    return provider == s_router.preferred ? score / (1.0f + CONFIG_KVA_ROUTER_SWITCH_PCT / 100.0f) : score;
+}
+
+// The healthy provider not in skip a request should go to
+static provider_router_provider_t best_locked(provider_router_stage_t stage, uint32_t skip, int64_t now_us)
+{
+    provider_router_provider_t best = PROVIDER_ROUTER_NONE;
+    float best_score = 0.0f;
+    for (int p = 0; p < PROVIDER_ROUTER_COUNT; ++p) {
+        const stage_stats_t *stats = &s_router.stats[p][stage];
+        if (!available_locked(p) || (skip & (1u << p)) || !healthy_locked(stats, now_us)) {
+            continue;
+        }
+        float score = score_locked(p, stats);
+        if (best == PROVIDER_ROUTER_NONE || score < best_score) {
+            best = p;
+            best_score = score;
+        }
+    }
+    return best;
+}
+
+// A provider whose breaker has run out takes one probe at a time
+static void reserve_probe_locked(provider_router_provider_t provider, provider_router_stage_t stage, int64_t now_us)
+{
+    stage_stats_t *stats = &s_router.stats[provider][stage];
+    if (stats->trips > 0) {
+        stats->open_until_us = now_us + (int64_t)CONFIG_KVA_ROUTER_TIMEOUT_MAX_MS * 1000;
+    }
+}
+
+void provider_router_init(provider_router_provider_t preferred, uint32_t available)
+{
+    portENTER_CRITICAL(&s_router_lock);
+    memset(&s_router, 0, sizeof(s_router));
+    s_router.preferred = preferred < PROVIDER_ROUTER_COUNT ? preferred : PROVIDER_ROUTER_GEMINI;
+    s_router.available = available;
+    for (int s = 0; s < PROVIDER_ROUTER_STAGE_COUNT; ++s) {
+        s_router.last[s] = PROVIDER_ROUTER_NONE;
+    }
+    portEXIT_CRITICAL(&s_router_lock);
+    ESP_LOGI(TAG, "Preferring %s; gemini %s, openai %s", PROVIDER_NAMES[s_router.preferred],
+             (available & (1u << PROVIDER_ROUTER_GEMINI)) ? "available" : "off",
+             (available & (1u << PROVIDER_ROUTER_OPENAI)) ? "available" : "off");
+}
+
+provider_router_provider_t provider_router_pick(provider_router_stage_t stage)
+{
+    if (stage >= PROVIDER_ROUTER_STAGE_COUNT) {
+        return PROVIDER_ROUTER_NONE;
+    }
+#if !CONFIG_KVA_PROVIDER_ROUTER
+    return available_locked(s_router.preferred) ? s_router.preferred : PROVIDER_ROUTER_NONE;
+#else
+    int64_t now_us = esp_timer_get_time();
+    portENTER_CRITICAL(&s_router_lock);
+    provider_router_provider_t pick = best_locked(stage, 0, now_us);
+    bool explore = ++s_router.requests[stage] % CONFIG_KVA_ROUTER_EXPLORE_EVERY == 0;
+    if (explore && pick != PROVIDER_ROUTER_NONE) {
+        provider_router_provider_t stale = best_locked(stage, 1u << pick, now_us);
+        if (stale != PROVIDER_ROUTER_NONE && now_us - s_router.stats[stale][stage].measured_us > STALE_US) {
+            pick = stale;
+        } else {
+            explore = false;
+        }
+    }
+    if (pick == PROVIDER_ROUTER_NONE && available_locked(s_router.preferred)) {
+        // Every breaker is open; trying beats giving up
+        pick = s_router.preferred;
+    }
+    provider_router_provider_t last = s_router.last[stage];
+    if (pick != PROVIDER_ROUTER_NONE) {
+        reserve_probe_locked(pick, stage, now_us);
+        if (!explore) {
+            s_router.last[stage] = pick;
+        }
+    }
+    portEXIT_CRITICAL(&s_router_lock);
+    if (explore) {
+        ESP_LOGI(TAG, "%s: refreshing %s", STAGE_NAMES[stage], PROVIDER_NAMES[pick]);
+    } else if (pick != last && last != PROVIDER_ROUTER_NONE && pick != PROVIDER_ROUTER_NONE) {
+        ESP_LOGI(TAG, "%s: %s -> %s", STAGE_NAMES[stage], PROVIDER_NAMES[last], PROVIDER_NAMES[pick]);
+    }
+    return pick;
+#endif
+}
+
+provider_router_provider_t provider_router_next(provider_router_stage_t stage, uint32_t tried)
+{
+#if !CONFIG_KVA_PROVIDER_ROUTER
+    (void)stage;
+    (void)tried;
+    return PROVIDER_ROUTER_NONE;
+#else
+    if (stage >= PROVIDER_ROUTER_STAGE_COUNT) {
+        return PROVIDER_ROUTER_NONE;
+    }
+    int64_t now_us = esp_timer_get_time();
+    portENTER_CRITICAL(&s_router_lock);
+    provider_router_provider_t next = best_locked(stage, tried, now_us);
+    if (next != PROVIDER_ROUTER_NONE) {
+        reserve_probe_locked(next, stage, now_us);
+    }
+    portEXIT_CRITICAL(&s_router_lock);
+    return next;
+#endif
+}
+
+uint32_t provider_router_timeout_ms(provider_router_provider_t provider, provider_router_stage_t stage)
+{
+    if (!valid(provider, stage)) {
+        return CONFIG_KVA_ROUTER_TIMEOUT_MAX_MS;
+    }
+    portENTER_CRITICAL(&s_router_lock);
+    const stage_stats_t *stats = &s_router.stats[provider][stage];
+    float ms = stats->samples ? stats->latency_ms + 4.0f * stats->deviation_ms : CONFIG_KVA_ROUTER_TIMEOUT_MAX_MS;
+    portEXIT_CRITICAL(&s_router_lock);
+    if (ms < CONFIG_KVA_ROUTER_TIMEOUT_MIN_MS) {
+        ms = CONFIG_KVA_ROUTER_TIMEOUT_MIN_MS;
+    }
+    return ms > CONFIG_KVA_ROUTER_TIMEOUT_MAX_MS ? CONFIG_KVA_ROUTER_TIMEOUT_MAX_MS : (uint32_t)ms;
+}
+
+uint32_t provider_router_hedge_after_ms(provider_router_provider_t provider, uint32_t clip_ms)
+{
+#if !CONFIG_KVA_PROVIDER_ROUTER || !CONFIG_KVA_ROUTER_HEDGE_STT
+    (void)provider;
+    (void)clip_ms;
+    return UINT32_MAX;
+#else
+    if (provider >= PROVIDER_ROUTER_COUNT || clip_ms > CONFIG_KVA_ROUTER_HEDGE_MAX_MS) {
+        return UINT32_MAX;
+    }
+    portENTER_CRITICAL(&s_router_lock);
+    s_router.hedge_tokens += CONFIG_KVA_ROUTER_HEDGE_BUDGET_PCT / 100.0f;
+    if (s_router.hedge_tokens > HEDGE_TOKENS_MAX) {
+        s_router.hedge_tokens = HEDGE_TOKENS_MAX;
+    }
+    const stage_stats_t *stats = &s_router.stats[provider][PROVIDER_ROUTER_STT];
+    // Unmeasured, hedge as early as an attempt may time out
+    float ms = stats->samples ? stats->latency_ms + 2.0f * stats->deviation_ms : CONFIG_KVA_ROUTER_TIMEOUT_MIN_MS;
+    portEXIT_CRITICAL(&s_router_lock);
+    return (uint32_t)ms;
+#endif
+}
+
+bool provider_router_hedge_take(void)
+{
+    portENTER_CRITICAL(&s_router_lock);
+    bool ok = s_router.hedge_tokens >= 1.0f;
+    if (ok) {
+        s_router.hedge_tokens -= 1.0f;
+    }
+    portEXIT_CRITICAL(&s_router_lock);
+    return ok;
+}
+
+static void add_latency_locked(stage_stats_t *stats, float ms, int64_t now_us)
+{
+    if (stats->samples == 0) {
+        stats->latency_ms = ms;
+        stats->deviation_ms = ms / 4.0f;
+    } else {
+        float diff = ms - stats->latency_ms;
+        stats->latency_ms += LATENCY_ALPHA * diff;
+        stats->deviation_ms += LATENCY_ALPHA * ((diff < 0 ? -diff : diff) - stats->deviation_ms);
+    }
+    stats->samples++;
+    stats->measured_us = now_us;
+}
+
+void provider_router_note_failure(provider_router_provider_t provider, provider_router_stage_t stage, esp_err_t err,
+                                  int64_t elapsed_us)
+{
+    if (!valid(provider, stage)) {
+        return;
+    }
+    int64_t now_us = esp_timer_get_time();
+    int64_t cooldown_ms = 0;
+    portENTER_CRITICAL(&s_router_lock);
+    stage_stats_t *stats = &s_router.stats[provider][stage];
+    stats->error_rate += ERROR_ALPHA * (1.0f - stats->error_rate);
+    if (err == ESP_ERR_TIMEOUT && elapsed_us > 0) {
+        // The real latency is at least this
+        add_latency_locked(stats, (float)elapsed_us / 1000.0f, now_us);
+    }
+    stats->failures += err == ESP_ERR_TIMEOUT ? 2 : 1;
+    if (stats->failures >= CONFIG_KVA_ROUTER_TRIP_FAILURES) {
+        int shift = stats->trips < MAX_TRIP_SHIFT ? stats->trips : MAX_TRIP_SHIFT;
+        cooldown_ms = (int64_t)CONFIG_KVA_ROUTER_COOLDOWN_MS << shift;
+        stats->open_until_us = now_us + cooldown_ms * 1000;
+        stats->trips++;
+        stats->failures = 0;
+    }
+    portEXIT_CRITICAL(&s_router_lock);
+    if (cooldown_ms) {
+        ESP_LOGW(TAG, "%s %s out of rotation for %lld ms (%s)", PROVIDER_NAMES[provider], STAGE_NAMES[stage],
+                 (long long)cooldown_ms, esp_err_to_name(err));
+    }
+}
+
+static void note_latency(provider_router_provider_t provider, provider_router_stage_t stage, int64_t latency_us,
+                         bool success)
+{
+    if (!valid(provider, stage) || latency_us < 0) {
+        return;
+    }
+    int64_t now_us = esp_timer_get_time();
+    bool recovered = false;
+    portENTER_CRITICAL(&s_router_lock);
+    stage_stats_t *stats = &s_router.stats[provider][stage];
+    add_latency_locked(stats, (float)latency_us / 1000.0f, now_us);
+    if (success) {
+        stats->error_rate -= ERROR_ALPHA * stats->error_rate;
+        recovered = stats->trips > 0;
+        stats->failures = 0;
+        stats->trips = 0;
+        stats->open_until_us = 0;
+    }
+    portEXIT_CRITICAL(&s_router_lock);
+    if (recovered) {
+        ESP_LOGI(TAG, "%s %s back in rotation", PROVIDER_NAMES[provider], STAGE_NAMES[stage]);
+    }
+}
+
+void provider_router_note_late(provider_router_provider_t provider, provider_router_stage_t stage,
+                               int64_t latency_us)
+{
+    note_latency(provider, stage, latency_us, false);
+}
+
+void provider_router_note_trace(const interaction_trace_t *trace, const provider_router_route_t *route)
+{
+    if (!trace || !route) {
+        return;
+    }
+    for (int s = 0; s < PROVIDER_ROUTER_STAGE_COUNT; ++s) {
+        int64_t end_us = trace->points[STAGE_END[s]].time_us;
+        int64_t start_us = route->start_us[s] ? route->start_us[s] : trace->points[STAGE_START[s]].time_us;
+        if (route->provider[s] == PROVIDER_ROUTER_NONE || end_us == 0 || start_us == 0 || end_us < start_us) {
+            continue;
+        }
+        note_latency(route->provider[s], (provider_router_stage_t)s, end_us - start_us, true);
+    }
+}
+
+void provider_router_route_init(provider_router_route_t *route)
+{
+    for (int s = 0; s < PROVIDER_ROUTER_STAGE_COUNT; ++s) {
+        route->provider[s] = PROVIDER_ROUTER_NONE;
+        route->start_us[s] = 0;
+    }
+}
+
+const char *provider_router_provider_name(provider_router_provider_t provider)
+{
+    return provider < PROVIDER_ROUTER_COUNT ? PROVIDER_NAMES[provider] : "none";
+}
+
+const char *provider_router_stage_name(provider_router_stage_t stage)
+{
+    return stage < PROVIDER_ROUTER_STAGE_COUNT ? STAGE_NAMES[stage] : "unknown";
+}
+
+void provider_router_log(void)
+{
+    int64_t now_us = esp_timer_get_time();
+    for (int p = 0; p < PROVIDER_ROUTER_COUNT; ++p) {
+        for (int s = 0; s < PROVIDER_ROUTER_STAGE_COUNT; ++s) {
+            portENTER_CRITICAL(&s_router_lock);
+            stage_stats_t stats = s_router.stats[p][s];
+            bool available = available_locked(p);
+            portEXIT_CRITICAL(&s_router_lock);
+            if (!available) {
+                continue;
+            }
+            ESP_LOGI(TAG, "%s %s: %.0f ms +-%.0f, %.0f%% errors, %u samples%s", PROVIDER_NAMES[p], STAGE_NAMES[s],
+                     stats.latency_ms, stats.deviation_ms, stats.error_rate * 100.0f, (unsigned)stats.samples,
+                     healthy_locked(&stats, now_us) ? "" : ", out of rotation");
+        }
+    }
+}
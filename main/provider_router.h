@@ -0,0 +1,109 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "interaction_trace.h"
+#include "kva_config_defaults.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    PROVIDER_ROUTER_GEMINI = 0,
+    PROVIDER_ROUTER_OPENAI,
+    PROVIDER_ROUTER_COUNT,
+    PROVIDER_ROUTER_NONE = PROVIDER_ROUTER_COUNT,
+} provider_router_provider_t;
+
+typedef enum {
+    PROVIDER_ROUTER_STT = 0,          // Batch transcription: VAD offset to final transcript
+    PROVIDER_ROUTER_LLM,              // Final transcript to first reply text
+    PROVIDER_ROUTER_TTS,              // First reply text to first synthesized byte
+    PROVIDER_ROUTER_STAGE_COUNT,
+} provider_router_stage_t;
+
+// Which provider served each stage of one interaction, for provider_router_note_trace()
+typedef struct {
+    provider_router_provider_t provider[PROVIDER_ROUTER_STAGE_COUNT];  // NONE: not routed
+    int64_t start_us[PROVIDER_ROUTER_STAGE_COUNT];  // Serving attempt's start; 0 takes the stage's first trace point
+} provider_router_route_t;
+
+/**
+ * Picks the cloud provider for each stage of a reply from how the
+ * providers have been doing lately.
+ *
+ * Per provider and stage it keeps a smoothed latency and its mean
+ * deviation, a smoothed error rate and a circuit breaker. Latencies come
+ * from the interaction trace: the span between a stage's trace points,
+ * measured from when its serving attempt started. Failures are noted by
+ * the caller as they happen, so failover does not wait for the report.
+ *
+ * A stage goes to the healthy provider with the lowest latency weighted
+ * by its error rate; the configured provider keeps it unless the other is
+ * CONFIG_KVA_ROUTER_SWITCH_PCT faster. CONFIG_KVA_ROUTER_TRIP_FAILURES in
+ * a row open the breaker, and the provider is offered one request again
+ * after the cool-down. A provider nobody has measured for a while gets
+ * every CONFIG_KVA_ROUTER_EXPLORE_EVERY-th request so its figures do not
+ * go stale behind a healthy favourite.
+ *
+ * All functions are safe from any task.
+ */
+
+/**
+ * @param preferred The configured provider, which wins ties
+ * @param available Bit per provider that is compiled in and has a key
+ */
+void provider_router_init(provider_router_provider_t preferred, uint32_t available);
+
+/**
+ * Provider for the next request of stage, or PROVIDER_ROUTER_NONE if none
+ * is available. With CONFIG_KVA_PROVIDER_ROUTER 0 the preferred one.
+ */
+provider_router_provider_t provider_router_pick(provider_router_stage_t stage);
+
+/**
+ * Failover target after the providers in tried (a bit each) failed:
+ * the best healthy one left, or PROVIDER_ROUTER_NONE
+ */
+provider_router_provider_t provider_router_next(provider_router_stage_t stage, uint32_t tried);
+
+// Wait for one attempt before giving up on it: its latency plus four deviations, within the configured bounds
+uint32_t provider_router_timeout_ms(provider_router_provider_t provider, provider_router_stage_t stage);
+
+/**
+ * When to hedge an STT request of clip_ms audio still unanswered by
+ * provider: its latency plus two deviations, or UINT32_MAX if hedging is
+ * off or the clip too long. Call once per request; each call adds
+ * CONFIG_KVA_ROUTER_HEDGE_BUDGET_PCT of a hedge to the budget.
+ */
+uint32_t provider_router_hedge_after_ms(provider_router_provider_t provider, uint32_t clip_ms);
+
+// Spend one hedge from the budget; false if it is used up
+bool provider_router_hedge_take(void);
+
+// A failed attempt after elapsed_us; ESP_ERR_TIMEOUT weighs double on the breaker
+void provider_router_note_failure(provider_router_provider_t provider, provider_router_stage_t stage, esp_err_t err,
+                                  int64_t elapsed_us);
+
+// An attempt that answered after another had already won or it was given
+// up on: its latency counts, not its success
+void provider_router_note_late(provider_router_provider_t provider, provider_router_stage_t stage,
+                               int64_t latency_us);
+
+// Successful stages of a finished interaction, timed by its trace points
+void provider_router_note_trace(const interaction_trace_t *trace, const provider_router_route_t *route);
+
+void provider_router_route_init(provider_router_route_t *route);
+
+const char *provider_router_provider_name(provider_router_provider_t provider);
+const char *provider_router_stage_name(provider_router_stage_t stage);
+
+// One line per provider and stage on the console
+void provider_router_log(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,172 @@
+#include "radio_coex.h"
+
+#include "esp_check.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_wifi.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "sdkconfig.h"
+#include "somnus_ble.h"
+#include "timer_wheel.h"
+
+#if CONFIG_ESP_COEX_SW_COEXIST_ENABLE || CONFIG_ESP32_WIFI_SW_COEXIST_ENABLE
+#include "esp_coexist.h"
+#define RADIO_COEX_HAVE_ARBITER 1
+#else
+#define RADIO_COEX_HAVE_ARBITER 0
+#endif
+
+static const char *TAG = "radio_coex";
+
+// Bit per busy source; written from several tasks
+static uint32_t s_busy_mask;
+static int64_t s_prewarm_until_us;    // Streaming schedule until then, busy or not (atomic)
+static bool s_wifi_started;           // Atomic; power save needs a running driver
+static bool s_streaming;              // Schedule currently applied, under s_lock
+static int s_wifi_ps = -1;            // wifi_ps_type_t applied, under s_lock; -1 for none yet
+static timer_wheel_timer_t *s_restore_timer;
+static SemaphoreHandle_t s_lock;
+
+#if CONFIG_KVA_PM_WIFI_POWER_SAVE
+// Under s_lock. Idle modem sleep costs the first packets of an interaction
+// up to a listen interval each, so streaming runs at full power.
+static void apply_wifi_ps(bool streaming)
+{
+    if (!__atomic_load_n(&s_wifi_started, __ATOMIC_ACQUIRE)) {
+        return;
+    }
+    wifi_ps_type_t ps = streaming ? WIFI_PS_NONE
+                                  : (CONFIG_KVA_WIFI_PS_IDLE_MAX_MODEM ? WIFI_PS_MAX_MODEM : WIFI_PS_MIN_MODEM);
+    if ((int)ps == s_wifi_ps) {
+        return;
+    }
+    esp_err_t err = esp_wifi_set_ps(ps);
+    if (err != ESP_OK && ps == WIFI_PS_NONE) {
+        // Coexistence refuses full power while the BT controller is up; DTIM wakes are the closest
+        ps = WIFI_PS_MIN_MODEM;
+        err = (int)ps == s_wifi_ps ? ESP_OK : esp_wifi_set_ps(ps);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Wi-Fi power save: %s", esp_err_to_name(err));
+        return;
+    }
+    s_wifi_ps = ps;
+    ESP_LOGI(TAG, "Wi-Fi %s", ps == WIFI_PS_NONE        ? "at full power"
+                              : ps == WIFI_PS_MAX_MODEM ? "in max modem sleep"
+                                                        : "in DTIM modem sleep");
+}
+#endif
+
+// Brings the radio in line with the busy mask and any prewarm hold, and
+// returns the schedule applied. Serialized so a restore racing a new
+// session cannot land after it.
+static bool apply(void)
+{
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    bool streaming = __atomic_load_n(&s_busy_mask, __ATOMIC_ACQUIRE) != 0 ||
+                     __atomic_load_n(&s_prewarm_until_us, __ATOMIC_ACQUIRE) > esp_timer_get_time();
+    if (streaming != s_streaming) {
+        s_streaming = streaming;
+#if RADIO_COEX_HAVE_ARBITER
+        esp_err_t err = esp_coex_preference_set(streaming ? ESP_COEX_PREFER_WIFI : ESP_COEX_PREFER_BALANCE);
+        if (err != ESP_OK) {
+            ESP_LOGW(TAG, "Coex preference: %s", esp_err_to_name(err));
+        }
+#endif
+        somnus_ble_set_low_duty(streaming);
+        ESP_LOGI(TAG, "%s",
+                 streaming ? "Audio streaming: Wi-Fi preferred, BLE low duty" : "Idle: balanced radio schedule");
+    }
+#if CONFIG_KVA_PM_WIFI_POWER_SAVE
+    apply_wifi_ps(streaming);
+#endif
+    xSemaphoreGive(s_lock);
+    return streaming;
+}
+
+// Idle schedule once the restore delay and any prewarm hold have both run out
+static void schedule_restore(void)
+{
+    int64_t prewarm_ms = (__atomic_load_n(&s_prewarm_until_us, __ATOMIC_ACQUIRE) - esp_timer_get_time()) / 1000;
+    uint32_t delay_ms = prewarm_ms >= CONFIG_KVA_COEX_RESTORE_MS ? (uint32_t)prewarm_ms + 1 : CONFIG_KVA_COEX_RESTORE_MS;
+    timer_wheel_stop(s_restore_timer);
+    timer_wheel_start_once(s_restore_timer, delay_ms);
+}
+
+static void restore_timer_cb(void *arg)
+{
+    (void)arg;
+    // Still streaming with nothing busy: the prewarm hold outlived the timer
+    if (apply() && __atomic_load_n(&s_busy_mask, __ATOMIC_ACQUIRE) == 0) {
+        schedule_restore();
+    }
+}
+
+esp_err_t radio_coex_init(void)
+{
+    if (!s_lock) {
+        s_lock = xSemaphoreCreateMutex();
+        ESP_RETURN_ON_FALSE(s_lock, ESP_ERR_NO_MEM, TAG, "lock");
+    }
+    if (!s_restore_timer) {
+        const timer_wheel_timer_config_t args = {
+            .callback = restore_timer_cb,
+            .name = "radio_coex",
+            .slack_ms = CONFIG_KVA_COEX_RESTORE_MS / 8,
+        };
+        ESP_RETURN_ON_ERROR(timer_wheel_create(&args, &s_restore_timer), TAG, "restore timer");
+    }
+    apply();
+#if !RADIO_COEX_HAVE_ARBITER
+    ESP_LOGI(TAG, "Software coexistence disabled; only BLE duty is adjusted");
+#endif
+    return ESP_OK;
+}
+
+void radio_coex_wifi_started(void)
+{
+    __atomic_store_n(&s_wifi_started, true, __ATOMIC_RELEASE);
+    // Before init there is no lock; init applies the mode
+    if (s_lock) {
+        apply();
+    }
+}
+
+void radio_coex_set_busy(radio_coex_source_t source, bool busy)
+{
+    if (source < 0 || source >= RADIO_COEX_SOURCE_COUNT) {
+        return;
+    }
+    uint32_t bit = 1u << source;
+    uint32_t before = busy ? __atomic_fetch_or(&s_busy_mask, bit, __ATOMIC_ACQ_REL)
+                           : __atomic_fetch_and(&s_busy_mask, ~bit, __ATOMIC_ACQ_REL);
+    uint32_t after = busy ? (before | bit) : (before & ~bit);
+    if (before == after) {
+        return;
+    }
+
+    // Before init the mask is all there is; init applies it
+    if (!s_restore_timer) {
+        return;
+    }
+    timer_wheel_stop(s_restore_timer);
+    if (after) {
+        apply();
+    } else {
+        schedule_restore();
+    }
+}
+
+void radio_coex_prewarm(void)
+{
+    __atomic_store_n(&s_prewarm_until_us, esp_timer_get_time() + (int64_t)CONFIG_KVA_WIFI_PS_PREWARM_MS * 1000,
+                     __ATOMIC_RELEASE);
+    if (!s_restore_timer) {
+        return;
+    }
+    apply();
+    if (__atomic_load_n(&s_busy_mask, __ATOMIC_ACQUIRE) == 0) {
+        schedule_restore();
+    }
+}
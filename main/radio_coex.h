@@ -0,0 +1,51 @@
+#pragma once
+
+#include <stdbool.h>
+
+#include "esp_err.h"
+#include "kva_config_defaults.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Wi-Fi and BLE share the one 2.4 GHz radio. While any source below is busy
+ * the coexistence arbiter prefers Wi-Fi and BLE drops to low duty (slow
+ * advertising, relaxed connection interval, no Wi-Fi scans requested over
+ * BLE), so audio streams are not starved of airtime. The balanced schedule
+ * comes back CONFIG_KVA_COEX_RESTORE_MS after the last source goes idle,
+ * which keeps a reply running straight into music from flapping it.
+ *
+ * With CONFIG_KVA_PM_WIFI_POWER_SAVE, Wi-Fi power save follows the same
+ * schedule: none while streaming (DTIM modem sleep if the BT controller is
+ * up, as coexistence requires), max modem sleep at
+ * CONFIG_KVA_WIFI_LISTEN_INTERVAL when idle, sleep monitoring included.
+ */
+typedef enum {
+    RADIO_COEX_INTERACTION,           // From wake to the end of the reply
+    RADIO_COEX_PLAYBACK,              // Assistant audio out
+    RADIO_COEX_SPOTIFY,               // Spotify Connect playing
+    RADIO_COEX_MULTIROOM,             // Leading or following multi-room playback
+    RADIO_COEX_SOURCE_COUNT,
+} radio_coex_source_t;
+
+// Create the restore timer; sources marked busy before this still count
+esp_err_t radio_coex_init(void);
+
+// Repeated calls are no-ops; callable from any task
+void radio_coex_set_busy(radio_coex_source_t source, bool busy);
+
+/**
+ * Streaming schedule now, ahead of an interaction that has not started: a
+ * wake word or speech onset, while the cloud connections are opened. Holds
+ * for CONFIG_KVA_WIFI_PS_PREWARM_MS unless a source keeps it longer.
+ */
+void radio_coex_prewarm(void);
+
+// The Wi-Fi driver is running, so its power save can be set; after esp_wifi_start()
+void radio_coex_wifi_started(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,4 +1,17 @@
 #include "serial_command_parser.h"
+#include "audio_graph.h"
+#include "bench_mode.h"
+#include "breath_monitor.h"
+#include "occupancy.h"
+#include "cpu_profiler.h"
+#include "deadline_monitor.h"
+#include "device_state.h"
+#include "dns_cache.h"
+#include "i2c_topology.h"
+#include "mem_telemetry.h"
+#include "multiroom_sync.h"
+#include "serial_link.h"
+#include "sound_bank.h"
 #include "spotify_client.h"
 
 #include <string.h>
@@ -8,89 +21,265 @@
 #include "driver/uart.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "task_placement.h"
+
+#if CONFIG_KVA_SERIAL_LINK_USB_JTAG
+#include "driver/usb_serial_jtag.h"
+#endif
+
+#define SERIAL_COMMAND_LINE_MAX 256
 
 static const char *TAG = "serial_cmd";
 
 static spotify_client_t *s_spotify_client = NULL;
 
-static void process_spotify_command(const char *cmd)
+static esp_err_t process_spotify_command(const char *cmd)
 {
     if (!s_spotify_client) {
         ESP_LOGW(TAG, "Spotify client not initialized");
-        return;
+        return ESP_ERR_INVALID_STATE;
     }
     
     if (strcmp(cmd, "SPOTIFY_PLAY") == 0) {
         ESP_LOGI(TAG, "Serial command: Spotify Play");
-        spotify_client_play(s_spotify_client, NULL);
+        return spotify_client_play(s_spotify_client, NULL);
     } else if (strcmp(cmd, "SPOTIFY_PAUSE") == 0) {
         ESP_LOGI(TAG, "Serial command: Spotify Pause");
-        spotify_client_pause(s_spotify_client);
+        return spotify_client_pause(s_spotify_client);
     } else if (strcmp(cmd, "SPOTIFY_RESUME") == 0) {
         ESP_LOGI(TAG, "Serial command: Spotify Resume");
-        spotify_client_resume(s_spotify_client);
+        return spotify_client_resume(s_spotify_client);
     } else if (strcmp(cmd, "SPOTIFY_VOLUME_UP") == 0) {
         ESP_LOGI(TAG, "Serial command: Spotify Volume Up");
-        spotify_client_volume_delta(s_spotify_client, s_spotify_client->volume_step);
+        return spotify_client_volume_delta(s_spotify_client, s_spotify_client->volume_step);
     } else if (strcmp(cmd, "SPOTIFY_VOLUME_DOWN") == 0) {
         ESP_LOGI(TAG, "Serial command: Spotify Volume Down");
-        spotify_client_volume_delta(s_spotify_client, -s_spotify_client->volume_step);
+        return spotify_client_volume_delta(s_spotify_client, -s_spotify_client->volume_step);
+    }
+    ESP_LOGW(TAG, "Unknown Spotify command: %s", cmd);
+    return ESP_ERR_NOT_FOUND;
+}
+
+// SOUND_PLAY <name> plays a bank sound as media, SOUND_CUE <name> as a UI
+// cue; SOUND_STOP stops both; SOUND_LIST logs the bank
+static esp_err_t process_sound_command(const char *cmd)
+{
+    esp_err_t err = ESP_OK;
+    if (strncmp(cmd, "SOUND_PLAY ", 11) == 0) {
+        err = sound_bank_play(cmd + 11, AUDIO_PLAYER_STREAM_MEDIA);
+    } else if (strncmp(cmd, "SOUND_CUE ", 10) == 0) {
+        err = sound_bank_play(cmd + 10, AUDIO_PLAYER_STREAM_UI);
+    } else if (strcmp(cmd, "SOUND_STOP") == 0) {
+        sound_bank_stop(AUDIO_PLAYER_STREAM_MEDIA);
+        err = sound_bank_stop(AUDIO_PLAYER_STREAM_UI);
+    } else if (strcmp(cmd, "SOUND_LIST") == 0) {
+        sound_bank_info_t info;
+        for (size_t i = 0; sound_bank_get(i, &info) == ESP_OK; ++i) {
+            ESP_LOGI(TAG, "  %-24s %5u ms %u Hz x%u%s%s", info.name,
+                     (unsigned)((uint64_t)info.frames * 1000 / info.rate_hz), (unsigned)info.rate_hz,
+                     (unsigned)info.channels, info.codec == SOUND_BANK_CODEC_IMA_ADPCM ? " adpcm" : "",
+                     (info.flags & SOUND_BANK_FLAG_LOOP) ? " loop" : "");
+        }
     } else {
-        ESP_LOGW(TAG, "Unknown Spotify command: %s", cmd);
+        ESP_LOGW(TAG, "Unknown sound command: %s", cmd);
+        return ESP_ERR_NOT_FOUND;
+    }
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "%s: %s", cmd, esp_err_to_name(err));
     }
+    return err;
 }
 
-static void serial_command_task(void *arg)
+// SYNC_LEADER, SYNC_FOLLOW and SYNC_OFF pick the multi-room role;
+// SYNC_STATUS logs the link
+static esp_err_t process_sync_command(const char *cmd)
 {
-    uint8_t *data = (uint8_t *)malloc(256);
-    if (!data) {
-        ESP_LOGE(TAG, "Failed to allocate command buffer");
-        vTaskDelete(NULL);
+    if (strcmp(cmd, "SYNC_LEADER") == 0) {
+        return multiroom_sync_set_role(MULTIROOM_ROLE_LEADER);
+    } else if (strcmp(cmd, "SYNC_FOLLOW") == 0) {
+        return multiroom_sync_set_role(MULTIROOM_ROLE_FOLLOWER);
+    } else if (strcmp(cmd, "SYNC_OFF") == 0) {
+        return multiroom_sync_set_role(MULTIROOM_ROLE_OFF);
+    } else if (strcmp(cmd, "SYNC_STATUS") == 0) {
+        multiroom_stats_t stats;
+        multiroom_sync_get_stats(&stats);
+        ESP_LOGI(TAG, "sync role %d packets %u lost %u resyncs %u skew %d us trim %d ppm rtt %d us%s",
+                 (int)stats.role, (unsigned)stats.packets, (unsigned)stats.lost, (unsigned)stats.resyncs,
+                 (int)stats.skew_us, (int)stats.trim_ppm, (int)stats.rtt_us,
+                 stats.clock_locked ? " locked" : "");
+        return ESP_OK;
+    }
+    ESP_LOGW(TAG, "Unknown sync command: %s", cmd);
+    return ESP_ERR_NOT_FOUND;
+}
+
+// Same syntax from a typed line and from a binary COMMAND frame
+static esp_err_t dispatch_command(const char *cmd, void *ctx)
+{
+    (void)ctx;
+    while (*cmd && isspace((unsigned char)*cmd)) {
+        cmd++;
+    }
+    if (!*cmd) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    ESP_LOGI(TAG, "Received command: %s", cmd);
+    if (strncmp(cmd, "SPOTIFY_", 8) == 0) {
+        return process_spotify_command(cmd);
+    } else if (strncmp(cmd, "SOUND_", 6) == 0) {
+        return process_sound_command(cmd);
+    } else if (strncmp(cmd, "SYNC_", 5) == 0) {
+        return process_sync_command(cmd);
+    } else if (strcmp(cmd, "SLEEP_ON") == 0 || strcmp(cmd, "SLEEP_OFF") == 0) {
+        device_state_set_sleep_mode(strcmp(cmd, "SLEEP_ON") == 0);
+        return ESP_OK;
+    } else if (strcmp(cmd, "SLEEP_STATUS") == 0) {
+        breath_monitor_stats_t breath;
+        breath_monitor_get(&breath);
+        ESP_LOGI(TAG, "sleep mode %s, breathing %s %.1f/min regularity %.2f (%u estimates)",
+                 device_state_sleep_mode() ? "on" : "off", breath.valid ? "steady" : "unclear",
+                 breath.breaths_per_min, breath.regularity, (unsigned)breath.estimates);
+        return ESP_OK;
+    } else if (strcmp(cmd, "OCCUPANCY") == 0) {
+        occupancy_stats_t occ;
+        occupancy_get_stats(&occ);
+        ESP_LOGI(TAG, "room %s, score %u, CO2 %.1f ppm/min, sound floor %.0f; seen s ago: prox %d act %d phone %d "
+                      "sound %d co2 %d",
+                 occupancy_state_name(occ.state), (unsigned)occ.score, occ.co2_ppm_per_min, occ.sound_floor_rms,
+                 (int)occ.seen_s_ago[OCCUPANCY_SOURCE_PROXIMITY], (int)occ.seen_s_ago[OCCUPANCY_SOURCE_ACTIVITY],
+                 (int)occ.seen_s_ago[OCCUPANCY_SOURCE_PHONE], (int)occ.seen_s_ago[OCCUPANCY_SOURCE_SOUND],
+                 (int)occ.seen_s_ago[OCCUPANCY_SOURCE_CO2]);
+        return ESP_OK;
+    } else if (strcmp(cmd, "I2C_RESCAN") == 0) {
+        esp_err_t err = i2c_topology_forget();
+        if (err == ESP_OK) {
+            ESP_LOGI(TAG, "I2C topology cleared; buses are scanned in full on the next boot");
+            return ESP_OK;
+        }
+        ESP_LOGW(TAG, "I2C topology not cleared: %s", esp_err_to_name(err));
+        return err;
+    } else if (strcmp(cmd, "MEM") == 0) {
+        mem_telemetry_log();
+        return ESP_OK;
+    } else if (strcmp(cmd, "TOP") == 0) {
+        cpu_profiler_log();
+        return ESP_OK;
+    } else if (strcmp(cmd, "GRAPH") == 0) {
+        audio_graph_log();
+        return ESP_OK;
+    } else if (strcmp(cmd, "DEADLINES") == 0) {
+        deadline_monitor_log();
+        return ESP_OK;
+    } else if (strcmp(cmd, "DNS") == 0) {
+        dns_cache_stats_t dns;
+        dns_cache_get_stats(&dns);
+        ESP_LOGI(TAG, "DNS cache: %lu hits, %lu misses, %lu lookups, %lu failed", (unsigned long)dns.hits,
+                 (unsigned long)dns.misses, (unsigned long)dns.refreshes, (unsigned long)dns.failures);
+        return ESP_OK;
+#if CONFIG_KVA_BENCH_MODE
+    } else if (strcmp(cmd, "BENCH") == 0) {
+        return bench_mode_play();
+#endif
+    }
+    ESP_LOGW(TAG, "Unknown command: %s", cmd);
+    return ESP_ERR_NOT_FOUND;
+}
+
+/*
+ * Text lines and binary frames share the port. A zero byte opens a frame
+ * and the next one closes it; bytes outside frames are text. A frame that
+ * does not decode was really text followed by an opening delimiter, so the
+ * closing zero starts a new frame instead and the reader resynchronizes.
+ */
+typedef struct {
+    char line[SERIAL_COMMAND_LINE_MAX];
+    size_t line_len;
+#if CONFIG_KVA_SERIAL_LINK_ENABLE
+    uint8_t frame[SERIAL_LINK_MAX_ENCODED];
+    size_t frame_len;
+    bool in_frame;
+    bool frame_overflow;
+#endif
+} serial_rx_t;
+
+static void rx_flush_line(serial_rx_t *rx)
+{
+    rx->line[rx->line_len] = '\0';
+    if (rx->line_len > 0) {
+        dispatch_command(rx->line, NULL);
+    }
+    rx->line_len = 0;
+}
+
+static void rx_byte(serial_rx_t *rx, uint8_t byte)
+{
+#if CONFIG_KVA_SERIAL_LINK_ENABLE
+    if (byte == 0) {
+        if (rx->in_frame && rx->frame_len > 0 && !rx->frame_overflow &&
+            serial_link_handle_frame(rx->frame, rx->frame_len) == ESP_OK) {
+            rx->in_frame = false;
+        } else {
+            rx->in_frame = true;
+        }
+        rx->frame_len = 0;
+        rx->frame_overflow = false;
         return;
     }
-    
+    if (rx->in_frame) {
+        if (rx->frame_len < sizeof(rx->frame)) {
+            rx->frame[rx->frame_len++] = byte;
+        } else {
+            rx->frame_overflow = true;
+        }
+        return;
+    }
+#endif
+    if (byte == '\n' || byte == '\r') {
+        rx_flush_line(rx);
+    } else if (rx->line_len < sizeof(rx->line) - 1) {
+        rx->line[rx->line_len++] = (char)byte;
+    }
+}
+
+static int serial_read(uint8_t *data, size_t len, TickType_t timeout)
+{
+#if CONFIG_KVA_SERIAL_LINK_USB_JTAG
+    return usb_serial_jtag_read_bytes(data, len, timeout);
+#else
+    return uart_read_bytes(UART_NUM_0, data, len, timeout);
+#endif
+}
+
+static void serial_command_task(void *arg)
+{
+    // Only this task touches it; too large for the stack
+    static serial_rx_t rx;
+    uint8_t data[128];
+
     ESP_LOGI(TAG, "Serial command parser task started");
     
     while (1) {
-        int len = uart_read_bytes(UART_NUM_0, data, 255, pdMS_TO_TICKS(100));
+        int len = serial_read(data, sizeof(data), pdMS_TO_TICKS(100));
         if (len < 0) {
             // UART driver error - likely console conflict, skip this read
             // Don't log every error to avoid spam, just wait and retry
             vTaskDelay(pdMS_TO_TICKS(100));
             continue;
         }
-        if (len > 0) {
-            data[len] = '\0';
-            
-            // Remove trailing newline/carriage return
-            while (len > 0 && (data[len-1] == '\n' || data[len-1] == '\r')) {
-                data[--len] = '\0';
-            }
-            
-            if (len > 0) {
-                char *cmd = (char *)data;
-                
-                // Skip leading whitespace
-                while (*cmd && isspace((unsigned char)*cmd)) {
-                    cmd++;
-                }
-                
-                if (*cmd) {
-                    ESP_LOGI(TAG, "Received command: %s", cmd);
-                    
-                    // Process commands
-                    if (strncmp(cmd, "SPOTIFY_", 8) == 0) {
-                        process_spotify_command(cmd);
-                    } else {
-                        ESP_LOGW(TAG, "Unknown command: %s", cmd);
-                    }
-                }
+        if (len == 0) {
+            // A command sent without a newline runs once the line goes quiet
+#if CONFIG_KVA_SERIAL_LINK_ENABLE
+            if (!rx.in_frame)
+#endif
+            {
+                rx_flush_line(&rx);
             }
+            continue;
+        }
+        for (int i = 0; i < len; ++i) {
+            rx_byte(&rx, data[i]);
         }
     }
-    
-    free(data);
-    vTaskDelete(NULL);
 }
 
 esp_err_t serial_command_parser_init(spotify_client_t *spotify_client)
@@ -99,7 +288,13 @@ esp_err_t serial_command_parser_init(spotify_client_t *spotify_client)
     
     // UART is already configured by ESP-IDF console, so we just need to read from it
     // Create task to read commands
-    xTaskCreate(serial_command_task, "serial_cmd", 4096, NULL, 5, NULL);
+    task_placement_create(TASK_PLACEMENT_SERIAL_COMMANDS, serial_command_task, NULL, NULL);
+#if CONFIG_KVA_SERIAL_LINK_ENABLE
+    esp_err_t err = serial_link_init(dispatch_command, NULL);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Binary serial link unavailable: %s", esp_err_to_name(err));
+    }
+#endif
     
     ESP_LOGI(TAG, "Serial command parser initialized");
     return ESP_OK;
@@ -0,0 +1,397 @@
+#include "serial_link.h"
+
+#include <string.h>
+
+#include "audio_meter.h"
+#include "bench_mode.h"
+#include "cpu_profiler.h"
+#include "driver/uart.h"
+#include "esp_check.h"
+#include "esp_log.h"
+#include "esp_rom_crc.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/ringbuf.h"
+#include "task_placement.h"
+
+#if CONFIG_KVA_SERIAL_LINK_USB_JTAG
+#include "driver/usb_serial_jtag.h"
+#endif
+
+#define SERIAL_LINK_DEFAULT_PERIOD_MS 100
+#define SERIAL_LINK_CPU_PERIOD_MS 1000    // The profiler's own sample period
+#define SERIAL_LINK_CPU_TASKS 8
+
+static const char *TAG = "serial_link";
+
+static RingbufHandle_t s_ring;
+static esp_timer_handle_t s_timer;
+static serial_link_command_cb_t s_command_cb;
+static void *s_command_ctx;
+static uint32_t s_streams;            // Subscribed serial_link_stream_t bits (atomic)
+static uint32_t s_period_ms = SERIAL_LINK_DEFAULT_PERIOD_MS;
+static int64_t s_last_cpu_us;
+static uint8_t s_seq;                 // Device frame counter (atomic)
+static uint32_t s_dropped;            // Device frames that did not fit (atomic)
+static uint32_t s_audio_frames;       // Capture frames offered since the audio stream started
+
+// COBS writer: zero bytes are replaced by the distance to the next one
+typedef struct {
+    uint8_t *out;
+    size_t pos;
+    size_t code_pos;
+    uint8_t code;
+} cobs_writer_t;
+
+static void cobs_begin(cobs_writer_t *w, uint8_t *out)
+{
+    w->out = out;
+    w->code_pos = 0;
+    w->pos = 1;
+    w->code = 1;
+}
+
+static void cobs_put(cobs_writer_t *w, uint8_t byte)
+{
+    if (byte != 0) {
+        w->out[w->pos++] = byte;
+        w->code++;
+    }
+    if (byte == 0 || w->code == 0xFF) {
+        w->out[w->code_pos] = w->code;
+        w->code_pos = w->pos++;
+        w->code = 1;
+    }
+}
+
+static size_t cobs_end(cobs_writer_t *w)
+{
+    w->out[w->code_pos] = w->code;
+    return w->pos;
+}
+
+static size_t cobs_max_encoded(size_t len)
+{
+    return len + len / 254 + 1;
+}
+
+// In place is not allowed; returns the decoded length, 0 if malformed
+static size_t cobs_decode(const uint8_t *in, size_t len, uint8_t *out, size_t out_size)
+{
+    size_t pos = 0;
+    size_t written = 0;
+    while (pos < len) {
+        uint8_t code = in[pos++];
+        if (code == 0 || pos + code - 1 > len) {
+            return 0;
+        }
+        for (uint8_t i = 1; i < code; ++i) {
+            if (written >= out_size) {
+                return 0;
+            }
+            out[written++] = in[pos++];
+        }
+        if (code != 0xFF && pos < len) {
+            if (written >= out_size) {
+                return 0;
+            }
+            out[written++] = 0;
+        }
+    }
+    return written;
+}
+
+// One frame from up to two payload parts, encoded straight into the ring
+static bool publish_parts(serial_link_frame_type_t type, const void *head, size_t head_len, const void *body,
+                          size_t body_len, TickType_t wait)
+{
+    size_t payload_len = head_len + body_len;
+    if (!s_ring || payload_len > SERIAL_LINK_MAX_PAYLOAD) {
+        return false;
+    }
+    // Item: wire length, then 0x00 | COBS(type, seq, payload, crc) | 0x00
+    size_t max_wire = 2 + cobs_max_encoded(2 + payload_len + 2);
+    void *item = NULL;
+    if (xRingbufferSendAcquire(s_ring, &item, sizeof(uint16_t) + max_wire, wait) != pdTRUE) {
+        __atomic_fetch_add(&s_dropped, 1, __ATOMIC_RELAXED);
+        return false;
+    }
+    uint8_t *wire = (uint8_t *)item + sizeof(uint16_t);
+    uint8_t header[2] = {(uint8_t)type, __atomic_fetch_add(&s_seq, 1, __ATOMIC_RELAXED)};
+    uint16_t crc = esp_rom_crc16_le(0, header, sizeof(header));
+    if (head_len) {
+        crc = esp_rom_crc16_le(crc, head, head_len);
+    }
+    if (body_len) {
+        crc = esp_rom_crc16_le(crc, body, body_len);
+    }
+
+    cobs_writer_t w;
+    wire[0] = 0;
+    cobs_begin(&w, wire + 1);
+    cobs_put(&w, header[0]);
+    cobs_put(&w, header[1]);
+    for (size_t i = 0; i < head_len; ++i) {
+        cobs_put(&w, ((const uint8_t *)head)[i]);
+    }
+    for (size_t i = 0; i < body_len; ++i) {
+        cobs_put(&w, ((const uint8_t *)body)[i]);
+    }
+    cobs_put(&w, (uint8_t)(crc & 0xFF));
+    cobs_put(&w, (uint8_t)(crc >> 8));
+    size_t wire_len = 1 + cobs_end(&w);
+    wire[wire_len++] = 0;
+
+    uint16_t stored = (uint16_t)wire_len;
+    memcpy(item, &stored, sizeof(stored));
+    xRingbufferSendComplete(s_ring, item);
+    return true;
+}
+
+bool serial_link_publish(serial_link_frame_type_t type, const void *payload, size_t len)
+{
+    return publish_parts(type, payload, len, NULL, 0, 0);
+}
+
+bool serial_link_publish_parts(serial_link_frame_type_t type, const void *head, size_t head_len,
+                               const void *body, size_t body_len, uint32_t wait_ms)
+{
+    return publish_parts(type, head, head_len, body, body_len, pdMS_TO_TICKS(wait_ms));
+}
+
+bool serial_link_wants(uint32_t streams)
+{
+    return (__atomic_load_n(&s_streams, __ATOMIC_RELAXED) & streams) != 0;
+}
+
+static uint32_t now_ms(void)
+{
+    return (uint32_t)(esp_timer_get_time() / 1000);
+}
+
+static void publish_levels(void)
+{
+    audio_meter_levels_t levels;
+    audio_meter_get(&levels);
+    bool fresh = levels.processed_us && esp_timer_get_time() - levels.processed_us < AUDIO_METER_STALE_MS * 1000LL;
+    serial_link_levels_t msg = {
+        .time_ms = now_ms(),
+        .mic_rms = {levels.mic[0].rms, levels.mic[1].rms},
+        .mic_peak = {levels.mic[0].peak, levels.mic[1].peak},
+        .processed_rms = fresh ? levels.processed.rms : 0.0f,
+        .frames_dropped = __atomic_load_n(&s_dropped, __ATOMIC_RELAXED),
+    };
+    serial_link_publish(SERIAL_LINK_FRAME_LEVELS, &msg, sizeof(msg));
+}
+
+static void publish_cpu(void)
+{
+    cpu_profiler_task_load_t top[SERIAL_LINK_CPU_TASKS];
+    size_t count = cpu_profiler_top(top, SERIAL_LINK_CPU_TASKS, CPU_PROFILER_WINDOW_1S);
+
+    serial_link_cpu_t head = {.time_ms = now_ms(), .tasks = (uint8_t)count};
+    for (int core = 0; core < 2; ++core) {
+        float pct;
+        head.core_load[core] = cpu_profiler_core_load(core, CPU_PROFILER_WINDOW_1S, &pct) == ESP_OK ? pct : -1.0f;
+    }
+    serial_link_cpu_task_t tasks[SERIAL_LINK_CPU_TASKS];
+    for (size_t i = 0; i < count; ++i) {
+        memset(tasks[i].name, 0, sizeof(tasks[i].name));
+        strncpy(tasks[i].name, top[i].name, sizeof(tasks[i].name));
+        tasks[i].core = (int8_t)top[i].core;
+        tasks[i].load_pct = top[i].load_pct;
+    }
+    publish_parts(SERIAL_LINK_FRAME_CPU, &head, sizeof(head), tasks, count * sizeof(tasks[0]), 0);
+}
+
+static void telemetry_timer_cb(void *arg)
+{
+    (void)arg;
+    if (serial_link_wants(SERIAL_LINK_STREAM_LEVELS)) {
+        publish_levels();
+    }
+    int64_t now = esp_timer_get_time();
+    if (serial_link_wants(SERIAL_LINK_STREAM_CPU) && now - s_last_cpu_us >= SERIAL_LINK_CPU_PERIOD_MS * 1000LL) {
+        s_last_cpu_us = now;
+        publish_cpu();
+    }
+}
+
+static void serial_link_write(const uint8_t *data, size_t len)
+{
+#if CONFIG_KVA_SERIAL_LINK_USB_JTAG
+    usb_serial_jtag_write_bytes(data, len, portMAX_DELAY);
+#else
+    // One call per frame: the driver's TX lock keeps log lines out of it
+    uart_write_bytes(UART_NUM_0, data, len);
+#endif
+}
+
+static void serial_link_task(void *arg)
+{
+    (void)arg;
+    while (true) {
+        size_t size = 0;
+        uint8_t *item = xRingbufferReceive(s_ring, &size, portMAX_DELAY);
+        if (!item) {
+            continue;
+        }
+        uint16_t wire_len;
+        memcpy(&wire_len, item, sizeof(wire_len));
+        serial_link_write(item + sizeof(wire_len), wire_len);
+        vRingbufferReturnItem(s_ring, item);
+    }
+}
+
+static esp_err_t apply_subscription(const serial_link_subscribe_t *sub)
+{
+    uint32_t previous = __atomic_exchange_n(&s_streams, sub->streams, __ATOMIC_RELAXED);
+    if ((sub->streams & SERIAL_LINK_STREAM_AUDIO) && !(previous & SERIAL_LINK_STREAM_AUDIO)) {
+        __atomic_store_n(&s_audio_frames, 0, __ATOMIC_RELAXED);
+    }
+    if (sub->period_ms) {
+        s_period_ms = sub->period_ms;
+    }
+    esp_timer_stop(s_timer);
+    if (sub->streams & (SERIAL_LINK_STREAM_LEVELS | SERIAL_LINK_STREAM_CPU)) {
+        ESP_RETURN_ON_ERROR(esp_timer_start_periodic(s_timer, (uint64_t)s_period_ms * 1000), TAG, "timer");
+    }
+    ESP_LOGI(TAG, "Streams 0x%02x every %u ms", (unsigned)sub->streams, (unsigned)s_period_ms);
+    return ESP_OK;
+}
+
+esp_err_t serial_link_handle_frame(const uint8_t *encoded, size_t len)
+{
+    // Only the serial command task receives
+    static uint8_t frame[SERIAL_LINK_MAX_PAYLOAD + 4];
+    static char command[SERIAL_LINK_MAX_PAYLOAD + 1];
+
+    size_t n = cobs_decode(encoded, len, frame, sizeof(frame));
+    if (n < 4) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    uint16_t crc = (uint16_t)(frame[n - 2] | (frame[n - 1] << 8));
+    if (esp_rom_crc16_le(0, frame, n - 2) != crc) {
+        return ESP_ERR_INVALID_CRC;
+    }
+    uint8_t type = frame[0];
+    const uint8_t *payload = frame + 2;
+    size_t payload_len = n - 4;
+
+    serial_link_result_t result = {.seq = frame[1], .status = ESP_ERR_NOT_SUPPORTED};
+    switch (type) {
+    case SERIAL_LINK_FRAME_COMMAND:
+        memcpy(command, payload, payload_len);
+        command[payload_len] = '\0';
+        result.status = s_command_cb ? s_command_cb(command, s_command_ctx) : ESP_ERR_INVALID_STATE;
+        break;
+    case SERIAL_LINK_FRAME_SUBSCRIBE:
+        if (payload_len == sizeof(serial_link_subscribe_t)) {
+            serial_link_subscribe_t sub;
+            memcpy(&sub, payload, sizeof(sub));
+            result.status = apply_subscription(&sub);
+        } else {
+            result.status = ESP_ERR_INVALID_SIZE;
+        }
+        break;
+#if CONFIG_KVA_BENCH_MODE
+    case SERIAL_LINK_FRAME_BENCH_AUDIO:
+        if (payload_len >= sizeof(serial_link_bench_audio_t) &&
+            (payload_len - sizeof(serial_link_bench_audio_t)) % sizeof(int16_t) == 0) {
+            serial_link_bench_audio_t head;
+            memcpy(&head, payload, sizeof(head));
+            // frame is static and 4-aligned, and the header is 8 bytes, so the PCM is aligned
+            result.status = bench_mode_load(head.total_frames, head.first_frame,
+                                            (const int16_t *)(payload + sizeof(head)),
+                                            (payload_len - sizeof(head)) / sizeof(int16_t));
+        } else {
+            result.status = ESP_ERR_INVALID_SIZE;
+        }
+        break;
+#endif
+    default:
+        break;
+    }
+    serial_link_publish(SERIAL_LINK_FRAME_RESULT, &result, sizeof(result));
+    return ESP_OK;
+}
+
+void serial_link_tap_audio(const int16_t *interleaved, size_t samples, uint8_t channels)
+{
+    if (!serial_link_wants(SERIAL_LINK_STREAM_AUDIO) || !interleaved || channels == 0) {
+        return;
+    }
+    const size_t max_frames = (SERIAL_LINK_MAX_PAYLOAD - sizeof(serial_link_audio_t)) / (sizeof(int16_t) * channels);
+    size_t frames = samples / channels;
+    while (frames > 0) {
+        size_t chunk = frames < max_frames ? frames : max_frames;
+        serial_link_audio_t head = {
+            .first_frame = __atomic_fetch_add(&s_audio_frames, (uint32_t)chunk, __ATOMIC_RELAXED),
+            .channels = channels,
+        };
+        // A dropped chunk still advances first_frame, so the host sees the gap
+        publish_parts(SERIAL_LINK_FRAME_AUDIO, &head, sizeof(head), interleaved, chunk * channels * sizeof(int16_t),
+                      0);
+        interleaved += chunk * channels;
+        frames -= chunk;
+    }
+}
+
+void serial_link_tap_vad(uint8_t event, bool speech, bool in_speech, float energy, float noise_floor)
+{
+    if (!serial_link_wants(SERIAL_LINK_STREAM_VAD)) {
+        return;
+    }
+    serial_link_vad_t msg = {
+        .time_ms = now_ms(),
+        .event = event,
+        .speech = speech,
+        .in_speech = in_speech,
+        .energy = energy,
+        .noise_floor = noise_floor,
+    };
+    serial_link_publish(SERIAL_LINK_FRAME_VAD, &msg, sizeof(msg));
+}
+
+void serial_link_tap_wake(float score, float threshold, bool detected)
+{
+    if (!serial_link_wants(SERIAL_LINK_STREAM_WAKE)) {
+        return;
+    }
+    serial_link_wake_t msg = {
+        .time_ms = now_ms(),
+        .score = score,
+        .threshold = threshold,
+        .detected = detected,
+    };
+    serial_link_publish(SERIAL_LINK_FRAME_WAKE, &msg, sizeof(msg));
+}
+
+esp_err_t serial_link_init(serial_link_command_cb_t command_cb, void *ctx)
+{
+    ESP_RETURN_ON_FALSE(!s_ring, ESP_ERR_INVALID_STATE, TAG, "already running");
+    s_command_cb = command_cb;
+    s_command_ctx = ctx;
+
+    const esp_timer_create_args_t timer_args = {
+        .callback = telemetry_timer_cb,
+        .name = "serial_link",
+    };
+    ESP_RETURN_ON_ERROR(esp_timer_create(&timer_args, &s_timer), TAG, "timer");
+    RingbufHandle_t ring = xRingbufferCreate(CONFIG_KVA_SERIAL_LINK_TX_BUFFER, RINGBUF_TYPE_NOSPLIT);
+    if (!ring) {
+        esp_timer_delete(s_timer);
+        s_timer = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+    s_ring = ring;
+    if (task_placement_create(TASK_PLACEMENT_SERIAL_LINK, serial_link_task, NULL, NULL) != pdPASS) {
+        s_ring = NULL;
+        vRingbufferDelete(ring);
+        esp_timer_delete(s_timer);
+        s_timer = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+    ESP_LOGI(TAG, "Binary link up (%u byte TX buffer)", (unsigned)CONFIG_KVA_SERIAL_LINK_TX_BUFFER);
+    return ESP_OK;
+}
@@ -0,0 +1,202 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "kva_config_defaults.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Binary control and telemetry frames on the console port, next to the
+ * logs. Each frame is COBS-encoded and wrapped in zero bytes, which text
+ * logs never contain:
+ *
+ *   0x00 | COBS(type, seq, payload..., crc16 LE) | 0x00
+ *
+ * The CRC is esp_rom_crc16_le(0, ...) over type, seq and payload, which is
+ * CRC-16/X-25 (reflected 0x1021, init and xorout 0xFFFF).
+ * All fields are little-endian. Wire format and stream payloads:
+ * docs/SERIAL_LINK_PROTOCOL.md; host side: scripts/serial_link.py.
+ *
+ * Publishing never blocks: frames are encoded straight into a ring buffer
+ * that a low-priority task writes out, and a frame that does not fit is
+ * dropped and counted.
+ */
+
+#define SERIAL_LINK_MAX_PAYLOAD 1024
+// Longest frame between its delimiters: header, payload and CRC plus COBS overhead
+#define SERIAL_LINK_MAX_ENCODED (SERIAL_LINK_MAX_PAYLOAD + 4 + (SERIAL_LINK_MAX_PAYLOAD + 4) / 254 + 1)
+
+typedef enum {
+    // Host to device
+    SERIAL_LINK_FRAME_COMMAND = 0x01,     // Text command, as typed on the console (no terminator)
+    SERIAL_LINK_FRAME_SUBSCRIBE = 0x02,   // serial_link_subscribe_t
+    SERIAL_LINK_FRAME_BENCH_AUDIO = 0x03, // serial_link_bench_audio_t, then mono int16 PCM (bench_mode.h)
+    // Device to host
+    SERIAL_LINK_FRAME_RESULT = 0x81,      // serial_link_result_t, for each host frame
+    SERIAL_LINK_FRAME_LEVELS = 0x10,      // serial_link_levels_t
+    SERIAL_LINK_FRAME_VAD = 0x11,         // serial_link_vad_t, one per AFE frame
+    SERIAL_LINK_FRAME_WAKE = 0x12,        // serial_link_wake_t, one per wake-word frame
+    SERIAL_LINK_FRAME_CPU = 0x13,         // serial_link_cpu_t, then `tasks` serial_link_cpu_task_t
+    SERIAL_LINK_FRAME_AUDIO = 0x20,       // serial_link_audio_t, then interleaved int16 PCM
+    SERIAL_LINK_FRAME_CAPTURE_BEGIN = 0x21,   // serial_link_capture_begin_t
+    SERIAL_LINK_FRAME_CAPTURE_AUDIO = 0x22,   // serial_link_capture_audio_t, then interleaved int16 PCM
+    SERIAL_LINK_FRAME_CAPTURE_SCORES = 0x23,  // serial_link_capture_scores_t, then `count` serial_link_capture_score_t
+    SERIAL_LINK_FRAME_CAPTURE_END = 0x24,     // serial_link_capture_end_t
+    SERIAL_LINK_FRAME_LOG = 0x30,         // deferred_log_record_t, then its arguments (log_drain.h)
+} serial_link_frame_type_t;
+
+typedef enum {
+    SERIAL_LINK_STREAM_LEVELS = 1u << 0,
+    SERIAL_LINK_STREAM_VAD = 1u << 1,
+    SERIAL_LINK_STREAM_WAKE = 1u << 2,
+    SERIAL_LINK_STREAM_CPU = 1u << 3,
+    SERIAL_LINK_STREAM_AUDIO = 1u << 4,   // Raw stereo capture; needs about 600 kbit/s at 16 kHz
+    SERIAL_LINK_STREAM_WAKE_CAPTURE = 1u << 5,  // Audio around wake events and near misses (wake_capture.h)
+    SERIAL_LINK_STREAM_LOG = 1u << 6,     // DLOG* records unformatted, instead of as text
+} serial_link_stream_t;
+
+typedef struct __attribute__((packed)) {
+    uint32_t streams;                 // serial_link_stream_t bits; 0 stops everything
+    uint16_t period_ms;               // LEVELS and CPU; 0 keeps the current period
+} serial_link_subscribe_t;
+
+// One piece of the benchmark utterance, at the capture rate; pieces arrive in order
+typedef struct __attribute__((packed)) {
+    uint32_t total_frames;            // Of the whole utterance
+    uint32_t first_frame;             // Of this piece; 0 starts a new utterance
+} serial_link_bench_audio_t;
+
+typedef struct __attribute__((packed)) {
+    uint8_t seq;                      // Of the host frame answered
+    int32_t status;                   // esp_err_t
+} serial_link_result_t;
+
+typedef struct __attribute__((packed)) {
+    uint32_t time_ms;
+    float mic_rms[2];
+    float mic_peak[2];
+    float processed_rms;              // 0 while the AFE output is stale
+    uint32_t frames_dropped;          // Device frames lost to a full TX buffer, since boot
+} serial_link_levels_t;
+
+typedef struct __attribute__((packed)) {
+    uint32_t time_ms;
+    uint8_t event;                    // vad_gate_event_t
+    uint8_t speech;                   // This frame's vote
+    uint8_t in_speech;
+    float energy;
+    float noise_floor;
+} serial_link_vad_t;
+
+typedef struct __attribute__((packed)) {
+    uint32_t time_ms;
+    float score;                      // Detector's own unit: energy, or model probability
+    float threshold;
+    uint8_t detected;
+} serial_link_wake_t;
+
+typedef struct __attribute__((packed)) {
+    uint32_t time_ms;
+    float core_load[2];               // 1 s window, -1 before the profiler has two samples
+    uint8_t tasks;
+} serial_link_cpu_t;
+
+typedef struct __attribute__((packed)) {
+    char name[16];
+    int8_t core;
+    float load_pct;
+} serial_link_cpu_task_t;
+
+typedef struct __attribute__((packed)) {
+    uint32_t first_frame;             // Capture frames since the stream started, dropped ones included
+    uint8_t channels;
+    uint8_t reserved;
+} serial_link_audio_t;
+
+// One wake-capture window: BEGIN, then AUDIO and SCORES, then END, all with the same id
+typedef struct __attribute__((packed)) {
+    uint16_t id;                      // Captures since boot
+    uint8_t source;                   // wake_capture_source_t
+    uint8_t outcome;                  // wake_capture_outcome_t
+    uint32_t time_ms;                 // Of the event
+    float score;                      // Peak score, detector's own unit
+    float threshold;
+    uint16_t sample_rate_hz;
+    uint16_t preroll_ms;
+    uint16_t postroll_ms;
+    uint8_t raw_channels;
+} serial_link_capture_begin_t;
+
+typedef struct __attribute__((packed)) {
+    uint16_t id;
+    uint8_t track;                    // 0 raw capture, 1 AFE output
+    uint8_t channels;
+    uint32_t first_frame;             // From the start of this track's window
+} serial_link_capture_audio_t;
+
+typedef struct __attribute__((packed)) {
+    uint16_t id;
+    uint8_t count;
+} serial_link_capture_scores_t;
+
+typedef struct __attribute__((packed)) {
+    uint32_t frame;                   // Raw-track frame the score was computed at
+    float score;
+} serial_link_capture_score_t;
+
+typedef struct __attribute__((packed)) {
+    uint16_t id;
+    uint32_t raw_frames;              // Sent, per track
+    uint32_t processed_frames;
+    uint32_t lost_frames;             // Raw frames overwritten or not sent in time
+} serial_link_capture_end_t;
+
+/**
+ * Run a text command (the console syntax) and return its status for the
+ * RESULT frame. Called from the serial command task.
+ */
+typedef esp_err_t (*serial_link_command_cb_t)(const char *command, void *ctx);
+
+// Start the writer task and the telemetry timer; streams stay off until a host subscribes
+esp_err_t serial_link_init(serial_link_command_cb_t command_cb, void *ctx);
+
+/**
+ * Decode and act on one received frame: the bytes between two zero
+ * delimiters, delimiters excluded.
+ *
+ * @return ESP_ERR_INVALID_CRC (or INVALID_SIZE) if it is not a valid frame;
+ *         the caller then treats the closing delimiter as an opening one
+ */
+esp_err_t serial_link_handle_frame(const uint8_t *encoded, size_t len);
+
+// Whether any of the streams is subscribed; lets producers skip building a payload
+bool serial_link_wants(uint32_t streams);
+
+// Queue a frame; false if the TX buffer is full or the link is not running
+bool serial_link_publish(serial_link_frame_type_t type, const void *payload, size_t len);
+
+/**
+ * Queue a frame whose payload is a header followed by a body, waiting up to
+ * wait_ms for TX space. Only for producers off the audio path that would
+ * rather slow down than lose data.
+ */
+bool serial_link_publish_parts(serial_link_frame_type_t type, const void *head, size_t head_len,
+                               const void *body, size_t body_len, uint32_t wait_ms);
+
+/**
+ * Producer taps, cheap no-ops while their stream is not subscribed.
+ * The audio tap splits the block into frames and copies it; it never blocks.
+ */
+void serial_link_tap_audio(const int16_t *interleaved, size_t samples, uint8_t channels);
+void serial_link_tap_vad(uint8_t event, bool speech, bool in_speech, float energy, float noise_floor);
+void serial_link_tap_wake(float score, float threshold, bool detected);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,440 @@
+#include "sound_bank.h"
+
+#include <string.h>
+
+#include "esp_check.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_partition.h"
+#include "esp_rom_crc.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "task_placement.h"
+
+#define BANK_MAGIC 0x3142534EU        // 'NSB1'
+#define BANK_VERSION 1
+// Frames offered to the mixer per enqueue
+#define FEED_FRAMES 1024
+// Wait between passes while every ring is full
+#define FEED_RETRY_MS 10
+
+typedef struct __attribute__((packed)) {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t count;
+    uint32_t used_bytes;
+    uint32_t index_crc;
+} bank_header_t;
+
+typedef struct __attribute__((packed)) {
+    char name[SOUND_BANK_NAME_LEN];
+    uint32_t offset;
+    uint32_t bytes;
+    uint32_t frames;
+    uint32_t rate_hz;
+    uint8_t channels;
+    uint8_t codec;
+    uint8_t flags;
+    uint8_t reserved0;
+    uint32_t reserved1;
+} bank_entry_t;
+
+_Static_assert(sizeof(bank_entry_t) == 48, "sound bank entry layout");
+
+typedef struct {
+    sound_bank_clip_t clip;           // Owned by the feeder task
+    bool playing;
+    uint32_t frame;                   // Next frame to queue
+    // ADPCM: the decoded block and how much of it is queued
+    uint32_t block_start;
+    uint32_t block_frames;
+    uint32_t block_used;
+    int16_t *pcm;                     // SOUND_BANK_ADPCM_BLOCK_FRAMES stereo frames
+    // Requests from sound_bank_play/stop, under s_lock; a clip of 0 frames stops
+    bool pending;
+    sound_bank_clip_t request;
+} voice_t;
+
+static const char *TAG = "sound_bank";
+
+static const uint8_t *s_base;
+static const bank_entry_t *s_index;
+static size_t s_count;
+static esp_partition_mmap_handle_t s_mmap;
+static voice_t *s_voices;             // One per mixer stream
+static TaskHandle_t s_task;
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static const int16_t IMA_STEPS[89] = {
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45, 50, 55, 60,
+    66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230, 253, 279, 307, 337, 371,
+    408, 449, 494, 544, 598, 658, 724, 796, 876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878,
+    2066, 2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845,
+    8630, 9493, 10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086,
+    29794, 32767,
+};
+static const int8_t IMA_INDEX_STEP[8] = {-1, -1, -1, -1, 2, 4, 6, 8};
+
+static int16_t ima_decode(uint8_t nibble, int32_t *predictor, int32_t *index)
+{
+    int32_t step = IMA_STEPS[*index];
+    int32_t diff = step >> 3;
+    if (nibble & 4) {
+        diff += step;
+    }
+    if (nibble & 2) {
+        diff += step >> 1;
+    }
+    if (nibble & 1) {
+        diff += step >> 2;
+    }
+    int32_t p = (nibble & 8) ? *predictor - diff : *predictor + diff;
+    *predictor = p > INT16_MAX ? INT16_MAX : (p < INT16_MIN ? INT16_MIN : p);
+    int32_t i = *index + IMA_INDEX_STEP[nibble & 7];
+    *index = i < 0 ? 0 : (i > 88 ? 88 : i);
+    return (int16_t)*predictor;
+}
+
+static uint8_t ima_encode(int16_t sample, int32_t *predictor, int32_t *index)
+{
+    int32_t step = IMA_STEPS[*index];
+    int32_t diff = sample - *predictor;
+    uint8_t nibble = 0;
+    if (diff < 0) {
+        nibble = 8;
+        diff = -diff;
+    }
+    // Mirrors ima_decode() bit by bit, so both sides track the same predictor
+    if (diff >= step) {
+        nibble |= 4;
+        diff -= step;
+    }
+    if (diff >= step >> 1) {
+        nibble |= 2;
+        diff -= step >> 1;
+    }
+    if (diff >= step >> 2) {
+        nibble |= 1;
+    }
+    ima_decode(nibble, predictor, index);
+    return nibble;
+}
+
+size_t sound_bank_adpcm_block_bytes(uint32_t frames, uint8_t channels)
+{
+    return 4u * channels + (frames * channels + 1) / 2;
+}
+
+size_t sound_bank_adpcm_encode_block(const int16_t *pcm, uint32_t frames, int32_t *index, uint8_t *out)
+{
+    if (frames == 0 || frames > SOUND_BANK_ADPCM_BLOCK_FRAMES) {
+        return 0;
+    }
+    // Each block restarts from its first sample, so a decoder can seek to it
+    int32_t predictor = pcm[0];
+    int32_t i = *index < 0 ? 0 : (*index > 88 ? 88 : *index);
+    out[0] = (uint8_t)(predictor & 0xFF);
+    out[1] = (uint8_t)((predictor >> 8) & 0xFF);
+    out[2] = (uint8_t)i;
+    out[3] = 0;
+    uint8_t *nibbles = out + 4;
+    for (uint32_t n = 0; n < frames; ++n) {
+        uint8_t nibble = ima_encode(pcm[n], &predictor, &i);
+        if (n & 1) {
+            nibbles[n / 2] |= (uint8_t)(nibble << 4);
+        } else {
+            nibbles[n / 2] = nibble;
+        }
+    }
+    *index = i;
+    return sound_bank_adpcm_block_bytes(frames, 1);
+}
+
+// Decode the block holding v->frame into v->pcm
+static void adpcm_load_block(voice_t *v)
+{
+    const sound_bank_clip_t *c = &v->clip;
+    uint32_t block = v->frame / SOUND_BANK_ADPCM_BLOCK_FRAMES;
+    uint32_t start = block * SOUND_BANK_ADPCM_BLOCK_FRAMES;
+    uint32_t frames = c->frames - start;
+    if (frames > SOUND_BANK_ADPCM_BLOCK_FRAMES) {
+        frames = SOUND_BANK_ADPCM_BLOCK_FRAMES;
+    }
+    const uint8_t *src = c->data + block * sound_bank_adpcm_block_bytes(SOUND_BANK_ADPCM_BLOCK_FRAMES, c->channels);
+
+    int32_t predictor[2];
+    int32_t index[2];
+    for (int ch = 0; ch < c->channels; ++ch) {
+        predictor[ch] = (int16_t)(src[0] | (src[1] << 8));
+        index[ch] = src[2] > 88 ? 88 : src[2];
+        src += 4;
+    }
+    uint32_t samples = frames * c->channels;
+    for (uint32_t n = 0; n < samples; ++n) {
+        uint8_t byte = src[n / 2];
+        uint8_t nibble = (n & 1) ? byte >> 4 : byte & 0x0F;
+        int ch = (int)(n % c->channels);
+        v->pcm[n] = ima_decode(nibble, &predictor[ch], &index[ch]);
+    }
+    v->block_start = start;
+    v->block_frames = frames;
+    v->block_used = v->frame - start;
+}
+
+// Queue what the stream's ring takes; true when anything went in
+static bool voice_feed(voice_t *v, audio_player_stream_t stream)
+{
+    const sound_bank_clip_t *e = &v->clip;
+    if (v->frame >= e->frames) {
+        if (!(e->flags & SOUND_BANK_FLAG_LOOP)) {
+            v->playing = false;
+            return false;
+        }
+        v->frame = 0;
+        v->block_frames = 0;
+    }
+
+    const int16_t *src;
+    size_t frames;
+    if (e->codec == SOUND_BANK_CODEC_PCM16) {
+        src = (const int16_t *)e->data + (size_t)v->frame * e->channels;
+        frames = e->frames - v->frame;
+    } else {
+        if (v->block_used >= v->block_frames) {
+            adpcm_load_block(v);
+        }
+        src = v->pcm + (size_t)v->block_used * e->channels;
+        frames = v->block_frames - v->block_used;
+    }
+    if (frames > FEED_FRAMES) {
+        frames = FEED_FRAMES;
+    }
+
+    size_t queued = 0;
+    audio_player_enqueue_pcm(stream, src, frames, (int)e->rate_hz, e->channels, &queued);
+    v->frame += queued;
+    v->block_used += queued;
+    return queued > 0;
+}
+
+static void feeder_task(void *arg)
+{
+    (void)arg;
+    while (true) {
+        bool active = false;
+        bool progress = false;
+        for (int id = 0; id < AUDIO_PLAYER_STREAM_COUNT; ++id) {
+            voice_t *v = &s_voices[id];
+            bool pending;
+            sound_bank_clip_t request;
+            portENTER_CRITICAL(&s_lock);
+            pending = v->pending;
+            request = v->request;
+            v->pending = false;
+            portEXIT_CRITICAL(&s_lock);
+            if (pending) {
+                if (v->playing) {
+                    // The old sound's queue would delay the new one, or hold a rate change
+                    audio_player_flush((audio_player_stream_t)id);
+                }
+                v->clip = request;
+                v->playing = request.frames > 0;
+                v->frame = 0;
+                v->block_frames = 0;
+                v->block_used = 0;
+            }
+            if (v->playing) {
+                progress |= voice_feed(v, (audio_player_stream_t)id);
+                active |= v->playing;
+            }
+        }
+        if (!active) {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        } else if (!progress) {
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(FEED_RETRY_MS));
+        }
+    }
+}
+
+static bool index_is_valid(const bank_header_t *hdr)
+{
+    for (size_t i = 0; i < hdr->count; ++i) {
+        const bank_entry_t *e = &s_index[i];
+        size_t need = e->codec == SOUND_BANK_CODEC_PCM16
+                          ? (size_t)e->frames * e->channels * sizeof(int16_t)
+                          : (size_t)(e->frames / SOUND_BANK_ADPCM_BLOCK_FRAMES) *
+                                    sound_bank_adpcm_block_bytes(SOUND_BANK_ADPCM_BLOCK_FRAMES, e->channels) +
+                                (e->frames % SOUND_BANK_ADPCM_BLOCK_FRAMES
+                                     ? sound_bank_adpcm_block_bytes(e->frames % SOUND_BANK_ADPCM_BLOCK_FRAMES, e->channels)
+                                     : 0);
+        if (memchr(e->name, '\0', SOUND_BANK_NAME_LEN) == NULL || (e->channels != 1 && e->channels != 2) ||
+            e->codec > SOUND_BANK_CODEC_IMA_ADPCM || e->rate_hz == 0 || e->frames == 0 || (e->offset & 3) ||
+            e->bytes < need || e->offset > hdr->used_bytes || e->bytes > hdr->used_bytes - e->offset) {
+            ESP_LOGE(TAG, "Entry %u is malformed", (unsigned)i);
+            return false;
+        }
+    }
+    return true;
+}
+
+// Voices and the feeder task; clips play through them even without a bank
+static esp_err_t feeder_start(void)
+{
+    if (s_task) {
+        return ESP_OK;
+    }
+    esp_err_t err = ESP_OK;
+    s_voices = heap_caps_calloc(AUDIO_PLAYER_STREAM_COUNT, sizeof(voice_t), MALLOC_CAP_8BIT);
+    for (int id = 0; s_voices && id < AUDIO_PLAYER_STREAM_COUNT; ++id) {
+        s_voices[id].pcm = heap_caps_malloc(SOUND_BANK_ADPCM_BLOCK_FRAMES * 2 * sizeof(int16_t),
+                                            MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        if (!s_voices[id].pcm) {
+            s_voices[id].pcm = heap_caps_malloc(SOUND_BANK_ADPCM_BLOCK_FRAMES * 2 * sizeof(int16_t),
+                                                MALLOC_CAP_8BIT);
+        }
+        if (!s_voices[id].pcm) {
+            err = ESP_ERR_NO_MEM;
+        }
+    }
+    if (!s_voices) {
+        err = ESP_ERR_NO_MEM;
+    }
+    if (err == ESP_OK && task_placement_create(TASK_PLACEMENT_SOUND_BANK, feeder_task, NULL, &s_task) != pdPASS) {
+        err = ESP_ERR_NO_MEM;
+    }
+    if (err != ESP_OK) {
+        for (int id = 0; s_voices && id < AUDIO_PLAYER_STREAM_COUNT; ++id) {
+            heap_caps_free(s_voices[id].pcm);
+        }
+        heap_caps_free(s_voices);
+        s_voices = NULL;
+    }
+    return err;
+}
+
+esp_err_t sound_bank_init(void)
+{
+    if (s_base) {
+        return ESP_OK;
+    }
+    ESP_RETURN_ON_ERROR(feeder_start(), TAG, "feeder");
+    const esp_partition_t *part =
+        esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, SOUND_BANK_PARTITION_LABEL);
+    if (!part) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    bank_header_t hdr;
+    ESP_RETURN_ON_ERROR(esp_partition_read(part, 0, &hdr, sizeof(hdr)), TAG, "read header");
+    if (hdr.magic != BANK_MAGIC || hdr.count == 0) {
+        ESP_LOGI(TAG, "No sounds in the \"%s\" partition", SOUND_BANK_PARTITION_LABEL);
+        return ESP_ERR_NOT_FOUND;
+    }
+    size_t index_end = sizeof(hdr) + (size_t)hdr.count * sizeof(bank_entry_t);
+    ESP_RETURN_ON_FALSE(hdr.version == BANK_VERSION && hdr.used_bytes >= index_end && hdr.used_bytes <= part->size,
+                        ESP_ERR_INVALID_VERSION, TAG, "unsupported bank (version %u)", (unsigned)hdr.version);
+
+    // Only the used part of the partition takes MMU pages
+    const void *mapped = NULL;
+    ESP_RETURN_ON_ERROR(esp_partition_mmap(part, 0, hdr.used_bytes, ESP_PARTITION_MMAP_DATA, &mapped, &s_mmap), TAG,
+                        "mmap");
+    s_base = mapped;
+    s_index = (const bank_entry_t *)(s_base + sizeof(hdr));
+    esp_err_t err = ESP_OK;
+    if (esp_rom_crc32_le(0, (const uint8_t *)s_index, index_end - sizeof(hdr)) != hdr.index_crc) {
+        ESP_LOGE(TAG, "Index CRC mismatch");
+        err = ESP_ERR_INVALID_CRC;
+    } else if (!index_is_valid(&hdr)) {
+        err = ESP_ERR_INVALID_SIZE;
+    }
+    if (err != ESP_OK) {
+        esp_partition_munmap(s_mmap);
+        s_base = NULL;
+        s_index = NULL;
+        return err;
+    }
+
+    s_count = hdr.count;
+    ESP_LOGI(TAG, "%u sounds mapped from \"%s\" (%u KB)", (unsigned)s_count, SOUND_BANK_PARTITION_LABEL,
+             (unsigned)(hdr.used_bytes / 1024));
+    return ESP_OK;
+}
+
+size_t sound_bank_count(void)
+{
+    return s_count;
+}
+
+esp_err_t sound_bank_get(size_t index, sound_bank_info_t *out)
+{
+    ESP_RETURN_ON_FALSE(out, ESP_ERR_INVALID_ARG, TAG, "out required");
+    if (index >= s_count) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    const bank_entry_t *e = &s_index[index];
+    out->name = e->name;
+    out->frames = e->frames;
+    out->rate_hz = e->rate_hz;
+    out->channels = e->channels;
+    out->codec = (sound_bank_codec_t)e->codec;
+    out->flags = e->flags;
+    return ESP_OK;
+}
+
+static esp_err_t request(audio_player_stream_t stream, const sound_bank_clip_t *clip)
+{
+    ESP_RETURN_ON_FALSE(s_task, ESP_ERR_INVALID_STATE, TAG, "not initialised");
+    ESP_RETURN_ON_FALSE(stream >= 0 && stream < AUDIO_PLAYER_STREAM_COUNT, ESP_ERR_INVALID_ARG, TAG, "stream");
+    portENTER_CRITICAL(&s_lock);
+    s_voices[stream].request = *clip;
+    s_voices[stream].pending = true;
+    portEXIT_CRITICAL(&s_lock);
+    xTaskNotifyGive(s_task);
+    return ESP_OK;
+}
+
+esp_err_t sound_bank_play(const char *name, audio_player_stream_t stream)
+{
+    ESP_RETURN_ON_FALSE(name, ESP_ERR_INVALID_ARG, TAG, "name required");
+    for (size_t i = 0; i < s_count; ++i) {
+        const bank_entry_t *e = &s_index[i];
+        if (strncmp(e->name, name, SOUND_BANK_NAME_LEN) == 0) {
+            const sound_bank_clip_t clip = {
+                .data = s_base + e->offset,
+                .frames = e->frames,
+                .rate_hz = e->rate_hz,
+                .channels = e->channels,
+                .codec = (sound_bank_codec_t)e->codec,
+                .flags = e->flags,
+            };
+            return request(stream, &clip);
+        }
+    }
+    return s_task ? ESP_ERR_NOT_FOUND : ESP_ERR_INVALID_STATE;
+}
+
+esp_err_t sound_bank_play_clip(const sound_bank_clip_t *clip, audio_player_stream_t stream)
+{
+    ESP_RETURN_ON_FALSE(clip && clip->data && clip->frames > 0 && clip->rate_hz > 0 &&
+                            (clip->channels == 1 || clip->channels == 2) &&
+                            clip->codec <= SOUND_BANK_CODEC_IMA_ADPCM,
+                        ESP_ERR_INVALID_ARG, TAG, "bad clip");
+    return request(stream, clip);
+}
+
+bool sound_bank_is_playing(audio_player_stream_t stream)
+{
+    if (!s_task || stream < 0 || stream >= AUDIO_PLAYER_STREAM_COUNT) {
+        return false;
+    }
+    portENTER_CRITICAL(&s_lock);
+    // A request not yet picked up counts as playing
+    bool playing = s_voices[stream].pending ? s_voices[stream].request.frames > 0 : s_voices[stream].playing;
+    portEXIT_CRITICAL(&s_lock);
+    return playing;
+}
+
+esp_err_t sound_bank_stop(audio_player_stream_t stream)
+{
+    const sound_bank_clip_t none = {0};
+    return request(stream, &none);
+}
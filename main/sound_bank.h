@@ -0,0 +1,110 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "audio_player.h"
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Sounds packed into a flash partition by scripts/make_sound_bank.py and
+ * played straight out of the memory-mapped partition: no filesystem, no
+ * decoding beyond IMA ADPCM, and the first frames reach the mixer ring on
+ * the next pass of the feeder task.
+ *
+ * Partition layout (little-endian):
+ *   header   magic 'NSB1', u16 version, u16 count, u32 used bytes, u32 CRC-32 of the index
+ *   index    count x 48-byte entries: char name[24], u32 offset, u32 bytes,
+ *            u32 frames, u32 rate_hz, u8 channels, u8 codec, u8 flags, u8 0, u32 0
+ *   data     4-byte aligned, at each entry's offset from the partition start
+ *
+ * PCM16 data is interleaved frames. IMA ADPCM data is a run of blocks of
+ * SOUND_BANK_ADPCM_BLOCK_FRAMES frames (the last may be short): per channel
+ * an i16 predictor and u8 step index (plus a pad byte), then one nibble
+ * per sample in frame order, low nibble first.
+ */
+
+#define SOUND_BANK_PARTITION_LABEL "sounds"
+#define SOUND_BANK_NAME_LEN 24
+#define SOUND_BANK_ADPCM_BLOCK_FRAMES 512
+
+#define SOUND_BANK_FLAG_LOOP 0x01     // Repeat until sound_bank_stop()
+
+typedef enum {
+    SOUND_BANK_CODEC_PCM16 = 0,
+    SOUND_BANK_CODEC_IMA_ADPCM = 1,
+} sound_bank_codec_t;
+
+typedef struct {
+    const char *name;
+    uint32_t frames;
+    uint32_t rate_hz;
+    uint8_t channels;
+    sound_bank_codec_t codec;
+    uint8_t flags;
+} sound_bank_info_t;
+
+/**
+ * Audio kept outside the bank, such as cached speech, in one of the bank's
+ * encodings. The data must stay mapped until the clip has played.
+ */
+typedef struct {
+    const uint8_t *data;
+    uint32_t frames;
+    uint32_t rate_hz;
+    uint8_t channels;
+    sound_bank_codec_t codec;
+    uint8_t flags;
+} sound_bank_clip_t;
+
+/**
+ * Start the feeder task and map the bank. Call after audio_player_init().
+ * The feeder keeps running for sound_bank_play_clip() when there is no bank.
+ *
+ * @return ESP_ERR_NOT_FOUND without a "sounds" partition or with an empty
+ *         one, ESP_ERR_INVALID_CRC when the index is damaged
+ */
+esp_err_t sound_bank_init(void);
+
+size_t sound_bank_count(void);
+
+// By index, for listings; ESP_ERR_NOT_FOUND past the end
+esp_err_t sound_bank_get(size_t index, sound_bank_info_t *out);
+
+/**
+ * Play a sound on a mixer stream, replacing whatever the bank was playing
+ * there (audio another producer queued on the stream is left alone).
+ * Sounds flagged SOUND_BANK_FLAG_LOOP repeat until stopped.
+ *
+ * @return ESP_ERR_NOT_FOUND for an unknown name
+ */
+esp_err_t sound_bank_play(const char *name, audio_player_stream_t stream);
+
+// Play a clip the same way, replacing whatever the bank was playing on the stream
+esp_err_t sound_bank_play_clip(const sound_bank_clip_t *clip, audio_player_stream_t stream);
+
+// Whether the bank still has frames of a sound or clip to queue on the stream
+bool sound_bank_is_playing(audio_player_stream_t stream);
+
+// Stop the bank's sound on a stream and drop what it had queued
+esp_err_t sound_bank_stop(audio_player_stream_t stream);
+
+size_t sound_bank_adpcm_block_bytes(uint32_t frames, uint8_t channels);
+
+/**
+ * Encode one mono IMA ADPCM block in the bank's layout, for audio recorded
+ * on the device. index carries the step index from block to block.
+ *
+ * @param frames 1 to SOUND_BANK_ADPCM_BLOCK_FRAMES
+ * @return bytes written, sound_bank_adpcm_block_bytes(frames, 1); 0 for a bad frame count
+ */
+size_t sound_bank_adpcm_encode_block(const int16_t *pcm, uint32_t frames, int32_t *index, uint8_t *out);
+
+#ifdef __cplusplus
+}
+#endif
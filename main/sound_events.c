@@ -0,0 +1,65 @@
+#include "sound_events.h"
+
+#include <sys/time.h>
+
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "night_summary.h"
+#include "occupancy.h"
+
+// Any wall clock after 2020 was set by SNTP
+#define SOUND_EVENTS_EPOCH_VALID_MS 1600000000000LL
+
+static sound_events_entry_t s_queue[CONFIG_KVA_SOUND_EVENTS_QUEUE];
+static size_t s_head;                 // Next slot to write
+static size_t s_count;
+static uint32_t s_dropped;
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+void sound_events_record(const char *label, int64_t start_us, uint32_t duration_ms, float confidence)
+{
+    sound_events_entry_t entry = {
+        .label = label,
+        .start_ms = start_us / 1000,
+        .duration_ms = duration_ms,
+        .confidence = confidence,
+    };
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    int64_t wall_ms = (int64_t)tv.tv_sec * 1000 + tv.tv_usec / 1000;
+    if (wall_ms >= SOUND_EVENTS_EPOCH_VALID_MS) {
+        entry.start_ms = wall_ms - (esp_timer_get_time() - start_us) / 1000;
+        entry.epoch = true;
+    }
+
+    night_summary_count_event(label);
+    occupancy_note(OCCUPANCY_SOURCE_SOUND);
+
+    portENTER_CRITICAL(&s_lock);
+    s_queue[s_head] = entry;
+    s_head = (s_head + 1) % CONFIG_KVA_SOUND_EVENTS_QUEUE;
+    if (s_count < CONFIG_KVA_SOUND_EVENTS_QUEUE) {
+        s_count++;
+    } else {
+        s_dropped++;
+    }
+    portEXIT_CRITICAL(&s_lock);
+}
+
+size_t sound_events_drain(sound_events_entry_t *out, size_t max, uint32_t *dropped_out)
+{
+    size_t n = 0;
+    portENTER_CRITICAL(&s_lock);
+    size_t oldest = (s_head + CONFIG_KVA_SOUND_EVENTS_QUEUE - s_count) % CONFIG_KVA_SOUND_EVENTS_QUEUE;
+    while (n < max && n < s_count) {
+        out[n] = s_queue[(oldest + n) % CONFIG_KVA_SOUND_EVENTS_QUEUE];
+        n++;
+    }
+    s_count -= n;
+    if (dropped_out) {
+        *dropped_out = s_dropped;
+        s_dropped = 0;
+    }
+    portEXIT_CRITICAL(&s_lock);
+    return n;
+}
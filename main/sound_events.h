@@ -0,0 +1,43 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "kva_config_defaults.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Night sounds (snore, cough, talking, alarm) found on the device by the
+ * wake word detector's event head, held until the next telemetry report.
+ * Only the event goes out, a few bytes each: no audio leaves the unit.
+ * Events past CONFIG_KVA_SOUND_EVENTS_QUEUE between reports are counted
+ * and dropped, oldest first.
+ */
+
+typedef struct {
+    const char *label;                // Static class name
+    int64_t start_ms;                 // Epoch time once SNTP has set the clock, else uptime
+    uint32_t duration_ms;
+    float confidence;
+    bool epoch;                       // start_ms is wall-clock time
+} sound_events_entry_t;
+
+// From the audio task; never blocks. start_us is esp_timer time. Also
+// counted into the open night's summary, and as sound in the room.
+void sound_events_record(const char *label, int64_t start_us, uint32_t duration_ms, float confidence);
+
+/**
+ * Move up to max queued events to out, oldest first.
+ *
+ * @param dropped_out Optional, events lost to a full queue since the last drain
+ * @return Events written
+ */
+size_t sound_events_drain(sound_events_entry_t *out, size_t max, uint32_t *dropped_out);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,262 @@
+#include "speech_pipeline.h"
+
+#include <ctype.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "esp_check.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "interaction_cancel.h"
+#include "task_placement.h"
+#include "wav_stream_player.h"
+
+static const char *TAG = "speech_pipeline";
+
+// Initial clip allocation; grows by doubling
+#define CLIP_INITIAL_BYTES (32 * 1024)
+
+typedef struct {
+    uint8_t *data;
+    size_t len;
+    size_t cap;
+} speech_clip_t;
+
+struct speech_pipeline {
+    speech_pipeline_config_t cfg;
+    QueueHandle_t text_queue;         // char * sentences; NULL ends the reply
+    QueueHandle_t audio_queue;        // speech_clip_t *; NULL ends playback
+    SemaphoreHandle_t done;           // Given by the playback worker on exit
+    char pending[SPEECH_PIPELINE_SENTENCE_MAX];
+    size_t pending_len;
+    wav_stream_player_t player;       // Owned by the playback worker
+    esp_err_t synth_err;              // Written by the TTS worker only
+    esp_err_t play_err;               // Written by the playback worker only
+    size_t pcm_bytes;
+};
+
+static esp_err_t clip_append(const uint8_t *data, size_t len, void *ctx)
+{
+    speech_clip_t *clip = (speech_clip_t *)ctx;
+    if (clip->len + len > clip->cap) {
+        size_t new_cap = clip->cap ? clip->cap * 2 : CLIP_INITIAL_BYTES;
+        while (new_cap < clip->len + len) {
+            new_cap *= 2;
+        }
+        uint8_t *mem = heap_caps_realloc(clip->data, new_cap, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        ESP_RETURN_ON_FALSE(mem, ESP_ERR_NO_MEM, TAG, "clip %u bytes", (unsigned)new_cap);
+        clip->data = mem;
+        clip->cap = new_cap;
+    }
+    memcpy(clip->data + clip->len, data, len);
+    clip->len += len;
+    return ESP_OK;
+}
+
+static void clip_free(speech_clip_t *clip)
+{
+    if (clip) {
+        heap_caps_free(clip->data);
+        free(clip);
+    }
+}
+
+static void synth_task(void *arg)
+{
+    speech_pipeline_handle_t handle = (speech_pipeline_handle_t)arg;
+    char *sentence = NULL;
+    while (xQueueReceive(handle->text_queue, &sentence, portMAX_DELAY) == pdTRUE && sentence) {
+        if (interaction_cancelled()) {
+            // Drain the queue without synthesizing; finish() still gets its sentinel
+            free(sentence);
+            continue;
+        }
+        speech_clip_t *clip = calloc(1, sizeof(*clip));
+        esp_err_t err = clip ? handle->cfg.tts(sentence, handle->cfg.voice, clip_append, clip) : ESP_ERR_NO_MEM;
+        if (err != ESP_OK) {
+            // Keep going; a missing sentence beats silence for the rest of the reply
+            ESP_LOGE(TAG, "TTS failed for \"%.40s\": %s", sentence, esp_err_to_name(err));
+            if (handle->synth_err == ESP_OK) {
+                handle->synth_err = err;
+            }
+            clip_free(clip);
+        } else {
+            ESP_LOGD(TAG, "Synthesized %u bytes for \"%.40s\"", (unsigned)clip->len, sentence);
+            xQueueSend(handle->audio_queue, &clip, portMAX_DELAY);
+        }
+        free(sentence);
+    }
+    // Nothing touches handle after the sentinel; finish() may free it
+    speech_clip_t *end = NULL;
+    task_placement_note_exit(TASK_PLACEMENT_SPEECH_SYNTH);
+    xQueueSend(handle->audio_queue, &end, portMAX_DELAY);
+    vTaskDelete(NULL);
+}
+
+static void playback_task(void *arg)
+{
+    speech_pipeline_handle_t handle = (speech_pipeline_handle_t)arg;
+    speech_clip_t *clip = NULL;
+    while (xQueueReceive(handle->audio_queue, &clip, portMAX_DELAY) == pdTRUE && clip) {
+        if (interaction_cancelled()) {
+            clip_free(clip);
+            continue;
+        }
+        size_t played = 0;
+        wav_stream_player_begin(&handle->player);
+        wav_stream_player_feed(clip->data, clip->len, &handle->player);
+        esp_err_t err = wav_stream_player_end(&handle->player, &played);
+        handle->pcm_bytes += played;
+        if (err != ESP_OK && handle->play_err == ESP_OK) {
+            handle->play_err = err;
+        }
+        clip_free(clip);
+    }
+    task_placement_note_exit(TASK_PLACEMENT_SPEECH_PLAYBACK);
+    xSemaphoreGive(handle->done);
+    vTaskDelete(NULL);
+}
+
+// Length of the first sentence in text, including its terminator, or 0
+static size_t sentence_end(const char *text, size_t len)
+{
+    // The character after the terminator must be present to tell "3.5" from "3. "
+    for (size_t i = SPEECH_PIPELINE_MIN_SENTENCE_CHARS - 1; i + 1 < len; ++i) {
+        char c = text[i];
+        if (c == '\n' || ((c == '.' || c == '!' || c == '?') && isspace((unsigned char)text[i + 1]))) {
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+static esp_err_t queue_sentence(speech_pipeline_handle_t handle, size_t len)
+{
+    const char *start = handle->pending;
+    const char *end = start + len;
+    while (start < end && isspace((unsigned char)*start)) {
+        ++start;
+    }
+    while (end > start && isspace((unsigned char)end[-1])) {
+        --end;
+    }
+
+    esp_err_t ret = ESP_OK;
+    if (end > start) {
+        char *sentence = strndup(start, end - start);
+        if (sentence) {
+            xQueueSend(handle->text_queue, &sentence, portMAX_DELAY);
+        } else {
+            ESP_LOGE(TAG, "No memory for sentence");
+            ret = ESP_ERR_NO_MEM;
+        }
+    }
+
+    handle->pending_len -= len;
+    memmove(handle->pending, handle->pending + len, handle->pending_len);
+    return ret;
+}
+
+speech_pipeline_handle_t speech_pipeline_start(const speech_pipeline_config_t *cfg)
+{
+    ESP_RETURN_ON_FALSE(cfg && cfg->tts, NULL, TAG, "bad args");
+
+    speech_pipeline_handle_t handle = calloc(1, sizeof(*handle));
+    ESP_RETURN_ON_FALSE(handle, NULL, TAG, "no mem");
+    handle->cfg = *cfg;
+    handle->text_queue = xQueueCreate(SPEECH_PIPELINE_TEXT_DEPTH, sizeof(char *));
+    handle->audio_queue = xQueueCreate(SPEECH_PIPELINE_AUDIO_DEPTH, sizeof(speech_clip_t *));
+    handle->done = xSemaphoreCreateBinary();
+    if (!handle->text_queue || !handle->audio_queue || !handle->done) {
+        goto fail;
+    }
+
+    if (task_placement_create(TASK_PLACEMENT_SPEECH_PLAYBACK, playback_task, handle, NULL) != pdPASS) {
+        goto fail;
+    }
+    if (task_placement_create(TASK_PLACEMENT_SPEECH_SYNTH, synth_task, handle, NULL) != pdPASS) {
+        // Let the playback worker exit before the queues go away
+        speech_clip_t *end = NULL;
+        xQueueSend(handle->audio_queue, &end, portMAX_DELAY);
+        xSemaphoreTake(handle->done, portMAX_DELAY);
+        goto fail;
+    }
+    return handle;
+
+fail:
+    ESP_LOGE(TAG, "Failed to start speech pipeline");
+    if (handle->text_queue) {
+        vQueueDelete(handle->text_queue);
+    }
+    if (handle->audio_queue) {
+        vQueueDelete(handle->audio_queue);
+    }
+    if (handle->done) {
+        vSemaphoreDelete(handle->done);
+    }
+    free(handle);
+    return NULL;
+}
+
+esp_err_t speech_pipeline_push_text(speech_pipeline_handle_t handle, const char *text)
+{
+    ESP_RETURN_ON_FALSE(handle && text, ESP_ERR_INVALID_ARG, TAG, "bad args");
+    if (interaction_cancelled()) {
+        // Stops the LLM stream feeding us at its next chunk
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    esp_err_t ret = ESP_OK;
+    while (*text) {
+        size_t room = sizeof(handle->pending) - handle->pending_len;
+        if (room == 0) {
+            // No sentence end in a full buffer: speak up to the last word break
+            size_t cut = handle->pending_len;
+            while (cut > 0 && !isspace((unsigned char)handle->pending[cut - 1])) {
+                --cut;
+            }
+            ret = queue_sentence(handle, cut ? cut : handle->pending_len);
+            continue;
+        }
+        size_t n = strnlen(text, room);
+        memcpy(handle->pending + handle->pending_len, text, n);
+        handle->pending_len += n;
+        text += n;
+
+        size_t len;
+        while ((len = sentence_end(handle->pending, handle->pending_len)) > 0) {
+            ret = queue_sentence(handle, len);
+        }
+    }
+    return ret;
+}
+
+esp_err_t speech_pipeline_finish(speech_pipeline_handle_t handle, size_t *pcm_bytes)
+{
+    ESP_RETURN_ON_FALSE(handle, ESP_ERR_INVALID_ARG, TAG, "bad args");
+
+    esp_err_t ret = ESP_OK;
+    if (handle->pending_len) {
+        ret = queue_sentence(handle, handle->pending_len);
+    }
+    char *end = NULL;
+    xQueueSend(handle->text_queue, &end, portMAX_DELAY);
+    xSemaphoreTake(handle->done, portMAX_DELAY);
+
+    if (ret == ESP_OK) {
+        ret = handle->synth_err != ESP_OK ? handle->synth_err : handle->play_err;
+    }
+    if (pcm_bytes) {
+        *pcm_bytes = handle->pcm_bytes;
+    }
+    vQueueDelete(handle->text_queue);
+    vQueueDelete(handle->audio_queue);
+    vSemaphoreDelete(handle->done);
+    free(handle);
+    return ret;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Longest run of text held while waiting for a sentence end; longer runs are cut at a space
+#ifndef SPEECH_PIPELINE_SENTENCE_MAX
+#define SPEECH_PIPELINE_SENTENCE_MAX 512
+#endif
+
+// Shorter sentences are merged with the next one to save a TTS round trip
+#ifndef SPEECH_PIPELINE_MIN_SENTENCE_CHARS
+#define SPEECH_PIPELINE_MIN_SENTENCE_CHARS 12
+#endif
+
+// Synthesized clips waiting for the speaker; bounds PSRAM held ahead of playback
+#ifndef SPEECH_PIPELINE_AUDIO_DEPTH
+#define SPEECH_PIPELINE_AUDIO_DEPTH 2
+#endif
+
+// Sentences waiting for the TTS worker
+#ifndef SPEECH_PIPELINE_TEXT_DEPTH
+#define SPEECH_PIPELINE_TEXT_DEPTH 8
+#endif
+
+typedef esp_err_t (*speech_pipeline_chunk_cb_t)(const uint8_t *data, size_t len, void *ctx);
+
+/**
+ * Synthesize text to a WAV and hand it to on_chunk piece by piece. Matches
+ * gemini_tts_generate_stream() and openai_tts_generate_stream().
+ */
+typedef esp_err_t (*speech_pipeline_tts_fn_t)(const char *text, const char *voice,
+                                              speech_pipeline_chunk_cb_t on_chunk, void *ctx);
+
+typedef struct {
+    speech_pipeline_tts_fn_t tts;
+    const char *voice;
+} speech_pipeline_config_t;
+
+/**
+ * Speaks text that is still being generated.
+ *
+ * Text pushed in arbitrary pieces is split into sentences. A TTS worker
+ * synthesizes each sentence into a PSRAM clip while a playback worker plays
+ * the previous one, so sentence N plays while N+1 downloads.
+ */
+typedef struct speech_pipeline *speech_pipeline_handle_t;
+
+/**
+ * Create the queues and start both workers.
+ *
+ * @return NULL if memory or task creation fails
+ */
+speech_pipeline_handle_t speech_pipeline_start(const speech_pipeline_config_t *cfg);
+
+/**
+ * Append generated text. Complete sentences are queued for synthesis; this
+ * blocks while the TTS worker is SPEECH_PIPELINE_TEXT_DEPTH sentences behind.
+ */
+esp_err_t speech_pipeline_push_text(speech_pipeline_handle_t handle, const char *text);
+
+/**
+ * Queue the trailing text, wait until the last clip has been handed to the
+ * codec, and free the pipeline.
+ *
+ * @param pcm_bytes PCM bytes played in total (may be NULL)
+ * @return first synthesis or playback error, ESP_OK otherwise
+ */
+esp_err_t speech_pipeline_finish(speech_pipeline_handle_t handle, size_t *pcm_bytes);
+
+#ifdef __cplusplus
+}
+#endif
@@ -20,6 +20,24 @@ static bool spotify_client_use_local_player(void)
 #endif
 }
 
+// Lazy start: cspot comes up on the first play or resume rather than at boot.
+// The request that starts it is answered by the stub; the player takes a few
+// seconds to log in and shows up in the Spotify app once it has
+static void spotify_client_wake_player(void)
+{
+#if CONFIG_KVA_SPOTIFY_USE_CSPOT
+    if (spotify_player_is_running()) {
+        return;
+    }
+    esp_err_t err = spotify_player_ensure_started();
+    if (err == ESP_OK) {
+        ESP_LOGI(TAG, "Starting Spotify Connect on first use");
+    } else if (err != ESP_ERR_INVALID_STATE) {
+        ESP_LOGW(TAG, "Spotify Connect start failed (%s)", esp_err_to_name(err));
+    }
+#endif
+}
+
 esp_err_t spotify_client_init(spotify_client_t *client, const spotify_client_config_t *cfg)
 {
     ESP_RETURN_ON_FALSE(client && cfg, ESP_ERR_INVALID_ARG, TAG, "bad args");
@@ -32,6 +50,7 @@ esp_err_t spotify_client_init(spotify_client_t *client, const spotify_client_con
 esp_err_t spotify_client_play(spotify_client_t *client, const char *query)
 {
     ESP_RETURN_ON_FALSE(client, ESP_ERR_INVALID_ARG, TAG, "client required");
+    spotify_client_wake_player();
     if (spotify_client_use_local_player()) {
         ESP_LOGI(TAG, "Resuming cspot playback for device \"%s\"", client->device_name);
         esp_err_t err = spotify_player_resume();
@@ -62,6 +81,7 @@ esp_err_t spotify_client_pause(spotify_client_t *client)
 esp_err_t spotify_client_resume(spotify_client_t *client)
 {
     ESP_RETURN_ON_FALSE(client, ESP_ERR_INVALID_ARG, TAG, "client required");
+    spotify_client_wake_player();
     if (spotify_client_use_local_player()) {
         esp_err_t err = spotify_player_resume();
         if (err == ESP_OK) {
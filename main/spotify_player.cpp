@@ -23,8 +23,8 @@
 #include <SpircHandler.h>
 #include <TrackPlayer.h>
 
+#include <algorithm>
 #include <atomic>
-#include <fstream>
 #include <memory>
 #include <new>
 #include <mutex>
@@ -32,11 +32,22 @@
 #include <string_view>
 #include <vector>
 
+#include <unistd.h>
+
 #include "audio_player.h"
-// ESP-IDF v4.4: SPIFFS functions are in esp_vfs.h and esp_spiffs.h
+#include "control_coalescer.h"
+#include "mem_tags.h"
+#include "radio_coex.h"
+#include "storage.h"
+#include "task_placement.h"
 #include "esp_vfs.h"
-#include "esp_spiffs.h"
+#include "esp_event.h"
+#include "esp_http_client.h"
+#include "esp_netif.h"
+#include "esp_timer.h"
+#include "esp_wifi.h"
 #include "mdns.h"
+#include "nvs.h"
 
 extern "C" {
 #include "esp_vfs.h"
@@ -47,11 +58,77 @@ namespace {
 constexpr const char *TAG = "spotify_player";
 constexpr const char *kDefaultCredsPath = "/spiffs/spotify_blob.json";
 
+// What a session needs to come back without pairing or resolving again
+constexpr const char *kNvsNamespace = "spotify";
+constexpr const char *kNvsBlob = "blob";          // LoginBlob JSON; reusable credentials once logged in
+constexpr const char *kNvsAps = "aps";            // Access points, one per line, last good first
+constexpr const char *kNvsVolume = "volume";
+constexpr const char *kApResolveUrl = "http://apresolve.spotify.com/?type=accesspoint";
+constexpr size_t kMaxCachedAps = 4;
+constexpr int kAuthStoredCredentials = 1;         // AuthenticationType_AUTHENTICATION_STORED_SPOTIFY_CREDENTIALS
+constexpr uint32_t kRetryMinMs = 1000;
+constexpr uint32_t kRetryMaxMs = 60000;
+constexpr int64_t kStableSessionUs = 60LL * 1000 * 1000;  // Lasting this long resets the backoff
+constexpr int64_t kVolumeSaveUs = 10LL * 1000 * 1000;
+
 std::mutex s_spirc_mutex;
 std::shared_ptr<cspot::SpircHandler> s_spirc_handler;
 std::atomic<bool> s_player_ready{false};
 std::atomic<int> s_volume_percent{50};
 std::atomic<bool> s_volume_known{false};
+std::atomic<bool> s_volume_dirty{false};          // Not yet in NVS
+std::atomic<bool> s_link_lost{false};             // Wi-Fi dropped under the session
+std::atomic<TaskHandle_t> s_player_task{nullptr}; // Woken when Wi-Fi is back
+// Slider drags and repeated "louder" land here; the mixer follows at the
+// control rate and Spotify hears only where the volume settles
+std::once_flag s_volume_ctl_once;
+control_coalescer_t *s_volume_ctl = nullptr;
+
+// Lifecycle, so the player can start on first use and idle out again
+constexpr int64_t kIdleCheckUs = 30LL * 1000 * 1000;
+std::atomic<bool> s_task_running{false};
+std::atomic<bool> s_stop_requested{false};
+std::atomic<bool> s_playing{false};
+std::atomic<int64_t> s_last_active_us{0};
+uint32_t s_idle_stop_ms = 0;
+esp_timer_handle_t s_idle_timer = nullptr;
+
+// Set by spotify_player_configure; the task's config points into it
+struct {
+    bool configured = false;
+    std::string device_name;
+    std::string credentials_path;
+    spotify_player_config_t cfg = {};
+} s_stored;
+
+// Playing Spotify streams over Wi-Fi, so it also gets the radio
+void set_playing(bool playing)
+{
+    s_playing.store(playing);
+    radio_coex_set_busy(RADIO_COEX_SPOTIFY, playing);
+}
+
+void mark_active()
+{
+    s_last_active_us.store(esp_timer_get_time());
+}
+
+void idle_check(void *arg)
+{
+    (void)arg;
+    if (!s_task_running.load() || s_stop_requested.load()) {
+        return;
+    }
+    if (s_playing.load()) {
+        mark_active();
+        return;
+    }
+    if (esp_timer_get_time() - s_last_active_us.load() >= (int64_t)s_idle_stop_ms * 1000) {
+        ESP_LOGI(TAG, "Idle for %u s; stopping Spotify Connect to free its memory",
+                 (unsigned)(s_idle_stop_ms / 1000));
+        s_stop_requested.store(true);
+    }
+}
 
 int clamp_percent(int percent)
 {
@@ -81,6 +158,147 @@ int percent_to_spirc_volume(int percent)
     return (percent * 65535) / 100;
 }
 
+std::string nvs_load_string(const char *key)
+{
+    nvs_handle_t nvs;
+    if (nvs_open(kNvsNamespace, NVS_READONLY, &nvs) != ESP_OK) {
+        return {};
+    }
+    std::string value;
+    size_t len = 0;
+    if (nvs_get_str(nvs, key, nullptr, &len) == ESP_OK && len > 1) {
+        value.resize(len);
+        if (nvs_get_str(nvs, key, value.data(), &len) == ESP_OK) {
+            value.resize(len - 1);
+        } else {
+            value.clear();
+        }
+    }
+    nvs_close(nvs);
+    return value;
+}
+
+// An empty value erases the key
+void nvs_store_string(const char *key, const std::string &value)
+{
+    nvs_handle_t nvs;
+    esp_err_t err = nvs_open(kNvsNamespace, NVS_READWRITE, &nvs);
+    if (err == ESP_OK) {
+        err = value.empty() ? nvs_erase_key(nvs, key) : nvs_set_str(nvs, key, value.c_str());
+        if (err == ESP_ERR_NVS_NOT_FOUND) {
+            err = ESP_OK;
+        }
+        if (err == ESP_OK) {
+            err = nvs_commit(nvs);
+        }
+        nvs_close(nvs);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Spotify %s not saved: %s", key, esp_err_to_name(err));
+    }
+}
+
+int load_volume()
+{
+    nvs_handle_t nvs;
+    uint8_t volume = 0;
+    bool found = false;
+    if (nvs_open(kNvsNamespace, NVS_READONLY, &nvs) == ESP_OK) {
+        found = nvs_get_u8(nvs, kNvsVolume, &volume) == ESP_OK && volume <= 100;
+        nvs_close(nvs);
+    }
+    return found ? volume : -1;
+}
+
+void save_volume()
+{
+    if (!s_volume_dirty.exchange(false)) {
+        return;
+    }
+    nvs_handle_t nvs;
+    if (nvs_open(kNvsNamespace, NVS_READWRITE, &nvs) == ESP_OK) {
+        if (nvs_set_u8(nvs, kNvsVolume, (uint8_t)s_volume_percent.load()) == ESP_OK) {
+            nvs_commit(nvs);
+        }
+        nvs_close(nvs);
+    }
+}
+
+std::vector<std::string> cached_aps()
+{
+    std::vector<std::string> aps;
+    std::string list = nvs_load_string(kNvsAps);
+    size_t pos = 0;
+    while (pos < list.size()) {
+        size_t end = list.find('\n', pos);
+        if (end == std::string::npos) {
+            end = list.size();
+        }
+        if (end > pos) {
+            aps.emplace_back(list, pos, end - pos);
+        }
+        pos = end + 1;
+    }
+    return aps;
+}
+
+void store_aps(const std::vector<std::string> &aps)
+{
+    std::string list;
+    for (size_t i = 0; i < aps.size() && i < kMaxCachedAps; ++i) {
+        list += (i ? "\n" : "") + aps[i];
+    }
+    nvs_store_string(kNvsAps, list);
+}
+
+// Ask apresolve for the current access points; plain HTTP, as cspot does
+std::vector<std::string> resolve_aps()
+{
+    std::vector<std::string> aps;
+    esp_http_client_config_t cfg = {};
+    cfg.url = kApResolveUrl;
+    cfg.timeout_ms = 5000;
+    esp_http_client_handle_t client = esp_http_client_init(&cfg);
+    if (!client) {
+        return aps;
+    }
+    std::string body;
+    if (esp_http_client_open(client, 0) == ESP_OK && esp_http_client_fetch_headers(client) >= 0 &&
+        esp_http_client_get_status_code(client) == 200) {
+        char buf[256];
+        int n;
+        while ((n = esp_http_client_read(client, buf, sizeof(buf))) > 0) {
+            body.append(buf, n);
+        }
+    }
+    esp_http_client_cleanup(client);
+
+    auto json = nlohmann::json::parse(body, nullptr, false);
+    if (json.is_object() && json["accesspoint"].is_array()) {
+        for (const auto &ap : json["accesspoint"]) {
+            if (ap.is_string() && aps.size() < kMaxCachedAps) {
+                aps.push_back(ap.get<std::string>());
+            }
+        }
+    }
+    return aps;
+}
+
+void on_network_event(void *arg, esp_event_base_t base, int32_t id, void *data)
+{
+    (void)arg;
+    (void)data;
+    if (base == IP_EVENT && id == IP_EVENT_STA_GOT_IP) {
+        // Cut a retry's backoff short
+        TaskHandle_t task = s_player_task.load();
+        if (task) {
+            xTaskNotifyGive(task);
+        }
+    } else {
+        s_link_lost.store(true);
+    }
+}
+
 void set_spirc_handler(std::shared_ptr<cspot::SpircHandler> handler)
 {
     std::lock_guard<std::mutex> lock(s_spirc_mutex);
@@ -97,34 +315,41 @@ std::shared_ptr<cspot::SpircHandler> acquire_spirc_handler()
     return s_spirc_handler;
 }
 
-bool ensure_spiffs()
+void apply_volume(int percent, bool settled, void *ctx)
 {
-    static bool mounted = false;
-    if (mounted) {
-        return true;
+    (void)ctx;
+    // cspot leaves volume to the sink: apply it in the mixer
+    audio_player_set_stream_volume(AUDIO_PLAYER_STREAM_MEDIA, percent);
+    if (s_volume_percent.exchange(percent) != percent || !s_volume_known.load()) {
+        s_volume_dirty.store(true);
     }
-    // Try "rules" partition first (matches partition table), fall back to NULL (default)
-    esp_vfs_spiffs_conf_t conf = {
-        .base_path = "/spiffs",
-        .partition_label = "rules",  // Use "rules" partition from partition table
-        .max_files = 5,
-        .format_if_mount_failed = false,  // Don't format - partition may have data
-    };
-    esp_err_t err = esp_vfs_spiffs_register(&conf);
-    if (err != ESP_OK) {
-        // Fall back to default partition if "rules" doesn't exist
-        ESP_LOGW(TAG, "SPIFFS mount failed with 'rules' partition (%s), trying default partition", esp_err_to_name(err));
-        conf.partition_label = NULL;  // Use default partition
-        conf.format_if_mount_failed = true;
-        err = esp_vfs_spiffs_register(&conf);
-        if (err != ESP_OK) {
-            ESP_LOGE(TAG, "SPIFFS mount failed with default partition (%s)", esp_err_to_name(err));
-            return false;
+    s_volume_known.store(true);
+    if (settled) {
+        auto handler = acquire_spirc_handler();
+        if (handler) {
+            handler->setRemoteVolume(percent_to_spirc_volume(percent));
         }
     }
-    mounted = true;
-    ESP_LOGI(TAG, "SPIFFS mounted successfully at /spiffs");
-    return true;
+}
+
+// NULL if it could not be made (before timer_wheel_init()); volume is then applied directly
+control_coalescer_t *volume_control()
+{
+    std::call_once(s_volume_ctl_once, [] {
+        const control_coalescer_config_t cfg = {
+            .name = "spotify_vol",
+            .apply = apply_volume,
+            .ctx = nullptr,
+            .initial = s_volume_percent.load(),
+            .rate_hz = 0,
+            .smoothing_ms = CONFIG_KVA_CONTROL_SMOOTHING_MS,
+            .step = 1,
+        };
+        if (control_coalescer_create(&cfg, &s_volume_ctl) != ESP_OK) {
+            s_volume_ctl = nullptr;
+        }
+    });
+    return s_volume_ctl;
 }
 
 class KorvoAudioSink : public AudioSink {
@@ -147,21 +372,50 @@ class KorvoAudioSink : public AudioSink {
         size_t sample_size = sizeof(int16_t);
         size_t frame_size = sample_size > 0 && channel_count_ > 0 ? (sample_size * channel_count_) : 2;
         size_t frame_count = frame_size > 0 ? bytes / frame_size : 0;
-        audio_player_submit_pcm(reinterpret_cast<const int16_t *>(buffer),
-                                frame_count,
-                                static_cast<int>(sample_rate_),
-                                channel_count_);
+        // Blocks only while the media ring (the jitter buffer) is full, which
+        // paces the decoder to the speaker
+        audio_player_stream_submit(AUDIO_PLAYER_STREAM_MEDIA,
+                                   reinterpret_cast<const int16_t *>(buffer),
+                                   frame_count,
+                                   static_cast<int>(sample_rate_),
+                                   channel_count_);
+        report_buffer();
     }
 
   private:
+    static constexpr int64_t kReportPeriodUs = 30LL * 1000 * 1000;
+
+    // Underruns mean the network fell behind for longer than the buffer
+    void report_buffer()
+    {
+        int64_t now = esp_timer_get_time();
+        if (now - last_report_us_ < kReportPeriodUs) {
+            return;
+        }
+        last_report_us_ = now;
+        audio_player_stream_stats_t st;
+        audio_player_get_stream_stats(AUDIO_PLAYER_STREAM_MEDIA, &st);
+        if (st.underruns != last_underruns_) {
+            ESP_LOGW(TAG, "Spotify buffer: %u/%u ms, %u underruns (+%u), %u full waits", (unsigned)st.queued_ms,
+                     (unsigned)st.ring_ms, (unsigned)st.underruns, (unsigned)(st.underruns - last_underruns_),
+                     (unsigned)st.overruns);
+            last_underruns_ = st.underruns;
+        } else {
+            ESP_LOGD(TAG, "Spotify buffer: %u/%u ms, %u underruns, %u full waits", (unsigned)st.queued_ms,
+                     (unsigned)st.ring_ms, (unsigned)st.underruns, (unsigned)st.overruns);
+        }
+    }
+
     uint32_t sample_rate_ = 44100;
     uint8_t channel_count_ = 2;
+    int64_t last_report_us_ = 0;
+    uint32_t last_underruns_ = 0;
 };
 
 class SpotifyPlayerTask : public bell::Task {
   public:
     explicit SpotifyPlayerTask(const spotify_player_config_t &cfg)
-        : bell::Task("cspot", 16 * 1024, 0, 1, false), cfg_(cfg)
+        : bell::Task(plan().name, plan().stack_bytes, plan().priority, plan().core, false), cfg_(cfg)
     {
         // Set default logger before starting task (required by cspot)
         bell::setDefaultLogger();
@@ -171,6 +425,11 @@ class SpotifyPlayerTask : public bell::Task {
   private:
     spotify_player_config_t cfg_;
 
+    static const task_placement_t &plan()
+    {
+        return *task_placement_get(TASK_PLACEMENT_SPOTIFY);
+    }
+
     std::string creds_path() const
     {
         if (cfg_.credentials_path && cfg_.credentials_path[0] != '\0') {
@@ -179,23 +438,23 @@ class SpotifyPlayerTask : public bell::Task {
         return kDefaultCredsPath;
     }
 
-    bool load_blob_from_disk(std::shared_ptr<cspot::LoginBlob> blob)
+    // NVS first; a blob only in the credentials file predates the NVS copy
+    bool load_blob(std::shared_ptr<cspot::LoginBlob> blob)
     {
-        if (!ensure_spiffs()) {
-            return false;
+        std::string json = nvs_load_string(kNvsBlob);
+        const char *from = "NVS";
+        char *file = nullptr;
+        if (json.empty() && storage_read(creds_path().c_str(), &file, nullptr) == ESP_OK) {
+            json = file;
+            free(file);
+            from = "the credentials file";
         }
-        std::ifstream file(creds_path(), std::ios::binary);
-        if (!file.is_open()) {
-            return false;
-        }
-        std::string json((std::istreambuf_iterator<char>(file)),
-                         std::istreambuf_iterator<char>());
         if (json.empty()) {
             return false;
         }
         try {
             blob->loadJson(json);
-            ESP_LOGI(TAG, "Loaded Spotify credentials from %s", creds_path().c_str());
+            ESP_LOGI(TAG, "Loaded Spotify credentials from %s", from);
             return true;
         } catch (...) {
             ESP_LOGW(TAG, "Failed to parse stored Spotify credentials");
@@ -203,27 +462,23 @@ class SpotifyPlayerTask : public bell::Task {
         }
     }
 
-    void save_blob_to_disk(std::shared_ptr<cspot::LoginBlob> blob)
+    void save_blob(std::shared_ptr<cspot::LoginBlob> blob)
     {
-        if (!ensure_spiffs()) {
-            return;
-        }
-        std::ofstream file(creds_path(), std::ios::binary | std::ios::trunc);
-        if (!file.is_open()) {
-            ESP_LOGW(TAG, "Unable to persist Spotify blob to %s", creds_path().c_str());
-            return;
-        }
-        file << blob->toJson();
-        ESP_LOGI(TAG, "Saved Spotify credentials to %s", creds_path().c_str());
+        nvs_store_string(kNvsBlob, blob->toJson());
+        ESP_LOGI(TAG, "Saved Spotify credentials to NVS");
     }
 
     void runTask() override
     {
-        // Ensure SPIFFS is mounted before any file operations (required by cspot)
-        if (!ensure_spiffs()) {
-            ESP_LOGE(TAG, "Failed to mount SPIFFS - cspot cannot load/save credentials");
-        }
-        
+        s_player_task.store(xTaskGetCurrentTaskHandle());
+        esp_event_handler_instance_t got_ip = nullptr;
+        esp_event_handler_instance_t lost_ip = nullptr;
+        esp_event_handler_instance_t disconnected = nullptr;
+        esp_event_handler_instance_register(IP_EVENT, IP_EVENT_STA_GOT_IP, on_network_event, nullptr, &got_ip);
+        esp_event_handler_instance_register(IP_EVENT, IP_EVENT_STA_LOST_IP, on_network_event, nullptr, &lost_ip);
+        esp_event_handler_instance_register(WIFI_EVENT, WIFI_EVENT_STA_DISCONNECTED, on_network_event, nullptr,
+                                            &disconnected);
+
         // Initialize mDNS (required by cspot for zeroconf)
         mdns_init();
         std::string hostname = cfg_.device_name ? cfg_.device_name : "korvo-naptick";
@@ -236,25 +491,79 @@ class SpotifyPlayerTask : public bell::Task {
         ESP_LOGI(TAG, "cspot mDNS initialized with hostname: %s", hostname.c_str());
 
         auto blob = std::make_shared<cspot::LoginBlob>(hostname);
-        bool have_blob = load_blob_from_disk(blob);
-        if (!have_blob) {
+        bool have_blob = load_blob(blob);
+        if (cfg_.wait_for_network) {
+            wait_for_network();
+        }
+        if (s_stop_requested.load()) {
+            have_blob = false;
+        } else if (!have_blob) {
             ESP_LOGI(TAG, "No saved credentials found, starting zeroconf pairing...");
             have_blob = run_zeroconf(blob);
             if (have_blob) {
-                save_blob_to_disk(blob);
+                save_blob(blob);
             }
-        } else {
-            ESP_LOGI(TAG, "Loaded Spotify credentials from disk");
         }
-
-        if (have_blob) {
-            start_session(blob);
-        } else {
+        if (!have_blob && !s_stop_requested.load()) {
             ESP_LOGE(TAG, "Unable to obtain Spotify credentials");
         }
+
+        // Sessions end when Wi-Fi drops or the connection fails; come back
+        // as soon as there is an address again, backing off while it fails
+        uint32_t retry_ms = kRetryMinMs;
+        while (have_blob && !s_stop_requested.load()) {
+            wait_for_network();
+            if (s_stop_requested.load()) {
+                break;
+            }
+            s_link_lost.store(false);
+            int64_t started_us = esp_timer_get_time();
+            bool established = start_session(blob);
+            save_volume();
+            if (s_stop_requested.load()) {
+                break;
+            }
+            if (established && esp_timer_get_time() - started_us >= kStableSessionUs) {
+                retry_ms = kRetryMinMs;
+            }
+            ESP_LOGW(TAG, "Spotify session ended; resuming in %u ms or when Wi-Fi is back", (unsigned)retry_ms);
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(retry_ms));
+            retry_ms = retry_ms * 2 < kRetryMaxMs ? retry_ms * 2 : kRetryMaxMs;
+        }
+
+        // Nothing of this object is touched once s_task_running drops, so
+        // spotify_player_start may delete it and start over
+        esp_event_handler_instance_unregister(IP_EVENT, IP_EVENT_STA_GOT_IP, got_ip);
+        esp_event_handler_instance_unregister(IP_EVENT, IP_EVENT_STA_LOST_IP, lost_ip);
+        esp_event_handler_instance_unregister(WIFI_EVENT, WIFI_EVENT_STA_DISCONNECTED, disconnected);
+        s_player_task.store(nullptr);
+        if (s_idle_timer) {
+            esp_timer_stop(s_idle_timer);
+        }
+        mdns_free();
+        set_playing(false);
+        ESP_LOGI(TAG, "Spotify Connect stopped; free heap %zu bytes", (size_t)esp_get_free_heap_size());
+        s_task_running.store(false);
         vTaskDelete(NULL);
     }
 
+    static void wait_for_network()
+    {
+        esp_netif_t *sta = esp_netif_get_handle_from_ifkey("WIFI_STA_DEF");
+        esp_netif_ip_info_t ip = {};
+        bool logged = false;
+        while ((!sta || esp_netif_get_ip_info(sta, &ip) != ESP_OK || ip.ip.addr == 0) && !s_stop_requested.load()) {
+            if (!logged) {
+                ESP_LOGI(TAG, "Waiting for Wi-Fi before connecting to Spotify");
+                logged = true;
+            }
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(250));
+            if (!sta) {
+                sta = esp_netif_get_handle_from_ifkey("WIFI_STA_DEF");
+            }
+        }
+    }
+
     bool run_zeroconf(std::shared_ptr<cspot::LoginBlob> blob)
     {
         std::atomic<bool> got_blob = false;
@@ -355,29 +664,85 @@ class SpotifyPlayerTask : public bell::Task {
             {{"VERSION", "1.0"}, {"CPath", "/spotify_info"}, {"Stack", "SP"}});
 
         ESP_LOGI(TAG, "Waiting for Spotify app to provision credentials via zeroconf...");
-        while (!got_blob.load()) {
+        while (!got_blob.load() && !s_stop_requested.load()) {
             BELL_SLEEP_MS(500);
         }
+        if (!got_blob.load()) {
+            return false;
+        }
         ESP_LOGI(TAG, "Received Spotify login blob over zeroconf");
         return true;
     }
 
-    void start_session(std::shared_ptr<cspot::LoginBlob> blob)
+    // The cached access points in order, then a fresh list, then cspot's own pick
+    static void connect_ap(const std::shared_ptr<cspot::Context> &ctx)
+    {
+        std::vector<std::string> aps = cached_aps();
+        bool fresh = aps.empty();
+        if (fresh) {
+            aps = resolve_aps();
+        }
+        for (size_t i = 0; i < aps.size(); ++i) {
+            ctx->config.apOverride = aps[i];
+            try {
+                ESP_LOGI(TAG, "Connecting to Spotify AP %s", aps[i].c_str());
+                ctx->session->connectWithRandomAp();
+            } catch (const std::exception &e) {
+                ESP_LOGW(TAG, "Spotify AP %s failed: %s", aps[i].c_str(), e.what());
+                continue;
+            }
+            if (fresh || i > 0) {
+                std::rotate(aps.begin(), aps.begin() + i, aps.begin() + i + 1);
+                store_aps(aps);
+            }
+            return;
+        }
+        // Every cached one failed: resolve again next time
+        store_aps({});
+        ctx->config.apOverride.clear();
+        ESP_LOGI(TAG, "Connecting to Spotify AP...");
+        ctx->session->connectWithRandomAp();
+    }
+
+    // True once logged in; returns when the session ends or could not start
+    bool start_session(std::shared_ptr<cspot::LoginBlob> blob)
     {
+        try {
+            return run_session(blob);
+        } catch (const std::exception &e) {
+            ESP_LOGW(TAG, "Spotify session failed: %s", e.what());
+        } catch (...) {
+            ESP_LOGW(TAG, "Spotify session failed");
+        }
+        set_spirc_handler(nullptr);
+        set_playing(false);
+        return false;
+    }
+
+    bool run_session(std::shared_ptr<cspot::LoginBlob> blob)
+    {
+        // cspot allocates through operator new, out of reach of the tag
+        // macros; charge its tag with what the session setup drew instead
+        size_t heap_before = heap_caps_get_free_size(MALLOC_CAP_DEFAULT);
+
         // Logger already set in constructor
         ESP_LOGI(TAG, "Creating cspot Context from LoginBlob...");
         auto ctx = cspot::Context::createFromBlob(blob);
-        
-        ESP_LOGI(TAG, "Connecting to Spotify AP...");
-        ctx->session->connectWithRandomAp();
-        
+        connect_ap(ctx);
+
         ESP_LOGI(TAG, "Authenticating with Spotify...");
         auto token = ctx->session->authenticate(blob);
         if (token.empty()) {
             ESP_LOGE(TAG, "Spotify authentication failed");
-            return;
+            return false;
         }
         ESP_LOGI(TAG, "Spotify authentication successful");
+        if (blob->authType != kAuthStoredCredentials || blob->authData != token) {
+            // Reusable credentials: later logins skip the zeroconf blob's key exchange
+            blob->authType = kAuthStoredCredentials;
+            blob->authData = token;
+            save_blob(blob);
+        }
 
         // Check available heap before creating internal task
         size_t free_heap = esp_get_free_heap_size();
@@ -396,6 +761,17 @@ class SpotifyPlayerTask : public bell::Task {
         auto handler = std::make_shared<cspot::SpircHandler>(ctx);
         handler->subscribeToMercury();
         set_spirc_handler(handler);
+        if (!s_volume_known.load()) {
+            int volume = load_volume();
+            if (volume >= 0) {
+                // Where the device was left, rather than cspot's default
+                if (control_coalescer_t *ctl = volume_control()) {
+                    control_coalescer_sync(ctl, volume);
+                }
+                apply_volume(volume, true, nullptr);
+                s_volume_dirty.store(false);
+            }
+        }
 
         ESP_LOGI(TAG, "Setting up audio sink...");
         auto sink = std::make_shared<KorvoAudioSink>();
@@ -404,6 +780,9 @@ class SpotifyPlayerTask : public bell::Task {
                 sink->feedPCMFrames(data, bytes);
                 return bytes;
             });
+        size_t heap_after = heap_caps_get_free_size(MALLOC_CAP_DEFAULT);
+        int32_t session_bytes = heap_after < heap_before ? (int32_t)(heap_before - heap_after) : 0;
+        mem_tags_charge(MEM_TAG_CSPOT, session_bytes);
 
         handler->setEventHandler(
             [](std::unique_ptr<cspot::SpircHandler::Event> event) {
@@ -426,23 +805,30 @@ class SpotifyPlayerTask : public bell::Task {
                         if (std::holds_alternative<int>(event->data)) {
                             int spirc_volume = std::get<int>(event->data);
                             int pct = spirc_volume_to_percent(spirc_volume);
-                            s_volume_percent.store(pct);
-                            s_volume_known.store(true);
+                            if (control_coalescer_t *ctl = volume_control()) {
+                                // Set from the app: nothing of ours left to glide to
+                                control_coalescer_sync(ctl, pct);
+                            }
+                            apply_volume(pct, false, nullptr);
                             ESP_LOGI(TAG, "Spotify volume -> %d%%", pct);
                         }
                         break;
                     case cspot::SpircHandler::EventType::PLAY_PAUSE:
                         if (std::holds_alternative<bool>(event->data)) {
                             bool paused = std::get<bool>(event->data);
+                            set_playing(!paused);
+                            mark_active();
                             ESP_LOGI(TAG, "Spotify player %s", paused ? "paused" : "playing");
                         }
                         break;
                     case cspot::SpircHandler::EventType::DISC:
                         ESP_LOGW(TAG, "Spotify session lost; waiting for reconnect");
                         s_player_ready.store(false);
+                        set_playing(false);
                         break;
                     case cspot::SpircHandler::EventType::PLAYBACK_START:
                         s_player_ready.store(true);
+                        set_playing(true);
                         ESP_LOGI(TAG, "Spotify playback started");
                         break;
                     default:
@@ -453,9 +839,30 @@ class SpotifyPlayerTask : public bell::Task {
         ESP_LOGI(TAG, "Spotify Connect session started as %s", blob->getDeviceName().c_str());
         ESP_LOGI(TAG, "Entering cspot packet handling loop...");
 
-        while (true) {
-            ctx->session->handlePacket();
+        // A stop or a Wi-Fi drop lands once the next packet does; Spotify
+        // pings an idle session every couple of minutes
+        int64_t volume_saved_us = esp_timer_get_time();
+        try {
+            while (!s_stop_requested.load() && !s_link_lost.load()) {
+                ctx->session->handlePacket();
+                if (esp_timer_get_time() - volume_saved_us >= kVolumeSaveUs) {
+                    save_volume();
+                    volume_saved_us = esp_timer_get_time();
+                }
+            }
+        } catch (const std::exception &e) {
+            ESP_LOGW(TAG, "Spotify connection lost: %s", e.what());
+        }
+        ESP_LOGI(TAG, "Leaving Spotify Connect session");
+        set_spirc_handler(nullptr);
+        set_playing(false);
+        try {
+            handler->disconnect();
+            ctx->session->disconnect();
+        } catch (...) {
         }
+        mem_tags_charge(MEM_TAG_CSPOT, -session_bytes);
+        return true;
     }
 };
 
@@ -476,19 +883,51 @@ extern "C" esp_err_t spotify_player_start(const spotify_player_config_t *config)
         ESP_LOGE(TAG, "spotify_player_start: invalid config");
         return ESP_ERR_INVALID_ARG;
     }
-    if (s_task) {
-        ESP_LOGW(TAG, "spotify_player_start: task already running");
+    if (s_task_running.load()) {
+        if (s_stop_requested.exchange(false)) {
+            // Caught before the session loop noticed; keep it
+            ESP_LOGI(TAG, "spotify_player_start: idle stop cancelled");
+        } else {
+            ESP_LOGW(TAG, "spotify_player_start: task already running");
+        }
+        mark_active();
         return ESP_OK;
     }
+    delete s_task;
+    s_task = nullptr;
+
+    s_stop_requested.store(false);
+    set_playing(false);
+    s_idle_stop_ms = config->idle_stop_ms;
+    mark_active();
+    if (s_idle_stop_ms > 0 && !s_idle_timer) {
+        const esp_timer_create_args_t args = {
+            .callback = idle_check,
+            .arg = nullptr,
+            .dispatch_method = ESP_TIMER_TASK,
+            .name = "spotify_idle",
+            .skip_unhandled_events = true,
+        };
+        if (esp_timer_create(&args, &s_idle_timer) != ESP_OK) {
+            ESP_LOGW(TAG, "No idle timer; Spotify Connect will stay up");
+            s_idle_timer = nullptr;
+        }
+    }
+
     ESP_LOGI(TAG, "Creating SpotifyPlayerTask (device: %s, port: %d)", 
              config->device_name ? config->device_name : "default",
              config->zeroconf_port ? config->zeroconf_port : 8080);
+    s_task_running.store(true);
     SpotifyPlayerTask *task = new (std::nothrow) SpotifyPlayerTask(*config);
     if (!task) {
+        s_task_running.store(false);
         ESP_LOGE(TAG, "Failed to create SpotifyPlayerTask: out of memory");
         return ESP_ERR_NO_MEM;
     }
     s_task = task;
+    if (s_idle_timer && s_idle_stop_ms > 0) {
+        esp_timer_start_periodic(s_idle_timer, kIdleCheckUs);
+    }
     ESP_LOGI(TAG, "SpotifyPlayerTask created successfully");
     return ESP_OK;
 #else
@@ -498,6 +937,78 @@ extern "C" esp_err_t spotify_player_start(const spotify_player_config_t *config)
 #endif
 }
 
+extern "C" esp_err_t spotify_player_configure(const spotify_player_config_t *config)
+{
+#if CONFIG_KVA_SPOTIFY_USE_CSPOT
+    if (!config) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    s_stored.device_name = config->device_name ? config->device_name : "";
+    s_stored.credentials_path = config->credentials_path ? config->credentials_path : "";
+    s_stored.cfg = *config;
+    s_stored.cfg.device_name = config->device_name ? s_stored.device_name.c_str() : nullptr;
+    s_stored.cfg.credentials_path = config->credentials_path ? s_stored.credentials_path.c_str() : nullptr;
+    s_stored.configured = true;
+    return ESP_OK;
+#else
+    (void)config;
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
+extern "C" esp_err_t spotify_player_ensure_started(void)
+{
+#if CONFIG_KVA_SPOTIFY_USE_CSPOT
+    if (!s_stored.configured) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    return spotify_player_start(&s_stored.cfg);
+#else
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
+extern "C" esp_err_t spotify_player_stop(void)
+{
+#if CONFIG_KVA_SPOTIFY_USE_CSPOT
+    if (!s_task_running.load()) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    s_stop_requested.store(true);
+    TaskHandle_t task = s_player_task.load();
+    if (task) {
+        // Out of a retry's backoff
+        xTaskNotifyGive(task);
+    }
+    return ESP_OK;
+#else
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
+extern "C" bool spotify_player_has_credentials(void)
+{
+#if CONFIG_KVA_SPOTIFY_USE_CSPOT
+    if (!nvs_load_string(kNvsBlob).empty()) {
+        return true;
+    }
+    const char *path = s_stored.configured && s_stored.cfg.credentials_path ? s_stored.cfg.credentials_path
+                                                                            : kDefaultCredsPath;
+    return access(path, R_OK) == 0;
+#else
+    return false;
+#endif
+}
+
+extern "C" bool spotify_player_is_running(void)
+{
+#if CONFIG_KVA_SPOTIFY_USE_CSPOT
+    return s_task_running.load() && !s_stop_requested.load();
+#else
+    return false;
+#endif
+}
+
 extern "C" bool spotify_player_is_ready(void)
 {
 #if CONFIG_KVA_SPOTIFY_USE_CSPOT
@@ -516,6 +1027,7 @@ extern "C" esp_err_t spotify_player_pause(void)
         return ESP_ERR_INVALID_STATE;
     }
     handler->setPause(true);
+    mark_active();
     return ESP_OK;
 #else
     return ESP_ERR_NOT_SUPPORTED;
@@ -531,6 +1043,7 @@ extern "C" esp_err_t spotify_player_resume(void)
         return ESP_ERR_INVALID_STATE;
     }
     handler->setPause(false);
+    mark_active();
     s_player_ready.store(true);
     return ESP_OK;
 #else
@@ -546,10 +1059,13 @@ extern "C" esp_err_t spotify_player_set_volume_percent(int percent)
         ESP_LOGE(TAG, "cspot not ready");
         return ESP_ERR_INVALID_STATE;
     }
+    mark_active();
     percent = clamp_percent(percent);
-    handler->setRemoteVolume(percent_to_spirc_volume(percent));
-    s_volume_percent.store(percent);
-    s_volume_known.store(true);
+    if (control_coalescer_t *ctl = volume_control()) {
+        control_coalescer_set(ctl, percent);
+    } else {
+        apply_volume(percent, true, nullptr);
+    }
     return ESP_OK;
 #else
     (void)percent;
@@ -565,11 +1081,14 @@ extern "C" esp_err_t spotify_player_volume_delta(int delta_percent)
         ESP_LOGE(TAG, "cspot not ready");
         return ESP_ERR_INVALID_STATE;
     }
+    mark_active();
+    if (control_coalescer_t *ctl = volume_control()) {
+        // From the target, so "louder, louder" adds up before the glide catches up
+        control_coalescer_add(ctl, delta_percent, 0, 100);
+        return ESP_OK;
+    }
     int current = s_volume_known.load() ? s_volume_percent.load() : 50;
-    int target = clamp_percent(current + delta_percent);
-    handler->setRemoteVolume(percent_to_spirc_volume(target));
-    s_volume_percent.store(target);
-    s_volume_known.store(true);
+    apply_volume(clamp_percent(current + delta_percent), true, nullptr);
     return ESP_OK;
 #else
     (void)delta_percent;
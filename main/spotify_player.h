@@ -1,6 +1,7 @@
 #pragma once
 
 #include <stdbool.h>
+#include <stdint.h>
 
 #include "esp_err.h"
 
@@ -12,9 +13,31 @@ typedef struct {
     const char *device_name;
     const char *credentials_path;
     uint16_t zeroconf_port;
+    // Start before Wi-Fi has an address: the player task mounts SPIFFS and
+    // reads stored credentials right away, then waits for an IPv4 address
+    // before pairing or logging in
+    bool wait_for_network;
+    // Stop the player after this long without playback or commands, which
+    // frees the task stack, the session and its TLS buffers. 0 = never
+    uint32_t idle_stop_ms;
 } spotify_player_config_t;
 
 esp_err_t spotify_player_start(const spotify_player_config_t *config);
+
+// Keep a copy of config for spotify_player_ensure_started without starting
+esp_err_t spotify_player_configure(const spotify_player_config_t *config);
+
+// Start with the configured settings unless running; cancels a pending idle
+// stop. ESP_ERR_INVALID_STATE before spotify_player_configure
+esp_err_t spotify_player_ensure_started(void);
+
+// Leave the session and end the task once the next packet arrives
+esp_err_t spotify_player_stop(void);
+
+// Paired before: a start logs in from stored credentials without the app
+bool spotify_player_has_credentials(void);
+
+bool spotify_player_is_running(void);
 bool spotify_player_is_ready(void);
 esp_err_t spotify_player_pause(void);
 esp_err_t spotify_player_resume(void);
@@ -0,0 +1,47 @@
+#include "sr_models.h"
+
+#include <stdbool.h>
+
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+static const char *TAG = "sr_models";
+
+#define SR_MODELS_PARTITION "model"
+
+static srmodel_list_t *s_models;
+static bool s_loaded;                 // Tried, with or without success
+static SemaphoreHandle_t s_lock;
+
+srmodel_list_t *sr_models_get(void)
+{
+    if (__atomic_load_n(&s_loaded, __ATOMIC_ACQUIRE)) {
+        return s_models;
+    }
+    // The first callers race only to create the lock
+    SemaphoreHandle_t lock = __atomic_load_n(&s_lock, __ATOMIC_ACQUIRE);
+    if (!lock) {
+        SemaphoreHandle_t created = xSemaphoreCreateMutex();
+        if (!created) {
+            return NULL;
+        }
+        if (__atomic_compare_exchange_n(&s_lock, &lock, created, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            lock = created;
+        } else {
+            vSemaphoreDelete(created);
+        }
+    }
+    xSemaphoreTake(lock, portMAX_DELAY);
+    if (!s_loaded) {
+        s_models = esp_srmodel_init(SR_MODELS_PARTITION);
+        if (s_models && s_models->num > 0) {
+            ESP_LOGI(TAG, "%d ESP-SR models in \"%s\"", s_models->num, SR_MODELS_PARTITION);
+        } else {
+            ESP_LOGW(TAG, "No ESP-SR models in \"%s\"", SR_MODELS_PARTITION);
+        }
+        __atomic_store_n(&s_loaded, true, __ATOMIC_RELEASE);
+    }
+    xSemaphoreGive(lock);
+    return s_models;
+}
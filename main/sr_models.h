@@ -0,0 +1,27 @@
+#pragma once
+
+#include "model_path.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * The ESP-SR model list of the "model" partition (WakeNet, MultiNet, the
+ * AFE's models), shared by every AFE instance and the local command
+ * recogniser.
+ *
+ * esp_srmodel_init() maps the whole partition and parses its index each
+ * time it is called, and esp_srmodel_deinit() unmaps it under any model
+ * still reading its weights from flash. The list is loaded the first time
+ * it is asked for and kept for the rest of the run, so the partition is
+ * mapped once and models that are never created are never touched.
+ *
+ * Do not pass the result to esp_srmodel_deinit(). NULL when the partition
+ * holds no ESP-SR models. Callable from any task.
+ */
+srmodel_list_t *sr_models_get(void);
+
+#ifdef __cplusplus
+}
+#endif
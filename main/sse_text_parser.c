@@ -0,0 +1,318 @@
+#include "sse_text_parser.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include "esp_log.h"
+
+static const char *TAG = "sse_text";
+
+static bool tok_eq(const char *js, const jsmntok_t *t, const char *s)
+{
+    size_t len = strlen(s);
+    return (size_t)(t->end - t->start) == len && memcmp(js + t->start, s, len) == 0;
+}
+
+// Index of the token following t[i] and everything nested under it
+static int tok_skip(const jsmntok_t *t, int i, int count)
+{
+    int pending = 1;
+    while (pending > 0 && i < count) {
+        pending += t[i].size - 1;
+        ++i;
+    }
+    return i;
+}
+
+// Value token for key in object t[obj], or -1
+static int obj_get(const char *js, const jsmntok_t *t, int obj, int count, const char *key)
+{
+    if (t[obj].type != JSMN_OBJECT) {
+        return -1;
+    }
+    int i = obj + 1;
+    for (int k = 0; k < t[obj].size && i + 1 < count; ++k) {
+        if (t[i].type == JSMN_STRING && tok_eq(js, &t[i], key)) {
+            return i + 1;
+        }
+        i = tok_skip(t, i + 1, count);
+    }
+    return -1;
+}
+
+static int hex_digit(char c)
+{
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+static int32_t hex4(const char *s)
+{
+    int32_t v = 0;
+    for (int i = 0; i < 4; ++i) {
+        int d = hex_digit(s[i]);
+        if (d < 0) {
+            return -1;
+        }
+        v = (v << 4) | d;
+    }
+    return v;
+}
+
+static size_t utf8_encode(uint32_t cp, char *out)
+{
+    if (cp < 0x80) {
+        out[0] = (char)cp;
+        return 1;
+    }
+    if (cp < 0x800) {
+        out[0] = (char)(0xC0 | (cp >> 6));
+        out[1] = (char)(0x80 | (cp & 0x3F));
+        return 2;
+    }
+    if (cp < 0x10000) {
+        out[0] = (char)(0xE0 | (cp >> 12));
+        out[1] = (char)(0x80 | ((cp >> 6) & 0x3F));
+        out[2] = (char)(0x80 | (cp & 0x3F));
+        return 3;
+    }
+    out[0] = (char)(0xF0 | (cp >> 18));
+    out[1] = (char)(0x80 | ((cp >> 12) & 0x3F));
+    out[2] = (char)(0x80 | ((cp >> 6) & 0x3F));
+    out[3] = (char)(0x80 | (cp & 0x3F));
+    return 4;
+}
+
+/**
+ * Decode JSON escapes of s[0..len) in place and NUL-terminate. The output is
+ * never longer than the input, and s[len] (the closing quote) is writable.
+ */
+static const char *unescape_in_place(char *s, size_t len)
+{
+    size_t r = 0;
+    size_t w = 0;
+    while (r < len) {
+        char c = s[r++];
+        if (c != '\\' || r >= len) {
+            s[w++] = c;
+            continue;
+        }
+        char e = s[r++];
+        switch (e) {
+        case 'n': s[w++] = '\n'; break;
+        case 'r': s[w++] = '\r'; break;
+        case 't': s[w++] = '\t'; break;
+        case 'b': s[w++] = '\b'; break;
+        case 'f': s[w++] = '\f'; break;
+        case 'u': {
+            int32_t cp = r + 4 <= len ? hex4(s + r) : -1;
+            if (cp < 0) {
+                s[w++] = '?';
+                break;
+            }
+            r += 4;
+            if (cp >= 0xD800 && cp <= 0xDBFF && r + 6 <= len && s[r] == '\\' && s[r + 1] == 'u') {
+                int32_t lo = hex4(s + r + 2);
+                if (lo >= 0xDC00 && lo <= 0xDFFF) {
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+                    r += 6;
+                }
+            }
+            w += utf8_encode((uint32_t)cp, s + w);
+            break;
+        }
+        default:
+            // \" \\ \/ and anything unknown map to the character itself
+            s[w++] = e;
+            break;
+        }
+    }
+    s[w] = '\0';
+    return s;
+}
+
+static void emit_text(sse_text_parser_t *p, char *js, const jsmntok_t *t)
+{
+    if (t->type != JSMN_STRING || t->end <= t->start || !p->callback) {
+        return;
+    }
+    p->callback(unescape_in_place(js + t->start, t->end - t->start), false, p->callback_ctx);
+}
+
+static void emit_done(sse_text_parser_t *p)
+{
+    if (p->done_sent) {
+        return;
+    }
+    p->done_sent = true;
+    if (p->callback) {
+        p->callback("", true, p->callback_ctx);
+    }
+}
+
+static void handle_event(sse_text_parser_t *p, char *js, size_t len)
+{
+    if (len == 6 && memcmp(js, "[DONE]", 6) == 0) {
+        emit_done(p);
+        return;
+    }
+
+    jsmn_parser parser;
+    jsmn_init(&parser);
+    jsmntok_t *t = p->tokens;
+    int count = jsmn_parse(&parser, js, len, t, SSE_TEXT_MAX_TOKENS);
+    if (count == JSMN_ERROR_NOMEM) {
+        ESP_LOGW(TAG, "Event exceeds %d tokens, skipped", SSE_TEXT_MAX_TOKENS);
+        return;
+    }
+    if (count < 1 || t[0].type != JSMN_OBJECT) {
+        return;
+    }
+
+    // Responses API streaming events
+    int type = obj_get(js, t, 0, count, "type");
+    if (type > 0 && t[type].type == JSMN_STRING) {
+        if (tok_eq(js, &t[type], "response.output_text.delta")) {
+            int delta = obj_get(js, t, 0, count, "delta");
+            if (delta > 0) {
+                emit_text(p, js, &t[delta]);
+            }
+            return;
+        }
+        if (tok_eq(js, &t[type], "response.completed")) {
+            emit_done(p);
+            return;
+        }
+    }
+
+    // Whole-response snapshots: output[].content[] with type output_text
+    int output = obj_get(js, t, 0, count, "output");
+    if (output > 0 && t[output].type == JSMN_ARRAY) {
+        int msg = output + 1;
+        for (int m = 0; m < t[output].size && msg < count; ++m) {
+            int content = obj_get(js, t, msg, count, "content");
+            if (content > 0 && t[content].type == JSMN_ARRAY) {
+                int entry = content + 1;
+                for (int e = 0; e < t[content].size && entry < count; ++e) {
+                    int etype = obj_get(js, t, entry, count, "type");
+                    if (etype > 0 && tok_eq(js, &t[etype], "output_text")) {
+                        int text = obj_get(js, t, entry, count, "text");
+                        if (text > 0) {
+                            emit_text(p, js, &t[text]);
+                        }
+                    }
+                    entry = tok_skip(t, entry, count);
+                }
+            }
+            msg = tok_skip(t, msg, count);
+        }
+    }
+
+    // Gemini streamGenerateContent: candidates[].content.parts[]
+    int candidates = obj_get(js, t, 0, count, "candidates");
+    if (candidates > 0 && t[candidates].type == JSMN_ARRAY) {
+        int cand = candidates + 1;
+        for (int c = 0; c < t[candidates].size && cand < count; ++c) {
+            int content = obj_get(js, t, cand, count, "content");
+            int parts = content > 0 ? obj_get(js, t, content, count, "parts") : -1;
+            if (parts > 0 && t[parts].type == JSMN_ARRAY) {
+                int part = parts + 1;
+                for (int i = 0; i < t[parts].size && part < count; ++i) {
+                    if (obj_get(js, t, part, count, "functionCall") > 0) {
+                        p->tool_call_seen = true;
+                    } else {
+                        int text = obj_get(js, t, part, count, "text");
+                        if (text > 0) {
+                            emit_text(p, js, &t[text]);
+                        }
+                    }
+                    part = tok_skip(t, part, count);
+                }
+            }
+            cand = tok_skip(t, cand, count);
+        }
+    }
+
+    int done = obj_get(js, t, 0, count, "done");
+    if (done > 0 && t[done].type == JSMN_PRIMITIVE && tok_eq(js, &t[done], "true")) {
+        emit_done(p);
+    }
+}
+
+static void handle_line(sse_text_parser_t *p)
+{
+    char *line = p->line;
+    size_t len = p->line_len;
+    if (len && line[len - 1] == '\r') {
+        --len;
+    }
+    if (len < 5 || memcmp(line, "data:", 5) != 0) {
+        return;  // Blank separators, "event:", "id:", comments
+    }
+    line += 5;
+    len -= 5;
+    if (len && *line == ' ') {
+        ++line;
+        --len;
+    }
+    line[len] = '\0';
+    handle_event(p, line, len);
+}
+
+void sse_text_parser_init(sse_text_parser_t *parser, sse_text_cb_t callback, void *callback_ctx)
+{
+    parser->line_len = 0;
+    parser->line_overflow = false;
+    parser->callback = callback;
+    parser->callback_ctx = callback_ctx;
+    parser->done_sent = false;
+    parser->tool_call_seen = false;
+}
+
+void sse_text_parser_feed(sse_text_parser_t *parser, const char *data, size_t len)
+{
+    while (len > 0) {
+        const char *nl = memchr(data, '\n', len);
+        size_t seg = nl ? (size_t)(nl - data) : len;
+
+        if (!parser->line_overflow) {
+            // Keep one byte for the terminator written by handle_line()
+            if (parser->line_len + seg < sizeof(parser->line)) {
+                memcpy(parser->line + parser->line_len, data, seg);
+                parser->line_len += seg;
+            } else {
+                ESP_LOGW(TAG, "SSE line over %d bytes dropped", SSE_TEXT_LINE_MAX);
+                parser->line_overflow = true;
+            }
+        }
+
+        if (!nl) {
+            return;
+        }
+        if (!parser->line_overflow) {
+            handle_line(parser);
+        }
+        parser->line_len = 0;
+        parser->line_overflow = false;
+        data += seg + 1;
+        len -= seg + 1;
+    }
+}
+
+void sse_text_parser_finish(sse_text_parser_t *parser)
+{
+    if (parser->line_len && !parser->line_overflow) {
+        handle_line(parser);
+    }
+    parser->line_len = 0;
+    parser->line_overflow = false;
+    emit_done(parser);
+}
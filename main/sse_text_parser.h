@@ -0,0 +1,71 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "jsmn.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Longest single "data:" line kept; longer events are dropped with a warning
+#ifndef SSE_TEXT_LINE_MAX
+#define SSE_TEXT_LINE_MAX 4096
+#endif
+
+// JSON tokens per event; Responses API deltas need ~20
+#ifndef SSE_TEXT_MAX_TOKENS
+#define SSE_TEXT_MAX_TOKENS 128
+#endif
+
+/**
+ * Receives each text fragment as soon as its event is complete. text is
+ * only valid for the duration of the call. is_done is sent exactly once.
+ */
+typedef void (*sse_text_cb_t)(const char *text, bool is_done, void *ctx);
+
+/**
+ * Incremental Server-Sent Events reader that pulls LLM text out of each
+ * "data:" event without copying or allocating.
+ *
+ * Bytes are appended to a fixed line buffer across HTTP chunks. Each complete
+ * event is tokenised in place with jsmn, and the text string is unescaped in
+ * place. Understood payloads are:
+ *   {"type":"response.output_text.delta","delta":"..."}
+ *   {"output":[{"content":[{"type":"output_text","text":"..."}]}], "done":true}
+ *   {"candidates":[{"content":{"parts":[{"text":"..."}]}}]} (Gemini alt=sse)
+ *   {"type":"response.completed"} and "[DONE]" (end of stream)
+ *
+ * Gemini functionCall parts are not text; they only set tool_call_seen so
+ * the caller can fall back to the tool-calling request path.
+ *
+ * The struct is large (~6 KB); keep it on the heap, not a task stack.
+ */
+typedef struct {
+    char line[SSE_TEXT_LINE_MAX];
+    size_t line_len;
+    bool line_overflow;               // Discarding until the next newline
+    jsmntok_t tokens[SSE_TEXT_MAX_TOKENS];
+    sse_text_cb_t callback;
+    void *callback_ctx;
+    bool done_sent;
+    bool tool_call_seen;
+} sse_text_parser_t;
+
+void sse_text_parser_init(sse_text_parser_t *parser, sse_text_cb_t callback, void *callback_ctx);
+
+/**
+ * Feed raw response bytes; splits across lines and events are handled.
+ */
+void sse_text_parser_feed(sse_text_parser_t *parser, const char *data, size_t len);
+
+/**
+ * Flush a trailing event without a newline and send is_done if the stream
+ * never signalled it.
+ */
+void sse_text_parser_finish(sse_text_parser_t *parser);
+
+#ifdef __cplusplus
+}
+#endif
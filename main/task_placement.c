@@ -0,0 +1,154 @@
+#include "task_placement.h"
+
+#include "esp_log.h"
+#include "sdkconfig.h"
+
+static const char *TAG = "task_placement";
+
+#define AUDIO TASK_PLACEMENT_AUDIO_CORE
+#define NETWORK TASK_PLACEMENT_NETWORK_CORE
+
+#ifndef CONFIG_NAPHOME_AWS_IOT_TASK_CORE
+#define CONFIG_NAPHOME_AWS_IOT_TASK_CORE 0
+#endif
+#ifndef CONFIG_SENSOR_MANAGER_TASK_CORE
+#define CONFIG_SENSOR_MANAGER_TASK_CORE 0
+#endif
+#ifndef CONFIG_SOMNUS_BLE_TASK_CORE
+#define CONFIG_SOMNUS_BLE_TASK_CORE 0
+#endif
+#ifndef CONFIG_BT_NIMBLE_PINNED_TO_CORE
+#define CONFIG_BT_NIMBLE_PINNED_TO_CORE 0
+#endif
+
+// Priorities on the audio core follow the data: capture runs in the I2S
+// interrupt (korvo_capture only starts it), output outranks the AFE, so a
+// slow AFE frame costs latency, not samples.
+static const task_placement_t PLAN[TASK_PLACEMENT_COUNT] = {
+    [TASK_PLACEMENT_CAPTURE] = {"korvo_capture", 3072, 8, AUDIO},
+    [TASK_PLACEMENT_AUDIO_OUT] = {"audio_out", 3072, 7, AUDIO},
+    [TASK_PLACEMENT_AUDIO_GRAPH] = {"audio_graph", 8192, 4, AUDIO},
+    [TASK_PLACEMENT_AFE] = {"voice_pipeline", 8192, 4, AUDIO},
+
+    // Spotify calls from the local command task may go out over HTTP
+    [TASK_PLACEMENT_LOCAL_COMMANDS] = {"local_cmd", 6144, 6, NETWORK},
+    // Every worker shares the name; the report shows the first one found
+    [TASK_PLACEMENT_INTERACTION_WORKER] = {"interaction_wk", 8192, 5, NETWORK},
+    // Device state is serialised to JSON here for get_device_state
+    [TASK_PLACEMENT_TOOL_WORKER] = {"tool_wk", 4096, 5, NETWORK},
+    // One per batch STT request in flight; each runs its own TLS session
+    [TASK_PLACEMENT_STT_ATTEMPT] = {"stt_attempt", 8192, 5, NETWORK},
+    [TASK_PLACEMENT_GEMINI_LIVE_UPLINK] = {"gemini_live_up", 4096, 5, NETWORK},
+    [TASK_PLACEMENT_OPENAI_UPLINK] = {"openai_rt_up", 4096, 5, NETWORK},
+    [TASK_PLACEMENT_LIVE_CLOSE] = {"live_close", 4096, 4, NETWORK},
+    [TASK_PLACEMENT_CLOUD_SESSION] = {"cloud_session", 8192, 4, NETWORK},
+    // The TTS worker runs the TLS session, so it needs the larger stack
+    [TASK_PLACEMENT_SPEECH_SYNTH] = {"speech_tts", 8192, 5, NETWORK},
+    [TASK_PLACEMENT_SPEECH_PLAYBACK] = {"speech_play", 3072, 5, NETWORK},
+    [TASK_PLACEMENT_SPOTIFY] = {"cspot", 16 * 1024, 0, NETWORK},
+    [TASK_PLACEMENT_SERIAL_COMMANDS] = {"serial_cmd", 4096, 5, NETWORK},
+    // Below the logs' producers, so a telemetry burst waits rather than starving them
+    [TASK_PLACEMENT_SERIAL_LINK] = {"serial_link", 2560, 2, NETWORK},
+    [TASK_PLACEMENT_WAKE_CAPTURE] = {"wake_capture", 3072, 2, NETWORK},
+    [TASK_PLACEMENT_LED_EFFECTS] = {"led_effects", 3072, 3, NETWORK},
+    // Above led_effects, so levels and states land before its next frame
+    [TASK_PLACEMENT_STATUS_EVENTS] = {"status_events", 3072, 4, NETWORK},
+    // Shadow and metrics callbacks build JSON here
+    [TASK_PLACEMENT_TIMER_WHEEL] = {"timer_wheel", 4096, 5, NETWORK},
+    [TASK_PLACEMENT_SOUND_BANK] = {"sound_bank", 3072, 5, NETWORK},
+    // Above the other network tasks: clock exchanges are timestamped here
+    [TASK_PLACEMENT_MULTIROOM] = {"multiroom", 4096, 6, NETWORK},
+    [TASK_PLACEMENT_DNS_CACHE] = {"dns_cache", 3072, 2, NETWORK},
+    [TASK_PLACEMENT_AUDIO_GRAPH_AUX] = {"audio_graph_aux", 4096, 3, NETWORK},
+    [TASK_PLACEMENT_LOG_DRAIN] = {"log_drain", 3072, 1, NETWORK},
+    // Lowest: the AFE it builds is not needed until the room goes quiet
+    [TASK_PLACEMENT_AFE_STANDBY] = {"afe_standby", 6144, 1, NETWORK},
+
+    [TASK_PLACEMENT_AWS_IOT] = {"aws_iot_service", 0, 5, CONFIG_NAPHOME_AWS_IOT_TASK_CORE},
+    [TASK_PLACEMENT_SENSOR_SAMPLING] = {"sensor_sampling", 0, 5, CONFIG_SENSOR_MANAGER_TASK_CORE},
+    [TASK_PLACEMENT_SENSOR_MANAGER] = {"sensor_manager", 0, 5, CONFIG_SENSOR_MANAGER_TASK_CORE},
+    [TASK_PLACEMENT_BLE_COMMANDS] = {"somnus_ble_cmd", 0, 5, CONFIG_SOMNUS_BLE_TASK_CORE},
+    [TASK_PLACEMENT_BLE_HOST] = {"nimble_host", 0, configMAX_PRIORITIES - 4, CONFIG_BT_NIMBLE_PINNED_TO_CORE},
+};
+
+// Lowest free stack seen per task, in bytes; UINT32_MAX until first seen
+static uint32_t s_min_free[TASK_PLACEMENT_COUNT];
+static bool s_min_free_init;
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static void record_free(task_placement_id_t id, uint32_t free_bytes)
+{
+    portENTER_CRITICAL(&s_lock);
+    if (!s_min_free_init) {
+        for (int i = 0; i < TASK_PLACEMENT_COUNT; ++i) {
+            s_min_free[i] = UINT32_MAX;
+        }
+        s_min_free_init = true;
+    }
+    if (free_bytes < s_min_free[id]) {
+        s_min_free[id] = free_bytes;
+    }
+    portEXIT_CRITICAL(&s_lock);
+}
+
+const task_placement_t *task_placement_get(task_placement_id_t id)
+{
+    return id < TASK_PLACEMENT_COUNT ? &PLAN[id] : NULL;
+}
+
+BaseType_t task_placement_create(task_placement_id_t id, TaskFunction_t fn, void *arg, TaskHandle_t *out)
+{
+    const task_placement_t *plan = task_placement_get(id);
+    if (!plan || plan->stack_bytes == 0) {
+        ESP_LOGE(TAG, "Task %d is not created from the plan", (int)id);
+        return pdFAIL;
+    }
+    return xTaskCreatePinnedToCore(fn, plan->name, plan->stack_bytes, arg, plan->priority, out, plan->core);
+}
+
+void task_placement_note_exit(task_placement_id_t id)
+{
+    if (id < TASK_PLACEMENT_COUNT) {
+        // ESP-IDF reports the high-water mark in bytes
+        record_free(id, (uint32_t)uxTaskGetStackHighWaterMark(NULL));
+    }
+}
+
+uint32_t task_placement_min_free_bytes(task_placement_id_t id)
+{
+    if (id >= TASK_PLACEMENT_COUNT) {
+        return UINT32_MAX;
+    }
+    portENTER_CRITICAL(&s_lock);
+    uint32_t min_free = s_min_free_init ? s_min_free[id] : UINT32_MAX;
+    portEXIT_CRITICAL(&s_lock);
+    return min_free;
+}
+
+void task_placement_log_stacks(void)
+{
+    for (int i = 0; i < TASK_PLACEMENT_COUNT; ++i) {
+        const task_placement_t *plan = &PLAN[i];
+        TaskHandle_t task = xTaskGetHandle(plan->name);
+        if (task) {
+            record_free((task_placement_id_t)i, (uint32_t)uxTaskGetStackHighWaterMark(task));
+        }
+        portENTER_CRITICAL(&s_lock);
+        uint32_t min_free = s_min_free_init ? s_min_free[i] : UINT32_MAX;
+        portEXIT_CRITICAL(&s_lock);
+        if (min_free == UINT32_MAX) {
+            continue;
+        }
+        if (plan->stack_bytes) {
+            ESP_LOGI(TAG, "%-15s core %d prio %2u: %5u of %5u bytes free at worst%s", plan->name, (int)plan->core,
+                     (unsigned)plan->priority, (unsigned)min_free, (unsigned)plan->stack_bytes,
+                     task ? "" : " (not running)");
+        } else {
+            ESP_LOGI(TAG, "%-15s core %d prio %2u: %5u bytes free at worst%s", plan->name, (int)plan->core,
+                     (unsigned)plan->priority, (unsigned)min_free, task ? "" : " (not running)");
+        }
+        if (min_free < TASK_PLACEMENT_STACK_WARN_BYTES) {
+            ESP_LOGW(TAG, "%s is within %u bytes of its stack end", plan->name, (unsigned)min_free);
+        }
+    }
+}
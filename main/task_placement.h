@@ -0,0 +1,91 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "kva_config_defaults.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Core that runs I2S capture, the AFE and I2S output, and nothing else
+#define TASK_PLACEMENT_AUDIO_CORE CONFIG_KVA_AUDIO_CORE
+// Core for Wi-Fi/lwIP, TLS, JSON and every other task
+#define TASK_PLACEMENT_NETWORK_CORE (1 - CONFIG_KVA_AUDIO_CORE)
+
+// Minimum unused stack before the report warns about a task
+#ifndef TASK_PLACEMENT_STACK_WARN_BYTES
+#define TASK_PLACEMENT_STACK_WARN_BYTES 512
+#endif
+
+/**
+ * Every long-lived task of the assistant, with its core, priority and
+ * stack in one table (task_placement.c). The audio core is reserved for
+ * the tasks that must never miss a DMA period; anything that can block on
+ * the network or burn milliseconds of CPU goes on the network core.
+ */
+typedef enum {
+    // Audio core
+    TASK_PLACEMENT_CAPTURE,           // korvo_capture: starts I2S RX here so its interrupt lands on this core, then exits
+    TASK_PLACEMENT_AUDIO_OUT,         // audio_out: mixer and I2S TX
+    TASK_PLACEMENT_AUDIO_GRAPH,       // audio_graph: capture-rate nodes (AFE, wake word, meters)
+    TASK_PLACEMENT_AFE,               // voice_pipeline: wake-to-reply interactions
+    // Network core
+    TASK_PLACEMENT_LOCAL_COMMANDS,
+    TASK_PLACEMENT_INTERACTION_WORKER,  // interaction_pool: batch STT, LLM and TTS of one reply per worker
+    TASK_PLACEMENT_TOOL_WORKER,       // tool_dispatch: function calls of one model reply, side by side
+    TASK_PLACEMENT_STT_ATTEMPT,       // batch_stt: one provider's transcription, so the caller can fail over or hedge
+    TASK_PLACEMENT_GEMINI_LIVE_UPLINK,
+    TASK_PLACEMENT_OPENAI_UPLINK,
+    TASK_PLACEMENT_LIVE_CLOSE,
+    TASK_PLACEMENT_CLOUD_SESSION,
+    TASK_PLACEMENT_SPEECH_SYNTH,
+    TASK_PLACEMENT_SPEECH_PLAYBACK,
+    TASK_PLACEMENT_SPOTIFY,
+    TASK_PLACEMENT_SERIAL_COMMANDS,
+    TASK_PLACEMENT_SERIAL_LINK,       // serial_link: writes binary telemetry frames to the console port
+    TASK_PLACEMENT_WAKE_CAPTURE,      // wake_capture: sends audio windows around wake events
+    TASK_PLACEMENT_LED_EFFECTS,       // led_effects: composites and refreshes the WS2812 strip
+    TASK_PLACEMENT_STATUS_EVENTS,     // event_bus subscriber: status LEDs, playback power and coexistence
+    TASK_PLACEMENT_TIMER_WHEEL,       // timer_wheel: housekeeping timer callbacks
+    TASK_PLACEMENT_SOUND_BANK,        // sound_bank: feeds flash-mapped sounds into the mixer
+    TASK_PLACEMENT_MULTIROOM,         // multiroom_sync: streams media between units
+    TASK_PLACEMENT_DNS_CACHE,         // dns_cache: resolves cloud hosts ahead of their requests
+    TASK_PLACEMENT_AUDIO_GRAPH_AUX,   // audio_graph: nodes that may lag the capture (spectrum)
+    TASK_PLACEMENT_LOG_DRAIN,         // log_drain: formats deferred log records off the hot paths
+    TASK_PLACEMENT_AFE_STANDBY,       // voice_pipeline: builds the low-cost AFE instance once, then exits
+    // Created by components, placed by their own Kconfig; listed for the report
+    TASK_PLACEMENT_AWS_IOT,
+    TASK_PLACEMENT_SENSOR_SAMPLING,
+    TASK_PLACEMENT_SENSOR_MANAGER,
+    TASK_PLACEMENT_BLE_COMMANDS,
+    TASK_PLACEMENT_BLE_HOST,
+    TASK_PLACEMENT_COUNT,
+} task_placement_id_t;
+
+typedef struct {
+    const char *name;                 // Shorter than configMAX_TASK_NAME_LEN so the report can find it
+    uint32_t stack_bytes;             // 0 when the owning component sizes it
+    UBaseType_t priority;
+    BaseType_t core;
+} task_placement_t;
+
+const task_placement_t *task_placement_get(task_placement_id_t id);
+
+// xTaskCreatePinnedToCore() with the table's name, stack, priority and core
+BaseType_t task_placement_create(task_placement_id_t id, TaskFunction_t fn, void *arg, TaskHandle_t *out);
+
+// Short-lived tasks call this just before vTaskDelete(NULL) so the report keeps their high-water mark
+void task_placement_note_exit(task_placement_id_t id);
+
+// Log each task's lowest recorded free stack; tasks not running show their last run
+void task_placement_log_stacks(void);
+
+// Lowest free stack recorded for a task in bytes, UINT32_MAX before it has been seen
+uint32_t task_placement_min_free_bytes(task_placement_id_t id);
+
+#ifdef __cplusplus
+}
+#endif
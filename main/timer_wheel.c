@@ -0,0 +1,343 @@
+#include "timer_wheel.h"
+
+#include <stdlib.h>
+
+#include "esp_check.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "task_placement.h"
+
+static const char *TAG = "timer_wheel";
+
+#define WHEEL_BITS 6
+#define WHEEL_SLOTS (1U << WHEEL_BITS)
+#define WHEEL_MASK (WHEEL_SLOTS - 1)
+#define WHEEL_LEVELS 4
+#define WHEEL_SPAN (1U << (WHEEL_BITS * WHEEL_LEVELS))
+#define TICK_US ((int64_t)CONFIG_KVA_TIMER_WHEEL_TICK_MS * 1000)
+#define MAX_GRID_TICKS 4096           // Coarsest deadline rounding slack can ask for
+
+/*
+ * Level L holds timers due 64^L to 64^(L+1) ticks after the wheel's
+ * position, in the slot of their deadline's L-th base-64 digit. When the
+ * position crosses a multiple of 64^L, the level L slot for the new digit
+ * is emptied and its timers placed again, now on a lower level; level 0
+ * slots are exact ticks. Timers further out than the wheel spans wait in
+ * the last level and are placed again when it comes round.
+ */
+struct timer_wheel_timer {
+    timer_wheel_timer_t *next;
+    timer_wheel_timer_t **pprev;      // NULL when not armed
+    uint32_t expires;                 // Tick it fires on
+    uint32_t due;                     // Periodic: unrounded deadline the next period counts from
+    uint32_t period;                  // Ticks, 0 for one-shot
+    uint32_t grid;                    // Deadline rounding from the slack, a power of two
+    uint8_t level;
+    uint8_t slot;
+    timer_wheel_cb_t callback;
+    void *arg;
+    const char *name;
+};
+
+static struct {
+    portMUX_TYPE lock;
+    timer_wheel_timer_t *slots[WHEEL_LEVELS][WHEEL_SLOTS];
+    uint64_t occupied[WHEEL_LEVELS];
+    uint32_t now;                     // Next tick to run; all earlier ones have fired
+    uint32_t sleep_until;             // Tick the task wakes for, valid while sleeping
+    bool sleeping;
+    bool sleep_forever;
+    int64_t origin_us;
+    TaskHandle_t task;
+    timer_wheel_stats_t stats;
+} s_wheel = {
+    .lock = portMUX_INITIALIZER_UNLOCKED,
+};
+
+static uint32_t tick_now(void)
+{
+    return (uint32_t)((esp_timer_get_time() - s_wheel.origin_us) / TICK_US);
+}
+
+static uint32_t round_up(uint32_t tick, uint32_t grid)
+{
+    return (tick + grid - 1) & ~(grid - 1);
+}
+
+static void link(timer_wheel_timer_t *t)
+{
+    uint32_t delta = t->expires - s_wheel.now;
+    if ((int32_t)delta < 0) {
+        t->expires = s_wheel.now;
+        delta = 0;
+    }
+    if (delta >= WHEEL_SPAN) {
+        t->expires = s_wheel.now + WHEEL_SPAN - 1;
+        delta = WHEEL_SPAN - 1;
+    }
+    uint8_t level = 0;
+    while (level < WHEEL_LEVELS - 1 && delta >= (1U << (WHEEL_BITS * (level + 1)))) {
+        ++level;
+    }
+    uint8_t slot = (t->expires >> (WHEEL_BITS * level)) & WHEEL_MASK;
+    timer_wheel_timer_t **head = &s_wheel.slots[level][slot];
+    t->level = level;
+    t->slot = slot;
+    t->next = *head;
+    if (t->next) {
+        t->next->pprev = &t->next;
+    }
+    t->pprev = head;
+    *head = t;
+    s_wheel.occupied[level] |= 1ULL << slot;
+    s_wheel.stats.armed++;
+}
+
+static void unlink(timer_wheel_timer_t *t)
+{
+    *t->pprev = t->next;
+    if (t->next) {
+        t->next->pprev = t->pprev;
+    }
+    t->pprev = NULL;
+    t->next = NULL;
+    if (!s_wheel.slots[t->level][t->slot]) {
+        s_wheel.occupied[t->level] &= ~(1ULL << t->slot);
+    }
+    s_wheel.stats.armed--;
+}
+
+// First occupied slot of a level in wheel order from `from`, or -1
+static int next_occupied(uint8_t level, uint32_t from)
+{
+    uint64_t bits = s_wheel.occupied[level];
+    if (!bits) {
+        return -1;
+    }
+    uint32_t shift = from & WHEEL_MASK;
+    uint64_t rotated = shift ? (bits >> shift) | (bits << (WHEEL_SLOTS - shift)) : bits;
+    return (int)((__builtin_ctzll(rotated) + shift) & WHEEL_MASK);
+}
+
+static void cascade(uint8_t level)
+{
+    uint32_t slot = (s_wheel.now >> (WHEEL_BITS * level)) & WHEEL_MASK;
+    timer_wheel_timer_t *t = s_wheel.slots[level][slot];
+    s_wheel.slots[level][slot] = NULL;
+    s_wheel.occupied[level] &= ~(1ULL << slot);
+    while (t) {
+        timer_wheel_timer_t *next = t->next;
+        s_wheel.stats.armed--;
+        link(t);
+        t = next;
+    }
+    if (slot == 0 && level + 1 < WHEEL_LEVELS) {
+        cascade(level + 1);
+    }
+}
+
+// Earliest deadline armed, false when nothing is
+static bool next_deadline(uint32_t *out)
+{
+    bool found = false;
+    uint32_t best = 0;
+    int slot = next_occupied(0, s_wheel.now);
+    if (slot >= 0) {
+        best = s_wheel.now + (((uint32_t)slot - s_wheel.now) & WHEEL_MASK);
+        found = true;
+    }
+    for (uint8_t level = 1; level < WHEEL_LEVELS; ++level) {
+        // The current digit's slot only holds timers a whole turn away
+        uint32_t digit = s_wheel.now >> (WHEEL_BITS * level);
+        slot = next_occupied(level, digit + 1);
+        if (slot < 0) {
+            continue;
+        }
+        for (timer_wheel_timer_t *t = s_wheel.slots[level][slot]; t; t = t->next) {
+            if (!found || (int32_t)(t->expires - best) < 0) {
+                best = t->expires;
+                found = true;
+            }
+        }
+    }
+    *out = best;
+    return found;
+}
+
+// Run every tick up to and including target. Lock held; dropped around callbacks
+static void advance(uint32_t target)
+{
+    while ((int32_t)(target - s_wheel.now) >= 0) {
+        uint32_t slot = s_wheel.now & WHEEL_MASK;
+        if (slot == 0) {
+            cascade(1);
+        }
+        timer_wheel_timer_t *t;
+        while ((t = s_wheel.slots[0][slot]) != NULL) {
+            unlink(t);
+            timer_wheel_cb_t callback = t->callback;
+            void *arg = t->arg;
+            if (t->period) {
+                t->due += t->period;
+                if ((int32_t)(t->due - s_wheel.now) <= 0) {
+                    // Woke late: skip the periods missed rather than run them back to back
+                    t->due = s_wheel.now + t->period;
+                }
+                t->expires = round_up(t->due, t->grid);
+                link(t);
+            }
+            s_wheel.stats.fired++;
+            portEXIT_CRITICAL(&s_wheel.lock);
+            callback(arg);
+            portENTER_CRITICAL(&s_wheel.lock);
+        }
+
+        // Skip ticks with an empty slot and no cascade, straight to the next of either
+        uint32_t step = WHEEL_SLOTS - slot;
+        int next = next_occupied(0, s_wheel.now + 1);
+        if (next >= 0) {
+            uint32_t to_next = ((uint32_t)next - s_wheel.now) & WHEEL_MASK;
+            if (to_next && to_next < step) {
+                step = to_next;
+            }
+        }
+        uint32_t remaining = target - s_wheel.now + 1;
+        s_wheel.now += step < remaining ? step : remaining;
+    }
+}
+
+static void timer_wheel_task(void *arg)
+{
+    (void)arg;
+    while (true) {
+        portENTER_CRITICAL(&s_wheel.lock);
+        s_wheel.sleeping = false;
+        advance(tick_now());
+        uint32_t deadline;
+        bool armed = next_deadline(&deadline);
+        s_wheel.sleep_until = deadline;
+        s_wheel.sleep_forever = !armed;
+        s_wheel.sleeping = true;
+        portEXIT_CRITICAL(&s_wheel.lock);
+
+        TickType_t wait = portMAX_DELAY;
+        if (armed) {
+            int32_t ticks = (int32_t)(deadline - tick_now());
+            uint32_t ms = ticks > 0 ? (uint32_t)ticks * CONFIG_KVA_TIMER_WHEEL_TICK_MS : 0;
+            wait = (ms + portTICK_PERIOD_MS - 1) / portTICK_PERIOD_MS;
+        }
+        if (wait) {
+            ulTaskNotifyTake(pdTRUE, wait);
+        }
+        __atomic_fetch_add(&s_wheel.stats.wakeups, 1, __ATOMIC_RELAXED);
+    }
+}
+
+esp_err_t timer_wheel_init(void)
+{
+    ESP_RETURN_ON_FALSE(!s_wheel.task, ESP_ERR_INVALID_STATE, TAG, "already running");
+    s_wheel.origin_us = esp_timer_get_time();
+    ESP_RETURN_ON_FALSE(task_placement_create(TASK_PLACEMENT_TIMER_WHEEL, timer_wheel_task, NULL, &s_wheel.task) ==
+                            pdPASS,
+                        ESP_ERR_NO_MEM, TAG, "task");
+    return ESP_OK;
+}
+
+esp_err_t timer_wheel_create(const timer_wheel_timer_config_t *config, timer_wheel_timer_t **out_timer)
+{
+    ESP_RETURN_ON_FALSE(config && config->callback && out_timer, ESP_ERR_INVALID_ARG, TAG, "config");
+    ESP_RETURN_ON_FALSE(s_wheel.task, ESP_ERR_INVALID_STATE, TAG, "not initialized");
+    timer_wheel_timer_t *t = calloc(1, sizeof(*t));
+    ESP_RETURN_ON_FALSE(t, ESP_ERR_NO_MEM, TAG, "timer");
+    t->callback = config->callback;
+    t->arg = config->arg;
+    t->name = config->name;
+    uint32_t slack_ticks = config->slack_ms / CONFIG_KVA_TIMER_WHEEL_TICK_MS;
+    t->grid = 1;
+    while (t->grid * 2 <= slack_ticks && t->grid < MAX_GRID_TICKS) {
+        t->grid *= 2;
+    }
+    *out_timer = t;
+    return ESP_OK;
+}
+
+void timer_wheel_delete(timer_wheel_timer_t *timer)
+{
+    if (!timer) {
+        return;
+    }
+    timer_wheel_stop(timer);
+    free(timer);
+}
+
+static void arm(timer_wheel_timer_t *timer, uint32_t delay_ms, uint32_t period_ms)
+{
+    if (!timer) {
+        return;
+    }
+    // Round the delay up, never fire early
+    int64_t due_us = esp_timer_get_time() - s_wheel.origin_us + (int64_t)delay_ms * 1000;
+    uint32_t due = (uint32_t)((due_us + TICK_US - 1) / TICK_US);
+    uint32_t period = 0;
+    if (period_ms) {
+        period = (period_ms + CONFIG_KVA_TIMER_WHEEL_TICK_MS - 1) / CONFIG_KVA_TIMER_WHEEL_TICK_MS;
+    }
+
+    bool wake;
+    portENTER_CRITICAL(&s_wheel.lock);
+    if (timer->pprev) {
+        unlink(timer);
+    }
+    timer->due = due;
+    timer->period = period;
+    timer->expires = round_up(due, timer->grid);
+    link(timer);
+    // Only a deadline earlier than the one the task sleeps for needs it awake
+    wake = s_wheel.sleeping && (s_wheel.sleep_forever || (int32_t)(timer->expires - s_wheel.sleep_until) < 0);
+    if (wake) {
+        s_wheel.sleeping = false;
+    }
+    portEXIT_CRITICAL(&s_wheel.lock);
+    if (wake) {
+        xTaskNotifyGive(s_wheel.task);
+    }
+}
+
+void timer_wheel_start_once(timer_wheel_timer_t *timer, uint32_t delay_ms)
+{
+    arm(timer, delay_ms, 0);
+}
+
+void timer_wheel_start_periodic(timer_wheel_timer_t *timer, uint32_t period_ms)
+{
+    arm(timer, period_ms, period_ms ? period_ms : CONFIG_KVA_TIMER_WHEEL_TICK_MS);
+}
+
+void timer_wheel_stop(timer_wheel_timer_t *timer)
+{
+    if (!timer) {
+        return;
+    }
+    portENTER_CRITICAL(&s_wheel.lock);
+    if (timer->pprev) {
+        unlink(timer);
+    }
+    portEXIT_CRITICAL(&s_wheel.lock);
+}
+
+bool timer_wheel_is_active(const timer_wheel_timer_t *timer)
+{
+    return timer && __atomic_load_n(&timer->pprev, __ATOMIC_RELAXED) != NULL;
+}
+
+void timer_wheel_get_stats(timer_wheel_stats_t *out)
+{
+    if (!out) {
+        return;
+    }
+    portENTER_CRITICAL(&s_wheel.lock);
+    *out = s_wheel.stats;
+    portEXIT_CRITICAL(&s_wheel.lock);
+}
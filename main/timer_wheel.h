@@ -0,0 +1,68 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "kva_config_defaults.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * One task for the firmware's housekeeping timers, in place of an esp_timer
+ * or FreeRTOS timer each. Timers sit in a hierarchical wheel of
+ * CONFIG_KVA_TIMER_WHEEL_TICK_MS ticks (four levels of 64 slots, about 46
+ * hours at 10 ms), so arming and stopping are O(1). The task sleeps until
+ * the earliest deadline instead of waking every tick, and every timer due
+ * in the same tick fires in the same wakeup.
+ *
+ * A timer's slack lets it fire up to that late: its deadline is rounded up
+ * to a multiple of the largest power of two ticks within the slack, so
+ * timers with similar slack share deadlines and wake the CPU together. It
+ * is meant for work that tolerates milliseconds of jitter; button debounce,
+ * sampling and anything with a hard deadline stay on esp_timer.
+ *
+ * Callbacks run on the timer_wheel task, one after another, and must not
+ * block for long.
+ */
+typedef struct timer_wheel_timer timer_wheel_timer_t;
+
+typedef void (*timer_wheel_cb_t)(void *arg);
+
+typedef struct {
+    timer_wheel_cb_t callback;
+    void *arg;
+    const char *name;                 // For logs only; not copied
+    uint32_t slack_ms;                // How late the callback may run, 0 = next tick after the deadline
+} timer_wheel_timer_config_t;
+
+typedef struct {
+    uint32_t armed;                   // Timers waiting now
+    uint32_t fired;
+    uint32_t wakeups;                 // Times the task woke; fired / wakeups is the coalescing
+} timer_wheel_stats_t;
+
+// Start the task; call once, before anything creates a timer
+esp_err_t timer_wheel_init(void);
+
+esp_err_t timer_wheel_create(const timer_wheel_timer_config_t *config, timer_wheel_timer_t **out_timer);
+
+// Stops the timer first. Not while its callback may be running on the wheel task
+void timer_wheel_delete(timer_wheel_timer_t *timer);
+
+// Arming an armed timer moves its deadline; callable from any task
+void timer_wheel_start_once(timer_wheel_timer_t *timer, uint32_t delay_ms);
+void timer_wheel_start_periodic(timer_wheel_timer_t *timer, uint32_t period_ms);
+
+// A callback already running still finishes
+void timer_wheel_stop(timer_wheel_timer_t *timer);
+
+bool timer_wheel_is_active(const timer_wheel_timer_t *timer);
+
+void timer_wheel_get_stats(timer_wheel_stats_t *out);
+
+#ifdef __cplusplus
+}
+#endif
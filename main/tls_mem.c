@@ -0,0 +1,74 @@
+#include "tls_mem.h"
+
+#include <string.h>
+
+#include "esp_heap_caps.h"
+#include "esp_memory_utils.h"
+#include "freertos/FreeRTOS.h"
+#include "kva_config_defaults.h"
+#include "sdkconfig.h"
+
+#if CONFIG_MBEDTLS_CUSTOM_MEM_ALLOC
+
+static tls_mem_stats_t s_stats;
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static void account(void *ptr, bool add)
+{
+    size_t bytes = heap_caps_get_allocated_size(ptr);
+    portENTER_CRITICAL(&s_lock);
+    if (esp_ptr_external_ram(ptr)) {
+        s_stats.psram_bytes = add ? s_stats.psram_bytes + bytes : s_stats.psram_bytes - bytes;
+        if (s_stats.psram_bytes > s_stats.psram_peak_bytes) {
+            s_stats.psram_peak_bytes = s_stats.psram_bytes;
+        }
+    } else {
+        s_stats.internal_bytes = add ? s_stats.internal_bytes + bytes : s_stats.internal_bytes - bytes;
+        if (s_stats.internal_bytes > s_stats.internal_peak_bytes) {
+            s_stats.internal_peak_bytes = s_stats.internal_bytes;
+        }
+    }
+    portEXIT_CRITICAL(&s_lock);
+}
+
+// Called by mbedTLS for every allocation, from whichever task runs the connection
+void *esp_mbedtls_mem_calloc(size_t n, size_t size)
+{
+    void *ptr = NULL;
+#if CONFIG_SPIRAM
+    if (n * size >= CONFIG_KVA_TLS_PSRAM_MIN_BYTES) {
+        ptr = heap_caps_calloc(n, size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    }
+#endif
+    if (!ptr) {
+        ptr = heap_caps_calloc(n, size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    }
+    if (ptr) {
+        account(ptr, true);
+    }
+    return ptr;
+}
+
+void esp_mbedtls_mem_free(void *ptr)
+{
+    if (ptr) {
+        account(ptr, false);
+        heap_caps_free(ptr);
+    }
+}
+
+void tls_mem_get(tls_mem_stats_t *out)
+{
+    portENTER_CRITICAL(&s_lock);
+    *out = s_stats;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+#else
+
+void tls_mem_get(tls_mem_stats_t *out)
+{
+    memset(out, 0, sizeof(*out));
+}
+
+#endif
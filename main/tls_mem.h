@@ -0,0 +1,31 @@
+#pragma once
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * mbedTLS heap, shared by every TLS client in the process (esp_http_client,
+ * esp_websocket_client, cspot and the AWS IoT wrapper alike). Built with
+ * CONFIG_MBEDTLS_CUSTOM_MEM_ALLOC, which routes mbedTLS through the
+ * esp_mbedtls_mem_calloc/free pair defined here; otherwise this only
+ * reports zeros.
+ *
+ * Record buffers, certificate chains and other blocks of
+ * CONFIG_KVA_TLS_PSRAM_MIN_BYTES or more go to PSRAM when there is any;
+ * the small, hot handshake and cipher state stays internal.
+ */
+typedef struct {
+    size_t internal_bytes;
+    size_t internal_peak_bytes;
+    size_t psram_bytes;
+    size_t psram_peak_bytes;
+} tls_mem_stats_t;
+
+void tls_mem_get(tls_mem_stats_t *out);
+
+#ifdef __cplusplus
+}
+#endif
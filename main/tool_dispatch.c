@@ -0,0 +1,213 @@
+#include "tool_dispatch.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "cJSON.h"
+#include "device_state.h"
+#include "esp_check.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "interaction_pool.h"
+#include "kva_config_defaults.h"
+
+static const char *TAG = "tool_dispatch";
+
+typedef enum {
+    TOOL_GROUP_NONE,                  // Reads state; runs on its own
+    TOOL_GROUP_LIGHTS,
+    TOOL_GROUP_AUDIO,
+    TOOL_GROUP_COUNT,
+} tool_group_t;
+
+// Phrase for a successful action, from its arguments; NULL when it has none
+typedef const char *(*tool_confirm_fn_t)(const cJSON *args);
+
+typedef struct {
+    const char *name;
+    tool_group_t group;
+    tool_confirm_fn_t confirm;        // NULL for calls whose result has to be read out
+} tool_spec_t;
+
+static const char *confirm_leds(const cJSON *args)
+{
+    const cJSON *enabled = cJSON_GetObjectItem(args, "enabled");
+    return cJSON_IsBool(enabled) ? (cJSON_IsTrue(enabled) ? "Lights on." : "Lights off.") : NULL;
+}
+
+static const char *confirm_led_color(const cJSON *args)
+{
+    (void)args;
+    return "Color changed.";
+}
+
+static const char *confirm_mute(const cJSON *args)
+{
+    const cJSON *muted = cJSON_GetObjectItem(args, "muted");
+    return cJSON_IsBool(muted) ? (cJSON_IsTrue(muted) ? "Muted." : "Sound's back on.") : NULL;
+}
+
+// The tools gemini_client declares; an unknown name is a group of its own without a phrase
+static const tool_spec_t TOOLS[] = {
+    {"get_device_state", TOOL_GROUP_NONE, NULL},
+    {"get_health", TOOL_GROUP_NONE, NULL},
+    {"get_temperature", TOOL_GROUP_NONE, NULL},
+    {"get_sensors", TOOL_GROUP_NONE, NULL},
+    {"set_leds", TOOL_GROUP_LIGHTS, confirm_leds},
+    {"set_led_color", TOOL_GROUP_LIGHTS, confirm_led_color},
+    {"set_audio_mute", TOOL_GROUP_AUDIO, confirm_mute},
+};
+
+typedef struct {
+    tool_dispatch_call_t *calls;
+    SemaphoreHandle_t done;
+    uint32_t remaining;               // Groups still running (atomic); the last one gives done
+} tool_batch_t;
+
+// One group: calls[index[0]], calls[index[1]], ... in that order
+typedef struct {
+    tool_batch_t *batch;
+    uint8_t count;
+    uint8_t index[TOOL_DISPATCH_MAX_CALLS];
+} tool_job_t;
+
+static interaction_pool_handle_t s_pool;
+
+static const tool_spec_t *find_tool(const char *name)
+{
+    for (size_t i = 0; i < sizeof(TOOLS) / sizeof(TOOLS[0]); ++i) {
+        if (strcmp(TOOLS[i].name, name) == 0) {
+            return &TOOLS[i];
+        }
+    }
+    return NULL;
+}
+
+static void run_group(const tool_job_t *job)
+{
+    for (uint8_t i = 0; i < job->count; ++i) {
+        tool_dispatch_call_t *call = &job->batch->calls[job->index[i]];
+        call->err = gemini_execute_function_call(call->name, call->args_json ? call->args_json : "{}",
+                                                 call->result, sizeof(call->result));
+    }
+}
+
+static void finish_group(tool_batch_t *batch)
+{
+    if (__atomic_sub_fetch(&batch->remaining, 1, __ATOMIC_ACQ_REL) == 0) {
+        xSemaphoreGive(batch->done);
+    }
+}
+
+static void tool_job(void *arg, void *ctx)
+{
+    (void)ctx;
+    tool_job_t *job = (tool_job_t *)arg;
+    run_group(job);
+    finish_group(job->batch);
+}
+
+esp_err_t tool_dispatch_init(void)
+{
+    if (s_pool || CONFIG_KVA_TOOL_WORKERS == 0) {
+        return ESP_OK;
+    }
+    // Refused jobs run on the caller, so the queue never has to hold a whole reply
+    const interaction_pool_config_t cfg = {
+        .run = tool_job,
+        .job_size = sizeof(tool_job_t),
+        .queue_depth = TOOL_DISPATCH_MAX_CALLS,
+        .workers = CONFIG_KVA_TOOL_WORKERS,
+        .placement = TASK_PLACEMENT_TOOL_WORKER,
+        .when_full = INTERACTION_POOL_REJECT,
+    };
+    return interaction_pool_create(&cfg, &s_pool);
+}
+
+void tool_dispatch_run(tool_dispatch_call_t *calls, size_t count)
+{
+    if (!calls || count == 0) {
+        return;
+    }
+    if (count > TOOL_DISPATCH_MAX_CALLS) {
+        ESP_LOGW(TAG, "%u function calls, running the first %d", (unsigned)count, TOOL_DISPATCH_MAX_CALLS);
+        count = TOOL_DISPATCH_MAX_CALLS;
+    }
+
+    tool_batch_t batch = {.calls = calls};
+    tool_job_t jobs[TOOL_DISPATCH_MAX_CALLS];
+    size_t job_count = 0;
+    int group_job[TOOL_GROUP_COUNT];
+    for (size_t g = 0; g < TOOL_GROUP_COUNT; ++g) {
+        group_job[g] = -1;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        const tool_spec_t *spec = find_tool(calls[i].name);
+        tool_group_t group = spec ? spec->group : TOOL_GROUP_NONE;
+        int j = group == TOOL_GROUP_NONE ? -1 : group_job[group];
+        if (j < 0) {
+            j = (int)job_count++;
+            jobs[j] = (tool_job_t){.batch = &batch};
+            if (group != TOOL_GROUP_NONE) {
+                group_job[group] = j;
+            }
+        }
+        jobs[j].index[jobs[j].count++] = (uint8_t)i;
+    }
+
+    // One group gains nothing from a worker
+    if (!s_pool || job_count == 1 || !(batch.done = xSemaphoreCreateBinary())) {
+        for (size_t j = 0; j < job_count; ++j) {
+            run_group(&jobs[j]);
+        }
+        return;
+    }
+    batch.remaining = (uint32_t)job_count;
+    // The first group stays here, so the caller works instead of only waiting
+    for (size_t j = 1; j < job_count; ++j) {
+        if (interaction_pool_submit(s_pool, &jobs[j]) != ESP_OK) {
+            run_group(&jobs[j]);
+            finish_group(&batch);
+        }
+    }
+    run_group(&jobs[0]);
+    finish_group(&batch);
+    xSemaphoreTake(batch.done, portMAX_DELAY);
+    vSemaphoreDelete(batch.done);
+    ESP_LOGI(TAG, "%u function calls in %u groups", (unsigned)count, (unsigned)job_count);
+}
+
+bool tool_dispatch_confirmation(const tool_dispatch_call_t *calls, size_t count, char *out, size_t out_len)
+{
+    if (!calls || count == 0 || !out || out_len == 0) {
+        return false;
+    }
+    if (count > TOOL_DISPATCH_MAX_CALLS) {
+        count = TOOL_DISPATCH_MAX_CALLS;
+    }
+    size_t len = 0;
+    out[0] = '\0';
+    for (size_t i = 0; i < count; ++i) {
+        const tool_spec_t *spec = find_tool(calls[i].name);
+        if (calls[i].err != ESP_OK || !spec || !spec->confirm) {
+            return false;
+        }
+        cJSON *args = cJSON_Parse(calls[i].args_json ? calls[i].args_json : "{}");
+        const char *phrase = spec->confirm(args);
+        cJSON_Delete(args);
+        if (!phrase) {
+            return false;
+        }
+        // A repeated phrase ("Lights off." twice) is said once
+        if (strstr(out, phrase)) {
+            continue;
+        }
+        int n = snprintf(out + len, out_len - len, "%s%s", len ? " " : "", phrase);
+        if (n < 0 || (size_t)n >= out_len - len) {
+            return false;
+        }
+        len += (size_t)n;
+    }
+    return len > 0;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Function calls taken from one model reply; the rest are ignored
+#define TOOL_DISPATCH_MAX_CALLS 8
+#define TOOL_DISPATCH_RESULT_MAX 512
+
+typedef struct {
+    const char *name;                 // Borrowed from the caller for the run
+    const char *args_json;
+    char result[TOOL_DISPATCH_RESULT_MAX];
+    esp_err_t err;
+} tool_dispatch_call_t;
+
+/**
+ * Runs the function calls of a model reply (gemini_execute_function_call())
+ * and, where it can, words the spoken confirmation itself so the reply
+ * needs no second model round trip.
+ *
+ * Calls are grouped by the device state they touch: calls in one group run
+ * in reply order, and the groups run at the same time on a small pool of
+ * workers (CONFIG_KVA_TOOL_WORKERS). Read-only calls are groups of their
+ * own. Without the workers, or with their queue full, a group runs on the
+ * calling task.
+ */
+esp_err_t tool_dispatch_init(void);
+
+// Run every call and return once all have finished; each call's err and result are filled in
+void tool_dispatch_run(tool_dispatch_call_t *calls, size_t count);
+
+/**
+ * A confirmation from fixed phrases ("Lights off. Muted."), which the TTS
+ * cache keeps after a couple of uses, if every call was an action that
+ * succeeded.
+ *
+ * @return false when a call failed or asked for data, which the model
+ *         has to put into words
+ */
+bool tool_dispatch_confirmation(const tool_dispatch_call_t *calls, size_t count, char *out, size_t out_len);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,408 @@
+#include "tts_cache.h"
+
+#include <string.h>
+
+#include "esp_check.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_partition.h"
+#include "esp_rom_crc.h"
+#include "flash_guard.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "interaction_cancel.h"
+#include "sound_bank.h"
+
+#define SLOT_MAGIC 0x3143544EU        // 'NTC1'
+#define SLOT_HEADER_BYTES 64
+#define SLOT_DATA_BYTES (TTS_CACHE_SLOT_BYTES - SLOT_HEADER_BYTES)
+#define SECTOR_BYTES 4096
+// Keys that missed once; the next miss of one of them is recorded
+#define ADMIT_HISTORY 16
+#define PLAY_POLL_MS 10
+
+// Slot layout: this header, then ADPCM data. The header is written last,
+// so a slot cut off by a reset fails its magic or CRC and reads as empty.
+typedef struct __attribute__((packed)) {
+    uint32_t magic;
+    uint32_t seq;                     // Write order across the partition
+    uint64_t key;
+    uint32_t frames;
+    uint32_t rate_hz;
+    uint32_t bytes;
+    uint32_t data_crc;
+    uint32_t header_crc;              // Of the fields above
+} slot_header_t;
+
+_Static_assert(sizeof(slot_header_t) <= SLOT_HEADER_BYTES, "tts cache slot header");
+
+typedef struct {
+    uint64_t key;
+    uint32_t frames;
+    uint32_t rate_hz;
+    uint32_t seq;
+    uint32_t last_used;               // s_clock at the last write or hit
+    uint8_t readers;                  // Plays in progress; the slot is not evicted under them
+    bool valid;
+    bool writing;
+} slot_t;
+
+struct tts_cache_recorder {
+    uint64_t key;
+    uint32_t rate_hz;
+    uint32_t frames;
+    size_t bytes;
+    bool failed;
+    int32_t index;                    // ADPCM step index carried between blocks
+    uint32_t block_frames;
+    int16_t block[SOUND_BANK_ADPCM_BLOCK_FRAMES];
+    uint8_t data[SLOT_DATA_BYTES];
+};
+
+static const char *TAG = "tts_cache";
+
+static const esp_partition_t *s_part;
+static const uint8_t *s_base;
+static esp_partition_mmap_handle_t s_mmap;
+static slot_t *s_slots;
+static size_t s_slot_count;
+static uint32_t s_clock;
+static uint32_t s_next_seq;
+static uint64_t s_missed[ADMIT_HISTORY];
+static size_t s_missed_next;
+static SemaphoreHandle_t s_lock;
+
+static uint32_t header_crc(const slot_header_t *h)
+{
+    return esp_rom_crc32_le(0, (const uint8_t *)h, offsetof(slot_header_t, header_crc));
+}
+
+static const uint8_t *slot_data(size_t slot)
+{
+    return s_base + slot * TTS_CACHE_SLOT_BYTES + SLOT_HEADER_BYTES;
+}
+
+static void load_slot(size_t slot)
+{
+    slot_header_t h;
+    memcpy(&h, s_base + slot * TTS_CACHE_SLOT_BYTES, sizeof(h));
+    if (h.magic != SLOT_MAGIC || h.header_crc != header_crc(&h) || h.frames == 0 || h.rate_hz == 0 ||
+        h.bytes > SLOT_DATA_BYTES || h.bytes < sound_bank_adpcm_block_bytes(h.frames, 1)) {
+        return;
+    }
+    if (esp_rom_crc32_le(0, slot_data(slot), h.bytes) != h.data_crc) {
+        ESP_LOGW(TAG, "Slot %u data CRC mismatch", (unsigned)slot);
+        return;
+    }
+    s_slots[slot] = (slot_t){
+        .key = h.key,
+        .frames = h.frames,
+        .rate_hz = h.rate_hz,
+        .seq = h.seq,
+        .last_used = h.seq,
+        .valid = true,
+    };
+    if (h.seq >= s_next_seq) {
+        s_next_seq = h.seq + 1;
+    }
+}
+
+esp_err_t tts_cache_init(void)
+{
+    if (s_base) {
+        return ESP_OK;
+    }
+    const esp_partition_t *part =
+        esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, TTS_CACHE_PARTITION_LABEL);
+    if (!part) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    size_t count = part->size / TTS_CACHE_SLOT_BYTES;
+    ESP_RETURN_ON_FALSE(count > 0, ESP_ERR_INVALID_SIZE, TAG, "partition smaller than one slot");
+
+    s_lock = xSemaphoreCreateMutex();
+    s_slots = heap_caps_calloc(count, sizeof(slot_t), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    const void *mapped = NULL;
+    esp_err_t err = s_lock && s_slots ? ESP_OK : ESP_ERR_NO_MEM;
+    if (err == ESP_OK) {
+        err = esp_partition_mmap(part, 0, count * TTS_CACHE_SLOT_BYTES, ESP_PARTITION_MMAP_DATA, &mapped, &s_mmap);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Init failed (%s)", esp_err_to_name(err));
+        if (s_lock) {
+            vSemaphoreDelete(s_lock);
+            s_lock = NULL;
+        }
+        heap_caps_free(s_slots);
+        s_slots = NULL;
+        return err;
+    }
+
+    s_part = part;
+    s_base = mapped;
+    s_slot_count = count;
+    size_t used = 0;
+    for (size_t i = 0; i < count; ++i) {
+        load_slot(i);
+        used += s_slots[i].valid;
+    }
+    s_clock = s_next_seq;
+    ESP_LOGI(TAG, "%u of %u slots cached in \"%s\"", (unsigned)used, (unsigned)count, TTS_CACHE_PARTITION_LABEL);
+    return ESP_OK;
+}
+
+uint64_t tts_cache_key(const char *text, const char *voice, const char *model)
+{
+    const char *parts[] = {text, voice, model};
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < sizeof(parts) / sizeof(parts[0]); ++i) {
+        // The terminator goes in too, so "ab"+"c" and "a"+"bc" differ
+        const char *p = parts[i] ? parts[i] : "";
+        do {
+            hash ^= (uint8_t)*p;
+            hash *= 0x100000001b3ULL;
+        } while (*p++);
+    }
+    return hash;
+}
+
+// Under s_lock
+static int find_slot(uint64_t key)
+{
+    for (size_t i = 0; i < s_slot_count; ++i) {
+        if (s_slots[i].valid && s_slots[i].key == key) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+bool tts_cache_contains(uint64_t key)
+{
+    if (!s_base) {
+        return false;
+    }
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    bool found = find_slot(key) >= 0;
+    xSemaphoreGive(s_lock);
+    return found;
+}
+
+esp_err_t tts_cache_play(uint64_t key, size_t *pcm_bytes)
+{
+    if (pcm_bytes) {
+        *pcm_bytes = 0;
+    }
+    if (!s_base) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    int slot = find_slot(key);
+    if (slot >= 0) {
+        s_slots[slot].last_used = ++s_clock;
+        s_slots[slot].readers++;
+    }
+    xSemaphoreGive(s_lock);
+    if (slot < 0) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    const sound_bank_clip_t clip = {
+        .data = slot_data(slot),
+        .frames = s_slots[slot].frames,
+        .rate_hz = s_slots[slot].rate_hz,
+        .channels = 1,
+        .codec = SOUND_BANK_CODEC_IMA_ADPCM,
+    };
+    esp_err_t err = sound_bank_play_clip(&clip, AUDIO_PLAYER_STREAM_VOICE);
+    // The feeder reads the slot until the last block is queued
+    while (err == ESP_OK && sound_bank_is_playing(AUDIO_PLAYER_STREAM_VOICE)) {
+        if (interaction_cancelled()) {
+            sound_bank_stop(AUDIO_PLAYER_STREAM_VOICE);
+            err = ESP_ERR_INVALID_STATE;
+            break;
+        }
+        vTaskDelay(pdMS_TO_TICKS(PLAY_POLL_MS));
+    }
+    if (err == ESP_OK && pcm_bytes) {
+        *pcm_bytes = (size_t)clip.frames * sizeof(int16_t);
+    }
+
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    s_slots[slot].readers--;
+    xSemaphoreGive(s_lock);
+    return err;
+}
+
+// Under s_lock. True if key had missed before; otherwise remembers it
+static bool admit(uint64_t key)
+{
+    for (size_t i = 0; i < ADMIT_HISTORY; ++i) {
+        if (s_missed[i] == key) {
+            s_missed[i] = 0;
+            return true;
+        }
+    }
+    s_missed[s_missed_next] = key;
+    s_missed_next = (s_missed_next + 1) % ADMIT_HISTORY;
+    return false;
+}
+
+tts_cache_recorder_t *tts_cache_record_begin(uint64_t key, bool force)
+{
+    if (!s_base) {
+        return NULL;
+    }
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    bool record = find_slot(key) < 0 && (force || admit(key));
+    xSemaphoreGive(s_lock);
+    if (!record) {
+        return NULL;
+    }
+    // A slot's worth of ADPCM; PSRAM where there is some
+    tts_cache_recorder_t *rec = heap_caps_malloc(sizeof(*rec), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!rec) {
+        rec = heap_caps_malloc(sizeof(*rec), MALLOC_CAP_8BIT);
+    }
+    if (!rec) {
+        ESP_LOGW(TAG, "No memory to record");
+        return NULL;
+    }
+    rec->key = key;
+    rec->rate_hz = 0;
+    rec->frames = 0;
+    rec->bytes = 0;
+    rec->failed = false;
+    rec->index = 0;
+    rec->block_frames = 0;
+    return rec;
+}
+
+static void encode_block(tts_cache_recorder_t *rec)
+{
+    size_t need = sound_bank_adpcm_block_bytes(rec->block_frames, 1);
+    if (rec->bytes + need > SLOT_DATA_BYTES) {
+        rec->failed = true;
+    } else {
+        rec->bytes += sound_bank_adpcm_encode_block(rec->block, rec->block_frames, &rec->index,
+                                                    rec->data + rec->bytes);
+        rec->frames += rec->block_frames;
+    }
+    rec->block_frames = 0;
+}
+
+void tts_cache_record_pcm(const int16_t *pcm, size_t frames, int sample_rate_hz, int num_channels, void *ctx)
+{
+    tts_cache_recorder_t *rec = ctx;
+    if (!rec || rec->failed) {
+        return;
+    }
+    if (num_channels != 1 || sample_rate_hz <= 0 || (rec->rate_hz && rec->rate_hz != (uint32_t)sample_rate_hz)) {
+        rec->failed = true;
+        return;
+    }
+    rec->rate_hz = (uint32_t)sample_rate_hz;
+    while (frames > 0 && !rec->failed) {
+        size_t take = SOUND_BANK_ADPCM_BLOCK_FRAMES - rec->block_frames;
+        if (take > frames) {
+            take = frames;
+        }
+        memcpy(rec->block + rec->block_frames, pcm, take * sizeof(int16_t));
+        rec->block_frames += take;
+        pcm += take;
+        frames -= take;
+        if (rec->block_frames == SOUND_BANK_ADPCM_BLOCK_FRAMES) {
+            encode_block(rec);
+        }
+    }
+}
+
+// Under s_lock: an empty slot, else the least recently used one nobody is playing
+static int pick_victim(void)
+{
+    int victim = -1;
+    for (size_t i = 0; i < s_slot_count; ++i) {
+        const slot_t *s = &s_slots[i];
+        if (s->readers || s->writing) {
+            continue;
+        }
+        if (!s->valid) {
+            return (int)i;
+        }
+        if (victim < 0 || s->last_used < s_slots[victim].last_used) {
+            victim = (int)i;
+        }
+    }
+    return victim;
+}
+
+static esp_err_t write_slot(size_t slot, const tts_cache_recorder_t *rec, uint32_t seq)
+{
+    size_t base = slot * TTS_CACHE_SLOT_BYTES;
+    size_t used = SLOT_HEADER_BYTES + rec->bytes;
+    // Recorded as the reply plays: sector steps, paced while the player is still draining it
+    ESP_RETURN_ON_ERROR(flash_guard_erase_range(s_part, base, (used + SECTOR_BYTES - 1) / SECTOR_BYTES * SECTOR_BYTES),
+                        TAG, "erase");
+    ESP_RETURN_ON_ERROR(flash_guard_write(s_part, base + SLOT_HEADER_BYTES, rec->data, rec->bytes), TAG,
+                        "write data");
+    slot_header_t h = {
+        .magic = SLOT_MAGIC,
+        .seq = seq,
+        .key = rec->key,
+        .frames = rec->frames,
+        .rate_hz = rec->rate_hz,
+        .bytes = (uint32_t)rec->bytes,
+        .data_crc = esp_rom_crc32_le(0, rec->data, rec->bytes),
+    };
+    h.header_crc = header_crc(&h);
+    return esp_partition_write(s_part, base, &h, sizeof(h));
+}
+
+esp_err_t tts_cache_record_end(tts_cache_recorder_t *rec, bool keep)
+{
+    if (!rec) {
+        return ESP_OK;
+    }
+    if (keep && !rec->failed && rec->block_frames) {
+        encode_block(rec);
+    }
+    if (!keep || rec->failed || rec->frames == 0) {
+        heap_caps_free(rec);
+        return keep ? ESP_ERR_INVALID_SIZE : ESP_OK;
+    }
+
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    int slot = find_slot(rec->key) < 0 ? pick_victim() : -1;
+    uint32_t seq = s_next_seq++;
+    if (slot >= 0) {
+        s_slots[slot].valid = false;
+        s_slots[slot].writing = true;
+    }
+    xSemaphoreGive(s_lock);
+    if (slot < 0) {
+        // Cached meanwhile by another reply, or every slot is playing
+        heap_caps_free(rec);
+        return ESP_OK;
+    }
+
+    // Erase and write without the lock so hits on other slots keep playing
+    esp_err_t err = write_slot(slot, rec, seq);
+
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    s_slots[slot] = (slot_t){
+        .key = rec->key,
+        .frames = rec->frames,
+        .rate_hz = rec->rate_hz,
+        .seq = seq,
+        .last_used = ++s_clock,
+        .valid = err == ESP_OK,
+    };
+    xSemaphoreGive(s_lock);
+    if (err == ESP_OK) {
+        ESP_LOGI(TAG, "Cached %u frames in slot %u (%u bytes)", (unsigned)rec->frames, (unsigned)slot,
+                 (unsigned)rec->bytes);
+    }
+    heap_caps_free(rec);
+    return err;
+}
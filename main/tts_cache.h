@@ -0,0 +1,76 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Synthesized speech kept in flash, addressed by a hash of text, voice and
+ * model, so a repeated reply ("Lights off.") plays without a TTS request.
+ *
+ * The "tts_cache" partition is split into TTS_CACHE_SLOT_BYTES slots of one
+ * rendering each, stored as mono IMA ADPCM in the sound bank's block layout
+ * and played by the sound bank feeder straight out of the mapped partition.
+ * The RAM index is rebuilt from the slot headers at boot. Recency is only
+ * tracked in RAM, so after a reboot eviction starts from the oldest write.
+ *
+ * A rendering is recorded the second time its key misses, so one-off LLM
+ * replies never cost a flash erase; phrases known to repeat can skip that
+ * check when recorded.
+ */
+
+#define TTS_CACHE_PARTITION_LABEL "tts_cache"
+#define TTS_CACHE_SLOT_BYTES (64 * 1024)
+
+typedef struct tts_cache_recorder tts_cache_recorder_t;
+
+/**
+ * Map the partition and index its slots. Call after sound_bank_init().
+ *
+ * @return ESP_ERR_NOT_FOUND without a "tts_cache" partition; every other
+ *         call is then a miss
+ */
+esp_err_t tts_cache_init(void);
+
+// FNV-1a over text, voice and model; NULL voice or model hash as ""
+uint64_t tts_cache_key(const char *text, const char *voice, const char *model);
+
+bool tts_cache_contains(uint64_t key);
+
+/**
+ * Play a cached rendering on the voice stream and wait until all of it is
+ * queued. The caller drains the stream as it would for streamed speech.
+ *
+ * @return ESP_ERR_NOT_FOUND on a miss; ESP_ERR_INVALID_STATE if the
+ *         interaction was cancelled while it played
+ */
+esp_err_t tts_cache_play(uint64_t key, size_t *pcm_bytes);
+
+/**
+ * Start recording a rendering of key. Without force, the key must have
+ * missed once before.
+ *
+ * @return NULL when nothing is to be recorded: no cache, already cached,
+ *         not admitted yet, or no memory
+ */
+tts_cache_recorder_t *tts_cache_record_begin(uint64_t key, bool force);
+
+// wav_stream_pcm_cb_t; ctx is the recorder. Anything but mono marks the recording unusable
+void tts_cache_record_pcm(const int16_t *pcm, size_t frames, int sample_rate_hz, int num_channels, void *ctx);
+
+/**
+ * Write the recording to the least recently used slot if keep is set and
+ * it fit, then free the recorder. Erases one sector at a time, so call it
+ * once the reply has played.
+ */
+esp_err_t tts_cache_record_end(tts_cache_recorder_t *rec, bool keep);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,110 @@
+#include "uplink_codec.h"
+
+#include <stdbool.h>
+#include <string.h>
+
+#include "esp_check.h"
+
+static const char *TAG = "uplink_codec";
+
+// ITU-T G.711 mu-law with the usual 0x84 bias and 14-bit clip
+static uint8_t linear_to_ulaw(int16_t sample)
+{
+    const int bias = 0x84;
+    const int clip = 32635;
+    int value = sample;
+    int sign = 0;
+    if (value < 0) {
+        sign = 0x80;
+        value = -value;
+    }
+    if (value > clip) {
+        value = clip;
+    }
+    value += bias;
+
+    int exponent = 7;
+    for (int mask = 0x4000; (value & mask) == 0 && exponent > 0; mask >>= 1) {
+        --exponent;
+    }
+    int mantissa = (value >> (exponent + 3)) & 0x0F;
+    return (uint8_t)~(sign | (exponent << 4) | mantissa);
+}
+
+static int16_t saturate16(int32_t v)
+{
+    if (v > INT16_MAX) {
+        return INT16_MAX;
+    }
+    if (v < INT16_MIN) {
+        return INT16_MIN;
+    }
+    return (int16_t)v;
+}
+
+esp_err_t uplink_codec_init(uplink_codec_encoder_t *enc, uplink_codec_id_t id, int in_rate_hz, int out_rate_hz)
+{
+    ESP_RETURN_ON_FALSE(enc && in_rate_hz > 0 && out_rate_hz > 0, ESP_ERR_INVALID_ARG, TAG, "bad args");
+    ESP_RETURN_ON_FALSE(id == UPLINK_CODEC_PCM16 || id == UPLINK_CODEC_MULAW, ESP_ERR_NOT_SUPPORTED, TAG,
+                        "codec %d", (int)id);
+    ESP_RETURN_ON_FALSE(in_rate_hz == out_rate_hz || in_rate_hz == 2 * out_rate_hz, ESP_ERR_NOT_SUPPORTED, TAG,
+                        "%d -> %d Hz", in_rate_hz, out_rate_hz);
+    memset(enc, 0, sizeof(*enc));
+    enc->id = id;
+    enc->decimation = in_rate_hz / out_rate_hz;
+    return ESP_OK;
+}
+
+size_t uplink_codec_max_encoded_bytes(const uplink_codec_encoder_t *enc, size_t sample_count)
+{
+    size_t out_samples = (sample_count + enc->decimation - 1) / enc->decimation;
+    return out_samples * (size_t)(uplink_codec_bits_per_sample(enc->id) / 8);
+}
+
+size_t uplink_codec_encode(uplink_codec_encoder_t *enc, const int16_t *pcm, size_t sample_count, uint8_t *out)
+{
+    uint8_t *w = out;
+    for (size_t i = 0; i < sample_count; ++i) {
+        int16_t sample = pcm[i];
+        if (enc->decimation == 2) {
+            // 7-tap half-band low-pass (-1 0 9 16 9 0 -1)/32, keep every other output
+            int16_t *h = enc->history;
+            bool emit = enc->phase;
+            int32_t acc = -h[0] + 9 * h[2] + 16 * h[3] + 9 * h[4] - sample;
+            memmove(h, h + 1, 5 * sizeof(h[0]));
+            h[5] = sample;
+            enc->phase = !enc->phase;
+            if (!emit) {
+                continue;
+            }
+            sample = saturate16(acc / 32);
+        }
+        if (enc->id == UPLINK_CODEC_MULAW) {
+            *w++ = linear_to_ulaw(sample);
+        } else {
+            *w++ = (uint8_t)(sample & 0xFF);
+            *w++ = (uint8_t)((uint16_t)sample >> 8);
+        }
+    }
+    return (size_t)(w - out);
+}
+
+int uplink_codec_bits_per_sample(uplink_codec_id_t id)
+{
+    return id == UPLINK_CODEC_MULAW ? 8 : 16;
+}
+
+uint16_t uplink_codec_wav_format_tag(uplink_codec_id_t id)
+{
+    return id == UPLINK_CODEC_MULAW ? 7 : 1;
+}
+
+const char *uplink_codec_google_encoding(uplink_codec_id_t id)
+{
+    return id == UPLINK_CODEC_MULAW ? "MULAW" : "LINEAR16";
+}
+
+const char *uplink_codec_openai_format(uplink_codec_id_t id)
+{
+    return id == UPLINK_CODEC_MULAW ? "g711_ulaw" : "pcm16";
+}
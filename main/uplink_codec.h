@@ -0,0 +1,60 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Wire formats for audio sent to cloud STT; values match CONFIG_KVA_UPLINK_CODEC
+typedef enum {
+    UPLINK_CODEC_PCM16 = 0,           // 16-bit little-endian PCM, 2 bytes/sample
+    UPLINK_CODEC_MULAW = 1,           // G.711 mu-law, 1 byte/sample
+} uplink_codec_id_t;
+
+/**
+ * Stateful encoder: optional 2:1 decimation followed by the codec.
+ * State carries across calls so a stream can be encoded chunk by chunk.
+ */
+typedef struct {
+    uplink_codec_id_t id;
+    int decimation;                   // 1 or 2
+    int16_t history[6];               // Half-band filter taps from the previous call
+    int phase;                        // Input samples since the last output, for decimation
+} uplink_codec_encoder_t;
+
+/**
+ * Prepare an encoder.
+ *
+ * @param in_rate_hz  rate of the PCM fed to uplink_codec_encode()
+ * @param out_rate_hz rate on the wire; equal to in_rate_hz or half of it
+ */
+esp_err_t uplink_codec_init(uplink_codec_encoder_t *enc, uplink_codec_id_t id, int in_rate_hz, int out_rate_hz);
+
+// Upper bound on bytes produced for sample_count input samples
+size_t uplink_codec_max_encoded_bytes(const uplink_codec_encoder_t *enc, size_t sample_count);
+
+/**
+ * Encode sample_count input samples into out.
+ *
+ * @return bytes written, at most uplink_codec_max_encoded_bytes()
+ */
+size_t uplink_codec_encode(uplink_codec_encoder_t *enc, const int16_t *pcm, size_t sample_count, uint8_t *out);
+
+int uplink_codec_bits_per_sample(uplink_codec_id_t id);
+
+// WAVE_FORMAT_* tag for the fmt chunk (1 = PCM, 7 = mu-law)
+uint16_t uplink_codec_wav_format_tag(uplink_codec_id_t id);
+
+// Google Speech-to-Text RecognitionConfig.encoding
+const char *uplink_codec_google_encoding(uplink_codec_id_t id);
+
+// OpenAI Realtime session input_audio_format
+const char *uplink_codec_openai_format(uplink_codec_id_t id);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,120 @@
+#include "uplink_link.h"
+
+#include <string.h>
+
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_wifi.h"
+
+static const char *TAG = "uplink_link";
+
+// Smoothing of the send ratio per message
+#define SEND_RATIO_ALPHA 0.2f
+// Sends taking this share of the audio's own duration mark a fair / poor link
+#define SEND_RATIO_FAIR 0.25f
+#define SEND_RATIO_POOR 0.6f
+#define RSSI_INTERVAL_US (2 * 1000 * 1000)
+
+void uplink_link_init(uplink_link_t *link, const char *name, size_t queue_depth)
+{
+    memset(link, 0, sizeof(*link));
+    link->name = name;
+    link->queue_depth = queue_depth;
+}
+
+void uplink_link_note_send(uplink_link_t *link, uint32_t audio_ms, int64_t send_us, bool ok)
+{
+    if (!ok) {
+        link->failures++;
+        return;
+    }
+    link->failures = 0;
+    if (audio_ms > 0) {
+        float ratio = (float)send_us / 1000.0f / (float)audio_ms;
+        link->send_ratio += SEND_RATIO_ALPHA * (ratio - link->send_ratio);
+    }
+}
+
+// Where conditions put the link right now
+static uplink_link_level_t link_target(const uplink_link_t *link, size_t queued, bool growing)
+{
+    bool rssi = link->rssi != 0;
+    // A queue emptying after a slow connect is not the link's doing; one filling up is
+    if (link->send_ratio > SEND_RATIO_POOR || link->failures >= 2 ||
+        (growing && queued * 2 >= link->queue_depth) || (rssi && link->rssi < CONFIG_KVA_UPLINK_RSSI_POOR)) {
+        return UPLINK_LINK_POOR;
+    }
+    if (link->send_ratio > SEND_RATIO_FAIR || link->failures >= 1 ||
+        (growing && queued * 4 >= link->queue_depth) || (rssi && link->rssi < CONFIG_KVA_UPLINK_RSSI_FAIR)) {
+        return UPLINK_LINK_FAIR;
+    }
+    return UPLINK_LINK_GOOD;
+}
+
+uplink_link_level_t uplink_link_update(uplink_link_t *link, size_t queued)
+{
+#if !CONFIG_KVA_UPLINK_ADAPTIVE
+    (void)queued;
+    return UPLINK_LINK_FAIR;
+#else
+    int64_t now = esp_timer_get_time();
+    if (link->rssi_at_us == 0 || now - link->rssi_at_us >= RSSI_INTERVAL_US) {
+        wifi_ap_record_t ap;
+        link->rssi = esp_wifi_sta_get_ap_info(&ap) == ESP_OK ? ap.rssi : 0;
+        link->rssi_at_us = now;
+    }
+    uplink_link_level_t target = link_target(link, queued, queued > link->last_queued);
+    link->last_queued = queued;
+
+    uplink_link_level_t level = link->level;
+    if (target > level) {
+        level = target;
+        link->better_since_us = 0;
+    } else if (target < level) {
+        if (link->better_since_us == 0) {
+            link->better_since_us = now;
+        } else if (now - link->better_since_us >= (int64_t)CONFIG_KVA_UPLINK_RECOVER_MS * 1000) {
+            level = (uplink_link_level_t)(level - 1);
+            link->better_since_us = level > target ? now : 0;
+        }
+    } else {
+        link->better_since_us = 0;
+    }
+    if (level != link->level) {
+        ESP_LOGI(TAG, "%s link %s -> %s (sends at %.0f%% of real time, %u queued, RSSI %d)", link->name,
+                 uplink_link_level_name(link->level), uplink_link_level_name(level), link->send_ratio * 100.0f,
+                 (unsigned)queued, link->rssi);
+        link->level = level;
+    }
+    return level;
+#endif
+}
+
+size_t uplink_link_batch(const uplink_link_t *link, size_t queued)
+{
+#if !CONFIG_KVA_UPLINK_ADAPTIVE
+    (void)link;
+    (void)queued;
+    return 1;
+#else
+    size_t batch = link->level == UPLINK_LINK_GOOD ? CONFIG_KVA_UPLINK_GOOD_BATCH : 1;
+    // The chunk in hand plus those behind it
+    if (queued + 1 > batch) {
+        batch = queued + 1;
+    }
+    return batch > CONFIG_KVA_UPLINK_BATCH_MAX ? CONFIG_KVA_UPLINK_BATCH_MAX : batch;
+#endif
+}
+
+const char *uplink_link_level_name(uplink_link_level_t level)
+{
+    switch (level) {
+    case UPLINK_LINK_GOOD:
+        return "good";
+    case UPLINK_LINK_FAIR:
+        return "fair";
+    case UPLINK_LINK_POOR:
+        return "poor";
+    }
+    return "?";
+}
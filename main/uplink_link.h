@@ -0,0 +1,67 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "kva_config_defaults.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    UPLINK_LINK_GOOD = 0,             // Full-rate audio, CONFIG_KVA_UPLINK_GOOD_BATCH chunks per message
+    UPLINK_LINK_FAIR,                 // Full-rate audio, one chunk per message unless behind
+    UPLINK_LINK_POOR,                 // The uplink's lower-rate format
+} uplink_link_level_t;
+
+/**
+ * Link quality of one realtime audio uplink, kept by its send task: how
+ * long each WebSocket send takes against the audio it carries (the socket
+ * blocks once the TCP window is full, so this is the backpressure), how
+ * many chunks wait in the queue behind it, failed sends, and the station's
+ * RSSI. The level drops as soon as any of them crosses its mark and climbs
+ * one step once conditions have stayed better for
+ * CONFIG_KVA_UPLINK_RECOVER_MS, so the wire format does not flap.
+ *
+ * The uplink sizes its messages with uplink_link_batch() and switches to
+ * its lower-rate format at UPLINK_LINK_POOR, which a backing-up queue
+ * reaches while it is still half empty.
+ */
+typedef struct {
+    const char *name;
+    size_t queue_depth;
+    size_t last_queued;               // At the previous update; a rising count is a backlog building
+    float send_ratio;                 // Smoothed send time over the audio time sent
+    int8_t rssi;                      // Last sample, 0 before the first
+    int64_t rssi_at_us;
+    uint32_t failures;                // Consecutive failed sends
+    uplink_link_level_t level;
+    int64_t better_since_us;          // Conditions have been above level since then; 0 when not
+} uplink_link_t;
+
+void uplink_link_init(uplink_link_t *link, const char *name, size_t queue_depth);
+
+// One message sent (or not): audio_ms of audio in send_us
+void uplink_link_note_send(uplink_link_t *link, uint32_t audio_ms, int64_t send_us, bool ok);
+
+/**
+ * Re-evaluate before a message; samples RSSI at most every couple of seconds.
+ *
+ * @param queued chunks waiting in the uplink queue
+ */
+uplink_link_level_t uplink_link_update(uplink_link_t *link, size_t queued);
+
+/**
+ * Chunks to put in the next message: the good-link batch, or whatever has
+ * queued up (capped at CONFIG_KVA_UPLINK_BATCH_MAX) so a slow link catches
+ * up with fewer, larger sends.
+ */
+size_t uplink_link_batch(const uplink_link_t *link, size_t queued);
+
+const char *uplink_link_level_name(uplink_link_level_t level);
+
+#ifdef __cplusplus
+}
+#endif
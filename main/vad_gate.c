@@ -0,0 +1,146 @@
+#include "vad_gate.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "esp_check.h"
+#include "esp_heap_caps.h"
+
+static const char *TAG = "vad_gate";
+
+// Noise floor: falls to a quieter frame at once, rises ~1/64 per silent frame
+#define FLOOR_RISE 0.015625f
+
+esp_err_t vad_gate_init(vad_gate_t *gate, const vad_gate_config_t *cfg)
+{
+    ESP_RETURN_ON_FALSE(gate && cfg && cfg->sample_rate_hz > 0, ESP_ERR_INVALID_ARG, TAG, "bad args");
+    memset(gate, 0, sizeof(*gate));
+    gate->cfg = *cfg;
+    gate->ring_samples = (size_t)cfg->sample_rate_hz * cfg->preroll_ms / 1000;
+    if (gate->ring_samples) {
+        gate->ring = heap_caps_malloc(gate->ring_samples * sizeof(int16_t), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        if (!gate->ring) {
+            gate->ring = malloc(gate->ring_samples * sizeof(int16_t));
+        }
+        ESP_RETURN_ON_FALSE(gate->ring, ESP_ERR_NO_MEM, TAG, "pre-roll alloc");
+    }
+    gate->noise_floor = VAD_GATE_MIN_ENERGY;
+    return ESP_OK;
+}
+
+void vad_gate_deinit(vad_gate_t *gate)
+{
+    if (gate) {
+        heap_caps_free(gate->ring);
+        memset(gate, 0, sizeof(*gate));
+    }
+}
+
+bool vad_gate_classify(vad_gate_t *gate, const int16_t *samples, size_t count, int afe_vote)
+{
+    float energy = 0.0f;
+    for (size_t i = 0; i < count; ++i) {
+        int32_t v = samples[i];
+        energy += (float)(v >= 0 ? v : -v);
+    }
+    energy = count ? energy / (float)count : 0.0f;
+    gate->last_energy = energy;
+
+    float threshold = gate->noise_floor * VAD_GATE_FLOOR_RATIO;
+    if (threshold < VAD_GATE_MIN_ENERGY) {
+        threshold = VAD_GATE_MIN_ENERGY;
+    }
+    bool loud = energy > threshold;
+    bool speech = afe_vote < 0 ? loud : (afe_vote > 0 && loud);
+
+    if (energy < gate->noise_floor) {
+        gate->noise_floor = energy;
+    } else if (!speech) {
+        gate->noise_floor += (energy - gate->noise_floor) * FLOOR_RISE;
+    }
+    return speech;
+}
+
+static void ring_push(vad_gate_t *gate, const int16_t *samples, size_t count)
+{
+    if (!gate->ring_samples) {
+        return;
+    }
+    if (count > gate->ring_samples) {
+        samples += count - gate->ring_samples;
+        gate->ring_head += count - gate->ring_samples;
+        count = gate->ring_samples;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        gate->ring[(gate->ring_head + i) % gate->ring_samples] = samples[i];
+    }
+    gate->ring_head += count;
+    if (gate->ring_head - gate->ring_start > gate->ring_samples) {
+        gate->ring_start = gate->ring_head - gate->ring_samples;
+    }
+}
+
+static uint32_t frame_ms(const vad_gate_t *gate, size_t count)
+{
+    return (uint32_t)(count * 1000 / (size_t)gate->cfg.sample_rate_hz);
+}
+
+vad_gate_event_t vad_gate_process(vad_gate_t *gate, const int16_t *samples, size_t count, bool speech)
+{
+    uint32_t ms = frame_ms(gate, count);
+    if (!gate->in_speech) {
+        ring_push(gate, samples, count);
+        gate->speech_run_ms = speech ? gate->speech_run_ms + ms : 0;
+        if (gate->speech_run_ms < gate->cfg.onset_ms || (!speech && gate->cfg.onset_ms == 0)) {
+            return VAD_GATE_SILENCE;
+        }
+        gate->in_speech = true;
+        gate->silence_run_ms = 0;
+        gate->utterance_ms = (uint32_t)((gate->ring_head - gate->ring_start) * 1000 / (size_t)gate->cfg.sample_rate_hz);
+        return VAD_GATE_ONSET;
+    }
+
+    gate->utterance_ms += ms;
+    gate->silence_run_ms = speech ? 0 : gate->silence_run_ms + ms;
+    bool too_long = gate->cfg.max_utterance_ms && gate->utterance_ms > gate->cfg.max_utterance_ms;
+    bool done = !speech && gate->cfg.end_early && gate->silence_run_ms < gate->cfg.hangover_ms &&
+                gate->cfg.end_early(gate->silence_run_ms, gate->cfg.end_early_ctx);
+    if (gate->silence_run_ms >= gate->cfg.hangover_ms || too_long || done) {
+        vad_gate_reset(gate);
+        return VAD_GATE_END;
+    }
+    return VAD_GATE_SPEECH;
+}
+
+size_t vad_gate_drain_preroll(vad_gate_t *gate, vad_gate_sink_t sink, void *ctx)
+{
+    size_t total = gate->ring_head - gate->ring_start;
+    if (total == 0) {
+        return 0;
+    }
+    size_t start = gate->ring_start % gate->ring_samples;
+    size_t first = total;
+    if (first > gate->ring_samples - start) {
+        first = gate->ring_samples - start;
+    }
+    sink(&gate->ring[start], first, ctx);
+    if (total > first) {
+        sink(gate->ring, total - first, ctx);
+    }
+    gate->ring_start = gate->ring_head;
+    return total;
+}
+
+void vad_gate_reset(vad_gate_t *gate)
+{
+    gate->in_speech = false;
+    gate->speech_run_ms = 0;
+    gate->silence_run_ms = 0;
+    gate->utterance_ms = 0;
+    gate->ring_start = gate->ring_head;
+}
+
+bool vad_gate_in_speech(const vad_gate_t *gate)
+{
+    return gate->in_speech;
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Audio kept from before onset so the first phoneme survives detection
+#ifndef VAD_GATE_PREROLL_MS
+#define VAD_GATE_PREROLL_MS 300
+#endif
+
+// Speech must persist this long before an utterance starts (rejects clicks)
+#ifndef VAD_GATE_ONSET_MS
+#define VAD_GATE_ONSET_MS 60
+#endif
+
+// Silence this long ends the utterance
+#ifndef VAD_GATE_HANGOVER_MS
+#define VAD_GATE_HANGOVER_MS 600
+#endif
+
+// Frame energy must exceed the tracked noise floor by this factor
+#ifndef VAD_GATE_FLOOR_RATIO
+#define VAD_GATE_FLOOR_RATIO 2.0f
+#endif
+
+// Mean absolute level below which a frame is never speech
+#ifndef VAD_GATE_MIN_ENERGY
+#define VAD_GATE_MIN_ENERGY 60.0f
+#endif
+
+// Asked at each silent frame of a pause; true takes the pause as the end of the turn
+typedef bool (*vad_gate_end_early_t)(uint32_t silence_ms, void *ctx);
+
+// Fill from the VAD_GATE_* defaults above unless a caller needs otherwise
+typedef struct {
+    int sample_rate_hz;               // Of the mono samples passed in
+    uint32_t preroll_ms;
+    uint32_t onset_ms;
+    uint32_t hangover_ms;
+    uint32_t max_utterance_ms;        // Force an end after this long; 0 for no limit
+    vad_gate_end_early_t end_early;   // Ends a pause before hangover_ms; NULL always waits it out
+    void *end_early_ctx;
+} vad_gate_config_t;
+
+typedef enum {
+    VAD_GATE_SILENCE = 0,             // Outside an utterance; the frame went to the pre-roll
+    VAD_GATE_ONSET,                   // Utterance started; the pre-roll (this frame included) is ready
+    VAD_GATE_SPEECH,                  // Inside an utterance, hangover included; pass the frame on
+    VAD_GATE_END,                     // Utterance over; this frame is not part of it
+} vad_gate_event_t;
+
+/**
+ * Utterance segmentation on top of per-frame VAD votes.
+ *
+ * Each frame is classified from the AFE's (WebRTC) VAD vote and its energy
+ * against an adaptive noise floor. A state machine then turns the votes into
+ * utterances: a run of onset_ms of speech opens one, hangover_ms of silence
+ * (or max_utterance_ms) closes it, or a shorter pause when end_early says
+ * the turn is complete. Frames outside an utterance go to a ring, so at
+ * onset the caller gets the last preroll_ms of audio and the start of the
+ * first word is not clipped.
+ */
+typedef struct {
+    vad_gate_config_t cfg;
+    int16_t *ring;                    // Pre-roll, mono
+    size_t ring_samples;
+    size_t ring_head;                 // Samples ever written
+    size_t ring_start;                // First sample of the current pre-roll
+    bool in_speech;
+    uint32_t speech_run_ms;
+    uint32_t silence_run_ms;
+    uint32_t utterance_ms;
+    float noise_floor;
+    float last_energy;
+} vad_gate_t;
+
+esp_err_t vad_gate_init(vad_gate_t *gate, const vad_gate_config_t *cfg);
+void vad_gate_deinit(vad_gate_t *gate);
+
+/**
+ * Vote on one frame.
+ *
+ * @param afe_vote 1 speech, 0 silence, -1 when no AFE VAD is running
+ * @return true for speech; also updates the noise floor
+ */
+bool vad_gate_classify(vad_gate_t *gate, const int16_t *samples, size_t count, int afe_vote);
+
+/**
+ * Advance the state machine by one frame.
+ */
+vad_gate_event_t vad_gate_process(vad_gate_t *gate, const int16_t *samples, size_t count, bool speech);
+
+typedef void (*vad_gate_sink_t)(const int16_t *samples, size_t count, void *ctx);
+
+/**
+ * Hand the pre-roll to sink in order (at most two calls) and empty it.
+ * Call on VAD_GATE_ONSET.
+ *
+ * @return samples delivered
+ */
+size_t vad_gate_drain_preroll(vad_gate_t *gate, vad_gate_sink_t sink, void *ctx);
+
+// Force the gate back to silence, dropping any pre-roll
+void vad_gate_reset(vad_gate_t *gate);
+
+bool vad_gate_in_speech(const vad_gate_t *gate);
+
+#ifdef __cplusplus
+}
+#endif
@@ -4,15 +4,58 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "audio_graph.h"
+#include "audio_meter.h"
+#include "breath_monitor.h"
+#if CONFIG_KVA_DOA_ENABLE
+#include "audio_doa.h"
+#endif
+#if CONFIG_KVA_TURN_PREDICTOR
+#include "model_loader.h"
+#include "turn_predictor.h"
+#endif
 #include "audio_player.h"
+#include "batch_stt.h"
+#include "conversation_memory.h"
+#include "cpu_profiler.h"
+#include "deferred_log.h"
+#include "event_bus.h"
+#include "feature_flags.h"
+#include "interaction_arena.h"
+#include "interaction_cancel.h"
+#include "interaction_pool.h"
+#include "interaction_trace.h"
+#include "local_commands.h"
+#include "mem_tags.h"
+#include "openai_client.h"
+#include "power_profile.h"
+#include "provider_router.h"
+#include "radio_coex.h"
+#include "serial_link.h"
+#include "speech_pipeline.h"
+#include "sr_models.h"
+#include "task_placement.h"
+#include "tts_cache.h"
+#include "uplink_codec.h"
+#include "vad_gate.h"
+#include "wake_arbiter.h"
+#include "wake_capture.h"
+#include "wav_stream_player.h"
 #include "esp_check.h"
+#include "esp_heap_caps.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/queue.h"
+#include "freertos/semphr.h"
 #include "freertos/task.h"
 #ifdef GEMINI_ENABLED
 #include "gemini_client.h"
 #include "device_state.h"
+#include "cJSON.h"
+#include "h2_transport.h"
+#include "https_pool.h"
+#include "tool_dispatch.h"
 #endif
 
 #ifdef GEMINI_ENABLED
@@ -21,9 +64,6 @@
 #define MAX_TRANSCRIPT_CHARS 512
 #endif
 
-// Forward declaration for microphone LED update
-extern void update_mic_leds(float mic1_level, float mic2_level, float mic3_level);
-
 #if CONFIG_KORVO_FARFIELD_WAKE_WORD_ENABLE
 #include "esp_afe_sr_iface.h"
 #include "esp_afe_sr_models.h"
@@ -33,12 +73,6 @@ extern void update_mic_leds(float mic1_level, float mic2_level, float mic3_level
 #include "model_path.h"
 #endif
 
-// External LED control functions from main
-extern void audio_playback_led_start(void);
-extern void audio_playback_led_stop(void);
-extern void lights_on(void);
-extern void lights_off(void);
-
 typedef enum {
     VOICE_PIPELINE_EVENT_WAKE = 1,
     VOICE_PIPELINE_EVENT_BUTTON = 2,
@@ -49,87 +83,725 @@ typedef struct {
     int button_id;
 } voice_pipeline_event_msg_t;
 
+typedef struct {
+    intent_router_decision_t decision;
+    const char *phrase;               // Static grammar string
+} local_command_msg_t;
+
+#if CONFIG_KORVO_FARFIELD_WAKE_WORD_ENABLE
+// Streaming AFE stage. Every buffer is sized from the AFE feed chunk at
+// voice_pipeline_create() time; the audio graph assembles exactly one feed
+// of capture per block, so nothing is accumulated or shifted here.
+// With a reference channel, mics are captured into mic_buffer and
+// interleaved with the playback loopback into feed_buffer.
+typedef struct {
+    int16_t *feed_buffer;       // One feed: chunksize x channels interleaved samples
+    size_t feed_samples;
+    int16_t *mic_buffer;        // Stereo capture for one feed; aliases feed_buffer without a reference
+    size_t mic_samples;
+    uint32_t feed_pos;          // Capture ring index of the feed's first sample
+    int16_t *ref_buffer;        // Loopback for one feed, NULL without a reference channel
+    int chunksize;
+    int channels;
+    int16_t *speech_buffer;     // Speech accumulated for Gemini batch STT
+    size_t speech_samples;
+    size_t speech_capacity;
+    bool speech_capturing;      // The current utterance goes to speech_buffer
+    volatile bool speech_held;  // A batch STT job owns speech_buffer until it is transcribed
+    bool afe_vad;               // The AFE runs its own VAD; its vote gates the energy check
+    vad_gate_t vad;             // Utterance segmentation and pre-roll on the AFE output
+} afe_stage_t;
+#endif
+
 struct voice_pipeline {
     voice_pipeline_config_t cfg;
     QueueHandle_t events;
     TaskHandle_t task;
-    int16_t *capture_buffer;
-    size_t capture_samples;
-    uint8_t *tts_buffer;
-    size_t tts_buffer_bytes;
+    vad_gate_t *turn_vad;             // Segments wake and follow-up turns; NULL when streaming continuously
+    wav_stream_player_t *tts_player;  // Streams TTS audio to the codec as it downloads
     voice_pipeline_wake_callback_t wake_callback;
     void *wake_callback_ctx;
 #if CONFIG_KORVO_FARFIELD_WAKE_WORD_ENABLE
     const esp_afe_sr_iface_t *afe_handle;
     esp_afe_sr_data_t *afe_data;
-    int16_t *afe_feed_buffer;
-    int afe_feed_chunksize;
-    int afe_feed_channels;
+    afe_stage_t afe_stage;
     bool vad_active;  // VAD state from AFE
     bool vad_was_active;  // Previous VAD state (for edge detection)
-    int16_t *afe_playback_ref;  // Playback reference for AEC
-    size_t afe_playback_ref_size;
     TickType_t wakenet_cooldown_until;  // Cooldown after wake word detection
     const char *wakenet_model_name;   // WakeNet model name
-    // Gemini batch STT audio accumulation
-    int16_t *gemini_audio_buffer;  // Buffer for accumulating audio during speech
-    size_t gemini_audio_samples;   // Current samples in buffer
-    size_t gemini_audio_capacity;  // Maximum capacity
+    local_commands_t *commands;       // MultiNet grammar on the AFE output, NULL when disabled
+    QueueHandle_t command_queue;      // local_command_msg_t, recognised in the AFE loop
+    TaskHandle_t command_task;        // Runs them off the AFE core
+    volatile bool afe_low_cost;       // Asked for by voice_pipeline_set_afe_low_cost(); a wake word clears it
+    bool afe_low_cost_applied;        // The low-cost profile is in effect; AFE node only
+    bool afe_se_ns_off;               // It is, by SE and NS switched off in the full instance
+    // The profile not in effect, built by afe_standby_task; swapped with the
+    // active afe_handle, afe_data and the stage's feed buffer and channels
+    const esp_afe_sr_iface_t *afe_standby_handle;
+    esp_afe_sr_data_t *afe_standby_data;
+    int16_t *afe_standby_feed;
+    int afe_standby_channels;
+    bool afe_standby_ready;           // Set once by the builder; the standby fields are the AFE node's from then on
+    uint32_t afe_warmup;              // Chunks still to feed the standby before the swap
+    TickType_t afe_last_speech;
+    uint32_t afe_budget_us;           // One feed's worth of audio, for the CPU profiler
+#if CONFIG_KVA_DOA_ENABLE
+    audio_doa_t *doa;                 // Talker direction over the mic pair, NULL when it failed to start
+#endif
+#if CONFIG_KVA_TURN_PREDICTOR
+    turn_predictor_t *turns;          // Ends the AFE gate's utterances early, NULL when it failed to start
+    const model_loader_model_t *turn_model;  // Its model, NULL for the prosody weights
+#endif
 #endif
+    bool utterance_local;             // The current utterance was a local command; the cloud skips it
+    intent_router_stream_t partial_route;  // Intent scan over the current turn's partial transcripts
+    int16_t *stream_frame;  // Raw frame for the streaming path when the AFE is not running
+    bool streaming;                   // Realtime streaming runs as an audio_graph node instead of the task
 #ifdef GEMINI_ENABLED
-    gemini_realtime_handle_t realtime_handle;
+    gemini_realtime_handle_t realtime_handle;  // Opened at speech onset, closed when idle
+    openai_realtime_handle_t speech_handle;    // Takes realtime_handle's place with cfg.openai_speech
+    volatile bool speech_replying;             // Reply audio from speech_handle is streaming
+    interaction_token_t speech_token;          // Cancel token of that reply
+    interaction_pool_handle_t replies;         // Workers for STT/LLM/TTS replies, made by voice_pipeline_start()
+    bool live_available;                // Cleared when Live fails to start; batch STT takes over
+    TickType_t live_last_voice;         // Last speech or wake word seen by the Live session
+    TaskHandle_t session_task;          // Prewarms cloud connections on wake, sweeps idle ones
 #endif
 };
 
 static const char *TAG = "voice_pipeline";
-static const size_t VOICE_PIPELINE_TTS_BUFFER_BYTES = 96 * 1024;
+// Playback returns once the last samples are queued; the drain waits until
+// they have left the DAC, so listening resumes as the speaker goes quiet
+#define VOICE_PIPELINE_DRAIN_TIMEOUT_MS 5000
+// Two mics plus the speaker loopback; the AFE's AEC cancels the playback it hears
+#define VOICE_PIPELINE_AFE_INPUT_FORMAT "MMR"
+// The low-cost profile: the first mic and the loopback
+#define VOICE_PIPELINE_AFE_LOW_COST_FORMAT "MR"
+#define VOICE_PIPELINE_MIC_CHANNELS 2
+// The reference is fed this far ahead of the measured echo time so DMA timing
+// error never puts it behind the mic; the AEC's adaptive filter absorbs the lead
+#define VOICE_PIPELINE_AEC_REF_LEAD_MS 4
+#define VOICE_PIPELINE_STREAM_FRAME_SAMPLES 512
+#define VOICE_PIPELINE_SPEECH_MAX_SECONDS 5
+// A Live session with no speech for this long is closed; the next onset reopens it
+#define VOICE_PIPELINE_LIVE_IDLE_MS 30000
+// Mic frames the wake and follow-up turns run their VAD on
+#define VOICE_PIPELINE_TURN_FRAME_SAMPLES 320
+// Wait for a turn's final transcript once its audio has ended
+#define VOICE_PIPELINE_TURN_FINAL_TIMEOUT_MS 5000
+// How often the session task closes pooled HTTPS connections past their idle timeout
+#define VOICE_PIPELINE_SESSION_SWEEP_MS 5000
+// Partials longer than this are sentences, not commands, and wait for the LLM
+#define VOICE_PIPELINE_EARLY_INTENT_MAX_WORDS 6
+
+#if CONFIG_KORVO_FARFIELD_WAKE_WORD_ENABLE
+// Size every streaming buffer from the AFE's feed geometry, once.
+// chunksize/channels must already be set.
+static esp_err_t afe_stage_alloc(afe_stage_t *stage, int sample_rate_hz)
+{
+    stage->feed_samples = (size_t)stage->chunksize * (size_t)stage->channels;
+    stage->feed_buffer = MEM_TAG_CAPS_MALLOC(MEM_TAG_VOICE_PIPELINE, stage->feed_samples * sizeof(int16_t),
+                                             MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    bool with_ref = stage->channels == VOICE_PIPELINE_MIC_CHANNELS + 1;
+    stage->mic_samples = (size_t)stage->chunksize * VOICE_PIPELINE_MIC_CHANNELS;
+    stage->mic_buffer = stage->feed_buffer;
+    stage->ref_buffer = NULL;
+    if (with_ref) {
+        stage->mic_buffer = MEM_TAG_CAPS_MALLOC(MEM_TAG_VOICE_PIPELINE, stage->mic_samples * sizeof(int16_t),
+                                                MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+        stage->ref_buffer = MEM_TAG_CAPS_MALLOC(MEM_TAG_VOICE_PIPELINE, (size_t)stage->chunksize * sizeof(int16_t),
+                                                MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    } else {
+        stage->mic_samples = stage->feed_samples;
+    }
+    // Several seconds of speech: keep it out of internal RAM when PSRAM exists
+    stage->speech_capacity = (size_t)sample_rate_hz * VOICE_PIPELINE_SPEECH_MAX_SECONDS;
+    stage->speech_samples = 0;
+    stage->speech_buffer = MEM_TAG_CAPS_MALLOC(MEM_TAG_VOICE_PIPELINE, stage->speech_capacity * sizeof(int16_t),
+                                               MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!stage->speech_buffer) {
+        stage->speech_buffer = MEM_TAG_MALLOC(MEM_TAG_VOICE_PIPELINE, stage->speech_capacity * sizeof(int16_t));
+    }
+    // The pre-roll counts toward the utterance, so a batch capture never outgrows speech_buffer
+    vad_gate_config_t vad_cfg = {
+        .sample_rate_hz = sample_rate_hz,
+        .preroll_ms = VAD_GATE_PREROLL_MS,
+        .onset_ms = VAD_GATE_ONSET_MS,
+        .hangover_ms = VAD_GATE_HANGOVER_MS,
+        .max_utterance_ms = VOICE_PIPELINE_SPEECH_MAX_SECONDS * 1000,
+    };
+    esp_err_t vad_err = vad_gate_init(&stage->vad, &vad_cfg);
+    if (!stage->feed_buffer || !stage->speech_buffer || !stage->mic_buffer || (with_ref && !stage->ref_buffer) ||
+        vad_err != ESP_OK) {
+        ESP_LOGE(TAG, "AFE stage allocation failed (feed=%zu, speech=%zu samples)",
+                 stage->feed_samples, stage->speech_capacity);
+        vad_gate_deinit(&stage->vad);
+        if (with_ref) {
+            MEM_TAG_FREE(MEM_TAG_VOICE_PIPELINE, stage->mic_buffer);
+            MEM_TAG_FREE(MEM_TAG_VOICE_PIPELINE, stage->ref_buffer);
+        }
+        MEM_TAG_FREE(MEM_TAG_VOICE_PIPELINE, stage->feed_buffer);
+        MEM_TAG_FREE(MEM_TAG_VOICE_PIPELINE, stage->speech_buffer);
+        memset(stage, 0, sizeof(*stage));
+        return ESP_ERR_NO_MEM;
+    }
+    ESP_LOGI(TAG, "AFE stage: feed=%zu samples (%d x %d%s), speech buffer=%zu samples, pre-roll=%u ms",
+             stage->feed_samples, stage->chunksize, stage->channels, with_ref ? ", playback ref" : "",
+             stage->speech_capacity, (unsigned)vad_cfg.preroll_ms);
+    return ESP_OK;
+}
+
+// Mics and reference of one feed in an instance's layout: "MMR", or "MR" for the low-cost profile
+static void afe_stage_interleave(const afe_stage_t *stage, int16_t *dst, int channels)
+{
+    const int16_t *mic = stage->mic_buffer;
+    for (int i = 0; i < stage->chunksize; ++i) {
+        *dst++ = mic[2 * i];
+        if (channels > 2) {
+            *dst++ = mic[2 * i + 1];
+        }
+        *dst++ = stage->ref_buffer[i];
+    }
+}
+
+// Complete a captured feed: interleave the playback that was reaching the
+// speaker while these samples were recorded as the AEC reference channel.
+// A TDM capture carries the codec's own loopback, aligned to the sample;
+// otherwise the player's copy is looked up by capture time
+static void afe_stage_add_reference(afe_stage_t *stage, korvo_audio_t *audio)
+{
+    if (!stage->ref_buffer) {
+        return;
+    }
+    if (korvo_audio_has_reference(audio)) {
+        korvo_audio_read_reference(audio, stage->feed_pos, stage->ref_buffer, (size_t)stage->chunksize);
+    } else {
+        int64_t captured_us = korvo_audio_sample_time_us(audio, stage->feed_pos);
+        audio_player_loopback_read(captured_us - (int64_t)VOICE_PIPELINE_AEC_REF_LEAD_MS * 1000, stage->ref_buffer,
+                                   (size_t)stage->chunksize);
+    }
+    afe_stage_interleave(stage, stage->feed_buffer, stage->channels);
+}
+
+// The configured 1..100 as a WakeNet detection threshold
+static float afe_wakenet_threshold(int configured)
+{
+    return 0.4f + (configured / 100.0f) * 0.5999f;
+}
+
+// On the AFE task, between feeds; until the standby instance exists, low cost is the full one without SE and NS
+static void afe_apply_low_cost(voice_pipeline_handle_t handle, bool low_cost)
+{
+    const esp_afe_sr_iface_t *afe = handle->afe_handle;
+    if (low_cost) {
+        afe->disable_se(handle->afe_data);
+        afe->disable_ns(handle->afe_data);
+    } else {
+        afe->enable_se(handle->afe_data);
+        afe->enable_ns(handle->afe_data);
+    }
+    handle->afe_low_cost_applied = low_cost;
+    handle->afe_se_ns_off = low_cost;
+    ESP_LOGI(TAG, "AFE %s", low_cost ? "low-cost: no beamforming or noise suppression" : "full front end");
+}
+
+// The flag can take the fleet back to plain PCM16 without a rebuild
+static uplink_codec_id_t uplink_codec_for(voice_pipeline_handle_t handle)
+{
+    return feature_flag_bool(FEATURE_FLAG_UPLINK_CODEC) ? handle->cfg.uplink_codec : UPLINK_CODEC_PCM16;
+}
+
+// Low cost only while asked for and nobody has spoken for a while; speech brings back the full front end
+static bool afe_want_low_cost(voice_pipeline_handle_t handle, TickType_t now)
+{
+    return handle->afe_low_cost && !handle->vad_active && feature_flag_bool(FEATURE_FLAG_AFE_PROFILES) &&
+           now - handle->afe_last_speech >= pdMS_TO_TICKS(feature_flag_int(FEATURE_FLAG_AFE_QUIET_MS));
+}
+
+/**
+ * Move towards the wanted profile by one chunk, after the active instance
+ * has had this one. The standby is fed the same chunk for a few chunks so
+ * its AEC, VAD and WakeNet have current audio behind them, and its output
+ * is dropped; then the two change places, so the next chunk goes to the
+ * new instance and none goes missing.
+ */
+static void afe_profile_step(voice_pipeline_handle_t handle, bool low_cost)
+{
+    if (handle->afe_se_ns_off) {
+        afe_apply_low_cost(handle, false);
+    }
+    if (low_cost == handle->afe_low_cost_applied) {
+        handle->afe_warmup = 0;
+        return;
+    }
+    afe_stage_t *stage = &handle->afe_stage;
+    if (handle->afe_warmup == 0) {
+        uint32_t chunk_ms = (uint32_t)((int64_t)stage->chunksize * 1000 / handle->cfg.sample_rate_hz);
+        handle->afe_warmup = chunk_ms ? (feature_flag_int(FEATURE_FLAG_AFE_WARMUP_MS) + chunk_ms - 1) / chunk_ms : 1;
+        handle->afe_warmup = handle->afe_warmup ? handle->afe_warmup : 1;
+    }
+    afe_stage_interleave(stage, handle->afe_standby_feed, handle->afe_standby_channels);
+    if (handle->afe_standby_handle->feed(handle->afe_standby_data, handle->afe_standby_feed) >= 0) {
+        handle->afe_standby_handle->fetch(handle->afe_standby_data);
+    }
+    if (--handle->afe_warmup > 0) {
+        return;
+    }
+
+    const esp_afe_sr_iface_t *afe = handle->afe_handle;
+    esp_afe_sr_data_t *data = handle->afe_data;
+    int16_t *feed = stage->feed_buffer;
+    int channels = stage->channels;
+    handle->afe_handle = handle->afe_standby_handle;
+    handle->afe_data = handle->afe_standby_data;
+    stage->feed_buffer = handle->afe_standby_feed;
+    stage->channels = handle->afe_standby_channels;
+    handle->afe_standby_handle = afe;
+    handle->afe_standby_data = data;
+    handle->afe_standby_feed = feed;
+    handle->afe_standby_channels = channels;
+    handle->afe_low_cost_applied = low_cost;
+    ESP_LOGI(TAG, "AFE %s", low_cost ? "low-cost: one mic, no beamforming or noise suppression" : "full front end");
+}
+
+// Builds the low-cost instance next to the running full one, then exits
+static void afe_standby_task(void *arg)
+{
+    voice_pipeline_handle_t handle = (voice_pipeline_handle_t)arg;
+    const voice_pipeline_config_t *cfg = &handle->cfg;
+    const afe_stage_t *stage = &handle->afe_stage;
+    srmodel_list_t *models = sr_models_get();
+    afe_config_t *afe_config = models ? afe_config_init(VOICE_PIPELINE_AFE_LOW_COST_FORMAT, models, AFE_TYPE_SR,
+                                                        AFE_MODE_LOW_COST)
+                                      : NULL;
+    const esp_afe_sr_iface_t *afe = NULL;
+    esp_afe_sr_data_t *data = NULL;
+    if (afe_config) {
+        // The full profile's stages less beamforming and noise suppression, so wake words and VAD carry over
+        afe_config->aec_init = true;
+        afe_config->se_init = false;
+        afe_config->ns_init = false;
+        afe_config->vad_init = true;
+        afe_config->vad_mode = VAD_MODE_3;
+        afe_config->agc_init = true;
+        afe_config->agc_mode = AFE_AGC_MODE_WAKENET;
+        afe_config->wakenet_init = cfg->enable_wakenet_local && handle->wakenet_model_name;
+        if (afe_config->wakenet_init) {
+            afe_config->wakenet_model_name = handle->wakenet_model_name;
+            afe_config->wakenet_mode = DET_MODE_90;
+        }
+        if (afe_parse_input_format(VOICE_PIPELINE_AFE_LOW_COST_FORMAT, &afe_config->pcm_config)) {
+            afe_config->pcm_config.sample_rate = cfg->sample_rate_hz;
+            afe_config = afe_config_check(afe_config);
+        }
+    }
+    if (afe_config) {
+        afe = esp_afe_handle_from_config(afe_config);
+        data = afe ? afe->create_from_config(afe_config) : NULL;
+    }
+    // Chunks are the audio graph's block size, so both profiles must take the same one
+    if (data && (afe->get_feed_chunksize(data) != stage->chunksize || afe->get_feed_channel_num(data) != 2)) {
+        ESP_LOGW(TAG, "Low-cost AFE takes %d x %d, not %d x 2", afe->get_feed_chunksize(data),
+                 afe->get_feed_channel_num(data), stage->chunksize);
+        afe->destroy(data);
+        data = NULL;
+    }
+    int16_t *feed = data ? MEM_TAG_CAPS_MALLOC(MEM_TAG_VOICE_PIPELINE, (size_t)stage->chunksize * 2 * sizeof(int16_t),
+                                               MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT)
+                         : NULL;
+    if (data && !feed) {
+        afe->destroy(data);
+        data = NULL;
+    }
+    if (data) {
+        if (afe_config->wakenet_init && cfg->wakenet_threshold > 0 && cfg->wakenet_threshold <= 100) {
+            afe->set_wakenet_threshold(data, 1, afe_wakenet_threshold(cfg->wakenet_threshold));
+        }
+        handle->afe_standby_handle = afe;
+        handle->afe_standby_data = data;
+        handle->afe_standby_feed = feed;
+        handle->afe_standby_channels = 2;
+        __atomic_store_n(&handle->afe_standby_ready, true, __ATOMIC_RELEASE);
+        ESP_LOGI(TAG, "Low-cost AFE ready: AEC -> VAD on one mic");
+    } else {
+        ESP_LOGW(TAG, "No low-cost AFE; the low-cost profile switches SE and NS off instead");
+    }
+    if (afe_config) {
+        afe_config_free(afe_config);
+    }
+    task_placement_note_exit(TASK_PLACEMENT_AFE_STANDBY);
+    vTaskDelete(NULL);
+}
+#endif
 
+// The LED state tracks the interaction, so it also decides the clock and the radio
 static void set_led_state(voice_pipeline_handle_t handle, led_controller_state_t state)
 {
+    power_profile_set_busy(POWER_PROFILE_INTERACTION, state != LED_CONTROLLER_STATE_IDLE);
+    radio_coex_set_busy(RADIO_COEX_INTERACTION, state != LED_CONTROLLER_STATE_IDLE);
     if (handle && handle->cfg.leds) {
         led_controller_set_state(handle->cfg.leds, state);
     }
 }
 
+// route, when not NULL, names the providers that served the reply; its
+// stages are timed from the trace for the provider router
+static void publish_routed_interaction(voice_pipeline_handle_t handle,
+                                       const char *transcript,
+                                       const intent_router_decision_t *decision,
+                                       esp_err_t status,
+                                       const provider_router_route_t *route)
+{
+    // The report closes the interaction's latency record
+    interaction_trace_t trace;
+    bool traced = interaction_trace_finish(&trace);
+    if (traced && route) {
+        provider_router_note_trace(&trace, route);
+    }
+    if (handle->cfg.aws_bridge) {
+        aws_iot_bridge_publish_interaction(handle->cfg.aws_bridge, transcript, decision, status,
+                                           traced ? &trace : NULL);
+    } else if (traced) {
+        interaction_trace_log(&trace);
+    }
+}
+
 static void publish_interaction(voice_pipeline_handle_t handle,
                                 const char *transcript,
                                 const intent_router_decision_t *decision,
                                 esp_err_t status)
 {
-    if (handle->cfg.aws_bridge) {
-        aws_iot_bridge_publish_interaction(handle->cfg.aws_bridge, transcript, decision, status);
+    publish_routed_interaction(handle, transcript, decision, status, NULL);
+}
+
+// One LLM request: Gemini with the device state and its tools when there is
+// one, OpenAI from the prompt alone
+static esp_err_t llm_request(provider_router_provider_t provider, const char *prompt, const char *device_state,
+                             char *out, size_t out_len)
+{
+    out[0] = '\0';
+    if (provider == PROVIDER_ROUTER_GEMINI) {
+        return device_state ? gemini_generate_text_response_with_tools(prompt, device_state, out, out_len)
+                            : gemini_generate_text_response(prompt, out, out_len);
     }
+    if (provider == PROVIDER_ROUTER_OPENAI) {
+        return openai_generate_text_response(prompt, out, out_len);
+    }
+    return ESP_ERR_NOT_SUPPORTED;
 }
 
-static esp_err_t capture_audio_block(voice_pipeline_handle_t handle, size_t total_samples)
+// LLM request on provider, then on each healthy provider not in tried until one answers
+static esp_err_t routed_llm(provider_router_provider_t provider, uint32_t tried, const char *prompt,
+                            const char *device_state, char *out, size_t out_len, provider_router_route_t *route)
 {
-    TickType_t lock_timeout = pdMS_TO_TICKS(handle->cfg.capture_ms > 0 ? handle->cfg.capture_ms + 500 : 2000);
-    esp_err_t err = korvo_audio_acquire(handle->cfg.audio, lock_timeout);
-    ESP_RETURN_ON_ERROR(err, TAG, "mic lock");
-    size_t captured = 0;
-    while (captured < total_samples) {
-        size_t remaining = total_samples - captured;
-        size_t chunk = remaining > 512 ? 512 : remaining;
-        size_t read = 0;
-        err = korvo_audio_capture_locked(handle->cfg.audio,
-                                         handle->capture_buffer + captured,
-                                         chunk,
-                                         &read,
-                                         pdMS_TO_TICKS(500));
+    esp_err_t err = ESP_ERR_NOT_SUPPORTED;
+    for (; provider != PROVIDER_ROUTER_NONE; provider = provider_router_next(PROVIDER_ROUTER_LLM, tried)) {
+        tried |= 1u << provider;
+        int64_t start_us = esp_timer_get_time();
+        err = llm_request(provider, prompt, device_state, out, out_len);
+        if (err == ESP_OK && out[0]) {
+            if (route) {
+                route->provider[PROVIDER_ROUTER_LLM] = provider;
+                route->start_us[PROVIDER_ROUTER_LLM] = start_us;
+            }
+            return ESP_OK;
+        }
+        err = err == ESP_OK ? ESP_ERR_INVALID_RESPONSE : err;
+        provider_router_note_failure(provider, PROVIDER_ROUTER_LLM, err, esp_timer_get_time() - start_us);
+        ESP_LOGW(TAG, "LLM request to %s failed (%s)", provider_router_provider_name(provider), esp_err_to_name(err));
+        if (interaction_cancelled()) {
+            break;
+        }
+    }
+    return err;
+}
+
+// Synthesize text and play it while it downloads, or replay it from the TTS
+// cache; blocks until playback is queued. A provider that fails before any
+// audio plays is failed over; route, when not NULL, gets the one that served
+static esp_err_t speak_text(voice_pipeline_handle_t handle, const char *text, size_t *pcm_bytes,
+                            provider_router_route_t *route)
+{
+    wav_stream_player_t *player = handle->tts_player;
+    tts_cache_recorder_t *recorder = NULL;
+    size_t played = 0;
+    esp_err_t err = ESP_ERR_NOT_FOUND;
+    event_bus_publish_state(EVENT_BUS_TOPIC_PLAYBACK, true);
+#if CONFIG_KVA_TTS_CACHE
+    bool cacheable = strlen(text) <= CONFIG_KVA_TTS_CACHE_MAX_CHARS;
+    uint64_t key = cacheable ? tts_cache_key(text, handle->cfg.tts_voice, GEMINI_TTS_MODEL) : 0;
+    if (cacheable) {
+        err = tts_cache_play(key, &played);
+    }
+#endif
+    uint32_t tried = 0;
+    for (provider_router_provider_t provider = err == ESP_ERR_NOT_FOUND ? provider_router_pick(PROVIDER_ROUTER_TTS)
+                                                                        : PROVIDER_ROUTER_NONE;
+         provider != PROVIDER_ROUTER_NONE; provider = provider_router_next(PROVIDER_ROUTER_TTS, tried)) {
+        tried |= 1u << provider;
+        int64_t start_us = esp_timer_get_time();
+        wav_stream_player_begin(player);
+        if (provider == PROVIDER_ROUTER_GEMINI) {
+#if CONFIG_KVA_TTS_CACHE && !CONFIG_KVA_INTERACTION_PSRAM_STACKS
+            // Cached replies are keyed to the Gemini voice and model
+            recorder = cacheable ? tts_cache_record_begin(key, false) : NULL;
+            if (recorder) {
+                player->on_pcm = tts_cache_record_pcm;
+                player->on_pcm_ctx = recorder;
+            }
+#endif
+            err = gemini_tts_generate_stream(text, handle->cfg.tts_voice, wav_stream_player_feed, player);
+        } else {
+            err = openai_tts_generate_stream(text, handle->cfg.tts_voice, wav_stream_player_feed, player);
+        }
+        esp_err_t play_err = wav_stream_player_end(player, &played);
+        if (err == ESP_OK) {
+            err = play_err;
+        }
+        if (err == ESP_OK) {
+            if (route) {
+                route->provider[PROVIDER_ROUTER_TTS] = provider;
+                route->start_us[PROVIDER_ROUTER_TTS] = start_us;
+            }
+            break;
+        }
+        provider_router_note_failure(provider, PROVIDER_ROUTER_TTS, err, esp_timer_get_time() - start_us);
+        if (played || interaction_cancelled()) {
+            // Part of the reply was heard; starting it over on another voice is worse
+            break;
+        }
+        tts_cache_record_end(recorder, false);
+        recorder = NULL;
+        ESP_LOGW(TAG, "TTS from %s failed (%s)", provider_router_provider_name(provider), esp_err_to_name(err));
+    }
+    if (pcm_bytes) {
+        *pcm_bytes = played;
+    }
+    if (played) {
+        audio_player_drain(AUDIO_PLAYER_STREAM_VOICE, VOICE_PIPELINE_DRAIN_TIMEOUT_MS);
+    }
+    event_bus_publish_state(EVENT_BUS_TOPIC_PLAYBACK, false);
+    // Flash is erased only now, with the reply already heard
+    tts_cache_record_end(recorder, err == ESP_OK && !interaction_cancelled());
+    return err;
+}
+
+#ifdef GEMINI_ENABLED
+typedef struct {
+    voice_pipeline_handle_t handle;
+    speech_pipeline_handle_t speech;
+    bool speaking;
+} pipelined_reply_t;
+
+static void pipelined_reply_delta(const char *text, void *ctx)
+{
+    pipelined_reply_t *reply = (pipelined_reply_t *)ctx;
+    if (!reply->speaking) {
+        interaction_trace_mark(INTERACTION_TRACE_LLM_FIRST_TOKEN);
+        reply->speaking = true;
+        set_led_state(reply->handle, LED_CONTROLLER_STATE_SPEAKING);
+        event_bus_publish_state(EVENT_BUS_TOPIC_PLAYBACK, true);
+    }
+    speech_pipeline_push_text(reply->speech, text);
+}
+
+/**
+ * Stream the LLM reply into the speech pipeline so the first sentence plays
+ * while the rest is still being generated and synthesized.
+ *
+ * @return false if the pipeline could not start; nothing was requested
+ */
+static bool respond_pipelined(voice_pipeline_handle_t handle, const char *transcription, const char *device_state,
+                              char *llm_response, size_t llm_len,
+                              esp_err_t *llm_err, esp_err_t *tts_err, size_t *pcm_bytes)
+{
+    const speech_pipeline_config_t speech_cfg = {
+        .tts = gemini_tts_generate_stream,
+        .voice = handle->cfg.tts_voice,
+    };
+    pipelined_reply_t reply = {
+        .handle = handle,
+        .speech = speech_pipeline_start(&speech_cfg),
+    };
+    if (!reply.speech) {
+        return false;
+    }
+
+    *llm_err = gemini_generate_text_response_stream(transcription, device_state, pipelined_reply_delta, &reply,
+                                                    llm_response, llm_len);
+    *tts_err = speech_pipeline_finish(reply.speech, pcm_bytes);
+    if (*pcm_bytes) {
+        audio_player_drain(AUDIO_PLAYER_STREAM_VOICE, VOICE_PIPELINE_DRAIN_TIMEOUT_MS);
+    }
+    if (reply.speaking) {
+        event_bus_publish_state(EVENT_BUS_TOPIC_PLAYBACK, false);
+    }
+    return true;
+}
+#endif
+
+#ifdef GEMINI_ENABLED
+// Where a task-path turn goes as it is captured: a Live session of its own,
+// or a buffer for batch STT when Live cannot start
+typedef struct {
+    gemini_realtime_handle_t live;
+    SemaphoreHandle_t final;          // Given by the final transcript or a session error
+    volatile bool done;               // text holds the final transcript
+    esp_err_t live_err;
+    char text[MAX_TRANSCRIPT_CHARS];
+    int16_t *batch;                   // Batch fallback only
+    size_t batch_capacity;
+    size_t samples;                   // Sent or buffered so far
+} turn_stt_t;
+
+static void turn_transcript_cb(const char *text, bool is_final, void *ctx)
+{
+    turn_stt_t *turn = (turn_stt_t *)ctx;
+    if (!is_final || !text || turn->done) {
+        return;
+    }
+    strlcpy(turn->text, text, sizeof(turn->text));
+    turn->done = true;
+    xSemaphoreGive(turn->final);
+}
+
+static void turn_error_cb(esp_err_t error, void *ctx)
+{
+    turn_stt_t *turn = (turn_stt_t *)ctx;
+    turn->live_err = error;
+    xSemaphoreGive(turn->final);
+}
+
+static void turn_stt_send(const int16_t *samples, size_t count, void *ctx)
+{
+    turn_stt_t *turn = (turn_stt_t *)ctx;
+    if (turn->live) {
+        esp_err_t err = gemini_realtime_send_audio(turn->live, samples, count);
         if (err != ESP_OK) {
+            ESP_LOGW(TAG, "⚠️ [Gemini Live] Send error: %s", esp_err_to_name(err));
+        }
+    } else {
+        size_t room = turn->batch_capacity - turn->samples;
+        count = count > room ? room : count;
+        memcpy(turn->batch + turn->samples, samples, count * sizeof(int16_t));
+    }
+    turn->samples += count;
+}
+
+// Open the turn's Live session, which holds audio sent before its setup
+// completes. Without one the turn is buffered, for one utterance at most
+static esp_err_t turn_stt_begin(voice_pipeline_handle_t handle, turn_stt_t *turn)
+{
+    turn->final = xSemaphoreCreateBinary();
+    ESP_RETURN_ON_FALSE(turn->final, ESP_ERR_NO_MEM, TAG, "turn semaphore");
+    turn->live = gemini_realtime_start(handle->cfg.sample_rate_hz, turn_transcript_cb, turn_error_cb, turn);
+    if (turn->live) {
+        return ESP_OK;
+    }
+    ESP_LOGW(TAG, "Failed to start the live session, capturing the turn for batch STT");
+    turn->batch_capacity = (size_t)handle->cfg.sample_rate_hz * VOICE_PIPELINE_SPEECH_MAX_SECONDS;
+    turn->batch = MEM_TAG_MALLOC(MEM_TAG_VOICE_PIPELINE, turn->batch_capacity * sizeof(int16_t));
+    return turn->batch ? ESP_OK : ESP_ERR_NO_MEM;
+}
+
+// Close the turn and, if speech was sent, wait for its transcript in
+// turn->text. The session and buffer are gone when this returns; route
+// gets the provider of a batch transcript
+static esp_err_t turn_stt_finish(voice_pipeline_handle_t handle, turn_stt_t *turn, bool heard,
+                                 provider_router_route_t *route)
+{
+    esp_err_t err = ESP_OK;
+    if (turn->live) {
+        if (heard) {
+            // The server closes the turn now instead of waiting for its own silence timeout
+            gemini_realtime_end_audio(turn->live);
+            if (xSemaphoreTake(turn->final, pdMS_TO_TICKS(VOICE_PIPELINE_TURN_FINAL_TIMEOUT_MS)) != pdTRUE) {
+                err = ESP_ERR_TIMEOUT;
+            } else if (!turn->done) {
+                err = turn->live_err != ESP_OK ? turn->live_err : ESP_FAIL;
+            }
+        }
+        gemini_realtime_stop(turn->live);
+        turn->live = NULL;
+    } else if (turn->batch) {
+        if (heard) {
+            err = batch_stt_transcribe(turn->batch, turn->samples, handle->cfg.sample_rate_hz,
+                                       uplink_codec_for(handle), turn->text, sizeof(turn->text), route);
+        }
+        MEM_TAG_FREE(MEM_TAG_VOICE_PIPELINE, turn->batch);
+        turn->batch = NULL;
+    }
+    if (turn->final) {
+        vSemaphoreDelete(turn->final);
+        turn->final = NULL;
+    }
+    return err;
+}
+
+// Capture one turn into STT as it is spoken. Like the wake-word sessions it
+// is VAD-gated: the uplink runs while the user talks and capture stops at the
+// end of speech. Without a reader one is opened at the live edge; a reader
+// passed in (a follow-up already under way, its start in the gate's pre-roll)
+// is closed too. ESP_ERR_NOT_FOUND: nobody spoke within cfg.capture_ms
+static esp_err_t capture_turn(voice_pipeline_handle_t handle, korvo_audio_reader_t *reader, turn_stt_t *turn)
+{
+    // Own cursor; the wake-word reader keeps running alongside
+    esp_err_t err = ESP_OK;
+    vad_gate_t *gate = handle->turn_vad;
+    if (!reader) {
+        vad_gate_reset(gate);
+        err = korvo_audio_open_reader(handle->cfg.audio, "capture", &reader);
+        ESP_RETURN_ON_ERROR(err, TAG, "mic reader");
+    } else if (vad_gate_in_speech(gate)) {
+        vad_gate_drain_preroll(gate, turn_stt_send, turn);
+    }
+    bool speaking = vad_gate_in_speech(gate);
+    int16_t frame[VOICE_PIPELINE_TURN_FRAME_SAMPLES];
+    TickType_t start = xTaskGetTickCount();
+    while (true) {
+        if (!speaking && xTaskGetTickCount() - start >= pdMS_TO_TICKS(handle->cfg.capture_ms)) {
+            err = ESP_ERR_NOT_FOUND;
             break;
         }
-        if (read == 0) {
+        size_t read = 0;
+        err = korvo_audio_read(reader, frame, VOICE_PIPELINE_TURN_FRAME_SAMPLES, &read, pdMS_TO_TICKS(500));
+        if (err == ESP_OK && read == 0) {
             err = ESP_ERR_TIMEOUT;
+        }
+        if (err != ESP_OK) {
+            break;
+        }
+        bool speech = vad_gate_classify(gate, frame, read, -1);
+        vad_gate_event_t event = vad_gate_process(gate, frame, read, speech);
+        if (event == VAD_GATE_ONSET) {
+            interaction_trace_mark(INTERACTION_TRACE_VAD_ONSET);
+            vad_gate_drain_preroll(gate, turn_stt_send, turn);
+            speaking = true;
+        } else if (event == VAD_GATE_SPEECH) {
+            turn_stt_send(frame, read, turn);
+        } else if (event == VAD_GATE_END) {
+            interaction_trace_mark(INTERACTION_TRACE_VAD_OFFSET);
             break;
         }
-        captured += read;
     }
-    korvo_audio_release(handle->cfg.audio);
+    if (reader->overruns > 0) {
+        ESP_LOGW(TAG, "Capture lost audio %u time(s)", (unsigned)reader->overruns);
+    }
+    static uint32_t s_dma_overruns;
+    uint32_t dma_overruns = korvo_audio_dma_overruns(reader->ctx);
+    if (dma_overruns != s_dma_overruns) {
+        ESP_LOGW(TAG, "I2S DMA dropped %u buffer(s) since the last capture", (unsigned)(dma_overruns - s_dma_overruns));
+        s_dma_overruns = dma_overruns;
+    }
+    korvo_audio_close_reader(reader);
+    if (err == ESP_ERR_NOT_FOUND) {
+        return err;
+    }
     ESP_RETURN_ON_ERROR(err, TAG, "mic read");
-    ESP_LOGI(TAG, "Captured %zu samples", captured);
+    ESP_LOGI(TAG, "Captured %zu samples", turn->samples);
     return ESP_OK;
 }
+#endif
 
 static void pick_response_text(const intent_router_decision_t *decision, char *out, size_t out_len)
 {
@@ -172,41 +844,101 @@ static void pick_response_text(const intent_router_decision_t *decision, char *o
     }
 }
 
-static void voice_pipeline_process_interaction(voice_pipeline_handle_t handle)
+// Run a routed intent; ESP_ERR_NOT_SUPPORTED for INTENT_ROUTER_ACTION_NONE
+static esp_err_t run_intent(voice_pipeline_handle_t handle, const intent_router_decision_t *decision)
+{
+    switch (decision->action) {
+        case INTENT_ROUTER_ACTION_SPOTIFY_PLAY:
+            return spotify_client_play(handle->cfg.spotify, decision->argument);
+        case INTENT_ROUTER_ACTION_SPOTIFY_PAUSE:
+            return spotify_client_pause(handle->cfg.spotify);
+        case INTENT_ROUTER_ACTION_SPOTIFY_RESUME:
+            return spotify_client_resume(handle->cfg.spotify);
+        case INTENT_ROUTER_ACTION_SPOTIFY_VOLUME_DELTA:
+            return spotify_client_volume_delta(handle->cfg.spotify, decision->volume_delta);
+        case INTENT_ROUTER_ACTION_LIGHTS_OFF:
+            event_bus_publish_state(EVENT_BUS_TOPIC_LIGHTS, false);
+            return ESP_OK;
+        case INTENT_ROUTER_ACTION_LIGHTS_ON:
+            event_bus_publish_state(EVENT_BUS_TOPIC_LIGHTS, true);
+            return ESP_OK;
+        case INTENT_ROUTER_ACTION_NONE:
+        default:
+            return ESP_ERR_NOT_SUPPORTED;
+    }
+}
+
+static bool is_spotify_action(intent_router_action_t action)
+{
+    return action == INTENT_ROUTER_ACTION_SPOTIFY_PLAY || action == INTENT_ROUTER_ACTION_SPOTIFY_PAUSE ||
+           action == INTENT_ROUTER_ACTION_SPOTIFY_RESUME || action == INTENT_ROUTER_ACTION_SPOTIFY_VOLUME_DELTA;
+}
+
+// Spotify commands are Web API round trips; their latency goes to the metrics
+static esp_err_t execute_intent(voice_pipeline_handle_t handle, const intent_router_decision_t *decision)
+{
+    int64_t start_us = esp_timer_get_time();
+    esp_err_t err = run_intent(handle, decision);
+    if (handle->cfg.aws_bridge && is_spotify_action(decision->action)) {
+        aws_iot_bridge_record_spotify_latency(handle->cfg.aws_bridge, esp_timer_get_time() - start_us);
+    }
+    return err;
+}
+
+// One wake-word turn: capture, STT, intent and a spoken reply. reader
+// carries a follow-up whose start is already in the turn gate's pre-roll.
+// Returns true if the reply was heard out, so a follow-up may come
+static bool voice_pipeline_process_interaction(voice_pipeline_handle_t handle, korvo_audio_reader_t *reader)
 {
     if (!handle || !handle->cfg.audio) {
-        return;
+        if (reader) {
+            korvo_audio_close_reader(reader);
+        }
+        return false;
     }
 
-    const size_t samples = handle->capture_samples;
     set_led_state(handle, LED_CONTROLLER_STATE_LISTENING);
-    if (capture_audio_block(handle, samples) != ESP_OK) {
+    char transcript_text[MAX_TRANSCRIPT_CHARS] = {0};
+    esp_err_t stt_err = ESP_FAIL;
+    provider_router_route_t route;
+    provider_router_route_init(&route);
+#ifdef GEMINI_ENABLED
+    // Streamed to Gemini STT while it is captured
+    turn_stt_t turn = {0};
+    esp_err_t capture_err = turn_stt_begin(handle, &turn);
+    if (capture_err == ESP_OK) {
+        capture_err = capture_turn(handle, reader, &turn);
+    } else if (reader) {
+        korvo_audio_close_reader(reader);
+    }
+    if (capture_err == ESP_OK) {
+        set_led_state(handle, LED_CONTROLLER_STATE_THINKING);
+    }
+    stt_err = turn_stt_finish(handle, &turn, capture_err == ESP_OK, &route);
+    if (capture_err == ESP_ERR_NOT_FOUND) {
+        ESP_LOGI(TAG, "No speech after the wake");
+        publish_interaction(handle, "no-speech", NULL, capture_err);
+        set_led_state(handle, LED_CONTROLLER_STATE_IDLE);
+        return false;
+    }
+    if (capture_err != ESP_OK) {
         ESP_LOGE(TAG, "Audio capture failed");
-        publish_interaction(handle, "capture-failed", NULL, ESP_FAIL);
+        publish_interaction(handle, "capture-failed", NULL, capture_err);
         set_led_state(handle, LED_CONTROLLER_STATE_ERROR);
         set_led_state(handle, LED_CONTROLLER_STATE_IDLE);
-        return;
+        return false;
     }
-
-    // Use Gemini STT exclusively
-    char transcript_text[MAX_TRANSCRIPT_CHARS] = {0};
-    esp_err_t stt_err = ESP_FAIL;
-    
-    set_led_state(handle, LED_CONTROLLER_STATE_THINKING);
-    
-    // Gemini STT pathway
-    ESP_LOGI(TAG, "🎤 [Gemini STT] Starting transcription (%zu samples, %d Hz)", samples, handle->cfg.sample_rate_hz);
-#ifdef GEMINI_ENABLED
-    gemini_transcription_t transcript = {0};
-    stt_err = gemini_transcribe_wav(handle->capture_buffer, samples, handle->cfg.sample_rate_hz, &transcript);
     if (stt_err == ESP_OK) {
-        strncpy(transcript_text, transcript.text, sizeof(transcript_text) - 1);
-        transcript_text[sizeof(transcript_text) - 1] = '\0';
+        interaction_trace_mark(INTERACTION_TRACE_STT_FINAL);
+        strlcpy(transcript_text, turn.text, sizeof(transcript_text));
         ESP_LOGI(TAG, "✅ [Gemini STT] Success: \"%s\"", transcript_text);
     } else {
         ESP_LOGE(TAG, "❌ [Gemini STT] Failed: %s", esp_err_to_name(stt_err));
     }
 #else
+    if (reader) {
+        korvo_audio_close_reader(reader);
+    }
     ESP_LOGE(TAG, "❌ [Gemini STT] Gemini not enabled (GEMINI_ENABLED not defined)");
     stt_err = ESP_ERR_NOT_SUPPORTED;
 #endif
@@ -219,7 +951,7 @@ static void voice_pipeline_process_interaction(voice_pipeline_handle_t handle)
         publish_interaction(handle, "stt-error", NULL, stt_err);
         set_led_state(handle, LED_CONTROLLER_STATE_ERROR);
         set_led_state(handle, LED_CONTROLLER_STATE_IDLE);
-        return;
+        return false;
     }
 
     ESP_LOGI(TAG, "Heard: \"%s\"", transcript_text);
@@ -262,69 +994,28 @@ static void voice_pipeline_process_interaction(voice_pipeline_handle_t handle)
     }
     
     intent_router_decision_t decision = intent_router_route(handle->cfg.router, filtered_text);
-    esp_err_t action_err = ESP_OK;
-    switch (decision.action) {
-        case INTENT_ROUTER_ACTION_SPOTIFY_PLAY:
-            action_err = spotify_client_play(handle->cfg.spotify, decision.argument);
-            break;
-        case INTENT_ROUTER_ACTION_SPOTIFY_PAUSE:
-            action_err = spotify_client_pause(handle->cfg.spotify);
-            break;
-        case INTENT_ROUTER_ACTION_SPOTIFY_RESUME:
-            action_err = spotify_client_resume(handle->cfg.spotify);
-            break;
-        case INTENT_ROUTER_ACTION_SPOTIFY_VOLUME_DELTA:
-            action_err = spotify_client_volume_delta(handle->cfg.spotify, decision.volume_delta);
-            break;
-        case INTENT_ROUTER_ACTION_LIGHTS_OFF:
-            lights_off();
-            action_err = ESP_OK;
-            break;
-        case INTENT_ROUTER_ACTION_LIGHTS_ON:
-            lights_on();
-            action_err = ESP_OK;
-            break;
-        case INTENT_ROUTER_ACTION_NONE:
-        default:
-            action_err = ESP_ERR_NOT_SUPPORTED;
-            break;
-    }
+    esp_err_t action_err = execute_intent(handle, &decision);
     if (handle->cfg.aws_bridge) {
         aws_iot_bridge_record_spotify_result(handle->cfg.aws_bridge, action_err);
     }
 
     char response_text[96] = {0};
     pick_response_text(&decision, response_text, sizeof(response_text));
-    size_t wav_bytes = 0;
+    size_t pcm_bytes = 0;
     set_led_state(handle, LED_CONTROLLER_STATE_SPEAKING);
-    esp_err_t tts_err = gemini_tts_generate(response_text,
-                                            handle->cfg.tts_voice,
-                                            handle->tts_buffer,
-                                            handle->tts_buffer_bytes,
-                                            &wav_bytes);
+    esp_err_t tts_err = speak_text(handle, response_text, &pcm_bytes, &route);
     if (handle->cfg.aws_bridge) {
         aws_iot_bridge_record_tts_result(handle->cfg.aws_bridge, tts_err);
     }
     if (tts_err == ESP_OK) {
-        ESP_LOGI(TAG, "Synthesized %d bytes of TTS audio", (int)wav_bytes);
-        audio_playback_led_start();
-        esp_err_t playback_err = audio_player_play_wav(handle->tts_buffer, wav_bytes);
-        if (playback_err != ESP_OK) {
-            ESP_LOGW(TAG, "Playback failed (%s)", esp_err_to_name(playback_err));
-            audio_playback_led_stop();
-        } else {
-            // Estimate playback duration: WAV header + data, assume 16kHz mono
-            // Rough estimate: ~wav_bytes / 32000 seconds (16-bit samples at 16kHz)
-            int estimated_ms = (int)(wav_bytes / 32) + 500; // Add 500ms buffer
-            vTaskDelay(pdMS_TO_TICKS(estimated_ms));
-            audio_playback_led_stop();
-        }
+        ESP_LOGI(TAG, "Played %d bytes of TTS audio", (int)pcm_bytes);
     } else {
         ESP_LOGE(TAG, "TTS failed (%s)", esp_err_to_name(tts_err));
     }
 
-    publish_interaction(handle, transcript_text, &decision, action_err);
+    publish_routed_interaction(handle, transcript_text, &decision, action_err, &route);
     set_led_state(handle, LED_CONTROLLER_STATE_IDLE);
+    return tts_err == ESP_OK && !interaction_cancelled();
 }
 
 static void voice_pipeline_process_button(voice_pipeline_handle_t handle, int button_id)
@@ -339,42 +1030,39 @@ static void voice_pipeline_process_button(voice_pipeline_handle_t handle, int bu
     char prompt[96];
     snprintf(prompt, sizeof(prompt), "Someone pressed button %d. Acknowledge briefly and cheerfully.", button_id);
     char llm_text[MAX_TRANSCRIPT_CHARS] = {0};
-    esp_err_t llm_err = gemini_generate_text_response(prompt, llm_text, sizeof(llm_text));
+    esp_err_t llm_err = routed_llm(provider_router_pick(PROVIDER_ROUTER_LLM), 0, prompt, NULL, llm_text,
+                                   sizeof(llm_text), NULL);
     if (llm_err != ESP_OK || llm_text[0] == '\0') {
         snprintf(llm_text, sizeof(llm_text), "Button %d pressed.", button_id);
     }
     set_led_state(handle, LED_CONTROLLER_STATE_SPEAKING);
-    size_t wav_bytes = 0;
-    esp_err_t tts_err = gemini_tts_generate(llm_text,
-                                            handle->cfg.tts_voice,
-                                            handle->tts_buffer,
-                                            handle->tts_buffer_bytes,
-                                            &wav_bytes);
+    size_t pcm_bytes = 0;
+    esp_err_t tts_err = speak_text(handle, llm_text, &pcm_bytes, NULL);
     if (handle->cfg.aws_bridge) {
         aws_iot_bridge_record_tts_result(handle->cfg.aws_bridge, tts_err);
     }
     if (tts_err == ESP_OK) {
-        ESP_LOGI(TAG, "Button %d prompt => \"%s\" (%d bytes audio)", button_id, llm_text, (int)wav_bytes);
+        ESP_LOGI(TAG, "Button %d prompt => \"%s\" (%d bytes audio)", button_id, llm_text, (int)pcm_bytes);
     } else {
         ESP_LOGE(TAG, "Button speech synthesis failed (%s)", esp_err_to_name(tts_err));
     }
-    if (tts_err == ESP_OK) {
-        audio_playback_led_start();
-        esp_err_t playback_err = audio_player_play_wav(handle->tts_buffer, wav_bytes);
-        if (playback_err != ESP_OK) {
-            ESP_LOGW(TAG, "Button response playback failed (%s)", esp_err_to_name(playback_err));
-            audio_playback_led_stop();
-        } else {
-            int estimated_ms = (int)(wav_bytes / 32) + 500;
-            vTaskDelay(pdMS_TO_TICKS(estimated_ms));
-            audio_playback_led_stop();
-        }
-    }
 
     publish_interaction(handle, llm_text, NULL, tts_err);
     set_led_state(handle, LED_CONTROLLER_STATE_IDLE);
 }
 
+void voice_pipeline_set_afe_low_cost(voice_pipeline_handle_t handle, bool low_cost)
+{
+#if CONFIG_KORVO_FARFIELD_WAKE_WORD_ENABLE
+    if (handle) {
+        handle->afe_low_cost = low_cost;
+    }
+#else
+    (void)handle;
+    (void)low_cost;
+#endif
+}
+
 void voice_pipeline_set_wake_callback(voice_pipeline_handle_t handle, voice_pipeline_wake_callback_t callback, void *ctx)
 {
     if (handle) {
@@ -383,22 +1071,21 @@ void voice_pipeline_set_wake_callback(voice_pipeline_handle_t handle, voice_pipe
     }
 }
 
-// Task data structure for GPT+TTS processing
+// One reply, copied into the worker pool's queue
 typedef struct {
     voice_pipeline_handle_t handle;
-    char text[MAX_TRANSCRIPT_CHARS];
-    bool active;
+    char text[MAX_TRANSCRIPT_CHARS];    // Empty: transcribe afe_stage.speech_buffer first
+    intent_router_decision_t decision;  // Local intent of text, reported with the reply
+    bool has_decision;
+    provider_router_route_t route;      // Providers that served the reply, filled in as it runs
 } gpt_tts_task_data_t;
 
 // Task to handle GPT/Gemini chat + TTS asynchronously
 // Also handles Gemini batch STT when transcription is not provided
-static void gpt_tts_response_task(void *arg)
+static esp_err_t gpt_tts_respond(gpt_tts_task_data_t *task_data)
 {
-    gpt_tts_task_data_t *task_data = (gpt_tts_task_data_t *)arg;
-    
     if (!task_data || !task_data->handle) {
-        vTaskDelete(NULL);
-        return;
+        return ESP_ERR_INVALID_ARG;
     }
     
     voice_pipeline_handle_t handle = task_data->handle;
@@ -414,9 +1101,9 @@ static void gpt_tts_response_task(void *arg)
         // Note: This requires the audio buffer to still be in handle when task runs
         // A better approach would be to pass audio buffer via task parameter, but for now
         // we'll rely on the handle's buffer being available
-        if (handle->gemini_audio_buffer && handle->gemini_audio_samples > 0) {
-            size_t audio_samples = handle->gemini_audio_samples;
-            int16_t *audio_buffer = handle->gemini_audio_buffer;
+        if (handle->afe_stage.speech_buffer && handle->afe_stage.speech_samples > 0) {
+            size_t audio_samples = handle->afe_stage.speech_samples;
+            int16_t *audio_buffer = handle->afe_stage.speech_buffer;
             
             ESP_LOGI(TAG, "=== GEMINI BATCH STT-LLM-TTS PATHWAY START ===");
             float audio_duration = (float)audio_samples / handle->cfg.sample_rate_hz;
@@ -424,50 +1111,39 @@ static void gpt_tts_response_task(void *arg)
                      audio_samples, audio_duration, handle->cfg.sample_rate_hz);
             ESP_LOGI(TAG, "Step 1/3: STT - Processing batch STT (%zu samples, %d Hz)", 
                      audio_samples, handle->cfg.sample_rate_hz);
-            gemini_transcription_t gemini_transcript = {0};
-            esp_err_t stt_err = gemini_transcribe_wav(audio_buffer, 
-                                                      audio_samples,
-                                                      handle->cfg.sample_rate_hz,
-                                                      &gemini_transcript);
-            // Clear buffer after processing
-            handle->gemini_audio_samples = 0;
+            // The router's pick, with failover (and a hedge, if enabled) to the other provider
+            esp_err_t stt_err = batch_stt_transcribe(audio_buffer, audio_samples, handle->cfg.sample_rate_hz,
+                                                     uplink_codec_for(handle), task_data->text,
+                                                     sizeof(task_data->text), &task_data->route);
+            // Clear buffer after processing; the next utterance may be captured during the reply
+            handle->afe_stage.speech_samples = 0;
+            handle->afe_stage.speech_held = false;
             
-            if (stt_err == ESP_OK && strlen(gemini_transcript.text) > 0) {
-                strncpy(task_data->text, gemini_transcript.text, sizeof(task_data->text) - 1);
-                task_data->text[sizeof(task_data->text) - 1] = '\0';
+            if (stt_err == ESP_OK && strlen(task_data->text) > 0) {
+                interaction_trace_mark(INTERACTION_TRACE_STT_FINAL);
                 transcription = task_data->text;
                 ESP_LOGI(TAG, "✅ Step 1/3: STT SUCCESS - Transcript: \"%s\"", transcription);
             } else {
                 ESP_LOGE(TAG, "❌ Step 1/3: STT FAILED - Error: %s", esp_err_to_name(stt_err));
-                task_data->active = false;
-                vTaskDelete(NULL);
-                return;
+                return stt_err != ESP_OK ? stt_err : ESP_ERR_NOT_FOUND;
             }
         } else {
             ESP_LOGW(TAG, "Gemini: No audio buffer available for STT");
-            task_data->active = false;
-            vTaskDelete(NULL);
-            return;
+            return ESP_ERR_INVALID_STATE;
         }
 #else
         ESP_LOGE(TAG, "Gemini requires CONFIG_KORVO_FARFIELD_WAKE_WORD_ENABLE");
-        task_data->active = false;
-        vTaskDelete(NULL);
-        return;
+        return ESP_ERR_NOT_SUPPORTED;
 #endif
 #else
         ESP_LOGE(TAG, "Gemini requested but not enabled");
-        task_data->active = false;
-        vTaskDelete(NULL);
-        return;
+        return ESP_ERR_NOT_SUPPORTED;
 #endif
     }
     
     if (!transcription || strlen(transcription) == 0) {
         ESP_LOGW(TAG, "No transcription to process");
-        task_data->active = false;
-        vTaskDelete(NULL);
-        return;
+        return ESP_ERR_INVALID_ARG;
     }
     
     ESP_LOGI(TAG, "=== GEMINI STT-LLM-TTS PATHWAY CONTINUED ===");
@@ -479,6 +1155,9 @@ static void gpt_tts_response_task(void *arg)
     // Send transcription to Gemini LLM (exclusively) with device state and function calling
     char llm_response[MAX_TRANSCRIPT_CHARS] = {0};
     esp_err_t llm_err = ESP_FAIL;
+    esp_err_t tts_err = ESP_FAIL;
+    size_t pcm_bytes = 0;
+    bool pipelined = false;
     
     ESP_LOGI(TAG, "💬 [Gemini Live] Step 2/3: LLM - Sending to Gemini: \"%s\"", transcription);
 #ifdef GEMINI_ENABLED
@@ -486,13 +1165,42 @@ static void gpt_tts_response_task(void *arg)
     char *device_state = device_state_to_json();
     if (device_state) {
         ESP_LOGD(TAG, "💬 [Gemini Live] Device state: %s", device_state);
-        llm_err = gemini_generate_text_response_with_tools(transcription, device_state, llm_response, sizeof(llm_response));
-        free(device_state);
     } else {
         ESP_LOGW(TAG, "⚠️ [Gemini Live] Failed to get device state, using basic prompt");
-        llm_err = gemini_generate_text_response(transcription, llm_response, sizeof(llm_response));
     }
+    provider_router_route_t *route = &task_data->route;
+    provider_router_provider_t llm_provider = provider_router_pick(PROVIDER_ROUTER_LLM);
+    uint32_t llm_tried = 0;
+    if (llm_provider == PROVIDER_ROUTER_GEMINI && handle->cfg.pipelined_tts &&
+        feature_flag_bool(FEATURE_FLAG_PIPELINED_TTS)) {
+        // Steps 2 and 3 overlap: sentence N plays while N+1 is synthesized
+        int64_t start_us = esp_timer_get_time();
+        pipelined = respond_pipelined(handle, transcription, device_state, llm_response, sizeof(llm_response),
+                                      &llm_err, &tts_err, &pcm_bytes);
+        if (pipelined && llm_err == ESP_OK && llm_response[0]) {
+            route->provider[PROVIDER_ROUTER_LLM] = PROVIDER_ROUTER_GEMINI;
+            route->start_us[PROVIDER_ROUTER_LLM] = start_us;
+            route->provider[PROVIDER_ROUTER_TTS] = PROVIDER_ROUTER_GEMINI;
+        } else if (pipelined) {
+            provider_router_note_failure(PROVIDER_ROUTER_GEMINI, PROVIDER_ROUTER_LLM,
+                                         llm_err != ESP_OK ? llm_err : ESP_ERR_INVALID_RESPONSE,
+                                         esp_timer_get_time() - start_us);
+            if (pcm_bytes == 0 && !interaction_cancelled()) {
+                // Nothing was heard yet, so the reply can still come from elsewhere
+                pipelined = false;
+                llm_tried = 1u << PROVIDER_ROUTER_GEMINI;
+                llm_provider = provider_router_next(PROVIDER_ROUTER_LLM, llm_tried);
+            }
+        }
+    }
+    if (!pipelined) {
+        llm_err = routed_llm(llm_provider, llm_tried, transcription, device_state, llm_response,
+                             sizeof(llm_response), route);
+    }
+    cJSON_free(device_state);
     if (llm_err == ESP_OK && strlen(llm_response) > 0) {
+        // Pipelined replies stamped this at their first delta; otherwise the reply arrives whole
+        interaction_trace_mark(INTERACTION_TRACE_LLM_FIRST_TOKEN);
         ESP_LOGI(TAG, "✅ [Gemini Live] Step 2/3: LLM SUCCESS - Response: \"%s\"", llm_response);
     } else {
         ESP_LOGE(TAG, "❌ [Gemini Live] Step 2/3: LLM FAILED - Error: %s", esp_err_to_name(llm_err));
@@ -503,54 +1211,117 @@ static void gpt_tts_response_task(void *arg)
 #endif
     
     if (llm_err == ESP_OK && strlen(llm_response) > 0) {
-        // Generate TTS from LLM response using Gemini
-        set_led_state(handle, LED_CONTROLLER_STATE_SPEAKING);
-        size_t wav_bytes = 0;
-        esp_err_t tts_err = ESP_FAIL;
-        
-        ESP_LOGI(TAG, "Step 3/3: TTS - Generating speech from LLM response (voice: %s)", handle->cfg.tts_voice);
+        if (!pipelined) {
+            // Generate TTS from LLM response using Gemini
+            set_led_state(handle, LED_CONTROLLER_STATE_SPEAKING);
+            
+            ESP_LOGI(TAG, "Step 3/3: TTS - Streaming speech from LLM response (voice: %s)", handle->cfg.tts_voice);
 #ifdef GEMINI_ENABLED
-        tts_err = gemini_tts_generate(llm_response,
-                                     handle->cfg.tts_voice,
-                                     handle->tts_buffer,
-                                     handle->tts_buffer_bytes,
-                                     &wav_bytes);
-        if (tts_err == ESP_OK && wav_bytes > 0) {
-            ESP_LOGI(TAG, "✅ Step 3/3: TTS SUCCESS - Generated %d bytes", (int)wav_bytes);
-        } else {
-            ESP_LOGE(TAG, "❌ Step 3/3: TTS FAILED - Error: %s", esp_err_to_name(tts_err));
-        }
+            // Playback starts with the first downloaded chunk
+            tts_err = speak_text(handle, llm_response, &pcm_bytes, route);
 #else
-        ESP_LOGE(TAG, "❌ GEMINI NOT ENABLED - GEMINI_ENABLED not defined");
-        tts_err = ESP_ERR_NOT_SUPPORTED;
+            ESP_LOGE(TAG, "❌ GEMINI NOT ENABLED - GEMINI_ENABLED not defined");
+            tts_err = ESP_ERR_NOT_SUPPORTED;
 #endif
+        }
         
-        if (tts_err == ESP_OK && wav_bytes > 0) {
-            // Play TTS audio
-            ESP_LOGI(TAG, "Playing TTS audio (%d bytes)", (int)wav_bytes);
-            audio_playback_led_start();
-            esp_err_t playback_err = audio_player_play_wav(handle->tts_buffer, wav_bytes);
-            if (playback_err != ESP_OK) {
-                ESP_LOGE(TAG, "❌ TTS playback failed: %s", esp_err_to_name(playback_err));
-                audio_playback_led_stop();
-            } else {
-                // Estimate playback duration: WAV header + data, assume 16kHz mono
-                int estimated_ms = (int)(wav_bytes / 32) + 500; // Add 500ms buffer
-                ESP_LOGI(TAG, "✅ TTS playback started (estimated %d ms)", estimated_ms);
-                vTaskDelay(pdMS_TO_TICKS(estimated_ms));
-                audio_playback_led_stop();
-                ESP_LOGI(TAG, "=== GEMINI STT-LLM-TTS PATHWAY COMPLETE ===");
-            }
+        if (tts_err == ESP_OK && pcm_bytes > 0) {
+            ESP_LOGI(TAG, "✅ Step 3/3: TTS SUCCESS - Played %d bytes", (int)pcm_bytes);
+            ESP_LOGI(TAG, "=== GEMINI STT-LLM-TTS PATHWAY COMPLETE ===");
         } else {
+            ESP_LOGE(TAG, "❌ Step 3/3: TTS FAILED - Error: %s", esp_err_to_name(tts_err));
             ESP_LOGE(TAG, "=== GEMINI STT-LLM-TTS PATHWAY FAILED AT TTS ===");
         }
     } else {
         ESP_LOGE(TAG, "=== GEMINI STT-LLM-TTS PATHWAY FAILED AT LLM ===");
     }
+#if CONFIG_KVA_CONVERSATION_MEMORY
+    // Only replies that were heard out; the next request replays them
+    if (llm_err == ESP_OK && tts_err == ESP_OK && llm_response[0]) {
+        conversation_memory_add(transcription, llm_response);
+    }
+#endif
     
     set_led_state(handle, LED_CONTROLLER_STATE_IDLE);
-    task_data->active = false;
-    vTaskDelete(NULL);
+    return llm_err != ESP_OK ? llm_err : tts_err;
+}
+
+static void gpt_tts_response_job(void *job, void *ctx)
+{
+    (void)ctx;
+    gpt_tts_task_data_t *task_data = (gpt_tts_task_data_t *)job;
+    bool batch = task_data->text[0] == '\0';
+    // Everything the reply allocates is dropped in one reset at the end
+    interaction_arena_begin();
+    interaction_token_t token = interaction_cancel_begin();
+    provider_router_route_init(&task_data->route);
+    esp_err_t reply_err = gpt_tts_respond(task_data);
+#if CONFIG_KORVO_FARFIELD_WAKE_WORD_ENABLE
+    if (batch) {
+        // Released after STT on success; this covers the paths that never reached it
+        task_data->handle->afe_stage.speech_held = false;
+    }
+#else
+    (void)batch;
+#endif
+    if (interaction_cancelled()) {
+        ESP_LOGI(TAG, "Reply cancelled after %s", esp_err_to_name(reply_err));
+    }
+    // Reported after playback so the latency record spans the whole reply
+    publish_routed_interaction(task_data->handle, task_data->text[0] ? task_data->text : "stt-error",
+                               task_data->has_decision ? &task_data->decision : NULL, reply_err, &task_data->route);
+    interaction_cancel_end(token);
+    interaction_arena_end();
+}
+
+// A newer transcript pushed this one out of a full queue
+static void gpt_tts_drop_job(void *job, void *ctx)
+{
+    (void)ctx;
+    gpt_tts_task_data_t *task_data = (gpt_tts_task_data_t *)job;
+    if (task_data->text[0] == '\0') {
+#if CONFIG_KORVO_FARFIELD_WAKE_WORD_ENABLE
+        task_data->handle->afe_stage.speech_samples = 0;
+        task_data->handle->afe_stage.speech_held = false;
+#endif
+        ESP_LOGW(TAG, "Dropped a queued utterance before STT");
+        return;
+    }
+    ESP_LOGW(TAG, "Dropped queued transcript \"%s\"", task_data->text);
+    publish_interaction(task_data->handle, task_data->text, task_data->has_decision ? &task_data->decision : NULL,
+                        ESP_ERR_TIMEOUT);
+}
+
+static size_t count_words(const char *text)
+{
+    size_t words = 0;
+    bool in_word = false;
+    for (; *text; ++text) {
+        bool space = isspace((unsigned char)*text);
+        if (!space && !in_word) {
+            words++;
+        }
+        in_word = !space;
+    }
+    return words;
+}
+
+// Run a device command as soon as a partial transcript names it. The final
+// transcript of the turn is then ignored, so no LLM request is made for it.
+static void early_intent_dispatch(voice_pipeline_handle_t handle, const char *partial)
+{
+    intent_router_decision_t decision = intent_router_route_partial(handle->cfg.router, &handle->partial_route,
+                                                                    partial);
+    if (!intent_router_is_immediate(&decision) || count_words(partial) > VOICE_PIPELINE_EARLY_INTENT_MAX_WORDS) {
+        return;
+    }
+    handle->utterance_local = true;
+    esp_err_t err = execute_intent(handle, &decision);
+    ESP_LOGI(TAG, "⚡ [Realtime] Early intent from partial \"%s\" -> %s", partial, esp_err_to_name(err));
+    if (handle->cfg.aws_bridge) {
+        aws_iot_bridge_record_spotify_result(handle->cfg.aws_bridge, err);
+    }
+    publish_interaction(handle, partial, &decision, err);
 }
 
 // Realtime transcription callback
@@ -572,55 +1343,62 @@ static void realtime_transcript_cb(const char *text, bool is_final, void *ctx)
         ESP_LOGI(TAG, "Gemini STT (partial): \"%s\"", text);
     }
     
+    if (!is_final) {
+#if CONFIG_KORVO_FARFIELD_WAKE_WORD_ENABLE && CONFIG_KVA_TURN_PREDICTOR
+        if (handle->turns) {
+            turn_predictor_set_partial(handle->turns, text);
+        }
+#endif
+        if (!handle->utterance_local) {
+            early_intent_dispatch(handle, text);
+        }
+        return;
+    }
+    intent_router_stream_begin(&handle->partial_route);
+    if (handle->utterance_local) {
+        // MultiNet or a partial already ran this command; do not act on it twice
+        ESP_LOGI(TAG, "Utterance handled locally, ignoring its transcript");
+#if CONFIG_KORVO_FARFIELD_WAKE_WORD_ENABLE
+        if (!handle->vad_active)
+#endif
+        {
+            // Turn over; without a VAD gate there is no onset to clear it
+            handle->utterance_local = false;
+        }
+        return;
+    }
     if (is_final && strlen(text) > 0) {
+        interaction_trace_mark(INTERACTION_TRACE_STT_FINAL);
+        // Intent routing for local actions is quick and synchronous
+        intent_router_decision_t decision = intent_router_route(handle->cfg.router, text);
+        
         // Send STT transcription to Gemini LLM and TTS the response
         // Do this in a separate task to avoid blocking callback
-        static gpt_tts_task_data_t gpt_tts_task_data = {0};
-        
-        // Copy text and trigger async processing
-        if (!gpt_tts_task_data.active && strlen(text) < sizeof(gpt_tts_task_data.text)) {
-            gpt_tts_task_data.handle = handle;
-            strncpy(gpt_tts_task_data.text, text, sizeof(gpt_tts_task_data.text) - 1);
-            gpt_tts_task_data.text[sizeof(gpt_tts_task_data.text) - 1] = '\0';
-            gpt_tts_task_data.active = true;
-            
-            // Spawn task to handle LLM chat + TTS (Gemini only)
-            const char *task_name = "gemini_llm_tts_task";
-            ESP_LOGI(TAG, "📤 [Realtime] Routing transcription to Gemini LLM: \"%s\"", text);
-            xTaskCreate(gpt_tts_response_task, task_name, 8192, &gpt_tts_task_data, 5, NULL);
-        } else {
-            ESP_LOGW(TAG, "LLM+TTS task already active, skipping");
-        }
-        
-        // Also process intent routing for local actions (quick, synchronous)
-        intent_router_decision_t decision = intent_router_route(handle->cfg.router, text);
+        // Staged off the WebSocket task's stack; only that task calls here and the pool copies it,
+        // so a transcript arriving mid-reply queues behind it instead of overwriting it
+        static gpt_tts_task_data_t job;
+        memset(&job, 0, sizeof(job));
+        job.handle = handle;
+        strlcpy(job.text, text, sizeof(job.text));
+        job.decision = decision;
+        job.has_decision = true;
+        ESP_LOGI(TAG, "📤 [Realtime] Routing transcription to Gemini LLM: \"%s\"", text);
+        // The worker reports the interaction when the reply ends
+        bool replying = interaction_pool_submit(handle->replies, &job) == ESP_OK;
         
         // Handle intent actions
         esp_err_t action_err = ESP_OK;
-        switch (decision.action) {
-            case INTENT_ROUTER_ACTION_SPOTIFY_PLAY:
-                action_err = spotify_client_play(handle->cfg.spotify, decision.argument);
-                break;
-            case INTENT_ROUTER_ACTION_SPOTIFY_PAUSE:
-                action_err = spotify_client_pause(handle->cfg.spotify);
-                break;
-            case INTENT_ROUTER_ACTION_SPOTIFY_RESUME:
-                action_err = spotify_client_resume(handle->cfg.spotify);
-                break;
-            case INTENT_ROUTER_ACTION_SPOTIFY_VOLUME_DELTA:
-                action_err = spotify_client_volume_delta(handle->cfg.spotify, decision.volume_delta);
-                break;
-            case INTENT_ROUTER_ACTION_LIGHTS_OFF:
-                lights_off();
-                break;
-            case INTENT_ROUTER_ACTION_LIGHTS_ON:
-                lights_on();
-                break;
-            default:
-                break;
+        if (decision.action != INTENT_ROUTER_ACTION_NONE) {
+            action_err = execute_intent(handle, &decision);
+        }
+        // The reply task reports its own status, so the action's goes to the metrics here
+        if (handle->cfg.aws_bridge && decision.action != INTENT_ROUTER_ACTION_NONE) {
+            aws_iot_bridge_record_spotify_result(handle->cfg.aws_bridge, action_err);
         }
         
-        publish_interaction(handle, text, &decision, action_err);
+        if (!replying) {
+            publish_interaction(handle, text, &decision, action_err);
+        }
     }
 }
 
@@ -633,414 +1411,745 @@ static void realtime_error_cb(esp_err_t error, void *ctx)
     }
 }
 
-// Continuous audio streaming task (skips wake word)
-static void voice_pipeline_realtime_stream_task(void *arg)
+#ifdef GEMINI_ENABLED
+// Speech-to-speech replies carry their own transcript; it is only logged
+static void speech_transcript_cb(const char *text, bool is_final, void *ctx)
 {
-    voice_pipeline_handle_t handle = (voice_pipeline_handle_t)arg;
-    if (!handle || !handle->cfg.audio) {
-        vTaskDelete(NULL);
+    (void)ctx;
+    if (is_final) {
+        ESP_LOGI(TAG, "🔊 [OpenAI speech] Reply: \"%s\"", text);
+    }
+}
+
+// Reply audio goes to the voice ring as each delta decodes. This runs on the
+// WebSocket task, which waits here only while the ring is full; at the end
+// of the reply the ring may still be playing its tail.
+static void speech_audio_cb(const int16_t *pcm, size_t sample_count, void *ctx)
+{
+    voice_pipeline_handle_t handle = (voice_pipeline_handle_t)ctx;
+    if (!pcm) {
+        if (handle->speech_replying) {
+            handle->speech_replying = false;
+            interaction_cancel_end(handle->speech_token);
+            event_bus_publish_state(EVENT_BUS_TOPIC_PLAYBACK, false);
+            set_led_state(handle, LED_CONTROLLER_STATE_IDLE);
+            publish_interaction(handle, "speech-reply", NULL, ESP_OK);
+        }
         return;
     }
-    
-    ESP_LOGI(TAG, "Starting continuous audio monitoring with Gemini");
-    ESP_LOGI(TAG, "Pipeline: I2S -> AEC -> BSS/NS -> VAD -> Gemini Batch STT -> Gemini LLM -> Gemini TTS");
-    
-#ifdef GEMINI_ENABLED
-    handle->realtime_handle = gemini_realtime_start(
-        handle->cfg.sample_rate_hz,
-        realtime_transcript_cb,
-        realtime_error_cb,
-        handle
-    );
-    
-    if (!handle->realtime_handle) {
-        ESP_LOGE(TAG, "Failed to start Gemini realtime placeholder");
-        vTaskDelete(NULL);
+    if (!handle->speech_replying) {
+        // Where STT, LLM and TTS used to arrive one after another
+        interaction_trace_mark(INTERACTION_TRACE_TTS_FIRST_BYTE);
+        handle->speech_token = interaction_cancel_begin();
+        handle->speech_replying = true;
+        set_led_state(handle, LED_CONTROLLER_STATE_SPEAKING);
+        event_bus_publish_state(EVENT_BUS_TOPIC_PLAYBACK, true);
+    }
+    if (interaction_cancelled()) {
+        // Barged in on: drop the rest of this reply as it arrives
         return;
     }
+    esp_err_t err = audio_player_stream_submit(AUDIO_PLAYER_STREAM_VOICE, pcm, sample_count,
+                                               OPENAI_REALTIME_OUTPUT_RATE_HZ, 1);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "⚠️ [OpenAI speech] Dropped %zu reply samples (%s)", sample_count, esp_err_to_name(err));
+    }
+}
+
+// Ask the session task to open the cloud connections; never blocks the caller
+static void prewarm_cloud_sessions(voice_pipeline_handle_t handle)
+{
+    // The handshakes should not wait out a modem-sleep listen interval
+    radio_coex_prewarm();
+    if (handle->session_task) {
+        xTaskNotifyGive(handle->session_task);
+    }
+}
+
+#if CONFIG_KVA_TTS_CACHE
+// pick_response_text()'s fixed replies, cached before they are first needed
+static const char *const PRERENDER_PHRASES[] = {
+    "Sorry, I didn't catch that.",
+    "Playing Spotify.",
+    "Pausing Spotify.",
+    "Resuming Spotify.",
+    "Turning it up.",
+    "Turning it down.",
+    "Lights off.",
+    "Lights on.",
+    "Working on it.",
+};
+
+// Synthesize the first phrase the cache lacks without playing it; false once none is left
+static bool prerender_next_phrase(voice_pipeline_handle_t handle, wav_stream_player_t *player)
+{
+    for (size_t i = 0; i < sizeof(PRERENDER_PHRASES) / sizeof(PRERENDER_PHRASES[0]); ++i) {
+        const char *text = PRERENDER_PHRASES[i];
+        tts_cache_recorder_t *recorder =
+            tts_cache_record_begin(tts_cache_key(text, handle->cfg.tts_voice, GEMINI_TTS_MODEL), true);
+        if (!recorder) {
+            continue;
+        }
+        wav_stream_player_begin(player);
+        player->muted = true;
+        player->on_pcm = tts_cache_record_pcm;
+        player->on_pcm_ctx = recorder;
+        esp_err_t err = gemini_tts_generate_stream(text, handle->cfg.tts_voice, wav_stream_player_feed, player);
+        esp_err_t end_err = wav_stream_player_end(player, NULL);
+        if (err == ESP_OK) {
+            err = end_err;
+        }
+        esp_err_t store_err = tts_cache_record_end(recorder, err == ESP_OK);
+        if (err == ESP_OK) {
+            err = store_err;
+        }
+        if (err != ESP_OK) {
+            // Retried on a later sweep
+            ESP_LOGW(TAG, "Pre-rendering \"%s\" failed (%s)", text, esp_err_to_name(err));
+        }
+        return true;
+    }
+    return false;
+}
 #endif
-    
-    int16_t *frame_buffer = malloc(512 * sizeof(int16_t));
-    if (!frame_buffer) {
-        ESP_LOGE(TAG, "Failed to allocate frame buffer");
-#ifdef GEMINI_ENABLED
-        gemini_realtime_stop(handle->realtime_handle);
+
+// Runs the DNS/TCP/TLS handshakes in parallel with capture, and tears down
+// connections nobody used. Idle sweeps also fill the TTS cache, a phrase at a time
+static void session_task(void *arg)
+{
+    voice_pipeline_handle_t handle = arg;
+#if CONFIG_KVA_TTS_CACHE
+    wav_stream_player_t *player = MEM_TAG_MALLOC(MEM_TAG_VOICE_PIPELINE, sizeof(*player));
+#else
+    (void)handle;
+#endif
+    while (1) {
+        if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(VOICE_PIPELINE_SESSION_SWEEP_MS)) > 0) {
+            gemini_prewarm();
+        }
+#if CONFIG_KVA_TTS_CACHE
+        else if (player && !interaction_in_progress() && !prerender_next_phrase(handle, player)) {
+            MEM_TAG_FREE(MEM_TAG_VOICE_PIPELINE, player);
+            player = NULL;
+        }
+#endif
+        https_pool_close_idle();
+#if CONFIG_KVA_HTTP2_GOOGLEAPIS
+        h2_transport_close_idle();
 #endif
-        vTaskDelete(NULL);
-        return;
     }
-    
-    const size_t frame_samples = 512;
-    const TickType_t frame_delay = pdMS_TO_TICKS(20); // ~20ms frames
-    
+}
+
+// Open the Live session if needed. Audio sent right away is buffered by the
+// client until setup completes, so the first words are not lost.
+static bool live_session_ensure(voice_pipeline_handle_t handle)
+{
+    if (handle->realtime_handle || handle->speech_handle) {
+        return true;
+    }
+    if (!handle->live_available) {
+        return false;
+    }
+    if (handle->cfg.openai_speech) {
+        handle->speech_handle = openai_realtime_start_speech(handle->cfg.sample_rate_hz, uplink_codec_for(handle),
+                                                             speech_transcript_cb, speech_audio_cb,
+                                                             realtime_error_cb, handle);
+    } else {
+        handle->realtime_handle = gemini_realtime_start(handle->cfg.sample_rate_hz, realtime_transcript_cb,
+                                                        realtime_error_cb, handle);
+    }
+    if (!handle->realtime_handle && !handle->speech_handle) {
+        // The VAD branch accumulates speech for batch STT from now on
+        ESP_LOGW(TAG, "Failed to start the live session, falling back to batch STT");
+        handle->live_available = false;
+        return false;
+    }
+    handle->live_last_voice = xTaskGetTickCount();
+    return true;
+}
+
 #if CONFIG_KORVO_FARFIELD_WAKE_WORD_ENABLE
-    // AFE accumulator for processing pipeline: I2S -> AEC -> BSS/NS -> VAD
-    static int16_t afe_accumulator[2048];
-    static size_t afe_accumulator_count = 0;
-    int16_t *afe_processed_buffer = NULL;
-    handle->vad_active = false;
-    handle->vad_was_active = false;
-    
-    if (handle->afe_handle && handle->afe_data && handle->afe_feed_buffer) {
-        afe_processed_buffer = malloc(handle->afe_feed_chunksize * sizeof(int16_t));
-        ESP_LOGI(TAG, "AFE pipeline enabled: AEC -> BSS/NS -> VAD");
-        ESP_LOGI(TAG, "  feed_chunksize=%d, channels=%d", 
-                 handle->afe_feed_chunksize, handle->afe_feed_channels);
-        
-        // Allocate playback reference buffer for AEC if needed
-        // AEC needs reference signal from speaker output
-        handle->afe_playback_ref = NULL;
-        handle->afe_playback_ref_size = 0;
+static void live_close_task(void *arg)
+{
+    gemini_realtime_stop((gemini_realtime_handle_t)arg);
+    task_placement_note_exit(TASK_PLACEMENT_LIVE_CLOSE);
+    vTaskDelete(NULL);
+}
+
+static void speech_close_task(void *arg)
+{
+    openai_realtime_stop((openai_realtime_handle_t)arg);
+    task_placement_note_exit(TASK_PLACEMENT_LIVE_CLOSE);
+    vTaskDelete(NULL);
+}
+
+// Close the Live session after VOICE_PIPELINE_LIVE_IDLE_MS without speech.
+// The WebSocket teardown runs in its own task so the AFE loop keeps pace.
+static void live_session_close_if_idle(voice_pipeline_handle_t handle, TickType_t now)
+{
+    if ((!handle->realtime_handle && !handle->speech_handle) || handle->vad_was_active || handle->speech_replying ||
+        now - handle->live_last_voice < pdMS_TO_TICKS(VOICE_PIPELINE_LIVE_IDLE_MS)) {
+        return;
     }
+    ESP_LOGI(TAG, "Live session idle for %d s, closing it", VOICE_PIPELINE_LIVE_IDLE_MS / 1000);
+    if (handle->speech_handle) {
+        openai_realtime_handle_t speech = handle->speech_handle;
+        handle->speech_handle = NULL;
+        if (task_placement_create(TASK_PLACEMENT_LIVE_CLOSE, speech_close_task, speech, NULL) != pdPASS) {
+            openai_realtime_stop(speech);
+        }
+        return;
+    }
+    gemini_realtime_handle_t idle = handle->realtime_handle;
+    handle->realtime_handle = NULL;
+    if (task_placement_create(TASK_PLACEMENT_LIVE_CLOSE, live_close_task, idle, NULL) != pdPASS) {
+        gemini_realtime_stop(idle);
+    }
+}
+
+// Batch STT runs on one utterance at a time, read from afe_stage.speech_buffer
+static void batch_speech_append(const int16_t *samples, size_t count, void *ctx)
+{
+    afe_stage_t *stage = (afe_stage_t *)ctx;
+    if (stage->speech_samples + count > stage->speech_capacity) {
+        ESP_LOGW(TAG, "⚠️ [Gemini] Audio buffer full (%zu/%zu), dropping samples",
+                 stage->speech_samples, stage->speech_capacity);
+        count = stage->speech_capacity - stage->speech_samples;
+    }
+    memcpy(stage->speech_buffer + stage->speech_samples, samples, count * sizeof(int16_t));
+    stage->speech_samples += count;
+}
+
+// Batch path: collect the utterance, pre-roll first, and hand it to STT the
+// moment the gate closes it
+static void batch_speech_event(voice_pipeline_handle_t handle, vad_gate_event_t event, const int16_t *samples,
+                               size_t count)
+{
+    afe_stage_t *stage = &handle->afe_stage;
+    switch (event) {
+    case VAD_GATE_ONSET:
+        if (stage->speech_held) {
+            // A queued or running job has not transcribed the previous utterance yet
+            DLOGW(TAG, "⚠️ [Gemini] STT busy, ignoring utterance");
+            stage->speech_capturing = false;
+            break;
+        }
+        stage->speech_capturing = true;
+        stage->speech_samples = 0;
+        interaction_trace_begin(INTERACTION_TRACE_VAD_ONSET);
+        vad_gate_drain_preroll(&stage->vad, batch_speech_append, stage);
+        DLOGI(TAG, "🎙️ [Gemini] Speech started, accumulating audio for batch STT");
+        prewarm_cloud_sessions(handle);
+        break;
+    case VAD_GATE_SPEECH:
+        if (stage->speech_capturing) {
+            batch_speech_append(samples, count, stage);
+        }
+        break;
+    case VAD_GATE_END:
+        if (!stage->speech_capturing) {
+            break;
+        }
+        stage->speech_capturing = false;
+        if (handle->utterance_local) {
+            DLOGI(TAG, "🎙️ [Gemini] Speech ended, handled locally; skipping batch STT");
+            stage->speech_samples = 0;
+            break;
+        }
+        interaction_trace_mark(INTERACTION_TRACE_VAD_OFFSET);
+        DLOGI(TAG, "🎙️ [Gemini] Speech ended (%zu samples, %.2f sec), sending to batch STT",
+              stage->speech_samples, (float)stage->speech_samples / handle->cfg.sample_rate_hz);
+        // Empty text: the worker transcribes speech_buffer first. Uplink encoding
+        // runs there, off the AFE core; it resets speech_samples. Static to
+        // spare the AFE stack; the pool copies it
+        static gpt_tts_task_data_t job;
+        memset(&job, 0, sizeof(job));
+        job.handle = handle;
+        stage->speech_held = true;
+        if (interaction_pool_submit(handle->replies, &job) != ESP_OK) {
+            stage->speech_held = false;
+            stage->speech_samples = 0;
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+static void live_speech_send(const int16_t *samples, size_t count, void *ctx)
+{
+    voice_pipeline_handle_t handle = (voice_pipeline_handle_t)ctx;
+    esp_err_t err = handle->speech_handle ? openai_realtime_send_audio(handle->speech_handle, samples, count)
+                                          : gemini_realtime_send_audio(handle->realtime_handle, samples, count);
+    if (err != ESP_OK) {
+        DLOGW(TAG, "⚠️ [Gemini Live] Send error: %s", esp_err_to_name(err));
+    }
+}
+
+// Live path: stream the utterance, pre-roll first, and close the turn as
+// soon as the gate ends it so the reply does not wait on a timeout
+static void live_speech_event(voice_pipeline_handle_t handle, vad_gate_event_t event, const int16_t *samples,
+                              size_t count, TickType_t now)
+{
+    afe_stage_t *stage = &handle->afe_stage;
+    switch (event) {
+    case VAD_GATE_ONSET:
+        if (live_session_ensure(handle)) {
+            interaction_trace_begin(INTERACTION_TRACE_VAD_ONSET);
+            size_t preroll = vad_gate_drain_preroll(&stage->vad, live_speech_send, handle);
+            DLOGI(TAG, "🎙️ [Gemini Live] Speech started, %zu samples of pre-roll", preroll);
+            handle->vad_was_active = true;
+            handle->live_last_voice = now;
+        }
+        break;
+    case VAD_GATE_SPEECH:
+        if (handle->vad_was_active && (handle->realtime_handle || handle->speech_handle) && !handle->utterance_local) {
+            // Queued for the uplink task; the transcript streams back while the user speaks
+            live_speech_send(samples, count, handle);
+            handle->live_last_voice = now;
+        }
+        break;
+    case VAD_GATE_END:
+        if (handle->vad_was_active && handle->speech_handle) {
+            // The reply is generated from the audio itself; a local command gets none
+            interaction_trace_mark(INTERACTION_TRACE_VAD_OFFSET);
+            DLOGI(TAG, "🎙️ [OpenAI speech] Speech ended, %s",
+                  handle->utterance_local ? "dropping the turn" : "asking for a reply");
+            openai_realtime_end_audio(handle->speech_handle, !handle->utterance_local);
+        } else if (handle->vad_was_active && handle->realtime_handle) {
+            interaction_trace_mark(INTERACTION_TRACE_VAD_OFFSET);
+            DLOGI(TAG, "🎙️ [Gemini Live] Speech ended, closing the turn");
+            gemini_realtime_end_audio(handle->realtime_handle);
+        }
+        handle->vad_was_active = false;
+        break;
+    default:
+        handle->vad_was_active = false;
+        live_session_close_if_idle(handle, now);
+        break;
+    }
+}
 #endif
-    
-    while (1) {
-        // Capture audio frame
-        size_t samples_read = 0;
-        esp_err_t err = korvo_audio_capture(handle->cfg.audio, frame_buffer, frame_samples, 
-                                           &samples_read, pdMS_TO_TICKS(100));
-        
-        if (err != ESP_OK || samples_read == 0) {
-            vTaskDelay(frame_delay);
-            continue;
+#endif
+
+#if CONFIG_KORVO_FARFIELD_WAKE_WORD_ENABLE
+// MultiNet hears the speech frames of each utterance and is reset when it
+// ends; a recognised command is queued so the AFE loop never waits on it
+static void local_command_listen(voice_pipeline_handle_t handle, vad_gate_event_t event, bool is_speech,
+                                 const int16_t *samples, size_t count)
+{
+    if (event == VAD_GATE_END) {
+        local_commands_reset(handle->commands);
+        return;
+    }
+    if ((event == VAD_GATE_SILENCE && !is_speech) || handle->utterance_local) {
+        return;
+    }
+    local_command_msg_t msg;
+    if (!local_commands_feed(handle->commands, samples, count, &msg.decision, &msg.phrase)) {
+        return;
+    }
+    handle->utterance_local = true;
+    // "Stop" also silences the reply, here rather than after the queue
+    if (msg.decision.action == INTENT_ROUTER_ACTION_SPOTIFY_PAUSE && interaction_cancel_request()) {
+        ESP_LOGI(TAG, "\"%s\" interrupts the reply", msg.phrase);
+    }
+    if (xQueueSend(handle->command_queue, &msg, 0) != pdPASS) {
+        ESP_LOGW(TAG, "Local command queue full, dropping \"%s\"", msg.phrase);
+    }
+}
+
+static void local_command_task(void *arg)
+{
+    voice_pipeline_handle_t handle = (voice_pipeline_handle_t)arg;
+    local_command_msg_t msg;
+    while (xQueueReceive(handle->command_queue, &msg, portMAX_DELAY) == pdTRUE) {
+        esp_err_t err = execute_intent(handle, &msg.decision);
+        ESP_LOGI(TAG, "⚡ [Local] \"%s\" -> %s", msg.phrase, esp_err_to_name(err));
+        if (handle->cfg.aws_bridge) {
+            aws_iot_bridge_record_spotify_result(handle->cfg.aws_bridge, err);
         }
-        
-        // Compute mic levels and update LEDs (4, 8, 12) for sound reactivity
-        // Extract left/right channels from stereo audio
-        float mic1_level = 0.0f, mic2_level = 0.0f, mic3_level = 0.0f;
-        if (samples_read >= 2) {
-            // MIC1 = Left channel, MIC2 = Right channel, MIC3 = Combined
-            uint64_t sum1 = 0, sum2 = 0, sum3 = 0;
-            size_t count = 0;
-            for (size_t i = 0; i < samples_read && i < frame_samples; i += 2) {
-                if (i + 1 < samples_read) {
-                    int32_t val1 = frame_buffer[i];     // Left channel (MIC1)
-                    int32_t val2 = frame_buffer[i + 1]; // Right channel (MIC2)
-                    int32_t val3 = (val1 + val2) / 2;   // Combined (MIC3)
-                    
-                    // Use absolute values
-                    sum1 += val1 >= 0 ? val1 : -val1;
-                    sum2 += val2 >= 0 ? val2 : -val2;
-                    sum3 += val3 >= 0 ? val3 : -val3;
-                    count++;
-                }
-            }
-            mic1_level = count > 0 ? (float)sum1 / count : 0.0f;
-            mic2_level = count > 0 ? (float)sum2 / count : 0.0f;
-            mic3_level = count > 0 ? (float)sum3 / count : 0.0f;
+        publish_interaction(handle, msg.phrase, &msg.decision, err);
+    }
+    vTaskDelete(NULL);
+}
+#endif
+
+#if CONFIG_KORVO_FARFIELD_WAKE_WORD_ENABLE
+#if CONFIG_KVA_TURN_PREDICTOR
+// The AFE gate's end_early: called on the AFE node at each silent frame of a pause
+static bool afe_turn_complete(uint32_t silence_ms, void *ctx)
+{
+    voice_pipeline_handle_t handle = (voice_pipeline_handle_t)ctx;
+    if (!turn_predictor_should_end(handle->turns, silence_ms)) {
+        return false;
+    }
+    DLOGI(TAG, "End of turn after %u ms of silence (score %.2f), %u ms ahead of the hangover",
+          (unsigned)silence_ms, turn_predictor_score(handle->turns),
+          (unsigned)(VAD_GATE_HANGOVER_MS - silence_ms));
+    return true;
+}
+
+static void afe_turn_predictor_start(voice_pipeline_handle_t handle)
+{
+    turn_predictor_config_t cfg = {
+        .sample_rate = (uint32_t)handle->cfg.sample_rate_hz,
+        .threshold = CONFIG_KVA_TURN_PREDICTOR_THRESHOLD_PCT / 100.0f,
+        .min_silence_ms = CONFIG_KVA_TURN_PREDICTOR_MIN_SILENCE_MS,
+    };
+    // Without the partition, or with nothing flashed in it, the prosody weights stand in
+    if (model_loader_acquire(CONFIG_KVA_TURN_PREDICTOR_PARTITION, &handle->turn_model) == ESP_OK) {
+        cfg.model_data = handle->turn_model->data;
+        cfg.model_size = handle->turn_model->size;
+    }
+    handle->turns = turn_predictor_create(&cfg);
+    if (!handle->turns) {
+        ESP_LOGW(TAG, "End-of-turn predictor unavailable, utterances end after the full hangover");
+        if (handle->turn_model) {
+            model_loader_release(handle->turn_model);
+            handle->turn_model = NULL;
         }
+        return;
+    }
+    handle->afe_stage.vad.cfg.end_early = afe_turn_complete;
+    handle->afe_stage.vad.cfg.end_early_ctx = handle;
+}
+#endif
+
+// One AFE feed from the audio graph, assembled in the stage's mic_buffer:
+// I2S -> AEC -> BSS/NS -> VAD -> Gemini
+static void afe_node(void *ctx, const audio_graph_block_t *block)
+{
+    voice_pipeline_handle_t handle = (voice_pipeline_handle_t)ctx;
+    afe_stage_t *stage = &handle->afe_stage;
+    stage->feed_pos = block->pos;
+
+    // Chosen before this chunk, so a swap lands on the boundary after it
+    bool standby = __atomic_load_n(&handle->afe_standby_ready, __ATOMIC_ACQUIRE);
+    bool low_cost = afe_want_low_cost(handle, xTaskGetTickCount());
+    if (!standby && low_cost != handle->afe_low_cost_applied) {
+        afe_apply_low_cost(handle, low_cost);
+    }
+
+    // Feed to AFE pipeline: AEC -> BSS/NS -> VAD, with TTS/Spotify as the echo reference
+    int64_t afe_start_us = esp_timer_get_time();
+    afe_stage_add_reference(stage, handle->cfg.audio);
+    if (handle->afe_handle->feed(handle->afe_data, stage->feed_buffer) < 0) {
+        return;
+    }
+    // Step 3: Fetch processed audio, VAD state, and WakeNet detection
+    afe_fetch_result_t *fetch_result = handle->afe_handle->fetch(handle->afe_data);
+    if (fetch_result && fetch_result->ret_value == ESP_OK) {
+        TickType_t now = xTaskGetTickCount();
         
-        // Update microphone LEDs (4, 8, 12) for sound reactivity
-        update_mic_leds(mic1_level, mic2_level, mic3_level);
-        
-#if CONFIG_KORVO_FARFIELD_WAKE_WORD_ENABLE
-        // Process through AFE pipeline: I2S -> AEC -> BSS/NS -> VAD -> Gemini
-        if (handle->afe_handle && handle->afe_data && handle->afe_feed_buffer && afe_processed_buffer) {
-            // Step 1: Accumulate I2S samples for AFE feed
-            size_t to_copy = samples_read;
-            size_t accumulator_size = sizeof(afe_accumulator);
-            size_t element_size = sizeof(afe_accumulator[0]);
-            size_t max_elements = element_size > 0 ? accumulator_size / element_size : 0;
-            if (max_elements > 0 && afe_accumulator_count + to_copy > max_elements) {
-                to_copy = max_elements - afe_accumulator_count;
-            }
-            memcpy(&afe_accumulator[afe_accumulator_count], frame_buffer, to_copy * sizeof(int16_t));
-            afe_accumulator_count += to_copy;
-            
-            // Step 2: Feed to AFE when we have enough samples
-            // AFE processes: AEC -> BSS/NS -> VAD
-            int samples_per_feed = handle->afe_feed_chunksize * handle->afe_feed_channels;
-            // Prevent divide-by-zero: ensure samples_per_feed is valid
-            if (samples_per_feed <= 0) {
-                ESP_LOGE(TAG, "Invalid samples_per_feed: %d (chunksize=%d, channels=%d)", 
-                         samples_per_feed, handle->afe_feed_chunksize, handle->afe_feed_channels);
-                samples_per_feed = 512; // Default fallback
-            }
-            while (afe_accumulator_count >= samples_per_feed && samples_per_feed > 0) {
-                memcpy(handle->afe_feed_buffer, afe_accumulator, samples_per_feed * sizeof(int16_t));
+        // Check WakeNet wake word detection (parallel processing)
+        // Dual pipeline:
+        //   Path 1: I2S -> AEC -> BSS/NS -> VAD -> Gemini streaming/batch processing
+        //   Path 2: I2S -> AEC -> BSS/NS -> WakeNet -> Local Control (triggered on wake word)
+        if (handle->wakenet_model_name && fetch_result->wakeup_state == WAKENET_DETECTED) {
+            // Check cooldown to prevent multiple detections
+            if (now >= handle->wakenet_cooldown_until) {
+                int word_index = fetch_result->wake_word_index;
+                int triggered_channel = fetch_result->trigger_channel_id;
+                const char *wake_word = handle->wakenet_model_name ? handle->wakenet_model_name : "wake_word";
                 
-                // Feed to AFE pipeline: AEC -> BSS/NS -> VAD
-                // Note: AEC may require playback reference signal for echo cancellation
-                // For now, feed mic audio only (AEC will adapt or work in reference-free mode)
-                int feed_result = handle->afe_handle->feed(handle->afe_data, handle->afe_feed_buffer);
+                // Get human-readable wake word name
+                const char *wake_word_name = esp_wn_wakeword_from_name(wake_word);
+                const char *display_name = wake_word_name ? wake_word_name : wake_word;
                 
-                // If AEC requires playback reference, it would be fed here:
-                // handle->afe_handle->feed_reference(handle->afe_data, playback_samples);
-                if (feed_result >= 0) {
-                    // Step 3: Fetch processed audio, VAD state, and WakeNet detection
-                    afe_fetch_result_t *fetch_result = handle->afe_handle->fetch(handle->afe_data);
-                    if (fetch_result && fetch_result->ret_value == ESP_OK) {
-                        TickType_t now = xTaskGetTickCount();
-                        
-                        // Check WakeNet wake word detection (parallel processing)
-                        // Dual pipeline:
-                        //   Path 1: I2S -> AEC -> BSS/NS -> VAD -> Gemini streaming/batch processing
-                        //   Path 2: I2S -> AEC -> BSS/NS -> WakeNet -> Local Control (triggered on wake word)
-                        if (handle->wakenet_model_name && fetch_result->wakeup_state == WAKENET_DETECTED) {
-                            // Check cooldown to prevent multiple detections
-                            if (now >= handle->wakenet_cooldown_until) {
-                                int word_index = fetch_result->wake_word_index;
-                                int triggered_channel = fetch_result->trigger_channel_id;
-                                const char *wake_word = handle->wakenet_model_name ? handle->wakenet_model_name : "wake_word";
-                                
-                                // Get human-readable wake word name
-                                const char *wake_word_name = esp_wn_wakeword_from_name(wake_word);
-                                const char *display_name = wake_word_name ? wake_word_name : wake_word;
-                                
-                                ESP_LOGI(TAG, "*** WAKE WORD DETECTED (local control): %s (index=%d, channel=%d) ***", 
-                                         display_name, word_index, triggered_channel);
-                                
-                                // Trigger local control callback
-                                if (handle->wake_callback) {
-                                    handle->wake_callback(display_name, word_index, handle->wake_callback_ctx);
-                                }
-                                
-                                // Set cooldown (2 seconds)
-                                handle->wakenet_cooldown_until = now + pdMS_TO_TICKS(2000);
-                            }
-                        }
-                        
-                        // Check VAD state - only send to Gemini processing when speech is detected
-                        // VAD runs after AEC -> BSS/NS in the AFE pipeline
-                        bool vad_detected = false;
-                        static int vad_check_count = 0;
-                        
-                        // Try to access VAD state from fetch_result
-                        // ESP-SR AFE may expose VAD state in fetch_result
-                        // Common fields: vad_state, vad_result, or VAD flag
-                        #if 0
-                        // Uncomment if your ESP-SR version exposes VAD state
-                        if (fetch_result->vad_state == VAD_DETECTED || 
-                            fetch_result->vad_state == VAD_SPEECH ||
-                            fetch_result->vad_result == VAD_RESULT_SPEECH) {
-                            vad_detected = true;
-                        }
-                        #endif
-                        
-                        // Fallback: Energy-based VAD on AFE-processed audio
-                        // After AEC -> BSS/NS, audio should be cleaner
-                        // Use moderate threshold - AFE processing improves SNR but we want to be sensitive
-                        // VAD threshold - lower is more sensitive
-                        // Set to very low value to ensure audio passes through for testing
-                        static float vad_energy_threshold = 100.0f; // Very sensitive - will trigger on most audio
-                        float energy = 0.0f;
-                        
-                        // Check energy on processed audio (after AEC/NS)
-                        // Try to get processed audio from fetch_result if available
-                        int16_t *audio_to_check = afe_accumulator; // Fallback to input
-                        size_t samples_to_check = handle->afe_feed_chunksize;
-                        
-                        #if 0
-                        // If fetch_result->data contains processed audio, use that
-                        if (fetch_result->data && fetch_result->data_size > 0) {
-                            audio_to_check = (int16_t *)fetch_result->data;
-                            size_t size_check = sizeof(int16_t);
-                            if (size_check > 0) {
-                                samples_to_check = fetch_result->data_size / size_check;
-                            } else {
-                                samples_to_check = 0;
-                            }
-                        }
-                        #endif
-                        
-                        // Ensure samples_to_check is valid before loop
-                        if (samples_to_check > 0 && audio_to_check) {
-                            for (size_t i = 0; i < samples_to_check; i++) {
-                                int32_t val = audio_to_check[i];
-                                energy += val >= 0 ? val : -val;
-                            }
-                            energy = energy / (float)samples_to_check;
-                        } else {
-                            energy = 0.0f;
-                        }
-                        vad_detected = (energy > vad_energy_threshold);
-                        
-                        // TEMPORARY: For testing, allow audio through if energy is above a very low threshold
-                        // This ensures we can test the full pipeline even with quiet audio
-                        static bool vad_bypass_for_testing = true;
-                        if (vad_bypass_for_testing && energy > 50.0f) {
-                            vad_detected = true;
-                        }
-                        
-                        handle->vad_active = vad_detected;
-                        
-                        // Log energy levels periodically for debugging - very frequent for testing
-                        static int energy_log_count = 0;
-                        if (++energy_log_count % 20 == 0) {  // Every 20 AFE cycles = very frequent
-                            ESP_LOGI(TAG, "VAD energy: %.1f (threshold=%.1f, detected=%d, bypass=%d)", 
-                                    energy, vad_energy_threshold, vad_detected, vad_bypass_for_testing);
-                        }
-                        
-                        // Step 4: Handle audio based on AI provider
-                        if (handle->cfg.use_gemini && !handle->realtime_handle) {
-                            // Pipeline: I2S -> AEC -> BSS/NS -> VAD -> Gemini Batch STT
-                            // Gemini: Accumulate audio during speech, batch STT when speech ends
-                            if (vad_detected) {
-                                // Accumulate audio samples for batch STT
-                                int16_t *audio_to_accumulate = afe_accumulator;
-                                size_t samples_to_accumulate = handle->afe_feed_chunksize;
-                                
-                                // Allocate buffer if needed
-                                if (!handle->gemini_audio_buffer) {
-                                    // Validate sample_rate_hz to prevent overflow/divide-by-zero
-                                    if (handle->cfg.sample_rate_hz > 0 && handle->cfg.sample_rate_hz <= 48000) {
-                                        handle->gemini_audio_capacity = handle->cfg.sample_rate_hz * 5; // 5 seconds max
-                                        handle->gemini_audio_buffer = malloc(handle->gemini_audio_capacity * sizeof(int16_t));
-                                        handle->gemini_audio_samples = 0;
-                                    } else {
-                                        ESP_LOGE(TAG, "Invalid sample_rate_hz for audio buffer: %d", handle->cfg.sample_rate_hz);
-                                        handle->gemini_audio_capacity = 0;
-                                    }
-                                }
-                                
-                                // Add samples to buffer if space available
-                                if (handle->gemini_audio_buffer && 
-                                    handle->gemini_audio_samples + samples_to_accumulate <= handle->gemini_audio_capacity) {
-                                    memcpy(handle->gemini_audio_buffer + handle->gemini_audio_samples,
-                                           audio_to_accumulate,
-                                           samples_to_accumulate * sizeof(int16_t));
-                                    handle->gemini_audio_samples += samples_to_accumulate;
-                                    
-                                    // Log audio accumulation periodically
-                                    static int accumulate_log_count = 0;
-                                    if (++accumulate_log_count % 50 == 0) {  // Every ~1 second at 50Hz
-                                        float duration = (float)handle->gemini_audio_samples / handle->cfg.sample_rate_hz;
-                                        ESP_LOGI(TAG, "🎙️ [Gemini] Accumulating audio: %zu samples (%.2f sec)", 
-                                                handle->gemini_audio_samples, duration);
-                                    }
-                                } else if (!handle->gemini_audio_buffer) {
-                                    ESP_LOGW(TAG, "⚠️ [Gemini] Audio buffer not allocated, cannot accumulate");
-                                } else {
-                                    ESP_LOGW(TAG, "⚠️ [Gemini] Audio buffer full (%zu/%zu), dropping samples", 
-                                            handle->gemini_audio_samples, handle->gemini_audio_capacity);
-                                }
-                                
-                                if (!handle->vad_was_active) {
-                                    ESP_LOGI(TAG, "🎙️ [Gemini] Speech started, accumulating audio for batch STT");
-                                }
-                                handle->vad_was_active = true;
-                            } else if (handle->vad_was_active && handle->gemini_audio_samples > 0) {
-                                // Speech ended - process accumulated audio with batch STT
-                                float duration = (float)handle->gemini_audio_samples / handle->cfg.sample_rate_hz;
-                                ESP_LOGI(TAG, "🎙️ [Gemini] Speech ended (%zu samples, %.2f sec), sending to batch STT", 
-                                        handle->gemini_audio_samples, duration);
-                                
-                                // Process in background task to avoid blocking
-                                // Keep audio in handle buffer - task will process it
-                                static gpt_tts_task_data_t gemini_stt_task_data = {0};
-                                if (!gemini_stt_task_data.active) {
-                                    gemini_stt_task_data.handle = handle;
-                                    gemini_stt_task_data.text[0] = '\0'; // Signal to do STT first (empty = process audio buffer)
-                                    gemini_stt_task_data.active = true;
-                                    
-                                    // Trigger STT processing task (will read from handle->gemini_audio_buffer)
-                                    ESP_LOGI(TAG, "🎙️ [Gemini Live] Creating batch STT task...");
-                                    xTaskCreate(gpt_tts_response_task, "gemini_stt_task", 8192, &gemini_stt_task_data, 5, NULL);
-                                    // Note: Don't reset gemini_audio_samples here - task will reset it after processing
-                                } else {
-                                    ESP_LOGW(TAG, "⚠️ [Gemini Live] STT task already active, dropping audio");
-                                    handle->gemini_audio_samples = 0; // Reset to prevent buffer overflow
-                                }
-                                handle->vad_was_active = false;
-                            }
-                        } else {
-                            // Gemini realtime placeholder: record audio chunks when VAD detects speech
-                            if (vad_detected && handle->realtime_handle) {
-                                // Send AFE-processed audio (after AEC -> BSS/NS -> VAD) to Gemini placeholder
-                                int16_t *audio_to_send = afe_accumulator;
-                                size_t samples_to_send = handle->afe_feed_chunksize;
-                                
-                                // Try to get processed audio from fetch_result
-                                // AFE-processed audio is cleaner (AEC removed echo, NS removed noise)
-                                #if 0
-                                // Uncomment if fetch_result->data contains processed audio
-                                if (fetch_result->data && fetch_result->data_size > 0) {
-                                    audio_to_send = (int16_t *)fetch_result->data;
-                                    size_t size_check = sizeof(int16_t);
-                                    if (size_check > 0) {
-                                        samples_to_send = fetch_result->data_size / size_check;
-                                    } else {
-                                        samples_to_send = 0;
-                                    }
-                                }
-                                #endif
-                                
-                                // Send processed audio to Gemini realtime placeholder
-                                esp_err_t send_err = gemini_realtime_send_audio(handle->realtime_handle, audio_to_send, samples_to_send);
-                                
-                                static int vad_log_count = 0;
-                                static int audio_send_count = 0;
-                                audio_send_count++;
-                                
-                                if (++vad_log_count % 10 == 0) {  // Every ~200ms
-                                    float duration = (float)samples_to_send / handle->cfg.sample_rate_hz;
-                                    ESP_LOGI(TAG, "📤 [Gemini Live] Sending audio: %zu samples (%.3f sec), total chunks: %d", 
-                                            samples_to_send, duration, audio_send_count);
-                                    if (send_err != ESP_OK) {
-                                        ESP_LOGW(TAG, "⚠️ [Gemini Live] Send error: %s", esp_err_to_name(send_err));
-                                    }
-                                }
-                            } else if (!vad_detected) {
-                                static int vad_silence_count = 0;
-                                if (++vad_silence_count % 20 == 0) {  // More frequent for testing
-                                    ESP_LOGI(TAG, "⚠️ VAD INACTIVE: skipping Gemini streaming (energy=%.1f < threshold=%.1f)", 
-                                            energy, vad_energy_threshold);
-                                }
-                            }
-                        }
+                if (interaction_cancel_request()) {
+                    ESP_LOGI(TAG, "Wake word interrupts the reply");
+                }
+                // The command that follows gets the full front end
+                handle->afe_low_cost = false;
+                interaction_trace_begin(INTERACTION_TRACE_WAKE);
+                wake_capture_trigger(WAKE_CAPTURE_SOURCE_WAKENET, WAKE_CAPTURE_DETECTED, 1.0f, 0.0f);
+                ESP_LOGI(TAG, "*** WAKE WORD DETECTED (local control): %s (index=%d, channel=%d) ***", 
+                         display_name, word_index, triggered_channel);
+#if CONFIG_KVA_DOA_ENABLE
+                // The AFE picks its beam internally; log where the pair heard the talker next to it
+                if (handle->doa) {
+                    audio_doa_estimate_t doa;
+                    audio_doa_read(handle->doa, &doa);
+                    if (doa.active) {
+                        ESP_LOGI(TAG, "Talker at %.0f deg (confidence %.2f), AFE beam %d",
+                                 doa.angle_deg, doa.confidence, triggered_channel);
                     }
                 }
+#endif
+                
+                // Trigger local control callback
+                if (handle->wake_callback) {
+                    handle->wake_callback(display_name, word_index, handle->wake_callback_ctx);
+                }
                 
-                // Shift remaining samples
-                size_t remaining = afe_accumulator_count - samples_per_feed;
-                if (remaining > 0) {
-                    memmove(afe_accumulator, &afe_accumulator[samples_per_feed], 
-                           remaining * sizeof(int16_t));
+#ifdef GEMINI_ENABLED
+                // A command usually follows: open the sessions while the user talks
+                if (handle->live_available) {
+                    radio_coex_prewarm();
+                    live_session_ensure(handle);
+                    handle->live_last_voice = now;
+                } else {
+                    prewarm_cloud_sessions(handle);
                 }
-                afe_accumulator_count = remaining;
+#endif
+                
+                // Set cooldown (2 seconds)
+                handle->wakenet_cooldown_until = now + pdMS_TO_TICKS(2000);
             }
-        } else
+        }
+        
+        // Segment on the AFE output (after AEC -> BSS/NS) when it has one
+        const int16_t *speech = stage->mic_buffer;
+        size_t speech_count = (size_t)stage->chunksize;
+        if (fetch_result->data && fetch_result->data_size > 0) {
+            speech = fetch_result->data;
+            speech_count = (size_t)fetch_result->data_size / sizeof(int16_t);
+            audio_meter_feed_processed(speech, speech_count);
+            breath_monitor_feed(speech, speech_count);
+            wake_capture_feed_processed(speech, speech_count);
+        }
+        int afe_vote = stage->afe_vad ? (fetch_result->vad_state == VAD_SPEECH) : -1;
+        bool is_speech = vad_gate_classify(&stage->vad, speech, speech_count, afe_vote);
+        vad_gate_event_t vad_event = vad_gate_process(&stage->vad, speech, speech_count, is_speech);
+        handle->vad_active = vad_gate_in_speech(&stage->vad);
+        if (handle->vad_active) {
+            handle->afe_last_speech = now;
+        }
+        serial_link_tap_vad((uint8_t)vad_event, is_speech, handle->vad_active, stage->vad.last_energy,
+                            stage->vad.noise_floor);
+#if CONFIG_KVA_TURN_PREDICTOR
+        // It hears the utterance from onset to end, so at the next pause the gate can ask it
+        if (handle->turns) {
+            if (vad_event == VAD_GATE_ONSET) {
+                turn_predictor_begin(handle->turns);
+            }
+            if (vad_event == VAD_GATE_ONSET || vad_event == VAD_GATE_SPEECH) {
+                turn_predictor_push(handle->turns, speech, speech_count, is_speech);
+            }
+        }
 #endif
-        {
-            // No AFE - send raw audio directly to Gemini placeholder
-            // Resample to 24kHz if needed (simplified: just send as-is for now)
-            if (handle->realtime_handle) {
-                gemini_realtime_send_audio(handle->realtime_handle, frame_buffer, samples_read);
+#if CONFIG_KVA_DOA_ENABLE
+        // The same stereo the AFE was just fed; transformed only while the VAD hears speech
+        if (handle->doa) {
+            bool utterance_done = audio_doa_set_speech(handle->doa, handle->vad_active);
+            audio_doa_push(handle->doa, stage->mic_buffer, stage->mic_samples);
+            audio_doa_estimate_t doa;
+            audio_doa_read(handle->doa, &doa);
+            const event_bus_event_t direction = {
+                .topic = EVENT_BUS_TOPIC_DIRECTION,
+                .direction = {doa.angle_deg, doa.confidence, doa.active},
+            };
+            event_bus_publish(&direction);
+            if (utterance_done) {
+                ESP_LOGI(TAG, "Utterance from %.0f deg (confidence %.2f)",
+                         doa.utterance_deg, doa.utterance_confidence);
             }
         }
+#endif
+        if (vad_event == VAD_GATE_ONSET) {
+            // A new turn: its commands have not run yet
+            handle->utterance_local = false;
+            intent_router_stream_begin(&handle->partial_route);
+        }
+        if (handle->commands) {
+            // Path 3: I2S -> AEC -> BSS/NS -> VAD -> MultiNet -> Local Control
+            local_command_listen(handle, vad_event, is_speech, speech, speech_count);
+        }
+        DLOGV(TAG, "VAD: energy=%.1f floor=%.1f afe=%d event=%d", stage->vad.last_energy,
+              stage->vad.noise_floor, afe_vote, (int)vad_event);
         
-        vTaskDelay(frame_delay);
+        // Step 4: Handle audio based on AI provider
+        if (vad_event == VAD_GATE_ONSET && handle->live_available) {
+            live_session_ensure(handle);  // Clears live_available when Live cannot start
+        }
+        if (handle->cfg.use_gemini && !handle->live_available) {
+            // Pipeline: I2S -> AEC -> BSS/NS -> VAD -> Gemini Batch STT
+            batch_speech_event(handle, vad_event, speech, speech_count);
+        } else {
+            // Pipeline: I2S -> AEC -> BSS/NS -> VAD -> Gemini Live
+            live_speech_event(handle, vad_event, speech, speech_count, now);
+        }
+    }
+    if (standby) {
+        afe_profile_step(handle, low_cost && !handle->vad_active);
     }
+    cpu_profiler_note_afe_frame((uint32_t)(esp_timer_get_time() - afe_start_us), handle->afe_budget_us);
+}
+#endif
+
+// No AFE: the capture goes to Gemini Live as it is
+static void raw_uplink_node(void *ctx, const audio_graph_block_t *block)
+{
+    voice_pipeline_handle_t handle = (voice_pipeline_handle_t)ctx;
+    // Resample to 24kHz if needed (simplified: just send as-is for now)
+    if (live_session_ensure(handle)) {
+        gemini_realtime_send_audio(handle->realtime_handle, block->samples, block->count);
+    }
+}
+
+// Continuous streaming (skips wake word): the AFE, or the raw capture,
+// runs as a node of the audio graph rather than a capture loop of its own
+static esp_err_t voice_pipeline_realtime_stream_start(voice_pipeline_handle_t handle)
+{
+    ESP_LOGI(TAG, "Starting continuous audio monitoring with Gemini");
     
-    if (frame_buffer) free(frame_buffer);
+#ifdef GEMINI_ENABLED
+    // The session is opened at the first speech onset or wake word, not here
+    handle->live_available = true;
 #if CONFIG_KORVO_FARFIELD_WAKE_WORD_ENABLE
-    if (afe_processed_buffer) free(afe_processed_buffer);
+    bool vad_turns = handle->afe_handle && handle->afe_data && handle->afe_stage.feed_buffer;
+#else
+    bool vad_turns = false;
 #endif
-    vTaskDelete(NULL);
+    if (handle->cfg.openai_speech && !vad_turns) {
+        ESP_LOGW(TAG, "Speech-to-speech needs the AFE VAD to end turns, using Gemini Live");
+        handle->cfg.openai_speech = false;
+    }
+    if (handle->cfg.openai_speech) {
+        ESP_LOGI(TAG, "Pipeline: I2S -> AEC -> BSS/NS -> VAD -> OpenAI Realtime speech-to-speech");
+    } else {
+        ESP_LOGI(TAG, "Pipeline: I2S -> AEC -> BSS/NS -> VAD -> Gemini Live STT -> Gemini LLM -> Gemini TTS");
+    }
+#endif
+    
+#if CONFIG_KORVO_FARFIELD_WAKE_WORD_ENABLE
+    // Pipeline: I2S -> AEC -> BSS/NS -> VAD
+    afe_stage_t *stage = &handle->afe_stage;
+    handle->vad_active = false;
+    handle->vad_was_active = false;
+    if (handle->afe_handle && handle->afe_data && stage->feed_buffer) {
+        ESP_LOGI(TAG, "AFE pipeline enabled: AEC -> BSS/NS -> VAD");
+        ESP_LOGI(TAG, "  feed_chunksize=%d, channels=%d", 
+                 handle->afe_stage.chunksize, handle->afe_stage.channels);
+        // Each frame's feed-to-result work must fit in the audio it covers
+        handle->afe_budget_us = (uint32_t)((int64_t)stage->chunksize * 1000000 / handle->cfg.sample_rate_hz);
+        const audio_graph_node_config_t afe = {
+            .process = afe_node,
+            .ctx = handle,
+            .block_samples = stage->mic_samples,
+            .buffer = stage->mic_buffer,
+        };
+        esp_err_t err = audio_graph_attach(AUDIO_GRAPH_NODE_AFE, &afe);
+#if CONFIG_KVA_AFE_PROFILES
+        // The single-mic profile needs the loopback channel; without it only SE and NS can be switched off
+        if (err == ESP_OK && stage->ref_buffer &&
+            task_placement_create(TASK_PLACEMENT_AFE_STANDBY, afe_standby_task, handle, NULL) != pdPASS) {
+            ESP_LOGW(TAG, "Low-cost AFE builder not started");
+        }
+#endif
+        return err;
+    }
+#endif
+    const audio_graph_node_config_t raw = {
+        .process = raw_uplink_node,
+        .ctx = handle,
+        .block_samples = VOICE_PIPELINE_STREAM_FRAME_SAMPLES,
+        .buffer = handle->stream_frame,
+    };
+    return audio_graph_attach(AUDIO_GRAPH_NODE_RAW_UPLINK, &raw);
+}
+
+/**
+ * After a reply, wait up to cfg.follow_up_ms for the user to speak again.
+ * On speech the pre-roll is left in the turn gate and the reader open for
+ * the capture to continue from, so the first word is kept.
+ *
+ * @return false when the window closed quietly, or a wake or button event
+ *         arrived and takes over
+ */
+static bool follow_up_listen(voice_pipeline_handle_t handle, korvo_audio_reader_t **reader_out)
+{
+    if (handle->cfg.follow_up_ms <= 0) {
+        return false;
+    }
+    korvo_audio_reader_t *reader = NULL;
+    if (korvo_audio_open_reader(handle->cfg.audio, "follow_up", &reader) != ESP_OK) {
+        return false;
+    }
+#ifdef GEMINI_ENABLED
+    // The STT request of a follow-up should find its connection open
+    prewarm_cloud_sessions(handle);
+#endif
+    set_led_state(handle, LED_CONTROLLER_STATE_LISTENING);
+
+    vad_gate_t *gate = handle->turn_vad;
+    vad_gate_reset(gate);
+    int16_t frame[VOICE_PIPELINE_TURN_FRAME_SAMPLES];
+    bool started = false;
+    TickType_t start = xTaskGetTickCount();
+    while (!started && xTaskGetTickCount() - start < pdMS_TO_TICKS(handle->cfg.follow_up_ms) &&
+           uxQueueMessagesWaiting(handle->events) == 0) {
+        size_t read = 0;
+        if (korvo_audio_read(reader, frame, VOICE_PIPELINE_TURN_FRAME_SAMPLES, &read, pdMS_TO_TICKS(100)) !=
+                ESP_OK ||
+            read == 0) {
+            continue;
+        }
+        bool speech = vad_gate_classify(gate, frame, read, -1);
+        if (vad_gate_process(gate, frame, read, speech) == VAD_GATE_ONSET) {
+            interaction_trace_begin(INTERACTION_TRACE_VAD_ONSET);
+            started = true;
+        }
+    }
+
+    if (!started) {
+        korvo_audio_close_reader(reader);
+        set_led_state(handle, LED_CONTROLLER_STATE_IDLE);
+        return false;
+    }
+    ESP_LOGI(TAG, "Follow-up speech");
+    *reader_out = reader;
+    return true;
 }
 
 static void voice_pipeline_task(void *arg)
 {
     voice_pipeline_handle_t handle = (voice_pipeline_handle_t)arg;
     
-    // If realtime streaming is enabled, start continuous streaming task
-    if (handle->cfg.use_realtime_streaming && handle->cfg.skip_wake_word) {
-        voice_pipeline_realtime_stream_task(arg);
-        return;
-    }
-    
-    // Otherwise use traditional wake word + interaction flow
+    // Traditional wake word + interaction flow; realtime streaming runs on the audio graph
     voice_pipeline_event_msg_t evt;
     while (xQueueReceive(handle->events, &evt, portMAX_DELAY) == pdTRUE) {
         if (evt.type == VOICE_PIPELINE_EVENT_WAKE) {
-            voice_pipeline_process_interaction(handle);
+            korvo_audio_reader_t *follow_up = NULL;
+            bool replied;
+            do {
+                // Payloads, responses and cJSON trees of this interaction are released in one reset
+                interaction_arena_begin();
+                interaction_token_t token = interaction_cancel_begin();
+                replied = voice_pipeline_process_interaction(handle, follow_up);
+                interaction_cancel_end(token);
+                interaction_arena_end();
+                follow_up = NULL;
+            } while (replied && follow_up_listen(handle, &follow_up));
         } else if (evt.type == VOICE_PIPELINE_EVENT_BUTTON) {
+            interaction_token_t token = interaction_cancel_begin();
             voice_pipeline_process_button(handle, evt.button_id);
+            interaction_cancel_end(token);
         }
     }
     vTaskDelete(NULL);
 }
 
+#if CONFIG_KORVO_FARFIELD_WAKE_WORD_ENABLE
+// Without a MultiNet model every command simply goes through the cloud
+static void voice_pipeline_init_local_commands(voice_pipeline_handle_t handle)
+{
+    esp_err_t err = local_commands_create(handle->cfg.router->default_volume_step, &handle->commands);
+    if (err == ESP_OK) {
+        handle->command_queue = xQueueCreate(2, sizeof(local_command_msg_t));
+        if (!handle->command_queue) {
+            local_commands_destroy(handle->commands);
+            handle->commands = NULL;
+            err = ESP_ERR_NO_MEM;
+        }
+    }
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Local commands disabled (%s)", esp_err_to_name(err));
+    }
+}
+#endif
+
 voice_pipeline_handle_t voice_pipeline_create(const voice_pipeline_config_t *cfg)
 {
     ESP_RETURN_ON_FALSE(cfg && cfg->audio && cfg->router && cfg->spotify, NULL, TAG, "invalid config");
@@ -1056,28 +2165,54 @@ voice_pipeline_handle_t voice_pipeline_create(const voice_pipeline_config_t *cfg
         return NULL;
     }
     
-    handle->capture_samples = (cfg->sample_rate_hz * cfg->capture_ms) / 1000;
-    if (handle->capture_samples == 0) {
-        handle->capture_samples = cfg->sample_rate_hz / 2;
+    if (handle->cfg.capture_ms <= 0) {
+        handle->cfg.capture_ms = 500;
+    }
+    // Continuous streaming already takes every utterance as a turn
+    if (cfg->use_realtime_streaming) {
+        handle->cfg.follow_up_ms = 0;
     }
-    handle->capture_buffer = malloc(handle->capture_samples * sizeof(int16_t));
-    handle->tts_buffer_bytes = VOICE_PIPELINE_TTS_BUFFER_BYTES;
-    handle->tts_buffer = malloc(handle->tts_buffer_bytes);
+    bool turns = !(cfg->use_realtime_streaming && cfg->skip_wake_word);
+    if (turns) {
+        // Wake turns stream as they are spoken; a turn is at most as long as a batch utterance
+        const vad_gate_config_t turn_cfg = {
+            .sample_rate_hz = cfg->sample_rate_hz,
+            .preroll_ms = VAD_GATE_PREROLL_MS,
+            .onset_ms = VAD_GATE_ONSET_MS,
+            .hangover_ms = VAD_GATE_HANGOVER_MS,
+            .max_utterance_ms = VOICE_PIPELINE_SPEECH_MAX_SECONDS * 1000,
+        };
+        handle->turn_vad = MEM_TAG_CALLOC(MEM_TAG_VOICE_PIPELINE, 1, sizeof(vad_gate_t));
+        if (handle->turn_vad && vad_gate_init(handle->turn_vad, &turn_cfg) != ESP_OK) {
+            MEM_TAG_FREE(MEM_TAG_VOICE_PIPELINE, handle->turn_vad);
+            handle->turn_vad = NULL;
+        }
+    }
+    if (cfg->use_realtime_streaming) {
+        handle->stream_frame = MEM_TAG_MALLOC(MEM_TAG_VOICE_PIPELINE,
+                                              VOICE_PIPELINE_STREAM_FRAME_SAMPLES * sizeof(int16_t));
+    }
+    handle->tts_player = MEM_TAG_MALLOC(MEM_TAG_VOICE_PIPELINE, sizeof(*handle->tts_player));
     handle->events = xQueueCreate(8, sizeof(voice_pipeline_event_msg_t));
     handle->realtime_handle = NULL;
+    handle->speech_handle = NULL;
+    handle->live_available = false;
+    handle->session_task = NULL;
     handle->wake_callback = NULL;
     handle->wake_callback_ctx = NULL;
 #if CONFIG_KORVO_FARFIELD_WAKE_WORD_ENABLE
     handle->wakenet_cooldown_until = 0;
     handle->wakenet_model_name = NULL;
-    handle->gemini_audio_buffer = NULL;
-    handle->gemini_audio_samples = 0;
-    handle->gemini_audio_capacity = 0;
 #endif
     
-    if (!handle->capture_buffer || !handle->tts_buffer || !handle->events) {
-        free(handle->capture_buffer);
-        free(handle->tts_buffer);
+    if ((turns && !handle->turn_vad) || !handle->tts_player || !handle->events ||
+        (cfg->use_realtime_streaming && !handle->stream_frame)) {
+        if (handle->turn_vad) {
+            vad_gate_deinit(handle->turn_vad);
+            MEM_TAG_FREE(MEM_TAG_VOICE_PIPELINE, handle->turn_vad);
+        }
+        MEM_TAG_FREE(MEM_TAG_VOICE_PIPELINE, handle->stream_frame);
+        MEM_TAG_FREE(MEM_TAG_VOICE_PIPELINE, handle->tts_player);
         if (handle->events) {
             vQueueDelete(handle->events);
         }
@@ -1090,7 +2225,7 @@ voice_pipeline_handle_t voice_pipeline_create(const voice_pipeline_config_t *cfg
     // Pipeline: I2S -> AEC -> BSS/NS -> VAD -> Gemini streaming/batch
     if (cfg->use_realtime_streaming) {
         ESP_LOGI(TAG, "Initializing AFE pipeline: I2S -> AEC -> BSS/NS -> VAD -> Gemini processing");
-        srmodel_list_t *models = esp_srmodel_init("model");
+        srmodel_list_t *models = sr_models_get();
         if (models && models->num > 0) {
             // Filter for WakeNet models, prefer the configured model
             char *model_name = NULL;
@@ -1103,7 +2238,7 @@ voice_pipeline_handle_t voice_pipeline_create(const voice_pipeline_config_t *cfg
                 model_name = esp_srmodel_filter(models, ESP_WN_PREFIX, NULL);
             }
             if (model_name) {
-                afe_config_t *afe_config = afe_config_init("MM", models, AFE_TYPE_SR, AFE_MODE_HIGH_PERF);
+                afe_config_t *afe_config = afe_config_init(VOICE_PIPELINE_AFE_INPUT_FORMAT, models, AFE_TYPE_SR, AFE_MODE_HIGH_PERF);
                 if (afe_config) {
                     // Pipeline: I2S -> AEC -> BSS/NS -> VAD -> Gemini
                     // Configure AFE processing stages in order:
@@ -1142,7 +2277,7 @@ voice_pipeline_handle_t voice_pipeline_create(const voice_pipeline_config_t *cfg
                         ESP_LOGI(TAG, "WakeNet disabled - using VAD to gate Gemini processing only");
                     }
                     
-                    if (afe_parse_input_format("MM", &afe_config->pcm_config)) {
+                    if (afe_parse_input_format(VOICE_PIPELINE_AFE_INPUT_FORMAT, &afe_config->pcm_config)) {
                         afe_config->pcm_config.sample_rate = cfg->sample_rate_hz;
                         afe_config = afe_config_check(afe_config);
                         
@@ -1151,27 +2286,43 @@ voice_pipeline_handle_t voice_pipeline_create(const voice_pipeline_config_t *cfg
                             if (handle->afe_handle) {
                                 handle->afe_data = handle->afe_handle->create_from_config(afe_config);
                                 if (handle->afe_data) {
-                                    handle->afe_feed_chunksize = handle->afe_handle->get_feed_chunksize(handle->afe_data);
-                                    handle->afe_feed_channels = handle->afe_handle->get_feed_channel_num(handle->afe_data);
+                                    handle->afe_stage.chunksize = handle->afe_handle->get_feed_chunksize(handle->afe_data);
+                                    handle->afe_stage.channels = handle->afe_handle->get_feed_channel_num(handle->afe_data);
                                     
                                     // Validate AFE parameters to prevent divide-by-zero
-                                    if (handle->afe_feed_chunksize <= 0) {
-                                        ESP_LOGE(TAG, "Invalid AFE feed_chunksize: %d", handle->afe_feed_chunksize);
-                                        handle->afe_feed_chunksize = 512; // Default fallback
+                                    if (handle->afe_stage.chunksize <= 0) {
+                                        ESP_LOGE(TAG, "Invalid AFE feed_chunksize: %d", handle->afe_stage.chunksize);
+                                        handle->afe_stage.chunksize = 512; // Default fallback
                                     }
-                                    if (handle->afe_feed_channels <= 0) {
-                                        ESP_LOGE(TAG, "Invalid AFE feed_channels: %d", handle->afe_feed_channels);
-                                        handle->afe_feed_channels = 1; // Default fallback
+                                    if (handle->afe_stage.channels <= 0) {
+                                        ESP_LOGE(TAG, "Invalid AFE feed_channels: %d", handle->afe_stage.channels);
+                                        handle->afe_stage.channels = 1; // Default fallback
                                     }
                                     
-                                    handle->afe_feed_buffer = malloc(handle->afe_feed_chunksize * sizeof(int16_t) * handle->afe_feed_channels);
-                                    if (handle->afe_feed_buffer) {
+                                    if (afe_stage_alloc(&handle->afe_stage, cfg->sample_rate_hz) == ESP_OK) {
+                                        handle->afe_stage.afe_vad = afe_config->vad_init;
+                                        if (cfg->enable_local_commands) {
+                                            voice_pipeline_init_local_commands(handle);
+                                        }
+#if CONFIG_KVA_DOA_ENABLE
+                                        const audio_doa_config_t doa_cfg = {
+                                            .sample_rate = (uint32_t)cfg->sample_rate_hz,
+                                            .mic_spacing_mm = CONFIG_KVA_DOA_MIC_SPACING_MM,
+                                        };
+                                        handle->doa = audio_doa_create(&doa_cfg);
+                                        if (!handle->doa) {
+                                            ESP_LOGW(TAG, "DOA estimator unavailable, continuing without talker direction");
+                                        }
+#endif
+#if CONFIG_KVA_TURN_PREDICTOR
+                                        afe_turn_predictor_start(handle);
+#endif
                                         handle->wakenet_model_name = cfg->wakenet_model ? strdup(cfg->wakenet_model) : NULL;
                                         handle->wakenet_cooldown_until = 0;
                                         
                                         // Set WakeNet threshold if enabled
                                         if (afe_config->wakenet_init && cfg->wakenet_threshold > 0 && cfg->wakenet_threshold <= 100) {
-                                            float det_threshold = 0.4f + (cfg->wakenet_threshold / 100.0f) * 0.5999f;
+                                            float det_threshold = afe_wakenet_threshold(cfg->wakenet_threshold);
                                             handle->afe_handle->set_wakenet_threshold(handle->afe_data, 1, det_threshold);
                                             ESP_LOGI(TAG, "WakeNet threshold set to %.3f (config=%d)", det_threshold, cfg->wakenet_threshold);
                                         }
@@ -1194,7 +2345,6 @@ voice_pipeline_handle_t voice_pipeline_create(const voice_pipeline_config_t *cfg
                     }
                 }
             }
-            esp_srmodel_deinit(models);
         }
     }
 #endif
@@ -1205,16 +2355,58 @@ voice_pipeline_handle_t voice_pipeline_create(const voice_pipeline_config_t *cfg
 esp_err_t voice_pipeline_start(voice_pipeline_handle_t handle)
 {
     ESP_RETURN_ON_FALSE(handle && handle->events, ESP_ERR_INVALID_ARG, TAG, "invalid handle");
-    if (handle->task) {
+    if (handle->task || handle->streaming) {
         return ESP_ERR_INVALID_STATE;
     }
-    BaseType_t rc = xTaskCreatePinnedToCore(voice_pipeline_task,
-                                            "voice_pipeline",
-                                            8192,
-                                            handle,
-                                            4,
-                                            &handle->task,
-                                            tskNO_AFFINITY);
+#if CONFIG_KORVO_FARFIELD_WAKE_WORD_ENABLE
+    // Before the AFE loop starts feeding commands to it
+    if (handle->commands &&
+        task_placement_create(TASK_PLACEMENT_LOCAL_COMMANDS, local_command_task, handle,
+                              &handle->command_task) != pdPASS) {
+        ESP_LOGW(TAG, "Local command task create failed, commands go through the cloud");
+        local_commands_destroy(handle->commands);
+        handle->commands = NULL;
+    }
+#endif
+    // Before anything can produce a transcript
+    interaction_pool_config_t pool_cfg = {
+        .run = gpt_tts_response_job,
+        .drop = gpt_tts_drop_job,
+        .job_size = sizeof(gpt_tts_task_data_t),
+        .queue_depth = CONFIG_KVA_INTERACTION_QUEUE_DEPTH,
+        .workers = CONFIG_KVA_INTERACTION_WORKERS,
+        .placement = TASK_PLACEMENT_INTERACTION_WORKER,
+        .when_full = INTERACTION_POOL_DROP_OLDEST,
+        .psram_stacks = CONFIG_KVA_INTERACTION_PSRAM_STACKS,
+    };
+    if (!handle->replies && interaction_pool_create(&pool_cfg, &handle->replies) != ESP_OK) {
+        ESP_LOGW(TAG, "No reply workers; transcripts are only routed to local intents");
+    }
+    uint32_t providers = openai_has_api_key() ? 1u << PROVIDER_ROUTER_OPENAI : 0;
+#ifdef GEMINI_ENABLED
+    providers |= 1u << PROVIDER_ROUTER_GEMINI;
+#endif
+    provider_router_init(handle->cfg.use_gemini ? PROVIDER_ROUTER_GEMINI : PROVIDER_ROUTER_OPENAI, providers);
+#ifdef GEMINI_ENABLED
+    if (tool_dispatch_init() != ESP_OK) {
+        ESP_LOGW(TAG, "No tool workers; a reply's function calls run one after another");
+    }
+#endif
+    BaseType_t rc;
+    if (handle->cfg.use_realtime_streaming && handle->cfg.skip_wake_word) {
+        handle->streaming = voice_pipeline_realtime_stream_start(handle) == ESP_OK;
+        rc = handle->streaming ? pdPASS : pdFAIL;
+    } else {
+        rc = task_placement_create(TASK_PLACEMENT_AFE, voice_pipeline_task, handle, &handle->task);
+    }
+#ifdef GEMINI_ENABLED
+    // Handshakes sit next to Wi-Fi/lwIP; a missing task only costs the prewarm
+    if (rc == pdPASS && handle->cfg.use_gemini &&
+        task_placement_create(TASK_PLACEMENT_CLOUD_SESSION, session_task, handle, &handle->session_task) != pdPASS) {
+        ESP_LOGW(TAG, "Cloud session task create failed, connections open on first request");
+        handle->session_task = NULL;
+    }
+#endif
     return rc == pdPASS ? ESP_OK : ESP_FAIL;
 }
 
@@ -1223,6 +2415,28 @@ void voice_pipeline_handle_wake(voice_pipeline_handle_t handle)
     if (!handle || !handle->events) {
         return;
     }
+    if (interaction_cancel_request()) {
+        ESP_LOGI(TAG, "Wake interrupts the reply");
+    }
+#if CONFIG_KVA_WAKE_ARBITER
+    float doa_confidence = 0.0f;
+#if CONFIG_KORVO_FARFIELD_WAKE_WORD_ENABLE && CONFIG_KVA_DOA_ENABLE
+    if (handle->doa) {
+        audio_doa_estimate_t doa;
+        audio_doa_read(handle->doa, &doa);
+        doa_confidence = doa.active ? doa.confidence : 0.0f;
+    }
+#endif
+    // Another unit nearer the talker takes it: no capture, no cloud session
+    if (!wake_arbiter_contend(doa_confidence)) {
+        return;
+    }
+#endif
+    interaction_trace_begin(INTERACTION_TRACE_WAKE);
+#ifdef GEMINI_ENABLED
+    // DNS/TCP/TLS run while the utterance is being captured
+    prewarm_cloud_sessions(handle);
+#endif
     voice_pipeline_event_msg_t evt = {
         .type = VOICE_PIPELINE_EVENT_WAKE,
         .button_id = 0,
@@ -1237,6 +2451,11 @@ void voice_pipeline_handle_button(voice_pipeline_handle_t handle, int button_id)
     if (!handle || !handle->events) {
         return;
     }
+    if (interaction_cancel_request()) {
+        // A press during a reply only stops it
+        ESP_LOGI(TAG, "Button %d interrupts the reply", button_id);
+        return;
+    }
     voice_pipeline_event_msg_t evt = {
         .type = VOICE_PIPELINE_EVENT_BUTTON,
         .button_id = button_id,
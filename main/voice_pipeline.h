@@ -5,6 +5,7 @@
 #include "korvo_audio.h"
 #include "led_controller.h"
 #include "spotify_client.h"
+#include "uplink_codec.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -19,14 +20,19 @@ typedef struct {
     aws_iot_bridge_t *aws_bridge;
     led_controller_t *leds;
     int sample_rate_hz;
-    int capture_ms;
+    int capture_ms;                // Longest a wake turn waits for speech to start
+    int follow_up_ms;              // Listen this long after a reply for a turn without a wake word; 0 disables
     const char *tts_voice;
     bool use_realtime_streaming;  // Use continuous streaming mode (Gemini batch/live monitoring)
     bool skip_wake_word;           // Skip wake word detection, stream continuously
     bool enable_wakenet_local;     // Enable WakeNet in parallel for local control
     const char *wakenet_model;     // WakeNet model name (e.g., "wn9_hiesp")
     int wakenet_threshold;          // WakeNet detection threshold (0-100)
+    bool enable_local_commands;     // MultiNet command grammar in the AFE loop; commands skip the cloud
     bool use_gemini;                // Use Gemini AI instead of OpenAI for STT-LLM-TTS
+    bool pipelined_tts;             // Speak each sentence while the LLM is still generating
+    uplink_codec_id_t uplink_codec; // Wire format for audio sent to cloud STT
+    bool openai_speech;             // Live turns go to OpenAI Realtime, which answers in speech: no LLM or TTS request
 } voice_pipeline_config_t;
 
 // Callback for local wake word detection (parallel to streaming)
@@ -36,6 +42,15 @@ voice_pipeline_handle_t voice_pipeline_create(const voice_pipeline_config_t *cfg
 esp_err_t voice_pipeline_start(voice_pipeline_handle_t handle);
 void voice_pipeline_handle_wake(voice_pipeline_handle_t handle);
 void voice_pipeline_handle_button(voice_pipeline_handle_t handle, int button_id);
+/**
+ * Allow the AFE's low-cost profile: one mic and no beamforming or noise
+ * suppression, its two costliest stages; AEC, VAD and WakeNet stay on. For
+ * an empty or sleeping room. It takes over once nobody has spoken for
+ * CONFIG_KVA_AFE_LOW_COST_QUIET_MS, speech onset brings back the full front
+ * end for the utterance, and a wake word clears the request. Applied by the
+ * AFE task on a chunk boundary; callable from any task.
+ */
+void voice_pipeline_set_afe_low_cost(voice_pipeline_handle_t handle, bool low_cost);
 void voice_pipeline_set_wake_callback(voice_pipeline_handle_t handle, voice_pipeline_wake_callback_t callback, void *ctx);
 
 #ifdef __cplusplus
@@ -0,0 +1,219 @@
+#include "wake_arbiter.h"
+
+#include <inttypes.h>
+#include <string.h>
+
+#include "esp_check.h"
+#include "esp_log.h"
+#include "esp_mac.h"
+#include "esp_now.h"
+#include "esp_timer.h"
+#include "esp_wifi.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#define BID_MAGIC 0x4e574131u         // "NWA1"
+#define WINDOW_US ((int64_t)CONFIG_KVA_WAKE_ARBITER_WINDOW_MS * 1000)
+// Bids for one utterance land at most this far apart: detectors fire a few
+// frames apart, and sound crosses a house in tens of milliseconds
+#define LOOKBACK_US (WINDOW_US * 4)
+// A noted detection older than this belongs to another wake
+#define NOTE_MAX_AGE_US 1000000
+#define MAX_PEERS 8
+
+typedef struct __attribute__((packed)) {
+    uint32_t magic;
+    uint32_t home;                    // FNV-1a of the SSID
+    int16_t snr_q4;                   // dB x 16
+    uint8_t score_q8;                 // 0..255 for 0..1
+    uint8_t doa_q8;
+} bid_packet_t;
+
+typedef struct {
+    uint8_t mac[ESP_NOW_ETH_ALEN];
+    bid_packet_t bid;
+    int64_t received_us;              // 0 = empty slot
+} peer_bid_t;
+
+static const char *TAG = "wake_arbiter";
+static const uint8_t BROADCAST_MAC[ESP_NOW_ETH_ALEN] = {0xff, 0xff, 0xff, 0xff, 0xff, 0xff};
+
+static bool s_ready;
+static uint32_t s_home;
+static uint8_t s_mac[ESP_NOW_ETH_ALEN];
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+// Latest bid per peer, written from the Wi-Fi task
+static peer_bid_t s_peers[MAX_PEERS];
+// Written by the detector task just before the wake callback
+static float s_noted_score;
+static float s_noted_snr_db;
+static int64_t s_noted_us;
+
+static uint32_t home_id(void)
+{
+    wifi_config_t cfg = {0};
+    if (esp_wifi_get_config(WIFI_IF_STA, &cfg) != ESP_OK) {
+        return 0;
+    }
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < sizeof(cfg.sta.ssid) && cfg.sta.ssid[i]; ++i) {
+        hash = (hash ^ cfg.sta.ssid[i]) * 16777619u;
+    }
+    return hash;
+}
+
+static uint8_t quantize_unit(float v)
+{
+    if (v <= 0.0f) {
+        return 0;
+    }
+    return v >= 1.0f ? 255 : (uint8_t)(v * 255.0f + 0.5f);
+}
+
+static int16_t quantize_db(float db)
+{
+    if (db < -100.0f) {
+        db = -100.0f;
+    } else if (db > 100.0f) {
+        db = 100.0f;
+    }
+    return (int16_t)(db * 16.0f);
+}
+
+// In 1/16 dB: a full detector score is worth 10 dB of SNR, a sure direction 6 dB
+static int32_t merit(const bid_packet_t *bid)
+{
+    return bid->snr_q4 + bid->score_q8 * 160 / 255 + bid->doa_q8 * 96 / 255;
+}
+
+static bool outranks(const bid_packet_t *a, const uint8_t *a_mac, const bid_packet_t *b, const uint8_t *b_mac)
+{
+    int32_t merit_a = merit(a);
+    int32_t merit_b = merit(b);
+    if (merit_a != merit_b) {
+        return merit_a > merit_b;
+    }
+    return memcmp(a_mac, b_mac, ESP_NOW_ETH_ALEN) < 0;
+}
+
+// Wi-Fi task: keep it to a copy
+static void on_recv(const esp_now_recv_info_t *info, const uint8_t *data, int len)
+{
+    bid_packet_t bid;
+    if (len != sizeof(bid)) {
+        return;
+    }
+    memcpy(&bid, data, sizeof(bid));
+    if (bid.magic != BID_MAGIC || bid.home != s_home) {
+        return;
+    }
+    int64_t now_us = esp_timer_get_time();
+    portENTER_CRITICAL(&s_lock);
+    // The peer's own slot, else the stalest
+    peer_bid_t *slot = &s_peers[0];
+    for (int i = 0; i < MAX_PEERS; ++i) {
+        if (memcmp(s_peers[i].mac, info->src_addr, ESP_NOW_ETH_ALEN) == 0) {
+            slot = &s_peers[i];
+            break;
+        }
+        if (s_peers[i].received_us < slot->received_us) {
+            slot = &s_peers[i];
+        }
+    }
+    memcpy(slot->mac, info->src_addr, ESP_NOW_ETH_ALEN);
+    slot->bid = bid;
+    slot->received_us = now_us;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+void wake_arbiter_note_detection(float score, float snr_db)
+{
+    s_noted_score = score;
+    s_noted_snr_db = snr_db;
+    s_noted_us = esp_timer_get_time();
+}
+
+esp_err_t wake_arbiter_init(void)
+{
+#if CONFIG_KVA_WAKE_ARBITER
+    if (s_ready) {
+        return ESP_OK;
+    }
+    ESP_RETURN_ON_ERROR(esp_now_init(), TAG, "esp_now init");
+    esp_now_peer_info_t peer = {
+        .channel = 0,                 // Whatever channel the AP is on
+        .ifidx = WIFI_IF_STA,
+        .encrypt = false,
+    };
+    memcpy(peer.peer_addr, BROADCAST_MAC, ESP_NOW_ETH_ALEN);
+    esp_err_t err = esp_now_register_recv_cb(on_recv);
+    if (err == ESP_OK) {
+        err = esp_now_add_peer(&peer);
+    }
+    if (err == ESP_OK) {
+        err = esp_read_mac(s_mac, ESP_MAC_WIFI_STA);
+    }
+    if (err != ESP_OK) {
+        esp_now_deinit();
+        ESP_LOGE(TAG, "ESP-NOW setup: %s", esp_err_to_name(err));
+        return err;
+    }
+    s_home = home_id();
+    s_ready = true;
+    ESP_LOGI(TAG, "Wake arbitration on (home %08" PRIx32 ", %d ms window)", s_home,
+             CONFIG_KVA_WAKE_ARBITER_WINDOW_MS);
+    return ESP_OK;
+#else
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
+bool wake_arbiter_contend(float doa_confidence)
+{
+    if (!s_ready) {
+        return true;
+    }
+    int64_t start_us = esp_timer_get_time();
+    // Without a fresh measurement (a button or simulated wake) bid as unmeasured
+    bool noted = start_us - s_noted_us < NOTE_MAX_AGE_US;
+    const bid_packet_t mine = {
+        .magic = BID_MAGIC,
+        .home = s_home,
+        .snr_q4 = noted ? quantize_db(s_noted_snr_db) : 0,
+        .score_q8 = noted ? quantize_unit(s_noted_score) : 255,
+        .doa_q8 = quantize_unit(doa_confidence),
+    };
+    esp_err_t err = esp_now_send(BROADCAST_MAC, (const uint8_t *)&mine, sizeof(mine));
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Bid not sent (%s), answering", esp_err_to_name(err));
+        return true;
+    }
+    vTaskDelay(pdMS_TO_TICKS(CONFIG_KVA_WAKE_ARBITER_WINDOW_MS));
+
+    bool win = true;
+    int peers = 0;
+    uint8_t winner[ESP_NOW_ETH_ALEN] = {0};
+    portENTER_CRITICAL(&s_lock);
+    for (int i = 0; i < MAX_PEERS; ++i) {
+        const peer_bid_t *peer = &s_peers[i];
+        // Negative while the bid arrived inside our window
+        int64_t age_us = start_us - peer->received_us;
+        if (!peer->received_us || age_us > LOOKBACK_US) {
+            continue;
+        }
+        peers++;
+        // A bid a whole window ahead of ours was settled without us
+        if (win && (age_us > WINDOW_US || outranks(&peer->bid, peer->mac, &mine, s_mac))) {
+            win = false;
+            memcpy(winner, peer->mac, ESP_NOW_ETH_ALEN);
+        }
+    }
+    portEXIT_CRITICAL(&s_lock);
+
+    if (!win) {
+        ESP_LOGI(TAG, "Wake goes to " MACSTR " (%d peer bids)", MAC2STR(winner), peers);
+    } else if (peers) {
+        ESP_LOGI(TAG, "Won the wake over %d peer bids (SNR %.1f dB)", peers, mine.snr_q4 / 16.0f);
+    }
+    return win;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <stdbool.h>
+
+#include "esp_err.h"
+#include "kva_config_defaults.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * One answer per utterance in a home with several units. On a wake, each
+ * device broadcasts a bid over ESP-NOW (no AP round trip) and listens for
+ * CONFIG_KVA_WAKE_ARBITER_WINDOW_MS; only the best-placed device goes on to
+ * capture and stream, the others drop the wake. Devices on the same SSID
+ * form one home.
+ *
+ * A bid ranks by SNR of the wake word over the device's own noise floor,
+ * with detector score and direction confidence to break near ties; an
+ * exact tie goes to the lower MAC. Every device ranks the same quantized
+ * fields, so all of them agree on the winner.
+ *
+ * Arbitration fails open: without ESP-NOW, or if no peer is heard (a peer
+ * in modem sleep can miss the broadcast), the device answers as before.
+ */
+
+// Record the detector's measurement of the wake about to be handled. Detector task.
+void wake_arbiter_note_detection(float score, float snr_db);
+
+// Start ESP-NOW on the station interface; call once Wi-Fi has started
+esp_err_t wake_arbiter_init(void);
+
+/**
+ * Bid for the wake just detected with the last noted detection and
+ * doa_confidence (0 without a direction estimate), and wait out the window.
+ *
+ * @return false when another device in the home answers this wake
+ */
+bool wake_arbiter_contend(float doa_confidence);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,365 @@
+#include "wake_capture.h"
+
+#include <string.h>
+
+#include "esp_check.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "kva_config_defaults.h"
+#include "serial_link.h"
+#include "task_placement.h"
+
+#define WAKE_CAPTURE_RAW_CHANNELS 2       // korvo_audio captures interleaved stereo
+#define WAKE_CAPTURE_SEND_WAIT_MS 200     // Per frame; a slower port loses audio instead
+#define WAKE_CAPTURE_RUN_GAP_MS 300       // A near-miss run ends after this long below the mark
+#define WAKE_CAPTURE_AFE_LAG_MS 300       // How long to wait for the AFE track to catch up
+#define WAKE_CAPTURE_SCORE_RING 256       // Power of two; ~4 s of energy-detector frames
+#define WAKE_CAPTURE_CHUNK_BYTES (SERIAL_LINK_MAX_PAYLOAD - sizeof(serial_link_capture_audio_t))
+#define WAKE_CAPTURE_RAW_CHUNK_SAMPLES \
+    (WAKE_CAPTURE_CHUNK_BYTES / (sizeof(int16_t) * WAKE_CAPTURE_RAW_CHANNELS) * WAKE_CAPTURE_RAW_CHANNELS)
+#define WAKE_CAPTURE_PROC_CHUNK_SAMPLES (WAKE_CAPTURE_CHUNK_BYTES / sizeof(int16_t))
+
+_Static_assert((WAKE_CAPTURE_SCORE_RING & (WAKE_CAPTURE_SCORE_RING - 1)) == 0, "score ring must be a power of two");
+
+typedef struct {
+    wake_capture_source_t source;
+    wake_capture_outcome_t outcome;
+    float score;
+    float threshold;
+    uint32_t time_ms;
+    uint32_t raw_pos;                 // Capture ring position at the event
+    uint32_t proc_pos;                // AFE track position at the event
+} wake_capture_event_t;
+
+typedef struct {
+    uint32_t pos;                     // Capture ring position the score was computed at
+    float score;
+} wake_capture_score_entry_t;
+
+static const char *TAG = "wake_capture";
+
+static korvo_audio_t *s_audio;        // Set last by init (atomic); NULL until then
+static korvo_audio_reader_t *s_reader;
+static QueueHandle_t s_events;
+static bool s_busy;                   // A window is being sent (atomic)
+static uint16_t s_next_id;
+static uint32_t s_preroll_frames;
+static uint32_t s_postroll_frames;
+
+// AFE track: written by the AFE task, read by the sender
+static int16_t *s_proc;
+static uint32_t s_proc_mask;
+static uint32_t s_proc_write;         // Monotonic samples written (atomic)
+static uint32_t s_proc_valid_from;    // First sample since the host subscribed (atomic)
+static bool s_proc_live;              // AFE track is being fed; written by the AFE task (atomic)
+
+// Energy-detector scores: written by the wake-word task, read by the sender
+static wake_capture_score_entry_t s_scores[WAKE_CAPTURE_SCORE_RING];
+static uint32_t s_score_write;        // Monotonic entries written (atomic)
+
+// Near-miss tracking, wake-word task only
+static struct {
+    bool active;
+    bool fired;                       // The run already produced a detection
+    float peak;
+    float threshold;
+    int64_t last_near_us;
+} s_run;
+
+// Sender task only
+static int16_t s_chunk[WAKE_CAPTURE_RAW_CHUNK_SAMPLES > WAKE_CAPTURE_PROC_CHUNK_SAMPLES
+                           ? WAKE_CAPTURE_RAW_CHUNK_SAMPLES
+                           : WAKE_CAPTURE_PROC_CHUNK_SAMPLES];
+static serial_link_capture_score_t s_window_scores[UINT8_MAX];
+
+bool wake_capture_armed(void)
+{
+    return __atomic_load_n(&s_audio, __ATOMIC_ACQUIRE) && serial_link_wants(SERIAL_LINK_STREAM_WAKE_CAPTURE);
+}
+
+void wake_capture_trigger(wake_capture_source_t source, wake_capture_outcome_t outcome, float score,
+                          float threshold)
+{
+    if (!wake_capture_armed()) {
+        return;
+    }
+    if (__atomic_exchange_n(&s_busy, true, __ATOMIC_ACQ_REL)) {
+        ESP_LOGD(TAG, "Window in flight, event dropped");
+        return;
+    }
+    wake_capture_event_t ev = {
+        .source = source,
+        .outcome = outcome,
+        .score = score,
+        .threshold = threshold,
+        .time_ms = (uint32_t)(esp_timer_get_time() / 1000),
+        .raw_pos = korvo_audio_write_pos(s_audio),
+        .proc_pos = __atomic_load_n(&s_proc_write, __ATOMIC_ACQUIRE),
+    };
+    if (xQueueSend(s_events, &ev, 0) != pdTRUE) {
+        __atomic_store_n(&s_busy, false, __ATOMIC_RELEASE);
+    }
+}
+
+void wake_capture_score(float score, float threshold, bool detected)
+{
+    if (!wake_capture_armed()) {
+        s_run.active = false;
+        return;
+    }
+    uint32_t n = s_score_write;
+    s_scores[n & (WAKE_CAPTURE_SCORE_RING - 1)] = (wake_capture_score_entry_t){
+        .pos = korvo_audio_write_pos(s_audio),
+        .score = score,
+    };
+    __atomic_store_n(&s_score_write, n + 1, __ATOMIC_RELEASE);
+
+    int64_t now = esp_timer_get_time();
+    bool near = score >= threshold * (CONFIG_KVA_WAKE_CAPTURE_NEAR_MISS_PCT / 100.0f);
+    if (near || detected) {
+        if (!s_run.active) {
+            s_run.active = true;
+            s_run.fired = false;
+            s_run.peak = score;
+        }
+        s_run.peak = score > s_run.peak ? score : s_run.peak;
+        s_run.threshold = threshold;
+        s_run.last_near_us = now;
+        if (detected && !s_run.fired) {
+            s_run.fired = true;
+            wake_capture_trigger(WAKE_CAPTURE_SOURCE_ENERGY, WAKE_CAPTURE_DETECTED, s_run.peak, threshold);
+        }
+        return;
+    }
+    // A pause between syllables is not the end of the run
+    if (s_run.active && now - s_run.last_near_us >= WAKE_CAPTURE_RUN_GAP_MS * 1000LL) {
+        s_run.active = false;
+        if (!s_run.fired) {
+            wake_capture_trigger(WAKE_CAPTURE_SOURCE_ENERGY, WAKE_CAPTURE_NEAR_MISS, s_run.peak, s_run.threshold);
+        }
+    }
+}
+
+void wake_capture_feed_processed(const int16_t *mono, size_t samples)
+{
+    if (!mono || !s_proc || !wake_capture_armed()) {
+        __atomic_store_n(&s_proc_live, false, __ATOMIC_RELAXED);
+        return;
+    }
+    uint32_t write = s_proc_write;
+    if (!__atomic_load_n(&s_proc_live, __ATOMIC_RELAXED)) {
+        // Anything older is from before the host subscribed
+        __atomic_store_n(&s_proc_valid_from, write, __ATOMIC_RELEASE);
+        __atomic_store_n(&s_proc_live, true, __ATOMIC_RELAXED);
+    }
+    for (size_t i = 0; i < samples; ++i) {
+        s_proc[(write + i) & s_proc_mask] = mono[i];
+    }
+    __atomic_store_n(&s_proc_write, write + (uint32_t)samples, __ATOMIC_RELEASE);
+}
+
+// Send AFE samples from *pos up to limit; skips ahead past anything overwritten
+static void send_processed(uint16_t id, uint32_t window_start, uint32_t *pos, uint32_t limit, uint32_t *sent)
+{
+    uint32_t ring = s_proc_mask + 1;
+    while ((int32_t)(limit - *pos) > 0) {
+        uint32_t write = __atomic_load_n(&s_proc_write, __ATOMIC_ACQUIRE);
+        if (write - *pos > ring) {
+            *pos = write - ring;
+        }
+        uint32_t count = limit - *pos;
+        if (count > WAKE_CAPTURE_PROC_CHUNK_SAMPLES) {
+            count = WAKE_CAPTURE_PROC_CHUNK_SAMPLES;
+        }
+        for (uint32_t i = 0; i < count; ++i) {
+            s_chunk[i] = s_proc[(*pos + i) & s_proc_mask];
+        }
+        // The AFE task may have lapped the copy
+        if (__atomic_load_n(&s_proc_write, __ATOMIC_ACQUIRE) - *pos > ring) {
+            continue;
+        }
+        serial_link_capture_audio_t head = {
+            .id = id,
+            .track = 1,
+            .channels = 1,
+            .first_frame = *pos - window_start,
+        };
+        if (serial_link_publish_parts(SERIAL_LINK_FRAME_CAPTURE_AUDIO, &head, sizeof(head), s_chunk,
+                                      count * sizeof(int16_t), WAKE_CAPTURE_SEND_WAIT_MS)) {
+            *sent += count;
+        }
+        *pos += count;
+    }
+}
+
+static void send_scores(uint16_t id, uint32_t window_start, uint32_t window_end)
+{
+    uint32_t write = __atomic_load_n(&s_score_write, __ATOMIC_ACQUIRE);
+    uint32_t oldest = write > WAKE_CAPTURE_SCORE_RING ? write - WAKE_CAPTURE_SCORE_RING : 0;
+    uint8_t count = 0;
+    for (uint32_t n = oldest; n != write && count < UINT8_MAX; ++n) {
+        const wake_capture_score_entry_t *entry = &s_scores[n & (WAKE_CAPTURE_SCORE_RING - 1)];
+        uint32_t offset = entry->pos - window_start;
+        if (offset < window_end - window_start) {
+            s_window_scores[count++] = (serial_link_capture_score_t){
+                .frame = offset / WAKE_CAPTURE_RAW_CHANNELS,
+                .score = entry->score,
+            };
+        }
+    }
+    serial_link_capture_scores_t head = {.id = id, .count = count};
+    serial_link_publish_parts(SERIAL_LINK_FRAME_CAPTURE_SCORES, &head, sizeof(head), s_window_scores,
+                              count * sizeof(s_window_scores[0]), WAKE_CAPTURE_SEND_WAIT_MS);
+}
+
+static void send_window(const wake_capture_event_t *ev)
+{
+    uint16_t id = s_next_id++;
+    serial_link_capture_begin_t begin = {
+        .id = id,
+        .source = (uint8_t)ev->source,
+        .outcome = (uint8_t)ev->outcome,
+        .time_ms = ev->time_ms,
+        .score = ev->score,
+        .threshold = ev->threshold,
+        .sample_rate_hz = (uint16_t)s_audio->sample_rate_hz,
+        .preroll_ms = (uint16_t)(s_preroll_frames * 1000 / s_audio->sample_rate_hz),
+        .postroll_ms = (uint16_t)(s_postroll_frames * 1000 / s_audio->sample_rate_hz),
+        .raw_channels = WAKE_CAPTURE_RAW_CHANNELS,
+    };
+    serial_link_publish_parts(SERIAL_LINK_FRAME_CAPTURE_BEGIN, &begin, sizeof(begin), NULL, 0,
+                              WAKE_CAPTURE_SEND_WAIT_MS);
+
+    // Window bounds on both tracks; anything the rings no longer hold is reported lost
+    uint32_t raw_start = ev->raw_pos - s_preroll_frames * WAKE_CAPTURE_RAW_CHANNELS;
+    uint32_t raw_end = ev->raw_pos + s_postroll_frames * WAKE_CAPTURE_RAW_CHANNELS;
+    uint32_t proc_start = ev->proc_pos - s_preroll_frames;
+    uint32_t proc_end = ev->proc_pos + s_postroll_frames;
+    uint32_t proc_pos = proc_start;
+    uint32_t valid_from = __atomic_load_n(&s_proc_valid_from, __ATOMIC_ACQUIRE);
+    if ((int32_t)(valid_from - proc_pos) > 0) {
+        proc_pos = valid_from;
+    }
+    korvo_audio_reader_seek(s_reader, raw_start);
+
+    uint32_t raw_sent = 0;
+    uint32_t proc_sent = 0;
+    int64_t deadline_us = esp_timer_get_time() +
+                          ((int64_t)(s_postroll_frames * 1000 / s_audio->sample_rate_hz) + 2000) * 1000;
+    while ((int32_t)(raw_end - s_reader->read_pos) > 0 && esp_timer_get_time() < deadline_us) {
+        size_t want = raw_end - s_reader->read_pos;
+        if (want > WAKE_CAPTURE_RAW_CHUNK_SAMPLES) {
+            want = WAKE_CAPTURE_RAW_CHUNK_SAMPLES;
+        }
+        size_t got = 0;
+        if (korvo_audio_read(s_reader, s_chunk, want, &got, pdMS_TO_TICKS(100)) != ESP_OK || got == 0) {
+            continue;
+        }
+        serial_link_capture_audio_t head = {
+            .id = id,
+            .track = 0,
+            .channels = WAKE_CAPTURE_RAW_CHANNELS,
+            .first_frame = (s_reader->read_pos - (uint32_t)got - raw_start) / WAKE_CAPTURE_RAW_CHANNELS,
+        };
+        if (serial_link_publish_parts(SERIAL_LINK_FRAME_CAPTURE_AUDIO, &head, sizeof(head), s_chunk,
+                                      got * sizeof(int16_t), WAKE_CAPTURE_SEND_WAIT_MS)) {
+            raw_sent += got / WAKE_CAPTURE_RAW_CHANNELS;
+        }
+
+        uint32_t proc_write = __atomic_load_n(&s_proc_write, __ATOMIC_ACQUIRE);
+        send_processed(id, proc_start, &proc_pos, (int32_t)(proc_write - proc_end) < 0 ? proc_write : proc_end,
+                       &proc_sent);
+    }
+
+    // The AFE output trails the capture by its own latency; only wait if it is running
+    int64_t afe_deadline_us = esp_timer_get_time() + WAKE_CAPTURE_AFE_LAG_MS * 1000LL;
+    while (__atomic_load_n(&s_proc_live, __ATOMIC_RELAXED) && (int32_t)(proc_end - proc_pos) > 0 && esp_timer_get_time() < afe_deadline_us) {
+        vTaskDelay(pdMS_TO_TICKS(20));
+        uint32_t proc_write = __atomic_load_n(&s_proc_write, __ATOMIC_ACQUIRE);
+        send_processed(id, proc_start, &proc_pos, (int32_t)(proc_write - proc_end) < 0 ? proc_write : proc_end,
+                       &proc_sent);
+    }
+
+    send_scores(id, raw_start, raw_end);
+
+    uint32_t window_frames = s_preroll_frames + s_postroll_frames;
+    serial_link_capture_end_t end = {
+        .id = id,
+        .raw_frames = raw_sent,
+        .processed_frames = proc_sent,
+        .lost_frames = window_frames > raw_sent ? window_frames - raw_sent : 0,
+    };
+    serial_link_publish_parts(SERIAL_LINK_FRAME_CAPTURE_END, &end, sizeof(end), NULL, 0, WAKE_CAPTURE_SEND_WAIT_MS);
+    ESP_LOGI(TAG, "Capture %u (%s, score %.2f / %.2f): %u raw, %u AFE frames, %u lost", (unsigned)id,
+             ev->outcome == WAKE_CAPTURE_DETECTED ? "detected" : "near miss", ev->score, ev->threshold,
+             (unsigned)raw_sent, (unsigned)proc_sent, (unsigned)end.lost_frames);
+}
+
+static void wake_capture_task(void *arg)
+{
+    (void)arg;
+    wake_capture_event_t ev;
+    while (true) {
+        if (xQueueReceive(s_events, &ev, portMAX_DELAY) == pdTRUE) {
+            send_window(&ev);
+            __atomic_store_n(&s_busy, false, __ATOMIC_RELEASE);
+        }
+    }
+}
+
+esp_err_t wake_capture_init(korvo_audio_t *audio)
+{
+    ESP_RETURN_ON_FALSE(audio && audio->sample_rate_hz > 0, ESP_ERR_INVALID_ARG, TAG, "audio");
+    ESP_RETURN_ON_FALSE(!s_audio, ESP_ERR_INVALID_STATE, TAG, "already running");
+
+    // Leave the ring some headroom over the pre-roll for the sender to start
+    uint32_t max_preroll = KORVO_AUDIO_RING_SAMPLES / WAKE_CAPTURE_RAW_CHANNELS * 7 / 8;
+    s_preroll_frames = (uint32_t)((int64_t)CONFIG_KVA_WAKE_CAPTURE_PREROLL_MS * audio->sample_rate_hz / 1000);
+    if (s_preroll_frames > max_preroll) {
+        ESP_LOGW(TAG, "Pre-roll cut to the %u frames the capture ring holds", (unsigned)max_preroll);
+        s_preroll_frames = max_preroll;
+    }
+    s_postroll_frames = (uint32_t)((int64_t)CONFIG_KVA_WAKE_CAPTURE_POSTROLL_MS * audio->sample_rate_hz / 1000);
+
+    // The AFE ring holds a whole window so the sender can fall behind the AFE
+    uint32_t proc_ring = 1024;
+    while (proc_ring < s_preroll_frames + s_postroll_frames + WAKE_CAPTURE_PROC_CHUNK_SAMPLES) {
+        proc_ring <<= 1;
+    }
+    s_proc = heap_caps_malloc(proc_ring * sizeof(int16_t), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    ESP_RETURN_ON_FALSE(s_proc, ESP_ERR_NO_MEM, TAG, "AFE ring");
+    s_proc_mask = proc_ring - 1;
+
+    esp_err_t err = ESP_ERR_NO_MEM;
+    s_events = xQueueCreate(1, sizeof(wake_capture_event_t));
+    if (!s_events) {
+        goto fail;
+    }
+    err = korvo_audio_open_reader(audio, "wake_capture", &s_reader);
+    if (err != ESP_OK) {
+        goto fail;
+    }
+    if (task_placement_create(TASK_PLACEMENT_WAKE_CAPTURE, wake_capture_task, NULL, NULL) != pdPASS) {
+        err = ESP_ERR_NO_MEM;
+        goto fail;
+    }
+    __atomic_store_n(&s_audio, audio, __ATOMIC_RELEASE);
+    ESP_LOGI(TAG, "Ready: %u ms pre-roll, %u ms post-roll, near miss at %d%% of threshold",
+             (unsigned)(s_preroll_frames * 1000 / audio->sample_rate_hz), (unsigned)CONFIG_KVA_WAKE_CAPTURE_POSTROLL_MS,
+             CONFIG_KVA_WAKE_CAPTURE_NEAR_MISS_PCT);
+    return ESP_OK;
+
+fail:
+    korvo_audio_close_reader(s_reader);
+    s_reader = NULL;
+    if (s_events) {
+        vQueueDelete(s_events);
+        s_events = NULL;
+    }
+    heap_caps_free(s_proc);
+    s_proc = NULL;
+    return err;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "korvo_audio.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Wake-word training capture: while a host subscribes to
+ * SERIAL_LINK_STREAM_WAKE_CAPTURE, every wake detection and every near miss
+ * (a score run that came close to the threshold but did not fire) sends a
+ * window of raw stereo capture and AFE output, pre-roll and post-roll, plus
+ * the detector scores over it. The host labels them as true or false
+ * accepts and rejects; scripts/serial_link.py wake-capture writes them out.
+ *
+ * The pre-roll comes straight from the capture ring, so it is limited to
+ * what the ring holds (about 1 s). One window is sent at a time; events
+ * while one is in flight are dropped. Without a subscriber every hook is a
+ * flag check.
+ */
+
+typedef enum {
+    WAKE_CAPTURE_SOURCE_ENERGY = 0,   // wake_word_service energy detector
+    WAKE_CAPTURE_SOURCE_WAKENET = 1,  // WakeNet in the AFE; reports no score
+} wake_capture_source_t;
+
+typedef enum {
+    WAKE_CAPTURE_NEAR_MISS = 0,
+    WAKE_CAPTURE_DETECTED = 1,
+} wake_capture_outcome_t;
+
+// Open the capture reader and start the sender task
+esp_err_t wake_capture_init(korvo_audio_t *audio);
+
+// Whether a host is collecting; lets producers skip the hooks below
+bool wake_capture_armed(void);
+
+// Capture a window around now; dropped if one is already being sent
+void wake_capture_trigger(wake_capture_source_t source, wake_capture_outcome_t outcome, float score,
+                          float threshold);
+
+/**
+ * Per-frame score of the energy detector. Records it for the window and
+ * triggers on detections and near misses. Wake-word task only.
+ */
+void wake_capture_score(float score, float threshold, bool detected);
+
+// AFE output (mono, capture rate) for the processed track. AFE task only.
+void wake_capture_feed_processed(const int16_t *mono, size_t samples);
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,25 +1,31 @@
 #include "wake_word_service.h"
 
+#include <math.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
 
+#include "deferred_log.h"
 #include "esp_check.h"
 #include "esp_log.h"
+#include "flash_guard.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
-#include "freertos/timers.h"
-
-// Forward declaration for LED update callback
-extern void update_mic_leds(float mic1_level, float mic2_level, float mic3_level);
+#include "nvs.h"
+#include "audio_graph.h"
+#include "audio_meter.h"
+#include "kva_config_defaults.h"
+#include "serial_link.h"
+#include "timer_wheel.h"
+#include "wake_arbiter.h"
+#include "wake_capture.h"
 
 struct wake_word_service {
     wake_word_service_config_t cfg;
     wake_word_callback_t callback;
     void *callback_ctx;
-    TimerHandle_t simulated_timer;
-    TaskHandle_t task;
-    int16_t *frame_buffer;
+    timer_wheel_timer_t *simulated_timer;
+    bool attached;                    // Running as the graph's WAKE_ENERGY node
     size_t frame_samples;
     int activation_frames;
     int frames_over_threshold;
@@ -27,23 +33,35 @@ struct wake_word_service {
     float energy_offset;
     TickType_t cooldown_ticks;
     TickType_t resume_from_tick;
-    bool stop_requested;
     bool calibrating;
     int calibration_samples;
     float calibration_sum;
     int calibration_count;
+    float learned_floor;              // Slow average of quiet frames, what NVS keeps; read by the save timer
+    float learn_alpha;                // Per frame, from CONFIG_KVA_WAKE_NOISE_LEARN_S
+    float saved_floor;                // Last value stored, 0 before the first
+    timer_wheel_timer_t *save_timer;
 };
 
 static const char *TAG = "wake_word";
-static const size_t WAKE_WORD_TASK_STACK = 4096;
-static const int WAKE_WORD_TASK_PRIORITY = 4;
-static const BaseType_t WAKE_WORD_TASK_CORE = 1;
 static const size_t WAKE_WORD_DEFAULT_FRAME_SAMPLES = 512;
 static const int WAKE_WORD_DEFAULT_FRAMES = 4;
 static const int WAKE_WORD_DEFAULT_COOLDOWN_MS = 2500;
-static const int WAKE_WORD_CALIBRATION_SAMPLES = 200;  // ~1 second at 5ms per frame
+static const int WAKE_WORD_CALIBRATION_SAMPLES = 200;  // Frames; ~3 s of default 16 ms frames
 static const float WAKE_WORD_MIN_NOISE_FLOOR = 100.0f;  // Minimum noise floor to prevent false positives
 
+#define WAKE_WORD_NVS_NAMESPACE "wake_word"
+#define WAKE_WORD_NVS_KEY "noise"
+// Bumped when the level measure changes; the PDM and TDM captures read different levels
+#define WAKE_WORD_NOISE_VERSION (1u | (CONFIG_KVA_CAPTURE_TDM ? 0x100u : 0u))
+// The stored floor is rewritten only once the learned one is 1 dB away from it
+#define WAKE_WORD_NOISE_SAVE_RATIO 1.122f
+
+typedef struct {
+    uint32_t version;
+    float noise_floor;
+} noise_record_t;
+
 static inline int clamp_int(int value, int min, int max)
 {
     if (value < min) {
@@ -64,70 +82,64 @@ static float energy_offset_for_sensitivity(int sensitivity)
     return min_offset + scaled * (max_offset - min_offset);
 }
 
-static float compute_frame_level(const int16_t *samples, size_t sample_count)
+static bool load_noise_floor(float *out)
 {
-    if (!samples || sample_count == 0) {
-        return 0.0f;
+    nvs_handle_t nvs;
+    if (nvs_open(WAKE_WORD_NVS_NAMESPACE, NVS_READONLY, &nvs) != ESP_OK) {
+        return false;
     }
-    uint64_t sum = 0;
-    for (size_t i = 0; i < sample_count; ++i) {
-        int32_t val = samples[i];
-        sum += val >= 0 ? val : -val;
+    noise_record_t rec;
+    size_t len = sizeof(rec);
+    esp_err_t err = nvs_get_blob(nvs, WAKE_WORD_NVS_KEY, &rec, &len);
+    nvs_close(nvs);
+    if (err != ESP_OK || len != sizeof(rec) || rec.version != WAKE_WORD_NOISE_VERSION || !isfinite(rec.noise_floor)) {
+        return false;
     }
-    // Prevent divide-by-zero
-    if (sample_count == 0) {
-        return 0.0f;
-    }
-    return (float)sum / (float)sample_count;
+    *out = rec.noise_floor < WAKE_WORD_MIN_NOISE_FLOOR ? WAKE_WORD_MIN_NOISE_FLOOR : rec.noise_floor;
+    return true;
 }
 
-// Compute energy levels for each microphone channel in STEREO audio
-// STEREO format: samples are interleaved [L, R, L, R, ...]
-// Korvo-1 has 3 microphones: we extract left, right, and combined for far-field processing
-static void compute_mic_levels(const int16_t *samples, size_t sample_count, 
-                                float *mic1_level, float *mic2_level, float *mic3_level)
+static void store_noise_floor(wake_word_service_t *service)
 {
-    if (!samples || sample_count == 0) {
-        *mic1_level = 0.0f;
-        *mic2_level = 0.0f;
-        *mic3_level = 0.0f;
+    float floor = service->learned_floor;
+    if (floor < WAKE_WORD_MIN_NOISE_FLOOR) {
+        floor = WAKE_WORD_MIN_NOISE_FLOOR;
+    }
+    float saved = service->saved_floor;
+    if (saved > 0.0f && floor < saved * WAKE_WORD_NOISE_SAVE_RATIO && floor * WAKE_WORD_NOISE_SAVE_RATIO > saved) {
         return;
     }
-    
-    uint64_t sum1 = 0, sum2 = 0, sum3 = 0;
-    size_t count1 = 0, count2 = 0, count3 = 0;
-    
-    // For STEREO: samples are interleaved [L, R, L, R, ...]
-    // MIC1 = Left channel (first microphone)
-    // MIC2 = Right channel (second microphone)  
-    // MIC3 = Combined/averaged signal for far-field beamforming effect
-    for (size_t i = 0; i < sample_count; i += 2) {
-        if (i < sample_count) {
-            int32_t val1 = samples[i]; // Left channel (MIC1)
-            int32_t abs_val1 = val1 >= 0 ? val1 : -val1;
-            sum1 += abs_val1;
-            count1++;
-            sum3 += abs_val1; // Include in combined
-            count3++;
-        }
-        if (i + 1 < sample_count) {
-            int32_t val2 = samples[i + 1]; // Right channel (MIC2)
-            int32_t abs_val2 = val2 >= 0 ? val2 : -val2;
-            sum2 += abs_val2;
-            count2++;
-            sum3 += abs_val2; // Include in combined
-            count3++;
+    const noise_record_t rec = {.version = WAKE_WORD_NOISE_VERSION, .noise_floor = floor};
+    nvs_handle_t nvs;
+    esp_err_t err = nvs_open(WAKE_WORD_NVS_NAMESPACE, NVS_READWRITE, &nvs);
+    if (err == ESP_OK) {
+        err = nvs_set_blob(nvs, WAKE_WORD_NVS_KEY, &rec, sizeof(rec));
+        if (err == ESP_OK) {
+            err = nvs_commit(nvs);
         }
+        nvs_close(nvs);
     }
-    
-    *mic1_level = count1 > 0 ? (float)sum1 / (float)count1 : 0.0f;
-    *mic2_level = count2 > 0 ? (float)sum2 / (float)count2 : 0.0f;
-    *mic3_level = count3 > 0 ? (float)sum3 / (float)count3 : 0.0f; // Combined average for far-field
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Noise floor not stored: %s", esp_err_to_name(err));
+        return;
+    }
+    service->saved_floor = floor;
+    ESP_LOGI(TAG, "Wake word: stored noise floor %.0f", floor);
+}
+
+static void save_timer_cb(void *arg)
+{
+    wake_word_service_t *service = (wake_word_service_t *)arg;
+    // Not before calibration has given a floor, nor over playback, which the commit would stall; next period
+    if (service->learned_floor <= 0.0f || flash_guard_audio_active()) {
+        return;
+    }
+    store_noise_floor(service);
 }
 
-static void simulated_timer_cb(TimerHandle_t timer)
+static void simulated_timer_cb(void *arg)
 {
-    wake_word_service_t *service = (wake_word_service_t *)pvTimerGetTimerID(timer);
+    wake_word_service_t *service = (wake_word_service_t *)arg;
     if (!service || !service->callback) {
         return;
     }
@@ -138,161 +150,132 @@ static void simulated_timer_cb(TimerHandle_t timer)
     service->callback(service->callback_ctx);
 }
 
-static void wake_word_task(void *arg)
+// One frame from the graph; paused frames are dropped, so detection resumes on fresh audio
+static void wake_word_node(void *arg, const audio_graph_block_t *block)
 {
     wake_word_service_t *service = (wake_word_service_t *)arg;
-    const TickType_t frame_delay = pdMS_TO_TICKS(5);
-    while (!service->stop_requested) {
-        if (!service->cfg.audio) {
-            vTaskDelay(pdMS_TO_TICKS(100));
-            continue;
-        }
-
-        TickType_t now = xTaskGetTickCount();
-        if (service->resume_from_tick != 0 && now < service->resume_from_tick) {
-            vTaskDelay(frame_delay);
-            continue;
-        } else if (service->resume_from_tick != 0 && now >= service->resume_from_tick) {
-            service->resume_from_tick = 0;
-        }
-
-        esp_err_t lock_err = korvo_audio_acquire(service->cfg.audio, pdMS_TO_TICKS(20));
-        if (lock_err != ESP_OK) {
-            vTaskDelay(frame_delay);
-            continue;
+    if (service->resume_from_tick != 0) {
+        if (xTaskGetTickCount() < service->resume_from_tick) {
+            return;
         }
+        service->resume_from_tick = 0;
+    }
 
-        size_t read = 0;
-        esp_err_t read_err = korvo_audio_capture_locked(service->cfg.audio,
-                                                        service->frame_buffer,
-                                                        service->frame_samples,
-                                                        &read,
-                                                        pdMS_TO_TICKS(50));
-        korvo_audio_release(service->cfg.audio);
-        if (read_err != ESP_OK || read == 0) {
-            vTaskDelay(frame_delay);
-            continue;
-        }
+    // The energy gate stays in mean |x| across both channels, as it was tuned
+    audio_meter_level_t mics[AUDIO_METER_MIC_CHANNELS];
+    audio_meter_measure(block->samples, block->count / AUDIO_METER_MIC_CHANNELS, AUDIO_METER_MIC_CHANNELS, mics);
+    float level = (mics[0].mean_abs + mics[1].mean_abs) / 2.0f;
 
-        float level = compute_frame_level(service->frame_buffer, read);
+    // Calibration period: collect samples to establish baseline noise floor
+    if (service->calibrating) {
+        service->calibration_sum += level;
+        service->calibration_count++;
         
-        // Compute individual microphone channel levels for LED visualization
-        float mic1_level = 0.0f, mic2_level = 0.0f, mic3_level = 0.0f;
-        compute_mic_levels(service->frame_buffer, read, &mic1_level, &mic2_level, &mic3_level);
-        
-        // Update microphone LEDs (callback to main)
-        update_mic_leds(mic1_level, mic2_level, mic3_level);
+        // Log calibration progress every 50 samples
+        if (service->calibration_count > 0 && service->calibration_count % 50 == 0) {
+            float current_avg = service->calibration_count > 0 ? service->calibration_sum / (float)service->calibration_count : 0.0f;
+            DLOGI(TAG, "Wake word: Calibrating... (%d/%d samples, current avg=%.0f, current level=%.0f)",
+                  service->calibration_count, service->calibration_samples, current_avg, level);
+        }
         
-        // Calibration period: collect samples to establish baseline noise floor
-        if (service->calibrating) {
-            service->calibration_sum += level;
-            service->calibration_count++;
+        if (service->calibration_count >= service->calibration_samples && service->calibration_count > 0) {
+            // Calculate average noise floor from calibration samples
+            float raw_avg = service->calibration_count > 0 ? service->calibration_sum / (float)service->calibration_count : 0.0f;
+            service->noise_floor = raw_avg;
             
-            // Log calibration progress every 50 samples
-            if (service->calibration_count > 0 && service->calibration_count % 50 == 0) {
-                float current_avg = service->calibration_count > 0 ? service->calibration_sum / (float)service->calibration_count : 0.0f;
-                ESP_LOGI(TAG, "Wake word: Calibrating... (%d/%d samples, current avg=%.0f, current level=%.0f)",
-                         service->calibration_count, service->calibration_samples, current_avg, level);
+            // Ensure minimum noise floor to prevent false positives
+            if (service->noise_floor < WAKE_WORD_MIN_NOISE_FLOOR) {
+                ESP_LOGW(TAG, "Wake word: Noise floor too low (%.0f), using minimum %.0f",
+                         raw_avg, WAKE_WORD_MIN_NOISE_FLOOR);
+                service->noise_floor = WAKE_WORD_MIN_NOISE_FLOOR;
             }
             
-            if (service->calibration_count >= service->calibration_samples && service->calibration_count > 0) {
-                // Calculate average noise floor from calibration samples
-                float raw_avg = service->calibration_count > 0 ? service->calibration_sum / (float)service->calibration_count : 0.0f;
-                service->noise_floor = raw_avg;
-                
-                // Ensure minimum noise floor to prevent false positives
-                if (service->noise_floor < WAKE_WORD_MIN_NOISE_FLOOR) {
-                    ESP_LOGW(TAG, "Wake word: Noise floor too low (%.0f), using minimum %.0f",
-                             raw_avg, WAKE_WORD_MIN_NOISE_FLOOR);
-                    service->noise_floor = WAKE_WORD_MIN_NOISE_FLOOR;
-                }
-                
-                service->calibrating = false;
-                float final_threshold = service->noise_floor + service->energy_offset;
-                ESP_LOGI(TAG, "Wake word: *** Calibration complete ***");
-                ESP_LOGI(TAG, "Wake word:   Noise floor: %.0f (from %d samples, raw avg=%.0f)",
-                         service->noise_floor, service->calibration_count, raw_avg);
-                ESP_LOGI(TAG, "Wake word:   Energy offset: %.0f (sensitivity=%d)",
-                         service->energy_offset, service->cfg.sensitivity);
-                ESP_LOGI(TAG, "Wake word:   Detection threshold: %.0f (noise + offset)",
-                         final_threshold);
-                ESP_LOGI(TAG, "Wake word:   Will trigger when level > %.0f for %d consecutive frames",
-                         final_threshold, service->activation_frames);
-            } else {
-                // Still calibrating, skip detection
-                vTaskDelay(frame_delay);
-                continue;
-            }
-        }
-        
-        // Fallback: if noise floor not set (shouldn't happen after calibration)
-        if (service->noise_floor <= 0.0f) {
-            service->noise_floor = level > WAKE_WORD_MIN_NOISE_FLOOR ? level : WAKE_WORD_MIN_NOISE_FLOOR;
-            ESP_LOGW(TAG, "Wake word: WARNING - Noise floor not calibrated, using fallback value %.0f (current level=%.0f)",
-                     service->noise_floor, level);
+            service->calibrating = false;
+            service->learned_floor = service->noise_floor;
+            float final_threshold = service->noise_floor + service->energy_offset;
+            ESP_LOGI(TAG, "Wake word: *** Calibration complete ***");
+            ESP_LOGI(TAG, "Wake word:   Noise floor: %.0f (from %d samples, raw avg=%.0f)",
+                     service->noise_floor, service->calibration_count, raw_avg);
+            ESP_LOGI(TAG, "Wake word:   Energy offset: %.0f (sensitivity=%d)",
+                     service->energy_offset, service->cfg.sensitivity);
+            ESP_LOGI(TAG, "Wake word:   Detection threshold: %.0f (noise + offset)",
+                     final_threshold);
+            ESP_LOGI(TAG, "Wake word:   Will trigger when level > %.0f for %d consecutive frames",
+                     final_threshold, service->activation_frames);
+        } else {
+            // Still calibrating, skip detection
+            return;
         }
+    }
+    
+    // Fallback: if noise floor not set (shouldn't happen after calibration)
+    if (service->noise_floor <= 0.0f) {
+        service->noise_floor = level > WAKE_WORD_MIN_NOISE_FLOOR ? level : WAKE_WORD_MIN_NOISE_FLOOR;
+        ESP_LOGW(TAG, "Wake word: WARNING - Noise floor not calibrated, using fallback value %.0f (current level=%.0f)",
+                 service->noise_floor, level);
+    }
 
-        float threshold = service->noise_floor + service->energy_offset;
-        
-        // Debug logging every 50 frames (~0.25 seconds at 5ms per frame) for more frequent updates
-        static int debug_counter = 0;
-        debug_counter++;
-        if (debug_counter % 50 == 0) {
-            ESP_LOGI(TAG, "Wake word: level=%.0f, noise=%.0f, threshold=%.0f, offset=%.0f, frames_over=%d/%d, diff=%.0f",
-                     level, service->noise_floor, threshold, service->energy_offset,
-                     service->frames_over_threshold, service->activation_frames,
-                     level - threshold);
+    float threshold = service->noise_floor + service->energy_offset;
+    
+    // Debug logging every 50 frames (~0.25 seconds at 5ms per frame) for more frequent updates
+    static int debug_counter = 0;
+    debug_counter++;
+    if (debug_counter % 50 == 0) {
+        DLOGI(TAG, "Wake word: level=%.0f, noise=%.0f, threshold=%.0f, offset=%.0f, frames_over=%d/%d, diff=%.0f",
+              level, service->noise_floor, threshold, service->energy_offset,
+              service->frames_over_threshold, service->activation_frames,
+              level - threshold);
+    }
+    
+    if (level <= threshold) {
+        float old_noise = service->noise_floor;
+        service->noise_floor = service->noise_floor * 0.98f + level * 0.02f;
+        // A single float store, so the save timer never reads it torn
+        service->learned_floor += service->learn_alpha * (level - service->learned_floor);
+        if (service->frames_over_threshold > 0) {
+            DLOGI(TAG, "Wake word: Level dropped below threshold (%.0f <= %.0f), resetting counter. Noise floor: %.0f -> %.0f",
+                  level, threshold, old_noise, service->noise_floor);
         }
-        
-        if (level <= threshold) {
-            float old_noise = service->noise_floor;
-            service->noise_floor = service->noise_floor * 0.98f + level * 0.02f;
-            if (service->frames_over_threshold > 0) {
-                ESP_LOGI(TAG, "Wake word: Level dropped below threshold (%.0f <= %.0f), resetting counter. Noise floor: %.0f -> %.0f",
-                         level, threshold, old_noise, service->noise_floor);
-            }
-            service->frames_over_threshold = 0;
-        } else {
-            float diff = level - threshold;
-            service->frames_over_threshold++;
-            if (service->frames_over_threshold == 1) {
-                ESP_LOGI(TAG, "Wake word: *** Level exceeded threshold! *** (%.0f > %.0f, diff=+%.0f, frames_over=%d/%d)",
-                         level, threshold, diff, service->frames_over_threshold, service->activation_frames);
-            } else if (service->frames_over_threshold == 2) {
-                ESP_LOGI(TAG, "Wake word: Still over threshold (frames_over=%d/%d, level=%.0f, diff=+%.0f)",
-                         service->frames_over_threshold, service->activation_frames, level, diff);
-            } else if (service->frames_over_threshold == service->activation_frames - 1) {
-                ESP_LOGI(TAG, "Wake word: Almost there! (frames_over=%d/%d, level=%.0f, diff=+%.0f)",
-                         service->frames_over_threshold, service->activation_frames, level, diff);
-            } else if (service->frames_over_threshold % 2 == 0 && service->frames_over_threshold > 2) {
-                ESP_LOGI(TAG, "Wake word: Continuing over threshold (frames_over=%d/%d, level=%.0f, diff=+%.0f)",
-                         service->frames_over_threshold, service->activation_frames, level, diff);
-            }
+        service->frames_over_threshold = 0;
+    } else {
+        float diff = level - threshold;
+        service->frames_over_threshold++;
+        if (service->frames_over_threshold == 1) {
+            DLOGI(TAG, "Wake word: *** Level exceeded threshold! *** (%.0f > %.0f, diff=+%.0f, frames_over=%d/%d)",
+                  level, threshold, diff, service->frames_over_threshold, service->activation_frames);
+        } else if (service->frames_over_threshold == 2) {
+            DLOGI(TAG, "Wake word: Still over threshold (frames_over=%d/%d, level=%.0f, diff=+%.0f)",
+                  service->frames_over_threshold, service->activation_frames, level, diff);
+        } else if (service->frames_over_threshold == service->activation_frames - 1) {
+            DLOGI(TAG, "Wake word: Almost there! (frames_over=%d/%d, level=%.0f, diff=+%.0f)",
+                  service->frames_over_threshold, service->activation_frames, level, diff);
+        } else if (service->frames_over_threshold % 2 == 0 && service->frames_over_threshold > 2) {
+            DLOGI(TAG, "Wake word: Continuing over threshold (frames_over=%d/%d, level=%.0f, diff=+%.0f)",
+                  service->frames_over_threshold, service->activation_frames, level, diff);
         }
+    }
 
-        // Only trigger wake word if not calibrating
-        if (!service->calibrating && service->frames_over_threshold >= service->activation_frames) {
-            service->frames_over_threshold = 0;
-            service->resume_from_tick = xTaskGetTickCount() + service->cooldown_ticks;
-            if (service->cfg.aws_bridge) {
-                aws_iot_bridge_record_wake(service->cfg.aws_bridge, false);
-            }
-            ESP_LOGI(TAG,
-                     "*** WAKE WORD DETECTED *** energy=%.0f, noise=%.0f, threshold=%.0f, offset=%.0f",
-                     level,
-                     service->noise_floor,
-                     threshold,
-                     service->energy_offset);
-            if (service->callback) {
-                service->callback(service->callback_ctx);
-            }
-        }
+    serial_link_tap_wake(level, threshold, service->frames_over_threshold >= service->activation_frames);
+    wake_capture_score(level, threshold, service->frames_over_threshold >= service->activation_frames);
 
-        vTaskDelay(frame_delay);
+    // Only trigger wake word if not calibrating
+    if (!service->calibrating && service->frames_over_threshold >= service->activation_frames) {
+        service->frames_over_threshold = 0;
+        service->resume_from_tick = xTaskGetTickCount() + service->cooldown_ticks;
+        if (service->cfg.aws_bridge) {
+            aws_iot_bridge_record_wake(service->cfg.aws_bridge, false);
+        }
+        ESP_LOGI(TAG,
+                 "*** WAKE WORD DETECTED *** energy=%.0f, noise=%.0f, threshold=%.0f, offset=%.0f",
+                 level,
+                 service->noise_floor,
+                 threshold,
+                 service->energy_offset);
+        wake_arbiter_note_detection(1.0f - threshold / level, 20.0f * log10f(level / service->noise_floor));
+        if (service->callback) {
+            service->callback(service->callback_ctx);
+        }
     }
-
-    service->task = NULL;
-    vTaskDelete(NULL);
 }
 
 wake_word_service_t *wake_word_service_start(const wake_word_service_config_t *cfg,
@@ -314,43 +297,57 @@ wake_word_service_t *wake_word_service_start(const wake_word_service_config_t *c
     service->cooldown_ticks = pdMS_TO_TICKS(cooldown_ms);
     service->energy_offset = energy_offset_for_sensitivity(cfg->sensitivity);
     
-    // Initialize calibration
+    // Initialize calibration, skipped when a floor learned before is stored
     service->calibrating = true;
     service->calibration_samples = WAKE_WORD_CALIBRATION_SAMPLES;
     service->calibration_sum = 0.0f;
     service->calibration_count = 0;
     service->noise_floor = 0.0f;  // Will be set after calibration
+    float stored_floor;
+    if (CONFIG_KVA_WAKE_NOISE_PERSIST && cfg->audio && load_noise_floor(&stored_floor)) {
+        service->calibrating = false;
+        service->noise_floor = stored_floor;
+        service->learned_floor = stored_floor;
+        service->saved_floor = stored_floor;
+    }
 
     if (cfg->simulated_interval_ms > 0) {
-        service->simulated_timer = xTimerCreate("wake_sim",
-                                                pdMS_TO_TICKS(cfg->simulated_interval_ms),
-                                                pdTRUE,
-                                                service,
-                                                simulated_timer_cb);
-        if (service->simulated_timer) {
-            xTimerStart(service->simulated_timer, 0);
+        const timer_wheel_timer_config_t timer_cfg = {
+            .callback = simulated_timer_cb,
+            .arg = service,
+            .name = "wake_sim",
+        };
+        if (timer_wheel_create(&timer_cfg, &service->simulated_timer) == ESP_OK) {
+            timer_wheel_start_periodic(service->simulated_timer, cfg->simulated_interval_ms);
             ESP_LOGI(TAG, "Simulated wake timer every %d ms", cfg->simulated_interval_ms);
         }
     }
 
     if (cfg->audio) {
-        service->frame_buffer = malloc(service->frame_samples * sizeof(int16_t));
-        if (!service->frame_buffer) {
-            ESP_LOGE(TAG, "Failed to allocate wake-word frame buffer");
+        // Stereo frames: the detector has to keep up with the audio each block covers
+        const audio_graph_node_config_t node = {
+            .process = wake_word_node,
+            .ctx = service,
+            .block_samples = service->frame_samples,
+        };
+        if (audio_graph_attach(AUDIO_GRAPH_NODE_WAKE_ENERGY, &node) != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to attach the wake-word node");
             wake_word_service_stop(service);
             return NULL;
         }
-        BaseType_t rc = xTaskCreatePinnedToCore(wake_word_task,
-                                                "wake_word",
-                                                WAKE_WORD_TASK_STACK,
-                                                service,
-                                                WAKE_WORD_TASK_PRIORITY,
-                                                &service->task,
-                                                WAKE_WORD_TASK_CORE);
-        if (rc != pdPASS) {
-            ESP_LOGE(TAG, "Wake-word task creation failed");
-            wake_word_service_stop(service);
-            return NULL;
+        service->attached = true;
+        float frame_ms = (float)service->frame_samples / 2.0f * 1000.0f / (float)cfg->audio->sample_rate_hz;
+        service->learn_alpha = frame_ms / (CONFIG_KVA_WAKE_NOISE_LEARN_S * 1000.0f);
+        if (CONFIG_KVA_WAKE_NOISE_PERSIST) {
+            const timer_wheel_timer_config_t save_cfg = {
+                .callback = save_timer_cb,
+                .arg = service,
+                .name = "wake_noise",
+                .slack_ms = 60 * 1000,
+            };
+            if (timer_wheel_create(&save_cfg, &service->save_timer) == ESP_OK) {
+                timer_wheel_start_periodic(service->save_timer, CONFIG_KVA_WAKE_NOISE_SAVE_S * 1000);
+            }
         }
         ESP_LOGI(TAG,
                  "Wake-word listener ready (frame=%d, frames=%d, cooldown=%d ms, offset=%.0f, sensitivity=%d)",
@@ -359,8 +356,13 @@ wake_word_service_t *wake_word_service_start(const wake_word_service_config_t *c
                  cooldown_ms,
                  service->energy_offset,
                  cfg->sensitivity);
-        ESP_LOGI(TAG, "Wake word: Calibrating noise floor for %d samples (~%.1f seconds)...",
-                 service->calibration_samples, (service->calibration_samples * 5.0f) / 1000.0f);
+        if (service->calibrating) {
+            ESP_LOGI(TAG, "Wake word: Calibrating noise floor for %d samples (~%.1f seconds)...",
+                     service->calibration_samples, service->calibration_samples * frame_ms / 1000.0f);
+        } else {
+            ESP_LOGI(TAG, "Wake word: Stored noise floor %.0f, detecting from the first frame (threshold %.0f)",
+                     service->noise_floor, service->noise_floor + service->energy_offset);
+        }
         ESP_LOGI(TAG, "Wake word: Will trigger when audio energy exceeds noise floor + %.0f for %d consecutive frames",
                  service->energy_offset, service->activation_frames);
     } else {
@@ -376,15 +378,17 @@ void wake_word_service_stop(wake_word_service_t *service)
         return;
     }
     if (service->simulated_timer) {
-        xTimerStop(service->simulated_timer, 0);
-        xTimerDelete(service->simulated_timer, 0);
+        timer_wheel_delete(service->simulated_timer);
+    }
+    if (service->save_timer) {
+        timer_wheel_delete(service->save_timer);
     }
-    if (service->task) {
-        service->stop_requested = true;
-        while (service->task) {
-            vTaskDelay(pdMS_TO_TICKS(10));
+    if (service->attached) {
+        audio_graph_detach(AUDIO_GRAPH_NODE_WAKE_ENERGY);
+        // A restart picks up what this run learned
+        if (CONFIG_KVA_WAKE_NOISE_PERSIST && service->learned_floor > 0.0f) {
+            store_noise_floor(service);
         }
     }
-    free(service->frame_buffer);
     free(service);
 }
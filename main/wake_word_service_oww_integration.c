@@ -8,6 +8,7 @@
 
 #include "wake_word_service.h"
 #include "openwakeword.h"
+#include "sound_events.h"
 #include "esp_log.h"
 
 static const char *TAG = "wake_word_oww";
@@ -47,6 +48,13 @@ static void openwakeword_detection_callback(const char *wake_word_name,
     }
 }
 
+// Sound events ride along on the same embeddings; queue them for telemetry
+static void openwakeword_sound_event_callback(const openwakeword_sound_event_t *event, void *user_data)
+{
+    (void)user_data;
+    sound_events_record(event->label, event->start_us, event->duration_ms, event->confidence);
+}
+
 // ============================================================================
 // Add to wake_word_service_start() - Initialize OpenWakeWord
 // ============================================================================
@@ -68,6 +76,8 @@ esp_err_t wake_word_service_init_openwakeword(wake_word_service_t *service,
         .cooldown_ms = CONFIG_OPENWAKEWORD_COOLDOWN_MS,
         .enable_vad = false,
         .vad_threshold = 0.5f,
+        .embedding_model_path = CONFIG_OPENWAKEWORD_EMBEDDING_MODEL_PATH,
+        .event_model_path = CONFIG_OPENWAKEWORD_EVENT_MODEL_PATH,
     };
     
     esp_err_t err = openwakeword_init(&oww_config, 
@@ -76,6 +86,7 @@ esp_err_t wake_word_service_init_openwakeword(wake_word_service_t *service,
                                       &service->oww_handle);
     
     if (err == ESP_OK && service->oww_handle) {
+        openwakeword_set_event_callback(service->oww_handle, openwakeword_sound_event_callback, NULL);
         service->use_openwakeword = true;
         service->oww_initialized = true;
         ESP_LOGI(TAG, "OpenWakeWord initialized successfully");
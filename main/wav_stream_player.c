@@ -0,0 +1,172 @@
+#include "wav_stream_player.h"
+
+#include <string.h>
+
+#include "audio_player.h"
+#include "esp_check.h"
+#include "esp_log.h"
+
+static const char *TAG = "wav_stream";
+
+static uint32_t read_le32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint16_t read_le16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+/**
+ * Walk the buffered header. Returns ESP_OK with *data_offset set once the
+ * "data" chunk starts, ESP_ERR_NOT_FINISHED if more bytes are needed.
+ */
+static esp_err_t parse_header(wav_stream_player_t *player, size_t *data_offset)
+{
+    const uint8_t *h = player->header;
+    size_t len = player->header_len;
+    if (len < 12) {
+        return ESP_ERR_NOT_FINISHED;
+    }
+    ESP_RETURN_ON_FALSE(memcmp(h, "RIFF", 4) == 0 && memcmp(h + 8, "WAVE", 4) == 0,
+                        ESP_ERR_INVALID_ARG, TAG, "not a WAV stream");
+
+    bool fmt_found = false;
+    size_t pos = 12;
+    while (pos + 8 <= len) {
+        const uint8_t *chunk = h + pos;
+        uint32_t chunk_size = read_le32(chunk + 4);
+        if (memcmp(chunk, "data", 4) == 0) {
+            ESP_RETURN_ON_FALSE(fmt_found, ESP_ERR_INVALID_ARG, TAG, "data before fmt");
+            *data_offset = pos + 8;
+            return ESP_OK;
+        }
+        if (memcmp(chunk, "fmt ", 4) == 0) {
+            if (pos + 8 + 16 > len) {
+                return ESP_ERR_NOT_FINISHED;
+            }
+            const uint8_t *fmt = chunk + 8;
+            ESP_RETURN_ON_FALSE(read_le16(fmt) == 1, ESP_ERR_NOT_SUPPORTED, TAG, "PCM required");
+            ESP_RETURN_ON_FALSE(read_le16(fmt + 14) == 16, ESP_ERR_NOT_SUPPORTED, TAG, "16-bit required");
+            player->num_channels = read_le16(fmt + 2);
+            player->sample_rate_hz = (int)read_le32(fmt + 4);
+            ESP_RETURN_ON_FALSE(player->num_channels == 1 || player->num_channels == 2,
+                                ESP_ERR_NOT_SUPPORTED, TAG, "channels");
+            fmt_found = true;
+        }
+        pos += 8 + (size_t)chunk_size + (chunk_size & 1);
+    }
+    return ESP_ERR_NOT_FINISHED;
+}
+
+static esp_err_t flush_stage(wav_stream_player_t *player, bool final)
+{
+    size_t frame_bytes = sizeof(int16_t) * player->num_channels;
+    size_t frames = player->stage_len / frame_bytes;
+    if (frames == 0) {
+        return ESP_OK;
+    }
+    if (player->on_pcm) {
+        player->on_pcm(player->stage, frames, player->sample_rate_hz, player->num_channels, player->on_pcm_ctx);
+    }
+    if (!player->muted) {
+        ESP_RETURN_ON_ERROR(audio_player_stream_submit(AUDIO_PLAYER_STREAM_VOICE, player->stage, frames,
+                                                       player->sample_rate_hz, player->num_channels),
+                            TAG, "submit");
+    }
+    size_t used = frames * frame_bytes;
+    player->pcm_bytes += used;
+    player->stage_len -= used;
+    if (player->stage_len && !final) {
+        // Keep a partial frame for the next chunk
+        memmove(player->stage, (uint8_t *)player->stage + used, player->stage_len);
+    }
+    return ESP_OK;
+}
+
+static esp_err_t push_pcm(wav_stream_player_t *player, const uint8_t *data, size_t len)
+{
+    while (len > 0) {
+        size_t room = sizeof(player->stage) - player->stage_len;
+        size_t n = len < room ? len : room;
+        memcpy((uint8_t *)player->stage + player->stage_len, data, n);
+        player->stage_len += n;
+        data += n;
+        len -= n;
+        if (player->stage_len == sizeof(player->stage)) {
+            ESP_RETURN_ON_ERROR(flush_stage(player, false), TAG, "flush");
+        }
+    }
+    return ESP_OK;
+}
+
+void wav_stream_player_begin(wav_stream_player_t *player)
+{
+    player->header_len = 0;
+    player->in_data = false;
+    player->sample_rate_hz = 0;
+    player->num_channels = 0;
+    player->stage_len = 0;
+    player->pcm_bytes = 0;
+    player->err = ESP_OK;
+    player->on_pcm = NULL;
+    player->on_pcm_ctx = NULL;
+    player->muted = false;
+}
+
+esp_err_t wav_stream_player_feed(const uint8_t *data, size_t len, void *ctx)
+{
+    wav_stream_player_t *player = (wav_stream_player_t *)ctx;
+    if (!player || player->err != ESP_OK) {
+        return player ? player->err : ESP_ERR_INVALID_ARG;
+    }
+
+    if (!player->in_data) {
+        size_t room = sizeof(player->header) - player->header_len;
+        size_t n = len < room ? len : room;
+        memcpy(player->header + player->header_len, data, n);
+        player->header_len += n;
+        data += n;
+        len -= n;
+
+        size_t data_offset = 0;
+        esp_err_t err = parse_header(player, &data_offset);
+        if (err == ESP_ERR_NOT_FINISHED) {
+            if (player->header_len < sizeof(player->header)) {
+                return ESP_OK;
+            }
+            ESP_LOGE(TAG, "No data chunk in first %d bytes", WAV_STREAM_HEADER_MAX);
+            err = ESP_ERR_INVALID_SIZE;
+        }
+        if (err != ESP_OK) {
+            player->err = err;
+            return err;
+        }
+        player->in_data = true;
+        ESP_LOGI(TAG, "Streaming %d Hz, %d ch", player->sample_rate_hz, player->num_channels);
+        player->err = push_pcm(player, player->header + data_offset, player->header_len - data_offset);
+    }
+
+    if (player->err == ESP_OK && len > 0) {
+        player->err = push_pcm(player, data, len);
+    }
+    return player->err;
+}
+
+esp_err_t wav_stream_player_end(wav_stream_player_t *player, size_t *pcm_bytes)
+{
+    ESP_RETURN_ON_FALSE(player, ESP_ERR_INVALID_ARG, TAG, "bad args");
+    if (player->err == ESP_OK) {
+        if (!player->in_data) {
+            player->err = ESP_ERR_INVALID_SIZE;
+            ESP_LOGE(TAG, "Stream ended before WAV data");
+        } else {
+            player->err = flush_stage(player, true);
+        }
+    }
+    if (pcm_bytes) {
+        *pcm_bytes = player->pcm_bytes;
+    }
+    return player->err;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Bytes of RIFF header kept while looking for the "data" chunk
+#define WAV_STREAM_HEADER_MAX 256
+
+// PCM staged before each audio_player_stream_submit() call
+#define WAV_STREAM_STAGE_BYTES 1024
+
+// Sees each block of PCM as it is staged, in the stream's own rate and layout
+typedef void (*wav_stream_pcm_cb_t)(const int16_t *pcm, size_t frames, int sample_rate_hz, int num_channels,
+                                    void *ctx);
+
+/**
+ * Plays a WAV file while it is still downloading.
+ *
+ * Bytes are fed in arbitrary pieces. The header is parsed once, and after
+ * that whole frames go to AUDIO_PLAYER_STREAM_VOICE as they arrive, which
+ * ducks any music. The data chunk size is not trusted, because streamed WAVs
+ * often carry a placeholder there. Playback runs until the feed ends.
+ */
+typedef struct {
+    uint8_t header[WAV_STREAM_HEADER_MAX];
+    size_t header_len;
+    bool in_data;
+    int sample_rate_hz;
+    int num_channels;
+    int16_t stage[WAV_STREAM_STAGE_BYTES / sizeof(int16_t)];
+    size_t stage_len;                 // Bytes in stage
+    size_t pcm_bytes;                 // Bytes handed to the player so far
+    esp_err_t err;                    // First failure; later bytes are dropped
+    // Set after begin(), which clears them
+    wav_stream_pcm_cb_t on_pcm;       // Optional tap, e.g. to record what is played
+    void *on_pcm_ctx;
+    bool muted;                       // Parse and tap only; nothing is queued for playback
+} wav_stream_player_t;
+
+void wav_stream_player_begin(wav_stream_player_t *player);
+
+/**
+ * Chunk callback compatible with openai_tts_chunk_cb_t / gemini_tts_chunk_cb_t.
+ * ctx is a wav_stream_player_t.
+ */
+esp_err_t wav_stream_player_feed(const uint8_t *data, size_t len, void *ctx);
+
+/**
+ * Play any staged tail and report the result of the whole stream.
+ *
+ * @param pcm_bytes PCM bytes played (may be NULL)
+ */
+esp_err_t wav_stream_player_end(wav_stream_player_t *player, size_t *pcm_bytes);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,178 @@
+#include "wav_upload.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "esp_check.h"
+#include "interaction_arena.h"
+#include "interaction_trace.h"
+#include "mbedtls/base64.h"
+
+static const char *TAG = "wav_upload";
+
+// Raw bytes per base64 block; a multiple of 3 so blocks concatenate cleanly
+#define B64_BLOCK_BYTES 768
+#define B64_BLOCK_CHARS (B64_BLOCK_BYTES / 3 * 4)
+
+typedef struct {
+    https_pool_writer_t *writer;
+    char *out;                        // B64_BLOCK_CHARS + 1 (mbedtls NUL)
+    uint8_t carry[3];                 // Tail of the previous input not yet on a 3-byte boundary
+    size_t carry_len;
+} b64_stream_t;
+
+static esp_err_t b64_emit(b64_stream_t *s, const uint8_t *data, size_t len)
+{
+    size_t olen = 0;
+    int ret = mbedtls_base64_encode((unsigned char *)s->out, B64_BLOCK_CHARS + 1, &olen, data, len);
+    ESP_RETURN_ON_FALSE(ret == 0, ESP_FAIL, TAG, "base64 %d", ret);
+    return https_pool_write(s->writer, s->out, olen);
+}
+
+static esp_err_t b64_feed(b64_stream_t *s, const uint8_t *data, size_t len)
+{
+    if (s->carry_len) {
+        while (s->carry_len < 3 && len) {
+            s->carry[s->carry_len++] = *data++;
+            --len;
+        }
+        if (s->carry_len < 3) {
+            return ESP_OK;
+        }
+        ESP_RETURN_ON_ERROR(b64_emit(s, s->carry, 3), TAG, "carry");
+        s->carry_len = 0;
+    }
+    while (len >= 3) {
+        size_t n = len - len % 3;
+        if (n > B64_BLOCK_BYTES) {
+            n = B64_BLOCK_BYTES;
+        }
+        ESP_RETURN_ON_ERROR(b64_emit(s, data, n), TAG, "block");
+        data += n;
+        len -= n;
+    }
+    memcpy(s->carry, data, len);
+    s->carry_len = len;
+    return ESP_OK;
+}
+
+static esp_err_t b64_finish(b64_stream_t *s)
+{
+    if (!s->carry_len) {
+        return ESP_OK;
+    }
+    esp_err_t ret = b64_emit(s, s->carry, s->carry_len);
+    s->carry_len = 0;
+    return ret;
+}
+
+static size_t data_bytes(const wav_upload_body_t *body)
+{
+    return body->sample_count * (size_t)(uplink_codec_bits_per_sample(body->codec) / 8);
+}
+
+static void fill_wav_header(uint8_t header[WAV_UPLOAD_HEADER_BYTES], const wav_upload_body_t *body)
+{
+    const uint16_t num_channels = 1;
+    const uint16_t bits_per_sample = uplink_codec_bits_per_sample(body->codec);
+    uint32_t data_size = data_bytes(body);
+
+    memset(header, 0, WAV_UPLOAD_HEADER_BYTES);
+    memcpy(header, "RIFF", 4);
+    uint32_t chunk_size = WAV_UPLOAD_HEADER_BYTES - 8 + data_size;
+    memcpy(header + 4, &chunk_size, 4);
+    memcpy(header + 8, "WAVE", 4);
+    memcpy(header + 12, "fmt ", 4);
+    uint32_t subchunk1_size = 16;
+    memcpy(header + 16, &subchunk1_size, 4);
+    uint16_t audio_format = uplink_codec_wav_format_tag(body->codec);
+    memcpy(header + 20, &audio_format, 2);
+    memcpy(header + 22, &num_channels, 2);
+    uint32_t sample_rate = body->sample_rate_hz;
+    memcpy(header + 24, &sample_rate, 4);
+    uint32_t byte_rate = sample_rate * num_channels * bits_per_sample / 8;
+    memcpy(header + 28, &byte_rate, 4);
+    uint16_t block_align = num_channels * bits_per_sample / 8;
+    memcpy(header + 32, &block_align, 2);
+    memcpy(header + 34, &bits_per_sample, 2);
+    memcpy(header + 36, "data", 4);
+    memcpy(header + 40, &data_size, 4);
+}
+
+esp_err_t wav_upload_body_init(wav_upload_body_t *body, const char *payload,
+                               const int16_t *pcm, size_t sample_count, int sample_rate_hz,
+                               uplink_codec_id_t codec)
+{
+    ESP_RETURN_ON_FALSE(body && payload && pcm && sample_count && sample_rate_hz > 0,
+                        ESP_ERR_INVALID_ARG, TAG, "bad args");
+    const char *marker = strstr(payload, WAV_UPLOAD_MARKER);
+    ESP_RETURN_ON_FALSE(marker, ESP_ERR_INVALID_ARG, TAG, "payload has no audio marker");
+
+    body->prefix = payload;
+    body->prefix_len = marker - payload;
+    body->suffix = marker + strlen(WAV_UPLOAD_MARKER);
+    body->suffix_len = strlen(body->suffix);
+    body->pcm = pcm;
+    body->sample_count = sample_count;
+    body->sample_rate_hz = sample_rate_hz;
+    body->codec = codec;
+    return ESP_OK;
+}
+
+size_t wav_upload_body_length(const wav_upload_body_t *body)
+{
+    size_t wav_bytes = WAV_UPLOAD_HEADER_BYTES + data_bytes(body);
+    return body->prefix_len + (wav_bytes + 2) / 3 * 4 + body->suffix_len;
+}
+
+// Encode the PCM in blocks and base64 each block as it is produced
+static esp_err_t feed_encoded(b64_stream_t *s, const wav_upload_body_t *body)
+{
+    uplink_codec_encoder_t enc;
+    ESP_RETURN_ON_ERROR(uplink_codec_init(&enc, body->codec, body->sample_rate_hz, body->sample_rate_hz),
+                        TAG, "codec");
+    // Sized for the worst case (PCM16) so any codec fits one block of samples
+    uint8_t *coded = interaction_arena_malloc(B64_BLOCK_BYTES);
+    ESP_RETURN_ON_FALSE(coded, ESP_ERR_NO_MEM, TAG, "codec block");
+
+    const size_t block_samples = B64_BLOCK_BYTES / sizeof(int16_t);
+    esp_err_t ret = ESP_OK;
+    for (size_t i = 0; i < body->sample_count && ret == ESP_OK; i += block_samples) {
+        size_t n = body->sample_count - i < block_samples ? body->sample_count - i : block_samples;
+        size_t len = uplink_codec_encode(&enc, body->pcm + i, n, coded);
+        ret = b64_feed(s, coded, len);
+    }
+    interaction_arena_free(coded);
+    return ret;
+}
+
+esp_err_t wav_upload_body_write(https_pool_writer_t *writer, void *ctx)
+{
+    const wav_upload_body_t *body = (const wav_upload_body_t *)ctx;
+    ESP_RETURN_ON_FALSE(writer && body, ESP_ERR_INVALID_ARG, TAG, "bad args");
+
+    b64_stream_t s = {
+        .writer = writer,
+        .out = interaction_arena_malloc(B64_BLOCK_CHARS + 1),
+    };
+    ESP_RETURN_ON_FALSE(s.out, ESP_ERR_NO_MEM, TAG, "b64 block");
+
+    uint8_t header[WAV_UPLOAD_HEADER_BYTES];
+    fill_wav_header(header, body);
+
+    esp_err_t ret = ESP_OK;
+    ESP_GOTO_ON_ERROR(https_pool_write(writer, body->prefix, body->prefix_len), done, TAG, "prefix");
+    interaction_trace_mark(INTERACTION_TRACE_UPLINK_FIRST_BYTE);
+    ESP_GOTO_ON_ERROR(b64_feed(&s, header, sizeof(header)), done, TAG, "wav header");
+    if (body->codec == UPLINK_CODEC_PCM16) {
+        ESP_GOTO_ON_ERROR(b64_feed(&s, (const uint8_t *)body->pcm, body->sample_count * sizeof(int16_t)), done, TAG, "pcm");
+    } else {
+        ESP_GOTO_ON_ERROR(feed_encoded(&s, body), done, TAG, "encoded audio");
+    }
+    ESP_GOTO_ON_ERROR(b64_finish(&s), done, TAG, "b64 tail");
+    ESP_GOTO_ON_ERROR(https_pool_write(writer, body->suffix, body->suffix_len), done, TAG, "suffix");
+
+done:
+    interaction_arena_free(s.out);
+    return ret;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "https_pool.h"
+#include "uplink_codec.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Put this string where the base64 WAV belongs in a JSON payload
+#define WAV_UPLOAD_MARKER "@@wav_upload_audio@@"
+
+#define WAV_UPLOAD_HEADER_BYTES 44
+
+/**
+ * JSON request whose audio field is streamed as base64 WAV.
+ *
+ * The prefix and suffix point into the caller's payload string, which must
+ * outlive the request. PCM16 is read in place; other codecs are encoded
+ * block by block while the body is written, into a WAV with that format tag.
+ */
+typedef struct {
+    const char *prefix;
+    size_t prefix_len;
+    const char *suffix;
+    size_t suffix_len;
+    const int16_t *pcm;
+    size_t sample_count;
+    int sample_rate_hz;
+    uplink_codec_id_t codec;
+} wav_upload_body_t;
+
+/**
+ * Split payload at WAV_UPLOAD_MARKER and bind the audio to stream there.
+ */
+esp_err_t wav_upload_body_init(wav_upload_body_t *body, const char *payload,
+                               const int16_t *pcm, size_t sample_count, int sample_rate_hz,
+                               uplink_codec_id_t codec);
+
+/**
+ * Exact Content-Length of the streamed body.
+ */
+size_t wav_upload_body_length(const wav_upload_body_t *body);
+
+/**
+ * https_pool_body_cb_t: write prefix, base64(WAV header + audio) in small
+ * blocks, then suffix. ctx is a wav_upload_body_t.
+ */
+esp_err_t wav_upload_body_write(https_pool_writer_t *writer, void *ctx);
+
+#ifdef __cplusplus
+}
+#endif
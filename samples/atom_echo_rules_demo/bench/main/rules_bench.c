@@ -0,0 +1,566 @@
+/**
+ * @file rules_bench.c
+ * @brief Rule engine and rule store scaling over synthetic rule sets
+ *
+ * Each size in RULE_COUNTS up to CONFIG_RULES_BENCH_MAX_RULES gets a rules
+ * document generated from a fixed seed: sensor_change rules spread over the
+ * six channels and time_window rules over the day, each with one to three
+ * conditions and one or two actions. The document is then
+ *
+ * - compiled BENCH_COMPILE_RUNS times, keeping the fastest, and once more
+ *   with cJSON's allocations counted for the parse tree's peak;
+ * - fed CONFIG_RULES_BENCH_EVENTS readings, one channel at a time as
+ *   sensor_reader delivers them, each a random walk step, timing every
+ *   rule_set_on_sensor() call;
+ * - stepped through a day a minute at a time with rule_set_on_time(),
+ *   after the rescan a clock jump costs;
+ * - passed to rule_store_update() on a store that does not persist and on
+ *   one that does, the difference being the slot write, and loaded back
+ *   with rule_store_init() as at boot.
+ *
+ * Every size prints one "BENCH run=rules" line.
+ */
+
+#include <inttypes.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cJSON.h"
+#include "esp_check.h"
+#include "esp_log.h"
+#include "json_writer.h"
+#include "rule_engine.h"
+#include "rule_store.h"
+#include "sdkconfig.h"
+#include "storage.h"
+
+#if CONFIG_IDF_TARGET_LINUX
+#include <time.h>
+#else
+#include "esp_cpu.h"
+#include "esp_timer.h"
+#endif
+
+static const char *TAG = "rules_bench";
+
+#define BENCH_COMPILE_RUNS 3
+#define BENCH_MINUTES_PER_DAY (24 * 60)
+#define BENCH_START_MINUTE (7 * 60)     // Simulated clock at the first reading
+#define BENCH_ALLOC_HEADER 16           // Keeps counted blocks as aligned as malloc()'s
+#define BENCH_HOST_DIR "/tmp/rules_bench"  // RULES_BENCH_DIR overrides it on the host
+
+static const uint16_t RULE_COUNTS[] = {100, 250, 500, 1000, 2000, 4000, 8000};
+
+// How each channel wanders, and how wide the bands of rules on it are
+typedef struct {
+    const char *name;                   // As rules documents spell it
+    float mid;
+    float span;                         // Readings stay within mid +- span
+    float step;                         // Largest change per reading
+    float min_delta;                    // Rules use one to four times this
+} bench_channel_t;
+
+static const bench_channel_t CHANNELS[RULE_SENSOR_COUNT] = {
+    [RULE_SENSOR_TEMP_C] = {"temp_c", 22.0f, 6.0f, 0.1f, 0.2f},
+    [RULE_SENSOR_HUMIDITY_PCT] = {"humidity_pct", 45.0f, 20.0f, 0.5f, 1.0f},
+    [RULE_SENSOR_PRESSURE_HPA] = {"pressure_hpa", 1013.0f, 15.0f, 0.2f, 0.5f},
+    [RULE_SENSOR_VOC_INDEX] = {"voc_index", 120.0f, 100.0f, 3.0f, 5.0f},
+    [RULE_SENSOR_CO2_PPM] = {"co2_ppm", 800.0f, 500.0f, 10.0f, 25.0f},
+    [RULE_SENSOR_PRESENCE] = {"presence", 0.5f, 0.5f, 1.0f, 0.5f},  // Flips instead of walking
+};
+
+static const char *const DAY_NAMES[] = {"Mon", "Tue", "Wed", "Thu", "Fri", "Sat", "Sun"};
+static const char *const COMPARE_OPS[] = {"<", "<=", ">", ">="};
+static const char *const SCENES[] = {"warm_dim", "cool_bright", "night_light", "sunrise"};
+static const int REPEAT_SEC[] = {0, 10, 60, 300};
+
+typedef struct {
+    uint32_t count;
+    uint32_t seed;
+} bench_doc_t;
+
+typedef struct {
+    double mean_us;
+    double p50_us;
+    double p99_us;
+    double max_us;
+} bench_stats_t;
+
+// cJSON's allocations while counting, for the parse tree's peak
+static struct {
+    size_t live;
+    size_t peak;
+} s_parse;
+
+static char s_rules_path[96];
+
+// xorshift32: a seed always gives the same documents and readings
+static uint32_t bench_rand(uint32_t *state)
+{
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+// Uniform in [lo, hi)
+static float bench_uniform(uint32_t *state, float lo, float hi)
+{
+    return lo + (hi - lo) * (float)(bench_rand(state) >> 8) / (float)(1u << 24);
+}
+
+// Short spans: CPU cycles on the device, wall time on the host
+static inline uint64_t bench_mark(void)
+{
+#if CONFIG_IDF_TARGET_LINUX
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+#else
+    return esp_cpu_get_cycle_count();
+#endif
+}
+
+static inline uint32_t bench_elapsed_ns(uint64_t from, uint64_t to)
+{
+#if CONFIG_IDF_TARGET_LINUX
+    return (uint32_t)(to - from);
+#else
+    uint32_t cycles = (uint32_t)to - (uint32_t)from;
+    return (uint32_t)((uint64_t)cycles * 1000 / CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ);
+#endif
+}
+
+// Spans that may outlast the cycle counter's wrap
+static int64_t bench_now_us(void)
+{
+#if CONFIG_IDF_TARGET_LINUX
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+#else
+    return esp_timer_get_time();
+#endif
+}
+
+static void *counted_malloc(size_t size)
+{
+    uint8_t *block = malloc(BENCH_ALLOC_HEADER + size);
+    if (!block) {
+        return NULL;
+    }
+    memcpy(block, &size, sizeof(size));
+    s_parse.live += size;
+    if (s_parse.live > s_parse.peak) {
+        s_parse.peak = s_parse.live;
+    }
+    return block + BENCH_ALLOC_HEADER;
+}
+
+static void counted_free(void *ptr)
+{
+    if (!ptr) {
+        return;
+    }
+    uint8_t *block = (uint8_t *)ptr - BENCH_ALLOC_HEADER;
+    size_t size;
+    memcpy(&size, block, sizeof(size));
+    s_parse.live -= size;
+    free(block);
+}
+
+static void write_minute(json_writer_t *w, const char *key, int minute)
+{
+    char hhmm[8];
+    snprintf(hhmm, sizeof(hhmm), "%02d:%02d", minute / 60 % 24, minute % 60);
+    json_writer_string(w, key, hhmm);
+}
+
+static void write_condition(json_writer_t *w, uint32_t *rng)
+{
+    json_writer_begin_object(w, NULL);
+    uint32_t pick = bench_rand(rng) % (RULE_SENSOR_COUNT + 1);
+    if (pick == RULE_SENSOR_COUNT) {
+        int start = (int)(bench_rand(rng) % BENCH_MINUTES_PER_DAY);
+        json_writer_string(w, "sensor", "time_local");
+        json_writer_string(w, "op", "IN_WINDOW");
+        json_writer_begin_object(w, "value");
+        write_minute(w, "start", start);
+        write_minute(w, "end", start + 60 + (int)(bench_rand(rng) % 480));
+        json_writer_end_object(w);
+    } else if (pick == RULE_SENSOR_PRESENCE) {
+        json_writer_string(w, "sensor", CHANNELS[pick].name);
+        json_writer_string(w, "op", "==");
+        json_writer_bool(w, "value", bench_rand(rng) & 1);
+    } else {
+        const bench_channel_t *channel = &CHANNELS[pick];
+        json_writer_string(w, "sensor", channel->name);
+        json_writer_string(w, "op", COMPARE_OPS[bench_rand(rng) % 4]);
+        json_writer_float(w, "value", bench_uniform(rng, channel->mid - channel->span, channel->mid + channel->span));
+    }
+    json_writer_end_object(w);
+}
+
+static void write_action(json_writer_t *w, uint32_t *rng)
+{
+    json_writer_begin_object(w, NULL);
+    switch (bench_rand(rng) % 3) {
+    case 0:
+        json_writer_string(w, "type", "set_light");
+        json_writer_string(w, "mode", "scene");
+        json_writer_string(w, "scene_id", SCENES[bench_rand(rng) % 4]);
+        json_writer_int(w, "transition_ms", 1000);
+        break;
+    case 1:
+        json_writer_string(w, "type", "set_light");
+        json_writer_string(w, "mode", "color");
+        json_writer_begin_array(w, "color_rgb");
+        for (int i = 0; i < 3; i++) {
+            json_writer_int(w, NULL, bench_rand(rng) & 0xFF);
+        }
+        json_writer_end_array(w);
+        json_writer_float(w, "brightness", 0.3f);
+        break;
+    default:
+        json_writer_string(w, "type", "set_sound");
+        json_writer_string(w, "mode", "playlist");
+        json_writer_string(w, "playlist_id", "bench_playlist");
+        json_writer_float(w, "volume", 0.25f);
+        break;
+    }
+    json_writer_end_object(w);
+}
+
+static void write_rule(json_writer_t *w, uint32_t index, uint32_t *rng)
+{
+    char id[20];
+    snprintf(id, sizeof(id), "bench_%05" PRIu32, index);
+    json_writer_begin_object(w, NULL);
+    json_writer_string(w, "id", id);
+    json_writer_bool(w, "enabled", true);
+
+    json_writer_begin_object(w, "trigger");
+    if (bench_rand(rng) % 100 < CONFIG_RULES_BENCH_SENSOR_PCT) {
+        const bench_channel_t *channel = &CHANNELS[bench_rand(rng) % RULE_SENSOR_COUNT];
+        json_writer_string(w, "type", "sensor_change");
+        json_writer_string(w, "sensor", channel->name);
+        json_writer_float(w, "min_delta", channel->min_delta * (float)(1 + bench_rand(rng) % 4));
+    } else {
+        int start = (int)(bench_rand(rng) % BENCH_MINUTES_PER_DAY);
+        json_writer_string(w, "type", "time_window");
+        write_minute(w, "start_local", start);
+        write_minute(w, "end_local", start + 15 + (int)(bench_rand(rng) % 240));
+        // Half run every day, the rest on some days
+        if (bench_rand(rng) & 1) {
+            uint32_t days = bench_rand(rng) & 0x7F;
+            json_writer_begin_array(w, "days");
+            for (int day = 0; day < 7; day++) {
+                if ((days ? days : 1u) & (1u << day)) {
+                    json_writer_string(w, NULL, DAY_NAMES[day]);
+                }
+            }
+            json_writer_end_array(w);
+        }
+    }
+    json_writer_end_object(w);
+
+    json_writer_begin_object(w, "conditions");
+    json_writer_string(w, "logic", bench_rand(rng) % 4 == 0 ? "ANY" : "ALL");
+    json_writer_begin_array(w, "items");
+    for (uint32_t n = 1 + bench_rand(rng) % 3; n > 0; n--) {
+        write_condition(w, rng);
+    }
+    json_writer_end_array(w);
+    json_writer_end_object(w);
+
+    json_writer_begin_array(w, "actions");
+    for (uint32_t n = 1 + bench_rand(rng) % 2; n > 0; n--) {
+        write_action(w, rng);
+    }
+    json_writer_end_array(w);
+
+    json_writer_begin_object(w, "limits");
+    json_writer_int(w, "min_repeat_sec", REPEAT_SEC[bench_rand(rng) % 4]);
+    json_writer_end_object(w);
+    json_writer_end_object(w);
+}
+
+// Runs twice per document, so everything comes from the seed in the spec
+static void build_document(json_writer_t *w, const void *arg)
+{
+    const bench_doc_t *spec = (const bench_doc_t *)arg;
+    uint32_t rng = spec->seed;
+    char version[24];
+    snprintf(version, sizeof(version), "bench-%" PRIu32, spec->count);
+    json_writer_begin_object(w, NULL);
+    json_writer_string(w, "version", version);
+    json_writer_begin_array(w, "rules");
+    for (uint32_t i = 0; i < spec->count; i++) {
+        write_rule(w, i, &rng);
+    }
+    json_writer_end_array(w);
+    json_writer_end_object(w);
+}
+
+static int cmp_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+static void stats(uint32_t *latency_ns, size_t count, uint64_t total_ns, bench_stats_t *out)
+{
+    qsort(latency_ns, count, sizeof(uint32_t), cmp_u32);
+    out->mean_us = (double)total_ns / (double)count / 1000.0;
+    out->p50_us = latency_ns[(count - 1) * 50 / 100] / 1000.0;
+    out->p99_us = latency_ns[(count - 1) * 99 / 100] / 1000.0;
+    out->max_us = latency_ns[count - 1] / 1000.0;
+}
+
+static void sample_init(rule_sample_t *sample)
+{
+    for (int c = 0; c < RULE_SENSOR_COUNT; c++) {
+        sample->values[c] = CHANNELS[c].mid;
+    }
+    sample->values[RULE_SENSOR_PRESENCE] = 1.0f;
+    sample->minute_of_day = BENCH_START_MINUTE;
+    sample->weekday = 0;
+}
+
+/**
+ * Readings at CONFIG_RULES_BENCH_EVENT_HZ of simulated time, the channels
+ * in turn, as sensor_reader hands them over
+ *
+ * @return Rules fired
+ */
+static uint32_t run_events(rule_set_t *set, uint32_t *latency_ns, bench_stats_t *out)
+{
+    uint32_t rng = (uint32_t)CONFIG_RULES_BENCH_SEED * 2654435761u | 1u;
+    rule_sample_t sample;
+    sample_init(&sample);
+    uint64_t total_ns = 0;
+    uint32_t fired = 0;
+    for (uint32_t i = 0; i < CONFIG_RULES_BENCH_EVENTS; i++) {
+        rule_sensor_t sensor = (rule_sensor_t)(i % RULE_SENSOR_COUNT);
+        const bench_channel_t *channel = &CHANNELS[sensor];
+        float *value = &sample.values[sensor];
+        if (sensor == RULE_SENSOR_PRESENCE) {
+            *value = bench_rand(&rng) % 16 == 0 ? 1.0f - *value : *value;
+        } else {
+            *value = fminf(fmaxf(*value + bench_uniform(&rng, -channel->step, channel->step),
+                                 channel->mid - channel->span),
+                           channel->mid + channel->span);
+        }
+        int64_t now_ms = (int64_t)i * 1000 / CONFIG_RULES_BENCH_EVENT_HZ;
+        sample.minute_of_day = (int16_t)((BENCH_START_MINUTE + now_ms / 60000) % BENCH_MINUTES_PER_DAY);
+
+        uint64_t t0 = bench_mark();
+        fired += (uint32_t)rule_set_on_sensor(set, sensor, &sample, now_ms, NULL, NULL);
+        uint64_t t1 = bench_mark();
+        latency_ns[i] = bench_elapsed_ns(t0, t1);
+        total_ns += latency_ns[i];
+    }
+    stats(latency_ns, CONFIG_RULES_BENCH_EVENTS, total_ns, out);
+    return fired;
+}
+
+/**
+ * A day of clock ticks. The first call finds the wheel unset and rescans
+ * every time rule, as after a clock jump; the rest advance one minute.
+ *
+ * @return Nanoseconds the rescan took
+ */
+static uint32_t run_ticks(rule_set_t *set, uint32_t *latency_ns, bench_stats_t *out)
+{
+    rule_sample_t sample;
+    sample_init(&sample);
+    sample.minute_of_day = 0;
+    uint64_t t0 = bench_mark();
+    rule_set_on_time(set, &sample, 0, NULL, NULL);
+    uint32_t rescan_ns = bench_elapsed_ns(t0, bench_mark());
+
+    uint64_t total_ns = 0;
+    for (int minute = 1; minute < BENCH_MINUTES_PER_DAY; minute++) {
+        sample.minute_of_day = (int16_t)minute;
+        t0 = bench_mark();
+        rule_set_on_time(set, &sample, (int64_t)minute * 60000, NULL, NULL);
+        uint64_t t1 = bench_mark();
+        latency_ns[minute - 1] = bench_elapsed_ns(t0, t1);
+        total_ns += latency_ns[minute - 1];
+    }
+    stats(latency_ns, BENCH_MINUTES_PER_DAY - 1, total_ns, out);
+    return rescan_ns;
+}
+
+static void remove_slots(void)
+{
+    char path[sizeof(s_rules_path) + 4];
+    for (int slot = 0; slot < 2; slot++) {
+        snprintf(path, sizeof(path), "%s.%d", s_rules_path, slot);
+        storage_remove(path);
+    }
+    storage_remove(s_rules_path);
+}
+
+// One rule_store_update() into an empty store; with persist it includes the slot write
+static esp_err_t time_update(const char *doc, bool persist, int64_t *out_us)
+{
+    remove_slots();
+    rule_store_config_t cfg = {.auto_flush = persist, .path = s_rules_path};
+    rule_store_t *store = NULL;
+    ESP_RETURN_ON_ERROR(rule_store_init(&store, &cfg), TAG, "store init");
+    int64_t start_us = bench_now_us();
+    esp_err_t err = rule_store_update(store, RULE_STORE_SOURCE_LOCAL_TEST, doc, NULL, NULL);
+    *out_us = bench_now_us() - start_us;
+    rule_store_deinit(store);
+    return err;
+}
+
+// Boot: read the newest slot, check its digest and compile it
+static esp_err_t time_load(int64_t *out_us)
+{
+    rule_store_config_t cfg = {.auto_flush = true, .path = s_rules_path};
+    rule_store_t *store = NULL;
+    int64_t start_us = bench_now_us();
+    esp_err_t err = rule_store_init(&store, &cfg);
+    *out_us = bench_now_us() - start_us;
+    rule_store_deinit(store);
+    return err;
+}
+
+static void bench_run(uint32_t count, uint32_t *latency_ns)
+{
+    const bench_doc_t spec = {.count = count, .seed = CONFIG_RULES_BENCH_SEED};
+    size_t json_len = 0;
+    char *doc = json_writer_build_alloc(build_document, &spec, malloc, free, &json_len);
+    if (!doc) {
+        printf("BENCH run=rules rules=%" PRIu32 " error=generate\n", count);
+        return;
+    }
+
+    rule_set_t *set = NULL;
+    esp_err_t err = ESP_OK;
+    int64_t compile_us = INT64_MAX;
+    for (int run = 0; run < BENCH_COMPILE_RUNS && err == ESP_OK; run++) {
+        rule_set_free(set);
+        set = NULL;
+        int64_t start_us = bench_now_us();
+        err = rule_set_compile(doc, &set);
+        int64_t us = bench_now_us() - start_us;
+        compile_us = us < compile_us ? us : compile_us;
+    }
+    if (err == ESP_OK) {
+        // Counted apart from the timed runs, which the bookkeeping would slow
+        cJSON_Hooks hooks = {.malloc_fn = counted_malloc, .free_fn = counted_free};
+        s_parse.live = 0;
+        s_parse.peak = 0;
+        cJSON_InitHooks(&hooks);
+        rule_set_t *counted = NULL;
+        err = rule_set_compile(doc, &counted);
+        cJSON_InitHooks(NULL);
+        rule_set_free(counted);
+    }
+    if (err != ESP_OK) {
+        printf("BENCH run=rules rules=%" PRIu32 " error=compile:%s\n", count, esp_err_to_name(err));
+        rule_set_free(set);
+        free(doc);
+        return;
+    }
+
+    uint32_t sensor_rules = 0;
+    uint32_t time_rules = 0;
+    uint32_t conditions = 0;
+    for (size_t i = 0; i < rule_set_count(set); i++) {
+        const rule_t *rule = rule_set_get(set, i);
+        sensor_rules += rule->trigger == RULE_TRIGGER_SENSOR_CHANGE;
+        time_rules += rule->trigger == RULE_TRIGGER_TIME_WINDOW;
+        conditions += rule->condition_count;
+    }
+    size_t set_bytes = rule_set_size(set);
+
+    bench_stats_t event;
+    bench_stats_t tick;
+    uint32_t fired = run_events(set, latency_ns, &event);
+    uint32_t rescan_ns = run_ticks(set, latency_ns, &tick);
+    rule_set_free(set);
+
+    int64_t update_us = 0;
+    int64_t persist_update_us = 0;
+    int64_t load_us = 0;
+    err = time_update(doc, false, &update_us);
+    if (err == ESP_OK) {
+        err = time_update(doc, true, &persist_update_us);
+    }
+    if (err == ESP_OK) {
+        err = time_load(&load_us);
+    }
+    remove_slots();
+    free(doc);
+
+    // One line per rule set with stable keys, so runs can be diffed or tabulated by a script
+    printf("BENCH run=rules rules=%" PRIu32 " sensor_rules=%" PRIu32 " time_rules=%" PRIu32 " conditions=%" PRIu32
+           " json_kb=%.1f compile_ms=%.2f parse_peak_kb=%.1f set_kb=%.1f",
+           count, sensor_rules, time_rules, conditions, json_len / 1024.0, compile_us / 1000.0,
+           s_parse.peak / 1024.0, set_bytes / 1024.0);
+    printf(" events=%d event_mean_us=%.2f event_p50_us=%.2f event_p99_us=%.2f event_max_us=%.2f fires_per_1k=%.1f",
+           CONFIG_RULES_BENCH_EVENTS, event.mean_us, event.p50_us, event.p99_us, event.max_us,
+           fired * 1000.0 / CONFIG_RULES_BENCH_EVENTS);
+    printf(" rescan_us=%.1f tick_p50_us=%.2f tick_p99_us=%.2f tick_max_us=%.2f", rescan_ns / 1000.0, tick.p50_us,
+           tick.p99_us, tick.max_us);
+    if (err != ESP_OK) {
+        printf(" store_error=%s\n", esp_err_to_name(err));
+        return;
+    }
+    int64_t persist_us = persist_update_us - update_us;
+    printf(" update_ms=%.2f update_persist_ms=%.2f persist_ms=%.2f load_ms=%.2f\n", update_us / 1000.0,
+           persist_update_us / 1000.0, (persist_us > 0 ? persist_us : 0) / 1000.0, load_us / 1000.0);
+}
+
+void app_main(void)
+{
+    // The engine and store log every compile, write and missing slot; failures show in the BENCH lines
+    esp_log_level_set("rule_engine", ESP_LOG_ERROR);
+    esp_log_level_set("rule_store", ESP_LOG_ERROR);
+
+    storage_config_t storage_cfg = {0};
+#if CONFIG_IDF_TARGET_LINUX
+    const char *dir = getenv("RULES_BENCH_DIR");
+    storage_cfg.base_path = dir ? dir : BENCH_HOST_DIR;
+#endif
+    esp_err_t err = storage_mount(&storage_cfg);
+    snprintf(s_rules_path, sizeof(s_rules_path), "%s/bench_rules.json",
+             storage_cfg.base_path ? storage_cfg.base_path : CONFIG_STORAGE_BASE_PATH);
+    size_t slots = CONFIG_RULES_BENCH_EVENTS > BENCH_MINUTES_PER_DAY ? CONFIG_RULES_BENCH_EVENTS
+                                                                      : BENCH_MINUTES_PER_DAY;
+    uint32_t *latency_ns = malloc(slots * sizeof(uint32_t));
+    if (err != ESP_OK || !latency_ns) {
+        ESP_LOGE(TAG, "No %s", latency_ns ? "storage" : "memory for latencies");
+        free(latency_ns);
+#if CONFIG_IDF_TARGET_LINUX
+        exit(1);
+#else
+        return;
+#endif
+    }
+
+    ESP_LOGI(TAG, "Seed %d, %d%% sensor_change rules, %d readings at %d Hz per set, rules in %s",
+             CONFIG_RULES_BENCH_SEED, CONFIG_RULES_BENCH_SENSOR_PCT, CONFIG_RULES_BENCH_EVENTS,
+             CONFIG_RULES_BENCH_EVENT_HZ, s_rules_path);
+    for (size_t i = 0; i < sizeof(RULE_COUNTS) / sizeof(RULE_COUNTS[0]); i++) {
+        if (RULE_COUNTS[i] <= CONFIG_RULES_BENCH_MAX_RULES) {
+            bench_run(RULE_COUNTS[i], latency_ns);
+        }
+    }
+    free(latency_ns);
+    ESP_LOGI(TAG, "Done");
+#if CONFIG_IDF_TARGET_LINUX
+    // Host runs are batch jobs
+    exit(0);
+#endif
+}
@@ -0,0 +1,135 @@
+/**
+ * @file storage_host.c
+ * @brief storage.h on the host filesystem, for the linux target
+ *
+ * The host has no LittleFS partition, so files live in a directory that
+ * storage_mount() creates, and storage_write_atomic() writes a temporary
+ * file, syncs it and renames it over the target, which POSIX makes atomic
+ * as LittleFS does. Persistence times measured here are the host disk's,
+ * not the flash's.
+ */
+
+#include "storage.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "esp_log.h"
+
+static const char *TAG = "storage";
+
+#define TMP_SUFFIX ".tmp"
+#define PATH_MAX_LEN 128
+
+static bool s_mounted;
+
+esp_err_t storage_mount(const storage_config_t *cfg)
+{
+    if (s_mounted) {
+        return ESP_OK;
+    }
+    const char *base_path = cfg && cfg->base_path ? cfg->base_path : CONFIG_STORAGE_BASE_PATH;
+    if (mkdir(base_path, 0755) != 0 && errno != EEXIST) {
+        ESP_LOGE(TAG, "Creating %s failed: errno %d", base_path, errno);
+        return ESP_FAIL;
+    }
+    s_mounted = true;
+    ESP_LOGI(TAG, "Host directory %s", base_path);
+    return ESP_OK;
+}
+
+bool storage_mounted(void)
+{
+    return s_mounted;
+}
+
+esp_err_t storage_read(const char *path, char **out_data, size_t *out_len)
+{
+    if (!path || !out_data) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *out_data = NULL;
+    if (out_len) {
+        *out_len = 0;
+    }
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        return errno == ENOENT ? ESP_ERR_NOT_FOUND : ESP_FAIL;
+    }
+    struct stat st;
+    if (fstat(fileno(f), &st) != 0 || st.st_size < 0) {
+        fclose(f);
+        return ESP_FAIL;
+    }
+    size_t len = (size_t)st.st_size;
+    char *data = malloc(len + 1);
+    if (!data) {
+        fclose(f);
+        return ESP_ERR_NO_MEM;
+    }
+    bool ok = fread(data, 1, len, f) == len;
+    fclose(f);
+    if (!ok) {
+        free(data);
+        return ESP_FAIL;
+    }
+    data[len] = '\0';
+    *out_data = data;
+    if (out_len) {
+        *out_len = len;
+    }
+    return ESP_OK;
+}
+
+esp_err_t storage_write_atomic(const char *path, const void *data, size_t len)
+{
+    if (!path || (!data && len > 0)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!s_mounted) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    char tmp[PATH_MAX_LEN];
+    if (snprintf(tmp, sizeof(tmp), "%s" TMP_SUFFIX, path) >= (int)sizeof(tmp)) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    FILE *f = fopen(tmp, "wb");
+    if (!f) {
+        return ESP_FAIL;
+    }
+    bool ok = fwrite(data, 1, len, f) == len && fflush(f) == 0 && fsync(fileno(f)) == 0;
+    ok = fclose(f) == 0 && ok;
+    if (!ok || rename(tmp, path) != 0) {
+        ESP_LOGE(TAG, "Replacing %s failed: errno %d", path, errno);
+        unlink(tmp);
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+esp_err_t storage_remove(const char *path)
+{
+    if (!path) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (unlink(path) != 0 && errno != ENOENT) {
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+// The host's disk has no partition size worth reporting
+esp_err_t storage_info(size_t *out_total, size_t *out_used)
+{
+    if (out_total) {
+        *out_total = 0;
+    }
+    if (out_used) {
+        *out_used = 0;
+    }
+    return s_mounted ? ESP_ERR_NOT_SUPPORTED : ESP_ERR_INVALID_STATE;
+}
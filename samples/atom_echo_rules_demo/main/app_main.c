@@ -38,14 +38,19 @@
 #include "nvs_flash.h"
 #include "rule_store.h"
 #include "rule_update_channel.h"
+#include "routine_scheduler.h"
 #include "scene_controller.h"
+#include "sensor_manager.h"
 #include "somnus_ble.h"
 #include "somnus_mqtt.h"
 #include "spotify_client.h"
 #include "spotify_player.h"
+#include "storage.h"
+#include "timer_wheel.h"
 #include "wifi_manager.h"
 #include "webserver.h"
 #include "ota_updater.h"
+#include "ota_jobs.h"
 #include "audio_player.h"
 #include "driver/i2c.h"
 
@@ -65,6 +70,7 @@ static void *s_led_handle;
 static display_matrix_t *s_display = NULL;
 static status_display_t s_status_display;
 static face_led_simulator_t s_face_led_simulator;
+static ir_tx_t s_ir_tx;
 
 // Voice/audio state tracking is now handled directly by status_display_set_* functions
 // which update the status_display_t structure from the Gemini pipeline
@@ -84,6 +90,13 @@ static void mqtt_action_handler(const char *payload, void *ctx)
 {
     (void)ctx;
     ESP_LOGI(TAG, "Somnus MQTT payload: %s", payload);
+
+#if CONFIG_ATOM_ECHO_ROUTINES
+    // Routine lists are kept and run from the device clock
+    if (routine_scheduler_update(payload) != ESP_ERR_NOT_SUPPORTED) {
+        return;
+    }
+#endif
     
     // Try SomnusDevice-style action handler first
     if (s_led_handle) {
@@ -103,6 +116,16 @@ static void mqtt_action_handler(const char *payload, void *ctx)
     }
 }
 
+// Streaming path: somnus_mqtt hands over one action at a time, no full DOM
+static esp_err_t mqtt_action_item_handler(const somnus_mqtt_action_t *action, void *ctx)
+{
+    (void)ctx;
+    if (!s_led_handle) {
+        return ESP_ERR_NOT_SUPPORTED; // Falls back to mqtt_action_handler
+    }
+    return somnus_action_handler_process_action(action, (scene_controller_t *)s_led_handle);
+}
+
 static esp_err_t mount_spiffs(void)
 {
     esp_vfs_spiffs_conf_t conf = {
@@ -135,6 +158,65 @@ static void rule_store_observer(const rule_store_snapshot_t *snapshot,
     rule_update_channel_apply_snapshot(channel, snapshot);
 }
 
+// Live dashboard events over /ws; each returns at once with no dashboard connected
+static void live_push(const char *type, const char *name, cJSON *data)
+{
+    if (data) {
+        webserver_push_json(s_webserver, type, name, data);
+        cJSON_Delete(data);
+    }
+}
+
+static void live_light_changed(const led_effect_layer_t *layer, const char *scene_id, void *ctx)
+{
+    (void)ctx;
+    if (!webserver_has_live_clients(s_webserver)) {
+        return;
+    }
+    cJSON *data = cJSON_CreateObject();
+    cJSON_AddBoolToObject(data, "on", layer != NULL);
+    if (layer) {
+        const int rgb[3] = {layer->color.r, layer->color.g, layer->color.b};
+        cJSON_AddItemToObject(data, "rgb", cJSON_CreateIntArray(rgb, 3));
+        cJSON_AddNumberToObject(data, "intensity", layer->intensity);
+        cJSON_AddNumberToObject(data, "effect", layer->kind);
+    }
+    live_push("led", scene_id, data);
+}
+
+static void live_rule_fired(const rule_t *rule, void *ctx)
+{
+    (void)ctx;
+    if (!webserver_has_live_clients(s_webserver)) {
+        return;
+    }
+    cJSON *data = cJSON_CreateObject();
+    cJSON_AddStringToObject(data, "trigger", rule_trigger_name((rule_trigger_type_t)rule->trigger));
+    cJSON_AddNumberToObject(data, "actions", rule->action_count);
+    live_push("rule", rule->id, data);
+}
+
+static void live_ble_log(const char *type, uint32_t timestamp_ms, const char *message, void *ctx)
+{
+    (void)ctx;
+    if (!webserver_has_live_clients(s_webserver)) {
+        return;
+    }
+    cJSON *data = cJSON_CreateObject();
+    cJSON_AddStringToObject(data, "type", type);
+    cJSON_AddNumberToObject(data, "timestamp_ms", timestamp_ms);
+    cJSON_AddStringToObject(data, "message", message);
+    live_push("ble_log", NULL, data);
+}
+
+static void live_sensor_state(const char *sensor_name, const cJSON *sensor_state, void *ctx)
+{
+    (void)ctx;
+    if (sensor_state) {
+        webserver_push_json(s_webserver, "sensor", sensor_name, sensor_state);
+    }
+}
+
 static void log_device_snapshot(void)
 {
     char *json = device_state_to_json();
@@ -349,6 +431,7 @@ static void maybe_start_cloud_services(void)
         somnus_mqtt_config_t mqtt_cfg = {
             .action_cb = mqtt_action_handler,
             .action_ctx = NULL,
+            .action_item_cb = mqtt_action_item_handler,
         };
         aws_led_set_connected(false);
         esp_err_t err = somnus_mqtt_start(&mqtt_cfg);
@@ -356,6 +439,11 @@ static void maybe_start_cloud_services(void)
             ESP_LOGI(TAG, "Somnus MQTT service started");
             s_aws_started = true;
             device_state_set_aws(true);
+#if CONFIG_ATOM_ECHO_OTA_JOBS
+            if (ota_jobs_start() != ESP_OK) {
+                ESP_LOGW(TAG, "AWS IoT Jobs client not started");
+            }
+#endif
             
             // Update status display
             if (s_display) {
@@ -418,7 +506,7 @@ static void maybe_start_cloud_services(void)
             if (!s_spotify_player_started) {
                 spotify_player_config_t player_cfg = {
                     .device_name = device_name,
-                    .credentials_path = "/spiffs/spotify_blob.json",
+                    .credentials_path = STORAGE_PATH("spotify_blob.json"),
                     .zeroconf_port = 8080,
                 };
                 esp_err_t player_err = spotify_player_start(&player_cfg);
@@ -482,6 +570,9 @@ void app_main(void)
     }
 
     ESP_ERROR_CHECK(mount_spiffs());
+    ESP_ERROR_CHECK(storage_mount(NULL));
+    // Before anything makes a timer (the action handler's control coalescers)
+    ESP_ERROR_CHECK(timer_wheel_init());
     device_state_init();
     device_state_set_wifi(false, NULL);
     device_state_set_aws(false);
@@ -496,6 +587,7 @@ void app_main(void)
         .connect_cb = ble_connect_wifi_cb,
         .connect_ctx = NULL,
     };
+    somnus_ble_set_log_cb(live_ble_log, NULL);
     esp_err_t ble_err = somnus_ble_start(&ble_cfg);
     bool ble_running = false;
     if (ble_err == ESP_OK) {
@@ -537,9 +629,10 @@ void app_main(void)
             ESP_LOGI(TAG, "Display initialised as 10x10 tile grid");
             
             // Display naphome.png image (moved down 15px to make room for status icons)
-            err = display_matrix_draw_bitmap(display, 0, 15, 
-                                             NAPHOME_WIDTH, NAPHOME_HEIGHT, 
-                                             naphome_data);
+            err = image_asset_draw(display, 0, 15, &naphome_asset);
+            if (err == ESP_OK) {
+                err = display_matrix_flush(display);
+            }
             if (err == ESP_OK) {
                 ESP_LOGI(TAG, "Naphome image displayed successfully");
             } else {
@@ -548,7 +641,7 @@ void app_main(void)
             
             // Initialize face LED simulator
             ESP_LOGI(TAG, "Initializing face LED simulator...");
-            err = face_led_simulator_init(&s_face_led_simulator, display, naphome_face_data, naphome_data);
+            err = face_led_simulator_init(&s_face_led_simulator, display, &naphome_face_asset);
             bool face_led_ok = (err == ESP_OK);
             if (face_led_ok) {
                 ESP_LOGI(TAG, "Face LED simulator initialized");
@@ -654,52 +747,6 @@ void app_main(void)
 #else
             ESP_LOGW(TAG, "Audio player disabled (CONFIG_ATOM_ECHO_AUDIO_ENABLED=n)");
 #endif
-            
-            // LED demo disabled for faster boot and BLE initialization
-            // Demo: Cycle through all LED patterns on init (after status icons are shown)
-            #if 0
-            if (face_led_ok) {
-                ESP_LOGI(TAG, "Starting LED pattern demo loop...");
-                struct {
-                    face_led_pattern_t pattern;
-                    uint8_t r, g, b;
-                    const char *name;
-                    int duration_ms;
-                } demo_patterns[] = {
-                    {FACE_LED_PATTERN_NONE, 255, 100, 100, "Solid Red", 2000},
-                    {FACE_LED_PATTERN_BREATHING, 0, 255, 255, "Breathing Cyan", 3000},
-                    {FACE_LED_PATTERN_GRADIENT_RED_BLUE, 255, 150, 150, "Red-Blue Gradient", 4000},
-                    {FACE_LED_PATTERN_GRADIENT_RED_YELLOW, 220, 38, 38, "Red-Yellow Gradient", 4000},
-                    {FACE_LED_PATTERN_GRADIENT_WHITE_BLUE, 14, 165, 233, "White-Blue Gradient", 4000},
-                    {FACE_LED_PATTERN_GRADIENT_BLUE_GREEN, 6, 182, 212, "Blue-Green Gradient", 4000},
-                    {FACE_LED_PATTERN_GRADIENT_TEAL_ORANGE, 244, 114, 182, "Teal-Orange Gradient", 4000},
-                    {FACE_LED_PATTERN_PULSE_ORANGE, 255, 135, 0, "Orange Pulse", 5000},
-                    {FACE_LED_PATTERN_PULSE_LILAC, 255, 100, 255, "Lilac Pulse", 5000},
-                };
-                
-                for (int i = 0; i < sizeof(demo_patterns) / sizeof(demo_patterns[0]); i++) {
-                    ESP_LOGI(TAG, "Demo pattern %d/%d: %s", i + 1, 
-                             (int)(sizeof(demo_patterns) / sizeof(demo_patterns[0])), 
-                             demo_patterns[i].name);
-                    face_led_simulator_set_pattern(&s_face_led_simulator,
-                                                   demo_patterns[i].pattern,
-                                                   demo_patterns[i].r,
-                                                   demo_patterns[i].g,
-                                                   demo_patterns[i].b,
-                                                   0.8f); // 80% intensity
-                    vTaskDelay(pdMS_TO_TICKS(demo_patterns[i].duration_ms));
-                }
-                
-                // Stop demo and return to background image
-                face_led_simulator_stop_pattern(&s_face_led_simulator);
-                ESP_LOGI(TAG, "LED pattern demo complete, returning to background image");
-                
-                // Redraw background image (moved down 15px)
-                display_matrix_draw_bitmap(display, 0, 15, 
-                                         NAPHOME_WIDTH, NAPHOME_HEIGHT, 
-                                         naphome_data);
-            }
-            #endif
         } else {
             ESP_LOGE(TAG, "Display initialization failed: %s", esp_err_to_name(err));
         }
@@ -728,6 +775,20 @@ void app_main(void)
     }
     s_lights_available = (scene != NULL);
     s_led_handle = scene;
+
+    // After the strip, so it keeps the RMT channel (and DMA) it asked for
+    if (CONFIG_ATOM_ECHO_IR_TX_GPIO >= 0) {
+        ir_tx_config_t ir_cfg = {
+            .gpio = CONFIG_ATOM_ECHO_IR_TX_GPIO,
+        };
+        err = ir_tx_init(&s_ir_tx, &ir_cfg);
+        if (err == ESP_OK) {
+            somnus_action_handler_set_ir_tx(&s_ir_tx);
+        } else {
+            ESP_LOGW(TAG, "IR transmitter init failed (%s)", esp_err_to_name(err));
+        }
+    }
+    scene_controller_set_light_observer(scene, live_light_changed, NULL);
     device_state_set_context(s_led_handle,
                              s_lights_available,
                              s_aws_started,
@@ -737,7 +798,7 @@ void app_main(void)
     rule_store_t *store = NULL;
     rule_store_config_t store_cfg = {
         .auto_flush = true,
-        .spiffs_path = "/spiffs/rules.json",
+        .seed_path = "/spiffs/rules.json",
     };
     ESP_ERROR_CHECK(rule_store_init(&store, &store_cfg));
 
@@ -745,10 +806,21 @@ void app_main(void)
         .store = store,
         .scene = scene,
         .display = display,
+        .fired_cb = live_rule_fired,
     };
     ESP_ERROR_CHECK(rule_update_channel_init(&s_rule_channel, &rule_channel_cfg));
     rule_store_set_observer(store, rule_store_observer, s_rule_channel);
 
+#if CONFIG_ATOM_ECHO_ROUTINES
+    routine_scheduler_config_t routine_cfg = {
+        .scene = scene,
+    };
+    err = routine_scheduler_start(&routine_cfg);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Routine scheduler not started (%s)", esp_err_to_name(err));
+    }
+#endif
+
     // Initialize OTA updater
     // GitHub token should be set via Kconfig (CONFIG_OTA_GITHUB_TOKEN) or environment variable
     // For security, never hardcode tokens in source code
@@ -813,6 +885,7 @@ void app_main(void)
         if (err == ESP_OK) {
             ESP_LOGI(TAG, "HTTP webserver started on port %d", webserver_cfg.port);
             ESP_LOGI(TAG, "Access dashboard at http://nap.local/ (after WiFi connects)");
+            sensor_manager_set_observer(live_sensor_state, NULL);
         } else {
             ESP_LOGW(TAG, "Failed to start HTTP webserver: %s", esp_err_to_name(err));
         }
@@ -7,25 +7,13 @@
 #include "esp_check.h"
 #include "esp_log.h"
 #include "esp_system.h"
+#include "freertos/FreeRTOS.h"
 #include "sensor_integration.h"
 
 static const char *TAG = "device_state";
 
-typedef struct {
-    bool wifi_connected;
-    char wifi_ssid[33];
-    bool aws_connected;
-    bool spotify_ready;
-    bool gemini_ready;
-    char gemini_summary[256];
-    char i2c_summary[256];
-    void *led_handle;
-    bool lights_enabled;
-    bool audio_muted;
-    bool audio_playing;
-} device_state_snapshot_t;
-
 static device_state_snapshot_t s_state;
+static portMUX_TYPE s_state_lock = portMUX_INITIALIZER_UNLOCKED;  // Setters and readers run on different tasks
 
 void device_state_init(void)
 {
@@ -39,11 +27,13 @@ void device_state_set_context(void *led_handle,
                               bool muted,
                               bool audio_playing)
 {
+    portENTER_CRITICAL(&s_state_lock);
     s_state.led_handle = led_handle;
     s_state.lights_enabled = lights_enabled;
     s_state.aws_connected = aws_connected;
     s_state.audio_muted = muted;
     s_state.audio_playing = audio_playing;
+    portEXIT_CRITICAL(&s_state_lock);
     ESP_LOGI(TAG,
              "Context updated: LEDs=%s AWS=%s Audio=%s Muted=%s",
              lights_enabled ? "ON" : "OFF",
@@ -54,73 +44,103 @@ void device_state_set_context(void *led_handle,
 
 void device_state_set_wifi(bool connected, const char *ssid)
 {
+    portENTER_CRITICAL(&s_state_lock);
     s_state.wifi_connected = connected;
     if (ssid) {
         strlcpy(s_state.wifi_ssid, ssid, sizeof(s_state.wifi_ssid));
     } else if (!connected) {
         s_state.wifi_ssid[0] = '\0';
     }
+    portEXIT_CRITICAL(&s_state_lock);
 }
 
 void device_state_set_aws(bool connected)
 {
+    portENTER_CRITICAL(&s_state_lock);
     s_state.aws_connected = connected;
+    portEXIT_CRITICAL(&s_state_lock);
 }
 
 void device_state_set_spotify(bool ready)
 {
+    portENTER_CRITICAL(&s_state_lock);
     s_state.spotify_ready = ready;
+    portEXIT_CRITICAL(&s_state_lock);
 }
 
 void device_state_set_gemini(bool ready, const char *summary)
 {
+    portENTER_CRITICAL(&s_state_lock);
     s_state.gemini_ready = ready;
     if (summary) {
         strlcpy(s_state.gemini_summary, summary, sizeof(s_state.gemini_summary));
     } else {
         s_state.gemini_summary[0] = '\0';
     }
+    portEXIT_CRITICAL(&s_state_lock);
 }
 
 void device_state_set_i2c_summary(const char *summary_json)
 {
+    // Validate once here so readers can embed the summary without parsing it
+    bool is_json = false;
+    if (summary_json && strlen(summary_json) < sizeof(s_state.i2c_summary)) {
+        cJSON *parsed = cJSON_Parse(summary_json);
+        is_json = parsed != NULL;
+        cJSON_Delete(parsed);
+    }
+    portENTER_CRITICAL(&s_state_lock);
     if (summary_json) {
         strlcpy(s_state.i2c_summary, summary_json, sizeof(s_state.i2c_summary));
     } else {
         s_state.i2c_summary[0] = '\0';
     }
+    s_state.i2c_summary_is_json = is_json;
+    portEXIT_CRITICAL(&s_state_lock);
+}
+
+void device_state_get(device_state_snapshot_t *out)
+{
+    if (!out) {
+        return;
+    }
+    portENTER_CRITICAL(&s_state_lock);
+    *out = s_state;
+    portEXIT_CRITICAL(&s_state_lock);
 }
 
 char *device_state_to_json(void)
 {
+    device_state_snapshot_t state;
+    device_state_get(&state);
     cJSON *root = cJSON_CreateObject();
     if (!root) {
         return NULL;
     }
 
-    cJSON_AddBoolToObject(root, "wifi_connected", s_state.wifi_connected);
-    cJSON_AddStringToObject(root, "wifi_ssid", s_state.wifi_ssid);
-    cJSON_AddBoolToObject(root, "aws_connected", s_state.aws_connected);
-    cJSON_AddBoolToObject(root, "spotify_ready", s_state.spotify_ready);
-    cJSON_AddBoolToObject(root, "gemini_ready", s_state.gemini_ready);
-    cJSON_AddStringToObject(root, "gemini_summary", s_state.gemini_summary);
+    cJSON_AddBoolToObject(root, "wifi_connected", state.wifi_connected);
+    cJSON_AddStringToObject(root, "wifi_ssid", state.wifi_ssid);
+    cJSON_AddBoolToObject(root, "aws_connected", state.aws_connected);
+    cJSON_AddBoolToObject(root, "spotify_ready", state.spotify_ready);
+    cJSON_AddBoolToObject(root, "gemini_ready", state.gemini_ready);
+    cJSON_AddStringToObject(root, "gemini_summary", state.gemini_summary);
     cJSON_AddNumberToObject(root, "free_heap_bytes", esp_get_free_heap_size());
 
     cJSON *leds = cJSON_CreateObject();
-    cJSON_AddBoolToObject(leds, "enabled", s_state.lights_enabled);
+    cJSON_AddBoolToObject(leds, "enabled", state.lights_enabled);
     cJSON_AddItemToObject(root, "leds", leds);
 
     cJSON *audio = cJSON_CreateObject();
-    cJSON_AddBoolToObject(audio, "muted", s_state.audio_muted);
-    cJSON_AddBoolToObject(audio, "playing", s_state.audio_playing);
+    cJSON_AddBoolToObject(audio, "muted", state.audio_muted);
+    cJSON_AddBoolToObject(audio, "playing", state.audio_playing);
     cJSON_AddItemToObject(root, "audio", audio);
 
-    if (s_state.i2c_summary[0]) {
-        cJSON *i2c = cJSON_Parse(s_state.i2c_summary);
+    if (state.i2c_summary[0]) {
+        cJSON *i2c = state.i2c_summary_is_json ? cJSON_Parse(state.i2c_summary) : NULL;
         if (i2c) {
             cJSON_AddItemToObject(root, "i2c_scan", i2c);
         } else {
-            cJSON_AddStringToObject(root, "i2c_scan_raw", s_state.i2c_summary);
+            cJSON_AddStringToObject(root, "i2c_scan_raw", state.i2c_summary);
         }
     }
 
@@ -9,6 +9,21 @@
 extern "C" {
 #endif
 
+typedef struct {
+    bool wifi_connected;
+    char wifi_ssid[33];
+    bool aws_connected;
+    bool spotify_ready;
+    bool gemini_ready;
+    char gemini_summary[256];
+    char i2c_summary[256];
+    bool i2c_summary_is_json;         // Checked once when the summary is set
+    void *led_handle;
+    bool lights_enabled;
+    bool audio_muted;
+    bool audio_playing;
+} device_state_snapshot_t;
+
 void device_state_init(void);
 void device_state_set_wifi(bool connected, const char *ssid);
 void device_state_set_aws(bool connected);
@@ -21,6 +36,8 @@ void device_state_set_context(void *led_handle,
                               bool muted,
                               bool audio_playing);
 
+// Copy of the cached state, for readers that format it themselves
+void device_state_get(device_state_snapshot_t *out);
 char *device_state_to_json(void);  // Caller must free()
 esp_err_t gemini_execute_function_call(const char *function_name,
                                        const char *arguments_json,
@@ -0,0 +1,187 @@
+#include "display_framebuffer.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// Two rectangles merge when their union wastes no more than this many
+// pixels, roughly what the window commands of an extra transaction cost
+#define DISPLAY_FB_MERGE_SLACK 256
+
+static int rect_area(const display_rect_t *r)
+{
+    return (r->x1 - r->x0) * (r->y1 - r->y0);
+}
+
+static display_rect_t rect_union(const display_rect_t *a, const display_rect_t *b)
+{
+    display_rect_t u = {
+        .x0 = a->x0 < b->x0 ? a->x0 : b->x0,
+        .y0 = a->y0 < b->y0 ? a->y0 : b->y0,
+        .x1 = a->x1 > b->x1 ? a->x1 : b->x1,
+        .y1 = a->y1 > b->y1 ? a->y1 : b->y1,
+    };
+    return u;
+}
+
+static bool clip(const display_framebuffer_t *fb, int *x0, int *y0, int *x1, int *y1)
+{
+    if (*x0 < 0) *x0 = 0;
+    if (*y0 < 0) *y0 = 0;
+    if (*x1 > fb->width) *x1 = fb->width;
+    if (*y1 > fb->height) *y1 = fb->height;
+    return *x0 < *x1 && *y0 < *y1;
+}
+
+static void add_dirty(display_framebuffer_t *fb, display_rect_t rect)
+{
+    // Merging can make the grown rectangle overlap others, so keep folding
+    // until nothing else is worth joining
+    for (;;) {
+        size_t best = fb->dirty_count;
+        for (size_t i = 0; i < fb->dirty_count; i++) {
+            display_rect_t u = rect_union(&fb->dirty[i], &rect);
+            if (rect_area(&u) <= rect_area(&fb->dirty[i]) + rect_area(&rect) + DISPLAY_FB_MERGE_SLACK) {
+                best = i;
+                break;
+            }
+        }
+        if (best == fb->dirty_count) {
+            break;
+        }
+        rect = rect_union(&fb->dirty[best], &rect);
+        fb->dirty[best] = fb->dirty[--fb->dirty_count];
+    }
+
+    if (fb->dirty_count < DISPLAY_FB_MAX_DIRTY) {
+        fb->dirty[fb->dirty_count++] = rect;
+        return;
+    }
+
+    // List full: fold into whichever rectangle grows least
+    size_t best = 0;
+    int best_growth = 0;
+    for (size_t i = 0; i < fb->dirty_count; i++) {
+        display_rect_t u = rect_union(&fb->dirty[i], &rect);
+        int growth = rect_area(&u) - rect_area(&fb->dirty[i]);
+        if (i == 0 || growth < best_growth) {
+            best = i;
+            best_growth = growth;
+        }
+    }
+    rect = rect_union(&fb->dirty[best], &rect);
+    fb->dirty[best] = fb->dirty[--fb->dirty_count];
+    add_dirty(fb, rect);
+}
+
+esp_err_t display_framebuffer_init(display_framebuffer_t *fb, int width, int height)
+{
+    if (!fb || width <= 0 || height <= 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    memset(fb, 0, sizeof(*fb));
+    fb->pixels = calloc((size_t)width * height, sizeof(uint16_t));
+    if (!fb->pixels) {
+        return ESP_ERR_NO_MEM;
+    }
+    fb->width = width;
+    fb->height = height;
+    // Panel RAM is undefined after reset; the first flush covers all of it
+    display_framebuffer_invalidate(fb, 0, 0, width, height);
+    return ESP_OK;
+}
+
+void display_framebuffer_deinit(display_framebuffer_t *fb)
+{
+    if (!fb) {
+        return;
+    }
+    free(fb->pixels);
+    memset(fb, 0, sizeof(*fb));
+}
+
+void display_framebuffer_invalidate(display_framebuffer_t *fb, int x0, int y0, int x1, int y1)
+{
+    if (!fb || !fb->pixels || !clip(fb, &x0, &y0, &x1, &y1)) {
+        return;
+    }
+    add_dirty(fb, (display_rect_t){x0, y0, x1, y1});
+}
+
+void display_framebuffer_fill(display_framebuffer_t *fb, int x0, int y0, int x1, int y1, uint16_t rgb565)
+{
+    if (!fb || !fb->pixels || !clip(fb, &x0, &y0, &x1, &y1)) {
+        return;
+    }
+    display_rect_t changed = {x1, y1, x0, y0};
+    for (int y = y0; y < y1; y++) {
+        uint16_t *row = fb->pixels + (size_t)y * fb->width;
+        for (int x = x0; x < x1; x++) {
+            if (row[x] == rgb565) {
+                continue;
+            }
+            row[x] = rgb565;
+            if (x < changed.x0) changed.x0 = x;
+            if (x >= changed.x1) changed.x1 = x + 1;
+            if (y < changed.y0) changed.y0 = y;
+            changed.y1 = y + 1;
+        }
+    }
+    if (changed.x0 < changed.x1) {
+        add_dirty(fb, changed);
+    }
+}
+
+void display_framebuffer_blit(display_framebuffer_t *fb, int x, int y, int width, int height, const uint16_t *bitmap)
+{
+    if (!fb || !fb->pixels || !bitmap) {
+        return;
+    }
+    int x0 = x, y0 = y, x1 = x + width, y1 = y + height;
+    if (!clip(fb, &x0, &y0, &x1, &y1)) {
+        return;
+    }
+    display_rect_t changed = {x1, y1, x0, y0};
+    for (int py = y0; py < y1; py++) {
+        uint16_t *row = fb->pixels + (size_t)py * fb->width;
+        const uint16_t *src = bitmap + (size_t)(py - y) * width + (x0 - x);
+        for (int px = x0; px < x1; px++, src++) {
+            if (row[px] == *src) {
+                continue;
+            }
+            row[px] = *src;
+            if (px < changed.x0) changed.x0 = px;
+            if (px >= changed.x1) changed.x1 = px + 1;
+            if (py < changed.y0) changed.y0 = py;
+            changed.y1 = py + 1;
+        }
+    }
+    if (changed.x0 < changed.x1) {
+        add_dirty(fb, changed);
+    }
+}
+
+size_t display_framebuffer_take_dirty(display_framebuffer_t *fb, display_rect_t *out)
+{
+    if (!fb || !out) {
+        return 0;
+    }
+    size_t count = fb->dirty_count;
+    memcpy(out, fb->dirty, count * sizeof(display_rect_t));
+    fb->dirty_count = 0;
+    return count;
+}
+
+void display_framebuffer_copy(const display_framebuffer_t *fb,
+                              const display_rect_t *rect,
+                              int row,
+                              int rows,
+                              uint16_t *dst)
+{
+    int width = rect->x1 - rect->x0;
+    const uint16_t *src = fb->pixels + (size_t)(rect->y0 + row) * fb->width + rect->x0;
+    for (int r = 0; r < rows; r++) {
+        memcpy(dst, src, (size_t)width * sizeof(uint16_t));
+        dst += width;
+        src += fb->width;
+    }
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Off-screen RGB565 copy of the panel shared by the display_matrix
+ * backends. Drawing only touches RAM and records the bounding box of the
+ * pixels that actually changed; flush hands the merged dirty rectangles to
+ * the panel, so a frame costs a few SPI transactions instead of one per
+ * primitive.
+ */
+
+#define DISPLAY_FB_MAX_DIRTY 8
+
+typedef struct {
+    int x0;
+    int y0;
+    int x1;  // Exclusive
+    int y1;  // Exclusive
+} display_rect_t;
+
+typedef struct {
+    uint16_t *pixels;
+    int width;
+    int height;
+    display_rect_t dirty[DISPLAY_FB_MAX_DIRTY];
+    size_t dirty_count;
+} display_framebuffer_t;
+
+esp_err_t display_framebuffer_init(display_framebuffer_t *fb, int width, int height);
+void display_framebuffer_deinit(display_framebuffer_t *fb);
+
+// Rectangles are clipped to the panel
+void display_framebuffer_fill(display_framebuffer_t *fb, int x0, int y0, int x1, int y1, uint16_t rgb565);
+void display_framebuffer_blit(display_framebuffer_t *fb, int x, int y, int width, int height, const uint16_t *bitmap);
+
+// Mark an area for the next flush even if its pixels did not change
+void display_framebuffer_invalidate(display_framebuffer_t *fb, int x0, int y0, int x1, int y1);
+
+/**
+ * Move the pending dirty rectangles to out and start a new frame
+ *
+ * @return Number of rectangles, at most DISPLAY_FB_MAX_DIRTY
+ */
+size_t display_framebuffer_take_dirty(display_framebuffer_t *fb, display_rect_t *out);
+
+/**
+ * Copy rows [row, row + rows) of rect into dst as one contiguous bitmap, the
+ * layout the panel drivers expect
+ */
+void display_framebuffer_copy(const display_framebuffer_t *fb,
+                              const display_rect_t *rect,
+                              int row,
+                              int rows,
+                              uint16_t *dst);
+
+#ifdef __cplusplus
+}
+#endif
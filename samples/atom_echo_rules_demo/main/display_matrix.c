@@ -13,8 +13,11 @@
 #include "driver/spi_master.h"
 #include "driver/i2c.h"
 #include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
 #include "freertos/task.h"
 
+#include "display_framebuffer.h"
+
 #define DISPLAY_TAG "display_matrix"
 
 struct display_matrix {
@@ -24,10 +27,18 @@ struct display_matrix {
     bool bus_initialized;
     int tile_width;
     int tile_height;
-    uint16_t *tile_buffer;
-    size_t tile_buffer_pixels;
+    SemaphoreHandle_t lock;       // Guards the framebuffer; drawing comes from several tasks
+    display_framebuffer_t fb;
+    // Ping-pong DMA sources for flush: one is copied while the other is on the bus
+    uint16_t *dma_buffers[2];
+    size_t dma_buffer_pixels;
+    SemaphoreHandle_t dma_free;   // Counts buffers not owned by an SPI transaction
+    int next_dma_buffer;
 };
 
+// Rows of the panel each DMA buffer holds
+#define DISPLAY_DMA_ROWS 16
+
 // LP5562 I2C address (typical)
 #define LP5562_I2C_ADDR 0x30
 
@@ -224,6 +235,19 @@ static esp_err_t configure_backlight(const display_matrix_config_t *cfg, bool on
     return ESP_OK;
 }
 
+// Runs in the SPI ISR once a flushed chunk has left its buffer
+static bool color_trans_done(esp_lcd_panel_io_handle_t io,
+                             esp_lcd_panel_io_event_data_t *edata,
+                             void *user_ctx)
+{
+    (void)io;
+    (void)edata;
+    display_matrix_t *display = user_ctx;
+    BaseType_t woken = pdFALSE;
+    xSemaphoreGiveFromISR(display->dma_free, &woken);
+    return woken == pdTRUE;
+}
+
 esp_err_t display_matrix_init(display_matrix_t **out_display,
                               const display_matrix_config_t *cfg)
 {
@@ -239,6 +263,35 @@ esp_err_t display_matrix_init(display_matrix_t **out_display,
     }
     display->cfg = *cfg;
 
+    esp_err_t err = ESP_OK;
+    display->lock = xSemaphoreCreateMutex();
+    display->dma_free = xSemaphoreCreateCounting(2, 2);
+    if (!display->lock || !display->dma_free) {
+        err = ESP_ERR_NO_MEM;
+        goto fail;
+    }
+    display->dma_buffer_pixels = (size_t)cfg->panel_width * DISPLAY_DMA_ROWS;
+    if (cfg->max_transfer_bytes > 0 &&
+        display->dma_buffer_pixels * sizeof(uint16_t) > cfg->max_transfer_bytes) {
+        display->dma_buffer_pixels = cfg->max_transfer_bytes / sizeof(uint16_t);
+    }
+    if (display->dma_buffer_pixels < (size_t)cfg->panel_width) {
+        display->dma_buffer_pixels = cfg->panel_width;  // A chunk is at least one full row
+    }
+    for (int i = 0; i < 2; i++) {
+        display->dma_buffers[i] = heap_caps_malloc(display->dma_buffer_pixels * sizeof(uint16_t), MALLOC_CAP_DMA);
+        if (!display->dma_buffers[i]) {
+            ESP_LOGE(DISPLAY_TAG, "Failed to allocate DMA buffer");
+            err = ESP_ERR_NO_MEM;
+            goto fail;
+        }
+    }
+    err = display_framebuffer_init(&display->fb, cfg->panel_width, cfg->panel_height);
+    if (err != ESP_OK) {
+        ESP_LOGE(DISPLAY_TAG, "Failed to allocate framebuffer");
+        goto fail;
+    }
+
     spi_bus_config_t buscfg = {
         .sclk_io_num = cfg->sclk_gpio,
         .mosi_io_num = cfg->mosi_gpio,
@@ -247,7 +300,7 @@ esp_err_t display_matrix_init(display_matrix_t **out_display,
         .quadhd_io_num = -1,
         .max_transfer_sz = cfg->max_transfer_bytes > 0 ? cfg->max_transfer_bytes : cfg->panel_width * cfg->panel_height * sizeof(uint16_t),
     };
-    esp_err_t err = spi_bus_initialize(cfg->spi_host, &buscfg, SPI_DMA_CH_AUTO);
+    err = spi_bus_initialize(cfg->spi_host, &buscfg, SPI_DMA_CH_AUTO);
     if (err != ESP_OK) {
         ESP_LOGE(DISPLAY_TAG, "spi_bus_initialize failed (%s)", esp_err_to_name(err));
         goto fail;
@@ -262,6 +315,8 @@ esp_err_t display_matrix_init(display_matrix_t **out_display,
         .lcd_param_bits = 8,
         .spi_mode = 0,
         .trans_queue_depth = 10,
+        .on_color_trans_done = color_trans_done,
+        .user_ctx = display,
     };
     ESP_LOGI(DISPLAY_TAG, "SPI IO config: DC=%d, CS=%d, freq=%d MHz, mode=%d", 
              cfg->dc_gpio, cfg->cs_gpio, io_config.pclk_hz / 1000000, io_config.spi_mode);
@@ -446,14 +501,6 @@ esp_err_t display_matrix_init(display_matrix_t **out_display,
         goto fail;
     }
 
-    display->tile_buffer_pixels = display->tile_width * display->tile_height;
-    display->tile_buffer = heap_caps_malloc(display->tile_buffer_pixels * sizeof(uint16_t), MALLOC_CAP_DMA);
-    if (!display->tile_buffer) {
-        err = ESP_ERR_NO_MEM;
-        ESP_LOGE(DISPLAY_TAG, "Failed to allocate tile buffer");
-        goto fail;
-    }
-
     *out_display = display;
     return ESP_OK;
 
@@ -467,6 +514,10 @@ void display_matrix_deinit(display_matrix_t *display)
     if (!display) {
         return;
     }
+    // Let in-flight flush chunks finish before their buffers go away
+    for (int i = 0; i < 2 && display->dma_free && display->io; i++) {
+        xSemaphoreTake(display->dma_free, pdMS_TO_TICKS(100));
+    }
     configure_backlight(&display->cfg, false);
     if (display->panel) {
         esp_lcd_panel_disp_on_off(display->panel, false);
@@ -478,7 +529,15 @@ void display_matrix_deinit(display_matrix_t *display)
     if (display->bus_initialized) {
         spi_bus_free(display->cfg.spi_host);
     }
-    free(display->tile_buffer);
+    display_framebuffer_deinit(&display->fb);
+    free(display->dma_buffers[0]);
+    free(display->dma_buffers[1]);
+    if (display->dma_free) {
+        vSemaphoreDelete(display->dma_free);
+    }
+    if (display->lock) {
+        vSemaphoreDelete(display->lock);
+    }
     free(display);
 }
 
@@ -489,29 +548,10 @@ static esp_err_t draw_filled_rect(display_matrix_t *display,
                                   int y1,
                                   uint16_t color)
 {
-    int width = x1 - x0;
-    int height = y1 - y0;
-    size_t pixels = (size_t)width * height;
-    if (pixels > display->tile_buffer_pixels) {
-        uint16_t *scratch = heap_caps_malloc(pixels * sizeof(uint16_t), MALLOC_CAP_DMA);
-        if (!scratch) {
-            return ESP_ERR_NO_MEM;
-        }
-        for (size_t i = 0; i < pixels; ++i) {
-            scratch[i] = color;
-        }
-        esp_err_t err = esp_lcd_panel_draw_bitmap(display->panel, x0, y0, x1, y1, scratch);
-        free(scratch);
-        return err;
-    }
-    for (size_t i = 0; i < pixels; ++i) {
-        display->tile_buffer[i] = color;
-    }
-    esp_err_t err = esp_lcd_panel_draw_bitmap(display->panel, x0, y0, x1, y1, display->tile_buffer);
-    if (err != ESP_OK) {
-        ESP_LOGE(DISPLAY_TAG, "esp_lcd_panel_draw_bitmap (fill) failed: %s", esp_err_to_name(err));
-    }
-    return err;
+    xSemaphoreTake(display->lock, portMAX_DELAY);
+    display_framebuffer_fill(&display->fb, x0, y0, x1, y1, color);
+    xSemaphoreGive(display->lock);
+    return ESP_OK;
 }
 
 esp_err_t display_matrix_fill(display_matrix_t *display, uint16_t rgb565)
@@ -556,8 +596,44 @@ esp_err_t display_matrix_draw_tile(display_matrix_t *display,
 
 esp_err_t display_matrix_flush(display_matrix_t *display)
 {
-    (void)display;
-    return ESP_OK;
+    if (!display) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_err_t err = ESP_OK;
+    display_rect_t dirty[DISPLAY_FB_MAX_DIRTY];
+    xSemaphoreTake(display->lock, portMAX_DELAY);
+    size_t count = display_framebuffer_take_dirty(&display->fb, dirty);
+    for (size_t i = 0; i < count && err == ESP_OK; i++) {
+        const display_rect_t *rect = &dirty[i];
+        int width = rect->x1 - rect->x0;
+        int height = rect->y1 - rect->y0;
+        int chunk_rows = (int)(display->dma_buffer_pixels / width);
+        for (int row = 0; row < height && err == ESP_OK; row += chunk_rows) {
+            int rows = height - row < chunk_rows ? height - row : chunk_rows;
+            // Blocks only while both buffers are still on the bus
+            xSemaphoreTake(display->dma_free, portMAX_DELAY);
+            uint16_t *buffer = display->dma_buffers[display->next_dma_buffer];
+            display->next_dma_buffer ^= 1;
+            display_framebuffer_copy(&display->fb, rect, row, rows, buffer);
+            err = esp_lcd_panel_draw_bitmap(display->panel,
+                                            rect->x0,
+                                            rect->y0 + row,
+                                            rect->x1,
+                                            rect->y0 + row + rows,
+                                            buffer);
+            if (err != ESP_OK) {
+                ESP_LOGE(DISPLAY_TAG, "esp_lcd_panel_draw_bitmap failed: %s", esp_err_to_name(err));
+                xSemaphoreGive(display->dma_free);
+            }
+        }
+    }
+    if (err != ESP_OK) {
+        // Resend the whole panel next time rather than leave stale regions
+        display_framebuffer_invalidate(&display->fb, 0, 0, display->cfg.panel_width, display->cfg.panel_height);
+    }
+    xSemaphoreGive(display->lock);
+    return err;
 }
 
 esp_err_t display_matrix_draw_bitmap(display_matrix_t *display,
@@ -576,25 +652,8 @@ esp_err_t display_matrix_draw_bitmap(display_matrix_t *display,
         return ESP_ERR_INVALID_ARG;
     }
 
-    size_t pixels = (size_t)width * height;
-    
-    // Allocate DMA-capable buffer for the bitmap
-    uint16_t *dma_buffer = heap_caps_malloc(pixels * sizeof(uint16_t), MALLOC_CAP_DMA);
-    if (!dma_buffer) {
-        ESP_LOGE(DISPLAY_TAG, "Failed to allocate DMA buffer for bitmap");
-        return ESP_ERR_NO_MEM;
-    }
-
-    // Copy bitmap data to DMA buffer
-    memcpy(dma_buffer, bitmap, pixels * sizeof(uint16_t));
-    
-    // Draw the bitmap
-    esp_err_t err = esp_lcd_panel_draw_bitmap(display->panel, x, y, x + width, y + height, dma_buffer);
-    
-    if (err != ESP_OK) {
-        ESP_LOGE(DISPLAY_TAG, "esp_lcd_panel_draw_bitmap failed: %s", esp_err_to_name(err));
-    }
-    
-    free(dma_buffer);
-    return err;
+    xSemaphoreTake(display->lock, portMAX_DELAY);
+    display_framebuffer_blit(&display->fb, x, y, width, height, bitmap);
+    xSemaphoreGive(display->lock);
+    return ESP_OK;
 }
@@ -8,6 +8,12 @@
 extern "C" {
 #endif
 
+/**
+ * Drawing goes to an off-screen framebuffer and only records which areas
+ * changed; nothing reaches the panel until display_matrix_flush(), which
+ * sends the merged dirty rectangles over SPI DMA. All calls are safe from
+ * any task.
+ */
 typedef struct display_matrix display_matrix_t;
 
 typedef struct {
@@ -34,6 +40,12 @@ esp_err_t display_matrix_draw_pixel(display_matrix_t *display,
                                     int tile_x,
                                     int tile_y,
                                     uint16_t rgb565);
+/**
+ * Push everything drawn since the last flush; returns once the data is
+ * queued. With a PSRAM front buffer (M5GFX backend) the frame is handed to
+ * a push task, so the caller goes on drawing the next one meanwhile and
+ * only waits here if the previous frame has not finished going out.
+ */
 esp_err_t display_matrix_flush(display_matrix_t *display);
 esp_err_t display_matrix_draw_tile(display_matrix_t *display,
                                    int tile_x,
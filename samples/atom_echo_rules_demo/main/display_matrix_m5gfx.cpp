@@ -1,10 +1,16 @@
 // M5GFX wrapper for display_matrix interface
 #include "display_matrix.h"
 #include <M5GFX.h>
+#include <esp_heap_caps.h>
 #include <esp_log.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
 #include <stdlib.h>
 #include <string.h>
 
+#include "display_framebuffer.h"
+
 #define DISPLAY_TAG "display_matrix"
 
 struct display_matrix {
@@ -12,10 +18,113 @@ struct display_matrix {
     m5gfx::M5GFX *gfx;
     int tile_width;
     int tile_height;
-    uint16_t *tile_buffer;
-    size_t tile_buffer_pixels;
+    SemaphoreHandle_t lock;       // Guards the framebuffer; drawing comes from several tasks
+    display_framebuffer_t fb;
+    // Ping-pong DMA sources for flush: one is copied while the other is on the bus
+    uint16_t *dma_buffers[2];
+    size_t dma_buffer_pixels;
+    // Front buffer: the last submitted frame in PSRAM, pushed by push_task
+    // while drawing carries on in fb. NULL when PSRAM is short; flush then
+    // pushes straight from fb and returns once the panel has it.
+    LGFX_Sprite *front;
+    display_framebuffer_t front_view;  // front's pixels, for display_framebuffer_copy
+    display_rect_t pending[DISPLAY_FB_MAX_DIRTY];
+    size_t pending_count;
+    TaskHandle_t push_task;
+    SemaphoreHandle_t front_free;      // Given while front is not being pushed
 };
 
+// Rows of the panel each DMA buffer holds
+#define DISPLAY_DMA_ROWS 16
+// Below the network stacks: a late frame matters less than a missed packet
+#define DISPLAY_PUSH_TASK_PRIORITY 3
+#define DISPLAY_PUSH_TASK_STACK 3072
+
+static void release(display_matrix_t *display)
+{
+    if (display->front_free) {
+        vSemaphoreDelete(display->front_free);
+    }
+    delete display->front;
+    if (display->gfx) {
+        delete display->gfx;
+    }
+    display_framebuffer_deinit(&display->fb);
+    free(display->dma_buffers[0]);
+    free(display->dma_buffers[1]);
+    if (display->lock) {
+        vSemaphoreDelete(display->lock);
+    }
+    free(display);
+}
+
+// One bus transaction for the whole frame; each chunk is copied into the
+// idle DMA buffer while the previous one is still going out
+static void push_rects(display_matrix_t *display, const display_framebuffer_t *src,
+                       const display_rect_t *rects, size_t count)
+{
+    int next = 0;
+    display->gfx->startWrite();
+    for (size_t i = 0; i < count; i++) {
+        const display_rect_t *rect = &rects[i];
+        int width = rect->x1 - rect->x0;
+        int height = rect->y1 - rect->y0;
+        int chunk_rows = (int)(display->dma_buffer_pixels / width);
+        for (int row = 0; row < height; row += chunk_rows) {
+            int rows = height - row < chunk_rows ? height - row : chunk_rows;
+            uint16_t *buffer = display->dma_buffers[next];
+            next ^= 1;
+            display_framebuffer_copy(src, rect, row, rows, buffer);
+            display->gfx->waitDMA();
+            display->gfx->pushImageDMA(rect->x0, rect->y0 + row, width, rows, buffer);
+        }
+    }
+    // endWrite() waits for the last chunk, so both buffers are free again
+    display->gfx->endWrite();
+}
+
+static void push_task(void *arg)
+{
+    display_matrix_t *display = (display_matrix_t *)arg;
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        push_rects(display, &display->front_view, display->pending, display->pending_count);
+        xSemaphoreGive(display->front_free);
+    }
+}
+
+static void start_async_flush(display_matrix_t *display)
+{
+    LGFX_Sprite *front = new LGFX_Sprite(display->gfx);
+    front->setColorDepth(16);
+    front->setPsram(true);
+    if (!front->createSprite(display->cfg.panel_width, display->cfg.panel_height)) {
+        ESP_LOGW(DISPLAY_TAG, "No PSRAM for a front buffer; flushes will wait for the panel");
+        delete front;
+        return;
+    }
+    display->front = front;
+    display->front_free = xSemaphoreCreateBinary();
+    if (display->front_free) {
+        xSemaphoreGive(display->front_free);
+    }
+    if (!display->front_free ||
+        xTaskCreate(push_task, "display_push", DISPLAY_PUSH_TASK_STACK, display, DISPLAY_PUSH_TASK_PRIORITY,
+                    &display->push_task) != pdPASS) {
+        ESP_LOGW(DISPLAY_TAG, "Push task not started; flushes will wait for the panel");
+        if (display->front_free) {
+            vSemaphoreDelete(display->front_free);
+            display->front_free = NULL;
+        }
+        delete front;
+        display->front = NULL;
+        return;
+    }
+    display->front_view.pixels = (uint16_t *)front->getBuffer();
+    display->front_view.width = display->cfg.panel_width;
+    display->front_view.height = display->cfg.panel_height;
+}
+
 extern "C" {
 
 esp_err_t display_matrix_init(display_matrix_t **out_display,
@@ -62,19 +171,22 @@ esp_err_t display_matrix_init(display_matrix_t **out_display,
     display->tile_height = cfg->panel_height / cfg->tile_rows;
     if (display->tile_width <= 0 || display->tile_height <= 0) {
         ESP_LOGE(DISPLAY_TAG, "Invalid tile size computed (%d x %d)", display->tile_width, display->tile_height);
-        delete display->gfx;
-        free(display);
+        release(display);
         return ESP_ERR_INVALID_ARG;
     }
 
-    display->tile_buffer_pixels = display->tile_width * display->tile_height;
-    display->tile_buffer = (uint16_t*)heap_caps_malloc(display->tile_buffer_pixels * sizeof(uint16_t), MALLOC_CAP_DMA);
-    if (!display->tile_buffer) {
-        ESP_LOGE(DISPLAY_TAG, "Failed to allocate tile buffer");
-        delete display->gfx;
-        free(display);
+    display->lock = xSemaphoreCreateMutex();
+    display->dma_buffer_pixels = (size_t)cfg->panel_width * DISPLAY_DMA_ROWS;
+    for (int i = 0; i < 2; i++) {
+        display->dma_buffers[i] = (uint16_t*)heap_caps_malloc(display->dma_buffer_pixels * sizeof(uint16_t), MALLOC_CAP_DMA);
+    }
+    if (!display->lock || !display->dma_buffers[0] || !display->dma_buffers[1] ||
+        display_framebuffer_init(&display->fb, cfg->panel_width, cfg->panel_height) != ESP_OK) {
+        ESP_LOGE(DISPLAY_TAG, "Failed to allocate framebuffer");
+        release(display);
         return ESP_ERR_NO_MEM;
     }
+    start_async_flush(display);
 
     *out_display = display;
     return ESP_OK;
@@ -85,13 +197,17 @@ void display_matrix_deinit(display_matrix_t *display)
     if (!display) {
         return;
     }
+    // Let the frame in flight finish before the bus goes away
+    if (display->push_task) {
+        xSemaphoreTake(display->front_free, portMAX_DELAY);
+        vTaskDelete(display->push_task);
+        display->push_task = NULL;
+    }
     if (display->gfx) {
+        display->gfx->waitDMA();
         display->gfx->setBrightness(0);
-        delete display->gfx;
-        display->gfx = nullptr;
     }
-    free(display->tile_buffer);
-    free(display);
+    release(display);
 }
 
 esp_err_t display_matrix_fill(display_matrix_t *display, uint16_t rgb565)
@@ -100,8 +216,9 @@ esp_err_t display_matrix_fill(display_matrix_t *display, uint16_t rgb565)
         return ESP_ERR_INVALID_ARG;
     }
     
-    // M5GFX/LGFX uses color565 directly
-    display->gfx->fillScreen(rgb565);
+    xSemaphoreTake(display->lock, portMAX_DELAY);
+    display_framebuffer_fill(&display->fb, 0, 0, display->cfg.panel_width, display->cfg.panel_height, rgb565);
+    xSemaphoreGive(display->lock);
     return ESP_OK;
 }
 
@@ -116,12 +233,9 @@ esp_err_t display_matrix_draw_bitmap(display_matrix_t *display,
         return ESP_ERR_INVALID_ARG;
     }
     
-    ESP_LOGI(DISPLAY_TAG, "Drawing bitmap via M5GFX: x=%d, y=%d, w=%d, h=%d", x, y, width, height);
-    
-    // M5GFX pushImage for RGB565 data (bitmap is already RGB565)
-    display->gfx->pushImage(x, y, width, height, bitmap);
-    
-    ESP_LOGI(DISPLAY_TAG, "Bitmap drawn successfully");
+    xSemaphoreTake(display->lock, portMAX_DELAY);
+    display_framebuffer_blit(&display->fb, x, y, width, height, bitmap);
+    xSemaphoreGive(display->lock);
     return ESP_OK;
 }
 
@@ -143,8 +257,9 @@ esp_err_t display_matrix_draw_tile(display_matrix_t *display,
     int x1 = x0 + display->tile_width;
     int y1 = y0 + display->tile_height;
 
-    // M5GFX uses color565 directly
-    display->gfx->fillRect(x0, y0, x1 - x0, y1 - y0, color);
+    xSemaphoreTake(display->lock, portMAX_DELAY);
+    display_framebuffer_fill(&display->fb, x0, y0, x1, y1, color);
+    xSemaphoreGive(display->lock);
     return ESP_OK;
 }
 
@@ -161,8 +276,39 @@ esp_err_t display_matrix_flush(display_matrix_t *display)
     if (!display || !display->gfx) {
         return ESP_ERR_INVALID_ARG;
     }
-    // M5GFX handles flushing automatically
-    // No explicit flush needed - drawing operations are immediate
+
+    if (!display->front) {
+        display_rect_t dirty[DISPLAY_FB_MAX_DIRTY];
+        xSemaphoreTake(display->lock, portMAX_DELAY);
+        size_t count = display_framebuffer_take_dirty(&display->fb, dirty);
+        if (count > 0) {
+            push_rects(display, &display->fb, dirty, count);
+        }
+        xSemaphoreGive(display->lock);
+        return ESP_OK;
+    }
+
+    // Waits only while the previous frame is still going out; the copy into
+    // front touches just the dirty rectangles, so drawing is held up briefly
+    xSemaphoreTake(display->front_free, portMAX_DELAY);
+    xSemaphoreTake(display->lock, portMAX_DELAY);
+    size_t count = display_framebuffer_take_dirty(&display->fb, display->pending);
+    for (size_t i = 0; i < count; i++) {
+        const display_rect_t *rect = &display->pending[i];
+        size_t stride = (size_t)display->fb.width;
+        size_t offset = (size_t)rect->y0 * stride + rect->x0;
+        for (int y = rect->y0; y < rect->y1; y++, offset += stride) {
+            memcpy(display->front_view.pixels + offset, display->fb.pixels + offset,
+                   (size_t)(rect->x1 - rect->x0) * sizeof(uint16_t));
+        }
+    }
+    display->pending_count = count;
+    xSemaphoreGive(display->lock);
+    if (count > 0) {
+        xTaskNotifyGive(display->push_task);
+    } else {
+        xSemaphoreGive(display->front_free);
+    }
     return ESP_OK;
 }
 
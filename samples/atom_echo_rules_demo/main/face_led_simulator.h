@@ -7,48 +7,35 @@
 
 #pragma once
 
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include "display_matrix.h"
 #include "esp_err.h"
+#include "image_asset.h"
+#include "led_effects.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-// Forward declaration for FreeRTOS types
-#include "freertos/FreeRTOS.h"
-#include "freertos/task.h"
-
-// LED pattern types (matching somnus_action_handler)
-typedef enum {
-    FACE_LED_PATTERN_NONE = 0,
-    FACE_LED_PATTERN_BREATHING,
-    FACE_LED_PATTERN_GRADIENT_RED_BLUE,
-    FACE_LED_PATTERN_GRADIENT_RED_YELLOW,
-    FACE_LED_PATTERN_GRADIENT_WHITE_BLUE,
-    FACE_LED_PATTERN_GRADIENT_BLUE_GREEN,
-    FACE_LED_PATTERN_GRADIENT_TEAL_ORANGE,
-    FACE_LED_PATTERN_PULSE_LILAC,
-    FACE_LED_PATTERN_PULSE_ORANGE,
-} face_led_pattern_t;
+// Pixels around each LED's centre that its glow covers, per side
+#define FACE_LED_SPAN 3
 
 typedef struct face_led_simulator {
     display_matrix_t *display;
-    face_led_pattern_t current_pattern;
-    uint8_t current_r, current_g, current_b;
-    float current_intensity;
-    bool pattern_active;
-    TaskHandle_t pattern_task;
     
-    // Face image data (128x128 RGB565)
-    const uint16_t *face_image;
-    uint16_t *render_buffer;  // Working buffer for rendering
+    uint16_t *render_buffer;  // Face with the last frame's LEDs; only LED footprints get redrawn
+    bool frame_shown;         // render_buffer has been pushed to the display once
     
     // LED positions (50 LEDs: 16 inner + 24 outer)
     struct {
         int x, y;
-        float angle;
+        uint8_t turn;         // Angle around the face in 1/256 turns
+        uint16_t color;       // Last drawn colour, RGB565
+        uint8_t level;        // Last drawn glow sprite, 0 = off
+        uint64_t overlaps;    // LEDs whose footprints share pixels with this one
+        uint16_t face[FACE_LED_SPAN * FACE_LED_SPAN];  // Bare face under the footprint, row stride = its width
     } led_positions[50];
     int num_leds;
 } face_led_simulator_t;
@@ -57,12 +44,12 @@ typedef struct face_led_simulator {
  * Initialize the face LED simulator
  * @param simulator Pointer to simulator structure
  * @param display Display matrix handle
- * @param face_image RGB565 image data (128x128)
+ * @param face_image Compressed 128x128 face, decoded once into the render buffer
  * @return ESP_OK on success
  */
 esp_err_t face_led_simulator_init(face_led_simulator_t *simulator,
                                   display_matrix_t *display,
-                                  const uint16_t *face_image);
+                                  const image_asset_t *face_image);
 
 /**
  * Deinitialize the face LED simulator
@@ -70,24 +57,17 @@ esp_err_t face_led_simulator_init(face_led_simulator_t *simulator,
 void face_led_simulator_deinit(face_led_simulator_t *simulator);
 
 /**
- * Set LED pattern
- * @param simulator Simulator handle
- * @param pattern Pattern type
- * @param r Red component (0-255)
- * @param g Green component (0-255)
- * @param b Blue component (0-255)
- * @param intensity Intensity multiplier (0.0-1.0)
- * @return ESP_OK on success
- */
-esp_err_t face_led_simulator_set_pattern(face_led_simulator_t *simulator,
-                                         face_led_pattern_t pattern,
-                                         uint8_t r, uint8_t g, uint8_t b,
-                                         float intensity);
-
-/**
- * Stop current pattern
+ * Draw one frame of the physical ring on the face
+ *
+ * Each simulated LED shows the strip pixel at the same angle around the
+ * ring. Matches led_effects_frame_cb_t, so the simulator can be registered
+ * with led_effects_set_frame_cb() and follows every effect the strip shows.
+ *
+ * @param pixels Composited strip frame
+ * @param count Number of strip pixels
+ * @param ctx Simulator handle
  */
-void face_led_simulator_stop_pattern(face_led_simulator_t *simulator);
+void face_led_simulator_show_frame(const led_rgb_t *pixels, size_t count, void *ctx);
 
 #ifdef __cplusplus
 }
@@ -6,6 +6,7 @@
 #include "esp_log.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "i2c_topology.h"
 
 static const char *TAG = "i2c_scanner";
 
@@ -67,9 +68,24 @@ static void teardown_bus(const i2c_bus_config_t *bus)
     i2c_driver_delete(bus->port);
 }
 
-esp_err_t i2c_scanner_scan_bus_with_callback(const i2c_bus_config_t *bus,
-                                             i2c_scanner_result_cb_t cb,
-                                             void *ctx)
+static bool probe_address(uint8_t addr, void *ctx)
+{
+    const i2c_bus_config_t *bus = ctx;
+    i2c_cmd_handle_t cmd = i2c_cmd_link_create();
+    i2c_master_start(cmd);
+    i2c_master_write_byte(cmd, (addr << 1) | I2C_MASTER_WRITE, true);
+    i2c_master_stop(cmd);
+    esp_err_t err = i2c_master_cmd_begin(bus->port, cmd, pdMS_TO_TICKS(20));
+    i2c_cmd_link_delete(cmd);
+    if (err != ESP_OK && err != ESP_ERR_TIMEOUT && err != ESP_FAIL) {
+        ESP_LOGV(TAG, "addr 0x%02X err=%s", addr, esp_err_to_name(err));
+    }
+    vTaskDelay(pdMS_TO_TICKS(2));
+    return err == ESP_OK;
+}
+
+// Names come from kKnownDevices on every pass; only addresses are cached
+static esp_err_t scan_bus(const i2c_bus_config_t *bus, i2c_scanner_result_cb_t cb, void *ctx, bool rescan)
 {
     if (!bus) {
         return ESP_ERR_INVALID_ARG;
@@ -83,43 +99,55 @@ esp_err_t i2c_scanner_scan_bus_with_callback(const i2c_bus_config_t *bus,
              bus->scl,
              (unsigned long)bus->frequency_hz);
 
-    int found = 0;
-    for (uint8_t addr = 0x03; addr < 0x78; ++addr) {
-        i2c_cmd_handle_t cmd = i2c_cmd_link_create();
-        i2c_master_start(cmd);
-        i2c_master_write_byte(cmd, (addr << 1) | I2C_MASTER_WRITE, true);
-        i2c_master_stop(cmd);
-        esp_err_t err = i2c_master_cmd_begin(bus->port, cmd, pdMS_TO_TICKS(20));
-        i2c_cmd_link_delete(cmd);
-        if (err == ESP_OK) {
-            const char *name = lookup_device_name(addr);
-            ESP_LOGI(TAG, "  - 0x%02X %s%s",
-                     addr,
-                     name ? "→ " : "",
-                     name ? name : "");
-            if (cb) {
-                cb(bus, addr, name, ctx);
-            }
-            found++;
-        } else if (err != ESP_ERR_TIMEOUT && err != ESP_FAIL) {
-            ESP_LOGV(TAG, "addr 0x%02X err=%s", addr, esp_err_to_name(err));
+    const i2c_topology_bus_t topo_bus = {
+        .port = bus->port,
+        .sda = bus->sda,
+        .scl = bus->scl,
+        .freq_hz = bus->frequency_hz,
+    };
+    i2c_topology_t topology;
+    esp_err_t err = i2c_topology_discover(&topo_bus, probe_address, (void *)bus, rescan, &topology);
+    teardown_bus(bus);
+    ESP_RETURN_ON_ERROR(err, TAG, "discover");
+
+    for (uint8_t i = 0; i < topology.count; ++i) {
+        uint8_t addr = topology.addr[i];
+        const char *name = lookup_device_name(addr);
+        ESP_LOGI(TAG, "  - 0x%02X %s%s",
+                 addr,
+                 name ? "→ " : "",
+                 name ? name : "");
+        if (cb) {
+            cb(bus, addr, name, ctx);
         }
-        vTaskDelay(pdMS_TO_TICKS(2));
     }
 
-    if (found == 0) {
+    if (topology.count == 0) {
         ESP_LOGW(TAG, "  No devices detected on %s", bus->label ? bus->label : "bus");
+    } else {
+        ESP_LOGI(TAG, "  %s in %u probes", topology.from_cache ? "Verified from cache" : "Full scan",
+                 topology.probes);
     }
-
-    teardown_bus(bus);
     return ESP_OK;
 }
 
+esp_err_t i2c_scanner_scan_bus_with_callback(const i2c_bus_config_t *bus,
+                                             i2c_scanner_result_cb_t cb,
+                                             void *ctx)
+{
+    return scan_bus(bus, cb, ctx, false);
+}
+
 esp_err_t i2c_scanner_scan_bus(const i2c_bus_config_t *bus)
 {
     return i2c_scanner_scan_bus_with_callback(bus, NULL, NULL);
 }
 
+esp_err_t i2c_scanner_rescan_bus(const i2c_bus_config_t *bus)
+{
+    return scan_bus(bus, NULL, NULL, true);
+}
+
 esp_err_t i2c_scanner_scan_all(const i2c_bus_config_t *buses, size_t count)
 {
     if (!buses || count == 0) {
@@ -24,7 +24,10 @@ typedef void (*i2c_scanner_result_cb_t)(const i2c_bus_config_t *bus,
 esp_err_t i2c_scanner_scan_bus_with_callback(const i2c_bus_config_t *bus,
                                              i2c_scanner_result_cb_t cb,
                                              void *ctx);
+// Addresses found on an earlier boot are only verified; see i2c_topology.h
 esp_err_t i2c_scanner_scan_bus(const i2c_bus_config_t *bus);
+// Full scan regardless of the cache, e.g. after adding a device
+esp_err_t i2c_scanner_rescan_bus(const i2c_bus_config_t *bus);
 esp_err_t i2c_scanner_scan_all(const i2c_bus_config_t *buses, size_t count);
 
 #ifdef __cplusplus
@@ -0,0 +1,125 @@
+#include "image_asset.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "esp_check.h"
+#include "esp_heap_caps.h"
+
+static const char *TAG = "image_asset";
+
+// 2 KB for a 128-pixel-wide image
+#define IMAGE_ASSET_STRIP_ROWS 8
+
+static uint16_t read_u16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | p[1] << 8);
+}
+
+esp_err_t image_asset_info(const image_asset_t *asset, int *width, int *height)
+{
+    ESP_RETURN_ON_FALSE(asset && asset->data && asset->size >= IMAGE_ASSET_HEADER_LEN, ESP_ERR_INVALID_ARG, TAG,
+                        "no asset");
+    const uint8_t *h = asset->data;
+    ESP_RETURN_ON_FALSE(memcmp(h, "NIMG", 4) == 0 && h[4] == 1, ESP_ERR_NOT_SUPPORTED, TAG, "not a v1 image asset");
+    if (width) {
+        *width = read_u16(&h[6]);
+    }
+    if (height) {
+        *height = read_u16(&h[8]);
+    }
+    return ESP_OK;
+}
+
+esp_err_t image_asset_decoder_init(image_asset_decoder_t *dec, const image_asset_t *asset)
+{
+    ESP_RETURN_ON_FALSE(dec, ESP_ERR_INVALID_ARG, TAG, "dec null");
+    memset(dec, 0, sizeof(*dec));
+    ESP_RETURN_ON_ERROR(image_asset_info(asset, &dec->width, &dec->height), TAG, "bad header");
+    dec->palette_count = read_u16(&asset->data[10]);
+    ESP_RETURN_ON_FALSE(dec->palette_count <= IMAGE_ASSET_MAX_PALETTE, ESP_ERR_NOT_SUPPORTED, TAG, "palette too large");
+    size_t palette_len = (size_t)dec->palette_count * 2;
+    ESP_RETURN_ON_FALSE(asset->size >= IMAGE_ASSET_HEADER_LEN + palette_len, ESP_ERR_INVALID_SIZE, TAG,
+                        "truncated palette");
+    dec->palette = &asset->data[IMAGE_ASSET_HEADER_LEN];
+    dec->pos = dec->palette + palette_len;
+    dec->end = asset->data + asset->size;
+    return ESP_OK;
+}
+
+static esp_err_t read_pixel(image_asset_decoder_t *dec, uint16_t *value)
+{
+    if (dec->palette_count) {
+        if (dec->pos >= dec->end) {
+            return ESP_ERR_INVALID_SIZE;
+        }
+        uint8_t index = *dec->pos++;
+        if (index >= dec->palette_count) {
+            return ESP_ERR_INVALID_RESPONSE;
+        }
+        *value = read_u16(&dec->palette[index * 2]);
+        return ESP_OK;
+    }
+    if (dec->end - dec->pos < 2) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    *value = read_u16(dec->pos);
+    dec->pos += 2;
+    return ESP_OK;
+}
+
+esp_err_t image_asset_decode_rows(image_asset_decoder_t *dec, uint16_t *dst, int rows)
+{
+    ESP_RETURN_ON_FALSE(dec && dst && rows > 0, ESP_ERR_INVALID_ARG, TAG, "invalid arguments");
+    ESP_RETURN_ON_FALSE(dec->row + rows <= dec->height, ESP_ERR_INVALID_SIZE, TAG, "past the last row");
+
+    size_t count = (size_t)rows * dec->width;
+    while (count > 0) {
+        if (dec->run_left == 0) {
+            ESP_RETURN_ON_FALSE(dec->pos < dec->end, ESP_ERR_INVALID_SIZE, TAG, "data ends early");
+            uint8_t tag = *dec->pos++;
+            dec->run_repeat = (tag & 0x80) != 0;
+            dec->run_left = (tag & 0x7F) + 1;
+            if (dec->run_repeat) {
+                ESP_RETURN_ON_ERROR(read_pixel(dec, &dec->run_value), TAG, "bad run");
+            }
+        }
+        size_t n = dec->run_left < count ? dec->run_left : count;
+        if (dec->run_repeat) {
+            for (size_t i = 0; i < n; i++) {
+                dst[i] = dec->run_value;
+            }
+        } else {
+            for (size_t i = 0; i < n; i++) {
+                ESP_RETURN_ON_ERROR(read_pixel(dec, &dst[i]), TAG, "bad literal");
+            }
+        }
+        dec->run_left -= n;
+        dst += n;
+        count -= n;
+    }
+    dec->row += rows;
+    return ESP_OK;
+}
+
+esp_err_t image_asset_draw(display_matrix_t *display, int x, int y, const image_asset_t *asset)
+{
+    ESP_RETURN_ON_FALSE(display, ESP_ERR_INVALID_ARG, TAG, "display null");
+    image_asset_decoder_t dec;
+    ESP_RETURN_ON_ERROR(image_asset_decoder_init(&dec, asset), TAG, "decoder init failed");
+
+    int strip_rows = dec.height < IMAGE_ASSET_STRIP_ROWS ? dec.height : IMAGE_ASSET_STRIP_ROWS;
+    uint16_t *strip = heap_caps_malloc((size_t)dec.width * strip_rows * sizeof(uint16_t), MALLOC_CAP_DEFAULT);
+    ESP_RETURN_ON_FALSE(strip, ESP_ERR_NO_MEM, TAG, "no strip buffer");
+
+    esp_err_t err = ESP_OK;
+    for (int row = 0; row < dec.height && err == ESP_OK; row += strip_rows) {
+        int rows = dec.height - row < strip_rows ? dec.height - row : strip_rows;
+        err = image_asset_decode_rows(&dec, strip, rows);
+        if (err == ESP_OK) {
+            err = display_matrix_draw_bitmap(display, x, y + row, dec.width, rows, strip);
+        }
+    }
+    free(strip);
+    return err;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "display_matrix.h"
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Compressed RGB565 images, generated by scripts/png_to_image_asset.py.
+ *
+ * Layout, little-endian:
+ *   "NIMG", version (1), flags (0), width u16, height u16, palette count u16
+ *   palette: count RGB565 values
+ *   packets, row-major across the whole image:
+ *     0x00-0x7F  n + 1 literal pixels follow
+ *     0x80-0xFF  the one pixel that follows repeats (n & 0x7F) + 1 times
+ * A pixel is a palette index byte when the image has a palette, otherwise
+ * the RGB565 value itself, stored as the display expects it.
+ *
+ * Decoding runs forward in strips of rows, so drawing an image needs a
+ * strip's worth of RAM rather than a full copy.
+ */
+
+#define IMAGE_ASSET_HEADER_LEN 12
+#define IMAGE_ASSET_MAX_PALETTE 256
+
+typedef struct {
+    const uint8_t *data;
+    size_t size;
+} image_asset_t;
+
+typedef struct {
+    const uint8_t *pos;
+    const uint8_t *end;
+    const uint8_t *palette;
+    uint16_t palette_count;
+    int width;
+    int height;
+    int row;                          // Next row to decode
+    uint8_t run_left;                 // Pixels left in the current packet
+    bool run_repeat;
+    uint16_t run_value;
+} image_asset_decoder_t;
+
+esp_err_t image_asset_info(const image_asset_t *asset, int *width, int *height);
+
+esp_err_t image_asset_decoder_init(image_asset_decoder_t *dec, const image_asset_t *asset);
+
+/**
+ * Decode the next rows into dst, width pixels per row
+ *
+ * @return ESP_ERR_INVALID_SIZE if the data ends early or rows runs past the
+ *         image, ESP_ERR_INVALID_RESPONSE on a palette index out of range
+ */
+esp_err_t image_asset_decode_rows(image_asset_decoder_t *dec, uint16_t *dst, int rows);
+
+// Draw the whole image with its top-left corner at x, y, a strip at a time
+esp_err_t image_asset_draw(display_matrix_t *display, int x, int y, const image_asset_t *asset);
+
+#ifdef __cplusplus
+}
+#endif
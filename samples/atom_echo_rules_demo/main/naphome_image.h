@@ -1,140 +1,589 @@
-// Auto-generated from Naphome.png
+// Auto-generated from naphome_image.h by scripts/png_to_image_asset.py
 // Image size: 128x128 pixels
-// Format: RGB565 (16-bit)
+// Format: image asset, RGB565, 9160 bytes (32768 raw)
 #pragma once
 
 #include <stdint.h>
 
+#include "image_asset.h"
+
 #define NAPHOME_WIDTH  128
 #define NAPHOME_HEIGHT 128
 
-static const uint16_t naphome_data[16384] = {
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xA210, 0x0742, 0x6952, 0x6A6B, 0xCC73, 0x0B6B, 0x074A, 0x4431, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x6008, 0x6852, 0x33AD, 0x98E6, 0x5BFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x7BFF, 0x5BFF, 0xD8FE, 0xB4D5, 0xAD93, 0x4431, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x2000, 0x0000, 0x2000, 0x2A6B, 0x57D6, 0xDDFF, 0x9CFF, 0x3AFF, 0xFAFE, 0xFAFE, 0x1AFF, 0x3BFF, 0x3BFF, 0x3BFF, 0x5BFF, 0x7CFF, 0x9CFF, 0xFAFE, 0xB1AC, 0x6431, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xE641, 0xD5C5, 0xFDFF, 0xBDFF, 0xFAFE, 0xF9FE, 0x1AFF, 0x3BFF, 0x5BFF, 0x5BFF, 0x5BFF, 0x5CFF, 0x5CFF, 0x5BFF, 0x5BFF, 0x5BFF, 0x5BFF, 0x9CFF, 0x3AFF, 0x0F9C, 0x6110, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xAD7B, 0x5BF7, 0xDDFF, 0x5BFF, 0xF9FE, 0x1AFF, 0x3BFF, 0x5BFF, 0x5BFF, 0x5CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x5BFF, 0x5CFF, 0xBDFF, 0x36DE, 0x054A, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x8110, 0x53B5, 0xDDFF, 0x7CFF, 0x5BFF, 0xFAFE, 0x1AFF, 0x5BFF, 0x5BFF, 0x5CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x9CFF, 0x9CFF, 0x9CFF, 0x9CFF, 0x9CFF, 0x9CFF, 0x7CFF, 0x5BFF, 0x9CFF, 0x3BFF, 0x2B7B, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xC218, 0x16CE, 0xDDFF, 0x5BF7, 0x7CFF, 0xFAFE, 0x1AFF, 0x5BFF, 0x5BFF, 0x5CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x9CFF, 0x9DFF, 0x9DFF, 0x9DFF, 0x9DFF, 0x9DFF, 0x9DFF, 0x9DFF, 0x9DFF, 0x9DFF, 0x7CFF, 0x7CFF, 0x9CFF, 0xEE8B, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0219, 0x37D6, 0xDDFF, 0x5BF7, 0x7CFF, 0x1AFF, 0x1AFF, 0x5BFF, 0x5BFF, 0x5CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x9CFF, 0x9DFF, 0x9DFF, 0x9DFF, 0x9DFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0x9DFF, 0x9DFF, 0x7CFF, 0xDDFF, 0x2F94, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xC218, 0x77D6, 0xBDFF, 0x5BF7, 0x9CFF, 0x3AFF, 0x1AFF, 0x5BFF, 0x5BFF, 0x5CFF, 0x7CFF, 0x7CFF, 0x9CFF, 0x9DFF, 0x9DFF, 0x9DFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0x9DFF, 0x7CFF, 0xDDFF, 0x2F94, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x8210, 0x16CE, 0xBCFF, 0x5BF7, 0x9CFF, 0x5BFF, 0xFAFE, 0x3BFF, 0x5BFF, 0x5CFF, 0x7CFF, 0x7CFF, 0x9DFF, 0x9DFF, 0x9DFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0x7CFF, 0xDDFF, 0xEE8B, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x4108, 0x94C5, 0xBCFF, 0x3BF7, 0x7CFF, 0x7CFF, 0x1AFF, 0x3AFF, 0x5BFF, 0x5CFF, 0x7CFF, 0x7CFF, 0x9DFF, 0x9DFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xBDFF, 0xBDFF, 0xBDFF, 0x7CFF, 0xDDFF, 0x4B7B, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x909C, 0xBCFF, 0x3BF7, 0x7CFF, 0x7CFF, 0x5BFF, 0x1AFF, 0x5BFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x9DFF, 0x9DFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xBDFF, 0x9DFF, 0x7CFF, 0x074A, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x2000, 0x0000, 0xE962, 0x9CFF, 0x3BF7, 0x5BFF, 0x7CFF, 0x7CFF, 0x1AFF, 0x3BFF, 0x5CFF, 0x7CFF, 0x7CFF, 0x9DFF, 0x9DFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xFEFF, 0xFEFF, 0xFEFF, 0xFEFF, 0xFEFF, 0xFEFF, 0xFEFF, 0xFEFF, 0xDEFF, 0xFEFF, 0xDEFF, 0xDEFF, 0xBDFF, 0xBDFF, 0xB9EE, 0xE320, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x8531, 0x1AF7, 0x5BF7, 0x5BF7, 0x7BFF, 0x9CFF, 0x5BFF, 0x1AFF, 0x5BFF, 0x7CFF, 0x9CFF, 0x9CFF, 0x9DFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xDEFF, 0xDEFF, 0xFEFF, 0xFEFF, 0xFEFF, 0xFEFF, 0xFEFF, 0xFEFF, 0xFEFF, 0xFEFF, 0xFEFF, 0xFEFF, 0xFEFF, 0xFFFF, 0xFEFF, 0xFEFF, 0xFEFF, 0xFEFF, 0xFEFF, 0xFEFF, 0xDEFF, 0x9DFF, 0xFEFF, 0x94C5, 0x2000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x6108, 0xB4C5, 0x7CFF, 0x3BF7, 0x5BFF, 0x7CFF, 0x7CFF, 0x1AFF, 0x3BFF, 0x7CFF, 0x7CFF, 0x9CFF, 0x9DFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xDEFF, 0xDEFF, 0xFEFF, 0xFEFF, 0xFEFF, 0xFEFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFEFF, 0xFEFF, 0xDEFF, 0xDEFF, 0x9DFF, 0xFEFF, 0x6C7B, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xCD83, 0x9CFF, 0x3AF7, 0x5BFF, 0x5BFF, 0x7CFF, 0x5BFF, 0x1AFF, 0x5BFF, 0x7CFF, 0x9CFF, 0x9DFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xDEFF, 0xDEFF, 0xFEFF, 0xFEFF, 0xFEFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFEFF, 0xDEFF, 0xBDFF, 0x7BFF, 0x6439, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xA539, 0x19F7, 0x3BF7, 0x5BF7, 0x5BFF, 0x7BFF, 0x7CFF, 0x3AFF, 0x3BFF, 0x7CFF, 0x7CFF, 0x9CFF, 0x9DFF, 0xBDFF, 0xBDFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xFEFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFEFF, 0xDEFF, 0xFEFF, 0xB5CD, 0x2008, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x2000, 0x73BD, 0x7BFF, 0x3AF7, 0x5BFF, 0x5BFF, 0x7CFF, 0x7CFF, 0x1AFF, 0x5BFF, 0x7CFF, 0x9CFF, 0x9DFF, 0xBDFF, 0xBDFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xFEFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFEFF, 0xBDFF, 0xFEFF, 0x0B73, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xE95A, 0x5BFF, 0x1AF7, 0x5BF7, 0x5BFF, 0x5BFF, 0x7CFF, 0x5BFF, 0x1AFF, 0x5CFF, 0x7CFF, 0x9DFF, 0x9DFF, 0xBDFF, 0xBDFF, 0xDEFF, 0xDEFF, 0xFEFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFEFF, 0xDEFF, 0xD9EE, 0x8210, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xA110, 0x36D6, 0x3BF7, 0x3AF7, 0x5BF7, 0x5BFF, 0x7BFF, 0x7CFF, 0x3AFF, 0x3BFF, 0x7CFF, 0x7CFF, 0x9DFF, 0xBDFF, 0xBDFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xFEFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xDEFF, 0xFFFF, 0x4F94, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x8C7B, 0x5BFF, 0x1AF7, 0x3BF7, 0x5BFF, 0x5BFF, 0x7CFF, 0x7CFF, 0x1AFF, 0x5BFF, 0x7CFF, 0x9CFF, 0xBDFF, 0xBDFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xFEFF, 0xFEFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFEFF, 0xDEFF, 0x5BFF, 0x6431, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xC218, 0x77DE, 0x3AF7, 0x1AF7, 0x5BF7, 0x5BFF, 0x5BFF, 0x7CFF, 0x5BFF, 0x1AFF, 0x5CFF, 0x7CFF, 0x9DFF, 0xBDFF, 0xBDFF, 0xDEFF, 0xDEFF, 0xFEFF, 0xFEFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xDEFF, 0xFFFF, 0xD1AC, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xAD83, 0x5BFF, 0xFAEE, 0x3AF7, 0x5BF7, 0x5BFF, 0x5BFF, 0x7CFF, 0x3BFF, 0x1AFF, 0x7CFF, 0x7CFF, 0x9DFF, 0xBDFF, 0xDDFF, 0xDEFF, 0xDEFF, 0xFEFF, 0xFEFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xDEFF, 0x7CFF, 0x8539, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xC218, 0x56DE, 0x1AF7, 0x1AF7, 0x3BF7, 0x5BF7, 0x5BFF, 0x5BFF, 0x7CFF, 0x1AFF, 0x3BFF, 0x7CFF, 0x9CFF, 0xBDFF, 0xBDFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xFEFF, 0xFEFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xDEFF, 0xFFFF, 0xD2AC, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x6C73, 0x3AFF, 0xF9EE, 0x3AF7, 0x3BF7, 0x5BF7, 0x5BFF, 0x7BFF, 0x7CFF, 0x1AFF, 0x3BFF, 0x7CFF, 0x9CFF, 0xBDFF, 0xBDFF, 0xDEFF, 0xDEFF, 0xFEFF, 0xFEFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xDEFF, 0x5BFF, 0x4431, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x6108, 0xF5CD, 0x1AF7, 0x1AF7, 0x3AF7, 0x3BF7, 0x5BF7, 0x5BFF, 0x7BFF, 0x5BFF, 0x1AFF, 0x5BFF, 0x7CFF, 0x9DFF, 0xBDFF, 0xBDFF, 0xDEFF, 0xDEFF, 0xFEFF, 0xFEFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xDEFF, 0xFFFF, 0x4F94, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xC852, 0x19F7, 0xF9EE, 0x1AF7, 0x3AF7, 0x3BF7, 0x5BF7, 0x5BFF, 0x7BFF, 0x5BFF, 0x1AFF, 0x5BFF, 0x7CFF, 0x9DFF, 0xBDFF, 0xBDFF, 0xDEFF, 0xDEFF, 0xFEFF, 0xFEFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFEFF, 0xD9EE, 0xA218, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x31B5, 0x1AFF, 0xF9EE, 0x1AF7, 0x3AF7, 0x3BF7, 0x5BF7, 0x5BFF, 0x7BFF, 0x3BFF, 0x1AFF, 0x5CFF, 0x7CFF, 0x9DFF, 0xBDFF, 0xBDFF, 0xDEFF, 0xDEFF, 0xFEFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xDEFF, 0xFEFF, 0x2B73, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x8531, 0x98EE, 0xF9EE, 0x1AF7, 0x1AF7, 0x3AF7, 0x5BF7, 0x5BF7, 0x5BFF, 0x7CFF, 0x3AFF, 0x1AFF, 0x5CFF, 0x7CFF, 0x9DFF, 0xBDFF, 0xBDFF, 0xDEFF, 0xFEFF, 0xFEFF, 0xFEFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFEFF, 0xFFFF, 0xF5CD, 0x4000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xAC7B, 0x19F7, 0xD9EE, 0x1AF7, 0x1AF7, 0x3AF7, 0x5BF7, 0x5BF7, 0x5BFF, 0x7BFF, 0x1AFF, 0x1AFF, 0x5CFF, 0x7CFF, 0x9DFF, 0xBDFF, 0xBDFF, 0xDEFF, 0xFEFF, 0xFEFF, 0xFEFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xDEFF, 0x9CFF, 0xA539, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x6108, 0xB3C5, 0xF9F6, 0xF9EE, 0x1AF7, 0x3AF7, 0x3AF7, 0x3BF7, 0x5BF7, 0x5BFF, 0x7BFF, 0x1AFF, 0x1AFF, 0x5CFF, 0x7CFF, 0x9DFF, 0xBDFF, 0xBDFF, 0xDEFF, 0xDEFF, 0xFEFF, 0xFEFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xDEFF, 0xFEFF, 0x2F94, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xC639, 0xB7EE, 0xD8EE, 0xF9EE, 0x1AF7, 0x3AF7, 0x3AF7, 0x3BF7, 0x5BF7, 0x5BFF, 0x7BFF, 0x1AFF, 0x1BFF, 0x5CFF, 0x7CFF, 0x9DFF, 0xBDFF, 0xBDFF, 0xDEFF, 0xDEFF, 0xFEFF, 0xFEFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFEFF, 0xFEFF, 0x37DE, 0x6108, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xCD83, 0xF9F6, 0xB8EE, 0xF9F6, 0x1AF7, 0x3AF7, 0x3AF7, 0x3BF7, 0x5BF7, 0x5BFF, 0x5BFF, 0x1AFF, 0x3BFF, 0x5CFF, 0x7CFF, 0x9DFF, 0xBDFF, 0xBDFF, 0xDEFF, 0xDEFF, 0xFEFF, 0xFEFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xDEFF, 0x9CFF, 0xE641, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x6108, 0x73BD, 0xD8EE, 0xD9EE, 0xF9F6, 0x1AF7, 0x3AF7, 0x3AF7, 0x3BF7, 0x5BF7, 0x5BFF, 0x5BFF, 0xFAFE, 0x3AFF, 0x5CFF, 0x7CFF, 0x9DFF, 0xBDFF, 0xBDFF, 0xDEFF, 0xDEFF, 0xFEFF, 0xFEFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xDEFF, 0xFEFF, 0x2F94, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x2329, 0x76E6, 0xB8EE, 0xD9EE, 0xF9F6, 0x1AF7, 0x3AF7, 0x3AF7, 0x3BF7, 0x5BF7, 0x5BFF, 0x5BFF, 0xFAFE, 0x1AFF, 0x5BFF, 0x7CFF, 0x9CFF, 0xBDFF, 0xBDFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xFEFF, 0xFEFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xDEFF, 0xFEFF, 0xF6D5, 0x2000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0A6B, 0xD8EE, 0xB8E6, 0xD9EE, 0xF9F6, 0x1AF7, 0x1AF7, 0x3AF7, 0x3BF7, 0x5BF7, 0x5BF7, 0x5BFF, 0xF9FE, 0x1AFF, 0x5BFF, 0x7CFF, 0x9CFF, 0x9DFF, 0xBDFF, 0xBDFF, 0xDEFF, 0xDEFF, 0xFEFF, 0xFEFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFEFF, 0xDEFF, 0x3BFF, 0xA539, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x6F9C, 0xD8F6, 0xB8E6, 0xF9EE, 0xF9F6, 0x1AF7, 0x1AF7, 0x3AF7, 0x3BF7, 0x3BF7, 0x5BF7, 0x5BF7, 0xF9FE, 0x1AFF, 0x5BFF, 0x7CFF, 0x7CFF, 0x9DFF, 0xBDFF, 0xBDFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xFEFF, 0xFEFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFEFF, 0xBDFF, 0xDDFF, 0x895A, 0x0000, 0x2000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xA210, 0x73C5, 0xB8EE, 0xB8EE, 0xD9EE, 0xF9F6, 0x1AF7, 0x1AF7, 0x3AF7, 0x3BF7, 0x3BF7, 0x5BF7, 0x5BF7, 0xF9FE, 0x1AFF, 0x5BFF, 0x5CFF, 0x7CFF, 0x9CFF, 0xBDFF, 0xBDFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xFEFF, 0xFEFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFEFF, 0xBDFF, 0xFEFF, 0x709C, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x6431, 0x56E6, 0x97E6, 0xB8EE, 0xD9EE, 0xF9F6, 0x1AF7, 0x1AF7, 0x3AF7, 0x3AF7, 0x3BF7, 0x3BF7, 0x5BF7, 0xFAFE, 0xFAFE, 0x3BFF, 0x5BFF, 0x7CFF, 0x9CFF, 0x9DFF, 0xBDFF, 0xBDFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xFEFF, 0xFEFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFEFF, 0xDEFF, 0xDDFF, 0x16DE, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x685A, 0x97EE, 0x77E6, 0xB8EE, 0xD9EE, 0xF9F6, 0x1AF7, 0x1AF7, 0x3AF7, 0x3AF7, 0x3BF7, 0x3BF7, 0x5BF7, 0xFAFE, 0xF9FE, 0x3BFF, 0x5BFF, 0x7CFF, 0x7CFF, 0x9DFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xDEFF, 0xDEFF, 0xFEFF, 0xFEFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFEFF, 0xFEFF, 0xDEFF, 0xBDFF, 0xF9F6, 0x0321, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x2E94, 0x97EE, 0x77E6, 0xB8EE, 0xD9EE, 0xF9EE, 0x1AF7, 0x1AF7, 0x3AF7, 0x3AF7, 0x3BF7, 0x3BF7, 0x5BF7, 0x1AF7, 0xD9FE, 0x3BFF, 0x5BFF, 0x5CFF, 0x7CFF, 0x9CFF, 0x9DFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xDEFF, 0xDEFF, 0xFEFF, 0xFEFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFEFF, 0xFEFF, 0xDEFF, 0x9DFF, 0x9CFF, 0xA95A, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x8FA4, 0x97EE, 0x77E6, 0xB8EE, 0xD9EE, 0xF9EE, 0xF9F6, 0x1AF7, 0x1AF7, 0x3AF7, 0x3AF7, 0x3BF7, 0x5BF7, 0x3AF7, 0xD9FE, 0x1AFF, 0x3BFF, 0x5BFF, 0x7CFF, 0x9CFF, 0x9DFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xFEFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFEFF, 0xDEFF, 0xDEFF, 0x9DFF, 0xDDFF, 0x0B73, 0x0000, 0x2000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x2100, 0x11B5, 0x76E6, 0x77E6, 0xB8EE, 0xD9EE, 0xF9EE, 0xF9EE, 0x1AF7, 0x1AF7, 0x3AF7, 0x3AF7, 0x3BF7, 0x3BF7, 0x3BF7, 0xF9FE, 0x1AFF, 0x3BFF, 0x5BFF, 0x5CFF, 0x7CFF, 0x9CFF, 0x9DFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xFEFF, 0xFEFF, 0xFEFF, 0xFEFF, 0xFEFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFEFF, 0xFEFF, 0xDEFF, 0xDEFF, 0x9DFF, 0xDDFF, 0xEE8B, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x6431, 0xF4D5, 0x56DE, 0x97E6, 0xB8EE, 0xD8EE, 0xF9EE, 0xF9EE, 0x1AF7, 0x1AF7, 0x1AF7, 0x3AF7, 0x3AF7, 0x3BF7, 0x3BF7, 0xF9FE, 0xFAFE, 0x3AFF, 0x3BFF, 0x5BFF, 0x7CFF, 0x7CFF, 0x9DFF, 0x9DFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xFEFF, 0xFEFF, 0xFEFF, 0xFEFF, 0xFEFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFEFF, 0xFEFF, 0xDEFF, 0xDEFF, 0xBDFF, 0x9DFF, 0x9DFF, 0xB5CD, 0x2000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xC541, 0x14DE, 0x36DE, 0x77E6, 0xB8EE, 0xD8EE, 0xF9EE, 0xF9EE, 0xF9F6, 0x1AF7, 0x1AF7, 0x3AF7, 0x3AF7, 0x3AF7, 0x5BF7, 0xFAFE, 0xF9FE, 0x1AFF, 0x3BFF, 0x5BFF, 0x5CFF, 0x7CFF, 0x9CFF, 0x9DFF, 0x9DFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xFEFF, 0xFEFF, 0xFEFF, 0xFEFF, 0xFEFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFEFF, 0xFEFF, 0xFEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xBDFF, 0x9DFF, 0x9CFF, 0x36DE, 0x4108, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xE649, 0x14DE, 0x35DE, 0x77E6, 0xB8E6, 0xB8EE, 0xD9EE, 0xF9EE, 0xF9EE, 0x1AF7, 0x1AF7, 0x1AF7, 0x3AF7, 0x3AF7, 0x3BF7, 0x1AFF, 0xD9FE, 0x1AFF, 0x3BFF, 0x3BFF, 0x5BFF, 0x7CFF, 0x7CFF, 0x9CFF, 0x9DFF, 0x9DFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xFEFF, 0xFEFF, 0xFEFF, 0xFEFF, 0xFEFF, 0xFEFF, 0xFEFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFEFF, 0xFEFF, 0xFEFF, 0xFEFF, 0xFEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xBDFF, 0xBDFF, 0x9CFF, 0x7CFF, 0x98EE, 0x8110, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xE641, 0x35E6, 0x15DE, 0x77E6, 0x97E6, 0xB8EE, 0xD9EE, 0xF9EE, 0xF9EE, 0x1AF7, 0x1AF7, 0x1AF7, 0x3AF7, 0x3AF7, 0x3BF7, 0x3AF7, 0xD9FE, 0xFAFE, 0x1AFF, 0x3BFF, 0x5BFF, 0x5BFF, 0x7CFF, 0x7CFF, 0x9CFF, 0x9DFF, 0x9DFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xFEFF, 0xFEFF, 0xFEFF, 0xFEFF, 0xFEFF, 0xFEFF, 0xFEFF, 0xFEFF, 0xFEFF, 0xFEFF, 0xFEFF, 0xFEFF, 0xFEFF, 0xFEFF, 0xFEFF, 0xFEFF, 0xFEFF, 0xFEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDDFF, 0xBDFF, 0xBDFF, 0x9CFF, 0x7CFF, 0xB8F6, 0x6110, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xA96A, 0x14DE, 0x15DE, 0x76E6, 0x97E6, 0xB8EE, 0xD8EE, 0xD9EE, 0xF9EE, 0xF9F6, 0x1AF7, 0x1AF7, 0x1AF7, 0x3AF7, 0x3AF7, 0x3AF7, 0xD9FE, 0xD9FE, 0x1AFF, 0x3BFF, 0x3BFF, 0x5BFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x9CFF, 0x9DFF, 0x9DFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xFEFF, 0xFEFF, 0xFEFF, 0xFEFF, 0xFEFF, 0xFEFF, 0xFEFF, 0xFEFF, 0xFEFF, 0xFEFF, 0xFEFF, 0xFEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xBDFF, 0xBDFF, 0x9DFF, 0x7CFF, 0x5CFF, 0xF9FE, 0x4429, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xEC93, 0xD3DD, 0x15DE, 0x56E6, 0x97E6, 0xB8E6, 0xD8EE, 0xD9EE, 0xF9EE, 0xF9EE, 0x1AF7, 0x1AF7, 0x1AF7, 0x1AF7, 0x3AF7, 0x3AF7, 0xF9F6, 0xD9FE, 0xFAFE, 0x1AFF, 0x3BFF, 0x3BFF, 0x5BFF, 0x5CFF, 0x7CFF, 0x7CFF, 0x9CFF, 0x9DFF, 0x9DFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xFEFF, 0xFEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xBDFF, 0xBDFF, 0xBDFF, 0x9DFF, 0x7CFF, 0x5BFF, 0x3AFF, 0x494A, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xEC8B, 0xD3D5, 0x15DE, 0x56DE, 0x77E6, 0x98E6, 0xB8EE, 0xD8EE, 0xD9EE, 0xF9EE, 0xF9F6, 0x1AF7, 0x1AF7, 0x1AF7, 0x1AF7, 0x3AF7, 0x1AF7, 0xB8FE, 0xF9FE, 0x1AFF, 0x1AFF, 0x3BFF, 0x5BFF, 0x5BFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x9CFF, 0x9DFF, 0x9DFF, 0x9DFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xBDFF, 0xBDFF, 0xBDFF, 0x9DFF, 0x9CFF, 0x7CFF, 0x3BFF, 0x1AFF, 0x2862, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xCC93, 0xB3D5, 0xF4D5, 0x56DE, 0x77E6, 0x97E6, 0xB8EE, 0xD8EE, 0xD9EE, 0xF9EE, 0xF9EE, 0xF9F6, 0x1AF7, 0x1AF7, 0x1AF7, 0x1AF7, 0x3AF7, 0xD9FE, 0xD9FE, 0xFAFE, 0x1AFF, 0x3BFF, 0x3BFF, 0x5BFF, 0x5BFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x9CFF, 0x9DFF, 0x9DFF, 0x9DFF, 0x9DFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xDEFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0x9DFF, 0x9DFF, 0x7CFF, 0x7CFF, 0x3BFF, 0x1AFF, 0x4852, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xCB93, 0x92D5, 0xD4D5, 0x35DE, 0x76E6, 0x97E6, 0xB8EE, 0xB8EE, 0xD8EE, 0xD9EE, 0xF9EE, 0xF9EE, 0xF9F6, 0x1AF7, 0x1AF7, 0x1AF7, 0x3AF7, 0xF9F6, 0xB8FE, 0xF9FE, 0xFAFE, 0x1AFF, 0x3BFF, 0x3BFF, 0x5BFF, 0x5BFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x9CFF, 0x9DFF, 0x9DFF, 0x9DFF, 0x9DFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0x9DFF, 0x9DFF, 0x9CFF, 0x7CFF, 0x5BFF, 0x3BFF, 0xFAFE, 0x284A, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xAB8B, 0x71CD, 0xD3D5, 0x15DE, 0x56DE, 0x77E6, 0x97E6, 0xB8EE, 0xB8EE, 0xD9EE, 0xD9EE, 0xF9EE, 0xF9EE, 0xF9F6, 0x1AF7, 0x1AF7, 0x1AF7, 0x1AF7, 0xB8F6, 0xD9FE, 0xFAFE, 0x1AFF, 0x1AFF, 0x3BFF, 0x3BFF, 0x5BFF, 0x5BFF, 0x5CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x9CFF, 0x9DFF, 0x9DFF, 0x9DFF, 0x9DFF, 0x9DFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0x9DFF, 0x9DFF, 0x9DFF, 0x9CFF, 0x7CFF, 0x7CFF, 0x5BFF, 0x1BFF, 0xD8FE, 0x263A, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x8A83, 0x51CD, 0xB3CD, 0x15DE, 0x36DE, 0x76E6, 0x97E6, 0x98E6, 0xB8EE, 0xD8EE, 0xD9EE, 0xD9EE, 0xF9EE, 0xF9EE, 0xF9F6, 0x1AF7, 0x1AF7, 0x1AF7, 0xF9F6, 0xB8FE, 0xF9FE, 0xFAFE, 0x1AFF, 0x1AFF, 0x3BFF, 0x3BFF, 0x5BFF, 0x5BFF, 0x5CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x9CFF, 0x9DFF, 0x9DFF, 0x9DFF, 0x9DFF, 0x9DFF, 0x9DFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0xBDFF, 0x9DFF, 0x9DFF, 0x9DFF, 0x9DFF, 0x9CFF, 0x9CFF, 0x7CFF, 0x7CFF, 0x5CFF, 0x3BFF, 0x1AFF, 0x97EE, 0x061A, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0973, 0x30C5, 0x92CD, 0xF4D5, 0x35DE, 0x56DE, 0x77E6, 0x97E6, 0xB8E6, 0xB8EE, 0xD8EE, 0xD9EE, 0xD9EE, 0xF9EE, 0xF9EE, 0xF9F6, 0x1AF7, 0x1AF7, 0x1AF7, 0xB8F6, 0xB9FE, 0xF9FE, 0xFAFE, 0x1AFF, 0x1AFF, 0x3BFF, 0x3BFF, 0x5BFF, 0x5BFF, 0x5CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x9CFF, 0x9CFF, 0x9DFF, 0x9DFF, 0x9DFF, 0x9DFF, 0x9DFF, 0x9DFF, 0x9DFF, 0x9DFF, 0x9DFF, 0x9DFF, 0x9DFF, 0x9DFF, 0x9DFF, 0x9DFF, 0x9DFF, 0x9DFF, 0x9DFF, 0x9CFF, 0x9CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x5CFF, 0x5BFF, 0x3BFF, 0x3AFF, 0xD5DD, 0x4108, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x8441, 0x0FC5, 0x71C5, 0xD3D5, 0x15DE, 0x36DE, 0x56E6, 0x97E6, 0x97E6, 0xB8EE, 0xB8EE, 0xD8EE, 0xD9EE, 0xD9EE, 0xF9EE, 0xF9EE, 0xF9EE, 0xF9F6, 0x1AF7, 0xF9F6, 0xB8FE, 0xD9FE, 0xF9FE, 0xFAFE, 0x1AFF, 0x1AFF, 0x3BFF, 0x3BFF, 0x5BFF, 0x5BFF, 0x5CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x9CFF, 0x9CFF, 0x9DFF, 0x9DFF, 0x9DFF, 0x9DFF, 0x9DFF, 0x9DFF, 0x9DFF, 0x9DFF, 0x9DFF, 0x9DFF, 0x9CFF, 0x9CFF, 0x9DFF, 0x9CFF, 0x9CFF, 0x9CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x5BFF, 0x3BFF, 0x1AFF, 0x3BFF, 0xF0C4, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x4331, 0xAEBC, 0x30C5, 0xB3CD, 0xF4D5, 0x15DE, 0x56DE, 0x76E6, 0x97E6, 0x97E6, 0xB8EE, 0xB8EE, 0xD8EE, 0xD9EE, 0xD9EE, 0xF9EE, 0xF9EE, 0xF9EE, 0xF9F6, 0x1AF7, 0xD9F6, 0xB8FE, 0xD9FE, 0xF9FE, 0xFAFE, 0x1AFF, 0x1AFF, 0x3BFF, 0x3BFF, 0x5BFF, 0x5BFF, 0x5BFF, 0x5CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x9CFF, 0x9CFF, 0x9CFF, 0x9CFF, 0x9CFF, 0x9CFF, 0x9CFF, 0x9CFF, 0x9CFF, 0x9CFF, 0x9CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x5BFF, 0x5BFF, 0x3BFF, 0xFAFE, 0x1AFF, 0xAC93, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x2329, 0x4CAC, 0xEFBC, 0x72CD, 0xD3D5, 0x14DE, 0x35DE, 0x56E6, 0x77E6, 0x97E6, 0x97E6, 0xB8EE, 0xB8EE, 0xD8EE, 0xD9EE, 0xD9EE, 0xF9EE, 0xF9EE, 0xF9EE, 0xF9F6, 0xF9EE, 0xB8F6, 0xB8FE, 0xD9FE, 0xF9FE, 0xFAFE, 0x1AFF, 0x1AFF, 0x3BFF, 0x3BFF, 0x3BFF, 0x5BFF, 0x5BFF, 0x5BFF, 0x5CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x5BFF, 0x5BFF, 0x3BFF, 0x3AFF, 0xFAFE, 0xB8FE, 0xC451, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0321, 0xCB9B, 0xAEB4, 0x51C5, 0xB3CD, 0xF4D5, 0x15DE, 0x36DE, 0x56E6, 0x77E6, 0x97E6, 0x97E6, 0xB8EE, 0xB8EE, 0xB8EE, 0xD8EE, 0xD9EE, 0xD9EE, 0xF9EE, 0xF9EE, 0xF9EE, 0xF9EE, 0x98F6, 0xB9FE, 0xF9FE, 0xF9FE, 0xFAFE, 0x1AFF, 0x1AFF, 0x3BFF, 0x3BFF, 0x3BFF, 0x3BFF, 0x5BFF, 0x5BFF, 0x5BFF, 0x5CFF, 0x5CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x5CFF, 0x5CFF, 0x5BFF, 0x5BFF, 0x3BFF, 0x3BFF, 0x1AFF, 0x1AFF, 0x93DD, 0xA020, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x2100, 0xE87A, 0x6DB4, 0x0FBD, 0x71CD, 0xB3D5, 0xF4D5, 0x15DE, 0x36DE, 0x56E6, 0x77E6, 0x97E6, 0x97E6, 0xB8EE, 0xB8EE, 0xB8EE, 0xB8EE, 0xD8EE, 0xD9EE, 0xD9EE, 0xD9EE, 0xF9EE, 0xD9EE, 0x98F6, 0xD9FE, 0xD9FE, 0xF9FE, 0xFAFE, 0x1AFF, 0x1AFF, 0x1AFF, 0x3BFF, 0x3BFF, 0x3BFF, 0x3BFF, 0x5BFF, 0x5BFF, 0x5BFF, 0x5BFF, 0x5CFF, 0x5CFF, 0x5CFF, 0x5CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x7CFF, 0x5CFF, 0x5CFF, 0x5CFF, 0x5BFF, 0x5BFF, 0x5BFF, 0x5BFF, 0x3BFF, 0x3BFF, 0x1AFF, 0xF9FE, 0xF9FE, 0xAA9B, 0xC118, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x465A, 0x0BA4, 0xAEB4, 0x30C5, 0x92CD, 0xD3D5, 0xF4D5, 0x15DE, 0x36DE, 0x56E6, 0x77E6, 0x77E6, 0x97E6, 0x97E6, 0xB8E6, 0xB8EE, 0xB8EE, 0xB8EE, 0xD8EE, 0xD8EE, 0xD9EE, 0xD9EE, 0xD8EE, 0x98F6, 0xD9FE, 0xF9FE, 0xF9FE, 0xFAFE, 0x1AFF, 0x1AFF, 0x1AFF, 0x1AFF, 0x3BFF, 0x3BFF, 0x3BFF, 0x3BFF, 0x5BFF, 0x5BFF, 0x5BFF, 0x5BFF, 0x5BFF, 0x5BFF, 0x5BFF, 0x5BFF, 0x5BFF, 0x5CFF, 0x5CFF, 0x5BFF, 0x5BFF, 0x5BFF, 0x5BFF, 0x5BFF, 0x5BFF, 0x5BFF, 0x3BFF, 0x3BFF, 0x3BFF, 0x1AFF, 0xFAFE, 0x1AFF, 0xB4E5, 0x035A, 0x0319, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x2331, 0x8993, 0x4CAC, 0xEFBC, 0x51C5, 0x92CD, 0xD3D5, 0xF4DD, 0x15DE, 0x36DE, 0x56E6, 0x76E6, 0x77E6, 0x97E6, 0x97E6, 0x97E6, 0xB8E6, 0xB8EE, 0xB8EE, 0xB8EE, 0xD8EE, 0xD8EE, 0xD9EE, 0xB8EE, 0x97F6, 0xB9FE, 0xF9FE, 0xF9FE, 0xFAFE, 0xFAFE, 0x1AFF, 0x1AFF, 0x1AFF, 0x3BFF, 0x3BFF, 0x3BFF, 0x3BFF, 0x3BFF, 0x3BFF, 0x5BFF, 0x5BFF, 0x5BFF, 0x5BFF, 0x5BFF, 0x5BFF, 0x5BFF, 0x5BFF, 0x5BFF, 0x5BFF, 0x5BFF, 0x5BFF, 0x3BFF, 0x3BFF, 0x3BFF, 0x3BFF, 0x1AFF, 0x1AFF, 0x1AFF, 0xF9FE, 0xD9FE, 0x4893, 0x6239, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x8110, 0xE772, 0xCA9B, 0x8DB4, 0x10C5, 0x71CD, 0xB2CD, 0xD3D5, 0xF4D5, 0x15DE, 0x35DE, 0x56DE, 0x56E6, 0x76E6, 0x77E6, 0x97E6, 0x97E6, 0x97E6, 0xB8E6, 0xB8EE, 0xB8EE, 0xB8EE, 0xB8EE, 0xB8EE, 0xB8EE, 0x97EE, 0xB8FE, 0xF9FE, 0xF9FE, 0xF9FE, 0xFAFE, 0xFAFE, 0x1AFF, 0x1AFF, 0x1AFF, 0x3BFF, 0x3BFF, 0x3BFF, 0x3BFF, 0x3BFF, 0x3BFF, 0x3BFF, 0x3BFF, 0x3BFF, 0x3BFF, 0x3BFF, 0x3BFF, 0x5BFF, 0x3BFF, 0x3BFF, 0x3BFF, 0x3BFF, 0x3BFF, 0x3BFF, 0x1AFF, 0x1AFF, 0x1AFF, 0xD9FE, 0x1AFF, 0xAEC4, 0xC159, 0x8431, 0x2000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x4108, 0xE551, 0x488B, 0x0BA4, 0xAEB4, 0x30C5, 0x71CD, 0xB2CD, 0xD3D5, 0xF4D5, 0x15DE, 0x35DE, 0x36DE, 0x56DE, 0x56E6, 0x77E6, 0x77E6, 0x97E6, 0x97E6, 0x97E6, 0x97E6, 0xB8EE, 0xB8EE, 0xB8E6, 0xB8EE, 0xB8E6, 0x77EE, 0x98FE, 0xD9FE, 0xF9FE, 0xF9FE, 0xF9FE, 0xFAFE, 0x1AFF, 0x1AFF, 0x1AFF, 0x1AFF, 0x3AFF, 0x3BFF, 0x3BFF, 0x3BFF, 0x3BFF, 0x3BFF, 0x3BFF, 0x3BFF, 0x3BFF, 0x3BFF, 0x3BFF, 0x3BFF, 0x3BFF, 0x3BFF, 0x3BFF, 0x1AFF, 0x1AFF, 0x1AFF, 0xFAFE, 0xD9FE, 0x3BFF, 0x92DD, 0x236A, 0xC349, 0x8010, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x4321, 0xA672, 0x8993, 0x4CAC, 0xCEBC, 0x30C5, 0x71CD, 0x92CD, 0xB3D5, 0xF4D5, 0xF4DD, 0x15DE, 0x35DE, 0x36DE, 0x56DE, 0x56E6, 0x76E6, 0x77E6, 0x77E6, 0x97E6, 0x97E6, 0x97E6, 0x97E6, 0x97E6, 0x98E6, 0xB8E6, 0x77E6, 0x77EE, 0xB8FE, 0xF9FE, 0xD9FE, 0xF9FE, 0xFAFE, 0xFAFE, 0x1AFF, 0x1AFF, 0x1AFF, 0x1AFF, 0x1AFF, 0x1AFF, 0x3AFF, 0x3AFF, 0x3BFF, 0x3BFF, 0x3BFF, 0x3BFF, 0x3BFF, 0x3AFF, 0x1AFF, 0x1AFF, 0x1AFF, 0x1AFF, 0x1AFF, 0xFAFE, 0xD9FE, 0x1AFF, 0x93E5, 0x847A, 0x045A, 0x0131, 0x8108, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x6108, 0xC449, 0xE77A, 0xAA9B, 0x4CAC, 0xCEBC, 0x10C5, 0x51C5, 0x92CD, 0xB3CD, 0xD3D5, 0xF4D5, 0x14DE, 0x15DE, 0x35DE, 0x35DE, 0x56DE, 0x56E6, 0x56E6, 0x76E6, 0x77E6, 0x77E6, 0x77E6, 0x97E6, 0x77E6, 0x97E6, 0x97E6, 0x77E6, 0x56E6, 0x77F6, 0xD9FE, 0xF9FE, 0xF9FE, 0xF9FE, 0xFAFE, 0xFAFE, 0xFAFE, 0x1AFF, 0x1AFF, 0x1AFF, 0x1AFF, 0x1AFF, 0x1AFF, 0x1AFF, 0x1AFF, 0x1AFF, 0x1AFF, 0x1AFF, 0x1AFF, 0x1AFF, 0x1AFF, 0xFAFE, 0xF9FE, 0xFAFE, 0x1AFF, 0x31D5, 0x847A, 0x4462, 0x6241, 0x4018, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xA120, 0x245A, 0x0783, 0xCA9B, 0x4CAC, 0xAEB4, 0x0FBD, 0x31C5, 0x72CD, 0x92CD, 0xB3D5, 0xD4D5, 0xF4D5, 0x14DE, 0x15DE, 0x35DE, 0x35DE, 0x36DE, 0x56DE, 0x56DE, 0x56E6, 0x56E6, 0x56E6, 0x76E6, 0x76E6, 0x76E6, 0x77E6, 0x77E6, 0x56DE, 0x36E6, 0x77F6, 0xB9FE, 0xF9FE, 0xF9FE, 0xF9FE, 0xF9FE, 0xF9FE, 0xFAFE, 0xFAFE, 0x1AFF, 0x1AFF, 0x1AFF, 0x1AFF, 0x1AFF, 0x1AFF, 0x1AFF, 0xFAFE, 0xFAFE, 0xF9FE, 0xF9FE, 0xFAFE, 0x1AFF, 0x77F6, 0x4DB4, 0xA572, 0x656A, 0xA249, 0xC128, 0x0008, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x4000, 0xA208, 0x6108, 0x8208, 0xA210, 0x2231, 0x4562, 0x0783, 0xCA9B, 0x2CAC, 0x8DB4, 0xEFBC, 0x30C5, 0x51CD, 0x72CD, 0x92CD, 0xB3D5, 0xD3D5, 0xF4D5, 0xF4D5, 0x15DE, 0x15DE, 0x15DE, 0x35DE, 0x35DE, 0x35DE, 0x35DE, 0x36DE, 0x36DE, 0x56DE, 0x56DE, 0x56E6, 0x56DE, 0x36DE, 0x15DE, 0x15E6, 0x36EE, 0x98FE, 0xD9FE, 0xFAFE, 0xFAFE, 0xFAFE, 0xF9FE, 0xF9FE, 0xF9FE, 0xF9FE, 0xF9FE, 0xF9FE, 0xF9FE, 0xF9FE, 0xFAFE, 0xFAFE, 0x1AFF, 0xFAFE, 0x77F6, 0x10CD, 0x6893, 0xC57A, 0xA672, 0xA351, 0xE030, 0xA120, 0xE310, 0x6208, 0xC000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x6100, 0x6108, 0xC308, 0xE819, 0x8629, 0x8629, 0x0732, 0x8A3A, 0x4A3A, 0x6A42, 0xC831, 0x6108, 0x6241, 0x6562, 0x0783, 0xA99B, 0x2BA4, 0x6DB4, 0xAEB4, 0xEFBC, 0x30C5, 0x51CD, 0x71CD, 0x92CD, 0xB3D5, 0xD3D5, 0xD3D5, 0xD4D5, 0xF4D5, 0xF4D5, 0xF4D5, 0x15DE, 0x15DE, 0x15DE, 0x15DE, 0x15DE, 0x15DE, 0x35DE, 0x15DE, 0x15DE, 0x35DE, 0x15DE, 0xF4D5, 0xD3D5, 0xD4DD, 0x15EE, 0x57F6, 0x98FE, 0xD9FE, 0xF9FE, 0xFAFE, 0xFAFE, 0x1AFF, 0x1AFF, 0xFAFE, 0xF9FE, 0xD9FE, 0x77F6, 0xB4E5, 0xAEC4, 0xA99B, 0x278B, 0x0783, 0x8672, 0xC351, 0x0139, 0x8020, 0xA218, 0x6621, 0x8721, 0xE519, 0x0311, 0xE410, 0x4511, 0x0419, 0x2000, 0x4100, 0x6100, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x4100, 0x4100, 0x6108, 0xA519, 0x6621, 0xA729, 0x6A3A, 0x6A3A, 0x6A42, 0x8A42, 0x6A42, 0x6A42, 0x4A3A, 0x293A, 0x293A, 0x293A, 0x6A3A, 0xE410, 0x6010, 0x8341, 0x4562, 0xE77A, 0x6993, 0xEAA3, 0x4CAC, 0x8DB4, 0xCEBC, 0x0FBD, 0x30C5, 0x51C5, 0x71CD, 0x92CD, 0x92CD, 0xB3CD, 0xB3D5, 0xD3D5, 0xD3D5, 0xD4D5, 0xD4D5, 0xF4D5, 0xF4D5, 0xF4D5, 0xF4D5, 0xF4D5, 0xF4D5, 0xF4D5, 0xF4D5, 0xF4D5, 0xF4D5, 0xF4D5, 0xD3D5, 0xB3CD, 0x72CD, 0x51CD, 0x71D5, 0x72D5, 0x93DD, 0xB3DD, 0x93DD, 0x72DD, 0x31D5, 0xCFC4, 0x6DB4, 0x0BAC, 0xA99B, 0x8993, 0x6893, 0xE782, 0x4562, 0xA351, 0x0139, 0xA028, 0x6018, 0xA721, 0xC721, 0x6621, 0x4511, 0x6619, 0x4519, 0x4511, 0x4519, 0x2511, 0x6619, 0x8619, 0xC308, 0x0411, 0xC308, 0x0000, 0x6100, 0x2000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x2000, 0x2411, 0x4521, 0x6A2A, 0x6A3A, 0x4A42, 0x8A42, 0x8A42, 0x6A42, 0x4A42, 0x493A, 0x493A, 0x493A, 0x493A, 0x493A, 0x493A, 0x493A, 0x6A3A, 0x493A, 0x6A3A, 0x0832, 0x4100, 0xA118, 0x6241, 0x245A, 0xC672, 0x288B, 0xA99B, 0x0BA4, 0x6CAC, 0x8DB4, 0xCEBC, 0xEFBC, 0x10C5, 0x30C5, 0x51C5, 0x71CD, 0x72CD, 0x92CD, 0x92CD, 0x92CD, 0xB2CD, 0xB3CD, 0xB3D5, 0xB3D5, 0xB3D5, 0xB3D5, 0xB3D5, 0xB3D5, 0xB3D5, 0xB3D5, 0xB3CD, 0x92CD, 0x92CD, 0x92CD, 0x92CD, 0x71CD, 0x51C5, 0x10C5, 0xEFBC, 0xCEBC, 0x8DB4, 0x6DB4, 0x4CAC, 0x2BA4, 0x0AA4, 0xEA9B, 0xA99B, 0x488B, 0xA672, 0x045A, 0x8249, 0x0139, 0xA020, 0x2018, 0xE729, 0x0F4C, 0xAE4B, 0x8E4B, 0x4C43, 0xCB32, 0x492A, 0xE721, 0xA619, 0x4511, 0x0411, 0x0411, 0x4511, 0x6511, 0x2511, 0xE410, 0xA611, 0xE408, 0xC308, 0x8200, 0x0000, 0x2000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xA208, 0x2519, 0xA629, 0x6A3A, 0x6A42, 0x8B42, 0x4942, 0x4A42, 0x493A, 0x293A, 0x293A, 0x493A, 0x4A42, 0x493A, 0x4A3A, 0x6A3A, 0x6A3A, 0x6A3A, 0x6A3A, 0x6A3A, 0x493A, 0x493A, 0x293A, 0x493A, 0x4521, 0x0000, 0xA018, 0x4139, 0xE459, 0x856A, 0x0783, 0x6893, 0xCA9B, 0x0BA4, 0x4CAC, 0x8DB4, 0xAEB4, 0xCFBC, 0xEFBC, 0x10C5, 0x30C5, 0x30C5, 0x51C5, 0x51C5, 0x71CD, 0x71CD, 0x72CD, 0x72CD, 0x72CD, 0x72CD, 0x72CD, 0x72CD, 0x72CD, 0x71CD, 0x71CD, 0x51CD, 0x51C5, 0x51C5, 0x30C5, 0x30C5, 0x10C5, 0xEFBC, 0xEFBC, 0xCEBC, 0x8DB4, 0x6DAC, 0x2BAC, 0xEAA3, 0xA99B, 0x488B, 0xE67A, 0x656A, 0x045A, 0x8249, 0x0139, 0x8020, 0x4018, 0x4010, 0xA719, 0x282A, 0xAA32, 0x2C3B, 0x8D43, 0xCE4B, 0x0F4C, 0xEF4B, 0xCE4B, 0x4D43, 0xAA32, 0x0822, 0x8619, 0x0411, 0x0409, 0x2511, 0x0411, 0x0511, 0x4511, 0xE408, 0x2411, 0xE308, 0xC308, 0xC300, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xC300, 0x4519, 0x2932, 0x4A3A, 0x8B42, 0x6A42, 0x4A42, 0x493A, 0x493A, 0x493A, 0x493A, 0x493A, 0x493A, 0x493A, 0x6A3A, 0x6A3A, 0x4A3A, 0x493A, 0x493A, 0x493A, 0x293A, 0x293A, 0x093A, 0x093A, 0x0832, 0x0832, 0x0832, 0x293A, 0xC310, 0x0000, 0x8018, 0x2131, 0xC349, 0x4462, 0xC672, 0x0783, 0x6893, 0xCA9B, 0x0BA4, 0x4CAC, 0x6CAC, 0x8DB4, 0xAEB4, 0xCEBC, 0xEFBC, 0xEFBC, 0x10BD, 0x10C5, 0x10C5, 0x30C5, 0x30C5, 0x30C5, 0x30C5, 0x30C5, 0x30C5, 0x30C5, 0x30C5, 0x10C5, 0x10C5, 0xEFBC, 0xEFBC, 0xEFBC, 0xCEBC, 0xAEB4, 0x8DB4, 0x6DAC, 0x4CAC, 0x0BA4, 0xCA9B, 0xA993, 0x488B, 0x0783, 0x8672, 0x2462, 0xC351, 0x4241, 0xE030, 0x8020, 0x4018, 0x4010, 0xC721, 0xA719, 0x4511, 0x0411, 0x0411, 0x4511, 0xA619, 0x0822, 0xAA32, 0x2C3B, 0x8D43, 0xEF4B, 0xEE4B, 0x8D43, 0x0B3B, 0x4922, 0x8619, 0x2511, 0x0409, 0xE408, 0x2511, 0x2511, 0x0409, 0x6611, 0xE508, 0x2409, 0xA208, 0xC300, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x8200, 0xE410, 0xC729, 0x8A3A, 0x8A42, 0x6A42, 0x4A3A, 0x493A, 0x493A, 0x493A, 0x293A, 0x293A, 0x493A, 0x6A3A, 0x4A3A, 0x6A3A, 0x6A3A, 0x6A3A, 0x493A, 0x293A, 0x293A, 0x293A, 0x093A, 0x293A, 0x0932, 0x093A, 0x293A, 0x0932, 0x293A, 0x2932, 0x493A, 0x2932, 0x4100, 0x0000, 0x6010, 0xE128, 0x8249, 0x045A, 0x656A, 0xC67A, 0x2783, 0x6893, 0xA99B, 0xEA9B, 0x0BA4, 0x2CAC, 0x4CAC, 0x6DB4, 0x8DB4, 0xAEB4, 0xAEB4, 0xCEBC, 0xCEBC, 0xCEBC, 0xCEBC, 0xCEBC, 0xCEBC, 0xCEBC, 0xCEBC, 0xCEBC, 0xCEBC, 0xAEB4, 0xAEB4, 0x8DB4, 0x6DB4, 0x4CAC, 0x2CAC, 0x0BA4, 0xEAA3, 0xCA9B, 0x8993, 0x488B, 0x0783, 0xC67A, 0x656A, 0xE359, 0x8249, 0x2139, 0xC030, 0x8020, 0x4018, 0x0008, 0xA619, 0x8D3B, 0x4C3B, 0x0C33, 0x8A2A, 0x2822, 0x8619, 0x2511, 0xE408, 0xE408, 0x2511, 0x6611, 0xC719, 0x8A2A, 0x0B33, 0x8D43, 0xAE43, 0x4C3B, 0xEB32, 0x4922, 0x8619, 0xE408, 0xE408, 0x2409, 0x0409, 0x0409, 0x0409, 0xE408, 0xE400, 0xC308, 0x6100, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xA210, 0x492A, 0xAB42, 0x6A42, 0x493A, 0x493A, 0x493A, 0x493A, 0x493A, 0x293A, 0x093A, 0x6A42, 0x8A42, 0x6A3A, 0x8A3A, 0x6A3A, 0x4A3A, 0x293A, 0x293A, 0x0932, 0x093A, 0x0932, 0xE831, 0x0932, 0x2932, 0x2932, 0x293A, 0x493A, 0x2932, 0x493A, 0x0932, 0x0832, 0x0932, 0xA729, 0x2000, 0x2000, 0x4008, 0xA020, 0x4139, 0xC351, 0x2462, 0x656A, 0xC67A, 0x0783, 0x488B, 0x8993, 0xA99B, 0xCA9B, 0x0AA4, 0x0BA4, 0x2BAC, 0x2CAC, 0x4CAC, 0x6CAC, 0x6CAC, 0x6DB4, 0x6CAC, 0x6DAC, 0x6CAC, 0x6CAC, 0x4CAC, 0x4CAC, 0x4CAC, 0x2BAC, 0x0BA4, 0x0BA4, 0xEA9B, 0xAA9B, 0x8993, 0x6893, 0x288B, 0xE782, 0xA672, 0x656A, 0x045A, 0xA351, 0x4141, 0xE130, 0xA028, 0x6018, 0x4010, 0x0008, 0x6208, 0xA619, 0xC719, 0x492A, 0xAA2A, 0x0B33, 0x0B33, 0x0B33, 0x8A2A, 0x2822, 0xA619, 0x0411, 0xE408, 0x0409, 0x0409, 0x2511, 0xA619, 0x692A, 0x2C3B, 0x8D43, 0x8D43, 0x2C3B, 0xCB32, 0xA619, 0xC300, 0xE408, 0x0409, 0x0409, 0x0409, 0x0409, 0x0401, 0x0401, 0x0409, 0x4100, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x6108, 0xC731, 0x6A3A, 0x4942, 0x293A, 0x493A, 0x493A, 0x293A, 0x293A, 0x293A, 0x093A, 0x293A, 0x0C4B, 0xCB42, 0xAB42, 0x0C43, 0x8A3A, 0x293A, 0x0932, 0x0932, 0x093A, 0x0932, 0x0832, 0xE831, 0x6A3A, 0x493A, 0x493A, 0x8A3A, 0x6A3A, 0x2932, 0xE831, 0xE831, 0xC831, 0xE831, 0xC729, 0x0832, 0x4521, 0x0000, 0x0000, 0x2008, 0x8018, 0xE028, 0x4141, 0xC351, 0x045A, 0x656A, 0xA672, 0xE67A, 0x0783, 0x488B, 0x6893, 0x8993, 0xA99B, 0xCA9B, 0xCA9B, 0xEA9B, 0xEAA3, 0xEAA3, 0xEAA3, 0xEAA3, 0xEAA3, 0xEAA3, 0xCA9B, 0xCA9B, 0xCA9B, 0xA99B, 0x8993, 0x6893, 0x488B, 0x2883, 0x0783, 0xC67A, 0x8572, 0x4562, 0x045A, 0xA351, 0x4241, 0x0131, 0xA028, 0x8020, 0x4018, 0x2010, 0x0008, 0x6100, 0x4511, 0x2511, 0x2511, 0x4519, 0x4511, 0x6619, 0xC719, 0x892A, 0xEB32, 0xEB32, 0xCA32, 0xAA2A, 0xC719, 0x0409, 0x2511, 0x2411, 0xE408, 0x0409, 0x6611, 0x4922, 0x4C3B, 0x8D43, 0x6D3B, 0x8D43, 0xAA2A, 0x0409, 0xE408, 0xE408, 0xE408, 0x0401, 0x4509, 0x2401, 0xE400, 0xE308, 0xE300, 0x6200, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x6108, 0x293A, 0x6A42, 0x293A, 0x493A, 0x293A, 0x293A, 0x293A, 0x293A, 0x293A, 0x0832, 0x6A3A, 0x3064, 0xEB42, 0x4D4B, 0xCE53, 0x4A3A, 0x0832, 0x0832, 0x0832, 0x0832, 0x0832, 0xC831, 0x2932, 0x4D4B, 0x8A3A, 0xAB42, 0x0C43, 0x493A, 0xE831, 0xE831, 0xC829, 0xC829, 0xC829, 0xE831, 0xC729, 0xC729, 0xE831, 0x2519, 0x0000, 0x0000, 0x0000, 0x4010, 0x8018, 0xE030, 0x4141, 0xA249, 0xE351, 0x2462, 0x656A, 0x8572, 0xC67A, 0xE77A, 0x0783, 0x2783, 0x488B, 0x488B, 0x488B, 0x688B, 0x688B, 0x688B, 0x688B, 0x488B, 0x488B, 0x288B, 0x2783, 0x0783, 0xE77A, 0xC67A, 0xA672, 0x656A, 0x4562, 0x0462, 0xE359, 0x8249, 0x4141, 0x0131, 0xC028, 0x6020, 0x4018, 0x4010, 0x2008, 0x0000, 0x6100, 0x2511, 0x4511, 0x2511, 0x4511, 0x2511, 0x2511, 0x2511, 0x0411, 0x2511, 0xA619, 0xAA2A, 0x0B33, 0xAA2A, 0x2C3B, 0x892A, 0x0411, 0x0409, 0x0409, 0x0409, 0x0409, 0x0409, 0x8611, 0xEB32, 0xAE43, 0xEB32, 0xCE43, 0x2C3B, 0xE408, 0xE408, 0x0409, 0x4511, 0x2409, 0xE300, 0xE408, 0x0409, 0xE408, 0xA300, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x4100, 0x2932, 0x493A, 0x293A, 0x493A, 0x293A, 0x293A, 0x293A, 0x093A, 0x293A, 0x0932, 0x6A3A, 0xF274, 0x2D4B, 0x4D53, 0x916C, 0x2932, 0xE831, 0x0832, 0x0832, 0xE831, 0x0832, 0xE831, 0x2932, 0x5164, 0x8A3A, 0x0C4B, 0xEF5B, 0xE831, 0xC831, 0xE831, 0xC829, 0xC829, 0xE831, 0xC831, 0xC829, 0xC829, 0xC729, 0xA729, 0xE829, 0x2519, 0x2000, 0x0000, 0x0000, 0x0008, 0x4010, 0x8020, 0xE028, 0x2139, 0x6141, 0xA249, 0xE351, 0x045A, 0x4462, 0x456A, 0x656A, 0x8572, 0xA672, 0xA672, 0xA672, 0xC67A, 0xC67A, 0xC67A, 0xA672, 0xA672, 0xA672, 0x856A, 0x656A, 0x4462, 0x2462, 0x045A, 0xC351, 0xA251, 0x6249, 0x2139, 0xE130, 0xA028, 0x8020, 0x4018, 0x2010, 0x2008, 0x2008, 0x0000, 0x6100, 0x2511, 0x4511, 0x2511, 0x2511, 0x2511, 0x2511, 0x2511, 0x2511, 0x2511, 0x2511, 0x0411, 0x2411, 0x4922, 0x0B33, 0xA619, 0x2C3B, 0x692A, 0xE408, 0x0409, 0x0409, 0x0409, 0x2409, 0x4511, 0x0401, 0xEB32, 0x6D3B, 0x081A, 0xCE4B, 0x8A2A, 0xC300, 0x0409, 0xE300, 0xE300, 0xE300, 0x0301, 0x2409, 0xC300, 0x0409, 0xA200, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0521, 0x6A3A, 0x0932, 0x0932, 0x093A, 0x293A, 0x0932, 0x0832, 0x0832, 0x0932, 0xC729, 0xEF63, 0x1385, 0xE931, 0x958D, 0x0C4B, 0xA729, 0x0832, 0xE831, 0x0832, 0x0832, 0x0832, 0x8729, 0x3064, 0xCF63, 0xE831, 0x137D, 0xE831, 0xA729, 0xC829, 0xC829, 0xC729, 0xC729, 0xC729, 0xC831, 0xC729, 0xC729, 0xC729, 0xA729, 0xE829, 0x8729, 0x2100, 0x0000, 0x0000, 0x0000, 0x0000, 0x2008, 0x4010, 0x6018, 0xA020, 0xE028, 0x2131, 0x4141, 0x6241, 0x8249, 0xA251, 0xC351, 0xE359, 0x035A, 0x045A, 0x045A, 0x045A, 0x045A, 0x045A, 0x045A, 0xE359, 0xE351, 0xC351, 0x8249, 0x6249, 0x4141, 0x2139, 0xE130, 0xC028, 0x8020, 0x6018, 0x4010, 0x2010, 0x2008, 0x0008, 0x0000, 0x0000, 0x0000, 0xA308, 0x4511, 0x2511, 0x2511, 0x2511, 0x2511, 0x2511, 0x2511, 0x2511, 0x2411, 0x2511, 0x4511, 0x0411, 0xE408, 0x692A, 0xCB32, 0x8619, 0x2C3B, 0x2511, 0xE408, 0x0409, 0xE408, 0xE408, 0x0409, 0xE408, 0xC308, 0x8D43, 0xAA32, 0x2822, 0xCE4B, 0xE408, 0xE408, 0xE300, 0xE408, 0xE300, 0x0409, 0xE300, 0xC300, 0xE300, 0x0401, 0x4100, 0x0000,
-    0x0000, 0x0000, 0x4001, 0xE832, 0xE939, 0x0932, 0x0932, 0x093A, 0x093A, 0x0832, 0x0832, 0x0832, 0x293A, 0xA729, 0x9274, 0xF384, 0xC829, 0x179E, 0xCB42, 0xC729, 0x0832, 0xE831, 0xE831, 0xE831, 0x0832, 0x4621, 0xD27C, 0xAF63, 0x2932, 0x758D, 0xA729, 0xC729, 0xC829, 0xC729, 0xC729, 0xA729, 0xC729, 0xC729, 0xC729, 0xC729, 0xA729, 0xC829, 0xA729, 0x2000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x2008, 0x4010, 0x6018, 0x8020, 0xA020, 0xE028, 0x0031, 0x0139, 0x2139, 0x2139, 0x4141, 0x4141, 0x4141, 0x4141, 0x4141, 0x4141, 0x2139, 0x2139, 0x0131, 0xE030, 0xC028, 0xA020, 0x8018, 0x6018, 0x4010, 0x2008, 0x2008, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x8208, 0x4511, 0x2511, 0x2511, 0x4511, 0x2511, 0x2511, 0x2511, 0x2411, 0x0411, 0x0411, 0x4511, 0x8300, 0x692A, 0x0C3B, 0x8300, 0xEF4B, 0x6611, 0xE308, 0x0409, 0xE408, 0xE408, 0xE408, 0x2409, 0x4200, 0xAE4B, 0xAA32, 0x6611, 0x9164, 0xE410, 0xC300, 0xE400, 0xE408, 0x0409, 0x6519, 0xE300, 0xE300, 0xE300, 0x0401, 0x6100, 0x0000,
-    0x0000, 0x0000, 0x8419, 0x4C53, 0xC831, 0x0932, 0x0832, 0x0832, 0xE831, 0xE831, 0xE831, 0xE831, 0x0832, 0xA729, 0x6D53, 0x58A6, 0xEB42, 0x3485, 0xF37C, 0xA729, 0xC831, 0xE831, 0xC729, 0xC831, 0xE831, 0x8729, 0x2D53, 0xD695, 0x2932, 0xD274, 0x716C, 0x8621, 0x8621, 0xC729, 0xA729, 0xA729, 0xA729, 0xA729, 0xA729, 0xA729, 0xA729, 0x8621, 0x2000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x2008, 0x2008, 0x4010, 0x4010, 0x6018, 0x6018, 0x8020, 0x8020, 0xA020, 0xA020, 0xA020, 0xA020, 0x8020, 0x8018, 0x6018, 0x6018, 0x4010, 0x2008, 0x2008, 0x2008, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xA208, 0x4511, 0x2511, 0x2411, 0x2511, 0x2511, 0x0411, 0x2511, 0x2511, 0x0409, 0xA300, 0x8719, 0x3054, 0x6611, 0x0B3B, 0xEF53, 0x0401, 0x0401, 0xE408, 0xE408, 0x0409, 0x2409, 0xA300, 0xC719, 0xF36C, 0xE719, 0x8D4B, 0x715C, 0xA300, 0xE408, 0xE400, 0xC300, 0xE300, 0xC300, 0xE400, 0xE300, 0xE300, 0xE400, 0x4100, 0x0000,
-    0x0000, 0x0000, 0x0000, 0xAF73, 0xE829, 0xC829, 0xE831, 0xE831, 0xC831, 0xE831, 0xE831, 0xE831, 0xE831, 0xE831, 0xE829, 0x3385, 0x958D, 0xEF5B, 0xD695, 0x506C, 0xE829, 0xA729, 0xC729, 0xC829, 0xC729, 0xC829, 0xA729, 0xEF5B, 0x547D, 0x8E53, 0xB274, 0x5064, 0x2932, 0x8721, 0x8721, 0x8721, 0xA729, 0xA729, 0xA729, 0xA729, 0x8721, 0x6108, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0008, 0x0008, 0x2008, 0x2008, 0x2008, 0x2008, 0x2008, 0x2008, 0x2008, 0x0008, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xC308, 0x2511, 0x0411, 0x2511, 0x2511, 0x0411, 0xE408, 0xA300, 0x0511, 0xAA32, 0x3054, 0x2C3B, 0xCE4B, 0x505C, 0x4511, 0xE408, 0x0409, 0x0409, 0x0409, 0xC308, 0x8200, 0xC719, 0xD26C, 0xAE4B, 0x6D43, 0x547D, 0xE721, 0xC300, 0xE408, 0xC300, 0xE400, 0xE300, 0xE400, 0xE300, 0xC300, 0xC300, 0xE308, 0x4100, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x6A4A, 0x159D, 0x6621, 0xC729, 0x0832, 0xC829, 0xE831, 0xC831, 0xC729, 0xC729, 0xE829, 0xA729, 0x2932, 0xD274, 0x5485, 0x916C, 0x347D, 0x916C, 0x8A3A, 0xA729, 0xA729, 0xA729, 0xA729, 0xA729, 0x6621, 0xCB3A, 0x105C, 0xCE53, 0x0F5C, 0xEF53, 0x0C43, 0x0832, 0x8721, 0x6621, 0x8621, 0x8721, 0x8721, 0xA208, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0xC308, 0x0409, 0xA308, 0xC300, 0xE408, 0x8619, 0xAA32, 0x0F54, 0x715C, 0x3054, 0x505C, 0x4C43, 0xE408, 0xC308, 0x0409, 0xE408, 0xC308, 0x8300, 0x2511, 0x4C43, 0xF374, 0x305C, 0x9164, 0x1375, 0x2822, 0x8300, 0xE408, 0xE300, 0xE300, 0xC300, 0xC300, 0xC300, 0xC300, 0xC300, 0xA300, 0xC300, 0x4000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x8210, 0xF083, 0xB494, 0x293A, 0xA721, 0xE831, 0xC729, 0xC729, 0xC729, 0xC729, 0xC729, 0xC729, 0xA729, 0xA729, 0x4D4B, 0x7164, 0x305C, 0x7164, 0x505C, 0x6D4B, 0x4932, 0xA729, 0x8621, 0xA729, 0xA729, 0x6621, 0xA721, 0x4932, 0xCB3A, 0x0C43, 0x6D4B, 0x4C43, 0xEB3A, 0x4932, 0xC729, 0xA729, 0xC310, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x6100, 0x4511, 0x0822, 0xAA32, 0xAE4B, 0x505C, 0xB15C, 0x505C, 0xCE4B, 0x0B3B, 0x8611, 0xA300, 0xC308, 0xA300, 0x8200, 0xA300, 0x8611, 0x2C43, 0xB164, 0x1375, 0xD26C, 0xF26C, 0x0F54, 0x4509, 0x8200, 0xE408, 0xE300, 0xE300, 0xE300, 0xC300, 0xC300, 0xC300, 0xE300, 0xA300, 0x8902, 0xA601, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x2842, 0xB48C, 0xEC52, 0x8729, 0xE831, 0xC729, 0xA729, 0xC729, 0xA729, 0xA729, 0xA729, 0xA729, 0x8621, 0xE829, 0xCB42, 0x4D43, 0x8D4B, 0xAE4B, 0x8E4B, 0xEB3A, 0x6932, 0xA729, 0x8721, 0x8621, 0x4621, 0xC729, 0x493A, 0x8621, 0x082A, 0x4932, 0xAA3A, 0xEB3A, 0xEB3A, 0xAA32, 0xC619, 0x4511, 0xE308, 0x4100, 0x4100, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x2008, 0x2008, 0x2008, 0x2008, 0x2008, 0x2008, 0x2008, 0x2008, 0x2008, 0x2008, 0x2008, 0x2000, 0x2000, 0x2000, 0x2000, 0x2000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x2000, 0x6100, 0x6108, 0x2411, 0xE721, 0x6932, 0x2C43, 0xEE4B, 0x715C, 0xD264, 0xD264, 0x915C, 0xCE4B, 0xEB32, 0xE719, 0xE408, 0x4100, 0x8200, 0xA300, 0xC408, 0x8611, 0x8A32, 0xCE4B, 0xB264, 0x3375, 0xF26C, 0xB164, 0xAE4B, 0xC719, 0xA300, 0xA300, 0xE408, 0xC300, 0xC300, 0xC300, 0xC300, 0xC300, 0xC300, 0xC300, 0xA200, 0xC200, 0x0301, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0411, 0x6629, 0x2100, 0x4519, 0xA729, 0xE831, 0xC729, 0xA729, 0xA729, 0xA729, 0xA729, 0xA729, 0xE831, 0xA729, 0x8721, 0x0832, 0x6932, 0xCB3A, 0x0C3B, 0x0C43, 0x0C3B, 0xAB3A, 0x2932, 0xC729, 0xA729, 0x8621, 0x4621, 0x4621, 0x4519, 0x6621, 0x8621, 0xA721, 0x8619, 0xC619, 0x071A, 0x281A, 0x281A, 0x071A, 0xC619, 0x6511, 0x2411, 0xE308, 0xA208, 0x6100, 0x2000, 0x2000, 0x2000, 0x0008, 0x2008, 0x2008, 0x4010, 0x4010, 0x4010, 0x4010, 0x4010, 0x6010, 0x6018, 0x4018, 0x4018, 0x4010, 0x2010, 0x2010, 0x2010, 0x2008, 0x4008, 0x4008, 0x4108, 0x4108, 0x4100, 0x4108, 0xA210, 0x0311, 0x4519, 0xA621, 0x072A, 0x4832, 0xEB3A, 0xAE4B, 0x505C, 0xD26C, 0x1375, 0x547D, 0x5475, 0x3375, 0xB164, 0xEE53, 0x2C3B, 0x482A, 0x2511, 0xA300, 0x4100, 0x6200, 0x2509, 0xC721, 0x8A32, 0x6D43, 0x2F54, 0xD26C, 0x3375, 0xF36C, 0xB164, 0xCE4B, 0xAA2A, 0x6611, 0x8200, 0x8200, 0xE408, 0xC300, 0xC300, 0xC300, 0xC300, 0xC300, 0xC300, 0xC300, 0xC300, 0xA200, 0x8100, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x2000, 0xC310, 0x4621, 0xA729, 0xC729, 0xA729, 0x8721, 0xA729, 0xC729, 0xA729, 0x8721, 0x8621, 0x6621, 0x6621, 0xA729, 0xE829, 0x4932, 0x8A32, 0xCB3A, 0xCB3A, 0xAA32, 0x492A, 0x282A, 0xC721, 0xA721, 0x6621, 0x6621, 0xC410, 0x0000, 0x0000, 0x0000, 0x6100, 0xA208, 0xE308, 0x2411, 0x8511, 0xA619, 0x8511, 0x8519, 0x8519, 0x4419, 0x2319, 0x2321, 0x0221, 0xE220, 0xE120, 0xE128, 0xE128, 0xE128, 0xE128, 0x0129, 0x0229, 0x2231, 0x6331, 0xA431, 0xE631, 0x273A, 0x683A, 0xAA42, 0xEA42, 0x2B4B, 0x6C4B, 0xAD53, 0xCE53, 0x0F54, 0x305C, 0x9164, 0xB26C, 0xF26C, 0x3375, 0x5475, 0x747D, 0x547D, 0x1375, 0xB26C, 0x2F5C, 0xAD53, 0x0B3B, 0x282A, 0x6519, 0x2411, 0x8208, 0x8200, 0x4511, 0xA721, 0xCA32, 0xAE4B, 0x305C, 0xB26C, 0x3375, 0x547D, 0x547D, 0x1375, 0x715C, 0x8D43, 0x8A2A, 0x8611, 0xC300, 0x6200, 0x8200, 0xC300, 0xC300, 0xA300, 0xC300, 0xC300, 0xC300, 0xC300, 0xA300, 0xA200, 0x2100, 0x0000, 0x8100, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x4108, 0xC310, 0x2519, 0x8621, 0xA729, 0xA729, 0xA721, 0x8621, 0x8621, 0x8621, 0x8621, 0x6621, 0x6621, 0x6621, 0x6621, 0x8621, 0xC729, 0x0822, 0x692A, 0x692A, 0x8A32, 0x8A32, 0x692A, 0x492A, 0xA619, 0x4411, 0xE308, 0xA208, 0x6100, 0x4000, 0x0000, 0x0000, 0x2008, 0x2008, 0x4010, 0x8018, 0xA120, 0xE120, 0x0129, 0x0129, 0x2231, 0x2231, 0x2231, 0x4239, 0x4239, 0x4239, 0x6239, 0x6339, 0x8341, 0xC441, 0x264A, 0x884A, 0xEA52, 0x4B53, 0x8C5B, 0xCD5B, 0xEE5B, 0x0F64, 0x0F64, 0x0E64, 0xEE63, 0xEE5B, 0xCD5B, 0x8D53, 0x4C4B, 0x0B43, 0xA93A, 0x0732, 0xC629, 0x8519, 0x4419, 0x4419, 0x4419, 0x6519, 0xA621, 0x072A, 0xCA3A, 0x8D53, 0x5064, 0xD274, 0x7485, 0xB68D, 0xD68D, 0xB68D, 0xB585, 0x547D, 0xB264, 0xEE53, 0x2C3B, 0x0822, 0x2511, 0xA200, 0x6200, 0x8200, 0xC300, 0xC300, 0xC300, 0xA300, 0xC300, 0xC300, 0xA200, 0xA300, 0x8200, 0x8200, 0x4100, 0x6100, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x2000, 0x8208, 0xE310, 0x2519, 0x6621, 0x8621, 0x8621, 0x8721, 0x8621, 0x8621, 0x6621, 0x4619, 0xA729, 0x6621, 0x4519, 0x4519, 0x6619, 0x8619, 0xA719, 0xE721, 0xA719, 0x8511, 0xA611, 0xA611, 0x8511, 0x6511, 0x4411, 0x2411, 0x0311, 0x0219, 0xE220, 0x0221, 0x0129, 0x2131, 0x2139, 0x4239, 0x6241, 0x6241, 0x8241, 0x8249, 0xA349, 0xC349, 0xC349, 0xC351, 0xE351, 0xE451, 0xE451, 0xE451, 0xE451, 0xE549, 0x054A, 0x2652, 0x4652, 0x4652, 0x464A, 0x264A, 0x254A, 0x264A, 0x264A, 0x264A, 0x464A, 0x6842, 0xCA42, 0x0B4B, 0x4C53, 0x8D53, 0xCE5B, 0x2F64, 0xB174, 0x337D, 0x958D, 0xD68D, 0xF795, 0x1796, 0x1796, 0xD68D, 0x9585, 0x1375, 0x916C, 0x0F5C, 0x6D4B, 0x8932, 0xC621, 0x0409, 0x8200, 0x6200, 0x6200, 0x8200, 0xA300, 0xC300, 0xC300, 0xC300, 0xA300, 0xC300, 0xA300, 0x8200, 0x6100, 0xA200, 0x4100, 0x8100, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x2000, 0x6108, 0xC310, 0xE410, 0x4519, 0x6619, 0x8621, 0xA721, 0xC829, 0x8721, 0x4619, 0x4519, 0x4519, 0x4519, 0x4519, 0x4519, 0x8208, 0x4100, 0x4000, 0x6100, 0x8100, 0xA208, 0xE218, 0x0219, 0x2221, 0x4329, 0x6339, 0x6339, 0x8341, 0xA349, 0xC349, 0xC351, 0xE351, 0xE451, 0x045A, 0x045A, 0x245A, 0x245A, 0x4562, 0x4562, 0x6662, 0xA762, 0xC86A, 0x096B, 0x4B6B, 0x8C6B, 0xED73, 0x2E74, 0x4F74, 0x907C, 0xB17C, 0xF27C, 0x1385, 0x3485, 0x5485, 0x758D, 0x958D, 0xB58D, 0xB68D, 0xB68D, 0xB68D, 0xB68D, 0x9585, 0x7585, 0x5485, 0x137D, 0xB174, 0x5064, 0xCE5B, 0x2C4B, 0xAA3A, 0x4832, 0xC621, 0x0319, 0xA208, 0x8200, 0x6200, 0x4100, 0xA308, 0x8621, 0xC300, 0xE400, 0xC300, 0xC300, 0xC300, 0xA300, 0x8200, 0x8200, 0x6200, 0x6100, 0x2000, 0xE308, 0x0000, 0x4100, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x2000, 0x4100, 0xA208, 0xC308, 0xE410, 0x0419, 0x4519, 0x4519, 0x6619, 0x6619, 0x2511, 0x4108, 0x2000, 0x2000, 0x4008, 0x4010, 0x8018, 0xC020, 0xE028, 0x0131, 0x4139, 0x8241, 0xA349, 0xC351, 0xE351, 0x045A, 0x245A, 0x4462, 0x4562, 0x656A, 0x656A, 0x856A, 0x866A, 0xA66A, 0xA672, 0xC772, 0xE772, 0x0873, 0x4973, 0x6A73, 0xAC7B, 0xCC7B, 0x0D7C, 0x2E7C, 0x2E7C, 0x4F7C, 0x4F7C, 0x4F7C, 0x4F7C, 0x2E7C, 0x0E74, 0xCD73, 0xAC6B, 0x8B6B, 0x4A63, 0x095B, 0xA852, 0x674A, 0xE541, 0x8339, 0xE228, 0xA220, 0x8118, 0x4010, 0x0010, 0x0010, 0x2010, 0x2010, 0x2010, 0x8110, 0xE300, 0x0401, 0x2409, 0xE308, 0xC310, 0xA200, 0xA200, 0x6100, 0x2000, 0x2000, 0x2000, 0x0000, 0x0000, 0x2000, 0x2000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x2000, 0x4100, 0x4100, 0x8208, 0x8208, 0x4000, 0x4000, 0x4008, 0x8018, 0xE128, 0x2131, 0x6241, 0xA249, 0xC351, 0x035A, 0x2462, 0x4462, 0x656A, 0x856A, 0xA572, 0xA672, 0xC672, 0xC67A, 0xC67A, 0xE67A, 0xE67A, 0xE77A, 0xE77A, 0xE77A, 0xE77A, 0xE77A, 0xE77A, 0xE77A, 0xE77A, 0xE77A, 0xE77A, 0xE67A, 0xE77A, 0xC67A, 0xC672, 0xA672, 0xA672, 0x8672, 0x8572, 0x656A, 0x446A, 0x2462, 0x0362, 0x0262, 0xE259, 0xC259, 0xA251, 0x6149, 0x4149, 0x2141, 0x0139, 0xE130, 0xC028, 0xA020, 0x8018, 0x6010, 0x6010, 0x8110, 0x6108, 0x4100, 0x4100, 0x6100, 0x2000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x4008, 0x6010, 0x6010, 0x8118, 0xA128, 0x2239, 0xA341, 0xC349, 0xE451, 0x245A, 0x4562, 0x866A, 0x8672, 0xE67A, 0xE782, 0x0783, 0x2783, 0x478B, 0x488B, 0x6893, 0x6893, 0x6893, 0x6893, 0x8893, 0x6893, 0x6893, 0x6893, 0x6893, 0x6893, 0x488B, 0x488B, 0x278B, 0x0783, 0x0783, 0xE67A, 0xC67A, 0xA672, 0x656A, 0x4562, 0x255A, 0x0452, 0xC449, 0xA341, 0x4239, 0x0131, 0x8020, 0x6010, 0x6010, 0x4008, 0x4008, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0008, 0x6010, 0x8118, 0xA118, 0xA118, 0xC120, 0xE220, 0xE228, 0x0229, 0x0229, 0x0229, 0x0229, 0x0229, 0x0229, 0x0229, 0x0229, 0x0229, 0xE228, 0xE220, 0xE220, 0xC120, 0xA118, 0x8118, 0x8110, 0x4010, 0x0008, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000
+static const uint8_t naphome_asset_data[9160] = {
+    0x4E, 0x49, 0x4D, 0x47, 0x01, 0x00, 0x80, 0x00, 0x80, 0x00, 0x00, 0x00, 0xFF, 0x00, 0x00, 0xFF,
+    0x00, 0x00, 0xFF, 0x00, 0x00, 0xFF, 0x00, 0x00, 0xFF, 0x00, 0x00, 0xFF, 0x00, 0x00, 0xFF, 0x00,
+    0x00, 0xFF, 0x00, 0x00, 0xFF, 0x00, 0x00, 0xFF, 0x00, 0x00, 0xFF, 0x00, 0x00, 0xFF, 0x00, 0x00,
+    0xFF, 0x00, 0x00, 0xFF, 0x00, 0x00, 0xFF, 0x00, 0x00, 0xFF, 0x00, 0x00, 0xFF, 0x00, 0x00, 0xBC,
+    0x00, 0x00, 0x07, 0x10, 0xA2, 0x42, 0x07, 0x52, 0x69, 0x6B, 0x6A, 0x73, 0xCC, 0x6B, 0x0B, 0x4A,
+    0x07, 0x31, 0x44, 0xF4, 0x00, 0x00, 0x04, 0x08, 0x60, 0x52, 0x68, 0xAD, 0x33, 0xE6, 0x98, 0xFF,
+    0x5B, 0x82, 0xFF, 0x7C, 0x05, 0xFF, 0x7B, 0xFF, 0x5B, 0xFE, 0xD8, 0xD5, 0xB4, 0x93, 0xAD, 0x31,
+    0x44, 0xED, 0x00, 0x00, 0x0A, 0x00, 0x20, 0x00, 0x00, 0x00, 0x20, 0x6B, 0x2A, 0xD6, 0x57, 0xFF,
+    0xDD, 0xFF, 0x9C, 0xFF, 0x3A, 0xFE, 0xFA, 0xFE, 0xFA, 0xFF, 0x1A, 0x82, 0xFF, 0x3B, 0x05, 0xFF,
+    0x5B, 0xFF, 0x7C, 0xFF, 0x9C, 0xFE, 0xFA, 0xAC, 0xB1, 0x31, 0x64, 0xEC, 0x00, 0x00, 0x07, 0x41,
+    0xE6, 0xC5, 0xD5, 0xFF, 0xFD, 0xFF, 0xBD, 0xFE, 0xFA, 0xFE, 0xF9, 0xFF, 0x1A, 0xFF, 0x3B, 0x82,
+    0xFF, 0x5B, 0x81, 0xFF, 0x5C, 0x83, 0xFF, 0x5B, 0x03, 0xFF, 0x9C, 0xFF, 0x3A, 0x9C, 0x0F, 0x10,
+    0x61, 0xE9, 0x00, 0x00, 0x09, 0x7B, 0xAD, 0xF7, 0x5B, 0xFF, 0xDD, 0xFF, 0x5B, 0xFE, 0xF9, 0xFF,
+    0x1A, 0xFF, 0x3B, 0xFF, 0x5B, 0xFF, 0x5B, 0xFF, 0x5C, 0x87, 0xFF, 0x7C, 0x04, 0xFF, 0x5B, 0xFF,
+    0x5C, 0xFF, 0xBD, 0xDE, 0x36, 0x4A, 0x05, 0xE6, 0x00, 0x00, 0x09, 0x10, 0x81, 0xB5, 0x53, 0xFF,
+    0xDD, 0xFF, 0x7C, 0xFF, 0x5B, 0xFE, 0xFA, 0xFF, 0x1A, 0xFF, 0x5B, 0xFF, 0x5B, 0xFF, 0x5C, 0x84,
+    0xFF, 0x7C, 0x85, 0xFF, 0x9C, 0x04, 0xFF, 0x7C, 0xFF, 0x5B, 0xFF, 0x9C, 0xFF, 0x3B, 0x7B, 0x2B,
+    0xE4, 0x00, 0x00, 0x09, 0x18, 0xC2, 0xCE, 0x16, 0xFF, 0xDD, 0xF7, 0x5B, 0xFF, 0x7C, 0xFE, 0xFA,
+    0xFF, 0x1A, 0xFF, 0x5B, 0xFF, 0x5B, 0xFF, 0x5C, 0x83, 0xFF, 0x7C, 0x00, 0xFF, 0x9C, 0x88, 0xFF,
+    0x9D, 0x81, 0xFF, 0x7C, 0x01, 0xFF, 0x9C, 0x8B, 0xEE, 0xE2, 0x00, 0x00, 0x09, 0x19, 0x02, 0xD6,
+    0x37, 0xFF, 0xDD, 0xF7, 0x5B, 0xFF, 0x7C, 0xFF, 0x1A, 0xFF, 0x1A, 0xFF, 0x5B, 0xFF, 0x5B, 0xFF,
+    0x5C, 0x82, 0xFF, 0x7C, 0x00, 0xFF, 0x9C, 0x83, 0xFF, 0x9D, 0x86, 0xFF, 0xBD, 0x81, 0xFF, 0x9D,
+    0x02, 0xFF, 0x7C, 0xFF, 0xDD, 0x94, 0x2F, 0xE0, 0x00, 0x00, 0x0C, 0x18, 0xC2, 0xD6, 0x77, 0xFF,
+    0xBD, 0xF7, 0x5B, 0xFF, 0x9C, 0xFF, 0x3A, 0xFF, 0x1A, 0xFF, 0x5B, 0xFF, 0x5B, 0xFF, 0x5C, 0xFF,
+    0x7C, 0xFF, 0x7C, 0xFF, 0x9C, 0x82, 0xFF, 0x9D, 0x8B, 0xFF, 0xBD, 0x03, 0xFF, 0x9D, 0xFF, 0x7C,
+    0xFF, 0xDD, 0x94, 0x2F, 0xDE, 0x00, 0x00, 0x0B, 0x10, 0x82, 0xCE, 0x16, 0xFF, 0xBC, 0xF7, 0x5B,
+    0xFF, 0x9C, 0xFF, 0x5B, 0xFE, 0xFA, 0xFF, 0x3B, 0xFF, 0x5B, 0xFF, 0x5C, 0xFF, 0x7C, 0xFF, 0x7C,
+    0x82, 0xFF, 0x9D, 0x85, 0xFF, 0xBD, 0x83, 0xFF, 0xDE, 0x85, 0xFF, 0xBD, 0x02, 0xFF, 0x7C, 0xFF,
+    0xDD, 0x8B, 0xEE, 0xDC, 0x00, 0x00, 0x0D, 0x08, 0x41, 0xC5, 0x94, 0xFF, 0xBC, 0xF7, 0x3B, 0xFF,
+    0x7C, 0xFF, 0x7C, 0xFF, 0x1A, 0xFF, 0x3A, 0xFF, 0x5B, 0xFF, 0x5C, 0xFF, 0x7C, 0xFF, 0x7C, 0xFF,
+    0x9D, 0xFF, 0x9D, 0x84, 0xFF, 0xBD, 0x8A, 0xFF, 0xDE, 0x82, 0xFF, 0xBD, 0x02, 0xFF, 0x7C, 0xFF,
+    0xDD, 0x7B, 0x4B, 0xDB, 0x00, 0x00, 0x07, 0x9C, 0x90, 0xFF, 0xBC, 0xF7, 0x3B, 0xFF, 0x7C, 0xFF,
+    0x7C, 0xFF, 0x5B, 0xFF, 0x1A, 0xFF, 0x5B, 0x82, 0xFF, 0x7C, 0x81, 0xFF, 0x9D, 0x83, 0xFF, 0xBD,
+    0x8F, 0xFF, 0xDE, 0x03, 0xFF, 0xBD, 0xFF, 0x9D, 0xFF, 0x7C, 0x4A, 0x07, 0xD7, 0x00, 0x00, 0x0E,
+    0x00, 0x20, 0x00, 0x00, 0x62, 0xE9, 0xFF, 0x9C, 0xF7, 0x3B, 0xFF, 0x5B, 0xFF, 0x7C, 0xFF, 0x7C,
+    0xFF, 0x1A, 0xFF, 0x3B, 0xFF, 0x5C, 0xFF, 0x7C, 0xFF, 0x7C, 0xFF, 0x9D, 0xFF, 0x9D, 0x82, 0xFF,
+    0xBD, 0x86, 0xFF, 0xDE, 0x87, 0xFF, 0xFE, 0x07, 0xFF, 0xDE, 0xFF, 0xFE, 0xFF, 0xDE, 0xFF, 0xDE,
+    0xFF, 0xBD, 0xFF, 0xBD, 0xEE, 0xB9, 0x20, 0xE3, 0xD7, 0x00, 0x00, 0x0C, 0x31, 0x85, 0xF7, 0x1A,
+    0xF7, 0x5B, 0xF7, 0x5B, 0xFF, 0x7B, 0xFF, 0x9C, 0xFF, 0x5B, 0xFF, 0x1A, 0xFF, 0x5B, 0xFF, 0x7C,
+    0xFF, 0x9C, 0xFF, 0x9C, 0xFF, 0x9D, 0x82, 0xFF, 0xBD, 0x81, 0xFF, 0xDE, 0x8A, 0xFF, 0xFE, 0x00,
+    0xFF, 0xFF, 0x85, 0xFF, 0xFE, 0x04, 0xFF, 0xDE, 0xFF, 0x9D, 0xFF, 0xFE, 0xC5, 0x94, 0x00, 0x20,
+    0xD5, 0x00, 0x00, 0x0C, 0x08, 0x61, 0xC5, 0xB4, 0xFF, 0x7C, 0xF7, 0x3B, 0xFF, 0x5B, 0xFF, 0x7C,
+    0xFF, 0x7C, 0xFF, 0x1A, 0xFF, 0x3B, 0xFF, 0x7C, 0xFF, 0x7C, 0xFF, 0x9C, 0xFF, 0x9D, 0x82, 0xFF,
+    0xBD, 0x81, 0xFF, 0xDE, 0x83, 0xFF, 0xFE, 0x8C, 0xFF, 0xFF, 0x81, 0xFF, 0xFE, 0x81, 0xFF, 0xDE,
+    0x02, 0xFF, 0x9D, 0xFF, 0xFE, 0x7B, 0x6C, 0xD5, 0x00, 0x00, 0x0B, 0x83, 0xCD, 0xFF, 0x9C, 0xF7,
+    0x3A, 0xFF, 0x5B, 0xFF, 0x5B, 0xFF, 0x7C, 0xFF, 0x5B, 0xFF, 0x1A, 0xFF, 0x5B, 0xFF, 0x7C, 0xFF,
+    0x9C, 0xFF, 0x9D, 0x82, 0xFF, 0xBD, 0x81, 0xFF, 0xDE, 0x82, 0xFF, 0xFE, 0x91, 0xFF, 0xFF, 0x04,
+    0xFF, 0xFE, 0xFF, 0xDE, 0xFF, 0xBD, 0xFF, 0x7B, 0x39, 0x64, 0xD3, 0x00, 0x00, 0x0E, 0x39, 0xA5,
+    0xF7, 0x19, 0xF7, 0x3B, 0xF7, 0x5B, 0xFF, 0x5B, 0xFF, 0x7B, 0xFF, 0x7C, 0xFF, 0x3A, 0xFF, 0x3B,
+    0xFF, 0x7C, 0xFF, 0x7C, 0xFF, 0x9C, 0xFF, 0x9D, 0xFF, 0xBD, 0xFF, 0xBD, 0x82, 0xFF, 0xDE, 0x00,
+    0xFF, 0xFE, 0x94, 0xFF, 0xFF, 0x04, 0xFF, 0xFE, 0xFF, 0xDE, 0xFF, 0xFE, 0xCD, 0xB5, 0x08, 0x20,
+    0xD1, 0x00, 0x00, 0x0E, 0x00, 0x20, 0xBD, 0x73, 0xFF, 0x7B, 0xF7, 0x3A, 0xFF, 0x5B, 0xFF, 0x5B,
+    0xFF, 0x7C, 0xFF, 0x7C, 0xFF, 0x1A, 0xFF, 0x5B, 0xFF, 0x7C, 0xFF, 0x9C, 0xFF, 0x9D, 0xFF, 0xBD,
+    0xFF, 0xBD, 0x82, 0xFF, 0xDE, 0x00, 0xFF, 0xFE, 0x96, 0xFF, 0xFF, 0x03, 0xFF, 0xFE, 0xFF, 0xBD,
+    0xFF, 0xFE, 0x73, 0x0B, 0xD1, 0x00, 0x00, 0x11, 0x5A, 0xE9, 0xFF, 0x5B, 0xF7, 0x1A, 0xF7, 0x5B,
+    0xFF, 0x5B, 0xFF, 0x5B, 0xFF, 0x7C, 0xFF, 0x5B, 0xFF, 0x1A, 0xFF, 0x5C, 0xFF, 0x7C, 0xFF, 0x9D,
+    0xFF, 0x9D, 0xFF, 0xBD, 0xFF, 0xBD, 0xFF, 0xDE, 0xFF, 0xDE, 0xFF, 0xFE, 0x98, 0xFF, 0xFF, 0x03,
+    0xFF, 0xFE, 0xFF, 0xDE, 0xEE, 0xD9, 0x10, 0x82, 0xCF, 0x00, 0x00, 0x0E, 0x10, 0xA1, 0xD6, 0x36,
+    0xF7, 0x3B, 0xF7, 0x3A, 0xF7, 0x5B, 0xFF, 0x5B, 0xFF, 0x7B, 0xFF, 0x7C, 0xFF, 0x3A, 0xFF, 0x3B,
+    0xFF, 0x7C, 0xFF, 0x7C, 0xFF, 0x9D, 0xFF, 0xBD, 0xFF, 0xBD, 0x82, 0xFF, 0xDE, 0x00, 0xFF, 0xFE,
+    0x99, 0xFF, 0xFF, 0x02, 0xFF, 0xDE, 0xFF, 0xFF, 0x94, 0x4F, 0xCF, 0x00, 0x00, 0x0D, 0x7B, 0x8C,
+    0xFF, 0x5B, 0xF7, 0x1A, 0xF7, 0x3B, 0xFF, 0x5B, 0xFF, 0x5B, 0xFF, 0x7C, 0xFF, 0x7C, 0xFF, 0x1A,
+    0xFF, 0x5B, 0xFF, 0x7C, 0xFF, 0x9C, 0xFF, 0xBD, 0xFF, 0xBD, 0x82, 0xFF, 0xDE, 0x81, 0xFF, 0xFE,
+    0x99, 0xFF, 0xFF, 0x03, 0xFF, 0xFE, 0xFF, 0xDE, 0xFF, 0x5B, 0x31, 0x64, 0xCD, 0x00, 0x00, 0x12,
+    0x18, 0xC2, 0xDE, 0x77, 0xF7, 0x3A, 0xF7, 0x1A, 0xF7, 0x5B, 0xFF, 0x5B, 0xFF, 0x5B, 0xFF, 0x7C,
+    0xFF, 0x5B, 0xFF, 0x1A, 0xFF, 0x5C, 0xFF, 0x7C, 0xFF, 0x9D, 0xFF, 0xBD, 0xFF, 0xBD, 0xFF, 0xDE,
+    0xFF, 0xDE, 0xFF, 0xFE, 0xFF, 0xFE, 0x9B, 0xFF, 0xFF, 0x02, 0xFF, 0xDE, 0xFF, 0xFF, 0xAC, 0xD1,
+    0xCD, 0x00, 0x00, 0x12, 0x83, 0xAD, 0xFF, 0x5B, 0xEE, 0xFA, 0xF7, 0x3A, 0xF7, 0x5B, 0xFF, 0x5B,
+    0xFF, 0x5B, 0xFF, 0x7C, 0xFF, 0x3B, 0xFF, 0x1A, 0xFF, 0x7C, 0xFF, 0x7C, 0xFF, 0x9D, 0xFF, 0xBD,
+    0xFF, 0xDD, 0xFF, 0xDE, 0xFF, 0xDE, 0xFF, 0xFE, 0xFF, 0xFE, 0x9C, 0xFF, 0xFF, 0x02, 0xFF, 0xDE,
+    0xFF, 0x7C, 0x39, 0x85, 0xCB, 0x00, 0x00, 0x0E, 0x18, 0xC2, 0xDE, 0x56, 0xF7, 0x1A, 0xF7, 0x1A,
+    0xF7, 0x3B, 0xF7, 0x5B, 0xFF, 0x5B, 0xFF, 0x5B, 0xFF, 0x7C, 0xFF, 0x1A, 0xFF, 0x3B, 0xFF, 0x7C,
+    0xFF, 0x9C, 0xFF, 0xBD, 0xFF, 0xBD, 0x82, 0xFF, 0xDE, 0x81, 0xFF, 0xFE, 0x9C, 0xFF, 0xFF, 0x02,
+    0xFF, 0xDE, 0xFF, 0xFF, 0xAC, 0xD2, 0xCB, 0x00, 0x00, 0x12, 0x73, 0x6C, 0xFF, 0x3A, 0xEE, 0xF9,
+    0xF7, 0x3A, 0xF7, 0x3B, 0xF7, 0x5B, 0xFF, 0x5B, 0xFF, 0x7B, 0xFF, 0x7C, 0xFF, 0x1A, 0xFF, 0x3B,
+    0xFF, 0x7C, 0xFF, 0x9C, 0xFF, 0xBD, 0xFF, 0xBD, 0xFF, 0xDE, 0xFF, 0xDE, 0xFF, 0xFE, 0xFF, 0xFE,
+    0x9E, 0xFF, 0xFF, 0x02, 0xFF, 0xDE, 0xFF, 0x5B, 0x31, 0x44, 0xC9, 0x00, 0x00, 0x13, 0x08, 0x61,
+    0xCD, 0xF5, 0xF7, 0x1A, 0xF7, 0x1A, 0xF7, 0x3A, 0xF7, 0x3B, 0xF7, 0x5B, 0xFF, 0x5B, 0xFF, 0x7B,
+    0xFF, 0x5B, 0xFF, 0x1A, 0xFF, 0x5B, 0xFF, 0x7C, 0xFF, 0x9D, 0xFF, 0xBD, 0xFF, 0xBD, 0xFF, 0xDE,
+    0xFF, 0xDE, 0xFF, 0xFE, 0xFF, 0xFE, 0x9E, 0xFF, 0xFF, 0x02, 0xFF, 0xDE, 0xFF, 0xFF, 0x94, 0x4F,
+    0xC9, 0x00, 0x00, 0x13, 0x52, 0xC8, 0xF7, 0x19, 0xEE, 0xF9, 0xF7, 0x1A, 0xF7, 0x3A, 0xF7, 0x3B,
+    0xF7, 0x5B, 0xFF, 0x5B, 0xFF, 0x7B, 0xFF, 0x5B, 0xFF, 0x1A, 0xFF, 0x5B, 0xFF, 0x7C, 0xFF, 0x9D,
+    0xFF, 0xBD, 0xFF, 0xBD, 0xFF, 0xDE, 0xFF, 0xDE, 0xFF, 0xFE, 0xFF, 0xFE, 0x9F, 0xFF, 0xFF, 0x02,
+    0xFF, 0xFE, 0xEE, 0xD9, 0x18, 0xA2, 0xC8, 0x00, 0x00, 0x12, 0xB5, 0x31, 0xFF, 0x1A, 0xEE, 0xF9,
+    0xF7, 0x1A, 0xF7, 0x3A, 0xF7, 0x3B, 0xF7, 0x5B, 0xFF, 0x5B, 0xFF, 0x7B, 0xFF, 0x3B, 0xFF, 0x1A,
+    0xFF, 0x5C, 0xFF, 0x7C, 0xFF, 0x9D, 0xFF, 0xBD, 0xFF, 0xBD, 0xFF, 0xDE, 0xFF, 0xDE, 0xFF, 0xFE,
+    0xA0, 0xFF, 0xFF, 0x02, 0xFF, 0xDE, 0xFF, 0xFE, 0x73, 0x2B, 0xC7, 0x00, 0x00, 0x11, 0x31, 0x85,
+    0xEE, 0x98, 0xEE, 0xF9, 0xF7, 0x1A, 0xF7, 0x1A, 0xF7, 0x3A, 0xF7, 0x5B, 0xF7, 0x5B, 0xFF, 0x5B,
+    0xFF, 0x7C, 0xFF, 0x3A, 0xFF, 0x1A, 0xFF, 0x5C, 0xFF, 0x7C, 0xFF, 0x9D, 0xFF, 0xBD, 0xFF, 0xBD,
+    0xFF, 0xDE, 0x82, 0xFF, 0xFE, 0x9F, 0xFF, 0xFF, 0x03, 0xFF, 0xFE, 0xFF, 0xFF, 0xCD, 0xF5, 0x00,
+    0x40, 0xC6, 0x00, 0x00, 0x11, 0x7B, 0xAC, 0xF7, 0x19, 0xEE, 0xD9, 0xF7, 0x1A, 0xF7, 0x1A, 0xF7,
+    0x3A, 0xF7, 0x5B, 0xF7, 0x5B, 0xFF, 0x5B, 0xFF, 0x7B, 0xFF, 0x1A, 0xFF, 0x1A, 0xFF, 0x5C, 0xFF,
+    0x7C, 0xFF, 0x9D, 0xFF, 0xBD, 0xFF, 0xBD, 0xFF, 0xDE, 0x82, 0xFF, 0xFE, 0xA0, 0xFF, 0xFF, 0x02,
+    0xFF, 0xDE, 0xFF, 0x9C, 0x39, 0xA5, 0xC5, 0x00, 0x00, 0x15, 0x08, 0x61, 0xC5, 0xB3, 0xF6, 0xF9,
+    0xEE, 0xF9, 0xF7, 0x1A, 0xF7, 0x3A, 0xF7, 0x3A, 0xF7, 0x3B, 0xF7, 0x5B, 0xFF, 0x5B, 0xFF, 0x7B,
+    0xFF, 0x1A, 0xFF, 0x1A, 0xFF, 0x5C, 0xFF, 0x7C, 0xFF, 0x9D, 0xFF, 0xBD, 0xFF, 0xBD, 0xFF, 0xDE,
+    0xFF, 0xDE, 0xFF, 0xFE, 0xFF, 0xFE, 0xA0, 0xFF, 0xFF, 0x02, 0xFF, 0xDE, 0xFF, 0xFE, 0x94, 0x2F,
+    0xC5, 0x00, 0x00, 0x15, 0x39, 0xC6, 0xEE, 0xB7, 0xEE, 0xD8, 0xEE, 0xF9, 0xF7, 0x1A, 0xF7, 0x3A,
+    0xF7, 0x3A, 0xF7, 0x3B, 0xF7, 0x5B, 0xFF, 0x5B, 0xFF, 0x7B, 0xFF, 0x1A, 0xFF, 0x1B, 0xFF, 0x5C,
+    0xFF, 0x7C, 0xFF, 0x9D, 0xFF, 0xBD, 0xFF, 0xBD, 0xFF, 0xDE, 0xFF, 0xDE, 0xFF, 0xFE, 0xFF, 0xFE,
+    0xA0, 0xFF, 0xFF, 0x81, 0xFF, 0xFE, 0x01, 0xDE, 0x37, 0x08, 0x61, 0xC4, 0x00, 0x00, 0x15, 0x83,
+    0xCD, 0xF6, 0xF9, 0xEE, 0xB8, 0xF6, 0xF9, 0xF7, 0x1A, 0xF7, 0x3A, 0xF7, 0x3A, 0xF7, 0x3B, 0xF7,
+    0x5B, 0xFF, 0x5B, 0xFF, 0x5B, 0xFF, 0x1A, 0xFF, 0x3B, 0xFF, 0x5C, 0xFF, 0x7C, 0xFF, 0x9D, 0xFF,
+    0xBD, 0xFF, 0xBD, 0xFF, 0xDE, 0xFF, 0xDE, 0xFF, 0xFE, 0xFF, 0xFE, 0xA1, 0xFF, 0xFF, 0x02, 0xFF,
+    0xDE, 0xFF, 0x9C, 0x41, 0xE6, 0xC3, 0x00, 0x00, 0x16, 0x08, 0x61, 0xBD, 0x73, 0xEE, 0xD8, 0xEE,
+    0xD9, 0xF6, 0xF9, 0xF7, 0x1A, 0xF7, 0x3A, 0xF7, 0x3A, 0xF7, 0x3B, 0xF7, 0x5B, 0xFF, 0x5B, 0xFF,
+    0x5B, 0xFE, 0xFA, 0xFF, 0x3A, 0xFF, 0x5C, 0xFF, 0x7C, 0xFF, 0x9D, 0xFF, 0xBD, 0xFF, 0xBD, 0xFF,
+    0xDE, 0xFF, 0xDE, 0xFF, 0xFE, 0xFF, 0xFE, 0xA1, 0xFF, 0xFF, 0x02, 0xFF, 0xDE, 0xFF, 0xFE, 0x94,
+    0x2F, 0xC3, 0x00, 0x00, 0x12, 0x29, 0x23, 0xE6, 0x76, 0xEE, 0xB8, 0xEE, 0xD9, 0xF6, 0xF9, 0xF7,
+    0x1A, 0xF7, 0x3A, 0xF7, 0x3A, 0xF7, 0x3B, 0xF7, 0x5B, 0xFF, 0x5B, 0xFF, 0x5B, 0xFE, 0xFA, 0xFF,
+    0x1A, 0xFF, 0x5B, 0xFF, 0x7C, 0xFF, 0x9C, 0xFF, 0xBD, 0xFF, 0xBD, 0x82, 0xFF, 0xDE, 0x81, 0xFF,
+    0xFE, 0xA0, 0xFF, 0xFF, 0x03, 0xFF, 0xDE, 0xFF, 0xFE, 0xD5, 0xF6, 0x00, 0x20, 0xC2, 0x00, 0x00,
+    0x17, 0x6B, 0x0A, 0xEE, 0xD8, 0xE6, 0xB8, 0xEE, 0xD9, 0xF6, 0xF9, 0xF7, 0x1A, 0xF7, 0x1A, 0xF7,
+    0x3A, 0xF7, 0x3B, 0xF7, 0x5B, 0xF7, 0x5B, 0xFF, 0x5B, 0xFE, 0xF9, 0xFF, 0x1A, 0xFF, 0x5B, 0xFF,
+    0x7C, 0xFF, 0x9C, 0xFF, 0x9D, 0xFF, 0xBD, 0xFF, 0xBD, 0xFF, 0xDE, 0xFF, 0xDE, 0xFF, 0xFE, 0xFF,
+    0xFE, 0xA0, 0xFF, 0xFF, 0x03, 0xFF, 0xFE, 0xFF, 0xDE, 0xFF, 0x3B, 0x39, 0xA5, 0xC2, 0x00, 0x00,
+    0x13, 0x9C, 0x6F, 0xF6, 0xD8, 0xE6, 0xB8, 0xEE, 0xF9, 0xF6, 0xF9, 0xF7, 0x1A, 0xF7, 0x1A, 0xF7,
+    0x3A, 0xF7, 0x3B, 0xF7, 0x3B, 0xF7, 0x5B, 0xF7, 0x5B, 0xFE, 0xF9, 0xFF, 0x1A, 0xFF, 0x5B, 0xFF,
+    0x7C, 0xFF, 0x7C, 0xFF, 0x9D, 0xFF, 0xBD, 0xFF, 0xBD, 0x82, 0xFF, 0xDE, 0x81, 0xFF, 0xFE, 0x9F,
+    0xFF, 0xFF, 0x05, 0xFF, 0xFE, 0xFF, 0xBD, 0xFF, 0xDD, 0x5A, 0x89, 0x00, 0x00, 0x00, 0x20, 0xBF,
+    0x00, 0x00, 0x14, 0x10, 0xA2, 0xC5, 0x73, 0xEE, 0xB8, 0xEE, 0xB8, 0xEE, 0xD9, 0xF6, 0xF9, 0xF7,
+    0x1A, 0xF7, 0x1A, 0xF7, 0x3A, 0xF7, 0x3B, 0xF7, 0x3B, 0xF7, 0x5B, 0xF7, 0x5B, 0xFE, 0xF9, 0xFF,
+    0x1A, 0xFF, 0x5B, 0xFF, 0x5C, 0xFF, 0x7C, 0xFF, 0x9C, 0xFF, 0xBD, 0xFF, 0xBD, 0x82, 0xFF, 0xDE,
+    0x81, 0xFF, 0xFE, 0x9F, 0xFF, 0xFF, 0x03, 0xFF, 0xFE, 0xFF, 0xBD, 0xFF, 0xFE, 0x9C, 0x70, 0xC1,
+    0x00, 0x00, 0x15, 0x31, 0x64, 0xE6, 0x56, 0xE6, 0x97, 0xEE, 0xB8, 0xEE, 0xD9, 0xF6, 0xF9, 0xF7,
+    0x1A, 0xF7, 0x1A, 0xF7, 0x3A, 0xF7, 0x3A, 0xF7, 0x3B, 0xF7, 0x3B, 0xF7, 0x5B, 0xFE, 0xFA, 0xFE,
+    0xFA, 0xFF, 0x3B, 0xFF, 0x5B, 0xFF, 0x7C, 0xFF, 0x9C, 0xFF, 0x9D, 0xFF, 0xBD, 0xFF, 0xBD, 0x82,
+    0xFF, 0xDE, 0x81, 0xFF, 0xFE, 0x9E, 0xFF, 0xFF, 0x03, 0xFF, 0xFE, 0xFF, 0xDE, 0xFF, 0xDD, 0xDE,
+    0x16, 0xC1, 0x00, 0x00, 0x13, 0x5A, 0x68, 0xEE, 0x97, 0xE6, 0x77, 0xEE, 0xB8, 0xEE, 0xD9, 0xF6,
+    0xF9, 0xF7, 0x1A, 0xF7, 0x1A, 0xF7, 0x3A, 0xF7, 0x3A, 0xF7, 0x3B, 0xF7, 0x3B, 0xF7, 0x5B, 0xFE,
+    0xFA, 0xFE, 0xF9, 0xFF, 0x3B, 0xFF, 0x5B, 0xFF, 0x7C, 0xFF, 0x7C, 0xFF, 0x9D, 0x82, 0xFF, 0xBD,
+    0x81, 0xFF, 0xDE, 0x81, 0xFF, 0xFE, 0x9D, 0xFF, 0xFF, 0x81, 0xFF, 0xFE, 0x03, 0xFF, 0xDE, 0xFF,
+    0xBD, 0xF6, 0xF9, 0x21, 0x03, 0xC0, 0x00, 0x00, 0x14, 0x94, 0x2E, 0xEE, 0x97, 0xE6, 0x77, 0xEE,
+    0xB8, 0xEE, 0xD9, 0xEE, 0xF9, 0xF7, 0x1A, 0xF7, 0x1A, 0xF7, 0x3A, 0xF7, 0x3A, 0xF7, 0x3B, 0xF7,
+    0x3B, 0xF7, 0x5B, 0xF7, 0x1A, 0xFE, 0xD9, 0xFF, 0x3B, 0xFF, 0x5B, 0xFF, 0x5C, 0xFF, 0x7C, 0xFF,
+    0x9C, 0xFF, 0x9D, 0x82, 0xFF, 0xBD, 0x81, 0xFF, 0xDE, 0x81, 0xFF, 0xFE, 0x9C, 0xFF, 0xFF, 0x81,
+    0xFF, 0xFE, 0x03, 0xFF, 0xDE, 0xFF, 0x9D, 0xFF, 0x9C, 0x5A, 0xA9, 0xC0, 0x00, 0x00, 0x14, 0xA4,
+    0x8F, 0xEE, 0x97, 0xE6, 0x77, 0xEE, 0xB8, 0xEE, 0xD9, 0xEE, 0xF9, 0xF6, 0xF9, 0xF7, 0x1A, 0xF7,
+    0x1A, 0xF7, 0x3A, 0xF7, 0x3A, 0xF7, 0x3B, 0xF7, 0x5B, 0xF7, 0x3A, 0xFE, 0xD9, 0xFF, 0x1A, 0xFF,
+    0x3B, 0xFF, 0x5B, 0xFF, 0x7C, 0xFF, 0x9C, 0xFF, 0x9D, 0x82, 0xFF, 0xBD, 0x83, 0xFF, 0xDE, 0x00,
+    0xFF, 0xFE, 0x9B, 0xFF, 0xFF, 0x07, 0xFF, 0xFE, 0xFF, 0xDE, 0xFF, 0xDE, 0xFF, 0x9D, 0xFF, 0xDD,
+    0x73, 0x0B, 0x00, 0x00, 0x00, 0x20, 0xBD, 0x00, 0x00, 0x0B, 0x00, 0x21, 0xB5, 0x11, 0xE6, 0x76,
+    0xE6, 0x77, 0xEE, 0xB8, 0xEE, 0xD9, 0xEE, 0xF9, 0xEE, 0xF9, 0xF7, 0x1A, 0xF7, 0x1A, 0xF7, 0x3A,
+    0xF7, 0x3A, 0x82, 0xF7, 0x3B, 0x07, 0xFE, 0xF9, 0xFF, 0x1A, 0xFF, 0x3B, 0xFF, 0x5B, 0xFF, 0x5C,
+    0xFF, 0x7C, 0xFF, 0x9C, 0xFF, 0x9D, 0x82, 0xFF, 0xBD, 0x82, 0xFF, 0xDE, 0x84, 0xFF, 0xFE, 0x96,
+    0xFF, 0xFF, 0x81, 0xFF, 0xFE, 0x81, 0xFF, 0xDE, 0x02, 0xFF, 0x9D, 0xFF, 0xDD, 0x8B, 0xEE, 0xBF,
+    0x00, 0x00, 0x07, 0x31, 0x64, 0xD5, 0xF4, 0xDE, 0x56, 0xE6, 0x97, 0xEE, 0xB8, 0xEE, 0xD8, 0xEE,
+    0xF9, 0xEE, 0xF9, 0x82, 0xF7, 0x1A, 0x81, 0xF7, 0x3A, 0x81, 0xF7, 0x3B, 0x08, 0xFE, 0xF9, 0xFE,
+    0xFA, 0xFF, 0x3A, 0xFF, 0x3B, 0xFF, 0x5B, 0xFF, 0x7C, 0xFF, 0x7C, 0xFF, 0x9D, 0xFF, 0x9D, 0x82,
+    0xFF, 0xBD, 0x83, 0xFF, 0xDE, 0x84, 0xFF, 0xFE, 0x93, 0xFF, 0xFF, 0x81, 0xFF, 0xFE, 0x81, 0xFF,
+    0xDE, 0x04, 0xFF, 0xBD, 0xFF, 0x9D, 0xFF, 0x9D, 0xCD, 0xB5, 0x00, 0x20, 0xBE, 0x00, 0x00, 0x0A,
+    0x41, 0xC5, 0xDE, 0x14, 0xDE, 0x36, 0xE6, 0x77, 0xEE, 0xB8, 0xEE, 0xD8, 0xEE, 0xF9, 0xEE, 0xF9,
+    0xF6, 0xF9, 0xF7, 0x1A, 0xF7, 0x1A, 0x82, 0xF7, 0x3A, 0x0A, 0xF7, 0x5B, 0xFE, 0xFA, 0xFE, 0xF9,
+    0xFF, 0x1A, 0xFF, 0x3B, 0xFF, 0x5B, 0xFF, 0x5C, 0xFF, 0x7C, 0xFF, 0x9C, 0xFF, 0x9D, 0xFF, 0x9D,
+    0x82, 0xFF, 0xBD, 0x84, 0xFF, 0xDE, 0x84, 0xFF, 0xFE, 0x8F, 0xFF, 0xFF, 0x82, 0xFF, 0xFE, 0x82,
+    0xFF, 0xDE, 0x04, 0xFF, 0xBD, 0xFF, 0x9D, 0xFF, 0x9C, 0xDE, 0x36, 0x08, 0x41, 0xBE, 0x00, 0x00,
+    0x08, 0x49, 0xE6, 0xDE, 0x14, 0xDE, 0x35, 0xE6, 0x77, 0xE6, 0xB8, 0xEE, 0xB8, 0xEE, 0xD9, 0xEE,
+    0xF9, 0xEE, 0xF9, 0x82, 0xF7, 0x1A, 0x81, 0xF7, 0x3A, 0x0B, 0xF7, 0x3B, 0xFF, 0x1A, 0xFE, 0xD9,
+    0xFF, 0x1A, 0xFF, 0x3B, 0xFF, 0x3B, 0xFF, 0x5B, 0xFF, 0x7C, 0xFF, 0x7C, 0xFF, 0x9C, 0xFF, 0x9D,
+    0xFF, 0x9D, 0x82, 0xFF, 0xBD, 0x85, 0xFF, 0xDE, 0x86, 0xFF, 0xFE, 0x88, 0xFF, 0xFF, 0x84, 0xFF,
+    0xFE, 0x82, 0xFF, 0xDE, 0x81, 0xFF, 0xBD, 0x03, 0xFF, 0x9C, 0xFF, 0x7C, 0xEE, 0x98, 0x10, 0x81,
+    0xBE, 0x00, 0x00, 0x08, 0x41, 0xE6, 0xE6, 0x35, 0xDE, 0x15, 0xE6, 0x77, 0xE6, 0x97, 0xEE, 0xB8,
+    0xEE, 0xD9, 0xEE, 0xF9, 0xEE, 0xF9, 0x82, 0xF7, 0x1A, 0x81, 0xF7, 0x3A, 0x0C, 0xF7, 0x3B, 0xF7,
+    0x3A, 0xFE, 0xD9, 0xFE, 0xFA, 0xFF, 0x1A, 0xFF, 0x3B, 0xFF, 0x5B, 0xFF, 0x5B, 0xFF, 0x7C, 0xFF,
+    0x7C, 0xFF, 0x9C, 0xFF, 0x9D, 0xFF, 0x9D, 0x82, 0xFF, 0xBD, 0x86, 0xFF, 0xDE, 0x91, 0xFF, 0xFE,
+    0x82, 0xFF, 0xDE, 0x06, 0xFF, 0xDD, 0xFF, 0xBD, 0xFF, 0xBD, 0xFF, 0x9C, 0xFF, 0x7C, 0xF6, 0xB8,
+    0x10, 0x61, 0xBE, 0x00, 0x00, 0x09, 0x6A, 0xA9, 0xDE, 0x14, 0xDE, 0x15, 0xE6, 0x76, 0xE6, 0x97,
+    0xEE, 0xB8, 0xEE, 0xD8, 0xEE, 0xD9, 0xEE, 0xF9, 0xF6, 0xF9, 0x82, 0xF7, 0x1A, 0x82, 0xF7, 0x3A,
+    0x81, 0xFE, 0xD9, 0x03, 0xFF, 0x1A, 0xFF, 0x3B, 0xFF, 0x3B, 0xFF, 0x5B, 0x82, 0xFF, 0x7C, 0x02,
+    0xFF, 0x9C, 0xFF, 0x9D, 0xFF, 0x9D, 0x83, 0xFF, 0xBD, 0x87, 0xFF, 0xDE, 0x8B, 0xFF, 0xFE, 0x85,
+    0xFF, 0xDE, 0x81, 0xFF, 0xBD, 0x04, 0xFF, 0x9D, 0xFF, 0x7C, 0xFF, 0x5C, 0xFE, 0xF9, 0x29, 0x44,
+    0xBE, 0x00, 0x00, 0x09, 0x93, 0xEC, 0xDD, 0xD3, 0xDE, 0x15, 0xE6, 0x56, 0xE6, 0x97, 0xE6, 0xB8,
+    0xEE, 0xD8, 0xEE, 0xD9, 0xEE, 0xF9, 0xEE, 0xF9, 0x83, 0xF7, 0x1A, 0x81, 0xF7, 0x3A, 0x0C, 0xF6,
+    0xF9, 0xFE, 0xD9, 0xFE, 0xFA, 0xFF, 0x1A, 0xFF, 0x3B, 0xFF, 0x3B, 0xFF, 0x5B, 0xFF, 0x5C, 0xFF,
+    0x7C, 0xFF, 0x7C, 0xFF, 0x9C, 0xFF, 0x9D, 0xFF, 0x9D, 0x84, 0xFF, 0xBD, 0x8B, 0xFF, 0xDE, 0x81,
+    0xFF, 0xFE, 0x88, 0xFF, 0xDE, 0x82, 0xFF, 0xBD, 0x04, 0xFF, 0x9D, 0xFF, 0x7C, 0xFF, 0x5B, 0xFF,
+    0x3A, 0x4A, 0x49, 0xBE, 0x00, 0x00, 0x0A, 0x8B, 0xEC, 0xD5, 0xD3, 0xDE, 0x15, 0xDE, 0x56, 0xE6,
+    0x77, 0xE6, 0x98, 0xEE, 0xB8, 0xEE, 0xD8, 0xEE, 0xD9, 0xEE, 0xF9, 0xF6, 0xF9, 0x83, 0xF7, 0x1A,
+    0x08, 0xF7, 0x3A, 0xF7, 0x1A, 0xFE, 0xB8, 0xFE, 0xF9, 0xFF, 0x1A, 0xFF, 0x1A, 0xFF, 0x3B, 0xFF,
+    0x5B, 0xFF, 0x5B, 0x82, 0xFF, 0x7C, 0x00, 0xFF, 0x9C, 0x82, 0xFF, 0x9D, 0x85, 0xFF, 0xBD, 0x92,
+    0xFF, 0xDE, 0x82, 0xFF, 0xBD, 0x05, 0xFF, 0x9D, 0xFF, 0x9C, 0xFF, 0x7C, 0xFF, 0x3B, 0xFF, 0x1A,
+    0x62, 0x28, 0xBE, 0x00, 0x00, 0x0B, 0x93, 0xCC, 0xD5, 0xB3, 0xD5, 0xF4, 0xDE, 0x56, 0xE6, 0x77,
+    0xE6, 0x97, 0xEE, 0xB8, 0xEE, 0xD8, 0xEE, 0xD9, 0xEE, 0xF9, 0xEE, 0xF9, 0xF6, 0xF9, 0x83, 0xF7,
+    0x1A, 0x08, 0xF7, 0x3A, 0xFE, 0xD9, 0xFE, 0xD9, 0xFE, 0xFA, 0xFF, 0x1A, 0xFF, 0x3B, 0xFF, 0x3B,
+    0xFF, 0x5B, 0xFF, 0x5B, 0x82, 0xFF, 0x7C, 0x00, 0xFF, 0x9C, 0x83, 0xFF, 0x9D, 0x86, 0xFF, 0xBD,
+    0x8C, 0xFF, 0xDE, 0x84, 0xFF, 0xBD, 0x81, 0xFF, 0x9D, 0x81, 0xFF, 0x7C, 0x02, 0xFF, 0x3B, 0xFF,
+    0x1A, 0x52, 0x48, 0xBE, 0x00, 0x00, 0x0C, 0x93, 0xCB, 0xD5, 0x92, 0xD5, 0xD4, 0xDE, 0x35, 0xE6,
+    0x76, 0xE6, 0x97, 0xEE, 0xB8, 0xEE, 0xB8, 0xEE, 0xD8, 0xEE, 0xD9, 0xEE, 0xF9, 0xEE, 0xF9, 0xF6,
+    0xF9, 0x82, 0xF7, 0x1A, 0x09, 0xF7, 0x3A, 0xF6, 0xF9, 0xFE, 0xB8, 0xFE, 0xF9, 0xFE, 0xFA, 0xFF,
+    0x1A, 0xFF, 0x3B, 0xFF, 0x3B, 0xFF, 0x5B, 0xFF, 0x5B, 0x83, 0xFF, 0x7C, 0x00, 0xFF, 0x9C, 0x83,
+    0xFF, 0x9D, 0x95, 0xFF, 0xBD, 0x81, 0xFF, 0x9D, 0x05, 0xFF, 0x9C, 0xFF, 0x7C, 0xFF, 0x5B, 0xFF,
+    0x3B, 0xFE, 0xFA, 0x4A, 0x28, 0xBE, 0x00, 0x00, 0x0D, 0x8B, 0xAB, 0xCD, 0x71, 0xD5, 0xD3, 0xDE,
+    0x15, 0xDE, 0x56, 0xE6, 0x77, 0xE6, 0x97, 0xEE, 0xB8, 0xEE, 0xB8, 0xEE, 0xD9, 0xEE, 0xD9, 0xEE,
+    0xF9, 0xEE, 0xF9, 0xF6, 0xF9, 0x83, 0xF7, 0x1A, 0x09, 0xF6, 0xB8, 0xFE, 0xD9, 0xFE, 0xFA, 0xFF,
+    0x1A, 0xFF, 0x1A, 0xFF, 0x3B, 0xFF, 0x3B, 0xFF, 0x5B, 0xFF, 0x5B, 0xFF, 0x5C, 0x82, 0xFF, 0x7C,
+    0x00, 0xFF, 0x9C, 0x84, 0xFF, 0x9D, 0x91, 0xFF, 0xBD, 0x82, 0xFF, 0x9D, 0x06, 0xFF, 0x9C, 0xFF,
+    0x7C, 0xFF, 0x7C, 0xFF, 0x5B, 0xFF, 0x1B, 0xFE, 0xD8, 0x3A, 0x26, 0xBE, 0x00, 0x00, 0x0E, 0x83,
+    0x8A, 0xCD, 0x51, 0xCD, 0xB3, 0xDE, 0x15, 0xDE, 0x36, 0xE6, 0x76, 0xE6, 0x97, 0xE6, 0x98, 0xEE,
+    0xB8, 0xEE, 0xD8, 0xEE, 0xD9, 0xEE, 0xD9, 0xEE, 0xF9, 0xEE, 0xF9, 0xF6, 0xF9, 0x82, 0xF7, 0x1A,
+    0x0A, 0xF6, 0xF9, 0xFE, 0xB8, 0xFE, 0xF9, 0xFE, 0xFA, 0xFF, 0x1A, 0xFF, 0x1A, 0xFF, 0x3B, 0xFF,
+    0x3B, 0xFF, 0x5B, 0xFF, 0x5B, 0xFF, 0x5C, 0x84, 0xFF, 0x7C, 0x00, 0xFF, 0x9C, 0x85, 0xFF, 0x9D,
+    0x8A, 0xFF, 0xBD, 0x83, 0xFF, 0x9D, 0x81, 0xFF, 0x9C, 0x81, 0xFF, 0x7C, 0x04, 0xFF, 0x5C, 0xFF,
+    0x3B, 0xFF, 0x1A, 0xEE, 0x97, 0x1A, 0x06, 0xBE, 0x00, 0x00, 0x0F, 0x73, 0x09, 0xC5, 0x30, 0xCD,
+    0x92, 0xD5, 0xF4, 0xDE, 0x35, 0xDE, 0x56, 0xE6, 0x77, 0xE6, 0x97, 0xE6, 0xB8, 0xEE, 0xB8, 0xEE,
+    0xD8, 0xEE, 0xD9, 0xEE, 0xD9, 0xEE, 0xF9, 0xEE, 0xF9, 0xF6, 0xF9, 0x82, 0xF7, 0x1A, 0x0A, 0xF6,
+    0xB8, 0xFE, 0xB9, 0xFE, 0xF9, 0xFE, 0xFA, 0xFF, 0x1A, 0xFF, 0x1A, 0xFF, 0x3B, 0xFF, 0x3B, 0xFF,
+    0x5B, 0xFF, 0x5B, 0xFF, 0x5C, 0x84, 0xFF, 0x7C, 0x81, 0xFF, 0x9C, 0x90, 0xFF, 0x9D, 0x81, 0xFF,
+    0x9C, 0x82, 0xFF, 0x7C, 0x05, 0xFF, 0x5C, 0xFF, 0x5B, 0xFF, 0x3B, 0xFF, 0x3A, 0xDD, 0xD5, 0x08,
+    0x41, 0xBE, 0x00, 0x00, 0x0D, 0x41, 0x84, 0xC5, 0x0F, 0xC5, 0x71, 0xD5, 0xD3, 0xDE, 0x15, 0xDE,
+    0x36, 0xE6, 0x56, 0xE6, 0x97, 0xE6, 0x97, 0xEE, 0xB8, 0xEE, 0xB8, 0xEE, 0xD8, 0xEE, 0xD9, 0xEE,
+    0xD9, 0x82, 0xEE, 0xF9, 0x0D, 0xF6, 0xF9, 0xF7, 0x1A, 0xF6, 0xF9, 0xFE, 0xB8, 0xFE, 0xD9, 0xFE,
+    0xF9, 0xFE, 0xFA, 0xFF, 0x1A, 0xFF, 0x1A, 0xFF, 0x3B, 0xFF, 0x3B, 0xFF, 0x5B, 0xFF, 0x5B, 0xFF,
+    0x5C, 0x86, 0xFF, 0x7C, 0x81, 0xFF, 0x9C, 0x89, 0xFF, 0x9D, 0x81, 0xFF, 0x9C, 0x00, 0xFF, 0x9D,
+    0x82, 0xFF, 0x9C, 0x82, 0xFF, 0x7C, 0x04, 0xFF, 0x5B, 0xFF, 0x3B, 0xFF, 0x1A, 0xFF, 0x3B, 0xC4,
+    0xF0, 0xBF, 0x00, 0x00, 0x0E, 0x31, 0x43, 0xBC, 0xAE, 0xC5, 0x30, 0xCD, 0xB3, 0xD5, 0xF4, 0xDE,
+    0x15, 0xDE, 0x56, 0xE6, 0x76, 0xE6, 0x97, 0xE6, 0x97, 0xEE, 0xB8, 0xEE, 0xB8, 0xEE, 0xD8, 0xEE,
+    0xD9, 0xEE, 0xD9, 0x82, 0xEE, 0xF9, 0x0A, 0xF6, 0xF9, 0xF7, 0x1A, 0xF6, 0xD9, 0xFE, 0xB8, 0xFE,
+    0xD9, 0xFE, 0xF9, 0xFE, 0xFA, 0xFF, 0x1A, 0xFF, 0x1A, 0xFF, 0x3B, 0xFF, 0x3B, 0x82, 0xFF, 0x5B,
+    0x00, 0xFF, 0x5C, 0x87, 0xFF, 0x7C, 0x8A, 0xFF, 0x9C, 0x85, 0xFF, 0x7C, 0x81, 0xFF, 0x5B, 0x03,
+    0xFF, 0x3B, 0xFE, 0xFA, 0xFF, 0x1A, 0x93, 0xAC, 0xBF, 0x00, 0x00, 0x0F, 0x29, 0x23, 0xAC, 0x4C,
+    0xBC, 0xEF, 0xCD, 0x72, 0xD5, 0xD3, 0xDE, 0x14, 0xDE, 0x35, 0xE6, 0x56, 0xE6, 0x77, 0xE6, 0x97,
+    0xE6, 0x97, 0xEE, 0xB8, 0xEE, 0xB8, 0xEE, 0xD8, 0xEE, 0xD9, 0xEE, 0xD9, 0x82, 0xEE, 0xF9, 0x08,
+    0xF6, 0xF9, 0xEE, 0xF9, 0xF6, 0xB8, 0xFE, 0xB8, 0xFE, 0xD9, 0xFE, 0xF9, 0xFE, 0xFA, 0xFF, 0x1A,
+    0xFF, 0x1A, 0x82, 0xFF, 0x3B, 0x82, 0xFF, 0x5B, 0x00, 0xFF, 0x5C, 0x95, 0xFF, 0x7C, 0x81, 0xFF,
+    0x5B, 0x04, 0xFF, 0x3B, 0xFF, 0x3A, 0xFE, 0xFA, 0xFE, 0xB8, 0x51, 0xC4, 0xBF, 0x00, 0x00, 0x0B,
+    0x21, 0x03, 0x9B, 0xCB, 0xB4, 0xAE, 0xC5, 0x51, 0xCD, 0xB3, 0xD5, 0xF4, 0xDE, 0x15, 0xDE, 0x36,
+    0xE6, 0x56, 0xE6, 0x77, 0xE6, 0x97, 0xE6, 0x97, 0x82, 0xEE, 0xB8, 0x02, 0xEE, 0xD8, 0xEE, 0xD9,
+    0xEE, 0xD9, 0x83, 0xEE, 0xF9, 0x06, 0xF6, 0x98, 0xFE, 0xB9, 0xFE, 0xF9, 0xFE, 0xF9, 0xFE, 0xFA,
+    0xFF, 0x1A, 0xFF, 0x1A, 0x83, 0xFF, 0x3B, 0x82, 0xFF, 0x5B, 0x81, 0xFF, 0x5C, 0x8F, 0xFF, 0x7C,
+    0x81, 0xFF, 0x5C, 0x81, 0xFF, 0x5B, 0x81, 0xFF, 0x3B, 0x81, 0xFF, 0x1A, 0x01, 0xDD, 0x93, 0x20,
+    0xA0, 0xBF, 0x00, 0x00, 0x0C, 0x00, 0x21, 0x7A, 0xE8, 0xB4, 0x6D, 0xBD, 0x0F, 0xCD, 0x71, 0xD5,
+    0xB3, 0xD5, 0xF4, 0xDE, 0x15, 0xDE, 0x36, 0xE6, 0x56, 0xE6, 0x77, 0xE6, 0x97, 0xE6, 0x97, 0x83,
+    0xEE, 0xB8, 0x00, 0xEE, 0xD8, 0x82, 0xEE, 0xD9, 0x06, 0xEE, 0xF9, 0xEE, 0xD9, 0xF6, 0x98, 0xFE,
+    0xD9, 0xFE, 0xD9, 0xFE, 0xF9, 0xFE, 0xFA, 0x82, 0xFF, 0x1A, 0x83, 0xFF, 0x3B, 0x83, 0xFF, 0x5B,
+    0x83, 0xFF, 0x5C, 0x86, 0xFF, 0x7C, 0x82, 0xFF, 0x5C, 0x83, 0xFF, 0x5B, 0x81, 0xFF, 0x3B, 0x04,
+    0xFF, 0x1A, 0xFE, 0xF9, 0xFE, 0xF9, 0x9B, 0xAA, 0x18, 0xC1, 0xC0, 0x00, 0x00, 0x0E, 0x5A, 0x46,
+    0xA4, 0x0B, 0xB4, 0xAE, 0xC5, 0x30, 0xCD, 0x92, 0xD5, 0xD3, 0xD5, 0xF4, 0xDE, 0x15, 0xDE, 0x36,
+    0xE6, 0x56, 0xE6, 0x77, 0xE6, 0x77, 0xE6, 0x97, 0xE6, 0x97, 0xE6, 0xB8, 0x82, 0xEE, 0xB8, 0x81,
+    0xEE, 0xD8, 0x81, 0xEE, 0xD9, 0x05, 0xEE, 0xD8, 0xF6, 0x98, 0xFE, 0xD9, 0xFE, 0xF9, 0xFE, 0xF9,
+    0xFE, 0xFA, 0x83, 0xFF, 0x1A, 0x83, 0xFF, 0x3B, 0x88, 0xFF, 0x5B, 0x81, 0xFF, 0x5C, 0x86, 0xFF,
+    0x5B, 0x82, 0xFF, 0x3B, 0x05, 0xFF, 0x1A, 0xFE, 0xFA, 0xFF, 0x1A, 0xE5, 0xB4, 0x5A, 0x03, 0x19,
+    0x03, 0xC0, 0x00, 0x00, 0x0C, 0x31, 0x23, 0x93, 0x89, 0xAC, 0x4C, 0xBC, 0xEF, 0xC5, 0x51, 0xCD,
+    0x92, 0xD5, 0xD3, 0xDD, 0xF4, 0xDE, 0x15, 0xDE, 0x36, 0xE6, 0x56, 0xE6, 0x76, 0xE6, 0x77, 0x82,
+    0xE6, 0x97, 0x00, 0xE6, 0xB8, 0x82, 0xEE, 0xB8, 0x81, 0xEE, 0xD8, 0x07, 0xEE, 0xD9, 0xEE, 0xB8,
+    0xF6, 0x97, 0xFE, 0xB9, 0xFE, 0xF9, 0xFE, 0xF9, 0xFE, 0xFA, 0xFE, 0xFA, 0x82, 0xFF, 0x1A, 0x85,
+    0xFF, 0x3B, 0x8B, 0xFF, 0x5B, 0x83, 0xFF, 0x3B, 0x82, 0xFF, 0x1A, 0x03, 0xFE, 0xF9, 0xFE, 0xD9,
+    0x93, 0x48, 0x39, 0x62, 0xC1, 0x00, 0x00, 0x0E, 0x10, 0x81, 0x72, 0xE7, 0x9B, 0xCA, 0xB4, 0x8D,
+    0xC5, 0x10, 0xCD, 0x71, 0xCD, 0xB2, 0xD5, 0xD3, 0xD5, 0xF4, 0xDE, 0x15, 0xDE, 0x35, 0xDE, 0x56,
+    0xE6, 0x56, 0xE6, 0x76, 0xE6, 0x77, 0x82, 0xE6, 0x97, 0x00, 0xE6, 0xB8, 0x85, 0xEE, 0xB8, 0x01,
+    0xEE, 0x97, 0xFE, 0xB8, 0x82, 0xFE, 0xF9, 0x81, 0xFE, 0xFA, 0x82, 0xFF, 0x1A, 0x8B, 0xFF, 0x3B,
+    0x00, 0xFF, 0x5B, 0x85, 0xFF, 0x3B, 0x82, 0xFF, 0x1A, 0x05, 0xFE, 0xD9, 0xFF, 0x1A, 0xC4, 0xAE,
+    0x59, 0xC1, 0x31, 0x84, 0x00, 0x20, 0xC0, 0x00, 0x00, 0x10, 0x08, 0x41, 0x51, 0xE5, 0x8B, 0x48,
+    0xA4, 0x0B, 0xB4, 0xAE, 0xC5, 0x30, 0xCD, 0x71, 0xCD, 0xB2, 0xD5, 0xD3, 0xD5, 0xF4, 0xDE, 0x15,
+    0xDE, 0x35, 0xDE, 0x36, 0xDE, 0x56, 0xE6, 0x56, 0xE6, 0x77, 0xE6, 0x77, 0x83, 0xE6, 0x97, 0x81,
+    0xEE, 0xB8, 0x05, 0xE6, 0xB8, 0xEE, 0xB8, 0xE6, 0xB8, 0xEE, 0x77, 0xFE, 0x98, 0xFE, 0xD9, 0x82,
+    0xFE, 0xF9, 0x00, 0xFE, 0xFA, 0x83, 0xFF, 0x1A, 0x00, 0xFF, 0x3A, 0x8D, 0xFF, 0x3B, 0x82, 0xFF,
+    0x1A, 0x06, 0xFE, 0xFA, 0xFE, 0xD9, 0xFF, 0x3B, 0xDD, 0x92, 0x6A, 0x23, 0x49, 0xC3, 0x10, 0x80,
+    0xC2, 0x00, 0x00, 0x12, 0x21, 0x43, 0x72, 0xA6, 0x93, 0x89, 0xAC, 0x4C, 0xBC, 0xCE, 0xC5, 0x30,
+    0xCD, 0x71, 0xCD, 0x92, 0xD5, 0xB3, 0xD5, 0xF4, 0xDD, 0xF4, 0xDE, 0x15, 0xDE, 0x35, 0xDE, 0x36,
+    0xDE, 0x56, 0xE6, 0x56, 0xE6, 0x76, 0xE6, 0x77, 0xE6, 0x77, 0x84, 0xE6, 0x97, 0x09, 0xE6, 0x98,
+    0xE6, 0xB8, 0xE6, 0x77, 0xEE, 0x77, 0xFE, 0xB8, 0xFE, 0xF9, 0xFE, 0xD9, 0xFE, 0xF9, 0xFE, 0xFA,
+    0xFE, 0xFA, 0x85, 0xFF, 0x1A, 0x81, 0xFF, 0x3A, 0x84, 0xFF, 0x3B, 0x00, 0xFF, 0x3A, 0x84, 0xFF,
+    0x1A, 0x07, 0xFE, 0xFA, 0xFE, 0xD9, 0xFF, 0x1A, 0xE5, 0x93, 0x7A, 0x84, 0x5A, 0x04, 0x31, 0x01,
+    0x08, 0x81, 0xC2, 0x00, 0x00, 0x13, 0x08, 0x61, 0x49, 0xC4, 0x7A, 0xE7, 0x9B, 0xAA, 0xAC, 0x4C,
+    0xBC, 0xCE, 0xC5, 0x10, 0xC5, 0x51, 0xCD, 0x92, 0xCD, 0xB3, 0xD5, 0xD3, 0xD5, 0xF4, 0xDE, 0x14,
+    0xDE, 0x15, 0xDE, 0x35, 0xDE, 0x35, 0xDE, 0x56, 0xE6, 0x56, 0xE6, 0x56, 0xE6, 0x76, 0x82, 0xE6,
+    0x77, 0x07, 0xE6, 0x97, 0xE6, 0x77, 0xE6, 0x97, 0xE6, 0x97, 0xE6, 0x77, 0xE6, 0x56, 0xF6, 0x77,
+    0xFE, 0xD9, 0x82, 0xFE, 0xF9, 0x82, 0xFE, 0xFA, 0x8D, 0xFF, 0x1A, 0x08, 0xFE, 0xFA, 0xFE, 0xF9,
+    0xFE, 0xFA, 0xFF, 0x1A, 0xD5, 0x31, 0x7A, 0x84, 0x62, 0x44, 0x41, 0x62, 0x18, 0x40, 0xC4, 0x00,
+    0x00, 0x13, 0x20, 0xA1, 0x5A, 0x24, 0x83, 0x07, 0x9B, 0xCA, 0xAC, 0x4C, 0xB4, 0xAE, 0xBD, 0x0F,
+    0xC5, 0x31, 0xCD, 0x72, 0xCD, 0x92, 0xD5, 0xB3, 0xD5, 0xD4, 0xD5, 0xF4, 0xDE, 0x14, 0xDE, 0x15,
+    0xDE, 0x35, 0xDE, 0x35, 0xDE, 0x36, 0xDE, 0x56, 0xDE, 0x56, 0x82, 0xE6, 0x56, 0x82, 0xE6, 0x76,
+    0x81, 0xE6, 0x77, 0x03, 0xDE, 0x56, 0xE6, 0x36, 0xF6, 0x77, 0xFE, 0xB9, 0x84, 0xFE, 0xF9, 0x81,
+    0xFE, 0xFA, 0x86, 0xFF, 0x1A, 0x81, 0xFE, 0xFA, 0x81, 0xFE, 0xF9, 0x08, 0xFE, 0xFA, 0xFF, 0x1A,
+    0xF6, 0x77, 0xB4, 0x4D, 0x72, 0xA5, 0x6A, 0x65, 0x49, 0xA2, 0x28, 0xC1, 0x08, 0x00, 0xC0, 0x00,
+    0x00, 0x13, 0x00, 0x40, 0x08, 0xA2, 0x08, 0x61, 0x08, 0x82, 0x10, 0xA2, 0x31, 0x22, 0x62, 0x45,
+    0x83, 0x07, 0x9B, 0xCA, 0xAC, 0x2C, 0xB4, 0x8D, 0xBC, 0xEF, 0xC5, 0x30, 0xCD, 0x51, 0xCD, 0x72,
+    0xCD, 0x92, 0xD5, 0xB3, 0xD5, 0xD3, 0xD5, 0xF4, 0xD5, 0xF4, 0x82, 0xDE, 0x15, 0x83, 0xDE, 0x35,
+    0x81, 0xDE, 0x36, 0x81, 0xDE, 0x56, 0x07, 0xE6, 0x56, 0xDE, 0x56, 0xDE, 0x36, 0xDE, 0x15, 0xE6,
+    0x15, 0xEE, 0x36, 0xFE, 0x98, 0xFE, 0xD9, 0x82, 0xFE, 0xFA, 0x87, 0xFE, 0xF9, 0x81, 0xFE, 0xFA,
+    0x0C, 0xFF, 0x1A, 0xFE, 0xFA, 0xF6, 0x77, 0xCD, 0x10, 0x93, 0x68, 0x7A, 0xC5, 0x72, 0xA6, 0x51,
+    0xA3, 0x30, 0xE0, 0x20, 0xA1, 0x10, 0xE3, 0x08, 0x62, 0x00, 0xC0, 0xB8, 0x00, 0x00, 0x1B, 0x00,
+    0x61, 0x08, 0x61, 0x08, 0xC3, 0x19, 0xE8, 0x29, 0x86, 0x29, 0x86, 0x32, 0x07, 0x3A, 0x8A, 0x3A,
+    0x4A, 0x42, 0x6A, 0x31, 0xC8, 0x08, 0x61, 0x41, 0x62, 0x62, 0x65, 0x83, 0x07, 0x9B, 0xA9, 0xA4,
+    0x2B, 0xB4, 0x6D, 0xB4, 0xAE, 0xBC, 0xEF, 0xC5, 0x30, 0xCD, 0x51, 0xCD, 0x71, 0xCD, 0x92, 0xD5,
+    0xB3, 0xD5, 0xD3, 0xD5, 0xD3, 0xD5, 0xD4, 0x82, 0xD5, 0xF4, 0x85, 0xDE, 0x15, 0x28, 0xDE, 0x35,
+    0xDE, 0x15, 0xDE, 0x15, 0xDE, 0x35, 0xDE, 0x15, 0xD5, 0xF4, 0xD5, 0xD3, 0xDD, 0xD4, 0xEE, 0x15,
+    0xF6, 0x57, 0xFE, 0x98, 0xFE, 0xD9, 0xFE, 0xF9, 0xFE, 0xFA, 0xFE, 0xFA, 0xFF, 0x1A, 0xFF, 0x1A,
+    0xFE, 0xFA, 0xFE, 0xF9, 0xFE, 0xD9, 0xF6, 0x77, 0xE5, 0xB4, 0xC4, 0xAE, 0x9B, 0xA9, 0x8B, 0x27,
+    0x83, 0x07, 0x72, 0x86, 0x51, 0xC3, 0x39, 0x01, 0x20, 0x80, 0x18, 0xA2, 0x21, 0x66, 0x21, 0x87,
+    0x19, 0xE5, 0x11, 0x03, 0x10, 0xE4, 0x11, 0x45, 0x19, 0x04, 0x00, 0x20, 0x00, 0x41, 0x00, 0x61,
+    0xAB, 0x00, 0x00, 0x81, 0x00, 0x41, 0x0A, 0x08, 0x61, 0x19, 0xA5, 0x21, 0x66, 0x29, 0xA7, 0x3A,
+    0x6A, 0x3A, 0x6A, 0x42, 0x6A, 0x42, 0x8A, 0x42, 0x6A, 0x42, 0x6A, 0x3A, 0x4A, 0x82, 0x3A, 0x29,
+    0x16, 0x3A, 0x6A, 0x10, 0xE4, 0x10, 0x60, 0x41, 0x83, 0x62, 0x45, 0x7A, 0xE7, 0x93, 0x69, 0xA3,
+    0xEA, 0xAC, 0x4C, 0xB4, 0x8D, 0xBC, 0xCE, 0xBD, 0x0F, 0xC5, 0x30, 0xC5, 0x51, 0xCD, 0x71, 0xCD,
+    0x92, 0xCD, 0x92, 0xCD, 0xB3, 0xD5, 0xB3, 0xD5, 0xD3, 0xD5, 0xD3, 0xD5, 0xD4, 0xD5, 0xD4, 0x8A,
+    0xD5, 0xF4, 0x27, 0xD5, 0xD3, 0xCD, 0xB3, 0xCD, 0x72, 0xCD, 0x51, 0xD5, 0x71, 0xD5, 0x72, 0xDD,
+    0x93, 0xDD, 0xB3, 0xDD, 0x93, 0xDD, 0x72, 0xD5, 0x31, 0xC4, 0xCF, 0xB4, 0x6D, 0xAC, 0x0B, 0x9B,
+    0xA9, 0x93, 0x89, 0x93, 0x68, 0x82, 0xE7, 0x62, 0x45, 0x51, 0xA3, 0x39, 0x01, 0x28, 0xA0, 0x18,
+    0x60, 0x21, 0xA7, 0x21, 0xC7, 0x21, 0x66, 0x11, 0x45, 0x19, 0x66, 0x19, 0x45, 0x11, 0x45, 0x19,
+    0x45, 0x11, 0x25, 0x19, 0x66, 0x19, 0x86, 0x08, 0xC3, 0x11, 0x04, 0x08, 0xC3, 0x00, 0x00, 0x00,
+    0x61, 0x00, 0x20, 0xA2, 0x00, 0x00, 0x09, 0x00, 0x20, 0x11, 0x24, 0x21, 0x45, 0x2A, 0x6A, 0x3A,
+    0x6A, 0x42, 0x4A, 0x42, 0x8A, 0x42, 0x8A, 0x42, 0x6A, 0x42, 0x4A, 0x86, 0x3A, 0x49, 0x14, 0x3A,
+    0x6A, 0x3A, 0x49, 0x3A, 0x6A, 0x32, 0x08, 0x00, 0x41, 0x18, 0xA1, 0x41, 0x62, 0x5A, 0x24, 0x72,
+    0xC6, 0x8B, 0x28, 0x9B, 0xA9, 0xA4, 0x0B, 0xAC, 0x6C, 0xB4, 0x8D, 0xBC, 0xCE, 0xBC, 0xEF, 0xC5,
+    0x10, 0xC5, 0x30, 0xC5, 0x51, 0xCD, 0x71, 0xCD, 0x72, 0x82, 0xCD, 0x92, 0x01, 0xCD, 0xB2, 0xCD,
+    0xB3, 0x87, 0xD5, 0xB3, 0x00, 0xCD, 0xB3, 0x83, 0xCD, 0x92, 0x28, 0xCD, 0x71, 0xC5, 0x51, 0xC5,
+    0x10, 0xBC, 0xEF, 0xBC, 0xCE, 0xB4, 0x8D, 0xB4, 0x6D, 0xAC, 0x4C, 0xA4, 0x2B, 0xA4, 0x0A, 0x9B,
+    0xEA, 0x9B, 0xA9, 0x8B, 0x48, 0x72, 0xA6, 0x5A, 0x04, 0x49, 0x82, 0x39, 0x01, 0x20, 0xA0, 0x18,
+    0x20, 0x29, 0xE7, 0x4C, 0x0F, 0x4B, 0xAE, 0x4B, 0x8E, 0x43, 0x4C, 0x32, 0xCB, 0x2A, 0x49, 0x21,
+    0xE7, 0x19, 0xA6, 0x11, 0x45, 0x11, 0x04, 0x11, 0x04, 0x11, 0x45, 0x11, 0x65, 0x11, 0x25, 0x10,
+    0xE4, 0x11, 0xA6, 0x08, 0xE4, 0x08, 0xC3, 0x00, 0x82, 0x00, 0x00, 0x00, 0x20, 0x9B, 0x00, 0x00,
+    0x0E, 0x08, 0xA2, 0x19, 0x25, 0x29, 0xA6, 0x3A, 0x6A, 0x42, 0x6A, 0x42, 0x8B, 0x42, 0x49, 0x42,
+    0x4A, 0x3A, 0x49, 0x3A, 0x29, 0x3A, 0x29, 0x3A, 0x49, 0x42, 0x4A, 0x3A, 0x49, 0x3A, 0x4A, 0x84,
+    0x3A, 0x6A, 0x81, 0x3A, 0x49, 0x17, 0x3A, 0x29, 0x3A, 0x49, 0x21, 0x45, 0x00, 0x00, 0x18, 0xA0,
+    0x39, 0x41, 0x59, 0xE4, 0x6A, 0x85, 0x83, 0x07, 0x93, 0x68, 0x9B, 0xCA, 0xA4, 0x0B, 0xAC, 0x4C,
+    0xB4, 0x8D, 0xB4, 0xAE, 0xBC, 0xCF, 0xBC, 0xEF, 0xC5, 0x10, 0xC5, 0x30, 0xC5, 0x30, 0xC5, 0x51,
+    0xC5, 0x51, 0xCD, 0x71, 0xCD, 0x71, 0x86, 0xCD, 0x72, 0x81, 0xCD, 0x71, 0x2E, 0xCD, 0x51, 0xC5,
+    0x51, 0xC5, 0x51, 0xC5, 0x30, 0xC5, 0x30, 0xC5, 0x10, 0xBC, 0xEF, 0xBC, 0xEF, 0xBC, 0xCE, 0xB4,
+    0x8D, 0xAC, 0x6D, 0xAC, 0x2B, 0xA3, 0xEA, 0x9B, 0xA9, 0x8B, 0x48, 0x7A, 0xE6, 0x6A, 0x65, 0x5A,
+    0x04, 0x49, 0x82, 0x39, 0x01, 0x20, 0x80, 0x18, 0x40, 0x10, 0x40, 0x19, 0xA7, 0x2A, 0x28, 0x32,
+    0xAA, 0x3B, 0x2C, 0x43, 0x8D, 0x4B, 0xCE, 0x4C, 0x0F, 0x4B, 0xEF, 0x4B, 0xCE, 0x43, 0x4D, 0x32,
+    0xAA, 0x22, 0x08, 0x19, 0x86, 0x11, 0x04, 0x09, 0x04, 0x11, 0x25, 0x11, 0x04, 0x11, 0x05, 0x11,
+    0x45, 0x08, 0xE4, 0x11, 0x24, 0x08, 0xE3, 0x08, 0xC3, 0x00, 0xC3, 0x96, 0x00, 0x00, 0x06, 0x00,
+    0xC3, 0x19, 0x45, 0x32, 0x29, 0x3A, 0x4A, 0x42, 0x8B, 0x42, 0x6A, 0x42, 0x4A, 0x86, 0x3A, 0x49,
+    0x81, 0x3A, 0x6A, 0x00, 0x3A, 0x4A, 0x82, 0x3A, 0x49, 0x81, 0x3A, 0x29, 0x81, 0x3A, 0x09, 0x82,
+    0x32, 0x08, 0x15, 0x3A, 0x29, 0x10, 0xC3, 0x00, 0x00, 0x18, 0x80, 0x31, 0x21, 0x49, 0xC3, 0x62,
+    0x44, 0x72, 0xC6, 0x83, 0x07, 0x93, 0x68, 0x9B, 0xCA, 0xA4, 0x0B, 0xAC, 0x4C, 0xAC, 0x6C, 0xB4,
+    0x8D, 0xB4, 0xAE, 0xBC, 0xCE, 0xBC, 0xEF, 0xBC, 0xEF, 0xBD, 0x10, 0xC5, 0x10, 0xC5, 0x10, 0x87,
+    0xC5, 0x30, 0x81, 0xC5, 0x10, 0x82, 0xBC, 0xEF, 0x2D, 0xBC, 0xCE, 0xB4, 0xAE, 0xB4, 0x8D, 0xAC,
+    0x6D, 0xAC, 0x4C, 0xA4, 0x0B, 0x9B, 0xCA, 0x93, 0xA9, 0x8B, 0x48, 0x83, 0x07, 0x72, 0x86, 0x62,
+    0x24, 0x51, 0xC3, 0x41, 0x42, 0x30, 0xE0, 0x20, 0x80, 0x18, 0x40, 0x10, 0x40, 0x21, 0xC7, 0x19,
+    0xA7, 0x11, 0x45, 0x11, 0x04, 0x11, 0x04, 0x11, 0x45, 0x19, 0xA6, 0x22, 0x08, 0x32, 0xAA, 0x3B,
+    0x2C, 0x43, 0x8D, 0x4B, 0xEF, 0x4B, 0xEE, 0x43, 0x8D, 0x3B, 0x0B, 0x22, 0x49, 0x19, 0x86, 0x11,
+    0x25, 0x09, 0x04, 0x08, 0xE4, 0x11, 0x25, 0x11, 0x25, 0x09, 0x04, 0x11, 0x66, 0x08, 0xE5, 0x09,
+    0x24, 0x08, 0xA2, 0x00, 0xC3, 0x90, 0x00, 0x00, 0x06, 0x00, 0x82, 0x10, 0xE4, 0x29, 0xC7, 0x3A,
+    0x8A, 0x42, 0x8A, 0x42, 0x6A, 0x3A, 0x4A, 0x82, 0x3A, 0x49, 0x81, 0x3A, 0x29, 0x02, 0x3A, 0x49,
+    0x3A, 0x6A, 0x3A, 0x4A, 0x82, 0x3A, 0x6A, 0x00, 0x3A, 0x49, 0x82, 0x3A, 0x29, 0x1C, 0x3A, 0x09,
+    0x3A, 0x29, 0x32, 0x09, 0x3A, 0x09, 0x3A, 0x29, 0x32, 0x09, 0x3A, 0x29, 0x32, 0x29, 0x3A, 0x49,
+    0x32, 0x29, 0x00, 0x41, 0x00, 0x00, 0x10, 0x60, 0x28, 0xE1, 0x49, 0x82, 0x5A, 0x04, 0x6A, 0x65,
+    0x7A, 0xC6, 0x83, 0x27, 0x93, 0x68, 0x9B, 0xA9, 0x9B, 0xEA, 0xA4, 0x0B, 0xAC, 0x2C, 0xAC, 0x4C,
+    0xB4, 0x6D, 0xB4, 0x8D, 0xB4, 0xAE, 0xB4, 0xAE, 0x89, 0xBC, 0xCE, 0x81, 0xB4, 0xAE, 0x2A, 0xB4,
+    0x8D, 0xB4, 0x6D, 0xAC, 0x4C, 0xAC, 0x2C, 0xA4, 0x0B, 0xA3, 0xEA, 0x9B, 0xCA, 0x93, 0x89, 0x8B,
+    0x48, 0x83, 0x07, 0x7A, 0xC6, 0x6A, 0x65, 0x59, 0xE3, 0x49, 0x82, 0x39, 0x21, 0x30, 0xC0, 0x20,
+    0x80, 0x18, 0x40, 0x08, 0x00, 0x19, 0xA6, 0x3B, 0x8D, 0x3B, 0x4C, 0x33, 0x0C, 0x2A, 0x8A, 0x22,
+    0x28, 0x19, 0x86, 0x11, 0x25, 0x08, 0xE4, 0x08, 0xE4, 0x11, 0x25, 0x11, 0x66, 0x19, 0xC7, 0x2A,
+    0x8A, 0x33, 0x0B, 0x43, 0x8D, 0x43, 0xAE, 0x3B, 0x4C, 0x32, 0xEB, 0x22, 0x49, 0x19, 0x86, 0x08,
+    0xE4, 0x08, 0xE4, 0x09, 0x24, 0x82, 0x09, 0x04, 0x03, 0x08, 0xE4, 0x00, 0xE4, 0x08, 0xC3, 0x00,
+    0x61, 0x8D, 0x00, 0x00, 0x03, 0x10, 0xA2, 0x2A, 0x49, 0x42, 0xAB, 0x42, 0x6A, 0x84, 0x3A, 0x49,
+    0x32, 0x3A, 0x29, 0x3A, 0x09, 0x42, 0x6A, 0x42, 0x8A, 0x3A, 0x6A, 0x3A, 0x8A, 0x3A, 0x6A, 0x3A,
+    0x4A, 0x3A, 0x29, 0x3A, 0x29, 0x32, 0x09, 0x3A, 0x09, 0x32, 0x09, 0x31, 0xE8, 0x32, 0x09, 0x32,
+    0x29, 0x32, 0x29, 0x3A, 0x29, 0x3A, 0x49, 0x32, 0x29, 0x3A, 0x49, 0x32, 0x09, 0x32, 0x08, 0x32,
+    0x09, 0x29, 0xA7, 0x00, 0x20, 0x00, 0x20, 0x08, 0x40, 0x20, 0xA0, 0x39, 0x41, 0x51, 0xC3, 0x62,
+    0x24, 0x6A, 0x65, 0x7A, 0xC6, 0x83, 0x07, 0x8B, 0x48, 0x93, 0x89, 0x9B, 0xA9, 0x9B, 0xCA, 0xA4,
+    0x0A, 0xA4, 0x0B, 0xAC, 0x2B, 0xAC, 0x2C, 0xAC, 0x4C, 0xAC, 0x6C, 0xAC, 0x6C, 0xB4, 0x6D, 0xAC,
+    0x6C, 0xAC, 0x6D, 0xAC, 0x6C, 0xAC, 0x6C, 0x82, 0xAC, 0x4C, 0x17, 0xAC, 0x2B, 0xA4, 0x0B, 0xA4,
+    0x0B, 0x9B, 0xEA, 0x9B, 0xAA, 0x93, 0x89, 0x93, 0x68, 0x8B, 0x28, 0x82, 0xE7, 0x72, 0xA6, 0x6A,
+    0x65, 0x5A, 0x04, 0x51, 0xA3, 0x41, 0x41, 0x30, 0xE1, 0x28, 0xA0, 0x18, 0x60, 0x10, 0x40, 0x08,
+    0x00, 0x08, 0x62, 0x19, 0xA6, 0x19, 0xC7, 0x2A, 0x49, 0x2A, 0xAA, 0x82, 0x33, 0x0B, 0x11, 0x2A,
+    0x8A, 0x22, 0x28, 0x19, 0xA6, 0x11, 0x04, 0x08, 0xE4, 0x09, 0x04, 0x09, 0x04, 0x11, 0x25, 0x19,
+    0xA6, 0x2A, 0x69, 0x3B, 0x2C, 0x43, 0x8D, 0x43, 0x8D, 0x3B, 0x2C, 0x32, 0xCB, 0x19, 0xA6, 0x00,
+    0xC3, 0x08, 0xE4, 0x83, 0x09, 0x04, 0x81, 0x01, 0x04, 0x01, 0x09, 0x04, 0x00, 0x41, 0x89, 0x00,
+    0x00, 0x06, 0x08, 0x61, 0x31, 0xC7, 0x3A, 0x6A, 0x42, 0x49, 0x3A, 0x29, 0x3A, 0x49, 0x3A, 0x49,
+    0x82, 0x3A, 0x29, 0x2D, 0x3A, 0x09, 0x3A, 0x29, 0x4B, 0x0C, 0x42, 0xCB, 0x42, 0xAB, 0x43, 0x0C,
+    0x3A, 0x8A, 0x3A, 0x29, 0x32, 0x09, 0x32, 0x09, 0x3A, 0x09, 0x32, 0x09, 0x32, 0x08, 0x31, 0xE8,
+    0x3A, 0x6A, 0x3A, 0x49, 0x3A, 0x49, 0x3A, 0x8A, 0x3A, 0x6A, 0x32, 0x29, 0x31, 0xE8, 0x31, 0xE8,
+    0x31, 0xC8, 0x31, 0xE8, 0x29, 0xC7, 0x32, 0x08, 0x21, 0x45, 0x00, 0x00, 0x00, 0x00, 0x08, 0x20,
+    0x18, 0x80, 0x28, 0xE0, 0x41, 0x41, 0x51, 0xC3, 0x5A, 0x04, 0x6A, 0x65, 0x72, 0xA6, 0x7A, 0xE6,
+    0x83, 0x07, 0x8B, 0x48, 0x93, 0x68, 0x93, 0x89, 0x9B, 0xA9, 0x9B, 0xCA, 0x9B, 0xCA, 0x9B, 0xEA,
+    0x85, 0xA3, 0xEA, 0x82, 0x9B, 0xCA, 0x2C, 0x9B, 0xA9, 0x93, 0x89, 0x93, 0x68, 0x8B, 0x48, 0x83,
+    0x28, 0x83, 0x07, 0x7A, 0xC6, 0x72, 0x85, 0x62, 0x45, 0x5A, 0x04, 0x51, 0xA3, 0x41, 0x42, 0x31,
+    0x01, 0x28, 0xA0, 0x20, 0x80, 0x18, 0x40, 0x10, 0x20, 0x08, 0x00, 0x00, 0x61, 0x11, 0x45, 0x11,
+    0x25, 0x11, 0x25, 0x19, 0x45, 0x11, 0x45, 0x19, 0x66, 0x19, 0xC7, 0x2A, 0x89, 0x32, 0xEB, 0x32,
+    0xEB, 0x32, 0xCA, 0x2A, 0xAA, 0x19, 0xC7, 0x09, 0x04, 0x11, 0x25, 0x11, 0x24, 0x08, 0xE4, 0x09,
+    0x04, 0x11, 0x66, 0x22, 0x49, 0x3B, 0x4C, 0x43, 0x8D, 0x3B, 0x6D, 0x43, 0x8D, 0x2A, 0xAA, 0x09,
+    0x04, 0x82, 0x08, 0xE4, 0x06, 0x01, 0x04, 0x09, 0x45, 0x01, 0x24, 0x00, 0xE4, 0x08, 0xE3, 0x00,
+    0xE3, 0x00, 0x62, 0x86, 0x00, 0x00, 0x04, 0x08, 0x61, 0x3A, 0x29, 0x42, 0x6A, 0x3A, 0x29, 0x3A,
+    0x49, 0x84, 0x3A, 0x29, 0x06, 0x32, 0x08, 0x3A, 0x6A, 0x64, 0x30, 0x42, 0xEB, 0x4B, 0x4D, 0x53,
+    0xCE, 0x3A, 0x4A, 0x84, 0x32, 0x08, 0x08, 0x31, 0xC8, 0x32, 0x29, 0x4B, 0x4D, 0x3A, 0x8A, 0x42,
+    0xAB, 0x43, 0x0C, 0x3A, 0x49, 0x31, 0xE8, 0x31, 0xE8, 0x82, 0x29, 0xC8, 0x04, 0x31, 0xE8, 0x29,
+    0xC7, 0x29, 0xC7, 0x31, 0xE8, 0x19, 0x25, 0x82, 0x00, 0x00, 0x0C, 0x10, 0x40, 0x18, 0x80, 0x30,
+    0xE0, 0x41, 0x41, 0x49, 0xA2, 0x51, 0xE3, 0x62, 0x24, 0x6A, 0x65, 0x72, 0x85, 0x7A, 0xC6, 0x7A,
+    0xE7, 0x83, 0x07, 0x83, 0x27, 0x82, 0x8B, 0x48, 0x83, 0x8B, 0x68, 0x81, 0x8B, 0x48, 0x17, 0x8B,
+    0x28, 0x83, 0x27, 0x83, 0x07, 0x7A, 0xE7, 0x7A, 0xC6, 0x72, 0xA6, 0x6A, 0x65, 0x62, 0x45, 0x62,
+    0x04, 0x59, 0xE3, 0x49, 0x82, 0x41, 0x41, 0x31, 0x01, 0x28, 0xC0, 0x20, 0x60, 0x18, 0x40, 0x10,
+    0x40, 0x08, 0x20, 0x00, 0x00, 0x00, 0x61, 0x11, 0x25, 0x11, 0x45, 0x11, 0x25, 0x11, 0x45, 0x82,
+    0x11, 0x25, 0x08, 0x11, 0x04, 0x11, 0x25, 0x19, 0xA6, 0x2A, 0xAA, 0x33, 0x0B, 0x2A, 0xAA, 0x3B,
+    0x2C, 0x2A, 0x89, 0x11, 0x04, 0x84, 0x09, 0x04, 0x0F, 0x11, 0x86, 0x32, 0xEB, 0x43, 0xAE, 0x32,
+    0xEB, 0x43, 0xCE, 0x3B, 0x2C, 0x08, 0xE4, 0x08, 0xE4, 0x09, 0x04, 0x11, 0x45, 0x09, 0x24, 0x00,
+    0xE3, 0x08, 0xE4, 0x09, 0x04, 0x08, 0xE4, 0x00, 0xA3, 0x85, 0x00, 0x00, 0x04, 0x00, 0x41, 0x32,
+    0x29, 0x3A, 0x49, 0x3A, 0x29, 0x3A, 0x49, 0x82, 0x3A, 0x29, 0x30, 0x3A, 0x09, 0x3A, 0x29, 0x32,
+    0x09, 0x3A, 0x6A, 0x74, 0xF2, 0x4B, 0x2D, 0x53, 0x4D, 0x6C, 0x91, 0x32, 0x29, 0x31, 0xE8, 0x32,
+    0x08, 0x32, 0x08, 0x31, 0xE8, 0x32, 0x08, 0x31, 0xE8, 0x32, 0x29, 0x64, 0x51, 0x3A, 0x8A, 0x4B,
+    0x0C, 0x5B, 0xEF, 0x31, 0xE8, 0x31, 0xC8, 0x31, 0xE8, 0x29, 0xC8, 0x29, 0xC8, 0x31, 0xE8, 0x31,
+    0xC8, 0x29, 0xC8, 0x29, 0xC8, 0x29, 0xC7, 0x29, 0xA7, 0x29, 0xE8, 0x19, 0x25, 0x00, 0x20, 0x00,
+    0x00, 0x00, 0x00, 0x08, 0x00, 0x10, 0x40, 0x20, 0x80, 0x28, 0xE0, 0x39, 0x21, 0x41, 0x61, 0x49,
+    0xA2, 0x51, 0xE3, 0x5A, 0x04, 0x62, 0x44, 0x6A, 0x45, 0x6A, 0x65, 0x72, 0x85, 0x82, 0x72, 0xA6,
+    0x82, 0x7A, 0xC6, 0x82, 0x72, 0xA6, 0x13, 0x6A, 0x85, 0x6A, 0x65, 0x62, 0x44, 0x62, 0x24, 0x5A,
+    0x04, 0x51, 0xC3, 0x51, 0xA2, 0x49, 0x62, 0x39, 0x21, 0x30, 0xE1, 0x28, 0xA0, 0x20, 0x80, 0x18,
+    0x40, 0x10, 0x20, 0x08, 0x20, 0x08, 0x20, 0x00, 0x00, 0x00, 0x61, 0x11, 0x25, 0x11, 0x45, 0x87,
+    0x11, 0x25, 0x07, 0x11, 0x04, 0x11, 0x24, 0x22, 0x49, 0x33, 0x0B, 0x19, 0xA6, 0x3B, 0x2C, 0x2A,
+    0x69, 0x08, 0xE4, 0x82, 0x09, 0x04, 0x09, 0x09, 0x24, 0x11, 0x45, 0x01, 0x04, 0x32, 0xEB, 0x3B,
+    0x6D, 0x1A, 0x08, 0x4B, 0xCE, 0x2A, 0x8A, 0x00, 0xC3, 0x09, 0x04, 0x82, 0x00, 0xE3, 0x04, 0x01,
+    0x03, 0x09, 0x24, 0x00, 0xC3, 0x09, 0x04, 0x00, 0xA2, 0x84, 0x00, 0x00, 0x12, 0x21, 0x05, 0x3A,
+    0x6A, 0x32, 0x09, 0x32, 0x09, 0x3A, 0x09, 0x3A, 0x29, 0x32, 0x09, 0x32, 0x08, 0x32, 0x08, 0x32,
+    0x09, 0x29, 0xC7, 0x63, 0xEF, 0x85, 0x13, 0x31, 0xE9, 0x8D, 0x95, 0x4B, 0x0C, 0x29, 0xA7, 0x32,
+    0x08, 0x31, 0xE8, 0x82, 0x32, 0x08, 0x08, 0x29, 0x87, 0x64, 0x30, 0x63, 0xCF, 0x31, 0xE8, 0x7D,
+    0x13, 0x31, 0xE8, 0x29, 0xA7, 0x29, 0xC8, 0x29, 0xC8, 0x82, 0x29, 0xC7, 0x00, 0x31, 0xC8, 0x82,
+    0x29, 0xC7, 0x03, 0x29, 0xA7, 0x29, 0xE8, 0x29, 0x87, 0x00, 0x21, 0x83, 0x00, 0x00, 0x0C, 0x08,
+    0x20, 0x10, 0x40, 0x18, 0x60, 0x20, 0xA0, 0x28, 0xE0, 0x31, 0x21, 0x41, 0x41, 0x41, 0x62, 0x49,
+    0x82, 0x51, 0xA2, 0x51, 0xC3, 0x59, 0xE3, 0x5A, 0x03, 0x85, 0x5A, 0x04, 0x0E, 0x59, 0xE3, 0x51,
+    0xE3, 0x51, 0xC3, 0x49, 0x82, 0x49, 0x62, 0x41, 0x41, 0x39, 0x21, 0x30, 0xE1, 0x28, 0xC0, 0x20,
+    0x80, 0x18, 0x60, 0x10, 0x40, 0x10, 0x20, 0x08, 0x20, 0x08, 0x00, 0x82, 0x00, 0x00, 0x01, 0x08,
+    0xA3, 0x11, 0x45, 0x86, 0x11, 0x25, 0x1F, 0x11, 0x24, 0x11, 0x25, 0x11, 0x45, 0x11, 0x04, 0x08,
+    0xE4, 0x2A, 0x69, 0x32, 0xCB, 0x19, 0x86, 0x3B, 0x2C, 0x11, 0x25, 0x08, 0xE4, 0x09, 0x04, 0x08,
+    0xE4, 0x08, 0xE4, 0x09, 0x04, 0x08, 0xE4, 0x08, 0xC3, 0x43, 0x8D, 0x32, 0xAA, 0x22, 0x28, 0x4B,
+    0xCE, 0x08, 0xE4, 0x08, 0xE4, 0x00, 0xE3, 0x08, 0xE4, 0x00, 0xE3, 0x09, 0x04, 0x00, 0xE3, 0x00,
+    0xC3, 0x00, 0xE3, 0x01, 0x04, 0x00, 0x41, 0x82, 0x00, 0x00, 0x06, 0x01, 0x40, 0x32, 0xE8, 0x39,
+    0xE9, 0x32, 0x09, 0x32, 0x09, 0x3A, 0x09, 0x3A, 0x09, 0x82, 0x32, 0x08, 0x08, 0x3A, 0x29, 0x29,
+    0xA7, 0x74, 0x92, 0x84, 0xF3, 0x29, 0xC8, 0x9E, 0x17, 0x42, 0xCB, 0x29, 0xC7, 0x32, 0x08, 0x82,
+    0x31, 0xE8, 0x0B, 0x32, 0x08, 0x21, 0x46, 0x7C, 0xD2, 0x63, 0xAF, 0x32, 0x29, 0x8D, 0x75, 0x29,
+    0xA7, 0x29, 0xC7, 0x29, 0xC8, 0x29, 0xC7, 0x29, 0xC7, 0x29, 0xA7, 0x83, 0x29, 0xC7, 0x03, 0x29,
+    0xA7, 0x29, 0xC8, 0x29, 0xA7, 0x00, 0x20, 0x87, 0x00, 0x00, 0x09, 0x08, 0x20, 0x10, 0x40, 0x18,
+    0x60, 0x20, 0x80, 0x20, 0xA0, 0x28, 0xE0, 0x31, 0x00, 0x39, 0x01, 0x39, 0x21, 0x39, 0x21, 0x85,
+    0x41, 0x41, 0x81, 0x39, 0x21, 0x08, 0x31, 0x01, 0x30, 0xE0, 0x28, 0xC0, 0x20, 0xA0, 0x18, 0x80,
+    0x18, 0x60, 0x10, 0x40, 0x08, 0x20, 0x08, 0x20, 0x87, 0x00, 0x00, 0x04, 0x08, 0x82, 0x11, 0x45,
+    0x11, 0x25, 0x11, 0x25, 0x11, 0x45, 0x82, 0x11, 0x25, 0x0B, 0x11, 0x24, 0x11, 0x04, 0x11, 0x04,
+    0x11, 0x45, 0x00, 0x83, 0x2A, 0x69, 0x3B, 0x0C, 0x00, 0x83, 0x4B, 0xEF, 0x11, 0x66, 0x08, 0xE3,
+    0x09, 0x04, 0x82, 0x08, 0xE4, 0x0B, 0x09, 0x24, 0x00, 0x42, 0x4B, 0xAE, 0x32, 0xAA, 0x11, 0x66,
+    0x64, 0x91, 0x10, 0xE4, 0x00, 0xC3, 0x00, 0xE4, 0x08, 0xE4, 0x09, 0x04, 0x19, 0x65, 0x82, 0x00,
+    0xE3, 0x01, 0x01, 0x04, 0x00, 0x61, 0x82, 0x00, 0x00, 0x05, 0x19, 0x84, 0x53, 0x4C, 0x31, 0xC8,
+    0x32, 0x09, 0x32, 0x08, 0x32, 0x08, 0x83, 0x31, 0xE8, 0x15, 0x32, 0x08, 0x29, 0xA7, 0x53, 0x6D,
+    0xA6, 0x58, 0x42, 0xEB, 0x85, 0x34, 0x7C, 0xF3, 0x29, 0xA7, 0x31, 0xC8, 0x31, 0xE8, 0x29, 0xC7,
+    0x31, 0xC8, 0x31, 0xE8, 0x29, 0x87, 0x53, 0x2D, 0x95, 0xD6, 0x32, 0x29, 0x74, 0xD2, 0x6C, 0x71,
+    0x21, 0x86, 0x21, 0x86, 0x29, 0xC7, 0x86, 0x29, 0xA7, 0x01, 0x21, 0x86, 0x00, 0x20, 0x8B, 0x00,
+    0x00, 0x81, 0x08, 0x20, 0x81, 0x10, 0x40, 0x81, 0x18, 0x60, 0x81, 0x20, 0x80, 0x83, 0x20, 0xA0,
+    0x04, 0x20, 0x80, 0x18, 0x80, 0x18, 0x60, 0x18, 0x60, 0x10, 0x40, 0x82, 0x08, 0x20, 0x8C, 0x00,
+    0x00, 0x26, 0x08, 0xA2, 0x11, 0x45, 0x11, 0x25, 0x11, 0x24, 0x11, 0x25, 0x11, 0x25, 0x11, 0x04,
+    0x11, 0x25, 0x11, 0x25, 0x09, 0x04, 0x00, 0xA3, 0x19, 0x87, 0x54, 0x30, 0x11, 0x66, 0x3B, 0x0B,
+    0x53, 0xEF, 0x01, 0x04, 0x01, 0x04, 0x08, 0xE4, 0x08, 0xE4, 0x09, 0x04, 0x09, 0x24, 0x00, 0xA3,
+    0x19, 0xC7, 0x6C, 0xF3, 0x19, 0xE7, 0x4B, 0x8D, 0x5C, 0x71, 0x00, 0xA3, 0x08, 0xE4, 0x00, 0xE4,
+    0x00, 0xC3, 0x00, 0xE3, 0x00, 0xC3, 0x00, 0xE4, 0x00, 0xE3, 0x00, 0xE3, 0x00, 0xE4, 0x00, 0x41,
+    0x83, 0x00, 0x00, 0x05, 0x73, 0xAF, 0x29, 0xE8, 0x29, 0xC8, 0x31, 0xE8, 0x31, 0xE8, 0x31, 0xC8,
+    0x84, 0x31, 0xE8, 0x12, 0x29, 0xE8, 0x85, 0x33, 0x8D, 0x95, 0x5B, 0xEF, 0x95, 0xD6, 0x6C, 0x50,
+    0x29, 0xE8, 0x29, 0xA7, 0x29, 0xC7, 0x29, 0xC8, 0x29, 0xC7, 0x29, 0xC8, 0x29, 0xA7, 0x5B, 0xEF,
+    0x7D, 0x54, 0x53, 0x8E, 0x74, 0xB2, 0x64, 0x50, 0x32, 0x29, 0x82, 0x21, 0x87, 0x83, 0x29, 0xA7,
+    0x01, 0x21, 0x87, 0x08, 0x61, 0x91, 0x00, 0x00, 0x81, 0x08, 0x00, 0x86, 0x08, 0x20, 0x00, 0x08,
+    0x00, 0x92, 0x00, 0x00, 0x0F, 0x08, 0xC3, 0x11, 0x25, 0x11, 0x04, 0x11, 0x25, 0x11, 0x25, 0x11,
+    0x04, 0x08, 0xE4, 0x00, 0xA3, 0x11, 0x05, 0x32, 0xAA, 0x54, 0x30, 0x3B, 0x2C, 0x4B, 0xCE, 0x5C,
+    0x50, 0x11, 0x45, 0x08, 0xE4, 0x82, 0x09, 0x04, 0x12, 0x08, 0xC3, 0x00, 0x82, 0x19, 0xC7, 0x6C,
+    0xD2, 0x4B, 0xAE, 0x43, 0x6D, 0x7D, 0x54, 0x21, 0xE7, 0x00, 0xC3, 0x08, 0xE4, 0x00, 0xC3, 0x00,
+    0xE4, 0x00, 0xE3, 0x00, 0xE4, 0x00, 0xE3, 0x00, 0xC3, 0x00, 0xC3, 0x08, 0xE3, 0x00, 0x41, 0x83,
+    0x00, 0x00, 0x12, 0x4A, 0x6A, 0x9D, 0x15, 0x21, 0x66, 0x29, 0xC7, 0x32, 0x08, 0x29, 0xC8, 0x31,
+    0xE8, 0x31, 0xC8, 0x29, 0xC7, 0x29, 0xC7, 0x29, 0xE8, 0x29, 0xA7, 0x32, 0x29, 0x74, 0xD2, 0x85,
+    0x54, 0x6C, 0x91, 0x7D, 0x34, 0x6C, 0x91, 0x3A, 0x8A, 0x84, 0x29, 0xA7, 0x0D, 0x21, 0x66, 0x3A,
+    0xCB, 0x5C, 0x10, 0x53, 0xCE, 0x5C, 0x0F, 0x53, 0xEF, 0x43, 0x0C, 0x32, 0x08, 0x21, 0x87, 0x21,
+    0x66, 0x21, 0x86, 0x21, 0x87, 0x21, 0x87, 0x08, 0xA2, 0xB0, 0x00, 0x00, 0x1C, 0x08, 0xC3, 0x09,
+    0x04, 0x08, 0xA3, 0x00, 0xC3, 0x08, 0xE4, 0x19, 0x86, 0x32, 0xAA, 0x54, 0x0F, 0x5C, 0x71, 0x54,
+    0x30, 0x5C, 0x50, 0x43, 0x4C, 0x08, 0xE4, 0x08, 0xC3, 0x09, 0x04, 0x08, 0xE4, 0x08, 0xC3, 0x00,
+    0x83, 0x11, 0x25, 0x43, 0x4C, 0x74, 0xF3, 0x5C, 0x30, 0x64, 0x91, 0x75, 0x13, 0x22, 0x28, 0x00,
+    0x83, 0x08, 0xE4, 0x00, 0xE3, 0x00, 0xE3, 0x84, 0x00, 0xC3, 0x02, 0x00, 0xA3, 0x00, 0xC3, 0x00,
+    0x40, 0x83, 0x00, 0x00, 0x05, 0x10, 0x82, 0x83, 0xF0, 0x94, 0xB4, 0x3A, 0x29, 0x21, 0xA7, 0x31,
+    0xE8, 0x85, 0x29, 0xC7, 0x81, 0x29, 0xA7, 0x16, 0x4B, 0x4D, 0x64, 0x71, 0x5C, 0x30, 0x64, 0x71,
+    0x5C, 0x50, 0x4B, 0x6D, 0x32, 0x49, 0x29, 0xA7, 0x21, 0x86, 0x29, 0xA7, 0x29, 0xA7, 0x21, 0x66,
+    0x21, 0xA7, 0x32, 0x49, 0x3A, 0xCB, 0x43, 0x0C, 0x4B, 0x6D, 0x43, 0x4C, 0x3A, 0xEB, 0x32, 0x49,
+    0x29, 0xC7, 0x29, 0xA7, 0x10, 0xC3, 0xB1, 0x00, 0x00, 0x19, 0x00, 0x61, 0x11, 0x45, 0x22, 0x08,
+    0x32, 0xAA, 0x4B, 0xAE, 0x5C, 0x50, 0x5C, 0xB1, 0x5C, 0x50, 0x4B, 0xCE, 0x3B, 0x0B, 0x11, 0x86,
+    0x00, 0xA3, 0x08, 0xC3, 0x00, 0xA3, 0x00, 0x82, 0x00, 0xA3, 0x11, 0x86, 0x43, 0x2C, 0x64, 0xB1,
+    0x75, 0x13, 0x6C, 0xD2, 0x6C, 0xF2, 0x54, 0x0F, 0x09, 0x45, 0x00, 0x82, 0x08, 0xE4, 0x82, 0x00,
+    0xE3, 0x82, 0x00, 0xC3, 0x03, 0x00, 0xE3, 0x00, 0xA3, 0x02, 0x89, 0x01, 0xA6, 0x86, 0x00, 0x00,
+    0x07, 0x42, 0x28, 0x8C, 0xB4, 0x52, 0xEC, 0x29, 0x87, 0x31, 0xE8, 0x29, 0xC7, 0x29, 0xA7, 0x29,
+    0xC7, 0x83, 0x29, 0xA7, 0x1A, 0x21, 0x86, 0x29, 0xE8, 0x42, 0xCB, 0x43, 0x4D, 0x4B, 0x8D, 0x4B,
+    0xAE, 0x4B, 0x8E, 0x3A, 0xEB, 0x32, 0x69, 0x29, 0xA7, 0x21, 0x87, 0x21, 0x86, 0x21, 0x46, 0x29,
+    0xC7, 0x3A, 0x49, 0x21, 0x86, 0x2A, 0x08, 0x32, 0x49, 0x3A, 0xAA, 0x3A, 0xEB, 0x3A, 0xEB, 0x32,
+    0xAA, 0x19, 0xC6, 0x11, 0x45, 0x08, 0xE3, 0x00, 0x41, 0x00, 0x41, 0x8E, 0x00, 0x00, 0x8A, 0x08,
+    0x20, 0x84, 0x00, 0x20, 0x87, 0x00, 0x00, 0x1F, 0x00, 0x20, 0x00, 0x61, 0x08, 0x61, 0x11, 0x24,
+    0x21, 0xE7, 0x32, 0x69, 0x43, 0x2C, 0x4B, 0xEE, 0x5C, 0x71, 0x64, 0xD2, 0x64, 0xD2, 0x5C, 0x91,
+    0x4B, 0xCE, 0x32, 0xEB, 0x19, 0xE7, 0x08, 0xE4, 0x00, 0x41, 0x00, 0x82, 0x00, 0xA3, 0x08, 0xC4,
+    0x11, 0x86, 0x32, 0x8A, 0x4B, 0xCE, 0x64, 0xB2, 0x75, 0x33, 0x6C, 0xF2, 0x64, 0xB1, 0x4B, 0xAE,
+    0x19, 0xC7, 0x00, 0xA3, 0x00, 0xA3, 0x08, 0xE4, 0x86, 0x00, 0xC3, 0x02, 0x00, 0xA2, 0x00, 0xC2,
+    0x01, 0x03, 0x88, 0x00, 0x00, 0x06, 0x11, 0x04, 0x29, 0x66, 0x00, 0x21, 0x19, 0x45, 0x29, 0xA7,
+    0x31, 0xE8, 0x29, 0xC7, 0x84, 0x29, 0xA7, 0x1F, 0x31, 0xE8, 0x29, 0xA7, 0x21, 0x87, 0x32, 0x08,
+    0x32, 0x69, 0x3A, 0xCB, 0x3B, 0x0C, 0x43, 0x0C, 0x3B, 0x0C, 0x3A, 0xAB, 0x32, 0x29, 0x29, 0xC7,
+    0x29, 0xA7, 0x21, 0x86, 0x21, 0x46, 0x21, 0x46, 0x19, 0x45, 0x21, 0x66, 0x21, 0x86, 0x21, 0xA7,
+    0x19, 0x86, 0x19, 0xC6, 0x1A, 0x07, 0x1A, 0x28, 0x1A, 0x28, 0x1A, 0x07, 0x19, 0xC6, 0x11, 0x65,
+    0x11, 0x24, 0x08, 0xE3, 0x08, 0xA2, 0x00, 0x61, 0x82, 0x00, 0x20, 0x02, 0x08, 0x00, 0x08, 0x20,
+    0x08, 0x20, 0x84, 0x10, 0x40, 0x04, 0x10, 0x60, 0x18, 0x60, 0x18, 0x40, 0x18, 0x40, 0x10, 0x40,
+    0x82, 0x10, 0x20, 0x2B, 0x08, 0x20, 0x08, 0x40, 0x08, 0x40, 0x08, 0x41, 0x08, 0x41, 0x00, 0x41,
+    0x08, 0x41, 0x10, 0xA2, 0x11, 0x03, 0x19, 0x45, 0x21, 0xA6, 0x2A, 0x07, 0x32, 0x48, 0x3A, 0xEB,
+    0x4B, 0xAE, 0x5C, 0x50, 0x6C, 0xD2, 0x75, 0x13, 0x7D, 0x54, 0x75, 0x54, 0x75, 0x33, 0x64, 0xB1,
+    0x53, 0xEE, 0x3B, 0x2C, 0x2A, 0x48, 0x11, 0x25, 0x00, 0xA3, 0x00, 0x41, 0x00, 0x62, 0x09, 0x25,
+    0x21, 0xC7, 0x32, 0x8A, 0x43, 0x6D, 0x54, 0x2F, 0x6C, 0xD2, 0x75, 0x33, 0x6C, 0xF3, 0x64, 0xB1,
+    0x4B, 0xCE, 0x2A, 0xAA, 0x11, 0x66, 0x00, 0x82, 0x00, 0x82, 0x08, 0xE4, 0x87, 0x00, 0xC3, 0x01,
+    0x00, 0xA2, 0x00, 0x81, 0x8E, 0x00, 0x00, 0x1B, 0x00, 0x20, 0x10, 0xC3, 0x21, 0x46, 0x29, 0xA7,
+    0x29, 0xC7, 0x29, 0xA7, 0x21, 0x87, 0x29, 0xA7, 0x29, 0xC7, 0x29, 0xA7, 0x21, 0x87, 0x21, 0x86,
+    0x21, 0x66, 0x21, 0x66, 0x29, 0xA7, 0x29, 0xE8, 0x32, 0x49, 0x32, 0x8A, 0x3A, 0xCB, 0x3A, 0xCB,
+    0x32, 0xAA, 0x2A, 0x49, 0x2A, 0x28, 0x21, 0xC7, 0x21, 0xA7, 0x21, 0x66, 0x21, 0x66, 0x10, 0xC4,
+    0x82, 0x00, 0x00, 0x0E, 0x00, 0x61, 0x08, 0xA2, 0x08, 0xE3, 0x11, 0x24, 0x11, 0x85, 0x19, 0xA6,
+    0x11, 0x85, 0x19, 0x85, 0x19, 0x85, 0x19, 0x44, 0x19, 0x23, 0x21, 0x23, 0x21, 0x02, 0x20, 0xE2,
+    0x20, 0xE1, 0x83, 0x28, 0xE1, 0x34, 0x29, 0x01, 0x29, 0x02, 0x31, 0x22, 0x31, 0x63, 0x31, 0xA4,
+    0x31, 0xE6, 0x3A, 0x27, 0x3A, 0x68, 0x42, 0xAA, 0x42, 0xEA, 0x4B, 0x2B, 0x4B, 0x6C, 0x53, 0xAD,
+    0x53, 0xCE, 0x54, 0x0F, 0x5C, 0x30, 0x64, 0x91, 0x6C, 0xB2, 0x6C, 0xF2, 0x75, 0x33, 0x75, 0x54,
+    0x7D, 0x74, 0x7D, 0x54, 0x75, 0x13, 0x6C, 0xB2, 0x5C, 0x2F, 0x53, 0xAD, 0x3B, 0x0B, 0x2A, 0x28,
+    0x19, 0x65, 0x11, 0x24, 0x08, 0x82, 0x00, 0x82, 0x11, 0x45, 0x21, 0xA7, 0x32, 0xCA, 0x4B, 0xAE,
+    0x5C, 0x30, 0x6C, 0xB2, 0x75, 0x33, 0x7D, 0x54, 0x7D, 0x54, 0x75, 0x13, 0x5C, 0x71, 0x43, 0x8D,
+    0x2A, 0x8A, 0x11, 0x86, 0x00, 0xC3, 0x00, 0x62, 0x00, 0x82, 0x00, 0xC3, 0x00, 0xC3, 0x00, 0xA3,
+    0x83, 0x00, 0xC3, 0x04, 0x00, 0xA3, 0x00, 0xA2, 0x00, 0x21, 0x00, 0x00, 0x00, 0x81, 0x92, 0x00,
+    0x00, 0x06, 0x08, 0x41, 0x10, 0xC3, 0x19, 0x25, 0x21, 0x86, 0x29, 0xA7, 0x29, 0xA7, 0x21, 0xA7,
+    0x83, 0x21, 0x86, 0x83, 0x21, 0x66, 0x18, 0x21, 0x86, 0x29, 0xC7, 0x22, 0x08, 0x2A, 0x69, 0x2A,
+    0x69, 0x32, 0x8A, 0x32, 0x8A, 0x2A, 0x69, 0x2A, 0x49, 0x19, 0xA6, 0x11, 0x44, 0x08, 0xE3, 0x08,
+    0xA2, 0x00, 0x61, 0x00, 0x40, 0x00, 0x00, 0x00, 0x00, 0x08, 0x20, 0x08, 0x20, 0x10, 0x40, 0x18,
+    0x80, 0x20, 0xA1, 0x20, 0xE1, 0x29, 0x01, 0x29, 0x01, 0x82, 0x31, 0x22, 0x82, 0x39, 0x42, 0x17,
+    0x39, 0x62, 0x39, 0x63, 0x41, 0x83, 0x41, 0xC4, 0x4A, 0x26, 0x4A, 0x88, 0x52, 0xEA, 0x53, 0x4B,
+    0x5B, 0x8C, 0x5B, 0xCD, 0x5B, 0xEE, 0x64, 0x0F, 0x64, 0x0F, 0x64, 0x0E, 0x63, 0xEE, 0x5B, 0xEE,
+    0x5B, 0xCD, 0x53, 0x8D, 0x4B, 0x4C, 0x43, 0x0B, 0x3A, 0xA9, 0x32, 0x07, 0x29, 0xC6, 0x19, 0x85,
+    0x82, 0x19, 0x44, 0x14, 0x19, 0x65, 0x21, 0xA6, 0x2A, 0x07, 0x3A, 0xCA, 0x53, 0x8D, 0x64, 0x50,
+    0x74, 0xD2, 0x85, 0x74, 0x8D, 0xB6, 0x8D, 0xD6, 0x8D, 0xB6, 0x85, 0xB5, 0x7D, 0x54, 0x64, 0xB2,
+    0x53, 0xEE, 0x3B, 0x2C, 0x22, 0x08, 0x11, 0x25, 0x00, 0xA2, 0x00, 0x62, 0x00, 0x82, 0x82, 0x00,
+    0xC3, 0x08, 0x00, 0xA3, 0x00, 0xC3, 0x00, 0xC3, 0x00, 0xA2, 0x00, 0xA3, 0x00, 0x82, 0x00, 0x82,
+    0x00, 0x41, 0x00, 0x61, 0x98, 0x00, 0x00, 0x2C, 0x00, 0x20, 0x08, 0x82, 0x10, 0xE3, 0x19, 0x25,
+    0x21, 0x66, 0x21, 0x86, 0x21, 0x86, 0x21, 0x87, 0x21, 0x86, 0x21, 0x86, 0x21, 0x66, 0x19, 0x46,
+    0x29, 0xA7, 0x21, 0x66, 0x19, 0x45, 0x19, 0x45, 0x19, 0x66, 0x19, 0x86, 0x19, 0xA7, 0x21, 0xE7,
+    0x19, 0xA7, 0x11, 0x85, 0x11, 0xA6, 0x11, 0xA6, 0x11, 0x85, 0x11, 0x65, 0x11, 0x44, 0x11, 0x24,
+    0x11, 0x03, 0x19, 0x02, 0x20, 0xE2, 0x21, 0x02, 0x29, 0x01, 0x31, 0x21, 0x39, 0x21, 0x39, 0x42,
+    0x41, 0x62, 0x41, 0x62, 0x41, 0x82, 0x49, 0x82, 0x49, 0xA3, 0x49, 0xC3, 0x49, 0xC3, 0x51, 0xC3,
+    0x51, 0xE3, 0x83, 0x51, 0xE4, 0x07, 0x49, 0xE5, 0x4A, 0x05, 0x52, 0x26, 0x52, 0x46, 0x52, 0x46,
+    0x4A, 0x46, 0x4A, 0x26, 0x4A, 0x25, 0x82, 0x4A, 0x26, 0x1C, 0x4A, 0x46, 0x42, 0x68, 0x42, 0xCA,
+    0x4B, 0x0B, 0x53, 0x4C, 0x53, 0x8D, 0x5B, 0xCE, 0x64, 0x2F, 0x74, 0xB1, 0x7D, 0x33, 0x8D, 0x95,
+    0x8D, 0xD6, 0x95, 0xF7, 0x96, 0x17, 0x96, 0x17, 0x8D, 0xD6, 0x85, 0x95, 0x75, 0x13, 0x6C, 0x91,
+    0x5C, 0x0F, 0x4B, 0x6D, 0x32, 0x89, 0x21, 0xC6, 0x09, 0x04, 0x00, 0x82, 0x00, 0x62, 0x00, 0x62,
+    0x00, 0x82, 0x00, 0xA3, 0x82, 0x00, 0xC3, 0x07, 0x00, 0xA3, 0x00, 0xC3, 0x00, 0xA3, 0x00, 0x82,
+    0x00, 0x61, 0x00, 0xA2, 0x00, 0x41, 0x00, 0x81, 0x9F, 0x00, 0x00, 0x0A, 0x00, 0x20, 0x08, 0x61,
+    0x10, 0xC3, 0x10, 0xE4, 0x19, 0x45, 0x19, 0x66, 0x21, 0x86, 0x21, 0xA7, 0x29, 0xC8, 0x21, 0x87,
+    0x19, 0x46, 0x84, 0x19, 0x45, 0x29, 0x08, 0x82, 0x00, 0x41, 0x00, 0x40, 0x00, 0x61, 0x00, 0x81,
+    0x08, 0xA2, 0x18, 0xE2, 0x19, 0x02, 0x21, 0x22, 0x29, 0x43, 0x39, 0x63, 0x39, 0x63, 0x41, 0x83,
+    0x49, 0xA3, 0x49, 0xC3, 0x51, 0xC3, 0x51, 0xE3, 0x51, 0xE4, 0x5A, 0x04, 0x5A, 0x04, 0x5A, 0x24,
+    0x5A, 0x24, 0x62, 0x45, 0x62, 0x45, 0x62, 0x66, 0x62, 0xA7, 0x6A, 0xC8, 0x6B, 0x09, 0x6B, 0x4B,
+    0x6B, 0x8C, 0x73, 0xED, 0x74, 0x2E, 0x74, 0x4F, 0x7C, 0x90, 0x7C, 0xB1, 0x7C, 0xF2, 0x85, 0x13,
+    0x85, 0x34, 0x85, 0x54, 0x8D, 0x75, 0x8D, 0x95, 0x8D, 0xB5, 0x83, 0x8D, 0xB6, 0x13, 0x85, 0x95,
+    0x85, 0x75, 0x85, 0x54, 0x7D, 0x13, 0x74, 0xB1, 0x64, 0x50, 0x5B, 0xCE, 0x4B, 0x2C, 0x3A, 0xAA,
+    0x32, 0x48, 0x21, 0xC6, 0x19, 0x03, 0x08, 0xA2, 0x00, 0x82, 0x00, 0x62, 0x00, 0x41, 0x08, 0xA3,
+    0x21, 0x86, 0x00, 0xC3, 0x00, 0xE4, 0x82, 0x00, 0xC3, 0x08, 0x00, 0xA3, 0x00, 0x82, 0x00, 0x82,
+    0x00, 0x62, 0x00, 0x61, 0x00, 0x20, 0x08, 0xE3, 0x00, 0x00, 0x00, 0x41, 0xA6, 0x00, 0x00, 0x2C,
+    0x00, 0x20, 0x00, 0x41, 0x08, 0xA2, 0x08, 0xC3, 0x10, 0xE4, 0x19, 0x04, 0x19, 0x45, 0x19, 0x45,
+    0x19, 0x66, 0x19, 0x66, 0x11, 0x25, 0x08, 0x41, 0x00, 0x20, 0x00, 0x20, 0x08, 0x40, 0x10, 0x40,
+    0x18, 0x80, 0x20, 0xC0, 0x28, 0xE0, 0x31, 0x01, 0x39, 0x41, 0x41, 0x82, 0x49, 0xA3, 0x51, 0xC3,
+    0x51, 0xE3, 0x5A, 0x04, 0x5A, 0x24, 0x62, 0x44, 0x62, 0x45, 0x6A, 0x65, 0x6A, 0x65, 0x6A, 0x85,
+    0x6A, 0x86, 0x6A, 0xA6, 0x72, 0xA6, 0x72, 0xC7, 0x72, 0xE7, 0x73, 0x08, 0x73, 0x49, 0x73, 0x6A,
+    0x7B, 0xAC, 0x7B, 0xCC, 0x7C, 0x0D, 0x7C, 0x2E, 0x7C, 0x2E, 0x83, 0x7C, 0x4F, 0x10, 0x7C, 0x2E,
+    0x74, 0x0E, 0x73, 0xCD, 0x6B, 0xAC, 0x6B, 0x8B, 0x63, 0x4A, 0x5B, 0x09, 0x52, 0xA8, 0x4A, 0x67,
+    0x41, 0xE5, 0x39, 0x83, 0x28, 0xE2, 0x20, 0xA2, 0x18, 0x81, 0x10, 0x40, 0x10, 0x00, 0x10, 0x00,
+    0x82, 0x10, 0x20, 0x08, 0x10, 0x81, 0x00, 0xE3, 0x01, 0x04, 0x09, 0x24, 0x08, 0xE3, 0x10, 0xC3,
+    0x00, 0xA2, 0x00, 0xA2, 0x00, 0x61, 0x82, 0x00, 0x20, 0x81, 0x00, 0x00, 0x81, 0x00, 0x20, 0xB0,
+    0x00, 0x00, 0x19, 0x00, 0x20, 0x00, 0x41, 0x00, 0x41, 0x08, 0x82, 0x08, 0x82, 0x00, 0x40, 0x00,
+    0x40, 0x08, 0x40, 0x18, 0x80, 0x28, 0xE1, 0x31, 0x21, 0x41, 0x62, 0x49, 0xA2, 0x51, 0xC3, 0x5A,
+    0x03, 0x62, 0x24, 0x62, 0x44, 0x6A, 0x65, 0x6A, 0x85, 0x72, 0xA5, 0x72, 0xA6, 0x72, 0xC6, 0x7A,
+    0xC6, 0x7A, 0xC6, 0x7A, 0xE6, 0x7A, 0xE6, 0x89, 0x7A, 0xE7, 0x1F, 0x7A, 0xE6, 0x7A, 0xE7, 0x7A,
+    0xC6, 0x72, 0xC6, 0x72, 0xA6, 0x72, 0xA6, 0x72, 0x86, 0x72, 0x85, 0x6A, 0x65, 0x6A, 0x44, 0x62,
+    0x24, 0x62, 0x03, 0x62, 0x02, 0x59, 0xE2, 0x59, 0xC2, 0x51, 0xA2, 0x49, 0x61, 0x49, 0x41, 0x41,
+    0x21, 0x39, 0x01, 0x30, 0xE1, 0x28, 0xC0, 0x20, 0xA0, 0x18, 0x80, 0x10, 0x60, 0x10, 0x60, 0x10,
+    0x81, 0x08, 0x61, 0x00, 0x41, 0x00, 0x41, 0x00, 0x61, 0x00, 0x20, 0xC4, 0x00, 0x00, 0x12, 0x08,
+    0x40, 0x10, 0x60, 0x10, 0x60, 0x18, 0x81, 0x28, 0xA1, 0x39, 0x22, 0x41, 0xA3, 0x49, 0xC3, 0x51,
+    0xE4, 0x5A, 0x24, 0x62, 0x45, 0x6A, 0x86, 0x72, 0x86, 0x7A, 0xE6, 0x82, 0xE7, 0x83, 0x07, 0x83,
+    0x27, 0x8B, 0x47, 0x8B, 0x48, 0x83, 0x93, 0x68, 0x00, 0x93, 0x88, 0x84, 0x93, 0x68, 0x81, 0x8B,
+    0x48, 0x12, 0x8B, 0x27, 0x83, 0x07, 0x83, 0x07, 0x7A, 0xE6, 0x7A, 0xC6, 0x72, 0xA6, 0x6A, 0x65,
+    0x62, 0x45, 0x5A, 0x25, 0x52, 0x04, 0x49, 0xC4, 0x41, 0xA3, 0x39, 0x42, 0x31, 0x01, 0x20, 0x80,
+    0x10, 0x60, 0x10, 0x60, 0x08, 0x40, 0x08, 0x40, 0xD9, 0x00, 0x00, 0x07, 0x08, 0x00, 0x10, 0x60,
+    0x18, 0x81, 0x18, 0xA1, 0x18, 0xA1, 0x20, 0xC1, 0x20, 0xE2, 0x28, 0xE2, 0x88, 0x29, 0x02, 0x08,
+    0x28, 0xE2, 0x20, 0xE2, 0x20, 0xE2, 0x20, 0xC1, 0x18, 0xA1, 0x18, 0x81, 0x10, 0x81, 0x10, 0x40,
+    0x08, 0x00, 0xFF, 0x00, 0x00, 0xFF, 0x00, 0x00, 0xFF, 0x00, 0x00, 0xFF, 0x00, 0x00, 0xFF, 0x00,
+    0x00, 0xFF, 0x00, 0x00, 0xFF, 0x00, 0x00, 0xFF, 0x00, 0x00, 0xFF, 0x00, 0x00, 0xFF, 0x00, 0x00,
+    0xFF, 0x00, 0x00, 0xFF, 0x00, 0x00, 0xFF, 0x00, 0x00, 0xFF, 0x00, 0x00, 0xFF, 0x00, 0x00, 0xFF,
+    0x00, 0x00, 0xFF, 0x00, 0x00, 0xB1, 0x00, 0x00,
 };
+
+static const image_asset_t naphome_asset = {naphome_asset_data, sizeof(naphome_asset_data)};
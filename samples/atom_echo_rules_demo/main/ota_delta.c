@@ -0,0 +1,649 @@
+#include "ota_delta.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "esp_crt_bundle.h"
+#include "esp_timer.h"
+#include "esp_http_client.h"
+#include "esp_log.h"
+#include "esp_ota_ops.h"
+#include "esp_partition.h"
+#include "esp_system.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "mbedtls/sha256.h"
+
+static const char *TAG = "ota_delta";
+
+/*
+ * Patch format, little-endian:
+ *
+ *   header   magic "NDP1", u16 version, u16 flags (0),
+ *            u32 source_size, u32 target_size,
+ *            source_sha256[32], target_sha256[32]
+ *   ops      until target_size bytes have been produced:
+ *     0x01 COPY     varint src_off, varint len, varint fix_count,
+ *                   fix_count x (varint gap, u8 xor)
+ *     0x02 LITERAL  varint len, len bytes
+ *
+ * COPY reproduces len bytes of the running image from src_off, flipping
+ * the odd byte on the way: each fix skips gap unchanged bytes and XORs the
+ * next one. Relinked firmware is mostly code that moved with a few
+ * addresses changed, which this captures without a compressor on device.
+ */
+#define PATCH_MAGIC 0x3150444EU       // "NDP1"
+#define PATCH_VERSION 1
+#define PATCH_HEADER_LEN 80
+#define OP_COPY 0x01
+#define OP_LITERAL 0x02
+
+#define OUT_BUF_LEN 4096              // One flash sector per esp_ota_write
+#define RX_BUF_LEN 2048
+#define HTTP_TIMEOUT_MS 15000
+#define RESUME_BACKOFF_MAX_MS 8000
+#define PROGRESS_STEP (64 * 1024)
+#define TASK_STACK 8192
+
+typedef enum {
+    DEC_HEADER = 0,
+    DEC_OP,
+    DEC_VARINT,
+    DEC_LITERAL,
+    DEC_FIX_XOR,
+    DEC_END,
+} dec_state_t;
+
+typedef struct {
+    dec_state_t state;
+    uint8_t op;
+    uint8_t field;                    // Which varint of the op is being read
+    uint32_t varint;
+    uint8_t varint_shift;
+
+    uint32_t src_pos;                 // COPY: next source byte
+    uint32_t remaining;               // Bytes left in the current op
+    uint32_t fixes;                   // COPY: fixes left
+
+    uint8_t header[PATCH_HEADER_LEN];
+    size_t header_len;
+    uint32_t source_size;
+    uint32_t target_size;
+    uint8_t target_sha256[32];
+
+    const esp_partition_t *source;
+    const esp_partition_t *target;
+    esp_ota_handle_t ota;
+    bool ota_open;
+    mbedtls_sha256_context sha;
+
+    uint8_t out[OUT_BUF_LEN];
+    size_t out_len;
+    size_t written;                   // Image bytes produced, flushed or not
+    size_t consumed;                  // Patch bytes fed in
+} decoder_t;
+
+typedef struct {
+    ota_delta_config_t cfg;
+    size_t next_progress;
+    decoder_t dec;
+    uint8_t rx[RX_BUF_LEN];
+} job_t;
+
+static ota_delta_status_t s_status;
+static bool s_running;
+static portMUX_TYPE s_status_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static uint32_t get_u32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void report(job_t *job, ota_delta_state_t state, esp_err_t error)
+{
+    ota_delta_status_t snapshot;
+    portENTER_CRITICAL(&s_status_lock);
+    s_status.state = state;
+    s_status.error = error;
+    s_status.patch_received = job->dec.consumed;
+    s_status.image_written = job->dec.written;
+    s_status.image_size = job->dec.target_size;
+    snapshot = s_status;
+    portEXIT_CRITICAL(&s_status_lock);
+
+    job->next_progress = job->dec.written + PROGRESS_STEP;
+    if (job->cfg.progress_cb) {
+        job->cfg.progress_cb(&snapshot, job->cfg.progress_ctx);
+    }
+}
+
+static esp_err_t flush_out(decoder_t *d)
+{
+    if (d->out_len == 0) {
+        return ESP_OK;
+    }
+    mbedtls_sha256_update(&d->sha, d->out, d->out_len);
+    esp_err_t err = esp_ota_write(d->ota, d->out, d->out_len);
+    d->out_len = 0;
+    return err;
+}
+
+static esp_err_t emit_source(decoder_t *d, uint32_t len, uint8_t xor_mask)
+{
+    while (len > 0) {
+        size_t chunk = OUT_BUF_LEN - d->out_len;
+        if (chunk > len) {
+            chunk = len;
+        }
+        esp_err_t err = esp_partition_read(d->source, d->src_pos, d->out + d->out_len, chunk);
+        if (err != ESP_OK) {
+            return err;
+        }
+        if (xor_mask) {
+            d->out[d->out_len] ^= xor_mask;
+        }
+        d->src_pos += chunk;
+        d->out_len += chunk;
+        d->written += chunk;
+        d->remaining -= chunk;
+        len -= chunk;
+        if (d->out_len == OUT_BUF_LEN) {
+            err = flush_out(d);
+            if (err != ESP_OK) {
+                return err;
+            }
+        }
+    }
+    return ESP_OK;
+}
+
+static esp_err_t emit_literal(decoder_t *d, const uint8_t *data, size_t len)
+{
+    while (len > 0) {
+        size_t chunk = OUT_BUF_LEN - d->out_len;
+        if (chunk > len) {
+            chunk = len;
+        }
+        memcpy(d->out + d->out_len, data, chunk);
+        d->out_len += chunk;
+        d->written += chunk;
+        d->remaining -= chunk;
+        data += chunk;
+        len -= chunk;
+        if (d->out_len == OUT_BUF_LEN) {
+            esp_err_t err = flush_out(d);
+            if (err != ESP_OK) {
+                return err;
+            }
+        }
+    }
+    return ESP_OK;
+}
+
+static esp_err_t hash_source(decoder_t *d, const uint8_t expected[32])
+{
+    uint8_t *buf = malloc(OUT_BUF_LEN);
+    if (!buf) {
+        return ESP_ERR_NO_MEM;
+    }
+    mbedtls_sha256_context sha;
+    mbedtls_sha256_init(&sha);
+    mbedtls_sha256_starts(&sha, 0);
+    esp_err_t err = ESP_OK;
+    for (uint32_t off = 0; off < d->source_size && err == ESP_OK; off += OUT_BUF_LEN) {
+        size_t chunk = d->source_size - off < OUT_BUF_LEN ? d->source_size - off : OUT_BUF_LEN;
+        err = esp_partition_read(d->source, off, buf, chunk);
+        if (err == ESP_OK) {
+            mbedtls_sha256_update(&sha, buf, chunk);
+        }
+    }
+    uint8_t digest[32];
+    mbedtls_sha256_finish(&sha, digest);
+    mbedtls_sha256_free(&sha);
+    free(buf);
+    if (err == ESP_OK && memcmp(digest, expected, sizeof(digest)) != 0) {
+        err = ESP_ERR_INVALID_VERSION;
+    }
+    return err;
+}
+
+static esp_err_t parse_header(job_t *job)
+{
+    decoder_t *d = &job->dec;
+    const uint8_t *h = d->header;
+    uint16_t version = (uint16_t)(h[4] | (h[5] << 8));
+    if (get_u32(h) != PATCH_MAGIC || version != PATCH_VERSION) {
+        ESP_LOGE(TAG, "Not a delta patch (magic %08lx, version %u)", (unsigned long)get_u32(h), version);
+        return ESP_ERR_INVALID_RESPONSE;
+    }
+    d->source_size = get_u32(h + 8);
+    d->target_size = get_u32(h + 12);
+    memcpy(d->target_sha256, h + 48, sizeof(d->target_sha256));
+
+    if (d->source_size > d->source->size || d->target_size > d->target->size || d->target_size == 0) {
+        ESP_LOGE(TAG, "Patch sizes %lu -> %lu do not fit the partitions",
+                 (unsigned long)d->source_size, (unsigned long)d->target_size);
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    report(job, OTA_DELTA_VERIFYING_SOURCE, ESP_OK);
+    esp_err_t err = hash_source(d, h + 16);
+    if (err == ESP_ERR_INVALID_VERSION) {
+        ESP_LOGE(TAG, "Patch was made for different firmware than %s holds", d->source->label);
+    }
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    // Sequential writes erase sector by sector as the image grows instead
+    // of the whole slot up front, so the socket is never left unread for
+    // the seconds a full erase takes
+    err = esp_ota_begin(d->target, OTA_WITH_SEQUENTIAL_WRITES, &d->ota);
+    if (err != ESP_OK) {
+        return err;
+    }
+    d->ota_open = true;
+    mbedtls_sha256_starts(&d->sha, 0);
+    ESP_LOGI(TAG, "Rebuilding %lu byte image into %s", (unsigned long)d->target_size, d->target->label);
+    report(job, OTA_DELTA_DOWNLOADING, ESP_OK);
+    return ESP_OK;
+}
+
+// A varint of the current op is complete: store it and pick the next state
+static esp_err_t field_done(decoder_t *d)
+{
+    uint32_t value = d->varint;
+    uint8_t field = d->field++;
+    d->varint = 0;
+    d->varint_shift = 0;
+
+    if (d->op == OP_LITERAL) {
+        if (value == 0 || value > d->target_size - d->written) {
+            return ESP_ERR_INVALID_RESPONSE;
+        }
+        d->remaining = value;
+        d->state = DEC_LITERAL;
+        return ESP_OK;
+    }
+
+    switch (field) {
+    case 0:
+        d->src_pos = value;
+        return ESP_OK;
+    case 1:
+        if (value == 0 || value > d->target_size - d->written ||
+            d->src_pos > d->source_size || value > d->source_size - d->src_pos) {
+            return ESP_ERR_INVALID_RESPONSE;
+        }
+        d->remaining = value;
+        return ESP_OK;
+    case 2:
+        d->fixes = value;
+        if (value > d->remaining) {
+            return ESP_ERR_INVALID_RESPONSE;
+        }
+        if (value > 0) {
+            return ESP_OK;
+        }
+        d->state = DEC_OP;
+        return emit_source(d, d->remaining, 0);
+    default:
+        // Gap before the next fix; it must leave room for the fixed byte
+        if (value >= d->remaining) {
+            return ESP_ERR_INVALID_RESPONSE;
+        }
+        d->state = DEC_FIX_XOR;
+        return emit_source(d, value, 0);
+    }
+}
+
+static esp_err_t feed(job_t *job, const uint8_t *data, size_t len)
+{
+    decoder_t *d = &job->dec;
+    esp_err_t err = ESP_OK;
+
+    while (len > 0 && err == ESP_OK) {
+        switch (d->state) {
+        case DEC_HEADER: {
+            size_t take = PATCH_HEADER_LEN - d->header_len;
+            if (take > len) {
+                take = len;
+            }
+            memcpy(d->header + d->header_len, data, take);
+            d->header_len += take;
+            d->consumed += take;
+            data += take;
+            len -= take;
+            if (d->header_len == PATCH_HEADER_LEN) {
+                d->state = DEC_OP;
+                err = parse_header(job);
+            }
+            continue;
+        }
+        case DEC_OP:
+            d->op = *data;
+            if (d->op != OP_COPY && d->op != OP_LITERAL) {
+                return ESP_ERR_INVALID_RESPONSE;
+            }
+            d->field = 0;
+            d->state = DEC_VARINT;
+            break;
+        case DEC_VARINT:
+            if (d->varint_shift > 28) {
+                return ESP_ERR_INVALID_RESPONSE;
+            }
+            d->varint |= (uint32_t)(*data & 0x7F) << d->varint_shift;
+            d->varint_shift += 7;
+            if (!(*data & 0x80)) {
+                err = field_done(d);
+            }
+            break;
+        case DEC_LITERAL: {
+            size_t take = d->remaining < len ? d->remaining : len;
+            err = emit_literal(d, data, take);
+            d->consumed += take;
+            data += take;
+            len -= take;
+            if (d->remaining == 0) {
+                d->state = DEC_OP;
+            }
+            goto op_done;
+        }
+        case DEC_FIX_XOR:
+            err = emit_source(d, 1, *data);
+            if (err == ESP_OK && --d->fixes > 0) {
+                d->state = DEC_VARINT;
+            } else if (err == ESP_OK) {
+                d->state = DEC_OP;
+                err = emit_source(d, d->remaining, 0);
+            }
+            break;
+        case DEC_END:
+            ESP_LOGE(TAG, "Patch continues past the end of the image");
+            return ESP_ERR_INVALID_SIZE;
+        }
+        d->consumed++;
+        data++;
+        len--;
+op_done:
+        if (d->state == DEC_OP && d->written == d->target_size) {
+            d->state = DEC_END;
+        }
+    }
+    return err;
+}
+
+static esp_err_t finish(decoder_t *d)
+{
+    esp_err_t err = flush_out(d);
+    if (err != ESP_OK) {
+        return err;
+    }
+    uint8_t digest[32];
+    mbedtls_sha256_finish(&d->sha, digest);
+    if (memcmp(digest, d->target_sha256, sizeof(digest)) != 0) {
+        ESP_LOGE(TAG, "Rebuilt image does not match the patch's SHA-256");
+        return ESP_ERR_INVALID_CRC;
+    }
+    d->ota_open = false;
+    err = esp_ota_end(d->ota);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Rebuilt image failed validation: %s", esp_err_to_name(err));
+        return err;
+    }
+    return esp_ota_set_boot_partition(d->target);
+}
+
+/*
+ * One HTTP request, resumed from d->consumed when non-zero.
+ *
+ * @return ESP_OK when the patch is fully decoded, ESP_ERR_TIMEOUT when the
+ *         connection dropped and another attempt should resume, anything
+ *         else when retrying cannot help
+ */
+static esp_err_t download_once(job_t *job)
+{
+    decoder_t *d = &job->dec;
+    esp_http_client_config_t http_cfg = {
+        .url = job->cfg.url,
+        .timeout_ms = HTTP_TIMEOUT_MS,
+        .buffer_size = RX_BUF_LEN,
+        .keep_alive_enable = true,
+    };
+    if (job->cfg.cert_pem) {
+        http_cfg.cert_pem = job->cfg.cert_pem;
+    } else {
+        http_cfg.crt_bundle_attach = esp_crt_bundle_attach;
+    }
+    esp_http_client_handle_t client = esp_http_client_init(&http_cfg);
+    if (!client) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    size_t resume_from = d->consumed;
+    if (resume_from > 0) {
+        char range[32];
+        snprintf(range, sizeof(range), "bytes=%u-", (unsigned)resume_from);
+        esp_http_client_set_header(client, "Range", range);
+    }
+
+    esp_err_t err = esp_http_client_open(client, 0);
+    if (err != ESP_OK) {
+        esp_http_client_cleanup(client);
+        return ESP_ERR_TIMEOUT;
+    }
+    int64_t content_length = esp_http_client_fetch_headers(client);
+    int status = esp_http_client_get_status_code(client);
+    if (resume_from > 0 && status != 206) {
+        // A server that ignores Range would replay the patch from byte 0
+        ESP_LOGE(TAG, "Server answered %d to a resume; it must support Range requests", status);
+        err = ESP_ERR_NOT_SUPPORTED;
+    } else if (status >= 400 && status < 500) {
+        ESP_LOGE(TAG, "Patch download failed: HTTP %d", status);
+        err = ESP_ERR_NOT_FOUND;
+    } else if (status != 200 && status != 206) {
+        ESP_LOGW(TAG, "Patch download got HTTP %d, retrying", status);
+        err = ESP_ERR_TIMEOUT;
+    }
+
+    if (err == ESP_OK && content_length > 0) {
+        portENTER_CRITICAL(&s_status_lock);
+        s_status.patch_size = resume_from + (size_t)content_length;
+        portEXIT_CRITICAL(&s_status_lock);
+    }
+
+    int64_t started_us = esp_timer_get_time();
+    uint64_t received = 0;
+    while (err == ESP_OK && d->state != DEC_END) {
+        int n = esp_http_client_read(client, (char *)job->rx, sizeof(job->rx));
+        if (n < 0) {
+            err = ESP_ERR_TIMEOUT;
+            break;
+        }
+        if (n == 0) {
+            if (esp_http_client_is_complete_data_received(client)) {
+                ESP_LOGE(TAG, "Patch ended %lu bytes short of the image",
+                         (unsigned long)(d->target_size - d->written));
+                err = ESP_ERR_INVALID_SIZE;
+            } else {
+                err = ESP_ERR_TIMEOUT;
+            }
+            break;
+        }
+        err = feed(job, job->rx, (size_t)n);
+        if (err == ESP_OK && d->written >= job->next_progress) {
+            report(job, OTA_DELTA_DOWNLOADING, ESP_OK);
+        }
+        if (job->cfg.max_bytes_per_sec) {
+            // Stop reading until the average over this connection is back
+            // under the cap; TCP flow control holds the server off meanwhile
+            received += (uint64_t)n;
+            int64_t due_us = (int64_t)(received * 1000000ULL / job->cfg.max_bytes_per_sec);
+            int64_t ahead_ms = (due_us - (esp_timer_get_time() - started_us)) / 1000;
+            if (ahead_ms > 0) {
+                vTaskDelay(pdMS_TO_TICKS(ahead_ms));
+            }
+        }
+    }
+
+    esp_http_client_close(client);
+    esp_http_client_cleanup(client);
+    return err;
+}
+
+esp_err_t ota_delta_apply(const ota_delta_config_t *cfg)
+{
+    if (!cfg || !cfg->url) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    bool busy;
+    portENTER_CRITICAL(&s_status_lock);
+    busy = s_running;
+    if (!busy) {
+        s_running = true;
+        memset(&s_status, 0, sizeof(s_status));
+    }
+    portEXIT_CRITICAL(&s_status_lock);
+    if (busy) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    job_t *job = calloc(1, sizeof(*job));
+    if (!job) {
+        portENTER_CRITICAL(&s_status_lock);
+        s_running = false;
+        portEXIT_CRITICAL(&s_status_lock);
+        return ESP_ERR_NO_MEM;
+    }
+    job->cfg = *cfg;
+    decoder_t *d = &job->dec;
+    d->source = esp_ota_get_running_partition();
+    d->target = esp_ota_get_next_update_partition(NULL);
+    mbedtls_sha256_init(&d->sha);
+
+    esp_err_t err = ESP_OK;
+    if (!d->source || !d->target) {
+        ESP_LOGE(TAG, "No OTA slot to update into");
+        err = ESP_ERR_NOT_FOUND;
+    }
+
+    uint8_t max_resumes = cfg->max_resumes ? cfg->max_resumes : OTA_DELTA_DEFAULT_RESUMES;
+    uint32_t backoff_ms = 1000;
+    while (err == ESP_OK) {
+        size_t consumed_before = d->consumed;
+        err = download_once(job);
+        if (err != ESP_ERR_TIMEOUT) {
+            break;
+        }
+        uint8_t resumes;
+        portENTER_CRITICAL(&s_status_lock);
+        resumes = ++s_status.resumes;
+        portEXIT_CRITICAL(&s_status_lock);
+        if (resumes > max_resumes) {
+            ESP_LOGE(TAG, "Giving up after %u resumes", max_resumes);
+            break;
+        }
+        if (d->consumed > consumed_before) {
+            backoff_ms = 1000;
+        }
+        ESP_LOGW(TAG, "Connection lost at patch byte %u, resuming in %lu ms",
+                 (unsigned)d->consumed, (unsigned long)backoff_ms);
+        vTaskDelay(pdMS_TO_TICKS(backoff_ms));
+        backoff_ms = backoff_ms * 2 > RESUME_BACKOFF_MAX_MS ? RESUME_BACKOFF_MAX_MS : backoff_ms * 2;
+        err = ESP_OK;
+    }
+
+    if (err == ESP_OK) {
+        err = finish(d);
+    }
+    if (d->ota_open) {
+        esp_ota_abort(d->ota);
+    }
+    mbedtls_sha256_free(&d->sha);
+
+    if (err == ESP_OK) {
+        ESP_LOGI(TAG, "Update ready in %s: %u patch bytes for a %lu byte image",
+                 d->target->label, (unsigned)d->consumed, (unsigned long)d->target_size);
+    } else {
+        ESP_LOGE(TAG, "Delta update failed: %s", esp_err_to_name(err));
+    }
+    report(job, err == ESP_OK ? OTA_DELTA_DONE : OTA_DELTA_FAILED, err);
+
+    portENTER_CRITICAL(&s_status_lock);
+    s_running = false;
+    portEXIT_CRITICAL(&s_status_lock);
+    free(job);
+    return err;
+}
+
+typedef struct {
+    ota_delta_config_t cfg;
+    char *url;
+    char *cert_pem;
+} start_args_t;
+
+static void ota_delta_task(void *arg)
+{
+    start_args_t *args = (start_args_t *)arg;
+    esp_err_t err = ota_delta_apply(&args->cfg);
+    bool reboot = err == ESP_OK && args->cfg.reboot;
+    free(args->url);
+    free(args->cert_pem);
+    free(args);
+    if (reboot) {
+        ESP_LOGI(TAG, "Restarting into the new image");
+        vTaskDelay(pdMS_TO_TICKS(1000));
+        esp_restart();
+    }
+    vTaskDelete(NULL);
+}
+
+esp_err_t ota_delta_start(const ota_delta_config_t *cfg)
+{
+    if (!cfg || !cfg->url) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    bool busy;
+    portENTER_CRITICAL(&s_status_lock);
+    busy = s_running;
+    portEXIT_CRITICAL(&s_status_lock);
+    if (busy) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    start_args_t *args = calloc(1, sizeof(*args));
+    if (!args) {
+        return ESP_ERR_NO_MEM;
+    }
+    args->cfg = *cfg;
+    args->url = strdup(cfg->url);
+    args->cert_pem = cfg->cert_pem ? strdup(cfg->cert_pem) : NULL;
+    if (!args->url || (cfg->cert_pem && !args->cert_pem)) {
+        free(args->url);
+        free(args->cert_pem);
+        free(args);
+        return ESP_ERR_NO_MEM;
+    }
+    args->cfg.url = args->url;
+    args->cfg.cert_pem = args->cert_pem;
+
+    if (xTaskCreate(ota_delta_task, "ota_delta", TASK_STACK, args, 5, NULL) != pdPASS) {
+        free(args->url);
+        free(args->cert_pem);
+        free(args);
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+void ota_delta_get_status(ota_delta_status_t *out_status)
+{
+    if (!out_status) {
+        return;
+    }
+    portENTER_CRITICAL(&s_status_lock);
+    *out_status = s_status;
+    portEXIT_CRITICAL(&s_status_lock);
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Delta firmware updates. Instead of a whole image the device downloads a
+ * patch against the firmware it is running (made by
+ * scripts/make_ota_delta.py) and rebuilds the new image into the next OTA
+ * slot while the patch streams in.
+ *
+ * Decoded bytes are hashed and written as they are produced, so the
+ * SHA-256 of the new image is ready when the last byte lands and nothing
+ * larger than one flash sector is ever buffered. A dropped connection is
+ * resumed with an HTTP Range request from the last patch byte consumed;
+ * the decoder, the hash and the half-written slot carry on from there.
+ *
+ * The boot partition only changes once the rebuilt image matches the hash
+ * in the patch header and passes esp_ota_end's image checks.
+ */
+
+typedef enum {
+    OTA_DELTA_IDLE = 0,
+    OTA_DELTA_VERIFYING_SOURCE,       // Hashing the running image against the patch
+    OTA_DELTA_DOWNLOADING,
+    OTA_DELTA_DONE,                   // New image set to boot
+    OTA_DELTA_FAILED,
+} ota_delta_state_t;
+
+typedef struct {
+    ota_delta_state_t state;
+    size_t patch_received;            // Patch bytes consumed, across resumes
+    size_t patch_size;                // 0 until the server reports it
+    size_t image_written;
+    size_t image_size;                // 0 until the patch header arrives
+    uint8_t resumes;
+    esp_err_t error;                  // Set in OTA_DELTA_FAILED
+} ota_delta_status_t;
+
+// Called from the update task on state changes and every few dozen KB
+typedef void (*ota_delta_progress_cb_t)(const ota_delta_status_t *status, void *ctx);
+
+typedef struct {
+    const char *url;
+    const char *cert_pem;             // NULL uses the certificate bundle
+    uint8_t max_resumes;              // 0 = OTA_DELTA_DEFAULT_RESUMES
+    bool reboot;                      // ota_delta_start only: restart into the new image
+    uint32_t max_bytes_per_sec;       // Patch download rate cap, 0 = unthrottled
+    ota_delta_progress_cb_t progress_cb;
+    void *progress_ctx;
+} ota_delta_config_t;
+
+#define OTA_DELTA_DEFAULT_RESUMES 8
+
+/**
+ * Download and apply a patch, blocking until the new image is set to boot
+ * or the update fails. Does not reboot.
+ *
+ * @return ESP_ERR_INVALID_VERSION when the patch was made for different
+ *         firmware than the one running, ESP_ERR_INVALID_CRC when the
+ *         rebuilt image does not match, ESP_ERR_INVALID_STATE when another
+ *         update is running
+ */
+esp_err_t ota_delta_apply(const ota_delta_config_t *cfg);
+
+// ota_delta_apply on its own task; strings in cfg are copied
+esp_err_t ota_delta_start(const ota_delta_config_t *cfg);
+
+void ota_delta_get_status(ota_delta_status_t *out_status);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,453 @@
+#include "ota_jobs.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "aws_iot_service.h"
+#include "cJSON.h"
+#include "device_state.h"
+#include "esp_app_desc.h"
+#include "esp_check.h"
+#include "esp_log.h"
+#include "esp_ota_ops.h"
+#include "esp_system.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "nvs.h"
+#include "ota_delta.h"
+#include "sdkconfig.h"
+#include "somnus_mqtt.h"
+
+static const char *TAG = "ota_jobs";
+
+#define JOBS_TOPIC_MAX 160
+#define JOB_ID_MAX 65                 // AWS job IDs are at most 64 characters
+#define JOB_URL_MAX 512
+#define JOBS_POLL_MS 10000
+#define JOBS_REFETCH_US (60LL * 60 * 1000000)
+#define PROGRESS_PERCENT_STEP 10
+#define RESTART_DRAIN_MS 5000         // Let the "rebooting" update leave the outbox
+#define CLOCK_SET_AFTER 1704067200    // 2024-01-01; earlier means SNTP has not run
+#define TASK_STACK 8192               // Runs the TLS download
+
+#define NVS_NAMESPACE "ota_jobs"
+#define NVS_KEY_JOB "job"
+#define NVS_KEY_SLOT "slot"
+
+typedef enum {
+    JOBS_MSG_NEXT = 0,                // notify-next and $next/get/accepted
+    JOBS_MSG_REJECTED,
+} jobs_msg_t;
+
+typedef struct {
+    char id[JOB_ID_MAX];
+    char url[JOB_URL_MAX];
+    int8_t start_hour;                // -1 = no window
+    int8_t end_hour;
+    uint32_t max_bytes_per_sec;
+    int64_t received_us;
+} ota_job_t;
+
+static struct {
+    SemaphoreHandle_t lock;
+    char prefix[JOBS_TOPIC_MAX];      // $aws/things/<thing>/jobs
+    uint32_t jitter;                  // Per-device spread within a window
+    ota_job_t pending;
+    bool has_pending;
+    bool installing;
+    char finished[JOB_ID_MAX];        // Reported after the restart, not to be run again
+    int64_t last_busy_us;
+    int64_t last_get_us;
+    int last_percent;
+} s_jobs;
+
+static bool job_id_valid(const char *id)
+{
+    size_t len = strlen(id);
+    if (len == 0 || len >= JOB_ID_MAX) {
+        return false;
+    }
+    // The ID goes into a topic, so nothing that could change its levels
+    for (size_t i = 0; i < len; ++i) {
+        char c = id[i];
+        if (!((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '-' ||
+              c == '_')) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// status_details is the inside of a JSON object, values must be strings
+static void report(const char *job_id, const char *status, const char *status_details, bool coalesce)
+{
+    char topic[JOBS_TOPIC_MAX + JOB_ID_MAX + 8];
+    char payload[256];
+    snprintf(topic, sizeof(topic), "%s/%s/update", s_jobs.prefix, job_id);
+    int len = snprintf(payload, sizeof(payload), "{\"status\":\"%s\",\"statusDetails\":{%s}}", status,
+                       status_details);
+    if (len < 0 || len >= (int)sizeof(payload)) {
+        return;
+    }
+    esp_err_t err = aws_iot_service_publish(topic, QOS1, payload, (size_t)len,
+                                            AWS_IOT_SERVICE_PRIORITY_INTERACTION, coalesce);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Job %s %s not queued: %s", job_id, status, esp_err_to_name(err));
+    }
+}
+
+static void request_next(void)
+{
+    char topic[JOBS_TOPIC_MAX + 16];
+    snprintf(topic, sizeof(topic), "%s/$next/get", s_jobs.prefix);
+    static const char payload[] = "{}";
+    if (aws_iot_service_publish(topic, QOS1, payload, sizeof(payload) - 1, AWS_IOT_SERVICE_PRIORITY_INTERACTION,
+                                true) == ESP_OK) {
+        s_jobs.last_get_us = esp_timer_get_time();
+    }
+}
+
+static int8_t hour_item(const cJSON *window, const char *name)
+{
+    const cJSON *item = cJSON_GetObjectItemCaseSensitive(window, name);
+    if (!cJSON_IsNumber(item) || item->valueint < 0 || item->valueint > 23) {
+        return -1;
+    }
+    return (int8_t)item->valueint;
+}
+
+/**
+ * Fill @p job from a job document.
+ *
+ * @return NULL when it describes an install, otherwise why it was rejected
+ */
+static const char *parse_document(const cJSON *doc, ota_job_t *job)
+{
+    const cJSON *operation = cJSON_GetObjectItemCaseSensitive(doc, "operation");
+    if (!cJSON_IsString(operation) || strcmp(operation->valuestring, "ota_delta") != 0) {
+        return "unsupported operation";
+    }
+    const cJSON *url = cJSON_GetObjectItemCaseSensitive(doc, "delta_url");
+    if (!cJSON_IsString(url) || strncmp(url->valuestring, "https://", 8) != 0) {
+        return "delta_url must be https";
+    }
+    if (strlen(url->valuestring) >= sizeof(job->url)) {
+        return "delta_url too long";
+    }
+    strcpy(job->url, url->valuestring);
+
+    job->start_hour = -1;
+    job->end_hour = -1;
+    const cJSON *window = cJSON_GetObjectItemCaseSensitive(doc, "window");
+    if (window) {
+        job->start_hour = hour_item(window, "start_hour");
+        job->end_hour = hour_item(window, "end_hour");
+        if (job->start_hour < 0 || job->end_hour < 0) {
+            return "window hours must be 0-23";
+        }
+    }
+
+    job->max_bytes_per_sec = CONFIG_ATOM_ECHO_OTA_JOBS_MAX_KBPS * 1024U;
+    const cJSON *kbps = cJSON_GetObjectItemCaseSensitive(doc, "max_kbps");
+    if (cJSON_IsNumber(kbps) && kbps->valueint > 0 && kbps->valueint < CONFIG_ATOM_ECHO_OTA_JOBS_MAX_KBPS) {
+        job->max_bytes_per_sec = (uint32_t)kbps->valueint * 1024U;
+    }
+    return NULL;
+}
+
+static void handle_next(const cJSON *root)
+{
+    const cJSON *execution = cJSON_GetObjectItemCaseSensitive(root, "execution");
+    const cJSON *job_id = cJSON_GetObjectItemCaseSensitive(execution, "jobId");
+    const cJSON *doc = cJSON_GetObjectItemCaseSensitive(execution, "jobDocument");
+
+    xSemaphoreTake(s_jobs.lock, portMAX_DELAY);
+    if (s_jobs.installing) {
+        // The running install cannot be taken back; the next fetch sorts it out
+        xSemaphoreGive(s_jobs.lock);
+        return;
+    }
+    if (!cJSON_IsString(job_id)) {
+        // No job pending any more, e.g. the one waiting here was cancelled
+        if (s_jobs.has_pending) {
+            ESP_LOGI(TAG, "Job %s withdrawn", s_jobs.pending.id);
+        }
+        s_jobs.has_pending = false;
+        xSemaphoreGive(s_jobs.lock);
+        return;
+    }
+    if (strcmp(job_id->valuestring, s_jobs.finished) == 0 ||
+        (s_jobs.has_pending && strcmp(job_id->valuestring, s_jobs.pending.id) == 0)) {
+        xSemaphoreGive(s_jobs.lock);
+        return;
+    }
+    xSemaphoreGive(s_jobs.lock);
+
+    if (!job_id_valid(job_id->valuestring)) {
+        ESP_LOGW(TAG, "Ignoring job with unusable ID");
+        return;
+    }
+    ota_job_t job = {0};
+    strcpy(job.id, job_id->valuestring);
+    const char *reason = parse_document(doc, &job);
+    if (reason) {
+        ESP_LOGW(TAG, "Rejecting job %s: %s", job.id, reason);
+        char details[96];
+        snprintf(details, sizeof(details), "\"reason\":\"%s\"", reason);
+        report(job.id, "REJECTED", details, false);
+        return;
+    }
+    job.received_us = esp_timer_get_time();
+
+    xSemaphoreTake(s_jobs.lock, portMAX_DELAY);
+    s_jobs.pending = job;
+    s_jobs.has_pending = true;
+    xSemaphoreGive(s_jobs.lock);
+
+    if (job.start_hour >= 0) {
+        ESP_LOGI(TAG, "Job %s scheduled for %02d:00-%02d:00", job.id, job.start_hour, job.end_hour);
+    } else {
+        ESP_LOGI(TAG, "Job %s scheduled for the next idle period", job.id);
+    }
+    report(job.id, "IN_PROGRESS", "\"step\":\"scheduled\"", false);
+}
+
+static void jobs_on_message(const char *topic, size_t topic_len, const char *payload, size_t len, void *ctx)
+{
+    (void)topic;
+    (void)topic_len;
+    cJSON *root = cJSON_ParseWithLength(payload, len);
+    if (!root) {
+        ESP_LOGW(TAG, "Unparseable jobs message");
+        return;
+    }
+    if ((jobs_msg_t)(intptr_t)ctx == JOBS_MSG_REJECTED) {
+        const cJSON *message = cJSON_GetObjectItemCaseSensitive(root, "message");
+        ESP_LOGW(TAG, "Job update rejected: %s", cJSON_IsString(message) ? message->valuestring : "?");
+    } else {
+        handle_next(root);
+    }
+    cJSON_Delete(root);
+}
+
+/**
+ * Whether the job's window is open. Each unit starts at its own offset in
+ * the first half of the window and keeps the second half for the download.
+ */
+static bool window_open(const ota_job_t *job)
+{
+    if (job->start_hour < 0) {
+        return true;
+    }
+    time_t now = time(NULL);
+    if (now < CLOCK_SET_AFTER) {
+        return true;                  // Cannot tell, idle has to do
+    }
+    struct tm local;
+    localtime_r(&now, &local);
+    int length_s = ((job->end_hour - job->start_hour + 24) % 24) * 3600;
+    if (length_s == 0) {
+        length_s = 24 * 3600;
+    }
+    int since_start_s = ((local.tm_hour - job->start_hour + 24) % 24) * 3600 + local.tm_min * 60 + local.tm_sec;
+    int offset_s = (int)(s_jobs.jitter % (uint32_t)(length_s / 2));
+    return since_start_s >= offset_s && since_start_s < length_s;
+}
+
+static bool ready_to_install(const ota_job_t *job, int64_t now_us)
+{
+    if (now_us - s_jobs.last_busy_us < (int64_t)CONFIG_ATOM_ECHO_OTA_JOBS_IDLE_S * 1000000) {
+        return false;
+    }
+    if (now_us - job->received_us >= (int64_t)CONFIG_ATOM_ECHO_OTA_JOBS_MAX_DEFER_H * 3600 * 1000000) {
+        return true;
+    }
+    return window_open(job);
+}
+
+static void install_progress(const ota_delta_status_t *status, void *ctx)
+{
+    const ota_job_t *job = (const ota_job_t *)ctx;
+    if (status->state != OTA_DELTA_DOWNLOADING || status->image_size == 0) {
+        return;
+    }
+    int percent = (int)((uint64_t)status->image_written * 100 / status->image_size);
+    percent -= percent % PROGRESS_PERCENT_STEP;
+    if (percent <= s_jobs.last_percent) {
+        return;
+    }
+    s_jobs.last_percent = percent;
+    char details[64];
+    snprintf(details, sizeof(details), "\"step\":\"downloading\",\"percent\":\"%d\"", percent);
+    report(job->id, "IN_PROGRESS", details, true);
+}
+
+static void remember_install(const ota_job_t *job)
+{
+    const esp_partition_t *target = esp_ota_get_boot_partition();
+    nvs_handle_t nvs;
+    if (!target || nvs_open(NVS_NAMESPACE, NVS_READWRITE, &nvs) != ESP_OK) {
+        return;
+    }
+    if (nvs_set_str(nvs, NVS_KEY_JOB, job->id) == ESP_OK && nvs_set_str(nvs, NVS_KEY_SLOT, target->label) == ESP_OK) {
+        nvs_commit(nvs);
+    }
+    nvs_close(nvs);
+}
+
+static void install(const ota_job_t *job)
+{
+    ESP_LOGI(TAG, "Installing job %s at up to %lu KB/s", job->id, (unsigned long)(job->max_bytes_per_sec / 1024));
+    s_jobs.last_percent = 0;
+    report(job->id, "IN_PROGRESS", "\"step\":\"downloading\",\"percent\":\"0\"", true);
+
+    ota_delta_config_t cfg = {
+        .url = job->url,
+        .max_bytes_per_sec = job->max_bytes_per_sec,
+        .progress_cb = install_progress,
+        .progress_ctx = (void *)job,
+    };
+    esp_err_t err = ota_delta_apply(&cfg);
+    if (err != ESP_OK) {
+        char details[96];
+        snprintf(details, sizeof(details), "\"step\":\"failed\",\"error\":\"%s\"", esp_err_to_name(err));
+        report(job->id, "FAILED", details, false);
+        return;
+    }
+
+    // The job succeeds once the new image has come up; see report_finished()
+    remember_install(job);
+    report(job->id, "IN_PROGRESS", "\"step\":\"rebooting\"", false);
+    aws_iot_service_outbox_stats_t stats;
+    for (int waited = 0; waited < RESTART_DRAIN_MS; waited += 100) {
+        aws_iot_service_get_outbox_stats(&stats);
+        if (stats.queued == 0) {
+            break;
+        }
+        vTaskDelay(pdMS_TO_TICKS(100));
+    }
+    ESP_LOGI(TAG, "Restarting into the new image");
+    esp_restart();
+}
+
+// Close out a job installed before the last restart
+static void report_finished(void)
+{
+    nvs_handle_t nvs;
+    if (nvs_open(NVS_NAMESPACE, NVS_READWRITE, &nvs) != ESP_OK) {
+        return;
+    }
+    char slot[17] = {0};
+    size_t id_len = sizeof(s_jobs.finished);
+    size_t slot_len = sizeof(slot);
+    if (nvs_get_str(nvs, NVS_KEY_JOB, s_jobs.finished, &id_len) != ESP_OK ||
+        nvs_get_str(nvs, NVS_KEY_SLOT, slot, &slot_len) != ESP_OK) {
+        s_jobs.finished[0] = '\0';
+        nvs_close(nvs);
+        return;
+    }
+    nvs_erase_key(nvs, NVS_KEY_JOB);
+    nvs_erase_key(nvs, NVS_KEY_SLOT);
+    nvs_commit(nvs);
+    nvs_close(nvs);
+
+    const esp_partition_t *running = esp_ota_get_running_partition();
+    if (running && strcmp(running->label, slot) == 0) {
+        // Reaching the broker is the health check for a rollback-enabled build
+        esp_ota_img_states_t state;
+        if (esp_ota_get_state_partition(running, &state) == ESP_OK && state == ESP_OTA_IMG_PENDING_VERIFY) {
+            esp_ota_mark_app_valid_cancel_rollback();
+        }
+        const esp_app_desc_t *app = esp_app_get_description();
+        char details[96];
+        snprintf(details, sizeof(details), "\"step\":\"installed\",\"version\":\"%.32s\"", app->version);
+        ESP_LOGI(TAG, "Job %s installed", s_jobs.finished);
+        report(s_jobs.finished, "SUCCEEDED", details, false);
+    } else {
+        ESP_LOGE(TAG, "Job %s: booted %s instead of %s", s_jobs.finished, running ? running->label : "?", slot);
+        report(s_jobs.finished, "FAILED", "\"step\":\"rolled_back\"", false);
+    }
+}
+
+static void ota_jobs_task(void *arg)
+{
+    (void)arg;
+    report_finished();
+    request_next();
+    while (true) {
+        vTaskDelay(pdMS_TO_TICKS(JOBS_POLL_MS));
+        int64_t now_us = esp_timer_get_time();
+
+        device_state_snapshot_t state;
+        device_state_get(&state);
+        if (state.audio_playing) {
+            s_jobs.last_busy_us = now_us;
+        }
+
+        ota_job_t job;
+        bool run = false;
+        xSemaphoreTake(s_jobs.lock, portMAX_DELAY);
+        if (s_jobs.has_pending && state.aws_connected && ready_to_install(&s_jobs.pending, now_us)) {
+            job = s_jobs.pending;
+            s_jobs.installing = true;
+            run = true;
+        }
+        xSemaphoreGive(s_jobs.lock);
+
+        if (run) {
+            install(&job);
+            // Only back here when it failed
+            xSemaphoreTake(s_jobs.lock, portMAX_DELAY);
+            s_jobs.installing = false;
+            s_jobs.has_pending = false;
+            xSemaphoreGive(s_jobs.lock);
+            request_next();
+        } else if (now_us - s_jobs.last_get_us >= JOBS_REFETCH_US) {
+            // notify-next is not retained; a missed one is picked up here
+            request_next();
+        }
+    }
+}
+
+esp_err_t ota_jobs_start(void)
+{
+    if (s_jobs.lock) {
+        return ESP_OK;                // Routes and the task outlive a restart of the service
+    }
+    const char *thing = somnus_mqtt_get_device_id();
+    ESP_RETURN_ON_FALSE(thing, ESP_ERR_INVALID_STATE, TAG, "no device ID");
+
+    snprintf(s_jobs.prefix, sizeof(s_jobs.prefix), "$aws/things/%s/jobs", thing);
+    // FNV-1a of the device ID: stable across restarts, spread across the fleet
+    s_jobs.jitter = 2166136261U;
+    for (const char *p = thing; *p; ++p) {
+        s_jobs.jitter = (s_jobs.jitter ^ (uint8_t)*p) * 16777619U;
+    }
+    s_jobs.last_busy_us = esp_timer_get_time();
+    s_jobs.lock = xSemaphoreCreateMutex();
+    ESP_RETURN_ON_FALSE(s_jobs.lock, ESP_ERR_NO_MEM, TAG, "lock");
+
+    static const struct {
+        const char *suffix;
+        jobs_msg_t kind;
+    } subs[] = {
+        {"notify-next", JOBS_MSG_NEXT},
+        {"$next/get/accepted", JOBS_MSG_NEXT},
+        {"+/update/rejected", JOBS_MSG_REJECTED},
+    };
+    char filter[JOBS_TOPIC_MAX + 24];
+    for (size_t i = 0; i < sizeof(subs) / sizeof(subs[0]); ++i) {
+        snprintf(filter, sizeof(filter), "%s/%s", s_jobs.prefix, subs[i].suffix);
+        ESP_RETURN_ON_ERROR(somnus_mqtt_subscribe(filter, jobs_on_message, (void *)(intptr_t)subs[i].kind), TAG,
+                            "subscribe %s", subs[i].suffix);
+    }
+
+    ESP_RETURN_ON_FALSE(xTaskCreate(ota_jobs_task, "ota_jobs", TASK_STACK, NULL, 3, NULL) == pdPASS,
+                        ESP_ERR_NO_MEM, TAG, "task");
+    ESP_LOGI(TAG, "Listening for jobs on %s", s_jobs.prefix);
+    return ESP_OK;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Firmware updates delivered as AWS IoT Jobs. Rollout across the fleet
+ * (stages, rate, abort criteria) is the job's business; this client decides
+ * when the one unit it runs on installs.
+ *
+ * A job document looks like
+ *
+ *   {"operation": "ota_delta", "delta_url": "https://...",
+ *    "window": {"start_hour": 2, "end_hour": 5}, "max_kbps": 64}
+ *
+ * where the window (local hours, may wrap midnight) and the rate are
+ * optional. The install waits until the clock is inside the window, if it
+ * has been set, and the device has been idle (no audio playing) for
+ * CONFIG_ATOM_ECHO_OTA_JOBS_IDLE_S. Within the window each unit starts at
+ * an offset derived from its device ID, so a stage does not hit the server
+ * all at once. A job older than CONFIG_ATOM_ECHO_OTA_JOBS_MAX_DEFER_H
+ * ignores the window and only waits for idle.
+ *
+ * The patch is applied with ota_delta_apply at a capped rate and progress
+ * is reported through UpdateJobExecution status details. After the restart
+ * the job is marked SUCCEEDED if the new image is the one running, FAILED
+ * if the bootloader rolled it back.
+ *
+ * Call once somnus_mqtt is running; calling again after it restarts is a
+ * no-op.
+ */
+esp_err_t ota_jobs_start(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,261 @@
+#include "routine_scheduler.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/time.h>
+#include <time.h>
+
+#include "cJSON.h"
+#include "esp_check.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "rule_store.h"
+#include "somnus_action_handler.h"
+#include "somnus_mqtt.h"
+#include "storage.h"
+
+static const char *TAG = "routines";
+
+#define DEFAULT_PATH STORAGE_PATH("routines.json")
+#define CLOCK_SET_AFTER 1704067200    // 2024-01-01; earlier means SNTP has not run
+#define CLOCK_WAIT_MS 10000
+#define MINUTE_GUARD_MS 50            // Wake this far past the minute so it has turned
+#define MAX_DUE 4                     // Routines starting in the same minute
+#define ROUTINE_ID_MAX 24
+#define TASK_STACK 6144               // Holds the cJSON tree of one action's Data
+
+typedef struct {
+    char id[ROUTINE_ID_MAX];
+    time_t at;
+    esp_err_t err;
+} routine_report_t;
+
+// Routines due this minute, copied out while the store is locked
+typedef struct {
+    size_t count;
+    char id[MAX_DUE][ROUTINE_ID_MAX];
+    char *actions[MAX_DUE];
+} routine_due_t;
+
+static struct {
+    rule_store_t *store;
+    scene_controller_t *scene;
+    TaskHandle_t task;
+    routine_report_t reports[ROUTINE_SCHEDULER_MAX_REPORTS];  // Oldest first; routine task only
+    size_t report_count;
+} s_sched;
+
+// PreSleepRoutine, SleepRoutine, WakeUpRoutine, ...
+static bool is_routine_key(const char *key)
+{
+    size_t len = key ? strlen(key) : 0;
+    return len >= 7 && strcasecmp(key + len - 7, "routine") == 0;
+}
+
+// One time_window rule that opens at StartTime and carries the action list as text
+static cJSON *routine_to_rule(const cJSON *routine)
+{
+    const cJSON *start = cJSON_GetObjectItemCaseSensitive(routine, "StartTime");
+    const cJSON *actions = cJSON_GetObjectItemCaseSensitive(routine, "Actions");
+    int hours = -1;
+    int minutes = -1;
+    if (!cJSON_IsString(start) || sscanf(start->valuestring, "%d:%d", &hours, &minutes) != 2 || hours < 0 ||
+        hours > 23 || minutes < 0 || minutes > 59 || !cJSON_IsArray(actions)) {
+        ESP_LOGW(TAG, "%s has no StartTime or Actions; not scheduled", routine->string);
+        return NULL;
+    }
+    char *payload = cJSON_PrintUnformatted(actions);
+    if (!payload) {
+        return NULL;
+    }
+
+    // Only the opening edge matters; the window closes a minute later
+    int end = (hours * 60 + minutes + 1) % (24 * 60);
+    char start_local[8];
+    char end_local[8];
+    snprintf(start_local, sizeof(start_local), "%02d:%02d", hours, minutes);
+    snprintf(end_local, sizeof(end_local), "%02d:%02d", end / 60, end % 60);
+
+    cJSON *rule = cJSON_CreateObject();
+    cJSON_AddStringToObject(rule, "id", routine->string);
+    cJSON *trigger = cJSON_AddObjectToObject(rule, "trigger");
+    cJSON_AddStringToObject(trigger, "type", "time_window");
+    cJSON_AddStringToObject(trigger, "start_local", start_local);
+    cJSON_AddStringToObject(trigger, "end_local", end_local);
+    const cJSON *days = cJSON_GetObjectItemCaseSensitive(routine, "Days");
+    if (cJSON_IsArray(days)) {
+        cJSON_AddItemToObject(trigger, "days", cJSON_Duplicate(days, true));
+    }
+    cJSON *action = cJSON_CreateObject();
+    cJSON_AddStringToObject(action, "type", "somnus");
+    cJSON_AddStringToObject(action, "mode", "actions");
+    cJSON_AddStringToObject(action, "payload", payload);
+    cJSON_AddItemToArray(cJSON_AddArrayToObject(rule, "actions"), action);
+    cJSON_free(payload);
+    return rule;
+}
+
+esp_err_t routine_scheduler_update(const char *payload)
+{
+    if (!payload) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    ESP_RETURN_ON_FALSE(s_sched.store, ESP_ERR_INVALID_STATE, TAG, "not started");
+
+    cJSON *root = cJSON_Parse(payload);
+    const cJSON *list = cJSON_IsArray(root) ? cJSON_GetArrayItem(root, 0) : NULL;
+    if (!cJSON_IsObject(list)) {
+        list = NULL;
+    }
+    bool routines = false;
+    const cJSON *routine = NULL;
+    cJSON_ArrayForEach(routine, list) {
+        routines = routines || is_routine_key(routine->string);
+    }
+    if (!routines) {
+        cJSON_Delete(root);
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    cJSON *doc = cJSON_CreateObject();
+    cJSON_AddStringToObject(doc, "version", "somnus-routines");
+    cJSON *rules = cJSON_AddArrayToObject(doc, "rules");
+    cJSON_ArrayForEach(routine, list) {
+        cJSON *rule = is_routine_key(routine->string) ? routine_to_rule(routine) : NULL;
+        if (rule) {
+            cJSON_AddItemToArray(rules, rule);
+        }
+    }
+    char *json = rules ? cJSON_PrintUnformatted(doc) : NULL;
+    cJSON_Delete(doc);
+    cJSON_Delete(root);
+    ESP_RETURN_ON_FALSE(json, ESP_ERR_NO_MEM, TAG, "routine document");
+
+    bool changed = false;
+    esp_err_t err = rule_store_update(s_sched.store, RULE_STORE_SOURCE_AWS, json, NULL, &changed);
+    cJSON_free(json);
+    if (err == ESP_OK) {
+        ESP_LOGI(TAG, "Routines %s", changed ? "stored for local runs" : "unchanged");
+    }
+    return err;
+}
+
+// Runs with the routine store locked; the actions are run after it is released
+static void on_routine_due(const rule_t *rule, void *ctx)
+{
+    routine_due_t *due = (routine_due_t *)ctx;
+    for (uint8_t i = 0; i < rule->action_count; i++) {
+        const rule_action_t *action = &rule->actions[i];
+        if (action->type != RULE_ACTION_SOMNUS || !action->id) {
+            continue;
+        }
+        char *copy = due->count < MAX_DUE ? strdup(action->id) : NULL;
+        if (!copy) {
+            ESP_LOGE(TAG, "Routine %s skipped", rule->id);
+            continue;
+        }
+        strlcpy(due->id[due->count], rule->id, ROUTINE_ID_MAX);
+        due->actions[due->count++] = copy;
+    }
+}
+
+static void queue_report(const char *id, time_t at, esp_err_t err)
+{
+    if (s_sched.report_count == ROUTINE_SCHEDULER_MAX_REPORTS) {
+        ESP_LOGW(TAG, "Report of %s dropped unsent", s_sched.reports[0].id);
+        memmove(&s_sched.reports[0], &s_sched.reports[1],
+                (ROUTINE_SCHEDULER_MAX_REPORTS - 1) * sizeof(s_sched.reports[0]));
+        s_sched.report_count--;
+    }
+    routine_report_t *report = &s_sched.reports[s_sched.report_count++];
+    strlcpy(report->id, id, sizeof(report->id));
+    report->at = at;
+    report->err = err;
+}
+
+// Sends held reports in order until the MQTT service refuses one
+static void send_reports(void)
+{
+    size_t sent = 0;
+    while (sent < s_sched.report_count) {
+        const routine_report_t *report = &s_sched.reports[sent];
+        struct tm local;
+        localtime_r(&report->at, &local);
+        char when[24];
+        strftime(when, sizeof(when), "%Y-%m-%d %H:%M", &local);
+        char message[112];
+        snprintf(message, sizeof(message), "Routine %s ran on the device at %s: %s", report->id, when,
+                 report->err == ESP_OK ? "ok" : esp_err_to_name(report->err));
+        if (somnus_mqtt_publish_log(report->err == ESP_OK ? "INFO" : "WARN", message) != ESP_OK) {
+            break;
+        }
+        sent++;
+    }
+    if (sent > 0) {
+        s_sched.report_count -= sent;
+        memmove(&s_sched.reports[0], &s_sched.reports[sent], s_sched.report_count * sizeof(s_sched.reports[0]));
+    }
+}
+
+static void routine_task(void *arg)
+{
+    (void)arg;
+    while (true) {
+        struct timeval now;
+        gettimeofday(&now, NULL);
+        if (now.tv_sec < CLOCK_SET_AFTER) {
+            vTaskDelay(pdMS_TO_TICKS(CLOCK_WAIT_MS));
+            continue;
+        }
+        struct tm local;
+        localtime_r(&now.tv_sec, &local);
+        rule_sample_t sample = {
+            .minute_of_day = (int16_t)(local.tm_hour * 60 + local.tm_min),
+            .weekday = (uint8_t)((local.tm_wday + 6) % 7),
+        };
+        for (int i = 0; i < RULE_SENSOR_COUNT; i++) {
+            sample.values[i] = NAN;
+        }
+
+        // The wheel catches up on minutes missed while a long routine ran
+        routine_due_t due = {0};
+        rule_store_evaluate(s_sched.store, &sample, esp_timer_get_time() / 1000, on_routine_due, &due);
+        for (size_t i = 0; i < due.count; i++) {
+            ESP_LOGI(TAG, "Running %s", due.id[i]);
+            esp_err_t err = somnus_action_handler_process(due.actions[i], s_sched.scene);
+            free(due.actions[i]);
+            queue_report(due.id[i], now.tv_sec, err);
+        }
+        send_reports();
+
+        gettimeofday(&now, NULL);
+        int64_t into_minute_ms = (int64_t)(now.tv_sec % 60) * 1000 + now.tv_usec / 1000;
+        vTaskDelay(pdMS_TO_TICKS(60000 - into_minute_ms + MINUTE_GUARD_MS));
+    }
+}
+
+esp_err_t routine_scheduler_start(const routine_scheduler_config_t *cfg)
+{
+    ESP_RETURN_ON_FALSE(cfg, ESP_ERR_INVALID_ARG, TAG, "config");
+    if (s_sched.task) {
+        return ESP_OK;
+    }
+    rule_store_config_t store_cfg = {
+        .auto_flush = true,
+        .path = cfg->path ? cfg->path : DEFAULT_PATH,
+    };
+    ESP_RETURN_ON_ERROR(rule_store_init(&s_sched.store, &store_cfg), TAG, "routine store");
+    s_sched.scene = cfg->scene;
+    if (xTaskCreate(routine_task, "routines", TASK_STACK, NULL, 5, &s_sched.task) != pdPASS) {
+        rule_store_deinit(s_sched.store);
+        s_sched.store = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
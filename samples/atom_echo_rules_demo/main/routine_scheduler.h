@@ -0,0 +1,51 @@
+#pragma once
+
+#include "esp_err.h"
+#include "scene_controller.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Somnus routine lists kept on the device and run from its own clock, so
+ * bedtime and wake routines start on the minute whether or not the cloud
+ * is reachable.
+ *
+ * A routine list is translated into a rules document with one time_window
+ * rule per routine and handed to a second rule store (its own A/B slot
+ * files), so it is compiled by the rule engine, survives a reboot and is
+ * scheduled by the engine's minute wheel. Each routine is an object:
+ *
+ *     [{"SleepRoutine": {"StartTime": "22:30", "Days": ["Mon", "Tue"],
+ *                        "Actions": [{"Action": "LED", "Data": {...}, "Delay": 0}, ...]},
+ *       "WakeUpRoutine": {...}}]
+ *
+ * Days defaults to every day. The actions run through
+ * somnus_action_handler_process(), which drives the LEDs, audio and IR.
+ * Every run is reported on the Somnus log topic; runs while the MQTT
+ * service is down are held (up to ROUTINE_SCHEDULER_MAX_REPORTS) and sent
+ * once it is back.
+ */
+
+#define ROUTINE_SCHEDULER_MAX_REPORTS 16
+
+typedef struct {
+    scene_controller_t *scene;
+    const char *path;                 // NULL = STORAGE_PATH("routines.json")
+} routine_scheduler_config_t;
+
+// Load the stored routines and start the task that runs them
+esp_err_t routine_scheduler_start(const routine_scheduler_config_t *cfg);
+
+/**
+ * Replace the stored routines if payload is a routine list.
+ *
+ * @return ESP_ERR_NOT_SUPPORTED when it is not one, so the caller can
+ *         handle the payload another way
+ */
+esp_err_t routine_scheduler_update(const char *payload);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,706 @@
+#include "rule_engine.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cJSON.h"
+#include "esp_log.h"
+
+static const char *TAG = "rule_engine";
+
+// Time windows are hashed into the wheel by minute of day
+#define RULE_WHEEL_SLOTS 64
+// A clock step longer than this is treated as a jump and rescans instead
+#define RULE_WHEEL_MAX_STEP 120
+#define RULE_NONE 0xFFFF
+
+// One opening or closing of a time window, chained per wheel slot
+typedef struct {
+    uint16_t minute;
+    uint16_t rule;
+    uint16_t next;
+    bool opens;
+} rule_edge_t;
+
+// Rules, actions, conditions, indexes and strings share one allocation
+struct rule_set {
+    const char *version;
+    size_t count;
+    size_t size;                      // Bytes in the allocation
+    rule_t *rules;
+    uint16_t *fired;                  // Scratch for one event, a slot per rule
+
+    // Per channel, sensor_change rules sorted by quiet_lo and by quiet_hi
+    uint16_t channel_first[RULE_SENSOR_COUNT];
+    uint16_t channel_count[RULE_SENSOR_COUNT];
+    uint16_t *by_lo;
+    uint16_t *by_hi;
+
+    uint16_t *time_rules;
+    uint16_t time_rule_count;
+    rule_edge_t *edges;
+    uint16_t wheel[RULE_WHEEL_SLOTS];
+    int16_t minute;                   // Where the wheel stands, -1 = unknown
+};
+
+#define ALIGN8(n) (((n) + 7u) & ~(size_t)7u)
+
+static const char *const SENSOR_NAMES[] = {
+    [RULE_SENSOR_TEMP_C] = "temp_c",
+    [RULE_SENSOR_HUMIDITY_PCT] = "humidity_pct",
+    [RULE_SENSOR_PRESSURE_HPA] = "pressure_hpa",
+    [RULE_SENSOR_VOC_INDEX] = "voc_index",
+    [RULE_SENSOR_CO2_PPM] = "co2_ppm",
+    [RULE_SENSOR_PRESENCE] = "presence",
+    [RULE_SENSOR_TIME_LOCAL] = "time_local",
+};
+
+static const char *const OP_NAMES[] = {
+    [RULE_OP_EQ] = "==",
+    [RULE_OP_NE] = "!=",
+    [RULE_OP_LT] = "<",
+    [RULE_OP_LE] = "<=",
+    [RULE_OP_GT] = ">",
+    [RULE_OP_GE] = ">=",
+    [RULE_OP_IN_WINDOW] = "IN_WINDOW",
+};
+
+static const char *const DAY_NAMES[] = {"Mon", "Tue", "Wed", "Thu", "Fri", "Sat", "Sun"};
+
+typedef struct {
+    rule_t *rules;
+    rule_condition_t *conditions;
+    rule_action_t *actions;
+    char *strings;
+} cursor_t;
+
+static int lookup(const char *const *names, size_t count, const cJSON *item)
+{
+    if (!cJSON_IsString(item)) {
+        return -1;
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (names[i] && strcmp(names[i], item->valuestring) == 0) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+// "HH:MM" to minutes since midnight, -1 when malformed
+static int parse_minute(const cJSON *item)
+{
+    int hours = 0;
+    int minutes = 0;
+    if (!cJSON_IsString(item) || sscanf(item->valuestring, "%d:%d", &hours, &minutes) != 2 ||
+        hours < 0 || hours > 23 || minutes < 0 || minutes > 59) {
+        return -1;
+    }
+    return hours * 60 + minutes;
+}
+
+static size_t string_bytes(const cJSON *item)
+{
+    return cJSON_IsString(item) ? strlen(item->valuestring) + 1 : 0;
+}
+
+// Copy a JSON string into the set's pool; fallbacks are literals and stay as they are
+static const char *intern(cursor_t *cursor, const cJSON *item, const char *fallback)
+{
+    if (!cJSON_IsString(item)) {
+        return fallback;
+    }
+    size_t len = strlen(item->valuestring) + 1;
+    char *copy = cursor->strings;
+    memcpy(copy, item->valuestring, len);
+    cursor->strings += len;
+    return copy;
+}
+
+static double number_or(const cJSON *item, double fallback)
+{
+    return cJSON_IsNumber(item) ? item->valuedouble : fallback;
+}
+
+static bool compile_condition(const cJSON *item, rule_condition_t *out)
+{
+    int sensor = lookup(SENSOR_NAMES, sizeof(SENSOR_NAMES) / sizeof(SENSOR_NAMES[0]),
+                        cJSON_GetObjectItemCaseSensitive(item, "sensor"));
+    int op = lookup(OP_NAMES, sizeof(OP_NAMES) / sizeof(OP_NAMES[0]),
+                    cJSON_GetObjectItemCaseSensitive(item, "op"));
+    const cJSON *value = cJSON_GetObjectItemCaseSensitive(item, "value");
+    if (sensor < 0 || op < 0) {
+        return false;
+    }
+    out->sensor = (uint8_t)sensor;
+    out->op = (uint8_t)op;
+    if (op == RULE_OP_IN_WINDOW) {
+        int start = parse_minute(cJSON_GetObjectItemCaseSensitive(value, "start"));
+        int end = parse_minute(cJSON_GetObjectItemCaseSensitive(value, "end"));
+        if (sensor != RULE_SENSOR_TIME_LOCAL || start < 0 || end < 0) {
+            return false;
+        }
+        out->start_minute = (uint16_t)start;
+        out->end_minute = (uint16_t)end;
+        return true;
+    }
+    if (sensor == RULE_SENSOR_TIME_LOCAL) {
+        return false;
+    }
+    if (cJSON_IsBool(value)) {
+        out->value = cJSON_IsTrue(value) ? 1.0f : 0.0f;
+    } else if (cJSON_IsNumber(value)) {
+        out->value = (float)value->valuedouble;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+static bool compile_action(const cJSON *item, cursor_t *cursor, rule_action_t *out)
+{
+    const cJSON *type = cJSON_GetObjectItemCaseSensitive(item, "type");
+    const cJSON *mode = cJSON_GetObjectItemCaseSensitive(item, "mode");
+    if (!cJSON_IsString(type) || !cJSON_IsString(mode)) {
+        return false;
+    }
+    // Defaults match what the demo has always used for missing fields
+    if (strcmp(type->valuestring, "set_light") == 0) {
+        if (strcmp(mode->valuestring, "scene") == 0) {
+            out->type = RULE_ACTION_LIGHT_SCENE;
+            out->id = intern(cursor, cJSON_GetObjectItemCaseSensitive(item, "scene_id"), "warm_dim");
+            out->transition_ms = (uint32_t)number_or(cJSON_GetObjectItemCaseSensitive(item, "transition_ms"), 1000);
+            return true;
+        }
+        if (strcmp(mode->valuestring, "color") == 0) {
+            const cJSON *color = cJSON_GetObjectItemCaseSensitive(item, "color_rgb");
+            if (!cJSON_IsArray(color) || cJSON_GetArraySize(color) != 3) {
+                return false;
+            }
+            out->type = RULE_ACTION_LIGHT_COLOR;
+            for (int i = 0; i < 3; i++) {
+                out->rgb[i] = (uint8_t)number_or(cJSON_GetArrayItem(color, i), 0);
+            }
+            out->level = (float)number_or(cJSON_GetObjectItemCaseSensitive(item, "brightness"), 0.2);
+            out->transition_ms = (uint32_t)number_or(cJSON_GetObjectItemCaseSensitive(item, "transition_ms"), 500);
+            return true;
+        }
+        return false;
+    }
+    if (strcmp(type->valuestring, "set_sound") == 0) {
+        out->level = (float)number_or(cJSON_GetObjectItemCaseSensitive(item, "volume"), 0.25);
+        if (strcmp(mode->valuestring, "scene") == 0) {
+            out->type = RULE_ACTION_SOUND_SCENE;
+            out->id = intern(cursor, cJSON_GetObjectItemCaseSensitive(item, "scene_id"), "gentle_rain");
+            return true;
+        }
+        if (strcmp(mode->valuestring, "playlist") == 0) {
+            out->type = RULE_ACTION_SOUND_PLAYLIST;
+            out->id = intern(cursor, cJSON_GetObjectItemCaseSensitive(item, "playlist_id"), "default_playlist");
+            return true;
+        }
+    }
+    // Cached Somnus routines (routine_scheduler.h); the list stays JSON text until it runs
+    if (strcmp(type->valuestring, "somnus") == 0 && strcmp(mode->valuestring, "actions") == 0) {
+        const cJSON *payload = cJSON_GetObjectItemCaseSensitive(item, "payload");
+        if (!cJSON_IsString(payload)) {
+            return false;
+        }
+        out->type = RULE_ACTION_SOMNUS;
+        out->id = intern(cursor, payload, NULL);
+        return true;
+    }
+    return false;
+}
+
+static bool compile_trigger(const cJSON *trigger, rule_t *rule)
+{
+    const cJSON *type = cJSON_GetObjectItemCaseSensitive(trigger, "type");
+    if (!cJSON_IsString(type)) {
+        return false;
+    }
+    if (strcmp(type->valuestring, "time_window") == 0) {
+        int start = parse_minute(cJSON_GetObjectItemCaseSensitive(trigger, "start_local"));
+        int end = parse_minute(cJSON_GetObjectItemCaseSensitive(trigger, "end_local"));
+        if (start < 0 || end < 0) {
+            return false;
+        }
+        rule->trigger = RULE_TRIGGER_TIME_WINDOW;
+        rule->start_minute = (uint16_t)start;
+        rule->end_minute = (uint16_t)end;
+        const cJSON *days = cJSON_GetObjectItemCaseSensitive(trigger, "days");
+        rule->days = cJSON_IsArray(days) ? 0 : 0x7F;
+        const cJSON *day = NULL;
+        cJSON_ArrayForEach(day, days) {
+            int index = lookup(DAY_NAMES, 7, day);
+            if (index < 0) {
+                return false;
+            }
+            rule->days |= (uint8_t)(1u << index);
+        }
+        return true;
+    }
+    if (strcmp(type->valuestring, "sensor_change") == 0) {
+        int sensor = lookup(SENSOR_NAMES, RULE_SENSOR_COUNT, cJSON_GetObjectItemCaseSensitive(trigger, "sensor"));
+        if (sensor < 0) {
+            return false;
+        }
+        rule->trigger = RULE_TRIGGER_SENSOR_CHANGE;
+        rule->trigger_sensor = (uint8_t)sensor;
+        rule->min_delta = (float)number_or(cJSON_GetObjectItemCaseSensitive(trigger, "min_delta"), 0);
+        return true;
+    }
+    return false;
+}
+
+static void compile_rule(const cJSON *item, cursor_t *cursor, rule_t *rule)
+{
+    const cJSON *conditions = cJSON_GetObjectItemCaseSensitive(item, "conditions");
+    const cJSON *logic = cJSON_GetObjectItemCaseSensitive(conditions, "logic");
+    const cJSON *items = cJSON_GetObjectItemCaseSensitive(conditions, "items");
+    const cJSON *actions = cJSON_GetObjectItemCaseSensitive(item, "actions");
+    const cJSON *limits = cJSON_GetObjectItemCaseSensitive(item, "limits");
+
+    rule->id = intern(cursor, cJSON_GetObjectItemCaseSensitive(item, "id"), "<no-id>");
+    rule->enabled = !cJSON_IsFalse(cJSON_GetObjectItemCaseSensitive(item, "enabled"));
+    rule->match_any = cJSON_IsString(logic) && strcmp(logic->valuestring, "ANY") == 0;
+    rule->min_repeat_ms = (uint32_t)(number_or(cJSON_GetObjectItemCaseSensitive(limits, "min_repeat_sec"), 0) * 1000.0);
+    rule->last_fired_ms = -1;
+
+    bool valid = compile_trigger(cJSON_GetObjectItemCaseSensitive(item, "trigger"), rule);
+
+    rule->conditions = cursor->conditions;
+    const cJSON *entry = NULL;
+    cJSON_ArrayForEach(entry, items) {
+        valid = compile_condition(entry, cursor->conditions++) && valid;
+        rule->condition_count++;
+    }
+    rule->actions = cursor->actions;
+    cJSON_ArrayForEach(entry, actions) {
+        valid = compile_action(entry, cursor, cursor->actions++) && valid;
+        rule->action_count++;
+    }
+
+    if (!valid && rule->enabled) {
+        ESP_LOGW(TAG, "Rule %s uses unsupported triggers, conditions or actions; disabled", rule->id);
+        rule->enabled = false;
+    }
+}
+
+static void build_indexes(rule_set_t *set)
+{
+    // Channels get contiguous runs of by_lo/by_hi; every rule starts
+    // unprimed with an empty band, so the order within a run is arbitrary
+    uint16_t next = 0;
+    for (int channel = 0; channel < RULE_SENSOR_COUNT; channel++) {
+        set->channel_first[channel] = next;
+        for (size_t i = 0; i < set->count; i++) {
+            rule_t *rule = &set->rules[i];
+            if (rule->enabled && rule->trigger == RULE_TRIGGER_SENSOR_CHANGE && rule->trigger_sensor == channel) {
+                rule->quiet_lo = INFINITY;
+                rule->quiet_hi = -INFINITY;
+                set->by_lo[next] = (uint16_t)i;
+                set->by_hi[next] = (uint16_t)i;
+                next++;
+            }
+        }
+        set->channel_count[channel] = (uint16_t)(next - set->channel_first[channel]);
+    }
+
+    for (int slot = 0; slot < RULE_WHEEL_SLOTS; slot++) {
+        set->wheel[slot] = RULE_NONE;
+    }
+    uint16_t edges = 0;
+    for (size_t i = 0; i < set->count; i++) {
+        const rule_t *rule = &set->rules[i];
+        if (!rule->enabled || rule->trigger != RULE_TRIGGER_TIME_WINDOW || rule->start_minute == rule->end_minute) {
+            continue;
+        }
+        set->time_rules[set->time_rule_count++] = (uint16_t)i;
+        for (int k = 0; k < 2; k++) {
+            rule_edge_t *edge = &set->edges[edges];
+            edge->opens = k == 0;
+            edge->minute = edge->opens ? rule->start_minute : rule->end_minute;
+            edge->rule = (uint16_t)i;
+            edge->next = set->wheel[edge->minute % RULE_WHEEL_SLOTS];
+            set->wheel[edge->minute % RULE_WHEEL_SLOTS] = edges++;
+        }
+    }
+    set->minute = -1;
+}
+
+esp_err_t rule_set_compile(const char *json, rule_set_t **out_set)
+{
+    if (!json || !out_set) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *out_set = NULL;
+
+    cJSON *root = NULL;
+    const cJSON *rules = NULL;
+    if (json[strspn(json, " \t\r\n")] != '\0') {
+        root = cJSON_Parse(json);
+        rules = cJSON_GetObjectItemCaseSensitive(root, "rules");
+        if (!cJSON_IsArray(rules)) {
+            ESP_LOGW(TAG, "Rules document %s", root ? "has no rules array" : "is not valid JSON");
+            cJSON_Delete(root);
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+    const cJSON *version = cJSON_GetObjectItemCaseSensitive(root, "version");
+
+    // First pass sizes the single allocation
+    size_t rule_count = 0;
+    size_t condition_count = 0;
+    size_t action_count = 0;
+    size_t sensor_rules = 0;
+    size_t time_rules = 0;
+    size_t strings = string_bytes(version);
+    const cJSON *rule = NULL;
+    cJSON_ArrayForEach(rule, rules) {
+        int conditions = cJSON_GetArraySize(cJSON_GetObjectItemCaseSensitive(
+            cJSON_GetObjectItemCaseSensitive(rule, "conditions"), "items"));
+        const cJSON *actions = cJSON_GetObjectItemCaseSensitive(rule, "actions");
+        if (conditions > UINT8_MAX || cJSON_GetArraySize(actions) > UINT8_MAX) {
+            ESP_LOGW(TAG, "Rule has more than %d conditions or actions", UINT8_MAX);
+            cJSON_Delete(root);
+            return ESP_ERR_INVALID_SIZE;
+        }
+        const cJSON *type = cJSON_GetObjectItemCaseSensitive(cJSON_GetObjectItemCaseSensitive(rule, "trigger"), "type");
+        if (cJSON_IsString(type)) {
+            sensor_rules += strcmp(type->valuestring, "sensor_change") == 0;
+            time_rules += strcmp(type->valuestring, "time_window") == 0;
+        }
+        rule_count++;
+        condition_count += (size_t)conditions;
+        action_count += (size_t)cJSON_GetArraySize(actions);
+        strings += string_bytes(cJSON_GetObjectItemCaseSensitive(rule, "id"));
+        if (rule_count >= RULE_NONE) {
+            ESP_LOGW(TAG, "More than %d rules", RULE_NONE - 1);
+            cJSON_Delete(root);
+            return ESP_ERR_INVALID_SIZE;
+        }
+        const cJSON *action = NULL;
+        cJSON_ArrayForEach(action, actions) {
+            strings += string_bytes(cJSON_GetObjectItemCaseSensitive(action, "scene_id"));
+            strings += string_bytes(cJSON_GetObjectItemCaseSensitive(action, "playlist_id"));
+            strings += string_bytes(cJSON_GetObjectItemCaseSensitive(action, "payload"));
+        }
+    }
+
+    size_t rules_offset = ALIGN8(sizeof(rule_set_t));
+    size_t actions_offset = rules_offset + ALIGN8(rule_count * sizeof(rule_t));
+    size_t conditions_offset = actions_offset + ALIGN8(action_count * sizeof(rule_action_t));
+    size_t edges_offset = conditions_offset + ALIGN8(condition_count * sizeof(rule_condition_t));
+    size_t fired_offset = edges_offset + ALIGN8(2 * time_rules * sizeof(rule_edge_t));
+    size_t by_lo_offset = fired_offset + ALIGN8(rule_count * sizeof(uint16_t));
+    size_t by_hi_offset = by_lo_offset + ALIGN8(sensor_rules * sizeof(uint16_t));
+    size_t time_rules_offset = by_hi_offset + ALIGN8(sensor_rules * sizeof(uint16_t));
+    size_t strings_offset = time_rules_offset + ALIGN8(time_rules * sizeof(uint16_t));
+    uint8_t *block = calloc(1, strings_offset + strings);
+    if (!block) {
+        cJSON_Delete(root);
+        return ESP_ERR_NO_MEM;
+    }
+
+    rule_set_t *set = (rule_set_t *)block;
+    cursor_t cursor = {
+        .rules = (rule_t *)(block + rules_offset),
+        .actions = (rule_action_t *)(block + actions_offset),
+        .conditions = (rule_condition_t *)(block + conditions_offset),
+        .strings = (char *)(block + strings_offset),
+    };
+    set->rules = cursor.rules;
+    set->count = rule_count;
+    set->size = strings_offset + strings;
+    set->fired = (uint16_t *)(block + fired_offset);
+    set->by_lo = (uint16_t *)(block + by_lo_offset);
+    set->by_hi = (uint16_t *)(block + by_hi_offset);
+    set->time_rules = (uint16_t *)(block + time_rules_offset);
+    set->edges = (rule_edge_t *)(block + edges_offset);
+    set->version = intern(&cursor, version, "unknown");
+    cJSON_ArrayForEach(rule, rules) {
+        compile_rule(rule, &cursor, cursor.rules++);
+    }
+    cJSON_Delete(root);
+    build_indexes(set);
+
+    ESP_LOGI(TAG, "Compiled %zu rules (%zu conditions, %zu actions) into %zu bytes",
+             rule_count, condition_count, action_count, strings_offset + strings);
+    *out_set = set;
+    return ESP_OK;
+}
+
+void rule_set_free(rule_set_t *set)
+{
+    free(set);
+}
+
+const char *rule_set_version(const rule_set_t *set)
+{
+    return set ? set->version : NULL;
+}
+
+size_t rule_set_count(const rule_set_t *set)
+{
+    return set ? set->count : 0;
+}
+
+size_t rule_set_size(const rule_set_t *set)
+{
+    return set ? set->size : 0;
+}
+
+const rule_t *rule_set_get(const rule_set_t *set, size_t index)
+{
+    return set && index < set->count ? &set->rules[index] : NULL;
+}
+
+static bool in_window(int minute, uint16_t start, uint16_t end)
+{
+    if (start <= end) {
+        return minute >= start && minute < end;
+    }
+    return minute >= start || minute < end;
+}
+
+static bool condition_holds(const rule_condition_t *condition, const rule_sample_t *sample)
+{
+    if (condition->op == RULE_OP_IN_WINDOW) {
+        return sample->minute_of_day >= 0 &&
+               in_window(sample->minute_of_day, condition->start_minute, condition->end_minute);
+    }
+    if (condition->sensor >= RULE_SENSOR_COUNT) {
+        return false;
+    }
+    float value = sample->values[condition->sensor];
+    if (isnan(value)) {
+        return false;
+    }
+    switch (condition->op) {
+    case RULE_OP_EQ:
+        return value == condition->value;
+    case RULE_OP_NE:
+        return value != condition->value;
+    case RULE_OP_LT:
+        return value < condition->value;
+    case RULE_OP_LE:
+        return value <= condition->value;
+    case RULE_OP_GT:
+        return value > condition->value;
+    case RULE_OP_GE:
+        return value >= condition->value;
+    default:
+        return false;
+    }
+}
+
+static int compare_index(const void *a, const void *b)
+{
+    return (int)*(const uint16_t *)a - (int)*(const uint16_t *)b;
+}
+
+// Conditions, repeat limit and callback for rules whose trigger fired
+static size_t finish(rule_set_t *set,
+                     size_t count,
+                     const rule_sample_t *sample,
+                     int64_t now_ms,
+                     rule_fire_cb_t callback,
+                     void *ctx)
+{
+    qsort(set->fired, count, sizeof(uint16_t), compare_index);
+    size_t fired = 0;
+    for (size_t i = 0; i < count; i++) {
+        rule_t *rule = &set->rules[set->fired[i]];
+        bool holds = rule->condition_count == 0 || !rule->match_any;
+        for (uint8_t c = 0; c < rule->condition_count; c++) {
+            if (condition_holds(&rule->conditions[c], sample) == rule->match_any) {
+                holds = rule->match_any;
+                break;
+            }
+        }
+        if (!holds) {
+            continue;
+        }
+        if (rule->last_fired_ms >= 0 && now_ms - rule->last_fired_ms < (int64_t)rule->min_repeat_ms) {
+            continue;
+        }
+        rule->last_fired_ms = now_ms;
+        fired++;
+        if (callback) {
+            callback(rule, ctx);
+        }
+    }
+    return fired;
+}
+
+static float band_key(const rule_t *rule, bool lo)
+{
+    return lo ? rule->quiet_lo : rule->quiet_hi;
+}
+
+// First position in a sorted run whose key is >= value, or > value when past_equal
+static size_t bound(const rule_set_t *set, const uint16_t *run, size_t count, float value, bool lo, bool past_equal)
+{
+    size_t first = 0;
+    while (count > 0) {
+        size_t half = count / 2;
+        float key = band_key(&set->rules[run[first + half]], lo);
+        if (key < value || (past_equal && key == value)) {
+            first += half + 1;
+            count -= half + 1;
+        } else {
+            count = half;
+        }
+    }
+    return first;
+}
+
+// Give one rule a new key and move it to its sorted place
+static void rekey(rule_set_t *set, uint16_t *run, size_t count, uint16_t index, bool lo, float key)
+{
+    rule_t *rule = &set->rules[index];
+    size_t at = bound(set, run, count, band_key(rule, lo), lo, false);
+    while (run[at] != index) {
+        at++;  // Past other rules with the same key
+    }
+    if (lo) {
+        rule->quiet_lo = key;
+    } else {
+        rule->quiet_hi = key;
+    }
+    while (at > 0 && band_key(&set->rules[run[at - 1]], lo) > key) {
+        run[at] = run[at - 1];
+        at--;
+    }
+    while (at + 1 < count && band_key(&set->rules[run[at + 1]], lo) < key) {
+        run[at] = run[at + 1];
+        at++;
+    }
+    run[at] = index;
+}
+
+size_t rule_set_on_sensor(rule_set_t *set,
+                          rule_sensor_t sensor,
+                          const rule_sample_t *sample,
+                          int64_t now_ms,
+                          rule_fire_cb_t callback,
+                          void *ctx)
+{
+    if (!set || !sample || sensor >= RULE_SENSOR_COUNT || set->channel_count[sensor] == 0) {
+        return 0;
+    }
+    float value = sample->values[sensor];
+    if (isnan(value)) {
+        return 0;
+    }
+    uint16_t *by_lo = set->by_lo + set->channel_first[sensor];
+    uint16_t *by_hi = set->by_hi + set->channel_first[sensor];
+    size_t run = set->channel_count[sensor];
+
+    // A rule fires when value <= quiet_lo or value >= quiet_hi: a suffix of
+    // by_lo and a prefix of by_hi. Unprimed rules sit at both ends.
+    size_t count = 0;
+    for (size_t i = bound(set, by_lo, run, value, true, false); i < run; i++) {
+        set->fired[count++] = by_lo[i];
+    }
+    size_t hi_end = bound(set, by_hi, run, value, false, true);
+    for (size_t i = 0; i < hi_end; i++) {
+        if (set->rules[by_hi[i]].quiet_lo < value) {  // Otherwise already taken from by_lo
+            set->fired[count++] = by_hi[i];
+        }
+    }
+    if (count == 0) {
+        return 0;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        const rule_t *rule = &set->rules[set->fired[i]];
+        rekey(set, by_lo, run, set->fired[i], true, value - rule->min_delta);
+        rekey(set, by_hi, run, set->fired[i], false, value + rule->min_delta);
+    }
+    return finish(set, count, sample, now_ms, callback, ctx);
+}
+
+static bool window_open(const rule_t *rule, const rule_sample_t *sample)
+{
+    return sample->weekday < 7 && (rule->days & (1u << sample->weekday)) &&
+           in_window(sample->minute_of_day, rule->start_minute, rule->end_minute);
+}
+
+size_t rule_set_on_time(rule_set_t *set,
+                        const rule_sample_t *sample,
+                        int64_t now_ms,
+                        rule_fire_cb_t callback,
+                        void *ctx)
+{
+    if (!set || !sample || set->time_rule_count == 0 || sample->minute_of_day == set->minute) {
+        return 0;
+    }
+    size_t count = 0;
+    int step = set->minute < 0 || sample->minute_of_day < 0
+                   ? -1
+                   : (sample->minute_of_day - set->minute + 24 * 60) % (24 * 60);
+
+    if (step < 0 || step > RULE_WHEEL_MAX_STEP) {
+        // Clock set, cleared or jumped: compare every window against now
+        for (uint16_t i = 0; i < set->time_rule_count; i++) {
+            rule_t *rule = &set->rules[set->time_rules[i]];
+            bool open = sample->minute_of_day >= 0 && window_open(rule, sample);
+            if (open && !rule->in_window) {
+                set->fired[count++] = set->time_rules[i];
+            }
+            rule->in_window = open;
+        }
+    } else {
+        // Only edges in the minutes just passed; each slot holds ~1/64 of them
+        for (int m = 1; m <= step; m++) {
+            int minute = (set->minute + m) % (24 * 60);
+            for (uint16_t e = set->wheel[minute % RULE_WHEEL_SLOTS]; e != RULE_NONE; e = set->edges[e].next) {
+                const rule_edge_t *edge = &set->edges[e];
+                if (edge->minute != minute) {
+                    continue;
+                }
+                rule_t *rule = &set->rules[edge->rule];
+                if (!edge->opens) {
+                    rule->in_window = false;
+                } else if (!rule->in_window && sample->weekday < 7 && (rule->days & (1u << sample->weekday))) {
+                    rule->in_window = true;
+                    set->fired[count++] = edge->rule;
+                }
+            }
+        }
+    }
+    set->minute = sample->minute_of_day;
+    return count ? finish(set, count, sample, now_ms, callback, ctx) : 0;
+}
+
+size_t rule_set_evaluate(rule_set_t *set,
+                         const rule_sample_t *sample,
+                         int64_t now_ms,
+                         rule_fire_cb_t callback,
+                         void *ctx)
+{
+    if (!set || !sample) {
+        return 0;
+    }
+    size_t fired = rule_set_on_time(set, sample, now_ms, callback, ctx);
+    for (int sensor = 0; sensor < RULE_SENSOR_COUNT; sensor++) {
+        fired += rule_set_on_sensor(set, (rule_sensor_t)sensor, sample, now_ms, callback, ctx);
+    }
+    return fired;
+}
+
+const char *rule_trigger_name(rule_trigger_type_t trigger)
+{
+    switch (trigger) {
+    case RULE_TRIGGER_TIME_WINDOW:
+        return "time_window";
+    case RULE_TRIGGER_SENSOR_CHANGE:
+        return "sensor_change";
+    default:
+        return "<unsupported>";
+    }
+}
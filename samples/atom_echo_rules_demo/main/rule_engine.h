@@ -0,0 +1,168 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Rule sets compiled from the rules JSON into flat tables of triggers,
+ * conditions and actions. Compiling happens once per rule set update;
+ * evaluating a sample only walks the tables, with no parsing or heap use,
+ * so it can run on every sensor tick.
+ *
+ * Triggers are indexed so the cost of an event does not grow with the
+ * number of rules: sensor_change rules sit in per-channel interval indexes
+ * and only those whose band the new reading leaves are visited, and
+ * time_window rules hang off a timer wheel so a clock tick only visits the
+ * windows that open or close in the elapsed minutes.
+ */
+
+typedef enum {
+    RULE_SENSOR_TEMP_C = 0,
+    RULE_SENSOR_HUMIDITY_PCT,
+    RULE_SENSOR_PRESSURE_HPA,
+    RULE_SENSOR_VOC_INDEX,
+    RULE_SENSOR_CO2_PPM,
+    RULE_SENSOR_PRESENCE,             // 1 = someone present
+    RULE_SENSOR_COUNT,
+    RULE_SENSOR_TIME_LOCAL = RULE_SENSOR_COUNT,  // Conditions only; read from minute_of_day
+    RULE_SENSOR_UNKNOWN,
+} rule_sensor_t;
+
+typedef struct {
+    float values[RULE_SENSOR_COUNT];  // NAN where there is no reading
+    int16_t minute_of_day;            // Local time, -1 while the clock is unset
+    uint8_t weekday;                  // 0 = Monday
+} rule_sample_t;
+
+typedef enum {
+    RULE_TRIGGER_NONE = 0,            // Never fires; unknown trigger types compile to this
+    RULE_TRIGGER_TIME_WINDOW,         // Fires on entering the window
+    RULE_TRIGGER_SENSOR_CHANGE,       // Fires when the sensor leaves min_delta around where it last fired
+} rule_trigger_type_t;
+
+typedef enum {
+    RULE_OP_EQ = 0,
+    RULE_OP_NE,
+    RULE_OP_LT,
+    RULE_OP_LE,
+    RULE_OP_GT,
+    RULE_OP_GE,
+    RULE_OP_IN_WINDOW,
+} rule_op_t;
+
+typedef struct {
+    uint8_t sensor;                   // rule_sensor_t
+    uint8_t op;                       // rule_op_t
+    float value;
+    uint16_t start_minute;            // IN_WINDOW only; windows may wrap midnight
+    uint16_t end_minute;
+} rule_condition_t;
+
+typedef enum {
+    RULE_ACTION_LIGHT_SCENE = 0,
+    RULE_ACTION_LIGHT_COLOR,
+    RULE_ACTION_SOUND_SCENE,
+    RULE_ACTION_SOUND_PLAYLIST,
+    RULE_ACTION_SOMNUS,               // A Somnus action list, run by somnus_action_handler
+} rule_action_type_t;
+
+typedef struct {
+    uint8_t type;                     // rule_action_type_t
+    uint8_t rgb[3];                   // LIGHT_COLOR
+    float level;                      // Brightness for LIGHT_COLOR, volume for sounds
+    uint32_t transition_ms;           // Lights only
+    const char *id;                   // Scene or playlist id; SOMNUS: the action list JSON
+} rule_action_t;
+
+typedef struct {
+    const char *id;
+    bool enabled;
+    bool match_any;                   // Conditions combine with ANY instead of ALL
+    uint8_t trigger;                  // rule_trigger_type_t
+    uint8_t trigger_sensor;           // SENSOR_CHANGE
+    uint8_t days;                     // TIME_WINDOW; bit 0 = Monday
+    uint16_t start_minute;            // TIME_WINDOW
+    uint16_t end_minute;
+    float min_delta;                  // SENSOR_CHANGE
+    uint32_t min_repeat_ms;
+    const rule_condition_t *conditions;
+    uint8_t condition_count;
+    const rule_action_t *actions;
+    uint8_t action_count;
+
+    // Evaluation state
+    bool in_window;
+    float quiet_lo;                   // SENSOR_CHANGE: fires at or beyond these, +-INF before the first reading
+    float quiet_hi;
+    int64_t last_fired_ms;
+} rule_t;
+
+typedef struct rule_set rule_set_t;
+
+/**
+ * Compile a rules document. An empty string compiles to an empty set;
+ * malformed JSON or a document without a rules array is rejected. Rules
+ * with parts the engine does not know are kept but disabled.
+ */
+esp_err_t rule_set_compile(const char *json, rule_set_t **out_set);
+void rule_set_free(rule_set_t *set);
+
+const char *rule_set_version(const rule_set_t *set);
+size_t rule_set_count(const rule_set_t *set);
+// Heap the compiled set holds, tables and strings included
+size_t rule_set_size(const rule_set_t *set);
+const rule_t *rule_set_get(const rule_set_t *set, size_t index);
+
+// Called for each rule that fires, in document order within one event
+typedef void (*rule_fire_cb_t)(const rule_t *rule, void *ctx);
+
+/**
+ * A new reading of one channel: visits only the sensor_change rules on that
+ * channel whose band it leaves. Conditions see the whole sample.
+ *
+ * @return Number of rules that fired
+ */
+size_t rule_set_on_sensor(rule_set_t *set,
+                          rule_sensor_t sensor,
+                          const rule_sample_t *sample,
+                          int64_t now_ms,
+                          rule_fire_cb_t callback,
+                          void *ctx);
+
+/**
+ * Advance the timer wheel to the sample's minute_of_day and fire the
+ * time_window rules that opened since the last call. A clock that jumps
+ * more than a wheel turn, or was unset, rescans the time rules once.
+ *
+ * @return Number of rules that fired
+ */
+size_t rule_set_on_time(rule_set_t *set,
+                        const rule_sample_t *sample,
+                        int64_t now_ms,
+                        rule_fire_cb_t callback,
+                        void *ctx);
+
+/**
+ * Both of the above for a full sample: the clock, then every channel that
+ * has a reading
+ *
+ * @return Number of rules that fired
+ */
+size_t rule_set_evaluate(rule_set_t *set,
+                         const rule_sample_t *sample,
+                         int64_t now_ms,
+                         rule_fire_cb_t callback,
+                         void *ctx);
+
+const char *rule_trigger_name(rule_trigger_type_t trigger);
+
+#ifdef __cplusplus
+}
+#endif
@@ -5,20 +5,65 @@
 #include <stdlib.h>
 #include <string.h>
 #include <strings.h>
+#include <unistd.h>
 
 #include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
 #include "mbedtls/md.h"
+#include "storage.h"
+
+struct rule_store_blob {
+    uint32_t refs;
+    size_t len;
+    char json[];
+};
 
 struct rule_store {
     rule_store_config_t cfg;
-    char *json;
+    rule_store_blob_t *blob;  // Current document; snapshots hold their own references
     char sha256[65];
+    rule_set_t *rules;        // Compiled from json, cached alongside its sha256
+    SemaphoreHandle_t lock;   // Updates and evaluation come from different tasks
     rule_store_observer_cb_t observer;
     void *observer_ctx;
+    uint32_t seq;             // Sequence number of the newest slot on disk
+    int slot;                 // Slot holding seq, -1 before the first slot write
+    bool dirty;               // Document newer than anything persisted
+    bool legacy;              // Loaded from a pre-slot rules file at path, removed after the first slot write
 };
 
 static const char *TAG = "rule_store";
-static const char *DEFAULT_SPIFFS_PATH = "/spiffs/rules.json";
+static const char *DEFAULT_PATH = STORAGE_PATH("rules.json");
+static const char *SLOT_MAGIC = "NRS1";
+
+static rule_store_blob_t *blob_create(const char *json, size_t len)
+{
+    rule_store_blob_t *blob = malloc(sizeof(*blob) + len + 1);
+    if (!blob) {
+        return NULL;
+    }
+    blob->refs = 1;
+    blob->len = len;
+    memcpy(blob->json, json, len);
+    blob->json[len] = '\0';
+    return blob;
+}
+
+static rule_store_blob_t *blob_ref(rule_store_blob_t *blob)
+{
+    if (blob) {
+        __atomic_add_fetch(&blob->refs, 1, __ATOMIC_RELAXED);
+    }
+    return blob;
+}
+
+static void blob_unref(rule_store_blob_t *blob)
+{
+    if (blob && __atomic_sub_fetch(&blob->refs, 1, __ATOMIC_ACQ_REL) == 0) {
+        free(blob);
+    }
+}
 
 static void compute_sha256_hex(const char *json, char out_hex[65])
 {
@@ -45,64 +90,210 @@ static void compute_sha256_hex(const char *json, char out_hex[65])
     out_hex[64] = '\0';
 }
 
-static esp_err_t load_from_disk(rule_store_t *store)
+static const char *base_path(const rule_store_t *store)
+{
+    return store->cfg.path ? store->cfg.path : DEFAULT_PATH;
+}
+
+static void slot_path(const char *base, int slot, char *out, size_t out_len)
+{
+    snprintf(out, out_len, "%s.%d", base, slot);
+}
+
+// Reads count bytes after the current position into a fresh blob
+static rule_store_blob_t *read_blob(FILE *f, size_t count)
 {
-    const char *path = store->cfg.spiffs_path ? store->cfg.spiffs_path : DEFAULT_SPIFFS_PATH;
+    rule_store_blob_t *blob = malloc(sizeof(*blob) + count + 1);
+    if (!blob) {
+        return NULL;
+    }
+    if (fread(blob->json, 1, count, f) != count) {
+        free(blob);
+        return NULL;
+    }
+    blob->refs = 1;
+    blob->len = count;
+    blob->json[count] = '\0';
+    return blob;
+}
+
+/**
+ * Load one slot file. Returns NULL for a missing slot or one whose header,
+ * length or digest does not check out, e.g. a write cut short by power loss.
+ */
+static rule_store_blob_t *load_slot(const char *base, int slot, uint32_t *out_seq, char out_sha[65])
+{
+    char path[96];
+    slot_path(base, slot, path, sizeof(path));
     FILE *f = fopen(path, "rb");
     if (!f) {
-        ESP_LOGW(TAG, "Rules file not found at %s", path);
-        return ESP_ERR_NOT_FOUND;
-    }
-    if (fseek(f, 0, SEEK_END) != 0) {
-        fclose(f);
-        return ESP_FAIL;
-    }
-    long size = ftell(f);
-    if (size < 0) {
-        fclose(f);
-        return ESP_FAIL;
-    }
-    rewind(f);
-    char *buf = calloc((size_t)size + 1, 1);
-    if (!buf) {
-        fclose(f);
-        return ESP_ERR_NO_MEM;
+        return NULL;
+    }
+    char magic[5];
+    unsigned seq = 0;
+    size_t len = 0;
+    char sha[65];
+    rule_store_blob_t *blob = NULL;
+    if (fscanf(f, "%4s %u %zu %64s", magic, &seq, &len, sha) == 4 &&
+        strcmp(magic, SLOT_MAGIC) == 0 && fgetc(f) == '\n') {
+        blob = read_blob(f, len);
+    }
+    bool trailing = blob && fgetc(f) != EOF;
+    fclose(f);
+    if (!blob) {
+        ESP_LOGW(TAG, "Rules slot %s is incomplete", path);
+        return NULL;
+    }
+    compute_sha256_hex(blob->json, out_sha);
+    if (trailing || strlen(blob->json) != len || strcasecmp(out_sha, sha) != 0) {
+        ESP_LOGW(TAG, "Rules slot %s fails its checksum", path);
+        blob_unref(blob);
+        return NULL;
+    }
+    *out_seq = seq;
+    return blob;
+}
+
+// Rules files written before the slot scheme, and the seed: the whole file is the document
+static rule_store_blob_t *load_plain(const char *path)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        return NULL;
+    }
+    rule_store_blob_t *blob = NULL;
+    long size = -1;
+    if (fseek(f, 0, SEEK_END) == 0) {
+        size = ftell(f);
+    }
+    if (size >= 0) {
+        rewind(f);
+        blob = read_blob(f, (size_t)size);
     }
-    size_t read = fread(buf, 1, (size_t)size, f);
     fclose(f);
-    if (read != (size_t)size) {
-        free(buf);
-        return ESP_FAIL;
-    }
-    free(store->json);
-    store->json = buf;
-    compute_sha256_hex(store->json, store->sha256);
-    ESP_LOGI(TAG, "Loaded rules (%zu bytes) sha=%s", read, store->sha256);
+    if (blob) {
+        ESP_LOGI(TAG, "Migrating rules from %s", path);
+    }
+    return blob;
+}
+
+// Newest valid slot under base, or NULL
+static rule_store_blob_t *load_slots(rule_store_t *store, const char *base, char sha[65])
+{
+    rule_store_blob_t *blob = NULL;
+    for (int slot = 0; slot < 2; slot++) {
+        uint32_t seq = 0;
+        char slot_sha[65];
+        rule_store_blob_t *candidate = load_slot(base, slot, &seq, slot_sha);
+        if (!candidate) {
+            continue;
+        }
+        // Sequence numbers only ever step by one, so wrap-safe compare
+        if (!blob || (int32_t)(seq - store->seq) > 0) {
+            blob_unref(blob);
+            blob = candidate;
+            store->seq = seq;
+            store->slot = slot;
+            memcpy(sha, slot_sha, 65);
+        } else {
+            blob_unref(candidate);
+        }
+    }
+    return blob;
+}
+
+static esp_err_t load_from_disk(rule_store_t *store)
+{
+    char sha[65];
+    rule_store_blob_t *blob = load_slots(store, base_path(store), sha);
+    if (!blob) {
+        blob = load_plain(base_path(store));
+        store->legacy = blob != NULL;
+        const char *seed = store->cfg.seed_path;
+        if (!blob && seed) {
+            // Slots an older build kept beside the seed still hold newer rules than the seed itself
+            blob = load_slots(store, seed, sha);
+            store->slot = -1;
+            if (!blob) {
+                blob = load_plain(seed);
+                if (blob) {
+                    compute_sha256_hex(blob->json, sha);
+                }
+            }
+        } else if (blob) {
+            compute_sha256_hex(blob->json, sha);
+        }
+        if (!blob) {
+            ESP_LOGW(TAG, "Rules file not found at %s", base_path(store));
+            return ESP_ERR_NOT_FOUND;
+        }
+        store->dirty = true;
+    }
+
+    rule_set_t *rules = NULL;
+    if (rule_set_compile(blob->json, &rules) != ESP_OK) {
+        // Keep the file so it can be inspected or replaced; it just runs no rules
+        ESP_LOGW(TAG, "Stored rules do not compile; running without rules");
+        rules = NULL;
+    }
+    blob_unref(store->blob);
+    store->blob = blob;
+    rule_set_free(store->rules);
+    store->rules = rules;
+    memcpy(store->sha256, sha, sizeof(sha));
+    ESP_LOGI(TAG, "Loaded rules (%zu bytes) sha=%s", blob->len, store->sha256);
     return ESP_OK;
 }
 
+/**
+ * Write the current document to the slot not holding the newest copy. The
+ * other slot is never touched, and storage_write_atomic() replaces this one
+ * whole or not at all, so the previous rules remain loadable throughout.
+ */
 static esp_err_t flush_to_disk(rule_store_t *store)
 {
     if (!store->cfg.auto_flush) {
         return ESP_OK;
     }
-    const char *path = store->cfg.spiffs_path ? store->cfg.spiffs_path : DEFAULT_SPIFFS_PATH;
-    FILE *f = fopen(path, "wb");
-    if (!f) {
-        ESP_LOGE(TAG, "Failed to open %s for writing", path);
-        return ESP_FAIL;
-    }
-    size_t len = store->json ? strlen(store->json) : 0;
-    size_t written = len > 0 ? fwrite(store->json, 1, len, f) : 0;
-    fclose(f);
-    if (len != written) {
-        ESP_LOGE(TAG, "Short write: expected %zu, wrote %zu", len, written);
-        return ESP_FAIL;
+    int slot = store->slot == 0 ? 1 : 0;
+    uint32_t seq = store->seq + 1;
+    char path[96];
+    slot_path(base_path(store), slot, path, sizeof(path));
+    size_t len = store->blob->len;
+    char header[96];
+    int header_len = snprintf(header, sizeof(header), "%s %u %zu %s\n", SLOT_MAGIC, (unsigned)seq, len,
+                              store->sha256);
+    char *data = malloc(header_len + len);
+    if (!data) {
+        return ESP_ERR_NO_MEM;
     }
-    ESP_LOGI(TAG, "Persisted rules to %s (%zu bytes)", path, len);
+    memcpy(data, header, header_len);
+    memcpy(data + header_len, store->blob->json, len);
+    esp_err_t err = storage_write_atomic(path, data, header_len + len);
+    free(data);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to write %s: %s", path, esp_err_to_name(err));
+        return err;
+    }
+    store->slot = slot;
+    store->seq = seq;
+    store->dirty = false;
+    if (store->legacy) {
+        remove(base_path(store));
+        store->legacy = false;
+    }
+    ESP_LOGI(TAG, "Persisted rules to %s (%zu bytes, seq %u)", path, len, (unsigned)seq);
     return ESP_OK;
 }
 
+static void fill_snapshot(const rule_store_t *store, rule_store_snapshot_t *snapshot)
+{
+    snapshot->json = store->blob ? store->blob->json : NULL;
+    snapshot->rules = store->rules;
+    snapshot->blob = NULL;
+    memcpy(snapshot->sha256, store->sha256, sizeof(store->sha256));
+}
+
 esp_err_t rule_store_init(rule_store_t **out_store, const rule_store_config_t *cfg)
 {
     if (!out_store) {
@@ -114,35 +305,41 @@ esp_err_t rule_store_init(rule_store_t **out_store, const rule_store_config_t *c
     if (!store) {
         return ESP_ERR_NO_MEM;
     }
+    store->lock = xSemaphoreCreateMutex();
+    if (!store->lock) {
+        free(store);
+        return ESP_ERR_NO_MEM;
+    }
+    store->slot = -1;
     store->cfg.auto_flush = true;
-    store->cfg.spiffs_path = DEFAULT_SPIFFS_PATH;
+    store->cfg.path = DEFAULT_PATH;
     if (cfg) {
         store->cfg = *cfg;
-        if (!store->cfg.spiffs_path) {
-            store->cfg.spiffs_path = DEFAULT_SPIFFS_PATH;
+        if (!store->cfg.path) {
+            store->cfg.path = DEFAULT_PATH;
         }
     }
 
     esp_err_t load_err = load_from_disk(store);
     if (load_err != ESP_OK) {
         // Start with empty JSON
-        store->json = calloc(1, 1);
-        if (!store->json) {
+        store->blob = blob_create("", 0);
+        if (!store->blob) {
+            vSemaphoreDelete(store->lock);
             free(store);
             return ESP_ERR_NO_MEM;
         }
-        compute_sha256_hex(store->json, store->sha256);
-        if (store->cfg.auto_flush && flush_to_disk(store) != ESP_OK) {
-            ESP_LOGW(TAG, "Failed to create empty rules file at boot");
-        }
+        compute_sha256_hex(store->blob->json, store->sha256);
+        store->dirty = true;
+    }
+    if (store->dirty && store->cfg.auto_flush && flush_to_disk(store) != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to write rules slot at boot");
     }
 
     *out_store = store;
     if (store->observer) {
-        rule_store_snapshot_t snapshot = {
-            .json = store->json,
-        };
-        memcpy(snapshot.sha256, store->sha256, sizeof(store->sha256));
+        rule_store_snapshot_t snapshot;
+        fill_snapshot(store, &snapshot);
         store->observer(&snapshot, RULE_STORE_SOURCE_BOOT, store->observer_ctx);
     }
     return ESP_OK;
@@ -153,10 +350,12 @@ void rule_store_deinit(rule_store_t *store)
     if (!store) {
         return;
     }
-    if (store->cfg.auto_flush) {
+    if (store->dirty) {
         flush_to_disk(store);
     }
-    free(store->json);
+    rule_set_free(store->rules);
+    vSemaphoreDelete(store->lock);
+    blob_unref(store->blob);
     free(store);
 }
 
@@ -165,11 +364,11 @@ esp_err_t rule_store_get_snapshot(rule_store_t *store, rule_store_snapshot_t *ou
     if (!store || !out_snapshot) {
         return ESP_ERR_INVALID_ARG;
     }
-    out_snapshot->json = store->json ? strdup(store->json) : NULL;
-    if (store->json && !out_snapshot->json) {
-        return ESP_ERR_NO_MEM;
-    }
-    memcpy(out_snapshot->sha256, store->sha256, sizeof(store->sha256));
+    xSemaphoreTake(store->lock, portMAX_DELAY);
+    fill_snapshot(store, out_snapshot);
+    out_snapshot->rules = NULL;
+    out_snapshot->blob = blob_ref(store->blob);
+    xSemaphoreGive(store->lock);
     return ESP_OK;
 }
 
@@ -178,7 +377,8 @@ void rule_store_release_snapshot(rule_store_snapshot_t *snapshot)
     if (!snapshot) {
         return;
     }
-    free(snapshot->json);
+    blob_unref(snapshot->blob);
+    snapshot->blob = NULL;
     snapshot->json = NULL;
 }
 
@@ -209,8 +409,11 @@ esp_err_t rule_store_update(rule_store_t *store,
         return ESP_ERR_INVALID_CRC;
     }
 
-    bool changed = store->json == NULL || strcmp(store->json, json_payload) != 0;
+    xSemaphoreTake(store->lock, portMAX_DELAY);
+    // Equal digests mean equal documents; no need to compare the text
+    bool changed = strcmp(store->sha256, new_sha) != 0;
     if (!changed) {
+        xSemaphoreGive(store->lock);
         ESP_LOGI(TAG, "Rules unchanged (%s)", rule_store_source_name(source));
         if (out_changed) {
             *out_changed = false;
@@ -218,13 +421,26 @@ esp_err_t rule_store_update(rule_store_t *store,
         return ESP_OK;
     }
 
-    char *copy = strdup(json_payload);
-    if (!copy) {
+    rule_set_t *rules = NULL;
+    esp_err_t err = rule_set_compile(json_payload, &rules);
+    if (err != ESP_OK) {
+        xSemaphoreGive(store->lock);
+        ESP_LOGW(TAG, "Rejected rules from %s (%s)", rule_store_source_name(source), esp_err_to_name(err));
+        return err;
+    }
+    rule_store_blob_t *blob = blob_create(json_payload, strlen(json_payload));
+    if (!blob) {
+        xSemaphoreGive(store->lock);
+        rule_set_free(rules);
         return ESP_ERR_NO_MEM;
     }
-    free(store->json);
-    store->json = copy;
+    // Readers still holding the old document keep it alive until they release
+    blob_unref(store->blob);
+    store->blob = blob;
+    rule_set_free(store->rules);
+    store->rules = rules;
     memcpy(store->sha256, new_sha, sizeof(new_sha));
+    store->dirty = true;
 
     esp_err_t flush_err = flush_to_disk(store);
     if (flush_err != ESP_OK) {
@@ -233,12 +449,11 @@ esp_err_t rule_store_update(rule_store_t *store,
 
     ESP_LOGI(TAG, "Rules updated from %s (sha=%s)", rule_store_source_name(source), store->sha256);
     if (store->observer) {
-        rule_store_snapshot_t snapshot = {
-            .json = store->json,
-        };
-        memcpy(snapshot.sha256, store->sha256, sizeof(store->sha256));
+        rule_store_snapshot_t snapshot;
+        fill_snapshot(store, &snapshot);
         store->observer(&snapshot, source, store->observer_ctx);
     }
+    xSemaphoreGive(store->lock);
     if (out_changed) {
         *out_changed = true;
     }
@@ -252,18 +467,33 @@ esp_err_t rule_store_set_observer(rule_store_t *store,
     if (!store) {
         return ESP_ERR_INVALID_ARG;
     }
+    xSemaphoreTake(store->lock, portMAX_DELAY);
     store->observer = callback;
     store->observer_ctx = ctx;
-    if (callback && store->json) {
-        rule_store_snapshot_t snapshot = {
-            .json = store->json,
-        };
-        memcpy(snapshot.sha256, store->sha256, sizeof(store->sha256));
+    if (callback && store->blob) {
+        rule_store_snapshot_t snapshot;
+        fill_snapshot(store, &snapshot);
         callback(&snapshot, RULE_STORE_SOURCE_BOOT, ctx);
     }
+    xSemaphoreGive(store->lock);
     return ESP_OK;
 }
 
+size_t rule_store_evaluate(rule_store_t *store,
+                           const rule_sample_t *sample,
+                           int64_t now_ms,
+                           rule_fire_cb_t callback,
+                           void *ctx)
+{
+    if (!store || !sample) {
+        return 0;
+    }
+    xSemaphoreTake(store->lock, portMAX_DELAY);
+    size_t fired = rule_set_evaluate(store->rules, sample, now_ms, callback, ctx);
+    xSemaphoreGive(store->lock);
+    return fired;
+}
+
 const char *rule_store_source_name(rule_store_source_t source)
 {
     switch (source) {
@@ -4,14 +4,25 @@
 #include <stddef.h>
 
 #include "esp_err.h"
+#include "rule_engine.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/**
+ * Rule documents are immutable once stored. Snapshots share the store's
+ * buffer through a reference count instead of copying it, so taking one is
+ * O(1) and an update never changes the text under a reader; it only drops
+ * the store's reference to the old buffer.
+ */
+typedef struct rule_store_blob rule_store_blob_t;
+
 typedef struct {
     char sha256[65];  // Hex encoded digest (null terminated)
-    char *json;       // Owning pointer to rule set JSON
+    const char *json; // Rule set JSON, valid until the snapshot is released
+    const rule_set_t *rules;  // Compiled rules; observer callbacks only, owned by the store
+    rule_store_blob_t *blob;  // Reference held by rule_store_get_snapshot()
 } rule_store_snapshot_t;
 
 typedef struct rule_store rule_store_t;
@@ -23,9 +34,19 @@ typedef enum {
     RULE_STORE_SOURCE_LOCAL_TEST,
 } rule_store_source_t;
 
+/**
+ * Persistence alternates between two slot files, path + ".0" and ".1", on
+ * the storage.h partition, each headed by a sequence number, length and
+ * SHA-256. A flush only replaces the older slot and loading takes the
+ * newest slot whose digest checks out, so losing power mid-write falls back
+ * to the previous rules instead of a torn file. When neither slot is valid
+ * a plain path file from older firmware is read, then slots and finally the
+ * plain file at seed_path, which is only ever read.
+ */
 typedef struct {
     bool auto_flush;
-    const char *spiffs_path;
+    const char *path;                 // NULL = STORAGE_PATH("rules.json")
+    const char *seed_path;            // Rules shipped in the image, or NULL
 } rule_store_config_t;
 
 esp_err_t rule_store_init(rule_store_t **out_store, const rule_store_config_t *cfg);
@@ -34,12 +55,17 @@ void rule_store_deinit(rule_store_t *store);
 esp_err_t rule_store_get_snapshot(rule_store_t *store, rule_store_snapshot_t *out_snapshot);
 void rule_store_release_snapshot(rule_store_snapshot_t *snapshot);
 
+/**
+ * Replace the rule set. The payload is compiled before anything is stored,
+ * so a document the rule engine rejects leaves the current rules in place.
+ */
 esp_err_t rule_store_update(rule_store_t *store,
                             rule_store_source_t source,
                             const char *json_payload,
                             const char *expected_sha256,
                             bool *out_changed);
 
+// Runs with the store locked; must not call back into the store
 typedef void (*rule_store_observer_cb_t)(const rule_store_snapshot_t *snapshot,
                                          rule_store_source_t source,
                                          void *ctx);
@@ -48,6 +74,18 @@ esp_err_t rule_store_set_observer(rule_store_t *store,
                                   rule_store_observer_cb_t callback,
                                   void *ctx);
 
+/**
+ * Evaluate the cached compiled rules against one sensor sample. The
+ * callback runs with the store locked, once per rule that fires.
+ *
+ * @return Number of rules that fired
+ */
+size_t rule_store_evaluate(rule_store_t *store,
+                           const rule_sample_t *sample,
+                           int64_t now_ms,
+                           rule_fire_cb_t callback,
+                           void *ctx);
+
 const char *rule_store_source_name(rule_store_source_t source);
 
 #ifdef __cplusplus
@@ -11,10 +11,15 @@ extern "C" {
 
 typedef struct rule_update_channel rule_update_channel_t;
 
+// Called after a fired rule's actions ran, with the rule store locked
+typedef void (*rule_update_channel_fired_cb_t)(const rule_t *rule, void *ctx);
+
 typedef struct {
     rule_store_t *store;
     scene_controller_t *scene;
     display_matrix_t *display;
+    rule_update_channel_fired_cb_t fired_cb;  // Optional
+    void *fired_ctx;
 } rule_update_channel_config_t;
 
 esp_err_t rule_update_channel_init(rule_update_channel_t **out_channel,
@@ -31,6 +36,15 @@ esp_err_t rule_update_channel_handle_matter(rule_update_channel_t *channel,
 void rule_update_channel_apply_snapshot(rule_update_channel_t *channel,
                                         const rule_store_snapshot_t *snapshot);
 
+/**
+ * Run the compiled rules against one sensor sample and apply the actions
+ * of every rule that fires. Cheap enough to call on each sensor tick.
+ *
+ * @return Number of rules that fired
+ */
+size_t rule_update_channel_evaluate(rule_update_channel_t *channel,
+                                    const rule_sample_t *sample);
+
 #ifdef __cplusplus
 }
 #endif
@@ -1,39 +1,61 @@
 #include "scene_controller.h"
 
+#include <math.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
-#include "esp_check.h"
 #include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
 #include "led_strip.h"
 
 struct scene_controller {
     scene_controller_config_t cfg;
     led_strip_handle_t strip;
+    led_effects_t *effects;
+    scene_controller_light_cb_t light_cb;
+    void *light_ctx;
 };
 
 static const char *TAG = "scene_controller";
 
-static esp_err_t set_all(scene_controller_t *ctrl, uint8_t r, uint8_t g, uint8_t b, float brightness)
+// Scenes and colours all live on the bottom layer of the effects engine
+#define SCENE_LAYER_LIGHT 0
+
+static void notify_light(scene_controller_t *ctrl, const led_effect_layer_t *layer, const char *scene_id)
+{
+    if (ctrl->light_cb) {
+        ctrl->light_cb(layer, scene_id, ctrl->light_ctx);
+    }
+}
+
+static void clear_light(scene_controller_t *ctrl)
 {
-    if (!ctrl || !ctrl->strip) {
+    led_effects_clear_layer(ctrl->effects, SCENE_LAYER_LIGHT);
+    notify_light(ctrl, NULL, NULL);
+}
+
+static esp_err_t set_all(scene_controller_t *ctrl, const char *scene_id, uint8_t r, uint8_t g, uint8_t b, float brightness)
+{
+    if (!ctrl || !ctrl->effects) {
         return ESP_ERR_INVALID_STATE;
     }
-    float master = ctrl->cfg.master_brightness > 0.0f ? ctrl->cfg.master_brightness : 1.0f;
     float scale = brightness > 0.0f ? brightness : 1.0f;
-    float factor = master * scale;
-    if (factor > 1.0f) {
-        factor = 1.0f;
-    } else if (factor < 0.01f) {
-        factor = 0.01f;
-    }
-    uint32_t rr = (uint32_t)(r * factor);
-    uint32_t gg = (uint32_t)(g * factor);
-    uint32_t bb = (uint32_t)(b * factor);
-    for (int i = 0; i < ctrl->cfg.led_pixel_count; ++i) {
-        ESP_RETURN_ON_ERROR(led_strip_set_pixel(ctrl->strip, i, rr, gg, bb), TAG, "set pixel");
+    if (scale > 1.0f) {
+        scale = 1.0f;
+    }
+    uint8_t intensity = (uint8_t)(scale * 255.0f + 0.5f);
+    const led_effect_layer_t layer = {
+        .kind = LED_EFFECT_SOLID,
+        .color = {r, g, b},
+        .intensity = intensity > 3 ? intensity : 3,
+    };
+    esp_err_t err = led_effects_set_layer(ctrl->effects, SCENE_LAYER_LIGHT, &layer);
+    if (err == ESP_OK) {
+        notify_light(ctrl, &layer, scene_id);
     }
-    return led_strip_refresh(ctrl->strip);
+    return err;
 }
 
 static esp_err_t apply_scene(scene_controller_t *ctrl, const char *scene_id, uint32_t transition_ms)
@@ -43,19 +65,19 @@ static esp_err_t apply_scene(scene_controller_t *ctrl, const char *scene_id, uin
     }
     if (strcmp(scene_id, "warm_dim") == 0) {
         ESP_LOGI(TAG, "Light scene warm_dim (transition %ums)", (unsigned)transition_ms);
-        return set_all(ctrl, 255, 147, 41, 0.15f);
+        return set_all(ctrl, "warm_dim", 255, 147, 41, 0.15f);
     }
     if (strcmp(scene_id, "gentle_rain") == 0) {
         ESP_LOGI(TAG, "Light scene gentle_rain (transition %ums)", (unsigned)transition_ms);
-        return set_all(ctrl, 80, 120, 255, 0.10f);
+        return set_all(ctrl, "gentle_rain", 80, 120, 255, 0.10f);
     }
     if (strcmp(scene_id, "cool_mist") == 0) {
         ESP_LOGI(TAG, "Light scene cool_mist (transition %ums)", (unsigned)transition_ms);
-        return set_all(ctrl, 160, 200, 255, 0.20f);
+        return set_all(ctrl, "cool_mist", 160, 200, 255, 0.20f);
     }
     ESP_LOGW(TAG, "Unknown scene id '%s', clearing", scene_id);
-    ESP_RETURN_ON_ERROR(led_strip_clear(ctrl->strip), TAG, "clear");
-    return led_strip_refresh(ctrl->strip);
+    clear_light(ctrl);
+    return ESP_OK;
 }
 
 esp_err_t scene_controller_init(scene_controller_t **out_ctrl, const scene_controller_config_t *cfg)
@@ -78,13 +100,28 @@ esp_err_t scene_controller_init(scene_controller_t **out_ctrl, const scene_contr
     };
     led_strip_rmt_config_t rmt_cfg = {
         .resolution_hz = 10 * 1000 * 1000,
-        .with_dma = false,
+        .with_dma = true,  // Ignored on SoCs without RMT DMA
     };
     esp_err_t err = led_strip_new_rmt_device(&strip_cfg, &rmt_cfg, &ctrl->strip);
     if (err != ESP_OK) {
         free(ctrl);
         return err;
     }
+    float master = cfg->master_brightness > 0.0f ? cfg->master_brightness : 1.0f;
+    led_effects_config_t fx_cfg = {
+        .strip = ctrl->strip,
+        .pixel_count = cfg->led_pixel_count,
+        .brightness = (uint8_t)(fminf(master, 1.0f) * 255.0f + 0.5f),
+        // Frame callbacks may draw the face simulator from this task
+        .stack_bytes = 4096,
+        .core = tskNO_AFFINITY,
+    };
+    err = led_effects_create(&fx_cfg, &ctrl->effects);
+    if (err != ESP_OK) {
+        led_strip_del(ctrl->strip);
+        free(ctrl);
+        return err;
+    }
     ESP_LOGI(TAG, "Scene controller initialised (GPIO%d, %d pixels)", cfg->led_gpio, cfg->led_pixel_count);
     *out_ctrl = ctrl;
     return ESP_OK;
@@ -95,6 +132,7 @@ void scene_controller_deinit(scene_controller_t *ctrl)
     if (!ctrl) {
         return;
     }
+    led_effects_destroy(ctrl->effects);
     if (ctrl->strip) {
         led_strip_clear(ctrl->strip);
         led_strip_refresh(ctrl->strip);
@@ -126,7 +164,7 @@ esp_err_t scene_controller_set_light_color(scene_controller_t *ctrl,
     }
     ESP_LOGI(TAG, "Light color rgb(%u,%u,%u) brightness=%.2f transition=%ums",
              r, g, b, brightness, (unsigned)transition_ms);
-    return set_all(ctrl, r, g, b, brightness);
+    return set_all(ctrl, NULL, r, g, b, brightness);
 }
 
 esp_err_t scene_controller_play_sound_scene(scene_controller_t *ctrl,
@@ -147,6 +185,39 @@ esp_err_t scene_controller_play_sound_playlist(scene_controller_t *ctrl,
     return ESP_OK;
 }
 
+esp_err_t scene_controller_set_light_effect(scene_controller_t *ctrl, const led_effect_layer_t *effect)
+{
+    if (!ctrl || !effect) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (effect->kind == LED_EFFECT_OFF) {
+        clear_light(ctrl);
+        return ESP_OK;
+    }
+    led_effect_layer_t layer = *effect;
+    layer.first = 0;
+    layer.count = 0;
+    esp_err_t err = led_effects_set_layer(ctrl->effects, SCENE_LAYER_LIGHT, &layer);
+    if (err == ESP_OK) {
+        notify_light(ctrl, &layer, NULL);
+    }
+    return err;
+}
+
+void scene_controller_set_light_observer(scene_controller_t *ctrl, scene_controller_light_cb_t cb, void *ctx)
+{
+    if (!ctrl) {
+        return;
+    }
+    ctrl->light_cb = cb;
+    ctrl->light_ctx = ctx;
+}
+
+led_effects_t *scene_controller_get_effects(scene_controller_t *ctrl)
+{
+    return ctrl ? ctrl->effects : NULL;
+}
+
 led_strip_handle_t scene_controller_get_strip(scene_controller_t *ctrl)
 {
     if (!ctrl) {
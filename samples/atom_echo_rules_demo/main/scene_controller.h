@@ -3,6 +3,7 @@
 #include <stdint.h>
 
 #include "esp_err.h"
+#include "led_effects.h"
 #include "led_strip.h"
 
 #ifdef __cplusplus
@@ -40,7 +41,22 @@ esp_err_t scene_controller_play_sound_playlist(scene_controller_t *ctrl,
                                                const char *playlist_id,
                                                float volume_0_1);
 
-// Helper functions for advanced LED control
+// Declare the animated effect behind every light scene and colour; the
+// effect's range is ignored and LED_EFFECT_OFF blanks the strip
+esp_err_t scene_controller_set_light_effect(scene_controller_t *ctrl, const led_effect_layer_t *effect);
+
+/**
+ * Called after each change to the light layer, on the task that made it.
+ * layer is NULL when the lights went off; scene_id is NULL for plain
+ * colours and effects.
+ */
+typedef void (*scene_controller_light_cb_t)(const led_effect_layer_t *layer, const char *scene_id, void *ctx);
+void scene_controller_set_light_observer(scene_controller_t *ctrl, scene_controller_light_cb_t cb, void *ctx);
+
+// Helper functions for advanced LED control. The effects engine is the only
+// writer to the strip; add layers or a frame callback there rather than
+// writing pixels directly.
+led_effects_t *scene_controller_get_effects(scene_controller_t *ctrl);
 led_strip_handle_t scene_controller_get_strip(scene_controller_t *ctrl);
 int scene_controller_get_pixel_count(scene_controller_t *ctrl);
 float scene_controller_get_master_brightness(scene_controller_t *ctrl);
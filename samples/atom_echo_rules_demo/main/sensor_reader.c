@@ -4,14 +4,17 @@
 #include <math.h>
 #include "esp_log.h"
 #include "esp_err.h"
-#include "driver/i2c.h"
-#include "driver/gpio.h"
+#include "hal/i2c_types.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "as7341.h"
+#include "bme68x.h"
+#include "i2c_scheduler.h"
+#include "nvs.h"
 
-// Sensor drivers - use relative paths
-// Note: SHT45 and SGP40 drivers use I2C master compat layer
-// For now, we'll use direct I2C reads for all sensors to avoid dependencies
+// Sensors are driven directly through the I2C scheduler so their conversions
+// overlap: a sweep takes as long as the slowest sensor (a forced-mode BME680) instead of
+// the sum of all of them.
 
 #define TAG "sensor_reader"
 
@@ -24,8 +27,6 @@
 // Sensor addresses
 #define BME280_ADDR_0x76 0x76
 #define BME280_ADDR_0x77 0x77
-#define BME680_ADDR_0x76 0x76
-#define BME680_ADDR_0x77 0x77
 #define SHT41_ADDR 0x44
 #define SGP40_ADDR 0x59
 #define AS7341_ADDR 0x39
@@ -39,19 +40,31 @@
 #define BME280_REG_TEMP_MSB 0xFA
 #define BME280_REG_HUM_MSB 0xFD
 
-// BME680 specific
-#define BME680_REG_ID 0xD0
-#define BME680_REG_CTRL_GAS_1 0x71
-#define BME680_REG_GAS_R_MSB 0x2A
+// BME680/BME688
+#define BME68X_REG_VARIANT_ID 0xF0
+#define BME68X_NVS_NAMESPACE "bme68x"
+#define BME68X_NVS_KEY "calib"
 
-// AS7341 registers
-#define AS7341_REG_ID 0x92
-#define AS7341_REG_ENABLE 0x80
-#define AS7341_REG_CFG1 0xA3
-#define AS7341_REG_CFG6 0xA8
-#define AS7341_REG_CH0_DATA_L 0x95
+// AS7341: 50 ms integration at 128x gain; banks F1-F4 and F5-F8 alternate by sweep
+#define AS7341_ATIME 29
+#define AS7341_ASTEP 599
 
-static bool s_i2c_initialized = false;
+// Conversion time from trigger to result
+#define BME280_CONVERSION_MS 20
+#define SHT41_CONVERSION_MS 15
+#define SGP40_CONVERSION_MS 30
+
+static i2c_scheduler_t *s_sched = NULL;
+static i2c_scheduler_dev_t *s_bme280 = NULL;
+static i2c_scheduler_dev_t *s_bme680 = NULL;
+static i2c_scheduler_dev_t *s_sht41 = NULL;
+static i2c_scheduler_dev_t *s_sgp40 = NULL;
+static i2c_scheduler_dev_t *s_as7341 = NULL;
+static bme68x_t s_bme68x;
+static as7341_t s_as7341_dev;
+
+// Written by the collect steps during a sweep
+static sensor_readings_t s_latest = {0};
 
 // BME280 calibration data
 static struct {
@@ -64,74 +77,55 @@ static struct {
     bool loaded;
 } bme280_cal = {0};
 
-// BME680 calibration data
-static struct {
-    uint16_t par_t1;
-    int16_t par_t2, par_t3;
-    uint16_t par_p1;
-    int16_t par_p2, par_p3, par_p4, par_p5, par_p6, par_p7, par_p8, par_p9, par_p10;
-    uint8_t par_h1, par_h3;
-    int16_t par_h2, par_h4, par_h5, par_h6, par_h7;
-    uint8_t par_g1;
-    int16_t par_g2, par_g3;
-    bool loaded;
-} bme680_cal = {0};
+// A BME688 runs this profile on its own in parallel mode: each step is a
+// multiple of 140 ms, so a 1 s sweep finds at most three new fields
+static const bme68x_config_t BME688_CONFIG = {
+    .os_temp = BME68X_OS_X2,
+    .os_pres = BME68X_OS_X4,
+    .os_hum = BME68X_OS_X1,
+    .heater = {{320, 3}, {280, 3}, {240, 3}, {200, 4}},
+    .heater_steps = 4,
+    .ambient_c = 25.0f,
+    .parallel = true,
+    .shared_heater_ms = 140,
+};
 
-static esp_err_t i2c_read_reg(i2c_port_t port, uint8_t addr, uint8_t reg, uint8_t *data, size_t len)
-{
-    i2c_cmd_handle_t cmd = i2c_cmd_link_create();
-    i2c_master_start(cmd);
-    i2c_master_write_byte(cmd, (addr << 1) | I2C_MASTER_WRITE, true);
-    i2c_master_write_byte(cmd, reg, true);
-    i2c_master_start(cmd);
-    i2c_master_write_byte(cmd, (addr << 1) | I2C_MASTER_READ, true);
-    if (len > 1) {
-        i2c_master_read(cmd, data, len - 1, I2C_MASTER_ACK);
-    }
-    i2c_master_read_byte(cmd, data + len - 1, I2C_MASTER_NACK);
-    i2c_master_stop(cmd);
-    esp_err_t ret = i2c_master_cmd_begin(port, cmd, pdMS_TO_TICKS(100));
-    i2c_cmd_link_delete(cmd);
-    return ret;
-}
-
-static esp_err_t i2c_write_reg(i2c_port_t port, uint8_t addr, uint8_t reg, uint8_t data)
-{
-    i2c_cmd_handle_t cmd = i2c_cmd_link_create();
-    i2c_master_start(cmd);
-    i2c_master_write_byte(cmd, (addr << 1) | I2C_MASTER_WRITE, true);
-    i2c_master_write_byte(cmd, reg, true);
-    i2c_master_write_byte(cmd, data, true);
-    i2c_master_stop(cmd);
-    esp_err_t ret = i2c_master_cmd_begin(port, cmd, pdMS_TO_TICKS(100));
-    i2c_cmd_link_delete(cmd);
-    return ret;
-}
+// A BME680 takes one forced-mode step per sweep; durations in ms
+static const bme68x_config_t BME680_CONFIG = {
+    .os_temp = BME68X_OS_X2,
+    .os_pres = BME68X_OS_X4,
+    .os_hum = BME68X_OS_X1,
+    .heater = {{320, 150}, {240, 150}},
+    .heater_steps = 2,
+    .ambient_c = 25.0f,
+};
 
-static bool detect_bme280(i2c_port_t port, uint8_t addr)
-{
-    uint8_t chip_id = 0;
-    if (i2c_read_reg(port, addr, BME280_REG_ID, &chip_id, 1) == ESP_OK) {
-        return (chip_id == 0x60);  // BME280 chip ID
-    }
-    return false;
-}
+// Trimming as last read, so a restart skips the calibration reads
+typedef struct {
+    uint8_t address;
+    uint8_t variant;
+    bme68x_calib_t calib;
+} bme68x_calib_cache_t;
 
-static bool detect_bme680(i2c_port_t port, uint8_t addr)
+// Sensirion word CRC (SHT4x, SGP40)
+static uint8_t sensirion_crc8(const uint8_t *data, size_t len)
 {
-    uint8_t chip_id = 0;
-    if (i2c_read_reg(port, addr, BME680_REG_ID, &chip_id, 1) == ESP_OK) {
-        return (chip_id == 0x61);  // BME680 chip ID
+    uint8_t crc = 0xFF;
+    for (size_t i = 0; i < len; ++i) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x31) : (uint8_t)(crc << 1);
+        }
     }
-    return false;
+    return crc;
 }
 
-static bool read_bme280_calibration(i2c_port_t port, uint8_t addr)
+static bool read_bme280_calibration(i2c_scheduler_dev_t *dev)
 {
     uint8_t cal[26] = {0};
     
     // Read calibration data (0x88-0xA1)
-    if (i2c_read_reg(port, addr, 0x88, cal, 24) != ESP_OK) return false;
+    if (i2c_scheduler_read_reg(dev, 0x88, cal, 24) != ESP_OK) return false;
     
     bme280_cal.dig_T1 = (uint16_t)(cal[0] | (cal[1] << 8));
     bme280_cal.dig_T2 = (int16_t)(cal[2] | (cal[3] << 8));
@@ -147,11 +141,11 @@ static bool read_bme280_calibration(i2c_port_t port, uint8_t addr)
     bme280_cal.dig_P9 = (int16_t)(cal[22] | (cal[23] << 8));
     
     // Read H1 (0xA1)
-    if (i2c_read_reg(port, addr, 0xA1, &bme280_cal.dig_H1, 1) != ESP_OK) return false;
+    if (i2c_scheduler_read_reg(dev, 0xA1, &bme280_cal.dig_H1, 1) != ESP_OK) return false;
     
     // Read H2-H6 (0xE1-0xE7)
     uint8_t h_cal[7] = {0};
-    if (i2c_read_reg(port, addr, 0xE1, h_cal, 7) != ESP_OK) return false;
+    if (i2c_scheduler_read_reg(dev, 0xE1, h_cal, 7) != ESP_OK) return false;
     
     bme280_cal.dig_H2 = (int16_t)(h_cal[0] | (h_cal[1] << 8));
     bme280_cal.dig_H3 = h_cal[2];
@@ -163,25 +157,32 @@ static bool read_bme280_calibration(i2c_port_t port, uint8_t addr)
     return true;
 }
 
-static bool read_bme280(i2c_port_t port, uint8_t addr, float *temp, float *humidity, float *pressure)
+static esp_err_t bme280_start(i2c_scheduler_dev_t *dev, void *ctx)
 {
-    if (!bme280_cal.loaded) {
-        if (!read_bme280_calibration(port, addr)) {
-            return false;
-        }
+    (void)ctx;
+    // Forced mode: one conversion, then the sensor sleeps
+    esp_err_t err = i2c_scheduler_write_reg(dev, BME280_REG_CTRL_HUM, 0x05);  // Humidity oversampling x16
+    if (err == ESP_OK) {
+        err = i2c_scheduler_write_reg(dev, BME280_REG_CONFIG, 0xA0);      // Standby 1000ms, filter off
     }
-    
-    // Configure for forced mode
-    i2c_write_reg(port, addr, BME280_REG_CTRL_HUM, 0x05);  // Humidity oversampling x16
-    i2c_write_reg(port, addr, BME280_REG_CONFIG, 0xA0);    // Standby 1000ms, filter off
-    i2c_write_reg(port, addr, BME280_REG_CTRL_MEAS, 0xB7); // Forced mode, temp/press x16
-    
-    vTaskDelay(pdMS_TO_TICKS(20));  // Wait for measurement
-    
+    if (err == ESP_OK) {
+        err = i2c_scheduler_write_reg(dev, BME280_REG_CTRL_MEAS, 0xB7);   // Forced mode, temp/press x16
+    }
+    return err;
+}
+
+static esp_err_t bme280_collect(i2c_scheduler_dev_t *dev, void *ctx)
+{
+    (void)ctx;
     uint8_t data[8] = {0};
-    if (i2c_read_reg(port, addr, BME280_REG_PRESS_MSB, data, 8) != ESP_OK) {
-        return false;
+    esp_err_t err = i2c_scheduler_read_reg(dev, BME280_REG_PRESS_MSB, data, sizeof(data));
+    if (err != ESP_OK) {
+        return err;
     }
+
+    float *temp = &s_latest.bme280_temp_c;
+    float *humidity = &s_latest.bme280_humidity_rh;
+    float *pressure = &s_latest.bme280_pressure_hpa;
     
     int32_t press_raw = (data[0] << 12) | (data[1] << 4) | (data[2] >> 4);
     int32_t temp_raw = (data[3] << 12) | (data[4] << 4) | (data[5] >> 4);
@@ -228,201 +229,338 @@ static bool read_bme280(i2c_port_t port, uint8_t addr, float *temp, float *humid
     v_x1_u32r = (v_x1_u32r > 419430400) ? 419430400 : v_x1_u32r;
     *humidity = (v_x1_u32r >> 12) / 1024.0f;
     
-    return true;
+    return ESP_OK;
 }
 
-static bool read_bme680(i2c_port_t port, uint8_t addr, float *temp, float *humidity, 
-                        float *pressure, uint32_t *gas_resistance)
+static bool bme68x_calib_load(uint8_t address, uint8_t variant, bme68x_calib_t *calib)
 {
-    // Simplified BME680 read - full implementation would require calibration data
-    // For now, just detect and return basic values
-    uint8_t chip_id = 0;
-    if (i2c_read_reg(port, addr, BME680_REG_ID, &chip_id, 1) != ESP_OK || chip_id != 0x61) {
+    nvs_handle_t nvs;
+    if (nvs_open(BME68X_NVS_NAMESPACE, NVS_READONLY, &nvs) != ESP_OK) {
         return false;
     }
-    
-    // Configure and trigger measurement
-    i2c_write_reg(port, addr, 0x74, 0x10);  // Gas heater off, run gas
-    i2c_write_reg(port, addr, 0x75, 0x00);  // Gas wait 0
-    i2c_write_reg(port, addr, BME680_REG_CTRL_GAS_1, 0x10);  // Enable gas
-    i2c_write_reg(port, addr, 0x72, 0x2C);  // Humidity x2, temp x2
-    i2c_write_reg(port, addr, 0x74, 0x93);  // Pressure x16, forced mode
-    
-    vTaskDelay(pdMS_TO_TICKS(100));  // Wait for measurement
-    
-    uint8_t data[15] = {0};
-    if (i2c_read_reg(port, addr, 0x1F, data, 15) != ESP_OK) {
+    bme68x_calib_cache_t cache;
+    size_t len = sizeof(cache);
+    esp_err_t err = nvs_get_blob(nvs, BME68X_NVS_KEY, &cache, &len);
+    nvs_close(nvs);
+    // A part of another kind or at another address is a different sensor
+    if (err != ESP_OK || len != sizeof(cache) || cache.address != address || cache.variant != variant) {
         return false;
     }
-    
-    // Parse raw values (simplified - would need full calibration)
-    int32_t press_raw = (data[2] << 12) | (data[3] << 4) | (data[4] >> 4);
-    int32_t temp_raw = (data[5] << 12) | (data[6] << 4) | (data[7] >> 4);
-    int32_t hum_raw = (data[8] << 8) | data[9];
-    uint16_t gas_raw = (data[13] << 2) | (data[14] >> 6);
-    
-    // Basic conversion (would need calibration for accuracy)
-    *temp = temp_raw / 100.0f;
-    *humidity = hum_raw / 1024.0f;
-    *pressure = press_raw / 256.0f;
-    *gas_resistance = gas_raw;
-    
+    *calib = cache.calib;
     return true;
 }
 
-static bool read_as7341(i2c_port_t port, uint8_t addr, uint16_t *channels)
+static void bme68x_calib_save(uint8_t address, const bme68x_t *dev)
 {
-    uint8_t chip_id = 0;
-    if (i2c_read_reg(port, addr, AS7341_REG_ID, &chip_id, 1) != ESP_OK) {
-        return false;
+    bme68x_calib_cache_t cache = {.address = address, .variant = (uint8_t)dev->variant};
+    bme68x_get_calib(dev, &cache.calib);
+    nvs_handle_t nvs;
+    esp_err_t err = nvs_open(BME68X_NVS_NAMESPACE, NVS_READWRITE, &nvs);
+    if (err == ESP_OK) {
+        err = nvs_set_blob(nvs, BME68X_NVS_KEY, &cache, sizeof(cache));
+        if (err == ESP_OK) {
+            err = nvs_commit(nvs);
+        }
+        nvs_close(nvs);
     }
-    if ((chip_id & 0xF0) != 0x90) {  // AS7341 ID mask
-        return false;
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "BME68x calibration not cached: %s", esp_err_to_name(err));
     }
-    
-    // Enable sensor
-    i2c_write_reg(port, addr, AS7341_REG_ENABLE, 0x01);  // Power on
-    vTaskDelay(pdMS_TO_TICKS(10));
-    
-    // Configure for spectral measurement
-    i2c_write_reg(port, addr, AS7341_REG_CFG1, 0x00);  // Low gain
-    i2c_write_reg(port, addr, AS7341_REG_CFG6, 0x10);  // Integration time
-    
-    // Start measurement
-    uint8_t enable = 0;
-    i2c_read_reg(port, addr, AS7341_REG_ENABLE, &enable, 1);
-    i2c_write_reg(port, addr, AS7341_REG_ENABLE, enable | 0x02);  // Start measurement
-    
-    vTaskDelay(pdMS_TO_TICKS(500));  // Wait for measurement
-    
-    // Read channel data (simplified - read first few channels)
-    uint8_t data[2] = {0};
-    for (int i = 0; i < 8; i++) {
-        if (i2c_read_reg(port, addr, AS7341_REG_CH0_DATA_L + (i * 2), data, 2) == ESP_OK) {
-            channels[i] = (uint16_t)(data[0] | (data[1] << 8));
-        } else {
-            channels[i] = 0;
+}
+
+static esp_err_t bme68x_start_step(i2c_scheduler_dev_t *dev, void *ctx)
+{
+    (void)dev;
+    return bme68x_start(ctx);
+}
+
+static esp_err_t bme68x_collect_step(i2c_scheduler_dev_t *dev, void *ctx)
+{
+    (void)dev;
+    bme68x_sample_t samples[BME68X_FIELD_COUNT];
+    size_t count = 0;
+    esp_err_t err = bme68x_read(ctx, samples, BME68X_FIELD_COUNT, &count);
+    if (err != ESP_OK) {
+        return err;
+    }
+    if (count == 0) {
+        // Parallel mode between fields: the last reading stands
+        return s_latest.bme680_available && s_bme68x.parallel ? ESP_OK : ESP_ERR_NOT_FINISHED;
+    }
+    const bme68x_sample_t *last = &samples[count - 1];
+    s_latest.bme680_temp_c = last->temperature_c;
+    s_latest.bme680_humidity_rh = last->humidity_rh;
+    s_latest.bme680_pressure_hpa = last->pressure_pa / 100.0f;
+    for (size_t i = count; i-- > 0;) {
+        if (!isnan(samples[i].gas_ohm)) {
+            s_latest.bme680_gas_resistance = (uint32_t)samples[i].gas_ohm;
+            s_latest.bme680_gas_step = samples[i].gas_index;
+            break;
         }
     }
-    
-    return true;
+    return ESP_OK;
+}
+
+static esp_err_t sht41_start(i2c_scheduler_dev_t *dev, void *ctx)
+{
+    (void)ctx;
+    const uint8_t cmd = 0xFD;  // High precision measurement
+    return i2c_scheduler_write(dev, &cmd, 1);
+}
+
+static esp_err_t sht41_collect(i2c_scheduler_dev_t *dev, void *ctx)
+{
+    (void)ctx;
+    uint8_t data[6] = {0};
+    esp_err_t err = i2c_scheduler_read(dev, data, sizeof(data));
+    if (err != ESP_OK) {
+        return err;
+    }
+    if (sensirion_crc8(&data[0], 2) != data[2] || sensirion_crc8(&data[3], 2) != data[5]) {
+        return ESP_ERR_INVALID_CRC;
+    }
+
+    uint16_t temp_raw = (data[0] << 8) | data[1];
+    uint16_t hum_raw = (data[3] << 8) | data[4];
+    s_latest.sht41_temp_c = -45.0f + (175.0f * temp_raw / 65535.0f);
+    s_latest.sht41_humidity_rh = -6.0f + (125.0f * hum_raw / 65535.0f);
+    return ESP_OK;
+}
+
+static esp_err_t sgp40_start(i2c_scheduler_dev_t *dev, void *ctx)
+{
+    (void)ctx;
+    // Compensate with the previous SHT41 reading, or the datasheet defaults (50 %RH, 25 C)
+    uint16_t hum_ticks = 0x8000;
+    uint16_t temp_ticks = 0x6666;
+    if (s_latest.sht41_available) {
+        float rh = fminf(fmaxf(s_latest.sht41_humidity_rh, 0.0f), 100.0f);
+        float t = fminf(fmaxf(s_latest.sht41_temp_c, -45.0f), 130.0f);
+        hum_ticks = (uint16_t)(rh * 65535.0f / 100.0f);
+        temp_ticks = (uint16_t)((t + 45.0f) * 65535.0f / 175.0f);
+    }
+    uint8_t cmd[8] = {0x26, 0x0F,  // Measure raw command
+                      (uint8_t)(hum_ticks >> 8), (uint8_t)hum_ticks, 0,
+                      (uint8_t)(temp_ticks >> 8), (uint8_t)temp_ticks, 0};
+    cmd[4] = sensirion_crc8(&cmd[2], 2);
+    cmd[7] = sensirion_crc8(&cmd[5], 2);
+    return i2c_scheduler_write(dev, cmd, sizeof(cmd));
+}
+
+static esp_err_t sgp40_collect(i2c_scheduler_dev_t *dev, void *ctx)
+{
+    (void)ctx;
+    uint8_t data[3] = {0};
+    esp_err_t err = i2c_scheduler_read(dev, data, sizeof(data));
+    if (err != ESP_OK) {
+        return err;
+    }
+    if (sensirion_crc8(data, 2) != data[2]) {
+        return ESP_ERR_INVALID_CRC;
+    }
+    s_latest.sgp40_voc_index = (data[0] << 8) | data[1];
+    return ESP_OK;
+}
+
+static esp_err_t as7341_start_step(i2c_scheduler_dev_t *dev, void *ctx)
+{
+    (void)dev;
+    return as7341_start(ctx);
+}
+
+// One bank per sweep; the other bank's channels keep their last values
+static esp_err_t as7341_collect_step(i2c_scheduler_dev_t *dev, void *ctx)
+{
+    (void)dev;
+    esp_err_t err = as7341_read(ctx, NULL);
+    if (err != ESP_OK) {
+        return err;
+    }
+    as7341_spectrum_t spectrum;
+    as7341_get_spectrum(ctx, &spectrum);
+    if (spectrum.fresh != ((1 << AS7341_BANK_F1_F4) | (1 << AS7341_BANK_F5_F8))) {
+        return ESP_ERR_NOT_FINISHED;
+    }
+    memcpy(s_latest.as7341_channels, spectrum.f, sizeof(spectrum.f));
+    s_latest.as7341_channels[8] = spectrum.clear;
+    s_latest.as7341_channels[9] = spectrum.nir;
+    s_latest.as7341_channels[10] = 0;
+    return ESP_OK;
+}
+
+static i2c_scheduler_dev_t *add_job(const i2c_scheduler_job_t *job)
+{
+    i2c_scheduler_dev_t *dev = NULL;
+    esp_err_t err = i2c_scheduler_add_job(s_sched, job, &dev);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to schedule %s: %s", job->name, esp_err_to_name(err));
+        return NULL;
+    }
+    ESP_LOGI(TAG, "%s found at 0x%02X", job->name, job->address);
+    return dev;
+}
+
+// Add a device for a driver that expects its handle attached before init
+static esp_err_t attach_device(uint16_t address, i2c_master_dev_handle_t *ret_dev)
+{
+    i2c_device_config_t dev_config = {
+        .dev_addr_length = I2C_ADDR_BIT_LEN_7,
+        .device_address = address,
+        .scl_speed_hz = I2C_FREQ_HZ,
+    };
+    return i2c_master_bus_add_device(i2c_scheduler_bus(s_sched), &dev_config, ret_dev);
+}
+
+// Attach, configure and schedule a BME680 or BME688; parallel mode needs no start per sweep
+static i2c_scheduler_dev_t *add_bme68x(uint8_t address)
+{
+    uint8_t variant = 0;
+    if (i2c_scheduler_identify(s_sched, address, BME68X_REG_VARIANT_ID, &variant) != ESP_OK) {
+        return NULL;
+    }
+    const bme68x_config_t *config = variant == BME68X_VARIANT_GAS_HIGH ? &BME688_CONFIG : &BME680_CONFIG;
+    s_bme68x = (bme68x_t){0};
+    if (attach_device(address, &s_bme68x.i2c_dev) != ESP_OK) {
+        return NULL;
+    }
+    bme68x_calib_t calib;
+    bool cached = bme68x_calib_load(address, variant, &calib);
+    esp_err_t err = bme68x_init(&s_bme68x, config, cached ? &calib : NULL);
+    if (err != ESP_OK && cached) {
+        err = bme68x_init(&s_bme68x, config, NULL);
+        cached = false;
+    }
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "BME68x init failed: %s", esp_err_to_name(err));
+        i2c_master_bus_rm_device(s_bme68x.i2c_dev);
+        s_bme68x.i2c_dev = NULL;
+        return NULL;
+    }
+    if (!cached) {
+        bme68x_calib_save(address, &s_bme68x);
+    }
+
+    i2c_scheduler_dev_t *job = add_job(&(i2c_scheduler_job_t){
+        .name = s_bme68x.variant == BME68X_VARIANT_GAS_HIGH ? "BME688" : "BME680",
+        .address = address,
+        .device = s_bme68x.i2c_dev,
+        .conversion_ms = bme68x_measurement_ms(&s_bme68x),
+        .start = bme68x_start_step,
+        .collect = bme68x_collect_step,
+        .ctx = &s_bme68x,
+    });
+    if (!job) {
+        bme68x_deinit(&s_bme68x);
+        return NULL;
+    }
+    ESP_LOGI(TAG, "BME68x %s mode, %u heater steps, calibration %s", s_bme68x.parallel ? "parallel" : "forced",
+             (unsigned)config->heater_steps, cached ? "from NVS" : "read");
+    return job;
 }
 
 esp_err_t sensor_reader_init(void)
 {
-    if (s_i2c_initialized) {
+    if (s_sched) {
         return ESP_OK;
     }
     
     ESP_LOGI(TAG, "Initializing I2C bus for sensor reading...");
     
-    // Initialize I2C bus
-    i2c_config_t conf = {
-        .mode = I2C_MODE_MASTER,
+    // I2C Port Allocation: I2C_NUM_1 is used for sensor bus (GPIO 2/1)
+    i2c_scheduler_config_t config = {
+        .port = I2C_PORT,
         .sda_io_num = I2C_SDA_GPIO,
         .scl_io_num = I2C_SCL_GPIO,
-        .sda_pullup_en = GPIO_PULLUP_ENABLE,
-        .scl_pullup_en = GPIO_PULLUP_ENABLE,
-        .master.clk_speed = I2C_FREQ_HZ,
+        .scl_speed_hz = I2C_FREQ_HZ,
+        .enable_internal_pullup = true,
     };
-    
-    // I2C Port Allocation: I2C_NUM_1 is used for sensor bus (GPIO 2/1)
-    esp_err_t err = i2c_param_config(I2C_PORT, &conf);
+    esp_err_t err = i2c_scheduler_new(&config, &s_sched);
     if (err != ESP_OK) {
-        ESP_LOGE(TAG, "I2C param config failed: %s", esp_err_to_name(err));
+        ESP_LOGE(TAG, "I2C bus init failed: %s", esp_err_to_name(err));
         return err;
     }
-    
-    err = i2c_driver_install(I2C_PORT, I2C_MODE_MASTER, 0, 0, 0);
-    if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) {
-        ESP_LOGE(TAG, "I2C driver install failed: %s", esp_err_to_name(err));
-        return err;
+
+    // Sensors are detected once; each one found becomes a job
+    const uint8_t bme_addrs[] = {BME280_ADDR_0x76, BME280_ADDR_0x77};
+    for (size_t i = 0; i < sizeof(bme_addrs); ++i) {
+        uint8_t chip_id = 0;
+        if (i2c_scheduler_identify(s_sched, bme_addrs[i], BME280_REG_ID, &chip_id) != ESP_OK) {
+            continue;
+        }
+        if (chip_id == 0x60 && !s_bme280) {  // BME280 chip ID
+            s_bme280 = add_job(&(i2c_scheduler_job_t){
+                .name = "BME280", .address = bme_addrs[i], .conversion_ms = BME280_CONVERSION_MS,
+                .start = bme280_start, .collect = bme280_collect,
+            });
+            if (s_bme280 && !read_bme280_calibration(s_bme280)) {
+                ESP_LOGW(TAG, "BME280 calibration read failed");
+            }
+        } else if (chip_id == 0x61 && !s_bme680) {  // BME680 and BME688 chip ID
+            s_bme680 = add_bme68x(bme_addrs[i]);
+        }
     }
-    if (err == ESP_ERR_INVALID_STATE) {
-        ESP_LOGI(TAG, "I2C driver already installed, reusing");
+
+    if (i2c_scheduler_probe(s_sched, SHT41_ADDR) == ESP_OK) {
+        s_sht41 = add_job(&(i2c_scheduler_job_t){
+            .name = "SHT41", .address = SHT41_ADDR, .conversion_ms = SHT41_CONVERSION_MS,
+            .start = sht41_start, .collect = sht41_collect,
+        });
+    }
+    if (i2c_scheduler_probe(s_sched, SGP40_ADDR) == ESP_OK) {
+        s_sgp40 = add_job(&(i2c_scheduler_job_t){
+            .name = "SGP40", .address = SGP40_ADDR, .conversion_ms = SGP40_CONVERSION_MS,
+            .start = sgp40_start, .collect = sgp40_collect,
+        });
+    }
+
+    if (i2c_scheduler_probe(s_sched, AS7341_ADDR) == ESP_OK &&
+        attach_device(AS7341_ADDR, &s_as7341_dev.i2c_dev) == ESP_OK) {
+        const as7341_config_t as7341_cfg = {.atime = AS7341_ATIME, .astep = AS7341_ASTEP, .gain = AS7341_GAIN_128X};
+        if (as7341_init(&s_as7341_dev, &as7341_cfg) == ESP_OK) {
+            s_as7341 = add_job(&(i2c_scheduler_job_t){
+                .name = "AS7341", .address = AS7341_ADDR, .device = s_as7341_dev.i2c_dev,
+                .conversion_ms = as7341_measurement_ms(&s_as7341_dev),
+                .start = as7341_start_step, .collect = as7341_collect_step, .ctx = &s_as7341_dev,
+            });
+        }
+        if (!s_as7341) {
+            if (s_as7341_dev.initialized) {
+                as7341_deinit(&s_as7341_dev);
+            } else {
+                i2c_master_bus_rm_device(s_as7341_dev.i2c_dev);
+                s_as7341_dev.i2c_dev = NULL;
+            }
+        }
     }
     
-    s_i2c_initialized = true;
-    
-    ESP_LOGI(TAG, "Sensor reader initialized (I2C ready for direct reads)");
+    ESP_LOGI(TAG, "Sensor reader initialized");
     return ESP_OK;
 }
 
+static bool job_ok(const i2c_scheduler_dev_t *dev)
+{
+    return dev && i2c_scheduler_dev_result(dev) == ESP_OK;
+}
+
 esp_err_t sensor_reader_read_all(sensor_readings_t *readings)
 {
-    if (!readings || !s_i2c_initialized) {
+    if (!readings || !s_sched) {
         return ESP_ERR_INVALID_ARG;
     }
     
-    memset(readings, 0, sizeof(sensor_readings_t));
-    
-    // Read BME280 (try both addresses)
-    if (detect_bme280(I2C_PORT, BME280_ADDR_0x76)) {
-        readings->bme280_available = read_bme280(I2C_PORT, BME280_ADDR_0x76,
-                                                 &readings->bme280_temp_c,
-                                                 &readings->bme280_humidity_rh,
-                                                 &readings->bme280_pressure_hpa);
-    } else if (detect_bme280(I2C_PORT, BME280_ADDR_0x77)) {
-        readings->bme280_available = read_bme280(I2C_PORT, BME280_ADDR_0x77,
-                                                 &readings->bme280_temp_c,
-                                                 &readings->bme280_humidity_rh,
-                                                 &readings->bme280_pressure_hpa);
-    }
-    
-    // Read BME680 (try both addresses)
-    if (detect_bme680(I2C_PORT, BME680_ADDR_0x76)) {
-        readings->bme680_available = read_bme680(I2C_PORT, BME680_ADDR_0x76,
-                                                  &readings->bme680_temp_c,
-                                                  &readings->bme680_humidity_rh,
-                                                  &readings->bme680_pressure_hpa,
-                                                  &readings->bme680_gas_resistance);
-    } else if (detect_bme680(I2C_PORT, BME680_ADDR_0x77)) {
-        readings->bme680_available = read_bme680(I2C_PORT, BME680_ADDR_0x77,
-                                                  &readings->bme680_temp_c,
-                                                  &readings->bme680_humidity_rh,
-                                                  &readings->bme680_pressure_hpa,
-                                                  &readings->bme680_gas_resistance);
-    }
-    
-    // Read SHT41 (SHT4x protocol - similar to SHT45)
-    uint8_t sht_cmd = 0xFD;  // High precision measurement
-    uint8_t sht_data[6] = {0};
-    if (i2c_write_reg(I2C_PORT, SHT41_ADDR, sht_cmd, 0) == ESP_OK) {
-        vTaskDelay(pdMS_TO_TICKS(15));  // Wait for measurement
-        if (i2c_read_reg(I2C_PORT, SHT41_ADDR, 0, sht_data, 6) == ESP_OK) {
-            uint16_t temp_raw = (sht_data[0] << 8) | sht_data[1];
-            uint16_t hum_raw = (sht_data[3] << 8) | sht_data[4];
-            readings->sht41_available = true;
-            readings->sht41_temp_c = -45.0f + (175.0f * temp_raw / 65535.0f);
-            readings->sht41_humidity_rh = -6.0f + (125.0f * hum_raw / 65535.0f);
-        }
-    }
-    
-    // Read SGP40 (simplified - just check if device responds)
-    uint8_t sgp_cmd[2] = {0x26, 0x0F};  // Measure raw command
-    uint8_t sgp_data[3] = {0};
-    i2c_cmd_handle_t cmd = i2c_cmd_link_create();
-    i2c_master_start(cmd);
-    i2c_master_write_byte(cmd, (SGP40_ADDR << 1) | I2C_MASTER_WRITE, true);
-    i2c_master_write(cmd, sgp_cmd, 2, true);
-    i2c_master_stop(cmd);
-    if (i2c_master_cmd_begin(I2C_PORT, cmd, pdMS_TO_TICKS(100)) == ESP_OK) {
-        vTaskDelay(pdMS_TO_TICKS(30));  // Wait for measurement
-        i2c_cmd_link_delete(cmd);
-        cmd = i2c_cmd_link_create();
-        i2c_master_start(cmd);
-        i2c_master_write_byte(cmd, (SGP40_ADDR << 1) | I2C_MASTER_READ, true);
-        i2c_master_read(cmd, sgp_data, 3, I2C_MASTER_LAST_NACK);
-        i2c_master_stop(cmd);
-        if (i2c_master_cmd_begin(I2C_PORT, cmd, pdMS_TO_TICKS(100)) == ESP_OK) {
-            readings->sgp40_available = true;
-            readings->sgp40_voc_index = (sgp_data[0] << 8) | sgp_data[1];
-        }
+    uint32_t elapsed_ms = 0;
+    esp_err_t err = i2c_scheduler_sweep(s_sched, &elapsed_ms);
+    if (err != ESP_OK) {
+        return err;
     }
-    i2c_cmd_link_delete(cmd);
-    
-    // Read AS7341
-    readings->as7341_available = read_as7341(I2C_PORT, AS7341_ADDR, readings->as7341_channels);
+    ESP_LOGD(TAG, "Sensor sweep took %lu ms", (unsigned long)elapsed_ms);
+
+    s_latest.bme280_available = job_ok(s_bme280);
+    s_latest.bme680_available = job_ok(s_bme680);
+    s_latest.sht41_available = job_ok(s_sht41);
+    s_latest.sgp40_available = job_ok(s_sgp40);
+    s_latest.as7341_available = job_ok(s_as7341);
+    *readings = s_latest;
     
     return ESP_OK;
 }
@@ -441,9 +579,10 @@ void sensor_reader_print(const sensor_readings_t *readings)
     }
     
     if (readings->bme680_available) {
-        ESP_LOGI(TAG, "BME680: T=%.2f°C H=%.1f%% P=%.2f hPa Gas=%lu",
+        ESP_LOGI(TAG, "BME680: T=%.2f°C H=%.1f%% P=%.2f hPa Gas=%lu ohm (heater step %u)",
                 readings->bme680_temp_c, readings->bme680_humidity_rh, 
-                readings->bme680_pressure_hpa, (unsigned long)readings->bme680_gas_resistance);
+                readings->bme680_pressure_hpa, (unsigned long)readings->bme680_gas_resistance,
+                readings->bme680_gas_step);
     } else {
         ESP_LOGD(TAG, "BME680: Not available");
     }
@@ -462,10 +601,11 @@ void sensor_reader_print(const sensor_readings_t *readings)
     }
     
     if (readings->as7341_available) {
-        ESP_LOGI(TAG, "AS7341: Channels: ");
-        for (int i = 0; i < 8; i++) {
-            ESP_LOGI(TAG, "  Ch%d=%u", i, readings->as7341_channels[i]);
-        }
+        ESP_LOGI(TAG, "AS7341: F1-F8 %u %u %u %u %u %u %u %u, Clear %u, NIR %u",
+                readings->as7341_channels[0], readings->as7341_channels[1], readings->as7341_channels[2],
+                readings->as7341_channels[3], readings->as7341_channels[4], readings->as7341_channels[5],
+                readings->as7341_channels[6], readings->as7341_channels[7], readings->as7341_channels[8],
+                readings->as7341_channels[9]);
     } else {
         ESP_LOGD(TAG, "AS7341: Not available");
     }
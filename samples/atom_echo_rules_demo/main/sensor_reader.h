@@ -14,12 +14,13 @@ typedef struct {
     float bme280_humidity_rh;
     float bme280_pressure_hpa;
     
-    // BME680 data
+    // BME680/BME688 data
     bool bme680_available;
     float bme680_temp_c;
     float bme680_humidity_rh;
     float bme680_pressure_hpa;
-    uint32_t bme680_gas_resistance;
+    uint32_t bme680_gas_resistance;  // Ohms, newest valid gas reading
+    uint8_t bme680_gas_step;         // Heater profile step it was taken at
     
     // SHT41 data (using SHT45 driver)
     bool sht41_available;
@@ -32,7 +33,7 @@ typedef struct {
     
     // AS7341 data
     bool as7341_available;
-    uint16_t as7341_channels[11];  // 8 spectral + clear + NIR + flicker
+    uint16_t as7341_channels[11];  // F1-F8, Clear, NIR; flicker (10) not measured
 } sensor_readings_t;
 
 /**
@@ -42,6 +43,9 @@ esp_err_t sensor_reader_init(void);
 
 /**
  * Read all sensors
+ *
+ * Conversions run overlapped, so this blocks for about the slowest sensor's
+ * conversion time rather than the sum of all of them.
  */
 esp_err_t sensor_reader_read_all(sensor_readings_t *readings);
 
@@ -4,48 +4,62 @@
 #include <stdlib.h>
 #include <math.h>
 
-#ifndef M_PI
-#define M_PI 3.14159265358979323846
-#endif
-
 #include "cJSON.h"
+#include "control_coalescer.h"
 #include "esp_log.h"
 #include "esp_err.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
-#include "freertos/timers.h"
-#include "led_strip.h"
+#include "led_effects.h"
 #include "face_led_simulator.h"
 
 #define ACTION_TAG "somnus_action"
 
-// LED pattern state
-typedef enum {
-    LED_PATTERN_NONE = 0,
-    LED_PATTERN_BREATHING,
-    LED_PATTERN_GRADIENT_RED_BLUE,
-    LED_PATTERN_GRADIENT_RED_YELLOW,
-    LED_PATTERN_GRADIENT_WHITE_BLUE,
-    LED_PATTERN_GRADIENT_BLUE_GREEN,
-    LED_PATTERN_GRADIENT_TEAL_ORANGE,
-    LED_PATTERN_PULSE_LILAC,
-    LED_PATTERN_PULSE_ORANGE,
-} led_pattern_t;
+// Animation periods, matching LED.py
+#define GRADIENT_FAST_MS 2000
+#define GRADIENT_SLOW_MS 6000
+#define BREATHING_MS 15700
+#define PULSE_MS 12000 // 4 s inhale, 4 s hold, 4 s exhale
+// Display flushes return before the panel has the frame, so the face can
+// follow the effects at 60 FPS
+#define FACE_FRAME_MS 16
+
+// Colours LED.py reserves to select an animation instead of a solid colour
+typedef struct {
+    uint8_t r, g, b;
+    const char *name;
+    led_effect_kind_t kind;
+    led_rgb_t from;
+    led_rgb_t to;
+    uint32_t period_ms;
+} color_trigger_t;
+
+static const color_trigger_t kColorTriggers[] = {
+    {255, 150, 150, "red-blue gradient", LED_EFFECT_GRADIENT, {255, 0, 0}, {0, 0, 255}, GRADIENT_FAST_MS},
+    {220, 38, 38, "red-yellow gradient", LED_EFFECT_GRADIENT, {255, 0, 0}, {255, 255, 0}, GRADIENT_SLOW_MS},
+    {14, 165, 233, "white-blue gradient", LED_EFFECT_GRADIENT, {255, 255, 255}, {0, 0, 255}, GRADIENT_SLOW_MS},
+    {6, 182, 212, "blue-green gradient", LED_EFFECT_GRADIENT, {0, 0, 255}, {0, 255, 0}, GRADIENT_SLOW_MS},
+    {244, 114, 182, "teal-orange gradient", LED_EFFECT_GRADIENT, {0, 100, 100}, {255, 140, 0}, GRADIENT_SLOW_MS},
+    {255, 135, 0, "orange pulse", LED_EFFECT_PULSE, {255, 135, 0}, {0, 0, 0}, PULSE_MS},
+    {255, 100, 255, "lilac pulse", LED_EFFECT_PULSE, {255, 100, 255}, {0, 0, 0}, PULSE_MS},
+};
 
 static struct {
     scene_controller_t *led_ctrl;
     face_led_simulator_t *face_simulator;
-    led_pattern_t current_pattern;
+    scene_controller_t *face_attached_to;
+    ir_tx_t *ir_tx;
+    led_effect_layer_t effect;    // Last declared light effect, restored by Play
+    bool effect_set;
     uint8_t current_r, current_g, current_b;
     float current_intensity;
     float current_volume;
     bool paused;
-    TaskHandle_t pattern_task;
-    TimerHandle_t audio_timer;
-    bool pattern_active;
+    control_coalescer_t *intensity;   // Slider drags re-declare the effect at the control rate
 } s_state = {0};
 
 // Forward declarations
+static esp_err_t run_action(somnus_mqtt_action_type_t type, const char *name, const cJSON *data);
 static esp_err_t handle_led_action(const cJSON *data);
 static esp_err_t handle_song_change(const cJSON *data);
 static esp_err_t handle_set_volume(const cJSON *data);
@@ -53,15 +67,38 @@ static esp_err_t handle_set_led_intensity(const cJSON *data);
 static esp_err_t handle_pause(void);
 static esp_err_t handle_play(void);
 static esp_err_t handle_speech(const cJSON *data);
+static esp_err_t handle_ir(const cJSON *data);
+
+// Mirror whatever the strip shows onto the face simulator
+static void attach_face_simulator(void)
+{
+    if (s_state.led_ctrl == s_state.face_attached_to) {
+        return;
+    }
+    led_effects_t *effects = scene_controller_get_effects(s_state.led_ctrl);
+    if (effects && s_state.face_simulator) {
+        led_effects_set_frame_cb(effects, face_led_simulator_show_frame, s_state.face_simulator);
+        led_effects_set_frame_ms(effects, FACE_FRAME_MS);
+    }
+    s_state.face_attached_to = s_state.led_ctrl;
+}
 
-// LED pattern tasks
-static void led_breathing_task(void *arg);
-static void led_gradient_task(void *arg);
-static void led_pulse_task(void *arg);
+static void set_led_controller(scene_controller_t *led_controller)
+{
+    s_state.led_ctrl = led_controller;
+    attach_face_simulator();
+}
 
 void somnus_action_handler_set_face_simulator(face_led_simulator_t *face_simulator)
 {
     s_state.face_simulator = face_simulator;
+    // Re-attach on the next action
+    s_state.face_attached_to = NULL;
+}
+
+void somnus_action_handler_set_ir_tx(ir_tx_t *ir_tx)
+{
+    s_state.ir_tx = ir_tx;
 }
 
 esp_err_t somnus_action_handler_process(const char *payload, scene_controller_t *led_controller)
@@ -70,7 +107,7 @@ esp_err_t somnus_action_handler_process(const char *payload, scene_controller_t
         return ESP_ERR_INVALID_ARG;
     }
     
-    s_state.led_ctrl = led_controller;
+    set_led_controller(led_controller);
     
     cJSON *root = cJSON_Parse(payload);
     if (!root) {
@@ -105,24 +142,7 @@ esp_err_t somnus_action_handler_process(const char *payload, scene_controller_t
             
             const char *action_str = action_type->valuestring;
             ESP_LOGI(ACTION_TAG, "Executing action: %s", action_str);
-            
-            if (strcmp(action_str, "LED") == 0) {
-                handle_led_action(data);
-            } else if (strcmp(action_str, "SongChange") == 0) {
-                handle_song_change(data);
-            } else if (strcmp(action_str, "SetVolume") == 0) {
-                handle_set_volume(data);
-            } else if (strcmp(action_str, "SetLEDIntensity") == 0) {
-                handle_set_led_intensity(data);
-            } else if (strcmp(action_str, "Pause") == 0) {
-                handle_pause();
-            } else if (strcmp(action_str, "Play") == 0) {
-                handle_play();
-            } else if (strcmp(action_str, "Speech") == 0) {
-                handle_speech(data);
-            } else {
-                ESP_LOGW(ACTION_TAG, "Unknown action type: %s", action_str);
-            }
+            run_action(somnus_mqtt_action_type_from_name(action_str, strlen(action_str)), action_str, data);
         }
     }
     // Handle single action
@@ -132,25 +152,7 @@ esp_err_t somnus_action_handler_process(const char *payload, scene_controller_t
             cJSON *data = cJSON_GetObjectItem(root, "Data");
             const char *action_str = action_type->valuestring;
             ESP_LOGI(ACTION_TAG, "Executing single action: %s", action_str);
-            
-            if (strcmp(action_str, "LED") == 0) {
-                result = handle_led_action(data);
-            } else if (strcmp(action_str, "SongChange") == 0) {
-                result = handle_song_change(data);
-            } else if (strcmp(action_str, "SetVolume") == 0) {
-                result = handle_set_volume(data);
-            } else if (strcmp(action_str, "SetLEDIntensity") == 0) {
-                result = handle_set_led_intensity(data);
-            } else if (strcmp(action_str, "Pause") == 0) {
-                result = handle_pause();
-            } else if (strcmp(action_str, "Play") == 0) {
-                result = handle_play();
-            } else if (strcmp(action_str, "Speech") == 0) {
-                result = handle_speech(data);
-            } else {
-                ESP_LOGW(ACTION_TAG, "Unknown action type: %s", action_str);
-                result = ESP_ERR_NOT_SUPPORTED;
-            }
+            result = run_action(somnus_mqtt_action_type_from_name(action_str, strlen(action_str)), action_str, data);
         }
     }
     
@@ -158,24 +160,72 @@ esp_err_t somnus_action_handler_process(const char *payload, scene_controller_t
     return result;
 }
 
-static void stop_current_pattern(void)
+esp_err_t somnus_action_handler_process_action(const somnus_mqtt_action_t *action,
+                                               scene_controller_t *led_controller)
 {
-    s_state.pattern_active = false;
-    if (s_state.pattern_task) {
-        vTaskDelete(s_state.pattern_task);
-        s_state.pattern_task = NULL;
+    if (!action) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (action->type == SOMNUS_MQTT_ACTION_UNKNOWN) {
+        ESP_LOGW(ACTION_TAG, "Unknown action type: %.*s", (int)action->name_len, action->name);
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    set_led_controller(led_controller);
+
+    if (action->delay_s > 0) {
+        vTaskDelay(pdMS_TO_TICKS(action->delay_s * 1000));
+    }
+
+    // Just this action's Data: a few hundred bytes of tree at most
+    cJSON *data = action->data ? cJSON_ParseWithLength(action->data, action->data_len) : NULL;
+    ESP_LOGI(ACTION_TAG, "Executing action %u/%u: %.*s", (unsigned)(action->index + 1), (unsigned)action->count,
+             (int)action->name_len, action->name);
+    esp_err_t result = run_action(action->type, NULL, data);
+    cJSON_Delete(data);
+    return result;
+}
+
+static esp_err_t run_action(somnus_mqtt_action_type_t type, const char *name, const cJSON *data)
+{
+    switch (type) {
+    case SOMNUS_MQTT_ACTION_LED:
+        return handle_led_action(data);
+    case SOMNUS_MQTT_ACTION_SONG_CHANGE:
+        return handle_song_change(data);
+    case SOMNUS_MQTT_ACTION_SET_VOLUME:
+        return handle_set_volume(data);
+    case SOMNUS_MQTT_ACTION_SET_LED_INTENSITY:
+        return handle_set_led_intensity(data);
+    case SOMNUS_MQTT_ACTION_PAUSE:
+        return handle_pause();
+    case SOMNUS_MQTT_ACTION_PLAY:
+        return handle_play();
+    case SOMNUS_MQTT_ACTION_SPEECH:
+        return handle_speech(data);
+    case SOMNUS_MQTT_ACTION_IR:
+        return handle_ir(data);
+    default:
+        ESP_LOGW(ACTION_TAG, "Unknown action type: %s", name ? name : "?");
+        return ESP_ERR_NOT_SUPPORTED;
     }
 }
 
+// Intensity 0 (never set) means full, as scene_controller_set_light_color does
+static uint8_t intensity_level(float intensity)
+{
+    if (intensity <= 0.0f || intensity >= 1.0f) {
+        return 255;
+    }
+    return (uint8_t)(intensity * 255.0f + 0.5f);
+}
+
 static esp_err_t handle_led_action(const cJSON *data)
 {
     if (!data || !s_state.led_ctrl) {
         return ESP_ERR_INVALID_ARG;
     }
     
-    // Stop current pattern
-    stop_current_pattern();
-    
     // Get pattern
     cJSON *pattern_json = cJSON_GetObjectItem(data, "Pattern");
     const char *pattern_str = pattern_json && cJSON_IsString(pattern_json) 
@@ -208,296 +258,40 @@ static esp_err_t handle_led_action(const cJSON *data)
     s_state.current_g = g;
     s_state.current_b = b;
     
-    ESP_LOGI(ACTION_TAG, "LED: pattern=%s color=[%u,%u,%u] intensity=%.2f duration=%d",
-             pattern_str, r, g, b, s_state.current_intensity, duration);
-    
-    // Update face LED simulator if available
-    face_led_pattern_t face_pattern = FACE_LED_PATTERN_NONE;
-    
-    // Check for special color triggers (from LED.py)
-    if (r == 255 && g == 150 && b == 150) {
-        // Red-Blue gradient (normal speed)
-        s_state.current_pattern = LED_PATTERN_GRADIENT_RED_BLUE;
-        face_pattern = FACE_LED_PATTERN_GRADIENT_RED_BLUE;
-        s_state.pattern_active = true;
-        xTaskCreate(led_gradient_task, "led_grad_rb", 4096, NULL, 5, &s_state.pattern_task);
-        if (s_state.face_simulator) {
-            face_led_simulator_set_pattern(s_state.face_simulator, face_pattern, r, g, b, s_state.current_intensity);
-        }
-        return ESP_OK;
-    } else if (r == 220 && g == 38 && b == 38) {
-        // Red-Yellow gradient (slow)
-        s_state.current_pattern = LED_PATTERN_GRADIENT_RED_YELLOW;
-        face_pattern = FACE_LED_PATTERN_GRADIENT_RED_YELLOW;
-        s_state.pattern_active = true;
-        xTaskCreate(led_gradient_task, "led_grad_ry", 4096, NULL, 5, &s_state.pattern_task);
-        if (s_state.face_simulator) {
-            face_led_simulator_set_pattern(s_state.face_simulator, face_pattern, r, g, b, s_state.current_intensity);
-        }
-        return ESP_OK;
-    } else if (r == 14 && g == 165 && b == 233) {
-        // White-Blue gradient (slow)
-        s_state.current_pattern = LED_PATTERN_GRADIENT_WHITE_BLUE;
-        face_pattern = FACE_LED_PATTERN_GRADIENT_WHITE_BLUE;
-        s_state.pattern_active = true;
-        xTaskCreate(led_gradient_task, "led_grad_wb", 4096, NULL, 5, &s_state.pattern_task);
-        if (s_state.face_simulator) {
-            face_led_simulator_set_pattern(s_state.face_simulator, face_pattern, r, g, b, s_state.current_intensity);
-        }
-        return ESP_OK;
-    } else if (r == 6 && g == 182 && b == 212) {
-        // Blue-Green gradient (slow)
-        s_state.current_pattern = LED_PATTERN_GRADIENT_BLUE_GREEN;
-        face_pattern = FACE_LED_PATTERN_GRADIENT_BLUE_GREEN;
-        s_state.pattern_active = true;
-        xTaskCreate(led_gradient_task, "led_grad_bg", 4096, NULL, 5, &s_state.pattern_task);
-        if (s_state.face_simulator) {
-            face_led_simulator_set_pattern(s_state.face_simulator, face_pattern, r, g, b, s_state.current_intensity);
-        }
-        return ESP_OK;
-    } else if (r == 244 && g == 114 && b == 182) {
-        // Dark Teal-Orange gradient (slow)
-        s_state.current_pattern = LED_PATTERN_GRADIENT_TEAL_ORANGE;
-        face_pattern = FACE_LED_PATTERN_GRADIENT_TEAL_ORANGE;
-        s_state.pattern_active = true;
-        xTaskCreate(led_gradient_task, "led_grad_to", 4096, NULL, 5, &s_state.pattern_task);
-        if (s_state.face_simulator) {
-            face_led_simulator_set_pattern(s_state.face_simulator, face_pattern, r, g, b, s_state.current_intensity);
-        }
-        return ESP_OK;
-    } else if (r == 255 && g == 135 && b == 0) {
-        // Orange pulse
-        s_state.current_pattern = LED_PATTERN_PULSE_ORANGE;
-        face_pattern = FACE_LED_PATTERN_PULSE_ORANGE;
-        s_state.pattern_active = true;
-        xTaskCreate(led_pulse_task, "led_pulse_orange", 4096, NULL, 5, &s_state.pattern_task);
-        if (s_state.face_simulator) {
-            face_led_simulator_set_pattern(s_state.face_simulator, face_pattern, r, g, b, s_state.current_intensity);
-        }
-        return ESP_OK;
-    } else if (r == 255 && g == 100 && b == 255) {
-        // Lilac pulse
-        s_state.current_pattern = LED_PATTERN_PULSE_LILAC;
-        face_pattern = FACE_LED_PATTERN_PULSE_LILAC;
-        s_state.pattern_active = true;
-        xTaskCreate(led_pulse_task, "led_pulse_lilac", 4096, NULL, 5, &s_state.pattern_task);
-        if (s_state.face_simulator) {
-            face_led_simulator_set_pattern(s_state.face_simulator, face_pattern, r, g, b, s_state.current_intensity);
-        }
-        return ESP_OK;
-    }
-    
-    // Handle standard patterns
-    if (strcasecmp(pattern_str, "breathing") == 0) {
-        s_state.current_pattern = LED_PATTERN_BREATHING;
-        face_pattern = FACE_LED_PATTERN_BREATHING;
-        s_state.pattern_active = true;
-        xTaskCreate(led_breathing_task, "led_breathing", 4096, NULL, 5, &s_state.pattern_task);
-        if (s_state.face_simulator) {
-            face_led_simulator_set_pattern(s_state.face_simulator, face_pattern, r, g, b, s_state.current_intensity);
-        }
-    } else if (strcasecmp(pattern_str, "none") == 0) {
-        // Solid color
-        s_state.current_pattern = LED_PATTERN_NONE;
-        face_pattern = FACE_LED_PATTERN_NONE;
-        esp_err_t err = scene_controller_set_light_color(s_state.led_ctrl, r, g, b, 
-                                                s_state.current_intensity, 2000);
-        if (s_state.face_simulator) {
-            face_led_simulator_set_pattern(s_state.face_simulator, face_pattern, r, g, b, s_state.current_intensity);
-        }
-        return err;
-    } else {
-        // Default to solid color
-        s_state.current_pattern = LED_PATTERN_NONE;
-        face_pattern = FACE_LED_PATTERN_NONE;
-        esp_err_t err = scene_controller_set_light_color(s_state.led_ctrl, r, g, b, 
-                                                s_state.current_intensity, 2000);
-        if (s_state.face_simulator) {
-            face_led_simulator_set_pattern(s_state.face_simulator, face_pattern, r, g, b, s_state.current_intensity);
-        }
-        return err;
-    }
-    
-    return ESP_OK;
-}
-
-static void led_breathing_task(void *arg)
-{
-    (void)arg;
-    scene_controller_t *ctrl = s_state.led_ctrl;
-    led_strip_handle_t strip = scene_controller_get_strip(ctrl);
-    if (!ctrl || !strip) {
-        vTaskDelete(NULL);
-        return;
-    }
-    
-    uint8_t r = s_state.current_r;
-    uint8_t g = s_state.current_g;
-    uint8_t b = s_state.current_b;
-    float intensity = s_state.current_intensity;
-    
-    float phase = 0.0f;
-    const float phase_increment = 0.02f; // Breathing speed
-    
-    while (s_state.pattern_active) {
-        // Cosine-based breathing: 0.5 * (1 - cos(phase)) gives 0.0 to 1.0
-        float breath = 0.5f * (1.0f - cosf(phase));
-        breath = fmaxf(0.05f, breath); // Minimum brightness
-        
-        float brightness = breath * intensity;
-        
-        scene_controller_set_light_color(ctrl, r, g, b, brightness, 0);
-        
-        phase += phase_increment;
-        if (phase >= 2.0f * M_PI) {
-            phase = 0.0f;
-        }
-        
-        vTaskDelay(pdMS_TO_TICKS(50)); // ~20 FPS
-    }
-    
-    vTaskDelete(NULL);
-}
-
-static void led_gradient_task(void *arg)
-{
-    (void)arg;
-    scene_controller_t *ctrl = s_state.led_ctrl;
-    led_strip_handle_t strip = scene_controller_get_strip(ctrl);
-    if (!ctrl || !strip) {
-        vTaskDelete(NULL);
-        return;
-    }
-    
-    uint8_t start_r = 0, start_g = 0, start_b = 0;
-    uint8_t end_r = 0, end_g = 0, end_b = 0;
-    bool slow_mode = false;
-    
-    // Set gradient colors based on pattern
-    switch (s_state.current_pattern) {
-        case LED_PATTERN_GRADIENT_RED_BLUE:
-            start_r = 255; start_g = 0; start_b = 0;
-            end_r = 0; end_g = 0; end_b = 255;
-            slow_mode = false;
-            break;
-        case LED_PATTERN_GRADIENT_RED_YELLOW:
-            start_r = 255; start_g = 0; start_b = 0;
-            end_r = 255; end_g = 255; end_b = 0;
-            slow_mode = true;
+    // Solid colour unless a trigger colour or the breathing pattern says otherwise
+    led_effect_layer_t effect = {
+        .kind = LED_EFFECT_SOLID,
+        .color = {r, g, b},
+        .intensity = intensity_level(s_state.current_intensity),
+    };
+    const char *effect_name = "solid";
+    for (size_t i = 0; i < sizeof(kColorTriggers) / sizeof(kColorTriggers[0]); ++i) {
+        const color_trigger_t *trigger = &kColorTriggers[i];
+        if (trigger->r == r && trigger->g == g && trigger->b == b) {
+            effect.kind = trigger->kind;
+            effect.color = trigger->from;
+            effect.color2 = trigger->to;
+            effect.period_ms = trigger->period_ms;
+            effect_name = trigger->name;
             break;
-        case LED_PATTERN_GRADIENT_WHITE_BLUE:
-            start_r = 255; start_g = 255; start_b = 255;
-            end_r = 0; end_g = 0; end_b = 255;
-            slow_mode = true;
-            break;
-        case LED_PATTERN_GRADIENT_BLUE_GREEN:
-            start_r = 0; start_g = 0; start_b = 255;
-            end_r = 0; end_g = 255; end_b = 0;
-            slow_mode = true;
-            break;
-        case LED_PATTERN_GRADIENT_TEAL_ORANGE:
-            start_r = 0; start_g = 100; start_b = 100;
-            end_r = 255; end_g = 140; end_b = 0;
-            slow_mode = true;
-            break;
-        default:
-            vTaskDelete(NULL);
-            return;
-    }
-    
-    float phase = 0.0f;
-    float phase_inc = slow_mode ? 0.005f : 0.01f;
-    int delay_ms = slow_mode ? 30 : 20;
-    
-    int num_leds = scene_controller_get_pixel_count(ctrl);
-    
-    while (s_state.pattern_active) {
-        for (int i = 0; i < num_leds; i++) {
-            // Calculate angle for each LED (circular pattern)
-            float angle = 2.0f * M_PI * ((float)i / (float)num_leds) + phase;
-            float blend = 0.5f * (1.0f + cosf(angle));
-            
-            uint8_t r = (uint8_t)(start_r + (end_r - start_r) * blend);
-            uint8_t g = (uint8_t)(start_g + (end_g - start_g) * blend);
-            uint8_t b = (uint8_t)(start_b + (end_b - start_b) * blend);
-            
-            float brightness = s_state.current_intensity;
-            float master = scene_controller_get_master_brightness(ctrl);
-            float factor = brightness * master;
-            if (factor > 1.0f) factor = 1.0f;
-            if (factor < 0.01f) factor = 0.01f;
-            
-            uint32_t rr = (uint32_t)(r * factor);
-            uint32_t gg = (uint32_t)(g * factor);
-            uint32_t bb = (uint32_t)(b * factor);
-            led_strip_set_pixel(strip, i, rr, gg, bb);
-        }
-        led_strip_refresh(strip);
-        
-        phase += phase_inc;
-        if (phase >= 1.0f) {
-            phase = 0.0f;
         }
-        
-        vTaskDelay(pdMS_TO_TICKS(delay_ms));
     }
-    
-    vTaskDelete(NULL);
-}
-
-static void led_pulse_task(void *arg)
-{
-    (void)arg;
-    scene_controller_t *ctrl = s_state.led_ctrl;
-    led_strip_handle_t strip = scene_controller_get_strip(ctrl);
-    if (!ctrl || !strip) {
-        vTaskDelete(NULL);
-        return;
-    }
-    
-    uint8_t r, g, b;
-    if (s_state.current_pattern == LED_PATTERN_PULSE_ORANGE) {
-        r = 255; g = 135; b = 0;
-    } else { // LILAC
-        r = 255; g = 100; b = 255;
+    if (effect.kind == LED_EFFECT_SOLID && strcasecmp(pattern_str, "breathing") == 0) {
+        effect.kind = LED_EFFECT_BREATHING;
+        effect.period_ms = BREATHING_MS;
+        effect_name = "breathing";
     }
     
-    // 4-4-4 breathing pattern: 4s inhale, 4s hold, 4s exhale = 12s cycle
-    const float inhale_duration = 4.0f;
-    const float hold_duration = 4.0f;
-    const float exhale_duration = 4.0f;
-    const float total_cycle = 12.0f;
+    ESP_LOGI(ACTION_TAG, "LED: pattern=%s color=[%u,%u,%u] intensity=%.2f duration=%d -> %s",
+             pattern_str, r, g, b, s_state.current_intensity, duration, effect_name);
     
-    TickType_t cycle_start = xTaskGetTickCount();
-    
-    while (s_state.pattern_active) {
-        TickType_t now = xTaskGetTickCount();
-        float elapsed = (float)(now - cycle_start) / (float)configTICK_RATE_HZ;
-        float cycle_pos = fmodf(elapsed, total_cycle);
-        
-        float breath_intensity;
-        if (cycle_pos <= inhale_duration) {
-            // Inhale
-            float progress = cycle_pos / inhale_duration;
-            breath_intensity = 0.5f * (1.0f - cosf(progress * M_PI));
-        } else if (cycle_pos <= inhale_duration + hold_duration) {
-            // Hold
-            breath_intensity = 1.0f;
-        } else {
-            // Exhale
-            float progress = (cycle_pos - inhale_duration - hold_duration) / exhale_duration;
-            breath_intensity = 0.5f * (1.0f + cosf(progress * M_PI));
-        }
-        
-        breath_intensity = fmaxf(0.05f, breath_intensity);
-        float brightness = breath_intensity * s_state.current_intensity;
-        
-        scene_controller_set_light_color(ctrl, r, g, b, brightness, 0);
-        
-        vTaskDelay(pdMS_TO_TICKS(16)); // ~60 FPS
+    // The effects task animates it; the face simulator follows through its frame callback
+    s_state.effect = effect;
+    s_state.effect_set = true;
+    if (s_state.intensity) {
+        control_coalescer_sync(s_state.intensity, effect.intensity);
     }
-    
-    vTaskDelete(NULL);
+    return scene_controller_set_light_effect(s_state.led_ctrl, &effect);
 }
 
 static esp_err_t handle_song_change(const cJSON *data)
@@ -550,6 +344,33 @@ static esp_err_t handle_set_volume(const cJSON *data)
     return ESP_ERR_INVALID_ARG;
 }
 
+// On the timer_wheel task, with the latest intensity
+static void apply_intensity(int level, bool settled, void *ctx)
+{
+    (void)settled;
+    (void)ctx;
+    if (s_state.led_ctrl && s_state.effect_set && !s_state.paused) {
+        s_state.effect.intensity = (uint8_t)level;
+        scene_controller_set_light_effect(s_state.led_ctrl, &s_state.effect);
+    }
+}
+
+static control_coalescer_t *intensity_control(void)
+{
+    if (!s_state.intensity) {
+        const control_coalescer_config_t cfg = {
+            .name = "led_intensity",
+            .apply = apply_intensity,
+            .initial = s_state.effect_set ? s_state.effect.intensity : 255,
+            .smoothing_ms = CONFIG_KVA_CONTROL_SMOOTHING_MS,
+        };
+        if (control_coalescer_create(&cfg, &s_state.intensity) != ESP_OK) {
+            s_state.intensity = NULL;
+        }
+    }
+    return s_state.intensity;
+}
+
 static esp_err_t handle_set_led_intensity(const cJSON *data)
 {
     if (!data) {
@@ -562,13 +383,17 @@ static esp_err_t handle_set_led_intensity(const cJSON *data)
         s_state.current_intensity = fmaxf(0.0f, fminf(1.0f, s_state.current_intensity));
         ESP_LOGI(ACTION_TAG, "SetLEDIntensity: %.2f", s_state.current_intensity);
         
-        // Update current LED color with new intensity
-        if (s_state.led_ctrl && s_state.current_pattern == LED_PATTERN_NONE) {
-            return scene_controller_set_light_color(s_state.led_ctrl, 
-                                                     s_state.current_r, 
-                                                     s_state.current_g, 
-                                                     s_state.current_b,
-                                                     s_state.current_intensity, 500);
+        // Re-declare the current effect; animations keep their phase
+        control_coalescer_t *ctl = intensity_control();
+        if (ctl) {
+            control_coalescer_set(ctl, intensity_level(s_state.current_intensity));
+            return ESP_OK;
+        }
+        if (s_state.led_ctrl && s_state.effect_set) {
+            s_state.effect.intensity = intensity_level(s_state.current_intensity);
+            if (!s_state.paused) {
+                return scene_controller_set_light_effect(s_state.led_ctrl, &s_state.effect);
+            }
         }
         return ESP_OK;
     }
@@ -580,13 +405,11 @@ static esp_err_t handle_pause(void)
 {
     ESP_LOGI(ACTION_TAG, "Pause command received");
     s_state.paused = true;
-    stop_current_pattern();
     
-    // Clear LEDs
-    led_strip_handle_t strip = scene_controller_get_strip(s_state.led_ctrl);
-    if (strip) {
-        led_strip_clear(strip);
-        led_strip_refresh(strip);
+    // Clear LEDs; the effect is kept for Play
+    if (s_state.led_ctrl) {
+        const led_effect_layer_t off = {.kind = LED_EFFECT_OFF};
+        scene_controller_set_light_effect(s_state.led_ctrl, &off);
     }
     
     // TODO: Pause audio playback
@@ -604,17 +427,8 @@ static esp_err_t handle_play(void)
     ESP_LOGW(ACTION_TAG, "Audio resume not yet implemented");
     
     // Restore LED state if we have one
-    if (s_state.current_pattern != LED_PATTERN_NONE) {
-        // Re-trigger the pattern
-        cJSON *dummy_data = cJSON_CreateObject();
-        cJSON *color = cJSON_CreateArray();
-        cJSON_AddItemToArray(color, cJSON_CreateNumber(s_state.current_r));
-        cJSON_AddItemToArray(color, cJSON_CreateNumber(s_state.current_g));
-        cJSON_AddItemToArray(color, cJSON_CreateNumber(s_state.current_b));
-        cJSON_AddItemToObject(dummy_data, "Color", color);
-        cJSON_AddItemToObject(dummy_data, "Intensity", cJSON_CreateNumber(s_state.current_intensity));
-        handle_led_action(dummy_data);
-        cJSON_Delete(dummy_data);
+    if (s_state.led_ctrl && s_state.effect_set) {
+        return scene_controller_set_light_effect(s_state.led_ctrl, &s_state.effect);
     }
     
     return ESP_OK;
@@ -640,3 +454,51 @@ static esp_err_t handle_speech(const cJSON *data)
     
     return ESP_OK;
 }
+
+// Data is {"Code": "lg_tv_power"} from the built-in library, or
+// {"Protocol": "NEC" | "RC5", "Address": n, "Command": n}; "Repeats" holds the button
+static esp_err_t handle_ir(const cJSON *data)
+{
+    if (!data) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!s_state.ir_tx) {
+        ESP_LOGW(ACTION_TAG, "IR action but no IR transmitter");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    cJSON *repeats_json = cJSON_GetObjectItem(data, "Repeats");
+    int repeats = cJSON_IsNumber(repeats_json) ? (int)cJSON_GetNumberValue(repeats_json) : 0;
+    repeats = repeats < 0 ? 0 : (repeats > 20 ? 20 : repeats);
+
+    cJSON *code_json = cJSON_GetObjectItem(data, "Code");
+    if (cJSON_IsString(code_json)) {
+        const ir_tx_code_t *code = ir_tx_find_code(code_json->valuestring);
+        if (!code) {
+            ESP_LOGE(ACTION_TAG, "IR: unknown code '%s'", code_json->valuestring);
+            return ESP_ERR_NOT_FOUND;
+        }
+        ESP_LOGI(ACTION_TAG, "IR: %s x%d", code->name, repeats + 1);
+        return ir_tx_send_code(s_state.ir_tx, code, (uint8_t)repeats);
+    }
+
+    cJSON *protocol_json = cJSON_GetObjectItem(data, "Protocol");
+    cJSON *address_json = cJSON_GetObjectItem(data, "Address");
+    cJSON *command_json = cJSON_GetObjectItem(data, "Command");
+    if (!cJSON_IsString(protocol_json) || !cJSON_IsNumber(address_json) || !cJSON_IsNumber(command_json)) {
+        ESP_LOGE(ACTION_TAG, "IR needs Code, or Protocol, Address and Command");
+        return ESP_ERR_INVALID_ARG;
+    }
+    uint8_t address = (uint8_t)cJSON_GetNumberValue(address_json);
+    uint8_t command = (uint8_t)cJSON_GetNumberValue(command_json);
+    ESP_LOGI(ACTION_TAG, "IR: %s address=0x%02X command=0x%02X x%d", protocol_json->valuestring, address, command,
+             repeats + 1);
+    if (strcasecmp(protocol_json->valuestring, "NEC") == 0) {
+        return ir_tx_send_nec(s_state.ir_tx, address, command, (uint8_t)repeats);
+    }
+    if (strcasecmp(protocol_json->valuestring, "RC5") == 0) {
+        return ir_tx_send_rc5(s_state.ir_tx, address, command, (uint8_t)repeats);
+    }
+    ESP_LOGE(ACTION_TAG, "IR: unsupported protocol '%s'", protocol_json->valuestring);
+    return ESP_ERR_NOT_SUPPORTED;
+}
@@ -1,7 +1,9 @@
 #pragma once
 
 #include "esp_err.h"
+#include "ir_tx.h"
 #include "scene_controller.h"
+#include "somnus_mqtt.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -21,6 +23,7 @@ typedef struct face_led_simulator face_led_simulator_t;
  * - SetLEDIntensity: Adjust LED brightness
  * - Pause/Play: Pause/resume audio and LEDs
  * - Speech: Text-to-speech (placeholder)
+ * - IR: Send an infrared remote code
  * 
  * @param payload JSON payload string (can be single action or action list)
  * @param led_controller Scene controller handle for LED control
@@ -28,6 +31,17 @@ typedef struct face_led_simulator face_led_simulator_t;
  */
 esp_err_t somnus_action_handler_process(const char *payload, scene_controller_t *led_controller);
 
+/**
+ * @brief Handle one action streamed by somnus_mqtt (action_item_cb)
+ *
+ * Only the action's own Data object is parsed, so a long action list never
+ * exists as a whole cJSON tree.
+ *
+ * @return ESP_ERR_NOT_SUPPORTED for an unknown action type
+ */
+esp_err_t somnus_action_handler_process_action(const somnus_mqtt_action_t *action,
+                                               scene_controller_t *led_controller);
+
 /**
  * @brief Set face LED simulator for synchronized display
  * 
@@ -35,6 +49,13 @@ esp_err_t somnus_action_handler_process(const char *payload, scene_controller_t
  */
 void somnus_action_handler_set_face_simulator(face_led_simulator_t *face_simulator);
 
+/**
+ * @brief Set the IR transmitter used by IR actions
+ *
+ * @param ir_tx Initialized transmitter (can be NULL to disable)
+ */
+void somnus_action_handler_set_ir_tx(ir_tx_t *ir_tx);
+
 #ifdef __cplusplus
 }
 #endif
@@ -38,6 +38,7 @@ esp_err_t status_display_init(status_display_t *status, display_matrix_t *displa
         ESP_LOGE(STATUS_TAG, "Failed to clear display");
         return err;
     }
+    display_matrix_flush(display);
     
     ESP_LOGI(STATUS_TAG, "Status display initialized");
     return ESP_OK;
@@ -126,7 +127,8 @@ esp_err_t status_display_update(status_display_t *status,
         if (icon_x < 9) display_matrix_draw_tile(status->display, icon_x + 1, icon_y, border_color);
     }
     
-    return ESP_OK;
+    // Goes out as a few merged rectangles rather than a transfer per tile
+    return display_matrix_flush(status->display);
 }
 
 esp_err_t status_display_draw_icon(display_matrix_t *display,
@@ -15,31 +15,78 @@
 #include "scene_controller.h"
 #include "sensor_reader.h"
 #include "sensor_integration.h"
+#include "sensor_history.h"
 #include "somnus_ble.h"
 #include "wifi_manager.h"
+#include "ota_delta.h"
 #include "ota_updater.h"
 
+#include <inttypes.h>
+#include <math.h>
+#include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 #include "esp_log.h"
 #include "esp_http_server.h"
 #include "cJSON.h"
+#include "json_writer.h"
 #include "esp_netif.h"
 #include "esp_timer.h"
 #include "esp_system.h"
 #include "esp_heap_caps.h"
 #include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
 #include "freertos/task.h"
 
 #define TAG "webserver"
 #define DEFAULT_PORT 80
+#define JSON_CHUNK_SIZE 512
+#define WS_MAX_CLIENTS 3      // Leaves most of max_open_sockets for REST calls
+#define WS_MAX_PENDING 16     // Events queued for the httpd task before new ones are dropped
+#define ASYNC_WORKERS 2       // Tasks that run the slow endpoints off the httpd task
+#define ASYNC_QUEUE_LEN 4     // Slow requests waiting for a worker before new ones get a 503
+#define ASYNC_STACK 6144      // The OTA check runs an HTTPS request on it
+#define ASYNC_ROUTES 4
+
+// www/dashboard.html, gzip-compressed at build time (see CMakeLists.txt)
+extern const uint8_t dashboard_html_gz_start[] asm("_binary_dashboard_html_gz_start");
+extern const uint8_t dashboard_html_gz_end[] asm("_binary_dashboard_html_gz_end");
+
+// A slow endpoint's handler, run on a worker with the server as its context
+typedef struct {
+    webserver_t *ws;
+    esp_err_t (*handler)(httpd_req_t *req);
+} async_route_t;
 
 struct webserver {
     httpd_handle_t server;
     webserver_config_t config;
     bool running;
+    char dashboard_etag[12];  // Quoted hash of the compressed dashboard
+    int ws_fds[WS_MAX_CLIENTS];   // Live /ws sockets, -1 when free; touched on the httpd task only
+    uint32_t ws_clients;          // Number of live sockets, read from any task
+    uint32_t ws_pending;          // Events queued on the httpd task
+    QueueHandle_t async_jobs;     // async_job_t for the workers
+    SemaphoreHandle_t async_exited;  // Given by each worker as it exits
+    int async_workers;
+    async_route_t async_routes[ASYNC_ROUTES];
+    int async_route_count;
 };
 
+// A slow request handed from the httpd task to a worker
+typedef struct {
+    httpd_req_t *req;             // From httpd_req_async_handler_begin()
+    esp_err_t (*handler)(httpd_req_t *req);  // NULL tells the worker to exit
+} async_job_t;
+
+// One pushed event on its way to the httpd task
+typedef struct {
+    webserver_t *ws;
+    char *text;
+    size_t len;
+} ws_event_t;
+
 // Forward declarations
 static esp_err_t root_handler(httpd_req_t *req);
 static esp_err_t api_status_handler(httpd_req_t *req);
@@ -52,418 +99,9 @@ static esp_err_t api_ota_check_handler(httpd_req_t *req);
 static esp_err_t api_ota_install_handler(httpd_req_t *req);
 static esp_err_t api_ble_logs_handler(httpd_req_t *req);
 static esp_err_t api_system_handler(httpd_req_t *req);
+static esp_err_t ws_handler(httpd_req_t *req);
 static const char* get_content_type(const char *path);
 
-// HTML dashboard
-static const char* html_dashboard = 
-"<!DOCTYPE html>"
-"<html><head>"
-"<meta charset='UTF-8'>"
-"<meta name='viewport' content='width=device-width, initial-scale=1.0'>"
-"<title>M5 Atom Debug Dashboard</title>"
-"<style>"
-"* { margin: 0; padding: 0; box-sizing: border-box; }"
-"body { font-family: -apple-system, BlinkMacSystemFont, 'Segoe UI', sans-serif; background: #1a1a1a; color: #e0e0e0; padding: 20px; }"
-".container { max-width: 1200px; margin: 0 auto; }"
-"h1 { color: #4CAF50; margin-bottom: 20px; }"
-".card { background: #2a2a2a; border-radius: 8px; padding: 20px; margin-bottom: 20px; box-shadow: 0 2px 8px rgba(0,0,0,0.3); }"
-".card h2 { color: #64B5F6; margin-bottom: 15px; font-size: 1.2em; }"
-".status-grid { display: grid; grid-template-columns: repeat(auto-fit, minmax(200px, 1fr)); gap: 15px; }"
-".status-item { padding: 10px; background: #333; border-radius: 4px; }"
-".status-item label { display: block; font-size: 0.9em; color: #aaa; margin-bottom: 5px; }"
-".status-item .value { font-size: 1.1em; font-weight: bold; }"
-".status-on { color: #4CAF50; }"
-".status-off { color: #f44336; }"
-".button { background: #4CAF50; color: white; border: none; padding: 10px 20px; border-radius: 4px; cursor: pointer; font-size: 1em; margin: 5px; }"
-".button:hover { background: #45a049; }"
-".button-danger { background: #f44336; }"
-".button-danger:hover { background: #da190b; }"
-"input[type='text'], input[type='number'], select { padding: 8px; border: 1px solid #555; border-radius: 4px; background: #333; color: #e0e0e0; width: 100%; margin: 5px 0; }"
-".led-control { display: flex; gap: 10px; align-items: center; flex-wrap: wrap; }"
-".led-control input[type='range'] { flex: 1; min-width: 150px; }"
-".json-viewer { background: #1e1e1e; padding: 15px; border-radius: 4px; overflow-x: auto; font-family: 'Courier New', monospace; font-size: 0.9em; white-space: pre-wrap; }"
-".refresh-btn { position: fixed; bottom: 20px; right: 20px; background: #2196F3; padding: 15px; border-radius: 50%; width: 60px; height: 60px; box-shadow: 0 4px 12px rgba(0,0,0,0.4); }"
-".ota-section { margin-top: 15px; }"
-".ota-status { padding: 10px; background: #333; border-radius: 4px; margin: 10px 0; }"
-".ota-progress { width: 100%; height: 20px; background: #1e1e1e; border-radius: 10px; overflow: hidden; margin: 10px 0; }"
-".ota-progress-bar { height: 100%; background: linear-gradient(90deg, #4CAF50, #8BC34A); transition: width 0.3s; display: flex; align-items: center; justify-content: center; color: white; font-size: 0.8em; }"
-".ota-info { font-size: 0.9em; color: #aaa; margin: 5px 0; }"
-".button-primary { background: #2196F3; }"
-".button-primary:hover { background: #1976D2; }"
-".button:disabled { opacity: 0.5; cursor: not-allowed; }"
-"</style>"
-"</head><body>"
-"<div class='container'>"
-"<h1>🤖 M5 Atom Echo Debug Dashboard</h1>"
-"<div class='card'><h2>Device Status</h2>"
-"<div class='status-grid' id='status-grid'></div>"
-"</div>"
-"<div class='card'><h2>LED Control</h2>"
-"<div class='led-control'>"
-"<button class='button' onclick='setScene(\"warm_dim\")'>Warm Dim</button>"
-"<button class='button' onclick='setScene(\"cool_bright\")'>Cool Bright</button>"
-"<button class='button' onclick='setScene(\"off\")'>Off</button>"
-"<br>"
-"<label>Color: <input type='color' id='led-color' value='#ff8800'></label>"
-"<label>Brightness: <input type='range' id='led-brightness' min='0' max='100' value='50'></label>"
-"<button class='button' onclick='setColor()'>Set Color</button>"
-"</div>"
-"</div>"
-"<div class='card'><h2>Rules Store</h2>"
-"<button class='button' onclick='loadRules()'>Refresh Rules</button>"
-"<div class='json-viewer' id='rules-viewer'>Loading...</div>"
-"</div>"
-"<div class='card'><h2>Sensor Data</h2>"
-"<button class='button' onclick='loadSensors()'>Refresh Sensors</button>"
-"<div class='sensor-grid' id='sensor-grid' style='display: grid; grid-template-columns: repeat(auto-fit, minmax(200px, 1fr)); gap: 15px; margin-top: 15px;'></div>"
-"<div class='json-viewer' id='sensors-viewer' style='margin-top: 15px; display: none;'></div>"
-"<button class='button' onclick='toggleSensorView()' style='margin-top: 10px;'>Toggle JSON View</button>"
-"</div>"
-"<div class='card'><h2>BLE Logs</h2>"
-"<button class='button' onclick='loadBLELogs()'>Refresh Logs</button>"
-"<button class='button' onclick='clearBLELogs()' style='margin-left: 10px;'>Clear View</button>"
-"<div class='ble-log-viewer' id='ble-log-viewer' style='margin-top: 15px; max-height: 400px; overflow-y: auto; background: #1e1e1e; padding: 15px; border-radius: 4px; font-family: monospace; font-size: 0.85em;'></div>"
-"</div>"
-"<div class='card'><h2>💾 Memory & Tasks</h2>"
-"<button class='button' onclick='loadSystemInfo()'>Refresh System Info</button>"
-"<div id='system-info' style='margin-top: 15px;'>"
-"<div class='status-grid' id='memory-grid' style='margin-bottom: 20px;'></div>"
-"<h3 style='color: #64B5F6; margin-top: 20px; margin-bottom: 10px;'>FreeRTOS Tasks</h3>"
-"<div id='tasks-table' style='overflow-x: auto;'></div>"
-"</div>"
-"</div>"
-"<div class='card'><h2>🔄 Firmware Update (OTA)</h2>"
-"<div class='ota-section'>"
-"<div class='ota-status' id='ota-status'>Loading status...</div>"
-"<div class='ota-progress' id='ota-progress-container' style='display:none;'>"
-"<div class='ota-progress-bar' id='ota-progress-bar' style='width:0%;'>0%</div>"
-"</div>"
-"<div class='ota-info' id='ota-info'></div>"
-"<button class='button button-primary' onclick='checkOTA()' id='ota-check-btn'>Check for Updates</button>"
-"<button class='button' onclick='installOTA()' id='ota-install-btn' style='display:none;'>Install Update</button>"
-"</div>"
-"</div>"
-"</div>"
-"<button class='button refresh-btn' onclick='refreshAll()' title='Refresh All'>🔄</button>"
-"<script>"
-"function refreshAll() { loadStatus(); loadRules(); loadSensors(); loadOTAStatus(); }"
-"function loadStatus() {"
-"  fetch('/api/status').then(r=>r.json()).then(data=>{"
-"    const grid = document.getElementById('status-grid');"
-"    grid.innerHTML = '';"
-"    const items = ["
-"      {label:'WiFi', value: data.wifi_connected ? 'Connected: ' + (data.wifi_ssid || 'N/A') : 'Disconnected', status: data.wifi_connected},"
-"      {label:'IP Address', value: data.ip_address || 'N/A'},"
-"      {label:'AWS IoT', value: data.aws_connected ? 'Connected' : 'Disconnected', status: data.aws_connected},"
-"      {label:'Spotify', value: data.spotify_ready ? 'Ready' : 'Not Ready', status: data.spotify_ready},"
-"      {label:'Gemini', value: data.gemini_ready ? 'Ready' : 'Not Ready', status: data.gemini_ready},"
-"      {label:'Lights', value: data.lights_available ? 'Available' : 'Not Available', status: data.lights_available},"
-"      {label:'Firmware', value: data.firmware_version || '0.1'},"
-"      {label:'Free Heap', value: (data.free_heap / 1024).toFixed(1) + ' KB'},"
-"      {label:'Uptime', value: (data.uptime_seconds / 60).toFixed(1) + ' min'}"
-"    ];"
-"    items.forEach(item=>{"
-"      const div = document.createElement('div');"
-"      div.className = 'status-item';"
-"      div.innerHTML = `<label>${item.label}</label><div class='value ${item.status !== undefined ? (item.status ? 'status-on' : 'status-off') : ''}'>${item.value}</div>`;"
-"      grid.appendChild(div);"
-"    });"
-"  }).catch(e=>console.error('Status error:', e));"
-"}"
-"function setScene(scene) {"
-"  fetch('/api/led', {method:'POST', headers:{'Content-Type':'application/json'}, body:JSON.stringify({scene})})"
-"    .then(r=>r.json()).then(d=>alert(d.success ? 'Scene set!' : 'Error: ' + d.error))"
-"    .catch(e=>alert('Error: ' + e));"
-"}"
-"function setColor() {"
-"  const color = document.getElementById('led-color').value;"
-"  const brightness = parseInt(document.getElementById('led-brightness').value) / 100;"
-"  const r = parseInt(color.substr(1,2), 16);"
-"  const g = parseInt(color.substr(3,2), 16);"
-"  const b = parseInt(color.substr(5,2), 16);"
-"  fetch('/api/led', {method:'POST', headers:{'Content-Type':'application/json'}, body:JSON.stringify({r,g,b,brightness})})"
-"    .then(r=>r.json()).then(d=>alert(d.success ? 'Color set!' : 'Error: ' + d.error))"
-"    .catch(e=>alert('Error: ' + e));"
-"}"
-"function loadRules() {"
-"  fetch('/api/rules').then(r=>r.json()).then(data=>{"
-"    document.getElementById('rules-viewer').textContent = JSON.stringify(data, null, 2);"
-"  }).catch(e=>document.getElementById('rules-viewer').textContent = 'Error: ' + e);"
-"}"
-"let showSensorJson = false;"
-"function toggleSensorView() {"
-"  showSensorJson = !showSensorJson;"
-"  const grid = document.getElementById('sensor-grid');"
-"  const viewer = document.getElementById('sensors-viewer');"
-"  if (showSensorJson) {"
-"    grid.style.display = 'none';"
-"    viewer.style.display = 'block';"
-"  } else {"
-"    grid.style.display = 'grid';"
-"    viewer.style.display = 'none';"
-"  }"
-"}"
-"function loadSensors() {"
-"  fetch('/api/sensors').then(r=>r.json()).then(data=>{"
-"    const grid = document.getElementById('sensor-grid');"
-"    const viewer = document.getElementById('sensors-viewer');"
-"    grid.innerHTML = '';"
-"    viewer.textContent = JSON.stringify(data, null, 2);"
-"    "
-"    if (data.sensors) {"
-"      const s = data.sensors;"
-"      const items = [];"
-"      "
-"      if (s.temperature_c !== undefined) {"
-"        const synth = s.temperature_synthetic ? ' (synthetic)' : '';"
-"        items.push({label: 'Temperature', value: s.temperature_c.toFixed(1) + '°C' + synth, icon: '🌡️'});"
-"      }"
-"      if (s.humidity_rh !== undefined) {"
-"        const synth = s.humidity_synthetic ? ' (synthetic)' : '';"
-"        items.push({label: 'Humidity', value: s.humidity_rh.toFixed(1) + '%' + synth, icon: '💧'});"
-"      }"
-"      if (s.co2_ppm !== undefined) {"
-"        const synth = s.co2_synthetic ? ' (synthetic)' : '';"
-"        items.push({label: 'CO₂', value: s.co2_ppm.toFixed(0) + ' ppm' + synth, icon: '🌬️'});"
-"      }"
-"      if (s.voc_index !== undefined) {"
-"        const synth = s.voc_synthetic ? ' (synthetic)' : '';"
-"        items.push({label: 'VOC Index', value: s.voc_index + synth, icon: '💨'});"
-"      }"
-"      if (s.ambient_lux !== undefined) {"
-"        const synth = s.ambient_lux_synthetic ? ' (synthetic)' : '';"
-"        items.push({label: 'Ambient Light', value: s.ambient_lux + ' lux' + synth, icon: '💡'});"
-"      }"
-"      if (s.proximity !== undefined) {"
-"        const synth = s.proximity_synthetic ? ' (synthetic)' : '';"
-"        items.push({label: 'Proximity', value: s.proximity + synth, icon: '👋'});"
-"      }"
-"      if (s.pm2_5_ug_m3 !== undefined) {"
-"        const synth = s.pm2_5_synthetic ? ' (synthetic)' : '';"
-"        items.push({label: 'PM2.5', value: s.pm2_5_ug_m3.toFixed(1) + ' μg/m³' + synth, icon: '🌫️'});"
-"      }"
-"      "
-"      items.forEach(item=>{"
-"        const div = document.createElement('div');"
-"        div.className = 'status-item';"
-"        div.innerHTML = `<label>${item.icon} ${item.label}</label><div class='value'>${item.value}</div>`;"
-"        grid.appendChild(div);"
-"      });"
-"      "
-"      if (items.length === 0) {"
-"        grid.innerHTML = '<div class=\"status-item\"><label>No sensor data available</label></div>';"
-"      }"
-"    }"
-"  }).catch(e=>{"
-"    document.getElementById('sensor-grid').innerHTML = '<div class=\"status-item\"><label>Error</label><div class=\"value status-off\">' + e + '</div></div>';"
-"    document.getElementById('sensors-viewer').textContent = 'Error: ' + e;"
-"  });"
-"}"
-"let otaUpdateAvailable = false;"
-"let otaDownloadUrl = null;"
-"let otaLatestVersion = null;"
-"function loadOTAStatus() {"
-"  fetch('/api/ota/status').then(r=>r.json()).then(data=>{"
-"    const statusEl = document.getElementById('ota-status');"
-"    const progressContainer = document.getElementById('ota-progress-container');"
-"    const progressBar = document.getElementById('ota-progress-bar');"
-"    const infoEl = document.getElementById('ota-info');"
-"    const installBtn = document.getElementById('ota-install-btn');"
-"    "
-"    const statusNames = ['Idle', 'Checking', 'Update Available', 'Downloading', 'Installing', 'Success', 'Failed'];"
-"    const status = data.status !== undefined ? statusNames[data.status] || 'Unknown' : 'Unknown';"
-"    const message = data.status_message || 'Unknown';"
-"    const progress = data.progress || 0;"
-"    "
-"    statusEl.innerHTML = `<strong>Status:</strong> ${status}<br><small>${message}</small>`;"
-"    "
-"    if (data.status === 3 || data.status === 4) {"
-"      progressContainer.style.display = 'block';"
-"      progressBar.style.width = progress + '%';"
-"      progressBar.textContent = progress + '%';"
-"    } else {"
-"      progressContainer.style.display = 'none';"
-"    }"
-"    "
-"    if (data.status === 2) {"
-"      installBtn.style.display = 'inline-block';"
-"      infoEl.textContent = 'Update available! Click Install to update firmware.';"
-"    } else if (data.status === 5) {"
-"      infoEl.textContent = 'Update successful! Device will reboot shortly.';"
-"      installBtn.style.display = 'none';"
-"    } else if (data.status === 6) {"
-"      infoEl.textContent = 'Update failed. Check logs for details.';"
-"      installBtn.style.display = 'none';"
-"    } else {"
-"      installBtn.style.display = 'none';"
-"      infoEl.textContent = '';"
-"    }"
-"  }).catch(e=>{"
-"    document.getElementById('ota-status').textContent = 'OTA not available: ' + e;"
-"  });"
-"}"
-"function checkOTA() {"
-"  const btn = document.getElementById('ota-check-btn');"
-"  btn.disabled = true;"
-"  btn.textContent = 'Checking...';"
-"  document.getElementById('ota-status').textContent = 'Checking for updates...';"
-"  "
-"  fetch('/api/ota/check', {method:'POST'}).then(r=>r.json()).then(data=>{"
-"    btn.disabled = false;"
-"    btn.textContent = 'Check for Updates';"
-"    "
-"    if (data.success) {"
-"      if (data.available) {"
-"        otaUpdateAvailable = true;"
-"        otaDownloadUrl = data.download_url;"
-"        otaLatestVersion = data.latest_version;"
-"        document.getElementById('ota-status').innerHTML = `<strong>Update Available!</strong><br><small>Latest version: ${data.latest_version}</small>`;"
-"        document.getElementById('ota-info').textContent = `Version ${data.latest_version} is available. Click Install to update.`;"
-"        document.getElementById('ota-install-btn').style.display = 'inline-block';"
-"      } else {"
-"        document.getElementById('ota-status').innerHTML = '<strong>Up to Date</strong><br><small>No updates available</small>';"
-"        document.getElementById('ota-info').textContent = 'Your firmware is up to date.';"
-"        document.getElementById('ota-install-btn').style.display = 'none';"
-"      }"
-"    } else {"
-"      document.getElementById('ota-status').innerHTML = `<strong>Error</strong><br><small>${data.error || 'Failed to check for updates'}</small>`;"
-"      document.getElementById('ota-info').textContent = '';"
-"    }"
-"    loadOTAStatus();"
-"  }).catch(e=>{"
-"    btn.disabled = false;"
-"    btn.textContent = 'Check for Updates';"
-"    document.getElementById('ota-status').innerHTML = `<strong>Error</strong><br><small>${e.message}</small>`;"
-"  });"
-"}"
-"function installOTA() {"
-"  if (!confirm('This will install the firmware update and reboot the device. Continue?')) return;"
-"  "
-"  const btn = document.getElementById('ota-install-btn');"
-"  btn.disabled = true;"
-"  btn.textContent = 'Installing...';"
-"  document.getElementById('ota-status').textContent = 'Starting update installation...';"
-"  document.getElementById('ota-progress-container').style.display = 'block';"
-"  "
-"  const payload = otaDownloadUrl ? {url: otaDownloadUrl} : {};"
-"  "
-"  fetch('/api/ota/install', {"
-"    method:'POST',"
-"    headers:{'Content-Type':'application/json'},"
-"    body:JSON.stringify(payload)"
-"  }).then(r=>r.json()).then(data=>{"
-"    if (data.success) {"
-"      document.getElementById('ota-status').innerHTML = '<strong>Installing...</strong><br><small>Update in progress, device will reboot when complete</small>';"
-"      document.getElementById('ota-info').textContent = data.message || 'Update started successfully.';"
-"      "
-"      let progress = 0;"
-"      const progressInterval = setInterval(()=>{"
-"        progress = Math.min(progress + 2, 90);"
-"        const progressBar = document.getElementById('ota-progress-bar');"
-"        progressBar.style.width = progress + '%';"
-"        progressBar.textContent = progress + '%';"
-"        "
-"        loadOTAStatus();"
-"        "
-"        if (progress >= 90) clearInterval(progressInterval);"
-"      }, 500);"
-"    } else {"
-"      btn.disabled = false;"
-"      btn.textContent = 'Install Update';"
-"      document.getElementById('ota-status').innerHTML = `<strong>Error</strong><br><small>${data.error || 'Installation failed'}</small>`;"
-"      document.getElementById('ota-info').textContent = '';"
-"    }"
-"  }).catch(e=>{"
-"    btn.disabled = false;"
-"    btn.textContent = 'Install Update';"
-"    document.getElementById('ota-status').innerHTML = `<strong>Error</strong><br><small>${e.message}</small>`;"
-"  });"
-"}"
-"setInterval(()=>{ loadOTAStatus(); }, 2000);"
-"setInterval(refreshAll, 5000);"
-"function loadBLELogs() {"
-"  fetch('/api/ble/logs').then(r=>r.json()).then(data=>{"
-"    const viewer = document.getElementById('ble-log-viewer');"
-"    if (data.logs && data.logs.length > 0) {"
-"      let html = '';"
-"      data.logs.forEach((log, idx) => {"
-"        const time = new Date(log.timestamp_ms);"
-"        const timeStr = time.toLocaleTimeString();"
-"        const typeColors = {"
-"          'CONNECT': '#4CAF50',"
-"          'DISCONNECT': '#f44336',"
-"          'RX': '#2196F3',"
-"          'TX': '#FF9800',"
-"          'SUBSCRIBE': '#9C27B0'"
-"        };"
-"        const color = typeColors[log.type] || '#aaa';"
-"        html += `<div style='margin: 5px 0; padding: 5px; border-left: 3px solid ${color}; background: #2a2a2a;'>`;"
-"        html += `<span style='color: ${color}; font-weight: bold;'>[${log.type}]</span> `;"
-"        html += `<span style='color: #888;'>${timeStr}</span> `;"
-"        html += `<span style='color: #e0e0e0;'>${log.message}</span>`;"
-"        html += `</div>`;"
-"      });"
-"      viewer.innerHTML = html;"
-"      viewer.scrollTop = viewer.scrollHeight;"
-"    } else {"
-"      viewer.innerHTML = '<div style=\"color: #888; padding: 10px;\">No BLE logs yet</div>';"
-"    }"
-"  }).catch(e=>{"
-"    document.getElementById('ble-log-viewer').innerHTML = '<div style=\"color: #f44336;\">Error loading logs: ' + e + '</div>';"
-"  });"
-"}"
-"function clearBLELogs() {"
-"  document.getElementById('ble-log-viewer').innerHTML = '';"
-"}"
-"function loadSystemInfo() {"
-"  fetch('/api/system').then(r=>r.json()).then(data=>{"
-"    const memGrid = document.getElementById('memory-grid');"
-"    if (data.memory) {"
-"      const mem = data.memory;"
-"      const freeMB = (mem.free_bytes / 1024 / 1024).toFixed(2);"
-"      const minMB = (mem.min_free_bytes / 1024 / 1024).toFixed(2);"
-"      const largestMB = (mem.largest_free_block_bytes / 1024 / 1024).toFixed(2);"
-"      memGrid.innerHTML = '';"
-"      memGrid.innerHTML += '<div class=\"status-item\"><label>Free Heap</label><div class=\"value\">' + freeMB + ' MB</div></div>';"
-"      memGrid.innerHTML += '<div class=\"status-item\"><label>Min Free</label><div class=\"value\">' + minMB + ' MB</div></div>';"
-"      memGrid.innerHTML += '<div class=\"status-item\"><label>Largest Block</label><div class=\"value\">' + largestMB + ' MB</div></div>';"
-"      memGrid.innerHTML += '<div class=\"status-item\"><label>Free %</label><div class=\"value\">' + mem.free_percent + '%</div></div>';"
-"    }"
-"    const tasksTable = document.getElementById('tasks-table');"
-"    if (data.tasks && data.tasks.length > 0) {"
-"      let html = '<table style=\"width:100%; border-collapse: collapse; font-size: 0.9em;\">';"
-"      html += '<thead><tr style=\"background: #333; color: #64B5F6;\"><th style=\"padding: 8px; text-align: left; border-bottom: 2px solid #555;\">Task Name</th>';"
-"      html += '<th style=\"padding: 8px; text-align: left; border-bottom: 2px solid #555;\">State</th>';"
-"      html += '<th style=\"padding: 8px; text-align: right; border-bottom: 2px solid #555;\">Priority</th>';"
-"      html += '<th style=\"padding: 8px; text-align: right; border-bottom: 2px solid #555;\">Stack High Water (words)</th>';"
-"      html += '<th style=\"padding: 8px; text-align: right; border-bottom: 2px solid #555;\">Runtime</th></tr></thead><tbody>';"
-"      const stateNames = ['Running', 'Ready', 'Blocked', 'Suspended', 'Deleted'];"
-"      data.tasks.forEach(task => {"
-"        const stateName = stateNames[task.state] || 'Unknown';"
-"        const stackUsed = task.stack_high_water_mark || 0;"
-"        html += '<tr style=\"border-bottom: 1px solid #444;\">';"
-"        html += '<td style=\"padding: 8px; font-family: monospace;\">' + task.name + '</td>';"
-"        html += '<td style=\"padding: 8px;\">' + stateName + '</td>';"
-"        html += '<td style=\"padding: 8px; text-align: right;\">' + task.priority + '</td>';"
-"        html += '<td style=\"padding: 8px; text-align: right; color: ' + (stackUsed < 100 ? '#f44336' : stackUsed < 500 ? '#ff9800' : '#4CAF50') + ';\">' + stackUsed + '</td>';"
-"        html += '<td style=\"padding: 8px; text-align: right;\">' + (task.runtime || 0) + '</td>';"
-"        html += '</tr>';"
-"      });"
-"      html += '</tbody></table>';"
-"      tasksTable.innerHTML = html;"
-"    } else {"
-"      tasksTable.innerHTML = '<p style=\"color: #aaa;\">No task information available</p>';"
-"    }"
-"  }).catch(err=>{"
-"    console.error('Failed to load system info:', err);"
-"  });"
-"}"
-"function refreshAll() { loadStatus(); loadRules(); loadSensors(); loadOTAStatus(); loadBLELogs(); loadSystemInfo(); }"
-"setInterval(()=>{ loadOTAStatus(); }, 2000);"
-"setInterval(refreshAll, 5000);"
-"refreshAll();"
-"</script>"
-"</body></html>";
 
 // Helper to get content type (unused for now, kept for future use)
 __attribute__((unused)) static const char* get_content_type(const char *path) {
@@ -474,73 +112,106 @@ __attribute__((unused)) static const char* get_content_type(const char *path) {
     return "text/plain";
 }
 
+/**
+ * JSON responses for the API handlers go through json_writer in
+ * JSON_CHUNK_SIZE pieces, each sent with httpd_resp_send_chunk(), so a
+ * response costs no cJSON tree and no heap, however large it gets.
+ */
+typedef struct {
+    json_writer_t w;
+    httpd_req_t *req;
+    char buf[JSON_CHUNK_SIZE];
+} json_stream_t;
+
+static esp_err_t js_send_chunk(void *ctx, const char *data, size_t len) {
+    return httpd_resp_send_chunk((httpd_req_t *)ctx, data, len);
+}
+
+static void js_begin(json_stream_t *js, httpd_req_t *req) {
+    js->req = req;
+    json_writer_init_chunked(&js->w, js->buf, sizeof(js->buf), js_send_chunk, req);
+    httpd_resp_set_type(req, "application/json");
+}
+
+static esp_err_t js_end(json_stream_t *js) {
+    esp_err_t err = json_writer_finish(&js->w, NULL);
+    if (err == ESP_OK) {
+        err = httpd_resp_send_chunk(js->req, NULL, 0);
+    }
+    return err;
+}
+
 // Root handler - serve dashboard
 static esp_err_t root_handler(httpd_req_t *req) {
+    webserver_t *ws = (webserver_t *)req->user_ctx;
+    // Revalidation is cheap: a reload after the first visit costs one 304
+    char if_none_match[sizeof(ws->dashboard_etag)];
+    httpd_resp_set_hdr(req, "ETag", ws->dashboard_etag);
+    httpd_resp_set_hdr(req, "Cache-Control", "no-cache");
+    if (httpd_req_get_hdr_value_str(req, "If-None-Match", if_none_match, sizeof(if_none_match)) == ESP_OK &&
+        strcmp(if_none_match, ws->dashboard_etag) == 0) {
+        httpd_resp_set_status(req, "304 Not Modified");
+        return httpd_resp_send(req, NULL, 0);
+    }
+    // Only the compressed copy is in flash; every browser accepts gzip
     httpd_resp_set_type(req, "text/html");
-    httpd_resp_send(req, html_dashboard, HTTPD_RESP_USE_STRLEN);
-    return ESP_OK;
+    httpd_resp_set_hdr(req, "Content-Encoding", "gzip");
+    return httpd_resp_send(req, (const char *)dashboard_html_gz_start,
+                           dashboard_html_gz_end - dashboard_html_gz_start);
 }
 
 // API: Get device status
 static esp_err_t api_status_handler(httpd_req_t *req) {
     webserver_t *ws = (webserver_t *)req->user_ctx;
-    cJSON *json = cJSON_CreateObject();
-    
-    // Get device state JSON and merge it into our response
-    char *device_json = device_state_to_json();
-    if (device_json) {
-        cJSON *device_obj = cJSON_Parse(device_json);
-        if (device_obj) {
-            // Merge device state fields into root object by iterating child items
-            cJSON *item = device_obj->child;
-            while (item) {
-                cJSON *next = item->next;
-                cJSON_AddItemToObject(json, item->string, cJSON_Duplicate(item, 1));
-                item = next;
-            }
-            cJSON_Delete(device_obj);
+    device_state_snapshot_t state;
+    device_state_get(&state);
+
+    json_stream_t js;
+    js_begin(&js, req);
+    json_writer_begin_object(&js.w, NULL);
+    json_writer_bool(&js.w, "wifi_connected", wifi_manager_is_connected());
+    json_writer_string(&js.w, "wifi_ssid", state.wifi_ssid);
+    json_writer_bool(&js.w, "aws_connected", state.aws_connected);
+    json_writer_bool(&js.w, "spotify_ready", state.spotify_ready);
+    json_writer_bool(&js.w, "gemini_ready", state.gemini_ready);
+    json_writer_string(&js.w, "gemini_summary", state.gemini_summary);
+    json_writer_begin_object(&js.w, "leds");
+    json_writer_bool(&js.w, "enabled", state.lights_enabled);
+    json_writer_end_object(&js.w);
+    json_writer_begin_object(&js.w, "audio");
+    json_writer_bool(&js.w, "muted", state.audio_muted);
+    json_writer_bool(&js.w, "playing", state.audio_playing);
+    json_writer_end_object(&js.w);
+    if (state.i2c_summary[0]) {
+        if (state.i2c_summary_is_json) {
+            json_writer_raw(&js.w, "i2c_scan", state.i2c_summary);
+        } else {
+            json_writer_string(&js.w, "i2c_scan_raw", state.i2c_summary);
         }
-        free(device_json);
     }
-    
-    // Add/override system info
-    cJSON_AddBoolToObject(json, "wifi_connected", wifi_manager_is_connected());
-    cJSON_AddNumberToObject(json, "free_heap", esp_get_free_heap_size());
-    cJSON_AddNumberToObject(json, "uptime_seconds", esp_timer_get_time() / 1000000);
-    
-    // Get IP address
+
+    size_t free_heap = esp_get_free_heap_size();
+    json_writer_int(&js.w, "free_heap_bytes", free_heap);
+    json_writer_int(&js.w, "free_heap", free_heap);
+    json_writer_int(&js.w, "uptime_seconds", esp_timer_get_time() / 1000000);
+
     esp_netif_t *netif = esp_netif_get_handle_from_ifkey("WIFI_STA_DEF");
-    if (netif) {
-        esp_netif_ip_info_t ip_info;
-        if (esp_netif_get_ip_info(netif, &ip_info) == ESP_OK) {
-            char ip_str[16];
-            snprintf(ip_str, sizeof(ip_str), IPSTR, IP2STR(&ip_info.ip));
-            cJSON_AddStringToObject(json, "ip_address", ip_str);
-        }
+    esp_netif_ip_info_t ip_info;
+    if (netif && esp_netif_get_ip_info(netif, &ip_info) == ESP_OK) {
+        char ip_str[16];
+        snprintf(ip_str, sizeof(ip_str), IPSTR, IP2STR(&ip_info.ip));
+        json_writer_string(&js.w, "ip_address", ip_str);
     }
-    
-    // Get WiFi SSID (override if device_state didn't have it)
-    // Note: esp_wifi_sta_get_ap_info may not be available in all ESP-IDF versions
-    // Using device_state data instead which already has WiFi info
-    
-    // Add lights_available from config
-    cJSON_AddBoolToObject(json, "lights_available", ws->config.led_handle != NULL);
-    
-    // Add firmware version if OTA updater is available
+
+    json_writer_bool(&js.w, "lights_available", ws->config.led_handle != NULL);
+
+    const char *version = NULL;
     if (ws->config.ota_updater) {
-        ota_updater_t *ota = (ota_updater_t *)ws->config.ota_updater;
-        const char *version = ota_updater_get_current_version(ota);
-        cJSON_AddStringToObject(json, "firmware_version", version ? version : "0.1");
-    } else {
-        cJSON_AddStringToObject(json, "firmware_version", "0.1");
+        version = ota_updater_get_current_version((ota_updater_t *)ws->config.ota_updater);
     }
-    
-    char *json_str = cJSON_Print(json);
-    httpd_resp_set_type(req, "application/json");
-    httpd_resp_send(req, json_str, HTTPD_RESP_USE_STRLEN);
-    free(json_str);
-    cJSON_Delete(json);
-    return ESP_OK;
+    json_writer_string(&js.w, "firmware_version", version ? version : "0.1");
+    json_writer_end_object(&js.w);
+    return js_end(&js);
 }
 
 // API: Get rules
@@ -646,93 +317,145 @@ static esp_err_t api_led_handler(httpd_req_t *req) {
     return ESP_OK;
 }
 
+static bool sensors_range_point(size_t channel, uint32_t t_s, float value, void *ctx) {
+    json_stream_t *js = (json_stream_t *)ctx;
+    json_writer_begin_array(&js->w, NULL);
+    json_writer_int(&js->w, NULL, channel);
+    json_writer_int(&js->w, NULL, t_s);
+    json_writer_float(&js->w, NULL, value);
+    json_writer_end_array(&js->w);
+    return js->w.err == ESP_OK;
+}
+
+// ?from=&to= (Unix seconds), optional ch=<group>.<key> and tier=raw|1m|15m:
+// stored history instead of the live readings, points as [channel, t, value]
+static esp_err_t api_sensors_range(httpd_req_t *req, const char *query) {
+    char from[16] = "";
+    char to[16] = "";
+    char ch[48] = "";
+    char tier_name[8] = "";
+    httpd_query_key_value(query, "from", from, sizeof(from));
+    httpd_query_key_value(query, "to", to, sizeof(to));
+    httpd_query_key_value(query, "ch", ch, sizeof(ch));
+    httpd_query_key_value(query, "tier", tier_name, sizeof(tier_name));
+    uint32_t from_s = (uint32_t)strtoul(from, NULL, 10);
+    uint32_t to_s = (uint32_t)strtoul(to, NULL, 10);
+    int channel = ch[0] ? sensor_history_find_channel(ch) : -1;
+    sensor_history_tier_t tier = SENSOR_HISTORY_TIER_AUTO;
+    for (int t = 0; t < SENSOR_HISTORY_TIER_COUNT; ++t) {
+        if (strcmp(tier_name, sensor_history_tier_name((sensor_history_tier_t)t)) == 0) {
+            tier = (sensor_history_tier_t)t;
+        }
+    }
+
+    json_stream_t js;
+    js_begin(&js, req);
+    json_writer_begin_object(&js.w, NULL);
+    if (sensor_history_channel_count() == 0 || from_s > to_s || (ch[0] && channel < 0)) {
+        httpd_resp_set_status(req, sensor_history_channel_count() ? "400 Bad Request" : "503 Service Unavailable");
+        json_writer_string(&js.w, "error", sensor_history_channel_count() ? "Invalid range or channel" : "No sensor history");
+        json_writer_end_object(&js.w);
+        return js_end(&js);
+    }
+    if (tier == SENSOR_HISTORY_TIER_AUTO) {
+        tier = sensor_history_pick_tier(from_s, to_s);
+    }
+    json_writer_int(&js.w, "from", from_s);
+    json_writer_int(&js.w, "to", to_s);
+    json_writer_string(&js.w, "tier", sensor_history_tier_name(tier));
+    json_writer_begin_array(&js.w, "channels");
+    for (size_t c = 0; c < sensor_history_channel_count(); ++c) {
+        char name[48];
+        sensor_history_channel_name(c, name, sizeof(name));
+        json_writer_string(&js.w, NULL, name);
+    }
+    json_writer_end_array(&js.w);
+    json_writer_begin_array(&js.w, "points");
+    esp_err_t err = sensor_history_query(channel, from_s, to_s, tier, sensors_range_point, &js);
+    json_writer_end_array(&js.w);
+    if (err != ESP_OK) {
+        json_writer_string(&js.w, "error", esp_err_to_name(err));
+    }
+    json_writer_end_object(&js.w);
+    return js_end(&js);
+}
+
 // API: Get sensor data
 static esp_err_t api_sensors_handler(httpd_req_t *req) {
-    (void)req;
-    cJSON *json = cJSON_CreateObject();
-    
-    // Get sensor data from sensor integration
+    char query[128];
+    char from[16];
+    if (httpd_req_get_url_query_str(req, query, sizeof(query)) == ESP_OK &&
+        httpd_query_key_value(query, "from", from, sizeof(from)) == ESP_OK) {
+        return api_sensors_range(req, query);
+    }
+
     sensor_integration_data_t sensor_data = sensor_integration_get_data();
-    
-    // Add timestamp
-    cJSON_AddNumberToObject(json, "timestamp_ms", sensor_data.last_update_ms);
-    
-    // Create sensors object
-    cJSON *sensors = cJSON_CreateObject();
-    
+
+    json_stream_t js;
+    js_begin(&js, req);
+    json_writer_begin_object(&js.w, NULL);
+    json_writer_int(&js.w, "timestamp_ms", sensor_data.last_update_ms);
+    json_writer_begin_object(&js.w, "sensors");
+
     // SHT45 Temperature & Humidity
+    json_writer_bool(&js.w, "sht45_available", sensor_data.sht45_available);
     if (sensor_data.sht45_available) {
-        cJSON_AddBoolToObject(sensors, "sht45_available", true);
-        cJSON_AddNumberToObject(sensors, "temperature_c", sensor_data.temperature_c);
-        cJSON_AddNumberToObject(sensors, "humidity_rh", sensor_data.humidity_rh);
+        json_writer_float(&js.w, "temperature_c", sensor_data.temperature_c);
+        json_writer_float(&js.w, "humidity_rh", sensor_data.humidity_rh);
     } else {
-        cJSON_AddBoolToObject(sensors, "sht45_available", false);
         // Synthetic data for demo
-        cJSON_AddNumberToObject(sensors, "temperature_c", 22.5);
-        cJSON_AddNumberToObject(sensors, "humidity_rh", 45.0);
-        cJSON_AddBoolToObject(sensors, "temperature_synthetic", true);
-        cJSON_AddBoolToObject(sensors, "humidity_synthetic", true);
+        json_writer_float(&js.w, "temperature_c", 22.5);
+        json_writer_float(&js.w, "humidity_rh", 45.0);
+        json_writer_bool(&js.w, "temperature_synthetic", true);
+        json_writer_bool(&js.w, "humidity_synthetic", true);
     }
-    
+
     // SGP40 VOC
+    json_writer_bool(&js.w, "sgp40_available", sensor_data.sgp40_available);
     if (sensor_data.sgp40_available) {
-        cJSON_AddBoolToObject(sensors, "sgp40_available", true);
-        cJSON_AddNumberToObject(sensors, "voc_index", sensor_data.voc_index);
+        json_writer_int(&js.w, "voc_index", sensor_data.voc_index);
     } else {
-        cJSON_AddBoolToObject(sensors, "sgp40_available", false);
-        // Synthetic data
-        cJSON_AddNumberToObject(sensors, "voc_index", 150);
-        cJSON_AddBoolToObject(sensors, "voc_synthetic", true);
+        json_writer_int(&js.w, "voc_index", 150);
+        json_writer_bool(&js.w, "voc_synthetic", true);
     }
-    
+
     // SCD40 CO2, Temperature, Humidity
+    json_writer_bool(&js.w, "scd40_available", sensor_data.scd40_available);
     if (sensor_data.scd40_available) {
-        cJSON_AddBoolToObject(sensors, "scd40_available", true);
-        cJSON_AddNumberToObject(sensors, "co2_ppm", sensor_data.co2_ppm);
-        cJSON_AddNumberToObject(sensors, "temperature_co2_c", sensor_data.temperature_co2_c);
-        cJSON_AddNumberToObject(sensors, "humidity_co2_rh", sensor_data.humidity_co2_rh);
+        json_writer_float(&js.w, "co2_ppm", sensor_data.co2_ppm);
+        json_writer_float(&js.w, "temperature_co2_c", sensor_data.temperature_co2_c);
+        json_writer_float(&js.w, "humidity_co2_rh", sensor_data.humidity_co2_rh);
     } else {
-        cJSON_AddBoolToObject(sensors, "scd40_available", false);
-        // Synthetic data
-        cJSON_AddNumberToObject(sensors, "co2_ppm", 450);
-        cJSON_AddNumberToObject(sensors, "temperature_co2_c", 22.3);
-        cJSON_AddNumberToObject(sensors, "humidity_co2_rh", 44.5);
-        cJSON_AddBoolToObject(sensors, "co2_synthetic", true);
+        json_writer_int(&js.w, "co2_ppm", 450);
+        json_writer_float(&js.w, "temperature_co2_c", 22.3);
+        json_writer_float(&js.w, "humidity_co2_rh", 44.5);
+        json_writer_bool(&js.w, "co2_synthetic", true);
     }
-    
+
     // VCNL4040 Ambient Light & Proximity
+    json_writer_bool(&js.w, "vcnl4040_available", sensor_data.vcnl4040_available);
     if (sensor_data.vcnl4040_available) {
-        cJSON_AddBoolToObject(sensors, "vcnl4040_available", true);
-        cJSON_AddNumberToObject(sensors, "ambient_lux", sensor_data.ambient_lux);
-        cJSON_AddNumberToObject(sensors, "proximity", sensor_data.proximity);
+        json_writer_int(&js.w, "ambient_lux", sensor_data.ambient_lux);
+        json_writer_int(&js.w, "proximity", sensor_data.proximity);
     } else {
-        cJSON_AddBoolToObject(sensors, "vcnl4040_available", false);
-        // Synthetic data
-        cJSON_AddNumberToObject(sensors, "ambient_lux", 250);
-        cJSON_AddNumberToObject(sensors, "proximity", 0);
-        cJSON_AddBoolToObject(sensors, "ambient_lux_synthetic", true);
-        cJSON_AddBoolToObject(sensors, "proximity_synthetic", true);
+        json_writer_int(&js.w, "ambient_lux", 250);
+        json_writer_int(&js.w, "proximity", 0);
+        json_writer_bool(&js.w, "ambient_lux_synthetic", true);
+        json_writer_bool(&js.w, "proximity_synthetic", true);
     }
-    
+
     // EC10 PM2.5 (stored in ec_ms_per_cm field)
+    json_writer_bool(&js.w, "ec10_available", sensor_data.ec10_available);
     if (sensor_data.ec10_available) {
-        cJSON_AddBoolToObject(sensors, "ec10_available", true);
-        cJSON_AddNumberToObject(sensors, "pm2_5_ug_m3", sensor_data.ec_ms_per_cm);
+        json_writer_float(&js.w, "pm2_5_ug_m3", sensor_data.ec_ms_per_cm);
     } else {
-        cJSON_AddBoolToObject(sensors, "ec10_available", false);
-        // Synthetic data
-        cJSON_AddNumberToObject(sensors, "pm2_5_ug_m3", 12.5);
-        cJSON_AddBoolToObject(sensors, "pm2_5_synthetic", true);
+        json_writer_float(&js.w, "pm2_5_ug_m3", 12.5);
+        json_writer_bool(&js.w, "pm2_5_synthetic", true);
     }
-    
-    cJSON_AddItemToObject(json, "sensors", sensors);
-    
-    char *json_str = cJSON_Print(json);
-    httpd_resp_set_type(req, "application/json");
-    httpd_resp_send(req, json_str, HTTPD_RESP_USE_STRLEN);
-    free(json_str);
-    cJSON_Delete(json);
-    return ESP_OK;
+
+    json_writer_end_object(&js.w);
+    json_writer_end_object(&js.w);
+    return js_end(&js);
 }
 
 // API: General control endpoint
@@ -772,79 +495,121 @@ static esp_err_t api_ble_logs_handler(httpd_req_t *req) {
 
 // API: Get system info (memory and tasks)
 static esp_err_t api_system_handler(httpd_req_t *req) {
-    (void)req;
-    cJSON *json = cJSON_CreateObject();
-    
-    // Memory information
-    cJSON *memory = cJSON_CreateObject();
     size_t free_heap = esp_get_free_heap_size();
     size_t min_free_heap = esp_get_minimum_free_heap_size();
     size_t largest_free_block = heap_caps_get_largest_free_block(MALLOC_CAP_DEFAULT);
-    
+
     // Get total heap size (approximate - ESP32-S3 has ~512KB internal SRAM)
     multi_heap_info_t heap_info;
     heap_caps_get_info(&heap_info, MALLOC_CAP_DEFAULT);
     size_t total_heap = heap_info.total_free_bytes + heap_info.total_allocated_bytes;
     int free_percent = total_heap > 0 ? (int)((free_heap * 100) / total_heap) : 0;
-    
-    cJSON_AddNumberToObject(memory, "free_bytes", free_heap);
-    cJSON_AddNumberToObject(memory, "min_free_bytes", min_free_heap);
-    cJSON_AddNumberToObject(memory, "largest_free_block_bytes", largest_free_block);
-    cJSON_AddNumberToObject(memory, "total_bytes", total_heap);
-    cJSON_AddNumberToObject(memory, "allocated_bytes", heap_info.total_allocated_bytes);
-    cJSON_AddNumberToObject(memory, "free_percent", free_percent);
-    cJSON_AddItemToObject(json, "memory", memory);
-    
+
+    json_stream_t js;
+    js_begin(&js, req);
+    json_writer_begin_object(&js.w, NULL);
+    json_writer_begin_object(&js.w, "memory");
+    json_writer_int(&js.w, "free_bytes", free_heap);
+    json_writer_int(&js.w, "min_free_bytes", min_free_heap);
+    json_writer_int(&js.w, "largest_free_block_bytes", largest_free_block);
+    json_writer_int(&js.w, "total_bytes", total_heap);
+    json_writer_int(&js.w, "allocated_bytes", heap_info.total_allocated_bytes);
+    json_writer_int(&js.w, "free_percent", free_percent);
+    json_writer_end_object(&js.w);
+
     // FreeRTOS task information
     // Note: Detailed task info requires configUSE_TRACE_FACILITY=1 in FreeRTOS config
-    cJSON *tasks = cJSON_CreateArray();
     UBaseType_t num_tasks = uxTaskGetNumberOfTasks();
-    cJSON_AddNumberToObject(json, "num_tasks", num_tasks);
-    
-    // Try to get detailed task info if trace facility is enabled
+    json_writer_int(&js.w, "num_tasks", num_tasks);
+    json_writer_begin_array(&js.w, "tasks");
     #if configUSE_TRACE_FACILITY == 1
     TaskStatus_t *task_status_array = malloc(num_tasks * sizeof(TaskStatus_t));
     if (task_status_array) {
         UBaseType_t num_tasks_running = uxTaskGetSystemState(task_status_array, num_tasks, NULL);
-        
+
         for (UBaseType_t i = 0; i < num_tasks_running; i++) {
-            cJSON *task = cJSON_CreateObject();
-            cJSON_AddStringToObject(task, "name", task_status_array[i].pcTaskName);
-            cJSON_AddNumberToObject(task, "state", task_status_array[i].eCurrentState);
-            cJSON_AddNumberToObject(task, "priority", task_status_array[i].uxCurrentPriority);
-            cJSON_AddNumberToObject(task, "stack_high_water_mark", task_status_array[i].usStackHighWaterMark);
+            json_writer_begin_object(&js.w, NULL);
+            json_writer_string(&js.w, "name", task_status_array[i].pcTaskName);
+            json_writer_int(&js.w, "state", task_status_array[i].eCurrentState);
+            json_writer_int(&js.w, "priority", task_status_array[i].uxCurrentPriority);
+            json_writer_int(&js.w, "stack_high_water_mark", task_status_array[i].usStackHighWaterMark);
             #if configGENERATE_RUN_TIME_STATS == 1
-            cJSON_AddNumberToObject(task, "runtime", task_status_array[i].ulRunTimeCounter);
+            json_writer_int(&js.w, "runtime", task_status_array[i].ulRunTimeCounter);
             #else
-            cJSON_AddNumberToObject(task, "runtime", 0);
+            json_writer_int(&js.w, "runtime", 0);
             #endif
-            cJSON_AddItemToArray(tasks, task);
+            json_writer_end_object(&js.w);
         }
         free(task_status_array);
     }
+    json_writer_end_array(&js.w);
     #else
+    json_writer_end_array(&js.w);
     // Trace facility not enabled - just report task count
-    cJSON_AddStringToObject(json, "task_info_note", "Detailed task info requires configUSE_TRACE_FACILITY=1");
+    json_writer_string(&js.w, "task_info_note", "Detailed task info requires configUSE_TRACE_FACILITY=1");
     #endif
-    cJSON_AddItemToObject(json, "tasks", tasks);
-    
+
     // System uptime
-    cJSON_AddNumberToObject(json, "uptime_ms", esp_timer_get_time() / 1000);
-    
-    char *json_str = cJSON_Print(json);
-    httpd_resp_set_type(req, "application/json");
-    httpd_resp_send(req, json_str, HTTPD_RESP_USE_STRLEN);
-    free(json_str);
-    cJSON_Delete(json);
-    return ESP_OK;
+    json_writer_int(&js.w, "uptime_ms", esp_timer_get_time() / 1000);
+    json_writer_end_object(&js.w);
+    return js_end(&js);
+}
+
+// ota_status_t numbering, so the dashboard renders delta updates unchanged
+static int delta_status_code(ota_delta_state_t state) {
+    switch (state) {
+    case OTA_DELTA_VERIFYING_SOURCE:
+    case OTA_DELTA_DOWNLOADING:
+        return 3;
+    case OTA_DELTA_DONE:
+        return 5;
+    case OTA_DELTA_FAILED:
+        return 6;
+    default:
+        return 0;
+    }
+}
+
+static cJSON *delta_status_json(const ota_delta_status_t *st) {
+    cJSON *json = cJSON_CreateObject();
+    char message[96];
+    if (st->state == OTA_DELTA_VERIFYING_SOURCE) {
+        snprintf(message, sizeof(message), "Checking the running firmware against the patch");
+    } else if (st->state == OTA_DELTA_FAILED) {
+        snprintf(message, sizeof(message), "Delta update failed: %s", esp_err_to_name(st->error));
+    } else {
+        snprintf(message, sizeof(message), "Delta update: %u of %u patch bytes, %u resumes",
+                 (unsigned)st->patch_received, (unsigned)st->patch_size, st->resumes);
+    }
+    cJSON_AddNumberToObject(json, "status", delta_status_code(st->state));
+    cJSON_AddStringToObject(json, "status_message", message);
+    cJSON_AddNumberToObject(json, "progress", st->image_size ? (int)(100.0 * st->image_written / st->image_size) : 0);
+    cJSON_AddNumberToObject(json, "patch_bytes", st->patch_received);
+    cJSON_AddNumberToObject(json, "image_bytes", st->image_written);
+    return json;
+}
+
+static void delta_progress_cb(const ota_delta_status_t *status, void *ctx) {
+    webserver_t *ws = (webserver_t *)ctx;
+    if (!webserver_has_live_clients(ws)) {
+        return;
+    }
+    cJSON *data = delta_status_json(status);
+    webserver_push_json(ws, "ota", NULL, data);
+    cJSON_Delete(data);
 }
 
 // API: Get OTA status
 static esp_err_t api_ota_status_handler(httpd_req_t *req) {
     webserver_t *ws = (webserver_t *)req->user_ctx;
-    cJSON *json = cJSON_CreateObject();
+    cJSON *json;
+    ota_delta_status_t delta;
+    ota_delta_get_status(&delta);
     
-    if (ws->config.ota_updater) {
+    if (delta.state != OTA_DELTA_IDLE) {
+        json = delta_status_json(&delta);
+    } else if (ws->config.ota_updater) {
+        json = cJSON_CreateObject();
         ota_updater_t *ota = (ota_updater_t *)ws->config.ota_updater;
         ota_status_t status = ota_updater_get_status(ota);
         const char *status_msg = ota_updater_get_status_message(ota);
@@ -854,6 +619,7 @@ static esp_err_t api_ota_status_handler(httpd_req_t *req) {
         cJSON_AddStringToObject(json, "status_message", status_msg);
         cJSON_AddNumberToObject(json, "progress", progress);
     } else {
+        json = cJSON_CreateObject();
         cJSON_AddStringToObject(json, "error", "OTA updater not available");
     }
     
@@ -904,34 +670,50 @@ static esp_err_t api_ota_check_handler(httpd_req_t *req) {
     return ESP_OK;
 }
 
-// API: Install OTA update
+// API: Install OTA update. {"delta_url": ...} applies a patch made by
+// scripts/make_ota_delta.py instead of downloading a full image.
 static esp_err_t api_ota_install_handler(httpd_req_t *req) {
     webserver_t *ws = (webserver_t *)req->user_ctx;
     cJSON *json = cJSON_CreateObject();
     
-    if (!ws->config.ota_updater) {
+    // Read request body for optional URL
+    char content[512];
+    int ret = httpd_req_recv(req, content, sizeof(content) - 1);
+    cJSON *req_json = NULL;
+    const char *url = NULL;
+    const char *delta_url = NULL;
+    
+    if (ret > 0) {
+        content[ret] = '\0';
+        req_json = cJSON_Parse(content);
+        if (req_json) {
+            cJSON *url_item = cJSON_GetObjectItem(req_json, "url");
+            if (url_item && cJSON_IsString(url_item)) {
+                url = cJSON_GetStringValue(url_item);
+            }
+            cJSON *delta_item = cJSON_GetObjectItem(req_json, "delta_url");
+            if (delta_item && cJSON_IsString(delta_item)) {
+                delta_url = cJSON_GetStringValue(delta_item);
+            }
+        }
+    }
+    
+    if (!delta_url && !ws->config.ota_updater) {
         cJSON_AddBoolToObject(json, "success", false);
         cJSON_AddStringToObject(json, "error", "OTA updater not available");
     } else {
-        // Read request body for optional URL
-        char content[512];
-        int ret = httpd_req_recv(req, content, sizeof(content) - 1);
-        const char *url = NULL;
-        
-        if (ret > 0) {
-            content[ret] = '\0';
-            cJSON *req_json = cJSON_Parse(content);
-            if (req_json) {
-                cJSON *url_item = cJSON_GetObjectItem(req_json, "url");
-                if (url_item && cJSON_IsString(url_item)) {
-                    url = cJSON_GetStringValue(url_item);
-                }
-                cJSON_Delete(req_json);
-            }
+        esp_err_t err;
+        if (delta_url) {
+            ota_delta_config_t delta_cfg = {
+                .url = delta_url,
+                .reboot = true,
+                .progress_cb = delta_progress_cb,
+                .progress_ctx = ws,
+            };
+            err = ota_delta_start(&delta_cfg);
+        } else {
+            err = ota_updater_install((ota_updater_t *)ws->config.ota_updater, url);
         }
-        
-        ota_updater_t *ota = (ota_updater_t *)ws->config.ota_updater;
-        esp_err_t err = ota_updater_install(ota, url);
         cJSON_AddBoolToObject(json, "success", err == ESP_OK);
         if (err != ESP_OK) {
             cJSON_AddStringToObject(json, "error", esp_err_to_name(err));
@@ -939,6 +721,8 @@ static esp_err_t api_ota_install_handler(httpd_req_t *req) {
             cJSON_AddStringToObject(json, "message", "Update started, device will reboot");
         }
     }
+    // The URLs point into the request document, so it outlives the install call
+    cJSON_Delete(req_json);
     
     char *json_str = cJSON_Print(json);
     httpd_resp_set_type(req, "application/json");
@@ -948,6 +732,218 @@ static esp_err_t api_ota_install_handler(httpd_req_t *req) {
     return ESP_OK;
 }
 
+/*
+ * Slow endpoints (outbound HTTPS for the OTA check and install, large JSON
+ * for sensors and system) run on a small worker pool, so the dashboard
+ * assets and the other API calls keep being served while they do. The
+ * httpd task only takes an async copy of the request and queues it; the
+ * copy keeps its socket open until the worker completes it.
+ */
+static void async_worker_task(void *arg) {
+    webserver_t *ws = (webserver_t *)arg;
+    async_job_t job;
+    while (xQueueReceive(ws->async_jobs, &job, portMAX_DELAY) == pdTRUE && job.handler) {
+        esp_err_t err = job.handler(job.req);
+        if (err != ESP_OK) {
+            ESP_LOGW(TAG, "%s failed: %s", job.req->uri, esp_err_to_name(err));
+        }
+        httpd_req_async_handler_complete(job.req);
+    }
+    xSemaphoreGive(ws->async_exited);
+    vTaskDelete(NULL);
+}
+
+static esp_err_t async_dispatch(httpd_req_t *req) {
+    async_route_t *route = (async_route_t *)req->user_ctx;
+    // Only the httpd task queues, so the space cannot go between here and the send
+    if (uxQueueSpacesAvailable(route->ws->async_jobs) == 0) {
+        ESP_LOGW(TAG, "Handler workers busy; refusing %s", req->uri);
+        httpd_resp_set_status(req, "503 Service Unavailable");
+        httpd_resp_set_hdr(req, "Retry-After", "1");
+        return httpd_resp_send(req, NULL, 0);
+    }
+    httpd_req_t *copy = NULL;
+    esp_err_t err = httpd_req_async_handler_begin(req, &copy);
+    if (err != ESP_OK) {
+        return err;
+    }
+    // The handlers expect the server as their context, as when they ran inline
+    copy->user_ctx = route->ws;
+    async_job_t job = {.req = copy, .handler = route->handler};
+    xQueueSend(route->ws->async_jobs, &job, 0);
+    return ESP_OK;
+}
+
+// Register uri to run on the worker pool instead of the httpd task
+static esp_err_t register_async_uri(webserver_t *ws, httpd_uri_t *uri) {
+    if (ws->async_route_count >= ASYNC_ROUTES) {
+        return ESP_ERR_NO_MEM;
+    }
+    async_route_t *route = &ws->async_routes[ws->async_route_count++];
+    route->ws = ws;
+    route->handler = uri->handler;
+    uri->handler = async_dispatch;
+    uri->user_ctx = route;
+    return httpd_register_uri_handler(ws->server, uri);
+}
+
+static esp_err_t async_workers_start(webserver_t *ws) {
+    ws->async_jobs = xQueueCreate(ASYNC_QUEUE_LEN, sizeof(async_job_t));
+    ws->async_exited = xSemaphoreCreateCounting(ASYNC_WORKERS, 0);
+    if (!ws->async_jobs || !ws->async_exited) {
+        return ESP_ERR_NO_MEM;
+    }
+    for (int i = 0; i < ASYNC_WORKERS; i++) {
+        char name[16];
+        snprintf(name, sizeof(name), "httpd_async%d", i);
+        if (xTaskCreate(async_worker_task, name, ASYNC_STACK, ws, tskIDLE_PRIORITY + 5, NULL) != pdPASS) {
+            return ESP_ERR_NO_MEM;
+        }
+        ws->async_workers++;
+    }
+    return ESP_OK;
+}
+
+// Queued requests are finished first: the exit jobs go in behind them
+static void async_workers_stop(webserver_t *ws) {
+    const async_job_t quit = {0};
+    for (int i = 0; i < ws->async_workers; i++) {
+        xQueueSend(ws->async_jobs, &quit, portMAX_DELAY);
+    }
+    for (int i = 0; i < ws->async_workers; i++) {
+        xSemaphoreTake(ws->async_exited, portMAX_DELAY);
+    }
+    ws->async_workers = 0;
+    if (ws->async_jobs) {
+        vQueueDelete(ws->async_jobs);
+        ws->async_jobs = NULL;
+    }
+    if (ws->async_exited) {
+        vSemaphoreDelete(ws->async_exited);
+        ws->async_exited = NULL;
+    }
+}
+
+static void ws_add_client(webserver_t *ws, int fd) {
+    int free_slot = -1;
+    for (int i = 0; i < WS_MAX_CLIENTS; i++) {
+        if (ws->ws_fds[i] == fd) {
+            return;
+        }
+        if (ws->ws_fds[i] < 0 && free_slot < 0) {
+            free_slot = i;
+        }
+    }
+    if (free_slot >= 0) {
+        ws->ws_fds[free_slot] = fd;
+        __atomic_add_fetch(&ws->ws_clients, 1, __ATOMIC_RELAXED);
+    }
+}
+
+static void ws_remove_client(webserver_t *ws, int slot) {
+    ws->ws_fds[slot] = -1;
+    __atomic_sub_fetch(&ws->ws_clients, 1, __ATOMIC_RELAXED);
+}
+
+// Live events: the handshake registers the socket; frames from the client
+// are read and ignored (pings and closes are answered by httpd itself)
+static esp_err_t ws_handler(httpd_req_t *req) {
+    webserver_t *ws = (webserver_t *)req->user_ctx;
+    if (req->method == HTTP_GET) {
+        if (__atomic_load_n(&ws->ws_clients, __ATOMIC_RELAXED) >= WS_MAX_CLIENTS) {
+            ESP_LOGW(TAG, "Live event clients full; refusing socket %d", httpd_req_to_sockfd(req));
+            return ESP_FAIL;
+        }
+        ws_add_client(ws, httpd_req_to_sockfd(req));
+        return ESP_OK;
+    }
+
+    httpd_ws_frame_t frame = {0};
+    esp_err_t err = httpd_ws_recv_frame(req, &frame, 0);
+    if (err != ESP_OK || frame.len == 0) {
+        return err;
+    }
+    uint8_t scratch[64];
+    if (frame.len > sizeof(scratch)) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    frame.payload = scratch;
+    return httpd_ws_recv_frame(req, &frame, frame.len);
+}
+
+// Runs on the httpd task, which owns the client table
+static void ws_send_event(void *arg) {
+    ws_event_t *event = (ws_event_t *)arg;
+    webserver_t *ws = event->ws;
+    httpd_ws_frame_t frame = {
+        .final = true,
+        .type = HTTPD_WS_TYPE_TEXT,
+        .payload = (uint8_t *)event->text,
+        .len = event->len,
+    };
+    for (int i = 0; i < WS_MAX_CLIENTS; i++) {
+        int fd = ws->ws_fds[i];
+        if (fd < 0) {
+            continue;
+        }
+        // A closed socket number may have been reused by a plain HTTP client
+        if (httpd_ws_get_fd_info(ws->server, fd) != HTTPD_WS_CLIENT_WEBSOCKET ||
+            httpd_ws_send_frame_async(ws->server, fd, &frame) != ESP_OK) {
+            ws_remove_client(ws, i);
+        }
+    }
+    __atomic_sub_fetch(&ws->ws_pending, 1, __ATOMIC_RELAXED);
+    free(event->text);
+    free(event);
+}
+
+bool webserver_has_live_clients(webserver_t *server) {
+    return server && server->running && __atomic_load_n(&server->ws_clients, __ATOMIC_RELAXED) > 0;
+}
+
+esp_err_t webserver_push_json(webserver_t *server, const char *type, const char *name, const cJSON *data) {
+    if (!server || !type) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!webserver_has_live_clients(server)) {
+        return ESP_OK;
+    }
+    if (__atomic_add_fetch(&server->ws_pending, 1, __ATOMIC_RELAXED) > WS_MAX_PENDING) {
+        __atomic_sub_fetch(&server->ws_pending, 1, __ATOMIC_RELAXED);
+        return ESP_ERR_NO_MEM;
+    }
+
+    ws_event_t *event = calloc(1, sizeof(ws_event_t));
+    cJSON *root = cJSON_CreateObject();
+    if (event && root) {
+        cJSON_AddStringToObject(root, "type", type);
+        if (name) {
+            cJSON_AddStringToObject(root, "name", name);
+        }
+        if (data) {
+            // Reference, not a copy; deleting root leaves data alone
+            cJSON_AddItemReferenceToObject(root, "data", (cJSON *)data);
+        }
+        event->text = cJSON_PrintUnformatted(root);
+    }
+    cJSON_Delete(root);
+    if (!event || !event->text) {
+        free(event);
+        __atomic_sub_fetch(&server->ws_pending, 1, __ATOMIC_RELAXED);
+        return ESP_ERR_NO_MEM;
+    }
+    event->ws = server;
+    event->len = strlen(event->text);
+
+    esp_err_t err = httpd_queue_work(server->server, ws_send_event, event);
+    if (err != ESP_OK) {
+        free(event->text);
+        free(event);
+        __atomic_sub_fetch(&server->ws_pending, 1, __ATOMIC_RELAXED);
+    }
+    return err;
+}
+
 esp_err_t webserver_start(webserver_t **out_server, const webserver_config_t *cfg) {
     if (!out_server || !cfg) {
         return ESP_ERR_INVALID_ARG;
@@ -962,15 +958,29 @@ esp_err_t webserver_start(webserver_t **out_server, const webserver_config_t *cf
     if (ws->config.port <= 0) {
         ws->config.port = DEFAULT_PORT;
     }
+    for (int i = 0; i < WS_MAX_CLIENTS; i++) {
+        ws->ws_fds[i] = -1;
+    }
+
+    // The dashboard only changes with the firmware, so hash it once here
+    uint32_t hash = 2166136261u;
+    for (const uint8_t *p = dashboard_html_gz_start; p < dashboard_html_gz_end; p++) {
+        hash = (hash ^ *p) * 16777619u;
+    }
+    snprintf(ws->dashboard_etag, sizeof(ws->dashboard_etag), "\"%08" PRIx32 "\"", hash);
     
     httpd_config_t config = HTTPD_DEFAULT_CONFIG();
     config.server_port = ws->config.port;
-    config.max_uri_handlers = 10;
+    config.max_uri_handlers = 14;  // 12 registered below, plus headroom
     config.max_open_sockets = 7;
-    
-    esp_err_t err = httpd_start(&ws->server, &config);
+
+    esp_err_t err = async_workers_start(ws);
+    if (err == ESP_OK) {
+        err = httpd_start(&ws->server, &config);
+    }
     if (err != ESP_OK) {
         ESP_LOGE(TAG, "Failed to start HTTP server: %s", esp_err_to_name(err));
+        async_workers_stop(ws);
         free(ws);
         return err;
     }
@@ -1014,7 +1024,7 @@ esp_err_t webserver_start(webserver_t **out_server, const webserver_config_t *cf
         .handler = api_sensors_handler,
         .user_ctx = ws
     };
-    httpd_register_uri_handler(ws->server, &sensors_uri);
+    register_async_uri(ws, &sensors_uri);
     
     httpd_uri_t control_uri = {
         .uri = "/api/control",
@@ -1038,7 +1048,7 @@ esp_err_t webserver_start(webserver_t **out_server, const webserver_config_t *cf
         .handler = api_ota_check_handler,
         .user_ctx = ws
     };
-    httpd_register_uri_handler(ws->server, &ota_check_uri);
+    register_async_uri(ws, &ota_check_uri);
     
     httpd_uri_t ota_install_uri = {
         .uri = "/api/ota/install",
@@ -1046,7 +1056,7 @@ esp_err_t webserver_start(webserver_t **out_server, const webserver_config_t *cf
         .handler = api_ota_install_handler,
         .user_ctx = ws
     };
-    httpd_register_uri_handler(ws->server, &ota_install_uri);
+    register_async_uri(ws, &ota_install_uri);
     
     httpd_uri_t ble_logs_uri = {
         .uri = "/api/ble/logs",
@@ -1062,7 +1072,18 @@ esp_err_t webserver_start(webserver_t **out_server, const webserver_config_t *cf
         .handler = api_system_handler,
         .user_ctx = ws
     };
-    httpd_register_uri_handler(ws->server, &system_uri);
+    register_async_uri(ws, &system_uri);
+    
+    httpd_uri_t ws_uri = {
+        .uri = "/ws",
+        .method = HTTP_GET,
+        .handler = ws_handler,
+        .user_ctx = ws,
+        .is_websocket = true
+    };
+    if (httpd_register_uri_handler(ws->server, &ws_uri) != ESP_OK) {
+        ESP_LOGW(TAG, "Registering /ws failed; live events disabled");
+    }
     
     ws->running = true;
     *out_server = ws;
@@ -1077,6 +1098,8 @@ void webserver_stop(webserver_t *server) {
         return;
     }
     
+    // Workers finish their requests while the server can still send the replies
+    async_workers_stop(server);
     httpd_stop(server->server);
     server->running = false;
     free(server);
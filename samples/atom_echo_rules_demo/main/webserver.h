@@ -0,0 +1,43 @@
+#pragma once
+
+#include <stdbool.h>
+
+#include "cJSON.h"
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct webserver webserver_t;
+
+typedef struct {
+    int port;                 // <= 0 uses 80
+    void *led_handle;         // scene_controller_t *
+    void *rule_store;         // rule_store_t *
+    void *device_state;       // Unused; device_state is a singleton
+    void *ota_updater;        // ota_updater_t *
+} webserver_config_t;
+
+esp_err_t webserver_start(webserver_t **out_server, const webserver_config_t *cfg);
+void webserver_stop(webserver_t *server);
+bool webserver_is_running(webserver_t *server);
+
+/**
+ * Dashboards connected on /ws receive events as they happen instead of
+ * polling the REST endpoints. Each event is one text frame,
+ * {"type": type, "name": name, "data": data}, with name left out when NULL.
+ *
+ * Safe from any task: the event is serialised here and sent from the httpd
+ * task, so the caller never waits on a socket. Without live clients it
+ * returns straight away; with too many events already queued it drops this
+ * one and returns ESP_ERR_NO_MEM.
+ */
+esp_err_t webserver_push_json(webserver_t *server, const char *type, const char *name, const cJSON *data);
+
+// Lets producers skip building an event nobody would receive
+bool webserver_has_live_clients(webserver_t *server);
+
+#ifdef __cplusplus
+}
+#endif
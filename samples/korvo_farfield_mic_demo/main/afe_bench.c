@@ -0,0 +1,652 @@
+/**
+ * @file afe_bench.c
+ * @brief AFE configuration sweep over a replayed corpus
+ *
+ * Each configuration gets a fresh AFE instance and the whole corpus, paced
+ * at the capture rate so core loads read as they would with live
+ * microphones. The feed side reads the clips in capture-sized blocks,
+ * spreads each clip channel over the layout's microphones (zeros for the
+ * reference channel, as with nothing playing) and feeds whole AFE chunks;
+ * the fetch side drains results and maps each wake detection to the clip
+ * whose audio it came out of. The "replay_only" row is the harness on its
+ * own, to subtract from the others.
+ */
+
+#include "afe_bench.h"
+
+#include <dirent.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "esp_afe_config.h"
+#include "esp_afe_sr_iface.h"
+#include "esp_afe_sr_models.h"
+#include "esp_check.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_spiffs.h"
+#include "esp_timer.h"
+#include "esp_wn_iface.h"
+#include "esp_wn_models.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "model_path.h"
+#include "sdkconfig.h"
+
+static const char *TAG = "afe_bench";
+
+#define BENCH_SAMPLE_RATE 16000
+#define BENCH_CORPUS_MOUNT "/corpus"
+#define BENCH_MAX_CLIPS 256
+#define BENCH_MAX_CHANNELS 4            // Longest input layout, e.g. "MMNR"
+#define BENCH_WAV_CHANNELS 2
+#define BENCH_FEED_MARKS 128            // Feeds the fetch side may trail by
+#define BENCH_SETTLE_MS 500             // After the last clip, and between configurations
+#define BENCH_FETCH_WAIT_MS 100
+
+// Latencies kept per configuration for percentiles; longer runs are reservoir-sampled
+#define BENCH_MAX_SAMPLES 4096
+
+typedef struct {
+    const char *name;
+    const char *format;                 // AFE input layout; NULL replays without an AFE
+    afe_mode_t mode;
+    bool se;
+    bool ns;
+    bool agc;
+    bool vad;
+    uint16_t block_ms;                  // Capture block handed over at a time
+} bench_config_t;
+
+static const bench_config_t CONFIGS[] = {
+    // name               format  mode                se     ns     agc    vad    block_ms
+    {"replay_only",       NULL,   AFE_MODE_HIGH_PERF, false, false, false, false, 20},
+    // The firmware's full profile (voice_pipeline.c), then this sample's own
+    {"hp_mmr_full",       "MMR",  AFE_MODE_HIGH_PERF, true,  true,  true,  true,  20},
+    {"hp_mm_full",        "MM",   AFE_MODE_HIGH_PERF, true,  true,  true,  true,  20},
+    // One stage off at a time, then all of them
+    {"hp_mm_no_se",       "MM",   AFE_MODE_HIGH_PERF, false, true,  true,  true,  20},
+    {"hp_mm_no_ns",       "MM",   AFE_MODE_HIGH_PERF, true,  false, true,  true,  20},
+    {"hp_mm_no_agc",      "MM",   AFE_MODE_HIGH_PERF, true,  true,  false, true,  20},
+    {"hp_mm_no_vad",      "MM",   AFE_MODE_HIGH_PERF, true,  true,  true,  false, 20},
+    {"hp_mm_bare",        "MM",   AFE_MODE_HIGH_PERF, false, false, false, false, 20},
+    // The firmware's standby profile, then the low-cost mode on two and one microphones
+    {"lc_mr_standby",     "MR",   AFE_MODE_LOW_COST,  false, false, true,  true,  20},
+    {"lc_mm_full",        "MM",   AFE_MODE_LOW_COST,  true,  true,  true,  true,  20},
+    {"lc_m_ns",           "M",    AFE_MODE_LOW_COST,  false, true,  true,  true,  20},
+    // Capture blocks around the sample's 20 ms; the AFE chunk itself is fixed by the mode
+    {"hp_mm_full_10ms",   "MM",   AFE_MODE_HIGH_PERF, true,  true,  true,  true,  10},
+    {"hp_mm_full_32ms",   "MM",   AFE_MODE_HIGH_PERF, true,  true,  true,  true,  32},
+    {"hp_mm_full_64ms",   "MM",   AFE_MODE_HIGH_PERF, true,  true,  true,  true,  64},
+};
+
+#define BENCH_CONFIG_COUNT (sizeof(CONFIGS) / sizeof(CONFIGS[0]))
+
+typedef struct {
+    char path[72];
+    bool positive;
+    uint32_t frames;
+} bench_clip_t;
+
+typedef struct {
+    uint32_t *values;
+    size_t kept;
+    uint64_t count;
+    uint32_t rng;
+} bench_stat_t;
+
+typedef struct {
+    uint64_t end_frame;                 // Stream position just past the chunk
+    int64_t time_us;                    // When feed() returned
+} bench_mark_t;
+
+typedef struct {
+    const esp_afe_sr_iface_t *afe;
+    esp_afe_sr_data_t *data;
+    bench_clip_t *clips;
+    size_t clip_count;
+
+    // Written by the feed side, read by the fetch side
+    bench_mark_t marks[BENCH_FEED_MARKS];
+    uint32_t marks_written;
+    uint64_t *clip_start;               // Stream position of each clip's first frame
+    uint32_t clips_started;
+    bool stop;
+
+    // Fetch side results
+    uint16_t *detections;               // Per clip
+    bench_stat_t fetch_latency;         // Microseconds
+    uint32_t fetches;
+    TaskHandle_t waiter;
+} bench_run_t;
+
+// What afe_config_check() left of a configuration
+typedef struct {
+    bool aec;
+    bool se;
+    bool ns;
+    bool agc;
+    bool vad;
+    int feed_chunk;
+    int fetch_chunk;
+} bench_effective_t;
+
+static void stat_reset(bench_stat_t *s)
+{
+    s->kept = 0;
+    s->count = 0;
+    s->rng = 0x2545F491u;
+}
+
+static void stat_record(bench_stat_t *s, uint32_t value)
+{
+    s->count++;
+    if (s->kept < BENCH_MAX_SAMPLES) {
+        s->values[s->kept++] = value;
+        return;
+    }
+    // Fixed-seed LCG so reruns over the same corpus keep the same samples
+    s->rng = s->rng * 1664525u + 1013904223u;
+    uint64_t slot = s->rng % s->count;
+    if (slot < BENCH_MAX_SAMPLES) {
+        s->values[slot] = value;
+    }
+}
+
+static int cmp_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+// Sorts in place; call once all values are in
+static void stat_percentiles(bench_stat_t *s, uint32_t *p50, uint32_t *p99)
+{
+    if (s->kept == 0) {
+        *p50 = *p99 = 0;
+        return;
+    }
+    qsort(s->values, s->kept, sizeof(uint32_t), cmp_u32);
+    *p50 = s->values[(s->kept - 1) * 50 / 100];
+    *p99 = s->values[(s->kept - 1) * 99 / 100];
+}
+
+/**
+ * Open a 16 kHz 16-bit PCM WAV, mono or stereo, positioned at its first
+ * sample. Chunks other than fmt and data are skipped.
+ */
+static FILE *wav_open(const char *path, int *channels_out, uint32_t *frames_out)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        return NULL;
+    }
+    uint8_t riff[12];
+    if (fread(riff, 1, sizeof(riff), f) != sizeof(riff) || memcmp(riff, "RIFF", 4) || memcmp(riff + 8, "WAVE", 4)) {
+        fclose(f);
+        return NULL;
+    }
+    int channels = 0;
+    uint8_t hdr[8];
+    while (fread(hdr, 1, sizeof(hdr), f) == sizeof(hdr)) {
+        uint32_t len = hdr[4] | (hdr[5] << 8) | (hdr[6] << 16) | ((uint32_t)hdr[7] << 24);
+        if (!memcmp(hdr, "fmt ", 4) && len >= 16) {
+            uint8_t fmt[16];
+            if (fread(fmt, 1, sizeof(fmt), f) != sizeof(fmt)) {
+                break;
+            }
+            uint16_t format = fmt[0] | (fmt[1] << 8);
+            uint16_t count = fmt[2] | (fmt[3] << 8);
+            uint32_t rate = fmt[4] | (fmt[5] << 8) | (fmt[6] << 16) | ((uint32_t)fmt[7] << 24);
+            uint16_t bits = fmt[14] | (fmt[15] << 8);
+            bool ok = format == 1 && count >= 1 && count <= BENCH_WAV_CHANNELS && rate == BENCH_SAMPLE_RATE &&
+                      bits == 16;
+            channels = ok ? count : 0;
+            fseek(f, (long)(len - sizeof(fmt) + (len & 1)), SEEK_CUR);
+        } else if (!memcmp(hdr, "data", 4)) {
+            if (!channels) {
+                break;
+            }
+            *channels_out = channels;
+            *frames_out = len / (channels * sizeof(int16_t));
+            return f;
+        } else {
+            fseek(f, (long)(len + (len & 1)), SEEK_CUR);
+        }
+    }
+    fclose(f);
+    return NULL;
+}
+
+static void list_clips(const char *dir_path, bool positive, bench_clip_t *clips, size_t *count)
+{
+    DIR *dir = opendir(dir_path);
+    if (!dir) {
+        ESP_LOGW(TAG, "No clips under %s", dir_path);
+        return;
+    }
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL && *count < BENCH_MAX_CLIPS) {
+        size_t len = strlen(entry->d_name);
+        if (len < 4 || strcmp(entry->d_name + len - 4, ".wav") != 0) {
+            continue;
+        }
+        bench_clip_t *clip = &clips[*count];
+        snprintf(clip->path, sizeof(clip->path), "%s/%s", dir_path, entry->d_name);
+        int channels = 0;
+        FILE *f = wav_open(clip->path, &channels, &clip->frames);
+        if (!f) {
+            ESP_LOGW(TAG, "Skipping %s: not 16 kHz 16-bit mono or stereo PCM", entry->d_name);
+            continue;
+        }
+        fclose(f);
+        clip->positive = positive;
+        (*count)++;
+    }
+    closedir(dir);
+}
+
+static esp_err_t mount_corpus(void)
+{
+    esp_vfs_spiffs_conf_t conf = {
+        .base_path = BENCH_CORPUS_MOUNT,
+        .partition_label = "corpus",
+        .max_files = 2,
+        .format_if_mount_failed = false,
+    };
+    return esp_vfs_spiffs_register(&conf);
+}
+
+static void fetch_task(void *arg)
+{
+    bench_run_t *run = (bench_run_t *)arg;
+    uint64_t fetched = 0;
+    uint32_t mark = 0;
+    size_t clip = 0;
+    while (!__atomic_load_n(&run->stop, __ATOMIC_ACQUIRE)) {
+        afe_fetch_result_t *res = run->afe->fetch_with_delay(run->data, pdMS_TO_TICKS(BENCH_FETCH_WAIT_MS));
+        int64_t now_us = esp_timer_get_time();
+        if (!res || res->ret_value != ESP_OK || res->data_size <= 0) {
+            continue;
+        }
+        run->fetches++;
+        fetched += (size_t)res->data_size / sizeof(int16_t);
+
+        // Latency runs from the feed that completed these samples
+        uint32_t written = __atomic_load_n(&run->marks_written, __ATOMIC_ACQUIRE);
+        if (written - mark > BENCH_FEED_MARKS) {
+            mark = written - BENCH_FEED_MARKS;
+        }
+        while (mark < written && run->marks[mark % BENCH_FEED_MARKS].end_frame < fetched) {
+            mark++;
+        }
+        if (mark < written) {
+            stat_record(&run->fetch_latency, (uint32_t)(now_us - run->marks[mark % BENCH_FEED_MARKS].time_us));
+        }
+
+        if (res->wakeup_state == WAKENET_DETECTED) {
+            // A clip owns its trailing gap, so late detections still count for it
+            uint32_t started = __atomic_load_n(&run->clips_started, __ATOMIC_ACQUIRE);
+            while (clip + 1 < started && run->clip_start[clip + 1] <= fetched) {
+                clip++;
+            }
+            if (clip < run->clip_count) {
+                run->detections[clip]++;
+            }
+        }
+    }
+    xTaskNotifyGive(run->waiter);
+    vTaskDelete(NULL);
+}
+
+static esp_err_t afe_build(const bench_config_t *cfg, srmodel_list_t *models, char *wn_model, bench_run_t *run,
+                           bench_effective_t *eff)
+{
+    int mics = 0;
+    for (const char *c = cfg->format; *c; ++c) {
+        mics += *c == 'M';
+    }
+    afe_config_t *afe_config = afe_config_init(cfg->format, models, AFE_TYPE_SR, cfg->mode);
+    ESP_RETURN_ON_FALSE(afe_config, ESP_FAIL, TAG, "%s: afe_config_init failed", cfg->name);
+    // Same stage settings as init_afe() and voice_pipeline.c, less what the row turns off
+    afe_config->aec_init = strchr(cfg->format, 'R') != NULL;
+    afe_config->se_init = cfg->se;
+    afe_config->ns_init = cfg->ns;
+    afe_config->vad_init = cfg->vad;
+    afe_config->vad_mode = VAD_MODE_3;
+    afe_config->agc_init = cfg->agc;
+    afe_config->agc_mode = AFE_AGC_MODE_WAKENET;
+    afe_config->wakenet_init = wn_model != NULL;
+    afe_config->wakenet_model_name = wn_model;
+    afe_config->wakenet_mode = mics >= 2 && cfg->se ? DET_MODE_2CH_90 : DET_MODE_90;
+    if (!afe_parse_input_format(cfg->format, &afe_config->pcm_config)) {
+        afe_config_free(afe_config);
+        ESP_LOGE(TAG, "%s: bad input format '%s'", cfg->name, cfg->format);
+        return ESP_ERR_INVALID_ARG;
+    }
+    afe_config->pcm_config.sample_rate = BENCH_SAMPLE_RATE;
+    afe_config = afe_config_check(afe_config);
+    ESP_RETURN_ON_FALSE(afe_config, ESP_FAIL, TAG, "%s: afe_config_check failed", cfg->name);
+
+    eff->aec = afe_config->aec_init;
+    eff->se = afe_config->se_init;
+    eff->ns = afe_config->ns_init;
+    eff->agc = afe_config->agc_init;
+    eff->vad = afe_config->vad_init;
+    run->afe = esp_afe_handle_from_config(afe_config);
+    run->data = run->afe ? run->afe->create_from_config(afe_config) : NULL;
+    afe_config_free(afe_config);
+    ESP_RETURN_ON_FALSE(run->data, ESP_FAIL, TAG, "%s: AFE not created", cfg->name);
+
+    if (run->afe->get_feed_channel_num(run->data) != (int)strlen(cfg->format)) {
+        ESP_LOGE(TAG, "%s: AFE takes %d channels, layout has %d", cfg->name,
+                 run->afe->get_feed_channel_num(run->data), (int)strlen(cfg->format));
+        run->afe->destroy(run->data);
+        run->data = NULL;
+        return ESP_ERR_INVALID_STATE;
+    }
+    eff->feed_chunk = run->afe->get_feed_chunksize(run->data);
+    eff->fetch_chunk = run->afe->get_fetch_chunksize(run->data);
+
+    // Same 0-100 to 0.4-0.9999 mapping as init_afe()
+    int threshold = CONFIG_KORVO_FARFIELD_WAKE_WORD_THRESHOLD;
+    if (wn_model && threshold > 0 && threshold <= 100) {
+        run->afe->set_wakenet_threshold(run->data, 1, 0.4f + (threshold / 100.0f) * 0.5999f);
+    }
+    return ESP_OK;
+}
+
+static void idle_snapshot(uint32_t idle[portNUM_PROCESSORS], int64_t *now_us)
+{
+#if configGENERATE_RUN_TIME_STATS
+    for (int core = 0; core < portNUM_PROCESSORS; ++core) {
+        idle[core] = (uint32_t)ulTaskGetRunTimeCounter(xTaskGetIdleTaskHandleForCore(core));
+    }
+#else
+    memset(idle, 0, sizeof(uint32_t) * portNUM_PROCESSORS);
+#endif
+    *now_us = esp_timer_get_time();
+}
+
+/**
+ * Replay every clip, then its gap of silence, at the capture rate.
+ *
+ * @param layout Per feed channel, the microphone it carries or -1 for a
+ *               zero channel
+ */
+static esp_err_t replay(bench_run_t *run, const bench_config_t *cfg, const int8_t *layout, int channels, int chunk,
+                        bench_stat_t *feed_us, size_t *min_free_internal)
+{
+    const size_t block = (size_t)cfg->block_ms * BENCH_SAMPLE_RATE / 1000;
+    const uint32_t gap = (uint32_t)CONFIG_KORVO_FARFIELD_AFE_BENCH_GAP_MS * BENCH_SAMPLE_RATE / 1000;
+    int16_t *in = malloc(block * BENCH_WAV_CHANNELS * sizeof(int16_t));
+    int16_t *acc = malloc((chunk + block) * channels * sizeof(int16_t));
+    if (!in || !acc) {
+        free(in);
+        free(acc);
+        return ESP_ERR_NO_MEM;
+    }
+
+    uint64_t position = 0;
+    size_t acc_frames = 0;
+    TickType_t wake = xTaskGetTickCount();
+    for (size_t i = 0; i < run->clip_count; ++i) {
+        int wav_channels = 0;
+        uint32_t clip_frames = 0;
+        FILE *f = wav_open(run->clips[i].path, &wav_channels, &clip_frames);
+        if (!f) {
+            // Listed at start; skipped here with no frames so clip indexes stay aligned
+            ESP_LOGW(TAG, "%s vanished", run->clips[i].path);
+            clip_frames = 0;
+            wav_channels = 1;
+        }
+        run->clip_start[i] = position;
+        __atomic_store_n(&run->clips_started, (uint32_t)(i + 1), __ATOMIC_RELEASE);
+
+        uint32_t left = clip_frames + gap;
+        while (left) {
+            size_t n = left < block ? left : block;
+            size_t audio = clip_frames > 0 ? (clip_frames < n ? clip_frames : n) : 0;
+            size_t got = audio ? fread(in, wav_channels * sizeof(int16_t), audio, f) : 0;
+            memset(in + got * wav_channels, 0, (n - got) * wav_channels * sizeof(int16_t));
+            clip_frames -= audio;
+            left -= n;
+
+            int16_t *dst = acc + acc_frames * channels;
+            for (size_t j = 0; j < n; ++j) {
+                for (int c = 0; c < channels; ++c) {
+                    *dst++ = layout[c] < 0 ? 0 : in[j * wav_channels + layout[c] % wav_channels];
+                }
+            }
+            acc_frames += n;
+            position += n;
+
+            while (run->data && acc_frames >= (size_t)chunk) {
+                int64_t t0 = esp_timer_get_time();
+                run->afe->feed(run->data, acc);
+                int64_t t1 = esp_timer_get_time();
+                stat_record(feed_us, (uint32_t)(t1 - t0));
+                uint32_t written = run->marks_written;
+                run->marks[written % BENCH_FEED_MARKS] = (bench_mark_t){
+                    .end_frame = position - (acc_frames - chunk),
+                    .time_us = t1,
+                };
+                __atomic_store_n(&run->marks_written, written + 1, __ATOMIC_RELEASE);
+                acc_frames -= chunk;
+                memmove(acc, acc + (size_t)chunk * channels, acc_frames * channels * sizeof(int16_t));
+            }
+            if (!run->data) {
+                acc_frames = 0;
+            }
+
+            size_t free_internal = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+            if (free_internal < *min_free_internal) {
+                *min_free_internal = free_internal;
+            }
+            vTaskDelayUntil(&wake, pdMS_TO_TICKS(cfg->block_ms));
+        }
+        if (f) {
+            fclose(f);
+        }
+    }
+    free(in);
+    free(acc);
+    return ESP_OK;
+}
+
+static void run_config(const bench_config_t *cfg, bench_run_t *run, srmodel_list_t *models, char *wn_model,
+                       bench_stat_t *feed_us)
+{
+    bench_effective_t eff = {0};
+    int8_t layout[BENCH_MAX_CHANNELS] = {0, 1};
+    int channels = 2;
+    int chunk = 0;
+    memset(run->marks, 0, sizeof(run->marks));
+    run->marks_written = 0;
+    run->clips_started = 0;
+    run->stop = false;
+    run->afe = NULL;
+    run->data = NULL;
+    run->fetches = 0;
+    memset(run->detections, 0, run->clip_count * sizeof(run->detections[0]));
+    stat_reset(&run->fetch_latency);
+    stat_reset(feed_us);
+
+    vTaskDelay(pdMS_TO_TICKS(BENCH_SETTLE_MS));
+    size_t internal_before = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+    size_t psram_before = heap_caps_get_free_size(MALLOC_CAP_SPIRAM);
+    if (cfg->format) {
+        channels = (int)strlen(cfg->format);
+        if (channels > BENCH_MAX_CHANNELS) {
+            ESP_LOGE(TAG, "%s: more than %d channels", cfg->name, BENCH_MAX_CHANNELS);
+            return;
+        }
+        int mic = 0;
+        for (int c = 0; c < channels; ++c) {
+            layout[c] = cfg->format[c] == 'M' ? mic++ : -1;
+        }
+        if (afe_build(cfg, models, wn_model, run, &eff) != ESP_OK) {
+            printf("BENCH run=afe config=%s format=%s error=create\n", cfg->name, cfg->format);
+            return;
+        }
+        chunk = eff.feed_chunk;
+    } else {
+        chunk = cfg->block_ms * BENCH_SAMPLE_RATE / 1000;
+    }
+    size_t internal_afe = internal_before - heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+    size_t psram_afe = psram_before - heap_caps_get_free_size(MALLOC_CAP_SPIRAM);
+
+    run->waiter = xTaskGetCurrentTaskHandle();
+    if (run->data &&
+        xTaskCreatePinnedToCore(fetch_task, "afe_fetch", 4096, run, 5, NULL, 1) != pdPASS) {
+        ESP_LOGE(TAG, "%s: no fetch task", cfg->name);
+        run->afe->destroy(run->data);
+        return;
+    }
+
+    uint32_t idle_start[portNUM_PROCESSORS], idle_end[portNUM_PROCESSORS];
+    int64_t start_us, end_us;
+    size_t min_free_internal = internal_before;
+    idle_snapshot(idle_start, &start_us);
+    esp_err_t err = replay(run, cfg, layout, channels, chunk, feed_us, &min_free_internal);
+    idle_snapshot(idle_end, &end_us);
+
+    if (run->data) {
+        // Let the fetch side drain what is still in the AFE before stopping it
+        vTaskDelay(pdMS_TO_TICKS(BENCH_SETTLE_MS));
+        __atomic_store_n(&run->stop, true, __ATOMIC_RELEASE);
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        run->afe->destroy(run->data);
+        run->data = NULL;
+    }
+    if (err != ESP_OK) {
+        printf("BENCH run=afe config=%s error=%s\n", cfg->name, esp_err_to_name(err));
+        return;
+    }
+    vTaskDelay(pdMS_TO_TICKS(BENCH_SETTLE_MS));
+    int leak = (int)internal_before - (int)heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+
+    uint32_t positives = 0, detected = 0, negatives = 0, false_accepts = 0;
+    uint64_t negative_frames = 0;
+    for (size_t i = 0; i < run->clip_count; ++i) {
+        if (run->clips[i].positive) {
+            positives++;
+            detected += run->detections[i] > 0;
+        } else {
+            negatives++;
+            false_accepts += run->detections[i];
+            negative_frames += run->clips[i].frames;
+        }
+    }
+    uint32_t feed_p50, feed_p99, fetch_p50, fetch_p99;
+    stat_percentiles(feed_us, &feed_p50, &feed_p99);
+    stat_percentiles(&run->fetch_latency, &fetch_p50, &fetch_p99);
+    double negative_hours = (double)negative_frames / BENCH_SAMPLE_RATE / 3600.0;
+
+    // One line per configuration with stable keys, so runs can be diffed or tabulated by a script
+    printf("BENCH run=afe config=%s format=%s mode=%s aec=%d se=%d ns=%d agc=%d vad=%d block_ms=%u feed_chunk=%d "
+           "fetch_chunk=%d",
+           cfg->name, cfg->format ? cfg->format : "none", cfg->mode == AFE_MODE_LOW_COST ? "low_cost" : "high_perf",
+           eff.aec, eff.se, eff.ns, eff.agc, eff.vad, cfg->block_ms, eff.feed_chunk, eff.fetch_chunk);
+    double elapsed_us = (double)(end_us - start_us);
+    for (int core = 0; core < portNUM_PROCESSORS; ++core) {
+#if configGENERATE_RUN_TIME_STATS
+        double busy = 100.0 - 100.0 * (double)(idle_end[core] - idle_start[core]) / elapsed_us;
+        printf(" core%d_pct=%.1f", core, busy < 0.0 ? 0.0 : busy);
+#else
+        printf(" core%d_pct=na", core);
+#endif
+    }
+    printf(" internal_kb=%.1f psram_kb=%.1f peak_internal_kb=%.1f leak_b=%d feed_p50_us=%" PRIu32
+           " feed_p99_us=%" PRIu32 " fetch_p50_ms=%.1f fetch_p99_ms=%.1f fetches=%" PRIu32,
+           internal_afe / 1024.0, psram_afe / 1024.0, (internal_before - min_free_internal) / 1024.0, leak, feed_p50,
+           feed_p99, fetch_p50 / 1000.0, fetch_p99 / 1000.0, run->fetches);
+    if (cfg->format && wn_model) {
+        printf(" positives=%" PRIu32 " detection_pct=%.1f negatives=%" PRIu32 " false_accepts=%" PRIu32
+               " fa_per_hour=%.2f\n",
+               positives, positives ? detected * 100.0 / positives : 0.0, negatives, false_accepts,
+               negative_hours > 0.0 ? false_accepts / negative_hours : 0.0);
+    } else {
+        printf(" detection=na\n");
+    }
+}
+
+static void bench_task(void *arg)
+{
+    (void)arg;
+    bench_run_t *run = calloc(1, sizeof(*run));
+    bench_stat_t feed_us = {0};
+    srmodel_list_t *models = NULL;
+    if (!run) {
+        ESP_LOGE(TAG, "Out of memory");
+        goto done;
+    }
+    if (mount_corpus() != ESP_OK) {
+        ESP_LOGE(TAG, "No corpus partition; build with -DAFE_BENCH_CORPUS_DIR=<dir> and flash");
+        goto done;
+    }
+    run->clips = calloc(BENCH_MAX_CLIPS, sizeof(bench_clip_t));
+    run->clip_start = calloc(BENCH_MAX_CLIPS, sizeof(uint64_t));
+    run->detections = calloc(BENCH_MAX_CLIPS, sizeof(uint16_t));
+    run->fetch_latency.values = malloc(BENCH_MAX_SAMPLES * sizeof(uint32_t));
+    feed_us.values = malloc(BENCH_MAX_SAMPLES * sizeof(uint32_t));
+    if (!run->clips || !run->clip_start || !run->detections || !run->fetch_latency.values || !feed_us.values) {
+        ESP_LOGE(TAG, "Out of memory");
+        goto done;
+    }
+    list_clips(BENCH_CORPUS_MOUNT "/positive", true, run->clips, &run->clip_count);
+    list_clips(BENCH_CORPUS_MOUNT "/negative", false, run->clips, &run->clip_count);
+    if (run->clip_count == 0) {
+        ESP_LOGE(TAG, "No WAVs under the corpus positive/ and negative/ directories");
+        goto done;
+    }
+
+    // Without a WakeNet model the sweep still measures cost, just not detection
+    models = esp_srmodel_init("model");
+    char *wn_model = NULL;
+    if (models && models->num > 0) {
+        wn_model = esp_srmodel_filter(models, ESP_WN_PREFIX, (char *)CONFIG_KORVO_FARFIELD_WAKE_WORD_MODEL);
+        if (!wn_model) {
+            wn_model = esp_srmodel_filter(models, ESP_WN_PREFIX, NULL);
+        }
+    }
+    uint64_t frames = 0;
+    for (size_t i = 0; i < run->clip_count; ++i) {
+        frames += run->clips[i].frames;
+    }
+    ESP_LOGI(TAG, "%u clips, %.1f s of audio, wake word model %s; %u configurations", (unsigned)run->clip_count,
+             (double)frames / BENCH_SAMPLE_RATE, wn_model ? wn_model : "none", (unsigned)BENCH_CONFIG_COUNT);
+#if !configGENERATE_RUN_TIME_STATS
+    ESP_LOGW(TAG, "Built without CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS; no core loads");
+#endif
+
+    for (size_t i = 0; i < BENCH_CONFIG_COUNT; ++i) {
+        ESP_LOGI(TAG, "[%u/%u] %s", (unsigned)(i + 1), (unsigned)BENCH_CONFIG_COUNT, CONFIGS[i].name);
+        run_config(&CONFIGS[i], run, models, wn_model, &feed_us);
+    }
+    printf("BENCH run=afe done configs=%u clips=%u\n", (unsigned)BENCH_CONFIG_COUNT, (unsigned)run->clip_count);
+
+done:
+    if (models) {
+        esp_srmodel_deinit(models);
+    }
+    if (run) {
+        free(run->clips);
+        free(run->clip_start);
+        free(run->detections);
+        free(run->fetch_latency.values);
+    }
+    free(feed_us.values);
+    free(run);
+    vTaskDelete(NULL);
+}
+
+esp_err_t afe_bench_start(void)
+{
+    BaseType_t ok = xTaskCreatePinnedToCore(bench_task, "afe_bench", 6144, NULL, 5, NULL, 0);
+    return ok == pdPASS ? ESP_OK : ESP_ERR_NO_MEM;
+}
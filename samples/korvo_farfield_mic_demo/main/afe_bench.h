@@ -0,0 +1,28 @@
+#pragma once
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * AFE configuration sweep over a replayed corpus.
+ *
+ * Builds one AFE instance per entry of the sweep table (input layout, mode,
+ * SE/NS/AGC/VAD, capture block size), replays every clip under
+ * /corpus/positive and /corpus/negative through it in real time, and prints
+ * one "BENCH run=afe" line per configuration: load on each core, the AFE's
+ * internal and PSRAM footprint, feed call and feed-to-fetch latency, and
+ * the wake word detection and false-accept rates.
+ *
+ * Runs in its own task pinned to core 0, with the fetch side on core 1,
+ * and returns at once.
+ *
+ * @return ESP_ERR_NO_MEM if the task could not be created
+ */
+esp_err_t afe_bench_start(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -22,6 +22,10 @@
 #include "model_path.h"
 #endif
 
+#if CONFIG_KORVO_FARFIELD_AFE_BENCH
+#include "afe_bench.h"
+#endif
+
 static const char *TAG = "farfield_mic";
 
 // LED configuration
@@ -897,6 +901,12 @@ void app_main(void)
     ESP_LOGI(TAG, "Sample Rate: %d Hz, Frame Size: %d ms (%d samples)",
              SAMPLE_RATE_HZ, FRAME_SIZE_MS, SAMPLES_PER_FRAME);
     
+#if CONFIG_KORVO_FARFIELD_AFE_BENCH
+    // Benchmark build: the corpus replaces the microphones, and LEDs and I2S stay off so they don't load the cores
+    ESP_ERROR_CHECK(afe_bench_start());
+    return;
+#endif
+    
     // Initialize LED strip
     led_strip_config_t strip_config = {
         .strip_gpio_num = LED_GPIO,
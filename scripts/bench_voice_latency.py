@@ -0,0 +1,158 @@
+#!/usr/bin/env python3
+"""
+End-to-end voice latency benchmark against scripts/mock_cloud_server.py.
+
+Needs firmware built with CONFIG_KVA_BENCH_MODE=1. Uploads a recorded
+utterance (16 kHz mono WAV, wake word included) over the serial link, then
+plays it into the capture path once per run with the BENCH command and
+reads the interaction_trace line each run ends in. Reports the median and
+p90 of every span, wake to first_dma_write being the headline number.
+
+With --baseline, the run fails (exit 1) when the headline median regresses
+by more than --max-regression-pct against a previous --json report.
+
+Examples:
+  bench_voice_latency.py /dev/ttyACM0 utterance.wav --runs 20
+  bench_voice_latency.py /dev/ttyACM0 utterance.wav --json bench.json
+  bench_voice_latency.py /dev/ttyACM0 utterance.wav --baseline bench.json --max-regression-pct 10
+"""
+
+import argparse
+import json
+import re
+import struct
+import sys
+import time
+import wave
+
+from serial_link import CAPTURE_RATE_HZ, FRAME_BENCH_AUDIO, SerialLink
+
+HEADLINE = "wake->first_dma_write"
+# Mono frames per BENCH_AUDIO frame: an 8-byte header plus PCM within the 1024-byte payload
+PIECE_FRAMES = 508
+TRACE_RE = re.compile(r"interaction_trace: #(\d+) from (\w+):(.*)")
+POINT_RE = re.compile(r"(\w+)=([+-]\d+\.\d+) ms")
+ANSI_RE = re.compile(r"\x1b\[[0-9;]*m")
+SPANS = [
+    ("wake", "vad_offset"),
+    ("vad_offset", "uplink_first_byte"),
+    ("vad_offset", "stt_final"),
+    ("stt_final", "llm_first_token"),
+    ("llm_first_token", "tts_first_byte"),
+    ("tts_first_byte", "first_dma_write"),
+    ("vad_offset", "first_dma_write"),
+    ("wake", "first_dma_write"),
+]
+
+
+def load_utterance(path):
+    with wave.open(path, "rb") as wav:
+        if wav.getnchannels() != 1 or wav.getsampwidth() != 2 or wav.getframerate() != CAPTURE_RATE_HZ:
+            sys.exit(f"{path}: need 16-bit mono at {CAPTURE_RATE_HZ} Hz")
+        return wav.readframes(wav.getnframes())
+
+
+def upload(link, pcm):
+    total = len(pcm) // 2
+    for first in range(0, total, PIECE_FRAMES):
+        piece = pcm[first * 2:(first + PIECE_FRAMES) * 2]
+        status = link.request(FRAME_BENCH_AUDIO, struct.pack("<II", total, first) + piece)
+        if status != 0:
+            sys.exit(f"BENCH_AUDIO at frame {first} failed: {status:#x} (is this a KVA_BENCH_MODE build?)")
+    print(f"Uploaded {total} frames ({total * 1000 // CAPTURE_RATE_HZ} ms)")
+
+
+def run_once(link, timeout):
+    """Play the utterance once; returns {point: ms from the origin} or None."""
+    traces = []
+
+    def on_text(line):
+        match = TRACE_RE.search(ANSI_RE.sub("", line))
+        if match:
+            points = {match.group(2): 0.0}
+            points.update({name: float(ms) for name, ms in POINT_RE.findall(match.group(3))})
+            traces.append(points)
+
+    link.on_text = on_text
+    status = link.command("BENCH")
+    if status != 0:
+        print(f"BENCH failed: {status:#x}")
+        return None
+    deadline = time.monotonic() + timeout
+    while time.monotonic() < deadline and not traces:
+        link.poll()
+    link.on_text = lambda line: None
+    return traces[0] if traces else None
+
+
+def percentile(values, pct):
+    ordered = sorted(values)
+    rank = (len(ordered) - 1) * pct / 100
+    low = int(rank)
+    high = min(low + 1, len(ordered) - 1)
+    return ordered[low] + (ordered[high] - ordered[low]) * (rank - low)
+
+
+def summarize(runs):
+    report = {}
+    for start, end in SPANS:
+        values = [r[end] - r[start] for r in runs if start in r and end in r]
+        if values:
+            report[f"{start}->{end}"] = {
+                "n": len(values),
+                "median_ms": round(percentile(values, 50), 3),
+                "p90_ms": round(percentile(values, 90), 3),
+            }
+    return report
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("port")
+    parser.add_argument("utterance", help="16 kHz mono WAV with the wake word and a request")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--runs", type=int, default=10)
+    parser.add_argument("--timeout", type=float, default=20.0, help="seconds to wait for each run's trace")
+    parser.add_argument("--gap", type=float, default=3.0, help="seconds between runs, for playback to finish")
+    parser.add_argument("--json", help="write the report here")
+    parser.add_argument("--baseline", help="a previous --json report to compare against")
+    parser.add_argument("--max-regression-pct", type=float, default=10.0)
+    args = parser.parse_args()
+
+    link = SerialLink(args.port, args.baud)
+    upload(link, load_utterance(args.utterance))
+
+    runs = []
+    for i in range(args.runs):
+        points = run_once(link, args.timeout)
+        if points is None or "first_dma_write" not in points:
+            print(f"run {i + 1}: incomplete {points}")
+        else:
+            print(f"run {i + 1}: {HEADLINE} {points['first_dma_write'] - points.get('wake', 0.0):.1f} ms")
+            runs.append(points)
+        time.sleep(args.gap)
+
+    report = summarize(runs)
+    print(f"\n{len(runs)}/{args.runs} complete runs")
+    for span, stats in report.items():
+        print(f"  {span:36s} median {stats['median_ms']:9.1f} ms   p90 {stats['p90_ms']:9.1f} ms   (n={stats['n']})")
+    if args.json:
+        with open(args.json, "w") as f:
+            json.dump({"runs": args.runs, "complete": len(runs), "spans": report}, f, indent=2)
+
+    if HEADLINE not in report:
+        sys.exit("no run reached first_dma_write")
+    if args.baseline:
+        with open(args.baseline) as f:
+            base = json.load(f)["spans"].get(HEADLINE)
+        if base:
+            now = report[HEADLINE]["median_ms"]
+            change = (now - base["median_ms"]) * 100 / base["median_ms"]
+            print(f"\n{HEADLINE} median {now:.1f} ms vs baseline {base['median_ms']:.1f} ms ({change:+.1f}%)")
+            if change > args.max_regression_pct:
+                print(f"Regression over {args.max_regression_pct:g}%")
+                sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
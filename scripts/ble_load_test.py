@@ -0,0 +1,472 @@
+#!/usr/bin/env python3
+"""
+BLE load test for the Somnus service (components/somnus_ble).
+
+Drives the device with ECHO commands at a fixed rate and payload size and
+measures command-to-reply latency, notification throughput and drops. Each
+run starts with GET_STATS reset and ends with GET_STATS, so the firmware's
+own counters (queue drops, mbuf waits, bulk retransmits, MTU, PHY and
+connection interval) are reported next to what the client saw.
+
+Modes:
+  json    ECHO as JSON on RX, replies as text on TX (split by MTU)
+  binary  ECHO frames on the binary characteristic, write without response
+  bulk    ECHO with bulk=1: --reply-size bytes over the bulk channel, acked
+          here frame by frame; runs back to back whatever --rate says
+
+Every combination of --interval-ms x --phy x --rate x --payload is one run.
+--interval-ms and --phy go through SET_LINK, which the phone may refuse; the
+report shows what the link actually used. The ATT MTU is whatever the
+client and CONFIG_SOMNUS_BLE_PREFERRED_MTU agree on; to cover several, run
+from clients or builds that differ and compare the --json reports.
+
+Examples:
+  ble_load_test.py --mode json --rate 5,20,50 --payload 16,128 --reply-size 600
+  ble_load_test.py --mode binary --rate 0 --payload 8,64,120 --interval-ms 7.5,30,100 --phy 1,2
+  ble_load_test.py --mode bulk --reply-size 32768 --duration 20 --json bulk.json
+
+Requires: pip install bleak
+"""
+
+import argparse
+import asyncio
+import itertools
+import json
+import statistics
+import struct
+import sys
+import time
+
+try:
+    from bleak import BleakClient, BleakScanner
+except ImportError:
+    sys.exit("bleak not installed: pip install bleak")
+
+RX_UUID = "6e400002-b5a3-f393-e0a9-e50e24dcca9e"
+TX_UUID = "6e400003-b5a3-f393-e0a9-e50e24dcca9e"
+BULK_UUID = "6e400004-b5a3-f393-e0a9-e50e24dcca9e"
+BIN_UUID = "6e400005-b5a3-f393-e0a9-e50e24dcca9e"
+
+DEFAULT_DEVICE_NAME = "rpi-gatt-server"
+
+CMD_ECHO = 0x22
+RSP_FLAG = 0x80
+TLV_DATA, TLV_SIZE, TLV_BULK = 0x40, 0x41, 0x42
+STATUS_OK, STATUS_BUSY = 0x00, 0x03
+BULK_START, BULK_DATA, BULK_END, BULK_ABORT = 0x01, 0x02, 0x03, 0x04
+BULK_ACK, BULK_NACK = 0x81, 0x82
+BULK_WINDOW = 8
+JSON_MAX_WRITE = 255            # SOMNUS_BLE_CMD_MAX_LEN
+BIN_MAX_REPLY = 123             # 128-byte frame less header and TLV header
+ECHO_PREFIX = b"ECHO:"
+
+
+def percentile(values, pct):
+    if not values:
+        return None
+    ordered = sorted(values)
+    return ordered[min(len(ordered) - 1, int(round(pct / 100 * (len(ordered) - 1))))]
+
+
+class Device:
+    """Routes notifications to the request waiting for them."""
+
+    def __init__(self, client):
+        self.client = client
+        self.text_waiter = None       # (predicate, future) for one text notification
+        self.stats_lines = None
+        self.stats_done = None
+        self.echo = None              # The run collecting ECHO replies
+        self.bulk = None
+
+    async def start(self):
+        await self.client.start_notify(TX_UUID, self._on_tx)
+        await self.client.start_notify(BIN_UUID, self._on_bin)
+        await self.client.start_notify(BULK_UUID, self._on_bulk)
+
+    # --- text channel ---
+
+    def _on_tx(self, _, data):
+        now = time.perf_counter()
+        if self.stats_lines is not None:
+            text = data.decode("utf-8", "replace")
+            if text == "STATS_END":
+                self.stats_done.set_result("".join(self.stats_lines))
+                self.stats_lines = None
+            elif text != "STATS_START":
+                self.stats_lines.append(text)
+            return
+        if self.text_waiter and self.text_waiter[0](data):
+            self.text_waiter[1].set_result(data.decode("utf-8", "replace"))
+            self.text_waiter = None
+            return
+        if self.echo:
+            self.echo.on_text(bytes(data), now)
+
+    async def command(self, payload, expect, timeout=3.0):
+        future = asyncio.get_running_loop().create_future()
+        self.text_waiter = (expect, future)
+        await self.client.write_gatt_char(RX_UUID, json.dumps(payload).encode(), response=True)
+        try:
+            return await asyncio.wait_for(future, timeout)
+        finally:
+            self.text_waiter = None
+
+    async def stats(self, reset=False):
+        self.stats_lines = []
+        self.stats_done = asyncio.get_running_loop().create_future()
+        await self.client.write_gatt_char(
+            RX_UUID, json.dumps({"action": "GET_STATS", "reset": reset}).encode(), response=True)
+        try:
+            return json.loads(await asyncio.wait_for(self.stats_done, 5.0))
+        finally:
+            self.stats_lines = None
+
+    async def set_link(self, interval_ms, phy):
+        request = {"action": "SET_LINK"}
+        if interval_ms is not None:
+            request["interval_ms"] = interval_ms
+        if phy is not None:
+            request["phy"] = phy
+        return await self.command(request, lambda d: d.startswith(b"Command "))
+
+    # --- binary and bulk channels ---
+
+    def _on_bin(self, _, data):
+        if self.echo and len(data) >= 3 and data[0] == CMD_ECHO | RSP_FLAG:
+            self.echo.on_frame(bytes(data), time.perf_counter())
+
+    def _on_bulk(self, _, data):
+        if self.bulk and len(data) >= 4:
+            self.bulk.on_frame(bytes(data))
+
+
+class BulkReceiver:
+    """Receiving end of the bulk protocol in docs/SOMNUS_BLE_PROTOCOLS.md."""
+
+    def __init__(self, client):
+        self.client = client
+        self.reset()
+
+    def reset(self):
+        self.expected = 0
+        self.received = 0
+        self.started = None
+        self.finished = None
+        self.nacks = 0
+        self.done = asyncio.get_running_loop().create_future()
+
+    def _write(self, frame):
+        asyncio.ensure_future(self.client.write_gatt_char(BULK_UUID, frame, response=False))
+
+    def on_frame(self, frame):
+        kind, stream, seq = frame[0], frame[1], frame[2] | frame[3] << 8
+        if kind == BULK_ABORT:
+            if not self.done.done():
+                self.done.set_result(False)
+            return
+        if seq != self.expected:
+            # Point at the gap; the device goes back and resends from there
+            if seq > self.expected:
+                self.nacks += 1
+                self._write(bytes([BULK_NACK, stream, self.expected & 0xFF, self.expected >> 8]))
+            return
+        if kind == BULK_START:
+            self.started = time.perf_counter()
+        elif kind == BULK_DATA:
+            self.received += len(frame) - 4
+        self._write(bytes([BULK_ACK, stream, seq & 0xFF, seq >> 8, BULK_WINDOW]))
+        self.expected = seq + 1
+        if kind == BULK_END:
+            self.finished = time.perf_counter()
+            if not self.done.done():
+                self.done.set_result(True)
+
+
+class EchoRun:
+    """One rate x payload run: what was sent and what came back."""
+
+    def __init__(self, mode, payload, reply_size):
+        self.mode = mode
+        self.payload = payload
+        self.reply_size = reply_size
+        self.pending = {}             # key -> (send time, reply length)
+        self.first = []               # ms to the first reply byte
+        self.complete = []            # ms to the whole reply
+        self.sent = self.ok = self.busy = self.errors = self.corrupt = 0
+        self.reply_bytes = 0
+        self.current = None           # JSON: [sent at, reply length, bytes so far]
+        self.idle = asyncio.Event()
+
+    def _settled(self):
+        if not self.pending:
+            self.idle.set()
+
+    # JSON: "ECHO:<seq>-xxx...." split into MTU-sized notifications
+    def request_json(self, seq):
+        data = f"{seq}-".encode()
+        data += b"x" * max(0, self.payload - len(data))
+        body = {"action": "ECHO", "data": data.decode(), "size": self.reply_size}
+        return str(seq), json.dumps(body, separators=(",", ":")).encode(), len(ECHO_PREFIX) + max(len(data), self.reply_size)
+
+    def on_text(self, data, now):
+        self.reply_bytes += len(data)
+        if data.startswith(ECHO_PREFIX):
+            key = data[len(ECHO_PREFIX):].split(b"-", 1)[0].decode("ascii", "replace")
+            request = self.pending.pop(key, None)
+            if request is None:
+                self.corrupt += 1
+                self.current = None
+                return
+            self.first.append((now - request[0]) * 1000)
+            self.current = [request[0], request[1], len(data)]
+        elif data == b"Queue busy":
+            # No way to tell which write it refused: the oldest is the best guess
+            if self.pending:
+                self.pending.pop(next(iter(self.pending)))
+            self.busy += 1
+            self._settled()
+            return
+        elif data.startswith(b"ECHO_ERROR"):
+            self.errors += 1
+            return
+        elif self.current:
+            self.current[2] += len(data)
+        else:
+            return
+        if self.current and self.current[2] >= self.current[1]:
+            self.complete.append((now - self.current[0]) * 1000)
+            self.corrupt += self.current[2] != self.current[1]
+            self.ok += 1
+            self.current = None
+            self._settled()
+
+    # Binary: [cmd][req_id] TLV data [TLV size] [TLV bulk]
+    def request_binary(self, seq, bulk):
+        req_id = seq & 0xFF
+        data = bytes((seq + i) & 0xFF for i in range(self.payload))
+        frame = bytes([CMD_ECHO, req_id, TLV_DATA, len(data)]) + data
+        if self.reply_size:
+            frame += bytes([TLV_SIZE, 4]) + struct.pack("<I", self.reply_size)
+        if bulk:
+            frame += bytes([TLV_BULK, 1, 1])
+        # The bulk ECHO answers with the data alone once the transfer is acked
+        return str(req_id), frame, len(data) if bulk else max(len(data), self.reply_size)
+
+    def on_frame(self, frame, now):
+        request = self.pending.pop(str(frame[1]), None)
+        if request is None:
+            return
+        started, expected = request
+        status = frame[2]
+        if status == STATUS_OK:
+            self.first.append((now - started) * 1000)
+            self.complete.append((now - started) * 1000)
+            self.reply_bytes += len(frame)
+            self.ok += 1
+            self.corrupt += len(frame) != 5 + expected or frame[3] != TLV_DATA or frame[4] != expected
+        elif status == STATUS_BUSY:
+            self.busy += 1
+        else:
+            self.errors += 1
+        self._settled()
+
+    def summary(self, elapsed):
+        lost = self.sent - self.ok - self.busy - self.errors
+        out = {
+            "sent": self.sent,
+            "ok": self.ok,
+            "busy": self.busy,
+            "errors": self.errors,
+            "lost": max(0, lost),
+            "corrupt": self.corrupt,
+            "rate_achieved": round(self.sent / elapsed, 2) if elapsed else 0,
+            "notify_bytes_per_s": round(self.reply_bytes / elapsed) if elapsed else 0,
+        }
+        for name, values in (("first_ms", self.first), ("complete_ms", self.complete)):
+            if values:
+                out[name] = {
+                    "p50": round(statistics.median(values), 1),
+                    "p90": round(percentile(values, 90), 1),
+                    "p99": round(percentile(values, 99), 1),
+                    "max": round(max(values), 1),
+                }
+        return out
+
+
+async def run_echo(device, mode, rate, payload, reply_size, duration, timeout):
+    run = EchoRun(mode, payload, reply_size)
+    device.echo = run
+    client = device.client
+    start = time.perf_counter()
+    seq = 0
+    next_at = start
+    while time.perf_counter() - start < duration:
+        if rate > 0:
+            delay = next_at - time.perf_counter()
+            if delay > 0:
+                await asyncio.sleep(delay)
+            next_at += 1.0 / rate
+        run.idle.clear()
+        if mode == "json":
+            key, frame, expected = run.request_json(seq)
+            run.pending[key] = (time.perf_counter(), expected)
+            await client.write_gatt_char(RX_UUID, frame, response=True)
+        else:
+            key, frame, expected = run.request_binary(seq, bulk=False)
+            run.pending[key] = (time.perf_counter(), expected)
+            await client.write_gatt_char(BIN_UUID, frame, response=False)
+        run.sent += 1
+        seq += 1
+        if rate == 0:
+            # Closed loop: the next command waits for this reply
+            try:
+                await asyncio.wait_for(run.idle.wait(), timeout)
+            except asyncio.TimeoutError:
+                run.pending.pop(key, None)
+    elapsed = time.perf_counter() - start
+    try:
+        await asyncio.wait_for(run.idle.wait(), timeout)
+    except asyncio.TimeoutError:
+        pass
+    device.echo = None
+    return run.summary(elapsed)
+
+
+async def run_bulk(device, reply_size, duration, timeout):
+    run = EchoRun("bulk", 8, reply_size)
+    receiver = BulkReceiver(device.client)
+    device.echo, device.bulk = run, receiver
+    rates, transfers, failed = [], 0, 0
+    start = time.perf_counter()
+    seq = 0
+    while time.perf_counter() - start < duration:
+        receiver.reset()
+        run.idle.clear()
+        key, frame, expected = run.request_binary(seq, bulk=True)
+        run.pending[key] = (time.perf_counter(), expected)
+        await device.client.write_gatt_char(BIN_UUID, frame, response=False)
+        run.sent += 1
+        seq += 1
+        try:
+            ok = await asyncio.wait_for(receiver.done, timeout + reply_size / 1000)
+            await asyncio.wait_for(run.idle.wait(), timeout)
+        except asyncio.TimeoutError:
+            ok = False
+            run.pending.pop(key, None)
+        transfers += 1
+        if ok and receiver.finished and receiver.finished > receiver.started:
+            rates.append(receiver.received / (receiver.finished - receiver.started))
+        else:
+            failed += 1
+    out = run.summary(time.perf_counter() - start)
+    out["transfers"] = transfers
+    out["transfer_failures"] = failed
+    if rates:
+        out["bulk_bytes_per_s"] = {"p50": round(statistics.median(rates)), "min": round(min(rates))}
+    device.echo = device.bulk = None
+    return out
+
+
+async def find_address(args):
+    if args.address:
+        return args.address
+    print(f"Scanning for '{args.device_name}'...")
+    for found in await BleakScanner.discover(timeout=args.scan_timeout):
+        if found.name and args.device_name.lower() in found.name.lower():
+            print(f"Found {found.name} ({found.address})")
+            return found.address
+    sys.exit(f"'{args.device_name}' not found")
+
+
+def parse_list(text, kind):
+    return [kind(item) for item in text.split(",") if item != ""] if text else [None]
+
+
+async def main_async(args):
+    rates = parse_list(args.rate, float)
+    payloads = parse_list(args.payload, int)
+    intervals = parse_list(args.interval_ms, float)
+    phys = parse_list(args.phy, int)
+    if args.mode == "json" and max(payloads) > JSON_MAX_WRITE - 64:
+        sys.exit(f"JSON payloads above {JSON_MAX_WRITE - 64} bytes do not fit one RX write")
+    if args.mode == "binary" and max(max(payloads), args.reply_size) > BIN_MAX_REPLY:
+        sys.exit(f"binary replies above {BIN_MAX_REPLY} bytes do not fit one frame")
+    if args.mode == "bulk":
+        rates, payloads = [None], [8]
+
+    results = []
+    async with BleakClient(await find_address(args)) as client:
+        device = Device(client)
+        await device.start()
+        print(f"Connected, client MTU {client.mtu_size}")
+        for interval, phy in itertools.product(intervals, phys):
+            if interval is not None or phy is not None:
+                answer = await device.set_link(interval, phy)
+                print(f"SET_LINK interval={interval} phy={phy}: {answer}")
+                await asyncio.sleep(args.settle)
+            for rate, payload in itertools.product(rates, payloads):
+                await device.stats(reset=True)
+                if args.mode == "bulk":
+                    measured = await run_bulk(device, args.reply_size, args.duration, args.timeout)
+                else:
+                    measured = await run_echo(device, args.mode, rate, payload, args.reply_size, args.duration,
+                                              args.timeout)
+                firmware = await device.stats()
+                entry = {
+                    "mode": args.mode,
+                    "requested": {"interval_ms": interval, "phy": phy, "rate": rate, "payload": payload,
+                                  "reply_size": args.reply_size},
+                    "link": {key: firmware.get(key) for key in ("mtu", "tx_phy", "rx_phy", "interval_ms", "latency")},
+                    "client": measured,
+                    "firmware": {key: value for key, value in firmware.items()
+                                 if key not in ("mtu", "tx_phy", "rx_phy", "interval_ms", "latency",
+                                                "supervision_ms")},
+                }
+                results.append(entry)
+                print_row(entry)
+        if any(i is not None for i in intervals):
+            await device.set_link(0, None)
+    return results
+
+
+def print_row(entry):
+    link, client, fw, req = entry["link"], entry["client"], entry["firmware"], entry["requested"]
+    complete = client.get("complete_ms", {})
+    print(f"  mtu {link['mtu']} phy {link['tx_phy']}/{link['rx_phy']} itvl {link['interval_ms']} ms | "
+          f"rate {req['rate']} payload {req['payload']} | sent {client['sent']} ok {client['ok']} "
+          f"busy {client['busy']} lost {client['lost']} | p50 {complete.get('p50')} p99 {complete.get('p99')} ms | "
+          f"{client['notify_bytes_per_s']} B/s"
+          + (f" bulk {client['bulk_bytes_per_s']['p50']} B/s" if "bulk_bytes_per_s" in client else "")
+          + f" | fw drops {fw.get('queue_drops')} mbuf waits {fw.get('mbuf_waits')}"
+          f" notify fails {fw.get('notify_failures')} retx {fw.get('bulk_retransmits')}")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--device-name", default=DEFAULT_DEVICE_NAME)
+    parser.add_argument("--address", help="connect to this address instead of scanning")
+    parser.add_argument("--scan-timeout", type=float, default=10.0)
+    parser.add_argument("--mode", choices=("json", "binary", "bulk"), default="binary")
+    parser.add_argument("--rate", default="10", help="commands per second, comma separated; 0 = next after each reply")
+    parser.add_argument("--payload", default="16", help="request payload bytes, comma separated")
+    parser.add_argument("--reply-size", type=int, default=0, help="ECHO reply bytes (bulk: transfer size)")
+    parser.add_argument("--interval-ms", help="connection intervals to pin with SET_LINK, comma separated")
+    parser.add_argument("--phy", help="PHYs to request with SET_LINK (1, 2), comma separated")
+    parser.add_argument("--duration", type=float, default=10.0, help="seconds per run")
+    parser.add_argument("--timeout", type=float, default=2.0, help="seconds before a reply counts as lost")
+    parser.add_argument("--settle", type=float, default=1.5, help="seconds for a SET_LINK update to complete")
+    parser.add_argument("--json", help="write all runs here")
+    args = parser.parse_args()
+    if args.mode == "bulk" and args.reply_size <= 0:
+        parser.error("bulk needs --reply-size")
+
+    results = asyncio.run(main_async(args))
+    if args.json:
+        with open(args.json, "w") as f:
+            json.dump(results, f, indent=2)
+            f.write("\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -2,16 +2,117 @@
 """
 Capture ESP32-S3 logs with device reset
 Resets the device and captures serial output to a file for review.
+
+With --elf, the device is also asked for its deferred log records
+(components/deferred_log) as binary LOG frames, which are formatted here
+against the firmware image the device runs.
 """
 
+import re
 import serial
 import serial.tools.list_ports
+import struct
 import time
 import sys
 import argparse
 from datetime import datetime
 from pathlib import Path
 
+# printf conversions as components/deferred_log parses them
+SPEC_RE = re.compile(r"%(?P<flags>[-+ #0]*)(?P<width>\*|\d+)?(?:\.(?P<prec>\*|\d*))?"
+                     r"(?P<len>hh|h|ll|l|j|z|t)?(?P<conv>[diouxXcfFeEgGaAsp%])")
+LOG_LEVELS = "NEWIDV"
+
+
+class DeferredLogDecoder:
+    """Formats LOG frame payloads using the format and tag strings in the ELF."""
+
+    def __init__(self, elf_path):
+        from elftools.elf.elffile import ELFFile
+
+        self.sections = []
+        with open(elf_path, 'rb') as f:
+            elf = ELFFile(f)
+            for section in elf.iter_sections():
+                if section['sh_type'] == 'SHT_PROGBITS' and section['sh_addr']:
+                    self.sections.append((section['sh_addr'], section.data()))
+        self.formats = {}
+
+    def _locate(self, addr):
+        for base, data in self.sections:
+            if base <= addr < base + len(data):
+                return data, addr - base
+        raise KeyError(f"{addr:#x} is not in the ELF; is it the image the device runs?")
+
+    def string(self, addr):
+        data, offset = self._locate(addr)
+        end = data.find(b"\0", offset)
+        return data[offset:end if end >= 0 else len(data)].decode('utf-8', errors='replace')
+
+    def site_format(self, site):
+        # The site struct's first word points at its format string
+        if site not in self.formats:
+            data, offset = self._locate(site)
+            self.formats[site] = self.string(struct.unpack_from("<I", data, offset)[0])
+        return self.formats[site]
+
+    @staticmethod
+    def format_args(fmt, args):
+        pos = 0
+
+        def take(code, size):
+            nonlocal pos
+            value = struct.unpack_from(code, args, pos)[0]
+            pos += size
+            return value
+
+        def convert(match):
+            nonlocal pos
+            conv = match['conv']
+            if conv == '%':
+                return '%'
+            stars = []
+            width, prec = match['width'], match['prec']
+            if width == '*':
+                stars.append(take("<i", 4))
+            if prec == '*':
+                stars.append(take("<i", 4))
+            spec = '%' + match['flags'] + (width or '') + ('.' + prec if prec is not None else '')
+            wide = match['len'] in ('ll', 'j')
+            if conv in 'di':
+                value = take("<q", 8) if wide else take("<i", 4)
+                return (spec + 'd') % (*stars, value)
+            if conv in 'ouxXc':
+                value = take("<Q", 8) if wide else take("<I", 4)
+                if conv == 'c':
+                    return (spec + 'c') % (*stars, chr(value & 0xFF))
+                return (spec + ('d' if conv == 'u' else conv)) % (*stars, value)
+            if conv in 'fFeEgGaA':
+                value = take("<d", 8)
+                return (spec + ('f' if conv in 'aA' else conv)) % (*stars, value)
+            if conv == 'p':
+                return f"0x{take('<I', 4):x}"
+            length = take("<B", 1)
+            text = args[pos:pos + length].decode('utf-8', errors='replace')
+            pos += length
+            return (spec + 's') % (*stars, text)
+
+        try:
+            return SPEC_RE.sub(convert, fmt)
+        except (struct.error, TypeError, ValueError) as e:
+            return f"{fmt!r} <undecodable arguments: {e}>"
+
+    def decode(self, payload):
+        site, tag, time_ms, core, level, args_len = struct.unpack_from("<IIIBBH", payload)
+        args = payload[16:16 + args_len]
+        try:
+            text = self.format_args(self.site_format(site), args)
+            tag_name = self.string(tag)
+        except KeyError as e:
+            return f"? ({time_ms}) <site {site:#x}: {e}>"
+        letter = LOG_LEVELS[level] if level < len(LOG_LEVELS) else '?'
+        return f"{letter} ({time_ms}) {tag_name}: {text}"
+
 def find_serial_port(port_hint=None):
     """Find the serial port to use."""
     if port_hint:
@@ -207,6 +308,62 @@ def capture_logs(port, duration=30, output_file=None, baudrate=115200, reset=Tru
             ser.close()
             print("Serial port closed")
 
+def capture_deferred_logs(port, elf, duration=30, output_file=None, baudrate=115200, reset=True,
+                          reset_method='rts'):
+    """Capture text logs and the LOG stream, formatting deferred records with the ELF."""
+    from serial_link import FRAME_LOG, STREAMS, SerialLink
+
+    if output_file is None:
+        timestamp = datetime.now().strftime("%Y%m%d_%H%M%S")
+        output_file = f"logs/capture_{timestamp}.log"
+    Path(output_file).parent.mkdir(parents=True, exist_ok=True)
+    decoder = DeferredLogDecoder(elf)
+
+    print(f"Connecting to {port} at {baudrate} baud...")
+    link = SerialLink(port, baudrate)
+    if reset:
+        reset_device(link.ser, reset_method)
+    lines = 0
+    with open(output_file, 'w', encoding='utf-8') as f:
+        f.write(f"Log capture started: {datetime.now().isoformat()}\n")
+        f.write(f"Port: {port}, Baudrate: {baudrate}, ELF: {elf}\n")
+        f.write("-" * 80 + "\n\n")
+
+        def emit(line):
+            nonlocal lines
+            lines += 1
+            f.write(line + "\n")
+            print(line)
+
+        def on_frame(ftype, seq, payload):
+            if ftype == FRAME_LOG:
+                emit(decoder.decode(payload))
+
+        link.on_text = emit
+        link.on_frame = on_frame
+        try:
+            # Until the serial link is up, records arrive as text like any other log
+            deadline = time.monotonic() + duration
+            subscribed = False
+            while time.monotonic() < deadline:
+                if not subscribed:
+                    try:
+                        subscribed = link.subscribe(STREAMS["log"]) == 0
+                    except TimeoutError:
+                        pass
+                link.poll()
+        except KeyboardInterrupt:
+            print("\n\nCapture interrupted by user")
+        finally:
+            try:
+                link.subscribe(0)
+            except TimeoutError:
+                pass
+            link.ser.close()
+        f.write(f"\n{'=' * 80}\nLines captured: {lines}\nEnd time: {datetime.now().isoformat()}\n")
+    print(f"\nLogs saved to: {output_file}")
+    return output_file
+
 def main():
     parser = argparse.ArgumentParser(
         description='Capture ESP32-S3 logs with device reset',
@@ -224,6 +381,9 @@ Examples:
 
   # Use specific port
   python capture_logs.py -p /dev/cu.usbserial-110
+
+  # Format deferred logs on the host (needs pyelftools and KVA_SERIAL_LINK_ENABLE)
+  python capture_logs.py --elf build/naphome-firmware.elf
         """
     )
     
@@ -265,6 +425,12 @@ Examples:
         default='rts',
         help='Reset method: rts, dtr, or both (default: rts)'
     )
+
+    parser.add_argument(
+        '--elf',
+        help='Firmware ELF: receive deferred logs as binary frames and format them here',
+        default=None
+    )
     
     args = parser.parse_args()
     
@@ -276,6 +442,18 @@ Examples:
         print("Please specify a port with -p/--port or connect a device")
         sys.exit(1)
     
+    if args.elf:
+        output_file = capture_deferred_logs(
+            port=port,
+            elf=args.elf,
+            duration=args.duration,
+            output_file=args.output,
+            baudrate=args.baudrate,
+            reset=not args.no_reset,
+            reset_method=args.reset_method
+        )
+        sys.exit(0 if output_file else 1)
+
     # Capture logs
     output_file = capture_logs(
         port=port,
@@ -0,0 +1,138 @@
+#!/usr/bin/env python3
+"""
+Check that the audio interrupts run entirely from IRAM
+
+Flash erases and writes (OTA, NVS, the partitions of tts_cache and
+sensor_manager) turn the flash cache off; with CONFIG_I2S_ISR_IRAM_SAFE the
+I2S interrupts keep running meanwhile, and everything they call has to be in
+IRAM or ROM. This walks the direct calls of each root below in the
+disassembly of the firmware ELF and fails on any that land in flash.
+
+Indirect calls (callx) cannot be followed and are listed as notes; their
+targets have to be roots themselves. Run as a post-build step from the top
+level CMakeLists.txt, or by hand:
+
+    scripts/check_iram_safe.py --objdump xtensa-esp32s3-elf-objdump build/naphome-firmware.elf
+"""
+
+import argparse
+import re
+import subprocess
+import sys
+
+# The cache-safe tier: I2S callbacks and what they record into
+ROOTS = [
+    "on_recv",                      # components/korvo1
+    "on_recv_q_ovf",
+    "capture_on_rx",                # main/korvo_audio.c, through korvo1's rx callback
+    "on_sent",                      # main/audio_player.c
+    "on_send_q_ovf",
+    "deadline_monitor_begin",       # main/deadline_monitor.c
+    "deadline_monitor_end",
+    "metrics_histogram_record_us",  # components/metrics
+]
+
+# ESP32-S3 instruction address space
+ROM = (0x40000000, 0x40060000)
+IRAM = (0x40370000, 0x403E0000)
+RTC_FAST = (0x600FE000, 0x60100000)
+
+FUNC_RE = re.compile(r"^([0-9a-f]+) <([^>]+)>:$")
+CALL_RE = re.compile(r"^\s*[0-9a-f]+:\s+(?:[0-9a-f]{2,}\s+)?(call(?:0|4|8|12)|j)\s+([0-9a-f]+)\s+<([^>+]+)")
+CALLX_RE = re.compile(r"^\s*[0-9a-f]+:\s+(?:[0-9a-f]{2,}\s+)?callx(?:0|4|8|12)\s")
+
+
+def in_range(addr, span):
+    return span[0] <= addr < span[1]
+
+
+def in_ram(addr):
+    return in_range(addr, IRAM) or in_range(addr, RTC_FAST)
+
+
+def load_functions(objdump, elf):
+    """Name and disassembly lines of every function in the ELF, by start address."""
+    out = subprocess.run([objdump, "-d", elf], check=True, capture_output=True, text=True).stdout
+    funcs = {}
+    lines = None
+    for line in out.splitlines():
+        m = FUNC_RE.match(line)
+        if m:
+            lines = []
+            funcs[int(m.group(1), 16)] = (m.group(2), lines)
+        elif lines is not None and line.strip():
+            lines.append(line)
+    return funcs
+
+
+def walk(funcs, root):
+    """(chain, target, addr) for each call from the root at address root that
+    leaves IRAM and ROM, and the chains that make indirect calls."""
+    bad = []
+    indirect = []
+    seen = set()
+    stack = [(root, [funcs[root][0]])]
+    while stack:
+        start, chain = stack.pop()
+        if start in seen or start not in funcs:
+            continue
+        seen.add(start)
+        for line in funcs[start][1]:
+            m = CALL_RE.match(line)
+            if m:
+                target, addr = m.group(3), int(m.group(2), 16)
+                if m.group(1) == "j" and target == chain[-1]:
+                    continue  # A branch within the function
+                if in_range(addr, ROM):
+                    continue
+                if in_ram(addr):
+                    stack.append((addr, chain + [target]))
+                else:
+                    bad.append((chain, target, addr))
+            elif CALLX_RE.match(line):
+                indirect.append(" -> ".join(chain))
+    return bad, sorted(set(indirect))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument("elf", help="Firmware ELF")
+    parser.add_argument("--objdump", default="xtensa-esp32s3-elf-objdump")
+    parser.add_argument("--root", action="append", help="Check this function instead of the built-in list")
+    parser.add_argument("--verbose", action="store_true", help="Also list indirect calls")
+    args = parser.parse_args()
+
+    funcs = load_functions(args.objdump, args.elf)
+    failed = False
+    for root in args.root or ROOTS:
+        starts = [addr for addr, (name, _) in funcs.items() if name == root]
+        if not starts:
+            # Not linked in this configuration
+            continue
+        # Static functions of other files may share the name (wake_arbiter's on_recv); those in flash are not roots
+        ram = [addr for addr in starts if in_ram(addr)]
+        if not ram:
+            print(f"check_iram_safe: {root} is at 0x{starts[0]:08x}, outside IRAM", file=sys.stderr)
+            failed = True
+            continue
+        bad = []
+        indirect = []
+        for start in ram:
+            b, i = walk(funcs, start)
+            bad += b
+            indirect += i
+        for chain, target, addr in bad:
+            path = " -> ".join(chain + [target])
+            print(f"check_iram_safe: {path} is at 0x{addr:08x}, outside IRAM", file=sys.stderr)
+            failed = True
+        if args.verbose:
+            for chain in indirect:
+                print(f"check_iram_safe: note: indirect call in {chain}")
+    if failed:
+        print("check_iram_safe: mark these IRAM_ATTR or keep them off the interrupt path", file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,132 @@
+#!/usr/bin/env python3
+"""
+Driver timing regression check for the test/drivers/timing Unity app.
+
+Runs the [timing] cases on a board flashed with that app (or reads a log of
+an earlier run with --log), collects the TIMING lines they print and writes
+them as one JSON report. With --baseline, every metric in the baseline is
+compared with this run and the check fails (exit 1) when a median or p90
+grew by more than --max-regression-pct, and by more than --min-delta so
+that sub-microsecond noise on fast transfers cannot fail it. A metric the
+baseline has but the run lacks (a sensor that stopped answering) fails too.
+
+Examples:
+  driver_timing.py /dev/ttyACM0 --json timing.json
+  driver_timing.py /dev/ttyACM0 --baseline test/drivers/timing/baseline.json
+  driver_timing.py --log hil.log --baseline test/drivers/timing/baseline.json --max-regression-pct 15
+"""
+
+import argparse
+import json
+import re
+import sys
+import time
+
+TIMING_RE = re.compile(r"TIMING (\{.*\})")
+SUMMARY_RE = re.compile(r"(\d+) Tests (\d+) Failures (\d+) Ignored")
+ANSI_RE = re.compile(r"\x1b\[[0-9;]*m")
+COMPARED = ("median", "p90")
+
+
+def parse(lines):
+    metrics = {}
+    failures = None
+    for line in lines:
+        line = ANSI_RE.sub("", line)
+        match = TIMING_RE.search(line)
+        if match:
+            entry = json.loads(match.group(1))
+            metrics[entry.pop("name")] = entry
+            continue
+        match = SUMMARY_RE.search(line)
+        if match:
+            failures = int(match.group(2))
+    return metrics, failures
+
+
+def run_on_board(port, baud, timeout):
+    import serial
+
+    lines = []
+    with serial.Serial(port, baud, timeout=1) as link:
+        # Unity's menu runs every case carrying the tag typed at its prompt
+        time.sleep(2.0)
+        link.reset_input_buffer()
+        link.write(b"[timing]\n")
+        deadline = time.time() + timeout
+        while time.time() < deadline:
+            line = link.readline().decode("utf-8", "replace").rstrip()
+            if not line:
+                continue
+            print(line)
+            lines.append(line)
+            if SUMMARY_RE.search(ANSI_RE.sub("", line)):
+                break
+        else:
+            sys.exit(f"no Unity summary within {timeout:g} s")
+    return lines
+
+
+def compare(metrics, baseline, max_pct, min_delta):
+    regressions = []
+    for name, base in sorted(baseline.items()):
+        now = metrics.get(name)
+        if now is None:
+            regressions.append(f"{name}: missing from this run")
+            continue
+        for key in COMPARED:
+            old, new = base[key], now[key]
+            delta = new - old
+            pct = delta * 100 / old if old else 0.0
+            flag = delta > min_delta and (not old or pct > max_pct)
+            print(f"  {name:24s} {key:6s} {old:>9} -> {new:>9} {base['unit']:8s} ({pct:+.1f}%){'  REGRESSED' if flag else ''}")
+            if flag:
+                regressions.append(f"{name} {key}: {old} -> {new} {base['unit']}")
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("port", nargs="?", help="serial port of the board running the timing app")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--log", help="parse this console log instead of running the board")
+    parser.add_argument("--timeout", type=float, default=180.0, help="seconds for the whole [timing] run")
+    parser.add_argument("--json", help="write the report here; a report is also a baseline")
+    parser.add_argument("--baseline", help="a previous --json report to compare against")
+    parser.add_argument("--max-regression-pct", type=float, default=10.0)
+    parser.add_argument("--min-delta", type=float, default=20.0, help="smallest growth, in the metric's unit, that counts")
+    args = parser.parse_args()
+
+    if args.log:
+        with open(args.log, errors="replace") as f:
+            lines = f.read().splitlines()
+    elif args.port:
+        lines = run_on_board(args.port, args.baud, args.timeout)
+    else:
+        parser.error("need a port or --log")
+
+    metrics, failures = parse(lines)
+    if not metrics:
+        sys.exit("no TIMING lines")
+    print(f"\n{len(metrics)} metrics")
+    if args.json:
+        with open(args.json, "w") as f:
+            json.dump(metrics, f, indent=2, sort_keys=True)
+            f.write("\n")
+
+    failed = bool(failures)
+    if failures:
+        print(f"{failures} timing case(s) failed on the board")
+    if args.baseline:
+        with open(args.baseline) as f:
+            baseline = json.load(f)
+        print(f"\nAgainst {args.baseline}:")
+        regressions = compare(metrics, baseline, args.max_regression_pct, args.min_delta)
+        for line in regressions:
+            print(f"Regression: {line}")
+        failed = failed or bool(regressions)
+    sys.exit(1 if failed else 0)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,206 @@
+#!/usr/bin/env python3
+"""
+Make a delta OTA patch that turns one firmware image into another.
+
+Usage:
+    python3 make_ota_delta.py old.bin new.bin update.patch
+
+old.bin must be exactly the image the devices are running (the build's
+<project>.bin); the device hashes its running partition against it before
+touching flash. Serve update.patch from any HTTP server that honours Range
+requests and post its URL to /api/ota/install as {"delta_url": ...}.
+
+Format (see ota_delta.c): an 80-byte header with both sizes and SHA-256s,
+then COPY ops that reuse old bytes with sparse XOR fixes and LITERAL ops
+for new bytes. The patch is decoded back here before it is written.
+"""
+
+import hashlib
+import struct
+import sys
+
+MAGIC = 0x3150444E  # 'NDP1'
+VERSION = 1
+HEADER = struct.Struct('<IHHII32s32s')
+OP_COPY = 0x01
+OP_LITERAL = 0x02
+
+BLOCK = 16          # Anchor length for a match
+STRIDE = 8          # Old image positions indexed, every STRIDE bytes
+MAX_CANDIDATES = 8  # Anchors tried per position
+GIVE_UP = 64        # Stop extending once the score falls this far behind
+
+
+def varint(value):
+    out = bytearray()
+    while True:
+        byte = value & 0x7F
+        value >>= 7
+        if value:
+            out.append(byte | 0x80)
+        else:
+            out.append(byte)
+            return bytes(out)
+
+
+def read_varint(data, pos):
+    value = shift = 0
+    while True:
+        byte = data[pos]
+        pos += 1
+        value |= (byte & 0x7F) << shift
+        shift += 7
+        if not byte & 0x80:
+            return value, pos
+
+
+def index_old(old):
+    index = {}
+    for pos in range(0, len(old) - BLOCK + 1, STRIDE):
+        index.setdefault(old[pos:pos + BLOCK], []).append(pos)
+    return index
+
+
+def extend(old, new, old_pos, new_pos):
+    """Length from (old_pos, new_pos) maximising matches minus mismatches.
+
+    A mismatch costs about two patch bytes as a fix and a match saves one
+    literal byte, so a region is worth copying while it gains."""
+
+    limit = min(len(old) - old_pos, len(new) - new_pos)
+    score = best = best_len = 0
+    for i in range(limit):
+        score += 1 if old[old_pos + i] == new[new_pos + i] else -1
+        if score > best:
+            best, best_len = score, i + 1
+        elif score < best - GIVE_UP:
+            break
+    return best_len
+
+
+def extend_back(old, new, old_pos, new_pos, floor):
+    """Exact matches before the anchor, not reaching below new offset floor."""
+
+    n = 0
+    while (new_pos - n > floor and old_pos - n > 0 and
+           old[old_pos - n - 1] == new[new_pos - n - 1]):
+        n += 1
+    return n
+
+
+def copy_op(old, new, old_pos, new_pos, length):
+    fixes = []
+    last = 0
+    for i in range(length):
+        diff = old[old_pos + i] ^ new[new_pos + i]
+        if diff:
+            fixes.append(varint(i - last) + bytes([diff]))
+            last = i + 1
+    return (bytes([OP_COPY]) + varint(old_pos) + varint(length) +
+            varint(len(fixes)) + b''.join(fixes))
+
+
+def literal_op(data):
+    return bytes([OP_LITERAL]) + varint(len(data)) + data
+
+
+def make_ops(old, new):
+    index = index_old(old)
+    ops = []
+    literal_start = pos = 0
+    expected = None  # Where the old image would continue after the last copy
+
+    while pos < len(new):
+        candidates = []
+        if expected is not None and expected < len(old):
+            candidates.append(expected)
+        candidates += index.get(new[pos:pos + BLOCK], [])[:MAX_CANDIDATES]
+
+        best_len, best_old = 0, None
+        for old_pos in candidates:
+            length = extend(old, new, old_pos, pos)
+            if length > best_len:
+                best_len, best_old = length, old_pos
+        if best_len < BLOCK:
+            pos += 1
+            continue
+
+        back = extend_back(old, new, best_old, pos, literal_start)
+        start, old_start, length = pos - back, best_old - back, best_len + back
+        if start > literal_start:
+            ops.append(literal_op(new[literal_start:start]))
+        ops.append(copy_op(old, new, old_start, start, length))
+        pos = literal_start = start + length
+        expected = old_start + length
+
+    if literal_start < len(new):
+        ops.append(literal_op(new[literal_start:]))
+    return b''.join(ops)
+
+
+def apply_patch(old, patch):
+    magic, version, _, source_size, target_size, source_sha, target_sha = HEADER.unpack_from(patch)
+    if magic != MAGIC or version != VERSION:
+        raise ValueError('not a delta patch')
+    if source_size != len(old) or hashlib.sha256(old).digest() != source_sha:
+        raise ValueError('patch was made for a different source image')
+
+    out = bytearray()
+    pos = HEADER.size
+    while len(out) < target_size:
+        op = patch[pos]
+        pos += 1
+        if op == OP_LITERAL:
+            length, pos = read_varint(patch, pos)
+            out += patch[pos:pos + length]
+            pos += length
+        elif op == OP_COPY:
+            old_pos, pos = read_varint(patch, pos)
+            length, pos = read_varint(patch, pos)
+            fixes, pos = read_varint(patch, pos)
+            chunk = bytearray(old[old_pos:old_pos + length])
+            at = 0
+            for _ in range(fixes):
+                gap, pos = read_varint(patch, pos)
+                at += gap
+                chunk[at] ^= patch[pos]
+                pos += 1
+                at += 1
+            out += chunk
+        else:
+            raise ValueError(f'unknown op {op:#x} at {pos - 1}')
+    if pos != len(patch) or hashlib.sha256(out).digest() != target_sha:
+        raise ValueError('patch does not rebuild the target image')
+    return bytes(out)
+
+
+def make_patch(old_path, new_path, patch_path):
+    with open(old_path, 'rb') as f:
+        old = f.read()
+    with open(new_path, 'rb') as f:
+        new = f.read()
+    if not new:
+        print(f"Error: '{new_path}' is empty", file=sys.stderr)
+        return 1
+
+    header = HEADER.pack(MAGIC, VERSION, 0, len(old), len(new),
+                         hashlib.sha256(old).digest(), hashlib.sha256(new).digest())
+    patch = header + make_ops(old, new)
+    apply_patch(old, patch)
+
+    with open(patch_path, 'wb') as f:
+        f.write(patch)
+    print(f"{patch_path}: {len(patch)} bytes for a {len(new)} byte image "
+          f"({100.0 * len(patch) / len(new):.1f}%)")
+    return 0
+
+
+def main():
+    if len(sys.argv) != 4:
+        print(__doc__, file=sys.stderr)
+        return 1
+    return make_patch(sys.argv[1], sys.argv[2], sys.argv[3])
+
+
+if __name__ == '__main__':
+    sys.exit(main())
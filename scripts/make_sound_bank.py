@@ -0,0 +1,209 @@
+#!/usr/bin/env python3
+"""
+Pack sounds into a flash image for the "sounds" partition (main/sound_bank.h).
+
+Usage:
+    python3 make_sound_bank.py [--rate HZ] [--mono] [--adpcm] [--size BYTES] \\
+        bank.bin chime.wav rain.mp3:loop ...
+
+Each sound is named after its file (without extension, at most 23
+characters). A ":loop" suffix marks it to repeat until stopped, for sleep
+soundscapes. Sounds are converted to --rate (default 48000, the codec rate,
+so the mixer plays them without resampling); anything other than a 16-bit
+WAV already at that rate goes through ffmpeg. --adpcm stores IMA ADPCM at a
+quarter of the size, which suits long loops; chimes are best left as PCM.
+
+Flash the result with:
+    parttool.py write_partition --partition-name sounds --input bank.bin
+"""
+
+import argparse
+import os
+import shutil
+import struct
+import subprocess
+import sys
+import wave
+import zlib
+
+MAGIC = 0x3142534E  # 'NSB1'
+VERSION = 1
+HEADER = struct.Struct('<IHHII')
+ENTRY = struct.Struct('<24sIIIIBBBBI')
+NAME_LEN = 24
+CODEC_PCM16 = 0
+CODEC_IMA_ADPCM = 1
+FLAG_LOOP = 0x01
+ADPCM_BLOCK_FRAMES = 512
+DEFAULT_SIZE = 2560 * 1024
+
+IMA_STEPS = [
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45, 50, 55, 60,
+    66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230, 253, 279, 307, 337, 371,
+    408, 449, 494, 544, 598, 658, 724, 796, 876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878,
+    2066, 2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845,
+    8630, 9493, 10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086,
+    29794, 32767,
+]
+IMA_INDEX_STEP = [-1, -1, -1, -1, 2, 4, 6, 8]
+
+
+def ima_decode(nibble, predictor, index):
+    """Same arithmetic as ima_decode() in sound_bank.c."""
+    step = IMA_STEPS[index]
+    diff = step >> 3
+    if nibble & 4:
+        diff += step
+    if nibble & 2:
+        diff += step >> 1
+    if nibble & 1:
+        diff += step >> 2
+    predictor = predictor - diff if nibble & 8 else predictor + diff
+    predictor = max(-32768, min(32767, predictor))
+    index = max(0, min(88, index + IMA_INDEX_STEP[nibble & 7]))
+    return predictor, index
+
+
+def ima_encode(sample, predictor, index):
+    step = IMA_STEPS[index]
+    diff = sample - predictor
+    nibble = 0
+    if diff < 0:
+        nibble = 8
+        diff = -diff
+    if diff >= step:
+        nibble |= 4
+        diff -= step
+    if diff >= step >> 1:
+        nibble |= 2
+        diff -= step >> 1
+    if diff >= step >> 2:
+        nibble |= 1
+    # Track the decoder, not the input, so errors don't accumulate
+    predictor, index = ima_decode(nibble, predictor, index)
+    return nibble, predictor, index
+
+
+def encode_adpcm(samples, channels):
+    """Blocks of ADPCM_BLOCK_FRAMES frames, each opening with every
+    channel's decoder state so playback can start at any block."""
+
+    out = bytearray()
+    state = [(0, 0)] * channels
+    frames = len(samples) // channels
+    for start in range(0, frames, ADPCM_BLOCK_FRAMES):
+        count = min(ADPCM_BLOCK_FRAMES, frames - start)
+        for predictor, index in state:
+            out += struct.pack('<hBB', predictor, index, 0)
+        nibbles = []
+        for n in range(count * channels):
+            c = n % channels
+            predictor, index = state[c]
+            nibble, predictor, index = ima_encode(samples[start * channels + n], predictor, index)
+            state[c] = (predictor, index)
+            nibbles.append(nibble)
+        if len(nibbles) & 1:
+            nibbles.append(0)
+        out += bytes(nibbles[i] | (nibbles[i + 1] << 4) for i in range(0, len(nibbles), 2))
+    return bytes(out)
+
+
+def read_wav(path, rate, channels):
+    """PCM from a WAV that needs no conversion, else None."""
+
+    if not path.lower().endswith('.wav'):
+        return None
+    try:
+        with wave.open(path, 'rb') as w:
+            if w.getsampwidth() != 2 or w.getframerate() != rate or w.getnchannels() != channels:
+                return None
+            return w.readframes(w.getnframes())
+    except wave.Error:
+        return None
+
+
+def read_ffmpeg(path, rate, channels):
+    if not shutil.which('ffmpeg'):
+        raise RuntimeError(f"{path}: needs ffmpeg to convert to {rate} Hz x{channels}")
+    result = subprocess.run(
+        ['ffmpeg', '-v', 'error', '-i', path, '-f', 's16le', '-acodec', 'pcm_s16le',
+         '-ar', str(rate), '-ac', str(channels), '-'],
+        stdout=subprocess.PIPE, check=True)
+    return result.stdout
+
+
+def load(path, rate, channels):
+    pcm = read_wav(path, rate, channels)
+    if pcm is None:
+        pcm = read_ffmpeg(path, rate, channels)
+    if len(pcm) < 2 * channels:
+        raise RuntimeError(f"{path}: no audio")
+    return pcm[:len(pcm) - len(pcm) % (2 * channels)]
+
+
+def build(args):
+    channels = 1 if args.mono else 2
+    entries = []
+    blobs = []
+    names = set()
+    for spec in args.sounds:
+        path, _, option = spec.partition(':')
+        if option not in ('', 'loop'):
+            raise RuntimeError(f"{spec}: unknown option '{option}'")
+        name = os.path.splitext(os.path.basename(path))[0][:NAME_LEN - 1]
+        if name in names:
+            raise RuntimeError(f"{spec}: duplicate name '{name}'")
+        names.add(name)
+
+        pcm = load(path, args.rate, channels)
+        frames = len(pcm) // (2 * channels)
+        if args.adpcm:
+            samples = struct.unpack(f'<{len(pcm) // 2}h', pcm)
+            data, codec = encode_adpcm(samples, channels), CODEC_IMA_ADPCM
+        else:
+            data, codec = pcm, CODEC_PCM16
+        flags = FLAG_LOOP if option == 'loop' else 0
+        entries.append((name, len(data), frames, codec, flags))
+        blobs.append(data)
+
+    data_start = HEADER.size + ENTRY.size * len(entries)
+    index = bytearray()
+    body = bytearray()
+    for (name, size, frames, codec, flags), data in zip(entries, blobs):
+        body += bytes(-(data_start + len(body)) % 4)
+        offset = data_start + len(body)
+        index += ENTRY.pack(name.encode(), offset, size, frames, args.rate, channels, codec, flags, 0, 0)
+        body += data
+
+    used = HEADER.size + len(index) + len(body)
+    if used > args.size:
+        raise RuntimeError(f"bank is {used} bytes; the partition holds {args.size}")
+    header = HEADER.pack(MAGIC, VERSION, len(entries), used, zlib.crc32(index))
+    with open(args.output, 'wb') as f:
+        f.write(header + index + body)
+
+    for name, size, frames, codec, flags in entries:
+        print(f"  {name:24s} {frames * 1000 // args.rate:7d} ms {size:9d} bytes"
+              f"{' adpcm' if codec == CODEC_IMA_ADPCM else ''}{' loop' if flags & FLAG_LOOP else ''}")
+    print(f"{args.output}: {len(entries)} sounds, {used} of {args.size} bytes")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n\n')[0])
+    parser.add_argument('--rate', type=int, default=48000)
+    parser.add_argument('--mono', action='store_true')
+    parser.add_argument('--adpcm', action='store_true')
+    parser.add_argument('--size', type=lambda v: int(v, 0), default=DEFAULT_SIZE)
+    parser.add_argument('output')
+    parser.add_argument('sounds', nargs='+')
+    args = parser.parse_args()
+    try:
+        build(args)
+    except (RuntimeError, OSError, subprocess.CalledProcessError) as e:
+        print(f"Error: {e}", file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,241 @@
+#!/usr/bin/env python3
+"""
+Stand-in for the OpenAI and Google endpoints the firmware calls, for the
+end-to-end latency benchmark (scripts/bench_voice_latency.py).
+
+Serves plain HTTP and WebSocket on one port; build the firmware with
+CONFIG_KVA_BENCH_MODE=1 and CONFIG_KVA_BENCH_CLOUD_HOST="<this host>:<port>".
+Every reply is canned, so what the benchmark measures is the device plus the
+network conditions set here: a fixed first-byte latency with jitter, and a
+bandwidth cap for the audio replies. No TLS, so handshakes are not included.
+
+Endpoints:
+  POST /v1/responses               OpenAI Responses (JSON, or SSE with stream)
+  POST /v1/audio/speech            OpenAI TTS (WAV)
+  WS   /v1/realtime                OpenAI Realtime transcription events
+  POST /v1/speech:recognize        Google Speech-to-Text
+  POST /v1beta/models/<m>:<verb>   Gemini generateContent / streamGenerateContent
+  POST /v1/text:synthesize         Google TTS (base64 WAV)
+  WS   /ws/...BidiGenerateContent  Gemini Live input transcription
+
+Examples:
+  mock_cloud_server.py --port 8080
+  mock_cloud_server.py --latency-ms 250 --jitter-ms 50 --kbps 256
+"""
+
+import argparse
+import asyncio
+import base64
+import io
+import json
+import math
+import random
+import struct
+import time
+import wave
+
+from aiohttp import WSMsgType, web
+
+TTS_RATE_HZ = 24000
+CHUNK_BYTES = 4096
+
+
+def make_reply_pcm(seconds, rate_hz):
+    """A soft two-tone chime, so the reply is audible and not silence-trimmed."""
+    frames = int(seconds * rate_hz)
+    out = bytearray()
+    for i in range(frames):
+        t = i / rate_hz
+        fade = min(1.0, t * 20, (seconds - t) * 20)
+        sample = 0.2 * fade * (math.sin(2 * math.pi * 440 * t) + math.sin(2 * math.pi * 660 * t)) / 2
+        out += struct.pack("<h", int(sample * 32767))
+    return bytes(out)
+
+
+def make_wav(pcm, rate_hz):
+    buf = io.BytesIO()
+    with wave.open(buf, "wb") as wav:
+        wav.setnchannels(1)
+        wav.setsampwidth(2)
+        wav.setframerate(rate_hz)
+        wav.writeframes(pcm)
+    return buf.getvalue()
+
+
+class MockCloud:
+    def __init__(self, args):
+        self.args = args
+        self.reply_wav = make_wav(make_reply_pcm(args.reply_seconds, TTS_RATE_HZ), TTS_RATE_HZ)
+        self.reply_pcm16k = make_reply_pcm(args.reply_seconds, 16000)
+
+    async def first_byte_delay(self):
+        delay = self.args.latency_ms + random.uniform(-self.args.jitter_ms, self.args.jitter_ms)
+        await asyncio.sleep(max(0.0, delay) / 1000)
+
+    async def paced(self, data, write):
+        """Send data in chunks no faster than --kbps (0 = unlimited)."""
+        start = time.monotonic()
+        for offset in range(0, len(data), CHUNK_BYTES):
+            chunk = data[offset:offset + CHUNK_BYTES]
+            await write(chunk)
+            if self.args.kbps > 0:
+                due = start + (offset + len(chunk)) * 8 / (self.args.kbps * 1000)
+                await asyncio.sleep(max(0.0, due - time.monotonic()))
+
+    def log(self, what):
+        if self.args.verbose:
+            print(f"[mock] {what}", flush=True)
+
+    async def sse(self, request, events):
+        response = web.StreamResponse(headers={"Content-Type": "text/event-stream", "Cache-Control": "no-cache"})
+        await response.prepare(request)
+        for event in events:
+            await response.write(f"data: {json.dumps(event)}\n\n".encode())
+            await asyncio.sleep(self.args.token_ms / 1000)
+        await response.write(b"data: [DONE]\n\n")
+        await response.write_eof()
+        return response
+
+    def words(self, text):
+        parts = text.split(" ")
+        return [p + (" " if i < len(parts) - 1 else "") for i, p in enumerate(parts)]
+
+    # OpenAI
+
+    async def responses(self, request):
+        body = await request.json()
+        # Transcription requests carry audio; everything else is a chat turn
+        audio = any(c.get("type") == "input_audio"
+                    for m in body.get("input", []) if isinstance(m, dict)
+                    for c in m.get("content", []) if isinstance(c, dict))
+        text = self.args.transcript if audio else self.args.reply
+        self.log(f"responses ({'stt' if audio else 'llm'}, stream={bool(body.get('stream'))})")
+        await self.first_byte_delay()
+        if body.get("stream"):
+            events = [{"type": "response.output_text.delta", "delta": w} for w in self.words(text)]
+            events.append({"type": "response.completed"})
+            return await self.sse(request, events)
+        return web.json_response({"output": [{"type": "message", "content": [{"type": "output_text", "text": text}]}]})
+
+    async def speech(self, request):
+        await request.read()
+        self.log("audio/speech")
+        await self.first_byte_delay()
+        response = web.StreamResponse(headers={"Content-Type": "audio/wav"})
+        response.content_length = len(self.reply_wav)
+        await response.prepare(request)
+        await self.paced(self.reply_wav, response.write)
+        await response.write_eof()
+        return response
+
+    async def openai_realtime(self, request):
+        ws = web.WebSocketResponse()
+        await ws.prepare(request)
+        self.log("realtime connected")
+        async for msg in ws:
+            if msg.type != WSMsgType.TEXT:
+                continue
+            event = json.loads(msg.data)
+            kind = event.get("type")
+            if kind == "session.update":
+                await ws.send_json({"type": "session.created", "session": {"id": "sess_mock"}})
+            elif kind in ("input_audio_buffer.commit", "response.create"):
+                await self.first_byte_delay()
+                for word in self.words(self.args.transcript):
+                    await ws.send_json({"type": "response.audio_transcript.delta", "delta": word})
+                    await asyncio.sleep(self.args.token_ms / 1000)
+                await ws.send_json({"type": "response.audio_transcript.done", "transcript": self.args.transcript})
+
+                async def send_audio(chunk):
+                    await ws.send_json({"type": "response.audio.delta", "delta": base64.b64encode(chunk).decode()})
+
+                await self.paced(self.reply_pcm16k, send_audio)
+                await ws.send_json({"type": "response.audio.done"})
+        return ws
+
+    # Google
+
+    async def recognize(self, request):
+        await request.read()
+        self.log("speech:recognize")
+        await self.first_byte_delay()
+        return web.json_response({"results": [{"alternatives": [{"transcript": self.args.transcript}]}]})
+
+    async def gemini(self, request):
+        await request.read()
+        verb = request.match_info["target"].split(":", 1)[-1]
+        self.log(f"gemini {verb}")
+        await self.first_byte_delay()
+
+        def candidate(text):
+            return {"candidates": [{"content": {"parts": [{"text": text}], "role": "model"}}]}
+
+        if verb.startswith("streamGenerateContent"):
+            return await self.sse(request, [candidate(w) for w in self.words(self.args.reply)])
+        return web.json_response(candidate(self.args.reply))
+
+    async def synthesize(self, request):
+        await request.read()
+        self.log("text:synthesize")
+        await self.first_byte_delay()
+        body = json.dumps({"audioContent": base64.b64encode(self.reply_wav).decode()}).encode()
+        response = web.StreamResponse(headers={"Content-Type": "application/json"})
+        response.content_length = len(body)
+        await response.prepare(request)
+        await self.paced(body, response.write)
+        await response.write_eof()
+        return response
+
+    async def gemini_live(self, request):
+        ws = web.WebSocketResponse()
+        await ws.prepare(request)
+        self.log("gemini live connected")
+        async for msg in ws:
+            if msg.type != WSMsgType.TEXT:
+                continue
+            event = json.loads(msg.data)
+            if "setup" in event:
+                await ws.send_json({"setupComplete": {}})
+            elif event.get("realtimeInput", {}).get("audioStreamEnd"):
+                await self.first_byte_delay()
+                for word in self.words(self.args.transcript):
+                    await ws.send_json({"serverContent": {"inputTranscription": {"text": word}}})
+                    await asyncio.sleep(self.args.token_ms / 1000)
+                await ws.send_json({"serverContent": {"turnComplete": True}})
+        return ws
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--host", default="0.0.0.0")
+    parser.add_argument("--port", type=int, default=8080)
+    parser.add_argument("--latency-ms", type=float, default=150.0, help="delay before each reply's first byte")
+    parser.add_argument("--jitter-ms", type=float, default=0.0, help="uniform +/- jitter on that delay")
+    parser.add_argument("--kbps", type=float, default=0.0, help="audio reply bandwidth cap (0 = none)")
+    parser.add_argument("--token-ms", type=float, default=20.0, help="gap between streamed words")
+    parser.add_argument("--transcript", default="what time is it")
+    parser.add_argument("--reply", default="It is half past seven.")
+    parser.add_argument("--reply-seconds", type=float, default=1.5)
+    parser.add_argument("--seed", type=int, help="fix the jitter sequence")
+    parser.add_argument("-v", "--verbose", action="store_true")
+    args = parser.parse_args()
+    if args.seed is not None:
+        random.seed(args.seed)
+
+    cloud = MockCloud(args)
+    app = web.Application(client_max_size=16 * 1024 * 1024)
+    app.router.add_post("/v1/responses", cloud.responses)
+    app.router.add_post("/v1/audio/speech", cloud.speech)
+    app.router.add_get("/v1/realtime", cloud.openai_realtime)
+    app.router.add_post("/v1/speech:recognize", cloud.recognize)
+    app.router.add_post("/v1beta/models/{target}", cloud.gemini)
+    app.router.add_post("/v1/text:synthesize", cloud.synthesize)
+    app.router.add_get("/ws/google.ai.generativelanguage.v1beta.GenerativeService.BidiGenerateContent",
+                       cloud.gemini_live)
+    print(f"Mock cloud on {args.host}:{args.port}: {args.latency_ms:g} ms +/- {args.jitter_ms:g} ms, "
+          f"{'unlimited' if args.kbps <= 0 else f'{args.kbps:g} kbps'}")
+    web.run_app(app, host=args.host, port=args.port, print=None)
+
+
+if __name__ == "__main__":
+    main()
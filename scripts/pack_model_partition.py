@@ -0,0 +1,61 @@
+#!/usr/bin/env python3
+"""
+Pack a TFLite model into a raw 'model' partition image for openWakeWord.
+
+Usage:
+    python3 pack_model_partition.py model.tflite model_partition.bin [partition_size] [model_version]
+
+The image starts with a 32-byte header (magic 'OWWM', header version, model
+size, CRC32, the model's own version, reserved) followed by the flatbuffer,
+so the firmware can memory-map exactly the model bytes, verify them and
+report which model it runs. Flash it with:
+
+    parttool.py write_partition --partition-name model --input model_partition.bin
+"""
+
+import os
+import struct
+import sys
+import zlib
+
+MAGIC = 0x4D57574F  # 'OWWM'
+VERSION = 2
+HEADER = struct.Struct('<IIIII12x')
+
+
+def pack_model(input_path, output_path, partition_size=None, model_version=0):
+    """Write header + model to output_path."""
+
+    if not os.path.exists(input_path):
+        print(f"Error: Input file '{input_path}' not found", file=sys.stderr)
+        return 1
+
+    with open(input_path, 'rb') as f:
+        model = f.read()
+
+    if len(model) < 8 or model[4:8] != b'TFL3':
+        print(f"Error: '{input_path}' is not a TFLite flatbuffer", file=sys.stderr)
+        return 1
+
+    image = HEADER.pack(MAGIC, VERSION, len(model), zlib.crc32(model) & 0xFFFFFFFF, model_version) + model
+
+    if partition_size is not None and len(image) > partition_size:
+        print(f"Error: image is {len(image)} bytes, partition holds {partition_size}",
+              file=sys.stderr)
+        return 1
+
+    with open(output_path, 'wb') as f:
+        f.write(image)
+
+    print(f"Wrote {output_path}: {len(model)} byte model version {model_version}, {len(image)} byte image")
+    return 0
+
+
+if __name__ == '__main__':
+    if len(sys.argv) < 3:
+        print(__doc__)
+        sys.exit(1)
+
+    size = int(sys.argv[3], 0) if len(sys.argv) > 3 else None
+    version = int(sys.argv[4], 0) if len(sys.argv) > 4 else 0
+    sys.exit(pack_model(sys.argv[1], sys.argv[2], size, version))
@@ -0,0 +1,143 @@
+#!/usr/bin/env python3
+"""
+Convert a PNG (or an RGB565 header from png_to_rgb565.py) to a compressed
+image asset for samples/atom_echo_rules_demo/main/image_asset.h.
+
+Usage:
+    python3 png_to_image_asset.py input.png output.h [--name NAME] [--width W] [--height H]
+    python3 png_to_image_asset.py naphome_image.h naphome_image.h --name naphome
+
+Images with at most 256 colours are stored as palette indices, others as
+RGB565. Either way pixels are run-length coded in PackBits-style packets.
+"""
+
+import argparse
+import os
+import re
+import struct
+import sys
+
+MAX_PACKET = 128
+MAX_PALETTE = 256
+
+
+def rgb888_to_rgb565(r, g, b):
+    """RGB888 to RGB565, byte-swapped the way the SPI panel expects it."""
+    value = ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3)
+    return ((value & 0xFF) << 8) | (value >> 8)
+
+
+def load_png(path, width, height):
+    from PIL import Image
+
+    img = Image.open(path).convert('RGB')
+    ratio = min(width / img.width, height / img.height)
+    scaled = img.resize((int(img.width * ratio), int(img.height * ratio)), Image.Resampling.LANCZOS)
+    bg = Image.new('RGB', (width, height), (0, 0, 0))
+    bg.paste(scaled, ((width - scaled.width) // 2, (height - scaled.height) // 2))
+    px = bg.load()
+    return width, height, [rgb888_to_rgb565(*px[x, y]) for y in range(height) for x in range(width)]
+
+
+def load_header(path):
+    text = open(path).read()
+    dims = re.findall(r'#define\s+\w+_(WIDTH|HEIGHT)\s+(\d+)', text)
+    sizes = {kind: int(value) for kind, value in dims}
+    body = text[text.index('{') + 1:text.rindex('}')]
+    pixels = [int(v, 16) for v in re.findall(r'0x([0-9A-Fa-f]{1,4})', body)]
+    width, height = sizes['WIDTH'], sizes['HEIGHT']
+    if len(pixels) != width * height:
+        raise ValueError(f'{path}: {len(pixels)} pixels for {width}x{height}')
+    return width, height, pixels
+
+
+def encode(pixels, width, height):
+    palette = sorted(set(pixels))
+    if len(palette) > MAX_PALETTE:
+        palette = []
+    index = {value: i for i, value in enumerate(palette)}
+
+    def pixel(value):
+        return bytes([index[value]]) if palette else struct.pack('<H', value)
+
+    out = bytearray(b'NIMG' + struct.pack('<BBHHH', 1, 0, width, height, len(palette)))
+    for value in palette:
+        out += struct.pack('<H', value)
+
+    literal = []
+
+    def flush_literal():
+        while literal:
+            chunk = literal[:MAX_PACKET]
+            del literal[:MAX_PACKET]
+            out.append(len(chunk) - 1)
+            for value in chunk:
+                out.extend(pixel(value))
+
+    i = 0
+    while i < len(pixels):
+        run = 1
+        while i + run < len(pixels) and run < MAX_PACKET and pixels[i + run] == pixels[i]:
+            run += 1
+        # A pair only pays for itself outside a literal packet
+        if run >= 3 or (run == 2 and not literal):
+            flush_literal()
+            out.append(0x80 | (run - 1))
+            out.extend(pixel(pixels[i]))
+            i += run
+        else:
+            literal.append(pixels[i])
+            i += 1
+    flush_literal()
+    return bytes(out), len(palette)
+
+
+def write_header(path, name, source, width, height, blob, palette_count):
+    with open(path, 'w') as f:
+        f.write(f'// Auto-generated from {os.path.basename(source)} by scripts/png_to_image_asset.py\n')
+        f.write(f'// Image size: {width}x{height} pixels\n')
+        kind = f'{palette_count}-colour palette' if palette_count else 'RGB565'
+        f.write(f'// Format: image asset, {kind}, {len(blob)} bytes ({width * height * 2} raw)\n')
+        f.write('#pragma once\n\n')
+        f.write('#include <stdint.h>\n\n')
+        f.write('#include "image_asset.h"\n\n')
+        f.write(f'#define {name.upper()}_WIDTH  {width}\n')
+        f.write(f'#define {name.upper()}_HEIGHT {height}\n\n')
+        f.write(f'static const uint8_t {name}_asset_data[{len(blob)}] = {{\n')
+        for start in range(0, len(blob), 16):
+            row = ', '.join(f'0x{b:02X}' for b in blob[start:start + 16])
+            f.write(f'    {row},\n')
+        f.write('};\n\n')
+        f.write(f'static const image_asset_t {name}_asset = {{{name}_asset_data, sizeof({name}_asset_data)}};\n')
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('input')
+    parser.add_argument('output')
+    parser.add_argument('--name', help='C identifier prefix (default: from the input file name)')
+    parser.add_argument('--width', type=int, default=128)
+    parser.add_argument('--height', type=int, default=128)
+    args = parser.parse_args()
+
+    name = args.name or re.sub(r'\W', '_', os.path.splitext(os.path.basename(args.input))[0])
+    if not name[0].isalpha():
+        name = 'img_' + name
+    try:
+        if args.input.endswith('.h'):
+            width, height, pixels = load_header(args.input)
+        else:
+            width, height, pixels = load_png(args.input, args.width, args.height)
+    except (OSError, ValueError, KeyError) as e:
+        print(f'Error: {e}', file=sys.stderr)
+        return 1
+
+    blob, palette_count = encode(pixels, width, height)
+    write_header(args.output, name, args.input, width, height, blob, palette_count)
+    print(f'{args.input} -> {args.output}: {width}x{height}, {len(blob)} bytes '
+          f'({100 * len(blob) // (width * height * 2)}% of raw), palette {palette_count or "none"}')
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -5,16 +5,27 @@ Provision an AWS IoT Core Thing with certificate material for Naphome devices.
 This helper creates (or reuses) a Thing, generates an X.509 certificate +
 private key, attaches an IoT policy, and writes the artifacts to disk.
 
+With --key-type ec-p256 the key pair is an ECDSA P-256 one generated locally
+and AWS IoT only signs a CSR for it; the private key never leaves this
+machine. Handshakes with a P-256 key cost the device far less than with the
+RSA-2048 key AWS generates otherwise. --nvs-csv also writes an NVS CSV for
+nvs_partition_gen.py, for firmware built with
+CONFIG_NAPHOME_AWS_IOT_CREDENTIALS_NVS (encrypt that partition).
+
 Prerequisites:
   * AWS credentials with IoT administrative permissions available in the
     environment (via ~/.aws/credentials, environment variables, SSO, etc.)
   * boto3 installed in the active Python environment.
+  * cryptography installed, for --key-type ec-p256.
 
 Example:
     python scripts/provision_aws_thing.py \\
         --thing-name SOMNUS_ABCDEF123456 \\
         --policy-name SomnusDevicePolicy \\
         --output-dir components/aws_iot/certs/generated/SOMNUS_ABCDEF123456
+
+    python scripts/provision_aws_thing.py --thing-name SOMNUS_ABCDEF123456 \\
+        --key-type ec-p256 --nvs-csv
 """
 
 from __future__ import annotations
@@ -31,6 +42,9 @@ import boto3
 from botocore.exceptions import ClientError
 
 DEFAULT_ROOT_CA_URL = "https://www.amazontrust.com/repository/AmazonRootCA1.pem"
+# ECC root; the endpoint may present either chain to an ECDSA-capable client
+ECC_ROOT_CA_URL = "https://www.amazontrust.com/repository/AmazonRootCA3.pem"
+NVS_NAMESPACE = "aws_cred"
 
 
 def parse_args() -> argparse.Namespace:
@@ -69,6 +83,18 @@ def parse_args() -> argparse.Namespace:
         default=DEFAULT_ROOT_CA_URL,
         help="URL to download the Amazon Root CA PEM.",
     )
+    parser.add_argument(
+        "--key-type",
+        choices=("rsa", "ec-p256"),
+        default="rsa",
+        help="rsa: key pair generated by AWS IoT. ec-p256: ECDSA P-256 key generated locally, "
+        "certificate issued from a CSR.",
+    )
+    parser.add_argument(
+        "--nvs-csv",
+        action="store_true",
+        help=f"Also write nvs_credentials.csv (namespace '{NVS_NAMESPACE}') for nvs_partition_gen.py.",
+    )
     parser.add_argument(
         "--no-activate",
         action="store_true",
@@ -156,6 +182,38 @@ def create_certificate(iot, set_active: bool) -> Dict[str, str]:
     }
 
 
+def create_certificate_from_csr(iot, thing_name: str, set_active: bool) -> Dict[str, str]:
+    from cryptography import x509
+    from cryptography.hazmat.primitives import hashes, serialization
+    from cryptography.hazmat.primitives.asymmetric import ec
+    from cryptography.x509.oid import NameOID
+
+    key = ec.generate_private_key(ec.SECP256R1())
+    csr = (
+        x509.CertificateSigningRequestBuilder()
+        .subject_name(x509.Name([x509.NameAttribute(NameOID.COMMON_NAME, thing_name)]))
+        .sign(key, hashes.SHA256())
+    )
+    response = iot.create_certificate_from_csr(
+        certificateSigningRequest=csr.public_bytes(serialization.Encoding.PEM).decode("ascii"),
+        setAsActive=set_active,
+    )
+    return {
+        "certificate_arn": response["certificateArn"],
+        "certificate_id": response["certificateId"],
+        "certificate_pem": response["certificatePem"],
+        # SEC1 "EC PRIVATE KEY", which mbedTLS parses directly
+        "private_key": key.private_bytes(
+            serialization.Encoding.PEM,
+            serialization.PrivateFormat.TraditionalOpenSSL,
+            serialization.NoEncryption(),
+        ).decode("ascii"),
+        "public_key": key.public_key()
+        .public_bytes(serialization.Encoding.PEM, serialization.PublicFormat.SubjectPublicKeyInfo)
+        .decode("ascii"),
+    }
+
+
 def attach_resources(iot, thing_name: str, certificate_arn: str, policy_name: str) -> None:
     print(f"[INFO] Attaching certificate to Thing '{thing_name}'.")
     iot.attach_thing_principal(thingName=thing_name, principal=certificate_arn)
@@ -197,6 +255,19 @@ def write_artifacts(output_dir: Path, thing_name: str, cert_bundle: Dict[str, st
     return paths
 
 
+def write_nvs_csv(paths: Dict[str, Path]) -> Path:
+    """CSV for nvs_partition_gen.py; file entries are read at generation time."""
+    csv_path = paths["device_cert"].parent / "nvs_credentials.csv"
+    csv_path.write_text(
+        "key,type,encoding,value\n"
+        f"{NVS_NAMESPACE},namespace,,\n"
+        f"cert,file,string,{paths['device_cert'].resolve()}\n"
+        f"key,file,string,{paths['private_key'].resolve()}\n",
+        encoding="utf-8",
+    )
+    return csv_path
+
+
 def main() -> int:
     args = parse_args()
 
@@ -210,17 +281,24 @@ def main() -> int:
     policy_doc = load_policy_document(args, args.region, account_id)
     ensure_policy(iot, args.policy_name, policy_doc)
 
-    cert_bundle = create_certificate(iot, set_active=not args.no_activate)
+    if args.key_type == "ec-p256":
+        cert_bundle = create_certificate_from_csr(iot, args.thing_name, set_active=not args.no_activate)
+    else:
+        cert_bundle = create_certificate(iot, set_active=not args.no_activate)
     attach_resources(iot, args.thing_name, cert_bundle["certificate_arn"], args.policy_name)
 
     root_ca_pem = download_root_ca(args.root_ca_url)
+    if args.key_type == "ec-p256" and args.root_ca_url == DEFAULT_ROOT_CA_URL:
+        root_ca_pem = root_ca_pem.rstrip("\n") + "\n" + download_root_ca(ECC_ROOT_CA_URL)
     paths = write_artifacts(args.output_dir, args.thing_name, cert_bundle, root_ca_pem)
+    nvs_csv = write_nvs_csv(paths) if args.nvs_csv else None
 
     summary = textwrap.dedent(
         f"""
         Provisioning complete!
 
         Thing Name: {args.thing_name}
+        Key Type: {args.key_type}
         Certificate ARN: {cert_bundle['certificate_arn']}
         Output Directory: {paths['device_cert'].parent}
 
@@ -235,6 +313,17 @@ def main() -> int:
     ).strip()
 
     print(summary)
+    if nvs_csv:
+        print(
+            textwrap.dedent(
+                f"""
+                NVS credentials: {nvs_csv}
+                  Build with CONFIG_NAPHOME_AWS_IOT_CREDENTIALS_NVS and flash the CSV into the NVS
+                  partition, encrypted (nvs_partition_gen.py encrypt ... --keygen), instead of
+                  copying the PEM files into components/aws_iot/certs.
+                """
+            ).rstrip()
+        )
     return 0
 
 
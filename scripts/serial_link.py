@@ -0,0 +1,354 @@
+#!/usr/bin/env python3
+"""
+Host side of the binary serial link (docs/SERIAL_LINK_PROTOCOL.md).
+Splits the console stream into text logs and COBS frames, sends commands
+and stream subscriptions, and records telemetry or raw capture audio.
+
+Examples:
+  serial_link.py /dev/ttyUSB0 monitor --streams levels,vad,wake,cpu
+  serial_link.py /dev/ttyUSB0 cmd SPOTIFY_PAUSE
+  serial_link.py /dev/ttyUSB0 --baud 2000000 audio capture.wav --seconds 10
+  serial_link.py /dev/ttyACM0 wake-capture training/hey_naptick/data/device
+"""
+
+import argparse
+import json
+import os
+import struct
+import sys
+import time
+import wave
+
+import serial
+
+FRAME_COMMAND = 0x01
+FRAME_SUBSCRIBE = 0x02
+FRAME_BENCH_AUDIO = 0x03
+FRAME_RESULT = 0x81
+FRAME_LEVELS = 0x10
+FRAME_VAD = 0x11
+FRAME_WAKE = 0x12
+FRAME_CPU = 0x13
+FRAME_AUDIO = 0x20
+FRAME_CAPTURE_BEGIN = 0x21
+FRAME_CAPTURE_AUDIO = 0x22
+FRAME_CAPTURE_SCORES = 0x23
+FRAME_CAPTURE_END = 0x24
+FRAME_LOG = 0x30
+
+STREAMS = {"levels": 1 << 0, "vad": 1 << 1, "wake": 1 << 2, "cpu": 1 << 3, "audio": 1 << 4,
+           "wake_capture": 1 << 5, "log": 1 << 6}
+CAPTURE_SOURCES = {0: "energy", 1: "wakenet"}
+CAPTURE_OUTCOMES = {0: "near_miss", 1: "detected"}
+VAD_EVENTS = {0: "silence", 1: "onset", 2: "speech", 3: "end"}
+CAPTURE_RATE_HZ = 16000
+
+
+def crc16_x25(data):
+    """esp_rom_crc16_le(0, data): reflected 0x1021, init and xorout 0xFFFF."""
+    crc = 0xFFFF
+    for byte in data:
+        crc ^= byte
+        for _ in range(8):
+            crc = (crc >> 1) ^ 0x8408 if crc & 1 else crc >> 1
+    return crc ^ 0xFFFF
+
+
+def cobs_encode(data):
+    out = bytearray([0])
+    code_pos, code = 0, 1
+    for byte in data:
+        if byte:
+            out.append(byte)
+            code += 1
+        if not byte or code == 0xFF:
+            out[code_pos] = code
+            code_pos, code = len(out), 1
+            out.append(0)
+    out[code_pos] = code
+    return bytes(out)
+
+
+def cobs_decode(data):
+    out = bytearray()
+    pos = 0
+    while pos < len(data):
+        code = data[pos]
+        pos += 1
+        if code == 0 or pos + code - 1 > len(data):
+            return None
+        out += data[pos:pos + code - 1]
+        pos += code - 1
+        if code != 0xFF and pos < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+class SerialLink:
+    """Reads the shared port; text lines go to on_text, frames to on_frame."""
+
+    def __init__(self, port, baud, on_text=None, on_frame=None):
+        self.ser = serial.Serial(port, baud, timeout=0.05)
+        self.on_text = on_text or (lambda line: None)
+        self.on_frame = on_frame or (lambda ftype, seq, payload: None)
+        self.text = bytearray()
+        self.frame = bytearray()
+        self.in_frame = False
+        self.seq = 0
+        self.results = {}
+
+    def send(self, ftype, payload=b""):
+        seq = self.seq
+        self.seq = (self.seq + 1) & 0xFF
+        body = bytes([ftype, seq]) + payload
+        body += struct.pack("<H", crc16_x25(body))
+        self.ser.write(b"\x00" + cobs_encode(body) + b"\x00")
+        return seq
+
+    def request(self, ftype, payload=b"", timeout=3.0):
+        """Send a host frame and wait for its RESULT; returns the esp_err_t."""
+        seq = self.send(ftype, payload)
+        deadline = time.monotonic() + timeout
+        while time.monotonic() < deadline:
+            self.poll()
+            if seq in self.results:
+                return self.results.pop(seq)
+        raise TimeoutError(f"no RESULT for frame {seq}")
+
+    def subscribe(self, streams, period_ms=0):
+        return self.request(FRAME_SUBSCRIBE, struct.pack("<IH", streams, period_ms))
+
+    def command(self, text):
+        return self.request(FRAME_COMMAND, text.encode())
+
+    def poll(self):
+        for byte in self.ser.read(4096):
+            self._byte(byte)
+
+    def _byte(self, byte):
+        # Mirrors rx_byte() in serial_command_parser.c
+        if byte == 0:
+            if self.in_frame and self.frame and self._frame(bytes(self.frame)):
+                self.in_frame = False
+            else:
+                self.in_frame = True
+            self.frame.clear()
+            return
+        if self.in_frame:
+            self.frame.append(byte)
+        elif byte == 0x0A:
+            self.on_text(self.text.decode(errors="replace").rstrip("\r"))
+            self.text.clear()
+        else:
+            self.text.append(byte)
+
+    def _frame(self, encoded):
+        raw = cobs_decode(encoded)
+        if not raw or len(raw) < 4:
+            return False
+        if crc16_x25(raw[:-2]) != struct.unpack("<H", raw[-2:])[0]:
+            return False
+        ftype, seq, payload = raw[0], raw[1], raw[2:-2]
+        if ftype == FRAME_RESULT:
+            answered, status = struct.unpack("<Bi", payload)
+            self.results[answered] = status
+        self.on_frame(ftype, seq, payload)
+        return True
+
+
+def describe(ftype, payload):
+    if ftype == FRAME_LEVELS:
+        t, l_rms, r_rms, l_pk, r_pk, proc, dropped = struct.unpack("<I5fI", payload)
+        return f"{t:>9} levels rms {l_rms:7.1f} {r_rms:7.1f} peak {l_pk:7.1f} {r_pk:7.1f} afe {proc:7.1f} dropped {dropped}"
+    if ftype == FRAME_VAD:
+        t, event, speech, in_speech, energy, floor = struct.unpack("<I3B2f", payload)
+        return f"{t:>9} vad {VAD_EVENTS.get(event, event):8} vote {speech} in {in_speech} energy {energy:8.1f} floor {floor:8.1f}"
+    if ftype == FRAME_WAKE:
+        t, score, threshold, detected = struct.unpack("<I2fB", payload)
+        return f"{t:>9} wake {score:8.1f} / {threshold:8.1f}{'  DETECTED' if detected else ''}"
+    if ftype == FRAME_CPU:
+        t, core0, core1, count = struct.unpack_from("<I2fB", payload)
+        tasks = []
+        for i in range(count):
+            name, core, load = struct.unpack_from("<16sbf", payload, 13 + i * 21)
+            tasks.append(f"{name.rstrip(bytes(1)).decode()}:{load:.0f}%")
+        return f"{t:>9} cpu {core0:5.1f}% {core1:5.1f}%  " + " ".join(tasks)
+    if ftype == FRAME_RESULT:
+        seq, status = struct.unpack("<Bi", payload)
+        return f"result for {seq}: {status:#x}"
+    return None
+
+
+def parse_streams(text):
+    mask = 0
+    for name in filter(None, text.split(",")):
+        if name not in STREAMS:
+            sys.exit(f"unknown stream {name!r}; choose from {', '.join(STREAMS)}")
+        mask |= STREAMS[name]
+    return mask
+
+
+def run_monitor(link, args):
+    def on_frame(ftype, seq, payload):
+        line = describe(ftype, payload)
+        if line and ftype != FRAME_RESULT:
+            print(line)
+
+    link.on_frame = on_frame
+    if not args.quiet:
+        link.on_text = lambda line: print(f"[log] {line}")
+    link.subscribe(parse_streams(args.streams), args.period)
+    try:
+        while True:
+            link.poll()
+    except KeyboardInterrupt:
+        pass
+    finally:
+        link.subscribe(0)
+
+
+def run_audio(link, args):
+    chunks = []
+    state = {"next": None, "lost": 0, "channels": 2}
+
+    def on_frame(ftype, seq, payload):
+        if ftype != FRAME_AUDIO:
+            return
+        first, channels, _ = struct.unpack_from("<IBB", payload)
+        pcm = payload[6:]
+        frames = len(pcm) // (2 * channels)
+        if state["next"] is not None and first > state["next"]:
+            # Fill dropped frames with silence so the timeline stays true
+            missing = first - state["next"]
+            state["lost"] += missing
+            chunks.append(bytes(missing * 2 * channels))
+        state["next"] = first + frames
+        state["channels"] = channels
+        chunks.append(pcm)
+
+    link.on_frame = on_frame
+    link.subscribe(STREAMS["audio"])
+    deadline = time.monotonic() + args.seconds
+    try:
+        while time.monotonic() < deadline:
+            link.poll()
+    finally:
+        link.subscribe(0)
+    with wave.open(args.output, "wb") as wav:
+        wav.setnchannels(state["channels"])
+        wav.setsampwidth(2)
+        wav.setframerate(CAPTURE_RATE_HZ)
+        wav.writeframes(b"".join(chunks))
+    print(f"Wrote {args.output}; {state['lost']} frames lost to a full TX buffer")
+
+
+class CaptureTrack:
+    """PCM placed by frame offset; gaps stay silent."""
+
+    def __init__(self, channels):
+        self.channels = channels
+        self.pcm = bytearray()
+
+    def put(self, first_frame, pcm):
+        start = first_frame * 2 * self.channels
+        if len(self.pcm) < start + len(pcm):
+            self.pcm.extend(bytes(start + len(pcm) - len(self.pcm)))
+        self.pcm[start:start + len(pcm)] = pcm
+
+    def write(self, path, rate):
+        with wave.open(path, "wb") as wav:
+            wav.setnchannels(self.channels)
+            wav.setsampwidth(2)
+            wav.setframerate(rate)
+            wav.writeframes(bytes(self.pcm))
+
+
+def run_wake_capture(link, args):
+    os.makedirs(args.output, exist_ok=True)
+    windows = {}
+
+    def on_frame(ftype, seq, payload):
+        if ftype == FRAME_CAPTURE_BEGIN:
+            (wid, source, outcome, t, score, threshold, rate, pre, post,
+             channels) = struct.unpack("<HBBI2f3HB", payload)
+            windows[wid] = {
+                "meta": {
+                    "source": CAPTURE_SOURCES.get(source, source),
+                    "outcome": CAPTURE_OUTCOMES.get(outcome, outcome),
+                    "time_ms": t, "score": score, "threshold": threshold,
+                    "sample_rate_hz": rate, "preroll_ms": pre, "postroll_ms": post,
+                },
+                "tracks": [CaptureTrack(channels), CaptureTrack(1)],
+            }
+        elif ftype == FRAME_CAPTURE_AUDIO:
+            wid, track, channels, first = struct.unpack_from("<HBBI", payload)
+            if wid in windows:
+                windows[wid]["tracks"][track].put(first, payload[8:])
+        elif ftype == FRAME_CAPTURE_SCORES:
+            wid, count = struct.unpack_from("<HB", payload)
+            if wid in windows:
+                windows[wid]["meta"]["scores"] = [
+                    struct.unpack_from("<If", payload, 3 + i * 8) for i in range(count)]
+        elif ftype == FRAME_CAPTURE_END and struct.unpack_from("<H", payload)[0] in windows:
+            wid, raw, proc, lost = struct.unpack("<H3I", payload)
+            window = windows.pop(wid)
+            meta = window["meta"]
+            meta.update(raw_frames=raw, processed_frames=proc, lost_frames=lost)
+            stem = os.path.join(args.output, f"{time.strftime('%Y%m%d_%H%M%S')}_{wid:04d}_{meta['outcome']}")
+            window["tracks"][0].write(stem + "_raw.wav", meta["sample_rate_hz"])
+            if proc:
+                window["tracks"][1].write(stem + "_afe.wav", meta["sample_rate_hz"])
+            with open(stem + ".json", "w") as f:
+                json.dump(meta, f, indent=2)
+            print(f"{stem}: {meta['outcome']} ({meta['source']}) score {meta['score']:.1f} / "
+                  f"{meta['threshold']:.1f}, {lost} frames lost")
+
+    link.on_frame = on_frame
+    link.subscribe(STREAMS["wake_capture"])
+    print(f"Collecting wake-word windows into {args.output}; Ctrl+C to stop")
+    try:
+        while True:
+            link.poll()
+    except KeyboardInterrupt:
+        pass
+    finally:
+        link.subscribe(0)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("port")
+    parser.add_argument("--baud", type=int, default=115200)
+    sub = parser.add_subparsers(dest="action", required=True)
+
+    mon = sub.add_parser("monitor", help="print telemetry streams")
+    mon.add_argument("--streams", default="levels,vad,wake,cpu")
+    mon.add_argument("--period", type=int, default=100, help="LEVELS/CPU period in ms")
+    mon.add_argument("--quiet", action="store_true", help="hide text logs")
+
+    cmd = sub.add_parser("cmd", help="run a console command and print its status")
+    cmd.add_argument("command", nargs="+")
+
+    aud = sub.add_parser("audio", help="record raw stereo capture to a WAV file")
+    aud.add_argument("output")
+    aud.add_argument("--seconds", type=float, default=10.0)
+
+    cap = sub.add_parser("wake-capture", help="save audio around wake detections and near misses")
+    cap.add_argument("output", help="directory for the WAV and JSON files")
+
+    args = parser.parse_args()
+    link = SerialLink(args.port, args.baud)
+    if args.action == "monitor":
+        run_monitor(link, args)
+    elif args.action == "cmd":
+        status = link.command(" ".join(args.command))
+        print("ok" if status == 0 else f"failed: {status:#x}")
+        sys.exit(0 if status == 0 else 1)
+    elif args.action == "audio":
+        run_audio(link, args)
+    else:
+        run_wake_capture(link, args)
+
+
+if __name__ == "__main__":
+    main()
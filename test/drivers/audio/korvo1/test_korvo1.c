@@ -71,3 +71,46 @@ TEST_CASE("korvo1 read requires start", "[korvo1]")
     TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, korvo1_read(&dev, buffer, sizeof(buffer), NULL, 0));
     TEST_ASSERT_EQUAL(ESP_OK, korvo1_deinit(&dev));
 }
+
+TEST_CASE("korvo1 tdm rejects a bad slot count", "[korvo1]")
+{
+    korvo1_t dev = {0};
+    korvo1_config_t cfg = {
+        .port = I2S_NUM_0,
+        .din_io_num = GPIO_NUM_19,
+        .bclk_io_num = GPIO_NUM_18,
+        .ws_io_num = GPIO_NUM_17,
+        .mclk_io_num = GPIO_NUM_0,
+        .sample_rate_hz = 16000,
+        .dma_buffer_count = 4,
+        .dma_buffer_len = 128,
+        .mode = KORVO1_CAPTURE_TDM,
+        .tdm_slots = 1,
+    };
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, korvo1_init(&dev, &cfg));
+    cfg.tdm_slots = KORVO1_TDM_MAX_SLOTS + 1;
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, korvo1_init(&dev, &cfg));
+    TEST_ASSERT_FALSE(dev.initialized);
+}
+
+TEST_CASE("korvo1 tdm init start stop", "[korvo1]")
+{
+    korvo1_t dev = {0};
+    korvo1_config_t cfg = {
+        .port = I2S_NUM_0,
+        .din_io_num = GPIO_NUM_19,
+        .bclk_io_num = GPIO_NUM_18,
+        .ws_io_num = GPIO_NUM_17,
+        .mclk_io_num = GPIO_NUM_0,
+        .sample_rate_hz = 16000,
+        .dma_buffer_count = 4,
+        .dma_buffer_len = 128,
+        .mode = KORVO1_CAPTURE_TDM,
+        .tdm_slots = 4,
+    };
+    TEST_ASSERT_EQUAL(ESP_OK, korvo1_init(&dev, &cfg));
+    TEST_ASSERT_TRUE(dev.initialized);
+    TEST_ASSERT_EQUAL(ESP_OK, korvo1_start(&dev));
+    TEST_ASSERT_EQUAL(ESP_OK, korvo1_stop(&dev));
+    TEST_ASSERT_EQUAL(ESP_OK, korvo1_deinit(&dev));
+}
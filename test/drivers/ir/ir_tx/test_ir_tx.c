@@ -0,0 +1,72 @@
+#include "unity.h"
+#include "ir_tx.h"
+
+#include <string.h>
+
+static bool symbol_is(rmt_symbol_word_t s, int level0, int duration0, int level1, int duration1)
+{
+    return s.level0 == level0 && s.duration0 == duration0 && s.level1 == level1 && s.duration1 == duration1;
+}
+
+TEST_CASE("ir_tx NEC frame carries address, command and their inverses LSB first", "[ir_tx]")
+{
+    rmt_symbol_word_t frame[IR_TX_NEC_SYMBOLS];
+    TEST_ASSERT_EQUAL(IR_TX_NEC_SYMBOLS, ir_tx_encode_nec(0x04, 0x08, frame));
+
+    TEST_ASSERT_TRUE(symbol_is(frame[0], 1, IR_TX_NEC_HEADER_MARK_US, 0, IR_TX_NEC_HEADER_SPACE_US));
+    const uint32_t expected = 0x04 | (0xFB << 8) | (0x08 << 16) | ((uint32_t)0xF7 << 24);
+    for (int bit = 0; bit < 32; ++bit) {
+        int space = (expected >> bit) & 1 ? IR_TX_NEC_ONE_SPACE_US : IR_TX_NEC_ZERO_SPACE_US;
+        TEST_ASSERT_TRUE(symbol_is(frame[1 + bit], 1, IR_TX_NEC_MARK_US, 0, space));
+    }
+    TEST_ASSERT_TRUE(symbol_is(frame[33], 1, IR_TX_NEC_MARK_US, 0, IR_TX_NEC_ZERO_SPACE_US));
+}
+
+TEST_CASE("ir_tx RC5 frame is Manchester coded MSB first", "[ir_tx]")
+{
+    rmt_symbol_word_t frame[IR_TX_RC5_SYMBOLS];
+    TEST_ASSERT_EQUAL(IR_TX_RC5_SYMBOLS, ir_tx_encode_rc5(0x05, 0x35, true, frame));
+
+    // S1, S2 (command below 64), T, then 00101 and 110101
+    const char *bits = "11100101110101";
+    for (int i = 0; i < IR_TX_RC5_SYMBOLS; ++i) {
+        int one = bits[i] == '1';
+        TEST_ASSERT_TRUE(symbol_is(frame[i], !one, IR_TX_RC5_HALF_BIT_US, one, IR_TX_RC5_HALF_BIT_US));
+    }
+
+    // Commands 64 and up clear the field bit
+    ir_tx_encode_rc5(0, 0x40, false, frame);
+    TEST_ASSERT_EQUAL(1, frame[1].level0);
+}
+
+TEST_CASE("ir_tx library frames match the run-time encoders", "[ir_tx]")
+{
+    rmt_symbol_word_t encoded[IR_TX_NEC_SYMBOLS];
+
+    const ir_tx_code_t *nec = ir_tx_find_code("lg_tv_power");
+    TEST_ASSERT_NOT_NULL(nec);
+    TEST_ASSERT_EQUAL(IR_TX_NEC_CARRIER_HZ, nec->carrier_hz);
+    TEST_ASSERT_EQUAL(IR_TX_NEC_SYMBOLS, nec->frame_len);
+    ir_tx_encode_nec(0x04, 0x08, encoded);
+    TEST_ASSERT_EQUAL_MEMORY(encoded, nec->frame, sizeof(rmt_symbol_word_t) * IR_TX_NEC_SYMBOLS);
+    TEST_ASSERT_NOT_NULL(nec->repeat);
+    TEST_ASSERT_NULL(nec->toggled);
+
+    const ir_tx_code_t *rc5 = ir_tx_find_code("philips_tv_power");
+    TEST_ASSERT_NOT_NULL(rc5);
+    TEST_ASSERT_EQUAL(IR_TX_RC5_CARRIER_HZ, rc5->carrier_hz);
+    ir_tx_encode_rc5(0, 12, false, encoded);
+    TEST_ASSERT_EQUAL_MEMORY(encoded, rc5->frame, sizeof(rmt_symbol_word_t) * IR_TX_RC5_SYMBOLS);
+    ir_tx_encode_rc5(0, 12, true, encoded);
+    TEST_ASSERT_EQUAL_MEMORY(encoded, rc5->toggled, sizeof(rmt_symbol_word_t) * IR_TX_RC5_SYMBOLS);
+}
+
+TEST_CASE("ir_tx rejects unknown codes and sends before init", "[ir_tx]")
+{
+    TEST_ASSERT_NULL(ir_tx_find_code("no_such_button"));
+    TEST_ASSERT_NULL(ir_tx_find_code(NULL));
+
+    ir_tx_t tx;
+    memset(&tx, 0, sizeof(tx));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, ir_tx_send_code(&tx, ir_tx_find_code("lg_tv_mute"), 0));
+}
@@ -0,0 +1,145 @@
+#include "unity.h"
+#include "as7341.h"
+#include "fake_i2c_dev.h"
+
+#include <string.h>
+
+static uint8_t g_registers[256];
+static bool g_smux_busy;          // Leave SMUXEN set after a route, as if still routing
+static int g_transfers;
+
+esp_err_t as7341_i2c_transfer(i2c_master_dev_handle_t i2c_dev,
+                              const uint8_t *write_buf,
+                              size_t write_size,
+                              uint8_t *read_buf,
+                              size_t read_size,
+                              int timeout_ms)
+{
+    (void)i2c_dev;
+    (void)timeout_ms;
+    g_transfers++;
+    uint8_t reg = write_buf[0];
+    if (read_size == 0) {
+        memcpy(&g_registers[reg], &write_buf[1], write_size - 1);
+        if (reg == 0x80 && !g_smux_busy) {
+            g_registers[0x80] &= ~(1 << 4);   // routing done at once
+        }
+        return ESP_OK;
+    }
+    memcpy(read_buf, &g_registers[reg], read_size);
+    return ESP_OK;
+}
+
+// ASTATUS then six channels, little-endian
+static void put_data(uint8_t astatus, const uint16_t ch[6])
+{
+    g_registers[0x94] = astatus;
+    for (int i = 0; i < 6; ++i) {
+        g_registers[0x95 + 2 * i] = ch[i] & 0xFF;
+        g_registers[0x96 + 2 * i] = ch[i] >> 8;
+    }
+    g_registers[0xA3] = 1 << 6;               // AVALID
+}
+
+static void test_init(as7341_t *dev)
+{
+    memset(g_registers, 0, sizeof(g_registers));
+    g_smux_busy = false;
+    g_registers[0x92] = 0x24;                 // ID
+    *dev = (as7341_t){.i2c_dev = FAKE_I2C_DEV};
+    as7341_config_t cfg = {.atime = 29, .astep = 599, .gain = AS7341_GAIN_128X};
+    TEST_ASSERT_EQUAL(ESP_OK, as7341_init(dev, &cfg));
+}
+
+static void test_deinit(as7341_t *dev)
+{
+    FAKE_I2C_DETACH(dev);
+    TEST_ASSERT_EQUAL(ESP_OK, as7341_deinit(dev));
+}
+
+TEST_CASE("as7341 init sets timing and routes the low bank", "[as7341]")
+{
+    as7341_t dev;
+    test_init(&dev);
+    TEST_ASSERT_EQUAL_HEX8(29, g_registers[0x81]);
+    TEST_ASSERT_EQUAL_HEX8(599 & 0xFF, g_registers[0xCA]);
+    TEST_ASSERT_EQUAL_HEX8(599 >> 8, g_registers[0xCB]);
+    TEST_ASSERT_EQUAL_HEX8(8, g_registers[0xAA]);
+    TEST_ASSERT_EQUAL_HEX8(0x10, g_registers[0xAF]);        // SMUX write command
+    TEST_ASSERT_EQUAL_HEX8(0x01, g_registers[0x80]);        // powered, routing done
+    TEST_ASSERT_EQUAL_HEX8(0x30, g_registers[0x00]);        // F1-F4 table
+    TEST_ASSERT_EQUAL_HEX8(0x06, g_registers[0x13]);
+    TEST_ASSERT_EQUAL(AS7341_BANK_F1_F4, dev.bank);
+    // 30 x 600 x 2.78 µs = 50.04 ms, plus start-up
+    TEST_ASSERT_EQUAL(53, as7341_measurement_ms(&dev));
+    test_deinit(&dev);
+}
+
+TEST_CASE("as7341 init rejects another chip", "[as7341]")
+{
+    as7341_t dev;
+    test_init(&dev);
+    test_deinit(&dev);
+    g_registers[0x92] = 0x90;
+    dev.i2c_dev = FAKE_I2C_DEV;
+    as7341_config_t cfg = {.atime = 29, .astep = 599, .gain = AS7341_GAIN_1X};
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_FOUND, as7341_init(&dev, &cfg));
+    TEST_ASSERT_FALSE(dev.initialized);
+}
+
+TEST_CASE("as7341 alternates banks into one spectrum", "[as7341]")
+{
+    as7341_t dev;
+    test_init(&dev);
+    TEST_ASSERT_EQUAL(ESP_OK, as7341_start(&dev));
+    TEST_ASSERT_EQUAL_HEX8(0x03, g_registers[0x80]);        // PON | SP_EN
+
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_FINISHED, as7341_read(&dev, NULL));
+
+    const uint16_t low[6] = {100, 200, 300, 400, 5000, 600};
+    put_data(0, low);
+    as7341_bank_t bank;
+    g_transfers = 0;
+    TEST_ASSERT_EQUAL(ESP_OK, as7341_read(&dev, &bank));
+    TEST_ASSERT_EQUAL(AS7341_BANK_F1_F4, bank);
+    // Status, data burst, then stop, table, command and enable
+    TEST_ASSERT_EQUAL(6, g_transfers);
+    TEST_ASSERT_EQUAL(AS7341_BANK_F5_F8, dev.bank);
+    TEST_ASSERT_EQUAL_HEX8(0x40, g_registers[0x03]);        // F5-F8 table
+    TEST_ASSERT_EQUAL_HEX8(0x24, g_registers[0x0E]);
+
+    as7341_spectrum_t s;
+    as7341_get_spectrum(&dev, &s);
+    TEST_ASSERT_EQUAL(1, s.fresh);
+    TEST_ASSERT_EQUAL(400, s.f[3]);
+
+    TEST_ASSERT_EQUAL(ESP_OK, as7341_start(&dev));
+    const uint16_t high[6] = {500, 600, 700, 800, 5100, 650};
+    put_data(0x80, high);                     // saturated
+    TEST_ASSERT_EQUAL(ESP_OK, as7341_read(&dev, &bank));
+    TEST_ASSERT_EQUAL(AS7341_BANK_F5_F8, bank);
+    TEST_ASSERT_EQUAL(AS7341_BANK_F1_F4, dev.bank);
+
+    as7341_get_spectrum(&dev, &s);
+    TEST_ASSERT_EQUAL(3, s.fresh);
+    TEST_ASSERT_EQUAL(100, s.f[0]);
+    TEST_ASSERT_EQUAL(800, s.f[7]);
+    TEST_ASSERT_EQUAL(5100, s.clear);
+    TEST_ASSERT_EQUAL(650, s.nir);
+    TEST_ASSERT_TRUE(s.saturated);
+    test_deinit(&dev);
+}
+
+TEST_CASE("as7341 start waits for the SMUX", "[as7341]")
+{
+    as7341_t dev;
+    test_init(&dev);
+    g_smux_busy = true;
+    const uint16_t ch[6] = {0};
+    put_data(0, ch);
+    TEST_ASSERT_EQUAL(ESP_OK, as7341_read(&dev, NULL));
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_FINISHED, as7341_start(&dev));
+    g_registers[0x80] = 0x01;
+    TEST_ASSERT_EQUAL(ESP_OK, as7341_start(&dev));
+    test_deinit(&dev);
+}
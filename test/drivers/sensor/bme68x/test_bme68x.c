@@ -0,0 +1,266 @@
+#include "unity.h"
+#include "bme68x.h"
+#include "fake_i2c_dev.h"
+
+#include <math.h>
+#include <string.h>
+
+static uint8_t g_registers[256];
+static int g_calib_reads;
+static int g_writes;
+
+esp_err_t bme68x_i2c_transfer(i2c_master_dev_handle_t i2c_dev,
+                              const uint8_t *write_buf,
+                              size_t write_size,
+                              uint8_t *read_buf,
+                              size_t read_size,
+                              int timeout_ms)
+{
+    (void)i2c_dev;
+    (void)timeout_ms;
+    if (read_size == 0) {
+        if (write_size % 2 != 0) {
+            return ESP_FAIL;
+        }
+        for (size_t i = 0; i < write_size; i += 2) {
+            g_registers[write_buf[i]] = write_buf[i + 1];
+        }
+        g_writes++;
+        return ESP_OK;
+    }
+    if (write_size != 1) {
+        return ESP_FAIL;
+    }
+    uint8_t reg = write_buf[0];
+    if (reg == 0x8A || reg == 0xE1 || reg == 0x00) {
+        g_calib_reads++;
+    }
+    memcpy(read_buf, &g_registers[reg], read_size);
+    return ESP_OK;
+}
+
+static void put_le16(uint8_t *p, int v)
+{
+    p[0] = v & 0xFF;
+    p[1] = (v >> 8) & 0xFF;
+}
+
+// Trimming laid out as in the part's NVM: 0x8A.., 0xE1.., 0x00..
+static void load_calibration(void)
+{
+    uint8_t c[BME68X_CALIB_LEN] = {0};
+    put_le16(&c[0], 26182);     // T2
+    c[2] = 3;                   // T3
+    put_le16(&c[4], 36013);     // P1
+    put_le16(&c[6], -10386);    // P2
+    c[8] = 88;                  // P3
+    put_le16(&c[10], 7105);     // P4
+    put_le16(&c[12], -134);     // P5
+    c[14] = 20;                 // P7
+    c[15] = 30;                 // P6
+    put_le16(&c[18], -3418);    // P8
+    put_le16(&c[20], -2502);    // P9
+    c[22] = 30;                 // P10
+    c[23] = 1016 >> 4;          // H2 high bits
+    c[24] = (1016 & 0x0F) << 4 | (838 & 0x0F);
+    c[25] = 838 >> 4;           // H1 high bits
+    c[26] = 0;                  // H3
+    c[27] = 45;                 // H4
+    c[28] = 20;                 // H5
+    c[29] = 120;                // H6
+    c[30] = (uint8_t)-100;      // H7
+    put_le16(&c[31], 26041);    // T1
+    put_le16(&c[33], -10306);   // GH2
+    c[35] = (uint8_t)-22;       // GH1
+    c[36] = 18;                 // GH3
+    c[37] = 45;                 // res_heat_val
+    c[39] = 1 << 4;             // res_heat_range
+    c[41] = 0xE0;               // range_sw_err -2, high nibble
+    memcpy(&g_registers[0x8A], &c[0], 23);
+    memcpy(&g_registers[0xE1], &c[23], 14);
+    memcpy(&g_registers[0x00], &c[37], 5);
+}
+
+// One 17-byte data field; gas goes where the variant reports it
+static void put_field(uint8_t reg, bool high, uint8_t status, uint8_t meas_index, uint16_t adc_g, uint8_t range)
+{
+    uint8_t *f = &g_registers[reg];
+    const uint32_t adc_p = 320000;
+    const uint32_t adc_t = 500000;
+    const uint16_t adc_h = 25000;
+    memset(f, 0, 17);
+    f[0] = status;
+    f[1] = meas_index;
+    f[2] = adc_p >> 12;
+    f[3] = (adc_p >> 4) & 0xFF;
+    f[4] = (adc_p & 0x0F) << 4;
+    f[5] = adc_t >> 12;
+    f[6] = (adc_t >> 4) & 0xFF;
+    f[7] = (adc_t & 0x0F) << 4;
+    f[8] = adc_h >> 8;
+    f[9] = adc_h & 0xFF;
+    uint8_t *g = high ? &f[15] : &f[13];
+    g[0] = adc_g >> 2;
+    g[1] = (uint8_t)((adc_g & 0x03) << 6 | 0x20 | 0x10 | range);   // gas valid, heater stable
+}
+
+static bme68x_config_t test_config(bool parallel)
+{
+    bme68x_config_t cfg = {
+        .os_temp = BME68X_OS_X2,
+        .os_pres = BME68X_OS_X4,
+        .os_hum = BME68X_OS_X1,
+        .filter = 2,
+        .heater = {{320, 150}, {200, 100}},
+        .heater_steps = 2,
+        .ambient_c = 25.0f,
+        .parallel = parallel,
+        .shared_heater_ms = 140,
+    };
+    return cfg;
+}
+
+static void test_init(bme68x_t *dev, uint8_t variant, bool parallel, const bme68x_calib_t *calib)
+{
+    memset(g_registers, 0, sizeof(g_registers));
+    g_calib_reads = 0;
+    g_writes = 0;
+    g_registers[0xD0] = 0x61;   // CHIP_ID
+    g_registers[0xF0] = variant;
+    load_calibration();
+    *dev = (bme68x_t){.i2c_dev = FAKE_I2C_DEV};
+    bme68x_config_t cfg = test_config(parallel);
+    TEST_ASSERT_EQUAL(ESP_OK, bme68x_init(dev, &cfg, calib));
+}
+
+static void test_deinit(bme68x_t *dev)
+{
+    FAKE_I2C_DETACH(dev);
+    TEST_ASSERT_EQUAL(ESP_OK, bme68x_deinit(dev));
+}
+
+TEST_CASE("bme68x init programs oversampling and the gas channel", "[bme68x]")
+{
+    bme68x_t dev;
+    test_init(&dev, BME68X_VARIANT_GAS_LOW, false, NULL);
+    TEST_ASSERT_EQUAL_HEX8(0xB6, g_registers[0xE0]);
+    TEST_ASSERT_EQUAL_HEX8(0x01, g_registers[0x72]);                  // humidity x1
+    TEST_ASSERT_EQUAL_HEX8(2 << 5 | 3 << 2, g_registers[0x74]);       // temp x2, pressure x4, asleep
+    TEST_ASSERT_EQUAL_HEX8(2 << 2, g_registers[0x75]);                // filter
+    TEST_ASSERT_EQUAL_HEX8(0x10, g_registers[0x71]);                  // run_gas, BME680 bit
+    TEST_ASSERT_EQUAL_HEX8(0x00, g_registers[0x70]);                  // heater on
+    TEST_ASSERT_EQUAL(3, g_calib_reads);
+    test_deinit(&dev);
+}
+
+TEST_CASE("bme68x init skips the calibration read when handed one", "[bme68x]")
+{
+    bme68x_t dev;
+    test_init(&dev, BME68X_VARIANT_GAS_LOW, false, NULL);
+    bme68x_calib_t calib;
+    bme68x_get_calib(&dev, &calib);
+    bme68x_coeffs_t read_coeffs = dev.coeffs;
+    test_deinit(&dev);
+
+    test_init(&dev, BME68X_VARIANT_GAS_LOW, false, &calib);
+    TEST_ASSERT_EQUAL(0, g_calib_reads);
+    TEST_ASSERT_EQUAL_MEMORY(&read_coeffs, &dev.coeffs, sizeof(read_coeffs));
+    TEST_ASSERT_EQUAL(838, dev.coeffs.h1);
+    TEST_ASSERT_EQUAL(1016, dev.coeffs.h2);
+    TEST_ASSERT_EQUAL(-2, dev.coeffs.range_sw_err);
+    test_deinit(&dev);
+}
+
+TEST_CASE("bme68x init rejects another chip", "[bme68x]")
+{
+    bme68x_t dev;
+    test_init(&dev, BME68X_VARIANT_GAS_LOW, false, NULL);
+    test_deinit(&dev);
+    g_registers[0xD0] = 0x60;
+    dev.i2c_dev = FAKE_I2C_DEV;
+    bme68x_config_t cfg = test_config(false);
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_FOUND, bme68x_init(&dev, &cfg, NULL));
+    TEST_ASSERT_FALSE(dev.initialized);
+}
+
+TEST_CASE("bme68x forced mode steps through the heater profile", "[bme68x]")
+{
+    bme68x_t dev;
+    test_init(&dev, BME68X_VARIANT_GAS_LOW, false, NULL);
+    TEST_ASSERT_FALSE(dev.parallel);
+    // Conversion 7 cycles and switching, plus the longest heater step
+    TEST_ASSERT_EQUAL(170, bme68x_measurement_ms(&dev));
+
+    TEST_ASSERT_EQUAL(ESP_OK, bme68x_start(&dev));
+    TEST_ASSERT_EQUAL_HEX8(2 << 5 | 3 << 2 | 0x01, g_registers[0x74]);
+    TEST_ASSERT_EQUAL_HEX8(118, g_registers[0x5A]);                   // 320 °C at 25 °C ambient
+    TEST_ASSERT_EQUAL_HEX8(0x40 | 37, g_registers[0x64]);             // 150 ms = 37 x 4
+
+    bme68x_sample_t sample;
+    size_t count = 0;
+    put_field(0x1D, false, 0x00, 0, 600, 5);
+    TEST_ASSERT_EQUAL(ESP_OK, bme68x_read(&dev, &sample, 1, &count));
+    TEST_ASSERT_EQUAL(0, count);                                      // not done yet
+
+    put_field(0x1D, false, 0x80, 0, 600, 5);
+    TEST_ASSERT_EQUAL(ESP_OK, bme68x_read(&dev, &sample, 1, &count));
+    TEST_ASSERT_EQUAL(1, count);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 26.0166f, sample.temperature_c);
+    TEST_ASSERT_FLOAT_WITHIN(2.0f, 106562.0f, sample.pressure_pa);
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 63.157f, sample.humidity_rh);
+    TEST_ASSERT_TRUE(sample.gas_valid && sample.heat_stable);
+    TEST_ASSERT_FLOAT_WITHIN(50.0f, 232709.3f, sample.gas_ohm);
+    TEST_ASSERT_EQUAL(0, sample.gas_index);
+
+    TEST_ASSERT_EQUAL(ESP_OK, bme68x_start(&dev));
+    TEST_ASSERT_EQUAL_HEX8(100 / 4 | 0x40, g_registers[0x64]);        // second step, 100 ms
+    put_field(0x1D, false, 0x80, 0, 600, 5);
+    TEST_ASSERT_EQUAL(ESP_OK, bme68x_read(&dev, &sample, 1, &count));
+    TEST_ASSERT_EQUAL(1, sample.gas_index);
+    test_deinit(&dev);
+}
+
+TEST_CASE("bme68x parallel mode returns new fields oldest first", "[bme68x]")
+{
+    bme68x_t dev;
+    test_init(&dev, BME68X_VARIANT_GAS_HIGH, true, NULL);
+    TEST_ASSERT_TRUE(dev.parallel);
+    TEST_ASSERT_EQUAL(0, bme68x_measurement_ms(&dev));
+    TEST_ASSERT_EQUAL_HEX8(0x20 | 2, g_registers[0x71]);              // run_gas (BME688 bit), two steps
+    TEST_ASSERT_EQUAL_HEX8(150, g_registers[0x64]);                   // duration multipliers as given
+    TEST_ASSERT_EQUAL_HEX8(100, g_registers[0x65]);
+    TEST_ASSERT_EQUAL_HEX8(0x80 | 18, g_registers[0x6E]);             // 140 ms = 293 ticks of 477 µs, / 16
+
+    TEST_ASSERT_EQUAL(ESP_OK, bme68x_start(&dev));
+    TEST_ASSERT_EQUAL_HEX8(2 << 5 | 3 << 2 | 0x02, g_registers[0x74]);
+    int writes = g_writes;
+    TEST_ASSERT_EQUAL(ESP_OK, bme68x_start(&dev));
+    TEST_ASSERT_EQUAL(writes, g_writes);                              // already running
+
+    put_field(0x1D, true, 0x80 | 1, 7, 600, 5);
+    put_field(0x2E, true, 0x80 | 0, 6, 600, 5);
+    put_field(0x3F, true, 0x00, 0, 0, 0);
+    bme68x_sample_t samples[BME68X_FIELD_COUNT];
+    size_t count = 0;
+    TEST_ASSERT_EQUAL(ESP_OK, bme68x_read(&dev, samples, BME68X_FIELD_COUNT, &count));
+    TEST_ASSERT_EQUAL(2, count);
+    TEST_ASSERT_EQUAL(0, samples[0].gas_index);
+    TEST_ASSERT_EQUAL(1, samples[1].gas_index);
+    TEST_ASSERT_FLOAT_WITHIN(100.0f, 1878899.0f, samples[1].gas_ohm);
+
+    // Fields already returned stay out; the next one wraps the index
+    put_field(0x3F, true, 0x80 | 0, 8, 600, 5);
+    TEST_ASSERT_EQUAL(ESP_OK, bme68x_read(&dev, samples, BME68X_FIELD_COUNT, &count));
+    TEST_ASSERT_EQUAL(1, count);
+    TEST_ASSERT_EQUAL(0, samples[0].gas_index);
+    test_deinit(&dev);
+}
+
+TEST_CASE("bme68x BME680 falls back to forced mode", "[bme68x]")
+{
+    bme68x_t dev;
+    test_init(&dev, BME68X_VARIANT_GAS_LOW, true, NULL);
+    TEST_ASSERT_FALSE(dev.parallel);
+    TEST_ASSERT_EQUAL_HEX8(0x10, g_registers[0x71]);
+    test_deinit(&dev);
+}
@@ -0,0 +1,152 @@
+#include "unity.h"
+#include "bmp581.h"
+#include "fake_i2c_dev.h"
+
+#include <string.h>
+
+static uint8_t g_registers[128];
+static uint8_t g_fifo[BMP581_FIFO_CAPACITY * BMP581_FIFO_FRAME_BYTES];
+static size_t g_fifo_len;
+static size_t g_fifo_bytes_read;
+static int g_fifo_bursts;
+
+esp_err_t bmp581_i2c_transfer(i2c_master_dev_handle_t i2c_dev,
+                              const uint8_t *write_buf,
+                              size_t write_size,
+                              uint8_t *read_buf,
+                              size_t read_size,
+                              int timeout_ms)
+{
+    (void)i2c_dev;
+    (void)timeout_ms;
+    uint8_t reg = write_buf[0];
+    if (read_size == 0 && write_size == 2) {
+        g_registers[reg] = write_buf[1];
+        return ESP_OK;
+    }
+    if (write_size != 1) {
+        return ESP_FAIL;
+    }
+    if (reg == 0x29) {
+        // FIFO_DATA pops frames instead of auto-incrementing
+        g_fifo_bursts++;
+        for (size_t i = 0; i < read_size; ++i) {
+            read_buf[i] = g_fifo_bytes_read < g_fifo_len ? g_fifo[g_fifo_bytes_read++] : 0x7F;
+        }
+        return ESP_OK;
+    }
+    memcpy(read_buf, &g_registers[reg], read_size);
+    return ESP_OK;
+}
+
+static void push_frame(int32_t raw_t, uint32_t raw_p)
+{
+    uint8_t *f = &g_fifo[g_fifo_len];
+    f[0] = raw_t & 0xFF;
+    f[1] = (raw_t >> 8) & 0xFF;
+    f[2] = (raw_t >> 16) & 0xFF;
+    f[3] = raw_p & 0xFF;
+    f[4] = (raw_p >> 8) & 0xFF;
+    f[5] = (raw_p >> 16) & 0xFF;
+    g_fifo_len += BMP581_FIFO_FRAME_BYTES;
+    g_registers[0x17] = g_fifo_len / BMP581_FIFO_FRAME_BYTES;
+}
+
+static void test_init(bmp581_t *dev)
+{
+    memset(g_registers, 0, sizeof(g_registers));
+    g_fifo_len = 0;
+    g_fifo_bytes_read = 0;
+    g_fifo_bursts = 0;
+    g_registers[0x01] = 0x50;   // CHIP_ID
+    g_registers[0x27] = 0x10;   // INT_STATUS: power-on reset done
+    g_registers[0x28] = 0x02;   // STATUS: NVM ready
+    *dev = (bmp581_t){.i2c_dev = FAKE_I2C_DEV};
+    bmp581_config_t cfg = {
+        .odr = BMP581_ODR_25_HZ,
+        .osr_pressure = BMP581_OSR_X8,
+        .osr_temperature = BMP581_OSR_X1,
+        .fifo_threshold = 12,
+    };
+    TEST_ASSERT_EQUAL(ESP_OK, bmp581_init(dev, &cfg));
+}
+
+static void test_deinit(bmp581_t *dev)
+{
+    FAKE_I2C_DETACH(dev);
+    TEST_ASSERT_EQUAL(ESP_OK, bmp581_deinit(dev));
+}
+
+TEST_CASE("bmp581 init configures the FIFO and normal mode", "[bmp581]")
+{
+    bmp581_t dev;
+    test_init(&dev);
+    TEST_ASSERT_EQUAL_HEX8(0xB6, g_registers[0x7E]);
+    TEST_ASSERT_EQUAL_HEX8(0x03, g_registers[0x18]);                  // pressure and temperature frames
+    TEST_ASSERT_EQUAL_HEX8(12, g_registers[0x16]);                    // threshold, streaming
+    TEST_ASSERT_EQUAL_HEX8((3 << 3) | (1 << 6), g_registers[0x36]);   // osr_p x8, press_en
+    TEST_ASSERT_EQUAL_HEX8((0x14 << 2) | 0x80 | 0x01, g_registers[0x37]);
+    test_deinit(&dev);
+}
+
+TEST_CASE("bmp581 init rejects another chip", "[bmp581]")
+{
+    bmp581_t dev;
+    test_init(&dev);
+    test_deinit(&dev);
+    g_registers[0x01] = 0x58;
+    dev.i2c_dev = FAKE_I2C_DEV;
+    bmp581_config_t cfg = {.odr = BMP581_ODR_10_HZ, .fifo_threshold = 8};
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_FOUND, bmp581_init(&dev, &cfg));
+    TEST_ASSERT_FALSE(dev.initialized);
+}
+
+TEST_CASE("bmp581 drains the FIFO in one burst", "[bmp581]")
+{
+    bmp581_t dev;
+    test_init(&dev);
+    push_frame(25 * 65536, 101325 * 64);
+    push_frame(-5 * 65536, 100000 * 64 + 32);
+    push_frame(21 * 65536 + 32768, 98765 * 64);
+
+    bmp581_sample_t samples[BMP581_FIFO_CAPACITY];
+    size_t count = 0;
+    TEST_ASSERT_EQUAL(ESP_OK, bmp581_read_fifo(&dev, samples, BMP581_FIFO_CAPACITY, &count));
+    TEST_ASSERT_EQUAL(3, count);
+    TEST_ASSERT_EQUAL(1, g_fifo_bursts);
+    TEST_ASSERT_EQUAL_FLOAT(25.0f, samples[0].temperature_c);
+    TEST_ASSERT_EQUAL_FLOAT(101325.0f, samples[0].pressure_pa);
+    TEST_ASSERT_EQUAL_FLOAT(-5.0f, samples[1].temperature_c);
+    TEST_ASSERT_EQUAL_FLOAT(100000.5f, samples[1].pressure_pa);
+    TEST_ASSERT_EQUAL_FLOAT(21.5f, samples[2].temperature_c);
+    test_deinit(&dev);
+}
+
+TEST_CASE("bmp581 leaves frames beyond the buffer queued", "[bmp581]")
+{
+    bmp581_t dev;
+    test_init(&dev);
+    for (int i = 0; i < 5; ++i) {
+        push_frame(20 * 65536, (100000 + i) * 64);
+    }
+
+    bmp581_sample_t samples[2];
+    size_t count = 0;
+    TEST_ASSERT_EQUAL(ESP_OK, bmp581_read_fifo(&dev, samples, 2, &count));
+    TEST_ASSERT_EQUAL(2, count);
+    TEST_ASSERT_EQUAL(2 * BMP581_FIFO_FRAME_BYTES, g_fifo_bytes_read);
+    TEST_ASSERT_EQUAL_FLOAT(100001.0f, samples[1].pressure_pa);
+    test_deinit(&dev);
+}
+
+TEST_CASE("bmp581 interrupt is latched, active high", "[bmp581]")
+{
+    bmp581_t dev;
+    test_init(&dev);
+    TEST_ASSERT_EQUAL(ESP_OK, bmp581_enable_interrupt(&dev, BMP581_INT_FIFO_THRESHOLD));
+    TEST_ASSERT_EQUAL_HEX8(BMP581_INT_FIFO_THRESHOLD, g_registers[0x15]);
+    TEST_ASSERT_EQUAL_HEX8(0x0B, g_registers[0x14]);
+    TEST_ASSERT_EQUAL(ESP_OK, bmp581_enable_interrupt(&dev, 0));
+    TEST_ASSERT_EQUAL_HEX8(0x03, g_registers[0x14]);
+    test_deinit(&dev);
+}
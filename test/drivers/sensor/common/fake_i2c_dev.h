@@ -0,0 +1,13 @@
+#pragma once
+
+#include "driver/i2c_master.h"
+
+/*
+ * For driver tests that override the driver's weak *_i2c_transfer() hook.
+ * The hook answers every transfer, so the device handle is never used and
+ * only has to be non-NULL for init to accept it.
+ */
+#define FAKE_I2C_DEV ((i2c_master_dev_handle_t)0x1)
+
+// Deinit removes a non-NULL handle from its bus, which the fake never joined
+#define FAKE_I2C_DETACH(dev) ((dev)->i2c_dev = NULL)
@@ -0,0 +1,170 @@
+#include "unity.h"
+#include "i2c_scheduler.h"
+
+#include "esp_timer.h"
+#include "driver/gpio.h"
+
+// Jobs below never touch the bus, so no devices need to be attached
+#define TEST_SDA GPIO_NUM_1
+#define TEST_SCL GPIO_NUM_2
+
+typedef struct {
+    int64_t started_us;
+    int64_t collected_us;
+    int start_calls;
+    int collect_calls;
+    esp_err_t start_result;
+} test_job_state_t;
+
+static esp_err_t test_start(i2c_scheduler_dev_t *dev, void *ctx)
+{
+    (void)dev;
+    test_job_state_t *state = ctx;
+    state->started_us = esp_timer_get_time();
+    state->start_calls++;
+    return state->start_result;
+}
+
+static esp_err_t test_collect(i2c_scheduler_dev_t *dev, void *ctx)
+{
+    (void)dev;
+    test_job_state_t *state = ctx;
+    state->collected_us = esp_timer_get_time();
+    state->collect_calls++;
+    return ESP_OK;
+}
+
+static i2c_scheduler_t *test_new_scheduler(void)
+{
+    i2c_scheduler_config_t cfg = {
+        .port = 0,
+        .sda_io_num = TEST_SDA,
+        .scl_io_num = TEST_SCL,
+        .scl_speed_hz = 100000,
+        .enable_internal_pullup = true,
+    };
+    i2c_scheduler_t *sched = NULL;
+    TEST_ASSERT_EQUAL(ESP_OK, i2c_scheduler_new(&cfg, &sched));
+    TEST_ASSERT_NOT_NULL(sched);
+    return sched;
+}
+
+TEST_CASE("i2c scheduler invalid args", "[i2c_scheduler]")
+{
+    i2c_scheduler_t *sched = NULL;
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, i2c_scheduler_new(NULL, &sched));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, i2c_scheduler_sweep(NULL, NULL));
+
+    sched = test_new_scheduler();
+    i2c_scheduler_job_t job = {.name = "no_collect", .address = 0x10};
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, i2c_scheduler_add_job(sched, &job, NULL));
+    i2c_scheduler_delete(sched);
+}
+
+TEST_CASE("i2c scheduler overlaps conversions", "[i2c_scheduler]")
+{
+    i2c_scheduler_t *sched = test_new_scheduler();
+    static const uint32_t conversion_ms[] = {100, 20, 50};
+    test_job_state_t states[3] = {0};
+    i2c_scheduler_dev_t *devs[3] = {0};
+
+    for (int i = 0; i < 3; ++i) {
+        i2c_scheduler_job_t job = {
+            .name = "test",
+            .address = (uint16_t)(0x10 + i),
+            .conversion_ms = conversion_ms[i],
+            .start = test_start,
+            .collect = test_collect,
+            .ctx = &states[i],
+        };
+        TEST_ASSERT_EQUAL(ESP_OK, i2c_scheduler_add_job(sched, &job, &devs[i]));
+        TEST_ASSERT_EQUAL(ESP_ERR_NOT_FINISHED, i2c_scheduler_dev_result(devs[i]));
+    }
+
+    uint32_t elapsed_ms = 0;
+    TEST_ASSERT_EQUAL(ESP_OK, i2c_scheduler_sweep(sched, &elapsed_ms));
+
+    // About the longest conversion, well short of the 170 ms sum
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(100, elapsed_ms);
+    TEST_ASSERT_LESS_THAN_UINT32(150, elapsed_ms);
+
+    for (int i = 0; i < 3; ++i) {
+        TEST_ASSERT_EQUAL(1, states[i].collect_calls);
+        TEST_ASSERT_GREATER_OR_EQUAL_INT64((int64_t)conversion_ms[i] * 1000,
+                                           states[i].collected_us - states[i].started_us);
+        TEST_ASSERT_EQUAL(ESP_OK, i2c_scheduler_dev_result(devs[i]));
+    }
+    // Collected in deadline order
+    TEST_ASSERT_TRUE(states[1].collected_us < states[2].collected_us);
+    TEST_ASSERT_TRUE(states[2].collected_us < states[0].collected_us);
+
+    i2c_scheduler_delete(sched);
+}
+
+TEST_CASE("i2c scheduler skips failed starts and honours periods", "[i2c_scheduler]")
+{
+    i2c_scheduler_t *sched = test_new_scheduler();
+    test_job_state_t failing = {.start_result = ESP_FAIL};
+    test_job_state_t periodic = {0};
+    i2c_scheduler_dev_t *failing_dev = NULL;
+    i2c_scheduler_dev_t *periodic_dev = NULL;
+
+    i2c_scheduler_job_t job = {
+        .name = "failing",
+        .address = 0x20,
+        .conversion_ms = 10,
+        .start = test_start,
+        .collect = test_collect,
+        .ctx = &failing,
+    };
+    TEST_ASSERT_EQUAL(ESP_OK, i2c_scheduler_add_job(sched, &job, &failing_dev));
+    job = (i2c_scheduler_job_t){
+        .name = "periodic",
+        .address = 0x21,
+        .period_ms = 60000,
+        .collect = test_collect,
+        .ctx = &periodic,
+    };
+    TEST_ASSERT_EQUAL(ESP_OK, i2c_scheduler_add_job(sched, &job, &periodic_dev));
+
+    TEST_ASSERT_EQUAL(ESP_OK, i2c_scheduler_sweep(sched, NULL));
+    TEST_ASSERT_EQUAL(ESP_OK, i2c_scheduler_sweep(sched, NULL));
+
+    TEST_ASSERT_EQUAL(2, failing.start_calls);
+    TEST_ASSERT_EQUAL(0, failing.collect_calls);
+    TEST_ASSERT_EQUAL(ESP_FAIL, i2c_scheduler_dev_result(failing_dev));
+    TEST_ASSERT_EQUAL(1, periodic.collect_calls);
+    TEST_ASSERT_EQUAL(ESP_OK, i2c_scheduler_dev_result(periodic_dev));
+
+    i2c_scheduler_delete(sched);
+}
+
+TEST_CASE("i2c scheduler runs jobs on a caller's device", "[i2c_scheduler]")
+{
+    i2c_scheduler_t *sched = test_new_scheduler();
+    TEST_ASSERT_NOT_NULL(i2c_scheduler_bus(sched));
+
+    i2c_device_config_t dev_config = {
+        .dev_addr_length = I2C_ADDR_BIT_LEN_7,
+        .device_address = 0x30,
+        .scl_speed_hz = 100000,
+    };
+    i2c_master_dev_handle_t handle = NULL;
+    TEST_ASSERT_EQUAL(ESP_OK, i2c_master_bus_add_device(i2c_scheduler_bus(sched), &dev_config, &handle));
+
+    test_job_state_t state = {0};
+    i2c_scheduler_job_t job = {
+        .name = "external",
+        .address = 0x30,
+        .device = handle,
+        .collect = test_collect,
+        .ctx = &state,
+    };
+    TEST_ASSERT_EQUAL(ESP_OK, i2c_scheduler_add_job(sched, &job, NULL));
+    TEST_ASSERT_EQUAL(ESP_OK, i2c_scheduler_sweep(sched, NULL));
+    TEST_ASSERT_EQUAL(1, state.collect_calls);
+
+    // Still the caller's to remove
+    TEST_ASSERT_EQUAL(ESP_OK, i2c_master_bus_rm_device(handle));
+    i2c_scheduler_delete(sched);
+}
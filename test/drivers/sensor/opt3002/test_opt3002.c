@@ -0,0 +1,113 @@
+#include "unity.h"
+#include "opt3002.h"
+#include "fake_i2c_dev.h"
+
+#include <string.h>
+
+static uint16_t g_registers[256];
+
+esp_err_t opt3002_i2c_transfer(i2c_master_dev_handle_t i2c_dev,
+                               const uint8_t *write_buf,
+                               size_t write_size,
+                               uint8_t *read_buf,
+                               size_t read_size,
+                               int timeout_ms)
+{
+    (void)i2c_dev;
+    (void)timeout_ms;
+    // Words are big-endian on the wire
+    if (read_size == 0 && write_size == 3) {
+        g_registers[write_buf[0]] = ((uint16_t)write_buf[1] << 8) | write_buf[2];
+        return ESP_OK;
+    }
+    if (read_size == 2 && write_size == 1) {
+        uint16_t value = g_registers[write_buf[0]];
+        read_buf[0] = value >> 8;
+        read_buf[1] = value & 0xFF;
+        return ESP_OK;
+    }
+    return ESP_FAIL;
+}
+
+static void test_init(opt3002_t *dev)
+{
+    memset(g_registers, 0, sizeof(g_registers));
+    g_registers[0x7E] = 0x5449;
+    *dev = (opt3002_t){.i2c_dev = FAKE_I2C_DEV};
+    opt3002_config_t cfg = {
+        .conversion_time = OPT3002_CONVERSION_800MS,
+        .fault_count = 2,
+    };
+    TEST_ASSERT_EQUAL(ESP_OK, opt3002_init(dev, &cfg));
+}
+
+static void test_deinit(opt3002_t *dev)
+{
+    FAKE_I2C_DETACH(dev);
+    TEST_ASSERT_EQUAL(ESP_OK, opt3002_deinit(dev));
+}
+
+TEST_CASE("opt3002 init selects auto range, continuous, latched", "[opt3002]")
+{
+    opt3002_t dev;
+    test_init(&dev);
+    // RN=1100, CT=1, M=10, L=1, POL=0, FC=01
+    TEST_ASSERT_EQUAL_HEX16(0xCC11, g_registers[0x01]);
+    TEST_ASSERT_EQUAL_HEX16(0x0000, g_registers[0x02]);
+    TEST_ASSERT_EQUAL_HEX16(0xBFFF, g_registers[0x03]);
+    test_deinit(&dev);
+}
+
+TEST_CASE("opt3002 rejects another part", "[opt3002]")
+{
+    opt3002_t dev = {.i2c_dev = FAKE_I2C_DEV};
+    memset(g_registers, 0, sizeof(g_registers));
+    g_registers[0x7E] = 0x1234;
+    opt3002_config_t cfg = {.fault_count = 1};
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_FOUND, opt3002_init(&dev, &cfg));
+    TEST_ASSERT_FALSE(dev.initialized);
+}
+
+TEST_CASE("opt3002 decodes exponent and mantissa", "[opt3002]")
+{
+    opt3002_t dev;
+    test_init(&dev);
+    float power = 0.0f;
+
+    g_registers[0x00] = 0x0001;   // one LSB at the finest range
+    TEST_ASSERT_EQUAL(ESP_OK, opt3002_read_power(&dev, &power));
+    TEST_ASSERT_EQUAL_FLOAT(1.2f, power);
+
+    g_registers[0x00] = 0x3100;   // 256 x 2^3 x 1.2
+    TEST_ASSERT_EQUAL(ESP_OK, opt3002_read_power(&dev, &power));
+    TEST_ASSERT_EQUAL_FLOAT(2457.6f, power);
+    test_deinit(&dev);
+}
+
+TEST_CASE("opt3002 window rounds outward", "[opt3002]")
+{
+    opt3002_t dev;
+    test_init(&dev);
+    // 100 nW/cm² is 83.3 LSB: low floors to 83, high ceils to 84
+    TEST_ASSERT_EQUAL(ESP_OK, opt3002_set_window(&dev, 100.0f, 100.0f));
+    TEST_ASSERT_EQUAL_HEX16(0x0053, g_registers[0x02]);
+    TEST_ASSERT_EQUAL_HEX16(0x0054, g_registers[0x03]);
+
+    // 10000 nW/cm² needs E=2: 10000 / 4.8 = 2083.3
+    TEST_ASSERT_EQUAL(ESP_OK, opt3002_set_window(&dev, 0.0f, 10000.0f));
+    TEST_ASSERT_EQUAL_HEX16(0x0000, g_registers[0x02]);
+    TEST_ASSERT_EQUAL_HEX16(0x2824, g_registers[0x03]);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, opt3002_set_window(&dev, 5.0f, 1.0f));
+    test_deinit(&dev);
+}
+
+TEST_CASE("opt3002 flags come from the config register", "[opt3002]")
+{
+    opt3002_t dev;
+    test_init(&dev);
+    uint8_t flags = 0;
+    g_registers[0x01] |= (1 << 6) | (1 << 7);
+    TEST_ASSERT_EQUAL(ESP_OK, opt3002_read_flags(&dev, &flags));
+    TEST_ASSERT_EQUAL_HEX8(OPT3002_FLAG_HIGH | OPT3002_FLAG_READY, flags);
+    test_deinit(&dev);
+}
@@ -0,0 +1,65 @@
+#include "unity.h"
+#include "sensirion_common.h"
+
+#include <string.h>
+
+// Bit-at-a-time CRC the drivers carried before the table
+static uint8_t test_crc(const uint8_t *data, size_t len)
+{
+    uint8_t crc = 0xFF;
+    for (size_t i = 0; i < len; ++i) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; ++bit) {
+            if (crc & 0x80) {
+                crc = (crc << 1) ^ 0x31;
+            } else {
+                crc <<= 1;
+            }
+        }
+    }
+    return crc;
+}
+
+TEST_CASE("sensirion crc matches datasheet and bitwise reference", "[sensirion]")
+{
+    const uint8_t example[2] = {0xBE, 0xEF};
+    TEST_ASSERT_EQUAL_HEX8(0x92, sensirion_crc8(example, sizeof(example)));
+
+    for (uint32_t value = 0; value <= 0xFFFF; ++value) {
+        const uint8_t word[2] = {(uint8_t)(value >> 8), (uint8_t)value};
+        TEST_ASSERT_EQUAL_HEX8(test_crc(word, 2), sensirion_crc8(word, 2));
+    }
+}
+
+TEST_CASE("sensirion words pack and unpack", "[sensirion]")
+{
+    const uint16_t words[3] = {0x0000, 0xBEEF, 0xFFFF};
+    uint8_t wire[3 * SENSIRION_WORD_BYTES];
+    uint16_t out[3] = {0};
+
+    sensirion_pack_words(words, 3, wire);
+    TEST_ASSERT_EQUAL_HEX8(0xBE, wire[3]);
+    TEST_ASSERT_EQUAL_HEX8(0xEF, wire[4]);
+    TEST_ASSERT_EQUAL_HEX8(0x92, wire[5]);
+    TEST_ASSERT_EQUAL(ESP_OK, sensirion_unpack_words(wire, 3, out));
+    TEST_ASSERT_EQUAL_HEX16_ARRAY(words, out, 3);
+}
+
+TEST_CASE("sensirion unpack rejects a corrupted word", "[sensirion]")
+{
+    const uint16_t words[2] = {0x1234, 0x5678};
+    uint8_t wire[2 * SENSIRION_WORD_BYTES];
+    uint16_t out[2] = {0};
+
+    sensirion_pack_words(words, 2, wire);
+    wire[4] ^= 0x01;
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_CRC, sensirion_unpack_words(wire, 2, out));
+}
+
+TEST_CASE("sensirion helpers reject a missing device", "[sensirion]")
+{
+    uint16_t word = 0;
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, sensirion_write_cmd(NULL, 0x21B1, 100));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, sensirion_read_words(NULL, &word, 1, 100));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, sensirion_cmd_read_words(NULL, 0xEC05, &word, 1, 100));
+}
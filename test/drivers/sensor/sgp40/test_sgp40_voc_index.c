@@ -0,0 +1,60 @@
+#include "unity.h"
+#include "sgp40_voc_index.h"
+
+// Room-air raw signal with a little sensor noise
+static uint16_t test_sraw(int t, int32_t base)
+{
+    return (uint16_t)(base + ((t * 7919) % 41) - 20);
+}
+
+static void test_run(sgp40_voc_index_t *algo, int seconds, int32_t base, int32_t *last)
+{
+    for (int t = 0; t < seconds; ++t) {
+        *last = sgp40_voc_index_process(algo, test_sraw(t, base));
+    }
+}
+
+TEST_CASE("sgp40 voc index blackout then baseline", "[sgp40]")
+{
+    sgp40_voc_index_t algo;
+    sgp40_voc_index_init(&algo);
+    for (int t = 0; t < SGP40_VOC_INDEX_BLACKOUT_S; ++t) {
+        TEST_ASSERT_EQUAL_INT32(0, sgp40_voc_index_process(&algo, test_sraw(t, 30000)));
+    }
+
+    int32_t index = 0;
+    test_run(&algo, 3600, 30000, &index);
+    TEST_ASSERT_INT32_WITHIN(10, 100, index);
+}
+
+TEST_CASE("sgp40 voc index rises on a voc event", "[sgp40]")
+{
+    sgp40_voc_index_t algo;
+    sgp40_voc_index_init(&algo);
+    int32_t index = 0;
+    test_run(&algo, 3600, 30000, &index);
+
+    // VOCs lower the raw signal
+    test_run(&algo, 120, 28000, &index);
+    TEST_ASSERT_GREATER_THAN_INT32(200, index);
+    TEST_ASSERT_LESS_OR_EQUAL_INT32(500, index);
+}
+
+TEST_CASE("sgp40 voc index state round trip", "[sgp40]")
+{
+    sgp40_voc_index_t algo;
+    sgp40_voc_index_init(&algo);
+    sgp40_voc_index_state_t state;
+    TEST_ASSERT_FALSE(sgp40_voc_index_get_state(&algo, &state));
+
+    int32_t index = 0;
+    test_run(&algo, 4 * 3600, 30000, &index);
+    TEST_ASSERT_TRUE(sgp40_voc_index_get_state(&algo, &state));
+
+    // A restored instance reports the learned baseline right after blackout
+    sgp40_voc_index_t restored;
+    sgp40_voc_index_init(&restored);
+    sgp40_voc_index_set_state(&restored, &state);
+    test_run(&restored, SGP40_VOC_INDEX_BLACKOUT_S + 10, 30000, &index);
+    TEST_ASSERT_INT32_WITHIN(10, 100, index);
+}
@@ -0,0 +1,65 @@
+#include "unity.h"
+#include "sps30.h"
+
+#include <string.h>
+
+static void put_float(uint16_t *words, size_t index, float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    words[index * 2] = (uint16_t)(bits >> 16);
+    words[index * 2 + 1] = (uint16_t)(bits & 0xFFFF);
+}
+
+TEST_CASE("sps30 decodes float output", "[sps30]")
+{
+    const float expected[10] = {1.5f, 2.5f, 3.25f, 4.0f, 10.0f, 12.0f, 13.5f, 14.0f, 14.25f, 0.6f};
+    uint16_t words[20];
+    for (size_t i = 0; i < 10; ++i) {
+        put_float(words, i, expected[i]);
+    }
+
+    sps30_measurement_t m = {0};
+    sps30_decode_measurement(words, SPS30_OUTPUT_FLOAT, &m);
+    TEST_ASSERT_EQUAL_FLOAT(1.5f, m.mc_pm1_0);
+    TEST_ASSERT_EQUAL_FLOAT(2.5f, m.mc_pm2_5);
+    TEST_ASSERT_EQUAL_FLOAT(3.25f, m.mc_pm4_0);
+    TEST_ASSERT_EQUAL_FLOAT(4.0f, m.mc_pm10);
+    TEST_ASSERT_EQUAL_FLOAT(10.0f, m.nc_pm0_5);
+    TEST_ASSERT_EQUAL_FLOAT(14.25f, m.nc_pm10);
+    TEST_ASSERT_EQUAL_FLOAT(0.6f, m.typical_particle_size_um);
+}
+
+TEST_CASE("sps30 decodes integer output", "[sps30]")
+{
+    const uint16_t words[10] = {3, 5, 6, 7, 20, 24, 25, 26, 27, 540};
+
+    sps30_measurement_t m = {0};
+    sps30_decode_measurement(words, SPS30_OUTPUT_UINT16, &m);
+    TEST_ASSERT_EQUAL_FLOAT(3.0f, m.mc_pm1_0);
+    TEST_ASSERT_EQUAL_FLOAT(5.0f, m.mc_pm2_5);
+    TEST_ASSERT_EQUAL_FLOAT(7.0f, m.mc_pm10);
+    TEST_ASSERT_EQUAL_FLOAT(27.0f, m.nc_pm10);
+    // Typical size comes in nm and is reported in µm
+    TEST_ASSERT_EQUAL_FLOAT(0.54f, m.typical_particle_size_um);
+}
+
+TEST_CASE("sps30 rejects an unknown output format", "[sps30]")
+{
+    sps30_t dev = {0};
+    sps30_config_t cfg = {.output_format = (sps30_output_format_t)0x04};
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, sps30_init(&dev, &cfg));
+    TEST_ASSERT_FALSE(dev.initialized);
+}
+
+TEST_CASE("sps30 needs a running measurement to read", "[sps30]")
+{
+    sps30_t dev = {0};
+    sps30_config_t cfg = {.output_format = SPS30_OUTPUT_FLOAT};
+    TEST_ASSERT_EQUAL(ESP_OK, sps30_init(&dev, &cfg));
+
+    sps30_measurement_t m;
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, sps30_read_measurement(&dev, &m));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, sps30_start_fan_cleaning(&dev));
+    TEST_ASSERT_EQUAL(ESP_OK, sps30_deinit(&dev));
+}
@@ -1,78 +1,74 @@
 #include "unity.h"
 #include "vcnl4040.h"
+#include "fake_i2c_dev.h"
 
 #include <string.h>
 #include "freertos/FreeRTOS.h"
-#include "driver/gpio.h"
 
 static uint16_t g_registers[256];
 
-esp_err_t vcnl4040_i2c_transfer(i2c_port_t port,
-                                uint8_t addr,
+esp_err_t vcnl4040_i2c_transfer(i2c_master_dev_handle_t i2c_dev,
                                 const uint8_t *write_buf,
                                 size_t write_size,
                                 uint8_t *read_buf,
                                 size_t read_size,
-                                TickType_t ticks_to_wait)
+                                int timeout_ms)
 {
-    (void)port;
-    (void)addr;
-    (void)ticks_to_wait;
+    (void)i2c_dev;
+    (void)timeout_ms;
+    // Words are little-endian on the wire
     if (read_size == 0 && write_size == 3) {
         uint8_t reg = write_buf[0];
-        uint16_t value = ((uint16_t)write_buf[1] << 8) | write_buf[2];
-        g_registers[reg] = value;
-        return ESP_OK;
-    }
-    if (read_size == 0 && write_size == 2) {
-        uint8_t reg = write_buf[0];
-        uint16_t value = ((uint16_t)write_buf[1] << 8) | 0;
+        uint16_t value = ((uint16_t)write_buf[2] << 8) | write_buf[1];
         g_registers[reg] = value;
         return ESP_OK;
     }
     if (read_size == 2 && write_size == 1) {
         uint8_t reg = write_buf[0];
         uint16_t value = g_registers[reg];
-        read_buf[0] = value >> 8;
-        read_buf[1] = value & 0xFF;
+        read_buf[0] = value & 0xFF;
+        read_buf[1] = value >> 8;
         return ESP_OK;
     }
     return ESP_FAIL;
 }
 
-TEST_CASE("vcnl4040 init configures registers", "[vcnl4040]")
+static void test_init(vcnl4040_t *dev, uint8_t led_current_ma)
 {
     memset(g_registers, 0, sizeof(g_registers));
-    vcnl4040_t dev = {0};
+    *dev = (vcnl4040_t){.i2c_dev = FAKE_I2C_DEV};
     vcnl4040_config_t cfg = {
-        .i2c_port = I2C_NUM_0,
-        .sda_io_num = GPIO_NUM_4,
-        .scl_io_num = GPIO_NUM_5,
-        .i2c_clk_speed_hz = 100000,
-        .led_current_ma = 100,
+        .led_current_ma = led_current_ma,
         .prox_rate = VCNL4040_PROX_RATE_31_3_SPS
     };
-    TEST_ASSERT_EQUAL(ESP_OK, vcnl4040_init(&dev, &cfg));
+    TEST_ASSERT_EQUAL(ESP_OK, vcnl4040_init(dev, &cfg));
+}
+
+static void test_deinit(vcnl4040_t *dev)
+{
+    FAKE_I2C_DETACH(dev);
+    TEST_ASSERT_EQUAL(ESP_OK, vcnl4040_deinit(dev));
+}
+
+TEST_CASE("vcnl4040 init configures registers", "[vcnl4040]")
+{
+    vcnl4040_t dev;
+    test_init(&dev, 100);
     TEST_ASSERT_TRUE(dev.initialized);
     TEST_ASSERT_NOT_EQUAL(0, g_registers[0x00]);
     TEST_ASSERT_NOT_EQUAL(0, g_registers[0x03]);
-    TEST_ASSERT_EQUAL(100 << 8, g_registers[0x05]);
-    TEST_ASSERT_EQUAL(ESP_OK, vcnl4040_deinit(&dev));
+    // ALS_SD and PS_SD clear: both powered
+    TEST_ASSERT_EQUAL(0, g_registers[0x00] & 0x01);
+    TEST_ASSERT_EQUAL(0, g_registers[0x03] & 0x01);
+    // LED_I = 100 mA in the high byte of PS_MS
+    TEST_ASSERT_EQUAL(0x02 << 8, g_registers[0x04]);
+    test_deinit(&dev);
 }
 
 TEST_CASE("vcnl4040 read functions succeed", "[vcnl4040]")
 {
-    memset(g_registers, 0, sizeof(g_registers));
-    vcnl4040_t dev = {0};
-    vcnl4040_config_t cfg = {
-        .i2c_port = I2C_NUM_0,
-        .sda_io_num = GPIO_NUM_4,
-        .scl_io_num = GPIO_NUM_5,
-        .i2c_clk_speed_hz = 100000,
-        .led_current_ma = 20,
-        .prox_rate = VCNL4040_PROX_RATE_31_3_SPS
-    };
-    TEST_ASSERT_EQUAL(ESP_OK, vcnl4040_init(&dev, &cfg));
+    vcnl4040_t dev;
+    test_init(&dev, 20);
 
     g_registers[0x09] = 0x1234;
     g_registers[0x08] = 0xABCD;
@@ -84,5 +80,37 @@ TEST_CASE("vcnl4040 read functions succeed", "[vcnl4040]")
     TEST_ASSERT_EQUAL(ESP_OK, vcnl4040_read_proximity(&dev, &prox));
     TEST_ASSERT_EQUAL_UINT16(0xABCD, prox);
 
-    TEST_ASSERT_EQUAL(ESP_OK, vcnl4040_deinit(&dev));
+    test_deinit(&dev);
+}
+
+TEST_CASE("vcnl4040 thresholds and interrupt flags", "[vcnl4040]")
+{
+    vcnl4040_t dev;
+    test_init(&dev, 100);
+
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, vcnl4040_set_als_thresholds(&dev, 200, 100));
+    TEST_ASSERT_EQUAL(ESP_OK, vcnl4040_set_als_thresholds(&dev, 100, 200));
+    TEST_ASSERT_EQUAL(ESP_OK, vcnl4040_set_ps_thresholds(&dev, 120, 300));
+    TEST_ASSERT_EQUAL_UINT16(100, g_registers[0x02]);
+    TEST_ASSERT_EQUAL_UINT16(200, g_registers[0x01]);
+    TEST_ASSERT_EQUAL_UINT16(120, g_registers[0x06]);
+    TEST_ASSERT_EQUAL_UINT16(300, g_registers[0x07]);
+
+    uint16_t ps_conf = g_registers[0x03];
+    TEST_ASSERT_EQUAL(ESP_OK, vcnl4040_enable_interrupts(&dev, true, true));
+    TEST_ASSERT_EQUAL(0x02, g_registers[0x00] & 0x02);
+    TEST_ASSERT_EQUAL(0x0300, g_registers[0x03] & 0x0300);
+    // The rest of PS_CONF1 is untouched
+    TEST_ASSERT_EQUAL(ps_conf & 0xFF, g_registers[0x03] & 0xFF);
+
+    g_registers[0x0B] = (VCNL4040_INT_PS_CLOSE | VCNL4040_INT_ALS_HIGH) << 8;
+    uint8_t flags = 0;
+    TEST_ASSERT_EQUAL(ESP_OK, vcnl4040_read_int_flags(&dev, &flags));
+    TEST_ASSERT_EQUAL_HEX8(VCNL4040_INT_PS_CLOSE | VCNL4040_INT_ALS_HIGH, flags);
+
+    TEST_ASSERT_EQUAL(ESP_OK, vcnl4040_enable_interrupts(&dev, false, false));
+    TEST_ASSERT_EQUAL(0, g_registers[0x00] & 0x02);
+    TEST_ASSERT_EQUAL(0, g_registers[0x03] & 0x0300);
+
+    test_deinit(&dev);
 }
@@ -0,0 +1,477 @@
+#include "unity.h"
+#include "i2c_scheduler.h"
+#include "sht45.h"
+#include "sgp40.h"
+#include "scd40.h"
+#include "vcnl4040.h"
+#include "ec10.h"
+#include "korvo1.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "driver/gpio.h"
+
+// Timing on a real board, against real sensors. Every result is one line
+//   TIMING {"name":"sht45.read","unit":"us","n":32,"median":..,"p90":..,"max":..}
+// that scripts/driver_timing.py collects and compares with a stored baseline.
+// A sensor that does not answer skips its case rather than failing it.
+//
+// Needs the real bus and I2S transfers, which the functional tests replace,
+// so it is built on its own (DRIVER_TIMING_HIL in test/drivers/CMakeLists.txt).
+// Pins are the Naphome board's; override with -D for another.
+
+#ifndef TIMING_I2C_PORT
+#define TIMING_I2C_PORT 0
+#endif
+#ifndef TIMING_I2C_SDA
+#define TIMING_I2C_SDA GPIO_NUM_44
+#endif
+#ifndef TIMING_I2C_SCL
+#define TIMING_I2C_SCL GPIO_NUM_43
+#endif
+#ifndef TIMING_I2C_HZ
+#define TIMING_I2C_HZ 100000
+#endif
+#ifndef TIMING_EC10_UART
+#define TIMING_EC10_UART 1
+#endif
+#ifndef TIMING_EC10_TX
+#define TIMING_EC10_TX GPIO_NUM_17
+#endif
+#ifndef TIMING_EC10_RX
+#define TIMING_EC10_RX GPIO_NUM_18
+#endif
+
+#define TIMING_SAMPLES 32
+#define TIMING_SWEEPS 20
+#define TIMING_I2S_FRAMES 256          // One DMA buffer, 16 ms at 16 kHz
+#define TIMING_I2S_READS 250
+
+typedef struct {
+    int64_t samples[TIMING_I2S_READS];
+    size_t count;
+} timing_series_t;
+
+static int compare_i64(const void *a, const void *b)
+{
+    int64_t x = *(const int64_t *)a;
+    int64_t y = *(const int64_t *)b;
+    return (x > y) - (x < y);
+}
+
+static void series_add(timing_series_t *series, int64_t value)
+{
+    if (series->count < TIMING_I2S_READS) {
+        series->samples[series->count++] = value;
+    }
+}
+
+// Sorts the samples; median, p90 and max are what the baseline compares
+static void series_report(const char *name, const char *unit, timing_series_t *series)
+{
+    TEST_ASSERT_TRUE_MESSAGE(series->count > 0, name);
+    qsort(series->samples, series->count, sizeof(series->samples[0]), compare_i64);
+    size_t n = series->count;
+    printf("TIMING {\"name\":\"%s\",\"unit\":\"%s\",\"n\":%u,\"median\":%lld,\"p90\":%lld,\"max\":%lld}\n", name, unit,
+           (unsigned)n, (long long)series->samples[n / 2], (long long)series->samples[(n * 9) / 10],
+           (long long)series->samples[n - 1]);
+}
+
+static void report_value(const char *name, const char *unit, int64_t value)
+{
+    printf("TIMING {\"name\":\"%s\",\"unit\":\"%s\",\"n\":1,\"median\":%lld,\"p90\":%lld,\"max\":%lld}\n", name, unit,
+           (long long)value, (long long)value, (long long)value);
+}
+
+static i2c_scheduler_t *timing_new_scheduler(void)
+{
+    i2c_scheduler_config_t cfg = {
+        .port = TIMING_I2C_PORT,
+        .sda_io_num = TIMING_I2C_SDA,
+        .scl_io_num = TIMING_I2C_SCL,
+        .scl_speed_hz = TIMING_I2C_HZ,
+        .enable_internal_pullup = true,
+    };
+    i2c_scheduler_t *sched = NULL;
+    TEST_ASSERT_EQUAL(ESP_OK, i2c_scheduler_new(&cfg, &sched));
+    return sched;
+}
+
+// Adds the device for a driver that expects it attached before init; false when the sensor is absent
+static bool timing_attach(i2c_scheduler_t *sched, uint16_t address, i2c_master_dev_handle_t *ret_dev)
+{
+    if (i2c_scheduler_probe(sched, address) != ESP_OK) {
+        return false;
+    }
+    i2c_device_config_t dev_config = {
+        .dev_addr_length = I2C_ADDR_BIT_LEN_7,
+        .device_address = address,
+        .scl_speed_hz = TIMING_I2C_HZ,
+    };
+    return i2c_master_bus_add_device(i2c_scheduler_bus(sched), &dev_config, ret_dev) == ESP_OK;
+}
+
+// After a failed init, which leaves the device on the bus
+static void timing_detach(i2c_master_dev_handle_t *dev)
+{
+    if (*dev) {
+        i2c_master_bus_rm_device(*dev);
+        *dev = NULL;
+    }
+}
+
+TEST_CASE("sht45 transaction latency", "[timing][hil]")
+{
+    i2c_scheduler_t *sched = timing_new_scheduler();
+    sht45_handle_t sht45 = {0};
+    if (i2c_scheduler_probe(sched, 0x44) != ESP_OK || !sht45_init(&sht45, i2c_scheduler_bus(sched), 0x44)) {
+        i2c_scheduler_delete(sched);
+        TEST_IGNORE_MESSAGE("no SHT45");
+    }
+    static timing_series_t start;
+    static timing_series_t collect;
+    start.count = collect.count = 0;
+    for (int i = 0; i < TIMING_SAMPLES; i++) {
+        int64_t t0 = esp_timer_get_time();
+        TEST_ASSERT_TRUE(sht45_start_measurement(&sht45));
+        series_add(&start, esp_timer_get_time() - t0);
+        vTaskDelay(pdMS_TO_TICKS(SHT45_MEASURE_DELAY_MS));
+        sht45_data_t data;
+        t0 = esp_timer_get_time();
+        TEST_ASSERT_TRUE(sht45_read_measurement(&sht45, &data));
+        series_add(&collect, esp_timer_get_time() - t0);
+    }
+    series_report("sht45.start", "us", &start);
+    series_report("sht45.read", "us", &collect);
+    sht45_deinit(&sht45);
+    i2c_scheduler_delete(sched);
+}
+
+TEST_CASE("sgp40 transaction latency", "[timing][hil]")
+{
+    i2c_scheduler_t *sched = timing_new_scheduler();
+    sgp40_t sgp40 = {0};
+    sgp40_config_t cfg = {
+        .i2c_port = TIMING_I2C_PORT,
+        .sda_io_num = TIMING_I2C_SDA,
+        .scl_io_num = TIMING_I2C_SCL,
+        .i2c_clk_speed_hz = TIMING_I2C_HZ,
+    };
+    if (!timing_attach(sched, SGP40_DEFAULT_ADDR, &sgp40.i2c_dev) || sgp40_init(&sgp40, &cfg) != ESP_OK) {
+        timing_detach(&sgp40.i2c_dev);
+        i2c_scheduler_delete(sched);
+        TEST_IGNORE_MESSAGE("no SGP40");
+    }
+    static timing_series_t start;
+    static timing_series_t collect;
+    start.count = collect.count = 0;
+    for (int i = 0; i < TIMING_SAMPLES; i++) {
+        int64_t t0 = esp_timer_get_time();
+        TEST_ASSERT_EQUAL(ESP_OK, sgp40_start_measure_raw(&sgp40, 0x8000, 0x6666));
+        series_add(&start, esp_timer_get_time() - t0);
+        vTaskDelay(pdMS_TO_TICKS(SGP40_MEASURE_RAW_DELAY_MS));
+        sgp40_raw_data_t data;
+        t0 = esp_timer_get_time();
+        TEST_ASSERT_EQUAL(ESP_OK, sgp40_read_raw(&sgp40, &data));
+        series_add(&collect, esp_timer_get_time() - t0);
+    }
+    series_report("sgp40.start", "us", &start);
+    series_report("sgp40.read", "us", &collect);
+    sgp40_deinit(&sgp40);
+    i2c_scheduler_delete(sched);
+}
+
+TEST_CASE("scd40 transaction latency", "[timing][hil]")
+{
+    i2c_scheduler_t *sched = timing_new_scheduler();
+    scd40_t scd40 = {0};
+    scd40_config_t cfg = {
+        .i2c_port = TIMING_I2C_PORT,
+        .sda_io_num = TIMING_I2C_SDA,
+        .scl_io_num = TIMING_I2C_SCL,
+        .i2c_clk_speed_hz = TIMING_I2C_HZ,
+        .rst_io_num = GPIO_NUM_NC,
+    };
+    if (!timing_attach(sched, SCD40_DEFAULT_ADDR, &scd40.i2c_dev) || scd40_init(&scd40, &cfg) != ESP_OK) {
+        timing_detach(&scd40.i2c_dev);
+        i2c_scheduler_delete(sched);
+        TEST_IGNORE_MESSAGE("no SCD40");
+    }
+    TEST_ASSERT_EQUAL(ESP_OK, scd40_start_periodic_measurement(&scd40));
+    // One measurement per period, so few samples; the first period has none ready
+    static timing_series_t collect;
+    collect.count = 0;
+    for (int i = 0; i < 4; i++) {
+        vTaskDelay(pdMS_TO_TICKS(SCD40_MEASUREMENT_DELAY_MS + 100));
+        scd40_measurement_t data;
+        int64_t t0 = esp_timer_get_time();
+        TEST_ASSERT_EQUAL(ESP_OK, scd40_read_measurement(&scd40, &data));
+        series_add(&collect, esp_timer_get_time() - t0);
+    }
+    series_report("scd40.read", "us", &collect);
+    scd40_stop_periodic_measurement(&scd40);
+    scd40_deinit(&scd40);
+    i2c_scheduler_delete(sched);
+}
+
+TEST_CASE("vcnl4040 transaction latency", "[timing][hil]")
+{
+    i2c_scheduler_t *sched = timing_new_scheduler();
+    vcnl4040_t vcnl = {0};
+    vcnl4040_config_t cfg = {
+        .led_current_ma = 100,
+        .prox_rate = VCNL4040_PROX_RATE_31_3_SPS,
+    };
+    if (!timing_attach(sched, VCNL4040_DEFAULT_ADDR, &vcnl.i2c_dev) || vcnl4040_init(&vcnl, &cfg) != ESP_OK) {
+        timing_detach(&vcnl.i2c_dev);
+        i2c_scheduler_delete(sched);
+        TEST_IGNORE_MESSAGE("no VCNL4040");
+    }
+    static timing_series_t als;
+    static timing_series_t ps;
+    als.count = ps.count = 0;
+    for (int i = 0; i < TIMING_SAMPLES; i++) {
+        uint16_t value;
+        int64_t t0 = esp_timer_get_time();
+        TEST_ASSERT_EQUAL(ESP_OK, vcnl4040_read_ambient_lux(&vcnl, &value));
+        series_add(&als, esp_timer_get_time() - t0);
+        t0 = esp_timer_get_time();
+        TEST_ASSERT_EQUAL(ESP_OK, vcnl4040_read_proximity(&vcnl, &value));
+        series_add(&ps, esp_timer_get_time() - t0);
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+    series_report("vcnl4040.als", "us", &als);
+    series_report("vcnl4040.ps", "us", &ps);
+    vcnl4040_deinit(&vcnl);
+    i2c_scheduler_delete(sched);
+}
+
+TEST_CASE("ec10 frame latency", "[timing][hil]")
+{
+    ec10_t ec10 = {0};
+    ec10_config_t cfg = {
+        .uart_port = TIMING_EC10_UART,
+        .tx_io_num = TIMING_EC10_TX,
+        .rx_io_num = TIMING_EC10_RX,
+        .baud_rate = 9600,
+        .rx_buffer_size = 255,
+    };
+    TEST_ASSERT_EQUAL(ESP_OK, ec10_init(&ec10, &cfg));
+    // The sensor sends a frame about once a second; the wait for it is the cost a poll pays
+    static timing_series_t frame;
+    frame.count = 0;
+    for (int i = 0; i < 8; i++) {
+        ec10_measurement_t data;
+        int64_t t0 = esp_timer_get_time();
+        esp_err_t err = ec10_read_measurement(&ec10, &data, pdMS_TO_TICKS(3000));
+        if (err != ESP_OK && i == 0) {
+            ec10_deinit(&ec10);
+            TEST_IGNORE_MESSAGE("no EC10");
+        }
+        TEST_ASSERT_EQUAL(ESP_OK, err);
+        series_add(&frame, esp_timer_get_time() - t0);
+    }
+    series_report("ec10.read", "us", &frame);
+    ec10_deinit(&ec10);
+}
+
+// Time spent inside start and collect steps during the current sweep
+static int64_t s_busy_us;
+
+static esp_err_t timing_sht45_start(i2c_scheduler_dev_t *dev, void *ctx)
+{
+    (void)dev;
+    int64_t t0 = esp_timer_get_time();
+    bool ok = sht45_start_measurement(ctx);
+    s_busy_us += esp_timer_get_time() - t0;
+    return ok ? ESP_OK : ESP_FAIL;
+}
+
+static esp_err_t timing_sht45_collect(i2c_scheduler_dev_t *dev, void *ctx)
+{
+    (void)dev;
+    sht45_data_t data;
+    int64_t t0 = esp_timer_get_time();
+    bool ok = sht45_read_measurement(ctx, &data);
+    s_busy_us += esp_timer_get_time() - t0;
+    return ok ? ESP_OK : ESP_FAIL;
+}
+
+static esp_err_t timing_sgp40_start(i2c_scheduler_dev_t *dev, void *ctx)
+{
+    (void)dev;
+    int64_t t0 = esp_timer_get_time();
+    esp_err_t err = sgp40_start_measure_raw(ctx, 0x8000, 0x6666);
+    s_busy_us += esp_timer_get_time() - t0;
+    return err;
+}
+
+static esp_err_t timing_sgp40_collect(i2c_scheduler_dev_t *dev, void *ctx)
+{
+    (void)dev;
+    sgp40_raw_data_t data;
+    int64_t t0 = esp_timer_get_time();
+    esp_err_t err = sgp40_read_raw(ctx, &data);
+    s_busy_us += esp_timer_get_time() - t0;
+    return err;
+}
+
+static esp_err_t timing_vcnl4040_collect(i2c_scheduler_dev_t *dev, void *ctx)
+{
+    (void)dev;
+    uint16_t als;
+    uint16_t ps;
+    int64_t t0 = esp_timer_get_time();
+    esp_err_t err = vcnl4040_read_ambient_lux(ctx, &als);
+    if (err == ESP_OK) {
+        err = vcnl4040_read_proximity(ctx, &ps);
+    }
+    s_busy_us += esp_timer_get_time() - t0;
+    return err;
+}
+
+// The sweep sensor_integration.c runs, over whichever of its fast sensors answer
+TEST_CASE("sampling sweep cost and bus occupancy", "[timing][hil]")
+{
+    i2c_scheduler_t *sched = timing_new_scheduler();
+    static sht45_handle_t sht45;
+    static sgp40_t sgp40;
+    static vcnl4040_t vcnl;
+    memset(&sht45, 0, sizeof(sht45));
+    memset(&sgp40, 0, sizeof(sgp40));
+    memset(&vcnl, 0, sizeof(vcnl));
+    bool have_sht45 = false;
+    int jobs = 0;
+
+    if (i2c_scheduler_probe(sched, 0x44) == ESP_OK && sht45_init(&sht45, i2c_scheduler_bus(sched), 0x44)) {
+        i2c_scheduler_job_t job = {
+            .name = "sht45",
+            .address = 0x44,
+            .device = sht45.i2c_dev,
+            .conversion_ms = SHT45_MEASURE_DELAY_MS,
+            .start = timing_sht45_start,
+            .collect = timing_sht45_collect,
+            .ctx = &sht45,
+        };
+        TEST_ASSERT_EQUAL(ESP_OK, i2c_scheduler_add_job(sched, &job, NULL));
+        have_sht45 = true;
+        jobs++;
+    }
+    sgp40_config_t sgp40_cfg = {
+        .i2c_port = TIMING_I2C_PORT,
+        .sda_io_num = TIMING_I2C_SDA,
+        .scl_io_num = TIMING_I2C_SCL,
+        .i2c_clk_speed_hz = TIMING_I2C_HZ,
+    };
+    if (timing_attach(sched, SGP40_DEFAULT_ADDR, &sgp40.i2c_dev) && sgp40_init(&sgp40, &sgp40_cfg) == ESP_OK) {
+        i2c_scheduler_job_t job = {
+            .name = "sgp40",
+            .address = SGP40_DEFAULT_ADDR,
+            .device = sgp40.i2c_dev,
+            .conversion_ms = SGP40_MEASURE_RAW_DELAY_MS,
+            .start = timing_sgp40_start,
+            .collect = timing_sgp40_collect,
+            .ctx = &sgp40,
+        };
+        TEST_ASSERT_EQUAL(ESP_OK, i2c_scheduler_add_job(sched, &job, NULL));
+        jobs++;
+    }
+    vcnl4040_config_t vcnl_cfg = {
+        .led_current_ma = 100,
+        .prox_rate = VCNL4040_PROX_RATE_31_3_SPS,
+    };
+    if (timing_attach(sched, VCNL4040_DEFAULT_ADDR, &vcnl.i2c_dev) && vcnl4040_init(&vcnl, &vcnl_cfg) == ESP_OK) {
+        i2c_scheduler_job_t job = {
+            .name = "vcnl4040",
+            .address = VCNL4040_DEFAULT_ADDR,
+            .device = vcnl.i2c_dev,
+            .collect = timing_vcnl4040_collect,
+            .ctx = &vcnl,
+        };
+        TEST_ASSERT_EQUAL(ESP_OK, i2c_scheduler_add_job(sched, &job, NULL));
+        jobs++;
+    }
+
+    if (jobs == 0) {
+        i2c_scheduler_delete(sched);
+        TEST_IGNORE_MESSAGE("no I2C sensors");
+    }
+    static timing_series_t sweep;
+    static timing_series_t occupancy;
+    sweep.count = occupancy.count = 0;
+    for (int i = 0; i < TIMING_SWEEPS; i++) {
+        s_busy_us = 0;
+        int64_t t0 = esp_timer_get_time();
+        TEST_ASSERT_EQUAL(ESP_OK, i2c_scheduler_sweep(sched, NULL));
+        int64_t elapsed = esp_timer_get_time() - t0;
+        series_add(&sweep, elapsed);
+        // Per mille of the sweep the bus was in use; the rest the task slept
+        series_add(&occupancy, elapsed > 0 ? s_busy_us * 1000 / elapsed : 0);
+        vTaskDelay(pdMS_TO_TICKS(100));
+    }
+    report_value("sweep.jobs", "count", jobs);
+    series_report("sweep.elapsed", "us", &sweep);
+    series_report("sweep.bus_occupancy", "permille", &occupancy);
+
+    if (have_sht45) {
+        sht45_deinit(&sht45);
+    }
+    if (sgp40.initialized) {
+        sgp40_deinit(&sgp40);
+    }
+    timing_detach(&sgp40.i2c_dev);
+    if (vcnl.initialized) {
+        vcnl4040_deinit(&vcnl);
+    }
+    timing_detach(&vcnl.i2c_dev);
+    i2c_scheduler_delete(sched);
+}
+
+// Gaps between DMA buffers as the reader sees them; each should be one buffer's worth of audio
+TEST_CASE("korvo1 capture jitter", "[timing][hil]")
+{
+    korvo1_t dev = {0};
+    korvo1_config_t cfg = {
+        .port = I2S_NUM_0,
+        .din_io_num = GPIO_NUM_19,
+        .bclk_io_num = GPIO_NUM_18,
+        .ws_io_num = GPIO_NUM_17,
+        .mclk_io_num = GPIO_NUM_0,
+        .sample_rate_hz = 16000,
+        .dma_buffer_count = 4,
+        .dma_buffer_len = TIMING_I2S_FRAMES,
+        .channel_format = I2S_CHANNEL_FMT_ONLY_LEFT,
+    };
+    TEST_ASSERT_EQUAL(ESP_OK, korvo1_init(&dev, &cfg));
+    TEST_ASSERT_EQUAL(ESP_OK, korvo1_start(&dev));
+
+    static int16_t buffer[TIMING_I2S_FRAMES];
+    size_t bytes_read = 0;
+    // Drain what queued up while starting, so the first gap is a steady-state one
+    for (int i = 0; i < cfg.dma_buffer_count; i++) {
+        TEST_ASSERT_EQUAL(ESP_OK, korvo1_read(&dev, buffer, sizeof(buffer), &bytes_read, pdMS_TO_TICKS(100)));
+    }
+    const int64_t period_us = (int64_t)TIMING_I2S_FRAMES * 1000000 / cfg.sample_rate_hz;
+    static timing_series_t jitter;
+    jitter.count = 0;
+    int64_t last = esp_timer_get_time();
+    int64_t first = last;
+    for (int i = 0; i < TIMING_I2S_READS; i++) {
+        TEST_ASSERT_EQUAL(ESP_OK, korvo1_read(&dev, buffer, sizeof(buffer), &bytes_read, pdMS_TO_TICKS(100)));
+        TEST_ASSERT_EQUAL(sizeof(buffer), bytes_read);
+        int64_t now = esp_timer_get_time();
+        series_add(&jitter, llabs(now - last - period_us));
+        last = now;
+    }
+    // Drift of the capture clock against esp_timer over the whole run, in ppm
+    int64_t expected = period_us * TIMING_I2S_READS;
+    report_value("korvo1.clock_drift", "ppm", llabs(last - first - expected) * 1000000 / expected);
+    series_report("korvo1.jitter", "us", &jitter);
+
+    TEST_ASSERT_EQUAL(ESP_OK, korvo1_stop(&dev));
+    TEST_ASSERT_EQUAL(ESP_OK, korvo1_deinit(&dev));
+}
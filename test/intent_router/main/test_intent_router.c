@@ -0,0 +1,96 @@
+/**
+ * @file test_intent_router.c
+ * @brief Phrase loading from the storage image and the built-in fallback
+ *
+ * config/storage is the directory the build packs into the storage
+ * partition, so reading intents.txt from it here reads what the device
+ * finds at CONFIG_KVA_INTENT_PHRASES_PATH.
+ */
+
+#include "unity.h"
+
+#include <ctype.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "intent_router.h"
+#include "kva_config_defaults.h"
+
+#define STORAGE_FILE(name) INTENT_TEST_STORAGE_DIR "/" name
+
+// Lines that hold a phrase: not blank and not a comment
+static size_t count_phrase_lines(const char *path)
+{
+    FILE *f = fopen(path, "r");
+    TEST_ASSERT_NOT_NULL_MESSAGE(f, path);
+    size_t count = 0;
+    char line[128];
+    while (fgets(line, sizeof(line), f)) {
+        const char *p = line;
+        while (*p && isspace((unsigned char)*p)) {
+            ++p;
+        }
+        if (*p && *p != '#') {
+            count++;
+        }
+    }
+    fclose(f);
+    return count;
+}
+
+static void assert_routes(intent_router_t *router, const char *utterance, intent_router_action_t action)
+{
+    intent_router_decision_t decision = intent_router_route(router, utterance);
+    TEST_ASSERT_EQUAL_MESSAGE(action, decision.action, utterance);
+}
+
+TEST_CASE("the phrase file is in the storage image", "[intent_router]")
+{
+    const char *name = strrchr(CONFIG_KVA_INTENT_PHRASES_PATH, '/');
+    TEST_ASSERT_NOT_NULL(name);
+    char path[256];
+    snprintf(path, sizeof(path), "%s%s", INTENT_TEST_STORAGE_DIR, name);
+    FILE *f = fopen(path, "r");
+    TEST_ASSERT_NOT_NULL_MESSAGE(f, path);
+    fclose(f);
+}
+
+TEST_CASE("phrases load from the flashed file", "[intent_router]")
+{
+    intent_router_t router;
+    intent_router_config_t cfg = {
+        .default_volume_step = 10,
+        .phrase_path = STORAGE_FILE("intents.txt"),
+    };
+    TEST_ASSERT_EQUAL(ESP_OK, intent_router_init(&router, &cfg));
+    TEST_ASSERT_EQUAL(count_phrase_lines(cfg.phrase_path), router.phrase_count);
+
+    assert_routes(&router, "please turn off the lights", INTENT_ROUTER_ACTION_LIGHTS_OFF);
+    assert_routes(&router, "lights up", INTENT_ROUTER_ACTION_LIGHTS_ON);
+    assert_routes(&router, "stop", INTENT_ROUTER_ACTION_SPOTIFY_PAUSE);
+    intent_router_decision_t louder = intent_router_route(&router, "louder");
+    TEST_ASSERT_EQUAL(INTENT_ROUTER_ACTION_SPOTIFY_VOLUME_DELTA, louder.action);
+    TEST_ASSERT_EQUAL(10, louder.volume_delta);
+    intent_router_decision_t play = intent_router_route(&router, "play some jazz");
+    TEST_ASSERT_EQUAL(INTENT_ROUTER_ACTION_SPOTIFY_PLAY, play.action);
+    TEST_ASSERT_EQUAL_STRING("some jazz", play.argument);
+
+    intent_router_deinit(&router);
+}
+
+TEST_CASE("a missing phrase file falls back to the built-in table", "[intent_router]")
+{
+    intent_router_t router;
+    intent_router_config_t cfg = {
+        .default_volume_step = 10,
+        .phrase_path = STORAGE_FILE("no_such_file.txt"),
+    };
+    TEST_ASSERT_EQUAL(ESP_OK, intent_router_init(&router, &cfg));
+    // The built-in table mirrors the shipped file, so an unflashed unit routes the same
+    TEST_ASSERT_EQUAL(count_phrase_lines(STORAGE_FILE("intents.txt")), router.phrase_count);
+
+    assert_routes(&router, "turn lights off", INTENT_ROUTER_ACTION_LIGHTS_OFF);
+    assert_routes(&router, "continue", INTENT_ROUTER_ACTION_SPOTIFY_RESUME);
+
+    intent_router_deinit(&router);
+}
@@ -0,0 +1,11 @@
+#include <stdlib.h>
+
+#include "unity.h"
+
+void app_main(void)
+{
+    // Host runs are batch jobs: run everything and exit with the failure count
+    UNITY_BEGIN();
+    unity_run_all_tests();
+    exit(UNITY_END());
+}
@@ -0,0 +1,16 @@
+#include <stdlib.h>
+
+#include "sdkconfig.h"
+#include "unity.h"
+
+void app_main(void)
+{
+#if CONFIG_IDF_TARGET_LINUX
+    // Host runs are batch jobs: run everything and exit with the failure count
+    UNITY_BEGIN();
+    unity_run_all_tests();
+    exit(UNITY_END());
+#else
+    unity_run_menu();
+#endif
+}
@@ -0,0 +1,642 @@
+/**
+ * @file test_openwakeword_benchmark.c
+ * @brief Per-stage timing of the wake word frontend and inference
+ *
+ * Replays audio in the production 80 ms frames: each frame computes its mel
+ * rows with audio_features_extract_melspectrogram() (one N_FFT window per
+ * hop, the same windows the streaming frontend emits) and then runs
+ * tflite_wrapper_invoke() over the newest mel window. Every stage prints one
+ * "BENCH" line with mean, P50 and P99 latency and, on the device, CPU cycles
+ * per frame; the corpus replay adds detection and false-accept rates. The
+ * direction-of-arrival stage is timed on the same 80 ms frames of stereo.
+ */
+
+#include "unity.h"
+
+#include <dirent.h>
+#include <inttypes.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "audio_doa.h"
+#include "audio_features.h"
+#include "detection_filter.h"
+#include "esp_err.h"
+#include "esp_log.h"
+#include "model_loader.h"
+#include "sdkconfig.h"
+#include "tflite_wrapper.h"
+
+#if CONFIG_IDF_TARGET_LINUX
+#include <time.h>
+#else
+#include "esp_cpu.h"
+#include "esp_spiffs.h"
+#endif
+
+static const char *TAG = "oww_bench";
+
+#define BENCH_SAMPLE_RATE 16000
+#define BENCH_N_FFT 512                 // MELSPEC_N_FFT in audio_features.c
+#define BENCH_FRAME_SAMPLES 1280        // 80 ms, the frame openwakeword_process_audio() sees
+#define BENCH_FRAME_US 80000
+#define BENCH_ROWS_PER_FRAME (BENCH_FRAME_SAMPLES / AUDIO_FEATURES_HOP_LENGTH)
+#define BENCH_SYNTH_SECONDS 10
+
+// Latencies kept per stage for percentiles; longer runs are reservoir-sampled
+#ifndef BENCH_MAX_SAMPLES
+#define BENCH_MAX_SAMPLES 8192
+#endif
+
+#define BENCH_CORPUS_MOUNT "/corpus"
+
+typedef struct {
+    const char *name;
+    uint32_t *latency_ns;
+    size_t kept;
+    uint64_t count;
+    uint64_t total_ns;
+    uint64_t total_cycles;
+    uint32_t rng;
+} bench_stage_t;
+
+typedef struct {
+    audio_features_t *features;
+    tflite_wrapper_t *model;            // NULL: frontend only
+    size_t model_frames;                // Mel rows per inference
+    float *history;                     // Newest model_frames rows, oldest first
+    size_t history_rows;
+    float frame_rows[BENCH_ROWS_PER_FRAME * AUDIO_FEATURES_N_MELS];
+    float output[8];
+    detection_filter_t filter;          // Same post-processing as the detector
+    bool triggered;                     // Filter fired during the last replay
+    bench_stage_t mel;
+    bench_stage_t infer;
+    bench_stage_t frame;
+} bench_t;
+
+typedef struct {
+    uint64_t ns;
+    uint32_t cycles;
+} bench_mark_t;
+
+// Cycles are counted on the device only; the host reports wall time
+static inline void bench_mark(bench_mark_t *m)
+{
+#if CONFIG_IDF_TARGET_LINUX
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    m->ns = (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+    m->cycles = 0;
+#else
+    m->cycles = esp_cpu_get_cycle_count();
+    m->ns = 0;
+#endif
+}
+
+static void bench_elapsed(const bench_mark_t *from, const bench_mark_t *to, uint32_t *ns, uint32_t *cycles)
+{
+#if CONFIG_IDF_TARGET_LINUX
+    *cycles = 0;
+    *ns = (uint32_t)(to->ns - from->ns);
+#else
+    *cycles = to->cycles - from->cycles;
+    *ns = (uint32_t)((uint64_t)*cycles * 1000 / CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ);
+#endif
+}
+
+static void stage_init(bench_stage_t *s, const char *name)
+{
+    memset(s, 0, sizeof(*s));
+    s->name = name;
+    s->rng = 0x2545F491u;
+    s->latency_ns = malloc(BENCH_MAX_SAMPLES * sizeof(uint32_t));
+    TEST_ASSERT_NOT_NULL(s->latency_ns);
+}
+
+static void stage_free(bench_stage_t *s)
+{
+    free(s->latency_ns);
+    s->latency_ns = NULL;
+}
+
+static void stage_record(bench_stage_t *s, uint32_t ns, uint32_t cycles)
+{
+    s->count++;
+    s->total_ns += ns;
+    s->total_cycles += cycles;
+    if (s->kept < BENCH_MAX_SAMPLES) {
+        s->latency_ns[s->kept++] = ns;
+        return;
+    }
+    // Fixed-seed LCG so reruns over the same corpus keep the same samples
+    s->rng = s->rng * 1664525u + 1013904223u;
+    uint64_t slot = s->rng % s->count;
+    if (slot < BENCH_MAX_SAMPLES) {
+        s->latency_ns[slot] = ns;
+    }
+}
+
+static int cmp_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+// One line per stage with stable keys, so runs can be diffed or gated by a script
+static void stage_report(bench_stage_t *s, const char *run)
+{
+    if (s->count == 0) {
+        printf("BENCH run=%s stage=%s frames=0\n", run, s->name);
+        return;
+    }
+    qsort(s->latency_ns, s->kept, sizeof(uint32_t), cmp_u32);
+    double mean_us = (double)s->total_ns / (double)s->count / 1000.0;
+    double p50_us = s->latency_ns[(s->kept - 1) * 50 / 100] / 1000.0;
+    double p99_us = s->latency_ns[(s->kept - 1) * 99 / 100] / 1000.0;
+    printf("BENCH run=%s stage=%s frames=%" PRIu64 " mean_us=%.1f p50_us=%.1f p99_us=%.1f budget_pct=%.2f",
+           run, s->name, s->count, mean_us, p50_us, p99_us, mean_us * 100.0 / BENCH_FRAME_US);
+#if CONFIG_IDF_TARGET_LINUX
+    printf(" cycles_per_frame=na\n");
+#else
+    printf(" cycles_per_frame=%" PRIu64 "\n", s->total_cycles / s->count);
+#endif
+}
+
+// Keep the newest model_frames rows contiguous, oldest first, as the model reads them
+static void history_push(bench_t *b, const float *rows, size_t count)
+{
+    const size_t row = AUDIO_FEATURES_N_MELS;
+    size_t cap = b->model_frames;
+    if (count >= cap) {
+        memcpy(b->history, rows + (count - cap) * row, cap * row * sizeof(float));
+        b->history_rows = cap;
+        return;
+    }
+    size_t keep = b->history_rows < cap - count ? b->history_rows : cap - count;
+    memmove(b->history, b->history + (b->history_rows - keep) * row, keep * row * sizeof(float));
+    memcpy(b->history + keep * row, rows, count * row * sizeof(float));
+    b->history_rows = keep + count;
+}
+
+/**
+ * Replay one clip frame by frame. Rows whose window would start before the
+ * clip are skipped, as the streaming frontend waits for a full window.
+ *
+ * @return Highest wake word confidence over the clip, 0 without a model
+ */
+static float bench_replay(bench_t *b, const int16_t *pcm, size_t n)
+{
+    float best = 0.0f;
+    b->history_rows = 0;
+    b->triggered = false;
+    detection_filter_reset(&b->filter);
+    for (size_t frame = 0; frame + BENCH_FRAME_SAMPLES <= n; frame += BENCH_FRAME_SAMPLES) {
+        bench_mark_t t0, t1, t2;
+        uint32_t ns, cycles;
+        size_t rows = 0;
+
+        bench_mark(&t0);
+        for (size_t r = 0; r < BENCH_ROWS_PER_FRAME; ++r) {
+            size_t end = frame + (r + 1) * AUDIO_FEATURES_HOP_LENGTH;
+            if (end < BENCH_N_FFT) {
+                continue;
+            }
+            size_t mel_size = 0;
+            esp_err_t err = audio_features_extract_melspectrogram(b->features, pcm + end - BENCH_N_FFT, BENCH_N_FFT,
+                                                                  &b->frame_rows[rows * AUDIO_FEATURES_N_MELS],
+                                                                  &mel_size);
+            TEST_ASSERT_EQUAL(ESP_OK, err);
+            rows++;
+        }
+        bench_mark(&t1);
+        bench_elapsed(&t0, &t1, &ns, &cycles);
+        stage_record(&b->mel, ns, cycles);
+
+        if (!b->model) {
+            stage_record(&b->frame, ns, cycles);
+            continue;
+        }
+        history_push(b, b->frame_rows, rows);
+        if (b->history_rows < b->model_frames) {
+            continue;
+        }
+
+        // The history shuffle above is harness bookkeeping, so inference gets its own start mark
+        bench_mark(&t1);
+        size_t out_size = sizeof(b->output) / sizeof(b->output[0]);
+        esp_err_t err = tflite_wrapper_invoke(b->model, b->history, b->model_frames * AUDIO_FEATURES_N_MELS,
+                                              b->output, &out_size);
+        bench_mark(&t2);
+        TEST_ASSERT_EQUAL(ESP_OK, err);
+        uint32_t infer_ns, infer_cycles;
+        bench_elapsed(&t1, &t2, &infer_ns, &infer_cycles);
+        stage_record(&b->infer, infer_ns, infer_cycles);
+        stage_record(&b->frame, ns + infer_ns, cycles + infer_cycles);
+
+        // Same reading as openwakeword.c: [not_wake_word, wake_word] or a single score
+        float confidence = out_size >= 2 ? b->output[1] : (out_size == 1 ? b->output[0] : 0.0f);
+        if (confidence > best) {
+            best = confidence;
+        }
+        if (detection_filter_push(&b->filter, confidence, !b->triggered)) {
+            b->triggered = true;
+        }
+    }
+    return best;
+}
+
+static void bench_init(bench_t *b)
+{
+    memset(b, 0, sizeof(*b));
+    b->features = audio_features_init(BENCH_SAMPLE_RATE);
+    TEST_ASSERT_NOT_NULL(b->features);
+    const detection_filter_config_t filter = {
+        .threshold = CONFIG_OPENWAKEWORD_THRESHOLD / 1000.0f,
+        .patience_frames = CONFIG_OPENWAKEWORD_PATIENCE_FRAMES,
+        .smoothing_frames = CONFIG_OPENWAKEWORD_SMOOTHING_FRAMES,
+    };
+    detection_filter_init(&b->filter, &filter);
+    stage_init(&b->mel, "mel");
+    stage_init(&b->infer, "infer");
+    stage_init(&b->frame, "frame");
+}
+
+static void bench_deinit(bench_t *b)
+{
+    if (b->model) {
+        tflite_wrapper_destroy(b->model);
+    }
+    free(b->history);
+    audio_features_deinit(b->features);
+    stage_free(&b->mel);
+    stage_free(&b->infer);
+    stage_free(&b->frame);
+}
+
+static void bench_report(bench_t *b, const char *run)
+{
+    stage_report(&b->mel, run);
+    if (b->model) {
+        stage_report(&b->infer, run);
+    }
+    stage_report(&b->frame, run);
+}
+
+#if CONFIG_IDF_TARGET_LINUX
+static const char *corpus_root(void)
+{
+    const char *env = getenv("OWW_BENCH_CORPUS");
+    return env ? env : OWW_BENCH_HOST_CORPUS;
+}
+
+// Model data stays loaded for the process; the wrapper keeps pointers into it
+static esp_err_t load_model_data(const uint8_t **data, size_t *size)
+{
+    static uint8_t *s_model;
+    static size_t s_model_size;
+    if (!s_model) {
+        const char *env = getenv("OWW_BENCH_MODEL");
+        esp_err_t err = model_loader_load_from_spiffs(env ? env : OWW_BENCH_HOST_MODEL, &s_model, &s_model_size);
+        if (err != ESP_OK) {
+            return err;
+        }
+    }
+    *data = s_model;
+    *size = s_model_size;
+    return ESP_OK;
+}
+#else
+static const char *corpus_root(void)
+{
+    static bool s_mounted;
+    if (!s_mounted) {
+        esp_vfs_spiffs_conf_t conf = {
+            .base_path = BENCH_CORPUS_MOUNT,
+            .partition_label = "corpus",
+            .max_files = 2,
+            .format_if_mount_failed = false,
+        };
+        if (esp_vfs_spiffs_register(&conf) != ESP_OK) {
+            return NULL;
+        }
+        s_mounted = true;
+    }
+    return BENCH_CORPUS_MOUNT;
+}
+
+static esp_err_t load_model_data(const uint8_t **data, size_t *size)
+{
+    static model_loader_mmap_t s_mapping;
+    static const uint8_t *s_model;
+    static size_t s_model_size;
+    if (!s_model) {
+        esp_err_t err = model_loader_mmap_partition(CONFIG_OPENWAKEWORD_MODEL_PARTITION, &s_model, &s_model_size,
+                                                    &s_mapping);
+        if (err != ESP_OK) {
+            return err;
+        }
+    }
+    *data = s_model;
+    *size = s_model_size;
+    return ESP_OK;
+}
+#endif
+
+// Without TFLite Micro in the build (the host build never has it) only the frontend is timed
+static void bench_attach_model(bench_t *b)
+{
+    const uint8_t *data = NULL;
+    size_t size = 0;
+    if (load_model_data(&data, &size) != ESP_OK) {
+        ESP_LOGW(TAG, "No model; timing the frontend only");
+        return;
+    }
+    b->model = tflite_wrapper_create(data, size, CONFIG_OPENWAKEWORD_TENSOR_ARENA_SIZE);
+    if (!b->model || !tflite_wrapper_is_initialized(b->model)) {
+        ESP_LOGW(TAG, "Model did not load (TFLite Micro not in the build?); timing the frontend only");
+        if (b->model) {
+            tflite_wrapper_destroy(b->model);
+            b->model = NULL;
+        }
+        return;
+    }
+    size_t frames = tflite_wrapper_get_input_size(b->model) / AUDIO_FEATURES_N_MELS;
+    if (frames == 0) {
+        frames = 1;
+    }
+    if (frames > AUDIO_FEATURES_WINDOW_FRAMES) {
+        frames = AUDIO_FEATURES_WINDOW_FRAMES;
+    }
+    b->model_frames = frames;
+    b->history = malloc(frames * AUDIO_FEATURES_N_MELS * sizeof(float));
+    TEST_ASSERT_NOT_NULL(b->history);
+}
+
+/**
+ * Read a 16 kHz, 16-bit mono PCM WAV. Chunks other than fmt and data are
+ * skipped; any other format is rejected rather than resampled.
+ */
+static esp_err_t wav_read(const char *path, int16_t **pcm_out, size_t *count_out)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    uint8_t riff[12];
+    if (fread(riff, 1, sizeof(riff), f) != sizeof(riff) || memcmp(riff, "RIFF", 4) || memcmp(riff + 8, "WAVE", 4)) {
+        fclose(f);
+        return ESP_ERR_INVALID_ARG;
+    }
+    bool fmt_ok = false;
+    uint8_t hdr[8];
+    while (fread(hdr, 1, sizeof(hdr), f) == sizeof(hdr)) {
+        uint32_t len = hdr[4] | (hdr[5] << 8) | (hdr[6] << 16) | ((uint32_t)hdr[7] << 24);
+        if (!memcmp(hdr, "fmt ", 4) && len >= 16) {
+            uint8_t fmt[16];
+            if (fread(fmt, 1, sizeof(fmt), f) != sizeof(fmt)) {
+                break;
+            }
+            uint16_t format = fmt[0] | (fmt[1] << 8);
+            uint16_t channels = fmt[2] | (fmt[3] << 8);
+            uint32_t rate = fmt[4] | (fmt[5] << 8) | (fmt[6] << 16) | ((uint32_t)fmt[7] << 24);
+            uint16_t bits = fmt[14] | (fmt[15] << 8);
+            fmt_ok = format == 1 && channels == 1 && rate == BENCH_SAMPLE_RATE && bits == 16;
+            fseek(f, (long)(len - sizeof(fmt) + (len & 1)), SEEK_CUR);
+        } else if (!memcmp(hdr, "data", 4)) {
+            if (!fmt_ok) {
+                break;
+            }
+            int16_t *pcm = malloc(len);
+            if (!pcm) {
+                fclose(f);
+                return ESP_ERR_NO_MEM;
+            }
+            size_t count = fread(pcm, sizeof(int16_t), len / sizeof(int16_t), f);
+            fclose(f);
+            *pcm_out = pcm;
+            *count_out = count;
+            return ESP_OK;
+        } else {
+            fseek(f, (long)(len + (len & 1)), SEEK_CUR);
+        }
+    }
+    fclose(f);
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+typedef struct {
+    uint32_t clips;
+    uint32_t detected;
+    uint32_t skipped;
+} bench_class_t;
+
+static void replay_dir(bench_t *b, const char *dir_path, bench_class_t *out)
+{
+    DIR *dir = opendir(dir_path);
+    if (!dir) {
+        ESP_LOGW(TAG, "No corpus at %s", dir_path);
+        return;
+    }
+    char path[320];
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        size_t len = strlen(entry->d_name);
+        if (len < 4 || strcmp(entry->d_name + len - 4, ".wav") != 0) {
+            continue;
+        }
+        snprintf(path, sizeof(path), "%s/%s", dir_path, entry->d_name);
+        int16_t *pcm = NULL;
+        size_t count = 0;
+        if (wav_read(path, &pcm, &count) != ESP_OK) {
+            ESP_LOGW(TAG, "Skipping %s: not 16 kHz 16-bit mono PCM", entry->d_name);
+            out->skipped++;
+            continue;
+        }
+        float best = bench_replay(b, pcm, count);
+        free(pcm);
+        out->clips++;
+        if (b->model && b->triggered) {
+            out->detected++;
+        }
+        ESP_LOGD(TAG, "%s: best score %.3f%s", entry->d_name, best, b->triggered ? " (detected)" : "");
+    }
+    closedir(dir);
+}
+
+TEST_CASE("mel frontend on synthetic audio", "[oww_bench]")
+{
+    // A fixed-seed noise bed under a 1 kHz tone: no corpus needed, same input every run
+    const size_t n = BENCH_SYNTH_SECONDS * BENCH_SAMPLE_RATE;
+    int16_t *pcm = malloc(n * sizeof(int16_t));
+    TEST_ASSERT_NOT_NULL(pcm);
+    uint32_t seed = 1;
+    for (size_t i = 0; i < n; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        int32_t noise = (int32_t)(seed >> 20) - 2048;
+        int32_t tone = (i % 16) < 8 ? 3000 : -3000;
+        pcm[i] = (int16_t)(noise + tone);
+    }
+
+    bench_t b;
+    bench_init(&b);
+    bench_replay(&b, pcm, n);
+    bench_report(&b, "synthetic");
+    TEST_ASSERT_EQUAL_UINT64(n / BENCH_FRAME_SAMPLES, b.mel.count);
+    bench_deinit(&b);
+    free(pcm);
+}
+
+TEST_CASE("freeing one frontend leaves the shared FFT to the others", "[oww_bench]")
+{
+    TEST_ASSERT_EQUAL(ESP_OK, audio_features_fft_init());
+    audio_features_t *first = audio_features_init(BENCH_SAMPLE_RATE);
+    audio_features_t *second = audio_features_init(BENCH_SAMPLE_RATE);
+    TEST_ASSERT_NOT_NULL(first);
+    TEST_ASSERT_NOT_NULL(second);
+    audio_features_deinit(first);
+
+    // One second of the 1 kHz square wave: enough audio for many rows
+    int16_t *pcm = malloc(BENCH_SAMPLE_RATE * sizeof(int16_t));
+    TEST_ASSERT_NOT_NULL(pcm);
+    for (size_t i = 0; i < BENCH_SAMPLE_RATE; ++i) {
+        pcm[i] = (i % 16) < 8 ? 3000 : -3000;
+    }
+    size_t rows = 0;
+    TEST_ASSERT_EQUAL(ESP_OK, audio_features_stream_push(second, pcm, BENCH_SAMPLE_RATE, &rows));
+    TEST_ASSERT_TRUE(rows > 0);
+    free(pcm);
+
+    // An impulse transforms to a flat spectrum
+    float data[2 * 64] = {1.0f};
+    TEST_ASSERT_EQUAL(ESP_OK, audio_features_fft(data, 64));
+    for (int k = 0; k < 64; ++k) {
+        TEST_ASSERT_FLOAT_WITHIN(1e-4f, 1.0f, data[2 * k]);
+        TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.0f, data[2 * k + 1]);
+    }
+    audio_features_deinit(second);
+}
+
+TEST_CASE("doa on a delayed noise pair", "[oww_bench]")
+{
+    // Noise reaching channel 1 two samples ahead of channel 0: about +41 degrees for a 65 mm pair
+    const int delay = 2;
+    const uint16_t spacing_mm = 65;
+    const size_t frames = BENCH_SYNTH_SECONDS * BENCH_SAMPLE_RATE;
+    int16_t *pcm = malloc(2 * frames * sizeof(int16_t));
+    TEST_ASSERT_NOT_NULL(pcm);
+    uint32_t seed = 1;
+    int16_t history[8] = {0};
+    for (size_t i = 0; i < frames; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        int16_t sample = (int16_t)(((int32_t)(seed >> 16) - 32768) / 4);
+        memmove(history + 1, history, (sizeof(history) / sizeof(history[0]) - 1) * sizeof(int16_t));
+        history[0] = sample;
+        pcm[2 * i] = history[delay];
+        pcm[2 * i + 1] = sample;
+    }
+
+    const audio_doa_config_t config = {.sample_rate = BENCH_SAMPLE_RATE, .mic_spacing_mm = spacing_mm};
+    audio_doa_t *doa = audio_doa_create(&config);
+    TEST_ASSERT_NOT_NULL(doa);
+    bench_stage_t stage;
+    stage_init(&stage, "doa");
+    audio_doa_set_speech(doa, true);
+    for (size_t frame = 0; frame + BENCH_FRAME_SAMPLES <= frames; frame += BENCH_FRAME_SAMPLES) {
+        bench_mark_t t0, t1;
+        uint32_t ns, cycles;
+        bench_mark(&t0);
+        audio_doa_push(doa, &pcm[2 * frame], 2 * BENCH_FRAME_SAMPLES);
+        bench_mark(&t1);
+        bench_elapsed(&t0, &t1, &ns, &cycles);
+        stage_record(&stage, ns, cycles);
+    }
+    audio_doa_estimate_t running;
+    audio_doa_read(doa, &running);
+    audio_doa_set_speech(doa, false);
+    audio_doa_estimate_t estimate;
+    audio_doa_read(doa, &estimate);
+    stage_report(&stage, "synthetic");
+
+    float expected = asinf(delay * 343.0f / BENCH_SAMPLE_RATE / (spacing_mm / 1000.0f)) * 180.0f / (float)M_PI;
+    printf("BENCH run=synthetic doa_expected_deg=%.1f doa_running_deg=%.1f doa_utterance_deg=%.1f confidence=%.2f\n",
+           expected, running.angle_deg, estimate.utterance_deg, estimate.utterance_confidence);
+    TEST_ASSERT_TRUE(running.active);
+    TEST_ASSERT_FALSE(estimate.active);
+    TEST_ASSERT_EQUAL_UINT32(1, estimate.utterances);
+    TEST_ASSERT_FLOAT_WITHIN(5.0f, expected, running.angle_deg);
+    TEST_ASSERT_FLOAT_WITHIN(5.0f, expected, estimate.utterance_deg);
+    stage_free(&stage);
+    audio_doa_destroy(doa);
+    free(pcm);
+}
+
+TEST_CASE("detection filter patience and debounce", "[oww_bench]")
+{
+    const detection_filter_config_t config = {.threshold = 0.5f, .patience_frames = 3, .smoothing_frames = 2};
+    detection_filter_t filter;
+    detection_filter_init(&filter, &config);
+
+    // A lone spike averages to 0.45 and never holds
+    TEST_ASSERT_FALSE(detection_filter_push(&filter, 0.9f, true));
+    TEST_ASSERT_FALSE(detection_filter_push(&filter, 0.0f, true));
+    TEST_ASSERT_FALSE(detection_filter_push(&filter, 0.0f, true));
+
+    // Sustained: the third smoothed score over threshold triggers, then the run restarts
+    TEST_ASSERT_FALSE(detection_filter_push(&filter, 0.8f, true));   // 0.40
+    TEST_ASSERT_FALSE(detection_filter_push(&filter, 0.8f, true));   // run 1
+    TEST_ASSERT_FALSE(detection_filter_push(&filter, 0.8f, true));   // run 2
+    TEST_ASSERT_TRUE(detection_filter_push(&filter, 0.8f, true));
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.8f, filter.smoothed);
+    TEST_ASSERT_FALSE(detection_filter_push(&filter, 0.8f, true));
+
+    // Debouncing records scores but holds the run at zero
+    for (int i = 0; i < 10; ++i) {
+        TEST_ASSERT_FALSE(detection_filter_push(&filter, 0.9f, false));
+    }
+    TEST_ASSERT_FALSE(detection_filter_push(&filter, 0.9f, true));
+    TEST_ASSERT_FALSE(detection_filter_push(&filter, 0.9f, true));
+    TEST_ASSERT_TRUE(detection_filter_push(&filter, 0.9f, true));
+}
+
+TEST_CASE("replay wake word corpus", "[oww_bench][corpus]")
+{
+    const char *root = corpus_root();
+    if (!root) {
+        TEST_IGNORE_MESSAGE("corpus partition not flashed (build with -DOWW_BENCH_CORPUS_DIR=<dir>)");
+    }
+
+    bench_t b;
+    bench_init(&b);
+    bench_attach_model(&b);
+
+    char dir[256];
+    bench_class_t positive = {0};
+    bench_class_t negative = {0};
+    snprintf(dir, sizeof(dir), "%s/positive", root);
+    replay_dir(&b, dir, &positive);
+    snprintf(dir, sizeof(dir), "%s/negative", root);
+    replay_dir(&b, dir, &negative);
+
+    bench_report(&b, "corpus");
+    if (b.model) {
+        printf("BENCH run=corpus threshold=%.3f patience=%d smoothing=%d positives=%" PRIu32 " detection_pct=%.1f negatives=%" PRIu32
+               " false_accept_pct=%.1f skipped=%" PRIu32 "\n",
+               CONFIG_OPENWAKEWORD_THRESHOLD / 1000.0f, CONFIG_OPENWAKEWORD_PATIENCE_FRAMES,
+               CONFIG_OPENWAKEWORD_SMOOTHING_FRAMES, positive.clips,
+               positive.clips ? positive.detected * 100.0 / positive.clips : 0.0, negative.clips,
+               negative.clips ? negative.detected * 100.0 / negative.clips : 0.0,
+               positive.skipped + negative.skipped);
+    } else {
+        printf("BENCH run=corpus detection=na skipped=%" PRIu32 "\n", positive.skipped + negative.skipped);
+    }
+    uint32_t clips = positive.clips + negative.clips;
+    bench_deinit(&b);
+    if (clips == 0) {
+        TEST_IGNORE_MESSAGE("no WAVs under the corpus positive/ and negative/ directories");
+    }
+}